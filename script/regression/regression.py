@@ -0,0 +1,447 @@
+#!/usr/bin/env python
+# encoding: utf-8
+
+## ==============================================
+## GOAL : Track performance regressions across commits
+## ==============================================
+##
+## Runs the benchmarks at fixed configurations, stores their results with
+## the commit hash and a fingerprint of the machine, and compares them
+## against a baseline commit measured on the same machine. A metric
+## regresses when it got worse by more than the threshold and Welch's
+## t-test says the difference is significant.
+##
+##   regression.py run --build-dir build --baseline <commit>
+##   regression.py compare --baseline <commit> [--commit <commit>]
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import logging
+import math
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+## ==============================================
+## CONFIGURATION
+## ==============================================
+
+# directory structure: peloton/script/regression/<this_file>
+CODE_SOURCE_DIR = os.path.abspath(os.path.dirname(__file__))
+PELOTON_DIR = os.path.abspath(os.path.join(CODE_SOURCE_DIR, os.path.pardir,
+                                           os.path.pardir))
+OLTPBENCH_SCRIPT = os.path.join(PELOTON_DIR, "script", "oltpbenchmark",
+                                "benchmark.py")
+
+DEFAULT_RESULTS = os.path.join(PELOTON_DIR, "build", "regression.jsonl")
+DEFAULT_SUITES = "micro,ycsb,tpcc"
+
+# The configurations are fixed so that the results of commits compare
+YCSB_ARGS = ["-k", "100", "-d", "10", "-b", "4", "-w", "a"]
+TPCC_ARGS = ["-w", "4", "-b", "4", "-d", "10"]
+TPCH_ARGS = ["-n", "3", "-e", "codegen", "-q", "1,3,5,6,14"]
+MICRO_ENV = {"PELOTON_BENCHMARK_MAX_THREADS": "4",
+             "PELOTON_BENCHMARK_REPETITIONS": "3"}
+CODEGEN_ENV = {"PELOTON_BENCHMARK_MAX_ROWS": "100000",
+               "PELOTON_BENCHMARK_REPETITIONS": "3"}
+OLTPBENCH_ARGS = ["localhost", "15721", "tpcc", "45,43,4,4,4",
+                  "--scale-factor", "4", "--terminals", "4",
+                  "--client-time", "60"]
+
+LOG = logging.getLogger(__name__)
+LOG_HANDLER = logging.StreamHandler()
+LOG_HANDLER.setFormatter(logging.Formatter(
+    fmt="%(asctime)s [%(funcName)s:%(lineno)03d] %(levelname)-5s: %(message)s",
+    datefmt="%m-%d-%Y %H:%M:%S"))
+LOG.addHandler(LOG_HANDLER)
+LOG.setLevel(logging.INFO)
+
+## ==============================================
+## MACHINE AND COMMIT
+## ==============================================
+
+def get_commit(commit="HEAD"):
+    return subprocess.check_output(
+        ["git", "rev-parse", commit], cwd=PELOTON_DIR).decode().strip()
+
+def is_dirty():
+    status = subprocess.check_output(
+        ["git", "status", "--porcelain", "--untracked-files=no"],
+        cwd=PELOTON_DIR).decode()
+    return len(status.strip()) > 0
+
+def read_proc(path, key):
+    # the value of the first "key : value" line of the file
+    try:
+        with open(path) as proc_file:
+            for line in proc_file:
+                if line.startswith(key):
+                    return line.split(":", 1)[1].strip()
+    except IOError:
+        pass
+    return "unknown"
+
+def get_machine():
+    return {
+        "host": platform.node(),
+        "cpu": read_proc("/proc/cpuinfo", "model name"),
+        "cpus": str(os.sysconf("SC_NPROCESSORS_ONLN")),
+        "memory": read_proc("/proc/meminfo", "MemTotal"),
+        "kernel": platform.release(),
+    }
+
+def get_fingerprint(machine):
+    # results only compare on the same hardware
+    text = "|".join(machine[key] for key in sorted(machine)
+                    if key != "kernel")
+    return hashlib.sha1(text.encode()).hexdigest()[:12]
+
+## ==============================================
+## BENCHMARKS
+## ==============================================
+
+def run_binary(command, work_dir, env=None):
+    LOG.info("Running %s", " ".join(command))
+    run_env = dict(os.environ)
+    run_env.update(env or {})
+    with open(os.path.join(work_dir, "output.log"), "w") as log_file:
+        ret = subprocess.call(command, cwd=work_dir, env=run_env,
+                              stdout=log_file, stderr=subprocess.STDOUT)
+    if ret != 0:
+        raise RuntimeError("%s failed with %d, see %s" %
+                           (command[0], ret, work_dir))
+
+def read_lines(path):
+    with open(path) as in_file:
+        return [line.split() for line in in_file if line.strip()]
+
+def run_micro(args, work_dir):
+    # ns per operation of every benchmark and thread count
+    run_binary([os.path.join(args.build_dir, "test", "micro_benchmark_test")],
+               work_dir, MICRO_ENV)
+    with open(os.path.join(work_dir, "micro_benchmark.json")) as in_file:
+        results = json.load(in_file)
+    metrics = {}
+    for result in results["benchmarks"]:
+        name = "micro/%s/%d" % (result["name"], result["threads"])
+        metrics[name] = (result["median_ns_per_op"], "ns/op", False)
+    return metrics
+
+def run_codegen(args, work_dir):
+    # compile and execution ms of every plan and table size
+    run_binary([os.path.join(args.build_dir, "test",
+                             "codegen_compile_benchmark_test")],
+               work_dir, CODEGEN_ENV)
+    with open(os.path.join(work_dir,
+                           "codegen_compile_benchmark.json")) as in_file:
+        results = json.load(in_file)
+    metrics = {}
+    for result in results["benchmarks"]:
+        name = "codegen/%s/%d" % (result["name"], result["rows"])
+        metrics[name + "/compile"] = (result["compile_ms"], "ms", False)
+        metrics[name + "/execute"] = (result["codegen_ms"], "ms", False)
+    return metrics
+
+def run_ycsb(args, work_dir):
+    # scale backends columns operations update_ratio theta throughput ...
+    run_binary([os.path.join(args.build_dir, "bin", "ycsb")] + YCSB_ARGS,
+               work_dir)
+    summary = read_lines(os.path.join(work_dir, "outputfile.summary"))
+    return {"ycsb/throughput": (float(summary[0][6]), "txn/s", True)}
+
+def run_tpcc(args, work_dir):
+    # scale backends warehouses throughput abort_rate memory
+    run_binary([os.path.join(args.build_dir, "bin", "tpcc")] + TPCC_ARGS,
+               work_dir)
+    summary = read_lines(os.path.join(work_dir, "outputfile.summary"))
+    return {"tpcc/throughput": (float(summary[0][3]), "txn/s", True)}
+
+def run_tpch(args, work_dir):
+    # a line per query: query engine tuples compile avg min max, then the
+    # compilation phases
+    if args.tpch_data is None:
+        raise RuntimeError("tpch needs --tpch-data")
+    run_binary([os.path.join(args.build_dir, "bin", "tpch"),
+                "-i", args.tpch_data, "-f", str(args.tpch_scale_factor)] +
+               TPCH_ARGS, work_dir)
+    metrics = {}
+    for fields in read_lines(os.path.join(work_dir, "outputfile.summary")):
+        name = "tpch/%s/%s" % (fields[0], fields[1])
+        metrics[name] = (float(fields[4]), "ms", False)
+        if fields[1] == "codegen":
+            metrics[name + "/compile"] = (float(fields[3]), "ms", False)
+    return metrics
+
+def run_oltpbench(args, work_dir):
+    # benchmark.py starts the server, runs oltpbench and collects its
+    # results in ~/tpcc_collected_data_<weights>_<scale factor>
+    run_binary([sys.executable, OLTPBENCH_SCRIPT] + OLTPBENCH_ARGS, work_dir)
+    suffix = OLTPBENCH_ARGS[3].replace(",", "_") + "_" + OLTPBENCH_ARGS[5]
+    summary_path = os.path.join(os.path.expanduser("~"),
+                                "tpcc_collected_data_" + suffix,
+                                "outputfile_" + suffix + ".summary")
+    with open(summary_path) as in_file:
+        lines = in_file.read().splitlines()
+    # the throughput is the sixth line of the summary
+    return {"oltpbench/tpcc/throughput": (float(lines[5]), "txn/s", True)}
+
+SUITES = {
+    "micro": run_micro,
+    "codegen": run_codegen,
+    "ycsb": run_ycsb,
+    "tpcc": run_tpcc,
+    "tpch": run_tpch,
+    "oltpbench": run_oltpbench,
+}
+
+def run_suites(args):
+    # every suite runs args.repetitions times, every run is one sample
+    metrics = {}
+    for suite in args.suites.split(","):
+        if suite not in SUITES:
+            raise RuntimeError("unknown suite: %s" % suite)
+        for repetition in range(args.repetitions):
+            work_dir = tempfile.mkdtemp(prefix="peloton_%s_" % suite)
+            LOG.info("Suite %s, repetition %d of %d", suite, repetition + 1,
+                     args.repetitions)
+            for name, (value, unit, higher_is_better) in \
+                    SUITES[suite](args, work_dir).items():
+                metric = metrics.setdefault(
+                    name, {"unit": unit, "higher_is_better": higher_is_better,
+                           "samples": []})
+                metric["samples"].append(value)
+            shutil.rmtree(work_dir)
+    return metrics
+
+## ==============================================
+## RESULTS
+## ==============================================
+
+def store_result(path, record):
+    with open(path, "a") as out_file:
+        out_file.write(json.dumps(record, sort_keys=True) + "\n")
+
+def load_results(path):
+    if not os.path.exists(path):
+        return []
+    with open(path) as in_file:
+        return [json.loads(line) for line in in_file if line.strip()]
+
+def merge_records(records):
+    # the samples of every metric over all the records
+    metrics = {}
+    for record in records:
+        for name, metric in record["metrics"].items():
+            merged = metrics.setdefault(
+                name, {"unit": metric["unit"],
+                       "higher_is_better": metric["higher_is_better"],
+                       "samples": []})
+            merged["samples"].extend(metric["samples"])
+    return metrics
+
+def find_records(results, fingerprint, commit=None, exclude_commit=None):
+    # the records of the commit on this machine, or of its latest other
+    # commit if no commit is given
+    records = [r for r in results if r["fingerprint"] == fingerprint]
+    if commit is None:
+        others = [r for r in records if r["commit"] != exclude_commit]
+        if len(others) == 0:
+            return None, []
+        commit = others[-1]["commit"]
+    return commit, [r for r in records if r["commit"] == commit]
+
+## ==============================================
+## STATISTICS
+## ==============================================
+
+def mean(samples):
+    return sum(samples) / float(len(samples))
+
+def variance(samples):
+    if len(samples) < 2:
+        return 0.0
+    sample_mean = mean(samples)
+    return sum((x - sample_mean) ** 2 for x in samples) / (len(samples) - 1)
+
+def beta_continued_fraction(a, b, x):
+    # Lentz's method for the continued fraction of the incomplete beta
+    tiny = 1e-30
+    c = 1.0
+    d = 1.0 - (a + b) * x / (a + 1.0)
+    d = 1.0 / (d if abs(d) > tiny else tiny)
+    result = d
+    for m in range(1, 200):
+        for numerator in (m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m)),
+                          -(a + m) * (a + b + m) * x /
+                          ((a + 2 * m) * (a + 2 * m + 1))):
+            d = 1.0 + numerator * d
+            d = 1.0 / (d if abs(d) > tiny else tiny)
+            c = 1.0 + numerator / c
+            c = c if abs(c) > tiny else tiny
+            result *= c * d
+        if abs(c * d - 1.0) < 1e-12:
+            break
+    return result
+
+def incomplete_beta(a, b, x):
+    # the regularized incomplete beta function I_x(a, b)
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    front = math.exp(math.lgamma(a + b) - math.lgamma(a) - math.lgamma(b) +
+                     a * math.log(x) + b * math.log(1.0 - x))
+    if x < (a + 1.0) / (a + b + 2.0):
+        return front * beta_continued_fraction(a, b, x) / a
+    return 1.0 - front * beta_continued_fraction(b, a, 1.0 - x) / b
+
+def welch_t_test(baseline, current):
+    # the two-sided p-value of the means being the same
+    if len(baseline) < 2 or len(current) < 2:
+        return 1.0
+    baseline_error = variance(baseline) / len(baseline)
+    current_error = variance(current) / len(current)
+    error = baseline_error + current_error
+    if error == 0.0:
+        return 1.0 if mean(baseline) == mean(current) else 0.0
+    t = (mean(current) - mean(baseline)) / math.sqrt(error)
+    dof = error ** 2 / (baseline_error ** 2 / (len(baseline) - 1) +
+                        current_error ** 2 / (len(current) - 1))
+    return incomplete_beta(dof / 2.0, 0.5, dof / (dof + t * t))
+
+def compare(baseline_metrics, current_metrics, threshold, alpha):
+    # print every metric both measured, return the regressed ones
+    regressions = []
+    print("%-48s %14s %14s %9s %8s  %s" %
+          ("Metric", "Baseline", "Current", "Change", "p", "Verdict"))
+    for name in sorted(current_metrics):
+        if name not in baseline_metrics:
+            continue
+        baseline = baseline_metrics[name]["samples"]
+        current = current_metrics[name]["samples"]
+        baseline_mean = mean(baseline)
+        current_mean = mean(current)
+        change = ((current_mean - baseline_mean) / baseline_mean
+                  if baseline_mean != 0 else 0.0)
+        # positive when it got worse
+        loss = -change if current_metrics[name]["higher_is_better"] \
+            else change
+        p_value = welch_t_test(baseline, current)
+
+        verdict = ""
+        if p_value < alpha and loss > threshold:
+            verdict = "REGRESSION"
+            regressions.append(name)
+        elif p_value < alpha and -loss > threshold:
+            verdict = "improvement"
+        print("%-48s %14.2f %14.2f %+8.1f%% %8.4f  %s" %
+              (name, baseline_mean, current_mean, change * 100, p_value,
+               verdict))
+    return regressions
+
+## ==============================================
+## MAIN
+## ==============================================
+
+def report(args, results, commit, current_metrics, fingerprint):
+    baseline_commit = None
+    if args.baseline is not None:
+        baseline_commit = get_commit(args.baseline)
+    baseline_commit, baseline_records = find_records(
+        results, fingerprint, baseline_commit, exclude_commit=commit)
+    if len(baseline_records) == 0:
+        LOG.warning("No baseline results on machine %s", fingerprint)
+        return 0
+
+    LOG.info("Comparing %s against baseline %s on machine %s", commit[:10],
+             baseline_commit[:10], fingerprint)
+    regressions = compare(merge_records(baseline_records), current_metrics,
+                          args.threshold, args.alpha)
+    if len(regressions) > 0:
+        LOG.error("%d metrics regressed by more than %.1f%%",
+                  len(regressions), args.threshold * 100)
+        return 1
+    return 0
+
+def run(args):
+    machine = get_machine()
+    fingerprint = get_fingerprint(machine)
+    commit = get_commit()
+    dirty = is_dirty()
+    if dirty:
+        LOG.warning("The tree has local changes, they are stored as %s",
+                    commit[:10])
+
+    record = {
+        "commit": commit,
+        "dirty": dirty,
+        "fingerprint": fingerprint,
+        "machine": machine,
+        "time": int(time.time()),
+        "metrics": run_suites(args),
+    }
+    results = load_results(args.results)
+    store_result(args.results, record)
+    LOG.info("Stored the results of %s in %s", commit[:10], args.results)
+    return report(args, results, commit, record["metrics"], fingerprint)
+
+def compare_commits(args):
+    fingerprint = get_fingerprint(get_machine())
+    commit = get_commit(args.commit)
+    results = load_results(args.results)
+    _, records = find_records(results, fingerprint, commit)
+    if len(records) == 0:
+        LOG.error("No results of %s on machine %s", commit[:10], fingerprint)
+        return 1
+    return report(args, results, commit, merge_records(records), fingerprint)
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Track performance regressions across commits")
+    parser.add_argument("--results", default=DEFAULT_RESULTS,
+                        help="results file (default: %(default)s)")
+    parser.add_argument("--baseline",
+                        help="baseline commit (default: the latest other "
+                             "commit measured on this machine)")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative loss that regresses "
+                             "(default: %(default)s)")
+    parser.add_argument("--alpha", type=float, default=0.05,
+                        help="significance level (default: %(default)s)")
+    subparsers = parser.add_subparsers(dest="command")
+
+    run_parser = subparsers.add_parser(
+        "run", help="run the benchmarks, store and compare the results")
+    run_parser.add_argument("--build-dir",
+                            default=os.path.join(PELOTON_DIR, "build"),
+                            help="build directory (default: %(default)s)")
+    run_parser.add_argument("--suites", default=DEFAULT_SUITES,
+                            help="comma-separated suites out of %s "
+                                 "(default: %%(default)s)" %
+                                 ", ".join(sorted(SUITES)))
+    run_parser.add_argument("--repetitions", type=int, default=5,
+                            help="runs of every suite (default: %(default)s)")
+    run_parser.add_argument("--tpch-data", help="TPC-H data directory")
+    run_parser.add_argument("--tpch-scale-factor", type=float, default=1,
+                            help="TPC-H scale factor (default: %(default)s)")
+
+    compare_parser = subparsers.add_parser(
+        "compare", help="compare the stored results of a commit")
+    compare_parser.add_argument("--commit", default="HEAD",
+                                help="commit to compare "
+                                     "(default: %(default)s)")
+
+    args = parser.parse_args()
+    if args.command == "run":
+        sys.exit(run(args))
+    elif args.command == "compare":
+        sys.exit(compare_commits(args))
+    parser.print_help()
+    sys.exit(1)
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <cmath>
 #include <limits>
 #include <sstream>
 #include <iostream>
@@ -23,31 +24,157 @@
 namespace peloton {
 namespace brain {
 
-// http://www.cs.princeton.edu/courses/archive/fall08/cos436/Duda/C/sk_means.htm
+//===--------------------------------------------------------------------===//
+// Column Bitmap
+//===--------------------------------------------------------------------===//
+
+ColumnBitmap ColumnBitmap::FromSample(const Sample &sample) {
+  auto columns_accessed = sample.GetColumnsAccessed();
+  oid_t column_count = columns_accessed.size();
+  ColumnBitmap bitmap(column_count);
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    if (columns_accessed[column_itr] != 0) {
+      bitmap.Set(column_itr);
+    }
+  }
+
+  return bitmap;
+}
+
+ColumnBitmap ColumnBitmap::FromColumnIds(const Sample &sample,
+                                         oid_t column_count) {
+  ColumnBitmap bitmap(column_count);
+
+  for (auto column : sample.GetColumnsAccessed()) {
+    PL_ASSERT(column >= 0 && column < column_count);
+    bitmap.Set(static_cast<oid_t>(column));
+  }
+
+  return bitmap;
+}
+
+oid_t ColumnBitmap::GetCount() const {
+  oid_t count = 0;
+  for (auto word : words_) {
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+//===--------------------------------------------------------------------===//
+// Clusterer
+//===--------------------------------------------------------------------===//
+
 void Clusterer::ProcessSample(const Sample &sample) {
-  // Figure out closest cluster
-  oid_t closest_cluster = GetClosestCluster(sample);
+  ProcessBitmap(ColumnBitmap::FromSample(sample));
+}
 
-  Sample distance = sample.GetDifference(means_[closest_cluster]);
-  Sample mean_drift = distance * new_sample_weight_;
+// http://www.cs.princeton.edu/courses/archive/fall08/cos436/Duda/C/sk_means.htm
+void Clusterer::ProcessBitmap(const ColumnBitmap &bitmap) {
+  PL_ASSERT(bitmap.GetColumnCount() == sample_column_count_);
+
+  // Figure out closest cluster
+  oid_t closest_cluster = GetClosestCluster(bitmap);
 
   // Update the cluster's mean
-  means_[closest_cluster] = means_[closest_cluster] + mean_drift;
+  // mean += (sample - mean) * weight
+  auto &mean = means_[closest_cluster];
+  double mean_sum = 0;
+  for (oid_t column_itr = 0; column_itr < sample_column_count_;
+       column_itr++) {
+    double column_value = bitmap.IsSet(column_itr) ? 1 : 0;
+    mean[column_itr] += (column_value - mean[column_itr]) * new_sample_weight_;
+    mean_sum += mean[column_itr];
+  }
+  mean_sums_[closest_cluster] = mean_sum;
+}
+
+void Clusterer::ProcessBitmaps(const std::vector<ColumnBitmap> &bitmaps) {
+  // The means start out equal, only samples one at a time split them up
+  if (sample_count_ == 0) {
+    for (auto &bitmap : bitmaps) {
+      ProcessBitmap(bitmap);
+    }
+    return;
+  }
+
+  // Assign every bitmap of the batch, and count the columns of the bitmaps
+  // assigned to each cluster
+  std::vector<oid_t> batch_counts(cluster_count_, 0);
+  std::vector<std::vector<oid_t>> column_counts(cluster_count_);
+  for (auto &bitmap : bitmaps) {
+    PL_ASSERT(bitmap.GetColumnCount() == sample_column_count_);
+    oid_t closest_cluster = GetClosestCluster(bitmap);
+
+    auto &cluster_column_counts = column_counts[closest_cluster];
+    if (cluster_column_counts.empty()) {
+      cluster_column_counts.resize(sample_column_count_, 0);
+    }
+    batch_counts[closest_cluster]++;
+
+    auto &words = bitmap.GetWords();
+    for (size_t word_itr = 0; word_itr < words.size(); word_itr++) {
+      for (auto word = words[word_itr]; word != 0; word &= word - 1) {
+        cluster_column_counts[word_itr * 64 + __builtin_ctzll(word)]++;
+      }
+    }
+  }
+
+  // Move each mean as far as the samples one at a time would, towards the
+  // average of its bitmaps
+  for (oid_t cluster_itr = 0; cluster_itr < cluster_count_; cluster_itr++) {
+    auto batch_count = batch_counts[cluster_itr];
+    if (batch_count == 0) {
+      continue;
+    }
+
+    double drift = 1 - std::pow(1 - new_sample_weight_, batch_count);
+    auto &mean = means_[cluster_itr];
+    auto &cluster_column_counts = column_counts[cluster_itr];
+    double mean_sum = 0;
+    for (oid_t column_itr = 0; column_itr < sample_column_count_;
+         column_itr++) {
+      double column_value =
+          static_cast<double>(cluster_column_counts[column_itr]) / batch_count;
+      mean[column_itr] += (column_value - mean[column_itr]) * drift;
+      mean_sum += mean[column_itr];
+    }
+    mean_sums_[cluster_itr] = mean_sum;
+  }
+}
+
+double Clusterer::GetDistance(const ColumnBitmap &bitmap,
+                              oid_t cluster_offset) const {
+  // A column of the bitmap is |1 - mean| away, any other |mean|. The means
+  // stay within [0, 1].
+  auto &mean = means_[cluster_offset];
+  double set_mean_sum = 0;
+  auto &words = bitmap.GetWords();
+  for (size_t word_itr = 0; word_itr < words.size(); word_itr++) {
+    for (auto word = words[word_itr]; word != 0; word &= word - 1) {
+      set_mean_sum += mean[word_itr * 64 + __builtin_ctzll(word)];
+    }
+  }
+
+  return mean_sums_[cluster_offset] + bitmap.GetCount() - 2 * set_mean_sum;
 }
 
 oid_t Clusterer::GetClosestCluster(const Sample &sample) {
+  return GetClosestCluster(ColumnBitmap::FromSample(sample));
+}
+
+oid_t Clusterer::GetClosestCluster(const ColumnBitmap &bitmap) {
   double min_dist = std::numeric_limits<double>::max();
   oid_t closest_cluster = START_OID;
-  oid_t cluster_itr = START_OID;
 
   // Go over all the means and find closest cluster
-  for (auto mean : means_) {
-    auto dist = sample.GetDistance(mean);
+  for (oid_t cluster_itr = 0; cluster_itr < cluster_count_; cluster_itr++) {
+    auto dist = GetDistance(bitmap, cluster_itr);
     if (dist < min_dist) {
       closest_cluster = cluster_itr;
       min_dist = dist;
     }
-    cluster_itr++;
   }
 
   closest_[closest_cluster]++;
@@ -57,7 +184,7 @@ oid_t Clusterer::GetClosestCluster(const Sample &sample) {
 }
 
 Sample Clusterer::GetCluster(oid_t cluster_offset) const {
-  return means_[cluster_offset];
+  return Sample(means_[cluster_offset]);
 }
 
 double Clusterer::GetFraction(oid_t cluster_offset) const {
@@ -99,7 +226,7 @@ column_map_type Clusterer::GetPartitioning(oid_t tile_count) const {
     }
 
     // otherwise, get its partitioning
-    auto config = means_[entry->second];
+    auto config = GetCluster(entry->second);
     auto config_tile = config.GetEnabledColumns();
 
     for (auto column : config_tile) {
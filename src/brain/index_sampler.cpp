@@ -0,0 +1,313 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_sampler.cpp
+//
+// Identification: src/brain/index_sampler.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "brain/index_sampler.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "brain/sample.h"
+#include "common/macros.h"
+#include "configuration/configuration.h"
+#include "expression/abstract_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/stats/cardinality_estimator.h"
+#include "optimizer/stats/cost.h"
+#include "optimizer/stats/stats_storage.h"
+#include "optimizer/stats/table_stats.h"
+#include "planner/abstract_join_plan.h"
+#include "planner/abstract_plan.h"
+#include "planner/abstract_scan_plan.h"
+#include "planner/delete_plan.h"
+#include "planner/insert_plan.h"
+#include "planner/update_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace brain {
+
+namespace {
+
+// The stats of an analyzed table, or null
+std::shared_ptr<optimizer::TableStats> GetAnalyzedTableStats(
+    storage::DataTable *table) {
+  auto table_stats = optimizer::StatsStorage::GetInstance()->GetTableStats(
+      table->GetDatabaseOid(), table->GetOid());
+  if (table_stats == nullptr || table_stats->num_rows == 0) return nullptr;
+  return table_stats;
+}
+
+// The rows of the table, as of the last analyze if there was one
+double GetRowCount(storage::DataTable *table,
+                   const std::shared_ptr<optimizer::TableStats> &table_stats) {
+  if (table_stats != nullptr) return table_stats->num_rows;
+  return table->GetTupleCount();
+}
+
+void CollectConjuncts(
+    const expression::AbstractExpression *predicate,
+    std::vector<const expression::AbstractExpression *> &conjuncts) {
+  if (predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    for (size_t child_idx = 0; child_idx < predicate->GetChildrenSize();
+         child_idx++) {
+      CollectConjuncts(predicate->GetChild(child_idx), conjuncts);
+    }
+  } else {
+    conjuncts.push_back(predicate);
+  }
+}
+
+// Returns false unless the conjunct compares a column of the scanned table
+// with a value, which an index on the column can look up
+bool GetIndexableColumn(const expression::AbstractExpression *conjunct,
+                        oid_t &column_id) {
+  switch (conjunct->GetExpressionType()) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return false;
+  }
+
+  auto column = conjunct->GetChild(0);
+  auto value = conjunct->GetChild(1);
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    std::swap(column, value);
+  }
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+      (value->GetExpressionType() != ExpressionType::VALUE_CONSTANT &&
+       value->GetExpressionType() != ExpressionType::VALUE_PARAMETER)) {
+    return false;
+  }
+
+  auto tuple_value =
+      static_cast<const expression::TupleValueExpression *>(column);
+  if (tuple_value->GetTupleId() != 0) return false;
+  column_id = tuple_value->GetColumnId();
+  return true;
+}
+
+// The table of the scan that produces the output of the plan, and the
+// column of the table that the output column is. Null if there is none.
+storage::DataTable *GetScanColumn(const planner::AbstractPlan *plan,
+                                  oid_t &column_id) {
+  // the hash of a join passes the tuples of its child through
+  while (plan != nullptr && plan->GetPlanNodeType() == PlanNodeType::HASH) {
+    plan = plan->GetChild(0);
+  }
+  if (plan == nullptr || (plan->GetPlanNodeType() != PlanNodeType::SEQSCAN &&
+                          plan->GetPlanNodeType() != PlanNodeType::INDEXSCAN)) {
+    return nullptr;
+  }
+
+  auto scan = static_cast<const planner::AbstractScan *>(plan);
+  auto &column_ids = scan->GetColumnIds();
+  if (column_ids.empty() == false) {
+    if (column_id >= column_ids.size()) return nullptr;
+    column_id = column_ids[column_id];
+  }
+  return scan->GetTable();
+}
+
+void RecordScanSample(const planner::AbstractScan *scan) {
+  auto table = scan->GetTable();
+  auto predicate = scan->GetPredicate();
+  if (table == nullptr || predicate == nullptr) return;
+
+  std::set<oid_t> column_ids;
+  IndexSampler::GetIndexableColumns(predicate, column_ids);
+  if (column_ids.empty()) return;
+
+  auto benefit = IndexSampler::GetIndexBenefit(table, predicate);
+  if (benefit <= 0) return;
+
+  std::vector<double> columns_accessed(column_ids.begin(), column_ids.end());
+  table->RecordIndexSample(
+      brain::Sample(columns_accessed, benefit, SAMPLE_TYPE_ACCESS));
+}
+
+void RecordJoinSamples(const planner::AbstractJoinPlan *join) {
+  auto predicate = join->GetPredicate();
+  if (predicate == nullptr || join->GetChildren().size() != 2) return;
+
+  std::vector<const expression::AbstractExpression *> conjuncts;
+  CollectConjuncts(predicate, conjuncts);
+  for (auto conjunct : conjuncts) {
+    if (conjunct->GetExpressionType() != ExpressionType::COMPARE_EQUAL ||
+        conjunct->GetChild(0)->GetExpressionType() !=
+            ExpressionType::VALUE_TUPLE ||
+        conjunct->GetChild(1)->GetExpressionType() !=
+            ExpressionType::VALUE_TUPLE) {
+      continue;
+    }
+
+    // Either side could be looked up by its key for each tuple of the other
+    for (size_t child_idx = 0; child_idx < 2; child_idx++) {
+      auto key = static_cast<const expression::TupleValueExpression *>(
+          conjunct->GetChild(child_idx));
+      if (key->GetTupleId() < 0 || key->GetTupleId() > 1) continue;
+
+      oid_t column_id = key->GetColumnId();
+      auto table = GetScanColumn(join->GetChild(key->GetTupleId()), column_id);
+      if (table == nullptr) continue;
+
+      auto benefit = IndexSampler::GetJoinIndexBenefit(table, column_id);
+      if (benefit <= 0) continue;
+
+      std::vector<double> columns_accessed = {static_cast<double>(column_id)};
+      table->RecordIndexSample(
+          brain::Sample(columns_accessed, benefit, SAMPLE_TYPE_ACCESS));
+    }
+  }
+}
+
+void RecordUpdateSample(storage::DataTable *table,
+                        const size_t modified_count) {
+  if (table == nullptr || modified_count == 0) return;
+
+  auto cost = IndexSampler::GetIndexMaintenanceCost(table, modified_count);
+  if (cost <= 0) return;
+
+  table->RecordIndexSample(brain::Sample({}, cost, SAMPLE_TYPE_UPDATE));
+}
+
+}  // namespace
+
+void IndexSampler::RecordPlan(const planner::AbstractPlan *plan,
+                              const size_t modified_count) {
+  static thread_local uint64_t plan_count = 0;
+  if (plan == nullptr || FLAGS_index_tuner_sample_interval == 0 ||
+      plan_count++ % FLAGS_index_tuner_sample_interval != 0) {
+    return;
+  }
+
+  RecordSamples(plan, modified_count);
+}
+
+void IndexSampler::RecordSamples(const planner::AbstractPlan *plan,
+                                 const size_t modified_count) {
+  switch (plan->GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN:
+    case PlanNodeType::INDEXSCAN:
+      RecordScanSample(static_cast<const planner::AbstractScan *>(plan));
+      break;
+    case PlanNodeType::NESTLOOP:
+    case PlanNodeType::MERGEJOIN:
+    case PlanNodeType::HASHJOIN:
+      RecordJoinSamples(static_cast<const planner::AbstractJoinPlan *>(plan));
+      break;
+    case PlanNodeType::UPDATE:
+      RecordUpdateSample(
+          static_cast<const planner::UpdatePlan *>(plan)->GetTable(),
+          modified_count);
+      break;
+    case PlanNodeType::DELETE:
+      RecordUpdateSample(
+          static_cast<const planner::DeletePlan *>(plan)->GetTable(),
+          modified_count);
+      break;
+    case PlanNodeType::INSERT:
+      RecordUpdateSample(
+          static_cast<const planner::InsertPlan *>(plan)->GetTable(),
+          modified_count);
+      break;
+    default:
+      break;
+  }
+
+  for (auto &child : plan->GetChildren()) {
+    RecordSamples(child.get(), modified_count);
+  }
+}
+
+void IndexSampler::GetIndexableColumns(
+    const expression::AbstractExpression *predicate,
+    std::set<oid_t> &column_ids) {
+  std::vector<const expression::AbstractExpression *> conjuncts;
+  CollectConjuncts(predicate, conjuncts);
+  for (auto conjunct : conjuncts) {
+    oid_t column_id;
+    if (GetIndexableColumn(conjunct, column_id)) {
+      column_ids.insert(column_id);
+    }
+  }
+}
+
+double IndexSampler::GetIndexBenefit(
+    storage::DataTable *table,
+    const expression::AbstractExpression *predicate) {
+  auto table_stats = GetAnalyzedTableStats(table);
+  double num_rows = GetRowCount(table, table_stats);
+  if (num_rows < 1) return 0;
+
+  // Only the conjuncts the index can look up narrow down its keys
+  std::vector<const expression::AbstractExpression *> conjuncts;
+  std::vector<const expression::AbstractExpression *> indexable_conjuncts;
+  bool has_equal = false;
+  CollectConjuncts(predicate, conjuncts);
+  for (auto conjunct : conjuncts) {
+    oid_t column_id;
+    if (GetIndexableColumn(conjunct, column_id)) {
+      indexable_conjuncts.push_back(conjunct);
+      has_equal |=
+          conjunct->GetExpressionType() == ExpressionType::COMPARE_EQUAL;
+    }
+  }
+  if (indexable_conjuncts.empty()) return 0;
+
+  // The costs of a sequential scan and of an index scan, as the optimizer
+  // would estimate them if the index existed. Until the table is analyzed,
+  // an equality is taken to match one tuple, as a join key is.
+  double selectivity = optimizer::CardinalityEstimator::EstimateSelectivity(
+      table_stats, indexable_conjuncts);
+  if (table_stats == nullptr && has_equal == true) {
+    selectivity = 1 / num_rows;
+  }
+  double seq_scan_cost = num_rows * optimizer::DEFAULT_TUPLE_COST;
+  double index_scan_cost =
+      optimizer::Cost::IndexLookupCost(num_rows, selectivity);
+  return std::max(seq_scan_cost - index_scan_cost, 0.0);
+}
+
+double IndexSampler::GetJoinIndexBenefit(storage::DataTable *table,
+                                         const oid_t column_id) {
+  auto table_stats = GetAnalyzedTableStats(table);
+  double num_rows = GetRowCount(table, table_stats);
+  if (num_rows < 1) return 0;
+
+  // A key matches the tuples of one of the distinct values of the column
+  double distinct = num_rows;
+  if (table_stats != nullptr && table_stats->HasColumnStats(column_id)) {
+    distinct = table_stats->GetCardinality(column_id);
+  }
+  double selectivity =
+      optimizer::CardinalityEstimator::EstimateJoinSelectivity(
+          distinct, num_rows, 1, 1);
+
+  double seq_scan_cost = num_rows * optimizer::DEFAULT_TUPLE_COST;
+  double index_scan_cost =
+      optimizer::Cost::IndexLookupCost(num_rows, selectivity);
+  return std::max(seq_scan_cost - index_scan_cost, 0.0);
+}
+
+double IndexSampler::GetIndexMaintenanceCost(storage::DataTable *table,
+                                             const size_t modified_count) {
+  auto table_stats = GetAnalyzedTableStats(table);
+  double num_rows = std::max(GetRowCount(table, table_stats), 2.0);
+  return modified_count * optimizer::Cost::IndexMaintenanceCost(num_rows);
+}
+
+}  // End brain namespace
+}  // End peloton namespace
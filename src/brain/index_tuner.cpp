@@ -16,15 +16,18 @@
 #include <include/brain/brain_util.h>
 
 #include "brain/clusterer.h"
+#include "brain/workload_forecaster.h"
 #include "catalog/catalog.h"
 #include "catalog/schema.h"
 #include "common/container_tuple.h"
 #include "common/logger.h"
+#include "common/maintenance_scheduler.h"
 #include "common/macros.h"
 #include "common/timer.h"
 #include "index/index_factory.h"
 #include "storage/data_table.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "wire/packet_manager.h"
 
 namespace peloton {
@@ -52,6 +55,25 @@ void IndexTuner::Start() {
   LOG_INFO("Started index tuner");
 }
 
+// The indexes the tuner creates and drops
+static const std::string ADHOC_INDEX_PREFIX = "adhoc_index_";
+
+static bool IsAdhocIndex(const std::shared_ptr<index::Index>& index) {
+  return index->GetName().compare(0, ADHOC_INDEX_PREFIX.size(),
+                                  ADHOC_INDEX_PREFIX) == 0;
+}
+
+// The memory an index on the attributes of the table takes, at least
+static size_t EstimateIndexFootprint(storage::DataTable* table,
+                                     const std::set<oid_t>& index_attrs) {
+  auto tuple_schema = table->GetSchema();
+  size_t entry_size = sizeof(ItemPointer*);
+  for (auto attr : index_attrs) {
+    entry_size += tuple_schema->GetLength(attr);
+  }
+  return table->GetTupleCount() * entry_size;
+}
+
 // Add an ad-hoc index
 static void AddIndex(storage::DataTable* table,
                      std::set<oid_t> suggested_index_attrs) {
@@ -71,12 +93,14 @@ static void AddIndex(storage::DataTable* table,
   key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
   key_schema->SetIndexedColumns(key_attrs);
 
-  unique = true;
+  // the columns need not be unique, an index that enforces it would reject
+  // the tuples that share a key
+  unique = false;
 
   index_metadata = new index::IndexMetadata(
-      "adhoc_index_" + std::to_string(index_oid), index_oid, table->GetOid(),
-      table->GetDatabaseOid(), IndexType::BWTREE,
-      IndexConstraintType::PRIMARY_KEY, tuple_schema, key_schema, key_attrs,
+      ADHOC_INDEX_PREFIX + std::to_string(index_oid), index_oid,
+      table->GetOid(), table->GetDatabaseOid(), IndexType::BWTREE,
+      IndexConstraintType::DEFAULT, tuple_schema, key_schema, key_attrs,
       unique);
 
   // Set initial utility ratio
@@ -94,38 +118,51 @@ static void AddIndex(storage::DataTable* table,
 
 void IndexTuner::BuildIndex(storage::DataTable* table,
                             std::shared_ptr<index::Index> index) {
-  auto table_schema = table->GetSchema();
   auto index_tile_group_offset = index->GetIndexedTileGroupOff();
   auto table_tile_group_count = table->GetTileGroupCount();
   oid_t tile_groups_indexed = 0;
 
+  // Finish the index before the peak rather than during it
+  auto tile_groups_to_index = tile_groups_indexed_per_iteration;
+  if (WorkloadForecaster::GetInstance().IsPeakAhead(DEFAULT_FORECAST_HORIZON,
+                                                    DEFAULT_PEAK_RATIO)) {
+    tile_groups_to_index *= peak_build_factor;
+  }
+
   auto index_schema = index->GetKeySchema();
   auto indexed_columns = index_schema->GetIndexedColumns();
-  std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+  std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer *>>
+      entries;
 
   while (index_tile_group_offset < table_tile_group_count &&
-         (tile_groups_indexed < tile_groups_indexed_per_iteration)) {
-    std::unique_ptr<storage::Tuple> tuple_ptr(
-        new storage::Tuple(table_schema, true));
-
+         (tile_groups_indexed < tile_groups_to_index)) {
     auto tile_group = table->GetTileGroup(index_tile_group_offset);
-    auto tile_group_id = tile_group->GetTileGroupId();
+    // tile groups dropped by the compactor have nothing to index
+    if (tile_group == nullptr) {
+      index->IncrementIndexedTileGroupOffset();
+      index_tile_group_offset++;
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
     oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
     for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      // The entry shares the indirection of the tuple with the other indexes
+      auto index_entry_ptr = tile_group_header->GetIndirection(tuple_id);
+      if (index_entry_ptr == nullptr) {
+        continue;
+      }
+
       // Setup container tuple
       expression::ContainerTuple<storage::TileGroup> container_tuple(
           tile_group.get(), tuple_id);
 
-      // Set the location
-      ItemPointer location(tile_group_id, tuple_id);
-
       // Set the key
+      std::unique_ptr<storage::Tuple> key(
+          new storage::Tuple(index_schema, true));
       key->SetFromTuple(&container_tuple, indexed_columns, index->GetPool());
 
-      // Insert in specific index
-      // TODO: Allocate itempointer ?
-      index->InsertEntry(key.get(), &location);
+      entries.emplace_back(std::move(key), index_entry_ptr);
     }
 
     // Update indexed tile group offset (set of tgs indexed)
@@ -135,10 +172,18 @@ void IndexTuner::BuildIndex(storage::DataTable* table,
     tile_groups_indexed++;
   }
 
+  // The first iteration builds the index at once, the later ones insert
+  table->LoadIndex(index.get(), entries, nullptr);
+
   tile_groups_indexed_ += tile_groups_indexed;
 }
 
 void IndexTuner::BuildIndices(storage::DataTable* table) {
+  // The indexes only turn visible in visibility mode, they are not built
+  if (visibility_mode_ == true) {
+    return;
+  }
+
   oid_t index_count = table->GetIndexCount();
 
   for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
@@ -148,8 +193,15 @@ void IndexTuner::BuildIndices(storage::DataTable* table) {
       continue;
     }
 
+    // Only the indexes the tuner created are built here, a few tile groups
+    // at a time
+    if (IsAdhocIndex(index) == false ||
+        index->GetIndexedTileGroupOff() >= table->GetTileGroupCount()) {
+      continue;
+    }
+
     // Build index
-    // BuildIndex(table, index);
+    BuildIndex(table, index);
   }
 }
 
@@ -203,15 +255,19 @@ std::vector<sample_frequency_map_entry> GetFrequentSamples(
   std::unordered_map<brain::Sample, double> sample_frequency_map;
   double total_weight = 0;
 
-  // Go over all samples
+  // Go over all samples. The weights of the samples of the same columns add
+  // up, whatever they are.
   for (auto sample : samples) {
+    brain::Sample columns_sample(sample.GetColumnsAccessed(),
+                                 DEFAULT_SAMPLE_WEIGHT,
+                                 sample.GetSampleType());
     if (sample.GetSampleType() == SAMPLE_TYPE_ACCESS) {
       // Update sample count
-      sample_frequency_map[sample] += sample.GetWeight();
+      sample_frequency_map[columns_sample] += sample.GetWeight();
       total_weight += sample.GetWeight();
     } else if (sample.GetSampleType() == SAMPLE_TYPE_UPDATE) {
       // Update sample count
-      sample_frequency_map[sample] += sample.GetWeight();
+      sample_frequency_map[columns_sample] += sample.GetWeight();
       total_weight += sample.GetWeight();
     } else {
       throw Exception("Unknown sample type : " +
@@ -300,30 +356,49 @@ double GetCurrentIndexUtility(
 void IndexTuner::DropIndexes(storage::DataTable* table) {
   oid_t index_count = table->GetIndexCount();
 
-  // Go over indices
+  // Go over indices, the ones the user created are kept
+  std::shared_ptr<index::Index> drop_index;
   oid_t index_itr;
   for (index_itr = 0; index_itr < index_count; index_itr++) {
     auto index = table->GetIndex(index_itr);
-    if (index == nullptr) {
+    if (index == nullptr || IsAdhocIndex(index) == false) {
       continue;
     }
 
-    // auto average_index_utility = index_metadata->GetUtility();
-    auto index_oid = index->GetOid();
+    // Drop the least useful index
+    if (drop_index == nullptr || index->GetMetadata()->GetUtility() <
+                                     drop_index->GetMetadata()->GetUtility()) {
+      drop_index = index;
+    }
+  }
 
-    // Check if index utility below threshold and drop if needed
-    // if (average_index_utility < index_utility_threshold) {
-    LOG_DEBUG("Dropping index : %s", index->GetMetadata()->GetInfo().c_str());
+  // Drop one index at a time
+  if (drop_index != nullptr) {
+    LOG_DEBUG("Dropping index : %s",
+              drop_index->GetMetadata()->GetInfo().c_str());
+    table->DropIndexWithOid(drop_index->GetOid());
+  }
+}
 
-    table->DropIndexWithOid(index_oid);
+size_t IndexTuner::GetAdhocIndexFootprint() const {
+  size_t index_footprint = 0;
 
-    // Drop one index at a time
-    return;
+  // Go over all tables
+  for (auto table : tables) {
+    oid_t index_count = table->GetIndexCount();
+    for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
+      auto index = table->GetIndex(index_itr);
+      if (index == nullptr || IsAdhocIndex(index) == false) {
+        continue;
+      }
 
-    // Update index count
-    index_count = table->GetIndexCount();
-    // }
+      auto index_attrs = table->GetIndexAttrs(index_itr);
+      index_footprint += std::max(index->GetMemoryFootprint(),
+                                  EstimateIndexFootprint(table, index_attrs));
+    }
   }
+
+  return index_footprint;
 }
 
 void IndexTuner::AddIndexes(
@@ -364,6 +439,14 @@ void IndexTuner::AddIndexes(
     if (visibility_mode_ == false && suggested_index_found == false) {
       LOG_TRACE("Did not find suggested index.");
 
+      // Check if the index fits in the memory left
+      if (GetAdhocIndexFootprint() +
+              EstimateIndexFootprint(table, suggested_index_set) >
+          index_memory_budget) {
+        LOG_TRACE("Suggested index exceeds the memory budget");
+        continue;
+      }
+
       // Add adhoc index with given utility
       AddIndex(table, suggested_index_set);
       constructed_index_itr++;
@@ -376,8 +459,12 @@ void IndexTuner::AddIndexes(
       auto index = table->GetIndex(index_itr);
       auto index_metadata = index->GetMetadata();
 
+      // An index the tuner builds is used once it holds every tuple
       auto index_is_visible = index_metadata->GetVisibility();
-      if (index_is_visible == false) {
+      auto index_is_built =
+          visibility_mode_ == true || IsAdhocIndex(index) == false ||
+          index->GetIndexedTileGroupOff() >= table->GetTileGroupCount();
+      if (index_is_visible == false && index_is_built == true) {
         LOG_INFO("Enabling index : %s", index_metadata->GetName().c_str());
         index_metadata->SetVisibility(true);
 
@@ -546,10 +633,14 @@ void IndexTuner::Tune() {
     // Go over one table at a time
     for (auto table : tables) {
       // Update indices periodically
-      IndexTuneHelper(table);
+      {
+        MaintenanceWork work(MaintenanceTask::INDEX_TUNER);
+        IndexTuneHelper(table);
+      }
 
       LOG_INFO("TUNER PAUSE [%dms]", duration_of_pause);
-      std::this_thread::sleep_for(std::chrono::milliseconds(duration_of_pause));
+      MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::INDEX_TUNER,
+                                                duration_of_pause * 1000);
     }
 
     pause_timer.Stop();
@@ -557,7 +648,8 @@ void IndexTuner::Tune() {
 
     // Sleep a bit if needed
     if (duration > duration_between_pauses) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(duration_of_pause));
+      MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::INDEX_TUNER,
+                                                duration_of_pause * 1000);
       pause_timer.Reset();
       pause_timer.Start();
     }
@@ -0,0 +1,239 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// knob_tuner.cpp
+//
+// Identification: src/brain/knob_tuner.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "brain/knob_tuner.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "common/logger.h"
+#include "common/maintenance_scheduler.h"
+#include "common/wait_events.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace brain {
+
+KnobTuner &KnobTuner::GetInstance() {
+  static KnobTuner knob_tuner;
+  return knob_tuner;
+}
+
+KnobTuner::KnobTuner() : knob_tuning_stop(true) {}
+
+KnobTuner::~KnobTuner() {}
+
+void KnobTuner::Start() {
+  // The epochs grow back to the length they were started with
+  default_epoch_length = EPOCH_LENGTH;
+  last_epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+
+  // Set signal
+  knob_tuning_stop = false;
+
+  // Launch thread
+  knob_tuner_thread = std::thread(&brain::KnobTuner::Tune, this);
+
+  LOG_INFO("Started knob tuner");
+}
+
+static uint64_t GetHeaderLatchWaitCount() {
+  auto totals = WaitEvents::GetTotals();
+  return totals
+      .wait_counts[static_cast<size_t>(WaitEventType::TILE_HEADER_LATCH)];
+}
+
+void KnobTuner::Tune() {
+  auto interval_start = std::chrono::steady_clock::now();
+  uint64_t latch_wait_count = GetHeaderLatchWaitCount();
+
+  // Continue till signal is not false
+  while (knob_tuning_stop == false) {
+    // Sleep till the end of the interval
+    MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::KNOB_TUNER,
+                                              tune_interval * 1000);
+    if (knob_tuning_stop == true) {
+      break;
+    }
+
+    MaintenanceWork work(MaintenanceTask::KNOB_TUNER);
+    auto now = std::chrono::steady_clock::now();
+    uint64_t interval_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(now -
+                                                              interval_start)
+            .count();
+    interval_start = now;
+
+    uint64_t last_latch_wait_count = latch_wait_count;
+    latch_wait_count = GetHeaderLatchWaitCount();
+
+    {
+      std::lock_guard<std::mutex> lock(knob_tuner_mutex);
+      for (auto table : tables) {
+        TuneTable(table, latch_wait_count - last_latch_wait_count);
+      }
+    }
+
+    TuneEpochLength(interval_ms);
+  }
+}
+
+void KnobTuner::Stop() {
+  // Stop tuning
+  knob_tuning_stop = true;
+
+  // Stop thread
+  knob_tuner_thread.join();
+
+  LOG_INFO("Stopped knob tuner");
+}
+
+void KnobTuner::AddTable(storage::DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(knob_tuner_mutex);
+    LOG_TRACE("Knob tuner adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void KnobTuner::DropTable(storage::DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(knob_tuner_mutex);
+    tables.erase(std::remove(tables.begin(), tables.end(), table),
+                 tables.end());
+    table_knobs.erase(table);
+  }
+}
+
+void KnobTuner::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(knob_tuner_mutex);
+    tables.clear();
+    table_knobs.clear();
+  }
+}
+
+void KnobTuner::TuneTable(storage::DataTable *table,
+                          const uint64_t latch_wait_count) {
+  auto &knobs = table_knobs[table];
+  size_t tuple_count = table->GetTupleCount();
+  size_t tile_group_count = table->GetTileGroupCount();
+
+  // The first interval only sets the baseline
+  size_t insert_count = 0;
+  size_t new_tile_group_count = 0;
+  if (knobs.is_seen == true) {
+    if (tuple_count > knobs.tuple_count) {
+      insert_count = tuple_count - knobs.tuple_count;
+    }
+    if (tile_group_count > knobs.tile_group_count) {
+      new_tile_group_count = tile_group_count - knobs.tile_group_count;
+    }
+  }
+  knobs.is_seen = true;
+  knobs.tuple_count = tuple_count;
+  knobs.tile_group_count = tile_group_count;
+
+  // Contended inserts spread over more active tile groups, and gather in
+  // fewer again once the contention is gone for a while
+  size_t active_tile_group_count = table->GetActiveTileGroupCount();
+  if (latch_wait_count >= contention_threshold &&
+      insert_count >= min_insert_count) {
+    knobs.quiet_interval_count = 0;
+    if (active_tile_group_count <
+        storage::DataTable::MAX_ACTIVE_TILE_GROUP_COUNT) {
+      auto new_count =
+          table->AdjustActiveTileGroupCount(active_tile_group_count * 2);
+      LOG_DEBUG("Table %u inserts into %lu active tile groups",
+                table->GetOid(), new_count);
+    }
+  } else if (++knobs.quiet_interval_count >= shrink_interval_count) {
+    knobs.quiet_interval_count = 0;
+    size_t default_count = storage::DataTable::default_active_tilegroup_count_;
+    if (active_tile_group_count > default_count) {
+      auto new_count = table->AdjustActiveTileGroupCount(
+          std::max(active_tile_group_count / 2, default_count));
+      LOG_DEBUG("Table %u inserts into %lu active tile groups",
+                table->GetOid(), new_count);
+    }
+  }
+
+  // A table that allocates tile groups this fast gets larger ones
+  size_t tuples_per_tilegroup = table->GetTuplesPerTileGroup();
+  if (new_tile_group_count > max_tile_groups_per_interval &&
+      tuples_per_tilegroup < max_tuples_per_tilegroup) {
+    tuples_per_tilegroup =
+        std::min(tuples_per_tilegroup * 2, max_tuples_per_tilegroup);
+    table->SetTuplesPerTileGroup(tuples_per_tilegroup);
+    LOG_DEBUG("Table %u allocates tile groups of %lu tuples",
+              table->GetOid(), tuples_per_tilegroup);
+  }
+}
+
+size_t KnobTuner::GetEpochLength(const size_t epoch_length,
+                                 const uint64_t advanced_epoch_count,
+                                 const uint64_t interval_ms,
+                                 const uint64_t lag_epoch_count) const {
+  // The epoch thread falls behind its period: fewer, longer epochs
+  double expected_epoch_count = static_cast<double>(interval_ms) / epoch_length;
+  if (expected_epoch_count >= 1 &&
+      expected_epoch_count > advanced_epoch_count * max_epoch_delay) {
+    return std::min(epoch_length * 2, max_epoch_length);
+  }
+
+  // Versions wait for their epoch to expire. With only a few epochs lagging,
+  // shorter ones release them sooner. Many lagging epochs are held by long
+  // transactions, which shorter epochs do not help.
+  uint64_t lag_ms = lag_epoch_count * epoch_length;
+  if (lag_ms > gc_lag_target && lag_epoch_count <= max_short_lag_epoch_count) {
+    return std::max(epoch_length / 2, min_epoch_length);
+  }
+
+  // Longer epochs again once the GC keeps up, group commit flushes fewer
+  if (lag_ms * 4 < gc_lag_target && epoch_length < default_epoch_length) {
+    return std::min(epoch_length * 2, default_epoch_length);
+  }
+
+  return epoch_length;
+}
+
+void KnobTuner::TuneEpochLength(const uint64_t interval_ms) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  eid_t current_epoch_id = epoch_manager.GetCurrentEpochId();
+  eid_t expired_epoch_id = epoch_manager.GetExpiredEpochId();
+
+  uint64_t advanced_epoch_count = current_epoch_id - last_epoch_id;
+  last_epoch_id = current_epoch_id;
+
+  // No transaction holds an epoch back if none is running
+  uint64_t lag_epoch_count = 0;
+  if (expired_epoch_id != MAX_EID && expired_epoch_id < current_epoch_id) {
+    lag_epoch_count = current_epoch_id - expired_epoch_id;
+  }
+
+  size_t epoch_length = EPOCH_LENGTH;
+  size_t new_epoch_length = GetEpochLength(epoch_length, advanced_epoch_count,
+                                           interval_ms, lag_epoch_count);
+  if (new_epoch_length != epoch_length) {
+    // The epoch thread, the loggers and group commit pick it up on their
+    // next period
+    EPOCH_LENGTH = new_epoch_length;
+    LOG_DEBUG("Epoch length changed from %lu to %lu ms", epoch_length,
+              new_epoch_length);
+  }
+}
+
+}  // End brain namespace
+}  // End peloton namespace
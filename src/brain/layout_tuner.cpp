@@ -16,10 +16,14 @@
 #include <string>
 #include <algorithm>
 
+#include "brain/workload_forecaster.h"
 #include "catalog/schema.h"
 #include "common/logger.h"
+#include "common/maintenance_scheduler.h"
 #include "common/timer.h"
 #include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_classifier.h"
 
 namespace peloton {
 namespace brain {
@@ -81,37 +85,6 @@ std::string LayoutTuner::GetColumnMapInfo(const column_map_type& column_map) {
   return ss.str();
 }
 
-Sample GetClustererSample(const Sample& sample, oid_t column_count) {
-
-  // Copy over the sample
-  Sample clusterer_sample = sample;
-
-  // Figure out columns accessed, and construct a bitmap
-  auto& columns_accessed = sample.GetColumnsAccessed();
-  std::vector<double> columns_accessed_bitmap;
-
-  for(oid_t column_itr = 0;
-      column_itr < column_count;
-      column_itr++){
-
-    // Append column into sample
-    auto column_found = std::find(columns_accessed.begin(),
-                                  columns_accessed.end(),
-                                  column_itr) != columns_accessed.end();
-
-    if(column_found == true) {
-      columns_accessed_bitmap.push_back(1);
-    } else {
-      columns_accessed_bitmap.push_back(0);
-    }
-  }
-
-  PL_ASSERT(columns_accessed_bitmap.size() == column_count);
-  clusterer_sample.SetColumnsAccessed(columns_accessed_bitmap);
-
-  return clusterer_sample;
-}
-
 void LayoutTuner::UpdateDefaultPartition(storage::DataTable* table) {
   oid_t column_count = table->GetSchema()->GetColumnCount();
 
@@ -126,16 +99,23 @@ void LayoutTuner::UpdateDefaultPartition(storage::DataTable* table) {
     return;
   }
 
-  for (auto sample : samples) {
+  std::vector<ColumnBitmap> bitmaps;
+  bitmaps.reserve(sample_batch_size);
+  for (auto& sample : samples) {
     if (sample.GetColumnsAccessed().size() == 0) {
       continue;
     }
 
-    // Transform the regular sample to a bitmap sample for clusterer
+    // Transform the regular sample to a bitmap for clusterer
     // {0, 3} => { 1, 0, 0, 1}
-    auto clusterer_sample = GetClustererSample(sample, column_count);
-
-    clusterer.ProcessSample(clusterer_sample);
+    bitmaps.push_back(ColumnBitmap::FromColumnIds(sample, column_count));
+    if (bitmaps.size() >= sample_batch_size) {
+      clusterer.ProcessBitmaps(bitmaps);
+      bitmaps.clear();
+    }
+  }
+  if (bitmaps.empty() == false) {
+    clusterer.ProcessBitmaps(bitmaps);
   }
 
   // Clear all samples in table
@@ -150,24 +130,66 @@ void LayoutTuner::UpdateDefaultPartition(storage::DataTable* table) {
   table->SetDefaultLayout(layout);
 }
 
+size_t LayoutTuner::RelayoutTable(storage::DataTable* table) {
+  auto tile_group_count = table->GetTileGroupCount();
+  auto &tile_group_offset = relayout_offsets[table];
+  size_t moved_count = 0;
+
+  // Finish moving them before the peak rather than during it
+  size_t move_count = relayout_count;
+  if (WorkloadForecaster::GetInstance().IsPeakAhead(DEFAULT_FORECAST_HORIZON,
+                                                    DEFAULT_PEAK_RATIO)) {
+    move_count *= peak_relayout_factor;
+  }
+
+  // Visit every tile group at most once per pass. The ones that are being
+  // written are moved once they cool down.
+  for (oid_t visit_itr = 0;
+       visit_itr < tile_group_count && moved_count < move_count;
+       visit_itr++) {
+    if (tile_group_offset >= tile_group_count) {
+      tile_group_offset = 0;
+    }
+
+    // Cold tile groups are barely read, moving them is not worth it
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group != nullptr &&
+        tile_group->GetHeader()->GetTemperature() ==
+            storage::TileGroupTemperature::COLD) {
+      tile_group_offset++;
+      continue;
+    }
+
+    LOG_TRACE("Relocating tile group at offset: %u", tile_group_offset);
+    if (table->RelayoutTileGroup(tile_group_offset, theta) != nullptr) {
+      moved_count++;
+    }
+    tile_group_offset++;
+  }
+
+  return moved_count;
+}
+
 void LayoutTuner::Tune() {
   Timer<std::milli> timer;
   // Continue till signal is not false
   while (layout_tuning_stop == false) {
     // Go over all tables
     for (auto table : tables) {
-      // Transform
-      auto tile_group_count = table->GetTileGroupCount();
-      auto tile_group_offset = rand() % tile_group_count;
+      {
+        MaintenanceWork work(MaintenanceTask::LAYOUT_TUNER);
 
-      LOG_TRACE("Transforming tile group at offset: %lu", tile_group_offset);
-      table->TransformTileGroup(tile_group_offset, theta);
+        // Move a few tile groups into the current layout, skipping the cold
+        storage::TileGroupClassifier::GetInstance().ClassifyTable(table);
+        RelayoutTable(table);
 
-      // Update partitioning periodically
-      UpdateDefaultPartition(table);
+        // Update partitioning periodically
+        UpdateDefaultPartition(table);
+      }
 
       // Sleep a bit
-      std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
+      MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::LAYOUT_TUNER,
+                                                sleep_duration);
     }
   }
 }
@@ -195,6 +217,7 @@ void LayoutTuner::ClearTables() {
   {
     std::lock_guard<std::mutex> lock(layout_tuner_mutex);
     tables.clear();
+    relayout_offsets.clear();
   }
 }
 
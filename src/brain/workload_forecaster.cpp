@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// workload_forecaster.cpp
+//
+// Identification: src/brain/workload_forecaster.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "brain/workload_forecaster.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "configuration/configuration.h"
+
+namespace peloton {
+namespace brain {
+
+WorkloadForecaster::WorkloadForecaster(size_t season_length,
+                                       size_t season_count,
+                                       size_t regression_window,
+                                       size_t max_shape_count)
+    : season_length_(std::max<size_t>(season_length, 1)),
+      season_count_(std::max<size_t>(season_count, 1)),
+      regression_window_(std::max<size_t>(regression_window, 2)),
+      max_shape_count_(max_shape_count) {}
+
+WorkloadForecaster &WorkloadForecaster::GetInstance() {
+  static WorkloadForecaster workload_forecaster(
+      FLAGS_workload_forecast_season);
+  return workload_forecaster;
+}
+
+void WorkloadForecaster::RecordQuery(const std::string &shape,
+                                     const double query_count) {
+  std::lock_guard<std::mutex> lock(forecaster_mutex_);
+
+  auto series_itr = series_.find(shape);
+  if (series_itr == series_.end()) {
+    if (series_.size() >= max_shape_count_) {
+      return;
+    }
+    series_itr = series_.emplace(shape, ArrivalSeries()).first;
+    series_itr->second.first_interval = interval_count_;
+  }
+
+  series_itr->second.current_count += query_count;
+  series_itr->second.last_seen_interval = interval_count_;
+}
+
+void WorkloadForecaster::FinishInterval() {
+  std::lock_guard<std::mutex> lock(forecaster_mutex_);
+
+  size_t history_length = season_length_ * season_count_;
+  last_total_ = 0;
+  for (auto series_itr = series_.begin(); series_itr != series_.end();) {
+    auto &series = series_itr->second;
+
+    // Forget the shapes that did not arrive for as long as is kept
+    if (interval_count_ - series.last_seen_interval >= history_length) {
+      series_itr = series_.erase(series_itr);
+      continue;
+    }
+
+    last_total_ += series.current_count;
+    series.interval_counts.push_back(series.current_count);
+    series.current_count = 0;
+    if (series.interval_counts.size() > history_length) {
+      series.interval_counts.pop_front();
+      series.first_interval++;
+    }
+    ++series_itr;
+  }
+
+  interval_count_++;
+}
+
+double WorkloadForecaster::GetForecast(const std::string &shape,
+                                       const size_t horizon,
+                                       const ForecastModel model) const {
+  std::lock_guard<std::mutex> lock(forecaster_mutex_);
+
+  auto series_itr = series_.find(shape);
+  if (series_itr == series_.end()) {
+    return 0;
+  }
+  return GetForecast(series_itr->second, horizon, model);
+}
+
+double WorkloadForecaster::GetTotalForecast(const size_t horizon) const {
+  std::lock_guard<std::mutex> lock(forecaster_mutex_);
+
+  double total_forecast = 0;
+  for (auto &series_item : series_) {
+    total_forecast +=
+        GetForecast(series_item.second, horizon, FORECAST_MODEL_INVALID);
+  }
+  return total_forecast;
+}
+
+std::unordered_map<std::string, double> WorkloadForecaster::GetForecastMix(
+    const size_t horizon) const {
+  std::lock_guard<std::mutex> lock(forecaster_mutex_);
+
+  std::unordered_map<std::string, double> forecast_mix;
+  double total_forecast = 0;
+  for (auto &series_item : series_) {
+    auto forecast =
+        GetForecast(series_item.second, horizon, FORECAST_MODEL_INVALID);
+    if (forecast > 0) {
+      forecast_mix[series_item.first] = forecast;
+      total_forecast += forecast;
+    }
+  }
+
+  for (auto &mix_item : forecast_mix) {
+    mix_item.second /= total_forecast;
+  }
+  return forecast_mix;
+}
+
+bool WorkloadForecaster::IsPeakAhead(const size_t horizon,
+                                     const double peak_ratio) const {
+  auto last_total = GetLastTotal();
+  for (size_t horizon_itr = 1; horizon_itr <= horizon; horizon_itr++) {
+    auto total_forecast = GetTotalForecast(horizon_itr);
+    if (total_forecast > 0 && total_forecast >= last_total * peak_ratio) {
+      return true;
+    }
+  }
+  return false;
+}
+
+double WorkloadForecaster::GetLastTotal() const {
+  std::lock_guard<std::mutex> lock(forecaster_mutex_);
+  return last_total_;
+}
+
+uint64_t WorkloadForecaster::GetIntervalCount() const {
+  std::lock_guard<std::mutex> lock(forecaster_mutex_);
+  return interval_count_;
+}
+
+void WorkloadForecaster::Clear() {
+  std::lock_guard<std::mutex> lock(forecaster_mutex_);
+  series_.clear();
+  interval_count_ = 0;
+  last_total_ = 0;
+}
+
+double WorkloadForecaster::GetForecast(const ArrivalSeries &series,
+                                       const size_t horizon,
+                                       const ForecastModel model) const {
+  PL_ASSERT(horizon >= 1);
+
+  switch (model) {
+    case FORECAST_MODEL_SEASONAL_AVERAGE:
+      return GetSeasonalAverage(series, horizon);
+    case FORECAST_MODEL_LINEAR_REGRESSION:
+      return GetLinearRegression(series, horizon);
+    default:
+      // A season is needed for the seasonal average
+      if (series.interval_counts.size() >= season_length_) {
+        return GetSeasonalAverage(series, horizon);
+      }
+      return GetLinearRegression(series, horizon);
+  }
+}
+
+double WorkloadForecaster::GetSeasonalAverage(const ArrivalSeries &series,
+                                              const size_t horizon) const {
+  // The interval to forecast, and the same one of the seasons before
+  uint64_t target_interval = interval_count_ + horizon - 1;
+  uint64_t last_interval =
+      series.first_interval + series.interval_counts.size();
+
+  double count_sum = 0;
+  size_t season_itr = 0;
+  for (uint64_t interval = target_interval;
+       interval >= season_length_ + series.first_interval;) {
+    interval -= season_length_;
+    if (interval < last_interval) {
+      count_sum += series.interval_counts[interval - series.first_interval];
+      season_itr++;
+    }
+    if (season_itr == season_count_) {
+      break;
+    }
+  }
+
+  if (season_itr == 0) {
+    return 0;
+  }
+  return count_sum / season_itr;
+}
+
+double WorkloadForecaster::GetLinearRegression(const ArrivalSeries &series,
+                                               const size_t horizon) const {
+  auto &interval_counts = series.interval_counts;
+  size_t point_count = std::min(interval_counts.size(), regression_window_);
+  if (point_count == 0) {
+    return 0;
+  }
+
+  // Least squares over the last points, x being the interval from the
+  // first of them
+  size_t first_point = interval_counts.size() - point_count;
+  double x_mean = (point_count - 1) / 2.0;
+  double y_mean = 0;
+  for (size_t point_itr = 0; point_itr < point_count; point_itr++) {
+    y_mean += interval_counts[first_point + point_itr];
+  }
+  y_mean /= point_count;
+
+  double covariance = 0;
+  double variance = 0;
+  for (size_t point_itr = 0; point_itr < point_count; point_itr++) {
+    double x_diff = point_itr - x_mean;
+    covariance += x_diff * (interval_counts[first_point + point_itr] - y_mean);
+    variance += x_diff * x_diff;
+  }
+  double slope = variance == 0 ? 0 : covariance / variance;
+
+  // The series ends with the last finished interval
+  double x = (point_count - 1) + horizon;
+  return std::max(y_mean + slope * (x - x_mean), 0.0);
+}
+
+}  // End brain namespace
+}  // End peloton namespace
@@ -12,9 +12,12 @@
 
 #include "catalog/abstract_catalog.h"
 
+#include <iterator>
+
 #include "catalog/catalog.h"
 #include "catalog/table_catalog.h"
 #include "common/statement.h"
+#include "concurrency/transaction.h"
 #include "index/index_factory.h"
 #include "optimizer/optimizer.h"
 #include "parser/postgresparser.h"
@@ -95,6 +98,42 @@ bool AbstractCatalog::InsertTuple(std::unique_ptr<storage::Tuple> tuple,
   return status;
 }
 
+/*@brief   insert tuples(records) in bulk helper function
+* The tuples that fill whole tile groups are appended to fresh ones, the rest
+* are inserted one by one into the tile groups the table has
+* @param   tuples    tuples to be inserted
+* @param   txn       Transaction
+* @return  Whether insertion is Successful
+*/
+bool AbstractCatalog::BulkInsertTuples(
+    std::vector<std::unique_ptr<storage::Tuple>> tuples,
+    concurrency::Transaction *txn) {
+  if (txn == nullptr)
+    throw CatalogException("Insert tuple requires transaction");
+
+  size_t tuples_per_tile_group = catalog_table_->GetTuplesPerTileGroup();
+  size_t bulk_count =
+      tuples.size() - tuples.size() % tuples_per_tile_group;
+  if (bulk_count > 0) {
+    std::vector<std::unique_ptr<storage::Tuple>> bulk_tuples(
+        std::make_move_iterator(tuples.begin()),
+        std::make_move_iterator(tuples.begin() + bulk_count));
+    if (catalog_table_->BulkInsert(bulk_tuples, txn) == false) {
+      txn->SetResult(ResultType::FAILURE);
+      return false;
+    }
+  }
+
+  for (size_t tuple_itr = bulk_count; tuple_itr < tuples.size();
+       tuple_itr++) {
+    if (InsertTuple(std::move(tuples[tuple_itr]), txn) == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /*@brief   Delete a tuple using index scan
 * @param   index_offset  Offset of index for scan
 * @param   values        Values for search
@@ -144,6 +183,45 @@ bool AbstractCatalog::DeleteWithIndexScan(oid_t index_offset,
   return status;
 }
 
+/*@brief   Delete tuples using sequential scan
+* NOTE: only for catalog tables that are rarely cleaned up, such as the
+* metrics tables
+* @param   predicate     predicate of the tuples to delete, owned by the scan
+* @param   txn           Transaction
+* @return  Whether deletion is Successful
+*/
+bool AbstractCatalog::DeleteWithSeqScan(
+    expression::AbstractExpression *predicate,
+    concurrency::Transaction *txn) {
+  if (txn == nullptr)
+    throw CatalogException("Delete tuple requires transaction");
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  // Delete node
+  planner::DeletePlan delete_node(catalog_table_, false);
+  executor::DeleteExecutor delete_executor(&delete_node, context.get());
+
+  // Sequential scan as child node
+  std::vector<oid_t> column_offsets;  // No projection
+  std::unique_ptr<planner::SeqScanPlan> seq_scan_node(
+      new planner::SeqScanPlan(catalog_table_, predicate, column_offsets));
+  executor::SeqScanExecutor seq_scan_executor(seq_scan_node.get(),
+                                              context.get());
+
+  // Parent-Child relationship
+  delete_node.AddChild(std::move(seq_scan_node));
+  delete_executor.AddChild(&seq_scan_executor);
+  delete_executor.Init();
+
+  // Every call deletes the tuples of one logical tile from the scan
+  while (delete_executor.Execute()) {
+  }
+
+  return txn->GetResult() == ResultType::SUCCESS;
+}
+
 /*@brief   Index scan helper function
 * @param   column_offsets    Column ids for search (projection)
 * @param   index_offset      Offset of index for scan
@@ -20,11 +20,15 @@
 #include "catalog/table_catalog.h"
 #include "catalog/table_metrics_catalog.h"
 #include "catalog/index_metrics_catalog.h"
+#include "codegen/background_compiler.h"
+#include "codegen/query_cache.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "expression/date_functions.h"
 #include "expression/string_functions.h"
 #include "expression/decimal_functions.h"
+#include "expression/expression_util.h"
 #include "index/index_factory.h"
+#include "storage/partitioned_table.h"
 #include "storage/storage_manager.h"
 #include "storage/table_factory.h"
 #include "type/ephemeral_pool.h"
@@ -180,6 +184,7 @@ ResultType Catalog::CreateDatabase(const std::string &database_name,
 
   // Insert database record into pg_db
   pg_database->InsertDatabase(database_oid, database_name, pool_.get(), txn);
+  RecordChange(txn);
 
   LOG_TRACE("Database %s created. Returning RESULT_SUCCESS.",
             database_name.c_str());
@@ -264,6 +269,7 @@ ResultType Catalog::CreateTable(const std::string &database_name,
     }
 
     CreatePrimaryIndex(database_oid, table_oid, txn);
+    RecordChange(txn);
 
     return ResultType::SUCCESS;
   } catch (CatalogException &e) {
@@ -371,7 +377,8 @@ ResultType Catalog::CreateIndex(const std::string &database_name,
                                 const std::vector<std::string> &index_attr,
                                 const std::string &index_name, bool unique_keys,
                                 IndexType index_type,
-                                concurrency::Transaction *txn) {
+                                concurrency::Transaction *txn,
+                                const expression::AbstractExpression *predicate) {
   if (txn == nullptr) {
     LOG_TRACE("Do not have transaction to create index: %s",
               index_name.c_str());
@@ -400,12 +407,25 @@ ResultType Catalog::CreateIndex(const std::string &database_name,
     return ResultType::FAILURE;
   }
 
+  // the partitions have indexes of their own
+  try {
+    if (storage::StorageManager::GetInstance()
+            ->GetTableWithOid(database_oid, table_oid)
+            ->GetPartitionedTable() != nullptr) {
+      LOG_TRACE("Cannot create index %s on partitioned table %s",
+                index_name.c_str(), table_name.c_str());
+      return ResultType::FAILURE;
+    }
+  } catch (CatalogException &e) {
+    return ResultType::FAILURE;
+  }
+
   IndexConstraintType index_constraint =
       unique_keys ? IndexConstraintType::UNIQUE : IndexConstraintType::DEFAULT;
 
   ResultType success =
       CreateIndex(database_oid, table_oid, index_attr, index_name, index_type,
-                  index_constraint, unique_keys, txn);
+                  index_constraint, unique_keys, txn, false, predicate);
 
   return success;
 }
@@ -416,7 +436,8 @@ ResultType Catalog::CreateIndex(oid_t database_oid, oid_t table_oid,
                                 IndexType index_type,
                                 IndexConstraintType index_constraint,
                                 bool unique_keys, concurrency::Transaction *txn,
-                                bool is_catalog) {
+                                bool is_catalog,
+                                const expression::AbstractExpression *predicate) {
   if (txn == nullptr) {
     LOG_TRACE("Do not have transaction to create index: %s",
               index_name.c_str());
@@ -474,6 +495,15 @@ ResultType Catalog::CreateIndex(oid_t database_oid, oid_t table_oid,
           index_type, index_constraint, schema, key_schema, key_attrs,
           unique_keys);
 
+      // A partial index evaluates its predicate on the tuples of the table
+      if (predicate != nullptr) {
+        std::shared_ptr<expression::AbstractExpression> index_predicate(
+            predicate->Copy());
+        expression::ExpressionUtil::TransformExpression(schema,
+                                                        index_predicate.get());
+        index_metadata->SetPredicate(index_predicate);
+      }
+
       // Add index to table
       std::shared_ptr<index::Index> key_index(
           index::IndexFactory::GetIndex(index_metadata));
@@ -487,6 +517,8 @@ ResultType Catalog::CreateIndex(oid_t database_oid, oid_t table_oid,
       LOG_TRACE("Successfully add index for table %s contains %d indexes",
                 table->GetName().c_str(), (int)table->GetValidIndexCount());
 
+      RecordChange(txn);
+
       return ResultType::SUCCESS;
     } catch (CatalogException &e) {
       LOG_TRACE(
@@ -504,6 +536,79 @@ ResultType Catalog::CreateIndex(oid_t database_oid, oid_t table_oid,
   }
 }
 
+ResultType Catalog::CreatePartitions(
+    const std::string &database_name, const std::string &table_name,
+    const std::string &column_name,
+    const storage::PartitionType partition_type,
+    const std::vector<type::Value> &lower_bounds, const size_t partition_count,
+    concurrency::Transaction *txn) {
+  if (txn == nullptr) {
+    LOG_TRACE("Do not have transaction to partition table: %s",
+              table_name.c_str());
+    return ResultType::FAILURE;
+  }
+
+  storage::DataTable *table = nullptr;
+  try {
+    table = GetTableWithName(database_name, table_name, txn);
+  } catch (CatalogException &e) {
+    LOG_TRACE("Cannot find table %s to partition", table_name.c_str());
+    return ResultType::FAILURE;
+  }
+  auto schema = table->GetSchema();
+  oid_t column_id = schema->GetColumnID(column_name);
+  size_t count = (partition_type == storage::PartitionType::RANGE)
+                     ? lower_bounds.size()
+                     : partition_count;
+  // the partitions do not carry the foreign keys of the table, which it
+  // would then no longer check
+  if (column_id == INVALID_OID || count == 0 ||
+      table->GetPartitionedTable() != nullptr || table->GetTupleCount() > 0 ||
+      table->HasForeignKeys() == true) {
+    LOG_TRACE("Cannot partition table %s by %s", table_name.c_str(),
+              column_name.c_str());
+    return ResultType::FAILURE;
+  }
+
+  std::unique_ptr<storage::PartitionedTable> partitioned_table(
+      new storage::PartitionedTable(table_name, partition_type, column_id));
+  for (size_t partition_offset = 0; partition_offset < count;
+       partition_offset++) {
+    std::string partition_name =
+        table_name + "_" + std::to_string(partition_offset);
+    std::unique_ptr<catalog::Schema> partition_schema(
+        catalog::Schema::CopySchema(schema));
+    if (CreateTable(database_name, partition_name, std::move(partition_schema),
+                    txn) != ResultType::SUCCESS) {
+      return ResultType::FAILURE;
+    }
+
+    auto partition = GetTableWithName(database_name, partition_name, txn);
+    bool added = false;
+    if (partition_type == storage::PartitionType::RANGE) {
+      auto lower_bound =
+          lower_bounds[partition_offset].CastAs(schema->GetType(column_id));
+      added = partitioned_table->AddPartition(partition, lower_bound);
+    } else {
+      added = partitioned_table->AddPartition(partition);
+    }
+    if (added == false) {
+      LOG_TRACE("Cannot add partition %s", partition_name.c_str());
+      return ResultType::FAILURE;
+    }
+  }
+
+  // the table itself stays empty
+  for (oid_t index_oid :
+       IndexCatalog::GetInstance()->GetIndexOids(table->GetOid(), txn)) {
+    DropIndex(index_oid, txn);
+  }
+  table->SetPartitionedTable(std::move(partitioned_table));
+  RecordChange(txn);
+
+  return ResultType::SUCCESS;
+}
+
 //===----------------------------------------------------------------------===//
 // DROP FUNCTIONS
 //===----------------------------------------------------------------------===//
@@ -544,12 +649,18 @@ ResultType Catalog::DropDatabaseWithOid(oid_t database_oid,
     DropTable(database_oid, table_oid, txn);
   }
 
+  // Tables that were added to the database without the catalog may still be
+  // in compiled queries
+  codegen::BackgroundCompiler::GetInstance().WaitForAll();
+  codegen::QueryCache::GetInstance().RemoveDatabase(database_oid);
+
   // Drop database record in catalog
   LOG_TRACE("Deleting tuple from pg_db");
   if (!DatabaseCatalog::GetInstance()->DeleteDatabase(database_oid, txn)) {
     LOG_TRACE("Database tuple is not found in pg_db!");
     return ResultType::FAILURE;
   }
+  RecordChange(txn);
 
   // Drop actual database object
   LOG_TRACE("Dropping database with oid: %d", database_oid);
@@ -617,6 +728,18 @@ ResultType Catalog::DropTable(oid_t database_oid, oid_t table_oid,
     auto database = storage_manager->GetDatabaseWithOid(database_oid);
     // auto table = database->GetTableWithOid(table_oid);
     LOG_TRACE("Deleting table!");
+    // STEP 0, the partitions go with the table
+    auto partitioned_table =
+        database->GetTableWithOid(table_oid)->GetPartitionedTable();
+    if (partitioned_table != nullptr) {
+      for (oid_t partition_offset = 0;
+           partition_offset < partitioned_table->GetPartitionCount();
+           partition_offset++) {
+        DropTable(database_oid,
+                  partitioned_table->GetPartition(partition_offset)->GetOid(),
+                  txn);
+      }
+    }
     // STEP 1, read index_oids from pg_index, and iterate through
     auto index_oids = IndexCatalog::GetInstance()->GetIndexOids(table_oid, txn);
     LOG_TRACE("dropping #%d indexes", (int)index_oids.size());
@@ -627,7 +750,10 @@ ResultType Catalog::DropTable(oid_t database_oid, oid_t table_oid,
     // STEP 3
     TableCatalog::GetInstance()->DeleteTable(table_oid, txn);
     // STEP 4
+    codegen::BackgroundCompiler::GetInstance().WaitForAll();
+    codegen::QueryCache::GetInstance().RemoveTable(database_oid, table_oid);
     database->DropTableWithOid(table_oid);
+    RecordChange(txn);
 
     return ResultType::SUCCESS;
   } catch (CatalogException &e) {
@@ -636,6 +762,51 @@ ResultType Catalog::DropTable(oid_t database_oid, oid_t table_oid,
   }
 }
 
+ResultType Catalog::DropPartitionsBefore(const std::string &database_name,
+                                         const std::string &table_name,
+                                         const type::Value &bound,
+                                         concurrency::Transaction *txn) {
+  if (txn == nullptr) {
+    LOG_TRACE("Do not have transaction to drop partitions: %s",
+              table_name.c_str());
+    return ResultType::FAILURE;
+  }
+
+  storage::DataTable *table = nullptr;
+  try {
+    table = GetTableWithName(database_name, table_name, txn);
+  } catch (CatalogException &e) {
+    LOG_TRACE("Cannot find table %s to drop partitions", table_name.c_str());
+    return ResultType::FAILURE;
+  }
+  auto partitioned_table = table->GetPartitionedTable();
+  if (partitioned_table == nullptr ||
+      partitioned_table->GetPartitionType() != storage::PartitionType::RANGE) {
+    return ResultType::FAILURE;
+  }
+
+  // the tables, and their indexes, are destroyed once no scan can reach
+  // them, only their entries are deleted right away
+  auto column_type =
+      table->GetSchema()->GetType(partitioned_table->GetPartitionColumn());
+  oid_t database_oid = table->GetDatabaseOid();
+  codegen::BackgroundCompiler::GetInstance().WaitForAll();
+  for (oid_t partition_oid :
+       partitioned_table->DropPartitionsBefore(bound.CastAs(column_type))) {
+    for (oid_t index_oid :
+         IndexCatalog::GetInstance()->GetIndexOids(partition_oid, txn)) {
+      IndexCatalog::GetInstance()->DeleteIndex(index_oid, txn);
+    }
+    ColumnCatalog::GetInstance()->DeleteColumns(partition_oid, txn);
+    TableCatalog::GetInstance()->DeleteTable(partition_oid, txn);
+    codegen::QueryCache::GetInstance().RemoveTable(database_oid,
+                                                   partition_oid);
+  }
+  RecordChange(txn);
+
+  return ResultType::SUCCESS;
+}
+
 /*@brief   Drop Index on table
 * @param   index_oid      the oid of the index to be dropped
 * @param   txn            Transaction
@@ -671,6 +842,7 @@ ResultType Catalog::DropIndex(oid_t index_oid, concurrency::Transaction *txn) {
 
       // drop record in pg_index
       IndexCatalog::GetInstance()->DeleteIndex(index_oid, txn);
+      RecordChange(txn);
 
       LOG_TRACE("Successfully drop index %d for table %s", index_oid,
                 table->GetName().c_str());
@@ -704,6 +876,21 @@ storage::Database *Catalog::GetDatabaseWithName(
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   bool single_statement_txn = false;
   auto storage_manager = storage::StorageManager::GetInstance();
+
+  // Try the cache first, unless the transaction changed the catalog itself
+  bool use_cache = (txn == nullptr || txn->HasChangedCatalog() == false);
+  if (use_cache == true) {
+    oid_t database_oid = cache_.GetDatabaseOid(database_name);
+    if (database_oid != INVALID_OID) {
+      try {
+        return storage_manager->GetDatabaseWithOid(database_oid);
+      } catch (CatalogException &e) {
+        cache_.EraseDatabase(database_name, database_oid);
+      }
+    }
+  }
+  uint64_t cache_version = cache_.GetVersion();
+
   if (txn == nullptr) {
     single_statement_txn = true;
     txn = txn_manager.BeginTransaction();
@@ -722,7 +909,11 @@ storage::Database *Catalog::GetDatabaseWithName(
     txn_manager.CommitTransaction(txn);
   }
 
-  return storage_manager->GetDatabaseWithOid(database_oid);
+  auto database = storage_manager->GetDatabaseWithOid(database_oid);
+  if (use_cache == true) {
+    cache_.AddDatabase(cache_version, database_name, database_oid);
+  }
+  return database;
 }
 
 /* Check table from pg_table with table_name using txn,
@@ -736,14 +927,33 @@ storage::DataTable *Catalog::GetTableWithName(const std::string &database_name,
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto storage_manager = storage::StorageManager::GetInstance();
   bool single_statement_txn = false;
+
+  LOG_TRACE("Looking for table %s in database %s", table_name.c_str(),
+            database_name.c_str());
+
+  // Try the cache first, unless the transaction changed the catalog itself
+  bool use_cache = (txn == nullptr || txn->HasChangedCatalog() == false);
+  if (use_cache == true) {
+    oid_t database_oid = cache_.GetDatabaseOid(database_name);
+    oid_t table_oid = INVALID_OID;
+    if (database_oid != INVALID_OID) {
+      table_oid = cache_.GetTableOid(database_oid, table_name);
+    }
+    if (table_oid != INVALID_OID) {
+      try {
+        return storage_manager->GetTableWithOid(database_oid, table_oid);
+      } catch (CatalogException &e) {
+        cache_.EraseTable(database_oid, table_name, table_oid);
+      }
+    }
+  }
+  uint64_t cache_version = cache_.GetVersion();
+
   if (txn == nullptr) {
     single_statement_txn = true;
     txn = txn_manager.BeginTransaction();
   }
 
-  LOG_TRACE("Looking for table %s in database %s", table_name.c_str(),
-            database_name.c_str());
-
   // Check in pg_database, throw exception and abort txn if not exists
   auto database_oid =
       DatabaseCatalog::GetInstance()->GetDatabaseOid(database_name, txn);
@@ -766,7 +976,12 @@ storage::DataTable *Catalog::GetTableWithName(const std::string &database_name,
     txn_manager.CommitTransaction(txn);
   }
 
-  return storage_manager->GetTableWithOid(database_oid, table_oid);
+  auto table = storage_manager->GetTableWithOid(database_oid, table_oid);
+  if (use_cache == true) {
+    cache_.AddDatabase(cache_version, database_name, database_oid);
+    cache_.AddTable(cache_version, database_oid, table_name, table_oid);
+  }
+  return table;
 }
 
 //===--------------------------------------------------------------------===//
@@ -784,12 +999,18 @@ void Catalog::AddDatabase(storage::Database *database) {
       database->GetOid(), database->GetDBName(), pool_.get(),
       txn);  // I guess this can pass tests
   txn_manager.CommitTransaction(txn);
+  cache_.Reset();
 }
 
 //===--------------------------------------------------------------------===//
 // HELPERS
 //===--------------------------------------------------------------------===//
 
+void Catalog::RecordChange(concurrency::Transaction *txn) {
+  txn->RecordCatalogChange();
+  cache_.Reset();
+}
+
 Catalog::~Catalog() {
   storage::StorageManager::GetInstance()->DestroyDatabases();
 }
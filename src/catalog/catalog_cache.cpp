@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// catalog_cache.cpp
+//
+// Identification: src/catalog/catalog_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/catalog_cache.h"
+
+#include <memory>
+
+namespace peloton {
+namespace catalog {
+
+CatalogCache::CatalogCache() : snapshot_(new CatalogSnapshot()) {}
+
+CatalogCache::~CatalogCache() { delete snapshot_.load(); }
+
+oid_t CatalogCache::GetDatabaseOid(const std::string &database_name) const {
+  lock_free_locator::ReadGuard guard;
+  auto snapshot = snapshot_.load();
+  auto itr = snapshot->database_oids.find(database_name);
+  if (itr == snapshot->database_oids.end()) {
+    return INVALID_OID;
+  }
+  return itr->second;
+}
+
+oid_t CatalogCache::GetTableOid(const oid_t database_oid,
+                                const std::string &table_name) const {
+  lock_free_locator::ReadGuard guard;
+  auto snapshot = snapshot_.load();
+  auto database_itr = snapshot->table_oids.find(database_oid);
+  if (database_itr == snapshot->table_oids.end()) {
+    return INVALID_OID;
+  }
+  auto table_itr = database_itr->second.find(table_name);
+  if (table_itr == database_itr->second.end()) {
+    return INVALID_OID;
+  }
+  return table_itr->second;
+}
+
+uint64_t CatalogCache::GetVersion() const {
+  lock_free_locator::ReadGuard guard;
+  return snapshot_.load()->version;
+}
+
+void CatalogCache::AddDatabase(const uint64_t version,
+                               const std::string &database_name,
+                               const oid_t database_oid) {
+  Publish([&](CatalogSnapshot &snapshot) {
+    if (snapshot.version != version) {
+      return false;
+    }
+    return snapshot.database_oids.emplace(database_name, database_oid).second;
+  });
+}
+
+void CatalogCache::AddTable(const uint64_t version, const oid_t database_oid,
+                            const std::string &table_name,
+                            const oid_t table_oid) {
+  Publish([&](CatalogSnapshot &snapshot) {
+    if (snapshot.version != version) {
+      return false;
+    }
+    return snapshot.table_oids[database_oid]
+        .emplace(table_name, table_oid)
+        .second;
+  });
+}
+
+void CatalogCache::EraseDatabase(const std::string &database_name,
+                                 const oid_t database_oid) {
+  Publish([&](CatalogSnapshot &snapshot) {
+    auto itr = snapshot.database_oids.find(database_name);
+    if (itr == snapshot.database_oids.end() || itr->second != database_oid) {
+      return false;
+    }
+    snapshot.database_oids.erase(itr);
+    return true;
+  });
+}
+
+void CatalogCache::EraseTable(const oid_t database_oid,
+                              const std::string &table_name,
+                              const oid_t table_oid) {
+  Publish([&](CatalogSnapshot &snapshot) {
+    auto &tables = snapshot.table_oids[database_oid];
+    auto itr = tables.find(table_name);
+    if (itr == tables.end() || itr->second != table_oid) {
+      return false;
+    }
+    tables.erase(itr);
+    return true;
+  });
+}
+
+void CatalogCache::Reset() {
+  std::lock_guard<std::mutex> lock(publish_mutex_);
+  std::unique_ptr<CatalogSnapshot> next_snapshot(new CatalogSnapshot());
+  next_snapshot->version = snapshot_.load()->version + 1;
+  retired_.Retire(snapshot_.exchange(next_snapshot.release()));
+}
+
+template <typename Change>
+void CatalogCache::Publish(Change change) {
+  std::lock_guard<std::mutex> lock(publish_mutex_);
+  std::unique_ptr<CatalogSnapshot> next_snapshot(
+      new CatalogSnapshot(*snapshot_.load()));
+  if (change(*next_snapshot) == false) {
+    return;
+  }
+  retired_.Retire(snapshot_.exchange(next_snapshot.release()));
+}
+
+}  // namespace catalog
+}  // namespace peloton
@@ -37,7 +37,14 @@ IndexMetricsCatalog::IndexMetricsCatalog(concurrency::Transaction *txn)
                       "reads          INT NOT NULL, "
                       "deletes        INT NOT NULL, "
                       "inserts        INT NOT NULL, "
-                      "time_stamp     INT NOT NULL);",
+                      "time_stamp     INT NOT NULL, "
+                      "consolidations INT NOT NULL, "
+                      "splits         INT NOT NULL, "
+                      "merges         INT NOT NULL, "
+                      "cas_failures   INT NOT NULL, "
+                      "epochs         INT NOT NULL, "
+                      "garbage_nodes  INT NOT NULL, "
+                      "delta_chain_threshold INT NOT NULL);",
                       txn) {
   // Add secondary index here if necessary
 }
@@ -47,7 +54,10 @@ IndexMetricsCatalog::~IndexMetricsCatalog() {}
 bool IndexMetricsCatalog::InsertIndexMetrics(
     oid_t database_oid, oid_t table_oid, oid_t index_oid, int64_t reads,
     int64_t deletes, int64_t inserts, int64_t time_stamp,
-    type::AbstractPool *pool, concurrency::Transaction *txn) {
+    int64_t consolidations, int64_t splits, int64_t merges,
+    int64_t cas_failures, int64_t epochs, int64_t garbage_nodes,
+    int64_t delta_chain_threshold, type::AbstractPool *pool,
+    concurrency::Transaction *txn) {
   std::unique_ptr<storage::Tuple> tuple(
       new storage::Tuple(catalog_table_->GetSchema(), true));
 
@@ -58,6 +68,13 @@ bool IndexMetricsCatalog::InsertIndexMetrics(
   auto val4 = type::ValueFactory::GetIntegerValue(deletes);
   auto val5 = type::ValueFactory::GetIntegerValue(inserts);
   auto val6 = type::ValueFactory::GetIntegerValue(time_stamp);
+  auto val7 = type::ValueFactory::GetIntegerValue(consolidations);
+  auto val8 = type::ValueFactory::GetIntegerValue(splits);
+  auto val9 = type::ValueFactory::GetIntegerValue(merges);
+  auto val10 = type::ValueFactory::GetIntegerValue(cas_failures);
+  auto val11 = type::ValueFactory::GetIntegerValue(epochs);
+  auto val12 = type::ValueFactory::GetIntegerValue(garbage_nodes);
+  auto val13 = type::ValueFactory::GetIntegerValue(delta_chain_threshold);
 
   tuple->SetValue(ColumnId::DATABASE_OID, val0, pool);
   tuple->SetValue(ColumnId::TABLE_OID, val1, pool);
@@ -66,6 +83,13 @@ bool IndexMetricsCatalog::InsertIndexMetrics(
   tuple->SetValue(ColumnId::DELETES, val4, pool);
   tuple->SetValue(ColumnId::INSERTS, val5, pool);
   tuple->SetValue(ColumnId::TIME_STAMP, val6, pool);
+  tuple->SetValue(ColumnId::CONSOLIDATIONS, val7, pool);
+  tuple->SetValue(ColumnId::SPLITS, val8, pool);
+  tuple->SetValue(ColumnId::MERGES, val9, pool);
+  tuple->SetValue(ColumnId::CAS_FAILURES, val10, pool);
+  tuple->SetValue(ColumnId::EPOCHS, val11, pool);
+  tuple->SetValue(ColumnId::GARBAGE_NODES, val12, pool);
+  tuple->SetValue(ColumnId::DELTA_CHAIN_THRESHOLD, val13, pool);
 
   // Insert the tuple
   return InsertTuple(std::move(tuple), txn);
@@ -17,14 +17,11 @@
 #include "storage/database.h"
 #include "storage/data_table.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "concurrency/epoch_manager_factory.h"
 
 namespace peloton {
 namespace catalog {
 
-std::shared_ptr<storage::TileGroup> Manager::empty_tile_group_;
-
-std::shared_ptr<storage::IndirectionArray> Manager::empty_indirection_array_;
-
 Manager &Manager::GetInstance() {
   static Manager manager;
   return manager;
@@ -38,13 +35,80 @@ void Manager::AddTileGroup(const oid_t oid,
                            std::shared_ptr<storage::TileGroup> location) {
 
   // add/update the catalog reference to the tile group
-  tile_group_locator_.Update(oid, location);
+  RetireTileGroup(tile_group_locator_.Update(oid, location));
 }
 
 void Manager::DropTileGroup(const oid_t oid) {
   
   // drop the catalog reference to the tile group
-  tile_group_locator_.Erase(oid, empty_tile_group_);
+  RetireTileGroup(tile_group_locator_.Erase(oid));
+}
+
+void Manager::RetireTileGroup(std::shared_ptr<storage::TileGroup> tile_group) {
+  if (tile_group == nullptr) {
+    return;
+  }
+
+  // the transactions in the current epoch may have resolved the tile group
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  {
+    std::lock_guard<std::mutex> lock(retired_tile_groups_mutex_);
+    retired_tile_groups_.emplace_back(epoch_manager.GetCurrentEpochId(),
+                                      std::move(tile_group));
+  }
+
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  if (expired_eid != MAX_EID) {
+    ReleaseRetiredTileGroups(expired_eid);
+  }
+}
+
+size_t Manager::ReleaseRetiredTileGroups(const eid_t expired_eid) {
+  // the tile groups are destroyed after the lock is released
+  std::vector<std::shared_ptr<storage::TileGroup>> released;
+  {
+    std::lock_guard<std::mutex> lock(retired_tile_groups_mutex_);
+    while (retired_tile_groups_.empty() == false &&
+           retired_tile_groups_.front().first <= expired_eid) {
+      released.push_back(std::move(retired_tile_groups_.front().second));
+      retired_tile_groups_.pop_front();
+    }
+  }
+  return released.size();
+}
+
+void Manager::RetireTable(storage::DataTable *table) {
+  if (table == nullptr) {
+    return;
+  }
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  {
+    std::lock_guard<std::mutex> lock(retired_tables_mutex_);
+    retired_tables_.emplace_back(epoch_manager.GetCurrentEpochId(), table);
+  }
+
+  auto expired_eid = epoch_manager.GetExpiredEpochId();
+  if (expired_eid != MAX_EID) {
+    ReleaseRetiredTables(expired_eid);
+  }
+}
+
+size_t Manager::ReleaseRetiredTables(const eid_t expired_eid) {
+  // the tables retire their tile groups, after the lock is released
+  std::vector<storage::DataTable *> released;
+  {
+    std::lock_guard<std::mutex> lock(retired_tables_mutex_);
+    while (retired_tables_.empty() == false &&
+           retired_tables_.front().first <= expired_eid) {
+      released.push_back(retired_tables_.front().second);
+      retired_tables_.pop_front();
+    }
+  }
+  for (auto table : released) {
+    delete table;
+  }
+  return released.size();
 }
 
 std::shared_ptr<storage::TileGroup> Manager::GetTileGroup(const oid_t oid) {
@@ -58,7 +122,10 @@ std::shared_ptr<storage::TileGroup> Manager::GetTileGroup(const oid_t oid) {
 // used for logging test
 void Manager::ClearTileGroup() {
 
-  tile_group_locator_.Clear(empty_tile_group_);
+  tile_group_locator_.Clear();
+
+  std::lock_guard<std::mutex> lock(retired_tile_groups_mutex_);
+  retired_tile_groups_.clear();
 }
 
 
@@ -72,14 +139,14 @@ void Manager::AddIndirectionArray(const oid_t oid,
 void Manager::DropIndirectionArray(const oid_t oid) {
   
   // drop the catalog reference to the tile group
-  indirection_array_locator_.Erase(oid, empty_indirection_array_);
+  indirection_array_locator_.Erase(oid);
 }
 
 
 // used for logging test
 void Manager::ClearIndirectionArray() {
 
-  indirection_array_locator_.Clear(empty_indirection_array_);
+  indirection_array_locator_.Clear();
 }
 
 }  // End catalog namespace
@@ -14,6 +14,7 @@
 
 #include "catalog/catalog.h"
 #include "executor/logical_tile.h"
+#include "expression/expression_util.h"
 #include "storage/data_table.h"
 #include "storage/tuple.h"
 
@@ -63,6 +64,28 @@ bool QueryMetricsCatalog::InsertQueryMetrics(
     int64_t updates, int64_t deletes, int64_t inserts, int64_t latency,
     int64_t cpu_time, int64_t time_stamp, type::AbstractPool *pool,
     concurrency::Transaction *txn) {
+  auto tuple = GetQueryMetricsTuple(name, database_oid, num_params, type_buf,
+                                    format_buf, value_buf, reads, updates,
+                                    deletes, inserts, latency, cpu_time,
+                                    time_stamp, pool);
+
+  // Insert the tuple
+  return InsertTuple(std::move(tuple), txn);
+}
+
+bool QueryMetricsCatalog::InsertQueryMetrics(
+    std::vector<std::unique_ptr<storage::Tuple>> tuples,
+    concurrency::Transaction *txn) {
+  return BulkInsertTuples(std::move(tuples), txn);
+}
+
+std::unique_ptr<storage::Tuple> QueryMetricsCatalog::GetQueryMetricsTuple(
+    const std::string &name, oid_t database_oid, int64_t num_params,
+    const stats::QueryMetric::QueryParamBuf &type_buf,
+    const stats::QueryMetric::QueryParamBuf &format_buf,
+    const stats::QueryMetric::QueryParamBuf &value_buf, int64_t reads,
+    int64_t updates, int64_t deletes, int64_t inserts, int64_t latency,
+    int64_t cpu_time, int64_t time_stamp, type::AbstractPool *pool) {
   std::unique_ptr<storage::Tuple> tuple(
       new storage::Tuple(catalog_table_->GetSchema(), true));
 
@@ -105,8 +128,7 @@ bool QueryMetricsCatalog::InsertQueryMetrics(
   tuple->SetValue(ColumnId::CPU_TIME, val11, pool);
   tuple->SetValue(ColumnId::TIME_STAMP, val12, pool);
 
-  // Insert the tuple
-  return InsertTuple(std::move(tuple), txn);
+  return tuple;
 }
 
 bool QueryMetricsCatalog::DeleteQueryMetrics(const std::string &name,
@@ -121,6 +143,18 @@ bool QueryMetricsCatalog::DeleteQueryMetrics(const std::string &name,
   return DeleteWithIndexScan(index_offset, values, txn);
 }
 
+bool QueryMetricsCatalog::DeleteQueryMetricsBefore(
+    int64_t time_stamp, concurrency::Transaction *txn) {
+  auto predicate = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_LESSTHAN,
+      expression::ExpressionUtil::TupleValueFactory(
+          type::TypeId::INTEGER, 0, ColumnId::TIME_STAMP),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(time_stamp)));
+
+  return DeleteWithSeqScan(predicate, txn);
+}
+
 stats::QueryMetric::QueryParamBuf QueryMetricsCatalog::GetParamTypes(
     const std::string &name, oid_t database_oid,
     concurrency::Transaction *txn) {
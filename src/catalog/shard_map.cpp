@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_map.cpp
+//
+// Identification: src/catalog/shard_map.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/shard_map.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "common/logger.h"
+#include "murmur3/MurmurHash3.h"
+#include "networking/network_address.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace catalog {
+
+bool ShardMap::Configure(const std::string &node_addresses,
+                         const size_t node_id,
+                         const std::string &sharded_tables) {
+  node_addresses_.clear();
+  node_id_ = 0;
+  tables_.clear();
+
+  std::vector<std::string> addresses;
+  for (auto &address : StringUtil::Split(node_addresses, ",")) {
+    if (address.empty() == true) {
+      continue;
+    }
+    networking::NetworkAddress network_address;
+    if (network_address.Parse(address) == false) {
+      LOG_ERROR("Invalid shard node address %s", address.c_str());
+      return false;
+    }
+    addresses.push_back(address);
+  }
+  if (addresses.empty() == true) {
+    return true;
+  }
+  if (node_id >= addresses.size()) {
+    LOG_ERROR("Shard node %lu is not one of the %lu nodes", node_id,
+              addresses.size());
+    return false;
+  }
+
+  std::unordered_map<std::string, ShardedTable> tables;
+  for (auto &description : StringUtil::Split(sharded_tables, ",")) {
+    if (description.empty() == true) {
+      continue;
+    }
+    ShardedTable table;
+    if (ParseTable(description, table) == false) {
+      LOG_ERROR("Invalid sharded table %s", description.c_str());
+      return false;
+    }
+    tables[table.table_name] = table;
+  }
+
+  node_addresses_ = std::move(addresses);
+  node_id_ = node_id;
+  tables_ = std::move(tables);
+  return true;
+}
+
+bool ShardMap::ParseTable(const std::string &description,
+                          ShardedTable &table) const {
+  auto fields = StringUtil::Split(description, ":");
+  if (fields.size() < 3 || fields[0].empty() || fields[2].empty()) {
+    return false;
+  }
+  table.table_name = StringUtil::Lower(fields[0]);
+  table.key_column = StringUtil::Lower(fields[2]);
+
+  auto type = StringUtil::Lower(fields[1]);
+  if (type == "hash") {
+    table.type = ShardingType::HASH;
+    return fields.size() == 3;
+  }
+  if (type != "range") {
+    return false;
+  }
+
+  // The bounds have to grow
+  table.type = ShardingType::RANGE;
+  for (size_t field_itr = 3; field_itr < fields.size(); field_itr++) {
+    char *end = nullptr;
+    int64_t bound = std::strtoll(fields[field_itr].c_str(), &end, 10);
+    if (fields[field_itr].empty() || *end != '\0' ||
+        (table.bounds.empty() == false && bound <= table.bounds.back())) {
+      return false;
+    }
+    table.bounds.push_back(bound);
+  }
+  return true;
+}
+
+const ShardedTable *ShardMap::GetTable(const std::string &table_name) const {
+  if (tables_.empty()) {
+    return nullptr;
+  }
+  auto entry = tables_.find(StringUtil::Lower(table_name));
+  return entry != tables_.end() ? &entry->second : nullptr;
+}
+
+size_t ShardMap::GetShard(const ShardedTable &table,
+                          const type::Value &key) const {
+  PL_ASSERT(IsEnabled() && key.IsNull() == false);
+
+  // Integers of every width go to the same shard, so that the literals of
+  // a statement find the rows of a column of any integer type
+  bool is_integer = key.CheckInteger();
+  if (table.type == ShardingType::RANGE) {
+    int64_t value = is_integer
+                        ? key.CastAs(type::TypeId::BIGINT).GetAs<int64_t>()
+                        : std::strtoll(key.ToString().c_str(), nullptr, 10);
+    size_t range = std::upper_bound(table.bounds.begin(), table.bounds.end(),
+                                    value) -
+                   table.bounds.begin();
+    return range % node_addresses_.size();
+  }
+
+  // The hash has to be the same on every node
+  uint64_t hash[2];
+  if (is_integer) {
+    int64_t value = key.CastAs(type::TypeId::BIGINT).GetAs<int64_t>();
+    MurmurHash3_x64_128(&value, sizeof(value), 0, hash);
+  } else {
+    std::string value = key.ToString();
+    MurmurHash3_x64_128(value.data(), value.size(), 0, hash);
+  }
+  return hash[0] % node_addresses_.size();
+}
+
+}  // End catalog namespace
+}  // End peloton namespace
@@ -344,6 +344,100 @@ void Aggregation::AdvanceValues(
   null_bitmap.WriteBack(codegen);
 }
 
+void Aggregation::DoMergeValue(CodeGen &codegen, llvm::Value *space,
+                               const Aggregation::AggregateInfo &agg_info,
+                               const codegen::Value &other) const {
+  auto curr = storage_.GetValueSkipNull(codegen, space, agg_info.storage_index);
+  codegen::Value next;
+  switch (agg_info.aggregate_type) {
+    case ExpressionType::AGGREGATE_SUM:
+    case ExpressionType::AGGREGATE_COUNT:
+    case ExpressionType::AGGREGATE_COUNT_STAR: {
+      // Sums and counts add up
+      next = curr.Add(codegen, other);
+      break;
+    }
+    case ExpressionType::AGGREGATE_MIN: {
+      next = curr.Min(codegen, other);
+      break;
+    }
+    case ExpressionType::AGGREGATE_MAX: {
+      next = curr.Max(codegen, other);
+      break;
+    }
+    default: {
+      std::string message = StringUtil::Format(
+          "Unexpected aggregate type [%s] when merging aggregator",
+          ExpressionTypeToString(agg_info.aggregate_type).c_str());
+      LOG_ERROR("%s", message.c_str());
+      throw Exception{EXCEPTION_TYPE_UNKNOWN_TYPE, message};
+    }
+  }
+
+  // Store the merged value in the appropriate slot
+  storage_.SetValueSkipNull(codegen, space, agg_info.storage_index, next);
+}
+
+// Merge each of the aggregates stored in the other storage space into the
+// ones stored in the provided storage space. Both spaces are in the format of
+// this aggregation.
+void Aggregation::MergeValues(CodeGen &codegen, llvm::Value *space,
+                              llvm::Value *other_space) const {
+  // The null bitmap trackers
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_, space};
+  UpdateableStorage::NullBitmap other_null_bitmap{codegen, storage_,
+                                                  other_space};
+
+  for (const auto &aggregate_info : aggregate_infos_) {
+    // AVG() aggregates are merged through their SUM() and COUNT()
+    if (aggregate_info.aggregate_type == ExpressionType::AGGREGATE_AVG) {
+      continue;
+    }
+
+    codegen::Value other = storage_.GetValueSkipNull(
+        codegen, other_space, aggregate_info.storage_index);
+
+    if (!null_bitmap.IsNullable(aggregate_info.storage_index)) {
+      DoMergeValue(codegen, space, aggregate_info, other);
+      continue;
+    }
+
+    // Like in AdvanceValues(), a NULL aggregate from the other space is
+    // skipped, and a NULL current aggregate takes the other value
+    llvm::Value *other_not_null = codegen->CreateNot(
+        other_null_bitmap.IsNull(codegen, aggregate_info.storage_index));
+    llvm::Value *agg_null =
+        null_bitmap.IsNull(codegen, aggregate_info.storage_index);
+
+    llvm::Value *curr_val =
+        null_bitmap.ByteFor(codegen, aggregate_info.storage_index);
+
+    lang::If valid_other{codegen, other_not_null};
+    {
+      lang::If agg_is_null{codegen, agg_null};
+      {
+        storage_.SetValue(codegen, space, aggregate_info.storage_index, other,
+                          null_bitmap);
+      }
+      agg_is_null.ElseBlock();
+      {
+        DoMergeValue(codegen, space, aggregate_info, other);
+      }
+      agg_is_null.EndIf();
+
+      // Merge the null value
+      null_bitmap.MergeValues(agg_is_null, curr_val);
+    }
+    valid_other.EndIf();
+
+    // Merge the null value
+    null_bitmap.MergeValues(valid_other, curr_val);
+  }
+
+  // Write the final contents of the null bitmap
+  null_bitmap.WriteBack(codegen);
+}
+
 // This function will computes the final values of all aggregates stored in the
 // provided storage space, and populates the provided vector with these values.
 void Aggregation::FinalizeValues(
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// background_compiler.cpp
+//
+// Identification: src/codegen/background_compiler.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/background_compiler.h"
+
+#include "codegen/buffering_consumer.h"
+#include "codegen/query_cache.h"
+#include "codegen/query_compiler.h"
+#include "codegen/query_parameters.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "planner/abstract_plan.h"
+#include "planner/binding_context.h"
+
+namespace peloton {
+namespace codegen {
+
+BackgroundCompiler &BackgroundCompiler::GetInstance() {
+  static BackgroundCompiler background_compiler;
+  return background_compiler;
+}
+
+BackgroundCompiler::BackgroundCompiler() : stop(false) {}
+
+BackgroundCompiler::~BackgroundCompiler() {
+  {
+    std::lock_guard<std::mutex> lock(compiler_mutex);
+    stop = true;
+  }
+  compiler_cv.notify_all();
+  if (compiler_thread.joinable()) {
+    compiler_thread.join();
+  }
+}
+
+bool BackgroundCompiler::Compile(std::shared_ptr<planner::AbstractPlan> plan,
+                                 const std::string &signature, bool optimize) {
+  {
+    std::lock_guard<std::mutex> lock(compiler_mutex);
+    if (failed_signatures.count(signature) != 0 ||
+        pending_signatures.insert(signature).second == false) {
+      return false;
+    }
+    tasks.push_back(CompileTask{plan, signature, optimize});
+
+    if (compiler_thread.joinable() == false) {
+      compiler_thread = std::thread(&BackgroundCompiler::Run, this);
+    }
+  }
+  compiler_cv.notify_all();
+
+  LOG_TRACE("Queued compilation of query %s", signature.c_str());
+  return true;
+}
+
+void BackgroundCompiler::CountExecution(
+    const std::shared_ptr<CachedQuery> &cached_query) {
+  auto execution_count = ++cached_query->execution_count;
+  if (cached_query->query->IsOptimized() == false &&
+      execution_count == optimize_threshold) {
+    Compile(cached_query->plan, cached_query->signature, true);
+  }
+}
+
+void BackgroundCompiler::WaitForAll() {
+  std::unique_lock<std::mutex> lock(compiler_mutex);
+  compiler_cv.wait(lock, [this] { return pending_signatures.empty(); });
+}
+
+size_t BackgroundCompiler::GetPendingCount() {
+  std::lock_guard<std::mutex> lock(compiler_mutex);
+  return pending_signatures.size();
+}
+
+void BackgroundCompiler::Run() {
+  std::unique_lock<std::mutex> lock(compiler_mutex);
+  while (true) {
+    compiler_cv.wait(lock, [this] { return stop || !tasks.empty(); });
+    if (tasks.empty()) {
+      // Stopped
+      break;
+    }
+
+    auto task = std::move(tasks.front());
+    tasks.pop_front();
+
+    lock.unlock();
+    bool compiled = CompileQuery(task);
+    lock.lock();
+
+    // Later executions find the query in the cache, or keep running on the
+    // executors
+    pending_signatures.erase(task.signature);
+    if (compiled == false) {
+      failed_signatures.insert(task.signature);
+    }
+    compiler_cv.notify_all();
+  }
+}
+
+bool BackgroundCompiler::CompileQuery(const CompileTask &task) {
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  try {
+    planner::BindingContext context;
+    task.plan->PerformBinding(context);
+
+    std::vector<oid_t> columns;
+    task.plan->GetOutputColumns(columns);
+    BufferingConsumer consumer{columns, context};
+    QueryParameters parameters{*task.plan};
+    PL_ASSERT(parameters.GetSignature() == task.signature);
+
+    QueryCompiler compiler{task.optimize};
+    auto query = compiler.Compile(*task.plan, consumer, nullptr, &parameters);
+    QueryCache::GetInstance().Add(task.plan, std::move(query), parameters);
+  } catch (Exception &e) {
+    LOG_ERROR("Failed to compile query %s: %s", task.signature.c_str(),
+              e.what());
+    return false;
+  }
+
+  timer.Stop();
+  LOG_DEBUG("Compiled %s query %s in %.2f ms",
+            task.optimize ? "optimized" : "unoptimized", task.signature.c_str(),
+            timer.GetDuration());
+  return true;
+}
+
+}  // namespace codegen
+}  // namespace peloton
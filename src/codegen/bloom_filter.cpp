@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bloom_filter.cpp
+//
+// Identification: src/codegen/bloom_filter.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/bloom_filter.h"
+
+#include "codegen/proxy/bloom_filter_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+// Just make a call to util::BloomFilter::Init(...)
+void BloomFilter::Init(CodeGen &codegen, llvm::Value *bloom_filter_ptr,
+                       uint64_t estimated_num_entries) const {
+  codegen.CallFunc(BloomFilterProxy::_Init::GetFunction(codegen),
+                   {bloom_filter_ptr, codegen.Const64(estimated_num_entries)});
+}
+
+void BloomFilter::Add(CodeGen &codegen, llvm::Value *bloom_filter_ptr,
+                      llvm::Value *hash, bool atomic) const {
+  llvm::Value *word_ptr = GetWordPtr(codegen, bloom_filter_ptr, hash);
+  llvm::Value *bits = GetWordBits(codegen, hash);
+  if (atomic) {
+    // Bits set by other threads must not be lost, but the order in which the
+    // bits are set does not matter
+    codegen->CreateAtomicRMW(llvm::AtomicRMWInst::Or, word_ptr, bits,
+                             llvm::AtomicOrdering::Monotonic);
+    return;
+  }
+  llvm::Value *word = codegen->CreateLoad(word_ptr);
+  codegen->CreateStore(codegen->CreateOr(word, bits), word_ptr);
+}
+
+llvm::Value *BloomFilter::Contains(CodeGen &codegen,
+                                   llvm::Value *bloom_filter_ptr,
+                                   llvm::Value *hash) const {
+  llvm::Value *word =
+      codegen->CreateLoad(GetWordPtr(codegen, bloom_filter_ptr, hash));
+  llvm::Value *bits = GetWordBits(codegen, hash);
+  return codegen->CreateICmpEQ(codegen->CreateAnd(word, bits), bits);
+}
+
+// Just make a call to util::BloomFilter::Destroy(...)
+void BloomFilter::Destroy(CodeGen &codegen,
+                          llvm::Value *bloom_filter_ptr) const {
+  codegen.CallFunc(BloomFilterProxy::_Destroy::GetFunction(codegen),
+                   {bloom_filter_ptr});
+}
+
+// The word is taken from the high bits of the product of the hash with a large
+// odd constant, masked by the number of words in the filter
+llvm::Value *BloomFilter::GetWordPtr(CodeGen &codegen,
+                                     llvm::Value *bloom_filter_ptr,
+                                     llvm::Value *hash) const {
+  llvm::Type *bloom_filter_type = BloomFilterProxy::GetType(codegen);
+  llvm::Value *words = codegen->CreateLoad(codegen->CreateConstInBoundsGEP2_32(
+      bloom_filter_type, bloom_filter_ptr, 0, 0));
+  llvm::Value *word_mask = codegen->CreateLoad(
+      codegen->CreateConstInBoundsGEP2_32(bloom_filter_type, bloom_filter_ptr,
+                                          0, 1));
+
+  llvm::Value *index = codegen->CreateMul(
+      hash, codegen.Const64(util::BloomFilter::kWordMultiplier));
+  index = codegen->CreateAnd(codegen->CreateLShr(index, 32), word_mask);
+  return codegen->CreateInBoundsGEP(codegen.Int64Type(), words, index);
+}
+
+// Every hash sets one bit per 6-bit chunk of its low bits
+llvm::Value *BloomFilter::GetWordBits(CodeGen &codegen,
+                                      llvm::Value *hash) const {
+  llvm::Value *bits = codegen.Const64(0);
+  for (uint32_t i = 0; i < util::BloomFilter::kNumHashBits; i++) {
+    llvm::Value *bit_idx = codegen->CreateAnd(
+        codegen->CreateLShr(hash, 6 * i), codegen.Const64(63));
+    bits = codegen->CreateOr(
+        bits, codegen->CreateShl(codegen.Const64(1), bit_idx));
+  }
+  return bits;
+}
+
+}  // namespace codegen
+}  // namespace peloton
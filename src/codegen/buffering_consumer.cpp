@@ -12,11 +12,9 @@
 
 #include "codegen/buffering_consumer.h"
 
-#include "codegen/lang/if.h"
-#include "codegen/proxy/values_runtime_proxy.h"
 #include "codegen/value_proxy.h"
-#include "codegen/type/sql_type.h"
 #include "planner/binding_context.h"
+#include "type/wire_format.h"
 
 namespace peloton {
 namespace codegen {
@@ -49,14 +47,36 @@ BufferingConsumer::BufferingConsumer(const std::vector<oid_t> &cols,
     output_ais_.push_back(context.Find(col_id));
   }
   state.output = &tuples_;
+  state.results = nullptr;
+  state.result_format = nullptr;
+  state.callback = nullptr;
+  state.chunk_rows = 0;
 }
 
 // Append the array of values (i.e., a tuple) into the consumer's buffer of
-// output tuples.
+// output tuples, or its columns into the results the consumer writes to.
 void BufferingConsumer::BufferTuple(char *state, peloton::type::Value *vals,
                                     uint32_t num_vals) {
   BufferingState *buffer_state = reinterpret_cast<BufferingState *>(state);
-  buffer_state->output->emplace_back(vals, num_vals);
+  if (buffer_state->results == nullptr) {
+    buffer_state->output->emplace_back(vals, num_vals);
+    return;
+  }
+
+  auto &results = *buffer_state->results;
+  auto *result_format = buffer_state->result_format;
+  for (uint32_t i = 0; i < num_vals; i++) {
+    results.emplace_back();
+    int format = peloton::type::WireFormat::kTextFormat;
+    if (result_format != nullptr && i < result_format->size()) {
+      format = (*result_format)[i];
+    }
+    peloton::type::WireFormat::Encode(vals[i], format, results.back().second);
+  }
+  if (buffer_state->callback != nullptr && buffer_state->chunk_rows > 0 &&
+      results.size() >= buffer_state->chunk_rows * num_vals) {
+    (*buffer_state->callback)(results);
+  }
 }
 
 // Get a proxy to BufferingConsumer::BufferTuple(...)
@@ -109,29 +129,9 @@ void BufferingConsumer::ConsumeResult(ConsumerContext &ctx,
     Value val = row.DeriveValue(codegen, output_ais_[i]);
 
     PL_ASSERT(output_ais_[i]->type == val.GetType());
-    const auto &sql_type = val.GetType().GetSqlType();
-
-    // Check if it's NULL
-    Value null_val;
-    lang::If val_is_null{codegen, val.IsNull(codegen)};
-    {
-      // If the value is NULL (i.e., has the NULL bit set), produce the NULL
-      // value for the given type.
-      null_val = sql_type.GetNullValue(codegen);
-    }
-    val_is_null.EndIf();
-    val = val_is_null.BuildPHI(null_val, val);
-
-    // Output the value using the type's output function
-    auto *output_func = sql_type.GetOutputFunction(codegen, val.GetType());
-
-    // Setup the function arguments
-    std::vector<llvm::Value *> args = {tuple_buffer_, codegen.Const64(i),
-                                       val.GetValue()};
-    if (val.GetLength() != nullptr) args.push_back(val.GetLength());
 
-    // Call the function
-    codegen.CallFunc(output_func, args);
+    // Output the value (or the NULL value of its type) into the tuple
+    val.OutputTo(codegen, tuple_buffer_, i);
   }
 
   // Append the tuple to the output buffer (by calling BufferTuple(...))
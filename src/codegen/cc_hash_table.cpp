@@ -230,6 +230,7 @@ void CCHashTable::Iterate(CodeGen &codegen, llvm::Value *ht_ptr,
 //
 //===----------------------------------------------------------------------===//
 void CCHashTable::FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
+                          llvm::Value *hash,
                           const std::vector<codegen::Value> &key,
                           IterateCallback &callback) const {
   llvm::Type *ht_type = CCHashTableProxy::GetType(codegen);
@@ -237,7 +238,9 @@ void CCHashTable::FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
       codegen->CreateConstInBoundsGEP2_32(ht_type, ht_ptr, 0, 0));
 
   // (1)
-  llvm::Value *hash = Hash::HashValues(codegen, key);
+  if (hash == nullptr) {
+    hash = Hash::HashValues(codegen, key);
+  }
 
   // (2) bucket = hash & (num_buckets-1)
   llvm::Value *bucket_mask = codegen->CreateLoad(
@@ -22,7 +22,9 @@
 #include "llvm/Transforms/Scalar/GVN.h"
 #endif
 
+#include "codegen/object_cache.h"
 #include "common/logger.h"
+#include "common/timer.h"
 
 namespace peloton {
 namespace codegen {
@@ -34,12 +36,18 @@ static std::atomic<uint64_t> kIdCounter{0};
 //===----------------------------------------------------------------------===//
 CodeContext::CodeContext()
     : id_(kIdCounter++),
+      name_id_(id_),
       context_(new llvm::LLVMContext()),
       module_(new llvm::Module("_" + std::to_string(id_) + "_plan", *context_)),
       builder_(*context_),
       func_(nullptr),
       opt_pass_manager_(module_),
-      jit_engine_(nullptr) {
+      jit_engine_(nullptr),
+      opt_ms_(0.0),
+      jit_ms_(0.0),
+      num_functions_(0),
+      num_instructions_(0),
+      loaded_from_cache_(false) {
   // Initialize JIT stuff
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
@@ -101,6 +109,14 @@ void *CodeContext::GetFunctionPointer(llvm::Function *fn) const {
   return jit_engine_->getPointerToFunction(fn);
 }
 
+void CodeContext::SetObjectCacheKey(const std::string &key) {
+  PL_ASSERT(module_->empty());
+  object_cache_key_ = key;
+  name_id_ = std::hash<std::string>{}(key);
+  module_->setModuleIdentifier(key);
+  jit_engine_->setObjectCache(&ObjectCache::GetInstance());
+}
+
 const llvm::DataLayout &CodeContext::GetDataLayout() const {
   return module_->getDataLayout();
 }
@@ -108,7 +124,7 @@ const llvm::DataLayout &CodeContext::GetDataLayout() const {
 //===----------------------------------------------------------------------===//
 // JIT the code contained within after optimizing it
 //===----------------------------------------------------------------------===//
-bool CodeContext::Compile() {
+bool CodeContext::Compile(bool optimize) {
   // Verify the module is okay
   llvm::raw_ostream &errors = llvm::errs();
   if (llvm::verifyModule(*module_, &errors)) {
@@ -118,16 +134,48 @@ bool CodeContext::Compile() {
     return false;
   }
 
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  // Code that is in the object cache is not optimized again, the engine
+  // loads the object it has instead of emitting the code
+  loaded_from_cache_ = object_cache_key_.empty() == false &&
+                       ObjectCache::GetInstance().HasObject(object_cache_key_);
+
   // Run each of our optimization passes over the functions in this module
-  opt_pass_manager_.doInitialization();
+  if (optimize && loaded_from_cache_ == false) {
+    opt_pass_manager_.doInitialization();
+    for (auto fn = module_->begin(), end = module_->end(); fn != end; fn++) {
+      opt_pass_manager_.run(*fn);
+    }
+    opt_pass_manager_.doFinalization();
+  }
+
+  timer.Stop();
+  opt_ms_ = timer.GetDuration();
+
+  // Count the code that is compiled, after it is optimized
+  num_functions_ = 0;
+  num_instructions_ = 0;
   for (auto fn = module_->begin(), end = module_->end(); fn != end; fn++) {
-    opt_pass_manager_.run(*fn);
+    if (fn->isDeclaration()) {
+      continue;
+    }
+    num_functions_++;
+    for (const auto &block : *fn) {
+      num_instructions_ += block.size();
+    }
   }
-  opt_pass_manager_.doFinalization();
+
+  timer.Reset();
+  timer.Start();
 
   // Finalize the object, this is where the JIT happens
   jit_engine_->finalizeObject();
 
+  timer.Stop();
+  jit_ms_ = timer.GetDuration();
+
   // Log the module
   LOG_TRACE("%s\n", GetIR().c_str());
 
@@ -160,6 +208,13 @@ void CodeContext::DumpContents() const {
   }
 }
 
+// Write the IR into the given file
+void CodeContext::DumpIR(const std::string &file_name) const {
+  std::error_code error_code;
+  llvm::raw_fd_ostream ll_ostream{file_name, error_code, llvm::sys::fs::F_RW};
+  module_->print(ll_ostream, nullptr, false);
+}
+
 // Get the textual form of the IR in this context
 std::string CodeContext::GetIR() const {
   std::string module_str;
@@ -14,6 +14,7 @@
 
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/TypeBuilder.h"
 #include "llvm/Support/TargetSelect.h"
@@ -156,8 +157,12 @@ llvm::Value *CodeGen::CallMulWithOverflow(llvm::Value *left, llvm::Value *right,
 void CodeGen::ThrowIfOverflow(llvm::Value *overflow) const {
   PL_ASSERT(overflow->getType() == BoolType());
 
-  // Get the overflow basic block for the currently generating function
+  // Get the overflow basic block for the currently generating function, unless
+  // the check is batched with others
   auto *func = code_context_.GetCurrentFunction();
+  if (func->AddToOverflowBatch(overflow)) {
+    return;
+  }
   auto *overflow_bb = func->GetOverflowBB();
 
   // Construct a new block that we jump if there *isn't* an overflow
@@ -166,7 +171,8 @@ void CodeGen::ThrowIfOverflow(llvm::Value *overflow) const {
 
   // Create a branch that goes to the overflow BB if an overflow exists
   auto &builder = GetBuilder();
-  builder.CreateCondBr(overflow, overflow_bb, no_overflow_bb);
+  builder.CreateCondBr(overflow, overflow_bb, no_overflow_bb,
+                       GetErrorBranchWeights());
 
   // Start insertion in the block
   builder.SetInsertPoint(no_overflow_bb);
@@ -185,12 +191,31 @@ void CodeGen::ThrowIfDivideByZero(llvm::Value *divide_by_zero) const {
 
   // Create a branch that goes to the divide-by-zero BB if an error exists
   auto &builder = GetBuilder();
-  builder.CreateCondBr(divide_by_zero, div0_bb, no_div0_bb);
+  builder.CreateCondBr(divide_by_zero, div0_bb, no_div0_bb,
+                       GetErrorBranchWeights());
 
   // Start insertion in the block
   builder.SetInsertPoint(no_div0_bb);
 }
 
+void CodeGen::BeginOverflowBatch() const {
+  code_context_.GetCurrentFunction()->BeginOverflowBatch();
+}
+
+void CodeGen::EndOverflowBatch() const {
+  llvm::Value *overflow =
+      code_context_.GetCurrentFunction()->EndOverflowBatch();
+  if (overflow != nullptr) {
+    ThrowIfOverflow(overflow);
+  }
+}
+
+// Errors are expected to (almost) never happen. Weighting their branches lets
+// block placement move the error blocks out of the hot path.
+llvm::MDNode *CodeGen::GetErrorBranchWeights() const {
+  return llvm::MDBuilder{GetContext()}.createBranchWeights(1, 1 << 20);
+}
+
 // Lookup a function in the module with the given name
 llvm::Function *CodeGen::LookupFunction(const std::string &fn_name) const {
   return GetModule().getFunction(fn_name);
@@ -23,9 +23,11 @@ namespace codegen {
 
 // Constructor
 CompilationContext::CompilationContext(Query &query,
-                                       QueryResultConsumer &result_consumer)
+                                       QueryResultConsumer &result_consumer,
+                                       const QueryParameters *parameters)
     : query_(query),
       result_consumer_(result_consumer),
+      parameters_(parameters),
       codegen_(query_.GetCodeContext()) {
   // Allocate a catalog and transaction instance in the runtime state
   auto &runtime_state = GetRuntimeState();
@@ -41,6 +43,9 @@ CompilationContext::CompilationContext(Query &query,
   executor_context_state_id_ =
       runtime_state.RegisterState("executorContext", executor_context_type);
 
+  parameters_state_id_ =
+      runtime_state.RegisterState("queryParameters", codegen_.CharPtrType());
+
   // Let the query consumer modify the runtime state object
   result_consumer_.Prepare(*this);
 }
@@ -109,10 +114,15 @@ void CompilationContext::GeneratePlan(QueryCompiler::CompileStats *stats) {
     throw Exception{"There was an error preparing the compiled query"};
   }
 
-  // We're done
+  // We're done. Preparing the query optimizes its code before emitting it.
   if (stats != nullptr) {
     timer.Stop();
-    stats->jit_ms = timer.GetDuration();
+    const auto &code_context = query_.GetCodeContext();
+    stats->opt_ms = code_context.GetOptimizeTime();
+    stats->jit_ms = timer.GetDuration() - stats->opt_ms;
+    stats->num_functions = code_context.GetFunctionCount();
+    stats->num_instructions = code_context.GetInstructionCount();
+    stats->loaded_from_cache = code_context.IsLoadedFromCache();
   }
 }
 
@@ -139,13 +149,55 @@ llvm::Value *CompilationContext::GetExecutorContextPtr() {
   return GetRuntimeState().LoadStateValue(codegen_, executor_context_state_id_);
 }
 
+// Get a pointer to the slot of the given expression in the query parameters
+llvm::Value *CompilationContext::GetParameterPtr(
+    const expression::AbstractExpression &exp) {
+  PL_ASSERT(parameters_ != nullptr);
+  uint32_t index = parameters_->GetParameterIndex(&exp);
+  llvm::Value *parameters_ptr =
+      GetRuntimeState().LoadStateValue(codegen_, parameters_state_id_);
+  return codegen_->CreateConstInBoundsGEP1_32(
+      codegen_.ByteType(), parameters_ptr,
+      index * sizeof(QueryParameters::Parameter));
+}
+
+llvm::Value *CompilationContext::GetPredicatePtr(
+    const expression::AbstractExpression &exp) {
+  if (parameters_ == nullptr) {
+    // The predicate belongs to the plan, which outlives the compiled query
+    return codegen_->CreateIntToPtr(
+        codegen_.Const64(reinterpret_cast<int64_t>(&exp)),
+        codegen_.CharPtrType());
+  }
+  llvm::Value *slot_ptr = codegen_->CreateBitCast(
+      GetParameterPtr(exp), codegen_.CharPtrType()->getPointerTo());
+  return codegen_->CreateLoad(slot_ptr);
+}
+
+llvm::Value *CompilationContext::GetPlanPtr(const planner::AbstractPlan &plan) {
+  if (parameters_ == nullptr) {
+    return codegen_->CreateIntToPtr(
+        codegen_.Const64(reinterpret_cast<int64_t>(&plan)),
+        codegen_.CharPtrType());
+  }
+  uint32_t index = parameters_->GetPlanIndex(&plan);
+  llvm::Value *parameters_ptr =
+      GetRuntimeState().LoadStateValue(codegen_, parameters_state_id_);
+  llvm::Value *slot_ptr = codegen_->CreateConstInBoundsGEP1_32(
+      codegen_.ByteType(), parameters_ptr,
+      index * sizeof(QueryParameters::Parameter));
+  slot_ptr = codegen_->CreateBitCast(slot_ptr,
+                                     codegen_.CharPtrType()->getPointerTo());
+  return codegen_->CreateLoad(slot_ptr);
+}
+
 // Generate code for the init() function of the query
 llvm::Function *CompilationContext::GenerateInitFunction() {
   // Create function definition
   auto &code_context = query_.GetCodeContext();
   auto &runtime_state = query_.GetRuntimeState();
 
-  auto init_fn_name = "_" + std::to_string(code_context.GetID()) + "_init";
+  auto init_fn_name = code_context.GetFunctionName("init");
   FunctionBuilder function_builder{
       code_context,
       init_fn_name,
@@ -175,7 +227,7 @@ llvm::Function *CompilationContext::GeneratePlanFunction(
   auto &code_context = query_.GetCodeContext();
   auto &runtime_state = query_.GetRuntimeState();
 
-  auto plan_fn_name = "_" + std::to_string(code_context.GetID()) + "_plan";
+  auto plan_fn_name = code_context.GetFunctionName("plan");
   FunctionBuilder function_builder{
       code_context,
       plan_fn_name,
@@ -201,7 +253,7 @@ llvm::Function *CompilationContext::GenerateTearDownFunction() {
   auto &code_context = query_.GetCodeContext();
   auto &runtime_state = query_.GetRuntimeState();
 
-  auto fn_name = "_" + std::to_string(code_context.GetID()) + "_tearDown";
+  auto fn_name = code_context.GetFunctionName("tearDown");
   FunctionBuilder function_builder{
       code_context,
       fn_name,
@@ -12,16 +12,55 @@
 
 #include "codegen/expression/arithmetic_translator.h"
 
+#include "expression/constant_value_expression.h"
 #include "expression/operator_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/attribute_info.h"
 
 namespace peloton {
 namespace codegen {
 
+namespace {
+
+// Does the expression only add, subtract and multiply non-null columns and
+// constants? Its code is then straight-line, and an intermediate result that
+// overflowed only flows into more arithmetic of the same expression.
+bool IsStraightLineArithmetic(const expression::AbstractExpression &exp) {
+  switch (exp.GetExpressionType()) {
+    case ExpressionType::OPERATOR_PLUS:
+    case ExpressionType::OPERATOR_MINUS:
+    case ExpressionType::OPERATOR_MULTIPLY: {
+      for (uint32_t i = 0; i < exp.GetChildrenSize(); i++) {
+        if (!IsStraightLineArithmetic(*exp.GetChild(i))) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case ExpressionType::VALUE_CONSTANT: {
+      const auto &constant =
+          static_cast<const expression::ConstantValueExpression &>(exp);
+      return !constant.GetValue().IsNull();
+    }
+    case ExpressionType::VALUE_TUPLE: {
+      const auto *ai =
+          static_cast<const expression::TupleValueExpression &>(exp)
+              .GetAttributeRef();
+      return ai != nullptr && !ai->type.nullable;
+    }
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 // Constructor
 ArithmeticTranslator::ArithmeticTranslator(
     const expression::OperatorExpression &arithmetic,
     CompilationContext &context)
-    : ExpressionTranslator(arithmetic, context) {
+    : ExpressionTranslator(arithmetic, context),
+      batch_overflow_checks_(IsStraightLineArithmetic(arithmetic)) {
   PL_ASSERT(arithmetic.GetChildrenSize() == 2);
 }
 
@@ -29,26 +68,44 @@ ArithmeticTranslator::ArithmeticTranslator(
 codegen::Value ArithmeticTranslator::DeriveValue(CodeGen &codegen,
                                                  RowBatch::Row &row) const {
   const auto &arithmetic = GetExpressionAs<expression::OperatorExpression>();
+
+  // The overflow checks of straight-line arithmetic are combined into one
+  // branch, made by the outermost operator once the whole expression is
+  // computed. This keeps the code of the expression branch-free.
+  if (batch_overflow_checks_) {
+    codegen.BeginOverflowBatch();
+  }
   codegen::Value left = row.DeriveValue(codegen, *arithmetic.GetChild(0));
   codegen::Value right = row.DeriveValue(codegen, *arithmetic.GetChild(1));
 
+  codegen::Value result;
   switch (arithmetic.GetExpressionType()) {
     case ExpressionType::OPERATOR_PLUS:
-      return left.Add(codegen, right);
+      result = left.Add(codegen, right);
+      break;
     case ExpressionType::OPERATOR_MINUS:
-      return left.Sub(codegen, right);
+      result = left.Sub(codegen, right);
+      break;
     case ExpressionType::OPERATOR_MULTIPLY:
-      return left.Mul(codegen, right);
+      result = left.Mul(codegen, right);
+      break;
     case ExpressionType::OPERATOR_DIVIDE:
-      return left.Div(codegen, right);
+      result = left.Div(codegen, right);
+      break;
     case ExpressionType::OPERATOR_MOD:
-      return left.Mod(codegen, right);
+      result = left.Mod(codegen, right);
+      break;
     default: {
       throw Exception(
           "Arithmetic expression has invalid type for translation: " +
           ExpressionTypeToString(arithmetic.GetExpressionType()));
     }
   }
+
+  if (batch_overflow_checks_) {
+    codegen.EndOverflowBatch();
+  }
+  return result;
 }
 
 }  // namespace codegen
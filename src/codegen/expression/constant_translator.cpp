@@ -12,6 +12,9 @@
 
 #include "codegen/expression/constant_translator.h"
 
+#include <cstddef>
+
+#include "codegen/compilation_context.h"
 #include "codegen/type/sql_type.h"
 #include "expression/constant_value_expression.h"
 #include "type/value_peeker.h"
@@ -22,14 +25,20 @@ namespace codegen {
 // Constructor
 ConstantTranslator::ConstantTranslator(
     const expression::ConstantValueExpression &exp, CompilationContext &ctx)
-    : ExpressionTranslator(exp, ctx) {}
+    : ExpressionTranslator(exp, ctx), context_(ctx) {}
 
 // Return an LLVM value for our constant (i.e., a compile-time constant)
 codegen::Value ConstantTranslator::DeriveValue(
     CodeGen &codegen, UNUSED_ATTRIBUTE RowBatch::Row &row) const {
   // Pull out the constant from the expression
-  const peloton::type::Value &constant =
-      GetExpressionAs<expression::ConstantValueExpression>().GetValue();
+  const auto &exp = GetExpressionAs<expression::ConstantValueExpression>();
+  const peloton::type::Value &constant = exp.GetValue();
+
+  // A query that is reused for other plans of the same shape reads the value
+  // from its parameter slot
+  if (context_.GetQueryParameters() != nullptr) {
+    return DeriveParameterValue(codegen, exp);
+  }
 
   // Convert the value into an LLVM compile-time constant
   llvm::Value *val = nullptr;
@@ -81,5 +90,45 @@ codegen::Value ConstantTranslator::DeriveValue(
                         len, nullptr};
 }
 
+// Load the value of our constant from its slot in the query parameters
+codegen::Value ConstantTranslator::DeriveParameterValue(
+    CodeGen &codegen, const expression::ConstantValueExpression &exp) const {
+  auto type_id = exp.GetValue().GetTypeId();
+  switch (type_id) {
+    case peloton::type::TypeId::TINYINT:
+    case peloton::type::TypeId::SMALLINT:
+    case peloton::type::TypeId::INTEGER:
+    case peloton::type::TypeId::BIGINT:
+    case peloton::type::TypeId::DECIMAL:
+    case peloton::type::TypeId::DATE:
+    case peloton::type::TypeId::TIMESTAMP:
+    case peloton::type::TypeId::VARCHAR: {
+      break;
+    }
+    default: {
+      throw Exception{"Unknown constant value type " +
+                      TypeIdToString(type_id)};
+    }
+  }
+
+  const auto &sql_type = type::SqlType::LookupType(type_id);
+  llvm::Type *val_type = nullptr;
+  llvm::Type *len_type = nullptr;
+  sql_type.GetTypeForMaterialization(codegen, val_type, len_type);
+
+  llvm::Value *slot_ptr = context_.GetParameterPtr(exp);
+  llvm::Value *val = codegen->CreateLoad(
+      codegen->CreateBitCast(slot_ptr, val_type->getPointerTo()));
+  llvm::Value *len = nullptr;
+  if (len_type != nullptr) {
+    llvm::Value *len_ptr = codegen->CreateConstInBoundsGEP1_32(
+        codegen.ByteType(), slot_ptr,
+        offsetof(QueryParameters::Parameter, length));
+    len = codegen->CreateLoad(
+        codegen->CreateBitCast(len_ptr, len_type->getPointerTo()));
+  }
+  return codegen::Value{sql_type, val, len, nullptr};
+}
+
 }  // namespace codegen
 }  // namespace peloton
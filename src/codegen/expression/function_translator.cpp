@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// function_translator.cpp
+//
+// Identification: src/codegen/expression/function_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/expression/function_translator.h"
+
+#include "codegen/compilation_context.h"
+#include "codegen/proxy/values_runtime_proxy.h"
+#include "codegen/type/sql_type.h"
+#include "codegen/value_proxy.h"
+#include "expression/function_expression.h"
+
+namespace peloton {
+namespace codegen {
+
+// Constructor
+FunctionTranslator::FunctionTranslator(
+    const expression::FunctionExpression &func_expr,
+    CompilationContext &context)
+    : ExpressionTranslator(func_expr, context), context_(context) {
+  if (func_expr.GetFunc() == nullptr) {
+    throw Exception{"Function " + func_expr.func_name_ + " is not resolved"};
+  }
+
+  auto &codegen = context.GetCodeGen();
+  auto &runtime_state = context.GetRuntimeState();
+  uint32_t num_args = std::max<uint32_t>(func_expr.GetChildrenSize(), 1);
+  args_id_ = runtime_state.RegisterState(
+      "funcArgs", codegen.VectorType(ValueProxy::GetType(codegen), num_args),
+      true);
+  result_id_ =
+      runtime_state.RegisterState("funcResult", codegen.Int64Type(), true);
+  result_len_id_ =
+      runtime_state.RegisterState("funcResultLen", codegen.Int32Type(), true);
+}
+
+Value FunctionTranslator::DeriveValue(CodeGen &codegen,
+                                      RowBatch::Row &row) const {
+  const auto &func_expr = GetExpressionAs<expression::FunctionExpression>();
+  auto &runtime_state = context_.GetRuntimeState();
+
+  // Write out the arguments (or the NULL values of their types)
+  llvm::Value *args = runtime_state.LoadStateValue(codegen, args_id_);
+  for (uint32_t i = 0; i < func_expr.GetChildrenSize(); i++) {
+    Value arg = row.DeriveValue(codegen, *func_expr.GetChild(i));
+    arg.OutputTo(codegen, args, i);
+  }
+
+  // Call the function
+  llvm::Value *result = runtime_state.LoadStateValue(codegen, result_id_);
+  llvm::Value *result_len =
+      runtime_state.LoadStateValue(codegen, result_len_id_);
+  llvm::Value *func_ptr = codegen->CreateIntToPtr(
+      codegen.Const64(reinterpret_cast<int64_t>(func_expr.GetFunc())),
+      codegen.CharPtrType());
+  llvm::Value *null = codegen.CallFunc(
+      ValuesRuntimeProxy::_CallFunction::GetFunction(codegen),
+      {func_ptr, codegen->CreateBitCast(args, codegen.CharPtrType()),
+       codegen.Const32(func_expr.GetChildrenSize()),
+       context_.GetExecutorContextPtr(),
+       codegen->CreateBitCast(result, codegen.CharPtrType()), result_len});
+
+  // Read the result back in the native format of its type
+  const auto &sql_type = type::SqlType::LookupType(func_expr.GetValueType());
+  llvm::Type *val_type = nullptr;
+  llvm::Type *len_type = nullptr;
+  sql_type.GetTypeForMaterialization(codegen, val_type, len_type);
+
+  llvm::Value *val = codegen->CreateLoad(
+      codegen->CreateBitCast(result, val_type->getPointerTo()));
+  llvm::Value *len = nullptr;
+  if (len_type != nullptr) {
+    len = codegen->CreateLoad(result_len);
+  }
+  return Value{type::Type{sql_type, true}, val, len, null};
+}
+
+}  // namespace codegen
+}  // namespace peloton
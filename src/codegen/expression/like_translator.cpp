@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_translator.cpp
+//
+// Identification: src/codegen/expression/like_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/expression/like_translator.h"
+
+#include "codegen/compilation_context.h"
+#include "codegen/proxy/values_runtime_proxy.h"
+#include "codegen/type/boolean_type.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "type/value_peeker.h"
+
+namespace peloton {
+namespace codegen {
+
+// Constructor. A query that is reused for other plans of the same shape reads
+// the pattern from its parameter slot, so only patterns of queries without
+// parameters can be analyzed.
+LikeTranslator::LikeTranslator(const expression::ComparisonExpression &like,
+                               CompilationContext &context)
+    : ExpressionTranslator(like, context), match_kind_(MatchKind::Pattern) {
+  PL_ASSERT(like.GetChildrenSize() == 2);
+
+  const auto *pattern_exp = like.GetChild(1);
+  if (context.GetQueryParameters() != nullptr ||
+      pattern_exp->GetExpressionType() != ExpressionType::VALUE_CONSTANT) {
+    return;
+  }
+
+  const auto &pattern =
+      static_cast<const expression::ConstantValueExpression *>(pattern_exp)
+          ->GetValue();
+  if (pattern.GetTypeId() == peloton::type::TypeId::VARCHAR &&
+      !pattern.IsNull()) {
+    AnalyzePattern(peloton::type::ValuePeeker::PeekVarchar(pattern));
+  }
+}
+
+// Patterns with escapes, '_' or a '%' between other characters are matched in
+// general. Otherwise, the position of the '%'s determines the match.
+void LikeTranslator::AnalyzePattern(const std::string &pattern) {
+  if (pattern.find_first_of("_\\") != std::string::npos) {
+    return;
+  }
+
+  auto first = pattern.find_first_not_of('%');
+  if (first == std::string::npos) {
+    // Only '%'s, which match every string. The empty pattern only matches the
+    // empty string, though.
+    if (!pattern.empty()) {
+      match_kind_ = MatchKind::Any;
+    }
+    return;
+  }
+  auto last = pattern.find_last_not_of('%');
+
+  literal_ = pattern.substr(first, last - first + 1);
+  if (literal_.find('%') != std::string::npos) {
+    return;
+  }
+
+  bool leading_percent = first > 0;
+  bool trailing_percent = last + 1 < pattern.size();
+  if (leading_percent && trailing_percent) {
+    match_kind_ = MatchKind::Substring;
+  } else if (leading_percent) {
+    match_kind_ = MatchKind::Suffix;
+  } else if (trailing_percent) {
+    match_kind_ = MatchKind::Prefix;
+  }
+}
+
+Value LikeTranslator::DeriveValue(CodeGen &codegen, RowBatch::Row &row) const {
+  const auto &like = GetExpressionAs<expression::ComparisonExpression>();
+  Value str = row.DeriveValue(codegen, *like.GetChild(0));
+
+  llvm::Value *null = str.IsNullable() ? str.IsNull(codegen) : nullptr;
+  llvm::Value *matches = nullptr;
+  if (match_kind_ == MatchKind::Any) {
+    matches = codegen.ConstBool(true);
+  } else if (match_kind_ == MatchKind::Pattern) {
+    Value pattern = row.DeriveValue(codegen, *like.GetChild(1));
+    if (pattern.IsNullable()) {
+      null = null != nullptr
+                 ? codegen->CreateOr(null, pattern.IsNull(codegen))
+                 : pattern.IsNull(codegen);
+    }
+    matches = codegen.CallFunc(
+        ValuesRuntimeProxy::_Like::GetFunction(codegen),
+        {str.GetValue(), str.GetLength(), pattern.GetValue(),
+         pattern.GetLength()});
+  } else {
+    llvm::Function *match_func = nullptr;
+    switch (match_kind_) {
+      case MatchKind::Prefix:
+        match_func = ValuesRuntimeProxy::_StartsWith::GetFunction(codegen);
+        break;
+      case MatchKind::Suffix:
+        match_func = ValuesRuntimeProxy::_EndsWith::GetFunction(codegen);
+        break;
+      default:
+        match_func = ValuesRuntimeProxy::_Contains::GetFunction(codegen);
+        break;
+    }
+    matches = codegen.CallFunc(
+        match_func, {str.GetValue(), str.GetLength(),
+                     codegen.ConstStringPtr(literal_),
+                     codegen.Const32(literal_.size())});
+  }
+
+  if (like.GetExpressionType() == ExpressionType::COMPARE_NOTLIKE) {
+    matches = codegen->CreateNot(matches);
+  }
+
+  if (null == nullptr) {
+    return Value{type::Boolean::Instance(), matches};
+  }
+  return Value{type::Type{type::Boolean::Instance(), true}, matches, nullptr,
+               null};
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -33,7 +33,9 @@ FunctionBuilder::FunctionBuilder(
       previous_function_(code_context_.GetCurrentFunction()),
       previous_insert_point_(code_context_.GetBuilder().GetInsertBlock()),
       overflow_bb_(nullptr),
-      divide_by_zero_bb_(nullptr) {
+      divide_by_zero_bb_(nullptr),
+      overflow_batch_depth_(0),
+      batched_overflow_(nullptr) {
   // Collect function argument types
   std::vector<llvm::Type *> arg_types;
   for (auto &arg : args) {
@@ -161,6 +163,27 @@ llvm::BasicBlock *FunctionBuilder::GetDivideByZeroBB() {
   return divide_by_zero_bb_;
 }
 
+llvm::Value *FunctionBuilder::EndOverflowBatch() {
+  PL_ASSERT(overflow_batch_depth_ > 0);
+  if (--overflow_batch_depth_ > 0) {
+    return nullptr;
+  }
+  llvm::Value *overflow = batched_overflow_;
+  batched_overflow_ = nullptr;
+  return overflow;
+}
+
+bool FunctionBuilder::AddToOverflowBatch(llvm::Value *overflow) {
+  if (overflow_batch_depth_ == 0) {
+    return false;
+  }
+  batched_overflow_ =
+      batched_overflow_ == nullptr
+          ? overflow
+          : code_context_.GetBuilder().CreateOr(batched_overflow_, overflow);
+  return true;
+}
+
 // Return the given value from the function and finish it
 void FunctionBuilder::ReturnAndFinish(llvm::Value *ret) {
   if (!finished_) {
@@ -29,12 +29,47 @@ const std::string Hash::kHashMethodStrings[4] = {"Crc32", "Murmur3", "CityHash",
 llvm::Value *Hash::HashValues(CodeGen &codegen,
                               const std::vector<codegen::Value> &vals,
                               Hash::HashMethod method) {
-  // The first thing we do is separate all input values into different lists
-  // that each hold inputs of one type. For our purposes, we split inputs into
-  // lists holding byte-types, short-types, integer-types, long-types and
-  // variable-length strings.
-  std::vector<llvm::Value *> bytes, shorts, ints, longs;
-  std::vector<Hash::Varlen> varlens;
+  return HashValues(codegen, std::vector<std::vector<codegen::Value>>{vals},
+                    method)[0];
+}
+
+//===----------------------------------------------------------------------===//
+// Generate the code to compute the hashes of the values of several rows. The
+// 64-bit inputs of the rows are hashed side by side, so the hashes of the rows
+// are computed in SIMD lanes or interleaved, depending on the hash method.
+//===----------------------------------------------------------------------===//
+std::vector<llvm::Value *> Hash::HashValues(
+    CodeGen &codegen, const std::vector<std::vector<codegen::Value>> &rows,
+    Hash::HashMethod method) {
+  PL_ASSERT(!rows.empty());
+  std::vector<std::vector<llvm::Value *>> numerics(rows.size());
+  std::vector<std::vector<Hash::Varlen>> varlens(rows.size());
+  for (uint32_t i = 0; i < rows.size(); i++) {
+    CollectHashInputs(codegen, rows[i], numerics[i], varlens[i]);
+  }
+
+  // Compute the hash of the 64-bit values in 'numerics' and the buffers in
+  // 'varlens' based on the chosen hash method.
+  switch (method) {
+    case Hash::HashMethod::Crc32:
+      return ComputeCRC32Hash(codegen, numerics, varlens);
+    case Hash::HashMethod::Murmur3:
+      return ComputeMurmur3Hash(codegen, numerics, varlens);
+    default:
+      throw Exception{"We currently don't support hash method: " +
+                      kHashMethodStrings[static_cast<uint32_t>(method)]};
+  }
+}
+
+// The first thing we do is separate all input values into different lists
+// that each hold inputs of one type. For our purposes, we split inputs into
+// lists holding byte-types, short-types, integer-types, long-types and
+// variable-length strings. The small ones are then packed into 64-bit values.
+void Hash::CollectHashInputs(CodeGen &codegen,
+                             const std::vector<codegen::Value> &vals,
+                             std::vector<llvm::Value *> &longs,
+                             std::vector<Hash::Varlen> &varlens) {
+  std::vector<llvm::Value *> bytes, shorts, ints;
 
   for (const auto &value : vals) {
     llvm::Value *val = nullptr;
@@ -128,70 +163,104 @@ llvm::Value *Hash::HashValues(CodeGen &codegen,
     longs.push_back(computed[index]);
   }
 
-  // Compute the hash of the 64-bit values in 'long' and the buffers in
-  // 'buffers' based on the chosen hash method.
-  switch (method) {
-    case Hash::HashMethod::Crc32:
-      return ComputeCRC32Hash(codegen, longs, varlens);
-    case Hash::HashMethod::Murmur3:
-      return ComputeMurmur3Hash(codegen, longs, varlens);
-    default:
-      throw Exception{"We currently don't support hash method: " +
-                      kHashMethodStrings[static_cast<uint32_t>(method)]};
-  }
 }
 
 //===----------------------------------------------------------------------===//
-// Generate the calculation of a CRC64 hash for the given values
+// Generate the calculation of a CRC64 hash for the given values of every row.
+// The CRC32 instruction has a latency of several cycles, but a new one can
+// start every cycle. Interleaving the instructions of independent rows keeps
+// several in flight.
 //===----------------------------------------------------------------------===//
-llvm::Value *Hash::ComputeCRC32Hash(CodeGen &codegen,
-                                    const std::vector<llvm::Value *> &numerics,
-                                    const std::vector<Hash::Varlen> &varlens) {
+std::vector<llvm::Value *> Hash::ComputeCRC32Hash(
+    CodeGen &codegen, const std::vector<std::vector<llvm::Value *>> &numerics,
+    const std::vector<std::vector<Hash::Varlen>> &varlens) {
   // The CRC32 generator polynomial
   static constexpr uint32_t kCrc32Generator = 0x04C11DB7;
 
-  llvm::Value *crc_low = codegen.Const64(0);
-  llvm::Value *crc_high = codegen.Const64(kCrc32Generator);
+  uint32_t num_rows = numerics.size();
+  std::vector<llvm::Value *> crc_low(num_rows, codegen.Const64(0));
+  std::vector<llvm::Value *> crc_high(num_rows,
+                                      codegen.Const64(kCrc32Generator));
 
   // Hash the numerics
   llvm::Function *crc32_func = llvm::Intrinsic::getDeclaration(
       &codegen.GetModule(), llvm::Intrinsic::x86_sse42_crc32_64_64);
   PL_ASSERT(crc32_func != nullptr);
-  for (auto *val : numerics) {
-    crc_low = codegen.CallFunc(crc32_func, {crc_low, val});
-    crc_high = codegen.CallFunc(crc32_func, {crc_high, val});
+  for (uint32_t i = 0; i < numerics[0].size(); i++) {
+    for (uint32_t row = 0; row < num_rows; row++) {
+      llvm::Value *val = numerics[row][i];
+      crc_low[row] = codegen.CallFunc(crc32_func, {crc_low[row], val});
+      crc_high[row] = codegen.CallFunc(crc32_func, {crc_high[row], val});
+    }
   }
 
   // Let crc64 = (crc_high << 32) | crc_low
-  crc_high = codegen->CreateShl(crc_high, 8 * sizeof(uint32_t));
-  llvm::Value *crc = codegen->CreateOr(crc_high, crc_low);
+  std::vector<llvm::Value *> crcs;
+  for (uint32_t row = 0; row < num_rows; row++) {
+    llvm::Value *high = codegen->CreateShl(crc_high[row], 8 * sizeof(uint32_t));
+    crcs.push_back(codegen->CreateOr(high, crc_low[row]));
+  }
 
   // Now hash the strings
   llvm::Function *crc64_func =
       RuntimeFunctionsProxy::_CRC64Hash::GetFunction(codegen);
   PL_ASSERT(crc64_func != nullptr);
-  for (auto &varlen : varlens) {
-    crc = codegen.CallFunc(crc64_func, {varlen.val, varlen.len, crc});
+  for (uint32_t row = 0; row < num_rows; row++) {
+    for (auto &varlen : varlens[row]) {
+      crcs[row] =
+          codegen.CallFunc(crc64_func, {varlen.val, varlen.len, crcs[row]});
+    }
   }
 
   ///
-  return crc;
+  return crcs;
 }
 
 // Here we compute the hash of all the numerics and the varlen buffers into a
-// single value
-llvm::Value *Hash::ComputeMurmur3Hash(
-    CodeGen &codegen, const std::vector<llvm::Value *> &numerics,
-    const std::vector<Hash::Varlen> &varlen_buffers) {
+// single value per row. The inputs of the rows are packed into the lanes of
+// vectors, so the mixing of all rows happens in the same SIMD instructions.
+std::vector<llvm::Value *> Hash::ComputeMurmur3Hash(
+    CodeGen &codegen, const std::vector<std::vector<llvm::Value *>> &numerics,
+    const std::vector<std::vector<Hash::Varlen>> &varlen_buffers) {
   // The magic constants used in Murmur3's final 64-bit avalanche mix
   static constexpr uint64_t kMurmur3C1 = 0xff51afd7ed558ccdLLU;
   static constexpr uint64_t kMurmur3C2 = 0xc4ceb9fe1a85ec53LLU;
   // The magic constant used in Boost's hash_combine()
   static constexpr uint64_t kHashCombine = 0x9e3779b9LLU;
 
-  llvm::Value *magic_const1 = codegen.Const64(kMurmur3C1);
-  llvm::Value *magic_const2 = codegen.Const64(kMurmur3C2);
-  llvm::Value *combine_const = codegen.Const64(kHashCombine);
+  for (const auto &row_varlens : varlen_buffers) {
+    if (!row_varlens.empty()) {
+      throw Exception{"Cannot perform a vectorized Murmur3 hash on strings"};
+    }
+  }
+
+  // A single row is hashed in scalars, several rows in vectors of one lane
+  // per row
+  uint32_t num_lanes = numerics.size();
+  auto splat = [&codegen, num_lanes](uint64_t val) -> llvm::Value * {
+    llvm::Constant *const_val = codegen.Const64(val);
+    if (num_lanes == 1) {
+      return const_val;
+    }
+    return llvm::ConstantVector::getSplat(num_lanes, const_val);
+  };
+  auto pack = [&codegen, &numerics, num_lanes](uint32_t i) -> llvm::Value * {
+    if (num_lanes == 1) {
+      return numerics[0][i];
+    }
+    llvm::Value *lanes = llvm::UndefValue::get(
+        llvm::VectorType::get(codegen.Int64Type(), num_lanes));
+    for (uint32_t lane = 0; lane < num_lanes; lane++) {
+      lanes = codegen->CreateInsertElement(lanes, numerics[lane][i],
+                                           codegen.Const32(lane));
+    }
+    return lanes;
+  };
+
+  llvm::Value *magic_const1 = splat(kMurmur3C1);
+  llvm::Value *magic_const2 = splat(kMurmur3C2);
+  llvm::Value *combine_const = splat(kHashCombine);
+  llvm::Value *shift33 = splat(33), *shift6 = splat(6), *shift2 = splat(2);
 
   llvm::Value *hash = nullptr;
 
@@ -204,12 +273,13 @@ llvm::Value *Hash::ComputeMurmur3Hash(
   //   k ^= k >> 33;
   //   return k;
   // }
-  for (auto *val : numerics) {
-    llvm::Value *k = codegen->CreateXor(val, codegen->CreateLShr(val, 33));
+  for (uint32_t i = 0; i < numerics[0].size(); i++) {
+    llvm::Value *val = pack(i);
+    llvm::Value *k = codegen->CreateXor(val, codegen->CreateLShr(val, shift33));
     k = codegen->CreateMul(k, magic_const1);
-    k = codegen->CreateXor(k, codegen->CreateLShr(k, 33));
+    k = codegen->CreateXor(k, codegen->CreateLShr(k, shift33));
     k = codegen->CreateMul(k, magic_const2);
-    k = codegen->CreateXor(k, codegen->CreateLShr(k, 33));
+    k = codegen->CreateXor(k, codegen->CreateLShr(k, shift33));
 
     if (hash == nullptr) {
       hash = k;
@@ -218,18 +288,24 @@ llvm::Value *Hash::ComputeMurmur3Hash(
       // Lifted from Boost's hash_combine(...):
       // hash ^= hashed_val + 0x9e3779b9 + (hash << 6) + (hash >> 2);
       llvm::Value *sum = codegen->CreateAdd(k, combine_const);
-      sum = codegen->CreateAdd(sum, codegen->CreateShl(hash, 6));
-      sum = codegen->CreateAdd(sum, codegen->CreateLShr(hash, 2));
+      sum = codegen->CreateAdd(sum, codegen->CreateShl(hash, shift6));
+      sum = codegen->CreateAdd(sum, codegen->CreateLShr(hash, shift2));
       hash = codegen->CreateXor(hash, sum);
     }
   }
 
-  if (!varlen_buffers.empty()) {
-    throw Exception{"Cannot perform a vectorized Murmur3 hash on strings"};
+  if (num_lanes == 1) {
+    return {hash};
   }
-
-  return hash;
+  std::vector<llvm::Value *> hashes;
+  for (uint32_t lane = 0; lane < num_lanes; lane++) {
+    hashes.push_back(
+        hash != nullptr
+            ? codegen->CreateExtractElement(hash, codegen.Const32(lane))
+            : nullptr);
+  }
+  return hashes;
 }
 
 }  // namespace codegen
-}  // namespace peloton
\ No newline at end of file
+}  // namespace peloton
@@ -0,0 +1,198 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scanner.cpp
+//
+// Identification: src/codegen/index_scanner.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/index_scanner.h"
+
+#include <map>
+
+#include "catalog/manager.h"
+#include "common/container_tuple.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "index/index.h"
+#include "planner/index_scan_plan.h"
+#include "storage/masked_tuple.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace codegen {
+
+void IndexScanner::Init(const planner::IndexScanPlan *plan,
+                        executor::ExecutorContext *executor_context) {
+  PL_ASSERT(plan != nullptr && executor_context != nullptr);
+  plan_ = plan;
+  executor_context_ = executor_context;
+  results_ = new std::vector<TileGroupTids>();
+}
+
+uint32_t IndexScanner::Scan() {
+  PL_ASSERT(plan_ != nullptr && results_ != nullptr);
+  results_->clear();
+
+  auto index = plan_->GetIndex();
+  const auto &key_column_ids = plan_->GetKeyColumnIds();
+  const auto &expr_types = plan_->GetExprTypes();
+  auto index_predicate = plan_->GetIndexPredicate();
+
+  // The keys of the scan, which are computed now if they depend on the
+  // parameters of the query
+  std::vector<peloton::type::Value> values;
+  if (plan_->GetRunTimeKeys().size() != 0) {
+    for (auto *expr : plan_->GetRunTimeKeys()) {
+      values.push_back(
+          expr->Evaluate(nullptr, nullptr, executor_context_).Copy());
+    }
+  } else {
+    values = plan_->GetValues();
+  }
+
+  // Probe the index
+  std::vector<ItemPointer *> tuple_location_ptrs;
+  if (key_column_ids.size() == 0) {
+    index->ScanAllKeys(tuple_location_ptrs);
+  } else if (plan_->GetLimit()) {
+    auto direction = plan_->GetDescend() ? ScanDirectionType::BACKWARD
+                                         : ScanDirectionType::FORWARD;
+    index->ScanLimit(values, key_column_ids, expr_types, direction,
+                     tuple_location_ptrs,
+                     &index_predicate.GetConjunctionList()[0],
+                     plan_->GetLimitNumber(), plan_->GetLimitOffset());
+  } else {
+    index->Scan(values, key_column_ids, expr_types, ScanDirectionType::FORWARD,
+                tuple_location_ptrs, &index_predicate.GetConjunctionList()[0]);
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = executor_context_->GetTransaction();
+  auto &manager = catalog::Manager::GetInstance();
+  bool acquire_owner = plan_->IsForUpdate();
+  const auto &indexed_columns = index->GetKeySchema()->GetIndexedColumns();
+
+  // Collect the visible versions of the matching tuples by tile group
+  std::map<oid_t, std::vector<uint32_t>> visible_tuples;
+  for (auto *tuple_location_ptr : tuple_location_ptrs) {
+    ItemPointer location = *tuple_location_ptr;
+    bool found = false;
+    if (!FindVisibleVersion(location, found)) {
+      txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+      return 0;
+    }
+    if (!found) {
+      continue;
+    }
+
+    // The version may not have the key anymore. This also checks the bounds
+    // of open ranges, which the index includes.
+    auto tile_group = manager.ResolveTileGroup(location.block);
+    expression::ContainerTuple<storage::TileGroup> tuple(tile_group,
+                                                         location.offset);
+    if (key_column_ids.size() != 0) {
+      storage::MaskedTuple key_tuple(&tuple, indexed_columns);
+      if (!index->Compare(key_tuple, key_column_ids, expr_types, values)) {
+        continue;
+      }
+    }
+
+    if (!txn_manager.PerformRead(txn, location, acquire_owner)) {
+      txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+      return 0;
+    }
+    visible_tuples[location.block].push_back(location.offset);
+  }
+
+  for (auto &tuples : visible_tuples) {
+    results_->emplace_back(manager.GetTileGroup(tuples.first),
+                           std::move(tuples.second));
+  }
+
+  LOG_TRACE("Index scan on '%s' found tuples in %lu tile groups",
+            index->GetName().c_str(), results_->size());
+  return static_cast<uint32_t>(results_->size());
+}
+
+storage::TileGroup *IndexScanner::GetTileGroup(uint32_t tile_group_idx) const {
+  PL_ASSERT(tile_group_idx < results_->size());
+  return (*results_)[tile_group_idx].first.get();
+}
+
+uint32_t *IndexScanner::GetTids(uint32_t tile_group_idx) const {
+  PL_ASSERT(tile_group_idx < results_->size());
+  return (*results_)[tile_group_idx].second.data();
+}
+
+uint32_t IndexScanner::GetTidCount(uint32_t tile_group_idx) const {
+  PL_ASSERT(tile_group_idx < results_->size());
+  return static_cast<uint32_t>((*results_)[tile_group_idx].second.size());
+}
+
+void IndexScanner::Destroy() {
+  delete results_;
+  results_ = nullptr;
+}
+
+// Traverse the version chain until the version the transaction sees, as the
+// index scan executor does
+bool IndexScanner::FindVisibleVersion(ItemPointer &location,
+                                      bool &found) const {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = executor_context_->GetTransaction();
+  auto &manager = catalog::Manager::GetInstance();
+
+  auto tile_group = manager.ResolveTileGroup(location.block);
+  auto *tile_group_header = tile_group->GetHeader();
+  size_t chain_length = 0;
+  found = false;
+  while (true) {
+    ++chain_length;
+
+    auto visibility =
+        txn_manager.IsVisible(txn, tile_group_header, location.offset);
+    if (visibility == VisibilityType::DELETED) {
+      return true;
+    }
+    if (visibility == VisibilityType::OK) {
+      // the versions behind one that every transaction sees are garbage
+      txn_manager.PruneVersionChain(tile_group_header, location.offset);
+      found = true;
+      return true;
+    }
+    PL_ASSERT(visibility == VisibilityType::INVISIBLE);
+
+    bool is_acquired = (tile_group_header->GetTransactionId(location.offset) ==
+                        INITIAL_TXN_ID);
+    bool is_alive = (tile_group_header->GetEndCommitId(location.offset) <=
+                     txn->GetReadId());
+    if (is_acquired && is_alive) {
+      // Another transaction modified the version chain, start over from its
+      // head
+      location = *(tile_group_header->GetIndirection(location.offset));
+      tile_group = manager.ResolveTileGroup(location.block);
+      tile_group_header = tile_group->GetHeader();
+      chain_length = 0;
+      continue;
+    }
+
+    location = tile_group_header->GetNextItemPointer(location.offset);
+    if (location.IsNull()) {
+      // An aborted version with no older ones is skipped. Otherwise, some
+      // version must have been visible.
+      return chain_length == 1;
+    }
+    tile_group = manager.ResolveTileGroup(location.block);
+    tile_group_header = tile_group->GetHeader();
+  }
+}
+
+}  // namespace codegen
+}  // namespace peloton
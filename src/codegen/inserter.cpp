@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// inserter.cpp
+//
+// Identification: src/codegen/inserter.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/inserter.h"
+
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "planner/insert_plan.h"
+#include "storage/data_table.h"
+#include "storage/foreign_key_cache.h"
+#include "storage/tuple.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace codegen {
+
+void Inserter::Init(storage::DataTable *table,
+                    executor::ExecutorContext *executor_context) {
+  PL_ASSERT(table != nullptr && executor_context != nullptr);
+  table_ = table;
+  executor_context_ = executor_context;
+
+  auto *schema = table_->GetSchema();
+  values_ = new peloton::type::Value[schema->GetColumnCount()];
+  tuple_ = new storage::Tuple(schema, true);
+  foreign_key_cache_ =
+      table_->HasForeignKeys() ? new storage::ForeignKeyCache() : nullptr;
+}
+
+char *Inserter::GetValues() const {
+  return reinterpret_cast<char *>(values_);
+}
+
+bool Inserter::Insert() {
+  PL_ASSERT(table_ != nullptr && values_ != nullptr);
+
+  auto *pool = executor_context_->GetPool();
+  uint32_t column_count = table_->GetSchema()->GetColumnCount();
+  for (uint32_t col_id = 0; col_id < column_count; col_id++) {
+    tuple_->SetValue(col_id, values_[col_id], pool);
+  }
+  return InsertTuple(tuple_);
+}
+
+void Inserter::InsertPlanTuples(const planner::InsertPlan *plan) {
+  PL_ASSERT(plan != nullptr);
+
+  // Probe the distinct referenced keys of all the tuples at once. A missing
+  // key is reported by the insert of its tuple.
+  if (foreign_key_cache_ != nullptr && plan->GetBulkInsertCount() > 1) {
+    std::vector<const storage::Tuple *> tuples;
+    for (oid_t insert_itr = 0; insert_itr < plan->GetBulkInsertCount();
+         insert_itr++) {
+      const storage::Tuple *tuple = plan->GetTuple(insert_itr);
+      if (tuple != nullptr) {
+        tuples.push_back(tuple);
+      }
+    }
+    table_->CheckForeignKeyConstraints(tuples, foreign_key_cache_);
+  }
+
+  for (oid_t insert_itr = 0; insert_itr < plan->GetBulkInsertCount();
+       insert_itr++) {
+    const storage::Tuple *tuple = plan->GetTuple(insert_itr);
+    if (tuple == nullptr) {
+      // Bulk inserts of a single tuple insert it repeatedly
+      tuple = plan->GetTuple(0);
+    }
+    PL_ASSERT(tuple != nullptr);
+    if (!InsertTuple(tuple)) {
+      return;
+    }
+  }
+}
+
+void Inserter::Destroy() {
+  delete[] values_;
+  values_ = nullptr;
+  delete tuple_;
+  tuple_ = nullptr;
+  delete foreign_key_cache_;
+  foreign_key_cache_ = nullptr;
+}
+
+bool Inserter::InsertTuple(const storage::Tuple *tuple) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = executor_context_->GetTransaction();
+
+  // Stop inserting once the transaction failed
+  if (txn->GetResult() == ResultType::FAILURE) {
+    return false;
+  }
+
+  ItemPointer *index_entry_ptr = nullptr;
+  ItemPointer location =
+      table_->InsertTuple(tuple, txn, &index_entry_ptr, foreign_key_cache_);
+
+  // A concurrent transaction may have inserted the same key
+  if (location.block == INVALID_OID) {
+    LOG_TRACE("Failed to insert into table '%s'", table_->GetName().c_str());
+    txn_manager.SetTransactionResult(txn, ResultType::FAILURE);
+    return false;
+  }
+
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  executor_context_->num_processed++;
+  return true;
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -49,11 +49,23 @@ llvm::Value *VectorizedLoop::GetLoopVar(uint32_t index) const {
 
 void VectorizedLoop::LoopEnd(CodeGen &codegen,
                              const std::vector<llvm::Value *> &loop_vars) {
+  LoopEnd(codegen, loop_vars, nullptr);
+}
+
+void VectorizedLoop::LoopEnd(CodeGen &codegen,
+                             const std::vector<llvm::Value *> &loop_vars,
+                             llvm::Value *break_condition) {
   llvm::Value *next_start =
       codegen->CreateAdd(start_, codegen.Const32(vector_size_));
   std::vector<llvm::Value *> next = {next_start};
   next.insert(next.end(), loop_vars.begin(), loop_vars.end());
-  loop_.LoopEnd(codegen->CreateICmpULT(next_start, num_elements_), next);
+  llvm::Value *end_condition =
+      codegen->CreateICmpULT(next_start, num_elements_);
+  if (break_condition != nullptr) {
+    end_condition = codegen->CreateAnd(end_condition,
+                                       codegen->CreateNot(break_condition));
+  }
+  loop_.LoopEnd(end_condition, next);
   ended_ = true;
 }
 
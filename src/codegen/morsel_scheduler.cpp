@@ -0,0 +1,312 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// morsel_scheduler.cpp
+//
+// Identification: src/codegen/morsel_scheduler.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/morsel_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "concurrency/transaction.h"
+#include "configuration/configuration.h"
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// The state a parallel scan shares with its worker threads. It is owned by
+// the tasks of the workers too, since a worker may only start after the scan
+// is finished. It then finds the scan closed, and returns.
+//===----------------------------------------------------------------------===//
+struct ParallelScan {
+  uint64_t state_size;
+  uint64_t num_tile_groups;
+  uint64_t morsel_size;
+  MorselScheduler::ScanFunction scan_func;
+  MorselScheduler::InitFunction init_func;
+
+  // The runtime state before the scan started, which the workers copy
+  std::unique_ptr<char[]> initial_state;
+
+  // The first tile group of the next morsel
+  std::atomic<uint64_t> next_tile_group{0};
+
+  // Set when a morsel failed, so that no more are taken
+  std::atomic<bool> failed{false};
+
+  std::mutex scan_mutex;
+  std::condition_variable scan_cv;
+
+  // Set once all morsels were taken, after which no more workers may join
+  bool closed = false;
+
+  // Workers that joined the scan and did not finish yet
+  uint64_t active_workers = 0;
+
+  // The state of the workers that scanned at least one morsel
+  std::vector<std::unique_ptr<char[]>> thread_states;
+
+  // The first exception thrown by a thread
+  std::exception_ptr error;
+
+  void SetError(std::exception_ptr exception) {
+    std::lock_guard<std::mutex> lock(scan_mutex);
+    if (error == nullptr) {
+      error = exception;
+    }
+    failed = true;
+  }
+
+  // Scan morsels into the given state until none are left. The state is set
+  // up before the first morsel, if required. Returns whether any morsel was
+  // scanned.
+  bool ScanMorsels(char *state, bool init_state) {
+    bool scanned = false;
+    try {
+      while (failed == false) {
+        uint64_t start = next_tile_group.fetch_add(morsel_size);
+        if (start >= num_tile_groups) {
+          break;
+        }
+        if (scanned == false && init_state) {
+          init_func(state);
+        }
+        scanned = true;
+        scan_func(state, start, std::min(start + morsel_size, num_tile_groups));
+      }
+    } catch (...) {
+      SetError(std::current_exception());
+    }
+    return scanned;
+  }
+};
+
+// Take part in the scan on a worker thread, unless it is finished already
+void RunWorker(ParallelScan &scan) {
+  std::unique_ptr<char[]> thread_state;
+  {
+    std::lock_guard<std::mutex> lock(scan.scan_mutex);
+    if (scan.closed) {
+      return;
+    }
+    scan.active_workers++;
+  }
+
+  thread_state.reset(new char[scan.state_size]);
+  PL_MEMCPY(thread_state.get(), scan.initial_state.get(), scan.state_size);
+  bool scanned = scan.ScanMorsels(thread_state.get(), true);
+
+  {
+    std::lock_guard<std::mutex> lock(scan.scan_mutex);
+    if (scanned) {
+      scan.thread_states.push_back(std::move(thread_state));
+    }
+    scan.active_workers--;
+  }
+  scan.scan_cv.notify_all();
+}
+
+//===----------------------------------------------------------------------===//
+// The state the threads merging the partitions of a parallel scan share
+//===----------------------------------------------------------------------===//
+struct PartitionMerge {
+  char *runtime_state;
+  std::vector<char *> thread_states;
+  uint64_t num_partitions;
+  MorselScheduler::MergePartitionFunction merge_partition_func;
+  std::shared_ptr<ParallelScan> scan;
+
+  // The next partition to merge
+  std::atomic<uint64_t> next_partition{0};
+
+  // Threads that are merging partitions
+  uint64_t active_mergers = 0;
+
+  // Merge partitions until none are left. Every partition is merged even if
+  // another one failed, so that all of them can be cleaned up.
+  void MergePartitions() {
+    while (true) {
+      uint64_t partition = next_partition.fetch_add(1);
+      if (partition >= num_partitions) {
+        break;
+      }
+      try {
+        merge_partition_func(runtime_state, thread_states.data(),
+                             thread_states.size(), partition);
+      } catch (...) {
+        scan->SetError(std::current_exception());
+      }
+    }
+  }
+};
+
+// Merge partitions on a worker thread, unless all are taken already
+void RunMerger(PartitionMerge &merge) {
+  auto &scan = *merge.scan;
+  {
+    std::lock_guard<std::mutex> lock(scan.scan_mutex);
+    if (merge.next_partition >= merge.num_partitions) {
+      return;
+    }
+    merge.active_mergers++;
+  }
+
+  merge.MergePartitions();
+
+  {
+    std::lock_guard<std::mutex> lock(scan.scan_mutex);
+    merge.active_mergers--;
+  }
+  scan.scan_cv.notify_all();
+}
+
+}  // namespace
+
+MorselScheduler &MorselScheduler::GetInstance() {
+  static MorselScheduler morsel_scheduler;
+  return morsel_scheduler;
+}
+
+MorselScheduler::MorselScheduler()
+    : worker_count(0), started(false), stopped(false) {}
+
+MorselScheduler::~MorselScheduler() { Shutdown(); }
+
+void MorselScheduler::ExecuteParallelScan(concurrency::Transaction &txn,
+                                          char *runtime_state,
+                                          uint64_t state_size,
+                                          uint64_t num_tile_groups,
+                                          ScanFunction scan_func,
+                                          InitFunction init_func,
+                                          MergeFunction merge_func,
+                                          uint64_t num_partitions,
+                                          MergePartitionFunction
+                                              merge_partition_func) {
+  uint64_t thread_count = GetThreadCount(num_tile_groups);
+  if (thread_count <= 1) {
+    // The calling thread scans all tile groups into the runtime state
+    scan_func(runtime_state, 0, num_tile_groups);
+    return;
+  }
+
+  auto scan = std::make_shared<ParallelScan>();
+  scan->state_size = state_size;
+  scan->num_tile_groups = num_tile_groups;
+  scan->morsel_size = morsel_size;
+  scan->scan_func = scan_func;
+  scan->init_func = init_func;
+  scan->initial_state.reset(new char[state_size]);
+  PL_MEMCPY(scan->initial_state.get(), runtime_state, state_size);
+
+  // The workers record their reads in the transaction until all are done
+  txn.Share();
+  for (uint64_t i = 1; i < thread_count; i++) {
+    worker_pool.SubmitTask([scan] { RunWorker(*scan); });
+  }
+
+  // The calling thread scans into the runtime state of the query, which needs
+  // no set up
+  scan->ScanMorsels(runtime_state, false);
+
+  // All morsels are taken, wait for the workers that are still scanning
+  {
+    std::unique_lock<std::mutex> lock(scan->scan_mutex);
+    scan->closed = true;
+    scan->scan_cv.wait(lock, [&scan] { return scan->active_workers == 0; });
+  }
+  txn.Unshare();
+
+  LOG_TRACE("Scanned %llu tile groups on %llu threads",
+            (unsigned long long)num_tile_groups,
+            (unsigned long long)scan->thread_states.size() + 1);
+
+  // Merge the partitions of all states on all threads, unless the scan failed.
+  // The calling thread consumed into the runtime state of the query, so it is
+  // merged too.
+  if (num_partitions > 1 && !scan->thread_states.empty() && !scan->failed) {
+    auto merge = std::make_shared<PartitionMerge>();
+    merge->runtime_state = runtime_state;
+    merge->thread_states.push_back(runtime_state);
+    for (auto &thread_state : scan->thread_states) {
+      merge->thread_states.push_back(thread_state.get());
+    }
+    merge->num_partitions = num_partitions;
+    merge->merge_partition_func = merge_partition_func;
+    merge->scan = scan;
+
+    uint64_t merge_thread_count = std::min(thread_count, num_partitions);
+    for (uint64_t i = 1; i < merge_thread_count; i++) {
+      worker_pool.SubmitTask([merge] { RunMerger(*merge); });
+    }
+    merge->MergePartitions();
+
+    std::unique_lock<std::mutex> lock(scan->scan_mutex);
+    scan->scan_cv.wait(lock, [&merge] { return merge->active_mergers == 0; });
+  }
+
+  // Merging also cleans up the state of the workers, so it is done even if
+  // the scan failed. After a partitioned merge, this only cleans up.
+  for (auto &thread_state : scan->thread_states) {
+    try {
+      merge_func(runtime_state, thread_state.get());
+    } catch (...) {
+      scan->SetError(std::current_exception());
+    }
+  }
+
+  if (scan->error != nullptr) {
+    std::rethrow_exception(scan->error);
+  }
+}
+
+void MorselScheduler::Shutdown() {
+  std::lock_guard<std::mutex> lock(scheduler_mutex);
+  if (started && !stopped && worker_count > 0) {
+    worker_pool.Shutdown();
+  }
+  stopped = true;
+}
+
+uint64_t MorselScheduler::GetThreadCount(uint64_t num_tile_groups) {
+  uint64_t num_morsels = (num_tile_groups + morsel_size - 1) / morsel_size;
+
+  std::lock_guard<std::mutex> lock(scheduler_mutex);
+  if (stopped) {
+    return 1;
+  }
+
+  if (!started) {
+    uint64_t thread_count = FLAGS_codegen_parallel_scan_threads;
+    if (thread_count == 0) {
+      thread_count = std::thread::hardware_concurrency();
+    }
+    worker_count = thread_count > 1 ? thread_count - 1 : 0;
+    if (worker_count > 0) {
+      // Spread the workers over the NUMA nodes of the machine
+      worker_pool.Initialize(worker_count, 0, ThreadPlacement::NUMA_NODE);
+    }
+    started = true;
+  }
+
+  return std::min(worker_count + 1, num_morsels);
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -28,10 +28,15 @@ namespace codegen {
 // The global default prefetch distance
 uint32_t OAHashTable::kDefaultGroupPrefetchSize = 10;
 
+// Roughly the size of the L2 cache
+uint64_t OAHashTable::kPrefetchThreshold = 256 * 1024;
+
 // The global attribute information instance used to populate a row's hash value
 const planner::AttributeInfo OAHashTable::kHashAI{type::Integer::Instance(), 0,
                                                   "hash"};
 
+constexpr uint32_t OAHashTable::kHashBatchSize;
+
 //===----------------------------------------------------------------------===//
 // CONSTRUCTORS
 //===----------------------------------------------------------------------===//
@@ -453,6 +458,24 @@ void OAHashTable::Insert(CodeGen &codegen, llvm::Value *ht_ptr,
 
 void OAHashTable::Iterate(CodeGen &codegen, llvm::Value *hash_table,
                           IterateCallback &callback) const {
+  IterateEntries(codegen, hash_table, nullptr, 0, callback);
+}
+
+void OAHashTable::IteratePartition(CodeGen &codegen, llvm::Value *hash_table,
+                                   llvm::Value *partition,
+                                   uint32_t partition_bits,
+                                   IterateCallback &callback) const {
+  PL_ASSERT(partition_bits > 0 && partition_bits < 64);
+  IterateEntries(codegen, hash_table, partition, partition_bits, callback);
+}
+
+// Iterate over the entries of the hash table, or over the ones in the given
+// partition only if there is one. The partition of an entry is given by the
+// top bits of its hash, since the low ones pick its bucket.
+void OAHashTable::IterateEntries(CodeGen &codegen, llvm::Value *hash_table,
+                                 llvm::Value *partition,
+                                 uint32_t partition_bits,
+                                 IterateCallback &callback) const {
   // Load the size of the array
   llvm::Value *num_buckets = LoadHashTableField(codegen, hash_table, 1);
 
@@ -486,6 +509,15 @@ void OAHashTable::Iterate(CodeGen &codegen, llvm::Value *hash_table,
     // Return the result of comparison (if ptr is 0 then the slot is free)
     llvm::Value *status_neq_zero = IsPtrUnEqualTo(codegen, kv_p, 0UL);
 
+    // Skip the entries of other partitions
+    if (partition != nullptr) {
+      llvm::Value *hash = LoadHashEntryField(codegen, entry_ptr, 0, 1);
+      llvm::Value *entry_partition =
+          codegen->CreateLShr(hash, codegen.Const64(64 - partition_bits));
+      status_neq_zero = codegen->CreateAnd(
+          status_neq_zero, codegen->CreateICmpEQ(entry_partition, partition));
+    }
+
     // If the bucket is not free
     lang::If bucket_occupied{codegen, status_neq_zero, "bucketIsOccupied"};
     {
@@ -601,6 +633,7 @@ void OAHashTable::VectorizedIterate(
 }
 
 void OAHashTable::FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
+                          llvm::Value *hash,
                           const std::vector<codegen::Value> &key,
                           IterateCallback &callback) const {
   auto key_found = [&codegen, &callback, &key](llvm::Value *data_ptr) {
@@ -610,7 +643,7 @@ void OAHashTable::FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
   // It does not do anything for a key that is not found
   auto key_not_found = [](llvm::Value *data_ptr) { (void)data_ptr; };
 
-  TranslateProbing(codegen, ht_ptr, nullptr, key,
+  TranslateProbing(codegen, ht_ptr, hash, key,
                    key_found,      // Key found then process it and break
                    key_not_found,  // Key not found then do nothing
                    true,           // process value
@@ -656,6 +689,62 @@ void OAHashTable::PrefetchBucket(CodeGen &codegen, llvm::Value *ht_ptr,
   codegen.CallFunc(prefetch_func, fn_args);
 }
 
+void OAHashTable::HashAndPrefetch(CodeGen &codegen, llvm::Value *ht_ptr,
+                                  llvm::Value *num_rows, Vector &hashes,
+                                  const KeyCollector &key_collector,
+                                  PrefetchType pf_type,
+                                  Locality locality) const {
+  static_assert((kHashBatchSize & (kHashBatchSize - 1)) == 0,
+                "The hash batch size must be a power of two");
+
+  // The rows of all full batches
+  llvm::Value *num_batched =
+      codegen->CreateAnd(num_rows, codegen.Const32(~(kHashBatchSize - 1)));
+
+  llvm::Value *p = codegen.Const32(0);
+  lang::Loop batch_loop{
+      codegen, codegen->CreateICmpULT(p, num_batched), {{"p", p}}};
+  {
+    p = batch_loop.GetLoopVar(0);
+
+    std::vector<llvm::Value *> row_idxs;
+    std::vector<std::vector<codegen::Value>> keys{kHashBatchSize};
+    for (uint32_t i = 0; i < kHashBatchSize; i++) {
+      row_idxs.push_back(codegen->CreateAdd(p, codegen.Const32(i)));
+      key_collector(row_idxs[i], keys[i]);
+    }
+
+    std::vector<llvm::Value *> hash_vals = Hash::HashValues(codegen, keys);
+    for (uint32_t i = 0; i < kHashBatchSize; i++) {
+      hashes.SetValue(codegen, row_idxs[i], hash_vals[i]);
+      PrefetchBucket(codegen, ht_ptr, hash_vals[i], pf_type, locality);
+    }
+
+    p = codegen->CreateAdd(p, codegen.Const32(kHashBatchSize));
+    batch_loop.LoopEnd(codegen->CreateICmpULT(p, num_batched), {p});
+  }
+
+  std::vector<llvm::Value *> final_vals;
+  batch_loop.CollectFinalLoopVariables(final_vals);
+
+  // The rows after the last full batch are hashed one at a time
+  p = final_vals[0];
+  lang::Loop tail_loop{codegen, codegen->CreateICmpULT(p, num_rows), {{"p", p}}};
+  {
+    p = tail_loop.GetLoopVar(0);
+
+    std::vector<codegen::Value> key;
+    key_collector(p, key);
+
+    llvm::Value *hash_val = HashKey(codegen, key);
+    hashes.SetValue(codegen, p, hash_val);
+    PrefetchBucket(codegen, ht_ptr, hash_val, pf_type, locality);
+
+    p = codegen->CreateAdd(p, codegen.Const32(1));
+    tail_loop.LoopEnd(codegen->CreateICmpULT(p, num_rows), {p});
+  }
+}
+
 void OAHashTable::OAHashTableAccess::ExtractBucketKeys(
     CodeGen &codegen, llvm::Value *index,
     std::vector<codegen::Value> &key) const {
@@ -0,0 +1,290 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache.cpp
+//
+// Identification: src/codegen/object_cache.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/object_cache.h"
+
+#include <dlfcn.h>
+#include <link.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include "catalog/schema.h"
+#include "codegen/query_parameters.h"
+#include "common/logger.h"
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "storage/storage_manager.h"
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+// Find the GNU build id of the object a function of this file was loaded
+// from, libpeloton or the executable it is linked into
+int FindBuildId(struct dl_phdr_info *info, size_t, void *data) {
+  auto address = reinterpret_cast<ElfW(Addr)>(&FindBuildId);
+  bool is_loaded_from = false;
+  for (int header_itr = 0; header_itr < info->dlpi_phnum; header_itr++) {
+    const auto &header = info->dlpi_phdr[header_itr];
+    auto start = info->dlpi_addr + header.p_vaddr;
+    if (header.p_type == PT_LOAD && address >= start &&
+        address < start + header.p_memsz) {
+      is_loaded_from = true;
+    }
+  }
+  if (is_loaded_from == false) {
+    return 0;
+  }
+
+  auto &build_id = *static_cast<std::string *>(data);
+  for (int header_itr = 0; header_itr < info->dlpi_phnum; header_itr++) {
+    const auto &header = info->dlpi_phdr[header_itr];
+    if (header.p_type != PT_NOTE) {
+      continue;
+    }
+    auto *notes =
+        reinterpret_cast<const char *>(info->dlpi_addr + header.p_vaddr);
+    size_t offset = 0;
+    while (offset + sizeof(ElfW(Nhdr)) <= header.p_memsz) {
+      auto *note = reinterpret_cast<const ElfW(Nhdr) *>(notes + offset);
+      size_t name_size = (note->n_namesz + 3) & ~3;
+      size_t desc_size = (note->n_descsz + 3) & ~3;
+      auto *desc = reinterpret_cast<const unsigned char *>(
+          notes + offset + sizeof(ElfW(Nhdr)) + name_size);
+      if (note->n_type == NT_GNU_BUILD_ID) {
+        static const char *kHexDigits = "0123456789abcdef";
+        for (size_t byte_itr = 0; byte_itr < note->n_descsz; byte_itr++) {
+          build_id += kHexDigits[desc[byte_itr] >> 4];
+          build_id += kHexDigits[desc[byte_itr] & 0xf];
+        }
+        return 1;
+      }
+      offset += sizeof(ElfW(Nhdr)) + name_size + desc_size;
+    }
+  }
+  return 1;
+}
+
+// The build id of Peloton, or the size and modification time of its file if
+// it was linked without one
+std::string GetBuildId() {
+  std::string build_id;
+  dl_iterate_phdr(FindBuildId, &build_id);
+  if (build_id.empty() == false) {
+    return build_id;
+  }
+  Dl_info dl_info;
+  struct stat file_stat;
+  if (dladdr(reinterpret_cast<void *>(&FindBuildId), &dl_info) != 0 &&
+      stat(dl_info.dli_fname, &file_stat) == 0) {
+    return std::to_string(file_stat.st_size) + "-" +
+           std::to_string(file_stat.st_mtime);
+  }
+  return "";
+}
+
+// The name and the features of the CPU the code is compiled for
+std::string GetCPU() {
+  std::string cpu = llvm::sys::getHostCPUName().str();
+  llvm::StringMap<bool> feature_map;
+  std::vector<std::string> features;
+  if (llvm::sys::getHostCPUFeatures(feature_map)) {
+    for (auto &feature : feature_map) {
+      features.push_back((feature.getValue() ? "+" : "-") +
+                         feature.getKey().str());
+    }
+  }
+  std::sort(features.begin(), features.end());
+  for (auto &feature : features) {
+    cpu += "," + feature;
+  }
+  return cpu;
+}
+
+}  // namespace
+
+ObjectCache &ObjectCache::GetInstance() {
+  static ObjectCache object_cache;
+  return object_cache;
+}
+
+ObjectCache::ObjectCache() : load_count_(0), store_count_(0) {
+  auto build_id = GetBuildId();
+  if (build_id.empty()) {
+    LOG_WARN("Cannot identify the build, compiled queries are not persisted");
+    return;
+  }
+  environment_ = "build=" + build_id + ";llvm=" LLVM_VERSION_STRING ";cpu=" +
+                 GetCPU();
+}
+
+void ObjectCache::SetDirectory(const std::string &directory) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  directory_.clear();
+  if (directory.empty() || environment_.empty()) {
+    return;
+  }
+  boost::system::error_code error;
+  boost::filesystem::create_directories(directory, error);
+  if (error) {
+    LOG_ERROR("Cannot create the compiled query directory %s: %s",
+              directory.c_str(), error.message().c_str());
+    return;
+  }
+  directory_ = directory;
+}
+
+bool ObjectCache::IsEnabled() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return directory_.empty() == false;
+}
+
+std::string ObjectCache::GetKey(const QueryParameters &parameters,
+                                bool optimized) {
+  // The code depends on the columns and indexes of the tables, and the oids
+  // of dropped tables are given to new ones by a later process
+  std::string key = parameters.GetSignature();
+  key += optimized ? "|optimized" : "|unoptimized";
+  auto *storage_manager = storage::StorageManager::GetInstance();
+  for (const auto &table_oid : parameters.GetTableOids()) {
+    auto *table = storage_manager->GetTableWithOid(table_oid.first,
+                                                   table_oid.second);
+    key += "|" + table->GetSchema()->GetInfo();
+    for (oid_t index_itr = 0; index_itr < table->GetIndexCount();
+         index_itr++) {
+      auto index = table->GetIndex(index_itr);
+      if (index == nullptr) {
+        continue;
+      }
+      key += "|" + std::to_string(index->GetOid()) + ":" +
+             IndexTypeToString(index->GetIndexMethodType()) + ":" +
+             index->GetKeySchema()->GetInfo();
+    }
+  }
+  return key;
+}
+
+std::string ObjectCache::GetFileName(const std::string &directory,
+                                     const std::string &key) const {
+  std::stringstream file_name;
+  file_name << directory << "/" << std::hex
+            << std::hash<std::string>{}(environment_ + '\0' + key) << ".o";
+  return file_name.str();
+}
+
+// An object file holds the length of its header, the header with the
+// environment and the key it was compiled for, and then the object
+bool ObjectCache::ReadObject(const std::string &key, std::string *object) {
+  std::string directory;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory = directory_;
+  }
+  if (directory.empty()) {
+    return false;
+  }
+
+  std::ifstream file(GetFileName(directory, key), std::ios::binary);
+  std::string header = environment_ + '\0' + key;
+  uint64_t header_length = 0;
+  file.read(reinterpret_cast<char *>(&header_length), sizeof(header_length));
+  if (!file || header_length != header.size()) {
+    return false;
+  }
+  std::string file_header(header_length, '\0');
+  file.read(&file_header[0], header_length);
+  if (!file || file_header != header) {
+    return false;
+  }
+  if (object != nullptr) {
+    object->assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+    if (object->empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ObjectCache::HasObject(const std::string &key) {
+  return ReadObject(key, nullptr);
+}
+
+void ObjectCache::notifyObjectCompiled(const llvm::Module *module,
+                                       llvm::MemoryBufferRef object) {
+  std::string directory;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory = directory_;
+  }
+  if (directory.empty()) {
+    return;
+  }
+
+  // The object is written to a file of its own and then renamed, so that
+  // another process never reads part of it
+  const auto &key = module->getModuleIdentifier();
+  auto file_name = GetFileName(directory, key);
+  std::stringstream temp_name;
+  temp_name << file_name << "." << getpid() << "."
+            << std::hash<std::thread::id>{}(std::this_thread::get_id())
+            << ".tmp";
+  {
+    std::ofstream file(temp_name.str(), std::ios::binary | std::ios::trunc);
+    std::string header = environment_ + '\0' + key;
+    uint64_t header_length = header.size();
+    file.write(reinterpret_cast<const char *>(&header_length),
+               sizeof(header_length));
+    file.write(header.data(), header.size());
+    file.write(object.getBufferStart(), object.getBufferSize());
+    if (!file) {
+      LOG_ERROR("Cannot write the compiled query %s", file_name.c_str());
+      std::remove(temp_name.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(temp_name.str().c_str(), file_name.c_str()) != 0) {
+    std::remove(temp_name.str().c_str());
+    return;
+  }
+  store_count_++;
+  LOG_DEBUG("Stored the compiled query %s", file_name.c_str());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> ObjectCache::getObject(
+    const llvm::Module *module) {
+  std::string object;
+  if (ReadObject(module->getModuleIdentifier(), &object) == false) {
+    return nullptr;
+  }
+  load_count_++;
+  return llvm::MemoryBuffer::getMemBufferCopy(object);
+}
+
+}  // namespace codegen
+}  // namespace peloton
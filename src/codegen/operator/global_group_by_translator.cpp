@@ -29,8 +29,10 @@ GlobalGroupByTranslator::GlobalGroupByTranslator(
       child_pipeline_(this) {
   LOG_DEBUG("Constructing GlobalGroupByTranslator ...");
 
-  // Prepare the child in the new child pipeline
+  // Prepare the child in the new child pipeline. Its threads aggregate into
+  // their own buffer if it runs in parallel.
   context.Prepare(*plan_.GetChild(0), child_pipeline_);
+  child_pipeline_.MakeParallel();
 
   // Prepare all the aggregating expressions
   const auto &aggregates = plan_.GetUniqueAggTerms();
@@ -116,6 +118,21 @@ void GlobalGroupByTranslator::Consume(ConsumerContext &,
   aggregation_.AdvanceValues(GetCodeGen(), LoadStatePtr(mat_buffer_id_), vals);
 }
 
+void GlobalGroupByTranslator::InitializeThreadState() const {
+  aggregation_.CreateInitialGlobalValues(GetCodeGen(),
+                                         LoadStatePtr(mat_buffer_id_));
+}
+
+void GlobalGroupByTranslator::MergeThreadState(
+    llvm::Value *thread_state) const {
+  auto &codegen = GetCodeGen();
+  auto &runtime_state = GetCompilationContext().GetRuntimeState();
+  llvm::Value *thread_mat_buffer =
+      runtime_state.LoadStatePtr(codegen, mat_buffer_id_, thread_state);
+  aggregation_.MergeValues(codegen, LoadStatePtr(mat_buffer_id_),
+                           thread_mat_buffer);
+}
+
 //===----------------------------------------------------------------------===//
 // Get the stringified name of this global group-by
 //===----------------------------------------------------------------------===//
@@ -23,6 +23,10 @@ namespace codegen {
 
 std::atomic<bool> HashGroupByTranslator::kUsePrefetch{false};
 
+std::atomic<bool> HashGroupByTranslator::kUsePartitionedMerge{false};
+
+constexpr uint32_t HashGroupByTranslator::kMergePartitionBits;
+
 //===----------------------------------------------------------------------===//
 // HASH GROUP BY TRANSLATOR
 //===----------------------------------------------------------------------===//
@@ -39,20 +43,6 @@ HashGroupByTranslator::HashGroupByTranslator(
   auto &codegen = GetCodeGen();
   auto &runtime_state = context.GetRuntimeState();
 
-  // If we should be prefetching into the hash-table, install a boundary in the
-  // pipeline at the input into this translator to ensure it receives a vector
-  // of input tuples
-  if (UsePrefetching()) {
-    child_pipeline_.InstallBoundaryAtInput(this);
-
-    // Allocate slot for prefetch array
-    prefetch_vector_id_ = runtime_state.RegisterState(
-        "gpPrefetchVec",
-        codegen.VectorType(codegen.Int64Type(),
-                           OAHashTable::kDefaultGroupPrefetchSize),
-        true);
-  }
-
   // Allocate local stage for the output vector we produce
   output_vector_id_ = runtime_state.RegisterState(
       "hgbSelVec",
@@ -63,9 +53,6 @@ HashGroupByTranslator::HashGroupByTranslator(
   hash_table_id_ = runtime_state.RegisterState(
       "groupBy", OAHashTableProxy::GetType(codegen));
 
-  // Prepare the input operator to this group by
-  context.Prepare(*group_by_.GetChild(0), child_pipeline_);
-
   // Prepare the predicate if one exists
   if (group_by_.GetPredicate() != nullptr) {
     context.Prepare(*group_by_.GetPredicate());
@@ -100,11 +87,49 @@ HashGroupByTranslator::HashGroupByTranslator(
   // Create the hash table
   hash_table_ =
       OAHashTable{codegen, key_type, aggregation_.GetAggregatesStorageSize()};
+
+  // If we should be prefetching into the hash-table, install a boundary in the
+  // pipeline at the input into this translator to ensure it receives a vector
+  // of input tuples. This is decided once the size of the hash table entries
+  // is known.
+  if (UsePrefetching()) {
+    child_pipeline_.InstallBoundaryAtInput(this);
+
+    // Allocate slot for prefetch array
+    prefetch_vector_id_ = runtime_state.RegisterState(
+        "gpPrefetchVec",
+        codegen.VectorType(codegen.Int64Type(),
+                           OAHashTable::kDefaultGroupPrefetchSize),
+        true);
+  }
+
+  // Groups of the threads that are merged in partitions end up in the hash
+  // tables of the partitions
+  if (UsePartitionedMerge()) {
+    partitions_id_ = runtime_state.RegisterState(
+        "groupByPartitions",
+        llvm::ArrayType::get(OAHashTableProxy::GetType(codegen),
+                             GetNumMergePartitions()));
+    partitioned_id_ =
+        runtime_state.RegisterState("groupByPartitioned", codegen.BoolType());
+  }
+
+  // Prepare the input operator to this group by. Its threads group into
+  // their own hash table if it runs in parallel.
+  context.Prepare(*group_by_.GetChild(0), child_pipeline_);
+  child_pipeline_.MakeParallel();
 }
 
 // Initialize the hash table instance
 void HashGroupByTranslator::InitializeState() {
-  hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
+  auto &codegen = GetCodeGen();
+  hash_table_.Init(codegen, LoadStatePtr(hash_table_id_));
+
+  // The hash tables of the partitions are set up when merging into them
+  if (UsePartitionedMerge()) {
+    codegen->CreateStore(codegen.ConstBool(false),
+                         LoadStatePtr(partitioned_id_));
+  }
 }
 
 // Produce!
@@ -117,11 +142,42 @@ void HashGroupByTranslator::Produce() const {
   LOG_DEBUG("HashGroupBy starting to produce results ...");
 
   // Iterate over the hash table, sending tuples up the tree
+  auto &codegen = GetCodeGen();
   Vector selection_vec{LoadStateValue(output_vector_id_),
-                       Vector::kDefaultVectorSize, GetCodeGen().Int32Type()};
+                       Vector::kDefaultVectorSize, codegen.Int32Type()};
   ProduceResults producer{*this};
-  hash_table_.VectorizedIterate(GetCodeGen(), LoadStatePtr(hash_table_id_),
-                                selection_vec, producer);
+  if (!UsePartitionedMerge()) {
+    hash_table_.VectorizedIterate(codegen, LoadStatePtr(hash_table_id_),
+                                  selection_vec, producer);
+    return;
+  }
+
+  // The groups are either in the hash tables of the partitions, or in the
+  // one of the query if they were not merged in partitions. The latter comes
+  // after the former.
+  llvm::Value *num_partitions = codegen.Const64(GetNumMergePartitions());
+  llvm::Value *partitioned =
+      codegen->CreateLoad(LoadStatePtr(partitioned_id_));
+  llvm::Value *table_idx = codegen->CreateSelect(
+      partitioned, codegen.Const64(0), num_partitions);
+  llvm::Value *num_tables = codegen->CreateSelect(
+      partitioned, num_partitions,
+      codegen->CreateAdd(num_partitions, codegen.Const64(1)));
+  lang::Loop table_loop{codegen,
+                        codegen->CreateICmpULT(table_idx, num_tables),
+                        {{"tableIdx", table_idx}}};
+  {
+    table_idx = table_loop.GetLoopVar(0);
+    llvm::Value *hash_table = codegen->CreateSelect(
+        codegen->CreateICmpULT(table_idx, num_partitions),
+        GetPartitionPtr(table_idx), LoadStatePtr(hash_table_id_));
+    hash_table_.VectorizedIterate(codegen, hash_table, selection_vec,
+                                  producer);
+
+    table_idx = codegen->CreateAdd(table_idx, codegen.Const64(1));
+    table_loop.LoopEnd(codegen->CreateICmpULT(table_idx, num_tables),
+                       {table_idx});
+  }
 }
 
 void HashGroupByTranslator::Consume(ConsumerContext &context,
@@ -146,34 +202,17 @@ void HashGroupByTranslator::Consume(ConsumerContext &context,
         codegen->CreateSub(iter_instance.end, iter_instance.start);
 
     // The first loop does hash computation and prefetching
-    lang::Loop prefetch_loop{
-        codegen, codegen->CreateICmpULT(p, end), {{"p", p}}};
-    {
-      p = prefetch_loop.GetLoopVar(0);
+    auto collect_key = [&](llvm::Value *row_idx,
+                           std::vector<codegen::Value> &key) {
       RowBatch::Row row =
-          batch.GetRowAt(codegen->CreateAdd(p, iter_instance.start));
-
-      // Collect keys
-      std::vector<codegen::Value> key;
+          batch.GetRowAt(codegen->CreateAdd(row_idx, iter_instance.start));
       CollectHashKeys(row, key);
+    };
+    hash_table_.HashAndPrefetch(codegen, LoadStatePtr(hash_table_id_), end,
+                                hashes, collect_key,
+                                OAHashTable::PrefetchType::Write,
+                                OAHashTable::Locality::Medium);
 
-      // Hash the key and store in prefetch vector
-      llvm::Value *hash_val = hash_table_.HashKey(codegen, key);
-
-      // StoreValue hashed val in prefetch vector
-      hashes.SetValue(codegen, p, hash_val);
-
-      // Prefetch the actual hash table bucket
-      hash_table_.PrefetchBucket(codegen, LoadStatePtr(hash_table_id_),
-                                 hash_val, OAHashTable::PrefetchType::Read,
-                                 OAHashTable::Locality::Medium);
-
-      // End prefetch loop
-      p = codegen->CreateAdd(p, codegen.Const32(1));
-      prefetch_loop.LoopEnd(codegen->CreateICmpULT(p, end), {p});
-    }
-
-    p = codegen.Const32(0);
     std::vector<lang::Loop::LoopVariable> loop_vars = {
         {"p", p}, {"writeIdx", iter_instance.write_pos}};
     lang::Loop process_loop{codegen, codegen->CreateICmpULT(p, end), loop_vars};
@@ -245,22 +284,128 @@ void HashGroupByTranslator::Consume(ConsumerContext &,
 
 // Cleanup by destroying the aggregation hash-table
 void HashGroupByTranslator::TearDownState() {
-  hash_table_.Destroy(GetCodeGen(), LoadStatePtr(hash_table_id_));
+  auto &codegen = GetCodeGen();
+  hash_table_.Destroy(codegen, LoadStatePtr(hash_table_id_));
+
+  // The hash tables of the partitions exist only after a partitioned merge
+  if (UsePartitionedMerge()) {
+    llvm::Value *partitioned =
+        codegen->CreateLoad(LoadStatePtr(partitioned_id_));
+    lang::If merged_partitions{codegen, partitioned};
+    {
+      for (uint32_t i = 0; i < GetNumMergePartitions(); i++) {
+        hash_table_.Destroy(codegen, GetPartitionPtr(codegen.Const64(i)));
+      }
+    }
+    merged_partitions.EndIf();
+  }
+}
+
+// Every thread of the parallel child pipeline groups into its own hash table
+void HashGroupByTranslator::InitializeThreadState() const {
+  hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
+}
+
+// Merge the groups of the hash table of a thread into the one of the query
+void HashGroupByTranslator::MergeThreadState(llvm::Value *thread_state) const {
+  auto &codegen = GetCodeGen();
+  auto &runtime_state = GetCompilationContext().GetRuntimeState();
+  llvm::Value *thread_hash_table =
+      runtime_state.LoadStatePtr(codegen, hash_table_id_, thread_state);
+
+  // Groups that were merged in partitions are not merged again
+  llvm::Value *merged = codegen.ConstBool(false);
+  if (UsePartitionedMerge()) {
+    merged = codegen->CreateLoad(LoadStatePtr(partitioned_id_));
+  }
+  lang::If not_merged{codegen, codegen->CreateNot(merged)};
+  {
+    MergeGroups merge_groups{*this, LoadStatePtr(hash_table_id_)};
+    hash_table_.Iterate(codegen, thread_hash_table, merge_groups);
+  }
+  not_merged.EndIf();
+  hash_table_.Destroy(codegen, thread_hash_table);
+}
+
+// Many groups are merged in partitions, every one on its own thread
+uint32_t HashGroupByTranslator::GetNumMergePartitions() const {
+  return UsePartitionedMerge() ? 1u << kMergePartitionBits : 1;
+}
+
+// Merge the groups of the given partition from the hash tables of all threads
+// into the hash table of the partition. The threads merging other partitions
+// only read the same hash tables.
+void HashGroupByTranslator::MergePartition(llvm::Value *thread_states,
+                                           llvm::Value *num_thread_states,
+                                           llvm::Value *partition) const {
+  auto &codegen = GetCodeGen();
+  auto &runtime_state = GetCompilationContext().GetRuntimeState();
+
+  llvm::Value *partition_table = GetPartitionPtr(partition);
+  hash_table_.Init(codegen, partition_table);
+
+  llvm::Value *state_idx = codegen.Const64(0);
+  lang::Loop state_loop{codegen,
+                        codegen->CreateICmpULT(state_idx, num_thread_states),
+                        {{"stateIdx", state_idx}}};
+  {
+    state_idx = state_loop.GetLoopVar(0);
+    llvm::Value *thread_state = codegen->CreateLoad(
+        codegen->CreateInBoundsGEP(thread_states, state_idx));
+    llvm::Value *thread_hash_table =
+        runtime_state.LoadStatePtr(codegen, hash_table_id_, thread_state);
+
+    MergeGroups merge_groups{*this, partition_table};
+    hash_table_.IteratePartition(codegen, thread_hash_table, partition,
+                                 kMergePartitionBits, merge_groups);
+
+    state_idx = codegen->CreateAdd(state_idx, codegen.Const64(1));
+    state_loop.LoopEnd(codegen->CreateICmpULT(state_idx, num_thread_states),
+                       {state_idx});
+  }
+
+  // Only the thread merging the first partition marks the groups as merged,
+  // which the merges of the threads check once all partitions are merged
+  lang::If first_partition{
+      codegen, codegen->CreateICmpEQ(partition, codegen.Const64(0))};
+  {
+    codegen->CreateStore(codegen.ConstBool(true),
+                         LoadStatePtr(partitioned_id_));
+  }
+  first_partition.EndIf();
 }
 
 // Get the stringified name of this hash-based group-by
 std::string HashGroupByTranslator::GetName() const { return "HashGroupBy"; }
 
 // Estimate the size of the dynamically constructed hash-table
+// Estimate the size of the hash table from the number of groups the
+// optimizer estimated
 uint64_t HashGroupByTranslator::EstimateHashTableSize() const {
-  // TODO: Implement me
-  return 0;
+  return group_by_.GetGroupCardinality() * hash_table_.HashEntrySize();
 }
 
-// Should this aggregation use prefetching
+// Should this aggregation use prefetching? Hash tables that do not fit in the
+// L2 cache miss on most probes, prefetching overlaps the misses of a group of
+// probes.
 bool HashGroupByTranslator::UsePrefetching() const {
-  // TODO: Implement me
-  return kUsePrefetch;
+  return kUsePrefetch ||
+         EstimateHashTableSize() >= OAHashTable::kPrefetchThreshold;
+}
+
+// Should the groups of the threads be merged in partitions? Merging the groups
+// of large hash tables on a single thread takes as long as grouping them in
+// the first place.
+bool HashGroupByTranslator::UsePartitionedMerge() const {
+  return kUsePartitionedMerge ||
+         EstimateHashTableSize() >= OAHashTable::kPrefetchThreshold;
+}
+
+llvm::Value *HashGroupByTranslator::GetPartitionPtr(
+    llvm::Value *partition) const {
+  auto &codegen = GetCodeGen();
+  return codegen->CreateGEP(LoadStatePtr(partitions_id_),
+                            {codegen.Const32(0), partition});
 }
 
 void HashGroupByTranslator::CollectHashKeys(
@@ -387,6 +532,57 @@ void HashGroupByTranslator::ProduceResults::ProcessEntries(
   }
 }
 
+//===----------------------------------------------------------------------===//
+// MERGE GROUPS
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::MergeGroups::MergeGroups(
+    const HashGroupByTranslator &translator, llvm::Value *hash_table)
+    : translator_(translator), hash_table_(hash_table) {}
+
+// Merge the group with the given keys and aggregates into the hash table
+void HashGroupByTranslator::MergeGroups::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &keys,
+    llvm::Value *data_area) const {
+  const auto &aggregation = translator_.GetAggregation();
+  MergeProbe probe{aggregation, data_area};
+  MergeInsert insert{aggregation, data_area};
+  translator_.hash_table_.ProbeOrInsert(codegen, hash_table_, nullptr, keys,
+                                        probe, insert);
+}
+
+//===----------------------------------------------------------------------===//
+// MERGE PROBE
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::MergeProbe::MergeProbe(const Aggregation &aggregation,
+                                              llvm::Value *other_data_area)
+    : aggregation_(aggregation), other_data_area_(other_data_area) {}
+
+void HashGroupByTranslator::MergeProbe::ProcessEntry(
+    CodeGen &codegen, llvm::Value *data_area) const {
+  aggregation_.MergeValues(codegen, data_area, other_data_area_);
+}
+
+//===----------------------------------------------------------------------===//
+// MERGE INSERT
+//===----------------------------------------------------------------------===//
+
+HashGroupByTranslator::MergeInsert::MergeInsert(const Aggregation &aggregation,
+                                                llvm::Value *other_data_area)
+    : aggregation_(aggregation), other_data_area_(other_data_area) {}
+
+void HashGroupByTranslator::MergeInsert::StoreValue(CodeGen &codegen,
+                                                    llvm::Value *space) const {
+  codegen->CreateMemCpy(space, other_data_area_,
+                        aggregation_.GetAggregatesStorageSize(), 1);
+}
+
+llvm::Value *HashGroupByTranslator::MergeInsert::GetValueSize(
+    CodeGen &codegen) const {
+  return codegen.Const32(aggregation_.GetAggregatesStorageSize());
+}
+
 //===----------------------------------------------------------------------===//
 // CONSUMER PROBE
 //===----------------------------------------------------------------------===//
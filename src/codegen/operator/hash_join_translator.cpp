@@ -12,7 +12,12 @@
 
 #include "codegen/operator/hash_join_translator.h"
 
+#include <algorithm>
+#include <unordered_set>
+
+#include "codegen/proxy/bloom_filter_proxy.h"
 #include "codegen/proxy/oa_hash_table_proxy.h"
+#include "codegen/proxy/partitioned_buffer_proxy.h"
 #include "codegen/expression/tuple_value_translator.h"
 #include "codegen/lang/vectorized_loop.h"
 #include "expression/tuple_value_expression.h"
@@ -23,6 +28,24 @@ namespace codegen {
 
 std::atomic<bool> HashJoinTranslator::kUsePrefetch{false};
 
+std::atomic<bool> HashJoinTranslator::kUseBloomFilter{true};
+
+namespace {
+
+// Joins whose hash table is estimated to be at least this large (roughly the
+// size of the last level cache) are radix-partitioned
+constexpr uint64_t kRadixPartitioningThreshold = 4 * 1024 * 1024;
+
+// The size the hash table of a single partition is aimed at (roughly the size
+// of the L2 cache)
+constexpr uint64_t kRadixPartitionSize = 256 * 1024;
+
+// The largest number of hash bits partitions are taken from, more partitions
+// than this thrash the TLB while partitioning
+constexpr uint32_t kMaxRadixBits = 10;
+
+}  // namespace
+
 //===----------------------------------------------------------------------===//
 // HASH JOIN TRANSLATOR
 //===----------------------------------------------------------------------===//
@@ -31,34 +54,15 @@ std::atomic<bool> HashJoinTranslator::kUsePrefetch{false};
 HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
                                        CompilationContext &context,
                                        Pipeline &pipeline)
-    : OperatorTranslator(context, pipeline), join_(join), left_pipeline_(this) {
+    : OperatorTranslator(context, pipeline),
+      join_(join),
+      left_pipeline_(this),
+      right_pipeline_(this) {
   LOG_DEBUG("Constructing HashJoinTranslator ...");
 
   auto &codegen = GetCodeGen();
   auto &runtime_state = context.GetRuntimeState();
 
-  // If we should be prefetching into the hash-table, install a boundary in the
-  // both the left and right pipeline at the input into this translator to
-  // ensure it receives a vector of input tuples
-  if (UsePrefetching()) {
-    left_pipeline_.InstallBoundaryAtInput(this);
-    pipeline.InstallBoundaryAtInput(this);
-
-    // Allocate slot for prefetch array
-    prefetch_vector_id_ = runtime_state.RegisterState(
-        "hjPFVec", codegen.VectorType(codegen.Int64Type(),
-                                      OAHashTable::kDefaultGroupPrefetchSize),
-        true);
-  }
-
-  // Allocate state for our hash table
-  hash_table_id_ =
-      runtime_state.RegisterState("join", OAHashTableProxy::GetType(codegen));
-
-  // Prepare translators for the left and right input operators
-  context.Prepare(*join_.GetChild(0), left_pipeline_);
-  context.Prepare(*join_.GetChild(1)->GetChild(0), pipeline);
-
   // Prepare the expressions that produce the build-size keys
   join.GetLeftHashKeys(left_key_exprs_);
 
@@ -83,12 +87,6 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
     right_key_type.push_back(right_key->ResultType());
   }
 
-  // Prepare the predicate
-  auto *predicate = join_.GetPredicate();
-  if (predicate != nullptr) {
-    context.Prepare(*predicate);
-  }
-
   // Make sure the key types are equal
   PL_ASSERT(left_key_type.size() == right_key_type.size());
   PL_ASSERT(std::equal(left_key_type.begin(), left_key_type.end(),
@@ -129,11 +127,121 @@ HashJoinTranslator::HashJoinTranslator(const planner::HashJoinPlan &join,
   hash_table_ =
       OAHashTable{codegen, left_key_type, left_value_storage_.MaxStorageSize()};
 
+  // Decide whether both sides are partitioned first, now that we know the
+  // size of the entries in the hash table
+  radix_bits_ = 0;
+  uint64_t hash_table_size = EstimateHashTableSize();
+  if (join_.GetJoinType() == JoinType::INNER &&
+      hash_table_size >= kRadixPartitioningThreshold) {
+    while ((hash_table_size >> radix_bits_) > kRadixPartitionSize &&
+           radix_bits_ < kMaxRadixBits) {
+      radix_bits_++;
+    }
+  }
+
+  // If we should be prefetching into the hash-table, install a boundary in the
+  // both the left and right pipeline at the input into this translator to
+  // ensure it receives a vector of input tuples
+  if (UsePrefetching()) {
+    left_pipeline_.InstallBoundaryAtInput(this);
+    pipeline.InstallBoundaryAtInput(this);
+
+    // Allocate slot for prefetch array
+    prefetch_vector_id_ = runtime_state.RegisterState(
+        "hjPFVec", codegen.VectorType(codegen.Int64Type(),
+                                      OAHashTable::kDefaultGroupPrefetchSize),
+        true);
+  }
+
+  // Allocate state for our hash table
+  hash_table_id_ =
+      runtime_state.RegisterState("join", OAHashTableProxy::GetType(codegen));
+
+  // The Bloom filter is sized for the estimated build side, so it is only
+  // used when there is an estimate
+  use_bloom_filter_ = kUseBloomFilter &&
+                      join_.GetJoinType() == JoinType::INNER &&
+                      join_.GetBuildCardinality() > 0;
+  if (UseBloomFilter()) {
+    bloom_filter_id_ = runtime_state.RegisterState(
+        "hjBloomFilter", BloomFilterProxy::GetType(codegen));
+  }
+
+  if (UseRadixPartitioning()) {
+    // Both sides are buffered into partitions, the threads of a parallel
+    // child pipeline buffer into their own partitions
+    context.Prepare(*join_.GetChild(0), left_pipeline_);
+    context.Prepare(*join_.GetChild(1)->GetChild(0), right_pipeline_);
+    left_pipeline_.MakeParallel();
+    right_pipeline_.MakeParallel();
+
+    left_partitions_id_ = runtime_state.RegisterState(
+        "hjLeftParts", PartitionedBufferProxy::GetType(codegen));
+    right_partitions_id_ = runtime_state.RegisterState(
+        "hjRightParts", PartitionedBufferProxy::GetType(codegen));
+    radix_output_vector_id_ = runtime_state.RegisterState(
+        "hjRadixSelVec", codegen.VectorType(codegen.Int32Type(), 1), true);
+  } else {
+    // Prepare translators for the left and right input operators
+    context.Prepare(*join_.GetChild(0), left_pipeline_);
+    context.Prepare(*join_.GetChild(1)->GetChild(0), pipeline);
+  }
+
+  // Prepare the predicate
+  auto *predicate = join_.GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+
+  if (UseRadixPartitioning()) {
+    // The left partitions hold the keys and values of the hash table
+    std::vector<type::Type> left_buffer_types = left_key_type;
+    left_buffer_types.insert(left_buffer_types.end(), left_value_types.begin(),
+                             left_value_types.end());
+    left_buffer_ = PartitionedBuffer{codegen, left_buffer_types};
+
+    // The right partitions hold the keys, and every right-side attribute the
+    // predicate or the parent reads
+    std::unordered_set<const planner::AttributeInfo *> right_ais{
+        join.GetRightAttributes().begin(), join.GetRightAttributes().end()};
+    right_ais_ = join.GetRightAttributes();
+    if (predicate != nullptr) {
+      std::unordered_set<const planner::AttributeInfo *> predicate_ais;
+      predicate->GetUsedAttributes(predicate_ais);
+      const auto &left_ais = join.GetLeftAttributes();
+      for (const auto *ai : predicate_ais) {
+        bool from_left = left_key_ais.count(ai) != 0 ||
+                         std::find(left_ais.begin(), left_ais.end(), ai) !=
+                             left_ais.end();
+        if (!from_left && right_ais.insert(ai).second) {
+          right_ais_.push_back(ai);
+        }
+      }
+    }
+    std::vector<type::Type> right_buffer_types = right_key_type;
+    for (const auto *right_ai : right_ais_) {
+      right_buffer_types.push_back(right_ai->type);
+    }
+    right_buffer_ = PartitionedBuffer{codegen, right_buffer_types};
+  }
+
   LOG_DEBUG("Finished constructing HashJoinTranslator ...");
 }
 
-// Initialize the hash-table instance
+// Initialize the hash-table instance, or the partitions of both sides
 void HashJoinTranslator::InitializeState() {
+  if (UseBloomFilter()) {
+    bloom_filter_.Init(GetCodeGen(), LoadStatePtr(bloom_filter_id_),
+                       join_.GetBuildCardinality());
+  }
+  if (UseRadixPartitioning()) {
+    uint32_t num_partitions = 1u << radix_bits_;
+    left_buffer_.Init(GetCodeGen(), LoadStatePtr(left_partitions_id_),
+                      num_partitions);
+    right_buffer_.Init(GetCodeGen(), LoadStatePtr(right_partitions_id_),
+                       num_partitions);
+    return;
+  }
   hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
 }
 
@@ -145,9 +253,47 @@ void HashJoinTranslator::Produce() const {
   // Let the right child produce tuples, which we use to probe the hash table
   GetCompilationContext().Produce(*join_.GetChild(1)->GetChild(0));
 
+  // If both sides were only partitioned, the join happens now
+  if (UseRadixPartitioning()) {
+    JoinPartitions();
+  }
+
   // That's it, we've produced all the tuples
 }
 
+// Build a hash table from every left partition and probe it with the matching
+// right partition. The hash table of a partition fits in the cache.
+void HashJoinTranslator::JoinPartitions() const {
+  auto &codegen = GetCodeGen();
+  llvm::Value *num_partitions = codegen.Const32(1u << radix_bits_);
+
+  llvm::Value *partition = codegen.Const32(0);
+  lang::Loop partition_loop{codegen,
+                            codegen->CreateICmpULT(partition, num_partitions),
+                            {{"partition", partition}}};
+  {
+    partition = partition_loop.GetLoopVar(0);
+
+    llvm::Value *hash_table = LoadStatePtr(hash_table_id_);
+    hash_table_.Init(codegen, hash_table);
+
+    BuildPartition build_partition{*this};
+    left_buffer_.IteratePartition(codegen, LoadStatePtr(left_partitions_id_),
+                                  partition, build_partition);
+
+    ProbePartition probe_partition{*this};
+    right_buffer_.IteratePartition(codegen,
+                                   LoadStatePtr(right_partitions_id_),
+                                   partition, probe_partition);
+
+    hash_table_.Destroy(codegen, hash_table);
+
+    partition = codegen->CreateAdd(partition, codegen.Const32(1));
+    partition_loop.LoopEnd(codegen->CreateICmpULT(partition, num_partitions),
+                           {partition});
+  }
+}
+
 void HashJoinTranslator::Consume(ConsumerContext &context,
                                  RowBatch &batch) const {
   if (!UsePrefetching()) {
@@ -164,45 +310,32 @@ void HashJoinTranslator::Consume(ConsumerContext &context,
   Vector hashes{LoadStateValue(prefetch_vector_id_),
                 OAHashTable::kDefaultGroupPrefetchSize, codegen.Int64Type()};
 
+  const bool from_left = IsFromLeftChild(context);
+  const auto pf_type = from_left ? OAHashTable::PrefetchType::Write
+                                 : OAHashTable::PrefetchType::Read;
+
   auto group_prefetch = [&](
       RowBatch::VectorizedIterateCallback::IterationInstance &iter_instance) {
     llvm::Value *p = codegen.Const32(0);
     llvm::Value *end =
         codegen->CreateSub(iter_instance.end, iter_instance.start);
 
-    // The first loop does hash computation and prefetching
-    lang::Loop prefetch_loop{
-        codegen, codegen->CreateICmpULT(p, end), {{"p", p}}};
-    {
-      p = prefetch_loop.GetLoopVar(0);
+    // The first loop does hash computation and prefetching, the build side
+    // writes into the buckets
+    auto collect_key = [&](llvm::Value *row_idx,
+                           std::vector<codegen::Value> &key) {
       RowBatch::Row row =
-          batch.GetRowAt(codegen->CreateAdd(p, iter_instance.start));
-
-      // Collect keys
-      std::vector<codegen::Value> key;
-      if (IsFromLeftChild(context)) {
+          batch.GetRowAt(codegen->CreateAdd(row_idx, iter_instance.start));
+      if (from_left) {
         CollectKeys(row, left_key_exprs_, key);
       } else {
         CollectKeys(row, right_key_exprs_, key);
       }
+    };
+    hash_table_.HashAndPrefetch(codegen, LoadStatePtr(hash_table_id_), end,
+                                hashes, collect_key, pf_type,
+                                OAHashTable::Locality::Medium);
 
-      // Hash the key and store in prefetch vector
-      llvm::Value *hash_val = hash_table_.HashKey(codegen, key);
-
-      // StoreValue hashed val in prefetch vector
-      hashes.SetValue(codegen, p, hash_val);
-
-      // Prefetch the actual hash table bucket
-      hash_table_.PrefetchBucket(codegen, LoadStatePtr(hash_table_id_),
-                                 hash_val, OAHashTable::PrefetchType::Read,
-                                 OAHashTable::Locality::Medium);
-
-      // End prefetch loop
-      p = codegen->CreateAdd(p, codegen.Const32(1));
-      prefetch_loop.LoopEnd(codegen->CreateICmpULT(p, end), {p});
-    }
-
-    p = codegen.Const32(0);
     std::vector<lang::Loop::LoopVariable> loop_vars = {
         {"p", p}, {"writeIdx", iter_instance.write_pos}};
     lang::Loop process_loop{codegen, codegen->CreateICmpULT(p, end), loop_vars};
@@ -259,11 +392,23 @@ void HashJoinTranslator::ConsumeFromLeft(ConsumerContext &,
   std::vector<codegen::Value> vals;
   CollectValues(row, left_val_ais_, vals);
 
-  // If the hash value is available, use it
-  llvm::Value *hash = nullptr;
-  if (row.HasAttribute(&OAHashTable::kHashAI)) {
-    codegen::Value hash_val = row.DeriveValue(codegen, &OAHashTable::kHashAI);
-    hash = hash_val.GetValue();
+  // The hash of the key is computed once for everything it is needed for
+  llvm::Value *hash = GetKeyHash(codegen, row, key);
+
+  // Add the key to the Bloom filter. Other threads add to it at the same time
+  // if the build side runs in parallel.
+  if (UseBloomFilter()) {
+    bloom_filter_.Add(codegen, LoadStatePtr(bloom_filter_id_), hash,
+                      left_pipeline_.IsParallel());
+  }
+
+  // Buffer the tuple into its partition, if the join is partitioned
+  if (UseRadixPartitioning()) {
+    std::vector<codegen::Value> tuple = key;
+    tuple.insert(tuple.end(), vals.begin(), vals.end());
+    left_buffer_.Append(codegen, LoadStatePtr(left_partitions_id_),
+                        GetPartition(codegen, hash), tuple);
+    return;
   }
 
   // Insert tuples from the left side into the hash table
@@ -275,26 +420,213 @@ void HashJoinTranslator::ConsumeFromLeft(ConsumerContext &,
 // The given row is from the right child. Probe hash-table.
 void HashJoinTranslator::ConsumeFromRight(ConsumerContext &context,
                                           RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
   // Pull out the values of the keys we probe the hash-table with
   std::vector<codegen::Value> key;
   CollectKeys(row, right_key_exprs_, key);
 
+  llvm::Value *hash = GetKeyHash(codegen, row, key);
+
+  // Drop the tuple right away if no build-side tuple of this join, or of the
+  // joins above it in the chain, can match it
+  std::vector<const HashJoinTranslator *> filter_joins;
+  GetFilterJoins(filter_joins);
+  ProbeWithFilters(context, row, hash, key, filter_joins, 0);
+}
+
+void HashJoinTranslator::ProbeWithFilters(
+    ConsumerContext &context, RowBatch::Row &row, llvm::Value *hash,
+    const std::vector<codegen::Value> &key,
+    const std::vector<const HashJoinTranslator *> &filter_joins,
+    uint32_t filter_idx) const {
+  if (filter_idx == filter_joins.size()) {
+    ProbeWithKey(context, row, hash, key);
+    return;
+  }
+
+  // The hash of the key of another join is only computed if the filters
+  // before it could not rule out the row
+  auto &codegen = GetCodeGen();
+  const auto *join = filter_joins[filter_idx];
+  llvm::Value *join_hash = hash;
+  if (join != this) {
+    std::vector<codegen::Value> join_key;
+    join->CollectKeys(row, join->right_key_exprs_, join_key);
+    join_hash = join->hash_table_.HashKey(codegen, join_key);
+  }
+
+  lang::If may_match{
+      codegen, join->bloom_filter_.Contains(
+                   codegen, join->LoadStatePtr(join->bloom_filter_id_),
+                   join_hash)};
+  {
+    ProbeWithFilters(context, row, hash, key, filter_joins, filter_idx + 1);
+  }
+  may_match.EndIf();
+}
+
+// A join checks its own Bloom filter, unless it is part of a chain. The lowest
+// join of a chain checks the filters of the joins above it whose probe keys
+// only read attributes the chain does not add below them. They are ordered by
+// their estimated build sides, so that the join expected to drop the most
+// tuples is checked first. The estimates ignore predicates, so they only rank
+// the joins roughly.
+void HashJoinTranslator::GetFilterJoins(
+    std::vector<const HashJoinTranslator *> &filter_joins) const {
+  filter_joins.clear();
+  if (!UseBloomFilter()) {
+    return;
+  }
+  if (!CanChainBloomFilter()) {
+    filter_joins.push_back(this);
+    return;
+  }
+
+  const HashJoinTranslator *lowest = this;
+  while (const auto *below = lowest->GetChainedJoin(false)) {
+    lowest = below;
+  }
+
+  filter_joins.push_back(lowest);
+  std::unordered_set<const planner::AttributeInfo *> added_ais;
+  for (const auto *join = lowest; join != nullptr;) {
+    // The attributes the join adds to the rows it produces
+    const auto &left_ais = join->GetJoinPlan().GetLeftAttributes();
+    added_ais.insert(left_ais.begin(), left_ais.end());
+    for (const auto *left_key : join->left_key_exprs_) {
+      left_key->GetUsedAttributes(added_ais);
+    }
+
+    join = join->GetChainedJoin(true);
+    if (join == nullptr) {
+      break;
+    }
+
+    std::unordered_set<const planner::AttributeInfo *> key_ais;
+    for (const auto *right_key : join->right_key_exprs_) {
+      right_key->GetUsedAttributes(key_ais);
+    }
+    bool computable = std::none_of(
+        key_ais.begin(), key_ais.end(),
+        [&added_ais](const planner::AttributeInfo *ai) {
+          return added_ais.count(ai) != 0;
+        });
+    if (computable) {
+      filter_joins.push_back(join);
+    } else if (join == this) {
+      // The lowest join can't check the filter of this join
+      filter_joins.clear();
+      filter_joins.push_back(this);
+      return;
+    }
+  }
+
+  // The filter of this join is checked below it
+  if (lowest != this) {
+    filter_joins.clear();
+    return;
+  }
+
+  auto by_build_size = [](const HashJoinTranslator *a,
+                          const HashJoinTranslator *b) {
+    return a->GetJoinPlan().GetBuildCardinality() <
+           b->GetJoinPlan().GetBuildCardinality();
+  };
+  std::stable_sort(filter_joins.begin(), filter_joins.end(), by_build_size);
+}
+
+const HashJoinTranslator *HashJoinTranslator::GetChainedJoin(
+    bool above) const {
+  const auto &pipeline = GetPipeline();
+  const auto *translator =
+      above ? pipeline.GetParentOf(this) : pipeline.GetChildOf(this);
+  const auto *join = dynamic_cast<const HashJoinTranslator *>(translator);
+  if (join == nullptr || !join->CanChainBloomFilter() ||
+      pipeline.GetTranslatorStage(join) != pipeline.GetTranslatorStage(this)) {
+    return nullptr;
+  }
+  return join;
+}
+
+// Probe the hash table with the given key of the given right-side row, or
+// buffer the row into its partition if the join is partitioned
+void HashJoinTranslator::ProbeWithKey(
+    ConsumerContext &context, RowBatch::Row &row, llvm::Value *hash,
+    const std::vector<codegen::Value> &key) const {
+  auto &codegen = GetCodeGen();
+
+  // Buffer the tuple into its partition, if the join is partitioned
+  if (UseRadixPartitioning()) {
+    std::vector<codegen::Value> tuple = key;
+    CollectValues(row, right_ais_, tuple);
+    right_buffer_.Append(codegen, LoadStatePtr(right_partitions_id_),
+                         GetPartition(codegen, hash), tuple);
+    return;
+  }
+
   const auto &join_plan = GetJoinPlan();
 
   // Check the join type
   if (join_plan.GetJoinType() == JoinType::INNER) {
     // For inner joins, find all join partners
     ProbeRight probe_right{*this, context, row, key};
-    hash_table_.FindAll(GetCodeGen(), LoadStatePtr(hash_table_id_), key,
+    hash_table_.FindAll(codegen, LoadStatePtr(hash_table_id_), hash, key,
                         probe_right);
   }
 }
 
-// Cleanup by destroying the hash-table instance
+// Get the hash of the given key of the given row. If the row was prefetched,
+// the hash is available already. Otherwise, it is only computed here if more
+// than the hash table need it.
+llvm::Value *HashJoinTranslator::GetKeyHash(
+    CodeGen &codegen, RowBatch::Row &row,
+    const std::vector<codegen::Value> &key) const {
+  if (row.HasAttribute(&OAHashTable::kHashAI)) {
+    return row.DeriveValue(codegen, &OAHashTable::kHashAI).GetValue();
+  }
+  if (UseBloomFilter() || UseRadixPartitioning()) {
+    return hash_table_.HashKey(codegen, key);
+  }
+  return nullptr;
+}
+
+// Cleanup by destroying the hash-table instance, or the partitions
 void HashJoinTranslator::TearDownState() {
+  if (UseBloomFilter()) {
+    bloom_filter_.Destroy(GetCodeGen(), LoadStatePtr(bloom_filter_id_));
+  }
+  if (UseRadixPartitioning()) {
+    left_buffer_.Destroy(GetCodeGen(), LoadStatePtr(left_partitions_id_));
+    right_buffer_.Destroy(GetCodeGen(), LoadStatePtr(right_partitions_id_));
+    return;
+  }
   hash_table_.Destroy(GetCodeGen(), LoadStatePtr(hash_table_id_));
 }
 
+// The state of a thread is a copy of the runtime state, the partitions both
+// sides of the join are buffered into are set up from scratch
+void HashJoinTranslator::InitializeThreadState() const {
+  uint32_t num_partitions = 1u << radix_bits_;
+  left_buffer_.Init(GetCodeGen(), LoadStatePtr(left_partitions_id_),
+                    num_partitions);
+  right_buffer_.Init(GetCodeGen(), LoadStatePtr(right_partitions_id_),
+                     num_partitions);
+}
+
+// Move the partitions of a thread into the partitions of the query. The
+// partitions of the side the thread did not consume are empty.
+void HashJoinTranslator::MergeThreadState(llvm::Value *thread_state) const {
+  auto &codegen = GetCodeGen();
+  auto &runtime_state = GetCompilationContext().GetRuntimeState();
+  left_buffer_.TransferFrom(
+      codegen, LoadStatePtr(left_partitions_id_),
+      runtime_state.LoadStatePtr(codegen, left_partitions_id_, thread_state));
+  right_buffer_.TransferFrom(
+      codegen, LoadStatePtr(right_partitions_id_),
+      runtime_state.LoadStatePtr(codegen, right_partitions_id_, thread_state));
+}
+
 // Get the stringified name of this join
 std::string HashJoinTranslator::GetName() const {
   std::string name = "HashJoin::";
@@ -322,19 +654,36 @@ std::string HashJoinTranslator::GetName() const {
     case JoinType::INVALID:
       throw Exception{"Invalid join type"};
   }
+  if (UseRadixPartitioning()) {
+    name.append("(Radix ").append(std::to_string(radix_bits_)).append(")");
+  }
   return name;
 }
 
-// Estimate the size of the dynamically constructed hash-table
+// Estimate the size of the dynamically constructed hash-table from the
+// cardinality the optimizer estimated for the build side
 uint64_t HashJoinTranslator::EstimateHashTableSize() const {
-  // TODO: Implement me
-  return 0;
+  return join_.GetBuildCardinality() * hash_table_.HashEntrySize();
 }
 
-// Should this aggregation use prefetching
+// Should this join use prefetching? Hash tables that do not fit in the L2
+// cache miss on most probes, prefetching overlaps the misses of a group of
+// probes. Partitioned joins probe hash tables that fit in the cache.
 bool HashJoinTranslator::UsePrefetching() const {
-  // TODO: Implement me
-  return kUsePrefetch;
+  if (UseRadixPartitioning()) {
+    return false;
+  }
+  return kUsePrefetch ||
+         EstimateHashTableSize() >= OAHashTable::kPrefetchThreshold;
+}
+
+// The partition is taken from the high bits of the hash, the hash table uses
+// the low bits to find the bucket
+llvm::Value *HashJoinTranslator::GetPartition(CodeGen &codegen,
+                                              llvm::Value *hash) const {
+  llvm::Value *partition =
+      codegen->CreateLShr(hash, codegen.Const64(64 - radix_bits_));
+  return codegen->CreateTrunc(partition, codegen.Int32Type());
 }
 
 void HashJoinTranslator::CollectKeys(
@@ -418,6 +767,59 @@ void HashJoinTranslator::ProbeRight::ProcessEntry(
   }
 }
 
+//===----------------------------------------------------------------------===//
+// BUILD PARTITION
+//===----------------------------------------------------------------------===//
+
+// The buffered tuple holds the key of the hash table followed by the values
+void HashJoinTranslator::BuildPartition::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &vals) const {
+  auto num_keys = join_translator_.left_key_exprs_.size();
+  std::vector<codegen::Value> key{vals.begin(), vals.begin() + num_keys};
+  std::vector<codegen::Value> left_vals{vals.begin() + num_keys, vals.end()};
+
+  InsertLeft insert_left{join_translator_.left_value_storage_, left_vals};
+  join_translator_.hash_table_.Insert(
+      codegen, join_translator_.LoadStatePtr(join_translator_.hash_table_id_),
+      nullptr, key, insert_left);
+}
+
+//===----------------------------------------------------------------------===//
+// PROBE PARTITION
+//===----------------------------------------------------------------------===//
+
+// The buffered tuple holds the key followed by the right-side attributes,
+// which are placed into a row of a one-row batch that probes the hash table
+void HashJoinTranslator::ProbePartition::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &vals) const {
+  auto num_keys = join_translator_.right_key_exprs_.size();
+  std::vector<codegen::Value> key{vals.begin(), vals.begin() + num_keys};
+
+  const auto &right_ais = join_translator_.right_ais_;
+  std::vector<BufferedAttributeAccess> accessors;
+  for (uint32_t i = 0; i < right_ais.size(); i++) {
+    accessors.emplace_back(vals, num_keys + i);
+  }
+
+  Vector v{join_translator_.LoadStateValue(
+               join_translator_.radix_output_vector_id_),
+           1, codegen.Int32Type()};
+  RowBatch batch{join_translator_.GetCompilationContext(), codegen.Const32(0),
+                 codegen.Const32(1), v, false};
+  for (uint32_t i = 0; i < right_ais.size(); i++) {
+    batch.AddAttribute(right_ais[i], &accessors[i]);
+  }
+
+  ConsumerContext context{join_translator_.GetCompilationContext(),
+                          join_translator_.GetPipeline()};
+  RowBatch::Row row = batch.GetRowAt(codegen.Const32(0));
+
+  ProbeRight probe_right{join_translator_, context, row, key};
+  join_translator_.hash_table_.FindAll(
+      codegen, join_translator_.LoadStatePtr(join_translator_.hash_table_id_),
+      nullptr, key, probe_right);
+}
+
 //===----------------------------------------------------------------------===//
 // INSERT LEFT
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,267 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_translator.cpp
+//
+// Identification: src/codegen/operator/index_scan_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/index_scan_translator.h"
+
+#include <unordered_set>
+
+#include "codegen/lang/loop.h"
+#include "codegen/proxy/index_scanner_proxy.h"
+#include "codegen/proxy/runtime_functions_proxy.h"
+#include "codegen/type/boolean_type.h"
+#include "codegen/vector.h"
+#include "planner/index_scan_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// INDEX SCAN TRANSLATOR
+//===----------------------------------------------------------------------===//
+
+// Constructor
+IndexScanTranslator::IndexScanTranslator(const planner::IndexScanPlan &scan,
+                                         CompilationContext &context,
+                                         Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline),
+      scan_(scan),
+      tile_group_(*scan_.GetTable()->GetSchema()) {
+  LOG_DEBUG("Constructing IndexScanTranslator ...");
+
+  // If there is a predicate, prepare a translator for it
+  const auto *predicate = GetScanPlan().GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+
+  // Register the index scanner
+  index_scanner_id_ = context.GetRuntimeState().RegisterState(
+      "indexScanner", IndexScannerProxy::GetType(GetCodeGen()));
+
+  LOG_DEBUG("Finished constructing IndexScanTranslator ...");
+}
+
+void IndexScanTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+  auto &compilation_context = GetCompilationContext();
+
+  // Call IndexScanner::Init(plan, executor_context)
+  llvm::Value *index_scanner = LoadStatePtr(index_scanner_id_);
+  codegen.CallFunc(IndexScannerProxy::_Init::GetFunction(codegen),
+                   {index_scanner, compilation_context.GetPlanPtr(scan_),
+                    compilation_context.GetExecutorContextPtr()});
+}
+
+// Probe the index, then scan the TIDs it found in every tile group.
+//
+// @code
+// num_tile_groups := index_scanner.Scan()
+//
+// for (tile_group_idx := 0; tile_group_idx < num_tile_groups; ++idx) {
+//   tile_group_ptr := index_scanner.GetTileGroup(tile_group_idx)
+//   tids := index_scanner.GetTids(tile_group_idx)
+//   tile_group.TidListScan(tile_group_ptr, column_layouts,
+//                          index_scanner.GetTidCount(tile_group_idx), ...)
+// }
+// @endcode
+void IndexScanTranslator::Produce() const {
+  auto &codegen = GetCodeGen();
+  auto &table = GetTable();
+
+  LOG_DEBUG("IndexScan on [%u] starting to produce tuples ...",
+            table.GetOid());
+
+  llvm::Value *index_scanner = LoadStatePtr(index_scanner_id_);
+  llvm::Value *num_tile_groups = codegen.CallFunc(
+      IndexScannerProxy::_Scan::GetFunction(codegen), {index_scanner});
+
+  const uint32_t num_columns =
+      static_cast<uint32_t>(table.GetSchema()->GetColumnCount());
+  llvm::Value *column_layouts = codegen->CreateAlloca(
+      RuntimeFunctionsProxy::_ColumnLayoutInfo::GetType(codegen),
+      codegen.Const32(num_columns));
+
+  llvm::Value *tile_group_idx = codegen.Const32(0);
+  lang::Loop loop{codegen,
+                  codegen->CreateICmpULT(tile_group_idx, num_tile_groups),
+                  {{"tileGroupIdx", tile_group_idx}}};
+  {
+    tile_group_idx = loop.GetLoopVar(0);
+    llvm::Value *tile_group_ptr = codegen.CallFunc(
+        IndexScannerProxy::_GetTileGroup::GetFunction(codegen),
+        {index_scanner, tile_group_idx});
+    llvm::Value *tids = codegen.CallFunc(
+        IndexScannerProxy::_GetTids::GetFunction(codegen),
+        {index_scanner, tile_group_idx});
+    llvm::Value *num_tids = codegen.CallFunc(
+        IndexScannerProxy::_GetTidCount::GetFunction(codegen),
+        {index_scanner, tile_group_idx});
+
+    ScanConsumer scan_consumer{*this, tids};
+    scan_consumer.TileGroupStart(
+        codegen, tile_group_.GetTileGroupId(codegen, tile_group_ptr),
+        tile_group_ptr);
+    tile_group_.GenerateTidListScan(
+        codegen, tile_group_ptr, column_layouts, num_tids,
+        Vector::kDefaultVectorSize, scan_consumer,
+        GetCompilationContext().GetExecutorContextPtr());
+    scan_consumer.TileGroupFinish(codegen, tile_group_ptr);
+
+    tile_group_idx = codegen->CreateAdd(tile_group_idx, codegen.Const32(1));
+    llvm::Value *more_tile_groups =
+        codegen->CreateICmpULT(tile_group_idx, num_tile_groups);
+    llvm::Value *finished = scan_consumer.IsFinished(codegen);
+    if (finished != nullptr) {
+      more_tile_groups = codegen->CreateAnd(more_tile_groups,
+                                            codegen->CreateNot(finished));
+    }
+    loop.LoopEnd(more_tile_groups, {tile_group_idx});
+  }
+
+  LOG_DEBUG("IndexScan on [%u] finished producing tuples ...",
+            table.GetOid());
+}
+
+void IndexScanTranslator::TearDownState() {
+  auto &codegen = GetCodeGen();
+  llvm::Value *index_scanner = LoadStatePtr(index_scanner_id_);
+  codegen.CallFunc(IndexScannerProxy::_Destroy::GetFunction(codegen),
+                   {index_scanner});
+}
+
+// Get the stringified name of this scan
+std::string IndexScanTranslator::GetName() const {
+  return "IndexScan('" + GetTable().GetName() + "')";
+}
+
+// Table accessor
+const storage::DataTable &IndexScanTranslator::GetTable() const {
+  return *scan_.GetTable();
+}
+
+//===----------------------------------------------------------------------===//
+// SCAN CONSUMER
+//===----------------------------------------------------------------------===//
+
+// Constructor
+IndexScanTranslator::ScanConsumer::ScanConsumer(
+    const IndexScanTranslator &translator, llvm::Value *tids)
+    : translator_(translator), tids_(tids), tile_group_id_(nullptr) {}
+
+// Generate the body of the scan over the positions [start, end) in the list
+// of TIDs. The TIDs were checked for visibility by the index scanner, so the
+// slice of the list is the selection vector of the batch.
+void IndexScanTranslator::ScanConsumer::ProcessTuples(
+    CodeGen &codegen, llvm::Value *start, llvm::Value *end,
+    TileGroup::TileGroupAccess &tile_group_access) {
+  // 1. Setup the batch over the TIDs in the range
+  Vector selection_vector{
+      codegen->CreateInBoundsGEP(codegen.Int32Type(), tids_, start),
+      Vector::kDefaultVectorSize, codegen.Int32Type()};
+  llvm::Value *num_tids = codegen->CreateSub(end, start);
+  selection_vector.SetNumElements(num_tids);
+
+
+  // 2. Filter rows by the predicate of the scan (if one exists)
+  if (translator_.GetScanPlan().GetPredicate() != nullptr) {
+    FilterRowsByPredicate(codegen, tile_group_access, num_tids,
+                          selection_vector);
+  }
+
+  // 3. Setup the (filtered) row batch and setup attribute accessors
+  RowBatch batch{translator_.GetCompilationContext(), tile_group_id_,
+                 codegen.Const32(0), num_tids, selection_vector, true};
+
+  std::vector<IndexScanTranslator::AttributeAccess> attribute_accesses;
+  SetupRowBatch(batch, tile_group_access, attribute_accesses);
+
+  // 4. Push the batch into the pipeline
+  ConsumerContext context{translator_.GetCompilationContext(),
+                          translator_.GetPipeline()};
+  context.Consume(batch);
+}
+
+void IndexScanTranslator::ScanConsumer::SetupRowBatch(
+    RowBatch &batch, TileGroup::TileGroupAccess &tile_group_access,
+    std::vector<IndexScanTranslator::AttributeAccess> &access) const {
+  // The attributes were bound to the column IDs of the base scan
+  const auto &scan_plan = translator_.GetScanPlan();
+  std::vector<const planner::AttributeInfo *> ais;
+  scan_plan.GetAttributes(ais);
+  const auto &output_col_ids =
+      static_cast<const planner::AbstractScan &>(scan_plan).GetColumnIds();
+
+  // 1. Put all the attribute accessors into a vector
+  access.clear();
+  for (oid_t col_idx = 0; col_idx < output_col_ids.size(); col_idx++) {
+    access.emplace_back(tile_group_access, ais[output_col_ids[col_idx]]);
+  }
+
+  // 2. Add the attribute accessors into the row batch
+  for (oid_t col_idx = 0; col_idx < output_col_ids.size(); col_idx++) {
+    batch.AddAttribute(ais[output_col_ids[col_idx]], &access[col_idx]);
+  }
+}
+
+void IndexScanTranslator::ScanConsumer::FilterRowsByPredicate(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *num_tids, Vector &selection_vector) const {
+  // The batch we're filtering
+  RowBatch batch{translator_.GetCompilationContext(), tile_group_id_,
+                 codegen.Const32(0), num_tids, selection_vector, true};
+
+  const auto *predicate = translator_.GetScanPlan().GetPredicate();
+
+  // Setup the row batch with attribute accessors for the predicate
+  std::unordered_set<const planner::AttributeInfo *> used_attributes;
+  predicate->GetUsedAttributes(used_attributes);
+
+  std::vector<AttributeAccess> attribute_accessors;
+  for (const auto *ai : used_attributes) {
+    attribute_accessors.emplace_back(access, ai);
+  }
+  for (uint32_t i = 0; i < attribute_accessors.size(); i++) {
+    auto &accessor = attribute_accessors[i];
+    batch.AddAttribute(accessor.GetAttributeRef(), &accessor);
+  }
+
+  // Iterate over the batch using a scalar loop
+  batch.Iterate(codegen, [&](RowBatch::Row &row) {
+    // Evaluate the predicate to determine row validity
+    codegen::Value valid_row = row.DeriveValue(codegen, *predicate);
+
+    // Reify the boolean value since it may be NULL
+    PL_ASSERT(valid_row.GetType().GetSqlType() == type::Boolean::Instance());
+    llvm::Value *bool_val = type::Boolean::Instance().Reify(codegen, valid_row);
+
+    // Set the validity of the row
+    row.SetValidity(codegen, bool_val);
+  });
+}
+
+//===----------------------------------------------------------------------===//
+// ATTRIBUTE ACCESS
+//===----------------------------------------------------------------------===//
+
+IndexScanTranslator::AttributeAccess::AttributeAccess(
+    const TileGroup::TileGroupAccess &access, const planner::AttributeInfo *ai)
+    : tile_group_access_(access), ai_(ai) {}
+
+codegen::Value IndexScanTranslator::AttributeAccess::Access(
+    CodeGen &codegen, RowBatch::Row &row) {
+  auto raw_row = tile_group_access_.GetRow(row.GetTID(codegen));
+  return raw_row.LoadColumn(codegen, ai_->attribute_id);
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// insert_translator.cpp
+//
+// Identification: src/codegen/operator/insert_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/insert_translator.h"
+
+#include "codegen/proxy/catalog_proxy.h"
+#include "codegen/proxy/inserter_proxy.h"
+#include "planner/insert_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace codegen {
+
+InsertTranslator::InsertTranslator(const planner::InsertPlan &insert_plan,
+                                   CompilationContext &context,
+                                   Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline), insert_plan_(insert_plan) {
+  // An INSERT ... SELECT inserts the tuples its child produces
+  if (!insert_plan.GetChildren().empty()) {
+    context.Prepare(*insert_plan.GetChild(0), pipeline);
+  }
+
+  // Register the inserter
+  inserter_state_id_ = context.GetRuntimeState().RegisterState(
+      "inserter", InserterProxy::GetType(GetCodeGen()));
+}
+
+void InsertTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+
+  // Get the table pointer
+  storage::DataTable *table = insert_plan_.GetTable();
+  llvm::Value *table_ptr = codegen.CallFunc(
+      CatalogProxy::_GetTableWithOid::GetFunction(codegen),
+      {GetCatalogPtr(), codegen.Const32(table->GetDatabaseOid()),
+       codegen.Const32(table->GetOid())});
+
+  // Call Inserter.Init(table, executor_context)
+  llvm::Value *inserter = LoadStatePtr(inserter_state_id_);
+  std::vector<llvm::Value *> args = {
+      inserter, table_ptr, GetCompilationContext().GetExecutorContextPtr()};
+  codegen.CallFunc(InserterProxy::_Init::GetFunction(codegen), args);
+}
+
+void InsertTranslator::Produce() const {
+  if (!insert_plan_.GetChildren().empty()) {
+    // Call Produce() on our child, to produce the tuples we'll insert
+    GetCompilationContext().Produce(*insert_plan_.GetChild(0));
+    return;
+  }
+
+  // The tuples of the plan are materialized already, insert them as they are
+  auto &codegen = GetCodeGen();
+  llvm::Value *inserter = LoadStatePtr(inserter_state_id_);
+  codegen.CallFunc(
+      InserterProxy::_InsertPlanTuples::GetFunction(codegen),
+      {inserter, GetCompilationContext().GetPlanPtr(insert_plan_)});
+}
+
+void InsertTranslator::Consume(ConsumerContext &, RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+  llvm::Value *inserter = LoadStatePtr(inserter_state_id_);
+
+  // Write the values of the row into the value buffer of the inserter
+  llvm::Value *values = codegen.CallFunc(
+      InserterProxy::_GetValues::GetFunction(codegen), {inserter});
+  const auto &ais = insert_plan_.GetAttributeInfos();
+  for (uint32_t col_id = 0; col_id < ais.size(); col_id++) {
+    codegen::Value val = row.DeriveValue(codegen, ais[col_id]);
+    val.OutputTo(codegen, values, col_id);
+  }
+
+  // Call Inserter::Insert()
+  codegen.CallFunc(InserterProxy::_Insert::GetFunction(codegen), {inserter});
+}
+
+void InsertTranslator::TearDownState() {
+  auto &codegen = GetCodeGen();
+  llvm::Value *inserter = LoadStatePtr(inserter_state_id_);
+  codegen.CallFunc(InserterProxy::_Destroy::GetFunction(codegen), {inserter});
+}
+
+}  // namespace codegen
+}  // namespace peloton
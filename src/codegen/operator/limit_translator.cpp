@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// limit_translator.cpp
+//
+// Identification: src/codegen/operator/limit_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/limit_translator.h"
+
+#include <limits>
+
+#include "codegen/consumer_context.h"
+#include "codegen/lang/if.h"
+#include "planner/limit_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+LimitTranslator::LimitTranslator(const planner::LimitPlan &plan,
+                                 CompilationContext &context,
+                                 Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline), plan_(plan) {
+  // The limit is fused into the pipeline of its child
+  context.Prepare(*plan.GetChild(0), pipeline);
+
+  count_id_ = context.GetRuntimeState().RegisterState(
+      "limitCount", GetCodeGen().Int64Type());
+}
+
+void LimitTranslator::InitializeState() {
+  GetCodeGen()->CreateStore(GetCodeGen().Const64(0), LoadStatePtr(count_id_));
+}
+
+void LimitTranslator::Produce() const {
+  GetCompilationContext().Produce(*plan_.GetChild(0));
+}
+
+// The tuple is counted if the limit isn't reached yet, and passed on if the
+// offset was skipped already:
+//
+// @code
+// if (count < offset + limit) {
+//   count++
+//   if (count > offset) {
+//     consume(row)
+//   }
+// }
+// @endcode
+void LimitTranslator::Consume(ConsumerContext &context,
+                              RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  llvm::Value *count_ptr = LoadStatePtr(count_id_);
+  llvm::Value *count = codegen->CreateLoad(count_ptr);
+
+  lang::If within_limit{
+      codegen, codegen->CreateICmpULT(count, codegen.Const64(GetEndCount()))};
+  {
+    llvm::Value *next_count = codegen->CreateAdd(count, codegen.Const64(1));
+    codegen->CreateStore(next_count, count_ptr);
+
+    lang::If past_offset{
+        codegen,
+        codegen->CreateICmpUGT(next_count, codegen.Const64(plan_.GetOffset()))};
+    {
+      // Send the row up to the parent
+      context.Consume(row);
+    }
+    past_offset.EndIf();
+  }
+  within_limit.EndIf();
+}
+
+llvm::Value *LimitTranslator::IsFinished() const {
+  auto &codegen = GetCodeGen();
+  llvm::Value *count = LoadStateValue(count_id_);
+  return codegen->CreateICmpUGE(count, codegen.Const64(GetEndCount()));
+}
+
+uint64_t LimitTranslator::GetEndCount() const {
+  uint64_t end_count = plan_.GetOffset() + plan_.GetLimit();
+  if (end_count < plan_.GetLimit()) {
+    end_count = std::numeric_limits<uint64_t>::max();
+  }
+  return end_count;
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_join_translator.cpp
+//
+// Identification: src/codegen/operator/nested_loop_join_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/nested_loop_join_translator.h"
+
+#include <unordered_set>
+
+#include "codegen/lang/if.h"
+#include "codegen/operator/projection_translator.h"
+#include "codegen/proxy/sorter_proxy.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/nested_loop_join_plan.h"
+#include "planner/project_info.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// NESTED LOOP JOIN TRANSLATOR
+//===----------------------------------------------------------------------===//
+
+NestedLoopJoinTranslator::NestedLoopJoinTranslator(
+    const planner::NestedLoopJoinPlan &join, CompilationContext &context,
+    Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline),
+      join_(join),
+      right_pipeline_(this) {
+  LOG_DEBUG("Constructing NestedLoopJoinTranslator ...");
+
+  auto &codegen = GetCodeGen();
+
+  // Prepare translators for the left and right input operators
+  context.Prepare(*join_.GetChild(0), pipeline);
+  context.Prepare(*join_.GetChild(1), right_pipeline_);
+
+  // Prepare the predicate and the projection
+  const auto *predicate = join_.GetPredicate();
+  if (predicate != nullptr) {
+    context.Prepare(*predicate);
+  }
+  const auto *projection_info = join_.GetProjInfo();
+  if (projection_info != nullptr) {
+    ProjectionTranslator::PrepareProjection(context, *projection_info);
+  }
+
+  // The right side buffers the attributes the output, the predicate and the
+  // projection use
+  right_ais_ = join_.GetRightAttributes();
+  if (predicate != nullptr) {
+    CollectRightAttributes(*predicate);
+  }
+  if (projection_info != nullptr) {
+    for (const auto &target : projection_info->GetTargetList()) {
+      CollectRightAttributes(*target.second.expr);
+    }
+  }
+
+  std::vector<type::Type> right_types;
+  for (const auto *right_ai : right_ais_) {
+    right_types.push_back(right_ai->type);
+  }
+  buffer_ = Sorter{codegen, right_types};
+
+  // Allocate state for the buffer
+  buffer_id_ = context.GetRuntimeState().RegisterState(
+      "nljBuffer", SorterProxy::GetType(codegen));
+
+  LOG_DEBUG("Finished constructing NestedLoopJoinTranslator ...");
+}
+
+// Initialize the buffer, it is never sorted so it has no comparison function
+void NestedLoopJoinTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+  auto *compare_func_type = llvm::FunctionType::get(
+      codegen.Int32Type(), {codegen.CharPtrType(), codegen.CharPtrType()},
+      false);
+  buffer_.Init(codegen, LoadStatePtr(buffer_id_),
+               codegen.NullPtr(compare_func_type->getPointerTo()));
+}
+
+void NestedLoopJoinTranslator::Produce() const {
+  // Let the right child produce the tuples we buffer
+  GetCompilationContext().Produce(*join_.GetChild(1));
+
+  // Let the left child produce the tuples we join with the buffered ones
+  GetCompilationContext().Produce(*join_.GetChild(0));
+}
+
+void NestedLoopJoinTranslator::Consume(ConsumerContext &context,
+                                       RowBatch::Row &row) const {
+  if (IsFromRightChild(context)) {
+    ConsumeFromRight(context, row);
+  } else {
+    ConsumeFromLeft(context, row);
+  }
+}
+
+// The given row is from the right child. Append it to the buffer.
+void NestedLoopJoinTranslator::ConsumeFromRight(ConsumerContext &,
+                                                RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+  std::vector<codegen::Value> vals;
+  for (const auto *right_ai : right_ais_) {
+    vals.push_back(row.DeriveValue(codegen, right_ai));
+  }
+  buffer_.Append(codegen, LoadStatePtr(buffer_id_), vals);
+}
+
+// The given row is from the left child. Join it with every buffered row.
+void NestedLoopJoinTranslator::ConsumeFromLeft(ConsumerContext &context,
+                                               RowBatch::Row &row) const {
+  JoinRight join_right{*this, context, row};
+  buffer_.Iterate(GetCodeGen(), LoadStatePtr(buffer_id_), join_right);
+}
+
+// Cleanup by destroying the buffer
+void NestedLoopJoinTranslator::TearDownState() {
+  buffer_.Destroy(GetCodeGen(), LoadStatePtr(buffer_id_));
+}
+
+std::string NestedLoopJoinTranslator::GetName() const {
+  std::string name = "NestedLoopJoin::";
+  switch (join_.GetJoinType()) {
+    case JoinType::INNER: {
+      name.append("Inner");
+      break;
+    }
+    case JoinType::OUTER: {
+      name.append("Outer");
+      break;
+    }
+    case JoinType::LEFT: {
+      name.append("Left");
+      break;
+    }
+    case JoinType::RIGHT: {
+      name.append("Right");
+      break;
+    }
+    case JoinType::SEMI: {
+      name.append("Semi");
+      break;
+    }
+    case JoinType::INVALID:
+      throw Exception{"Invalid join type"};
+  }
+  return name;
+}
+
+// Column references with a tuple index of one bind to the right child
+void NestedLoopJoinTranslator::CollectRightAttributes(
+    const expression::AbstractExpression &exp) {
+  if (exp.GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    const auto &tve = static_cast<const expression::TupleValueExpression &>(exp);
+    const auto *ai = tve.GetAttributeRef();
+    if (tve.GetTupleId() == 1 &&
+        std::find(right_ais_.begin(), right_ais_.end(), ai) ==
+            right_ais_.end()) {
+      right_ais_.push_back(ai);
+    }
+  }
+  for (uint32_t i = 0; i < exp.GetChildrenSize(); i++) {
+    CollectRightAttributes(*exp.GetChild(i));
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// JOIN RIGHT
+//===----------------------------------------------------------------------===//
+
+NestedLoopJoinTranslator::JoinRight::JoinRight(
+    const NestedLoopJoinTranslator &join_translator, ConsumerContext &context,
+    RowBatch::Row &row)
+    : join_translator_(join_translator), context_(context), row_(row) {}
+
+// The values of the buffered row are put into the row of the left side, which
+// is sent to the parent if it satisfies the predicate
+void NestedLoopJoinTranslator::JoinRight::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &vals) const {
+  const auto &right_ais = join_translator_.right_ais_;
+  for (uint32_t i = 0; i < right_ais.size(); i++) {
+    codegen::Value val = vals[i];
+    row_.RegisterAttributeValue(right_ais[i], val);
+  }
+
+  // The derived attributes of the projection
+  std::vector<RowBatch::ExpressionAccess> accessors;
+  const auto *projection_info = join_translator_.GetJoinPlan().GetProjInfo();
+  if (projection_info != nullptr) {
+    ProjectionTranslator::AddNonTrivialAttributes(
+        row_.GetBatch(), *projection_info, accessors);
+  }
+
+  // Check predicate if one exists
+  const auto *predicate = join_translator_.GetJoinPlan().GetPredicate();
+  if (predicate != nullptr) {
+    auto valid_row = row_.DeriveValue(codegen, *predicate);
+    lang::If is_valid_row{codegen, valid_row};
+    {
+      // Send row up to the parent
+      context_.Consume(row_);
+    }
+    is_valid_row.EndIf();
+  } else {
+    // Send the row up to the parent
+    context_.Consume(row_);
+  }
+}
+
+}  // namespace codegen
+}  // namespace peloton
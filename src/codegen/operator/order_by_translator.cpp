@@ -12,6 +12,8 @@
 
 #include "codegen/operator/order_by_translator.h"
 
+#include <limits>
+
 #include "codegen/proxy/runtime_functions_proxy.h"
 #include "codegen/proxy/sorter_proxy.h"
 #include "codegen/type/integer_type.h"
@@ -33,8 +35,10 @@ OrderByTranslator::OrderByTranslator(const planner::OrderByPlan &plan,
       child_pipeline_(this) {
   LOG_DEBUG("Constructing OrderByTranslator ...");
 
-  // Prepare the child
+  // Prepare the child. Its threads append into their own sorter if it runs in
+  // parallel.
   context.Prepare(*plan.GetChild(0), child_pipeline_);
+  child_pipeline_.MakeParallel();
 
   auto &codegen = GetCodeGen();
 
@@ -260,15 +264,52 @@ void OrderByTranslator::Consume(ConsumerContext &, RowBatch::Row &row) const {
     }
   }
 
-  // Append the tuple into the sorter
-  sorter_.Append(codegen, LoadStatePtr(sorter_id_), tuple);
+  // Append the tuple into the sorter. If the sort has a limit, the sorter only
+  // keeps the tuples the limit (and offset) above it let through.
+  if (plan_.GetLimit()) {
+    sorter_.AppendTopK(codegen, LoadStatePtr(sorter_id_), tuple, GetTopK());
+  } else {
+    sorter_.Append(codegen, LoadStatePtr(sorter_id_), tuple);
+  }
 }
 
 void OrderByTranslator::TearDownState() {
   sorter_.Destroy(GetCodeGen(), LoadStatePtr(sorter_id_));
 }
 
-std::string OrderByTranslator::GetName() const { return "OrderBy"; }
+// Every thread of the parallel child pipeline appends into its own sorter
+void OrderByTranslator::InitializeThreadState() const {
+  sorter_.Init(GetCodeGen(), LoadStatePtr(sorter_id_), compare_func_);
+}
+
+// Move the tuples of the sorter of a thread into the one of the query. With a
+// limit, each thread keeps its own first top-K tuples, and the merge keeps the
+// first top-K tuples of all of them.
+void OrderByTranslator::MergeThreadState(llvm::Value *thread_state) const {
+  auto &codegen = GetCodeGen();
+  auto &runtime_state = GetCompilationContext().GetRuntimeState();
+  llvm::Value *thread_sorter =
+      runtime_state.LoadStatePtr(codegen, sorter_id_, thread_state);
+  sorter_.TransferFrom(codegen, LoadStatePtr(sorter_id_), thread_sorter,
+                       GetTopK());
+}
+
+std::string OrderByTranslator::GetName() const {
+  return plan_.GetLimit() ? "OrderBy(TopN)" : "OrderBy";
+}
+
+// The number of tuples the sorter keeps. Sorts without a limit, and limits
+// whose offset overflows, keep them all.
+uint64_t OrderByTranslator::GetTopK() const {
+  if (!plan_.GetLimit()) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  uint64_t top_k = plan_.GetLimitOffset() + plan_.GetLimitNumber();
+  if (top_k < plan_.GetLimitNumber()) {
+    top_k = std::numeric_limits<uint64_t>::max();
+  }
+  return top_k;
+}
 
 //===----------------------------------------------------------------------===//
 // PRODUCE RESULTS
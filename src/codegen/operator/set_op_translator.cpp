@@ -0,0 +1,246 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// set_op_translator.cpp
+//
+// Identification: src/codegen/operator/set_op_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/set_op_translator.h"
+
+#include "codegen/lang/loop.h"
+#include "codegen/proxy/oa_hash_table_proxy.h"
+#include "common/logger.h"
+#include "planner/set_op_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+namespace {
+
+// Every entry in the hash table stores two 64-bit counters: the number of
+// tuples of the left side, followed by the number of tuples of the right side
+constexpr uint32_t kLeftCountIndex = 0;
+constexpr uint32_t kRightCountIndex = 1;
+constexpr uint32_t kNumCounters = 2;
+
+llvm::Value *GetCounterPtr(CodeGen &codegen, llvm::Value *data_area,
+                           uint32_t index) {
+  auto *counters = codegen->CreateBitCast(
+      data_area, codegen.Int64Type()->getPointerTo());
+  return codegen->CreateConstInBoundsGEP1_32(codegen.Int64Type(), counters,
+                                             index);
+}
+
+void IncrementCounter(CodeGen &codegen, llvm::Value *data_area,
+                      uint32_t index) {
+  auto *counter_ptr = GetCounterPtr(codegen, data_area, index);
+  auto *counter = codegen->CreateLoad(counter_ptr);
+  codegen->CreateStore(codegen->CreateAdd(counter, codegen.Const64(1)),
+                       counter_ptr);
+}
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// SET OP TRANSLATOR
+//===----------------------------------------------------------------------===//
+
+SetOpTranslator::SetOpTranslator(const planner::SetOpPlan &plan,
+                                 CompilationContext &context,
+                                 Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline),
+      plan_(plan),
+      left_pipeline_(this),
+      right_pipeline_(this) {
+  LOG_DEBUG("Constructing SetOpTranslator ...");
+
+  auto &codegen = GetCodeGen();
+
+  // Prepare translators for the left and right input operators
+  context.Prepare(*plan_.GetChild(0), left_pipeline_);
+  context.Prepare(*plan_.GetChild(1), right_pipeline_);
+
+  // Allocate state for the hash table and the output vector
+  auto &runtime_state = context.GetRuntimeState();
+  hash_table_id_ = runtime_state.RegisterState(
+      "setOpHashTable", OAHashTableProxy::GetType(codegen));
+  output_vector_id_ = runtime_state.RegisterState(
+      "setOpSelVec", codegen.VectorType(codegen.Int32Type(), 1), true);
+
+  // The hash table is keyed on all columns
+  std::vector<type::Type> key_type;
+  for (const auto *left_ai : plan_.GetLeftAttributes()) {
+    key_type.push_back(left_ai->type);
+  }
+  hash_table_ =
+      OAHashTable{codegen, key_type, kNumCounters * sizeof(int64_t)};
+
+  LOG_DEBUG("Finished constructing SetOpTranslator ...");
+}
+
+void SetOpTranslator::InitializeState() {
+  hash_table_.Init(GetCodeGen(), LoadStatePtr(hash_table_id_));
+}
+
+void SetOpTranslator::Produce() const {
+  // Let both children produce the tuples we count
+  GetCompilationContext().Produce(*plan_.GetChild(0));
+  GetCompilationContext().Produce(*plan_.GetChild(1));
+
+  // Iterate over the hash table, sending tuples up the tree
+  ProduceResults producer{*this};
+  hash_table_.Iterate(GetCodeGen(), LoadStatePtr(hash_table_id_), producer);
+}
+
+void SetOpTranslator::Consume(ConsumerContext &context,
+                              RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+
+  const bool from_left = IsFromLeftChild(context);
+  const auto &ais =
+      from_left ? plan_.GetLeftAttributes() : plan_.GetRightAttributes();
+
+  std::vector<codegen::Value> key;
+  for (const auto *ai : ais) {
+    key.push_back(row.DeriveValue(codegen, ai));
+  }
+
+  llvm::Value *hash_table = LoadStatePtr(hash_table_id_);
+  if (from_left) {
+    CountLeft count_left;
+    InsertLeft insert_left;
+    hash_table_.ProbeOrInsert(codegen, hash_table, nullptr, key, count_left,
+                              insert_left);
+  } else {
+    // Tuples of the right side that are not on the left side do not matter
+    CountRight count_right;
+    hash_table_.FindAll(codegen, hash_table, nullptr, key, count_right);
+  }
+}
+
+void SetOpTranslator::TearDownState() {
+  hash_table_.Destroy(GetCodeGen(), LoadStatePtr(hash_table_id_));
+}
+
+std::string SetOpTranslator::GetName() const {
+  switch (plan_.GetSetOp()) {
+    case SetOpType::INTERSECT:
+      return "SetOp::Intersect";
+    case SetOpType::INTERSECT_ALL:
+      return "SetOp::IntersectAll";
+    case SetOpType::EXCEPT:
+      return "SetOp::Except";
+    case SetOpType::EXCEPT_ALL:
+      return "SetOp::ExceptAll";
+    default:
+      throw Exception{"Invalid set operation"};
+  }
+}
+
+llvm::Value *SetOpTranslator::GetOutputCount(CodeGen &codegen,
+                                             llvm::Value *left_count,
+                                             llvm::Value *right_count) const {
+  auto *zero = codegen.Const64(0);
+  auto *one = codegen.Const64(1);
+  auto *in_right = codegen->CreateICmpUGT(right_count, zero);
+  switch (plan_.GetSetOp()) {
+    case SetOpType::INTERSECT:
+      return codegen->CreateSelect(in_right, one, zero);
+    case SetOpType::INTERSECT_ALL:
+      return codegen->CreateSelect(
+          codegen->CreateICmpULT(left_count, right_count), left_count,
+          right_count);
+    case SetOpType::EXCEPT:
+      return codegen->CreateSelect(in_right, zero, one);
+    case SetOpType::EXCEPT_ALL:
+      return codegen->CreateSelect(
+          codegen->CreateICmpUGT(left_count, right_count),
+          codegen->CreateSub(left_count, right_count), zero);
+    default:
+      throw Exception{"Invalid set operation"};
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// COUNTING CALLBACKS
+//===----------------------------------------------------------------------===//
+
+void SetOpTranslator::CountLeft::ProcessEntry(CodeGen &codegen,
+                                              llvm::Value *data_area) const {
+  IncrementCounter(codegen, data_area, kLeftCountIndex);
+}
+
+void SetOpTranslator::InsertLeft::StoreValue(CodeGen &codegen,
+                                             llvm::Value *space) const {
+  codegen->CreateStore(codegen.Const64(1),
+                       GetCounterPtr(codegen, space, kLeftCountIndex));
+  codegen->CreateStore(codegen.Const64(0),
+                       GetCounterPtr(codegen, space, kRightCountIndex));
+}
+
+llvm::Value *SetOpTranslator::InsertLeft::GetValueSize(CodeGen &codegen) const {
+  return codegen.Const32(kNumCounters * sizeof(int64_t));
+}
+
+void SetOpTranslator::CountRight::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &,
+    llvm::Value *data_area) const {
+  IncrementCounter(codegen, data_area, kRightCountIndex);
+}
+
+//===----------------------------------------------------------------------===//
+// PRODUCE RESULTS
+//===----------------------------------------------------------------------===//
+
+SetOpTranslator::ProduceResults::ProduceResults(
+    const SetOpTranslator &translator)
+    : translator_(translator) {}
+
+// Send the key of the entry to the parent as often as the set operation asks
+void SetOpTranslator::ProduceResults::ProcessEntry(
+    CodeGen &codegen, const std::vector<codegen::Value> &key,
+    llvm::Value *data_area) const {
+  llvm::Value *left_count =
+      codegen->CreateLoad(GetCounterPtr(codegen, data_area, kLeftCountIndex));
+  llvm::Value *right_count =
+      codegen->CreateLoad(GetCounterPtr(codegen, data_area, kRightCountIndex));
+  llvm::Value *num_copies =
+      translator_.GetOutputCount(codegen, left_count, right_count);
+
+  const auto &left_ais = translator_.plan_.GetLeftAttributes();
+  std::vector<KeyAttributeAccess> key_accessors;
+  for (uint32_t i = 0; i < left_ais.size(); i++) {
+    key_accessors.emplace_back(key, i);
+  }
+
+  llvm::Value *copy = codegen.Const64(0);
+  lang::Loop copy_loop{
+      codegen, codegen->CreateICmpULT(copy, num_copies), {{"copy", copy}}};
+  {
+    copy = copy_loop.GetLoopVar(0);
+
+    // Create a row-batch of one row, place all the attributes into the row
+    Vector v{translator_.LoadStateValue(translator_.output_vector_id_), 1,
+             codegen.Int32Type()};
+    RowBatch batch{translator_.GetCompilationContext(), codegen.Const32(0),
+                   codegen.Const32(1), v, false};
+    for (uint32_t i = 0; i < left_ais.size(); i++) {
+      batch.AddAttribute(left_ais[i], &key_accessors[i]);
+    }
+
+    ConsumerContext context{translator_.GetCompilationContext(),
+                            translator_.GetPipeline()};
+    context.Consume(batch);
+
+    copy = codegen->CreateAdd(copy, codegen.Const64(1));
+    copy_loop.LoopEnd(codegen->CreateICmpULT(copy, num_copies), {copy});
+  }
+}
+
+}  // namespace codegen
+}  // namespace peloton
@@ -12,16 +12,266 @@
 
 #include "codegen/operator/table_scan_translator.h"
 
+#include <algorithm>
+#include <unordered_map>
+
+#include "codegen/function_builder.h"
 #include "codegen/lang/if.h"
 #include "codegen/proxy/catalog_proxy.h"
+#include "codegen/proxy/runtime_functions_proxy.h"
 #include "codegen/proxy/transaction_runtime_proxy.h"
 #include "codegen/type/boolean_type.h"
+#include "expression/conjunction_order.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
 #include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
 
 namespace peloton {
 namespace codegen {
 
+namespace {
+
+// The number of rows a SIMD predicate is evaluated on at once
+const uint32_t kSIMDVectorSize = 8;
+
+bool IsIntegral(peloton::type::TypeId type_id) {
+  switch (type_id) {
+    case peloton::type::TypeId::TINYINT:
+    case peloton::type::TypeId::SMALLINT:
+    case peloton::type::TypeId::INTEGER:
+    case peloton::type::TypeId::BIGINT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Can the expression be loaded from a column or splat from a constant into a
+// vector of fixed-length values?
+bool IsSIMDOperand(const expression::AbstractExpression &exp) {
+  switch (exp.GetExpressionType()) {
+    case ExpressionType::VALUE_TUPLE: {
+      break;
+    }
+    case ExpressionType::VALUE_CONSTANT: {
+      const auto &constant =
+          static_cast<const expression::ConstantValueExpression &>(exp);
+      if (constant.GetValue().IsNull()) {
+        return false;
+      }
+      break;
+    }
+    default: { return false; }
+  }
+  auto type_id = exp.GetValueType();
+  return IsIntegral(type_id) || type_id == peloton::type::TypeId::DECIMAL ||
+         type_id == peloton::type::TypeId::DATE ||
+         type_id == peloton::type::TypeId::TIMESTAMP;
+}
+
+// Is the predicate made of conjunctions and comparisons of fixed-length
+// columns and constants only, such that it can be evaluated with vector
+// instructions?
+bool IsSIMDPredicate(const expression::AbstractExpression &exp) {
+  switch (exp.GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR: {
+      return IsSIMDPredicate(*exp.GetChild(0)) &&
+             IsSIMDPredicate(*exp.GetChild(1));
+    }
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+      const auto &left = *exp.GetChild(0);
+      const auto &right = *exp.GetChild(1);
+      if (!IsSIMDOperand(left) || !IsSIMDOperand(right)) {
+        return false;
+      }
+      // Dates and timestamps are only compared among themselves
+      auto left_type = left.GetValueType(), right_type = right.GetValueType();
+      auto is_numeric = [](peloton::type::TypeId type_id) {
+        return IsIntegral(type_id) ||
+               type_id == peloton::type::TypeId::DECIMAL;
+      };
+      return left_type == right_type ||
+             (is_numeric(left_type) && is_numeric(right_type));
+    }
+    default: { return false; }
+  }
+}
+
+// The most terms of a chain of ANDs compiled scans reorder. Every pass over a
+// batch branches to the term the order puts there.
+const uint32_t kMaxReorderedTerms = 4;
+
+// Is the predicate a chain of ANDs whose terms are evaluated one after the
+// other, in the order they turn out to filter the rows best?
+bool IsReorderedConjunction(const expression::AbstractExpression &exp) {
+  return exp.GetExpressionType() == ExpressionType::CONJUNCTION_AND &&
+         !IsSIMDPredicate(exp) &&
+         expression::ConjunctionOrder::IsReorderable(&exp, kMaxReorderedTerms);
+}
+
+// The type both sides of a SIMD comparison are converted to
+peloton::type::TypeId GetComparisonType(peloton::type::TypeId left_type,
+                                        peloton::type::TypeId right_type) {
+  if (left_type == right_type) {
+    return left_type;
+  }
+  if (left_type == peloton::type::TypeId::DECIMAL ||
+      right_type == peloton::type::TypeId::DECIMAL) {
+    return peloton::type::TypeId::DECIMAL;
+  }
+  // The integral types are ordered by their width
+  return std::max(left_type, right_type);
+}
+
+//===----------------------------------------------------------------------===//
+// Evaluates a SIMD predicate on the rows of a vector of TIDs, producing the
+// mask of the rows it is true for. Every column is loaded once, however often
+// the predicate refers to it.
+//===----------------------------------------------------------------------===//
+class SIMDPredicate {
+ public:
+  SIMDPredicate(CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+                RowBatch::Row &row, llvm::Value *tids)
+      : codegen_(codegen), access_(access), row_(row), tids_(tids) {}
+
+  llvm::Value *Evaluate(const expression::AbstractExpression &exp) {
+    switch (exp.GetExpressionType()) {
+      case ExpressionType::CONJUNCTION_AND: {
+        return codegen_->CreateAnd(Evaluate(*exp.GetChild(0)),
+                                   Evaluate(*exp.GetChild(1)));
+      }
+      case ExpressionType::CONJUNCTION_OR: {
+        return codegen_->CreateOr(Evaluate(*exp.GetChild(0)),
+                                  Evaluate(*exp.GetChild(1)));
+      }
+      default: { return EvaluateComparison(exp); }
+    }
+  }
+
+ private:
+  // A comparison is true for the rows where neither side is NULL
+  llvm::Value *EvaluateComparison(const expression::AbstractExpression &exp) {
+    const auto &left = *exp.GetChild(0);
+    const auto &right = *exp.GetChild(1);
+    auto type_id =
+        GetComparisonType(left.GetValueType(), right.GetValueType());
+
+    llvm::Value *left_null = nullptr, *right_null = nullptr;
+    llvm::Value *lhs = DeriveOperand(left, type_id, left_null);
+    llvm::Value *rhs = DeriveOperand(right, type_id, right_null);
+
+    llvm::Value *result = nullptr;
+    if (type_id == peloton::type::TypeId::DECIMAL) {
+      switch (exp.GetExpressionType()) {
+        case ExpressionType::COMPARE_EQUAL:
+          result = codegen_->CreateFCmpOEQ(lhs, rhs);
+          break;
+        case ExpressionType::COMPARE_NOTEQUAL:
+          result = codegen_->CreateFCmpUNE(lhs, rhs);
+          break;
+        case ExpressionType::COMPARE_LESSTHAN:
+          result = codegen_->CreateFCmpOLT(lhs, rhs);
+          break;
+        case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+          result = codegen_->CreateFCmpOLE(lhs, rhs);
+          break;
+        case ExpressionType::COMPARE_GREATERTHAN:
+          result = codegen_->CreateFCmpOGT(lhs, rhs);
+          break;
+        default:
+          result = codegen_->CreateFCmpOGE(lhs, rhs);
+          break;
+      }
+    } else {
+      switch (exp.GetExpressionType()) {
+        case ExpressionType::COMPARE_EQUAL:
+          result = codegen_->CreateICmpEQ(lhs, rhs);
+          break;
+        case ExpressionType::COMPARE_NOTEQUAL:
+          result = codegen_->CreateICmpNE(lhs, rhs);
+          break;
+        case ExpressionType::COMPARE_LESSTHAN:
+          result = codegen_->CreateICmpSLT(lhs, rhs);
+          break;
+        case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+          result = codegen_->CreateICmpSLE(lhs, rhs);
+          break;
+        case ExpressionType::COMPARE_GREATERTHAN:
+          result = codegen_->CreateICmpSGT(lhs, rhs);
+          break;
+        default:
+          result = codegen_->CreateICmpSGE(lhs, rhs);
+          break;
+      }
+    }
+
+    if (left_null != nullptr) {
+      result = codegen_->CreateAnd(result, codegen_->CreateNot(left_null));
+    }
+    if (right_null != nullptr) {
+      result = codegen_->CreateAnd(result, codegen_->CreateNot(right_null));
+    }
+    return result;
+  }
+
+  // Load the column or splat the constant into a vector of the given type
+  llvm::Value *DeriveOperand(const expression::AbstractExpression &exp,
+                             peloton::type::TypeId type_id,
+                             llvm::Value *&is_null) {
+    llvm::Value *vals = nullptr;
+    is_null = nullptr;
+    if (exp.GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      const auto &tve =
+          static_cast<const expression::TupleValueExpression &>(exp);
+      uint32_t col_idx = tve.GetAttributeRef()->attribute_id;
+      auto iter = columns_.find(col_idx);
+      if (iter == columns_.end()) {
+        llvm::Value *col_null = nullptr;
+        llvm::Value *col_vals = access_.LoadColumnVector(
+            codegen_, tids_, kSIMDVectorSize, col_idx, col_null);
+        iter = columns_.emplace(col_idx, std::make_pair(col_vals, col_null))
+                   .first;
+      }
+      vals = iter->second.first;
+      is_null = iter->second.second;
+    } else {
+      // Constants are independent of the row
+      codegen::Value constant = row_.DeriveValue(codegen_, exp);
+      vals = codegen_->CreateVectorSplat(kSIMDVectorSize, constant.GetValue());
+    }
+
+    if (exp.GetValueType() == type_id) {
+      return vals;
+    }
+    llvm::Type *val_type = nullptr, *len_type = nullptr;
+    type::SqlType::LookupType(type_id)
+        .GetTypeForMaterialization(codegen_, val_type, len_type);
+    llvm::Type *vector_type = llvm::VectorType::get(val_type, kSIMDVectorSize);
+    return type_id == peloton::type::TypeId::DECIMAL
+               ? codegen_->CreateSIToFP(vals, vector_type)
+               : codegen_->CreateSExt(vals, vector_type);
+  }
+
+ private:
+  CodeGen &codegen_;
+  const TileGroup::TileGroupAccess &access_;
+  RowBatch::Row &row_;
+  llvm::Value *tids_;
+
+  // The values and NULL masks of the columns loaded so far
+  std::unordered_map<uint32_t, std::pair<llvm::Value *, llvm::Value *>>
+      columns_;
+};
+
+}  // anonymous namespace
+
 //===----------------------------------------------------------------------===//
 // TABLE SCAN TRANSLATOR
 //===----------------------------------------------------------------------===//
@@ -32,6 +282,8 @@ TableScanTranslator::TableScanTranslator(const planner::SeqScanPlan &scan,
                                          Pipeline &pipeline)
     : OperatorTranslator(context, pipeline),
       scan_(scan),
+      reorders_terms_(false),
+      conjunction_order_id_(0),
       table_(*scan_.GetTable()) {
   LOG_DEBUG("Constructing TableScanTranslator ...");
 
@@ -48,16 +300,49 @@ TableScanTranslator::TableScanTranslator(const planner::SeqScanPlan &scan,
     }
   }
 
+  // The selection vector is padded by a SIMD vector, which SIMD predicates
+  // read and write past its last element
   auto &codegen = GetCodeGen();
   auto &runtime_state = context.GetRuntimeState();
   selection_vector_id_ = runtime_state.RegisterState(
-      "scanSelVec",
-      codegen.VectorType(codegen.Int32Type(), Vector::kDefaultVectorSize),
+      "scanSelVec", codegen.VectorType(codegen.Int32Type(),
+                                       Vector::kDefaultVectorSize +
+                                           kSIMDVectorSize),
       true);
 
+  // The order of the terms is shared by the threads of a parallel scan
+  if (predicate != nullptr && IsReorderedConjunction(*predicate)) {
+    reorders_terms_ = true;
+    conjunction_order_id_ =
+        runtime_state.RegisterState("scanConjOrder", codegen.CharPtrType());
+  }
+
   LOG_DEBUG("Finished constructing TableScanTranslator ...");
 }
 
+void TableScanTranslator::InitializeState() {
+  if (!reorders_terms_) {
+    return;
+  }
+  auto &codegen = GetCodeGen();
+  llvm::Value *predicate_ptr =
+      GetCompilationContext().GetPredicatePtr(*GetScanPlan().GetPredicate());
+  llvm::Value *order = codegen.CallFunc(
+      RuntimeFunctionsProxy::_CreateConjunctionOrder::GetFunction(codegen),
+      {predicate_ptr});
+  codegen->CreateStore(order, LoadStatePtr(conjunction_order_id_));
+}
+
+void TableScanTranslator::TearDownState() {
+  if (!reorders_terms_) {
+    return;
+  }
+  auto &codegen = GetCodeGen();
+  codegen.CallFunc(
+      RuntimeFunctionsProxy::_DestroyConjunctionOrder::GetFunction(codegen),
+      {LoadStateValue(conjunction_order_id_)});
+}
+
 // Produce!
 void TableScanTranslator::Produce() const {
   auto &codegen = GetCodeGen();
@@ -65,22 +350,128 @@ void TableScanTranslator::Produce() const {
 
   LOG_DEBUG("TableScan on [%u] starting to produce tuples ...", table.GetOid());
 
-  // Get the table instance from the database
-  llvm::Value *catalog_ptr = GetCatalogPtr();
-  llvm::Value *table_ptr =
-      codegen.CallFunc(CatalogProxy::_GetTableWithOid::GetFunction(codegen),
-                       {catalog_ptr, codegen.Const32(table.GetDatabaseOid()),
-                        codegen.Const32(table.GetOid())});
+  // Get the table instance from the database, and its number of tile groups
+  llvm::Value *table_ptr = GetTablePtr();
+  llvm::Value *num_tile_groups = table_.GetTileGroupCount(codegen, table_ptr);
+
+  if (GetPipeline().IsParallel()) {
+    ProduceParallel(num_tile_groups);
+  } else {
+    ProduceTileGroups(table_ptr, codegen.Const64(0), num_tile_groups);
+  }
+
+  LOG_DEBUG("TableScan on [%u] finished producing tuples ...", table.GetOid());
+}
+
+// Get the table instance from the database
+llvm::Value *TableScanTranslator::GetTablePtr() const {
+  auto &codegen = GetCodeGen();
+  auto &table = GetTable();
+  return codegen.CallFunc(
+      CatalogProxy::_GetTableWithOid::GetFunction(codegen),
+      {GetCatalogPtr(), codegen.Const32(table.GetDatabaseOid()),
+       codegen.Const32(table.GetOid())});
+}
+
+void TableScanTranslator::ProduceTileGroups(
+    llvm::Value *table_ptr, llvm::Value *tile_group_start,
+    llvm::Value *tile_group_end) const {
+  auto &codegen = GetCodeGen();
 
   // The selection vector for the scan
   Vector sel_vec{LoadStateValue(selection_vector_id_),
                  Vector::kDefaultVectorSize, codegen.Int32Type()};
 
-  // Generate the scan
+  // Generate the scan. Tile groups are skipped if their zone maps rule out
+  // the predicate.
   ScanConsumer scan_consumer{*this, sel_vec};
-  table_.GenerateScan(codegen, table_ptr, sel_vec.GetCapacity(), scan_consumer);
+  const auto *predicate = GetScanPlan().GetPredicate();
+  llvm::Value *predicate_ptr =
+      predicate != nullptr
+          ? GetCompilationContext().GetPredicatePtr(*predicate)
+          : nullptr;
+  table_.GenerateScan(codegen, table_ptr, tile_group_start, tile_group_end,
+                      sel_vec.GetCapacity(), scan_consumer, predicate_ptr,
+                      GetCompilationContext().GetExecutorContextPtr());
+}
 
-  LOG_DEBUG("TableScan on [%u] finished producing tuples ...", table.GetOid());
+// The scan of a parallel pipeline goes into a function over a morsel of tile
+// groups, which the morsel scheduler calls on several threads. The operator
+// ending the pipeline provides the functions to set up the state of a thread,
+// and to merge it into the state of the query.
+void TableScanTranslator::ProduceParallel(llvm::Value *num_tile_groups) const {
+  auto &codegen = GetCodeGen();
+  auto &code_context = codegen.GetCodeContext();
+  auto &compilation_context = GetCompilationContext();
+  auto &runtime_state = compilation_context.GetRuntimeState();
+  auto *runtime_state_type = runtime_state.FinalizeType(codegen);
+  auto *runtime_state_ptr_type = runtime_state_type->getPointerTo();
+  const auto fn_prefix = code_context.GetFunctionName("");
+
+  // The scan of a morsel creates its own stack-local state
+  auto local_state = runtime_state.GetLocalState();
+  FunctionBuilder scan_morsel{code_context,
+                              fn_prefix + "scanMorsel",
+                              codegen.VoidType(),
+                              {{"runtimeState", runtime_state_ptr_type},
+                               {"tileGroupStart", codegen.Int64Type()},
+                               {"tileGroupEnd", codegen.Int64Type()}}};
+  runtime_state.CreateLocalState(codegen);
+  ProduceTileGroups(GetTablePtr(),
+                    scan_morsel.GetArgumentByName("tileGroupStart"),
+                    scan_morsel.GetArgumentByName("tileGroupEnd"));
+  scan_morsel.ReturnAndFinish();
+  runtime_state.SetLocalState(local_state);
+
+  const auto *breaker = GetPipeline().GetBreaker();
+  FunctionBuilder init_thread_state{code_context,
+                                    fn_prefix + "initThreadState",
+                                    codegen.VoidType(),
+                                    {{"runtimeState", runtime_state_ptr_type}}};
+  breaker->InitializeThreadState();
+  init_thread_state.ReturnAndFinish();
+
+  FunctionBuilder merge_thread_state{
+      code_context,
+      fn_prefix + "mergeThreadState",
+      codegen.VoidType(),
+      {{"runtimeState", runtime_state_ptr_type},
+       {"threadState", runtime_state_ptr_type}}};
+  breaker->MergeThreadState(merge_thread_state.GetArgumentByName("threadState"));
+  merge_thread_state.ReturnAndFinish();
+
+  // Breakers with many groups to merge merge them partition by partition
+  auto *char_ptr_type = codegen.CharPtrType();
+  uint32_t num_partitions = breaker->GetNumMergePartitions();
+  llvm::Value *merge_partition_func =
+      llvm::ConstantPointerNull::get(char_ptr_type);
+  if (num_partitions > 1) {
+    FunctionBuilder merge_partition{
+        code_context,
+        fn_prefix + "mergePartition",
+        codegen.VoidType(),
+        {{"runtimeState", runtime_state_ptr_type},
+         {"threadStates", runtime_state_ptr_type->getPointerTo()},
+         {"numThreadStates", codegen.Int64Type()},
+         {"partition", codegen.Int64Type()}}};
+    breaker->MergePartition(merge_partition.GetArgumentByName("threadStates"),
+                            merge_partition.GetArgumentByName("numThreadStates"),
+                            merge_partition.GetArgumentByName("partition"));
+    merge_partition.ReturnAndFinish();
+    merge_partition_func =
+        codegen->CreateBitCast(merge_partition.GetFunction(), char_ptr_type);
+  }
+
+  // Dispatch the morsels
+  codegen.CallFunc(
+      RuntimeFunctionsProxy::_ExecuteParallelScan::GetFunction(codegen),
+      {compilation_context.GetTransactionPtr(),
+       codegen->CreateBitCast(codegen.GetState(), char_ptr_type),
+       codegen.Const64(codegen.SizeOf(runtime_state_type)), num_tile_groups,
+       codegen->CreateBitCast(scan_morsel.GetFunction(), char_ptr_type),
+       codegen->CreateBitCast(init_thread_state.GetFunction(), char_ptr_type),
+       codegen->CreateBitCast(merge_thread_state.GetFunction(), char_ptr_type),
+       codegen.Const64(num_partitions), merge_partition_func});
 }
 
 // Get the stringified name of this scan
@@ -117,9 +508,12 @@ void TableScanTranslator::ScanConsumer::ProcessTuples(
   // 1. Filter the rows in the range [tid_start, tid_end) by txn visibility
   FilterRowsByVisibility(codegen, tid_start, tid_end, selection_vector_);
 
-  // 2. Filter rows by the given predicate (if one exists)
+  // 2. Filter rows by the given predicate (if one exists). Frozen tile groups
+  //    first rule out rows on their encoded columns.
   auto *predicate = GetPredicate();
   if (predicate != nullptr) {
+    FilterRowsByFrozenColumns(codegen, selection_vector_);
+
     // First perform a vectorized filter, putting TIDs into the selection vector
     FilterRowsByPredicate(codegen, tile_group_access, tid_start, tid_end,
                           selection_vector_);
@@ -181,6 +575,19 @@ void TableScanTranslator::ScanConsumer::FilterRowsByVisibility(
   selection_vector.SetNumElements(out_idx);
 }
 
+void TableScanTranslator::ScanConsumer::FilterRowsByFrozenColumns(
+    CodeGen &codegen, Vector &selection_vector) const {
+  auto &compilation_ctx = translator_.GetCompilationContext();
+  llvm::Value *predicate_ptr = compilation_ctx.GetPredicatePtr(*GetPredicate());
+  llvm::Value *executor_context_ptr = compilation_ctx.GetExecutorContextPtr();
+
+  llvm::Value *num_rows = codegen.CallFunc(
+      RuntimeFunctionsProxy::_FilterFrozenTuples::GetFunction(codegen),
+      {tile_group_ptr_, predicate_ptr, executor_context_ptr,
+       selection_vector.GetVectorPtr(), selection_vector.GetNumElements()});
+  selection_vector.SetNumElements(num_rows);
+}
+
 // Get the predicate, if one exists
 const expression::AbstractExpression *
 TableScanTranslator::ScanConsumer::GetPredicate() const {
@@ -191,19 +598,102 @@ void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
     CodeGen &codegen, const TileGroup::TileGroupAccess &access,
     llvm::Value *tid_start, llvm::Value *tid_end,
     Vector &selection_vector) const {
+  // First, check if the predicate is SIMDable
+  const auto *predicate = GetPredicate();
+  if (IsSIMDPredicate(*predicate)) {
+    RowBatch batch{translator_.GetCompilationContext(), tile_group_id_,
+                   tid_start, tid_end, selection_vector, true};
+    SIMDFilterRows(codegen, batch, access);
+    return;
+  }
+
+  if (translator_.reorders_terms_) {
+    FilterRowsByTerms(codegen, access, tid_start, tid_end, selection_vector);
+    return;
+  }
+
+  FilterRowsByExpression(codegen, access, tid_start, tid_end, *predicate,
+                         selection_vector);
+}
+
+// Every term filters the rows the terms before it let through. The order is
+// read once per batch, and the number of rows every term lets through is
+// recorded for the order to adapt to.
+void TableScanTranslator::ScanConsumer::FilterRowsByTerms(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    Vector &selection_vector) const {
+  std::vector<const expression::AbstractExpression *> terms;
+  expression::ConjunctionOrder::CollectTerms(GetPredicate(), terms);
+
+  llvm::Value *order_ptr =
+      translator_.LoadStateValue(translator_.conjunction_order_id_);
+  llvm::Value *order = codegen.CallFunc(
+      RuntimeFunctionsProxy::_GetConjunctionOrder::GetFunction(codegen),
+      {order_ptr});
+
+  for (uint32_t pos = 0; pos < terms.size(); pos++) {
+    llvm::Value *term = codegen->CreateTrunc(
+        codegen->CreateAnd(codegen->CreateLShr(order, codegen.Const64(4 * pos)),
+                           codegen.Const64(0xf)),
+        codegen.Int32Type());
+    llvm::Value *num_tuples = selection_vector.GetNumElements();
+    llvm::Value *num_passed = FilterRowsByTerm(
+        codegen, access, tid_start, tid_end, terms, term, 0, selection_vector);
+    selection_vector.SetNumElements(num_passed);
+    codegen.CallFunc(
+        RuntimeFunctionsProxy::_RecordConjunctionTerm::GetFunction(codegen),
+        {order_ptr, term, num_tuples, num_passed});
+  }
+}
+
+llvm::Value *TableScanTranslator::ScanConsumer::FilterRowsByTerm(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    const std::vector<const expression::AbstractExpression *> &terms,
+    llvm::Value *term, uint32_t term_idx, Vector &selection_vector) const {
+  if (term_idx + 1 == terms.size()) {
+    FilterRowsByExpression(codegen, access, tid_start, tid_end,
+                           *terms[term_idx], selection_vector);
+    return selection_vector.GetNumElements();
+  }
+
+  llvm::Value *num_tuples = selection_vector.GetNumElements();
+  llvm::Value *num_passed = nullptr, *num_passed_other = nullptr;
+  lang::If is_term{codegen,
+                   codegen->CreateICmpEQ(term, codegen.Const32(term_idx)),
+                   "filterByTerm"};
+  {
+    FilterRowsByExpression(codegen, access, tid_start, tid_end,
+                           *terms[term_idx], selection_vector);
+    num_passed = selection_vector.GetNumElements();
+  }
+  is_term.ElseBlock("filterByOtherTerm");
+  {
+    selection_vector.SetNumElements(num_tuples);
+    num_passed_other =
+        FilterRowsByTerm(codegen, access, tid_start, tid_end, terms, term,
+                         term_idx + 1, selection_vector);
+  }
+  is_term.EndIf();
+  return is_term.BuildPHI(num_passed, num_passed_other);
+}
+
+void TableScanTranslator::ScanConsumer::FilterRowsByExpression(
+    CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+    llvm::Value *tid_start, llvm::Value *tid_end,
+    const expression::AbstractExpression &exp,
+    Vector &selection_vector) const {
   // The batch we're filtering
   auto &compilation_ctx = translator_.GetCompilationContext();
   RowBatch batch{compilation_ctx, tile_group_id_,   tid_start,
                  tid_end,         selection_vector, true};
 
-  // First, check if the predicate is SIMDable
-  const auto *predicate = GetPredicate();
-
-  // Determine the attributes the predicate needs
+  // Determine the attributes the expression needs
   std::unordered_set<const planner::AttributeInfo *> used_attributes;
-  predicate->GetUsedAttributes(used_attributes);
+  exp.GetUsedAttributes(used_attributes);
 
-  // Setup the row batch with attribute accessors for the predicate
+  // Setup the row batch with attribute accessors for the expression
   std::vector<AttributeAccess> attribute_accessors;
   for (const auto *ai : used_attributes) {
     attribute_accessors.emplace_back(access, ai);
@@ -215,8 +705,8 @@ void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
 
   // Iterate over the batch using a scalar loop
   batch.Iterate(codegen, [&](RowBatch::Row &row) {
-    // Evaluate the predicate to determine row validity
-    codegen::Value valid_row = row.DeriveValue(codegen, *predicate);
+    // Evaluate the expression to determine row validity
+    codegen::Value valid_row = row.DeriveValue(codegen, exp);
 
     // Reify the boolean value since it may be NULL
     PL_ASSERT(valid_row.GetType().GetSqlType() == type::Boolean::Instance());
@@ -227,6 +717,64 @@ void TableScanTranslator::ScanConsumer::FilterRowsByPredicate(
   });
 }
 
+// Evaluate the predicate on vectors of rows. The TIDs of the rows that satisfy
+// it are compacted into the selection vector without branches: every TID is
+// written to the current output position, which only moves past the TIDs of
+// valid rows.
+void TableScanTranslator::ScanConsumer::SIMDFilterRows(
+    CodeGen &codegen, RowBatch &batch,
+    const TileGroup::TileGroupAccess &access) const {
+  const auto *predicate = GetPredicate();
+
+  // The lane index of every element of a vector
+  std::vector<llvm::Constant *> lanes;
+  for (uint32_t i = 0; i < kSIMDVectorSize; i++) {
+    lanes.push_back(codegen.Const32(i));
+  }
+  llvm::Value *lane_ids = llvm::ConstantVector::get(lanes);
+  auto *tids_type =
+      llvm::VectorType::get(codegen.Int32Type(), kSIMDVectorSize);
+
+  // Constants are derived through a row, which they do not read from
+  RowBatch::Row row = batch.GetRowAt(codegen.Const32(0));
+
+  batch.VectorizedIterate(codegen, kSIMDVectorSize, [&](
+      RowBatch::VectorizedIterateCallback::IterationInstance &ins) {
+    // Load the TIDs of the vector. The lanes past the end of the batch get
+    // the TID of the first lane, so that they load from valid rows.
+    llvm::Value *tids = codegen->CreateAlignedLoad(
+        codegen->CreateBitCast(
+            selection_vector_.GetPtrToValue(codegen, ins.start),
+            tids_type->getPointerTo()),
+        4);
+    llvm::Value *num_lanes = codegen->CreateSub(ins.end, ins.start);
+    llvm::Value *in_batch = codegen->CreateICmpULT(
+        lane_ids, codegen->CreateVectorSplat(kSIMDVectorSize, num_lanes));
+    llvm::Value *first_tid =
+        codegen->CreateExtractElement(tids, codegen.Const32(0));
+    tids = codegen->CreateSelect(
+        in_batch, tids,
+        codegen->CreateVectorSplat(kSIMDVectorSize, first_tid));
+
+    // Evaluate the predicate on all lanes at once
+    SIMDPredicate simd_predicate{codegen, access, row, tids};
+    llvm::Value *valid =
+        codegen->CreateAnd(simd_predicate.Evaluate(*predicate), in_batch);
+
+    // Compact the TIDs of the valid rows
+    llvm::Value *write_pos = ins.write_pos;
+    for (uint32_t i = 0; i < kSIMDVectorSize; i++) {
+      llvm::Value *lane = codegen.Const32(i);
+      selection_vector_.SetValue(codegen, write_pos,
+                                 codegen->CreateExtractElement(tids, lane));
+      llvm::Value *delta = codegen->CreateZExt(
+          codegen->CreateExtractElement(valid, lane), codegen.Int32Type());
+      write_pos = codegen->CreateAdd(write_pos, delta);
+    }
+    return write_pos;
+  });
+}
+
 //===----------------------------------------------------------------------===//
 // ATTRIBUTE ACCESS
 //===----------------------------------------------------------------------===//
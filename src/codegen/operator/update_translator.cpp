@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// update_translator.cpp
+//
+// Identification: src/codegen/operator/update_translator.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/operator/update_translator.h"
+
+#include <unordered_map>
+
+#include "codegen/proxy/updater_proxy.h"
+#include "planner/update_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+UpdateTranslator::UpdateTranslator(const planner::UpdatePlan &update_plan,
+                                   CompilationContext &context,
+                                   Pipeline &pipeline)
+    : OperatorTranslator(context, pipeline), update_plan_(update_plan) {
+  // Also create the translator for our child.
+  context.Prepare(*update_plan.GetChild(0), pipeline);
+
+  // Prepare translators for the SET expressions
+  for (const auto &target : update_plan.GetProjectInfo()->GetTargetList()) {
+    context.Prepare(*target.second.expr);
+  }
+
+  // Register the updater
+  updater_state_id_ = context.GetRuntimeState().RegisterState(
+      "updater", UpdaterProxy::GetType(GetCodeGen()));
+}
+
+void UpdateTranslator::InitializeState() {
+  auto &codegen = GetCodeGen();
+  auto &compilation_context = GetCompilationContext();
+
+  // Call Updater.Init(plan, executor_context)
+  llvm::Value *updater = LoadStatePtr(updater_state_id_);
+  std::vector<llvm::Value *> args = {
+      updater, compilation_context.GetPlanPtr(update_plan_),
+      compilation_context.GetExecutorContextPtr()};
+  codegen.CallFunc(UpdaterProxy::_Init::GetFunction(codegen), args);
+}
+
+void UpdateTranslator::Produce() const {
+  // Call Produce() on our child (a scan), to produce the tuples we'll update
+  GetCompilationContext().Produce(*update_plan_.GetChild(0));
+}
+
+void UpdateTranslator::Consume(ConsumerContext &, RowBatch::Row &row) const {
+  auto &codegen = GetCodeGen();
+  llvm::Value *updater = LoadStatePtr(updater_state_id_);
+
+  // Evaluate the SET expressions on the old values of the row
+  std::unordered_map<oid_t, codegen::Value> target_values;
+  for (const auto &target : update_plan_.GetProjectInfo()->GetTargetList()) {
+    target_values[target.first] = row.DeriveValue(codegen, *target.second.expr);
+  }
+
+  // Write the new values of all columns into the value buffer of the updater
+  llvm::Value *values = codegen.CallFunc(
+      UpdaterProxy::_GetValues::GetFunction(codegen), {updater});
+  const auto &ais = update_plan_.GetAttributeInfos();
+  for (uint32_t col_id = 0; col_id < ais.size(); col_id++) {
+    auto iter = target_values.find(col_id);
+    codegen::Value val = iter != target_values.end()
+                             ? iter->second
+                             : row.DeriveValue(codegen, ais[col_id]);
+    val.OutputTo(codegen, values, col_id);
+  }
+
+  // Call Updater::Update(tile_group_id, tuple_offset)
+  codegen.CallFunc(UpdaterProxy::_Update::GetFunction(codegen),
+                   {updater, row.GetTileGroupID(), row.GetTID(codegen)});
+}
+
+void UpdateTranslator::TearDownState() {
+  auto &codegen = GetCodeGen();
+  llvm::Value *updater = LoadStatePtr(updater_state_id_);
+  codegen.CallFunc(UpdaterProxy::_Destroy::GetFunction(codegen), {updater});
+}
+
+}  // namespace codegen
+}  // namespace peloton
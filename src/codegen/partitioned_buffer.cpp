@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_buffer.cpp
+//
+// Identification: src/codegen/partitioned_buffer.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/partitioned_buffer.h"
+
+#include "codegen/lang/loop.h"
+#include "codegen/proxy/partitioned_buffer_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+PartitionedBuffer::PartitionedBuffer() {
+  // This constructor shouldn't generally be used at all, but there are
+  // cases when the tuple description is not known fully at construction time.
+}
+
+PartitionedBuffer::PartitionedBuffer(CodeGen &codegen,
+                                     const std::vector<type::Type> &row_desc) {
+  // Configure the storage format using the provided row description
+  for (const auto &value_type : row_desc) {
+    storage_format_.AddType(value_type);
+  }
+  // Finalize the format
+  storage_format_.Finalize(codegen);
+}
+
+// Just make a call to util::PartitionedBuffer::Init(...)
+void PartitionedBuffer::Init(CodeGen &codegen, llvm::Value *buffer_ptr,
+                             uint32_t num_partitions) const {
+  auto *tuple_size = codegen.Const32(storage_format_.GetStorageSize());
+  codegen.CallFunc(PartitionedBufferProxy::_Init::GetFunction(codegen),
+                   {buffer_ptr, tuple_size, codegen.Const32(num_partitions)});
+}
+
+// Append the given tuple to the given partition of the buffer instance
+void PartitionedBuffer::Append(CodeGen &codegen, llvm::Value *buffer_ptr,
+                               llvm::Value *partition,
+                               const std::vector<codegen::Value> &tuple) const {
+  // Get the space for the tuple at the end of the partition
+  auto *store_func =
+      PartitionedBufferProxy::_StoreInputTuple::GetFunction(codegen);
+  auto *space = codegen.CallFunc(store_func, {buffer_ptr, partition});
+
+  // Now, individually store the attributes of the tuple into the free space
+  UpdateableStorage::NullBitmap null_bitmap{codegen, storage_format_, space};
+  for (uint32_t col_id = 0; col_id < tuple.size(); col_id++) {
+    if (!null_bitmap.IsNullable(col_id)) {
+      storage_format_.SetValueSkipNull(codegen, space, col_id, tuple[col_id]);
+    } else {
+      storage_format_.SetValue(codegen, space, col_id, tuple[col_id],
+                               null_bitmap);
+    }
+  }
+  null_bitmap.WriteBack(codegen);
+}
+
+// The tuples of a partition are contiguous, so we walk them with a pointer
+void PartitionedBuffer::IteratePartition(CodeGen &codegen,
+                                         llvm::Value *buffer_ptr,
+                                         llvm::Value *partition,
+                                         IterateCallback &callback) const {
+  llvm::Value *start_pos = codegen.CallFunc(
+      PartitionedBufferProxy::_GetPartitionStart::GetFunction(codegen),
+      {buffer_ptr, partition});
+  llvm::Value *num_tuples = codegen.CallFunc(
+      PartitionedBufferProxy::_GetNumTuples::GetFunction(codegen),
+      {buffer_ptr, partition});
+  llvm::Value *tuple_size = codegen.Const64(storage_format_.GetStorageSize());
+
+  llvm::Value *index = codegen.Const64(0);
+  lang::Loop loop{codegen,
+                  codegen->CreateICmpULT(index, num_tuples),
+                  {{"pos", start_pos}, {"index", index}}};
+  {
+    llvm::Value *pos = loop.GetLoopVar(0);
+    index = loop.GetLoopVar(1);
+
+    // Parse the row
+    std::vector<codegen::Value> vals;
+    UpdateableStorage::NullBitmap null_bitmap{codegen, storage_format_, pos};
+    for (uint32_t i = 0; i < storage_format_.GetNumElements(); i++) {
+      if (!null_bitmap.IsNullable(i)) {
+        vals.emplace_back(storage_format_.GetValueSkipNull(codegen, pos, i));
+      } else {
+        vals.emplace_back(
+            storage_format_.GetValue(codegen, pos, i, null_bitmap));
+      }
+    }
+
+    // Call the actual callback
+    callback.ProcessEntry(codegen, vals);
+
+    // Move to the next tuple
+    pos = codegen->CreateInBoundsGEP(codegen.ByteType(), pos, tuple_size);
+    index = codegen->CreateAdd(index, codegen.Const64(1));
+    loop.LoopEnd(codegen->CreateICmpULT(index, num_tuples), {pos, index});
+  }
+}
+
+// Just make a call to util::PartitionedBuffer::TransferFrom(...)
+void PartitionedBuffer::TransferFrom(CodeGen &codegen, llvm::Value *buffer_ptr,
+                                     llvm::Value *other_buffer_ptr) const {
+  codegen.CallFunc(PartitionedBufferProxy::_TransferFrom::GetFunction(codegen),
+                   {buffer_ptr, other_buffer_ptr});
+}
+
+// Just make a call to util::PartitionedBuffer::Destroy(...)
+void PartitionedBuffer::Destroy(CodeGen &codegen,
+                                llvm::Value *buffer_ptr) const {
+  codegen.CallFunc(PartitionedBufferProxy::_Destroy::GetFunction(codegen),
+                   {buffer_ptr});
+}
+
+}  // namespace codegen
+}  // namespace peloton
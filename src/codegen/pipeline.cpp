@@ -12,16 +12,21 @@
 
 #include "codegen/pipeline.h"
 
+#include <algorithm>
+
+#include "codegen/codegen.h"
 #include "codegen/operator/operator_translator.h"
 
 namespace peloton {
 namespace codegen {
 
 // Constructor
-Pipeline::Pipeline() : pipeline_index_(0) {}
+Pipeline::Pipeline() : pipeline_index_(0), parallel_(false) {}
 
 // Constructor
-Pipeline::Pipeline(const OperatorTranslator *translator) { Add(translator); }
+Pipeline::Pipeline(const OperatorTranslator *translator) : parallel_(false) {
+  Add(translator);
+}
 
 // Add this translator in this pipeline
 void Pipeline::Add(const OperatorTranslator *translator) {
@@ -68,6 +73,24 @@ const OperatorTranslator *Pipeline::NextStep() {
   }
 }
 
+const OperatorTranslator *Pipeline::GetParentOf(
+    const OperatorTranslator *translator) const {
+  auto pos = std::find(pipeline_.begin(), pipeline_.end(), translator);
+  if (pos == pipeline_.end() || pos == pipeline_.begin()) {
+    return nullptr;
+  }
+  return *(pos - 1);
+}
+
+const OperatorTranslator *Pipeline::GetChildOf(
+    const OperatorTranslator *translator) const {
+  auto pos = std::find(pipeline_.begin(), pipeline_.end(), translator);
+  if (pos == pipeline_.end() || pos + 1 == pipeline_.end()) {
+    return nullptr;
+  }
+  return *(pos + 1);
+}
+
 uint32_t Pipeline::GetNumStages() const {
   return static_cast<uint32_t>(stage_boundaries_.size()) + 1;
 }
@@ -95,9 +118,33 @@ uint32_t Pipeline::GetTranslatorStage(
   return GetNumStages() - stage - 1;
 }
 
+// The pipeline runs in parallel if every operator feeding the breaker at its
+// end can consume tuples on several threads at once
+void Pipeline::MakeParallel() {
+  PL_ASSERT(!pipeline_.empty());
+  parallel_ = pipeline_.size() > 1;
+  for (uint32_t pi = 1; pi < pipeline_.size(); pi++) {
+    parallel_ = parallel_ && pipeline_[pi]->IsParallelSafe();
+  }
+}
+
+llvm::Value *Pipeline::IsFinished(CodeGen &codegen) const {
+  llvm::Value *finished = nullptr;
+  for (const auto *translator : pipeline_) {
+    llvm::Value *translator_finished = translator->IsFinished();
+    if (translator_finished == nullptr) {
+      continue;
+    }
+    finished = finished == nullptr
+                   ? translator_finished
+                   : codegen->CreateOr(finished, translator_finished);
+  }
+  return finished;
+}
+
 // Get the stringified version of this pipeline
 std::string Pipeline::GetInfo() const {
-  std::string result;
+  std::string result{parallel_ ? "Parallel: " : ""};
   for (int32_t pi = static_cast<int32_t>(pipeline_.size()) - 1,
                sbi = static_cast<int32_t>(stage_boundaries_.size()) - 1;
        pi >= 0; pi--) {
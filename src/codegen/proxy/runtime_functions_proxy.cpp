@@ -15,7 +15,9 @@
 #include "llvm/IR/TypeBuilder.h"
 
 #include "codegen/proxy/data_table_proxy.h"
+#include "codegen/proxy/executor_context_proxy.h"
 #include "codegen/proxy/tile_group_proxy.h"
+#include "codegen/proxy/transaction_proxy.h"
 
 namespace peloton {
 namespace codegen {
@@ -71,6 +73,92 @@ llvm::Function *RuntimeFunctionsProxy::_GetTileGroup::GetFunction(
   return codegen.RegisterFunction(kGetTileGroupFnName, fn_type);
 }
 
+//===----------------------------------------------------------------------===//
+// Get the LLVM function definition/wrapper to
+// RuntimeFunctions::ZoneMapCanSatisfy(const TileGroup *,
+//                                     const AbstractExpression *,
+//                                     ExecutorContext *)
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_ZoneMapCanSatisfy::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kZoneMapCanSatisfyFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions17ZoneMapCanSatisfyEPKNS_"
+      "7storage9TileGroupEPKNS_10expression18AbstractExpressionEPNS_"
+      "8executor15ExecutorContextE";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions17ZoneMapCanSatisfyEPKNS_"
+      "7storage9TileGroupEPKNS_10expression18AbstractExpressionEPNS_"
+      "8executor15ExecutorContextE";
+#endif
+  auto *zone_map_func = codegen.LookupFunction(kZoneMapCanSatisfyFnName);
+  if (zone_map_func != nullptr) {
+    return zone_map_func;
+  }
+  // Not cached, create the type. The predicate is opaque to the generated
+  // code, so it is passed along as a char pointer.
+  std::vector<llvm::Type *> fn_args = {
+      TileGroupProxy::GetType(codegen)->getPointerTo(), codegen.CharPtrType(),
+      ExecutorContextProxy::GetType(codegen)->getPointerTo()};
+  auto *fn_type =
+      llvm::FunctionType::get(codegen.BoolType(), fn_args, false);
+  return codegen.RegisterFunction(kZoneMapCanSatisfyFnName, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// RuntimeFunctions::FilterFrozenTuples(const TileGroup *,
+//                                      const AbstractExpression *,
+//                                      ExecutorContext *, uint32_t *, uint32_t)
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_FilterFrozenTuples::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kFilterFrozenTuplesFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions18FilterFrozenTuplesEPKNS_"
+      "7storage9TileGroupEPKNS_10expression18AbstractExpressionEPNS_"
+      "8executor15ExecutorContextEPjj";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions18FilterFrozenTuplesEPKNS_"
+      "7storage9TileGroupEPKNS_10expression18AbstractExpressionEPNS_"
+      "8executor15ExecutorContextEPjj";
+#endif
+  auto *filter_func = codegen.LookupFunction(kFilterFrozenTuplesFnName);
+  if (filter_func != nullptr) {
+    return filter_func;
+  }
+  std::vector<llvm::Type *> fn_args = {
+      TileGroupProxy::GetType(codegen)->getPointerTo(), codegen.CharPtrType(),
+      ExecutorContextProxy::GetType(codegen)->getPointerTo(),
+      codegen.Int32Type()->getPointerTo(), codegen.Int32Type()};
+  auto *fn_type =
+      llvm::FunctionType::get(codegen.Int32Type(), fn_args, false);
+  return codegen.RegisterFunction(kFilterFrozenTuplesFnName, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// RuntimeFunctions::TileGroupHasNulls(const TileGroup *)
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_TileGroupHasNulls::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kTileGroupHasNullsFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions17TileGroupHasNullsEPKNS_"
+      "7storage9TileGroupE";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions17TileGroupHasNullsEPKNS_"
+      "7storage9TileGroupE";
+#endif
+  auto *has_nulls_func = codegen.LookupFunction(kTileGroupHasNullsFnName);
+  if (has_nulls_func != nullptr) {
+    return has_nulls_func;
+  }
+  std::vector<llvm::Type *> fn_args = {
+      TileGroupProxy::GetType(codegen)->getPointerTo()};
+  auto *fn_type =
+      llvm::FunctionType::get(codegen.BoolType(), fn_args, false);
+  return codegen.RegisterFunction(kTileGroupHasNullsFnName, fn_type);
+}
+
 //===----------------------------------------------------------------------===//
 //===----------------------------------------------------------------------===//
 llvm::Type *RuntimeFunctionsProxy::_ColumnLayoutInfo::GetType(
@@ -98,26 +186,163 @@ llvm::Function *RuntimeFunctionsProxy::_GetTileGroupLayout::GetFunction(
   static const std::string kGetTileGroupLayoutFnName =
 #ifdef __APPLE__
       "_ZN7peloton7codegen16RuntimeFunctions18GetTileGroupLayoutEPKNS_"
-      "7storage9TileGroupEPNS1_16ColumnLayoutInfoEj";
+      "7storage9TileGroupEPNS1_16ColumnLayoutInfoEjPNS_8executor"
+      "15ExecutorContextE";
 #else
       "_ZN7peloton7codegen16RuntimeFunctions18GetTileGroupLayoutEPKNS_"
-      "7storage9TileGroupEPNS1_16ColumnLayoutInfoEj";
+      "7storage9TileGroupEPNS1_16ColumnLayoutInfoEjPNS_8executor"
+      "15ExecutorContextE";
 #endif
 
   auto *get_tg_func = codegen.LookupFunction(kGetTileGroupLayoutFnName);
   if (get_tg_func != nullptr) {
     return get_tg_func;
   }
-  // Function arguments: DataTable*, oid_t, ColumnLayoutInfo*, uint32_t
+  // Function arguments: TileGroup*, ColumnLayoutInfo*, uint32_t,
+  // ExecutorContext*
   std::vector<llvm::Type *> fn_args = {
       TileGroupProxy::GetType(codegen)->getPointerTo(),
       RuntimeFunctionsProxy::_ColumnLayoutInfo::GetType(codegen)
           ->getPointerTo(),
-      codegen.Int32Type()};
+      codegen.Int32Type(),
+      ExecutorContextProxy::GetType(codegen)->getPointerTo()};
   auto *fn_type = llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
   return codegen.RegisterFunction(kGetTileGroupLayoutFnName, fn_type);
 }
 
+//===----------------------------------------------------------------------===//
+// Get the LLVM function definition/wrapper to
+// RuntimeFunctions::ExecuteParallelScan()
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_ExecuteParallelScan::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kExecuteParallelScanFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions19ExecuteParallelScanEPNS_"
+      "11concurrency11TransactionEPcmmPFvS5_mmEPFvS5_EPFvS5_S5_EmPFvS5_PS5_"
+      "mmE";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions19ExecuteParallelScanEPNS_"
+      "11concurrency11TransactionEPcmmPFvS5_mmEPFvS5_EPFvS5_S5_EmPFvS5_PS5_"
+      "mmE";
+#endif
+
+  auto *parallel_scan_func = codegen.LookupFunction(kExecuteParallelScanFnName);
+  if (parallel_scan_func != nullptr) {
+    return parallel_scan_func;
+  }
+  // Not cached, create the type. The runtime state and the functions
+  // generated for the pipeline are passed along as char pointers.
+  std::vector<llvm::Type *> fn_args = {
+      TransactionProxy::GetType(codegen)->getPointerTo(),
+      codegen.CharPtrType(),
+      codegen.Int64Type(),
+      codegen.Int64Type(),
+      codegen.CharPtrType(),
+      codegen.CharPtrType(),
+      codegen.CharPtrType(),
+      codegen.Int64Type(),
+      codegen.CharPtrType()};
+  auto *fn_type = llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+  return codegen.RegisterFunction(kExecuteParallelScanFnName, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// RuntimeFunctions::CreateConjunctionOrder(const AbstractExpression *)
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_CreateConjunctionOrder::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kCreateConjunctionOrderFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions22CreateConjunctionOrderEPKNS_"
+      "10expression18AbstractExpressionE";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions22CreateConjunctionOrderEPKNS_"
+      "10expression18AbstractExpressionE";
+#endif
+
+  auto *create_func = codegen.LookupFunction(kCreateConjunctionOrderFnName);
+  if (create_func != nullptr) {
+    return create_func;
+  }
+  // The predicate and the order are opaque to the compiled code
+  auto *fn_type = llvm::FunctionType::get(codegen.CharPtrType(),
+                                          {codegen.CharPtrType()}, false);
+  return codegen.RegisterFunction(kCreateConjunctionOrderFnName, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// RuntimeFunctions::DestroyConjunctionOrder(ConjunctionOrder *)
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_DestroyConjunctionOrder::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kDestroyConjunctionOrderFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions23DestroyConjunctionOrderEPNS_"
+      "10expression16ConjunctionOrderE";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions23DestroyConjunctionOrderEPNS_"
+      "10expression16ConjunctionOrderE";
+#endif
+
+  auto *destroy_func = codegen.LookupFunction(kDestroyConjunctionOrderFnName);
+  if (destroy_func != nullptr) {
+    return destroy_func;
+  }
+  auto *fn_type = llvm::FunctionType::get(codegen.VoidType(),
+                                          {codegen.CharPtrType()}, false);
+  return codegen.RegisterFunction(kDestroyConjunctionOrderFnName, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// RuntimeFunctions::GetConjunctionOrder(const ConjunctionOrder *)
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_GetConjunctionOrder::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kGetConjunctionOrderFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions19GetConjunctionOrderEPKNS_"
+      "10expression16ConjunctionOrderE";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions19GetConjunctionOrderEPKNS_"
+      "10expression16ConjunctionOrderE";
+#endif
+
+  auto *get_order_func = codegen.LookupFunction(kGetConjunctionOrderFnName);
+  if (get_order_func != nullptr) {
+    return get_order_func;
+  }
+  auto *fn_type = llvm::FunctionType::get(codegen.Int64Type(),
+                                          {codegen.CharPtrType()}, false);
+  return codegen.RegisterFunction(kGetConjunctionOrderFnName, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// RuntimeFunctions::RecordConjunctionTerm(ConjunctionOrder *, uint32_t,
+//                                         uint32_t, uint32_t)
+//===----------------------------------------------------------------------===//
+llvm::Function *RuntimeFunctionsProxy::_RecordConjunctionTerm::GetFunction(
+    CodeGen &codegen) {
+  static const std::string kRecordConjunctionTermFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen16RuntimeFunctions21RecordConjunctionTermEPNS_"
+      "10expression16ConjunctionOrderEjjj";
+#else
+      "_ZN7peloton7codegen16RuntimeFunctions21RecordConjunctionTermEPNS_"
+      "10expression16ConjunctionOrderEjjj";
+#endif
+
+  auto *record_func = codegen.LookupFunction(kRecordConjunctionTermFnName);
+  if (record_func != nullptr) {
+    return record_func;
+  }
+  std::vector<llvm::Type *> fn_args = {codegen.CharPtrType(),
+                                       codegen.Int32Type(), codegen.Int32Type(),
+                                       codegen.Int32Type()};
+  auto *fn_type = llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+  return codegen.RegisterFunction(kRecordConjunctionTermFnName, fn_type);
+}
+
 //===----------------------------------------------------------------------===//
 // Get the LLVM function definition/wrapper to
 // RuntimeFunctions::ThrowDivideByZeroException()
@@ -135,10 +360,13 @@ llvm::Function *RuntimeFunctionsProxy::_ThrowDivideByZeroException::GetFunction(
   if (get_exc_func != nullptr) {
     return get_exc_func;
   }
-  // No function args or return values
-  std::vector<llvm::Type *> fn_args;
+  // No function args or return values. The function never returns, and only
+  // runs on error paths that code layout moves out of the way.
   auto *fn_type = llvm::FunctionType::get(codegen.VoidType(), false);
-  return codegen.RegisterFunction(kDivZeroExceptionFnName, fn_type);
+  auto *exc_func = codegen.RegisterFunction(kDivZeroExceptionFnName, fn_type);
+  exc_func->setDoesNotReturn();
+  exc_func->addFnAttr(llvm::Attribute::Cold);
+  return exc_func;
 }
 
 //===----------------------------------------------------------------------===//
@@ -158,10 +386,13 @@ llvm::Function *RuntimeFunctionsProxy::_ThrowOverflowException::GetFunction(
   if (get_exc_func != nullptr) {
     return get_exc_func;
   }
-  // No function args or return values
-  std::vector<llvm::Type *> fn_args;
+  // No function args or return values. The function never returns, and only
+  // runs on error paths that code layout moves out of the way.
   auto *fn_type = llvm::FunctionType::get(codegen.VoidType(), false);
-  return codegen.RegisterFunction(kOverflowExceptionFnName, fn_type);
+  auto *exc_func = codegen.RegisterFunction(kOverflowExceptionFnName, fn_type);
+  exc_func->setDoesNotReturn();
+  exc_func->addFnAttr(llvm::Attribute::Cold);
+  return exc_func;
 }
 
 }  // namespace codegen
@@ -129,6 +129,72 @@ llvm::Function *SorterProxy::_StoreInputTuple::GetFunction(CodeGen &codegen) {
   return codegen.RegisterFunction(fn_name, fn_type);
 }
 
+//===--------------------------------------------------------------------===//
+// The proxy for codegen::util::Sorter::StoreInputTupleTopK()
+//===--------------------------------------------------------------------===//
+const std::string &SorterProxy::_StoreInputTupleTopK::GetFunctionName() {
+  static const std::string kStoreInputTupleTopKFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen4util6Sorter19StoreInputTupleTopKEy";
+#else
+      "_ZN7peloton7codegen4util6Sorter19StoreInputTupleTopKEm";
+#endif
+  return kStoreInputTupleTopKFnName;
+}
+
+llvm::Function *SorterProxy::_StoreInputTupleTopK::GetFunction(
+    CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  // The function hasn't been registered, let's do it now ...
+  // We need to create a function type whose signature matches
+  // codegen::util::Sorter::StoreInputTupleTopK(...)
+  std::vector<llvm::Type *> fn_args = {
+      SorterProxy::GetType(codegen)->getPointerTo(), codegen.Int64Type()};
+  llvm::FunctionType *fn_type =
+      llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
+//===--------------------------------------------------------------------===//
+// The proxy for codegen::util::Sorter::TransferFrom()
+//===--------------------------------------------------------------------===//
+const std::string &SorterProxy::_TransferFrom::GetFunctionName() {
+  static const std::string kTransferFromFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen4util6Sorter12TransferFromERS2_y";
+#else
+      "_ZN7peloton7codegen4util6Sorter12TransferFromERS2_m";
+#endif
+  return kTransferFromFnName;
+}
+
+llvm::Function *SorterProxy::_TransferFrom::GetFunction(CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  // The function hasn't been registered, let's do it now ...
+  // We need to create a function type whose signature matches
+  // codegen::util::Sorter::TransferFrom(...)
+  auto *sorter_ptr_type = SorterProxy::GetType(codegen)->getPointerTo();
+  std::vector<llvm::Type *> fn_args = {sorter_ptr_type, sorter_ptr_type,
+                                       codegen.Int64Type()};
+  llvm::FunctionType *fn_type =
+      llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
 //===--------------------------------------------------------------------===//
 // The proxy for codegen::util::Sorter::Sort()
 //===--------------------------------------------------------------------===//
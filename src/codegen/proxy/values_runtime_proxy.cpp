@@ -12,6 +12,7 @@
 
 #include "codegen/proxy/values_runtime_proxy.h"
 
+#include "codegen/proxy/executor_context_proxy.h"
 #include "codegen/value_proxy.h"
 #include "type/value.h"
 
@@ -345,5 +346,169 @@ llvm::Function *ValuesRuntimeProxy::_CompareStrings::GetFunction(
   return codegen.RegisterFunction(fn_name, fn_type);
 }
 
+//===----------------------------------------------------------------------===//
+// LIKE
+//===----------------------------------------------------------------------===//
+
+const std::string &ValuesRuntimeProxy::_Like::GetFunctionName() {
+  static const std::string kLikeFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen13ValuesRuntime4LikeEPKcjS3_j";
+#else
+      "_ZN7peloton7codegen13ValuesRuntime4LikeEPKcjS3_j";
+#endif
+  return kLikeFnName;
+}
+
+llvm::Function *ValuesRuntimeProxy::_Like::GetFunction(CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  std::vector<llvm::Type *> arg_types = {codegen.CharPtrType(),  // str
+                                         codegen.Int32Type(),    // str length
+                                         codegen.CharPtrType(),  // pattern
+                                         codegen.Int32Type()};   // its length
+  auto *fn_type =
+      llvm::FunctionType::get(codegen.BoolType(), arg_types, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// STARTS WITH
+//===----------------------------------------------------------------------===//
+
+const std::string &ValuesRuntimeProxy::_StartsWith::GetFunctionName() {
+  static const std::string kStartsWithFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen13ValuesRuntime10StartsWithEPKcjS3_j";
+#else
+      "_ZN7peloton7codegen13ValuesRuntime10StartsWithEPKcjS3_j";
+#endif
+  return kStartsWithFnName;
+}
+
+llvm::Function *ValuesRuntimeProxy::_StartsWith::GetFunction(CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  std::vector<llvm::Type *> arg_types = {codegen.CharPtrType(),  // str
+                                         codegen.Int32Type(),    // str length
+                                         codegen.CharPtrType(),  // pattern
+                                         codegen.Int32Type()};   // its length
+  auto *fn_type =
+      llvm::FunctionType::get(codegen.BoolType(), arg_types, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// ENDS WITH
+//===----------------------------------------------------------------------===//
+
+const std::string &ValuesRuntimeProxy::_EndsWith::GetFunctionName() {
+  static const std::string kEndsWithFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen13ValuesRuntime8EndsWithEPKcjS3_j";
+#else
+      "_ZN7peloton7codegen13ValuesRuntime8EndsWithEPKcjS3_j";
+#endif
+  return kEndsWithFnName;
+}
+
+llvm::Function *ValuesRuntimeProxy::_EndsWith::GetFunction(CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  std::vector<llvm::Type *> arg_types = {codegen.CharPtrType(),  // str
+                                         codegen.Int32Type(),    // str length
+                                         codegen.CharPtrType(),  // pattern
+                                         codegen.Int32Type()};   // its length
+  auto *fn_type =
+      llvm::FunctionType::get(codegen.BoolType(), arg_types, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// CONTAINS
+//===----------------------------------------------------------------------===//
+
+const std::string &ValuesRuntimeProxy::_Contains::GetFunctionName() {
+  static const std::string kContainsFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen13ValuesRuntime8ContainsEPKcjS3_j";
+#else
+      "_ZN7peloton7codegen13ValuesRuntime8ContainsEPKcjS3_j";
+#endif
+  return kContainsFnName;
+}
+
+llvm::Function *ValuesRuntimeProxy::_Contains::GetFunction(CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  std::vector<llvm::Type *> arg_types = {codegen.CharPtrType(),  // str
+                                         codegen.Int32Type(),    // str length
+                                         codegen.CharPtrType(),  // pattern
+                                         codegen.Int32Type()};   // its length
+  auto *fn_type =
+      llvm::FunctionType::get(codegen.BoolType(), arg_types, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
+//===----------------------------------------------------------------------===//
+// CALL FUNCTION
+//===----------------------------------------------------------------------===//
+
+const std::string &ValuesRuntimeProxy::_CallFunction::GetFunctionName() {
+  static const std::string kCallFunctionFnName =
+#ifdef __APPLE__
+      "_ZN7peloton7codegen13ValuesRuntime12CallFunctionEPcS2_jPNS_8executor15ExecutorContextES2_Pj";
+#else
+      "_ZN7peloton7codegen13ValuesRuntime12CallFunctionEPcS2_jPNS_8executor15ExecutorContextES2_Pj";
+#endif
+  return kCallFunctionFnName;
+}
+
+llvm::Function *ValuesRuntimeProxy::_CallFunction::GetFunction(
+    CodeGen &codegen) {
+  const std::string &fn_name = GetFunctionName();
+
+  // Has the function already been registered?
+  llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+  if (llvm_fn != nullptr) {
+    return llvm_fn;
+  }
+
+  std::vector<llvm::Type *> arg_types = {
+      codegen.CharPtrType(),                                  // function
+      codegen.CharPtrType(),                                  // arguments
+      codegen.Int32Type(),                                    // # arguments
+      ExecutorContextProxy::GetType(codegen)->getPointerTo(),  // context
+      codegen.CharPtrType(),                                  // result
+      codegen.Int32Type()->getPointerTo()};                   // result length
+  auto *fn_type =
+      llvm::FunctionType::get(codegen.BoolType(), arg_types, false);
+  return codegen.RegisterFunction(fn_name, fn_type);
+}
+
 }  // namespace codegen
 }  // namespace peloton
@@ -12,8 +12,10 @@
 
 #include "codegen/query.h"
 
+#include "codegen/query_parameters.h"
 #include "storage/storage_manager.h"
 #include "common/logger.h"
+#include "common/memory_tracker.h"
 #include "common/timer.h"
 
 namespace peloton {
@@ -21,7 +23,15 @@ namespace codegen {
 
 // Constructor
 Query::Query(const planner::AbstractPlan &query_plan)
-    : query_plan_(query_plan) {}
+    : query_plan_(query_plan),
+      runtime_state_size_(0),
+      parameterized_(false),
+      optimized_(true),
+      memory_footprint_(0) {}
+
+Query::~Query() {
+  MemoryTracker::Release(MemoryComponentType::CODEGEN, memory_footprint_);
+}
 
 // Execute the query on the given database (and within the provided transaction)
 // This really involves calling the init(), plan() and tearDown() functions, in
@@ -29,12 +39,10 @@ Query::Query(const planner::AbstractPlan &query_plan)
 // functions throw exceptions.
 void Query::Execute(concurrency::Transaction &txn,
                     executor::ExecutorContext *executor_context,
-                    char *consumer_arg, RuntimeStats *stats) {
-  CodeGen codegen{GetCodeContext()};
-
-  llvm::Type *runtime_state_type = runtime_state_.FinalizeType(codegen);
-  uint64_t parameter_size = codegen.SizeOf(runtime_state_type);
-  PL_ASSERT(parameter_size % 8 == 0);
+                    char *consumer_arg, RuntimeStats *stats,
+                    const QueryParameters *parameters) {
+  PL_ASSERT(parameterized_ == (parameters != nullptr));
+  uint64_t parameter_size = runtime_state_size_;
 
   // Allocate some space for the function arguments
   std::unique_ptr<char[]> param_data{new char[parameter_size]};
@@ -50,6 +58,7 @@ void Query::Execute(concurrency::Transaction &txn,
     concurrency::Transaction *txn;
     storage::StorageManager *catalog;
     executor::ExecutorContext *executor_context;
+    char *query_parameters;
     char *consumer_arg;
     char rest[0];
   } PACKED;
@@ -59,6 +68,8 @@ void Query::Execute(concurrency::Transaction &txn,
   func_args->txn = &txn;
   func_args->catalog = storage::StorageManager::GetInstance();
   func_args->executor_context = executor_context;
+  func_args->query_parameters =
+      parameters != nullptr ? parameters->GetParameterData() : nullptr;
   func_args->consumer_arg = consumer_arg;
 
   // Timer
@@ -115,8 +126,13 @@ void Query::Execute(concurrency::Transaction &txn,
 bool Query::Prepare(const QueryFunctions &query_funcs) {
   LOG_TRACE("Going to JIT the query ...");
 
+  CodeGen codegen{GetCodeContext()};
+  llvm::Type *runtime_state_type = runtime_state_.FinalizeType(codegen);
+  runtime_state_size_ = codegen.SizeOf(runtime_state_type);
+  PL_ASSERT(runtime_state_size_ % 8 == 0);
+
   // Compile the code
-  if (!code_context_.Compile()) {
+  if (!code_context_.Compile(optimized_)) {
     return false;
   }
 
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_cache.cpp
+//
+// Identification: src/codegen/query_cache.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_cache.h"
+
+#include <algorithm>
+
+#include "codegen/query_parameters.h"
+#include "common/logger.h"
+#include "configuration/configuration.h"
+#include "planner/abstract_plan.h"
+
+namespace peloton {
+namespace codegen {
+
+QueryCache &QueryCache::GetInstance() {
+  static QueryCache query_cache;
+  return query_cache;
+}
+
+QueryCache::QueryCache()
+    : cache_(std::max<size_t>(FLAGS_codegen_query_cache_size, 1)) {}
+
+std::shared_ptr<CachedQuery> QueryCache::Find(const std::string &signature) {
+  return cache_.Find(signature);
+}
+
+std::shared_ptr<CachedQuery> QueryCache::Add(
+    std::shared_ptr<planner::AbstractPlan> plan, std::unique_ptr<Query> query,
+    const QueryParameters &parameters) {
+  PL_ASSERT(query->IsParameterized());
+  PL_ASSERT(&query->GetPlan() == plan.get());
+
+  std::shared_ptr<CachedQuery> cached_query(new CachedQuery());
+  cached_query->signature = parameters.GetSignature();
+  cached_query->plan = plan;
+  cached_query->query = std::move(query);
+  cached_query->table_oids = parameters.GetTableOids();
+
+  // A query compiled concurrently for the same signature is replaced. The
+  // executions that found it hold on to it.
+  cache_.Insert(cached_query->signature, cached_query);
+  LOG_TRACE("Cached compiled query %s", cached_query->signature.c_str());
+  return cached_query;
+}
+
+void QueryCache::RemoveTable(oid_t database_oid, oid_t table_oid) {
+  RemoveIf([database_oid, table_oid](const CachedQuery &cached_query) {
+    for (const auto &oids : cached_query.table_oids) {
+      if (oids.first == database_oid && oids.second == table_oid) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+void QueryCache::RemoveDatabase(oid_t database_oid) {
+  RemoveIf([database_oid](const CachedQuery &cached_query) {
+    for (const auto &oids : cached_query.table_oids) {
+      if (oids.first == database_oid) {
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+void QueryCache::Clear() {
+  RemoveIf([](const CachedQuery &) { return true; });
+}
+
+size_t QueryCache::GetCount() { return cache_.GetSize(); }
+
+template <typename Predicate>
+void QueryCache::RemoveIf(Predicate predicate) {
+  cache_.EraseIf(
+      [&predicate](const std::string &,
+                   const std::shared_ptr<CachedQuery> &cached_query) {
+        return predicate(*cached_query);
+      });
+}
+
+}  // namespace codegen
+}  // namespace peloton
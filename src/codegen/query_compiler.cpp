@@ -13,28 +13,72 @@
 #include "codegen/query_compiler.h"
 
 #include "codegen/compilation_context.h"
+#include "codegen/object_cache.h"
+#include "codegen/query_parameters.h"
+#include "common/logger.h"
+#include "common/memory_tracker.h"
+#include "configuration/configuration.h"
+#include "expression/function_expression.h"
 #include "planner/seq_scan_plan.h"
 #include "planner/aggregate_plan.h"
 #include "planner/hash_join_plan.h"
+#include "planner/index_scan_plan.h"
+#include "planner/insert_plan.h"
+#include "planner/nested_loop_join_plan.h"
+#include "planner/set_op_plan.h"
+#include "planner/update_plan.h"
+#include "storage/data_table.h"
 
 namespace peloton {
 namespace codegen {
 
 // Constructor
-QueryCompiler::QueryCompiler() : next_id_(0) {}
+QueryCompiler::QueryCompiler(bool optimize)
+    : next_id_(0), optimize_(optimize) {}
 
 // Compile the given query statement
 std::unique_ptr<Query> QueryCompiler::Compile(
     const planner::AbstractPlan &root, QueryResultConsumer &result_consumer,
-    CompileStats *stats) {
+    CompileStats *stats, const QueryParameters *parameters) {
+  // What the query keeps of its compilation is charged to codegen
+  MemoryScope memory_scope;
+
   // The query statement we compile
   std::unique_ptr<Query> query{new Query(root)};
+  query->parameterized_ = (parameters != nullptr);
+  query->optimized_ = optimize_;
+
+  // The code of a parameterized query is kept for the processes started
+  // later, which load it instead of compiling it
+  if (parameters != nullptr && ObjectCache::GetInstance().IsEnabled()) {
+    query->GetCodeContext().SetObjectCacheKey(
+        ObjectCache::GetKey(*parameters, optimize_));
+  }
 
-  // Set up the compilation context
-  CompilationContext context{*query, result_consumer};
+  {
+    // Set up the compilation context
+    CompilationContext context{*query, result_consumer, parameters};
 
-  // Perform the compilation
-  context.GeneratePlan(stats);
+    // Perform the compilation
+    context.GeneratePlan(stats);
+  }
+
+  // Dump the IR of the plan asked for, as it was compiled
+  if (FLAGS_codegen_dump_ir_plan != 0) {
+    uint64_t plan_hash = parameters != nullptr
+                             ? parameters->GetPlanHash()
+                             : QueryParameters{root}.GetPlanHash();
+    if (plan_hash == FLAGS_codegen_dump_ir_plan) {
+      std::string file_name = "dump_plan_" + std::to_string(plan_hash) + ".ll";
+      LOG_INFO("Writing the IR of plan %llu to %s",
+               (unsigned long long)plan_hash, file_name.c_str());
+      query->GetCodeContext().DumpIR(file_name);
+    }
+  }
+
+  query->memory_footprint_ = memory_scope.GetAllocatedBytes();
+  MemoryTracker::Allocate(MemoryComponentType::CODEGEN,
+                          query->memory_footprint_);
 
   // Return the compiled query statement
   return query;
@@ -49,15 +93,68 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan,
                                 const planner::AbstractPlan *parent) {
   switch (plan.GetPlanNodeType()) {
     case PlanNodeType::SEQSCAN:
+    case PlanNodeType::INDEXSCAN: {
+      // The generated scan groups the tuples by tile group, which loses the
+      // key order
+      const auto &scan_plan = static_cast<const planner::IndexScanPlan &>(plan);
+      if (scan_plan.IsKeyOrdered()) {
+        return false;
+      }
+      break;
+    }
     case PlanNodeType::ORDERBY:
-    case PlanNodeType::DELETE:
+    case PlanNodeType::LIMIT:
+    case PlanNodeType::DELETE: {
+      break;
+    }
     case PlanNodeType::AGGREGATE_V2: {
+      // The approximate aggregates are only implemented by the executors
+      const auto &agg_plan = static_cast<const planner::AggregatePlan &>(plan);
+      for (const auto &agg_term : agg_plan.GetUniqueAggTerms()) {
+        if (agg_term.aggtype ==
+            ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT) {
+          return false;
+        }
+      }
       break;
     }
     case PlanNodeType::PROJECTION: {
       if (plan.GetChildren().size() == 0) return false;
       break;
     }
+    case PlanNodeType::INSERT: {
+      // Inserts either take the tuples of their child, or of the plan. Values
+      // that need a projection are evaluated by the executor.
+      const auto &insert_plan = static_cast<const planner::InsertPlan &>(plan);
+      if (insert_plan.GetChildren().empty() &&
+          insert_plan.GetTuple(0) == nullptr) {
+        return false;
+      }
+      break;
+    }
+    case PlanNodeType::UPDATE: {
+      const auto &update_plan = static_cast<const planner::UpdatePlan &>(plan);
+      if (!IsUpdateSupported(update_plan)) return false;
+      break;
+    }
+    case PlanNodeType::NESTLOOP: {
+      const auto &nljp = static_cast<const planner::NestedLoopJoinPlan &>(plan);
+      // Right now, only support inner joins
+      if (nljp.GetJoinType() != JoinType::INNER) return false;
+      break;
+    }
+    case PlanNodeType::SETOP: {
+      const auto &set_op_plan = static_cast<const planner::SetOpPlan &>(plan);
+      switch (set_op_plan.GetSetOp()) {
+        case SetOpType::INTERSECT:
+        case SetOpType::INTERSECT_ALL:
+        case SetOpType::EXCEPT:
+        case SetOpType::EXCEPT_ALL:
+          break;
+        default: { return false; }
+      }
+      break;
+    }
     case PlanNodeType::HASHJOIN: {
       const auto &hjp = static_cast<const planner::HashJoinPlan &>(plan);
       // Right now, only support inner joins
@@ -83,6 +180,11 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan,
       pred = scan_plan.GetPredicate();
       break;
     }
+    case PlanNodeType::INDEXSCAN: {
+      auto &scan_plan = static_cast<const planner::IndexScanPlan &>(plan);
+      pred = scan_plan.GetPredicate();
+      break;
+    }
     case PlanNodeType::AGGREGATE_V2: {
       auto &agg_plan = static_cast<const planner::AggregatePlan &>(plan);
       pred = agg_plan.GetPredicate();
@@ -93,6 +195,11 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan,
       pred = hj_plan.GetPredicate();
       break;
     }
+    case PlanNodeType::NESTLOOP: {
+      auto &nlj_plan = static_cast<const planner::NestedLoopJoinPlan &>(plan);
+      pred = nlj_plan.GetPredicate();
+      break;
+    }
     default: { break; }
   }
 
@@ -111,13 +218,48 @@ bool QueryCompiler::IsSupported(const planner::AbstractPlan &plan,
   return true;
 }
 
+// The SET expressions and the direct maps of an update refer to the columns of
+// the table, so the child must be a scan that produces all of them in order
+bool QueryCompiler::IsUpdateSupported(const planner::UpdatePlan &plan) {
+  if (plan.GetChildren().size() != 1) return false;
+  // The updater inserts the new tuples of a key update into its own table
+  if (plan.GetInsertTable() != plan.GetTable()) return false;
+  const auto &child = *plan.GetChild(0);
+  if (child.GetPlanNodeType() != PlanNodeType::SEQSCAN &&
+      child.GetPlanNodeType() != PlanNodeType::INDEXSCAN) {
+    return false;
+  }
+  const auto &scan_plan = static_cast<const planner::AbstractScan &>(child);
+  const auto &column_ids = scan_plan.GetColumnIds();
+  for (oid_t i = 0; i < column_ids.size(); i++) {
+    if (column_ids[i] != i) return false;
+  }
+  if (!column_ids.empty() &&
+      column_ids.size() != plan.GetTable()->GetSchema()->GetColumnCount()) {
+    return false;
+  }
+
+  for (const auto &target : plan.GetProjectInfo()->GetTargetList()) {
+    if (!IsExpressionSupported(*target.second.expr)) return false;
+  }
+  return true;
+}
+
 bool QueryCompiler::IsExpressionSupported(
     const expression::AbstractExpression &expr) {
   switch (expr.GetExpressionType()) {
     case ExpressionType::STAR:
-    case ExpressionType::FUNCTION:
     case ExpressionType::VALUE_PARAMETER:
       return false;
+    case ExpressionType::FUNCTION: {
+      // Only functions resolved to a built-in function can be called
+      const auto &func_expr =
+          static_cast<const expression::FunctionExpression &>(expr);
+      if (func_expr.GetFunc() == nullptr) {
+        return false;
+      }
+      break;
+    }
     default:
       break;
   }
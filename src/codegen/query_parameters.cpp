@@ -0,0 +1,397 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_parameters.cpp
+//
+// Identification: src/codegen/query_parameters.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_parameters.h"
+
+#include <numeric>
+
+#include "expression/case_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/function_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/delete_plan.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/index_scan_plan.h"
+#include "planner/insert_plan.h"
+#include "planner/limit_plan.h"
+#include "planner/nested_loop_join_plan.h"
+#include "planner/order_by_plan.h"
+#include "planner/projection_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "planner/set_op_plan.h"
+#include "planner/update_plan.h"
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "type/value_peeker.h"
+
+namespace peloton {
+namespace codegen {
+
+static_assert(sizeof(QueryParameters::Parameter) == 16,
+              "The compiled code expects 16 byte parameter slots");
+
+// Constructor
+QueryParameters::QueryParameters(const planner::AbstractPlan &plan) {
+  CollectPlan(plan);
+}
+
+uint32_t QueryParameters::GetParameterIndex(
+    const expression::AbstractExpression *exp) const {
+  auto iter = parameter_indexes_.find(exp);
+  PL_ASSERT(iter != parameter_indexes_.end());
+  return iter->second;
+}
+
+uint32_t QueryParameters::GetPlanIndex(
+    const planner::AbstractPlan *plan) const {
+  auto iter = plan_indexes_.find(plan);
+  PL_ASSERT(iter != plan_indexes_.end());
+  return iter->second;
+}
+
+// Walk the plan in the order the signature is built in. Everything the
+// translators read from a node goes into the signature, except for the values
+// that are passed as parameters.
+void QueryParameters::CollectPlan(const planner::AbstractPlan &plan) {
+  AppendToSignature(static_cast<int64_t>(plan.GetPlanNodeType()));
+
+  switch (plan.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN: {
+      auto &scan_plan = static_cast<const planner::SeqScanPlan &>(plan);
+      auto *table = scan_plan.GetTable();
+      table_oids_.emplace_back(table->GetDatabaseOid(), table->GetOid());
+      AppendToSignature(table->GetDatabaseOid());
+      AppendToSignature(table->GetOid());
+      // The binding fills in all the columns if there are none, which must
+      // not change the signature
+      std::vector<oid_t> column_ids = scan_plan.GetColumnIds();
+      if (column_ids.empty() && scan_plan.GetChildren().empty()) {
+        column_ids.resize(table->GetSchema()->GetColumnCount());
+        std::iota(column_ids.begin(), column_ids.end(), 0);
+      }
+      AppendToSignature(column_ids);
+      CollectPredicate(scan_plan.GetPredicate());
+      break;
+    }
+    case PlanNodeType::INDEXSCAN: {
+      auto &scan_plan = static_cast<const planner::IndexScanPlan &>(plan);
+      auto *table = scan_plan.GetTable();
+      table_oids_.emplace_back(table->GetDatabaseOid(), table->GetOid());
+      AppendToSignature(table->GetDatabaseOid());
+      AppendToSignature(table->GetOid());
+      AppendToSignature(scan_plan.GetIndex()->GetOid());
+      std::vector<oid_t> column_ids = scan_plan.GetColumnIds();
+      if (column_ids.empty()) {
+        column_ids.resize(table->GetSchema()->GetColumnCount());
+        std::iota(column_ids.begin(), column_ids.end(), 0);
+      }
+      AppendToSignature(column_ids);
+      CollectPredicate(scan_plan.GetPredicate());
+      // The keys are only read by the index scanner at runtime, from the plan
+      // the query runs for
+      AddPlanParameter(&plan);
+      break;
+    }
+    case PlanNodeType::PROJECTION: {
+      auto &projection_plan =
+          static_cast<const planner::ProjectionPlan &>(plan);
+      AppendToSignature(projection_plan.GetColumnIds());
+      CollectProjectInfo(projection_plan.GetProjectInfo());
+      break;
+    }
+    case PlanNodeType::HASHJOIN: {
+      auto &join_plan = static_cast<const planner::HashJoinPlan &>(plan);
+      AppendToSignature(static_cast<int64_t>(join_plan.GetJoinType()));
+      AppendToSignature(join_plan.GetOuterHashIds());
+      std::vector<const expression::AbstractExpression *> left_keys;
+      std::vector<const expression::AbstractExpression *> right_keys;
+      join_plan.GetLeftHashKeys(left_keys);
+      join_plan.GetRightHashKeys(right_keys);
+      AppendToSignature(left_keys.size());
+      for (const auto *key : left_keys) {
+        CollectExpression(key);
+      }
+      AppendToSignature(right_keys.size());
+      for (const auto *key : right_keys) {
+        CollectExpression(key);
+      }
+      CollectExpression(join_plan.GetPredicate());
+      CollectProjectInfo(join_plan.GetProjInfo());
+      break;
+    }
+    case PlanNodeType::NESTLOOP: {
+      auto &join_plan = static_cast<const planner::NestedLoopJoinPlan &>(plan);
+      AppendToSignature(static_cast<int64_t>(join_plan.GetJoinType()));
+      CollectExpression(join_plan.GetPredicate());
+      CollectProjectInfo(join_plan.GetProjInfo());
+      break;
+    }
+    case PlanNodeType::HASH: {
+      auto &hash_plan = static_cast<const planner::HashPlan &>(plan);
+      AppendToSignature(hash_plan.GetHashKeys().size());
+      for (const auto &key : hash_plan.GetHashKeys()) {
+        CollectExpression(key.get());
+      }
+      break;
+    }
+    case PlanNodeType::AGGREGATE_V2: {
+      auto &agg_plan = static_cast<const planner::AggregatePlan &>(plan);
+      AppendToSignature(static_cast<int64_t>(agg_plan.GetAggregateStrategy()));
+      AppendToSignature(agg_plan.GetGroupbyColIds());
+      AppendToSignature(agg_plan.GetUniqueAggTerms().size());
+      for (const auto &agg_term : agg_plan.GetUniqueAggTerms()) {
+        AppendToSignature(static_cast<int64_t>(agg_term.aggtype));
+        AppendToSignature(agg_term.distinct);
+        CollectExpression(agg_term.expression);
+      }
+      CollectExpression(agg_plan.GetPredicate());
+      CollectProjectInfo(agg_plan.GetProjectInfo());
+      break;
+    }
+    case PlanNodeType::ORDERBY: {
+      auto &order_by_plan = static_cast<const planner::OrderByPlan &>(plan);
+      AppendToSignature(order_by_plan.GetSortKeys());
+      const auto &descend_flags = order_by_plan.GetDescendFlags();
+      AppendToSignature(descend_flags.size());
+      for (bool descend : descend_flags) {
+        AppendToSignature(descend);
+      }
+      AppendToSignature(order_by_plan.GetOutputColumnIds());
+      AppendToSignature(order_by_plan.GetLimit());
+      AppendToSignature(order_by_plan.GetLimitNumber());
+      AppendToSignature(order_by_plan.GetLimitOffset());
+      break;
+    }
+    case PlanNodeType::LIMIT: {
+      auto &limit_plan = static_cast<const planner::LimitPlan &>(plan);
+      AppendToSignature(static_cast<int64_t>(limit_plan.GetLimit()));
+      AppendToSignature(static_cast<int64_t>(limit_plan.GetOffset()));
+      break;
+    }
+    case PlanNodeType::SETOP: {
+      auto &set_op_plan = static_cast<const planner::SetOpPlan &>(plan);
+      AppendToSignature(static_cast<int64_t>(set_op_plan.GetSetOp()));
+      break;
+    }
+    case PlanNodeType::DELETE: {
+      auto &delete_plan = static_cast<const planner::DeletePlan &>(plan);
+      auto *table = delete_plan.GetTable();
+      table_oids_.emplace_back(table->GetDatabaseOid(), table->GetOid());
+      AppendToSignature(table->GetDatabaseOid());
+      AppendToSignature(table->GetOid());
+      AppendToSignature(delete_plan.GetTruncate());
+      break;
+    }
+    case PlanNodeType::INSERT: {
+      auto &insert_plan = static_cast<const planner::InsertPlan &>(plan);
+      auto *table = insert_plan.GetTable();
+      table_oids_.emplace_back(table->GetDatabaseOid(), table->GetOid());
+      AppendToSignature(table->GetDatabaseOid());
+      AppendToSignature(table->GetOid());
+      // The materialized tuples are inserted by the inserter at runtime, from
+      // the plan the query runs for
+      if (insert_plan.GetChildren().empty()) {
+        AddPlanParameter(&plan);
+      }
+      break;
+    }
+    case PlanNodeType::UPDATE: {
+      auto &update_plan = static_cast<const planner::UpdatePlan &>(plan);
+      auto *table = update_plan.GetTable();
+      table_oids_.emplace_back(table->GetDatabaseOid(), table->GetOid());
+      AppendToSignature(table->GetDatabaseOid());
+      AppendToSignature(table->GetOid());
+      AppendToSignature(update_plan.GetUpdatePrimaryKey());
+      CollectProjectInfo(update_plan.GetProjectInfo());
+      AddPlanParameter(&plan);
+      break;
+    }
+    default: { break; }
+  }
+
+  AppendToSignature(plan.GetChildren().size());
+  for (const auto &child : plan.GetChildren()) {
+    CollectPlan(*child);
+  }
+}
+
+void QueryParameters::CollectProjectInfo(
+    const planner::ProjectInfo *project_info) {
+  if (project_info == nullptr) {
+    AppendToSignature(-1);
+    return;
+  }
+
+  const auto &target_list = project_info->GetTargetList();
+  AppendToSignature(target_list.size());
+  for (const auto &target : target_list) {
+    AppendToSignature(target.first);
+    CollectExpression(target.second.expr);
+  }
+
+  const auto &direct_map_list = project_info->GetDirectMapList();
+  AppendToSignature(direct_map_list.size());
+  for (const auto &direct_map : direct_map_list) {
+    AppendToSignature(direct_map.first);
+    AppendToSignature(direct_map.second.first);
+    AppendToSignature(direct_map.second.second);
+  }
+}
+
+void QueryParameters::CollectExpression(
+    const expression::AbstractExpression *exp) {
+  if (exp == nullptr) {
+    AppendToSignature(-1);
+    return;
+  }
+
+  AppendToSignature(static_cast<int64_t>(exp->GetExpressionType()));
+  AppendToSignature(static_cast<int64_t>(exp->GetValueType()));
+
+  switch (exp->GetExpressionType()) {
+    case ExpressionType::VALUE_CONSTANT: {
+      AddParameter(exp);
+      break;
+    }
+    case ExpressionType::VALUE_TUPLE: {
+      auto *tve = static_cast<const expression::TupleValueExpression *>(exp);
+      AppendToSignature(tve->GetTupleId());
+      AppendToSignature(tve->GetColumnId());
+      break;
+    }
+    case ExpressionType::OPERATOR_CASE_EXPR: {
+      auto *case_exp = static_cast<const expression::CaseExpression *>(exp);
+      AppendToSignature(case_exp->GetWhenClauseSize());
+      for (size_t i = 0; i < case_exp->GetWhenClauseSize(); i++) {
+        CollectExpression(case_exp->GetWhenClauseCond(i));
+        CollectExpression(case_exp->GetWhenClauseResult(i));
+      }
+      CollectExpression(case_exp->GetDefault());
+      break;
+    }
+    case ExpressionType::FUNCTION: {
+      // The compiled query calls the function it was compiled for
+      auto *func_exp = static_cast<const expression::FunctionExpression *>(exp);
+      AppendToSignature(reinterpret_cast<int64_t>(func_exp->GetFunc()));
+      break;
+    }
+    default: { break; }
+  }
+
+  AppendToSignature(exp->GetChildrenSize());
+  for (size_t i = 0; i < exp->GetChildrenSize(); i++) {
+    CollectExpression(exp->GetChild(i));
+  }
+}
+
+void QueryParameters::CollectPredicate(
+    const expression::AbstractExpression *predicate) {
+  CollectExpression(predicate);
+  if (predicate != nullptr) {
+    AddParameter(predicate);
+  }
+}
+
+void QueryParameters::AppendToSignature(int64_t token) {
+  signature_.append(std::to_string(token));
+  signature_.push_back(',');
+}
+
+// Lists are prefixed with their length, so that the signature of a plan never
+// is the signature of another one
+void QueryParameters::AppendToSignature(const std::vector<oid_t> &tokens) {
+  AppendToSignature(tokens.size());
+  for (oid_t token : tokens) {
+    AppendToSignature(token);
+  }
+}
+
+// Add a slot for the value of the given constant, or for the pointer to the
+// given predicate
+uint32_t QueryParameters::AddParameter(
+    const expression::AbstractExpression *exp) {
+  auto index = static_cast<uint32_t>(parameters_.size());
+  parameters_.emplace_back();
+  auto &parameter = parameters_.back();
+  PL_MEMSET(&parameter, 0, sizeof(Parameter));
+  parameter_indexes_[exp] = index;
+
+  if (exp->GetExpressionType() != ExpressionType::VALUE_CONSTANT) {
+    parameter.value.pointer = exp;
+    return index;
+  }
+
+  const peloton::type::Value &constant =
+      static_cast<const expression::ConstantValueExpression *>(exp)->GetValue();
+  switch (constant.GetTypeId()) {
+    case peloton::type::TypeId::TINYINT: {
+      parameter.value.tinyint =
+          peloton::type::ValuePeeker::PeekTinyInt(constant);
+      break;
+    }
+    case peloton::type::TypeId::SMALLINT: {
+      parameter.value.smallint =
+          peloton::type::ValuePeeker::PeekSmallInt(constant);
+      break;
+    }
+    case peloton::type::TypeId::INTEGER: {
+      parameter.value.integer =
+          peloton::type::ValuePeeker::PeekInteger(constant);
+      break;
+    }
+    case peloton::type::TypeId::BIGINT: {
+      parameter.value.bigint = peloton::type::ValuePeeker::PeekBigInt(constant);
+      break;
+    }
+    case peloton::type::TypeId::DECIMAL: {
+      parameter.value.decimal =
+          peloton::type::ValuePeeker::PeekDouble(constant);
+      break;
+    }
+    case peloton::type::TypeId::DATE: {
+      parameter.value.integer = peloton::type::ValuePeeker::PeekDate(constant);
+      break;
+    }
+    case peloton::type::TypeId::TIMESTAMP: {
+      parameter.value.bigint =
+          peloton::type::ValuePeeker::PeekTimestamp(constant);
+      break;
+    }
+    case peloton::type::TypeId::VARCHAR: {
+      // The deque never moves the strings it holds
+      strings_.push_back(peloton::type::ValuePeeker::PeekVarchar(constant));
+      parameter.value.varchar = strings_.back().c_str();
+      parameter.length = static_cast<uint32_t>(strings_.back().length());
+      break;
+    }
+    default: {
+      // The translator rejects the constant when the plan is compiled
+      break;
+    }
+  }
+  return index;
+}
+
+uint32_t QueryParameters::AddPlanParameter(const planner::AbstractPlan *plan) {
+  auto index = static_cast<uint32_t>(parameters_.size());
+  parameters_.emplace_back();
+  auto &parameter = parameters_.back();
+  PL_MEMSET(&parameter, 0, sizeof(Parameter));
+  parameter.value.pointer = plan;
+  plan_indexes_[plan] = index;
+  return index;
+}
+
+}  // namespace codegen
+}  // namespace peloton
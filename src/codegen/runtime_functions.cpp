@@ -16,9 +16,14 @@
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "executor/executor_context.h"
+#include "expression/conjunction_order.h"
 #include "storage/data_table.h"
+#include "storage/frozen_tile_group.h"
 #include "storage/tile_group.h"
 #include "storage/tile.h"
+#include "storage/zone_map.h"
+#include "type/varlen_type.h"
 
 namespace peloton {
 namespace codegen {
@@ -56,15 +61,55 @@ uint64_t RuntimeFunctions::HashCrc64(const char *buf, uint64_t length,
 }
 
 //===----------------------------------------------------------------------===//
-// Get the tile group with the given index from the table.
-//
-// TODO: DataTable::GetTileGroup() returns a std::shared_ptr<> that we strip
-//       off. This means we could be touching free'd data. This must be fixed.
+// Get the tile group with the given index from the table. The query runs in
+// the epoch of its transaction, so a tile group dropped meanwhile is only
+// released after the query is done with it.
 //===----------------------------------------------------------------------===//
 storage::TileGroup *RuntimeFunctions::GetTileGroup(storage::DataTable *table,
                                                    oid_t tile_group_index) {
-  auto tile_group = table->GetTileGroup(tile_group_index);
-  return tile_group.get();
+  return table->ResolveTileGroup(tile_group_index);
+}
+
+//===----------------------------------------------------------------------===//
+// Check whether any tuple in the tile group can satisfy the scan predicate.
+// Tile groups that were dropped from the table (nullptr) are skipped.
+//===----------------------------------------------------------------------===//
+bool RuntimeFunctions::ZoneMapCanSatisfy(
+    const storage::TileGroup *tile_group,
+    const expression::AbstractExpression *predicate,
+    executor::ExecutorContext *executor_context) {
+  // the tile group was dropped by the compactor
+  if (tile_group == nullptr) {
+    return false;
+  }
+  return tile_group->GetZoneMap()->CanSatisfy(predicate, executor_context);
+}
+
+//===----------------------------------------------------------------------===//
+// Frozen tile groups are immutable, so the tuples their encoded columns rule
+// out never satisfy the predicate. The scan still evaluates the predicate on
+// the remaining tuples, since only some of its parts are handled here.
+//===----------------------------------------------------------------------===//
+uint32_t RuntimeFunctions::FilterFrozenTuples(
+    const storage::TileGroup *tile_group,
+    const expression::AbstractExpression *predicate,
+    executor::ExecutorContext *executor_context, uint32_t *selection,
+    uint32_t count) {
+  auto frozen_tile_group = tile_group->GetFrozenTileGroup();
+  if (frozen_tile_group == nullptr) {
+    return count;
+  }
+  return frozen_tile_group->FilterTuples(predicate, executor_context,
+                                         selection, count);
+}
+
+//===----------------------------------------------------------------------===//
+// The zone map counts every NULL written into the tile group, including the
+// ones of older versions and deleted tuples. A tile group without any can be
+// scanned without checking its values for NULL.
+//===----------------------------------------------------------------------===//
+bool RuntimeFunctions::TileGroupHasNulls(const storage::TileGroup *tile_group) {
+  return tile_group->GetZoneMap()->HasNulls();
 }
 
 //===----------------------------------------------------------------------===//
@@ -72,10 +117,40 @@ storage::TileGroup *RuntimeFunctions::GetTileGroup(storage::DataTable *table,
 // column in the provided 'infos' array.  Specifically, we need a pointer to
 // where the first value of the column can be found, and the amount of bytes
 // to skip over to find successive values of the column.
+//
+// A tile group whose tuple slots were released is read from its frozen copy:
+// the columns are decoded into tuple slots in the pool of the query, which
+// lives as long as every value the query keeps pointing into them.
 //===----------------------------------------------------------------------===//
-void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
-                                          ColumnLayoutInfo *infos,
-                                          uint32_t num_cols) {
+void RuntimeFunctions::GetTileGroupLayout(
+    const storage::TileGroup *tile_group, ColumnLayoutInfo *infos,
+    uint32_t num_cols, executor::ExecutorContext *executor_context) {
+  auto frozen_tile_group = executor_context != nullptr &&
+                                   tile_group->IsReleased() == true
+                               ? tile_group->GetFrozenTileGroup()
+                               : nullptr;
+  if (frozen_tile_group != nullptr) {
+    auto *schema = tile_group->GetAbstractTable()->GetSchema();
+    auto *pool = executor_context->GetPool();
+    uint32_t tuple_length = schema->GetLength();
+    oid_t tuple_count = frozen_tile_group->GetTupleCount();
+    char *slots =
+        static_cast<char *>(pool->Allocate(tuple_count * tuple_length));
+    for (uint32_t col_idx = 0; col_idx < num_cols; col_idx++) {
+      infos[col_idx].column = slots + schema->GetOffset(col_idx);
+      infos[col_idx].stride = tuple_length;
+      infos[col_idx].is_columnar = num_cols == 1;
+
+      bool is_inlined = schema->IsInlined(col_idx);
+      for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+        peloton::type::VarlenType::SerializeToTile(
+            frozen_tile_group->GetValue(tuple_id, col_idx),
+            infos[col_idx].column + tuple_id * tuple_length, is_inlined, pool);
+      }
+    }
+    return;
+  }
+
   for (uint32_t col_idx = 0; col_idx < num_cols; col_idx++) {
     // Map the current column to a tile and a column offset in the tile
     oid_t tile_offset, tile_column_offset;
@@ -94,6 +169,42 @@ void RuntimeFunctions::GetTileGroupLayout(const storage::TileGroup *tile_group,
   }
 }
 
+//===----------------------------------------------------------------------===//
+// Hand the scan of a parallel pipeline over to the morsel scheduler
+//===----------------------------------------------------------------------===//
+void RuntimeFunctions::ExecuteParallelScan(
+    concurrency::Transaction *txn, char *runtime_state, uint64_t state_size,
+    uint64_t num_tile_groups, MorselScheduler::ScanFunction scan_func,
+    MorselScheduler::InitFunction init_func,
+    MorselScheduler::MergeFunction merge_func, uint64_t num_partitions,
+    MorselScheduler::MergePartitionFunction merge_partition_func) {
+  MorselScheduler::GetInstance().ExecuteParallelScan(
+      *txn, runtime_state, state_size, num_tile_groups, scan_func, init_func,
+      merge_func, num_partitions, merge_partition_func);
+}
+
+expression::ConjunctionOrder *RuntimeFunctions::CreateConjunctionOrder(
+    const expression::AbstractExpression *predicate) {
+  return new expression::ConjunctionOrder(predicate);
+}
+
+void RuntimeFunctions::DestroyConjunctionOrder(
+    expression::ConjunctionOrder *order) {
+  delete order;
+}
+
+uint64_t RuntimeFunctions::GetConjunctionOrder(
+    const expression::ConjunctionOrder *order) {
+  return order->GetOrder();
+}
+
+// Compiled terms are not timed, their cost is estimated
+void RuntimeFunctions::RecordConjunctionTerm(
+    expression::ConjunctionOrder *order, uint32_t term, uint32_t num_tuples,
+    uint32_t num_passed) {
+  order->Record(term, num_tuples, num_tuples - num_passed);
+}
+
 void RuntimeFunctions::ThrowDivideByZeroException() {
   throw DivideByZeroException("ERROR: division by zero");
 }
@@ -37,6 +37,12 @@ RuntimeState::StateID RuntimeState::RegisterState(std::string name,
 
 llvm::Value *RuntimeState::LoadStatePtr(CodeGen &codegen,
                                         RuntimeState::StateID state_id) const {
+  return LoadStatePtr(codegen, state_id, codegen.GetState());
+}
+
+llvm::Value *RuntimeState::LoadStatePtr(CodeGen &codegen,
+                                        RuntimeState::StateID state_id,
+                                        llvm::Value *runtime_state) const {
   // At this point, the runtime state type must have been finalized. Otherwise,
   // it'd be impossible for us to index into it because the type would be
   // incomplete.
@@ -49,7 +55,6 @@ llvm::Value *RuntimeState::LoadStatePtr(CodeGen &codegen,
 
   // We index into the runtime state to get a pointer to the state
   std::string ptr_name{state_info.name + "Ptr"};
-  llvm::Value *runtime_state = codegen.GetState();
   llvm::Value *state_ptr = codegen->CreateConstInBoundsGEP2_32(
       constructed_type_, runtime_state, 0, state_info.index, ptr_name);
   return state_ptr;
@@ -124,5 +129,23 @@ void RuntimeState::CreateLocalState(CodeGen &codegen) {
   }
 }
 
+std::vector<llvm::Value *> RuntimeState::GetLocalState() const {
+  std::vector<llvm::Value *> local_state;
+  for (const auto &state_info : state_slots_) {
+    local_state.push_back(state_info.local ? state_info.val : nullptr);
+  }
+  return local_state;
+}
+
+void RuntimeState::SetLocalState(
+    const std::vector<llvm::Value *> &local_state) {
+  PL_ASSERT(local_state.size() == state_slots_.size());
+  for (uint32_t i = 0; i < state_slots_.size(); i++) {
+    if (state_slots_[i].local) {
+      state_slots_[i].val = local_state[i];
+    }
+  }
+}
+
 }  // namespace codegen
 }  // namespace peloton
\ No newline at end of file
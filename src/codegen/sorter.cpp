@@ -63,6 +63,24 @@ void Sorter::Append(CodeGen &codegen, llvm::Value *sorter_ptr,
   null_bitmap.WriteBack(codegen);
 }
 
+// Append the tuple, then let util::Sorter::StoreInputTupleTopK(...) drop the
+// tuple that sorts last if there are more than top_k
+void Sorter::AppendTopK(CodeGen &codegen, llvm::Value *sorter_ptr,
+                        const std::vector<codegen::Value> &tuple,
+                        uint64_t top_k) const {
+  Append(codegen, sorter_ptr, tuple);
+  auto *top_k_func = SorterProxy::_StoreInputTupleTopK::GetFunction(codegen);
+  codegen.CallFunc(top_k_func, {sorter_ptr, codegen.Const64(top_k)});
+}
+
+// Just make a call to util::Sorter::TransferFrom(...)
+void Sorter::TransferFrom(CodeGen &codegen, llvm::Value *sorter_ptr,
+                          llvm::Value *other_sorter_ptr, uint64_t top_k) const {
+  auto *transfer_func = SorterProxy::_TransferFrom::GetFunction(codegen);
+  codegen.CallFunc(transfer_func,
+                   {sorter_ptr, other_sorter_ptr, codegen.Const64(top_k)});
+}
+
 // Just make a call to util::Sorter::Sort(...). This actually sorts the data
 // that has been inserted into the sorter instance.
 void Sorter::Sort(CodeGen &codegen, llvm::Value *sorter_ptr) const {
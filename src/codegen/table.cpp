@@ -14,6 +14,8 @@
 
 #include "catalog/schema.h"
 #include "codegen/proxy/data_table_proxy.h"
+#include "codegen/proxy/executor_context_proxy.h"
+#include "codegen/lang/if.h"
 #include "codegen/lang/loop.h"
 #include "codegen/proxy/runtime_functions_proxy.h"
 #include "storage/data_table.h"
@@ -52,14 +54,34 @@ llvm::Value *Table::GetTileGroup(CodeGen &codegen, llvm::Value *table_ptr,
 //
 // for (; tile_group_idx < num_tile_groups; ++tile_group_idx) {
 //   tile_group_ptr := GetTileGroup(table_ptr, tile_group_idx)
-//   consumer.TileGroupStart(tile_group_ptr);
-//   tile_group.TidScan(tile_group_ptr, column_layouts, vector_size, consumer);
-//   consumer.TileGroupEnd(tile_group_ptr);
+//   if (ZoneMapCanSatisfy(tile_group_ptr, predicate, executor_context)) {
+//     consumer.TileGroupStart(tile_group_ptr);
+//     tile_group.TidScan(tile_group_ptr, column_layouts, vector_size,
+//                        consumer);
+//     consumer.TileGroupEnd(tile_group_ptr);
+//   }
 // }
 //
 // @endcode
 void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
-                         uint32_t batch_size, ScanCallback &consumer) const {
+                         uint32_t batch_size, ScanCallback &consumer,
+                         llvm::Value *predicate_ptr,
+                         llvm::Value *executor_context_ptr) const {
+  // Get the number of tile groups in the given table
+  llvm::Value *num_tile_groups = GetTileGroupCount(codegen, table_ptr);
+
+  // Iterate over all tile groups in the table
+  GenerateScan(codegen, table_ptr, codegen.Const64(0), num_tile_groups,
+               batch_size, consumer, predicate_ptr, executor_context_ptr);
+}
+
+// Generate a scan over the tile groups in the range [tile_group_start,
+// tile_group_end). Parallel scans generate one over each morsel of tile groups.
+void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
+                         llvm::Value *tile_group_start,
+                         llvm::Value *tile_group_end, uint32_t batch_size,
+                         ScanCallback &consumer, llvm::Value *predicate_ptr,
+                         llvm::Value *executor_context_ptr) const {
   // First get the columns from the table the consumer needs. For every column,
   // we'll need to have a ColumnInfoLayout struct
   const uint32_t num_columns =
@@ -69,37 +91,63 @@ void Table::GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
       RuntimeFunctionsProxy::_ColumnLayoutInfo::GetType(codegen),
       codegen.Const32(num_columns));
 
-  // Get the number of tile groups in the given table
-  llvm::Value *tile_group_idx = codegen.Const64(0);
-  llvm::Value *num_tile_groups = GetTileGroupCount(codegen, table_ptr);
+  llvm::Value *tile_group_idx = tile_group_start;
 
-  // Iterate over all tile groups in the table
+  // Iterate over the tile groups in the range
   lang::Loop loop{codegen,
-                  codegen->CreateICmpULT(tile_group_idx, num_tile_groups),
+                  codegen->CreateICmpULT(tile_group_idx, tile_group_end),
                   {{"tileGroupIdx", tile_group_idx}}};
   {
     // Get the tile group with the given tile group ID
     tile_group_idx = loop.GetLoopVar(0);
     llvm::Value *tile_group_ptr =
         GetTileGroup(codegen, table_ptr, tile_group_idx);
-    llvm::Value *tile_group_id =
-        tile_group_.GetTileGroupId(codegen, tile_group_ptr);
 
-    // Invoke the consumer to let her know that we're starting to iterate over
-    // the tile group now
-    consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
+    // Check the zone map of the tile group, if there's a predicate. This also
+    // skips tile groups that were dropped from the table.
+    if (predicate_ptr == nullptr) {
+      predicate_ptr = codegen.NullPtr(codegen.CharPtrType());
+    } else {
+      PL_ASSERT(executor_context_ptr != nullptr);
+    }
+    if (executor_context_ptr == nullptr) {
+      executor_context_ptr = codegen.NullPtr(
+          ExecutorContextProxy::GetType(codegen)->getPointerTo());
+    }
+    llvm::Value *can_satisfy = codegen.CallFunc(
+        RuntimeFunctionsProxy::_ZoneMapCanSatisfy::GetFunction(codegen),
+        {tile_group_ptr, predicate_ptr, executor_context_ptr});
+
+    lang::If zone_map_check{codegen, can_satisfy};
+    {
+      llvm::Value *tile_group_id =
+          tile_group_.GetTileGroupId(codegen, tile_group_ptr);
+
+      // Invoke the consumer to let her know that we're starting to iterate
+      // over the tile group now
+      consumer.TileGroupStart(codegen, tile_group_id, tile_group_ptr);
 
-    // Generate the scan cover over the given tile group
-    tile_group_.GenerateTidScan(codegen, tile_group_ptr, column_layouts,
-                                batch_size, consumer);
+      // Generate the scan cover over the given tile group
+      tile_group_.GenerateTidScan(codegen, tile_group_ptr, column_layouts,
+                                  batch_size, consumer, executor_context_ptr);
 
-    // Invoke the consumer to let her know that we're done with this tile group
-    consumer.TileGroupFinish(codegen, tile_group_ptr);
+      // Invoke the consumer to let her know that we're done with this tile
+      // group
+      consumer.TileGroupFinish(codegen, tile_group_ptr);
+    }
+    zone_map_check.EndIf();
 
-    // Move to next tile group in the table
+    // Move to next tile group in the table, unless the consumer needs no more
+    // tuples
     tile_group_idx = codegen->CreateAdd(tile_group_idx, codegen.Const64(1));
-    loop.LoopEnd(codegen->CreateICmpULT(tile_group_idx, num_tile_groups),
-                 {tile_group_idx});
+    llvm::Value *more_tile_groups =
+        codegen->CreateICmpULT(tile_group_idx, tile_group_end);
+    llvm::Value *finished = consumer.IsFinished(codegen);
+    if (finished != nullptr) {
+      more_tile_groups = codegen->CreateAnd(more_tile_groups,
+                                            codegen->CreateNot(finished));
+    }
+    loop.LoopEnd(more_tile_groups, {tile_group_idx});
   }
 }
 
@@ -30,38 +30,102 @@ namespace codegen {
 TileGroup::TileGroup(const catalog::Schema &schema) : schema_(schema) {}
 
 // This method generates code to scan over all the tuples in the provided tile
-// group. The fourth argument is allocated stack space where ColumnLayoutInfo
+// group. The third argument is allocated stack space where ColumnLayoutInfo
 // structs are - we use this to acquire column layout information of this
-// tile group.
+// tile group. The executor context holds the columns decoded from frozen tile
+// groups, see RuntimeFunctions::GetTileGroupLayout().
 //
 // @code
 // col_layouts := GetColumnLayouts(tile_group_ptr, column_layouts)
 // num_tuples := GetNumTuples(tile_group_ptr)
 //
-// for (start := 0; start < num_tuples; start += vector_size) {
-//   end := min(start + vector_size, num_tuples)
-//   ProcessTuples(start, end, tile_group_ptr);
+// if (TileGroupHasNulls(tile_group_ptr)) {
+//   for (start := 0; start < num_tuples; start += vector_size) {
+//     end := min(start + vector_size, num_tuples)
+//     ProcessTuples(start, end, tile_group_ptr);
+//   }
+// } else {
+//   // Same loop, all columns are loaded as non-NULL
 // }
 // @endcode
 //
+// The check is only generated if the schema has nullable columns.
+//
 void TileGroup::GenerateTidScan(CodeGen &codegen, llvm::Value *tile_group_ptr,
                                 llvm::Value *column_layouts,
-                                uint32_t batch_size,
-                                ScanCallback &consumer) const {
+                                uint32_t batch_size, ScanCallback &consumer,
+                                llvm::Value *executor_context_ptr) const {
   // Get the column layouts
-  auto col_layouts = GetColumnLayouts(codegen, tile_group_ptr, column_layouts);
+  auto col_layouts = GetColumnLayouts(codegen, tile_group_ptr, column_layouts,
+                                      executor_context_ptr);
 
   llvm::Value *num_tuples = GetNumTuples(codegen, tile_group_ptr);
+  if (!HasNullableColumns()) {
+    GenerateTidScanLoop(codegen, num_tuples, col_layouts, batch_size, false,
+                        consumer);
+    return;
+  }
+
+  llvm::Value *has_nulls = codegen.CallFunc(
+      RuntimeFunctionsProxy::_TileGroupHasNulls::GetFunction(codegen),
+      {tile_group_ptr});
+  lang::If null_check{codegen, has_nulls, "hasNulls"};
+  {
+    GenerateTidScanLoop(codegen, num_tuples, col_layouts, batch_size, false,
+                        consumer);
+  }
+  null_check.ElseBlock("noNulls");
+  {
+    GenerateTidScanLoop(codegen, num_tuples, col_layouts, batch_size, true,
+                        consumer);
+  }
+  null_check.EndIf();
+}
+
+void TileGroup::GenerateTidScanLoop(
+    CodeGen &codegen, llvm::Value *num_tuples,
+    const std::vector<TileGroup::ColumnLayout> &col_layouts,
+    uint32_t batch_size, bool no_nulls, ScanCallback &consumer) const {
   lang::VectorizedLoop loop{codegen, num_tuples, batch_size, {}};
   {
     lang::VectorizedLoop::Range curr_range = loop.GetCurrentRange();
 
     // Pass the vector to the consumer
+    TileGroupAccess tile_group_access{*this, col_layouts, no_nulls};
+    consumer.ProcessTuples(codegen, curr_range.start, curr_range.end,
+                           tile_group_access);
+
+    loop.LoopEnd(codegen, {}, consumer.IsFinished(codegen));
+  }
+}
+
+bool TileGroup::HasNullableColumns() const {
+  for (oid_t col_id = 0; col_id < schema_.GetColumnCount(); col_id++) {
+    if (schema_.AllowNull(col_id)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TileGroup::GenerateTidListScan(CodeGen &codegen,
+                                    llvm::Value *tile_group_ptr,
+                                    llvm::Value *column_layouts,
+                                    llvm::Value *num_tids, uint32_t batch_size,
+                                    ScanCallback &consumer,
+                                    llvm::Value *executor_context_ptr) const {
+  auto col_layouts = GetColumnLayouts(codegen, tile_group_ptr, column_layouts,
+                                      executor_context_ptr);
+
+  lang::VectorizedLoop loop{codegen, num_tids, batch_size, {}};
+  {
+    lang::VectorizedLoop::Range curr_range = loop.GetCurrentRange();
+
     TileGroupAccess tile_group_access{*this, col_layouts};
     consumer.ProcessTuples(codegen, curr_range.start, curr_range.end,
                            tile_group_access);
 
-    loop.LoopEnd(codegen, {});
+    loop.LoopEnd(codegen, {}, consumer.IsFinished(codegen));
   }
 }
 
@@ -89,12 +153,14 @@ llvm::Value *TileGroup::GetTileGroupId(CodeGen &codegen,
 //===----------------------------------------------------------------------===//
 std::vector<TileGroup::ColumnLayout> TileGroup::GetColumnLayouts(
     CodeGen &codegen, llvm::Value *tile_group_ptr,
-    llvm::Value *column_layout_infos) const {
+    llvm::Value *column_layout_infos,
+    llvm::Value *executor_context_ptr) const {
   // Call RuntimeFunctions::GetTileGroupLayout()
   uint32_t num_cols = schema_.GetColumnCount();
   codegen.CallFunc(
       RuntimeFunctionsProxy::_GetTileGroupLayout::GetFunction(codegen),
-      {tile_group_ptr, column_layout_infos, codegen.Const32(num_cols)});
+      {tile_group_ptr, column_layout_infos, codegen.Const32(num_cols),
+       executor_context_ptr});
 
   // Collect <start, stride, is_columnar> triplets of all columns
   std::vector<TileGroup::ColumnLayout> layouts;
@@ -113,9 +179,9 @@ std::vector<TileGroup::ColumnLayout> TileGroup::GetColumnLayouts(
 }
 
 // Load a given column for the row with the given TID
-codegen::Value TileGroup::LoadColumn(
-    CodeGen &codegen, llvm::Value *tid,
-    const TileGroup::ColumnLayout &layout) const {
+codegen::Value TileGroup::LoadColumn(CodeGen &codegen, llvm::Value *tid,
+                                     const TileGroup::ColumnLayout &layout,
+                                     bool no_nulls) const {
   // We're calculating: col[tid] = col_start + (tid * col_stride)
   llvm::Value *col_address =
       codegen->CreateInBoundsGEP(codegen.ByteType(), layout.col_start_ptr,
@@ -129,9 +195,13 @@ codegen::Value TileGroup::LoadColumn(
   const auto &column = schema_.GetColumn(layout.col_id);
   const auto &sql_type = type::SqlType::LookupType(column.GetType());
 
+  // The type stays nullable in tile groups without NULLs, only the check is
+  // skipped
+  bool check_null = is_nullable && !no_nulls;
+
   // Check if it's a string or numeric value
   if (sql_type.IsVariableLength()) {
-    if (is_nullable) {
+    if (check_null) {
       codegen::Varlen::GetPtrAndLength(codegen, col_address, val, length,
                                        is_null);
     } else {
@@ -146,7 +216,7 @@ codegen::Value TileGroup::LoadColumn(
 
     val = codegen->CreateLoad(col_type, codegen->CreateBitCast(col_address, col_type->getPointerTo()));
 
-    if (is_nullable) {
+    if (check_null) {
       // To check for NULL, we need to perform a comparison between the value we
       // just read from the table with the NULL value for the column's type. We
       // need to be careful that the runtime type of both values is not NULL to
@@ -161,29 +231,106 @@ codegen::Value TileGroup::LoadColumn(
     }
   }
 
+  if (is_nullable && !check_null) {
+    is_null = codegen.ConstBool(false);
+  }
+
   // Names
   val->setName(column.GetName());
   if (length != nullptr) length->setName(column.GetName() + ".len");
-  if (is_null != nullptr) is_null->setName(column.GetName() + ".null");
+  if (check_null) is_null->setName(column.GetName() + ".null");
 
   // Return the value
   auto type = type::Type{column.GetType(), is_nullable};
   return codegen::Value{type, val, length, is_null};
 }
 
+// Load a given fixed-length column for the rows with the given vector of TIDs
+llvm::Value *TileGroup::LoadColumnVector(CodeGen &codegen, llvm::Value *tids,
+                                         uint32_t vector_size,
+                                         const TileGroup::ColumnLayout &layout,
+                                         bool no_nulls,
+                                         llvm::Value *&is_null) const {
+  // Column metadata
+  bool is_nullable = schema_.AllowNull(layout.col_id);
+  const auto &column = schema_.GetColumn(layout.col_id);
+  const auto &sql_type = type::SqlType::LookupType(column.GetType());
+  PL_ASSERT(!sql_type.IsVariableLength());
+
+  llvm::Type *col_type = nullptr, *col_len_type = nullptr;
+  sql_type.GetTypeForMaterialization(codegen, col_type, col_len_type);
+  PL_ASSERT(col_type != nullptr && col_len_type == nullptr);
+  llvm::Type *vector_type = llvm::VectorType::get(col_type, vector_size);
+
+  // The values of consecutive TIDs are adjacent if the column is stored in
+  // columnar form
+  llvm::Value *first_tid = codegen->CreateExtractElement(tids, codegen.Const32(0));
+  llvm::Value *last_tid =
+      codegen->CreateExtractElement(tids, codegen.Const32(vector_size - 1));
+  llvm::Value *consecutive = codegen->CreateICmpEQ(
+      codegen->CreateSub(last_tid, first_tid), codegen.Const32(vector_size - 1));
+  llvm::Value *columnar = codegen->CreateICmpEQ(
+      layout.col_stride, codegen.Const32(codegen.SizeOf(col_type)));
+
+  llvm::Value *vector_vals = nullptr, *gathered_vals = nullptr;
+  lang::If is_contiguous{codegen, codegen->CreateAnd(consecutive, columnar),
+                         "contiguousVals"};
+  {
+    llvm::Value *col_address = codegen->CreateInBoundsGEP(
+        codegen.ByteType(), layout.col_start_ptr,
+        codegen->CreateMul(first_tid, layout.col_stride));
+    vector_vals = codegen->CreateAlignedLoad(
+        codegen->CreateBitCast(col_address, vector_type->getPointerTo()), 1);
+  }
+  is_contiguous.ElseBlock("gatherVals");
+  {
+    gathered_vals = llvm::UndefValue::get(vector_type);
+    for (uint32_t i = 0; i < vector_size; i++) {
+      llvm::Value *tid = codegen->CreateExtractElement(tids, codegen.Const32(i));
+      llvm::Value *col_address = codegen->CreateInBoundsGEP(
+          codegen.ByteType(), layout.col_start_ptr,
+          codegen->CreateMul(tid, layout.col_stride));
+      llvm::Value *val = codegen->CreateLoad(
+          col_type,
+          codegen->CreateBitCast(col_address, col_type->getPointerTo()));
+      gathered_vals =
+          codegen->CreateInsertElement(gathered_vals, val, codegen.Const32(i));
+    }
+  }
+  is_contiguous.EndIf();
+  llvm::Value *vals = is_contiguous.BuildPHI(vector_vals, gathered_vals);
+  vals->setName(column.GetName());
+
+  // NULL values are stored as the NULL value of the column's type
+  is_null = nullptr;
+  if (is_nullable && !no_nulls) {
+    llvm::Value *null_vals = codegen->CreateVectorSplat(
+        vector_size, sql_type.GetNullValue(codegen).GetValue());
+    is_null = col_type->isFloatingPointTy()
+                  ? codegen->CreateFCmpOEQ(vals, null_vals)
+                  : codegen->CreateICmpEQ(vals, null_vals);
+    is_null->setName(column.GetName() + ".null");
+  }
+  return vals;
+}
+
 //===----------------------------------------------------------------------===//
 // TILE GROUP ROW
 //===----------------------------------------------------------------------===//
 
 TileGroup::TileGroupAccess::Row::Row(const TileGroup &tile_group,
                                      const std::vector<ColumnLayout> &layout,
-                                     llvm::Value *tid)
-    : tile_group_(tile_group), layout_(layout), tid_(tid) {}
+                                     bool no_nulls, llvm::Value *tid)
+    : tile_group_(tile_group),
+      layout_(layout),
+      no_nulls_(no_nulls),
+      tid_(tid) {}
 
 codegen::Value TileGroup::TileGroupAccess::Row::LoadColumn(
     CodeGen &codegen, uint32_t col_idx) const {
   PL_ASSERT(col_idx < layout_.size());
-  return tile_group_.LoadColumn(codegen, GetTID(), layout_[col_idx]);
+  return tile_group_.LoadColumn(codegen, GetTID(), layout_[col_idx],
+                                no_nulls_);
 }
 
 //===----------------------------------------------------------------------===//
@@ -192,12 +339,23 @@ codegen::Value TileGroup::TileGroupAccess::Row::LoadColumn(
 
 TileGroup::TileGroupAccess::TileGroupAccess(
     const TileGroup &tile_group,
-    const std::vector<TileGroup::ColumnLayout> &tile_group_layout)
-    : tile_group_(tile_group), layout_(tile_group_layout) {}
+    const std::vector<TileGroup::ColumnLayout> &tile_group_layout,
+    bool no_nulls)
+    : tile_group_(tile_group),
+      layout_(tile_group_layout),
+      no_nulls_(no_nulls) {}
 
 TileGroup::TileGroupAccess::Row TileGroup::TileGroupAccess::GetRow(
     llvm::Value *tid) const {
-  return TileGroup::TileGroupAccess::Row{tile_group_, layout_, tid};
+  return TileGroup::TileGroupAccess::Row{tile_group_, layout_, no_nulls_, tid};
+}
+
+llvm::Value *TileGroup::TileGroupAccess::LoadColumnVector(
+    CodeGen &codegen, llvm::Value *tids, uint32_t vector_size,
+    uint32_t col_idx, llvm::Value *&is_null) const {
+  PL_ASSERT(col_idx < layout_.size());
+  return tile_group_.LoadColumnVector(codegen, tids, vector_size,
+                                      layout_[col_idx], no_nulls_, is_null);
 }
 
 }  // namespace codegen
@@ -17,28 +17,43 @@
 #include "codegen/expression/comparison_translator.h"
 #include "codegen/expression/conjunction_translator.h"
 #include "codegen/expression/constant_translator.h"
+#include "codegen/expression/function_translator.h"
+#include "codegen/expression/like_translator.h"
 #include "codegen/operator/delete_translator.h"
 #include "codegen/operator/global_group_by_translator.h"
 #include "codegen/operator/hash_group_by_translator.h"
 #include "codegen/operator/hash_join_translator.h"
+#include "codegen/operator/index_scan_translator.h"
+#include "codegen/operator/insert_translator.h"
+#include "codegen/operator/limit_translator.h"
 #include "codegen/expression/negation_translator.h"
+#include "codegen/operator/nested_loop_join_translator.h"
 #include "codegen/operator/order_by_translator.h"
 #include "codegen/operator/projection_translator.h"
+#include "codegen/operator/set_op_translator.h"
 #include "codegen/operator/table_scan_translator.h"
+#include "codegen/operator/update_translator.h"
 #include "codegen/expression/tuple_value_translator.h"
 #include "expression/case_expression.h"
 #include "expression/comparison_expression.h"
 #include "expression/conjunction_expression.h"
 #include "expression/constant_value_expression.h"
+#include "expression/function_expression.h"
 #include "expression/operator_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "expression/aggregate_expression.h"
 #include "planner/aggregate_plan.h"
 #include "planner/delete_plan.h"
 #include "planner/hash_join_plan.h"
+#include "planner/index_scan_plan.h"
+#include "planner/insert_plan.h"
+#include "planner/limit_plan.h"
+#include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
+#include "planner/set_op_plan.h"
+#include "planner/update_plan.h"
 
 namespace peloton {
 namespace codegen {
@@ -56,6 +71,11 @@ std::unique_ptr<OperatorTranslator> TranslatorFactory::CreateTranslator(
       translator = new TableScanTranslator(scan, context, pipeline);
       break;
     }
+    case PlanNodeType::INDEXSCAN: {
+      auto &scan = static_cast<const planner::IndexScanPlan &>(plan_node);
+      translator = new IndexScanTranslator(scan, context, pipeline);
+      break;
+    }
     case PlanNodeType::PROJECTION: {
       auto &projection =
           static_cast<const planner::ProjectionPlan &>(plan_node);
@@ -67,6 +87,11 @@ std::unique_ptr<OperatorTranslator> TranslatorFactory::CreateTranslator(
       translator = new HashJoinTranslator(join, context, pipeline);
       break;
     }
+    case PlanNodeType::NESTLOOP: {
+      auto &join = static_cast<const planner::NestedLoopJoinPlan &>(plan_node);
+      translator = new NestedLoopJoinTranslator(join, context, pipeline);
+      break;
+    }
     case PlanNodeType::AGGREGATE_V2: {
       const auto &aggregate_plan =
           static_cast<const planner::AggregatePlan &>(plan_node);
@@ -87,12 +112,32 @@ std::unique_ptr<OperatorTranslator> TranslatorFactory::CreateTranslator(
       translator = new OrderByTranslator(order_by, context, pipeline);
       break;
     }
+    case PlanNodeType::LIMIT: {
+      auto &limit = static_cast<const planner::LimitPlan &>(plan_node);
+      translator = new LimitTranslator(limit, context, pipeline);
+      break;
+    }
+    case PlanNodeType::SETOP: {
+      auto &set_op = static_cast<const planner::SetOpPlan &>(plan_node);
+      translator = new SetOpTranslator(set_op, context, pipeline);
+      break;
+    }
     case PlanNodeType::DELETE: {
       auto &delete_plan = const_cast<planner::DeletePlan &>(
           static_cast<const planner::DeletePlan &>(plan_node));
       translator = new DeleteTranslator(delete_plan, context, pipeline);
       break;
     }
+    case PlanNodeType::INSERT: {
+      auto &insert_plan = static_cast<const planner::InsertPlan &>(plan_node);
+      translator = new InsertTranslator(insert_plan, context, pipeline);
+      break;
+    }
+    case PlanNodeType::UPDATE: {
+      auto &update_plan = static_cast<const planner::UpdatePlan &>(plan_node);
+      translator = new UpdateTranslator(update_plan, context, pipeline);
+      break;
+    }
     default: {
       throw Exception{"We don't have a translator for plan node type: " +
                       PlanNodeTypeToString(plan_node.GetPlanNodeType())};
@@ -133,6 +178,13 @@ std::unique_ptr<ExpressionTranslator> TranslatorFactory::CreateTranslator(
       translator = new ComparisonTranslator(cmp_exp, context);
       break;
     }
+    case ExpressionType::COMPARE_LIKE:
+    case ExpressionType::COMPARE_NOTLIKE: {
+      const auto &like_exp =
+          static_cast<const expression::ComparisonExpression &>(exp);
+      translator = new LikeTranslator(like_exp, context);
+      break;
+    }
     case ExpressionType::CONJUNCTION_AND:
     case ExpressionType::CONJUNCTION_OR: {
       const auto &conjunction_exp =
@@ -161,6 +213,12 @@ std::unique_ptr<ExpressionTranslator> TranslatorFactory::CreateTranslator(
       translator = new CaseTranslator(case_exp, context);
       break;
     }
+    case ExpressionType::FUNCTION: {
+      auto &func_exp =
+          static_cast<const expression::FunctionExpression &>(exp);
+      translator = new FunctionTranslator(func_exp, context);
+      break;
+    }
     default: {
       throw Exception{"We don't have a translator for expression type: " +
                       ExpressionTypeToString(exp.GetExpressionType())};
@@ -0,0 +1,230 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// updater.cpp
+//
+// Identification: src/codegen/updater.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/updater.h"
+
+#include "catalog/manager.h"
+#include "common/container_tuple.h"
+#include "concurrency/contention_manager.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "planner/update_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace codegen {
+
+void Updater::Init(const planner::UpdatePlan *plan,
+                   executor::ExecutorContext *executor_context) {
+  PL_ASSERT(plan != nullptr && executor_context != nullptr);
+  plan_ = plan;
+  executor_context_ = executor_context;
+
+  auto *schema = plan_->GetTable()->GetSchema();
+  values_ = new peloton::type::Value[schema->GetColumnCount()];
+
+  auto *project_info = plan_->GetProjectInfo();
+  target_col_ids_ = new std::vector<oid_t>();
+  for (const auto &target : project_info->GetTargetList()) {
+    target_col_ids_->push_back(target.first);
+  }
+
+  // The columns that are not updated must keep their values
+  in_place_ = true;
+  for (const auto &dm : project_info->GetDirectMapList()) {
+    if (dm.second.first != 0 || dm.first != dm.second.second) {
+      in_place_ = false;
+    }
+  }
+}
+
+char *Updater::GetValues() const { return reinterpret_cast<char *>(values_); }
+
+bool Updater::Update(uint32_t tile_group_id, uint32_t tuple_offset) {
+  PL_ASSERT(plan_ != nullptr && values_ != nullptr);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = executor_context_->GetTransaction();
+  auto *table = plan_->GetTable();
+
+  // Stop updating once the transaction failed
+  if (txn->GetResult() == ResultType::FAILURE) {
+    return false;
+  }
+
+  auto tile_group = table->GetTileGroupById(tile_group_id);
+  auto *tile_group_header = tile_group->GetHeader();
+  oid_t physical_tuple_id = tuple_offset;
+  ItemPointer old_location(tile_group_id, physical_tuple_id);
+
+  // At snapshot isolation, the latest version of the tuple is updated
+  if (txn->GetIsolationLevel() == IsolationLevelType::SNAPSHOT) {
+    old_location = *(tile_group_header->GetIndirection(physical_tuple_id));
+    tile_group = catalog::Manager::GetInstance().GetTileGroup(
+        old_location.block);
+    tile_group_header = tile_group->GetHeader();
+    physical_tuple_id = old_location.offset;
+
+    auto visibility =
+        txn_manager.IsVisible(txn, tile_group_header, physical_tuple_id,
+                              VisibilityIdType::COMMIT_ID);
+    if (visibility != VisibilityType::OK) {
+      return Fail();
+    }
+  }
+
+  bool is_owner =
+      txn_manager.IsOwner(txn, tile_group_header, physical_tuple_id);
+  bool is_written =
+      txn_manager.IsWritten(txn, tile_group_header, physical_tuple_id);
+
+  // The transaction created this version already, which it updates in place
+  if (is_owner && is_written) {
+    if (plan_->GetUpdatePrimaryKey()) {
+      return UpdatePrimaryKey(is_owner, tile_group_header, old_location);
+    }
+    WriteAll(tile_group.get(), physical_tuple_id);
+    txn_manager.PerformUpdate(txn, old_location);
+    executor_context_->num_processed++;
+    return true;
+  }
+
+  bool is_ownable =
+      is_owner ||
+      txn_manager.IsOwnable(txn, tile_group_header, physical_tuple_id);
+  if (!is_ownable) {
+    // The latest version cannot be updated
+    LOG_TRACE("Fail to update tuple. Set txn failure.");
+    concurrency::ContentionManager::GetInstance().RecordConflict(
+        tile_group->GetTileGroupId(), ConflictType::WRITE_WRITE);
+    return Fail();
+  }
+
+  bool acquired_ownership =
+      is_owner ||
+      txn_manager.AcquireOwnership(txn, tile_group_header, physical_tuple_id);
+  if (!acquired_ownership) {
+    return Fail();
+  }
+
+  if (plan_->GetUpdatePrimaryKey()) {
+    return UpdatePrimaryKey(is_owner, tile_group_header, old_location);
+  }
+
+  // Update the version in place, if the protocol allows for it
+  if (in_place_ &&
+      txn_manager.PerformInPlaceUpdate(txn, tile_group.get(), physical_tuple_id,
+                                       *target_col_ids_)) {
+    WriteTargets(tile_group.get(), physical_tuple_id);
+    executor_context_->num_processed++;
+    return true;
+  }
+
+  // Otherwise, install the values as a new version
+  ItemPointer new_location = table->AcquireVersion();
+  auto new_tile_group =
+      catalog::Manager::GetInstance().GetTileGroup(new_location.block);
+  WriteAll(new_tile_group.get(), new_location.offset);
+
+  expression::ContainerTuple<storage::TileGroup> new_tuple(
+      new_tile_group.get(), new_location.offset);
+  expression::ContainerTuple<storage::TileGroup> old_tuple(tile_group.get(),
+                                                           physical_tuple_id);
+  ItemPointer *indirection =
+      tile_group_header->GetIndirection(old_location.offset);
+  bool installed = table->InstallVersion(
+      &new_tuple, &(plan_->GetProjectInfo()->GetTargetList()), txn,
+      indirection, &old_tuple);
+  if (!installed) {
+    // Release the ownership acquired above, since the version is not in the
+    // write set of the transaction yet
+    if (!is_owner) {
+      txn_manager.YieldOwnership(txn, tile_group_header, physical_tuple_id);
+    }
+    return Fail();
+  }
+
+  txn_manager.PerformUpdate(txn, old_location, new_location);
+  executor_context_->num_processed++;
+  return true;
+}
+
+void Updater::Destroy() {
+  delete[] values_;
+  values_ = nullptr;
+  delete target_col_ids_;
+  target_col_ids_ = nullptr;
+}
+
+void Updater::WriteTargets(storage::TileGroup *tile_group,
+                           oid_t tuple_offset) const {
+  for (oid_t col_id : *target_col_ids_) {
+    tile_group->SetValue(values_[col_id], tuple_offset, col_id);
+  }
+}
+
+void Updater::WriteAll(storage::TileGroup *tile_group,
+                       oid_t tuple_offset) const {
+  uint32_t column_count = plan_->GetTable()->GetSchema()->GetColumnCount();
+  for (uint32_t col_id = 0; col_id < column_count; col_id++) {
+    tile_group->SetValue(values_[col_id], tuple_offset, col_id);
+  }
+}
+
+bool Updater::UpdatePrimaryKey(bool is_owner,
+                               storage::TileGroupHeader *tile_group_header,
+                               ItemPointer old_location) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = executor_context_->GetTransaction();
+  auto *table = plan_->GetTable();
+
+  // Delete the old version
+  ItemPointer new_location = table->InsertEmptyVersion();
+  if (new_location.IsNull()) {
+    if (!is_owner) {
+      txn_manager.YieldOwnership(txn, tile_group_header, old_location.offset);
+    }
+    return Fail();
+  }
+  txn_manager.PerformDelete(txn, old_location, new_location);
+
+  // Insert the new values as a new tuple
+  storage::Tuple new_tuple(table->GetSchema(), true);
+  auto *pool = executor_context_->GetPool();
+  uint32_t column_count = table->GetSchema()->GetColumnCount();
+  for (uint32_t col_id = 0; col_id < column_count; col_id++) {
+    new_tuple.SetValue(col_id, values_[col_id], pool);
+  }
+
+  ItemPointer *index_entry_ptr = nullptr;
+  ItemPointer location = table->InsertTuple(&new_tuple, txn, &index_entry_ptr);
+  if (location.block == INVALID_OID) {
+    return Fail();
+  }
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  executor_context_->num_processed++;
+  return true;
+}
+
+bool Updater::Fail() const {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.SetTransactionResult(executor_context_->GetTransaction(),
+                                   ResultType::FAILURE);
+  return false;
+}
+
+}  // namespace codegen
+}  // namespace peloton
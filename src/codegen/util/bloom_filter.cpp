@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bloom_filter.cpp
+//
+// Identification: src/codegen/util/bloom_filter.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/bloom_filter.h"
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "storage/backend_manager.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+BloomFilter::BloomFilter() : words_(nullptr), word_mask_(0) {}
+
+BloomFilter::~BloomFilter() { Destroy(); }
+
+// The number of words is rounded up to a power of two, so the word of a hash
+// can be found with a mask
+void BloomFilter::Init(uint64_t estimated_num_entries) {
+  uint64_t num_bits = estimated_num_entries * kBitsPerEntry;
+  uint64_t num_words = 1;
+  while (num_words * 64 < num_bits && num_words < kMaxNumWords) {
+    num_words <<= 1;
+  }
+  word_mask_ = num_words - 1;
+
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  words_ = static_cast<uint64_t *>(backend_manager.Allocate(
+      BackendType::MM, num_words * sizeof(uint64_t)));
+  PL_MEMSET(words_, 0, num_words * sizeof(uint64_t));
+
+  LOG_DEBUG("Initialized BloomFilter with %llu words for %llu entries ...",
+            (unsigned long long)num_words,
+            (unsigned long long)estimated_num_entries);
+}
+
+void BloomFilter::Destroy() {
+  if (words_ != nullptr) {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    backend_manager.Release(BackendType::MM, words_);
+    words_ = nullptr;
+  }
+  word_mask_ = 0;
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_buffer.cpp
+//
+// Identification: src/codegen/util/partitioned_buffer.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/util/partitioned_buffer.h"
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "storage/backend_manager.h"
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+PartitionedBuffer::PartitionedBuffer()
+    : partitions_(nullptr), num_partitions_(0), tuple_size_(0) {}
+
+PartitionedBuffer::~PartitionedBuffer() { Destroy(); }
+
+// The space of the partitions is only allocated when the first tuple arrives
+void PartitionedBuffer::Init(uint32_t tuple_size, uint32_t num_partitions) {
+  PL_ASSERT(num_partitions > 0);
+  tuple_size_ = tuple_size;
+  num_partitions_ = num_partitions;
+  partitions_ = new Partition[num_partitions];
+  for (uint32_t i = 0; i < num_partitions; i++) {
+    partitions_[i] = {nullptr, nullptr, nullptr};
+  }
+
+  LOG_DEBUG("Initialized PartitionedBuffer with %u partitions for tuples of "
+            "size %u ...",
+            num_partitions_, tuple_size_);
+}
+
+char *PartitionedBuffer::StoreInputTuple(uint32_t partition) {
+  PL_ASSERT(partition < num_partitions_);
+  Partition &part = partitions_[partition];
+  if (part.pos + tuple_size_ > part.end) {
+    Resize(part, tuple_size_);
+  }
+  char *ret = part.pos;
+  part.pos += tuple_size_;
+  return ret;
+}
+
+// Both buffers have the same layout, so every partition of the other buffer is
+// copied to the end of the matching partition of this one
+void PartitionedBuffer::TransferFrom(PartitionedBuffer &other) {
+  PL_ASSERT(other.tuple_size_ == tuple_size_);
+  PL_ASSERT(other.num_partitions_ == num_partitions_);
+  for (uint32_t i = 0; i < num_partitions_; i++) {
+    Partition &part = partitions_[i];
+    const Partition &other_part = other.partitions_[i];
+    uint64_t other_used = other_part.pos - other_part.start;
+    if (other_used == 0) {
+      continue;
+    }
+    if (part.pos + other_used > part.end) {
+      Resize(part, other_used);
+    }
+    PL_MEMCPY(part.pos, other_part.start, other_used);
+    part.pos += other_used;
+  }
+  other.Destroy();
+}
+
+char *PartitionedBuffer::GetPartitionStart(uint32_t partition) const {
+  PL_ASSERT(partition < num_partitions_);
+  return partitions_[partition].start;
+}
+
+uint64_t PartitionedBuffer::GetNumTuples(uint32_t partition) const {
+  PL_ASSERT(partition < num_partitions_);
+  const Partition &part = partitions_[partition];
+  return (part.pos - part.start) / tuple_size_;
+}
+
+// Release any memory we allocated from the storage manager
+void PartitionedBuffer::Destroy() {
+  if (partitions_ == nullptr) {
+    return;
+  }
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  for (uint32_t i = 0; i < num_partitions_; i++) {
+    if (partitions_[i].start != nullptr) {
+      backend_manager.Release(BackendType::MM, partitions_[i].start);
+    }
+  }
+  delete[] partitions_;
+  partitions_ = nullptr;
+  num_partitions_ = 0;
+}
+
+// Double the space of the partition until the requested space fits. The used
+// part of the old space is copied over, and the old space released.
+void PartitionedBuffer::Resize(Partition &partition, uint64_t min_free_space) {
+  uint64_t curr_alloc_size = partition.end - partition.start;
+  uint64_t curr_used_size = partition.pos - partition.start;
+
+  uint64_t next_alloc_size =
+      curr_alloc_size == 0 ? kInitialPartitionSize : curr_alloc_size << 1;
+  while (next_alloc_size - curr_used_size < min_free_space) {
+    next_alloc_size <<= 1;
+  }
+
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  char *new_start = reinterpret_cast<char *>(
+      backend_manager.Allocate(BackendType::MM, next_alloc_size));
+  if (partition.start != nullptr) {
+    PL_MEMCPY(new_start, partition.start, curr_used_size);
+    backend_manager.Release(BackendType::MM, partition.start);
+  }
+
+  partition.start = new_start;
+  partition.pos = new_start + curr_used_size;
+  partition.end = new_start + next_alloc_size;
+}
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -12,7 +12,11 @@
 
 #include "codegen/util/sorter.h"
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
+#include <limits>
+#include <thread>
 
 #include "common/logger.h"
 #include "common/timer.h"
@@ -65,7 +69,93 @@ char *Sorter::StoreInputTuple() {
   return ret;
 }
 
-// Sort the buffer
+// Keep the smallest top_k tuples in a heap. The tuple stored last is sifted
+// up, and if there are more than top_k tuples, the root (the tuple that sorts
+// last) is dropped and the new root sifted down. The heap is a permutation of
+// the buffer, so Sort() works on it as usual.
+void Sorter::StoreInputTupleTopK(uint64_t top_k) {
+  uint64_t num_tuples = GetNumTuples();
+  PL_ASSERT(num_tuples > 0);
+
+  // If the heap is full, a tuple that doesn't sort before the root is dropped
+  if (num_tuples > top_k &&
+      (top_k == 0 ||
+       cmp_func_(GetTupleAt(num_tuples - 1), GetTupleAt(0)) >= 0)) {
+    buffer_pos_ -= tuple_size_;
+    return;
+  }
+
+  // Sift the new tuple up
+  uint64_t child = num_tuples - 1;
+  while (child > 0) {
+    uint64_t parent = (child - 1) / 2;
+    if (cmp_func_(GetTupleAt(parent), GetTupleAt(child)) >= 0) {
+      break;
+    }
+    SwapTuples(parent, child);
+    child = parent;
+  }
+
+  if (num_tuples <= top_k) {
+    return;
+  }
+
+  // There is one tuple too many, drop the root
+  num_tuples--;
+  SwapTuples(0, num_tuples);
+  buffer_pos_ -= tuple_size_;
+
+  // Sift the new root down
+  uint64_t parent = 0;
+  while (true) {
+    uint64_t largest = parent;
+    uint64_t left = 2 * parent + 1, right = 2 * parent + 2;
+    if (left < num_tuples &&
+        cmp_func_(GetTupleAt(left), GetTupleAt(largest)) > 0) {
+      largest = left;
+    }
+    if (right < num_tuples &&
+        cmp_func_(GetTupleAt(right), GetTupleAt(largest)) > 0) {
+      largest = right;
+    }
+    if (largest == parent) {
+      break;
+    }
+    SwapTuples(parent, largest);
+    parent = largest;
+  }
+}
+
+// Move the tuples of the other sorter to the end of this one. Without a
+// limit, the used space of the other sorter is copied in one go. Otherwise,
+// every tuple goes through the top-K heap, so this sorter keeps at most top_k
+// tuples.
+void Sorter::TransferFrom(Sorter &other, uint64_t top_k) {
+  PL_ASSERT(other.buffer_start_ == nullptr || tuple_size_ == other.tuple_size_);
+
+  uint64_t other_used_size = other.GetUsedSpace();
+  if (other_used_size > 0) {
+    if (top_k == std::numeric_limits<uint64_t>::max()) {
+      while (!EnoughSpace(other_used_size)) {
+        Resize();
+      }
+      PL_MEMCPY(buffer_pos_, other.buffer_start_, other_used_size);
+      buffer_pos_ += other_used_size;
+    } else {
+      uint64_t num_tuples = other.GetNumTuples();
+      for (uint64_t i = 0; i < num_tuples; i++) {
+        PL_MEMCPY(StoreInputTuple(), other.GetTupleAt(i), tuple_size_);
+        StoreInputTupleTopK(top_k);
+      }
+    }
+  }
+
+  other.Destroy();
+}
+
+// Sort the buffer. We sort pointers to the tuples rather than the tuples
+// themselves, so every move is eight bytes no matter how wide the tuples are,
+// and then copy the tuples into a new buffer in the sorted order.
 void Sorter::Sort() {
   // Nothing to sort if nothing has been stored
   if (GetUsedSpace() <= 0) {
@@ -81,12 +171,89 @@ void Sorter::Sort() {
   LOG_DEBUG("Going to sort %llu tuples in sort buffer", (unsigned long long) num_tuples);
 
   // Sort the sucker
-  std::qsort(buffer_start_, num_tuples, tuple_size_, cmp_func_);
+  std::vector<char *> tuples(num_tuples);
+  for (uint64_t i = 0; i < num_tuples; i++) {
+    tuples[i] = GetTupleAt(i);
+  }
+  SortTuplePointers(tuples);
+
+  // Copy the tuples in their sorted order
+  auto &backend_manager = storage::BackendManager::GetInstance();
+  uint64_t alloc_size = GetAllocatedSpace();
+  uint64_t used_size = GetUsedSpace();
+  char *sorted_start = reinterpret_cast<char *>(
+      backend_manager.Allocate(BackendType::MM, alloc_size));
+  for (uint64_t i = 0; i < num_tuples; i++) {
+    PL_MEMCPY(sorted_start + i * tuple_size_, tuples[i], tuple_size_);
+  }
+
+  backend_manager.Release(BackendType::MM, buffer_start_);
+  buffer_start_ = sorted_start;
+  buffer_pos_ = buffer_start_ + used_size;
+  buffer_end_ = buffer_start_ + alloc_size;
 
   timer.Stop();
   LOG_INFO("Sorted %llu tuples in %.2f ms", (unsigned long long) num_tuples, timer.GetDuration());
 }
 
+// Small inputs are sorted on the calling thread. Larger ones are split into
+// equally sized runs, one per thread, that are sorted concurrently. Neighboring
+// runs are then merged pairwise, with the merges of a round running
+// concurrently too, until a single run is left.
+void Sorter::SortTuplePointers(std::vector<char *> &tuples) const {
+  ComparisonFunction cmp_func = cmp_func_;
+  auto less = [cmp_func](const char *left, const char *right) {
+    return cmp_func(left, right) < 0;
+  };
+
+  uint64_t num_runs = std::min<uint64_t>(
+      std::max(std::thread::hardware_concurrency(), 1u), kMaxSortThreads);
+  num_runs = std::min<uint64_t>(num_runs, tuples.size() / kParallelSortThreshold);
+  if (num_runs <= 1) {
+    std::sort(tuples.begin(), tuples.end(), less);
+    return;
+  }
+
+  // The runs are [bounds[i], bounds[i + 1])
+  std::vector<uint64_t> bounds(num_runs + 1);
+  for (uint64_t i = 0; i <= num_runs; i++) {
+    bounds[i] = tuples.size() * i / num_runs;
+  }
+  auto run_begin = [&tuples, &bounds](uint64_t run) {
+    return tuples.begin() + bounds[std::min<uint64_t>(run, bounds.size() - 1)];
+  };
+
+  // Invoke the task for every index in [0, num_tasks), the first one on the
+  // calling thread
+  auto run_concurrently = [](uint64_t num_tasks,
+                             const std::function<void(uint64_t)> &task) {
+    std::vector<std::thread> threads;
+    for (uint64_t i = 1; i < num_tasks; i++) {
+      threads.emplace_back(task, i);
+    }
+    task(0);
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  };
+
+  run_concurrently(num_runs, [&](uint64_t run) {
+    std::sort(run_begin(run), run_begin(run + 1), less);
+  });
+
+  for (uint64_t width = 1; width < num_runs; width *= 2) {
+    uint64_t num_merges = (num_runs + 2 * width - 1) / (2 * width);
+    run_concurrently(num_merges, [&](uint64_t merge) {
+      uint64_t first = merge * 2 * width;
+      std::inplace_merge(run_begin(first), run_begin(first + width),
+                         run_begin(first + 2 * width), less);
+    });
+  }
+
+  LOG_DEBUG("Sorted %llu tuples in %llu runs",
+            (unsigned long long) tuples.size(), (unsigned long long) num_runs);
+}
+
 // Release any memory we allocated from the storage manager.
 void Sorter::Destroy() {
   if (buffer_start_ != nullptr) {
@@ -134,6 +301,11 @@ void Sorter::Resize() {
   backend_manager.Release(BackendType::MM, old_buffer_start);
 }
 
+void Sorter::SwapTuples(uint64_t left_pos, uint64_t right_pos) {
+  char *left = GetTupleAt(left_pos);
+  std::swap_ranges(left, left + tuple_size_, GetTupleAt(right_pos));
+}
+
 //===----------------------------------------------------------------------===//
 // Iterators
 //===----------------------------------------------------------------------===//
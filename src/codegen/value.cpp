@@ -15,8 +15,10 @@
 #include <list>
 #include <queue>
 
+#include "codegen/lang/if.h"
 #include "codegen/type/type_system.h"
 #include "codegen/type/sql_type.h"
+#include "codegen/value_proxy.h"
 
 namespace peloton {
 namespace codegen {
@@ -233,6 +235,30 @@ void Value::ValuesForMaterialization(CodeGen &codegen, llvm::Value *&val,
   null = IsNull(codegen);
 }
 
+void Value::OutputTo(CodeGen &codegen, llvm::Value *values,
+                     uint32_t idx) const {
+  const auto &sql_type = GetType().GetSqlType();
+
+  // NULL values (i.e., with the NULL bit set) are output as the NULL value of
+  // their type
+  Value null_val;
+  lang::If val_is_null{codegen, IsNull(codegen)};
+  {
+    null_val = sql_type.GetNullValue(codegen);
+  }
+  val_is_null.EndIf();
+  Value val = val_is_null.BuildPHI(null_val, *this);
+
+  // Output the value using the type's output function
+  auto *output_func = sql_type.GetOutputFunction(codegen, val.GetType());
+  llvm::Value *values_ptr = codegen->CreateBitCast(
+      values, ValueProxy::GetType(codegen)->getPointerTo());
+  std::vector<llvm::Value *> args = {values_ptr, codegen.Const64(idx),
+                                     val.GetValue()};
+  if (val.GetLength() != nullptr) args.push_back(val.GetLength());
+  codegen.CallFunc(output_func, args);
+}
+
 // Return the value that can be
 Value Value::ValueFromMaterialization(const type::Type &type, llvm::Value *val,
                                       llvm::Value *len, llvm::Value *null) {
@@ -12,6 +12,9 @@
 
 #include "codegen/values_runtime.h"
 
+#include <algorithm>
+
+#include "executor/executor_context.h"
 #include "type/type_util.h"
 #include "type/value_factory.h"
 #include "type/value_peeker.h"
@@ -81,5 +84,144 @@ int32_t ValuesRuntime::CompareStrings(const char *str1, uint32_t len1,
   return type::TypeUtil::CompareStrings(str1, len1, str2, len2);
 }
 
+namespace {
+
+// Strings from storage count their null terminator in their length, the ones
+// from the query do not. Matching ignores it.
+uint32_t GetStringLength(const char *str, uint32_t len) {
+  return (len > 0 && str[len - 1] == '\0') ? len - 1 : len;
+}
+
+}  // anonymous namespace
+
+// Match the pattern left to right. A '%' remembers the position in both the
+// pattern and the string, which the match backtracks to (with the '%'
+// consuming one more character of the string) whenever the rest of the
+// pattern fails to match.
+bool ValuesRuntime::Like(const char *str, uint32_t len, const char *pattern,
+                         uint32_t pattern_len) {
+  len = GetStringLength(str, len);
+  pattern_len = GetStringLength(pattern, pattern_len);
+
+  uint32_t s = 0, p = 0;
+  bool seen_percent = false;
+  uint32_t percent_s = 0, percent_p = 0;
+  while (s < len) {
+    if (p < pattern_len) {
+      char c = pattern[p];
+      if (c == '%') {
+        seen_percent = true;
+        percent_p = ++p;
+        percent_s = s;
+        continue;
+      }
+      if (c == '_') {
+        s++;
+        p++;
+        continue;
+      }
+      uint32_t width = 1;
+      if (c == '\\' && p + 1 < pattern_len) {
+        c = pattern[p + 1];
+        width = 2;
+      }
+      if (str[s] == c) {
+        s++;
+        p += width;
+        continue;
+      }
+    }
+    if (!seen_percent) {
+      return false;
+    }
+    s = ++percent_s;
+    p = percent_p;
+  }
+
+  // The string is consumed, only '%' may be left in the pattern
+  while (p < pattern_len && pattern[p] == '%') {
+    p++;
+  }
+  return p == pattern_len;
+}
+
+bool ValuesRuntime::StartsWith(const char *str, uint32_t len,
+                               const char *prefix, uint32_t prefix_len) {
+  len = GetStringLength(str, len);
+  return len >= prefix_len && memcmp(str, prefix, prefix_len) == 0;
+}
+
+bool ValuesRuntime::EndsWith(const char *str, uint32_t len, const char *suffix,
+                             uint32_t suffix_len) {
+  len = GetStringLength(str, len);
+  return len >= suffix_len &&
+         memcmp(str + len - suffix_len, suffix, suffix_len) == 0;
+}
+
+bool ValuesRuntime::Contains(const char *str, uint32_t len, const char *substr,
+                             uint32_t substr_len) {
+  len = GetStringLength(str, len);
+  return substr_len == 0 ||
+         std::search(str, str + len, substr, substr + substr_len) != str + len;
+}
+
+bool ValuesRuntime::CallFunction(char *func, char *args, uint32_t num_args,
+                                 executor::ExecutorContext *executor_context,
+                                 char *result, uint32_t *result_len) {
+  type::Value *vals = reinterpret_cast<type::Value *>(args);
+  type::Value ret = reinterpret_cast<Function>(func)(
+      std::vector<type::Value>(vals, vals + num_args));
+  if (ret.IsNull()) {
+    // NULL strings are empty, so that they are safe to look at
+    *reinterpret_cast<int64_t *>(result) = 0;
+    *result_len = 0;
+    return true;
+  }
+
+  switch (ret.GetTypeId()) {
+    case type::TypeId::BOOLEAN:
+      *reinterpret_cast<bool *>(result) = type::ValuePeeker::PeekBoolean(ret);
+      break;
+    case type::TypeId::TINYINT:
+      *reinterpret_cast<int8_t *>(result) = type::ValuePeeker::PeekTinyInt(ret);
+      break;
+    case type::TypeId::SMALLINT:
+      *reinterpret_cast<int16_t *>(result) =
+          type::ValuePeeker::PeekSmallInt(ret);
+      break;
+    case type::TypeId::INTEGER:
+      *reinterpret_cast<int32_t *>(result) = type::ValuePeeker::PeekInteger(ret);
+      break;
+    case type::TypeId::BIGINT:
+      *reinterpret_cast<int64_t *>(result) = type::ValuePeeker::PeekBigInt(ret);
+      break;
+    case type::TypeId::DATE:
+      *reinterpret_cast<int32_t *>(result) = type::ValuePeeker::PeekDate(ret);
+      break;
+    case type::TypeId::TIMESTAMP:
+      *reinterpret_cast<int64_t *>(result) =
+          type::ValuePeeker::PeekTimestamp(ret);
+      break;
+    case type::TypeId::DECIMAL:
+      *reinterpret_cast<double *>(result) = type::ValuePeeker::PeekDouble(ret);
+      break;
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY: {
+      uint32_t len = ret.GetLength();
+      char *str = reinterpret_cast<char *>(
+          executor_context->GetPool()->Allocate(len));
+      PL_MEMCPY(str, ret.GetData(), len);
+      *reinterpret_cast<char **>(result) = str;
+      *result_len = len;
+      break;
+    }
+    default: {
+      throw Exception{"Function returned a value of unsupported type " +
+                      TypeIdToString(ret.GetTypeId())};
+    }
+  }
+  return false;
+}
+
 }  // namespace codegen
 }  // namespace peloton
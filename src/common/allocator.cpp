@@ -17,7 +17,13 @@
 #include <stdint.h>
 #include <execinfo.h>
 #include <unistd.h>
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
 
+#include "common/memory_tracker.h"
 #include "common/stack_trace.h"
 
 // We will use jemalloc at link time. jemalloc library has already mangled the symbols
@@ -25,16 +31,33 @@
 
 namespace peloton {
 
+// The size of the block, as the memory tracker measures it
+static inline size_t usable_size(void *location) {
+#ifdef __APPLE__
+  return malloc_size(location);
+#else
+  return malloc_usable_size(location);
+#endif
+}
+
 void *do_allocation(size_t size, bool do_throw) {
   void *location = malloc(size);
   if (!location && do_throw) {
     throw std::bad_alloc();
   }
 
+  if (location != nullptr && MemoryTracker::IsMeasuringThread()) {
+    MemoryTracker::RecordThreadAllocation(usable_size(location));
+  }
   return location;
 }
 
-void do_deletion(void *location) { free(location); }
+void do_deletion(void *location) {
+  if (location != nullptr && MemoryTracker::IsMeasuringThread()) {
+    MemoryTracker::RecordThreadDeallocation(usable_size(location));
+  }
+  free(location);
+}
 
 }  // End peloton namespace
 
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_node.cpp
+//
+// Identification: src/common/arena_node.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/arena_node.h"
+
+#include <cstdint>
+
+#include "type/arena_pool.h"
+
+namespace peloton {
+
+namespace {
+
+// Every node is preceded by a word that tells where it came from. The arena
+// aligns to 8 bytes, which is enough for the nodes.
+const size_t kNodeHeaderSize = 8;
+const uint64_t kHeapNode = 0;
+const uint64_t kArenaNode = 1;
+
+}  // namespace
+
+thread_local type::ArenaPool *ArenaNodeScope::current_arena_ = nullptr;
+
+void *ArenaNode::operator new(size_t size) {
+  auto arena = ArenaNodeScope::GetArena();
+  char *block;
+  if (arena != nullptr) {
+    block = static_cast<char *>(arena->Allocate(size + kNodeHeaderSize));
+    *reinterpret_cast<uint64_t *>(block) = kArenaNode;
+  } else {
+    block = static_cast<char *>(::operator new(size + kNodeHeaderSize));
+    *reinterpret_cast<uint64_t *>(block) = kHeapNode;
+  }
+  return block + kNodeHeaderSize;
+}
+
+void ArenaNode::operator delete(void *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  char *block = static_cast<char *>(ptr) - kNodeHeaderSize;
+  if (*reinterpret_cast<uint64_t *>(block) == kHeapNode) {
+    ::operator delete(block);
+  }
+}
+
+ArenaNodeScope::ArenaNodeScope(type::ArenaPool *arena)
+    : previous_arena_(current_arena_) {
+  current_arena_ = arena;
+}
+
+ArenaNodeScope::~ArenaNodeScope() { current_arena_ = previous_arena_; }
+
+}  // namespace peloton
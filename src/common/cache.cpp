@@ -15,6 +15,7 @@
 
 #include "common/statement.h"
 #include "common/macros.h"
+#include "optimizer/stats/cardinality_feedback.h"
 #include "planner/abstract_plan.h"
 
 namespace peloton {
@@ -143,4 +144,6 @@ template class Cache<std::string,
                      const planner::AbstractPlan>; /* Actual in use */
 
 template class Cache<std::string, Statement >;
+
+template class Cache<std::string, optimizer::CardinalityFeedbackEntry>;
 }
@@ -15,11 +15,25 @@
 #include <google/protobuf/stubs/common.h>
 
 #include "brain/index_tuner.h"
+#include "brain/knob_tuner.h"
 #include "brain/layout_tuner.h"
 #include "catalog/catalog.h"
+#include "codegen/background_compiler.h"
+#include "codegen/morsel_scheduler.h"
+#include "codegen/object_cache.h"
 #include "common/thread_pool.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "gc/gc_manager_factory.h"
+#include "logging/group_commit_manager.h"
+#include "statistics/metrics_exporter.h"
+#include "storage/aggregate_view.h"
+#include "storage/index_builder.h"
+#include "storage/tile_group_compactor.h"
+#include "storage/tile_group_evictor.h"
+#include "storage/tile_group_freezer.h"
+#include "storage/tile_group_provisioner.h"
+#include "storage/tuple_expirer.h"
+#include "wire/libevent_server.h"
 
 namespace peloton {
 
@@ -50,6 +64,8 @@ void PelotonInit::Initialize() {
     // Set the default visibility flag for all indexes to false
     index::IndexMetadata::SetDefaultVisibleFlag(false);
     auto& index_tuner = brain::IndexTuner::GetInstance();
+    index_tuner.SetIndexMemoryBudget(FLAGS_index_tuner_memory_mb * 1024 *
+                                     1024);
     index_tuner.Start();
   }
 
@@ -59,6 +75,58 @@ void PelotonInit::Initialize() {
     layout_tuner.Start();
   }
 
+  // start knob tuner
+  if (FLAGS_knob_tuner == true) {
+    auto& knob_tuner = brain::KnobTuner::GetInstance();
+    knob_tuner.SetGCLagTarget(FLAGS_knob_tuner_gc_lag_ms);
+    knob_tuner.Start();
+  }
+
+  // load and keep the code of compiled queries
+  if (FLAGS_codegen_object_cache_dir.empty() == false) {
+    codegen::ObjectCache::GetInstance().SetDirectory(
+        FLAGS_codegen_object_cache_dir);
+  }
+
+  // start tile group freezer
+  if (FLAGS_tile_group_freezer == true) {
+    storage::TileGroupFreezer::GetInstance().Start();
+  }
+
+  // start tile group evictor
+  if (FLAGS_tile_group_evictor == true) {
+    auto& tile_group_evictor = storage::TileGroupEvictor::GetInstance();
+    tile_group_evictor.SetEvictionDirectory(FLAGS_tile_group_evictor_dir);
+    tile_group_evictor.SetMemoryBudget(FLAGS_tile_group_evictor_memory_mb *
+                                       1024 * 1024);
+    tile_group_evictor.Start();
+  }
+
+  // start tile group compactor
+  if (FLAGS_tile_group_compactor == true) {
+    storage::TileGroupCompactor::GetInstance().Start();
+  }
+
+  // start tuple expirer
+  if (FLAGS_tuple_expirer == true) {
+    storage::TupleExpirer::GetInstance().Start();
+  }
+
+  // start tile group provisioner
+  if (FLAGS_tile_group_provisioner == true) {
+    storage::TileGroupProvisioner::GetInstance().Start();
+  }
+
+  // start group commit
+  if (FLAGS_group_commit == true) {
+    logging::GroupCommitManager::GetInstance().Start();
+  }
+
+  // start serving the metrics
+  if (FLAGS_metrics_port != 0) {
+    stats::MetricsExporter::GetInstance().Start(FLAGS_metrics_port);
+  }
+
   // Initialize catalog
   auto pg_catalog = catalog::Catalog::GetInstance();
   pg_catalog->Bootstrap();  // Additional catalogs
@@ -75,6 +143,11 @@ void PelotonInit::Initialize() {
 }
 
 void PelotonInit::Shutdown() {
+  // stop serving the metrics
+  if (stats::MetricsExporter::GetInstance().IsRunning()) {
+    stats::MetricsExporter::GetInstance().Stop();
+  }
+
   // shut down index tuner
   if (FLAGS_index_tuner == true) {
     auto& index_tuner = brain::IndexTuner::GetInstance();
@@ -87,6 +160,54 @@ void PelotonInit::Shutdown() {
     layout_tuner.Stop();
   }
 
+  // shut down knob tuner
+  if (FLAGS_knob_tuner == true) {
+    brain::KnobTuner::GetInstance().Stop();
+  }
+
+  // shut down tile group evictor
+  if (FLAGS_tile_group_evictor == true) {
+    storage::TileGroupEvictor::GetInstance().Stop();
+  }
+
+  // shut down tile group freezer
+  if (FLAGS_tile_group_freezer == true) {
+    storage::TileGroupFreezer::GetInstance().Stop();
+  }
+
+  // shut down tile group compactor
+  if (FLAGS_tile_group_compactor == true) {
+    storage::TileGroupCompactor::GetInstance().Stop();
+  }
+
+  // shut down tuple expirer
+  if (FLAGS_tuple_expirer == true) {
+    storage::TupleExpirer::GetInstance().Stop();
+  }
+
+  // shut down tile group provisioner
+  if (FLAGS_tile_group_provisioner == true) {
+    storage::TileGroupProvisioner::GetInstance().Stop();
+  }
+
+  // shut down group commit
+  if (FLAGS_group_commit == true) {
+    logging::GroupCommitManager::GetInstance().Stop();
+  }
+
+  // abandon the index builds, they wait for the epochs to expire
+  storage::IndexBuilder::GetInstance().StopAll();
+  storage::AggregateViewManager::GetInstance().StopAll();
+
+  // finish the queries being compiled, they read the tables
+  codegen::BackgroundCompiler::GetInstance().WaitForAll();
+
+  // stop the threads of the parallel scans
+  codegen::MorselScheduler::GetInstance().Shutdown();
+
+  // stop the threads executing the statements of the connections
+  wire::LibeventExecutionPool::GetInstance().Shutdown();
+
   // shut down GC.
   gc::GCManagerFactory::GetInstance().StopGC();
 
@@ -0,0 +1,221 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// maintenance_scheduler.cpp
+//
+// Identification: src/common/maintenance_scheduler.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/maintenance_scheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "configuration/configuration.h"
+
+namespace peloton {
+
+std::string MaintenanceTaskToString(MaintenanceTask task) {
+  switch (task) {
+    case MaintenanceTask::GC:
+      return "GC";
+    case MaintenanceTask::INDEX_TUNER:
+      return "INDEX_TUNER";
+    case MaintenanceTask::LAYOUT_TUNER:
+      return "LAYOUT_TUNER";
+    case MaintenanceTask::COMPACTOR:
+      return "COMPACTOR";
+    case MaintenanceTask::FREEZER:
+      return "FREEZER";
+    case MaintenanceTask::CHECKPOINT:
+      return "CHECKPOINT";
+    case MaintenanceTask::KNOB_TUNER:
+      return "KNOB_TUNER";
+    case MaintenanceTask::EVICTOR:
+      return "EVICTOR";
+    case MaintenanceTask::EXPIRER:
+      return "EXPIRER";
+    case MaintenanceTask::PROVISIONER:
+      return "PROVISIONER";
+  }
+  return "INVALID";
+}
+
+std::string MaintenanceModeToString(MaintenanceMode mode) {
+  switch (mode) {
+    case MaintenanceMode::IDLE:
+      return "IDLE";
+    case MaintenanceMode::NORMAL:
+      return "NORMAL";
+    case MaintenanceMode::THROTTLED:
+      return "THROTTLED";
+  }
+  return "INVALID";
+}
+
+const uint64_t MaintenanceScheduler::THROTTLE_FACTOR;
+const uint64_t MaintenanceScheduler::IDLE_FACTOR;
+const uint64_t MaintenanceScheduler::MIN_THROTTLED_PAUSE_US;
+const uint64_t MaintenanceScheduler::MAX_PAUSE_US;
+const uint64_t MaintenanceScheduler::LATENCY_TIMEOUT_US;
+
+MaintenanceScheduler::MaintenanceScheduler()
+    : latency_time_(Clock::now()), refill_time_(Clock::now()) {}
+
+MaintenanceScheduler &MaintenanceScheduler::GetInstance() {
+  static MaintenanceScheduler maintenance_scheduler;
+  static std::once_flag budgets_flag;
+  std::call_once(budgets_flag, [] {
+    maintenance_scheduler.SetBudgets(FLAGS_maintenance_latency_slo_ms,
+                                     FLAGS_maintenance_cpu_percent,
+                                     FLAGS_maintenance_io_mb);
+  });
+  return maintenance_scheduler;
+}
+
+void MaintenanceScheduler::RecordQueryLatency(const double p99_latency_ms,
+                                              const uint64_t query_count) {
+  std::lock_guard<std::mutex> lock(scheduler_mutex_);
+  p99_latency_ms_ = p99_latency_ms;
+  query_count_ = query_count;
+  latency_time_ = Clock::now();
+  has_latency_ = true;
+}
+
+void MaintenanceScheduler::RecordWork(const MaintenanceTask task,
+                                      const uint64_t work_us,
+                                      const uint64_t io_bytes) {
+  auto task_idx = static_cast<size_t>(task);
+  std::lock_guard<std::mutex> lock(scheduler_mutex_);
+  Refill(Clock::now());
+  work_us_[task_idx] += work_us;
+  io_bytes_[task_idx] += io_bytes;
+  cpu_tokens_us_ -= work_us;
+  io_tokens_bytes_ -= io_bytes;
+}
+
+uint64_t MaintenanceScheduler::GetPause(const MaintenanceTask task,
+                                        const uint64_t pause_us) {
+  if (task == MaintenanceTask::GC) {
+    return pause_us;
+  }
+
+  std::lock_guard<std::mutex> lock(scheduler_mutex_);
+  auto now = Clock::now();
+  Refill(now);
+
+  uint64_t task_pause_us;
+  auto mode = GetMode(now);
+  switch (mode) {
+    case MaintenanceMode::IDLE:
+      task_pause_us = pause_us / IDLE_FACTOR;
+      break;
+    case MaintenanceMode::THROTTLED:
+      task_pause_us =
+          std::max(pause_us * THROTTLE_FACTOR, MIN_THROTTLED_PAUSE_US);
+      break;
+    default:
+      task_pause_us = pause_us;
+      break;
+  }
+
+  // Wait until the debts are paid off
+  double refill_factor = (mode == MaintenanceMode::IDLE) ? IDLE_FACTOR : 1;
+  if (cpu_percent_ != 0 && cpu_tokens_us_ < 0) {
+    double cpu_rate = cpu_percent_ / 100.0 * refill_factor;
+    task_pause_us = std::max(task_pause_us,
+                             static_cast<uint64_t>(-cpu_tokens_us_ / cpu_rate));
+  }
+  if (io_mb_ != 0 && io_tokens_bytes_ < 0) {
+    double io_rate = GetIoRate() * refill_factor;
+    task_pause_us = std::max(
+        task_pause_us, static_cast<uint64_t>(-io_tokens_bytes_ / io_rate));
+  }
+
+  return std::min(task_pause_us, MAX_PAUSE_US);
+}
+
+void MaintenanceScheduler::Pause(const MaintenanceTask task,
+                                 const uint64_t pause_us) {
+  auto task_pause_us = GetPause(task, pause_us);
+  if (task_pause_us != 0) {
+    std::this_thread::sleep_for(std::chrono::microseconds(task_pause_us));
+  }
+}
+
+MaintenanceMode MaintenanceScheduler::GetMode() const {
+  std::lock_guard<std::mutex> lock(scheduler_mutex_);
+  return GetMode(Clock::now());
+}
+
+uint64_t MaintenanceScheduler::GetWorkUs(const MaintenanceTask task) const {
+  std::lock_guard<std::mutex> lock(scheduler_mutex_);
+  return work_us_[static_cast<size_t>(task)];
+}
+
+uint64_t MaintenanceScheduler::GetIoBytes(const MaintenanceTask task) const {
+  std::lock_guard<std::mutex> lock(scheduler_mutex_);
+  return io_bytes_[static_cast<size_t>(task)];
+}
+
+void MaintenanceScheduler::SetBudgets(const uint64_t latency_slo_ms,
+                                      const uint64_t cpu_percent,
+                                      const uint64_t io_mb) {
+  std::lock_guard<std::mutex> lock(scheduler_mutex_);
+  latency_slo_ms_ = latency_slo_ms;
+  cpu_percent_ = cpu_percent;
+  io_mb_ = io_mb;
+
+  // A second of the budgets to start with
+  cpu_tokens_us_ = cpu_percent_ / 100.0 * 1000 * 1000;
+  io_tokens_bytes_ = io_mb_ * 1024.0 * 1024;
+  refill_time_ = Clock::now();
+}
+
+void MaintenanceScheduler::Refill(const Clock::time_point now) {
+  double elapsed_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - refill_time_)
+          .count();
+  refill_time_ = now;
+
+  // The buckets refill faster while no queries run, and hold a second of
+  // the budgets at most
+  double refill_factor =
+      (GetMode(now) == MaintenanceMode::IDLE) ? IDLE_FACTOR : 1;
+  double cpu_rate = cpu_percent_ / 100.0 * refill_factor;
+  cpu_tokens_us_ =
+      std::min(cpu_tokens_us_ + elapsed_us * cpu_rate, cpu_rate * 1000 * 1000);
+
+  double io_rate = GetIoRate() * refill_factor;
+  io_tokens_bytes_ = std::min(io_tokens_bytes_ + elapsed_us * io_rate,
+                              io_rate * 1000 * 1000);
+}
+
+double MaintenanceScheduler::GetIoRate() const {
+  // MB/s in bytes/us
+  return io_mb_ * 1024.0 * 1024 / (1000 * 1000);
+}
+
+MaintenanceMode MaintenanceScheduler::GetMode(
+    const Clock::time_point now) const {
+  if (has_latency_ == false ||
+      std::chrono::duration_cast<std::chrono::microseconds>(now -
+                                                            latency_time_)
+              .count() > static_cast<int64_t>(LATENCY_TIMEOUT_US)) {
+    return MaintenanceMode::NORMAL;
+  }
+
+  if (latency_slo_ms_ != 0 && p99_latency_ms_ > latency_slo_ms_) {
+    return MaintenanceMode::THROTTLED;
+  }
+  if (query_count_ == 0) {
+    return MaintenanceMode::IDLE;
+  }
+  return MaintenanceMode::NORMAL;
+}
+
+}  // End peloton namespace
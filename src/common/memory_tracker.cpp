@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_tracker.cpp
+//
+// Identification: src/common/memory_tracker.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/memory_tracker.h"
+
+#include <atomic>
+
+#include "common/platform.h"
+
+namespace peloton {
+
+namespace {
+
+// The bytes of a component, on a cache line of its own so that components
+// charged by different threads don't contend
+struct alignas(CACHELINE_SIZE) ComponentCounter {
+  std::atomic<int64_t> bytes{0};
+};
+
+ComponentCounter component_counters[MEMORY_COMPONENT_TYPE_COUNT];
+
+}  // namespace
+
+thread_local uint32_t MemoryTracker::thread_measure_depth_ = 0;
+
+thread_local int64_t MemoryTracker::thread_allocated_bytes_ = 0;
+
+std::string MemoryComponentTypeToString(MemoryComponentType type) {
+  switch (type) {
+    case MemoryComponentType::TILE_DATA:
+      return "tile_data";
+    case MemoryComponentType::TILE_GROUP_HEADER:
+      return "tile_group_header";
+    case MemoryComponentType::INDIRECTION_ARRAY:
+      return "indirection_array";
+    case MemoryComponentType::VARLEN_POOL:
+      return "varlen_pool";
+    case MemoryComponentType::INDEX:
+      return "index";
+    case MemoryComponentType::VERSION_CHAIN:
+      return "version_chain";
+    case MemoryComponentType::PLAN_CACHE:
+      return "plan_cache";
+    case MemoryComponentType::CODEGEN:
+      return "codegen";
+  }
+  return "invalid";
+}
+
+void MemoryTracker::Allocate(const MemoryComponentType type,
+                             const size_t bytes) {
+  component_counters[static_cast<size_t>(type)].bytes.fetch_add(
+      bytes, std::memory_order_relaxed);
+}
+
+void MemoryTracker::Release(const MemoryComponentType type,
+                            const size_t bytes) {
+  component_counters[static_cast<size_t>(type)].bytes.fetch_sub(
+      bytes, std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::GetAllocatedBytes(const MemoryComponentType type) {
+  // Releases may be counted before the allocations they free
+  auto bytes = component_counters[static_cast<size_t>(type)].bytes.load(
+      std::memory_order_relaxed);
+  return bytes > 0 ? bytes : 0;
+}
+
+MemoryScope::MemoryScope()
+    : begin_bytes_(MemoryTracker::thread_allocated_bytes_) {
+  MemoryTracker::thread_measure_depth_++;
+}
+
+MemoryScope::~MemoryScope() {
+  // Keep counting for the scopes around this one
+  if (--MemoryTracker::thread_measure_depth_ == 0) {
+    MemoryTracker::thread_allocated_bytes_ = 0;
+  }
+}
+
+size_t MemoryScope::GetAllocatedBytes() const {
+  auto bytes = MemoryTracker::thread_allocated_bytes_ - begin_bytes_;
+  return bytes > 0 ? bytes : 0;
+}
+
+}  // End peloton namespace
@@ -24,7 +24,7 @@ namespace peloton {
     {"ROLLBACK", QueryType::QUERY_ROLLBACK}, {"SET", QueryType::QUERY_SET},
     {"SHOW", QueryType::QUERY_SHOW}, {"INSERT", QueryType::QUERY_INSERT},
     {"PREPARE", QueryType::QUERY_PREPARE}, {"EXECUTE", QueryType::QUERY_EXECUTE},
-    {"CREATE", QueryType::QUERY_CREATE}
+    {"CREATE", QueryType::QUERY_CREATE}, {"COPY", QueryType::QUERY_COPY}
   };
 
 Statement::Statement(const std::string& statement_name,
@@ -0,0 +1,209 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// thread_pool.cpp
+//
+// Identification: src/common/thread_pool.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/thread_pool.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+
+namespace peloton {
+
+namespace {
+
+// The pool and the worker the calling thread runs tasks for, if any
+thread_local ThreadPool *current_pool = nullptr;
+thread_local size_t current_worker = 0;
+
+}  // namespace
+
+ThreadPool::~ThreadPool() { StopWorkers(); }
+
+void ThreadPool::Initialize(const size_t &pool_size,
+                            const size_t &dedicated_thread_count,
+                            const ThreadPlacement placement) {
+  PL_ASSERT(workers_.empty());
+
+  dedicated_thread_count_ = dedicated_thread_count;
+  current_thread_count_ = 0;
+  dedicated_threads_.resize(dedicated_thread_count_);
+
+  stopped_ = false;
+  pending_task_count_ = 0;
+
+  // Spread the workers over the nodes, and over the CPUs of every node
+  int node_count = NumaUtil::GetNodeCount();
+  std::vector<std::vector<int>> node_cpus(node_count);
+  for (int node = 0; node < node_count; node++) {
+    node_cpus[node] = NumaUtil::GetNodeCpus(node);
+  }
+  size_t cpu_count = std::max(std::thread::hardware_concurrency(), 1U);
+
+  for (size_t worker_id = 0; worker_id < pool_size; worker_id++) {
+    std::unique_ptr<Worker> worker(new Worker());
+    if (placement != ThreadPlacement::NONE) {
+      worker->numa_node = static_cast<int>(worker_id % node_count);
+      auto &cpus = node_cpus[worker->numa_node];
+      if (cpus.empty() == false) {
+        worker->cpu = cpus[(worker_id / node_count) % cpus.size()];
+      } else {
+        worker->cpu = static_cast<int>(worker_id % cpu_count);
+      }
+    }
+    workers_.push_back(std::move(worker));
+  }
+
+  for (size_t worker_id = 0; worker_id < pool_size; worker_id++) {
+    auto &victims = workers_[worker_id]->victims;
+    int numa_node = workers_[worker_id]->numa_node;
+    for (size_t offset = 1; offset < pool_size; offset++) {
+      size_t victim_id = (worker_id + offset) % pool_size;
+      if (workers_[victim_id]->numa_node == numa_node) {
+        victims.push_back(victim_id);
+      }
+    }
+    for (size_t offset = 1; offset < pool_size; offset++) {
+      size_t victim_id = (worker_id + offset) % pool_size;
+      if (workers_[victim_id]->numa_node != numa_node) {
+        victims.push_back(victim_id);
+      }
+    }
+  }
+
+  for (size_t worker_id = 0; worker_id < pool_size; worker_id++) {
+    workers_[worker_id]->thread = std::thread([this, worker_id, placement] {
+      auto &worker = *workers_[worker_id];
+      if (placement == ThreadPlacement::CPU) {
+        NumaUtil::BindThreadToCpu(worker.cpu);
+      } else if (placement == ThreadPlacement::NUMA_NODE &&
+                 NumaUtil::GetNodeCount() > 1) {
+        NumaUtil::BindThreadToNode(worker.numa_node);
+      }
+      RunWorker(worker_id);
+    });
+  }
+}
+
+void ThreadPool::Shutdown() {
+  // always join lastly created threads first.
+  size_t thread_count = std::min(current_thread_count_.load(),
+                                 dedicated_threads_.size());
+  for (size_t i = 0; i < thread_count; ++i) {
+    auto &thread = dedicated_threads_[thread_count - 1 - i];
+    if (thread != nullptr && thread->joinable()) {
+      thread->join();
+    }
+  }
+  StopWorkers();
+}
+
+void ThreadPool::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopped_ = true;
+  }
+  sleep_cv_.notify_all();
+
+  for (auto &worker : workers_) {
+    if (worker->thread.joinable()) {
+      worker->thread.join();
+    }
+  }
+  workers_.clear();
+}
+
+void ThreadPool::Submit(const TaskPriority priority, Task &&task) {
+  if (workers_.empty()) {
+    // Like a pool without workers always did, the task never runs
+    LOG_DEBUG("Task submitted to a thread pool without workers");
+    return;
+  }
+
+  size_t worker_id;
+  if (current_pool == this) {
+    worker_id = current_worker;
+  } else {
+    worker_id =
+        next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+  }
+
+  auto &worker = *workers_[worker_id];
+  {
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+  }
+
+  // A worker going to sleep counts itself before it checks for tasks, so
+  // either it sees this one or it is woken up here
+  pending_task_count_.fetch_add(1);
+  if (sleeping_count_.load() > 0) {
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    sleep_cv_.notify_one();
+  }
+}
+
+bool ThreadPool::FindTask(const size_t worker_id, Task &task) {
+  auto &worker = *workers_[worker_id];
+  for (size_t priority = 0; priority < kPriorityCount; priority++) {
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      auto &tasks = worker.tasks[priority];
+      if (tasks.empty() == false) {
+        task = std::move(tasks.back());
+        tasks.pop_back();
+        return true;
+      }
+    }
+
+    for (auto victim_id : worker.victims) {
+      auto &victim = *workers_[victim_id];
+      std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+      if (lock.owns_lock() == false) {
+        continue;
+      }
+      auto &tasks = victim.tasks[priority];
+      if (tasks.empty() == false) {
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void ThreadPool::RunWorker(const size_t worker_id) {
+  current_pool = this;
+  current_worker = worker_id;
+
+  Task task;
+  while (stopped_.load() == false) {
+    if (FindTask(worker_id, task)) {
+      pending_task_count_.fetch_sub(1);
+      task();
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleeping_count_.fetch_add(1);
+    // Victims that were busy are tried again when there are still tasks
+    sleep_cv_.wait(lock, [this] {
+      return stopped_.load() || pending_task_count_.load() > 0;
+    });
+    sleeping_count_.fetch_sub(1);
+  }
+
+  current_pool = nullptr;
+}
+
+}  // End peloton namespace
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wait_events.cpp
+//
+// Identification: src/common/wait_events.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/wait_events.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace peloton {
+
+namespace {
+
+// The waits counted by a thread. Slots are never freed.
+struct WaitEventSlot {
+  std::atomic<uint64_t> wait_counts[WAIT_EVENT_TYPE_COUNT];
+  std::atomic<uint64_t> timed_counts[WAIT_EVENT_TYPE_COUNT];
+  std::atomic<uint64_t> timed_ns[WAIT_EVENT_TYPE_COUNT];
+  std::atomic<bool> is_used;
+  WaitEventSlot *next;
+
+  WaitEventSlot() : is_used(true), next(nullptr) {
+    for (size_t type_idx = 0; type_idx < WAIT_EVENT_TYPE_COUNT; type_idx++) {
+      wait_counts[type_idx].store(0, std::memory_order_relaxed);
+      timed_counts[type_idx].store(0, std::memory_order_relaxed);
+      timed_ns[type_idx].store(0, std::memory_order_relaxed);
+    }
+  }
+};
+
+// Slots are only added to the front of the list
+std::atomic<WaitEventSlot *> slot_list{nullptr};
+
+// Holds the slot of a thread while it runs
+struct ThreadSlot {
+  WaitEventSlot *slot;
+
+  ThreadSlot() : slot(nullptr) {
+    for (auto free_slot = slot_list.load(); free_slot != nullptr;
+         free_slot = free_slot->next) {
+      bool is_used = false;
+      if (free_slot->is_used.compare_exchange_strong(is_used, true)) {
+        slot = free_slot;
+        return;
+      }
+    }
+    slot = new WaitEventSlot();
+    slot->next = slot_list.load();
+    while (slot_list.compare_exchange_weak(slot->next, slot) == false) {
+    }
+  }
+
+  ~ThreadSlot() { slot->is_used.store(false); }
+};
+
+WaitEventSlot &GetThreadSlot() {
+  thread_local ThreadSlot thread_slot;
+  return *thread_slot.slot;
+}
+
+// Only called by the thread owning the slot, which is the only writer of
+// the counter
+inline uint64_t AddTo(std::atomic<uint64_t> &counter, const uint64_t count) {
+  uint64_t value = counter.load(std::memory_order_relaxed) + count;
+  counter.store(value, std::memory_order_relaxed);
+  return value;
+}
+
+uint64_t GetSteadyTimeNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+std::string WaitEventTypeToString(WaitEventType type) {
+  switch (type) {
+    case WaitEventType::SPINLOCK:
+      return "SPINLOCK";
+    case WaitEventType::TUPLE_LATCH:
+      return "TUPLE_LATCH";
+    case WaitEventType::TILE_HEADER_LATCH:
+      return "TILE_HEADER_LATCH";
+    case WaitEventType::POOL_LATCH:
+      return "POOL_LATCH";
+    case WaitEventType::EPOCH_LATCH:
+      return "EPOCH_LATCH";
+    case WaitEventType::EPOCH_WAIT:
+      return "EPOCH_WAIT";
+    case WaitEventType::RETRY_BACKOFF:
+      return "RETRY_BACKOFF";
+  }
+  return "INVALID";
+}
+
+uint64_t WaitEvents::BeginWait(const WaitEventType type) {
+  auto type_idx = static_cast<size_t>(type);
+  auto wait_count = AddTo(GetThreadSlot().wait_counts[type_idx], 1);
+  if (wait_count % WAIT_SAMPLE_INTERVAL != 1) {
+    return 0;
+  }
+  return GetSteadyTimeNs();
+}
+
+void WaitEvents::EndWait(const WaitEventType type, const uint64_t begin_ns) {
+  if (begin_ns == 0) {
+    return;
+  }
+  auto type_idx = static_cast<size_t>(type);
+  auto &slot = GetThreadSlot();
+  AddTo(slot.timed_counts[type_idx], 1);
+  AddTo(slot.timed_ns[type_idx], GetSteadyTimeNs() - begin_ns);
+}
+
+void WaitEvents::RecordWait(const WaitEventType type, const uint64_t wait_us) {
+  auto type_idx = static_cast<size_t>(type);
+  auto &slot = GetThreadSlot();
+  AddTo(slot.wait_counts[type_idx], 1);
+  AddTo(slot.timed_counts[type_idx], 1);
+  AddTo(slot.timed_ns[type_idx], wait_us * 1000);
+}
+
+WaitEventTotals WaitEvents::GetTotals() {
+  uint64_t timed_counts[WAIT_EVENT_TYPE_COUNT] = {};
+  uint64_t timed_ns[WAIT_EVENT_TYPE_COUNT] = {};
+  WaitEventTotals totals;
+  for (auto slot = slot_list.load(); slot != nullptr; slot = slot->next) {
+    for (size_t type_idx = 0; type_idx < WAIT_EVENT_TYPE_COUNT; type_idx++) {
+      totals.wait_counts[type_idx] +=
+          slot->wait_counts[type_idx].load(std::memory_order_relaxed);
+      timed_counts[type_idx] +=
+          slot->timed_counts[type_idx].load(std::memory_order_relaxed);
+      timed_ns[type_idx] +=
+          slot->timed_ns[type_idx].load(std::memory_order_relaxed);
+    }
+  }
+
+  // The timed waits stand for all of them
+  for (size_t type_idx = 0; type_idx < WAIT_EVENT_TYPE_COUNT; type_idx++) {
+    if (timed_counts[type_idx] == 0) {
+      continue;
+    }
+    totals.wait_us[type_idx] = static_cast<uint64_t>(
+        static_cast<double>(timed_ns[type_idx]) / 1000 *
+        totals.wait_counts[type_idx] / timed_counts[type_idx]);
+  }
+  return totals;
+}
+
+}  // End peloton namespace
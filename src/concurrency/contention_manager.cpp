@@ -0,0 +1,193 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// contention_manager.cpp
+//
+// Identification: src/concurrency/contention_manager.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/contention_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "common/wait_events.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace concurrency {
+
+namespace {
+
+// Retry state of the transactions of a thread
+struct RetryState {
+  // tile group where the running transaction last conflicted, and how
+  oid_t conflict_tile_group_id = INVALID_OID;
+  ConflictType conflict_type = ConflictType::INVALID;
+
+  // tile group where the last aborted transaction conflicted
+  oid_t retry_tile_group_id = INVALID_OID;
+
+  // consecutive aborts
+  uint32_t abort_count = 0;
+
+  // admission slot held by the running retry
+  size_t admitted_slot = SIZE_MAX;
+};
+
+thread_local RetryState retry_state;
+
+thread_local std::minstd_rand retry_rng(
+    std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+uint32_t DecayedCount(const uint64_t entry, const uint32_t epoch_id) {
+  uint32_t entry_epoch_id = entry >> 32;
+  uint32_t count = entry & 0xFFFFFFFF;
+  uint32_t elapsed = epoch_id - entry_epoch_id;
+  // the count is halved every epoch
+  return elapsed >= 32 ? 0 : count >> elapsed;
+}
+
+uint32_t CurrentEpochId() {
+  return EpochManagerFactory::GetInstance().GetCurrentEpochId();
+}
+
+}  // End anonymous namespace
+
+ContentionManager &ContentionManager::GetInstance() {
+  static ContentionManager contention_manager;
+  return contention_manager;
+}
+
+ContentionManager::ContentionManager() { Reset(); }
+
+void ContentionManager::Reset() {
+  for (size_t slot = 0; slot < slot_count; slot++) {
+    conflict_counts[slot] = 0;
+    admitted_retries[slot] = 0;
+  }
+
+  std::lock_guard<std::mutex> lock(abort_counts_lock);
+  abort_counts.clear();
+}
+
+std::map<std::pair<oid_t, ConflictType>, uint64_t>
+ContentionManager::GetAbortCounts() {
+  std::lock_guard<std::mutex> lock(abort_counts_lock);
+  return abort_counts;
+}
+
+void ContentionManager::RecordConflict(const oid_t tile_group_id,
+                                       const ConflictType type) {
+  retry_state.conflict_tile_group_id = tile_group_id;
+  retry_state.conflict_type = type;
+
+  auto &conflict_count = conflict_counts[GetSlot(tile_group_id)];
+  uint64_t epoch_id = CurrentEpochId();
+  uint64_t entry = conflict_count.load();
+  uint64_t new_entry;
+  do {
+    new_entry = (epoch_id << 32) | (DecayedCount(entry, epoch_id) + 1);
+  } while (conflict_count.compare_exchange_weak(entry, new_entry) == false);
+}
+
+uint32_t ContentionManager::GetHotness(const oid_t tile_group_id) {
+  return DecayedCount(conflict_counts[GetSlot(tile_group_id)].load(),
+                      CurrentEpochId());
+}
+
+void ContentionManager::EndTransaction(const ResultType result) {
+  if (retry_state.admitted_slot != SIZE_MAX) {
+    admitted_retries[retry_state.admitted_slot]--;
+    retry_state.admitted_slot = SIZE_MAX;
+  }
+
+  if (result == ResultType::SUCCESS) {
+    retry_state.abort_count = 0;
+    retry_state.retry_tile_group_id = INVALID_OID;
+  } else {
+    retry_state.abort_count++;
+    retry_state.retry_tile_group_id = retry_state.conflict_tile_group_id;
+
+    oid_t table_id = INVALID_OID;
+    if (retry_state.conflict_tile_group_id != INVALID_OID) {
+      auto tile_group = catalog::Manager::GetInstance().ResolveTileGroup(
+          retry_state.conflict_tile_group_id);
+      if (tile_group != nullptr) {
+        table_id = tile_group->GetTableId();
+      }
+    }
+    std::lock_guard<std::mutex> lock(abort_counts_lock);
+    abort_counts[std::make_pair(table_id, retry_state.conflict_type)]++;
+  }
+  retry_state.conflict_tile_group_id = INVALID_OID;
+  retry_state.conflict_type = ConflictType::INVALID;
+}
+
+uint64_t ContentionManager::GetRetryBackoff() {
+  if (retry_state.abort_count == 0) {
+    return 0;
+  }
+
+  uint32_t shifts = std::min(retry_state.abort_count - 1, 10U);
+  uint64_t backoff = base_backoff << shifts;
+
+  // conflicts on a hot tile group are likely to repeat
+  if (retry_state.retry_tile_group_id != INVALID_OID &&
+      IsHot(retry_state.retry_tile_group_id) == true) {
+    backoff *= 2;
+  }
+
+  return std::min(backoff, max_backoff);
+}
+
+uint64_t ContentionManager::WaitBeforeRetry() {
+  uint64_t backoff = GetRetryBackoff();
+  if (backoff == 0) {
+    return 0;
+  }
+
+  // spread the retries of the transactions that aborted together
+  uint64_t wait_time = backoff / 2 + retry_rng() % (backoff / 2 + 1);
+  std::this_thread::sleep_for(std::chrono::microseconds(wait_time));
+
+  auto tile_group_id = retry_state.retry_tile_group_id;
+  if (tile_group_id == INVALID_OID || IsHot(tile_group_id) == false ||
+      retry_state.admitted_slot != SIZE_MAX) {
+    WaitEvents::RecordWait(WaitEventType::RETRY_BACKOFF, wait_time);
+    return wait_time;
+  }
+
+  // queue behind the admitted retries of the hot tile group. the wait is
+  // bounded, as a retry may never end if its client stops.
+  auto slot = GetSlot(tile_group_id);
+  auto &admitted = admitted_retries[slot];
+  while (wait_time < max_backoff) {
+    uint32_t admitted_count = admitted.load();
+    if (admitted_count < max_admitted_retries &&
+        admitted.compare_exchange_weak(admitted_count, admitted_count + 1)) {
+      retry_state.admitted_slot = slot;
+      WaitEvents::RecordWait(WaitEventType::RETRY_BACKOFF, wait_time);
+      return wait_time;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(base_backoff));
+    wait_time += base_backoff;
+  }
+
+  LOG_TRACE("Retry admitted after %lu us without a free slot", wait_time);
+  WaitEvents::RecordWait(WaitEventType::RETRY_BACKOFF, wait_time);
+  return wait_time;
+}
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -2,9 +2,9 @@
 //
 //                         Peloton
 //
-// centralized_epoch_manager.cpp
+// decentralized_epoch_manager.cpp
 //
-// Identification: src/concurrency/centralized_epoch_manager.cpp
+// Identification: src/concurrency/decentralized_epoch_manager.cpp
 //
 // Copyright (c) 2015-16, Carnegie Mellon University Database Group
 //
@@ -20,29 +20,51 @@ namespace concurrency {
   // enter epoch with thread id
   cid_t DecentralizedEpochManager::EnterEpoch(const size_t thread_id, const TimestampType ts_type) {
 
-    PL_ASSERT(local_epochs_.find(thread_id) != local_epochs_.end());
+    PL_ASSERT(thread_id < max_thread_count);
+    PL_ASSERT(registered_threads_[thread_id] == true);
+
+    auto &local_epoch = local_epochs_[thread_id];
 
     if (ts_type == TimestampType::SNAPSHOT_READ) {
 
-      local_epochs_.at(thread_id)->EnterEpoch(snapshot_global_epoch_id_, ts_type);
+      while (true) {
+        eid_t epoch_id = snapshot_global_epoch_id_.load();
+
+        local_epoch.EnterEpoch(epoch_id, ts_type);
 
-      return (snapshot_global_epoch_id_ << 32) | 0x0;
+        // the snapshot epoch did not advance while we entered it, so the
+        // epoch thread either sees this transaction or has not expired it.
+        if (snapshot_global_epoch_id_.load() == epoch_id) {
+          return (epoch_id << 32) | 0x0;
+        }
+
+        local_epoch.ExitEpoch(epoch_id);
+      }
 
     } else {
 
       while (true) {
-        uint64_t epoch_id = GetCurrentEpochId();
+        eid_t epoch_id = GetCurrentEpochId();
 
         // enter the corresponding local epoch.
-        bool rt = local_epochs_.at(thread_id)->EnterEpoch(epoch_id, ts_type);
+        bool rt = local_epoch.EnterEpoch(epoch_id, ts_type);
+
+        if (rt == false) {
+          continue;
+        }
+
+        // the epoch thread only expires an epoch once the global epoch has
+        // moved past it. if it is still current, the entry is visible to
+        // every later scan.
+        if (ts_type == TimestampType::COMMIT ||
+            GetCurrentEpochId() == epoch_id) {
 
-        // if successfully entered local epoch
-        if (rt == true) {
-      
           uint32_t next_txn_id = GetNextTransactionId();
 
           return (epoch_id << 32) | next_txn_id;
         }
+
+        local_epoch.ExitEpoch(epoch_id);
       }
 
     }
@@ -50,35 +72,65 @@ namespace concurrency {
 
   void DecentralizedEpochManager::ExitEpoch(const size_t thread_id, const eid_t epoch_id) {
 
-    PL_ASSERT(local_epochs_.find(thread_id) != local_epochs_.end());
+    PL_ASSERT(thread_id < max_thread_count);
 
     // exit from the corresponding local epoch.
-    local_epochs_.at(thread_id)->ExitEpoch(epoch_id);
+    local_epochs_[thread_id].ExitEpoch(epoch_id);
  
   }
 
 
-  eid_t DecentralizedEpochManager::GetExpiredEpochId() {
+  eid_t DecentralizedEpochManager::GetLocalExpiredEpochId(const eid_t current_epoch_id) {
     eid_t global_expired_eid = MAX_EID;
-    
+
     // for all the local epoch contexts, obtain the minimum max committed epoch id.
-    for (auto &local_epoch_itr : local_epochs_) {
-      
+    size_t thread_count = thread_count_.load();
+    for (size_t thread_id = 0; thread_id < thread_count; ++thread_id) {
+
+      if (registered_threads_[thread_id] == false) {
+        continue;
+      }
+
       // the centralized epoch manager must notify each local epoch
       // the current global epoch.
-      eid_t local_expired_eid = local_epoch_itr.second->GetExpiredEpochId(current_global_epoch_id_);
-      
+      eid_t local_expired_eid = local_epochs_[thread_id].GetExpiredEpochId(current_epoch_id);
+
       if (local_expired_eid < global_expired_eid) {
         global_expired_eid = local_expired_eid;
       }
     }
 
+    return global_expired_eid;
+  }
+
+
+  eid_t DecentralizedEpochManager::GetExpiredEpochId() {
+    // read the global epoch before the scan. any transaction missed by the
+    // scan has entered an epoch that is at least this one.
+    eid_t current_epoch_id = current_global_epoch_id_.load();
+
+    eid_t global_expired_eid = GetLocalExpiredEpochId(current_epoch_id);
+
     // if we observe that global_expired_eid is larger than snapshot_global_epoch,
     // then it means the current thread's progress is too slow.
     // we should directly update it to global_expired_eid + 1.
     if (global_expired_eid != MAX_EID && 
-        global_expired_eid >= snapshot_global_epoch_id_) {
-      snapshot_global_epoch_id_ = global_expired_eid + 1;
+        global_expired_eid >= snapshot_global_epoch_id_.load()) {
+      AdvanceSnapshotEpochId(global_expired_eid + 1);
+
+      // a read-only transaction may have entered the old snapshot epoch
+      // behind the scan. it is either seen now or it retries in the new one.
+      eid_t snapshot_expired_eid = GetLocalExpiredEpochId(current_epoch_id);
+      if (snapshot_expired_eid < global_expired_eid) {
+        global_expired_eid = snapshot_expired_eid;
+      }
+    }
+
+    if (global_expired_eid != MAX_EID) {
+      eid_t last_expired_eid = last_expired_epoch_id_.load();
+      while (last_expired_eid < global_expired_eid &&
+             last_expired_epoch_id_.compare_exchange_weak(
+                 last_expired_eid, global_expired_eid) == false);
     }
 
     return global_expired_eid;
@@ -2,7 +2,7 @@
 //
 //                         Peloton
 //
-// centralized_epoch_manager.cpp
+// local_epoch.cpp
 //
 // Identification: src/concurrency/local_epoch.cpp
 //
@@ -10,103 +10,151 @@
 //
 //===----------------------------------------------------------------------===//
 
-#include "concurrency/decentralized_epoch_manager.h"
+#include "concurrency/local_epoch.h"
+
+#include "common/macros.h"
 
 
 namespace peloton {
 namespace concurrency {
 
-  bool LocalEpoch::EnterEpoch(const eid_t epoch_id, const TimestampType ts_type) {
-
-    epoch_lock_.Lock();
-
-    // if this thread is never used or has been GC'd
-    if (epoch_id_lower_bound_ == UINT64_MAX) {
-
-      epoch_id_lower_bound_ = epoch_id - 1;
-    
-    } else if (epoch_id_lower_bound_ >= epoch_id) {
-    
-      if (ts_type == TimestampType::SNAPSHOT_READ) {
-    
-        epoch_id_lower_bound_ = epoch_id - 1;
-    
-      } else {
-        // epoch_id_lower_bound_ has already been updated by the GC.
-        // have to grab a newer epoch_id.
-        epoch_lock_.Unlock();
-
-        return false;
-      }
+  void LocalEpoch::Reset(const size_t thread_id) {
+    for (auto &slot : epoch_slots_) {
+      slot = 0;
     }
 
-    if (ts_type != TimestampType::COMMIT) {
+    overflow_lock_.Lock(WaitEventType::EPOCH_LATCH);
+    overflow_epochs_.clear();
+    overflow_count_ = 0;
+    overflow_lock_.Unlock();
 
-      auto epoch_map_itr = epoch_map_.find(epoch_id);
-      // check whether the corresponding epoch exists.
-      if (epoch_map_itr == epoch_map_.end()) {
+    epoch_id_lower_bound_ = UINT64_MAX;
+    thread_id_ = thread_id;
+  }
 
-        std::shared_ptr<Epoch> epoch_ptr(new Epoch(epoch_id, 1));
+  bool LocalEpoch::EnterEpoch(const eid_t epoch_id, const TimestampType ts_type) {
 
-        epoch_queue_.push(epoch_ptr);
-        epoch_map_[epoch_id] = epoch_ptr;
+    // a commit timestamp comes with a read timestamp that already holds back
+    // the expired epoch.
+    if (ts_type != TimestampType::COMMIT) {
+      Publish(epoch_id);
+    }
 
-      } else {
-        epoch_map_itr->second->txn_count_++;
-      }
-      
+    // a read-only transaction can always enter its snapshot epoch.
+    if (ts_type == TimestampType::SNAPSHOT_READ) {
+      return true;
     }
 
-    epoch_lock_.Unlock();
+    // the lower bound is checked after publishing the epoch, so either the
+    // epoch manager sees this transaction or we see the new lower bound.
+    uint64_t lower_bound = epoch_id_lower_bound_.load();
+    if (lower_bound != UINT64_MAX && lower_bound >= epoch_id) {
+      // the epoch has already been reported as expired.
+      // have to grab a newer epoch_id.
+      if (ts_type != TimestampType::COMMIT) {
+        Unpublish(epoch_id);
+      }
+      return false;
+    }
 
     return true;
   }
 
   void LocalEpoch::ExitEpoch(const eid_t epoch_id) {
-    epoch_lock_.Lock();
-
-    PL_ASSERT(epoch_map_.find(epoch_id) != epoch_map_.end());
-    epoch_map_.at(epoch_id)->txn_count_--;
-
-    while (epoch_queue_.size() != 0) {
-      auto &epoch_ptr = epoch_queue_.top();
-      if (epoch_ptr->txn_count_ == 0) {
-        epoch_map_.erase(epoch_ptr->epoch_id_);
-        epoch_queue_.pop();
-      } else {
-        PL_ASSERT(epoch_ptr->epoch_id_ > epoch_id_lower_bound_);
-        epoch_id_lower_bound_ = epoch_ptr->epoch_id_ - 1;
-        break;
+    Unpublish(epoch_id);
+  }
+
+  void LocalEpoch::Publish(const eid_t epoch_id) {
+    PL_ASSERT(GetSlotEpochId(PackSlot(epoch_id, 0)) == epoch_id);
+
+    // join the transactions already running in the epoch
+    for (auto &slot : epoch_slots_) {
+      uint64_t slot_value = slot.load();
+      while (GetSlotEpochId(slot_value) == epoch_id &&
+             GetSlotCount(slot_value) != 0) {
+        PL_ASSERT(GetSlotCount(slot_value) != count_mask);
+        if (slot.compare_exchange_weak(slot_value, slot_value + 1)) {
+          return;
+        }
+      }
+    }
+
+    // otherwise take a free slot
+    for (auto &slot : epoch_slots_) {
+      uint64_t slot_value = slot.load();
+      while (GetSlotCount(slot_value) == 0) {
+        if (slot.compare_exchange_weak(slot_value, PackSlot(epoch_id, 1))) {
+          return;
+        }
       }
     }
 
-    epoch_lock_.Unlock();
+    // every slot holds another running epoch
+    overflow_lock_.Lock(WaitEventType::EPOCH_LATCH);
+    overflow_epochs_[epoch_id]++;
+    overflow_count_++;
+    overflow_lock_.Unlock();
   }
 
-  uint64_t LocalEpoch::GetExpiredEpochId(const uint64_t epoch_id) {
-    epoch_lock_.Lock();
+  void LocalEpoch::Unpublish(const eid_t epoch_id) {
+    while (true) {
+      for (auto &slot : epoch_slots_) {
+        uint64_t slot_value = slot.load();
+        while (GetSlotEpochId(slot_value) == epoch_id &&
+               GetSlotCount(slot_value) != 0) {
+          if (slot.compare_exchange_weak(slot_value, slot_value - 1)) {
+            return;
+          }
+        }
+      }
+
+      overflow_lock_.Lock(WaitEventType::EPOCH_LATCH);
+      auto epoch_itr = overflow_epochs_.find(epoch_id);
+      if (epoch_itr != overflow_epochs_.end()) {
+        if (--epoch_itr->second == 0) {
+          overflow_epochs_.erase(epoch_itr);
+        }
+        overflow_count_--;
+        overflow_lock_.Unlock();
+        return;
+      }
+      overflow_lock_.Unlock();
+
+      // another thread sharing this local epoch has moved our count into a
+      // slot that we had already passed.
+    }
+  }
+
+  uint64_t LocalEpoch::GetExpiredEpochId(const uint64_t current_epoch_id) {
+    eid_t min_epoch_id = MAX_EID;
+
+    for (auto &slot : epoch_slots_) {
+      uint64_t slot_value = slot.load();
+      if (GetSlotCount(slot_value) != 0 &&
+          GetSlotEpochId(slot_value) < min_epoch_id) {
+        min_epoch_id = GetSlotEpochId(slot_value);
+      }
+    }
+
+    if (overflow_count_.load() != 0) {
+      overflow_lock_.Lock(WaitEventType::EPOCH_LATCH);
+      if (overflow_epochs_.empty() == false &&
+          overflow_epochs_.begin()->first < min_epoch_id) {
+        min_epoch_id = overflow_epochs_.begin()->first;
+      }
+      overflow_lock_.Unlock();
+    }
+
     // there's no epoch in this thread.
     // which indicates that this thread is never used or has been GC'd for some time.
-    if (epoch_queue_.size() == 0) {
-      epoch_id_lower_bound_ = epoch_id - 1;
+    uint64_t ret;
+    if (min_epoch_id == MAX_EID) {
+      ret = current_epoch_id - 1;
     } else {
-      while (epoch_queue_.size() != 0) {
-        // get the smallest epoch.
-        auto &epoch_ptr = epoch_queue_.top();
-        // if there's no transaction in the epoch
-        if (epoch_ptr->txn_count_ == 0) {
-          epoch_map_.erase(epoch_ptr->epoch_id_);
-          epoch_queue_.pop();
-        } else {
-          PL_ASSERT(epoch_ptr->epoch_id_ > epoch_id_lower_bound_);
-          epoch_id_lower_bound_ = epoch_ptr->epoch_id_ - 1;
-          break;
-        }
-      }
+      ret = min_epoch_id - 1;
     }
-    uint64_t ret = epoch_id_lower_bound_;
-    
-    epoch_lock_.Unlock();
+
+    epoch_id_lower_bound_ = ret;
     return ret;
   }
 
@@ -0,0 +1,192 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// optimistic_transaction_manager.cpp
+//
+// Identification: src/concurrency/optimistic_transaction_manager.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/optimistic_transaction_manager.h"
+
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "common/platform.h"
+#include "concurrency/contention_manager.h"
+#include "concurrency/transaction.h"
+
+namespace peloton {
+namespace concurrency {
+
+OptimisticTransactionManager &OptimisticTransactionManager::GetInstance(
+    const ProtocolType protocol,
+    const IsolationLevelType isolation,
+    const ConflictAvoidanceType conflict) {
+
+  static OptimisticTransactionManager txn_manager;
+
+  txn_manager.Init(protocol, isolation, conflict);
+
+  return txn_manager;
+}
+
+bool OptimisticTransactionManager::AcquireOwnership(
+    Transaction *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tuple_id) {
+  auto txn_id = current_txn->GetTransactionId();
+
+  if (tile_group_header->SetAtomicTransactionId(tuple_id, txn_id) == false) {
+    ContentionManager::GetInstance().RecordConflict(
+        tile_group_header->GetTileGroup()->GetTileGroupId(),
+        ConflictType::WRITE_WRITE);
+    return false;
+  }
+
+  // the tuple is being copied into another tile group, which would not
+  // observe the write. the relocation checks the owners after copying.
+  if (tile_group_header->IsRelocating() == true) {
+    tile_group_header->SetTransactionId(tuple_id, INITIAL_TXN_ID);
+    ContentionManager::GetInstance().RecordConflict(
+        tile_group_header->GetTileGroup()->GetTileGroupId(),
+        ConflictType::WRITE_WRITE);
+    return false;
+  }
+
+  // a frozen tile group is immutable. thaw it only after taking
+  // ownership, so that a concurrent freezer observes the new owner.
+  if (tile_group_header->IsFrozen() == true) {
+    tile_group_header->Thaw();
+  }
+
+  return true;
+}
+
+bool OptimisticTransactionManager::PerformRead(
+    Transaction *const current_txn, const ItemPointer &location,
+    bool acquire_ownership) {
+
+  // only serializable and repeatable reads track readers in the tuple
+  // headers under timestamp ordering. the other levels are shared.
+  if (current_txn->GetIsolationLevel() != IsolationLevelType::SERIALIZABLE &&
+      current_txn->GetIsolationLevel() !=
+          IsolationLevelType::REPEATABLE_READS) {
+    return TimestampOrderingTransactionManager::PerformRead(
+        current_txn, location, acquire_ownership);
+  }
+
+  oid_t tile_group_id = location.block;
+  oid_t tuple_id = location.offset;
+
+  LOG_TRACE("PerformRead (%u, %u)\n", location.block, location.offset);
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
+
+  if (IsOwner(current_txn, tile_group_header, tuple_id) == false) {
+    if (acquire_ownership == true) {
+      // select for update takes the write lock right away.
+      if (IsOwnable(current_txn, tile_group_header, tuple_id) == false) {
+        return false;
+      }
+      if (AcquireOwnership(current_txn, tile_group_header, tuple_id) ==
+          false) {
+        return false;
+      }
+
+      // Record RWType::READ_OWN
+      current_txn->RecordReadOwn(location);
+    } else {
+      // a concurrent owner is not a conflict yet. it is checked at commit.
+      current_txn->RecordRead(location);
+    }
+  }
+
+  // Increment table read op stats
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementTableReads(
+        location.block);
+  }
+  return true;
+}
+
+bool OptimisticTransactionManager::ValidateReadSet(
+    Transaction *const current_txn) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  oid_t tile_group_id = INVALID_OID;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+
+  for (auto &rw_entry : current_txn->GetReadWriteSet()) {
+    if (rw_entry.type != RWType::READ) {
+      continue;
+    }
+
+    if (rw_entry.location.block != tile_group_id) {
+      tile_group_id = rw_entry.location.block;
+      tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
+    }
+    auto tuple_slot = rw_entry.location.offset;
+
+    // the owner is released only after the end commit id is installed.
+    // checking it first guarantees that a writer that committed in between
+    // is seen through the end commit id.
+    if (tile_group_header->GetTransactionId(tuple_slot) != INITIAL_TXN_ID) {
+      LOG_TRACE("Version (%u, %u) is owned by a concurrent transaction",
+                tile_group_id, tuple_slot);
+      ContentionManager::GetInstance().RecordConflict(
+          tile_group_id, ConflictType::VALIDATION);
+      return false;
+    }
+
+    COMPILER_MEMORY_FENCE;
+
+    if (tile_group_header->GetEndCommitId(tuple_slot) != MAX_CID) {
+      LOG_TRACE("Version (%u, %u) has been overwritten", tile_group_id,
+                tuple_slot);
+      ContentionManager::GetInstance().RecordConflict(
+          tile_group_id, ConflictType::VALIDATION);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+ResultType OptimisticTransactionManager::CommitTransaction(
+    Transaction *const current_txn) {
+  // the ownership of the write set is already held, so the read set is
+  // validated against the final state of the transaction.
+  if (current_txn->GetIsolationLevel() == IsolationLevelType::SERIALIZABLE ||
+      current_txn->GetIsolationLevel() ==
+          IsolationLevelType::REPEATABLE_READS) {
+    if (ValidateReadSet(current_txn) == false) {
+      LOG_TRACE("Validation failed for txn : %lu ",
+                current_txn->GetTransactionId());
+      return AbortTransaction(current_txn);
+    }
+  }
+
+  return TimestampOrderingTransactionManager::CommitTransaction(current_txn);
+}
+
+ResultType OptimisticTransactionManager::PrepareTransaction(
+    Transaction *const current_txn) {
+  auto result = TimestampOrderingTransactionManager::PrepareTransaction(
+      current_txn);
+  if (result == ResultType::SUCCESS &&
+      (current_txn->GetIsolationLevel() == IsolationLevelType::SERIALIZABLE ||
+       current_txn->GetIsolationLevel() ==
+           IsolationLevelType::REPEATABLE_READS) &&
+      ValidateReadSet(current_txn) == false) {
+    LOG_TRACE("Validation failed for txn : %lu ",
+              current_txn->GetTransactionId());
+    return ResultType::ABORTED;
+  }
+  return result;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
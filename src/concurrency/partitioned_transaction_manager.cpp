@@ -0,0 +1,268 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_transaction_manager.cpp
+//
+// Identification: src/concurrency/partitioned_transaction_manager.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/partitioned_transaction_manager.h"
+
+#include <algorithm>
+
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "concurrency/contention_manager.h"
+#include "concurrency/transaction.h"
+#include "storage/data_table.h"
+#include "statistics/stats_aggregator.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace concurrency {
+
+namespace {
+
+// partitions of the transaction that is being begun or ended by this thread.
+// swapped with the transaction, so neither allocates in the common case.
+thread_local std::vector<size_t> partition_buffer;
+
+}  // namespace
+
+PartitionedTransactionManager &PartitionedTransactionManager::GetInstance(
+    const ProtocolType protocol,
+    const IsolationLevelType isolation,
+    const ConflictAvoidanceType conflict) {
+
+  static PartitionedTransactionManager txn_manager;
+
+  txn_manager.Init(protocol, isolation, conflict);
+
+  return txn_manager;
+}
+
+void PartitionedTransactionManager::SetPartitionCount(
+    const size_t partition_count) {
+  PL_ASSERT(partition_count > 0);
+
+  if (partition_count == partition_count_) {
+    return;
+  }
+
+  partitions_.reset(new Partition[partition_count]);
+  partition_count_ = partition_count;
+}
+
+Transaction *PartitionedTransactionManager::BeginPartitionTransaction(
+    const size_t thread_id, const std::vector<size_t> &partition_ids) {
+  partition_buffer.clear();
+  if (partition_ids.empty() == true) {
+    for (size_t partition_id = 0; partition_id < partition_count_;
+         partition_id++) {
+      partition_buffer.push_back(partition_id);
+    }
+  } else {
+    for (auto partition_id : partition_ids) {
+      PL_ASSERT(partition_id < partition_count_);
+      partition_buffer.push_back(partition_id);
+    }
+
+    // lock in partition order to avoid deadlocks
+    std::sort(partition_buffer.begin(), partition_buffer.end());
+    partition_buffer.erase(
+        std::unique(partition_buffer.begin(), partition_buffer.end()),
+        partition_buffer.end());
+  }
+
+  for (auto partition_id : partition_buffer) {
+    partitions_[partition_id].partition_lock.lock();
+  }
+
+  // the timestamps are taken once the partitions are held, so they follow
+  // the serial order of the transactions of each partition.
+  auto txn = BeginTransaction(thread_id);
+  txn->GetPartitionIds().swap(partition_buffer);
+
+  return txn;
+}
+
+void PartitionedTransactionManager::UnlockPartitions(
+    const std::vector<size_t> &partition_ids) {
+  for (auto partition_id : partition_ids) {
+    partitions_[partition_id].partition_lock.unlock();
+  }
+}
+
+bool PartitionedTransactionManager::AcquireOwnership(
+    Transaction *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tuple_id) {
+  if (current_txn->IsSinglePartition() == false) {
+    return TimestampOrderingTransactionManager::AcquireOwnership(
+        current_txn, tile_group_header, tuple_id);
+  }
+
+  // no transaction of a later timestamp can have read the version, as the
+  // partition was held by this transaction since it began.
+  auto txn_id = current_txn->GetTransactionId();
+  if (tile_group_header->SetAtomicTransactionId(tuple_id, txn_id) == false) {
+    ContentionManager::GetInstance().RecordConflict(
+        tile_group_header->GetTileGroup()->GetTileGroupId(),
+        ConflictType::WRITE_WRITE);
+    return false;
+  }
+
+  // the tuple is being copied into another tile group, which would not
+  // observe the write. the relocation checks the owners after copying.
+  if (tile_group_header->IsRelocating() == true) {
+    tile_group_header->SetTransactionId(tuple_id, INITIAL_TXN_ID);
+    ContentionManager::GetInstance().RecordConflict(
+        tile_group_header->GetTileGroup()->GetTileGroupId(),
+        ConflictType::WRITE_WRITE);
+    return false;
+  }
+
+  // a frozen tile group is immutable. thaw it only after taking
+  // ownership, so that a concurrent freezer observes the new owner.
+  if (tile_group_header->IsFrozen() == true) {
+    tile_group_header->Thaw();
+  }
+
+  return true;
+}
+
+bool PartitionedTransactionManager::PerformRead(
+    Transaction *const current_txn, const ItemPointer &location,
+    bool acquire_ownership) {
+  // select for update and the weaker isolation levels take the regular path
+  if (current_txn->IsSinglePartition() == false ||
+      acquire_ownership == true ||
+      (current_txn->GetIsolationLevel() != IsolationLevelType::SERIALIZABLE &&
+       current_txn->GetIsolationLevel() !=
+           IsolationLevelType::REPEATABLE_READS)) {
+    return TimestampOrderingTransactionManager::PerformRead(
+        current_txn, location, acquire_ownership);
+  }
+
+  LOG_TRACE("PerformRead (%u, %u)\n", location.block, location.offset);
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group_header =
+      manager.ResolveTileGroup(location.block)->GetHeader();
+
+  // the partition lock excludes every writer that could make the version
+  // stale, so the last reader of the version is not published.
+  if (IsOwner(current_txn, tile_group_header, location.offset) == false) {
+    if (IsOwned(current_txn, tile_group_header, location.offset) == true) {
+      LOG_TRACE("Transaction read failed");
+      ContentionManager::GetInstance().RecordConflict(
+          location.block, ConflictType::WRITE_READ);
+      return false;
+    }
+
+    current_txn->RecordRead(location);
+  }
+
+  // Increment table read op stats
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementTableReads(
+        location.block);
+  }
+  return true;
+}
+
+bool PartitionedTransactionManager::PerformInPlaceUpdate(
+    Transaction *const current_txn, storage::TileGroup *const tile_group,
+    const oid_t &tuple_id, const std::vector<oid_t> &column_ids) {
+  if (in_place_updates_ == false ||
+      current_txn->IsSinglePartition() == false) {
+    return false;
+  }
+
+  // a version written by this transaction is updated in place anyway
+  auto tile_group_header = tile_group->GetHeader();
+  PL_ASSERT(IsOwner(current_txn, tile_group_header, tuple_id) == true);
+  if (IsWritten(current_txn, tile_group_header, tuple_id) == true) {
+    return false;
+  }
+
+  // the index entries are built from the version, and the varlen values of
+  // the version are only released by the GC.
+  auto table =
+      dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+  PL_ASSERT(table != nullptr);
+  auto schema = table->GetSchema();
+  for (auto column_id : column_ids) {
+    if (schema->IsInlined(column_id) == false) {
+      return false;
+    }
+  }
+
+  for (size_t idx = 0; idx < table->GetIndexCount(); ++idx) {
+    auto index = table->GetIndex(idx);
+    if (index == nullptr) continue;
+    for (auto indexed_column : index->GetKeySchema()->GetIndexedColumns()) {
+      if (std::find(column_ids.begin(), column_ids.end(), indexed_column) !=
+          column_ids.end()) {
+        return false;
+      }
+    }
+  }
+
+  current_txn->RecordInPlaceUpdate(tile_group, tuple_id, column_ids);
+
+  // Increment table update op stats
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementTableUpdates(
+        tile_group->GetTileGroupId());
+  }
+  return true;
+}
+
+ResultType PartitionedTransactionManager::CommitTransaction(
+    Transaction *const current_txn) {
+  if (current_txn->GetPartitionIds().empty() == true) {
+    return TimestampOrderingTransactionManager::CommitTransaction(current_txn);
+  }
+
+  // the versions updated in place are stamped and logged by the commit
+
+  // the transaction object is released when it ends
+  partition_buffer.clear();
+  partition_buffer.swap(current_txn->GetPartitionIds());
+
+  auto result =
+      TimestampOrderingTransactionManager::CommitTransaction(current_txn);
+
+  UnlockPartitions(partition_buffer);
+
+  return result;
+}
+
+ResultType PartitionedTransactionManager::AbortTransaction(
+    Transaction *const current_txn) {
+  if (current_txn->GetPartitionIds().empty() == true) {
+    return TimestampOrderingTransactionManager::AbortTransaction(current_txn);
+  }
+
+  // restore the versions updated in place before their ownership goes
+  current_txn->GetUndoBuffer().Undo();
+
+  // the transaction object is released when it ends
+  partition_buffer.clear();
+  partition_buffer.swap(current_txn->GetPartitionIds());
+
+  auto result =
+      TimestampOrderingTransactionManager::AbortTransaction(current_txn);
+
+  UnlockPartitions(partition_buffer);
+
+  return result;
+}
+
+}  // End concurrency namespace
+}  // End peloton namespace
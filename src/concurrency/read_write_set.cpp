@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// read_write_set.cpp
+//
+// Identification: src/concurrency/read_write_set.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/read_write_set.h"
+
+#include "common/macros.h"
+
+namespace peloton {
+namespace concurrency {
+
+// tuple locations have no equality operator
+static inline bool IsSameLocation(const ItemPointer &lhs,
+                                  const ItemPointer &rhs) {
+  return lhs.block == rhs.block && lhs.offset == rhs.offset;
+}
+
+RWType *ReadWriteSet::Find(const ItemPointer &location) {
+  if (buckets_.empty() == true) {
+    for (auto &entry : entries_) {
+      if (IsSameLocation(entry.location, location) == true) {
+        return &entry.type;
+      }
+    }
+    return nullptr;
+  }
+
+  size_t mask = buckets_.size() - 1;
+  for (size_t bucket = Hash(location) & mask; buckets_[bucket] != 0;
+       bucket = (bucket + 1) & mask) {
+    auto &entry = entries_[buckets_[bucket] - 1];
+    if (IsSameLocation(entry.location, location) == true) {
+      return &entry.type;
+    }
+  }
+  return nullptr;
+}
+
+void ReadWriteSet::Insert(const ItemPointer &location, const RWType type) {
+  PL_ASSERT(Find(location) == nullptr);
+
+  entries_.emplace_back(location, type);
+
+  if (buckets_.empty() == true) {
+    if (entries_.size() > linear_search_limit) {
+      BuildIndex(linear_search_limit * 4);
+    }
+    return;
+  }
+
+  // keep the index at most half full
+  if (entries_.size() * 2 > buckets_.size()) {
+    BuildIndex(buckets_.size() * 2);
+    return;
+  }
+
+  size_t mask = buckets_.size() - 1;
+  size_t bucket = Hash(location) & mask;
+  while (buckets_[bucket] != 0) {
+    bucket = (bucket + 1) & mask;
+  }
+  buckets_[bucket] = entries_.size();
+}
+
+void ReadWriteSet::Clear() {
+  if (entries_.capacity() > max_retained_entry_count) {
+    std::vector<ReadWriteEntry>().swap(entries_);
+    std::vector<uint32_t>().swap(buckets_);
+    return;
+  }
+
+  entries_.clear();
+  buckets_.clear();
+}
+
+void ReadWriteSet::BuildIndex(const size_t bucket_count) {
+  PL_ASSERT((bucket_count & (bucket_count - 1)) == 0);
+
+  buckets_.assign(bucket_count, 0);
+
+  size_t mask = bucket_count - 1;
+  for (size_t entry_id = 0; entry_id < entries_.size(); entry_id++) {
+    size_t bucket = Hash(entries_[entry_id].location) & mask;
+    while (buckets_[bucket] != 0) {
+      bucket = (bucket + 1) & mask;
+    }
+    buckets_[bucket] = entry_id + 1;
+  }
+}
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -16,9 +16,13 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/platform.h"
+#include "concurrency/contention_manager.h"
 #include "concurrency/transaction.h"
 #include "gc/gc_manager_factory.h"
 #include "logging/log_manager_factory.h"
+#include "storage/aggregate_view.h"
+#include "storage/tile_group_classifier.h"
+#include "tcop/result_cache.h"
 
 namespace peloton {
 namespace concurrency {
@@ -51,7 +55,8 @@ bool TimestampOrderingTransactionManager::SetLastReaderCommitId(
   cid_t *ts_ptr = (cid_t *)(tile_group_header->GetReservedFieldRef(tuple_id) +
                             LAST_READER_OFFSET);
 
-  GetSpinlockField(tile_group_header, tuple_id)->Lock();
+  GetSpinlockField(tile_group_header, tuple_id)
+      ->Lock(WaitEventType::TUPLE_LATCH);
 
   txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
 
@@ -148,6 +153,12 @@ bool TimestampOrderingTransactionManager::IsOwnable(
     UNUSED_ATTRIBUTE Transaction *const current_txn,
     const storage::TileGroupHeader *const tile_group_header,
     const oid_t &tuple_id) {
+  // the versions of an append-only tile group are never replaced, and
+  // those of a tile group that is being deleted are owned by the deleter
+  if (tile_group_header->IsAppendOnly() == true ||
+      tile_group_header->IsDeleting() == true) {
+    return false;
+  }
   auto tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
   auto tuple_end_cid = tile_group_header->GetEndCommitId(tuple_id);
   return tuple_txn_id == INITIAL_TXN_ID &&
@@ -163,7 +174,8 @@ bool TimestampOrderingTransactionManager::AcquireOwnership(
   // to acquire the ownership, 
   // we must guarantee that no transaction that has read
   // the tuple has a larger timestamp than the current transaction.
-  GetSpinlockField(tile_group_header, tuple_id)->Lock();
+  GetSpinlockField(tile_group_header, tuple_id)
+      ->Lock(WaitEventType::TUPLE_LATCH);
   // change timestamp
   cid_t last_reader_cid = GetLastReaderCommitId(tile_group_header, tuple_id);
 
@@ -171,23 +183,62 @@ bool TimestampOrderingTransactionManager::AcquireOwnership(
   // (rather than read_id).
   // consider a transaction that is executed under snapshot isolation.
   // in this case, commit_id is not equal to read_id.
-  if (last_reader_cid > current_txn->GetCommitId()) {
+  //
+  // a transaction under snapshot isolation only conflicts with the
+  // concurrent writers of the tuple (first updater wins), so it ignores
+  // the readers. serializable readers are only ordered against other
+  // serializable writers.
+  bool check_readers =
+      current_txn->GetIsolationLevel() != IsolationLevelType::SNAPSHOT;
+  if (check_readers && last_reader_cid > current_txn->GetCommitId()) {
     GetSpinlockField(tile_group_header, tuple_id)->Unlock();
 
+    ContentionManager::GetInstance().RecordConflict(
+        tile_group_header->GetTileGroup()->GetTileGroupId(),
+        ConflictType::READ_WRITE);
     return false;
   } else {
     if (tile_group_header->SetAtomicTransactionId(tuple_id, txn_id) == false) {
       GetSpinlockField(tile_group_header, tuple_id)->Unlock();
 
+      ContentionManager::GetInstance().RecordConflict(
+          tile_group_header->GetTileGroup()->GetTileGroupId(),
+          ConflictType::WRITE_WRITE);
+      return false;
+    } else if (tile_group_header->IsRelocating() == true ||
+               tile_group_header->IsDeleting() == true) {
+      // the tuple is being copied into another tile group, which would not
+      // observe the write. the relocation checks the owners after copying.
+      // likewise, the delete of a tile group checks the owners after
+      // marking it.
+      tile_group_header->SetTransactionId(tuple_id, INITIAL_TXN_ID);
+      GetSpinlockField(tile_group_header, tuple_id)->Unlock();
+
+      ContentionManager::GetInstance().RecordConflict(
+          tile_group_header->GetTileGroup()->GetTileGroupId(),
+          ConflictType::WRITE_WRITE);
       return false;
     } else {
       GetSpinlockField(tile_group_header, tuple_id)->Unlock();
 
+      // a frozen tile group is immutable. thaw it only after taking
+      // ownership, so that a concurrent freezer observes the new owner.
+      if (tile_group_header->IsFrozen() == true) {
+        tile_group_header->Thaw();
+      }
+
       return true;
     }
   }
 }
 
+void TimestampOrderingTransactionManager::RecordRelocatedRead(
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t &tuple_id, const cid_t &commit_id) {
+  // the raise is recorded even if a transaction owns the tuple
+  SetLastReaderCommitId(tile_group_header, tuple_id, commit_id, true);
+}
+
 // release write lock on a tuple.
 // one example usage of this method is when a tuple is acquired, but operation
 // (insert,update,delete) can't proceed, the executor needs to yield the
@@ -208,6 +259,9 @@ bool TimestampOrderingTransactionManager::PerformRead(
 
   ItemPointer location = read_location;
 
+  // Count the read for the hot and cold tile groups
+  storage::TileGroupClassifier::RecordAccess(location.block);
+
   //////////////////////////////////////////////////////////
   //// handle READ_ONLY
   //////////////////////////////////////////////////////////
@@ -228,7 +282,8 @@ bool TimestampOrderingTransactionManager::PerformRead(
 
     LOG_TRACE("PerformRead (%u, %u)\n", location.block, location.offset);
     auto &manager = catalog::Manager::GetInstance();
-    auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    auto tile_group_header =
+        manager.ResolveTileGroup(tile_group_id)->GetHeader();
 
     // Check if it's select for update before we check the ownership 
     // and modify the last reader cid
@@ -240,7 +295,7 @@ bool TimestampOrderingTransactionManager::PerformRead(
       tile_group_id = location.block;
       tuple_id = location.offset;
 
-      tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+      tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
 
       if (IsOwner(current_txn, tile_group_header, tuple_id) == false) {
 
@@ -293,7 +348,8 @@ bool TimestampOrderingTransactionManager::PerformRead(
 
     LOG_TRACE("PerformRead (%u, %u)\n", location.block, location.offset);
     auto &manager = catalog::Manager::GetInstance();
-    auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    auto tile_group_header =
+        manager.ResolveTileGroup(tile_group_id)->GetHeader();
 
     // Check if it's select for update before we check the ownership.
     if (acquire_ownership == true) {
@@ -328,7 +384,8 @@ bool TimestampOrderingTransactionManager::PerformRead(
       // a transaction can never read an uncommitted version.
       if (IsOwner(current_txn, tile_group_header, tuple_id) == false) {
 
-        if (IsOwned(current_txn, tile_group_header, tuple_id) == false) {
+        if (IsOwned(current_txn, tile_group_header, tuple_id) == false &&
+            IsDeletedConcurrently(current_txn, tile_group_header) == false) {
 
           current_txn->RecordRead(location);
 
@@ -343,6 +400,8 @@ bool TimestampOrderingTransactionManager::PerformRead(
           // if the tuple has been owned by some concurrent transactions, 
           // then read fails.
           LOG_TRACE("Transaction read failed");
+          ContentionManager::GetInstance().RecordConflict(
+              tile_group_id, ConflictType::WRITE_READ);
           return false;
 
         }
@@ -377,7 +436,8 @@ bool TimestampOrderingTransactionManager::PerformRead(
 
     LOG_TRACE("PerformRead (%u, %u)\n", location.block, location.offset);
     auto &manager = catalog::Manager::GetInstance();
-    auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+    auto tile_group_header =
+        manager.ResolveTileGroup(tile_group_id)->GetHeader();
 
     // Check if it's select for update before we check the ownership 
     // and modify the last reader cid.
@@ -428,8 +488,11 @@ bool TimestampOrderingTransactionManager::PerformRead(
 
         // if the current transaction does not own this tuple, 
         // then attempt to set last reader cid.
+        // the deleter of a tile group checks the readers after marking it,
+        // so the mark is checked after the read is recorded.
         if (SetLastReaderCommitId(tile_group_header, tuple_id,
-                                  current_txn->GetCommitId(), false) == true) {
+                                  current_txn->GetCommitId(), false) == true &&
+            IsDeletedConcurrently(current_txn, tile_group_header) == false) {
           
           // update read set.
           current_txn->RecordRead(location);
@@ -444,6 +507,8 @@ bool TimestampOrderingTransactionManager::PerformRead(
           // if the tuple has been owned by some concurrent transactions, 
           // then read fails.
           LOG_TRACE("Transaction read failed");
+          ContentionManager::GetInstance().RecordConflict(
+              tile_group_id, ConflictType::WRITE_READ);
           return false;
         }
 
@@ -480,7 +545,8 @@ void TimestampOrderingTransactionManager::PerformInsert(
   oid_t tuple_id = location.offset;
 
   auto &manager = catalog::Manager::GetInstance();
-  auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+  auto tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
+  storage::TileGroupClassifier::RecordAccess(tile_group_header);
   auto transaction_id = current_txn->GetTransactionId();
 
   // check MVCC info
@@ -496,7 +562,10 @@ void TimestampOrderingTransactionManager::PerformInsert(
   // Add the new tuple into the insert set
   current_txn->RecordInsert(location);
 
-  InitTupleReserved(tile_group_header, tuple_id);
+  // no writer ever orders itself after the readers of an append-only tuple
+  if (tile_group_header->IsAppendOnly() == false) {
+    InitTupleReserved(tile_group_header, tuple_id);
+  }
 
   // Write down the head pointer's address in tile group header
   tile_group_header->SetIndirection(tuple_id, index_entry_ptr);
@@ -508,6 +577,30 @@ void TimestampOrderingTransactionManager::PerformInsert(
   }
 }
 
+void TimestampOrderingTransactionManager::PerformBulkInsert(
+    Transaction *const current_txn, const oid_t &tile_group_id,
+    const oid_t &tuple_count) {
+  PL_ASSERT(current_txn->GetIsolationLevel() != IsolationLevelType::READ_ONLY);
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
+  auto transaction_id = current_txn->GetTransactionId();
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    // the tuple slot must be empty.
+    PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID);
+    PL_ASSERT(tile_group_header->GetBeginCommitId(tuple_id) == MAX_CID);
+    PL_ASSERT(tile_group_header->GetEndCommitId(tuple_id) == MAX_CID);
+
+    tile_group_header->SetTransactionId(tuple_id, transaction_id);
+
+    InitTupleReserved(tile_group_header, tuple_id);
+  }
+
+  // Add the whole tile group into the bulk insert set
+  current_txn->RecordBulkInsert(tile_group_id, tuple_count);
+}
+
 void TimestampOrderingTransactionManager::PerformUpdate(
     Transaction *const current_txn, const ItemPointer &location,
     const ItemPointer &new_location) {
@@ -522,10 +615,11 @@ void TimestampOrderingTransactionManager::PerformUpdate(
 
   auto &manager = catalog::Manager::GetInstance();
 
-  auto tile_group_header = manager.GetTileGroup(old_location.block)
+  auto tile_group_header = manager.ResolveTileGroup(old_location.block)
                                   ->GetHeader();
-  auto new_tile_group_header = manager.GetTileGroup(new_location.block)
+  auto new_tile_group_header = manager.ResolveTileGroup(new_location.block)
                                       ->GetHeader();
+  storage::TileGroupClassifier::RecordAccess(tile_group_header);
 
   auto transaction_id = current_txn->GetTransactionId();
   // if we can perform update, then we must have already locked the older
@@ -544,6 +638,9 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   // Set double linked list
   // old_prev is the version next (newer) to the old version.
 
+  // shorten the chain of the version being replaced while it is at hand
+  PruneVersionChain(tile_group_header, old_location.offset);
+
   auto old_prev = tile_group_header->GetPrevItemPointer(old_location.offset);
 
   tile_group_header->SetPrevItemPointer(old_location.offset, new_location);
@@ -559,7 +656,7 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   COMPILER_MEMORY_FENCE;
 
   if (old_prev.IsNull() == false) {
-    auto old_prev_tile_group_header = manager.GetTileGroup(old_prev.block)
+    auto old_prev_tile_group_header = manager.ResolveTileGroup(old_prev.block)
                                              ->GetHeader();
 
     // once everything is set, we can allow traversing the new version.
@@ -613,7 +710,8 @@ void TimestampOrderingTransactionManager::PerformUpdate(
   oid_t tuple_id = location.offset;
 
   auto &manager = catalog::Manager::GetInstance();
-  auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+  auto tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
+  storage::TileGroupClassifier::RecordAccess(tile_group_header);
 
   PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) ==
             current_txn->GetTransactionId());
@@ -645,14 +743,19 @@ void TimestampOrderingTransactionManager::PerformDelete(
 
   auto &manager = catalog::Manager::GetInstance();
 
-  auto tile_group_header = manager.GetTileGroup(old_location.block)
+  auto tile_group_header = manager.ResolveTileGroup(old_location.block)
                                   ->GetHeader();
-  auto new_tile_group_header = manager.GetTileGroup(new_location.block)
+  auto new_tile_group_header = manager.ResolveTileGroup(new_location.block)
                                       ->GetHeader();
+  storage::TileGroupClassifier::RecordAccess(tile_group_header);
 
   auto transaction_id = current_txn->GetTransactionId();
 
-  PL_ASSERT(GetLastReaderCommitId(tile_group_header, old_location.offset) ==
+  // optimistic and single-partition transactions do not track readers in
+  // the tuple header.
+  PL_ASSERT(protocol_ == ProtocolType::OPTIMISTIC ||
+            protocol_ == ProtocolType::PARTITIONED ||
+            GetLastReaderCommitId(tile_group_header, old_location.offset) ==
             current_txn->GetCommitId());
 
   PL_ASSERT(tile_group_header->GetTransactionId(old_location.offset) ==
@@ -666,6 +769,9 @@ void TimestampOrderingTransactionManager::PerformDelete(
 
   // Set up double linked list
 
+  // shorten the chain of the version being replaced while it is at hand
+  PruneVersionChain(tile_group_header, old_location.offset);
+
   auto old_prev = tile_group_header->GetPrevItemPointer(old_location.offset);
 
   tile_group_header->SetPrevItemPointer(old_location.offset, new_location);
@@ -683,7 +789,7 @@ void TimestampOrderingTransactionManager::PerformDelete(
   COMPILER_MEMORY_FENCE;
 
   if (old_prev.IsNull() == false) {
-    auto old_prev_tile_group_header = manager.GetTileGroup(old_prev.block)
+    auto old_prev_tile_group_header = manager.ResolveTileGroup(old_prev.block)
                                              ->GetHeader();
 
     old_prev_tile_group_header->SetNextItemPointer(old_prev.offset,
@@ -735,7 +841,8 @@ void TimestampOrderingTransactionManager::PerformDelete(
   oid_t tuple_id = location.offset;
 
   auto &manager = catalog::Manager::GetInstance();
-  auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
+  auto tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
+  storage::TileGroupClassifier::RecordAccess(tile_group_header);
 
   PL_ASSERT(tile_group_header->GetTransactionId(tuple_id) ==
             current_txn->GetTransactionId());
@@ -760,6 +867,83 @@ void TimestampOrderingTransactionManager::PerformDelete(
   }
 }
 
+bool TimestampOrderingTransactionManager::PerformTileGroupDelete(
+    Transaction *const current_txn, const oid_t &tile_group_id) {
+  PL_ASSERT(current_txn->GetIsolationLevel() != IsolationLevelType::READ_ONLY);
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group = manager.ResolveTileGroup(tile_group_id);
+  auto tile_group_header = tile_group->GetHeader();
+
+  // the tile group may still receive inserts
+  if (tile_group_header->GetCurrentNextTupleSlot() <
+      tile_group->GetAllocatedTupleCount()) {
+    return false;
+  }
+
+  if (tile_group_header->IsRelocating() == true ||
+      tile_group_header->StartDelete(current_txn->GetTransactionId(),
+                                     current_txn->GetReadId()) == false) {
+    return false;
+  }
+
+  // once the tile group is marked, no writer can take ownership of its
+  // tuples. every version that is not empty must be committed and either
+  // visible to the transaction or older than its snapshot. as in
+  // AcquireOwnership(), a snapshot transaction ignores the readers.
+  bool check_readers =
+      current_txn->GetIsolationLevel() != IsolationLevelType::SNAPSHOT;
+  cid_t read_id = current_txn->GetReadId();
+  oid_t slot_count = tile_group_header->GetCurrentNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < slot_count; tuple_id++) {
+    txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
+    if (tuple_txn_id == INVALID_TXN_ID) {
+      continue;
+    }
+
+    cid_t tuple_begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+    cid_t tuple_end_cid = tile_group_header->GetEndCommitId(tuple_id);
+    bool changed = tuple_txn_id != INITIAL_TXN_ID ||
+                   (tuple_end_cid == MAX_CID && tuple_begin_cid > read_id) ||
+                   (tuple_end_cid != MAX_CID && tuple_end_cid > read_id);
+    if (changed == false && check_readers == true) {
+      GetSpinlockField(tile_group_header, tuple_id)
+          ->Lock(WaitEventType::TUPLE_LATCH);
+      changed = GetLastReaderCommitId(tile_group_header, tuple_id) >
+                current_txn->GetCommitId();
+      GetSpinlockField(tile_group_header, tuple_id)->Unlock();
+    }
+
+    if (changed == true) {
+      tile_group_header->FinishDelete();
+      ContentionManager::GetInstance().RecordConflict(
+          tile_group_id, ConflictType::WRITE_WRITE);
+      return false;
+    }
+  }
+
+  current_txn->RecordTileGroupDelete(tile_group_id);
+  return true;
+}
+
+bool TimestampOrderingTransactionManager::IsDeletedConcurrently(
+    Transaction *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header) {
+  if (tile_group_header->IsDeleting() == false) {
+    return false;
+  }
+  txn_id_t deleting_txn_id = tile_group_header->GetDeletingTransactionId();
+  if (deleting_txn_id == INVALID_TXN_ID ||
+      deleting_txn_id == current_txn->GetTransactionId() ||
+      tile_group_header->GetDeletedCommitId() != MAX_CID) {
+    return false;
+  }
+  ContentionManager::GetInstance().RecordConflict(
+      tile_group_header->GetTileGroup()->GetTileGroupId(),
+      ConflictType::WRITE_READ);
+  return true;
+}
+
 ResultType TimestampOrderingTransactionManager::CommitTransaction(
     Transaction *const current_txn) {
   LOG_TRACE("Committing peloton txn : %lu ", current_txn->GetTransactionId());
@@ -776,23 +960,47 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
   //// handle other isolation levels
   //////////////////////////////////////////////////////////
 
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()
+        ->GetCommitLatencyMetric()
+        .StartTimer();
+  }
+
   auto &manager = catalog::Manager::GetInstance();
-  auto &log_manager = logging::LogManager::GetInstance();
+  auto &log_manager = logging::LogManagerFactory::GetInstance();
 
-  log_manager.StartLogging();
-  
   // generate transaction id.
   cid_t end_commit_id = current_txn->GetCommitId();
+
+  log_manager.LogBegin(current_txn->GetEpochId(), end_commit_id);
+
+  // all the writes were made by logged statements, which are replayed
+  // instead of the tuples
+  if (current_txn->IsCommandLogged() == true) {
+    log_manager.LogCommands(current_txn->GetCommandLog());
+  }
+
+  // the versions updated in place now hold the values of this transaction.
+  // they are still owned, so readers do not see them before the stamp.
+  for (auto &undo_record : current_txn->GetUndoBuffer()) {
+    auto tile_group_header =
+        manager.ResolveTileGroup(undo_record.location.block)->GetHeader();
+    tile_group_header->SetBeginCommitId(undo_record.location.offset,
+                                        end_commit_id);
+    log_manager.LogUpdate(undo_record.location, INVALID_ITEMPOINTER);
+  }
   
   auto &rw_set = current_txn->GetReadWriteSet();
 
-  auto gc_set = current_txn->GetGCSetPtr();
+  // the aggregate views read the new and the old versions before they are
+  // installed
+  storage::AggregateViewManager::GetInstance().RecordCommit(current_txn);
 
   oid_t database_id = 0;
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     if (!rw_set.empty()) {
-      database_id =
-          manager.GetTileGroup(rw_set.begin()->first)->GetDatabaseId();
+      database_id = manager.ResolveTileGroup(rw_set.begin()->location.block)
+                        ->GetDatabaseId();
     }
   }
 
@@ -800,120 +1008,179 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
   // 1. install a new version for update operations;
   // 2. install an empty version for delete operations;
   // 3. install a new tuple for insert operations.
-  for (auto &tile_group_entry : rw_set) {
-    
-    oid_t tile_group_id = tile_group_entry.first;
-    auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
-
-    for (auto &tuple_entry : tile_group_entry.second) {
-      
-      auto tuple_slot = tuple_entry.first;
-      
-      if (tuple_entry.second == RWType::READ_OWN) {
-        // A read operation has acquired ownership but hasn't done any further
-        // update/delete yet
-        // Yield the ownership
-        YieldOwnership(current_txn, tile_group_header, tuple_slot);
-      } else if (tuple_entry.second == RWType::UPDATE) {
-        // we must guarantee that, at any time point, only one version is
-        // visible.
-        ItemPointer new_version =
-            tile_group_header->GetPrevItemPointer(tuple_slot);
-
-        PL_ASSERT(new_version.IsNull() == false);
-
-        auto cid = tile_group_header->GetEndCommitId(tuple_slot);
-        PL_ASSERT(cid > end_commit_id);
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
-        new_tile_group_header->SetBeginCommitId(new_version.offset,
-                                                end_commit_id);
-        new_tile_group_header->SetEndCommitId(new_version.offset, cid);
-
-        COMPILER_MEMORY_FENCE;
-
-        tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
-
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
-
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INITIAL_TXN_ID);
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
-
-        // add to gc set.
-        gc_set->operator[](tile_group_id)[tuple_slot] = false;
-
-        log_manager.LogUpdate(new_version);
-
-      } else if (tuple_entry.second == RWType::DELETE) {
-        ItemPointer new_version =
-            tile_group_header->GetPrevItemPointer(tuple_slot);
-
-        auto cid = tile_group_header->GetEndCommitId(tuple_slot);
-        PL_ASSERT(cid > end_commit_id);
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
-        new_tile_group_header->SetBeginCommitId(new_version.offset,
-                                                end_commit_id);
-        new_tile_group_header->SetEndCommitId(new_version.offset, cid);
-
-        COMPILER_MEMORY_FENCE;
-
-        tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
+  oid_t tile_group_id = INVALID_OID;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+
+  for (auto &rw_entry : rw_set) {
+    // consecutive entries often share a tile group
+    if (rw_entry.location.block != tile_group_id) {
+      tile_group_id = rw_entry.location.block;
+      tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
+    }
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+    auto tuple_slot = rw_entry.location.offset;
+    
+    if (rw_entry.type == RWType::READ_OWN) {
+      // A read operation has acquired ownership but hasn't done any further
+      // update/delete yet
+      // Yield the ownership
+      YieldOwnership(current_txn, tile_group_header, tuple_slot);
+    } else if (rw_entry.type == RWType::UPDATE) {
+      // we must guarantee that, at any time point, only one version is
+      // visible.
+      ItemPointer new_version =
+          tile_group_header->GetPrevItemPointer(tuple_slot);
+
+      PL_ASSERT(new_version.IsNull() == false);
+
+      auto cid = tile_group_header->GetEndCommitId(tuple_slot);
+      PL_ASSERT(cid > end_commit_id);
+      auto new_tile_group_header =
+          manager.ResolveTileGroup(new_version.block)->GetHeader();
+      new_tile_group_header->SetBeginCommitId(new_version.offset,
+                                              end_commit_id);
+      new_tile_group_header->SetEndCommitId(new_version.offset, cid);
+
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
+
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
+
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INITIAL_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+
+      // add to gc set.
+      current_txn->RecordGarbage(ItemPointer(tile_group_id, tuple_slot), false);
+
+      log_manager.LogUpdate(new_version,
+                            ItemPointer(tile_group_id, tuple_slot));
+
+    } else if (rw_entry.type == RWType::DELETE) {
+      ItemPointer new_version =
+          tile_group_header->GetPrevItemPointer(tuple_slot);
+
+      auto cid = tile_group_header->GetEndCommitId(tuple_slot);
+      PL_ASSERT(cid > end_commit_id);
+      auto new_tile_group_header =
+          manager.ResolveTileGroup(new_version.block)->GetHeader();
+      new_tile_group_header->SetBeginCommitId(new_version.offset,
+                                              end_commit_id);
+      new_tile_group_header->SetEndCommitId(new_version.offset, cid);
+
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetEndCommitId(tuple_slot, end_commit_id);
+
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
+
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+
+      // add to gc set.
+      // we need to recycle both old and new versions.
+      // we require the GC to delete tuple from index only once.
+      // recycle old version, delete from index
+      current_txn->RecordGarbage(ItemPointer(tile_group_id, tuple_slot), true);
+      // recycle new version (which is an empty version), do not delete from index
+      current_txn->RecordGarbage(new_version, false);
+
+      log_manager.LogDelete(ItemPointer(tile_group_id, tuple_slot));
+
+    } else if (rw_entry.type == RWType::INSERT) {
+      PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
+                current_txn->GetTransactionId());
+      // set the begin commit id to persist insert
+      tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+
+      if (tile_group_header->IsAppendOnly() == true) {
+        tile_group_header->CommitAppend(end_commit_id);
+      }
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      // nothing to be added to gc set.
 
-        // add to gc set.
-        // we need to recycle both old and new versions.
-        // we require the GC to delete tuple from index only once.
-        // recycle old version, delete from index
-        gc_set->operator[](tile_group_id)[tuple_slot] = true;
-        // recycle new version (which is an empty version), do not delete from index
-        gc_set->operator[](new_version.block)[new_version.offset] = false;
+      log_manager.LogInsert(ItemPointer(tile_group_id, tuple_slot));
 
-        log_manager.LogDelete(ItemPointer(tile_group_id, tuple_slot));
+    } else if (rw_entry.type == RWType::INS_DEL) {
+      PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
+                current_txn->GetTransactionId());
 
-      } else if (tuple_entry.second == RWType::INSERT) {
-        PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
-                  current_txn->GetTransactionId());
-        // set the begin commit id to persist insert
-        tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      // set the begin commit id to persist insert
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
 
-        // nothing to be added to gc set.
+      if (tile_group_header->IsAppendOnly() == true) {
+        tile_group_header->AbortAppend();
+      }
 
-        log_manager.LogInsert(ItemPointer(tile_group_id, tuple_slot));
+      // add to gc set.
+      current_txn->RecordGarbage(ItemPointer(tile_group_id, tuple_slot), true);
 
-      } else if (tuple_entry.second == RWType::INS_DEL) {
-        PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
-                  current_txn->GetTransactionId());
+      // no log is needed for this case
+    }
+  }
 
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+  // install the bulk loaded tile groups, one pass per tile group.
+  for (auto &bulk_entry : current_txn->GetBulkInsertSet()) {
+    oid_t tile_group_id = bulk_entry.first;
+    oid_t tuple_count = bulk_entry.second;
+    auto tile_group_header =
+        manager.ResolveTileGroup(tile_group_id)->GetHeader();
+
+    for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+      PL_ASSERT(tile_group_header->GetTransactionId(tuple_slot) ==
+                current_txn->GetTransactionId());
+      tile_group_header->SetBeginCommitId(tuple_slot, end_commit_id);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+    }
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+    // we should set the versions before releasing the locks.
+    COMPILER_MEMORY_FENCE;
 
-        // set the begin commit id to persist insert
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+    for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-        // add to gc set.
-        gc_set->operator[](tile_group_id)[tuple_slot] = true;
+      log_manager.LogInsert(ItemPointer(tile_group_id, tuple_slot));
+    }
+  }
 
-        // no log is needed for this case
+  // delete the visible versions of the tile groups deleted as a whole. the
+  // gc drops their index entries and the tile groups themselves.
+  for (auto deleted_tile_group_id : current_txn->GetDeletedTileGroupSet()) {
+    auto tile_group_header =
+        manager.ResolveTileGroup(deleted_tile_group_id)->GetHeader();
+    tile_group_header->CommitDelete(end_commit_id);
+
+    oid_t slot_count = tile_group_header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+      if (tile_group_header->IsDeletedSlot(tuple_slot) == true) {
+        log_manager.LogDelete(ItemPointer(deleted_tile_group_id, tuple_slot));
       }
     }
+
+    current_txn->RecordGarbage(ItemPointer(deleted_tile_group_id, INVALID_OID),
+                               true);
+  }
+
+  // the cached results of the tables written are stale once the versions
+  // are installed
+  if (FLAGS_result_cache_size > 0) {
+    tcop::ResultCache::GetInstance().RecordCommit(current_txn);
   }
 
   ResultType result = current_txn->GetResult();
@@ -924,8 +1191,9 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
 
   // Increment # txns committed metric
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
-    stats::BackendStatsContext::GetInstance()->IncrementTxnCommitted(
-        database_id);
+    auto stats_context = stats::BackendStatsContext::GetInstance();
+    stats_context->GetCommitLatencyMetric().RecordLatency();
+    stats_context->IncrementTxnCommitted(database_id);
   }
 
   return result;
@@ -933,175 +1201,223 @@ ResultType TimestampOrderingTransactionManager::CommitTransaction(
 
 ResultType TimestampOrderingTransactionManager::AbortTransaction(
     Transaction *const current_txn) {
-  // a pre-declared read-only transaction will never abort.
-  PL_ASSERT(current_txn->GetIsolationLevel() != IsolationLevelType::READ_ONLY);
-
   LOG_TRACE("Aborting peloton txn : %lu ", current_txn->GetTransactionId());
+
+  //////////////////////////////////////////////////////////
+  //// handle READ_ONLY
+  //////////////////////////////////////////////////////////
+  // a pre-declared read-only transaction has nothing to undo. it is only
+  // aborted by an explicit rollback.
+  if (current_txn->GetIsolationLevel() == IsolationLevelType::READ_ONLY) {
+    current_txn->SetResult(ResultType::ABORTED);
+    EndTransaction(current_txn);
+    return ResultType::ABORTED;
+  }
+
   auto &manager = catalog::Manager::GetInstance();
 
   auto &rw_set = current_txn->GetReadWriteSet();
 
-  auto gc_set = current_txn->GetGCSetPtr();
-
   oid_t database_id = 0;
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     if (!rw_set.empty()) {
-      database_id =
-          manager.GetTileGroup(rw_set.begin()->first)->GetDatabaseId();
+      database_id = manager.ResolveTileGroup(rw_set.begin()->location.block)
+                        ->GetDatabaseId();
     }
   }
 
-  for (auto &tile_group_entry : rw_set) {
-    oid_t tile_group_id = tile_group_entry.first;
-    auto tile_group_header = manager.GetTileGroup(tile_group_id)->GetHeader();
-
-    for (auto &tuple_entry : tile_group_entry.second) {
-      auto tuple_slot = tuple_entry.first;
-      if (tuple_entry.second == RWType::READ_OWN) {
-        // A read operation has acquired ownership but hasn't done any further
-        // update/delete yet
-        // Yield the ownership
-        YieldOwnership(current_txn, tile_group_header, tuple_slot);
-      } else if (tuple_entry.second == RWType::UPDATE) {
-        ItemPointer new_version =
-            tile_group_header->GetPrevItemPointer(tuple_slot);
-
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
-
-        // these two fields can be set at any time.
-        new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
-
-        COMPILER_MEMORY_FENCE;
-
-        // as the aborted version has already been placed in the version chain,
-        // we need to unlink it by resetting the item pointers.
-        auto old_prev =
-            new_tile_group_header->GetPrevItemPointer(new_version.offset);
-
-        // check whether the previous version exists.
-        if (old_prev.IsNull() == true) {
-          PL_ASSERT(tile_group_header->GetEndCommitId(tuple_slot) == MAX_CID);
-          // if we updated the latest version.
-          // We must first adjust the head pointer
-          // before we unlink the aborted version from version list
-          ItemPointer *index_entry_ptr =
-              tile_group_header->GetIndirection(tuple_slot);
-          UNUSED_ATTRIBUTE auto res = AtomicUpdateItemPointer(
-              index_entry_ptr, ItemPointer(tile_group_id, tuple_slot));
-          PL_ASSERT(res == true);
-        }
-        //////////////////////////////////////////////////
+  oid_t tile_group_id = INVALID_OID;
+  storage::TileGroupHeader *tile_group_header = nullptr;
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+  for (auto &rw_entry : rw_set) {
+    // consecutive entries often share a tile group
+    if (rw_entry.location.block != tile_group_id) {
+      tile_group_id = rw_entry.location.block;
+      tile_group_header = manager.ResolveTileGroup(tile_group_id)->GetHeader();
+    }
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
+    auto tuple_slot = rw_entry.location.offset;
+    if (rw_entry.type == RWType::READ_OWN) {
+      // A read operation has acquired ownership but hasn't done any further
+      // update/delete yet
+      // Yield the ownership
+      YieldOwnership(current_txn, tile_group_header, tuple_slot);
+    } else if (rw_entry.type == RWType::UPDATE) {
+      ItemPointer new_version =
+          tile_group_header->GetPrevItemPointer(tuple_slot);
+
+      auto new_tile_group_header =
+          manager.ResolveTileGroup(new_version.block)->GetHeader();
+
+      // these two fields can be set at any time.
+      new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+
+      COMPILER_MEMORY_FENCE;
+
+      // as the aborted version has already been placed in the version chain,
+      // we need to unlink it by resetting the item pointers.
+      auto old_prev =
+          new_tile_group_header->GetPrevItemPointer(new_version.offset);
+
+      // check whether the previous version exists.
+      if (old_prev.IsNull() == true) {
+        PL_ASSERT(tile_group_header->GetEndCommitId(tuple_slot) == MAX_CID);
+        // if we updated the latest version.
+        // We must first adjust the head pointer
+        // before we unlink the aborted version from version list
+        ItemPointer *index_entry_ptr =
+            tile_group_header->GetIndirection(tuple_slot);
+        UNUSED_ATTRIBUTE auto res = AtomicUpdateItemPointer(
+            index_entry_ptr, ItemPointer(tile_group_id, tuple_slot));
+        PL_ASSERT(res == true);
+      }
+      //////////////////////////////////////////////////
 
-        if (old_prev.IsNull() == false) {
-          auto old_prev_tile_group_header = catalog::Manager::GetInstance()
-                                                .GetTileGroup(old_prev.block)
-                                                ->GetHeader();
-          old_prev_tile_group_header->SetNextItemPointer(
-              old_prev.offset, ItemPointer(tile_group_id, tuple_slot));
-          tile_group_header->SetPrevItemPointer(tuple_slot, old_prev);
-        } else {
-          tile_group_header->SetPrevItemPointer(tuple_slot,
-                                                INVALID_ITEMPOINTER);
-        }
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
 
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      if (old_prev.IsNull() == false) {
+        auto old_prev_tile_group_header = catalog::Manager::GetInstance()
+                                              .ResolveTileGroup(old_prev.block)
+                                              ->GetHeader();
+        old_prev_tile_group_header->SetNextItemPointer(
+            old_prev.offset, ItemPointer(tile_group_id, tuple_slot));
+        tile_group_header->SetPrevItemPointer(tuple_slot, old_prev);
+      } else {
+        tile_group_header->SetPrevItemPointer(tuple_slot,
+                                              INVALID_ITEMPOINTER);
+      }
 
-        // add to gc set.
-        gc_set->operator[](new_version.block)[new_version.offset] = false;
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
 
-      } else if (tuple_entry.second == RWType::DELETE) {
-        ItemPointer new_version =
-            tile_group_header->GetPrevItemPointer(tuple_slot);
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-        auto new_tile_group_header =
-            manager.GetTileGroup(new_version.block)->GetHeader();
+      // add to gc set.
+      current_txn->RecordGarbage(new_version, false);
 
-        new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
-        new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
+    } else if (rw_entry.type == RWType::DELETE) {
+      ItemPointer new_version =
+          tile_group_header->GetPrevItemPointer(tuple_slot);
 
-        COMPILER_MEMORY_FENCE;
+      auto new_tile_group_header =
+          manager.ResolveTileGroup(new_version.block)->GetHeader();
 
-        // as the aborted version has already been placed in the version chain,
-        // we need to unlink it by resetting the item pointers.
-        auto old_prev =
-            new_tile_group_header->GetPrevItemPointer(new_version.offset);
+      new_tile_group_header->SetBeginCommitId(new_version.offset, MAX_CID);
+      new_tile_group_header->SetEndCommitId(new_version.offset, MAX_CID);
 
-        // check whether the previous version exists.
-        if (old_prev.IsNull() == true) {
-          // if we updated the latest version.
-          // We must first adjust the head pointer
-          // before we unlink the aborted version from version list
-          ItemPointer *index_entry_ptr =
-              tile_group_header->GetIndirection(tuple_slot);
-          UNUSED_ATTRIBUTE auto res = AtomicUpdateItemPointer(
-              index_entry_ptr, ItemPointer(tile_group_id, tuple_slot));
-          PL_ASSERT(res == true);
-        }
-        //////////////////////////////////////////////////
+      COMPILER_MEMORY_FENCE;
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+      // as the aborted version has already been placed in the version chain,
+      // we need to unlink it by resetting the item pointers.
+      auto old_prev =
+          new_tile_group_header->GetPrevItemPointer(new_version.offset);
 
-        new_tile_group_header->SetTransactionId(new_version.offset,
-                                                INVALID_TXN_ID);
+      // check whether the previous version exists.
+      if (old_prev.IsNull() == true) {
+        // if we updated the latest version.
+        // We must first adjust the head pointer
+        // before we unlink the aborted version from version list
+        ItemPointer *index_entry_ptr =
+            tile_group_header->GetIndirection(tuple_slot);
+        UNUSED_ATTRIBUTE auto res = AtomicUpdateItemPointer(
+            index_entry_ptr, ItemPointer(tile_group_id, tuple_slot));
+        PL_ASSERT(res == true);
+      }
+      //////////////////////////////////////////////////
 
-        if (old_prev.IsNull() == false) {
-          auto old_prev_tile_group_header = catalog::Manager::GetInstance()
-                                                .GetTileGroup(old_prev.block)
-                                                ->GetHeader();
-          old_prev_tile_group_header->SetNextItemPointer(
-              old_prev.offset, ItemPointer(tile_group_id, tuple_slot));
-        }
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetPrevItemPointer(tuple_slot, old_prev);
+      new_tile_group_header->SetTransactionId(new_version.offset,
+                                              INVALID_TXN_ID);
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+      if (old_prev.IsNull() == false) {
+        auto old_prev_tile_group_header = catalog::Manager::GetInstance()
+                                              .ResolveTileGroup(old_prev.block)
+                                              ->GetHeader();
+        old_prev_tile_group_header->SetNextItemPointer(
+            old_prev.offset, ItemPointer(tile_group_id, tuple_slot));
+      }
+
+      tile_group_header->SetPrevItemPointer(tuple_slot, old_prev);
+
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
+
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
 
-        tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      // add to gc set.
+      current_txn->RecordGarbage(new_version, false);
 
-        // add to gc set.
-        gc_set->operator[](new_version.block)[new_version.offset] = false;
+    } else if (rw_entry.type == RWType::INSERT) {
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
 
-      } else if (tuple_entry.second == RWType::INSERT) {
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
 
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+      if (tile_group_header->IsAppendOnly() == true) {
+        tile_group_header->AbortAppend();
+      }
 
-        // add to gc set.
-        // delete from index
-        gc_set->operator[](tile_group_id)[tuple_slot] = true;
+      // add to gc set.
+      // delete from index
+      current_txn->RecordGarbage(ItemPointer(tile_group_id, tuple_slot), true);
 
-      } else if (tuple_entry.second == RWType::INS_DEL) {
-        tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
-        tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+    } else if (rw_entry.type == RWType::INS_DEL) {
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
 
-        // we should set the version before releasing the lock.
-        COMPILER_MEMORY_FENCE;
+      // we should set the version before releasing the lock.
+      COMPILER_MEMORY_FENCE;
 
-        tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
 
-        // add to gc set.
-        gc_set->operator[](tile_group_id)[tuple_slot] = true;
+      if (tile_group_header->IsAppendOnly() == true) {
+        tile_group_header->AbortAppend();
       }
+
+      // add to gc set.
+      current_txn->RecordGarbage(ItemPointer(tile_group_id, tuple_slot), true);
+    }
+  }
+
+  for (auto &bulk_entry : current_txn->GetBulkInsertSet()) {
+    oid_t tile_group_id = bulk_entry.first;
+    oid_t tuple_count = bulk_entry.second;
+    auto tile_group_header =
+        manager.ResolveTileGroup(tile_group_id)->GetHeader();
+
+    for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+      tile_group_header->SetBeginCommitId(tuple_slot, MAX_CID);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+    }
+
+    // we should set the versions before releasing the locks.
+    COMPILER_MEMORY_FENCE;
+
+    for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+      tile_group_header->SetTransactionId(tuple_slot, INVALID_TXN_ID);
+
+      // add to gc set.
+      // delete from index
+      current_txn->RecordGarbage(ItemPointer(tile_group_id, tuple_slot), true);
     }
   }
 
+  for (auto deleted_tile_group_id : current_txn->GetDeletedTileGroupSet()) {
+    manager.ResolveTileGroup(deleted_tile_group_id)
+        ->GetHeader()
+        ->FinishDelete();
+  }
+
   current_txn->SetResult(ResultType::ABORTED);
   EndTransaction(current_txn);
 
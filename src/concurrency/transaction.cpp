@@ -18,6 +18,7 @@
 #include "common/logger.h"
 #include "common/platform.h"
 #include "common/macros.h"
+#include "storage/tile_group.h"
 
 #include <chrono>
 #include <thread>
@@ -48,126 +49,155 @@ namespace concurrency {
  *    i : insert
  */
 
-RWType Transaction::GetRWType(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
-  auto itr = rw_set_.find(tile_group_id);
-  if (itr == rw_set_.end()) {
-    return RWType::INVALID;
+namespace {
+
+// Holds the lock of the read write set while the transaction is shared
+class SharedRWSetGuard {
+ public:
+  SharedRWSetGuard(const std::atomic<size_t> &shared_count, Spinlock &lock)
+      : lock_(shared_count.load() > 0 ? &lock : nullptr) {
+    if (lock_ != nullptr) {
+      lock_->Lock();
+    }
   }
 
-  auto inner_itr = itr->second.find(tuple_id);
-  if (inner_itr == itr->second.end()) {
+  ~SharedRWSetGuard() {
+    if (lock_ != nullptr) {
+      lock_->Unlock();
+    }
+  }
+
+ private:
+  Spinlock *lock_;
+};
+
+}  // namespace
+
+RWType Transaction::GetRWType(const ItemPointer &location) {
+  SharedRWSetGuard guard(shared_count_, rw_set_lock_);
+  RWType *type = rw_set_.Find(location);
+  if (type == nullptr) {
     return RWType::INVALID;
   }
 
-  return inner_itr->second;
+  return *type;
 }
 
 void Transaction::RecordRead(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
+  SharedRWSetGuard guard(shared_count_, rw_set_lock_);
+  RWType *type = rw_set_.Find(location);
 
-  if (IsInRWSet(location)) {
-    PL_ASSERT(rw_set_.at(tile_group_id).at(tuple_id) != RWType::DELETE &&
-              rw_set_.at(tile_group_id).at(tuple_id) != RWType::INS_DEL);
+  if (type != nullptr) {
+    PL_ASSERT(*type != RWType::DELETE && *type != RWType::INS_DEL);
     return;
   } else {
-    rw_set_[tile_group_id][tuple_id] = RWType::READ;
+    rw_set_.Insert(location, RWType::READ);
   }
 }
 
 void Transaction::RecordReadOwn(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
+  SharedRWSetGuard guard(shared_count_, rw_set_lock_);
+  RWType *type = rw_set_.Find(location);
 
-  if (IsInRWSet(location)) {
-    RWType &type = rw_set_.at(tile_group_id).at(tuple_id);
-    if (type == RWType::READ) {
-      type = RWType::READ_OWN;
+  if (type != nullptr) {
+    if (*type == RWType::READ) {
+      *type = RWType::READ_OWN;
       // record write.
       return;
     }
-    PL_ASSERT(type != RWType::DELETE && type != RWType::INS_DEL);
+    PL_ASSERT(*type != RWType::DELETE && *type != RWType::INS_DEL);
   } else {
-    rw_set_[tile_group_id][tuple_id] = RWType::READ_OWN;
+    rw_set_.Insert(location, RWType::READ_OWN);
   }
 }
 
 void Transaction::RecordUpdate(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
-  
-  if (IsInRWSet(location)) {
-    RWType &type = rw_set_.at(tile_group_id).at(tuple_id);
-    if (type == RWType::READ || type == RWType::READ_OWN) {
-      type = RWType::UPDATE;
+  RWType *type = rw_set_.Find(location);
+
+  if (type != nullptr) {
+    if (*type == RWType::READ || *type == RWType::READ_OWN) {
+      *type = RWType::UPDATE;
       // record write.
       is_written_ = true;
 
       return;
     }
-    if (type == RWType::UPDATE) {
+    if (*type == RWType::UPDATE) {
       return;
     }
-    if (type == RWType::INSERT) {
+    if (*type == RWType::INSERT) {
       return;
     }
-    if (type == RWType::DELETE) {
+    if (*type == RWType::DELETE) {
       PL_ASSERT(false);
       return;
     }
     PL_ASSERT(false);
   } else {
     // consider select_for_udpate case.
-    rw_set_[tile_group_id][tuple_id] = RWType::UPDATE;
+    rw_set_.Insert(location, RWType::UPDATE);
   }
 }
 
+void Transaction::RecordInPlaceUpdate(storage::TileGroup *const tile_group,
+                                      const oid_t &tuple_id,
+                                      const std::vector<oid_t> &column_ids) {
+  // the ownership is released with the read own entry
+  RecordReadOwn(ItemPointer(tile_group->GetTileGroupId(), tuple_id));
+  undo_buffer_.Record(tile_group, tuple_id, column_ids);
+  is_written_ = true;
+}
+
 void Transaction::RecordInsert(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
-  
   if (IsInRWSet(location)) {
     PL_ASSERT(false);
   } else {
-    rw_set_[tile_group_id][tuple_id] = RWType::INSERT;
+    rw_set_.Insert(location, RWType::INSERT);
     ++insert_count_;
 
   }
 }
 
+void Transaction::RecordBulkInsert(const oid_t tile_group_id,
+                                   const oid_t tuple_count) {
+  bulk_insert_set_.emplace_back(tile_group_id, tuple_count);
+  insert_count_ += tuple_count;
+}
+
+void Transaction::RecordTileGroupDelete(const oid_t tile_group_id) {
+  deleted_tile_group_set_.push_back(tile_group_id);
+  is_written_ = true;
+}
+
 bool Transaction::RecordDelete(const ItemPointer &location) {
-  oid_t tile_group_id = location.block;
-  oid_t tuple_id = location.offset;
+  RWType *type = rw_set_.Find(location);
 
-  if (IsInRWSet(location)) {
-    RWType &type = rw_set_.at(tile_group_id).at(tuple_id);
-    if (type == RWType::READ || type == RWType::READ_OWN) {
-      type = RWType::DELETE;
+  if (type != nullptr) {
+    if (*type == RWType::READ || *type == RWType::READ_OWN) {
+      *type = RWType::DELETE;
       // record write.
       is_written_ = true;
 
       return false;
     }
-    if (type == RWType::UPDATE) {
-      type = RWType::DELETE;
+    if (*type == RWType::UPDATE) {
+      *type = RWType::DELETE;
 
       return false;
     }
-    if (type == RWType::INSERT) {
-      type = RWType::INS_DEL;
+    if (*type == RWType::INSERT) {
+      *type = RWType::INS_DEL;
       --insert_count_;
 
       return true;
     }
-    if (type == RWType::DELETE) {
+    if (*type == RWType::DELETE) {
       PL_ASSERT(false);
       return false;
     }
     PL_ASSERT(false);
   } else {
-    rw_set_[tile_group_id][tuple_id] = RWType::DELETE;
+    rw_set_.Insert(location, RWType::DELETE);
   }
   return false;
 }
@@ -178,7 +208,7 @@ const std::string Transaction::GetInfo() const {
   os << "\tTxn :: @" << this << " ID : " << std::setw(4) << txn_id_
      << " Read ID : " << std::setw(4) << read_id_
      << " Commit ID : " << std::setw(4) << commit_id_
-     << " Result : " << result_;
+     << " Result : " << result_.load();
 
   return os.str();
 }
@@ -14,15 +14,53 @@
 
 #include "concurrency/transaction.h"
 #include "catalog/manager.h"
+#include "concurrency/contention_manager.h"
 #include "statistics/stats_aggregator.h"
+#include "logging/group_commit_manager.h"
 #include "logging/log_manager.h"
 #include "gc/gc_manager_factory.h"
 #include "storage/tile_group.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 
 namespace peloton {
 namespace concurrency {
 
+namespace {
+
+// number of ended transactions that a thread keeps for reuse
+const size_t max_pooled_transaction_count = 16;
+
+// transactions ended by this thread. a transaction runs on one thread, so
+// the pool needs no synchronization.
+thread_local std::vector<std::unique_ptr<Transaction>> transaction_pool;
+
+Transaction *NewTransaction(const size_t thread_id,
+                            const IsolationLevelType type,
+                            const cid_t read_id, const cid_t commit_id) {
+  if (transaction_pool.empty() == true) {
+    return new Transaction(thread_id, type, read_id, commit_id);
+  }
+
+  Transaction *txn = transaction_pool.back().release();
+  transaction_pool.pop_back();
+  txn->Init(thread_id, type, read_id, commit_id);
+  return txn;
+}
+
+void FreeTransaction(Transaction *txn) {
+  if (transaction_pool.size() < max_pooled_transaction_count) {
+    transaction_pool.emplace_back(txn);
+  } else {
+    delete txn;
+  }
+}
+
+}  // namespace
+
 ProtocolType TransactionManager::protocol_ = 
     ProtocolType::TIMESTAMP_ORDERING;
 IsolationLevelType TransactionManager::isolation_level_ =
@@ -38,7 +76,7 @@ Transaction *TransactionManager::BeginTransaction(const size_t thread_id, const
 
     // transaction processing with decentralized epoch manager
     cid_t read_id = EpochManagerFactory::GetInstance().EnterEpoch(thread_id, TimestampType::SNAPSHOT_READ);
-    txn = new Transaction(thread_id, type, read_id); 
+    txn = NewTransaction(thread_id, type, read_id, read_id);
   
   } else if (type == IsolationLevelType::SNAPSHOT) {
     
@@ -49,9 +87,9 @@ Transaction *TransactionManager::BeginTransaction(const size_t thread_id, const
     if (protocol_ == ProtocolType::TIMESTAMP_ORDERING) {
       cid_t commit_id = EpochManagerFactory::GetInstance().EnterEpoch(thread_id, TimestampType::COMMIT);
       
-      txn = new Transaction(thread_id, type, read_id, commit_id);
+      txn = NewTransaction(thread_id, type, read_id, commit_id);
     } else {
-      txn = new Transaction(thread_id, type, read_id);
+      txn = NewTransaction(thread_id, type, read_id, read_id);
     }
 
   } else {
@@ -62,7 +100,7 @@ Transaction *TransactionManager::BeginTransaction(const size_t thread_id, const
     // - READ_COMMITTED.
     // transaction processing with decentralized epoch manager
     cid_t read_id = EpochManagerFactory::GetInstance().EnterEpoch(thread_id, TimestampType::READ);
-    txn = new Transaction(thread_id, type, read_id); 
+    txn = NewTransaction(thread_id, type, read_id, read_id);
   
   }
   
@@ -86,7 +124,7 @@ void TransactionManager::EndTransaction(Transaction *current_txn) {
     if (current_txn->GetResult() == ResultType::SUCCESS) {
       if (current_txn->IsGCSetEmpty() != true) {
         gc::GCManagerFactory::GetInstance().
-            RecycleTransaction(current_txn->GetGCSetPtr(), 
+            RecycleTransaction(current_txn->ReleaseGCSet(), 
                                current_txn->GetEpochId(), 
                                current_txn->GetThreadId());
       }
@@ -94,14 +132,18 @@ void TransactionManager::EndTransaction(Transaction *current_txn) {
       if (current_txn->IsGCSetEmpty() != true) {
         // consider what parameter we should use.
         gc::GCManagerFactory::GetInstance().
-            RecycleTransaction(current_txn->GetGCSetPtr(), 
+            RecycleTransaction(current_txn->ReleaseGCSet(), 
                                epoch_manager.GetNextEpochId(),
                                current_txn->GetThreadId());
       }
     }
   }
 
-  delete current_txn;
+  ContentionManager::GetInstance().EndTransaction(current_txn->GetResult());
+
+  // the transaction object and its read write set are reused by the next
+  // transaction of this thread.
+  FreeTransaction(current_txn);
   current_txn = nullptr;
   
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
@@ -111,6 +153,24 @@ void TransactionManager::EndTransaction(Transaction *current_txn) {
   }
 }
 
+ResultType TransactionManager::GroupCommitTransaction(
+    Transaction *const current_txn,
+    const std::function<void(const ResultType)> &callback) {
+  // the transaction is deleted by commit
+  eid_t epoch_id = current_txn->GetEpochId();
+
+  ResultType result = CommitTransaction(current_txn);
+
+  auto &group_commit_manager = logging::GroupCommitManager::GetInstance();
+  if (result == ResultType::SUCCESS && group_commit_manager.IsRunning()) {
+    group_commit_manager.EnqueueCommit(epoch_id, callback);
+  } else {
+    callback(result);
+  }
+
+  return result;
+}
+
 // this function checks whether a concurrent transaction is inserting the same
 // tuple
 // that is to-be-inserted by the current transaction.
@@ -118,8 +178,9 @@ bool TransactionManager::IsOccupied(
     Transaction *const current_txn, const void *position_ptr) {
   ItemPointer &position = *((ItemPointer *)position_ptr);
 
-  auto tile_group_header =
-      catalog::Manager::GetInstance().GetTileGroup(position.block)->GetHeader();
+  auto tile_group_header = catalog::Manager::GetInstance()
+                               .ResolveTileGroup(position.block)
+                               ->GetHeader();
   auto tuple_id = position.offset;
 
   txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
@@ -131,6 +192,14 @@ bool TransactionManager::IsOccupied(
     return false;
   }
 
+  if (tile_group_header->IsDeleting() == true &&
+      tile_group_header->IsDeletedVersion(current_txn->GetTransactionId(),
+                                          current_txn->GetReadId(),
+                                          tuple_begin_cid) == true) {
+    // the tuple was deleted along with its tile group.
+    return false;
+  }
+
   // the tuple has already been owned by the current transaction.
   bool own = (current_txn->GetTransactionId() == tuple_txn_id);
   // the tuple has already been committed.
@@ -183,6 +252,25 @@ bool TransactionManager::IsOccupied(
   }
 }
 
+void TransactionManager::PruneVersionChain(
+    storage::TileGroupHeader *const tile_group_header, const oid_t &tuple_id) {
+  if (tile_group_header->GetNextItemPointer(tuple_id).IsNull() == true) {
+    return;
+  }
+
+  // every active transaction reads above the expired cid, so it sees this
+  // version or a newer one. an uncommitted version has a begin cid of
+  // MAX_CID.
+  cid_t begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+  if (begin_cid >= EpochManagerFactory::GetInstance().GetLastExpiredCid()) {
+    return;
+  }
+
+  // the older versions are not dereferenced here. the GC may already have
+  // recycled them.
+  tile_group_header->SetNextItemPointer(tuple_id, INVALID_ITEMPOINTER);
+}
+
 // this function checks whether a version is visible to current transaction.
 VisibilityType TransactionManager::IsVisible(
     Transaction *const current_txn,
@@ -211,6 +299,14 @@ VisibilityType TransactionManager::IsVisible(
   // the tuple is not visible.
   bool invalidated = (txn_vis_id >= tuple_end_cid);
 
+  if (tile_group_header->IsDeleting() == true &&
+      tile_group_header->IsDeletedVersion(current_txn->GetTransactionId(),
+                                          txn_vis_id, tuple_begin_cid) ==
+          true) {
+    // the tuple was deleted along with its tile group
+    return VisibilityType::DELETED;
+  }
+
   if (tuple_txn_id == INVALID_TXN_ID || CidIsInDirtyRange(tuple_begin_cid)) {
     // the tuple is not available.
     if (activated && !invalidated) {
@@ -267,5 +363,85 @@ VisibilityType TransactionManager::IsVisible(
 }
 
 
+// this function checks the visibility of a range of versions at once. the
+// common case, a committed version that no transaction owns, is decided from
+// the header entry alone. all the others go through IsVisible.
+oid_t TransactionManager::GetVisibleTuples(
+    Transaction *const current_txn,
+    const storage::TileGroupHeader *const tile_group_header,
+    const oid_t tuple_begin, const oid_t tuple_end, oid_t *selection_vector,
+    const VisibilityIdType type) {
+  cid_t txn_vis_id;
+
+  if (type == VisibilityIdType::READ_ID) {
+    txn_vis_id = current_txn->GetReadId();
+  } else {
+    PL_ASSERT(type == VisibilityIdType::COMMIT_ID);
+    txn_vis_id = current_txn->GetCommitId();
+  }
+
+  oid_t visible_count = 0;
+
+  // the versions of a tile group that is being deleted are checked one by
+  // one.
+  bool deleting = tile_group_header->IsDeleting();
+
+  // every version of a frozen tile group is committed and visible to the
+  // transactions that started after it was frozen.
+  if (deleting == false && tile_group_header->IsFrozen() &&
+      tile_group_header->GetFrozenCommitId() <= txn_vis_id) {
+    for (oid_t tuple_id = tuple_begin; tuple_id < tuple_end; tuple_id++) {
+      selection_vector[visible_count++] = tuple_id;
+    }
+    return visible_count;
+  }
+
+  // the leading versions of an append-only tile group are decided by a
+  // single check once all the inserts into them have committed.
+  oid_t tuple_id = tuple_begin;
+  oid_t append_end =
+      deleting ? tuple_begin
+               : std::min(tile_group_header->GetVisibleAppendCount(txn_vis_id),
+                          tuple_end);
+  for (; tuple_id < append_end; tuple_id++) {
+    selection_vector[visible_count++] = tuple_id;
+  }
+
+  for (; tuple_id < tuple_end; tuple_id++) {
+    if (tuple_id + visibility_prefetch_distance < tuple_end) {
+      __builtin_prefetch(tile_group_header->GetHeaderEntry(
+          tuple_id + visibility_prefetch_distance));
+    }
+
+    txn_id_t tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
+    bool visible;
+
+    if (tuple_txn_id == INITIAL_TXN_ID) {
+      // the tuple is not owned by any transaction.
+      cid_t tuple_begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+      cid_t tuple_end_cid = tile_group_header->GetEndCommitId(tuple_id);
+      visible = (txn_vis_id >= tuple_begin_cid) &
+                (txn_vis_id < tuple_end_cid) &
+                !CidIsInDirtyRange(tuple_begin_cid);
+      if (deleting == true && visible == true) {
+        visible = !tile_group_header->IsDeletedVersion(
+            current_txn->GetTransactionId(), txn_vis_id, tuple_begin_cid);
+      }
+    } else if (tuple_txn_id == INVALID_TXN_ID) {
+      // the tuple is not available.
+      visible = false;
+    } else {
+      visible = (IsVisible(current_txn, tile_group_header, tuple_id, type) ==
+                 VisibilityType::OK);
+    }
+
+    selection_vector[visible_count] = tuple_id;
+    visible_count += visible;
+  }
+
+  return visible_count;
+}
+
+
 }
 }
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// undo_buffer.cpp
+//
+// Identification: src/concurrency/undo_buffer.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/undo_buffer.h"
+
+#include "catalog/manager.h"
+#include "common/macros.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace concurrency {
+
+void UndoBuffer::Record(storage::TileGroup *const tile_group,
+                        const oid_t &tuple_id,
+                        const std::vector<oid_t> &column_ids) {
+  records_.emplace_back(ItemPointer(tile_group->GetTileGroupId(), tuple_id),
+                        values_.size());
+
+  for (auto column_id : column_ids) {
+    values_.emplace_back(column_id, tile_group->GetValue(tuple_id, column_id));
+  }
+}
+
+void UndoBuffer::Undo() {
+  auto &manager = catalog::Manager::GetInstance();
+
+  // a version updated twice is restored to the values of the first record
+  size_t value_end = values_.size();
+  for (auto record = records_.rbegin(); record != records_.rend(); ++record) {
+    auto tile_group = manager.GetTileGroup(record->location.block);
+    PL_ASSERT(tile_group != nullptr);
+
+    for (size_t value_id = record->value_offset; value_id < value_end;
+         value_id++) {
+      tile_group->SetValue(values_[value_id].second, record->location.offset,
+                           values_[value_id].first);
+    }
+    value_end = record->value_offset;
+  }
+}
+
+void UndoBuffer::Clear() {
+  if (values_.capacity() > max_retained_value_count) {
+    std::vector<UndoRecord>().swap(records_);
+    std::vector<std::pair<oid_t, type::Value>>().swap(values_);
+    return;
+  }
+
+  records_.clear();
+  values_.clear();
+}
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -33,10 +33,62 @@ void PrintConfiguration(){
   LOG_INFO("%30s: %10llu", "Port", (unsigned long long) FLAGS_port);
   LOG_INFO("%30s: %10s",  "Socket Family", FLAGS_socket_family.c_str());
   LOG_INFO("%30s: %10s", "Statistics", FLAGS_stats_mode ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10llu", "Stats Flush Intervals", (unsigned long long) FLAGS_stats_flush_intervals);
+  LOG_INFO("%30s: %10llu", "Query Metrics Per Flush", (unsigned long long) FLAGS_stats_query_metrics_per_flush);
+  LOG_INFO("%30s: %10llu", "Query Metrics Retention (s)", (unsigned long long) FLAGS_stats_query_metrics_retention);
+  LOG_INFO("%30s: %10llu", "Query Sample Interval", (unsigned long long) FLAGS_stats_query_sample_interval);
+  LOG_INFO("%30s: %10llu", "Slow Query Threshold (ms)", (unsigned long long) FLAGS_stats_slow_query_ms);
+  LOG_INFO("%30s: %10s", "Hardware Counters", FLAGS_stats_hardware_counters ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10llu", "Metrics Port", (unsigned long long) FLAGS_metrics_port);
   LOG_INFO("%30s: %10llu", "Max Connections", (unsigned long long) FLAGS_max_connections);
+  LOG_INFO("%30s: %10llu", "Result Chunk Rows", (unsigned long long) FLAGS_result_chunk_rows);
+  LOG_INFO("%30s: %10llu", "Execution Threads", (unsigned long long) FLAGS_execution_threads);
+  LOG_INFO("%30s: %10llu", "Execution Contexts", (unsigned long long) FLAGS_execution_contexts);
   LOG_INFO("%30s: %10s", "Index Tuner", FLAGS_index_tuner ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10llu", "Index Tuner Sample Interval", (unsigned long long) FLAGS_index_tuner_sample_interval);
+  LOG_INFO("%30s: %10llu", "Index Tuner Memory (MB)", (unsigned long long) FLAGS_index_tuner_memory_mb);
   LOG_INFO("%30s: %10s", "Layout Tuner", FLAGS_layout_tuner ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10s", "Knob Tuner", FLAGS_knob_tuner ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10llu", "Knob Tuner GC Lag (ms)", (unsigned long long) FLAGS_knob_tuner_gc_lag_ms);
+  LOG_INFO("%30s: %10llu", "Workload Forecast Interval (s)", (unsigned long long) FLAGS_workload_forecast_interval_s);
+  LOG_INFO("%30s: %10llu", "Workload Forecast Season", (unsigned long long) FLAGS_workload_forecast_season);
   LOG_INFO("%30s: %10s",  "Code-generation", FLAGS_codegen ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10llu", "Compiled Query Cache", (unsigned long long) FLAGS_codegen_query_cache_size);
+  LOG_INFO("%30s: %10s", "Background Compilation", FLAGS_codegen_background_compile ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10llu", "Parallel Scan Threads", (unsigned long long) FLAGS_codegen_parallel_scan_threads);
+  LOG_INFO("%30s: %10llu", "Compiled Query Min Rows", (unsigned long long) FLAGS_codegen_min_rows);
+  LOG_INFO("%30s: %10llu", "Slow Compiled Query (ms)", (unsigned long long) FLAGS_codegen_slow_query_ms);
+  LOG_INFO("%30s: %10s", "Compiled Query Directory", FLAGS_codegen_object_cache_dir.c_str());
+  LOG_INFO("%30s: %10s", "Tile Group Freezer", FLAGS_tile_group_freezer ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10s", "Tile Group Compactor", FLAGS_tile_group_compactor ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10s", "Tuple Expirer", FLAGS_tuple_expirer ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10s", "Tile Group Provisioner", FLAGS_tile_group_provisioner ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10s", "Tile Group Evictor", FLAGS_tile_group_evictor ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10s", "Tile Group Evictor Directory", FLAGS_tile_group_evictor_dir.c_str());
+  LOG_INFO("%30s: %10llu", "Tile Group Memory (MB)", (unsigned long long) FLAGS_tile_group_evictor_memory_mb);
+  LOG_INFO("%30s: %10s", "Huge Page Tiles", FLAGS_huge_page_tiles ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10llu", "Exchange Threads", (unsigned long long) FLAGS_exchange_threads);
+  LOG_INFO("%30s: %10llu", "Query Memory Budget (MB)", (unsigned long long) FLAGS_query_memory_budget_mb);
+  LOG_INFO("%30s: %10llu", "Copy Threads", (unsigned long long) FLAGS_copy_threads);
+  LOG_INFO("%30s: %10llu", "Merge Join Threads", (unsigned long long) FLAGS_merge_join_threads);
+  LOG_INFO("%30s: %10llu", "Plan Cache", (unsigned long long) FLAGS_plan_cache_size);
+  LOG_INFO("%30s: %10llu", "Result Cache", (unsigned long long) FLAGS_result_cache_size);
+  LOG_INFO("%30s: %10llu", "Analyze Sample Size", (unsigned long long) FLAGS_analyze_sample_size);
+  LOG_INFO("%30s: %10llu", "Auto Analyze Threshold", (unsigned long long) FLAGS_auto_analyze_threshold);
+  LOG_INFO("%30s: %10llu", "Cardinality Feedback Error", (unsigned long long) FLAGS_cardinality_feedback_error);
+  LOG_INFO("%30s: %10llu", "Optimizer Timeout", (unsigned long long) FLAGS_optimizer_timeout);
+  LOG_INFO("%30s: %10llu", "Optimizer Task Budget", (unsigned long long) FLAGS_optimizer_task_budget);
+  LOG_INFO("%30s: %10llu", "Maintenance Latency SLO (ms)", (unsigned long long) FLAGS_maintenance_latency_slo_ms);
+  LOG_INFO("%30s: %10llu", "Maintenance CPU (%)", (unsigned long long) FLAGS_maintenance_cpu_percent);
+  LOG_INFO("%30s: %10llu", "Maintenance I/O (MB/s)", (unsigned long long) FLAGS_maintenance_io_mb);
+  LOG_INFO("%30s: %10s", "Group Commit", FLAGS_group_commit ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10s", "Command Logging", FLAGS_command_logging ? "enabled" : "disabled");
+  LOG_INFO("%30s: %10s", "Replicas", FLAGS_replica_addresses.empty() ? "none" : FLAGS_replica_addresses.c_str());
+  LOG_INFO("%30s: %10llu", "Replication Port", (unsigned long long) FLAGS_replication_port);
+  LOG_INFO("%30s: %10s", "Shard Nodes", FLAGS_shard_nodes.empty() ? "none" : FLAGS_shard_nodes.c_str());
+  LOG_INFO("%30s: %10llu", "Shard Node Id", (unsigned long long) FLAGS_shard_node_id);
+  LOG_INFO("%30s: %10s", "Sharded Tables", FLAGS_shard_tables.empty() ? "none" : FLAGS_shard_tables.c_str());
+  LOG_INFO("%30s: %10llu", "Shard Timeout (ms)", (unsigned long long) FLAGS_shard_timeout_ms);
 
   LOG_INFO(" ");
   LOG_INFO("%30s", "//===---------------------------------------------------===//");
@@ -62,6 +114,24 @@ DEFINE_uint64(max_connections,
               64,
               "Maximum number of connections (default: 64)");
 
+DEFINE_uint64(result_chunk_rows,
+              1000,
+              "Number of result rows sent to the client at a time while a "
+              "statement executes, 0 sends them all at the end (default: "
+              "1000)");
+
+DEFINE_uint64(execution_threads,
+              0,
+              "Number of threads that execute the statements of the "
+              "connections, 0 executes them on the connection threads "
+              "(default: 0)");
+
+DEFINE_uint64(execution_contexts,
+              0,
+              "Number of traffic cops the connections share, each bound to "
+              "a connection for the duration of a transaction, 0 gives "
+              "every connection its own (default: 0)");
+
 DEFINE_string(socket_family,
               "AF_INET",
               "Socket family (default: AF_INET)");
@@ -81,10 +151,169 @@ DEFINE_string(certificate_file,
 // RESOURCE USAGE
 //===----------------------------------------------------------------------===//
 
+DEFINE_bool(tile_group_freezer,
+            false,
+            "Freeze cold tile groups into a compressed form (default: false)");
+
+DEFINE_bool(tile_group_compactor,
+            false,
+            "Move live tuples out of sparse tile groups (default: false)");
+
+DEFINE_bool(tuple_expirer,
+            false,
+            "Delete the tuples whose time to live is over (default: false)");
+
+DEFINE_bool(tile_group_provisioner,
+            false,
+            "Create tile groups ahead of the inserts that fill the active "
+            "ones (default: false)");
+
+DEFINE_bool(tile_group_evictor,
+            false,
+            "Evict cold, frozen tile groups to files, needs the tile group "
+            "freezer (default: false)");
+
+DEFINE_string(tile_group_evictor_dir,
+              "/tmp",
+              "Directory the evicted tile groups are written to "
+              "(default: /tmp)");
+
+DEFINE_uint64(tile_group_evictor_memory_mb,
+              0,
+              "Memory the tuple slots of the tables may use before cold tile "
+              "groups are evicted, 0 to evict all of them (default: 0)");
+
+DEFINE_bool(huge_page_tiles,
+            false,
+            "Allocate tile data from huge page backed memory (default: false)");
+
+DEFINE_uint64(exchange_threads,
+              0,
+              "Number of worker threads the exchanges of the executors run "
+              "their scans on, 0 for one per core (default: 0)");
+
+DEFINE_uint64(query_memory_budget_mb,
+              1024,
+              "Memory the hash joins and hash aggregations of a query may use "
+              "before they spill to disk, 0 for no limit (default: 1024)");
+
+DEFINE_uint64(copy_threads,
+              0,
+              "Number of threads a COPY FROM parses its input on, 0 for one "
+              "per core (default: 0)");
+
+DEFINE_uint64(merge_join_threads,
+              0,
+              "Number of threads a merge join merges its input on, 0 for one "
+              "per core (default: 0)");
+
+DEFINE_uint64(plan_cache_size,
+              0,
+              "Number of parameterized queries whose plans are kept for "
+              "reuse, 0 to disable (default: 0)");
+
+DEFINE_uint64(result_cache_size,
+              0,
+              "Number of result rows of SELECTs that are kept until the "
+              "tables they read change, 0 to disable (default: 0)");
+
+DEFINE_uint64(analyze_sample_size,
+              30000,
+              "Number of tuples ANALYZE samples from a larger table, 0 to "
+              "scan every table fully (default: 30000)");
+
+DEFINE_uint64(auto_analyze_threshold,
+              0,
+              "Number of modified tuples after which a table is analyzed "
+              "again, 0 to disable (default: 0)");
+
+DEFINE_double(auto_analyze_scale_factor,
+              0.1,
+              "Fraction of the tuples of a table that are modified on top of "
+              "the threshold before it is analyzed again (default: 0.1)");
+
+DEFINE_uint64(cardinality_feedback_error,
+              10,
+              "Factor by which the rows a scan observed may differ from the "
+              "estimate before cached plans are dropped, 0 to disable "
+              "cardinality feedback (default: 10)");
+
+DEFINE_uint64(optimizer_timeout,
+              0,
+              "Milliseconds after which the optimizer stops costing further "
+              "alternatives and keeps the best plan found, 0 to disable "
+              "(default: 0)");
+
+DEFINE_uint64(optimizer_task_budget,
+              0,
+              "Number of expressions the optimizer costs before it keeps the "
+              "best plan found, 0 to disable (default: 0)");
+
+DEFINE_uint64(maintenance_latency_slo_ms,
+              0,
+              "p99 latency of queries above which background maintenance is "
+              "held back, 0 for none (default: 0)");
+
+DEFINE_uint64(maintenance_cpu_percent,
+              50,
+              "Percent of one core the background maintenance tasks may use "
+              "together, 0 for no limit (default: 50)");
+
+DEFINE_uint64(maintenance_io_mb,
+              0,
+              "Megabytes per second the background maintenance tasks may "
+              "write together, 0 for no limit (default: 0)");
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
 
+DEFINE_bool(group_commit,
+            false,
+            "Acknowledge commits once per epoch (default: false)");
+
+DEFINE_bool(command_logging,
+            false,
+            "Log the statements of transactions instead of their writes "
+            "(default: false)");
+
+//===----------------------------------------------------------------------===//
+// REPLICATION
+//===----------------------------------------------------------------------===//
+
+DEFINE_string(replica_addresses,
+              "",
+              "Replicas the log is shipped to, as host:port,... "
+              "(default: none)");
+
+DEFINE_uint64(replication_port,
+              0,
+              "Port of the replication server, needed by a primary with "
+              "replicas and by a replica (default: 0, none)");
+
+//===----------------------------------------------------------------------===//
+// SHARDING
+//===----------------------------------------------------------------------===//
+
+DEFINE_string(shard_nodes,
+              "",
+              "RPC servers of the nodes the sharded tables are spread over, "
+              "as host:port,... in node order (default: none)");
+
+DEFINE_uint64(shard_node_id,
+              0,
+              "Id of this node, its position in shard_nodes (default: 0)");
+
+DEFINE_string(shard_tables,
+              "",
+              "Sharded tables, as table:hash:column or "
+              "table:range:column:bound:...,... (default: none)");
+
+DEFINE_uint64(shard_timeout_ms,
+              5000,
+              "Time a node waits for the answer of another node "
+              "(default: 5000)");
+
 //===----------------------------------------------------------------------===//
 // ERROR REPORTING AND LOGGING
 //===----------------------------------------------------------------------===//
@@ -105,6 +334,41 @@ DEFINE_uint64(stats_mode,
               peloton::STATS_TYPE_INVALID,
               "Enable statistics collection (default: 0)");
 
+DEFINE_uint64(stats_flush_intervals,
+              10,
+              "Aggregation intervals between writes to the metrics tables "
+              "(default: 10)");
+
+DEFINE_uint64(stats_query_metrics_per_flush,
+              1000,
+              "Completed queries sampled per write to the query metrics "
+              "table, 0 to keep all (default: 1000)");
+
+DEFINE_uint64(stats_query_metrics_retention,
+              3600,
+              "Seconds the query metrics are kept, 0 to keep them forever "
+              "(default: 3600)");
+
+DEFINE_uint64(stats_query_sample_interval,
+              1,
+              "Measure one in this many queries of every thread in full, 0 "
+              "to only measure the slow ones (default: 1)");
+
+DEFINE_uint64(stats_slow_query_ms,
+              0,
+              "Also measure every query that took at least this long (ms) "
+              "and log its phases, 0 to not (default: 0)");
+
+DEFINE_bool(stats_hardware_counters,
+            false,
+            "Count cycles, instructions and cache, branch and TLB misses of "
+            "every query with perf events (default: false)");
+
+DEFINE_uint64(metrics_port,
+              0,
+              "Port serving the statistics in the Prometheus text format at "
+              "/metrics, 0 to not serve them (default: 0)");
+
 //===----------------------------------------------------------------------===//
 // AI
 //===----------------------------------------------------------------------===//
@@ -113,10 +377,40 @@ DEFINE_bool(index_tuner,
             false,
             "Enable index tuner (default: false)");
 
+DEFINE_uint64(index_tuner_sample_interval,
+              10,
+              "Record the predicates of one in this many executed queries "
+              "for the index tuner (default: 10)");
+
+DEFINE_uint64(index_tuner_memory_mb,
+              1024,
+              "Memory the indexes created by the index tuner may take "
+              "(default: 1024)");
+
 DEFINE_bool(layout_tuner,
             false,
             "Enable layout tuner (default: false)");
 
+DEFINE_bool(knob_tuner,
+            false,
+            "Enable tuning of the active tile groups, the tile group size "
+            "and the epoch length (default: false)");
+
+DEFINE_uint64(knob_tuner_gc_lag_ms,
+              100,
+              "Time versions may wait for their epoch to expire before the "
+              "knob tuner shortens the epochs (default: 100)");
+
+DEFINE_uint64(workload_forecast_interval_s,
+              60,
+              "Length of the intervals the arrivals of each query shape are "
+              "counted in for the workload forecast (default: 60)");
+
+DEFINE_uint64(workload_forecast_season,
+              1440,
+              "Number of forecast intervals after which the workload "
+              "repeats (default: 1440, a day of minutes)");
+
 //===----------------------------------------------------------------------===//
 //
 //===----------------------------------------------------------------------===//
@@ -125,6 +419,41 @@ DEFINE_bool(codegen,
             true,
             "Enable code-generation for query execution (default: true)");
 
+DEFINE_uint64(codegen_query_cache_size,
+              100,
+              "Number of compiled queries kept for reuse (default: 100)");
+
+DEFINE_bool(codegen_background_compile,
+            true,
+            "Compile new queries in the background and run them on the "
+            "executors meanwhile (default: true)");
+
+DEFINE_uint64(codegen_parallel_scan_threads,
+              0,
+              "Number of threads a parallel scan in compiled queries runs on, "
+              "0 for one per core (default: 0)");
+
+DEFINE_uint64(codegen_slow_query_ms,
+              1000,
+              "Log compiled queries that take at least this many ms to "
+              "compile and run, 0 to disable (default: 1000)");
+
+DEFINE_uint64(codegen_min_rows,
+              0,
+              "Number of tuples a plan has to be estimated to read before it "
+              "is compiled, unless it is compiled already, 0 to compile "
+              "every plan (default: 0)");
+
+DEFINE_uint64(codegen_dump_ir_plan,
+              0,
+              "Write the IR of the plan with this hash when it is compiled, "
+              "0 for none (default: 0)");
+
+DEFINE_string(codegen_object_cache_dir,
+              "",
+              "Directory the machine code of compiled queries is kept in for "
+              "later processes, empty to disable (default: empty)");
+
 // Layout mode
 int peloton_layout_mode = peloton::LAYOUT_TYPE_ROW;
 
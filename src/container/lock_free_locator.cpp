@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// lock_free_locator.cpp
+//
+// Identification: src/container/lock_free_locator.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/lock_free_locator.h"
+
+#include <limits>
+
+namespace peloton {
+namespace lock_free_locator {
+
+namespace {
+
+std::atomic<uint64_t> current_epoch(1);
+
+// Pushed to the front, never removed
+std::atomic<ReaderSlot *> reader_slots(nullptr);
+
+ReaderSlot *AcquireReaderSlot() {
+  for (ReaderSlot *slot = reader_slots.load(); slot != nullptr;
+       slot = slot->next) {
+    bool in_use = false;
+    if (slot->in_use.load() == false &&
+        slot->in_use.compare_exchange_strong(in_use, true)) {
+      return slot;
+    }
+  }
+
+  ReaderSlot *slot = new ReaderSlot();
+  slot->in_use.store(true);
+  slot->next = reader_slots.load();
+  while (reader_slots.compare_exchange_weak(slot->next, slot) == false) {
+  }
+  return slot;
+}
+
+// Gives the slot back when the thread exits
+struct ReaderSlotHandle {
+  ReaderSlotHandle() : slot(AcquireReaderSlot()) {}
+
+  ~ReaderSlotHandle() {
+    slot->epoch.store(0);
+    slot->in_use.store(false, std::memory_order_release);
+  }
+
+  ReaderSlot *slot;
+};
+
+}  // namespace
+
+ReaderSlot &GetReaderSlot() {
+  static thread_local ReaderSlotHandle handle;
+  return *handle.slot;
+}
+
+uint64_t GetCurrentEpoch() { return current_epoch.load(); }
+
+uint64_t AdvanceEpoch() { return current_epoch.fetch_add(1); }
+
+uint64_t GetOldestReaderEpoch() {
+  uint64_t oldest_epoch = std::numeric_limits<uint64_t>::max();
+  for (ReaderSlot *slot = reader_slots.load(); slot != nullptr;
+       slot = slot->next) {
+    uint64_t epoch = slot->epoch.load();
+    if (epoch != 0 && epoch < oldest_epoch) {
+      oldest_epoch = epoch;
+    }
+  }
+  return oldest_epoch;
+}
+
+}  // namespace lock_free_locator
+}  // namespace peloton
@@ -90,11 +90,47 @@ bool AbstractExecutor::Execute() {
   // TODO In the future, we might want to pass some kind of executor state to
   // GetNextTile. e.g. params for prepared plans.
 
+  if (executor_context_ != nullptr && executor_context_->IsProfiling()) {
+    return ProfiledExecute();
+  }
+
+  bool status = DExecute();
+
+  return status;
+}
+
+bool AbstractExecutor::ProfiledExecute() {
+  size_t memory_before = executor_context_->GetUsedMemory();
+  profile_timer_.Start();
   bool status = DExecute();
+  profile_timer_.Stop();
 
+  size_t memory_after = executor_context_->GetUsedMemory();
+  if (memory_after > memory_before) {
+    profile_memory_bytes_ += memory_after - memory_before;
+  }
+  if (status == true && output != nullptr) {
+    profile_tuple_count_ += output->GetTupleCount();
+  }
   return status;
 }
 
+ExecutorProfile AbstractExecutor::GetProfile() const {
+  ExecutorProfile profile;
+  if (node_ != nullptr) {
+    profile.name = ExecutorProfile::GetPlanName(*node_);
+  }
+  profile.is_profiled = profile_timer_.GetInvocations() > 0;
+  profile.execute_count = profile_timer_.GetInvocations();
+  profile.tuple_count = profile_tuple_count_;
+  profile.execute_ms = profile_timer_.GetDuration();
+  profile.memory_bytes = profile_memory_bytes_;
+  for (auto child : children_) {
+    profile.children.push_back(child->GetProfile());
+  }
+  return profile;
+}
+
 void AbstractExecutor::SetContext(type::Value &value) {
   executor_context_->SetParams(value);
 }
@@ -126,13 +126,8 @@ bool AggregateExecutor::DExecute() {
 
     LOG_TRACE("Looping over tile..");
 
-    for (oid_t tuple_id : *tile) {
-      std::unique_ptr<expression::ContainerTuple<LogicalTile>> cur_tuple(
-          new expression::ContainerTuple<LogicalTile>(tile.get(), tuple_id));
-
-      if (aggregator->Advance(cur_tuple.get()) == false) {
-        return false;
-      }
+    if (aggregator->AdvanceTile(tile.get()) == false) {
+      return false;
     }
     LOG_TRACE("Finished processing logical tile");
   }
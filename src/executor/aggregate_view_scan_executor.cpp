@@ -0,0 +1,164 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregate_view_scan_executor.cpp
+//
+// Identification: src/executor/aggregate_view_scan_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/aggregate_view_scan_executor.h"
+
+#include "common/logger.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile_factory.h"
+#include "planner/aggregate_view_scan_plan.h"
+#include "storage/aggregate_view.h"
+#include "storage/table_factory.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+AggregateViewScanExecutor::AggregateViewScanExecutor(
+    const planner::AbstractPlan *node, ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+AggregateViewScanExecutor::~AggregateViewScanExecutor() {
+  // clean up temporary output table
+  delete output_table;
+}
+
+bool AggregateViewScanExecutor::DInit() {
+  PL_ASSERT(children_.size() == 1);
+
+  const planner::AggregateViewScanPlan &node =
+      GetPlanNode<planner::AggregateViewScanPlan>();
+
+  result_itr = START_OID;
+  result.clear();
+  done = false;
+  is_view_used = false;
+
+  delete output_table;
+  output_table = storage::TableFactory::GetTempTable(
+      const_cast<catalog::Schema *>(node.GetOutputSchema()), false);
+
+  return true;
+}
+
+// The value of an output column for one group
+static type::Value GetOutputValue(
+    const planner::AggregateViewScanPlan::OutputColumn &column,
+    const std::vector<type::Value> &key,
+    const storage::AggregateView::GroupState &group) {
+  int64_t value_count = 0;
+  if (column.type != ExpressionType::VALUE_TUPLE &&
+      column.offset < group.value_counts.size()) {
+    value_count = group.value_counts[column.offset];
+  }
+
+  switch (column.type) {
+    case ExpressionType::VALUE_TUPLE:
+      return key[column.offset];
+    case ExpressionType::AGGREGATE_COUNT_STAR:
+      return type::ValueFactory::GetBigIntValue(group.row_count);
+    case ExpressionType::AGGREGATE_COUNT:
+      return type::ValueFactory::GetBigIntValue(value_count);
+    case ExpressionType::AGGREGATE_SUM:
+      if (value_count == 0) {
+        return type::ValueFactory::GetNullValueByType(type::TypeId::BIGINT);
+      }
+      return group.sums[column.offset];
+    case ExpressionType::AGGREGATE_AVG:
+      if (value_count == 0) {
+        return type::ValueFactory::GetNullValueByType(type::TypeId::DECIMAL);
+      }
+      return group.sums[column.offset]
+          .CastAs(type::TypeId::DECIMAL)
+          .Divide(type::ValueFactory::GetDecimalValue(
+              static_cast<double>(value_count)));
+    default:
+      throw Exception("Aggregate type not supported by aggregate views");
+  }
+}
+
+bool AggregateViewScanExecutor::ScanView() {
+  const planner::AggregateViewScanPlan &node =
+      GetPlanNode<planner::AggregateViewScanPlan>();
+  auto &view = node.GetView();
+
+  storage::AggregateView::GroupMap groups;
+  if (view == nullptr ||
+      view->GetGroups(executor_context_->GetTransaction(), groups) == false) {
+    return false;
+  }
+
+  // Without group-by there is one row even if the table is empty
+  if (groups.empty() && view->GetGroupColumnIds().empty()) {
+    groups.emplace(std::vector<type::Value>(),
+                   storage::AggregateView::GroupState());
+  }
+
+  auto output_schema = output_table->GetSchema();
+  auto &output_columns = node.GetOutputColumns();
+  for (auto &group : groups) {
+    storage::Tuple tuple(output_schema, true);
+    for (oid_t column_itr = 0; column_itr < output_columns.size();
+         column_itr++) {
+      auto type_id = output_schema->GetType(column_itr);
+      auto value =
+          GetOutputValue(output_columns[column_itr], group.first, group.second);
+      if (value.IsNull() == true) {
+        value = type::ValueFactory::GetNullValueByType(type_id);
+      } else if (value.GetTypeId() != type_id) {
+        value = value.CastAs(type_id);
+      }
+      tuple.SetValue(column_itr, value, executor_context_->GetPool());
+    }
+    UNUSED_ATTRIBUTE auto location = output_table->InsertTuple(&tuple);
+    PL_ASSERT(location.block != INVALID_OID);
+  }
+
+  auto tile_group_count = output_table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = output_table->GetTileGroup(tile_group_itr);
+    PL_ASSERT(tile_group != nullptr);
+    result.push_back(LogicalTileFactory::WrapTileGroup(tile_group));
+  }
+
+  LOG_TRACE("Answered from aggregate view %s with %lu groups",
+            view->GetName().c_str(), groups.size());
+  return true;
+}
+
+bool AggregateViewScanExecutor::DExecute() {
+  if (done == false) {
+    done = true;
+    is_view_used = ScanView();
+  }
+
+  // The plan of the query itself answers
+  if (is_view_used == false) {
+    if (children_[0]->Execute() == false) {
+      return false;
+    }
+    SetOutput(children_[0]->GetOutput());
+    return true;
+  }
+
+  if (result_itr == result.size()) {
+    return false;
+  }
+  SetOutput(result[result_itr]);
+  result_itr++;
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -11,13 +11,17 @@
 //===----------------------------------------------------------------------===//
 #include "executor/aggregator.h"
 
+#include <new>
 #include <set>
 
 #include "catalog/manager.h"
 #include "common/logger.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "expression/tuple_value_expression.h"
 #include "storage/abstract_table.h"
+#include "storage/tile.h"
 
 namespace peloton {
 namespace executor {
@@ -49,6 +53,9 @@ AbstractAttributeAggregator *GetAttributeAggregatorInstance(ExpressionType agg_t
     case ExpressionType::AGGREGATE_MAX:
       aggregator = new MaxAggregator();
       break;
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+      aggregator = new ApproxCountDistinctAggregator();
+      break;
     default: {
       std::string message =
           "Unknown aggregate type " + ExpressionTypeToString(agg_type);
@@ -81,6 +88,16 @@ type::Value AbstractAttributeAggregator::Finalize() {
   return DFinalize();
 }
 
+bool AbstractAggregator::AdvanceTile(LogicalTile *tile) {
+  for (oid_t tuple_id : *tile) {
+    expression::ContainerTuple<LogicalTile> cur_tuple(tile, tuple_id);
+    if (Advance(&cur_tuple) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*
  * Helper method responsible for inserting the results of the aggregation
  * into a new tuple in the output tile group as well as passing through any
@@ -153,22 +170,104 @@ bool Helper(const planner::AggregatePlan *node, AbstractAttributeAggregator **ag
 HashAggregator::HashAggregator(const planner::AggregatePlan *node,
                                storage::AbstractTable *output_table,
                                executor::ExecutorContext *econtext,
-                               size_t num_input_columns)
+                               size_t num_input_columns, size_t partition_level)
     : AbstractAggregator(node, output_table, econtext),
-      num_input_columns(num_input_columns) {}
+      num_input_columns(num_input_columns),
+      partition_level_(partition_level),
+      group_pool_(new type::ArenaPool()),
+      aggregates_map(0, ValueVectorHasher(), ValueVectorCmp(),
+                     HashAggregateMapType::allocator_type(group_pool_.get())) {
+}
 //  group_by_key_values.resize(node->GetGroupbyColIds().size(),
 //      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER));
 //}
 
-HashAggregator::~HashAggregator() {
+HashAggregator::~HashAggregator() { ClearGroups(); }
+
+void HashAggregator::ClearGroups() {
   for (auto entry : aggregates_map) {
     // Clean up allocated storage
     for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
       delete entry.second->aggregates[aggno];
     }
-    delete[] entry.second->aggregates;
-    delete entry.second;
+    entry.second->~AggregateList();
+  }
+
+  // Drop the table and its arena at once, rather than node by node
+  std::unique_ptr<type::ArenaPool> old_pool(std::move(group_pool_));
+  group_pool_.reset(new type::ArenaPool());
+  aggregates_map = HashAggregateMapType(
+      0, ValueVectorHasher(), ValueVectorCmp(),
+      HashAggregateMapType::allocator_type(group_pool_.get()));
+
+  if (reserved_memory_ > 0) {
+    executor_context->ReleaseMemory(reserved_memory_);
+    reserved_memory_ = 0;
+  }
+}
+
+bool HashAggregator::ReserveGroup(const AbstractTuple *cur_tuple) {
+  // Once a group is spilled, all new groups are, so that no group has tuples
+  // both in memory and on disk
+  if (!partitions_.empty()) {
+    return false;
+  }
+
+  // The copies of the first tuple and of the keys, the aggregates and the
+  // entry of the hash table
+  size_t num_aggs = node->GetUniqueAggTerms().size();
+  size_t group_size =
+      sizeof(AggregateList) + 4 * sizeof(void *) +
+      num_aggs * (sizeof(AbstractAttributeAggregator *) +
+                  sizeof(AbstractAttributeAggregator)) +
+      (num_input_columns + group_by_key_values.size()) * sizeof(type::Value);
+  for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+    type::Value value = cur_tuple->GetValue(col_id);
+    if (!value.IsInlined() && !value.IsNull()) {
+      group_size += value.GetLength();
+    }
+  }
+
+  if (executor_context == nullptr ||
+      executor_context->ReserveMemory(group_size)) {
+    if (executor_context != nullptr) {
+      reserved_memory_ += group_size;
+    }
+    return true;
+  }
+
+  // A partition that is still too large at the deepest level is aggregated in
+  // memory anyway
+  if (partition_level_ >= SpillFile::kMaxPartitionLevel) {
+    if (!over_budget_) {
+      LOG_WARN("Hash aggregation exceeds the memory budget of the query "
+               "at partition level %lu", (unsigned long)partition_level_);
+      over_budget_ = true;
+    }
+    return true;
+  }
+
+  LOG_DEBUG("Hash aggregation spills to disk after %lu groups at partition "
+            "level %lu", (unsigned long)aggregates_map.size(),
+            (unsigned long)partition_level_);
+  std::vector<type::TypeId> column_types;
+  for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+    column_types.push_back(cur_tuple->GetValue(col_id).GetTypeId());
   }
+  for (size_t i = 0; i < SpillFile::kNumPartitions; i++) {
+    partitions_.emplace_back(new SpillFile(column_types));
+  }
+  return false;
+}
+
+void HashAggregator::SpillTuple(const AbstractTuple *cur_tuple) {
+  std::vector<type::Value> values;
+  for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
+    values.push_back(cur_tuple->GetValue(col_id));
+  }
+  size_t partition =
+      SpillFile::GetPartition(group_by_key_values, partition_level_);
+  partitions_[partition]->Append(values);
 }
 
 bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
@@ -185,12 +284,22 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
 
   auto map_itr = aggregates_map.find(group_by_key_values);
 
-  // Group not found. Make a new entry in the hash for this new group.
+  // Group not found. Make a new entry in the hash for this new group, or
+  // spill the tuple if the group does not fit into memory.
   if (map_itr == aggregates_map.end()) {
+    if (!ReserveGroup(cur_tuple)) {
+      SpillTuple(cur_tuple);
+      return true;
+    }
+
     LOG_TRACE("Group-by key not found. Start a new group.");
     // Allocate new aggregate list
-    aggregate_list = new AggregateList();
-    aggregate_list->aggregates = new AbstractAttributeAggregator *[node->GetUniqueAggTerms().size()];
+    aggregate_list = new (group_pool_->Allocate(sizeof(AggregateList)))
+        AggregateList();
+    aggregate_list->aggregates =
+        static_cast<AbstractAttributeAggregator **>(group_pool_->Allocate(
+            node->GetUniqueAggTerms().size() *
+            sizeof(AbstractAttributeAggregator *)));
     // Make a deep copy of the first tuple we meet
     for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
       // first_tuple_values has the ownership
@@ -238,6 +347,39 @@ bool HashAggregator::Finalize() {
       return false;
     }
   }
+
+  if (partitions_.empty()) {
+    return true;
+  }
+
+  // The memory of the groups output already goes to the partitions
+  ClearGroups();
+  return FinalizePartitions();
+}
+
+bool HashAggregator::FinalizePartitions() {
+  std::vector<type::Value> values;
+  expression::ContainerTuple<std::vector<type::Value>> tuple(&values);
+  for (auto &partition : partitions_) {
+    if (partition->GetRowCount() == 0) {
+      continue;
+    }
+
+    HashAggregator aggregator(node, output_table, executor_context,
+                              num_input_columns, partition_level_ + 1);
+    partition->Rewind();
+    while (partition->Next(values)) {
+      if (aggregator.Advance(&tuple) == false) {
+        return false;
+      }
+    }
+    if (aggregator.Finalize() == false) {
+      return false;
+    }
+
+    // Remove the file as soon as it is done
+    partition.reset();
+  }
   return true;
 }
 
@@ -388,6 +530,81 @@ bool PlainAggregator::Advance(AbstractTuple *next_tuple) {
   return true;
 }
 
+bool PlainAggregator::AdvanceTile(LogicalTile *tile) {
+  std::vector<oid_t> column_ids;
+  if (GetKernelColumns(tile, column_ids) == false) {
+    return AbstractAggregator::AdvanceTile(tile);
+  }
+
+  std::vector<oid_t> tuple_ids;
+  for (oid_t aggno = 0; aggno < column_ids.size(); aggno++) {
+    storage::ColumnAggregate column_aggregate;
+    if (column_ids[aggno] == INVALID_OID) {
+      column_aggregate.row_count = tile->GetTupleCount();
+    } else {
+      // The tuples of the base tile, tuples missing from it are NULL
+      const auto &column_info = tile->GetColumnInfo(column_ids[aggno]);
+      const auto &position_list =
+          tile->GetPositionList(column_info.position_list_idx);
+      tuple_ids.clear();
+      for (oid_t tuple_id : *tile) {
+        if (position_list[tuple_id] != NULL_OID) {
+          tuple_ids.push_back(position_list[tuple_id]);
+        }
+      }
+      column_aggregate.row_count = tile->GetTupleCount() - tuple_ids.size();
+      storage::ColumnKernels::Aggregate(
+          storage::TileColumn(column_info.base_tile.get(),
+                              column_info.origin_column_id),
+          tuple_ids.data(), tuple_ids.size(), column_aggregate);
+    }
+    aggregates[aggno]->DAdvanceColumn(column_aggregate);
+  }
+  return true;
+}
+
+bool PlainAggregator::GetKernelColumns(LogicalTile *tile,
+                                       std::vector<oid_t> &column_ids) const {
+  for (const auto &agg_term : node->GetUniqueAggTerms()) {
+    if (agg_term.distinct) {
+      return false;
+    }
+    if (agg_term.aggtype == ExpressionType::AGGREGATE_COUNT_STAR) {
+      column_ids.push_back(INVALID_OID);
+      continue;
+    }
+    if (agg_term.aggtype != ExpressionType::AGGREGATE_COUNT &&
+        agg_term.aggtype != ExpressionType::AGGREGATE_SUM &&
+        agg_term.aggtype != ExpressionType::AGGREGATE_MIN &&
+        agg_term.aggtype != ExpressionType::AGGREGATE_MAX) {
+      return false;
+    }
+
+    // A fixed-width numeric column of the tile
+    const auto *expr = agg_term.expression;
+    if (expr == nullptr ||
+        expr->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+      return false;
+    }
+    const auto *tuple_value =
+        static_cast<const expression::TupleValueExpression *>(expr);
+    oid_t column_id = tuple_value->GetColumnId();
+    if (tuple_value->GetTupleId() != 0 ||
+        column_id >= tile->GetColumnCount()) {
+      return false;
+    }
+    const auto &column_info = tile->GetColumnInfo(column_id);
+    const auto *schema = column_info.base_tile->GetSchema();
+    if (!schema->IsInlined(column_info.origin_column_id) ||
+        !storage::ColumnKernels::IsSupported(
+            schema->GetType(column_info.origin_column_id))) {
+      return false;
+    }
+    column_ids.push_back(column_id);
+  }
+  return true;
+}
+
 bool PlainAggregator::Finalize() {
   if (!Helper(node, aggregates, output_table, nullptr,
               this->executor_context)) {
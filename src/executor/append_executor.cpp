@@ -12,6 +12,8 @@
 
 
 #include "common/logger.h"
+#include "concurrency/transaction.h"
+#include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/append_executor.h"
 
@@ -46,8 +48,17 @@ bool AppendExecutor::DExecute() {
     if (children_[cur_child_id_]->Execute()) {
       SetOutput(children_[cur_child_id_]->GetOutput());
       return true;
-    } else
-      cur_child_id_++;
+    }
+
+    // a child that failed a write, e.g. the update of one partition, fails
+    // the transaction, which runs none of the others
+    if (executor_context_ != nullptr &&
+        executor_context_->GetTransaction() != nullptr &&
+        executor_context_->GetTransaction()->GetResult() ==
+            ResultType::FAILURE) {
+      return false;
+    }
+    cur_child_id_++;
   }
 
   return false;
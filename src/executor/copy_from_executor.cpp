@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_from_executor.cpp
+//
+// Identification: src/executor/copy_from_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/copy_from_executor.h"
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "executor/copy_from_loader.h"
+#include "executor/executor_context.h"
+#include "planner/copy_plan.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Constructor for the copy from executor.
+ * @param node Copy node corresponding to this executor.
+ */
+CopyFromExecutor::CopyFromExecutor(const planner::AbstractPlan *node,
+                                   ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+CopyFromExecutor::~CopyFromExecutor() {
+  if (file_ != nullptr) {
+    fclose(file_);
+  }
+}
+
+/**
+ * @brief Open the input file.
+ * @return true on success, false otherwise.
+ */
+bool CopyFromExecutor::DInit() {
+  PL_ASSERT(children_.size() == 0);
+
+  const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
+  PL_ASSERT(node.table != nullptr);
+
+  if (file_ != nullptr) {
+    fclose(file_);
+  }
+  file_ = fopen(node.file_path.c_str(), "r");
+  if (file_ == nullptr) {
+    throw ExecutorException("Failed to open file " + node.file_path + ": " +
+                            std::string(strerror(errno)));
+  }
+
+  row_count_ = 0;
+  done_ = false;
+  return true;
+}
+
+/**
+ * @brief Load all rows of the file.
+ * @return true on success, false if a constraint was violated.
+ */
+bool CopyFromExecutor::DExecute() {
+  if (done_) {
+    return false;
+  }
+  done_ = true;
+
+  const planner::CopyPlan &node = GetPlanNode<planner::CopyPlan>();
+  CopyFromLoader loader(node.table, node.delimiter,
+                        executor_context_->GetTransaction());
+
+  std::vector<char> block(CopyFromLoader::kChunkSize);
+  bool success = true;
+  while (success) {
+    size_t bytes_read = fread(block.data(), 1, block.size(), file_);
+    if (ferror(file_)) {
+      throw ExecutorException("Failed to read the file to copy from: " +
+                              std::string(strerror(errno)));
+    }
+    if (bytes_read == 0) {
+      success = loader.Finish();
+      break;
+    }
+    success = loader.Append(block.data(), bytes_read);
+  }
+
+  row_count_ = loader.GetRowCount();
+  executor_context_->num_processed += row_count_;
+  return success;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,346 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_from_loader.cpp
+//
+// Identification: src/executor/copy_from_loader.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/copy_from_loader.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "storage/data_table.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+// The lines of a chunk of the text and the tuples parsed from them
+struct CopyFromLoader::Chunk {
+  std::string text;
+
+  // The line number of the first line, for errors
+  size_t first_line = 0;
+
+  // The data of the varlen values of the tuples
+  std::unique_ptr<type::AbstractPool> pool;
+
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+
+  bool parsed = false;
+
+  // The exception thrown while parsing, if any
+  std::exception_ptr error;
+};
+
+//===----------------------------------------------------------------------===//
+// The threads that parse the chunks of a COPY FROM. They are stopped and
+// joined once the loader is destroyed, also when loading failed.
+//===----------------------------------------------------------------------===//
+class ParserThreads {
+ public:
+  typedef std::function<void(CopyFromLoader::Chunk &)> Parse;
+
+  ParserThreads(size_t thread_count, Parse parse) : parse_(parse) {
+    for (size_t i = 0; i < thread_count; i++) {
+      threads_.emplace_back([this] { Run(); });
+    }
+  }
+
+  ~ParserThreads() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    cv_.notify_all();
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Queue a chunk to be parsed. It must stay alive until it is parsed.
+  void Submit(CopyFromLoader::Chunk *chunk) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(chunk);
+    }
+    cv_.notify_all();
+  }
+
+  // Wait until the chunk is parsed
+  void Wait(CopyFromLoader::Chunk *chunk) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [chunk] { return chunk->parsed; });
+  }
+
+ private:
+  void Run() {
+    while (true) {
+      CopyFromLoader::Chunk *chunk;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return closed_ || !pending_.empty(); });
+        if (closed_) {
+          return;
+        }
+        chunk = pending_.front();
+        pending_.pop_front();
+      }
+
+      try {
+        parse_(*chunk);
+      } catch (...) {
+        chunk->error = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chunk->parsed = true;
+      }
+      cv_.notify_all();
+    }
+  }
+
+  Parse parse_;
+
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+
+  // Signals queued and parsed chunks
+  std::condition_variable cv_;
+
+  std::deque<CopyFromLoader::Chunk *> pending_;
+
+  bool closed_ = false;
+};
+
+CopyFromLoader::CopyFromLoader(storage::DataTable *table, char delimiter,
+                               concurrency::Transaction *txn)
+    : table_(table), delimiter_(delimiter), txn_(txn) {
+  PL_ASSERT(table_ != nullptr);
+  size_t thread_count = FLAGS_copy_threads;
+  if (thread_count == 0) {
+    thread_count = std::thread::hardware_concurrency();
+  }
+
+  // Chunks are loaded in order, while the next ones are parsed. Bulk loads
+  // are not thread-safe within a transaction, so they are all done on the
+  // calling thread.
+  if (thread_count > 1) {
+    max_chunks_ = 2 * thread_count;
+    threads_.reset(new ParserThreads(
+        thread_count, [this](Chunk &chunk) { ParseChunk(chunk); }));
+  }
+}
+
+CopyFromLoader::~CopyFromLoader() {}
+
+bool CopyFromLoader::Append(const char *data, size_t len) {
+  text_.append(data, len);
+  while (text_.size() >= kChunkSize && CutChunk(false)) {
+    if (LoadChunks(max_chunks_ - 1) == false) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CopyFromLoader::Finish() {
+  if (text_.empty() == false) {
+    CutChunk(true);
+  }
+  bool success = LoadChunks(0);
+  LOG_DEBUG("Copied %lu rows into %s", row_count_, table_->GetName().c_str());
+  return success;
+}
+
+bool CopyFromLoader::CutChunk(bool last) {
+  size_t end = text_.size();
+  if (last == false) {
+    // Cut after the last new line that is not escaped, which is one preceded
+    // by an even number of backslashes
+    while (end > 0) {
+      size_t newline = text_.rfind('\n', end - 1);
+      if (newline == std::string::npos) {
+        end = 0;
+        break;
+      }
+      size_t backslashes = 0;
+      while (backslashes < newline &&
+             text_[newline - backslashes - 1] == '\\') {
+        backslashes++;
+      }
+      if (backslashes % 2 == 0) {
+        end = newline + 1;
+        break;
+      }
+      end = newline;
+    }
+
+    // A line longer than a chunk is continued by the next text
+    if (end == 0) {
+      return false;
+    }
+  }
+
+  std::unique_ptr<Chunk> chunk(new Chunk());
+  chunk->first_line = next_line_;
+  if (end == text_.size()) {
+    chunk->text = std::move(text_);
+    text_.clear();
+  } else {
+    chunk->text = text_.substr(0, end);
+    text_.erase(0, end);
+  }
+  next_line_ += std::count(chunk->text.begin(), chunk->text.end(), '\n');
+
+  if (threads_ != nullptr) {
+    threads_->Submit(chunk.get());
+  }
+  chunks_.push_back(std::move(chunk));
+  return true;
+}
+
+void CopyFromLoader::ParseChunk(Chunk &chunk) const {
+  const catalog::Schema *schema = table_->GetSchema();
+  const oid_t column_count = schema->GetColumnCount();
+  chunk.pool.reset(new type::EphemeralPool());
+
+  const std::string &text = chunk.text;
+  size_t line = chunk.first_line;
+  std::vector<std::string> fields;
+  std::vector<bool> is_empty;
+  std::string field;
+  bool field_empty = true;
+
+  auto end_field = [&] {
+    fields.push_back(std::move(field));
+    is_empty.push_back(field_empty);
+    field.clear();
+    field_empty = true;
+  };
+
+  auto end_row = [&] {
+    // Skip empty lines
+    if (fields.size() == 1 && is_empty[0]) {
+      fields.clear();
+      is_empty.clear();
+      return;
+    }
+    if (fields.size() != column_count) {
+      throw ExecutorException("COPY FROM line " + std::to_string(line) +
+                              " has " + std::to_string(fields.size()) +
+                              " fields, expected " +
+                              std::to_string(column_count));
+    }
+
+    std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+    try {
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        if (is_empty[column_itr]) {
+          tuple->SetValue(column_itr, type::ValueFactory::GetNullValueByType(
+                                          schema->GetType(column_itr)),
+                          chunk.pool.get());
+        } else {
+          tuple->SetValue(column_itr,
+                          type::ValueFactory::GetVarcharValue(
+                              fields[column_itr].c_str(), false),
+                          chunk.pool.get());
+        }
+      }
+    } catch (Exception &e) {
+      throw ExecutorException("COPY FROM line " + std::to_string(line) + ": " +
+                              e.what());
+    }
+    chunk.tuples.push_back(std::move(tuple));
+    fields.clear();
+    is_empty.clear();
+  };
+
+  for (size_t pos = 0; pos < text.size(); pos++) {
+    char ch = text[pos];
+    if (ch == '\\' && pos + 1 < text.size()) {
+      // An escaped new line is part of the field
+      field.push_back(text[++pos]);
+      field_empty = false;
+    } else if (ch == delimiter_) {
+      end_field();
+    } else if (ch == '\n') {
+      // Windows line ends
+      if (!field.empty() && field.back() == '\r') {
+        field.pop_back();
+        field_empty = field.empty();
+      }
+      end_field();
+      end_row();
+      line++;
+    } else {
+      field.push_back(ch);
+      field_empty = false;
+    }
+  }
+
+  // The last line of the text
+  if (!field_empty || !fields.empty()) {
+    end_field();
+    end_row();
+  }
+  LOG_TRACE("Parsed %lu rows from line %lu", chunk.tuples.size(),
+            chunk.first_line);
+}
+
+bool CopyFromLoader::LoadChunk(Chunk &chunk) {
+  if (chunk.error != nullptr) {
+    std::rethrow_exception(chunk.error);
+  }
+  if (chunk.tuples.empty()) {
+    return true;
+  }
+
+  if (table_->BulkInsert(chunk.tuples, txn_) == false) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    txn_manager.SetTransactionResult(txn_, ResultType::FAILURE);
+    return false;
+  }
+  row_count_ += chunk.tuples.size();
+  return true;
+}
+
+bool CopyFromLoader::LoadChunks(size_t max_chunks) {
+  while (chunks_.size() > max_chunks) {
+    Chunk *chunk = chunks_.front().get();
+    if (threads_ != nullptr) {
+      threads_->Wait(chunk);
+    } else {
+      ParseChunk(*chunk);
+    }
+    if (LoadChunk(*chunk) == false) {
+      return false;
+    }
+    chunks_.pop_front();
+  }
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
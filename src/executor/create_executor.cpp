@@ -12,10 +12,16 @@
 
 #include "executor/create_executor.h"
 
+#include <algorithm>
+
 #include "catalog/catalog.h"
 #include "common/logger.h"
 #include "concurrency/transaction.h"
 #include "executor/executor_context.h"
+#include "storage/aggregate_view.h"
+#include "storage/data_table.h"
+#include "storage/partitioned_table.h"
+#include "type/value_factory.h"
 
 
 namespace peloton {
@@ -49,6 +55,25 @@ bool CreateExecutor::DExecute() {
 
     ResultType result = catalog::Catalog::GetInstance()->CreateTable(
         database_name, table_name, std::move(schema), current_txn);
+    // the new table is still empty
+    if (result == ResultType::SUCCESS && node.IsAppendOnly() == true) {
+      catalog::Catalog::GetInstance()
+          ->GetTableWithName(database_name, table_name, current_txn)
+          ->SetAppendOnly();
+    }
+    if (result == ResultType::SUCCESS &&
+        node.GetPartitionColumn().empty() == false) {
+      std::vector<type::Value> lower_bounds;
+      for (auto &bound : node.GetRangePartitionBounds()) {
+        lower_bounds.push_back(type::ValueFactory::GetVarcharValue(bound));
+      }
+      auto partition_type = lower_bounds.empty()
+                                ? storage::PartitionType::HASH
+                                : storage::PartitionType::RANGE;
+      result = catalog::Catalog::GetInstance()->CreatePartitions(
+          database_name, table_name, node.GetPartitionColumn(), partition_type,
+          lower_bounds, node.GetHashPartitionCount(), current_txn);
+    }
     current_txn->SetResult(result);
 
     if (current_txn->GetResult() == ResultType::SUCCESS) {
@@ -72,7 +97,7 @@ bool CreateExecutor::DExecute() {
 
     ResultType result = catalog::Catalog::GetInstance()->CreateIndex(
         DEFAULT_DB_NAME, table_name, index_attrs, index_name, unique_flag,
-        index_type, current_txn);
+        index_type, current_txn, node.GetIndexPredicate());
     current_txn->SetResult(result);
 
     if (current_txn->GetResult() == ResultType::SUCCESS) {
@@ -84,6 +109,39 @@ bool CreateExecutor::DExecute() {
                 ResultTypeToString(current_txn->GetResult()).c_str());
     }
   }
+
+  // Check if query was for creating a materialized view
+  if (node.GetCreateType() == CreateType::VIEW) {
+    auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+        node.GetDatabaseName(), node.GetTableName());
+    auto schema = table->GetSchema();
+    std::vector<oid_t> group_column_ids;
+    for (auto &column_name : node.GetViewGroupColumns()) {
+      group_column_ids.push_back(schema->GetColumnID(column_name));
+    }
+    std::vector<oid_t> aggregate_column_ids;
+    for (auto &column_name : node.GetViewAggregateColumns()) {
+      aggregate_column_ids.push_back(schema->GetColumnID(column_name));
+    }
+
+    ResultType result = ResultType::FAILURE;
+    if (std::find(group_column_ids.begin(), group_column_ids.end(),
+                  INVALID_OID) == group_column_ids.end() &&
+        std::find(aggregate_column_ids.begin(), aggregate_column_ids.end(),
+                  INVALID_OID) == aggregate_column_ids.end() &&
+        storage::AggregateViewManager::GetInstance().CreateView(
+            node.GetViewName(), table, group_column_ids,
+            aggregate_column_ids) == true) {
+      result = ResultType::SUCCESS;
+    }
+    current_txn->SetResult(result);
+
+    if (current_txn->GetResult() == ResultType::SUCCESS) {
+      LOG_TRACE("Creating materialized view succeeded!");
+    } else {
+      LOG_TRACE("Creating materialized view failed!");
+    }
+  }
   return false;
 }
 }
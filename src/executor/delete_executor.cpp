@@ -16,6 +16,7 @@
 
 #include "type/value.h"
 #include "planner/delete_plan.h"
+#include "planner/seq_scan_plan.h"
 #include "catalog/manager.h"
 #include "common/container_tuple.h"
 #include "common/logger.h"
@@ -25,6 +26,8 @@
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
+#include "concurrency/contention_manager.h"
 #include "concurrency/transaction_manager_factory.h"
 
 namespace peloton {
@@ -67,6 +70,12 @@ bool DeleteExecutor::DInit() {
  */
 bool DeleteExecutor::DExecute() {
   PL_ASSERT(target_table_);
+
+  if (tile_groups_deleted_ == false) {
+    tile_groups_deleted_ = true;
+    DeleteTileGroups();
+  }
+
   // Retrieve next tile.
   if (!children_[0]->Execute()) {
     return false;
@@ -170,6 +179,8 @@ bool DeleteExecutor::DExecute() {
       } else {
         // transaction should be aborted as we cannot update the latest version.
         LOG_TRACE("Fail to update tuple. Set txn failure.");
+        concurrency::ContentionManager::GetInstance().RecordConflict(
+            tile_group->GetTileGroupId(), ConflictType::WRITE_WRITE);
         transaction_manager.SetTransactionResult(current_txn, ResultType::FAILURE);
         return false;
       }
@@ -179,5 +190,54 @@ bool DeleteExecutor::DExecute() {
   return true;
 }
 
+/**
+ * @brief Delete the tile groups in which every tuple satisfies the predicate
+ * of the child sequential scan, e.g. all of them for a truncate, without
+ * touching their tuples. The indexes and the tile groups are cleaned up by
+ * the GC. The tuples of the other tile groups, and of those that cannot be
+ * deleted at once, are deleted one by one.
+ */
+void DeleteExecutor::DeleteTileGroups() {
+  auto scan_plan =
+      dynamic_cast<const planner::SeqScanPlan *>(children_[0]->GetRawNode());
+  if (scan_plan == nullptr || scan_plan->GetTable() != target_table_ ||
+      scan_plan->GetChildren().empty() == false) {
+    return;
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  auto predicate = scan_plan->GetPredicate();
+
+  oid_t tile_group_count = target_table_->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = target_table_->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    if (predicate != nullptr &&
+        tile_group->GetZoneMap()->SatisfiesAll(predicate, executor_context_) ==
+            false) {
+      continue;
+    }
+
+    if (transaction_manager.PerformTileGroupDelete(
+            current_txn, tile_group->GetTileGroupId()) == false) {
+      continue;
+    }
+
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t slot_count = tile_group_header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_id = 0; tuple_id < slot_count; tuple_id++) {
+      if (tile_group_header->IsDeletedSlot(tuple_id) == true) {
+        executor_context_->num_processed += 1;  // deleted one
+      }
+    }
+  }
+}
+
 }  // namespace executor
 }  // namespace peloton
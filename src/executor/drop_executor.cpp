@@ -16,6 +16,7 @@
 #include "common/logger.h"
 #include "concurrency/transaction.h"
 #include "executor/executor_context.h"
+#include "storage/aggregate_view.h"
 
 namespace peloton {
 namespace executor {
@@ -43,8 +44,15 @@ bool DropExecutor::DExecute() {
 
   auto current_txn = context->GetTransaction();
 
-  ResultType result = catalog::Catalog::GetInstance()->DropTable(
-      DEFAULT_DB_NAME, table_name, current_txn);
+  ResultType result;
+  if (node.IsView() == true) {
+    bool dropped =
+        storage::AggregateViewManager::GetInstance().DropView(table_name);
+    result = (dropped == true) ? ResultType::SUCCESS : ResultType::FAILURE;
+  } else {
+    result = catalog::Catalog::GetInstance()->DropTable(
+        DEFAULT_DB_NAME, table_name, current_txn);
+  }
   current_txn->SetResult(result);
 
   if (current_txn->GetResult() == ResultType::SUCCESS) {
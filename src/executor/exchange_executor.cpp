@@ -0,0 +1,354 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// exchange_executor.cpp
+//
+// Identification: src/executor/exchange_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/exchange_executor.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "common/logger.h"
+#include "common/thread_pool.h"
+#include "concurrency/transaction.h"
+#include "configuration/configuration.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "planner/exchange_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// The worker threads of all exchanges. They are started on the first
+// exchange that runs in parallel.
+//===----------------------------------------------------------------------===//
+class ExchangeWorkerPool {
+ public:
+  static ExchangeWorkerPool &GetInstance() {
+    static ExchangeWorkerPool worker_pool;
+    return worker_pool;
+  }
+
+  ~ExchangeWorkerPool() {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (worker_count_ > 0) {
+      worker_pool_.Shutdown();
+    }
+  }
+
+  // Number of worker threads, not counting the calling thread of an exchange
+  size_t GetWorkerCount() {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (!started_) {
+      size_t thread_count = FLAGS_exchange_threads;
+      if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency();
+      }
+      worker_count_ = thread_count > 1 ? thread_count - 1 : 0;
+      if (worker_count_ > 0) {
+        worker_pool_.Initialize(worker_count_, 0);
+      }
+      started_ = true;
+    }
+    return worker_count_;
+  }
+
+  template <typename Task>
+  void SubmitTask(Task &&task) {
+    worker_pool_.SubmitTask(std::forward<Task>(task));
+  }
+
+ private:
+  ThreadPool worker_pool_;
+
+  size_t worker_count_ = 0;
+
+  bool started_ = false;
+
+  std::mutex pool_mutex_;
+};
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// The state an exchange shares with its workers. It is owned by the tasks of
+// the workers too, since a task may only start after the exchange is gone. It
+// then finds the exchange closed, and returns without touching the instances.
+//===----------------------------------------------------------------------===//
+struct ExchangeExecutor::SharedState {
+  std::vector<AbstractExecutor *> instances;
+
+  std::mutex mutex;
+
+  // Signals queued tiles, free space in the queue and finished workers
+  std::condition_variable cv;
+
+  // The tiles produced by the workers
+  std::deque<std::unique_ptr<LogicalTile>> tiles;
+
+  // The next instance to scan
+  size_t next_instance = 0;
+
+  // Workers that are scanning an instance
+  size_t active_workers = 0;
+
+  // Set once the exchange stops, after which no more instances are taken
+  bool closed = false;
+
+  // The first exception thrown by a worker
+  std::exception_ptr error;
+
+  // Take the next instance to scan, if any. Must hold the mutex.
+  AbstractExecutor *TakeInstance() {
+    if (closed || error != nullptr || next_instance >= instances.size()) {
+      return nullptr;
+    }
+    return instances[next_instance++];
+  }
+
+  // Scan instances on a worker thread until none are left
+  void RunWorker() {
+    while (true) {
+      AbstractExecutor *instance = nullptr;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        instance = TakeInstance();
+        if (instance == nullptr) {
+          return;
+        }
+        active_workers++;
+      }
+
+      try {
+        ScanInstance(*instance);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        active_workers--;
+      }
+      cv.notify_all();
+    }
+  }
+
+  // Queue the tiles of the instance, waiting while the queue is full
+  void ScanInstance(AbstractExecutor &instance) {
+    while (instance.Execute()) {
+      std::unique_ptr<LogicalTile> tile(instance.GetOutput());
+      if (tile == nullptr) {
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock,
+              [this] { return closed || tiles.size() < kMaxQueuedTiles; });
+      if (closed) {
+        return;
+      }
+      tiles.push_back(std::move(tile));
+      lock.unlock();
+      cv.notify_all();
+    }
+  }
+};
+
+/**
+ * @brief Constructor
+ */
+ExchangeExecutor::ExchangeExecutor(const planner::AbstractPlan *node,
+                                   ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+ExchangeExecutor::~ExchangeExecutor() { StopWorkers(); }
+
+/**
+ * @brief Basic checks, and set up the instances of the child.
+ * @return true on success, false otherwise.
+ */
+bool ExchangeExecutor::DInit() {
+  PL_ASSERT(children_.size() == 1);
+
+  const auto *child_plan = GetRawNode()->GetChildren()[0].get();
+  auto *child = dynamic_cast<SeqScanExecutor *>(children_[0]);
+  if (child_plan->GetPlanNodeType() != PlanNodeType::SEQSCAN ||
+      !child_plan->GetChildren().empty() || child == nullptr) {
+    LOG_ERROR("The child of an exchange must be a sequential scan of a table");
+    return false;
+  }
+
+  // A previous run may have left the child with a range of the tile groups
+  StopWorkers();
+  if (!instances_.empty()) {
+    child->SetTileGroupRange(START_OID, INVALID_OID);
+    if (!child->Init()) {
+      return false;
+    }
+  }
+  instances_.clear();
+  owned_instances_.clear();
+  local_instance_ = nullptr;
+  serial_ = true;
+
+  return InitInstances();
+}
+
+bool ExchangeExecutor::InitInstances() {
+  const auto &node = GetPlanNode<planner::ExchangePlan>();
+  const auto &scan_plan = *static_cast<const planner::SeqScanPlan *>(
+      GetRawNode()->GetChildren()[0].get());
+
+  size_t worker_count = ExchangeWorkerPool::GetInstance().GetWorkerCount();
+
+  size_t num_tile_groups = scan_plan.GetTable()->GetTileGroupCount();
+  size_t num_instances = node.GetNumInstances();
+  if (num_instances == 0) {
+    num_instances = worker_count + 1;
+  }
+  num_instances = std::min(num_instances, num_tile_groups);
+  if (worker_count == 0 || num_instances <= 1) {
+    // The child scans the whole table on the calling thread
+    return true;
+  }
+
+  // Every instance scans a range of the tile groups, the first one is the
+  // child. It was initialized for the whole table already.
+  for (size_t i = 0; i < num_instances; i++) {
+    auto *instance = static_cast<SeqScanExecutor *>(children_[0]);
+    if (i > 0) {
+      owned_instances_.emplace_back(
+          new SeqScanExecutor(&scan_plan, executor_context_));
+      instance = owned_instances_.back().get();
+    }
+    instance->SetTileGroupRange(num_tile_groups * i / num_instances,
+                                num_tile_groups * (i + 1) / num_instances);
+    if (!instance->Init()) {
+      return false;
+    }
+    instances_.push_back(instance);
+  }
+  serial_ = false;
+
+  // The workers record their reads in the transaction until they are stopped
+  executor_context_->GetTransaction()->Share();
+  shared_state_ = std::make_shared<SharedState>();
+  shared_state_->instances = instances_;
+
+  // The calling thread takes instances too, so the workers that don't get any
+  // return at once
+  auto shared_state = shared_state_;
+  size_t num_tasks = std::min(worker_count, num_instances - 1);
+  for (size_t i = 0; i < num_tasks; i++) {
+    ExchangeWorkerPool::GetInstance().SubmitTask(
+        [shared_state] { shared_state->RunWorker(); });
+  }
+
+  LOG_TRACE("Exchange runs %lu instances on up to %lu workers",
+            (unsigned long)num_instances, (unsigned long)num_tasks);
+  return true;
+}
+
+/**
+ * @brief Return the next tile of any instance.
+ * @return true on success, false once all instances are done.
+ */
+bool ExchangeExecutor::DExecute() {
+  if (serial_) {
+    if (children_[0]->Execute()) {
+      SetOutput(children_[0]->GetOutput());
+      return true;
+    }
+    return false;
+  }
+
+  auto &shared_state = *shared_state_;
+  while (true) {
+    // The tiles of the workers come first, so that they can continue
+    {
+      std::unique_lock<std::mutex> lock(shared_state.mutex);
+      if (shared_state.error != nullptr) {
+        std::rethrow_exception(shared_state.error);
+      }
+      if (!shared_state.tiles.empty()) {
+        SetOutput(shared_state.tiles.front().release());
+        shared_state.tiles.pop_front();
+        lock.unlock();
+        shared_state.cv.notify_all();
+        return true;
+      }
+      if (local_instance_ == nullptr) {
+        local_instance_ = shared_state.TakeInstance();
+      }
+    }
+
+    // Scan an instance on the calling thread
+    if (local_instance_ != nullptr) {
+      if (local_instance_->Execute()) {
+        LogicalTile *tile = local_instance_->GetOutput();
+        if (tile != nullptr) {
+          SetOutput(tile);
+          return true;
+        }
+      } else {
+        local_instance_ = nullptr;
+      }
+      continue;
+    }
+
+    // All instances are taken, wait for the tiles of the workers
+    std::unique_lock<std::mutex> lock(shared_state.mutex);
+    shared_state.cv.wait(lock, [&shared_state] {
+      return !shared_state.tiles.empty() || shared_state.active_workers == 0;
+    });
+    if (shared_state.tiles.empty() && shared_state.active_workers == 0) {
+      if (shared_state.error != nullptr) {
+        std::rethrow_exception(shared_state.error);
+      }
+      return false;
+    }
+  }
+}
+
+void ExchangeExecutor::StopWorkers() {
+  if (shared_state_ == nullptr) {
+    return;
+  }
+
+  auto &shared_state = *shared_state_;
+  {
+    std::unique_lock<std::mutex> lock(shared_state.mutex);
+    shared_state.closed = true;
+    shared_state.cv.notify_all();
+    shared_state.cv.wait(lock, [&shared_state] {
+      return shared_state.active_workers == 0;
+    });
+    shared_state.tiles.clear();
+  }
+  shared_state_.reset();
+  executor_context_->GetTransaction()->Unshare();
+}
+
+}  // namespace executor
+}  // namespace peloton
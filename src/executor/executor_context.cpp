@@ -14,17 +14,22 @@
 #include "type/value.h"
 #include "executor/executor_context.h"
 #include "concurrency/transaction.h"
+#include "configuration/configuration.h"
 
 namespace peloton {
 namespace executor {
 
 ExecutorContext::ExecutorContext(concurrency::Transaction *transaction)
-    : transaction_(transaction) {}
+    : transaction_(transaction),
+      pool_(new type::ArenaPool()),
+      memory_budget_(FLAGS_query_memory_budget_mb << 20) {}
 
 ExecutorContext::ExecutorContext(concurrency::Transaction *transaction,
                                  const std::vector<type::Value> &params)
     : transaction_(transaction),
-      params_(params) {}
+      params_(params),
+      pool_(new type::ArenaPool()),
+      memory_budget_(FLAGS_query_memory_budget_mb << 20) {}
 
 ExecutorContext::~ExecutorContext() {
   // params will be freed automatically
@@ -46,15 +51,24 @@ void ExecutorContext::ClearParams() {
   params_.clear();
 }
 
-type::EphemeralPool *ExecutorContext::GetPool() {
+type::AbstractPool *ExecutorContext::GetPool() {
+  // Created with the context, so that parallel executors need not race to
+  return pool_.get();
+}
 
-  // construct pool if needed
-  if (pool_.get() == nullptr) {
-    pool_.reset(new type::EphemeralPool());
-  }
+bool ExecutorContext::ReserveMemory(size_t bytes) {
+  size_t reserved = reserved_memory_.load();
+  do {
+    if (memory_budget_ != 0 && reserved + bytes > memory_budget_) {
+      return false;
+    }
+  } while (!reserved_memory_.compare_exchange_weak(reserved, reserved + bytes));
+  return true;
+}
 
-  // return pool
-  return pool_.get();
+void ExecutorContext::ReleaseMemory(size_t bytes) {
+  PL_ASSERT(reserved_memory_.load() >= bytes);
+  reserved_memory_.fetch_sub(bytes);
 }
 
 }  // namespace executor
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// executor_profile.cpp
+//
+// Identification: src/executor/executor_profile.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/executor_profile.h"
+
+#include "planner/abstract_scan_plan.h"
+#include "storage/data_table.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace executor {
+
+ExecutorProfile ExecutorProfile::FromPlan(const planner::AbstractPlan &plan) {
+  ExecutorProfile profile;
+  profile.name = GetPlanName(plan);
+  for (auto &child : plan.GetChildren()) {
+    profile.children.push_back(FromPlan(*child));
+  }
+  return profile;
+}
+
+std::string ExecutorProfile::GetPlanName(const planner::AbstractPlan &plan) {
+  std::string name = PlanNodeTypeToString(plan.GetPlanNodeType());
+  switch (plan.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN:
+    case PlanNodeType::INDEXSCAN: {
+      auto table = static_cast<const planner::AbstractScan &>(plan).GetTable();
+      if (table != nullptr) {
+        name += " on " + table->GetName();
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return name;
+}
+
+std::vector<std::string> ExecutorProfile::GetLines() const {
+  std::vector<std::string> lines;
+  AddLines(0, lines);
+  return lines;
+}
+
+void ExecutorProfile::AddLines(const size_t depth,
+                               std::vector<std::string> &lines) const {
+  std::string line(depth * 2, ' ');
+  if (depth > 0) {
+    line += "-> ";
+  }
+  line += name;
+  if (is_compiled) {
+    line += StringUtil::Format(
+        " (compiled, compile=%.3f ms, init=%.3f ms, tear down=%.3f ms)",
+        compile_ms, init_ms, tear_down_ms);
+  }
+  if (is_profiled) {
+    line += StringUtil::Format(
+        " (rows=%llu loops=%llu time=%.3f ms memory=%s)",
+        (unsigned long long)tuple_count, (unsigned long long)execute_count,
+        execute_ms, StringUtil::FormatSize(memory_bytes).c_str());
+  }
+  lines.push_back(std::move(line));
+
+  for (auto &child : children) {
+    child.AddLines(depth + 1, lines);
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
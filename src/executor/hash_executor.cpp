@@ -14,8 +14,10 @@
 #include <utility>
 #include <vector>
 
+#include "catalog/schema.h"
 #include "common/logger.h"
 #include "type/value.h"
+#include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/hash_executor.h"
 #include "planner/hash_plan.h"
@@ -31,6 +33,12 @@ HashExecutor::HashExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context)
     : AbstractExecutor(node, executor_context) {}
 
+HashExecutor::~HashExecutor() {
+  if (reserved_memory_ > 0) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+  }
+}
+
 /**
  * @brief Do some basic checks and initialize executor state.
  * @return true on success, false otherwise.
@@ -41,6 +49,7 @@ bool HashExecutor::DInit() {
   // Initialize executor state
   done_ = false;
   result_itr = 0;
+  partitions_.clear();
 
   return true;
 }
@@ -51,16 +60,6 @@ bool HashExecutor::DExecute() {
   if (done_ == false) {
     const planner::HashPlan &node = GetPlanNode<planner::HashPlan>();
 
-    // First, get all the input logical tiles
-    while (children_[0]->Execute()) {
-      child_tiles_.emplace_back(children_[0]->GetOutput());
-    }
-
-    if (child_tiles_.size() == 0) {
-      LOG_TRACE("Hash Executor : false -- no child tiles ");
-      return false;
-    }
-
     /* *
      * HashKeys is a vector of TupleValue expr
      * from which we construct a vector of column ids that represent the
@@ -70,6 +69,7 @@ bool HashExecutor::DExecute() {
     auto &hashkeys = node.GetHashKeys();
 
     // Construct a logical tile
+    column_ids_.clear();
     for (auto &hashkey : hashkeys) {
       PL_ASSERT(hashkey->GetExpressionType() == ExpressionType::VALUE_TUPLE);
       auto tuple_value =
@@ -78,6 +78,39 @@ bool HashExecutor::DExecute() {
       column_ids_.push_back(tuple_value->GetColumnId());
     }
 
+    // First, get all the input logical tiles, or spill them once they exceed
+    // the memory budget
+    while (children_[0]->Execute()) {
+      std::unique_ptr<LogicalTile> child_tile(children_[0]->GetOutput());
+      if (partitions_.empty()) {
+        if (ReserveTile(child_tile.get())) {
+          child_tiles_.push_back(std::move(child_tile));
+          continue;
+        }
+        StartSpilling(child_tile.get());
+      }
+      SpillTile(child_tile.get());
+    }
+
+    if (!partitions_.empty()) {
+      LOG_TRACE("Hash Executor : false -- spilled to disk ");
+      done_ = true;
+      return false;
+    }
+
+    if (child_tiles_.size() == 0) {
+      LOG_TRACE("Hash Executor : false -- no child tiles ");
+      return false;
+    }
+
+    // Size the Bloom filter for all the input tuples
+    size_t num_tuples = 0;
+    for (const auto &child_tile : child_tiles_) {
+      num_tuples += child_tile->GetTupleCount();
+    }
+    bloom_filter_.Destroy();
+    bloom_filter_.Init(num_tuples);
+
     // Construct the hash table by going over each child logical tile and
     // hashing
     for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
@@ -96,6 +129,7 @@ bool HashExecutor::DExecute() {
         }
         hash_table_[key].insert(
                     std::make_pair(child_tile_itr, tuple_id));
+        bloom_filter_.Add(key.HashCode());
       }
     }
 
@@ -118,5 +152,73 @@ bool HashExecutor::DExecute() {
   return false;
 }
 
+bool HashExecutor::ReserveTile(LogicalTile *tile) {
+  // The hash table and the position lists of the tile
+  size_t tile_size =
+      tile->GetTupleCount() *
+      (kBytesPerTuple + tile->GetPositionLists().size() * sizeof(oid_t));
+  if (executor_context_ == nullptr ||
+      executor_context_->ReserveMemory(tile_size)) {
+    if (executor_context_ != nullptr) {
+      reserved_memory_ += tile_size;
+    }
+    return true;
+  }
+
+  if (spilling_enabled_) {
+    return false;
+  }
+
+  if (!over_budget_) {
+    LOG_WARN("Hash table exceeds the memory budget of the query, but cannot "
+             "spill to disk");
+    over_budget_ = true;
+  }
+  return true;
+}
+
+void HashExecutor::StartSpilling(LogicalTile *tile) {
+  LOG_DEBUG("Hash table spills to disk after %lu tiles",
+            (unsigned long)child_tiles_.size());
+
+  spilled_schema_.reset(tile->GetPhysicalSchema());
+  std::vector<type::TypeId> column_types;
+  for (oid_t column_id = 0; column_id < spilled_schema_->GetColumnCount();
+       column_id++) {
+    column_types.push_back(spilled_schema_->GetType(column_id));
+  }
+  for (size_t i = 0; i < SpillFile::kNumPartitions; i++) {
+    partitions_.emplace_back(new SpillFile(column_types));
+  }
+
+  for (auto &child_tile : child_tiles_) {
+    SpillTile(child_tile.get());
+  }
+  child_tiles_.clear();
+
+  if (reserved_memory_ > 0) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+    reserved_memory_ = 0;
+  }
+}
+
+void HashExecutor::SpillTile(LogicalTile *tile) {
+  oid_t column_count = tile->GetColumnCount();
+
+  std::vector<type::Value> values;
+  std::vector<type::Value> keys;
+  for (oid_t tuple_id : *tile) {
+    values.clear();
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      values.push_back(tile->GetValue(tuple_id, column_id));
+    }
+    keys.clear();
+    for (oid_t column_id : column_ids_) {
+      keys.push_back(values[column_id]);
+    }
+    partitions_[SpillFile::GetPartition(keys, 0)]->Append(values);
+  }
+}
+
 } /* namespace executor */
 } /* namespace peloton */
@@ -15,14 +15,67 @@
 
 #include "type/types.h"
 #include "common/logger.h"
+#include "executor/executor_context.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/hash_join_executor.h"
 #include "expression/abstract_expression.h"
 #include "common/container_tuple.h"
+#include "storage/tile.h"
 
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// The number of tuples of a left partition that are joined at a time
+constexpr size_t kSpilledLeftTileSize = 1024;
+
+// Read up to max_rows rows of the spill file into a temporary tile, and wrap
+// it in a logical tile. Returns nullptr at the end of the file.
+std::unique_ptr<LogicalTile> LoadSpilledRows(SpillFile &file,
+                                             const catalog::Schema &schema,
+                                             size_t max_rows) {
+  std::vector<std::vector<type::Value>> rows;
+  std::vector<type::Value> values;
+  while (rows.size() < max_rows && file.Next(values)) {
+    rows.push_back(std::move(values));
+  }
+  if (rows.empty()) {
+    return nullptr;
+  }
+
+  std::shared_ptr<storage::Tile> tile(
+      storage::TileFactory::GetTempTile(schema, rows.size()));
+  for (oid_t tuple_id = 0; tuple_id < rows.size(); tuple_id++) {
+    for (oid_t column_id = 0; column_id < rows[tuple_id].size(); column_id++) {
+      tile->SetValue(rows[tuple_id][column_id], tuple_id, column_id);
+    }
+  }
+  return std::unique_ptr<LogicalTile>(LogicalTileFactory::WrapTiles({tile}));
+}
+
+// Write the rows of the spill file to the partitions of the next level
+void SplitSpillFile(SpillFile &file, const std::vector<oid_t> &key_ids,
+                    size_t level,
+                    std::vector<std::unique_ptr<SpillFile>> &partitions) {
+  for (size_t i = 0; i < SpillFile::kNumPartitions; i++) {
+    partitions.emplace_back(new SpillFile(file.GetColumnTypes()));
+  }
+
+  std::vector<type::Value> values;
+  std::vector<type::Value> keys;
+  file.Rewind();
+  while (file.Next(values)) {
+    keys.clear();
+    for (oid_t key_id : key_ids) {
+      keys.push_back(values[key_id]);
+    }
+    partitions[SpillFile::GetPartition(keys, level)]->Append(values);
+  }
+}
+
+}  // namespace
+
 /**
  * @brief Constructor for hash join executor.
  * @param node Hash join node corresponding to this executor.
@@ -42,6 +95,13 @@ bool HashJoinExecutor::DInit() {
 
   hash_executor_ = reinterpret_cast<HashExecutor *>(children_[1]);
 
+  // Only inner joins can join the partitions of their children on their own
+  if (join_type_ == JoinType::INNER) {
+    hash_executor_->EnableSpilling();
+  }
+  spilled_ = false;
+  spilled_partitions_.clear();
+
   return true;
 }
 
@@ -63,6 +123,14 @@ bool HashJoinExecutor::DExecute() {
       return true;
     }
 
+    // Join the spilled partitions one at a time
+    if (spilled_ == true) {
+      if (JoinNextPartition() == false) {
+        return false;
+      }
+      continue;
+    }
+
     // Build outer join output when done
     if (left_child_done_ == true) {
       return BuildOuterJoinOutput();
@@ -78,6 +146,13 @@ bool HashJoinExecutor::DExecute() {
         BufferRightTile(children_[1]->GetOutput());
       }
       right_child_done_ = true;
+
+      // The hash table exceeded the budget, partition the left child too
+      if (hash_executor_->IsSpilled()) {
+        PartitionLeftChild();
+        spilled_ = true;
+        continue;
+      }
     }
 
     // Get next tile from LEFT child
@@ -101,24 +176,56 @@ bool HashJoinExecutor::DExecute() {
     // Build Join Tile
     //===------------------------------------------------------------------===//
 
-    // Get the hash table from the hash executor
-    auto &hash_table = hash_executor_->GetHashTable();
-    auto &hashed_col_ids = hash_executor_->GetHashKeyIds();
+    // Probe the hash table from the hash executor
+    ProbeHashTable(left_tile, left_result_tiles_.size() - 1,
+                   hash_executor_->GetHashTable(),
+                   &hash_executor_->GetBloomFilter(), right_result_tiles_);
 
-    oid_t prev_tile = INVALID_OID;
-    std::unique_ptr<LogicalTile> output_tile;
-    LogicalTile::PositionListsBuilder pos_lists_builder;
+    // Check if we have any buffered output tiles
+    if (buffered_output_tiles.empty() == false) {
+      auto output_tile = buffered_output_tiles.front();
+      SetOutput(output_tile);
+      buffered_output_tiles.pop_front();
 
-    // Go over the left tile
-    for (auto left_tile_itr : *left_tile) {
-      const expression::ContainerTuple<executor::LogicalTile> left_tuple(
-          left_tile, left_tile_itr, &hashed_col_ids);
+      return true;
+    } else {
+      // Try again
+      continue;
+    }
+  }
+}
+
+/**
+ * @brief Probes the hash table with the tuples of the left tile, and buffers
+ * the output tiles of the joined tuples.
+ */
+void HashJoinExecutor::ProbeHashTable(
+    LogicalTile *left_tile, size_t left_tile_idx,
+    const HashExecutor::HashMapType &hash_table,
+    const codegen::util::BloomFilter *bloom_filter,
+    const std::vector<std::unique_ptr<LogicalTile>> &right_tiles) {
+  auto &hashed_col_ids = hash_executor_->GetHashKeyIds();
+
+  oid_t prev_tile = INVALID_OID;
+  std::unique_ptr<LogicalTile> output_tile;
+  LogicalTile::PositionListsBuilder pos_lists_builder;
+
+  // Go over the left tile
+  for (auto left_tile_itr : *left_tile) {
+    const expression::ContainerTuple<executor::LogicalTile> left_tuple(
+        left_tile, left_tile_itr, &hashed_col_ids);
+
+    // Skip the hash table lookup for tuples that match no right tuple
+    if (bloom_filter != nullptr &&
+        !bloom_filter->Contains(left_tuple.HashCode())) {
+      continue;
+    }
 
-      // Find matching tuples in the hash table built on top of the right table
-      auto right_tuples = hash_table.find(left_tuple);
+    // Find matching tuples in the hash table built on top of the right table
+    auto right_tuples = hash_table.find(left_tuple);
 
-      if (right_tuples != hash_table.end()) {
-    	// Not yet supported due to assertion in gettomg right_tuples->first
+    if (right_tuples != hash_table.end()) {
+  	// Not yet supported due to assertion in gettomg right_tuples->first
 //    	if (predicate_ != nullptr) {
 //    		auto eval = predicate_->Evaluate(&left_tuple, &right_tuples->first,
 //					executor_context_);
@@ -126,63 +233,188 @@ bool HashJoinExecutor::DExecute() {
 //				continue;
 //    	}
 
-        RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_itr);
+      RecordMatchedLeftRow(left_tile_idx, left_tile_itr);
+
+      // Go over the matching right tuples
+      for (auto &location : right_tuples->second) {
+        // Check if we got a new right tile itr
+        if (prev_tile != location.first) {
+          // Check if we have any join tuples
+          if (pos_lists_builder.Size() > 0) {
+            LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+            output_tile->SetPositionListsAndVisibility(
+                pos_lists_builder.Release());
+            buffered_output_tiles.push_back(output_tile.release());
+          }
 
-        // Go over the matching right tuples
-        for (auto &location : right_tuples->second) {
-          // Check if we got a new right tile itr
-          if (prev_tile != location.first) {
-            // Check if we have any join tuples
-            if (pos_lists_builder.Size() > 0) {
-              LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
-              output_tile->SetPositionListsAndVisibility(
-                  pos_lists_builder.Release());
-              buffered_output_tiles.push_back(output_tile.release());
-            }
+          // Get the logical tile from right child
+          LogicalTile *right_tile = right_tiles[location.first].get();
 
-            // Get the logical tile from right child
-            LogicalTile *right_tile = right_result_tiles_[location.first].get();
+          // Build output logical tile
+          output_tile = BuildOutputLogicalTile(left_tile, right_tile);
 
-            // Build output logical tile
-            output_tile = BuildOutputLogicalTile(left_tile, right_tile);
+          // Build position lists
+          pos_lists_builder =
+              LogicalTile::PositionListsBuilder(left_tile, right_tile);
 
-            // Build position lists
-            pos_lists_builder =
-                LogicalTile::PositionListsBuilder(left_tile, right_tile);
+          pos_lists_builder.SetRightSource(&right_tile->GetPositionLists());
+        }
 
-            pos_lists_builder.SetRightSource(
-                &right_result_tiles_[location.first]->GetPositionLists());
-          }
+        // Add join tuple
+        pos_lists_builder.AddRow(left_tile_itr, location.second);
 
-          // Add join tuple
-          pos_lists_builder.AddRow(left_tile_itr, location.second);
+        RecordMatchedRightRow(location.first, location.second);
 
-          RecordMatchedRightRow(location.first, location.second);
+        // Cache prev logical tile itr
+        prev_tile = location.first;
+      }
+    }
+  }
 
-          // Cache prev logical tile itr
-          prev_tile = location.first;
-        }
+  // Check if we have any join tuples
+  if (pos_lists_builder.Size() > 0) {
+    LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    buffered_output_tiles.push_back(output_tile.release());
+  }
+}
+
+void HashJoinExecutor::PartitionLeftChild() {
+  auto &hashed_col_ids = hash_executor_->GetHashKeyIds();
+  std::vector<std::unique_ptr<SpillFile>> left_partitions;
+
+  std::vector<type::Value> values;
+  std::vector<type::Value> keys;
+  while (children_[0]->Execute()) {
+    std::unique_ptr<LogicalTile> left_tile(children_[0]->GetOutput());
+    if (left_partitions.empty()) {
+      left_spilled_schema_.reset(left_tile->GetPhysicalSchema());
+      std::vector<type::TypeId> column_types;
+      for (oid_t column_id = 0;
+           column_id < left_spilled_schema_->GetColumnCount(); column_id++) {
+        column_types.push_back(left_spilled_schema_->GetType(column_id));
+      }
+      for (size_t i = 0; i < SpillFile::kNumPartitions; i++) {
+        left_partitions.emplace_back(new SpillFile(column_types));
       }
     }
 
-    // Check if we have any join tuples
-    if (pos_lists_builder.Size() > 0) {
-      LOG_TRACE("Join tile size : %lu \n", pos_lists_builder.Size());
-      output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
-      buffered_output_tiles.push_back(output_tile.release());
+    oid_t column_count = left_tile->GetColumnCount();
+    for (oid_t tuple_id : *left_tile) {
+      values.clear();
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        values.push_back(left_tile->GetValue(tuple_id, column_id));
+      }
+      keys.clear();
+      for (oid_t column_id : hashed_col_ids) {
+        keys.push_back(values[column_id]);
+      }
+      left_partitions[SpillFile::GetPartition(keys, 0)]->Append(values);
     }
+  }
+  left_child_done_ = true;
 
-    // Check if we have any buffered output tiles
-    if (buffered_output_tiles.empty() == false) {
-      auto output_tile = buffered_output_tiles.front();
-      SetOutput(output_tile);
-      buffered_output_tiles.pop_front();
+  // An inner join of an empty left child is empty
+  if (left_partitions.empty()) {
+    return;
+  }
 
-      return true;
-    } else {
-      // Try again
+  auto &right_partitions = hash_executor_->GetPartitions();
+  for (size_t i = 0; i < SpillFile::kNumPartitions; i++) {
+    spilled_partitions_.push_back(SpilledPartition{
+        std::move(left_partitions[i]), std::move(right_partitions[i]), 0});
+  }
+  LOG_DEBUG("Hash join joins %lu spilled partitions",
+            (unsigned long)spilled_partitions_.size());
+}
+
+bool HashJoinExecutor::JoinNextPartition() {
+  while (!spilled_partitions_.empty()) {
+    SpilledPartition partition = std::move(spilled_partitions_.front());
+    spilled_partitions_.pop_front();
+    if (partition.left->GetRowCount() == 0 ||
+        partition.right->GetRowCount() == 0) {
       continue;
     }
+
+    // The hash table of the right partition and its tile
+    size_t build_size =
+        partition.right->GetByteCount() +
+        partition.right->GetRowCount() * HashExecutor::kBytesPerTuple;
+    bool reserved = executor_context_->ReserveMemory(build_size);
+    if (reserved == false) {
+      if (partition.level + 1 < SpillFile::kMaxPartitionLevel) {
+        Repartition(partition);
+        continue;
+      }
+      LOG_WARN("Spilled partition of a hash join exceeds the memory budget of "
+               "the query at partition level %lu",
+               (unsigned long)partition.level);
+    }
+
+    JoinPartition(partition);
+    if (reserved) {
+      executor_context_->ReleaseMemory(build_size);
+    }
+    if (!buffered_output_tiles.empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void HashJoinExecutor::JoinPartition(SpilledPartition &partition) {
+  auto &hashed_col_ids = hash_executor_->GetHashKeyIds();
+
+  // Build the hash table on the whole right partition
+  partition.right->Rewind();
+  std::vector<std::unique_ptr<LogicalTile>> right_tiles;
+  right_tiles.push_back(LoadSpilledRows(*partition.right,
+                                        *hash_executor_->GetSpilledSchema(),
+                                        partition.right->GetRowCount()));
+  LogicalTile *right_tile = right_tiles[0].get();
+
+  HashExecutor::HashMapType hash_table;
+  for (oid_t tuple_id : *right_tile) {
+    auto key = HashExecutor::HashMapType::key_type(right_tile, tuple_id,
+                                                   &hashed_col_ids);
+    hash_table[key].insert(std::make_pair(0, tuple_id));
+  }
+
+  // Probe it with the left partition a tile at a time
+  partition.left->Rewind();
+  while (true) {
+    std::unique_ptr<LogicalTile> left_tile(LoadSpilledRows(
+        *partition.left, *left_spilled_schema_, kSpilledLeftTileSize));
+    if (left_tile == nullptr) {
+      break;
+    }
+    ProbeHashTable(left_tile.get(), 0, hash_table, nullptr, right_tiles);
+  }
+}
+
+void HashJoinExecutor::Repartition(SpilledPartition &partition) {
+  auto &hashed_col_ids = hash_executor_->GetHashKeyIds();
+  size_t level = partition.level + 1;
+  LOG_DEBUG("Hash join partitions a partition of %lu tuples again at level %lu",
+            (unsigned long)partition.right->GetRowCount(),
+            (unsigned long)level);
+
+  std::vector<std::unique_ptr<SpillFile>> left_partitions;
+  std::vector<std::unique_ptr<SpillFile>> right_partitions;
+  SplitSpillFile(*partition.left, hashed_col_ids, level, left_partitions);
+  SplitSpillFile(*partition.right, hashed_col_ids, level, right_partitions);
+
+  // Join the new partitions first, so that their files are removed early. If
+  // all tuples have the same keys, partitioning again does not split them.
+  size_t right_row_count = partition.right->GetRowCount();
+  for (size_t i = 0; i < SpillFile::kNumPartitions; i++) {
+    size_t next_level = right_partitions[i]->GetRowCount() == right_row_count
+                            ? SpillFile::kMaxPartitionLevel
+                            : level;
+    spilled_partitions_.push_front(SpilledPartition{
+        std::move(left_partitions[i]), std::move(right_partitions[i]),
+        next_level});
   }
 }
 
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <ctime>
@@ -25,6 +26,7 @@
 #include "common/container_tuple.h"
 #include "common/logger.h"
 #include "common/timer.h"
+#include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/executor_context.h"
 #include "executor/hybrid_scan_executor.h"
@@ -35,6 +37,7 @@
 #include "storage/data_table.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
+#include "storage/zone_map.h"
 #include "type/types.h"
 
 namespace peloton {
@@ -42,8 +45,7 @@ namespace executor {
 
 HybridScanExecutor::HybridScanExecutor(const planner::AbstractPlan *node,
                                        ExecutorContext *executor_context)
-    : AbstractScanExecutor(node, executor_context),
-      indexed_tile_offset_(START_OID) {}
+    : AbstractScanExecutor(node, executor_context) {}
 
 bool HybridScanExecutor::DInit() {
   auto status = AbstractScanExecutor::DInit();
@@ -57,6 +59,12 @@ bool HybridScanExecutor::DInit() {
   type_ = node.GetHybridType();
   PL_ASSERT(table_ != nullptr);
 
+  vectorized_predicate_.reset();
+  if (predicate_ != nullptr) {
+    vectorized_predicate_.reset(
+        new expression::VectorizedPredicate(predicate_));
+  }
+
   // SEQUENTIAL SCAN
   if (type_ == HybridScanType::SEQUENTIAL) {
     LOG_TRACE("Sequential Scan");
@@ -112,26 +120,16 @@ bool HybridScanExecutor::DInit() {
   else if (type_ == HybridScanType::HYBRID) {
     LOG_TRACE("Hybrid Scan");
 
+    // Scan the tile groups the index does not cover first, their selectivity
+    // tells whether to use the index for the others
     table_tile_group_count_ = table_->GetTileGroupCount();
-    int offset = index_->GetIndexedTileGroupOff();
-    indexed_tile_offset_ = (offset == -1) ? INVALID_OID : (oid_t)offset;
-    block_threshold = 0;
-
-    if (indexed_tile_offset_ == INVALID_OID) {
-      current_tile_group_offset_ = START_OID;
-    } else {
-      current_tile_group_offset_ = indexed_tile_offset_ + 1;
-      std::shared_ptr<storage::TileGroup> tile_group;
-      if (current_tile_group_offset_ < table_tile_group_count_) {
-        tile_group = table_->GetTileGroup(current_tile_group_offset_);
-      } else {
-        tile_group = table_->GetTileGroup(table_tile_group_count_ - 1);
-      }
-
-      oid_t tuple_id = 0;
-      ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-      block_threshold = location.block;
-    }
+    indexed_tile_group_count_ = std::min<oid_t>(
+        index_->GetIndexedTileGroupOff(), table_tile_group_count_);
+    current_tile_group_offset_ = indexed_tile_group_count_;
+    indexed_tile_group_itr_ = START_OID;
+    index_tuples_.clear();
+    scanned_tuple_count_ = 0;
+    matched_tuple_count_ = 0;
 
     result_itr_ = START_OID;
     index_done_ = false;
@@ -180,89 +178,92 @@ bool HybridScanExecutor::SeqScanUtil() {
   assert(table_ != nullptr);
   assert(column_ids_.size() > 0);
 
-  auto &transaction_manager =
-      concurrency::TransactionManagerFactory::GetInstance();
-
-  auto current_txn = executor_context_->GetTransaction();
-
-  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
-
   // Retrieve next tile group.
   while (current_tile_group_offset_ < table_tile_group_count_) {
     LOG_TRACE("Current tile group offset : %u", current_tile_group_offset_);
     auto tile_group = table_->GetTileGroup(current_tile_group_offset_++);
-    auto tile_group_header = tile_group->GetHeader();
 
-    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+    // Skip tile groups dropped by the compactor
+    if (tile_group == nullptr) {
+      continue;
+    }
 
-    // Construct position list by looping through tile group
-    // and applying the predicate.
-    oid_t upper_bound_block = 0;
-    if (item_pointers_.size() > 0) {
-      auto reverse_iter = item_pointers_.rbegin();
-      upper_bound_block = reverse_iter->block;
+    if (ScanTileGroup(tile_group) == true) {
+      return true;
+    }
+    if (executor_context_->GetTransaction()->GetResult() ==
+        ResultType::FAILURE) {
+      return false;
     }
+  }
 
-    std::vector<oid_t> position_list;
-    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-      ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-      if (type_ == HybridScanType::HYBRID && item_pointers_.size() > 0 &&
-          location.block <= upper_bound_block) {
-        if (item_pointers_.find(location) != item_pointers_.end()) {
-          continue;
-        }
-      }
+  return false;
+}
 
-      // Check transaction visibility
-      if (transaction_manager.IsVisible(current_txn, tile_group_header,
-                                        tuple_id) == VisibilityType::OK) {
-        // If the tuple is visible, then perform predicate evaluation.
-        if (predicate_ == nullptr) {
-          position_list.push_back(tuple_id);
-        } else {
-          expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                               tuple_id);
-          auto eval =
-              predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-          if (eval == true) {
-            position_list.push_back(tuple_id);
-          }
-        }
-      } else {
-        expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                             tuple_id);
-        auto eval =
-            predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-        if (eval == true) {
-          position_list.push_back(tuple_id);
-          auto res = transaction_manager.PerformRead(current_txn, location,
-                                                     acquire_owner);
-          if (!res) {
-            transaction_manager.SetTransactionResult(current_txn,
-                                                     ResultType::FAILURE);
-            return res;
-          }
-        }
-      }
-    }
+bool HybridScanExecutor::ScanTileGroup(
+    const std::shared_ptr<storage::TileGroup> &tile_group) {
+  // Skip tile groups in which no tuple can satisfy the predicate
+  if (predicate_ != nullptr &&
+      tile_group->GetZoneMap()->CanSatisfy(predicate_, executor_context_) ==
+          false) {
+    LOG_TRACE("Skipping tile group %u", tile_group->GetTileGroupId());
+    return false;
+  }
 
-    // Don't return empty tiles
-    if (position_list.size() == 0) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+
+  // Check the visibility of the whole tile group at once
+  oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+  std::vector<oid_t> visible_tuples(active_tuple_count);
+  oid_t visible_tuple_count = transaction_manager.GetVisibleTuples(
+      current_txn, tile_group->GetHeader(), 0, active_tuple_count,
+      visible_tuples.data());
+
+  // Evaluate the predicate for all visible tuples at once
+  if (predicate_ != nullptr) {
+    vectorized_predicate_->Evaluate(tile_group.get(), visible_tuples.data(),
+                                    visible_tuple_count, nullptr,
+                                    executor_context_, predicate_results_);
+  }
+
+  std::vector<oid_t> position_list;
+  for (oid_t visible_idx = 0; visible_idx < visible_tuple_count;
+       visible_idx++) {
+    if (predicate_ != nullptr &&
+        predicate_results_[visible_idx] != type::CMP_TRUE) {
       continue;
     }
 
-    // Construct logical tile.
-    std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-    logical_tile->AddColumns(tile_group, column_ids_);
-    logical_tile->AddPositionList(std::move(position_list));
-
-    LOG_TRACE("Hybrid executor, Seq Scan :: Got a logical tile");
-    SetOutput(logical_tile.release());
+    oid_t tuple_id = visible_tuples[visible_idx];
+    ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+    position_list.push_back(tuple_id);
+    auto res =
+        transaction_manager.PerformRead(current_txn, location, acquire_owner);
+    if (!res) {
+      transaction_manager.SetTransactionResult(current_txn,
+                                               ResultType::FAILURE);
+      return res;
+    }
+  }
+  scanned_tuple_count_ += visible_tuple_count;
+  matched_tuple_count_ += position_list.size();
 
-    return true;
+  // Don't return empty tiles
+  if (position_list.size() == 0) {
+    return false;
   }
 
-  return false;
+  // Construct logical tile.
+  std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+  logical_tile->AddColumns(tile_group, column_ids_);
+  logical_tile->AddPositionList(std::move(position_list));
+
+  LOG_TRACE("Hybrid executor, Seq Scan :: Got a logical tile");
+  SetOutput(logical_tile.release());
+  return true;
 }
 
 bool HybridScanExecutor::IndexScanUtil() {
@@ -311,21 +312,15 @@ bool HybridScanExecutor::DExecute() {
   else if (type_ == HybridScanType::HYBRID) {
     LOG_TRACE("Hybrid Scan");
 
-    // do two part search
-    if (index_done_ == false) {
-      if (indexed_tile_offset_ == INVALID_OID) {
-        index_done_ = true;
-      } else {
-        ExecPrimaryIndexLookup();
-        LOG_TRACE("Using index -- tile count : %lu", result_.size());
-      }
-    }
-
-    if (IndexScanUtil() == true) {
+    // The tile groups the index does not cover yet
+    if (SeqScanUtil() == true) {
       return true;
     }
-    // Scan seq
-    return SeqScanUtil();
+    if (executor_context_->GetTransaction()->GetResult() ==
+        ResultType::FAILURE) {
+      return false;
+    }
+    return HybridScanUtil();
   }
   // FALLBACK
   else {
@@ -372,62 +367,18 @@ bool HybridScanExecutor::ExecPrimaryIndexLookup() {
 
   // for every tuple that is found in the index.
   for (auto tuple_location_ptr : tuple_location_ptrs) {
-    ItemPointer tuple_location = *tuple_location_ptr;
-
-    if (type_ == HybridScanType::HYBRID &&
-        tuple_location.block >= (block_threshold)) {
-      item_pointers_.insert(tuple_location);
+    ItemPointer tuple_location = GetVisibleVersion(tuple_location_ptr);
+    if (tuple_location.IsNull()) {
+      continue;
     }
 
-    auto &manager = catalog::Manager::GetInstance();
-    auto tile_group = manager.GetTileGroup(tuple_location.block);
-    auto tile_group_header = tile_group.get()->GetHeader();
-
-    // perform transaction read
-    size_t chain_length = 0;
-    while (true) {
-      ++chain_length;
-
-      auto visibility = transaction_manager.IsVisible(
-          current_txn, tile_group_header, tuple_location.offset);
-
-      if (visibility == VisibilityType::OK) {
-        visible_tuples[tuple_location.block].push_back(tuple_location.offset);
-        auto res = transaction_manager.PerformRead(current_txn, tuple_location,
-                                                   acquire_owner);
-        if (!res) {
-          transaction_manager.SetTransactionResult(current_txn,
-                                                   ResultType::FAILURE);
-          return res;
-        }
-        break;
-      } else {
-        ItemPointer old_item = tuple_location;
-        cid_t old_end_cid = tile_group_header->GetEndCommitId(old_item.offset);
-
-        tuple_location = tile_group_header->GetNextItemPointer(old_item.offset);
-        // there must exist a visible version.
-        assert(tuple_location.IsNull() == false);
-
-        cid_t max_committed_cid = transaction_manager.GetExpiredCid();
-
-        // check whether older version is garbage.
-        if (old_end_cid < max_committed_cid) {
-          assert(tile_group_header->GetTransactionId(old_item.offset) ==
-                     INITIAL_TXN_ID ||
-                 tile_group_header->GetTransactionId(old_item.offset) ==
-                     INVALID_TXN_ID);
-
-          if (tile_group_header->SetAtomicTransactionId(
-                  old_item.offset, INVALID_TXN_ID) == true) {
-            // atomically swap item pointer held in the index bucket.
-            AtomicUpdateItemPointer(tuple_location_ptr, tuple_location);
-          }
-        }
-
-        tile_group = manager.GetTileGroup(tuple_location.block);
-        tile_group_header = tile_group.get()->GetHeader();
-      }
+    visible_tuples[tuple_location.block].push_back(tuple_location.offset);
+    auto res = transaction_manager.PerformRead(current_txn, tuple_location,
+                                               acquire_owner);
+    if (!res) {
+      transaction_manager.SetTransactionResult(current_txn,
+                                               ResultType::FAILURE);
+      return res;
     }
   }
 
@@ -456,5 +407,175 @@ bool HybridScanExecutor::ExecPrimaryIndexLookup() {
   return true;
 }
 
+ItemPointer HybridScanExecutor::GetVisibleVersion(
+    ItemPointer *tuple_location_ptr) {
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  auto &manager = catalog::Manager::GetInstance();
+
+  ItemPointer tuple_location = *tuple_location_ptr;
+  auto tile_group = manager.GetTileGroup(tuple_location.block);
+  auto tile_group_header = tile_group.get()->GetHeader();
+
+  // perform transaction read
+  while (true) {
+    auto visibility = transaction_manager.IsVisible(
+        current_txn, tile_group_header, tuple_location.offset);
+
+    if (visibility == VisibilityType::OK) {
+      // the versions behind one that every transaction sees are garbage
+      transaction_manager.PruneVersionChain(tile_group_header,
+                                            tuple_location.offset);
+      return tuple_location;
+    }
+
+    ItemPointer old_item = tuple_location;
+    cid_t old_end_cid = tile_group_header->GetEndCommitId(old_item.offset);
+
+    tuple_location = tile_group_header->GetNextItemPointer(old_item.offset);
+    // the tuple was deleted before the transaction began
+    if (tuple_location.IsNull()) {
+      return tuple_location;
+    }
+
+    cid_t max_committed_cid = transaction_manager.GetExpiredCid();
+
+    // check whether older version is garbage.
+    if (old_end_cid < max_committed_cid) {
+      assert(tile_group_header->GetTransactionId(old_item.offset) ==
+                 INITIAL_TXN_ID ||
+             tile_group_header->GetTransactionId(old_item.offset) ==
+                 INVALID_TXN_ID);
+
+      if (tile_group_header->SetAtomicTransactionId(
+              old_item.offset, INVALID_TXN_ID) == true) {
+        // atomically swap item pointer held in the index bucket.
+        AtomicUpdateItemPointer(tuple_location_ptr, tuple_location);
+      }
+    }
+
+    tile_group = manager.GetTileGroup(tuple_location.block);
+    tile_group_header = tile_group.get()->GetHeader();
+  }
+}
+
+bool HybridScanExecutor::PreferIndex() {
+  // Without keys the lookup would scan the whole index
+  if (GetPlanNode<planner::HybridScanPlan>().GetKeyColumnIds().empty()) {
+    return false;
+  }
+
+  // Trust the index until enough tuples were scanned
+  if (scanned_tuple_count_ < kMinFeedbackTuples) {
+    return true;
+  }
+  return matched_tuple_count_ <=
+         kMaxIndexSelectivity * static_cast<double>(scanned_tuple_count_);
+}
+
+bool HybridScanExecutor::HybridScanUtil() {
+  while (indexed_tile_group_itr_ < indexed_tile_group_count_) {
+    auto tile_group = table_->GetTileGroup(indexed_tile_group_itr_++);
+
+    // Skip tile groups dropped by the compactor
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    // Switch to the index once the predicate proves selective. Its single
+    // lookup serves all indexed tile groups left.
+    if (index_done_ == false && PreferIndex() == true) {
+      HybridExecPrimaryIndexLookup();
+      LOG_TRACE("Using index for tile groups from %u",
+                indexed_tile_group_itr_ - 1);
+    }
+
+    bool found = index_done_ == true ? ServeIndexedTileGroup(tile_group)
+                                     : ScanTileGroup(tile_group);
+    if (found == true) {
+      return true;
+    }
+    if (executor_context_->GetTransaction()->GetResult() ==
+        ResultType::FAILURE) {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+void HybridScanExecutor::HybridExecPrimaryIndexLookup() {
+  PL_ASSERT(index_done_ == false);
+
+  const planner::HybridScanPlan &node = GetPlanNode<planner::HybridScanPlan>();
+  std::vector<ItemPointer *> tuple_location_ptrs;
+  index_->Scan(values_, node.GetKeyColumnIds(), node.GetExprTypes(),
+               ScanDirectionType::FORWARD, tuple_location_ptrs,
+               &node.GetIndexPredicate().GetConjunctionList()[0]);
+  LOG_TRACE("Result tuple count: %lu", tuple_location_ptrs.size());
+
+  // The version of an entry may be in a tile group that is scanned
+  // sequentially, then the scan returns it instead
+  for (auto tuple_location_ptr : tuple_location_ptrs) {
+    ItemPointer tuple_location = GetVisibleVersion(tuple_location_ptr);
+    if (tuple_location.IsNull() == false) {
+      index_tuples_[tuple_location.block].push_back(tuple_location.offset);
+    }
+  }
+
+  index_done_ = true;
+}
+
+bool HybridScanExecutor::ServeIndexedTileGroup(
+    const std::shared_ptr<storage::TileGroup> &tile_group) {
+  auto entry = index_tuples_.find(tile_group->GetTileGroupId());
+  if (entry == index_tuples_.end()) {
+    return false;
+  }
+  std::vector<oid_t> tuple_ids = std::move(entry->second);
+  index_tuples_.erase(entry);
+
+  // The index only checked its keys, the rest of the predicate is evaluated
+  // for all tuples of the tile group at once
+  if (predicate_ != nullptr) {
+    vectorized_predicate_->Evaluate(tile_group.get(), tuple_ids.data(),
+                                    tuple_ids.size(), nullptr,
+                                    executor_context_, predicate_results_);
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
+
+  std::vector<oid_t> position_list;
+  for (size_t idx = 0; idx < tuple_ids.size(); idx++) {
+    if (predicate_ != nullptr && predicate_results_[idx] != type::CMP_TRUE) {
+      continue;
+    }
+
+    ItemPointer location(tile_group->GetTileGroupId(), tuple_ids[idx]);
+    position_list.push_back(tuple_ids[idx]);
+    auto res =
+        transaction_manager.PerformRead(current_txn, location, acquire_owner);
+    if (!res) {
+      transaction_manager.SetTransactionResult(current_txn,
+                                               ResultType::FAILURE);
+      return res;
+    }
+  }
+
+  if (position_list.size() == 0) {
+    return false;
+  }
+
+  std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+  logical_tile->AddColumns(tile_group, column_ids_);
+  logical_tile->AddPositionList(std::move(position_list));
+  SetOutput(logical_tile.release());
+  return true;
+}
+
 }  // namespace executor
 }  // namespace peloton
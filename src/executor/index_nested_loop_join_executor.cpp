@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_nested_loop_join_executor.cpp
+//
+// Identification: src/executor/index_nested_loop_join_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/container_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "concurrency/transaction.h"
+#include "executor/executor_context.h"
+#include "executor/index_nested_loop_join_executor.h"
+#include "executor/index_scan_executor.h"
+#include "planner/index_nested_loop_join_plan.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief Constructor for index nested loop join executor.
+ * @param node Index nested loop join node corresponding to this executor.
+ */
+IndexNestedLoopJoinExecutor::IndexNestedLoopJoinExecutor(
+    const planner::AbstractPlan *node, ExecutorContext *executor_context)
+    : AbstractJoinExecutor(node, executor_context) {}
+
+/**
+ * @brief Do some basic checks and find the index scan of the right child.
+ * @return true on success, false otherwise.
+ */
+bool IndexNestedLoopJoinExecutor::DInit() {
+  auto status = AbstractJoinExecutor::DInit();
+  if (status == false) {
+    return status;
+  }
+
+  PL_ASSERT(join_type_ == JoinType::INNER);
+
+  index_scan_executor_ = dynamic_cast<IndexScanExecutor *>(children_[1]);
+  if (index_scan_executor_ == nullptr) {
+    throw ExecutorException(
+        "The right child of an index nested loop join must be an index scan");
+  }
+
+  left_tile_.reset();
+  left_tile_done_ = true;
+  key_rows_.clear();
+
+  // The right tuples are the batch, the left tuple is the same for all of them
+  vectorized_predicate_.reset();
+  if (predicate_ != nullptr) {
+    vectorized_predicate_.reset(
+        new expression::VectorizedPredicate(predicate_, 1));
+  }
+
+  return true;
+}
+
+/**
+ * @brief Creates logical tiles from the right tiles the index scan finds for
+ * the keys of a left tile, and the left tuples with those keys.
+ * @return true on success, false otherwise.
+ */
+bool IndexNestedLoopJoinExecutor::DExecute() {
+  LOG_TRACE("********** Index Nested Loop %s Join executor :: 2 children ",
+            GetJoinTypeString());
+
+  for (;;) {
+    // Join the next right tile with the left tuples of its key
+    if (left_tile_done_ == false) {
+      if (index_scan_executor_->Execute() == true) {
+        std::unique_ptr<LogicalTile> right_tile(
+            index_scan_executor_->GetOutput());
+        const std::vector<oid_t> &left_rows =
+            key_rows_[index_scan_executor_->GetKeyIndex()];
+
+        auto output_tile =
+            BuildOutputLogicalTile(left_tile_.get(), right_tile.get());
+        LogicalTile::PositionListsBuilder pos_lists_builder(left_tile_.get(),
+                                                            right_tile.get());
+
+        std::vector<oid_t> right_tuple_ids(right_tile->begin(),
+                                           right_tile->end());
+        for (auto left_row : left_rows) {
+          expression::ContainerTuple<LogicalTile> left_tuple(left_tile_.get(),
+                                                             left_row);
+
+          // Evaluate the join predicate for the whole right tile
+          if (predicate_ != nullptr) {
+            vectorized_predicate_->Evaluate(
+                right_tile.get(), right_tuple_ids.data(),
+                right_tuple_ids.size(), &left_tuple, executor_context_,
+                predicate_results_);
+          }
+
+          for (size_t right_idx = 0; right_idx < right_tuple_ids.size();
+               right_idx++) {
+            // Join predicate is false. Skip pair and continue.
+            if (predicate_ != nullptr &&
+                predicate_results_[right_idx] == type::CMP_FALSE) {
+              continue;
+            }
+            pos_lists_builder.AddRow(left_row, right_tuple_ids[right_idx]);
+          }
+        }
+
+        LOG_TRACE("pos_lists_builder's size : %ld", pos_lists_builder.Size());
+        if (pos_lists_builder.Size() > 0) {
+          output_tile->SetPositionListsAndVisibility(
+              pos_lists_builder.Release());
+          SetOutput(output_tile.release());
+          return true;
+        }
+        continue;
+      }
+
+      // The index scan fails the transaction if it could not read a tuple
+      if (executor_context_->GetTransaction()->GetResult() ==
+          ResultType::FAILURE) {
+        return false;
+      }
+      LOG_TRACE("Every key of the left tile is joined");
+      left_tile_done_ = true;
+    }
+
+    // Left child is finished, no more tiles
+    if (children_[0]->Execute() == false) {
+      LOG_TRACE("Left child is exhausted.");
+      return false;
+    }
+
+    LOG_TRACE("Retrieve a new tile from left child");
+    left_tile_.reset(children_[0]->GetOutput());
+    LookupLeftTile();
+  }
+}
+
+void IndexNestedLoopJoinExecutor::LookupLeftTile() {
+  const planner::IndexNestedLoopJoinPlan &node =
+      GetPlanNode<planner::IndexNestedLoopJoinPlan>();
+  const std::vector<oid_t> &join_column_ids_left = node.GetJoinColumnsLeft();
+
+  // The position in the batch of every distinct key
+  std::unordered_map<expression::ContainerTuple<LogicalTile>, size_t,
+                     expression::ContainerTupleHasher<LogicalTile>,
+                     expression::ContainerTupleComparator<LogicalTile>>
+      key_positions;
+  std::vector<std::vector<type::Value>> key_batch;
+  key_rows_.clear();
+
+  for (auto left_row : *left_tile_) {
+    expression::ContainerTuple<LogicalTile> left_key(
+        left_tile_.get(), left_row, &join_column_ids_left);
+
+    // A NULL key equals no key of the right side
+    bool has_null = false;
+    for (auto column_id : join_column_ids_left) {
+      if (left_key.GetValue(column_id).IsNull()) {
+        has_null = true;
+        break;
+      }
+    }
+    if (has_null == true) {
+      continue;
+    }
+
+    auto entry = key_positions.emplace(left_key, key_batch.size());
+    if (entry.second == true) {
+      std::vector<type::Value> key_values;
+      for (auto column_id : join_column_ids_left) {
+        key_values.push_back(left_key.GetValue(column_id));
+      }
+      key_batch.push_back(std::move(key_values));
+      key_rows_.emplace_back();
+    }
+    key_rows_[entry.first->second].push_back(left_row);
+  }
+
+  LOG_TRACE("Looking up %lu keys of %lu left tuples", key_batch.size(),
+            left_tile_->GetTupleCount());
+  left_tile_done_ = key_batch.empty();
+  if (left_tile_done_ == false) {
+    index_scan_executor_->ResetState();
+    index_scan_executor_->SetKeyBatch(node.GetJoinColumnsRight(),
+                                      std::move(key_batch));
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
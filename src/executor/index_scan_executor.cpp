@@ -12,6 +12,7 @@
 
 #include "executor/index_scan_executor.h"
 
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <utility>
@@ -25,13 +26,16 @@
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
 #include "expression/abstract_expression.h"
+#include "expression/tuple_value_expression.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
 #include "planner/index_scan_plan.h"
 #include "storage/data_table.h"
 #include "storage/masked_tuple.h"
+#include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
+#include "storage/tuple.h"
 #include "type/types.h"
 #include "type/value.h"
 
@@ -88,6 +92,7 @@ bool IndexScanExecutor::DInit() {
   limit_number_ = node.GetLimitNumber();
   limit_offset_ = node.GetLimitOffset();
   descend_ = node.GetDescend();
+  key_ordered_ = node.IsKeyOrdered();
 
   if (runtime_keys_.size() != 0) {
     PL_ASSERT(runtime_keys_.size() == values_.size());
@@ -113,6 +118,14 @@ bool IndexScanExecutor::DInit() {
     std::iota(full_column_ids_.begin(), full_column_ids_.end(), 0);
   }
 
+  // The tuples read from the index only come last
+  index_only_ = key_ordered_ == false && IsIndexOnlyScan();
+
+  key_batch_column_ids_.clear();
+  key_batch_.clear();
+  key_batch_locations_.clear();
+  result_keys_.clear();
+
   return true;
 }
 
@@ -124,7 +137,10 @@ bool IndexScanExecutor::DExecute() {
   LOG_TRACE("Index Scan executor :: 0 child");
 
   if (!done_) {
-    if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+    if (key_batch_.empty() == false) {
+      auto status = ExecKeyBatchLookup();
+      if (status == false) return false;
+    } else if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
       auto status = ExecPrimaryIndexLookup();
       if (status == false) return false;
     } else {
@@ -156,39 +172,37 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
 
   std::vector<ItemPointer *> tuple_location_ptrs;
 
+  // the keys of the tuple locations, if the scan is index-only
+  std::vector<type::Value> key_value_list;
+
   // Grab info from plan node
   bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
 
   PL_ASSERT(index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY);
 
-  if (0 == key_column_ids_.size()) {
+  if (limit_ || descend_) {
+    ScanInKeyOrder(tuple_location_ptrs);
+  } else if (0 == key_column_ids_.size()) {
     index_->ScanAllKeys(tuple_location_ptrs);
   } else {
-    // Limit clause accelerate
-    if (limit_) {
-      // invoke index scan limit
-      if (!descend_) {
-        LOG_TRACE("ASCENDING SCAN LIMIT in Primary Index");
-        index_->ScanLimit(values_, key_column_ids_, expr_types_,
-                          ScanDirectionType::FORWARD, tuple_location_ptrs,
-                          &index_predicate_.GetConjunctionList()[0],
-                          limit_number_, limit_offset_);
-      } else {
-        LOG_TRACE("DESCENDING SCAN LIMIT in Primary Index");
-        index_->ScanLimit(values_, key_column_ids_, expr_types_,
-                          ScanDirectionType::BACKWARD, tuple_location_ptrs,
-                          &index_predicate_.GetConjunctionList()[0],
-                          limit_number_, limit_offset_);
-
-        LOG_TRACE("1-Result size is %lu", result_.size());
-      }
+    // The key was looked up together with the others of its batch
+    if (key_batch_locations_.empty() == false) {
+      tuple_location_ptrs = std::move(key_batch_locations_[key_batch_itr_]);
     }
     // Normal SQL (without limit)
     else {
       LOG_TRACE("Index Scan in Primary Index");
-      index_->Scan(values_, key_column_ids_, expr_types_,
-                   ScanDirectionType::FORWARD, tuple_location_ptrs,
-                   &index_predicate_.GetConjunctionList()[0]);
+      if (index_only_ == true) {
+        // the index may not be able to give back its keys
+        index_only_ = index_->ScanWithKeys(
+            values_, key_column_ids_, expr_types_, tuple_location_ptrs,
+            key_value_list, &index_predicate_.GetConjunctionList()[0]);
+      }
+      if (index_only_ == false) {
+        index_->Scan(values_, key_column_ids_, expr_types_,
+                     ScanDirectionType::FORWARD, tuple_location_ptrs,
+                     &index_predicate_.GetConjunctionList()[0]);
+      }
     }
 
     LOG_TRACE("tuple_location_ptrs:%lu", tuple_location_ptrs.size());
@@ -205,23 +219,59 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   auto current_txn = executor_context_->GetTransaction();
   auto &manager = catalog::Manager::GetInstance();
   std::vector<ItemPointer> visible_tuple_locations;
-  std::map<oid_t, std::vector<oid_t>> visible_tuples;
+
+  // the keys of the tuples that are read from the index only
+  std::vector<size_t> index_only_rows;
+  std::vector<type::Value> key_tuple_values(full_column_ids_.size());
+  expression::ContainerTuple<std::vector<type::Value>> key_tuple(
+      &key_tuple_values);
 
 #ifdef LOG_TRACE_ENABLED
   int num_tuples_examined = 0;
 #endif
 
   // for every tuple that is found in the index.
-  for (auto tuple_location_ptr : tuple_location_ptrs) {
-    ItemPointer tuple_location = *tuple_location_ptr;
-    auto tile_group = manager.GetTileGroup(tuple_location.block);
-    auto tile_group_header = tile_group.get()->GetHeader();
+  for (size_t row_id = 0; row_id < tuple_location_ptrs.size(); row_id++) {
+    ItemPointer tuple_location = *tuple_location_ptrs[row_id];
+    auto tile_group = manager.ResolveTileGroup(tuple_location.block);
+    auto tile_group_header = tile_group->GetHeader();
     size_t chain_length = 0;
 
 #ifdef LOG_TRACE_ENABLED
     num_tuples_examined++;
 #endif
 
+    // every version of a frozen tile group is committed, live and visible to
+    // the transactions that started after it was frozen. the key of a
+    // primary key index is the key of the latest version, so the tuple is
+    // read from the index key.
+    if (index_only_ == true && tile_group_header->IsFrozen() &&
+        tile_group_header->GetFrozenCommitId() <= current_txn->GetReadId()) {
+      SetKeyValues(key_value_list, row_id, key_tuple_values);
+
+      if (predicate_ != nullptr &&
+          predicate_->Evaluate(&key_tuple, nullptr, executor_context_)
+                  .IsTrue() == false) {
+        continue;
+      }
+
+      if ((left_open_ || right_open_) &&
+          CheckKeyConditions(key_tuple) == false) {
+        continue;
+      }
+
+      auto res = transaction_manager.PerformRead(current_txn, tuple_location,
+                                                 acquire_owner);
+      if (!res) {
+        transaction_manager.SetTransactionResult(current_txn,
+                                                 ResultType::FAILURE);
+        return res;
+      }
+
+      index_only_rows.push_back(row_id);
+      continue;
+    }
+
     // the following code traverses the version chain until a certain visible
     // version is found.
     // we should always find a visible version from a version chain.
@@ -242,12 +292,16 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
         LOG_TRACE("perform read: %u, %u", tuple_location.block,
                   tuple_location.offset);
 
+        // the versions behind one that every transaction sees are garbage
+        transaction_manager.PruneVersionChain(tile_group_header,
+                                              tuple_location.offset);
+
         bool eval = true;
         // if having predicate, then perform evaluation.
         if (predicate_ != nullptr) {
           LOG_TRACE("perform predicate evaluate");
           expression::ContainerTuple<storage::TileGroup> tuple(
-              tile_group.get(), tuple_location.offset);
+              tile_group, tuple_location.offset);
           eval =
               predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
         }
@@ -289,8 +343,8 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
           // from scratch.
           tuple_location =
               *(tile_group_header->GetIndirection(tuple_location.offset));
-          tile_group = manager.GetTileGroup(tuple_location.block);
-          tile_group_header = tile_group.get()->GetHeader();
+          tile_group = manager.ResolveTileGroup(tuple_location.block);
+          tile_group_header = tile_group->GetHeader();
           chain_length = 0;
           continue;
         }
@@ -314,8 +368,8 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
         }
 
         // search for next version.
-        tile_group = manager.GetTileGroup(tuple_location.block);
-        tile_group_header = tile_group.get()->GetHeader();
+        tile_group = manager.ResolveTileGroup(tuple_location.block);
+        tile_group_header = tile_group->GetHeader();
         continue;
       }
     }
@@ -326,6 +380,13 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
             index_->GetName().c_str());
 #endif
 
+  // some of the keys that were scanned for the limit were not visible
+  if (IsLimitShort(tuple_location_ptrs.size(),
+                   visible_tuple_locations.size() + index_only_rows.size())) {
+    limit_number_ *= 2;
+    return ExecPrimaryIndexLookup();
+  }
+
   LOG_TRACE("%ld tuples before pruning boundaries",
             visible_tuple_locations.size());
 
@@ -335,34 +396,108 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
   LOG_TRACE("%ld tuples after pruning boundaries",
             visible_tuple_locations.size());
 
-  for (auto &visible_tuple_location : visible_tuple_locations) {
-    visible_tuples[visible_tuple_location.block]
-        .push_back(visible_tuple_location.offset);
+  BuildResultTiles(visible_tuple_locations);
+
+  if (index_only_rows.size() != 0) {
+    LOG_TRACE("%lu tuples read from the index only", index_only_rows.size());
+    result_.push_back(BuildIndexOnlyTile(key_value_list, index_only_rows));
   }
 
-  // Construct a logical tile for each block
-  for (auto tuples : visible_tuples) {
-    auto &manager = catalog::Manager::GetInstance();
-    auto tile_group = manager.GetTileGroup(tuples.first);
+  done_ = true;
 
-    std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-    // Add relevant columns to logical tile
-    logical_tile->AddColumns(tile_group, full_column_ids_);
-    logical_tile->AddPositionList(std::move(tuples.second));
-    if (column_ids_.size() != 0) {
-      logical_tile->ProjectColumns(full_column_ids_, column_ids_);
-    }
+  LOG_TRACE("Result tiles : %lu", result_.size());
 
-    result_.push_back(logical_tile.release());
+  return true;
+}
+
+bool IndexScanExecutor::IsIndexOnlyScan() {
+  // the key of a secondary index may belong to an older version of the tuple
+  if (table_ == nullptr ||
+      index_->GetIndexType() != IndexConstraintType::PRIMARY_KEY) {
+    return false;
   }
 
-  done_ = true;
+  // the index keys are only returned by plain scans of a key range
+  if (GetPlanNode<planner::AbstractScan>().IsForUpdate() || limit_ ||
+      key_column_ids_.size() == 0) {
+    return false;
+  }
 
-  LOG_TRACE("Result tiles : %lu", result_.size());
+  const std::vector<oid_t> &tuple_to_index =
+      index_->GetMetadata()->GetTupleToIndexMapping();
+
+  const std::vector<oid_t> &output_column_ids =
+      (column_ids_.size() != 0 ? column_ids_ : full_column_ids_);
+  for (auto column_id : output_column_ids) {
+    if (tuple_to_index[column_id] == INVALID_OID) {
+      return false;
+    }
+  }
+
+  // so is every column of the predicate
+  std::vector<const expression::AbstractExpression *> exprs;
+  if (predicate_ != nullptr) {
+    exprs.push_back(predicate_);
+  }
+  while (exprs.size() != 0) {
+    auto expr = exprs.back();
+    exprs.pop_back();
+
+    if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+      auto tuple_value_expr =
+          static_cast<const expression::TupleValueExpression *>(expr);
+      oid_t column_id = tuple_value_expr->GetColumnId();
+      if (tuple_value_expr->GetTupleId() != 0 ||
+          column_id >= tuple_to_index.size() ||
+          tuple_to_index[column_id] == INVALID_OID) {
+        return false;
+      }
+    }
+
+    for (size_t i = 0; i < expr->GetChildrenSize(); i++) {
+      exprs.push_back(expr->GetChild(i));
+    }
+  }
 
   return true;
 }
 
+void IndexScanExecutor::SetKeyValues(
+    const std::vector<type::Value> &key_value_list, size_t row_id,
+    std::vector<type::Value> &tuple_values) const {
+  const std::vector<oid_t> &key_attrs = index_->GetMetadata()->GetKeyAttrs();
+  size_t key_column_count = key_attrs.size();
+
+  for (size_t i = 0; i < key_column_count; i++) {
+    tuple_values[key_attrs[i]] = key_value_list[row_id * key_column_count + i];
+  }
+}
+
+LogicalTile *IndexScanExecutor::BuildIndexOnlyTile(
+    const std::vector<type::Value> &key_value_list,
+    const std::vector<size_t> &rows) const {
+  const std::vector<oid_t> &output_column_ids =
+      (column_ids_.size() != 0 ? column_ids_ : full_column_ids_);
+  std::unique_ptr<catalog::Schema> output_schema(
+      catalog::Schema::CopySchema(table_->GetSchema(), output_column_ids));
+
+  std::shared_ptr<storage::Tile> dest_tile(
+      storage::TileFactory::GetTempTile(*output_schema, rows.size()));
+
+  std::vector<type::Value> tuple_values(full_column_ids_.size());
+  for (oid_t tuple_id = 0; tuple_id < rows.size(); tuple_id++) {
+    SetKeyValues(key_value_list, rows[tuple_id], tuple_values);
+
+    for (oid_t column_id = 0; column_id < output_column_ids.size();
+         column_id++) {
+      dest_tile->SetValue(tuple_values[output_column_ids[column_id]],
+                          tuple_id, column_id);
+    }
+  }
+
+  return LogicalTileFactory::WrapTiles({dest_tile});
+}
+
 bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   LOG_TRACE("ExecSecondaryIndexLookup");
   PL_ASSERT(!done_);
@@ -373,29 +508,14 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   // Grab info from plan node
   bool acquire_owner = GetPlanNode<planner::AbstractScan>().IsForUpdate();
 
-  if (0 == key_column_ids_.size()) {
+  if (limit_ || descend_) {
+    ScanInKeyOrder(tuple_location_ptrs);
+  } else if (0 == key_column_ids_.size()) {
     index_->ScanAllKeys(tuple_location_ptrs);
   } else {
-    // Limit clause accelerate
-    if (limit_) {
-      // invoke index scan limit
-      if (!descend_) {
-        LOG_TRACE("ASCENDING SCAN LIMIT in Secondary Index");
-        index_->ScanLimit(values_, key_column_ids_, expr_types_,
-                          ScanDirectionType::FORWARD, tuple_location_ptrs,
-                          &index_predicate_.GetConjunctionList()[0],
-                          limit_number_, limit_offset_);
-      } else {
-        LOG_TRACE("DESCENDING SCAN LIMIT in Secondary Index");
-        index_->ScanLimit(values_, key_column_ids_, expr_types_,
-                          ScanDirectionType::BACKWARD, tuple_location_ptrs,
-                          &index_predicate_.GetConjunctionList()[0],
-                          limit_number_, limit_offset_);
-
-        if (tuple_location_ptrs.size() == 0) {
-          LOG_TRACE("2-Result size is %lu", tuple_location_ptrs.size());
-        }
-      }
+    // The key was looked up together with the others of its batch
+    if (key_batch_locations_.empty() == false) {
+      tuple_location_ptrs = std::move(key_batch_locations_[key_batch_itr_]);
     }
     // Normal SQL (without limit)
     else {
@@ -417,7 +537,6 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   auto current_txn = executor_context_->GetTransaction();
 
   std::vector<ItemPointer> visible_tuple_locations;
-  std::map<oid_t, std::vector<oid_t>> visible_tuples;
   auto &manager = catalog::Manager::GetInstance();
 
   // Quickie Hack
@@ -426,7 +545,7 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   // we got for each tuple and check whether its the same to avoid having
   // to go back to the catalog each time.
   oid_t last_block = INVALID_OID;
-  std::shared_ptr<storage::TileGroup> tile_group;
+  storage::TileGroup *tile_group = nullptr;
   storage::TileGroupHeader *tile_group_header = nullptr;
 
 #ifdef LOG_TRACE_ENABLED
@@ -437,8 +556,8 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
   for (auto tuple_location_ptr : tuple_location_ptrs) {
     ItemPointer tuple_location = *tuple_location_ptr;
     if (tuple_location.block != last_block) {
-      tile_group = manager.GetTileGroup(tuple_location.block);
-      tile_group_header = tile_group.get()->GetHeader();
+      tile_group = manager.ResolveTileGroup(tuple_location.block);
+      tile_group_header = tile_group->GetHeader();
     }
 #ifdef LOG_TRACE_ENABLED
     else
@@ -470,9 +589,13 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
         LOG_TRACE("perform read: %u, %u", tuple_location.block,
                   tuple_location.offset);
 
+        // the versions behind one that every transaction sees are garbage
+        transaction_manager.PruneVersionChain(tile_group_header,
+                                              tuple_location.offset);
+
         // Further check if the version has the secondary key
         expression::ContainerTuple<storage::TileGroup> candidate_tuple(
-            tile_group.get(), tuple_location.offset);
+            tile_group, tuple_location.offset);
 
         LOG_TRACE("candidate_tuple size: %s",
                   candidate_tuple.GetInfo().c_str());
@@ -535,8 +658,8 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
           // from scratch.
           tuple_location =
               *(tile_group_header->GetIndirection(tuple_location.offset));
-          tile_group = manager.GetTileGroup(tuple_location.block);
-          tile_group_header = tile_group.get()->GetHeader();
+          tile_group = manager.ResolveTileGroup(tuple_location.block);
+          tile_group_header = tile_group->GetHeader();
           chain_length = 0;
           continue;
         }
@@ -564,8 +687,8 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
         }
 
         // search for next version.
-        tile_group = manager.GetTileGroup(tuple_location.block);
-        tile_group_header = tile_group.get()->GetHeader();
+        tile_group = manager.ResolveTileGroup(tuple_location.block);
+        tile_group_header = tile_group->GetHeader();
       }
     }
     LOG_TRACE("Traverse length: %d\n", (int)chain_length);
@@ -575,35 +698,94 @@ bool IndexScanExecutor::ExecSecondaryIndexLookup() {
             num_tuples_examined, index_->GetName().c_str(), num_blocks_reused);
 #endif
 
+  // some of the keys that were scanned for the limit were not visible
+  if (IsLimitShort(tuple_location_ptrs.size(),
+                   visible_tuple_locations.size())) {
+    limit_number_ *= 2;
+    return ExecSecondaryIndexLookup();
+  }
+
   // Check whether the boundaries satisfy the required condition
   CheckOpenRangeWithReturnedTuples(visible_tuple_locations);
 
-  for (auto &visible_tuple_location : visible_tuple_locations) {
-    visible_tuples[visible_tuple_location.block]
-        .push_back(visible_tuple_location.offset);
-  }
+  BuildResultTiles(visible_tuple_locations);
 
-  // Construct a logical tile for each block
-  for (auto tuples : visible_tuples) {
-    auto &manager = catalog::Manager::GetInstance();
-    auto tile_group = manager.GetTileGroup(tuples.first);
+  done_ = true;
+
+  LOG_TRACE("Result tiles : %lu", result_.size());
+
+  return true;
+}
+
+void IndexScanExecutor::ScanInKeyOrder(
+    std::vector<ItemPointer *> &tuple_location_ptrs) {
+  auto direction =
+      descend_ ? ScanDirectionType::BACKWARD : ScanDirectionType::FORWARD;
+  uint64_t limit_number = limit_ ? static_cast<uint64_t>(limit_number_)
+                                 : std::numeric_limits<uint64_t>::max();
+  uint64_t limit_offset = limit_ ? static_cast<uint64_t>(limit_offset_) : 0;
+  LOG_TRACE("%s scan in %s, limit %lu",
+            descend_ ? "Descending" : "Ascending", index_->GetName().c_str(),
+            limit_number);
+  index_->ScanLimit(values_, key_column_ids_, expr_types_, direction,
+                    tuple_location_ptrs,
+                    &index_predicate_.GetConjunctionList()[0], limit_number,
+                    limit_offset);
+}
+
+bool IndexScanExecutor::IsLimitShort(size_t found_count,
+                                     size_t visible_count) const {
+  return limit_ == true && visible_count < found_count &&
+         found_count >= static_cast<size_t>(limit_number_);
+}
+
+void IndexScanExecutor::BuildResultTiles(
+    const std::vector<ItemPointer> &tuple_locations) {
+  auto &manager = catalog::Manager::GetInstance();
+  auto add_tile = [&](oid_t block, std::vector<oid_t> &&tuple_ids) {
+    auto tile_group = manager.GetTileGroup(block);
 
     std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
     // Add relevant columns to logical tile
     logical_tile->AddColumns(tile_group, full_column_ids_);
-    logical_tile->AddPositionList(std::move(tuples.second));
+    logical_tile->AddPositionList(std::move(tuple_ids));
     if (column_ids_.size() != 0) {
       logical_tile->ProjectColumns(full_column_ids_, column_ids_);
     }
 
     result_.push_back(logical_tile.release());
+  };
+
+  // Every run of tuples of the same block makes a tile, to keep the key order
+  if (key_ordered_ == true) {
+    size_t run_start = 0;
+    for (size_t location_itr = 1; location_itr <= tuple_locations.size();
+         location_itr++) {
+      if (location_itr < tuple_locations.size() &&
+          tuple_locations[location_itr].block ==
+              tuple_locations[run_start].block) {
+        continue;
+      }
+      std::vector<oid_t> tuple_ids;
+      for (size_t run_itr = run_start; run_itr < location_itr; run_itr++) {
+        tuple_ids.push_back(tuple_locations[run_itr].offset);
+      }
+      add_tile(tuple_locations[run_start].block, std::move(tuple_ids));
+      run_start = location_itr;
+    }
+    return;
   }
 
-  done_ = true;
-
-  LOG_TRACE("Result tiles : %lu", result_.size());
+  std::map<oid_t, std::vector<oid_t>> visible_tuples;
+  for (auto &visible_tuple_location : tuple_locations) {
+    visible_tuples[visible_tuple_location.block]
+        .push_back(visible_tuple_location.offset);
+  }
 
-  return true;
+  // Construct a logical tile for each block
+  for (auto &tuples : visible_tuples) {
+    add_tile(tuples.first, std::move(tuples.second));
+  }
 }
 
 void IndexScanExecutor::CheckOpenRangeWithReturnedTuples(
@@ -632,18 +814,22 @@ void IndexScanExecutor::CheckOpenRangeWithReturnedTuples(
 }
 
 bool IndexScanExecutor::CheckKeyConditions(const ItemPointer &tuple_location) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  auto tile_group = manager.ResolveTileGroup(tuple_location.block);
+  expression::ContainerTuple<storage::TileGroup> tuple(tile_group,
+                                                       tuple_location.offset);
+
+  return CheckKeyConditions(tuple);
+}
+
+bool IndexScanExecutor::CheckKeyConditions(const AbstractTuple &tuple) {
   // The size of these three arrays must be the same
   PL_ASSERT(key_column_ids_.size() == expr_types_.size());
   PL_ASSERT(expr_types_.size() == values_.size());
 
   LOG_TRACE("Examining key conditions for the returned tuple.");
 
-  auto &manager = catalog::Manager::GetInstance();
-
-  auto tile_group = manager.GetTileGroup(tuple_location.block);
-  expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                       tuple_location.offset);
-
   // This is the end of loop
   oid_t cond_num = key_column_ids_.size();
 
@@ -824,9 +1010,104 @@ void IndexScanExecutor::UpdatePredicate(
       .SetTupleColumnValue(index_.get(), key_column_ids, values);
 }
 
+// column_ids are output column ids, as for UpdatePredicate
+void IndexScanExecutor::SetKeyBatch(
+    const std::vector<oid_t> &column_ids,
+    std::vector<std::vector<type::Value>> &&key_batch) {
+  key_batch_column_ids_ = column_ids;
+  key_batch_ = std::move(key_batch);
+  key_batch_locations_.clear();
+
+  // The tuples of a batch are not read from the index keys
+  index_only_ = false;
+}
+
+bool IndexScanExecutor::ExecKeyBatchLookup() {
+  PL_ASSERT(!done_);
+  auto current_txn = executor_context_->GetTransaction();
+
+  // The first key sets up the key columns of the index predicate
+  UpdatePredicate(key_batch_column_ids_, key_batch_[0]);
+  ScanKeyBatch();
+
+  for (key_batch_itr_ = 0; key_batch_itr_ < key_batch_.size();
+       key_batch_itr_++) {
+    if (key_batch_locations_.empty() && key_batch_itr_ > 0) {
+      UpdatePredicate(key_batch_column_ids_, key_batch_[key_batch_itr_]);
+    }
+
+    // A lookup returns false when it found no tuple, and when a read failed,
+    // which ends the whole batch
+    bool status;
+    if (index_->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+      status = ExecPrimaryIndexLookup();
+    } else {
+      status = ExecSecondaryIndexLookup();
+    }
+    if (status == false && current_txn->GetResult() == ResultType::FAILURE) {
+      key_batch_locations_.clear();
+      return false;
+    }
+
+    result_keys_.resize(result_.size(), key_batch_itr_);
+    done_ = false;
+  }
+
+  key_batch_locations_.clear();
+  done_ = true;
+  return true;
+}
+
+// The keys of the batch are looked up all at once when they cover the whole
+// key of the index. Otherwise each of them is scanned for on its own, as a
+// prefix of the index key.
+void IndexScanExecutor::ScanKeyBatch() {
+  key_batch_locations_.clear();
+  if (limit_ == true) {
+    return;
+  }
+
+  // The position of every key column of the index in the keys of the batch
+  const std::vector<oid_t> &key_attrs = index_->GetMetadata()->GetKeyAttrs();
+  if (key_attrs.size() != key_batch_column_ids_.size()) {
+    return;
+  }
+  std::vector<size_t> key_positions;
+  for (auto key_attr : key_attrs) {
+    size_t position = 0;
+    while (position < key_batch_column_ids_.size() &&
+           column_ids_[key_batch_column_ids_[position]] != key_attr) {
+      position++;
+    }
+    if (position == key_batch_column_ids_.size()) {
+      return;
+    }
+    key_positions.push_back(position);
+  }
+
+  auto key_schema = index_->GetKeySchema();
+  auto pool = executor_context_->GetPool();
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<const storage::Tuple *> key_ptrs;
+  for (auto &key_values : key_batch_) {
+    keys.emplace_back(new storage::Tuple(key_schema, true));
+    for (oid_t key_column = 0; key_column < key_positions.size();
+         key_column++) {
+      keys.back()->SetValue(key_column, key_values[key_positions[key_column]],
+                            pool);
+    }
+    key_ptrs.push_back(keys.back().get());
+  }
+
+  index_->ScanKeys(key_ptrs, key_batch_locations_);
+  LOG_TRACE("Looked up %lu keys at once", key_ptrs.size());
+}
+
 void IndexScanExecutor::ResetState() {
   result_.clear();
 
+  result_keys_.clear();
+
   result_itr_ = START_OID;
 
   done_ = false;
@@ -42,6 +42,7 @@ bool InsertExecutor::DInit() {
   PL_ASSERT(executor_context_);
 
   done_ = false;
+  foreign_key_cache_.Clear();
   return true;
 }
 
@@ -90,8 +91,7 @@ bool InsertExecutor::DExecute() {
     auto target_table_schema = target_table->GetSchema();
     auto column_count = target_table_schema->GetColumnCount();
 
-    std::unique_ptr<storage::Tuple> tuple(
-        new storage::Tuple(target_table_schema, true));
+    auto tuple = GetTupleBuffer(target_table_schema);
 
     // Go over the logical tile
     for (oid_t tuple_id : *logical_tile) {
@@ -107,7 +107,8 @@ bool InsertExecutor::DExecute() {
       // insert tuple into the table.
       ItemPointer *index_entry_ptr = nullptr;
       peloton::ItemPointer location =
-          target_table->InsertTuple(tuple.get(), current_txn, &index_entry_ptr);
+          target_table->InsertTuple(tuple, current_txn, &index_entry_ptr,
+                                    &foreign_key_cache_);
 
       // it is possible that some concurrent transactions have inserted the same
       // tuple.
@@ -134,7 +135,6 @@ bool InsertExecutor::DExecute() {
     auto schema = target_table->GetSchema();
     auto project_info = node.GetProjectInfo();
     auto tuple = node.GetTuple(0);
-    std::unique_ptr<storage::Tuple> project_tuple;
 
     // Check if this is not a raw tuple
     if (tuple == nullptr) {
@@ -143,7 +143,7 @@ bool InsertExecutor::DExecute() {
       // There should be no direct maps
       PL_ASSERT(project_info->GetDirectMapList().size() == 0);
 
-      project_tuple.reset(new storage::Tuple(schema, true));
+      auto project_tuple = GetTupleBuffer(schema);
 
       for (auto target : project_info->GetTargetList()) {
         auto value =
@@ -152,7 +152,20 @@ bool InsertExecutor::DExecute() {
       }
 
       // Set tuple to point to temporary project tuple
-      tuple = project_tuple.get();
+      tuple = project_tuple;
+    }
+
+    // Probe the distinct referenced keys of all the tuples at once. A missing
+    // key is reported by the insert of its tuple.
+    if (!project_info && bulk_insert_count > 1 &&
+        target_table->HasForeignKeys()) {
+      std::vector<const storage::Tuple *> tuples;
+      tuples.reserve(bulk_insert_count);
+      for (oid_t insert_itr = 0; insert_itr < bulk_insert_count;
+           insert_itr++) {
+        tuples.push_back(node.GetTuple(insert_itr));
+      }
+      target_table->CheckForeignKeyConstraints(tuples, &foreign_key_cache_);
     }
 
     // Bulk Insert Mode
@@ -164,13 +177,16 @@ bool InsertExecutor::DExecute() {
       // Carry out insertion
       ItemPointer *index_entry_ptr = nullptr;
       ItemPointer location =
-          target_table->InsertTuple(tuple, current_txn, &index_entry_ptr);
+          target_table->InsertTuple(tuple, current_txn, &index_entry_ptr,
+                                    &foreign_key_cache_);
       LOG_TRACE("Inserted into location: %u, %u", location.block,
                 location.offset);
+#ifdef LOG_TRACE_ENABLED
       if (tuple->GetColumnCount() > 2) {
         type::Value val = (tuple->GetValue(2));
         LOG_TRACE("value: %s", val.GetInfo().c_str());
       }
+#endif
 
       if (location.block == INVALID_OID) {
         LOG_TRACE("Failed to Insert. Set txn failure.");
@@ -194,5 +210,12 @@ bool InsertExecutor::DExecute() {
   return true;
 }
 
+storage::Tuple *InsertExecutor::GetTupleBuffer(const catalog::Schema *schema) {
+  if (tuple_buffer_ == nullptr || tuple_buffer_->GetSchema() != schema) {
+    tuple_buffer_.reset(new storage::Tuple(schema, true));
+  }
+  return tuple_buffer_.get();
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -22,6 +22,7 @@
 #include "storage/tile_group.h"
 #include "type/value.h"
 #include "type/value_factory.h"
+#include "type/wire_format.h"
 
 namespace peloton {
 namespace executor {
@@ -450,11 +451,7 @@ std::vector<std::vector<std::string>> LogicalTile::GetAllValuesAsStrings(
         val = cp.base_tile->GetValue(base_tuple_id, cp.origin_column_id);
       }
 
-      // LM: I put varchar here because we don't need to do endian conversion
-      // for them, and assuming binary and text for a varchar are the same.
-      if (result_format[column_itr] == 0 ||
-          cp.base_tile->GetSchema()->GetType(cp.origin_column_id) ==
-              type::TypeId::VARCHAR) {
+      if (result_format[column_itr] == type::WireFormat::kTextFormat) {
         // don't let to_string function decide what NULL value is
         if (use_to_string_null == false && val.IsNull() == true) {
           // materialize Null values as 0B string
@@ -464,23 +461,10 @@ std::vector<std::vector<std::string>> LogicalTile::GetAllValuesAsStrings(
           row.push_back(val.ToString());
         }
       } else {
-        auto data_length =
-            cp.base_tile->GetSchema()->GetLength(cp.origin_column_id);
-        LOG_TRACE("data length: %ld", data_length);
-        char *val_binary = new char[data_length];
-        bool is_inlined = false;
-
-        val.SerializeTo(val_binary, is_inlined, nullptr);
-
-        // convert little endian to big endian...
-        // TODO: This is stupid.... But I think this hack is fine for now.
-        for (size_t i = 0; i < (data_length >> 1); ++i) {
-          auto tmp_char = val_binary[i];
-          val_binary[i] = val_binary[data_length - i - 1];
-          val_binary[data_length - i - 1] = tmp_char;
-        }
-
-        row.push_back(std::string(val_binary, data_length));
+        // NULL values are empty in binary format as well
+        std::vector<unsigned char> bytes;
+        type::WireFormat::Encode(val, result_format[column_itr], bytes);
+        row.push_back(std::string(bytes.begin(), bytes.end()));
       }
     }
     string_tile.push_back(row);
@@ -554,24 +538,33 @@ void LogicalTile::MaterializeByTiles(
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
     const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
     storage::Tile *dest_tile) {
-  bool row_wise_materialization = true;
-
-  if (peloton_layout_mode == LAYOUT_TYPE_COLUMN)
-    row_wise_materialization = false;
-
-  // TODO: Make this a parameter
-  auto dest_tile_column_count = dest_tile->GetColumnCount();
-  oid_t column_count_threshold = 20;
-  if (peloton_layout_mode == LAYOUT_TYPE_HYBRID &&
-      dest_tile_column_count <= column_count_threshold)
-    row_wise_materialization = false;
+  // Pick the materialization of each base tile by its layout
+  std::unordered_map<storage::Tile *, std::vector<oid_t>> row_wise_cols;
+  std::unordered_map<storage::Tile *, std::vector<oid_t>> column_wise_cols;
+  for (const auto &kv : tile_to_cols) {
+    if (IsColumnWiseMaterialization(kv.first, kv.second.size())) {
+      column_wise_cols.insert(kv);
+    } else {
+      row_wise_cols.insert(kv);
+    }
+  }
 
   // Materialize as needed
-  if (row_wise_materialization == true) {
-    MaterializeRowAtAtATime(old_to_new_cols, tile_to_cols, dest_tile);
-  } else {
-    MaterializeColumnAtATime(old_to_new_cols, tile_to_cols, dest_tile);
+  if (!row_wise_cols.empty()) {
+    MaterializeRowAtAtATime(old_to_new_cols, row_wise_cols, dest_tile);
+  }
+  if (!column_wise_cols.empty()) {
+    MaterializeColumnAtATime(old_to_new_cols, column_wise_cols, dest_tile);
+  }
+}
+
+bool LogicalTile::IsColumnWiseMaterialization(const storage::Tile *base_tile,
+                                              size_t column_count) {
+  // A row of a single column is a column
+  if (column_count <= 1) {
+    return true;
   }
+  return 2 * column_count < base_tile->GetColumnCount();
 }
 
 void LogicalTile::MaterializeRowAtAtATime(
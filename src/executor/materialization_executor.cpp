@@ -99,23 +99,24 @@ void MaterializationExecutor::MaterializeByTiles(
     const std::unordered_map<oid_t, oid_t> &old_to_new_cols,
     const std::unordered_map<storage::Tile *, std::vector<oid_t>> &tile_to_cols,
     storage::Tile *dest_tile) {
-  bool row_wise_materialization = true;
-
-  if (peloton_layout_mode == LAYOUT_TYPE_COLUMN) row_wise_materialization = false;
-
-  // TODO: Make this a parameter
-  auto dest_tile_column_count = dest_tile->GetColumnCount();
-  oid_t column_count_threshold = 20;
-  if (peloton_layout_mode == LAYOUT_TYPE_HYBRID &&
-      dest_tile_column_count <= column_count_threshold)
-    row_wise_materialization = false;
+  // Pick the materialization of each base tile by its layout
+  std::unordered_map<storage::Tile *, std::vector<oid_t>> row_wise_cols;
+  std::unordered_map<storage::Tile *, std::vector<oid_t>> column_wise_cols;
+  for (const auto &kv : tile_to_cols) {
+    if (LogicalTile::IsColumnWiseMaterialization(kv.first, kv.second.size())) {
+      column_wise_cols.insert(kv);
+    } else {
+      row_wise_cols.insert(kv);
+    }
+  }
 
   // Materialize as needed
-  if (row_wise_materialization == true) {
-    MaterializeRowAtAtATime(source_tile, old_to_new_cols, tile_to_cols,
+  if (!row_wise_cols.empty()) {
+    MaterializeRowAtAtATime(source_tile, old_to_new_cols, row_wise_cols,
                             dest_tile);
-  } else {
-    MaterializeColumnAtATime(source_tile, old_to_new_cols, tile_to_cols,
+  }
+  if (!column_wise_cols.empty()) {
+    MaterializeColumnAtATime(source_tile, old_to_new_cols, column_wise_cols,
                              dest_tile);
   }
 }
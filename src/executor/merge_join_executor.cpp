@@ -11,21 +11,90 @@
 //===----------------------------------------------------------------------===//
 
 
+#include "executor/merge_join_executor.h"
+
+#include <algorithm>
+#include <exception>
+#include <map>
+#include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 
-#include "type/types.h"
+#include "common/container_tuple.h"
 #include "common/logger.h"
+#include "configuration/configuration.h"
 #include "executor/logical_tile_factory.h"
-#include "executor/merge_join_executor.h"
 #include "expression/abstract_expression.h"
-#include "common/container_tuple.h"
+#include "type/types.h"
 
 namespace peloton {
 namespace executor {
 
+// The tuples of one side in the order of their keys
+struct MergeJoinExecutor::SortedSide {
+  struct Row {
+    // The buffered tile of the tuple
+    oid_t tile_idx;
+    oid_t tuple_id;
+
+    // The offset of the key in keys
+    size_t key_offset;
+  };
+
+  std::vector<Row> rows;
+
+  // The values of the join clauses of every row
+  std::vector<type::Value> keys;
+
+  const type::Value *GetKey(size_t row) const {
+    return &keys[rows[row].key_offset];
+  }
+};
+
+namespace {
+
+// Compare two keys, where NULLs are greater than all other values. Keys with
+// NULLs must not be matched even if they compare equal.
+int CompareKeys(const type::Value *left, const type::Value *right,
+                size_t key_count) {
+  for (size_t key_itr = 0; key_itr < key_count; key_itr++) {
+    bool left_null = left[key_itr].IsNull();
+    bool right_null = right[key_itr].IsNull();
+    if (left_null || right_null) {
+      if (left_null != right_null) {
+        return left_null ? 1 : -1;
+      }
+      continue;
+    }
+    if (left[key_itr].CompareLessThan(right[key_itr]) == type::CMP_TRUE) {
+      return -1;
+    }
+    if (left[key_itr].CompareGreaterThan(right[key_itr]) == type::CMP_TRUE) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+bool HasNull(const type::Value *key, size_t key_count) {
+  for (size_t key_itr = 0; key_itr < key_count; key_itr++) {
+    if (key[key_itr].IsNull()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The joined tuples of a range, by the pair of left and right tiles
+typedef std::map<std::pair<oid_t, oid_t>, LogicalTile::PositionListsBuilder>
+    RangeOutput;
+
+}  // namespace
+
 /**
- * @brief Constructor for nested loop join executor.
- * @param node Nested loop join node corresponding to this executor.
+ * @brief Constructor for merge join executor.
+ * @param node Merge join node corresponding to this executor.
  */
 MergeJoinExecutor::MergeJoinExecutor(const planner::AbstractPlan *node,
                                      ExecutorContext *executor_context)
@@ -43,6 +112,10 @@ bool MergeJoinExecutor::DInit() {
 
   if (join_clauses_ == nullptr) return false;
 
+  output_tiles_.clear();
+  output_itr_ = 0;
+  merged_ = false;
+
   return true;
 }
 
@@ -52,237 +125,243 @@ bool MergeJoinExecutor::DInit() {
  * @return true on success, false otherwise.
  */
 bool MergeJoinExecutor::DExecute() {
-  LOG_TRACE(
-      "********** Merge Join executor :: 2 children "
-      "left:: start: %lu, end: %lu, done: %d "
-      "right:: start: %lu, end: %lu, done: %d",
-      left_start_row, left_end_row, left_child_done_, right_start_row,
-      right_end_row, right_child_done_);
-
-  // Build outer join output when done
-  if (right_child_done_ && left_child_done_) {
-    return BuildOuterJoinOutput();
-  }
+  LOG_TRACE("********** Merge Join executor :: 2 children ");
+
+  if (merged_ == false) {
+    merged_ = true;
 
-  //===--------------------------------------------------------------------===//
-  // Pick right and left tiles
-  //===--------------------------------------------------------------------===//
-
-  // Try to get next tile from RIGHT child
-  if (((right_child_done_ == false) && (right_start_row == right_end_row)) ||
-      (left_child_done_ == true)) {
-    if (children_[1]->Execute() == false) {
-      LOG_TRACE("Did not get right tile ");
-      right_child_done_ = true;
-      // Try again
-      return DExecute();
+    // An empty side needs the other one only for an outer join of it
+    right_child_done_ = !ReadChild(1);
+    left_child_done_ = !ReadChild(0);
+    if (right_child_done_ &&
+        (join_type_ == JoinType::INNER || join_type_ == JoinType::RIGHT)) {
+      return false;
+    }
+    if (left_child_done_ &&
+        (join_type_ == JoinType::INNER || join_type_ == JoinType::LEFT)) {
+      return false;
     }
 
-    LOG_TRACE("Got right tile ");
+    while (!right_child_done_) {
+      right_child_done_ = !ReadChild(1);
+    }
+    while (!left_child_done_) {
+      left_child_done_ = !ReadChild(0);
+    }
+    Merge();
+  }
 
-    auto right_tile = children_[1]->GetOutput();
-    BufferRightTile(right_tile);
+  if (output_itr_ < output_tiles_.size()) {
+    SetOutput(output_tiles_[output_itr_++].release());
+    return true;
+  }
+  return BuildOuterJoinOutput();
+}
 
-    right_start_row = 0;
-    right_end_row = Advance(right_tile, right_start_row, false);
-    LOG_TRACE("size of right tiles: %lu", right_result_tiles_.size());
+bool MergeJoinExecutor::ReadChild(size_t child_idx) {
+  if (children_[child_idx]->Execute() == false) {
+    return false;
+  }
+  auto tile = children_[child_idx]->GetOutput();
+  if (child_idx == 0) {
+    BufferLeftTile(tile);
+  } else {
+    BufferRightTile(tile);
   }
+  return true;
+}
 
-  // Try to get next tile from LEFT child
-  if (((left_child_done_ == false) && (left_start_row == left_end_row)) ||
-      (right_child_done_ == true)) {
-    if (children_[0]->Execute() == false) {
-      LOG_TRACE("Did not get left tile ");
-      left_child_done_ = true;
-      // if we know the join type is left join, we don't have to get the
-      // tiles from right child anymore.
-      if (join_type_ == JoinType::LEFT || join_type_ == JoinType::INNER) {
-        return BuildOuterJoinOutput();
-      } else {
-        // otherwise, try again
-        return DExecute();
+void MergeJoinExecutor::SortSide(bool is_left, SortedSide &side) {
+  const size_t key_count = join_clauses_->size();
+  auto &tiles = is_left ? left_result_tiles_ : right_result_tiles_;
+
+  for (oid_t tile_idx = 0; tile_idx < tiles.size(); tile_idx++) {
+    LogicalTile *tile = tiles[tile_idx].get();
+    for (auto tuple_id : *tile) {
+      expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+      side.rows.push_back({tile_idx, tuple_id, side.keys.size()});
+      for (auto &clause : *join_clauses_) {
+        auto expr = is_left ? clause.left_.get() : clause.right_.get();
+        side.keys.push_back(expr->Evaluate(&tuple, &tuple, executor_context_));
       }
-
-      // Try again
-      return DExecute();
     }
-
-    LOG_TRACE("Got left tile ");
-
-    auto left_tile = children_[0]->GetOutput();
-    BufferLeftTile(left_tile);
-
-    left_start_row = 0;
-    left_end_row = Advance(left_tile, left_start_row, true);
-    LOG_TRACE("size of left tiles: %lu", left_result_tiles_.size());
   }
 
-  // Check if we have logical tiles to process
-  if (left_result_tiles_.empty() || right_result_tiles_.empty()) {
-    return BuildOuterJoinOutput();
+  // The tuples of a key ordered index scan need no sort
+  auto less = [&side, key_count](const SortedSide::Row &left,
+                                 const SortedSide::Row &right) {
+    return CompareKeys(&side.keys[left.key_offset],
+                       &side.keys[right.key_offset], key_count) < 0;
+  };
+  if (std::is_sorted(side.rows.begin(), side.rows.end(), less) == false) {
+    LOG_TRACE("Sorting %lu %s tuples", side.rows.size(),
+              is_left ? "left" : "right");
+    std::sort(side.rows.begin(), side.rows.end(), less);
   }
+}
 
-  LogicalTile *left_tile = left_result_tiles_.back().get();
-  LogicalTile *right_tile = right_result_tiles_.back().get();
-
-  //===--------------------------------------------------------------------===//
-  // Build Join Tile
-  //===--------------------------------------------------------------------===//
-
-  // Build output logical tile
-  auto output_tile = BuildOutputLogicalTile(left_tile, right_tile);
-
-  // Build position lists
-  LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
-
-  while ((left_end_row > left_start_row) && (right_end_row > right_start_row)) {
-    expression::ContainerTuple<executor::LogicalTile> left_tuple(
-        left_tile, left_start_row);
-    expression::ContainerTuple<executor::LogicalTile> right_tuple(
-        right_tile, right_start_row);
-    bool not_matching_tuple_pair = false;
-
-    // Evaluate and compare the join clauses
-    for (auto &clause : *join_clauses_) {
-      auto left_value =
-          clause.left_->Evaluate(&left_tuple, &right_tuple, nullptr);
-      auto right_value =
-          clause.right_->Evaluate(&left_tuple, &right_tuple, nullptr);
-
-      // Left key < Right key, advance left
-      if (left_value.CompareLessThan(right_value) == type::CMP_TRUE) {
-        LOG_TRACE("left < right, advance left ");
-        left_start_row = left_end_row;
-        left_end_row = Advance(left_tile, left_start_row, true);
-        not_matching_tuple_pair = true;
-        break;
-      }
-      // Left key > Right key, advance right
-      else if (left_value.CompareGreaterThan(right_value) == type::CMP_TRUE) {
-        LOG_TRACE("left > right, advance right ");
-        right_start_row = right_end_row;
-        right_end_row = Advance(right_tile, right_start_row, false);
-        not_matching_tuple_pair = true;
-        break;
-      }
-
-      // Left key == Right key, go and check next join clause
-    }
-
-    // At least one of the join clauses don't match
-    // One of the tile has been advanced
-    if (not_matching_tuple_pair) {
-      continue;
+void MergeJoinExecutor::Merge() {
+  const size_t key_count = join_clauses_->size();
+  SortedSide left, right;
+  SortSide(true, left);
+  SortSide(false, right);
+  const size_t left_count = left.rows.size();
+  const size_t right_count = right.rows.size();
+
+  size_t thread_count = FLAGS_merge_join_threads;
+  if (thread_count == 0) {
+    thread_count = std::thread::hardware_concurrency();
+  }
+  thread_count = std::max<size_t>(
+      1, std::min(thread_count, left_count / kMinRowsPerThread));
+
+  // Cut the left tuples into ranges that do not split a key, and find the
+  // first right tuple that is not less than the first key of every range
+  std::vector<size_t> left_bounds(thread_count + 1, left_count);
+  std::vector<size_t> right_bounds(thread_count + 1, right_count);
+  left_bounds[0] = 0;
+  right_bounds[0] = 0;
+  for (size_t range = 1; range < thread_count; range++) {
+    size_t bound = std::max(left_bounds[range - 1], range * left_count /
+                                                        thread_count);
+    while (bound > 0 && bound < left_count &&
+           CompareKeys(left.GetKey(bound - 1), left.GetKey(bound),
+                       key_count) == 0) {
+      bound++;
     }
-
-    // Join clauses matched, try to match predicate
-    LOG_TRACE("one pair of tuples matches join clause ");
-
-    // Join predicate exists
-    if (predicate_ != nullptr) {
-      auto eval = predicate_->Evaluate(&left_tuple,
-                                      &right_tuple, executor_context_);
-      if (eval.IsFalse()) {
-      //if (predicate_->Evaluate(&left_tuple, &right_tuple, executor_context_)
-      //        .IsFalse()) {
-        // Join predicate is false. Advance both.
-        left_start_row = left_end_row;
-        left_end_row = Advance(left_tile, left_start_row, true);
-
-        right_start_row = right_end_row;
-        right_end_row = Advance(right_tile, right_start_row, false);
+    left_bounds[range] = bound;
+    if (bound < left_count) {
+      size_t low = right_bounds[range - 1], high = right_count;
+      while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (CompareKeys(right.GetKey(mid), left.GetKey(bound), key_count) <
+            0) {
+          low = mid + 1;
+        } else {
+          high = mid;
+        }
       }
+      right_bounds[range] = low;
     }
+  }
 
-    // Sub tile matched, do a Cartesian product
-    // Go over every pair of tuples in left and right logical tiles
-    for (size_t left_tile_row_itr = left_start_row;
-         left_tile_row_itr < left_end_row; left_tile_row_itr++) {
-      for (size_t right_tile_row_itr = right_start_row;
-           right_tile_row_itr < right_end_row; right_tile_row_itr++) {
-        // Insert a tuple into the output logical tile
-        pos_lists_builder.AddRow(left_tile_row_itr, right_tile_row_itr);
-
-        RecordMatchedLeftRow(left_result_tiles_.size() - 1, left_tile_row_itr);
-        RecordMatchedRightRow(right_result_tiles_.size() - 1,
-                              right_tile_row_itr);
+  // The matched rows of the ranges are disjoint, so every thread sets its own
+  std::vector<char> left_matched(left_count, 0);
+  std::vector<char> right_matched(right_count, 0);
+  std::vector<RangeOutput> outputs(thread_count);
+  std::vector<std::exception_ptr> errors(thread_count);
+
+  auto merge_range = [&](size_t range) {
+    try {
+      size_t left_row = left_bounds[range];
+      size_t right_row = right_bounds[range];
+      while (left_row < left_bounds[range + 1] &&
+             right_row < right_bounds[range + 1]) {
+        const type::Value *left_key = left.GetKey(left_row);
+        const type::Value *right_key = right.GetKey(right_row);
+        int cmp = CompareKeys(left_key, right_key, key_count);
+        if (cmp < 0 || (cmp == 0 && HasNull(left_key, key_count))) {
+          left_row++;
+          continue;
+        }
+        if (cmp > 0) {
+          right_row++;
+          continue;
+        }
+
+        // Join every pair of tuples with this key
+        size_t left_end = left_row + 1;
+        while (left_end < left_bounds[range + 1] &&
+               CompareKeys(left_key, left.GetKey(left_end), key_count) == 0) {
+          left_end++;
+        }
+        size_t right_end = right_row + 1;
+        while (right_end < right_bounds[range + 1] &&
+               CompareKeys(right_key, right.GetKey(right_end), key_count) ==
+                   0) {
+          right_end++;
+        }
+
+        for (size_t left_itr = left_row; left_itr < left_end; left_itr++) {
+          auto &left_info = left.rows[left_itr];
+          LogicalTile *left_tile = left_result_tiles_[left_info.tile_idx].get();
+          expression::ContainerTuple<LogicalTile> left_tuple(
+              left_tile, left_info.tuple_id);
+          for (size_t right_itr = right_row; right_itr < right_end;
+               right_itr++) {
+            auto &right_info = right.rows[right_itr];
+            LogicalTile *right_tile =
+                right_result_tiles_[right_info.tile_idx].get();
+            expression::ContainerTuple<LogicalTile> right_tuple(
+                right_tile, right_info.tuple_id);
+
+            // Join predicate is false. Skip pair and continue.
+            if (predicate_ != nullptr &&
+                predicate_->Evaluate(&left_tuple, &right_tuple,
+                                     executor_context_)
+                    .IsFalse()) {
+              continue;
+            }
+
+            auto builder =
+                outputs[range]
+                    .emplace(std::piecewise_construct,
+                             std::forward_as_tuple(left_info.tile_idx,
+                                                   right_info.tile_idx),
+                             std::forward_as_tuple(left_tile, right_tile))
+                    .first;
+            builder->second.AddRow(left_info.tuple_id, right_info.tuple_id);
+            left_matched[left_itr] = 1;
+            right_matched[right_itr] = 1;
+          }
+        }
+        left_row = left_end;
+        right_row = right_end;
       }
+    } catch (...) {
+      errors[range] = std::current_exception();
     }
+  };
 
-    // Then, advance both if necessary
-    right_start_row = right_end_row;
-    right_end_row = Advance(right_tile, right_start_row, false);
-
-    if (right_start_row != right_end_row) {
-      left_start_row = left_end_row;
-      left_end_row = Advance(left_tile, left_start_row, true);
-    }
+  std::vector<std::thread> threads;
+  for (size_t range = 1; range < thread_count; range++) {
+    threads.emplace_back(merge_range, range);
   }
-
-  // Check if we have any join tuples.
-  if (pos_lists_builder.Size() > 0) {
-    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
-    SetOutput(output_tile.release());
-    return true;
+  merge_range(0);
+  for (auto &thread : threads) {
+    thread.join();
   }
-  // Try again
-  else {
-    // If we are out of any more pairs of child tiles to examine,
-    // then we will return false earlier in this function
-    // So, no need to return false here
-    DExecute();
+  for (auto &error : errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
   }
-
-  return true;
-}
-
-/**
- * @brief Advance the row iterator until value changes in terms of the join
- * clauses
- * @return the end row number, [start_row, end_row) are the rows of the same
- * value
- *         if the end_row == start_row, the subset is empty
- */
-size_t MergeJoinExecutor::Advance(LogicalTile *tile, size_t start_row,
-                                  bool is_left) {
-  size_t end_row = start_row + 1;
-  size_t this_row = start_row;
-  size_t tuple_count = tile->GetTupleCount();
-  if (start_row >= tuple_count) return start_row;
-
-  while (end_row < tuple_count) {
-    expression::ContainerTuple<executor::LogicalTile> this_tuple(tile,
-                                                                 this_row);
-    expression::ContainerTuple<executor::LogicalTile> next_tuple(tile, end_row);
-
-    bool diff = false;
-
-    for (auto &clause : *join_clauses_) {
-      // Go through each join clauses
-      auto expr = is_left ? clause.left_.get() : clause.right_.get();
-      auto this_value =
-          expr->Evaluate(&this_tuple, &this_tuple, executor_context_);
-      auto next_value =
-          expr->Evaluate(&next_tuple, &next_tuple, executor_context_);
-
-      if (!(this_value.CompareEquals(next_value) == type::CMP_TRUE)) {
-        diff = true;
-        break;
-      }
+  LOG_TRACE("Merged %lu left and %lu right tuples on %lu threads", left_count,
+            right_count, thread_count);
+
+  // Build the output tiles in the order of the ranges
+  for (auto &output : outputs) {
+    for (auto &entry : output) {
+      auto output_tile =
+          BuildOutputLogicalTile(left_result_tiles_[entry.first.first].get(),
+                                 right_result_tiles_[entry.first.second].get());
+      output_tile->SetPositionListsAndVisibility(entry.second.Release());
+      output_tiles_.push_back(std::move(output_tile));
     }
+  }
 
-    if (diff) {
-      break;
+  for (size_t left_itr = 0; left_itr < left_count; left_itr++) {
+    if (left_matched[left_itr]) {
+      RecordMatchedLeftRow(left.rows[left_itr].tile_idx,
+                           left.rows[left_itr].tuple_id);
+    }
+  }
+  for (size_t right_itr = 0; right_itr < right_count; right_itr++) {
+    if (right_matched[right_itr]) {
+      RecordMatchedRightRow(right.rows[right_itr].tile_idx,
+                            right.rows[right_itr].tuple_id);
     }
-
-    // the two tuples are the same, we advance by 1
-    this_row = end_row;
-    end_row++;
   }
-
-  LOG_TRACE("Advanced %s with subset size %lu ", is_left ? "left" : "right",
-            end_row - start_row);
-  return end_row;
 }
 
 }  // namespace executor
@@ -53,6 +53,13 @@ bool NestedLoopJoinExecutor::DInit() {
 
   PL_ASSERT(left_result_tiles_.empty());
 
+  // The right tuples are the batch, the left tuple is the same for all of them
+  vectorized_predicate_.reset();
+  if (predicate_ != nullptr) {
+    vectorized_predicate_.reset(
+        new expression::VectorizedPredicate(predicate_, 1));
+  }
+
   return true;
 }
 
@@ -140,27 +147,29 @@ bool NestedLoopJoinExecutor::DExecute() {
         LogicalTile::PositionListsBuilder pos_lists_builder(left_tile_.get(),
                                                             right_tile.get());
 
+        // Evaluate the join predicate for the whole right tile
+        std::vector<oid_t> right_tuple_ids(right_tile->begin(),
+                                           right_tile->end());
+        if (predicate_ != nullptr) {
+          vectorized_predicate_->Evaluate(
+              right_tile.get(), right_tuple_ids.data(), right_tuple_ids.size(),
+              &left_tuple, executor_context_, predicate_results_);
+        }
+
         // Go over every pair of tuples in left and right logical tiles
-        for (auto right_tile_row_itr : *right_tile) {
+        for (size_t right_idx = 0; right_idx < right_tuple_ids.size();
+             right_idx++) {
+          // Join predicate is false. Skip pair and continue.
+          if (predicate_ != nullptr &&
+              predicate_results_[right_idx] == type::CMP_FALSE) {
+            LOG_TRACE("Not math join predicate");
+            continue;
+          }
+
           // Insert a tuple into the output logical tile
-          // First, copy the elements in left logical tile's tuple
           LOG_TRACE("Insert a tuple into the output logical tile");
-
-          expression::ContainerTuple<executor::LogicalTile> right_tuple(
-              right_tile.get(), right_tile_row_itr);
-
-          if (predicate_ != nullptr) {
-            auto eval = predicate_->Evaluate(&left_tuple, &right_tuple,
-                                             executor_context_);
-
-            // Join predicate is false. Skip pair and continue.
-            if (eval.IsFalse()) {
-              LOG_TRACE("Not math join predicate");
-              continue;
-            }
-            LOG_TRACE("Find a tuple with join predicate");
-          }
-          pos_lists_builder.AddRow(left_tile_row_itr_, right_tile_row_itr);
+          pos_lists_builder.AddRow(left_tile_row_itr_,
+                                   right_tuple_ids[right_idx]);
         }  // Outer loop of NLJ
 
         // Now current left tile is done
@@ -24,6 +24,37 @@
 namespace peloton {
 namespace executor {
 
+namespace {
+
+// Compare the values of a sort key. Negative if the first one comes first,
+// positive if the second one does.
+int CompareSortKey(const type::Value &va, const type::Value &vb,
+                   bool descend) {
+  if (va.CompareLessThan(vb) == type::CMP_TRUE) {
+    return descend ? 1 : -1;
+  }
+  if (va.CompareGreaterThan(vb) == type::CMP_TRUE) {
+    return descend ? -1 : 1;
+  }
+  return 0;
+}
+
+// Does the sort key tuple a come before b?
+// Note: This is a less-than comparer, NOT an equality comparer.
+bool SortKeysLess(const storage::Tuple &a, const storage::Tuple &b,
+                  const std::vector<bool> &descend_flags) {
+  for (oid_t id = 0; id < descend_flags.size(); id++) {
+    int cmp =
+        CompareSortKey(a.GetValue(id), b.GetValue(id), descend_flags[id]);
+    if (cmp != 0) {
+      return cmp < 0;
+    }
+  }
+  return false;  // Will return false if all keys equal
+}
+
+}  // namespace
+
 /**
  * @brief Constructor
  * @param node  OrderByNode plan node corresponding to this executor
@@ -32,13 +63,18 @@ OrderByExecutor::OrderByExecutor(const planner::AbstractPlan *node,
                                  ExecutorContext *executor_context)
     : AbstractExecutor(node, executor_context) {}
 
-OrderByExecutor::~OrderByExecutor() {}
+OrderByExecutor::~OrderByExecutor() {
+  if (reserved_memory_ > 0) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+  }
+}
 
 bool OrderByExecutor::DInit() {
   PL_ASSERT(children_.size() == 1);
 
   sort_done_ = false;
   num_tuples_returned_ = 0;
+  runs_.clear();
 
   // Grab info from plan node and check it
   const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
@@ -63,6 +99,10 @@ bool OrderByExecutor::DExecute() {
 
   if (!sort_done_) DoSort();
 
+  if (!runs_.empty()) {
+    return ExecuteMerge();
+  }
+
   if (!(num_tuples_returned_ < sort_buffer_.size())) {
     return false;
   }
@@ -114,12 +154,39 @@ bool OrderByExecutor::DoSort() {
   PL_ASSERT(!sort_done_);
   PL_ASSERT(executor_context_ != nullptr);
 
+  // Grab data from plan node
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  descend_flags_ = node.GetDescendFlags();
+
+  // With a limit, only the first offset + limit tuples are kept
+  bool top_n =
+      limit_ && !underling_ordered_ && limit_offset_ + limit_number_ > 0;
+
   // Extract all data from child
   while (children_[0]->Execute()) {
-    input_tiles_.emplace_back(children_[0]->GetOutput());
+    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+    if (tile->GetTupleCount() == 0) {
+      continue;
+    }
+    if (sort_key_tuple_schema_ == nullptr) {
+      InitSchemas(tile.get());
+    }
+
+    // Write the buffered tuples to a run if the tile exceeds the budget. A
+    // top-N sort stays within its bounds without runs.
+    if (!top_n && !ReserveTile(tile.get()) && !sort_buffer_.empty()) {
+      WriteRun();
+      ReserveTile(tile.get());
+    }
 
     // increase the counter
-    num_tuples_get_ += input_tiles_.back()->GetTupleCount();
+    num_tuples_get_ += tile->GetTupleCount();
+    input_tiles_.push_back(std::move(tile));
+    BufferTile();
+
+    if (top_n && sort_buffer_.size() >= 2 * (limit_offset_ + limit_number_)) {
+      PruneBuffer();
+    }
 
     // Optimization for ordered output
     if (underling_ordered_ && limit_) {
@@ -132,22 +199,49 @@ bool OrderByExecutor::DoSort() {
     }
   }
 
-  /** Number of valid tuples to be sorted. */
-  size_t count = 0;
-  for (auto &tile : input_tiles_) {
-    count += tile->GetTupleCount();
+  // The runs are merged on the fly, with the rest of the buffer as the last
+  // one
+  if (!runs_.empty()) {
+    if (!sort_buffer_.empty()) {
+      WriteRun();
+    }
+    LOG_DEBUG("Order by merges %lu sorted runs", (unsigned long)runs_.size());
+    InitMerge();
+    sort_done_ = true;
+    return true;
   }
 
+  /** Number of valid tuples to be sorted. */
+  size_t count = sort_buffer_.size();
+
   if (count == 0) return true;
 
-  // Grab data from plan node
+  // If the underlying result has the same order, it is not necessary to sort
+  // the result again. Instead, go to the end.
+  if (underling_ordered_) {
+    LOG_TRACE("underling_ordered works and already get all tuples (%lu)",
+              count);
+    sort_done_ = true;
+    return true;
+  }
+
+  // Finally ... sort it !
+  if (top_n) {
+    PruneBuffer();
+  }
+  SortBuffer();
+
+  sort_done_ = true;
+
+  return true;
+}
+
+void OrderByExecutor::InitSchemas(LogicalTile *tile) {
   const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
-  descend_flags_ = node.GetDescendFlags();
 
   // Extract the schema for sort keys.
-
   std::unique_ptr<catalog::Schema> physical_schema;
-  physical_schema.reset(input_tiles_[0]->GetPhysicalSchema());
+  physical_schema.reset(tile->GetPhysicalSchema());
   std::vector<catalog::Column> sort_key_columns;
   std::vector<catalog::Column> output_key_columns;
   for (auto id : node.GetSortKeys()) {
@@ -159,78 +253,197 @@ bool OrderByExecutor::DoSort() {
   output_column_ids_ = node.GetOutputColumnIds();
   sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
   output_schema_.reset(new catalog::Schema(output_key_columns));
+}
+
+bool OrderByExecutor::ReserveTile(LogicalTile *tile) {
+  // The sort key tuples and the position lists of the tile
+  size_t tile_size =
+      tile->GetTupleCount() *
+      (sizeof(sort_buffer_entry_t) + sizeof(storage::Tuple) +
+       sort_key_tuple_schema_->GetLength() +
+       tile->GetPositionLists().size() * sizeof(oid_t));
+  if (!executor_context_->ReserveMemory(tile_size)) {
+    return false;
+  }
+  reserved_memory_ += tile_size;
+  return true;
+}
+
+void OrderByExecutor::BufferTile() {
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
   auto executor_pool = executor_context_->GetPool();
 
   // Extract all valid tuples into a single std::vector (the sort buffer)
-  sort_buffer_.reserve(count);
+  oid_t tile_id = input_tiles_.size() - 1;
+  for (oid_t tuple_id : *input_tiles_[tile_id]) {
+    // Extract the sort key tuple
+    std::unique_ptr<storage::Tuple> tuple(
+        new storage::Tuple(sort_key_tuple_schema_.get(), true));
+    for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
+      type::Value val =
+          (input_tiles_[tile_id]->GetValue(tuple_id, node.GetSortKeys()[id]));
+      tuple->SetValue(id, val, executor_pool);
+    }
+    // Inert the sort key tuple into sort buffer
+    sort_buffer_.emplace_back(
+        sort_buffer_entry_t(ItemPointer(tile_id, tuple_id), std::move(tuple)));
+  }
+}
+
+void OrderByExecutor::SortBuffer() {
+  auto &descend_flags = descend_flags_;
+  std::sort(sort_buffer_.begin(), sort_buffer_.end(),
+            [&descend_flags](const sort_buffer_entry_t &a,
+                             const sort_buffer_entry_t &b) {
+              return SortKeysLess(*a.tuple, *b.tuple, descend_flags);
+            });
+}
+
+void OrderByExecutor::PruneBuffer() {
+  size_t num_kept = limit_offset_ + limit_number_;
+  if (sort_buffer_.size() <= num_kept) {
+    return;
+  }
+
+  auto &descend_flags = descend_flags_;
+  std::nth_element(sort_buffer_.begin(), sort_buffer_.begin() + num_kept,
+                   sort_buffer_.end(),
+                   [&descend_flags](const sort_buffer_entry_t &a,
+                                    const sort_buffer_entry_t &b) {
+                     return SortKeysLess(*a.tuple, *b.tuple, descend_flags);
+                   });
+  sort_buffer_.erase(sort_buffer_.begin() + num_kept, sort_buffer_.end());
+
+  // The tiles keep their ids, those without any kept tuple are released
+  std::vector<bool> referenced(input_tiles_.size(), false);
+  for (auto &entry : sort_buffer_) {
+    referenced[entry.item_pointer.block] = true;
+  }
   for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
-    for (oid_t tuple_id : *input_tiles_[tile_id]) {
-      // Extract the sort key tuple
-      std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(sort_key_tuple_schema_.get(), true));
-      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
-        type::Value val =
-            (input_tiles_[tile_id]->GetValue(tuple_id, node.GetSortKeys()[id]));
-        tuple->SetValue(id, val, executor_pool);
-      }
-      // Inert the sort key tuple into sort buffer
-      sort_buffer_.emplace_back(sort_buffer_entry_t(
-          ItemPointer(tile_id, tuple_id), std::move(tuple)));
+    if (!referenced[tile_id]) {
+      input_tiles_[tile_id].reset();
     }
   }
+}
 
-  PL_ASSERT(count == sort_buffer_.size());
+void OrderByExecutor::WriteRun() {
+  SortBuffer();
 
-  // If the underlying result has the same order, it is not necessary to sort
-  // the result again. Instead, go to the end.
-  if (underling_ordered_) {
-    LOG_TRACE("underling_ordered works and already get all tuples (%lu)",
-              count);
-    sort_done_ = true;
-    return true;
+  std::vector<type::TypeId> column_types;
+  for (oid_t id = 0; id < sort_key_tuple_schema_->GetColumnCount(); id++) {
+    column_types.push_back(sort_key_tuple_schema_->GetType(id));
+  }
+  for (oid_t id = 0; id < output_schema_->GetColumnCount(); id++) {
+    column_types.push_back(output_schema_->GetType(id));
   }
+  runs_.emplace_back(new SpillFile(column_types));
 
-  // Prepare the compare function
-  // Note: This is a less-than comparer, NOT an equality comparer.
-  struct TupleComparer {
-    TupleComparer(std::vector<bool> &_descend_flags)
-        : descend_flags(_descend_flags) {}
-
-    bool operator()(const storage::Tuple *ta, const storage::Tuple *tb) {
-      for (oid_t id = 0; id < descend_flags.size(); id++) {
-        type::Value va = (ta->GetValue(id));
-        type::Value vb = (tb->GetValue(id));
-        if (!descend_flags[id]) {
-          if (va.CompareLessThan(vb) == type::CMP_TRUE)
-            return true;
-          else {
-            if (va.CompareGreaterThan(vb) == type::CMP_TRUE) return false;
-          }
-        } else {
-          if (vb.CompareLessThan(va) == type::CMP_TRUE)
-            return true;
-          else {
-            if (vb.CompareGreaterThan(va) == type::CMP_TRUE) return false;
-          }
-        }
-      }
-      return false;  // Will return false if all keys equal
+  std::vector<type::Value> values;
+  for (auto &entry : sort_buffer_) {
+    values.clear();
+    for (oid_t id = 0; id < sort_key_tuple_schema_->GetColumnCount(); id++) {
+      values.push_back(entry.tuple->GetValue(id));
+    }
+    auto &tile = input_tiles_[entry.item_pointer.block];
+    for (auto column_id : output_column_ids_) {
+      values.push_back(tile->GetValue(entry.item_pointer.offset, column_id));
     }
+    runs_.back()->Append(values);
+  }
+  LOG_DEBUG("Order by writes a sorted run of %lu tuples",
+            (unsigned long)sort_buffer_.size());
+
+  sort_buffer_.clear();
+  input_tiles_.clear();
+  if (reserved_memory_ > 0) {
+    executor_context_->ReleaseMemory(reserved_memory_);
+    reserved_memory_ = 0;
+  }
+}
 
-    std::vector<bool> descend_flags;
-  };
+void OrderByExecutor::InitMerge() {
+  size_t num_runs = runs_.size();
+  run_heads_.assign(num_runs, std::vector<type::Value>());
+  for (size_t run = 0; run < num_runs; run++) {
+    runs_[run]->Rewind();
+    runs_[run]->Next(run_heads_[run]);
+  }
 
-  TupleComparer comp(descend_flags_);
+  // Every inner node starts with a run that beats all others, which the
+  // matches of the leaves push out
+  loser_tree_.assign(num_runs, num_runs);
+  for (size_t run = num_runs; run-- > 0;) {
+    AdjustLoserTree(run);
+  }
+}
 
-  // Finally ... sort it !
-  std::sort(
-      sort_buffer_.begin(), sort_buffer_.end(),
-      [&comp](const sort_buffer_entry_t &a, const sort_buffer_entry_t &b) {
-        return comp(a.tuple.get(), b.tuple.get());
-      });
+void OrderByExecutor::AdjustLoserTree(size_t run) {
+  size_t num_runs = runs_.size();
+  for (size_t node = (run + num_runs) / 2; node > 0; node /= 2) {
+    // The loser stays at the node, the winner goes on
+    if (RunBeats(loser_tree_[node], run)) {
+      std::swap(run, loser_tree_[node]);
+    }
+  }
+  loser_tree_[0] = run;
+}
 
-  sort_done_ = true;
+bool OrderByExecutor::RunBeats(size_t a, size_t b) const {
+  // The initial entry of the inner nodes beats every run
+  size_t num_runs = runs_.size();
+  if (a == num_runs) return true;
+  if (b == num_runs) return false;
+
+  // Done runs lose
+  if (run_heads_[a].empty()) return false;
+  if (run_heads_[b].empty()) return true;
+
+  for (oid_t id = 0; id < descend_flags_.size(); id++) {
+    int cmp = CompareSortKey(run_heads_[a][id], run_heads_[b][id],
+                             descend_flags_[id]);
+    if (cmp != 0) {
+      return cmp < 0;
+    }
+  }
 
+  // Ties go to the earlier run
+  return a < b;
+}
+
+bool OrderByExecutor::ExecuteMerge() {
+  size_t num_keys = sort_key_tuple_schema_->GetColumnCount();
+
+  // Take the next rows of the winning runs
+  std::vector<std::vector<type::Value>> rows;
+  while (rows.size() < size_t(DEFAULT_TUPLES_PER_TILEGROUP)) {
+    size_t run = loser_tree_[0];
+    if (run_heads_[run].empty()) {
+      break;
+    }
+    rows.push_back(std::move(run_heads_[run]));
+    run_heads_[run].clear();
+    if (!runs_[run]->Next(run_heads_[run])) {
+      run_heads_[run].clear();
+    }
+    AdjustLoserTree(run);
+  }
+
+  if (rows.empty()) {
+    return false;
+  }
+
+  std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
+      BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+      nullptr, *output_schema_, nullptr, rows.size()));
+  for (size_t id = 0; id < rows.size(); id++) {
+    for (oid_t i = 0; i < output_schema_->GetColumnCount(); i++) {
+      ptile->SetValue(rows[id][num_keys + i], id, i);
+    }
+  }
+
+  std::vector<std::shared_ptr<storage::Tile>> singleton({ptile});
+  SetOutput(LogicalTileFactory::WrapTiles(singleton));
+  num_tuples_returned_ += rows.size();
   return true;
 }
 
@@ -12,13 +12,22 @@
 
 #include "executor/plan_executor.h"
 
+#include "codegen/background_compiler.h"
 #include "codegen/buffering_consumer.h"
+#include "codegen/query_cache.h"
+#include "codegen/query_parameters.h"
 #include "codegen/query_compiler.h"
 #include "codegen/query.h"
 #include "common/logger.h"
+#include "configuration/configuration.h"
 #include "executor/executor_context.h"
 #include "executor/executors.h"
+#include "index/index.h"
 #include "optimizer/util.h"
+#include "planner/copy_plan.h"
+#include "planner/index_scan_plan.h"
+#include "statistics/backend_stats_context.h"
+#include "storage/data_table.h"
 #include "storage/tuple_iterator.h"
 
 namespace peloton {
@@ -36,6 +45,48 @@ executor::AbstractExecutor *BuildExecutorTree(
 
 void CleanExecutorTree(executor::AbstractExecutor *root);
 
+/*
+ * Record the compilation and execution of a compiled query in the stats of
+ * the ongoing query, and log them if the query was slow. Queries found in the
+ * query cache took no time to compile.
+ */
+static void RecordCompiledQuery(
+    const planner::AbstractPlan &plan, codegen::Query &query,
+    const codegen::QueryCompiler::CompileStats &compile_stats,
+    const codegen::Query::RuntimeStats &runtime_stats,
+    const codegen::QueryParameters *parameters) {
+  stats::QueryMetric::CodegenInfo codegen_info;
+  codegen_info.compiled = true;
+  codegen_info.compile_ms = compile_stats.TotalTime();
+  codegen_info.execute_ms = runtime_stats.init_ms + runtime_stats.plan_ms +
+                            runtime_stats.tear_down_ms;
+  codegen_info.num_instructions =
+      query.GetCodeContext().GetInstructionCount();
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->RecordQueryCodegen(
+        codegen_info);
+  }
+
+  double total_ms = codegen_info.compile_ms + codegen_info.execute_ms;
+  if (FLAGS_codegen_slow_query_ms > 0 &&
+      total_ms >= FLAGS_codegen_slow_query_ms) {
+    uint64_t plan_hash = parameters != nullptr
+                             ? parameters->GetPlanHash()
+                             : codegen::QueryParameters{plan}.GetPlanHash();
+    LOG_INFO(
+        "Slow compiled query, plan %llu: compile %.2f ms (setup %.2f, IR %.2f, "
+        "optimize %.2f, JIT %.2f), init %.2f ms, plan %.2f ms, tear down "
+        "%.2f ms, %llu functions, %llu instructions",
+        (unsigned long long)plan_hash, codegen_info.compile_ms,
+        compile_stats.setup_ms, compile_stats.ir_gen_ms, compile_stats.opt_ms,
+        compile_stats.jit_ms, runtime_stats.init_ms, runtime_stats.plan_ms,
+        runtime_stats.tear_down_ms,
+        (unsigned long long)query.GetCodeContext().GetFunctionCount(),
+        (unsigned long long)codegen_info.num_instructions);
+  }
+}
+
 /**
  * @brief Build a executor tree and execute it.
  * Use std::vector<type::Value> as params to make it more elegant for
@@ -49,7 +100,8 @@ ExecuteResult PlanExecutor::ExecutePlan(
     concurrency::Transaction *txn,
     const std::vector<type::Value> &params,
     std::vector<StatementResult> &result,
-    const std::vector<int> &result_format) {
+    const std::vector<int> &result_format, const ResultCallback *callback,
+    ExecutorProfile *profile) {
   ExecuteResult p_status;
   if (plan == nullptr) return p_status;
 
@@ -65,8 +117,43 @@ ExecuteResult PlanExecutor::ExecutePlan(
   // network
   std::unique_ptr<executor::ExecutorContext> executor_context(
         BuildExecutorContext(params, txn));
+  if (profile != nullptr) {
+    executor_context->SetProfiling(true);
+  }
+
+  // With the query cache, the query compiled for a plan of the same shape is
+  // executed with the constants of this plan
+  bool compiled = FLAGS_codegen && codegen::QueryCompiler::IsSupported(*plan);
+  std::unique_ptr<codegen::QueryParameters> parameters;
+  std::shared_ptr<codegen::CachedQuery> cached_query;
+
+  // A short plan runs on the executors before it would be compiled
+  bool short_plan = compiled && FLAGS_codegen_min_rows > 0 &&
+                    EstimateProcessedRows(*plan) < FLAGS_codegen_min_rows;
+  if (compiled && FLAGS_codegen_query_cache_size > 0) {
+    parameters.reset(new codegen::QueryParameters(*plan));
+    cached_query =
+        codegen::QueryCache::GetInstance().Find(parameters->GetSignature());
+
+    auto &background_compiler = codegen::BackgroundCompiler::GetInstance();
+    if (FLAGS_codegen_background_compile && cached_query != nullptr) {
+      background_compiler.CountExecution(cached_query);
+    } else if (short_plan) {
+      compiled = false;
+    } else if (FLAGS_codegen_background_compile) {
+      // Run the plan on the executors until its query is compiled. The
+      // binding completes the plan before the executors read it, the one of
+      // the compilation then only rewrites attribute references.
+      planner::BindingContext context;
+      plan->PerformBinding(context);
+      background_compiler.Compile(plan, parameters->GetSignature(), false);
+      compiled = false;
+    }
+  } else if (short_plan) {
+    compiled = false;
+  }
 
-  if (!FLAGS_codegen || !codegen::QueryCompiler::IsSupported(*plan)) {
+  if (compiled == false) {
     // Build the executor tree
     LOG_TRACE("Building the executor tree");
     std::unique_ptr<executor::AbstractExecutor> executor_tree(
@@ -107,6 +194,13 @@ ExecuteResult PlanExecutor::ExecutePlan(
               result.push_back(std::move(res));
             }
           }
+
+          // Hand over the rows so far once there is a chunk of them
+          if (callback != nullptr && FLAGS_result_chunk_rows > 0 &&
+              result.size() >= FLAGS_result_chunk_rows *
+                                   logical_tile->GetColumnCount()) {
+            (*callback)(result);
+          }
         }
       }
 
@@ -118,6 +212,10 @@ ExecuteResult PlanExecutor::ExecutePlan(
       p_status.m_result = ResultType::FAILURE;
     }
 
+    if (profile != nullptr) {
+      *profile = executor_tree->GetProfile();
+    }
+
     p_status.m_result_slots = nullptr;
 
     // clean up executor tree
@@ -128,34 +226,65 @@ ExecuteResult PlanExecutor::ExecutePlan(
 
     result.clear();
 
-    // Perform binding
+    // Perform binding, unless the query is compiled already. The consumer
+    // only needs the attributes to compile the query.
     planner::BindingContext context;
-    plan->PerformBinding(context);
+    if (cached_query == nullptr) {
+      plan->PerformBinding(context);
+    }
 
-    // Prepare output buffer
+    // The compiled query writes out the columns of its results directly
     std::vector<oid_t> columns;
     plan->GetOutputColumns(columns);
     codegen::BufferingConsumer consumer{columns, context};
-
-    // Compile the query
-    codegen::QueryCompiler compiler;
-    auto query = compiler.Compile(*plan, consumer);
-
-    // Execute the query
-    query->Execute(*txn, executor_context.get(),
-                   reinterpret_cast<char *>(consumer.GetState()));
-
-    // Iterate over results
-    const auto &results = consumer.GetOutputTuples();
-    for (const auto &tuple : results) {
-      for (uint32_t i = 0; i < tuple.tuple_.size(); i++) {
-        auto res = StatementResult();
-        auto column_val = tuple.GetValue(i);
-        auto str = column_val.IsNull() ? "" : column_val.ToString();
-        PlanExecutor::copyFromTo(str, res.second);
-        LOG_TRACE("column content: [%s]", str.c_str());
-        result.push_back(std::move(res));
+    consumer.WriteResultsTo(result, &result_format, callback,
+                            FLAGS_result_chunk_rows);
+
+    codegen::QueryCompiler::CompileStats compile_stats;
+    codegen::Query::RuntimeStats runtime_stats;
+    if (parameters != nullptr) {
+      if (cached_query == nullptr) {
+        codegen::QueryCompiler compiler;
+        auto query = compiler.Compile(*plan, consumer, &compile_stats,
+                                      parameters.get());
+        cached_query = codegen::QueryCache::GetInstance().Add(
+            plan, std::move(query), *parameters);
       }
+
+      // Execute the query
+      cached_query->query->Execute(
+          *txn, executor_context.get(),
+          reinterpret_cast<char *>(consumer.GetState()), &runtime_stats,
+          parameters.get());
+      RecordCompiledQuery(*plan, *cached_query->query, compile_stats,
+                          runtime_stats, parameters.get());
+    } else {
+      // Compile the query
+      codegen::QueryCompiler compiler;
+      auto query = compiler.Compile(*plan, consumer, &compile_stats);
+
+      // Execute the query
+      query->Execute(*txn, executor_context.get(),
+                     reinterpret_cast<char *>(consumer.GetState()),
+                     &runtime_stats);
+      RecordCompiledQuery(*plan, *query, compile_stats, runtime_stats,
+                          nullptr);
+    }
+
+    // The operators of a pipeline run fused together, so only the query as
+    // a whole is profiled
+    if (profile != nullptr) {
+      *profile = ExecutorProfile::FromPlan(*plan);
+      profile->is_compiled = true;
+      profile->compile_ms = compile_stats.TotalTime();
+      profile->init_ms = runtime_stats.init_ms;
+      profile->tear_down_ms = runtime_stats.tear_down_ms;
+      profile->is_profiled = true;
+      profile->execute_count = 1;
+      profile->tuple_count =
+          columns.empty() ? 0 : result.size() / columns.size();
+      profile->execute_ms = runtime_stats.plan_ms;
+      profile->memory_bytes = executor_context->GetUsedMemory();
     }
 
     // This is 0 since codegen currently support SELECT only
@@ -167,6 +296,51 @@ ExecuteResult PlanExecutor::ExecutePlan(
   return p_status;
 }
 
+size_t PlanExecutor::EstimateProcessedRows(const planner::AbstractPlan &plan) {
+  size_t num_rows = 0;
+  switch (plan.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN: {
+      auto table = static_cast<const planner::AbstractScan &>(plan).GetTable();
+      if (table != nullptr) num_rows = table->GetTupleCount();
+      break;
+    }
+    case PlanNodeType::INDEXSCAN: {
+      auto &index_scan = static_cast<const planner::IndexScanPlan &>(plan);
+      auto index = index_scan.GetIndex();
+      auto &key_column_ids = index_scan.GetKeyColumnIds();
+      auto &expr_types = index_scan.GetExprTypes();
+      bool point_lookup = index != nullptr && index->HasUniqueKeys();
+      if (point_lookup) {
+        // Every key has to be compared for equality
+        for (auto key_column_id : index->GetMetadata()->GetKeyAttrs()) {
+          bool bound = false;
+          for (size_t key_idx = 0; key_idx < key_column_ids.size();
+               key_idx++) {
+            if (key_column_ids[key_idx] == key_column_id &&
+                expr_types[key_idx] == ExpressionType::COMPARE_EQUAL) {
+              bound = true;
+              break;
+            }
+          }
+          if (bound == false) {
+            point_lookup = false;
+            break;
+          }
+        }
+      }
+      num_rows = point_lookup ? 1 : index_scan.GetTable()->GetTupleCount();
+      break;
+    }
+    default:
+      break;
+  }
+
+  for (auto &child : plan.GetChildren()) {
+    num_rows += EstimateProcessedRows(*child);
+  }
+  return num_rows;
+}
+
 /**
  * @brief Build a executor tree and execute it.
  * Use std::vector<type::Value> as params to make it more elegant for
@@ -310,6 +484,22 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::IndexScanExecutor(plan, executor_context);
       break;
 
+    case PlanNodeType::AGGREGATE_VIEW_SCAN:
+      LOG_TRACE("Adding Aggregate View Scan Executor");
+      child_executor =
+          new executor::AggregateViewScanExecutor(plan, executor_context);
+      break;
+
+    case PlanNodeType::EXCHANGE:
+      LOG_TRACE("Adding Exchange Executor");
+      child_executor = new executor::ExchangeExecutor(plan, executor_context);
+      break;
+
+    case PlanNodeType::APPEND:
+      LOG_TRACE("Adding Append Executor");
+      child_executor = new executor::AppendExecutor(plan, executor_context);
+      break;
+
     case PlanNodeType::INSERT:
       LOG_TRACE("Adding Insert Executor");
       child_executor = new executor::InsertExecutor(plan, executor_context);
@@ -336,6 +526,12 @@ executor::AbstractExecutor *BuildExecutorTree(
           new executor::NestedLoopJoinExecutor(plan, executor_context);
       break;
 
+    case PlanNodeType::NESTLOOPINDEX:
+      LOG_TRACE("Adding Index Nested Loop Join Executor");
+      child_executor =
+          new executor::IndexNestedLoopJoinExecutor(plan, executor_context);
+      break;
+
     case PlanNodeType::MERGEJOIN:
       LOG_TRACE("Adding Merge Join Executor");
       child_executor = new executor::MergeJoinExecutor(plan, executor_context);
@@ -372,6 +568,11 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::OrderByExecutor(plan, executor_context);
       break;
 
+    case PlanNodeType::WINDOW:
+      LOG_TRACE("Adding Window Executor");
+      child_executor = new executor::WindowExecutor(plan, executor_context);
+      break;
+
     case PlanNodeType::DROP:
       LOG_TRACE("Adding Drop Executor");
       child_executor = new executor::DropExecutor(plan, executor_context);
@@ -387,8 +588,14 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::CreateExecutor(plan, executor_context);
       break;
     case PlanNodeType::COPY:
-      LOG_TRACE("Adding Copy Executor");
-      child_executor = new executor::CopyExecutor(plan, executor_context);
+      if (static_cast<const planner::CopyPlan *>(plan)->IsCopyFrom()) {
+        LOG_TRACE("Adding Copy From Executor");
+        child_executor =
+            new executor::CopyFromExecutor(plan, executor_context);
+      } else {
+        LOG_TRACE("Adding Copy Executor");
+        child_executor = new executor::CopyExecutor(plan, executor_context);
+      }
       break;
     case PlanNodeType::POPULATE_INDEX:
       LOG_TRACE("Adding PopulateIndex Executor");
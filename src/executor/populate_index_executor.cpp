@@ -20,8 +20,13 @@
 #include "executor/executor_context.h"
 #include "planner/populate_index_plan.h"
 #include "expression/tuple_value_expression.h"
+#include "index/index.h"
 #include "storage/data_table.h"
+#include "storage/index_builder.h"
 #include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
 
 namespace peloton {
 namespace executor {
@@ -55,8 +60,36 @@ bool PopulateIndexExecutor::DExecute() {
   LOG_TRACE("Populate Index Executor");
   PL_ASSERT(executor_context_ != nullptr);
   auto current_txn = executor_context_->GetTransaction();
-  auto executor_pool = executor_context_->GetPool();
   if (done_ == false) {
+    // The index on these columns that was added last is the one just created
+    std::shared_ptr<index::Index> target_index;
+    for (int index_itr = target_table_->GetIndexCount() - 1; index_itr >= 0;
+         --index_itr) {
+      auto index = target_table_->GetIndex(index_itr);
+      if (index != nullptr &&
+          index->GetKeySchema()->GetIndexedColumns() == column_ids_) {
+        target_index = index;
+        break;
+      }
+    }
+
+    if (target_index == nullptr) {
+      LOG_TRACE("PopulateIndex Executor : false -- no index to populate ");
+      return false;
+    }
+
+    // An index without a uniqueness constraint is populated in the
+    // background while the writers maintain it, so that the statement does
+    // not stall them. A violation of a uniqueness constraint must fail the
+    // statement instead.
+    if (target_index->GetIndexType() == IndexConstraintType::DEFAULT) {
+      storage::IndexBuilder::GetInstance().BuildIndex(target_table_,
+                                                      target_index);
+      done_ = true;
+      LOG_TRACE("PopulateIndex Executor : false -- building in background ");
+      return false;
+    }
+
     //Get the output from seq_scan
     while (children_[0]->Execute()) {
       child_tiles_.emplace_back(children_[0]->GetOutput());
@@ -67,37 +100,43 @@ bool PopulateIndexExecutor::DExecute() {
       return false;
     }
 
-    auto target_table_schema = target_table_->GetSchema();
+    auto index_schema = target_index->GetKeySchema();
+    std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer *>>
+        entries;
 
-    std::unique_ptr<storage::Tuple> tuple(
-        new storage::Tuple(target_table_schema, true));
-
-    // Go over the logical tile and insert in the index the values
+    // Go over the logical tile and collect the keys and index entries
     for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
          child_tile_itr++) {
       auto tile = child_tiles_[child_tile_itr].get();
+      auto tile_group_header =
+          tile->GetBaseTile(0)->GetTileGroup()->GetHeader();
+      auto &position_list =
+          tile->GetPositionList(tile->GetColumnInfo(0).position_list_idx);
 
       // Go over all tuples in the logical tile
       for (oid_t tuple_id : *tile) {
         expression::ContainerTuple<LogicalTile> cur_tuple(tile, tuple_id);
 
-        // Materialize the logical tile tuple
+        // The seq scan outputs the key columns in key order
+        std::unique_ptr<storage::Tuple> key(
+            new storage::Tuple(index_schema, true));
         for (oid_t column_itr = 0; column_itr < column_ids_.size();
              column_itr++) {
           type::Value val = (cur_tuple.GetValue(column_itr));
-          tuple->SetValue(column_ids_[column_itr], val, executor_pool);
+          key->SetValue(column_itr, val, target_index->GetPool());
         }
 
-        ItemPointer location(tile->GetBaseTile(0)->GetTileGroup()->GetTileGroupId(),
-                             tuple_id);
-
-        // insert tuple into the index.
-        ItemPointer *index_entry_ptr = nullptr;
-        target_table_->InsertInIndexes(tuple.get(), location, current_txn,
-                                       &index_entry_ptr);
+        // The entry shares the indirection of the tuple with the other
+        // indexes
+        entries.emplace_back(std::move(key),
+                             tile_group_header->GetIndirection(
+                                 position_list[tuple_id]));
       }
     }
 
+    // Build the index from the sorted keys at once
+    target_table_->LoadIndex(target_index.get(), entries, current_txn);
+
     done_ = true;
   }
   LOG_TRACE("Populate Index Executor : false -- done ");
@@ -46,6 +46,63 @@ bool ProjectionExecutor::DInit() {
   this->project_info_ = node.GetProjectInfo();
   this->schema_ = node.GetSchema();
 
+  // A projection made of direct maps from its only child keeps the child's
+  // position lists
+  direct_column_ids_.clear();
+  if (children_.size() == 1 && !project_info_->isNonTrivial()) {
+    const auto &direct_map_list = project_info_->GetDirectMapList();
+    std::vector<oid_t> column_ids(schema_->GetColumnCount(), INVALID_OID);
+    bool direct = direct_map_list.size() == column_ids.size();
+    for (const auto &direct_map : direct_map_list) {
+      if (!direct || direct_map.first >= column_ids.size() ||
+          direct_map.second.first != 0) {
+        direct = false;
+        break;
+      }
+      column_ids[direct_map.first] = direct_map.second.second;
+    }
+    for (oid_t column_id : column_ids) {
+      direct = direct && column_id != INVALID_OID;
+    }
+    if (direct) {
+      direct_column_ids_ = std::move(column_ids);
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Project the columns of the source tile in place, if the output
+ * columns are columns of the child of the same types.
+ * @return true if the source tile was projected, false otherwise.
+ */
+bool ProjectionExecutor::ProjectColumns(LogicalTile *source_tile) {
+  if (direct_column_ids_.empty()) {
+    return false;
+  }
+
+  const oid_t source_column_count = source_tile->GetColumnCount();
+  std::vector<oid_t> source_column_ids;
+  for (oid_t column_id = 0; column_id < source_column_count; column_id++) {
+    source_column_ids.push_back(column_id);
+  }
+
+  // Values of other types are cast when they are copied
+  for (oid_t column_itr = 0; column_itr < direct_column_ids_.size();
+       column_itr++) {
+    oid_t column_id = direct_column_ids_[column_itr];
+    if (column_id >= source_column_count) {
+      return false;
+    }
+    const auto &column_info = source_tile->GetColumnInfo(column_id);
+    if (column_info.base_tile->GetSchema()->GetType(
+            column_info.origin_column_id) != schema_->GetType(column_itr)) {
+      return false;
+    }
+  }
+
+  source_tile->ProjectColumns(source_column_ids, direct_column_ids_);
   return true;
 }
 
@@ -96,6 +153,10 @@ bool ProjectionExecutor::DExecute() {
 
     // Get input from child
     std::unique_ptr<LogicalTile> source_tile(children_[0]->GetOutput());
+    if (ProjectColumns(source_tile.get())) {
+      SetOutput(source_tile.release());
+      return true;
+    }
     auto num_tuples = source_tile->GetTupleCount();
 
     // Create new physical tile where we store projected tuples
@@ -12,6 +12,7 @@
 
 #include "executor/seq_scan_executor.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -30,11 +31,16 @@
 #include "common/container_tuple.h"
 #include "planner/create_plan.h"
 #include "storage/data_table.h"
+#include "storage/frozen_tile_group.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_evictor.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
+#include "storage/zone_map.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "common/logger.h"
 #include "index/index.h"
+#include "optimizer/stats/cardinality_feedback.h"
 
 namespace peloton {
 namespace executor {
@@ -61,12 +67,17 @@ bool SeqScanExecutor::DInit() {
 
   target_table_ = node.GetTable();
 
-  current_tile_group_offset_ = START_OID;
+  current_tile_group_offset_ = tile_group_start_;
+  prefetch_tile_group_offset_ = tile_group_start_;
+  scanned_tuple_count_ = 0;
+  matched_tuple_count_ = 0;
 
   old_predicate_ = predicate_;
+  vectorized_predicate_.reset();
 
   if (target_table_ != nullptr) {
-    table_tile_group_count_ = target_table_->GetTileGroupCount();
+    oid_t tile_group_count = target_table_->GetTileGroupCount();
+    table_tile_group_count_ = std::min(tile_group_count, tile_group_end_);
 
     if (column_ids_.empty()) {
       column_ids_.resize(target_table_->GetSchema()->GetColumnCount());
@@ -103,13 +114,14 @@ bool SeqScanExecutor::DExecute() {
 
       if (predicate_ != nullptr) {
         // Invalidate tuples that don't satisfy the predicate.
-        for (oid_t tuple_id : *tile) {
-          expression::ContainerTuple<LogicalTile> tuple(tile.get(), tuple_id);
-          auto eval = predicate_->Evaluate(&tuple, nullptr, executor_context_);
-          if (eval.IsFalse()) {
-            // if (predicate_->Evaluate(&tuple, nullptr, executor_context_)
-            //        .IsFalse()) {
-            tile->RemoveVisibility(tuple_id);
+        std::vector<oid_t> tuple_ids(tile->begin(), tile->end());
+        GetVectorizedPredicate().Evaluate(tile.get(), tuple_ids.data(),
+                                          tuple_ids.size(), nullptr,
+                                          executor_context_,
+                                          predicate_results_);
+        for (size_t idx = 0; idx < tuple_ids.size(); idx++) {
+          if (predicate_results_[idx] == type::CMP_FALSE) {
+            tile->RemoveVisibility(tuple_ids[idx]);
           }
         }
       }
@@ -160,68 +172,135 @@ bool SeqScanExecutor::DExecute() {
     while (current_tile_group_offset_ < table_tile_group_count_) {
       auto tile_group =
           target_table_->GetTileGroup(current_tile_group_offset_++);
+
+      // Skip tile groups dropped by the compactor
+      if (tile_group == nullptr) {
+        continue;
+      }
+
       auto tile_group_header = tile_group->GetHeader();
 
+      // Skip tile groups in which no tuple can satisfy the predicate
+      if (predicate_ != nullptr &&
+          tile_group->GetZoneMap()->CanSatisfy(predicate_, executor_context_) ==
+              false) {
+        LOG_TRACE("Skipping tile group %u", tile_group->GetTileGroupId());
+        scanned_tuple_count_ += tile_group_header->GetActiveTupleCount();
+        continue;
+      }
+
+      // Page in the evicted tile groups that follow while this one is read
+      if (tile_group->IsEvicted() == true &&
+          current_tile_group_offset_ >= prefetch_tile_group_offset_) {
+        auto prefetch_count =
+            std::min(storage::TileGroupEvictor::PREFETCH_TILE_GROUP_COUNT,
+                     table_tile_group_count_ - current_tile_group_offset_);
+        storage::TileGroupEvictor::PrefetchTileGroups(
+            target_table_, current_tile_group_offset_, prefetch_count);
+        prefetch_tile_group_offset_ =
+            current_tile_group_offset_ + prefetch_count;
+      }
+
       oid_t active_tuple_count = tile_group->GetNextTupleSlot();
 
-      // Construct position list by looping through tile group
-      // and applying the predicate.
+      // Check the visibility of the whole tile group at once
+      std::vector<oid_t> visible_tuples(active_tuple_count);
+      oid_t visible_tuple_count = transaction_manager.GetVisibleTuples(
+          current_txn, tile_group_header, 0, active_tuple_count,
+          visible_tuples.data());
+
+      // The tuple slots of a released tile group are read from its frozen
+      // copy, whose encoded columns rule out tuples before the predicate is
+      // evaluated on the decoded values of the others
+      auto frozen_tile_group = tile_group->IsReleased() == true
+                                   ? tile_group->GetFrozenTileGroup()
+                                   : nullptr;
+      oid_t candidate_count = visible_tuple_count;
+      if (predicate_ != nullptr && frozen_tile_group != nullptr) {
+        candidate_count = frozen_tile_group->FilterTuples(
+            predicate_, executor_context_, visible_tuples.data(),
+            visible_tuple_count);
+        predicate_results_.resize(candidate_count);
+        for (oid_t visible_idx = 0; visible_idx < candidate_count;
+             visible_idx++) {
+          expression::ContainerTuple<storage::TileGroup> tuple(
+              tile_group.get(), visible_tuples[visible_idx]);
+          predicate_results_[visible_idx] =
+              predicate_->Evaluate(&tuple, nullptr, executor_context_)
+                      .IsTrue()
+                  ? type::CMP_TRUE
+                  : type::CMP_FALSE;
+        }
+      } else if (predicate_ != nullptr) {
+        // Evaluate the predicate for all visible tuples at once
+        GetVectorizedPredicate().Evaluate(
+            tile_group.get(), visible_tuples.data(), visible_tuple_count,
+            nullptr, executor_context_, predicate_results_);
+      }
+
+      // Construct position list by looping through the visible tuples
+      // that satisfy the predicate.
       std::vector<oid_t> position_list;
-      for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+      for (oid_t visible_idx = 0; visible_idx < candidate_count;
+           visible_idx++) {
+        if (predicate_ != nullptr &&
+            predicate_results_[visible_idx] != type::CMP_TRUE) {
+          continue;
+        }
 
-        auto visibility = transaction_manager.IsVisible(
-            current_txn, tile_group_header, tuple_id);
-
-        // check transaction visibility
-        if (visibility == VisibilityType::OK) {
-          // if the tuple is visible, then perform predicate evaluation.
-          if (predicate_ == nullptr) {
-            position_list.push_back(tuple_id);
-            auto res = transaction_manager.PerformRead(current_txn, location,
-                                                       acquire_owner);
-            if (!res) {
-              transaction_manager.SetTransactionResult(current_txn,
-                                                       ResultType::FAILURE);
-              return res;
-            }
-          } else {
-            expression::ContainerTuple<storage::TileGroup> tuple(
-                tile_group.get(), tuple_id);
-            LOG_TRACE("Evaluate predicate for a tuple");
-            auto eval =
-                predicate_->Evaluate(&tuple, nullptr, executor_context_);
-            LOG_TRACE("Evaluation result: %s", eval.GetInfo().c_str());
-            if (eval.IsTrue()) {
-              position_list.push_back(tuple_id);
-              auto res = transaction_manager.PerformRead(current_txn, location,
-                                                         acquire_owner);
-              if (!res) {
-                transaction_manager.SetTransactionResult(current_txn,
-                                                         ResultType::FAILURE);
-                return res;
-              } else {
-                LOG_TRACE("Sequential Scan Predicate Satisfied");
-              }
-            }
-          }
+        oid_t tuple_id = visible_tuples[visible_idx];
+        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+        position_list.push_back(tuple_id);
+        auto res = transaction_manager.PerformRead(current_txn, location,
+                                                   acquire_owner);
+        if (!res) {
+          transaction_manager.SetTransactionResult(current_txn,
+                                                   ResultType::FAILURE);
+          return res;
         }
       }
 
+      scanned_tuple_count_ += visible_tuple_count;
+      matched_tuple_count_ += position_list.size();
+
       // Don't return empty tiles
       if (position_list.size() == 0) {
         continue;
       }
 
-      // Construct logical tile.
+      // Construct logical tile. The columns of a released tile group are
+      // decoded into a tile whose slots line up with its tuple slots, so
+      // that the parents find the tuples at their offsets.
       std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-      logical_tile->AddColumns(tile_group, column_ids_);
+      auto decoded_tile =
+          frozen_tile_group != nullptr
+              ? tile_group->DecodeFrozenTile(column_ids_, position_list)
+              : nullptr;
+      if (decoded_tile != nullptr) {
+        for (oid_t column_itr = 0; column_itr < column_ids_.size();
+             column_itr++) {
+          logical_tile->AddColumn(decoded_tile, column_itr, 0);
+        }
+      } else {
+        logical_tile->AddColumns(tile_group, column_ids_);
+      }
       logical_tile->AddPositionList(std::move(position_list));
 
       LOG_TRACE("Information %s", logical_tile->GetInfo().c_str());
       SetOutput(logical_tile.release());
       return true;
     }
+
+    // Only a scan of the whole table with the predicate of the plan tells
+    // the selectivity of the predicate
+    if (predicate_ != nullptr && new_predicate_ == nullptr &&
+        tile_group_start_ == START_OID &&
+        table_tile_group_count_ == target_table_->GetTileGroupCount()) {
+      optimizer::CardinalityFeedback::GetInstance().Record(
+          target_table_->GetOid(), predicate_, matched_tuple_count_,
+          scanned_tuple_count_);
+      scanned_tuple_count_ = 0;
+    }
   }
 
   return false;
@@ -260,6 +339,17 @@ void SeqScanExecutor::UpdatePredicate(const std::vector<oid_t> &column_ids,
   // we should eventually make prediate_ a unique_ptr
   new_predicate_.reset(new_predicate);
   predicate_ = new_predicate;
+  vectorized_predicate_.reset();
+}
+
+const expression::VectorizedPredicate &
+SeqScanExecutor::GetVectorizedPredicate() {
+  PL_ASSERT(predicate_ != nullptr);
+  if (vectorized_predicate_ == nullptr) {
+    vectorized_predicate_.reset(
+        new expression::VectorizedPredicate(predicate_));
+  }
+  return *vectorized_predicate_;
 }
 
 // Transfer a list of equality predicate
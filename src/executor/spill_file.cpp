@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.cpp
+//
+// Identification: src/executor/spill_file.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/spill_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+SpillFile::SpillFile(const std::vector<type::TypeId> &column_types)
+    : column_types_(column_types) {
+  // The file is removed as soon as it is closed
+  file_ = std::tmpfile();
+  if (file_ == nullptr) {
+    throw ExecutorException("Could not create a spill file: " +
+                            std::string(strerror(errno)));
+  }
+}
+
+SpillFile::~SpillFile() { fclose(file_); }
+
+size_t SpillFile::GetPartition(const std::vector<type::Value> &keys,
+                               size_t level) {
+  size_t seed = 0x9e3779b97f4a7c15ull * (level + 1);
+  for (const auto &key : keys) {
+    key.HashCombine(seed);
+  }
+  return (seed >> 8) % kNumPartitions;
+}
+
+void SpillFile::Append(const std::vector<type::Value> &values) {
+  PL_ASSERT(values.size() == column_types_.size());
+
+  output_.Reset();
+  for (const auto &value : values) {
+    value.SerializeTo(output_);
+  }
+
+  uint32_t length = static_cast<uint32_t>(output_.Size());
+  if (fwrite(&length, sizeof(length), 1, file_) != 1 ||
+      fwrite(output_.Data(), 1, length, file_) != length) {
+    throw ExecutorException("Could not write to a spill file: " +
+                            std::string(strerror(errno)));
+  }
+
+  row_count_++;
+  byte_count_ += sizeof(length) + length;
+}
+
+void SpillFile::Rewind() {
+  if (fflush(file_) != 0 || fseek(file_, 0, SEEK_SET) != 0) {
+    throw ExecutorException("Could not rewind a spill file: " +
+                            std::string(strerror(errno)));
+  }
+}
+
+bool SpillFile::Next(std::vector<type::Value> &values) {
+  uint32_t length;
+  if (fread(&length, sizeof(length), 1, file_) != 1) {
+    if (ferror(file_)) {
+      throw ExecutorException("Could not read from a spill file: " +
+                              std::string(strerror(errno)));
+    }
+    return false;
+  }
+
+  input_.resize(length);
+  if (fread(input_.data(), 1, length, file_) != length) {
+    throw ExecutorException("Spill file ends in the middle of a row");
+  }
+
+  // Values deserialized from the buffer refer to it, varlen values are copied
+  // out so that they outlive the next row
+  ReferenceSerializeInput input(input_.data(), length);
+  values.clear();
+  for (auto column_type : column_types_) {
+    type::Value value = type::Value::DeserializeFrom(input, column_type);
+    if (!value.IsNull() && column_type == type::TypeId::VARCHAR) {
+      value = type::ValueFactory::GetVarcharValue(value.GetData(),
+                                                  value.GetLength(), true);
+    } else if (!value.IsNull() && column_type == type::TypeId::VARBINARY) {
+      value = type::ValueFactory::GetVarbinaryValue(
+          reinterpret_cast<const unsigned char *>(value.GetData()),
+          value.GetLength(), true);
+    }
+    values.push_back(std::move(value));
+  }
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -17,6 +17,7 @@
 #include "executor/logical_tile.h"
 #include "executor/executor_context.h"
 #include "common/container_tuple.h"
+#include "concurrency/contention_manager.h"
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/data_table.h"
@@ -103,10 +104,11 @@ bool UpdateExecutor::PerformUpdatePrimaryKey(bool is_owner,
 
   project_info_->Evaluate(&new_tuple, &old_tuple, nullptr, executor_context_);
 
-  // insert tuple into the table.
+  // insert tuple into the table, or into the partition of its new key.
   ItemPointer *index_entry_ptr = nullptr;
-  peloton::ItemPointer location =
-      target_table_->InsertTuple(&new_tuple, current_txn, &index_entry_ptr);
+  const planner::UpdatePlan &update_node = GetPlanNode<planner::UpdatePlan>();
+  peloton::ItemPointer location = update_node.GetInsertTable()->InsertTuple(
+      &new_tuple, current_txn, &index_entry_ptr);
 
   // it is possible that some concurrent transactions have inserted the
   // same tuple. In this case, abort the transaction.
@@ -117,10 +119,52 @@ bool UpdateExecutor::PerformUpdatePrimaryKey(bool is_owner,
   }
 
   transaction_manager.PerformInsert(current_txn, location, index_entry_ptr);
+  if (update_node.GetInsertTable() != target_table_) {
+    executor_context_->AddMovedTuple(location);
+  }
 
   return true;
 }
 
+bool UpdateExecutor::PerformInPlaceUpdate(storage::TileGroup *tile_group,
+                                          oid_t physical_tuple_id) {
+  // the columns that are not updated must keep their values
+  for (auto &dm : project_info_->GetDirectMapList()) {
+    if (dm.second.first != 0 || dm.first != dm.second.second) {
+      return false;
+    }
+  }
+
+  auto &target_list = project_info_->GetTargetList();
+  std::vector<oid_t> column_ids;
+  for (auto &target : target_list) {
+    column_ids.push_back(target.first);
+  }
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto current_txn = executor_context_->GetTransaction();
+  if (transaction_manager.PerformInPlaceUpdate(
+          current_txn, tile_group, physical_tuple_id, column_ids) == false) {
+    return false;
+  }
+
+  // evaluate every target before any column is overwritten
+  expression::ContainerTuple<storage::TileGroup> old_tuple(tile_group,
+                                                           physical_tuple_id);
+  std::vector<type::Value> values;
+  for (auto &target : target_list) {
+    values.push_back(
+        target.second.expr->Evaluate(&old_tuple, nullptr, executor_context_));
+  }
+
+  for (size_t target_id = 0; target_id < values.size(); target_id++) {
+    tile_group->SetValue(values[target_id], physical_tuple_id,
+                         column_ids[target_id]);
+  }
+  return true;
+}
+
 /**
  * @brief updates a set of columns
  * @return true on success, false otherwise.
@@ -155,6 +199,11 @@ bool UpdateExecutor::DExecute() {
 
     ItemPointer old_location(tile_group->GetTileGroupId(), physical_tuple_id);
 
+    // the statement already updated the tuple it moved here
+    if (executor_context_->IsMovedTuple(old_location) == true) {
+      continue;
+    }
+
     LOG_TRACE("Visible Tuple id : %u, Physical Tuple id : %u ",
               visible_tuple_id, physical_tuple_id);
 
@@ -263,6 +312,12 @@ bool UpdateExecutor::DExecute() {
           }
         }
 
+        // Normal update (no primary key) of the version in place
+        else if (PerformInPlaceUpdate(tile_group, physical_tuple_id) ==
+                 true) {
+          executor_context_->num_processed += 1;  // updated one
+        }
+
         // Normal update (no primary key)
         else {
           // if it is the latest version and not locked by other threads, then
@@ -289,10 +344,11 @@ bool UpdateExecutor::DExecute() {
           // get indirection.
           ItemPointer *indirection =
               tile_group_header->GetIndirection(old_location.offset);
-          // finally install new version into the table
-          ret = target_table_->InstallVersion(&new_tuple,
-                                              &(project_info_->GetTargetList()),
-                                              current_txn, indirection);
+          // finally install new version into the table. the indexes are
+          // only maintained if the update changed their columns.
+          ret = target_table_->InstallVersion(
+              &new_tuple, &(project_info_->GetTargetList()), current_txn,
+              indirection, &old_tuple);
 
           // PerformUpdate() will not be executed if the insertion failed.
           // There is a write lock acquired, but since it is not in the write
@@ -328,6 +384,8 @@ bool UpdateExecutor::DExecute() {
 
         // transaction should be aborted as we cannot update the latest version.
         LOG_TRACE("Fail to update tuple. Set txn failure.");
+        concurrency::ContentionManager::GetInstance().RecordConflict(
+            tile_group->GetTileGroupId(), ConflictType::WRITE_WRITE);
         transaction_manager.SetTransactionResult(current_txn,
                                                  ResultType::FAILURE);
         return false;
@@ -0,0 +1,370 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// window_executor.cpp
+//
+// Identification: src/executor/window_executor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "executor/window_executor.h"
+
+#include <algorithm>
+
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "planner/window_plan.h"
+#include "storage/tile.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace executor {
+
+namespace {
+
+// SUM adds up integers as BIGINT and everything else as DECIMAL
+type::TypeId GetSumType(type::TypeId column_type) {
+  switch (column_type) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+      return type::TypeId::BIGINT;
+    default:
+      return type::TypeId::DECIMAL;
+  }
+}
+
+type::TypeId GetTermType(const planner::WindowTerm &term,
+                         type::TypeId column_type) {
+  switch (term.function) {
+    case planner::WindowFunctionType::SUM:
+      return GetSumType(column_type);
+    case planner::WindowFunctionType::AVG:
+      return type::TypeId::DECIMAL;
+    case planner::WindowFunctionType::MIN:
+    case planner::WindowFunctionType::MAX:
+      return column_type;
+    default:
+      return type::TypeId::BIGINT;
+  }
+}
+
+std::string GetTermName(const planner::WindowTerm &term) {
+  switch (term.function) {
+    case planner::WindowFunctionType::ROW_NUMBER:
+      return "row_number";
+    case planner::WindowFunctionType::RANK:
+      return "rank";
+    case planner::WindowFunctionType::DENSE_RANK:
+      return "dense_rank";
+    case planner::WindowFunctionType::COUNT:
+      return "count";
+    case planner::WindowFunctionType::SUM:
+      return "sum";
+    case planner::WindowFunctionType::AVG:
+      return "avg";
+    case planner::WindowFunctionType::MIN:
+      return "min";
+    case planner::WindowFunctionType::MAX:
+      return "max";
+  }
+  return "window";
+}
+
+}  // namespace
+
+/**
+ * @brief Constructor
+ * @param node  WindowPlan plan node corresponding to this executor
+ */
+WindowExecutor::WindowExecutor(const planner::AbstractPlan *node,
+                               ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context) {}
+
+bool WindowExecutor::DInit() {
+  PL_ASSERT(children_.size() == 1);
+
+  window_done_ = false;
+  num_tuples_returned_ = 0;
+  input_tiles_.clear();
+  rows_.clear();
+  window_values_.clear();
+
+  return true;
+}
+
+bool WindowExecutor::DExecute() {
+  LOG_TRACE("Window executor ");
+
+  if (!window_done_) DoWindow();
+
+  if (!(num_tuples_returned_ < rows_.size())) {
+    return false;
+  }
+
+  PL_ASSERT(output_schema_.get());
+
+  // Returned tiles are new physical tiles with the input columns followed by
+  // the window values
+  size_t tile_size = std::min(size_t(DEFAULT_TUPLES_PER_TILEGROUP),
+                              rows_.size() - num_tuples_returned_);
+
+  std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
+      BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+      nullptr, *output_schema_, nullptr, tile_size));
+
+  for (size_t id = 0; id < tile_size; id++) {
+    size_t row = num_tuples_returned_ + id;
+    for (oid_t column_id = 0; column_id < input_column_count_; column_id++) {
+      ptile->SetValue(GetRowValue(row, column_id), id, column_id);
+    }
+    auto &values = window_values_[row];
+    for (oid_t term_offset = 0; term_offset < values.size(); term_offset++) {
+      ptile->SetValue(values[term_offset], id,
+                      input_column_count_ + term_offset);
+    }
+  }
+
+  // Create an owner wrapper of this physical tile
+  std::vector<std::shared_ptr<storage::Tile>> singleton({ptile});
+  std::unique_ptr<LogicalTile> ltile(LogicalTileFactory::WrapTiles(singleton));
+  PL_ASSERT(ltile->GetTupleCount() == tile_size);
+
+  SetOutput(ltile.release());
+
+  num_tuples_returned_ += tile_size;
+  return true;
+}
+
+void WindowExecutor::DoWindow() {
+  PL_ASSERT(children_.size() == 1);
+  PL_ASSERT(!window_done_);
+
+  const planner::WindowPlan &node = GetPlanNode<planner::WindowPlan>();
+
+  // Extract all data from child
+  while (children_[0]->Execute()) {
+    std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
+    if (tile->GetTupleCount() == 0) {
+      continue;
+    }
+    if (output_schema_ == nullptr) {
+      InitSchema(tile.get());
+    }
+
+    oid_t tile_id = input_tiles_.size();
+    for (oid_t tuple_id : *tile) {
+      rows_.emplace_back(tile_id, tuple_id);
+    }
+    input_tiles_.push_back(std::move(tile));
+  }
+
+  window_values_.assign(rows_.size(), std::vector<type::Value>());
+  size_t begin = 0;
+  for (size_t row = 1; row <= rows_.size(); row++) {
+    if (row == rows_.size() ||
+        !SameValues(row - 1, row, node.GetPartitionColumnIds())) {
+      ComputePartition(begin, row);
+      begin = row;
+    }
+  }
+
+  window_done_ = true;
+}
+
+void WindowExecutor::InitSchema(LogicalTile *tile) {
+  const planner::WindowPlan &node = GetPlanNode<planner::WindowPlan>();
+
+  std::unique_ptr<catalog::Schema> physical_schema(tile->GetPhysicalSchema());
+  input_column_count_ = physical_schema->GetColumnCount();
+
+  std::vector<catalog::Column> columns = physical_schema->GetColumns();
+  for (auto &term : node.GetTerms()) {
+    auto column_type = type::TypeId::INVALID;
+    if (term.column_id != INVALID_OID) {
+      column_type = physical_schema->GetType(term.column_id);
+    }
+    auto term_type = GetTermType(term, column_type);
+
+    // MIN and MAX keep the column as it is, e.g. its varchar length
+    if (term.column_id != INVALID_OID && term_type == column_type) {
+      catalog::Column column = physical_schema->GetColumn(term.column_id);
+      columns.push_back(catalog::Column(term_type, column.GetLength(),
+                                        GetTermName(term),
+                                        column.IsInlined()));
+    } else {
+      columns.push_back(catalog::Column(term_type,
+                                        type::Type::GetTypeSize(term_type),
+                                        GetTermName(term), true));
+    }
+  }
+  output_schema_.reset(new catalog::Schema(columns));
+}
+
+void WindowExecutor::ComputePartition(size_t begin, size_t end) {
+  const planner::WindowPlan &node = GetPlanNode<planner::WindowPlan>();
+  auto &terms = node.GetTerms();
+  for (size_t row = begin; row < end; row++) {
+    window_values_[row].resize(terms.size());
+  }
+
+  for (oid_t term_offset = 0; term_offset < terms.size(); term_offset++) {
+    auto &term = terms[term_offset];
+    if (term.function != planner::WindowFunctionType::ROW_NUMBER &&
+        term.function != planner::WindowFunctionType::RANK &&
+        term.function != planner::WindowFunctionType::DENSE_RANK) {
+      ComputeAggregate(term_offset, begin, end);
+      continue;
+    }
+
+    int64_t rank = 0;
+    for (size_t row = begin; row < end; row++) {
+      // peers share the rank of the first of them
+      bool is_peer =
+          row > begin && SameValues(row - 1, row, node.GetOrderColumnIds());
+      if (term.function == planner::WindowFunctionType::ROW_NUMBER) {
+        rank = row - begin + 1;
+      } else if (term.function == planner::WindowFunctionType::RANK) {
+        rank = is_peer ? rank : row - begin + 1;
+      } else {
+        rank = is_peer ? rank : rank + 1;
+      }
+      window_values_[row][term_offset] =
+          type::ValueFactory::GetBigIntValue(rank);
+    }
+  }
+}
+
+void WindowExecutor::ComputeAggregate(oid_t term_offset, size_t begin,
+                                      size_t end) {
+  const planner::WindowPlan &node = GetPlanNode<planner::WindowPlan>();
+  auto &term = node.GetTerms()[term_offset];
+  size_t row_count = end - begin;
+
+  auto column_type = type::TypeId::INVALID;
+  if (term.column_id != INVALID_OID) {
+    column_type = output_schema_->GetType(term.column_id);
+  }
+  auto sum_type = GetSumType(column_type);
+  auto term_type = GetTermType(term, column_type);
+
+  // The leaves are the rows, every inner node combines its two children
+  std::vector<AggregateState> tree(2 * row_count);
+  for (size_t offset = 0; offset < row_count; offset++) {
+    auto &leaf = tree[row_count + offset];
+    if (term.column_id == INVALID_OID) {
+      leaf.count = 1;
+      continue;
+    }
+    auto value = GetRowValue(begin + offset, term.column_id);
+    if (value.IsNull()) {
+      continue;
+    }
+    leaf.count = 1;
+    if (term.function == planner::WindowFunctionType::SUM ||
+        term.function == planner::WindowFunctionType::AVG) {
+      leaf.sum = value.CastAs(sum_type);
+    }
+    leaf.min = value;
+    leaf.max = value;
+  }
+  for (size_t node_id = row_count; node_id-- > 1;) {
+    tree[node_id] = tree[2 * node_id];
+    Combine(tree[node_id], tree[2 * node_id + 1]);
+  }
+
+  for (size_t offset = 0; offset < row_count; offset++) {
+    // the frame of the row is [frame_begin, frame_end)
+    size_t frame_begin = (term.preceding == planner::WindowTerm::UNBOUNDED ||
+                          offset < term.preceding)
+                             ? 0
+                             : offset - term.preceding;
+    size_t frame_end = (term.following == planner::WindowTerm::UNBOUNDED ||
+                        row_count - offset <= term.following)
+                           ? row_count
+                           : offset + term.following + 1;
+
+    AggregateState state;
+    for (size_t left = frame_begin + row_count, right = frame_end + row_count;
+         left < right; left /= 2, right /= 2) {
+      if (left % 2 == 1) Combine(state, tree[left++]);
+      if (right % 2 == 1) Combine(state, tree[--right]);
+    }
+
+    type::Value result;
+    if (term.function == planner::WindowFunctionType::COUNT) {
+      result = type::ValueFactory::GetBigIntValue(state.count);
+    } else if (state.count == 0) {
+      result = type::ValueFactory::GetNullValueByType(term_type);
+    } else if (term.function == planner::WindowFunctionType::SUM) {
+      result = state.sum;
+    } else if (term.function == planner::WindowFunctionType::AVG) {
+      result = state.sum.CastAs(type::TypeId::DECIMAL)
+                   .Divide(type::ValueFactory::GetDecimalValue(state.count));
+    } else if (term.function == planner::WindowFunctionType::MIN) {
+      result = state.min;
+    } else {
+      result = state.max;
+    }
+    window_values_[begin + offset][term_offset] = result;
+  }
+}
+
+void WindowExecutor::Combine(AggregateState &state,
+                             const AggregateState &other) {
+  if (other.count == 0) {
+    return;
+  }
+  if (state.count == 0) {
+    state = other;
+    return;
+  }
+
+  state.count += other.count;
+  if (other.sum.GetTypeId() != type::TypeId::INVALID) {
+    state.sum = state.sum.Add(other.sum);
+  }
+  if (other.min.GetTypeId() != type::TypeId::INVALID) {
+    if (other.min.CompareLessThan(state.min) == type::CMP_TRUE) {
+      state.min = other.min;
+    }
+    if (other.max.CompareGreaterThan(state.max) == type::CMP_TRUE) {
+      state.max = other.max;
+    }
+  }
+}
+
+bool WindowExecutor::SameValues(size_t row_a, size_t row_b,
+                                const std::vector<oid_t> &column_ids) const {
+  for (auto column_id : column_ids) {
+    auto value_a = GetRowValue(row_a, column_id);
+    auto value_b = GetRowValue(row_b, column_id);
+
+    // nulls fall into one partition, and are peers
+    if (value_a.IsNull() || value_b.IsNull()) {
+      if (value_a.IsNull() != value_b.IsNull()) {
+        return false;
+      }
+      continue;
+    }
+    if (value_a.CompareEquals(value_b) != type::CMP_TRUE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+type::Value WindowExecutor::GetRowValue(size_t row, oid_t column_id) const {
+  auto &location = rows_[row];
+  return input_tiles_[location.block]->GetValue(location.offset, column_id);
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunction_order.cpp
+//
+// Identification: src/expression/conjunction_order.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "expression/conjunction_order.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "expression/abstract_expression.h"
+
+namespace peloton {
+namespace expression {
+
+namespace {
+
+void CollectChain(const AbstractExpression *expr, ExpressionType type,
+                  std::vector<const AbstractExpression *> &terms) {
+  if (expr->GetExpressionType() == type && expr->GetChildrenSize() == 2) {
+    CollectChain(expr->GetChild(0), type, terms);
+    CollectChain(expr->GetChild(1), type, terms);
+    return;
+  }
+  terms.push_back(expr);
+}
+
+}  // namespace
+
+ConjunctionOrder::ConjunctionOrder(const AbstractExpression *predicate)
+    : num_terms_(0), order_(0), reordered_(false) {
+  std::vector<const AbstractExpression *> terms;
+  CollectTerms(predicate, terms);
+  PL_ASSERT(terms.size() <= kMaxTerms);
+  num_terms_ = static_cast<uint32_t>(terms.size());
+
+  uint64_t order = 0;
+  for (uint32_t term_itr = 0; term_itr < num_terms_; term_itr++) {
+    terms_[term_itr].estimated_cost = EstimateCost(terms[term_itr]);
+    terms_[term_itr].may_fail = MayFail(terms[term_itr]);
+    order |= static_cast<uint64_t>(term_itr) << (4 * term_itr);
+  }
+  order_ = order;
+
+  // A single term has nothing to reorder
+  reordered_ = num_terms_ < 2;
+}
+
+void ConjunctionOrder::CollectTerms(
+    const AbstractExpression *expr,
+    std::vector<const AbstractExpression *> &terms) {
+  terms.clear();
+  auto type = expr->GetExpressionType();
+  if ((type != ExpressionType::CONJUNCTION_AND &&
+       type != ExpressionType::CONJUNCTION_OR) ||
+      expr->GetChildrenSize() != 2) {
+    return;
+  }
+  CollectChain(expr, type, terms);
+}
+
+bool ConjunctionOrder::IsReorderable(const AbstractExpression *predicate,
+                                     uint32_t max_terms) {
+  std::vector<const AbstractExpression *> terms;
+  CollectTerms(predicate, terms);
+  return terms.size() >= 2 && terms.size() <= std::min(max_terms, kMaxTerms);
+}
+
+void ConjunctionOrder::Record(uint32_t term, uint64_t num_tuples,
+                              uint64_t num_decided, uint64_t nanos) {
+  if (IsSampling() == false) {
+    return;
+  }
+  PL_ASSERT(term < num_terms_);
+  auto &stats = terms_[term];
+  stats.num_tuples.fetch_add(num_tuples, std::memory_order_relaxed);
+  stats.num_decided.fetch_add(num_decided, std::memory_order_relaxed);
+  stats.nanos.fetch_add(nanos, std::memory_order_relaxed);
+
+  // The first term sees every tuple. The thread that finds it saw enough of
+  // them reorders the terms.
+  auto &first = terms_[GetTerm(GetOrder(), 0)];
+  if (first.num_tuples.load(std::memory_order_relaxed) < kSampleTuples) {
+    return;
+  }
+  bool expected = false;
+  if (reordered_.compare_exchange_strong(expected, true)) {
+    Reorder();
+  }
+}
+
+void ConjunctionOrder::Reorder() {
+  // The time per unit of estimated cost of the terms that were measured, to
+  // give the ones without tuples a cost in the same unit
+  uint64_t total_nanos = 0;
+  double total_cost = 0.0;
+  for (uint32_t term_itr = 0; term_itr < num_terms_; term_itr++) {
+    auto &term = terms_[term_itr];
+    total_nanos += term.nanos;
+    total_cost += term.estimated_cost * term.num_tuples;
+  }
+  double nanos_per_cost = total_nanos > 0 && total_cost > 0.0
+                              ? static_cast<double>(total_nanos) / total_cost
+                              : 1.0;
+
+  // The share of the tuples a term decides per unit of its cost. A term that
+  // saw no tuple is assumed to decide half of them.
+  std::vector<double> ranks(num_terms_);
+  for (uint32_t term_itr = 0; term_itr < num_terms_; term_itr++) {
+    auto &term = terms_[term_itr];
+    uint64_t num_tuples = term.num_tuples;
+    double decided = num_tuples > 0
+                         ? static_cast<double>(term.num_decided) / num_tuples
+                         : 0.5;
+    double cost = num_tuples > 0 && term.nanos > 0
+                      ? static_cast<double>(term.nanos) / num_tuples
+                      : term.estimated_cost * nanos_per_cost;
+    ranks[term_itr] = decided / std::max(cost, 1e-9);
+  }
+
+  std::vector<uint32_t> movable, fixed;
+  for (uint32_t term_itr = 0; term_itr < num_terms_; term_itr++) {
+    (terms_[term_itr].may_fail ? fixed : movable).push_back(term_itr);
+  }
+  std::stable_sort(movable.begin(), movable.end(),
+                   [&ranks](uint32_t left, uint32_t right) {
+                     return ranks[left] > ranks[right];
+                   });
+  movable.insert(movable.end(), fixed.begin(), fixed.end());
+
+  uint64_t order = 0;
+  for (uint32_t pos = 0; pos < num_terms_; pos++) {
+    order |= static_cast<uint64_t>(movable[pos]) << (4 * pos);
+  }
+  LOG_TRACE("Reordered the %u terms of a conjunction to %llx", num_terms_,
+            (unsigned long long)order);
+  order_.store(order, std::memory_order_release);
+}
+
+double ConjunctionOrder::EstimateCost(const AbstractExpression *expr) {
+  double cost = 1.0;
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::COMPARE_LIKE:
+    case ExpressionType::COMPARE_NOTLIKE:
+      cost += 20.0;
+      break;
+    case ExpressionType::FUNCTION:
+      cost += 10.0;
+      break;
+    default:
+      break;
+  }
+  switch (expr->GetValueType()) {
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY:
+      cost += 3.0;
+      break;
+    default:
+      break;
+  }
+  for (size_t child_itr = 0; child_itr < expr->GetChildrenSize();
+       child_itr++) {
+    cost += EstimateCost(expr->GetChild(child_itr));
+  }
+  return cost;
+}
+
+bool ConjunctionOrder::MayFail(const AbstractExpression *expr) {
+  // Arithmetic can overflow or divide by zero, and casts and functions can
+  // reject their arguments
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::VALUE_CONSTANT:
+    case ExpressionType::VALUE_PARAMETER:
+    case ExpressionType::VALUE_TUPLE:
+    case ExpressionType::VALUE_NULL:
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+    case ExpressionType::COMPARE_LIKE:
+    case ExpressionType::COMPARE_NOTLIKE:
+    case ExpressionType::COMPARE_DISTINCT_FROM:
+    case ExpressionType::OPERATOR_NOT:
+    case ExpressionType::OPERATOR_IS_NULL:
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR:
+      break;
+    default:
+      return true;
+  }
+  for (size_t child_itr = 0; child_itr < expr->GetChildrenSize();
+       child_itr++) {
+    if (MayFail(expr->GetChild(child_itr))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace expression
+}  // namespace peloton
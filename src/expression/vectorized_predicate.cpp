@@ -0,0 +1,694 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_predicate.cpp
+//
+// Identification: src/expression/vectorized_predicate.cpp
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "expression/vectorized_predicate.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "common/container_tuple.h"
+#include "executor/logical_tile.h"
+#include "expression/abstract_expression.h"
+#include "expression/conjunction_order.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/column_kernels.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "type/limits.h"
+
+namespace peloton {
+namespace expression {
+
+//===----------------------------------------------------------------------===//
+// The tuples a predicate is evaluated for
+//===----------------------------------------------------------------------===//
+struct VectorizedPredicate::Batch {
+  // Either the tile group or the logical tile of the tuples
+  storage::TileGroup *tile_group;
+  executor::LogicalTile *tile;
+
+  const oid_t *tuple_ids;
+  size_t num_tuples;
+
+  int batch_tuple_idx;
+  const AbstractTuple *other_tuple;
+  executor::ExecutorContext *context;
+
+  // Evaluate the expression for the tuple at the given position of the batch
+  type::Value EvaluateTuple(const AbstractExpression *expr, size_t pos) const {
+    if (tile_group != nullptr) {
+      ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_ids[pos]);
+      return Evaluate(expr, &tuple);
+    }
+    ContainerTuple<executor::LogicalTile> tuple(tile, tuple_ids[pos]);
+    return Evaluate(expr, &tuple);
+  }
+
+  // Evaluate an expression that does not refer to the tuples of the batch
+  type::Value EvaluateInvariant(const AbstractExpression *expr) const {
+    return Evaluate(expr, nullptr);
+  }
+
+  type::Value Evaluate(const AbstractExpression *expr,
+                       const AbstractTuple *tuple) const {
+    if (batch_tuple_idx == 0) {
+      return expr->Evaluate(tuple, other_tuple, context);
+    }
+    return expr->Evaluate(other_tuple, tuple, context);
+  }
+};
+
+//===----------------------------------------------------------------------===//
+// A node of the predicate. It evaluates its expression for the tuples at the
+// selected positions of the batch, and stores the results at the same
+// positions.
+//===----------------------------------------------------------------------===//
+class VectorizedPredicate::Node {
+ public:
+  virtual ~Node() {}
+
+  virtual void Evaluate(const Batch &batch,
+                        const std::vector<uint32_t> &selection,
+                        type::CmpBool *results) const = 0;
+
+  virtual bool IsVectorized() const = 0;
+};
+
+namespace {
+
+type::CmpBool ToCmpBool(const type::Value &value) {
+  if (value.IsNull()) {
+    return type::CMP_NULL;
+  }
+  return value.IsTrue() ? type::CMP_TRUE : type::CMP_FALSE;
+}
+
+bool IsNumeric(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Whether the expression is the same for all tuples of the batch. Functions
+// are not, since they need not return the same value every time.
+bool IsInvariant(const AbstractExpression *expr, int batch_tuple_idx) {
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::VALUE_CONSTANT:
+    case ExpressionType::VALUE_PARAMETER:
+      return true;
+    case ExpressionType::VALUE_TUPLE:
+      return static_cast<const TupleValueExpression *>(expr)->GetTupleId() !=
+             batch_tuple_idx;
+    case ExpressionType::OPERATOR_PLUS:
+    case ExpressionType::OPERATOR_MINUS:
+    case ExpressionType::OPERATOR_MULTIPLY:
+    case ExpressionType::OPERATOR_DIVIDE:
+    case ExpressionType::OPERATOR_MOD:
+    case ExpressionType::OPERATOR_UNARY_MINUS:
+      for (size_t i = 0; i < expr->GetChildrenSize(); i++) {
+        if (!IsInvariant(expr->GetChild(i), batch_tuple_idx)) {
+          return false;
+        }
+      }
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Whether the expression is a column of the tuples of the batch
+bool IsBatchColumn(const AbstractExpression *expr, int batch_tuple_idx) {
+  return expr->GetExpressionType() == ExpressionType::VALUE_TUPLE &&
+         static_cast<const TupleValueExpression *>(expr)->GetTupleId() ==
+             batch_tuple_idx;
+}
+
+//===----------------------------------------------------------------------===//
+// Evaluates any expression one tuple at a time
+//===----------------------------------------------------------------------===//
+class TupleAtATimeNode : public VectorizedPredicate::Node {
+ public:
+  explicit TupleAtATimeNode(const AbstractExpression *expr) : expr_(expr) {}
+
+  void Evaluate(const VectorizedPredicate::Batch &batch,
+                const std::vector<uint32_t> &selection,
+                type::CmpBool *results) const override {
+    for (uint32_t pos : selection) {
+      results[pos] = ToCmpBool(batch.EvaluateTuple(expr_, pos));
+    }
+  }
+
+  bool IsVectorized() const override { return false; }
+
+ private:
+  const AbstractExpression *expr_;
+};
+
+//===----------------------------------------------------------------------===//
+// Evaluates AND and OR. The right side is only evaluated for the tuples the
+// left side does not decide the result of.
+//===----------------------------------------------------------------------===//
+class ConjunctionNode : public VectorizedPredicate::Node {
+ public:
+  ConjunctionNode(bool is_and, std::unique_ptr<Node> left,
+                  std::unique_ptr<Node> right)
+      : is_and_(is_and), left_(std::move(left)), right_(std::move(right)) {}
+
+  void Evaluate(const VectorizedPredicate::Batch &batch,
+                const std::vector<uint32_t> &selection,
+                type::CmpBool *results) const override {
+    left_->Evaluate(batch, selection, results);
+
+    const type::CmpBool decided = is_and_ ? type::CMP_FALSE : type::CMP_TRUE;
+    std::vector<uint32_t> undecided;
+    for (uint32_t pos : selection) {
+      if (results[pos] != decided) {
+        undecided.push_back(pos);
+      }
+    }
+    if (undecided.empty()) {
+      return;
+    }
+
+    std::vector<type::CmpBool> right_results(batch.num_tuples);
+    right_->Evaluate(batch, undecided, right_results.data());
+    for (uint32_t pos : undecided) {
+      // The left side is either NULL or the opposite of the decided result
+      if (right_results[pos] == decided) {
+        results[pos] = decided;
+      } else if (right_results[pos] == type::CMP_NULL) {
+        results[pos] = type::CMP_NULL;
+      }
+    }
+  }
+
+  bool IsVectorized() const override {
+    return left_->IsVectorized() || right_->IsVectorized();
+  }
+
+ private:
+  bool is_and_;
+
+  std::unique_ptr<Node> left_;
+
+  std::unique_ptr<Node> right_;
+};
+
+//===----------------------------------------------------------------------===//
+// Evaluates a chain of ANDs, or of ORs, term by term in the order of its
+// ConjunctionOrder. Every term is only evaluated for the tuples the terms
+// before it did not decide the result of, and what the terms decide and the
+// time they take is recorded while the order is sampled.
+//===----------------------------------------------------------------------===//
+class AdaptiveConjunctionNode : public VectorizedPredicate::Node {
+ public:
+  AdaptiveConjunctionNode(const AbstractExpression *expr,
+                          std::vector<std::unique_ptr<Node>> terms)
+      : is_and_(expr->GetExpressionType() ==
+                ExpressionType::CONJUNCTION_AND),
+        terms_(std::move(terms)),
+        order_(new ConjunctionOrder(expr)) {
+    PL_ASSERT(terms_.size() == order_->GetTermCount());
+  }
+
+  void Evaluate(const VectorizedPredicate::Batch &batch,
+                const std::vector<uint32_t> &selection,
+                type::CmpBool *results) const override {
+    const type::CmpBool decided = is_and_ ? type::CMP_FALSE : type::CMP_TRUE;
+    const type::CmpBool not_decided =
+        is_and_ ? type::CMP_TRUE : type::CMP_FALSE;
+    for (uint32_t pos : selection) {
+      results[pos] = not_decided;
+    }
+
+    // The whole batch is evaluated in the same order
+    uint64_t order = order_->GetOrder();
+    std::vector<uint32_t> undecided = selection, remaining;
+    std::vector<type::CmpBool> term_results(batch.num_tuples);
+    for (uint32_t pos = 0; pos < terms_.size() && !undecided.empty(); pos++) {
+      uint32_t term = ConjunctionOrder::GetTerm(order, pos);
+      bool is_sampling = order_->IsSampling();
+      auto start = is_sampling ? std::chrono::steady_clock::now()
+                               : std::chrono::steady_clock::time_point();
+      terms_[term]->Evaluate(batch, undecided, term_results.data());
+
+      remaining.clear();
+      for (uint32_t tuple_pos : undecided) {
+        if (term_results[tuple_pos] == decided) {
+          results[tuple_pos] = decided;
+          continue;
+        }
+        if (term_results[tuple_pos] == type::CMP_NULL) {
+          results[tuple_pos] = type::CMP_NULL;
+        }
+        remaining.push_back(tuple_pos);
+      }
+
+      if (is_sampling) {
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+        order_->Record(term, undecided.size(),
+                       undecided.size() - remaining.size(), nanos);
+      }
+      undecided.swap(remaining);
+    }
+  }
+
+  bool IsVectorized() const override {
+    for (const auto &term : terms_) {
+      if (term->IsVectorized()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  bool is_and_;
+
+  std::vector<std::unique_ptr<Node>> terms_;
+
+  // Shared by the threads evaluating the predicate
+  std::unique_ptr<ConjunctionOrder> order_;
+};
+
+//===----------------------------------------------------------------------===//
+// Compares numeric columns of the batch with each other or with invariant
+// values. Everything is compared as BIGINT, or as DECIMAL if either side is
+// one, which is what the comparisons of the values do too. Comparisons with
+// invariants are left to the ColumnKernels.
+//===----------------------------------------------------------------------===//
+class ComparisonNode : public VectorizedPredicate::Node {
+ public:
+  ComparisonNode(const AbstractExpression *expr, int batch_tuple_idx)
+      : expr_(expr), fallback_(expr) {
+    for (size_t i = 0; i < 2; i++) {
+      const auto *child = expr->GetChild(i);
+      operands_[i].expr = child;
+      operands_[i].is_column = IsBatchColumn(child, batch_tuple_idx);
+      if (operands_[i].is_column) {
+        operands_[i].column_id =
+            static_cast<const TupleValueExpression *>(child)->GetColumnId();
+      }
+    }
+  }
+
+  void Evaluate(const VectorizedPredicate::Batch &batch,
+                const std::vector<uint32_t> &selection,
+                type::CmpBool *results) const override {
+    // Look the columns up once for the whole batch
+    BoundOperand bound[2];
+    bool is_decimal = false;
+    for (size_t i = 0; i < 2; i++) {
+      if (!Bind(batch, operands_[i], bound[i])) {
+        fallback_.Evaluate(batch, selection, results);
+        return;
+      }
+      if (bound[i].is_null) {
+        for (uint32_t pos : selection) {
+          results[pos] = type::CMP_NULL;
+        }
+        return;
+      }
+      is_decimal = is_decimal || bound[i].type_id == type::TypeId::DECIMAL;
+    }
+
+    // A column compared with an invariant is compared by the kernel of its
+    // type, on the memory of its tile
+    if (bound[0].tile != nullptr && bound[1].tile == nullptr) {
+      CompareWithInvariant(batch, selection, bound[0],
+                           expr_->GetExpressionType(), bound[1].value,
+                           results);
+      return;
+    }
+    if (bound[0].tile == nullptr && bound[1].tile != nullptr) {
+      CompareWithInvariant(batch, selection, bound[1],
+                           Commute(expr_->GetExpressionType()),
+                           bound[0].value, results);
+      return;
+    }
+
+    if (is_decimal) {
+      Compare<double>(batch, selection, bound, results);
+    } else {
+      Compare<int64_t>(batch, selection, bound, results);
+    }
+  }
+
+  bool IsVectorized() const override { return true; }
+
+ private:
+  struct Operand {
+    const AbstractExpression *expr;
+    bool is_column;
+    oid_t column_id;
+  };
+
+  // An operand resolved for a batch
+  struct BoundOperand {
+    type::TypeId type_id;
+
+    // The base tile, offset and position list of a column. Columns of tile
+    // groups have no position list.
+    const storage::Tile *tile = nullptr;
+    oid_t column_id = INVALID_OID;
+    size_t offset = 0;
+    const std::vector<oid_t> *position_list = nullptr;
+
+    // The value of an invariant
+    type::Value value;
+    bool is_null = false;
+  };
+
+  static bool Bind(const VectorizedPredicate::Batch &batch,
+                   const Operand &operand, BoundOperand &bound) {
+    if (!operand.is_column) {
+      bound.value = batch.EvaluateInvariant(operand.expr);
+      bound.type_id = bound.value.GetTypeId();
+      bound.is_null = bound.value.IsNull();
+      return IsNumeric(bound.type_id) || bound.is_null;
+    }
+
+    oid_t tile_column_id;
+    if (batch.tile_group != nullptr) {
+      oid_t tile_offset;
+      batch.tile_group->LocateTileAndColumn(operand.column_id, tile_offset,
+                                            tile_column_id);
+      bound.tile = batch.tile_group->GetTile(tile_offset);
+    } else {
+      const auto &column_info = batch.tile->GetColumnInfo(operand.column_id);
+      bound.tile = column_info.base_tile.get();
+      tile_column_id = column_info.origin_column_id;
+      bound.position_list =
+          &batch.tile->GetPositionList(column_info.position_list_idx);
+    }
+    const auto *schema = bound.tile->GetSchema();
+    bound.column_id = tile_column_id;
+    bound.type_id = schema->GetType(tile_column_id);
+    bound.offset = schema->GetOffset(tile_column_id);
+    return IsNumeric(bound.type_id);
+  }
+
+  // The comparison with the operands swapped
+  static ExpressionType Commute(ExpressionType compare_type) {
+    switch (compare_type) {
+      case ExpressionType::COMPARE_LESSTHAN:
+        return ExpressionType::COMPARE_GREATERTHAN;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        return ExpressionType::COMPARE_LESSTHAN;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+      default:
+        return compare_type;
+    }
+  }
+
+  static void CompareWithInvariant(const VectorizedPredicate::Batch &batch,
+                                   const std::vector<uint32_t> &selection,
+                                   const BoundOperand &column,
+                                   ExpressionType compare_type,
+                                   const type::Value &invariant,
+                                   type::CmpBool *results) {
+    std::vector<oid_t> tuple_ids;
+    std::vector<uint32_t> positions;
+    tuple_ids.reserve(selection.size());
+    positions.reserve(selection.size());
+    for (uint32_t pos : selection) {
+      oid_t tuple_id = batch.tuple_ids[pos];
+      if (column.position_list != nullptr) {
+        tuple_id = (*column.position_list)[tuple_id];
+      }
+      if (tuple_id == NULL_OID) {
+        results[pos] = type::CMP_NULL;
+        continue;
+      }
+      tuple_ids.push_back(tuple_id);
+      positions.push_back(pos);
+    }
+
+    std::vector<type::CmpBool> column_results(tuple_ids.size());
+    storage::ColumnKernels::Compare(
+        storage::TileColumn(column.tile, column.column_id), compare_type,
+        invariant, tuple_ids.data(), tuple_ids.size(), column_results.data());
+    for (size_t i = 0; i < positions.size(); i++) {
+      results[positions[i]] = column_results[i];
+    }
+  }
+
+  template <typename T, typename Stored>
+  static void LoadColumn(const VectorizedPredicate::Batch &batch,
+                         const std::vector<uint32_t> &selection,
+                         const BoundOperand &bound, Stored null_value,
+                         T *values, bool *nulls) {
+    for (uint32_t pos : selection) {
+      oid_t tuple_id = batch.tuple_ids[pos];
+      if (bound.position_list != nullptr) {
+        tuple_id = (*bound.position_list)[tuple_id];
+      }
+      if (tuple_id == NULL_OID) {
+        nulls[pos] = true;
+        continue;
+      }
+      Stored stored;
+      const char *data = bound.tile->GetTupleLocation(tuple_id) + bound.offset;
+      std::memcpy(&stored, data, sizeof(stored));
+      nulls[pos] = stored == null_value;
+      values[pos] = static_cast<T>(stored);
+    }
+  }
+
+  template <typename T>
+  static void Load(const VectorizedPredicate::Batch &batch,
+                   const std::vector<uint32_t> &selection,
+                   const BoundOperand &bound, std::vector<T> &values,
+                   std::unique_ptr<bool[]> &nulls) {
+    if (bound.tile == nullptr) {
+      // Invariants are broadcast over the batch
+      type::TypeId type_id = std::is_same<T, double>::value
+                                 ? type::TypeId::DECIMAL
+                                 : type::TypeId::BIGINT;
+      values.assign(1, bound.value.CastAs(type_id).GetAs<T>());
+      return;
+    }
+
+    values.resize(batch.num_tuples);
+    nulls.reset(new bool[batch.num_tuples]);
+    switch (bound.type_id) {
+      case type::TypeId::TINYINT:
+        LoadColumn<T, int8_t>(batch, selection, bound, type::PELOTON_INT8_NULL,
+                              values.data(), nulls.get());
+        break;
+      case type::TypeId::SMALLINT:
+        LoadColumn<T, int16_t>(batch, selection, bound,
+                               type::PELOTON_INT16_NULL, values.data(),
+                               nulls.get());
+        break;
+      case type::TypeId::INTEGER:
+        LoadColumn<T, int32_t>(batch, selection, bound,
+                               type::PELOTON_INT32_NULL, values.data(),
+                               nulls.get());
+        break;
+      case type::TypeId::BIGINT:
+        LoadColumn<T, int64_t>(batch, selection, bound,
+                               type::PELOTON_INT64_NULL, values.data(),
+                               nulls.get());
+        break;
+      case type::TypeId::DECIMAL:
+        LoadColumn<T, double>(batch, selection, bound,
+                              type::PELOTON_DECIMAL_NULL, values.data(),
+                              nulls.get());
+        break;
+      default:
+        PL_ASSERT(false);
+    }
+  }
+
+  template <typename T>
+  void Compare(const VectorizedPredicate::Batch &batch,
+               const std::vector<uint32_t> &selection,
+               const BoundOperand *bound, type::CmpBool *results) const {
+    std::vector<T> left, right;
+    std::unique_ptr<bool[]> left_nulls, right_nulls;
+    Load<T>(batch, selection, bound[0], left, left_nulls);
+    Load<T>(batch, selection, bound[1], right, right_nulls);
+
+    switch (expr_->GetExpressionType()) {
+      case ExpressionType::COMPARE_EQUAL:
+        Apply(selection, left, left_nulls, right, right_nulls, results,
+              [](T l, T r) { return l == r; });
+        break;
+      case ExpressionType::COMPARE_NOTEQUAL:
+        Apply(selection, left, left_nulls, right, right_nulls, results,
+              [](T l, T r) { return l != r; });
+        break;
+      case ExpressionType::COMPARE_LESSTHAN:
+        Apply(selection, left, left_nulls, right, right_nulls, results,
+              [](T l, T r) { return l < r; });
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        Apply(selection, left, left_nulls, right, right_nulls, results,
+              [](T l, T r) { return l > r; });
+        break;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        Apply(selection, left, left_nulls, right, right_nulls, results,
+              [](T l, T r) { return l <= r; });
+        break;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        Apply(selection, left, left_nulls, right, right_nulls, results,
+              [](T l, T r) { return l >= r; });
+        break;
+      default:
+        fallback_.Evaluate(batch, selection, results);
+    }
+  }
+
+  // The comparison loop, specialized for the type and the operator. An
+  // operand without NULL flags is an invariant with a single value.
+  template <typename T, typename Op>
+  static void Apply(const std::vector<uint32_t> &selection,
+                    const std::vector<T> &left,
+                    const std::unique_ptr<bool[]> &left_nulls,
+                    const std::vector<T> &right,
+                    const std::unique_ptr<bool[]> &right_nulls,
+                    type::CmpBool *results, Op op) {
+    const bool left_column = left_nulls != nullptr;
+    const bool right_column = right_nulls != nullptr;
+    for (uint32_t pos : selection) {
+      size_t left_pos = left_column ? pos : 0;
+      size_t right_pos = right_column ? pos : 0;
+      if ((left_column && left_nulls[pos]) ||
+          (right_column && right_nulls[pos])) {
+        results[pos] = type::CMP_NULL;
+      } else {
+        results[pos] = op(left[left_pos], right[right_pos]) ? type::CMP_TRUE
+                                                            : type::CMP_FALSE;
+      }
+    }
+  }
+
+  const AbstractExpression *expr_;
+
+  Operand operands_[2];
+
+  // Evaluates comparisons of operands that are not numeric
+  TupleAtATimeNode fallback_;
+};
+
+std::unique_ptr<VectorizedPredicate::Node> Compile(
+    const AbstractExpression *expr, int batch_tuple_idx) {
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND:
+    case ExpressionType::CONJUNCTION_OR:
+      if (ConjunctionOrder::IsReorderable(expr)) {
+        std::vector<const AbstractExpression *> terms;
+        ConjunctionOrder::CollectTerms(expr, terms);
+        std::vector<std::unique_ptr<VectorizedPredicate::Node>> nodes;
+        for (const auto *term : terms) {
+          nodes.push_back(Compile(term, batch_tuple_idx));
+        }
+        return std::unique_ptr<VectorizedPredicate::Node>(
+            new AdaptiveConjunctionNode(expr, std::move(nodes)));
+      }
+      if (expr->GetChildrenSize() == 2) {
+        return std::unique_ptr<VectorizedPredicate::Node>(new ConjunctionNode(
+            expr->GetExpressionType() == ExpressionType::CONJUNCTION_AND,
+            Compile(expr->GetChild(0), batch_tuple_idx),
+            Compile(expr->GetChild(1), batch_tuple_idx)));
+      }
+      break;
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO: {
+      if (expr->GetChildrenSize() != 2) {
+        break;
+      }
+      // At least one side is a column, the other one is a column or the same
+      // for the whole batch
+      const auto *left = expr->GetChild(0);
+      const auto *right = expr->GetChild(1);
+      bool left_column = IsBatchColumn(left, batch_tuple_idx);
+      bool right_column = IsBatchColumn(right, batch_tuple_idx);
+      if ((left_column && (right_column ||
+                           IsInvariant(right, batch_tuple_idx))) ||
+          (right_column && IsInvariant(left, batch_tuple_idx))) {
+        return std::unique_ptr<VectorizedPredicate::Node>(
+            new ComparisonNode(expr, batch_tuple_idx));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return std::unique_ptr<VectorizedPredicate::Node>(new TupleAtATimeNode(expr));
+}
+
+}  // namespace
+
+VectorizedPredicate::VectorizedPredicate(const AbstractExpression *predicate,
+                                         int batch_tuple_idx)
+    : batch_tuple_idx_(batch_tuple_idx),
+      root_(Compile(predicate, batch_tuple_idx)) {}
+
+VectorizedPredicate::~VectorizedPredicate() {}
+
+void VectorizedPredicate::Evaluate(storage::TileGroup *tile_group,
+                                   const oid_t *tuple_ids, size_t num_tuples,
+                                   const AbstractTuple *other_tuple,
+                                   executor::ExecutorContext *context,
+                                   std::vector<type::CmpBool> &results) const {
+  Batch batch{tile_group, nullptr,          tuple_ids, num_tuples,
+              batch_tuple_idx_, other_tuple, context};
+  Evaluate(batch, results);
+}
+
+void VectorizedPredicate::Evaluate(executor::LogicalTile *tile,
+                                   const oid_t *tuple_ids, size_t num_tuples,
+                                   const AbstractTuple *other_tuple,
+                                   executor::ExecutorContext *context,
+                                   std::vector<type::CmpBool> &results) const {
+  Batch batch{nullptr,          tile,        tuple_ids, num_tuples,
+              batch_tuple_idx_, other_tuple, context};
+  Evaluate(batch, results);
+}
+
+void VectorizedPredicate::Evaluate(const Batch &batch,
+                                   std::vector<type::CmpBool> &results) const {
+  std::vector<uint32_t> selection(batch.num_tuples);
+  for (size_t pos = 0; pos < batch.num_tuples; pos++) {
+    selection[pos] = pos;
+  }
+  results.resize(batch.num_tuples);
+  root_->Evaluate(batch, selection, results.data());
+}
+
+bool VectorizedPredicate::IsVectorized() const {
+  return root_->IsVectorized();
+}
+
+}  // namespace expression
+}  // namespace peloton
@@ -12,13 +12,17 @@
 
 #include "gc/transaction_level_gc_manager.h"
 
+#include <algorithm>
+
 #include "storage/tuple.h"
 #include "storage/database.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "catalog/manager.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "concurrency/epoch_manager_factory.h"
 #include "common/container_tuple.h"
+#include "common/maintenance_scheduler.h"
 
 namespace peloton {
 namespace gc {
@@ -60,17 +64,48 @@ void TransactionLevelGCManager::Running(const int &thread_id) {
       continue;
     }
 
+    auto work_start = std::chrono::steady_clock::now();
+
     int reclaimed_count = Reclaim(thread_id, expired_eid);
 
     int unlinked_count = Unlink(thread_id, expired_eid);
 
+    // the GC shares the budget of the background tasks, without pausing
+    if (reclaimed_count != 0 || unlinked_count != 0) {
+      MaintenanceScheduler::GetInstance().RecordWork(
+          MaintenanceTask::GC,
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - work_start).count());
+    }
+
+    size_t held_garbage_count = local_unlink_queues_[thread_id].size();
+    for (auto &bucket : reclaim_queues_[thread_id]) {
+      held_garbage_count += bucket.garbages_.size();
+    }
+    held_garbage_counts_[thread_id].store(held_garbage_count,
+                                          std::memory_order_relaxed);
+
+    // the dropped tables and tile groups that no later drop has released
+    if (thread_id == 0) {
+      catalog::Manager::GetInstance().ReleaseRetiredTables(expired_eid);
+      catalog::Manager::GetInstance().ReleaseRetiredTileGroups(expired_eid);
+    }
+
     if (is_running_ == false) {
       return;
     }
+
+    // garbage is arriving faster than this thread unlinks it
+    if (HasQueuedGarbage(thread_id) == true) {
+      AddActiveThread();
+    }
+
     if (reclaimed_count == 0 && unlinked_count == 0) {
       // sleep at most 0.8192 s
       if (backoff_shifts < 13) {
         ++backoff_shifts;
+      } else {
+        RemoveActiveThread(thread_id);
       }
       uint64_t sleep_duration = 1UL << backoff_shifts;
       sleep_duration *= 100;
@@ -86,8 +121,51 @@ void TransactionLevelGCManager::RecycleTransaction(std::shared_ptr<GCSet> gc_set
                                                    const eid_t &epoch_id, 
                                                    const size_t &thread_id) {
   // Add the garbage context to the lock-free queue
-  std::shared_ptr<GarbageContext> gc_context(new GarbageContext(gc_set, epoch_id));
-  unlink_queues_[HashToThread(thread_id)]->Enqueue(gc_context);
+  std::shared_ptr<GarbageContext> gc_context(
+      new GarbageContext(std::move(gc_set), epoch_id));
+  auto gc_thread_id = HashToThread(thread_id);
+  if (unlink_queues_[gc_thread_id]->Enqueue(std::move(gc_context)) == false) {
+    // the gc thread is far behind. never drop garbage.
+    overflow_unlink_queues_[gc_thread_id]->Enqueue(gc_context);
+  }
+}
+
+bool TransactionLevelGCManager::DequeueGarbage(
+    const int &thread_id, std::shared_ptr<GarbageContext> &garbage_ctx) {
+  return unlink_queues_[thread_id]->Dequeue(garbage_ctx) == true ||
+         overflow_unlink_queues_[thread_id]->Dequeue(garbage_ctx) == true;
+}
+
+void TransactionLevelGCManager::AddActiveThread() {
+  int active_thread_count = active_thread_count_.load();
+  while (active_thread_count < gc_thread_count_) {
+    if (active_thread_count_.compare_exchange_weak(active_thread_count,
+                                                   active_thread_count + 1)) {
+      LOG_TRACE("%d gc threads are active", active_thread_count + 1);
+      return;
+    }
+  }
+}
+
+void TransactionLevelGCManager::RemoveActiveThread(const int &thread_id) {
+  // the first thread always stays active. the garbage already hashed to a
+  // removed thread is still unlinked by it.
+  int active_thread_count = thread_id + 1;
+  if (thread_id > 0 &&
+      active_thread_count_.compare_exchange_strong(active_thread_count,
+                                                   thread_id)) {
+    LOG_TRACE("%d gc threads are active", thread_id);
+  }
+}
+
+size_t TransactionLevelGCManager::GetBacklog() {
+  // the garbage in the overflow queues is not counted
+  size_t backlog = 0;
+  for (int i = 0; i < gc_thread_count_; ++i) {
+    backlog += unlink_queues_[i]->GetApproximateSize() +
+               held_garbage_counts_[i].load(std::memory_order_relaxed);
+  }
+  return backlog;
 }
 
 int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired_eid) {
@@ -104,8 +182,6 @@ int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired
         (const std::shared_ptr<GarbageContext>& garbage_ctx) -> bool {
       bool res = garbage_ctx->epoch_id_ <= expired_eid;
       if (res == true) {
-        // TODO: carefully think about how to delete tuple from indexes!
-        // DeleteFromIndexes(garbage_ctx);
         // Add to the garbage map
         garbages.push_back(garbage_ctx);
         tuple_counter++;
@@ -117,7 +193,7 @@ int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired
   for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
     std::shared_ptr<GarbageContext> garbage_ctx;
     // if there's no more tuples in the queue, then break.
-    if (unlink_queues_[thread_id]->Dequeue(garbage_ctx) == false) {
+    if (DequeueGarbage(thread_id, garbage_ctx) == false) {
       break;
     }
 
@@ -126,9 +202,7 @@ int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired
       // as the global expired epoch id is no less than the garbage version's epoch id,
       // it means that no active transactions can read the version.
       // As a result, we can delete all the tuples from the indexes to which it belongs.
-      
-      // TODO: carefully think about how to delete tuple from indexes!
-      // DeleteFromIndexes(garbage_ctx);
+
       // Add to the garbage map
       garbages.push_back(garbage_ctx);
       tuple_counter++;
@@ -144,9 +218,26 @@ int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired
   // at that time point, it is safe to recycle the version.
   eid_t safe_expired_eid = concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
 
-  for(auto& item : garbages){
-      reclaim_maps_[thread_id].insert(std::make_pair(safe_expired_eid, item));
+  if (garbages.empty() == true) {
+    return 0;
   }
+
+  // no active transaction can read the deleted tuples, so their index
+  // entries can go. readers that have already looked up an entry are
+  // done once the indirection is released together with the garbage.
+  DeleteFromIndexes(garbages);
+
+  auto &reclaim_queue = reclaim_queues_[thread_id];
+  if (reclaim_queue.empty() == true ||
+      reclaim_queue.back().epoch_id_ != safe_expired_eid) {
+    PL_ASSERT(reclaim_queue.empty() == true ||
+              reclaim_queue.back().epoch_id_ < safe_expired_eid);
+    reclaim_queue.emplace_back(safe_expired_eid);
+  }
+  auto &reclaim_bucket = reclaim_queue.back().garbages_;
+  reclaim_bucket.insert(reclaim_bucket.end(), garbages.begin(),
+                        garbages.end());
+
   LOG_TRACE("Marked %d tuples as garbage", tuple_counter);
   return tuple_counter;
 }
@@ -155,24 +246,17 @@ int TransactionLevelGCManager::Unlink(const int &thread_id, const eid_t &expired
 int TransactionLevelGCManager::Reclaim(const int &thread_id, const eid_t &expired_eid) {
   int gc_counter = 0;
 
-  // we delete garbage in the free list
-  auto garbage_ctx_entry = reclaim_maps_[thread_id].begin();
-  while (garbage_ctx_entry != reclaim_maps_[thread_id].end()) {
-    const eid_t garbage_eid = garbage_ctx_entry->first;
-    auto garbage_ctx = garbage_ctx_entry->second;
-
-    // if the global expired epoch id is no less than the garbage version's epoch id,
-    // then recycle the garbage version
-    if (garbage_eid <= expired_eid) {
+  // we delete garbage in the free list. the buckets are in epoch order.
+  auto &reclaim_queue = reclaim_queues_[thread_id];
+  while (reclaim_queue.empty() == false &&
+         reclaim_queue.front().epoch_id_ <= expired_eid) {
+    // the global expired epoch id is no less than the garbage version's
+    // epoch id, so recycle the garbage versions
+    for (auto &garbage_ctx : reclaim_queue.front().garbages_) {
       AddToRecycleMap(garbage_ctx);
-
-      // Remove from the original map
-      garbage_ctx_entry = reclaim_maps_[thread_id].erase(garbage_ctx_entry);
       gc_counter++;
-    } else {
-      // Early break since we use an ordered map
-      break;
     }
+    reclaim_queue.pop_front();
   }
   LOG_TRACE("Marked %d txn contexts as recycled", gc_counter);
   return gc_counter;
@@ -181,39 +265,97 @@ int TransactionLevelGCManager::Reclaim(const int &thread_id, const eid_t &expire
 // Multiple GC thread share the same recycle map
 void TransactionLevelGCManager::AddToRecycleMap(
     std::shared_ptr<GarbageContext> garbage_ctx) {
+  ReleaseIndirections(garbage_ctx);
+
+  auto &manager = catalog::Manager::GetInstance();
+
+  // the gc set is flat. consecutive entries often share a tile group.
+  oid_t tile_group_id = INVALID_OID;
+  oid_t table_id = INVALID_OID;
+  storage::DataTable *table = nullptr;
+  std::shared_ptr<storage::TileGroup> tile_group;
+  storage::TileGroupHeader *tile_group_header = nullptr;
+  size_t reset_count = 0;
+
   for (auto &entry : *(garbage_ctx->gc_set_.get())) {
-    auto &manager = catalog::Manager::GetInstance();
-    auto tile_group = manager.GetTileGroup(entry.first);
+    // as this transaction has been committed, we should reclaim older
+    // versions.
+    ItemPointer location = entry.first;
 
-    // During the resetting, a table may be deconstructed because of the DROP
-    // TABLE request
-    if (tile_group == nullptr) {
-      return;
-    }
+    if (location.block != tile_group_id) {
+      tile_group = manager.GetTileGroup(location.block);
 
-    PL_ASSERT(tile_group != nullptr);
+      // During the resetting, a table may be deconstructed because of the DROP
+      // TABLE request
+      if (tile_group == nullptr) {
+        break;
+      }
 
-    storage::DataTable *table =
-        dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
-    PL_ASSERT(table != nullptr);
+      table =
+          dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+      PL_ASSERT(table != nullptr);
 
-    oid_t table_id = table->GetOid();
+      tile_group_id = location.block;
+      table_id = table->GetOid();
+      tile_group_header = tile_group->GetHeader();
+    }
 
-    for (auto &element : entry.second) {
-      // as this transaction has been committed, we should reclaim older
-      // versions.
-      ItemPointer location(entry.first, element.first);
+    // the whole tile group was deleted
+    if (location.offset == INVALID_OID) {
+      reset_count += RecycleDeletedTileGroup(table, tile_group.get());
+      continue;
+    }
 
-      // If the tuple being reset no longer exists, just skip it
-      if (ResetTuple(location) == false) {
-        continue;
-      }
-      // if the entry for table_id exists.
-      if (recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
-        recycle_queue_map_[table_id]->Enqueue(location);
+    // If the tuple being reset no longer exists, just skip it
+    if (ResetTuple(location) == false) {
+      continue;
+    }
+    reset_count++;
+    // if the entry for table_id exists.
+    if (recycle_queue_map_.find(table_id) != recycle_queue_map_.end()) {
+      // only announce the tile group when its first slot is recycled.
+      // retired tile groups are drained by the compactor instead.
+      if (tile_group_header->RecycleTupleSlot(location.offset) == true &&
+          tile_group_header->IsRetired() == false) {
+        recycle_queue_map_[table_id]->Enqueue(tile_group_id);
       }
     }
   }
+  reclaimed_version_count_.fetch_add(reset_count, std::memory_order_relaxed);
+}
+
+size_t TransactionLevelGCManager::RecycleDeletedTileGroup(
+    storage::DataTable *table, storage::TileGroup *tile_group) {
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+
+  // the tile group is retired before the delete is finished, so that its
+  // slots are never handed out. the compactor moves the tuples inserted
+  // after the delete, if any, and drops the tile group then.
+  tile_group_header->Retire();
+
+  bool recycle =
+      recycle_queue_map_.find(table->GetOid()) != recycle_queue_map_.end();
+  size_t reset_count = 0;
+  oid_t slot_count = tile_group_header->GetCurrentNextTupleSlot();
+  for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+    if (tile_group_header->IsDeletedSlot(tuple_slot) == false) {
+      continue;
+    }
+    ResetTuple(ItemPointer(tile_group_id, tuple_slot));
+    if (recycle == true) {
+      tile_group_header->RecycleTupleSlot(tuple_slot);
+    }
+    reset_count++;
+  }
+  tile_group_header->FinishDelete();
+
+  // every slot has been recycled, so no version chain can lead here
+  if (tile_group_header->GetRecycledTupleSlotCount() ==
+      tile_group->GetAllocatedTupleCount()) {
+    table->DropTileGroup(tile_group_id);
+  }
+  return reset_count;
 }
 
 // this function returns a free tuple slot, if one exists
@@ -223,122 +365,224 @@ ItemPointer TransactionLevelGCManager::ReturnFreeSlot(const oid_t &table_id) {
   if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
     return INVALID_ITEMPOINTER;
   }
-  ItemPointer location;
   PL_ASSERT(recycle_queue_map_.find(table_id) != recycle_queue_map_.end());
   auto recycle_queue = recycle_queue_map_[table_id];
+  auto &manager = catalog::Manager::GetInstance();
+
+  oid_t tile_group_id;
+  while (recycle_queue->Dequeue(tile_group_id) == true) {
+    auto tile_group = manager.GetTileGroup(tile_group_id);
 
-  if (recycle_queue->Dequeue(location) == true) {
-    LOG_TRACE("Reuse tuple(%u, %u) in table %u", location.block,
-              location.offset, table_id);
-    return location;
+    // the table may have been dropped
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    auto tile_group_header = tile_group->GetHeader();
+    if (tile_group_header->IsRetired() == true ||
+        tile_group_header->IsDeleting() == true) {
+      continue;
+    }
+
+    oid_t tuple_slot_id = tile_group_header->GetRecycledTupleSlot();
+
+    // the tile group may have been retired or deleted while we took the
+    // slot. the compactor retires before it counts the recycled slots, so
+    // one of us sees the other. a deleted tile group is retired before its
+    // delete is finished.
+    if (tuple_slot_id != INVALID_OID &&
+        (tile_group_header->IsRetired() == true ||
+         tile_group_header->IsDeleting() == true)) {
+      tile_group_header->RecycleTupleSlot(tuple_slot_id);
+      continue;
+    }
+
+    // keep the tile group in the queue while it has recycled slots left
+    if (tile_group_header->GetRecycledTupleSlotCount() > 0) {
+      recycle_queue->Enqueue(tile_group_id);
+    }
+
+    if (tuple_slot_id != INVALID_OID) {
+      LOG_TRACE("Reuse tuple(%u, %u) in table %u", tile_group_id,
+                tuple_slot_id, table_id);
+      return ItemPointer(tile_group_id, tuple_slot_id);
+    }
   }
   return INVALID_ITEMPOINTER;
 }
 
 void TransactionLevelGCManager::ClearGarbage(int thread_id) {
-  while (!unlink_queues_[thread_id]->IsEmpty() ||
+  while (HasQueuedGarbage(thread_id) == true ||
          !local_unlink_queues_[thread_id].empty()) {
     Unlink(thread_id, MAX_CID);
   }
 
-  while (reclaim_maps_[thread_id].size() != 0) {
+  while (reclaim_queues_[thread_id].empty() == false) {
     Reclaim(thread_id, MAX_CID);
   }
 
   return;
 }
 
-void TransactionLevelGCManager::DeleteFromIndexes(
-    const std::shared_ptr<GarbageContext> &garbage_ctx) {
-  for (auto entry : *(garbage_ctx->gc_set_.get())) {
-    for (auto &element : entry.second) {
-      if (element.second == true) {
-        ItemPointer location(entry.first, element.first);
-
-        DeleteTupleFromIndexes(location);
-      }
-    }
-  }
-}
-
-// delete a tuple from all its indexes it belongs to.
-void TransactionLevelGCManager::DeleteTupleFromIndexes(
-    const ItemPointer location) {
+namespace {
 
-  // only old versions are stored in the gc set.
-  // so we can safely get indirection from the indirection array.
-  auto tile_group =
-      catalog::Manager::GetInstance().GetTileGroup(location.block);
-  
-  // if the corresponding tile group is deconstructed, 
-  // then do nothing.
-  if (tile_group == nullptr) {
-    return;
-  }
-
-  auto tile_group_header = catalog::Manager::GetInstance()
-                               .GetTileGroup(location.block)
-                               ->GetHeader();
+// an unlinked tuple whose index entries are deleted
+struct IndexGarbage {
+  ItemPointer location;
+  ItemPointer *indirection;
+  GarbageContext *garbage_ctx;
+  storage::TileGroup *tile_group;
+};
+
+// an index entry to delete
+struct IndexEntryGarbage {
+  std::unique_ptr<storage::Tuple> key;
+  const IndexGarbage *garbage;
+};
+
+}  // namespace
+
+// delete the tuples that were deleted or whose insert was aborted from all
+// the indexes they belong to. the tuples are grouped by table, and the keys
+// of each index are deleted in key order, so that consecutive deletions
+// touch the same index nodes.
+void TransactionLevelGCManager::DeleteFromIndexes(
+    const std::vector<std::shared_ptr<GarbageContext>> &garbages) {
+  auto &manager = catalog::Manager::GetInstance();
 
-  ItemPointer *indirection =
-      tile_group_header->GetIndirection(location.offset);
+  // keeps the tile groups alive while their tuples are processed
+  std::vector<std::shared_ptr<storage::TileGroup>> tile_groups;
+  std::unordered_map<storage::DataTable *, std::vector<IndexGarbage>>
+      table_garbages;
 
-  // do nothing if indirection is null
-  if (indirection == nullptr) {
-    return;
-  }
+  for (auto &garbage_ctx : garbages) {
+    // the gc set is flat. consecutive entries often share a tile group.
+    oid_t tile_group_id = INVALID_OID;
+    storage::TileGroup *tile_group = nullptr;
+    std::vector<IndexGarbage> *tuple_garbages = nullptr;
 
-  expression::ContainerTuple<storage::TileGroup> current_tuple(
-      tile_group.get(), location.offset);
+    for (auto &entry : *(garbage_ctx->gc_set_.get())) {
+      if (entry.second == false) {
+        continue;
+      }
 
-  // get the version next (older) to the current version.
-  // recall that a tuple is inserted into an index only when  
-  // any change is made to the index key.
-  // Hence, we should delete a tuple from the index only if
-  // the value of the version's key field is different from
-  // that of the older version's.
-  auto older_location = tile_group_header->GetNextItemPointer(location.offset);
+      ItemPointer location = entry.first;
+      if (location.block != tile_group_id) {
+        tile_group_id = location.block;
+        auto tile_group_ptr = manager.GetTileGroup(location.block);
+        tile_group = tile_group_ptr.get();
+
+        // if the corresponding tile group is deconstructed,
+        // then do nothing.
+        if (tile_group == nullptr) {
+          continue;
+        }
+        tile_groups.push_back(std::move(tile_group_ptr));
+
+        storage::DataTable *table =
+            dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+        PL_ASSERT(table != nullptr);
+        tuple_garbages = &table_garbages[table];
+      }
 
-  auto older_tile_group = 
-      catalog::Manager::GetInstance().GetTileGroup(older_location.block);
+      if (tile_group == nullptr) {
+        continue;
+      }
 
-  PL_ASSERT(older_tile_group != nullptr);
+      // the whole tile group was deleted. its index entries are deleted
+      // along with the others.
+      if (location.offset == INVALID_OID) {
+        auto tile_group_header = tile_group->GetHeader();
+        oid_t slot_count = tile_group_header->GetCurrentNextTupleSlot();
+        for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+          ItemPointer *indirection =
+              tile_group_header->GetIndirection(tuple_slot);
+          if (tile_group_header->IsDeletedSlot(tuple_slot) == true &&
+              indirection != nullptr) {
+            tuple_garbages->push_back({ItemPointer(tile_group_id, tuple_slot),
+                                       indirection, garbage_ctx.get(),
+                                       tile_group});
+          }
+        }
+        continue;
+      }
 
-  expression::ContainerTuple<storage::TileGroup> older_tuple(
-      older_tile_group.get(), older_location.offset);
+      ItemPointer *indirection =
+          tile_group->GetHeader()->GetIndirection(location.offset);
 
+      // do nothing if indirection is null
+      if (indirection == nullptr) {
+        continue;
+      }
 
-  storage::DataTable *table =
-      dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
-  PL_ASSERT(table != nullptr);
+      tuple_garbages->push_back(
+          {location, indirection, garbage_ctx.get(), tile_group});
+    }
+  }
 
-  // attempt to unlink the version from all the indexes.
-  for (size_t idx = 0; idx < table->GetIndexCount(); ++idx) {
-    auto index = table->GetIndex(idx);
-    if (index == nullptr) continue;
-    auto index_schema = index->GetKeySchema();
-    auto indexed_columns = index_schema->GetIndexedColumns();
+  std::vector<IndexEntryGarbage> index_entries;
+  for (auto &table_garbage : table_garbages) {
+    auto table = table_garbage.first;
+    auto &tuple_garbages = table_garbage.second;
+
+    for (size_t idx = 0; idx < table->GetIndexCount(); ++idx) {
+      auto index = table->GetIndex(idx);
+      if (index == nullptr) continue;
+      auto index_schema = index->GetKeySchema();
+      auto indexed_columns = index_schema->GetIndexedColumns();
+
+      // build keys.
+      index_entries.clear();
+      for (auto &tuple_garbage : tuple_garbages) {
+        expression::ContainerTuple<storage::TileGroup> current_tuple(
+            tuple_garbage.tile_group, tuple_garbage.location.offset);
+
+        std::unique_ptr<storage::Tuple> current_key(
+            new storage::Tuple(index_schema, true));
+        current_key->SetFromTuple(&current_tuple, indexed_columns,
+                                  index->GetPool());
+        index_entries.push_back({std::move(current_key), &tuple_garbage});
+      }
 
-    bool updated = false;
-    for (auto col : indexed_columns) {
-      if (current_tuple.GetValue(col).CompareEquals(older_tuple.GetValue(col)) != type::CMP_TRUE) {
-        updated = true;
-        break;
+      std::sort(index_entries.begin(), index_entries.end(),
+                [](const IndexEntryGarbage &lhs, const IndexEntryGarbage &rhs) {
+                  return lhs.key->Compare(*rhs.key) < 0;
+                });
+
+      // entries left behind by updates of the key columns still reference
+      // the indirection. it then stays in use.
+      for (auto &index_entry : index_entries) {
+        auto garbage = index_entry.garbage;
+        if (index->DeleteEntry(index_entry.key.get(), garbage->indirection) ==
+                true &&
+            storage::IndirectionArray::RemoveIndexEntry(
+                garbage->indirection) == 0) {
+          garbage->garbage_ctx->indirections_.emplace_back(
+              garbage->location.block, garbage->indirection);
+        }
       }
     }
+  }
+}
 
-    // if no key field is updated, then do not delete it from index.
-    if (updated == false) {
+// hand the unreferenced indirections back to their tables.
+void TransactionLevelGCManager::ReleaseIndirections(
+    const std::shared_ptr<GarbageContext> &garbage_ctx) {
+  for (auto &entry : garbage_ctx->indirections_) {
+    auto tile_group = catalog::Manager::GetInstance().GetTileGroup(entry.first);
+
+    // the table may have been dropped
+    if (tile_group == nullptr) {
       continue;
     }
 
-    // build key.
-    std::unique_ptr<storage::Tuple> current_key(new storage::Tuple(index_schema, true));
-    current_key->SetFromTuple(&current_tuple, indexed_columns, index->GetPool());
+    storage::DataTable *table =
+        dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+    PL_ASSERT(table != nullptr);
 
-    index->DeleteEntry(current_key.get(), indirection);
+    table->ReleaseIndirection(entry.second);
   }
-
+  garbage_ctx->indirections_.clear();
 }
 
 }  // namespace gc
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gcbench_configuration.h
+//
+// Identification: src/include/benchmark/gcbench/gcbench_configuration.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace benchmark {
+namespace gcbench {
+
+static const oid_t gcbench_database_oid = 100;
+
+static const oid_t gcbench_table_oid = 1001;
+
+static const oid_t gcbench_table_pkey_index_oid = 2001;
+
+// Every tuple has a key and this many INTEGER fields
+static const int gcbench_field_count = 10;
+
+// The version chains are walked up to this many versions
+static const size_t max_chain_length = 1 << 16;
+
+// Chain lengths are counted in powers of two: 1, 2, 3-4, 5-8 and so on
+static const size_t chain_length_bucket_count = 17;
+
+// What is sampled every profile interval
+struct ProfileResult {
+  // versions reclaimed per second during the interval
+  double reclaim_throughput = 0;
+
+  // garbage contexts waiting to be unlinked or reclaimed
+  size_t gc_backlog = 0;
+
+  // bytes of the tiles, their headers and varlen pools
+  size_t memory_bytes = 0;
+
+  double average_chain_length = 0;
+
+  size_t max_chain_length = 0;
+};
+
+class configuration {
+ public:
+  // # of K tuples
+  int scale_factor;
+
+  // execution duration (in s)
+  double duration;
+
+  // sampling interval (in s)
+  double profile_duration;
+
+  // # of threads updating the keys
+  int writer_count;
+
+  // updates per writer transaction
+  int update_count;
+
+  // # of threads reading the hot keys, one key per transaction
+  int reader_count;
+
+  // # of threads holding a transaction open for the reader duration
+  int long_reader_count;
+
+  // the first keys, which the readers and the hot updates pick from
+  int hot_key_count;
+
+  // fraction of the updates on the hot keys
+  double hot_ratio;
+
+  // the sweep, a process for every gc thread count and reader duration
+  std::vector<int> gc_thread_counts;
+
+  // seconds a long reader keeps its transaction open, 0 for no long readers
+  std::vector<double> reader_durations;
+
+  // the point of the sweep that runs
+  int gc_thread_count;
+
+  double reader_duration;
+
+  // committed writer transactions per second
+  double update_throughput = 0;
+
+  // aborted writer transactions per committed one
+  double abort_rate = 0;
+
+  // versions reclaimed per second over the run
+  double reclaim_throughput = 0;
+
+  // latencies of the hot reads (in ms)
+  double read_p50_latency = 0;
+  double read_p99_latency = 0;
+  double read_p999_latency = 0;
+  double read_max_latency = 0;
+
+  // bytes of the tiles, their headers and varlen pools gained in the run
+  int64_t memory_growth = 0;
+
+  // the version chains at the end of the run
+  std::vector<uint64_t> chain_length_counts;
+
+  std::vector<ProfileResult> profile_results;
+};
+
+extern configuration state;
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+void ValidateScaleFactor(const configuration &state);
+
+void ValidateDuration(const configuration &state);
+
+void ValidateProfileDuration(const configuration &state);
+
+void ValidateThreadCounts(const configuration &state);
+
+void ValidateHotKeys(const configuration &state);
+
+void ValidateSweep(const configuration &state);
+
+// Write the results of the run, after the ones of the earlier runs of the
+// sweep if append is set
+void WriteOutput(bool append);
+
+}  // namespace gcbench
+}  // namespace benchmark
+}  // namespace peloton
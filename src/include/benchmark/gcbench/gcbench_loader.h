@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gcbench_loader.h
+//
+// Identification: src/include/benchmark/gcbench/gcbench_loader.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "benchmark/gcbench/gcbench_configuration.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
+namespace benchmark {
+namespace gcbench {
+
+extern configuration state;
+
+extern storage::DataTable *gcbench_table;
+
+void CreateGCBenchDatabase();
+
+void LoadGCBenchDatabase();
+
+}  // namespace gcbench
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,39 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gcbench_workload.h
+//
+// Identification: src/include/benchmark/gcbench/gcbench_workload.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "benchmark/benchmark_common.h"
+#include "benchmark/gcbench/gcbench_configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace gcbench {
+
+extern configuration state;
+
+// Writers, hot readers and long readers, each on an epoch thread of its own
+size_t GetThreadCount();
+
+void RunWorkload();
+
+// Walk the chain of every tuple from its newest version, counting the
+// lengths into chain_length_counts and their average and maximum into the
+// result
+void SampleVersionChains(ProfileResult &result,
+                         std::vector<uint64_t> &chain_length_counts);
+
+}  // namespace gcbench
+}  // namespace benchmark
+}  // namespace peloton
@@ -1,95 +1,111 @@
-// //===----------------------------------------------------------------------===//
-// //
-// //                         Peloton
-// //
-// // logger_configuration.h
-// //
-// // Identification: src/include/benchmark/logger/logger_configuration.h
-// //
-// // Copyright (c) 2015-16, Carnegie Mellon University Database Group
-// //
-// //===----------------------------------------------------------------------===//
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logger_configuration.h
+//
+// Identification: src/include/benchmark/logger/logger_configuration.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
 
 
-// #pragma once
+#pragma once
 
-// #include <string>
-// #include <getopt.h>
-// #include <vector>
-// #include <sys/time.h>
-// #include <iostream>
+#include <string>
+#include <getopt.h>
+#include <vector>
+#include <sys/time.h>
+#include <iostream>
 
-// #include "type/types.h"
+#include "type/types.h"
 
-// namespace peloton {
-// namespace benchmark {
-// namespace logger {
+namespace peloton {
+namespace benchmark {
+namespace logger {
 
-// enum ExperimentType {
-//   EXPERIMENT_TYPE_INVALID = 0,
+enum BenchmarkType {
+  BENCHMARK_TYPE_INVALID = 0,
 
-//   EXPERIMENT_TYPE_THROUGHPUT = 1,
-//   EXPERIMENT_TYPE_RECOVERY = 2,
-//   EXPERIMENT_TYPE_STORAGE = 3,
-//   EXPERIMENT_TYPE_LATENCY = 4
-// };
+  BENCHMARK_TYPE_YCSB = 1,
+  BENCHMARK_TYPE_TPCC = 2
+};
 
-// enum BenchmarkType {
-//   BENCHMARK_TYPE_INVALID = 0,
+class configuration {
+ public:
+  // Benchmark type
+  BenchmarkType benchmark_type;
 
-//   BENCHMARK_TYPE_YCSB = 1,
-//   BENCHMARK_TYPE_TPCC = 2
-// };
+  // log directory, each run logs to a directory of its own in it
+  std::string log_dir;
 
-// enum AsynchronousType {
-//   ASYNCHRONOUS_TYPE_INVALID = 0,
+  // backend of the log segments
+  BackendType backend_type;
 
-//   ASYNCHRONOUS_TYPE_SYNC = 1,      // logging enabled + sync commits
-//   ASYNCHRONOUS_TYPE_ASYNC = 2,     // logging enabled + async commits
-//   ASYNCHRONOUS_TYPE_DISABLED = 3,  // logging disabled
-//   ASYNCHRONOUS_TYPE_NO_WRITE = 4
-// };
+  // the runs sweep every combination of these
+  std::vector<int> backend_counts;
 
-// class configuration {
-//  public:
-//   // experiment type
-//   ExperimentType experiment_type;
+  std::vector<int> logger_counts;
 
-//   // logging type
-//   LoggingType logging_type;
+  // epoch lengths (in ms)
+  std::vector<int> epoch_lengths;
 
-//   // checkpoint type
-//   CheckpointType checkpoint_type;
+  // summary file, a line per run
+  std::string output_file;
+};
 
-//   // log file dir
-//   std::string log_file_dir;
+// Results of a run
+struct RunResult {
+  int backend_count = 0;
 
-//   // size of the pmem file (in MB)
-//   size_t data_file_size;
+  int logger_count = 0;
 
-//   // frequency with which the logger flushes
-//   int wait_timeout;
+  int epoch_length = 0;
 
-//   // Benchmark type
-//   BenchmarkType benchmark_type;
+  double throughput = 0;
 
-//   // clflush or clwb
-//   int flush_mode;
+  double abort_rate = 0;
 
-//   // nvm latency
-//   int nvm_latency;
+  // commit latencies (in ms)
+  double latency_average = 0;
 
-//   // pcommit latency
-//   int pcommit_latency;
+  double latency_50th = 0;
 
-//   // asynchronous_mode
-//   AsynchronousType asynchronous_mode;
-// };
+  double latency_95th = 0;
 
-// void Usage(FILE *out);
+  double latency_99th = 0;
 
-// void ParseArguments(int argc, char *argv[], configuration &state);
+  double latency_max = 0;
 
-// }  // namespace logger
-// }  // namespace benchmark
-// }  // namespace peloton
+  double bytes_per_txn = 0;
+
+  // flushes per second
+  double flush_rate = 0;
+
+  // bytes and buffers of a flush
+  double flush_bytes = 0;
+
+  double flush_buffers = 0;
+
+  double max_flush_bytes = 0;
+
+  // fraction of the run the loggers spent writing and syncing
+  double logger_utilization = 0;
+
+  // fraction of the run the log device was busy, -1 if unknown
+  double device_utilization = -1;
+};
+
+extern configuration state;
+
+void Usage(FILE *out);
+
+// The options after a "--" are those of the benchmark
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+void WriteOutput(const RunResult &result);
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
@@ -1,61 +1,39 @@
-// //===----------------------------------------------------------------------===//
-// //
-// //                         Peloton
-// //
-// // logger_workload.h
-// //
-// // Identification: src/include/benchmark/logger/logger_workload.h
-// //
-// // Copyright (c) 2015-16, Carnegie Mellon University Database Group
-// //
-// //===----------------------------------------------------------------------===//
-
-
-// #pragma once
-
-// #include <memory>
-
-// #include "benchmark/logger/logger_configuration.h"
-
-// namespace peloton {
-
-// namespace catalog {
-// class Column;
-// class Schema;
-// }
-
-// namespace storage {
-// class Tuple;
-// class DataTable;
-// }
-
-// namespace benchmark {
-// namespace logger {
-
-// extern configuration state;
-
-// //===--------------------------------------------------------------------===//
-// // PREPARE LOG FILE
-// //===--------------------------------------------------------------------===//
-
-// bool SetupLoggingOnFollower();
-
-// bool PrepareLogFile();
-
-// //===--------------------------------------------------------------------===//
-// // CHECK RECOVERY
-// //===--------------------------------------------------------------------===//
-
-// void ResetSystem(void);
-
-// void DoRecovery();
-
-// //===--------------------------------------------------------------------===//
-// // WRITING LOG RECORD
-// //===--------------------------------------------------------------------===//
-
-// void BuildLog();
-
-// }  // namespace logger
-// }  // namespace benchmark
-// }  // namespace peloton
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logger_workload.h
+//
+// Identification: src/include/benchmark/logger/logger_workload.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include "benchmark/logger/logger_configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace logger {
+
+//===--------------------------------------------------------------------===//
+// RUNS
+//===--------------------------------------------------------------------===//
+
+// Run the benchmark with logging on once for every combination of the
+// backend, logger and epoch counts, each run in a process of its own.
+// Returns false if a run failed.
+bool RunSweep();
+
+// Load the benchmark, then run it with the loggers logging to the directory.
+// Returns false if logging could not be started.
+bool RunLogging(const int backend_count, const int logger_count,
+                const int epoch_length, const std::string &run_log_dir,
+                RunResult &result);
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
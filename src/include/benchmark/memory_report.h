@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_report.h
+//
+// Identification: src/include/benchmark/memory_report.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include "common/logger.h"
+#include "statistics/memory_usage.h"
+
+namespace peloton {
+namespace benchmark {
+
+// Emit the bytes per tuple of every component, from the usage before the
+// database was created to the usage with its tables added. A line per
+// component: label, component, bytes, bytes per tuple.
+inline void WriteMemoryReport(std::ofstream &out, const std::string &label,
+                              const stats::MemoryUsage &before,
+                              const stats::MemoryUsage &after) {
+  auto tuple_count = after.tuple_count > 0 ? after.tuple_count : 1;
+  size_t total_bytes = 0;
+
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("memory of %s :: %lu tuples", label.c_str(), after.tuple_count);
+  for (size_t type = 0; type < MEMORY_COMPONENT_TYPE_COUNT; type++) {
+    auto component = static_cast<MemoryComponentType>(type);
+    auto bytes = after.GetBytes(component) > before.GetBytes(component)
+                     ? after.GetBytes(component) - before.GetBytes(component)
+                     : 0;
+
+    // The versions awaiting GC are part of the tiles
+    if (component != MemoryComponentType::VERSION_CHAIN) {
+      total_bytes += bytes;
+    }
+
+    auto name = MemoryComponentTypeToString(component);
+    LOG_INFO("%s :: %lu bytes %lf bytes/tuple", name.c_str(), bytes,
+             (double)bytes / tuple_count);
+    out << label << " " << name << " " << bytes << " "
+        << (double)bytes / tuple_count << "\n";
+  }
+
+  LOG_INFO("total :: %lu bytes %lf bytes/tuple", total_bytes,
+           (double)total_bytes / tuple_count);
+  out << label << " total " << total_bytes << " "
+      << (double)total_bytes / tuple_count << "\n";
+  out.flush();
+}
+
+}  // namespace benchmark
+}  // namespace peloton
@@ -146,6 +146,23 @@ class configuration {
   bool holistic_indexing;
 
   oid_t multi_stage_idx = 0;
+
+  // HYBRID PARAMETERS
+
+  // whether to run the OLTP writers and the OLAP readers concurrently
+  bool hybrid;
+
+  // # of OLTP writer threads
+  int writer_count;
+
+  // # of OLAP reader threads to sweep over
+  std::vector<int> reader_counts;
+
+  // execution duration of every sweep point (s)
+  double duration;
+
+  // whether to freeze the cold tile groups in the background
+  bool freeze;
 };
 
 void Usage(FILE *out);
@@ -23,8 +23,13 @@ extern configuration state;
 
 extern std::unique_ptr<storage::DataTable> sdbench_table;
 
+static const oid_t sdbench_table_pkey_index_oid = 0;
+
 void CreateTable();
 
+// Create the primary key index the hybrid workload looks tuples up with
+void CreatePrimaryIndex();
+
 void LoadTable();
 
 void CreateAndLoadTable(LayoutType layout_type);
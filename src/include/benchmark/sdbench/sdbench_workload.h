@@ -13,7 +13,12 @@
 
 #pragma once
 
+#include <fstream>
+#include <memory>
+#include <vector>
+
 #include "benchmark/sdbench/sdbench_configuration.h"
+#include "planner/hybrid_scan_plan.h"
 
 namespace peloton {
 namespace benchmark {
@@ -21,8 +26,22 @@ namespace sdbench {
 
 extern configuration state;
 
+// Summary of the results, one line per query or sweep point
+extern std::ofstream out;
+
+void BenchmarkPrepare();
+void BenchmarkCleanUp();
+
+std::shared_ptr<planner::HybridScanPlan> CreateHybridScanPlan(
+    const std::vector<oid_t> &tuple_key_attrs,
+    const std::vector<oid_t> &index_key_attrs,
+    const std::vector<oid_t> &column_ids);
+
+std::vector<double> GetColumnsAccessed(const std::vector<oid_t> &column_ids);
+
 void RunSDBenchTest();
 void RunMultiStageBenchmark();
+void RunHybridBenchmark();
 
 }  // namespace sdbench
 }  // namespace benchmark
@@ -148,6 +148,42 @@ static const oid_t order_line_table_skey_index_oid =
 #define COL_IDX_S_REMOTE_CNT      15
 #define COL_IDX_S_DATA            16
 
+// How the backends are pinned to the processors
+enum class PinningType {
+  NONE = 0,  // not pinned
+  CORE = 1,  // one core per backend
+  NUMA = 2   // the cores of one NUMA node per backend, round robin
+};
+
+// The transaction types of the workload
+enum class TransactionType {
+  NEW_ORDER = 0,
+  PAYMENT = 1,
+  DELIVERY = 2,
+  ORDER_STATUS = 3,
+  STOCK_LEVEL = 4
+};
+
+static const size_t transaction_type_count = 5;
+
+std::string TransactionTypeToString(const TransactionType type);
+
+// The measurements of one transaction type
+struct TransactionResult {
+  // commits per second
+  double throughput = 0;
+
+  // aborts per commit, by their cause. conflicts are found while the
+  // transaction runs, validation failures when it commits.
+  double conflict_abort_rate = 0;
+  double validation_abort_rate = 0;
+
+  // latencies of the committed transactions (in ms), over all their attempts
+  double average_latency = 0;
+  double p50_latency = 0;
+  double p95_latency = 0;
+  double p99_latency = 0;
+};
 
 class configuration {
  public:
@@ -158,6 +194,9 @@ class configuration {
   // epoch type
   EpochType epoch;
 
+  // concurrency control protocol
+  ProtocolType protocol;
+
   // scale factor
   double scale_factor;
 
@@ -173,6 +212,15 @@ class configuration {
   // num of warehouses
   int warehouse_count;
 
+  // the backend and warehouse counts to sweep. every warehouse count is
+  // loaded once and runs every backend count.
+  std::vector<int> backend_counts;
+
+  std::vector<int> warehouse_counts;
+
+  // pinning of the backends
+  PinningType pinning;
+
   // item count
   int item_count;
 
@@ -197,16 +245,34 @@ class configuration {
   // number of loaders
   int loader_count;
 
+  // report the memory of every component after loading
+  bool memory_report;
+
   // throughput
   double throughput = 0;
 
   // abort rate
   double abort_rate = 0;
 
+  // abort rate by cause
+  double conflict_abort_rate = 0;
+
+  double validation_abort_rate = 0;
+
+  // the results of every transaction type
+  std::vector<TransactionResult> transaction_results;
+
   std::vector<double> profile_throughput;
 
   std::vector<double> profile_abort_rate;
 
+  std::vector<double> profile_conflict_abort_rate;
+
+  std::vector<double> profile_validation_abort_rate;
+
+  // throughput of every transaction type
+  std::vector<std::vector<double>> profile_transaction_throughput;
+
   std::vector<int> profile_memory;
   
 };
@@ -231,7 +297,9 @@ void ValidateWarehouseCount(const configuration &state);
 
 void ValidateGCBackendCount(const configuration &state);
 
-void WriteOutput();
+// Write the results of the last run, after the ones of the earlier runs of
+// the sweep if append is set
+void WriteOutput(bool append);
 
 }  // namespace tpcc
 }  // namespace benchmark
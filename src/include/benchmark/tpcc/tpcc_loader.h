@@ -33,6 +33,9 @@ extern configuration state;
 
 void CreateTPCCDatabase();
 
+// Drop the database and all of its tables
+void DropTPCCDatabase();
+
 void LoadTPCCDatabase();
 
 /////////////////////////////////////////////////////////
@@ -24,6 +24,10 @@ namespace storage {
 class DataTable;
 }
 
+namespace concurrency {
+class Transaction;
+}
+
 namespace benchmark {
 namespace tpcc {
 
@@ -43,6 +47,15 @@ bool RunStockLevel(const size_t &thread_id);
 
 size_t GenerateWarehouseId(const size_t &thread_id);
 
+// Count an abort of the thread's transaction at its commit, when the
+// validation of its reads failed
+void RecordValidationAbort(const size_t &thread_id);
+
+// Begin a transaction that accesses the given warehouses. Under the
+// partitioned protocol it holds their partitions until it ends.
+concurrency::Transaction *BeginWarehouseTransaction(
+    const size_t &thread_id, const std::vector<int> &warehouse_ids);
+
 /////////////////////////////////////////////////////////
 
 std::vector<std::vector<type::Value>> ExecuteRead(executor::AbstractExecutor* executor);
@@ -53,6 +66,9 @@ void ExecuteDelete(executor::AbstractExecutor* executor);
 
 void PinToCore(size_t core);
 
+// Pin the backend as the configuration asks
+void PinBackend(size_t thread_id);
+
 }  // namespace tpcc
 }  // namespace benchmark
 }  // namespace peloton
@@ -71,6 +71,12 @@ enum class TableId : uint32_t {
   Orders = 51,
 };
 
+// The engines that execute the queries
+enum class ExecutionEngine : uint32_t {
+  Codegen = 0,
+  Interpreter,
+};
+
 //===----------------------------------------------------------------------===//
 // The benchmark configuration
 //===----------------------------------------------------------------------===//
@@ -85,6 +91,13 @@ struct Configuration {
   // The number of runs to average over
   uint32_t num_runs = 10;
 
+  // The number of threads the scans of a query run on
+  uint32_t num_threads = 1;
+
+  // Which engines run the queries?
+  bool run_codegen = true;
+  bool run_interpreter = false;
+
   // The directory where all the data files are
   std::string data_dir;
 
@@ -112,9 +125,12 @@ struct Configuration {
 
   void SetRunnableQueries(char *query_list);
 
+  // Pick the engines from "codegen", "interpreter" or "both"
+  bool SetEngines(const std::string &engines);
+
   bool ShouldRunQuery(QueryId qid) const;
 };
 
 }  // namespace tpch
 }  // namespace benchmark
-}  // namespace pelton
\ No newline at end of file
+}  // namespace peloton
\ No newline at end of file
@@ -27,6 +27,9 @@ class DataTable;
 namespace benchmark {
 namespace tpch {
 
+// Convert the given yyyy-mm-dd string into the DATE value the loaders store
+uint32_t ConvertDate(const char *p);
+
 //===----------------------------------------------------------------------===//
 // The TPCH Database. This class is responsible for access to all table in the
 // DB. Tables are created on instantiation. Individual tables can be loaded
@@ -61,11 +64,23 @@ class TPCHDatabase {
   void LoadRegionTable();
   void LoadSupplierTable();
 
+  // The dictionary codes of strings, the queries compare the encoded columns
+  // with them
   uint32_t CodeForMktSegment(const std::string mktsegment) const;
+  uint32_t CodeForShipMode(const std::string &shipmode) const;
+  uint32_t CodeForShipInstruct(const std::string &shipinstruct) const;
+  uint32_t CodeForBrand(const std::string &brand) const;
+  uint32_t CodeForContainer(const std::string &container) const;
+
+  // The keys of the nations and regions with the given names
+  int32_t KeyForNation(const std::string &name) const;
+  int32_t KeyForRegion(const std::string &name) const;
 
  private:
   uint32_t DictionaryEncode(Dictionary &dict, const std::string &val);
 
+  static uint32_t LookupCode(const Dictionary &dict, const std::string &val);
+
   // Table creators
   void CreateCustomerTable() const;
   void CreateLineitemTable() const;
@@ -100,6 +115,10 @@ class TPCHDatabase {
   Dictionary p_brand_dict_;
   Dictionary p_container_dict_;
   Dictionary c_mktsegment_dict_;
+
+  // The names of the nations and regions, mapped to their keys
+  Dictionary nation_keys_;
+  Dictionary region_keys_;
 };
 
 }  // namespace tpch
@@ -12,6 +12,11 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "benchmark/tpch/tpch_configuration.h"
 #include "benchmark/tpch/tpch_database.h"
 
@@ -19,6 +24,19 @@
 #include "codegen/query_result_consumer.h"
 
 namespace peloton {
+
+namespace catalog {
+class Column;
+}  // namespace catalog
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace planner {
+class AbstractPlan;
+}  // namespace planner
+
 namespace benchmark {
 namespace tpch {
 
@@ -47,7 +65,8 @@ class CountingConsumer : public codegen::QueryResultConsumer {
   codegen::RuntimeState::StateID counter_state_id_;
 };
 
-// The benchmark
+// The benchmark. Every query runs on the engines of the configuration, the
+// queries without a plan are skipped.
 class TPCHBenchmark {
  public:
   TPCHBenchmark(const Configuration &config, TPCHDatabase &db);
@@ -68,36 +87,74 @@ class TPCHBenchmark {
     // The list of tables this query uses
     std::vector<TableId> required_tables;
 
-    // A function that constructs a plan for this query
+    // A function that constructs a plan for this query, null if the query
+    // has none yet
     std::function<std::unique_ptr<planner::AbstractPlan>()> PlanConstructor;
   };
 
+  // The times of the runs of a query on an engine
+  struct QueryStats {
+    std::string query_name;
+    ExecutionEngine engine;
+    uint64_t num_tuples;
+    double compile_ms;
+    // The phases of the compilation and the size of the compiled code
+    codegen::QueryCompiler::CompileStats compile_stats;
+    double avg_ms;
+    double min_ms;
+    double max_ms;
+  };
+
   // Run the given query
   void RunQuery(const QueryConfig &query_config);
 
+  // Run the query compiled, or with the interpreted executors
+  void RunCompiled(const QueryConfig &query_config);
+  void RunInterpreted(const QueryConfig &query_config);
+
+  void RecordStats(const QueryConfig &query_config, uint64_t num_tuples,
+                   const codegen::QueryCompiler::CompileStats &compile_stats,
+                   const std::vector<double> &run_ms);
+
+  // Log the times of all queries that ran and write them to
+  // outputfile.summary
+  void PrintStats() const;
+
+  // A sequential scan of the table. The scans of interpreted queries run on
+  // the threads of the configuration under an exchange.
+  std::unique_ptr<planner::AbstractPlan> ScanTable(
+      TableId table_id, expression::AbstractExpression *predicate,
+      const std::vector<oid_t> &column_ids) const;
+
+  // An inner join of the left input with the hash table on the right input.
+  // The keys are INTEGER columns at the same positions of both inputs, since
+  // the interpreted join probes with the key columns of the hash table. The
+  // direct map picks the output columns.
+  static std::unique_ptr<planner::AbstractPlan> HashJoin(
+      std::unique_ptr<planner::AbstractPlan> &&left,
+      std::unique_ptr<planner::AbstractPlan> &&right,
+      const std::vector<oid_t> &key_ids, DirectMapList &&direct_map_list,
+      const std::vector<catalog::Column> &columns);
+
+  // l_extendedprice * (1 - l_discount) of the given columns of the input
+  static expression::AbstractExpression *DiscountedPrice(oid_t price_col,
+                                                         oid_t discount_col);
+
   // Plan constructors
   std::unique_ptr<planner::AbstractPlan> ConstructQ1Plan() const;
-  std::unique_ptr<planner::AbstractPlan> ConstructQ2Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ3Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ4Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ5Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ6Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ7Plan() const;
-  std::unique_ptr<planner::AbstractPlan> ConstructQ8Plan() const;
-  std::unique_ptr<planner::AbstractPlan> ConstructQ9Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ10Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ11Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ12Plan() const;
-  std::unique_ptr<planner::AbstractPlan> ConstructQ13Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ14Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ15Plan() const;
-  std::unique_ptr<planner::AbstractPlan> ConstructQ16Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ17Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ18Plan() const;
   std::unique_ptr<planner::AbstractPlan> ConstructQ19Plan() const;
-  std::unique_ptr<planner::AbstractPlan> ConstructQ20Plan() const;
-  std::unique_ptr<planner::AbstractPlan> ConstructQ21Plan() const;
-  std::unique_ptr<planner::AbstractPlan> ConstructQ22Plan() const;
 
  private:
   // The benchmark configuration
@@ -108,6 +165,12 @@ class TPCHBenchmark {
 
   // All query configurations
   std::vector<QueryConfig> query_configs_;
+
+  // The engine the plans are constructed for
+  ExecutionEngine engine_;
+
+  // The times of the queries that ran
+  std::vector<QueryStats> query_stats_;
 };
 
 }  // namespace tpch
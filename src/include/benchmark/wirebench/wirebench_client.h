@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_client.h
+//
+// Identification: src/include/benchmark/wirebench/wirebench_client.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+// The outcome of one request, up to its ReadyForQuery
+struct QueryResult {
+  bool error = false;
+
+  // the message of the first error
+  std::string error_message;
+
+  uint64_t row_count = 0;
+};
+
+/**
+ * A client connection speaking the PostgreSQL protocol (version 3)
+ *
+ * Messages are queued until Flush, so many requests can be pipelined before
+ * their results are read. Every request is a Query, or ends with a Sync, so
+ * the server answers each one with a ReadyForQuery and ReadResult reads the
+ * results of one request.
+ */
+class PostgresClient {
+ public:
+  PostgresClient(const PostgresClient &) = delete;
+  PostgresClient &operator=(const PostgresClient &) = delete;
+
+  PostgresClient() {}
+
+  ~PostgresClient();
+
+  // Connect and start up. Returns false if it cannot.
+  bool Connect(const std::string &host, const int port,
+               const std::string &user, const std::string &database);
+
+  // Terminate and close the connection
+  void Close();
+
+  // Queue a simple Query
+  void SendQuery(const std::string &query);
+
+  // Queue the Parse of a named statement, and a Sync
+  void SendParse(const std::string &statement_name, const std::string &query);
+
+  // Queue the Bind and Execute of a prepared statement with the parameters
+  // in text, and a Sync
+  void SendExecute(const std::string &statement_name,
+                   const std::vector<std::string> &params);
+
+  // Send the queued messages. Returns false if the connection failed.
+  bool Flush();
+
+  // Read the results of the next request. Returns false if the connection
+  // failed.
+  bool ReadResult(QueryResult &result);
+
+ private:
+  void BeginMessage(const char type);
+
+  void PutInt16(const int16_t value);
+
+  void PutInt32(const int32_t value);
+
+  // with the terminating zero
+  void PutString(const std::string &value);
+
+  // Set the length of the message begun last
+  void EndMessage();
+
+  // Read the next message. Returns false if the connection failed.
+  bool ReadMessage(char &type, std::string &body);
+
+  // Read at least the bytes into the buffer
+  bool Fill(const size_t byte_count);
+
+  int socket_fd_ = -1;
+
+  std::string write_buffer_;
+
+  // where the message begun last starts in the write buffer
+  size_t message_start_ = 0;
+
+  std::string read_buffer_;
+
+  // the first byte not yet read
+  size_t read_ptr_ = 0;
+};
+
+// Fetch the page at the path over HTTP. Returns false if it cannot.
+bool FetchHttp(const std::string &host, const int port,
+               const std::string &path, std::string &body);
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
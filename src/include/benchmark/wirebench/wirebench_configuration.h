@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_configuration.h
+//
+// Identification: src/include/benchmark/wirebench/wirebench_configuration.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+// The statements the clients run
+enum class WorkloadType {
+  YCSB,  // point reads and updates of one table, one statement each
+  TPCC   // new order and payment transactions of a reduced TPC-C schema
+};
+
+// How the statements are sent
+enum class QueryProtocol {
+  SIMPLE,   // one Query message per statement, with the parameters inlined
+  EXTENDED  // Bind, Execute and Sync of statements prepared when connecting
+};
+
+// The requests the clients send, each one statement or a transaction
+enum class RequestType { READ = 0, UPDATE, NEW_ORDER, PAYMENT };
+
+static const size_t request_type_count = 4;
+
+std::string RequestTypeToString(RequestType type);
+
+// The server-side query types, as labelled by its metrics
+static const std::vector<std::string> server_query_types = {
+    "SELECT", "INSERT", "UPDATE", "DELETE", "OTHER"};
+
+// YCSB table
+static const int ycsb_field_count = 10;
+
+static const int ycsb_field_length = 100;
+
+// TPC-C tables, per warehouse
+static const int tpcc_district_count = 10;
+
+static const int tpcc_customer_count = 3000;  // per district
+
+static const int tpcc_item_count = 100000;
+
+struct LatencyResult {
+  // completed requests or queries per second
+  double throughput = 0;
+
+  // in ms
+  double average_latency = 0;
+  double p50_latency = 0;
+  double p95_latency = 0;
+  double p99_latency = 0;
+};
+
+class configuration {
+ public:
+  // server address
+  std::string host;
+
+  int port;
+
+  // port of the metrics of the server, 0 to not report its latencies
+  int metrics_port;
+
+  WorkloadType workload;
+
+  QueryProtocol protocol;
+
+  // create and load the tables before running
+  bool load;
+
+  // K tuples for YCSB, warehouses for TPC-C
+  int scale_factor;
+
+  // execution duration (in s)
+  double duration;
+
+  // number of client connections, each on a thread of its own
+  int client_count;
+
+  // requests sent by a client before it reads their results
+  int pipeline_depth;
+
+  // fraction of YCSB updates
+  double update_ratio;
+
+  // skew of the YCSB keys
+  double zipf_theta;
+
+  // clients loading the tables
+  int loader_count;
+
+  // completed requests per second
+  double throughput = 0;
+
+  // failed requests per completed one
+  double abort_rate = 0;
+
+  // client-side latencies of every request type, from sending the pipeline
+  // holding the request until its last result is read
+  std::vector<LatencyResult> request_results;
+
+  // server-side latencies of every query type and of the transactions,
+  // estimated from the buckets of its histograms
+  std::vector<LatencyResult> server_query_results;
+
+  LatencyResult server_txn_result;
+
+  // whether the server reported its latencies
+  bool has_server_results = false;
+};
+
+extern configuration state;
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+void ValidatePort(const configuration &state);
+
+void ValidateScaleFactor(const configuration &state);
+
+void ValidateDuration(const configuration &state);
+
+void ValidateClientCount(const configuration &state);
+
+void ValidatePipelineDepth(const configuration &state);
+
+void ValidateUpdateRatio(const configuration &state);
+
+void ValidateZipfTheta(const configuration &state);
+
+void ValidateLoaderCount(const configuration &state);
+
+void WriteOutput();
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
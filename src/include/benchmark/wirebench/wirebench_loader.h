@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_loader.h
+//
+// Identification: src/include/benchmark/wirebench/wirebench_loader.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "benchmark/wirebench/wirebench_configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+extern configuration state;
+
+// Create the tables of the workload through a client
+void CreateTables();
+
+// Load the tables with the loaders, each a client inserting its share of
+// the rows
+void LoadTables();
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_workload.h
+//
+// Identification: src/include/benchmark/wirebench/wirebench_workload.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_common.h"
+#include "benchmark/wirebench/wirebench_client.h"
+#include "benchmark/wirebench/wirebench_configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+extern configuration state;
+
+// A statement with the parameters $1 to $n, which the simple protocol
+// inlines quoted if the parameter is a string
+struct StatementTemplate {
+  std::string name;
+
+  std::string query;
+
+  // whether every parameter is a string
+  std::vector<bool> string_params;
+};
+
+// A statement to run, by its index among the statements of the workload
+struct Statement {
+  size_t statement_id;
+
+  std::vector<std::string> params;
+};
+
+// A request is one statement, or the statements of a transaction in a
+// BEGIN and COMMIT
+struct Request {
+  RequestType type;
+
+  std::vector<Statement> statements;
+};
+
+// The statements of the workload
+const std::vector<StatementTemplate> &GetStatements();
+
+// Queue the statement on the client, by the configured protocol
+void SendStatement(PostgresClient &client, const Statement &statement);
+
+// Prepare the statements of the workload on the client. Returns false if any
+// fails.
+bool PrepareStatements(PostgresClient &client);
+
+// Connect a client to the server
+bool ConnectClient(PostgresClient &client);
+
+void RunWorkload();
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
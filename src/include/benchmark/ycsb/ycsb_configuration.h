@@ -34,6 +34,54 @@ static const oid_t user_table_pkey_index_oid = 2001;
 
 static const oid_t ycsb_field_length = 100;
 
+// The core workloads of YCSB. CUSTOM mixes reads and updates by the update
+// ratio.
+enum class WorkloadType {
+  CUSTOM,
+  A,  // update heavy: 50% reads, 50% updates
+  B,  // read mostly: 95% reads, 5% updates
+  C,  // read only
+  D,  // read latest: 95% reads, 5% inserts
+  E,  // short ranges: 95% scans, 5% inserts
+  F   // read-modify-write: 50% reads, 50% read-modify-writes
+};
+
+// How the keys of the operations are picked
+enum class DistributionType {
+  ZIPF,     // skewed by zipf_theta
+  UNIFORM,
+  LATEST,   // the most recently inserted records are the most popular
+  HOTSPOT   // hotspot_ops of the operations go to hotspot_fraction of the keys
+};
+
+enum class OperationType {
+  READ = 0,
+  UPDATE,
+  INSERT,
+  SCAN,
+  READ_MODIFY_WRITE
+};
+
+static const size_t operation_type_count = 5;
+
+std::string OperationTypeToString(OperationType type);
+
+struct OperationResult {
+  // operations per second, in the committed transactions
+  double throughput = 0;
+
+  // latencies of the executed operations (in ms)
+  double average_latency = 0;
+  double p50_latency = 0;
+  double p95_latency = 0;
+  double p99_latency = 0;
+  double max_latency = 0;
+
+  // the number of operations up to every latency bound (in ms), each bound
+  // twice the one before
+  std::vector<std::pair<double, uint64_t>> histogram;
+};
+
 class configuration {
  public:
 
@@ -43,6 +91,9 @@ class configuration {
   // epoch type
   EpochType epoch;
 
+  // concurrency control protocol
+  ProtocolType protocol;
+
   // size of the table
   int scale_factor;
 
@@ -61,9 +112,35 @@ class configuration {
   // operation count in a transaction
   int operation_count;
 
-  // update ratio
+  // core workload, which sets the operation ratios
+  WorkloadType workload;
+
+  // fractions of the operations of every type, summing up to 1
+  double read_ratio;
+
   double update_ratio;
 
+  double insert_ratio;
+
+  double scan_ratio;
+
+  double read_modify_write_ratio;
+
+  // records read by a scan, from 1 up to this
+  int max_scan_length;
+
+  // key distribution
+  DistributionType distribution;
+
+  // fraction of the keys that are hot
+  double hotspot_fraction;
+
+  // fraction of the operations going to the hot keys
+  double hotspot_ops;
+
+  // length of a field in string mode
+  int value_size;
+
   // contention level
   double zipf_theta;
 
@@ -82,12 +159,21 @@ class configuration {
   // number of loaders
   int loader_count;
 
+  // report the memory of every component after loading
+  bool memory_report;
+
   // throughput
   double throughput = 0;
 
   // abort rate
   double abort_rate = 0;
 
+  // of every operation type
+  std::vector<OperationResult> operation_results;
+
+  // latencies of the committed transactions (in ms), over all their attempts
+  OperationResult transaction_result;
+
   std::vector<double> profile_throughput;
 
   std::vector<double> profile_abort_rate;
@@ -118,6 +204,12 @@ void ValidateOperationCount(const configuration &state);
 
 void ValidateUpdateRatio(const configuration &state);
 
+void ValidateScanLength(const configuration &state);
+
+void ValidateHotspot(const configuration &state);
+
+void ValidateValueSize(const configuration &state);
+
 void ValidateZipfTheta(const configuration &state);
 
 void ValidateGCBackendCount(const configuration &state);
@@ -17,6 +17,7 @@
 #include "benchmark/ycsb/ycsb_configuration.h"
 #include "storage/data_table.h"
 #include "executor/abstract_executor.h"
+#include "statistics/latency_histogram.h"
 
 namespace peloton {
 
@@ -31,9 +32,37 @@ extern configuration state;
 
 extern storage::DataTable* user_table;
 
+// committed operations and latencies of the executed ones, of every thread
+// and operation type
+extern PadInt *operation_counts;
+
+extern stats::LatencyHistogram *operation_latencies;
+
+// Picks the keys of the operations by the configured distribution. The keys
+// of the records are the loaded ones and then the inserted ones in order.
+// Zipf keys are the loaded ones, the others spread over the inserted ones too.
+class KeyGenerator {
+ public:
+  KeyGenerator(FastRandom &rng);
+
+  // the key of an existing record. Keys of inserts still running or aborted
+  // read no record.
+  int NextKey();
+
+  // the key of a new record
+  static int NextInsertKey();
+
+ private:
+  FastRandom &rng_;
+
+  // over the loaded keys
+  ZipfDistribution zipf_;
+};
+
 void RunWorkload();
 
-bool RunMixed(const size_t thread_id, ZipfDistribution &zipf, FastRandom &rng);
+bool RunMixed(const size_t thread_id, KeyGenerator &key_generator,
+              FastRandom &rng);
 
 /////////////////////////////////////////////////////////
 
@@ -33,14 +33,52 @@ namespace brain {
 // Column Id to < Tile Id, Tile Column Id >
 typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
 
+// The columns a sample accessed, packed 64 to a word
+class ColumnBitmap {
+ public:
+  ColumnBitmap(oid_t column_count)
+      : column_count_(column_count), words_((column_count + 63) / 64, 0) {}
+
+  // the columns of a bitmap sample, { 1, 0, 0, 1 } => {0, 3}
+  static ColumnBitmap FromSample(const Sample &sample);
+
+  // the columns of a sample that lists their ids
+  static ColumnBitmap FromColumnIds(const Sample &sample, oid_t column_count);
+
+  inline void Set(oid_t column_id) {
+    words_[column_id / 64] |= 1ULL << (column_id % 64);
+  }
+
+  inline bool IsSet(oid_t column_id) const {
+    return (words_[column_id / 64] >> (column_id % 64)) & 1;
+  }
+
+  // # of columns set
+  oid_t GetCount() const;
+
+  inline oid_t GetColumnCount() const { return column_count_; }
+
+  inline const std::vector<uint64_t> &GetWords() const { return words_; }
+
+ private:
+  oid_t column_count_;
+
+  std::vector<uint64_t> words_;
+};
+
 // Sequential k-Means Clustering
+//
+// The samples are column bitmaps and the distance is the L1 distance to the
+// means. It is computed from the sum of each mean and the columns set in the
+// sample, so the columns that a sample did not access cost nothing.
 class Clusterer : public Printable {
  public:
   Clusterer(oid_t cluster_count, oid_t sample_column_count,
             double param = NEW_SAMPLE_WEIGHT)
       : cluster_count_(cluster_count),
-        means_(
-            std::vector<Sample>(cluster_count_, Sample(sample_column_count))),
+        means_(cluster_count_, std::vector<double>(sample_column_count,
+                                                   DEFAULT_COLUMN_VALUE)),
+        mean_sums_(cluster_count_, sample_column_count * DEFAULT_COLUMN_VALUE),
         closest_(std::vector<int>(cluster_count_, 0)),
         new_sample_weight_(param),
         sample_count_(0),
@@ -51,9 +89,20 @@ class Clusterer : public Printable {
   // process the sample and update the means
   void ProcessSample(const Sample &sample);
 
+  // process the bitmap and update the means
+  void ProcessBitmap(const ColumnBitmap &bitmap);
+
+  // process a mini-batch of bitmaps, each against the means before the
+  // batch, and move every mean once towards the bitmaps closest to it. The
+  // first batch is processed one bitmap at a time.
+  void ProcessBitmaps(const std::vector<ColumnBitmap> &bitmaps);
+
   // find closest cluster for the given sample
   oid_t GetClosestCluster(const Sample &sample);
 
+  // find closest cluster for the given bitmap
+  oid_t GetClosestCluster(const ColumnBitmap &bitmap);
+
   // get cluster mean sample
   Sample GetCluster(oid_t cluster_offset) const;
 
@@ -67,6 +116,9 @@ class Clusterer : public Printable {
   const std::string GetInfo() const;
 
  private:
+  // L1 distance between the bitmap and the cluster mean
+  double GetDistance(const ColumnBitmap &bitmap, oid_t cluster_offset) const;
+
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -75,7 +127,10 @@ class Clusterer : public Printable {
   oid_t cluster_count_;
 
   // means_
-  std::vector<Sample> means_;
+  std::vector<std::vector<double>> means_;
+
+  // sum of the columns of each mean
+  std::vector<double> mean_sums_;
 
   // history
   std::vector<int> closest_;
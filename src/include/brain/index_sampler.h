@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_sampler.h
+//
+// Identification: src/include/brain/index_sampler.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <set>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace planner {
+class AbstractPlan;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace brain {
+
+//===--------------------------------------------------------------------===//
+// Index Sampler
+//===--------------------------------------------------------------------===//
+
+/**
+ * Turns the plans of executed queries into the index samples of the tables
+ * they access, for the index tuner.
+ *
+ * The columns that a scan compares with values, and the join keys of the
+ * tables that are scanned for a join, are recorded as access samples. Their
+ * weight is the cost an index on these columns would save the scan, which
+ * the optimizer cost model estimates as if the index existed. The tuples
+ * that a query inserts, updates or deletes are recorded as update samples,
+ * weighted by the cost of keeping one more index of the table up to date.
+ * The tuner weighs both against each other.
+ */
+class IndexSampler {
+ public:
+  // Record the samples of a plan that was executed and modified the number
+  // of tuples. Only one in FLAGS_index_tuner_sample_interval plans of a
+  // thread is recorded.
+  static void RecordPlan(const planner::AbstractPlan *plan,
+                         const size_t modified_count);
+
+  // Record the samples of a plan that was executed
+  static void RecordSamples(const planner::AbstractPlan *plan,
+                            const size_t modified_count);
+
+  // Add the columns of the table that the predicate compares with a value
+  // in one of its conjuncts
+  static void GetIndexableColumns(
+      const expression::AbstractExpression *predicate,
+      std::set<oid_t> &column_ids);
+
+  // The cost that an index on the indexable columns of the predicate saves
+  // a scan of the table, 0 if none
+  static double GetIndexBenefit(
+      storage::DataTable *table,
+      const expression::AbstractExpression *predicate);
+
+  // The cost that an index on a join key of the table saves the scan for
+  // one tuple of the other side
+  static double GetJoinIndexBenefit(storage::DataTable *table,
+                                    const oid_t column_id);
+
+  // The cost of keeping an index of the table up to date for the modified
+  // tuples
+  static double GetIndexMaintenanceCost(storage::DataTable *table,
+                                        const size_t modified_count);
+};
+
+}  // End brain namespace
+}  // End peloton namespace
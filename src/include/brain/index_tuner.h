@@ -100,9 +100,16 @@ class IndexTuner {
     write_ratio_threshold = write_ratio_threshold_;
   }
 
+  void SetIndexMemoryBudget(const size_t &index_memory_budget_) {
+    index_memory_budget = index_memory_budget_;
+  }
+
   // Get # of indexes in managed tables
   oid_t GetIndexCount() const;
 
+  // Get the memory the indexes created by the tuner take, at least
+  size_t GetAdhocIndexFootprint() const;
+
   // Bootstrap for TPCC
   void BootstrapTPCC(const std::string& path);
 
@@ -163,6 +170,9 @@ class IndexTuner {
   // # of tile groups to be indexed per iteration
   oid_t tile_groups_indexed_per_iteration = 10;
 
+  // how many times as many tile groups are indexed when a peak is forecast
+  oid_t peak_build_factor = 4;
+
   // alpha (weight for old samples)
   double alpha = 0.2;
 
@@ -182,6 +192,9 @@ class IndexTuner {
   // write intensive workload ratio threshold
   double write_ratio_threshold = 0.75;
 
+  // memory the indexes created by the tuner may take (in bytes)
+  size_t index_memory_budget = 1024UL * 1024 * 1024;
+
   oid_t tile_groups_indexed_;
 
   // visibility mode
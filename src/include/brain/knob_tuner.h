@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// knob_tuner.h
+//
+// Identification: src/include/brain/knob_tuner.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
+namespace brain {
+
+//===--------------------------------------------------------------------===//
+// Knob Tuner
+//===--------------------------------------------------------------------===//
+
+/**
+ * Tunes the knobs that are otherwise set once for all deployments from what
+ * it observes every interval.
+ *
+ * A table whose inserts contend on the tile group header latches gets more
+ * active tile groups, and gives them back once the contention is gone. A
+ * table that allocates tile groups faster than the tuner's threshold gets
+ * larger ones. The epochs are lengthened when the epoch thread falls behind
+ * its period, and shortened when the versions wait longer than
+ * FLAGS_knob_tuner_gc_lag_ms for their epoch to expire while only a few
+ * epochs lag.
+ *
+ * The GC threads already follow the garbage on their own and the connection
+ * threads are fixed once the server listens, so neither is tuned here.
+ */
+class KnobTuner {
+ public:
+  KnobTuner(const KnobTuner &) = delete;
+  KnobTuner &operator=(const KnobTuner &) = delete;
+  KnobTuner(KnobTuner &&) = delete;
+  KnobTuner &operator=(KnobTuner &&) = delete;
+
+  KnobTuner();
+
+  ~KnobTuner();
+
+  // Singleton
+  static KnobTuner &GetInstance();
+
+  // Start tuning
+  void Start();
+
+  // Tune knobs
+  void Tune();
+
+  // Stop tuning
+  void Stop();
+
+  // Add table to list of tables whose knobs must be tuned
+  void AddTable(storage::DataTable *table);
+
+  // Remove table from the list
+  void DropTable(storage::DataTable *table);
+
+  // Clear list
+  void ClearTables();
+
+  // Adjust the active tile groups and the tile group size of the table to
+  // the inserts since the last call and the contended tile group header
+  // latches of the interval
+  void TuneTable(storage::DataTable *table, const uint64_t latch_wait_count);
+
+  // The epoch length (ms) for the next interval, given how many epochs
+  // advanced in the last one and how many epochs the expired one lags
+  // behind the current one
+  size_t GetEpochLength(const size_t epoch_length,
+                        const uint64_t advanced_epoch_count,
+                        const uint64_t interval_ms,
+                        const uint64_t lag_epoch_count) const;
+
+  void SetGCLagTarget(const uint64_t gc_lag_ms) { gc_lag_target = gc_lag_ms; }
+
+ private:
+  // What the tuner saw of a table at the end of the last interval
+  struct TableKnobs {
+    bool is_seen = false;
+
+    size_t tuple_count = 0;
+
+    size_t tile_group_count = 0;
+
+    // # of intervals in a row without contention
+    size_t quiet_interval_count = 0;
+  };
+
+  // Tune the epoch length to the epochs of the interval
+  void TuneEpochLength(const uint64_t interval_ms);
+
+  // Tables whose knobs must be tuned
+  std::vector<storage::DataTable *> tables;
+
+  std::map<storage::DataTable *, TableKnobs> table_knobs;
+
+  std::mutex knob_tuner_mutex;
+
+  // Current epoch at the end of the last interval
+  eid_t last_epoch_id = INVALID_EID;
+
+  // Stop signal
+  std::atomic<bool> knob_tuning_stop;
+
+  // Tuner thread
+  std::thread knob_tuner_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Tuner Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Length of an interval (in ms)
+  oid_t tune_interval = 1000;
+
+  // Contended header latches per interval that grow the active tile groups
+  // of the tables that inserted
+  uint64_t contention_threshold = 100;
+
+  // Inserts per interval a table needs to be charged with the contention
+  size_t min_insert_count = 100;
+
+  // Intervals without contention after which the active tile groups shrink
+  size_t shrink_interval_count = 10;
+
+  // Tile groups allocated per interval that grow the tile group size
+  size_t max_tile_groups_per_interval = 8;
+
+  // Largest tile group size the tuner sets
+  size_t max_tuples_per_tilegroup = 64 * 1000;
+
+  // Bounds of the epoch length (in ms)
+  size_t min_epoch_length = 5;
+  size_t max_epoch_length = 200;
+
+  // The epoch length the epochs grow back to once the GC keeps up, the one
+  // set when the tuner starts (in ms)
+  size_t default_epoch_length = 40;
+
+  // Times its period an epoch may take before the epochs are lengthened
+  double max_epoch_delay = 1.5;
+
+  // Time versions may wait for their epoch to expire (in ms)
+  uint64_t gc_lag_target = 100;
+
+  // Lagging epochs beyond which long transactions, not the epoch length,
+  // hold the GC back
+  uint64_t max_short_lag_epoch_count = 4;
+};
+
+}  // End brain namespace
+}  // End peloton namespace
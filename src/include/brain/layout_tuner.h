@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <map>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -64,6 +65,10 @@ class LayoutTuner {
 
   std::string GetColumnMapInfo(const column_map_type &column_map);
 
+  // Move up to relayout_count tile groups of the table into its default
+  // layout, resuming after the last one visited. Returns the number moved.
+  size_t RelayoutTable(storage::DataTable *table);
+
  protected:
   // Update layout of table
   void UpdateDefaultPartition(storage::DataTable *table);
@@ -74,6 +79,9 @@ class LayoutTuner {
 
   std::mutex layout_tuner_mutex;
 
+  // Offset of the next tile group to visit in each table
+  std::map<storage::DataTable *, oid_t> relayout_offsets;
+
   // Stop signal
   std::atomic<bool> layout_tuning_stop;
 
@@ -93,6 +101,12 @@ class LayoutTuner {
   // DataTable::TransformTileGroup, even if the schema is the same.
   double theta = 0.0001;
 
+  // Tile groups moved into the new layout per table and pass
+  oid_t relayout_count = 1;
+
+  // How many times as many are moved when a peak is forecast
+  oid_t peak_relayout_factor = 4;
+
   // Sleeping period (in us)
   oid_t sleep_duration = 100;
 
@@ -102,6 +116,9 @@ class LayoutTuner {
   // New sample weight
   double new_sample_weight = 0.01;
 
+  // Samples the clusterer assigns against the same means
+  size_t sample_batch_size = 16;
+
   // Desired layout tile count
   oid_t tile_count = 2;
 
@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// workload_forecaster.h
+//
+// Identification: src/include/brain/workload_forecaster.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace brain {
+
+// # of forecast intervals the tuners look ahead for a peak
+#define DEFAULT_FORECAST_HORIZON 10
+// arrivals ahead relative to the ones now that make a peak
+#define DEFAULT_PEAK_RATIO 1.5
+
+enum ForecastModel {
+  FORECAST_MODEL_INVALID = 0,
+
+  FORECAST_MODEL_SEASONAL_AVERAGE = 1,   // same interval of past seasons
+  FORECAST_MODEL_LINEAR_REGRESSION = 2   // trend of the recent intervals
+};
+
+//===--------------------------------------------------------------------===//
+// Workload Forecaster
+//===--------------------------------------------------------------------===//
+
+/**
+ * Keeps a time series of the arrivals of each query shape, one count per
+ * interval, and forecasts the arrivals of the coming intervals.
+ *
+ * Once a shape has been seen for a season, its forecast is the average of
+ * the same interval in the past seasons. Until then, it is extrapolated from
+ * a line fit to the recent intervals. The tuners use the forecast to do
+ * their work ahead of a peak rather than during it.
+ */
+class WorkloadForecaster {
+ public:
+  WorkloadForecaster(size_t season_length, size_t season_count = 2,
+                     size_t regression_window = 16,
+                     size_t max_shape_count = 128);
+
+  // Singleton, with FLAGS_workload_forecast_season intervals in a season
+  static WorkloadForecaster &GetInstance();
+
+  // Count queries of the shape in the current interval
+  void RecordQuery(const std::string &shape, const double query_count = 1);
+
+  // Append the counts of the current interval to the series and start the
+  // next one
+  void FinishInterval();
+
+  // The arrivals of the shape expected in the interval the horizon after
+  // the current one, 1 being the next
+  double GetForecast(const std::string &shape, const size_t horizon = 1,
+                     const ForecastModel model = FORECAST_MODEL_INVALID) const;
+
+  // The arrivals of all shapes expected in the interval
+  double GetTotalForecast(const size_t horizon = 1) const;
+
+  // The expected fraction of the arrivals of each shape in the interval
+  std::unordered_map<std::string, double> GetForecastMix(
+      const size_t horizon = 1) const;
+
+  // True if the arrivals of some interval up to the horizon are expected to
+  // be at least the ratio times those of the last interval
+  bool IsPeakAhead(const size_t horizon, const double peak_ratio) const;
+
+  // The arrivals of all shapes in the last finished interval
+  double GetLastTotal() const;
+
+  // # of intervals finished
+  uint64_t GetIntervalCount() const;
+
+  // Forget all series
+  void Clear();
+
+ private:
+  // The arrivals of one shape, from the first interval it was seen in
+  struct ArrivalSeries {
+    uint64_t first_interval = 0;
+
+    uint64_t last_seen_interval = 0;
+
+    std::deque<double> interval_counts;
+
+    double current_count = 0;
+  };
+
+  double GetForecast(const ArrivalSeries &series, const size_t horizon,
+                     const ForecastModel model) const;
+
+  double GetSeasonalAverage(const ArrivalSeries &series,
+                            const size_t horizon) const;
+
+  double GetLinearRegression(const ArrivalSeries &series,
+                             const size_t horizon) const;
+
+  //===--------------------------------------------------------------------===//
+  // MEMBERS
+  //===--------------------------------------------------------------------===//
+
+  // # of intervals in a season
+  size_t season_length_;
+
+  // # of past seasons kept and averaged
+  size_t season_count_;
+
+  // # of recent intervals the line is fit to
+  size_t regression_window_;
+
+  // # of shapes kept, the others are not counted
+  size_t max_shape_count_;
+
+  // # of intervals finished
+  uint64_t interval_count_ = 0;
+
+  // arrivals of all shapes in the last finished interval
+  double last_total_ = 0;
+
+  std::unordered_map<std::string, ArrivalSeries> series_;
+
+  mutable std::mutex forecaster_mutex_;
+};
+
+}  // End brain namespace
+}  // End peloton namespace
@@ -59,9 +59,15 @@ class AbstractCatalog {
   bool InsertTuple(std::unique_ptr<storage::Tuple> tuple,
                    concurrency::Transaction *txn);
 
+  bool BulkInsertTuples(std::vector<std::unique_ptr<storage::Tuple>> tuples,
+                        concurrency::Transaction *txn);
+
   bool DeleteWithIndexScan(oid_t index_offset, std::vector<type::Value> values,
                            concurrency::Transaction *txn);
 
+  bool DeleteWithSeqScan(expression::AbstractExpression *predicate,
+                         concurrency::Transaction *txn);
+
   std::unique_ptr<std::vector<std::unique_ptr<executor::LogicalTile>>>
   GetResultWithIndexScan(std::vector<oid_t> column_offsets, oid_t index_offset,
                          std::vector<type::Value> values,
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 
+#include "catalog/catalog_cache.h"
 #include "catalog/catalog_defaults.h"
 
 namespace peloton {
@@ -26,6 +28,10 @@ namespace concurrency {
 class Transaction;
 }
 
+namespace expression {
+class AbstractExpression;
+}
+
 namespace index {
 class Index;
 }
@@ -35,6 +41,7 @@ class Database;
 class DataTable;
 class TableFactory;
 class Tuple;
+enum class PartitionType;
 }
 
 namespace type {
@@ -96,14 +103,32 @@ class Catalog {
                          const std::string &table_name,
                          const std::vector<std::string> &index_attr,
                          const std::string &index_name, bool unique_keys,
-                         IndexType index_type, concurrency::Transaction *txn);
+                         IndexType index_type, concurrency::Transaction *txn,
+                         const expression::AbstractExpression *predicate =
+                             nullptr);
 
   ResultType CreateIndex(oid_t database_oid, oid_t table_oid,
                          const std::vector<std::string> &index_attr,
                          const std::string &index_name, IndexType index_type,
                          IndexConstraintType index_constraint, bool unique_keys,
                          concurrency::Transaction *txn,
-                         bool is_catalog = false);
+                         bool is_catalog = false,
+                         const expression::AbstractExpression *predicate =
+                             nullptr);
+
+  // Split an empty table into partitions by the values of the column: one
+  // range partition from each of the ascending lower bounds on, or
+  // partition_count hash partitions. The partitions are tables of the
+  // database named <table>_<offset>, with the schema and the primary key of
+  // the table, which keeps neither tuples nor indexes of its own. Tables with
+  // foreign keys can not be partitioned.
+  ResultType CreatePartitions(const std::string &database_name,
+                              const std::string &table_name,
+                              const std::string &column_name,
+                              const storage::PartitionType partition_type,
+                              const std::vector<type::Value> &lower_bounds,
+                              const size_t partition_count,
+                              concurrency::Transaction *txn);
 
   //===--------------------------------------------------------------------===//
   // DROP FUNCTIONS
@@ -127,6 +152,17 @@ class Catalog {
   ResultType DropIndex(oid_t index_oid,
                        concurrency::Transaction *txn);
 
+  // Drop the range partitions of the table that only hold keys below the
+  // bound, see storage::PartitionedTable::DropPartitionsBefore()
+  ResultType DropPartitionsBefore(const std::string &database_name,
+                                  const std::string &table_name,
+                                  const type::Value &bound,
+                                  concurrency::Transaction *txn);
+
+  // The version of the catalog changes whenever a database, a table or an
+  // index is created or dropped, plans built for an older version are stale
+  uint64_t GetVersion() const { return cache_.GetVersion(); }
+
   //===--------------------------------------------------------------------===//
   // GET WITH NAME - CHECK FROM CATALOG TABLES, USING TRANSACTION
   //===--------------------------------------------------------------------===//
@@ -184,7 +220,14 @@ class Catalog {
   // The pool for new varlen tuple fields
   std::unique_ptr<type::AbstractPool> pool_;
 
+  // Called by every change to the catalog. The transaction no longer
+  // resolves names through the cache, which is reset for everyone else.
+  void RecordChange(concurrency::Transaction *txn);
+
   std::mutex catalog_mutex;
+
+  // Database and table names resolved at the current version
+  mutable CatalogCache cache_;
 };
 
 }
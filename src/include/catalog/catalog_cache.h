@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// catalog_cache.h
+//
+// Identification: src/include/catalog/catalog_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "container/lock_free_locator.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace catalog {
+
+//===--------------------------------------------------------------------===//
+// Catalog Snapshot
+//
+// The oids of the databases and tables that were found by name at one
+// version of the catalog. A snapshot is never changed once published.
+//===--------------------------------------------------------------------===//
+
+struct CatalogSnapshot {
+  uint64_t version = 0;
+
+  std::unordered_map<std::string, oid_t> database_oids;
+
+  // By database oid, then by table name
+  std::unordered_map<oid_t, std::unordered_map<std::string, oid_t>> table_oids;
+};
+
+//===--------------------------------------------------------------------===//
+// Catalog Cache
+//
+// Resolves database and table names without reading the catalog tables.
+// Lookups load the current snapshot without taking a lock. Lookups that
+// miss read the catalog tables and publish a copy of the snapshot with what
+// they found, unless the catalog changed in the meantime. Every change to
+// the catalog publishes an empty snapshot of the next version.
+//===--------------------------------------------------------------------===//
+
+class CatalogCache {
+ public:
+  CatalogCache();
+  ~CatalogCache();
+
+  CatalogCache(const CatalogCache &) = delete;
+  CatalogCache &operator=(const CatalogCache &) = delete;
+
+  // The oid of the database, INVALID_OID if it is not cached
+  oid_t GetDatabaseOid(const std::string &database_name) const;
+
+  // The oid of the table, INVALID_OID if it is not cached
+  oid_t GetTableOid(const oid_t database_oid,
+                    const std::string &table_name) const;
+
+  // The version of the current snapshot
+  uint64_t GetVersion() const;
+
+  // Cache what a lookup found in the catalog tables, if the version is still
+  // the one it read before reading them
+  void AddDatabase(const uint64_t version, const std::string &database_name,
+                   const oid_t database_oid);
+
+  void AddTable(const uint64_t version, const oid_t database_oid,
+                const std::string &table_name, const oid_t table_oid);
+
+  // Drop an entry found to be stale, if it still caches the oid
+  void EraseDatabase(const std::string &database_name,
+                     const oid_t database_oid);
+
+  void EraseTable(const oid_t database_oid, const std::string &table_name,
+                  const oid_t table_oid);
+
+  // Publish an empty snapshot of the next version
+  void Reset();
+
+ private:
+  // Publish a copy of the current snapshot changed by the function, which
+  // returns false to keep the current one
+  template <typename Change>
+  void Publish(Change change);
+
+  std::atomic<const CatalogSnapshot *> snapshot_;
+
+  std::mutex publish_mutex_;
+
+  lock_free_locator::RetiredList<const CatalogSnapshot> retired_;
+};
+
+}  // namespace catalog
+}  // namespace peloton
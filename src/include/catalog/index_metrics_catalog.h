@@ -21,6 +21,13 @@
 // 4: deletes
 // 5: inserts
 // 6: time_stamp
+// 7: consolidations
+// 8: splits
+// 9: merges
+// 10: cas_failures
+// 11: epochs
+// 12: garbage_nodes
+// 13: delta_chain_threshold
 //
 // Indexes: (index offset: indexed columns)
 // 0: index_oid (unique & primary key)
@@ -50,7 +57,11 @@ class IndexMetricsCatalog : public AbstractCatalog {
   //===--------------------------------------------------------------------===//
   bool InsertIndexMetrics(oid_t database_oid, oid_t table_oid, oid_t index_oid,
                           int64_t reads, int64_t deletes, int64_t inserts,
-                          int64_t time_stamp, type::AbstractPool *pool,
+                          int64_t time_stamp, int64_t consolidations,
+                          int64_t splits, int64_t merges, int64_t cas_failures,
+                          int64_t epochs, int64_t garbage_nodes,
+                          int64_t delta_chain_threshold,
+                          type::AbstractPool *pool,
                           concurrency::Transaction *txn);
   bool DeleteIndexMetrics(oid_t index_oid, concurrency::Transaction *txn);
 
@@ -70,6 +81,13 @@ class IndexMetricsCatalog : public AbstractCatalog {
     DELETES = 4,
     INSERTS = 5,
     TIME_STAMP = 6,
+    CONSOLIDATIONS = 7,
+    SPLITS = 8,
+    MERGES = 9,
+    CAS_FAILURES = 10,
+    EPOCHS = 11,
+    GARBAGE_NODES = 12,
+    DELTA_CHAIN_THRESHOLD = 13,
     // Add new columns here in creation order
   };
 
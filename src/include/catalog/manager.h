@@ -17,15 +17,17 @@
 #include <mutex>
 #include <vector>
 #include <unordered_map>
+#include <deque>
 #include <memory>
 
 #include "common/macros.h"
 #include "type/types.h"
-#include "container/lock_free_array.h"
+#include "container/lock_free_locator.h"
 
 namespace peloton {
 
 namespace storage {
+class DataTable;
 class TileGroup;
 class IndirectionArray;
 }
@@ -62,6 +64,25 @@ class Manager {
 
   std::shared_ptr<storage::TileGroup> GetTileGroup(const oid_t oid);
 
+  // Resolves the tile group without taking a reference on it, for the hot
+  // paths that dereference item pointers. Only valid while the calling
+  // transaction is in its epoch: the tile groups dropped or replaced in the
+  // meantime are only released once that epoch has expired.
+  storage::TileGroup *ResolveTileGroup(const oid_t oid) {
+    return tile_group_locator_.FindPointer(oid);
+  }
+
+  // Releases the dropped tile groups no transaction can still resolve
+  size_t ReleaseRetiredTileGroups(const eid_t expired_eid);
+
+  // Takes over a table removed from its database, which the transactions
+  // of the current epoch may still scan, and destroys it once that epoch
+  // has expired
+  void RetireTable(storage::DataTable *table);
+
+  // Destroys the retired tables no transaction can still scan
+  size_t ReleaseRetiredTables(const eid_t expired_eid);
+
   void ClearTileGroup(void);
 
 
@@ -94,18 +115,25 @@ class Manager {
   //===--------------------------------------------------------------------===//
   std::atomic<oid_t> tile_group_oid_ = ATOMIC_VAR_INIT(START_OID);
 
-  LockFreeArray<std::shared_ptr<storage::TileGroup>> tile_group_locator_;
+  LockFreeLocator<storage::TileGroup> tile_group_locator_;
 
-  static std::shared_ptr<storage::TileGroup> empty_tile_group_;
+  void RetireTileGroup(std::shared_ptr<storage::TileGroup> tile_group);
+
+  // Dropped tile groups, with the epoch they were dropped in
+  std::mutex retired_tile_groups_mutex_;
+  std::deque<std::pair<eid_t, std::shared_ptr<storage::TileGroup>>>
+      retired_tile_groups_;
+
+  // Tables removed from their database, with the epoch they were removed in
+  std::mutex retired_tables_mutex_;
+  std::deque<std::pair<eid_t, storage::DataTable *>> retired_tables_;
 
   //===--------------------------------------------------------------------===//
   // Data members for indirection array allocation
   //===--------------------------------------------------------------------===//
   std::atomic<oid_t> indirection_array_oid_ = ATOMIC_VAR_INIT(START_OID);
 
-  LockFreeArray<std::shared_ptr<storage::IndirectionArray>> indirection_array_locator_;
-
-  static std::shared_ptr<storage::IndirectionArray> empty_indirection_array_;
+  LockFreeLocator<storage::IndirectionArray> indirection_array_locator_;
 };
 
 }  // End catalog namespace
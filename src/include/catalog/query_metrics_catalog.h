@@ -63,8 +63,22 @@ class QueryMetricsCatalog : public AbstractCatalog {
                           int64_t inserts, int64_t latency, int64_t cpu_time,
                           int64_t time_stamp, type::AbstractPool *pool,
                           concurrency::Transaction *txn);
+  // Append the tuples made by GetQueryMetricsTuple in bulk
+  bool InsertQueryMetrics(std::vector<std::unique_ptr<storage::Tuple>> tuples,
+                          concurrency::Transaction *txn);
   bool DeleteQueryMetrics(const std::string &name, oid_t database_oid,
                           concurrency::Transaction *txn);
+  // Delete the metrics of the queries recorded before the time stamp
+  bool DeleteQueryMetricsBefore(int64_t time_stamp,
+                                concurrency::Transaction *txn);
+
+  std::unique_ptr<storage::Tuple> GetQueryMetricsTuple(
+      const std::string &name, oid_t database_oid, int64_t num_params,
+      const stats::QueryMetric::QueryParamBuf &type_buf,
+      const stats::QueryMetric::QueryParamBuf &format_buf,
+      const stats::QueryMetric::QueryParamBuf &value_buf, int64_t reads,
+      int64_t updates, int64_t deletes, int64_t inserts, int64_t latency,
+      int64_t cpu_time, int64_t time_stamp, type::AbstractPool *pool);
 
   //===--------------------------------------------------------------------===//
   // Read-only Related API
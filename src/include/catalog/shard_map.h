@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_map.h
+//
+// Identification: src/include/catalog/shard_map.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "type/value.h"
+
+namespace peloton {
+namespace catalog {
+
+//===--------------------------------------------------------------------===//
+// Shard Map
+//===--------------------------------------------------------------------===//
+
+// How the rows of a sharded table are spread over the nodes
+enum class ShardingType {
+  HASH,  // by the hash of the shard key
+  RANGE  // by the range of the shard key, bounded by integers
+};
+
+// A sharded table and the column its rows are spread by
+struct ShardedTable {
+  std::string table_name;
+
+  std::string key_column;
+
+  ShardingType type;
+
+  // The lower bounds of the ranges after the first one. Range i goes to the
+  // node i modulo the number of nodes.
+  std::vector<int64_t> bounds;
+};
+
+// Where the sharded tables of the cluster live. Every node of the cluster
+// has the same map: the RPC servers of the nodes in node order, and the
+// tables whose rows are spread over them by a shard key. Each node stores
+// the rows of its shards in a local table of the same name, any other table
+// is local to the node.
+class ShardMap {
+ public:
+  ShardMap(const ShardMap &) = delete;
+  ShardMap &operator=(const ShardMap &) = delete;
+
+  ShardMap() {}
+
+  static ShardMap &GetInstance() {
+    static ShardMap shard_map;
+    return shard_map;
+  }
+
+  // Spread the tables of the comma separated table:hash:column or
+  // table:range:column:bound:... list over the nodes of the comma separated
+  // host:port addresses, this node being the one of the given id. No table
+  // is sharded if the addresses are empty. Returns false, and shards no
+  // table, if the configuration is invalid.
+  bool Configure(const std::string &node_addresses, const size_t node_id,
+                 const std::string &sharded_tables);
+
+  inline bool IsEnabled() const { return node_addresses_.empty() == false; }
+
+  size_t GetNodeCount() const { return node_addresses_.size(); }
+
+  size_t GetNodeId() const { return node_id_; }
+
+  const std::string &GetNodeAddress(const size_t node_id) const {
+    return node_addresses_[node_id];
+  }
+
+  // The sharded table of the name, nullptr if the table is not sharded
+  const ShardedTable *GetTable(const std::string &table_name) const;
+
+  // The node owning the rows with the shard key, which must not be NULL
+  size_t GetShard(const ShardedTable &table, const type::Value &key) const;
+
+ private:
+  bool ParseTable(const std::string &description, ShardedTable &table) const;
+
+  std::vector<std::string> node_addresses_;
+
+  size_t node_id_ = 0;
+
+  // The sharded tables by their lower case names
+  std::unordered_map<std::string, ShardedTable> tables_;
+};
+
+}  // End catalog namespace
+}  // End peloton namespace
@@ -53,6 +53,12 @@ class Aggregation {
   void AdvanceValues(CodeGen &codegen, llvm::Value *space,
                      const std::vector<codegen::Value> &next) const;
 
+  // Merge the aggregates stored in the other storage space into the ones
+  // stored in the provided storage space. Parallel pipelines merge the
+  // aggregates of their threads this way.
+  void MergeValues(CodeGen &codegen, llvm::Value *space,
+                   llvm::Value *other_space) const;
+
   // Compute the final values of all the aggregates stored in the provided
   // storage space, inserting them into the provided output vector.
   void FinalizeValues(CodeGen &codegen, llvm::Value *space,
@@ -112,6 +118,12 @@ class Aggregation {
                       const AggregateInfo &agg_info,
                       const codegen::Value &next) const;
 
+  // Merge the value of a specific aggregate computed elsewhere into the
+  // current one, without any NULL checking. This assumes that neither is NULL.
+  void DoMergeValue(CodeGen &codegen, llvm::Value *space,
+                    const AggregateInfo &agg_info,
+                    const codegen::Value &other) const;
+
  private:
   // Is this a global aggregation?
   bool is_global_;
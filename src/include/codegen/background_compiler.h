@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// background_compiler.h
+//
+// Identification: src/include/codegen/background_compiler.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+namespace peloton {
+
+namespace planner {
+class AbstractPlan;
+}  // namespace planner
+
+namespace codegen {
+
+struct CachedQuery;
+
+//===----------------------------------------------------------------------===//
+// Compiles queries into the QueryCache off the execution path. Plans whose
+// queries are not compiled yet run on the executors in the meantime.
+//
+// Compilation is tiered: a new query is compiled without the optimization
+// passes, so that it is available soon. Once it has run often enough, it is
+// compiled again with them, and the optimized query replaces it.
+//
+// The plan must have been bound before it is handed over. The compilation
+// binds it again, which only rewrites the attribute references that the
+// executors and the compiled queries do not read.
+//===----------------------------------------------------------------------===//
+class BackgroundCompiler {
+ public:
+  BackgroundCompiler(const BackgroundCompiler &) = delete;
+  BackgroundCompiler &operator=(const BackgroundCompiler &) = delete;
+  BackgroundCompiler(BackgroundCompiler &&) = delete;
+  BackgroundCompiler &operator=(BackgroundCompiler &&) = delete;
+
+  BackgroundCompiler();
+
+  ~BackgroundCompiler();
+
+  // Singleton
+  static BackgroundCompiler &GetInstance();
+
+  // Compile the query of the plan, unless it is being compiled already.
+  // Returns true if the compilation was queued.
+  bool Compile(std::shared_ptr<planner::AbstractPlan> plan,
+               const std::string &signature, bool optimize);
+
+  // Count an execution of the cached query, and queue its optimization once
+  // it turned hot
+  void CountExecution(const std::shared_ptr<CachedQuery> &cached_query);
+
+  // Wait for the queued compilations to finish
+  void WaitForAll();
+
+  // Number of queued compilations that did not finish yet
+  size_t GetPendingCount();
+
+  inline void SetOptimizeThreshold(const uint64_t threshold) {
+    optimize_threshold = threshold;
+  }
+
+ private:
+  struct CompileTask {
+    std::shared_ptr<planner::AbstractPlan> plan;
+    std::string signature;
+    bool optimize;
+  };
+
+  // Loop of the compiler thread
+  void Run();
+
+  // Compile the query of one task into the cache. Returns false if the plan
+  // cannot be compiled.
+  static bool CompileQuery(const CompileTask &task);
+
+ private:
+  std::deque<CompileTask> tasks;
+
+  // Signatures of the queued tasks and of the one being compiled
+  std::unordered_set<std::string> pending_signatures;
+
+  // Signatures of the plans that failed to compile, which are not queued
+  // again
+  std::unordered_set<std::string> failed_signatures;
+
+  std::mutex compiler_mutex;
+
+  // Signals new tasks to the compiler thread, and finished ones to waiters
+  std::condition_variable compiler_cv;
+
+  bool stop;
+
+  // Started with the first task
+  std::thread compiler_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Compiler Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Executions of an unoptimized query before it is optimized
+  uint64_t optimize_threshold = 16;
+};
+
+}  // namespace codegen
+}  // namespace peloton
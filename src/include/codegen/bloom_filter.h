@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bloom_filter.h
+//
+// Identification: src/include/codegen/bloom_filter.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/codegen.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// This class simplifies interaction with a codegen::util::BloomFilter instance
+// from generated code. Hashes are added and tested inline, the same way
+// util::BloomFilter::Add() and util::BloomFilter::Contains() do.
+//===----------------------------------------------------------------------===//
+class BloomFilter {
+ public:
+  // Initialize the given filter instance for the given number of entries
+  void Init(CodeGen &codegen, llvm::Value *bloom_filter_ptr,
+            uint64_t estimated_num_entries) const;
+
+  // Add the given hash to the given filter instance. Threads that add to the
+  // same instance at once must do so atomically.
+  void Add(CodeGen &codegen, llvm::Value *bloom_filter_ptr, llvm::Value *hash,
+           bool atomic) const;
+
+  // Generate a boolean that is false only if the given hash was never added
+  // to the given filter instance
+  llvm::Value *Contains(CodeGen &codegen, llvm::Value *bloom_filter_ptr,
+                        llvm::Value *hash) const;
+
+  void Destroy(CodeGen &codegen, llvm::Value *bloom_filter_ptr) const;
+
+ private:
+  // Get a pointer to the word of the filter the given hash lives in
+  llvm::Value *GetWordPtr(CodeGen &codegen, llvm::Value *bloom_filter_ptr,
+                          llvm::Value *hash) const;
+
+  // Get the bits the given hash sets in its word
+  llvm::Value *GetWordBits(CodeGen &codegen, llvm::Value *hash) const;
+};
+
+}  // namespace codegen
+}  // namespace peloton
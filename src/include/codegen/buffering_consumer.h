@@ -18,6 +18,7 @@
 #include "codegen/query_result_consumer.h"
 #include "codegen/value.h"
 #include "common/container_tuple.h"
+#include "common/statement.h"
 
 namespace peloton {
 
@@ -47,12 +48,25 @@ class WrappedTuple
 };
 
 //===----------------------------------------------------------------------===//
-// A query consumer that buffers tuples into a local memory location
+// A query consumer that buffers tuples into a local memory location.
+//
+// Tuples are buffered as WrappedTuples by default. Results that go straight to
+// the client are better written as the text columns of the wire protocol with
+// WriteResultsTo(), which the compiled query then appends every tuple to
+// without materializing any WrappedTuple. The compiled code is the same in
+// both cases, so a cached query can be executed either way.
 //===----------------------------------------------------------------------===//
 class BufferingConsumer : public QueryResultConsumer {
  public:
   struct BufferingState {
     std::vector<WrappedTuple> *output;
+    // If set, tuples are appended here column by column instead, in the
+    // wire formats of the columns if those are set
+    std::vector<StatementResult> *results;
+    const std::vector<int> *result_format;
+    // If set, takes the results whenever they hold chunk_rows tuples
+    const ResultCallback *callback;
+    size_t chunk_rows;
   };
 
   // Constructor
@@ -85,6 +99,20 @@ class BufferingConsumer : public QueryResultConsumer {
 
   BufferingState *GetState() { return &state; }
 
+  // Append the columns of all tuples to the given results in their wire
+  // formats, text by default, instead of buffering them as WrappedTuples.
+  // NULLs are empty. With a callback, the results are handed over every
+  // chunk_rows tuples.
+  void WriteResultsTo(std::vector<StatementResult> &results,
+                      const std::vector<int> *result_format = nullptr,
+                      const ResultCallback *callback = nullptr,
+                      size_t chunk_rows = 0) {
+    state.results = &results;
+    state.result_format = result_format;
+    state.callback = callback;
+    state.chunk_rows = chunk_rows;
+  }
+
   const std::vector<WrappedTuple> &GetOutputTuples() const { return tuples_; }
 
  private:
@@ -57,7 +57,7 @@ class CCHashTable : public HashTable {
                          VectorizedIterateCallback &callback) const override;
 
   // Generate code that iterates all the matches
-  void FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
+  void FindAll(CodeGen &codegen, llvm::Value *ht_ptr, llvm::Value *hash,
                const std::vector<codegen::Value> &key,
                HashTable::IterateCallback &callback) const override;
 
@@ -50,12 +50,26 @@ class CodeContext {
   // Get a pointer to the JITed function of the given type
   void *GetFunctionPointer(llvm::Function *fn) const;
 
-  // JIT the code contained within
-  bool Compile();
+  // JIT the code contained within. The optimization passes can be skipped to
+  // get the code sooner.
+  bool Compile(bool optimize = true);
+
+  // Keep the compiled code in the object cache under the given key, or load
+  // it from there if it has it. The names of the functions then derive from
+  // the key, so that they are those of the code an earlier process compiled.
+  void SetObjectCacheKey(const std::string &key);
+
+  // The name of the function of this context with the given suffix
+  std::string GetFunctionName(const std::string &suffix) const {
+    return "_" + std::to_string(name_id_) + "_" + suffix;
+  }
 
   // Dump the contents of all the code in this context
   void DumpContents() const;
 
+  // Write the IR of all the code in this context into the given file
+  void DumpIR(const std::string &file_name) const;
+
   //===--------------------------------------------------------------------===//
   // ACCESSORS
   //===--------------------------------------------------------------------===//
@@ -69,6 +83,18 @@ class CodeContext {
   // Get the module
   llvm::Module &GetModule() { return *module_; }
 
+  // Whether the code was loaded from the object cache instead of compiled
+  bool IsLoadedFromCache() const { return loaded_from_cache_; }
+
+  // The time the optimization passes and the emission of native code took
+  // when the code was compiled, in milliseconds
+  double GetOptimizeTime() const { return opt_ms_; }
+  double GetJITTime() const { return jit_ms_; }
+
+  // The number of functions and of IR instructions in them that were compiled
+  uint64_t GetFunctionCount() const { return num_functions_; }
+  uint64_t GetInstructionCount() const { return num_instructions_; }
+
  private:
   // Get the raw IR in text form
   std::string GetIR() const;
@@ -89,6 +115,12 @@ class CodeContext {
   // The ID/version of code
   uint64_t id_;
 
+  // The ID in the names of the functions
+  uint64_t name_id_;
+
+  // The key of the code in the object cache, empty if it is not kept there
+  std::string object_cache_key_;
+
   // The main context
   std::unique_ptr<llvm::LLVMContext> context_;
 
@@ -118,6 +150,13 @@ class CodeContext {
   llvm::Type *void_type_;
   llvm::PointerType *char_ptr_type_;
 
+  // Statistics of the compilation of the code
+  double opt_ms_;
+  double jit_ms_;
+  uint64_t num_functions_;
+  uint64_t num_instructions_;
+  bool loaded_from_cache_;
+
  private:
   // This class cannot be copy or move-constructed
   DISALLOW_COPY_AND_MOVE(CodeContext);
@@ -104,6 +104,12 @@ class CodeGen {
   void ThrowIfOverflow(llvm::Value *overflow) const;
   void ThrowIfDivideByZero(llvm::Value *divide_by_zero) const;
 
+  // Combine the overflow checks made until the batch is closed into a single
+  // branch. Only straight-line code whose results aren't used before the
+  // batch is closed may be batched.
+  void BeginOverflowBatch() const;
+  void EndOverflowBatch() const;
+
   //===--------------------------------------------------------------------===//
   // Function lookup and registration
   //===--------------------------------------------------------------------===//
@@ -139,6 +145,10 @@ class CodeGen {
   // Get the LLVM module
   llvm::Module &GetModule() const { return code_context_.GetModule(); }
 
+  // Get the branch weights of a branch into an error block, taken (almost)
+  // never
+  llvm::MDNode *GetErrorBranchWeights() const;
+
  private:
   // Get the LLVM IR Builder (also accessible through the -> operator overload)
   llvm::IRBuilder<> &GetBuilder() const { return code_context_.GetBuilder(); }
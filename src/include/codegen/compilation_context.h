@@ -22,6 +22,7 @@
 #include "codegen/operator/operator_translator.h"
 #include "codegen/query_compiler.h"
 #include "codegen/query.h"
+#include "codegen/query_parameters.h"
 #include "codegen/translator_factory.h"
 
 namespace peloton {
@@ -48,8 +49,10 @@ class CompilationContext {
   friend class RowBatch;
 
  public:
-  // Constructor
-  CompilationContext(Query &query, QueryResultConsumer &result_consumer);
+  // Constructor. If parameters are provided, the compiled code reads the
+  // constants and scan predicates of the plan from them at runtime.
+  CompilationContext(Query &query, QueryResultConsumer &result_consumer,
+                     const QueryParameters *parameters = nullptr);
 
   // Prepare a translator in this context
   void Prepare(const planner::AbstractPlan &op, Pipeline &pipeline);
@@ -84,6 +87,21 @@ class CompilationContext {
   // Get a pointer to the executor context instance
   llvm::Value *GetExecutorContextPtr();
 
+  // The parameters the query is compiled for, if any
+  const QueryParameters *GetQueryParameters() const { return parameters_; }
+
+  // Get a pointer to the parameter slot of the given constant or predicate
+  llvm::Value *GetParameterPtr(const expression::AbstractExpression &exp);
+
+  // Get the given predicate of the plan as an opaque pointer. The pointer is
+  // read from the parameters, so the predicate of the plan the query runs
+  // for is used.
+  llvm::Value *GetPredicatePtr(const expression::AbstractExpression &exp);
+
+  // Get the given plan node as an opaque pointer, read from the parameters
+  // like the predicates are
+  llvm::Value *GetPlanPtr(const planner::AbstractPlan &plan);
+
  private:
   // Generate any auxiliary helper functions that the query needs
   void GenerateHelperFunctions();
@@ -109,6 +127,9 @@ class CompilationContext {
   // The consumer of the results of the query
   QueryResultConsumer &result_consumer_;
 
+  // The parameters of the plan, if the query is compiled to be reused
+  const QueryParameters *parameters_;
+
   // The code generator
   CodeGen codegen_;
 
@@ -122,6 +143,7 @@ class CompilationContext {
   RuntimeState::StateID txn_state_id_;
   RuntimeState::StateID catalog_state_id_;
   RuntimeState::StateID executor_context_state_id_;
+  RuntimeState::StateID parameters_state_id_;
 
   // The mapping of an operator in the tree to its translator
   std::unordered_map<const planner::AbstractPlan *,
@@ -35,6 +35,10 @@ class ArithmeticTranslator : public ExpressionTranslator {
   // Produce the value that is the result of codegening the expression
   codegen::Value DeriveValue(CodeGen &codegen,
                              RowBatch::Row &row) const override;
+
+ private:
+  // Whether the overflow checks of the expression are made with one branch
+  bool batch_overflow_checks_;
 };
 
 }  // namespace codegen
@@ -34,6 +34,15 @@ class ConstantTranslator : public ExpressionTranslator {
   // Produce the value that is the result of codegen-ing the expression
   codegen::Value DeriveValue(CodeGen &codegen,
                              RowBatch::Row &row) const override;
+
+ private:
+  // Produce the value of the constant from the query parameters
+  codegen::Value DeriveParameterValue(
+      CodeGen &codegen, const expression::ConstantValueExpression &exp) const;
+
+ private:
+  // The context the constant is compiled in
+  CompilationContext &context_;
 };
 
 }  // namespace codegen
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// function_translator.h
+//
+// Identification: src/include/codegen/expression/function_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/expression/expression_translator.h"
+#include "codegen/runtime_state.h"
+
+namespace peloton {
+
+namespace expression {
+class FunctionExpression;
+}  // namespace expression
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A translator for calls of the built-in SQL functions (string, date and
+// decimal functions). The arguments are written out into an array of values,
+// which ValuesRuntime::CallFunction() passes to the function. The result comes
+// back in the native format of its type.
+//===----------------------------------------------------------------------===//
+class FunctionTranslator : public ExpressionTranslator {
+ public:
+  // Constructor
+  FunctionTranslator(const expression::FunctionExpression &func_expr,
+                     CompilationContext &context);
+
+  // Produce the result of calling the function
+  Value DeriveValue(CodeGen &codegen, RowBatch::Row &row) const override;
+
+ private:
+  CompilationContext &context_;
+
+  // The on-stack array of the arguments
+  RuntimeState::StateID args_id_;
+
+  // The on-stack slots of the result, and its length if it is a string
+  RuntimeState::StateID result_id_;
+  RuntimeState::StateID result_len_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_translator.h
+//
+// Identification: src/include/codegen/expression/like_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+
+#include "codegen/expression/expression_translator.h"
+
+namespace peloton {
+
+namespace expression {
+class ComparisonExpression;
+}  // namespace expression
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A translator for LIKE and NOT LIKE. Patterns that are constants of the query
+// are analyzed when it is compiled. The common shapes 'abc%', '%abc' and
+// '%abc%' are matched with a single prefix, suffix or substring comparison
+// against the literal characters, any other pattern with the general matcher.
+//===----------------------------------------------------------------------===//
+class LikeTranslator : public ExpressionTranslator {
+ public:
+  // Constructor
+  LikeTranslator(const expression::ComparisonExpression &like,
+                 CompilationContext &context);
+
+  // Produce the result of matching the string against the pattern
+  Value DeriveValue(CodeGen &codegen, RowBatch::Row &row) const override;
+
+ private:
+  // How strings are matched against the pattern
+  enum class MatchKind { Any, Prefix, Suffix, Substring, Pattern };
+
+  // Find how strings are matched against the given constant pattern
+  void AnalyzePattern(const std::string &pattern);
+
+ private:
+  MatchKind match_kind_;
+
+  // The literal characters of the pattern, for the prefix, suffix and
+  // substring matches
+  std::string literal_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
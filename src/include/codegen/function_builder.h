@@ -42,6 +42,17 @@ class FunctionBuilder {
   // Get the basic block where the function throws a divide by zero exception
   llvm::BasicBlock *GetDivideByZeroBB();
 
+  // Overflow checks made while a batch is open only record their overflow
+  // bits, which are checked together once the outermost batch is closed
+  void BeginOverflowBatch() { overflow_batch_depth_++; }
+
+  // Close a batch. Returns whether any overflow bit of the outermost batch is
+  // set, or nullptr if an outer batch is still open or nothing was recorded.
+  llvm::Value *EndOverflowBatch();
+
+  // Record the overflow bit in the open batch. Returns false if there is none.
+  bool AddToOverflowBatch(llvm::Value *overflow);
+
   // Finish the current function
   void ReturnAndFinish(llvm::Value *res = nullptr);
 
@@ -69,6 +80,10 @@ class FunctionBuilder {
   llvm::BasicBlock *overflow_bb_;
   // The divide-by-zero error block
   llvm::BasicBlock *divide_by_zero_bb_;
+  // The number of open overflow check batches, and whether any overflow bit
+  // recorded in them is set
+  uint32_t overflow_batch_depth_;
+  llvm::Value *batched_overflow_;
 
  private:
   // This class cannot be copy or move-constructed
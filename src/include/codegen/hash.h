@@ -46,15 +46,28 @@ class Hash {
       CodeGen &codegen, const std::vector<codegen::Value> &vals,
       Hash::HashMethod method = Hash::HashMethod::Crc32);
 
+  // Given the values of the same columns of several rows, produce the hash
+  // value of every row. The rows are hashed together, each hash is the one
+  // HashValues() produces for the values of its row alone.
+  static std::vector<llvm::Value *> HashValues(
+      CodeGen &codegen, const std::vector<std::vector<codegen::Value>> &rows,
+      Hash::HashMethod method = Hash::HashMethod::Crc32);
+
  private:
-  // Generate the calculation of a CRC64 hash for the given values
-  static llvm::Value *ComputeCRC32Hash(
-      CodeGen &codegen, const std::vector<llvm::Value *> &numerics,
-      const std::vector<Hash::Varlen> &buffers);
-
-  static llvm::Value *ComputeMurmur3Hash(
-      CodeGen &codegen, const std::vector<llvm::Value *> &numerics,
-      const std::vector<Hash::Varlen> &varlen_buffers);
+  // Split the values into 64-bit numerics and variable-length buffers
+  static void CollectHashInputs(CodeGen &codegen,
+                                const std::vector<codegen::Value> &vals,
+                                std::vector<llvm::Value *> &numerics,
+                                std::vector<Hash::Varlen> &varlens);
+
+  // Generate the calculation of a CRC64 hash for the given values of each row
+  static std::vector<llvm::Value *> ComputeCRC32Hash(
+      CodeGen &codegen, const std::vector<std::vector<llvm::Value *>> &numerics,
+      const std::vector<std::vector<Hash::Varlen>> &varlens);
+
+  static std::vector<llvm::Value *> ComputeMurmur3Hash(
+      CodeGen &codegen, const std::vector<std::vector<llvm::Value *>> &numerics,
+      const std::vector<std::vector<Hash::Varlen>> &varlen_buffers);
 };
 
 }  // namespace codegen
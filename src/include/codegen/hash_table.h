@@ -134,8 +134,9 @@ class HashTable {
                                  Vector &selection_vector,
                                  VectorizedIterateCallback &callback) const = 0;
 
-  // Generate code that iterates all the matches
-  virtual void FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
+  // Generate code that iterates all the matches. The hash of the key is
+  // computed if it isn't provided.
+  virtual void FindAll(CodeGen &codegen, llvm::Value *ht_ptr, llvm::Value *hash,
                        const std::vector<codegen::Value> &key,
                        IterateCallback &callback) const = 0;
 
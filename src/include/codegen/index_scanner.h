@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scanner.h
+//
+// Identification: src/include/codegen/index_scanner.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "common/macros.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace planner {
+class IndexScanPlan;
+}  // namespace planner
+
+namespace storage {
+class TileGroup;
+}  // namespace storage
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// This class handles index scans from generated code. The index is probed
+// through its regular scan APIs, and the versions of the matching tuples the
+// transaction sees are collected by tile group. The generated code then reads
+// the tuples of every tile group from the list of their offsets.
+//
+// Like the Deleter, the scanner lives in the runtime state and is initialized
+// (through Init()) outside the main loop.
+//===----------------------------------------------------------------------===//
+class IndexScanner {
+ public:
+  // Initialize this scanner for the given plan, whose index is scanned in the
+  // transaction of the given executor context
+  void Init(const planner::IndexScanPlan *plan,
+            executor::ExecutorContext *executor_context);
+
+  // Scan the index, and return the number of tile groups that hold visible
+  // tuples. If a read fails, the transaction fails and no tuples are returned.
+  uint32_t Scan();
+
+  // The tile group at the given index
+  storage::TileGroup *GetTileGroup(uint32_t tile_group_idx) const;
+
+  // The offsets of the visible tuples in the tile group at the given index
+  uint32_t *GetTids(uint32_t tile_group_idx) const;
+
+  // The number of visible tuples in the tile group at the given index
+  uint32_t GetTidCount(uint32_t tile_group_idx) const;
+
+  // Release the scanned tuples
+  void Destroy();
+
+ private:
+  // Can't construct
+  IndexScanner()
+      : plan_(nullptr), executor_context_(nullptr), results_(nullptr) {}
+
+  // Follow the version chain from the given location to the version the
+  // transaction sees. Returns false if the transaction must fail.
+  bool FindVisibleVersion(ItemPointer &location, bool &found) const;
+
+ private:
+  typedef std::pair<std::shared_ptr<storage::TileGroup>, std::vector<uint32_t>>
+      TileGroupTids;
+
+  // The plan of the scan
+  const planner::IndexScanPlan *plan_;
+
+  // The context the scan runs in
+  executor::ExecutorContext *executor_context_;
+
+  // The offsets of the visible tuples of every tile group
+  std::vector<TileGroupTids> *results_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(IndexScanner);
+};
+
+}  // namespace codegen
+}  // namespace peloton
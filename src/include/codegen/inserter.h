@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// inserter.h
+//
+// Identification: src/include/codegen/inserter.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/macros.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace planner {
+class InsertPlan;
+}  // namespace planner
+
+namespace storage {
+class DataTable;
+class ForeignKeyCache;
+class Tuple;
+}  // namespace storage
+
+namespace type {
+class Value;
+}  // namespace type
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// This class handles insertion of tuples from generated code. The generated
+// code writes the values of a tuple into the value buffer of the inserter,
+// which then builds the tuple and inserts it into the table.
+//
+// Like the Deleter, the inserter lives in the runtime state and is initialized
+// (through Init()) outside the main loop.
+//===----------------------------------------------------------------------===//
+class Inserter {
+ public:
+  // Initialize this inserter for inserts into the given table, in the
+  // transaction of the given executor context
+  void Init(storage::DataTable *table,
+            executor::ExecutorContext *executor_context);
+
+  // The buffer of values of the next tuple, one for every column of the table
+  char *GetValues() const;
+
+  // Insert the tuple in the value buffer. Returns false, and fails the
+  // transaction, if the tuple could not be inserted.
+  bool Insert();
+
+  // Insert the materialized tuples of the given plan
+  void InsertPlanTuples(const planner::InsertPlan *plan);
+
+  // Release the value buffer and the foreign key cache
+  void Destroy();
+
+ private:
+  // Can't construct
+  Inserter()
+      : table_(nullptr),
+        executor_context_(nullptr),
+        values_(nullptr),
+        tuple_(nullptr),
+        foreign_key_cache_(nullptr) {}
+
+  // Insert the given tuple into the table
+  bool InsertTuple(const storage::Tuple *tuple);
+
+ private:
+  // The table the tuples are inserted into
+  storage::DataTable *table_;
+
+  // The context the inserts happen in
+  executor::ExecutorContext *executor_context_;
+
+  // The values the generated code writes the next tuple into
+  peloton::type::Value *values_;
+
+  // The tuple the values are materialized in
+  storage::Tuple *tuple_;
+
+  // The referenced keys the inserts already found
+  storage::ForeignKeyCache *foreign_key_cache_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(Inserter);
+};
+
+}  // namespace codegen
+}  // namespace peloton
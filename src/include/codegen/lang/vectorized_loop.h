@@ -51,6 +51,11 @@ class VectorizedLoop {
   // Complete the loop
   void LoopEnd(CodeGen &codegen, const std::vector<llvm::Value *> &loop_vars);
 
+  // Complete the loop, which is left before the next range if the given
+  // condition is true
+  void LoopEnd(CodeGen &codegen, const std::vector<llvm::Value *> &loop_vars,
+               llvm::Value *break_condition);
+
   // Collect the final values of all loop variables
   void CollectFinalLoopVariables(std::vector<llvm::Value *> &loop_vals);
 
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// morsel_scheduler.h
+//
+// Identification: src/include/codegen/morsel_scheduler.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>
+#include <stdint.h>
+
+#include "common/thread_pool.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}  // namespace concurrency
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// Runs the table scans of parallel pipelines in compiled queries. The tile
+// groups of the table are split into morsels, which the calling thread and the
+// worker threads take from a shared counter until none are left. Threads that
+// finish early keep taking morsels, so skewed tile groups do not leave cores
+// idle.
+//
+// The calling thread scans into the runtime state of the query. Every worker
+// thread scans into its own copy, taken before the scan starts and set up by
+// the init function of the pipeline on its first morsel. The copies are
+// merged into the runtime state of the query once all morsels are scanned.
+//
+// Operators with many groups to merge split them into partitions instead. All
+// states, the one of the query first, are then merged partition by partition
+// on all threads, and the merge function of every worker only cleans up its
+// state afterwards.
+//
+// The transaction is shared with the workers while they scan, so that they
+// record the tuples they read under the lock of its read write set.
+//===----------------------------------------------------------------------===//
+class MorselScheduler {
+ public:
+  // Scan the tile groups in [tile_group_start, tile_group_end)
+  typedef void (*ScanFunction)(char *runtime_state, uint64_t tile_group_start,
+                               uint64_t tile_group_end);
+
+  // Set up the state a worker thread consumes tuples into
+  typedef void (*InitFunction)(char *thread_state);
+
+  // Merge the state of a worker thread into the runtime state of the query
+  typedef void (*MergeFunction)(char *runtime_state, char *thread_state);
+
+  // Merge a partition of the given states of all threads into the runtime
+  // state of the query
+  typedef void (*MergePartitionFunction)(char *runtime_state,
+                                         char **thread_states,
+                                         uint64_t num_thread_states,
+                                         uint64_t partition);
+
+  MorselScheduler(const MorselScheduler &) = delete;
+  MorselScheduler &operator=(const MorselScheduler &) = delete;
+  MorselScheduler(MorselScheduler &&) = delete;
+  MorselScheduler &operator=(MorselScheduler &&) = delete;
+
+  MorselScheduler();
+
+  ~MorselScheduler();
+
+  // Singleton
+  static MorselScheduler &GetInstance();
+
+  // Scan the tile groups [0, num_tile_groups) of a parallel pipeline. The
+  // states of the threads are merged in the given number of partitions if
+  // there is more than one. Exceptions thrown by the scan are rethrown once all
+  // threads are done.
+  void ExecuteParallelScan(concurrency::Transaction &txn, char *runtime_state,
+                           uint64_t state_size, uint64_t num_tile_groups,
+                           ScanFunction scan_func, InitFunction init_func,
+                           MergeFunction merge_func, uint64_t num_partitions,
+                           MergePartitionFunction merge_partition_func);
+
+  // Stop the worker threads. Later scans run on the calling thread only.
+  void Shutdown();
+
+  inline void SetMorselSize(const uint64_t size) { morsel_size = size; }
+
+ private:
+  // Number of threads to scan the given number of tile groups on, including
+  // the calling thread. Starts the worker threads on the first call.
+  uint64_t GetThreadCount(uint64_t num_tile_groups);
+
+ private:
+  ThreadPool worker_pool;
+
+  // Number of threads in the worker pool
+  uint64_t worker_count;
+
+  bool started;
+
+  bool stopped;
+
+  std::mutex scheduler_mutex;
+
+  //===--------------------------------------------------------------------===//
+  // Scheduler Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Number of tile groups in a morsel
+  uint64_t morsel_size = 1;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -32,9 +32,20 @@ class OAHashTable : public HashTable {
   // The default group prefetch distance
   static uint32_t kDefaultGroupPrefetchSize;
 
+  // Hash tables estimated to be at least this large are probed with group
+  // prefetching, since most of their probes miss the cache
+  static uint64_t kPrefetchThreshold;
+
   // A global pointer for attribute hashes
   static const planner::AttributeInfo kHashAI;
 
+  // The number of keys hashed together by HashAndPrefetch()
+  static constexpr uint32_t kHashBatchSize = 4;
+
+  // Collect the key of the row at the given position of a group
+  typedef std::function<void(llvm::Value *row_idx,
+                             std::vector<codegen::Value> &key)> KeyCollector;
+
   //===--------------------------------------------------------------------===//
   // Convenience class providing a random access interface over the hash-table
   //===--------------------------------------------------------------------===//
@@ -83,26 +94,40 @@ class OAHashTable : public HashTable {
   void Iterate(CodeGen &codegen, llvm::Value *ht_ptr,
                HashTable::IterateCallback &callback) const override;
 
+  // Generate code to iterate over the entries of the hash table whose hashes
+  // are in the given partition, out of 2^partition_bits
+  void IteratePartition(CodeGen &codegen, llvm::Value *ht_ptr,
+                        llvm::Value *partition, uint32_t partition_bits,
+                        HashTable::IterateCallback &callback) const;
+
   // Generate code to iterate over the entire hash table in vectorized fashion
   void VectorizedIterate(
       CodeGen &codegen, llvm::Value *ht_ptr, Vector &selection_vector,
       HashTable::VectorizedIterateCallback &callback) const override;
 
   // Generate code that iterates all the matches
-  void FindAll(CodeGen &codegen, llvm::Value *ht_ptr,
+  void FindAll(CodeGen &codegen, llvm::Value *ht_ptr, llvm::Value *hash,
                const std::vector<codegen::Value> &key,
                HashTable::IterateCallback &callback) const override;
 
   // An enum class indicating the type of prefetch (i.e., read or write)
-  enum class PrefetchType : uint32_t { Read = 0, Write = 0 };
+  enum class PrefetchType : uint32_t { Read = 0, Write = 1 };
 
   // An enum class indicating the temporal locality of the prefetched address
-  enum class Locality : uint32_t { None = 0, High = 1, Medium = 2, Low = 3 };
+  enum class Locality : uint32_t { None = 0, Low = 1, Medium = 2, High = 3 };
 
   // Prefetch the first bucket with the given hash value from the hash table
   void PrefetchBucket(CodeGen &codegen, llvm::Value *ht_ptr, llvm::Value *hash,
                       PrefetchType pf_type, Locality locality) const;
 
+  // Hash the keys of the rows [0, num_rows) of a group, storing the hash of
+  // each row in the given vector and prefetching its first bucket. The keys of
+  // kHashBatchSize rows at a time are hashed together.
+  void HashAndPrefetch(CodeGen &codegen, llvm::Value *ht_ptr,
+                       llvm::Value *num_rows, Vector &hashes,
+                       const KeyCollector &key_collector, PrefetchType pf_type,
+                       Locality locality) const;
+
   // Destroy/cleanup the hash table whose address is stored in the given LLVM
   // register/value
   void Destroy(CodeGen &codegen, llvm::Value *ht_ptr) const override;
@@ -130,6 +155,10 @@ class OAHashTable : public HashTable {
                         bool process_value, bool process_only_one_value,
                         bool create_key_if_missing) const;
 
+  void IterateEntries(CodeGen &codegen, llvm::Value *hash_table,
+                      llvm::Value *partition, uint32_t partition_bits,
+                      HashTable::IterateCallback &callback) const;
+
   llvm::Value *LoadHashTableField(CodeGen &codegen, llvm::Value *hash_table,
                                   uint32_t field_id) const;
 
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache.h
+//
+// Identification: src/include/codegen/object_cache.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+
+namespace peloton {
+namespace codegen {
+
+class QueryParameters;
+
+//===----------------------------------------------------------------------===//
+// The machine code of compiled queries kept in files, so that a new process
+// loads the code of the queries an earlier one compiled instead of compiling
+// them again. The code is only reused by the same build of Peloton on the
+// same CPU, for plans with the same signature over tables with the same
+// schemas.
+//
+// The code contexts of parameterized queries are given their key, the object
+// is then looked up when their code is emitted, and stored once it is
+// compiled if there was none.
+//===----------------------------------------------------------------------===//
+class ObjectCache : public llvm::ObjectCache {
+ public:
+  ObjectCache(const ObjectCache &) = delete;
+  ObjectCache &operator=(const ObjectCache &) = delete;
+
+  // Singleton
+  static ObjectCache &GetInstance();
+
+  // Keep the objects in the given directory, which is created if needed. An
+  // empty one disables the cache.
+  void SetDirectory(const std::string &directory);
+
+  bool IsEnabled();
+
+  // The key of the code compiled for the plan with the given parameters
+  static std::string GetKey(const QueryParameters &parameters, bool optimized);
+
+  // Whether there is an object for the given key
+  bool HasObject(const std::string &key);
+
+  // Store the object compiled for the module, whose identifier is its key
+  void notifyObjectCompiled(const llvm::Module *module,
+                            llvm::MemoryBufferRef object) override;
+
+  // The object stored for the module, or null
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module *module) override;
+
+  // The number of objects loaded and stored by this process
+  uint64_t GetLoadCount() const { return load_count_; }
+  uint64_t GetStoreCount() const { return store_count_; }
+
+ private:
+  ObjectCache();
+
+  // The file of the object for the given key in the directory
+  std::string GetFileName(const std::string &directory,
+                          const std::string &key) const;
+
+  // Whether there is an object for the given key, which is read into the
+  // given string if there is one
+  bool ReadObject(const std::string &key, std::string *object);
+
+ private:
+  // The build of Peloton, the version of LLVM and the CPU the objects are
+  // compiled for, stored with every object
+  std::string environment_;
+
+  // Guards the directory
+  std::mutex mutex_;
+  std::string directory_;
+
+  std::atomic<uint64_t> load_count_;
+  std::atomic<uint64_t> store_count_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -51,6 +51,12 @@ class GlobalGroupByTranslator : public OperatorTranslator {
   // No state to tear down
   void TearDownState() override {}
 
+  // Reset the aggregates of a thread of the parallel child pipeline
+  void InitializeThreadState() const override;
+
+  // Merge the aggregates of a thread of the parallel child pipeline
+  void MergeThreadState(llvm::Value *thread_state) const override;
+
   std::string GetName() const override;
 
  private:
@@ -35,6 +35,14 @@ class HashGroupByTranslator : public OperatorTranslator {
   // Global/configurable variable controlling whether hash aggregations prefetch
   static std::atomic<bool> kUsePrefetch;
 
+  // Global/configurable variable controlling whether the hash tables of the
+  // threads of parallel aggregations are always merged in partitions
+  static std::atomic<bool> kUsePartitionedMerge;
+
+  // The groups of parallel aggregations are merged in 2^kMergePartitionBits
+  // partitions
+  static constexpr uint32_t kMergePartitionBits = 4;
+
   // Constructor
   HashGroupByTranslator(const planner::AggregatePlan &group_by,
                         CompilationContext &context, Pipeline &pipeline);
@@ -55,6 +63,22 @@ class HashGroupByTranslator : public OperatorTranslator {
   // Codegen any cleanup work for this translator
   void TearDownState() override;
 
+  // Create the hash table of a thread of the parallel child pipeline
+  void InitializeThreadState() const override;
+
+  // Merge the groups of a thread of the parallel child pipeline, and destroy
+  // its hash table
+  void MergeThreadState(llvm::Value *thread_state) const override;
+
+  // The number of partitions the groups of the threads are merged in
+  uint32_t GetNumMergePartitions() const override;
+
+  // Merge the groups of all threads in the given partition into the hash
+  // table of the partition
+  void MergePartition(llvm::Value *thread_states,
+                      llvm::Value *num_thread_states,
+                      llvm::Value *partition) const override;
+
   // Get a stringified name for this hash-table based aggregation
   std::string GetName() const override;
 
@@ -121,6 +145,68 @@ class HashGroupByTranslator : public OperatorTranslator {
     const std::vector<codegen::Value> &initial_vals_;
   };
 
+  //===--------------------------------------------------------------------===//
+  // The callback used when iterating over the hash table of a thread of the
+  // parallel child pipeline. Every group is merged into the hash table of the
+  // query.
+  //===--------------------------------------------------------------------===//
+  class MergeGroups : public HashTable::IterateCallback {
+   public:
+    // Constructor
+    MergeGroups(const HashGroupByTranslator &translator,
+                llvm::Value *hash_table);
+
+    // The callback
+    void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &keys,
+                      llvm::Value *data_area) const override;
+
+   private:
+    // The translator of the group-by
+    const HashGroupByTranslator &translator_;
+    // The hash table the groups are merged into
+    llvm::Value *hash_table_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when merging a group of a thread into an existing group,
+  // whose aggregates are merged with the ones of the thread
+  //===--------------------------------------------------------------------===//
+  class MergeProbe : public HashTable::ProbeCallback {
+   public:
+    // Constructor
+    MergeProbe(const Aggregation &aggregation, llvm::Value *other_data_area);
+
+    // The callback
+    void ProcessEntry(CodeGen &codegen, llvm::Value *data_area) const override;
+
+   private:
+    // The guy that handles the computation of the aggregates
+    const Aggregation &aggregation_;
+    // The aggregates of the group of the thread
+    llvm::Value *other_data_area_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when merging a group of a thread that does not exist
+  // yet, whose aggregates are copied over
+  //===--------------------------------------------------------------------===//
+  class MergeInsert : public HashTable::InsertCallback {
+   public:
+    // Constructor
+    MergeInsert(const Aggregation &aggregation, llvm::Value *other_data_area);
+
+    // Copy the aggregates of the group of the thread into the storage
+    void StoreValue(CodeGen &codegen, llvm::Value *data_space) const override;
+
+    llvm::Value *GetValueSize(CodeGen &codegen) const override;
+
+   private:
+    // The guy that handles the computation of the aggregates
+    const Aggregation &aggregation_;
+    // The aggregates of the group of the thread
+    llvm::Value *other_data_area_;
+  };
+
   //===--------------------------------------------------------------------===//
   // An aggregate finalizer allows aggregations to delay the finalization of an
   // aggregate in the hash-table to a later time. This is needed when we do
@@ -170,6 +256,12 @@ class HashGroupByTranslator : public OperatorTranslator {
   // Should this operator employ prefetching?
   bool UsePrefetching() const;
 
+  // Should the groups of the threads be merged in partitions?
+  bool UsePartitionedMerge() const;
+
+  // The hash table of the given partition of the groups
+  llvm::Value *GetPartitionPtr(llvm::Value *partition) const;
+
   const planner::AggregatePlan &GetAggregatePlan() const { return group_by_; }
 
   const Aggregation &GetAggregation() const { return aggregation_; }
@@ -187,6 +279,11 @@ class HashGroupByTranslator : public OperatorTranslator {
   // The hash table
   OAHashTable hash_table_;
 
+  // The IDs of the hash tables of the partitions of a partitioned merge, and
+  // of the flag set once the groups are merged into them
+  RuntimeState::StateID partitions_id_;
+  RuntimeState::StateID partitioned_id_;
+
   // The ID of the output vector (for vectorized result production)
   RuntimeState::StateID output_vector_id_;
 
@@ -12,10 +12,12 @@
 
 #pragma once
 
+#include "codegen/bloom_filter.h"
 #include "codegen/compilation_context.h"
 #include "codegen/consumer_context.h"
 #include "codegen/oa_hash_table.h"
 #include "codegen/operator/operator_translator.h"
+#include "codegen/partitioned_buffer.h"
 #include "codegen/updateable_storage.h"
 
 namespace peloton {
@@ -27,13 +29,34 @@ class HashJoinPlan;
 namespace codegen {
 
 //===----------------------------------------------------------------------===//
-// The translator for a hash-join operator
+// The translator for a hash-join operator.
+//
+// When the estimated hash table of the build side is larger than the last
+// level cache, the join is radix-partitioned: both sides are first buffered
+// into partitions by the high bits of the hash of their keys, so that the hash
+// table of every partition fits in the cache. The partitions are then joined
+// one at a time. Partitioning runs in parallel when the child pipelines do.
+//
+// When the cardinality of the build side is known, the hashes of its keys are
+// also added to a Bloom filter. Probe-side tuples the filter does not contain
+// are dropped as soon as they arrive, before they probe the hash table or are
+// buffered into a partition.
+//
+// Joins probed one after another in the same pipeline form a chain. The lowest
+// join of a chain checks the Bloom filters of all the joins above it whose
+// probe keys it can compute, starting with the one with the smallest build
+// side. Tuples are dropped at the first filter ruling them out, before any
+// hash table is probed.
 //===----------------------------------------------------------------------===//
 class HashJoinTranslator : public OperatorTranslator {
  public:
   // Global/configurable variable controlling whether hash aggregations prefetch
   static std::atomic<bool> kUsePrefetch;
 
+  // Global/configurable variable controlling whether hash joins filter the
+  // probe side with a Bloom filter of the build side
+  static std::atomic<bool> kUseBloomFilter;
+
   HashJoinTranslator(const planner::HashJoinPlan &join,
                      CompilationContext &context, Pipeline &pipeline);
 
@@ -53,12 +76,44 @@ class HashJoinTranslator : public OperatorTranslator {
   // Codegen any cleanup work for this translator
   void TearDownState() override;
 
+  // Set up the partitions the tuples of a thread are buffered into
+  void InitializeThreadState() const override;
+
+  // Move the partitioned tuples of a thread into the partitions of the query
+  void MergeThreadState(llvm::Value *thread_state) const override;
+
   std::string GetName() const override;
 
  private:
+  // Join the buffered partitions of both sides one at a time
+  void JoinPartitions() const;
   // Consume the given context from the left/build side or the right/probe side
   void ConsumeFromLeft(ConsumerContext &context, RowBatch::Row &row) const;
   void ConsumeFromRight(ConsumerContext &context, RowBatch::Row &row) const;
+  void ProbeWithKey(ConsumerContext &context, RowBatch::Row &row,
+                    llvm::Value *hash,
+                    const std::vector<codegen::Value> &key) const;
+
+  // Check the Bloom filters of the given joins, starting at the given one,
+  // and probe with the key if none of them rules out the row
+  void ProbeWithFilters(
+      ConsumerContext &context, RowBatch::Row &row, llvm::Value *hash,
+      const std::vector<codegen::Value> &key,
+      const std::vector<const HashJoinTranslator *> &filter_joins,
+      uint32_t filter_idx) const;
+
+  // Get the joins whose Bloom filters the probe side of this join checks,
+  // in the order they are checked in
+  void GetFilterJoins(
+      std::vector<const HashJoinTranslator *> &filter_joins) const;
+
+  // Get the next join below (or above) this one in a chain of joins whose
+  // Bloom filters can be checked together, nullptr if there is none
+  const HashJoinTranslator *GetChainedJoin(bool above) const;
+
+  // The hash of the given key of the given row, null if it isn't needed
+  llvm::Value *GetKeyHash(CodeGen &codegen, RowBatch::Row &row,
+                          const std::vector<codegen::Value> &key) const;
 
   bool IsFromLeftChild(ConsumerContext &context) const {
     return context.GetPipeline().GetChild() == left_pipeline_.GetChild();
@@ -79,6 +134,20 @@ class HashJoinTranslator : public OperatorTranslator {
   // Should this operator employ prefetching?
   bool UsePrefetching() const;
 
+  // Should the probe side be filtered with a Bloom filter of the build side?
+  bool UseBloomFilter() const { return use_bloom_filter_; }
+
+  // Should both sides be partitioned before they are joined?
+  bool UseRadixPartitioning() const { return radix_bits_ > 0; }
+
+  // Can the Bloom filter be checked by a join below this one in the pipeline?
+  bool CanChainBloomFilter() const {
+    return UseBloomFilter() && !UseRadixPartitioning() && !UsePrefetching();
+  }
+
+  // The partition the tuple with the given key hash belongs to
+  llvm::Value *GetPartition(CodeGen &codegen, llvm::Value *hash) const;
+
   const planner::HashJoinPlan &GetJoinPlan() const { return join_; }
 
   //===--------------------------------------------------------------------===//
@@ -125,6 +194,65 @@ class HashJoinTranslator : public OperatorTranslator {
     const std::vector<codegen::Value> &values_;
   };
 
+  //===--------------------------------------------------------------------===//
+  // The callback used to insert the buffered tuples of a left-side partition
+  // into the hash table
+  //===--------------------------------------------------------------------===//
+  class BuildPartition : public PartitionedBuffer::IterateCallback {
+   public:
+    // Constructor
+    explicit BuildPartition(const HashJoinTranslator &join_translator)
+        : join_translator_(join_translator) {}
+
+    // Insert the buffered key and values into the hash table
+    void ProcessEntry(CodeGen &codegen,
+                      const std::vector<codegen::Value> &vals) const override;
+
+   private:
+    // The translator
+    const HashJoinTranslator &join_translator_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used to probe the hash table with the buffered tuples of a
+  // right-side partition
+  //===--------------------------------------------------------------------===//
+  class ProbePartition : public PartitionedBuffer::IterateCallback {
+   public:
+    // Constructor
+    explicit ProbePartition(const HashJoinTranslator &join_translator)
+        : join_translator_(join_translator) {}
+
+    // Probe the hash table with the buffered key, and send the buffered values
+    // of every match up the tree
+    void ProcessEntry(CodeGen &codegen,
+                      const std::vector<codegen::Value> &vals) const override;
+
+   private:
+    // The translator
+    const HashJoinTranslator &join_translator_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // An accessor into a buffered value of a right-side tuple
+  //===--------------------------------------------------------------------===//
+  class BufferedAttributeAccess : public RowBatch::AttributeAccess {
+   public:
+    // Constructor
+    BufferedAttributeAccess(const std::vector<codegen::Value> &vals,
+                            uint32_t index)
+        : vals_(vals), index_(index) {}
+
+    Value Access(CodeGen &, RowBatch::Row &) override { return vals_[index_]; }
+
+   private:
+    // The buffered values of the tuple
+    const std::vector<codegen::Value> &vals_;
+
+    // The value this accessor is for
+    uint32_t index_;
+  };
+
  private:
   // The hash join plan node that contains all the information we need
   const planner::HashJoinPlan &join_;
@@ -132,6 +260,10 @@ class HashJoinTranslator : public OperatorTranslator {
   // The build-side pipeline
   Pipeline left_pipeline_;
 
+  // The probe-side pipeline, if the join is radix-partitioned. Otherwise, the
+  // probe side is part of the pipeline of this join.
+  Pipeline right_pipeline_;
+
   // The ID of the hash-table in the runtime state
   RuntimeState::StateID hash_table_id_;
 
@@ -153,6 +285,31 @@ class HashJoinTranslator : public OperatorTranslator {
 
   // Does this join need an output vector
   bool needs_output_vector_;
+
+  // The number of high hash bits the partition of a tuple is taken from, zero
+  // if the join is not radix-partitioned
+  uint32_t radix_bits_;
+
+  // The IDs of the partitioned buffers of both sides in the runtime state
+  RuntimeState::StateID left_partitions_id_;
+  RuntimeState::StateID right_partitions_id_;
+
+  // The partitioned buffers: the left one holds the build-side keys followed
+  // by the build-side values, the right one the probe-side keys followed by
+  // the probe-side attributes the join and its parent use
+  PartitionedBuffer left_buffer_;
+  PartitionedBuffer right_buffer_;
+
+  // The probe-side attributes in the right partitioned buffer
+  std::vector<const planner::AttributeInfo *> right_ais_;
+
+  // The ID of the selection vector of the rows produced from the partitions
+  RuntimeState::StateID radix_output_vector_id_;
+
+  // The Bloom filter of the build-side keys, and its ID in the runtime state
+  bool use_bloom_filter_;
+  BloomFilter bloom_filter_;
+  RuntimeState::StateID bloom_filter_id_;
 };
 
 }  // namespace codegen
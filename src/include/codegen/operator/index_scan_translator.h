@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_translator.h
+//
+// Identification: src/include/codegen/operator/index_scan_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/consumer_context.h"
+#include "codegen/operator/operator_translator.h"
+#include "codegen/scan_callback.h"
+#include "codegen/tile_group.h"
+#include "codegen/vector.h"
+
+namespace peloton {
+
+namespace planner {
+class IndexScanPlan;
+}  // namespace planner
+
+namespace storage {
+class DataTable;
+}  // namespace storage
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// A translator for index scans. The index is probed by the IndexScanner in the
+// runtime state, which collects the visible tuples that match the keys of the
+// plan by tile group. The generated code then reads the tuples of every tile
+// group like a table scan does, filters them by the predicate of the plan and
+// pushes them into the pipeline.
+//===----------------------------------------------------------------------===//
+class IndexScanTranslator : public OperatorTranslator {
+ public:
+  // Constructor
+  IndexScanTranslator(const planner::IndexScanPlan &scan,
+                      CompilationContext &context, Pipeline &pipeline);
+
+  // Initialize the index scanner
+  void InitializeState() override;
+
+  // Index scans don't rely on any auxiliary functions
+  void DefineAuxiliaryFunctions() override {}
+
+  // The method that produces new tuples
+  void Produce() const override;
+
+  // Scans are leaves in the query plan and, hence, do not consume tuples
+  void Consume(ConsumerContext &, RowBatch &) const override {}
+  void Consume(ConsumerContext &, RowBatch::Row &) const override {}
+
+  // Release the tuples of the index scanner
+  void TearDownState() override;
+
+  // Get a stringified version of this translator
+  std::string GetName() const override;
+
+ private:
+  //===--------------------------------------------------------------------===//
+  // An attribute accessor that uses the backing tile group to access columns
+  //===--------------------------------------------------------------------===//
+  class AttributeAccess : public RowBatch::AttributeAccess {
+   public:
+    // Constructor
+    AttributeAccess(const TileGroup::TileGroupAccess &access,
+                    const planner::AttributeInfo *ai);
+
+    // Access an attribute in the given row
+    codegen::Value Access(CodeGen &codegen, RowBatch::Row &row) override;
+
+    const planner::AttributeInfo *GetAttributeRef() const { return ai_; }
+
+   private:
+    // The accessor we use to load column values
+    const TileGroup::TileGroupAccess &tile_group_access_;
+    // The attribute we will access
+    const planner::AttributeInfo *ai_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The class responsible for generating the scan code over the list of TIDs
+  // of a tile group
+  //===--------------------------------------------------------------------===//
+  class ScanConsumer : public codegen::ScanCallback {
+   public:
+    // Constructor
+    ScanConsumer(const IndexScanTranslator &translator, llvm::Value *tids);
+
+    // The callback when starting iteration over a new tile group
+    void TileGroupStart(CodeGen &, llvm::Value *tile_group_id,
+                        llvm::Value *) override {
+      tile_group_id_ = tile_group_id;
+    }
+
+    // The code that forms the body of the scan loop, over the positions
+    // [start, end) in the list of TIDs
+    void ProcessTuples(CodeGen &codegen, llvm::Value *start, llvm::Value *end,
+                       TileGroup::TileGroupAccess &tile_group_access) override;
+
+    // The callback when finishing iteration over a tile group
+    void TileGroupFinish(CodeGen &, llvm::Value *) override {}
+
+    // The scan is ended early once an operator in its pipeline is finished
+    llvm::Value *IsFinished(CodeGen &codegen) override {
+      return translator_.GetPipeline().IsFinished(codegen);
+    }
+
+   private:
+    void SetupRowBatch(RowBatch &batch,
+                       TileGroup::TileGroupAccess &tile_group_access,
+                       std::vector<AttributeAccess> &access) const;
+
+    // Filter the rows whose TIDs are in the selection vector by the predicate
+    // of the scan, compacting the vector in place
+    void FilterRowsByPredicate(CodeGen &codegen,
+                               const TileGroup::TileGroupAccess &access,
+                               llvm::Value *num_tids,
+                               Vector &selection_vector) const;
+
+   private:
+    // The translator instance the consumer is generating code for
+    const IndexScanTranslator &translator_;
+
+    // The TIDs of the tile group, which the batches are filtered in place
+    llvm::Value *tids_;
+
+    // The current tile group id we're scanning over
+    llvm::Value *tile_group_id_;
+  };
+
+  // Plan accessor
+  const planner::IndexScanPlan &GetScanPlan() const { return scan_; }
+
+  // Table accessor
+  const storage::DataTable &GetTable() const;
+
+ private:
+  // The scan
+  const planner::IndexScanPlan &scan_;
+
+  // The ID of the index scanner in runtime state
+  RuntimeState::StateID index_scanner_id_;
+
+  // The code-generating tile group instance
+  codegen::TileGroup tile_group_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// insert_translator.h
+//
+// Identification: src/include/codegen/operator/insert_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/consumer_context.h"
+#include "codegen/operator/operator_translator.h"
+
+namespace peloton {
+
+namespace planner {
+class InsertPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for an insert operator
+//===----------------------------------------------------------------------===//
+class InsertTranslator : public OperatorTranslator {
+ public:
+  InsertTranslator(const planner::InsertPlan &insert_plan,
+                   CompilationContext &context, Pipeline &pipeline);
+
+  void InitializeState() override;
+
+  void DefineAuxiliaryFunctions() override {}
+
+  void TearDownState() override;
+
+  std::string GetName() const override { return "Insert"; }
+
+  void Produce() const override;
+
+  void Consume(ConsumerContext &, RowBatch::Row &) const override;
+
+ private:
+  // The insert plan
+  const planner::InsertPlan &insert_plan_;
+
+  // The Inserter instance
+  RuntimeState::StateID inserter_state_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// limit_translator.h
+//
+// Identification: src/include/codegen/operator/limit_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/operator/operator_translator.h"
+
+namespace peloton {
+
+namespace planner {
+class LimitPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for a limit (with offset) operator. The tuples it consumes
+// are counted in the runtime state. Only the ones past the offset and within
+// the limit are passed on, and once the limit is reached, the scan producing
+// the tuples stops.
+//===----------------------------------------------------------------------===//
+class LimitTranslator : public OperatorTranslator {
+ public:
+  LimitTranslator(const planner::LimitPlan &plan, CompilationContext &context,
+                  Pipeline &pipeline);
+
+  void InitializeState() override;
+
+  void DefineAuxiliaryFunctions() override {}
+
+  void TearDownState() override {}
+
+  std::string GetName() const override { return "Limit"; }
+
+  void Produce() const override;
+
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+  // The limit is finished once offset + limit tuples went through it
+  llvm::Value *IsFinished() const override;
+
+ private:
+  // The number of tuples to consume before the limit is reached
+  uint64_t GetEndCount() const;
+
+ private:
+  // The plan
+  const planner::LimitPlan &plan_;
+
+  // The number of tuples consumed so far
+  RuntimeState::StateID count_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_join_translator.h
+//
+// Identification: src/include/codegen/operator/nested_loop_join_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/consumer_context.h"
+#include "codegen/operator/operator_translator.h"
+#include "codegen/sorter.h"
+
+namespace peloton {
+
+namespace planner {
+class NestedLoopJoinPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for a nested-loop join operator. The right (inner) child is
+// materialized into a buffer first. Every tuple of the left (outer) child is
+// then joined with all buffered tuples that satisfy the join predicate. The
+// buffer is a sorter instance that is never sorted.
+//===----------------------------------------------------------------------===//
+class NestedLoopJoinTranslator : public OperatorTranslator {
+ public:
+  NestedLoopJoinTranslator(const planner::NestedLoopJoinPlan &join,
+                           CompilationContext &context, Pipeline &pipeline);
+
+  // Codegen any initialization work for this operator
+  void InitializeState() override;
+
+  // Define any helper functions this translator needs
+  void DefineAuxiliaryFunctions() override {}
+
+  // The method that produces new tuples
+  void Produce() const override;
+
+  // The method that consumes tuples from child operators
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+  // Codegen any cleanup work for this translator
+  void TearDownState() override;
+
+  std::string GetName() const override;
+
+ private:
+  // Consume the given row from the left/outer side or the right/inner side
+  void ConsumeFromLeft(ConsumerContext &context, RowBatch::Row &row) const;
+  void ConsumeFromRight(ConsumerContext &context, RowBatch::Row &row) const;
+
+  bool IsFromRightChild(ConsumerContext &context) const {
+    return context.GetPipeline().GetChild() == right_pipeline_.GetChild();
+  }
+
+  // Collect the attributes of the right child the expression uses
+  void CollectRightAttributes(const expression::AbstractExpression &exp);
+
+  const planner::NestedLoopJoinPlan &GetJoinPlan() const { return join_; }
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when iterating the buffered tuples of the right side for
+  // a tuple of the left side
+  //===--------------------------------------------------------------------===//
+  class JoinRight : public Sorter::IterateCallback {
+   public:
+    // Constructor
+    JoinRight(const NestedLoopJoinTranslator &join_translator,
+              ConsumerContext &context, RowBatch::Row &row);
+
+    // The callback
+    void ProcessEntry(CodeGen &codegen,
+                      const std::vector<codegen::Value> &vals) const override;
+
+   private:
+    // The translator of the join
+    const NestedLoopJoinTranslator &join_translator_;
+    // The consumer context
+    ConsumerContext &context_;
+    // The row from the left side
+    RowBatch::Row &row_;
+  };
+
+ private:
+  // The join plan
+  const planner::NestedLoopJoinPlan &join_;
+
+  // The pipeline of the right child, which ends at the buffer
+  Pipeline right_pipeline_;
+
+  // The attributes of the right side that are buffered
+  std::vector<const planner::AttributeInfo *> right_ais_;
+
+  // The ID of the buffer in the runtime state
+  RuntimeState::StateID buffer_id_;
+
+  // The buffer of the tuples of the right side
+  Sorter buffer_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
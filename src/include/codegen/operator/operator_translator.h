@@ -38,6 +38,12 @@ class ConsumerContext;
 // must be defined and implemented in the DefineAuxiliaryFunctions() method,
 // which is
 // guaranteed to be called on all operators before any other method.
+//
+// Operators in a parallel pipeline consume tuples on several threads, each
+// with its own copy of the runtime state. The operator ending the pipeline
+// initializes the state it consumes tuples into in InitializeThreadState() for
+// every thread, and merges it into the state of the query in
+// MergeThreadState().
 //===----------------------------------------------------------------------===//
 class OperatorTranslator {
  public:
@@ -63,6 +69,35 @@ class OperatorTranslator {
   // Codegen any cleanup work for this translator
   virtual void TearDownState() = 0;
 
+  // Can this operator consume tuples on several threads at once. Only
+  // operators that keep no state while consuming tuples can.
+  virtual bool IsParallelSafe() const { return false; }
+
+  // Codegen the initialization of the state this operator consumes tuples
+  // into on a thread of a parallel pipeline it ends
+  virtual void InitializeThreadState() const {}
+
+  // Codegen merging the state of a thread of a parallel pipeline this
+  // operator ends into the state of the query, cleaning up the former
+  virtual void MergeThreadState(llvm::Value *) const {}
+
+  // The number of partitions the states of the threads of a parallel pipeline
+  // this operator ends are merged in. With more than one, all partitions are
+  // merged on several threads in MergePartition() first, after which
+  // MergeThreadState() only cleans up the state of every thread.
+  virtual uint32_t GetNumMergePartitions() const { return 1; }
+
+  // Codegen merging a partition of the states of all threads of a parallel
+  // pipeline this operator ends into the state of the query. The states are
+  // an array of pointers, the first being the state of the query itself.
+  virtual void MergePartition(llvm::Value *, llvm::Value *,
+                              llvm::Value *) const {}
+
+  // Codegen the check whether this operator needs no more tuples from its
+  // pipeline, which lets the scan starting the pipeline stop early. Operators
+  // that consume every tuple return nullptr.
+  virtual llvm::Value *IsFinished() const { return nullptr; }
+
   virtual std::string GetName() const = 0;
 
  protected:
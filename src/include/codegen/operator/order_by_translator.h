@@ -40,12 +40,22 @@ class OrderByTranslator : public OperatorTranslator {
 
   void TearDownState() override;
 
+  // Create the sorter of a thread of the parallel child pipeline
+  void InitializeThreadState() const override;
+
+  // Move the tuples of a thread of the parallel child pipeline into the
+  // sorter of the query, and destroy the sorter of the thread
+  void MergeThreadState(llvm::Value *thread_state) const override;
+
   std::string GetName() const override;
 
  private:
   // Accessor
   const planner::OrderByPlan &GetPlan() const { return plan_; }
 
+  // The number of tuples of the sort order the sorter keeps
+  uint64_t GetTopK() const;
+
   //===--------------------------------------------------------------------===//
   // The call back used when iterating over the results in the sorter instance
   //===--------------------------------------------------------------------===//
@@ -49,6 +49,9 @@ class ProjectionTranslator : public OperatorTranslator {
   // No state to tear down
   void TearDownState() override {}
 
+  // Projections keep no state, and can run in parallel pipelines
+  bool IsParallelSafe() const override { return true; }
+
   // Get the stringified name of this translator
   std::string GetName() const override;
 
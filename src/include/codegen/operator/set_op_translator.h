@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// set_op_translator.h
+//
+// Identification: src/include/codegen/operator/set_op_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/consumer_context.h"
+#include "codegen/oa_hash_table.h"
+#include "codegen/operator/operator_translator.h"
+
+namespace peloton {
+
+namespace planner {
+class SetOpPlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for the INTERSECT (ALL) and EXCEPT (ALL) set operations. The
+// tuples of both children are counted in a hash table keyed on all columns.
+// The left child inserts the distinct tuples, the right child only counts the
+// tuples it finds. Each entry is then produced as many times as the set
+// operation asks for, given both counts.
+//===----------------------------------------------------------------------===//
+class SetOpTranslator : public OperatorTranslator {
+ public:
+  // Constructor
+  SetOpTranslator(const planner::SetOpPlan &plan, CompilationContext &context,
+                  Pipeline &pipeline);
+
+  // Codegen any initialization work for this operator
+  void InitializeState() override;
+
+  // Define any helper functions this translator needs
+  void DefineAuxiliaryFunctions() override {}
+
+  // The method that produces new tuples
+  void Produce() const override;
+
+  // The method that consumes tuples from child operators
+  void Consume(ConsumerContext &context, RowBatch::Row &row) const override;
+
+  // Codegen any cleanup work for this translator
+  void TearDownState() override;
+
+  std::string GetName() const override;
+
+ private:
+  bool IsFromLeftChild(ConsumerContext &context) const {
+    return context.GetPipeline().GetChild() == left_pipeline_.GetChild();
+  }
+
+  // Compute the number of copies of an entry with the given counts to produce
+  llvm::Value *GetOutputCount(CodeGen &codegen, llvm::Value *left_count,
+                              llvm::Value *right_count) const;
+
+  //===--------------------------------------------------------------------===//
+  // The callbacks to count tuples of the left side in the hash table
+  //===--------------------------------------------------------------------===//
+  class CountLeft : public HashTable::ProbeCallback {
+   public:
+    void ProcessEntry(CodeGen &codegen, llvm::Value *data_area) const override;
+  };
+
+  class InsertLeft : public HashTable::InsertCallback {
+   public:
+    void StoreValue(CodeGen &codegen, llvm::Value *space) const override;
+    llvm::Value *GetValueSize(CodeGen &codegen) const override;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback to count the tuples of the right side found in the hash table
+  //===--------------------------------------------------------------------===//
+  class CountRight : public HashTable::IterateCallback {
+   public:
+    void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                      llvm::Value *data_area) const override;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The callback used when producing the entries of the hash table
+  //===--------------------------------------------------------------------===//
+  class ProduceResults : public HashTable::IterateCallback {
+   public:
+    // Constructor
+    ProduceResults(const SetOpTranslator &translator);
+
+    // The callback
+    void ProcessEntry(CodeGen &codegen, const std::vector<codegen::Value> &key,
+                      llvm::Value *data_area) const override;
+
+   private:
+    // The translator
+    const SetOpTranslator &translator_;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // An accessor into a (key) value of the entry currently being produced
+  //===--------------------------------------------------------------------===//
+  class KeyAttributeAccess : public RowBatch::AttributeAccess {
+   public:
+    // Constructor
+    KeyAttributeAccess(const std::vector<codegen::Value> &key,
+                       uint32_t key_index)
+        : key_(key), key_index_(key_index) {}
+
+    Value Access(CodeGen &, RowBatch::Row &) override {
+      return key_[key_index_];
+    }
+
+   private:
+    // The key of the entry
+    const std::vector<codegen::Value> &key_;
+
+    // The value this accessor is for
+    uint32_t key_index_;
+  };
+
+ private:
+  // The plan
+  const planner::SetOpPlan &plan_;
+
+  // The pipelines of the left and right child
+  Pipeline left_pipeline_;
+  Pipeline right_pipeline_;
+
+  // The ID of the hash table in the runtime state
+  RuntimeState::StateID hash_table_id_;
+
+  // The ID of our output vector in the runtime state
+  RuntimeState::StateID output_vector_id_;
+
+  // The hash table counting the tuples of both sides
+  OAHashTable hash_table_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
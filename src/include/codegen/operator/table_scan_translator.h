@@ -39,7 +39,8 @@ class TableScanTranslator : public OperatorTranslator {
   TableScanTranslator(const planner::SeqScanPlan &scan,
                       CompilationContext &context, Pipeline &pipeline);
 
-  void InitializeState() override {}
+  // Scans filtering by a chain of ANDs create the order of its terms
+  void InitializeState() override;
 
   // Table scans don't rely on any auxiliary functions
   void DefineAuxiliaryFunctions() override {}
@@ -51,8 +52,10 @@ class TableScanTranslator : public OperatorTranslator {
   void Consume(ConsumerContext &, RowBatch &) const override {}
   void Consume(ConsumerContext &, RowBatch::Row &) const override {}
 
-  // Similar to InitializeState(), table scans don't have any state
-  void TearDownState() override {}
+  void TearDownState() override;
+
+  // Table scans can be split into morsels of tile groups scanned in parallel
+  bool IsParallelSafe() const override { return true; }
 
   // Get a stringified version of this translator
   std::string GetName() const override;
@@ -103,6 +106,11 @@ class TableScanTranslator : public OperatorTranslator {
     // The callback when finishing iteration over a tile group
     void TileGroupFinish(CodeGen &, llvm::Value *) override {}
 
+    // The scan is ended early once an operator in its pipeline is finished
+    llvm::Value *IsFinished(CodeGen &codegen) override {
+      return translator_.GetPipeline().IsFinished(codegen);
+    }
+
    private:
     // Get the predicate, if one exists
     const expression::AbstractExpression *GetPredicate() const;
@@ -115,6 +123,11 @@ class TableScanTranslator : public OperatorTranslator {
                                 llvm::Value *tid_end,
                                 Vector &selection_vector) const;
 
+    // Drop the rows of a frozen tile group that its encoded columns rule out
+    // for the predicate
+    void FilterRowsByFrozenColumns(CodeGen &codegen,
+                                   Vector &selection_vector) const;
+
     // Filter all the rows whose TIDs are in the range [tid_start, tid_end] and
     // store their TIDs in the output TID selection vector
     void FilterRowsByPredicate(CodeGen &codegen,
@@ -122,8 +135,32 @@ class TableScanTranslator : public OperatorTranslator {
                                llvm::Value *tid_start, llvm::Value *tid_end,
                                Vector &selection_vector) const;
 
-    llvm::Value *SIMDFilterRows(RowBatch &batch,
-                                const TileGroup::TileGroupAccess &access) const;
+    // Filter the rows by a chain of ANDs, term by term in the order of the
+    // ConjunctionOrder of the scan
+    void FilterRowsByTerms(CodeGen &codegen,
+                           const TileGroup::TileGroupAccess &access,
+                           llvm::Value *tid_start, llvm::Value *tid_end,
+                           Vector &selection_vector) const;
+
+    // Filter the rows by the term of the order, which is one of the terms
+    // [term_idx, terms.size()), and return the number of rows left
+    llvm::Value *FilterRowsByTerm(
+        CodeGen &codegen, const TileGroup::TileGroupAccess &access,
+        llvm::Value *tid_start, llvm::Value *tid_end,
+        const std::vector<const expression::AbstractExpression *> &terms,
+        llvm::Value *term, uint32_t term_idx, Vector &selection_vector) const;
+
+    // Filter the rows by evaluating the expression on one row at a time
+    void FilterRowsByExpression(CodeGen &codegen,
+                                const TileGroup::TileGroupAccess &access,
+                                llvm::Value *tid_start, llvm::Value *tid_end,
+                                const expression::AbstractExpression &exp,
+                                Vector &selection_vector) const;
+
+    // Filter the rows of the batch by a predicate that is evaluated on
+    // vectors of rows at once
+    void SIMDFilterRows(CodeGen &codegen, RowBatch &batch,
+                        const TileGroup::TileGroupAccess &access) const;
 
    private:
     // The translator instance the consumer is generating code for
@@ -139,6 +176,18 @@ class TableScanTranslator : public OperatorTranslator {
     llvm::Value *tile_group_ptr_;
   };
 
+  // Get the table instance from the database
+  llvm::Value *GetTablePtr() const;
+
+  // Generate the scan over the tile groups in the range [tile_group_start,
+  // tile_group_end) of the table
+  void ProduceTileGroups(llvm::Value *table_ptr, llvm::Value *tile_group_start,
+                         llvm::Value *tile_group_end) const;
+
+  // Generate the scan of a parallel pipeline, which is dispatched in morsels
+  // to several threads
+  void ProduceParallel(llvm::Value *num_tile_groups) const;
+
   // Plan accessor
   const planner::SeqScanPlan &GetScanPlan() const { return scan_; }
 
@@ -152,6 +201,11 @@ class TableScanTranslator : public OperatorTranslator {
   // The ID of the selection vector in runtime state
   RuntimeState::StateID selection_vector_id_;
 
+  // Whether the terms of the predicate are reordered at runtime, and the ID
+  // of their ConjunctionOrder in runtime state
+  bool reorders_terms_;
+  RuntimeState::StateID conjunction_order_id_;
+
   // The code-generating table instance
   codegen::Table table_;
 };
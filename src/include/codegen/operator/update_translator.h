@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// update_translator.h
+//
+// Identification: src/include/codegen/operator/update_translator.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/compilation_context.h"
+#include "codegen/consumer_context.h"
+#include "codegen/operator/operator_translator.h"
+
+namespace peloton {
+
+namespace planner {
+class UpdatePlan;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The translator for an update operator
+//===----------------------------------------------------------------------===//
+class UpdateTranslator : public OperatorTranslator {
+ public:
+  UpdateTranslator(const planner::UpdatePlan &update_plan,
+                   CompilationContext &context, Pipeline &pipeline);
+
+  void InitializeState() override;
+
+  void DefineAuxiliaryFunctions() override {}
+
+  void TearDownState() override;
+
+  std::string GetName() const override { return "Update"; }
+
+  void Produce() const override;
+
+  void Consume(ConsumerContext &, RowBatch::Row &) const override;
+
+ private:
+  // The update plan
+  const planner::UpdatePlan &update_plan_;
+
+  // The Updater instance
+  RuntimeState::StateID updater_state_id_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_buffer.h
+//
+// Identification: src/include/codegen/partitioned_buffer.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/updateable_storage.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// This class simplifies interaction with a codegen::util::PartitionedBuffer
+// instance from generated code.
+//===----------------------------------------------------------------------===//
+class PartitionedBuffer {
+ public:
+  //===--------------------------------------------------------------------===//
+  // Callback to process one entry when scanning the tuples of a partition
+  //===--------------------------------------------------------------------===//
+  struct IterateCallback {
+    // Destructor
+    virtual ~IterateCallback() {}
+    // Process the values of a tuple in the partition
+    virtual void ProcessEntry(
+        CodeGen &codegen, const std::vector<codegen::Value> &vals) const = 0;
+  };
+
+  // Constructor
+  PartitionedBuffer();
+  PartitionedBuffer(CodeGen &codegen, const std::vector<type::Type> &row_desc);
+
+  // Initialize the given buffer instance with the given number of partitions
+  void Init(CodeGen &codegen, llvm::Value *buffer_ptr,
+            uint32_t num_partitions) const;
+
+  // Append the given tuple to the given partition of the buffer instance
+  void Append(CodeGen &codegen, llvm::Value *buffer_ptr,
+              llvm::Value *partition,
+              const std::vector<codegen::Value> &tuple) const;
+
+  // Iterate over the tuples of the given partition of the buffer instance
+  void IteratePartition(CodeGen &codegen, llvm::Value *buffer_ptr,
+                        llvm::Value *partition,
+                        IterateCallback &callback) const;
+
+  // Move all tuples of the other buffer instance into the given one, and
+  // destroy the other one
+  void TransferFrom(CodeGen &codegen, llvm::Value *buffer_ptr,
+                    llvm::Value *other_buffer_ptr) const;
+
+  void Destroy(CodeGen &codegen, llvm::Value *buffer_ptr) const;
+
+  const UpdateableStorage &GetStorageFormat() const { return storage_format_; }
+
+ private:
+  // The format of the tuples in the buffer
+  UpdateableStorage storage_format_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -16,9 +16,14 @@
 #include <string>
 #include <vector>
 
+namespace llvm {
+class Value;
+}  // namespace llvm
+
 namespace peloton {
 namespace codegen {
 
+class CodeGen;
 class OperatorTranslator;
 class CompilationContext;
 class ConsumerContext;
@@ -28,6 +33,12 @@ class ConsumerContext;
 // Peloton pipelines are decomposed further into stages. Operators in a
 // stage are fully pipelined/fused together, while whole stages communicate
 // through cache-resident vectors of TIDs.
+//
+// A pipeline that starts at a table scan can be run in parallel. Its tile
+// groups are then scanned in morsels on several threads, each of which
+// consumes tuples into its own copy of the runtime state. The operator ending
+// the pipeline merges the state of the threads into the runtime state of the
+// query when the scan is finished.
 //===----------------------------------------------------------------------===//
 class Pipeline {
  public:
@@ -49,9 +60,36 @@ class Pipeline {
   // Move to the next step in this pipeline
   const OperatorTranslator *NextStep();
 
+  // Get the operator consuming the output of the given one in this pipeline,
+  // nullptr if the given one ends the pipeline
+  const OperatorTranslator *GetParentOf(
+      const OperatorTranslator *translator) const;
+
+  // Get the operator whose output the given one consumes in this pipeline,
+  // nullptr if the given one starts the pipeline
+  const OperatorTranslator *GetChildOf(
+      const OperatorTranslator *translator) const;
+
   uint32_t GetNumStages() const;
   uint32_t GetTranslatorStage(const OperatorTranslator *translator) const;
 
+  // Run this pipeline in parallel, if all of its operators but the one ending
+  // it can consume tuples on several threads at once. Only the operator
+  // ending the pipeline may call this, once all the others were added.
+  void MakeParallel();
+
+  // Is this pipeline run in parallel
+  bool IsParallel() const { return parallel_; }
+
+  // The operator ending this pipeline, which merges the state of the threads
+  // of a parallel pipeline
+  const OperatorTranslator *GetBreaker() const { return pipeline_.front(); }
+
+  // Codegen the check whether an operator in this pipeline needs no more
+  // tuples, e.g. a limit that was reached. Scans starting the pipeline stop
+  // early then. Returns nullptr if every operator consumes all tuples.
+  llvm::Value *IsFinished(CodeGen &codegen) const;
+
   // Get a stringified version of this pipeline
   std::string GetInfo() const;
 
@@ -66,6 +104,9 @@ class Pipeline {
   // A value, i, in this list means there is a stage boundary between operators
   // i-1 and i in the pipeline.
   std::vector<uint32_t> stage_boundaries_;
+
+  // Whether the pipeline is run in parallel
+  bool parallel_;
 };
 
 }  // namespace codegen
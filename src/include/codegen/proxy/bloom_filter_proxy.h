@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bloom_filter_proxy.h
+//
+// Identification: src/include/codegen/proxy/bloom_filter_proxy.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/codegen.h"
+#include "codegen/util/bloom_filter.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// BLOOM FILTER PROXY
+//===----------------------------------------------------------------------===//
+
+struct BloomFilterProxy {
+  // The layout of util::BloomFilter, whose fields compiled queries access
+  static llvm::Type *GetType(CodeGen &codegen) {
+    static const std::string kBloomFilterTypeName =
+        "peloton::codegen::util::BloomFilter";
+    auto *bloom_filter_type = codegen.LookupTypeByName(kBloomFilterTypeName);
+    if (bloom_filter_type != nullptr) {
+      return bloom_filter_type;
+    }
+
+    // Type isn't cached, create it
+    std::vector<llvm::Type *> layout = {
+        // The words of the filter
+        codegen.Int64Type()->getPointerTo(),
+
+        // The word mask
+        codegen.Int64Type()};
+    return llvm::StructType::create(codegen.GetContext(), layout,
+                                    kBloomFilterTypeName);
+  }
+
+  // Wrapper around util::BloomFilter::Init()
+  struct _Init {
+    static const std::string &GetFunctionName() {
+      static const std::string init_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen4util11BloomFilter4InitEy";
+#else
+          "_ZN7peloton7codegen4util11BloomFilter4InitEm";
+#endif
+      return init_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          BloomFilterProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int64Type()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around util::BloomFilter::Destroy()
+  struct _Destroy {
+    static const std::string &GetFunctionName() {
+      static const std::string destroy_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen4util11BloomFilter7DestroyEv";
+#else
+          "_ZN7peloton7codegen4util11BloomFilter7DestroyEv";
+#endif
+      return destroy_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          BloomFilterProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+};
+
+}  // namespace codegen
+}  // namespace peloton
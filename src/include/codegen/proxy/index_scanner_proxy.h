@@ -0,0 +1,226 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scanner_proxy.h
+//
+// Identification: src/include/codegen/proxy/index_scanner_proxy.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/codegen.h"
+#include "codegen/index_scanner.h"
+#include "codegen/proxy/executor_context_proxy.h"
+#include "codegen/proxy/tile_group_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// INDEX SCANNER PROXY
+//===----------------------------------------------------------------------===//
+
+struct IndexScannerProxy {
+  static llvm::Type *GetType(CodeGen &codegen) {
+    static const std::string kIndexScannerTypeName =
+        "peloton::codegen::IndexScanner";
+    auto *index_scanner_type = codegen.LookupTypeByName(kIndexScannerTypeName);
+    if (index_scanner_type != nullptr) {
+      return index_scanner_type;
+    }
+
+    // Type isn't cached, create it
+    auto *opaque_arr_type =
+        codegen.VectorType(codegen.Int8Type(), sizeof(IndexScanner));
+    return llvm::StructType::create(codegen.GetContext(), {opaque_arr_type},
+                                    kIndexScannerTypeName);
+  }
+
+  // Wrapper around IndexScanner::Init()
+  struct _Init {
+    static const std::string &GetFunctionName() {
+      static const std::string init_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen12IndexScanner4InitEPKNS_7planner13IndexScanPla"
+          "nEPNS_8executor15ExecutorContextE";
+#else
+          "_ZN7peloton7codegen12IndexScanner4InitEPKNS_7planner13IndexScanPla"
+          "nEPNS_8executor15ExecutorContextE";
+#endif
+      return init_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          IndexScannerProxy::GetType(codegen)->getPointerTo(),
+          codegen.CharPtrType(),
+          ExecutorContextProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around IndexScanner::Scan()
+  struct _Scan {
+    static const std::string &GetFunctionName() {
+      static const std::string scan_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen12IndexScanner4ScanEv";
+#else
+          "_ZN7peloton7codegen12IndexScanner4ScanEv";
+#endif
+      return scan_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          IndexScannerProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.Int32Type(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around IndexScanner::GetTileGroup()
+  struct _GetTileGroup {
+    static const std::string &GetFunctionName() {
+      static const std::string get_tile_group_fn_name =
+#ifdef __APPLE__
+          "_ZNK7peloton7codegen12IndexScanner12GetTileGroupEj";
+#else
+          "_ZNK7peloton7codegen12IndexScanner12GetTileGroupEj";
+#endif
+      return get_tile_group_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          IndexScannerProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int32Type()};
+      llvm::FunctionType *fn_type = llvm::FunctionType::get(
+          TileGroupProxy::GetType(codegen)->getPointerTo(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around IndexScanner::GetTids()
+  struct _GetTids {
+    static const std::string &GetFunctionName() {
+      static const std::string get_tids_fn_name =
+#ifdef __APPLE__
+          "_ZNK7peloton7codegen12IndexScanner7GetTidsEj";
+#else
+          "_ZNK7peloton7codegen12IndexScanner7GetTidsEj";
+#endif
+      return get_tids_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          IndexScannerProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int32Type()};
+      llvm::FunctionType *fn_type = llvm::FunctionType::get(
+          codegen.Int32Type()->getPointerTo(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around IndexScanner::GetTidCount()
+  struct _GetTidCount {
+    static const std::string &GetFunctionName() {
+      static const std::string get_tid_count_fn_name =
+#ifdef __APPLE__
+          "_ZNK7peloton7codegen12IndexScanner11GetTidCountEj";
+#else
+          "_ZNK7peloton7codegen12IndexScanner11GetTidCountEj";
+#endif
+      return get_tid_count_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          IndexScannerProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int32Type()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.Int32Type(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around IndexScanner::Destroy()
+  struct _Destroy {
+    static const std::string &GetFunctionName() {
+      static const std::string destroy_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen12IndexScanner7DestroyEv";
+#else
+          "_ZN7peloton7codegen12IndexScanner7DestroyEv";
+#endif
+      return destroy_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          IndexScannerProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// inserter_proxy.h
+//
+// Identification: src/include/codegen/proxy/inserter_proxy.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/codegen.h"
+#include "codegen/inserter.h"
+#include "codegen/proxy/data_table_proxy.h"
+#include "codegen/proxy/executor_context_proxy.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// INSERTER PROXY
+//===----------------------------------------------------------------------===//
+
+struct InserterProxy {
+  static llvm::Type *GetType(CodeGen &codegen) {
+    static const std::string kInserterTypeName =
+        "peloton::codegen::Inserter";
+    auto *inserter_type = codegen.LookupTypeByName(kInserterTypeName);
+    if (inserter_type != nullptr) {
+      return inserter_type;
+    }
+
+    // Type isn't cached, create it
+    auto *opaque_arr_type =
+        codegen.VectorType(codegen.Int8Type(), sizeof(Inserter));
+    return llvm::StructType::create(codegen.GetContext(), {opaque_arr_type},
+                                    kInserterTypeName);
+  }
+
+  // Wrapper around Inserter::Init()
+  struct _Init {
+    static const std::string &GetFunctionName() {
+      static const std::string init_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen8Inserter4InitEPNS_7storage9DataTableEPNS_8exec"
+          "utor15ExecutorContextE";
+#else
+          "_ZN7peloton7codegen8Inserter4InitEPNS_7storage9DataTableEPNS_8exec"
+          "utor15ExecutorContextE";
+#endif
+      return init_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          InserterProxy::GetType(codegen)->getPointerTo(),
+          DataTableProxy::GetType(codegen)->getPointerTo(),
+          ExecutorContextProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around Inserter::GetValues()
+  struct _GetValues {
+    static const std::string &GetFunctionName() {
+      static const std::string get_values_fn_name =
+#ifdef __APPLE__
+          "_ZNK7peloton7codegen8Inserter9GetValuesEv";
+#else
+          "_ZNK7peloton7codegen8Inserter9GetValuesEv";
+#endif
+      return get_values_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          InserterProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.CharPtrType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around Inserter::Insert()
+  struct _Insert {
+    static const std::string &GetFunctionName() {
+      static const std::string insert_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen8Inserter6InsertEv";
+#else
+          "_ZN7peloton7codegen8Inserter6InsertEv";
+#endif
+      return insert_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          InserterProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.BoolType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around Inserter::InsertPlanTuples()
+  struct _InsertPlanTuples {
+    static const std::string &GetFunctionName() {
+      static const std::string insert_plan_tuples_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen8Inserter16InsertPlanTuplesEPKNS_7planner10Inse"
+          "rtPlanE";
+#else
+          "_ZN7peloton7codegen8Inserter16InsertPlanTuplesEPKNS_7planner10Inse"
+          "rtPlanE";
+#endif
+      return insert_plan_tuples_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          InserterProxy::GetType(codegen)->getPointerTo(),
+          codegen.CharPtrType()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around Inserter::Destroy()
+  struct _Destroy {
+    static const std::string &GetFunctionName() {
+      static const std::string destroy_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen8Inserter7DestroyEv";
+#else
+          "_ZN7peloton7codegen8Inserter7DestroyEv";
+#endif
+      return destroy_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          InserterProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+};
+
+}  // namespace codegen
+}  // namespace peloton
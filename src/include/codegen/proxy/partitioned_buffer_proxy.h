@@ -0,0 +1,224 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_buffer_proxy.h
+//
+// Identification: src/include/codegen/proxy/partitioned_buffer_proxy.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/codegen.h"
+#include "codegen/util/partitioned_buffer.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// PARTITIONED BUFFER PROXY
+//===----------------------------------------------------------------------===//
+
+struct PartitionedBufferProxy {
+  static llvm::Type *GetType(CodeGen &codegen) {
+    static const std::string kPartitionedBufferTypeName =
+        "peloton::codegen::util::PartitionedBuffer";
+    auto *partitioned_buffer_type =
+        codegen.LookupTypeByName(kPartitionedBufferTypeName);
+    if (partitioned_buffer_type != nullptr) {
+      return partitioned_buffer_type;
+    }
+
+    // Type isn't cached, create it
+    auto *opaque_arr_type = codegen.VectorType(
+        codegen.Int8Type(), sizeof(util::PartitionedBuffer));
+    return llvm::StructType::create(codegen.GetContext(), {opaque_arr_type},
+                                    kPartitionedBufferTypeName);
+  }
+
+  // Wrapper around util::PartitionedBuffer::Init()
+  struct _Init {
+    static const std::string &GetFunctionName() {
+      static const std::string init_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen4util17PartitionedBuffer4InitEjj";
+#else
+          "_ZN7peloton7codegen4util17PartitionedBuffer4InitEjj";
+#endif
+      return init_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          PartitionedBufferProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int32Type(),
+          codegen.Int32Type()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around util::PartitionedBuffer::StoreInputTuple()
+  struct _StoreInputTuple {
+    static const std::string &GetFunctionName() {
+      static const std::string store_input_tuple_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen4util17PartitionedBuffer15StoreInputTupleEj";
+#else
+          "_ZN7peloton7codegen4util17PartitionedBuffer15StoreInputTupleEj";
+#endif
+      return store_input_tuple_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          PartitionedBufferProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int32Type()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.CharPtrType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around util::PartitionedBuffer::TransferFrom()
+  struct _TransferFrom {
+    static const std::string &GetFunctionName() {
+      static const std::string transfer_from_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen4util17PartitionedBuffer12TransferFromERS2_";
+#else
+          "_ZN7peloton7codegen4util17PartitionedBuffer12TransferFromERS2_";
+#endif
+      return transfer_from_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          PartitionedBufferProxy::GetType(codegen)->getPointerTo(),
+          PartitionedBufferProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around util::PartitionedBuffer::GetPartitionStart()
+  struct _GetPartitionStart {
+    static const std::string &GetFunctionName() {
+      static const std::string get_partition_start_fn_name =
+#ifdef __APPLE__
+          "_ZNK7peloton7codegen4util17PartitionedBuffer17GetPartitionStartEj";
+#else
+          "_ZNK7peloton7codegen4util17PartitionedBuffer17GetPartitionStartEj";
+#endif
+      return get_partition_start_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          PartitionedBufferProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int32Type()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.CharPtrType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around util::PartitionedBuffer::GetNumTuples()
+  struct _GetNumTuples {
+    static const std::string &GetFunctionName() {
+      static const std::string get_num_tuples_fn_name =
+#ifdef __APPLE__
+          "_ZNK7peloton7codegen4util17PartitionedBuffer12GetNumTuplesEj";
+#else
+          "_ZNK7peloton7codegen4util17PartitionedBuffer12GetNumTuplesEj";
+#endif
+      return get_num_tuples_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          PartitionedBufferProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int32Type()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.Int64Type(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around util::PartitionedBuffer::Destroy()
+  struct _Destroy {
+    static const std::string &GetFunctionName() {
+      static const std::string destroy_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen4util17PartitionedBuffer7DestroyEv";
+#else
+          "_ZN7peloton7codegen4util17PartitionedBuffer7DestroyEv";
+#endif
+      return destroy_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          PartitionedBufferProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -34,6 +34,24 @@ class RuntimeFunctionsProxy {
     static llvm::Function *GetFunction(CodeGen &codegen);
   };
 
+  struct _ZoneMapCanSatisfy {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::ZoneMapCanSatisfy()
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  struct _FilterFrozenTuples {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::FilterFrozenTuples()
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  struct _TileGroupHasNulls {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::TileGroupHasNulls()
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
   struct _ColumnLayoutInfo {
     static llvm::Type *GetType(CodeGen &codegen);
   };
@@ -44,6 +62,36 @@ class RuntimeFunctionsProxy {
     static llvm::Function *GetFunction(CodeGen &codegen);
   };
 
+  struct _ExecuteParallelScan {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::ExecuteParallelScan()
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  struct _CreateConjunctionOrder {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::CreateConjunctionOrder()
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  struct _DestroyConjunctionOrder {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::DestroyConjunctionOrder()
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  struct _GetConjunctionOrder {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::GetConjunctionOrder()
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  struct _RecordConjunctionTerm {
+    // Get the LLVM function definition/wrapper to
+    // RuntimeFunctions::RecordConjunctionTerm()
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
   struct _ThrowDivideByZeroException {
     // Get the LLVM function definition/wrapper to our
     // ThrowDivideByZeroException() function
@@ -38,6 +38,22 @@ class SorterProxy {
     static llvm::Function *GetFunction(CodeGen &codegen);
   };
 
+  //===--------------------------------------------------------------------===//
+  // The proxy for codegen::util::Sorter::StoreInputTupleTopK()
+  //===--------------------------------------------------------------------===//
+  struct _StoreInputTupleTopK {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  //===--------------------------------------------------------------------===//
+  // The proxy for codegen::util::Sorter::TransferFrom()
+  //===--------------------------------------------------------------------===//
+  struct _TransferFrom {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
   //===--------------------------------------------------------------------===//
   // The proxy for codegen::util::Sorter::Sort()
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// updater_proxy.h
+//
+// Identification: src/include/codegen/proxy/updater_proxy.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "codegen/codegen.h"
+#include "codegen/proxy/executor_context_proxy.h"
+#include "codegen/updater.h"
+
+namespace peloton {
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// UPDATER PROXY
+//===----------------------------------------------------------------------===//
+
+struct UpdaterProxy {
+  static llvm::Type *GetType(CodeGen &codegen) {
+    static const std::string kUpdaterTypeName =
+        "peloton::codegen::Updater";
+    auto *updater_type = codegen.LookupTypeByName(kUpdaterTypeName);
+    if (updater_type != nullptr) {
+      return updater_type;
+    }
+
+    // Type isn't cached, create it
+    auto *opaque_arr_type =
+        codegen.VectorType(codegen.Int8Type(), sizeof(Updater));
+    return llvm::StructType::create(codegen.GetContext(), {opaque_arr_type},
+                                    kUpdaterTypeName);
+  }
+
+  // Wrapper around Updater::Init()
+  struct _Init {
+    static const std::string &GetFunctionName() {
+      static const std::string init_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen7Updater4InitEPKNS_7planner10UpdatePlanEPNS_8ex"
+          "ecutor15ExecutorContextE";
+#else
+          "_ZN7peloton7codegen7Updater4InitEPKNS_7planner10UpdatePlanEPNS_8ex"
+          "ecutor15ExecutorContextE";
+#endif
+      return init_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          UpdaterProxy::GetType(codegen)->getPointerTo(),
+          codegen.CharPtrType(),
+          ExecutorContextProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around Updater::GetValues()
+  struct _GetValues {
+    static const std::string &GetFunctionName() {
+      static const std::string get_values_fn_name =
+#ifdef __APPLE__
+          "_ZNK7peloton7codegen7Updater9GetValuesEv";
+#else
+          "_ZNK7peloton7codegen7Updater9GetValuesEv";
+#endif
+      return get_values_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          UpdaterProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.CharPtrType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around Updater::Update()
+  struct _Update {
+    static const std::string &GetFunctionName() {
+      static const std::string update_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen7Updater6UpdateEjj";
+#else
+          "_ZN7peloton7codegen7Updater6UpdateEjj";
+#endif
+      return update_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          UpdaterProxy::GetType(codegen)->getPointerTo(),
+          codegen.Int32Type(),
+          codegen.Int32Type()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.BoolType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+
+  // Wrapper around Updater::Destroy()
+  struct _Destroy {
+    static const std::string &GetFunctionName() {
+      static const std::string destroy_fn_name =
+#ifdef __APPLE__
+          "_ZN7peloton7codegen7Updater7DestroyEv";
+#else
+          "_ZN7peloton7codegen7Updater7DestroyEv";
+#endif
+      return destroy_fn_name;
+    }
+
+    static llvm::Function *GetFunction(CodeGen &codegen) {
+      const std::string &fn_name = GetFunctionName();
+
+      // Has the function already been registered?
+      llvm::Function *llvm_fn = codegen.LookupFunction(fn_name);
+      if (llvm_fn != nullptr) {
+        return llvm_fn;
+      }
+
+      std::vector<llvm::Type *> fn_args = {
+          UpdaterProxy::GetType(codegen)->getPointerTo()};
+      llvm::FunctionType *fn_type =
+          llvm::FunctionType::get(codegen.VoidType(), fn_args, false);
+      return codegen.RegisterFunction(fn_name, fn_type);
+    }
+  };
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -83,6 +83,36 @@ class ValuesRuntimeProxy {
     static const std::string &GetFunctionName();
     static llvm::Function *GetFunction(CodeGen &codegen);
   };
+
+  // The proxy around ValuesRuntime::Like()
+  struct _Like {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  // The proxy around ValuesRuntime::StartsWith()
+  struct _StartsWith {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  // The proxy around ValuesRuntime::EndsWith()
+  struct _EndsWith {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  // The proxy around ValuesRuntime::Contains()
+  struct _Contains {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
+
+  // The proxy around ValuesRuntime::CallFunction()
+  struct _CallFunction {
+    static const std::string &GetFunctionName();
+    static llvm::Function *GetFunction(CodeGen &codegen);
+  };
 };
 
 }  // namespace codegen
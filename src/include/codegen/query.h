@@ -31,6 +31,8 @@ class AbstractPlan;
 
 namespace codegen {
 
+class QueryParameters;
+
 //===----------------------------------------------------------------------===//
 // A query statement that can be compiled
 //===----------------------------------------------------------------------===//
@@ -54,10 +56,19 @@ class Query {
   bool Prepare(const QueryFunctions &funcs);
 
   // Execute th e query given the catalog manager and runtime/consumer state
-  // that is passed along to the query execution code.
+  // that is passed along to the query execution code. A query compiled with
+  // parameters must be given the parameters of the plan it runs for, which
+  // can be any plan with the same signature.
   void Execute(concurrency::Transaction &txn,
                executor::ExecutorContext *executor_context, char *consumer_arg,
-               RuntimeStats *stats = nullptr);
+               RuntimeStats *stats = nullptr,
+               const QueryParameters *parameters = nullptr);
+
+  // Whether the query reads the values of the plan from query parameters
+  bool IsParameterized() const { return parameterized_; }
+
+  // Whether the optimization passes ran over the code of the query
+  bool IsOptimized() const { return optimized_; }
 
   // Return the query plan
   const planner::AbstractPlan &GetPlan() const { return query_plan_; }
@@ -68,6 +79,12 @@ class Query {
   // The class tracking all the state needed by this query
   RuntimeState &GetRuntimeState() { return runtime_state_; }
 
+  // The bytes allocated to compile the query and kept by it, charged to
+  // codegen while the query lives
+  size_t GetMemoryFootprint() const { return memory_footprint_; }
+
+  ~Query();
+
  private:
   friend class QueryCompiler;
 
@@ -84,6 +101,19 @@ class Query {
   // The size of the parameter the functions take
   RuntimeState runtime_state_;
 
+  // The size of the runtime state, computed when the query is prepared so
+  // that executions never touch the code context
+  uint64_t runtime_state_size_;
+
+  // Whether the constants and predicates are read from query parameters
+  bool parameterized_;
+
+  // Whether the code is optimized before it is compiled
+  bool optimized_;
+
+  // The bytes charged to codegen
+  size_t memory_footprint_;
+
   // The init(), plan() and tearDown() functions
   typedef void (*compiled_function_t)(char *);
   compiled_function_t init_func_;
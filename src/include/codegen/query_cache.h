@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_cache.h
+//
+// Identification: src/include/codegen/query_cache.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "codegen/query.h"
+#include "common/concurrent_cache.h"
+#include "type/types.h"
+
+namespace peloton {
+
+namespace planner {
+class AbstractPlan;
+}  // namespace planner
+
+namespace codegen {
+
+class QueryParameters;
+
+//===----------------------------------------------------------------------===//
+// A query compiled with parameters, together with the plan it was compiled
+// for. The compiled code refers to the types and columns of the plan, so the
+// plan is kept alive as long as the query may run.
+//===----------------------------------------------------------------------===//
+struct CachedQuery {
+  std::string signature;
+  std::shared_ptr<planner::AbstractPlan> plan;
+  std::unique_ptr<Query> query;
+
+  // The tables the query reads or writes, as (database, table) oids
+  std::vector<std::pair<oid_t, oid_t>> table_oids;
+
+  // Number of executions, used to find the queries worth optimizing
+  std::atomic<uint64_t> execution_count{0};
+};
+
+//===----------------------------------------------------------------------===//
+// The process-wide cache of compiled queries, keyed by the signature of their
+// plans. All queries are compiled for a BufferingConsumer over the output
+// columns of their plans, so a query found for a plan can be executed with
+// the parameters of that plan.
+//
+// Compiled queries look their tables up by oid when they run, and read the
+// layouts of the tile groups they scan then, so they only need to be dropped
+// when one of their tables is dropped.
+//===----------------------------------------------------------------------===//
+class QueryCache {
+ public:
+  QueryCache(const QueryCache &) = delete;
+  QueryCache &operator=(const QueryCache &) = delete;
+  QueryCache(QueryCache &&) = delete;
+  QueryCache &operator=(QueryCache &&) = delete;
+
+  // Singleton
+  static QueryCache &GetInstance();
+
+  // Find the query compiled for the given signature, or null
+  std::shared_ptr<CachedQuery> Find(const std::string &signature);
+
+  // Add a query compiled with the given parameters of its plan
+  std::shared_ptr<CachedQuery> Add(std::shared_ptr<planner::AbstractPlan> plan,
+                                   std::unique_ptr<Query> query,
+                                   const QueryParameters &parameters);
+
+  // Drop the queries on the given table
+  void RemoveTable(oid_t database_oid, oid_t table_oid);
+
+  // Drop the queries on the tables of the given database
+  void RemoveDatabase(oid_t database_oid);
+
+  // Drop all queries
+  void Clear();
+
+  size_t GetCount();
+
+ private:
+  QueryCache();
+
+  // Drop the queries that match
+  template <typename Predicate>
+  void RemoveIf(Predicate predicate);
+
+ private:
+  ConcurrentCache<std::string, CachedQuery> cache_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -22,18 +22,22 @@ namespace peloton {
 
 namespace planner {
 class AbstractPlan;
+class UpdatePlan;
 }  // namespace plan
 
 namespace codegen {
 
+class QueryParameters;
+
 // The primary interface to JIT compile queries
 class QueryCompiler {
  public:
   //===--------------------------------------------------------------------===//
   // A tiny struct that collects statistics on query compilation.  In here, we
   // can track the amount of time it took to setup the compilation, the amount
-  // of time it took to generate the LLVM IR and the amount of time it took to
-  // JIT compile the query's components into native code.
+  // of time it took to generate the LLVM IR, the amount of time it took to
+  // optimize it and to JIT compile the query's components into native code,
+  // and the size of the compiled code.
   //===--------------------------------------------------------------------===//
   struct CompileStats {
     // The time taken to setup the compilation context
@@ -42,20 +46,37 @@ class QueryCompiler {
     // The time taken to generate all the IR for the plan
     double ir_gen_ms = 0.0;
 
+    // The time taken to run the optimization passes over the IR
+    double opt_ms = 0.0;
+
     // The time taken to perform JIT compilation
     double jit_ms = 0.0;
+
+    // The number of functions and IR instructions compiled
+    uint64_t num_functions = 0;
+    uint64_t num_instructions = 0;
+
+    // Whether the code was loaded from the object cache
+    bool loaded_from_cache = false;
+
+    // The time taken by all phases
+    double TotalTime() const { return setup_ms + ir_gen_ms + opt_ms + jit_ms; }
   };
 
-  // Constructor
-  QueryCompiler();
+  // Constructor. The optimization passes can be skipped for queries that
+  // should start running soon.
+  explicit QueryCompiler(bool optimize = true);
 
   // Compile the provided query, returning the compiled plan that can be invoked
   // to return results. Callers can also pass in an (optional) CompileStats
   // object pointer if they want to collect statistics on the compilation
-  // process.
+  // process. If the parameters of the plan are provided, the compiled query
+  // reads the constants of the plan from them, and can be executed for any
+  // plan with the same signature.
   std::unique_ptr<Query> Compile(const planner::AbstractPlan &query_plan,
                                  QueryResultConsumer &consumer,
-                                 CompileStats *stats = nullptr);
+                                 CompileStats *stats = nullptr,
+                                 const QueryParameters *parameters = nullptr);
 
   // Get the next available query plan ID
   uint64_t NextId() { return next_id_++; }
@@ -67,8 +88,13 @@ class QueryCompiler {
   static bool IsSupported(const planner::AbstractPlan &plan,
                           const planner::AbstractPlan *parent);
 
+  static bool IsUpdateSupported(const planner::UpdatePlan &plan);
+
   // Counter we use to ID the queries we compiled
   std::atomic<uint64_t> next_id_;
+
+  // Whether the compiled code is optimized
+  bool optimize_;
 };
 
 }  // namespace codegen
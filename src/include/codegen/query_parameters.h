@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_parameters.h
+//
+// Identification: src/include/codegen/query_parameters.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "type/types.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace planner {
+class AbstractPlan;
+class ProjectInfo;
+}  // namespace planner
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// The values of a plan that the compiled code of the plan reads at runtime
+// instead of baking them into the code. These are the constants of all the
+// expressions in the plan, the scan predicates that are checked against the
+// zone maps, and the index scans whose keys the index is probed with.
+//
+// The plan is walked in a fixed order, so two plans that only differ in their
+// constants have the same signature and lay their values out in the same
+// slots. A query compiled for one of them can then run with the parameters of
+// the other.
+//===----------------------------------------------------------------------===//
+class QueryParameters {
+ public:
+  // The runtime layout of one value. Variable length values also carry their
+  // length.
+  struct Parameter {
+    union {
+      int8_t tinyint;
+      int16_t smallint;
+      int32_t integer;
+      int64_t bigint;
+      double decimal;
+      const char *varchar;
+      const void *pointer;
+    } value;
+    uint32_t length;
+  };
+
+  // Collect the parameters of the given plan
+  explicit QueryParameters(const planner::AbstractPlan &plan);
+
+  // The shape of the plan, without the values of the parameters
+  const std::string &GetSignature() const { return signature_; }
+
+  // A hash of the signature, which identifies the plan in logs and flags
+  uint64_t GetPlanHash() const { return std::hash<std::string>{}(signature_); }
+
+  // The tables the plan reads or writes, as (database, table) oids
+  const std::vector<std::pair<oid_t, oid_t>> &GetTableOids() const {
+    return table_oids_;
+  }
+
+  // The slot of the given constant expression or scan predicate
+  uint32_t GetParameterIndex(const expression::AbstractExpression *exp) const;
+
+  // The slot of the given index scan
+  uint32_t GetPlanIndex(const planner::AbstractPlan *plan) const;
+
+  uint32_t GetParameterCount() const {
+    return static_cast<uint32_t>(parameters_.size());
+  }
+
+  // The parameter slots, as passed to the compiled query
+  char *GetParameterData() const {
+    return reinterpret_cast<char *>(
+        const_cast<Parameter *>(parameters_.data()));
+  }
+
+ private:
+  void CollectPlan(const planner::AbstractPlan &plan);
+
+  void CollectProjectInfo(const planner::ProjectInfo *project_info);
+
+  void CollectExpression(const expression::AbstractExpression *exp);
+
+  // Add a scan predicate, whose pointer the compiled code passes on
+  void CollectPredicate(const expression::AbstractExpression *predicate);
+
+  void AppendToSignature(int64_t token);
+
+  void AppendToSignature(const std::vector<oid_t> &tokens);
+
+  uint32_t AddParameter(const expression::AbstractExpression *exp);
+
+  // Add a slot for the pointer to the given plan node
+  uint32_t AddPlanParameter(const planner::AbstractPlan *plan);
+
+  DISALLOW_COPY_AND_MOVE(QueryParameters);
+
+ private:
+  std::string signature_;
+
+  std::vector<std::pair<oid_t, oid_t>> table_oids_;
+
+  std::vector<Parameter> parameters_;
+
+  // The characters of the varchar constants the slots point to
+  std::deque<std::string> strings_;
+
+  std::unordered_map<const expression::AbstractExpression *, uint32_t>
+      parameter_indexes_;
+
+  std::unordered_map<const planner::AbstractPlan *, uint32_t> plan_indexes_;
+};
+
+}  // namespace codegen
+}  // namespace peloton
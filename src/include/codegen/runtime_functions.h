@@ -14,10 +14,24 @@
 
 #include <stdint.h>
 
+#include "codegen/morsel_scheduler.h"
 #include "type/types.h"
 
 namespace peloton {
 
+namespace concurrency {
+class Transaction;
+}  // namespace concurrency
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace expression {
+class AbstractExpression;
+class ConjunctionOrder;
+}  // namespace expression
+
 namespace storage {
 class DataTable;
 class TileGroup;
@@ -42,6 +56,27 @@ class RuntimeFunctions {
   static storage::TileGroup *GetTileGroup(storage::DataTable *table,
                                           oid_t tile_group_index);
 
+  // Check the tile group's zone map to determine whether any of its tuples
+  // can satisfy the given predicate. Returning false lets the scan skip the
+  // whole tile group.
+  static bool ZoneMapCanSatisfy(const storage::TileGroup *tile_group,
+                                const expression::AbstractExpression *predicate,
+                                executor::ExecutorContext *executor_context);
+
+  // Filter the tuples in the selection vector of a batch by the parts of the
+  // predicate that can be evaluated on the encoded columns of the frozen form
+  // of the tile group. Returns the new number of tuples in the selection
+  // vector, which is unchanged if the tile group isn't frozen.
+  static uint32_t FilterFrozenTuples(
+      const storage::TileGroup *tile_group,
+      const expression::AbstractExpression *predicate,
+      executor::ExecutorContext *executor_context, uint32_t *selection,
+      uint32_t count);
+
+  // Check the tile group's zone map to determine whether a NULL was ever
+  // written into it. Scans specialize the code of tile groups without NULLs.
+  static bool TileGroupHasNulls(const storage::TileGroup *tile_group);
+
   // This struct represents the layout (or configuration) of a column in a
   // tile group. A configuration is characterized by two properties: its
   // starting address and its stride.  The former indicates where in memory
@@ -56,9 +91,38 @@ class RuntimeFunctions {
     bool is_columnar;
   };
 
-  // Get the column configuration for every column in the tile group
+  // Get the column configuration for every column in the tile group. The
+  // columns of a tile group whose tuple slots were released are decoded into
+  // the pool of the executor context, if there is one.
   static void GetTileGroupLayout(const storage::TileGroup *tile_group,
-                                 ColumnLayoutInfo *infos, uint32_t num_cols);
+                                 ColumnLayoutInfo *infos, uint32_t num_cols,
+                                 executor::ExecutorContext *executor_context);
+
+  // Scan the tile groups [0, num_tile_groups) of a parallel pipeline in
+  // morsels on several threads, using the functions generated for the
+  // pipeline
+  static void ExecuteParallelScan(
+      concurrency::Transaction *txn, char *runtime_state, uint64_t state_size,
+      uint64_t num_tile_groups, MorselScheduler::ScanFunction scan_func,
+      MorselScheduler::InitFunction init_func,
+      MorselScheduler::MergeFunction merge_func, uint64_t num_partitions,
+      MorselScheduler::MergePartitionFunction merge_partition_func);
+
+  // Create the order the terms of the chain of ANDs of the predicate are
+  // evaluated in, which is shared by all threads scanning with it
+  static expression::ConjunctionOrder *CreateConjunctionOrder(
+      const expression::AbstractExpression *predicate);
+
+  static void DestroyConjunctionOrder(expression::ConjunctionOrder *order);
+
+  // The order a batch of tuples is evaluated in
+  static uint64_t GetConjunctionOrder(
+      const expression::ConjunctionOrder *order);
+
+  // Record that the term let num_passed of num_tuples tuples through
+  static void RecordConjunctionTerm(expression::ConjunctionOrder *order,
+                                    uint32_t term, uint32_t num_tuples,
+                                    uint32_t num_passed);
 
   static void ThrowDivideByZeroException();
 
@@ -61,6 +61,11 @@ class RuntimeState {
   llvm::Value *LoadStatePtr(CodeGen &codegen,
                             RuntimeState::StateID state_id) const;
 
+  // Get the pointer to the given state information in the provided instance
+  // of the runtime state, rather than the one of the current function
+  llvm::Value *LoadStatePtr(CodeGen &codegen, RuntimeState::StateID state_id,
+                            llvm::Value *runtime_state) const;
+
   // Get the actual value of the state information with the given ID
   llvm::Value *LoadStateValue(CodeGen &codegen,
                               RuntimeState::StateID state_id) const;
@@ -71,6 +76,12 @@ class RuntimeState {
   // Create/initialize all registered state that is stack-local
   void CreateLocalState(CodeGen &codegen);
 
+  // Stack-local state belongs to the function it was created in. Functions
+  // generated in the middle of another one create their own, and restore the
+  // local state of the other one when they are finished.
+  std::vector<llvm::Value *> GetLocalState() const;
+  void SetLocalState(const std::vector<llvm::Value *> &local_state);
+
  private:
   // Little struct to track information of elements in the runtime state
   struct StateInfo {
@@ -44,6 +44,11 @@ class ScanCallback {
   // Callback for when iteration over the given tile group has completed
   virtual void TileGroupFinish(CodeGen &codegen,
                                llvm::Value *tile_group_ptr) = 0;
+
+  // Codegen the check whether the client needs no more tuples, which ends the
+  // scan before the next range of tuples. Returns nullptr if the whole table
+  // is scanned.
+  virtual llvm::Value *IsFinished(CodeGen &) { return nullptr; }
 };
 
 }  // namespace codegen
@@ -103,6 +103,17 @@ class Sorter {
   void Append(CodeGen &codegen, llvm::Value *sorter_ptr,
               const std::vector<codegen::Value> &tuple) const;
 
+  // Append the given tuple into the sorter instance, which keeps only the
+  // first top_k tuples in the sort order
+  void AppendTopK(CodeGen &codegen, llvm::Value *sorter_ptr,
+                  const std::vector<codegen::Value> &tuple,
+                  uint64_t top_k) const;
+
+  // Move the tuples of the other sorter instance into the given one, which
+  // keeps only the first top_k tuples in the sort order, and destroy the former
+  void TransferFrom(CodeGen &codegen, llvm::Value *sorter_ptr,
+                    llvm::Value *other_sorter_ptr, uint64_t top_k) const;
+
   // Sort all the data that has been inserted into the sorter instance
   void Sort(CodeGen &codegen, llvm::Value *sorter_ptr) const;
 
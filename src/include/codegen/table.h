@@ -38,9 +38,21 @@ class Table {
 
   // Generate code to perform a scan over the given table. The table pointer
   // is provided as the second argument. The scan consumer (third argument)
-  // should be notified when ready to generate the scan loop body.
+  // should be notified when ready to generate the scan loop body. If a
+  // pointer to a predicate is provided, tile groups whose zone maps prove that
+  // none of their tuples satisfy it are skipped.
   void GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
-                    uint32_t batch_size, ScanCallback &consumer) const;
+                    uint32_t batch_size, ScanCallback &consumer,
+                    llvm::Value *predicate_ptr = nullptr,
+                    llvm::Value *executor_context_ptr = nullptr) const;
+
+  // Like GenerateScan() above, but only scan the tile groups whose indexes are
+  // in the range [tile_group_start, tile_group_end)
+  void GenerateScan(CodeGen &codegen, llvm::Value *table_ptr,
+                    llvm::Value *tile_group_start, llvm::Value *tile_group_end,
+                    uint32_t batch_size, ScanCallback &consumer,
+                    llvm::Value *predicate_ptr = nullptr,
+                    llvm::Value *executor_context_ptr = nullptr) const;
 
   // Given a table instance, return the number of tile groups in the table.
   llvm::Value *GetTileGroupCount(CodeGen &codegen,
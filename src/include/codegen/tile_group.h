@@ -37,10 +37,22 @@ class TileGroup {
   // Constructor
   TileGroup(const catalog::Schema &schema);
 
-  // Generate code that performs a sequential scan over the provided tile group
+  // Generate code that performs a sequential scan over the provided tile group.
+  // If the schema has nullable columns, tile groups without NULLs are scanned
+  // by a copy of the loop that skips all NULL checks. Frozen tile groups are
+  // decoded into the pool of the executor context, which may be null.
   void GenerateTidScan(CodeGen &codegen, llvm::Value *tile_group_ptr,
                        llvm::Value *column_layouts, uint32_t batch_size,
-                       ScanCallback &consumer) const;
+                       ScanCallback &consumer,
+                       llvm::Value *executor_context_ptr) const;
+
+  // Generate code that scans a list of num_tids TIDs of the provided tile
+  // group. The ranges passed to the consumer are positions in the list, not
+  // TIDs.
+  void GenerateTidListScan(CodeGen &codegen, llvm::Value *tile_group_ptr,
+                           llvm::Value *column_layouts, llvm::Value *num_tids,
+                           uint32_t batch_size, ScanCallback &consumer,
+                           llvm::Value *executor_context_ptr) const;
 
   llvm::Value *GetNumTuples(CodeGen &codegen, llvm::Value *tile_group) const;
 
@@ -86,13 +98,32 @@ class TileGroup {
   };
   */
 
+  // Generate the loop over the tuples of the tile group in batches
+  void GenerateTidScanLoop(CodeGen &codegen, llvm::Value *num_tuples,
+                           const std::vector<ColumnLayout> &col_layouts,
+                           uint32_t batch_size, bool no_nulls,
+                           ScanCallback &consumer) const;
+
+  // Does the schema have any nullable column?
+  bool HasNullableColumns() const;
+
   std::vector<TileGroup::ColumnLayout> GetColumnLayouts(
       CodeGen &codegen, llvm::Value *tile_group_ptr,
-      llvm::Value *column_layout_infos) const;
+      llvm::Value *column_layout_infos,
+      llvm::Value *executor_context_ptr) const;
 
-  // Access a given column for the row with the given tid
+  // Access a given column for the row with the given tid. If no_nulls is set,
+  // the tile group is known to hold no NULLs and the value is never NULL.
   codegen::Value LoadColumn(CodeGen &codegen, llvm::Value *tid,
-                            const TileGroup::ColumnLayout &layout) const;
+                            const TileGroup::ColumnLayout &layout,
+                            bool no_nulls) const;
+
+  // Access a given fixed-length column for the rows with the given vector of
+  // tids
+  llvm::Value *LoadColumnVector(CodeGen &codegen, llvm::Value *tids,
+                                uint32_t vector_size,
+                                const TileGroup::ColumnLayout &layout,
+                                bool no_nulls, llvm::Value *&is_null) const;
 
  public:
   //===--------------------------------------------------------------------===//
@@ -103,7 +134,8 @@ class TileGroup {
    public:
     // Constructor
     TileGroupAccess(const TileGroup &tile_group,
-                    const std::vector<ColumnLayout> &tile_group_layout);
+                    const std::vector<ColumnLayout> &tile_group_layout,
+                    bool no_nulls = false);
 
     //===------------------------------------------------------------------===//
     // A row in this tile group
@@ -112,7 +144,8 @@ class TileGroup {
      public:
       // Constructor
       Row(const TileGroup &tile_group,
-          const std::vector<ColumnLayout> &tile_group_layout, llvm::Value *tid);
+          const std::vector<ColumnLayout> &tile_group_layout, bool no_nulls,
+          llvm::Value *tid);
 
       // Load the column at the given index
       codegen::Value LoadColumn(CodeGen &codegen, uint32_t col_idx) const;
@@ -124,6 +157,8 @@ class TileGroup {
       const TileGroup &tile_group_;
       // The layout of the tile group
       const std::vector<ColumnLayout> &layout_;
+      // Is the tile group known to hold no NULLs?
+      bool no_nulls_;
       // The tid of the row
       llvm::Value *tid_;
     };
@@ -131,6 +166,14 @@ class TileGroup {
     // Load a specific row from the batch
     Row GetRow(llvm::Value *tid) const;
 
+    // Load the fixed-length column at the given index for a vector of tids.
+    // Runs of consecutive tids in a columnar layout are read with a single
+    // vector load. If the column is nullable, is_null is set to the mask of
+    // its NULL values.
+    llvm::Value *LoadColumnVector(CodeGen &codegen, llvm::Value *tids,
+                                  uint32_t vector_size, uint32_t col_idx,
+                                  llvm::Value *&is_null) const;
+
     //===------------------------------------------------------------------===//
     // ACCESSORS
     //===------------------------------------------------------------------===//
@@ -146,6 +189,10 @@ class TileGroup {
     const TileGroup &tile_group_;
     // The layout of all columns in the tile group
     const std::vector<ColumnLayout> &layout_;
+    // Is the tile group known to hold no NULLs? Nullable columns then load
+    // values whose NULL flag is constant false, so that the NULL handling of
+    // the code consuming them folds away.
+    bool no_nulls_;
   };
 
  private:
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// updater.h
+//
+// Identification: src/include/codegen/updater.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "common/macros.h"
+#include "type/types.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
+namespace planner {
+class UpdatePlan;
+}  // namespace planner
+
+namespace storage {
+class TileGroup;
+class TileGroupHeader;
+}  // namespace storage
+
+namespace type {
+class Value;
+}  // namespace type
+
+namespace codegen {
+
+//===----------------------------------------------------------------------===//
+// This class handles updates of tuples from generated code. The generated
+// code evaluates the SET expressions of the update and writes the new values
+// of all columns of a tuple into the value buffer of the updater. The updater
+// then installs them as the new version of the tuple, following the same
+// protocol as the UpdateExecutor.
+//
+// Like the Deleter, the updater lives in the runtime state and is initialized
+// (through Init()) outside the main loop.
+//===----------------------------------------------------------------------===//
+class Updater {
+ public:
+  // Initialize this updater for the given plan, whose table is updated in the
+  // transaction of the given executor context
+  void Init(const planner::UpdatePlan *plan,
+            executor::ExecutorContext *executor_context);
+
+  // The buffer of new values of the tuple, one for every column of the table
+  char *GetValues() const;
+
+  // Update the tuple at the provided offset in the tile group with the given
+  // ID to the values in the value buffer. Returns false, and fails the
+  // transaction, if the tuple could not be updated.
+  bool Update(uint32_t tile_group_id, uint32_t tuple_offset);
+
+  // Release the value buffer
+  void Destroy();
+
+ private:
+  // Can't construct
+  Updater()
+      : plan_(nullptr),
+        executor_context_(nullptr),
+        values_(nullptr),
+        target_col_ids_(nullptr),
+        in_place_(false) {}
+
+  // Write the new values of the updated columns into the given tuple slot
+  void WriteTargets(storage::TileGroup *tile_group, oid_t tuple_offset) const;
+
+  // Write the new values of all columns into the given tuple slot
+  void WriteAll(storage::TileGroup *tile_group, oid_t tuple_offset) const;
+
+  // Update the primary key, by deleting the old version and inserting the new
+  // values as a new tuple
+  bool UpdatePrimaryKey(bool is_owner,
+                        storage::TileGroupHeader *tile_group_header,
+                        ItemPointer old_location);
+
+  bool Fail() const;
+
+ private:
+  // The plan of the update
+  const planner::UpdatePlan *plan_;
+
+  // The context the updates happen in
+  executor::ExecutorContext *executor_context_;
+
+  // The values the generated code writes the new tuple into
+  peloton::type::Value *values_;
+
+  // The columns the update sets
+  std::vector<oid_t> *target_col_ids_;
+
+  // Can versions the transaction does not own yet be updated in place? Only
+  // if all other columns keep their values.
+  bool in_place_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(Updater);
+};
+
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bloom_filter.h
+//
+// Identification: src/include/codegen/util/bloom_filter.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+//===----------------------------------------------------------------------===//
+// A register-blocked Bloom filter over 64-bit hash values. All the bits of a
+// hash are set in a single 64-bit word, so a lookup touches one cache line
+// only. The filter only ever has false positives, never false negatives.
+//
+// Hash joins add the hash of every build-side key, and drop the probe-side
+// tuples the filter does not contain before they probe the hash table.
+//
+// The layout of this class is mirrored by codegen::BloomFilterProxy, since
+// compiled queries add and test hashes inline.
+//===----------------------------------------------------------------------===//
+class BloomFilter {
+ public:
+  // The number of bits of the filter per entry it was sized for
+  static constexpr uint64_t kBitsPerEntry = 16;
+
+  // The largest filter is 64 MB
+  static constexpr uint64_t kMaxNumWords = 8 * 1024 * 1024;
+
+  // The number of bits that are set for every hash
+  static constexpr uint32_t kNumHashBits = 4;
+
+  // The multiplier the word of a hash is picked with
+  static constexpr uint64_t kWordMultiplier = 0x9E3779B97F4A7C15ull;
+
+  // Constructor
+  BloomFilter();
+  // Destructor
+  ~BloomFilter();
+
+  // Initialize the filter for the given number of entries
+  void Init(uint64_t estimated_num_entries);
+
+  // Add the given hash to the filter
+  void Add(uint64_t hash) { words_[GetWordIndex(hash)] |= GetWordBits(hash); }
+
+  // Could the given hash have been added to the filter?
+  bool Contains(uint64_t hash) const {
+    uint64_t bits = GetWordBits(hash);
+    return (words_[GetWordIndex(hash)] & bits) == bits;
+  }
+
+  uint64_t GetNumWords() const { return word_mask_ + 1; }
+
+  // Cleanup all the resources this filter maintains
+  void Destroy();
+
+  // The bits a hash sets in its word, taken from consecutive 6-bit chunks of
+  // the low bits of the hash
+  static uint64_t GetWordBits(uint64_t hash) {
+    uint64_t bits = 0;
+    for (uint32_t i = 0; i < kNumHashBits; i++) {
+      bits |= uint64_t{1} << ((hash >> (6 * i)) & 63);
+    }
+    return bits;
+  }
+
+ private:
+  // The word of a hash is taken from the high bits of its product with a
+  // large odd constant, which mixes in all bits of the hash
+  uint64_t GetWordIndex(uint64_t hash) const {
+    return ((hash * kWordMultiplier) >> 32) & word_mask_;
+  }
+
+ private:
+  // The words of the filter, their number is a power of two
+  uint64_t *words_;
+  uint64_t word_mask_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_buffer.h
+//
+// Identification: src/include/codegen/util/partitioned_buffer.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace peloton {
+namespace codegen {
+namespace util {
+
+//===----------------------------------------------------------------------===//
+// A buffer of fixed-size tuples split into a number of partitions. Tuples are
+// appended to the partition the caller picks, and every partition is a
+// contiguous chunk of memory that doubles in size when it runs full.
+//
+// Radix hash joins scatter the tuples of both their inputs into partitions by
+// the bits of their hash, so that each pair of partitions can later be joined
+// with a hash table that fits into the cache.
+//===----------------------------------------------------------------------===//
+class PartitionedBuffer {
+ private:
+  // Partitions start out small, since there may be many of them
+  static constexpr uint64_t kInitialPartitionSize = 4 * 1024;
+
+ public:
+  // Constructor
+  PartitionedBuffer();
+  // Destructor
+  ~PartitionedBuffer();
+
+  // Initialize this buffer for tuples of the given size
+  void Init(uint32_t tuple_size, uint32_t num_partitions);
+
+  // Get space for a tuple at the end of the given partition
+  char *StoreInputTuple(uint32_t partition);
+
+  // Append the tuples of all partitions of the other buffer to the ones of
+  // this buffer, then destroy the other buffer
+  void TransferFrom(PartitionedBuffer &other);
+
+  // Access the tuples of a partition
+  char *GetPartitionStart(uint32_t partition) const;
+  uint64_t GetNumTuples(uint32_t partition) const;
+
+  uint32_t GetNumPartitions() const { return num_partitions_; }
+
+  // Cleanup all the resources this buffer maintains
+  void Destroy();
+
+ private:
+  // A contiguous chunk of tuples, with start <= pos <= end
+  struct Partition {
+    char *start;
+    char *pos;
+    char *end;
+  };
+
+  // Grow the partition so it has room for at least the given number of bytes
+  void Resize(Partition &partition, uint64_t min_free_space);
+
+ private:
+  // The partitions
+  Partition *partitions_;
+  uint32_t num_partitions_;
+
+  // The size of the tuples
+  uint32_t tuple_size_;
+};
+
+}  // namespace util
+}  // namespace codegen
+}  // namespace peloton
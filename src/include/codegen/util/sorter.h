@@ -42,6 +42,13 @@ class Sorter {
   // We (arbitrarily) allocate 4MB of buffer space upon initialization
   static constexpr uint64_t kInitialBufferSize = 1 * 1024 * 1024 * 4;
 
+  // Sorts of at least this many tuples are split into runs that are sorted on
+  // several threads and then merged
+  static constexpr uint64_t kParallelSortThreshold = 64 * 1024;
+
+  // The maximum number of threads a sort runs on
+  static constexpr uint32_t kMaxSortThreads = 16;
+
  public:
   typedef int (*ComparisonFunction)(const void *left_tuple,
                                     const void *right_tuple);
@@ -58,6 +65,17 @@ class Sorter {
   // provided at initialization time.
   char *StoreInputTuple();
 
+  // Called after the tuple returned by StoreInputTuple() was written, when
+  // only the first top_k tuples in the sort order are needed. The buffer is
+  // kept as a heap of at most top_k tuples whose root sorts last, so tuples
+  // that sort after all of them are dropped right away.
+  void StoreInputTupleTopK(uint64_t top_k);
+
+  // Move all the tuples of the other sorter into this one, and destroy the
+  // former. If only the first top_k tuples in the sort order are needed, the
+  // moved tuples go through the heap of StoreInputTupleTopK().
+  void TransferFrom(Sorter &other, uint64_t top_k);
+
   // Perform the sort
   void Sort();
 
@@ -93,9 +111,9 @@ class Sorter {
   uint64_t GetNumTuples() const { return GetUsedSpace() / tuple_size_; }
 
  private:
-  // Is there enough room in the buffer to store a tuple of the provided size?
-  bool EnoughSpace(uint32_t tuple_size) const {
-    return buffer_start_ != nullptr && buffer_pos_ + tuple_size < buffer_end_;
+  // Is there enough room in the buffer to store the provided number of bytes?
+  bool EnoughSpace(uint64_t size) const {
+    return buffer_start_ != nullptr && buffer_pos_ + size < buffer_end_;
   }
 
   uint64_t GetAllocatedSpace() const { return buffer_end_ - buffer_start_; }
@@ -104,6 +122,18 @@ class Sorter {
   // Resize the given array to a larger size
   void Resize();
 
+  // Sort the given tuple pointers by the comparison function. Large inputs are
+  // split into runs sorted on their own threads, which are then merged.
+  void SortTuplePointers(std::vector<char *> &tuples) const;
+
+  // Access the tuple at the given position in the buffer
+  char *GetTupleAt(uint64_t pos) const {
+    return buffer_start_ + pos * tuple_size_;
+  }
+
+  // Swap the contents of the tuples at the given positions
+  void SwapTuples(uint64_t left_pos, uint64_t right_pos);
+
  private:
   // The contiguous buffer space where tuples are stored.
   //
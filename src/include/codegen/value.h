@@ -116,6 +116,10 @@ class Value {
   void ValuesForMaterialization(CodeGen &codegen, llvm::Value *&val,
                                 llvm::Value *&len, llvm::Value *&null) const;
 
+  // Write this value into the element at the given index of an array of
+  // peloton::type::Value, through the output function of its SQL type
+  void OutputTo(CodeGen &codegen, llvm::Value *values, uint32_t idx) const;
+
   // Return a value that can be constructed from the provided type and value
   // registers
   static Value ValueFromMaterialization(const type::Type &type,
@@ -15,6 +15,11 @@
 #include "type/value.h"
 
 namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}  // namespace executor
+
 namespace codegen {
 
 class ValuesRuntime {
@@ -53,6 +58,32 @@ class ValuesRuntime {
 
   static int32_t CompareStrings(const char *str1, uint32_t len1,
                                 const char *str2, uint32_t len2);
+
+  // Does the string match the LIKE pattern? '%' matches any sequence of
+  // characters, '_' any single character, and a backslash escapes the
+  // character following it.
+  static bool Like(const char *str, uint32_t len, const char *pattern,
+                   uint32_t pattern_len);
+
+  // Fast paths for LIKE patterns known at compile time: does the string start
+  // with, end with or contain the given characters?
+  static bool StartsWith(const char *str, uint32_t len, const char *prefix,
+                         uint32_t prefix_len);
+  static bool EndsWith(const char *str, uint32_t len, const char *suffix,
+                       uint32_t suffix_len);
+  static bool Contains(const char *str, uint32_t len, const char *substr,
+                       uint32_t substr_len);
+
+  // The signature of the built-in SQL functions
+  typedef type::Value (*Function)(const std::vector<type::Value> &args);
+
+  // Call the function (a Function) on the given array of arguments, and write
+  // its result into the given slot in the native format of its type. Strings
+  // are copied into the memory pool of the executor context, their length is
+  // written out too. Returns whether the result is NULL.
+  static bool CallFunction(char *func, char *args, uint32_t num_args,
+                           executor::ExecutorContext *executor_context,
+                           char *result, uint32_t *result_len);
 };
 
 }  // namespace codegen
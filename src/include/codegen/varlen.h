@@ -25,19 +25,42 @@ class Varlen {
   // Get the length and the pointer to the variable length object
   static void SafeGetPtrAndLength(CodeGen &codegen, llvm::Value *varlen_ptr_ptr,
                                   llvm::Value *&data_ptr, llvm::Value *&len) {
-    // Load the Varlen** to get a Varlen*
-    auto *varlen_type = VarlenProxy::GetType(codegen);
-    auto *varlen_ptr = codegen->CreateLoad(codegen->CreateBitCast(
-        varlen_ptr_ptr, varlen_type->getPointerTo()->getPointerTo()));
+    // Short values are stored in the slot itself, tagged by the lowest bit of
+    // its first byte (see type::VarlenType::SerializeInlineTo())
+    auto *slot = codegen->CreateBitCast(varlen_ptr_ptr, codegen.CharPtrType());
+    auto *tag = codegen->CreateLoad(codegen.ByteType(), slot);
+    auto *is_inline = codegen->CreateICmpNE(
+        codegen->CreateAnd(tag, codegen.Const8(1)), codegen.Const8(0));
 
-    // The first four bytes are the length, load it here
-    auto *len_ptr =
-        codegen->CreateConstInBoundsGEP2_32(varlen_type, varlen_ptr, 0, 0);
-    len = codegen->CreateLoad(codegen.Int32Type(), len_ptr);
+    llvm::Value *inline_data = nullptr, *inline_len = nullptr;
+    lang::If varlen_is_inline{codegen, is_inline};
+    {
+      // The length is in the first byte, and the data follows it
+      inline_data =
+          codegen->CreateConstInBoundsGEP1_32(codegen.ByteType(), slot, 1);
+      inline_len = codegen->CreateZExt(
+          codegen->CreateLShr(tag, codegen.Const8(1)), codegen.Int32Type());
+    }
+    varlen_is_inline.ElseBlock();
+    {
+      // Load the Varlen** to get a Varlen*
+      auto *varlen_type = VarlenProxy::GetType(codegen);
+      auto *varlen_ptr = codegen->CreateLoad(codegen->CreateBitCast(
+          varlen_ptr_ptr, varlen_type->getPointerTo()->getPointerTo()));
+
+      // The first four bytes are the length, load it here
+      auto *len_ptr =
+          codegen->CreateConstInBoundsGEP2_32(varlen_type, varlen_ptr, 0, 0);
+      len = codegen->CreateLoad(codegen.Int32Type(), len_ptr);
+
+      // The four bytes after the start is where the (contiguous) data is
+      data_ptr =
+          codegen->CreateConstInBoundsGEP2_32(varlen_type, varlen_ptr, 0, 1);
+    }
+    varlen_is_inline.EndIf();
 
-    // The four bytes after the start is where the (contiguous) data is
-    data_ptr =
-        codegen->CreateConstInBoundsGEP2_32(varlen_type, varlen_ptr, 0, 1);
+    data_ptr = varlen_is_inline.BuildPHI(inline_data, data_ptr);
+    len = varlen_is_inline.BuildPHI(inline_len, len);
   }
 
   // Get the length and the pointer to the variable length object
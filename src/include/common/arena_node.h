@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_node.h
+//
+// Identification: src/include/common/arena_node.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace peloton {
+
+namespace type {
+class ArenaPool;
+}
+
+//===--------------------------------------------------------------------===//
+// Arena Node
+//===--------------------------------------------------------------------===//
+
+/**
+ * A base for the nodes of trees that are built and dropped as a whole, like
+ * the parse tree of a statement and the expressions in it.
+ *
+ * While an ArenaNodeScope lives, the nodes the thread creates are carved from
+ * its arena. Other nodes come from the heap. Deleting a node always runs its
+ * destructor, but only frees a heap node; the nodes of an arena are freed at
+ * once with the arena, which must outlive them.
+ */
+class ArenaNode {
+ public:
+  static void *operator new(size_t size);
+
+  static void operator delete(void *ptr);
+
+  // Placement new is hidden by the operator above otherwise
+  static void *operator new(size_t, void *place) { return place; }
+
+  static void operator delete(void *, void *) {}
+};
+
+/**
+ * Sets the arena the calling thread allocates arena nodes from while the
+ * scope lives. Scopes may be nested.
+ */
+class ArenaNodeScope {
+ public:
+  explicit ArenaNodeScope(type::ArenaPool *arena);
+
+  ~ArenaNodeScope();
+
+  ArenaNodeScope(const ArenaNodeScope &) = delete;
+  ArenaNodeScope &operator=(const ArenaNodeScope &) = delete;
+
+  // The arena of the innermost scope of the thread, nullptr if none
+  static type::ArenaPool *GetArena() { return current_arena_; }
+
+ private:
+  type::ArenaPool *previous_arena_;
+
+  static thread_local type::ArenaPool *current_arena_;
+};
+
+}  // namespace peloton
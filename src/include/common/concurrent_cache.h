@@ -0,0 +1,282 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// concurrent_cache.h
+//
+// Identification: src/include/common/concurrent_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/platform.h"
+
+#define DEFAULT_CACHE_SHARD_COUNT 16
+
+namespace peloton {
+
+/** @brief A cache that is shared by many threads
+ *
+ *  The keys are spread over shards by their hash, each with a lock of its
+ *  own. Lookups only take the lock of their shard for reading, so threads
+ *  finding the same few entries don't wait for each other. Instead of
+ *  keeping the entries in LRU order, which every lookup would have to
+ *  change, a lookup only marks its entry as referenced. Once a shard holds
+ *  more than its capacity, a clock hand goes round the entries of the
+ *  shard, evicting the ones that were not referenced since it last passed
+ *  them (CLOCK).
+ *
+ *  Every entry is charged against the capacity, by default 1 so that the
+ *  capacity is a number of entries, or e.g. the bytes of the value. The
+ *  eviction callback is called for every entry evicted for capacity, after
+ *  the lock of its shard is released.
+ * */
+template <class Key, class Value>
+class ConcurrentCache {
+ public:
+  typedef std::shared_ptr<Value> ValuePtr;
+
+  typedef std::function<void(const Key &, const ValuePtr &)> EvictionCallback;
+
+  ConcurrentCache(const ConcurrentCache &) = delete;
+  ConcurrentCache &operator=(const ConcurrentCache &) = delete;
+  ConcurrentCache(ConcurrentCache &&) = delete;
+  ConcurrentCache &operator=(ConcurrentCache &&) = delete;
+
+  /** @brief A cache holding entries charged up to capacity in total, which is
+   *   spread over the shards */
+  explicit ConcurrentCache(size_t capacity,
+                           size_t shard_count = DEFAULT_CACHE_SHARD_COUNT,
+                           EvictionCallback eviction_callback = nullptr)
+      : shard_capacity_((std::max<size_t>(capacity, 1) + shard_count - 1) /
+                        shard_count),
+        eviction_callback_(std::move(eviction_callback)) {
+    PL_ASSERT(shard_count > 0);
+    for (size_t shard_idx = 0; shard_idx < shard_count; shard_idx++) {
+      shards_.emplace_back(new Shard());
+    }
+  }
+
+  /** @brief The value cached with the key, or null */
+  ValuePtr Find(const Key &key) const {
+    auto &shard = GetShard(key);
+    PelotonReadLock lock(shard.lock);
+    auto itr = shard.entries.find(key);
+    if (itr == shard.entries.end()) {
+      return nullptr;
+    }
+    itr->second->referenced.store(true, std::memory_order_relaxed);
+    return itr->second->value;
+  }
+
+  /** @brief Cache the value with the key, replacing the value cached with it
+   *   before */
+  void Insert(const Key &key, ValuePtr value, size_t charge = 1) {
+    Insert(key, std::move(value), charge, true);
+  }
+
+  /** @brief Cache the value with the key unless there is one already
+   *  @return the value cached with the key
+   */
+  ValuePtr InsertIfAbsent(const Key &key, ValuePtr value, size_t charge = 1) {
+    return Insert(key, std::move(value), charge, false);
+  }
+
+  /** @brief Drop the entry of the key
+   *  @return whether there was one
+   */
+  bool Erase(const Key &key) {
+    auto &shard = GetShard(key);
+    PelotonWriteLock lock(shard.lock);
+    auto itr = shard.entries.find(key);
+    if (itr == shard.entries.end()) {
+      return false;
+    }
+    shard.Remove(itr);
+    return true;
+  }
+
+  /** @brief Drop the entry of the key if it still caches the given value
+   *  @return whether it did
+   */
+  bool Erase(const Key &key, const ValuePtr &value) {
+    auto &shard = GetShard(key);
+    PelotonWriteLock lock(shard.lock);
+    auto itr = shard.entries.find(key);
+    if (itr == shard.entries.end() || itr->second->value != value) {
+      return false;
+    }
+    shard.Remove(itr);
+    return true;
+  }
+
+  /** @brief Drop the entries whose key and value match the predicate
+   *  @return the number of entries dropped
+   */
+  template <typename Predicate>
+  size_t EraseIf(Predicate predicate) {
+    size_t erased_count = 0;
+    for (auto &shard : shards_) {
+      PelotonWriteLock lock(shard->lock);
+      for (auto itr = shard->entries.begin(); itr != shard->entries.end();) {
+        if (predicate(itr->first, itr->second->value)) {
+          itr = shard->Remove(itr);
+          erased_count++;
+        } else {
+          itr++;
+        }
+      }
+    }
+    return erased_count;
+  }
+
+  /** @brief Drop all entries, keeping the capacity */
+  void Clear() {
+    EraseIf([](const Key &, const ValuePtr &) { return true; });
+  }
+
+  /** @brief The number of entries */
+  size_t GetSize() const {
+    size_t size = 0;
+    for (auto &shard : shards_) {
+      PelotonReadLock lock(shard->lock);
+      size += shard->entries.size();
+    }
+    return size;
+  }
+
+  /** @brief The charges of all entries */
+  size_t GetCharge() const {
+    size_t charge = 0;
+    for (auto &shard : shards_) {
+      PelotonReadLock lock(shard->lock);
+      charge += shard->charge;
+    }
+    return charge;
+  }
+
+  size_t GetCapacity() const { return shard_capacity_ * shards_.size(); }
+
+ private:
+  struct Entry {
+    Key key;
+    ValuePtr value;
+    size_t charge;
+
+    // Set by lookups, cleared by the clock hand
+    std::atomic<bool> referenced;
+
+    // Where the entry is on the clock
+    size_t clock_idx;
+  };
+
+  typedef std::unordered_map<Key, std::unique_ptr<Entry>> EntryMap;
+
+  struct Shard {
+    // Take the entry out of the map and off the clock
+    typename EntryMap::iterator Remove(typename EntryMap::iterator itr) {
+      Entry *entry = itr->second.get();
+      charge -= entry->charge;
+
+      // The last entry on the clock takes the place of the removed one
+      Entry *last = clock.back();
+      clock[entry->clock_idx] = last;
+      last->clock_idx = entry->clock_idx;
+      clock.pop_back();
+      if (hand >= clock.size()) {
+        hand = 0;
+      }
+
+      return entries.erase(itr);
+    }
+
+    RWLock lock;
+    EntryMap entries;
+
+    // The entries in the order the hand passes them
+    std::vector<Entry *> clock;
+    size_t hand = 0;
+
+    size_t charge = 0;
+
+    char padding[CACHELINE_SIZE];
+  };
+
+  Shard &GetShard(const Key &key) const {
+    return *shards_[std::hash<Key>()(key) % shards_.size()];
+  }
+
+  ValuePtr Insert(const Key &key, ValuePtr value, size_t charge,
+                  bool replace) {
+    std::vector<std::pair<Key, ValuePtr>> evicted;
+    ValuePtr cached_value;
+    {
+      auto &shard = GetShard(key);
+      PelotonWriteLock lock(shard.lock);
+      auto itr = shard.entries.find(key);
+      if (itr != shard.entries.end()) {
+        Entry *entry = itr->second.get();
+        entry->referenced.store(true, std::memory_order_relaxed);
+        if (replace == false) {
+          return entry->value;
+        }
+        shard.charge = shard.charge - entry->charge + charge;
+        entry->value = std::move(value);
+        entry->charge = charge;
+        cached_value = entry->value;
+      } else {
+        std::unique_ptr<Entry> entry(new Entry());
+        entry->key = key;
+        entry->value = std::move(value);
+        entry->charge = charge;
+        entry->referenced.store(true, std::memory_order_relaxed);
+        entry->clock_idx = shard.clock.size();
+        cached_value = entry->value;
+        shard.clock.push_back(entry.get());
+        shard.charge += charge;
+        shard.entries.emplace(key, std::move(entry));
+      }
+
+      // Evict until the shard fits. The hand clears the marks it passes, so
+      // it goes round at most twice.
+      while (shard.charge > shard_capacity_ && shard.clock.empty() == false) {
+        Entry *candidate = shard.clock[shard.hand];
+        if (candidate->referenced.exchange(false,
+                                           std::memory_order_relaxed)) {
+          shard.hand = (shard.hand + 1) % shard.clock.size();
+          continue;
+        }
+        if (eviction_callback_ != nullptr) {
+          evicted.emplace_back(candidate->key, candidate->value);
+        }
+        shard.Remove(shard.entries.find(candidate->key));
+      }
+    }
+
+    for (auto &entry : evicted) {
+      eviction_callback_(entry.first, entry.second);
+    }
+    return cached_value;
+  }
+
+ private:
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  size_t shard_capacity_;
+
+  EvictionCallback eviction_callback_;
+};
+
+}  // namespace peloton
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// maintenance_scheduler.h
+//
+// Identification: src/include/common/maintenance_scheduler.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Maintenance Scheduler
+//===--------------------------------------------------------------------===//
+
+// The background tasks the scheduler paces
+enum class MaintenanceTask : uint32_t {
+  GC = 0,            // unlinking and reclaiming old versions
+  INDEX_TUNER = 1,   // building and dropping indexes
+  LAYOUT_TUNER = 2,  // changing the layout of tile groups
+  COMPACTOR = 3,     // compacting sparse tile groups
+  FREEZER = 4,       // freezing cold tile groups
+  CHECKPOINT = 5,    // writing checkpoints
+  KNOB_TUNER = 6,    // tuning the tile groups and the epoch length
+  EVICTOR = 7,       // evicting cold tile groups to files
+  EXPIRER = 8,       // deleting the tuples whose time to live is over
+  PROVISIONER = 9    // creating tile groups ahead of the inserts
+};
+
+static const size_t MAINTENANCE_TASK_COUNT = 10;
+
+std::string MaintenanceTaskToString(MaintenanceTask task);
+
+// How the background tasks are paced
+enum class MaintenanceMode : uint32_t {
+  IDLE = 0,       // no queries ran, the tasks pause less
+  NORMAL = 1,     // the tasks pause as they would on their own
+  THROTTLED = 2   // the latency of queries is above the SLO
+};
+
+std::string MaintenanceModeToString(MaintenanceMode mode);
+
+/**
+ * Paces the background maintenance tasks by the latency of the queries and
+ * by budgets of CPU time and writes the tasks share.
+ *
+ * Instead of sleeping for a fixed time between units of work, a task asks
+ * the scheduler how long to pause. The pause grows while the p99 latency of
+ * the queries (reported by the stats aggregator) is above
+ * FLAGS_maintenance_latency_slo_ms, and shrinks while no queries run. On top,
+ * the tasks pay for the CPU time and the bytes written of their work from
+ * token buckets that refill at FLAGS_maintenance_cpu_percent of a core and
+ * FLAGS_maintenance_io_mb per second. A task in debt pauses until it is
+ * paid off.
+ *
+ * GC is accounted but never held back, since longer version chains slow the
+ * queries down more than the GC itself does.
+ */
+class MaintenanceScheduler {
+ public:
+  // How much longer the tasks pause while throttled, and how much shorter
+  // while idle
+  static const uint64_t THROTTLE_FACTOR = 8;
+  static const uint64_t IDLE_FACTOR = 4;
+
+  // The shortest pause while throttled, and the longest pause (us)
+  static const uint64_t MIN_THROTTLED_PAUSE_US = 100 * 1000;
+  static const uint64_t MAX_PAUSE_US = 1000 * 1000;
+
+  // The latency reported last is used for this long (us)
+  static const uint64_t LATENCY_TIMEOUT_US = 5 * 1000 * 1000;
+
+  MaintenanceScheduler();
+
+  // Singleton, with the budgets and the SLO of the flags
+  static MaintenanceScheduler &GetInstance();
+
+  // The p99 latency (ms) of the queries of the last interval and how many
+  // ran
+  void RecordQueryLatency(const double p99_latency_ms,
+                          const uint64_t query_count);
+
+  // The time (us) and the bytes written of a unit of work the task did
+  void RecordWork(const MaintenanceTask task, const uint64_t work_us,
+                  const uint64_t io_bytes = 0);
+
+  // The time (us) the task pauses before its next unit of work, given the
+  // pause it takes on its own
+  uint64_t GetPause(const MaintenanceTask task, const uint64_t pause_us);
+
+  // Sleep for the pause of the task
+  void Pause(const MaintenanceTask task, const uint64_t pause_us);
+
+  MaintenanceMode GetMode() const;
+
+  // The CPU time (us) and bytes written by the task since the start
+  uint64_t GetWorkUs(const MaintenanceTask task) const;
+  uint64_t GetIoBytes(const MaintenanceTask task) const;
+
+  // The SLO (ms), the share of a core (%) and the writes per second (MB)
+  // budgeted, 0 for none
+  void SetBudgets(const uint64_t latency_slo_ms, const uint64_t cpu_percent,
+                  const uint64_t io_mb);
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  // Refill the buckets for the time passed since
+  void Refill(const Clock::time_point now);
+
+  MaintenanceMode GetMode(const Clock::time_point now) const;
+
+  // The writes budgeted (bytes/us)
+  double GetIoRate() const;
+
+  mutable std::mutex scheduler_mutex_;
+
+  uint64_t latency_slo_ms_ = 0;
+
+  uint64_t cpu_percent_ = 0;
+
+  uint64_t io_mb_ = 0;
+
+  // The latency and the queries reported last, and when
+  double p99_latency_ms_ = 0;
+  uint64_t query_count_ = 0;
+  Clock::time_point latency_time_;
+  bool has_latency_ = false;
+
+  // CPU time (us) and bytes the tasks may still use, negative if in debt
+  double cpu_tokens_us_ = 0;
+  double io_tokens_bytes_ = 0;
+  Clock::time_point refill_time_;
+
+  uint64_t work_us_[MAINTENANCE_TASK_COUNT] = {};
+  uint64_t io_bytes_[MAINTENANCE_TASK_COUNT] = {};
+};
+
+/**
+ * Times a unit of work of a task and records it with the scheduler once it
+ * ends
+ */
+class MaintenanceWork {
+ public:
+  MaintenanceWork(const MaintenanceTask task)
+      : task_(task), start_(std::chrono::steady_clock::now()) {}
+
+  ~MaintenanceWork() {
+    auto work_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::steady_clock::now() - start_).count();
+    MaintenanceScheduler::GetInstance().RecordWork(task_, work_us, io_bytes_);
+  }
+
+  inline void AddIoBytes(const uint64_t io_bytes) { io_bytes_ += io_bytes; }
+
+ private:
+  MaintenanceTask task_;
+
+  std::chrono::steady_clock::time_point start_;
+
+  uint64_t io_bytes_ = 0;
+};
+
+}  // End peloton namespace
@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_tracker.h
+//
+// Identification: src/include/common/memory_tracker.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Memory Tracker
+//===--------------------------------------------------------------------===//
+
+// What the memory is used for
+enum class MemoryComponentType : uint32_t {
+  TILE_DATA = 0,          // the tuple slots of tiles
+  TILE_GROUP_HEADER = 1,  // the MVCC headers of tile groups
+  INDIRECTION_ARRAY = 2,  // the indirections index entries point to
+  VARLEN_POOL = 3,        // the varlen data of tiles
+  INDEX = 4,              // the indexes, as reported by them
+  VERSION_CHAIN = 5,      // the versions awaiting GC, part of the tiles
+  PLAN_CACHE = 6,         // the statements of the plan cache
+  CODEGEN = 7             // the compiled queries
+};
+
+static const size_t MEMORY_COMPONENT_TYPE_COUNT = 8;
+
+std::string MemoryComponentTypeToString(MemoryComponentType type);
+
+/**
+ * Counts the bytes allocated for every component
+ *
+ * The components charge what they allocate and release it when they free
+ * it. The indexes and the versions awaiting GC are not charged, as they are
+ * computed from the tables instead, see stats::MemoryUsage.
+ *
+ * The allocations of a thread can also be measured, through the global
+ * operator new, to charge a component for structures that are allocated
+ * piecemeal, like plans and compiled queries.
+ */
+class MemoryTracker {
+ public:
+  // Charge the component for the bytes
+  static void Allocate(const MemoryComponentType type, const size_t bytes);
+
+  // Release bytes charged to the component
+  static void Release(const MemoryComponentType type, const size_t bytes);
+
+  // The bytes charged to the component and not released
+  static size_t GetAllocatedBytes(const MemoryComponentType type);
+
+  // Whether a scope measures the allocations of the calling thread
+  static inline bool IsMeasuringThread() { return thread_measure_depth_ > 0; }
+
+  // Called by the global operator new and delete while measuring, with the
+  // usable size of the block
+  static inline void RecordThreadAllocation(const size_t bytes) {
+    thread_allocated_bytes_ += bytes;
+  }
+
+  static inline void RecordThreadDeallocation(const size_t bytes) {
+    thread_allocated_bytes_ -= bytes;
+  }
+
+ private:
+  friend class MemoryScope;
+
+  // The number of scopes measuring the allocations of the thread
+  static thread_local uint32_t thread_measure_depth_;
+
+  // The bytes allocated less the bytes freed while measuring
+  static thread_local int64_t thread_allocated_bytes_;
+};
+
+/**
+ * Measures the bytes the calling thread allocates and does not free while
+ * the scope lives. Scopes may be nested.
+ */
+class MemoryScope {
+ public:
+  MemoryScope();
+
+  ~MemoryScope();
+
+  MemoryScope(const MemoryScope &) = delete;
+  MemoryScope &operator=(const MemoryScope &) = delete;
+
+  // The bytes allocated since the scope began, 0 if more were freed
+  size_t GetAllocatedBytes() const;
+
+ private:
+  int64_t begin_bytes_;
+};
+
+/**
+ * An allocator for standard containers that charges the component
+ */
+template <typename T, MemoryComponentType type>
+class TrackedAllocator {
+ public:
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef TrackedAllocator<U, type> other;
+  };
+
+  TrackedAllocator() {}
+
+  template <typename U>
+  TrackedAllocator(const TrackedAllocator<U, type> &) {}
+
+  T *allocate(size_t n) {
+    auto location = static_cast<T *>(::operator new(n * sizeof(T)));
+    MemoryTracker::Allocate(type, n * sizeof(T));
+    return location;
+  }
+
+  void deallocate(T *location, size_t n) {
+    MemoryTracker::Release(type, n * sizeof(T));
+    ::operator delete(location);
+  }
+
+  template <typename U>
+  bool operator==(const TrackedAllocator<U, type> &) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const TrackedAllocator<U, type> &) const {
+    return false;
+  }
+};
+
+}  // End peloton namespace
@@ -20,6 +20,7 @@
 #include <immintrin.h>
 
 #include "common/macros.h"
+#include "common/wait_events.h"
 
 //===--------------------------------------------------------------------===//
 // Synchronization utilities
@@ -118,10 +119,16 @@ class Spinlock {
  public:
   Spinlock() : spin_lock_state(Unlocked) {}
 
-  inline void Lock() {
+  // A contended lock is counted as a wait for the type of the latch
+  inline void Lock(const WaitEventType type = WaitEventType::SPINLOCK) {
+    if (TryLock()) {
+      return;
+    }
+    uint64_t wait_begin_ns = WaitEvents::BeginWait(type);
     while (!TryLock()) {
       _mm_pause();  // helps the cpu to detect busy-wait loop
     }
+    WaitEvents::EndWait(type, wait_begin_ns);
   }
 
   bool IsLocked() { return spin_lock_state.load() == Locked; }
@@ -15,13 +15,12 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "common/statement.h"
 #include "type/value.h"
 #include "statistics/query_metric.h"
 
 namespace peloton {
 
-class Statement;
-
 class Portal {
  public:
   Portal() = delete;
@@ -55,6 +54,11 @@ class Portal {
 
   // The serialized params for stats collection
   std::shared_ptr<stats::QueryMetric::QueryParams> param_stat_;
+
+  // The rows of an execution that stopped at its row limit, which the next
+  // executions of the portal send from suspended_row_ on
+  std::vector<StatementResult> suspended_results_;
+  size_t suspended_row_ = 0;
 };
 
 }  // namespace peloton
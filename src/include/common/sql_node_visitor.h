@@ -26,6 +26,7 @@ class TransactionStatement;
 class UpdateStatement;
 class CopyStatement;
 class AnalyzeStatement;
+class ExplainStatement;
 class JoinDefinition;
 struct TableRef;
 
@@ -76,6 +77,7 @@ class SqlNodeVisitor {
   virtual void Visit(const parser::UpdateStatement *) {}
   virtual void Visit(const parser::CopyStatement *) {}
   virtual void Visit(const parser::AnalyzeStatement *) {};
+  virtual void Visit(const parser::ExplainStatement *) {}
 
   virtual void Visit(expression::ComparisonExpression *expr);
   virtual void Visit(expression::AggregateExpression *expr);
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -29,6 +30,10 @@ class AbstractPlan;
 typedef std::pair<std::vector<unsigned char>, std::vector<unsigned char>>
     StatementResult;
 
+// Takes the complete rows of a result out of the given columns while the
+// rest of the result is still produced
+typedef std::function<void(std::vector<StatementResult> &)> ResultCallback;
+
 // FIELD INFO TYPE : field name, oid (data type), size
 typedef std::tuple<std::string, oid_t, size_t> FieldInfo;
 
@@ -82,6 +87,60 @@ class Statement : public Printable {
 
   inline void SetNeedsPlan(bool replan) { needs_replan_ = replan; }
 
+  inline bool IsReadOnlyTransaction() const { return read_only_transaction_; }
+
+  inline void SetReadOnlyTransaction(bool read_only) {
+    read_only_transaction_ = read_only;
+  }
+
+  inline IsolationLevelType GetTransactionIsolation() const {
+    return transaction_isolation_;
+  }
+
+  inline void SetTransactionIsolation(IsolationLevelType isolation) {
+    transaction_isolation_ = isolation;
+  }
+
+  // An EXPLAIN has the plan of the statement it explains, which has the
+  // given number of columns. EXPLAIN ANALYZE runs it.
+  inline void SetExplain(bool analyze, size_t explained_column_count) {
+    explain_ = true;
+    explain_analyze_ = analyze;
+    explained_column_count_ = explained_column_count;
+  }
+
+  inline bool IsExplain() const { return explain_; }
+
+  inline bool IsExplainAnalyze() const { return explain_analyze_; }
+
+  inline size_t GetExplainedColumnCount() const {
+    return explained_column_count_;
+  }
+
+  // Id of the statement in the command log. Ids are only valid for the run
+  // of the logging they were assigned in.
+  inline bool GetCommandId(const size_t log_generation,
+                           uint32_t &command_id) const {
+    if (command_log_generation_ != log_generation) {
+      return false;
+    }
+    command_id = command_id_;
+    return true;
+  }
+
+  inline void SetCommandId(const size_t log_generation,
+                           const uint32_t command_id) {
+    command_log_generation_ = log_generation;
+    command_id_ = command_id;
+  }
+
+  // The bytes allocated to prepare the statement and kept by it
+  inline size_t GetMemoryFootprint() const { return memory_footprint_; }
+
+  inline void SetMemoryFootprint(size_t memory_footprint) {
+    memory_footprint_ = memory_footprint;
+  }
+
   // Get a string representation for debugging
   const std::string GetInfo() const;
 
@@ -116,6 +175,26 @@ class Statement : public Printable {
   // If this flag is true, then somebody wants us to replan this query
   bool needs_replan_ = false;
 
+  // bytes allocated to prepare the statement
+  size_t memory_footprint_ = 0;
+
+  // If this flag is true, then this BEGIN starts a read-only transaction
+  bool read_only_transaction_ = false;
+
+  // The isolation level of the transaction this BEGIN starts, INVALID for the
+  // default level of the transaction manager
+  IsolationLevelType transaction_isolation_ = IsolationLevelType::INVALID;
+
+  // If these flags are true, then this is an EXPLAIN [ANALYZE]
+  bool explain_ = false;
+  bool explain_analyze_ = false;
+  size_t explained_column_count_ = 0;
+
+  uint32_t command_id_ = 0;
+
+  // run of the logging the command id belongs to, 0 if none
+  size_t command_log_generation_ = 0;
+
   // containing pairs of <query_type_string, query_type>
   // use map to speed up searching
   static std::unordered_map<std::string, QueryType> query_type_map_;
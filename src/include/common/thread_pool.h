@@ -4,66 +4,82 @@
 //
 // thread_pool.h
 //
-// Identification: src/include/common/worker_thread_pool.h
+// Identification: src/include/common/thread_pool.h
 //
-// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
 
-
 #pragma once
 
-#include <vector>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <thread>
-
-#include <boost/asio/io_service.hpp>
-#include <boost/thread/thread.hpp>
-#include <boost/bind.hpp>
-#include <boost/function.hpp>
+#include <vector>
 
 #include "common/macros.h"
+#include "util/numa_util.h"
 
 namespace peloton {
-// a wrapper for boost worker thread pool.
-class ThreadPool {
- public:
-  ThreadPool() : pool_size_(0), 
-                 dedicated_thread_count_(0),
-                 work_(io_service_) { }
 
-  ~ThreadPool() { }
+// Workers run every task of a higher priority they can find first
+enum class TaskPriority {
+  FOREGROUND = 0,  // work of queries, like morsels and packets
+  BACKGROUND = 1,  // maintenance, like garbage collection and tuning
+};
 
-  void Initialize(const size_t &pool_size, const size_t &dedicated_thread_count) {
-    current_thread_count_ = ATOMIC_VAR_INIT(0);
-    pool_size_ = pool_size;
-    // PL_ASSERT(pool_size_ != 0);
+// Where the worker threads of a pool run
+enum class ThreadPlacement {
+  NONE,       // wherever the OS schedules them
+  NUMA_NODE,  // on the CPUs of a node each, spread over the nodes
+  CPU,        // pinned to a CPU each, spread over the nodes
+};
 
-    dedicated_thread_count_ = dedicated_thread_count;
+//===--------------------------------------------------------------------===//
+// Thread Pool
+//===--------------------------------------------------------------------===//
+
+/**
+ * A work-stealing pool of worker threads, plus dedicated threads for tasks
+ * that run until shutdown.
+ *
+ * Every worker has a deque of tasks per priority. Tasks submitted by a worker
+ * go to the back of its own deque, and it runs the newest of them first while
+ * their data is still in its cache. Tasks submitted by other threads are
+ * spread over the workers. A worker without tasks steals the oldest task of
+ * another one, trying the workers of its own NUMA node first, and sleeps once
+ * there is nothing left to steal.
+ */
+class ThreadPool {
+ public:
+  ThreadPool() {}
 
-    for (size_t i = 0; i < pool_size_; ++i) {
-      // add thread to thread pool.
-      thread_pool_.create_thread(
-          boost::bind(&boost::asio::io_service::run, &io_service_));
-    }
+  ~ThreadPool();
 
-    dedicated_threads_.resize(dedicated_thread_count_);
-  }
+  void Initialize(const size_t &pool_size, const size_t &dedicated_thread_count,
+                  const ThreadPlacement placement = ThreadPlacement::NONE);
 
-  void Shutdown() {
-    // always join lastly created threads first.
-    for (size_t i = 0; i < current_thread_count_; ++i) {
-      dedicated_threads_[(current_thread_count_ - 1 - i)]->join();
-    }
-    io_service_.stop();
-    thread_pool_.join_all();
-  }
+  // Join the dedicated threads, then stop the workers. Tasks they have not
+  // started are dropped.
+  void Shutdown();
 
   // submit task to thread pool.
   // it accepts a function and a set of function parameters as parameters.
   template <typename FunctionType, typename... ParamTypes>
   void SubmitTask(FunctionType &&func, const ParamTypes &&... params) {
-    // add task to thread pool.
-    io_service_.post(std::bind(func, params...));
+    Submit(TaskPriority::FOREGROUND, std::bind(func, params...));
+  }
+
+  // submit task of the given priority to thread pool.
+  template <typename FunctionType, typename... ParamTypes>
+  void SubmitTaskWithPriority(const TaskPriority priority,
+                              FunctionType &&func,
+                              const ParamTypes &&... params) {
+    Submit(priority, std::bind(func, params...));
   }
 
   // submit task to a dedicated thread.
@@ -72,31 +88,70 @@ class ThreadPool {
   void SubmitDedicatedTask(FunctionType &&func, const ParamTypes &&... params) {
     size_t thread_id =
         current_thread_count_.fetch_add(1, std::memory_order_relaxed);
+    PL_ASSERT(thread_id < dedicated_threads_.size());
     // assign task to dedicated thread.
-    dedicated_threads_[thread_id].reset(new std::thread(std::thread(func, params...)));
+    dedicated_threads_[thread_id].reset(new std::thread(func, params...));
+  }
+
+  size_t GetWorkerCount() const { return workers_.size(); }
+
+  // The NUMA node a worker runs on, INVALID_NUMA_NODE if it is not placed
+  int GetWorkerNode(const size_t worker_id) const {
+    return workers_[worker_id]->numa_node;
   }
 
  private:
-  ThreadPool(const ThreadPool &);
-  ThreadPool &operator=(const ThreadPool &);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  typedef std::function<void()> Task;
+
+  static const size_t kPriorityCount = 2;
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks[kPriorityCount];
+
+    int numa_node = INVALID_NUMA_NODE;
+    int cpu = -1;
+
+    // The workers to steal from, the ones on the same node first
+    std::vector<size_t> victims;
+
+    std::thread thread;
+  };
+
+  void Submit(const TaskPriority priority, Task &&task);
+
+  void RunWorker(const size_t worker_id);
+
+  // Take the next task for the worker, from its own deques or stolen
+  bool FindTask(const size_t worker_id, Task &task);
+
+  void StopWorkers();
 
  private:
-  // number of threads in the thread pool.
-  size_t pool_size_;
   // max number of dedicated threads.
-  size_t dedicated_thread_count_;
+  size_t dedicated_thread_count_ = 0;
   // current number of dedicated threads.
   std::atomic<size_t> current_thread_count_ = ATOMIC_VAR_INIT(0);
 
-  // real thread pool that holds a set of threads.
-  boost::thread_group thread_pool_;
-  // io_service provides IO functionality of asynchronize services.
-  boost::asio::io_service io_service_;
-  // io_service::work is responsible for starting the io_service processing
-  // loop.
-  boost::asio::io_service::work work_;
-
   std::vector<std::unique_ptr<std::thread>> dedicated_threads_;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Where tasks submitted by other threads go next
+  std::atomic<size_t> next_worker_ = ATOMIC_VAR_INIT(0);
+
+  // Tasks in the deques. Briefly off by the tasks being pushed and taken.
+  std::atomic<int64_t> pending_task_count_ = ATOMIC_VAR_INIT(0);
+
+  // Idle workers sleep until tasks are submitted
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  std::atomic<size_t> sleeping_count_ = ATOMIC_VAR_INIT(0);
+
+  std::atomic<bool> stopped_ = ATOMIC_VAR_INIT(false);
 };
 
 }  // End peloton namespace
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wait_events.h
+//
+// Identification: src/include/common/wait_events.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace peloton {
+
+//===--------------------------------------------------------------------===//
+// Wait Events
+//===--------------------------------------------------------------------===//
+
+// What a thread waits for. The latches are only counted when they are
+// contended.
+enum class WaitEventType : uint32_t {
+  SPINLOCK = 0,           // a latch without a name
+  TUPLE_LATCH = 1,        // the latch in a tuple header
+  TILE_HEADER_LATCH = 2,  // the latch of a tile group header
+  POOL_LATCH = 3,         // the latch of a varlen pool
+  EPOCH_LATCH = 4,        // the overflow latch of a local epoch
+  EPOCH_WAIT = 5,         // a commit waiting for its epoch to be durable
+  RETRY_BACKOFF = 6       // an aborted transaction backing off
+};
+
+static const size_t WAIT_EVENT_TYPE_COUNT = 7;
+
+std::string WaitEventTypeToString(WaitEventType type);
+
+// The waits of all threads since the start
+struct WaitEventTotals {
+  // The number of waits
+  uint64_t wait_counts[WAIT_EVENT_TYPE_COUNT] = {};
+
+  // The time waited (us), estimated from the waits that were timed
+  uint64_t wait_us[WAIT_EVENT_TYPE_COUNT] = {};
+};
+
+/**
+ * Counts the waits of every thread by what they wait for
+ *
+ * Every thread counts into a slot of its own, so counting is a plain add.
+ * Only one in WAIT_SAMPLE_INTERVAL waits of a type reads the clock, which
+ * bounds the overhead on contended latches. Waits whose duration is known
+ * anyway are all timed. Slots of exited threads are reused, so the totals
+ * keep their waits.
+ */
+class WaitEvents {
+ public:
+  static const uint64_t WAIT_SAMPLE_INTERVAL = 16;
+
+  // Begin a wait of the calling thread. Returns the time it began (ns) if
+  // the wait is timed, 0 otherwise.
+  static uint64_t BeginWait(const WaitEventType type);
+
+  // End the wait begun at the given time
+  static void EndWait(const WaitEventType type, const uint64_t begin_ns);
+
+  // Record a wait of the calling thread that took the given time (us)
+  static void RecordWait(const WaitEventType type, const uint64_t wait_us);
+
+  // Sum up the waits of all threads
+  static WaitEventTotals GetTotals();
+};
+
+}  // End peloton namespace
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// contention_manager.h
+//
+// Identification: src/include/concurrency/contention_manager.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace concurrency {
+
+//===--------------------------------------------------------------------===//
+// Contention Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * Tracks how often transactions conflict on each tile group and schedules
+ * the retries of the transactions that aborted because of a conflict.
+ *
+ * The transaction manager and the executors report every failed attempt to
+ * own or read a version. The conflict counters are hashed by tile group and
+ * halved every epoch, so they follow the current hot spots. When a client
+ * retries an aborted transaction, it first waits for a randomized backoff
+ * that grows with its consecutive aborts and with the hotness of the tile
+ * group it conflicted on. Retries of transactions that conflicted on a hot
+ * tile group are also admitted only a few at a time, so that they do not
+ * keep aborting each other.
+ *
+ * The per-transaction state is kept per thread, as a transaction runs in a
+ * single thread and its client retries it from the same thread.
+ *
+ * The aborts are counted by the table and the type of the conflict that
+ * aborted them, and the backoffs as waits of the thread.
+ */
+class ContentionManager {
+ public:
+  ContentionManager(const ContentionManager &) = delete;
+  ContentionManager &operator=(const ContentionManager &) = delete;
+  ContentionManager(ContentionManager &&) = delete;
+  ContentionManager &operator=(ContentionManager &&) = delete;
+
+  ContentionManager();
+
+  ~ContentionManager() {}
+
+  // Singleton
+  static ContentionManager &GetInstance();
+
+  // Record that the running transaction of this thread conflicted with a
+  // concurrent transaction on the tile group
+  void RecordConflict(const oid_t tile_group_id, const ConflictType type);
+
+  // Called when the running transaction of this thread ends
+  void EndTransaction(const ResultType result);
+
+  // Wait before retrying the transaction that this thread aborted last.
+  // Returns the time waited (in us).
+  uint64_t WaitBeforeRetry();
+
+  // Backoff (in us) before the next retry of this thread, before jitter
+  uint64_t GetRetryBackoff();
+
+  // Recent number of conflicts on the tile group
+  uint32_t GetHotness(const oid_t tile_group_id);
+
+  bool IsHot(const oid_t tile_group_id) {
+    return GetHotness(tile_group_id) >= hot_threshold;
+  }
+
+  // The aborts since the last reset, by the table and the type of the last
+  // conflict of the aborted transaction. Aborts without a conflict have an
+  // invalid table and type.
+  std::map<std::pair<oid_t, ConflictType>, uint64_t> GetAbortCounts();
+
+  // Forget every conflict and abort
+  void Reset();
+
+ private:
+  static const size_t slot_count = 4096;
+
+  static size_t GetSlot(const oid_t tile_group_id) {
+    return (tile_group_id * 0x9E3779B1U) % slot_count;
+  }
+
+  // Conflict count in the low 32 bits, epoch of the last update in the high
+  // 32 bits
+  std::array<std::atomic<uint64_t>, slot_count> conflict_counts;
+
+  // Number of admitted retries that conflicted on the slot
+  std::array<std::atomic<uint32_t>, slot_count> admitted_retries;
+
+  // Aborts are rare next to the work they undo, so they take a lock
+  std::mutex abort_counts_lock;
+  std::map<std::pair<oid_t, ConflictType>, uint64_t> abort_counts;
+
+  //===--------------------------------------------------------------------===//
+  // Contention Parameters
+  //===--------------------------------------------------------------------===//
+
+  // A tile group with this many recent conflicts is hot
+  uint32_t hot_threshold = 16;
+
+  // Retries that may run concurrently after conflicting on a hot tile group
+  uint32_t max_admitted_retries = 2;
+
+  // Backoff after the first abort (in us)
+  uint64_t base_backoff = 10;
+
+  // Largest backoff (in us)
+  uint64_t max_backoff = 10000;
+};
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <thread>
 #include <vector>
 
@@ -32,11 +34,16 @@ class DecentralizedEpochManager : public EpochManager {
   DecentralizedEpochManager(const DecentralizedEpochManager&) = delete;
 
 public:
-  DecentralizedEpochManager() : 
-    current_global_epoch_id_(1), 
+  DecentralizedEpochManager() :
+    thread_count_(0),
+    current_global_epoch_id_(1),
     next_txn_id_(0),
     snapshot_global_epoch_id_(1),
+    last_expired_epoch_id_(0),
     is_running_(false) {
+      for (auto &registered : registered_threads_) {
+        registered = false;
+      }
       // register a default thread for handling catalog stuffs.
       RegisterThread(0);
   }
@@ -56,8 +63,12 @@ public:
     current_global_epoch_id_ = current_epoch_id;
     next_txn_id_ = 0;
     snapshot_global_epoch_id_ = 1;
-    local_epochs_.clear();
-    
+    last_expired_epoch_id_ = 0;
+    for (auto &registered : registered_threads_) {
+      registered = false;
+    }
+    thread_count_ = 0;
+
     RegisterThread(0);
   }
 
@@ -83,20 +94,24 @@ public:
     this->is_running_ = false;
   }
 
+  // registration only touches the slot of the thread, so it never waits for
+  // the epoch thread.
   virtual void RegisterThread(const size_t thread_id) override {
-    local_epoch_lock_.Lock();
+    PL_ASSERT(thread_id < max_thread_count);
 
-    local_epochs_[thread_id].reset(new LocalEpoch(thread_id));
+    local_epochs_[thread_id].Reset(thread_id);
+    registered_threads_[thread_id] = true;
 
-    local_epoch_lock_.Unlock();
+    // raise the number of slots that the epoch thread scans
+    size_t thread_count = thread_count_.load();
+    while (thread_count < thread_id + 1 &&
+           thread_count_.compare_exchange_weak(thread_count, thread_id + 1) == false);
   }
 
   virtual void DeregisterThread(const size_t thread_id) override {
-    local_epoch_lock_.Lock();
+    PL_ASSERT(thread_id < max_thread_count);
 
-    local_epochs_.erase(thread_id);
-
-    local_epoch_lock_.Unlock();
+    registered_threads_[thread_id] = false;
   }
 
   // a transaction enters epoch with thread id
@@ -111,6 +126,14 @@ public:
     return (max_committed_eid << 32) | 0xFFFFFFFF;
   }
 
+  virtual cid_t GetLastExpiredCid() override {
+    uint64_t max_committed_eid = last_expired_epoch_id_.load();
+    if (max_committed_eid == 0) {
+      return 0;
+    }
+    return (max_committed_eid << 32) | 0xFFFFFFFF;
+  }
+
   virtual eid_t GetExpiredEpochId() override;
 
   virtual eid_t GetNextEpochId() override {
@@ -124,6 +147,16 @@ public:
 private:
 
 
+  // advance the snapshot epoch, never move it back
+  void AdvanceSnapshotEpochId(const eid_t epoch_id) {
+    eid_t snapshot_epoch_id = snapshot_global_epoch_id_.load();
+    while (snapshot_epoch_id < epoch_id &&
+           snapshot_global_epoch_id_.compare_exchange_weak(snapshot_epoch_id, epoch_id) == false);
+  }
+
+  // the minimum expired epoch id over all the registered threads
+  eid_t GetLocalExpiredEpochId(const eid_t current_epoch_id);
+
   inline uint32_t GetNextTransactionId() {
     return next_txn_id_.fetch_add(1, std::memory_order_relaxed);
   }
@@ -135,17 +168,24 @@ private:
 
     while (is_running_ == true) {
       // the epoch advances every EPOCH_LENGTH milliseconds.
-      std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH));
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(EPOCH_LENGTH.load()));
       current_global_epoch_id_.fetch_add(1);
     }
   }
 
 private:
 
-  // each thread holds a pointer to a local epoch.
+  // maximum number of threads that can register
+  static const size_t max_thread_count = 256;
+
+  // each thread owns the local epoch at its thread id.
   // it updates the local epoch to report their local time.
-  Spinlock local_epoch_lock_;
-  std::unordered_map<int, std::unique_ptr<LocalEpoch>> local_epochs_;
+  std::array<LocalEpoch, max_thread_count> local_epochs_;
+  std::array<std::atomic<bool>, max_thread_count> registered_threads_;
+
+  // one more than the largest registered thread id
+  std::atomic<size_t> thread_count_;
   
   // the global epoch reflects the true time of the system.
   std::atomic<eid_t> current_global_epoch_id_;
@@ -153,7 +193,10 @@ private:
   
   // snapshot epoch is an epoch where the corresponding tuples may be still
   // visible to on-the-fly transactions
-  eid_t snapshot_global_epoch_id_;
+  std::atomic<eid_t> snapshot_global_epoch_id_;
+
+  // the largest epoch id returned by GetExpiredEpochId(), 0 if none
+  std::atomic<eid_t> last_expired_epoch_id_;
 
   bool is_running_;
 
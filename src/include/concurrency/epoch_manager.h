@@ -59,6 +59,10 @@ public:
 
   virtual cid_t GetExpiredCid() = 0;
 
+  // the expired cid found by the last GetExpiredCid(). cheaper, but may lag
+  // behind. once expired, a cid stays expired, so it is still safe.
+  virtual cid_t GetLastExpiredCid() = 0;
+
 };
 
 }
@@ -13,11 +13,9 @@
 
 #pragma once
 
-#include <thread>
-#include <queue>
-#include <vector>
-#include <unordered_map>
-#include <functional>
+#include <array>
+#include <atomic>
+#include <map>
 #include <cstdint>
 
 #include "type/types.h"
@@ -26,48 +24,83 @@
 namespace peloton {
 namespace concurrency {
 
-struct Epoch {
-  Epoch(const uint64_t epoch_id, const size_t txn_count):
-    epoch_id_(epoch_id),
-    txn_count_(txn_count) {}
+/**
+ * The epochs in which the transactions of one thread are running.
+ *
+ * Each slot packs an epoch id and the number of transactions running in it
+ * into one word, so entering and exiting an epoch is a single CAS on a slot
+ * that is normally touched by its own thread only. A thread rarely has
+ * transactions in more than a couple of epochs at once. When all slots hold
+ * other active epochs, the transaction falls back to a locked overflow map.
+ *
+ * The hot fields fill exactly one cache line and the local epochs of
+ * different threads never share one.
+ */
+class CACHE_ALIGNED LocalEpoch {
 
-  Epoch(const Epoch& epoch) {
-    this->epoch_id_ = epoch.epoch_id_;
-    this->txn_count_ = epoch.txn_count_;
-  }
-
-  uint64_t epoch_id_;
-  size_t txn_count_;
-};
-
-struct EpochCompare {
-  bool operator()(const std::shared_ptr<Epoch> &lhs, const std::shared_ptr<Epoch> &rhs) {
-    return lhs->epoch_id_ > rhs->epoch_id_;
+public:
+  LocalEpoch() : LocalEpoch(0) {}
+
+  LocalEpoch(const size_t thread_id) :
+    epoch_id_lower_bound_(UINT64_MAX),
+    overflow_count_(0),
+    thread_id_(thread_id) {
+      for (auto &slot : epoch_slots_) {
+        slot = 0;
+      }
   }
-};
 
-class LocalEpoch {
-
-public:
-  LocalEpoch(const size_t thread_id) : 
-    epoch_id_lower_bound_(UINT64_MAX), 
-    thread_id_(thread_id) {}
+  // forget all the epochs. the thread must not have running transactions.
+  void Reset(const size_t thread_id);
 
   bool EnterEpoch(const eid_t epoch_id, const TimestampType ts_type);
 
   void ExitEpoch(const eid_t epoch_id);
-  
+
   uint64_t GetExpiredEpochId(const uint64_t current_epoch_id);
 
+  inline size_t GetThreadId() const { return thread_id_; }
+
 private:
-  Spinlock epoch_lock_;
-  
-  uint64_t epoch_id_lower_bound_;
+  static const size_t slot_count = 6;
+
+  // a slot holds the epoch id in the upper bits and the transaction count
+  // in the lower ones. a slot whose count is 0 is free.
+  static const uint64_t count_bits = 24;
+  static const uint64_t count_mask = (1UL << count_bits) - 1;
+
+  static inline uint64_t PackSlot(const eid_t epoch_id, const uint64_t count) {
+    return (epoch_id << count_bits) | count;
+  }
+
+  static inline eid_t GetSlotEpochId(const uint64_t slot) {
+    return slot >> count_bits;
+  }
+
+  static inline uint64_t GetSlotCount(const uint64_t slot) {
+    return slot & count_mask;
+  }
+
+  // register a transaction in the epoch
+  void Publish(const eid_t epoch_id);
+
+  // unregister a transaction from the epoch
+  void Unpublish(const eid_t epoch_id);
+
+  std::array<std::atomic<uint64_t>, slot_count> epoch_slots_;
+
+  // the last expired epoch id reported to the epoch manager. transactions
+  // cannot enter an epoch that has already been reported as expired.
+  std::atomic<uint64_t> epoch_id_lower_bound_;
+
+  // number of transactions in the overflow map
+  std::atomic<uint64_t> overflow_count_;
+
+  Spinlock overflow_lock_;
+
+  std::map<eid_t, size_t> overflow_epochs_;
 
   size_t thread_id_;
-  
-  std::priority_queue<std::shared_ptr<Epoch>, std::vector<std::shared_ptr<Epoch>>, EpochCompare> epoch_queue_;
-  std::unordered_map<uint64_t, std::shared_ptr<Epoch>> epoch_map_;
 };
 
 }
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// optimistic_transaction_manager.h
+//
+// Identification: src/include/concurrency/optimistic_transaction_manager.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "concurrency/timestamp_ordering_transaction_manager.h"
+
+namespace peloton {
+namespace concurrency {
+
+//===--------------------------------------------------------------------===//
+// optimistic concurrency control
+//===--------------------------------------------------------------------===//
+
+// Readers never write to the tuple headers. A transaction keeps the versions
+// it read in its read set and validates, at commit time and while holding the
+// ownership of every version it writes, that none of them has been
+// overwritten or is owned by a concurrent transaction. Writes, version chain
+// maintenance and installation are shared with timestamp ordering.
+class OptimisticTransactionManager
+    : public TimestampOrderingTransactionManager {
+ public:
+  OptimisticTransactionManager() {}
+
+  virtual ~OptimisticTransactionManager() {}
+
+  static OptimisticTransactionManager &GetInstance(
+      const ProtocolType protocol,
+      const IsolationLevelType isolation,
+      const ConflictAvoidanceType conflict);
+
+  // Ownership only excludes concurrent writers. Readers are checked at commit.
+  virtual bool AcquireOwnership(
+      Transaction *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id);
+
+  virtual bool PerformRead(Transaction *const current_txn,
+                           const ItemPointer &location,
+                           bool acquire_ownership = false);
+
+  virtual ResultType CommitTransaction(Transaction *const current_txn);
+
+  // Validates the read set ahead of the commit. The commit validates it again,
+  // so a transaction prepared here can still abort when a concurrent writer
+  // overwrote what it read in between.
+  virtual ResultType PrepareTransaction(Transaction *const current_txn);
+
+  // Check that every version in the read set is still the latest committed
+  // version of its tuple.
+  bool ValidateReadSet(Transaction *const current_txn);
+};
+}
+}
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_transaction_manager.h
+//
+// Identification: src/include/concurrency/partitioned_transaction_manager.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/platform.h"
+#include "concurrency/timestamp_ordering_transaction_manager.h"
+
+namespace peloton {
+namespace concurrency {
+
+//===--------------------------------------------------------------------===//
+// partitioned execution
+//===--------------------------------------------------------------------===//
+
+// H-Store style execution for workloads that partition by a key.
+//
+// A transaction declares the partitions it accesses and holds their locks
+// from its beginning to its end, so the transactions of one partition run
+// serially. A single-partition transaction therefore skips the per-tuple
+// concurrency control of timestamp ordering: it does not publish itself as
+// the last reader of the versions it reads, and takes ownership without the
+// tuple latch. Its writes still create versions, so snapshot readers and the
+// GC are unaffected. A transaction spanning several partitions locks all of
+// them in partition order and runs the full timestamp ordering protocol.
+//
+// The workload must only access the partitions it declares. Tables that are
+// not partitioned may be read by any transaction, but must only be written by
+// transactions that lock every partition. Transactions begun without
+// declaring partitions are plain timestamp ordering transactions and are not
+// isolated from single-partition ones.
+//
+// With in-place updates enabled, a single-partition transaction overwrites
+// the updated columns of the newest version in place and keeps their old
+// values in its undo buffer, instead of copying the whole tuple into a new
+// version. Updates of indexed or non-inlined columns still install a new
+// version. As no older version is left behind, every transaction reading
+// such a partition, read-only ones included, must declare it.
+class PartitionedTransactionManager
+    : public TimestampOrderingTransactionManager {
+ public:
+  PartitionedTransactionManager()
+      : partition_count_(0), in_place_updates_(false) {
+    SetPartitionCount(1);
+  }
+
+  virtual ~PartitionedTransactionManager() {}
+
+  static PartitionedTransactionManager &GetInstance(
+      const ProtocolType protocol,
+      const IsolationLevelType isolation,
+      const ConflictAvoidanceType conflict);
+
+  // No transaction may be running while the partitions are changed.
+  void SetPartitionCount(const size_t partition_count);
+
+  inline size_t GetPartitionCount() const { return partition_count_; }
+
+  // Partition of an integer partitioning key, e.g. a warehouse id
+  inline size_t GetPartitionId(const int64_t key) const {
+    return static_cast<size_t>(key) % partition_count_;
+  }
+
+  // No transaction may be running while the mode is changed.
+  inline void SetInPlaceUpdates(const bool in_place_updates) {
+    in_place_updates_ = in_place_updates;
+  }
+
+  inline bool GetInPlaceUpdates() const { return in_place_updates_; }
+
+  // Begin a transaction that only accesses the given partitions. The empty
+  // list stands for all the partitions.
+  Transaction *BeginPartitionTransaction(
+      const size_t thread_id, const std::vector<size_t> &partition_ids);
+
+  virtual bool AcquireOwnership(
+      Transaction *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id);
+
+  virtual bool PerformRead(Transaction *const current_txn,
+                           const ItemPointer &location,
+                           bool acquire_ownership = false);
+
+  virtual bool PerformInPlaceUpdate(Transaction *const current_txn,
+                                    storage::TileGroup *const tile_group,
+                                    const oid_t &tuple_id,
+                                    const std::vector<oid_t> &column_ids);
+
+  virtual ResultType CommitTransaction(Transaction *const current_txn);
+
+  virtual ResultType AbortTransaction(Transaction *const current_txn);
+
+ private:
+  // padded rather than aligned, as operator new[] does not honour an
+  // extended alignment before C++17
+  struct Partition {
+    std::mutex partition_lock;
+    char padding[CACHELINE_SIZE - sizeof(std::mutex) % CACHELINE_SIZE];
+  };
+
+  // Release the partitions held by a transaction that has ended
+  void UnlockPartitions(const std::vector<size_t> &partition_ids);
+
+  std::unique_ptr<Partition[]> partitions_;
+
+  size_t partition_count_;
+
+  bool in_place_updates_;
+};
+}
+}
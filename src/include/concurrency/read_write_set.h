@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// read_write_set.h
+//
+// Identification: src/include/concurrency/read_write_set.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace concurrency {
+
+// a tuple accessed by a transaction and how it was accessed
+struct ReadWriteEntry {
+  ReadWriteEntry(const ItemPointer &location, const RWType type)
+      : location(location), type(type) {}
+
+  ItemPointer location;
+  RWType type;
+};
+
+//===--------------------------------------------------------------------===//
+// Read Write Set
+//===--------------------------------------------------------------------===//
+
+/**
+ * The tuples accessed by a transaction, in the order of their first access.
+ *
+ * The entries are stored in one flat array. Small sets are searched
+ * linearly; larger ones build an open addressing index over the array. The
+ * set lives in a pooled transaction, so Clear() keeps the memory of both
+ * arrays for the next transaction instead of freeing one node per entry.
+ */
+class ReadWriteSet {
+ public:
+  typedef std::vector<ReadWriteEntry>::const_iterator const_iterator;
+
+  ReadWriteSet() {}
+
+  // Type recorded for the location, or nullptr if it is not in the set.
+  // The pointer is valid until the next insertion.
+  RWType *Find(const ItemPointer &location);
+
+  // Add a location that is not in the set yet
+  void Insert(const ItemPointer &location, const RWType type);
+
+  // Drop all the entries, keep the memory for the next transaction
+  void Clear();
+
+  inline size_t size() const { return entries_.size(); }
+
+  inline bool empty() const { return entries_.empty(); }
+
+  inline const_iterator begin() const { return entries_.begin(); }
+
+  inline const_iterator end() const { return entries_.end(); }
+
+ private:
+  static inline size_t Hash(const ItemPointer &location) {
+    uint64_t key = (static_cast<uint64_t>(location.block) << 32) |
+                   location.offset;
+    return (key * 0x9E3779B97F4A7C15UL) >> 32;
+  }
+
+  // rebuild the index over all the entries
+  void BuildIndex(const size_t bucket_count);
+
+  // sets up to this size are searched without an index
+  static const size_t linear_search_limit = 16;
+
+  // larger arrays are released instead of being kept for the next
+  // transaction
+  static const size_t max_retained_entry_count = 4096;
+
+  std::vector<ReadWriteEntry> entries_;
+
+  // position of each entry in entries_ plus one, 0 for an empty bucket.
+  // empty while the set is searched linearly.
+  std::vector<uint32_t> buckets_;
+};
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -72,12 +72,21 @@ class TimestampOrderingTransactionManager : public TransactionManager {
       const storage::TileGroupHeader *const tile_group_header,
       const oid_t &tuple_id);
 
+  // Record a read of the tuple at the commit id in its last reader
+  virtual void RecordRelocatedRead(
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t &tuple_id, const cid_t &commit_id);
+
   // The index_entry_ptr is the address of the head node of the version chain,
   // which is directly pointed by the primary index.
   virtual void PerformInsert(Transaction *const current_txn,
                              const ItemPointer &location,
                              ItemPointer *index_entry_ptr = nullptr);
 
+  virtual void PerformBulkInsert(Transaction *const current_txn,
+                                 const oid_t &tile_group_id,
+                                 const oid_t &tuple_count);
+
   virtual bool PerformRead(Transaction *const current_txn,
                            const ItemPointer &location,
                            bool acquire_ownership = false);
@@ -96,6 +105,9 @@ class TimestampOrderingTransactionManager : public TransactionManager {
   virtual void PerformDelete(Transaction *const current_txn,
                              const ItemPointer &location);
 
+  virtual bool PerformTileGroupDelete(Transaction *const current_txn,
+                                      const oid_t &tile_group_id);
+
   virtual ResultType CommitTransaction(Transaction *const current_txn);
 
   virtual ResultType AbortTransaction(Transaction *const current_txn);
@@ -119,6 +131,12 @@ private:
       const cid_t &current_cid, 
       const bool is_owner);
 
+  // Whether another transaction is deleting the tile group and has not
+  // committed yet. Reads of its tuples conflict with the delete then.
+  bool IsDeletedConcurrently(
+      Transaction *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header);
+
   // Initiate reserved area of a tuple
   void InitTupleReserved(
       const storage::TileGroupHeader *const tile_group_header,
@@ -14,13 +14,18 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "common/exception.h"
 #include "common/item_pointer.h"
+#include "common/platform.h"
 #include "common/printable.h"
+#include "concurrency/read_write_set.h"
+#include "concurrency/undo_buffer.h"
+#include "type/serializeio.h"
 #include "type/types.h"
 
 namespace peloton {
@@ -49,8 +54,8 @@ class Transaction : public Printable {
 
   ~Transaction() {}
 
- private:
-
+  // Init() also reinitializes a transaction taken from the pool of the
+  // transaction manager. the read write set keeps its memory.
   void Init(const size_t thread_id, 
             const IsolationLevelType isolation, 
             const cid_t &read_id) {
@@ -78,8 +83,28 @@ class Transaction : public Printable {
     is_written_ = false;
     
     insert_count_ = 0;
-    
-    gc_set_.reset(new GCSet());
+
+    result_ = ResultType::SUCCESS;
+
+    shared_count_ = 0;
+
+    rw_set_.Clear();
+
+    bulk_insert_set_.clear();
+
+    deleted_tile_group_set_.clear();
+
+    partition_ids_.clear();
+    undo_buffer_.Clear();
+
+    command_log_.Reset();
+    is_command_logged_ = true;
+
+    is_catalog_changed_ = false;
+
+    // the gc set is handed over to the gc manager, so it is only created
+    // when the transaction produces garbage.
+    gc_set_.reset();
   }
 
 
@@ -108,32 +133,56 @@ class Transaction : public Printable {
 
   void RecordInsert(const ItemPointer &);
 
+  // Record the first tuple_count slots of a bulk loaded tile group
+  void RecordBulkInsert(const oid_t tile_group_id, const oid_t tuple_count);
+
+  // Record a tile group whose visible versions are deleted as a whole
+  void RecordTileGroupDelete(const oid_t tile_group_id);
+
   // Return true if we detect INS_DEL
   bool RecordDelete(const ItemPointer &);
 
   RWType GetRWType(const ItemPointer &);
 
   bool IsInRWSet(const ItemPointer &location) {
+    return GetRWType(location) != RWType::INVALID;
+  }
 
-    oid_t tile_group_id = location.block;
-    oid_t tuple_id = location.offset;
+  // The threads of a parallel scan read on behalf of the transaction while
+  // it is shared. They record their reads under a lock until it is unshared.
+  inline void Share() { shared_count_++; }
 
-    if (rw_set_.find(tile_group_id) != rw_set_.end() &&
-        rw_set_.at(tile_group_id).find(tuple_id) !=
-            rw_set_.at(tile_group_id).end()) {
-      return true;
-    } else {
-      return false;
-    }
+  inline void Unshare() {
+    PL_ASSERT(shared_count_ > 0);
+    shared_count_--;
   }
 
   inline const ReadWriteSet &GetReadWriteSet() { return rw_set_; }
 
-  inline std::shared_ptr<GCSet> GetGCSetPtr() {
-    return gc_set_;
+  inline const BulkInsertSet &GetBulkInsertSet() { return bulk_insert_set_; }
+
+  inline const std::vector<oid_t> &GetDeletedTileGroupSet() {
+    return deleted_tile_group_set_;
   }
 
-  inline bool IsGCSetEmpty() { return gc_set_->size() == 0; }
+  // Add a version to be recycled once the transaction is over
+  inline void RecordGarbage(const ItemPointer &location,
+                            const bool is_index_deletion) {
+    if (gc_set_ == nullptr) {
+      gc_set_ = std::make_shared<GCSet>();
+      gc_set_->reserve(rw_set_.size() * 2);
+    }
+    gc_set_->emplace_back(location, is_index_deletion);
+  }
+
+  // Hand the gc set over to the gc manager
+  inline std::shared_ptr<GCSet> ReleaseGCSet() {
+    return std::move(gc_set_);
+  }
+
+  inline bool IsGCSetEmpty() {
+    return gc_set_ == nullptr || gc_set_->empty();
+  }
 
   // Get a string representation for debugging
   const std::string GetInfo() const;
@@ -152,6 +201,42 @@ class Transaction : public Printable {
     return isolation_level_;
   }
 
+  // a declared read-only transaction reads a snapshot and never writes
+  inline bool IsDeclaredReadOnly() const {
+    return isolation_level_ == IsolationLevelType::READ_ONLY;
+  }
+
+  // partitions locked by the transaction under partitioned execution
+  inline std::vector<size_t> &GetPartitionIds() { return partition_ids_; }
+
+  inline bool IsSinglePartition() const { return partition_ids_.size() == 1; }
+
+  // the columns of an owned version that are about to be overwritten in
+  // place
+  void RecordInPlaceUpdate(storage::TileGroup *const tile_group,
+                           const oid_t &tuple_id,
+                           const std::vector<oid_t> &column_ids);
+
+  inline UndoBuffer &GetUndoBuffer() { return undo_buffer_; }
+
+  // statements of the transaction, logged instead of its writes when every
+  // write was made by one of them
+  inline CopySerializeOutput &GetCommandLog() { return command_log_; }
+
+  // the transaction made a write outside of the logged statements
+  inline void DisableCommandLogging() { is_command_logged_ = false; }
+
+  inline bool IsCommandLogged() const {
+    return is_command_logged_ == true && command_log_.Size() > 0;
+  }
+
+  // the transaction created or dropped a database, a table or an index. it
+  // then resolves names through the catalog tables, which it sees the
+  // changes of.
+  inline void RecordCatalogChange() { is_catalog_changed_ = true; }
+
+  inline bool HasChangedCatalog() const { return is_catalog_changed_; }
+
  private:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -177,15 +262,40 @@ class Transaction : public Printable {
 
   ReadWriteSet rw_set_;
 
+  // number of parallel scans reading for the transaction, and the lock of
+  // the read write set while there are any
+  std::atomic<size_t> shared_count_;
+  Spinlock rw_set_lock_;
+
+  // tile groups filled by bulk loads, with their number of tuples.
+  // these are not tracked per tuple in rw_set_.
+  BulkInsertSet bulk_insert_set_;
+
+  // tile groups whose visible versions are deleted as a whole. these are
+  // not tracked per tuple in rw_set_ either.
+  std::vector<oid_t> deleted_tile_group_set_;
+
   // this set contains data location that needs to be gc'd in the transaction.
   std::shared_ptr<GCSet> gc_set_;
 
-  // result of the transaction
-  ResultType result_ = ResultType::SUCCESS;
+  // result of the transaction, which the threads of a parallel scan may set
+  std::atomic<ResultType> result_;
 
   bool is_written_;
   size_t insert_count_;
 
+  // sorted ids of the locked partitions, empty if none
+  std::vector<size_t> partition_ids_;
+
+  // old values of the versions updated in place
+  UndoBuffer undo_buffer_;
+
+  CopySerializeOutput command_log_;
+
+  bool is_command_logged_;
+
+  bool is_catalog_changed_;
+
   IsolationLevelType isolation_level_;
 
 };
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <unordered_map>
 #include <list>
 #include <utility>
@@ -29,6 +30,7 @@ class ItemPointer;
 
 namespace storage {
 class DataTable;
+class TileGroup;
 class TileGroupHeader;
 }
 
@@ -65,6 +67,16 @@ class TransactionManager {
       const oid_t &tuple_id,
       const VisibilityIdType type = VisibilityIdType::READ_ID);
 
+  // Check the visibility of the tuple slots in [tuple_begin, tuple_end) and
+  // store the visible ones in the selection vector, which must have room for
+  // the whole range. Returns the number of visible tuples.
+  oid_t GetVisibleTuples(
+      Transaction *const current_txn,
+      const storage::TileGroupHeader *const tile_group_header,
+      const oid_t tuple_begin, const oid_t tuple_end,
+      oid_t *selection_vector,
+      const VisibilityIdType type = VisibilityIdType::READ_ID);
+
   // This method test whether the current transaction is the owner of this version.
   virtual bool IsOwner(
       Transaction *const current_txn, 
@@ -102,12 +114,26 @@ class TransactionManager {
       const storage::TileGroupHeader *const tile_group_header, 
       const oid_t &tuple_id) = 0;
 
+  // Record a read of the tuple at the commit id. Called on the copy of a
+  // tuple header, whose readers may have been recorded in the original
+  // only. Nothing to do for protocols that do not track readers in headers.
+  virtual void RecordRelocatedRead(
+      UNUSED_ATTRIBUTE const storage::TileGroupHeader *const tile_group_header,
+      UNUSED_ATTRIBUTE const oid_t &tuple_id,
+      UNUSED_ATTRIBUTE const cid_t &commit_id) {}
+
   // The index_entry_ptr is the address of the head node of the version chain, 
   // which is directly pointed by the primary index.
   virtual void PerformInsert(Transaction *const current_txn, 
                              const ItemPointer &location, 
                              ItemPointer *index_entry_ptr = nullptr) = 0;
 
+  // Take ownership of the first tuple_count slots of a bulk loaded tile group.
+  // The slots are committed together when the transaction commits.
+  virtual void PerformBulkInsert(Transaction *const current_txn,
+                                 const oid_t &tile_group_id,
+                                 const oid_t &tuple_count) = 0;
+
   virtual bool PerformRead(Transaction *const current_txn, 
                            const ItemPointer &location,
                            bool acquire_ownership = false) = 0;
@@ -126,6 +152,29 @@ class TransactionManager {
   virtual void PerformDelete(Transaction *const current_txn, 
                              const ItemPointer &location) = 0;
 
+  // Delete every version of the tile group that is visible to the
+  // transaction at once. Returns false if the protocol cannot delete the
+  // tile group as a whole, or if some of its tuples are owned or were
+  // changed since the transaction started, in which case nothing is
+  // recorded and the tuples have to be deleted one by one.
+  virtual bool PerformTileGroupDelete(
+      UNUSED_ATTRIBUTE Transaction *const current_txn,
+      UNUSED_ATTRIBUTE const oid_t &tile_group_id) {
+    return false;
+  }
+
+  // Record that the given columns of an owned version are about to be
+  // overwritten in place by the caller, without installing a new version.
+  // Returns false if the protocol cannot update the version in place, in
+  // which case nothing is recorded.
+  virtual bool PerformInPlaceUpdate(
+      UNUSED_ATTRIBUTE Transaction *const current_txn,
+      UNUSED_ATTRIBUTE storage::TileGroup *const tile_group,
+      UNUSED_ATTRIBUTE const oid_t &tuple_id,
+      UNUSED_ATTRIBUTE const std::vector<oid_t> &column_ids) {
+    return false;
+  }
+
   void SetTransactionResult(Transaction *const current_txn, const ResultType result) {
     current_txn->SetResult(result);
   }
@@ -143,6 +192,24 @@ class TransactionManager {
 
   virtual ResultType AbortTransaction(Transaction *const current_txn) = 0;
 
+  // The first phase of the commit of a distributed transaction: returns
+  // SUCCESS if the transaction can still commit, and the coordinator then
+  // decides whether it commits or aborts. A transaction owns every version it
+  // writes, so only a transaction that failed cannot commit.
+  virtual ResultType PrepareTransaction(Transaction *const current_txn) {
+    return current_txn->GetResult() == ResultType::SUCCESS
+               ? ResultType::SUCCESS
+               : ResultType::ABORTED;
+  }
+
+  // Commit the transaction without waiting for it to become durable. The
+  // callback is invoked with the final result once the epoch of the
+  // transaction has been made durable by the group commit manager, or right
+  // away if the transaction aborted or group commit is off.
+  ResultType GroupCommitTransaction(
+      Transaction *const current_txn,
+      const std::function<void(const ResultType)> &callback);
+
   // this function generates the maximum commit id of committed transactions.
   // please note that this function only returns a "safe" value instead of a
   // precise value.
@@ -150,6 +217,14 @@ class TransactionManager {
     return EpochManagerFactory::GetInstance().GetExpiredCid();
   }
 
+  // Detach the versions older than a committed version that every active
+  // transaction can see. None of them can reach the older versions, which
+  // are already in the GC set of the transactions that replaced them. Called
+  // by readers and writers on the version chains they traverse, so that hot
+  // rows do not wait for the GC to shorten their chains.
+  void PruneVersionChain(storage::TileGroupHeader *const tile_group_header,
+                         const oid_t &tuple_id);
+
   void SetDirtyRange(std::pair<cid_t, cid_t> dirty_range) {
     this->dirty_range_ = dirty_range;
   }
@@ -159,6 +234,9 @@ class TransactionManager {
   }
 
  protected:
+  // number of header entries fetched ahead by GetVisibleTuples
+  static const oid_t visibility_prefetch_distance = 8;
+
   inline bool CidIsInDirtyRange(cid_t cid) {
     return ((cid > dirty_range_.first) & (cid <= dirty_range_.second));
   }
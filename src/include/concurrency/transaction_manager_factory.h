@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include "concurrency/optimistic_transaction_manager.h"
+#include "concurrency/partitioned_transaction_manager.h"
 #include "concurrency/timestamp_ordering_transaction_manager.h"
 
 namespace peloton {
@@ -25,6 +27,12 @@ class TransactionManagerFactory {
       case ProtocolType::TIMESTAMP_ORDERING:
         return TimestampOrderingTransactionManager::GetInstance(protocol_, isolation_level_, conflict_avoidance_);
 
+      case ProtocolType::OPTIMISTIC:
+        return OptimisticTransactionManager::GetInstance(protocol_, isolation_level_, conflict_avoidance_);
+
+      case ProtocolType::PARTITIONED:
+        return PartitionedTransactionManager::GetInstance(protocol_, isolation_level_, conflict_avoidance_);
+
       default:
         return TimestampOrderingTransactionManager::GetInstance(protocol_, isolation_level_, conflict_avoidance_);
     }
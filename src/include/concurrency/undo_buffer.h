@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// undo_buffer.h
+//
+// Identification: src/include/concurrency/undo_buffer.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace storage {
+class TileGroup;
+}
+
+namespace concurrency {
+
+// a version updated in place, and where its old values start in the buffer
+struct UndoRecord {
+  UndoRecord(const ItemPointer &location, const size_t value_offset)
+      : location(location), value_offset(value_offset) {}
+
+  ItemPointer location;
+  size_t value_offset;
+};
+
+//===--------------------------------------------------------------------===//
+// Undo Buffer
+//===--------------------------------------------------------------------===//
+
+/**
+ * The old values of the columns that a transaction overwrote in place.
+ *
+ * Only the updated columns are saved, as deltas of the version. The buffer
+ * lives in a pooled transaction, so Clear() keeps its memory for the next
+ * transaction.
+ */
+class UndoBuffer {
+ public:
+  typedef std::vector<UndoRecord>::const_iterator const_iterator;
+
+  UndoBuffer() {}
+
+  // Save the given columns of a version before they are overwritten
+  void Record(storage::TileGroup *const tile_group, const oid_t &tuple_id,
+              const std::vector<oid_t> &column_ids);
+
+  // Write the saved values back, the most recent first
+  void Undo();
+
+  // Drop all the records, keep the memory for the next transaction
+  void Clear();
+
+  inline bool empty() const { return records_.empty(); }
+
+  inline const_iterator begin() const { return records_.begin(); }
+
+  inline const_iterator end() const { return records_.end(); }
+
+ private:
+  // larger buffers are released instead of being kept for the next
+  // transaction
+  static const size_t max_retained_value_count = 4096;
+
+  std::vector<UndoRecord> records_;
+
+  // the saved columns with their old values, in record order
+  std::vector<std::pair<oid_t, type::Value>> values_;
+};
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -28,6 +28,20 @@ DECLARE_uint64(port);
 // Maximum number of connections
 DECLARE_uint64(max_connections);
 
+// Number of result rows sent to the client at a time while a statement
+// executes, 0 sends them all at the end
+DECLARE_uint64(result_chunk_rows);
+
+// Number of threads that execute the statements of the connections, so that
+// a long statement does not hold up the other connections of its connection
+// thread. 0 executes them on the connection threads.
+DECLARE_uint64(execution_threads);
+
+// Number of traffic cops the connections share. A connection is bound to one
+// for the duration of a transaction, and waits for one if all are bound. 0
+// gives every connection its own.
+DECLARE_uint64(execution_contexts);
+
 // Socket family
 DECLARE_string(socket_family);
 
@@ -43,10 +57,119 @@ DECLARE_string(certificate_file);
 // RESOURCE USAGE
 //===----------------------------------------------------------------------===//
 
+// Enable or disable freezing of cold tile groups
+DECLARE_bool(tile_group_freezer);
+
+// Enable or disable compaction of sparse tile groups
+DECLARE_bool(tile_group_compactor);
+
+// Enable or disable deletion of the tuples whose time to live is over
+DECLARE_bool(tuple_expirer);
+DECLARE_bool(tile_group_provisioner);
+
+// Enable or disable eviction of cold, frozen tile groups to files
+DECLARE_bool(tile_group_evictor);
+
+// Directory the evicted tile groups are written to
+DECLARE_string(tile_group_evictor_dir);
+
+// Memory the tuple slots of the tables may use before cold tile groups are
+// evicted (0 evicts all of them)
+DECLARE_uint64(tile_group_evictor_memory_mb);
+
+// Allocate tile data from huge page backed memory
+DECLARE_bool(huge_page_tiles);
+
+// Number of worker threads the exchanges of the executors run the instances
+// of their scans on (0 uses one per core)
+DECLARE_uint64(exchange_threads);
+
+// Memory the hash joins and hash aggregations of a query may use before they
+// partition their input to temporary files (0 for no limit)
+DECLARE_uint64(query_memory_budget_mb);
+
+// Number of threads a COPY FROM parses the rows of its input on (0 uses one
+// per core)
+DECLARE_uint64(copy_threads);
+
+// Number of threads a merge join merges the key ranges of its input on (0
+// uses one per core)
+DECLARE_uint64(merge_join_threads);
+
+// Number of queries whose literals are replaced by parameters and whose plans
+// are kept for reuse (0 disables the cache)
+DECLARE_uint64(plan_cache_size);
+
+// Number of rows of the results of single statement SELECTs that are kept
+// until a transaction writes to the tables they read (0 disables the cache)
+DECLARE_uint64(result_cache_size);
+
+// Number of tuples ANALYZE samples instead of scanning a larger table (0
+// always scans the whole table)
+DECLARE_uint64(analyze_sample_size);
+
+// A table is analyzed again once the threshold plus the scale factor times
+// its tuples have been inserted, updated or deleted (0 disables it)
+DECLARE_uint64(auto_analyze_threshold);
+DECLARE_double(auto_analyze_scale_factor);
+
+// The optimizer uses the selectivities that scans observed, and drops the
+// cached plans once one is off from the estimate by this factor (0 disables
+// the feedback)
+DECLARE_uint64(cardinality_feedback_error);
+
+// Once the optimizer spent the milliseconds or costed the expressions, each
+// group keeps the best plan found so far instead of costing the rest of its
+// alternatives (0 disables the bound)
+DECLARE_uint64(optimizer_timeout);
+DECLARE_uint64(optimizer_task_budget);
+
+// Background maintenance is held back while the p99 latency of queries is
+// above the SLO (0 for none), and uses at most the percent of a core and the
+// megabytes per second of writes (0 for no limit)
+DECLARE_uint64(maintenance_latency_slo_ms);
+DECLARE_uint64(maintenance_cpu_percent);
+DECLARE_uint64(maintenance_io_mb);
+
 //===----------------------------------------------------------------------===//
 // WRITE AHEAD LOG
 //===----------------------------------------------------------------------===//
 
+// Acknowledge commits once per epoch
+DECLARE_bool(group_commit);
+
+// Log the statements of transactions instead of their writes
+DECLARE_bool(command_logging);
+
+//===----------------------------------------------------------------------===//
+// REPLICATION
+//===----------------------------------------------------------------------===//
+
+// Replicas the log is shipped to, as comma separated host:port addresses
+DECLARE_string(replica_addresses);
+
+// Port of the replication server, zero if none. It receives the log on a
+// replica, and the answers of the replicas on their primary.
+DECLARE_uint64(replication_port);
+
+//===----------------------------------------------------------------------===//
+// SHARDING
+//===----------------------------------------------------------------------===//
+
+// The RPC servers of the nodes the sharded tables are spread over, as comma
+// separated host:port addresses in node order. Every node lists the same.
+DECLARE_string(shard_nodes);
+
+// The id of this node, its position in shard_nodes
+DECLARE_uint64(shard_node_id);
+
+// The sharded tables, as comma separated table:hash:column or
+// table:range:column:bound:... descriptions
+DECLARE_string(shard_tables);
+
+// How long a node waits for the answer of another one
+DECLARE_uint64(shard_timeout_ms);
+
 //===----------------------------------------------------------------------===//
 // ERROR REPORTING AND LOGGING
 //===----------------------------------------------------------------------===//
@@ -64,6 +187,13 @@ DECLARE_bool(display_configuration);
 
 // Enable or disable statistics collection
 DECLARE_uint64(stats_mode);
+DECLARE_uint64(stats_flush_intervals);
+DECLARE_uint64(stats_query_metrics_per_flush);
+DECLARE_uint64(stats_query_metrics_retention);
+DECLARE_uint64(stats_query_sample_interval);
+DECLARE_uint64(stats_slow_query_ms);
+DECLARE_bool(stats_hardware_counters);
+DECLARE_uint64(metrics_port);
 
 //===----------------------------------------------------------------------===//
 // AI
@@ -71,16 +201,52 @@ DECLARE_uint64(stats_mode);
 
 // Enable or disable index tuner
 DECLARE_bool(index_tuner);
+DECLARE_uint64(index_tuner_sample_interval);
+DECLARE_uint64(index_tuner_memory_mb);
 
 // Enable or disable layout tuner
 DECLARE_bool(layout_tuner);
 
+// Enable or disable knob tuner
+DECLARE_bool(knob_tuner);
+DECLARE_uint64(knob_tuner_gc_lag_ms);
+
+// Workload forecast of the tuners
+DECLARE_uint64(workload_forecast_interval_s);
+DECLARE_uint64(workload_forecast_season);
+
 //===----------------------------------------------------------------------===//
 // CODEGEN
 //===----------------------------------------------------------------------===//
 
 DECLARE_bool(codegen);
 
+// Number of compiled queries kept for reuse (0 disables the cache)
+DECLARE_uint64(codegen_query_cache_size);
+
+// Enable or disable compiling new queries in the background
+DECLARE_bool(codegen_background_compile);
+
+// Number of threads a parallel scan in compiled queries runs on (0 uses one
+// per core, 1 disables parallel scans)
+DECLARE_uint64(codegen_parallel_scan_threads);
+
+// Compiled queries that take at least this long to compile and run are logged
+// with their compile statistics (0 disables the log)
+DECLARE_uint64(codegen_slow_query_ms);
+
+// Plans estimated to read fewer tuples than this run on the executors, unless
+// their query is compiled already, as compiling them would take longer than
+// running them (0 compiles every supported plan)
+DECLARE_uint64(codegen_min_rows);
+
+// Write the IR of the plan with this hash when it is compiled (0 for none)
+DECLARE_uint64(codegen_dump_ir_plan);
+
+// Directory the machine code of compiled queries is kept in for the processes
+// started later (empty disables it)
+DECLARE_string(codegen_object_cache_dir);
+
 //===----------------------------------------------------------------------===//
 // GENERAL
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,290 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// lock_free_locator.h
+//
+// Identification: src/include/container/lock_free_locator.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/platform.h"
+
+namespace peloton {
+
+namespace lock_free_locator {
+
+// What a thread looking up a locator announces to the threads replacing
+// entries: the epoch it started its lookup in, or 0 when it is not in one.
+// Slots are handed out to threads on their first lookup and are given back
+// when the thread exits, but they are never freed.
+struct ReaderSlot {
+  std::atomic<uint64_t> epoch = ATOMIC_VAR_INIT(0);
+  std::atomic<bool> in_use = ATOMIC_VAR_INIT(false);
+  ReaderSlot *next = nullptr;
+  char padding[CACHELINE_SIZE - sizeof(std::atomic<uint64_t>) -
+               sizeof(std::atomic<bool>) - sizeof(ReaderSlot *)];
+};
+
+// The slot of the calling thread
+ReaderSlot &GetReaderSlot();
+
+// The epoch lookups starting now announce. Starts at 1.
+uint64_t GetCurrentEpoch();
+
+// Ends the current epoch, returning it
+uint64_t AdvanceEpoch();
+
+// The oldest epoch a lookup is still in, or UINT64_MAX if there is none
+uint64_t GetOldestReaderEpoch();
+
+// Announces the current epoch in the slot of the calling thread while it is
+// in scope. The epoch is announced before the lookup loads a slot, so a
+// thread retiring the holder after that either sees the announcement or had
+// already swapped the holder out of the slot.
+class ReadGuard {
+ public:
+  ReadGuard() : slot_(GetReaderSlot()) {
+    slot_.epoch.store(GetCurrentEpoch());
+  }
+
+  ~ReadGuard() { slot_.epoch.store(0, std::memory_order_release); }
+
+ private:
+  ReaderSlot &slot_;
+};
+
+// Objects swapped out of where lookups find them. Each is deleted once no
+// lookup that could have loaded it is still running.
+template <typename T>
+class RetiredList {
+ public:
+  RetiredList() {}
+
+  // Only destroyed when no lookup is running
+  ~RetiredList() {
+    for (auto &retired : retired_) {
+      delete retired.second;
+    }
+  }
+
+  RetiredList(const RetiredList &) = delete;
+  RetiredList &operator=(const RetiredList &) = delete;
+
+  // Takes over the object, which lookups starting now can no longer load
+  void Retire(T *object) {
+    if (object == nullptr) {
+      return;
+    }
+
+    // Deleting the objects might drop the last reference to others, which is
+    // not done while holding the lock
+    std::vector<T *> reclaimed;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      retired_.emplace_back(AdvanceEpoch(), object);
+
+      // A lookup that loaded an object announced an epoch before it was
+      // retired
+      uint64_t oldest_epoch = GetOldestReaderEpoch();
+      while (retired_.empty() == false &&
+             retired_.front().first < oldest_epoch) {
+        reclaimed.push_back(retired_.front().second);
+        retired_.pop_front();
+      }
+    }
+    for (auto reclaimed_object : reclaimed) {
+      delete reclaimed_object;
+    }
+  }
+
+  // The number of objects retired but not deleted yet
+  size_t GetSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return retired_.size();
+  }
+
+ private:
+  // With the epoch they were retired in
+  mutable std::mutex mutex_;
+  std::deque<std::pair<uint64_t, T *>> retired_;
+};
+
+}  // namespace lock_free_locator
+
+//===--------------------------------------------------------------------===//
+// Lock Free Locator -- Maps dense oids to the objects shared under them.
+//
+// The entries are kept in segments of a fixed size, found through a
+// directory indexed by the high bits of the oid. Segments are added as oids
+// grow, without moving the entries already there, so the locator does not
+// have to be sized up front and never stops lookups to grow.
+//
+// Lookups take no lock and write no shared cache line. Every slot points to
+// an immutable holder of the shared pointer, which lookups copy. Replacing
+// or erasing an entry swaps the holder and retires the old one, which is
+// deleted once no lookup that could have loaded it is still running (epoch
+// based reclamation). Without concurrent lookups that is right away, else on
+// a later update.
+//===--------------------------------------------------------------------===//
+
+template <typename ValueType>
+class LockFreeLocator {
+ public:
+  typedef std::shared_ptr<ValueType> ValuePtr;
+
+  LockFreeLocator()
+      : directory_(new std::atomic<Segment *>[DIRECTORY_SIZE]) {
+    for (size_t segment_idx = 0; segment_idx < DIRECTORY_SIZE; segment_idx++) {
+      directory_[segment_idx].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~LockFreeLocator() {
+    Clear();
+    for (size_t segment_idx = 0; segment_idx < DIRECTORY_SIZE; segment_idx++) {
+      delete directory_[segment_idx].load(std::memory_order_relaxed);
+    }
+  }
+
+  LockFreeLocator(const LockFreeLocator &) = delete;
+  LockFreeLocator &operator=(const LockFreeLocator &) = delete;
+
+  // Sets the entry of the offset, returning the one it replaced
+  ValuePtr Update(const std::size_t &offset, ValuePtr value) {
+    PL_ASSERT(offset < MAX_SIZE);
+    Segment &segment = GetOrAddSegment(offset >> SEGMENT_BITS);
+    Holder *holder = nullptr;
+    if (value != nullptr) {
+      holder = new Holder{std::move(value)};
+    }
+    return Retire(segment.slots[offset & SEGMENT_MASK].exchange(holder));
+  }
+
+  // Drops the entry of the offset, returning it
+  ValuePtr Erase(const std::size_t &offset) {
+    PL_ASSERT(offset < MAX_SIZE);
+    Segment *segment = directory_[offset >> SEGMENT_BITS].load();
+    if (segment == nullptr) {
+      return nullptr;
+    }
+    return Retire(segment->slots[offset & SEGMENT_MASK].exchange(nullptr));
+  }
+
+  // The entry of the offset, or null
+  ValuePtr Find(const std::size_t &offset) const {
+    PL_ASSERT(offset < MAX_SIZE);
+    lock_free_locator::ReadGuard guard;
+    Holder *holder = LoadHolder(offset);
+    if (holder == nullptr) {
+      return nullptr;
+    }
+    return holder->value;
+  }
+
+  // The object of the offset, or null, without taking a reference on it. The
+  // caller has to keep the object alive some other way while using it.
+  ValueType *FindPointer(const std::size_t &offset) const {
+    PL_ASSERT(offset < MAX_SIZE);
+    lock_free_locator::ReadGuard guard;
+    Holder *holder = LoadHolder(offset);
+    if (holder == nullptr) {
+      return nullptr;
+    }
+    return holder->value.get();
+  }
+
+  // Drops all entries. The segments are kept.
+  void Clear() {
+    for (size_t segment_idx = 0; segment_idx < DIRECTORY_SIZE; segment_idx++) {
+      Segment *segment = directory_[segment_idx].load();
+      if (segment == nullptr) {
+        continue;
+      }
+      for (size_t slot_idx = 0; slot_idx < SEGMENT_SIZE; slot_idx++) {
+        if (segment->slots[slot_idx].load(std::memory_order_relaxed) !=
+            nullptr) {
+          Retire(segment->slots[slot_idx].exchange(nullptr));
+        }
+      }
+    }
+  }
+
+  // The number of holders retired but not deleted yet
+  size_t GetRetiredCount() const { return retired_.GetSize(); }
+
+ private:
+  static constexpr size_t SEGMENT_BITS = 16;
+  static constexpr size_t SEGMENT_SIZE = 1UL << SEGMENT_BITS;
+  static constexpr size_t SEGMENT_MASK = SEGMENT_SIZE - 1;
+  static constexpr size_t DIRECTORY_SIZE = 1UL << 16;
+  static constexpr size_t MAX_SIZE = SEGMENT_SIZE * DIRECTORY_SIZE;
+
+  struct Holder {
+    const ValuePtr value;
+  };
+
+  struct Segment {
+    Segment() {
+      for (size_t slot_idx = 0; slot_idx < SEGMENT_SIZE; slot_idx++) {
+        slots[slot_idx].store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    std::atomic<Holder *> slots[SEGMENT_SIZE];
+  };
+
+  // Only called while the calling thread announces its epoch
+  Holder *LoadHolder(const std::size_t &offset) const {
+    Segment *segment = directory_[offset >> SEGMENT_BITS].load(
+        std::memory_order_acquire);
+    if (segment == nullptr) {
+      return nullptr;
+    }
+    return segment->slots[offset & SEGMENT_MASK].load();
+  }
+
+  Segment &GetOrAddSegment(const size_t &segment_idx) {
+    Segment *segment = directory_[segment_idx].load(std::memory_order_acquire);
+    if (segment != nullptr) {
+      return *segment;
+    }
+    std::unique_ptr<Segment> new_segment(new Segment());
+    if (directory_[segment_idx].compare_exchange_strong(segment,
+                                                        new_segment.get())) {
+      return *new_segment.release();
+    }
+    // Another thread added it first
+    return *segment;
+  }
+
+  // Returns the entry of the holder
+  ValuePtr Retire(Holder *holder) {
+    if (holder == nullptr) {
+      return nullptr;
+    }
+    ValuePtr value = holder->value;
+    retired_.Retire(holder);
+    return value;
+  }
+
+  std::unique_ptr<std::atomic<Segment *>[]> directory_;
+
+  // Holders swapped out of their slot
+  lock_free_locator::RetiredList<Holder> retired_;
+};
+
+}  // namespace peloton
@@ -0,0 +1,297 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// ring_queue.h
+//
+// Identification: src/include/container/ring_queue.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "common/macros.h"
+#include "common/platform.h"
+
+namespace peloton {
+
+namespace ring_queue {
+
+// The smallest power of two that is at least the capacity, and at least 2
+inline size_t RoundUpCapacity(const size_t &capacity) {
+  size_t rounded = 2;
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
+}  // namespace ring_queue
+
+//===--------------------------------------------------------------------===//
+// MPMC Ring Queue -- A bounded queue for multiple producers and consumers.
+//
+// Every slot of the ring has a sequence number telling whether it is free or
+// holds an item for the current lap, so producers and consumers only contend
+// on the position they advance (D. Vyukov's bounded MPMC queue). The two
+// positions are on cache lines of their own. Enqueueing fails when the queue
+// is full instead of allocating.
+//===--------------------------------------------------------------------===//
+
+template <typename T>
+class MPMCRingQueue {
+ public:
+  explicit MPMCRingQueue(const size_t &capacity)
+      : mask_(ring_queue::RoundUpCapacity(capacity) - 1),
+        cells_(new Cell[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPMCRingQueue(const MPMCRingQueue &) = delete;
+  MPMCRingQueue &operator=(const MPMCRingQueue &) = delete;
+
+  // Enqueues one item, returning false if the queue is full. The item is
+  // only moved from once it is enqueued.
+  bool Enqueue(const T &item) {
+    T copy(item);
+    return Enqueue(std::move(copy));
+  }
+
+  bool Enqueue(T &&item) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = cells_[position & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+      if (difference == 0) {
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          cell.item = std::move(item);
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Dequeues one item, returning false if the queue appeared empty
+  bool Dequeue(T &item) {
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = cells_[position & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+      if (difference == 0) {
+        if (dequeue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          item = std::move(cell.item);
+          cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Enqueues up to count items, moved out of items in order, claiming their
+  // slots at once. Returns the number enqueued, fewer if the queue is full.
+  size_t EnqueueBatch(T *items, const size_t &count) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      size_t free_count = 0;
+      while (free_count < count && free_count <= mask_ &&
+             cells_[(position + free_count) & mask_].sequence.load(
+                 std::memory_order_acquire) == position + free_count) {
+        free_count++;
+      }
+      if (free_count == 0) {
+        // Full, unless another producer has moved on from this position
+        size_t current = enqueue_position_.load(std::memory_order_relaxed);
+        if (current == position) {
+          return 0;
+        }
+        position = current;
+        continue;
+      }
+      if (enqueue_position_.compare_exchange_weak(
+              position, position + free_count, std::memory_order_relaxed)) {
+        for (size_t i = 0; i < free_count; i++) {
+          Cell &cell = cells_[(position + i) & mask_];
+          cell.item = std::move(items[i]);
+          cell.sequence.store(position + i + 1, std::memory_order_release);
+        }
+        return free_count;
+      }
+    }
+  }
+
+  // Dequeues up to max_count items into items, claiming their slots at once.
+  // Returns the number dequeued.
+  size_t DequeueBatch(T *items, const size_t &max_count) {
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      size_t ready_count = 0;
+      while (ready_count < max_count && ready_count <= mask_ &&
+             cells_[(position + ready_count) & mask_].sequence.load(
+                 std::memory_order_acquire) == position + ready_count + 1) {
+        ready_count++;
+      }
+      if (ready_count == 0) {
+        size_t current = dequeue_position_.load(std::memory_order_relaxed);
+        if (current == position) {
+          return 0;
+        }
+        position = current;
+        continue;
+      }
+      if (dequeue_position_.compare_exchange_weak(
+              position, position + ready_count, std::memory_order_relaxed)) {
+        for (size_t i = 0; i < ready_count; i++) {
+          Cell &cell = cells_[(position + i) & mask_];
+          items[i] = std::move(cell.item);
+          cell.sequence.store(position + i + mask_ + 1,
+                              std::memory_order_release);
+        }
+        return ready_count;
+      }
+    }
+  }
+
+  bool IsEmpty() const {
+    return enqueue_position_.load(std::memory_order_acquire) ==
+           dequeue_position_.load(std::memory_order_acquire);
+  }
+
+  // The number of items enqueued and not yet dequeued. Only a hint while
+  // other threads use the queue.
+  size_t GetApproximateSize() const {
+    size_t dequeue_position = dequeue_position_.load(std::memory_order_relaxed);
+    size_t enqueue_position = enqueue_position_.load(std::memory_order_relaxed);
+    if (enqueue_position < dequeue_position) {
+      return 0;
+    }
+    return enqueue_position - dequeue_position;
+  }
+
+  size_t GetCapacity() const { return mask_ + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T item;
+  };
+
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+
+  char padding0_[CACHELINE_SIZE];
+  std::atomic<size_t> enqueue_position_ = ATOMIC_VAR_INIT(0);
+  char padding1_[CACHELINE_SIZE - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> dequeue_position_ = ATOMIC_VAR_INIT(0);
+  char padding2_[CACHELINE_SIZE - sizeof(std::atomic<size_t>)];
+};
+
+//===--------------------------------------------------------------------===//
+// SPSC Ring Queue -- A bounded queue for one producer and one consumer.
+//
+// The producer only writes the tail and the consumer only the head, each on
+// a cache line of its own. Both keep a copy of the other position and only
+// read the shared one again when the copy says the queue is full (or empty).
+//===--------------------------------------------------------------------===//
+
+template <typename T>
+class SPSCRingQueue {
+ public:
+  explicit SPSCRingQueue(const size_t &capacity)
+      : mask_(ring_queue::RoundUpCapacity(capacity) - 1),
+        items_(new T[mask_ + 1]) {}
+
+  SPSCRingQueue(const SPSCRingQueue &) = delete;
+  SPSCRingQueue &operator=(const SPSCRingQueue &) = delete;
+
+  // Enqueues one item, returning false if the queue is full. The item is
+  // only moved from once it is enqueued. Only called by the producer.
+  bool Enqueue(const T &item) {
+    T copy(item);
+    return Enqueue(std::move(copy));
+  }
+
+  bool Enqueue(T &&item) { return EnqueueBatch(&item, 1) == 1; }
+
+  // Dequeues one item, returning false if the queue is empty. Only called by
+  // the consumer.
+  bool Dequeue(T &item) { return DequeueBatch(&item, 1) == 1; }
+
+  // Enqueues up to count items, moved out of items in order. Returns the
+  // number enqueued, fewer if the queue is full.
+  size_t EnqueueBatch(T *items, const size_t &count) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail + count - cached_head_ > mask_ + 1) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    size_t free_count = mask_ + 1 - (tail - cached_head_);
+    size_t enqueue_count = count < free_count ? count : free_count;
+    for (size_t i = 0; i < enqueue_count; i++) {
+      items_[(tail + i) & mask_] = std::move(items[i]);
+    }
+    tail_.store(tail + enqueue_count, std::memory_order_release);
+    return enqueue_count;
+  }
+
+  // Dequeues up to max_count items into items. Returns the number dequeued.
+  size_t DequeueBatch(T *items, const size_t &max_count) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (cached_tail_ - head < max_count) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    size_t ready_count = cached_tail_ - head;
+    size_t dequeue_count = max_count < ready_count ? max_count : ready_count;
+    for (size_t i = 0; i < dequeue_count; i++) {
+      items[i] = std::move(items_[(head + i) & mask_]);
+    }
+    head_.store(head + dequeue_count, std::memory_order_release);
+    return dequeue_count;
+  }
+
+  bool IsEmpty() const {
+    return tail_.load(std::memory_order_acquire) ==
+           head_.load(std::memory_order_acquire);
+  }
+
+  size_t GetCapacity() const { return mask_ + 1; }
+
+ private:
+  const size_t mask_;
+  std::unique_ptr<T[]> items_;
+
+  // Written by the consumer
+  char padding0_[CACHELINE_SIZE];
+  std::atomic<size_t> head_ = ATOMIC_VAR_INIT(0);
+  size_t cached_tail_ = 0;
+  char padding1_[CACHELINE_SIZE - sizeof(std::atomic<size_t>) -
+                 sizeof(size_t)];
+
+  // Written by the producer
+  std::atomic<size_t> tail_ = ATOMIC_VAR_INIT(0);
+  size_t cached_head_ = 0;
+  char padding2_[CACHELINE_SIZE - sizeof(std::atomic<size_t>) -
+                 sizeof(size_t)];
+};
+
+}  // namespace peloton
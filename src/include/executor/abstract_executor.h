@@ -16,6 +16,8 @@
 #include <vector>
 
 #include "common/item_pointer.h"
+#include "common/timer.h"
+#include "executor/executor_profile.h"
 #include "executor/logical_tile.h"
 #include "type/types.h"
 
@@ -80,6 +82,9 @@ class AbstractExecutor {
   // Used to reset the state. For now it's overloaded by index scan executor
   virtual void ResetState() {}
 
+  // What this executor and its children did while the query was profiled
+  ExecutorProfile GetProfile() const;
+
  protected:
   // NOTE: The reason why we keep the plan node separate from the executor
   // context is because we might want to reuse the plan multiple times
@@ -112,10 +117,19 @@ class AbstractExecutor {
   std::vector<AbstractExecutor *> children_;
 
  private:
+  // Execute() while the query is profiled
+  bool ProfiledExecute();
+
   // Output logical tile
   // This is where we will write the results of the plan node's execution
   std::unique_ptr<LogicalTile> output;
 
+  // Time spent in Execute() while the query is profiled, and the tuples and
+  // memory it took meanwhile
+  Timer<std::ratio<1, 1000>> profile_timer_;
+  uint64_t profile_tuple_count_ = 0;
+  uint64_t profile_memory_bytes_ = 0;
+
   /** @brief Plan node corresponding to this executor. */
   const planner::AbstractPlan *node_ = nullptr;
 
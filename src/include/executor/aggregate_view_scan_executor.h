@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregate_view_scan_executor.h
+//
+// Identification: src/include/executor/aggregate_view_scan_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "executor/abstract_executor.h"
+
+namespace peloton {
+
+namespace storage {
+class AbstractTable;
+}
+
+namespace executor {
+
+/**
+ * Produces the groups of a materialized aggregate view as the transaction
+ * sees them. If the view can not answer for the transaction, the output of
+ * the child, the plan of the query itself, is passed on instead.
+ */
+class AggregateViewScanExecutor : public AbstractExecutor {
+ public:
+  AggregateViewScanExecutor(const AggregateViewScanExecutor &) = delete;
+  AggregateViewScanExecutor &operator=(const AggregateViewScanExecutor &) =
+      delete;
+  AggregateViewScanExecutor(AggregateViewScanExecutor &&) = delete;
+  AggregateViewScanExecutor &operator=(AggregateViewScanExecutor &&) = delete;
+
+  AggregateViewScanExecutor(const planner::AbstractPlan *node,
+                            ExecutorContext *executor_context);
+
+  ~AggregateViewScanExecutor();
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  // Fill the output table from the view. Returns false if the view can not
+  // answer.
+  bool ScanView();
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  /** @brief Result of the view */
+  std::vector<LogicalTile *> result;
+
+  /** @brief Result itr */
+  oid_t result_itr = INVALID_OID;
+
+  /** @brief Asked the view */
+  bool done = false;
+
+  /** @brief The view answered, otherwise the child does */
+  bool is_view_used = false;
+
+  /** @brief Output table. */
+  storage::AbstractTable *output_table = nullptr;
+};
+
+}  // namespace executor
+}  // namespace peloton
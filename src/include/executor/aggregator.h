@@ -17,7 +17,11 @@
 
 #include "common/container_tuple.h"
 #include "executor/abstract_executor.h"
+#include "executor/spill_file.h"
+#include "optimizer/stats/hyperloglog.h"
 #include "planner/aggregate_plan.h"
+#include "storage/column_kernels.h"
+#include "type/arena_pool.h"
 #include "type/value_factory.h"
 
 //===--------------------------------------------------------------------===//
@@ -48,6 +52,14 @@ class AbstractAttributeAggregator {
   virtual void DAdvance(const type::Value &val) = 0;
   virtual type::Value DFinalize() = 0;
 
+  // Fold in the aggregate of a column over a batch of tuples, as computed by
+  // the ColumnKernels. Only COUNT(*), COUNT, SUM, MIN and MAX that are not
+  // distinct support it.
+  virtual void DAdvanceColumn(
+      const storage::ColumnAggregate &column_aggregate UNUSED_ATTRIBUTE) {
+    PL_ASSERT(false);
+  }
+
  private:
   typedef std::unordered_set<type::Value, type::Value::hash,
                              type::Value::equal_to>
@@ -76,6 +88,12 @@ class SumAggregator : public AbstractAttributeAggregator {
     }
   }
 
+  void DAdvanceColumn(const storage::ColumnAggregate &column_aggregate) {
+    if (column_aggregate.count > 0) {
+      DAdvance(column_aggregate.sum);
+    }
+  }
+
   type::Value DFinalize() {
     if (!have_advanced)
       return type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER);
@@ -154,6 +172,10 @@ class CountAggregator : public AbstractAttributeAggregator {
     count++;
   }
 
+  void DAdvanceColumn(const storage::ColumnAggregate &column_aggregate) {
+    count += column_aggregate.count;
+  }
+
   type::Value DFinalize() { return type::ValueFactory::GetBigIntValue(count); }
 
  private:
@@ -166,6 +188,10 @@ class CountStarAggregator : public AbstractAttributeAggregator {
 
   void DAdvance(const type::Value &val UNUSED_ATTRIBUTE) { ++count; }
 
+  void DAdvanceColumn(const storage::ColumnAggregate &column_aggregate) {
+    count += column_aggregate.row_count;
+  }
+
   type::Value DFinalize() { return type::ValueFactory::GetBigIntValue(count); }
 
  private:
@@ -190,6 +216,12 @@ class MaxAggregator : public AbstractAttributeAggregator {
     }
   }
 
+  void DAdvanceColumn(const storage::ColumnAggregate &column_aggregate) {
+    if (column_aggregate.count > 0) {
+      DAdvance(column_aggregate.max);
+    }
+  }
+
   type::Value DFinalize() { return aggregate; }
 
  private:
@@ -217,6 +249,12 @@ class MinAggregator : public AbstractAttributeAggregator {
     }
   }
 
+  void DAdvanceColumn(const storage::ColumnAggregate &column_aggregate) {
+    if (column_aggregate.count > 0) {
+      DAdvance(column_aggregate.min);
+    }
+  }
+
   type::Value DFinalize() { return aggregate; }
 
  private:
@@ -225,6 +263,36 @@ class MinAggregator : public AbstractAttributeAggregator {
   bool have_advanced;
 };
 
+// Estimates the number of distinct values with a HyperLogLog sketch, so the
+// state stays a few kilobytes however many values there are. The sketches of
+// partial aggregates merge into the sketch of their union.
+class ApproxCountDistinctAggregator : public AbstractAttributeAggregator {
+ public:
+  ApproxCountDistinctAggregator() : sketch(PRECISION) {}
+
+  void DAdvance(const type::Value &val) {
+    if (val.IsNull()) {
+      return;
+    }
+    sketch.Update(val);
+  }
+
+  void Merge(const ApproxCountDistinctAggregator &other) {
+    sketch.Merge(other.sketch);
+  }
+
+  type::Value DFinalize() {
+    return type::ValueFactory::GetBigIntValue(
+        static_cast<int64_t>(sketch.EstimateCardinality()));
+  }
+
+ private:
+  // 4096 registers, about 1.6% standard error
+  static constexpr int PRECISION = 12;
+
+  optimizer::HyperLogLog sketch;
+};
+
 /** brief Create an instance of an aggregator for the specified aggregate */
 AbstractAttributeAggregator *GetAttributeAggregatorInstance(
     ExpressionType agg_type);
@@ -244,6 +312,9 @@ class AbstractAggregator {
 
   virtual bool Advance(AbstractTuple *next_tuple) = 0;
 
+  // Advance every tuple of the tile
+  virtual bool AdvanceTile(LogicalTile *tile);
+
   virtual bool Finalize() = 0;
 
   virtual ~AbstractAggregator() {}
@@ -262,12 +333,20 @@ class AbstractAggregator {
 /**
  * @brief Used when input is NOT sorted.
  * Will maintain an internal hash table.
+ *
+ * The groups in the hash table count against the memory budget of the query.
+ * Once a new group exceeds it, the tuples of all groups that are not in the
+ * hash table yet are spilled to partitions on disk by the hash of their
+ * group-by keys. The groups in memory are output first, then every partition
+ * is aggregated on its own, spilling to the partitions of the next level
+ * again if it exceeds the budget too.
  */
 class HashAggregator : public AbstractAggregator {
  public:
   HashAggregator(const planner::AggregatePlan *node,
                  storage::AbstractTable *output_table,
-                 executor::ExecutorContext *econtext, size_t num_input_columns);
+                 executor::ExecutorContext *econtext, size_t num_input_columns,
+                 size_t partition_level = 0);
 
   bool Advance(AbstractTuple *next_tuple) override;
 
@@ -275,9 +354,37 @@ class HashAggregator : public AbstractAggregator {
 
   ~HashAggregator();
 
+  /** @brief Have tuples been spilled to partitions on disk? */
+  bool IsSpilled() const { return !partitions_.empty(); }
+
  private:
+  // Start a new group for the tuple if it fits into the memory budget
+  bool ReserveGroup(const AbstractTuple *cur_tuple);
+
+  // Write the tuple to the partition of its group-by keys
+  void SpillTuple(const AbstractTuple *cur_tuple);
+
+  // Aggregate the tuples of every partition and output their groups
+  bool FinalizePartitions();
+
+  // Delete the groups in the hash table and release their memory
+  void ClearGroups();
+
   const size_t num_input_columns;
 
+  /** @brief Level of the partition this aggregator aggregates, 0 for the
+   * input of the query */
+  const size_t partition_level_;
+
+  /** @brief Memory reserved for the groups in the hash table */
+  size_t reserved_memory_ = 0;
+
+  /** @brief Did the groups exceed the budget at the deepest level? */
+  bool over_budget_ = false;
+
+  /** @brief Partitions of the spilled tuples, empty until the first one */
+  std::vector<std::unique_ptr<SpillFile>> partitions_;
+
   /** List of aggregates for a specific group. */
   struct AggregateList {
     // Keep a deep copy of the first tuple we met of this group
@@ -312,13 +419,20 @@ class HashAggregator : public AbstractAggregator {
   };
 
   // Default equal_to should works well
-  typedef std::unordered_map<std::vector<type::Value>, AggregateList *,
-                             ValueVectorHasher, ValueVectorCmp>
+  typedef std::unordered_map<
+      std::vector<type::Value>, AggregateList *, ValueVectorHasher,
+      ValueVectorCmp,
+      type::ArenaAllocator<
+          std::pair<const std::vector<type::Value>, AggregateList *>>>
       HashAggregateMapType;
 
   /** @brief Group by key values used */
   std::vector<type::Value> group_by_key_values;
 
+  /** @brief Arena of the hash table and the aggregate lists, released at
+   * once with the groups */
+  std::unique_ptr<type::ArenaPool> group_pool_;
+
   /** @brief Hash table */
   HashAggregateMapType aggregates_map;
 };
@@ -358,11 +472,20 @@ class PlainAggregator : public AbstractAggregator {
 
   bool Advance(AbstractTuple *next_tuple) override;
 
+  // Aggregate the columns of the base tiles with the ColumnKernels if all
+  // aggregates support it, or one tuple at a time
+  bool AdvanceTile(LogicalTile *tile) override;
+
   bool Finalize() override;
 
   ~PlainAggregator();
 
  private:
+  // The column of the tile that every aggregate aggregates, INVALID_OID for
+  // COUNT(*). Returns false if any of them is not for the ColumnKernels.
+  bool GetKernelColumns(LogicalTile *tile,
+                        std::vector<oid_t> &column_ids) const;
+
   AbstractAttributeAggregator **aggregates;
 };
 }
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_from_executor.h
+//
+// Identification: src/include/executor/copy_from_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <memory>
+
+#include "executor/abstract_executor.h"
+
+namespace peloton {
+namespace executor {
+
+class CopyFromLoader;
+
+//===----------------------------------------------------------------------===//
+// Loads the rows of a delimited text file into a table. The file is read in
+// blocks that are handed to a CopyFromLoader, which parses them on several
+// threads and bulk loads them in the order of the file.
+//===----------------------------------------------------------------------===//
+class CopyFromExecutor : public AbstractExecutor {
+ public:
+  CopyFromExecutor(const CopyFromExecutor &) = delete;
+  CopyFromExecutor &operator=(const CopyFromExecutor &) = delete;
+  CopyFromExecutor(CopyFromExecutor &&) = delete;
+  CopyFromExecutor &operator=(CopyFromExecutor &&) = delete;
+
+  CopyFromExecutor(const planner::AbstractPlan *node,
+                   ExecutorContext *executor_context);
+
+  ~CopyFromExecutor();
+
+  // The number of rows loaded
+  size_t GetRowCount() const { return row_count_; }
+
+ protected:
+  bool DInit() override;
+
+  bool DExecute() override;
+
+ private:
+  FILE *file_ = nullptr;
+
+  size_t row_count_ = 0;
+
+  bool done_ = false;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_from_loader.h
+//
+// Identification: src/include/executor/copy_from_loader.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class DataTable;
+}
+
+namespace executor {
+
+class ParserThreads;
+
+//===----------------------------------------------------------------------===//
+// Loads delimited text that is handed over in pieces, the blocks of a file or
+// the CopyData of a COPY FROM STDIN, into a table within a transaction. The
+// text is cut into chunks of whole lines, the chunks are parsed into tuples
+// on the copy threads while more text comes in, and the tuples of every
+// chunk are bulk loaded into fresh tile groups of the table, with their index
+// entries inserted in key order, in the order of the chunks.
+//
+// Fields are separated by the delimiter and rows by new lines. A backslash
+// escapes the next character, and an empty field is NULL.
+//===----------------------------------------------------------------------===//
+class CopyFromLoader {
+ public:
+  CopyFromLoader(const CopyFromLoader &) = delete;
+  CopyFromLoader &operator=(const CopyFromLoader &) = delete;
+  CopyFromLoader(CopyFromLoader &&) = delete;
+  CopyFromLoader &operator=(CopyFromLoader &&) = delete;
+
+  // Parses on copy_threads threads, 0 for one per core
+  CopyFromLoader(storage::DataTable *table, char delimiter,
+                 concurrency::Transaction *txn);
+
+  ~CopyFromLoader();
+
+  // Add the next piece of the text and load the chunks parsed so far.
+  // Returns false if a constraint was violated, which fails the transaction,
+  // and throws an ExecutorException for a malformed line.
+  bool Append(const char *data, size_t len);
+
+  // Load the rest of the text, the last line need not end with a new line
+  bool Finish();
+
+  // The number of rows loaded
+  size_t GetRowCount() const { return row_count_; }
+
+  // The number of bytes of text a chunk is cut from
+  static constexpr size_t kChunkSize = 1 << 20;
+
+  struct Chunk;
+
+ private:
+  // Cut the whole lines of the text so far into a chunk and queue it, or
+  // all of the text for the last one. Returns false if there is no line.
+  bool CutChunk(bool last);
+
+  // Parse the lines of the chunk into tuples
+  void ParseChunk(Chunk &chunk) const;
+
+  // Bulk load the tuples of a parsed chunk
+  bool LoadChunk(Chunk &chunk);
+
+  // Load the queued chunks until at most max_chunks are left
+  bool LoadChunks(size_t max_chunks);
+
+  storage::DataTable *table_;
+
+  char delimiter_;
+
+  concurrency::Transaction *txn_;
+
+  // The text not cut into a chunk yet
+  std::string text_;
+
+  // The line number of the first line of the next chunk
+  size_t next_line_ = 1;
+
+  size_t row_count_ = 0;
+
+  // The chunks queued to be parsed and loaded, at most max_chunks_
+  std::deque<std::unique_ptr<Chunk>> chunks_;
+  size_t max_chunks_ = 1;
+
+  // Parse the chunks, none to parse them on the calling thread. Declared
+  // after the chunks, so that they are stopped before the chunks are freed.
+  std::unique_ptr<ParserThreads> threads_;
+};
+
+}  // namespace executor
+}  // namespace peloton
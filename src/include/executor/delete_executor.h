@@ -43,7 +43,13 @@ class DeleteExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  // Delete the tile groups whose tuples all satisfy the predicate of the
+  // scan below as a whole. The scan does not see their tuples then.
+  void DeleteTileGroups();
+
   storage::DataTable *target_table_ = nullptr;
+
+  bool tile_groups_deleted_ = false;
 };
 
 }  // namespace executor
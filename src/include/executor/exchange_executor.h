@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// exchange_executor.h
+//
+// Identification: src/include/executor/exchange_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "executor/abstract_executor.h"
+
+namespace peloton {
+namespace executor {
+
+class SeqScanExecutor;
+
+/**
+ * @brief Exchange executor.
+ * Splits the tile groups of the table its child scans into ranges, and runs
+ * one instance of the scan on each. Worker threads and the calling thread
+ * take instances until none are left. The tiles of the workers are gathered
+ * in a bounded queue, so the calling thread returns tiles of both in no
+ * particular order.
+ *
+ * The transaction is shared with the workers while they run, so that they
+ * record the tuples they read under the lock of its read write set.
+ */
+class ExchangeExecutor : public AbstractExecutor {
+ public:
+  ExchangeExecutor(const ExchangeExecutor &) = delete;
+  ExchangeExecutor &operator=(const ExchangeExecutor &) = delete;
+  ExchangeExecutor(ExchangeExecutor &&) = delete;
+  ExchangeExecutor &operator=(ExchangeExecutor &&) = delete;
+
+  explicit ExchangeExecutor(const planner::AbstractPlan *node,
+                            ExecutorContext *executor_context);
+
+  // Stops the instances still running on worker threads
+  ~ExchangeExecutor();
+
+  // The maximum number of tiles the workers queue up
+  static constexpr size_t kMaxQueuedTiles = 64;
+
+ protected:
+  bool DInit() override;
+
+  bool DExecute() override;
+
+ private:
+  // The state shared with the worker threads
+  struct SharedState;
+
+  // Set up the instances of the scan and start the workers
+  bool InitInstances();
+
+  // Stop the workers and wait for the ones still scanning
+  void StopWorkers();
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  /** @brief The instances of the scan, the first one is the child. */
+  std::vector<AbstractExecutor *> instances_;
+
+  /** @brief The instances created by the exchange. */
+  std::vector<std::unique_ptr<SeqScanExecutor>> owned_instances_;
+
+  /** @brief The instance the calling thread is scanning, if any. */
+  AbstractExecutor *local_instance_ = nullptr;
+
+  /** @brief Does the child run on the calling thread only? */
+  bool serial_ = true;
+
+  std::shared_ptr<SharedState> shared_state_;
+};
+
+}  // namespace executor
+}  // namespace peloton
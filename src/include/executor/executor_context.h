@@ -13,7 +13,11 @@
 
 #pragma once
 
-#include "type/ephemeral_pool.h"
+#include <atomic>
+#include <set>
+
+#include "common/item_pointer.h"
+#include "type/arena_pool.h"
 #include "type/value.h"
 
 namespace peloton {
@@ -52,8 +56,56 @@ class ExecutorContext {
 
   void ClearParams();
 
-  // Get a pool
-  type::EphemeralPool *GetPool();
+  // Get the arena of the query for varlen data of tuples and values it builds.
+  // The memory is released at once, when the context is destroyed.
+  type::AbstractPool *GetPool();
+
+  //===--------------------------------------------------------------------===//
+  // Memory Budget
+  //===--------------------------------------------------------------------===//
+
+  // Reserve memory for a hash table of the query. Returns false, reserving
+  // nothing, when the reservation would exceed the budget.
+  bool ReserveMemory(size_t bytes);
+
+  // Release memory reserved before
+  void ReleaseMemory(size_t bytes);
+
+  // The budget in bytes, 0 for no limit. It defaults to the
+  // query_memory_budget_mb setting.
+  void SetMemoryBudget(size_t bytes) { memory_budget_ = bytes; }
+
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  size_t GetReservedMemory() const { return reserved_memory_.load(); }
+
+  // The memory reserved and the one of the arena
+  size_t GetUsedMemory() {
+    return reserved_memory_.load() + pool_->GetAllocatedSize();
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Profiling
+  //===--------------------------------------------------------------------===//
+
+  // Have the executors count what they do, for EXPLAIN ANALYZE
+  void SetProfiling(bool profiling) { profiling_ = profiling; }
+
+  bool IsProfiling() const { return profiling_; }
+
+  //===--------------------------------------------------------------------===//
+  // Moved Tuples
+  //===--------------------------------------------------------------------===//
+
+  // Record a tuple that an update moved into the partition of its new key,
+  // which the statement must not update again when it scans that partition
+  void AddMovedTuple(const ItemPointer &location) {
+    moved_tuples_.insert(location);
+  }
+
+  bool IsMovedTuple(const ItemPointer &location) const {
+    return moved_tuples_.find(location) != moved_tuples_.end();
+  }
 
   // num of tuple processed
   uint32_t num_processed = 0;
@@ -69,8 +121,20 @@ class ExecutorContext {
   // params
   std::vector<type::Value> params_;
 
-  // pool
-  std::unique_ptr<type::EphemeralPool> pool_;
+  // pool, shared by the threads of the query
+  std::unique_ptr<type::ArenaPool> pool_;
+
+  // memory budget, 0 for no limit
+  size_t memory_budget_;
+
+  // memory reserved by the executors, which may run on several threads
+  std::atomic<size_t> reserved_memory_{0};
+
+  // whether the executors count what they do
+  bool profiling_ = false;
+
+  // the tuples the statement moved into another partition
+  std::set<ItemPointer> moved_tuples_;
 
 };
 
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// executor_profile.h
+//
+// Identification: src/include/executor/executor_profile.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace peloton {
+
+namespace planner {
+class AbstractPlan;
+}  // namespace planner
+
+namespace executor {
+
+//===--------------------------------------------------------------------===//
+// Executor Profile
+//===--------------------------------------------------------------------===//
+
+// What the executors of a plan did while it ran, for EXPLAIN ANALYZE. A
+// compiled query runs the operators of a pipeline fused together, so only the
+// query as a whole is profiled.
+struct ExecutorProfile {
+  // The plan node, e.g. "SEQSCAN on foo"
+  std::string name;
+
+  // Whether the plan ran. EXPLAIN only shows the plan.
+  bool is_profiled = false;
+
+  // calls of Execute()
+  uint64_t execute_count = 0;
+
+  // tuples in the tiles output
+  uint64_t tuple_count = 0;
+
+  // time spent, including the children (in ms)
+  double execute_ms = 0;
+
+  // memory taken from the query while executing, including the children.
+  // It counts the memory reserved for hash tables and sorts and the one of
+  // the arena of the query.
+  uint64_t memory_bytes = 0;
+
+  // Set for the root of a compiled query, which has no stats of its own
+  // operators
+  bool is_compiled = false;
+  double compile_ms = 0;
+  double init_ms = 0;
+  double tear_down_ms = 0;
+
+  std::vector<ExecutorProfile> children;
+
+  // The profile of the plan, without any stats
+  static ExecutorProfile FromPlan(const planner::AbstractPlan &plan);
+
+  // The name of the plan node, with the table it scans if any
+  static std::string GetPlanName(const planner::AbstractPlan &plan);
+
+  // One line per plan node, the children indented below their parent
+  std::vector<std::string> GetLines() const;
+
+ private:
+  void AddLines(const size_t depth, std::vector<std::string> &lines) const;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -17,6 +17,7 @@
 #include "create_executor.h"
 #include "drop_executor.h"
 #include "executor/aggregate_executor.h"
+#include "executor/aggregate_view_scan_executor.h"
 #include "executor/limit_executor.h"
 #include "executor/materialization_executor.h"
 #include "executor/seq_scan_executor.h"
@@ -25,13 +26,17 @@
 #include "executor/delete_executor.h"
 #include "executor/update_executor.h"
 #include "executor/nested_loop_join_executor.h"
+#include "executor/index_nested_loop_join_executor.h"
 #include "executor/merge_join_executor.h"
 #include "executor/hash_join_executor.h"
 #include "executor/hash_executor.h"
 #include "executor/order_by_executor.h"
 #include "executor/hash_set_op_executor.h"
 #include "executor/append_executor.h"
+#include "executor/exchange_executor.h"
 #include "executor/projection_executor.h"
 #include "executor/copy_executor.h"
+#include "executor/copy_from_executor.h"
 #include "executor/populate_index_executor.h"
 #include "executor/analyze_executor.h"
+#include "executor/window_executor.h"
@@ -17,8 +17,10 @@
 #include <unordered_set>
 
 #include "type/types.h"
+#include "codegen/util/bloom_filter.h"
 #include "executor/abstract_executor.h"
 #include "executor/logical_tile.h"
+#include "executor/spill_file.h"
 #include "common/container_tuple.h"
 
 #include <boost/functional/hash.hpp>
@@ -29,6 +31,11 @@ namespace executor {
 /**
  * @brief Hash executor.
  *
+ * The hash table counts against the memory budget of the query. When spilling
+ * is enabled and a tile of the child exceeds the budget, no hash table is
+ * built. The tuples of the child are written to partitions on disk by the
+ * hash of their keys instead, for the hash join to join partition by
+ * partition.
  */
 class HashExecutor : public AbstractExecutor {
  public:
@@ -54,15 +61,70 @@ class HashExecutor : public AbstractExecutor {
     return this->column_ids_;
   }
 
+  /** @brief Bloom filter of the hashes of all keys in the hash table */
+  inline const codegen::util::BloomFilter &GetBloomFilter() const {
+    return this->bloom_filter_;
+  }
+
+  /** @brief Estimated bytes of the hash table per tuple: the key with the
+   * node and bucket of the map, and the location with those of its set */
+  static constexpr size_t kBytesPerTuple =
+      sizeof(HashMapType::value_type) + sizeof(std::pair<size_t, oid_t>) +
+      6 * sizeof(void *);
+
+  /** @brief Allow spilling to disk when the budget is exceeded */
+  inline void EnableSpilling() { this->spilling_enabled_ = true; }
+
+  /** @brief Were the tuples of the child spilled to partitions on disk? */
+  inline bool IsSpilled() const { return !this->partitions_.empty(); }
+
+  /** @brief Partitions of the spilled tuples, by the hash of their keys */
+  inline std::vector<std::unique_ptr<SpillFile>> &GetPartitions() {
+    return this->partitions_;
+  }
+
+  /** @brief Physical schema of the spilled tuples */
+  inline const catalog::Schema *GetSpilledSchema() const {
+    return this->spilled_schema_.get();
+  }
+
+  ~HashExecutor();
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
+  // Reserve memory for hashing the tile. Returns false if the tile exceeds the
+  // budget and should be spilled.
+  bool ReserveTile(LogicalTile *tile);
+
+  // Write the tiles buffered so far to the partitions and release their memory
+  void StartSpilling(LogicalTile *tile);
+
+  // Write all tuples of the tile to the partitions of their keys
+  void SpillTile(LogicalTile *tile);
+
+  /** @brief Memory reserved for the hash table and the buffered tiles */
+  size_t reserved_memory_ = 0;
+
+  bool spilling_enabled_ = false;
+
+  /** @brief Did the hash table exceed the budget without spilling? */
+  bool over_budget_ = false;
+
+  /** @brief Partitions of the spilled tuples, empty unless spilled */
+  std::vector<std::unique_ptr<SpillFile>> partitions_;
+
+  std::unique_ptr<catalog::Schema> spilled_schema_;
+
   /** @brief Hash table */
   HashMapType hash_table_;
 
+  /** @brief Bloom filter of the keys in the hash table */
+  codegen::util::BloomFilter bloom_filter_;
+
   /** @brief Input tiles from child node */
   std::vector<std::unique_ptr<LogicalTile>> child_tiles_;
 
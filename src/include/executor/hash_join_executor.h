@@ -23,6 +23,16 @@
 namespace peloton {
 namespace executor {
 
+/**
+ * @brief Hash join executor.
+ *
+ * When the hash table of an inner join exceeds the memory budget of the
+ * query, the hash executor spills the right child to partitions on disk. The
+ * left child is then partitioned the same way, and every pair of partitions
+ * is joined on its own. A pair whose right partition still exceeds the budget
+ * is partitioned again with the next level of the hash, up to a limit. Outer
+ * joins keep their hash tables in memory.
+ */
 class HashJoinExecutor : public AbstractJoinExecutor {
   HashJoinExecutor(const HashJoinExecutor &) = delete;
   HashJoinExecutor &operator=(const HashJoinExecutor &) = delete;
@@ -37,8 +47,46 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  /** @brief A pair of partitions of the children spilled to disk */
+  struct SpilledPartition {
+    std::unique_ptr<SpillFile> left;
+    std::unique_ptr<SpillFile> right;
+    size_t level;
+  };
+
+  // Probe the hash table with the tuples of the left tile and buffer the
+  // joined tiles
+  void ProbeHashTable(
+      LogicalTile *left_tile, size_t left_tile_idx,
+      const HashExecutor::HashMapType &hash_table,
+      const codegen::util::BloomFilter *bloom_filter,
+      const std::vector<std::unique_ptr<LogicalTile>> &right_tiles);
+
+  // Write the tuples of the left child to the partitions of their keys, and
+  // pair them with the partitions of the hash executor
+  void PartitionLeftChild();
+
+  // Join the next pair of spilled partitions that has any joined tuples.
+  // Returns false once none are left.
+  bool JoinNextPartition();
+
+  // Join a pair of partitions whose right partition fits into memory
+  void JoinPartition(SpilledPartition &partition);
+
+  // Split a pair of partitions into the partitions of the next level
+  void Repartition(SpilledPartition &partition);
+
   HashExecutor *hash_executor_ = nullptr;
 
+  /** @brief Were the children spilled to disk? */
+  bool spilled_ = false;
+
+  /** @brief Pairs of spilled partitions that are still to be joined */
+  std::deque<SpilledPartition> spilled_partitions_;
+
+  /** @brief Physical schema of the spilled tuples of the left child */
+  std::unique_ptr<catalog::Schema> left_spilled_schema_;
+
   bool hashed_ = false;
 
   std::deque<LogicalTile *> buffered_output_tiles;
@@ -16,13 +16,23 @@
 #include "storage/data_table.h"
 #include "index/index.h"
 #include "executor/abstract_scan_executor.h"
+#include "expression/vectorized_predicate.h"
 #include "planner/hybrid_scan_plan.h"
 
-#include <set>
+#include <unordered_map>
 
 namespace peloton {
 namespace executor {
 
+/**
+ * Scans a table that is only partially indexed while the brain builds the
+ * index. In a hybrid scan every tile group is either skipped through its zone
+ * map, scanned sequentially or served from a single index lookup. The tile
+ * groups the index does not cover yet are scanned first, and the fraction of
+ * their tuples that satisfy the predicate decides whether the indexed ones
+ * are looked up in the index. An unselective predicate scans on until it
+ * proves selective enough.
+ */
 class HybridScanExecutor : public AbstractScanExecutor {
  public:
   HybridScanExecutor(const HybridScanExecutor &) = delete;
@@ -31,6 +41,13 @@ class HybridScanExecutor : public AbstractScanExecutor {
   explicit HybridScanExecutor(const planner::AbstractPlan *node,
                               ExecutorContext *executor_context);
 
+  // The largest fraction of the scanned tuples satisfying the predicate for
+  // which the index is looked up rather than scanning sequentially
+  static constexpr double kMaxIndexSelectivity = 0.05;
+
+  // The tuples to scan before their selectivity is trusted over the index
+  static const size_t kMinFeedbackTuples = 1000;
+
  protected:
   bool DInit();
 
@@ -41,8 +58,6 @@ class HybridScanExecutor : public AbstractScanExecutor {
 
   storage::DataTable *table_ = nullptr;
 
-  oid_t indexed_tile_offset_ = INVALID_OID;
-
   HybridScanType type_ = HybridScanType::INVALID;
 
   //  bool build_index_ = true;
@@ -57,14 +72,31 @@ class HybridScanExecutor : public AbstractScanExecutor {
   inline bool SeqScanUtil();
   inline bool IndexScanUtil();
 
+  // Output the visible tuples of a tile group that satisfy the predicate.
+  // Returns false if no tuple does, or the transaction failed to read one.
+  bool ScanTileGroup(const std::shared_ptr<storage::TileGroup> &tile_group);
+
+  // Output the tuples of a tile group the index found
+  bool ServeIndexedTileGroup(
+      const std::shared_ptr<storage::TileGroup> &tile_group);
+
+  // Should the indexed tile groups left be looked up in the index?
+  bool PreferIndex();
+
   //===--------------------------------------------------------------------===//
   // Index Scan
   //===--------------------------------------------------------------------===//
   bool ExecPrimaryIndexLookup();
 
-  bool HybridExecPrimaryIndexLookup();
-  bool HybridSeqScanUtil();
-  //  bool ExecSecondaryIndexLookup();
+  // Look up the key of the plan once, and bucket the visible versions found
+  // by the tile group they are in
+  void HybridExecPrimaryIndexLookup();
+
+  // Follow the version chain from an index entry to the version visible to
+  // the transaction. Returns an invalid location if there is none.
+  ItemPointer GetVisibleVersion(ItemPointer *tuple_location_ptr);
+
+  bool HybridScanUtil();
 
   //===--------------------------------------------------------------------===//
   // Executor State
@@ -79,6 +111,24 @@ class HybridScanExecutor : public AbstractScanExecutor {
   /** @brief Computed the result */
   bool index_done_ = false;
 
+  /** @brief Number of tile groups covered by the index, from the first */
+  oid_t indexed_tile_group_count_ = 0;
+
+  /** @brief Next indexed tile group, once the others are scanned */
+  oid_t indexed_tile_group_itr_ = 0;
+
+  /** @brief Visible tuples found by the index, by tile group id */
+  std::unordered_map<oid_t, std::vector<oid_t>> index_tuples_;
+
+  /** @brief Tuples scanned sequentially and those that satisfied the
+   * predicate, the feedback for choosing the index */
+  size_t scanned_tuple_count_ = 0;
+  size_t matched_tuple_count_ = 0;
+
+  std::unique_ptr<expression::VectorizedPredicate> vectorized_predicate_;
+
+  std::vector<type::CmpBool> predicate_results_;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -89,10 +139,6 @@ class HybridScanExecutor : public AbstractScanExecutor {
   std::vector<oid_t> full_column_ids_;
 
   bool key_ready_ = false;
-
-  std::set<ItemPointer> item_pointers_;
-
-  oid_t block_threshold = 0;
 };
 
 }  // namespace executor
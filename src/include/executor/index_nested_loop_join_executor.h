@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_nested_loop_join_executor.h
+//
+// Identification: src/include/executor/index_nested_loop_join_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "executor/abstract_join_executor.h"
+#include "expression/vectorized_predicate.h"
+
+#include <vector>
+
+namespace peloton {
+namespace executor {
+
+class IndexScanExecutor;
+
+//===----------------------------------------------------------------------===//
+// Joins every outer tile with the inner tuples its join keys find in an
+// index. The distinct keys of the tile are looked up as one batch by the
+// index scan of the right child, and every inner tile it produces is joined
+// with the outer tuples of the key it was found with. Only inner joins are
+// supported.
+//===----------------------------------------------------------------------===//
+class IndexNestedLoopJoinExecutor : public AbstractJoinExecutor {
+  IndexNestedLoopJoinExecutor(const IndexNestedLoopJoinExecutor &) = delete;
+  IndexNestedLoopJoinExecutor &operator=(const IndexNestedLoopJoinExecutor &) =
+      delete;
+
+ public:
+  explicit IndexNestedLoopJoinExecutor(const planner::AbstractPlan *node,
+                                       ExecutorContext *executor_context);
+
+ protected:
+  bool DInit();
+  bool DExecute();
+
+ private:
+  // Look up the distinct join keys of the left tile in the index
+  void LookupLeftTile();
+
+  // The index scan of the inner table
+  IndexScanExecutor *index_scan_executor_ = nullptr;
+
+  // The left tile being joined
+  std::unique_ptr<LogicalTile> left_tile_;
+
+  // Whether every inner tile of the left tile was joined
+  bool left_tile_done_ = true;
+
+  // The rows of the left tile with every key of the batch
+  std::vector<std::vector<oid_t>> key_rows_;
+
+  // The join predicate, evaluated for a right tile at a time
+  std::unique_ptr<expression::VectorizedPredicate> vectorized_predicate_;
+
+  std::vector<type::CmpBool> predicate_results_;
+};
+
+}  // namespace executor
+}  // namespace peloton
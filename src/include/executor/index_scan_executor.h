@@ -44,6 +44,15 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   void ResetState();
 
+  // Look up a batch of keys on the given output columns, e.g. the join keys of
+  // the outer tuples of an index nested-loop join. The tiles of every key are
+  // produced after the ones of the keys before it.
+  void SetKeyBatch(const std::vector<oid_t> &column_ids,
+                   std::vector<std::vector<type::Value>> &&key_batch);
+
+  // The position in the batch of the key the last output tile was found with
+  size_t GetKeyIndex() const { return result_keys_[result_itr_ - 1]; }
+
  protected:
   bool DInit();
 
@@ -56,6 +65,34 @@ class IndexScanExecutor : public AbstractScanExecutor {
   bool ExecPrimaryIndexLookup();
   bool ExecSecondaryIndexLookup();
 
+  // Scan the index in the order of the keys, or in reverse if descending,
+  // stopping at the limit if there is one
+  void ScanInKeyOrder(std::vector<ItemPointer *> &tuple_location_ptrs);
+
+  // Did the scan stop at the limit with keys whose tuples are not visible?
+  // Then there are fewer tuples than the limit, but maybe more in the index.
+  bool IsLimitShort(size_t found_count, size_t visible_count) const;
+
+  // Add the logical tiles of the visible tuples to the result
+  void BuildResultTiles(const std::vector<ItemPointer> &tuple_locations);
+
+  // Look up the keys of the batch one after another
+  bool ExecKeyBatchLookup();
+
+  // Look up the tuple locations of all keys of the batch at once, if the
+  // index allows it
+  void ScanKeyBatch();
+
+  // Whether the scan reads nothing but key columns of a primary key index,
+  // in which case the tuples of frozen tile groups are produced from the
+  // index keys without reading the table
+  bool IsIndexOnlyScan();
+
+  // Build the tuples that were read from the index keys into a logical tile.
+  // rows are the positions of the keys in key_value_list
+  LogicalTile *BuildIndexOnlyTile(const std::vector<type::Value> &key_value_list,
+                                  const std::vector<size_t> &rows) const;
+
   // When the required scan range has open boundaries, the tuples found by the
   // index might not be exact since the index can only give back tuples in a
   // close range. This function prune the head and the tail of the returned
@@ -67,6 +104,14 @@ class IndexScanExecutor : public AbstractScanExecutor {
   // conditions on key columns
   bool CheckKeyConditions(const ItemPointer &tuple_location);
 
+  // Check whether a tuple satisfies the required conditions on key columns
+  bool CheckKeyConditions(const AbstractTuple &tuple);
+
+  // Set the table columns of the tuple_values to the row_id'th key of an
+  // index-only scan
+  void SetKeyValues(const std::vector<type::Value> &key_value_list,
+                    size_t row_id, std::vector<type::Value> &tuple_values) const;
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -129,6 +174,27 @@ class IndexScanExecutor : public AbstractScanExecutor {
 
   // whether order by is descending
   bool descend_ = false;
+
+  // whether the tiles keep the order of the index keys
+  bool key_ordered_ = false;
+
+  // whether tuples of frozen tile groups are produced from the index keys
+  bool index_only_ = false;
+
+  // the output columns of the keys of the batch
+  std::vector<oid_t> key_batch_column_ids_;
+
+  // the keys of the batch, if any
+  std::vector<std::vector<type::Value>> key_batch_;
+
+  // the tuple locations of every key, if the batch was looked up at once
+  std::vector<std::vector<ItemPointer *>> key_batch_locations_;
+
+  // the key of the batch being looked up
+  size_t key_batch_itr_ = 0;
+
+  // the key of the batch every tile of result_ was found with
+  std::vector<size_t> result_keys_;
 };
 
 }  // namespace executor
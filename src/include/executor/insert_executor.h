@@ -14,6 +14,8 @@
 #pragma once
 
 #include "executor/abstract_executor.h"
+#include "storage/foreign_key_cache.h"
+#include "storage/tuple.h"
 
 #include <vector>
 
@@ -36,7 +38,16 @@ class InsertExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  // The tuple the rows are materialized into before they are inserted, kept
+  // across calls
+  storage::Tuple *GetTupleBuffer(const catalog::Schema *schema);
+
   bool done_ = false;
+
+  std::unique_ptr<storage::Tuple> tuple_buffer_;
+
+  // The referenced keys the statement already found
+  storage::ForeignKeyCache foreign_key_cache_;
 };
 
 }  // namespace executor
@@ -115,6 +115,13 @@ class LogicalTile : public Printable {
   // Materialize and return a physical tile.
   std::unique_ptr<storage::Tile> Materialize();
 
+  // Whether the given number of columns of a base tile are copied column at a
+  // time. Rows are only copied at a time when they cover most of the base
+  // tile, narrow projections of wide tiles and columnar tiles are copied by
+  // column.
+  static bool IsColumnWiseMaterialization(const storage::Tile *base_tile,
+                                          size_t column_count);
+
   //===--------------------------------------------------------------------===//
   // Logical Tile Iterator
   //===--------------------------------------------------------------------===//
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "executor/abstract_join_executor.h"
@@ -21,6 +22,13 @@
 namespace peloton {
 namespace executor {
 
+//===----------------------------------------------------------------------===//
+// Joins the tuples of its children with equal keys of the join clauses. Both
+// children are read entirely, and a side whose tuples are not in key order,
+// unlike the ones of a key ordered index scan, is sorted first. The left
+// tuples are then cut into ranges on key boundaries, and the ranges are
+// merged with the right tuples of the same keys on several threads.
+//===----------------------------------------------------------------------===//
 class MergeJoinExecutor : public AbstractJoinExecutor {
   MergeJoinExecutor(const MergeJoinExecutor &) = delete;
   MergeJoinExecutor &operator=(const MergeJoinExecutor &) = delete;
@@ -29,23 +37,36 @@ class MergeJoinExecutor : public AbstractJoinExecutor {
   explicit MergeJoinExecutor(const planner::AbstractPlan *node,
                              ExecutorContext *executor_context);
 
+  // The minimum number of left tuples every thread merges
+  static constexpr size_t kMinRowsPerThread = 1 << 14;
+
+  struct SortedSide;
+
  protected:
   bool DInit();
 
   bool DExecute();
 
  private:
-  size_t Advance(LogicalTile *tile, size_t start_row, bool is_left);
+  // Read the tiles of a child, returns false if it had none
+  bool ReadChild(size_t child_idx);
+
+  // Collect the tuples of the buffered tiles of a side in key order
+  void SortSide(bool is_left, SortedSide &side);
+
+  // Merge the tuples of both sides and build the output tiles
+  void Merge();
 
   /** @brief a vector of join clauses
    * Get this from plan node during initialization */
   const std::vector<planner::MergeJoinPlan::JoinClause> *join_clauses_;
 
-  size_t left_start_row = 0;
-  size_t right_start_row = 0;
+  // The joined tiles that are not produced yet
+  std::vector<std::unique_ptr<LogicalTile>> output_tiles_;
+
+  size_t output_itr_ = 0;
 
-  size_t left_end_row = 0;
-  size_t right_end_row = 0;
+  bool merged_ = false;
 };
 
 }  // namespace executor
@@ -13,6 +13,7 @@
 #pragma once
 
 #include "executor/abstract_join_executor.h"
+#include "expression/vectorized_predicate.h"
 
 #include <vector>
 
@@ -51,6 +52,11 @@ class NestedLoopJoinExecutor : public AbstractJoinExecutor {
   // return the combine result when there is a matched right tile. So next time,
   // we will begin from the point of last time, if left_tile_done is false
   bool left_tile_done_ = true;
+
+  // The join predicate, evaluated for a right tile at a time
+  std::unique_ptr<expression::VectorizedPredicate> vectorized_predicate_;
+
+  std::vector<type::CmpBool> predicate_results_;
 };
 
 }  // namespace executor
@@ -14,6 +14,7 @@
 
 #include "type/types.h"
 #include "executor/abstract_executor.h"
+#include "executor/spill_file.h"
 #include "storage/tuple.h"
 
 namespace peloton {
@@ -22,10 +23,13 @@ namespace executor {
 /**
  * @warning This is a pipeline breaker and a materialization point.
  *
- * TODO Currently, we store all input tiles and sort result in memory
- * until this executor is destroyed, which is sometimes necessary.
- * But can we let it release the RAM earlier as long as the executor
- * is not needed any more (e.g., with a LIMIT sitting on top)?
+ * The input tiles and the sort buffer count against the memory budget of the
+ * query. When a tile exceeds it, the buffered tuples are sorted and written
+ * to a run on disk, and the sort continues with an empty buffer. The runs are
+ * merged with a loser tree at the end.
+ *
+ * With a limit, only the first offset + limit tuples are kept (top-N), which
+ * bounds the memory without any runs.
  */
 class OrderByExecutor : public AbstractExecutor {
  public:
@@ -47,6 +51,37 @@ class OrderByExecutor : public AbstractExecutor {
  private:
   bool DoSort();
 
+  // Set up the schemas of the sort keys and of the output tiles
+  void InitSchemas(LogicalTile *tile);
+
+  // Reserve memory for sorting the tile. Returns false if it exceeds the
+  // budget.
+  bool ReserveTile(LogicalTile *tile);
+
+  // Add the tuples of the last input tile to the sort buffer
+  void BufferTile();
+
+  void SortBuffer();
+
+  // Keep only the first offset + limit tuples of the sort buffer, and drop the
+  // input tiles none of them is in
+  void PruneBuffer();
+
+  // Sort the buffer, write it to a new run, and release its memory
+  void WriteRun();
+
+  // Read the first row of every run and build the loser tree
+  void InitMerge();
+
+  // Replay the matches of the run from its leaf up to the root
+  void AdjustLoserTree(size_t run);
+
+  // Does the next row of run a come before the one of run b?
+  bool RunBeats(size_t a, size_t b) const;
+
+  // Return the next output tile of the merged runs
+  bool ExecuteMerge();
+
   bool sort_done_ = false;
 
   /**
@@ -92,6 +127,20 @@ class OrderByExecutor : public AbstractExecutor {
 
   std::vector<bool> descend_flags_;
 
+  /** Sorted runs written once the input exceeded the memory budget. Their
+   * rows have the sort keys first, then the output columns. */
+  std::vector<std::unique_ptr<SpillFile>> runs_;
+
+  /** The next row of every run, empty once the run is done */
+  std::vector<std::vector<type::Value>> run_heads_;
+
+  /** Loser tree over the runs. The first entry is the run of the next row,
+   * the others the losers of the matches at the inner nodes. */
+  std::vector<size_t> loser_tree_;
+
+  /** Memory reserved for the buffered tiles */
+  size_t reserved_memory_ = 0;
+
   /** How many tuples have been returned to parent */
   size_t num_tuples_returned_ = 0;
 
@@ -66,12 +66,17 @@ class PlanExecutor {
    * for networking
    * Before ExecutePlan, a node first receives value list, so we should
    * pass value list directly rather than passing Postgres's ParamListInfo
+   * With a callback, the rows of the result are handed over in chunks of
+   * result_chunk_rows while the plan executes, the last ones stay in result
+   * With a profile, the executors count what they do into it
    */
   static ExecuteResult ExecutePlan(std::shared_ptr<planner::AbstractPlan> plan,
                                     concurrency::Transaction* txn,
                                     const std::vector<type::Value> &params,
                                     std::vector<StatementResult> &result,
-                                    const std::vector<int> &result_format);
+                                    const std::vector<int> &result_format,
+                                    const ResultCallback *callback = nullptr,
+                                    ExecutorProfile *profile = nullptr);
 
   /*
    * @brief When a peloton node recvs a query plan, this function is invoked
@@ -82,6 +87,13 @@ class PlanExecutor {
       const planner::AbstractPlan *plan, const std::vector<type::Value> &params,
       std::vector<std::unique_ptr<executor::LogicalTile>> &logical_tile_list);
 
+  /*
+   * @brief Estimate the number of tuples the scans of the plan read, from
+   * the number of tuples of their tables. A lookup of a single key of a
+   * unique index reads one.
+   */
+  static size_t EstimateProcessedRows(const planner::AbstractPlan &plan);
+
  private:
   DISALLOW_COPY_AND_MOVE(PlanExecutor);
 };
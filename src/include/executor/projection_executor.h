@@ -35,6 +35,8 @@ class ProjectionExecutor : public AbstractExecutor {
   bool DExecute();
 
  private:
+  bool ProjectColumns(LogicalTile *source_tile);
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -47,6 +49,13 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** @brief Flag to indicate whether the execution has finished for SELECT without FROM */
   bool finished_ = false;
+
+  /**
+   * @brief Child columns of the output columns, if the projection only
+   * reorders columns of its child. It is then done on the position lists of
+   * the child's tiles, without copying any values.
+   */
+  std::vector<oid_t> direct_column_ids_;
 };
 
 } /* namespace executor */
@@ -14,6 +14,7 @@
 
 #include "planner/seq_scan_plan.h"
 #include "executor/abstract_scan_executor.h"
+#include "expression/vectorized_predicate.h"
 
 namespace peloton {
 namespace executor {
@@ -31,7 +32,20 @@ class SeqScanExecutor : public AbstractScanExecutor {
   void UpdatePredicate(const std::vector<oid_t> &column_ids,
                        const std::vector<type::Value> &values) override;
 
-  void ResetState() override { current_tile_group_offset_ = START_OID; }
+  void ResetState() override {
+    current_tile_group_offset_ = tile_group_start_;
+    prefetch_tile_group_offset_ = tile_group_start_;
+    scanned_tuple_count_ = 0;
+    matched_tuple_count_ = 0;
+  }
+
+  // Only scan the tile groups in [start, end) of the table. Exchanges run
+  // several scans of the same plan on disjoint ranges. Must be called before
+  // Init().
+  void SetTileGroupRange(oid_t start, oid_t end) {
+    tile_group_start_ = start;
+    tile_group_end_ = end;
+  }
 
  protected:
   bool DInit() override ;
@@ -50,6 +64,8 @@ class SeqScanExecutor : public AbstractScanExecutor {
   expression::AbstractExpression *ColumnValueToCmpExpr(
       const oid_t column_id, const type::Value &value);
 
+  const expression::VectorizedPredicate &GetVectorizedPredicate();
+
   //===--------------------------------------------------------------------===//
   // Executor State
   //===--------------------------------------------------------------------===//
@@ -57,9 +73,22 @@ class SeqScanExecutor : public AbstractScanExecutor {
   /** @brief Keeps track of current tile group id being scanned. */
   oid_t current_tile_group_offset_ = INVALID_OID;
 
+  /** @brief The tile groups before this one were paged in ahead, if they
+   * were evicted. */
+  oid_t prefetch_tile_group_offset_ = INVALID_OID;
+
   /** @brief Keeps track of the number of tile groups to scan. */
   oid_t table_tile_group_count_ = INVALID_OID;
 
+  /** @brief The range of tile groups to scan, the whole table by default. */
+  oid_t tile_group_start_ = START_OID;
+  oid_t tile_group_end_ = INVALID_OID;
+
+  /** @brief The tuples scanned so far and those that satisfied the predicate,
+   * reported as cardinality feedback once the whole table was scanned. */
+  size_t scanned_tuple_count_ = 0;
+  size_t matched_tuple_count_ = 0;
+
   //===--------------------------------------------------------------------===//
   // Plan Info
   //===--------------------------------------------------------------------===//
@@ -76,6 +105,12 @@ class SeqScanExecutor : public AbstractScanExecutor {
   // The original predicate, if it's not nullptr
   // we need to combine it with the undated predicate 
   const expression::AbstractExpression *old_predicate_;
+
+  // The predicate evaluated a tile group or logical tile at a time, built
+  // from the current predicate on first use
+  std::unique_ptr<expression::VectorizedPredicate> vectorized_predicate_;
+
+  std::vector<type::CmpBool> predicate_results_;
 };
 
 }  // namespace executor
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_file.h
+//
+// Identification: src/include/executor/spill_file.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <vector>
+
+#include "type/serializeio.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace executor {
+
+/**
+ * @brief A temporary file of rows of values.
+ * The hash joins and hash aggregations that exceed the memory budget of their
+ * query write the rows they cannot keep in memory to spill files, one file per
+ * partition of the hash of the keys, and read them back partition by
+ * partition. The file is removed once the spill file is destroyed.
+ */
+class SpillFile {
+ public:
+  SpillFile(const SpillFile &) = delete;
+  SpillFile &operator=(const SpillFile &) = delete;
+  SpillFile(SpillFile &&) = delete;
+  SpillFile &operator=(SpillFile &&) = delete;
+
+  explicit SpillFile(const std::vector<type::TypeId> &column_types);
+
+  ~SpillFile();
+
+  // The number of partitions the input of a hash table is spilled to
+  static constexpr size_t kNumPartitions = 16;
+
+  // The deepest level a partition that exceeds the budget is partitioned again
+  static constexpr size_t kMaxPartitionLevel = 8;
+
+  // The partition of the given key values. Each level of the partitioning
+  // hashes with a different seed, so that the rows of a partition spread over
+  // the partitions of the next level.
+  static size_t GetPartition(const std::vector<type::Value> &keys,
+                             size_t level);
+
+  // Append a row with a value for every column
+  void Append(const std::vector<type::Value> &values);
+
+  // Start reading the rows from the first one
+  void Rewind();
+
+  // Read the next row. The values own their data. Returns false after the last
+  // row.
+  bool Next(std::vector<type::Value> &values);
+
+  const std::vector<type::TypeId> &GetColumnTypes() const {
+    return column_types_;
+  }
+
+  size_t GetRowCount() const { return row_count_; }
+
+  // The number of bytes of the rows written
+  size_t GetByteCount() const { return byte_count_; }
+
+ private:
+  const std::vector<type::TypeId> column_types_;
+
+  FILE *file_ = nullptr;
+
+  size_t row_count_ = 0;
+
+  size_t byte_count_ = 0;
+
+  // Serialized row being written
+  CopySerializeOutput output_;
+
+  // Serialized row being read
+  std::vector<char> input_;
+};
+
+}  // namespace executor
+}  // namespace peloton
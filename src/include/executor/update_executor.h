@@ -42,6 +42,11 @@ class UpdateExecutor : public AbstractExecutor {
                                oid_t physical_tuple_id,
                                ItemPointer &old_location);
 
+  // overwrite the updated columns of an owned version in place, if the
+  // protocol allows it
+  bool PerformInPlaceUpdate(storage::TileGroup *tile_group,
+                            oid_t physical_tuple_id);
+
   bool DInit();
 
   bool DExecute();
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// window_executor.h
+//
+// Identification: src/include/executor/window_executor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "executor/abstract_executor.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace planner {
+struct WindowTerm;
+}
+
+namespace executor {
+
+/**
+ * @warning This is a pipeline breaker and a materialization point.
+ *
+ * Computes the window functions of every input row. The input arrives sorted
+ * by partition, so every partition is a run of rows. The ranks are counted
+ * along the run. The aggregates of a partition are answered from a segment
+ * tree over its rows, so that every frame costs O(log n) whatever its size.
+ */
+class WindowExecutor : public AbstractExecutor {
+ public:
+  WindowExecutor(const WindowExecutor &) = delete;
+  WindowExecutor &operator=(const WindowExecutor &) = delete;
+  WindowExecutor(const WindowExecutor &&) = delete;
+  WindowExecutor &operator=(const WindowExecutor &&) = delete;
+
+  explicit WindowExecutor(const planner::AbstractPlan *node,
+                          ExecutorContext *executor_context);
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  // The partial aggregate of a range of rows
+  struct AggregateState {
+    int64_t count = 0;
+    type::Value sum;
+    type::Value min;
+    type::Value max;
+  };
+
+  // Read all input tiles and compute the window values
+  void DoWindow();
+
+  // Set up the schema of the output tiles
+  void InitSchema(LogicalTile *tile);
+
+  // Compute the window values of the rows in [begin, end), one partition
+  void ComputePartition(size_t begin, size_t end);
+
+  // Compute the aggregate of the term over the frames of the partition
+  void ComputeAggregate(oid_t term_offset, size_t begin, size_t end);
+
+  static void Combine(AggregateState &state, const AggregateState &other);
+
+  // Do the rows agree on the columns?
+  bool SameValues(size_t row_a, size_t row_b,
+                  const std::vector<oid_t> &column_ids) const;
+
+  type::Value GetRowValue(size_t row, oid_t column_id) const;
+
+  bool window_done_ = false;
+
+  /** All tiles returned by child. */
+  std::vector<std::unique_ptr<LogicalTile>> input_tiles_;
+
+  /** The input rows in order, as tile and tuple ids */
+  std::vector<ItemPointer> rows_;
+
+  /** The window values, per row and then per term */
+  std::vector<std::vector<type::Value>> window_values_;
+
+  /** Physical schema of output tiles */
+  std::unique_ptr<catalog::Schema> output_schema_;
+
+  /** Columns of the input tiles */
+  oid_t input_column_count_ = 0;
+
+  /** How many tuples have been returned to parent */
+  size_t num_tuples_returned_ = 0;
+};
+
+} /* namespace executor */
+} /* namespace peloton */
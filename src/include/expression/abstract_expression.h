@@ -14,6 +14,7 @@
 
 #include <string>
 
+#include "common/arena_node.h"
 #include "common/printable.h"
 #include "planner/attribute_info.h"
 #include "type/types.h"
@@ -60,7 +61,7 @@ namespace expression {
 // remain constant and read-only during an execution.
 //===----------------------------------------------------------------------===//
 
-class AbstractExpression : public Printable {
+class AbstractExpression : public Printable, public ArenaNode {
  public:
   virtual type::Value Evaluate(const AbstractTuple *tuple1,
                                const AbstractTuple *tuple2,
@@ -58,6 +58,9 @@ class AggregateExpression : public AbstractExpression {
       case ExpressionType::AGGREGATE_AVG:
         expr_name_ = "avg";
         break;
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+        expr_name_ = "approx_count_distinct";
+        break;
       default:
         throw Exception("Aggregate type not supported");
     }
@@ -111,6 +114,9 @@ class AggregateExpression : public AbstractExpression {
       case ExpressionType::AGGREGATE_AVG:
         return_value_type_ = type::TypeId::DECIMAL;
         break;
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+        return_value_type_ = type::TypeId::BIGINT;
+        break;
       default:
         break;
     }
@@ -14,6 +14,7 @@
 
 #include "common/sql_node_visitor.h"
 #include "expression/abstract_expression.h"
+#include "type/value_dispatch.h"
 #include "type/value_factory.h"
 
 namespace peloton {
@@ -44,19 +45,16 @@ class ComparisonExpression : public AbstractExpression {
     auto vr = children_[1]->Evaluate(tuple1, tuple2, context);
     switch (exp_type_) {
       case (ExpressionType::COMPARE_EQUAL):
-        return type::ValueFactory::GetBooleanValue(vl.CompareEquals(vr));
       case (ExpressionType::COMPARE_NOTEQUAL):
-        return type::ValueFactory::GetBooleanValue(vl.CompareNotEquals(vr));
       case (ExpressionType::COMPARE_LESSTHAN):
-        return type::ValueFactory::GetBooleanValue(vl.CompareLessThan(vr));
       case (ExpressionType::COMPARE_GREATERTHAN):
-        return type::ValueFactory::GetBooleanValue(vl.CompareGreaterThan(vr));
       case (ExpressionType::COMPARE_LESSTHANOREQUALTO):
-        return type::ValueFactory::GetBooleanValue(
-            vl.CompareLessThanEquals(vr));
-      case (ExpressionType::COMPARE_GREATERTHANOREQUALTO):
-        return type::ValueFactory::GetBooleanValue(
-            vl.CompareGreaterThanEquals(vr));
+      case (ExpressionType::COMPARE_GREATERTHANOREQUALTO): {
+        // Compare with the kernel of the types of the values
+        auto compare = type::ValueDispatch::GetCompareFunction(
+            exp_type_, vl.GetTypeId(), vr.GetTypeId());
+        return type::ValueFactory::GetBooleanValue(compare(vl, vr));
+      }
       case (ExpressionType::COMPARE_DISTINCT_FROM): {
         if (vl.IsNull() && vr.IsNull()) {
           return type::ValueFactory::GetBooleanValue(false);
@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunction_order.h
+//
+// Identification: src/include/expression/conjunction_order.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace expression {
+
+class AbstractExpression;
+
+//===----------------------------------------------------------------------===//
+// The order the terms of a chain of ANDs, or of ORs, are evaluated in, adapted
+// to the tuples they see. The terms are evaluated in the order of the query
+// until the first one saw kSampleTuples tuples. They are then ordered by the
+// share of the tuples they decide the result of per unit of their cost, which
+// puts the cheap and selective terms of ANDs first.
+//
+// The terms that can fail, e.g. divide by zero, stay behind the others in the
+// order of the query. They then only see tuples they would have seen in that
+// order too.
+//
+// The order is shared by all threads evaluating the predicate. It changes
+// once, and is read as a whole so that a batch of tuples is evaluated in
+// one order.
+//===----------------------------------------------------------------------===//
+class ConjunctionOrder {
+ public:
+  // The most terms of a chain that are reordered
+  static constexpr uint32_t kMaxTerms = 16;
+
+  // The number of tuples the first term sees before the terms are reordered
+  static constexpr uint64_t kSampleTuples = 4096;
+
+  ConjunctionOrder(const ConjunctionOrder &) = delete;
+  ConjunctionOrder &operator=(const ConjunctionOrder &) = delete;
+
+  // The order of the terms of the chain the predicate is the root of
+  explicit ConjunctionOrder(const AbstractExpression *predicate);
+
+  // Collect the terms of the chain of conjunctions the expression is the root
+  // of, in the order of the query. Empty if it is no conjunction.
+  static void CollectTerms(const AbstractExpression *expr,
+                           std::vector<const AbstractExpression *> &terms);
+
+  // Whether the predicate is a chain whose terms can be reordered
+  static bool IsReorderable(const AbstractExpression *predicate,
+                            uint32_t max_terms = kMaxTerms);
+
+  uint32_t GetTermCount() const { return num_terms_; }
+
+  // The order of the terms, each position holding the index of its term in
+  // four bits
+  uint64_t GetOrder() const { return order_.load(std::memory_order_acquire); }
+
+  // The term evaluated at the given position of the order
+  static uint32_t GetTerm(uint64_t order, uint32_t pos) {
+    return static_cast<uint32_t>((order >> (4 * pos)) & 0xf);
+  }
+
+  // Whether the terms are still evaluated in the order of the query
+  bool IsSampling() const {
+    return reordered_.load(std::memory_order_relaxed) == false;
+  }
+
+  // Record that the term was evaluated for the tuples, and decided the result
+  // of some of them. The time it took is 0 if it was not measured, the cost
+  // of the term is then estimated from its expression.
+  void Record(uint32_t term, uint64_t num_tuples, uint64_t num_decided,
+              uint64_t nanos = 0);
+
+ private:
+  // Order the terms by what they did so far
+  void Reorder();
+
+  // The cost of evaluating the expression, in comparisons of columns
+  static double EstimateCost(const AbstractExpression *expr);
+
+  // Whether evaluating the expression can throw
+  static bool MayFail(const AbstractExpression *expr);
+
+ private:
+  struct Term {
+    double estimated_cost = 1.0;
+    bool may_fail = false;
+
+    std::atomic<uint64_t> num_tuples{0};
+    std::atomic<uint64_t> num_decided{0};
+    std::atomic<uint64_t> nanos{0};
+  };
+
+  uint32_t num_terms_;
+
+  Term terms_[kMaxTerms];
+
+  std::atomic<uint64_t> order_;
+
+  std::atomic<bool> reordered_;
+};
+
+}  // namespace expression
+}  // namespace peloton
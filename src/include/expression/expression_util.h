@@ -261,6 +261,7 @@ class ExpressionUtil {
       case ExpressionType::AGGREGATE_MIN:
       case ExpressionType::AGGREGATE_MAX:
       case ExpressionType::AGGREGATE_AVG:
+      case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
         return true;
       default:
         return false;
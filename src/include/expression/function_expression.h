@@ -25,6 +25,9 @@ namespace expression {
 
 class FunctionExpression : public AbstractExpression {
  public:
+  // The signature of the built-in functions
+  typedef type::Value (*BuiltInFuncType)(const std::vector<type::Value>&);
+
   FunctionExpression(const char* func_name,
                      const std::vector<AbstractExpression*>& children)
       : AbstractExpression(ExpressionType::FUNCTION),
@@ -79,6 +82,9 @@ class FunctionExpression : public AbstractExpression {
 
   AbstractExpression* Copy() const override { return new FunctionExpression(*this); }
 
+  // The built-in function, or nullptr if it was not resolved yet
+  BuiltInFuncType GetFunc() const { return func_ptr_; }
+
   std::string func_name_;
 
   virtual void Accept(SqlNodeVisitor* v) override { v->Visit(this); }
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_predicate.h
+//
+// Identification: src/include/expression/vectorized_predicate.h
+//
+// Copyright (c) 2015-2017, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "type/type.h"
+#include "type/types.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace executor {
+class ExecutorContext;
+class LogicalTile;
+}
+
+namespace storage {
+class TileGroup;
+}
+
+namespace expression {
+
+class AbstractExpression;
+
+//===----------------------------------------------------------------------===//
+// VectorizedPredicate
+//
+// Evaluates a predicate over a batch of tuples at a time, instead of calling
+// AbstractExpression::Evaluate for every tuple. Comparisons of numeric columns
+// with each other or with values that are the same for the whole batch are
+// evaluated by kernels that read the columns straight out of the base tiles,
+// and conjunctions only evaluate their right side on the tuples the left side
+// did not decide. The terms of chains of ANDs or ORs are reordered by what
+// they decide on the first tuples, see ConjunctionOrder. Every other
+// expression is evaluated one tuple at a time.
+//
+// The result for every tuple is CMP_TRUE, CMP_FALSE or CMP_NULL. The tuples
+// of the batch are the tuples |batch_tuple_idx| of the expression refers to.
+// The tuple on the other side, if any, is the same for the whole batch, e.g.
+// the outer tuple of a nested loop join.
+//===----------------------------------------------------------------------===//
+class VectorizedPredicate {
+ public:
+  VectorizedPredicate(const VectorizedPredicate &) = delete;
+  VectorizedPredicate &operator=(const VectorizedPredicate &) = delete;
+
+  VectorizedPredicate(const AbstractExpression *predicate,
+                      int batch_tuple_idx = 0);
+
+  ~VectorizedPredicate();
+
+  // Evaluate the predicate for the given tuples of a tile group, whose column
+  // ids are the ones of the table
+  void Evaluate(storage::TileGroup *tile_group, const oid_t *tuple_ids,
+                size_t num_tuples, const AbstractTuple *other_tuple,
+                executor::ExecutorContext *context,
+                std::vector<type::CmpBool> &results) const;
+
+  // Evaluate the predicate for the given tuples of a logical tile
+  void Evaluate(executor::LogicalTile *tile, const oid_t *tuple_ids,
+                size_t num_tuples, const AbstractTuple *other_tuple,
+                executor::ExecutorContext *context,
+                std::vector<type::CmpBool> &results) const;
+
+  // Whether any part of the predicate is evaluated by a kernel
+  bool IsVectorized() const;
+
+  class Node;
+  struct Batch;
+
+ private:
+  void Evaluate(const Batch &batch, std::vector<type::CmpBool> &results) const;
+
+  int batch_tuple_idx_;
+
+  std::unique_ptr<Node> root_;
+};
+
+}  // namespace expression
+}  // namespace peloton
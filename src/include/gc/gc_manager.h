@@ -24,6 +24,7 @@
 namespace peloton {
 
 namespace storage {
+class DataTable;
 class TileGroup;
 }
 
@@ -70,6 +71,12 @@ class GCManager {
 
   virtual size_t GetTableCount() { return 0; }
 
+  // The number of garbage contexts waiting to be unlinked or reclaimed
+  virtual size_t GetBacklog() { return 0; }
+
+  // The number of versions reclaimed since the start
+  virtual size_t GetReclaimedVersionCount() { return 0; }
+
   virtual void RecycleTransaction(std::shared_ptr<GCSet> gc_set UNUSED_ATTRIBUTE, 
                                   const eid_t &epoch_id UNUSED_ATTRIBUTE, 
                                   const size_t &thread_id UNUSED_ATTRIBUTE) {}
@@ -12,9 +12,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <deque>
 #include <thread>
 #include <unordered_map>
-#include <map>
 #include <vector>
 #include <list>
 
@@ -25,38 +26,60 @@
 #include "gc/gc_manager.h"
 
 #include "container/lock_free_queue.h"
+#include "container/ring_queue.h"
 
 namespace peloton {
 namespace gc {
 
 #define MAX_QUEUE_LENGTH 100000
 #define MAX_ATTEMPT_COUNT 100000
+#define OVERFLOW_QUEUE_LENGTH 1024
 
 
 struct GarbageContext {
   GarbageContext() : epoch_id_(INVALID_EID) {}
   GarbageContext(std::shared_ptr<GCSet> gc_set, 
                  const eid_t &epoch_id) {
-    gc_set_ = gc_set;
+    gc_set_ = std::move(gc_set);
     epoch_id_ = epoch_id;
   }
 
   std::shared_ptr<GCSet> gc_set_;
   eid_t epoch_id_;
+
+  // indirections of the unlinked tuples that no index entry references
+  // anymore, with the tile group of the tuple. released with the garbage.
+  std::vector<std::pair<oid_t, ItemPointer *>> indirections_;
+};
+
+// the garbage unlinked by a gc thread while one epoch was current.
+// reclaimed once that epoch has expired.
+struct ReclaimBucket {
+  ReclaimBucket(const eid_t &epoch_id) : epoch_id_(epoch_id) {}
+
+  eid_t epoch_id_;
+  std::vector<std::shared_ptr<GarbageContext>> garbages_;
 };
 
 class TransactionLevelGCManager : public GCManager {
 public:
   TransactionLevelGCManager(const int thread_count) 
     : gc_thread_count_(thread_count),
-      reclaim_maps_(thread_count) {
+      active_thread_count_(thread_count > 0 ? 1 : 0),
+      reclaim_queues_(thread_count),
+      held_garbage_counts_(thread_count),
+      reclaimed_version_count_(0) {
 
     unlink_queues_.reserve(thread_count);
     for (int i = 0; i < gc_thread_count_; ++i) {
-      std::shared_ptr<LockFreeQueue<std::shared_ptr<GarbageContext>>> unlink_queue(
-        new LockFreeQueue<std::shared_ptr<GarbageContext>>(MAX_QUEUE_LENGTH)
+      std::shared_ptr<MPMCRingQueue<std::shared_ptr<GarbageContext>>> unlink_queue(
+        new MPMCRingQueue<std::shared_ptr<GarbageContext>>(MAX_QUEUE_LENGTH)
       );
       unlink_queues_.push_back(unlink_queue);
+      std::shared_ptr<LockFreeQueue<std::shared_ptr<GarbageContext>>> overflow_queue(
+        new LockFreeQueue<std::shared_ptr<GarbageContext>>(OVERFLOW_QUEUE_LENGTH)
+      );
+      overflow_unlink_queues_.push_back(overflow_queue);
       local_unlink_queues_.emplace_back();
     }
   }
@@ -98,7 +121,7 @@ public:
   virtual void RegisterTable(const oid_t &table_id) override {
     // Insert a new entry for the table
     if (recycle_queue_map_.find(table_id) == recycle_queue_map_.end()) {
-      std::shared_ptr<LockFreeQueue<ItemPointer>> recycle_queue(new LockFreeQueue<ItemPointer>(MAX_QUEUE_LENGTH));
+      std::shared_ptr<LockFreeQueue<oid_t>> recycle_queue(new LockFreeQueue<oid_t>(MAX_QUEUE_LENGTH));
       recycle_queue_map_[table_id] = recycle_queue;
     }
   }
@@ -110,6 +133,12 @@ public:
     }
   }
 
+  virtual size_t GetBacklog() override;
+
+  virtual size_t GetReclaimedVersionCount() override {
+    return reclaimed_version_count_.load(std::memory_order_relaxed);
+  }
+
   virtual size_t GetTableCount() override {
     return recycle_queue_map_.size();
   }
@@ -120,21 +149,46 @@ public:
 
 private:
 
+  // only the active gc threads are handed new garbage. the others drain
+  // what they hold and back off.
   inline unsigned int HashToThread(const size_t &thread_id) {
-    return (unsigned int)thread_id % gc_thread_count_;
+    return (unsigned int)thread_id % active_thread_count_.load();
   }
 
+  // hand new garbage to one more gc thread
+  void AddActiveThread();
+
+  // stop handing new garbage to the given gc thread if it is the last
+  // active one
+  void RemoveActiveThread(const int &thread_id);
+
   void ClearGarbage(int thread_id);
 
+  // take the next garbage handed to the gc thread, if any
+  bool DequeueGarbage(const int &thread_id,
+                      std::shared_ptr<GarbageContext> &garbage_ctx);
+
+  bool HasQueuedGarbage(const int &thread_id) {
+    return unlink_queues_[thread_id]->IsEmpty() == false ||
+           overflow_unlink_queues_[thread_id]->IsEmpty() == false;
+  }
+
   void Running(const int &thread_id);
 
   void AddToRecycleMap(std::shared_ptr<GarbageContext> gc_ctx);
 
+  // Recycle the versions of a tile group that was deleted as a whole, and
+  // drop it once all its slots are recycled. Returns the number of versions
+  // recycled.
+  size_t RecycleDeletedTileGroup(storage::DataTable *table,
+                                 storage::TileGroup *tile_group);
+
   bool ResetTuple(const ItemPointer &);
 
-  void DeleteFromIndexes(const std::shared_ptr<GarbageContext>& garbage_ctx);
+  void DeleteFromIndexes(
+      const std::vector<std::shared_ptr<GarbageContext>> &garbages);
 
-  void DeleteTupleFromIndexes(const ItemPointer location);
+  void ReleaseIndirections(const std::shared_ptr<GarbageContext> &garbage_ctx);
 
 private:
   //===--------------------------------------------------------------------===//
@@ -143,23 +197,42 @@ private:
 
   int gc_thread_count_;
 
-  // queues for to-be-unlinked tuples.
+  // # of gc threads that new garbage is hashed to. grows while the gc
+  // threads cannot keep up and shrinks once they are idle.
+  std::atomic<int> active_thread_count_;
+
+  // queues for to-be-unlinked tuples. bounded rings written by all the
+  // transaction threads and read by one gc thread.
   // # unlink_queues == # gc_threads
-  std::vector<std::shared_ptr<peloton::LockFreeQueue<std::shared_ptr<GarbageContext>>>> unlink_queues_;
+  std::vector<std::shared_ptr<peloton::MPMCRingQueue<std::shared_ptr<GarbageContext>>>> unlink_queues_;
+
+  // garbage that did not fit into the unlink queue of its gc thread.
+  // # overflow_unlink_queues == # gc_threads
+  std::vector<std::shared_ptr<peloton::LockFreeQueue<std::shared_ptr<GarbageContext>>>> overflow_unlink_queues_;
   
   // local queues for to-be-unlinked tuples.
   // # local_unlink_queues == # gc_threads
   std::vector<std::list<std::shared_ptr<GarbageContext>>> local_unlink_queues_;
 
-  // multimaps for to-be-reclaimed tuples.
-  // The key is the timestamp when the garbage is identified, value is the
-  // metadata of the garbage.
-  // # reclaim_maps == # gc_threads
-  std::vector<std::multimap<cid_t, std::shared_ptr<GarbageContext>>> reclaim_maps_;
+  // queues for to-be-reclaimed tuples, bucketed by the epoch that was
+  // current when the garbage was unlinked. the epochs only grow, so the
+  // buckets are in epoch order.
+  // # reclaim_queues == # gc_threads
+  std::vector<std::deque<ReclaimBucket>> reclaim_queues_;
+
+  // # of garbage contexts in the local unlink queue and the reclaim queue
+  // of each gc thread, published by the thread for the others to read.
+  // # held_garbage_counts == # gc_threads
+  std::vector<std::atomic<size_t>> held_garbage_counts_;
+
+  // # of versions whose slots were reset for reuse
+  std::atomic<size_t> reclaimed_version_count_;
 
   // queues for to-be-reused tuples.
   // # recycle_queue_maps == # tables
-  std::unordered_map<oid_t, std::shared_ptr<peloton::LockFreeQueue<ItemPointer>>> recycle_queue_map_;
+  // each queue holds the ids of the table's tile groups that have recycled
+  // slots. the slots themselves are tracked by the tile group headers.
+  std::unordered_map<oid_t, std::shared_ptr<peloton::LockFreeQueue<oid_t>>> recycle_queue_map_;
 
 };
 }
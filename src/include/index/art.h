@@ -0,0 +1,1618 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// art.h
+//
+// Identification: src/include/index/art.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace peloton {
+namespace index {
+
+/*
+ * ART_TEMPLATE_ARGUMENTS - Save some key strokes
+ */
+#define ART_TEMPLATE_ARGUMENTS                                            \
+  template <typename KeyType, typename ValueType, typename KeyComparator, \
+            typename KeyEqualityChecker, typename ValueEqualityChecker>
+
+/*
+ * class ART - Adaptive radix tree of keys and their values
+ *
+ * The tree branches on the bytes of KeyType::GetRawData(), which must order
+ * like the keys do, as the big endian and sign flipped integers of
+ * CompactIntsKey, and every key is KeyType::key_size_byte long. An inner node
+ * has 4, 16, 48 or 256 children and is replaced by the next size once it is
+ * full. The bytes all keys below a node share are stored in its prefix, and a
+ * key no other key shares the next byte with is a leaf right away.
+ *
+ * Inner nodes follow optimistic lock coupling. A reader records the version
+ * of a node, reads it and then checks the version is unchanged, restarting
+ * from the root if it is not. A writer locks the nodes it changes, which bumps
+ * their versions, and a replaced node is marked obsolete. A leaf holds the
+ * values of its key under its own latch, so values are added and removed
+ * without locking the node above it. The leaf of a key goes with its last
+ * value. Replaced nodes and removed leaves are freed by the epoch manager, and
+ * inner nodes are not shrunk.
+ *
+ * With unique keys Insert() rejects a key that already has a value, while
+ * ConditionalInsert() leaves that decision to its predicate, as in SkipList.
+ * The same pair is never inserted twice.
+ */
+ART_TEMPLATE_ARGUMENTS
+class ART {
+ public:
+  using KeyValuePair = std::pair<KeyType, ValueType>;
+
+  // Number of key bytes the tree branches on
+  constexpr static size_t KEY_LENGTH = KeyType::key_size_byte;
+
+  // Nodes freed between two garbage collections done by the writers
+  constexpr static size_t GC_THRESHOLD = 1024;
+
+  class ForwardIterator;
+
+ private:
+  // The low bits of the version of a node, the rest counts the changes
+  constexpr static uint64_t OBSOLETE_BIT = 1UL;
+  constexpr static uint64_t LOCKED_BIT = 2UL;
+
+  enum class NodeType : uint8_t { NODE_4, NODE_16, NODE_48, NODE_256 };
+
+  /*
+   * struct ARTNode - The header of an inner node
+   *
+   * Readers go through the fields without locking, so they are all atomic
+   * and a read is only trusted once the version is checked after it
+   */
+  struct ARTNode {
+    std::atomic<uint64_t> version;
+
+    const NodeType type;
+
+    std::atomic<uint16_t> count;
+
+    std::atomic<uint32_t> prefix_length;
+
+    std::atomic<uint8_t> prefix[KEY_LENGTH];
+
+    ARTNode(NodeType p_type)
+        : version{0}, type{p_type}, count{0}, prefix_length{0} {
+      for (size_t i = 0; i < KEY_LENGTH; i++) {
+        prefix[i].store(0);
+      }
+    }
+  };
+
+  /*
+   * struct SortedNode - Node4 and Node16, whose key bytes are kept sorted
+   */
+  template <size_t CAPACITY>
+  struct SortedNode : public ARTNode {
+    std::atomic<uint8_t> keys[CAPACITY];
+
+    std::atomic<ARTNode *> children[CAPACITY];
+
+    SortedNode(NodeType p_type) : ARTNode{p_type} {
+      for (size_t i = 0; i < CAPACITY; i++) {
+        keys[i].store(0);
+        children[i].store(nullptr);
+      }
+    }
+  };
+
+  using Node4 = SortedNode<4>;
+  using Node16 = SortedNode<16>;
+
+  /*
+   * struct Node48 - A slot per child, found through the key byte
+   */
+  struct Node48 : public ARTNode {
+    // The slot of the child of a key byte plus one, 0 for no child
+    std::atomic<uint8_t> child_index[256];
+
+    std::atomic<ARTNode *> children[48];
+
+    Node48() : ARTNode{NodeType::NODE_48} {
+      for (size_t i = 0; i < 256; i++) {
+        child_index[i].store(0);
+      }
+      for (size_t i = 0; i < 48; i++) {
+        children[i].store(nullptr);
+      }
+    }
+  };
+
+  /*
+   * struct Node256 - A child per key byte
+   */
+  struct Node256 : public ARTNode {
+    std::atomic<ARTNode *> children[256];
+
+    Node256() : ARTNode{NodeType::NODE_256} {
+      for (size_t i = 0; i < 256; i++) {
+        children[i].store(nullptr);
+      }
+    }
+  };
+
+  /*
+   * struct ARTLeaf - A key and its values
+   *
+   * Child pointers to leaves have their low bit set
+   */
+  struct ARTLeaf {
+    const KeyType key;
+
+    std::atomic<bool> latch;
+
+    // Set under the latch and the lock of the node above the leaf when the
+    // leaf is removed
+    bool is_deleted;
+
+    std::vector<ValueType> values;
+
+    ARTLeaf(const KeyType &p_key, const ValueType &value)
+        : key{p_key}, latch{false}, is_deleted{false}, values{value} {}
+  };
+
+  static inline bool IsLeaf(const ARTNode *node_p) {
+    return (reinterpret_cast<uintptr_t>(node_p) & 1UL) != 0;
+  }
+
+  static inline ARTNode *ToChild(const ARTLeaf *leaf_p) {
+    return reinterpret_cast<ARTNode *>(reinterpret_cast<uintptr_t>(leaf_p) |
+                                       1UL);
+  }
+
+  static inline ARTLeaf *ToLeaf(const ARTNode *node_p) {
+    return reinterpret_cast<ARTLeaf *>(reinterpret_cast<uintptr_t>(node_p) &
+                                       ~1UL);
+  }
+
+  static inline void LockLeaf(ARTLeaf *leaf_p) {
+    while (leaf_p->latch.exchange(true) == true) {
+      std::this_thread::yield();
+    }
+  }
+
+  static inline void UnlockLeaf(ARTLeaf *leaf_p) { leaf_p->latch.store(false); }
+
+  /*
+   * ReadLock() - Record the version of a node, waiting out its writer
+   *
+   * Returns false if the node is obsolete
+   */
+  static inline bool ReadLock(ARTNode *node_p, uint64_t &version) {
+    version = node_p->version.load();
+    while ((version & LOCKED_BIT) != 0) {
+      std::this_thread::yield();
+      version = node_p->version.load();
+    }
+    return (version & OBSOLETE_BIT) == 0;
+  }
+
+  /*
+   * Validate() - Whether a node is unchanged since its version was recorded
+   */
+  static inline bool Validate(ARTNode *node_p, uint64_t version) {
+    return node_p->version.load() == version;
+  }
+
+  /*
+   * UpgradeLock() - Lock a node unless it changed since its version was
+   *                 recorded
+   */
+  static inline bool UpgradeLock(ARTNode *node_p, uint64_t version) {
+    return node_p->version.compare_exchange_strong(version,
+                                                   version + LOCKED_BIT);
+  }
+
+  // Clears the lock bit and counts the change
+  static inline void Unlock(ARTNode *node_p) {
+    node_p->version.fetch_add(LOCKED_BIT);
+  }
+
+  static inline void UnlockObsolete(ARTNode *node_p) {
+    node_p->version.fetch_add(LOCKED_BIT | OBSOLETE_BIT);
+  }
+
+ public:
+  /*
+   * class EpochManager - Maintains a linked list of replaced nodes and
+   *                      removed leaves until all threads entering epochs
+   *                      before they were unlinked have exited
+   *
+   * This follows the epoch manager of the SkipList. The garbage collection
+   * is not thread-safe, the tree runs one at a time.
+   */
+  class EpochManager {
+   public:
+    // The epoch counter is decreased by this while its epoch is freed
+    constexpr static int CLEARING_THREAD_COUNT = 0x7FFFFFFF;
+
+    /*
+     * struct GarbageNode - A linked list of garbages
+     */
+    struct GarbageNode {
+      // An inner node, or a leaf with the low bit set
+      ARTNode *node_p;
+
+      // Only the head of the garbage list is contended
+      GarbageNode *next_p;
+    };
+
+    /*
+     * struct EpochNode - A linked list of epoch node that records thread count
+     *
+     * This struct is also the head of garbage node linked list, which worker
+     * threads CAS their garbage nodes onto
+     */
+    struct EpochNode {
+      std::atomic<int> active_thread_count;
+
+      std::atomic<GarbageNode *> garbage_list_p;
+
+      // Only maintained by the garbage collection
+      EpochNode *next_p;
+    };
+
+    EpochManager(ART *p_tree_p) : tree_p{p_tree_p} {
+      current_epoch_p = new EpochNode{};
+      current_epoch_p.load()->active_thread_count = 0;
+      current_epoch_p.load()->garbage_list_p = nullptr;
+      current_epoch_p.load()->next_p = nullptr;
+
+      head_epoch_p = current_epoch_p.load();
+
+      garbage_count = 0;
+    }
+
+    /*
+     * Destructor - Free the garbage of every epoch
+     *
+     * No thread is in an epoch any more
+     */
+    ~EpochManager() {
+      // So that the head epoch is never the current one
+      current_epoch_p = nullptr;
+
+      ClearEpoch();
+
+      assert(head_epoch_p == nullptr);
+    }
+
+    /*
+     * JoinEpoch() - Let current thread join this epoch
+     *
+     * The nodes unlinked on and after the epoch are not freed before the
+     * thread leaves it
+     */
+    inline EpochNode *JoinEpoch() {
+      while (true) {
+        // The epoch joined must be the one returned
+        EpochNode *epoch_p = current_epoch_p.load();
+
+        int prev_count = epoch_p->active_thread_count.fetch_add(1);
+
+        // The epoch is being freed, and the current epoch has moved on
+        if (prev_count < 0) {
+          epoch_p->active_thread_count.fetch_sub(1);
+          continue;
+        }
+
+        return epoch_p;
+      }
+    }
+
+    /*
+     * LeaveEpoch() - Leave epoch a thread has once joined
+     */
+    inline void LeaveEpoch(EpochNode *epoch_p) {
+      epoch_p->active_thread_count.fetch_sub(1);
+    }
+
+    /*
+     * AddGarbageNode() - Add an unlinked node into the current epoch
+     *
+     * The current epoch cannot be freed, since the calling thread is in an
+     * epoch no later than it
+     */
+    void AddGarbageNode(ARTNode *node_p) {
+      EpochNode *epoch_p = current_epoch_p.load();
+
+      GarbageNode *garbage_node_p = new GarbageNode;
+      garbage_node_p->node_p = node_p;
+      garbage_node_p->next_p = epoch_p->garbage_list_p.load();
+
+      // If the CAS fails next_p is reloaded with the head
+      while (epoch_p->garbage_list_p.compare_exchange_strong(
+                 garbage_node_p->next_p, garbage_node_p) == false) {
+      }
+
+      garbage_count.fetch_add(1);
+    }
+
+    /*
+     * CreateNewEpoch() - Create a new epoch node
+     */
+    void CreateNewEpoch() {
+      EpochNode *epoch_node_p = new EpochNode{};
+      epoch_node_p->active_thread_count = 0;
+      epoch_node_p->garbage_list_p = nullptr;
+      epoch_node_p->next_p = nullptr;
+
+      current_epoch_p.load()->next_p = epoch_node_p;
+      current_epoch_p = epoch_node_p;
+    }
+
+    /*
+     * ClearEpoch() - Sweep the chain of epoch and free memory
+     *
+     * The epochs are freed in order, until one is current or some thread
+     * is still in it
+     */
+    void ClearEpoch() {
+      while (head_epoch_p != nullptr) {
+        if (head_epoch_p == current_epoch_p.load()) {
+          break;
+        }
+
+        if (head_epoch_p->active_thread_count.load() != 0) {
+          break;
+        }
+
+        // A thread joined since the check. Those joining after this see a
+        // negative count and retry
+        if (head_epoch_p->active_thread_count.fetch_sub(
+                CLEARING_THREAD_COUNT) > 0) {
+          head_epoch_p->active_thread_count.fetch_add(CLEARING_THREAD_COUNT);
+          break;
+        }
+
+        GarbageNode *next_garbage_node_p = nullptr;
+        for (GarbageNode *garbage_node_p = head_epoch_p->garbage_list_p.load();
+             garbage_node_p != nullptr;
+             garbage_node_p = next_garbage_node_p) {
+          tree_p->FreeNode(garbage_node_p->node_p);
+
+          next_garbage_node_p = garbage_node_p->next_p;
+          delete garbage_node_p;
+
+          garbage_count.fetch_sub(1);
+        }
+
+        EpochNode *next_epoch_node_p = head_epoch_p->next_p;
+        delete head_epoch_p;
+        head_epoch_p = next_epoch_node_p;
+      }
+    }
+
+    /*
+     * PerformGarbageCollection() - Free the epochs no thread is left in,
+     *                              then start a new one
+     */
+    void PerformGarbageCollection() {
+      ClearEpoch();
+      CreateNewEpoch();
+    }
+
+    size_t GetGarbageCount() const { return garbage_count.load(); }
+
+   private:
+    ART *tree_p;
+
+    // Only accessed by the garbage collection
+    EpochNode *head_epoch_p;
+
+    std::atomic<EpochNode *> current_epoch_p;
+
+    // Nodes waiting to be freed
+    std::atomic<size_t> garbage_count;
+  };
+
+  /*
+   * class ForwardIterator - Iterates the pairs in key order
+   *
+   * The iterator copies the values of a key at a time, and keeps the path of
+   * nodes down to its leaf with their versions to move on to the next key.
+   * If a node on the path changed meanwhile, the next key is searched for
+   * from the root. The iterator stays in an epoch for its lifetime so the
+   * nodes of the path are never freed.
+   */
+  class ForwardIterator {
+   public:
+    ForwardIterator(ART *p_tree_p)
+        : tree_p{p_tree_p},
+          epoch_node_p{p_tree_p->epoch_manager.JoinEpoch()},
+          pair_index{0} {}
+
+    ForwardIterator(const ForwardIterator &other)
+        : tree_p{other.tree_p},
+          epoch_node_p{other.tree_p->epoch_manager.JoinEpoch()},
+          path{other.path},
+          key_pairs{other.key_pairs},
+          pair_index{other.pair_index} {}
+
+    ForwardIterator &operator=(const ForwardIterator &) = delete;
+
+    ~ForwardIterator() { tree_p->epoch_manager.LeaveEpoch(epoch_node_p); }
+
+    inline bool IsEnd() const { return key_pairs.empty(); }
+
+    inline const KeyValuePair &operator*() const {
+      return key_pairs[pair_index];
+    }
+
+    inline const KeyValuePair *operator->() const {
+      return &key_pairs[pair_index];
+    }
+
+    /*
+     * operator++ - Move to the next pair, of this key or the one after
+     */
+    inline ForwardIterator &operator++() {
+      if (pair_index + 1 < key_pairs.size()) {
+        pair_index++;
+      } else {
+        tree_p->LoadNextKey(*this);
+      }
+      return *this;
+    }
+
+   private:
+    friend class ART;
+
+    /*
+     * struct PathEntry - A node on the path and the key byte taken
+     */
+    struct PathEntry {
+      ARTNode *node_p;
+
+      uint64_t version;
+
+      uint8_t key_byte;
+    };
+
+    ART *tree_p;
+
+    typename EpochManager::EpochNode *epoch_node_p;
+
+    std::vector<PathEntry> path;
+
+    // The pairs of the current key, in insertion order
+    std::vector<KeyValuePair> key_pairs;
+
+    size_t pair_index;
+  };
+
+  ART(bool p_unique_keys, const KeyComparator &p_key_cmp_obj = KeyComparator{},
+      const KeyEqualityChecker &p_key_eq_obj = KeyEqualityChecker{},
+      const ValueEqualityChecker &p_value_eq_obj = ValueEqualityChecker{})
+      : unique_keys{p_unique_keys},
+        key_cmp_obj{p_key_cmp_obj},
+        key_eq_obj{p_key_eq_obj},
+        value_eq_obj{p_value_eq_obj},
+        memory_footprint{0},
+        gc_flag{false},
+        last_gc_garbage_count{0},
+        epoch_manager{this} {
+    // The root is never replaced, since it is never full and has no prefix
+    root_p = NewNode(NodeType::NODE_256);
+  }
+
+  /*
+   * Destructor - Free the nodes still in the tree
+   *
+   * No thread is using the tree any more. The garbage holds the nodes
+   * unlinked before, and is freed by the epoch manager
+   */
+  ~ART() { FreeSubtree(root_p); }
+
+  inline bool KeyCmpLess(const KeyType &key1, const KeyType &key2) const {
+    return key_cmp_obj(key1, key2);
+  }
+
+  inline bool KeyCmpEqual(const KeyType &key1, const KeyType &key2) const {
+    return key_eq_obj(key1, key2);
+  }
+
+  inline bool KeyCmpLessEqual(const KeyType &key1, const KeyType &key2) const {
+    return !KeyCmpLess(key2, key1);
+  }
+
+  inline bool ValueCmpEqual(const ValueType &value1,
+                            const ValueType &value2) const {
+    return value_eq_obj(value1, value2);
+  }
+
+  /*
+   * Insert() - Insert a pair
+   *
+   * Returns false if the pair is already in, or with unique keys if the key
+   * already has a value
+   */
+  bool Insert(const KeyType &key, const ValueType &value) {
+    bool predicate_satisfied = false;
+    return InsertPair(key, value, nullptr, &predicate_satisfied);
+  }
+
+  /*
+   * ConditionalInsert() - Insert a pair unless the predicate holds for a
+   *                       value of the key
+   *
+   * predicate_satisfied is set if the predicate held for some value.
+   * Returns false if the pair was not inserted
+   */
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const void *)> predicate,
+                         bool *predicate_satisfied) {
+    *predicate_satisfied = false;
+    return InsertPair(key, value, predicate, predicate_satisfied);
+  }
+
+  /*
+   * Delete() - Delete a pair
+   *
+   * Returns false if the pair is not in
+   */
+  bool Delete(const KeyType &key, const ValueType &value) {
+    auto epoch_node_p = epoch_manager.JoinEpoch();
+
+    bool is_deleted = false;
+    while (TryDelete(key, value, is_deleted) == false) {
+    }
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+
+    CollectGarbageIfNeeded();
+
+    return is_deleted;
+  }
+
+  /*
+   * GetValue() - Fill the values of a key
+   */
+  void GetValue(const KeyType &search_key, std::vector<ValueType> &value_list) {
+    auto epoch_node_p = epoch_manager.JoinEpoch();
+
+    ARTLeaf *leaf_p = nullptr;
+    while (TryFindLeaf(search_key, leaf_p) == false) {
+    }
+
+    // A leaf removed since it was found has no values left
+    if (leaf_p != nullptr) {
+      LockLeaf(leaf_p);
+      if (leaf_p->is_deleted == false) {
+        value_list.insert(value_list.end(), leaf_p->values.begin(),
+                          leaf_p->values.end());
+      }
+      UnlockLeaf(leaf_p);
+    }
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+  }
+
+  /*
+   * Begin() - The iterator on the first pair
+   */
+  ForwardIterator Begin() {
+    ForwardIterator itr{this};
+    while (LoadFirstKey(nullptr, true, itr) == false) {
+    }
+    return itr;
+  }
+
+  /*
+   * Begin() - The iterator on the first pair not less than the key
+   */
+  ForwardIterator Begin(const KeyType &start_key) {
+    ForwardIterator itr{this};
+    while (LoadFirstKey(&start_key, true, itr) == false) {
+    }
+    return itr;
+  }
+
+  /*
+   * NeedGarbageCollection() - Whether there are unlinked nodes to free
+   */
+  bool NeedGarbageCollection() const {
+    return epoch_manager.GetGarbageCount() > 0;
+  }
+
+  /*
+   * PerformGarbageCollection() - Free the unlinked nodes no thread sees
+   *
+   * Skipped if another thread is collecting
+   */
+  void PerformGarbageCollection() {
+    if (gc_flag.exchange(true) == true) {
+      return;
+    }
+
+    epoch_manager.PerformGarbageCollection();
+    last_gc_garbage_count = epoch_manager.GetGarbageCount();
+
+    gc_flag.store(false);
+  }
+
+  /*
+   * GetMemoryFootprint() - Bytes of the nodes and leaves, freed or not
+   */
+  size_t GetMemoryFootprint() const { return memory_footprint.load(); }
+
+ private:
+  static inline uint8_t KeyByte(const KeyType &key, size_t depth) {
+    return key.GetRawData()[depth];
+  }
+
+  /*
+   * GetPrefixLength() - Length of the prefix of a node at the depth
+   *
+   * A length read while the node changes may run past the key, which the
+   * check of the version catches later
+   */
+  static inline size_t GetPrefixLength(ARTNode *node_p, size_t depth) {
+    size_t prefix_length = node_p->prefix_length.load();
+    if (depth + prefix_length >= KEY_LENGTH) {
+      prefix_length = KEY_LENGTH - 1 - depth;
+    }
+    return prefix_length;
+  }
+
+  /*
+   * PrefixMismatch() - The first byte of the prefix the key differs in, or
+   *                    the length of the prefix if it matches
+   */
+  static inline size_t PrefixMismatch(ARTNode *node_p, const KeyType &key,
+                                      size_t depth, size_t prefix_length) {
+    for (size_t i = 0; i < prefix_length; i++) {
+      if (node_p->prefix[i].load() != KeyByte(key, depth + i)) {
+        return i;
+      }
+    }
+    return prefix_length;
+  }
+
+  static inline void SetPrefix(ARTNode *node_p, const KeyType &key,
+                               size_t depth, size_t prefix_length) {
+    for (size_t i = 0; i < prefix_length; i++) {
+      node_p->prefix[i].store(KeyByte(key, depth + i));
+    }
+    node_p->prefix_length.store(prefix_length);
+  }
+
+  /*
+   * FindChild() - The child of a key byte, nullptr if there is none
+   */
+  static ARTNode *FindChild(ARTNode *node_p, uint8_t key_byte) {
+    switch (node_p->type) {
+      case NodeType::NODE_4:
+        return FindSortedChild(static_cast<Node4 *>(node_p), key_byte);
+      case NodeType::NODE_16:
+        return FindSortedChild(static_cast<Node16 *>(node_p), key_byte);
+      case NodeType::NODE_48: {
+        Node48 *node48_p = static_cast<Node48 *>(node_p);
+        uint8_t slot = node48_p->child_index[key_byte].load();
+        return slot == 0 ? nullptr : node48_p->children[slot - 1].load();
+      }
+      case NodeType::NODE_256:
+        return static_cast<Node256 *>(node_p)->children[key_byte].load();
+    }
+    return nullptr;
+  }
+
+  template <size_t CAPACITY>
+  static ARTNode *FindSortedChild(SortedNode<CAPACITY> *node_p,
+                                  uint8_t key_byte) {
+    size_t count = node_p->count.load();
+    for (size_t i = 0; i < count && i < CAPACITY; i++) {
+      if (node_p->keys[i].load() == key_byte) {
+        return node_p->children[i].load();
+      }
+    }
+    return nullptr;
+  }
+
+  /*
+   * FindChildAtLeast() - The child of the first key byte not less than the
+   *                      one given, nullptr if there is none
+   *
+   * That key byte is returned in found_byte
+   */
+  static ARTNode *FindChildAtLeast(ARTNode *node_p, uint8_t key_byte,
+                                   uint8_t &found_byte) {
+    switch (node_p->type) {
+      case NodeType::NODE_4:
+        return FindSortedChildAtLeast(static_cast<Node4 *>(node_p), key_byte,
+                                      found_byte);
+      case NodeType::NODE_16:
+        return FindSortedChildAtLeast(static_cast<Node16 *>(node_p), key_byte,
+                                      found_byte);
+      case NodeType::NODE_48: {
+        Node48 *node48_p = static_cast<Node48 *>(node_p);
+        for (size_t byte = key_byte; byte < 256; byte++) {
+          uint8_t slot = node48_p->child_index[byte].load();
+          if (slot != 0) {
+            found_byte = static_cast<uint8_t>(byte);
+            return node48_p->children[slot - 1].load();
+          }
+        }
+        return nullptr;
+      }
+      case NodeType::NODE_256: {
+        Node256 *node256_p = static_cast<Node256 *>(node_p);
+        for (size_t byte = key_byte; byte < 256; byte++) {
+          ARTNode *child_p = node256_p->children[byte].load();
+          if (child_p != nullptr) {
+            found_byte = static_cast<uint8_t>(byte);
+            return child_p;
+          }
+        }
+        return nullptr;
+      }
+    }
+    return nullptr;
+  }
+
+  template <size_t CAPACITY>
+  static ARTNode *FindSortedChildAtLeast(SortedNode<CAPACITY> *node_p,
+                                         uint8_t key_byte,
+                                         uint8_t &found_byte) {
+    size_t count = node_p->count.load();
+    for (size_t i = 0; i < count && i < CAPACITY; i++) {
+      uint8_t byte = node_p->keys[i].load();
+      if (byte >= key_byte) {
+        found_byte = byte;
+        return node_p->children[i].load();
+      }
+    }
+    return nullptr;
+  }
+
+  static bool IsFull(const ARTNode *node_p) {
+    switch (node_p->type) {
+      case NodeType::NODE_4:
+        return node_p->count.load() == 4;
+      case NodeType::NODE_16:
+        return node_p->count.load() == 16;
+      case NodeType::NODE_48:
+        return node_p->count.load() == 48;
+      case NodeType::NODE_256:
+        return false;
+    }
+    return false;
+  }
+
+  /*
+   * InsertChild() - Add the child of a new key byte to a node not full
+   *
+   * The node is locked or not linked yet
+   */
+  static void InsertChild(ARTNode *node_p, uint8_t key_byte,
+                          ARTNode *child_p) {
+    switch (node_p->type) {
+      case NodeType::NODE_4:
+        InsertSortedChild(static_cast<Node4 *>(node_p), key_byte, child_p);
+        break;
+      case NodeType::NODE_16:
+        InsertSortedChild(static_cast<Node16 *>(node_p), key_byte, child_p);
+        break;
+      case NodeType::NODE_48: {
+        Node48 *node48_p = static_cast<Node48 *>(node_p);
+        size_t slot = 0;
+        while (node48_p->children[slot].load() != nullptr) {
+          slot++;
+        }
+        node48_p->children[slot].store(child_p);
+        node48_p->child_index[key_byte].store(static_cast<uint8_t>(slot + 1));
+        node_p->count.fetch_add(1);
+        break;
+      }
+      case NodeType::NODE_256:
+        static_cast<Node256 *>(node_p)->children[key_byte].store(child_p);
+        node_p->count.fetch_add(1);
+        break;
+    }
+  }
+
+  template <size_t CAPACITY>
+  static void InsertSortedChild(SortedNode<CAPACITY> *node_p, uint8_t key_byte,
+                                ARTNode *child_p) {
+    size_t count = node_p->count.load();
+    size_t position = count;
+    while (position > 0 && node_p->keys[position - 1].load() > key_byte) {
+      node_p->keys[position].store(node_p->keys[position - 1].load());
+      node_p->children[position].store(node_p->children[position - 1].load());
+      position--;
+    }
+    node_p->keys[position].store(key_byte);
+    node_p->children[position].store(child_p);
+    node_p->count.store(count + 1);
+  }
+
+  /*
+   * ChangeChild() - Replace the child of a key byte, the node is locked
+   */
+  static void ChangeChild(ARTNode *node_p, uint8_t key_byte,
+                          ARTNode *child_p) {
+    switch (node_p->type) {
+      case NodeType::NODE_4:
+        ChangeSortedChild(static_cast<Node4 *>(node_p), key_byte, child_p);
+        break;
+      case NodeType::NODE_16:
+        ChangeSortedChild(static_cast<Node16 *>(node_p), key_byte, child_p);
+        break;
+      case NodeType::NODE_48: {
+        Node48 *node48_p = static_cast<Node48 *>(node_p);
+        uint8_t slot = node48_p->child_index[key_byte].load();
+        assert(slot != 0);
+        node48_p->children[slot - 1].store(child_p);
+        break;
+      }
+      case NodeType::NODE_256:
+        static_cast<Node256 *>(node_p)->children[key_byte].store(child_p);
+        break;
+    }
+  }
+
+  template <size_t CAPACITY>
+  static void ChangeSortedChild(SortedNode<CAPACITY> *node_p, uint8_t key_byte,
+                                ARTNode *child_p) {
+    size_t count = node_p->count.load();
+    for (size_t i = 0; i < count; i++) {
+      if (node_p->keys[i].load() == key_byte) {
+        node_p->children[i].store(child_p);
+        return;
+      }
+    }
+    assert(false);
+  }
+
+  /*
+   * RemoveChild() - Remove the child of a key byte, the node is locked
+   */
+  static void RemoveChild(ARTNode *node_p, uint8_t key_byte) {
+    switch (node_p->type) {
+      case NodeType::NODE_4:
+        RemoveSortedChild(static_cast<Node4 *>(node_p), key_byte);
+        break;
+      case NodeType::NODE_16:
+        RemoveSortedChild(static_cast<Node16 *>(node_p), key_byte);
+        break;
+      case NodeType::NODE_48: {
+        Node48 *node48_p = static_cast<Node48 *>(node_p);
+        uint8_t slot = node48_p->child_index[key_byte].load();
+        assert(slot != 0);
+        node48_p->child_index[key_byte].store(0);
+        node48_p->children[slot - 1].store(nullptr);
+        node_p->count.fetch_sub(1);
+        break;
+      }
+      case NodeType::NODE_256:
+        static_cast<Node256 *>(node_p)->children[key_byte].store(nullptr);
+        node_p->count.fetch_sub(1);
+        break;
+    }
+  }
+
+  template <size_t CAPACITY>
+  static void RemoveSortedChild(SortedNode<CAPACITY> *node_p,
+                                uint8_t key_byte) {
+    size_t count = node_p->count.load();
+    size_t position = 0;
+    while (node_p->keys[position].load() != key_byte) {
+      position++;
+    }
+    for (; position + 1 < count; position++) {
+      node_p->keys[position].store(node_p->keys[position + 1].load());
+      node_p->children[position].store(node_p->children[position + 1].load());
+    }
+    node_p->children[count - 1].store(nullptr);
+    node_p->count.store(count - 1);
+  }
+
+  /*
+   * Grow() - A copy of a full node with room for more children
+   */
+  ARTNode *Grow(ARTNode *node_p) {
+    ARTNode *new_node_p = nullptr;
+    switch (node_p->type) {
+      case NodeType::NODE_4:
+        new_node_p = NewNode(NodeType::NODE_16);
+        break;
+      case NodeType::NODE_16:
+        new_node_p = NewNode(NodeType::NODE_48);
+        break;
+      default:
+        new_node_p = NewNode(NodeType::NODE_256);
+        break;
+    }
+
+    size_t prefix_length = node_p->prefix_length.load();
+    for (size_t i = 0; i < prefix_length; i++) {
+      new_node_p->prefix[i].store(node_p->prefix[i].load());
+    }
+    new_node_p->prefix_length.store(prefix_length);
+
+    uint8_t key_byte = 0;
+    for (ARTNode *child_p = FindChildAtLeast(node_p, 0, key_byte);
+         child_p != nullptr;
+         child_p = key_byte == 255
+                       ? nullptr
+                       : FindChildAtLeast(node_p, key_byte + 1, key_byte)) {
+      InsertChild(new_node_p, key_byte, child_p);
+    }
+
+    return new_node_p;
+  }
+
+  /*
+   * InsertPair() - Insert a pair, restarting from the root until a pass
+   *                gets through without a conflict
+   *
+   * A predicate of nullptr inserts unconditionally
+   */
+  bool InsertPair(const KeyType &key, const ValueType &value,
+                  const std::function<bool(const void *)> &predicate,
+                  bool *predicate_satisfied) {
+    auto epoch_node_p = epoch_manager.JoinEpoch();
+
+    bool is_inserted = false;
+    while (TryInsert(key, value, predicate, predicate_satisfied,
+                     is_inserted) == false) {
+    }
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+
+    CollectGarbageIfNeeded();
+
+    return is_inserted;
+  }
+
+  /*
+   * TryInsert() - One pass of InsertPair(), false if it has to restart
+   */
+  bool TryInsert(const KeyType &key, const ValueType &value,
+                 const std::function<bool(const void *)> &predicate,
+                 bool *predicate_satisfied, bool &is_inserted) {
+    ARTNode *parent_p = nullptr;
+    uint64_t parent_version = 0;
+    uint8_t parent_key_byte = 0;
+
+    ARTNode *node_p = root_p;
+    uint64_t version = 0;
+    if (ReadLock(node_p, version) == false) {
+      return false;
+    }
+
+    size_t depth = 0;
+    while (true) {
+      if (depth >= KEY_LENGTH) {
+        return false;
+      }
+
+      // The key parts from the prefix, so a new node above takes the bytes
+      // before that and branches to the node and the new leaf
+      size_t prefix_length = GetPrefixLength(node_p, depth);
+      size_t mismatch = PrefixMismatch(node_p, key, depth, prefix_length);
+      if (mismatch < prefix_length) {
+        assert(parent_p != nullptr);
+        if (UpgradeLock(parent_p, parent_version) == false) {
+          return false;
+        }
+        if (UpgradeLock(node_p, version) == false) {
+          Unlock(parent_p);
+          return false;
+        }
+
+        ARTNode *new_node_p = NewNode(NodeType::NODE_4);
+        SetPrefix(new_node_p, key, depth, mismatch);
+        InsertChild(new_node_p, node_p->prefix[mismatch].load(), node_p);
+        InsertChild(new_node_p, KeyByte(key, depth + mismatch),
+                    ToChild(NewLeaf(key, value)));
+
+        // The node keeps the bytes after the one branched on
+        for (size_t i = mismatch + 1; i < prefix_length; i++) {
+          node_p->prefix[i - mismatch - 1].store(node_p->prefix[i].load());
+        }
+        node_p->prefix_length.store(prefix_length - mismatch - 1);
+
+        ChangeChild(parent_p, parent_key_byte, new_node_p);
+        Unlock(node_p);
+        Unlock(parent_p);
+
+        is_inserted = true;
+        return true;
+      }
+      depth += prefix_length;
+
+      uint8_t key_byte = KeyByte(key, depth);
+      ARTNode *child_p = FindChild(node_p, key_byte);
+      if (Validate(node_p, version) == false) {
+        return false;
+      }
+
+      if (child_p == nullptr) {
+        if (IsFull(node_p) == true) {
+          // The parent is locked too, since the node is replaced below it
+          assert(parent_p != nullptr);
+          if (UpgradeLock(parent_p, parent_version) == false) {
+            return false;
+          }
+          if (UpgradeLock(node_p, version) == false) {
+            Unlock(parent_p);
+            return false;
+          }
+
+          ARTNode *new_node_p = Grow(node_p);
+          InsertChild(new_node_p, key_byte, ToChild(NewLeaf(key, value)));
+          ChangeChild(parent_p, parent_key_byte, new_node_p);
+          UnlockObsolete(node_p);
+          Unlock(parent_p);
+
+          epoch_manager.AddGarbageNode(node_p);
+        } else {
+          if (UpgradeLock(node_p, version) == false) {
+            return false;
+          }
+          InsertChild(node_p, key_byte, ToChild(NewLeaf(key, value)));
+          Unlock(node_p);
+        }
+
+        is_inserted = true;
+        return true;
+      }
+
+      if (IsLeaf(child_p) == true) {
+        ARTLeaf *leaf_p = ToLeaf(child_p);
+        if (KeyCmpEqual(leaf_p->key, key) == true) {
+          return InsertIntoLeaf(leaf_p, value, predicate, predicate_satisfied,
+                                is_inserted);
+        }
+
+        // The two keys share the bytes up to where they part, which a new
+        // node takes as its prefix to branch on the byte after
+        if (UpgradeLock(node_p, version) == false) {
+          return false;
+        }
+
+        size_t branch_depth = depth + 1;
+        while (branch_depth < KEY_LENGTH - 1 &&
+               KeyByte(leaf_p->key, branch_depth) ==
+                   KeyByte(key, branch_depth)) {
+          branch_depth++;
+        }
+
+        ARTNode *new_node_p = NewNode(NodeType::NODE_4);
+        SetPrefix(new_node_p, key, depth + 1, branch_depth - depth - 1);
+        InsertChild(new_node_p, KeyByte(leaf_p->key, branch_depth), child_p);
+        InsertChild(new_node_p, KeyByte(key, branch_depth),
+                    ToChild(NewLeaf(key, value)));
+        ChangeChild(node_p, key_byte, new_node_p);
+        Unlock(node_p);
+
+        is_inserted = true;
+        return true;
+      }
+
+      // The node is checked again as a split could have put a new node
+      // between it and the child meanwhile
+      uint64_t child_version = 0;
+      if (ReadLock(child_p, child_version) == false ||
+          Validate(node_p, version) == false) {
+        return false;
+      }
+
+      parent_p = node_p;
+      parent_version = version;
+      parent_key_byte = key_byte;
+
+      node_p = child_p;
+      version = child_version;
+      depth++;
+    }
+  }
+
+  /*
+   * InsertIntoLeaf() - Add a value to the leaf of its key
+   *
+   * Returns false if the leaf got removed, so the insert restarts
+   */
+  bool InsertIntoLeaf(ARTLeaf *leaf_p, const ValueType &value,
+                      const std::function<bool(const void *)> &predicate,
+                      bool *predicate_satisfied, bool &is_inserted) {
+    LockLeaf(leaf_p);
+    if (leaf_p->is_deleted == true) {
+      UnlockLeaf(leaf_p);
+      return false;
+    }
+
+    is_inserted = true;
+    for (const ValueType &leaf_value : leaf_p->values) {
+      if (predicate != nullptr) {
+        if (predicate(leaf_value) == true) {
+          *predicate_satisfied = true;
+          is_inserted = false;
+          break;
+        }
+      } else if (unique_keys == true) {
+        is_inserted = false;
+        break;
+      }
+
+      if (ValueCmpEqual(leaf_value, value) == true) {
+        is_inserted = false;
+        break;
+      }
+    }
+
+    if (is_inserted == true) {
+      leaf_p->values.push_back(value);
+      memory_footprint.fetch_add(sizeof(ValueType));
+    }
+
+    UnlockLeaf(leaf_p);
+    return true;
+  }
+
+  /*
+   * TryDelete() - One pass of Delete(), false if it has to restart
+   */
+  bool TryDelete(const KeyType &key, const ValueType &value,
+                 bool &is_deleted) {
+    ARTNode *node_p = root_p;
+    uint64_t version = 0;
+    if (ReadLock(node_p, version) == false) {
+      return false;
+    }
+
+    is_deleted = false;
+    size_t depth = 0;
+    while (true) {
+      if (depth >= KEY_LENGTH) {
+        return false;
+      }
+
+      size_t prefix_length = GetPrefixLength(node_p, depth);
+      if (PrefixMismatch(node_p, key, depth, prefix_length) < prefix_length) {
+        return Validate(node_p, version);
+      }
+      depth += prefix_length;
+
+      uint8_t key_byte = KeyByte(key, depth);
+      ARTNode *child_p = FindChild(node_p, key_byte);
+      if (Validate(node_p, version) == false) {
+        return false;
+      }
+
+      if (child_p == nullptr) {
+        return true;
+      }
+
+      if (IsLeaf(child_p) == true) {
+        ARTLeaf *leaf_p = ToLeaf(child_p);
+        if (KeyCmpEqual(leaf_p->key, key) == false) {
+          return true;
+        }
+
+        LockLeaf(leaf_p);
+        if (leaf_p->is_deleted == true) {
+          UnlockLeaf(leaf_p);
+          return false;
+        }
+
+        auto value_itr = leaf_p->values.begin();
+        while (value_itr != leaf_p->values.end() &&
+               ValueCmpEqual(*value_itr, value) == false) {
+          value_itr++;
+        }
+
+        if (value_itr == leaf_p->values.end()) {
+          UnlockLeaf(leaf_p);
+          return true;
+        }
+
+        if (leaf_p->values.size() > 1) {
+          leaf_p->values.erase(value_itr);
+          memory_footprint.fetch_sub(sizeof(ValueType));
+          UnlockLeaf(leaf_p);
+          is_deleted = true;
+          return true;
+        }
+
+        // The leaf goes with its last value. The node is locked with the
+        // leaf latched, which never waits, so no thread locking the other
+        // way round is deadlocked
+        if (UpgradeLock(node_p, version) == false) {
+          UnlockLeaf(leaf_p);
+          return false;
+        }
+
+        leaf_p->is_deleted = true;
+        UnlockLeaf(leaf_p);
+
+        RemoveChild(node_p, key_byte);
+        Unlock(node_p);
+
+        epoch_manager.AddGarbageNode(child_p);
+
+        is_deleted = true;
+        return true;
+      }
+
+      uint64_t child_version = 0;
+      if (ReadLock(child_p, child_version) == false ||
+          Validate(node_p, version) == false) {
+        return false;
+      }
+
+      node_p = child_p;
+      version = child_version;
+      depth++;
+    }
+  }
+
+  /*
+   * TryFindLeaf() - Find the leaf of a key, nullptr if it has none
+   *
+   * Returns false if the search has to restart
+   */
+  bool TryFindLeaf(const KeyType &key, ARTLeaf *&leaf_p) {
+    ARTNode *node_p = root_p;
+    uint64_t version = 0;
+    if (ReadLock(node_p, version) == false) {
+      return false;
+    }
+
+    leaf_p = nullptr;
+    size_t depth = 0;
+    while (true) {
+      if (depth >= KEY_LENGTH) {
+        return false;
+      }
+
+      size_t prefix_length = GetPrefixLength(node_p, depth);
+      if (PrefixMismatch(node_p, key, depth, prefix_length) < prefix_length) {
+        return Validate(node_p, version);
+      }
+      depth += prefix_length;
+
+      ARTNode *child_p = FindChild(node_p, KeyByte(key, depth));
+      if (Validate(node_p, version) == false) {
+        return false;
+      }
+
+      if (child_p == nullptr) {
+        return true;
+      }
+
+      if (IsLeaf(child_p) == true) {
+        if (KeyCmpEqual(ToLeaf(child_p)->key, key) == true) {
+          leaf_p = ToLeaf(child_p);
+        }
+        return true;
+      }
+
+      uint64_t child_version = 0;
+      if (ReadLock(child_p, child_version) == false ||
+          Validate(node_p, version) == false) {
+        return false;
+      }
+
+      node_p = child_p;
+      version = child_version;
+      depth++;
+    }
+  }
+
+  /*
+   * LoadFirstKey() - Point the iterator at the first key not less than the
+   *                  bound, or greater than it if inclusive is not set
+   *
+   * Without a bound it is the first key. Returns false if the search has
+   * to restart
+   */
+  bool LoadFirstKey(const KeyType *bound_key_p, bool inclusive,
+                    ForwardIterator &itr) {
+    itr.path.clear();
+    itr.key_pairs.clear();
+    itr.pair_index = 0;
+
+    ARTNode *node_p = root_p;
+    uint64_t version = 0;
+    if (ReadLock(node_p, version) == false) {
+      return false;
+    }
+
+    // Whether the bytes down to here are those of the bound
+    bool on_bound = bound_key_p != nullptr;
+    size_t depth = 0;
+    while (true) {
+      if (depth >= KEY_LENGTH) {
+        return false;
+      }
+
+      size_t prefix_length = GetPrefixLength(node_p, depth);
+      if (on_bound == true) {
+        size_t mismatch =
+            PrefixMismatch(node_p, *bound_key_p, depth, prefix_length);
+        if (mismatch < prefix_length) {
+          uint8_t prefix_byte = node_p->prefix[mismatch].load();
+          if (Validate(node_p, version) == false) {
+            return false;
+          }
+
+          // The keys below are all before the bound, so continue after the
+          // node. Its parent is on top of the path, as the root has no prefix
+          if (prefix_byte < KeyByte(*bound_key_p, depth + mismatch)) {
+            return LoadNextLeaf(itr);
+          }
+          on_bound = false;
+        }
+      }
+      depth += prefix_length;
+
+      uint8_t start_byte = on_bound == true ? KeyByte(*bound_key_p, depth) : 0;
+      uint8_t key_byte = 0;
+      ARTNode *child_p = FindChildAtLeast(node_p, start_byte, key_byte);
+      if (Validate(node_p, version) == false) {
+        return false;
+      }
+
+      if (child_p == nullptr) {
+        return LoadNextLeaf(itr);
+      }
+
+      if (key_byte != start_byte) {
+        on_bound = false;
+      }
+      itr.path.push_back({node_p, version, key_byte});
+
+      if (IsLeaf(child_p) == true) {
+        ARTLeaf *leaf_p = ToLeaf(child_p);
+        if (on_bound == true &&
+            (KeyCmpLess(leaf_p->key, *bound_key_p) == true ||
+             (inclusive == false &&
+              KeyCmpEqual(leaf_p->key, *bound_key_p) == true))) {
+          return LoadNextLeaf(itr);
+        }
+
+        if (LoadLeaf(leaf_p, itr) == true) {
+          return true;
+        }
+        return LoadNextLeaf(itr);
+      }
+
+      uint64_t child_version = 0;
+      if (ReadLock(child_p, child_version) == false ||
+          Validate(node_p, version) == false) {
+        return false;
+      }
+
+      node_p = child_p;
+      version = child_version;
+      depth++;
+    }
+  }
+
+  /*
+   * LoadNextLeaf() - Point the iterator at the first leaf after the child
+   *                  taken by the node on top of its path
+   *
+   * The iterator is at the end once the path runs out. Returns false if a
+   * node on the path changed
+   */
+  bool LoadNextLeaf(ForwardIterator &itr) {
+    itr.key_pairs.clear();
+    itr.pair_index = 0;
+
+    while (itr.path.empty() == false) {
+      auto &entry = itr.path.back();
+
+      uint8_t key_byte = 0;
+      ARTNode *child_p = nullptr;
+      if (entry.key_byte != 255) {
+        child_p = FindChildAtLeast(entry.node_p, entry.key_byte + 1, key_byte);
+      }
+      if (Validate(entry.node_p, entry.version) == false) {
+        return false;
+      }
+
+      if (child_p == nullptr) {
+        itr.path.pop_back();
+        continue;
+      }
+      entry.key_byte = key_byte;
+
+      // Down the first children to a leaf. A node emptied by deletes is
+      // pushed as done, to be popped above
+      while (IsLeaf(child_p) == false) {
+        uint64_t version = 0;
+        if (ReadLock(child_p, version) == false ||
+            Validate(itr.path.back().node_p, itr.path.back().version) ==
+                false) {
+          return false;
+        }
+
+        ARTNode *first_child_p = FindChildAtLeast(child_p, 0, key_byte);
+        if (Validate(child_p, version) == false) {
+          return false;
+        }
+
+        if (first_child_p == nullptr) {
+          itr.path.push_back({child_p, version, 255});
+          break;
+        }
+
+        itr.path.push_back({child_p, version, key_byte});
+        child_p = first_child_p;
+      }
+
+      if (IsLeaf(child_p) == true && LoadLeaf(ToLeaf(child_p), itr) == true) {
+        return true;
+      }
+    }
+
+    return true;
+  }
+
+  /*
+   * LoadNextKey() - Point the iterator at the key after its current one
+   */
+  void LoadNextKey(ForwardIterator &itr) {
+    KeyType current_key = itr.key_pairs.front().first;
+    if (LoadNextLeaf(itr) == true) {
+      return;
+    }
+
+    while (LoadFirstKey(&current_key, false, itr) == false) {
+    }
+  }
+
+  /*
+   * LoadLeaf() - Copy the pairs of a leaf into the iterator
+   *
+   * Returns false if the leaf got removed
+   */
+  bool LoadLeaf(ARTLeaf *leaf_p, ForwardIterator &itr) {
+    LockLeaf(leaf_p);
+    if (leaf_p->is_deleted == false) {
+      for (const ValueType &value : leaf_p->values) {
+        itr.key_pairs.emplace_back(leaf_p->key, value);
+      }
+    }
+    UnlockLeaf(leaf_p);
+
+    return itr.key_pairs.empty() == false;
+  }
+
+  ARTNode *NewNode(NodeType type) {
+    ARTNode *node_p = nullptr;
+    switch (type) {
+      case NodeType::NODE_4:
+        node_p = new Node4{NodeType::NODE_4};
+        break;
+      case NodeType::NODE_16:
+        node_p = new Node16{NodeType::NODE_16};
+        break;
+      case NodeType::NODE_48:
+        node_p = new Node48{};
+        break;
+      case NodeType::NODE_256:
+        node_p = new Node256{};
+        break;
+    }
+    memory_footprint.fetch_add(GetNodeSize(type));
+    return node_p;
+  }
+
+  ARTLeaf *NewLeaf(const KeyType &key, const ValueType &value) {
+    memory_footprint.fetch_add(sizeof(ARTLeaf) + sizeof(ValueType));
+    return new ARTLeaf{key, value};
+  }
+
+  static size_t GetNodeSize(NodeType type) {
+    switch (type) {
+      case NodeType::NODE_4:
+        return sizeof(Node4);
+      case NodeType::NODE_16:
+        return sizeof(Node16);
+      case NodeType::NODE_48:
+        return sizeof(Node48);
+      case NodeType::NODE_256:
+        return sizeof(Node256);
+    }
+    return 0;
+  }
+
+  /*
+   * FreeNode() - Free an inner node or a leaf, but not the children
+   */
+  void FreeNode(ARTNode *node_p) {
+    if (IsLeaf(node_p) == true) {
+      ARTLeaf *leaf_p = ToLeaf(node_p);
+      memory_footprint.fetch_sub(sizeof(ARTLeaf) +
+                                 leaf_p->values.size() * sizeof(ValueType));
+      delete leaf_p;
+      return;
+    }
+
+    memory_footprint.fetch_sub(GetNodeSize(node_p->type));
+    switch (node_p->type) {
+      case NodeType::NODE_4:
+        delete static_cast<Node4 *>(node_p);
+        break;
+      case NodeType::NODE_16:
+        delete static_cast<Node16 *>(node_p);
+        break;
+      case NodeType::NODE_48:
+        delete static_cast<Node48 *>(node_p);
+        break;
+      case NodeType::NODE_256:
+        delete static_cast<Node256 *>(node_p);
+        break;
+    }
+  }
+
+  void FreeSubtree(ARTNode *node_p) {
+    if (IsLeaf(node_p) == false) {
+      uint8_t key_byte = 0;
+      for (ARTNode *child_p = FindChildAtLeast(node_p, 0, key_byte);
+           child_p != nullptr;
+           child_p = key_byte == 255
+                         ? nullptr
+                         : FindChildAtLeast(node_p, key_byte + 1, key_byte)) {
+        FreeSubtree(child_p);
+      }
+    }
+    FreeNode(node_p);
+  }
+
+  /*
+   * CollectGarbageIfNeeded() - The writers collect the garbage as it piles up
+   */
+  void CollectGarbageIfNeeded() {
+    size_t garbage_count = epoch_manager.GetGarbageCount();
+    if (garbage_count >= last_gc_garbage_count.load() + GC_THRESHOLD) {
+      PerformGarbageCollection();
+    }
+  }
+
+  bool unique_keys;
+
+  KeyComparator key_cmp_obj;
+
+  KeyEqualityChecker key_eq_obj;
+
+  ValueEqualityChecker value_eq_obj;
+
+  std::atomic<size_t> memory_footprint;
+
+  // Set while a thread is collecting the garbage
+  std::atomic<bool> gc_flag;
+
+  std::atomic<size_t> last_gc_garbage_count;
+
+  // A Node256 with no prefix
+  ARTNode *root_p;
+
+  EpochManager epoch_manager;
+};
+
+}  // End index namespace
+}  // End peloton namespace
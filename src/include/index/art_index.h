@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// art_index.h
+//
+// Identification: src/include/index/art_index.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "catalog/manager.h"
+#include "common/platform.h"
+#include "type/types.h"
+#include "index/index.h"
+
+#include "index/art.h"
+
+#define ART_INDEX_TYPE                                            \
+  ARTIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker, \
+           ValueEqualityChecker>
+
+namespace peloton {
+namespace index {
+
+/**
+ * Adaptive radix tree index, for keys of integers only.
+ *
+ * The keys are CompactIntsKey, whose bytes compare like the keys, so the
+ * tree branches on them directly. Backward scans are collected forward and
+ * then reversed.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename KeyEqualityChecker, typename ValueEqualityChecker>
+class ARTIndex : public Index {
+  friend class IndexFactory;
+
+  using MapType = ART<KeyType, ValueType, KeyComparator, KeyEqualityChecker,
+                      ValueEqualityChecker>;
+
+ public:
+  ARTIndex(IndexMetadata *metadata);
+
+  ~ARTIndex();
+
+  bool InsertEntry(const storage::Tuple *key, ItemPointer *value);
+
+  bool DeleteEntry(const storage::Tuple *key, ItemPointer *value);
+
+  bool CondInsertEntry(const storage::Tuple *key, ItemPointer *value,
+                       std::function<bool(const void *)> predicate);
+
+  void Scan(const std::vector<type::Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            ScanDirectionType scan_direction, std::vector<ValueType> &result,
+            const ConjunctionScanPredicate *csp_p);
+
+  void ScanLimit(const std::vector<type::Value> &values,
+                 const std::vector<oid_t> &key_column_ids,
+                 const std::vector<ExpressionType> &expr_types,
+                 ScanDirectionType scan_direction,
+                 std::vector<ValueType> &result,
+                 const ConjunctionScanPredicate *csp_p, uint64_t limit,
+                 uint64_t offset);
+
+  void ScanAllKeys(std::vector<ValueType> &result);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ValueType> &result);
+
+  std::string GetTypeName() const;
+
+  size_t GetMemoryFootprint() { return container.GetMemoryFootprint(); }
+
+  bool NeedGC() { return container.NeedGarbageCollection(); }
+
+  void PerformGC() {
+    container.PerformGarbageCollection();
+
+    return;
+  }
+
+ private:
+  void ScanRange(const ConjunctionScanPredicate *csp_p,
+                 ScanDirectionType scan_direction, uint64_t limit,
+                 uint64_t offset, std::vector<ValueType> &result);
+
+ protected:
+  // equality checker and comparator
+  KeyComparator comparator;
+  KeyEqualityChecker equals;
+
+  // container
+  MapType container;
+};
+
+}  // End index namespace
+}  // End peloton namespace
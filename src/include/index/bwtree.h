@@ -31,6 +31,7 @@
 #include <cassert>
 #include <chrono>
 #include <thread>
+#include <type_traits>
 #include <unordered_set>
 // offsetof() is defined here
 #include <cstddef>
@@ -85,8 +86,12 @@ using NodeID = uint64_t;
 
 /*
  * USE_OLD_EPOCH - This flag switches between old epoch and new epoch mechanism
+ *
+ * The old mechanism counts the threads of an epoch on a shared epoch node,
+ * which every operation modifies twice. The new one publishes the epoch of a
+ * thread in its own cache line and keeps garbage in per-thread lists
  */
-#define USE_OLD_EPOCH
+//#define USE_OLD_EPOCH
 
 /*
  * BWTREE_TEMPLATE_ARGUMENTS - Save some key strokes
@@ -147,6 +152,8 @@ extern bool print_flag;
 #define MAPPING_TABLE_SIZE ((size_t)(1 << 20))
 
 // If the length of delta chain exceeds ( >= ) this then we consolidate the node
+// These and the node size thresholds below are the defaults of a tree, which
+// could be changed at runtime through the Set*Threshold() interface
 #define INNER_DELTA_CHAIN_LENGTH_THRESHOLD ((int)8)
 #define LEAF_DELTA_CHAIN_LENGTH_THRESHOLD ((int)8)
 
@@ -157,6 +164,14 @@ extern bool print_flag;
 #define LEAF_NODE_SIZE_UPPER_THRESHOLD ((int)128)
 #define LEAF_NODE_SIZE_LOWER_THRESHOLD ((int)32)
 
+// Nodes built by BulkLoad() are filled up to this size, which leaves room
+// for inserts before they are split
+#define INNER_NODE_BULK_LOAD_SIZE ((int)96)
+#define LEAF_NODE_BULK_LOAD_SIZE ((int)96)
+
+// The number of traversals GetValueBatch() interleaves
+#define BATCH_LOOKUP_GROUP_SIZE ((size_t)8)
+
 #define PREALLOCATE_THREAD_NUM ((size_t)1024)
 
 /*
@@ -185,6 +200,32 @@ extern bool print_flag;
                                                         sizeof(T)) \
                                                     ) T{__VA_ARGS__} ))
 
+/*
+ * struct HasKeyArraySearch - Whether the key comparator searches node arrays
+ *
+ * Comparators that set HAS_KEY_ARRAY_SEARCH provide
+ *
+ *   static size_t CountKeysBefore(const unsigned char *key_array_p,
+ *                                 size_t stride,
+ *                                 size_t key_count,
+ *                                 const KeyType &search_key,
+ *                                 bool inclusive);
+ *
+ * which returns the number of keys in a sorted array that are less than
+ * (or not greater than if inclusive) the search key, where keys are stride
+ * bytes apart. Nodes are then searched with it instead of std::lower_bound()
+ * and std::upper_bound(), which lets the comparator compare several keys at
+ * once with SIMD instructions
+ */
+template <typename KeyComparator, typename = void>
+struct HasKeyArraySearch : std::false_type {};
+
+template <typename KeyComparator>
+struct HasKeyArraySearch<
+    KeyComparator,
+    typename std::enable_if<KeyComparator::HAS_KEY_ARRAY_SEARCH>::type>
+    : std::true_type {};
+
 /*
  * class BwTreeBase - Base class of BwTree that stores some common members
  */
@@ -199,6 +240,13 @@ public:
   // We invoke the GC procedure after this has been reached
   static constexpr size_t GC_NODE_COUNT_THREADHOLD = 1024;
   
+  // The number of threads that could use BwTree at the same time. Every
+  // instance has a GC context for each of them
+  static constexpr size_t GC_THREAD_COUNT = 256;
+  
+  // The last active epoch of a thread that is not inside any operation
+  static constexpr uint64_t QUIESCENT_EPOCH = static_cast<uint64_t>(-1);
+  
   /*
    * class GarbageNode - Garbage node used to represent delayed allocation
    *
@@ -241,7 +289,9 @@ public:
     // So if we take a global minimum of this value, that minimum could be
     // be used as the global epoch value to decide whether a garbage node could
     // be recycled
-    uint64_t last_active_epoch;
+    // It is QUIESCENT_EPOCH while the thread is outside of the tree. This is
+    // only written by the owning thread, but read by all threads doing GC
+    std::atomic<uint64_t> last_active_epoch;
     
     // We only need a pointer
     GarbageNode header; 
@@ -256,13 +306,15 @@ public:
     
     // The number of nodes inside this GC context
     // We use this as a threshold to trigger GC
-    uint64_t node_count;
+    // Only the owning thread modifies it, so it is never updated atomically
+    // with other threads; it is atomic only for reading statistics
+    std::atomic<uint64_t> node_count;
     
     /*
      * Default constructor
      */
     GCMetaData() :
-      last_active_epoch{0UL},
+      last_active_epoch{QUIESCENT_EPOCH},
       header{},
       last_p{&header},
       node_count{0UL}
@@ -312,8 +364,8 @@ public:
   static thread_local int gc_id;
 
 private:
-  // This is used to count the number of threads participating GC process
-  // We use this number to initialize GC data structure
+  // This is used to count the number of GC IDs ever assigned. IDs of threads
+  // that have exited are reused, so this never exceeds GC_THREAD_COUNT
   static std::atomic<size_t> total_thread_num;
   
   // This is the array being allocated for performing GC
@@ -329,7 +381,7 @@ private:
   
   // This is current epoch
   // We need to make it atomic since multiple threads might try to modify it
-  uint64_t epoch;
+  std::atomic<uint64_t> epoch;
   
  public:
    
@@ -416,7 +468,7 @@ private:
   BwTreeBase() :
     gc_metadata_p{nullptr},
     original_p{nullptr},
-    thread_num{total_thread_num.load()},
+    thread_num{GC_THREAD_COUNT},
     epoch{0UL} {
     
     // Allocate memory for thread local data structure
@@ -461,27 +513,20 @@ private:
    *                    in the current process's address space
    *
    * This function assigns an ID to a thread starting from 0, which could be 
-   * used as thread ID for the garbage collection process. 
-   *
-   * Also note that only threads registered before an instance is created will
-   * be considered as being eligible for GC for that thread
-   *
-   * This function does not return any value, and instead it uses an atomic 
-   * counter to counter the number of threads currently in this system, and
-   * assigns the thread ID to a thread local variable called gc_id decleared
-   * inside this class
-   *
-   * Each thread being allocated a GC ID has a context for garbage collection
-   * that is aligned to cache lines. The context will be allocated for every
-   * thread being registered, even if it has already exited. Therefore, this
-   * approach is only suitable for thread pools where the number of threads
-   * is fixed at startup time.
+   * used as thread ID for the garbage collection process. It is called
+   * when the thread enters a BwTree for the first time
+   *
+   * This function does not return any value, and instead it assigns the
+   * thread ID to a thread local variable called gc_id decleared inside this
+   * class
+   *
+   * Each instance has a context for garbage collection aligned to cache lines
+   * for every ID, i.e. for GC_THREAD_COUNT threads. The ID is given back when
+   * the thread exits, and the next thread registered takes over its context
+   * together with the garbage left in there. If all IDs are taken the thread
+   * waits for another one to exit
    */
-  static void RegisterThread() {
-    gc_id = total_thread_num.fetch_add(1);
-    
-    return;
-  }
+  static void RegisterThread();
   
   /*
    * IncreaseEpoch() - Go to the next epoch by increasing the counter
@@ -490,22 +535,50 @@ private:
    * it will cause contention
    */
   inline void IncreaseEpoch() {
-    epoch++;
+    epoch.fetch_add(1);
     
     return;
   }
   
   /*
-   * UpdateLastActiveEpoch() - Updates the last active epoch field of thread 
-   *                           local storage
+   * EnterEpoch() - Publishes the current epoch as the last active epoch of
+   *                the current thread before it accesses the tree
    *
    * This is the core of GC algorithm. Its implication is that all garbage nodes
-   * unlinked before this epoch could be safely collected since at the time 
-   * the thread local counter is updated, we know all references to shared
-   * resources have been released
+   * unlinked before this epoch could be safely collected, since they had been
+   * unlinked before the thread has read the epoch counter
+   *
+   * The thread only writes to its own cache line. If the epoch advances while
+   * it is being published, a GC that has read the new epoch might not have
+   * seen it, so the thread publishes the new one instead
    */
-  inline void UpdateLastActiveEpoch() {
-    GetCurrentGCMetaData()->last_active_epoch = GetGlobalEpoch();
+  inline void EnterEpoch() {
+    if(gc_id == -1) {
+      RegisterThread();
+    }
+    
+    GCMetaData *metadata_p = GetCurrentGCMetaData();
+    while(1) {
+      uint64_t current_epoch = GetGlobalEpoch();
+      metadata_p->last_active_epoch.store(current_epoch);
+      
+      if(GetGlobalEpoch() == current_epoch) {
+        break;
+      }
+    }
+    
+    return;
+  }
+  
+  /*
+   * ExitEpoch() - Marks the current thread as being outside of the tree
+   *
+   * All references to shared resources have been released at this point, so
+   * the thread does not hold back GC until it enters again
+   */
+  inline void ExitEpoch() {
+    GetCurrentGCMetaData()->last_active_epoch.store(QUIESCENT_EPOCH,
+                                                    std::memory_order_release);
     
     return;
   }
@@ -516,7 +589,7 @@ private:
    *                      for GC
    */
   inline void UnregisterThread(int thread_id) {
-    GetGCMetaData(thread_id)->last_active_epoch = static_cast<uint64_t>(-1);
+    GetGCMetaData(thread_id)->last_active_epoch.store(QUIESCENT_EPOCH);
   }
   
   /*
@@ -528,7 +601,7 @@ private:
    * when it reads the counter
    */
   inline uint64_t GetGlobalEpoch() {
-    return epoch; 
+    return epoch.load(); 
   }
   
   /*
@@ -553,24 +626,36 @@ private:
    * SummarizeGCEpoch() - Returns the minimum epochs among the current epoch
    *                      counters of all threads
    *
-   * Note that if this is called then it must be true that there are at least
-   * one thread participating into the GC process
+   * The global epoch is read first and bounds the result. A thread entering
+   * while the counters are read publishes an epoch no less than that one,
+   * so it could not be using the garbage being collected
    */
   uint64_t SummarizeGCEpoch() {
-    assert(thread_num >= 1);
+    uint64_t min_epoch = GetGlobalEpoch();
     
-    // Use the first metadata's epoch as min and update it on the fly
-    uint64_t min_epoch = GetGCMetaData(0)->last_active_epoch;
-    
-    // This might not be executed if there is only one thread
-    for(int i = 1;i < static_cast<int>(thread_num);i++) {
+    for(int i = 0;i < static_cast<int>(thread_num);i++) {
       // This will be compiled into using CMOV which is more efficient
       // than CMP and JMP
-      min_epoch = std::min(GetGCMetaData(i)->last_active_epoch, min_epoch);
+      min_epoch = std::min(GetGCMetaData(i)->last_active_epoch.load(),
+                           min_epoch);
     }
     
     return min_epoch;
   }
+  
+  /*
+   * GetThreadLocalGarbageCount() - Returns the number of garbage nodes in the
+   *                                GC contexts of all threads
+   */
+  uint64_t GetThreadLocalGarbageCount() const {
+    uint64_t garbage_count = 0UL;
+    for(size_t i = 0;i < thread_num;i++) {
+      garbage_count += \
+        (gc_metadata_p + i)->data.node_count.load(std::memory_order_relaxed);
+    }
+    
+    return garbage_count;
+  }
 };
 
 /*
@@ -970,6 +1055,93 @@ class BwTree : public BwTreeBase {
     return !KeyCmpGreater(key1, key2);
   }
 
+  /*
+   * KeyLowerBound() - Returns the first element in a sorted element array
+   *                   whose key is >= the search key
+   *
+   * The element type is either KeyNodeIDPair or KeyValuePair, and only keys
+   * are compared. If the key comparator could search key arrays by itself
+   * then it is used instead of std::lower_bound()
+   */
+  template <typename ElementType>
+  inline ElementType *KeyLowerBound(ElementType *start_p,
+                                    ElementType *end_p,
+                                    const KeyType &search_key) const {
+    return start_p + CountKeysBefore(start_p,
+                                     end_p,
+                                     search_key,
+                                     false,
+                                     HasKeyArraySearch<KeyComparator>{});
+  }
+
+  /*
+   * KeyUpperBound() - Returns the first element in a sorted element array
+   *                   whose key is > the search key
+   */
+  template <typename ElementType>
+  inline ElementType *KeyUpperBound(ElementType *start_p,
+                                    ElementType *end_p,
+                                    const KeyType &search_key) const {
+    return start_p + CountKeysBefore(start_p,
+                                     end_p,
+                                     search_key,
+                                     true,
+                                     HasKeyArraySearch<KeyComparator>{});
+  }
+
+  /*
+   * CountKeysBefore() - Counts elements before the lower bound (or the
+   *                     upper bound if inclusive) using the comparator's
+   *                     key array search
+   */
+  template <typename ElementType>
+  inline size_t CountKeysBefore(ElementType *start_p,
+                                ElementType *end_p,
+                                const KeyType &search_key,
+                                bool inclusive,
+                                std::true_type) const {
+    // Keys must be at the beginning of each element for the stride to work
+    static_assert(offsetof(KeyNodeIDPair, first) == 0 &&
+                  offsetof(KeyValuePair, first) == 0,
+                  "Keys must be the first member of element pairs");
+
+    return KeyComparator::CountKeysBefore(
+        reinterpret_cast<const unsigned char *>(start_p),
+        sizeof(ElementType),
+        static_cast<size_t>(end_p - start_p),
+        search_key,
+        inclusive);
+  }
+
+  /*
+   * CountKeysBefore() - Counts elements before the lower bound (or the
+   *                     upper bound if inclusive) with binary search
+   */
+  template <typename ElementType>
+  inline size_t CountKeysBefore(ElementType *start_p,
+                                ElementType *end_p,
+                                const KeyType &search_key,
+                                bool inclusive,
+                                std::false_type) const {
+    if(inclusive == true) {
+      return std::upper_bound(start_p,
+                              end_p,
+                              search_key,
+                              [this](const KeyType &key,
+                                     const ElementType &element) {
+                                return KeyCmpLess(key, element.first);
+                              }) - start_p;
+    }
+
+    return std::lower_bound(start_p,
+                            end_p,
+                            search_key,
+                            [this](const ElementType &element,
+                                   const KeyType &key) {
+                              return KeyCmpLess(element.first, key);
+                            }) - start_p;
+  }
+
   ///////////////////////////////////////////////////////////////////
   // Value Comparison Member
   ///////////////////////////////////////////////////////////////////
@@ -2509,7 +2681,7 @@ class BwTree : public BwTreeBase {
       // This size is exactly the index of the split point
       int left_sibling_size = std::distance(this->Begin(), it);
 
-      if(left_sibling_size > static_cast<int>(LEAF_NODE_SIZE_LOWER_THRESHOLD)) {
+      if(left_sibling_size > t->GetLeafNodeSizeLowerThreshold()) {
         return left_sibling_size;
       }
 
@@ -2525,7 +2697,7 @@ class BwTree : public BwTreeBase {
 
       int right_sibling_size = std::distance(it, this->End());
 
-      if(right_sibling_size > static_cast<int>(LEAF_NODE_SIZE_LOWER_THRESHOLD)) {
+      if(right_sibling_size > t->GetLeafNodeSizeLowerThreshold()) {
         return std::distance(this->Begin(), it);
       }
 
@@ -2672,6 +2844,23 @@ class BwTree : public BwTreeBase {
       update_op_count{0},
       update_abort_count{0},
 
+      // Structure modification thresholds
+      inner_delta_chain_length_threshold{INNER_DELTA_CHAIN_LENGTH_THRESHOLD},
+      leaf_delta_chain_length_threshold{LEAF_DELTA_CHAIN_LENGTH_THRESHOLD},
+      inner_node_size_upper_threshold{INNER_NODE_SIZE_UPPER_THRESHOLD},
+      inner_node_size_lower_threshold{INNER_NODE_SIZE_LOWER_THRESHOLD},
+      leaf_node_size_upper_threshold{LEAF_NODE_SIZE_UPPER_THRESHOLD},
+      leaf_node_size_lower_threshold{LEAF_NODE_SIZE_LOWER_THRESHOLD},
+
+      // Structure modification counters
+      leaf_consolidation_count{0},
+      inner_consolidation_count{0},
+      leaf_split_count{0},
+      inner_split_count{0},
+      leaf_merge_count{0},
+      inner_merge_count{0},
+      cas_failure_count{0},
+
       // Epoch Manager that does garbage collection
       epoch_manager{this} {
     bwt_printf("Bw-Tree Constructor called. "
@@ -2732,6 +2921,10 @@ class BwTree : public BwTreeBase {
       UnregisterThread(i);
     }
     
+    // Garbage is only collected when it has been unlinked before the
+    // current epoch
+    IncreaseEpoch();
+    
     for(size_t i = 0;i < GetThreadNum();i++) {
       // Here all epoch counters have been set to 0xFFFFFFFFFFFFFFFF
       // so GC should always succeed
@@ -2739,7 +2932,7 @@ class BwTree : public BwTreeBase {
       
       // This will collect all nodes since we have adjusted the currenr thread
       // GC ID
-      assert(GetGCMetaData(i)->node_count == 0);
+      assert(GetGCMetaData(i)->node_count.load() == 0);
     }
     
     return;
@@ -3143,7 +3336,12 @@ class BwTree : public BwTreeBase {
     debug_stop_mutex.unlock();
     #endif
 
-    return mapping_table[node_id].compare_exchange_strong(prev_p, node_p);
+    bool ret = mapping_table[node_id].compare_exchange_strong(prev_p, node_p);
+    if(ret == false) {
+      cas_failure_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return ret;
   }
 
   /*
@@ -3456,11 +3654,8 @@ abort_traverse:
     assert(inner_node_p->GetSize() != 0UL);
     (void)inner_node_p;
 
-    // Hopefully std::upper_bound would use binary search here
-    auto it = std::upper_bound(start_p,
-                               end_p,
-                               std::make_pair(search_key, INVALID_NODE_ID),
-                               key_node_id_pair_cmp_obj) - 1;
+    // This is either binary search or the key array search of the comparator
+    auto it = KeyUpperBound(start_p, end_p, search_key) - 1;
 #ifdef BWTREE_DEBUG
     //auto it2 = std::upper_bound(inner_node_p->Begin() + 1,
     //                           inner_node_p->End(),
@@ -3489,10 +3684,9 @@ abort_traverse:
   inline NodeID LocateSeparatorByKeyBI(const KeyType &search_key,
                                        const InnerNode *inner_node_p) {
     assert(inner_node_p->GetSize() != 0UL);
-    auto it = std::upper_bound(inner_node_p->Begin() + 1,
-                               inner_node_p->End(),
-                               std::make_pair(search_key, INVALID_NODE_ID),
-                               key_node_id_pair_cmp_obj) - 1;
+    auto it = KeyUpperBound(inner_node_p->Begin() + 1,
+                            inner_node_p->End(),
+                            search_key) - 1;
 
     if(KeyCmpEqual(it->first, search_key) == true) {
       // If search key is the low key then we know we should have already
@@ -3970,10 +4164,9 @@ abort_traverse:
             // The return value might be end() iterator, but it is also
             // consistent
             copy_end_it = \
-              std::lower_bound(inner_node_p->Begin() + 1,
-                               inner_node_p->End(),
-                               high_key_pair,     // This contains the high key
-                               key_node_id_pair_cmp_obj);
+              KeyLowerBound(inner_node_p->Begin() + 1,
+                            inner_node_p->End(),
+                            high_key_pair.first);
           }
 
           // Since we want to access its first element
@@ -4283,10 +4476,7 @@ abort_traverse:
           // NOTE: We only compare keys here, so it will get to the first
           // element >= search key
           auto copy_start_it = \
-            std::lower_bound(start_it,
-                             end_it,
-                             std::make_pair(search_key, ValueType{}),
-                             key_value_pair_cmp_obj);
+            KeyLowerBound(start_it, end_it, search_key);
 
           // If there is something to copy
           while((copy_start_it != leaf_node_p->End()) && \
@@ -4464,10 +4654,9 @@ abort_traverse:
           // NOTE: We only compare keys here, so it will get to the first
           // element >= search key
           auto scan_start_it = \
-            std::lower_bound(leaf_node_p->Begin(),
-                             leaf_node_p->End(),
-                             std::make_pair(search_key, ValueType{}),
-                             key_value_pair_cmp_obj);
+            KeyLowerBound(leaf_node_p->Begin(),
+                          leaf_node_p->End(),
+                          search_key);
 
           // Search all values with the search key
           while((scan_start_it != leaf_node_p->End()) && \
@@ -4657,10 +4846,9 @@ abort_traverse:
             static_cast<const LeafNode *>(node_p);
 
           auto copy_start_it = \
-            std::lower_bound(leaf_node_p->Begin(),
-                             leaf_node_p->End(),
-                             std::make_pair(search_key, ValueType{}),
-                             key_value_pair_cmp_obj);
+            KeyLowerBound(leaf_node_p->Begin(),
+                          leaf_node_p->End(),
+                          search_key);
 
           while((copy_start_it != leaf_node_p->End()) && \
                 (KeyCmpEqual(search_key, copy_start_it->first))) {
@@ -4943,12 +5131,9 @@ abort_traverse:
             // This points copy_end_it to the first element >= current high key
             // If no such element exists then copy_end_it is end() iterator
             // which is also consistent behavior
-            copy_end_it = std::lower_bound(leaf_node_p->Begin(),
-                                           leaf_node_p->End(),
-                                           // It only compares key so we
-                                           // just use high key pair
-                                           std::make_pair(high_key_pair.first, ValueType{}),
-                                           key_value_pair_cmp_obj);
+            copy_end_it = KeyLowerBound(leaf_node_p->Begin(),
+                                        leaf_node_p->End(),
+                                        high_key_pair.first);
           }
           
           // This is the index of the copy end it
@@ -6289,6 +6474,7 @@ before_switch:
                                     snapshot_p->node_p);
 
     if(ret == true) {
+      leaf_consolidation_count.fetch_add(1, std::memory_order_relaxed);
       epoch_manager.AddGarbageNode(snapshot_p->node_p);
 
       snapshot_p->node_p = leaf_node_p;
@@ -6314,6 +6500,7 @@ before_switch:
                                     snapshot_p->node_p);
 
     if(ret == true) {
+      inner_consolidation_count.fetch_add(1, std::memory_order_relaxed);
       epoch_manager.AddGarbageNode(snapshot_p->node_p);
 
       snapshot_p->node_p = inner_node_p;
@@ -6387,11 +6574,11 @@ before_switch:
     int depth = node_p->GetDepth();
 
     if(snapshot_p->IsLeaf() == true) {
-      if(depth < LEAF_DELTA_CHAIN_LENGTH_THRESHOLD) {
+      if(depth < leaf_delta_chain_length_threshold.load()) {
         return;
       }
     } else {
-      if(depth < INNER_DELTA_CHAIN_LENGTH_THRESHOLD) {
+      if(depth < inner_delta_chain_length_threshold.load()) {
         return;
       }
     }
@@ -6445,7 +6632,8 @@ before_switch:
       size_t node_size = leaf_node_p->GetItemCount();
 
       // Perform corresponding action based on node size
-      if(node_size >= LEAF_NODE_SIZE_UPPER_THRESHOLD) {
+      if(node_size >= \
+         static_cast<size_t>(leaf_node_size_upper_threshold.load())) {
         bwt_printf("Node size >= leaf upper threshold. Split\n");
 
         // Note: This function takes this as argument since it will
@@ -6497,6 +6685,7 @@ before_switch:
         bool ret = InstallNodeToReplace(node_id, split_node_p, node_p);
 
         if(ret == true) {
+          leaf_split_count.fetch_add(1, std::memory_order_relaxed);
           bwt_printf("Leaf split delta (from %lu to %lu) CAS succeeds. ABORT\n",
                      node_id,
                      new_node_id);
@@ -6530,7 +6719,8 @@ before_switch:
           return;
         }
 
-      } else if(node_size <= LEAF_NODE_SIZE_LOWER_THRESHOLD) {
+      } else if(node_size <= \
+                static_cast<size_t>(leaf_node_size_lower_threshold.load())) {
         // This might yield a false positive of left child
         // but correctness is not affected - sometimes the merge is delayed
         if(IsOnLeftMostChild(context_p) == true) {
@@ -6602,7 +6792,8 @@ before_switch:
 
       size_t node_size = inner_node_p->GetSize();
 
-      if(node_size >= INNER_NODE_SIZE_UPPER_THRESHOLD) {
+      if(node_size >= \
+         static_cast<size_t>(inner_node_size_upper_threshold.load())) {
         bwt_printf("Node size >= inner upper threshold. Split\n");
 
         const InnerNode *new_inner_node_p = inner_node_p->GetSplitSibling();
@@ -6657,6 +6848,7 @@ before_switch:
         bool ret = InstallNodeToReplace(node_id, split_node_p, node_p);
 
         if(ret == true) {
+          inner_split_count.fetch_add(1, std::memory_order_relaxed);
           bwt_printf("Inner split delta (from %lu to %lu) CAS succeeds."
                      " ABORT\n", node_id, new_node_id);
 
@@ -6684,7 +6876,8 @@ before_switch:
 
           return;
         } // if CAS fails
-      } else if(node_size <= INNER_NODE_SIZE_LOWER_THRESHOLD) {
+      } else if(node_size <= \
+                static_cast<size_t>(inner_node_size_lower_threshold.load())) {
         if(context_p->IsOnRootNode() == true) {
           bwt_printf("Root underflow - let it be\n");
 
@@ -6950,10 +7143,7 @@ before_switch:
         }
 
         const KeyNodeIDPair *it = \
-          std::lower_bound(start_it,
-                           inner_node_p->End(),
-                           std::make_pair(search_key, INVALID_NODE_ID),
-                           key_node_id_pair_cmp_obj);
+          KeyLowerBound(start_it, inner_node_p->End(), search_key);
 
         // Just give the location information by assigning to location
         *location = it;
@@ -7080,10 +7270,9 @@ before_switch:
 
           // Since we know the search key must be one of the key inside
           // the inner node, lower bound is sufficient
-          auto it1 = std::upper_bound(inner_node_p->Begin() + 1,
-                                      end_it,
-                                      std::make_pair(search_key, INVALID_NODE_ID),
-                                      key_node_id_pair_cmp_obj) - 1;
+          auto it1 = KeyUpperBound(inner_node_p->Begin() + 1,
+                                   end_it,
+                                   search_key) - 1;
 
           // Note that it is possible for it1 to be begin()
           // since it is not the real current node if the node id
@@ -7227,6 +7416,7 @@ before_switch:
                                           snapshot_p->node_p);
                                           
           if(ret == true) {
+            inner_consolidation_count.fetch_add(1, std::memory_order_relaxed);
             epoch_manager.AddGarbageNode(snapshot_p->node_p);
             
             snapshot_p->node_p = inner_node_p;
@@ -7290,6 +7480,7 @@ before_switch:
     if(ret == false) {
       merge_node_p->~InnerMergeNode();
     } else {
+      inner_merge_count.fetch_add(1, std::memory_order_relaxed);
       *node_p_p = merge_node_p;
     }
 
@@ -7328,12 +7519,163 @@ before_switch:
     if(ret == false) {
       merge_node_p->~LeafMergeNode();
     } else {
+      leaf_merge_count.fetch_add(1, std::memory_order_relaxed);
       *node_p_p = merge_node_p;
     }
 
     return ret;
   }
 
+  /*
+   * BulkLoad() - Build the tree bottom-up from key-value pairs sorted by key
+   *
+   * Leaf nodes are filled with about LEAF_NODE_BULK_LOAD_SIZE pairs without
+   * putting the pairs of one key on two leaf nodes, and each level of inner
+   * nodes is then built over the low keys of the level below until a single
+   * root is left. This is much faster than inserting pairs one by one, which
+   * goes through delta records, consolidations and splits
+   *
+   * The pairs must be sorted by key and distinct. The tree must be empty and
+   * no other thread may access it until this function returns. If the tree
+   * has ever had a pair inserted this function returns false and does not
+   * change the tree
+   */
+  bool BulkLoad(const std::vector<KeyValuePair> &kv_list) {
+    bwt_printf("BulkLoad called\n");
+
+    // The tree is empty as long as it only has the nodes of InitNodeLayout()
+    // and there is no delta record on the first leaf node
+    const BaseNode *first_leaf_p = GetNode(first_leaf_id);
+    if((next_unused_node_id.load() != FIRST_LEAF_NODE_ID + 1) ||
+       (first_leaf_p->GetType() != NodeType::LeafType) ||
+       (static_cast<const LeafNode *>(first_leaf_p)->GetSize() != 0)) {
+      return false;
+    }
+
+    if(kv_list.size() == 0UL) {
+      return true;
+    }
+
+    // Spread the pairs evenly over the leaf nodes, and only end a leaf
+    // node where the key changes
+    size_t leaf_count = (kv_list.size() + LEAF_NODE_BULK_LOAD_SIZE - 1) / \
+                        LEAF_NODE_BULK_LOAD_SIZE;
+    size_t leaf_size = (kv_list.size() + leaf_count - 1) / leaf_count;
+
+    std::vector<size_t> start_list{};
+    size_t item_index = 0UL;
+    while(item_index < kv_list.size()) {
+      start_list.push_back(item_index);
+
+      item_index += leaf_size;
+      while((item_index < kv_list.size()) && \
+            (KeyCmpEqual(kv_list[item_index - 1].first,
+                         kv_list[item_index].first) == true)) {
+        item_index++;
+      }
+    }
+
+    start_list.push_back(kv_list.size());
+
+    // Free the nodes of InitNodeLayout(). The first leaf node keeps its
+    // NodeID since iterators start from FIRST_LEAF_NODE_ID, and the root
+    // keeps root_id
+    FreeNodeByNodeID(root_id.load());
+
+    // This holds the low key and NodeID of each node on the level that was
+    // built last. The low key of the left most node is -Inf, which is never
+    // compared
+    std::vector<KeyNodeIDPair> child_list{};
+    child_list.reserve(start_list.size() - 1);
+    child_list.push_back(std::make_pair(KeyType(), first_leaf_id));
+    for(size_t i = 1;i + 1 < start_list.size();i++) {
+      child_list.push_back(std::make_pair(kv_list[start_list[i]].first,
+                                          GetNextNodeID()));
+    }
+
+    for(size_t i = 0;i < child_list.size();i++) {
+      int size = static_cast<int>(start_list[i + 1] - start_list[i]);
+
+      KeyNodeIDPair low_key_pair = std::make_pair(KeyType(), INVALID_NODE_ID);
+      if(i != 0) {
+        low_key_pair = std::make_pair(child_list[i].first, ~INVALID_NODE_ID);
+      }
+
+      // The high key of the last node is +Inf
+      KeyNodeIDPair high_key_pair = std::make_pair(KeyType(), INVALID_NODE_ID);
+      if(i + 1 != child_list.size()) {
+        high_key_pair = child_list[i + 1];
+      }
+
+      LeafNode *leaf_node_p = \
+        reinterpret_cast<LeafNode *>(ElasticNode<KeyValuePair>::\
+          Get(size,
+              NodeType::LeafType,
+              0,
+              size,
+              low_key_pair,
+              high_key_pair));
+
+      leaf_node_p->PushBack(kv_list.data() + start_list[i],
+                            kv_list.data() + start_list[i + 1]);
+
+      InstallNewNode(child_list[i].second, leaf_node_p);
+    }
+
+    // The root is always an inner node, even if there is only one leaf node
+    do {
+      size_t node_count = \
+        (child_list.size() + INNER_NODE_BULK_LOAD_SIZE - 1) / \
+        INNER_NODE_BULK_LOAD_SIZE;
+
+      start_list.clear();
+      for(size_t i = 0;i < node_count;i++) {
+        start_list.push_back(child_list.size() * i / node_count);
+      }
+
+      start_list.push_back(child_list.size());
+
+      std::vector<KeyNodeIDPair> parent_list{};
+      parent_list.reserve(node_count);
+      for(size_t i = 0;i < node_count;i++) {
+        parent_list.push_back( \
+          std::make_pair(child_list[start_list[i]].first,
+                         node_count == 1UL ? root_id.load() : GetNextNodeID()));
+      }
+
+      for(size_t i = 0;i < node_count;i++) {
+        int size = static_cast<int>(start_list[i + 1] - start_list[i]);
+
+        KeyNodeIDPair high_key_pair = \
+          std::make_pair(KeyType(), INVALID_NODE_ID);
+        if(i + 1 != node_count) {
+          high_key_pair = parent_list[i + 1];
+        }
+
+        // The low key of an inner node is its first separator
+        InnerNode *inner_node_p = \
+          reinterpret_cast<InnerNode *>(ElasticNode<KeyNodeIDPair>::\
+            Get(size,
+                NodeType::InnerType,
+                0,
+                size,
+                child_list[start_list[i]],
+                high_key_pair));
+
+        inner_node_p->PushBack(child_list.data() + start_list[i],
+                               child_list.data() + start_list[i + 1]);
+
+        InstallNewNode(parent_list[i].second, inner_node_p);
+      }
+
+      child_list = std::move(parent_list);
+    } while(child_list.size() > 1UL);
+
+    bwt_printf("Bulk loaded %lu pairs\n", kv_list.size());
+
+    return true;
+  }
+
   /*
    * Insert() - Insert a key-value pair
    *
@@ -7640,6 +7982,147 @@ before_switch:
     return;
   }
 
+  /*
+   * GetValueBatch() - Fill the values of each key in a batch of keys
+   *
+   * The keys are looked up BATCH_LOOKUP_GROUP_SIZE at a time with their
+   * traversals interleaved. Each traversal takes one step in turn, and
+   * prefetches the mapping table entry or the node its next step reads, such
+   * that the cache misses of the group overlap instead of stalling one after
+   * another
+   *
+   * value_list_list[i] receives the values of key_list[i]
+   */
+  void GetValueBatch(const std::vector<KeyType> &key_list,
+                     std::vector<std::vector<ValueType>> &value_list_list) {
+    bwt_printf("GetValueBatch()\n");
+
+    value_list_list.clear();
+    value_list_list.resize(key_list.size());
+
+    // A traversal loads the root, then navigates the node it has loaded and
+    // loads the child it is directed to, until it navigates a leaf node
+    enum class LookupStage { LoadRoot, Navigate, LoadChild };
+
+    struct Lookup {
+      Context *context_p;
+      size_t key_index;
+      LookupStage stage;
+      NodeID child_node_id;
+    };
+
+    // Contexts can not be moved, so they are constructed in place here
+    typename std::aligned_storage<sizeof(Context), alignof(Context)>::type \
+      context_storage[BATCH_LOOKUP_GROUP_SIZE];
+    Lookup lookup_list[BATCH_LOOKUP_GROUP_SIZE];
+
+    EpochNode *epoch_node_p = epoch_manager.JoinEpoch();
+
+    size_t next_key_index = 0UL;
+    size_t active_count = 0UL;
+    for(size_t i = 0;i < BATCH_LOOKUP_GROUP_SIZE;i++) {
+      lookup_list[i].context_p = nullptr;
+
+      if(next_key_index < key_list.size()) {
+        lookup_list[i].context_p = \
+          new (&context_storage[i]) Context{key_list[next_key_index]};
+        lookup_list[i].key_index = next_key_index;
+        lookup_list[i].stage = LookupStage::LoadRoot;
+
+        next_key_index++;
+        active_count++;
+      }
+    }
+
+    while(active_count > 0UL) {
+      for(size_t i = 0;i < BATCH_LOOKUP_GROUP_SIZE;i++) {
+        Lookup &lookup = lookup_list[i];
+        Context *context_p = lookup.context_p;
+        if(context_p == nullptr) {
+          continue;
+        }
+
+        bool finished = false;
+        switch(lookup.stage) {
+          case LookupStage::LoadRoot:
+          case LookupStage::LoadChild: {
+            NodeID node_id = lookup.stage == LookupStage::LoadRoot ? \
+                             root_id.load() : \
+                             lookup.child_node_id;
+
+            LoadNodeIDReadOptimized(node_id, context_p);
+            if(context_p->abort_flag == false) {
+              __builtin_prefetch(context_p->current_snapshot.node_p);
+              lookup.stage = LookupStage::Navigate;
+            }
+
+            break;
+          }
+          case LookupStage::Navigate: {
+            NodeSnapshot *snapshot_p = GetLatestNodeSnapshot(context_p);
+
+            if(snapshot_p->IsLeaf() == true) {
+              NavigateLeafNode(context_p,
+                               value_list_list[lookup.key_index]);
+              finished = context_p->abort_flag == false;
+            } else {
+              lookup.child_node_id = NavigateInnerNode(context_p);
+              if(context_p->abort_flag == false) {
+                __builtin_prefetch(&mapping_table[lookup.child_node_id]);
+                lookup.stage = LookupStage::LoadChild;
+              }
+            }
+
+            break;
+          }
+        } // switch
+
+        // Same as TraverseReadOptimized(), an aborted traversal restarts
+        // from the root
+        if(context_p->abort_flag == true) {
+          #ifdef BWTREE_DEBUG
+
+          context_p->current_level = -1;
+
+          context_p->abort_counter++;
+
+          #endif
+
+          context_p->current_snapshot.node_id = INVALID_NODE_ID;
+
+          context_p->abort_flag = false;
+
+          lookup.stage = LookupStage::LoadRoot;
+
+          continue;
+        }
+
+        if(finished == false) {
+          continue;
+        }
+
+        // Start the next key in this slot
+        context_p->~Context();
+        lookup.context_p = nullptr;
+
+        if(next_key_index < key_list.size()) {
+          lookup.context_p = \
+            new (&context_storage[i]) Context{key_list[next_key_index]};
+          lookup.key_index = next_key_index;
+          lookup.stage = LookupStage::LoadRoot;
+
+          next_key_index++;
+        } else {
+          active_count--;
+        }
+      }
+    }
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+
+    return;
+  }
+
   /*
    * GetValue() - Return value in a ValueSet object
    *
@@ -7703,6 +8186,120 @@ before_switch:
     return;
   }
 
+  ///////////////////////////////////////////////////////////////////
+  // Structure Modification Interface
+  ///////////////////////////////////////////////////////////////////
+
+  /*
+   * Set*DeltaChainLengthThreshold() - Change the delta chain length at which
+   *                                   nodes are consolidated
+   *
+   * Short delta chains make reads cheaper at the cost of consolidating more
+   * often. Chains already longer than the new threshold are consolidated
+   * the next time a thread traverses them
+   */
+  void SetLeafDeltaChainLengthThreshold(int threshold) {
+    assert(threshold > 0);
+    leaf_delta_chain_length_threshold.store(threshold);
+
+    return;
+  }
+
+  void SetInnerDeltaChainLengthThreshold(int threshold) {
+    assert(threshold > 0);
+    inner_delta_chain_length_threshold.store(threshold);
+
+    return;
+  }
+
+  /*
+   * Set*NodeSizeThreshold() - Change the node sizes that trigger merge and
+   *                           split
+   *
+   * The lower threshold must be less than half of the upper one, otherwise
+   * both halves of a split node would be merged again
+   */
+  void SetLeafNodeSizeThreshold(int lower_threshold, int upper_threshold) {
+    assert(lower_threshold > 0);
+    assert(lower_threshold * 2 < upper_threshold);
+    leaf_node_size_lower_threshold.store(lower_threshold);
+    leaf_node_size_upper_threshold.store(upper_threshold);
+
+    return;
+  }
+
+  void SetInnerNodeSizeThreshold(int lower_threshold, int upper_threshold) {
+    assert(lower_threshold > 0);
+    assert(lower_threshold * 2 < upper_threshold);
+    inner_node_size_lower_threshold.store(lower_threshold);
+    inner_node_size_upper_threshold.store(upper_threshold);
+
+    return;
+  }
+
+  inline int GetLeafDeltaChainLengthThreshold() const {
+    return leaf_delta_chain_length_threshold.load();
+  }
+
+  inline int GetInnerDeltaChainLengthThreshold() const {
+    return inner_delta_chain_length_threshold.load();
+  }
+
+  inline int GetLeafNodeSizeLowerThreshold() const {
+    return leaf_node_size_lower_threshold.load();
+  }
+
+  inline int GetLeafNodeSizeUpperThreshold() const {
+    return leaf_node_size_upper_threshold.load();
+  }
+
+  inline int GetInnerNodeSizeLowerThreshold() const {
+    return inner_node_size_lower_threshold.load();
+  }
+
+  inline int GetInnerNodeSizeUpperThreshold() const {
+    return inner_node_size_upper_threshold.load();
+  }
+
+  /*
+   * Get*Count() - Number of structure modifications installed so far, and
+   *               of mapping table CAS that failed and were retried
+   */
+  inline uint64_t GetConsolidationCount() const {
+    return leaf_consolidation_count.load() + inner_consolidation_count.load();
+  }
+
+  inline uint64_t GetSplitCount() const {
+    return leaf_split_count.load() + inner_split_count.load();
+  }
+
+  inline uint64_t GetMergeCount() const {
+    return leaf_merge_count.load() + inner_merge_count.load();
+  }
+
+  inline uint64_t GetCASFailureCount() const {
+    return cas_failure_count.load();
+  }
+
+  /*
+   * GetEpochCount() - Number of epochs whose garbage was not freed yet
+   */
+  inline uint64_t GetEpochCount() const {
+    return epoch_manager.epoch_count.load();
+  }
+
+  /*
+   * GetGarbageNodeCount() - Number of unlinked delta chains and nodes
+   *                         waiting for their epoch to be freed
+   */
+  inline uint64_t GetGarbageNodeCount() const {
+#ifdef USE_OLD_EPOCH
+    return epoch_manager.garbage_node_count.load();
+#else
+    return GetThreadLocalGarbageCount();
+#endif
+  }
+
  /*
   * Private Method Implementation
   */
@@ -7767,6 +8364,25 @@ before_switch:
   std::atomic<uint64_t> update_op_count;
   std::atomic<uint64_t> update_abort_count;
 
+  // Thresholds of consolidation, split and merge. Worker threads read them
+  // on every traversal, so changing them only affects later decisions
+  std::atomic<int> inner_delta_chain_length_threshold;
+  std::atomic<int> leaf_delta_chain_length_threshold;
+  std::atomic<int> inner_node_size_upper_threshold;
+  std::atomic<int> inner_node_size_lower_threshold;
+  std::atomic<int> leaf_node_size_upper_threshold;
+  std::atomic<int> leaf_node_size_lower_threshold;
+
+  // Number of structure modifications that were installed, and of all
+  // mapping table CAS that failed. These are only used for statistics
+  std::atomic<uint64_t> leaf_consolidation_count;
+  std::atomic<uint64_t> inner_consolidation_count;
+  std::atomic<uint64_t> leaf_split_count;
+  std::atomic<uint64_t> inner_split_count;
+  std::atomic<uint64_t> leaf_merge_count;
+  std::atomic<uint64_t> inner_merge_count;
+  std::atomic<uint64_t> cas_failure_count;
+
   //InteractiveDebugger idb;
 
   EpochManager epoch_manager;
@@ -7833,6 +8449,11 @@ before_switch:
     // Therefore, strict ordering is required
     std::atomic<bool> exited_flag;
 
+    // Length of the epoch list, and number of garbage nodes linked to the
+    // epochs in it. Only used for statistics
+    std::atomic<uint64_t> epoch_count;
+    std::atomic<uint64_t> garbage_node_count;
+
     // If GC is done with external thread then this should be set
     // to nullptr
     // Otherwise it points to a thread created by EpochManager internally
@@ -7884,6 +8505,9 @@ before_switch:
       // This is used to notify the cleaner thread that it has ended
       exited_flag.store(false);
 
+      epoch_count.store(1UL);
+      garbage_node_count.store(0UL);
+
       // Initialize atomic counter to record how many
       // freed has been called inside epoch manager
       #ifdef BWTREE_DEBUG
@@ -8010,6 +8634,8 @@ before_switch:
       // And then switch current epoch pointer
       current_epoch_p = epoch_node_p;
 
+      epoch_count.fetch_add(1);
+
       #ifdef BWTREE_DEBUG
       epoch_created++;
       #endif
@@ -8053,6 +8679,7 @@ before_switch:
 
         // If CAS succeeds then just return
         if(ret == true) {
+          garbage_node_count.fetch_add(1, std::memory_order_relaxed);
           break;
         } else {
           bwt_printf("Add garbage node CAS failed. Retry\n");
@@ -8149,21 +8776,33 @@ try_join_again:
     }
     
     inline EpochNode *JoinEpoch() {
-      tree_p->UpdateLastActiveEpoch();
+      tree_p->EnterEpoch();
       
       return nullptr;
     }
     
     inline void LeaveEpoch(EpochNode *epoch_p) {
-      tree_p->UpdateLastActiveEpoch();
+      tree_p->ExitEpoch();
       
       (void)epoch_p;
       return;
     }
     
+    /*
+     * PerformGarbageCollection() - Advances the epoch, and also frees the
+     *                              garbage of the calling thread if it has
+     *                              used the tree
+     *
+     * The garbage of the other threads is freed by themselves once they have
+     * collected enough of it
+     */
     inline void PerformGarbageCollection() {
       tree_p->IncreaseEpoch();
       
+      if(gc_id != -1) {
+        tree_p->PerformGC(gc_id);
+      }
+      
       return;
     }
     
@@ -8409,6 +9048,7 @@ try_join_again:
         // and then free each delta chain
 
         const GarbageNode *next_garbage_node_p = nullptr;
+        uint64_t freed_garbage_count = 0;
 
         // Walk through its garbage chain
         for(const GarbageNode *garbage_node_p = head_epoch_p->garbage_list_p.load();
@@ -8423,8 +9063,12 @@ try_join_again:
           // This invalidates any further reference to its
           // members (so we saved next pointer above)
           delete garbage_node_p;
+          freed_garbage_count++;
         } // for
 
+        garbage_node_count.fetch_sub(freed_garbage_count);
+        epoch_count.fetch_sub(1);
+
         // First need to save this in order to delete current node
         // safely
         EpochNode *next_epoch_node_p = head_epoch_p->next_p;
@@ -9215,10 +9859,9 @@ try_join_again:
         //   3. kv_p points to End() of the leaf node but next node ID
         //      is a valid one: Try next page since the current page might have
         //      been merged
-        kv_p = std::lower_bound(ic_p->GetLeafNode()->Begin(),
-                                ic_p->GetLeafNode()->End(),
-                                std::make_pair(start_key, ValueType{}),
-                                p_tree_p->key_value_pair_cmp_obj);
+        kv_p = p_tree_p->KeyLowerBound(ic_p->GetLeafNode()->Begin(),
+                                       ic_p->GetLeafNode()->End(),
+                                       start_key);
 
         // All keys in the leaf page are < start key. Switch the next key until
         // we have found the key or until we have reached end of tree
@@ -9312,10 +9955,9 @@ try_join_again:
         //        need to take the current low key and retry
         //    (6) If the leaf node itself is empty then kv_p == End() == Begin()
         //        and kv_p-- is REnd()
-        kv_p = std::lower_bound(ic_p->GetLeafNode()->Begin(),
-                                ic_p->GetLeafNode()->End(),
-                                std::make_pair(low_key, ValueType{}),
-                                tree_p->key_value_pair_cmp_obj) - 1;
+        kv_p = tree_p->KeyLowerBound(ic_p->GetLeafNode()->Begin(),
+                                     ic_p->GetLeafNode()->End(),
+                                     low_key) - 1;
          
         // If after decreament the kv_p points to the element before Begin()
         // then we know we should try again                       
@@ -9391,13 +10033,15 @@ try_join_again:
     GetCurrentGCMetaData()->last_p = garbage_node_p;
     
     // Update the counter 
-    GetCurrentGCMetaData()->node_count++;
+    std::atomic<uint64_t> &node_count = GetCurrentGCMetaData()->node_count;
+    node_count.store(node_count.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
     
     // It is possible that we could not free enough number of nodes to
     // make it less than this threshold
     // So it is important to let the epoch counter be constantly increased
     // to guarantee progress
-    if(GetCurrentGCMetaData()->node_count > GC_NODE_COUNT_THREADHOLD) {
+    if(node_count.load(std::memory_order_relaxed) > GC_NODE_COUNT_THREADHOLD) {
       // Use current thread's gc id to perform GC
       PerformGC(gc_id);
     }
@@ -9438,8 +10082,10 @@ try_join_again:
       epoch_manager.FreeEpochDeltaChain((const BaseNode *)first_p->node_p);
       
       delete first_p;
-      assert(GetGCMetaData(thread_id)->node_count != 0UL);
-      GetGCMetaData(thread_id)->node_count--;
+      std::atomic<uint64_t> &node_count = GetGCMetaData(thread_id)->node_count;
+      assert(node_count.load(std::memory_order_relaxed) != 0UL);
+      node_count.store(node_count.load(std::memory_order_relaxed) - 1,
+                       std::memory_order_relaxed);
       
       first_p = header_p->next_p;
     }
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <map>
@@ -75,6 +76,9 @@ class BWTreeIndex : public Index {
                        ItemPointer *value,
                        std::function<bool(const void *)> predicate);
 
+  bool BulkLoad(const std::vector<std::pair<std::unique_ptr<storage::Tuple>,
+                                            ItemPointer *>> &entries);
+
   void Scan(const std::vector<type::Value> &values,
             const std::vector<oid_t> &key_column_ids,
             const std::vector<ExpressionType> &expr_types,
@@ -91,15 +95,27 @@ class BWTreeIndex : public Index {
                  uint64_t limit,
                  uint64_t offset);
 
+  bool ScanWithKeys(const std::vector<type::Value> &values,
+                    const std::vector<oid_t> &key_column_ids,
+                    const std::vector<ExpressionType> &expr_types,
+                    std::vector<ValueType> &result,
+                    std::vector<type::Value> &key_value_list,
+                    const ConjunctionScanPredicate *csp_p);
+
   void ScanAllKeys(std::vector<ValueType> &result);
 
   void ScanKey(const storage::Tuple *key,
                std::vector<ValueType> &result);
 
+  void ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                std::vector<std::vector<ValueType>> &results);
+
   std::string GetTypeName() const;
 
   // TODO: Implement this
   size_t GetMemoryFootprint() { return 0; }
+
+  IndexStructureStats GetStructureStats();
   
   bool NeedGC() {
     return container.NeedGarbageCollection();
@@ -119,6 +135,15 @@ class BWTreeIndex : public Index {
   
   // container
   MapType container;
+
+ private:
+  void CountWrite();
+
+  void TuneThresholds();
+
+  // Operations since the thresholds of the container were last tuned
+  std::atomic<uint64_t> read_op_count;
+  std::atomic<uint64_t> write_op_count;
 };
 
 }  // End index namespace
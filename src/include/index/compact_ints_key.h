@@ -12,8 +12,13 @@
 
 #pragma once
 
+#include <cstring>
 #include <sstream>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include "util/string_util.h"
 #include "util/portable_endian.h"
 
@@ -351,6 +356,37 @@ class CompactIntsKey {
     return (os.str());
   }
 
+  /*
+   * ToValue() - Extracts the value of a key column
+   *
+   * Columns are stored one after another in the order of the key schema,
+   * so the offset of a column is the total size of the columns before it
+   */
+  inline type::Value ToValue(const catalog::Schema *key_schema,
+                             int column_id) const {
+    size_t offset = 0;
+    for (int i = 0; i < column_id; i++) {
+      offset += type::Type::GetTypeSize(key_schema->GetType(i));
+    }
+
+    switch (key_schema->GetType(column_id)) {
+      case type::TypeId::BIGINT:
+        return type::ValueFactory::GetBigIntValue(GetInteger<int64_t>(offset));
+      case type::TypeId::INTEGER:
+        return type::ValueFactory::GetIntegerValue(
+            GetInteger<int32_t>(offset));
+      case type::TypeId::SMALLINT:
+        return type::ValueFactory::GetSmallIntValue(
+            GetInteger<int16_t>(offset));
+      case type::TypeId::TINYINT:
+        return type::ValueFactory::GetTinyIntValue(GetInteger<int8_t>(offset));
+      default:
+        throw IndexException(
+            "We currently only support a specific set of "
+            "column index sizes...");
+    }
+  }
+
  private:
   /*
    * SetFromColumn() - Sets the value of a column into a given offset of
@@ -579,6 +615,115 @@ class CompactIntsComparator {
                          const CompactIntsKey<KeySize> &rhs) const {
     return CompactIntsKey<KeySize>::LessThan(lhs, rhs);
   }
+
+  /*
+   * HAS_KEY_ARRAY_SEARCH - The BwTree searches its nodes with
+   *                        CountKeysBefore() instead of this comparator
+   *
+   * Only single word keys, since they compare as one unsigned integer
+   */
+  static constexpr bool HAS_KEY_ARRAY_SEARCH = (KeySize == 1);
+
+  // Binary search stops at this many keys, which are compared by vectors
+  static constexpr size_t KEY_ARRAY_SEARCH_WINDOW = 16;
+
+  /*
+   * CountKeysBefore() - The number of keys in a sorted array less than the
+   *                     search key, or not greater than it if inclusive
+   *
+   * The keys are stride bytes apart, as in an array of pairs with keys
+   * first. A binary search narrows the array down to a window whose keys
+   * are then gathered into vectors and compared all at once.
+   */
+  static size_t CountKeysBefore(const unsigned char *key_array_p,
+                                size_t stride, size_t key_count,
+                                const CompactIntsKey<KeySize> &search_key,
+                                bool inclusive) {
+    static_assert(KeySize == 1, "Only single word keys are searched");
+
+    uint64_t search_word = LoadWord(search_key.GetRawData());
+
+    size_t low = 0;
+    size_t high = key_count;
+    while (high - low > KEY_ARRAY_SEARCH_WINDOW) {
+      size_t mid = low + (high - low) / 2;
+      uint64_t word = LoadWord(key_array_p + mid * stride);
+      if (word < search_word || (inclusive == true && word == search_word)) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+
+    // The keys of the window before the search key are a prefix of it
+    const unsigned char *window_p = key_array_p + low * stride;
+    size_t window_size = high - low;
+    size_t count = 0;
+    size_t i = 0;
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    const __m512i index = _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride,
+                                           4 * stride, 3 * stride, 2 * stride,
+                                           stride, 0);
+    const __m512i byte_swap = _mm512_set4_epi32(0x08090A0B, 0x0C0D0E0F,
+                                                0x00010203, 0x04050607);
+    const __m512i search_vector = _mm512_set1_epi64(search_word);
+    for (; i + 8 <= window_size; i += 8) {
+      __m512i words = _mm512_shuffle_epi8(
+          _mm512_i64gather_epi64(index, window_p + i * stride, 1), byte_swap);
+      __mmask8 before =
+          inclusive == true
+              ? _mm512_cmple_epu64_mask(words, search_vector)
+              : _mm512_cmplt_epu64_mask(words, search_vector);
+      count += __builtin_popcount(before);
+    }
+#elif defined(__AVX2__)
+    // AVX2 only compares signed words, so the sign bits are flipped first
+    const __m256i index = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+    const __m256i byte_swap =
+        _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                        8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i sign_bit = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i search_vector =
+        _mm256_xor_si256(_mm256_set1_epi64x(search_word), sign_bit);
+    for (; i + 4 <= window_size; i += 4) {
+      __m256i words = _mm256_xor_si256(
+          _mm256_shuffle_epi8(
+              _mm256_i64gather_epi64(
+                  reinterpret_cast<const long long *>(window_p + i * stride),
+                  index, 1),
+              byte_swap),
+          sign_bit);
+      if (inclusive == true) {
+        // Not greater than the search key
+        int after = _mm256_movemask_pd(
+            _mm256_castsi256_pd(_mm256_cmpgt_epi64(words, search_vector)));
+        count += 4 - __builtin_popcount(after);
+      } else {
+        int before = _mm256_movemask_pd(
+            _mm256_castsi256_pd(_mm256_cmpgt_epi64(search_vector, words)));
+        count += __builtin_popcount(before);
+      }
+    }
+#endif
+
+    for (; i < window_size; i++) {
+      uint64_t word = LoadWord(window_p + i * stride);
+      if (word < search_word || (inclusive == true && word == search_word)) {
+        count++;
+      }
+    }
+
+    return low + count;
+  }
+
+ private:
+  // The big endian key bytes as an integer that compares like the key
+  static inline uint64_t LoadWord(const unsigned char *data_p) {
+    uint64_t word;
+    memcpy(&word, data_p, sizeof(word));
+    return be64toh(word);
+  }
 };
 
 /*
@@ -13,6 +13,7 @@
 #pragma once
 
 #include "type/type_util.h"
+#include "type/value_ref.h"
 
 namespace peloton {
 namespace index {
@@ -46,6 +47,13 @@ class GenericKey {
     return type::Value::DeserializeFrom(data_ptr, column_type, is_inlined);
   }
 
+  // A view of the value of the column that is read without a virtual call
+  inline type::ValueRef ToValueRef(const catalog::Schema *schema,
+                                   int column_id) const {
+    return type::ValueRef(schema->GetType(column_id),
+                          &data[schema->GetOffset(column_id)]);
+  }
+
   inline const char *GetRawData(const catalog::Schema *schema,
                                 int column_id) const {
     const char *data_ptr = &data[schema->GetOffset(column_id)];
@@ -68,17 +76,13 @@ class GenericComparator {
                          const GenericKey<KeySize> &rhs) const {
     auto schema = lhs.schema;
 
-    type::Value lhs_value;
-    type::Value rhs_value;
-
     for (oid_t col_itr = 0; col_itr < schema->GetColumnCount(); col_itr++) {
-      const type::Value lhs_value = (lhs.ToValue(schema, col_itr));
-      const type::Value rhs_value = (rhs.ToValue(schema, col_itr));
+      int result = lhs.ToValueRef(schema, col_itr)
+                       .Compare(rhs.ToValueRef(schema, col_itr));
 
-      if (lhs_value.CompareLessThan(rhs_value) == type::CMP_TRUE) return true;
+      if (result < 0) return true;
 
-      if (lhs_value.CompareGreaterThan(rhs_value) == type::CMP_TRUE)
-        return false;
+      if (result > 0) return false;
     }
 
     return false;
@@ -134,14 +138,12 @@ class GenericComparatorRaw {
 
     for (oid_t column_itr = 0; column_itr < schema->GetColumnCount();
          column_itr++) {
-      const type::Value lhs_value = (lhs.ToValue(schema, column_itr));
-      const type::Value rhs_value = (rhs.ToValue(schema, column_itr));
+      int result = lhs.ToValueRef(schema, column_itr)
+                       .Compare(rhs.ToValueRef(schema, column_itr));
 
-      if (lhs_value.CompareLessThan(rhs_value) == type::CMP_TRUE)
-        return VALUE_COMPARE_LESSTHAN;
+      if (result < 0) return VALUE_COMPARE_LESSTHAN;
 
-      if (lhs_value.CompareGreaterThan(rhs_value) == type::CMP_TRUE)
-        return VALUE_COMPARE_GREATERTHAN;
+      if (result > 0) return VALUE_COMPARE_GREATERTHAN;
     }
 
     /* equal */
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.h
+//
+// Identification: src/include/index/hash_index.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "libcuckoo/cuckoohash_map.hh"
+
+#include "common/platform.h"
+#include "index/index.h"
+#include "type/types.h"
+
+#define HASH_INDEX_TEMPLATE_ARGUMENTS                                      \
+  template <typename KeyType, typename ValueType, typename KeyComparator, \
+            typename KeyEqualityChecker, typename KeyHashFunc,            \
+            typename ValueEqualityChecker>
+
+#define HASH_INDEX_TYPE                                                   \
+  HashIndex<KeyType, ValueType, KeyComparator, KeyEqualityChecker,        \
+            KeyHashFunc, ValueEqualityChecker>
+
+namespace peloton {
+namespace index {
+
+/**
+ * Hash index on a concurrent cuckoo hash map, for point queries.
+ *
+ * A key maps to the list of its values, which is changed under the bucket
+ * locks of the map, and the map grows as it fills. Scans that are not point
+ * queries walk the whole map, and sort the values by key when their order
+ * matters.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator,
+          typename KeyEqualityChecker, typename KeyHashFunc,
+          typename ValueEqualityChecker>
+class HashIndex : public Index {
+  friend class IndexFactory;
+
+  using MapType = cuckoohash_map<KeyType, std::vector<ValueType>, KeyHashFunc,
+                                 KeyEqualityChecker>;
+
+ public:
+  HashIndex(IndexMetadata *metadata);
+
+  ~HashIndex();
+
+  bool InsertEntry(const storage::Tuple *key, ItemPointer *value);
+
+  bool DeleteEntry(const storage::Tuple *key, ItemPointer *value);
+
+  bool CondInsertEntry(const storage::Tuple *key, ItemPointer *value,
+                       std::function<bool(const void *)> predicate);
+
+  void Scan(const std::vector<type::Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            ScanDirectionType scan_direction, std::vector<ValueType> &result,
+            const ConjunctionScanPredicate *csp_p);
+
+  void ScanLimit(const std::vector<type::Value> &values,
+                 const std::vector<oid_t> &key_column_ids,
+                 const std::vector<ExpressionType> &expr_types,
+                 ScanDirectionType scan_direction,
+                 std::vector<ValueType> &result,
+                 const ConjunctionScanPredicate *csp_p, uint64_t limit,
+                 uint64_t offset);
+
+  void ScanAllKeys(std::vector<ValueType> &result);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ValueType> &result);
+
+  std::string GetTypeName() const;
+
+  size_t GetMemoryFootprint() {
+    return container.bucket_count() * container.slot_per_bucket *
+           sizeof(typename MapType::value_type);
+  }
+
+  // The map frees the values as they are deleted
+  bool NeedGC() { return false; }
+
+  void PerformGC() { return; }
+
+ private:
+  // The key-value pairs in the range of the scan predicate, in key order if
+  // is_ordered is set
+  void ScanRange(const ConjunctionScanPredicate *csp_p, bool is_ordered,
+                 std::vector<std::pair<KeyType, ValueType>> &pairs);
+
+ protected:
+  // equality checker and comparator
+  KeyComparator comparator;
+  KeyEqualityChecker equals;
+  ValueEqualityChecker value_equals;
+
+  // container
+  MapType container;
+};
+
+}  // End index namespace
+}  // End peloton namespace
@@ -34,6 +34,10 @@ namespace catalog {
 class Schema;
 }
 
+namespace expression {
+class AbstractExpression;
+}
+
 namespace storage {
 class Tuple;
 }
@@ -75,6 +79,9 @@ class IndexMetadata : public Printable {
 
   inline oid_t GetDatabaseOid() { return database_oid; }
 
+  // Where the threads count the accesses to the index
+  inline size_t GetStatsSlotId() const { return stats_slot_id_; }
+
   inline IndexType GetIndexType() { return index_type_; }
 
   IndexConstraintType GetIndexConstraintType() {
@@ -131,6 +138,29 @@ class IndexMetadata : public Printable {
 
   inline void SetVisibility(bool visibile) { visible_ = visibile; }
 
+  inline bool IsBuilding() const { return building_.load(); }
+
+  inline void SetBuilding(bool building) { building_ = building; }
+
+  // A partial index only holds the tuples that satisfy its predicate.
+  // The predicate refers to the columns of the base table.
+  inline const expression::AbstractExpression *GetPredicate() const {
+    return predicate_.get();
+  }
+
+  inline bool HasPredicate() const { return predicate_ != nullptr; }
+
+  // Columns of the base table that the predicate reads
+  inline const std::set<oid_t> &GetPredicateColumns() const {
+    return predicate_columns_;
+  }
+
+  void SetPredicate(
+      std::shared_ptr<const expression::AbstractExpression> predicate);
+
+  // Whether a tuple of the base table belongs into the index
+  bool SatisfiesPredicate(const AbstractTuple *tuple) const;
+
   /*
    * GetInfo() - Get a string representation for debugging
    */
@@ -182,16 +212,57 @@ class IndexMetadata : public Printable {
   // Whether keys are unique (e.g. primary key)
   const bool unique_keys;
 
+  // Dense id of the access counters of the index
+  const size_t stats_slot_id_;
+
   // utility of an index
   double utility_ratio = INVALID_RATIO;
 
   // If set to true, then this index is visible to the planner
   bool visible_;
 
+  // If set to true, then the index is populated in the background and
+  // writers must insert the keys of all new versions into it
+  std::atomic<bool> building_{false};
+
+  // Predicate of a partial index, null if all tuples are indexed
+  std::shared_ptr<const expression::AbstractExpression> predicate_;
+
+  std::set<oid_t> predicate_columns_;
+
   // This is a magic flag that tells us whether new
   static bool index_default_visibility;
 };
 
+/////////////////////////////////////////////////////////////////////
+// IndexStructureStats definition
+/////////////////////////////////////////////////////////////////////
+
+/*
+ * struct IndexStructureStats - Snapshot of the counters an index keeps about
+ *                              its own structure and memory reclamation
+ *
+ * The counts are totals since the index was created. Indexes that do not
+ * keep a counter leave it at 0
+ */
+struct IndexStructureStats {
+  // Delta chains or nodes rewritten into a compact node
+  uint64_t consolidation_count = 0;
+
+  uint64_t split_count = 0;
+  uint64_t merge_count = 0;
+
+  // Atomic installs that lost against another thread and were retried
+  uint64_t cas_failure_count = 0;
+
+  // Epochs whose garbage was not freed yet, and the garbage in them
+  uint64_t epoch_count = 0;
+  uint64_t garbage_node_count = 0;
+
+  // Delta chain length at which leaf nodes are consolidated now
+  int64_t delta_chain_threshold = 0;
+};
+
 /////////////////////////////////////////////////////////////////////
 // Index class definition
 /////////////////////////////////////////////////////////////////////
@@ -251,6 +322,17 @@ class Index : public Printable {
   virtual bool CondInsertEntry(const storage::Tuple *key, ItemPointer *location,
                                std::function<bool(const void *)> predicate) = 0;
 
+  // Load the key-location pairs into an empty index at once, which is much
+  // faster than inserting them one by one. The locations must be distinct.
+  // Return false without loading anything if the index is not empty, does not
+  // support bulk loading or, for a unique index, two pairs share a key; the
+  // caller should then insert the pairs one by one
+  virtual bool BulkLoad(
+      UNUSED_ATTRIBUTE const std::vector<
+          std::pair<std::unique_ptr<storage::Tuple>, ItemPointer *>> &entries) {
+    return false;
+  }
+
   ///////////////////////////////////////////////////////////////////
   // Index Scan
   ///////////////////////////////////////////////////////////////////
@@ -279,11 +361,32 @@ class Index : public Printable {
                         const ScanDirectionType &scan_direction,
                         std::vector<ItemPointer *> &result);
 
+  // Scan like Scan() does, and also append the key of every value found to
+  // key_value_list, one value per key schema column. This lets covering
+  // scans produce tuples without fetching them from the table. Return false
+  // without scanning anything if the index cannot give back its keys
+  virtual bool ScanWithKeys(
+      UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+      UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+      UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+      UNUSED_ATTRIBUTE std::vector<ItemPointer *> &result,
+      UNUSED_ATTRIBUTE std::vector<type::Value> &key_value_list,
+      UNUSED_ATTRIBUTE const ConjunctionScanPredicate *csp_p) {
+    return false;
+  }
+
   virtual void ScanAllKeys(std::vector<ItemPointer *> &result) = 0;
 
   virtual void ScanKey(const storage::Tuple *key,
                        std::vector<ItemPointer *> &result) = 0;
 
+  // Look up a batch of keys, e.g. the values of an IN list or the probe keys
+  // of a join, and return the values of each key in results. Indexes that
+  // can overlap the lookups override this; by default the keys are scanned
+  // one by one
+  virtual void ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                        std::vector<std::vector<ItemPointer *>> &results);
+
   ///////////////////////////////////////////////////////////////////
   // Garbage Collection
   ///////////////////////////////////////////////////////////////////
@@ -363,6 +466,11 @@ class Index : public Printable {
   // Get the memory footprint
   virtual size_t GetMemoryFootprint() = 0;
 
+  // Get the structure modification and garbage collection counters
+  virtual IndexStructureStats GetStructureStats() {
+    return IndexStructureStats{};
+  }
+
   // Get the indexed tile group offset
   virtual size_t GetIndexedTileGroupOff() {
     return indexed_tile_group_offset.load();
@@ -47,6 +47,20 @@ class IndexFactory {
   static Index *GetSkipListIntsKeyIndex(IndexMetadata *metadata);
 
   static Index *GetSkipListGenericKeyIndex(IndexMetadata *metadata);
+
+  //===--------------------------------------------------------------------===//
+  // PELOTON::HASH
+  //===--------------------------------------------------------------------===//
+
+  static Index *GetHashIntsKeyIndex(IndexMetadata *metadata);
+
+  static Index *GetHashGenericKeyIndex(IndexMetadata *metadata);
+
+  //===--------------------------------------------------------------------===//
+  // PELOTON::ART
+  //===--------------------------------------------------------------------===//
+
+  static Index *GetARTIntsKeyIndex(IndexMetadata *metadata);
 };
 
 }  // End index namespace
@@ -16,6 +16,7 @@
 #include "common/macros.h"
 #include "index/index.h"
 #include "storage/tuple.h"
+#include "type/value_factory.h"
 #include "type/value_peeker.h"
 
 #include <boost/functional/hash.hpp>
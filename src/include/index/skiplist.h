@@ -12,6 +12,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
 namespace peloton {
 namespace index {
 
@@ -21,10 +29,910 @@ namespace index {
 #define SKIPLIST_TEMPLATE_ARGUMENTS                                       \
   template <typename KeyType, typename ValueType, typename KeyComparator, \
             typename KeyEqualityChecker, typename ValueEqualityChecker>
-template <typename KeyType, typename ValueType, typename KeyComparator,
-          typename KeyEqualityChecker, typename ValueEqualityChecker>
+
+/*
+ * class SkipList - Lock-free skip list of key-value pairs
+ *
+ * All nodes are linked on level 0 in key order, and a node of height h is
+ * also linked on the levels below h. The pairs of a key are adjacent, and a
+ * new pair is linked in front of the pairs of its key.
+ *
+ * A pair is deleted by marking the low bit of the next pointers of its node,
+ * top level first. The thread marking level 0 has deleted the pair. Searches
+ * unlink the marked nodes they pass, and the unlinked nodes are freed by the
+ * epoch manager once no thread that could still see them is left.
+ *
+ * With unique keys Insert() rejects a key that already has a pair, while
+ * ConditionalInsert() leaves that decision to its predicate (the index keeps
+ * the versions of a key that way). The same pair is never inserted twice.
+ */
+SKIPLIST_TEMPLATE_ARGUMENTS
 class SkipList {
-  // TODO: Add your declarations here
+ public:
+  using KeyValuePair = std::pair<KeyType, ValueType>;
+
+  // Levels of the head, which is the tallest a node could be
+  constexpr static int MAX_LEVEL = 32;
+
+  // Nodes unlinked between two garbage collections done by the writers
+  constexpr static size_t GC_THRESHOLD = 1024;
+
+  class ForwardIterator;
+  class ReverseIterator;
+
+ private:
+  /*
+   * struct SkipListNode - A pair and its next pointers, one per level
+   */
+  struct SkipListNode {
+    KeyValuePair item;
+
+    int height;
+
+    // The inserting and the deleting thread both release the node, and the
+    // last to do so hands it to the epoch manager. Either could still be
+    // linking or unlinking it while the other is done.
+    std::atomic<int> ref_count;
+
+    std::atomic<SkipListNode *> *next_list;
+
+    SkipListNode(const KeyType &key, const ValueType &value, int p_height)
+        : item{key, value},
+          height{p_height},
+          ref_count{2},
+          next_list{new std::atomic<SkipListNode *>[p_height]} {
+      for (int level = 0; level < height; level++) {
+        next_list[level].store(nullptr);
+      }
+    }
+
+    ~SkipListNode() { delete[] next_list; }
+  };
+
+  /*
+   * IsMarked() - Whether a next pointer is marked, i.e. its node is deleted
+   */
+  static inline bool IsMarked(const SkipListNode *node_p) {
+    return (reinterpret_cast<uintptr_t>(node_p) & 1UL) != 0;
+  }
+
+  static inline SkipListNode *Mark(const SkipListNode *node_p) {
+    return reinterpret_cast<SkipListNode *>(
+        reinterpret_cast<uintptr_t>(node_p) | 1UL);
+  }
+
+  static inline SkipListNode *Unmark(const SkipListNode *node_p) {
+    return reinterpret_cast<SkipListNode *>(
+        reinterpret_cast<uintptr_t>(node_p) & ~1UL);
+  }
+
+  /*
+   * IsDeleted() - Whether the pair of a node is deleted
+   */
+  static inline bool IsDeleted(const SkipListNode *node_p) {
+    return IsMarked(node_p->next_list[0].load());
+  }
+
+ public:
+  /*
+   * class EpochManager - Maintains a linked list of unlinked nodes
+   *                      until all threads entering epochs before the
+   *                      nodes were unlinked have exited
+   *
+   * This follows the epoch manager of the BwTree. The garbage collection
+   * is not thread-safe, the skip list runs one at a time.
+   */
+  class EpochManager {
+   public:
+    // The epoch counter is decreased by this while its epoch is freed
+    constexpr static int CLEARING_THREAD_COUNT = 0x7FFFFFFF;
+
+    /*
+     * struct GarbageNode - A linked list of garbages
+     */
+    struct GarbageNode {
+      SkipListNode *node_p;
+
+      // Only the head of the garbage list is contended
+      GarbageNode *next_p;
+    };
+
+    /*
+     * struct EpochNode - A linked list of epoch node that records thread count
+     *
+     * This struct is also the head of garbage node linked list, which worker
+     * threads CAS their garbage nodes onto
+     */
+    struct EpochNode {
+      std::atomic<int> active_thread_count;
+
+      std::atomic<GarbageNode *> garbage_list_p;
+
+      // Only maintained by the garbage collection
+      EpochNode *next_p;
+    };
+
+    EpochManager(SkipList *p_list_p) : list_p{p_list_p} {
+      current_epoch_p = new EpochNode{};
+      current_epoch_p.load()->active_thread_count = 0;
+      current_epoch_p.load()->garbage_list_p = nullptr;
+      current_epoch_p.load()->next_p = nullptr;
+
+      head_epoch_p = current_epoch_p.load();
+
+      garbage_count = 0;
+    }
+
+    /*
+     * Destructor - Free the garbage of every epoch
+     *
+     * No thread is in an epoch any more
+     */
+    ~EpochManager() {
+      // So that the head epoch is never the current one
+      current_epoch_p = nullptr;
+
+      ClearEpoch();
+
+      assert(head_epoch_p == nullptr);
+    }
+
+    /*
+     * JoinEpoch() - Let current thread join this epoch
+     *
+     * The nodes unlinked on and after the epoch are not freed before the
+     * thread leaves it
+     */
+    inline EpochNode *JoinEpoch() {
+      while (true) {
+        // The epoch joined must be the one returned
+        EpochNode *epoch_p = current_epoch_p.load();
+
+        int prev_count = epoch_p->active_thread_count.fetch_add(1);
+
+        // The epoch is being freed, and the current epoch has moved on
+        if (prev_count < 0) {
+          epoch_p->active_thread_count.fetch_sub(1);
+          continue;
+        }
+
+        return epoch_p;
+      }
+    }
+
+    /*
+     * LeaveEpoch() - Leave epoch a thread has once joined
+     */
+    inline void LeaveEpoch(EpochNode *epoch_p) {
+      epoch_p->active_thread_count.fetch_sub(1);
+    }
+
+    /*
+     * AddGarbageNode() - Add an unlinked node into the current epoch
+     *
+     * The current epoch cannot be freed, since the calling thread is in an
+     * epoch no later than it
+     */
+    void AddGarbageNode(SkipListNode *node_p) {
+      EpochNode *epoch_p = current_epoch_p.load();
+
+      GarbageNode *garbage_node_p = new GarbageNode;
+      garbage_node_p->node_p = node_p;
+      garbage_node_p->next_p = epoch_p->garbage_list_p.load();
+
+      // If the CAS fails next_p is reloaded with the head
+      while (epoch_p->garbage_list_p.compare_exchange_strong(
+                 garbage_node_p->next_p, garbage_node_p) == false) {
+      }
+
+      garbage_count.fetch_add(1);
+    }
+
+    /*
+     * CreateNewEpoch() - Create a new epoch node
+     */
+    void CreateNewEpoch() {
+      EpochNode *epoch_node_p = new EpochNode{};
+      epoch_node_p->active_thread_count = 0;
+      epoch_node_p->garbage_list_p = nullptr;
+      epoch_node_p->next_p = nullptr;
+
+      current_epoch_p.load()->next_p = epoch_node_p;
+      current_epoch_p = epoch_node_p;
+    }
+
+    /*
+     * ClearEpoch() - Sweep the chain of epoch and free memory
+     *
+     * The epochs are freed in order, until one is current or some thread
+     * is still in it
+     */
+    void ClearEpoch() {
+      while (head_epoch_p != nullptr) {
+        if (head_epoch_p == current_epoch_p.load()) {
+          break;
+        }
+
+        if (head_epoch_p->active_thread_count.load() != 0) {
+          break;
+        }
+
+        // A thread joined since the check. Those joining after this see a
+        // negative count and retry
+        if (head_epoch_p->active_thread_count.fetch_sub(
+                CLEARING_THREAD_COUNT) > 0) {
+          head_epoch_p->active_thread_count.fetch_add(CLEARING_THREAD_COUNT);
+          break;
+        }
+
+        GarbageNode *next_garbage_node_p = nullptr;
+        for (GarbageNode *garbage_node_p = head_epoch_p->garbage_list_p.load();
+             garbage_node_p != nullptr;
+             garbage_node_p = next_garbage_node_p) {
+          list_p->FreeNode(garbage_node_p->node_p);
+
+          next_garbage_node_p = garbage_node_p->next_p;
+          delete garbage_node_p;
+
+          garbage_count.fetch_sub(1);
+        }
+
+        EpochNode *next_epoch_node_p = head_epoch_p->next_p;
+        delete head_epoch_p;
+        head_epoch_p = next_epoch_node_p;
+      }
+    }
+
+    /*
+     * PerformGarbageCollection() - Free the epochs no thread is left in,
+     *                              then start a new one
+     */
+    void PerformGarbageCollection() {
+      ClearEpoch();
+      CreateNewEpoch();
+    }
+
+    size_t GetGarbageCount() const { return garbage_count.load(); }
+
+   private:
+    SkipList *list_p;
+
+    // Only accessed by the garbage collection
+    EpochNode *head_epoch_p;
+
+    std::atomic<EpochNode *> current_epoch_p;
+
+    // Nodes waiting to be freed
+    std::atomic<size_t> garbage_count;
+  };
+
+  /*
+   * class ForwardIterator - Iterates the pairs in key order
+   *
+   * The iterator stays in an epoch for its lifetime, so the node it is on is
+   * never freed, even if its pair gets deleted meanwhile
+   */
+  class ForwardIterator {
+   public:
+    ForwardIterator(SkipList *p_list_p)
+        : list_p{p_list_p},
+          epoch_node_p{p_list_p->epoch_manager.JoinEpoch()},
+          node_p{nullptr} {}
+
+    ForwardIterator(const ForwardIterator &other)
+        : list_p{other.list_p},
+          epoch_node_p{other.list_p->epoch_manager.JoinEpoch()},
+          node_p{other.node_p} {}
+
+    ForwardIterator &operator=(const ForwardIterator &) = delete;
+
+    ~ForwardIterator() { list_p->epoch_manager.LeaveEpoch(epoch_node_p); }
+
+    inline bool IsEnd() const { return node_p == nullptr; }
+
+    inline const KeyValuePair &operator*() const { return node_p->item; }
+
+    inline const KeyValuePair *operator->() const { return &node_p->item; }
+
+    /*
+     * operator++ - Move to the next pair not deleted
+     */
+    inline ForwardIterator &operator++() {
+      node_p = list_p->NextLiveNode(node_p);
+      return *this;
+    }
+
+   private:
+    friend class SkipList;
+
+    SkipList *list_p;
+
+    typename EpochManager::EpochNode *epoch_node_p;
+
+    SkipListNode *node_p;
+  };
+
+  /*
+   * class ReverseIterator - Iterates the pairs in reverse key order
+   *
+   * The nodes are not linked backwards, so a step back to the previous key
+   * searches for it from the head. The iterator copies the pairs of a key at
+   * a time and holds no node.
+   */
+  class ReverseIterator {
+   public:
+    ReverseIterator(SkipList *p_list_p) : list_p{p_list_p}, pair_index{0} {}
+
+    inline bool IsEnd() const { return key_pairs.empty(); }
+
+    inline const KeyValuePair &operator*() const {
+      return key_pairs[pair_index];
+    }
+
+    inline const KeyValuePair *operator->() const {
+      return &key_pairs[pair_index];
+    }
+
+    /*
+     * operator++ - Move to the previous pair, of this key or the one before
+     */
+    inline ReverseIterator &operator++() {
+      if (pair_index > 0) {
+        pair_index--;
+      } else {
+        KeyType key = key_pairs.front().first;
+        list_p->LoadLastKey(&key, false, *this);
+      }
+      return *this;
+    }
+
+   private:
+    friend class SkipList;
+
+    SkipList *list_p;
+
+    // The pairs of the current key, in key order
+    std::vector<KeyValuePair> key_pairs;
+
+    size_t pair_index;
+  };
+
+  SkipList(bool p_unique_keys,
+           const KeyComparator &p_key_cmp_obj = KeyComparator{},
+           const KeyEqualityChecker &p_key_eq_obj = KeyEqualityChecker{},
+           const ValueEqualityChecker &p_value_eq_obj = ValueEqualityChecker{})
+      : unique_keys{p_unique_keys},
+        key_cmp_obj{p_key_cmp_obj},
+        key_eq_obj{p_key_eq_obj},
+        value_eq_obj{p_value_eq_obj},
+        head_node_p{new SkipListNode(KeyType{}, ValueType{}, MAX_LEVEL)},
+        memory_footprint{0},
+        gc_flag{false},
+        last_gc_garbage_count{0},
+        epoch_manager{this} {}
+
+  /*
+   * Destructor - Free the nodes still linked
+   *
+   * No thread is using the skip list any more, so no node is half linked
+   */
+  ~SkipList() {
+    SkipListNode *node_p = head_node_p;
+    while (node_p != nullptr) {
+      SkipListNode *next_node_p = Unmark(node_p->next_list[0].load());
+      delete node_p;
+      node_p = next_node_p;
+    }
+  }
+
+  inline bool KeyCmpLess(const KeyType &key1, const KeyType &key2) const {
+    return key_cmp_obj(key1, key2);
+  }
+
+  inline bool KeyCmpEqual(const KeyType &key1, const KeyType &key2) const {
+    return key_eq_obj(key1, key2);
+  }
+
+  inline bool KeyCmpLessEqual(const KeyType &key1, const KeyType &key2) const {
+    return !KeyCmpLess(key2, key1);
+  }
+
+  inline bool ValueCmpEqual(const ValueType &value1,
+                            const ValueType &value2) const {
+    return value_eq_obj(value1, value2);
+  }
+
+  /*
+   * Insert() - Insert a pair
+   *
+   * Returns false if the pair is already in, or with unique keys if the key
+   * already has a pair
+   */
+  bool Insert(const KeyType &key, const ValueType &value) {
+    bool predicate_satisfied = false;
+    return InsertPair(key, value, nullptr, &predicate_satisfied);
+  }
+
+  /*
+   * ConditionalInsert() - Insert a pair unless the predicate holds for a
+   *                       pair of the key
+   *
+   * predicate_satisfied is set if the predicate held for some pair. Returns
+   * false if the pair was not inserted
+   */
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const void *)> predicate,
+                         bool *predicate_satisfied) {
+    *predicate_satisfied = false;
+    return InsertPair(key, value, predicate, predicate_satisfied);
+  }
+
+  /*
+   * Delete() - Delete a pair
+   *
+   * Returns false if the pair is not in
+   */
+  bool Delete(const KeyType &key, const ValueType &value) {
+    auto epoch_node_p = epoch_manager.JoinEpoch();
+
+    SkipListNode *preds[MAX_LEVEL];
+    SkipListNode *succs[MAX_LEVEL];
+    FindPosition(key, false, preds, succs);
+
+    SkipListNode *node_p = succs[0];
+    while (node_p != nullptr && KeyCmpEqual(node_p->item.first, key)) {
+      SkipListNode *next_node_p = node_p->next_list[0].load();
+      if (IsMarked(next_node_p) == false &&
+          ValueCmpEqual(node_p->item.second, value)) {
+        break;
+      }
+      node_p = Unmark(next_node_p);
+    }
+
+    if (node_p == nullptr || KeyCmpEqual(node_p->item.first, key) == false) {
+      epoch_manager.LeaveEpoch(epoch_node_p);
+      return false;
+    }
+
+    // Mark the levels above first so that no search links past the node
+    // once its pair is deleted
+    for (int level = node_p->height - 1; level > 0; level--) {
+      SkipListNode *next_node_p = node_p->next_list[level].load();
+      while (IsMarked(next_node_p) == false) {
+        node_p->next_list[level].compare_exchange_weak(next_node_p,
+                                                       Mark(next_node_p));
+      }
+    }
+
+    SkipListNode *next_node_p = node_p->next_list[0].load();
+    while (true) {
+      // Another thread deleted the pair first
+      if (IsMarked(next_node_p) == true) {
+        epoch_manager.LeaveEpoch(epoch_node_p);
+        return false;
+      }
+
+      if (node_p->next_list[0].compare_exchange_weak(next_node_p,
+                                                     Mark(next_node_p))) {
+        break;
+      }
+    }
+
+    // The search past the key unlinks the node on every level
+    FindPosition(key, true, preds, succs);
+    ReleaseNode(node_p);
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+
+    // The writers collect the garbage as it piles up
+    size_t garbage_count = epoch_manager.GetGarbageCount();
+    if (garbage_count >= last_gc_garbage_count.load() + GC_THRESHOLD) {
+      PerformGarbageCollection();
+    }
+
+    return true;
+  }
+
+  /*
+   * GetValue() - Fill the values of a key
+   */
+  void GetValue(const KeyType &search_key, std::vector<ValueType> &value_list) {
+    auto epoch_node_p = epoch_manager.JoinEpoch();
+
+    SkipListNode *preds[MAX_LEVEL];
+    SkipListNode *succs[MAX_LEVEL];
+    FindPosition(search_key, false, preds, succs);
+
+    for (SkipListNode *node_p = succs[0];
+         node_p != nullptr && KeyCmpEqual(node_p->item.first, search_key);
+         node_p = NextLiveNode(node_p)) {
+      if (IsDeleted(node_p) == false) {
+        value_list.push_back(node_p->item.second);
+      }
+    }
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+  }
+
+  /*
+   * Begin() - The iterator on the first pair
+   */
+  ForwardIterator Begin() {
+    ForwardIterator itr{this};
+    itr.node_p = NextLiveNode(head_node_p);
+    return itr;
+  }
+
+  /*
+   * Begin() - The iterator on the first pair not less than the key
+   */
+  ForwardIterator Begin(const KeyType &start_key) {
+    ForwardIterator itr{this};
+
+    SkipListNode *preds[MAX_LEVEL];
+    SkipListNode *succs[MAX_LEVEL];
+    FindPosition(start_key, false, preds, succs);
+
+    itr.node_p = succs[0];
+    if (itr.node_p != nullptr && IsDeleted(itr.node_p) == true) {
+      itr.node_p = NextLiveNode(itr.node_p);
+    }
+    return itr;
+  }
+
+  /*
+   * RBegin() - The iterator on the last pair
+   */
+  ReverseIterator RBegin() {
+    ReverseIterator itr{this};
+    LoadLastKey(nullptr, false, itr);
+    return itr;
+  }
+
+  /*
+   * RBegin() - The iterator on the last pair not greater than the key
+   */
+  ReverseIterator RBegin(const KeyType &start_key) {
+    ReverseIterator itr{this};
+    LoadLastKey(&start_key, true, itr);
+    return itr;
+  }
+
+  /*
+   * NeedGarbageCollection() - Whether there are unlinked nodes to free
+   */
+  bool NeedGarbageCollection() const {
+    return epoch_manager.GetGarbageCount() > 0;
+  }
+
+  /*
+   * PerformGarbageCollection() - Free the unlinked nodes no thread sees
+   *
+   * Skipped if another thread is collecting
+   */
+  void PerformGarbageCollection() {
+    if (gc_flag.exchange(true) == true) {
+      return;
+    }
+
+    epoch_manager.PerformGarbageCollection();
+    last_gc_garbage_count = epoch_manager.GetGarbageCount();
+
+    gc_flag.store(false);
+  }
+
+  /*
+   * GetMemoryFootprint() - Bytes of the nodes, freed or not
+   */
+  size_t GetMemoryFootprint() const { return memory_footprint.load(); }
+
+ private:
+  /*
+   * RandomHeight() - Height of a new node, 1/4 of the nodes of a level are
+   *                  also on the next
+   */
+  static int RandomHeight() {
+    static thread_local uint64_t seed =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) | 1UL;
+
+    // xorshift
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+
+    int height = 1;
+    uint64_t bits = seed;
+    while (height < MAX_LEVEL && (bits & 3UL) == 0) {
+      height++;
+      bits >>= 2;
+    }
+    return height;
+  }
+
+  static size_t GetNodeSize(int height) {
+    return sizeof(SkipListNode) + height * sizeof(std::atomic<SkipListNode *>);
+  }
+
+  /*
+   * FindPosition() - Fill the nodes around the key on every level
+   *
+   * preds[level] is the last node before the key and succs[level] is the
+   * node after it. The position is before the pairs of the key, or after
+   * them if after_equal is set. The marked nodes passed are unlinked.
+   *
+   * The pairs of a key need not be in the same order on every level, so the
+   * search goes down from before the key and then walks past its pairs.
+   */
+  void FindPosition(const KeyType &key, bool after_equal, SkipListNode **preds,
+                    SkipListNode **succs) {
+  retry:
+    SkipListNode *pred_node_p = head_node_p;
+    for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+      SkipListNode *curr_node_p = nullptr;
+      if (WalkLevel(key, false, level, pred_node_p, curr_node_p) == false) {
+        goto retry;
+      }
+
+      preds[level] = pred_node_p;
+      succs[level] = curr_node_p;
+      if (after_equal == true &&
+          WalkLevel(key, true, level, preds[level], succs[level]) == false) {
+        goto retry;
+      }
+    }
+  }
+
+  /*
+   * WalkLevel() - Move along a level from the node up to the first node
+   *               not before the key, or after it if after_equal is set
+   *
+   * The marked nodes passed are unlinked. Returns false if an unlink failed
+   * because the predecessor changed or got marked itself
+   */
+  bool WalkLevel(const KeyType &key, bool after_equal, int level,
+                 SkipListNode *&pred_node_p, SkipListNode *&curr_node_p) {
+    curr_node_p = Unmark(pred_node_p->next_list[level].load());
+
+    while (curr_node_p != nullptr) {
+      SkipListNode *succ_node_p = curr_node_p->next_list[level].load();
+
+      if (IsMarked(succ_node_p) == true) {
+        SkipListNode *expected_node_p = curr_node_p;
+        if (pred_node_p->next_list[level].compare_exchange_strong(
+                expected_node_p, Unmark(succ_node_p)) == false) {
+          return false;
+        }
+        curr_node_p = Unmark(succ_node_p);
+        continue;
+      }
+
+      bool is_before = after_equal
+                           ? KeyCmpLessEqual(curr_node_p->item.first, key)
+                           : KeyCmpLess(curr_node_p->item.first, key);
+      if (is_before == false) {
+        break;
+      }
+
+      pred_node_p = curr_node_p;
+      curr_node_p = succ_node_p;
+    }
+
+    return true;
+  }
+
+  /*
+   * NextLiveNode() - The next node on level 0 whose pair is not deleted
+   */
+  SkipListNode *NextLiveNode(const SkipListNode *node_p) {
+    SkipListNode *next_node_p = Unmark(node_p->next_list[0].load());
+    while (next_node_p != nullptr && IsDeleted(next_node_p) == true) {
+      next_node_p = Unmark(next_node_p->next_list[0].load());
+    }
+    return next_node_p;
+  }
+
+  /*
+   * InsertPair() - Link a new node in front of the pairs of its key
+   *
+   * A predicate of nullptr inserts unconditionally
+   */
+  bool InsertPair(const KeyType &key, const ValueType &value,
+                  const std::function<bool(const void *)> &predicate,
+                  bool *predicate_satisfied) {
+    auto epoch_node_p = epoch_manager.JoinEpoch();
+
+    SkipListNode *preds[MAX_LEVEL];
+    SkipListNode *succs[MAX_LEVEL];
+    SkipListNode *node_p = nullptr;
+
+    while (true) {
+      FindPosition(key, false, preds, succs);
+
+      // The new node goes in front of the pairs checked, so the CAS below
+      // fails if a pair of the key came in since
+      bool is_rejected = false;
+      for (SkipListNode *curr_node_p = succs[0];
+           curr_node_p != nullptr &&
+               KeyCmpEqual(curr_node_p->item.first, key);
+           curr_node_p = NextLiveNode(curr_node_p)) {
+        if (IsDeleted(curr_node_p) == true) {
+          continue;
+        }
+
+        if (predicate != nullptr) {
+          if (predicate(curr_node_p->item.second) == true) {
+            *predicate_satisfied = true;
+            is_rejected = true;
+            break;
+          }
+        } else if (unique_keys == true) {
+          is_rejected = true;
+          break;
+        }
+
+        if (ValueCmpEqual(curr_node_p->item.second, value) == true) {
+          is_rejected = true;
+          break;
+        }
+      }
+
+      if (is_rejected == true) {
+        if (node_p != nullptr) {
+          FreeNode(node_p);
+        }
+        epoch_manager.LeaveEpoch(epoch_node_p);
+        return false;
+      }
+
+      if (node_p == nullptr) {
+        int height = RandomHeight();
+        node_p = new SkipListNode(key, value, height);
+        memory_footprint.fetch_add(GetNodeSize(height));
+      }
+
+      node_p->next_list[0].store(succs[0]);
+      SkipListNode *expected_node_p = succs[0];
+      if (preds[0]->next_list[0].compare_exchange_strong(expected_node_p,
+                                                         node_p) == true) {
+        break;
+      }
+    }
+
+    // The pair is in, the levels above only speed up the searches. A mark
+    // on a level means the pair is being deleted, so stop linking
+    bool is_linking = true;
+    for (int level = 1; level < node_p->height && is_linking == true;
+         level++) {
+      while (true) {
+        SkipListNode *next_node_p = node_p->next_list[level].load();
+        if (IsMarked(next_node_p) == true ||
+            node_p->next_list[level].compare_exchange_strong(
+                next_node_p, succs[level]) == false) {
+          is_linking = false;
+          break;
+        }
+
+        SkipListNode *expected_node_p = succs[level];
+        if (preds[level]->next_list[level].compare_exchange_strong(
+                expected_node_p, node_p) == true) {
+          break;
+        }
+
+        FindPosition(key, false, preds, succs);
+      }
+    }
+
+    // The pair got deleted while the node was being linked, and the delete
+    // might have searched past the levels linked last
+    if (IsDeleted(node_p) == true) {
+      FindPosition(key, true, preds, succs);
+    }
+    ReleaseNode(node_p);
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+    return true;
+  }
+
+  /*
+   * LoadLastKey() - Point the iterator at the last pair of the last key
+   *                 before the bound, or not after it if inclusive is set
+   *
+   * Without a bound it is the last key. If all pairs of that key get
+   * deleted meanwhile, the key before is tried
+   */
+  void LoadLastKey(const KeyType *bound_key_p, bool inclusive,
+                   ReverseIterator &itr) {
+    auto epoch_node_p = epoch_manager.JoinEpoch();
+
+    itr.key_pairs.clear();
+    itr.pair_index = 0;
+
+    // Find the last node before the bound, higher levels first
+    KeyType bound_key;
+    bool has_bound = bound_key_p != nullptr;
+    if (has_bound == true) {
+      bound_key = *bound_key_p;
+    }
+
+    while (itr.key_pairs.empty() == true) {
+      SkipListNode *pred_node_p = head_node_p;
+      for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+        SkipListNode *curr_node_p =
+            Unmark(pred_node_p->next_list[level].load());
+        while (curr_node_p != nullptr &&
+               (has_bound == false ||
+                (inclusive == true
+                     ? KeyCmpLessEqual(curr_node_p->item.first, bound_key)
+                     : KeyCmpLess(curr_node_p->item.first, bound_key)))) {
+          pred_node_p = curr_node_p;
+          curr_node_p = Unmark(curr_node_p->next_list[level].load());
+        }
+      }
+
+      if (pred_node_p == head_node_p) {
+        break;
+      }
+
+      // Copy the pairs of its key, in key order
+      bound_key = pred_node_p->item.first;
+      SkipListNode *preds[MAX_LEVEL];
+      SkipListNode *succs[MAX_LEVEL];
+      FindPosition(bound_key, false, preds, succs);
+
+      for (SkipListNode *node_p = succs[0];
+           node_p != nullptr && KeyCmpEqual(node_p->item.first, bound_key);
+           node_p = NextLiveNode(node_p)) {
+        if (IsDeleted(node_p) == false) {
+          itr.key_pairs.push_back(node_p->item);
+        }
+      }
+
+      // The key before is the bound of the next try
+      has_bound = true;
+      inclusive = false;
+    }
+
+    if (itr.key_pairs.empty() == false) {
+      itr.pair_index = itr.key_pairs.size() - 1;
+    }
+
+    epoch_manager.LeaveEpoch(epoch_node_p);
+  }
+
+  /*
+   * ReleaseNode() - Drop a reference to a node, the last hands it to the
+   *                 epoch manager
+   */
+  void ReleaseNode(SkipListNode *node_p) {
+    if (node_p->ref_count.fetch_sub(1) == 1) {
+      epoch_manager.AddGarbageNode(node_p);
+    }
+  }
+
+  void FreeNode(SkipListNode *node_p) {
+    memory_footprint.fetch_sub(GetNodeSize(node_p->height));
+    delete node_p;
+  }
+
+  bool unique_keys;
+
+  KeyComparator key_cmp_obj;
+
+  KeyEqualityChecker key_eq_obj;
+
+  ValueEqualityChecker value_eq_obj;
+
+  // The head is on every level and holds no pair
+  SkipListNode *head_node_p;
+
+  std::atomic<size_t> memory_footprint;
+
+  // Set while a thread is collecting the garbage
+  std::atomic<bool> gc_flag;
+
+  std::atomic<size_t> last_gc_garbage_count;
+
+  EpochManager epoch_manager;
 };
 
 }  // End index namespace
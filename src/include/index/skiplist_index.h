@@ -78,14 +78,20 @@ class SkipListIndex : public Index {
 
   std::string GetTypeName() const;
 
-  // TODO: Implement this
-  size_t GetMemoryFootprint() { return 0; }
+  size_t GetMemoryFootprint() { return container.GetMemoryFootprint(); }
 
-  // TODO: Implement this
-  bool NeedGC() { return false; }
+  bool NeedGC() { return container.NeedGarbageCollection(); }
 
-  // TODO: Implement this
-  void PerformGC() { return; }
+  void PerformGC() {
+    container.PerformGarbageCollection();
+
+    return;
+  }
+
+ private:
+  void ScanRange(const ConjunctionScanPredicate *csp_p,
+                 ScanDirectionType scan_direction, uint64_t limit,
+                 uint64_t offset, std::vector<ValueType> &result);
 
  protected:
   // equality checker and comparator
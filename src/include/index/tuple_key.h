@@ -115,6 +115,13 @@ class TupleKey {
     else
       return column_indices[indexColumn];
   }
+
+  // Return the value of the column_id'th key-schema column.
+  inline type::Value ToValue(UNUSED_ATTRIBUTE const catalog::Schema *schema,
+                             int column_id) const {
+    return GetTupleForComparison(key_tuple_schema)
+        .GetValue(ColumnForIndexColumn(column_id));
+  }
 };
 
 /*
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 #include <thread>
 
@@ -22,6 +23,11 @@
 #include "type/types.h"
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
@@ -61,6 +67,28 @@ class CheckpointManager {
 
   virtual size_t GetTableCount() { return 0; }
 
+  // Take a checkpoint now. Returns its epoch, or INVALID_EID if none was
+  // taken.
+  virtual eid_t DoCheckpoint() { return INVALID_EID; }
+
+  // Epoch and table files of the latest complete checkpoint, INVALID_EID if
+  // there is none
+  virtual eid_t GetLatestCheckpoint(
+      std::vector<std::string> &checkpoint_paths UNUSED_ATTRIBUTE) {
+    return INVALID_EID;
+  }
+
+  // Map the table snapshots among the files of a checkpoint into their
+  // tables, and remove them from the paths. The indexes of the tables are
+  // filled by the threads started, which the caller joins. Returns the
+  // tables that were loaded.
+  virtual std::vector<storage::DataTable *> LoadSnapshots(
+      std::vector<std::string> &checkpoint_paths UNUSED_ATTRIBUTE,
+      std::vector<std::unique_ptr<std::thread>> &index_threads
+          UNUSED_ATTRIBUTE) {
+    return {};
+  }
+
  protected:
   volatile bool is_running_;
 };
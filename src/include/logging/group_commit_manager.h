@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// group_commit_manager.h
+//
+// Identification: src/include/logging/group_commit_manager.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "container/lock_free_queue.h"
+#include "logging/log_stats.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace logging {
+
+// Called with the result of the transaction once its commit is acknowledged
+typedef std::function<void(const ResultType)> CommitCallback;
+
+//===--------------------------------------------------------------------===//
+// Group Commit Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background task that acknowledges committed transactions one epoch at a
+ * time.
+ *
+ * A transaction is installed in memory by the worker thread that commits it.
+ * Its acknowledgement is queued with the epoch it ran in. An epoch is durable
+ * once no transaction of it is still running and the log manager has
+ * persisted its log buffers. The acknowledgements of all transactions of the
+ * durable epochs are then delivered together from the group commit thread,
+ * so the workers never wait for the log.
+ *
+ * The time from the enqueue of a commit to its acknowledgement is recorded,
+ * which is the commit latency seen by the client.
+ */
+class GroupCommitManager {
+ public:
+  GroupCommitManager(const GroupCommitManager &) = delete;
+  GroupCommitManager &operator=(const GroupCommitManager &) = delete;
+  GroupCommitManager(GroupCommitManager &&) = delete;
+  GroupCommitManager &operator=(GroupCommitManager &&) = delete;
+
+  GroupCommitManager();
+
+  ~GroupCommitManager();
+
+  // Singleton
+  static GroupCommitManager &GetInstance();
+
+  // Start acknowledging commits
+  void Start();
+
+  // Group commit loop
+  void Acknowledge();
+
+  // Stop acknowledging commits. The pending ones are acknowledged first.
+  void Stop();
+
+  bool IsRunning() const { return group_commit_stop == false; }
+
+  // Acknowledge a transaction that committed in the epoch once the epoch is
+  // durable
+  void EnqueueCommit(const eid_t epoch_id, const CommitCallback &callback);
+
+  // Acknowledge the pending commits of the epochs up to the durable epoch.
+  // Returns the number of acknowledged transactions.
+  size_t AcknowledgeCommits(const eid_t durable_epoch_id);
+
+  // Latest epoch whose transactions are all finished and logged
+  eid_t GetDurableEpochId();
+
+  size_t GetPendingCommitCount();
+
+  // Latencies (in us) of the commits acknowledged since the last reset
+  LatencyHistogram GetCommitLatencies();
+
+  void ResetCommitLatencies();
+
+ private:
+  struct PendingCommit {
+    eid_t epoch_id;
+    CommitCallback callback;
+    // steady clock time of the enqueue (in us)
+    uint64_t enqueue_time;
+  };
+
+  // Move the commits handed over by the workers to the pending ones. Needs
+  // the pending commits lock.
+  void DrainCommitQueue();
+
+  // Commits handed over by the workers
+  LockFreeQueue<PendingCommit> commit_queue;
+
+  // Commits waiting for their epoch, in epoch order
+  std::multimap<eid_t, PendingCommit> pending_commits;
+
+  // guards pending_commits and commit_latencies
+  std::mutex pending_commits_mutex;
+
+  LatencyHistogram commit_latencies;
+
+  // Stop signal
+  std::atomic<bool> group_commit_stop;
+
+  // Group commit thread
+  std::thread group_commit_thread;
+};
+
+//===--------------------------------------------------------------------===//
+// Commit Waiter
+//===--------------------------------------------------------------------===//
+
+/**
+ * The commits of a client that wait for their epochs to become durable. The
+ * client learns once all of them are acknowledged, which is when the replies
+ * to the statements that committed them may be sent.
+ *
+ * It is shared with the callbacks of the pending commits, which may run on
+ * the group commit thread after the client is gone.
+ */
+class CommitWaiter {
+ public:
+  // The callback of a commit to wait for
+  CommitCallback AddCommit(const std::shared_ptr<CommitWaiter> &self);
+
+  // Run the callback once all pending commits are acknowledged, on the thread
+  // that acknowledges the last one. Returns false, without running it, if no
+  // commit is pending.
+  bool OnAcknowledged(std::function<void()> callback);
+
+  size_t GetPendingCommitCount();
+
+ private:
+  void Acknowledge();
+
+  std::mutex mutex_;
+
+  size_t pending_count_ = 0;
+
+  std::function<void()> callback_;
+};
+
+}  // End logging namespace
+}  // End peloton namespace
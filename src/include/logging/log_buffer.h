@@ -31,7 +31,7 @@ private:
 
 public:
   LogBuffer(const size_t thread_id, const size_t eid) : 
-      thread_id_(thread_id), eid_(eid), size_(0){
+      thread_id_(thread_id), eid_(eid), size_(0), frame_count_(0){
     data_ = new char[log_buffer_capacity_];
     PL_MEMSET(data_, 0, log_buffer_capacity_);
   }
@@ -40,7 +40,7 @@ public:
     data_ = nullptr;
   }
 
-  inline void Reset() { size_ = 0; eid_ = INVALID_EID; }
+  inline void Reset() { size_ = 0; eid_ = INVALID_EID; frame_count_ = 0; }
 
   inline char *GetData() { return data_; }
 
@@ -52,12 +52,16 @@ public:
 
   inline bool Empty() { return size_ == 0; }
 
+  // Number of successful writes, each one a frame of the log
+  inline size_t GetFrameCount() { return frame_count_; }
+
   bool WriteData(const char *data, size_t len);
 
 private:
   size_t thread_id_;
   size_t eid_;
   size_t size_;
+  size_t frame_count_;
   char* data_;
 };
 
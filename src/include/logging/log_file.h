@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_file.h
+//
+// Identification: src/include/logging/log_file.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <string>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Log File
+//===--------------------------------------------------------------------===//
+
+// Append-only log segment written in batches. The data appended between two
+// flushes is gathered into as few writes as possible, and made durable with
+// a single fdatasync. The space ahead of the end of the file is preallocated
+// in large extents without changing its size, so the syncs of the appends
+// rarely have block allocations to commit and the file stays contiguous.
+//
+// On the NVM backend the segment is mapped from a persistent memory (DAX)
+// file system instead. A flush copies the data into the mapping and makes it
+// durable with cache line write backs and a fence, without any block I/O.
+// The file then starts with a header holding the size of the durable data,
+// which is only updated once the data is persisted, so the region past it
+// never holds a torn frame. A file system without DAX support falls back
+// to msync.
+class LogFile {
+ public:
+  LogFile(const LogFile &) = delete;
+  LogFile &operator=(const LogFile &) = delete;
+  LogFile(LogFile &&) = delete;
+  LogFile &operator=(LogFile &&) = delete;
+
+  LogFile()
+      : fd_(-1),
+        backend_type_(BackendType::SSD),
+        size_(0),
+        allocated_size_(0),
+        pending_size_(0),
+        mapping_(nullptr),
+        is_dax_mapping_(false) {}
+
+  ~LogFile() { Close(); }
+
+  // Open the file for appending, creating it if needed. A new file is
+  // mapped from persistent memory on the NVM backend, and written to
+  // otherwise. An existing file keeps the layout it was created with.
+  // Returns false if it cannot be opened.
+  bool Open(const std::string &path,
+            const BackendType backend_type = BackendType::SSD);
+
+  // Release the space preallocated past the end of the file and close it.
+  // The data not flushed yet is dropped.
+  void Close();
+
+  inline bool IsOpen() const { return fd_ >= 0; }
+
+  inline const std::string &GetPath() const { return path_; }
+
+  // NVM if the file is mapped from persistent memory
+  inline BackendType GetBackendType() const { return backend_type_; }
+
+  // Size of the data of the file, including the data not flushed yet
+  inline size_t GetSize() const { return size_ + pending_size_; }
+
+  // Queue the data for the next flush. It must stay valid until then.
+  void Append(const char *data, const size_t size);
+
+  // Write the queued data and make it durable. Returns false if it could
+  // not be, in which case the data is dropped.
+  bool Flush();
+
+  // Drop the data past the size. Nothing may be queued.
+  bool Truncate(const size_t size);
+
+  // Data of the file at the path, of either layout. Empty if it cannot be
+  // read.
+  static std::string ReadFile(const std::string &path);
+
+ private:
+  // make sure the blocks up to the size are allocated
+  void Preallocate(const size_t size);
+
+  bool FlushFile();
+
+  bool FlushMapping();
+
+  // map the header and the data up to the size, growing the file to it
+  bool MapFile(const size_t size);
+
+  void UnmapFile();
+
+  // make the range of the mapping durable
+  bool Persist(char *address, const size_t size);
+
+  // header of a mapped file
+  struct MappingHeader {
+    char magic[8];
+    // size of the durable data after the header
+    uint64_t size;
+  };
+
+  // the header fills a cache line, so the data it covers never shares one
+  static const size_t mapping_header_size_ = 64;
+
+  static const char mapping_magic_[8];
+
+  // preallocation step, also the size of the first extent
+  static const size_t preallocation_size_ = 1 << 26;  // 64 MB
+
+  int fd_;
+
+  std::string path_;
+
+  BackendType backend_type_;
+
+  // size of the data written
+  size_t size_;
+
+  // size of the preallocated blocks from the start of the file, or of the
+  // mapping
+  size_t allocated_size_;
+
+  std::vector<struct iovec> pending_;
+
+  size_t pending_size_;
+
+  char *mapping_;
+
+  // set if the cache line write backs make the mapping durable
+  bool is_dax_mapping_;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -22,6 +22,18 @@
 #include "type/types.h"
 
 namespace peloton {
+
+class CopySerializeOutput;
+class Statement;
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace type {
+class Value;
+}
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
@@ -61,16 +73,47 @@ class LogManager {
 
   virtual size_t GetTableCount() { return 0; }
 
-  virtual void LogBegin() {}
+  // Begin the records of a committing transaction
+  virtual void LogBegin(const eid_t epoch_id UNUSED_ATTRIBUTE,
+                        const cid_t commit_id UNUSED_ATTRIBUTE) {}
 
   virtual void LogEnd() {}
 
   virtual void LogInsert(const ItemPointer & UNUSED_ATTRIBUTE) {}
   
-  virtual void LogUpdate(const ItemPointer & UNUSED_ATTRIBUTE) {}
+  // The new version of an update, and the version it replaced, or
+  // INVALID_ITEMPOINTER if it was updated in place
+  virtual void LogUpdate(const ItemPointer &location UNUSED_ATTRIBUTE,
+                         const ItemPointer &old_location UNUSED_ATTRIBUTE) {}
   
   virtual void LogDelete(const ItemPointer & UNUSED_ATTRIBUTE) {}
 
+  // Add an executed statement to the command log of its transaction.
+  // Returns false if the writes of the transaction are logged by value.
+  virtual bool LogCommand(concurrency::Transaction *txn UNUSED_ATTRIBUTE,
+                          Statement &statement UNUSED_ATTRIBUTE,
+                          const std::vector<type::Value> &params
+                              UNUSED_ATTRIBUTE) {
+    return false;
+  }
+
+  // Log the command log of the committing transaction instead of its writes
+  virtual void LogCommands(
+      const CopySerializeOutput &command_log UNUSED_ATTRIBUTE) {}
+
+  // Replay the logs before the logging starts. Returns the latest recovered
+  // epoch.
+  virtual eid_t DoRecovery(
+      const size_t recovery_thread_count UNUSED_ATTRIBUTE) {
+    return INVALID_EID;
+  }
+
+  // The records of the epochs up to the checkpointed one are no longer needed
+  virtual void TruncateLog(const eid_t checkpoint_epoch_id UNUSED_ATTRIBUTE) {}
+
+  // Latest epoch whose log records have all been persisted
+  virtual eid_t GetPersistentEpochId() { return MAX_EID; }
+
  protected:
   volatile bool is_running_;
 };
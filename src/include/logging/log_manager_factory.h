@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "logging/log_manager.h"
 #include "logging/logical_log_manager.h"
 
@@ -32,12 +34,20 @@ class LogManagerFactory {
     }
   }
 
-  static void Configure(const int thread_count = 1) {
+  // Logging must be stopped. The log directory must exist.
+  static void Configure(const int thread_count = 1,
+                        const std::string &log_dir = ".",
+                        const BackendType backend_type = BackendType::SSD) {
     if (thread_count == 0) {
       logging_type_ = LoggingType::OFF;
     } else {
       logging_type_ = LoggingType::ON;
       logging_thread_count_ = thread_count;
+
+      auto &log_manager = LogicalLogManager::GetInstance(thread_count);
+      log_manager.SetLoggerCount(thread_count);
+      log_manager.SetDirectory(log_dir);
+      log_manager.SetBackendType(backend_type);
     }
   }
 
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_shipper.h
+//
+// Identification: src/include/logging/log_shipper.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace peloton {
+
+namespace networking {
+class PelotonLoggingService_Stub;
+class RpcChannel;
+class RpcController;
+}
+
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Log Shipper
+//===--------------------------------------------------------------------===//
+
+// Streams the log of the primary to its read replicas over the RPC layer.
+// Each logger ships the frames of a pass once they are durable, so a replica
+// never applies a transaction the primary could lose. The batches of every
+// logger are numbered, and a replica applies an epoch once each logger has
+// shipped its end marker.
+//
+// The shipping is asynchronous: the loggers do not wait for the replicas,
+// which trail the primary by the batches in flight. A batch that cannot be
+// sent is not sent again, so a replica that missed one has to be rebuilt
+// from a checkpoint.
+class LogShipper {
+ public:
+  LogShipper(const LogShipper &) = delete;
+  LogShipper &operator=(const LogShipper &) = delete;
+  LogShipper(LogShipper &&) = delete;
+  LogShipper &operator=(LogShipper &&) = delete;
+
+  LogShipper();
+
+  ~LogShipper();
+
+  static LogShipper &GetInstance() {
+    static LogShipper log_shipper;
+    return log_shipper;
+  }
+
+  // Ship the batches of the loggers to the replicas of the comma separated
+  // host:port addresses, to none if empty. The batches are numbered from
+  // zero again. No logger may be running. Returns false if an address is
+  // invalid, in which case nothing is shipped.
+  bool Configure(const std::string &replica_addresses,
+                 const size_t logger_count);
+
+  inline bool IsEnabled() const { return replicas_.empty() == false; }
+
+  // Send the next batch of frames of the logger to every replica
+  void Ship(const size_t logger_id, const std::string &frames);
+
+ private:
+  struct Replica {
+    std::string address;
+
+    std::unique_ptr<networking::RpcChannel> channel;
+
+    std::unique_ptr<networking::RpcController> controller;
+
+    std::unique_ptr<networking::PelotonLoggingService_Stub> stub;
+
+    // whether the last batch could be sent, to report failures once
+    bool is_connected = true;
+  };
+
+  // guards the replicas and the sequence numbers, the loggers ship
+  // concurrently
+  std::mutex ship_mutex_;
+
+  std::vector<std::unique_ptr<Replica>> replicas_;
+
+  // number of the next batch of each logger
+  std::vector<int64_t> sequence_numbers_;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_stats.h
+//
+// Identification: src/include/logging/log_stats.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Logger Stats
+//===--------------------------------------------------------------------===//
+
+// Work done by the loggers since logging started. A flush is the batch of
+// buffers a logger writes and syncs in one pass.
+struct LoggerStats {
+  // passes that synced the log file
+  uint64_t flush_count = 0;
+
+  uint64_t flush_byte_count = 0;
+
+  uint64_t flush_buffer_count = 0;
+
+  // transactions in the flushed buffers
+  uint64_t flush_txn_count = 0;
+
+  // largest batch of a flush
+  uint64_t max_flush_byte_count = 0;
+
+  // time spent writing and syncing the log file (in us)
+  uint64_t flush_time = 0;
+
+  LoggerStats &operator+=(const LoggerStats &other);
+};
+
+//===--------------------------------------------------------------------===//
+// Latency Histogram
+//===--------------------------------------------------------------------===//
+
+// Latencies in microseconds, counted in buckets of 1/16 of a power of two,
+// so a percentile is within about 3% of the recorded latency.
+class LatencyHistogram {
+ public:
+  LatencyHistogram() { Reset(); }
+
+  void Record(const uint64_t latency);
+
+  void Merge(const LatencyHistogram &other);
+
+  void Reset();
+
+  inline uint64_t GetCount() const { return count_; }
+
+  inline uint64_t GetMax() const { return max_; }
+
+  // 0 if no latency was recorded
+  double GetAverage() const;
+
+  // Latency under which the given percent of the latencies are, 0 if no
+  // latency was recorded
+  double GetPercentile(const double percent) const;
+
+ private:
+  static size_t GetBucket(const uint64_t latency);
+
+  // middle of the latencies of a bucket
+  static double GetBucketLatency(const size_t bucket);
+
+  static const size_t sub_bucket_bits_ = 4;
+
+  static const size_t sub_bucket_count_ = 1 << sub_bucket_bits_;
+
+  static const size_t bucket_count_ = (64 - sub_bucket_bits_ + 1) *
+                                      sub_bucket_count_;
+
+  std::array<uint64_t, bucket_count_> buckets_;
+
+  uint64_t count_;
+
+  uint64_t sum_;
+
+  uint64_t max_;
+};
+
+}  // namespace logging
+}  // namespace peloton
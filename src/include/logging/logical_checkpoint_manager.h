@@ -12,15 +12,58 @@
 
 #pragma once
 
+#include <atomic>
+#include <string>
+
 #include "logging/checkpoint_manager.h"
 
 namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class DataTable;
+}
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
 // logical checkpoint Manager
 //===--------------------------------------------------------------------===//
 
+/**
+ * checkpoint file name layout :
+ *
+ * dir_name + "/" + prefix + "_" + epoch_id                  (complete mark)
+ * dir_name + "/" + prefix + "_" + epoch_id + "_" + database_id + "_" +
+ * table_id                                                   (table file)
+ *
+ *
+ * table file layout :
+ *
+ *  -----------------------------------------------------------------------
+ *  | record_length | TUPLE_INSERT | database_id | table_id | values ... |
+ *  -----------------------------------------------------------------------
+ *
+ * The ids are varints, as in the tuple records of the log. A table with a
+ * primary key whose columns are all inlined is written as a
+ * storage::TableSnapshot instead, to the table file name + ".snapshot".
+ * Recovery maps it back into tile groups rather than inserting its tuples
+ * one by one.
+ *
+ * A checkpoint holds every transaction of the epochs up to its epoch. It is
+ * read through a snapshot transaction, so writers are never blocked: the
+ * tile groups are scanned with the MVCC visibility of the snapshot while
+ * the writers keep installing newer versions. The tables are written in
+ * parallel, each to its own file, and the checkpoint is complete once its
+ * mark is written. The log records up to the epoch are then truncated, and
+ * the older checkpoints are removed.
+ *
+ * The tables of the catalog database are rebuilt at startup and are not
+ * checkpointed.
+ */
 class LogicalCheckpointManager : public CheckpointManager {
  public:
   LogicalCheckpointManager(const LogicalCheckpointManager &) = delete;
@@ -28,7 +71,12 @@ class LogicalCheckpointManager : public CheckpointManager {
   LogicalCheckpointManager(LogicalCheckpointManager &&) = delete;
   LogicalCheckpointManager &operator=(LogicalCheckpointManager &&) = delete;
 
-  LogicalCheckpointManager(const int thread_count) : checkpointer_thread_count_(thread_count) {}
+  LogicalCheckpointManager(const int thread_count)
+      : checkpointer_thread_count_(thread_count),
+        checkpoint_dir_("."),
+        checkpoint_interval_(30),
+        thread_id_(0),
+        checkpoint_epoch_id_(INVALID_EID) {}
 
   virtual ~LogicalCheckpointManager() {}
 
@@ -37,13 +85,33 @@ class LogicalCheckpointManager : public CheckpointManager {
     return checkpoint_manager;
   }
 
+  // No checkpoint may be running while the configuration is changed.
+  void SetCheckpointerCount(const int thread_count) {
+    PL_ASSERT(thread_count > 0);
+    checkpointer_thread_count_ = thread_count;
+  }
+
+  void SetDirectory(const std::string &checkpoint_dir) {
+    checkpoint_dir_ = checkpoint_dir;
+  }
+
+  // Seconds between the checkpoints taken by the checkpointing thread
+  void SetInterval(const size_t checkpoint_interval) {
+    checkpoint_interval_ = checkpoint_interval;
+  }
+
+  // Thread id of the snapshot transactions, registered with the epoch
+  // manager by the caller
+  void SetThreadId(const size_t thread_id) { thread_id_ = thread_id; }
+
   virtual void Reset() { is_running_ = false; }
 
-  virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> & UNUSED_ATTRIBUTE) {}
+  virtual void StartCheckpointing(
+      std::vector<std::unique_ptr<std::thread>> &checkpoint_threads) override;
 
-  virtual void StartLogging() {}
+  virtual void StartCheckpointing() override;
 
-  virtual void StopLogging() {}
+  virtual void StopCheckpointing() override;
 
   virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) {}
 
@@ -51,9 +119,60 @@ class LogicalCheckpointManager : public CheckpointManager {
 
   virtual size_t GetTableCount() { return 0; }
 
+  virtual eid_t DoCheckpoint() override;
+
+  virtual eid_t GetLatestCheckpoint(
+      std::vector<std::string> &checkpoint_paths) override;
+
+  virtual std::vector<storage::DataTable *> LoadSnapshots(
+      std::vector<std::string> &checkpoint_paths,
+      std::vector<std::unique_ptr<std::thread>> &index_threads) override;
+
+  // Epoch of the latest checkpoint taken by this process
+  eid_t GetCheckpointEpochId() const { return checkpoint_epoch_id_.load(); }
+
  private:
+  // Take a checkpoint every interval until stopped
+  void Running();
+
+  // Write the visible tuples of the table to its checkpoint file
+  bool CheckpointTable(concurrency::Transaction *txn,
+                       storage::DataTable *table,
+                       const std::string &checkpoint_path);
+
+  // Remove the files of the checkpoints before the epoch
+  void RemoveCheckpoints(const eid_t epoch_id);
+
+  std::string GetCheckpointPath(const eid_t epoch_id) const {
+    return checkpoint_dir_ + "/" + checkpoint_filename_prefix_ + "_" +
+           std::to_string(epoch_id);
+  }
+
+  std::string GetTablePath(const eid_t epoch_id, const oid_t database_id,
+                           const oid_t table_id) const {
+    return GetCheckpointPath(epoch_id) + "_" + std::to_string(database_id) +
+           "_" + std::to_string(table_id);
+  }
+
+  static const std::string checkpoint_filename_prefix_;
+
+  static const std::string snapshot_filename_suffix_;
+
+  // a table file is written out whenever this much is buffered
+  static const size_t checkpoint_buffer_size_ = 1 << 20;
+
   int checkpointer_thread_count_;
 
+  std::string checkpoint_dir_;
+
+  size_t checkpoint_interval_;
+
+  size_t thread_id_;
+
+  std::atomic<eid_t> checkpoint_epoch_id_;
+
+  // checkpointing thread joined by StopCheckpointing
+  std::unique_ptr<std::thread> checkpoint_thread_;
 };
 
 }  // namespace logging
@@ -12,9 +12,24 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #include "logging/log_manager.h"
+#include "logging/logical_logger.h"
+#include "logging/worker_context.h"
 
 namespace peloton {
+
+namespace storage {
+class TileGroup;
+}
+
 namespace logging {
 
 //===--------------------------------------------------------------------===//
@@ -25,19 +40,75 @@ namespace logging {
 /**
  * logging file name layout :
  * 
- * dir_name + "/" + prefix + "_" + epoch_id
+ * dir_name + "/" + prefix + "_" + logger_id + "_" + segment_id
  *
  *
  * logging file layout :
  *
  *  -----------------------------------------------------------------------------
- *  | txn_id | database_id | table_id | operation_type | data | ... | txn_end_flag
+ *  | txn_length | txn_begin_flag | epoch_id | commit_id | tuple record | ... | txn_end_flag |
+ *  -----------------------------------------------------------------------------
+ *
+ *  tuple record :
+ *
+ *  -----------------------------------------------------------------------------
+ *  | operation_type | database_id | table_id | data |
+ *  -----------------------------------------------------------------------------
+ *
+ *  update data :
+ *
+ *  -----------------------------------------------------------------------------
+ *  | column bitmap | values of the columns in the bitmap |
+ *  -----------------------------------------------------------------------------
+ *
+ *  epoch end marker :
+ *
+ *  -----------------------------------------------------------------------------
+ *  | length | epoch_end_flag | epoch_id |
+ *  -----------------------------------------------------------------------------
+ *
+ *  recovery mark, the epochs between the two were discarded :
+ *
+ *  -----------------------------------------------------------------------------
+ *  | length | epoch_begin_flag | persist_epoch_id | restart_epoch_id |
+ *  -----------------------------------------------------------------------------
+ *
+ * NOTE: this layout is designed for logical logging. The data of a tuple
+ * record holds all the values of the version, the new one for insert, the
+ * deleted one for delete. An update holds the values of the changed columns
+ * and of the key columns, one bit per column of the table, lowest first. It
+ * holds all of them if the key changed.
+ *
+ * NOTE: with command logging, a transaction whose writes were all made by
+ * statements executed through the traffic cop is logged as those statements
+ * instead, each one a command record:
+ *
+ *  -----------------------------------------------------------------------------
+ *  | command_flag | command_id | param_count | param_type | param_value | ... |
+ *  -----------------------------------------------------------------------------
+ *
+ * The query string of a command id is in the command file of the directory,
+ * appended and synced before the id is first used:
+ *
+ *  -----------------------------------------------------------------------------
+ *  | length | query_string |
  *  -----------------------------------------------------------------------------
  *
- * NOTE: this layout is designed for logical logging.
+ * Recovery replays the commands serially in commit order, after the records
+ * logged by value, so the statements must be deterministic. The transactions
+ * logged by value, such as those of bulk loads, must not write the tuples of
+ * the command logged ones.
+ *
+ * NOTE: the ids are varints. The commit id is stored xor the first commit
+ * id of its epoch, so it takes a few bytes.
  *
  * NOTE: tuple length can be obtained from the table schema.
  *
+ * NOTE: every transaction of an epoch is in the file ahead of the first epoch
+ * end marker of a later or equal epoch. Transactions of later epochs may
+ * precede the marker as well, so recovery replays the transactions of the
+ * epochs up to the smallest last marker of all the files.
+ *
  */
 
 class LogicalLogManager : public LogManager {
@@ -47,7 +118,13 @@ class LogicalLogManager : public LogManager {
   LogicalLogManager(LogicalLogManager &&) = delete;
   LogicalLogManager &operator=(LogicalLogManager &&) = delete;
 
-  LogicalLogManager(const int thread_count) : logger_thread_count_(thread_count) {}
+  LogicalLogManager(const int thread_count)
+      : logger_thread_count_(thread_count),
+        log_dir_("."),
+        backend_type_(BackendType::SSD),
+        existing_epoch_id_(MAX_EID),
+        generation_(0),
+        command_logging_(false) {}
 
   virtual ~LogicalLogManager() {}
 
@@ -56,40 +133,43 @@ class LogicalLogManager : public LogManager {
     return log_manager;
   }
 
-  // virtual void SetDirectories(const std::vector<std::string> &logging_dirs) override {
-  //   logger_dirs_ = logging_dirs;
+  // Only while logging is stopped
+  void SetLoggerCount(const int thread_count) {
+    PL_ASSERT(is_running_ == false);
+    logger_thread_count_ = thread_count;
+  }
 
-  //   if (logging_dirs.size() > 0) {
-  //     pepoch_dir_ = logging_dirs.at(0);
-  //   }
-  //   // check the existence of logging directories.
-  //   // if not exists, then create the directory.
-  //   for (auto logging_dir : logging_dirs) {
-  //     if (LoggingUtil::CheckDirectoryExistence(logging_dir.c_str()) == false) {
-  //       LOG_INFO("Logging directory %s is not accessible or does not exist", logging_dir.c_str());
-  //       bool res = LoggingUtil::CreateDirectory(logging_dir.c_str(), 0700);
-  //       if (res == false) {
-  //         LOG_ERROR("Cannot create directory: %s", logging_dir.c_str());
-  //       }
-  //     }
-  //   }
+  inline int GetLoggerCount() const { return logger_thread_count_; }
 
-  //   logger_count_ = logging_dirs.size();
-  //   for (size_t i = 0; i < logger_count_; ++i) {
-  //     loggers_.emplace_back(new PhyLogLogger(i, logging_dirs.at(i)));
-  //   }
-  // }
+  // The directory must exist. Only while logging is stopped.
+  void SetDirectory(const std::string &log_dir) {
+    PL_ASSERT(is_running_ == false);
+    log_dir_ = log_dir;
+  }
+
+  inline const std::string &GetDirectory() const { return log_dir_; }
+
+  // NVM places the new log segments in the persistent memory of the
+  // directory, which must be on a DAX file system. Only while logging is
+  // stopped.
+  void SetBackendType(const BackendType backend_type) {
+    PL_ASSERT(is_running_ == false);
+    backend_type_ = backend_type;
+  }
 
-  // virtual const std::vector<std::string> &GetDirectories() override {
-  //   return logger_dirs_;
-  // }
+  inline BackendType GetBackendType() const { return backend_type_; }
 
+  // Path of the log file of a logger
+  std::string GetLogFilePath(const size_t logger_id) const;
 
-  virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> & UNUSED_ATTRIBUTE) override {}
+  // The caller joins the logger threads after stopping the logging
+  virtual void StartLogging(std::vector<std::unique_ptr<std::thread>> &logger_threads) override;
 
-  virtual void StartLogging() override {}
+  virtual void StartLogging() override;
 
-  virtual void StopLogging() override {}
+  // The workers must have ended their transactions. Every buffer left is
+  // written out before the loggers exit.
+  virtual void StopLogging() override;
 
   virtual void RegisterTable(const oid_t &table_id UNUSED_ATTRIBUTE) override {}
 
@@ -97,32 +177,107 @@ class LogicalLogManager : public LogManager {
 
   virtual size_t GetTableCount() override { return 0; }
 
-  virtual void LogBegin() override {}
+  virtual void LogBegin(const eid_t epoch_id, const cid_t commit_id) override;
 
-  virtual void LogEnd() override {}
+  virtual void LogEnd() override;
 
-  virtual void LogInsert(const ItemPointer & UNUSED_ATTRIBUTE) override {}
+  virtual void LogInsert(const ItemPointer &location) override;
   
-  virtual void LogUpdate(const ItemPointer & UNUSED_ATTRIBUTE) override {}
+  // Only the changed columns and those of the key are logged, unless the
+  // key changed or the old version is gone
+  virtual void LogUpdate(const ItemPointer &location,
+                         const ItemPointer &old_location) override;
   
-  virtual void LogDelete(const ItemPointer & UNUSED_ATTRIBUTE) override { }
+  virtual void LogDelete(const ItemPointer &location) override;
+
+  virtual bool LogCommand(concurrency::Transaction *txn, Statement &statement,
+                          const std::vector<type::Value> &params) override;
+
+  virtual void LogCommands(const CopySerializeOutput &command_log) override;
+
+  static std::string GetCommandFilePath(const std::string &log_dir) {
+    return log_dir + "/" + command_filename_;
+  }
+
+  // Read the query strings of the command file, indexed by command id.
+  // Returns the size of its complete frames.
+  static size_t ReadCommandFile(const std::string &log_dir,
+                                std::vector<std::string> &query_strings);
+
+  // Replay the log files of the directory, see LogicalLogRecovery
+  virtual eid_t DoRecovery(const size_t recovery_thread_count) override;
+
+  // Drop the log segments covered by the checkpoint
+  virtual void TruncateLog(const eid_t checkpoint_epoch_id) override;
+
+  virtual eid_t GetPersistentEpochId() override;
+
+  // Flushes of the loggers since logging last started, still known once it
+  // is stopped
+  LoggerStats GetLoggerStats();
 
  private:
+  // Open the log files and register the loggers. false if a file cannot
+  // be opened.
+  bool PrepareLoggers();
+
+  // Context of the calling worker, registered with a logger on first use
+  WorkerContext *GetWorkerContext();
+
+  // Serialize a tuple record of the running transaction with all the
+  // values of the version
+  void LogTuple(const LogRecordType type, const ItemPointer &location);
+
+  // Serialize the header of a tuple record
+  void LogTupleHeader(CopySerializeOutput &output, const LogRecordType type,
+                      storage::TileGroup *tile_group);
+
+  // Copy the records of the transaction into the log buffer of the worker
+  void CopyToLogBuffer(WorkerContext *worker_context);
+
+  // Load the commands of the earlier runs. false if the command file cannot
+  // be read.
+  bool PrepareCommands();
+
+  // Id of the query string in the command file, which is appended to and
+  // synced for a new one. false if it cannot be written.
+  bool GetCommandId(const std::string &query_string, uint32_t &command_id);
+
   int logger_thread_count_;
 
-  // std::atomic<oid_t> worker_count_;
+  std::string log_dir_;
+
+  BackendType backend_type_;
+
+  // latest epoch with records in the segments of the earlier runs. known
+  // after a recovery, which restarts the epochs past them.
+  eid_t existing_epoch_id_;
+
+  std::vector<std::unique_ptr<LogicalLogger>> loggers_;
+
+  // logger threads joined by StopLogging
+  std::vector<std::unique_ptr<std::thread>> logger_threads_;
+
+  // guards workers_
+  std::mutex worker_mutex_;
 
-  // std::vector<std::string> logger_dirs_;
+  std::vector<std::unique_ptr<WorkerContext>> workers_;
 
-  // std::vector<std::shared_ptr<PhyLogLogger>> loggers_;
+  // incremented by every start, so the workers drop the contexts of a
+  // previous run
+  std::atomic<size_t> generation_;
 
-  // std::unique_ptr<std::thread> pepoch_thread_;
-  // volatile bool is_running_;
+  // whether the committed transactions are logged by command, read from
+  // the configuration at every start. turned off if the command file
+  // cannot be written.
+  std::atomic<bool> command_logging_;
 
-  // std::string pepoch_dir_;
+  // guards command_ids_ and the command file
+  std::mutex command_mutex_;
 
-  // const std::string pepoch_filename_ = "pepoch";
+  std::unordered_map<std::string, uint32_t> command_ids_;
 
+  static const std::string command_filename_;
 };
 
 }  // namespace logging
@@ -0,0 +1,220 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_recovery.h
+//
+// Identification: src/include/logging/logical_log_recovery.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "type/types.h"
+
+namespace peloton {
+
+class SerializeInput;
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class DataTable;
+class Tuple;
+}
+
+namespace type {
+class AbstractPool;
+}
+
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Logical Log Recovery
+//===--------------------------------------------------------------------===//
+
+// Replays the log files written by the logical log manager.
+//
+// The files are read in parallel, one thread per file. The tuple records of
+// the transactions are split into partitions by table and primary key, so
+// all the records of a tuple land in the same partition. Each partition is
+// then replayed by its own thread in commit order, up to the latest epoch
+// that every file has persisted. Only the surviving version of each tuple is
+// kept, and it is loaded into fresh tile groups of its table with one bulk
+// insert per table and partition, which builds the indexes after the data.
+//
+// The tuples of a checkpoint are loaded along with the log records, which
+// are only replayed for the epochs after the checkpoint. The tables mapped
+// from the snapshots of the checkpoint hold their tuples already. The first
+// record of such a tuple starts from its mapped version, which is replaced
+// by the surviving one.
+//
+// The transactions logged by command are replayed last, one at a time in
+// commit order, by running their statements again with the logged
+// parameters.
+//
+// Transactions of the epochs after the recovered one were never
+// acknowledged. The files are marked so that later recoveries skip them, and
+// the epochs restart past every epoch in the files.
+class LogicalLogRecovery {
+ public:
+  LogicalLogRecovery(const std::string &log_dir,
+                     const size_t recovery_thread_count)
+      : log_dir_(log_dir),
+        recovery_thread_count_(recovery_thread_count),
+        checkpoint_epoch_id_(INVALID_EID),
+        last_restart_epoch_id_(INVALID_EID),
+        persist_epoch_id_(INVALID_EID),
+        restart_epoch_id_(INVALID_EID) {}
+
+  // Load the table files of the checkpoint of the epoch before the logs, on
+  // top of the tables mapped from its snapshots, whose indexes are filled
+  void SetCheckpoint(const eid_t checkpoint_epoch_id,
+                     const std::vector<std::string> &checkpoint_paths,
+                     const std::vector<storage::DataTable *> &snapshot_tables);
+
+  // Replay the logs into the tables of the catalog, which must be empty.
+  // Neither the logging nor any transaction may be running. Returns the
+  // latest recovered epoch.
+  eid_t Recover();
+
+  inline eid_t GetRestartEpochId() const { return restart_epoch_id_; }
+
+  // Columns identifying the tuples of a table in the log: those of the
+  // primary key, or all the columns of a table without one
+  static std::vector<oid_t> GetKeyColumns(storage::DataTable *table);
+
+ private:
+  // the segments of a logger
+  struct LogFile {
+    std::vector<std::string> segment_paths;
+
+    std::string data;
+
+    // offset of the last segment in the data
+    size_t last_segment_offset = 0;
+
+    // size of the complete frames, a torn one may follow
+    size_t valid_size = 0;
+
+    // last epoch end marker since the last mark of a recovery
+    eid_t last_epoch_id = INVALID_EID;
+
+    // whether a frame follows the last mark of a recovery
+    bool is_active = false;
+
+    eid_t max_epoch_id = INVALID_EID;
+  };
+
+  struct TupleRecord {
+    eid_t epoch_id;
+    cid_t commit_id;
+    LogRecordType type;
+    storage::DataTable *table;
+    // serialized values of the tuple, in the data of the log file
+    const char *data;
+    size_t size;
+  };
+
+  // a transaction logged by command
+  struct CommandRecord {
+    eid_t epoch_id;
+    cid_t commit_id;
+    // command records up to the commit, in the data of the log file
+    const char *data;
+    size_t size;
+  };
+
+  struct TableInfo {
+    storage::DataTable *table;
+    std::vector<oid_t> key_columns;
+  };
+
+  // tables by database and table oid
+  typedef std::unordered_map<uint64_t, TableInfo> TableCache;
+
+  // Parse a log file into the tuple records of each partition
+  void ReadLogFile(const size_t file_id);
+
+  void ReadCheckpointFile(const size_t file_id);
+
+  // Parse a tuple record into the partition of its tuple. Returns false if
+  // its table is missing.
+  bool ParseTupleRecord(SerializeInput &input, const LogRecordType type,
+                        const eid_t epoch_id, const cid_t commit_id,
+                        TableCache &tables,
+                        std::vector<std::vector<TupleRecord>> &records);
+
+  // Replay the records of a partition and bulk load the surviving tuples
+  void ReplayPartition(const size_t partition_id);
+
+  // The location of the mapped version of a tuple of a snapshot table, with
+  // a copy of its values, or an invalid location if the snapshot has none
+  ItemPointer FindSnapshotTuple(storage::DataTable *table,
+                                const storage::Tuple &key_tuple,
+                                std::unique_ptr<storage::Tuple> &tuple,
+                                type::AbstractPool *pool);
+
+  // Replace the mapped versions of a snapshot table with the surviving ones
+  bool ReplaceSnapshotTuples(
+      concurrency::Transaction *txn, storage::DataTable *table,
+      const std::vector<ItemPointer> &locations,
+      const std::vector<std::unique_ptr<storage::Tuple>> &tuples);
+
+  // Run the statements of the durable transactions logged by command
+  void ReplayCommands();
+
+  // Append the epochs discarded by this recovery to a log file, after its
+  // last complete frame
+  void MarkLogFile(const LogFile &log_file);
+
+  bool IsDurable(const eid_t epoch_id) const;
+
+  std::string log_dir_;
+
+  size_t recovery_thread_count_;
+
+  std::vector<LogFile> log_files_;
+
+  eid_t checkpoint_epoch_id_;
+
+  std::vector<std::string> checkpoint_paths_;
+
+  std::unordered_set<storage::DataTable *> snapshot_tables_;
+
+  std::vector<std::string> checkpoint_data_;
+
+  // records_[file id][partition id], in the order of the file. the
+  // checkpoint files follow the log files.
+  std::vector<std::vector<std::vector<TupleRecord>>> records_;
+
+  // commands_[file id], in the order of the file
+  std::vector<std::vector<CommandRecord>> commands_;
+
+  // (last persisted, restart) epochs of the earlier recoveries. the epochs
+  // in between were discarded.
+  std::vector<std::vector<std::pair<eid_t, eid_t>>> discarded_epochs_;
+
+  // first epoch after the last recovery
+  eid_t last_restart_epoch_id_;
+
+  // latest durable epoch after the last recovery
+  eid_t persist_epoch_id_;
+
+  eid_t restart_epoch_id_;
+};
+
+}  // namespace logging
+}  // namespace peloton
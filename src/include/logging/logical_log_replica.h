@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_replica.h
+//
+// Identification: src/include/logging/logical_log_replica.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+
+class SerializeInput;
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Logical Log Replica
+//===--------------------------------------------------------------------===//
+
+// Applies the log shipped by the loggers of a primary to the tables of a
+// read replica, which must have the same catalog.
+//
+// The batches of each logger are taken in their order, and their frames are
+// held until every logger has shipped the end marker of an epoch. The
+// transactions of the epochs up to that one are then applied in commit
+// order, all in one transaction of the replica, so a reader sees either all
+// of them or none. A read-only transaction thus sees the tables as of a
+// replicated epoch.
+//
+// The tuples are located by their primary key: the updates and deletes of
+// tables without one cannot be applied, nor can the transactions logged by
+// command.
+class LogicalLogReplica {
+ public:
+  LogicalLogReplica(const LogicalLogReplica &) = delete;
+  LogicalLogReplica &operator=(const LogicalLogReplica &) = delete;
+  LogicalLogReplica(LogicalLogReplica &&) = delete;
+  LogicalLogReplica &operator=(LogicalLogReplica &&) = delete;
+
+  LogicalLogReplica() : replicated_epoch_id_(INVALID_EID) {}
+
+  static LogicalLogReplica &GetInstance() {
+    static LogicalLogReplica log_replica;
+    return log_replica;
+  }
+
+  // Take a batch of frames shipped by a logger, and apply the epochs every
+  // logger has shipped. A first batch restarts the stream of its logger.
+  // Returns the latest replicated epoch.
+  eid_t ReceiveLog(const size_t logger_id, const size_t logger_count,
+                   const int64_t sequence_number, const std::string &log);
+
+  // Latest epoch whose transactions are all applied
+  inline eid_t GetReplicatedEpochId() const {
+    return replicated_epoch_id_.load();
+  }
+
+  // Begin a read-only transaction on the replicated epochs
+  concurrency::Transaction *BeginSnapshot(const size_t thread_id = 0);
+
+  // Drop the streams and the frames not applied yet
+  void Reset();
+
+ private:
+  // a transaction of the log, not applied yet
+  struct TransactionFrame {
+    eid_t epoch_id;
+    cid_t commit_id;
+    // records up to the commit
+    std::string data;
+  };
+
+  // the batches of a logger
+  struct LoggerStream {
+    int64_t next_sequence_number = 0;
+
+    // batches ahead of the next one
+    std::map<int64_t, std::string> pending_batches;
+
+    std::vector<TransactionFrame> transactions;
+
+    // last epoch end marker
+    eid_t persist_epoch_id = INVALID_EID;
+
+    bool is_started = false;
+  };
+
+  // Split a batch into the transactions and the end markers of its stream
+  void ParseBatch(LoggerStream &stream, const std::string &batch);
+
+  // Apply the transactions of the epochs up to the given one
+  void ApplyEpochs(const eid_t epoch_id);
+
+  // Apply a tuple record in the transaction. Returns false if it cannot be.
+  bool ApplyRecord(concurrency::Transaction *txn, SerializeInput &input,
+                   const LogRecordType type);
+
+  // guards the streams, the batches of the loggers arrive concurrently
+  std::mutex replica_mutex_;
+
+  std::vector<LoggerStream> streams_;
+
+  std::atomic<eid_t> replicated_epoch_id_;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -4,143 +4,178 @@
 //
 // logical_logger.h
 //
-// Identification: src/logging/logical_logger.h
+// Identification: src/include/logging/logical_logger.h
 //
-// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
 
 #pragma once
 
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
 #include <vector>
-#include <thread>
-#include <list>
-#include <stack>
-#include <unordered_map>
 
-#include "concurrency/transaction.h"
-#include "concurrency/epoch_manager.h"
+#include "common/platform.h"
 #include "logging/log_buffer.h"
-#include "logging/log_record.h"
-#include "logging/log_buffer_pool.h"
-#include "logging/log_manager.h"
+#include "logging/log_file.h"
+#include "logging/log_stats.h"
 #include "logging/worker_context.h"
+#include "type/serializeio.h"
 #include "type/types.h"
-#include "common/serializer.h"
-#include "common/lockfree_queue.h"
-#include "common/logger.h"
-#include "common/pool.h"
-
 
 namespace peloton {
-  
-namespace storage {
-  class TileGroupHeader;
-}
-
 namespace logging {
 
-  class PhyLogLogger {
+//===--------------------------------------------------------------------===//
+// Logical Logger
+//===--------------------------------------------------------------------===//
+
+// Logger thread writing the log buffers of a set of workers to its own log
+// file. Once an epoch has expired, every record of it and of the earlier
+// epochs has been written ahead of the next epoch end marker of the file.
+// The buffers and the marker of a pass are written as one batch and made
+// durable by a single sync, and an epoch is only reported persistent once
+// that sync has completed. The durable batch is then shipped to the
+// replicas, if any.
+//
+// On the NVM backend the segments are mapped from persistent memory, and a
+// pass is made durable by cache line write backs instead of a sync.
+//
+// The file is split into segments. A new segment is started whenever a
+// checkpoint covers more epochs, and the segments that only hold records of
+// the covered epochs are removed.
+class LogicalLogger {
+ public:
+  LogicalLogger(const LogicalLogger &) = delete;
+  LogicalLogger &operator=(const LogicalLogger &) = delete;
+  LogicalLogger(LogicalLogger &&) = delete;
+  LogicalLogger &operator=(LogicalLogger &&) = delete;
+
+  LogicalLogger(const size_t logger_id, const std::string &log_dir,
+                const BackendType backend_type = BackendType::SSD)
+      : logger_id_(logger_id),
+        log_dir_(log_dir),
+        backend_type_(backend_type),
+        segment_id_(0),
+        segment_epoch_id_(INVALID_EID),
+        is_running_(false),
+        persist_epoch_id_(INVALID_EID),
+        has_failed_(false),
+        truncate_epoch_id_(INVALID_EID),
+        truncated_epoch_id_(INVALID_EID) {}
+
+  ~LogicalLogger();
+
+  // Open a new segment after the existing ones. The existing segments only
+  // hold records up to the given epoch, MAX_EID if unknown. Returns false if
+  // the file cannot be opened.
+  bool OpenLogFile(const eid_t existing_epoch_id);
+
+  void CloseLogFile();
+
+  // Path of the current segment
+  inline std::string GetLogFilePath() const {
+    return GetSegmentPath(log_dir_, logger_id_, segment_id_);
+  }
 
-  public:
-    PhyLogLogger(const size_t &logger_id, const std::string &log_dir) :
-      logger_id_(logger_id),
-      log_dir_(log_dir),
-      logger_thread_(nullptr),
-      is_running_(false),
-      logger_output_buffer_(), 
-      persist_epoch_id_(INVALID_EID),
-      worker_map_lock_(), 
-      worker_map_() {}
+  static std::string GetSegmentPath(const std::string &log_dir,
+                                    const size_t logger_id,
+                                    const size_t segment_id) {
+    return log_dir + "/" + logging_filename_prefix_ + "_" +
+           std::to_string(logger_id) + "_" + std::to_string(segment_id);
+  }
 
-    ~PhyLogLogger() {}
+  // Segment ids of the logger in the directory, in increasing order
+  static std::vector<size_t> GetSegmentIds(const std::string &log_dir,
+                                           const size_t logger_id);
 
-    void StartRecovery(const size_t checkpoint_eid, const size_t persist_eid, const size_t recovery_thread_count);
-    void StartIndexRebulding(const size_t logger_count);
+  // Ids of the loggers with segments in the directory, in increasing order
+  static std::vector<size_t> GetLoggerIds(const std::string &log_dir);
 
-    void WaitForRecovery();
-    void WaitForIndexRebuilding();
+  // The records of the epochs up to the given one are no longer needed
+  void TruncateLog(const eid_t checkpoint_epoch_id);
 
-    void StartLogging() {
-      is_running_ = true;
-      logger_thread_.reset(new std::thread(&PhyLogLogger::Run, this));
-    }
+  void RegisterWorker(WorkerContext *worker_context);
 
-    void StopLogging() {
-      is_running_ = false;
-      logger_thread_->join();
-    }
+  void SetRunning(const bool is_running) { is_running_ = is_running; }
 
-    void RegisterWorker(WorkerContext *phylog_worker_ctx);
-    void DeregisterWorker(WorkerContext *phylog_worker_ctx);
+  // Logger loop. Once stopped, it writes out every buffer left before it
+  // returns.
+  void Run();
 
-    size_t GetPersistEpochId() const {
-      return persist_epoch_id_;
-    }
+  // Latest epoch whose records are all persisted by this logger
+  inline eid_t GetPersistentEpochId() const { return persist_epoch_id_.load(); }
 
+  // Flushes of the logger so far
+  LoggerStats GetStats();
 
-private:
-  void Run();
+ private:
+  // Take the buffers of the workers that hold no record of an epoch after
+  // the expired one, or every buffer if all_buffers is set
+  void CollectBuffers(const eid_t expired_epoch_id, const bool all_buffers);
 
-  void PersistEpochBegin(FileHandle &file_handle, const size_t epoch_id);
-  void PersistEpochEnd(FileHandle &file_handle, const size_t epoch_id);
-  void PersistLogBuffer(FileHandle &file_handle, std::unique_ptr<LogBuffer> log_buffer);
+  // Write the collected buffers, followed by the end marker of the epoch
+  // unless it is INVALID_EID, sync them and return the buffers to the
+  // workers' pools. Returns false if they could not be made durable.
+  bool PersistBuffers(const eid_t epoch_id);
 
-  std::string GetLogFileFullPath(size_t epoch_id) {
-    return log_dir_ + "/" + logging_filename_prefix_ + "_" + std::to_string(logger_id_) + "_" + std::to_string(epoch_id);
-  }
+  // Queue an epoch end marker for the next flush
+  void PersistEpochEnd(const eid_t epoch_id);
+
+  // Start a new segment and remove the ones covered by the checkpoint
+  void RotateLogFile(const eid_t checkpoint_epoch_id);
+
+  size_t logger_id_;
+
+  std::string log_dir_;
+
+  // backend of the new segments
+  BackendType backend_type_;
+
+  size_t segment_id_;
+
+  // latest epoch with records in the current segment
+  eid_t segment_epoch_id_;
 
-  void GetSortedLogFileIdList(const size_t checkpoint_eid, const size_t persist_eid);
-  
-  void RunRecoveryThread(const size_t thread_id, const size_t checkpoint_eid, const size_t persist_eid);
+  // closed segments and the latest epoch with records in each
+  std::vector<std::pair<size_t, eid_t>> closed_segments_;
 
-  void RunSecIndexRebuildThread(const size_t logger_count);
+  std::unique_ptr<LogFile> log_file_;
 
-  void RebuildSecIndexForTable(const size_t logger_count, storage::DataTable *table);
+  std::atomic<bool> is_running_;
 
-  bool ReplayLogFile(const size_t thread_id, FileHandle &file_handle, size_t checkpoint_eid, size_t pepoch_eid);
-  bool InstallTupleRecord(LogRecordType type, storage::Tuple *tuple, storage::DataTable *table, cid_t cur_cid);
+  std::atomic<eid_t> persist_epoch_id_;
 
-  // Return value is the swapped txn id, either INVALID_TXNID or INITIAL_TXNID
-  txn_id_t LockTuple(storage::TileGroupHeader *tg_header, oid_t tuple_offset);
-  void UnlockTuple(storage::TileGroupHeader *tg_header, oid_t tuple_offset, txn_id_t new_txn_id);
+  // set once a write of the log file failed
+  bool has_failed_;
 
-  private:
-    size_t logger_id_;
-    std::string log_dir_;
+  // latest checkpointed epoch, and the one the segments were rotated for
+  std::atomic<eid_t> truncate_epoch_id_;
 
-    // recovery threads
-    std::vector<std::unique_ptr<std::thread>> recovery_threads_;
-    std::vector<size_t> file_eids_;
-    std::atomic<int> max_replay_file_id_;
+  eid_t truncated_epoch_id_;
 
-    /* Recovery */
-    // TODO: Check if we can discard the recovery pool after the recovery is done. Since every thing is copied to the
-    // tile group and tile group related pool
-    std::vector<std::unique_ptr<VarlenPool>> recovery_pools_;
-    
-    // logger thread
-    std::unique_ptr<std::thread> logger_thread_;
-    volatile bool is_running_;
+  // guards workers_, which grows while the logger runs
+  Spinlock worker_lock_;
 
-    /* File system related */
-    CopySerializeOutput logger_output_buffer_;
+  std::vector<WorkerContext *> workers_;
 
-    /* Log buffers */
-    size_t persist_epoch_id_;
+  // buffers taken from the workers in the current pass
+  std::vector<std::pair<WorkerContext *, std::unique_ptr<LogBuffer>>>
+      persist_buffers_;
 
-    // The spin lock to protect the worker map. We only update this map when creating/terminating a new worker
-    Spinlock worker_map_lock_;
-    // map from worker id to the worker's context.
-    std::unordered_map<oid_t, std::shared_ptr<WorkerContext>> worker_map_;
-  
-    const std::string logging_filename_prefix_ = "log";
+  CopySerializeOutput marker_output_;
 
-    const size_t sleep_period_us_ = 40000;
+  // guards stats_, read while the logger runs
+  Spinlock stats_lock_;
 
-    const int new_file_interval_ = 500; // 500 milliseconds.
-  };
+  LoggerStats stats_;
 
+  static const std::string logging_filename_prefix_;
+};
 
-}
-}
\ No newline at end of file
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// worker_context.h
+//
+// Identification: src/include/logging/worker_context.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/platform.h"
+#include "logging/log_buffer.h"
+#include "logging/log_buffer_pool.h"
+#include "type/serializeio.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Worker Context
+//===--------------------------------------------------------------------===//
+
+// Log state of one worker thread.
+//
+// The records of the running transaction are serialized into txn_output and
+// copied into the current buffer when the transaction ends, so a buffer only
+// holds whole transactions, all of the epoch it is tagged with. A buffer is
+// sealed once it is full or a transaction of a later epoch ends. The logger
+// of the worker takes the sealed buffers, and the current one once its epoch
+// has expired, and returns them to the pool after writing them out.
+struct WorkerContext {
+  WorkerContext(const size_t worker_id)
+      : worker_id(worker_id), buffer_pool(worker_id) {}
+
+  size_t worker_id;
+
+  LogBufferPool buffer_pool;
+
+  // guards current_buffer and full_buffers, which the logger drains
+  Spinlock buffer_lock;
+
+  std::unique_ptr<LogBuffer> current_buffer;
+
+  std::vector<std::unique_ptr<LogBuffer>> full_buffers;
+
+  // records of the running transaction, only touched by the worker
+  CopySerializeOutput txn_output;
+
+  eid_t txn_epoch_id = INVALID_EID;
+
+  cid_t txn_commit_id = INVALID_CID;
+
+  // size of the records of a transaction without writes
+  size_t txn_begin_size = 0;
+
+  // whether the running transaction is logged by its commands, so its
+  // tuples are not logged
+  bool txn_logs_commands = false;
+
+  // changed columns of the update being logged
+  std::vector<uint8_t> column_bitmap;
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logging_service.h
+//
+// Identification: src/include/networking/logging_service.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "peloton/proto/logging_service.pb.h"
+
+//===--------------------------------------------------------------------===//
+// Implements PelotonLoggingService
+//===--------------------------------------------------------------------===//
+
+namespace peloton {
+namespace networking {
+
+// Receives the log shipped by the primary on a replica, and the answers of
+// the replicas on the primary. It is registered with the RPC server of both.
+class LoggingService : public PelotonLoggingService {
+ public:
+  virtual void LogRecordReplay(::google::protobuf::RpcController* controller,
+                               const LogRecordReplayRequest* request,
+                               LogRecordReplayResponse* response,
+                               ::google::protobuf::Closure* done);
+};
+
+}  // namespace networking
+}  // namespace peloton
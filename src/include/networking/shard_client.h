@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_client.h
+//
+// Identification: src/include/networking/shard_client.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace google {
+namespace protobuf {
+class Message;
+}
+}
+
+namespace peloton {
+namespace networking {
+
+class PelotonShardService_Stub;
+class RpcChannel;
+class RpcController;
+class ShardStatementResponse;
+class ShardTransactionResponse;
+
+//===--------------------------------------------------------------------===//
+// Shard Client
+//===--------------------------------------------------------------------===//
+
+// Sends the statements and the 2PC messages of distributed transactions to
+// the other nodes of the shard map over the RPC layer. The RPC layer does not
+// wait for answers: they come back through the shard service of this node,
+// which hands them to the client by the id of their request. A call is sent
+// first and waited for later, so that the calls to several nodes overlap.
+class ShardClient {
+ public:
+  ShardClient(const ShardClient &) = delete;
+  ShardClient &operator=(const ShardClient &) = delete;
+
+  ShardClient();
+
+  ~ShardClient();
+
+  static ShardClient &GetInstance() {
+    static ShardClient shard_client;
+    return shard_client;
+  }
+
+  // Send the statement to the node, in the distributed transaction or in a
+  // transaction of its own if the id is zero. Returns the id of the call.
+  uint64_t SendStatement(const size_t node_id, const int64_t transaction_id,
+                         const std::string &query);
+
+  // Send the first or the second phase of the commit of the distributed
+  // transaction to the node. Returns the id of the call.
+  uint64_t SendPrepare(const size_t node_id, const int64_t transaction_id);
+
+  uint64_t SendFinish(const size_t node_id, const int64_t transaction_id,
+                      const bool commit);
+
+  // Wait for the answer of the call. Returns false if the call could not be
+  // sent or was not answered in time.
+  bool WaitStatement(const uint64_t call_id, ShardStatementResponse &response);
+
+  bool WaitTransaction(const uint64_t call_id,
+                       ShardTransactionResponse &response);
+
+  // Called by the shard service with the answer of a call
+  void Complete(const uint64_t call_id,
+                const google::protobuf::Message &response);
+
+ private:
+  struct Node {
+    std::unique_ptr<RpcChannel> channel;
+
+    std::unique_ptr<RpcController> controller;
+
+    std::unique_ptr<PelotonShardService_Stub> stub;
+  };
+
+  // The node of the shard map, connected on first use
+  Node &GetNode(const size_t node_id);
+
+  // Register the call before it is sent, as the answer may come before the
+  // send returns, and drop it if it fails
+  uint64_t BeginCall();
+
+  void FailCall(const uint64_t call_id);
+
+  bool Wait(const uint64_t call_id, google::protobuf::Message &response);
+
+  // guards the nodes and the stubs, whose controllers are shared
+  std::mutex node_mutex_;
+
+  std::unordered_map<size_t, std::unique_ptr<Node>> nodes_;
+
+  // guards the calls
+  std::mutex call_mutex_;
+
+  std::condition_variable call_cv_;
+
+  uint64_t next_call_id_ = 1;
+
+  // The calls waited for and their answers, nullptr until answered
+  std::unordered_map<uint64_t, std::unique_ptr<google::protobuf::Message>>
+      calls_;
+
+  // The calls that could not be sent
+  std::unordered_set<uint64_t> failed_calls_;
+};
+
+}  // namespace networking
+}  // namespace peloton
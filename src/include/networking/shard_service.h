@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_service.h
+//
+// Identification: src/include/networking/shard_service.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "peloton/proto/shard_service.pb.h"
+
+namespace peloton {
+
+namespace tcop {
+class TrafficCop;
+}
+
+namespace networking {
+
+// Runs the statements other nodes send to the shards of this node, and takes
+// the answers to the statements this node sent. The statements of a
+// distributed transaction run in a session of their own until the
+// coordinator finishes the transaction. A session prepares by checking that
+// its transaction can still commit.
+class ShardService : public PelotonShardService {
+ public:
+  ShardService();
+
+  ~ShardService();
+
+  virtual void ExecuteStatement(::google::protobuf::RpcController *controller,
+                                const ShardStatementRequest *request,
+                                ShardStatementResponse *response,
+                                ::google::protobuf::Closure *done);
+
+  virtual void PrepareTransaction(
+      ::google::protobuf::RpcController *controller,
+      const ShardTransactionRequest *request,
+      ShardTransactionResponse *response, ::google::protobuf::Closure *done);
+
+  virtual void FinishTransaction(::google::protobuf::RpcController *controller,
+                                 const ShardTransactionRequest *request,
+                                 ShardTransactionResponse *response,
+                                 ::google::protobuf::Closure *done);
+
+  // The number of distributed transactions with an open session
+  size_t GetSessionCount();
+
+ private:
+  // The session of the distributed transaction, began if it is new
+  tcop::TrafficCop &GetSession(const int64_t transaction_id);
+
+  // guards the sessions
+  std::mutex session_mutex_;
+
+  // The statements that are not part of a distributed transaction
+  std::unique_ptr<tcop::TrafficCop> autocommit_session_;
+
+  std::unordered_map<int64_t, std::unique_ptr<tcop::TrafficCop>> sessions_;
+};
+
+}  // namespace networking
+}  // namespace peloton
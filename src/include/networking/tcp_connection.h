@@ -26,6 +26,7 @@
 #include <event2/event.h>
 
 #include <memory>
+#include <unordered_map>
 
 namespace peloton {
 namespace networking {
@@ -140,6 +141,25 @@ class Connection {
    */
   bool AddToWriteBuffer(char* buffer, int len);
 
+  /*
+   * Frame the message with the header, type and opcode and serialize it
+   * straight into the write buf, without copying it through another buffer.
+   * return true on success, false on failure.
+   */
+  bool WriteMessage(uint16_t type, uint64_t opcode,
+                    const google::protobuf::Message& message);
+
+  /*
+   * Get a pointer to the first len data of read buf, made contiguous,
+   * the data still exist in the read buf until DrainReadBuffer removes them
+   */
+  const char* PeekReadBuffer(int len);
+
+  /*
+   * Remove the first len data from read buf
+   */
+  void DrainReadBuffer(int len);
+
   /*
    * Forward data in read buf into write buf
    */
@@ -159,6 +179,17 @@ class Connection {
 
   std::string method_name_;
 
+  // The messages the rpc methods are parsed into and respond with, by
+  // opcode. The messages of a connection are processed one at a time, so
+  // they are cleared and reused instead of allocated for every message.
+  struct RpcMessages {
+    std::unique_ptr<google::protobuf::Message> request;
+    std::unique_ptr<google::protobuf::Message> response;
+  };
+  std::unordered_map<uint64_t, RpcMessages> rpc_messages_;
+
+  RpcMessages& GetRpcMessages(uint64_t opcode, const RpcMethod* rpc_method);
+
   // this can be used in buffer cb
   // int total_send_;
 };
@@ -43,6 +43,8 @@ class ChildPropertyGenerator : public OperatorVisitor {
   void Visit(const PhysicalLeftNLJoin *) override;
   void Visit(const PhysicalRightNLJoin *) override;
   void Visit(const PhysicalOuterNLJoin *) override;
+  void Visit(const PhysicalInnerIndexNLJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
   void Visit(const PhysicalInnerHashJoin *) override;
   void Visit(const PhysicalLeftHashJoin *) override;
   void Visit(const PhysicalRightHashJoin *) override;
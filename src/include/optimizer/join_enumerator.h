@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_enumerator.h
+//
+// Identification: src/include/optimizer/join_enumerator.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace parser {
+class SelectStatement;
+}  // namespace parser
+
+namespace storage {
+class DataTable;
+}  // namespace storage
+
+namespace optimizer {
+
+class OperatorExpression;
+class TableStats;
+
+//===--------------------------------------------------------------------===//
+// Join Enumerator
+//
+// Reorders the inner joins of a query by their estimated cost before the
+// query is inserted into the memo. Every tree of inner joins is flattened into
+// its relations and the conjuncts of its join predicates, which form the join
+// graph. The order with the smallest sum of intermediate result sizes is then
+// found by dynamic programming over the connected subsets of the relations,
+// or greedily if there are too many relations.
+//===--------------------------------------------------------------------===//
+class JoinEnumerator {
+ public:
+  // The largest number of relations whose join orders are all enumerated
+  static constexpr size_t kMaxDPRelations = 10;
+
+  // The single table predicates of the WHERE clause of the query filter the
+  // base relations
+  JoinEnumerator(const parser::SelectStatement *select);
+
+  std::shared_ptr<OperatorExpression> ReorderJoins(
+      std::shared_ptr<OperatorExpression> expr);
+
+ private:
+  struct Relation {
+    std::shared_ptr<OperatorExpression> expr;
+    std::unordered_set<std::string> table_aliases;
+    double rows;
+  };
+
+  struct JoinPredicate {
+    std::unique_ptr<expression::AbstractExpression> expr;
+    // The relations the predicate refers to
+    uint64_t relations;
+    double selectivity;
+  };
+
+  // The relations and predicates of a tree of inner joins, and the order they
+  // are joined in. A set of relations that is joined is split into the two
+  // sets that are joined last.
+  struct JoinGraph {
+    std::vector<Relation> relations;
+    std::vector<JoinPredicate> predicates;
+    std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> splits;
+  };
+
+  // Returns false if a relation or predicate cannot be placed in the graph
+  bool CollectRelations(const std::shared_ptr<OperatorExpression> &expr,
+                        JoinGraph &graph);
+
+  bool CollectPredicates(const std::shared_ptr<OperatorExpression> &expr,
+                         JoinGraph &graph);
+
+  void EnumerateDP(JoinGraph &graph);
+
+  void EnumerateGreedy(JoinGraph &graph);
+
+  std::shared_ptr<OperatorExpression> BuildJoinTree(const JoinGraph &graph,
+                                                    uint64_t relations);
+
+  double EstimateRows(const JoinGraph &graph, uint64_t relations) const;
+
+  bool IsConnected(const JoinGraph &graph, uint64_t left,
+                   uint64_t right) const;
+
+  double EstimateRelationRows(const std::shared_ptr<OperatorExpression> &expr);
+
+  double EstimateJoinSelectivity(const JoinGraph &graph,
+                                 const expression::AbstractExpression *expr);
+
+  // The rows of the relation of the column are returned too
+  double EstimateDistinctValues(const JoinGraph &graph,
+                                const expression::AbstractExpression *expr,
+                                double &rows);
+
+  std::shared_ptr<TableStats> GetTableStats(storage::DataTable *table);
+
+  // The single table predicates of the WHERE clause by table alias
+  std::unordered_multimap<std::string, expression::AbstractExpression *>
+      where_predicates_;
+
+  std::unordered_map<oid_t, std::shared_ptr<TableStats>> table_stats_;
+
+  // Reordering changes the columns of SELECT *
+  bool enabled_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
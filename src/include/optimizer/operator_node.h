@@ -58,6 +58,8 @@ enum class OpType {
   LeftNLJoin,
   RightNLJoin,
   OuterNLJoin,
+  InnerIndexNLJoin,
+  InnerMergeJoin,
   InnerHashJoin,
   LeftHashJoin,
   RightHashJoin,
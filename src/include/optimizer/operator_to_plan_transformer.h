@@ -63,6 +63,8 @@ class OperatorToPlanTransformer : public OperatorVisitor {
   void Visit(const PhysicalRightNLJoin *) override;
 
   void Visit(const PhysicalOuterNLJoin *) override;
+  void Visit(const PhysicalInnerIndexNLJoin *) override;
+  void Visit(const PhysicalInnerMergeJoin *) override;
 
   void Visit(const PhysicalInnerHashJoin *) override;
 
@@ -109,7 +111,14 @@ class OperatorToPlanTransformer : public OperatorVisitor {
 
   std::unique_ptr<planner::AbstractPlan> GenerateJoinPlan(
       expression::AbstractExpression *join_predicate, JoinType join_type,
-      bool is_hash);
+      PlanNodeType join_plan_type);
+
+  // Rebuild a scan plan as a full scan of an index in key order
+  std::unique_ptr<planner::AbstractPlan> GenerateKeyOrderedScan(
+      const planner::AbstractPlan &scan_plan, oid_t index_id);
+
+  // Estimate the number of tuples the given plan produces
+  size_t EstimateCardinality(const planner::AbstractPlan &plan);
 
   std::unique_ptr<planner::AbstractPlan> output_plan_;
   std::vector<std::unique_ptr<planner::AbstractPlan>> children_plans_;
@@ -36,6 +36,8 @@ class OperatorVisitor {
   virtual void Visit(const PhysicalLeftNLJoin *) = 0;
   virtual void Visit(const PhysicalRightNLJoin *) = 0;
   virtual void Visit(const PhysicalOuterNLJoin *) = 0;
+  virtual void Visit(const PhysicalInnerIndexNLJoin *) = 0;
+  virtual void Visit(const PhysicalInnerMergeJoin *) = 0;
   virtual void Visit(const PhysicalInnerHashJoin *) = 0;
   virtual void Visit(const PhysicalLeftHashJoin *) = 0;
   virtual void Visit(const PhysicalRightHashJoin *) = 0;
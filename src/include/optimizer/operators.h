@@ -293,6 +293,27 @@ class PhysicalOuterNLJoin : public OperatorNode<PhysicalOuterNLJoin> {
   static Operator make(std::shared_ptr<expression::AbstractExpression> join_predicate);
 };
 
+//===--------------------------------------------------------------------===//
+// InnerIndexNLJoin
+//===--------------------------------------------------------------------===//
+class PhysicalInnerIndexNLJoin
+    : public OperatorNode<PhysicalInnerIndexNLJoin> {
+ public:
+  std::shared_ptr<expression::AbstractExpression> join_predicate;
+  static Operator make(
+      std::shared_ptr<expression::AbstractExpression> join_predicate);
+};
+
+//===--------------------------------------------------------------------===//
+// InnerMergeJoin
+//===--------------------------------------------------------------------===//
+class PhysicalInnerMergeJoin : public OperatorNode<PhysicalInnerMergeJoin> {
+ public:
+  std::shared_ptr<expression::AbstractExpression> join_predicate;
+  static Operator make(
+      std::shared_ptr<expression::AbstractExpression> join_predicate);
+};
+
 //===--------------------------------------------------------------------===//
 // InnerHashJoin
 //===--------------------------------------------------------------------===//
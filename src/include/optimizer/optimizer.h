@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include "optimizer/abstract_optimizer.h"
@@ -68,6 +69,53 @@ class Optimizer : public AbstractOptimizer {
   std::unique_ptr<planner::AbstractPlan> HandleDDLStatement(
       parser::SQLStatement *tree, bool &is_ddl_stmt);
 
+  /* HandlePointStatement - plan a SELECT, UPDATE or DELETE of a single table
+   * whose predicate binds all the keys of a unique index by equality as an
+   * index scan, without searching the memo.
+   *
+   * tree: a bound peloton query tree
+   * return: the plan, or nullptr if the statement is not a point statement
+   */
+  std::unique_ptr<planner::AbstractPlan> HandlePointStatement(
+      parser::SQLStatement *tree);
+
+  /* HandleViewStatement - answer a GROUP BY of a single table from a
+   * materialized aggregate view that groups by the same columns and covers
+   * its aggregates. The plan becomes the child of the view scan, which runs
+   * it whenever the view can not answer.
+   *
+   * tree: a bound peloton query tree
+   * plan: the best plan of the query
+   * return: the view scan, or the plan if no view matches
+   */
+  std::unique_ptr<planner::AbstractPlan> HandleViewStatement(
+      parser::SQLStatement *tree, std::unique_ptr<planner::AbstractPlan> plan);
+
+  /* HandlePartitions - scan the partitions of a partitioned table instead of
+   * the table itself, which keeps no tuples. Only the partitions in which
+   * the predicate of the scan can be satisfied are scanned, through an
+   * append if there are several. Updates and deletes become the ones of
+   * the same partitions.
+   *
+   * tree: a bound peloton query tree
+   * plan: the best plan of the query
+   * return: the plan with the scans of the partitions
+   */
+  std::unique_ptr<planner::AbstractPlan> HandlePartitions(
+      parser::SQLStatement *tree, std::unique_ptr<planner::AbstractPlan> plan);
+
+  /* HandleExchanges - run the sequential scans of a SELECT that the
+   * executors interpret on the exchange workers. A scan of a table that
+   * spans several tile groups becomes the child of an exchange, which gathers
+   * the tiles of the scans of disjoint ranges of the tile groups.
+   *
+   * tree: a bound peloton query tree
+   * plan: the best plan of the query
+   * return: the plan with the exchanges
+   */
+  std::unique_ptr<planner::AbstractPlan> HandleExchanges(
+      parser::SQLStatement *tree, std::unique_ptr<planner::AbstractPlan> plan);
+
   /* TransformQueryTree - create an initial operator tree for the given query
    * to be used in performing optimization.
    *
@@ -217,6 +265,10 @@ class Optimizer : public AbstractOptimizer {
   /// Other Helper functions
   Property *GenerateNewPropertyCols(PropertySet requirements);
 
+  // Whether the time or the number of expressions the search may spend is
+  // used up, after which groups keep the best expression they have
+  bool HasExceededBudget() const;
+
   //////////////////////////////////////////////////////////////////////////////
   /// Member variables
   Memo memo_;
@@ -227,6 +279,11 @@ class Optimizer : public AbstractOptimizer {
 
   // Rules to transform logical plan to physical implementation
   std::vector<std::unique_ptr<Rule>> physical_implementation_rules_;
+
+  // When the search of the current query started and how many expressions
+  // it has costed
+  std::chrono::steady_clock::time_point search_start_time_;
+  size_t search_task_count_ = 0;
 };
 
 } // namespace optimizer
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.h
+//
+// Identification: src/include/optimizer/plan_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/concurrent_cache.h"
+#include "common/memory_tracker.h"
+
+namespace peloton {
+
+class Statement;
+
+namespace optimizer {
+
+//===----------------------------------------------------------------------===//
+// The prepared statements of a parameterized query that are not executing,
+// and the version of the catalog their plans were built for
+//===----------------------------------------------------------------------===//
+struct CachedStatements {
+  // Release the memory charged for the statements
+  ~CachedStatements();
+
+  std::string query;
+  uint64_t catalog_version;
+
+  // The memory footprints of the statements are charged to the plan cache
+  // while they are in the cache
+  std::vector<std::shared_ptr<Statement>,
+              TrackedAllocator<std::shared_ptr<Statement>,
+                               MemoryComponentType::PLAN_CACHE>>
+      statements;
+
+  // Held while statements are taken out or put back
+  std::mutex statements_mutex;
+};
+
+//===----------------------------------------------------------------------===//
+// The process-wide cache of the optimized plans of queries whose literals are
+// replaced by parameters, keyed by the parameterized text of the queries.
+//
+// Binding the parameters writes them into the plan, so a statement can only
+// run one query at a time. A statement is taken out of the cache while it
+// executes and put back afterwards, and a query that runs concurrently with
+// itself gets more than one statement.
+//
+// The queries are spread over the shards of a concurrent cache, so that the
+// connections running the same few queries don't all wait for one lock.
+//===----------------------------------------------------------------------===//
+class PlanCache {
+ public:
+  // The most statements kept for a query
+  static constexpr size_t kMaxStatementsPerQuery = 16;
+
+  static constexpr size_t kShardCount = 16;
+
+  PlanCache(const PlanCache &) = delete;
+  PlanCache &operator=(const PlanCache &) = delete;
+  PlanCache(PlanCache &&) = delete;
+  PlanCache &operator=(PlanCache &&) = delete;
+
+  // Singleton
+  static PlanCache &GetInstance();
+
+  // Take a statement prepared for the query with the given version of the
+  // catalog out of the cache, or null. The statements of an older version are
+  // dropped.
+  std::shared_ptr<Statement> Acquire(const std::string &query,
+                                     uint64_t catalog_version);
+
+  // Put a statement prepared for the query with the given version of the
+  // catalog back into the cache
+  void Release(const std::string &query, uint64_t catalog_version,
+               std::shared_ptr<Statement> statement);
+
+  // A statement for the query to hold on to, e.g. as a prepared statement of
+  // a connection. It's taken from the cache or prepared by the function if
+  // there is none, and put back into the cache once the handle is dropped.
+  std::shared_ptr<Statement> AcquireHandle(
+      const std::string &query, uint64_t catalog_version,
+      const std::function<std::shared_ptr<Statement>()> &prepare);
+
+  // Drop all statements
+  void Clear();
+
+  // The number of cached queries
+  size_t GetCount();
+
+ private:
+  PlanCache();
+
+ private:
+  ConcurrentCache<std::string, CachedStatements> cache_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
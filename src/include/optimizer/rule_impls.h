@@ -229,6 +229,32 @@ class OuterJoinToOuterNLJoin : public Rule {
       const override;
 };
 
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinToInnerIndexNLJoin
+class InnerJoinToInnerIndexNLJoin : public Rule {
+ public:
+  InnerJoinToInnerIndexNLJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan, Memo *memo) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed)
+      const override;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinToInnerMergeJoin
+class InnerJoinToInnerMergeJoin : public Rule {
+ public:
+  InnerJoinToInnerMergeJoin();
+
+  bool Check(std::shared_ptr<OperatorExpression> plan, Memo *memo) const override;
+
+  void Transform(std::shared_ptr<OperatorExpression> input,
+                 std::vector<std::shared_ptr<OperatorExpression>> &transformed)
+      const override;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 /// InnerJoinToInnerHashJoin
 class InnerJoinToInnerHashJoin : public Rule {
@@ -22,10 +22,15 @@ namespace optimizer {
 //===--------------------------------------------------------------------===//
 class Stats {
  public:
-  Stats(TupleSample *sample) : sample_(sample){};
+  Stats(TupleSample *sample, double num_rows = -1)
+      : sample_(sample), num_rows_(num_rows){};
+
+  // The estimated number of rows, negative while unknown
+  inline double GetNumRows() const { return num_rows_; }
 
  private:
    TupleSample *sample_;
+   double num_rows_;
 };
 
 } // namespace optimizer
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_estimator.h
+//
+// Identification: src/include/optimizer/stats/cardinality_estimator.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "optimizer/stats/value_condition.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace optimizer {
+
+class TableStats;
+
+//===----------------------------------------------------------------------===//
+// CardinalityEstimator
+//
+// Estimates the fraction of the tuples of a table that satisfy a predicate.
+// The comparisons of a column with a value are estimated by Selectivity, from
+// the histogram for ranges and from the most common values for equality. The
+// bounds of a range on the same column are estimated together, as one range
+// of the histogram.
+//
+// The columns that a conjunction restricts are rarely independent, so their
+// selectivities are combined with exponential backoff: the most selective one
+// counts fully, the next ones with the square root, fourth root, ... of
+// theirs. The result lies between the product of the selectivities and the
+// smallest one.
+//===----------------------------------------------------------------------===//
+class CardinalityEstimator {
+ public:
+  // The most conjuncts whose selectivities are combined, the others are
+  // assumed to be implied by them
+  static constexpr size_t kMaxBackoffConjuncts = 4;
+
+  // The columns of the predicate are looked up by the column ids they are
+  // bound to
+  static double EstimateSelectivity(
+      const std::shared_ptr<TableStats> &table_stats,
+      const expression::AbstractExpression *predicate);
+
+  // The selectivity of predicates that all hold
+  static double EstimateSelectivity(
+      const std::shared_ptr<TableStats> &table_stats,
+      const std::vector<const expression::AbstractExpression *> &conjuncts);
+
+  // The selectivity of conditions that all hold
+  static double EstimateSelectivity(
+      const std::shared_ptr<TableStats> &table_stats,
+      const std::vector<ValueCondition> &conditions);
+
+  // The selectivity of an equi-join, where every value of the side with
+  // fewer distinct values matches. A side has no more distinct values than
+  // rows.
+  static double EstimateJoinSelectivity(double left_distinct,
+                                        double left_rows,
+                                        double right_distinct,
+                                        double right_rows);
+
+ private:
+  // Add the selectivity of the conditions on each column
+  static void CollectColumnSelectivities(
+      const std::shared_ptr<TableStats> &table_stats,
+      const std::vector<ValueCondition> &conditions,
+      std::vector<double> &selectivities);
+
+  // The selectivity of the conditions on a single column
+  static double EstimateColumnSelectivity(
+      const std::shared_ptr<TableStats> &table_stats,
+      const std::vector<const ValueCondition *> &conditions);
+
+  static double CombineConjuncts(std::vector<double> selectivities);
+
+  // Returns false unless the predicate compares a column with a value
+  static bool GetCondition(const expression::AbstractExpression *predicate,
+                           std::vector<ValueCondition> &conditions);
+};
+
+}  // namespace optimizer
+}  // namespace peloton
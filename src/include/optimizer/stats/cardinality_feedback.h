@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_feedback.h
+//
+// Identification: src/include/optimizer/stats/cardinality_feedback.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/cache.h"
+#include "type/types.h"
+
+namespace peloton {
+
+namespace expression {
+class AbstractExpression;
+}  // namespace expression
+
+namespace optimizer {
+
+//===----------------------------------------------------------------------===//
+// The selectivity the optimizer estimated for the predicate of a table and the
+// one the scans of the table observed, negative while unknown
+//===----------------------------------------------------------------------===//
+struct CardinalityFeedbackEntry {
+  std::string key;
+  double estimated_selectivity;
+  double observed_selectivity;
+};
+
+//===----------------------------------------------------------------------===//
+// Cardinality Feedback
+//
+// The process-wide store of the selectivities that completed scans observed,
+// keyed by the table and the signature of the predicate. The signature is the
+// same for the conjuncts of a predicate in any order, and a parameter stands
+// for all of its values.
+//
+// The optimizer prefers an observed selectivity over its own estimate. Once
+// an observation is off from the estimate that plans were built with by more
+// than the error factor, the cached plans are dropped, so recurring queries
+// are planned again with what was observed.
+//===----------------------------------------------------------------------===//
+class CardinalityFeedback {
+ public:
+  // The most predicates whose selectivities are kept
+  static constexpr size_t kMaxEntries = 4096;
+
+  // The weight of a new observation against the earlier ones
+  static constexpr double kObservationWeight = 0.5;
+
+  CardinalityFeedback(const CardinalityFeedback &) = delete;
+  CardinalityFeedback &operator=(const CardinalityFeedback &) = delete;
+  CardinalityFeedback(CardinalityFeedback &&) = delete;
+  CardinalityFeedback &operator=(CardinalityFeedback &&) = delete;
+
+  // Singleton
+  static CardinalityFeedback &GetInstance();
+
+  // Returns false unless a scan of the table with the conjuncts was observed
+  bool GetSelectivity(
+      oid_t table_id,
+      const std::vector<const expression::AbstractExpression *> &conjuncts,
+      double &selectivity);
+
+  bool GetSelectivity(oid_t table_id,
+                      const expression::AbstractExpression *predicate,
+                      double &selectivity);
+
+  // Remember the estimate plans are built with until a scan is observed
+  void SetEstimate(
+      oid_t table_id,
+      const std::vector<const expression::AbstractExpression *> &conjuncts,
+      double selectivity);
+
+  // A scan of the table with the predicate found the rows out of the scanned
+  // ones. Returns true if the cached plans were dropped.
+  bool Record(oid_t table_id, const expression::AbstractExpression *predicate,
+              size_t rows, size_t scanned_rows);
+
+  // Drop all selectivities
+  void Clear();
+
+  // The number of predicates with a selectivity
+  size_t GetCount();
+
+  // The conjuncts of the predicate rendered in a canonical order
+  static std::string GetSignature(
+      const std::vector<const expression::AbstractExpression *> &conjuncts);
+
+ private:
+  CardinalityFeedback();
+
+  static std::string GetKey(
+      oid_t table_id,
+      const std::vector<const expression::AbstractExpression *> &conjuncts);
+
+  static std::string GetExpressionSignature(
+      const expression::AbstractExpression *expr);
+
+ private:
+  Cache<std::string, CardinalityFeedbackEntry> cache_;
+
+  std::mutex cache_mutex_;
+};
+
+}  // namespace optimizer
+}  // namespace peloton
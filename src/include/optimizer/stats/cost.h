@@ -37,11 +37,15 @@ static constexpr double DEFAULT_INDEX_TUPLE_COST = 0.005;
 // query.
 static constexpr double DEFAULT_OPERATOR_COST = 0.0025;
 
+// Estimate the cost of fetching each tuple found by an index scan, which
+// reads the tuples in random order.
+static constexpr double DEFAULT_INDEX_FETCH_COST = 0.04;
+
 // Default cost of sorting n elements
-  double default_sorting_cost(size_t n) { return n * std::log2(n); }
+inline double default_sorting_cost(size_t n) { return n * std::log2(n); }
 
 // Default number of index tuple to access for n elements
-  double default_index_height(size_t n) { return std::log2(n); }
+inline double default_index_height(size_t n) { return std::log2(n); }
 
 //===----------------------------------------------------------------------===//
 // Cost
@@ -62,6 +66,23 @@ class Cost {
       const ValueCondition& condition,
       std::shared_ptr<TableStats>& output_stats);
 
+  /*
+   * Cost of descending an index once and fetching the tuples of the keys it
+   * finds, which are the given fraction of the rows.
+   */
+  static inline double IndexLookupCost(const double num_rows,
+                                       const double selectivity) {
+    return default_index_height(num_rows) * DEFAULT_INDEX_TUPLE_COST +
+           selectivity * num_rows * DEFAULT_INDEX_FETCH_COST;
+  }
+
+  /*
+   * Cost of keeping an index of the rows up to date for one modified tuple.
+   */
+  static inline double IndexMaintenanceCost(const double num_rows) {
+    return default_index_height(num_rows) * DEFAULT_INDEX_TUPLE_COST;
+  }
+
   /*
    *  Combine two stats with conjunction clause.
    *  ExpressionType type can be CONJUNCTION_AND / CONJUNCTION_OR
@@ -41,6 +41,12 @@ class HyperLogLog {
     hll_->Update(StatsUtil::HashValue(value));
   }
 
+  // Fold in the values counted by another instance of the same precision
+  void Merge(const HyperLogLog& other) {
+    PL_ASSERT(precision_ == other.precision_);
+    hll_->Merge(other.hll_);
+  }
+
   uint64_t EstimateCardinality() {
     uint64_t cardinality = hll_->Estimate();
     LOG_TRACE("Estimated cardinality: %lu", cardinality);
@@ -74,12 +74,21 @@ class StatsStorage {
   ResultType AnalyzeStatsForTable(storage::DataTable *table,
                                   concurrency::Transaction *txn = nullptr);
 
+  // Analyze the tables that had more than the auto analyze threshold of their
+  // tuples modified since they were last analyzed
+  ResultType AnalyzeStatsForStaleTables(
+      concurrency::Transaction *txn = nullptr);
+
   ResultType AnalayzeStatsForColumns(storage::DataTable *table,
                                      std::vector<std::string> column_names);
 
  private:
   std::unique_ptr<type::AbstractPool> pool_;
 
+  // The distinct values of a table estimated from those of a sample
+  double ScaleSampleCardinality(double sample_cardinality, size_t num_rows,
+                                double sample_ratio);
+
   std::shared_ptr<ColumnStats> ConvertVectorToColumnStats(
       oid_t database_id, oid_t table_id, oid_t column_id,
       std::unique_ptr<std::vector<type::Value>> &column_stats_vector);
@@ -30,10 +30,15 @@ class TableStatsCollector {
 
   ~TableStatsCollector();
 
-  void CollectColumnStats();
+  // The stats of a table with more tuples than the sample count are collected
+  // from a random sample of its tuples, 0 always scans the whole table
+  void CollectColumnStats(size_t max_sample_count = 0);
 
   inline size_t GetActiveTupleCount() { return active_tuple_count_; }
 
+  // The number of tuples of the table each collected tuple stands for
+  inline double GetSampleRatio() { return sample_ratio_; }
+
   inline size_t GetColumnCount() { return column_count_; }
 
   ColumnStatsCollector* GetColumnStats(oid_t column_id);
@@ -44,11 +49,14 @@ class TableStatsCollector {
   std::vector<std::unique_ptr<ColumnStatsCollector>> column_stats_collectors_;
   size_t active_tuple_count_;
   size_t column_count_;
+  double sample_ratio_;
 
   TableStatsCollector(const TableStatsCollector&);
   void operator=(const TableStatsCollector&);
 
   void InitColumnStatsCollectors();
+
+  void CollectSampleColumnStats(size_t sample_count);
 };
 
 } /* namespace optimizer */
@@ -15,6 +15,8 @@
 #include <cstdlib>
 #include <algorithm>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 #include "expression/abstract_expression.h"
 #include "planner/abstract_plan.h"
@@ -31,6 +33,8 @@ class DataTable;
 }
 
 namespace optimizer {
+class PropertySort;
+
 namespace util {
 
 inline void to_lower_string(std::string &str) {
@@ -38,7 +42,8 @@ inline void to_lower_string(std::string &str) {
 }
 
 template<class T>
-bool IsSubset (std::unordered_set<T>& super_set, std::unordered_set<T>& child_set) {
+bool IsSubset (const std::unordered_set<T>& super_set,
+               const std::unordered_set<T>& child_set) {
   for (auto element : child_set) {
     if (super_set.find(element) == super_set.end())
       return false;
@@ -60,6 +65,11 @@ void GetPredicateColumns(const catalog::Schema *schema,
                                 std::vector<type::Value> &values,
                                 bool &index_searchable);
 
+// check whether the predicate implies the predicate of a partial index
+bool PredicateImplies(const catalog::Schema *schema,
+                      const expression::AbstractExpression *predicate,
+                      const expression::AbstractExpression *index_predicate);
+
 bool CheckIndexSearchable(storage::DataTable *target_table,
                                  expression::AbstractExpression *expression,
                                  std::vector<oid_t> &key_column_ids,
@@ -84,12 +94,51 @@ expression::AbstractExpression* ConstructJoinPredicate(
     std::unordered_set<std::string>& table_alias_set,
     MultiTablePredicates& join_predicates);
 
+// Split the predicate required at a join into the conjuncts on the tables of
+// either child, which the child can evaluate, and the rest, which the join
+// has to. The conjuncts are copied, and a part without any is nullptr.
+void SplitJoinPredicate(
+    expression::AbstractExpression* predicate,
+    const std::unordered_set<std::string>& l_group_alias,
+    const std::unordered_set<std::string>& r_group_alias,
+    expression::AbstractExpression*& l_predicate,
+    expression::AbstractExpression*& r_predicate,
+    expression::AbstractExpression*& join_predicate);
+
 bool ContainsJoinColumns(
     const std::unordered_set<std::string>& l_group_alias,
     const std::unordered_set<std::string>& r_group_alias,
     const expression::AbstractExpression* expr);
 
 
+// Get the columns of the table with the given alias that the equality
+// predicates of expr compare with columns of the tables of other_alias
+void GetJoinColumns(const std::string& table_alias,
+                    const std::unordered_set<std::string>& other_alias,
+                    const expression::AbstractExpression* expr,
+                    std::vector<oid_t>& column_ids);
+
+// Find the index of the table that an index nested loop join can look up the
+// values of the given columns in. The leading key columns of the index must
+// all be among them, and a hash index must be covered entirely. Returns the
+// number of leading key columns that are covered, or 0 if no index is.
+size_t GetJoinIndex(storage::DataTable* table,
+                    const std::vector<oid_t>& column_ids, oid_t& index_id);
+
+// Find an index of the table whose first key column is the given one, so
+// that a full scan of it produces the tuples in the order of the column.
+// Returns false if there is none.
+bool GetOrderedIndex(storage::DataTable* table, oid_t column_id,
+                     oid_t& index_id);
+
+// Find an index of the table whose leading key columns are the columns of
+// the sort property, all ascending or all descending, so that a scan of it
+// in key order, or in reverse key order if descending is set, satisfies the
+// property. Returns false if there is none.
+bool GetSortIndex(storage::DataTable* table, const std::string& alias,
+                  const PropertySort* sort_prop, oid_t& index_id,
+                  bool& descending);
+
 std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(parser::CopyStatement* copy_stmt);
 
 
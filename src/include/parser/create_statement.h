@@ -14,6 +14,7 @@
 
 #include "type/types.h"
 #include "common/sql_node_visitor.h"
+#include "parser/select_statement.h"
 #include "parser/sql_statement.h"
 #include "expression/abstract_expression.h"
 
@@ -24,7 +25,7 @@ namespace parser {
  * @struct ColumnDefinition
  * @brief Represents definition of a table column
  */
-struct ColumnDefinition {
+struct ColumnDefinition : public ArenaNode {
   enum DataType {
     INVALID,
 
@@ -187,7 +188,7 @@ struct ColumnDefinition {
  */
 class CreateStatement : public TableRefStatement {
  public:
-  enum CreateType { kTable, kDatabase, kIndex };
+  enum CreateType { kTable, kDatabase, kIndex, kMaterializedView };
 
   CreateStatement(CreateType type)
       : TableRefStatement(StatementType::CREATE),
@@ -212,6 +213,13 @@ class CreateStatement : public TableRefStatement {
     if (database_name != nullptr) {
       delete[] (database_name);
     }
+
+    if (index_predicate != nullptr) {
+      delete index_predicate;
+    }
+    if (view_query != nullptr) {
+      delete view_query;
+    }
   }
 
   virtual void Accept(SqlNodeVisitor* v) const override {
@@ -229,7 +237,21 @@ class CreateStatement : public TableRefStatement {
   char* index_name = nullptr;
   char* database_name = nullptr;
 
+  // WHERE clause of a partial index
+  expression::AbstractExpression* index_predicate = nullptr;
+  // SELECT of a materialized view
+  SelectStatement* view_query = nullptr;
+
   bool unique = false;
+
+  // WITH (append_only) of a table
+  bool append_only = false;
+
+  // WITH (partition_column = c, hash_partitions = n) or
+  // WITH (partition_column = c, range_partitions = 'bound, ...') of a table
+  std::string partition_column;
+  size_t hash_partition_count = 0;
+  std::vector<std::string> range_partition_bounds;
 };
 
 }  // End parser namespace
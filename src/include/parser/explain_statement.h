@@ -0,0 +1,43 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// explain_statement.h
+//
+// Identification: src/include/parser/explain_statement.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+
+#include "common/sql_node_visitor.h"
+#include "parser/sql_statement.h"
+
+namespace peloton {
+namespace parser {
+
+/**
+ * @class ExplainStatement
+ * @brief EXPLAIN [ANALYZE] <statement>
+ */
+class ExplainStatement : public SQLStatement {
+ public:
+  ExplainStatement() : SQLStatement(StatementType::EXPLAIN) {}
+
+  virtual ~ExplainStatement() {}
+
+  virtual void Accept(SqlNodeVisitor* v) const override { v->Visit(this); }
+
+  // The statement explained
+  std::unique_ptr<SQLStatement> real_sql_stmt;
+
+  // Whether the statement runs, to profile its executors
+  bool analyze = false;
+};
+
+}  // namespace parser
+}  // namespace peloton
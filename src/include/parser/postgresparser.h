@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "parser/statements.h"
 #include "parser/pg_query.h"
 #include "parser/parsenodes.h"
+#include "type/value.h"
 
 namespace peloton {
 namespace parser {
@@ -52,6 +56,14 @@ class PostgresParser {
   std::unique_ptr<parser::SQLStatementList> BuildParseTree(
       const std::string& query_string);
 
+  // Replace the literals that a SELECT, UPDATE or DELETE compares columns
+  // with in its WHERE clause, and the ones of a single row INSERT, by the
+  // parameters $1, $2, ... Queries that differ in these literals only then
+  // have the same text. Returns false if there is nothing to replace.
+  static bool ParameterizeLiterals(const std::string& query,
+                                   std::string& parameterized_query,
+                                   std::vector<type::Value>& params);
+
  private:
   //===--------------------------------------------------------------------===//
   // Helper Functions
@@ -87,7 +99,7 @@ class PostgresParser {
   static bool IsAggregateFunction(std::string& fun_name) {
     if (fun_name == "min" || fun_name == "max" ||
         fun_name == "count" || fun_name == "avg" ||
-        fun_name == "sum")
+        fun_name == "sum" || fun_name == "approx_count_distinct")
       return true;
     return false;
   }
@@ -166,6 +178,9 @@ class PostgresParser {
   // transform helper for create db statement
   static parser::SQLStatement* CreateDbTransform(CreatedbStmt* root);
 
+  // transform helper for create materialized view statements
+  static parser::SQLStatement* CreateViewTransform(CreateTableAsStmt* root);
+
   // transform helper for column name (for insert statement)
   static std::vector<char*>* ColumnNameTransform(List* root);
 
@@ -203,6 +218,15 @@ class PostgresParser {
   // transform helper for transaction statement
   static parser::TransactionStatement* TransactionTransform(TransactionStmt* root);
 
+  // transform helper for the isolation level of a transaction
+  static IsolationLevelType IsolationLevelTransform(const char* level);
+
+  // transform helper for a boolean option like WITH (name [= value])
+  static bool BoolOptionTransform(DefElem* root);
+
+  // transform helper for the value of an option like WITH (name = value)
+  static std::string OptionValueTransform(DefElem* root);
+
   // transform helper for execute statement
   static parser::ExecuteStatement* ExecuteTransform(ExecuteStmt* root);
 
@@ -219,6 +243,20 @@ class PostgresParser {
 
   // transform helper for analyze statement
   static parser::AnalyzeStatement* VacuumTransform(VacuumStmt* root);
+
+  // transform helper for explain statement
+  static parser::ExplainStatement* ExplainTransform(ExplainStmt* root);
+
+  // helpers for parameterizing literals, the literals are collected from
+  // the raw parse tree of a statement
+  static void CollectLiterals(Node* stmt, std::vector<A_Const*>& literals);
+
+  static void CollectWhereLiterals(Node* root,
+                                   std::vector<A_Const*>& literals);
+
+  // The length of the text of a literal, or 0 if the text at its location
+  // is not exactly its value
+  static size_t LiteralLength(const std::string& query, A_Const* literal);
 };
 
 }  // End parser namespace
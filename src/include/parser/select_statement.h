@@ -28,7 +28,7 @@ namespace parser {
  */
 typedef enum { kOrderAsc, kOrderDesc } OrderType;
 
-class OrderDescription {
+class OrderDescription : public ArenaNode {
  public:
   OrderDescription() {}
 
@@ -53,7 +53,7 @@ class OrderDescription {
  */
 const int64_t kNoLimit = -1;
 const int64_t kNoOffset = -1;
-class LimitDescription {
+class LimitDescription : public ArenaNode {
  public:
   LimitDescription(int64_t limit, int64_t offset)
       : limit(limit), offset(offset) {}
@@ -67,7 +67,7 @@ class LimitDescription {
 /**
  * @class GroupByDescription
  */
-class GroupByDescription {
+class GroupByDescription : public ArenaNode {
  public:
   GroupByDescription() : columns(NULL), having(NULL) {}
 
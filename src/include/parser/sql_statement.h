@@ -17,11 +17,14 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "common/arena_node.h"
 #include "common/sql_node_visitor.h"
 #include "common/macros.h"
 #include "common/printable.h"
+#include "type/arena_pool.h"
 #include "type/types.h"
 
 namespace peloton {
@@ -40,8 +43,9 @@ struct TableInfo {
   char* database_name = nullptr;
 };
 
-// Base class for every SQLStatement
-class SQLStatement : public Printable {
+// Base class for every SQLStatement. The statements of a parse are allocated
+// from the arena of their SQLStatementList.
+class SQLStatement : public Printable, public ArenaNode {
  public:
   SQLStatement(StatementType type) : stmt_type(type){};
 
@@ -118,6 +122,10 @@ class SQLStatementList : public Printable {
   const char* parser_msg;
   int error_line;
   int error_col;
+
+  // The arena the parser allocated the nodes of the statements from, if any.
+  // It is destroyed after the statements.
+  std::unique_ptr<type::ArenaPool> arena;
 };
 
 }  // End parser namespace
@@ -28,7 +28,7 @@ class JoinDefinition;
 
 //  Holds reference to tables.
 // Can be either table names or a select statement.
-struct TableRef {
+struct TableRef : public ArenaNode {
   TableRef(TableReferenceType type)
       : type(type),
         schema(NULL),
@@ -78,7 +78,7 @@ struct TableRef {
 };
 
 // Definition of a join table
-class JoinDefinition {
+class JoinDefinition : public ArenaNode {
  public:
   JoinDefinition()
       : left(NULL), right(NULL), condition(NULL), type(JoinType::INNER) {}
@@ -20,7 +20,8 @@ namespace parser {
 
 /**
  * @class TransactionStatement
- * @brief Represents "BEGIN or COMMIT or ROLLBACK [TRANSACTION]"
+ * @brief Represents "BEGIN [TRANSACTION] [ISOLATION LEVEL level] [READ ONLY]
+ * or COMMIT or ROLLBACK [TRANSACTION]"
  */
 class TransactionStatement : public SQLStatement {
  public:
@@ -30,14 +31,25 @@ class TransactionStatement : public SQLStatement {
     kRollback,
   };
 
-  TransactionStatement(CommandType type)
-      : SQLStatement(StatementType::TRANSACTION), type(type) {}
+  TransactionStatement(
+      CommandType type, bool read_only = false,
+      IsolationLevelType isolation = IsolationLevelType::INVALID)
+      : SQLStatement(StatementType::TRANSACTION),
+        type(type),
+        read_only(read_only),
+        isolation(isolation) {}
 
   virtual void Accept(SqlNodeVisitor* v) const override {
     v->Visit(this);
   }
 
   CommandType type;
+
+  // BEGIN READ ONLY
+  bool read_only;
+
+  // BEGIN ISOLATION LEVEL, INVALID if the default level is used
+  IsolationLevelType isolation;
 };
 
 }  // End parser namespace
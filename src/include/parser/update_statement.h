@@ -26,7 +26,7 @@ namespace parser {
  * @struct UpdateClause
  * @brief Represents "column = value" expressions
  */
-class UpdateClause {
+class UpdateClause : public ArenaNode {
  public:
   char* column;
   expression::AbstractExpression* value;
@@ -61,6 +61,10 @@ class AbstractPlan : public Printable {
 
   const AbstractPlan *GetChild(uint32_t child_index) const;
 
+  // Replace the child at the index, and return the child it replaced
+  std::unique_ptr<AbstractPlan> ReplaceChild(
+      uint32_t child_index, std::unique_ptr<AbstractPlan> &&child);
+
   const AbstractPlan *GetParent() const;
 
   //===--------------------------------------------------------------------===//
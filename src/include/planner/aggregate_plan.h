@@ -113,6 +113,13 @@ class AggregatePlan : public AbstractPlan {
 
   const std::vector<oid_t> &GetColumnIds() const { return column_ids_; }
 
+  // The estimated number of groups, zero if unknown
+  void SetGroupCardinality(size_t group_cardinality) {
+    group_cardinality_ = group_cardinality;
+  }
+
+  size_t GetGroupCardinality() const { return group_cardinality_; }
+
   std::unique_ptr<AbstractPlan> Copy() const override {
     std::vector<AggTerm> copied_agg_terms;
     for (const AggTerm &term : unique_agg_terms_) {
@@ -126,6 +133,7 @@ class AggregatePlan : public AbstractPlan {
         project_info_->Copy(), std::unique_ptr<const expression::AbstractExpression>(predicate_->Copy()),
         std::move(copied_agg_terms), std::move(copied_groupby_col_ids),
         output_schema_copy, agg_strategy_);
+    new_plan->SetGroupCardinality(group_cardinality_);
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
@@ -152,6 +160,9 @@ class AggregatePlan : public AbstractPlan {
   /** @brief Columns involved */
   std::vector<oid_t> column_ids_;
 
+  /* Estimated number of groups */
+  size_t group_cardinality_ = 0;
+
  private:
   DISALLOW_COPY_AND_MOVE(AggregatePlan);
 };
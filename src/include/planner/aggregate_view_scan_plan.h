@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregate_view_scan_plan.h
+//
+// Identification: src/include/planner/aggregate_view_scan_plan.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "planner/abstract_plan.h"
+#include "type/types.h"
+
+namespace peloton {
+
+namespace storage {
+class AggregateView;
+}
+
+namespace planner {
+
+/**
+ * @brief Answers an aggregate query from a materialized aggregate view.
+ *
+ * The child is the plan of the query itself. It runs instead whenever the
+ * view can not answer for the transaction.
+ */
+class AggregateViewScanPlan : public AbstractPlan {
+ public:
+  // One output column: a group column or an aggregate over the view
+  struct OutputColumn {
+    // VALUE_TUPLE for a group column
+    ExpressionType type;
+
+    // Offset among the group columns or the aggregated columns of the view
+    oid_t offset;
+  };
+
+  AggregateViewScanPlan(std::shared_ptr<storage::AggregateView> view,
+                        std::vector<OutputColumn> output_columns,
+                        std::shared_ptr<const catalog::Schema> output_schema)
+      : view_(view),
+        output_columns_(std::move(output_columns)),
+        output_schema_(output_schema) {}
+
+  inline PlanNodeType GetPlanNodeType() const {
+    return PlanNodeType::AGGREGATE_VIEW_SCAN;
+  }
+
+  const std::string GetInfo() const { return "AggregateViewScan"; }
+
+  const std::shared_ptr<storage::AggregateView> &GetView() const {
+    return view_;
+  }
+
+  const std::vector<OutputColumn> &GetOutputColumns() const {
+    return output_columns_;
+  }
+
+  const catalog::Schema *GetOutputSchema() const {
+    return output_schema_.get();
+  }
+
+  std::unique_ptr<AbstractPlan> Copy() const {
+    std::unique_ptr<AbstractPlan> new_plan(
+        new AggregateViewScanPlan(view_, output_columns_, output_schema_));
+    for (auto &child : GetChildren()) {
+      new_plan->AddChild(child->Copy());
+    }
+    return new_plan;
+  }
+
+ private:
+  std::shared_ptr<storage::AggregateView> view_;
+
+  std::vector<OutputColumn> output_columns_;
+
+  std::shared_ptr<const catalog::Schema> output_schema_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(AggregateViewScanPlan);
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -37,6 +37,14 @@ class CopyPlan : public AbstractPlan {
     LOG_DEBUG("Creating a Copy Plan");
   }
 
+  // COPY FROM the file into the table
+  CopyPlan(char *file_path, storage::DataTable *table, char delimiter)
+      : file_path(file_path), table(table), delimiter(delimiter) {
+    LOG_DEBUG("Creating a Copy From Plan");
+  }
+
+  inline bool IsCopyFrom() const { return table != nullptr; }
+
   inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::COPY; }
 
   const std::string GetInfo() const { return "CopyPlan"; }
@@ -50,6 +58,12 @@ class CopyPlan : public AbstractPlan {
   // Whether the copying requires deserialization of parameters
   bool deserialize_parameters = false;
 
+  // The table a COPY FROM loads the rows of the file into
+  storage::DataTable *table = nullptr;
+
+  // Field delimiter between the columns of the file
+  char delimiter = ',';
+
  private:
   DISALLOW_COPY_AND_MOVE(CopyPlan);
 };
@@ -18,6 +18,9 @@ namespace peloton {
 namespace catalog {
 class Schema;
 }
+namespace expression {
+class AbstractExpression;
+}
 namespace storage {
 class DataTable;
 }
@@ -59,10 +62,39 @@ class CreatePlan : public AbstractPlan {
 
   bool IsUnique() const { return unique; }
 
+  // Whether the table is only ever inserted into
+  bool IsAppendOnly() const { return append_only; }
+
+  // Column the table is partitioned by, empty if it is not partitioned
+  std::string GetPartitionColumn() const { return partition_column; }
+
+  size_t GetHashPartitionCount() const { return hash_partition_count; }
+
+  // Lower bounds of the range partitions, in text form
+  std::vector<std::string> GetRangePartitionBounds() const {
+    return range_partition_bounds;
+  }
+
   IndexType GetIndexType() const { return index_type; }
 
   std::vector<std::string> GetIndexAttributes() const { return index_attrs; }
 
+  // Predicate of a partial index, in terms of column names
+  const expression::AbstractExpression *GetIndexPredicate() const {
+    return index_predicate.get();
+  }
+
+  std::string GetViewName() const { return view_name; }
+
+  // Columns a materialized view groups by and aggregates
+  std::vector<std::string> GetViewGroupColumns() const {
+    return view_group_columns;
+  }
+
+  std::vector<std::string> GetViewAggregateColumns() const {
+    return view_aggregate_columns;
+  }
+
  private:
   // Target Table
   storage::DataTable *target_table_ = nullptr;
@@ -91,6 +123,24 @@ class CreatePlan : public AbstractPlan {
   // UNIQUE INDEX flag
   bool unique;
 
+  // WITH (append_only) flag of a table
+  bool append_only = false;
+
+  // WITH (partition_column, hash_partitions | range_partitions) of a table
+  std::string partition_column;
+  size_t hash_partition_count = 0;
+  std::vector<std::string> range_partition_bounds;
+
+  // WHERE clause of a partial index
+  std::shared_ptr<expression::AbstractExpression> index_predicate;
+
+  // Materialized view name, table_name is the table it aggregates
+  std::string view_name;
+
+  std::vector<std::string> view_group_columns;
+
+  std::vector<std::string> view_aggregate_columns;
+
  private:
   DISALLOW_COPY_AND_MOVE(CreatePlan);
 };
@@ -53,11 +53,15 @@ class DropPlan : public AbstractPlan {
 
   bool IsMissing() const { return missing; }
 
+  // The name is the one of a materialized view
+  bool IsView() const { return is_view; }
+
  private:
   // Target Table
   storage::DataTable *target_table_ = nullptr;
   std::string table_name;
   bool missing;
+  bool is_view = false;
 
  private:
   DISALLOW_COPY_AND_MOVE(DropPlan);
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// exchange_plan.h
+//
+// Identification: src/include/planner/exchange_plan.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "abstract_plan.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace planner {
+
+/**
+ * @brief Plan node for an exchange.
+ * Runs several instances of its child, a sequential scan, on disjoint ranges
+ * of the tile groups of the table and gathers their logical tiles. The tiles
+ * are produced in no particular order.
+ */
+class ExchangePlan : public AbstractPlan {
+ public:
+  explicit ExchangePlan(size_t num_instances)
+      : num_instances_(num_instances) {}
+
+  // The number of instances of the child to run, 0 for one per worker thread
+  size_t GetNumInstances() const { return num_instances_; }
+
+  inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::EXCHANGE; }
+
+  const std::string GetInfo() const { return "Exchange"; }
+
+  std::unique_ptr<AbstractPlan> Copy() const {
+    return std::unique_ptr<AbstractPlan>(new ExchangePlan(num_instances_));
+  }
+
+ private:
+  const size_t num_instances_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(ExchangePlan);
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -80,6 +80,13 @@ class HashJoinPlan : public AbstractJoinPlan {
     }
   }
 
+  // The estimated number of tuples on the build (left) side, zero if unknown
+  void SetBuildCardinality(size_t build_cardinality) {
+    build_cardinality_ = build_cardinality;
+  }
+
+  size_t GetBuildCardinality() const { return build_cardinality_; }
+
   std::unique_ptr<AbstractPlan> Copy() const override {
     std::unique_ptr<const expression::AbstractExpression> predicate_copy(
         GetPredicate()->Copy());
@@ -88,6 +95,7 @@ class HashJoinPlan : public AbstractJoinPlan {
     HashJoinPlan *new_plan = new HashJoinPlan(
         GetJoinType(), std::move(predicate_copy),
         GetProjInfo()->Copy(), schema_copy, outer_column_ids_);
+    new_plan->SetBuildCardinality(build_cardinality_);
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
@@ -99,6 +107,8 @@ class HashJoinPlan : public AbstractJoinPlan {
   std::vector<std::unique_ptr<const expression::AbstractExpression>>
       right_hash_keys_;
 
+  size_t build_cardinality_ = 0;
+
  private:
   DISALLOW_COPY_AND_MOVE(HashJoinPlan);
 };
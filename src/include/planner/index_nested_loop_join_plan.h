@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_nested_loop_join_plan.h
+//
+// Identification: src/include/planner/index_nested_loop_join_plan.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "planner/abstract_join_plan.h"
+
+namespace peloton {
+namespace planner {
+
+class ProjectInfo;
+
+//===----------------------------------------------------------------------===//
+// A nested loop join whose right child is an index scan of the inner table.
+// The join keys of every outer tile are looked up in the index as one batch,
+// instead of scanning the inner table for every outer tuple.
+//===----------------------------------------------------------------------===//
+class IndexNestedLoopJoinPlan : public AbstractJoinPlan {
+ public:
+  // The join columns are output columns of the children, and the right ones
+  // must be key columns of the index the right child scans
+  IndexNestedLoopJoinPlan(
+      JoinType join_type,
+      std::unique_ptr<const expression::AbstractExpression> &&predicate,
+      std::unique_ptr<const ProjectInfo> &&proj_info,
+      std::shared_ptr<const catalog::Schema> &proj_schema,
+      const std::vector<oid_t> &join_column_ids_left,
+      const std::vector<oid_t> &join_column_ids_right);
+
+  // Nested loops don't need to perform any attribute binding
+  void HandleSubplanBinding(UNUSED_ATTRIBUTE bool,
+                            UNUSED_ATTRIBUTE const BindingContext &) override {}
+
+  inline PlanNodeType GetPlanNodeType() const override {
+    return PlanNodeType::NESTLOOPINDEX;
+  }
+
+  const std::string GetInfo() const override {
+    return "IndexNestedLoopJoin";
+  }
+
+  std::unique_ptr<AbstractPlan> Copy() const override {
+    std::unique_ptr<const expression::AbstractExpression> predicate_copy(
+        GetPredicate() != nullptr ? GetPredicate()->Copy() : nullptr);
+
+    std::shared_ptr<const catalog::Schema> schema_copy(
+        catalog::Schema::CopySchema(GetSchema()));
+
+    return std::unique_ptr<AbstractPlan>(new IndexNestedLoopJoinPlan(
+        GetJoinType(), std::move(predicate_copy), GetProjInfo()->Copy(),
+        schema_copy, join_column_ids_left_, join_column_ids_right_));
+  }
+
+  const std::vector<oid_t> &GetJoinColumnsLeft() const {
+    return join_column_ids_left_;
+  }
+
+  const std::vector<oid_t> &GetJoinColumnsRight() const {
+    return join_column_ids_right_;
+  }
+
+ private:
+  // The columns of the left child whose values are looked up
+  std::vector<oid_t> join_column_ids_left_;
+
+  // The columns of the right child they are looked up on
+  std::vector<oid_t> join_column_ids_right_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(IndexNestedLoopJoinPlan);
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -149,6 +149,8 @@ class IndexScanPlan : public AbstractScan {
 
   inline bool GetDescend() const { return descend_; }
 
+  inline bool IsKeyOrdered() const { return key_ordered_; }
+
   const std::string GetInfo() const { return "IndexScan"; }
 
   void SetLimit(bool limit) { limit_ = limit; }
@@ -159,6 +161,9 @@ class IndexScanPlan : public AbstractScan {
 
   void SetDescend(bool descend) { descend_ = descend; }
 
+  // Produce the tuples in the order of the index keys, e.g. for a merge join
+  void SetKeyOrdered(bool key_ordered) { key_ordered_ = key_ordered; }
+
   void SetParameterValues(std::vector<type::Value> *values);
 
   std::unique_ptr<AbstractPlan> Copy() const {
@@ -171,6 +176,11 @@ class IndexScanPlan : public AbstractScan {
                        new_runtime_keys);
     IndexScanPlan *new_plan = new IndexScanPlan(
         GetTable(), GetPredicate()->Copy(), GetColumnIds(), desc, false);
+    new_plan->SetKeyOrdered(key_ordered_);
+    new_plan->SetDescend(descend_);
+    new_plan->SetLimit(limit_);
+    new_plan->SetLimitNumber(limit_number_);
+    new_plan->SetLimitOffset(limit_offset_);
     return std::unique_ptr<AbstractPlan>(new_plan);
   }
 
@@ -228,6 +238,9 @@ class IndexScanPlan : public AbstractScan {
   // whether order by is descending
   bool descend_ = false;
 
+  // whether the tuples are produced in the order of the index keys
+  bool key_ordered_ = false;
+
  private:
   DISALLOW_COPY_AND_MOVE(IndexScanPlan);
 };
@@ -59,6 +59,9 @@ class InsertPlan : public AbstractPlan {
 
   void SetParameterValues(std::vector<type::Value> *values);
 
+  // Bind the columns of the child, which are inserted in order
+  void PerformBinding(BindingContext &binding_context) override;
+
   storage::DataTable *GetTable() const { return target_table_; }
 
   const planner::ProjectInfo *GetProjectInfo() const {
@@ -74,6 +77,11 @@ class InsertPlan : public AbstractPlan {
     return tuples_[tuple_idx].get();
   }
 
+  // The attributes of the child that go into the columns of the table
+  const std::vector<const AttributeInfo *> &GetAttributeInfos() const {
+    return ais_;
+  }
+
   const std::string GetInfo() const { return "InsertPlan"; }
 
   std::unique_ptr<AbstractPlan> Copy() const {
@@ -105,6 +113,9 @@ class InsertPlan : public AbstractPlan {
   // pool for variable length types
   std::unique_ptr<type::AbstractPool> pool_;
 
+  // The attributes of the child, set by the binding
+  std::vector<const AttributeInfo *> ais_;
+
  private:
   DISALLOW_COPY_AND_MOVE(InsertPlan);
 };
@@ -109,6 +109,49 @@ class PlanUtil {
       }
     }
   }
+
+ public:
+  /**
+   * @brief Check whether executing the plan writes to the database. Scans
+   * that take ownership of the tuples they read count as writes.
+   * @param The plan tree
+   * @return true if the plan writes
+   */
+  static bool IsModifyingPlan(const planner::AbstractPlan *plan) {
+    if (plan == nullptr) {
+      return false;
+    }
+
+    switch (plan->GetPlanNodeType()) {
+      case PlanNodeType::UPDATE:
+      case PlanNodeType::INSERT:
+      case PlanNodeType::DELETE:
+      case PlanNodeType::DROP:
+      case PlanNodeType::CREATE:
+      case PlanNodeType::POPULATE_INDEX:
+      case PlanNodeType::ANALYZE:
+        return true;
+      case PlanNodeType::ABSTRACT_SCAN:
+      case PlanNodeType::SEQSCAN:
+      case PlanNodeType::INDEXSCAN: {
+        const planner::AbstractScan *scan_node =
+            reinterpret_cast<const planner::AbstractScan *>(plan);
+        if (scan_node->IsForUpdate() == true) {
+          return true;
+        }
+        break;
+      }
+      default: {
+        break;
+      }
+    }  // SWITCH
+    for (auto &child : plan->GetChildren()) {
+      if (IsModifyingPlan(child.get()) == true) {
+        return true;
+      }
+    }
+    return false;
+  }
 };
 
 }  // namespace planner
@@ -13,6 +13,7 @@
 #pragma once
 
 #include "abstract_plan.h"
+#include "planner/attribute_info.h"
 #include "type/types.h"
 
 namespace peloton {
@@ -33,6 +34,18 @@ class SetOpPlan : public AbstractPlan {
 
   inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::SETOP; }
 
+  // The output of the set operation is the one of the left child. The columns
+  // of the right child are bound separately, in the same order.
+  void PerformBinding(BindingContext &binding_context);
+
+  const std::vector<const AttributeInfo *> &GetLeftAttributes() const {
+    return left_ais_;
+  }
+
+  const std::vector<const AttributeInfo *> &GetRightAttributes() const {
+    return right_ais_;
+  }
+
   const std::string GetInfo() const { return "SetOp"; }
 
   std::unique_ptr<AbstractPlan> Copy() const {
@@ -43,6 +56,10 @@ class SetOpPlan : public AbstractPlan {
   /** @brief Set Operation of this node */
   SetOpType set_op_;
 
+  // The attributes of the columns of the left and right child
+  std::vector<const AttributeInfo *> left_ais_;
+  std::vector<const AttributeInfo *> right_ais_;
+
  private:
   DISALLOW_COPY_AND_MOVE(SetOpPlan);
 };
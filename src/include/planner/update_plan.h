@@ -65,15 +65,40 @@ class UpdatePlan : public AbstractPlan {
 
   storage::DataTable *GetTable() const { return target_table_; }
 
+  // Bind the SET expressions, and the columns that keep their values, to the
+  // attributes of the child
+  void PerformBinding(BindingContext &binding_context) override;
+
+  // The attributes the new values of the columns of the table come from
+  const std::vector<const AttributeInfo *> &GetAttributeInfos() const {
+    return ais_;
+  }
+
   const std::string GetInfo() const { return "UpdatePlan"; }
 
   void SetParameterValues(std::vector<type::Value> *values);
 
   bool GetUpdatePrimaryKey() const { return update_primary_key_; }
 
+  // The table the new tuples of a primary key update are inserted into
+  storage::DataTable *GetInsertTable() const {
+    return (insert_table_ != nullptr) ? insert_table_ : target_table_;
+  }
+
+  // Update a partition by deleting the old tuples and inserting the new ones
+  // through the partitioned table, which moves them to the partition of
+  // their new key
+  void SetInsertTable(storage::DataTable *table) {
+    insert_table_ = table;
+    update_primary_key_ = true;
+  }
+
   std::unique_ptr<AbstractPlan> Copy() const {
-    return std::unique_ptr<AbstractPlan>(
-        new UpdatePlan(target_table_, project_info_->Copy()));
+    auto update_plan = new UpdatePlan(target_table_, project_info_->Copy());
+    if (insert_table_ != nullptr) {
+      update_plan->SetInsertTable(insert_table_);
+    }
+    return std::unique_ptr<AbstractPlan>(update_plan);
   }
 
  private:
@@ -98,6 +123,12 @@ class UpdatePlan : public AbstractPlan {
   // Whether update primary key
   bool update_primary_key_;
 
+  // The partitioned table of a partition whose key is updated
+  storage::DataTable *insert_table_ = nullptr;
+
+  // The attributes of the new values, set by the binding
+  std::vector<const AttributeInfo *> ais_;
+
  private:
   DISALLOW_COPY_AND_MOVE(UpdatePlan);
 };
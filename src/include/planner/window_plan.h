@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// window_plan.h
+//
+// Identification: src/include/planner/window_plan.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "planner/abstract_plan.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace planner {
+
+enum class WindowFunctionType {
+  ROW_NUMBER,
+  RANK,
+  DENSE_RANK,
+  COUNT,
+  SUM,
+  AVG,
+  MIN,
+  MAX
+};
+
+/**
+ * One window function. The aggregates range over the rows of the frame,
+ * given in rows before and after the current one (ROWS BETWEEN ... AND ...).
+ * The default frame runs from the first row of the partition to the current
+ * one, which makes running totals.
+ */
+struct WindowTerm {
+  static constexpr size_t UNBOUNDED = std::numeric_limits<size_t>::max();
+
+  WindowTerm(WindowFunctionType function, oid_t column_id = INVALID_OID,
+             size_t preceding = UNBOUNDED, size_t following = 0)
+      : function(function),
+        column_id(column_id),
+        preceding(preceding),
+        following(following) {}
+
+  WindowFunctionType function;
+
+  // argument of the aggregates, INVALID_OID for COUNT(*) and the ranks
+  oid_t column_id;
+
+  size_t preceding;
+  size_t following;
+};
+
+/**
+ * @brief Window function plan node.
+ *
+ * The input must be sorted by the partition columns and then by the order
+ * columns, e.g. by an order by child. The output has the columns of the
+ * input and then one column per window term.
+ */
+class WindowPlan : public AbstractPlan {
+ public:
+  WindowPlan(const std::vector<oid_t> &partition_column_ids,
+             const std::vector<oid_t> &order_column_ids,
+             const std::vector<WindowTerm> &terms)
+      : partition_column_ids_(partition_column_ids),
+        order_column_ids_(order_column_ids),
+        terms_(terms) {}
+
+  const std::vector<oid_t> &GetPartitionColumnIds() const {
+    return partition_column_ids_;
+  }
+
+  const std::vector<oid_t> &GetOrderColumnIds() const {
+    return order_column_ids_;
+  }
+
+  const std::vector<WindowTerm> &GetTerms() const { return terms_; }
+
+  inline PlanNodeType GetPlanNodeType() const { return PlanNodeType::WINDOW; }
+
+  const std::string GetInfo() const { return "Window"; }
+
+  std::unique_ptr<AbstractPlan> Copy() const {
+    return std::unique_ptr<AbstractPlan>(
+        new WindowPlan(partition_column_ids_, order_column_ids_, terms_));
+  }
+
+ private:
+  const std::vector<oid_t> partition_column_ids_;
+
+  // rows with equal values in them rank the same
+  const std::vector<oid_t> order_column_ids_;
+
+  const std::vector<WindowTerm> terms_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(WindowPlan);
+};
+
+}  // namespace planner
+}  // namespace peloton
@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// access_counter_slab.h
+//
+// Identification: src/include/statistics/access_counter_slab.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/platform.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace stats {
+
+/**
+ * The access counters of one table or index, counted by one thread
+ */
+struct AccessCounterSlot {
+  // Set before the slot is marked as in use, and never changed after
+  oid_t database_id = INVALID_OID;
+  oid_t table_id = INVALID_OID;
+  // INVALID_OID for the slot of a table
+  oid_t index_id = INVALID_OID;
+  std::atomic<bool> in_use = ATOMIC_VAR_INIT(false);
+
+  std::atomic<int64_t> reads = ATOMIC_VAR_INIT(0);
+  std::atomic<int64_t> updates = ATOMIC_VAR_INIT(0);
+  std::atomic<int64_t> inserts = ATOMIC_VAR_INIT(0);
+  std::atomic<int64_t> deletes = ATOMIC_VAR_INIT(0);
+};
+
+/**
+ * The access counters of all tables and indexes counted by one thread, by the
+ * dense slot id every table and index gets when it is created.
+ *
+ * Only the thread owning the slab counts, so counting is a plain increment
+ * of a counter no other thread writes. The aggregator reads the counters
+ * while they are counted without taking a lock: a slot is published once
+ * its oids are set, and every counter only grows, so a read sees the count
+ * of some moment since the last read.
+ *
+ * The slots are kept in segments found through a fixed directory, and
+ * segments are added as the ids grow without moving the slots already
+ * there. Segments are padded so that no two slabs share a cache line.
+ */
+class AccessCounterSlab {
+ public:
+  AccessCounterSlab();
+  ~AccessCounterSlab();
+
+  AccessCounterSlab(const AccessCounterSlab &) = delete;
+  AccessCounterSlab &operator=(const AccessCounterSlab &) = delete;
+
+  // The slot of the id, claimed for the oids on its first use. Only called by
+  // the thread owning the slab. Null if the id is past the capacity.
+  inline AccessCounterSlot *GetSlot(const size_t slot_id,
+                                    const oid_t database_id,
+                                    const oid_t table_id,
+                                    const oid_t index_id) {
+    size_t segment_idx = slot_id >> SEGMENT_BITS;
+    if (segment_idx >= DIRECTORY_SIZE) {
+      return nullptr;
+    }
+    Segment *segment = directory_[segment_idx].load(std::memory_order_relaxed);
+    if (segment == nullptr) {
+      segment = AddSegment(segment_idx);
+    }
+    AccessCounterSlot &slot = segment->slots[slot_id & SEGMENT_MASK];
+    if (slot.in_use.load(std::memory_order_relaxed) == false) {
+      slot.database_id = database_id;
+      slot.table_id = table_id;
+      slot.index_id = index_id;
+      slot.in_use.store(true, std::memory_order_release);
+    }
+    return &slot;
+  }
+
+  // Only called by the thread owning the slab, which is the only writer of
+  // the counter, so this compiles to a plain add
+  static inline void Increment(std::atomic<int64_t> &counter,
+                               const int64_t count = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + count,
+                  std::memory_order_relaxed);
+  }
+
+  // Calls the function with every slot in use, while the owner may still be
+  // counting
+  template <typename Function>
+  void ForEachSlot(Function function) const {
+    size_t segment_count = segment_count_.load(std::memory_order_acquire);
+    for (size_t segment_idx = 0; segment_idx < segment_count; segment_idx++) {
+      Segment *segment =
+          directory_[segment_idx].load(std::memory_order_acquire);
+      if (segment == nullptr) {
+        continue;
+      }
+      for (auto &slot : segment->slots) {
+        if (slot.in_use.load(std::memory_order_acquire)) {
+          function(slot);
+        }
+      }
+    }
+  }
+
+  // A new slot id for a table or index. Ids are not reused.
+  static size_t GetNextSlotId();
+
+ private:
+  static constexpr size_t SEGMENT_BITS = 8;
+  static constexpr size_t SEGMENT_SIZE = 1UL << SEGMENT_BITS;
+  static constexpr size_t SEGMENT_MASK = SEGMENT_SIZE - 1;
+  static constexpr size_t DIRECTORY_SIZE = 1UL << 12;
+
+  struct Segment {
+    char front_padding[CACHELINE_SIZE];
+    AccessCounterSlot slots[SEGMENT_SIZE];
+    char back_padding[CACHELINE_SIZE];
+  };
+
+  Segment *AddSegment(const size_t segment_idx);
+
+  std::unique_ptr<std::atomic<Segment *>[]> directory_;
+
+  // One past the highest segment added
+  std::atomic<size_t> segment_count_;
+};
+
+}  // namespace stats
+}  // namespace peloton
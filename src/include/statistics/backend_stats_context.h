@@ -16,15 +16,17 @@
 #include <thread>
 #include <sstream>
 #include <unordered_map>
+#include <vector>
 
 #include "common/platform.h"
+#include "statistics/access_counter_slab.h"
 #include "statistics/table_metric.h"
 #include "statistics/index_metric.h"
 #include "statistics/latency_metric.h"
 #include "statistics/database_metric.h"
 #include "statistics/query_metric.h"
 #include "container/cuckoo_map.h"
-#include "container/lock_free_queue.h"
+#include "container/ring_queue.h"
 
 #define QUERY_METRIC_QUEUE_SIZE 100000
 
@@ -47,7 +49,7 @@ class BackendStatsContext {
  public:
   static BackendStatsContext* GetInstance();
 
-  BackendStatsContext(size_t max_latency_history, bool regiser_to_aggregator);
+  BackendStatsContext(bool regiser_to_aggregator);
   ~BackendStatsContext();
 
   //===--------------------------------------------------------------------===//
@@ -68,7 +70,7 @@ class BackendStatsContext {
                               oid_t index_id);
 
   // Returns the metrics for completed queries
-  LockFreeQueue<std::shared_ptr<QueryMetric>>& GetCompletedQueryMetrics() {
+  SPSCRingQueue<std::shared_ptr<QueryMetric>>& GetCompletedQueryMetrics() {
     return completed_query_metrics_;
   };
 
@@ -78,6 +80,13 @@ class BackendStatsContext {
   // Returns the latency metric
   LatencyMetric& GetTxnLatencyMetric();
 
+  // Returns the latency metric of the commits of txns that wrote
+  LatencyMetric& GetCommitLatencyMetric();
+
+  // Returns the latency metric of the queries of the statement type, the
+  // type being the first word of the query
+  LatencyMetric& GetQueryLatencyMetric(const std::string& query_type_string);
+
   // Increment the read stat for given tile group
   void IncrementTableReads(oid_t tile_group_id);
 
@@ -109,10 +118,28 @@ class BackendStatsContext {
   // Increment the abortion stat for given database
   void IncrementTxnAborted(oid_t database_id);
 
-  // Initialize the query stat
+  // Record the compilation and execution of the ongoing query as compiled code
+  void RecordQueryCodegen(const QueryMetric::CodegenInfo& codegen_info);
+
+  // Initialize the query stat. Only one in FLAGS_stats_query_sample_interval
+  // queries of the thread gets a metric from the start. The others are only
+  // timed, and get a metric when they complete if they were slower than
+  // FLAGS_stats_slow_query_ms.
   void InitQueryMetric(const std::shared_ptr<Statement> statement,
                        const std::shared_ptr<QueryMetric::QueryParams> params);
 
+  // Add the time spent in a phase to the query of the thread. The phases
+  // before it starts count for the query started next.
+  void RecordQueryPhase(const QueryPhase phase, const double latency_ms);
+
+  // Begin the response to a query. The metric of a query completed during
+  // the response is held back until it finishes, so that the results sent
+  // after the query completed count as its SEND phase.
+  void StartQueryTrace();
+
+  // Finish the response, handing over the metric held back
+  void FinishQueryTrace();
+
   //===--------------------------------------------------------------------===//
   // HELPER FUNCTIONS
   //===--------------------------------------------------------------------===//
@@ -126,6 +153,9 @@ class BackendStatsContext {
   // (e.g., sets all counters to zero)
   void Reset();
 
+  // Computes the latency measurements of the interval since the last call
+  void ComputeLatencies();
+
   std::string ToString() const;
 
   // Returns the total number of query aggregated so far
@@ -154,8 +184,10 @@ class BackendStatsContext {
   // Index oid spin lock
   Spinlock index_id_lock;
 
-  // Metrics for completed queries
-  LockFreeQueue<std::shared_ptr<QueryMetric>> completed_query_metrics_{
+  // Metrics for completed queries. Only the thread of the context adds to it
+  // and only the aggregator takes from it. Metrics that do not fit are
+  // dropped.
+  SPSCRingQueue<std::shared_ptr<QueryMetric>> completed_query_metrics_{
       QUERY_METRIC_QUEUE_SIZE};
 
  private:
@@ -166,11 +198,43 @@ class BackendStatsContext {
   // The query metric for the on going metric
   std::shared_ptr<QueryMetric> ongoing_query_metric_ = nullptr;
 
+  // Whether a query is on going
+  bool is_query_ongoing_ = false;
+
+  // The number of queries started by this worker
+  uint64_t started_query_count_ = 0;
+
+  // The on going query if it has no metric, and the time it started
+  std::shared_ptr<Statement> ongoing_statement_;
+  std::shared_ptr<QueryMetric::QueryParams> ongoing_query_params_;
+  LatencyTimer ongoing_query_timer_;
+
+  // The time spent in every phase of the on going query (ms)
+  double query_phase_latencies_[QUERY_PHASE_COUNT] = {};
+
+  // Whether a response is being traced, and whether its query completed
+  bool is_tracing_ = false;
+  bool is_trace_completed_ = false;
+
+  // The metric of the query completed during the response, if it has one
+  std::shared_ptr<QueryMetric> traced_query_metric_ = nullptr;
+
   // The thread ID of this worker
   std::thread::id thread_id_;
 
   // Latencies recorded by this worker
   LatencyMetric txn_latencies_;
+  LatencyMetric commit_latencies_;
+
+  // Query latencies by statement type, the last one of all other types
+  std::vector<std::unique_ptr<LatencyMetric>> query_latencies_;
+
+  // The statement type of the on going query
+  size_t ongoing_query_type_idx_ = 0;
+
+  // The table and index accesses counted by this worker, which are added to
+  // the table and index metrics of the context it is aggregated into
+  AccessCounterSlab access_counters_;
 
   // Whether this context is registered to the global aggregator
   bool is_registered_to_aggregator_;
@@ -185,11 +249,55 @@ class BackendStatsContext {
   // Mark the on going query as completed and move it to completed query queue
   void CompleteQueryMetric();
 
+  void EnqueueCompletedQueryMetric(std::shared_ptr<QueryMetric> query_metric);
+
+  // The statement type the latencies of the query are recorded for
+  static size_t GetQueryLatencyTypeIdx(const std::string& query_type_string);
+
+  // The access counters of the table of the tile group or of the index, null
+  // if they can't be counted
+  AccessCounterSlot* GetTableCounters(oid_t tile_group_id);
+  AccessCounterSlot* GetIndexCounters(index::IndexMetadata* metadata);
+
   // Get the mapping table of backend stat context for each thread
   static CuckooMap<std::thread::id, std::shared_ptr<BackendStatsContext>> &
     GetBackendContextMap(void);
 
 };
 
+/**
+ * Times a phase of the query of the thread, from its construction until it
+ * is stopped or destroyed. Nothing is timed while the stats are off.
+ */
+class QueryPhaseTimer {
+ public:
+  explicit QueryPhaseTimer(const QueryPhase phase);
+
+  ~QueryPhaseTimer() { Stop(); }
+
+  void Stop();
+
+ private:
+  QueryPhase phase_;
+
+  bool is_timing_;
+
+  Timer<std::ratio<1, 1000>> timer_ms_;
+};
+
+/**
+ * Traces the response to a query while in scope, see
+ * BackendStatsContext::StartQueryTrace
+ */
+class QueryTraceScope {
+ public:
+  QueryTraceScope();
+
+  ~QueryTraceScope();
+
+ private:
+  bool is_tracing_;
+};
+
 }  // namespace stats
 }  // namespace peloton
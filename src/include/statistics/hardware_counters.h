@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hardware_counters.h
+//
+// Identification: src/include/statistics/hardware_counters.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace peloton {
+namespace stats {
+
+/**
+ * Values of the hardware counters. Counters that cannot be counted on this
+ * machine stay 0.
+ */
+struct HardwareCounterValues {
+  uint64_t cycles = 0;
+  uint64_t instructions = 0;
+  uint64_t llc_misses = 0;
+  uint64_t branch_misses = 0;
+  uint64_t tlb_misses = 0;
+
+  void Add(const HardwareCounterValues &source);
+
+  // The counts from the earlier values to these
+  HardwareCounterValues GetSince(const HardwareCounterValues &begin) const;
+
+  // Instructions per cycle, 0 if no cycles were counted
+  double GetInstructionsPerCycle() const;
+
+  // Misses per thousand instructions, 0 if none were counted
+  double GetMissesPerKiloInstructions(const uint64_t misses) const;
+
+  const std::string GetInfo() const;
+};
+
+/**
+ * The hardware counters of a thread, counted by perf events
+ *
+ * The counters only count the thread in user space, and are read as one
+ * group with a single system call. They are opened the first time the thread
+ * reads them and closed when it exits. Where perf events are not available
+ * (another OS, a kernel disallowing them, a VM without a PMU) the thread has
+ * no counters.
+ */
+class HardwareCounters {
+ public:
+  ~HardwareCounters();
+
+  HardwareCounters(const HardwareCounters &) = delete;
+  HardwareCounters &operator=(const HardwareCounters &) = delete;
+
+  // The counters of the calling thread, nullptr if it has none
+  static HardwareCounters *GetInstance();
+
+  // Read the current values of the counters, false if they cannot be read
+  bool Read(HardwareCounterValues &values) const;
+
+ private:
+  HardwareCounters();
+
+  static constexpr size_t COUNTER_COUNT = 5;
+
+  // The file descriptors of the counters, the first of which leads the
+  // group. -1 for the ones that could not be opened.
+  int counter_fds_[COUNTER_COUNT];
+
+  // The number of counters opened, which is the number of values read
+  size_t open_count_ = 0;
+
+  // For every value read, the counter it is the value of
+  size_t value_counters_[COUNTER_COUNT];
+};
+
+}  // namespace stats
+}  // namespace peloton
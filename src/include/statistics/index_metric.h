@@ -21,6 +21,11 @@
 #include "statistics/access_metric.h"
 
 namespace peloton {
+
+namespace index {
+struct IndexStructureStats;
+}
+
 namespace stats {
 
 /**
@@ -49,16 +54,48 @@ class IndexMetric : public AbstractMetric {
 
   inline oid_t GetIndexId() { return index_id_; }
 
+  // Counters of the index structure. The aggregator samples them from the
+  // index itself, so they stay 0 in the metrics of the backends
+  inline int64_t GetConsolidations() { return consolidations_; }
+
+  inline int64_t GetSplits() { return splits_; }
+
+  inline int64_t GetMerges() { return merges_; }
+
+  inline int64_t GetCASFailures() { return cas_failures_; }
+
+  inline int64_t GetEpochs() { return epochs_; }
+
+  inline int64_t GetGarbageNodes() { return garbage_nodes_; }
+
+  inline int64_t GetDeltaChainThreshold() { return delta_chain_threshold_; }
+
+  void SetStructureStats(const index::IndexStructureStats &structure_stats);
+
   //===--------------------------------------------------------------------===//
   // HELPER METHODS
   //===--------------------------------------------------------------------===//
 
-  inline void Reset() { index_access_.Reset(); }
+  inline void Reset() {
+    index_access_.Reset();
+    consolidations_ = 0;
+    splits_ = 0;
+    merges_ = 0;
+    cas_failures_ = 0;
+    epochs_ = 0;
+    garbage_nodes_ = 0;
+    delta_chain_threshold_ = 0;
+  }
 
   inline bool operator==(const IndexMetric &other) {
     return database_id_ == other.database_id_ && table_id_ == other.table_id_ &&
            index_id_ == other.index_id_ && index_name_ == other.index_name_ &&
-           index_access_ == other.index_access_;
+           index_access_ == other.index_access_ &&
+           consolidations_ == other.consolidations_ &&
+           splits_ == other.splits_ && merges_ == other.merges_ &&
+           cas_failures_ == other.cas_failures_ && epochs_ == other.epochs_ &&
+           garbage_nodes_ == other.garbage_nodes_ &&
+           delta_chain_threshold_ == other.delta_chain_threshold_;
   }
 
   inline bool operator!=(const IndexMetric &other) { return !(*this == other); }
@@ -70,6 +107,11 @@ class IndexMetric : public AbstractMetric {
     ss << "INDEXES: " << std::endl;
     ss << index_name_ << "(OID=" << index_id_ << "): ";
     ss << index_access_.GetInfo() << std::endl;
+    ss << "[consolidations=" << consolidations_ << ", splits=" << splits_
+       << ", merges=" << merges_ << ", cas_failures=" << cas_failures_
+       << ", epochs=" << epochs_ << ", garbage_nodes=" << garbage_nodes_
+       << ", delta_chain_threshold=" << delta_chain_threshold_ << "]"
+       << std::endl;
     return ss.str();
   }
 
@@ -92,6 +134,19 @@ class IndexMetric : public AbstractMetric {
 
   // Counts the number of index entries accessed
   AccessMetric index_access_{ACCESS_METRIC};
+
+  // Structure modifications installed, and atomic installs retried
+  int64_t consolidations_ = 0;
+  int64_t splits_ = 0;
+  int64_t merges_ = 0;
+  int64_t cas_failures_ = 0;
+
+  // Garbage waiting for memory reclamation
+  int64_t epochs_ = 0;
+  int64_t garbage_nodes_ = 0;
+
+  // Delta chain length at which leaf nodes are consolidated
+  int64_t delta_chain_threshold_ = 0;
 };
 
 }  // namespace stats
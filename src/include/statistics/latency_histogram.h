@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram.h
+//
+// Identification: src/include/statistics/latency_histogram.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace peloton {
+namespace stats {
+
+/**
+ * Counts latencies in log-linear buckets (HDR histogram)
+ *
+ * Latencies are counted in microseconds. The ones below SUB_BUCKET_COUNT
+ * are counted exactly. Above that every power of two is split into
+ * SUB_BUCKET_COUNT / 2 buckets of the same width, so a latency is known
+ * within 1/64 of its value however long it is, at a fixed size of 16 KB.
+ * Latencies past MAX_LATENCY_US are counted as that.
+ *
+ * Histograms are merged by adding up the counts, so the histograms of many
+ * threads sum up to the histogram of all of them, and the histogram of an
+ * interval is the difference of the histograms at its end and start.
+ *
+ * Only one thread records into a histogram, so recording is a plain add.
+ * Unlike logging::LatencyHistogram, other threads may merge it meanwhile,
+ * seeing the count of every bucket at some moment since they last looked.
+ */
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  // Only called by the thread owning the histogram
+  void Record(double latency_ms);
+
+  // Add the counts of the source
+  void Merge(const LatencyHistogram &source);
+
+  // Take away the counts of a histogram this one was merged from earlier
+  void Subtract(const LatencyHistogram &source);
+
+  void Reset();
+
+  uint64_t GetCount() const;
+
+  double GetAverage() const;
+
+  // The sum of the latencies (ms)
+  double GetSum() const;
+
+  // The number of latencies known to be at most the given one, which are
+  // the ones in buckets that count no higher latency
+  uint64_t GetCountAtMost(double latency_ms) const;
+
+  // The latency at the percentile (0 to 100), rounded up to the highest
+  // latency its bucket counts. 0 if there are none.
+  double GetPercentile(double percentile) const;
+
+  double GetMin() const;
+
+  double GetMax() const;
+
+ private:
+  static constexpr uint64_t SUB_BUCKET_BITS = 7;
+  static constexpr uint64_t SUB_BUCKET_COUNT = 1UL << SUB_BUCKET_BITS;
+  static constexpr uint64_t SUB_BUCKET_HALF_COUNT = SUB_BUCKET_COUNT / 2;
+  static constexpr uint64_t MAX_LATENCY_BITS = 36;
+  static constexpr uint64_t MAX_LATENCY_US = (1UL << MAX_LATENCY_BITS) - 1;
+  static constexpr uint64_t BUCKET_COUNT =
+      (MAX_LATENCY_BITS - SUB_BUCKET_BITS + 2) * SUB_BUCKET_HALF_COUNT;
+
+  static size_t GetBucketIdx(uint64_t latency_us);
+
+  // The highest latency counted in the bucket, in microseconds
+  static uint64_t GetBucketLatency(size_t bucket_idx);
+
+  // Only the recording thread writes them
+  std::atomic<uint64_t> bucket_counts_[BUCKET_COUNT];
+  std::atomic<uint64_t> total_count_;
+  std::atomic<uint64_t> total_latency_us_;
+};
+
+}  // namespace stats
+}  // namespace peloton
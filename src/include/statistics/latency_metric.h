@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -19,15 +20,15 @@
 #include "common/macros.h"
 #include "type/types.h"
 #include "common/exception.h"
-#include "container/circular_buffer.h"
 #include "statistics/abstract_metric.h"
-#include <mutex>
+#include "statistics/latency_histogram.h"
 
 namespace peloton {
 namespace stats {
 
 // Container for different latency measurements
 struct LatencyMeasurements {
+  uint64_t count_ = 0;
   double average_ = 0.0;
   double min_ = 0.0;
   double max_ = 0.0;
@@ -35,53 +36,77 @@ struct LatencyMeasurements {
   double perc_25th_ = 0.0;
   double perc_75th_ = 0.0;
   double perc_99th_ = 0.0;
+  double perc_999th_ = 0.0;
 };
 
 /**
- * Metric for storing raw latency values and computing
- * latency measurements.
+ * Timer for measuring one latency at a time
+ */
+class LatencyTimer {
+ public:
+  // Starts the timer for the next latency measurement
+  inline void StartTimer() {
+    timer_ms_.Reset();
+    timer_ms_.Start();
+  }
+
+  // Stops the latency timer and keeps the total time elapsed
+  inline void RecordLatency() {
+    timer_ms_.Stop();
+    latency_ms_ = timer_ms_.GetDuration();
+  }
+
+  // Returns the latency last recorded, 0 if there is none
+  inline double GetLatencyValue() const { return latency_ms_; }
+
+  // Keeps a latency measured by another timer
+  inline void SetLatencyValue(double latency_ms) { latency_ms_ = latency_ms; }
+
+ private:
+  Timer<std::ratio<1, 1000>> timer_ms_;
+
+  double latency_ms_ = 0.0;
+};
+
+/**
+ * Metric for counting latencies in a histogram and computing
+ * latency measurements of every interval.
  */
 class LatencyMetric : public AbstractMetric {
  public:
-  LatencyMetric(MetricType type, size_t max_history);
+  LatencyMetric(MetricType type);
 
   //===--------------------------------------------------------------------===//
   // HELPER METHODS
   //===--------------------------------------------------------------------===//
 
-  inline void Reset() {
-    latencies_.Clear();
-    timer_ms_.Reset();
-  }
+  // Clears the latencies recorded. The latencies measured last are kept, so
+  // that the next measurements are still of the latencies since then.
+  inline void Reset() { latencies_.Reset(); }
 
   // Starts the timer for the next latency measurement
-  inline void StartTimer() {
-    timer_ms_.Reset();
-    timer_ms_.Start();
-  }
+  inline void StartTimer() { timer_.StartTimer(); }
 
   // Stops the latency timer and records the total time elapsed
   inline void RecordLatency() {
-    timer_ms_.Stop();
-    double latency_value = timer_ms_.GetDuration();
-    // Record this latency only if we can do so without blocking.
-    // Occasionally losing single latency measurements is fine.
-    {
-      std::unique_lock<std::mutex> lock(latency_mutex_, std::defer_lock);
-      if (lock.try_lock()) {
-        latencies_.PushBack(latency_value);
-      }
-    }
+    timer_.RecordLatency();
+    latencies_.Record(timer_.GetLatencyValue());
   }
 
-  // Returns the first latency value recorded
-  inline double GetFirstLatencyValue() {
-    PL_ASSERT(latencies_.begin() != latencies_.end());
-    return *(latencies_.begin());
+  // Records a latency measured elsewhere
+  inline void RecordLatency(double latency_ms) {
+    latencies_.Record(latency_ms);
   }
 
-  // Computes the latency measurements using the latencies
-  // collected so far.
+  inline const LatencyHistogram &GetLatencies() const { return latencies_; }
+
+  inline const LatencyMeasurements &GetLatencyMeasurements() const {
+    return latency_measurements_;
+  }
+
+  // Computes the latency measurements of the latencies recorded since the
+  // last call. Only called by the aggregator, which keeps the latencies of
+  // every thread together since they started.
   void ComputeLatencies();
 
   // Combines the source latency metric with this latency metric
@@ -90,30 +115,26 @@ class LatencyMetric : public AbstractMetric {
   // Returns a string representation of this latency metric
   const std::string GetInfo() const;
 
-  // Returns a copy of the latencies collected
-  CircularBuffer<double> Copy();
-
  private:
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
 
-  // Circular buffer with capacity N that stores the <= N
-  // most recent latencies collected
-  CircularBuffer<double> latencies_;
+  // Every latency recorded, only recorded by the thread owning the metric
+  LatencyHistogram latencies_;
 
   // Timer for timing individual latencies
-  Timer<std::ratio<1, 1000>> timer_ms_;
+  LatencyTimer timer_;
 
-  // Stores result of last call to ComputeLatencies()
-  LatencyMeasurements latency_measurements_;
+  // The latencies at the last call to ComputeLatencies(), created by the
+  // first call
+  std::unique_ptr<LatencyHistogram> measured_latencies_;
 
-  // The maximum number of latencies that can be stored
-  // (the capacity size N of the circular buffer)
-  size_t max_history_;
+  // The latencies since the last call to ComputeLatencies()
+  std::unique_ptr<LatencyHistogram> interval_latencies_;
 
-  // Protects accesses to the circular buffer
-  std::mutex latency_mutex_;
+  // Stores result of last call to ComputeLatencies()
+  LatencyMeasurements latency_measurements_;
 };
 
 }  // namespace stats
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_usage.h
+//
+// Identification: src/include/statistics/memory_usage.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/memory_tracker.h"
+
+namespace peloton {
+
+namespace storage {
+class Database;
+class DataTable;
+}  // namespace storage
+
+namespace stats {
+
+/**
+ * The bytes used by every component, and the tuples they hold
+ *
+ * The tracked components come from the MemoryTracker, which counts them for
+ * the whole process. The indexes and the versions awaiting GC are computed
+ * from the tables added. The versions live in the tiles and their headers,
+ * so they are not part of the total.
+ */
+struct MemoryUsage {
+  MemoryUsage();
+
+  // The components charged to the MemoryTracker
+  static MemoryUsage GetTracked();
+
+  // The tracked components, with the tables of every database
+  static MemoryUsage Collect();
+
+  // Add the indexes, the versions awaiting GC and the tuples of the table
+  void AddTable(storage::DataTable *table);
+
+  void AddDatabase(storage::Database *database);
+
+  size_t GetBytes(const MemoryComponentType type) const {
+    return bytes[static_cast<size_t>(type)];
+  }
+
+  // The bytes of all components but the versions awaiting GC
+  size_t GetTotalBytes() const;
+
+  size_t bytes[MEMORY_COMPONENT_TYPE_COUNT];
+
+  size_t tuple_count;
+};
+
+}  // namespace stats
+}  // namespace peloton
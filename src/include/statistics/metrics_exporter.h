@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// metrics_exporter.h
+//
+// Identification: src/include/statistics/metrics_exporter.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct event_base;
+struct evhttp;
+struct evhttp_request;
+
+namespace peloton {
+namespace stats {
+
+class LatencyHistogram;
+
+// The labels of a sample, as name and value
+typedef std::vector<std::pair<std::string, std::string>> MetricLabels;
+
+//===--------------------------------------------------------------------===//
+// Metrics Text
+//===--------------------------------------------------------------------===//
+
+/**
+ * Writes metrics in the Prometheus text exposition format (version 0.0.4)
+ *
+ * Every family of samples begins with AddFamily, followed by its samples.
+ * Latencies are written as histograms in seconds, cumulative over the
+ * buckets of HISTOGRAM_BUCKETS_S.
+ */
+class MetricsText {
+ public:
+  // The upper bounds of the histogram buckets (s), besides +Inf
+  static const std::vector<double> HISTOGRAM_BUCKETS_S;
+
+  // Begin a family of the type (counter, gauge or histogram)
+  void AddFamily(const std::string &name, const std::string &type,
+                 const std::string &help);
+
+  void AddSample(const std::string &name, const MetricLabels &labels,
+                 const double value);
+
+  void AddHistogram(const std::string &name, const MetricLabels &labels,
+                    const LatencyHistogram &latencies);
+
+  inline const std::string &GetText() const { return text_; }
+
+ private:
+  void AddSample(const std::string &name, const MetricLabels &labels,
+                 const std::string &value);
+
+  std::string text_;
+};
+
+//===--------------------------------------------------------------------===//
+// Metrics Exporter
+//===--------------------------------------------------------------------===//
+
+/**
+ * Serves the metrics at /metrics over HTTP, from a thread of its own
+ *
+ * The stats aggregator renders the metrics once per aggregation and
+ * publishes the text. A scrape only takes a reference to the text last
+ * published, so it never waits for the aggregator nor the workers.
+ */
+class MetricsExporter {
+ public:
+  MetricsExporter(const MetricsExporter &) = delete;
+  MetricsExporter &operator=(const MetricsExporter &) = delete;
+  MetricsExporter(MetricsExporter &&) = delete;
+  MetricsExporter &operator=(MetricsExporter &&) = delete;
+
+  MetricsExporter();
+
+  ~MetricsExporter();
+
+  // Singleton
+  static MetricsExporter &GetInstance();
+
+  // Start serving on the port. Returns false if it cannot be bound.
+  bool Start(const int port);
+
+  // Stop serving
+  void Stop();
+
+  inline bool IsRunning() const { return is_running_.load(); }
+
+  // Replace the metrics served
+  void Publish(std::shared_ptr<const std::string> metrics);
+
+  // The metrics last published
+  std::shared_ptr<const std::string> GetMetrics() const;
+
+ private:
+  // Server loop
+  void Serve();
+
+  static void HandleRequest(struct evhttp_request *request, void *arg);
+
+  // Leaves the server loop once stopping
+  static void CheckStop(int fd, short event_flags, void *arg);
+
+  std::shared_ptr<const std::string> metrics_;
+
+  // Whether a server thread is running
+  std::atomic<bool> is_running_;
+
+  // Stop signal
+  std::atomic<bool> exporter_stop_;
+
+  struct event_base *event_base_ = nullptr;
+
+  struct evhttp *http_ = nullptr;
+
+  // Server thread
+  std::thread exporter_thread_;
+
+  //===--------------------------------------------------------------------===//
+  // Exporter Parameters
+  //===--------------------------------------------------------------------===//
+
+  // How often the server loop checks the stop signal (in ms)
+  int stop_check_interval_ms_ = 100;
+};
+
+}  // namespace stats
+}  // namespace peloton
@@ -22,12 +22,14 @@
 #include <sys/resource.h>
 #include "statistics/abstract_metric.h"
 #include "statistics/access_metric.h"
+#include "statistics/hardware_counters.h"
 
 namespace peloton {
 namespace stats {
 
 /**
- * Metric for storing raw processor execution time values.
+ * Metric for storing raw processor execution time values, and the hardware
+ * counters of the execution if they are counted.
  */
 class ProcessorMetric : public AbstractMetric {
  public:
@@ -39,6 +41,7 @@ class ProcessorMetric : public AbstractMetric {
     user_time_end_ = 0;
     sys_time_begin_ = 0;
     sys_time_end_ = 0;
+    has_hardware_counters_ = false;
   }
 
   // Starts the timer
@@ -59,6 +62,14 @@ class ProcessorMetric : public AbstractMetric {
     return sys_time_end_ - sys_time_begin_;
   }
 
+  // Whether the hardware counters of the execution were counted
+  inline bool HasHardwareCounters() const { return has_hardware_counters_; }
+
+  // Get the hardware counters of the execution
+  inline HardwareCounterValues GetHardwareCounters() const {
+    return hardware_counters_end_.GetSince(hardware_counters_begin_);
+  }
+
   // Returns a string representation of this latency metric
   const std::string GetInfo() const;
 
@@ -91,6 +102,14 @@ class ProcessorMetric : public AbstractMetric {
 
   // End CPU time (ms) for system execution
   double sys_time_end_ = 0;
+
+  // Hardware counters at the begin and end of the execution, which are
+  // only counted if the thread has them when the timer starts, and the
+  // timer is stopped by the same thread
+  bool has_hardware_counters_ = false;
+  const HardwareCounters *started_hardware_counters_ = nullptr;
+  HardwareCounterValues hardware_counters_begin_;
+  HardwareCounterValues hardware_counters_end_;
 };
 
 }  // namespace stats
@@ -28,6 +28,20 @@ namespace stats {
 // Same type defined in wire/marshal.h
 typedef unsigned char uchar;
 
+// The phases of a query, in the order they run
+enum class QueryPhase : uint32_t {
+  PARSE = 0,     // parsing the query and taking out its literals
+  BIND = 1,      // binding the parameters to the plan
+  OPTIMIZE = 2,  // building the plan
+  COMPILE = 3,   // compiling the plan, if it runs as compiled code
+  EXECUTE = 4,   // running the plan, not counting its compilation
+  SEND = 5       // packing the results into the response
+};
+
+static const size_t QUERY_PHASE_COUNT = 6;
+
+std::string QueryPhaseToString(QueryPhase phase);
+
 /**
  * Metric for the access of a query
  */
@@ -62,6 +76,21 @@ class QueryMetric : public AbstractMetric {
     int num_params = 0;
   };
 
+  // The compilation and execution of a query run as compiled code
+  struct CodegenInfo {
+    // Whether the query ran as compiled code
+    bool compiled = false;
+
+    // The time taken to compile the query, 0 if it was found compiled
+    double compile_ms = 0.0;
+
+    // The time taken to run the compiled code
+    double execute_ms = 0.0;
+
+    // The number of IR instructions of the compiled code
+    uint64_t num_instructions = 0;
+  };
+
   QueryMetric(MetricType type, const std::string &query_name,
               std::shared_ptr<QueryParams> query_params,
               const oid_t database_id);
@@ -72,10 +101,22 @@ class QueryMetric : public AbstractMetric {
 
   inline AccessMetric &GetQueryAccess() { return query_access_; }
 
-  inline LatencyMetric &GetQueryLatency() { return latency_metric_; }
+  inline LatencyTimer &GetQueryLatency() { return latency_timer_; }
 
   inline ProcessorMetric &GetProcessorMetric() { return processor_metric_; }
 
+  inline CodegenInfo &GetCodegenInfo() { return codegen_info_; }
+
+  // The time spent in the phase (ms)
+  inline double GetPhaseLatency(const QueryPhase phase) const {
+    return phase_latencies_[static_cast<size_t>(phase)];
+  }
+
+  inline void AddPhaseLatency(const QueryPhase phase,
+                              const double latency_ms) {
+    phase_latencies_[static_cast<size_t>(phase)] += latency_ms;
+  }
+
   inline std::string GetName() const { return query_name_; }
 
   inline oid_t GetDatabaseId() const { return database_id_; }
@@ -92,12 +133,21 @@ class QueryMetric : public AbstractMetric {
 
   void Aggregate(AbstractMetric &source);
 
+  // The latency and the time spent in every phase
+  const std::string GetPhaseInfo() const;
+
   inline const std::string GetInfo() const {
     std::stringstream ss;
     ss << "-----------------------------" << std::endl;
     ss << "  QUERY " << query_name_ << std::endl;
     ss << "-----------------------------" << std::endl;
     ss << query_access_.GetInfo() << std::endl;
+    ss << GetPhaseInfo() << std::endl;
+    if (codegen_info_.compiled) {
+      ss << "[compiled] compile_ms=" << codegen_info_.compile_ms
+         << ", execute_ms=" << codegen_info_.execute_ms
+         << ", instructions=" << codegen_info_.num_instructions << std::endl;
+    }
     return ss.str();
   }
 
@@ -118,11 +168,17 @@ class QueryMetric : public AbstractMetric {
   // The number of tuple accesses
   AccessMetric query_access_{ACCESS_METRIC};
 
-  // Latency metric
-  LatencyMetric latency_metric_{LATENCY_METRIC, 2};
+  // Latency of this query, recorded when it completes
+  LatencyTimer latency_timer_;
 
   // Processor metric
   ProcessorMetric processor_metric_{PROCESSOR_METRIC};
+
+  // Compilation and execution of the compiled code, if the query was compiled
+  CodegenInfo codegen_info_;
+
+  // The time spent in every phase (ms)
+  double phase_latencies_[QUERY_PHASE_COUNT] = {};
 };
 
 }  // namespace stats
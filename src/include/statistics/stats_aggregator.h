@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <map>
 #include <vector>
@@ -19,6 +20,7 @@
 #include <condition_variable>
 #include <string>
 #include <fstream>
+#include <random>
 
 #include "common/logger.h"
 #include "common/macros.h"
@@ -33,8 +35,8 @@
 
 #define STATS_AGGREGATION_INTERVAL_MS 1000
 #define STATS_LOG_INTERVALS 10
-#define LATENCY_MAX_HISTORY_THREAD 100
-#define LATENCY_MAX_HISTORY_AGGREGATOR 10000
+#define STATS_MAX_QUERY_SHAPES 1000
+#define STATS_MAX_SLOW_QUERIES 100
 
 class BackendStatsContext;
 
@@ -77,6 +79,16 @@ class StatsAggregator {
   // Get the current aggregated stats of all threads (including history)
   inline BackendStatsContext &GetAggregatedStats() { return aggregated_stats_; }
 
+  // The number of completed queries that ran as compiled code, and the total
+  // time spent compiling and running them
+  inline uint64_t GetCompiledQueryCount() const {
+    return compiled_query_count_;
+  }
+  inline double GetTotalCompileTime() const { return total_compile_ms_; }
+  inline double GetTotalCompiledExecutionTime() const {
+    return total_compiled_execute_ms_;
+  }
+
   //===--------------------------------------------------------------------===//
   // HELPER FUNCTIONS
   //===--------------------------------------------------------------------===//
@@ -113,17 +125,27 @@ class StatsAggregator {
   // Stores all aggregated stats
   BackendStatsContext aggregated_stats_;
 
-  // Protect register and unregister of BackendStatsContext*
-  std::mutex stats_mutex_{};
+  // A registered BackendStatsContext. Contexts are only added to the front
+  // of the list, and the ones unregistered are skipped but kept.
+  struct RegisteredContext {
+    std::thread::id thread_id;
+    BackendStatsContext *context;
+    bool is_unregistered;
+    RegisteredContext *next;
+  };
+
+  // Registering a context takes no lock, so new threads don't wait for an
+  // aggregation to finish
+  std::atomic<RegisteredContext *> registered_contexts_{nullptr};
 
-  // Map the thread id to the pointer of its BackendStatsContext
-  std::unordered_map<std::thread::id, BackendStatsContext *> backend_stats_{};
+  // Protect unregister of BackendStatsContext* against aggregation
+  std::mutex stats_mutex_{};
 
   // How often to aggregate all worker thread stats
   int64_t aggregation_interval_ms_;
 
   // Number of threads registered
-  int thread_number_;
+  std::atomic<int> thread_number_;
 
   int64_t total_prev_txn_committed_;
 
@@ -142,28 +164,82 @@ class StatsAggregator {
   // Whether the aggregator is running
   bool is_aggregating_ = false;
 
+  // Totals over the completed queries that ran as compiled code
+  uint64_t compiled_query_count_ = 0;
+  double total_compile_ms_ = 0.0;
+  double total_compiled_execute_ms_ = 0.0;
+
+  // The hardware counters of the queries completed since the stats log was
+  // last written, by the query string. Queries that only differ in their
+  // literals share the string of their cached plan, so this sums them up by
+  // the shape of the statement. At most STATS_MAX_QUERY_SHAPES are kept.
+  struct QueryShapeCounters {
+    uint64_t query_count = 0;
+    HardwareCounterValues counters;
+  };
+  std::unordered_map<std::string, QueryShapeCounters> query_shape_counters_;
+
+  // The latency and phases of the slow queries completed since the stats
+  // log was last written, at most STATS_MAX_SLOW_QUERIES of them
+  std::vector<std::string> slow_query_traces_;
+
   // Abstract Pool to hold query strings
   std::unique_ptr<type::AbstractPool> pool_;
 
+  // A uniform sample of the queries completed since the metrics tables were
+  // last written, and the number of them
+  std::vector<std::shared_ptr<QueryMetric>> sampled_query_metrics_;
+  uint64_t completed_query_count_ = 0;
+  std::mt19937_64 random_generator_;
+
+  // The counters last written to the metrics tables, by the oid of the
+  // database, table or index. Metrics that did not change are not written
+  // again.
+  std::unordered_map<oid_t, std::vector<int64_t>> written_counters_;
+
   //===--------------------------------------------------------------------===//
   // HELPER FUNCTIONS
   //===--------------------------------------------------------------------===//
 
-  // Write all metrics to metric tables
+  typedef std::vector<std::pair<oid_t, std::vector<int64_t>>> CounterList;
+
+  // Write the waits of all threads by what they waited for, and the aborts
+  // by table and conflict, to the stats log
+  void LogWaitEvents();
+
+  // Render the aggregated stats, the waits and aborts, and the state of the
+  // storage, GC and connections for the metrics exporter to serve
+  void PublishMetrics(double throughput);
+
+  // Write the metrics that changed since the last write, and the sampled
+  // query metrics, to metric tables. Whatever fails to be written is tried
+  // again on the next write.
   void UpdateMetrics();
 
   // Update the table metrics with a given database
   void UpdateTableMetrics(storage::Database *database, int64_t time_stamp,
+                          CounterList &written_counters,
                           concurrency::Transaction *txn);
 
   // Update the index metrics with a given table
   void UpdateIndexMetrics(storage::Database *database,
                           storage::DataTable *table, int64_t time_stamp,
+                          CounterList &written_counters,
                           concurrency::Transaction *txn);
 
-  // Write all query metrics to a metric table
+  // Append the sampled query metrics to a metric table in bulk, and delete
+  // the ones past retention
   void UpdateQueryMetrics(int64_t time_stamp, concurrency::Transaction *txn);
 
+  // Take the completed queries out of the aggregated stats, sampling the ones
+  // to write
+  void SampleQueryMetrics();
+
+  // Whether the counters of the oid differ from the ones last written, in
+  // which case they are added to the list being written
+  bool AddChangedCounters(oid_t oid, std::vector<int64_t> counters,
+                          CounterList &written_counters) const;
+
   // Aggregate stats periodically
   void RunAggregator();
 };
@@ -22,6 +22,7 @@
 #include "common/item_pointer.h"
 #include "common/printable.h"
 #include "type/types.h"
+#include "util/numa_util.h"
 
 //===--------------------------------------------------------------------===//
 // GUC Variables
@@ -94,6 +95,9 @@ class AbstractTable : public Printable {
 
   oid_t GetOid() const { return table_oid; }
 
+  // Where the threads count the accesses to the table
+  size_t GetStatsSlotId() const { return stats_slot_id_; }
+
   void SetSchema(catalog::Schema *given_schema) { schema = given_schema; }
 
   catalog::Schema *GetSchema() const { return (schema); }
@@ -132,7 +136,8 @@ class AbstractTable : public Printable {
 
   TileGroup *GetTileGroupWithLayout(oid_t database_id, oid_t tile_group_id,
                                     const column_map_type &partitioning,
-                                    const size_t num_tuples);
+                                    const size_t num_tuples,
+                                    const int numa_node = INVALID_NUMA_NODE);
 
   column_map_type GetTileGroupLayout(LayoutType layout_type) const;
 
@@ -152,6 +157,9 @@ class AbstractTable : public Printable {
    * where the scheme may live longer.
    */
   bool own_schema_;
+
+  // Dense id of the access counters of the table
+  const size_t stats_slot_id_;
 };
 
 }  // End storage namespace
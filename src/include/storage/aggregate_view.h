@@ -0,0 +1,305 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregate_view.h
+//
+// Identification: src/include/storage/aggregate_view.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+class AbstractTuple;
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+
+class AbstractTable;
+class DataTable;
+
+//===--------------------------------------------------------------------===//
+// Aggregate View
+//===--------------------------------------------------------------------===//
+
+/**
+ * Materialized GROUP BY over a table, maintained from the changes of the
+ * committing transactions.
+ *
+ * Every group holds its number of rows and, for every aggregated column, the
+ * number of values that are not null and their sum. COUNT(*), COUNT, SUM and
+ * AVG over those columns are derived from them. MIN and MAX can not be
+ * maintained through deletes and are not supported.
+ *
+ * The groups are a base as of the base commit id plus the deltas of the
+ * transactions that committed later, tagged with their commit id. A reader
+ * adds the deltas up to its read id to the base, so the result is what its
+ * own scan of the table would have aggregated. Deltas no transaction can
+ * precede anymore are folded into the base.
+ */
+class AggregateView {
+ public:
+  // The totals of one group
+  struct GroupState {
+    int64_t row_count = 0;
+
+    // Values that are not null, per aggregated column
+    std::vector<int64_t> value_counts;
+
+    // BIGINT for the integer columns, DECIMAL for the others
+    std::vector<type::Value> sums;
+  };
+
+  struct ValueVectorHasher {
+    size_t operator()(const std::vector<type::Value> &values) const {
+      size_t seed = 0;
+      for (auto &value : values) {
+        value.HashCombine(seed);
+      }
+      return seed;
+    }
+  };
+
+  struct ValueVectorCmp {
+    bool operator()(const std::vector<type::Value> &lhs,
+                    const std::vector<type::Value> &rhs) const {
+      if (lhs.size() != rhs.size()) {
+        return false;
+      }
+      for (size_t i = 0; i < lhs.size(); i++) {
+        if (lhs[i].CompareNotEquals(rhs[i]) == type::CMP_TRUE) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+
+  // Group key values to totals
+  typedef std::unordered_map<std::vector<type::Value>, GroupState,
+                             ValueVectorHasher, ValueVectorCmp> GroupMap;
+
+  AggregateView(const std::string &name, DataTable *table,
+                const std::vector<oid_t> &group_column_ids,
+                const std::vector<oid_t> &aggregate_column_ids);
+
+  const std::string &GetName() const { return name; }
+
+  DataTable *GetTable() const { return table; }
+
+  const std::vector<oid_t> &GetGroupColumnIds() const {
+    return group_column_ids;
+  }
+
+  const std::vector<oid_t> &GetAggregateColumnIds() const {
+    return aggregate_column_ids;
+  }
+
+  // Offset of the column among the group or the aggregated columns, or
+  // INVALID_OID
+  oid_t GetGroupOffset(const oid_t column_id) const;
+
+  oid_t GetAggregateOffset(const oid_t column_id) const;
+
+  // Add the tuple of the table to the groups, or remove it if sign is -1
+  void AddTuple(GroupMap &groups, const AbstractTuple *tuple,
+                const int sign) const;
+
+  // Record the changes of a transaction that commits with the commit id
+  void AddDelta(const cid_t commit_id, GroupMap &&delta);
+
+  // Start answering from the groups of the build, which hold the versions
+  // up to the commit id. Deltas up to it are in the groups already.
+  void SetBase(const cid_t commit_id, GroupMap &&groups);
+
+  // Fold the deltas up to the expired commit id into the base. Returns the
+  // number of deltas folded.
+  size_t FoldDeltas(const cid_t expired_cid);
+
+  // The groups as the transaction sees them. Returns false if the view can
+  // not answer for it: the view is not built, was invalidated, the read id
+  // precedes the base, or the transaction changed the table itself.
+  bool GetGroups(concurrency::Transaction *txn, GroupMap &groups);
+
+  // The table was changed in a way that can not be maintained
+  void Invalidate() { is_valid = false; }
+
+  bool IsReady() const { return is_ready; }
+
+  bool IsValid() const { return is_valid; }
+
+  size_t GetDeltaCount();
+
+  // Add the totals of the delta to the groups, dropping empty groups
+  static void MergeGroups(GroupMap &groups, const GroupMap &delta);
+
+ private:
+  struct Delta {
+    cid_t commit_id;
+
+    GroupMap groups;
+  };
+
+  std::string name;
+
+  DataTable *table;
+
+  std::vector<oid_t> group_column_ids;
+
+  std::vector<oid_t> aggregate_column_ids;
+
+  // Whether every aggregated column is summed as BIGINT
+  std::vector<bool> is_integer_column;
+
+  // Groups of the versions up to the base commit id
+  GroupMap base_groups;
+
+  cid_t base_cid = 0;
+
+  std::vector<Delta> deltas;
+
+  std::mutex view_mutex;
+
+  std::atomic<bool> is_ready;
+
+  std::atomic<bool> is_valid;
+};
+
+//===--------------------------------------------------------------------===//
+// Aggregate View Manager
+//===--------------------------------------------------------------------===//
+
+/**
+ * Holds the aggregate views, captures the changes of the committing
+ * transactions for them, and builds new views in the background.
+ *
+ * The transaction manager hands every committing transaction to
+ * RecordCommit() before it installs the versions. Inserted versions are
+ * added to the groups, deleted ones removed, and an update removes the old
+ * version and adds the new one. Bulk loaded tile groups are added as a
+ * whole. Updates made in place leave no old version behind and invalidate
+ * the views of the table.
+ *
+ * A new view captures deltas right away. Its build waits for the epoch to
+ * advance, starts a transaction, and waits until the transactions of the
+ * earlier epochs have ended. Every version up to that epoch is committed
+ * then, so the scan of the table holds the commits the captured deltas
+ * missed and the deltas up to the epoch are dropped. The views are kept in
+ * memory only and have to be created again after a restart.
+ */
+class AggregateViewManager {
+ public:
+  AggregateViewManager(const AggregateViewManager &) = delete;
+  AggregateViewManager &operator=(const AggregateViewManager &) = delete;
+  AggregateViewManager(AggregateViewManager &&) = delete;
+  AggregateViewManager &operator=(AggregateViewManager &&) = delete;
+
+  AggregateViewManager();
+
+  ~AggregateViewManager();
+
+  // Singleton
+  static AggregateViewManager &GetInstance();
+
+  // Create a view aggregating the columns by the group columns, and build
+  // it in the background. Returns false if the name is taken.
+  bool CreateView(const std::string &name, DataTable *table,
+                  const std::vector<oid_t> &group_column_ids,
+                  const std::vector<oid_t> &aggregate_column_ids);
+
+  // Returns false if there is no view with the name
+  bool DropView(const std::string &name);
+
+  std::shared_ptr<AggregateView> GetView(const std::string &name);
+
+  // A built view of the table grouped by exactly the group columns that
+  // aggregates all the columns, or nullptr
+  std::shared_ptr<AggregateView> FindView(
+      DataTable *table, const std::vector<oid_t> &group_column_ids,
+      const std::vector<oid_t> &aggregate_column_ids);
+
+  // Capture the changes of a transaction that is about to install its
+  // versions
+  void RecordCommit(concurrency::Transaction *txn);
+
+  // Wait for all builds to finish
+  void WaitForAll();
+
+  // Drop the views of a table that is dropped
+  void DropTable(DataTable *table);
+
+  // Abandon all builds, and wait for them
+  void StopAll();
+
+  size_t GetViewCount() const { return view_count; }
+
+  // Scan the versions of the table that exist as of the commit id into
+  // groups
+  static void ScanTable(const AggregateView *view, const cid_t commit_id,
+                        AggregateView::GroupMap &groups);
+
+ private:
+  struct ViewBuild {
+    std::shared_ptr<AggregateView> view;
+
+    // Transactions of this epoch may commit without the view
+    eid_t barrier_eid;
+
+    std::atomic<bool> stop;
+    std::atomic<bool> done;
+
+    std::thread build_thread;
+  };
+
+  // Build loop of one view
+  void Build(ViewBuild *build);
+
+  // Join and release the builds of the view, or of all views if null
+  void JoinBuilds(const AggregateView *view, bool stop);
+
+  // The views of the table, copied so no lock is held while they are used
+  std::vector<std::shared_ptr<AggregateView>> GetTableViews(
+      const AbstractTable *table);
+
+  std::unordered_map<std::string, std::shared_ptr<AggregateView>> views;
+
+  std::unordered_map<const AbstractTable *,
+                     std::vector<std::shared_ptr<AggregateView>>> table_views;
+
+  std::mutex manager_mutex;
+
+  // Commits skip the capture while there is no view
+  std::atomic<size_t> view_count;
+
+  std::vector<std::unique_ptr<ViewBuild>> builds;
+
+  std::mutex builder_mutex;
+
+  //===--------------------------------------------------------------------===//
+  // Manager Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Sleeping period while waiting for the epochs (in ms)
+  oid_t sleep_duration = 10;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
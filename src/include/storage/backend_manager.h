@@ -12,7 +12,11 @@
 
 #pragma once
 
+#include <map>
 #include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "common/platform.h"
 #include "type/types.h"
@@ -31,6 +35,18 @@ namespace storage {
 
 #define TMP_DIR "/tmp/"
 
+//===--------------------------------------------------------------------===//
+// Huge pages
+//===--------------------------------------------------------------------===//
+
+#define HUGE_PAGE_SIZE (UINT64_C(2) * 1024 * 1024)  // 2 MB
+
+// small allocations are carved out of arenas of this size
+#define HUGE_PAGE_ARENA_SIZE (16 * HUGE_PAGE_SIZE)  // 32 MB
+
+// allocations at least this large get their own mapping
+#define HUGE_PAGE_DIRECT_SIZE (HUGE_PAGE_SIZE / 4)
+
 //===--------------------------------------------------------------------===//
 // Storage Manager
 //===--------------------------------------------------------------------===//
@@ -48,6 +64,23 @@ class BackendManager {
 
   void Release(BackendType type, void *address);
 
+  // Allocate page-aligned memory whose pages are placed on the given NUMA
+  // node (best effort). It must be released with ReleaseOnNode().
+  void *AllocateOnNode(size_t size, int numa_node);
+
+  void ReleaseOnNode(void *address, size_t size);
+
+  // Allocate memory backed by huge pages, placed on the given NUMA node (best
+  // effort). Explicit huge pages are used when the kernel has them reserved,
+  // otherwise the mapping is advised for transparent huge pages. Small blocks
+  // share arenas and are recycled by size when released.
+  // It must be released with ReleaseHugePages() using the same size and node.
+  void *AllocateHugePages(size_t size, int numa_node);
+
+  void ReleaseHugePages(void *address, size_t size, int numa_node);
+
+  size_t GetHugePageMappingCount() const { return huge_page_mapping_count; }
+
   void Sync(BackendType type, void *address, size_t length);
 
   size_t GetMsyncCount() const { return msync_count; }
@@ -75,6 +108,24 @@ class BackendManager {
   size_t clflush_count = 0;
 
   size_t allocation_count = 0;
+
+  // huge pages
+  void *MapHugePages(size_t size, int numa_node);
+
+  struct HugePageArena {
+    char *next = nullptr;
+    size_t remaining = 0;
+  };
+
+  // numa node -> current arena
+  std::unordered_map<int, HugePageArena> huge_page_arenas;
+
+  // (numa node, size) -> released blocks
+  std::map<std::pair<int, size_t>, std::vector<void *>> huge_page_free_blocks;
+
+  Spinlock huge_page_spinlock;
+
+  size_t huge_page_mapping_count = 0;
 };
 
 }  // End storage namespace
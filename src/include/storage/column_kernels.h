@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// column_kernels.h
+//
+// Identification: src/include/storage/column_kernels.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+class Tile;
+
+//===----------------------------------------------------------------------===//
+// A fixed-width column of a tile: the value of tuple i is stride * i bytes
+// after data
+//===----------------------------------------------------------------------===//
+struct TileColumn {
+  TileColumn(const Tile *tile, oid_t column_id);
+
+  const char *data;
+  size_t stride;
+  type::TypeId type_id;
+
+  // The number of tuple slots of the tile
+  oid_t tuple_count;
+};
+
+//===----------------------------------------------------------------------===//
+// The aggregates of the values of a column for some of its tuples
+//===----------------------------------------------------------------------===//
+struct ColumnAggregate {
+  // The number of tuples and of non-NULL values
+  uint64_t row_count = 0;
+  uint64_t count = 0;
+
+  // Of the type of the column, NULL if there are no values. The sum of
+  // integers is out of range if it does not fit their type.
+  type::Value sum;
+  type::Value min;
+  type::Value max;
+};
+
+//===----------------------------------------------------------------------===//
+// Kernels that read fixed-width numeric columns straight out of the memory of
+// a tile, for the tuples of a list of tuple ids. They compare and aggregate
+// the native values like the Values of them would. With AVX2 the values of
+// 32 and 64 bit integer columns are gathered and compared several at once.
+//===----------------------------------------------------------------------===//
+class ColumnKernels {
+ public:
+  // Whether columns of the type are supported: TINYINT, SMALLINT, INTEGER,
+  // BIGINT and DECIMAL
+  static bool IsSupported(type::TypeId type_id);
+
+  // Compare the value of every tuple with a numeric constant, which is on the
+  // right side. results[i] is the result for tuple_ids[i].
+  static void Compare(const TileColumn &column, ExpressionType compare_type,
+                      const type::Value &constant, const oid_t *tuple_ids,
+                      size_t count, type::CmpBool *results);
+
+  // Select the tuple ids of the tuples whose value compares true with the
+  // constant into selection, which has room for count of them. Returns the
+  // number selected.
+  static size_t Filter(const TileColumn &column, ExpressionType compare_type,
+                       const type::Value &constant, const oid_t *tuple_ids,
+                       size_t count, oid_t *selection);
+
+  // Add the values of the tuples to the aggregate
+  static void Aggregate(const TileColumn &column, const oid_t *tuple_ids,
+                        size_t count, ColumnAggregate &aggregate);
+};
+
+}  // namespace storage
+}  // namespace peloton
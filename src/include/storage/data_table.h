@@ -12,15 +12,19 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <queue>
 #include <set>
+#include <vector>
 
 #include "common/item_pointer.h"
 #include "common/platform.h"
 #include "container/lock_free_array.h"
+#include "container/lock_free_queue.h"
 #include "index/index.h"
 #include "storage/abstract_table.h"
 #include "storage/indirection_array.h"
@@ -58,6 +62,8 @@ namespace storage {
 class Tuple;
 class TileGroup;
 class IndirectionArray;
+class ForeignKeyCache;
+class PartitionedTable;
 
 //===--------------------------------------------------------------------===//
 // DataTable
@@ -107,20 +113,44 @@ class DataTable : public AbstractTable {
 
   // install an version in table. designed for update operation.
   // as we implement logical-pointer indexing mechanism, targets_ptr is
-  // required.
+  // required. the indexes are left alone if the update changes none of
+  // their columns, which is only known of the targets if the version it
+  // replaces is given.
   bool InstallVersion(const AbstractTuple *tuple, const TargetList *targets_ptr,
                       concurrency::Transaction *transaction,
-                      ItemPointer *index_entry_ptr);
+                      ItemPointer *index_entry_ptr,
+                      const AbstractTuple *old_tuple = nullptr);
 
   // insert tuple in table. the pointer to the index entry is returned as
   // index_entry_ptr.
   ItemPointer InsertTuple(const Tuple *tuple,
                           concurrency::Transaction *transaction,
                           ItemPointer **index_entry_ptr = nullptr);
+  // insert tuple in table, skipping the foreign key checks of the referenced
+  // keys the statement already found in the cache.
+  ItemPointer InsertTuple(const Tuple *tuple,
+                          concurrency::Transaction *transaction,
+                          ItemPointer **index_entry_ptr,
+                          ForeignKeyCache *foreign_key_cache);
   // designed for tables without primary key. e.g., output table used by
   // aggregate_executor.
   ItemPointer InsertTuple(const Tuple *tuple);
 
+  // bulk load tuples into new, fully packed tile groups that are never made
+  // active. the whole batch is owned by the transaction and stamped with its
+  // commit id in one pass per tile group, and index entries are inserted in
+  // key order. returns false if a constraint is violated, in which case the
+  // transaction must abort.
+  bool BulkInsert(const std::vector<std::unique_ptr<Tuple>> &tuples,
+                  concurrency::Transaction *transaction);
+
+  // check the foreign keys of all the tuples, probing every distinct
+  // referenced key that is not in the cache once, in one batch per foreign
+  // key. the keys that were found are added to the cache. returns false if
+  // any key is missing.
+  bool CheckForeignKeyConstraints(const std::vector<const Tuple *> &tuples,
+                                  ForeignKeyCache *foreign_key_cache = nullptr);
+
   //===--------------------------------------------------------------------===//
   // TILE GROUP
   //===--------------------------------------------------------------------===//
@@ -128,8 +158,75 @@ class DataTable : public AbstractTable {
   // coerce into adding a new tile group with a tile group id
   void AddTileGroupWithOidForRecovery(const oid_t &tile_group_id);
 
+  // drop an empty tile group from the table. its offset is left as a hole:
+  // GetTileGroup() returns nullptr for it and the tile group count does not
+  // change.
+  bool DropTileGroup(const oid_t &tile_group_id);
+
   void AddTileGroup(const std::shared_ptr<TileGroup> &tile_group);
 
+  // add a tile group whose tuples are committed already, such as one mapped
+  // from a snapshot. it is never made active, and its tuples are only in the
+  // indexes once InsertTileGroupsInIndexes() has returned.
+  void AddCommittedTileGroup(const std::shared_ptr<TileGroup> &tile_group);
+
+  // insert every tuple of the committed tile groups into all indexes in key
+  // order. their tuples must not be written to before.
+  void InsertTileGroupsInIndexes(const std::vector<oid_t> &tile_group_ids);
+
+  // block the writers of the table, and keep the planner off its indexes,
+  // until the indexes are filled with committed tile groups
+  void BeginIndexFill();
+
+  void EndIndexFill();
+
+  // wait until the indexes are filled, if they are being filled
+  void WaitForIndexFill();
+
+  // load the keys and their index entries into the index. an empty index is
+  // built from the sorted keys at once, otherwise they are inserted one by
+  // one in key order. unique constraints are only checked in the latter case
+  // and with a transaction given. returns false if one is violated.
+  bool LoadIndex(
+      index::Index *index,
+      std::vector<std::pair<std::unique_ptr<Tuple>, ItemPointer *>> &entries,
+      concurrency::Transaction *transaction);
+
+  inline size_t GetTuplesPerTileGroup() const {
+    return tuples_per_tilegroup_.load();
+  }
+
+  // the tile groups allocated from now on hold this many tuples. the ones
+  // allocated before keep their size.
+  void SetTuplesPerTileGroup(const size_t tuples_per_tilegroup);
+
+  // the tuples of an append-only table are inserted but never updated or
+  // deleted, so scans decide the visibility of its committed tile groups at
+  // once. only an empty table can be made append-only, returns false
+  // otherwise.
+  bool SetAppendOnly();
+
+  inline bool IsAppendOnly() const { return append_only_; }
+
+  // the empty table is split into the partitions, which get the tuples
+  // inserted into it from now on
+  void SetPartitionedTable(std::unique_ptr<PartitionedTable> partitioned_table);
+
+  // nullptr unless the table is split into partitions
+  inline PartitionedTable *GetPartitionedTable() const {
+    return partitioned_table_.get();
+  }
+
+  // the tuples whose timestamp in the column is older than the time to live
+  // (in us) are deleted by the TupleExpirer. returns false if the column is
+  // not a timestamp.
+  bool SetTimeToLive(const oid_t column_id, const uint64_t time_to_live);
+
+  // INVALID_OID unless the tuples of the table expire
+  inline oid_t GetTimeToLiveColumn() const { return ttl_column_id_; }
+
+  inline uint64_t GetTimeToLive() const { return ttl_; }
+
   // Offset is a 0-based number local to the table
   std::shared_ptr<storage::TileGroup> GetTileGroup(
       const std::size_t &tile_group_offset) const;
@@ -138,10 +235,16 @@ class DataTable : public AbstractTable {
   std::shared_ptr<storage::TileGroup> GetTileGroupById(
       const oid_t &tile_group_id) const;
 
+  // Like GetTileGroup(), without taking a reference on the tile group. Only
+  // valid while the calling transaction is in its epoch.
+  storage::TileGroup *ResolveTileGroup(
+      const std::size_t &tile_group_offset) const;
+
   size_t GetTileGroupCount() const;
 
   // Get a tile group with given layout
-  TileGroup *GetTileGroupWithLayout(const column_map_type &partitioning);
+  TileGroup *GetTileGroupWithLayout(const column_map_type &partitioning,
+                                    const int numa_node = INVALID_NUMA_NODE);
 
   //===--------------------------------------------------------------------===//
   // INDEX
@@ -187,6 +290,13 @@ class DataTable : public AbstractTable {
   storage::TileGroup *TransformTileGroup(const oid_t &tile_group_offset,
                                          const double &theta);
 
+  // Move a tile group into the default layout while transactions read it.
+  // Only a full tile group whose tuples are all committed, latest versions
+  // is moved. Returns nullptr if the tile group is already close to the
+  // layout, or cannot be moved right now.
+  storage::TileGroup *RelayoutTileGroup(const oid_t &tile_group_offset,
+                                        const double &theta);
+
   //===--------------------------------------------------------------------===//
   // STATS
   //===--------------------------------------------------------------------===//
@@ -199,6 +309,13 @@ class DataTable : public AbstractTable {
 
   size_t GetTupleCount() const;
 
+  // The number of tuple versions inserted, updated or deleted since the count
+  // was last reset
+  size_t GetModifiedTupleCount() const { return modified_tuple_count_; }
+
+  // Returns the count before the reset
+  size_t ResetModifiedTupleCount() { return modified_tuple_count_.exchange(0); }
+
   bool IsDirty() const;
 
   void ResetDirty();
@@ -252,10 +369,30 @@ class DataTable : public AbstractTable {
                        concurrency::Transaction *transaction,
                        ItemPointer **index_entry_ptr);
 
+  // hand back an indirection that no index entry references anymore. it is
+  // reused by a later insert.
+  void ReleaseIndirection(ItemPointer *indirection);
+
   static void SetActiveTileGroupCount(const size_t active_tile_group_count) {
     default_active_tilegroup_count_ = active_tile_group_count;
   }
 
+  inline size_t GetActiveTileGroupCount() const {
+    return active_tilegroup_count_.load();
+  }
+
+  // change the number of tile groups the table inserts into concurrently.
+  // it is rounded up to a multiple of the NUMA node count and capped at
+  // MAX_ACTIVE_TILE_GROUP_COUNT. returns the count set.
+  size_t AdjustActiveTileGroupCount(const size_t active_tile_group_count);
+
+  // create the spare tile groups that replace the active ones once they are
+  // full. Returns the number of tile groups created.
+  size_t PrepareTileGroups();
+
+  // most active tile groups a table can have
+  static const size_t MAX_ACTIVE_TILE_GROUP_COUNT = 64;
+
   static void SetActiveIndirectionArrayCount(
       const size_t active_indirection_array_count) {
     default_active_indirection_array_count_ = active_indirection_array_count;
@@ -276,11 +413,23 @@ class DataTable : public AbstractTable {
   // add a tile group to the table
   oid_t AddDefaultTileGroup();
   // add a tile group to the table. replace the active_tile_group_id-th active
-  // tile group.
+  // tile group, with the spare one if it was created ahead of time.
   oid_t AddDefaultTileGroup(const size_t &active_tile_group_id);
 
+  // Get the active tile group an inserting thread should use. When multiple
+  // NUMA nodes are present, threads prefer the ones on their own node.
+  size_t GetActiveTileGroupId() const;
+
+  // replace the active_indirection_array_id-th active indirection array,
+  // with the spare one if it was created ahead of time.
   oid_t AddDefaultIndirectionArray(const size_t &active_indirection_array_id);
 
+  // create the array that replaces the active_indirection_array_id-th active
+  // indirection array once it is full
+  void PrepareIndirectionArray(const size_t &active_indirection_array_id);
+
+  std::shared_ptr<IndirectionArray> CreateIndirectionArray();
+
   // Drop all tile groups of the table. Used by recovery
   void DropTileGroups();
 
@@ -288,13 +437,39 @@ class DataTable : public AbstractTable {
   // INDEX HELPERS
   //===--------------------------------------------------------------------===//
 
+  // allocate an indirection pointing at the location. reclaimed indirections
+  // are reused before the active indirection arrays are drawn from.
+  ItemPointer *AllocateIndirection(const ItemPointer &location);
+
+  // insert the bulk loaded tuples into all indexes in key order
+  bool BulkInsertInIndexes(const std::vector<std::unique_ptr<Tuple>> &tuples,
+                           const std::vector<ItemPointer *> &index_entry_ptrs,
+                           concurrency::Transaction *transaction);
+
+  // Whether no secondary index needs an entry for the new version of an
+  // update, since none of their key or predicate columns changed. The
+  // indexes point at the indirection the new version is installed in.
+  bool IsHeapOnlyUpdate(const AbstractTuple *tuple,
+                        const TargetList *targets_ptr,
+                        const AbstractTuple *old_tuple);
+
   bool InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                 const TargetList *targets_ptr,
                                 concurrency::Transaction *transaction,
                                 ItemPointer *index_entry_ptr);
 
+  // the tile group of an append-only table no longer counts on the slot of
+  // an insert that failed
+  void AbortAppend(const ItemPointer &location);
+
   // check the foreign key constraints
-  bool CheckForeignKeyConstraints(const storage::Tuple *tuple);
+  bool CheckForeignKeyConstraints(const storage::Tuple *tuple,
+                                  ForeignKeyCache *foreign_key_cache = nullptr);
+
+  // the primary key index of the table the foreign key refers to, or nullptr
+  // if it has none. returns false if that table does not exist.
+  bool GetReferencedIndex(const catalog::ForeignKey *foreign_key,
+                          std::shared_ptr<index::Index> &index);
 
  public:
   static size_t default_active_tilegroup_count_;
@@ -306,34 +481,60 @@ class DataTable : public AbstractTable {
   // MEMBERS
   //===--------------------------------------------------------------------===//
 
-  size_t active_tilegroup_count_;
+  std::atomic<size_t> active_tilegroup_count_;
   size_t active_indirection_array_count_;
 
+  // serializes the changes of the active tile group count
+  std::mutex active_tile_group_mutex_;
+
+  // active tile group i is placed on NUMA node (i % numa_node_count_)
+  size_t numa_node_count_;
+
   const oid_t database_oid;
 
   // deprecated, use catalog::TableCatalog::GetInstance()->GetTableName()
   std::string table_name;
 
   // number of tuples allocated per tilegroup
-  size_t tuples_per_tilegroup_;
+  std::atomic<size_t> tuples_per_tilegroup_;
 
   // TILE GROUPS
   LockFreeArray<oid_t> tile_groups_;
 
+  // sized for the most active tile groups the table can have, only the
+  // first active_tilegroup_count_ are inserted into
   std::vector<std::shared_ptr<storage::TileGroup>> active_tile_groups_;
 
   std::atomic<size_t> tile_group_count_ = ATOMIC_VAR_INIT(0);
 
+  // tile groups created ahead of time to replace the active ones. they are
+  // not registered with the catalog until they become active.
+  std::vector<std::shared_ptr<storage::TileGroup>> spare_tile_groups_;
+
   // INDIRECTIONS
   std::vector<std::shared_ptr<storage::IndirectionArray>>
       active_indirection_arrays_;
 
+  // arrays created ahead of time to replace the active ones
+  std::vector<std::shared_ptr<storage::IndirectionArray>>
+      spare_indirection_arrays_;
+
+  // indirections that no index entry references anymore
+  LockFreeQueue<ItemPointer *> recycled_indirections_;
+
   // data table mutex
   std::mutex data_table_mutex_;
 
   // INDEXES
   LockFreeArray<std::shared_ptr<index::Index>> indexes_;
 
+  // set while the indexes are filled, with the indexes that were not being
+  // built before
+  std::atomic<bool> index_fill_pending_{false};
+  std::vector<std::shared_ptr<index::Index>> filling_indexes_;
+  std::mutex index_fill_mutex_;
+  std::condition_variable index_fill_cv_;
+
   // columns present in the indexes
   std::vector<std::set<oid_t>> indexes_columns_;
 
@@ -350,9 +551,22 @@ class DataTable : public AbstractTable {
   // concurrently.
   std::atomic<size_t> number_of_tuples_ = ATOMIC_VAR_INIT(0);
 
+  // # of tuples modified since the stats of the table were collected
+  std::atomic<size_t> modified_tuple_count_ = ATOMIC_VAR_INIT(0);
+
   // dirty flag. for detecting whether the tile group has been used.
   bool dirty_ = false;
 
+  // the tile groups of an append-only table are marked as such
+  std::atomic<bool> append_only_ = ATOMIC_VAR_INIT(false);
+
+  // the partitions the table is split into, if any
+  std::unique_ptr<PartitionedTable> partitioned_table_;
+
+  // timestamp column the tuples expire by, and their time to live (us)
+  std::atomic<oid_t> ttl_column_id_ = ATOMIC_VAR_INIT(INVALID_OID);
+  std::atomic<uint64_t> ttl_ = ATOMIC_VAR_INIT(0);
+
   //===--------------------------------------------------------------------===//
   // TUNING MEMBERS
   //===--------------------------------------------------------------------===//
@@ -61,6 +61,10 @@ class Database : public Printable {
 
   void DropTableWithOid(const oid_t table_oid);
 
+  // Remove the table from the database without destroying it, the caller
+  // owns it from now on. Returns nullptr if there is no such table.
+  storage::DataTable *DetachTableWithOid(const oid_t table_oid);
+
   //===--------------------------------------------------------------------===//
   // UTILITIES
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// foreign_key_cache.h
+//
+// Identification: src/include/storage/foreign_key_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "common/macros.h"
+
+namespace peloton {
+
+namespace catalog {
+class ForeignKey;
+}
+
+namespace storage {
+
+class Tuple;
+
+//===--------------------------------------------------------------------===//
+// Foreign Key Cache
+//===--------------------------------------------------------------------===//
+
+/**
+ * The referenced keys a statement already found in the tables its foreign
+ * keys refer to.
+ *
+ * A statement that inserts many tuples with the same parent key then probes
+ * the parent's primary key index once instead of once per tuple. Only keys
+ * that were found are cached, and the cache lives no longer than the
+ * statement. Keys are compared by the serialized bytes of their values.
+ */
+class ForeignKeyCache {
+ public:
+  ForeignKeyCache() {}
+
+  // The serialized values of the key tuple
+  static std::string MakeKey(const Tuple *key);
+
+  // Whether the key was already found in the table the foreign key refers to
+  bool Contains(const catalog::ForeignKey *foreign_key,
+                const std::string &key) const;
+
+  // Remember that the key exists in the table the foreign key refers to
+  void Add(const catalog::ForeignKey *foreign_key, const std::string &key);
+
+  size_t GetKeyCount() const;
+
+  void Clear() { keys_.clear(); }
+
+ private:
+  std::unordered_map<const catalog::ForeignKey *,
+                     std::unordered_set<std::string>> keys_;
+
+ private:
+  DISALLOW_COPY_AND_MOVE(ForeignKeyCache);
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,289 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_tile_group.h
+//
+// Identification: src/include/storage/frozen_tile_group.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/printable.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace storage {
+
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Column encodings
+//===--------------------------------------------------------------------===//
+
+enum class ColumnEncodingType {
+  INVALID = 0,
+  DICTIONARY = 1,   // distinct values + bit-packed codes
+  RUN_LENGTH = 2,   // (value, run end) pairs
+  BIT_PACKED = 3,   // frame-of-reference + bit-packing
+};
+
+std::string ColumnEncodingTypeToString(ColumnEncodingType type);
+
+//===--------------------------------------------------------------------===//
+// Frozen Dictionary
+//===--------------------------------------------------------------------===//
+
+/**
+ * The sorted distinct values of a dictionary-encoded column, with NULL last.
+ * Codes are positions in the dictionary, so they preserve the order of the
+ * values.
+ *
+ * A dictionary is immutable. The freezer shares one among the frozen columns
+ * of all tile groups of a table whose values it has, and replaces it with a
+ * larger one when a tile group brings new values, as long as it stays below
+ * kMaxSharedSize entries. Codes of the same dictionary compare across tile
+ * groups.
+ */
+class FrozenDictionary {
+  FrozenDictionary() = delete;
+  FrozenDictionary(FrozenDictionary const &) = delete;
+
+ public:
+  // Dictionaries with more entries are only used by a single column
+  static const size_t kMaxSharedSize = 1 << 10;
+
+  // The dictionary of the distinct values and of the entries of base, if any
+  FrozenDictionary(const std::vector<type::Value> &values,
+                   const FrozenDictionary *base);
+
+  // Find the code of a value. Returns false if it is not in the dictionary.
+  bool Lookup(const type::Value &value, uint32_t &code) const;
+
+  inline const type::Value &GetValue(const uint32_t code) const {
+    PL_ASSERT(code < entries_.size());
+    return entries_[code];
+  }
+
+  inline const std::vector<type::Value> &GetEntries() const {
+    return entries_;
+  }
+
+  inline size_t GetEntryCount() const { return entries_.size(); }
+
+  // The entries before the NULL one
+  inline size_t GetNonNullCount() const { return non_null_count_; }
+
+  // Bytes used by the values
+  size_t GetMemorySize() const;
+
+ private:
+  std::vector<type::Value> entries_;
+
+  size_t non_null_count_ = 0;
+
+  // Hash -> codes of the values with that hash
+  std::unordered_multimap<size_t, uint32_t> lookup_;
+};
+
+//===--------------------------------------------------------------------===//
+// Frozen Column
+//===--------------------------------------------------------------------===//
+
+/**
+ * An immutable, encoded copy of a single column of a tile group.
+ *
+ * Fixed-width integral columns (and dates/timestamps) are encoded either with
+ * run-length encoding or with frame-of-reference bit-packing, depending on
+ * which one is smaller. All other columns are dictionary encoded with
+ * bit-packed codes.
+ *
+ * NULLs of integral types are stored as their in-tile sentinel values, so
+ * they round-trip without a separate null bitmap.
+ *
+ * Dictionaries are sorted, with NULL last, so that a comparison with a
+ * constant translates into a range of codes.
+ */
+class FrozenColumn {
+  FrozenColumn() = delete;
+  FrozenColumn(FrozenColumn const &) = delete;
+
+ public:
+  // shared_dictionary is the dictionary of the column in the tile groups of
+  // its table frozen before, if any. It is used if it has all the values,
+  // and replaced with one that has them if that is small enough to share.
+  FrozenColumn(const type::TypeId type_id,
+               const std::vector<type::Value> &values,
+               std::shared_ptr<const FrozenDictionary> *shared_dictionary =
+                   nullptr);
+
+  type::Value GetValue(const oid_t tuple_offset) const;
+
+  inline type::TypeId GetTypeId() const { return type_id_; }
+
+  inline ColumnEncodingType GetEncodingType() const { return encoding_type_; }
+
+  inline oid_t GetTupleCount() const { return tuple_count_; }
+
+  // Number of distinct values (dictionary) or runs (run-length)
+  size_t GetEntryCount() const;
+
+  // The dictionary of a DICTIONARY column, nullptr for the others
+  inline const FrozenDictionary *GetDictionary() const {
+    return dictionary_.get();
+  }
+
+  // Keep the tuple offsets of the ascending selection whose values satisfy
+  // the comparison with the value, which is evaluated on the encoded column.
+  // Offsets are compacted in place, the ones past the end of the column are
+  // kept. Returns the number of offsets kept, which is the given count if
+  // the value can't be compared on this column.
+  uint32_t FilterComparison(const ExpressionType comparison_type,
+                            const type::Value &value, uint32_t *selection,
+                            const uint32_t count) const;
+
+  // Bytes used by the encoded column
+  size_t GetMemorySize() const;
+
+  static bool IsIntegralType(const type::TypeId type_id);
+
+ private:
+  void EncodeIntegral(const std::vector<int64_t> &values);
+
+  void EncodeDictionary(
+      const std::vector<type::Value> &values,
+      std::shared_ptr<const FrozenDictionary> *shared_dictionary);
+
+  int64_t GetIntegralValue(const oid_t tuple_offset) const;
+
+  type::Value MakeIntegralValue(const int64_t value) const;
+
+  // Convert a value of an integral type the way the column stores it
+  static bool ToIntegral(const type::Value &value, int64_t &result);
+
+  uint32_t FilterDictionary(const ExpressionType comparison_type,
+                            const type::Value &value, uint32_t *selection,
+                            const uint32_t count) const;
+
+  uint32_t FilterIntegral(const ExpressionType comparison_type,
+                          const type::Value &value, uint32_t *selection,
+                          const uint32_t count) const;
+
+  // Bit-packing helpers
+  static uint8_t GetBitWidth(const uint64_t max_value);
+
+  static void Pack(std::vector<uint64_t> &words, const uint8_t bit_width,
+                   const oid_t offset, const uint64_t value);
+
+  static uint64_t Unpack(const std::vector<uint64_t> &words,
+                         const uint8_t bit_width, const oid_t offset);
+
+ private:
+  type::TypeId type_id_;
+
+  ColumnEncodingType encoding_type_ = ColumnEncodingType::INVALID;
+
+  oid_t tuple_count_;
+
+  // Frame of reference (BIT_PACKED)
+  int64_t base_value_ = 0;
+
+  // Width of every packed entry (BIT_PACKED and DICTIONARY codes)
+  uint8_t bit_width_ = 0;
+
+  std::vector<uint64_t> packed_words_;
+
+  // RUN_LENGTH: run_ends_[i] is the first tuple offset after run i
+  std::vector<int64_t> run_values_;
+  std::vector<oid_t> run_ends_;
+
+  // DICTIONARY, possibly shared with other tile groups of the table
+  std::shared_ptr<const FrozenDictionary> dictionary_;
+};
+
+//===--------------------------------------------------------------------===//
+// Frozen Tile Group
+//===--------------------------------------------------------------------===//
+
+/**
+ * Immutable columnar form of a tile group whose tuples are all committed,
+ * visible and older than the GC horizon.
+ *
+ * The per-slot MVCC header collapses into a single commit id: every tuple is
+ * visible to any transaction whose read id is at least GetCommitId().
+ *
+ * Frozen tile groups are built by the TileGroupFreezer.
+ */
+class FrozenTileGroup : public Printable {
+  FrozenTileGroup() = delete;
+  FrozenTileGroup(FrozenTileGroup const &) = delete;
+
+ public:
+  // shared_dictionaries are the dictionaries of the columns in the tile
+  // groups of the table, see FrozenColumn
+  FrozenTileGroup(TileGroup *tile_group, const oid_t tuple_count,
+                  const cid_t commit_id,
+                  std::vector<std::shared_ptr<const FrozenDictionary>>
+                      *shared_dictionaries = nullptr);
+
+  inline type::Value GetValue(const oid_t tuple_offset,
+                              const oid_t column_id) const {
+    PL_ASSERT(column_id < columns_.size());
+    return columns_[column_id]->GetValue(tuple_offset);
+  }
+
+  inline const FrozenColumn &GetColumn(const oid_t column_id) const {
+    PL_ASSERT(column_id < columns_.size());
+    return *columns_[column_id];
+  }
+
+  inline oid_t GetColumnCount() const { return columns_.size(); }
+
+  inline oid_t GetTupleCount() const { return tuple_count_; }
+
+  inline cid_t GetCommitId() const { return commit_id_; }
+
+  // Keep the tuple offsets of the ascending selection that may satisfy the
+  // predicate. Comparisons of columns with constants in its conjunction are
+  // evaluated on the encoded columns, everything else is left to the caller.
+  // Returns the number of offsets kept.
+  uint32_t FilterTuples(const expression::AbstractExpression *predicate,
+                        executor::ExecutorContext *executor_context,
+                        uint32_t *selection, const uint32_t count) const;
+
+  // Bytes used by all the encoded columns
+  size_t GetMemorySize() const;
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const;
+
+ private:
+  oid_t tuple_count_;
+
+  // All tuples are visible for read ids >= commit_id_
+  cid_t commit_id_;
+
+  std::vector<std::unique_ptr<FrozenColumn>> columns_;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
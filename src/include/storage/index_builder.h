@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_builder.h
+//
+// Identification: src/include/storage/index_builder.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace index {
+class Index;
+}
+
+namespace storage {
+
+class DataTable;
+
+//===--------------------------------------------------------------------===//
+// Index Builder
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background task that populates a newly created index without blocking the
+ * writers of its table.
+ *
+ * The index is already part of the table when the build starts, so writers
+ * maintain it from then on, including the keys of versions whose key
+ * columns were not updated (IndexMetadata::IsBuilding()). The build waits
+ * until the transactions that may have missed the index have ended, then
+ * worker threads insert the keys of the versions that exist in the tile
+ * groups. The index becomes visible to the planner afterwards.
+ *
+ * Only indexes without a uniqueness constraint are built in the background,
+ * as a violation found by the build could not fail the CREATE INDEX anymore.
+ */
+class IndexBuilder {
+ public:
+  IndexBuilder(const IndexBuilder &) = delete;
+  IndexBuilder &operator=(const IndexBuilder &) = delete;
+  IndexBuilder(IndexBuilder &&) = delete;
+  IndexBuilder &operator=(IndexBuilder &&) = delete;
+
+  IndexBuilder();
+
+  ~IndexBuilder();
+
+  // Singleton
+  static IndexBuilder &GetInstance();
+
+  // Populate the index in the background. The index must have been added to
+  // the table already.
+  void BuildIndex(DataTable *table, std::shared_ptr<index::Index> index);
+
+  // Wait for the builds of the table to finish
+  void WaitForTable(DataTable *table);
+
+  // Wait for all builds to finish
+  void WaitForAll();
+
+  // Abandon the builds of a table that is dropped, and wait for them
+  void DropTable(DataTable *table);
+
+  // Abandon all builds, and wait for them
+  void StopAll();
+
+  // Number of builds that did not finish yet
+  size_t GetActiveBuildCount();
+
+  // Insert the keys of the versions in every stride-th tile group starting
+  // at begin_offset and before end_offset. Versions that are not committed
+  // yet, or that no transaction can see anymore, are skipped.
+  // Returns the number of entries inserted.
+  static size_t IndexTileGroups(DataTable *table, index::Index *index,
+                                const oid_t begin_offset,
+                                const oid_t end_offset, const oid_t stride,
+                                const cid_t expired_cid);
+
+  inline void SetWorkerCount(const size_t count) { worker_count = count; }
+
+ private:
+  struct IndexBuild {
+    DataTable *table;
+    std::shared_ptr<index::Index> index;
+
+    // Transactions that entered this epoch or an earlier one may not know
+    // about the index
+    eid_t barrier_eid;
+
+    std::atomic<bool> stop;
+    std::atomic<bool> done;
+
+    std::thread build_thread;
+  };
+
+  // Build loop of one index
+  void Build(IndexBuild *build);
+
+  // Join and release the builds that match, or all of them if table is null
+  void JoinBuilds(DataTable *table, bool stop);
+
+  // Builds that were not joined yet
+  std::vector<std::unique_ptr<IndexBuild>> builds;
+
+  std::mutex builder_mutex;
+
+  //===--------------------------------------------------------------------===//
+  // Builder Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Number of threads that scan the tile groups of a table
+  size_t worker_count;
+
+  // Sleeping period while waiting for old transactions (in ms)
+  oid_t sleep_duration = 10;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -12,19 +12,41 @@
 
 #include <array>
 
+#include "common/memory_tracker.h"
+
 namespace peloton {
 namespace storage {
 
 const size_t INDIRECTION_ARRAY_MAX_SIZE = 1000;
 const size_t INVALID_INDIRECTION_OFFSET = std::numeric_limits<size_t>::max();
 
+// once this many indirections of an array are handed out, the array that
+// replaces it is created ahead of time
+const size_t INDIRECTION_ARRAY_PREALLOCATE_SIZE =
+    INDIRECTION_ARRAY_MAX_SIZE * 3 / 4;
+
+// An indirection array is one fixed-size segment of the indirections of a
+// table. Every indirection counts the index entries that reference it, so
+// that it can be reused once none is left.
 class IndirectionArray {
+  // the indirection must stay the first member: index entries hold a pointer
+  // to it and the counter is found from that pointer.
+  struct IndirectionEntry {
+    ItemPointer indirection;
+    std::atomic<oid_t> index_entry_count = ATOMIC_VAR_INIT(0);
+  };
+
  public:
   IndirectionArray(oid_t oid) : oid_(oid) {
     indirections_.reset(new indirection_array_t());
+    MemoryTracker::Allocate(MemoryComponentType::INDIRECTION_ARRAY,
+                            sizeof(indirection_array_t));
   }
 
-  ~IndirectionArray() {}
+  ~IndirectionArray() {
+    MemoryTracker::Release(MemoryComponentType::INDIRECTION_ARRAY,
+                           sizeof(indirection_array_t));
+  }
 
   size_t AllocateIndirection() {
     if (indirection_counter_ >= INDIRECTION_ARRAY_MAX_SIZE) {
@@ -41,13 +63,34 @@ class IndirectionArray {
   }
 
   ItemPointer *GetIndirectionByOffset(const size_t &offset) {
-    return &(indirections_->at(offset));
+    return &(indirections_->at(offset).indirection);
   }
 
   inline oid_t GetOid() { return oid_; }
 
+  // Record that an index entry references the indirection
+  static void AddIndexEntry(ItemPointer *indirection) {
+    GetEntry(indirection)->index_entry_count.fetch_add(1);
+  }
+
+  // Record that an index entry referencing the indirection was deleted.
+  // Returns the number of index entries left.
+  static oid_t RemoveIndexEntry(ItemPointer *indirection) {
+    auto entry = GetEntry(indirection);
+    PL_ASSERT(entry->index_entry_count > 0);
+    return entry->index_entry_count.fetch_sub(1) - 1;
+  }
+
+  static oid_t GetIndexEntryCount(ItemPointer *indirection) {
+    return GetEntry(indirection)->index_entry_count.load();
+  }
+
  private:
-  typedef std::array<ItemPointer, INDIRECTION_ARRAY_MAX_SIZE>
+  static inline IndirectionEntry *GetEntry(ItemPointer *indirection) {
+    return reinterpret_cast<IndirectionEntry *>(indirection);
+  }
+
+  typedef std::array<IndirectionEntry, INDIRECTION_ARRAY_MAX_SIZE>
       indirection_array_t;
 
   std::unique_ptr<indirection_array_t> indirections_;
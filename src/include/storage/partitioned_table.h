@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_table.h
+//
+// Identification: src/include/storage/partitioned_table.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/item_pointer.h"
+#include "common/platform.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace executor {
+class ExecutorContext;
+}
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace storage {
+
+class DataTable;
+class ForeignKeyCache;
+class Tuple;
+
+//===--------------------------------------------------------------------===//
+// Partitioned Table
+//===--------------------------------------------------------------------===//
+
+enum class PartitionType {
+  // partition i holds the keys in [bound i, bound i + 1), the last one all
+  // keys from its bound on
+  RANGE,
+
+  // partition i holds the keys whose hash modulo the partition count is i
+  HASH
+};
+
+/**
+ * A table split into partitions by the value of one column, the partition
+ * key.
+ *
+ * Every partition is a table of its own, with the same schema, in the
+ * database of the partitioned table, so its indexes cover that partition
+ * alone. Tuples are routed to their partition on insert, scans only visit the
+ * partitions a predicate can be satisfied in, and a range partition is
+ * dropped with its table, without deleting its tuples one by one.
+ *
+ * Catalog::CreatePartitions() splits an empty table, which then keeps the
+ * PartitionedTable but no tuples nor indexes of its own: the inserts into it
+ * go to the partitions, and the optimizer replaces its scans with the scans
+ * of the partitions left by GetPartitions().
+ *
+ * Tuples whose key is null, or below the bound of the first range partition,
+ * have no partition and are rejected.
+ */
+class PartitionedTable {
+ public:
+  PartitionedTable(const PartitionedTable &) = delete;
+  PartitionedTable &operator=(const PartitionedTable &) = delete;
+
+  PartitionedTable(const std::string &name, const PartitionType type,
+                   const oid_t column_id);
+
+  const std::string &GetName() const { return name; }
+
+  PartitionType GetPartitionType() const { return type; }
+
+  oid_t GetPartitionColumn() const { return column_id; }
+
+  // Add a range partition. Its bound must be above the bound of the last
+  // one, and the table must share the schema of the others. Returns false
+  // otherwise.
+  bool AddPartition(DataTable *table, const type::Value &lower_bound);
+
+  // Add a hash partition. No tuple may be inserted before all hash
+  // partitions are added, as adding one reroutes the keys.
+  bool AddPartition(DataTable *table);
+
+  size_t GetPartitionCount() const;
+
+  DataTable *GetPartition(const oid_t partition_offset) const;
+
+  // Partition of the key, nullptr if it has none
+  DataTable *GetPartitionForKey(const type::Value &key) const;
+
+  // Insert the tuple into its partition. Returns a null location if it has
+  // none or the insert fails. The foreign key checks skip the keys found in
+  // the cache, if given.
+  ItemPointer InsertTuple(const Tuple *tuple, concurrency::Transaction *txn,
+                          ItemPointer **index_entry_ptr = nullptr,
+                          ForeignKeyCache *foreign_key_cache = nullptr);
+
+  // Insert the tuples one by one into their partitions, for the transaction.
+  // Returns false if one of them has none or its insert fails, in which case
+  // the transaction must abort.
+  bool BulkInsert(const std::vector<std::unique_ptr<Tuple>> &tuples,
+                  concurrency::Transaction *txn);
+
+  // The partitions in which a tuple can satisfy the predicate, all of them
+  // for a null predicate. Parameter values are resolved through the executor
+  // context if given.
+  std::vector<DataTable *> GetPartitions(
+      const expression::AbstractExpression *predicate,
+      executor::ExecutorContext *executor_context = nullptr) const;
+
+  // Drop the range partitions that only hold keys below the bound, together
+  // with their tables. The tables leave their database right away, but the
+  // catalog::Manager only destroys them once the transactions that may still
+  // scan them have ended. Returns the oids of the tables dropped.
+  std::vector<oid_t> DropPartitionsBefore(const type::Value &bound);
+
+ private:
+  // Offset of the partition of the key, INVALID_OID if it has none
+  oid_t GetPartitionOffset(const type::Value &key) const;
+
+  // Returns false if no tuple of the partition can satisfy the predicate
+  bool CanSatisfy(const oid_t partition_offset,
+                  const expression::AbstractExpression *predicate,
+                  executor::ExecutorContext *executor_context) const;
+
+  // Returns false if no key of the partition satisfies the comparison
+  bool CanSatisfyComparison(const oid_t partition_offset,
+                            const ExpressionType comparison_type,
+                            const type::Value &value) const;
+
+  std::string name;
+
+  PartitionType type;
+
+  // partition key
+  oid_t column_id;
+
+  std::vector<DataTable *> partitions;
+
+  // lower bounds of the range partitions, ascending
+  std::vector<type::Value> lower_bounds;
+
+  // guards the partitions
+  RWLock partition_lock;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,98 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_snapshot.h
+//
+// Identification: src/include/storage/table_snapshot.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "type/types.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+
+class DataTable;
+
+//===--------------------------------------------------------------------===//
+// Table Snapshot
+//===--------------------------------------------------------------------===//
+
+/**
+ * snapshot file layout :
+ *
+ *  -----------------------------------------------------------------------
+ *  | header | tile data | tile data | ... | directory |
+ *  -----------------------------------------------------------------------
+ *
+ * header, the first page :
+ *
+ *  -----------------------------------------------------------------------
+ *  | magic | directory_offset | directory_size |
+ *  -----------------------------------------------------------------------
+ *
+ * directory :
+ *
+ *  -----------------------------------------------------------------------
+ *  | column_count | column_type | column_length | ... | tuple_length |
+ *  | tile_group_count | tuple_count | data_offset | zone map | ... |
+ *  -----------------------------------------------------------------------
+ *
+ * The zone map of a tile group holds, for each column, its null count and
+ * whether min and max values follow.
+ *
+ * The tile data of a tile group is page aligned, and holds its tuples laid
+ * out exactly as in a tile of the whole schema. Loading a snapshot maps the
+ * file copy-on-write and builds tile groups right over the mapping, so the
+ * tuples are only read from the file when first accessed, and the time to
+ * load does not depend on the size of the data. The MVCC headers of the
+ * tile groups are still set up, a few words per tuple, and the indexes are
+ * filled by a background thread.
+ *
+ * The varlen values of a tuple live in the pool of its tile, so only the
+ * tables whose columns are all inlined have a snapshot. The file must not
+ * change while a table is mapped from it: a new snapshot is written to a
+ * temporary file renamed over the old one.
+ */
+class TableSnapshot {
+ public:
+  // Write the tuples of the table visible to the transaction. Returns false
+  // if the table has uninlined columns or the file cannot be written.
+  static bool WriteTable(concurrency::Transaction *txn, DataTable *table,
+                         const std::string &path);
+
+  // Map the snapshot into tile groups of the empty table. Its tuples are
+  // visible to every transaction. The indexes, if any, are filled by the
+  // thread started, which the caller joins: the table may be scanned right
+  // away, while its writers wait and its indexes are not planned until the
+  // thread is done. Returns false if the snapshot cannot be read or does not
+  // match the table.
+  static bool LoadTable(DataTable *table, const std::string &path,
+                        std::unique_ptr<std::thread> &index_thread);
+
+ private:
+  static const char snapshot_magic_[8];
+
+  // alignment of the tile data, so each tile starts on its own page
+  static const size_t snapshot_page_size_ = 4096;
+
+  // commit id of the mapped tuples, ahead of every transaction
+  static const cid_t snapshot_commit_id_ = 1;
+};
+
+}  // namespace storage
+}  // namespace peloton
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <mutex>
 
 #include "catalog/manager.h"
@@ -21,6 +23,7 @@
 #include "type/abstract_pool.h"
 #include "type/serializeio.h"
 #include "type/serializer.h"
+#include "util/numa_util.h"
 
 namespace peloton {
 
@@ -56,10 +59,12 @@ class Tile : public Printable {
   Tile(Tile const &) = delete;
 
  public:
-  // Tile creator
+  // Tile creator. A tile over mapped data uses it in place of allocating its
+  // own, and keeps the mapping alive.
   Tile(BackendType backend_type, TileGroupHeader *tile_header,
        const catalog::Schema &tuple_schema, TileGroup *tile_group,
-       int tuple_count);
+       int tuple_count, int numa_node = INVALID_NUMA_NODE,
+       const std::shared_ptr<char> &mapped_data = nullptr);
 
   virtual ~Tile();
 
@@ -129,6 +134,37 @@ class Tile : public Printable {
   // Both inlined and uninlined data
   uint32_t GetSize() const { return tile_size + uninlined_data_size; }
 
+  //===--------------------------------------------------------------------===//
+  // Mapped tuple slots
+  //===--------------------------------------------------------------------===//
+
+  // True if the tuple slots are in a mapped file, which the kernel pages in
+  // on access
+  bool IsMapped() const { return mapped_data != nullptr; }
+
+  // Move the tuple slots into a mapped copy of them. The uninlined data stays
+  // in the pool. Returns the function that frees the memory they were in, to
+  // be called once no reader can still use it.
+  std::function<void()> MapData(const std::shared_ptr<char> &mapped_copy);
+
+  // Ask the kernel to page the mapped tuple slots in ahead of the accesses
+  void PrefetchData() const;
+
+  //===--------------------------------------------------------------------===//
+  // Released tuple slots
+  //===--------------------------------------------------------------------===//
+
+  // True if the tuple slots have been released, see ReleaseData
+  bool IsReleased() const { return is_released; }
+
+  // Give up the tuple slots, which must not be read until RestoreData. The
+  // uninlined data stays in the pool. Returns the function that frees the
+  // memory they were in, to be called once no reader can still use it.
+  std::function<void()> ReleaseData();
+
+  // Allocate zeroed tuple slots again after ReleaseData
+  void RestoreData();
+
   //===--------------------------------------------------------------------===//
   // Columns
   //===--------------------------------------------------------------------===//
@@ -191,12 +227,21 @@ class Tile : public Printable {
   // backend type
   BackendType backend_type;
 
+  // NUMA node the tuple storage is placed on, if any
+  int numa_node;
+
   // tile schema
   catalog::Schema schema;
 
   // set of fixed-length tuple slots
   char *data;
 
+  // mapping holding the tuple slots of a mapped tile
+  std::shared_ptr<char> mapped_data;
+
+  // the tuple slots were released and are freed by their release function
+  bool is_released;
+
   // relevant tile group
   TileGroup *tile_group;
 
@@ -282,9 +327,10 @@ class TileFactory {
                        oid_t table_id, oid_t tile_group_id, oid_t tile_id,
                        TileGroupHeader *tile_header,
                        const catalog::Schema &schema, TileGroup *tile_group,
-                       int tuple_count) {
-    Tile *tile =
-        new Tile(backend_type, tile_header, schema, tile_group, tuple_count);
+                       int tuple_count, int numa_node = INVALID_NUMA_NODE,
+                       const std::shared_ptr<char> &mapped_data = nullptr) {
+    Tile *tile = new Tile(backend_type, tile_header, schema, tile_group,
+                          tuple_count, numa_node, mapped_data);
 
     TileFactory::InitCommon(tile, database_id, table_id, tile_group_id, tile_id,
                             schema);
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -24,6 +25,7 @@
 #include "type/abstract_pool.h"
 #include "type/types.h"
 #include "type/value.h"
+#include "util/numa_util.h"
 
 namespace peloton {
 
@@ -52,6 +54,9 @@ class TileGroupHeader;
 class AbstractTable;
 class TileGroupIterator;
 class RollbackSegment;
+class FrozenTileGroup;
+class ZoneMap;
+class TupleSerializer;
 
 typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
 
@@ -67,16 +72,21 @@ typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
 class TileGroup : public Printable {
   friend class Tile;
   friend class TileGroupFactory;
+  friend class TileGroupEvictor;
   friend class gc::GCManager;
 
   TileGroup() = delete;
   TileGroup(TileGroup const &) = delete;
 
  public:
-  // Tile group constructor
+  // Tile group constructor. The tiles use the mapped data, if given, one
+  // entry per tile.
   TileGroup(BackendType backend_type, TileGroupHeader *tile_group_header,
             AbstractTable *table, const std::vector<catalog::Schema> &schemas,
-            const column_map_type &column_map, int tuple_count);
+            const column_map_type &column_map, int tuple_count,
+            int numa_node = INVALID_NUMA_NODE,
+            const std::vector<std::shared_ptr<char>> &mapped_tile_data =
+                std::vector<std::shared_ptr<char>>());
 
   ~TileGroup();
 
@@ -125,18 +135,26 @@ class TileGroup : public Printable {
 
   TileGroupHeader *GetHeader() const { return tile_group_header; }
 
+  // NUMA node the tiles and the header are placed on, if any
+  int GetNumaNode() const { return numa_node; }
+
   void SetHeader(TileGroupHeader *header) { tile_group_header = header; }
 
   unsigned int NumTiles() const { return tiles.size(); }
 
-  // Get the tile at given offset in the tile group
+  // Get the tile at given offset in the tile group. Released tuple slots are
+  // restored first.
   inline Tile *GetTile(const oid_t tile_offset) const {
     PL_ASSERT(tile_offset < tile_count);
+    if (is_released == true) {
+      RestoreTiles();
+    }
     Tile *tile = tiles[tile_offset].get();
     return tile;
   }
 
-  // Get a reference to the tile at the given offset in the tile group
+  // Get a reference to the tile at the given offset in the tile group.
+  // Released tuple slots are restored first.
   std::shared_ptr<Tile> GetTileReference(const oid_t tile_offset) const;
 
   oid_t GetTileId(const oid_t tile_id) const;
@@ -182,6 +200,62 @@ class TileGroup : public Printable {
 
   double GetSchemaDifference(const storage::column_map_type &new_column_map);
 
+  //===--------------------------------------------------------------------===//
+  // Frozen tile groups
+  //===--------------------------------------------------------------------===//
+
+  // Install the immutable, compressed copy of this tile group and mark the
+  // header as frozen.
+  void Freeze(const std::shared_ptr<FrozenTileGroup> &frozen_tile_group);
+
+  // Returns nullptr if the tile group is not frozen (or has been thawed by a
+  // writer since it was frozen).
+  std::shared_ptr<FrozenTileGroup> GetFrozenTileGroup() const;
+
+  // Drop the compressed copy of a tile group that has been thawed.
+  void ReleaseFrozenTileGroup();
+
+  // Give up the tuple slots of the tiles of a frozen tile group. GetValue and
+  // the scans read its frozen copy instead, the other readers and the
+  // writers restore the slots first. Returns the functions that free their
+  // memory, to be called once no reader can still use it, none if the tile
+  // group is not frozen, evicted or released already.
+  std::vector<std::function<void()>> ReleaseTiles();
+
+  // True while the tuple slots are released, see ReleaseTiles
+  bool IsReleased() const { return is_released; }
+
+  // Decode the frozen copy back into the released tuple slots. The uninlined
+  // values are copied into the pools again.
+  void RestoreTiles() const;
+
+  // Decode the columns of the tuples at the given offsets from the frozen
+  // copy into a tile of the tile group with a slot per tuple slot, so that
+  // the tuples keep their offsets. Returns nullptr if there is no frozen
+  // copy.
+  std::shared_ptr<Tile> DecodeFrozenTile(const std::vector<oid_t> &column_ids,
+                                         const std::vector<oid_t> &tuple_ids);
+
+  // Bytes of tuple slots the tiles hold in memory
+  size_t GetResidentSize() const;
+
+  //===--------------------------------------------------------------------===//
+  // Evicted tile groups
+  //===--------------------------------------------------------------------===//
+
+  // True if the tuple slots of the tile group are paged in from a file on
+  // access, see TileGroupEvictor
+  bool IsEvicted() const;
+
+  // Ask the kernel to page the evicted tuple slots in ahead of a scan
+  void Prefetch() const;
+
+  // Per-column min/max values of everything written into the tile group
+  ZoneMap *GetZoneMap() const { return zone_map.get(); }
+
+  // Serializes the tuples of the tile group straight from its tiles
+  const TupleSerializer &GetSerializer() const { return *serializer; }
+
   // Sync the contents
   void Sync();
 
@@ -198,6 +272,9 @@ class TileGroup : public Printable {
   // Backend type
   BackendType backend_type;
 
+  // NUMA node the tile group is placed on, if any
+  int numa_node;
+
   // mapping to tile schemas
   std::vector<catalog::Schema> tile_schemas;
 
@@ -216,7 +293,20 @@ class TileGroup : public Printable {
   // number of tiles
   oid_t tile_count;
 
-  std::mutex tile_group_mutex;
+  // serializes releasing, restoring and evicting the tuple slots
+  mutable std::mutex tile_group_mutex;
+
+  // compressed copy of the tile group. only valid while the header is frozen.
+  std::shared_ptr<FrozenTileGroup> frozen_tile_group;
+
+  // the frozen copy holds the only copy of the tuples, see ReleaseTiles
+  mutable std::atomic<bool> is_released;
+
+  // widened on every insert and update. used to skip tile groups in scans.
+  std::unique_ptr<ZoneMap> zone_map;
+
+  // built from the tile schemas and the column map
+  std::unique_ptr<TupleSerializer> serializer;
 
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_classifier.h
+//
+// Identification: src/include/storage/tile_group_classifier.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "storage/tile_group_header.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+
+std::string TileGroupTemperatureToString(TileGroupTemperature temperature);
+
+//===--------------------------------------------------------------------===//
+// Tile Group Classifier
+//===--------------------------------------------------------------------===//
+
+/**
+ * Classifies the tile groups of a table as hot, warm or cold by how often
+ * their tuples are accessed.
+ *
+ * The transaction manager reports every read, insert, update and delete.
+ * Each thread only counts one in ACCESS_SAMPLE_INTERVAL of them, into the
+ * header of the tile group accessed. Classifying a table folds the counts
+ * into a score per tile group that decays by half every classification, so
+ * it follows the recent accesses. The score is compared to the hot and cold
+ * thresholds.
+ *
+ * The freezer only freezes cold tile groups, and the layout tuner does not
+ * move them. A table is classified at most once per classify interval,
+ * whichever of them asks.
+ */
+class TileGroupClassifier {
+ public:
+  // One in this many accesses of a thread is counted
+  static const uint32_t ACCESS_SAMPLE_INTERVAL = 64;
+
+  TileGroupClassifier();
+
+  // Singleton
+  static TileGroupClassifier &GetInstance();
+
+  // Report an access to a tuple of the tile group
+  static void RecordAccess(const oid_t tile_group_id);
+
+  static void RecordAccess(TileGroupHeader *tile_group_header);
+
+  // Classify the tile groups of the table, unless it was classified less
+  // than the classify interval ago. Returns the number of cold tile groups,
+  // or 0 if it was skipped.
+  size_t ClassifyTable(DataTable *table);
+
+  // Classify the tile groups of the table now
+  size_t ClassifyTableNow(DataTable *table);
+
+  // Forget when the table was classified
+  void DropTable(DataTable *table);
+
+  // Scores (in sampled accesses) at and above which a tile group is hot,
+  // and below which it is cold
+  void SetThresholds(const double hot_score, const double cold_score);
+
+  // Shortest time between two classifications of a table (in ms)
+  void SetClassifyInterval(const uint64_t interval_ms) {
+    classify_interval = interval_ms;
+  }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  // True for one in ACCESS_SAMPLE_INTERVAL calls of the thread
+  static bool IsSampled();
+
+  // Fold the accesses into the scores and set the temperatures. Called with
+  // the classifier mutex held.
+  size_t Classify(DataTable *table);
+
+  TileGroupTemperature GetTemperature(const double score) const;
+
+  // Serializes the classifications, the scores decay once per pass
+  std::mutex classifier_mutex;
+
+  // When every table was classified last
+  std::unordered_map<DataTable *, Clock::time_point> classify_times;
+
+  //===--------------------------------------------------------------------===//
+  // Classifier Parameters
+  //===--------------------------------------------------------------------===//
+
+  // The part of the score that is kept every classification
+  double score_decay = 0.5;
+
+  double hot_threshold = 16;
+
+  double cold_threshold = 1;
+
+  // Shortest time between two classifications of a table (in ms)
+  uint64_t classify_interval = 1000;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
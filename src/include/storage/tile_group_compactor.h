@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor.h
+//
+// Identification: src/include/storage/tile_group_compactor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Compactor
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background task that moves the live tuples out of sparse tile groups and
+ * drops the tile groups once they are empty.
+ *
+ * A full tile group whose fraction of live tuples falls below the threshold
+ * is retired: the GC stops handing out its recycled slots. Its live tuples are
+ * then moved into the active tile groups by installing a new version of each
+ * of them, exactly like an update that changes no column, so index entries
+ * keep pointing at the same indirections. The old versions are reclaimed by
+ * the GC like any other garbage. Once every slot of the retired tile group
+ * has been recycled, no transaction can reach it anymore and it is dropped
+ * from the table.
+ */
+class TileGroupCompactor {
+ public:
+  TileGroupCompactor(const TileGroupCompactor &) = delete;
+  TileGroupCompactor &operator=(const TileGroupCompactor &) = delete;
+  TileGroupCompactor(TileGroupCompactor &&) = delete;
+  TileGroupCompactor &operator=(TileGroupCompactor &&) = delete;
+
+  TileGroupCompactor();
+
+  ~TileGroupCompactor();
+
+  // Singleton
+  static TileGroupCompactor &GetInstance();
+
+  // Start compacting
+  void Start();
+
+  // Compactor loop
+  void Compact();
+
+  // Stop compacting
+  void Stop();
+
+  // Add table to the list of tables whose tile groups can be compacted
+  void AddTable(DataTable *table);
+
+  // Remove table from the list
+  void DropTable(DataTable *table);
+
+  // Clear list
+  void ClearTables();
+
+  // Retire the sparse tile groups of a table, move their live tuples and drop
+  // the ones that are empty. Returns the number of dropped tile groups.
+  size_t CompactTable(DataTable *table);
+
+  // Move the live tuples of a retired tile group into the active tile groups
+  // in one transaction. Returns false if the transaction did not commit.
+  static bool MoveTuples(DataTable *table, TileGroup *tile_group);
+
+  // Number of latest, undeleted versions in the tile group
+  static oid_t GetLiveTupleCount(const TileGroup *tile_group);
+
+  void SetCompactionThreshold(const double threshold) {
+    compaction_threshold = threshold;
+  }
+
+ private:
+  // Tables whose tile groups must be compacted
+  std::vector<DataTable *> tables;
+
+  std::mutex compactor_mutex;
+
+  // Stop signal
+  std::atomic<bool> compactor_stop;
+
+  // Compactor thread
+  std::thread compactor_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Compactor Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Retire tile groups with fewer live tuples than this fraction of slots
+  double compaction_threshold = 0.25;
+
+  // Sleeping period (in ms)
+  oid_t sleep_duration = 1000;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_evictor.h
+//
+// Identification: src/include/storage/tile_group_evictor.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Evictor
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background task that evicts the tuple slots of cold, frozen tile groups
+ * to files, so that a table can hold more data than fits in memory.
+ *
+ * Evicting a tile group writes the tuple slots of its tiles into a file in
+ * the eviction directory and maps the file in their place. The file is
+ * unlinked right away and lives as long as the mapping. The tile group, its
+ * header and the uninlined data stay in memory, so indexes, the catalog and
+ * the visibility checks are unaffected. The kernel pages the slots back in
+ * on the first access, blocking only the thread that touches them, and may
+ * drop them again under memory pressure. Scans that reach an evicted tile
+ * group ask for the following ones ahead of time.
+ *
+ * Only tile groups that the TileGroupClassifier finds cold and whose header
+ * is still frozen are evicted, coldest first, until the slots left in
+ * memory fit the memory budget. The TileGroupFreezer releases the slots of
+ * the tile groups it freezes, so these are the ones whose slots a reader of
+ * the raw slots restored since. Writers are held off while the slots are
+ * copied, exactly like during a relocation. The memory the slots were in is
+ * freed once the transactions that could have read it have ended. Evicted
+ * data is not durable, recovery comes from the log and checkpoints.
+ */
+class TileGroupEvictor {
+ public:
+  // Tile groups a scan pages in ahead when it reaches an evicted one
+  static const oid_t PREFETCH_TILE_GROUP_COUNT = 8;
+
+  TileGroupEvictor(const TileGroupEvictor &) = delete;
+  TileGroupEvictor &operator=(const TileGroupEvictor &) = delete;
+  TileGroupEvictor(TileGroupEvictor &&) = delete;
+  TileGroupEvictor &operator=(TileGroupEvictor &&) = delete;
+
+  TileGroupEvictor();
+
+  ~TileGroupEvictor();
+
+  // Singleton
+  static TileGroupEvictor &GetInstance();
+
+  // Start evicting
+  void Start();
+
+  // Evictor loop
+  void Evict();
+
+  // Stop evicting
+  void Stop();
+
+  // Add table to the list of tables whose tile groups can be evicted
+  void AddTable(DataTable *table);
+
+  // Remove table from the list
+  void DropTable(DataTable *table);
+
+  // Clear list
+  void ClearTables();
+
+  // Evict the cold, frozen tile groups of all tables, coldest first, until
+  // the rest fits the memory budget. Returns the number evicted, and adds
+  // the bytes written to the evicted size if given.
+  size_t EvictTables(size_t *evicted_size = nullptr);
+
+  // Move the tuple slots of the tile group into a file. Returns false if it
+  // is not frozen anymore, already evicted or released.
+  bool EvictTileGroup(TileGroup *tile_group);
+
+  // Free the memory of evicted tuple slots that no transaction can read
+  // anymore. Returns the number of tiles whose memory was freed.
+  size_t ReleaseData();
+
+  // Page in the evicted tile groups among the count that follow the offset
+  // of the table, ahead of a scan reaching them
+  static void PrefetchTileGroups(DataTable *table,
+                                 const oid_t tile_group_offset,
+                                 const oid_t tile_group_count);
+
+  // Bytes of tuple slots the tile group holds in memory
+  static size_t GetResidentSize(const TileGroup *tile_group);
+
+  void SetEvictionDirectory(const std::string &directory) {
+    eviction_directory = directory;
+  }
+
+  // Bytes of tuple slots the tables may keep in memory, 0 to evict every
+  // cold, frozen tile group
+  void SetMemoryBudget(const size_t budget) { memory_budget = budget; }
+
+ private:
+  // Memory of evicted tuple slots, freed once the epoch has expired
+  struct RetiredData {
+    eid_t epoch_id;
+
+    std::function<void()> release;
+  };
+
+  // Tables whose tile groups can be evicted
+  std::vector<DataTable *> tables;
+
+  std::mutex evictor_mutex;
+
+  std::vector<RetiredData> retired_data;
+
+  std::mutex retired_data_mutex;
+
+  // Stop signal
+  std::atomic<bool> evictor_stop;
+
+  // Evictor thread
+  std::thread evictor_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Evictor Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Sleeping period (in ms)
+  oid_t sleep_duration = 1000;
+
+  // Tile groups evicted per pass at most
+  size_t max_evictions_per_pass = 64;
+
+  // Directory the evicted tuple slots are written to
+  std::string eviction_directory = "/tmp";
+
+  // Bytes of tuple slots the tables may keep in memory, 0 for none
+  size_t memory_budget = 0;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
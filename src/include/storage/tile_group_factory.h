@@ -33,7 +33,11 @@ class TileGroupFactory {
                                  oid_t tile_group_id, AbstractTable *table,
                                  const std::vector<catalog::Schema> &schemas,
                                  const column_map_type &column_map,
-                                 int tuple_count);
+                                 int tuple_count,
+                                 int numa_node = INVALID_NUMA_NODE,
+                                 const std::vector<std::shared_ptr<char>>
+                                     &mapped_tile_data =
+                                         std::vector<std::shared_ptr<char>>());
 };
 
 }  // End storage namespace
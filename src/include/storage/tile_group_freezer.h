@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.h
+//
+// Identification: src/include/storage/tile_group_freezer.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+class FrozenDictionary;
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Freezer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background task that converts cold tile groups into their immutable,
+ * compressed FrozenTileGroup form.
+ *
+ * A tile group is frozen when all of its slots are allocated and every tuple
+ * is a committed, live version whose begin commit id is older than the GC
+ * horizon (EpochManager::GetExpiredCid()). Writers thaw a frozen tile group
+ * when they acquire ownership of one of its tuples; a later pass releases the
+ * stale compressed copy.
+ *
+ * The background pass only freezes the tile groups the TileGroupClassifier
+ * finds cold, so ones that are still read often stay uncompressed. Freezing
+ * releases the uncompressed tuple slots, so that only the frozen copy takes
+ * memory: scans decode it, the other readers and the writers restore the
+ * slots from it, see TileGroup::ReleaseTiles. The pass releases the restored
+ * slots of the tile groups that are still frozen and cold again. Their
+ * memory is freed once the transactions that could have read it have ended.
+ */
+class TileGroupFreezer {
+ public:
+  TileGroupFreezer(const TileGroupFreezer &) = delete;
+  TileGroupFreezer &operator=(const TileGroupFreezer &) = delete;
+  TileGroupFreezer(TileGroupFreezer &&) = delete;
+  TileGroupFreezer &operator=(TileGroupFreezer &&) = delete;
+
+  TileGroupFreezer();
+
+  ~TileGroupFreezer();
+
+  // Singleton
+  static TileGroupFreezer &GetInstance();
+
+  // Start freezing
+  void Start();
+
+  // Freezer loop
+  void Freeze();
+
+  // Stop freezing
+  void Stop();
+
+  // Add table to the list of tables whose tile groups can be frozen
+  void AddTable(DataTable *table);
+
+  // Remove table from the list
+  void DropTable(DataTable *table);
+
+  // Clear list
+  void ClearTables();
+
+  // Freeze all eligible tile groups of a table, only the cold ones if asked
+  // to. Returns the number of tile groups that were frozen.
+  size_t FreezeTable(DataTable *table, const cid_t expired_cid,
+                     const bool cold_only = false);
+
+  // Freeze the tile group if it is eligible. Its dictionary-encoded columns
+  // share the dictionaries given for them, see FrozenColumn.
+  bool FreezeTileGroup(TileGroup *tile_group, const cid_t expired_cid,
+                       std::vector<std::shared_ptr<const FrozenDictionary>>
+                           *shared_dictionaries = nullptr);
+
+  // Check whether all tuples in the tile group are committed, live and older
+  // than expired_cid. On success, commit_id is set to the largest begin
+  // commit id in the tile group.
+  static bool CanFreeze(const TileGroup *tile_group, const cid_t expired_cid,
+                        cid_t &commit_id);
+
+  // Free the memory of released tuple slots that no transaction can read
+  // anymore. Returns the number of tiles whose memory was freed.
+  size_t ReleaseData();
+
+ private:
+  // Memory of released tuple slots, freed once the epoch has expired
+  struct RetiredData {
+    eid_t epoch_id;
+
+    std::function<void()> release;
+  };
+
+  // Release the tuple slots of a frozen tile group
+  void ReleaseTiles(TileGroup *tile_group);
+
+  // Tables whose tile groups must be frozen
+  std::vector<DataTable *> tables;
+
+  std::mutex freezer_mutex;
+
+  // The dictionaries shared by the frozen tile groups of every table, by
+  // column
+  std::unordered_map<DataTable *,
+                     std::vector<std::shared_ptr<const FrozenDictionary>>>
+      dictionaries;
+
+  std::mutex dictionaries_mutex;
+
+  std::vector<RetiredData> retired_data;
+
+  std::mutex retired_data_mutex;
+
+  // Stop signal
+  std::atomic<bool> freezer_stop;
+
+  // Freezer thread
+  std::thread freezer_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Freezer Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Sleeping period (in ms)
+  oid_t sleep_duration = 1000;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
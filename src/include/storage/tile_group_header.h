@@ -12,14 +12,17 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
+#include <memory>
 
 #include "common/item_pointer.h"
 #include "common/macros.h"
 #include "common/platform.h"
 #include "common/printable.h"
 #include "type/types.h"
+#include "util/numa_util.h"
 
 namespace peloton {
 namespace storage {
@@ -66,24 +69,61 @@ class TileGroup;
 
 #define TUPLE_HEADER_LOCATION data + (tuple_slot_id * header_entry_size)
 
+// How often the tuples of a tile group are accessed, see TileGroupClassifier
+enum class TileGroupTemperature : uint32_t {
+  HOT = 0,   // accessed often, kept in its fastest form
+  WARM = 1,  // accessed now and then
+  COLD = 2   // barely accessed, may be frozen
+};
+
 class TileGroupHeader : public Printable {
   TileGroupHeader() = delete;
 
  public:
-  TileGroupHeader(const BackendType &backend_type, const int &tuple_count);
+  TileGroupHeader(const BackendType &backend_type, const int &tuple_count,
+                  const int numa_node = INVALID_NUMA_NODE);
 
   TileGroupHeader &operator=(const peloton::storage::TileGroupHeader &other) {
     // check for self-assignment
     if (&other == this) return *this;
 
-    header_size = other.header_size;
+    // the header array was allocated for this slot count, never copy past
+    // the end of either array
+    PL_ASSERT(num_tuple_slots == other.num_tuple_slots);
+    PL_ASSERT(header_size == other.header_size);
 
     // copy over all the data
-    PL_MEMCPY(data, other.data, header_size);
+    PL_MEMCPY(data, other.data, std::min(header_size, other.header_size));
 
-    num_tuple_slots = other.num_tuple_slots;
     oid_t val = other.next_tuple_slot;
-    next_tuple_slot = val;
+    next_tuple_slot = std::min(val, num_tuple_slots);
+
+    // carry over the slots that were recycled by the GC
+    PL_ASSERT(recycled_slot_word_count == other.recycled_slot_word_count);
+    oid_t word_count =
+        std::min(recycled_slot_word_count, other.recycled_slot_word_count);
+    for (oid_t word_itr = 0; word_itr < word_count; word_itr++) {
+      recycled_slots[word_itr] = other.recycled_slots[word_itr].load();
+    }
+    oid_t recycled_count = other.recycled_slot_count;
+    recycled_slot_count = recycled_count;
+
+    append_only = other.append_only;
+    oid_t pending_count = other.pending_append_count;
+    pending_append_count = pending_count;
+    cid_t newest_commit_id = other.newest_append_commit_id;
+    newest_append_commit_id = newest_commit_id;
+    bool has_empty = other.has_empty_append;
+    has_empty_append = has_empty;
+
+    bool is_retired = other.retired;
+    retired = is_retired;
+
+    txn_id_t deleting_txn = other.deleting_txn_id;
+    deleting_txn_id = deleting_txn;
+    delete_read_id = other.delete_read_id;
+    cid_t deleted_commit = other.deleted_commit_id;
+    deleted_commit_id = deleted_commit;
 
     return *this;
   }
@@ -96,6 +136,18 @@ class TileGroupHeader : public Printable {
       return INVALID_OID;
     }
 
+    // the insert is counted before its slot is handed out, see
+    // GetVisibleAppendCount()
+    if (append_only == true) {
+      pending_append_count++;
+      oid_t tuple_slot_id = next_tuple_slot.fetch_add(1);
+      if (tuple_slot_id >= num_tuple_slots) {
+        pending_append_count--;
+        return INVALID_OID;
+      }
+      return tuple_slot_id;
+    }
+
     oid_t tuple_slot_id =
         next_tuple_slot.fetch_add(1, std::memory_order_relaxed);
 
@@ -109,19 +161,36 @@ class TileGroupHeader : public Printable {
   /**
    * Used by logging
    */
-  // TODO: rewrite the code!!!
   bool GetEmptyTupleSlot(const oid_t &tuple_slot_id) {
-    tile_header_lock.Lock();
-    if (tuple_slot_id < num_tuple_slots) {
-      if (next_tuple_slot <= tuple_slot_id) {
-        next_tuple_slot = tuple_slot_id + 1;
-      }
-      tile_header_lock.Unlock();
-      return true;
-    } else {
-      tile_header_lock.Unlock();
+    if (tuple_slot_id >= num_tuple_slots) {
       return false;
     }
+
+    // move next_tuple_slot past the given slot, unless someone else already
+    // did so
+    oid_t next_tid = next_tuple_slot.load();
+    while (next_tid <= tuple_slot_id &&
+           next_tuple_slot.compare_exchange_weak(next_tid,
+                                                 tuple_slot_id + 1) == false)
+      ;
+
+    return true;
+  }
+
+  //===--------------------------------------------------------------------===//
+  // Recycled tuple slots
+  //===--------------------------------------------------------------------===//
+
+  // Called by the GC once the version in the slot has been reset.
+  // Returns true if the tile group had no recycled slots before, in which
+  // case the caller must make the tile group known to the inserters.
+  bool RecycleTupleSlot(const oid_t tuple_slot_id);
+
+  // Claim a recycled slot. Returns INVALID_OID if there is none.
+  oid_t GetRecycledTupleSlot();
+
+  inline oid_t GetRecycledTupleSlotCount() const {
+    return recycled_slot_count.load();
   }
 
   oid_t GetCurrentNextTupleSlot() const {
@@ -146,6 +215,11 @@ class TileGroupHeader : public Printable {
     return tile_group;
   }
 
+  // start of the header entry of a tuple slot, used to prefetch it
+  inline const char *GetHeaderEntry(const oid_t &tuple_slot_id) const {
+    return TUPLE_HEADER_LOCATION;
+  }
+
   // it is possible that some other transactions are modifying the txn_id,
   // but the current transaction reads the txn_id.
   // the returned value seems to be uncertain.
@@ -230,6 +304,127 @@ class TileGroupHeader : public Printable {
 
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
+  //===--------------------------------------------------------------------===//
+  // Frozen tile groups
+  //===--------------------------------------------------------------------===//
+
+  // A frozen tile group is immutable: every tuple slot holds a committed
+  // version that is visible to all transactions with read id >= the frozen
+  // commit id. Writers must thaw the tile group before taking ownership.
+  inline bool IsFrozen() const { return frozen_commit_id != INVALID_CID; }
+
+  inline cid_t GetFrozenCommitId() const { return frozen_commit_id; }
+
+  inline void SetFrozenCommitId(const cid_t &commit_id) {
+    frozen_commit_id = commit_id;
+  }
+
+  inline void Thaw() const { frozen_commit_id = INVALID_CID; }
+
+  //===--------------------------------------------------------------------===//
+  // Append-only tile groups
+  //===--------------------------------------------------------------------===//
+
+  // The tuples of an append-only tile group are inserted but never updated
+  // or deleted. While no insert into it is in flight and none was rolled
+  // back, every slot handed out holds a committed version.
+  inline bool IsAppendOnly() const { return append_only; }
+
+  // Only called before the first insert into the tile group
+  inline void SetAppendOnly() { append_only = true; }
+
+  // Called once an insert is committed, after its version is installed
+  void CommitAppend(const cid_t commit_id);
+
+  // Called once an insert is rolled back, or its slot is left empty. The
+  // slots of the tile group are checked one by one from then on.
+  void AbortAppend();
+
+  // The number of leading tuple slots that are all visible at the read id,
+  // zero if they have to be checked one by one
+  oid_t GetVisibleAppendCount(const cid_t read_id) const;
+
+  //===--------------------------------------------------------------------===//
+  // Retired tile groups
+  //===--------------------------------------------------------------------===//
+
+  // A retired tile group is being compacted: its recycled slots are no longer
+  // handed out, and it is dropped once all of them have been recycled.
+  inline bool IsRetired() const { return retired; }
+
+  inline void Retire() { retired = true; }
+
+  //===--------------------------------------------------------------------===//
+  // Relocating tile groups
+  //===--------------------------------------------------------------------===//
+
+  // A relocating tile group is being copied into another layout. Writers
+  // cannot take ownership of its tuples until the relocation is finished.
+  inline bool IsRelocating() const { return relocating; }
+
+  inline void StartRelocation() { relocating = true; }
+
+  inline void FinishRelocation() { relocating = false; }
+
+  //===--------------------------------------------------------------------===//
+  // Deleted tile groups
+  //===--------------------------------------------------------------------===//
+
+  // A transaction deletes every committed version of a tile group that is
+  // visible at its read id at once. Writers cannot take ownership of the
+  // tuples of a tile group that is being deleted.
+  inline bool IsDeleting() const { return deleting_txn_id != INVALID_TXN_ID; }
+
+  // INVALID_TXN_ID unless a transaction is deleting the tile group
+  inline txn_id_t GetDeletingTransactionId() const { return deleting_txn_id; }
+
+  // MAX_CID until the deleting transaction is committed
+  inline cid_t GetDeletedCommitId() const { return deleted_commit_id; }
+
+  // Returns false if another transaction is deleting the tile group already
+  bool StartDelete(const txn_id_t txn_id, const cid_t read_id);
+
+  // Called once the deleting transaction is committed
+  void CommitDelete(const cid_t commit_id);
+
+  // Called once the deleting transaction is rolled back, or by the GC once
+  // the deleted versions have been recycled
+  void FinishDelete();
+
+  // Whether the delete of the tile group hides the version with the begin
+  // commit id from the transaction
+  bool IsDeletedVersion(const txn_id_t txn_id, const cid_t vis_id,
+                        const cid_t begin_cid) const;
+
+  // Whether the slot holds a committed version that the delete of the tile
+  // group hides
+  bool IsDeletedSlot(const oid_t tuple_slot_id) const;
+
+  //===--------------------------------------------------------------------===//
+  // Access temperature
+  //===--------------------------------------------------------------------===//
+
+  // Only sampled accesses are counted, see TileGroupClassifier
+  inline void IncrementAccessCount() {
+    access_count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // The accesses counted since the last call
+  inline uint64_t TakeAccessCount() { return access_count.exchange(0); }
+
+  // Decayed access count, only read and written by the classifier
+  inline double GetAccessScore() const { return access_score; }
+
+  inline void SetAccessScore(const double score) { access_score = score; }
+
+  // New tile groups are hot until they are classified
+  inline TileGroupTemperature GetTemperature() const { return temperature; }
+
+  inline void SetTemperature(
+      const TileGroupTemperature tile_group_temperature) {
+    temperature = tile_group_temperature;
+  }
+
   // Getter for spin lock
   Spinlock &GetHeaderLock() { return tile_header_lock; }
 
@@ -261,6 +456,9 @@ class TileGroupHeader : public Printable {
   static const size_t reserved_field_offset =
       indirection_offset + sizeof(ItemPointer);
 
+  static_assert(CACHELINE_SIZE % header_entry_size == 0,
+                "tuple headers must not straddle cache lines");
+
  private:
   //===--------------------------------------------------------------------===//
   // Data members
@@ -269,12 +467,15 @@ class TileGroupHeader : public Printable {
   // Backend
   BackendType backend_type;
 
+  // NUMA node the header is placed on, if any
+  int numa_node;
+
   // Associated tile_group
   TileGroup *tile_group;
 
   size_t header_size;
 
-  // set of fixed-length tuple slots
+  // set of fixed-length tuple slots, aligned to a cache line
   char *data;
 
   // number of tuple slots allocated
@@ -286,6 +487,49 @@ class TileGroupHeader : public Printable {
   std::atomic<oid_t> next_tuple_slot;
 
   Spinlock tile_header_lock;
+
+  // bitmap of the slots that were recycled by the GC and can be reused
+  std::unique_ptr<std::atomic<uint64_t>[]> recycled_slots;
+
+  oid_t recycled_slot_word_count;
+
+  // number of bits set in recycled_slots. a slot's bit is always set before
+  // the count is incremented, and cleared before it is decremented.
+  std::atomic<oid_t> recycled_slot_count;
+
+  // INVALID_CID unless this tile group is frozen
+  mutable std::atomic<cid_t> frozen_commit_id;
+
+  bool append_only;
+
+  // inserts into an append-only tile group that are not committed yet
+  std::atomic<oid_t> pending_append_count;
+
+  // newest commit id of the inserts into an append-only tile group
+  std::atomic<cid_t> newest_append_commit_id;
+
+  // set once an insert into an append-only tile group left its slot empty
+  std::atomic<bool> has_empty_append;
+
+  std::atomic<bool> retired;
+
+  std::atomic<bool> relocating;
+
+  // INVALID_TXN_ID unless a transaction is deleting this tile group
+  std::atomic<txn_id_t> deleting_txn_id;
+
+  // read id of the deleting transaction
+  cid_t delete_read_id;
+
+  // MAX_CID until the deleting transaction is committed
+  std::atomic<cid_t> deleted_commit_id;
+
+  // sampled accesses since the last classification
+  std::atomic<uint64_t> access_count;
+
+  double access_score;
+
+  std::atomic<TileGroupTemperature> temperature;
 };
 
 }  // End storage namespace
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_provisioner.h
+//
+// Identification: src/include/storage/tile_group_provisioner.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "type/types.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Provisioner
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background task that keeps a spare tile group ready for every active tile
+ * group of the tables, see DataTable::PrepareTileGroups(). The inserter that
+ * fills an active tile group then swaps in the spare one instead of
+ * allocating and zeroing a new tile group while the others wait.
+ */
+class TileGroupProvisioner {
+ public:
+  TileGroupProvisioner(const TileGroupProvisioner &) = delete;
+  TileGroupProvisioner &operator=(const TileGroupProvisioner &) = delete;
+  TileGroupProvisioner(TileGroupProvisioner &&) = delete;
+  TileGroupProvisioner &operator=(TileGroupProvisioner &&) = delete;
+
+  TileGroupProvisioner();
+
+  ~TileGroupProvisioner();
+
+  // Singleton
+  static TileGroupProvisioner &GetInstance();
+
+  // Start provisioning
+  void Start();
+
+  // Provisioner loop
+  void Provision();
+
+  // Stop provisioning
+  void Stop();
+
+  // Add table to the list of tables to provision
+  void AddTable(DataTable *table);
+
+  // Remove table from the list
+  void DropTable(DataTable *table);
+
+  // Clear list
+  void ClearTables();
+
+  // Create the missing spare tile groups of all tables. Returns the number
+  // of tile groups created.
+  size_t ProvisionTables();
+
+ private:
+  // Tables to provision
+  std::vector<DataTable *> tables;
+
+  std::mutex provisioner_mutex;
+
+  // Stop signal
+  std::atomic<bool> provisioner_stop;
+
+  // Provisioner thread
+  std::thread provisioner_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Provisioner Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Sleeping period (in ms), short so that spares are back before the next
+  // tile group fills
+  oid_t sleep_duration = 10;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
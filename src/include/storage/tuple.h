@@ -125,6 +125,11 @@ class Tuple : public AbstractTuple {
     SetValue(column_id, value, nullptr);
   }
 
+  // Set a value of a tuple that wraps a slot of a tile, which stores short
+  // varlen values in their slot instead of the pool
+  void SetTileValue(const oid_t column_id, const type::Value &value,
+                    type::AbstractPool *data_pool);
+
   inline int GetLength() const { return tuple_schema_->GetLength(); }
 
   // Is the column value null ?
@@ -205,6 +210,10 @@ class Tuple : public AbstractTuple {
   const std::string GetInfo() const;
 
  private:
+  // Set a value, in_tile if the tuple wraps a slot of a tile
+  void SetValue(const oid_t column_id, const type::Value &value,
+                type::AbstractPool *data_pool, bool in_tile);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_expirer.h
+//
+// Identification: src/include/storage/tuple_expirer.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Tuple Expirer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Background task that deletes the tuples whose time to live is over, see
+ * DataTable::SetTimeToLive().
+ *
+ * The zone map of the timestamp column tells which tile groups hold expired
+ * tuples. A tile group whose tuples have all expired is deleted as a whole,
+ * and the GC drops it. The expired tuples of the other tile groups are
+ * deleted one transaction per tile group, and a pass stops after a batch of
+ * tuples, so that the expiry does not show up as a storm of deletes.
+ */
+class TupleExpirer {
+ public:
+  TupleExpirer(const TupleExpirer &) = delete;
+  TupleExpirer &operator=(const TupleExpirer &) = delete;
+  TupleExpirer(TupleExpirer &&) = delete;
+  TupleExpirer &operator=(TupleExpirer &&) = delete;
+
+  TupleExpirer();
+
+  ~TupleExpirer();
+
+  // Singleton
+  static TupleExpirer &GetInstance();
+
+  // Start expiring
+  void Start();
+
+  // Expirer loop
+  void Expire();
+
+  // Stop expiring
+  void Stop();
+
+  // Add table to the list of tables whose tuples can expire
+  void AddTable(DataTable *table);
+
+  // Remove table from the list
+  void DropTable(DataTable *table);
+
+  // Clear list
+  void ClearTables();
+
+  // Delete the tuples of the table that expired at the time (us since the
+  // epoch), up to a batch. Returns the number of tuples deleted.
+  size_t ExpireTable(DataTable *table, const int64_t now);
+
+  // The time of a timestamp value in us since the epoch, in UTC. Returns
+  // false for nulls and values that do not encode a date.
+  static bool GetTimestampTime(const type::Value &value, int64_t &time);
+
+  // Current time in us since the epoch
+  static int64_t GetCurrentTime();
+
+  void SetBatchSize(const size_t batch_size) {
+    expire_batch_size = batch_size;
+  }
+
+ private:
+  // The times of the oldest and the newest timestamps in the column of the
+  // tile group. Returns false if the zone map does not bound them.
+  static bool GetTimeRange(const TileGroup *tile_group, const oid_t column_id,
+                           int64_t &oldest, int64_t &newest);
+
+  // Delete the visible tuples of the tile group at once, if no one writes
+  // them. Returns the number of tuples deleted.
+  static size_t DeleteTileGroup(TileGroup *tile_group);
+
+  // Delete the expired tuples of the tile group in one transaction, skipping
+  // the ones being written. Returns the number of tuples deleted.
+  static size_t ExpireTuples(DataTable *table, TileGroup *tile_group,
+                             const oid_t column_id, const int64_t cutoff);
+
+  // Tables whose tuples can expire
+  std::vector<DataTable *> tables;
+
+  std::mutex expirer_mutex;
+
+  // Stop signal
+  std::atomic<bool> expirer_stop;
+
+  // Expirer thread
+  std::thread expirer_thread;
+
+  //===--------------------------------------------------------------------===//
+  // Expirer Parameters
+  //===--------------------------------------------------------------------===//
+
+  // Tuples deleted per table and pass
+  size_t expire_batch_size = 10000;
+
+  // Sleeping period (in ms)
+  oid_t sleep_duration = 1000;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_serializer.h
+//
+// Identification: src/include/storage/tuple_serializer.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "type/serializeio.h"
+#include "type/types.h"
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace storage {
+
+class TileGroup;
+class Tuple;
+
+typedef std::map<oid_t, std::pair<oid_t, oid_t>> column_map_type;
+
+//===--------------------------------------------------------------------===//
+// Tuple Serializer
+//===--------------------------------------------------------------------===//
+
+/**
+ * Serializes tuples straight from their storage, into the same bytes as
+ * Value::SerializeTo() of every column in order, without building Values.
+ *
+ * Fixed-width columns serialize to their storage bytes, so runs of them that
+ * are next to each other in a tile are copied at once. Varlen columns are
+ * read from their slot. Their size is known up front, so a tuple is written
+ * into space reserved once in the output, be that a log buffer or a network
+ * buffer, without intermediate copies. Columns of other types go through
+ * their Values.
+ */
+class TupleSerializer {
+ public:
+  // For tuples of the schema, whose data is in a single location
+  explicit TupleSerializer(const catalog::Schema &schema);
+
+  // For tuples whose columns are spread over tiles of the schemas by the
+  // column map, like the ones of a tile group
+  TupleSerializer(const std::vector<catalog::Schema> &tile_schemas,
+                  const column_map_type &column_map);
+
+  // Serialize the tuple whose data in tile i is at tile_locations[i]
+  void SerializeTo(const char *const *tile_locations,
+                   SerializeOutput &output) const;
+
+  // Serialize a tuple of the schema
+  void SerializeTo(const Tuple &tuple, SerializeOutput &output) const;
+
+  // Serialize a tuple of the tile group, or the ones in [begin, end) back to
+  // back
+  void SerializeTo(const TileGroup *tile_group, const oid_t tuple_offset,
+                   SerializeOutput &output) const;
+  void SerializeRangeTo(const TileGroup *tile_group, const oid_t begin,
+                        const oid_t end, SerializeOutput &output) const;
+
+  // The number of bytes the tuple serializes to
+  size_t GetSerializedSize(const char *const *tile_locations) const;
+
+ private:
+  enum class SegmentType {
+    FIXED,   // columns copied as they are stored
+    VARLEN,  // a varlen slot, written as its length and data
+    VALUE,   // a column serialized through its Value
+  };
+
+  // Consecutive columns serialized together
+  struct Segment {
+    SegmentType type;
+    oid_t tile_offset;
+    // Of the column data in the tuple of the tile, and its length for FIXED
+    size_t offset;
+    size_t length;
+    type::TypeId type_id;
+    bool is_inlined;
+  };
+
+  void AddColumn(const catalog::Schema &schema, const oid_t tile_offset,
+                 const oid_t column_id);
+
+  std::vector<Segment> segments_;
+
+  // The bytes of all FIXED segments
+  size_t fixed_size_ = 0;
+
+  // Whether there is no VALUE segment, so that the size of a tuple is known
+  // before it is written
+  bool is_native_ = true;
+
+  oid_t tile_count_ = 1;
+};
+
+}  // namespace storage
+}  // namespace peloton
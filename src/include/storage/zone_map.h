@@ -0,0 +1,117 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.h
+//
+// Identification: src/include/storage/zone_map.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/platform.h"
+#include "common/printable.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+}
+
+namespace expression {
+class AbstractExpression;
+}
+
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Zone Map
+//===--------------------------------------------------------------------===//
+
+/**
+ * Per-column min/max values and null counts of a tile group.
+ *
+ * The zone map only ever widens: it covers every value that was written into
+ * the tile group, including older versions and deleted tuples. It is
+ * therefore conservative and can only be used to prove that a tile group
+ * contains no tuple satisfying a predicate.
+ */
+class ZoneMap : public Printable {
+  ZoneMap() = delete;
+  ZoneMap(ZoneMap const &) = delete;
+
+ public:
+  ZoneMap(const oid_t column_count);
+
+  // Widen the zone map of the column to cover the value
+  void Widen(const oid_t column_id, const type::Value &value);
+
+  // Widen the zone map to cover all the values of another zone map
+  void Merge(const ZoneMap &other);
+
+  // Count nulls written into the column
+  void AddNullCount(const oid_t column_id, const size_t null_count);
+
+  // Returns false if no tuple in the tile group can satisfy the predicate.
+  // Parameter values are resolved through the executor context if given.
+  bool CanSatisfy(const expression::AbstractExpression *predicate,
+                  executor::ExecutorContext *executor_context = nullptr) const;
+
+  // Returns true if every tuple in the tile group satisfies the predicate,
+  // which only holds if every value ever written into it does.
+  bool SatisfiesAll(
+      const expression::AbstractExpression *predicate,
+      executor::ExecutorContext *executor_context = nullptr) const;
+
+  // Split a comparison of a column of the scanned tuple with a constant or a
+  // parameter into its parts, mirrored so that the column is on the left hand
+  // side. Returns false for comparisons of any other form.
+  static bool GetColumnComparison(
+      const expression::AbstractExpression *predicate,
+      executor::ExecutorContext *executor_context,
+      ExpressionType &comparison_type, oid_t &column_id, type::Value &value);
+
+  type::Value GetMinValue(const oid_t column_id) const;
+
+  type::Value GetMaxValue(const oid_t column_id) const;
+
+  size_t GetNullCount(const oid_t column_id) const;
+
+  // Returns false if no null was ever written into any column
+  bool HasNulls() const;
+
+  inline oid_t GetColumnCount() const { return column_count_; }
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const;
+
+ private:
+  bool CanSatisfyComparison(const ExpressionType comparison_type,
+                            const oid_t column_id,
+                            const type::Value &value) const;
+
+  bool SatisfiesAllComparison(const ExpressionType comparison_type,
+                              const oid_t column_id,
+                              const type::Value &value) const;
+
+  oid_t column_count_;
+
+  // min/max are INVALID-typed until the first non-null value is written
+  std::vector<type::Value> min_values_;
+  std::vector<type::Value> max_values_;
+
+  std::vector<size_t> null_counts_;
+
+  mutable Spinlock zone_map_lock_;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
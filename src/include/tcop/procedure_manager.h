@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// procedure_manager.h
+//
+// Identification: src/include/tcop/procedure_manager.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace peloton {
+
+class Statement;
+
+namespace tcop {
+
+//===--------------------------------------------------------------------===//
+// A stored procedure: the statements a call runs in one transaction, whose
+// parameters $1 .. $n are the arguments of the call
+//===--------------------------------------------------------------------===//
+struct Procedure {
+  std::string name;
+
+  std::vector<std::string> queries;
+
+  size_t parameter_count = 0;
+};
+
+// The statements of a procedure prepared for a version of the catalog. A call
+// takes them out of the procedure manager while it executes them, as binding
+// the arguments writes them into the plans.
+struct PreparedProcedure {
+  std::shared_ptr<const Procedure> procedure;
+
+  uint64_t catalog_version = 0;
+
+  std::vector<std::shared_ptr<Statement>> statements;
+};
+
+//===--------------------------------------------------------------------===//
+// The process-wide registry of the stored procedures and of their prepared
+// statements, so that a call neither parses nor plans its statements. The
+// plans are compiled by the query cache of the codegen like any other.
+//===--------------------------------------------------------------------===//
+class ProcedureManager {
+ public:
+  // The most prepared statements kept for a procedure
+  static constexpr size_t kMaxPreparedPerProcedure = 16;
+
+  ProcedureManager(const ProcedureManager &) = delete;
+  ProcedureManager &operator=(const ProcedureManager &) = delete;
+
+  // Singleton
+  static ProcedureManager &GetInstance();
+
+  // Register the procedure, in place of the one with the same name
+  void CreateProcedure(std::shared_ptr<const Procedure> procedure);
+
+  // Returns false if there is no procedure with the name
+  bool DropProcedure(const std::string &name);
+
+  // The procedure with the name, or null
+  std::shared_ptr<const Procedure> GetProcedure(const std::string &name);
+
+  // Take statements of the procedure prepared for the version of the catalog
+  // out of the manager, or null. The ones of older versions are dropped.
+  std::unique_ptr<PreparedProcedure> Acquire(const std::string &name,
+                                             uint64_t catalog_version);
+
+  // Put the statements back once the call finished with them
+  void Release(std::unique_ptr<PreparedProcedure> prepared);
+
+  // Drop all procedures
+  void Clear();
+
+  // The number of registered procedures
+  size_t GetCount();
+
+  // Split the body of a procedure into its statements at the semicolons
+  // outside of quotes, and find the highest parameter they use
+  static std::vector<std::string> SplitQueries(const std::string &body,
+                                               size_t &parameter_count);
+
+ private:
+  ProcedureManager() {}
+
+  struct Entry {
+    std::shared_ptr<const Procedure> procedure;
+
+    std::vector<std::unique_ptr<PreparedProcedure>> prepared;
+  };
+
+  // Guards the procedures
+  std::mutex mutex_;
+
+  std::unordered_map<std::string, Entry> procedures_;
+};
+
+}  // End tcop namespace
+}  // End peloton namespace
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// result_cache.h
+//
+// Identification: src/include/tcop/result_cache.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/concurrent_cache.h"
+#include "common/statement.h"
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace tcop {
+
+//===----------------------------------------------------------------------===//
+// The rows a SELECT returned, and the versions of the catalog and of the
+// tables it read when it started
+//===----------------------------------------------------------------------===//
+struct CachedResult {
+  uint64_t catalog_version;
+  std::vector<std::pair<oid_t, uint64_t>> table_versions;
+
+  std::vector<FieldInfo> tuple_descriptor;
+  std::vector<StatementResult> rows;
+  int rows_changed;
+};
+
+//===----------------------------------------------------------------------===//
+// The process-wide cache of the results of single statement SELECTs, keyed by
+// the parameterized text of the queries and the values of their parameters.
+//
+// Every table has a version that is bumped by the transactions writing to it
+// once they have installed their versions. A result is only handed out while
+// the tables it read are still at the versions taken before its transaction
+// started, so it is what running the query again would return. Tables share
+// the version of their slot, a write to one only drops the results of the
+// others more often.
+//
+// The capacity is a number of rows, a result with more rows than fit in one
+// shard is not kept.
+//===----------------------------------------------------------------------===//
+class ResultCache {
+ public:
+  static constexpr size_t kShardCount = 16;
+
+  static constexpr size_t kVersionSlotCount = 1024;
+
+  ResultCache(const ResultCache &) = delete;
+  ResultCache &operator=(const ResultCache &) = delete;
+  ResultCache(ResultCache &&) = delete;
+  ResultCache &operator=(ResultCache &&) = delete;
+
+  // Singleton
+  static ResultCache &GetInstance();
+
+  // The key of a query with the given parameters
+  static std::string GetKey(const std::string &query,
+                            const std::vector<type::Value> &params);
+
+  // The result cached with the key, or null if there is none or it's stale.
+  // A stale result is dropped.
+  std::shared_ptr<CachedResult> Find(const std::string &key,
+                                     uint64_t catalog_version);
+
+  // Cache the result of a query, unless it is too large
+  void Insert(const std::string &key, std::shared_ptr<CachedResult> result);
+
+  // The most rows of a result that is cached
+  size_t GetMaxResultRows() const {
+    return cache_.GetCapacity() / kShardCount - 1;
+  }
+
+  // The current versions of the tables, to be taken before the transaction
+  // reading them starts
+  std::vector<std::pair<oid_t, uint64_t>> GetTableVersions(
+      const std::set<oid_t> &table_oids) const;
+
+  // Bump the versions of the tables the committing transaction wrote to,
+  // after it has installed its versions
+  void RecordCommit(concurrency::Transaction *txn);
+
+  void BumpTableVersion(oid_t table_oid);
+
+  // Drop all results
+  void Clear();
+
+  // The number of cached results
+  size_t GetCount() const;
+
+  uint64_t GetHitCount() const { return hit_count_; }
+
+ private:
+  ResultCache();
+
+  std::atomic<uint64_t> &GetVersionSlot(oid_t table_oid) {
+    return table_versions_[table_oid % kVersionSlotCount];
+  }
+
+ private:
+  ConcurrentCache<std::string, CachedResult> cache_;
+
+  std::array<std::atomic<uint64_t>, kVersionSlotCount> table_versions_;
+
+  std::atomic<uint64_t> hit_count_;
+};
+
+}  // namespace tcop
+}  // namespace peloton
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_router.h
+//
+// Identification: src/include/tcop/shard_router.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/statement.h"
+#include "type/types.h"
+
+namespace peloton {
+
+namespace parser {
+class SelectStatement;
+class SQLStatement;
+}
+
+namespace tcop {
+
+class TrafficCop;
+
+enum class ShardTargetType {
+  LOCAL,   // only this node, the statement does not use sharded tables
+  SINGLE,  // the one shard that has the rows of the statement
+  ALL      // every shard
+};
+
+// The shards a statement reads or writes
+struct ShardTarget {
+  ShardTargetType type = ShardTargetType::LOCAL;
+
+  size_t node_id = 0;
+
+  bool is_write = false;
+};
+
+// The rows a shard returned for a statement, as text. NULL is empty.
+struct ShardResult {
+  std::vector<FieldInfo> columns;
+
+  std::vector<std::vector<std::string>> rows;
+
+  int rows_changed = 0;
+};
+
+//===--------------------------------------------------------------------===//
+// Shard Router
+//===--------------------------------------------------------------------===//
+
+// Executes the statements of a connection on the shards of the sharded tables
+// they use. A statement that selects its shard key runs on that shard only,
+// any other goes to every shard, and a SELECT over several shards is
+// aggregated on every shard and merged here. The statements of a transaction
+// block run in a distributed transaction on the nodes they touch, which
+// commits with two phases: the commit of this node decides the transaction
+// once every other node prepared it.
+class ShardRouter {
+ public:
+  ShardRouter(TrafficCop &traffic_cop);
+
+  // Aborts the distributed transaction that is still open
+  ~ShardRouter();
+
+  // Execute the statement on the shards it uses. Returns false if it only
+  // uses this node, which then executes it as usual.
+  bool ExecuteStatement(const std::string &query,
+                        std::vector<StatementResult> &result,
+                        std::vector<FieldInfo> &tuple_descriptor,
+                        int &rows_changed, std::string &error_message,
+                        ResultType &status);
+
+  // The other nodes in the open distributed transaction
+  const std::set<size_t> &GetParticipants() const { return participants_; }
+
+  // Find the shards of the statement. Returns false if it cannot be
+  // executed on the shards.
+  static bool GetTarget(parser::SQLStatement *statement, ShardTarget &target,
+                        std::string &error_message);
+
+  // Merge the rows the shards returned for the SELECT. Returns false if they
+  // cannot be merged.
+  static bool MergeResults(const parser::SelectStatement &select,
+                           const std::vector<ShardResult> &shard_results,
+                           ShardResult &merged, std::string &error_message);
+
+ private:
+  // Execute on this node without routing
+  ResultType ExecuteLocal(const std::string &query, ShardResult &shard_result,
+                          std::string &error_message);
+
+  // Execute on every node in the target and merge the rows
+  ResultType ExecuteOnShards(parser::SQLStatement *statement,
+                             const std::string &query,
+                             const ShardTarget &target, ShardResult &merged,
+                             std::string &error_message);
+
+  // The id of the distributed transaction, new for the first statement of
+  // the transaction block that goes to another node
+  int64_t GetTransactionId();
+
+  ResultType CommitTransaction(std::string &error_message);
+
+  ResultType AbortTransaction(std::string &error_message);
+
+  // Send the second phase to the other nodes and close the transaction
+  void FinishTransaction(const bool commit);
+
+  TrafficCop &traffic_cop_;
+
+  int64_t transaction_id_ = 0;
+
+  std::set<size_t> participants_;
+};
+
+}  // End tcop namespace
+}  // End peloton namespace
@@ -14,6 +14,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <functional>
 #include <mutex>
 #include <stack>
 #include <vector>
@@ -29,7 +30,21 @@
 
 namespace peloton {
 
+namespace logging {
+class CommitWaiter;
+}
+
 namespace tcop {
+
+class ShardRouter;
+struct Procedure;
+struct PreparedProcedure;
+
+// Takes the complete rows of the result of a statement with the given columns
+// while the statement executes
+typedef std::function<void(const std::vector<FieldInfo> &,
+                           std::vector<StatementResult> &)> RowsCallback;
+
 //===--------------------------------------------------------------------===//
 // TRAFFIC COP
 //===--------------------------------------------------------------------===//
@@ -47,6 +62,42 @@ class TrafficCop {
   // reset this object
   void Reset();
 
+  // Hand the rows of the statements executed from now on to the callback in
+  // chunks while they execute, or buffer all of them if it is empty
+  void SetRowsCallback(RowsCallback callback) {
+    rows_callback_ = std::move(callback);
+  }
+
+  const RowsCallback &GetRowsCallback() const { return rows_callback_; }
+
+  // Wait for the transactions committed from now on to become durable with
+  // the waiter, or don't track them if it is null. They are committed through
+  // group commit either way.
+  void SetCommitWaiter(std::shared_ptr<logging::CommitWaiter> commit_waiter) {
+    commit_waiter_ = std::move(commit_waiter);
+  }
+
+  // Execute the statements over sharded tables on their shards, or only on
+  // this node if disabled, as for the statements other nodes send here
+  void SetShardRouting(const bool route_shards) {
+    route_shards_ = route_shards;
+  }
+
+  // The transaction of the open transaction block, nullptr if there is none
+  concurrency::Transaction *GetRunningTransaction() {
+    return tcop_txn_state_.empty() ? nullptr : tcop_txn_state_.top().first;
+  }
+
+  // The result so far of the open transaction block, INVALID if there is none
+  ResultType GetRunningTransactionResult() {
+    return tcop_txn_state_.empty() ? ResultType::INVALID
+                                   : tcop_txn_state_.top().second;
+  }
+
+  // Abort the transaction of the open transaction block, which stays open
+  // until it is rolled back
+  void AbortRunningTransaction();
+
   // PortalExec - Execute query string
   ResultType ExecuteStatement(const std::string &query,
                               std::vector<StatementResult> &result,
@@ -63,13 +114,26 @@ class TrafficCop {
       std::vector<StatementResult> &result, int &rows_change,
       std::string &error_message, const size_t thread_id = 0);
 
+  // Run the statements of the stored procedure with the arguments as its
+  // parameters in one transaction, the one of the open transaction block if
+  // there is one. The rows are those of its last statement returning rows.
+  ResultType ExecuteProcedure(const std::string &name,
+                              const std::vector<type::Value> &params,
+                              std::vector<StatementResult> &result,
+                              std::vector<FieldInfo> &tuple_descriptor,
+                              int &rows_changed, std::string &error_message,
+                              const size_t thread_id = 0);
+
   // ExecutePrepStmt - Helper to handle txn-specifics for the plan-tree of a
   // statement
   executor::ExecuteResult ExecuteStatementPlan(
       std::shared_ptr<planner::AbstractPlan> plan,
       const std::vector<type::Value> &params,
       std::vector<StatementResult> &result,
-      const std::vector<int> &result_format, const size_t thread_id = 0);
+      const std::vector<int> &result_format, const size_t thread_id = 0,
+      Statement *statement = nullptr,
+      const ResultCallback *callback = nullptr,
+      executor::ExecutorProfile *profile = nullptr);
 
   // InitBindPrepStmt - Prepare and bind a query from a query string
   std::shared_ptr<Statement> PrepareStatement(const std::string &statement_name,
@@ -92,6 +156,17 @@ class TrafficCop {
   // The optimizer used for this connection
   std::unique_ptr<optimizer::AbstractOptimizer> optimizer_;
 
+  // Takes the rows of the executing statement, if set
+  RowsCallback rows_callback_;
+
+  // Tracks the commits of the client until they are durable, if set
+  std::shared_ptr<logging::CommitWaiter> commit_waiter_;
+
+  bool route_shards_ = true;
+
+  // Executes the statements over sharded tables, created on first use
+  std::unique_ptr<ShardRouter> shard_router_;
+
   // pair of txn ptr and the result so-far for that txn
   // use a stack to support nested-txns
   typedef std::pair<concurrency::Transaction *, ResultType> TcopTxnState;
@@ -102,12 +177,45 @@ class TrafficCop {
 
   TcopTxnState &GetCurrentTxnState();
 
-  ResultType BeginQueryHelper(const size_t thread_id);
+  ResultType BeginQueryHelper(
+      const size_t thread_id, const bool read_only = false,
+      const IsolationLevelType isolation = IsolationLevelType::INVALID);
 
   ResultType CommitQueryHelper();
 
+  // Commit the transaction through group commit. Its acknowledgement is
+  // held by the commit waiter until its epoch is durable.
+  ResultType CommitTransaction(concurrency::Transaction *txn);
+
   ResultType AbortQueryHelper();
 
+  // Return the plan of an EXPLAIN as its rows, one per plan node. EXPLAIN
+  // ANALYZE runs the plan and adds what every node did.
+  ResultType ExplainStatementPlan(const std::shared_ptr<Statement> &statement,
+                                  const std::vector<type::Value> &params,
+                                  std::vector<StatementResult> &result,
+                                  int &rows_changed, const size_t thread_id);
+
+  // Record the statement in the command log of the transaction, or have the
+  // transaction logged by value if it cannot be replayed from there
+  void LogCommand(concurrency::Transaction *txn,
+                  const planner::AbstractPlan *plan, Statement *statement,
+                  const std::vector<type::Value> &params);
+
+  // Execute CREATE PROCEDURE name AS query; ..., DROP PROCEDURE name and
+  // CALL name(arguments), which the parser does not know. Returns false if
+  // the query is none of them.
+  bool ExecuteProcedureCommand(const std::string &query,
+                               std::vector<StatementResult> &result,
+                               std::vector<FieldInfo> &tuple_descriptor,
+                               int &rows_changed, std::string &error_message,
+                               const size_t thread_id, ResultType &status);
+
+  // Prepare the statements of the procedure, or null if one cannot run in it
+  std::unique_ptr<PreparedProcedure> PrepareProcedure(
+      std::shared_ptr<const Procedure> procedure, uint64_t catalog_version,
+      std::string &error_message);
+
   // Get all data tables from a TableRef.
   // For multi-way join
   // still a HACK
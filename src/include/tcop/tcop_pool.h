@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tcop_pool.h
+//
+// Identification: src/include/tcop/tcop_pool.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "configuration/configuration.h"
+
+namespace peloton {
+namespace tcop {
+
+class TrafficCop;
+
+//===----------------------------------------------------------------------===//
+// The traffic cops the connections share if FLAGS_execution_contexts is set.
+// A connection takes one when a transaction starts and gives it back when
+// the transaction ends, so that many mostly idle connections only need as
+// many optimizers and transaction states as there are open transactions.
+//===----------------------------------------------------------------------===//
+class TrafficCopPool {
+ public:
+  TrafficCopPool(const TrafficCopPool &) = delete;
+  TrafficCopPool &operator=(const TrafficCopPool &) = delete;
+  TrafficCopPool(TrafficCopPool &&) = delete;
+  TrafficCopPool &operator=(TrafficCopPool &&) = delete;
+
+  // Singleton
+  static TrafficCopPool &GetInstance();
+
+  bool IsEnabled() const { return FLAGS_execution_contexts > 0; }
+
+  // Take a traffic cop, creating one if fewer than FLAGS_execution_contexts
+  // exist and waiting for one to be given back otherwise
+  TrafficCop *Acquire();
+
+  // Give back a traffic cop that has no open transaction
+  void Release(TrafficCop *traffic_cop);
+
+  // The number of traffic cops created, and of those not taken
+  size_t GetCount();
+  size_t GetFreeCount();
+
+ private:
+  TrafficCopPool() {}
+
+ private:
+  std::vector<std::unique_ptr<TrafficCop>> traffic_cops_;
+
+  std::vector<TrafficCop *> free_traffic_cops_;
+
+  std::mutex pool_mutex_;
+
+  std::condition_variable released_;
+};
+
+}  // namespace tcop
+}  // namespace peloton
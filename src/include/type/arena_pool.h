@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_pool.h
+//
+// Identification: src/include/type/arena_pool.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/macros.h"
+#include "common/memory_tracker.h"
+#include "type/abstract_pool.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "common/platform.h"
+
+namespace peloton {
+namespace type {
+
+// A bump-pointer memory pool for varlen data that is only released as a
+// whole, when the pool is destroyed. Allocations from concurrent threads only
+// contend on an atomic offset; the lock is taken when a chunk runs out.
+class ArenaPool : public AbstractPool {
+  struct Chunk {
+    Chunk(size_t size) : data(new char[size]), size(size), offset(0) {}
+
+    std::unique_ptr<char[]> data;
+    size_t size;
+    std::atomic<size_t> offset;
+  };
+
+public:
+
+  ArenaPool(size_t chunk_size = kDefaultChunkSize)
+      : chunk_size_(chunk_size),
+        current_chunk_(nullptr),
+        allocated_size_(0),
+        is_tracked_(false),
+        component_(MemoryComponentType::VARLEN_POOL) {}
+
+  // A pool whose chunks are charged to the component of the memory tracker
+  ArenaPool(MemoryComponentType component,
+            size_t chunk_size = kDefaultChunkSize)
+      : chunk_size_(chunk_size),
+        current_chunk_(nullptr),
+        allocated_size_(0),
+        is_tracked_(true),
+        component_(component) {}
+
+  // Destroy this pool, and all memory it owns.
+  ~ArenaPool() {
+    if (is_tracked_) {
+      MemoryTracker::Release(component_, allocated_size_);
+    }
+  }
+
+  // Allocate a contiguous block of memory of the given size. If the allocation
+  // is successful a non-null pointer is returned. If the allocation fails, a
+  // null pointer will be returned.
+  void *Allocate(size_t size){
+    // keep the blocks 8-byte aligned
+    size = (size + 7) & ~static_cast<size_t>(7);
+
+    // large blocks would waste most of a chunk
+    if (size > chunk_size_ / 4) {
+      pool_lock_.Lock(WaitEventType::POOL_LATCH);
+      chunks_.emplace_back(new Chunk(size));
+      auto location = chunks_.back()->data.get();
+      AddChunkSize(size);
+      pool_lock_.Unlock();
+      return location;
+    }
+
+    while (true) {
+      Chunk *chunk = current_chunk_.load();
+      if (chunk != nullptr) {
+        auto offset = chunk->offset.fetch_add(size);
+        if (offset + size <= chunk->size) {
+          return chunk->data.get() + offset;
+        }
+      }
+
+      // the chunk is full. the first thread to get here installs a new one.
+      pool_lock_.Lock(WaitEventType::POOL_LATCH);
+      if (current_chunk_.load() == chunk) {
+        chunks_.emplace_back(new Chunk(chunk_size_));
+        AddChunkSize(chunk_size_);
+        current_chunk_ = chunks_.back().get();
+      }
+      pool_lock_.Unlock();
+    }
+  }
+
+  // Blocks are not reused, the memory is released with the pool.
+  void Free(UNUSED_ATTRIBUTE void *ptr) {}
+
+  // Total size of the chunks owned by the pool
+  size_t GetAllocatedSize() {
+    pool_lock_.Lock(WaitEventType::POOL_LATCH);
+    auto allocated_size = allocated_size_;
+    pool_lock_.Unlock();
+    return allocated_size;
+  }
+
+  static const size_t kDefaultChunkSize = 64 * 1024;
+
+private:
+  // Count a new chunk, holding the lock
+  void AddChunkSize(size_t size) {
+    allocated_size_ += size;
+    if (is_tracked_) {
+      MemoryTracker::Allocate(component_, size);
+    }
+  }
+
+  size_t chunk_size_;
+
+  // Chunk that allocations are currently carved from
+  std::atomic<Chunk *> current_chunk_;
+
+  // All chunks owned by the pool
+  std::vector<std::unique_ptr<Chunk>> chunks_;
+
+  size_t allocated_size_;
+
+  // Spin lock protecting the chunk list
+  Spinlock pool_lock_;
+
+  // Whether the chunks are charged to the component
+  bool is_tracked_;
+  MemoryComponentType component_;
+};
+
+// An allocator for standard containers that draws from an arena. Nothing is
+// released before the arena is destroyed, so it suits containers that only
+// grow and are dropped as a whole, like the hash tables of a query.
+template <typename T>
+class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  // The container moves and copies along with its arena
+  typedef std::true_type propagate_on_container_copy_assignment;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  ArenaAllocator(ArenaPool *pool) : pool_(pool) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : pool_(other.GetPool()) {}
+
+  T *allocate(size_t n) {
+    static_assert(alignof(T) <= 8, "the arena only aligns to 8 bytes");
+    return static_cast<T *>(pool_->Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(UNUSED_ATTRIBUTE T *ptr, UNUSED_ATTRIBUTE size_t n) {}
+
+  ArenaPool *GetPool() const { return pool_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &other) const {
+    return pool_ == other.GetPool();
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U> &other) const {
+    return pool_ != other.GetPool();
+  }
+
+private:
+  ArenaPool *pool_;
+};
+
+}  // namespace type
+}  // namespace peloton
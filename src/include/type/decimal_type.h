@@ -17,6 +17,8 @@
 namespace peloton {
 namespace type {
 
+// DECIMAL values are stored and computed as doubles. The catalog keeps no
+// precision or scale for them.
 class DecimalType : public NumericType {
  public:
 
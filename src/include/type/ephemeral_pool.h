@@ -36,7 +36,7 @@ public:
   // Destroy this pool, and all memory it owns.
   ~EphemeralPool(){
 
-    pool_lock_.Lock();
+    pool_lock_.Lock(WaitEventType::POOL_LATCH);
     for(auto location: locations_){
       delete[] location;
     }
@@ -50,7 +50,7 @@ public:
   void *Allocate(size_t size){
     auto location = new char[size];
 
-    pool_lock_.Lock();
+    pool_lock_.Lock(WaitEventType::POOL_LATCH);
     locations_.insert(location);
     pool_lock_.Unlock();
 
@@ -60,7 +60,7 @@ public:
   // Returns the provided chunk of memory back into the pool
   void Free(UNUSED_ATTRIBUTE void *ptr) {
     char *cptr = (char *) ptr;
-    pool_lock_.Lock();
+    pool_lock_.Lock(WaitEventType::POOL_LATCH);
     locations_.erase(cptr);
     pool_lock_.Unlock();
     delete [] cptr;
@@ -48,6 +48,19 @@ class SerializeInput {
   inline float ReadFloat() { return ReadPrimitive<float>(); }
   inline double ReadDouble() { return ReadPrimitive<double>(); }
 
+  // an unsigned integer of 7 bits per byte, lowest first
+  inline uint64_t ReadVarInt() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = ReadPrimitive<uint8_t>();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        break;
+      }
+    }
+    return value;
+  }
+
   /** Returns a pointer to the internal data buffer, advancing the read position by length. */
   const void* getRawPointer(size_t length) {
     const void* result = current_;
@@ -154,6 +167,15 @@ class SerializeOutput {
   inline void WriteLong(int64_t value) { WritePrimitive(value); }
   inline void WriteFloat(float value) { WritePrimitive(value); }
   inline void WriteDouble(double value) { WritePrimitive(value); }   
+
+  // small values take a single byte, see SerializeInput::ReadVarInt
+  inline void WriteVarInt(uint64_t value) {
+    while (value >= 0x80) {
+      WritePrimitive(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    WritePrimitive(static_cast<uint8_t>(value));
+  }
   inline void WriteEnumInSingleByte(int value) {
     PL_ASSERT(std::numeric_limits<int8_t>::min() <= value &&
       value <= std::numeric_limits<int8_t>::max());
@@ -215,6 +237,12 @@ class SerializeOutput {
     return offset;
   }
 
+  /** Reserves length bytes of space and returns where they start, for writing them in
+  place. The pointer is valid until the next write that expands the buffer. */
+  char *ReserveBuffer(size_t length) {
+    return buffer_ + ReserveBytes(length);
+  }
+
   /** Copies length bytes from value to this buffer, starting at offset. Offset should have been
   obtained from reserveBytes. This does not affect the current write position.
   * @return offset + length
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <bitset>
 #include <climits>
 #include <cstdint>
@@ -201,6 +202,7 @@ enum class ExpressionType {
   AGGREGATE_MIN = 53,
   AGGREGATE_MAX = 54,
   AGGREGATE_AVG = 55,
+  AGGREGATE_APPROX_COUNT_DISTINCT = 56,
 
   // -----------------------------
   // Functions
@@ -352,6 +354,11 @@ enum class NetworkMessageType : unsigned char {
   READY_FOR_QUERY = 'Z',
   ROW_DESCRIPTION = 'T',
   DATA_ROW = 'D',
+  PORTAL_SUSPENDED = 's',
+  COPY_IN_RESPONSE = 'G',
+  COPY_OUT_RESPONSE = 'H',
+  COPY_DATA = 'd',
+  COPY_DONE = 'c',
   // Errors
   HUMAN_READABLE_ERROR = 'M',
   SQLSTATE_CODE_ERROR = 'C',
@@ -364,6 +371,7 @@ enum class NetworkMessageType : unsigned char {
   PARSE_COMMAND = 'P',
   SIMPLE_QUERY_COMMAND = 'Q',
   CLOSE_COMMAND = 'C',
+  COPY_FAIL_COMMAND = 'f',
   // SSL willingness
   SSL_YES = 'S',
   SSL_NO = 'N',
@@ -386,7 +394,9 @@ enum SqlStateErrorCode {
 
 enum class ProtocolType {
   INVALID = INVALID_TYPE_ID,
-  TIMESTAMP_ORDERING = 1  // timestamp ordering
+  TIMESTAMP_ORDERING = 1,  // timestamp ordering
+  OPTIMISTIC = 2,          // optimistic concurrency control
+  PARTITIONED = 3          // partitioned execution
 };
 std::string ProtocolTypeToString(ProtocolType type);
 ProtocolType StringToProtocolType(const std::string &str);
@@ -468,6 +478,17 @@ std::string ConflictAvoidanceTypeToString(ConflictAvoidanceType type);
 ConflictAvoidanceType StringToConflictAvoidanceType(const std::string &str);
 std::ostream &operator<<(std::ostream &os, const ConflictAvoidanceType &type);
 
+enum class ConflictType {
+  INVALID = INVALID_TYPE_ID,  // aborted without a conflict
+  WRITE_WRITE = 1,  // version owned or overwritten by another transaction
+  READ_WRITE = 2,   // version to write read by a later transaction
+  WRITE_READ = 3,   // version to read owned by another transaction
+  VALIDATION = 4    // version read changed before the commit
+};
+std::string ConflictTypeToString(ConflictType type);
+ConflictType StringToConflictType(const std::string &str);
+std::ostream &operator<<(std::ostream &os, const ConflictType &type);
+
 //===--------------------------------------------------------------------===//
 // Garbage Collection Types
 //===--------------------------------------------------------------------===//
@@ -490,7 +511,8 @@ enum class BackendType {
   MM = 1,                     // on volatile memory
   NVM = 2,                    // on non-volatile memory
   SSD = 3,                    // on ssd
-  HDD = 4                     // on hdd
+  HDD = 4,                    // on hdd
+  HUGE_PAGE = 5               // on volatile memory backed by huge pages
 };
 std::string BackendTypeToString(BackendType type);
 BackendType StringToBackendType(const std::string &str);
@@ -504,7 +526,8 @@ enum class IndexType {
   INVALID = INVALID_TYPE_ID,  // invalid index type
   BWTREE = 1,                 // bwtree
   HASH = 2,                   // hash
-  SKIPLIST = 3                // skiplist
+  SKIPLIST = 3,               // skiplist
+  ART = 4                     // adaptive radix tree
 };
 std::string IndexTypeToString(IndexType type);
 IndexType StringToIndexType(const std::string &str);
@@ -584,6 +607,7 @@ enum class PlanNodeType {
   ABSTRACT_SCAN = 10,
   SEQSCAN = 11,
   INDEXSCAN = 12,
+  AGGREGATE_VIEW_SCAN = 13,
 
   // Join Nodes
   NESTLOOP = 20,
@@ -606,6 +630,7 @@ enum class PlanNodeType {
   SEND = 40,
   RECEIVE = 41,
   PRINT = 42,
+  EXCHANGE = 43,
 
   // Algebra Nodes
   AGGREGATE = 50,
@@ -619,6 +644,7 @@ enum class PlanNodeType {
   APPEND = 59,  // append
   AGGREGATE_V2 = 61,
   HASH = 62,
+  WINDOW = 63,
 
   // Utility
   RESULT = 70,
@@ -640,7 +666,8 @@ enum class CreateType {
   DB = 1,                     // db create type
   TABLE = 2,                  // table create type
   INDEX = 3,                  // index create type
-  CONSTRAINT = 4              // constraint create type
+  CONSTRAINT = 4,             // constraint create type
+  VIEW = 5                    // materialized view create type
 };
 
 //===--------------------------------------------------------------------===//
@@ -661,7 +688,8 @@ enum class StatementType {
   ALTER = 12,                 // alter statement type
   TRANSACTION = 13,           // transaction statement type,
   COPY = 14,                  // copy type
-  ANALYZE = 15                // analyze type
+  ANALYZE = 15,               // analyze type
+  EXPLAIN = 16                // explain type
 };
 std::string StatementTypeToString(StatementType type);
 StatementType StringToStatementType(const std::string &str);
@@ -681,6 +709,7 @@ enum class QueryType {
   QUERY_SHOW,                 // show query
   QUERY_PREPARE,	      // prepare query
   QUERY_EXECUTE, 	      // execute query
+  QUERY_COPY,                 // copy query
   QUERY_OTHER,                // other queries
 };
 
@@ -894,6 +923,9 @@ enum class LogRecordType {
   TUPLE_DELETE = 12,
   TUPLE_UPDATE = 13,
 
+  // Statement of a command logged transaction
+  COMMAND = 14,
+
   // Epoch related records
   EPOCH_BEGIN = 21,
   EPOCH_END = 22,
@@ -1048,8 +1080,10 @@ static const cid_t INVALID_EID = 0;
 
 static const cid_t MAX_EID = std::numeric_limits<eid_t>::max();
 
-// For epoch
-static const size_t EPOCH_LENGTH = 40;
+// For epoch, the period (in ms) of the epoch thread, the loggers and the
+// group commit. They read it every period, so it can be changed while they
+// run.
+extern std::atomic<size_t> EPOCH_LENGTH;
 
 // For threads
 extern size_t CONNECTION_THREAD_COUNT;
@@ -1093,12 +1127,13 @@ std::ostream &operator<<(std::ostream &os, const RWType &type);
 
 enum class GCSetType { COMMITTED, ABORTED };
 
-// block -> offset -> type
-typedef std::unordered_map<oid_t, std::unordered_map<oid_t, RWType>>
-    ReadWriteSet;
+// (block, tuple count) of bulk loaded tile groups
+typedef std::vector<std::pair<oid_t, oid_t>> BulkInsertSet;
+
+class ItemPointer;
 
-// block -> offset -> is_index_deletion
-typedef std::unordered_map<oid_t, std::unordered_map<oid_t, bool>> GCSet;
+// (location, is_index_deletion) of the versions to recycle
+typedef std::vector<std::pair<ItemPointer, bool>> GCSet;
 
 //===--------------------------------------------------------------------===//
 // File Handle
@@ -314,6 +314,7 @@ class Value : public Printable {
   friend class DateType;
 
   friend class ValueFactory;
+  friend class ValueRef;
 
  protected:
   // The actual value item
@@ -0,0 +1,41 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// value_dispatch.h
+//
+// Identification: src/include/type/value_dispatch.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace type {
+
+//===----------------------------------------------------------------------===//
+// Tables of the operations on Values specialized for the types of their
+// operands. An operation is looked up by the type ids once and then called
+// without going through Type::GetInstance() and its virtual functions. The
+// types without a specialization go through their Type as before.
+//===----------------------------------------------------------------------===//
+class ValueDispatch {
+ public:
+  typedef CmpBool (*CompareFunction)(const Value &left, const Value &right);
+
+  // The comparison of the expression type, one of COMPARE_EQUAL,
+  // COMPARE_NOTEQUAL, COMPARE_LESSTHAN, COMPARE_GREATERTHAN,
+  // COMPARE_LESSTHANOREQUALTO and COMPARE_GREATERTHANOREQUALTO, of values of
+  // the left and the right type. Returns nullptr for other expression types.
+  static CompareFunction GetCompareFunction(ExpressionType compare_type,
+                                            TypeId left_type,
+                                            TypeId right_type);
+};
+
+}  // namespace type
+}  // namespace peloton
@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// value_ref.h
+//
+// Identification: src/include/type/value_ref.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "type/value.h"
+#include "type/type_util.h"
+#include "type/varlen_type.h"
+
+namespace peloton {
+namespace type {
+
+//===----------------------------------------------------------------------===//
+// A view of a value in a tuple, a key or a Value that neither owns nor copies
+// its data. Only the type id is looked at, so unlike a Value it is read and
+// compared without the virtual calls of its Type. It is valid as long as the
+// storage it views is, and for varlen values their pool.
+//===----------------------------------------------------------------------===//
+class ValueRef {
+ public:
+  explicit ValueRef(const Value &value)
+      : type_id_(value.type_id_),
+        len_(value.size_.len),
+        is_null_(value.IsNull()) {
+    if (type_id_ == TypeId::VARCHAR || type_id_ == TypeId::VARBINARY) {
+      data_ = value.value_.const_varlen;
+    } else {
+      data_ = reinterpret_cast<const char *>(&value.value_);
+    }
+  }
+
+  // The value of the type serialized in the storage of a column, the way
+  // Value::DeserializeFrom() reads it
+  ValueRef(TypeId type_id, const char *storage)
+      : type_id_(type_id), data_(storage), len_(0), is_null_(false) {
+    switch (type_id_) {
+      case TypeId::BOOLEAN:
+        is_null_ = GetAs<int8_t>() == PELOTON_BOOLEAN_NULL;
+        break;
+      case TypeId::TINYINT:
+        is_null_ = GetAs<int8_t>() == PELOTON_INT8_NULL;
+        break;
+      case TypeId::SMALLINT:
+        is_null_ = GetAs<int16_t>() == PELOTON_INT16_NULL;
+        break;
+      case TypeId::INTEGER:
+        is_null_ = GetAs<int32_t>() == PELOTON_INT32_NULL;
+        break;
+      case TypeId::BIGINT:
+        is_null_ = GetAs<int64_t>() == PELOTON_INT64_NULL;
+        break;
+      case TypeId::DECIMAL:
+        is_null_ = GetAs<double>() == PELOTON_DECIMAL_NULL;
+        break;
+      case TypeId::TIMESTAMP:
+        is_null_ = GetAs<uint64_t>() == PELOTON_TIMESTAMP_NULL;
+        break;
+      case TypeId::DATE:
+        is_null_ = GetAs<uint32_t>() == PELOTON_DATE_NULL;
+        break;
+      case TypeId::VARCHAR:
+      case TypeId::VARBINARY: {
+        // Varlen columns hold a pointer to the length and the data, or short
+        // values themselves
+        if (VarlenType::IsInlineStorage(storage)) {
+          len_ = VarlenType::GetInlineLength(storage);
+          data_ = VarlenType::GetInlineData(storage);
+          break;
+        }
+        const char *ptr = *reinterpret_cast<const char *const *>(storage);
+        if (ptr == nullptr) {
+          data_ = nullptr;
+          len_ = PELOTON_VALUE_NULL;
+          is_null_ = true;
+        } else {
+          len_ = *reinterpret_cast<const uint32_t *>(ptr);
+          data_ = ptr + sizeof(uint32_t);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  inline TypeId GetTypeId() const { return type_id_; }
+
+  inline bool IsNull() const { return is_null_; }
+
+  // The fixed-length value
+  template <class T>
+  inline T GetAs() const {
+    return *reinterpret_cast<const T *>(data_);
+  }
+
+  // The data of a varlen value and its length, which for a VARCHAR includes
+  // the terminating null
+  inline const char *GetData() const { return data_; }
+  inline uint32_t GetLength() const { return len_; }
+
+  // A Value of the data that does not own it either
+  Value ToValue() const;
+
+  // Compare to a view of a value of the same type, less than, equal to or
+  // greater than 0 like memcmp. NULL compares equal to everything, the way
+  // the comparators of the indexes treat it.
+  inline int Compare(const ValueRef &other) const {
+    PL_ASSERT(type_id_ == other.type_id_);
+    if (is_null_ || other.is_null_) return 0;
+    switch (type_id_) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return CompareAs<int8_t>(other);
+      case TypeId::SMALLINT:
+        return CompareAs<int16_t>(other);
+      case TypeId::INTEGER:
+        return CompareAs<int32_t>(other);
+      case TypeId::BIGINT:
+        return CompareAs<int64_t>(other);
+      case TypeId::DECIMAL:
+        return CompareAs<double>(other);
+      case TypeId::TIMESTAMP:
+        return CompareAs<uint64_t>(other);
+      case TypeId::DATE:
+        return CompareAs<uint32_t>(other);
+      case TypeId::VARCHAR:
+      case TypeId::VARBINARY:
+        return CompareVarlen(other);
+      default:
+        return CompareValues(other);
+    }
+  }
+
+  // Compare the varlen data the way VarlenType does
+  inline int CompareVarlen(const ValueRef &other) const {
+    if (len_ == PELOTON_VARCHAR_MAX_LEN ||
+        other.len_ == PELOTON_VARCHAR_MAX_LEN) {
+      return len_ < other.len_ ? -1 : (other.len_ < len_ ? 1 : 0);
+    }
+    return TypeUtil::CompareStrings(data_, len_ - 1, other.data_,
+                                    other.len_ - 1);
+  }
+
+ private:
+  template <class T>
+  inline int CompareAs(const ValueRef &other) const {
+    T left = GetAs<T>();
+    T right = other.GetAs<T>();
+    return left < right ? -1 : (right < left ? 1 : 0);
+  }
+
+  // Compare the values of the other types through their Type
+  int CompareValues(const ValueRef &other) const;
+
+  TypeId type_id_;
+
+  // The fixed-length value, or the data of a varlen value
+  const char *data_;
+
+  uint32_t len_;
+
+  bool is_null_;
+};
+
+}  // namespace type
+}  // namespace peloton
@@ -27,7 +27,8 @@ class VarlenType : public Type {
   // Access the raw variable length data
   const char *GetData(const Value& val) const override;
 
-  // Access the raw varlen data stored from the tuple storage
+  // Access the raw varlen data stored from the tuple storage, nullptr if the
+  // value is stored in the slot itself
   char *GetData(char *storage) override;
 
   // Get the length of the variable length data
@@ -70,6 +71,32 @@ class VarlenType : public Type {
 
   // Create a copy of this value
   Value Copy(const Value& val) const override;
+
+  // The slot of a varlen column holds a pointer to the length and the data.
+  // Tiles store values of up to kInlineCapacity bytes in the slot instead,
+  // with the length in the first byte, tagged by its lowest bit, which the
+  // aligned pointers of the pools never have set.
+  static const uint32_t kInlineCapacity = sizeof(char *) - 1;
+
+  // Store a varlen value in the slot if it fits, false if it does not
+  static bool SerializeInlineTo(const Value &val, char *storage);
+
+  // Serialize a value of any type into a column of a tile, short varlen
+  // values into their slot and everything else like Value::SerializeTo()
+  static void SerializeToTile(const Value &val, char *storage, bool inlined,
+                              AbstractPool *pool);
+
+  static inline bool IsInlineStorage(const char *storage) {
+    return (*reinterpret_cast<const uint8_t *>(storage) & 1) != 0;
+  }
+
+  static inline uint32_t GetInlineLength(const char *storage) {
+    return *reinterpret_cast<const uint8_t *>(storage) >> 1;
+  }
+
+  static inline const char *GetInlineData(const char *storage) {
+    return storage + 1;
+  }
 };
 
 }  // namespace type
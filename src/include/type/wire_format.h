@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wire_format.h
+//
+// Identification: src/include/type/wire_format.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "type/types.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace type {
+
+//===----------------------------------------------------------------------===//
+// Wire Format
+//
+// The representations of values in the rows and the parameters of the
+// Postgres wire protocol. The text format is what the values print as. The
+// binary format is the network order encoding of the type the columns of a
+// value are described as by TrafficCop::GetColumnFieldForValueType, and
+// types described as text are sent as text in either format.
+//===----------------------------------------------------------------------===//
+class WireFormat {
+ public:
+  // The format codes of the protocol
+  static constexpr int kTextFormat = 0;
+  static constexpr int kBinaryFormat = 1;
+
+  // Append the value in the format to the bytes, nothing for NULL
+  static void Encode(const Value &value, int format,
+                     std::vector<unsigned char> &bytes);
+
+  // The value of a parameter of the type sent in binary format. Returns
+  // false if the type is not supported or the length does not fit it.
+  static bool DecodeBinary(PostgresValueType type, const unsigned char *data,
+                           size_t len, Value &value);
+
+  // Microseconds since 2000-01-01 of the timestamp, and the timestamp of
+  // them in UTC
+  static int64_t ToPostgresTimestamp(uint64_t timestamp);
+  static uint64_t FromPostgresTimestamp(int64_t micros);
+};
+
+}  // namespace type
+}  // namespace peloton
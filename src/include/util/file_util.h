@@ -78,6 +78,42 @@ class FileUtil {
     struct stat buffer;
     return (stat(path.c_str(), &buffer) == 0);
   }
+
+  /**
+   * Returns the names of the entries of the directory at the provided path,
+   * in no particular order. Empty if it cannot be read.
+   */
+  static std::vector<std::string> ListDirectory(const std::string path) {
+    std::vector<std::string> names;
+    boost::system::error_code error;
+    boost::filesystem::directory_iterator itr(path, error);
+    if (error) return (names);
+    for (; itr != boost::filesystem::directory_iterator(); itr.increment(error)) {
+      if (error) break;
+      names.push_back(itr->path().filename().string());
+    }
+    return (names);
+  }
+
+  /**
+   * Create a new empty directory in the temp directory and return its path.
+   * @param an optional prefix to use for the directory name
+   */
+  static std::string CreateTempDirectory(const std::string prefix = "") {
+    boost::filesystem::path tempDir =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path(prefix + "%%%%%%%%%");
+    boost::filesystem::create_directories(tempDir);
+    return (tempDir.string());
+  }
+
+  /**
+   * Remove the directory at the provided path with all its contents.
+   */
+  static void RemoveDirectory(const std::string path) {
+    boost::system::error_code error;
+    boost::filesystem::remove_all(path, error);
+  }
 };
 
 }  // END peloton
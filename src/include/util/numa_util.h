@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// numa_util.h
+//
+// Identification: src/include/util/numa_util.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace peloton {
+
+// No particular NUMA node
+static const int INVALID_NUMA_NODE = -1;
+
+/**
+ * NUMA Utility Functions
+ * The topology is read from sysfs and memory policies are set through raw
+ * system calls, so we don't depend on libnuma. On machines (or kernels)
+ * without NUMA support everything behaves as if there was a single node.
+ */
+class NumaUtil {
+ public:
+  // Number of NUMA nodes on this machine
+  static int GetNodeCount();
+
+  // The node of the CPU the calling thread is currently running on
+  static int GetCurrentNode();
+
+  // The CPUs that belong to the given node
+  static std::vector<int> GetNodeCpus(const int node);
+
+  // Restrict the calling thread to the CPUs of the given node
+  static bool BindThreadToNode(const int node);
+
+  // Pin the calling thread to the given CPU
+  static bool BindThreadToCpu(const int cpu);
+
+  // Prefer placing the pages of the given (page-aligned) memory range on the
+  // given node. Pages that have not been touched yet are allocated there.
+  static bool BindMemoryToNode(void *address, const size_t size,
+                               const int node);
+
+  // Parse a sysfs cpu/node list (e.g., "0-3,8,10-11")
+  static std::vector<int> ParseList(const std::string &list);
+};
+
+}  // End peloton namespace
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <mutex>
 #include <vector>
 
 #include <sys/file.h>
@@ -49,12 +50,13 @@ class LibeventThread;
 class LibeventMasterThread;
 
 // Libevent Thread States
-enum ConnState {
+enum ConnState : int {
   CONN_LISTENING,  // State that listens for new connections
   CONN_READ,       // State that reads data from the network
   CONN_WRITE,      // State the writes data to the network
   CONN_WAIT,       // State for waiting for some event to happen
   CONN_PROCESS,    // State that runs the wire protocol on received data
+  CONN_EXECUTING,  // State while an execution thread processes a packet
   CONN_CLOSING,    // State for closing the client connection
   CONN_CLOSED,     // State for closed connection
   CONN_INVALID,    // Invalid STate
@@ -166,6 +168,7 @@ class LibeventSocket {
   Buffer rbuf_;                     // Socket's read buffer
   Buffer wbuf_;                     // Socket's write buffer
   unsigned int next_response_ = 0;  // The next response in the response buffer
+  short listen_flags_ = 0;  // The flags the event is added with, 0 if not
 
  private:
   // Is the requested amount of data available from the current position in
@@ -198,14 +201,26 @@ class LibeventSocket {
   // Update the existing event to listen to the passed flags
   bool UpdateEvent(short flags);
 
+  // Stop listening to the socket until the event is updated again
+  void RemoveEvent();
+
   // Extracts the header of a Postgres packet from the read socket buffer
   bool ReadPacketHeader();
 
   // Extracts the contents of Postgres packet from the read socket buffer
   bool ReadPacket();
 
+  // Extracts the next packet into rpkt if all of it is in the read socket
+  // buffer already, so that pipelined packets are processed back to back
+  bool ReadBufferedPacket();
+
   WriteState WritePackets();
 
+  // Writes out the packets buffered while a statement executes, and waits
+  // for the client to read them if the socket is full. Returns false if the
+  // connection failed.
+  bool FlushResponses();
+
   void PrintWriteBuffer();
 
   void CloseSocket();
@@ -219,6 +234,10 @@ class LibeventSocket {
   // Writes a packet's content into the write buffer
   WriteState BufferWriteBytesContent(OutputPacket *pkt);
 
+  // Writes the write buffer and the rest of a packet's content to the socket
+  // at once, for contents too large to be copied into the buffer
+  WriteState WritevContent(OutputPacket *pkt);
+
   // Used to invoke a write into the Socket, returns false if the socket is not
   // ready for write
   WriteState FlushWriteBuffer();
@@ -279,6 +298,9 @@ struct LibeventServer {
    */
   static std::unordered_map<int, std::unique_ptr<LibeventSocket>> &
   GetGlobalSocketList();
+
+  // Guards the list, the sockets themselves stay where they are
+  static std::mutex &GetGlobalSocketListMutex();
 };
 
 /*
@@ -24,12 +24,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 #include <sys/file.h>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/thread_pool.h"
 #include "configuration/configuration.h"
 #include "container/lock_free_queue.h"
 #include "wire/libevent_server.h"
@@ -40,6 +43,8 @@ namespace wire {
 
 // Forward Declarations
 struct NewConnQueueItem;
+class LibeventSocket;
+enum ConnState : int;
 
 class LibeventThread {
  protected:
@@ -52,9 +57,15 @@ class LibeventThread {
   bool is_closed = false;
   int sock_fd = -1;
 
+  // The number of connections open on the thread
+  std::atomic<int> conn_count_;
+
+  // The number of connections open on all the threads
+  static std::atomic<int> total_conn_count_;
+
  public:
   LibeventThread(const int thread_id, struct event_base *libevent_base)
-      : thread_id_(thread_id), libevent_base_(libevent_base) {
+      : thread_id_(thread_id), libevent_base_(libevent_base), conn_count_(0) {
     if (libevent_base_ == nullptr) {
       LOG_ERROR("Can't allocate event base\n");
       exit(1);
@@ -80,6 +91,20 @@ class LibeventThread {
   int GetThreadSockFd() { return sock_fd; }
 
   void SetThreadSockFd(int fd) { this->sock_fd = fd; }
+
+  int GetConnectionCount() { return conn_count_.load(); }
+
+  void AddConnection() {
+    conn_count_++;
+    total_conn_count_++;
+  }
+
+  void RemoveConnection() {
+    conn_count_--;
+    total_conn_count_--;
+  }
+
+  static int GetTotalConnectionCount() { return total_conn_count_.load(); }
 };
 
 class LibeventWorkerThread : public LibeventThread {
@@ -100,9 +125,16 @@ class LibeventWorkerThread : public LibeventThread {
   /* The queue for new connection requests */
   LockFreeQueue<std::shared_ptr<NewConnQueueItem>> new_conn_queue;
 
+  /* The queue of connections whose packets have been processed */
+  LockFreeQueue<std::shared_ptr<NewConnQueueItem>> executed_conn_queue;
+
  public:
   LibeventWorkerThread(const int thread_id);
 
+  // Notify the thread that the packet of the connection has been processed,
+  // it resumes the connection in the given state
+  void ResumeConnection(int conn_fd, ConnState next_state);
+
   // Getters and setters
   event *GetNewConnEvent() { return this->new_conn_event_; }
 
@@ -135,5 +167,36 @@ class LibeventMasterThread : public LibeventThread {
   static void StartWorker(peloton::wire::LibeventWorkerThread *worker_thread);
 };
 
+// The threads that process the packets of the connections if
+// FLAGS_execution_threads is set, so that a long statement does not hold up
+// the other connections of its worker thread. The worker threads then only
+// read the packets and write the responses.
+class LibeventExecutionPool {
+ public:
+  static LibeventExecutionPool &GetInstance();
+
+  bool IsEnabled() const { return FLAGS_execution_threads > 0; }
+
+  // Process the packet read by the connection, and resume the connection on
+  // its worker thread once it is processed
+  void ProcessPacket(LibeventSocket *conn);
+
+  void Shutdown();
+
+ private:
+  LibeventExecutionPool() : next_thread_id_(0) {}
+
+  void ExecutePacket(LibeventSocket *conn);
+
+  // The id an execution thread enters the epochs with, after the ids of the
+  // worker threads
+  size_t RegisterThread();
+
+  // Started by the first packet, so that it can be restarted after Shutdown()
+  std::unique_ptr<ThreadPool> pool_;
+  std::mutex pool_mutex_;
+  std::atomic<size_t> next_thread_id_;
+};
+
 }  // namespace wire
 }  // namespace peloton
@@ -103,14 +103,17 @@ struct OutputPacket {
   bool skip_header_write;  // whether we should write header to socket wbuf
   size_t write_ptr;        // cursor used to write packet content to socket wbuf
 
-  // TODO could packet be reused?
+  // Reset to an empty packet for reuse. The contents of a large packet are
+  // released rather than kept around.
   inline void Reset() {
-    buf.resize(BUFFER_INIT_SIZE);
-    buf.shrink_to_fit();
-    buf.clear();
+    if (buf.capacity() > SOCKET_BUFFER_SIZE) {
+      ByteBuf().swap(buf);
+    } else {
+      buf.clear();
+    }
     len = ptr = write_ptr = 0;
-    msg_type = NetworkMessageType::NULL_COMMAND;
-    skip_header_write = true;
+    msg_type = static_cast<NetworkMessageType>(0);
+    skip_header_write = false;
   }
 };
 
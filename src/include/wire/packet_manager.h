@@ -13,6 +13,7 @@
 #pragma once
 
 #include <boost/assign/list_of.hpp>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -21,6 +22,8 @@
 #include "common/cache.h"
 #include "common/portal.h"
 #include "common/statement.h"
+#include "executor/copy_from_loader.h"
+#include "logging/group_commit_manager.h"
 #include "tcop/tcop.h"
 #include "wire/marshal.h"
 
@@ -105,11 +108,46 @@ class PacketManager {
   // Should we send the buffered packets right away?
   bool force_flush = false;
 
-  // TODO declare a response buffer pool so that we can reuse the responses
-  // so that we don't have to new packet each time
+  // Writes out the buffered packets while a statement still executes, false
+  // if the connection failed. Set by the socket of the connection.
+  std::function<bool()> flush_responses;
+
   ResponseBuffer responses;
 
+  // Keep the responses once they are written out, for reuse by the next ones
+  void RecycleResponses();
+
+  // Run the callback once the transactions committed by the processed
+  // packets are durable, after which their responses may be sent. Returns
+  // false, without running it, if no commit is pending.
+  bool OnCommitsDurable(std::function<void()> callback) {
+    return commit_waiter_->OnAcknowledged(std::move(callback));
+  }
+
  private:
+  // A packet for a response, reused from the recycled ones if possible
+  std::unique_ptr<OutputPacket> NewPacket();
+
+  // The switch case of ProcessPacket()
+  bool DispatchPacket(InputPacket* pkt, const size_t thread_id);
+
+  // Prepare a statement of the connection. With the plan cache enabled, the
+  // statement is shared with the other connections through a handle from
+  // the PlanCache.
+  std::shared_ptr<Statement> PrepareStatement(const std::string& statement_name,
+                                              const std::string& query_string,
+                                              std::string& error_message);
+
+  // Keep a prepared statement under its name, or forget it
+  void CacheStatement(const std::string& statement_name,
+                      const std::shared_ptr<Statement>& statement);
+  void UncacheStatement(const std::string& statement_name);
+
+  // Bind a traffic cop to the connection, from the TrafficCopPool if it is
+  // enabled, and give a pooled one back once no transaction is open
+  void BindTrafficCop();
+  void UnbindTrafficCop();
+
   //===--------------------------------------------------------------------===//
   // PROTOCOL HANDLING FUNCTIONS
   //===--------------------------------------------------------------------===//
@@ -122,10 +160,37 @@ class PacketManager {
   void SendReadyForQuery(NetworkTransactionStateType txn_status);
 
   // Sends the attribute headers required by SELECT queries
-  void PutTupleDescriptor(const std::vector<FieldInfo>& tuple_descriptor);
+  // The columns are described as text unless their formats are given
+  void PutTupleDescriptor(const std::vector<FieldInfo>& tuple_descriptor,
+                          const std::vector<int>* result_format = nullptr);
 
-  // Send each row, one packet at a time, used by SELECT queries
+  // Send each row, one packet at a time, used by SELECT queries. Sends at
+  // most max_rows rows from first_row on, unless max_rows is 0.
   void SendDataRows(std::vector<StatementResult>& results, int colcount,
+                    int& rows_affected, size_t first_row = 0,
+                    size_t max_rows = 0);
+
+  // Have the rows of the next statement sent and flushed in chunks while it
+  // executes, after its row description if send_descriptor is set
+  void StartStreaming(bool send_descriptor);
+
+  // Buffer the rows of the statements executed from now on
+  void StopStreaming();
+
+  // Send the rows of the executing statement taken out of the results
+  void StreamDataRows(const std::vector<FieldInfo>& tuple_descriptor,
+                      std::vector<StatementResult>& results);
+
+  // Tells the client that the portal stopped at the row limit of the
+  // execution
+  void SendPortalSuspended();
+
+  // Sends the CopyInResponse or CopyOutResponse of a COPY of the columns,
+  // all of them in text format
+  void PutCopyResponse(NetworkMessageType msg_type, size_t column_count);
+
+  // Send each row as a line of CopyData, used by COPY TO STDOUT
+  void SendCopyData(std::vector<StatementResult>& results, int colcount,
                     int& rows_affected);
 
   // Used to send a packet that indicates the completion of a query. Also has
@@ -165,6 +230,23 @@ class PacketManager {
   /* Process the optional CLOSE message of the extended query protocol */
   void ExecCloseMessage(InputPacket* pkt);
 
+  /* Run a COPY FROM STDIN or TO STDOUT over the connection. Returns false
+   * for the other COPYs, which execute as any other statement */
+  bool ExecCopyQuery(const std::string& query, const size_t thread_id);
+
+  /* Process the COPY DATA, COPY DONE and COPY FAIL messages of the client
+   * during a COPY FROM STDIN. They are ignored after the COPY failed */
+  void ExecCopyDataMessage(InputPacket* pkt);
+  void ExecCopyDoneMessage();
+  void ExecCopyFailMessage(InputPacket* pkt);
+
+  // End the COPY FROM STDIN, committing its transaction if it succeeded and
+  // it is not part of a transaction block, and send its result
+  void EndCopyIn(bool success, std::string error_message);
+
+  // Stop the COPY FROM STDIN, if any, and end its own transaction
+  ResultType CloseCopyIn(bool success);
+
   //===--------------------------------------------------------------------===//
   // MEMBERS
   //===--------------------------------------------------------------------===//
@@ -175,6 +257,20 @@ class PacketManager {
   // The result-column format code
   std::vector<int> result_format_;
 
+  // The rows of the executing statement sent so far, and whether its row
+  // description still has to go before them
+  int streamed_rows_ = 0;
+  bool stream_descriptor_ = false;
+
+  // The COPY FROM STDIN in progress, and the transaction it loads the rows
+  // in, which is its own unless it runs in a transaction block
+  std::unique_ptr<executor::CopyFromLoader> copy_loader_;
+  concurrency::Transaction* copy_txn_ = nullptr;
+  bool own_copy_txn_ = false;
+
+  // The delimiter of the executing COPY TO STDOUT, 0 for other statements
+  char copy_out_delimiter_ = 0;
+
   // global txn state
   NetworkTransactionStateType txn_state_;
 
@@ -208,8 +304,19 @@ class PacketManager {
   std::unordered_map<std::string, stats::QueryMetric::QueryParamBuf>
       statement_param_types_;
 
-  // The traffic cop used for this connection
-  std::unique_ptr<tcop::TrafficCop> traffic_cop_;
+  // The traffic cop used for this connection, its own or one bound from the
+  // TrafficCopPool while a packet is processed or a transaction is open
+  tcop::TrafficCop *traffic_cop_ = nullptr;
+  std::unique_ptr<tcop::TrafficCop> own_traffic_cop_;
+
+  // The commits of the connection that wait for their epochs
+  std::shared_ptr<logging::CommitWaiter> commit_waiter_;
+
+  // Written out responses, reused by NewPacket()
+  ResponseBuffer free_packets_;
+
+  // Enough for a chunk of streamed rows
+  static constexpr size_t kMaxFreePackets = 1024;
 
   //===--------------------------------------------------------------------===//
   // STATIC DATA
@@ -0,0 +1,291 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// art_index.cpp
+//
+// Identification: src/index/art_index.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "index/art_index.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/logger.h"
+#include "index/index_key.h"
+#include "index/scan_optimizer.h"
+#include "statistics/stats_aggregator.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace index {
+
+ART_TEMPLATE_ARGUMENTS
+ART_INDEX_TYPE::ARTIndex(IndexMetadata *metadata)
+    :  // Base class
+      Index{metadata},
+      // Key "less than" relation comparator
+      comparator{},
+      // Key equality checker
+      equals{},
+      // A unique index holds a single value per key, bar the versions
+      // inserted through CondInsertEntry()
+      container{metadata->HasUniqueKeys(), comparator, equals} {
+  return;
+}
+
+ART_TEMPLATE_ARGUMENTS
+ART_INDEX_TYPE::~ARTIndex() {}
+
+/*
+ * InsertEntry() - insert a key-value pair into the map
+ *
+ * If the key value pair already exists in the map, just return false
+ */
+ART_TEMPLATE_ARGUMENTS
+bool ART_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
+                                 ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Insert(index_key, value);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  return ret;
+}
+
+/*
+ * DeleteEntry() - Removes a key-value pair
+ *
+ * If the key-value pair does not exists yet in the map return false
+ */
+ART_TEMPLATE_ARGUMENTS
+bool ART_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
+                                 ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Delete(index_key, value);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
+        ret == true ? 1 : 0, metadata);
+  }
+  return ret;
+}
+
+ART_TEMPLATE_ARGUMENTS
+bool ART_INDEX_TYPE::CondInsertEntry(
+    const storage::Tuple *key, ItemPointer *value,
+    std::function<bool(const void *)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool predicate_satisfied = false;
+
+  // The predicate is checked against the values of the key and the value
+  // inserted in one step
+  bool ret = container.ConditionalInsert(index_key, value, predicate,
+                                         &predicate_satisfied);
+
+  if (predicate_satisfied == true) {
+    assert(ret == false);
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  return ret;
+}
+
+/*
+ * Scan() - Scans a range inside the index using index scan optimizer
+ *
+ * The scan optimizer specifies whether a scan is point query, full scan
+ * or interval scan. The tree is walked forward from the low key either
+ * way, and backward scans reverse what it collected
+ */
+ART_TEMPLATE_ARGUMENTS
+void ART_INDEX_TYPE::Scan(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  ScanRange(csp_p, scan_direction, std::numeric_limits<uint64_t>::max(), 0,
+            result);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
+  return;
+}
+
+/*
+ * ScanLimit() - Scan the index with predicate and limit/offset
+ *
+ * The first offset elements are skipped. A forward scan stops after offset +
+ * limit elements
+ */
+ART_TEMPLATE_ARGUMENTS
+void ART_INDEX_TYPE::ScanLimit(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p, uint64_t limit, uint64_t offset) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  ScanRange(csp_p, scan_direction, limit, offset, result);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
+  return;
+}
+
+/*
+ * ScanRange() - Fill the values the scan predicate selects, in the order of
+ *               the direction, skipping offset values and up to limit
+ */
+ART_TEMPLATE_ARGUMENTS
+void ART_INDEX_TYPE::ScanRange(const ConjunctionScanPredicate *csp_p,
+                               ScanDirectionType scan_direction,
+                               uint64_t limit, uint64_t offset,
+                               std::vector<ValueType> &result) {
+  LOG_TRACE("Scan() Point Query = %d; Full Scan = %d ", csp_p->IsPointQuery(),
+            csp_p->IsFullIndexScan());
+
+  if (csp_p->IsPointQuery() == true) {
+    KeyType point_query_key;
+    point_query_key.SetFromKey(csp_p->GetPointQueryKey());
+
+    std::vector<ValueType> values;
+    container.GetValue(point_query_key, values);
+    if (scan_direction == ScanDirectionType::BACKWARD) {
+      std::reverse(values.begin(), values.end());
+    }
+
+    for (size_t value_itr = offset;
+         value_itr < values.size() && value_itr - offset < limit;
+         value_itr++) {
+      result.push_back(values[value_itr]);
+    }
+    return;
+  }
+
+  bool is_full_scan = csp_p->IsFullIndexScan();
+  KeyType index_low_key;
+  KeyType index_high_key;
+  if (is_full_scan == false) {
+    LOG_TRACE("Partial scan low key: %s\n high key: %s",
+              csp_p->GetLowKey()->GetInfo().c_str(),
+              csp_p->GetHighKey()->GetInfo().c_str());
+
+    index_low_key.SetFromKey(csp_p->GetLowKey());
+    index_high_key.SetFromKey(csp_p->GetHighKey());
+  }
+
+  // A backward scan collects the whole range before skipping the offset
+  bool is_forward = scan_direction == ScanDirectionType::FORWARD;
+  uint64_t scan_offset = is_forward == true ? offset : 0;
+  uint64_t scan_limit =
+      is_forward == true ? limit : std::numeric_limits<uint64_t>::max();
+
+  std::vector<ValueType> values;
+  uint64_t scan_count = 0;
+  for (auto scan_itr = is_full_scan == true ? container.Begin()
+                                            : container.Begin(index_low_key);
+       scan_itr.IsEnd() == false; ++scan_itr) {
+    if (is_full_scan == false &&
+        container.KeyCmpLessEqual(scan_itr->first, index_high_key) == false) {
+      break;
+    }
+    if (scan_count >= scan_offset) {
+      if (scan_count - scan_offset >= scan_limit) {
+        break;
+      }
+      values.push_back(scan_itr->second);
+    }
+    scan_count++;
+  }
+
+  if (is_forward == true) {
+    result.insert(result.end(), values.begin(), values.end());
+    return;
+  }
+
+  std::reverse(values.begin(), values.end());
+  for (size_t value_itr = offset;
+       value_itr < values.size() && value_itr - offset < limit; value_itr++) {
+    result.push_back(values[value_itr]);
+  }
+}
+
+ART_TEMPLATE_ARGUMENTS
+void ART_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
+  for (auto scan_itr = container.Begin(); scan_itr.IsEnd() == false;
+       ++scan_itr) {
+    result.push_back(scan_itr->second);
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+  return;
+}
+
+ART_TEMPLATE_ARGUMENTS
+void ART_INDEX_TYPE::ScanKey(const storage::Tuple *key,
+                             std::vector<ValueType> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container.GetValue(index_key, result);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
+  return;
+}
+
+ART_TEMPLATE_ARGUMENTS
+std::string ART_INDEX_TYPE::GetTypeName() const { return "ART"; }
+
+// IMPORTANT: Make sure you don't exceed CompactIntegerKey_MAX_SLOTS
+
+template class ARTIndex<CompactIntsKey<1>, ItemPointer *,
+                        CompactIntsComparator<1>,
+                        CompactIntsEqualityChecker<1>, ItemPointerComparator>;
+template class ARTIndex<CompactIntsKey<2>, ItemPointer *,
+                        CompactIntsComparator<2>,
+                        CompactIntsEqualityChecker<2>, ItemPointerComparator>;
+template class ARTIndex<CompactIntsKey<3>, ItemPointer *,
+                        CompactIntsComparator<3>,
+                        CompactIntsEqualityChecker<3>, ItemPointerComparator>;
+template class ARTIndex<CompactIntsKey<4>, ItemPointer *,
+                        CompactIntsComparator<4>,
+                        CompactIntsEqualityChecker<4>, ItemPointerComparator>;
+
+}  // End index namespace
+}  // End peloton namespace
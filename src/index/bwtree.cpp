@@ -13,6 +13,8 @@
 
 #include "index/bwtree.h"
 
+#include <mutex>
+
 #ifdef BWTREE_PELOTON
 namespace peloton {
 namespace index {
@@ -30,6 +32,53 @@ thread_local int BwTreeBase::gc_id = -1;
 
 std::atomic<size_t> BwTreeBase::total_thread_num{0UL};
 
+namespace {
+
+// The GC IDs given back by threads that have exited
+std::mutex free_gc_id_lock;
+std::vector<int> free_gc_id_list;
+
+/*
+ * class GCIDReleaser - Gives the GC ID of a thread back when it exits
+ */
+class GCIDReleaser {
+ public:
+  ~GCIDReleaser() {
+    if(BwTreeBase::gc_id == -1) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> guard(free_gc_id_lock);
+    free_gc_id_list.push_back(BwTreeBase::gc_id);
+    BwTreeBase::gc_id = -1;
+  }
+};
+
+}  // namespace
+
+void BwTreeBase::RegisterThread() {
+  static thread_local GCIDReleaser releaser;
+  (void)releaser;
+
+  while(1) {
+    {
+      std::lock_guard<std::mutex> guard(free_gc_id_lock);
+      if(free_gc_id_list.empty() == false) {
+        gc_id = free_gc_id_list.back();
+        free_gc_id_list.pop_back();
+        return;
+      }
+
+      if(total_thread_num.load() < GC_THREAD_COUNT) {
+        gc_id = static_cast<int>(total_thread_num.fetch_add(1));
+        return;
+      }
+    }
+
+    std::this_thread::yield();
+  }
+}
+
 }  // End index/bwtree namespace
 }  // End peloton/wangziqi2013 namespace
 
@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 #include "index/bwtree_index.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "common/logger.h"
 #include "index/index_key.h"
 #include "index/scan_optimizer.h"
@@ -20,6 +23,76 @@
 namespace peloton {
 namespace index {
 
+namespace {
+
+// Lists shorter than this are sorted on the calling thread
+constexpr size_t PARALLEL_SORT_THRESHOLD = 1 << 16;
+
+// The delta chain length threshold of the tree is chosen again after this
+// many writes, from the share of writes among the operations since the last
+// time
+constexpr uint64_t TUNING_WRITE_INTERVAL = 1 << 16;
+
+// Workloads with less than 10% writes traverse fewer deltas on every read,
+// and workloads with more than 50% writes consolidate less often
+constexpr int READ_MOSTLY_DELTA_CHAIN_LENGTH = 4;
+constexpr int WRITE_MOSTLY_DELTA_CHAIN_LENGTH = 16;
+
+/*
+ * ParallelSort() - Sort chunks of the list on their own threads, and then
+ *                  merge neighbouring sorted runs in parallel until a single
+ *                  one is left
+ */
+template <typename ElementType, typename Compare>
+void ParallelSort(std::vector<ElementType> &list, Compare cmp) {
+  size_t thread_count = std::thread::hardware_concurrency();
+  if (list.size() < PARALLEL_SORT_THRESHOLD || thread_count <= 1) {
+    std::sort(list.begin(), list.end(), cmp);
+    return;
+  }
+
+  // The sorted runs are [bounds[i], bounds[i + 1])
+  std::vector<size_t> bounds;
+  for (size_t thread_itr = 0; thread_itr <= thread_count; thread_itr++) {
+    bounds.push_back(list.size() * thread_itr / thread_count);
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t run_itr = 0; run_itr + 1 < bounds.size(); run_itr++) {
+    threads.emplace_back([&list, &bounds, &cmp, run_itr]() {
+      std::sort(list.begin() + bounds[run_itr],
+                list.begin() + bounds[run_itr + 1], cmp);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  while (bounds.size() > 2) {
+    threads.clear();
+    std::vector<size_t> merged_bounds;
+    for (size_t run_itr = 0; run_itr + 1 < bounds.size(); run_itr += 2) {
+      merged_bounds.push_back(bounds[run_itr]);
+      // The last run has no neighbour when the run count is odd
+      if (run_itr + 2 < bounds.size()) {
+        threads.emplace_back([&list, &bounds, &cmp, run_itr]() {
+          std::inplace_merge(list.begin() + bounds[run_itr],
+                             list.begin() + bounds[run_itr + 1],
+                             list.begin() + bounds[run_itr + 2], cmp);
+        });
+      }
+    }
+    merged_bounds.push_back(bounds.back());
+
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    bounds = std::move(merged_bounds);
+  }
+}
+
+}  // namespace
+
 BWTREE_TEMPLATE_ARGUMENTS
 BWTREE_INDEX_TYPE::BWTreeIndex(IndexMetadata *metadata)
     :  // Base class
@@ -35,7 +108,9 @@ BWTREE_INDEX_TYPE::BWTreeIndex(IndexMetadata *metadata)
       //
       // NOTE 2: We set the first parameter to false to disable automatic GC
       //
-      container{false, comparator, equals, hash_func} {
+      container{false, comparator, equals, hash_func},
+      read_op_count{0},
+      write_op_count{0} {
   return;
 }
 
@@ -54,6 +129,7 @@ bool BWTREE_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
   index_key.SetFromKey(key);
 
   bool ret = container.Insert(index_key, value);
+  CountWrite();
 
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
@@ -77,6 +153,7 @@ bool BWTREE_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
   // In Delete() since we just use the value for comparison (i.e. read-only)
   // it is unnecessary for us to allocate memory
   bool ret = container.Delete(index_key, value);
+  CountWrite();
 
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
@@ -99,6 +176,7 @@ bool BWTREE_INDEX_TYPE::CondInsertEntry(
   // returns true for some value
   bool ret = container.ConditionalInsert(index_key, value, predicate,
                                          &predicate_satisfied);
+  CountWrite();
 
   // If predicate is not satisfied then we know insertion successes
   if (predicate_satisfied == false) {
@@ -115,6 +193,48 @@ bool BWTREE_INDEX_TYPE::CondInsertEntry(
   return ret;
 }
 
+/*
+ * BulkLoad() - Sort the pairs by key and build the BwTree bottom-up
+ *
+ * This only works on an empty index, see BwTree::BulkLoad()
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+bool BWTREE_INDEX_TYPE::BulkLoad(
+    const std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer *>>
+        &entries) {
+  std::vector<std::pair<KeyType, ValueType>> kv_list(entries.size());
+  for (size_t entry_itr = 0; entry_itr < entries.size(); entry_itr++) {
+    kv_list[entry_itr].first.SetFromKey(entries[entry_itr].first.get());
+    kv_list[entry_itr].second = entries[entry_itr].second;
+  }
+
+  ParallelSort(kv_list, [this](const std::pair<KeyType, ValueType> &lhs,
+                               const std::pair<KeyType, ValueType> &rhs) {
+    return comparator(lhs.first, rhs.first);
+  });
+
+  // Duplicate keys of a unique index are left to CondInsertEntry(), which
+  // checks them against the visible versions
+  if (HasUniqueKeys() == true) {
+    for (size_t kv_itr = 1; kv_itr < kv_list.size(); kv_itr++) {
+      if (equals(kv_list[kv_itr - 1].first, kv_list[kv_itr].first) == true) {
+        return false;
+      }
+    }
+  }
+
+  bool ret = container.BulkLoad(kv_list);
+
+  if (ret == true && FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    for (size_t kv_itr = 0; kv_itr < kv_list.size(); kv_itr++) {
+      stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(
+          metadata);
+    }
+  }
+
+  return ret;
+}
+
 /*
  * Scan() - Scans a range inside the index using index scan optimizer
  *
@@ -182,6 +302,8 @@ void BWTREE_INDEX_TYPE::Scan(
     }
   }  // if is full scan
 
+  read_op_count.fetch_add(1, std::memory_order_relaxed);
+
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
         result.size(), metadata);
@@ -190,14 +312,78 @@ void BWTREE_INDEX_TYPE::Scan(
   return;
 }
 
+/*
+ * ScanWithKeys() - Scans like Scan() does, and also returns the keys
+ *
+ * The values of the key columns of the i-th result are stored at
+ * [i * key column count, (i + 1) * key column count) of key_value_list.
+ * Values found by a point query all share the point query key
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+bool BWTREE_INDEX_TYPE::ScanWithKeys(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    std::vector<ValueType> &result, std::vector<type::Value> &key_value_list,
+    const ConjunctionScanPredicate *csp_p) {
+  const catalog::Schema *key_schema = metadata->GetKeySchema();
+  oid_t key_column_count = key_schema->GetColumnCount();
+
+  size_t start_size = result.size();
+
+  if (csp_p->IsPointQuery() == true) {
+    const storage::Tuple *point_query_key_p = csp_p->GetPointQueryKey();
+
+    KeyType point_query_key;
+    point_query_key.SetFromKey(point_query_key_p);
+
+    container.GetValue(point_query_key, result);
+
+    for (size_t i = start_size; i < result.size(); i++) {
+      for (oid_t column_id = 0; column_id < key_column_count; column_id++) {
+        key_value_list.push_back(point_query_key_p->GetValue(column_id));
+      }
+    }
+  } else {
+    KeyType index_low_key;
+    KeyType index_high_key;
+
+    bool is_full_scan = csp_p->IsFullIndexScan();
+    if (is_full_scan == false) {
+      index_low_key.SetFromKey(csp_p->GetLowKey());
+      index_high_key.SetFromKey(csp_p->GetHighKey());
+    }
+
+    for (auto scan_itr = (is_full_scan == true ? container.Begin()
+                                               : container.Begin(index_low_key));
+         (scan_itr.IsEnd() == false) &&
+             (is_full_scan == true ||
+              container.KeyCmpLessEqual(scan_itr->first, index_high_key));
+         scan_itr++) {
+      result.push_back(scan_itr->second);
+
+      for (oid_t column_id = 0; column_id < key_column_count; column_id++) {
+        key_value_list.push_back(scan_itr->first.ToValue(key_schema, column_id));
+      }
+    }
+  }
+
+  read_op_count.fetch_add(1, std::memory_order_relaxed);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size() - start_size, metadata);
+  }
+
+  return true;
+}
+
 /*
  * ScanLimit() - Scan the index with predicate and limit/offset
  *
- * This function scans the index using the given index optimizer's low key and
- * high key. In addition to merely doing the scan, it checks scan direction
- * and uses either begin() or end() iterator to scan the index, and stops
- * after offset + limit elements are scanned, and limit elements are finally
- * returned
+ * The index is scanned from the low key forward, or from the high key
+ * backward, and the scan stops after offset + limit elements. The first
+ * offset elements are skipped.
  */
 BWTREE_TEMPLATE_ARGUMENTS
 void BWTREE_INDEX_TYPE::ScanLimit(
@@ -206,34 +392,66 @@ void BWTREE_INDEX_TYPE::ScanLimit(
     const std::vector<ExpressionType> &expr_list,
     ScanDirectionType scan_direction, std::vector<ValueType> &result,
     const ConjunctionScanPredicate *csp_p, uint64_t limit, uint64_t offset) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
 
-  // Only work with limit == 1 and offset == 0
-  // Because that gets translated to "min"
-  // But still since we could not access tuples in the table
-  // the index just fetches the first qualified key without further checking
-  // including checking for non-exact bounds!!!
-  if (csp_p->IsPointQuery() == false && limit == 1 && offset == 0 &&
-      scan_direction == ScanDirectionType::FORWARD) {
-    const storage::Tuple *low_key_p = csp_p->GetLowKey();
-    const storage::Tuple *high_key_p = csp_p->GetHighKey();
-
-    LOG_TRACE("ScanLimit() special case (limit = 1; offset = 0; ASCENDING): %s",
-              low_key_p->GetInfo().c_str());
-
-    KeyType index_low_key;
-    KeyType index_high_key;
-    index_low_key.SetFromKey(low_key_p);
-    index_high_key.SetFromKey(high_key_p);
+  // A point query or a full scan has to look at all its values anyway
+  if (csp_p->IsPointQuery() == true || csp_p->IsFullIndexScan() == true) {
+    std::vector<ValueType> values;
+    Scan(value_list, tuple_column_id_list, expr_list, scan_direction, values,
+         csp_p);
+    if (scan_direction == ScanDirectionType::BACKWARD) {
+      std::reverse(values.begin(), values.end());
+    }
+    for (size_t value_itr = offset;
+         value_itr < values.size() && value_itr - offset < limit;
+         value_itr++) {
+      result.push_back(values[value_itr]);
+    }
+    return;
+  }
 
-    auto scan_itr = container.Begin(index_low_key);
-    if ((scan_itr.IsEnd() == false) &&
-        (container.KeyCmpLessEqual(scan_itr->first, index_high_key))) {
+  KeyType index_low_key;
+  KeyType index_high_key;
+  index_low_key.SetFromKey(csp_p->GetLowKey());
+  index_high_key.SetFromKey(csp_p->GetHighKey());
 
-      result.push_back(scan_itr->second);
+  size_t start_size = result.size();
+  uint64_t scan_count = 0;
+  if (scan_direction == ScanDirectionType::FORWARD) {
+    for (auto scan_itr = container.Begin(index_low_key);
+         (scan_itr.IsEnd() == false) &&
+             (container.KeyCmpLessEqual(scan_itr->first, index_high_key)) &&
+             (scan_count < offset || scan_count - offset < limit);
+         scan_itr++) {
+      if (scan_count++ >= offset) {
+        result.push_back(scan_itr->second);
+      }
     }
   } else {
-    Scan(value_list, tuple_column_id_list, expr_list, scan_direction, result,
-         csp_p);
+    // Step over the values of the high key, then walk back from the last one
+    auto scan_itr = container.Begin(index_high_key);
+    while ((scan_itr.IsEnd() == false) &&
+           (container.KeyCmpLessEqual(scan_itr->first, index_high_key))) {
+      scan_itr++;
+    }
+    for (scan_itr--;
+         (scan_itr.IsREnd() == false) &&
+             (container.KeyCmpLessEqual(index_low_key, scan_itr->first)) &&
+             (scan_count < offset || scan_count - offset < limit);
+         scan_itr--) {
+      if (scan_count++ >= offset) {
+        result.push_back(scan_itr->second);
+      }
+    }
+  }
+
+  read_op_count.fetch_add(1, std::memory_order_relaxed);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size() - start_size, metadata);
   }
 
   return;
@@ -249,6 +467,8 @@ void BWTREE_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
     it++;
   }
 
+  read_op_count.fetch_add(1, std::memory_order_relaxed);
+
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
         result.size(), metadata);
@@ -265,6 +485,8 @@ void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
   // This function in BwTree fills a given vector
   container.GetValue(index_key, result);
 
+  read_op_count.fetch_add(1, std::memory_order_relaxed);
+
   if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
     stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
         result.size(), metadata);
@@ -273,9 +495,96 @@ void BWTREE_INDEX_TYPE::ScanKey(const storage::Tuple *key,
   return;
 }
 
+/*
+ * ScanKeys() - Look up a batch of keys with interleaved BwTree traversals
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_INDEX_TYPE::ScanKeys(
+    const std::vector<const storage::Tuple *> &keys,
+    std::vector<std::vector<ValueType>> &results) {
+  std::vector<KeyType> index_keys(keys.size());
+  for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    index_keys[key_itr].SetFromKey(keys[key_itr]);
+  }
+
+  container.GetValueBatch(index_keys, results);
+
+  read_op_count.fetch_add(keys.size(), std::memory_order_relaxed);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    for (auto &result : results) {
+      stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+          result.size(), metadata);
+    }
+  }
+
+  return;
+}
+
 BWTREE_TEMPLATE_ARGUMENTS
 std::string BWTREE_INDEX_TYPE::GetTypeName() const { return "BWTree"; }
 
+BWTREE_TEMPLATE_ARGUMENTS
+IndexStructureStats BWTREE_INDEX_TYPE::GetStructureStats() {
+  IndexStructureStats structure_stats;
+  structure_stats.consolidation_count = container.GetConsolidationCount();
+  structure_stats.split_count = container.GetSplitCount();
+  structure_stats.merge_count = container.GetMergeCount();
+  structure_stats.cas_failure_count = container.GetCASFailureCount();
+  structure_stats.epoch_count = container.GetEpochCount();
+  structure_stats.garbage_node_count = container.GetGarbageNodeCount();
+  structure_stats.delta_chain_threshold =
+      container.GetLeafDeltaChainLengthThreshold();
+  return structure_stats;
+}
+
+/*
+ * CountWrite() - Count a write, and tune the thresholds of the tree every
+ *                TUNING_WRITE_INTERVAL writes
+ *
+ * Only the thread whose write reaches the interval tunes, so the counters
+ * are not reset twice for one interval
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_INDEX_TYPE::CountWrite() {
+  if (write_op_count.fetch_add(1, std::memory_order_relaxed) + 1 ==
+      TUNING_WRITE_INTERVAL) {
+    TuneThresholds();
+  }
+}
+
+/*
+ * TuneThresholds() - Choose the delta chain length of leaf nodes from the
+ *                    read/write mix since the last call
+ *
+ * Read-only workloads never get here, but they do not grow delta chains
+ * either
+ */
+BWTREE_TEMPLATE_ARGUMENTS
+void BWTREE_INDEX_TYPE::TuneThresholds() {
+  uint64_t read_count = read_op_count.exchange(0);
+  uint64_t write_count = write_op_count.exchange(0);
+  uint64_t op_count = read_count + write_count;
+  if (op_count == 0) {
+    return;
+  }
+
+  int threshold = LEAF_DELTA_CHAIN_LENGTH_THRESHOLD;
+  if (write_count * 10 < op_count) {
+    threshold = READ_MOSTLY_DELTA_CHAIN_LENGTH;
+  } else if (write_count * 2 > op_count) {
+    threshold = WRITE_MOSTLY_DELTA_CHAIN_LENGTH;
+  }
+
+  if (threshold != container.GetLeafDeltaChainLengthThreshold()) {
+    LOG_DEBUG("Index %s: delta chain length threshold %d -> %d (%lu reads, "
+              "%lu writes)",
+              GetName().c_str(), container.GetLeafDeltaChainLengthThreshold(),
+              threshold, read_count, write_count);
+    container.SetLeafDeltaChainLengthThreshold(threshold);
+  }
+}
+
 // IMPORTANT: Make sure you don't exceed CompactIntegerKey_MAX_SLOTS
 
 template class BWTreeIndex<CompactIntsKey<1>, ItemPointer *,
@@ -308,10 +617,18 @@ template class BWTreeIndex<GenericKey<16>, ItemPointer *,
                            FastGenericComparator<16>,
                            GenericEqualityChecker<16>, GenericHasher<16>,
                            ItemPointerComparator, ItemPointerHashFunc>;
+template class BWTreeIndex<GenericKey<32>, ItemPointer *,
+                           FastGenericComparator<32>,
+                           GenericEqualityChecker<32>, GenericHasher<32>,
+                           ItemPointerComparator, ItemPointerHashFunc>;
 template class BWTreeIndex<GenericKey<64>, ItemPointer *,
                            FastGenericComparator<64>,
                            GenericEqualityChecker<64>, GenericHasher<64>,
                            ItemPointerComparator, ItemPointerHashFunc>;
+template class BWTreeIndex<GenericKey<128>, ItemPointer *,
+                           FastGenericComparator<128>,
+                           GenericEqualityChecker<128>, GenericHasher<128>,
+                           ItemPointerComparator, ItemPointerHashFunc>;
 template class BWTreeIndex<GenericKey<256>, ItemPointer *,
                            FastGenericComparator<256>,
                            GenericEqualityChecker<256>, GenericHasher<256>,
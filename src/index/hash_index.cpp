@@ -0,0 +1,355 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.cpp
+//
+// Identification: src/index/hash_index.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include "index/hash_index.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "index/index_key.h"
+#include "index/scan_optimizer.h"
+#include "statistics/stats_aggregator.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace index {
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+HASH_INDEX_TYPE::HashIndex(IndexMetadata *metadata)
+    :  // Base class
+      Index{metadata},
+      // Key "less than" relation comparator
+      comparator{},
+      // Key equality checker
+      equals{},
+      // Value equality checker
+      value_equals{},
+      container{} {
+  return;
+}
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+HASH_INDEX_TYPE::~HashIndex() {}
+
+/*
+ * InsertEntry() - insert a key-value pair into the map
+ *
+ * If the key value pair already exists in the map, or the index is unique
+ * and the key has a value, just return false
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
+                                  ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool unique_keys = metadata->HasUniqueKeys();
+
+  // The values of the key are checked and extended under its bucket lock,
+  // the key is inserted with the value if it is not in yet
+  bool ret = true;
+  container.upsert(index_key,
+                   [this, value, unique_keys, &ret](std::vector<ValueType> &values) {
+                     for (auto &existing_value : values) {
+                       if (unique_keys == true ||
+                           value_equals(existing_value, value) == true) {
+                         ret = false;
+                         return;
+                       }
+                     }
+                     values.push_back(value);
+                   },
+                   std::vector<ValueType>{value});
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  return ret;
+}
+
+/*
+ * DeleteEntry() - Removes a key-value pair
+ *
+ * If the key-value pair does not exists yet in the map return false
+ *
+ * NOTE: A key whose values are all deleted stays in the map with no value,
+ * since erasing it could race with an insert of the key
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
+                                  ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = false;
+  container.update_fn(index_key,
+                      [this, value, &ret](std::vector<ValueType> &values) {
+                        for (auto value_itr = values.begin();
+                             value_itr != values.end(); value_itr++) {
+                          if (value_equals(*value_itr, value) == true) {
+                            values.erase(value_itr);
+                            ret = true;
+                            return;
+                          }
+                        }
+                      });
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
+        ret == true ? 1 : 0, metadata);
+  }
+  return ret;
+}
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+bool HASH_INDEX_TYPE::CondInsertEntry(
+    const storage::Tuple *key, ItemPointer *value,
+    std::function<bool(const void *)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // The predicate is checked against the values of the key and the value
+  // inserted under the same bucket lock
+  bool ret = true;
+  container.upsert(index_key,
+                   [this, value, &predicate, &ret](std::vector<ValueType> &values) {
+                     for (auto &existing_value : values) {
+                       if (predicate(existing_value) == true ||
+                           value_equals(existing_value, value) == true) {
+                         ret = false;
+                         return;
+                       }
+                     }
+                     values.push_back(value);
+                   },
+                   std::vector<ValueType>{value});
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
+  return ret;
+}
+
+/*
+ * Scan() - Scans a range inside the index using index scan optimizer
+ *
+ * A point query is a single lookup. Any other scan walks the whole map, and
+ * the values come in no particular order
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::Scan(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  if (csp_p->IsPointQuery() == true) {
+    KeyType point_query_key;
+    point_query_key.SetFromKey(csp_p->GetPointQueryKey());
+
+    std::vector<ValueType> values;
+    if (container.find(point_query_key, values) == true) {
+      result.insert(result.end(), values.begin(), values.end());
+    }
+  } else {
+    std::vector<std::pair<KeyType, ValueType>> pairs;
+    ScanRange(csp_p, false, pairs);
+    for (auto &pair : pairs) {
+      result.push_back(pair.second);
+    }
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
+  return;
+}
+
+/*
+ * ScanLimit() - Scan the index with predicate and limit/offset
+ *
+ * The offset and limit apply in key order in the direction of the scan, so
+ * the pairs of a scan that is not a point query are sorted first
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanLimit(
+    UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
+    UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
+    UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p, uint64_t limit, uint64_t offset) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  std::vector<ValueType> values;
+  if (csp_p->IsPointQuery() == true) {
+    KeyType point_query_key;
+    point_query_key.SetFromKey(csp_p->GetPointQueryKey());
+
+    container.find(point_query_key, values);
+  } else {
+    std::vector<std::pair<KeyType, ValueType>> pairs;
+    ScanRange(csp_p, true, pairs);
+    for (auto &pair : pairs) {
+      values.push_back(pair.second);
+    }
+  }
+
+  if (scan_direction == ScanDirectionType::BACKWARD) {
+    std::reverse(values.begin(), values.end());
+  }
+
+  for (uint64_t value_itr = offset;
+       value_itr < values.size() && value_itr - offset < limit; value_itr++) {
+    result.push_back(values[value_itr]);
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
+  return;
+}
+
+/*
+ * ScanRange() - Collect the pairs whose key is in the range of the scan
+ *               predicate
+ *
+ * The map is locked as a whole while it is walked
+ */
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanRange(
+    const ConjunctionScanPredicate *csp_p, bool is_ordered,
+    std::vector<std::pair<KeyType, ValueType>> &pairs) {
+  bool is_full_scan = csp_p->IsFullIndexScan();
+
+  KeyType index_low_key;
+  KeyType index_high_key;
+  if (is_full_scan == false) {
+    index_low_key.SetFromKey(csp_p->GetLowKey());
+    index_high_key.SetFromKey(csp_p->GetHighKey());
+  }
+
+  {
+    auto locked_table = container.lock_table();
+    for (auto &entry : locked_table) {
+      if (is_full_scan == false &&
+          (comparator(entry.first, index_low_key) == true ||
+           comparator(index_high_key, entry.first) == true)) {
+        continue;
+      }
+      for (auto &value : entry.second) {
+        pairs.emplace_back(entry.first, value);
+      }
+    }
+  }
+
+  if (is_ordered == true) {
+    std::stable_sort(pairs.begin(), pairs.end(),
+                     [this](const std::pair<KeyType, ValueType> &pair1,
+                            const std::pair<KeyType, ValueType> &pair2) {
+                       return comparator(pair1.first, pair2.first);
+                     });
+  }
+}
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
+  {
+    auto locked_table = container.lock_table();
+    for (auto &entry : locked_table) {
+      result.insert(result.end(), entry.second.begin(), entry.second.end());
+    }
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+  return;
+}
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+void HASH_INDEX_TYPE::ScanKey(const storage::Tuple *key,
+                              std::vector<ValueType> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  std::vector<ValueType> values;
+  if (container.find(index_key, values) == true) {
+    result.insert(result.end(), values.begin(), values.end());
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
+  return;
+}
+
+HASH_INDEX_TEMPLATE_ARGUMENTS
+std::string HASH_INDEX_TYPE::GetTypeName() const { return "Hash"; }
+
+// IMPORTANT: Make sure you don't exceed CompactIntegerKey_MAX_SLOTS
+
+template class HashIndex<CompactIntsKey<1>, ItemPointer *,
+                         CompactIntsComparator<1>,
+                         CompactIntsEqualityChecker<1>, CompactIntsHasher<1>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<2>, ItemPointer *,
+                         CompactIntsComparator<2>,
+                         CompactIntsEqualityChecker<2>, CompactIntsHasher<2>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<3>, ItemPointer *,
+                         CompactIntsComparator<3>,
+                         CompactIntsEqualityChecker<3>, CompactIntsHasher<3>,
+                         ItemPointerComparator>;
+template class HashIndex<CompactIntsKey<4>, ItemPointer *,
+                         CompactIntsComparator<4>,
+                         CompactIntsEqualityChecker<4>, CompactIntsHasher<4>,
+                         ItemPointerComparator>;
+
+// Generic key
+template class HashIndex<GenericKey<4>, ItemPointer *,
+                         FastGenericComparator<4>, GenericEqualityChecker<4>,
+                         GenericHasher<4>, ItemPointerComparator>;
+template class HashIndex<GenericKey<8>, ItemPointer *,
+                         FastGenericComparator<8>, GenericEqualityChecker<8>,
+                         GenericHasher<8>, ItemPointerComparator>;
+template class HashIndex<GenericKey<16>, ItemPointer *,
+                         FastGenericComparator<16>, GenericEqualityChecker<16>,
+                         GenericHasher<16>, ItemPointerComparator>;
+template class HashIndex<GenericKey<64>, ItemPointer *,
+                         FastGenericComparator<64>, GenericEqualityChecker<64>,
+                         GenericHasher<64>, ItemPointerComparator>;
+template class HashIndex<GenericKey<256>, ItemPointer *,
+                         FastGenericComparator<256>,
+                         GenericEqualityChecker<256>, GenericHasher<256>,
+                         ItemPointerComparator>;
+
+// Tuple key
+template class HashIndex<TupleKey, ItemPointer *, TupleKeyComparator,
+                         TupleKeyEqualityChecker, TupleKeyHasher,
+                         ItemPointerComparator>;
+
+}  // End index namespace
+}  // End peloton namespace
@@ -15,7 +15,9 @@
 
 #include "catalog/manager.h"
 #include "catalog/schema.h"
+#include "expression/tuple_value_expression.h"
 #include "index/scan_optimizer.h"
+#include "statistics/access_counter_slab.h"
 #include "storage/tuple.h"
 #include "type/ephemeral_pool.h"
 
@@ -62,6 +64,7 @@ IndexMetadata::IndexMetadata(std::string index_name, oid_t index_oid,
       key_attrs(key_attrs),
       tuple_attrs(),
       unique_keys(unique_keys),
+      stats_slot_id_(stats::AccessCounterSlab::GetNextSlotId()),
       visible_(IndexMetadata::index_default_visibility) {
   // Push the reverse mapping relation into tuple_attrs which maps
   // tuple key's column into index key's column
@@ -100,6 +103,38 @@ IndexMetadata::~IndexMetadata() {
   return;
 }
 
+// Collects the columns of the tuple value expressions in the predicate
+static void GetExpressionColumns(const expression::AbstractExpression *expr,
+                                 std::set<oid_t> &column_ids) {
+  if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    auto tuple_expr =
+        static_cast<const expression::TupleValueExpression *>(expr);
+    column_ids.insert(static_cast<oid_t>(tuple_expr->GetColumnId()));
+  }
+
+  for (size_t child_itr = 0; child_itr < expr->GetChildrenSize();
+       child_itr++) {
+    GetExpressionColumns(expr->GetChild(child_itr), column_ids);
+  }
+}
+
+void IndexMetadata::SetPredicate(
+    std::shared_ptr<const expression::AbstractExpression> predicate) {
+  predicate_ = predicate;
+  predicate_columns_.clear();
+  if (predicate_ != nullptr) {
+    GetExpressionColumns(predicate_.get(), predicate_columns_);
+  }
+}
+
+bool IndexMetadata::SatisfiesPredicate(const AbstractTuple *tuple) const {
+  if (predicate_ == nullptr) {
+    return true;
+  }
+
+  return predicate_->Evaluate(tuple, nullptr, nullptr).IsTrue();
+}
+
 const std::string IndexMetadata::GetInfo() const {
   std::stringstream os;
 
@@ -110,7 +145,8 @@ const std::string IndexMetadata::GetInfo() const {
      << "ConstraintType=" << IndexConstraintTypeToString(index_constraint_type_)
      << ", "
      << "UtilityRatio=" << utility_ratio << ", "
-     << "Visible=" << visible_ << "]";
+     << "Visible=" << visible_ << ", "
+     << "Partial=" << (predicate_ != nullptr) << "]";
 
   os << " -> " << key_schema->GetInfo();
 
@@ -202,6 +238,21 @@ void Index::ScanTest(const std::vector<type::Value> &value_list,
   return;
 }
 
+/*
+ * ScanKeys() - Scan the keys of a batch one by one
+ */
+void Index::ScanKeys(const std::vector<const storage::Tuple *> &keys,
+                     std::vector<std::vector<ItemPointer *>> &results) {
+  results.clear();
+  results.resize(keys.size());
+
+  for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+    ScanKey(keys[key_itr], results[key_itr]);
+  }
+
+  return;
+}
+
 /*
  * Compare() - Check whether a given index key satisfies a predicate
  *
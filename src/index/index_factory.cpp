@@ -16,7 +16,9 @@
 
 #include "common/logger.h"
 #include "common/macros.h"
+#include "index/art_index.h"
 #include "index/bwtree_index.h"
+#include "index/hash_index.h"
 #include "index/index_factory.h"
 #include "index/index_key.h"
 #include "index/skiplist_index.h"
@@ -76,6 +78,27 @@ Index *IndexFactory::GetIndex(IndexMetadata *metadata) {
       index = IndexFactory::GetSkipListGenericKeyIndex(metadata);
     }
 
+  // -----------------------
+  // HASH
+  // -----------------------
+  } else if (index_type == IndexType::HASH) {
+    if (ints_only) {
+      index = IndexFactory::GetHashIntsKeyIndex(metadata);
+    } else {
+      index = IndexFactory::GetHashGenericKeyIndex(metadata);
+    }
+
+  // -----------------------
+  // ART
+  // -----------------------
+  } else if (index_type == IndexType::ART) {
+    // The bytes of the other keys do not compare like the keys
+    if (ints_only) {
+      index = IndexFactory::GetARTIntsKeyIndex(metadata);
+    } else {
+      throw IndexException("ART index only supports integer keys");
+    }
+
   // -----------------------
   // ERROR
   // -----------------------
@@ -157,6 +180,8 @@ Index *IndexFactory::GetBwTreeGenericKeyIndex(IndexMetadata *metadata) {
   std::string comparatorType;
 #endif
 
+  // Every node holds full copies of its keys, so the sizes are close enough
+  // for the padding of a composite key not to outweigh the key itself
   if (key_size <= 4) {
 #ifdef LOG_TRACE_ENABLED
     comparatorType = "GenericKey<4>";
@@ -182,6 +207,15 @@ Index *IndexFactory::GetBwTreeGenericKeyIndex(IndexMetadata *metadata) {
                         FastGenericComparator<16>, GenericEqualityChecker<16>,
                         GenericHasher<16>, ItemPointerComparator,
                         ItemPointerHashFunc>(metadata);
+  } else if (key_size <= 32) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<32>";
+#endif
+    index =
+        new BWTreeIndex<GenericKey<32>, ItemPointer *,
+                        FastGenericComparator<32>, GenericEqualityChecker<32>,
+                        GenericHasher<32>, ItemPointerComparator,
+                        ItemPointerHashFunc>(metadata);
   } else if (key_size <= 64) {
 #ifdef LOG_TRACE_ENABLED
     comparatorType = "GenericKey<64>";
@@ -191,6 +225,15 @@ Index *IndexFactory::GetBwTreeGenericKeyIndex(IndexMetadata *metadata) {
                         FastGenericComparator<64>, GenericEqualityChecker<64>,
                         GenericHasher<64>, ItemPointerComparator,
                         ItemPointerHashFunc>(metadata);
+  } else if (key_size <= 128) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<128>";
+#endif
+    index =
+        new BWTreeIndex<GenericKey<128>, ItemPointer *,
+                        FastGenericComparator<128>, GenericEqualityChecker<128>,
+                        GenericHasher<128>, ItemPointerComparator,
+                        ItemPointerHashFunc>(metadata);
   } else if (key_size <= 256) {
 #ifdef LOG_TRACE_ENABLED
     comparatorType = "GenericKey<256>";
@@ -342,6 +385,176 @@ Index *IndexFactory::GetSkipListGenericKeyIndex(IndexMetadata *metadata) {
   return (index);
 }
 
+Index *IndexFactory::GetHashIntsKeyIndex(IndexMetadata *metadata) {
+  // Our new Index!
+  Index *index = nullptr;
+
+  // The size of the key in bytes
+  const auto key_size = metadata->key_schema->GetLength();
+
+// Debug Output
+#ifdef LOG_TRACE_ENABLED
+  std::string comparatorType;
+#endif
+
+  if (key_size <= sizeof(uint64_t)) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<1>";
+#endif
+    index = new HashIndex<CompactIntsKey<1>, ItemPointer *,
+                          CompactIntsComparator<1>,
+                          CompactIntsEqualityChecker<1>, CompactIntsHasher<1>,
+                          ItemPointerComparator>(metadata);
+  } else if (key_size <= sizeof(uint64_t) * 2) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<2>";
+#endif
+    index = new HashIndex<CompactIntsKey<2>, ItemPointer *,
+                          CompactIntsComparator<2>,
+                          CompactIntsEqualityChecker<2>, CompactIntsHasher<2>,
+                          ItemPointerComparator>(metadata);
+  } else if (key_size <= sizeof(uint64_t) * 3) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<3>";
+#endif
+    index = new HashIndex<CompactIntsKey<3>, ItemPointer *,
+                          CompactIntsComparator<3>,
+                          CompactIntsEqualityChecker<3>, CompactIntsHasher<3>,
+                          ItemPointerComparator>(metadata);
+  } else if (key_size <= sizeof(uint64_t) * 4) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<4>";
+#endif
+    index = new HashIndex<CompactIntsKey<4>, ItemPointer *,
+                          CompactIntsComparator<4>,
+                          CompactIntsEqualityChecker<4>, CompactIntsHasher<4>,
+                          ItemPointerComparator>(metadata);
+  } else {
+    throw IndexException("Unsupported IntsKey scheme");
+  }
+
+#ifdef LOG_TRACE_ENABLED
+  LOG_TRACE("%s", IndexFactory::GetInfo(metadata, comparatorType).c_str());
+#endif
+  return (index);
+}
+
+Index *IndexFactory::GetHashGenericKeyIndex(IndexMetadata *metadata) {
+  // Our new Index!
+  Index *index = nullptr;
+
+  // The size of the key in bytes
+  const auto key_size = metadata->key_schema->GetLength();
+
+// Debug Output
+#ifdef LOG_TRACE_ENABLED
+  std::string comparatorType;
+#endif
+
+  if (key_size <= 4) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<4>";
+#endif
+    index = new HashIndex<GenericKey<4>, ItemPointer *,
+                          FastGenericComparator<4>, GenericEqualityChecker<4>,
+                          GenericHasher<4>, ItemPointerComparator>(metadata);
+  } else if (key_size <= 8) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<8>";
+#endif
+    index = new HashIndex<GenericKey<8>, ItemPointer *,
+                          FastGenericComparator<8>, GenericEqualityChecker<8>,
+                          GenericHasher<8>, ItemPointerComparator>(metadata);
+  } else if (key_size <= 16) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<16>";
+#endif
+    index = new HashIndex<GenericKey<16>, ItemPointer *,
+                          FastGenericComparator<16>, GenericEqualityChecker<16>,
+                          GenericHasher<16>, ItemPointerComparator>(metadata);
+  } else if (key_size <= 64) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<64>";
+#endif
+    index = new HashIndex<GenericKey<64>, ItemPointer *,
+                          FastGenericComparator<64>, GenericEqualityChecker<64>,
+                          GenericHasher<64>, ItemPointerComparator>(metadata);
+  } else if (key_size <= 256) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "GenericKey<256>";
+#endif
+    index = new HashIndex<GenericKey<256>, ItemPointer *,
+                          FastGenericComparator<256>, GenericEqualityChecker<256>,
+                          GenericHasher<256>, ItemPointerComparator>(metadata);
+  } else {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "TupleKey";
+#endif
+    index = new HashIndex<TupleKey, ItemPointer *, TupleKeyComparator,
+                          TupleKeyEqualityChecker, TupleKeyHasher,
+                          ItemPointerComparator>(metadata);
+  }
+
+#ifdef LOG_TRACE_ENABLED
+  LOG_TRACE("%s", IndexFactory::GetInfo(metadata, comparatorType).c_str());
+#endif
+  return (index);
+}
+
+Index *IndexFactory::GetARTIntsKeyIndex(IndexMetadata *metadata) {
+  // Our new Index!
+  Index *index = nullptr;
+
+  // The size of the key in bytes
+  const auto key_size = metadata->key_schema->GetLength();
+
+// Debug Output
+#ifdef LOG_TRACE_ENABLED
+  std::string comparatorType;
+#endif
+
+  if (key_size <= sizeof(uint64_t)) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<1>";
+#endif
+    index = new ARTIndex<CompactIntsKey<1>, ItemPointer *,
+                         CompactIntsComparator<1>,
+                         CompactIntsEqualityChecker<1>, ItemPointerComparator>(
+        metadata);
+  } else if (key_size <= sizeof(uint64_t) * 2) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<2>";
+#endif
+    index = new ARTIndex<CompactIntsKey<2>, ItemPointer *,
+                         CompactIntsComparator<2>,
+                         CompactIntsEqualityChecker<2>, ItemPointerComparator>(
+        metadata);
+  } else if (key_size <= sizeof(uint64_t) * 3) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<3>";
+#endif
+    index = new ARTIndex<CompactIntsKey<3>, ItemPointer *,
+                         CompactIntsComparator<3>,
+                         CompactIntsEqualityChecker<3>, ItemPointerComparator>(
+        metadata);
+  } else if (key_size <= sizeof(uint64_t) * 4) {
+#ifdef LOG_TRACE_ENABLED
+    comparatorType = "CompactIntsKey<4>";
+#endif
+    index = new ARTIndex<CompactIntsKey<4>, ItemPointer *,
+                         CompactIntsComparator<4>,
+                         CompactIntsEqualityChecker<4>, ItemPointerComparator>(
+        metadata);
+  } else {
+    throw IndexException("Unsupported IntsKey scheme");
+  }
+
+#ifdef LOG_TRACE_ENABLED
+  LOG_TRACE("%s", IndexFactory::GetInfo(metadata, comparatorType).c_str());
+#endif
+  return (index);
+}
+
 std::string IndexFactory::GetInfo(IndexMetadata *metadata,
                                   std::string comparatorType) {
   std::ostringstream os;
@@ -15,7 +15,7 @@
 namespace peloton {
 namespace index {
 
-// Add your function definitions here
+// The skip list is a template, see skiplist.h
 
 }  // End index namespace
 }  // End peloton namespace
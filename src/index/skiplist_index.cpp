@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 #include "index/skiplist_index.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "common/logger.h"
 #include "index/index_key.h"
 #include "index/scan_optimizer.h"
@@ -27,8 +30,10 @@ SKIPLIST_INDEX_TYPE::SkipListIndex(IndexMetadata *metadata)
       // Key "less than" relation comparator
       comparator{},
       // Key equality checker
-      equals{} {
-  // TODO: Add your implementation here
+      equals{},
+      // A unique index holds a single pair per key, bar the versions
+      // inserted through CondInsertEntry()
+      container{metadata->HasUniqueKeys(), comparator, equals} {
   return;
 }
 
@@ -41,11 +46,17 @@ SKIPLIST_INDEX_TYPE::~SkipListIndex() {}
  * If the key value pair already exists in the map, just return false
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
-bool SKIPLIST_INDEX_TYPE::InsertEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value) {
-  bool ret = false;
-  // TODO: Add your implementation here
+bool SKIPLIST_INDEX_TYPE::InsertEntry(const storage::Tuple *key,
+                                      ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Insert(index_key, value);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
   return ret;
 }
 
@@ -55,69 +66,210 @@ bool SKIPLIST_INDEX_TYPE::InsertEntry(
  * If the key-value pair does not exists yet in the map return false
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
-bool SKIPLIST_INDEX_TYPE::DeleteEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value) {
-  bool ret = false;
-  // TODO: Add your implementation here
+bool SKIPLIST_INDEX_TYPE::DeleteEntry(const storage::Tuple *key,
+                                      ItemPointer *value) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool ret = container.Delete(index_key, value);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexDeletes(
+        ret == true ? 1 : 0, metadata);
+  }
   return ret;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
 bool SKIPLIST_INDEX_TYPE::CondInsertEntry(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE ItemPointer *value,
-    UNUSED_ATTRIBUTE std::function<bool(const void *)> predicate) {
-  bool ret = false;
-  // TODO: Add your implementation here
+    const storage::Tuple *key, ItemPointer *value,
+    std::function<bool(const void *)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  bool predicate_satisfied = false;
+
+  // The predicate is checked against the values of the key and the value
+  // inserted in one step
+  bool ret = container.ConditionalInsert(index_key, value, predicate,
+                                         &predicate_satisfied);
+
+  if (predicate_satisfied == true) {
+    assert(ret == false);
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexInserts(metadata);
+  }
+
   return ret;
 }
 
 /*
  * Scan() - Scans a range inside the index using index scan optimizer
  *
+ * The scan optimizer specifies whether a scan is point query, full scan
+ * or interval scan. Forward scans walk the skip list from the low key,
+ * backward scans walk it back from the high key
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
 void SKIPLIST_INDEX_TYPE::Scan(
     UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
     UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
     UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
-    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result,
-    UNUSED_ATTRIBUTE const ConjunctionScanPredicate *csp_p) {
-  // TODO: Add your implementation here
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  ScanRange(csp_p, scan_direction, std::numeric_limits<uint64_t>::max(), 0,
+            result);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
   return;
 }
 
 /*
  * ScanLimit() - Scan the index with predicate and limit/offset
  *
+ * The scan stops after offset + limit elements, and the first offset
+ * elements are skipped
  */
 SKIPLIST_TEMPLATE_ARGUMENTS
 void SKIPLIST_INDEX_TYPE::ScanLimit(
     UNUSED_ATTRIBUTE const std::vector<type::Value> &value_list,
     UNUSED_ATTRIBUTE const std::vector<oid_t> &tuple_column_id_list,
     UNUSED_ATTRIBUTE const std::vector<ExpressionType> &expr_list,
-    UNUSED_ATTRIBUTE ScanDirectionType scan_direction,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result,
-    UNUSED_ATTRIBUTE const ConjunctionScanPredicate *csp_p,
-    UNUSED_ATTRIBUTE uint64_t limit, UNUSED_ATTRIBUTE uint64_t offset) {
-  // TODO: Add your implementation here
+    ScanDirectionType scan_direction, std::vector<ValueType> &result,
+    const ConjunctionScanPredicate *csp_p, uint64_t limit, uint64_t offset) {
+  if (scan_direction == ScanDirectionType::INVALID) {
+    throw Exception("Invalid scan direction \n");
+  }
+
+  ScanRange(csp_p, scan_direction, limit, offset, result);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
   return;
 }
 
+/*
+ * ScanRange() - Fill the values the scan predicate selects, in the order of
+ *               the direction, skipping offset values and up to limit
+ */
+SKIPLIST_TEMPLATE_ARGUMENTS
+void SKIPLIST_INDEX_TYPE::ScanRange(const ConjunctionScanPredicate *csp_p,
+                                    ScanDirectionType scan_direction,
+                                    uint64_t limit, uint64_t offset,
+                                    std::vector<ValueType> &result) {
+  LOG_TRACE("Scan() Point Query = %d; Full Scan = %d ", csp_p->IsPointQuery(),
+            csp_p->IsFullIndexScan());
+
+  if (csp_p->IsPointQuery() == true) {
+    KeyType point_query_key;
+    point_query_key.SetFromKey(csp_p->GetPointQueryKey());
+
+    std::vector<ValueType> values;
+    container.GetValue(point_query_key, values);
+    if (scan_direction == ScanDirectionType::BACKWARD) {
+      std::reverse(values.begin(), values.end());
+    }
+
+    for (size_t value_itr = offset;
+         value_itr < values.size() && value_itr - offset < limit;
+         value_itr++) {
+      result.push_back(values[value_itr]);
+    }
+    return;
+  }
+
+  bool is_full_scan = csp_p->IsFullIndexScan();
+  KeyType index_low_key;
+  KeyType index_high_key;
+  if (is_full_scan == false) {
+    LOG_TRACE("Partial scan low key: %s\n high key: %s",
+              csp_p->GetLowKey()->GetInfo().c_str(),
+              csp_p->GetHighKey()->GetInfo().c_str());
+
+    index_low_key.SetFromKey(csp_p->GetLowKey());
+    index_high_key.SetFromKey(csp_p->GetHighKey());
+  }
+
+  uint64_t scan_count = 0;
+  if (scan_direction == ScanDirectionType::FORWARD) {
+    for (auto scan_itr = is_full_scan == true
+                             ? container.Begin()
+                             : container.Begin(index_low_key);
+         scan_itr.IsEnd() == false; ++scan_itr) {
+      if (is_full_scan == false &&
+          container.KeyCmpLessEqual(scan_itr->first, index_high_key) ==
+              false) {
+        break;
+      }
+      if (scan_count >= offset) {
+        if (scan_count - offset >= limit) {
+          break;
+        }
+        result.push_back(scan_itr->second);
+      }
+      scan_count++;
+    }
+  } else {
+    for (auto scan_itr = is_full_scan == true
+                             ? container.RBegin()
+                             : container.RBegin(index_high_key);
+         scan_itr.IsEnd() == false; ++scan_itr) {
+      if (is_full_scan == false &&
+          container.KeyCmpLessEqual(index_low_key, scan_itr->first) ==
+              false) {
+        break;
+      }
+      if (scan_count >= offset) {
+        if (scan_count - offset >= limit) {
+          break;
+        }
+        result.push_back(scan_itr->second);
+      }
+      scan_count++;
+    }
+  }
+}
+
 SKIPLIST_TEMPLATE_ARGUMENTS
-void SKIPLIST_INDEX_TYPE::ScanAllKeys(
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result) {
-  // TODO: Add your implementation here
+void SKIPLIST_INDEX_TYPE::ScanAllKeys(std::vector<ValueType> &result) {
+  for (auto scan_itr = container.Begin(); scan_itr.IsEnd() == false;
+       ++scan_itr) {
+    result.push_back(scan_itr->second);
+  }
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
   return;
 }
 
 SKIPLIST_TEMPLATE_ARGUMENTS
-void SKIPLIST_INDEX_TYPE::ScanKey(
-    UNUSED_ATTRIBUTE const storage::Tuple *key,
-    UNUSED_ATTRIBUTE std::vector<ValueType> &result) {
-  // TODO: Add your implementation here
+void SKIPLIST_INDEX_TYPE::ScanKey(const storage::Tuple *key,
+                                  std::vector<ValueType> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container.GetValue(index_key, result);
+
+  if (FLAGS_stats_mode != STATS_TYPE_INVALID) {
+    stats::BackendStatsContext::GetInstance()->IncrementIndexReads(
+        result.size(), metadata);
+  }
+
   return;
 }
 
@@ -0,0 +1,180 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// group_commit_manager.cpp
+//
+// Identification: src/logging/group_commit_manager.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/group_commit_manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "common/wait_events.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "logging/log_manager_factory.h"
+
+namespace peloton {
+namespace logging {
+
+// steady clock time (in us)
+static uint64_t GetSteadyTime() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+GroupCommitManager &GroupCommitManager::GetInstance() {
+  static GroupCommitManager group_commit_manager;
+  return group_commit_manager;
+}
+
+GroupCommitManager::GroupCommitManager()
+    : commit_queue(1024), group_commit_stop(true) {}
+
+GroupCommitManager::~GroupCommitManager() {}
+
+void GroupCommitManager::Start() {
+  // Set signal
+  group_commit_stop = false;
+
+  // Launch thread
+  group_commit_thread =
+      std::thread(&logging::GroupCommitManager::Acknowledge, this);
+
+  LOG_INFO("Started group commit");
+}
+
+void GroupCommitManager::Acknowledge() {
+  // Continue till signal is not false
+  while (group_commit_stop == false) {
+    AcknowledgeCommits(GetDurableEpochId());
+
+    // Sleep for an epoch
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH.load()));
+  }
+}
+
+void GroupCommitManager::Stop() {
+  // Stop acknowledging
+  group_commit_stop = true;
+
+  // Stop thread
+  group_commit_thread.join();
+
+  // No more epochs will become durable, acknowledge what is left
+  AcknowledgeCommits(MAX_EID);
+
+  LOG_INFO("Stopped group commit");
+}
+
+void GroupCommitManager::EnqueueCommit(const eid_t epoch_id,
+                                       const CommitCallback &callback) {
+  PendingCommit pending_commit{epoch_id, callback, GetSteadyTime()};
+  commit_queue.Enqueue(pending_commit);
+}
+
+size_t GroupCommitManager::AcknowledgeCommits(const eid_t durable_epoch_id) {
+  std::vector<CommitCallback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(pending_commits_mutex);
+    DrainCommitQueue();
+
+    uint64_t acknowledge_time = GetSteadyTime();
+    auto durable_end = pending_commits.upper_bound(durable_epoch_id);
+    for (auto itr = pending_commits.begin(); itr != durable_end; ++itr) {
+      auto wait_time = acknowledge_time - itr->second.enqueue_time;
+      commit_latencies.Record(wait_time);
+      WaitEvents::RecordWait(WaitEventType::EPOCH_WAIT, wait_time);
+      callbacks.push_back(std::move(itr->second.callback));
+    }
+    pending_commits.erase(pending_commits.begin(), durable_end);
+  }
+
+  // the callbacks may block, so they run without the lock
+  for (auto &callback : callbacks) {
+    callback(ResultType::SUCCESS);
+  }
+
+  LOG_TRACE("Acknowledged %lu commits up to epoch %lu", callbacks.size(),
+            durable_epoch_id);
+  return callbacks.size();
+}
+
+eid_t GroupCommitManager::GetDurableEpochId() {
+  auto expired_epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetExpiredEpochId();
+  auto persistent_epoch_id = LogManagerFactory::GetInstance().GetPersistentEpochId();
+  return std::min(expired_epoch_id, persistent_epoch_id);
+}
+
+size_t GroupCommitManager::GetPendingCommitCount() {
+  std::lock_guard<std::mutex> lock(pending_commits_mutex);
+  DrainCommitQueue();
+  return pending_commits.size();
+}
+
+LatencyHistogram GroupCommitManager::GetCommitLatencies() {
+  std::lock_guard<std::mutex> lock(pending_commits_mutex);
+  return commit_latencies;
+}
+
+void GroupCommitManager::ResetCommitLatencies() {
+  std::lock_guard<std::mutex> lock(pending_commits_mutex);
+  commit_latencies.Reset();
+}
+
+void GroupCommitManager::DrainCommitQueue() {
+  PendingCommit pending_commit;
+  while (commit_queue.Dequeue(pending_commit) == true) {
+    pending_commits.emplace(pending_commit.epoch_id,
+                            std::move(pending_commit));
+  }
+}
+
+CommitCallback CommitWaiter::AddCommit(
+    const std::shared_ptr<CommitWaiter> &self) {
+  PL_ASSERT(self.get() == this);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_count_++;
+  }
+  return [self](const ResultType) { self->Acknowledge(); };
+}
+
+bool CommitWaiter::OnAcknowledged(std::function<void()> callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (pending_count_ == 0) return false;
+  callback_ = std::move(callback);
+  return true;
+}
+
+size_t CommitWaiter::GetPendingCommitCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_count_;
+}
+
+void CommitWaiter::Acknowledge() {
+  std::function<void()> callback;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PL_ASSERT(pending_count_ > 0);
+    if (--pending_count_ == 0) {
+      callback.swap(callback_);
+    }
+  }
+
+  // the client may wait for the next commits from the callback
+  if (callback) callback();
+}
+
+}  // End logging namespace
+}  // End peloton namespace
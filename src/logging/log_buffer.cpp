@@ -25,6 +25,7 @@ bool LogBuffer::WriteData(const char *data, size_t len) {
     PL_ASSERT(len);
     PL_MEMCPY(data_ + size_, data, len);
     size_ += len;
+    frame_count_++;
     return true;
   }
 }
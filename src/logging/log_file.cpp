@@ -0,0 +1,351 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_file.cpp
+//
+// Identification: src/logging/log_file.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/log_file.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "storage/backend_manager.h"
+#include "util/file_util.h"
+
+namespace peloton {
+namespace logging {
+
+const char LogFile::mapping_magic_[8] = {'P', 'L', 'N', 'V', 'M', 'L', 'O', 'G'};
+
+bool LogFile::Open(const std::string &path, const BackendType backend_type) {
+  PL_ASSERT(IsOpen() == false);
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  struct stat file_stat;
+  if (fd < 0 || fstat(fd, &file_stat) != 0) {
+    LOG_ERROR("Cannot open log file %s: %s", path.c_str(), strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+
+  fd_ = fd;
+  path_ = path;
+  PL_ASSERT(pending_.empty() == true);
+
+  // an existing file keeps its layout
+  size_t file_size = file_stat.st_size;
+  MappingHeader header;
+  bool is_mapped = false;
+  if (file_size == 0) {
+    is_mapped = (backend_type == BackendType::NVM);
+  } else if (file_size >= mapping_header_size_ &&
+             pread(fd_, &header, sizeof(header), 0) ==
+                 static_cast<ssize_t>(sizeof(header)) &&
+             memcmp(header.magic, mapping_magic_, sizeof(header.magic)) ==
+                 0) {
+    is_mapped = true;
+  }
+
+  if (is_mapped == false) {
+    backend_type_ =
+        (backend_type == BackendType::NVM ? BackendType::SSD : backend_type);
+    size_ = file_size;
+    allocated_size_ = size_;
+    return true;
+  }
+
+  backend_type_ = BackendType::NVM;
+  if (file_size == 0) {
+    // the header is durable before anything is mapped, so a file is never
+    // left without its magic
+    PL_MEMSET(&header, 0, sizeof(header));
+    PL_MEMCPY(header.magic, mapping_magic_, sizeof(header.magic));
+    if (pwrite(fd_, &header, sizeof(header), 0) !=
+            static_cast<ssize_t>(sizeof(header)) ||
+        fdatasync(fd_) != 0) {
+      LOG_ERROR("Cannot write log file %s: %s", path.c_str(),
+                strerror(errno));
+      close(fd_);
+      fd_ = -1;
+      return false;
+    }
+    file_size = mapping_header_size_;
+  }
+  size_ = std::min<size_t>(header.size, file_size - mapping_header_size_);
+
+  if (MapFile(file_size) == false) {
+    close(fd_);
+    fd_ = -1;
+    return false;
+  }
+  return true;
+}
+
+void LogFile::Close() {
+  if (IsOpen() == false) {
+    return;
+  }
+
+  size_t file_size = size_;
+  if (mapping_ != nullptr) {
+    UnmapFile();
+    file_size += mapping_header_size_;
+  }
+
+  // truncating to the size frees the blocks preallocated past it
+  if (allocated_size_ > file_size && ftruncate(fd_, file_size) != 0) {
+    LOG_ERROR("Cannot truncate log file %s: %s", path_.c_str(),
+              strerror(errno));
+  }
+  close(fd_);
+  fd_ = -1;
+  pending_.clear();
+  pending_size_ = 0;
+}
+
+void LogFile::Append(const char *data, const size_t size) {
+  if (size == 0) {
+    return;
+  }
+
+  struct iovec entry;
+  entry.iov_base = const_cast<char *>(data);
+  entry.iov_len = size;
+  pending_.push_back(entry);
+  pending_size_ += size;
+}
+
+bool LogFile::Flush() {
+  PL_ASSERT(IsOpen() == true);
+  if (pending_.empty() == true) {
+    return true;
+  }
+
+  if (mapping_ != nullptr) {
+    return FlushMapping();
+  }
+  return FlushFile();
+}
+
+bool LogFile::FlushFile() {
+  Preallocate(size_ + pending_size_);
+
+  bool success = true;
+  size_t entry_offset = 0;
+  while (entry_offset < pending_.size()) {
+    int entry_count =
+        static_cast<int>(std::min<size_t>(pending_.size() - entry_offset,
+                                          IOV_MAX));
+    ssize_t written = writev(fd_, &pending_[entry_offset], entry_count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      success = false;
+      break;
+    }
+    size_ += written;
+
+    // skip the entries written, and the written part of a partial one
+    size_t remaining = written;
+    while (remaining > 0 && remaining >= pending_[entry_offset].iov_len) {
+      remaining -= pending_[entry_offset].iov_len;
+      entry_offset++;
+    }
+    if (remaining > 0) {
+      auto &entry = pending_[entry_offset];
+      entry.iov_base = static_cast<char *>(entry.iov_base) + remaining;
+      entry.iov_len -= remaining;
+    }
+  }
+  pending_.clear();
+  pending_size_ = 0;
+
+  if (success == true && fdatasync(fd_) != 0) {
+    success = false;
+  }
+  if (success == false) {
+    LOG_ERROR("Cannot write log file %s: %s", path_.c_str(), strerror(errno));
+  }
+  return success;
+}
+
+void LogFile::Preallocate(const size_t size) {
+  if (size <= allocated_size_) {
+    return;
+  }
+
+  // grow by whole extents ahead of the writes
+  size_t allocated_size =
+      (size + preallocation_size_ - 1) / preallocation_size_ *
+      preallocation_size_;
+
+#ifdef __linux__
+  // the size is kept, so readers of the file only see the data written
+  if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, allocated_size_,
+                allocated_size - allocated_size_) != 0) {
+    // not supported by the file system, the writes allocate instead
+    LOG_TRACE("Cannot preallocate log file %s: %s", path_.c_str(),
+              strerror(errno));
+  }
+#endif
+
+  allocated_size_ = allocated_size;
+}
+
+bool LogFile::FlushMapping() {
+  bool success = true;
+  size_t mapping_size = mapping_header_size_ + size_ + pending_size_;
+  if (mapping_size > allocated_size_ && MapFile(mapping_size) == false) {
+    success = false;
+  }
+
+  if (success == true) {
+    char *data = mapping_ + mapping_header_size_ + size_;
+    size_t offset = 0;
+    for (auto &entry : pending_) {
+      PL_MEMCPY(data + offset, entry.iov_base, entry.iov_len);
+      offset += entry.iov_len;
+    }
+    success = Persist(data, pending_size_);
+  }
+
+  // the header only covers the data once it is durable. its size is aligned,
+  // so it is never persisted torn.
+  if (success == true) {
+    auto header = reinterpret_cast<MappingHeader *>(mapping_);
+    header->size = size_ + pending_size_;
+    success = Persist(mapping_, sizeof(MappingHeader));
+  }
+  if (success == true) {
+    size_ += pending_size_;
+  }
+  pending_.clear();
+  pending_size_ = 0;
+
+  if (success == false) {
+    LOG_ERROR("Cannot write log file %s: %s", path_.c_str(), strerror(errno));
+  }
+  return success;
+}
+
+bool LogFile::Truncate(const size_t size) {
+  PL_ASSERT(IsOpen() == true);
+  PL_ASSERT(pending_.empty() == true);
+  PL_ASSERT(size <= size_);
+
+  if (mapping_ != nullptr) {
+    reinterpret_cast<MappingHeader *>(mapping_)->size = size;
+    if (Persist(mapping_, sizeof(MappingHeader)) == false) {
+      LOG_ERROR("Cannot truncate log file %s: %s", path_.c_str(),
+                strerror(errno));
+      return false;
+    }
+  } else {
+    if (ftruncate(fd_, size) != 0) {
+      LOG_ERROR("Cannot truncate log file %s: %s", path_.c_str(),
+                strerror(errno));
+      return false;
+    }
+    allocated_size_ = size;
+  }
+  size_ = size;
+  return true;
+}
+
+std::string LogFile::ReadFile(const std::string &path) {
+  std::string data = FileUtil::GetFile(path);
+
+  MappingHeader header;
+  if (data.size() < mapping_header_size_) {
+    return data;
+  }
+  PL_MEMCPY(&header, data.data(), sizeof(header));
+  if (memcmp(header.magic, mapping_magic_, sizeof(header.magic)) != 0) {
+    return data;
+  }
+  size_t size = std::min<size_t>(header.size,
+                                 data.size() - mapping_header_size_);
+  return data.substr(mapping_header_size_, size);
+}
+
+bool LogFile::MapFile(const size_t size) {
+  // the file grows by whole extents, allocated ahead of the copies
+  size_t mapping_size =
+      (size + preallocation_size_ - 1) / preallocation_size_ *
+      preallocation_size_;
+  int status = posix_fallocate(fd_, 0, mapping_size);
+  if (status != 0) {
+    LOG_ERROR("Cannot allocate log file %s: %s", path_.c_str(),
+              strerror(status));
+    return false;
+  }
+
+  UnmapFile();
+
+  void *address = MAP_FAILED;
+#if defined(MAP_SYNC) && defined(MAP_SHARED_VALIDATE)
+  // the page tables of a synchronous mapping always point to the persistent
+  // media, so the cache line write backs are enough
+  address = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                 MAP_SHARED_VALIDATE | MAP_SYNC, fd_, 0);
+  is_dax_mapping_ = (address != MAP_FAILED);
+#endif
+  if (address == MAP_FAILED) {
+    LOG_TRACE("Log file %s is not on a DAX file system, using msync",
+              path_.c_str());
+    address = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                   fd_, 0);
+    is_dax_mapping_ = false;
+  }
+  if (address == MAP_FAILED) {
+    LOG_ERROR("Cannot map log file %s: %s", path_.c_str(), strerror(errno));
+    return false;
+  }
+
+  mapping_ = static_cast<char *>(address);
+  allocated_size_ = mapping_size;
+  return true;
+}
+
+void LogFile::UnmapFile() {
+  if (mapping_ == nullptr) {
+    return;
+  }
+  munmap(mapping_, allocated_size_);
+  mapping_ = nullptr;
+}
+
+bool LogFile::Persist(char *address, const size_t size) {
+  if (is_dax_mapping_ == true) {
+    storage::BackendManager::GetInstance().Sync(BackendType::NVM, address,
+                                                size);
+    return true;
+  }
+
+  // msync takes whole pages
+  uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  uintptr_t start = reinterpret_cast<uintptr_t>(address) & ~(page_size - 1);
+  uintptr_t end = reinterpret_cast<uintptr_t>(address) + size;
+  return msync(reinterpret_cast<void *>(start), end - start, MS_SYNC) == 0;
+}
+
+}  // namespace logging
+}  // namespace peloton
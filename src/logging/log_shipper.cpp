@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_shipper.cpp
+//
+// Identification: src/logging/log_shipper.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/log_shipper.h"
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "networking/network_address.h"
+#include "networking/rpc_channel.h"
+#include "networking/rpc_controller.h"
+#include "peloton/proto/logging_service.pb.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace logging {
+
+LogShipper::LogShipper() {}
+
+LogShipper::~LogShipper() {}
+
+bool LogShipper::Configure(const std::string &replica_addresses,
+                           const size_t logger_count) {
+  std::lock_guard<std::mutex> lock(ship_mutex_);
+  replicas_.clear();
+  sequence_numbers_.assign(logger_count, 0);
+
+  std::vector<std::unique_ptr<Replica>> replicas;
+  for (auto &address : StringUtil::Split(replica_addresses, ",")) {
+    if (address.empty() == true) {
+      continue;
+    }
+
+    // the channel throws on an address it cannot parse
+    networking::NetworkAddress network_address;
+    if (network_address.Parse(address) == false) {
+      LOG_ERROR("Invalid replica address %s", address.c_str());
+      return false;
+    }
+
+    std::unique_ptr<Replica> replica(new Replica());
+    replica->address = address;
+    replica->channel.reset(new networking::RpcChannel(address));
+    replica->controller.reset(new networking::RpcController());
+    replica->stub.reset(
+        new networking::PelotonLoggingService_Stub(replica->channel.get()));
+    replicas.push_back(std::move(replica));
+  }
+
+  replicas_ = std::move(replicas);
+  return true;
+}
+
+void LogShipper::Ship(const size_t logger_id, const std::string &frames) {
+  std::lock_guard<std::mutex> lock(ship_mutex_);
+  PL_ASSERT(logger_id < sequence_numbers_.size());
+
+  networking::LogRecordReplayRequest request;
+  request.set_log(frames);
+  request.set_sync_type(networking::ResponseType::ASYNC);
+  request.set_sequence_number(sequence_numbers_[logger_id]++);
+  request.set_logger_id(logger_id);
+  request.set_logger_count(sequence_numbers_.size());
+
+  // the replicas answer through the logging service of the primary
+  networking::LogRecordReplayResponse response;
+  for (auto &replica : replicas_) {
+    replica->controller->Reset();
+    replica->stub->LogRecordReplay(replica->controller.get(), &request,
+                                   &response, nullptr);
+
+    bool is_connected = replica->controller->Failed() == false;
+    if (is_connected == false && replica->is_connected == true) {
+      LOG_ERROR("Cannot ship the log to replica %s: %s",
+                replica->address.c_str(),
+                replica->controller->ErrorText().c_str());
+    }
+    replica->is_connected = is_connected;
+  }
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_stats.cpp
+//
+// Identification: src/logging/log_stats.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/log_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace peloton {
+namespace logging {
+
+LoggerStats &LoggerStats::operator+=(const LoggerStats &other) {
+  flush_count += other.flush_count;
+  flush_byte_count += other.flush_byte_count;
+  flush_buffer_count += other.flush_buffer_count;
+  flush_txn_count += other.flush_txn_count;
+  max_flush_byte_count =
+      std::max(max_flush_byte_count, other.max_flush_byte_count);
+  flush_time += other.flush_time;
+  return *this;
+}
+
+void LatencyHistogram::Record(const uint64_t latency) {
+  buckets_[GetBucket(latency)]++;
+  count_++;
+  sum_ += latency;
+  max_ = std::max(max_, latency);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &other) {
+  for (size_t bucket = 0; bucket < bucket_count_; bucket++) {
+    buckets_[bucket] += other.buckets_[bucket];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Reset() {
+  buckets_.fill(0);
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+double LatencyHistogram::GetAverage() const {
+  if (count_ == 0) {
+    return 0;
+  }
+  return static_cast<double>(sum_) / count_;
+}
+
+double LatencyHistogram::GetPercentile(const double percent) const {
+  if (count_ == 0) {
+    return 0;
+  }
+
+  uint64_t rank = static_cast<uint64_t>(std::ceil(percent / 100 * count_));
+  rank = std::max<uint64_t>(rank, 1);
+
+  uint64_t seen_count = 0;
+  for (size_t bucket = 0; bucket < bucket_count_; bucket++) {
+    seen_count += buckets_[bucket];
+    if (seen_count >= rank) {
+      // the bucket of the largest latency is not wider than it
+      return std::min(GetBucketLatency(bucket), static_cast<double>(max_));
+    }
+  }
+  return max_;
+}
+
+size_t LatencyHistogram::GetBucket(const uint64_t latency) {
+  if (latency < sub_bucket_count_) {
+    return latency;
+  }
+
+  // the sub bucket is given by the bits after the highest one
+  size_t high_bit = 63 - __builtin_clzll(latency);
+  size_t shift = high_bit - sub_bucket_bits_;
+  return (high_bit - sub_bucket_bits_ + 1) * sub_bucket_count_ +
+         ((latency >> shift) & (sub_bucket_count_ - 1));
+}
+
+double LatencyHistogram::GetBucketLatency(const size_t bucket) {
+  if (bucket < sub_bucket_count_) {
+    return bucket;
+  }
+
+  size_t shift = bucket / sub_bucket_count_ - 1;
+  uint64_t low = (sub_bucket_count_ + bucket % sub_bucket_count_) << shift;
+  uint64_t width = 1ULL << shift;
+  return low + (width - 1) / 2.0;
+}
+
+}  // namespace logging
+}  // namespace peloton
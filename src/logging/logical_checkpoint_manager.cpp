@@ -0,0 +1,383 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_checkpoint_manager.cpp
+//
+// Identification: src/logging/logical_checkpoint_manager.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_checkpoint_manager.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#include "catalog/catalog_defaults.h"
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/maintenance_scheduler.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "logging/log_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/table_snapshot.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple_serializer.h"
+#include "type/serializeio.h"
+#include "type/value.h"
+#include "util/file_util.h"
+
+namespace peloton {
+namespace logging {
+
+const std::string LogicalCheckpointManager::checkpoint_filename_prefix_ =
+    "checkpoint";
+
+const std::string LogicalCheckpointManager::snapshot_filename_suffix_ =
+    ".snapshot";
+
+namespace {
+
+// parse "<prefix>_<epoch id>" and "<prefix>_<epoch id>_<database>_<table>"
+bool ParseCheckpointName(const std::string &name, const std::string &prefix,
+                         eid_t &epoch_id, bool &is_mark) {
+  if (name.compare(0, prefix.size() + 1, prefix + "_") != 0) {
+    return false;
+  }
+  try {
+    size_t length = 0;
+    epoch_id = std::stoull(name.substr(prefix.size() + 1), &length);
+    is_mark = (prefix.size() + 1 + length == name.size());
+  } catch (std::exception &e) {
+    return false;
+  }
+  return true;
+}
+
+// parse the ids out of "<...>_<database>_<table><suffix>"
+bool ParseSnapshotPath(const std::string &path, const std::string &suffix,
+                       oid_t &database_id, oid_t &table_id) {
+  if (path.size() <= suffix.size() ||
+      path.compare(path.size() - suffix.size(), suffix.size(), suffix) != 0) {
+    return false;
+  }
+  std::string name = path.substr(0, path.size() - suffix.size());
+  size_t table_separator = name.rfind('_');
+  if (table_separator == std::string::npos || table_separator == 0) {
+    return false;
+  }
+  size_t database_separator = name.rfind('_', table_separator - 1);
+  if (database_separator == std::string::npos) {
+    return false;
+  }
+  try {
+    database_id = std::stoul(name.substr(database_separator + 1));
+    table_id = std::stoul(name.substr(table_separator + 1));
+  } catch (std::exception &e) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+void LogicalCheckpointManager::StartCheckpointing(
+    std::vector<std::unique_ptr<std::thread>> &checkpoint_threads) {
+  is_running_ = true;
+  checkpoint_threads.emplace_back(
+      new std::thread(&LogicalCheckpointManager::Running, this));
+}
+
+void LogicalCheckpointManager::StartCheckpointing() {
+  is_running_ = true;
+  checkpoint_thread_.reset(
+      new std::thread(&LogicalCheckpointManager::Running, this));
+}
+
+void LogicalCheckpointManager::StopCheckpointing() {
+  is_running_ = false;
+  if (checkpoint_thread_ != nullptr) {
+    checkpoint_thread_->join();
+    checkpoint_thread_.reset();
+  }
+}
+
+void LogicalCheckpointManager::Running() {
+  while (true) {
+    // wait out the interval in short steps, to stop promptly
+    auto start = std::chrono::steady_clock::now();
+    while (is_running_ == true &&
+           std::chrono::steady_clock::now() - start <
+               std::chrono::seconds(checkpoint_interval_)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (is_running_ == false) {
+      break;
+    }
+
+    DoCheckpoint();
+  }
+}
+
+eid_t LogicalCheckpointManager::DoCheckpoint() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // the snapshot sees exactly the transactions of the epochs before its
+  // own, which have all finished
+  auto txn =
+      txn_manager.BeginTransaction(thread_id_, IsolationLevelType::READ_ONLY);
+  eid_t epoch_id = (txn->GetReadId() >> 32) - 1;
+
+  // nothing new since the last checkpoint
+  if (epoch_id == INVALID_EID ||
+      FileUtil::Exists(GetCheckpointPath(epoch_id)) == true) {
+    txn_manager.CommitTransaction(txn);
+    return INVALID_EID;
+  }
+
+  std::vector<storage::DataTable *> tables;
+  auto storage_manager = storage::StorageManager::GetInstance();
+  for (oid_t database_offset = 0;
+       database_offset < storage_manager->GetDatabaseCount();
+       database_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(database_offset);
+    if (database->GetOid() == CATALOG_DATABASE_OID) {
+      continue;
+    }
+    for (oid_t table_offset = 0; table_offset < database->GetTableCount();
+         table_offset++) {
+      tables.push_back(database->GetTable(table_offset));
+    }
+  }
+
+  // the tables are handed out one at a time, so that a large table does
+  // not hold up the others
+  std::atomic<size_t> next_table(0);
+  std::atomic<bool> success(true);
+  auto checkpoint_tables = [&] {
+    for (size_t table_id = next_table++; table_id < tables.size();
+         table_id = next_table++) {
+      auto table = tables[table_id];
+      if (CheckpointTable(txn, table,
+                          GetTablePath(epoch_id, table->GetDatabaseOid(),
+                                       table->GetOid())) == false) {
+        success = false;
+      }
+    }
+  };
+
+  size_t thread_count = std::min(
+      static_cast<size_t>(checkpointer_thread_count_), tables.size());
+  std::vector<std::thread> threads;
+  for (size_t thread_id = 1; thread_id < thread_count; thread_id++) {
+    threads.emplace_back(checkpoint_tables);
+  }
+  checkpoint_tables();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  txn_manager.CommitTransaction(txn);
+
+  if (success == false) {
+    LOG_ERROR("Cannot take checkpoint of epoch %lu", epoch_id);
+    return INVALID_EID;
+  }
+
+  // the checkpoint is complete once its mark is durable
+  std::string checkpoint_path = GetCheckpointPath(epoch_id);
+  FILE *mark_file = fopen(checkpoint_path.c_str(), "wb");
+  if (mark_file == nullptr || fsync(fileno(mark_file)) != 0) {
+    LOG_ERROR("Cannot write checkpoint file %s", checkpoint_path.c_str());
+    if (mark_file != nullptr) {
+      fclose(mark_file);
+    }
+    return INVALID_EID;
+  }
+  fclose(mark_file);
+
+  checkpoint_epoch_id_ = epoch_id;
+  RemoveCheckpoints(epoch_id);
+  LogManagerFactory::GetInstance().TruncateLog(epoch_id);
+
+  LOG_TRACE("Took checkpoint of epoch %lu", epoch_id);
+  return epoch_id;
+}
+
+bool LogicalCheckpointManager::CheckpointTable(
+    concurrency::Transaction *txn, storage::DataTable *table,
+    const std::string &checkpoint_path) {
+  // the tuples of a table without varlen values are mapped back at
+  // recovery, where the log records find them by their primary key
+  if (table->GetSchema()->IsInlined() == true &&
+      table->HasPrimaryKey() == true) {
+    return storage::TableSnapshot::WriteTable(
+        txn, table, checkpoint_path + snapshot_filename_suffix_);
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  FILE *checkpoint_file = fopen(checkpoint_path.c_str(), "wb");
+  if (checkpoint_file == nullptr) {
+    LOG_ERROR("Cannot open checkpoint file %s", checkpoint_path.c_str());
+    return false;
+  }
+
+  bool success = true;
+  CopySerializeOutput output;
+  auto &maintenance_scheduler = MaintenanceScheduler::GetInstance();
+  auto write_output = [&] {
+    if (output.Size() > 0 &&
+        fwrite(output.Data(), output.Size(), 1, checkpoint_file) != 1) {
+      success = false;
+    }
+
+    // the writes are paced by the budget of the background tasks
+    maintenance_scheduler.RecordWork(MaintenanceTask::CHECKPOINT, 0,
+                                     output.Size());
+    maintenance_scheduler.Pause(MaintenanceTask::CHECKPOINT, 0);
+    output.Reset();
+  };
+
+  // tile groups added after the snapshot only hold invisible versions
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t tile_group_offset = 0;
+       tile_group_offset < tile_group_count && success == true;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+    auto &serializer = tile_group->GetSerializer();
+
+    oid_t active_tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+          VisibilityType::OK) {
+        continue;
+      }
+
+      size_t start = output.Position();
+      output.WriteInt(0);
+      output.WriteEnumInSingleByte(
+          static_cast<int>(LogRecordType::TUPLE_INSERT));
+      output.WriteVarInt(table->GetDatabaseOid());
+      output.WriteVarInt(table->GetOid());
+      serializer.SerializeTo(tile_group.get(), tuple_id, output);
+      output.WriteIntAt(start,
+                        static_cast<int32_t>(output.Position() - start -
+                                             sizeof(int32_t)));
+    }
+
+    if (output.Size() >= checkpoint_buffer_size_) {
+      write_output();
+    }
+  }
+  write_output();
+
+  if (success == false || fflush(checkpoint_file) != 0 ||
+      fsync(fileno(checkpoint_file)) != 0) {
+    LOG_ERROR("Cannot write checkpoint file %s", checkpoint_path.c_str());
+    success = false;
+  }
+  fclose(checkpoint_file);
+
+  return success;
+}
+
+eid_t LogicalCheckpointManager::GetLatestCheckpoint(
+    std::vector<std::string> &checkpoint_paths) {
+  auto names = FileUtil::ListDirectory(checkpoint_dir_);
+
+  eid_t latest_epoch_id = INVALID_EID;
+  eid_t epoch_id;
+  bool is_mark;
+  for (auto &name : names) {
+    if (ParseCheckpointName(name, checkpoint_filename_prefix_, epoch_id,
+                            is_mark) == true &&
+        is_mark == true) {
+      latest_epoch_id = std::max(latest_epoch_id, epoch_id);
+    }
+  }
+
+  checkpoint_paths.clear();
+  if (latest_epoch_id == INVALID_EID) {
+    return INVALID_EID;
+  }
+
+  for (auto &name : names) {
+    if (ParseCheckpointName(name, checkpoint_filename_prefix_, epoch_id,
+                            is_mark) == true &&
+        is_mark == false && epoch_id == latest_epoch_id) {
+      checkpoint_paths.push_back(checkpoint_dir_ + "/" + name);
+    }
+  }
+  std::sort(checkpoint_paths.begin(), checkpoint_paths.end());
+
+  return latest_epoch_id;
+}
+
+std::vector<storage::DataTable *> LogicalCheckpointManager::LoadSnapshots(
+    std::vector<std::string> &checkpoint_paths,
+    std::vector<std::unique_ptr<std::thread>> &index_threads) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  std::vector<std::string> record_paths;
+  std::vector<storage::DataTable *> tables;
+  for (auto &path : checkpoint_paths) {
+    oid_t database_id, table_id;
+    if (ParseSnapshotPath(path, snapshot_filename_suffix_, database_id,
+                          table_id) == false) {
+      record_paths.push_back(path);
+      continue;
+    }
+
+    storage::DataTable *table = nullptr;
+    try {
+      table = storage_manager->GetTableWithOid(database_id, table_id);
+    } catch (CatalogException &e) {
+      LOG_ERROR("Cannot recover the snapshot of missing table %u", table_id);
+      continue;
+    }
+
+    std::unique_ptr<std::thread> index_thread;
+    if (storage::TableSnapshot::LoadTable(table, path, index_thread) ==
+        false) {
+      LOG_ERROR("Cannot recover the snapshot %s", path.c_str());
+      continue;
+    }
+    if (index_thread != nullptr) {
+      index_threads.push_back(std::move(index_thread));
+    }
+    tables.push_back(table);
+  }
+  checkpoint_paths.swap(record_paths);
+  return tables;
+}
+
+void LogicalCheckpointManager::RemoveCheckpoints(const eid_t epoch_id) {
+  eid_t name_epoch_id;
+  bool is_mark;
+  for (auto &name : FileUtil::ListDirectory(checkpoint_dir_)) {
+    if (ParseCheckpointName(name, checkpoint_filename_prefix_, name_epoch_id,
+                            is_mark) == true &&
+        name_epoch_id < epoch_id) {
+      std::string path = checkpoint_dir_ + "/" + name;
+      if (remove(path.c_str()) != 0) {
+        LOG_ERROR("Cannot remove checkpoint file %s", path.c_str());
+      }
+    }
+  }
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,505 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_manager.cpp
+//
+// Identification: src/logging/logical_log_manager.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_log_manager.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "common/statement.h"
+#include "concurrency/transaction.h"
+#include "configuration/configuration.h"
+#include "logging/checkpoint_manager_factory.h"
+#include "logging/log_shipper.h"
+#include "logging/logical_log_recovery.h"
+#include "storage/abstract_table.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tuple_serializer.h"
+#include "type/value.h"
+#include "util/file_util.h"
+
+namespace peloton {
+namespace logging {
+
+namespace {
+
+// context of this worker, valid while its generation is the current one
+thread_local WorkerContext *worker_context = nullptr;
+
+thread_local size_t worker_generation = 0;
+
+// context of the transaction being logged, nullptr if it is not logged
+thread_local WorkerContext *txn_context = nullptr;
+
+bool IsSameValue(const type::Value &lhs, const type::Value &rhs) {
+  if (lhs.IsNull() == true || rhs.IsNull() == true) {
+    return lhs.IsNull() == rhs.IsNull();
+  }
+  return lhs.CompareEquals(rhs) == type::CMP_TRUE;
+}
+
+}  // namespace
+
+const std::string LogicalLogManager::command_filename_ = "commands";
+
+std::string LogicalLogManager::GetLogFilePath(const size_t logger_id) const {
+  PL_ASSERT(logger_id < loggers_.size());
+  return loggers_[logger_id]->GetLogFilePath();
+}
+
+bool LogicalLogManager::PrepareLoggers() {
+  PL_ASSERT(is_running_ == false);
+  PL_ASSERT(logger_thread_count_ > 0);
+
+  // the contexts of the previous run are dropped along with their buffers
+  {
+    std::lock_guard<std::mutex> lock(worker_mutex_);
+    workers_.clear();
+    generation_++;
+  }
+
+  loggers_.clear();
+  for (int logger_id = 0; logger_id < logger_thread_count_; logger_id++) {
+    loggers_.emplace_back(new LogicalLogger(logger_id, log_dir_, backend_type_));
+    if (loggers_.back()->OpenLogFile(existing_epoch_id_) == false) {
+      loggers_.clear();
+      return false;
+    }
+    loggers_.back()->SetRunning(true);
+  }
+
+  // the batches of the loggers are numbered from zero at every start
+  if (LogShipper::GetInstance().Configure(FLAGS_replica_addresses,
+                                          loggers_.size()) == false) {
+    loggers_.clear();
+    return false;
+  }
+
+  command_logging_ = FLAGS_command_logging;
+  if (command_logging_ == true && PrepareCommands() == false) {
+    loggers_.clear();
+    return false;
+  }
+  return true;
+}
+
+bool LogicalLogManager::PrepareCommands() {
+  std::lock_guard<std::mutex> lock(command_mutex_);
+  command_ids_.clear();
+
+  std::vector<std::string> query_strings;
+  size_t valid_size = ReadCommandFile(log_dir_, query_strings);
+  for (uint32_t command_id = 0; command_id < query_strings.size();
+       command_id++) {
+    command_ids_.emplace(query_strings[command_id], command_id);
+  }
+
+  // drop a query string torn by a crash, the new ones are appended after it
+  auto command_file_path = GetCommandFilePath(log_dir_);
+  if (FileUtil::Exists(command_file_path) == true &&
+      truncate(command_file_path.c_str(), valid_size) != 0) {
+    LOG_ERROR("Cannot truncate command file %s: %s",
+              command_file_path.c_str(), strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+size_t LogicalLogManager::ReadCommandFile(
+    const std::string &log_dir, std::vector<std::string> &query_strings) {
+  query_strings.clear();
+
+  auto command_file_path = GetCommandFilePath(log_dir);
+  if (FileUtil::Exists(command_file_path) == false) {
+    return 0;
+  }
+
+  std::string data = FileUtil::GetFile(command_file_path);
+  size_t offset = 0;
+  while (offset + sizeof(int32_t) <= data.size()) {
+    ReferenceSerializeInput input(data.data() + offset, sizeof(int32_t));
+    size_t length = input.ReadInt();
+    if (offset + sizeof(int32_t) + length > data.size()) {
+      break;
+    }
+    query_strings.emplace_back(data, offset + sizeof(int32_t), length);
+    offset += sizeof(int32_t) + length;
+  }
+  return offset;
+}
+
+bool LogicalLogManager::GetCommandId(const std::string &query_string,
+                                     uint32_t &command_id) {
+  std::lock_guard<std::mutex> lock(command_mutex_);
+  if (command_logging_ == false) {
+    return false;
+  }
+
+  auto itr = command_ids_.find(query_string);
+  if (itr != command_ids_.end()) {
+    command_id = itr->second;
+    return true;
+  }
+
+  // the query string is durable before any record refers to its id
+  CopySerializeOutput output;
+  output.WriteInt(static_cast<int32_t>(query_string.size()));
+  output.WriteBytes(query_string.data(), query_string.size());
+
+  auto command_file_path = GetCommandFilePath(log_dir_);
+  FILE *command_file = fopen(command_file_path.c_str(), "ab");
+  bool success = command_file != nullptr &&
+                 fwrite(output.Data(), output.Size(), 1, command_file) == 1 &&
+                 fflush(command_file) == 0 &&
+                 fsync(fileno(command_file)) == 0;
+  if (command_file != nullptr) {
+    fclose(command_file);
+  }
+  if (success == false) {
+    // the ids appended after a torn query string would not be found again
+    LOG_ERROR("Cannot write command file %s: %s", command_file_path.c_str(),
+              strerror(errno));
+    command_logging_ = false;
+    return false;
+  }
+
+  command_id = static_cast<uint32_t>(command_ids_.size());
+  command_ids_.emplace(query_string, command_id);
+  return true;
+}
+
+bool LogicalLogManager::LogCommand(concurrency::Transaction *txn,
+                                   Statement &statement,
+                                   const std::vector<type::Value> &params) {
+  if (is_running_ == false || command_logging_ == false) {
+    return false;
+  }
+
+  // the id is looked up once per statement and run of the log manager
+  size_t generation = generation_.load();
+  uint32_t command_id;
+  if (statement.GetCommandId(generation, command_id) == false) {
+    if (GetCommandId(statement.GetQueryString(), command_id) == false) {
+      return false;
+    }
+    statement.SetCommandId(generation, command_id);
+  }
+
+  auto &output = txn->GetCommandLog();
+  output.WriteEnumInSingleByte(static_cast<int>(LogRecordType::COMMAND));
+  output.WriteVarInt(command_id);
+  output.WriteVarInt(params.size());
+  for (auto &param : params) {
+    output.WriteEnumInSingleByte(static_cast<int>(param.GetTypeId()));
+    param.SerializeTo(output);
+  }
+  return true;
+}
+
+void LogicalLogManager::LogCommands(const CopySerializeOutput &command_log) {
+  if (txn_context == nullptr) {
+    return;
+  }
+
+  txn_context->txn_output.WriteBytes(command_log.Data(), command_log.Size());
+  txn_context->txn_logs_commands = true;
+}
+
+void LogicalLogManager::StartLogging(
+    std::vector<std::unique_ptr<std::thread>> &logger_threads) {
+  LOG_TRACE("Starting logging");
+  if (PrepareLoggers() == false) {
+    return;
+  }
+
+  logger_threads.resize(loggers_.size());
+  for (size_t logger_id = 0; logger_id < loggers_.size(); logger_id++) {
+    logger_threads[logger_id].reset(
+        new std::thread(&LogicalLogger::Run, loggers_[logger_id].get()));
+  }
+  this->is_running_ = true;
+}
+
+void LogicalLogManager::StartLogging() {
+  LOG_TRACE("Starting logging");
+  if (PrepareLoggers() == false) {
+    return;
+  }
+
+  for (auto &logger : loggers_) {
+    logger_threads_.emplace_back(new std::thread(&LogicalLogger::Run, logger.get()));
+  }
+  this->is_running_ = true;
+}
+
+void LogicalLogManager::StopLogging() {
+  LOG_TRACE("Stopping logging");
+  this->is_running_ = false;
+
+  for (auto &logger : loggers_) {
+    logger->SetRunning(false);
+  }
+
+  for (auto &logger_thread : logger_threads_) {
+    logger_thread->join();
+  }
+  logger_threads_.clear();
+}
+
+eid_t LogicalLogManager::DoRecovery(const size_t recovery_thread_count) {
+  PL_ASSERT(is_running_ == false);
+  PL_ASSERT(recovery_thread_count > 0);
+
+  LogicalLogRecovery recovery(log_dir_, recovery_thread_count);
+
+  // the logs are replayed on top of the latest checkpoint
+  std::vector<std::string> checkpoint_paths;
+  eid_t checkpoint_epoch_id =
+      CheckpointManagerFactory::GetInstance().GetLatestCheckpoint(
+          checkpoint_paths);
+  if (checkpoint_epoch_id != INVALID_EID) {
+    // the log records are replayed through the indexes of the snapshots
+    std::vector<std::unique_ptr<std::thread>> index_threads;
+    auto snapshot_tables =
+        CheckpointManagerFactory::GetInstance().LoadSnapshots(
+            checkpoint_paths, index_threads);
+    for (auto &index_thread : index_threads) {
+      index_thread->join();
+    }
+    recovery.SetCheckpoint(checkpoint_epoch_id, checkpoint_paths,
+                           snapshot_tables);
+  }
+
+  eid_t persist_epoch_id = recovery.Recover();
+  if (recovery.GetRestartEpochId() != INVALID_EID) {
+    existing_epoch_id_ = recovery.GetRestartEpochId() - 1;
+  }
+  return persist_epoch_id;
+}
+
+void LogicalLogManager::TruncateLog(const eid_t checkpoint_epoch_id) {
+  if (is_running_ == false) {
+    return;
+  }
+
+  for (auto &logger : loggers_) {
+    logger->TruncateLog(checkpoint_epoch_id);
+  }
+}
+
+eid_t LogicalLogManager::GetPersistentEpochId() {
+  if (is_running_ == false) {
+    return MAX_EID;
+  }
+
+  eid_t persist_epoch_id = MAX_EID;
+  for (auto &logger : loggers_) {
+    persist_epoch_id =
+        std::min(persist_epoch_id, logger->GetPersistentEpochId());
+  }
+  return persist_epoch_id;
+}
+
+LoggerStats LogicalLogManager::GetLoggerStats() {
+  LoggerStats stats;
+  for (auto &logger : loggers_) {
+    stats += logger->GetStats();
+  }
+  return stats;
+}
+
+WorkerContext *LogicalLogManager::GetWorkerContext() {
+  if (worker_context != nullptr && worker_generation == generation_.load()) {
+    return worker_context;
+  }
+
+  std::lock_guard<std::mutex> lock(worker_mutex_);
+  size_t worker_id = workers_.size();
+  workers_.emplace_back(new WorkerContext(worker_id));
+  worker_context = workers_.back().get();
+  worker_generation = generation_.load();
+
+  loggers_[worker_id % loggers_.size()]->RegisterWorker(worker_context);
+  return worker_context;
+}
+
+void LogicalLogManager::LogBegin(const eid_t epoch_id, const cid_t commit_id) {
+  if (is_running_ == false) {
+    txn_context = nullptr;
+    return;
+  }
+
+  txn_context = GetWorkerContext();
+  txn_context->txn_epoch_id = epoch_id;
+  txn_context->txn_commit_id = commit_id;
+  txn_context->txn_logs_commands = false;
+
+  // the length is filled in once the transaction ends
+  auto &output = txn_context->txn_output;
+  output.Reset();
+  output.WriteInt(0);
+  output.WriteEnumInSingleByte(
+      static_cast<int>(LogRecordType::TRANSACTION_BEGIN));
+  output.WriteVarInt(epoch_id);
+  output.WriteVarInt(commit_id ^ (static_cast<cid_t>(epoch_id) << 32));
+  txn_context->txn_begin_size = output.Size();
+}
+
+void LogicalLogManager::LogEnd() {
+  if (txn_context == nullptr) {
+    return;
+  }
+
+  auto worker_context = txn_context;
+  txn_context = nullptr;
+
+  // nothing to log for a transaction without writes
+  auto &output = worker_context->txn_output;
+  if (output.Size() == worker_context->txn_begin_size) {
+    return;
+  }
+
+  output.WriteEnumInSingleByte(
+      static_cast<int>(LogRecordType::TRANSACTION_COMMIT));
+  output.WriteIntAt(0,
+                    static_cast<int32_t>(output.Size() - sizeof(int32_t)));
+
+  CopyToLogBuffer(worker_context);
+}
+
+void LogicalLogManager::LogInsert(const ItemPointer &location) {
+  LogTuple(LogRecordType::TUPLE_INSERT, location);
+}
+
+void LogicalLogManager::LogUpdate(const ItemPointer &location,
+                                  const ItemPointer &old_location) {
+  if (txn_context == nullptr || txn_context->txn_logs_commands == true) {
+    return;
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group = manager.GetTileGroup(location.block);
+  auto table =
+      dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+  PL_ASSERT(table != nullptr);
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+
+  // the key columns locate the tuple on recovery. the old version is gone
+  // after an update in place, and a changed key replaces the whole tuple.
+  auto &column_bitmap = txn_context->column_bitmap;
+  column_bitmap.assign((column_count + 7) / 8, 0);
+  auto key_columns = LogicalLogRecovery::GetKeyColumns(table);
+  bool has_all_columns = old_location.IsNull();
+  if (has_all_columns == false) {
+    auto old_tile_group = manager.GetTileGroup(old_location.block);
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      if (IsSameValue(tile_group->GetValue(location.offset, column_id),
+                      old_tile_group->GetValue(old_location.offset,
+                                               column_id)) == true) {
+        continue;
+      }
+      if (std::find(key_columns.begin(), key_columns.end(), column_id) !=
+          key_columns.end()) {
+        has_all_columns = true;
+        break;
+      }
+      column_bitmap[column_id / 8] |= 1 << (column_id % 8);
+    }
+  }
+  if (has_all_columns == true) {
+    column_bitmap.assign(column_bitmap.size(), 0xff);
+  } else {
+    for (auto column_id : key_columns) {
+      column_bitmap[column_id / 8] |= 1 << (column_id % 8);
+    }
+  }
+
+  auto &output = txn_context->txn_output;
+  LogTupleHeader(output, LogRecordType::TUPLE_UPDATE, tile_group.get());
+  output.WriteBytes(column_bitmap.data(), column_bitmap.size());
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    if ((column_bitmap[column_id / 8] & (1 << (column_id % 8))) != 0) {
+      tile_group->GetValue(location.offset, column_id).SerializeTo(output);
+    }
+  }
+}
+
+void LogicalLogManager::LogDelete(const ItemPointer &location) {
+  LogTuple(LogRecordType::TUPLE_DELETE, location);
+}
+
+void LogicalLogManager::LogTuple(const LogRecordType type,
+                                 const ItemPointer &location) {
+  if (txn_context == nullptr || txn_context->txn_logs_commands == true) {
+    return;
+  }
+
+  auto tile_group = catalog::Manager::GetInstance().GetTileGroup(location.block);
+
+  auto &output = txn_context->txn_output;
+  LogTupleHeader(output, type, tile_group.get());
+
+  // Copied from the tiles into the output, column runs at a time
+  tile_group->GetSerializer().SerializeTo(tile_group.get(), location.offset,
+                                          output);
+}
+
+void LogicalLogManager::LogTupleHeader(CopySerializeOutput &output,
+                                       const LogRecordType type,
+                                       storage::TileGroup *tile_group) {
+  output.WriteEnumInSingleByte(static_cast<int>(type));
+  output.WriteVarInt(tile_group->GetDatabaseId());
+  output.WriteVarInt(tile_group->GetTableId());
+}
+
+void LogicalLogManager::CopyToLogBuffer(WorkerContext *worker_context) {
+  auto &output = worker_context->txn_output;
+  auto epoch_id = worker_context->txn_epoch_id;
+
+  worker_context->buffer_lock.Lock();
+
+  auto &current_buffer = worker_context->current_buffer;
+  if (current_buffer != nullptr && current_buffer->GetEpochId() == epoch_id &&
+      current_buffer->WriteData(output.Data(), output.Size()) == true) {
+    worker_context->buffer_lock.Unlock();
+    return;
+  }
+
+  // seal the buffer, it is full or holds an earlier epoch
+  if (current_buffer != nullptr) {
+    worker_context->full_buffers.push_back(std::move(current_buffer));
+  }
+  worker_context->buffer_lock.Unlock();
+
+  // the pool waits for the logger to return a buffer, which needs the lock
+  auto buffer = worker_context->buffer_pool.GetBuffer(epoch_id);
+  if (buffer->WriteData(output.Data(), output.Size()) == false) {
+    LOG_ERROR("Log records of %lu bytes do not fit in a log buffer",
+              output.Size());
+  }
+
+  worker_context->buffer_lock.Lock();
+  PL_ASSERT(current_buffer == nullptr);
+  current_buffer = std::move(buffer);
+  worker_context->buffer_lock.Unlock();
+}
+
+}  // namespace logging
+}  // namespace peloton
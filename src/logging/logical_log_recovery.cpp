@@ -0,0 +1,746 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_recovery.cpp
+//
+// Identification: src/logging/logical_log_recovery.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_log_recovery.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/statement.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/plan_executor.h"
+#include "index/index.h"
+#include "logging/logical_log_manager.h"
+#include "logging/logical_logger.h"
+#include "storage/data_table.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "tcop/tcop.h"
+#include "type/ephemeral_pool.h"
+#include "type/serializeio.h"
+#include "type/value.h"
+#include "util/file_util.h"
+
+namespace peloton {
+namespace logging {
+
+namespace {
+
+// whether an update record holds the column
+inline bool HasColumn(const char *column_bitmap, const oid_t column_id) {
+  return column_bitmap == nullptr ||
+         (column_bitmap[column_id / 8] & (1 << (column_id % 8))) != 0;
+}
+
+}  // namespace
+
+std::vector<oid_t> LogicalLogRecovery::GetKeyColumns(
+    storage::DataTable *table) {
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); index_itr++) {
+    auto index = table->GetIndex(index_itr);
+    if (index != nullptr &&
+        index->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+      return index->GetKeySchema()->GetIndexedColumns();
+    }
+  }
+
+  std::vector<oid_t> key_columns;
+  for (oid_t column_id = 0; column_id < table->GetSchema()->GetColumnCount();
+       column_id++) {
+    key_columns.push_back(column_id);
+  }
+  return key_columns;
+}
+
+void LogicalLogRecovery::SetCheckpoint(
+    const eid_t checkpoint_epoch_id,
+    const std::vector<std::string> &checkpoint_paths,
+    const std::vector<storage::DataTable *> &snapshot_tables) {
+  checkpoint_epoch_id_ = checkpoint_epoch_id;
+  checkpoint_paths_ = checkpoint_paths;
+  snapshot_tables_.insert(snapshot_tables.begin(), snapshot_tables.end());
+}
+
+eid_t LogicalLogRecovery::Recover() {
+  // the segments of a logger are read as one file
+  for (auto logger_id : LogicalLogger::GetLoggerIds(log_dir_)) {
+    log_files_.emplace_back();
+    for (auto segment_id : LogicalLogger::GetSegmentIds(log_dir_, logger_id)) {
+      log_files_.back().segment_paths.push_back(
+          LogicalLogger::GetSegmentPath(log_dir_, logger_id, segment_id));
+    }
+  }
+
+  if (log_files_.empty() == true && checkpoint_epoch_id_ == INVALID_EID) {
+    LOG_INFO("No log files to recover in %s", log_dir_.c_str());
+    return INVALID_EID;
+  }
+
+  // the checkpoint files follow the log files
+  records_.resize(log_files_.size() + checkpoint_paths_.size());
+  commands_.resize(log_files_.size());
+  discarded_epochs_.resize(log_files_.size());
+  checkpoint_data_.resize(checkpoint_paths_.size());
+
+  std::vector<std::thread> threads;
+  for (size_t file_id = 0; file_id < log_files_.size(); file_id++) {
+    threads.emplace_back(&LogicalLogRecovery::ReadLogFile, this, file_id);
+  }
+  for (size_t file_id = 0; file_id < checkpoint_paths_.size(); file_id++) {
+    threads.emplace_back(&LogicalLogRecovery::ReadCheckpointFile, this,
+                         file_id);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+
+  for (auto &discarded_epochs : discarded_epochs_) {
+    for (auto &discarded_epoch : discarded_epochs) {
+      last_restart_epoch_id_ =
+          std::max(last_restart_epoch_id_, discarded_epoch.second);
+    }
+  }
+
+  // an epoch since the last recovery is durable once every logger still
+  // writing its file has persisted it
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  bool has_active_file = false;
+  persist_epoch_id_ = MAX_EID;
+  restart_epoch_id_ = epoch_manager.GetCurrentEpochId();
+  for (auto &log_file : log_files_) {
+    if (log_file.is_active == true) {
+      has_active_file = true;
+      persist_epoch_id_ = std::min(persist_epoch_id_, log_file.last_epoch_id);
+    }
+    restart_epoch_id_ = std::max(restart_epoch_id_, log_file.max_epoch_id);
+  }
+  if (has_active_file == false) {
+    persist_epoch_id_ = INVALID_EID;
+  }
+
+  // the mark of this recovery must not discard the epochs recovered by the
+  // earlier ones
+  if (last_restart_epoch_id_ != INVALID_EID) {
+    persist_epoch_id_ =
+        std::max(persist_epoch_id_, last_restart_epoch_id_ - 1);
+  }
+  persist_epoch_id_ = std::max(persist_epoch_id_, checkpoint_epoch_id_);
+  restart_epoch_id_ = std::max(
+      std::max(restart_epoch_id_, checkpoint_epoch_id_) + 1,
+      last_restart_epoch_id_);
+
+  // the replayed transactions commit after every logged one
+  epoch_manager.SetCurrentEpochId(restart_epoch_id_);
+
+  for (size_t partition_id = 0; partition_id < recovery_thread_count_;
+       partition_id++) {
+    threads.emplace_back(&LogicalLogRecovery::ReplayPartition, this,
+                         partition_id);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // the statements run on top of the tuples replayed by value
+  ReplayCommands();
+
+  for (auto &log_file : log_files_) {
+    MarkLogFile(log_file);
+  }
+
+  // the data of the files is not needed anymore
+  records_.clear();
+  commands_.clear();
+  log_files_.clear();
+  checkpoint_data_.clear();
+
+  LOG_INFO("Recovered the logs up to epoch %lu", persist_epoch_id_);
+  return persist_epoch_id_;
+}
+
+bool LogicalLogRecovery::IsDurable(const eid_t epoch_id) const {
+  if (epoch_id >= last_restart_epoch_id_) {
+    return epoch_id <= persist_epoch_id_;
+  }
+
+  // the epochs before the last recovery were durable unless it discarded
+  // them. every file holds the same marks.
+  for (auto &discarded_epochs : discarded_epochs_) {
+    for (auto &discarded_epoch : discarded_epochs) {
+      if (epoch_id > discarded_epoch.first &&
+          epoch_id < discarded_epoch.second) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void LogicalLogRecovery::ReadLogFile(const size_t file_id) {
+  auto &log_file = log_files_[file_id];
+  auto &records = records_[file_id];
+  records.resize(recovery_thread_count_);
+
+  // only the last segment may end with a torn frame
+  for (auto &segment_path : log_file.segment_paths) {
+    log_file.last_segment_offset = log_file.data.size();
+    log_file.data += logging::LogFile::ReadFile(segment_path);
+  }
+  const char *data = log_file.data.data();
+  size_t size = log_file.data.size();
+
+  TableCache tables;
+
+  size_t offset = 0;
+  while (offset + sizeof(int32_t) <= size) {
+    ReferenceSerializeInput length_input(data + offset, sizeof(int32_t));
+    size_t length = length_input.ReadInt();
+
+    // a frame torn by the crash ends the file
+    if (offset + sizeof(int32_t) + length > size) {
+      break;
+    }
+
+    ReferenceSerializeInput input(data + offset + sizeof(int32_t), length);
+    offset += sizeof(int32_t) + length;
+
+    auto type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+
+    // a file without frames after the mark of a recovery is not written
+    // anymore, its logger was dropped
+    if (type == LogRecordType::EPOCH_BEGIN) {
+      eid_t persist_epoch_id = input.ReadLong();
+      eid_t restart_epoch_id = input.ReadLong();
+      discarded_epochs_[file_id].emplace_back(persist_epoch_id,
+                                              restart_epoch_id);
+      log_file.last_epoch_id = INVALID_EID;
+      log_file.is_active = false;
+      continue;
+    }
+    log_file.is_active = true;
+
+    if (type == LogRecordType::EPOCH_END) {
+      log_file.last_epoch_id = input.ReadLong();
+      log_file.max_epoch_id =
+          std::max(log_file.max_epoch_id, log_file.last_epoch_id);
+      continue;
+    }
+
+    PL_ASSERT(type == LogRecordType::TRANSACTION_BEGIN);
+    eid_t epoch_id = input.ReadVarInt();
+    cid_t commit_id =
+        input.ReadVarInt() ^ (static_cast<cid_t>(epoch_id) << 32);
+    log_file.max_epoch_id = std::max(log_file.max_epoch_id, epoch_id);
+
+    // the statements of a transaction logged by command are kept whole
+    const char *txn_data = static_cast<const char *>(input.getRawPointer(0));
+    size_t txn_size = data + offset - txn_data;
+    if (txn_size > 0 && static_cast<LogRecordType>(txn_data[0]) ==
+                            LogRecordType::COMMAND) {
+      commands_[file_id].push_back(
+          CommandRecord{epoch_id, commit_id, txn_data, txn_size});
+      continue;
+    }
+
+    while (true) {
+      type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+      if (type == LogRecordType::TRANSACTION_COMMIT) {
+        break;
+      }
+
+      if (ParseTupleRecord(input, type, epoch_id, commit_id, tables,
+                           records) == false) {
+        break;
+      }
+    }
+  }
+
+  log_file.valid_size = offset;
+  if (offset < size) {
+    LOG_INFO("Dropped a torn frame of %lu bytes from %s", size - offset,
+             log_file.segment_paths.back().c_str());
+  }
+}
+
+void LogicalLogRecovery::ReadCheckpointFile(const size_t file_id) {
+  auto &data = checkpoint_data_[file_id];
+  auto &records = records_[log_files_.size() + file_id];
+  records.resize(recovery_thread_count_);
+
+  data = FileUtil::GetFile(checkpoint_paths_[file_id]);
+
+  TableCache tables;
+
+  size_t offset = 0;
+  while (offset + sizeof(int32_t) <= data.size()) {
+    ReferenceSerializeInput length_input(data.data() + offset, sizeof(int32_t));
+    size_t length = length_input.ReadInt();
+
+    // the checkpoint is complete, so the frames are too
+    PL_ASSERT(offset + sizeof(int32_t) + length <= data.size());
+    ReferenceSerializeInput input(data.data() + offset + sizeof(int32_t),
+                                  length);
+    offset += sizeof(int32_t) + length;
+
+    auto type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+    PL_ASSERT(type == LogRecordType::TUPLE_INSERT);
+    if (ParseTupleRecord(input, type, checkpoint_epoch_id_, INVALID_CID,
+                         tables, records) == false) {
+      break;
+    }
+  }
+}
+
+bool LogicalLogRecovery::ParseTupleRecord(
+    SerializeInput &input, const LogRecordType type, const eid_t epoch_id,
+    const cid_t commit_id, TableCache &tables,
+    std::vector<std::vector<TupleRecord>> &records) {
+  oid_t database_id = input.ReadVarInt();
+  oid_t table_id = input.ReadVarInt();
+  uint64_t table_key = (static_cast<uint64_t>(database_id) << 32) | table_id;
+  auto table_itr = tables.find(table_key);
+  if (table_itr == tables.end()) {
+    storage::DataTable *table = nullptr;
+    try {
+      table = storage::StorageManager::GetInstance()->GetTableWithOid(
+          database_id, table_id);
+    } catch (CatalogException &e) {
+      LOG_ERROR("Cannot recover the records of missing table %u", table_id);
+    }
+    TableInfo table_info{table, {}};
+    if (table != nullptr) {
+      table_info.key_columns = GetKeyColumns(table);
+    }
+    table_itr = tables.emplace(table_key, table_info).first;
+  }
+
+  // the values cannot be parsed without the schema
+  auto table = table_itr->second.table;
+  if (table == nullptr) {
+    return false;
+  }
+
+  // records of the same tuple go to the same partition
+  auto schema = table->GetSchema();
+  auto &key_columns = table_itr->second.key_columns;
+  size_t hash = table_id;
+  const char *record_data = static_cast<const char *>(input.getRawPointer(0));
+  const char *column_bitmap = nullptr;
+  if (type == LogRecordType::TUPLE_UPDATE) {
+    column_bitmap = static_cast<const char *>(
+        input.getRawPointer((schema->GetColumnCount() + 7) / 8));
+  }
+  for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+       column_id++) {
+    if (HasColumn(column_bitmap, column_id) == false) {
+      continue;
+    }
+    auto value = type::Value::DeserializeFrom(
+        input, schema->GetType(column_id), nullptr);
+    if (std::find(key_columns.begin(), key_columns.end(), column_id) !=
+        key_columns.end()) {
+      value.HashCombine(hash);
+    }
+  }
+  size_t record_size =
+      static_cast<const char *>(input.getRawPointer(0)) - record_data;
+
+  records[hash % recovery_thread_count_].push_back(
+      TupleRecord{epoch_id, commit_id, type, table, record_data, record_size});
+  return true;
+}
+
+void LogicalLogRecovery::ReplayPartition(const size_t partition_id) {
+  std::vector<const TupleRecord *> records;
+  for (auto &file_records : records_) {
+    for (auto &record : file_records[partition_id]) {
+      // the checkpoint holds the records of the epochs up to its own
+      if (record.commit_id == INVALID_CID ||
+          (record.epoch_id > checkpoint_epoch_id_ &&
+           IsDurable(record.epoch_id) == true)) {
+        records.push_back(&record);
+      }
+    }
+  }
+
+  // the records of one transaction keep their order, the checkpoint ones
+  // come first
+  std::stable_sort(records.begin(), records.end(),
+                   [](const TupleRecord *lhs, const TupleRecord *rhs) {
+                     return lhs->commit_id < rhs->commit_id;
+                   });
+
+  // the surviving versions of each tuple, by the values of its key columns.
+  // only a table without primary key holds several.
+  typedef std::unordered_map<std::string,
+                             std::vector<std::unique_ptr<storage::Tuple>>>
+      TupleMap;
+  std::unordered_map<storage::DataTable *, TupleMap> tables;
+  std::unordered_map<storage::DataTable *, std::vector<oid_t>> key_columns;
+
+  // the mapped versions of the tuples of the snapshot tables that have
+  // records, by the values of their key columns
+  std::unordered_map<storage::DataTable *,
+                     std::unordered_map<std::string, ItemPointer>>
+      snapshot_locations;
+
+  type::EphemeralPool pool;
+  CopySerializeOutput key_output;
+
+  for (auto record : records) {
+    auto table = record->table;
+    auto schema = table->GetSchema();
+
+    auto key_columns_itr = key_columns.find(table);
+    if (key_columns_itr == key_columns.end()) {
+      key_columns_itr =
+          key_columns.emplace(table, GetKeyColumns(table)).first;
+    }
+
+    std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+    ReferenceSerializeInput input(record->data, record->size);
+    const char *column_bitmap = nullptr;
+    bool has_all_columns = true;
+    if (record->type == LogRecordType::TUPLE_UPDATE) {
+      column_bitmap = static_cast<const char *>(
+          input.getRawPointer((schema->GetColumnCount() + 7) / 8));
+    }
+    for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+         column_id++) {
+      if (HasColumn(column_bitmap, column_id) == false) {
+        has_all_columns = false;
+        continue;
+      }
+      tuple->SetValue(column_id,
+                      type::Value::DeserializeFrom(
+                          input, schema->GetType(column_id), &pool),
+                      &pool);
+    }
+
+    key_output.Reset();
+    for (auto column_id : key_columns_itr->second) {
+      tuple->GetValue(column_id).SerializeTo(key_output);
+    }
+    std::string key(key_output.Data(), key_output.Size());
+    auto &table_tuples = tables[table];
+    auto versions_itr = table_tuples.find(key);
+    if (versions_itr == table_tuples.end()) {
+      versions_itr = table_tuples.emplace(key, TupleMap::mapped_type()).first;
+
+      // the first record of a tuple of a snapshot follows its mapped version
+      std::unique_ptr<storage::Tuple> snapshot_tuple;
+      ItemPointer location;
+      if (snapshot_tables_.count(table) != 0) {
+        location = FindSnapshotTuple(table, *tuple, snapshot_tuple, &pool);
+      }
+      if (location.IsNull() == false) {
+        snapshot_locations[table][key] = location;
+        versions_itr->second.push_back(std::move(snapshot_tuple));
+      }
+    }
+    auto &versions = versions_itr->second;
+
+    switch (record->type) {
+      case LogRecordType::TUPLE_INSERT:
+        if (table->HasPrimaryKey() == true) {
+          versions.clear();
+        }
+        versions.push_back(std::move(tuple));
+        break;
+
+      case LogRecordType::TUPLE_UPDATE:
+        if (table->HasPrimaryKey() == false) {
+          LOG_ERROR("Cannot replay an update of table %u without primary key",
+                    table->GetOid());
+          break;
+        }
+
+        // the columns left out kept the values of the replaced version
+        if (has_all_columns == false) {
+          if (versions.empty() == true) {
+            LOG_ERROR("Cannot replay an update of a missing tuple of table %u",
+                      table->GetOid());
+            break;
+          }
+          for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+               column_id++) {
+            if (HasColumn(column_bitmap, column_id) == false) {
+              tuple->SetValue(column_id, versions.back()->GetValue(column_id),
+                              &pool);
+            }
+          }
+        }
+        versions.clear();
+        versions.push_back(std::move(tuple));
+        break;
+
+      case LogRecordType::TUPLE_DELETE:
+        if (versions.empty() == false) {
+          versions.pop_back();
+        }
+        break;
+
+      default:
+        LOG_ERROR("Invalid log record type %s",
+                  LogRecordTypeToString(record->type).c_str());
+        break;
+    }
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  concurrency::EpochManagerFactory::GetInstance().RegisterThread(partition_id);
+
+  for (auto &table_entry : tables) {
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    for (auto &tuple_entry : table_entry.second) {
+      for (auto &tuple : tuple_entry.second) {
+        tuples.push_back(std::move(tuple));
+      }
+    }
+
+    auto snapshot_itr = snapshot_locations.find(table_entry.first);
+    if (snapshot_itr != snapshot_locations.end()) {
+      std::vector<ItemPointer> locations;
+      for (auto &location_entry : snapshot_itr->second) {
+        locations.push_back(location_entry.second);
+      }
+      auto txn = txn_manager.BeginTransaction(partition_id);
+      if (ReplaceSnapshotTuples(txn, table_entry.first, locations, tuples) ==
+          false) {
+        LOG_ERROR("Cannot recover %lu tuples of table %u", tuples.size(),
+                  table_entry.first->GetOid());
+        txn_manager.AbortTransaction(txn);
+        continue;
+      }
+      txn_manager.CommitTransaction(txn);
+      continue;
+    }
+
+    if (tuples.empty() == true) {
+      continue;
+    }
+
+    auto txn = txn_manager.BeginTransaction(partition_id);
+    if (table_entry.first->BulkInsert(tuples, txn) == false) {
+      LOG_ERROR("Cannot recover %lu tuples of table %u", tuples.size(),
+                table_entry.first->GetOid());
+      txn_manager.AbortTransaction(txn);
+      continue;
+    }
+    txn_manager.CommitTransaction(txn);
+  }
+}
+
+ItemPointer LogicalLogRecovery::FindSnapshotTuple(
+    storage::DataTable *table, const storage::Tuple &key_tuple,
+    std::unique_ptr<storage::Tuple> &tuple, type::AbstractPool *pool) {
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); index_itr++) {
+    auto index = table->GetIndex(index_itr);
+    if (index == nullptr ||
+        index->GetIndexType() != IndexConstraintType::PRIMARY_KEY) {
+      continue;
+    }
+
+    auto key_schema = index->GetKeySchema();
+    storage::Tuple key(key_schema, true);
+    key.SetFromTuple(&key_tuple, key_schema->GetIndexedColumns(),
+                     index->GetPool());
+    std::vector<ItemPointer *> index_entries;
+    index->ScanKey(&key, index_entries);
+    if (index_entries.empty() == true) {
+      return INVALID_ITEMPOINTER;
+    }
+
+    // nothing but the recovery wrote to the table, the mapped version is
+    // the head of its chain
+    ItemPointer location = *index_entries[0];
+    auto tile_group =
+        catalog::Manager::GetInstance().GetTileGroup(location.block);
+    auto schema = table->GetSchema();
+    tuple.reset(new storage::Tuple(schema, true));
+    for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+         column_id++) {
+      tuple->SetValue(column_id, tile_group->GetValue(location.offset,
+                                                      column_id),
+                      pool);
+    }
+    return location;
+  }
+  return INVALID_ITEMPOINTER;
+}
+
+bool LogicalLogRecovery::ReplaceSnapshotTuples(
+    concurrency::Transaction *txn, storage::DataTable *table,
+    const std::vector<ItemPointer> &locations,
+    const std::vector<std::unique_ptr<storage::Tuple>> &tuples) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &manager = catalog::Manager::GetInstance();
+
+  // the mapped versions are deleted, then the surviving ones inserted, as
+  // an update of the primary key does
+  for (auto &location : locations) {
+    auto tile_group_header = manager.GetTileGroup(location.block)->GetHeader();
+    if (txn_manager.AcquireOwnership(txn, tile_group_header,
+                                     location.offset) == false) {
+      return false;
+    }
+    ItemPointer new_location = table->InsertEmptyVersion();
+    if (new_location.IsNull() == true) {
+      txn_manager.YieldOwnership(txn, tile_group_header, location.offset);
+      return false;
+    }
+    txn_manager.PerformDelete(txn, location, new_location);
+  }
+
+  for (auto &tuple : tuples) {
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer location = table->InsertTuple(tuple.get(), txn,
+                                              &index_entry_ptr);
+    if (location.block == INVALID_OID) {
+      return false;
+    }
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  }
+  return txn->GetResult() == ResultType::SUCCESS;
+}
+
+void LogicalLogRecovery::ReplayCommands() {
+  std::vector<const CommandRecord *> commands;
+  for (auto &file_commands : commands_) {
+    for (auto &command : file_commands) {
+      if (command.epoch_id > checkpoint_epoch_id_ &&
+          IsDurable(command.epoch_id) == true) {
+        commands.push_back(&command);
+      }
+    }
+  }
+  if (commands.empty() == true) {
+    return;
+  }
+
+  std::sort(commands.begin(), commands.end(),
+            [](const CommandRecord *lhs, const CommandRecord *rhs) {
+              return lhs->commit_id < rhs->commit_id;
+            });
+
+  // each statement is prepared once, on its first replay
+  std::vector<std::string> query_strings;
+  LogicalLogManager::ReadCommandFile(log_dir_, query_strings);
+  std::vector<std::shared_ptr<Statement>> statements(query_strings.size());
+
+  tcop::TrafficCop traffic_cop;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  size_t replayed_count = 0;
+
+  for (auto command : commands) {
+    ReferenceSerializeInput input(command->data, command->size);
+    auto txn = txn_manager.BeginTransaction();
+    bool success = true;
+
+    while (success == true) {
+      auto type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+      if (type == LogRecordType::TRANSACTION_COMMIT) {
+        break;
+      }
+      PL_ASSERT(type == LogRecordType::COMMAND);
+
+      uint32_t command_id = input.ReadVarInt();
+      size_t param_count = input.ReadVarInt();
+      std::vector<type::Value> params;
+      for (size_t param_id = 0; param_id < param_count; param_id++) {
+        auto param_type =
+            static_cast<type::TypeId>(input.ReadEnumInSingleByte());
+        params.push_back(type::Value::DeserializeFrom(input, param_type,
+                                                      nullptr));
+      }
+
+      if (command_id >= statements.size()) {
+        LOG_ERROR("Cannot replay missing command %u", command_id);
+        success = false;
+        break;
+      }
+      auto &statement = statements[command_id];
+      if (statement == nullptr) {
+        std::string error_message;
+        statement = traffic_cop.PrepareStatement(
+            "", query_strings[command_id], error_message);
+        if (statement == nullptr) {
+          LOG_ERROR("Cannot prepare command %u: %s", command_id,
+                    error_message.c_str());
+          success = false;
+          break;
+        }
+      }
+
+      std::vector<StatementResult> result;
+      std::vector<int> result_format(statement->GetTupleDescriptor().size(),
+                                     0);
+      auto status = executor::PlanExecutor::ExecutePlan(
+          statement->GetPlanTree(), txn, params, result, result_format);
+      success = status.m_result == ResultType::SUCCESS &&
+                txn->GetResult() == ResultType::SUCCESS;
+    }
+
+    if (success == false) {
+      LOG_ERROR("Cannot replay the commands of transaction %lu",
+                command->commit_id);
+      txn_manager.AbortTransaction(txn);
+      continue;
+    }
+    txn_manager.CommitTransaction(txn);
+    replayed_count++;
+  }
+
+  LOG_INFO("Replayed %lu of %lu transactions logged by command",
+           replayed_count, commands.size());
+}
+
+void LogicalLogRecovery::MarkLogFile(const LogFile &log_file) {
+  // the segment keeps its layout, mapped or written
+  auto &segment_path = log_file.segment_paths.back();
+  logging::LogFile segment_file;
+  if (segment_file.Open(segment_path) == false) {
+    return;
+  }
+
+  // the frames after the torn one would not be read
+  if (log_file.valid_size < log_file.data.size() &&
+      segment_file.Truncate(log_file.valid_size -
+                            log_file.last_segment_offset) == false) {
+    return;
+  }
+
+  // framed like a transaction: length, record type, persisted and restart
+  // epochs
+  CopySerializeOutput output;
+  output.WriteInt(0);
+  output.WriteEnumInSingleByte(static_cast<int>(LogRecordType::EPOCH_BEGIN));
+  output.WriteLong(persist_epoch_id_);
+  output.WriteLong(restart_epoch_id_);
+  output.WriteIntAt(0, static_cast<int32_t>(output.Size() - sizeof(int32_t)));
+
+  segment_file.Append(output.Data(), output.Size());
+  segment_file.Flush();
+}
+
+}  // namespace logging
+}  // namespace peloton
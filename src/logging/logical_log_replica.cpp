@@ -0,0 +1,383 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_replica.cpp
+//
+// Identification: src/logging/logical_log_replica.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_log_replica.h"
+
+#include <algorithm>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/container_tuple.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "index/index.h"
+#include "planner/project_info.h"
+#include "storage/data_table.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/serializeio.h"
+#include "type/value.h"
+
+namespace peloton {
+namespace logging {
+
+namespace {
+
+// whether an update record holds the column
+inline bool HasColumn(const char *column_bitmap, const oid_t column_id) {
+  return column_bitmap == nullptr ||
+         (column_bitmap[column_id / 8] & (1 << (column_id % 8))) != 0;
+}
+
+}  // namespace
+
+eid_t LogicalLogReplica::ReceiveLog(const size_t logger_id,
+                                    const size_t logger_count,
+                                    const int64_t sequence_number,
+                                    const std::string &log) {
+  std::lock_guard<std::mutex> lock(replica_mutex_);
+  if (logger_id >= logger_count) {
+    LOG_ERROR("Invalid logger %lu of %lu", logger_id, logger_count);
+    return replicated_epoch_id_.load();
+  }
+
+  // the primary started logging with other loggers
+  if (streams_.size() != logger_count) {
+    streams_.clear();
+    streams_.resize(logger_count);
+  }
+
+  auto &stream = streams_[logger_id];
+  if (sequence_number == 0) {
+    stream = LoggerStream();
+  }
+  stream.is_started = true;
+
+  if (sequence_number < stream.next_sequence_number) {
+    LOG_TRACE("Dropped batch %ld of logger %lu, it was received already",
+              sequence_number, logger_id);
+    return replicated_epoch_id_.load();
+  }
+
+  // the batches are parsed in the order they were shipped
+  stream.pending_batches.emplace(sequence_number, log);
+  while (stream.pending_batches.empty() == false &&
+         stream.pending_batches.begin()->first == stream.next_sequence_number) {
+    ParseBatch(stream, stream.pending_batches.begin()->second);
+    stream.pending_batches.erase(stream.pending_batches.begin());
+    stream.next_sequence_number++;
+  }
+
+  // an epoch is complete once every logger has shipped its end marker
+  eid_t epoch_id = MAX_EID;
+  for (auto &logger_stream : streams_) {
+    if (logger_stream.is_started == false) {
+      epoch_id = INVALID_EID;
+      break;
+    }
+    epoch_id = std::min(epoch_id, logger_stream.persist_epoch_id);
+  }
+  if (epoch_id != INVALID_EID && epoch_id != MAX_EID &&
+      epoch_id > replicated_epoch_id_.load()) {
+    ApplyEpochs(epoch_id);
+  }
+  return replicated_epoch_id_.load();
+}
+
+concurrency::Transaction *LogicalLogReplica::BeginSnapshot(
+    const size_t thread_id) {
+  return concurrency::TransactionManagerFactory::GetInstance().BeginTransaction(
+      thread_id, IsolationLevelType::READ_ONLY);
+}
+
+void LogicalLogReplica::Reset() {
+  std::lock_guard<std::mutex> lock(replica_mutex_);
+  streams_.clear();
+  replicated_epoch_id_ = INVALID_EID;
+}
+
+void LogicalLogReplica::ParseBatch(LoggerStream &stream,
+                                   const std::string &batch) {
+  const char *data = batch.data();
+  size_t size = batch.size();
+
+  size_t offset = 0;
+  while (offset + sizeof(int32_t) <= size) {
+    ReferenceSerializeInput length_input(data + offset, sizeof(int32_t));
+    size_t length = length_input.ReadInt();
+
+    // a batch only holds whole frames
+    if (offset + sizeof(int32_t) + length > size) {
+      LOG_ERROR("Dropped a torn frame of %lu bytes", size - offset);
+      break;
+    }
+
+    ReferenceSerializeInput input(data + offset + sizeof(int32_t), length);
+    offset += sizeof(int32_t) + length;
+
+    auto type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+    if (type == LogRecordType::EPOCH_END) {
+      stream.persist_epoch_id = input.ReadLong();
+      continue;
+    }
+    if (type != LogRecordType::TRANSACTION_BEGIN) {
+      continue;
+    }
+
+    eid_t epoch_id = input.ReadVarInt();
+    cid_t commit_id =
+        input.ReadVarInt() ^ (static_cast<cid_t>(epoch_id) << 32);
+    const char *txn_data = static_cast<const char *>(input.getRawPointer(0));
+    stream.transactions.push_back(TransactionFrame{
+        epoch_id, commit_id, std::string(txn_data, data + offset - txn_data)});
+  }
+}
+
+void LogicalLogReplica::ApplyEpochs(const eid_t epoch_id) {
+  std::vector<const TransactionFrame *> transactions;
+  for (auto &stream : streams_) {
+    for (auto &transaction : stream.transactions) {
+      if (transaction.epoch_id <= epoch_id) {
+        transactions.push_back(&transaction);
+      }
+    }
+  }
+
+  std::sort(transactions.begin(), transactions.end(),
+            [](const TransactionFrame *lhs, const TransactionFrame *rhs) {
+              return lhs->commit_id < rhs->commit_id;
+            });
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  size_t failed_count = 0;
+
+  for (auto transaction : transactions) {
+    ReferenceSerializeInput input(transaction->data.data(),
+                                  transaction->data.size());
+    while (true) {
+      auto type = static_cast<LogRecordType>(input.ReadEnumInSingleByte());
+      if (type == LogRecordType::TRANSACTION_COMMIT) {
+        break;
+      }
+
+      // the rest of the transaction cannot be parsed past a failed record
+      if (type == LogRecordType::COMMAND) {
+        LOG_ERROR("Cannot apply transaction %lu, it is logged by command",
+                  transaction->commit_id);
+        failed_count++;
+        break;
+      }
+      if (ApplyRecord(txn, input, type) == false) {
+        failed_count++;
+        break;
+      }
+    }
+  }
+
+  if (txn_manager.CommitTransaction(txn) != ResultType::SUCCESS) {
+    LOG_ERROR("Cannot apply the transactions up to epoch %lu", epoch_id);
+  } else if (failed_count > 0) {
+    LOG_ERROR("Applied %lu of %lu transactions up to epoch %lu",
+              transactions.size() - failed_count, transactions.size(),
+              epoch_id);
+  }
+
+  for (auto &stream : streams_) {
+    auto &stream_transactions = stream.transactions;
+    stream_transactions.erase(
+        std::remove_if(stream_transactions.begin(), stream_transactions.end(),
+                       [epoch_id](const TransactionFrame &transaction) {
+                         return transaction.epoch_id <= epoch_id;
+                       }),
+        stream_transactions.end());
+  }
+  replicated_epoch_id_ = epoch_id;
+}
+
+bool LogicalLogReplica::ApplyRecord(concurrency::Transaction *txn,
+                                    SerializeInput &input,
+                                    const LogRecordType type) {
+  oid_t database_id = input.ReadVarInt();
+  oid_t table_id = input.ReadVarInt();
+  storage::DataTable *table = nullptr;
+  try {
+    table = storage::StorageManager::GetInstance()->GetTableWithOid(
+        database_id, table_id);
+  } catch (CatalogException &e) {
+    table = nullptr;
+  }
+  if (table == nullptr) {
+    LOG_ERROR("Cannot apply the records of missing table %u", table_id);
+    return false;
+  }
+
+  auto schema = table->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+  const char *column_bitmap = nullptr;
+  if (type == LogRecordType::TUPLE_UPDATE) {
+    column_bitmap =
+        static_cast<const char *>(input.getRawPointer((column_count + 7) / 8));
+  }
+
+  type::EphemeralPool pool;
+  storage::Tuple tuple(schema, true);
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    if (HasColumn(column_bitmap, column_id) == true) {
+      tuple.SetValue(column_id,
+                     type::Value::DeserializeFrom(
+                         input, schema->GetType(column_id), &pool),
+                     &pool);
+    }
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  if (type == LogRecordType::TUPLE_INSERT) {
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+    if (location.block == INVALID_OID) {
+      LOG_ERROR("Cannot apply an insert into table %u", table_id);
+      return false;
+    }
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+    return true;
+  }
+
+  // the other records locate their tuple through the primary key
+  std::shared_ptr<index::Index> primary_index;
+  for (oid_t index_itr = 0; index_itr < table->GetIndexCount(); index_itr++) {
+    auto index = table->GetIndex(index_itr);
+    if (index != nullptr &&
+        index->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+      primary_index = index;
+      break;
+    }
+  }
+  if (primary_index == nullptr) {
+    LOG_ERROR("Cannot apply a %s of table %u without primary key",
+              LogRecordTypeToString(type).c_str(), table_id);
+    return false;
+  }
+
+  auto key_schema = primary_index->GetKeySchema();
+  auto &key_columns = key_schema->GetIndexedColumns();
+  storage::Tuple key(key_schema, true);
+  for (oid_t key_column_id = 0; key_column_id < key_columns.size();
+       key_column_id++) {
+    key.SetValue(key_column_id, tuple.GetValue(key_columns[key_column_id]),
+                 &pool);
+  }
+
+  // the latest version is the visible one, the replica is its only writer
+  auto &manager = catalog::Manager::GetInstance();
+  std::vector<ItemPointer *> item_pointers;
+  primary_index->ScanKey(&key, item_pointers);
+  ItemPointer location;
+  std::shared_ptr<storage::TileGroup> tile_group;
+  for (auto item_pointer : item_pointers) {
+    auto candidate_tile_group = manager.GetTileGroup(item_pointer->block);
+    if (txn_manager.IsVisible(txn, candidate_tile_group->GetHeader(),
+                              item_pointer->offset) == VisibilityType::OK) {
+      location = *item_pointer;
+      tile_group = candidate_tile_group;
+      break;
+    }
+  }
+  if (tile_group == nullptr) {
+    LOG_ERROR("Cannot apply a %s of a missing tuple of table %u",
+              LogRecordTypeToString(type).c_str(), table_id);
+    return false;
+  }
+
+  auto tile_group_header = tile_group->GetHeader();
+  bool is_written =
+      txn_manager.IsOwner(txn, tile_group_header, location.offset) == true &&
+      txn_manager.IsWritten(txn, tile_group_header, location.offset) == true;
+  if (is_written == false &&
+      (txn_manager.IsOwnable(txn, tile_group_header, location.offset) ==
+           false ||
+       txn_manager.AcquireOwnership(txn, tile_group_header, location.offset) ==
+           false)) {
+    LOG_ERROR("Cannot apply a %s of table %u, the tuple is locked",
+              LogRecordTypeToString(type).c_str(), table_id);
+    return false;
+  }
+
+  if (type == LogRecordType::TUPLE_DELETE) {
+    // a version written by this transaction is deleted in place
+    if (is_written == true) {
+      txn_manager.PerformDelete(txn, location);
+      return true;
+    }
+
+    ItemPointer new_location = table->InsertEmptyVersion();
+    if (new_location.IsNull() == true) {
+      txn_manager.YieldOwnership(txn, tile_group_header, location.offset);
+      LOG_ERROR("Cannot apply a delete of table %u", table_id);
+      return false;
+    }
+    txn_manager.PerformDelete(txn, location, new_location);
+    return true;
+  }
+
+  PL_ASSERT(type == LogRecordType::TUPLE_UPDATE);
+  TargetList target_list;
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    if (HasColumn(column_bitmap, column_id) == true &&
+        std::find(key_columns.begin(), key_columns.end(), column_id) ==
+            key_columns.end()) {
+      target_list.emplace_back(column_id, planner::DerivedAttribute(nullptr));
+    }
+  }
+
+  // a version written by this transaction is updated in place
+  if (is_written == true) {
+    for (auto &target : target_list) {
+      auto value = tuple.GetValue(target.first);
+      tile_group->SetValue(value, location.offset, target.first);
+    }
+    txn_manager.PerformUpdate(txn, location);
+    return true;
+  }
+
+  // the columns left out keep the values of the version
+  ItemPointer new_location = table->AcquireVersion();
+  auto new_tile_group = manager.GetTileGroup(new_location.block);
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    auto value = HasColumn(column_bitmap, column_id) == true
+                     ? tuple.GetValue(column_id)
+                     : tile_group->GetValue(location.offset, column_id);
+    new_tile_group->SetValue(value, new_location.offset, column_id);
+  }
+
+  expression::ContainerTuple<storage::TileGroup> new_tuple(
+      new_tile_group.get(), new_location.offset);
+  expression::ContainerTuple<storage::TileGroup> old_tuple(tile_group.get(),
+                                                           location.offset);
+  if (table->InstallVersion(
+          &new_tuple, &target_list, txn,
+          tile_group_header->GetIndirection(location.offset),
+          &old_tuple) == false) {
+    txn_manager.YieldOwnership(txn, tile_group_header, location.offset);
+    LOG_ERROR("Cannot apply an update of table %u", table_id);
+    return false;
+  }
+  txn_manager.PerformUpdate(txn, location, new_location);
+  return true;
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,307 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_logger.cpp
+//
+// Identification: src/logging/logical_logger.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/logical_logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "common/logger.h"
+#include "common/timer.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "logging/log_shipper.h"
+#include "util/file_util.h"
+
+namespace peloton {
+namespace logging {
+
+const std::string LogicalLogger::logging_filename_prefix_ = "log";
+
+namespace {
+
+// parse "<prefix>_<logger id>_<segment id>"
+bool ParseSegmentName(const std::string &name, const std::string &prefix,
+                      size_t &logger_id, size_t &segment_id) {
+  if (name.compare(0, prefix.size() + 1, prefix + "_") != 0) {
+    return false;
+  }
+  size_t separator = name.find('_', prefix.size() + 1);
+  if (separator == std::string::npos) {
+    return false;
+  }
+  try {
+    logger_id = std::stoul(name.substr(prefix.size() + 1));
+    segment_id = std::stoul(name.substr(separator + 1));
+  } catch (std::exception &e) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+LogicalLogger::~LogicalLogger() { CloseLogFile(); }
+
+std::vector<size_t> LogicalLogger::GetSegmentIds(const std::string &log_dir,
+                                                 const size_t logger_id) {
+  std::vector<size_t> segment_ids;
+  size_t name_logger_id, segment_id;
+  for (auto &name : FileUtil::ListDirectory(log_dir)) {
+    if (ParseSegmentName(name, logging_filename_prefix_, name_logger_id,
+                         segment_id) == true &&
+        name_logger_id == logger_id) {
+      segment_ids.push_back(segment_id);
+    }
+  }
+  std::sort(segment_ids.begin(), segment_ids.end());
+  return segment_ids;
+}
+
+std::vector<size_t> LogicalLogger::GetLoggerIds(const std::string &log_dir) {
+  std::vector<size_t> logger_ids;
+  size_t logger_id, segment_id;
+  for (auto &name : FileUtil::ListDirectory(log_dir)) {
+    if (ParseSegmentName(name, logging_filename_prefix_, logger_id,
+                         segment_id) == true) {
+      logger_ids.push_back(logger_id);
+    }
+  }
+  std::sort(logger_ids.begin(), logger_ids.end());
+  logger_ids.erase(std::unique(logger_ids.begin(), logger_ids.end()),
+                   logger_ids.end());
+  return logger_ids;
+}
+
+bool LogicalLogger::OpenLogFile(const eid_t existing_epoch_id) {
+  PL_ASSERT(log_file_ == nullptr);
+
+  // the segments of earlier runs are removed once a checkpoint covers them
+  segment_id_ = 0;
+  for (auto segment_id : GetSegmentIds(log_dir_, logger_id_)) {
+    closed_segments_.emplace_back(segment_id, existing_epoch_id);
+    segment_id_ = segment_id + 1;
+  }
+
+  std::unique_ptr<LogFile> log_file(new LogFile());
+  if (log_file->Open(GetLogFilePath(), backend_type_) == false) {
+    return false;
+  }
+  log_file_ = std::move(log_file);
+  return true;
+}
+
+void LogicalLogger::CloseLogFile() { log_file_.reset(); }
+
+void LogicalLogger::RegisterWorker(WorkerContext *worker_context) {
+  worker_lock_.Lock();
+  workers_.push_back(worker_context);
+  worker_lock_.Unlock();
+}
+
+void LogicalLogger::Run() {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  while (true) {
+    // the workers are stopped before the logger, so the last pass sees every
+    // record they wrote
+    bool is_running = is_running_.load();
+
+    // every transaction of the expired epochs has finished logging, so the
+    // epoch is read before the buffers are taken
+    eid_t expired_epoch_id = epoch_manager.GetExpiredEpochId();
+
+    CollectBuffers(expired_epoch_id, is_running == false);
+
+    // the buffers and the epoch end marker go out in one batch and one sync
+    bool has_new_epoch = (expired_epoch_id != MAX_EID &&
+                          expired_epoch_id > persist_epoch_id_.load());
+    bool is_persisted = PersistBuffers(
+        has_new_epoch == true ? expired_epoch_id : INVALID_EID);
+
+    // the epoch is only acknowledged once its sync has completed. after a
+    // failed write the file may miss records, so no later epoch is either.
+    if (is_persisted == false) {
+      has_failed_ = true;
+    }
+    if (has_new_epoch == true && has_failed_ == false) {
+      persist_epoch_id_ = expired_epoch_id;
+    }
+
+    eid_t truncate_epoch_id = truncate_epoch_id_.load();
+    if (truncate_epoch_id != truncated_epoch_id_) {
+      RotateLogFile(truncate_epoch_id);
+    }
+
+    if (is_running == false) {
+      break;
+    }
+
+    // Sleep for an epoch
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH.load()));
+  }
+}
+
+void LogicalLogger::CollectBuffers(const eid_t expired_epoch_id,
+                                   const bool all_buffers) {
+  worker_lock_.Lock();
+  for (auto worker_context : workers_) {
+    worker_context->buffer_lock.Lock();
+
+    for (auto &buffer : worker_context->full_buffers) {
+      persist_buffers_.emplace_back(worker_context, std::move(buffer));
+    }
+    worker_context->full_buffers.clear();
+
+    // no transaction will add to the buffer of an expired epoch, take it
+    // instead of waiting for the worker to seal it
+    auto &current_buffer = worker_context->current_buffer;
+    if (current_buffer != nullptr &&
+        (all_buffers == true ||
+         current_buffer->GetEpochId() <= expired_epoch_id)) {
+      persist_buffers_.emplace_back(worker_context, std::move(current_buffer));
+    }
+
+    worker_context->buffer_lock.Unlock();
+  }
+  worker_lock_.Unlock();
+}
+
+bool LogicalLogger::PersistBuffers(const eid_t epoch_id) {
+  LoggerStats flush_stats;
+  Timer<std::micro> timer;
+  timer.Start();
+
+  for (auto &entry : persist_buffers_) {
+    auto &buffer = entry.second;
+    segment_epoch_id_ =
+        std::max<eid_t>(segment_epoch_id_, buffer->GetEpochId());
+    log_file_->Append(buffer->GetData(), buffer->GetSize());
+
+    flush_stats.flush_byte_count += buffer->GetSize();
+    flush_stats.flush_buffer_count++;
+    flush_stats.flush_txn_count += buffer->GetFrameCount();
+  }
+
+  if (epoch_id != INVALID_EID) {
+    PersistEpochEnd(epoch_id);
+    flush_stats.flush_byte_count += marker_output_.Size();
+  }
+
+  bool is_persisted = log_file_->Flush();
+
+  timer.Stop();
+  if (is_persisted == true && flush_stats.flush_byte_count > 0) {
+    flush_stats.flush_count = 1;
+    flush_stats.max_flush_byte_count = flush_stats.flush_byte_count;
+    flush_stats.flush_time = static_cast<uint64_t>(timer.GetDuration());
+
+    stats_lock_.Lock();
+    stats_ += flush_stats;
+    stats_lock_.Unlock();
+  }
+
+  // the replicas only receive what the primary cannot lose
+  auto &log_shipper = LogShipper::GetInstance();
+  if (is_persisted == true && log_shipper.IsEnabled() == true) {
+    std::string frames;
+    for (auto &entry : persist_buffers_) {
+      frames.append(entry.second->GetData(), entry.second->GetSize());
+    }
+    if (epoch_id != INVALID_EID) {
+      frames.append(marker_output_.Data(), marker_output_.Size());
+    }
+    if (frames.empty() == false) {
+      log_shipper.Ship(logger_id_, frames);
+    }
+  }
+
+  // the buffers are only reused once written out
+  for (auto &entry : persist_buffers_) {
+    entry.second->Reset();
+    entry.first->buffer_pool.PutBuffer(std::move(entry.second));
+  }
+  persist_buffers_.clear();
+
+  return is_persisted;
+}
+
+LoggerStats LogicalLogger::GetStats() {
+  stats_lock_.Lock();
+  LoggerStats stats = stats_;
+  stats_lock_.Unlock();
+  return stats;
+}
+
+void LogicalLogger::TruncateLog(const eid_t checkpoint_epoch_id) {
+  eid_t truncate_epoch_id = truncate_epoch_id_.load();
+  while (truncate_epoch_id < checkpoint_epoch_id &&
+         truncate_epoch_id_.compare_exchange_weak(
+             truncate_epoch_id, checkpoint_epoch_id) == false);
+}
+
+void LogicalLogger::RotateLogFile(const eid_t checkpoint_epoch_id) {
+  truncated_epoch_id_ = checkpoint_epoch_id;
+
+  // the current segment is synced by the pass that precedes the rotation.
+  // it is kept in use if the next one cannot be opened.
+  std::unique_ptr<LogFile> segment_file(new LogFile());
+  if (segment_file->Open(GetSegmentPath(log_dir_, logger_id_, segment_id_ + 1),
+                         backend_type_) == false) {
+    return;
+  }
+
+  log_file_ = std::move(segment_file);
+  closed_segments_.emplace_back(segment_id_, segment_epoch_id_);
+  segment_id_++;
+  segment_epoch_id_ = INVALID_EID;
+
+  // the persisted epoch stays known when the earlier segments are removed
+  if (persist_epoch_id_.load() != INVALID_EID) {
+    PersistEpochEnd(persist_epoch_id_.load());
+    log_file_->Flush();
+  }
+
+  // segments are removed oldest first, so the remaining ones stay contiguous
+  size_t removed_count = 0;
+  while (removed_count < closed_segments_.size() &&
+         closed_segments_[removed_count].second <= checkpoint_epoch_id) {
+    auto closed_path = GetSegmentPath(log_dir_, logger_id_,
+                                      closed_segments_[removed_count].first);
+    if (std::remove(closed_path.c_str()) != 0) {
+      LOG_ERROR("Cannot remove log file %s", closed_path.c_str());
+      break;
+    }
+    removed_count++;
+  }
+  closed_segments_.erase(closed_segments_.begin(),
+                         closed_segments_.begin() + removed_count);
+}
+
+void LogicalLogger::PersistEpochEnd(const eid_t epoch_id) {
+  // framed like a transaction: length, record type, epoch id. the marker is
+  // queued, so at most one is written per flush.
+  marker_output_.Reset();
+  size_t start = marker_output_.Position();
+  marker_output_.WriteInt(0);
+  marker_output_.WriteEnumInSingleByte(
+      static_cast<int>(LogRecordType::EPOCH_END));
+  marker_output_.WriteLong(epoch_id);
+  marker_output_.WriteIntAt(
+      start, static_cast<int32_t>(marker_output_.Position() - start -
+                                  sizeof(int32_t)));
+
+  log_file_->Append(marker_output_.Data(), marker_output_.Size());
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gcbench.cpp
+//
+// Identification: src/main/gcbench/gcbench.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark/gcbench/gcbench_configuration.h"
+#include "benchmark/gcbench/gcbench_loader.h"
+#include "benchmark/gcbench/gcbench_workload.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "gc/gc_manager_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace gcbench {
+
+configuration state;
+
+// Run one point of the sweep
+void RunBenchmark(bool append_output) {
+  gc::GCManagerFactory::Configure(state.gc_thread_count);
+  concurrency::EpochManagerFactory::Configure(
+      EpochType::DECENTRALIZED_EPOCH);
+
+  std::unique_ptr<std::thread> epoch_thread;
+  std::vector<std::unique_ptr<std::thread>> gc_threads;
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto thread_count = GetThreadCount();
+  for (size_t thread_id = 0; thread_id < thread_count; ++thread_id) {
+    epoch_manager.RegisterThread(thread_id);
+  }
+  epoch_manager.StartEpoch(epoch_thread);
+
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  gc_manager.StartGC(gc_threads);
+
+  CreateGCBenchDatabase();
+  LoadGCBenchDatabase();
+
+  RunWorkload();
+
+  gc_manager.StopGC();
+  epoch_manager.StopEpoch();
+
+  for (auto &gc_thread : gc_threads) {
+    PL_ASSERT(gc_thread != nullptr);
+    gc_thread->join();
+  }
+
+  PL_ASSERT(epoch_thread != nullptr);
+  epoch_thread->join();
+
+  WriteOutput(append_output);
+}
+
+// A process per point of the sweep, as the gc threads and the database are
+// set up once per process
+bool RunSweep() {
+  bool is_successful = true;
+  bool append_output = false;
+  for (auto gc_thread_count : state.gc_thread_counts) {
+    for (auto reader_duration : state.reader_durations) {
+      state.gc_thread_count = gc_thread_count;
+      state.reader_duration = reader_duration;
+
+      LOG_INFO("Run with %d gc threads, readers open for %.1lf s",
+               gc_thread_count, reader_duration);
+
+      fflush(stdout);
+      pid_t pid = fork();
+      if (pid == 0) {
+        RunBenchmark(append_output);
+        fflush(stdout);
+
+        // the singletons are not torn down
+        _exit(EXIT_SUCCESS);
+      }
+
+      int status = 0;
+      if (pid < 0 || waitpid(pid, &status, 0) != pid ||
+          WIFEXITED(status) == false || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        LOG_ERROR("Run with %d gc threads, readers open for %.1lf s failed",
+                  gc_thread_count, reader_duration);
+        is_successful = false;
+      }
+      append_output = true;
+    }
+  }
+  return is_successful;
+}
+
+}  // namespace gcbench
+}  // namespace benchmark
+}  // namespace peloton
+
+int main(int argc, char **argv) {
+  peloton::benchmark::gcbench::ParseArguments(
+      argc, argv, peloton::benchmark::gcbench::state);
+
+  return peloton::benchmark::gcbench::RunSweep() ? EXIT_SUCCESS
+                                                 : EXIT_FAILURE;
+}
@@ -0,0 +1,296 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gcbench_configuration.cpp
+//
+// Identification: src/main/gcbench/gcbench_configuration.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <getopt.h>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include "benchmark/gcbench/gcbench_configuration.h"
+#include "common/logger.h"
+
+namespace peloton {
+namespace benchmark {
+namespace gcbench {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : gcbench <options> \n"
+          "   -h --help              :  print help message \n"
+          "   -k --scale_factor      :  # of K tuples \n"
+          "   -d --duration          :  execution duration \n"
+          "   -p --profile_duration  :  sampling interval \n"
+          "   -b --writer_count      :  # of updating backends \n"
+          "   -o --update_count      :  # of updates per transaction \n"
+          "   -r --reader_count      :  # of backends reading hot keys \n"
+          "   -l --long_reader_count :  # of long-running readers \n"
+          "   -x --hot_key_count     :  # of hot keys \n"
+          "   -q --hot_ratio         :  fraction of updates on hot keys \n"
+          "   -g --gc_thread_count   :  # of gc threads, or a list to sweep \n"
+          "   -L --reader_duration   :  seconds a long reader stays open, or "
+          "a list to sweep \n");
+}
+
+static struct option opts[] = {
+    {"scale_factor", optional_argument, NULL, 'k'},
+    {"duration", optional_argument, NULL, 'd'},
+    {"profile_duration", optional_argument, NULL, 'p'},
+    {"writer_count", optional_argument, NULL, 'b'},
+    {"update_count", optional_argument, NULL, 'o'},
+    {"reader_count", optional_argument, NULL, 'r'},
+    {"long_reader_count", optional_argument, NULL, 'l'},
+    {"hot_key_count", optional_argument, NULL, 'x'},
+    {"hot_ratio", optional_argument, NULL, 'q'},
+    {"gc_thread_count", optional_argument, NULL, 'g'},
+    {"reader_duration", optional_argument, NULL, 'L'},
+    {NULL, 0, NULL, 0}};
+
+// A comma-separated list of values
+template <typename T>
+static std::vector<T> ParseList(const char *list) {
+  std::vector<T> parsed;
+  const char *p = list;
+  while (true) {
+    parsed.push_back(static_cast<T>(atof(p)));
+    p = strchr(p, ',');
+    if (p == nullptr) {
+      break;
+    }
+    p++;
+  }
+  return parsed;
+}
+
+void ValidateScaleFactor(const configuration &state) {
+  if (state.scale_factor <= 0) {
+    LOG_ERROR("Invalid scale_factor :: %d", state.scale_factor);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "scale_factor", state.scale_factor);
+}
+
+void ValidateDuration(const configuration &state) {
+  if (state.duration <= 0) {
+    LOG_ERROR("Invalid duration :: %lf", state.duration);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "duration", state.duration);
+}
+
+void ValidateProfileDuration(const configuration &state) {
+  if (state.profile_duration <= 0 ||
+      state.profile_duration > state.duration) {
+    LOG_ERROR("Invalid profile_duration :: %lf", state.profile_duration);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "profile_duration", state.profile_duration);
+}
+
+void ValidateThreadCounts(const configuration &state) {
+  if (state.writer_count <= 0) {
+    LOG_ERROR("Invalid writer_count :: %d", state.writer_count);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.update_count <= 0) {
+    LOG_ERROR("Invalid update_count :: %d", state.update_count);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.reader_count < 0) {
+    LOG_ERROR("Invalid reader_count :: %d", state.reader_count);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.long_reader_count < 0) {
+    LOG_ERROR("Invalid long_reader_count :: %d", state.long_reader_count);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "writer_count", state.writer_count);
+  LOG_TRACE("%s : %d", "update_count", state.update_count);
+  LOG_TRACE("%s : %d", "reader_count", state.reader_count);
+  LOG_TRACE("%s : %d", "long_reader_count", state.long_reader_count);
+}
+
+void ValidateHotKeys(const configuration &state) {
+  if (state.hot_key_count <= 0 ||
+      state.hot_key_count > state.scale_factor * 1000) {
+    LOG_ERROR("Invalid hot_key_count :: %d", state.hot_key_count);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.hot_ratio < 0 || state.hot_ratio > 1) {
+    LOG_ERROR("Invalid hot_ratio :: %lf", state.hot_ratio);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "hot_key_count", state.hot_key_count);
+  LOG_TRACE("%s : %lf", "hot_ratio", state.hot_ratio);
+}
+
+void ValidateSweep(const configuration &state) {
+  for (auto gc_thread_count : state.gc_thread_counts) {
+    if (gc_thread_count <= 0) {
+      LOG_ERROR("Invalid gc_thread_count :: %d", gc_thread_count);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  for (auto reader_duration : state.reader_durations) {
+    if (reader_duration < 0) {
+      LOG_ERROR("Invalid reader_duration :: %lf", reader_duration);
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.scale_factor = 10;
+  state.duration = 30;
+  state.profile_duration = 1;
+  state.writer_count = 4;
+  state.update_count = 4;
+  state.reader_count = 2;
+  state.long_reader_count = 1;
+  state.hot_key_count = 100;
+  state.hot_ratio = 0.9;
+  state.gc_thread_counts = {1};
+  state.reader_durations = {0};
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hk:d:p:b:o:r:l:x:q:g:L:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'k':
+        state.scale_factor = atoi(optarg);
+        break;
+      case 'd':
+        state.duration = atof(optarg);
+        break;
+      case 'p':
+        state.profile_duration = atof(optarg);
+        break;
+      case 'b':
+        state.writer_count = atoi(optarg);
+        break;
+      case 'o':
+        state.update_count = atoi(optarg);
+        break;
+      case 'r':
+        state.reader_count = atoi(optarg);
+        break;
+      case 'l':
+        state.long_reader_count = atoi(optarg);
+        break;
+      case 'x':
+        state.hot_key_count = atoi(optarg);
+        break;
+      case 'q':
+        state.hot_ratio = atof(optarg);
+        break;
+      case 'g':
+        state.gc_thread_counts = ParseList<int>(optarg);
+        break;
+      case 'L':
+        state.reader_durations = ParseList<double>(optarg);
+        break;
+
+      case 'h':
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+
+      default:
+        LOG_ERROR("Unknown option: -%c-", c);
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+    }
+  }
+
+  // Print configuration
+  ValidateScaleFactor(state);
+  ValidateDuration(state);
+  ValidateProfileDuration(state);
+  ValidateThreadCounts(state);
+  ValidateHotKeys(state);
+  ValidateSweep(state);
+
+  state.gc_thread_count = state.gc_thread_counts.front();
+  state.reader_duration = state.reader_durations.front();
+}
+
+void WriteOutput(bool append) {
+  std::ofstream out("outputfile.summary",
+                    append ? std::ios::app : std::ios::trunc);
+
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("%d %d %d %d %d %.1lf :: %lf %lf %lf :: %lf %lf %lf :: %ld",
+           state.scale_factor, state.writer_count, state.reader_count,
+           state.long_reader_count, state.gc_thread_count,
+           state.reader_duration, state.update_throughput, state.abort_rate,
+           state.reclaim_throughput, state.read_p50_latency,
+           state.read_p99_latency, state.read_p999_latency,
+           state.memory_growth);
+
+  out << state.scale_factor << " ";
+  out << state.writer_count << " ";
+  out << state.reader_count << " ";
+  out << state.long_reader_count << " ";
+  out << state.gc_thread_count << " ";
+  out << state.reader_duration << " ";
+  out << state.update_throughput << " ";
+  out << state.abort_rate << " ";
+  out << state.reclaim_throughput << " ";
+  out << state.read_p50_latency << " ";
+  out << state.read_p99_latency << " ";
+  out << state.read_p999_latency << " ";
+  out << state.read_max_latency << " ";
+  out << state.memory_growth << "\n";
+
+  // reclaim throughput, backlog, memory and chain lengths of every interval
+  for (size_t round_id = 0; round_id < state.profile_results.size();
+       ++round_id) {
+    auto &result = state.profile_results[round_id];
+    out << "[" << std::setw(3) << std::left
+        << state.profile_duration * round_id << " - " << std::setw(3)
+        << std::left << state.profile_duration * (round_id + 1)
+        << " s]: " << result.reclaim_throughput << " " << result.gc_backlog
+        << " " << result.memory_bytes << " " << result.average_chain_length
+        << " " << result.max_chain_length << "\n";
+  }
+
+  // the chains of every length at the end: the longest length of the
+  // bucket and the count
+  out << "chains:";
+  for (size_t bucket = 0; bucket < state.chain_length_counts.size();
+       bucket++) {
+    out << " " << (1UL << bucket) << ":" << state.chain_length_counts[bucket];
+  }
+  out << "\n";
+
+  out.flush();
+  out.close();
+}
+
+}  // namespace gcbench
+}  // namespace benchmark
+}  // namespace peloton
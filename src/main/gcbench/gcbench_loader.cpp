@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gcbench_loader.cpp
+//
+// Identification: src/main/gcbench/gcbench_loader.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "benchmark/gcbench/gcbench_loader.h"
+#include "catalog/catalog.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/insert_executor.h"
+#include "index/index_factory.h"
+#include "planner/insert_plan.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/table_factory.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace gcbench {
+
+storage::Database *gcbench_database = nullptr;
+
+storage::DataTable *gcbench_table = nullptr;
+
+void CreateGCBenchDatabase() {
+  const bool is_inlined = true;
+
+  auto catalog = catalog::Catalog::GetInstance();
+  gcbench_database = new storage::Database(gcbench_database_oid);
+  catalog->AddDatabase(gcbench_database);
+
+  // The key and the fields, all INTEGER
+  std::vector<catalog::Column> columns;
+  for (int col_itr = 0; col_itr <= gcbench_field_count; col_itr++) {
+    columns.push_back(catalog::Column(
+        type::TypeId::INTEGER, type::Type::GetTypeSize(type::TypeId::INTEGER),
+        col_itr == 0 ? "GC_KEY" : "FIELD" + std::to_string(col_itr),
+        is_inlined));
+  }
+
+  bool own_schema = true;
+  bool adapt_table = false;
+  catalog::Schema *table_schema = new catalog::Schema(columns);
+  gcbench_table = storage::TableFactory::GetDataTable(
+      gcbench_database_oid, gcbench_table_oid, table_schema, "GCBENCH",
+      DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
+  gcbench_database->AddTable(gcbench_table);
+
+  // Primary index on the key
+  std::vector<oid_t> key_attrs = {0};
+  auto tuple_schema = gcbench_table->GetSchema();
+  auto key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+
+  bool unique = true;
+  auto index_metadata = new index::IndexMetadata(
+      "primary_index", gcbench_table_pkey_index_oid, gcbench_table_oid,
+      gcbench_database_oid, IndexType::BWTREE,
+      IndexConstraintType::PRIMARY_KEY, tuple_schema, key_schema, key_attrs,
+      unique);
+
+  std::shared_ptr<index::Index> pkey_index(
+      index::IndexFactory::GetIndex(index_metadata));
+  gcbench_table->AddIndex(pkey_index);
+}
+
+void LoadGCBenchDatabase() {
+  auto start_time = std::chrono::steady_clock::now();
+
+  const int tuple_count = state.scale_factor * 1000;
+  auto table_schema = gcbench_table->GetSchema();
+  const bool allocate = true;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  for (int rowid = 0; rowid < tuple_count; rowid++) {
+    std::unique_ptr<storage::Tuple> tuple(
+        new storage::Tuple(table_schema, allocate));
+    auto value = type::ValueFactory::GetIntegerValue(rowid);
+    for (int col_itr = 0; col_itr <= gcbench_field_count; col_itr++) {
+      tuple->SetValue(col_itr, value, nullptr);
+    }
+
+    planner::InsertPlan node(gcbench_table, std::move(tuple));
+    executor::InsertExecutor executor(&node, context.get());
+    executor.Execute();
+  }
+
+  txn_manager.CommitTransaction(txn);
+
+  double diff = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start_time).count();
+  LOG_INFO("Loaded %d tuples in %lf ms", tuple_count, diff);
+}
+
+}  // namespace gcbench
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,365 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gcbench_workload.cpp
+//
+// Identification: src/main/gcbench/gcbench_workload.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark/gcbench/gcbench_loader.h"
+#include "benchmark/gcbench/gcbench_workload.h"
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/index_scan_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/update_executor.h"
+#include "expression/expression_util.h"
+#include "gc/gc_manager_factory.h"
+#include "planner/index_scan_plan.h"
+#include "planner/update_plan.h"
+#include "statistics/latency_histogram.h"
+#include "statistics/memory_usage.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace gcbench {
+
+/////////////////////////////////////////////////////////
+// WORKLOAD
+/////////////////////////////////////////////////////////
+
+volatile bool is_running = true;
+
+// committed and aborted transactions of every writer
+PadInt *commit_counts;
+
+PadInt *abort_counts;
+
+// latencies of the hot reads of every reader
+stats::LatencyHistogram *read_latencies;
+
+size_t GetThreadCount() {
+  size_t long_reader_count =
+      state.reader_duration > 0 ? state.long_reader_count : 0;
+  return state.writer_count + state.reader_count + long_reader_count;
+}
+
+// The index scan of the tuple with the key
+static std::unique_ptr<planner::IndexScanPlan> KeyScan(int key) {
+  std::vector<oid_t> column_ids;
+  for (int col_itr = 0; col_itr <= gcbench_field_count; col_itr++) {
+    column_ids.push_back(col_itr);
+  }
+
+  std::vector<oid_t> key_column_ids = {0};
+  std::vector<ExpressionType> expr_types = {ExpressionType::COMPARE_EQUAL};
+  std::vector<type::Value> values = {
+      type::ValueFactory::GetIntegerValue(key).Copy()};
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  auto pkey_index =
+      gcbench_table->GetIndexWithOid(gcbench_table_pkey_index_oid);
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      pkey_index, key_column_ids, expr_types, values, runtime_keys);
+
+  return std::unique_ptr<planner::IndexScanPlan>(new planner::IndexScanPlan(
+      gcbench_table, nullptr, column_ids, index_scan_desc));
+}
+
+static void ReadRecord(executor::ExecutorContext *context, int key) {
+  auto index_scan_node = KeyScan(key);
+  executor::IndexScanExecutor index_scan_executor(index_scan_node.get(),
+                                                  context);
+  index_scan_executor.Init();
+  while (index_scan_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        index_scan_executor.GetOutput());
+  }
+}
+
+// Set every field of the tuple to the value, so every update is a version
+static void UpdateRecord(executor::ExecutorContext *context, int key,
+                         int value) {
+  auto index_scan_node = KeyScan(key);
+  executor::IndexScanExecutor index_scan_executor(index_scan_node.get(),
+                                                  context);
+
+  TargetList target_list;
+  DirectMapList direct_map_list;
+  direct_map_list.emplace_back(0, std::pair<oid_t, oid_t>(0, 0));
+  for (int col_itr = 1; col_itr <= gcbench_field_count; col_itr++) {
+    planner::DerivedAttribute attr{expression::ExpressionUtil::
+        ConstantValueFactory(type::ValueFactory::GetIntegerValue(value))};
+    target_list.emplace_back(col_itr, attr);
+  }
+
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(std::move(target_list),
+                               std::move(direct_map_list)));
+  planner::UpdatePlan update_node(gcbench_table, std::move(project_info));
+
+  executor::UpdateExecutor update_executor(&update_node, context);
+  update_executor.AddChild(&index_scan_executor);
+  update_executor.Init();
+  while (update_executor.Execute() == true);
+}
+
+// A hot key by the hot ratio, any key otherwise
+static int NextUpdateKey(FastRandom &rng) {
+  if (rng.NextUniform() < state.hot_ratio) {
+    return rng.next_u32() % state.hot_key_count;
+  }
+  return rng.next_u32() % (state.scale_factor * 1000);
+}
+
+static bool RunUpdate(const size_t thread_id, FastRandom &rng) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction(thread_id);
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  for (int update_itr = 0; update_itr < state.update_count; update_itr++) {
+    UpdateRecord(context.get(), NextUpdateKey(rng), rng.next_u32());
+    if (txn->GetResult() != ResultType::SUCCESS) {
+      txn_manager.AbortTransaction(txn);
+      return false;
+    }
+  }
+
+  return txn_manager.CommitTransaction(txn) == ResultType::SUCCESS;
+}
+
+static void RunWriter(const size_t thread_id) {
+  FastRandom rng(rand());
+  while (is_running == true) {
+    if (RunUpdate(thread_id, rng) == true) {
+      commit_counts[thread_id].data++;
+    } else {
+      abort_counts[thread_id].data++;
+    }
+  }
+}
+
+// One hot key per transaction
+static void RunReader(const size_t thread_id, const size_t reader_id) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  FastRandom rng(rand());
+  while (is_running == true) {
+    Timer<std::ratio<1, 1000>> timer;
+    timer.Start();
+
+    auto txn = txn_manager.BeginTransaction(thread_id);
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+    ReadRecord(context.get(), rng.next_u32() % state.hot_key_count);
+    if (txn->GetResult() != ResultType::SUCCESS) {
+      txn_manager.AbortTransaction(txn);
+      continue;
+    }
+    if (txn_manager.CommitTransaction(txn) != ResultType::SUCCESS) {
+      continue;
+    }
+
+    timer.Stop();
+    read_latencies[reader_id].Record(timer.GetDuration());
+  }
+}
+
+// Keeps a transaction open for the reader duration, reading now and then.
+// Its epoch does not expire meanwhile, so the versions it could see are
+// kept.
+static void RunLongReader(const size_t thread_id) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  FastRandom rng(rand());
+  while (is_running == true) {
+    auto txn = txn_manager.BeginTransaction(thread_id);
+    std::unique_ptr<executor::ExecutorContext> context(
+        new executor::ExecutorContext(txn));
+
+    auto start_time = std::chrono::steady_clock::now();
+    while (is_running == true && txn->GetResult() == ResultType::SUCCESS &&
+           std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start_time).count() <
+               state.reader_duration) {
+      ReadRecord(context.get(), rng.next_u32() % (state.scale_factor * 1000));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (txn->GetResult() == ResultType::SUCCESS) {
+      txn_manager.CommitTransaction(txn);
+    } else {
+      txn_manager.AbortTransaction(txn);
+    }
+  }
+}
+
+// The bytes of the tiles, their headers and their varlen pools
+static size_t GetStorageBytes() {
+  auto usage = stats::MemoryUsage::GetTracked();
+  return usage.GetBytes(MemoryComponentType::TILE_DATA) +
+         usage.GetBytes(MemoryComponentType::TILE_GROUP_HEADER) +
+         usage.GetBytes(MemoryComponentType::VARLEN_POOL);
+}
+
+void SampleVersionChains(ProfileResult &result,
+                         std::vector<uint64_t> &chain_length_counts) {
+  auto &manager = catalog::Manager::GetInstance();
+  chain_length_counts.assign(chain_length_bucket_count, 0);
+  size_t chain_count = 0;
+  size_t version_count = 0;
+  result.max_chain_length = 0;
+
+  // The headers change under the walk, so a chain may be cut short or
+  // counted with a version that is being reclaimed
+  auto tile_group_count = gcbench_table->GetTileGroupCount();
+  for (size_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = gcbench_table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) continue;
+    auto header = tile_group->GetHeader();
+    auto slot_count = header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+      // a newest version has no newer one
+      if (header->GetTransactionId(tuple_slot) == INVALID_TXN_ID ||
+          header->GetPrevItemPointer(tuple_slot).IsNull() == false) {
+        continue;
+      }
+
+      size_t chain_length = 1;
+      auto location = header->GetNextItemPointer(tuple_slot);
+      while (location.IsNull() == false && chain_length < max_chain_length) {
+        auto older_tile_group = manager.GetTileGroup(location.block);
+        if (older_tile_group == nullptr) break;
+        auto older_header = older_tile_group->GetHeader();
+        if (older_header->GetTransactionId(location.offset) ==
+            INVALID_TXN_ID) {
+          break;
+        }
+        chain_length++;
+        location = older_header->GetNextItemPointer(location.offset);
+      }
+
+      size_t bucket = 0;
+      while ((1UL << bucket) < chain_length &&
+             bucket + 1 < chain_length_bucket_count) {
+        bucket++;
+      }
+      chain_length_counts[bucket]++;
+      chain_count++;
+      version_count += chain_length;
+      result.max_chain_length =
+          std::max(result.max_chain_length, chain_length);
+    }
+  }
+
+  result.average_chain_length =
+      chain_count > 0 ? version_count * 1.0 / chain_count : 0;
+}
+
+void RunWorkload() {
+  size_t writer_count = state.writer_count;
+  size_t reader_count = state.reader_count;
+  size_t thread_count = GetThreadCount();
+
+  commit_counts = new PadInt[writer_count];
+  abort_counts = new PadInt[writer_count];
+  read_latencies = new stats::LatencyHistogram[reader_count];
+
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  size_t start_reclaimed_count = gc_manager.GetReclaimedVersionCount();
+  size_t start_memory_bytes = GetStorageBytes();
+
+  // writers, hot readers, then long readers
+  is_running = true;
+  std::vector<std::thread> thread_group;
+  for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+    if (thread_id < writer_count) {
+      thread_group.push_back(std::thread(RunWriter, thread_id));
+    } else if (thread_id < writer_count + reader_count) {
+      thread_group.push_back(
+          std::thread(RunReader, thread_id, thread_id - writer_count));
+    } else {
+      thread_group.push_back(std::thread(RunLongReader, thread_id));
+    }
+  }
+
+  size_t profile_round = (size_t)(state.duration / state.profile_duration);
+  size_t last_reclaimed_count = start_reclaimed_count;
+  state.profile_results.clear();
+  for (size_t round_id = 0; round_id < profile_round; ++round_id) {
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(int(state.profile_duration * 1000)));
+
+    ProfileResult result;
+    size_t reclaimed_count = gc_manager.GetReclaimedVersionCount();
+    result.reclaim_throughput =
+        (reclaimed_count - last_reclaimed_count) / state.profile_duration;
+    last_reclaimed_count = reclaimed_count;
+    result.gc_backlog = gc_manager.GetBacklog();
+    result.memory_bytes = GetStorageBytes();
+    SampleVersionChains(result, state.chain_length_counts);
+    state.profile_results.push_back(result);
+  }
+
+  is_running = false;
+
+  for (auto &thread : thread_group) {
+    thread.join();
+  }
+
+  // Aggregate the results
+  uint64_t total_commit_count = 0;
+  uint64_t total_abort_count = 0;
+  for (size_t writer_id = 0; writer_id < writer_count; writer_id++) {
+    total_commit_count += commit_counts[writer_id].data;
+    total_abort_count += abort_counts[writer_id].data;
+  }
+
+  stats::LatencyHistogram latencies;
+  for (size_t reader_id = 0; reader_id < reader_count; reader_id++) {
+    latencies.Merge(read_latencies[reader_id]);
+  }
+
+  state.update_throughput = total_commit_count * 1.0 / state.duration;
+  state.abort_rate =
+      total_commit_count > 0 ? total_abort_count * 1.0 / total_commit_count
+                             : 0;
+  state.reclaim_throughput =
+      (gc_manager.GetReclaimedVersionCount() - start_reclaimed_count) /
+      state.duration;
+  state.read_p50_latency = latencies.GetPercentile(50);
+  state.read_p99_latency = latencies.GetPercentile(99);
+  state.read_p999_latency = latencies.GetPercentile(99.9);
+  state.read_max_latency = latencies.GetMax();
+  state.memory_growth = static_cast<int64_t>(GetStorageBytes()) -
+                        static_cast<int64_t>(start_memory_bytes);
+
+  delete[] commit_counts;
+  commit_counts = nullptr;
+  delete[] abort_counts;
+  abort_counts = nullptr;
+  delete[] read_latencies;
+  read_latencies = nullptr;
+}
+
+}  // namespace gcbench
+}  // namespace benchmark
+}  // namespace peloton
@@ -1,421 +1,315 @@
-// //===----------------------------------------------------------------------===//
-// //
-// //                         Peloton
-// //
-// // logger_workload.cpp
-// //
-// // Identification: src/main/logger/logger_workload.cpp
-// //
-// // Copyright (c) 2015-16, Carnegie Mellon University Database Group
-// //
-// //===----------------------------------------------------------------------===//
-
-// #include <fts.h>
-// #include <getopt.h>
-// #include <sys/stat.h>
-// #include <unistd.h>
-// #include <string>
-// #include <thread>
-
-// #include "type/value_factory.h"
-// #include "concurrency/transaction_manager_factory.h"
-
-// #include "common/exception.h"
-// #include "common/logger.h"
-// #include "common/timer.h"
-// #include "logging/log_manager.h"
-// #include "storage/storage_manager.h"
-
-// #include "benchmark/logger/logger_workload.h"
-
-// #include "benchmark/ycsb/ycsb_configuration.h"
-// #include "benchmark/ycsb/ycsb_loader.h"
-// #include "benchmark/ycsb/ycsb_workload.h"
-
-// #include "benchmark/tpcc/tpcc_configuration.h"
-// #include "benchmark/tpcc/tpcc_loader.h"
-// #include "benchmark/tpcc/tpcc_workload.h"
-
-// #include "logging/checkpoint_manager.h"
-// #include "logging/loggers/wbl_frontend_logger.h"
-// #include "logging/logging_util.h"
-
-// //===--------------------------------------------------------------------===//
-// // GUC Variables
-// //===--------------------------------------------------------------------===//
-
-// extern peloton::CheckpointType peloton_checkpoint_mode;
-
-// namespace peloton {
-// namespace benchmark {
-// namespace logger {
-
-// //===--------------------------------------------------------------------===//
-// // PREPARE LOG FILE
-// //===--------------------------------------------------------------------===//
-
-// //===--------------------------------------------------------------------===//
-// // 1. Standby -- Bootstrap
-// // 2. Recovery -- Optional
-// // 3. Logging -- Collect data and flush when commit
-// // 4. Terminate -- Collect any remaining data and flush
-// // 5. Sleep -- Disconnect backend loggers and frontend logger from manager
-// //===--------------------------------------------------------------------===//
-
-// #define LOGGING_TESTS_DATABASE_OID 20000
-// #define LOGGING_TESTS_TABLE_OID 10000
-
-// void WriteOutput() {
-//   std::ofstream out("outputfile-log.summary");
-//   LOG_INFO("----------------------------------------------------------");
-//   LOG_INFO("%d %d %d %d %d %d", state.benchmark_type, static_cast<int>(state.logging_type),
-//            state.nvm_latency, state.pcommit_latency, state.flush_mode,
-//            state.asynchronous_mode);
-
-//   out << state.benchmark_type << " ";
-//   out << state.logging_type << " ";
-//   out << state.nvm_latency << " ";
-//   out << state.pcommit_latency << " ";
-//   out << state.flush_mode << " ";
-//   out << state.asynchronous_mode << "\n";
-//   out.flush();
-// }
-
-// std::string GetFilePath(std::string directory_path, std::string file_name) {
-//   std::string file_path = directory_path;
-
-//   // Add a trailing slash to a file path if needed
-//   if (!file_path.empty() && file_path.back() != '/') file_path += '/';
-
-//   file_path += file_name;
-
-//   return file_path;
-// }
-
-// void StartLogging(std::thread& log_thread, std::thread& checkpoint_thread) {
-//   auto& log_manager = logging::LogManager::GetInstance();
-
-//   if (peloton_checkpoint_mode != CheckpointTypeId::INVALID) {
-//     auto& checkpoint_manager =
-//         peloton::logging::CheckpointManager::GetInstance();
-
-//     // launch checkpoint thread
-//     if (!checkpoint_manager.IsInCheckpointingMode()) {
-//       // Wait for standby mode
-//       auto local_thread =
-//           std::thread(&peloton::logging::CheckpointManager::StartStandbyMode,
-//                       &checkpoint_manager);
-//       checkpoint_thread.swap(local_thread);
-//       checkpoint_manager.WaitForModeTransition(
-//           peloton::CheckpointStatus::STANDBY, true);
-
-//       // Clean up table tile state before recovery from checkpoint
-//       log_manager.PrepareRecovery();
-
-//       // Do any recovery
-//       checkpoint_manager.StartRecoveryMode();
-
-//       // Wait for standby mode
-//       checkpoint_manager.WaitForModeTransition(
-//           peloton::CheckpointStatus::DONE_RECOVERY, true);
-//     }
-
-//     // start checkpointing mode after recovery
-//     if (peloton_checkpoint_mode != CheckpointTypeId::INVALID) {
-//       if (!checkpoint_manager.IsInCheckpointingMode()) {
-//         // Now, enter CHECKPOINTING mode
-//         checkpoint_manager.SetCheckpointStatus(
-//             peloton::CheckpointStatus::CHECKPOINTING);
-//       }
-//     }
-//   }
-
-//   if (peloton_logging_mode != LoggingTypeId::INVALID) {
-//     // Launching a thread for logging
-//     if (!log_manager.IsInLoggingMode()) {
-//       // Wait for standby mode
-//       auto local_thread = std::thread(
-//           &peloton::logging::LogManager::StartStandbyMode, &log_manager);
-//       log_thread.swap(local_thread);
-//       log_manager.WaitForModeTransition(peloton::LoggingStatusType::STANDBY,
-//                                         true);
-
-//       // Clean up database tile state before recovery from checkpoint
-//       log_manager.PrepareRecovery();
-
-//       // Do any recovery
-//       log_manager.StartRecoveryMode();
-
-//       // Wait for logging mode
-//       log_manager.WaitForModeTransition(peloton::LoggingStatusType::LOGGING,
-//                                         true);
-
-//       // Done recovery
-//       log_manager.DoneRecovery();
-//     }
-//   }
-// }
-
-// int RemoveDirectory(const char* dir) {
-//   int ret = 0;
-//   FTS* ftsp = NULL;
-//   FTSENT* curr;
-
-//   // Cast needed (in C) because fts_open() takes a "char * const *", instead
-//   // of a "const char * const *", which is only allowed in C++. fts_open()
-//   // does not modify the argument.
-//   char* files[] = {(char*)dir, NULL};
-
-//   // FTS_NOCHDIR  - Avoid changing cwd, which could cause unexpected behavior
-//   //                in multithreaded programs
-//   // FTS_PHYSICAL - Don't follow symlinks. Prevents deletion of files outside
-//   //                of the specified directory
-//   // FTS_XDEV     - Don't cross filesystem boundaries
-//   ftsp = fts_open(files, FTS_NOCHDIR | FTS_PHYSICAL | FTS_XDEV, NULL);
-//   if (!ftsp) {
-//     fprintf(stderr, "%s: fts_open failed: %s\n", dir, strerror(errno));
-//     ret = -1;
-//     goto finish;
-//   }
-
-//   while ((curr = fts_read(ftsp))) {
-//     switch (curr->fts_info) {
-//       case FTS_NS:
-//       case FTS_DNR:
-//       case FTS_ERR:
-//         break;
-
-//       case FTS_DC:
-//       case FTS_DOT:
-//       case FTS_NSOK:
-//         // Not reached unless FTS_LOGICAL, FTS_SEEDOT, or FTS_NOSTAT were
-//         // passed to fts_open()
-//         break;
-
-//       case FTS_D:
-//         // Do nothing. Need depth-first search, so directories are deleted
-//         // in FTS_DP
-//         break;
-
-//       case FTS_DP:
-//       case FTS_F:
-//       case FTS_SL:
-//       case FTS_SLNONE:
-//       case FTS_DEFAULT:
-//         if (remove(curr->fts_accpath) < 0) {
-//           fprintf(stderr, "%s: Failed to remove: %s\n", curr->fts_path,
-//                   strerror(errno));
-//           ret = -1;
-//         }
-//         break;
-//     }
-//   }
-
-// finish:
-//   if (ftsp) {
-//     fts_close(ftsp);
-//   }
-
-//   return ret;
-// }
-
-// void CleanUpLogDirectory() {
-//   if (chdir(state.log_file_dir.c_str())) {
-//     LOG_ERROR("Could not change directory");
-//   }
-//   // remove wbl log file if it exists
-//   std::string wbl_directory_path =
-//       state.log_file_dir + logging::WriteBehindFrontendLogger::wbl_log_path;
-
-//   // remove wal log directory (for wal if it exists)
-//   // for now hardcode for 1 logger
-//   std::string wal_directory_path =
-//       state.log_file_dir +
-//       logging::WriteAheadFrontendLogger::wal_directory_path;
-
-//   std::string checkpoint_dir_path = state.log_file_dir + "pl_checkpoint";
-
-//   RemoveDirectory(wbl_directory_path.c_str());
-
-//   RemoveDirectory(wal_directory_path.c_str());
-// }
-
-// /**
-//  * @brief writing a simple log file
-//  */
-// bool PrepareLogFile() {
-//   // Clean up log directory
-//   CleanUpLogDirectory();
-
-//   // start a thread for logging
-//   auto& log_manager = logging::LogManager::GetInstance();
-//   log_manager.SetLogDirectoryName(state.log_file_dir);
-
-//   if (logging::LoggingUtil::IsBasedOnWriteAheadLogging(peloton_logging_mode)) {
-//     log_manager.SetLogFileName(
-//         state.log_file_dir + "/" +
-//         logging::WriteAheadFrontendLogger::wal_directory_path);
-//   } else {
-//     LOG_ERROR("currently, we do not support write behind logging.");
-//     PL_ASSERT(false);
-//   }
-
-//   UNUSED_ATTRIBUTE auto& checkpoint_manager =
-//       logging::CheckpointManager::GetInstance();
-
-//   if (log_manager.ContainsFrontendLogger() == true) {
-//     LOG_ERROR("another logging thread is running now");
-//     return false;
-//   }
-
-//   // Get an instance of the storage manager to force posix_fallocate
-//   // to be invoked before we begin benchmarking
-//   auto& storage_manager = storage::StorageManager::GetInstance();
-//   auto tmp = storage_manager.Allocate(BackendType::MM, 1024);
-//   storage_manager.Release(BackendType::MM, tmp);
-
-//   // Pick sync commit mode
-//   switch (state.asynchronous_mode) {
-//     case ASYNCHRONOUS_TYPE_SYNC:
-//       log_manager.SetSyncCommit(true);
-//       break;
-
-//     case ASYNCHRONOUS_TYPE_ASYNC:
-//       log_manager.SetSyncCommit(false);
-//       break;
-
-//     case ASYNCHRONOUS_TYPE_DISABLED:
-//       // No logging
-//       peloton_logging_mode = LoggingTypeId::INVALID;
-//       break;
-//     case ASYNCHRONOUS_TYPE_NO_WRITE:
-//       log_manager.SetNoWrite(true);
-//       break;
-
-//     case ASYNCHRONOUS_TYPE_INVALID:
-//       throw Exception("Invalid asynchronous mode : " +
-//                       std::to_string(state.asynchronous_mode));
-//   }
-
-//   std::thread logging_thread;
-//   std::thread checkpoint_thread;
-
-//   // Initializing logging module
-//   StartLogging(logging_thread, checkpoint_thread);
-
-//   // Build the log
-//   BuildLog();
-
-//   // Stop frontend logger if in a valid logging mode
-//   if (peloton_checkpoint_mode != CheckpointTypeId::INVALID) {
-//     //  Wait for the mode transition :: LOGGING -> TERMINATE -> SLEEP
-//     checkpoint_manager.SetCheckpointStatus(CheckpointStatus::INVALID);
-//     checkpoint_manager.WaitForModeTransition(CheckpointStatus::INVALID, true);
-//     checkpoint_thread.join();
-//   }
-//   // Stop frontend logger if in a valid logging mode
-//   if (peloton_logging_mode != LoggingTypeId::INVALID) {
-//     //  Wait for the mode transition :: LOGGING -> TERMINATE -> SLEEP
-//     if (log_manager.EndLogging()) {
-//       logging_thread.join();
-//     }
-//   }
-
-//   if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
-//     ycsb::WriteOutput();
-//   } else if (state.benchmark_type == BENCHMARK_TYPE_TPCC) {
-//     tpcc::WriteOutput();
-//   }
-
-//   return true;
-// }
-
-// //===--------------------------------------------------------------------===//
-// // CHECK RECOVERY
-// //===--------------------------------------------------------------------===//
-
-// void ResetSystem() {
-//   auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-//   txn_manager.ResetStates();
-
-//   // Reset database (only needed for WAL not WBL)
-//   if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
-//     ycsb::CreateYCSBDatabase();
-//   } else if (state.benchmark_type == BENCHMARK_TYPE_TPCC) {
-//     tpcc::CreateTPCCDatabase();
-//   }
-// }
-
-// /**
-//  * @brief recover the database and check the tuples
-//  */
-// void DoRecovery() {
-//   //===--------------------------------------------------------------------===//
-//   // RECOVERY
-//   //===--------------------------------------------------------------------===//
-
-//   // Reset log manager state
-//   auto& log_manager = peloton::logging::LogManager::GetInstance();
-//   log_manager.ResetLogStatus();
-//   log_manager.ResetFrontendLoggers();
-
-//   Timer<std::milli> timer;
-//   std::thread thread;
-//   std::thread cp_thread;
-
-//   timer.Start();
-
-//   // Do recovery
-//   StartLogging(thread, cp_thread);
-
-//   timer.Stop();
-
-//   // Synchronize and finish recovery
-//   if (peloton_logging_mode != LoggingTypeId::INVALID) {
-//     if (log_manager.EndLogging()) {
-//       thread.join();
-//     } else {
-//       LOG_ERROR("Failed to terminate logging thread");
-//     }
-//   }
-//   auto& checkpoint_manager = logging::CheckpointManager::GetInstance();
-//   // Synchronize and finish recovery
-//   if (peloton_checkpoint_mode != CheckpointTypeId::INVALID) {
-//     checkpoint_manager.SetCheckpointStatus(CheckpointStatus::INVALID);
-//     checkpoint_manager.WaitForModeTransition(CheckpointStatus::INVALID, true);
-//     cp_thread.join();
-//   }
-
-//   if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
-//     ycsb::WriteOutput();
-//   } else if (state.benchmark_type == BENCHMARK_TYPE_TPCC) {
-//     tpcc::WriteOutput();
-//   }
-
-//   // Recovery time (in ms)
-//   LOG_INFO("recovery time: %lf", timer.GetDuration());
-// }
-
-// //===--------------------------------------------------------------------===//
-// // WRITING LOG RECORD
-// //===--------------------------------------------------------------------===//
-
-// void BuildLog() {
-//   if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
-//     ycsb::CreateYCSBDatabase();
-
-//     ycsb::LoadYCSBDatabase();
-
-//     ycsb::RunWorkload();
-//   } else if (state.benchmark_type == BENCHMARK_TYPE_TPCC) {
-//     tpcc::CreateTPCCDatabase();
-
-//     tpcc::LoadTPCCDatabase();
-
-//     tpcc::RunWorkload();
-//   }
-// }
-
-// }  // namespace logger
-// }  // namespace benchmark
-// }  // namespace peloton
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logger_workload.cpp
+//
+// Identification: src/main/logger/logger_workload.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "common/logger.h"
+#include "common/timer.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/partitioned_transaction_manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "gc/gc_manager_factory.h"
+#include "logging/group_commit_manager.h"
+#include "logging/log_manager_factory.h"
+#include "util/file_util.h"
+
+#include "benchmark/logger/logger_workload.h"
+
+#include "benchmark/ycsb/ycsb_configuration.h"
+#include "benchmark/ycsb/ycsb_loader.h"
+#include "benchmark/ycsb/ycsb_workload.h"
+
+#include "benchmark/tpcc/tpcc_configuration.h"
+#include "benchmark/tpcc/tpcc_loader.h"
+#include "benchmark/tpcc/tpcc_workload.h"
+
+namespace peloton {
+namespace benchmark {
+namespace logger {
+
+//===--------------------------------------------------------------------===//
+// 1. Load -- the benchmark is loaded with logging off
+// 2. Logging -- the workload runs, and group commit acknowledges the
+//    transactions once their epoch is persisted
+// 3. Drain -- the acknowledgements still pending are waited for
+// 4. Collect -- the stats of the loggers and of the log device
+//===--------------------------------------------------------------------===//
+
+// Milliseconds the log device of the path was busy for, from the block
+// device stats. false if the path is not on a block device.
+static bool GetDeviceBusyTime(const std::string &path, uint64_t &busy_time) {
+  struct stat path_stat;
+  if (stat(path.c_str(), &path_stat) != 0) {
+    return false;
+  }
+
+  std::ifstream device_stat("/sys/dev/block/" +
+                            std::to_string(major(path_stat.st_dev)) + ":" +
+                            std::to_string(minor(path_stat.st_dev)) + "/stat");
+  if (device_stat.is_open() == false) {
+    return false;
+  }
+
+  // io_ticks is the tenth field
+  uint64_t field = 0;
+  for (int field_itr = 0; field_itr < 10; field_itr++) {
+    if (!(device_stat >> field)) {
+      return false;
+    }
+  }
+  busy_time = field;
+  return true;
+}
+
+// Configure the transactions as the benchmark does, for the backend count
+static void ConfigureBenchmark(const int backend_count) {
+  bool gc_mode;
+  int gc_backend_count;
+  EpochType epoch;
+  ProtocolType protocol;
+  if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
+    ycsb::state.backend_count = backend_count;
+    gc_mode = ycsb::state.gc_mode;
+    gc_backend_count = ycsb::state.gc_backend_count;
+    epoch = ycsb::state.epoch;
+    protocol = ycsb::state.protocol;
+  } else {
+    tpcc::state.backend_count = backend_count;
+    gc_mode = tpcc::state.gc_mode;
+    gc_backend_count = tpcc::state.gc_backend_count;
+    epoch = tpcc::state.epoch;
+    protocol = tpcc::state.protocol;
+  }
+
+  if (gc_mode == false) {
+    gc::GCManagerFactory::Configure(0);
+  } else {
+    gc::GCManagerFactory::Configure(gc_backend_count);
+  }
+
+  concurrency::EpochManagerFactory::Configure(epoch);
+
+  concurrency::TransactionManagerFactory::Configure(protocol);
+
+  // one partition per warehouse
+  if (protocol == ProtocolType::PARTITIONED) {
+    static_cast<concurrency::PartitionedTransactionManager &>(
+        concurrency::TransactionManagerFactory::GetInstance())
+        .SetPartitionCount(tpcc::state.warehouse_count);
+  }
+}
+
+bool RunLogging(const int backend_count, const int logger_count,
+                const int epoch_length, const std::string &run_log_dir,
+                RunResult &result) {
+  // the epoch thread, the loggers and group commit all use it
+  EPOCH_LENGTH = epoch_length;
+
+  ConfigureBenchmark(backend_count);
+
+  std::unique_ptr<std::thread> epoch_thread;
+  std::vector<std::unique_ptr<std::thread>> gc_threads;
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  if (concurrency::EpochManagerFactory::GetEpochType() ==
+      EpochType::DECENTRALIZED_EPOCH) {
+    for (size_t i = 0; i < (size_t)backend_count; ++i) {
+      // register thread to epoch manager
+      epoch_manager.RegisterThread(i);
+    }
+  }
+
+  // start epoch.
+  epoch_manager.StartEpoch(epoch_thread);
+
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+
+  // start GC.
+  gc_manager.StartGC(gc_threads);
+
+  // the load is not logged
+  if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
+    ycsb::CreateYCSBDatabase();
+    ycsb::LoadYCSBDatabase();
+  } else {
+    tpcc::CreateTPCCDatabase();
+    tpcc::LoadTPCCDatabase();
+  }
+
+  logging::LogManagerFactory::Configure(logger_count, run_log_dir,
+                                        state.backend_type);
+  auto &log_manager = logging::LogicalLogManager::GetInstance();
+  log_manager.StartLogging();
+
+  bool is_logging = log_manager.GetStatus();
+  if (is_logging == false) {
+    LOG_ERROR("Cannot start logging to %s", run_log_dir.c_str());
+  } else {
+    auto &group_commit_manager = logging::GroupCommitManager::GetInstance();
+    group_commit_manager.Start();
+
+    uint64_t device_begin_time = 0;
+    bool has_device_time = GetDeviceBusyTime(run_log_dir, device_begin_time);
+
+    Timer<std::micro> timer;
+    timer.Start();
+
+    // Run the workload
+    if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
+      ycsb::RunWorkload();
+      result.throughput = ycsb::state.throughput;
+      result.abort_rate = ycsb::state.abort_rate;
+    } else {
+      tpcc::RunWorkload();
+      result.throughput = tpcc::state.throughput;
+      result.abort_rate = tpcc::state.abort_rate;
+    }
+
+    // the last commits are acknowledged by the next epochs, unless they
+    // never become durable
+    for (int epoch_itr = 0; epoch_itr < 100; epoch_itr++) {
+      if (group_commit_manager.GetPendingCommitCount() == 0) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(epoch_length));
+    }
+
+    timer.Stop();
+
+    uint64_t device_end_time = 0;
+    has_device_time = has_device_time &&
+                      GetDeviceBusyTime(run_log_dir, device_end_time);
+
+    group_commit_manager.Stop();
+    log_manager.StopLogging();
+
+    // Collect the stats
+    double run_time = timer.GetDuration();
+    auto latencies = group_commit_manager.GetCommitLatencies();
+    auto logger_stats = log_manager.GetLoggerStats();
+
+    result.backend_count = backend_count;
+    result.logger_count = logger_count;
+    result.epoch_length = epoch_length;
+
+    result.latency_average = latencies.GetAverage() / 1000;
+    result.latency_50th = latencies.GetPercentile(50) / 1000;
+    result.latency_95th = latencies.GetPercentile(95) / 1000;
+    result.latency_99th = latencies.GetPercentile(99) / 1000;
+    result.latency_max = latencies.GetMax() / 1000.0;
+
+    if (logger_stats.flush_txn_count > 0) {
+      result.bytes_per_txn = logger_stats.flush_byte_count * 1.0 /
+                             logger_stats.flush_txn_count;
+    }
+    if (logger_stats.flush_count > 0) {
+      result.flush_bytes =
+          logger_stats.flush_byte_count * 1.0 / logger_stats.flush_count;
+      result.flush_buffers =
+          logger_stats.flush_buffer_count * 1.0 / logger_stats.flush_count;
+    }
+    result.max_flush_bytes = logger_stats.max_flush_byte_count;
+    result.flush_rate = logger_stats.flush_count * 1000000.0 / run_time;
+    result.logger_utilization =
+        logger_stats.flush_time / (run_time * logger_count);
+
+    if (has_device_time == true) {
+      result.device_utilization =
+          (device_end_time - device_begin_time) * 1000.0 / run_time;
+    }
+  }
+
+  // stop GC.
+  gc_manager.StopGC();
+
+  // stop epoch.
+  epoch_manager.StopEpoch();
+
+  // join all gc threads
+  for (auto &gc_thread : gc_threads) {
+    PL_ASSERT(gc_thread != nullptr);
+    gc_thread->join();
+  }
+
+  // join epoch thread
+  PL_ASSERT(epoch_thread != nullptr);
+  epoch_thread->join();
+
+  return is_logging;
+}
+
+bool RunSweep() {
+  // the runs append their results
+  std::ofstream out(state.output_file, std::ofstream::trunc);
+  out.close();
+
+  bool is_successful = true;
+  size_t run_id = 0;
+  for (auto backend_count : state.backend_counts) {
+    for (auto logger_count : state.logger_counts) {
+      for (auto epoch_length : state.epoch_lengths) {
+        std::string run_log_dir =
+            state.log_dir + "/logger_run_" + std::to_string(run_id++);
+        FileUtil::RemoveDirectory(run_log_dir);
+        if (mkdir(run_log_dir.c_str(), S_IRWXU) != 0) {
+          LOG_ERROR("Cannot create log directory %s", run_log_dir.c_str());
+          return false;
+        }
+
+        LOG_INFO("Run with %d backends, %d loggers, epochs of %d ms",
+                 backend_count, logger_count, epoch_length);
+
+        // a process per run, so the database, the catalog and the
+        // singletons start afresh
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+          RunResult result;
+          bool is_logging = RunLogging(backend_count, logger_count,
+                                       epoch_length, run_log_dir, result);
+          if (is_logging == true) {
+            WriteOutput(result);
+          }
+          fflush(stdout);
+
+          // the singletons are not torn down
+          _exit(is_logging == true ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        int status = 0;
+        if (pid < 0 || waitpid(pid, &status, 0) != pid ||
+            WIFEXITED(status) == false ||
+            WEXITSTATUS(status) != EXIT_SUCCESS) {
+          LOG_ERROR("Run with %d backends, %d loggers, epochs of %d ms failed",
+                    backend_count, logger_count, epoch_length);
+          is_successful = false;
+        }
+
+        FileUtil::RemoveDirectory(run_log_dir);
+      }
+    }
+  }
+
+  return is_successful;
+}
+
+}  // namespace logger
+}  // namespace benchmark
+}  // namespace peloton
@@ -11,10 +11,16 @@
 //===----------------------------------------------------------------------===//
 
 #include <iostream>
+#include <thread>
 
+#include "catalog/shard_map.h"
 #include "configuration/configuration.h"
 #include "common/init.h"
 #include "common/logger.h"
+#include "networking/logging_service.h"
+#include "networking/network_address.h"
+#include "networking/rpc_server.h"
+#include "networking/shard_service.h"
 #include "wire/libevent_server.h"
 
 // Peloton process begins execution here.
@@ -35,10 +41,35 @@ int main(int argc, char *argv[]) {
     peloton::configuration::PrintConfiguration();
   }
 
+  auto &shard_map = peloton::catalog::ShardMap::GetInstance();
+  if (shard_map.Configure(FLAGS_shard_nodes, FLAGS_shard_node_id,
+                          FLAGS_shard_tables) == false) {
+    return 1;
+  }
+
   try {
     // Setup
     peloton::PelotonInit::Initialize();
 
+    // The replication server receives the shipped log on a replica, and the
+    // answers of the replicas on their primary. It also executes the
+    // statements other shard nodes send. It serves until the process exits.
+    if (FLAGS_replication_port > 0 || shard_map.IsEnabled()) {
+      auto port = FLAGS_replication_port;
+      if (port == 0) {
+        port = peloton::networking::NetworkAddress(
+                   shard_map.GetNodeAddress(shard_map.GetNodeId()))
+                   .GetPort();
+      }
+      static peloton::networking::LoggingService logging_service;
+      static peloton::networking::ShardService shard_service;
+      auto rpc_server = new peloton::networking::RpcServer(port);
+      rpc_server->RegisterService(&logging_service);
+      rpc_server->RegisterService(&shard_service);
+      std::thread(&peloton::networking::RpcServer::Start, rpc_server)
+          .detach();
+    }
+
     // Create LibeventServer object
     peloton::wire::LibeventServer libeventserver;
     
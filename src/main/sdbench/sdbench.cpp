@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
@@ -38,9 +39,23 @@ void RunBenchmark() {
 
   epoch_manager.RegisterThread(0);
 
+  // The hybrid workload runs up to all writers and readers at once
+  if (state.hybrid) {
+    int max_reader_count = 0;
+    for (auto reader_count : state.reader_counts) {
+      max_reader_count = std::max(max_reader_count, reader_count);
+    }
+    for (int i = 1; i < state.writer_count + max_reader_count; i++) {
+      epoch_manager.RegisterThread(i);
+    }
+  }
+
   epoch_manager.StartEpoch(epoch_thread);
 
-  if (state.multi_stage) {
+  if (state.hybrid) {
+    // Run OLTP writers and OLAP readers concurrently
+    RunHybridBenchmark();
+  } else if (state.multi_stage) {
     // Run holistic indexing comparison benchmark
     RunMultiStageBenchmark();
   } else {
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <cstring>
 #include <iomanip>
 
 #include "benchmark/sdbench/sdbench_configuration.h"
@@ -49,7 +50,15 @@ void Usage() {
       "   -w --write_ratio                    :  Fraction of writes\n"
       "   -x --index_count_threshold          :  Index count threshold\n"
       "   -y --index_utility_threshold        :  Index utility threshold\n"
-      "   -z --write_ratio_threshold          :  Write ratio threshold\n");
+      "   -z --write_ratio_threshold          :  Write ratio threshold\n"
+      "   -H --hybrid                         :  Run OLTP writers and OLAP "
+      "readers together\n"
+      "   -W --writer_count                   :  # of OLTP writers (hybrid)\n"
+      "   -R --reader_counts                  :  # of OLAP readers to sweep, "
+      "e.g. 0,1,2,4\n"
+      "   -D --duration                       :  Duration of a sweep point\n"
+      "   -F --freeze                         :  Freeze cold tile groups "
+      "(hybrid)\n");
 
   exit(EXIT_FAILURE);
 }
@@ -79,6 +88,11 @@ static struct option opts[] = {
     {"write_ratio_threshold", optional_argument, NULL, 'z'},
     {"multi_stage", optional_argument, NULL, 'n'},
     {"holistic_indexing", optional_argument, NULL, 'r'},
+    {"hybrid", no_argument, NULL, 'H'},
+    {"writer_count", optional_argument, NULL, 'W'},
+    {"reader_counts", optional_argument, NULL, 'R'},
+    {"duration", optional_argument, NULL, 'D'},
+    {"freeze", no_argument, NULL, 'F'},
     {NULL, 0, NULL, 0}};
 
 void GenerateSequence(oid_t column_count) {
@@ -373,6 +387,50 @@ static void ValidateHolisticIndexing(const configuration &state) {
   LOG_INFO("holistic_indexing : %d", state.holistic_indexing);
 }
 
+static void ValidateHybrid(const configuration &state) {
+  if (state.hybrid == false) {
+    return;
+  }
+
+  if (state.writer_count < 0) {
+    LOG_ERROR("Invalid writer_count :: %d", state.writer_count);
+    exit(EXIT_FAILURE);
+  }
+
+  for (auto reader_count : state.reader_counts) {
+    if (reader_count < 0) {
+      LOG_ERROR("Invalid reader_count :: %d", reader_count);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  if (state.duration <= 0) {
+    LOG_ERROR("Invalid duration :: %.2lf", state.duration);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("hybrid : %d", state.hybrid);
+  LOG_INFO("writer_count : %d", state.writer_count);
+  LOG_INFO("reader_counts : %lu", state.reader_counts.size());
+  LOG_INFO("duration : %.2lf", state.duration);
+  LOG_INFO("freeze : %d", state.freeze);
+}
+
+// Parse a comma-separated list of counts, e.g. 0,1,2,4
+static std::vector<int> ParseCounts(const char *counts) {
+  std::vector<int> parsed;
+  const char *p = counts;
+  while (true) {
+    parsed.push_back(atoi(p));
+    p = strchr(p, ',');
+    if (p == nullptr) {
+      break;
+    }
+    p++;
+  }
+  return parsed;
+}
+
 void ParseArguments(int argc, char *argv[], configuration &state) {
   state.verbose = false;
 
@@ -420,17 +478,25 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   state.holistic_indexing = false;
   state.multi_stage_idx = 0;
 
+  // Hybrid parameters
+  state.hybrid = false;
+  state.writer_count = 4;
+  state.reader_counts = {0, 1, 2, 4};
+  state.duration = 10;
+  state.freeze = false;
+
   // Parse args
   while (1) {
     int idx = 0;
     int c = getopt_long(argc, argv,
-                        "a:b:c:d:e:f:g:hi:j:k:l:m:n:o:p:q:r:s:t:u:v:w:x:y:z:",
+                        "a:b:c:d:e:f:g:hi:j:k:l:m:n:o:p:q:r:s:t:u:v:w:x:y:z:"
+                        "HW:R:D:F",
                         opts, &idx);
 
     if (c == -1) break;
 
     switch (c) {
-      // AVAILABLE FLAGS: rABCDEFGHIJKLMNOPQRSTUVWXYZ
+      // AVAILABLE FLAGS: ABCEGIJKLMNOPQSTUVXYZ
       case 'a':
         state.attribute_count = atoi(optarg);
         break;
@@ -509,6 +575,21 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'z':
         state.write_ratio_threshold = atof(optarg);
         break;
+      case 'H':
+        state.hybrid = true;
+        break;
+      case 'W':
+        state.writer_count = atoi(optarg);
+        break;
+      case 'R':
+        state.reader_counts = ParseCounts(optarg);
+        break;
+      case 'D':
+        state.duration = atof(optarg);
+        break;
+      case 'F':
+        state.freeze = true;
+        break;
 
       default:
         LOG_ERROR("Unknown option: -%c-", c);
@@ -558,6 +639,7 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   ValidateVariabilityThreshold(state);
   ValidateMultiStage(state);
   ValidateHolisticIndexing(state);
+  ValidateHybrid(state);
 }
 
 }  // namespace sdbench
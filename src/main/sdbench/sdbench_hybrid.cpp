@@ -0,0 +1,524 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// sdbench_hybrid.cpp
+//
+// Identification: src/main/sdbench/sdbench_hybrid.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark_common.h"
+#include "benchmark/sdbench/sdbench_loader.h"
+#include "benchmark/sdbench/sdbench_workload.h"
+
+#include "brain/sample.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/aggregate_executor.h"
+#include "executor/executor_context.h"
+#include "executor/hybrid_scan_executor.h"
+#include "executor/index_scan_executor.h"
+#include "executor/insert_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/update_executor.h"
+#include "expression/expression_util.h"
+#include "planner/aggregate_plan.h"
+#include "planner/index_scan_plan.h"
+#include "planner/insert_plan.h"
+#include "planner/update_plan.h"
+#include "statistics/latency_histogram.h"
+#include "storage/data_table.h"
+#include "storage/tile_group_freezer.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace benchmark {
+namespace sdbench {
+
+// Writers run a mix of new order and payment like transactions over the
+// sdbench table, looking tuples up by the primary key. Readers run TPC-H
+// like scans with aggregates over the same table, in read-only snapshot
+// transactions, while the tuners adapt the indexes and the layout.
+
+// Range of the # of tuples a new order inserts and updates
+static const int new_order_min_count = 5;
+static const int new_order_max_count = 15;
+
+// # of tuples a payment updates
+static const int payment_count = 3;
+
+static volatile bool is_running = true;
+
+// Key of the next tuple a writer inserts
+static std::atomic<int> next_key;
+
+static PadInt *commit_counts;
+static PadInt *abort_counts;
+static PadInt *query_counts;
+
+static stats::LatencyHistogram *txn_latencies;
+static stats::LatencyHistogram *query_latencies;
+
+// Results of one sweep point
+struct HybridResult {
+  int writer_count;
+  int reader_count;
+
+  // OLTP
+  double txn_throughput;
+  double abort_rate;
+  double txn_average_latency;
+  double txn_p99_latency;
+
+  // OLAP
+  double query_throughput;
+  double query_average_latency;
+  double query_p99_latency;
+};
+
+// The index scan of the tuple with the key
+static std::unique_ptr<planner::IndexScanPlan> KeyScan(int key) {
+  std::vector<oid_t> column_ids;
+  for (oid_t col_itr = 0; col_itr <= state.attribute_count; col_itr++) {
+    column_ids.push_back(col_itr);
+  }
+
+  std::vector<oid_t> key_column_ids = {0};
+  std::vector<ExpressionType> expr_types = {ExpressionType::COMPARE_EQUAL};
+  std::vector<type::Value> values = {
+      type::ValueFactory::GetIntegerValue(key).Copy()};
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  auto pkey_index =
+      sdbench_table->GetIndexWithOid(sdbench_table_pkey_index_oid);
+
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      pkey_index, key_column_ids, expr_types, values, runtime_keys);
+
+  auto predicate = nullptr;
+
+  return std::unique_ptr<planner::IndexScanPlan>(new planner::IndexScanPlan(
+      sdbench_table.get(), predicate, column_ids, index_scan_desc));
+}
+
+// Increment the last attribute of the tuple with the key
+static void UpdateTuple(executor::ExecutorContext *context, int key) {
+  auto index_scan_node = KeyScan(key);
+  executor::IndexScanExecutor index_scan_executor(index_scan_node.get(),
+                                                  context);
+
+  const oid_t update_attr = state.attribute_count;
+
+  TargetList target_list;
+  DirectMapList direct_map_list;
+  for (oid_t col_itr = 0; col_itr <= state.attribute_count; col_itr++) {
+    if (col_itr == update_attr) {
+      auto tuple_value_expression =
+          expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER,
+                                                        0, update_attr);
+      auto constant_value_expression =
+          expression::ExpressionUtil::ConstantValueFactory(
+              type::ValueFactory::GetIntegerValue(1));
+      planner::DerivedAttribute attribute{
+          expression::ExpressionUtil::OperatorFactory(
+              ExpressionType::OPERATOR_PLUS, type::TypeId::INTEGER,
+              tuple_value_expression, constant_value_expression)};
+      target_list.emplace_back(col_itr, attribute);
+    } else {
+      direct_map_list.emplace_back(col_itr,
+                                   std::pair<oid_t, oid_t>(0, col_itr));
+    }
+  }
+
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(std::move(target_list),
+                               std::move(direct_map_list)));
+  planner::UpdatePlan update_node(sdbench_table.get(),
+                                  std::move(project_info));
+
+  executor::UpdateExecutor update_executor(&update_node, context);
+  update_executor.AddChild(&index_scan_executor);
+
+  update_executor.Init();
+  while (update_executor.Execute() == true) {
+  }
+}
+
+// Insert a tuple with every attribute set to the key, as the loader does
+static void InsertTuple(executor::ExecutorContext *context, int key) {
+  const bool allocate = true;
+
+  std::unique_ptr<type::AbstractPool> pool(new type::EphemeralPool());
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(sdbench_table->GetSchema(), allocate));
+
+  auto value = type::ValueFactory::GetIntegerValue(key);
+  for (oid_t col_itr = 0; col_itr <= state.attribute_count; col_itr++) {
+    tuple->SetValue(col_itr, value, pool.get());
+  }
+
+  planner::InsertPlan insert_node(sdbench_table.get(), std::move(tuple));
+  executor::InsertExecutor insert_executor(&insert_node, context);
+  insert_executor.Execute();
+}
+
+// Run a new order (inserts and updates) or a payment (a few updates) like
+// transaction. Returns whether it committed.
+static bool RunWriterTransaction(const size_t thread_id, FastRandom &rng) {
+  const int tuple_count = state.scale_factor * state.tuples_per_tilegroup;
+  const bool is_new_order = rng.next_u32() % 2 == 0;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction(thread_id);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  int update_count = payment_count;
+  if (is_new_order == true) {
+    int count_range = new_order_max_count - new_order_min_count + 1;
+    int insert_count = new_order_min_count + rng.next_u32() % count_range;
+    update_count = new_order_min_count + rng.next_u32() % count_range;
+
+    for (int insert_itr = 0; insert_itr < insert_count; insert_itr++) {
+      InsertTuple(context.get(), next_key++);
+      if (txn->GetResult() != ResultType::SUCCESS) {
+        txn_manager.AbortTransaction(txn);
+        return false;
+      }
+    }
+  }
+
+  for (int update_itr = 0; update_itr < update_count; update_itr++) {
+    UpdateTuple(context.get(), rng.next_u32() % tuple_count);
+    if (txn->GetResult() != ResultType::SUCCESS) {
+      txn_manager.AbortTransaction(txn);
+      return false;
+    }
+  }
+
+  auto result = txn_manager.CommitTransaction(txn);
+  return result == ResultType::SUCCESS;
+}
+
+// Run an aggregate (SUM) over the projected columns of the tuples matching
+// the selectivity predicate on a random attribute, recording the samples
+// the index and layout tuners adapt to
+static void RunReaderQuery(const size_t thread_id, FastRandom &rng) {
+  oid_t predicate_attr = 1 + rng.next_u32() % state.variability_threshold;
+  std::vector<oid_t> tuple_key_attrs = {predicate_attr};
+  std::vector<oid_t> index_key_attrs = {0};
+
+  // Columns to aggregate over
+  std::vector<oid_t> column_ids;
+  column_ids.push_back(0);
+  for (oid_t col_itr = 0; col_itr < state.attribute_count; col_itr++) {
+    column_ids.push_back(sdbench_column_ids[col_itr]);
+  }
+  oid_t column_count =
+      std::max<oid_t>(1, state.projectivity * state.attribute_count);
+  column_ids.resize(column_count);
+
+  Timer<> timer;
+  timer.Start();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn =
+      txn_manager.BeginTransaction(thread_id, IsolationLevelType::READ_ONLY);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  auto hybrid_scan_node =
+      CreateHybridScanPlan(tuple_key_attrs, index_key_attrs, column_ids);
+  executor::HybridScanExecutor hybrid_scan_executor(hybrid_scan_node.get(),
+                                                    context.get());
+
+  // Plain aggregation without group by columns
+  std::vector<oid_t> group_by_columns;
+
+  DirectMapList direct_map_list;
+  oid_t tuple_idx = 1;
+  for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
+    direct_map_list.push_back({col_itr, {tuple_idx, col_itr}});
+  }
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
+    planner::AggregatePlan::AggTerm sum_column_agg(
+        ExpressionType::AGGREGATE_SUM,
+        expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                      col_itr),
+        false);
+    agg_terms.push_back(sum_column_agg);
+  }
+
+  std::unique_ptr<const expression::AbstractExpression> aggregate_predicate(
+      nullptr);
+
+  auto data_table_schema = sdbench_table->GetSchema();
+  std::vector<catalog::Column> columns;
+  for (auto column_id : column_ids) {
+    columns.push_back(data_table_schema->GetColumn(column_id));
+  }
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  planner::AggregatePlan aggregation_node(
+      std::move(proj_info), std::move(aggregate_predicate),
+      std::move(agg_terms), std::move(group_by_columns), output_table_schema,
+      AggregateType::PLAIN);
+
+  executor::AggregateExecutor aggregation_executor(&aggregation_node,
+                                                   context.get());
+  aggregation_executor.AddChild(&hybrid_scan_executor);
+
+  aggregation_executor.Init();
+  while (aggregation_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        aggregation_executor.GetOutput());
+  }
+
+  txn_manager.CommitTransaction(txn);
+
+  timer.Stop();
+  auto duration = timer.GetDuration();
+
+  // Record index sample
+  std::vector<double> index_columns_accessed(tuple_key_attrs.begin(),
+                                             tuple_key_attrs.end());
+  brain::Sample index_access_sample(index_columns_accessed, duration,
+                                    brain::SAMPLE_TYPE_ACCESS);
+  sdbench_table->RecordIndexSample(index_access_sample);
+
+  // Record layout sample
+  auto tuple_columns_accessed = tuple_key_attrs;
+  for (auto column_id : column_ids) {
+    tuple_columns_accessed.push_back(column_id);
+  }
+  brain::Sample tuple_access_bitmap(GetColumnsAccessed(tuple_columns_accessed),
+                                    duration);
+  sdbench_table->RecordLayoutSample(tuple_access_bitmap);
+
+  query_latencies[thread_id].Record(duration * 1000);
+  query_counts[thread_id].data++;
+}
+
+static void RunWriter(const size_t thread_id) {
+  FastRandom rng(generator_seed + thread_id);
+
+  while (is_running == true) {
+    Timer<std::ratio<1, 1000>> timer;
+    timer.Start();
+
+    bool committed = RunWriterTransaction(thread_id, rng);
+
+    timer.Stop();
+    if (committed == true) {
+      txn_latencies[thread_id].Record(timer.GetDuration());
+      commit_counts[thread_id].data++;
+    } else {
+      abort_counts[thread_id].data++;
+    }
+  }
+}
+
+static void RunReader(const size_t thread_id) {
+  FastRandom rng(generator_seed + thread_id);
+
+  while (is_running == true) {
+    RunReaderQuery(thread_id, rng);
+  }
+}
+
+// Run the writers and the readers together for the duration
+static HybridResult RunSweepPoint(const int writer_count,
+                                  const int reader_count) {
+  const size_t thread_count = writer_count + reader_count;
+
+  commit_counts = new PadInt[thread_count];
+  abort_counts = new PadInt[thread_count];
+  query_counts = new PadInt[thread_count];
+  txn_latencies = new stats::LatencyHistogram[thread_count];
+  query_latencies = new stats::LatencyHistogram[thread_count];
+
+  is_running = true;
+
+  // Writers take the first thread ids, readers the remaining ones
+  std::vector<std::thread> thread_group;
+  for (size_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    if (thread_itr < static_cast<size_t>(writer_count)) {
+      thread_group.push_back(std::thread(RunWriter, thread_itr));
+    } else {
+      thread_group.push_back(std::thread(RunReader, thread_itr));
+    }
+  }
+
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(int(state.duration * 1000)));
+
+  is_running = false;
+
+  for (auto &thread : thread_group) {
+    thread.join();
+  }
+
+  uint64_t commit_count = 0;
+  uint64_t abort_count = 0;
+  uint64_t query_count = 0;
+  stats::LatencyHistogram txn_latency;
+  stats::LatencyHistogram query_latency;
+  for (size_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    commit_count += commit_counts[thread_itr].data;
+    abort_count += abort_counts[thread_itr].data;
+    query_count += query_counts[thread_itr].data;
+    txn_latency.Merge(txn_latencies[thread_itr]);
+    query_latency.Merge(query_latencies[thread_itr]);
+  }
+
+  HybridResult result;
+  result.writer_count = writer_count;
+  result.reader_count = reader_count;
+  result.txn_throughput = commit_count / state.duration;
+  result.abort_rate =
+      commit_count + abort_count == 0
+          ? 0
+          : abort_count * 1.0 / (commit_count + abort_count);
+  result.txn_average_latency = txn_latency.GetAverage();
+  result.txn_p99_latency = txn_latency.GetPercentile(99);
+  result.query_throughput = query_count / state.duration;
+  result.query_average_latency = query_latency.GetAverage();
+  result.query_p99_latency = query_latency.GetPercentile(99);
+
+  delete[] commit_counts;
+  commit_counts = nullptr;
+  delete[] abort_counts;
+  abort_counts = nullptr;
+  delete[] query_counts;
+  query_counts = nullptr;
+  delete[] txn_latencies;
+  txn_latencies = nullptr;
+  delete[] query_latencies;
+  query_latencies = nullptr;
+
+  return result;
+}
+
+// Fraction of the throughput of the baseline, 0 if there is none
+static double Ratio(double throughput, double baseline) {
+  return baseline > 0 ? throughput / baseline : 0;
+}
+
+static void WriteHybridOutput(const std::vector<HybridResult> &results) {
+  // Baselines : the writers without readers, the readers without writers
+  double txn_baseline = 0;
+  for (auto &result : results) {
+    if (result.reader_count == 0) {
+      txn_baseline = result.txn_throughput;
+    }
+  }
+
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("%7s %7s %10s %7s %8s %8s %10s %8s %8s %7s %7s", "writers",
+           "readers", "txn/s", "aborts", "avg ms", "p99 ms", "query/s",
+           "avg ms", "p99 ms", "oltp", "olap");
+
+  for (auto &result : results) {
+    double query_baseline = 0;
+    for (auto &baseline : results) {
+      if (baseline.writer_count == 0 &&
+          baseline.reader_count == result.reader_count) {
+        query_baseline = baseline.query_throughput;
+      }
+    }
+
+    // Throughputs relative to running alone
+    double oltp_ratio = Ratio(result.txn_throughput, txn_baseline);
+    double olap_ratio = Ratio(result.query_throughput, query_baseline);
+
+    LOG_INFO("%7d %7d %10.1lf %7.3lf %8.3lf %8.3lf %10.2lf %8.1lf %8.1lf "
+             "%7.2lf %7.2lf",
+             result.writer_count, result.reader_count, result.txn_throughput,
+             result.abort_rate, result.txn_average_latency,
+             result.txn_p99_latency, result.query_throughput,
+             result.query_average_latency, result.query_p99_latency,
+             oltp_ratio, olap_ratio);
+
+    out << result.writer_count << " ";
+    out << result.reader_count << " ";
+    out << result.txn_throughput << " ";
+    out << result.abort_rate << " ";
+    out << result.txn_average_latency << " ";
+    out << result.txn_p99_latency << " ";
+    out << result.query_throughput << " ";
+    out << result.query_average_latency << " ";
+    out << result.query_p99_latency << " ";
+    out << oltp_ratio << " ";
+    out << olap_ratio << "\n";
+  }
+
+  out.flush();
+}
+
+void RunHybridBenchmark() {
+  BenchmarkPrepare();
+
+  auto &freezer = storage::TileGroupFreezer::GetInstance();
+  if (state.freeze == true) {
+    freezer.AddTable(sdbench_table.get());
+    freezer.Start();
+  }
+
+  next_key = state.scale_factor * state.tuples_per_tilegroup;
+
+  // Every reader count with the writers, then without them for the
+  // readers' baseline
+  std::vector<std::pair<int, int>> sweep_points;
+  for (auto reader_count : state.reader_counts) {
+    sweep_points.emplace_back(state.writer_count, reader_count);
+  }
+  if (state.writer_count > 0) {
+    for (auto reader_count : state.reader_counts) {
+      if (reader_count > 0) {
+        sweep_points.emplace_back(0, reader_count);
+      }
+    }
+  }
+
+  std::vector<HybridResult> results;
+  for (auto &sweep_point : sweep_points) {
+    LOG_INFO("Running %d writers and %d readers", sweep_point.first,
+             sweep_point.second);
+    results.push_back(RunSweepPoint(sweep_point.first, sweep_point.second));
+  }
+
+  WriteHybridOutput(results);
+
+  if (state.freeze == true) {
+    freezer.Stop();
+    freezer.ClearTables();
+  }
+
+  BenchmarkCleanUp();
+}
+
+}  // namespace sdbench
+}  // namespace benchmark
+}  // namespace peloton
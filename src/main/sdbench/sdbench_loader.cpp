@@ -73,6 +73,32 @@ void CreateTable() {
   sdbench_table.reset(storage::TableFactory::GetDataTable(
       INVALID_OID, INVALID_OID, table_schema, table_name,
       state.tuples_per_tilegroup, own_schema, adapt_table));
+
+  // The writers of the hybrid workload look up tuples by key
+  if (state.hybrid == true) {
+    CreatePrimaryIndex();
+  }
+}
+
+void CreatePrimaryIndex() {
+  // Primary index on column 0, which is loaded with the row id
+  std::vector<oid_t> key_attrs = {0};
+
+  auto tuple_schema = sdbench_table->GetSchema();
+  catalog::Schema *key_schema =
+      catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+
+  bool unique = true;
+
+  index::IndexMetadata *index_metadata = new index::IndexMetadata(
+      "primary_index", sdbench_table_pkey_index_oid, INVALID_OID, INVALID_OID,
+      IndexType::BWTREE, IndexConstraintType::PRIMARY_KEY, tuple_schema,
+      key_schema, key_attrs, unique);
+
+  std::shared_ptr<index::Index> pkey_index(
+      index::IndexFactory::GetIndex(index_metadata));
+  sdbench_table->AddIndex(pkey_index);
 }
 
 void LoadTable() {
@@ -129,7 +155,7 @@ void CreateAndLoadTable(LayoutType layout_type) {
 
 void DropIndexes() {
   // Drop index
-  sdbench_table->DropIndexWithOid(0);
+  sdbench_table->DropIndexWithOid(sdbench_table_pkey_index_oid);
 }
 
 }  // namespace sdbench
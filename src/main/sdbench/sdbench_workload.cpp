@@ -267,7 +267,7 @@ static inline std::string GetOidVectorString(const std::vector<oid_t> &oids) {
  * @param column_ids Column ids to be added to the result tile after scan.
  * @return A hybrid scan executor based on the key columns.
  */
-static std::shared_ptr<planner::HybridScanPlan> CreateHybridScanPlan(
+std::shared_ptr<planner::HybridScanPlan> CreateHybridScanPlan(
     const std::vector<oid_t> &tuple_key_attrs,
     const std::vector<oid_t> &index_key_attrs,
     const std::vector<oid_t> &column_ids) {
@@ -349,7 +349,7 @@ UNUSED_ATTRIBUTE static void WriteOutput(double duration) {
  * @details We should use the output of this method to construct a Sample for
  * layout tuning instead of passing in the accessed columns directly!!
  */
-static std::vector<double> GetColumnsAccessed(
+std::vector<double> GetColumnsAccessed(
     const std::vector<oid_t> &column_ids) {
   std::vector<double> columns_accessed;
   std::map<oid_t, oid_t> columns_accessed_map;
@@ -13,14 +13,18 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <algorithm>
 
 #include "common/logger.h"
 #include "benchmark/tpcc/tpcc_configuration.h"
 #include "benchmark/tpcc/tpcc_loader.h"
 #include "benchmark/tpcc/tpcc_workload.h"
+#include "benchmark/memory_report.h"
 
 #include "gc/gc_manager_factory.h"
 #include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "concurrency/partitioned_transaction_manager.h"
 
 namespace peloton {
 namespace benchmark {
@@ -39,13 +43,19 @@ void RunBenchmark() {
   
   concurrency::EpochManagerFactory::Configure(state.epoch);
 
+  concurrency::TransactionManagerFactory::Configure(state.protocol);
+
   std::unique_ptr<std::thread> epoch_thread;
   std::vector<std::unique_ptr<std::thread>> gc_threads;
 
   concurrency::EpochManager &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
 
+  // the most backends of the sweep
+  size_t max_backend_count = *std::max_element(state.backend_counts.begin(),
+                                               state.backend_counts.end());
+
   if (concurrency::EpochManagerFactory::GetEpochType() == EpochType::DECENTRALIZED_EPOCH) {
-    for (size_t i = 0; i < (size_t) state.backend_count; ++i) {
+    for (size_t i = 0; i < max_backend_count; ++i) {
       // register thread to epoch manager
       epoch_manager.RegisterThread(i);
     }
@@ -59,15 +69,53 @@ void RunBenchmark() {
   // start GC.
   gc_manager.StartGC(gc_threads);
 
-  // Create the database
-  CreateTPCCDatabase();
+  // Every warehouse count is loaded into a new database, and every backend
+  // count runs on it in turn
+  bool append_output = false;
+  for (auto warehouse_count : state.warehouse_counts) {
+    state.warehouse_count = warehouse_count;
+
+    // one partition per warehouse
+    if (state.protocol == ProtocolType::PARTITIONED) {
+      static_cast<concurrency::PartitionedTransactionManager &>(
+          concurrency::TransactionManagerFactory::GetInstance())
+          .SetPartitionCount(state.warehouse_count);
+    }
 
-  // Load the database
-  LoadTPCCDatabase();
+    if (tpcc_database != nullptr) {
+      DropTPCCDatabase();
+    }
+
+    // What the earlier databases left charged is not part of this one
+    auto memory_before = stats::MemoryUsage::GetTracked();
+
+    // Create the database
+    CreateTPCCDatabase();
+
+    // Load the database
+    LoadTPCCDatabase();
+
+    if (state.memory_report == true) {
+      auto memory_after = stats::MemoryUsage::GetTracked();
+      memory_after.AddDatabase(tpcc_database);
+      std::ofstream out("outputfile.memory", append_output ? std::ios::app
+                                                          : std::ios::trunc);
+      WriteMemoryReport(out, std::to_string(state.warehouse_count),
+                        memory_before, memory_after);
+    }
+
+    for (auto backend_count : state.backend_counts) {
+      state.backend_count = backend_count;
+
+      // Run the workload
+      RunWorkload();
+
+      // Emit throughput
+      WriteOutput(append_output);
+      append_output = true;
+    }
+  }
 
-  // Run the workload
-  RunWorkload();
-  
   // stop GC.
   gc_manager.StopGC();
 
@@ -83,10 +131,6 @@ void RunBenchmark() {
   // join epoch thread
   PL_ASSERT(epoch_thread != nullptr);
   epoch_thread->join();
-
-
-  // Emit throughput
-  WriteOutput();
 }
 
 }  // namespace tpcc
@@ -30,14 +30,17 @@ void Usage(FILE *out) {
           "   -k --scale_factor      :  scale factor \n"
           "   -d --duration          :  execution duration \n"
           "   -p --profile_duration  :  profile duration \n"
-          "   -b --backend_count     :  # of backends \n"
-          "   -w --warehouse_count   :  # of warehouses \n"
-          "   -e --exp_backoff       :  enable exponential backoff \n"
+          "   -b --backend_count     :  # of backends, or a list to sweep (1,2,4) \n"
+          "   -w --warehouse_count   :  # of warehouses, or a list to sweep \n"
+          "   -e --exp_backoff       :  enable contention-aware backoff \n"
           "   -a --affinity          :  enable client affinity \n"
+          "   -c --pinning           :  backend pinning: core (default), numa or none \n"
           "   -g --gc_mode           :  enable garbage collection \n"
           "   -n --gc_backend_count  :  # of gc backends \n"
           "   -l --loader_count      :  # of loaders \n"
           "   -y --epoch             :  epoch type: centralized or decentralized \n"
+          "   -t --protocol          :  concurrency control: to (default), occ or partitioned \n"
+          "   -m --memory_report     :  report the memory per tuple of every component \n"
   );
 }
 
@@ -50,10 +53,13 @@ static struct option opts[] = {
     { "warehouse_count", optional_argument, NULL, 'w' },
     { "exp_backoff", no_argument, NULL, 'e' },
     { "affinity", no_argument, NULL, 'a' },
+    { "pinning", optional_argument, NULL, 'c' },
     { "gc_mode", no_argument, NULL, 'g' },
     { "gc_backend_count", optional_argument, NULL, 'n' },
-    { "loader_count", optional_argument, NULL, 'n' },
+    { "loader_count", optional_argument, NULL, 'l' },
     { "epoch", optional_argument, NULL, 'y' },
+    { "protocol", optional_argument, NULL, 't' },
+    { "memory_report", no_argument, NULL, 'm' },
     { NULL, 0, NULL, 0 }
 };
 
@@ -92,21 +98,56 @@ void ValidateProfileDuration(const configuration &state) {
 }
 
 void ValidateBackendCount(const configuration &state) {
-  if (state.backend_count <= 0) {
-    LOG_ERROR("Invalid backend_count :: %d", state.backend_count);
-    exit(EXIT_FAILURE);
-  }
+  for (auto backend_count : state.backend_counts) {
+    if (backend_count <= 0) {
+      LOG_ERROR("Invalid backend_count :: %d", backend_count);
+      exit(EXIT_FAILURE);
+    }
 
-  LOG_TRACE("%s : %d", "backend_count", state.backend_count);
+    LOG_TRACE("%s : %d", "backend_count", backend_count);
+  }
 }
 
 void ValidateWarehouseCount(const configuration &state) {
-  if (state.warehouse_count <= 0) {
-    LOG_ERROR("Invalid warehouse_count :: %d", state.warehouse_count);
-    exit(EXIT_FAILURE);
+  for (auto warehouse_count : state.warehouse_counts) {
+    if (warehouse_count <= 0) {
+      LOG_ERROR("Invalid warehouse_count :: %d", warehouse_count);
+      exit(EXIT_FAILURE);
+    }
+
+    LOG_TRACE("%s : %d", "warehouse_count", warehouse_count);
   }
+}
 
-  LOG_TRACE("%s : %d", "warehouse_count", state.warehouse_count);
+// Parse a count, or a comma separated list of counts
+static std::vector<int> ParseCounts(const char *counts) {
+  std::vector<int> parsed;
+  const char *p = counts;
+  while (true) {
+    parsed.push_back(atoi(p));
+    p = strchr(p, ',');
+    if (p == nullptr) {
+      break;
+    }
+    p++;
+  }
+  return parsed;
+}
+
+std::string TransactionTypeToString(const TransactionType type) {
+  switch (type) {
+    case TransactionType::NEW_ORDER:
+      return "new_order";
+    case TransactionType::PAYMENT:
+      return "payment";
+    case TransactionType::DELIVERY:
+      return "delivery";
+    case TransactionType::ORDER_STATUS:
+      return "order_status";
+    case TransactionType::STOCK_LEVEL:
+      return "stock_level";
+  }
+  return "invalid";
 }
 
 void ValidateGCBackendCount(const configuration &state) {
@@ -123,22 +164,25 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   // Default Values
   state.index = IndexType::BWTREE;
   state.epoch = EpochType::DECENTRALIZED_EPOCH;
+  state.protocol = ProtocolType::TIMESTAMP_ORDERING;
   state.scale_factor = 1;
   state.duration = 10;
   state.profile_duration = 1;
-  state.backend_count = 2;
-  state.warehouse_count = 2;
+  state.backend_counts = {2};
+  state.warehouse_counts = {2};
   state.exp_backoff = false;
   state.affinity = false;
+  state.pinning = PinningType::CORE;
   state.gc_mode = false;
   state.gc_backend_count = 1;
   state.loader_count = 1;
+  state.memory_report = false;
 
 
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "heagi:k:d:p:b:w:n:l:y:", opts, &idx);
+    int c = getopt_long(argc, argv, "heagmi:k:d:p:b:w:n:l:y:t:c:", opts, &idx);
 
     if (c == -1) break;
 
@@ -163,6 +207,20 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
         }
         break;
       }
+      case 't': {
+        char *protocol = optarg;
+        if (strcmp(protocol, "to") == 0) {
+          state.protocol = ProtocolType::TIMESTAMP_ORDERING;
+        } else if (strcmp(protocol, "occ") == 0) {
+          state.protocol = ProtocolType::OPTIMISTIC;
+        } else if (strcmp(protocol, "partitioned") == 0) {
+          state.protocol = ProtocolType::PARTITIONED;
+        } else {
+          LOG_ERROR("Unknown protocol: %s", protocol);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
       case 'l':
         state.loader_count = atoi(optarg);
         break;
@@ -176,11 +234,25 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
         state.profile_duration = atof(optarg);
         break;
       case 'b':
-        state.backend_count = atoi(optarg);
+        state.backend_counts = ParseCounts(optarg);
         break;
       case 'w':
-        state.warehouse_count = atoi(optarg);
+        state.warehouse_counts = ParseCounts(optarg);
+        break;
+      case 'c': {
+        char *pinning = optarg;
+        if (strcmp(pinning, "core") == 0) {
+          state.pinning = PinningType::CORE;
+        } else if (strcmp(pinning, "numa") == 0) {
+          state.pinning = PinningType::NUMA;
+        } else if (strcmp(pinning, "none") == 0) {
+          state.pinning = PinningType::NONE;
+        } else {
+          LOG_ERROR("Unknown pinning: %s", pinning);
+          exit(EXIT_FAILURE);
+        }
         break;
+      }
       case 'e':
         state.exp_backoff = true;
         break;
@@ -190,6 +262,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'g':
         state.gc_mode = true;
         break;
+      case 'm':
+        state.memory_report = true;
+        break;
       case 'n':
         state.gc_backend_count = atoi(optarg);
         break;
@@ -206,6 +281,10 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
     }
   }
 
+  // The first point of the sweep
+  state.backend_count = state.backend_counts.front();
+  state.warehouse_count = state.warehouse_counts.front();
+
   // Static TPCC parameters
   state.item_count = 100000 * state.scale_factor;
   state.districts_per_warehouse = 10;
@@ -224,12 +303,14 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   LOG_TRACE("%s : %d", "Run client affinity", state.affinity);
   LOG_TRACE("%s : %d", "Run exponential backoff", state.exp_backoff);
   LOG_TRACE("%s : %d", "Run garbage collection", state.gc_mode);
+  LOG_TRACE("%s : %d", "Backend pinning", static_cast<int>(state.pinning));
 }
 
 
 
-void WriteOutput() {
-  std::ofstream out("outputfile.summary");
+void WriteOutput(bool append) {
+  std::ofstream out("outputfile.summary",
+                    append ? std::ios::app : std::ios::trunc);
 
   oid_t total_profile_memory = 0;
   for (auto &entry : state.profile_memory) {
@@ -259,7 +340,31 @@ void WriteOutput() {
         << std::left << state.profile_duration * (round_id + 1)
         << " s]: " << state.profile_throughput[round_id] << " "
         << state.profile_abort_rate[round_id] << " "
-        << state.profile_memory[round_id] << "\n";
+        << state.profile_memory[round_id] << " "
+        << state.profile_conflict_abort_rate[round_id] << " "
+        << state.profile_validation_abort_rate[round_id];
+    for (auto throughput : state.profile_transaction_throughput[round_id]) {
+      out << " " << throughput;
+    }
+    out << "\n";
+  }
+
+  // throughput, latencies (ms) and abort rates by cause of every type
+  LOG_INFO("%-14s %12s %9s %9s %9s %9s %9s %9s", "transaction", "txn/s",
+           "avg ms", "p50 ms", "p95 ms", "p99 ms", "conflict", "validation");
+  for (size_t type_id = 0; type_id < transaction_type_count; type_id++) {
+    auto name =
+        TransactionTypeToString(static_cast<TransactionType>(type_id));
+    auto &result = state.transaction_results[type_id];
+    LOG_INFO("%-14s %12.1lf %9.3lf %9.3lf %9.3lf %9.3lf %9.4lf %9.4lf",
+             name.c_str(), result.throughput, result.average_latency,
+             result.p50_latency, result.p95_latency, result.p99_latency,
+             result.conflict_abort_rate, result.validation_abort_rate);
+
+    out << name << " " << result.throughput << " " << result.average_latency
+        << " " << result.p50_latency << " " << result.p95_latency << " "
+        << result.p99_latency << " " << result.conflict_abort_rate << " "
+        << result.validation_abort_rate << "\n";
   }
   out.flush();
   out.close();
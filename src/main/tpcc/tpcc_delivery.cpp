@@ -117,7 +117,7 @@ bool RunDelivery(const size_t &thread_id){
 
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   
-  auto txn = txn_manager.BeginTransaction(thread_id);
+  auto txn = BeginWarehouseTransaction(thread_id, {warehouse_id});
 
   std::unique_ptr<executor::ExecutorContext> context(
     new executor::ExecutorContext(txn));
@@ -506,7 +506,10 @@ bool RunDelivery(const size_t &thread_id){
 
   assert(txn->GetResult() == ResultType::SUCCESS);
 
-  auto result = txn_manager.CommitTransaction(txn);
+  // acknowledged once durable when group commit runs, see the logger
+  // benchmark
+  auto result =
+      txn_manager.GroupCommitTransaction(txn, [](const ResultType) {});
 
   if (result == ResultType::SUCCESS) {
     LOG_TRACE("commit successfully");
@@ -514,6 +517,7 @@ bool RunDelivery(const size_t &thread_id){
   } else {
     assert(result == ResultType::ABORTED || 
            result == ResultType::FAILURE);
+    RecordValidationAbort(thread_id);
     return false;
   }
 }
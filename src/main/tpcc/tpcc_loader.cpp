@@ -38,6 +38,7 @@
 #include "storage/data_table.h"
 #include "storage/table_factory.h"
 #include "storage/database.h"
+#include "type/ephemeral_pool.h"
 #include "type/types.h"
 
 
@@ -996,6 +997,25 @@ void CreateTPCCDatabase() {
   CreateOrderLineTable();
 }
 
+void DropTPCCDatabase() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithOid(tpcc_database_oid, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The storage manager deleted the database with its tables
+  tpcc_database = nullptr;
+  warehouse_table = nullptr;
+  district_table = nullptr;
+  item_table = nullptr;
+  customer_table = nullptr;
+  history_table = nullptr;
+  stock_table = nullptr;
+  orders_table = nullptr;
+  new_order_table = nullptr;
+  order_line_table = nullptr;
+}
+
 /////////////////////////////////////////////////////////
 // Load in the tables
 /////////////////////////////////////////////////////////
@@ -1559,14 +1579,15 @@ void LoadItems() {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
   std::unique_ptr<type::AbstractPool> pool(new type::EphemeralPool());
-  std::unique_ptr<executor::ExecutorContext> context(
-      new executor::ExecutorContext(txn));
 
+  std::vector<std::unique_ptr<storage::Tuple>> item_tuples;
   for (auto item_itr = 0; item_itr < state.item_count; item_itr++) {
-    auto item_tuple = BuildItemTuple(item_itr, pool);
-    planner::InsertPlan node(item_table, std::move(item_tuple));
-    executor::InsertExecutor executor(&node, context.get());
-    executor.Execute();
+    item_tuples.push_back(BuildItemTuple(item_itr, pool));
+  }
+
+  if (item_table->BulkInsert(item_tuples, txn) == false) {
+    txn_manager.AbortTransaction(txn);
+    return;
   }
 
   txn_manager.CommitTransaction(txn);
@@ -1686,16 +1707,17 @@ void LoadWarehouses(const int &warehouse_from, const int &warehouse_to) {
     }  // END DISTRICTS
 
     // STOCK
-    for (auto stock_itr = 0; stock_itr < state.item_count; stock_itr++) {
-      auto txn = txn_manager.BeginTransaction();
-      context.reset(new executor::ExecutorContext(txn));
+    txn = txn_manager.BeginTransaction();
 
-      int s_w_id = warehouse_itr;
-      auto stock_tuple = BuildStockTuple(stock_itr, s_w_id, pool);
-      planner::InsertPlan stock_node(stock_table, std::move(stock_tuple));
-      executor::InsertExecutor stock_executor(&stock_node, context.get());
-      stock_executor.Execute();
+    int s_w_id = warehouse_itr;
+    std::vector<std::unique_ptr<storage::Tuple>> stock_tuples;
+    for (auto stock_itr = 0; stock_itr < state.item_count; stock_itr++) {
+      stock_tuples.push_back(BuildStockTuple(stock_itr, s_w_id, pool));
+    }
 
+    if (stock_table->BulkInsert(stock_tuples, txn) == false) {
+      txn_manager.AbortTransaction(txn);
+    } else {
       txn_manager.CommitTransaction(txn);
     }
 
@@ -132,7 +132,10 @@ bool RunNewOrder(const size_t &thread_id){
 
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
-  auto txn = txn_manager.BeginTransaction(thread_id);
+  // the order lines may be supplied by remote warehouses
+  std::vector<int> warehouse_ids(ol_w_ids);
+  warehouse_ids.push_back(warehouse_id);
+  auto txn = BeginWarehouseTransaction(thread_id, warehouse_ids);
 
   std::unique_ptr<executor::ExecutorContext> context(
       new executor::ExecutorContext(txn));
@@ -631,7 +634,10 @@ bool RunNewOrder(const size_t &thread_id){
   // transaction passed execution.
   PL_ASSERT(txn->GetResult() == ResultType::SUCCESS);
 
-  auto result = txn_manager.CommitTransaction(txn);
+  // acknowledged once durable when group commit runs, see the logger
+  // benchmark
+  auto result =
+      txn_manager.GroupCommitTransaction(txn, [](const ResultType) {});
 
   if (result == ResultType::SUCCESS) {
     // transaction passed commitment.
@@ -643,6 +649,7 @@ bool RunNewOrder(const size_t &thread_id){
     PL_ASSERT(result == ResultType::ABORTED ||
            result == ResultType::FAILURE);
     LOG_TRACE("abort txn, thread_id = %d, d_id = %d, next_o_id = %d", (int)thread_id, (int)district_id, (int)type::ValuePeeker::PeekInteger(d_next_o_id));
+    RecordValidationAbort(thread_id);
     return false;
   }
 }
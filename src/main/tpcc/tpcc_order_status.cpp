@@ -94,14 +94,16 @@ bool RunOrderStatus(const size_t &thread_id){
    */
 
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-  auto txn = txn_manager.BeginTransaction(thread_id);
-
-  std::unique_ptr<executor::ExecutorContext> context(
-    new executor::ExecutorContext(txn));
 
   // Generate w_id, d_id, c_id, c_last
   //int w_id = GetRandomInteger(0, state.warehouse_count - 1);
   int w_id = GenerateWarehouseId(thread_id);
+
+  auto txn = BeginWarehouseTransaction(thread_id, {w_id});
+
+  std::unique_ptr<executor::ExecutorContext> context(
+    new executor::ExecutorContext(txn));
+
   int d_id = GetRandomInteger(0, state.districts_per_warehouse - 1);
 
   int c_id = -1;
@@ -316,6 +318,7 @@ bool RunOrderStatus(const size_t &thread_id){
   if (result == ResultType::SUCCESS) {
     return true;
   } else {
+    RecordValidationAbort(thread_id);
     return false;
   }
 }
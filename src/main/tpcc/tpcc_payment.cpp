@@ -145,7 +145,8 @@ bool RunPayment(const size_t &thread_id){
 
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   
-  auto txn = txn_manager.BeginTransaction(thread_id);
+  auto txn = BeginWarehouseTransaction(
+      thread_id, {warehouse_id, customer_warehouse_id});
 
   std::unique_ptr<executor::ExecutorContext> context(
     new executor::ExecutorContext(txn));
@@ -658,13 +659,17 @@ bool RunPayment(const size_t &thread_id){
 
   PL_ASSERT(txn->GetResult() == ResultType::SUCCESS);
 
-  auto result = txn_manager.CommitTransaction(txn);
+  // acknowledged once durable when group commit runs, see the logger
+  // benchmark
+  auto result =
+      txn_manager.GroupCommitTransaction(txn, [](const ResultType) {});
 
   if (result == ResultType::SUCCESS) {
     return true;
   } else {
     PL_ASSERT(result == ResultType::ABORTED || 
            result == ResultType::FAILURE);
+    RecordValidationAbort(thread_id);
     return false;
   }
 }
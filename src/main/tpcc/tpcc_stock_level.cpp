@@ -91,13 +91,15 @@ bool RunStockLevel(const size_t &thread_id) {
      }
    */
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-  auto txn = txn_manager.BeginTransaction(thread_id);
+
+  // Prepare random data
+  int w_id = GenerateWarehouseId(thread_id);
+
+  auto txn = BeginWarehouseTransaction(thread_id, {w_id});
 
   std::unique_ptr<executor::ExecutorContext> context(
     new executor::ExecutorContext(txn));
 
-  // Prepare random data
-  int w_id = GenerateWarehouseId(thread_id);
   int d_id = GetRandomInteger(0, state.districts_per_warehouse - 1);
   int threshold = GetRandomInteger(stock_min_threshold, stock_max_threshold);
 
@@ -253,6 +255,7 @@ bool RunStockLevel(const size_t &thread_id) {
   if (result == ResultType::SUCCESS) {
     return true;
   } else {
+    RecordValidationAbort(thread_id);
     return false;
   }
 
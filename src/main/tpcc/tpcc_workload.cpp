@@ -38,9 +38,12 @@
 #include "common/logger.h"
 #include "common/timer.h"
 #include "common/generator.h"
+#include "util/numa_util.h"
 
+#include "concurrency/contention_manager.h"
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "concurrency/partitioned_transaction_manager.h"
 #include "concurrency/epoch_manager_factory.h"
 
 #include "executor/executor_context.h"
@@ -72,6 +75,8 @@
 #include "planner/order_by_plan.h"
 #include "planner/limit_plan.h"
 
+#include "statistics/latency_histogram.h"
+
 #include "storage/data_table.h"
 #include "storage/table_factory.h"
 
@@ -90,8 +95,24 @@ namespace tpcc {
 
 volatile bool is_running = true;
 
-PadInt *abort_counts;
+// Counts of every thread and transaction type, at
+// thread_id * transaction_type_count + type
 PadInt *commit_counts;
+PadInt *conflict_abort_counts;
+PadInt *validation_abort_counts;
+
+// Latencies of the committed transactions, at the same positions
+stats::LatencyHistogram *transaction_latencies;
+
+// Aborts at commit of every thread, whatever the transaction type
+PadInt *commit_abort_counts;
+
+// The counts of all threads at the end of a profile round
+struct RoundCounts {
+  uint64_t commits[transaction_type_count] = {};
+  uint64_t conflict_aborts[transaction_type_count] = {};
+  uint64_t validation_aborts[transaction_type_count] = {};
+};
 
 size_t GenerateWarehouseId(const size_t &thread_id) {
   if (state.affinity) {
@@ -109,6 +130,31 @@ size_t GenerateWarehouseId(const size_t &thread_id) {
   }
 }
 
+void RecordValidationAbort(const size_t &thread_id) {
+  commit_abort_counts[thread_id].data++;
+}
+
+concurrency::Transaction *BeginWarehouseTransaction(
+    const size_t &thread_id, const std::vector<int> &warehouse_ids) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  if (state.protocol != ProtocolType::PARTITIONED) {
+    return txn_manager.BeginTransaction(thread_id);
+  }
+
+  auto &partitioned_txn_manager =
+      static_cast<concurrency::PartitionedTransactionManager &>(txn_manager);
+
+  std::vector<size_t> partition_ids;
+  for (auto warehouse_id : warehouse_ids) {
+    partition_ids.push_back(
+        partitioned_txn_manager.GetPartitionId(warehouse_id));
+  }
+
+  return partitioned_txn_manager.BeginPartitionTransaction(thread_id,
+                                                           partition_ids);
+}
+
 #ifndef __APPLE__
 void PinToCore(size_t core) {
   cpu_set_t cpuset;
@@ -123,9 +169,61 @@ void PinToCore(size_t UNUSED_ATTRIBUTE core) {
 #endif
 }
 
+void PinBackend(size_t thread_id) {
+  switch (state.pinning) {
+    case PinningType::CORE: {
+      size_t core_count = std::max(std::thread::hardware_concurrency(), 1u);
+      PinToCore(thread_id % core_count);
+      break;
+    }
+    case PinningType::NUMA: {
+      NumaUtil::BindThreadToNode(thread_id % NumaUtil::GetNodeCount());
+      break;
+    }
+    case PinningType::NONE:
+      break;
+  }
+}
+
+// Run the transaction until it commits or the workload ends. Its aborts are
+// counted by their cause, and its latency spans all of its attempts.
+static void RunTransaction(const size_t thread_id, const TransactionType type,
+                           bool (*run)(const size_t &)) {
+  size_t count_idx =
+      thread_id * transaction_type_count + static_cast<size_t>(type);
+
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  while (true) {
+    uint64_t commit_abort_count = commit_abort_counts[thread_id].data;
+    if (run(thread_id) == true) {
+      break;
+    }
+
+    if (commit_abort_counts[thread_id].data != commit_abort_count) {
+      validation_abort_counts[count_idx].data++;
+    } else {
+      conflict_abort_counts[count_idx].data++;
+    }
+
+    if (is_running == false) {
+      return;
+    }
+    // backoff, scaled by the contention on the conflicting tile group
+    if (state.exp_backoff) {
+      concurrency::ContentionManager::GetInstance().WaitBeforeRetry();
+    }
+  }
+
+  timer.Stop();
+  transaction_latencies[count_idx].Record(timer.GetDuration());
+  commit_counts[count_idx].data++;
+}
+
 void RunBackend(const size_t thread_id) {
 
-  PinToCore(thread_id);
+  PinBackend(thread_id);
 
   if (concurrency::EpochManagerFactory::GetEpochType() == EpochType::DECENTRALIZED_EPOCH) {
     // register thread to epoch manager
@@ -133,107 +231,71 @@ void RunBackend(const size_t thread_id) {
     epoch_manager.RegisterThread(thread_id);
   }
 
-  PadInt &execution_count_ref = abort_counts[thread_id];
-  PadInt &transaction_count_ref = commit_counts[thread_id];
-  
-  // backoff
-  uint32_t backoff_shifts = 0;
-
-  while (true) {
-
-    if (is_running == false) {
-      break;
-    }
+  FastRandom rng(rand());
 
-    FastRandom rng(rand());
-    
+  while (is_running == true) {
     auto rng_val = rng.NextUniform();
     if (rng_val <= STOCK_LEVEL_RATIO) {
-      while (RunStockLevel(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
-      }
+      RunTransaction(thread_id, TransactionType::STOCK_LEVEL, RunStockLevel);
     } else if (rng_val <= ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO) {
-      while (RunOrderStatus(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
-      }
+      RunTransaction(thread_id, TransactionType::ORDER_STATUS,
+                     RunOrderStatus);
     } else if (rng_val <= PAYMENT_RATIO + ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO) {
-      while (RunPayment(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
-      }
+      RunTransaction(thread_id, TransactionType::PAYMENT, RunPayment);
     } else if (rng_val <= PAYMENT_RATIO + ORDER_STATUS_RATIO + STOCK_LEVEL_RATIO + NEW_ORDER_RATIO) {
-      while (RunNewOrder(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
-      }
+      RunTransaction(thread_id, TransactionType::NEW_ORDER, RunNewOrder);
     } else {
-      while (RunDelivery(thread_id) == false) {
-        if (is_running == false) {
-          break;
-        }
-        execution_count_ref.data++;
-        // backoff
-        if (state.exp_backoff) {
-          if (backoff_shifts < 13) {
-            ++backoff_shifts;
-          }
-          uint64_t sleep_duration = 1UL << backoff_shifts;
-          sleep_duration *= 100;
-          std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
-        }
-      }
+      RunTransaction(thread_id, TransactionType::DELIVERY, RunDelivery);
+    }
+  }
+}
+
+// Sum up the counts of all threads
+static RoundCounts CountRound(size_t num_threads) {
+  RoundCounts counts;
+  for (size_t i = 0; i < num_threads; ++i) {
+    for (size_t type_id = 0; type_id < transaction_type_count; ++type_id) {
+      size_t count_idx = i * transaction_type_count + type_id;
+      counts.commits[type_id] += commit_counts[count_idx].data;
+      counts.conflict_aborts[type_id] += conflict_abort_counts[count_idx].data;
+      counts.validation_aborts[type_id] +=
+          validation_abort_counts[count_idx].data;
     }
+  }
+  return counts;
+}
 
-    backoff_shifts >>= 1;
-    transaction_count_ref.data++;
+static double PerCommit(uint64_t count, uint64_t commit_count) {
+  return commit_count == 0 ? 0 : count * 1.0 / commit_count;
+}
 
+// Record the throughput and abort rates of the profile round between the
+// counts
+static void ProfileRound(const RoundCounts &begin, const RoundCounts &end) {
+  uint64_t total_commit_count = 0;
+  uint64_t total_conflict_count = 0;
+  uint64_t total_validation_count = 0;
+  std::vector<double> transaction_throughput;
+  for (size_t type_id = 0; type_id < transaction_type_count; ++type_id) {
+    uint64_t commit_count = end.commits[type_id] - begin.commits[type_id];
+    total_commit_count += commit_count;
+    total_conflict_count +=
+        end.conflict_aborts[type_id] - begin.conflict_aborts[type_id];
+    total_validation_count +=
+        end.validation_aborts[type_id] - begin.validation_aborts[type_id];
+    transaction_throughput.push_back(commit_count * 1.0 /
+                                     state.profile_duration);
   }
+
+  state.profile_throughput
+      .push_back(total_commit_count * 1.0 / state.profile_duration);
+  state.profile_abort_rate.push_back(PerCommit(
+      total_conflict_count + total_validation_count, total_commit_count));
+  state.profile_conflict_abort_rate
+      .push_back(PerCommit(total_conflict_count, total_commit_count));
+  state.profile_validation_abort_rate
+      .push_back(PerCommit(total_validation_count, total_commit_count));
+  state.profile_transaction_throughput.push_back(transaction_throughput);
 }
 
 void RunWorkload() {
@@ -241,24 +303,26 @@ void RunWorkload() {
   // Execute the workload to build the log
   std::vector<std::thread> thread_group;
   size_t num_threads = state.backend_count;
-  
-  abort_counts = new PadInt[num_threads];
-  PL_MEMSET(abort_counts, 0, sizeof(PadInt) * num_threads);
+  size_t count_size = num_threads * transaction_type_count;
 
-  commit_counts = new PadInt[num_threads];
-  PL_MEMSET(commit_counts, 0, sizeof(PadInt) * num_threads);
+  is_running = true;
 
-  size_t profile_round = (size_t)(state.duration / state.profile_duration);
+  commit_counts = new PadInt[count_size];
+  conflict_abort_counts = new PadInt[count_size];
+  validation_abort_counts = new PadInt[count_size];
+  transaction_latencies = new stats::LatencyHistogram[count_size];
+  commit_abort_counts = new PadInt[num_threads];
 
-  PadInt **abort_counts_profiles = new PadInt *[profile_round];
-  for (size_t round_id = 0; round_id < profile_round; ++round_id) {
-    abort_counts_profiles[round_id] = new PadInt[num_threads];
-  }
+  state.profile_throughput.clear();
+  state.profile_abort_rate.clear();
+  state.profile_conflict_abort_rate.clear();
+  state.profile_validation_abort_rate.clear();
+  state.profile_transaction_throughput.clear();
+  state.profile_memory.clear();
 
-  PadInt **commit_counts_profiles = new PadInt *[profile_round];
-  for (size_t round_id = 0; round_id < profile_round; ++round_id) {
-    commit_counts_profiles[round_id] = new PadInt[num_threads];
-  }
+  size_t profile_round = (size_t)(state.duration / state.profile_duration);
+
+  std::vector<RoundCounts> round_counts(profile_round);
 
   for (size_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
     thread_group.push_back(std::thread(RunBackend, thread_itr));
@@ -269,10 +333,7 @@ void RunWorkload() {
   for (size_t round_id = 0; round_id < profile_round; ++round_id) {
     std::this_thread::sleep_for(
         std::chrono::milliseconds(int(state.profile_duration * 1000)));
-    PL_MEMCPY(abort_counts_profiles[round_id], abort_counts,
-           sizeof(PadInt) * num_threads);
-    PL_MEMCPY(commit_counts_profiles[round_id], commit_counts,
-           sizeof(PadInt) * num_threads);
+    round_counts[round_id] = CountRound(num_threads);
     
     auto& manager = catalog::Manager::GetInstance();
     oid_t current_tile_group_id = manager.GetCurrentTileGroupId();
@@ -292,75 +353,64 @@ void RunWorkload() {
     thread_group[thread_itr].join();
   }
 
-  // calculate the throughput and abort rate for the first round.
-  uint64_t total_commit_count = 0;
-  for (size_t i = 0; i < num_threads; ++i) {
-    total_commit_count += commit_counts_profiles[0][i].data;
-  }
-
-  uint64_t total_abort_count = 0;
-  for (size_t i = 0; i < num_threads; ++i) {
-    total_abort_count += abort_counts_profiles[0][i].data;
-  }
-
-  state.profile_throughput
-      .push_back(total_commit_count * 1.0 / state.profile_duration);
-  state.profile_abort_rate
-      .push_back(total_abort_count * 1.0 / total_commit_count);
-
-  // calculate the throughput and abort rate for the remaining rounds.
+  // calculate the throughput and abort rates of every round.
+  ProfileRound(RoundCounts(), round_counts[0]);
   for (size_t round_id = 0; round_id < profile_round - 1; ++round_id) {
-    total_commit_count = 0;
-    for (size_t i = 0; i < num_threads; ++i) {
-      total_commit_count += commit_counts_profiles[round_id + 1][i].data -
-                            commit_counts_profiles[round_id][i].data;
-    }
+    ProfileRound(round_counts[round_id], round_counts[round_id + 1]);
+  }
 
-    total_abort_count = 0;
+  // calculate the aggregated throughput and abort rates, of all transactions
+  // and of every type.
+  auto &total_counts = round_counts[profile_round - 1];
+  uint64_t total_commit_count = 0;
+  uint64_t total_conflict_count = 0;
+  uint64_t total_validation_count = 0;
+  state.transaction_results.clear();
+  for (size_t type_id = 0; type_id < transaction_type_count; ++type_id) {
+    uint64_t commit_count = total_counts.commits[type_id];
+    total_commit_count += commit_count;
+    total_conflict_count += total_counts.conflict_aborts[type_id];
+    total_validation_count += total_counts.validation_aborts[type_id];
+
+    // the latencies of all threads, including the ones after the last round
+    stats::LatencyHistogram latencies;
     for (size_t i = 0; i < num_threads; ++i) {
-      total_abort_count += abort_counts_profiles[round_id + 1][i].data -
-                           abort_counts_profiles[round_id][i].data;
+      latencies.Merge(
+          transaction_latencies[i * transaction_type_count + type_id]);
     }
 
-    state.profile_throughput
-        .push_back(total_commit_count * 1.0 / state.profile_duration);
-    state.profile_abort_rate
-        .push_back(total_abort_count * 1.0 / total_commit_count);
-  }
-
-  // calculate the aggregated throughput and abort rate.
-  total_commit_count = 0;
-  for (size_t i = 0; i < num_threads; ++i) {
-    total_commit_count += commit_counts_profiles[profile_round - 1][i].data;
-  }
-
-  total_abort_count = 0;
-  for (size_t i = 0; i < num_threads; ++i) {
-    total_abort_count += abort_counts_profiles[profile_round - 1][i].data;
+    TransactionResult result;
+    result.throughput = commit_count * 1.0 / state.duration;
+    result.conflict_abort_rate =
+        PerCommit(total_counts.conflict_aborts[type_id], commit_count);
+    result.validation_abort_rate =
+        PerCommit(total_counts.validation_aborts[type_id], commit_count);
+    result.average_latency = latencies.GetAverage();
+    result.p50_latency = latencies.GetPercentile(50);
+    result.p95_latency = latencies.GetPercentile(95);
+    result.p99_latency = latencies.GetPercentile(99);
+    state.transaction_results.push_back(result);
   }
 
   state.throughput = total_commit_count * 1.0 / state.duration;
-  state.abort_rate = total_abort_count * 1.0 / total_commit_count;
+  state.abort_rate = PerCommit(total_conflict_count + total_validation_count,
+                               total_commit_count);
+  state.conflict_abort_rate =
+      PerCommit(total_conflict_count, total_commit_count);
+  state.validation_abort_rate =
+      PerCommit(total_validation_count, total_commit_count);
 
   // cleanup everything.
-  for (size_t round_id = 0; round_id < profile_round; ++round_id) {
-    delete[] abort_counts_profiles[round_id];
-    abort_counts_profiles[round_id] = nullptr;
-  }
-
-  for (size_t round_id = 0; round_id < profile_round; ++round_id) {
-    delete[] commit_counts_profiles[round_id];
-    commit_counts_profiles[round_id] = nullptr;
-  }
-  delete[] abort_counts_profiles;
-  abort_counts_profiles = nullptr;
-  delete[] commit_counts_profiles;
-  commit_counts_profiles = nullptr;
-
-  delete[] abort_counts;
-  abort_counts = nullptr;
   delete[] commit_counts;
   commit_counts = nullptr;
+  delete[] conflict_abort_counts;
+  conflict_abort_counts = nullptr;
+  delete[] validation_abort_counts;
+  validation_abort_counts = nullptr;
+  delete[] transaction_latencies;
+  transaction_latencies = nullptr;
+  delete[] commit_abort_counts;
+  commit_abort_counts = nullptr;
 }
 
 /////////////////////////////////////////////////////////
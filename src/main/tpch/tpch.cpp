@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdio>
 #include <getopt.h>
 #include <string>
@@ -18,6 +19,7 @@
 #include "benchmark/tpch/tpch_database.h"
 #include "benchmark/tpch/tpch_workload.h"
 #include "common/logger.h"
+#include "configuration/configuration.h"
 
 namespace peloton {
 namespace benchmark {
@@ -31,13 +33,22 @@ void Usage(FILE *out) {
           "   -n --num-runs          :  the number of runs to execute for each query \n"
           "   -s --suffix            :  input file suffix \n"
           "   -d --dict-encode       :  dictionary encode \n"
-          "   -q --queries           :  comma-separated list of queries to run (i.g., 1,14 for Q1 and Q14) \n");
+          "   -q --queries           :  comma-separated list of queries to run (i.g., 1,14 for Q1 and Q14) \n"
+          "   -f --scale-factor      :  the scale factor of the data \n"
+          "   -e --engine            :  codegen, interpreter or both \n"
+          "   -t --threads           :  the number of threads the scans run on \n");
 }
 
 static struct option opts[] = {
+    {"help", no_argument, NULL, 'h'},
     {"input-dir", required_argument, NULL, 'i'},
+    {"num-runs", required_argument, NULL, 'n'},
+    {"suffix", required_argument, NULL, 's'},
     {"dict-encode", optional_argument, NULL, 'd'},
     {"queries", optional_argument, NULL, 'q'},
+    {"scale-factor", required_argument, NULL, 'f'},
+    {"engine", required_argument, NULL, 'e'},
+    {"threads", required_argument, NULL, 't'},
     {NULL, 0, NULL, 0}};
 
 void ParseArguments(int argc, char **argv, Configuration &config) {
@@ -46,7 +57,7 @@ void ParseArguments(int argc, char **argv, Configuration &config) {
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "hi:n:s:dq:", opts, &idx);
+    int c = getopt_long(argc, argv, "hi:n:s:dq:f:e:t:", opts, &idx);
 
     if (c == -1) break;
 
@@ -59,6 +70,12 @@ void ParseArguments(int argc, char **argv, Configuration &config) {
       case 'n': {
         char *input = optarg;
         config.num_runs = static_cast<uint32_t>(std::atoi(input));
+        break;
+      }
+      case 's': {
+        char *input = optarg;
+        config.suffix = input;
+        break;
       }
       case 'd': {
         config.dictionary_encode = true;
@@ -69,6 +86,26 @@ void ParseArguments(int argc, char **argv, Configuration &config) {
         config.SetRunnableQueries(csv_queries);
         break;
       }
+      case 'f': {
+        char *input = optarg;
+        config.scale_factor = std::atof(input);
+        break;
+      }
+      case 'e': {
+        char *input = optarg;
+        if (!config.SetEngines(input)) {
+          LOG_ERROR("Unknown engine: %s", input);
+          Usage(stderr);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
+      case 't': {
+        char *input = optarg;
+        config.num_threads =
+            std::max(static_cast<uint32_t>(std::atoi(input)), 1u);
+        break;
+      }
       case 'h': {
         Usage(stderr);
         exit(EXIT_FAILURE);
@@ -86,7 +123,17 @@ void ParseArguments(int argc, char **argv, Configuration &config) {
     exit(EXIT_FAILURE);
   }
 
+  // The scans of compiled queries run in parallel themselves, interpreted
+  // queries run them under exchanges
+  FLAGS_codegen_parallel_scan_threads = config.num_threads;
+  FLAGS_exchange_threads = config.num_threads;
+
   LOG_INFO("Input directory   : '%s'", config.data_dir.c_str());
+  LOG_INFO("Scale factor      : %.2lf", config.scale_factor);
+  LOG_INFO("Threads           : %u", config.num_threads);
+  LOG_INFO("Engines           : %s%s",
+           config.run_codegen ? "codegen " : "",
+           config.run_interpreter ? "interpreter" : "");
   LOG_INFO("Dictionary encode : %s",
            config.dictionary_encode ? "true" : "false");
   for (uint32_t i = 0; i < 22; i++) {
@@ -15,6 +15,7 @@
 #include <sys/stat.h>
 
 #include "common/logger.h"
+#include "type/type.h"
 
 namespace peloton {
 namespace benchmark {
@@ -108,6 +109,12 @@ void Configuration::SetRunnableQueries(char *query_list) {
   }
 }
 
+bool Configuration::SetEngines(const std::string &engines) {
+  run_codegen = (engines == "codegen" || engines == "both");
+  run_interpreter = (engines == "interpreter" || engines == "both");
+  return run_codegen || run_interpreter;
+}
+
 bool Configuration::ShouldRunQuery(QueryId qid) const {
   return queries_to_run[static_cast<uint32_t>(qid)];
 }
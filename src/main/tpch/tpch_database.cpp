@@ -12,8 +12,23 @@
 
 #include "benchmark/tpch/tpch_database.h"
 
+#include <ctime>
+#include <fcntl.h>
+#include <functional>
+#include <unistd.h>
+
 #include "benchmark/tpch/tpch_workload.h"
 #include "catalog/catalog.h"
+#include "catalog/schema.h"
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/table_factory.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace benchmark {
@@ -73,7 +88,7 @@ void ForEachLine(const std::string fname, std::function<void(char *)> cb) {
 }
 
 // Convert the given string into a i32 date
-uint32_t ConvertDate(char *p) {
+uint32_t ConvertDate(const char *p) {
   std::tm t_shipdate;
   PL_MEMSET(&t_shipdate, 0, sizeof(std::tm));
   strptime(p, "%Y-%m-%d", &t_shipdate);
@@ -122,8 +137,8 @@ void TPCHDatabase::CreateTables() const {
 }
 
 storage::Database &TPCHDatabase::GetDatabase() const {
-  auto *catalog = catalog::Catalog::GetInstance();
-  return *catalog->GetDatabaseWithOid(kTPCHDatabaseId);
+  auto *storage_manager = storage::StorageManager::GetInstance();
+  return *storage_manager->GetDatabaseWithOid(kTPCHDatabaseId);
 }
 
 storage::DataTable &TPCHDatabase::GetTable(TableId table_id) const {
@@ -142,9 +157,39 @@ uint32_t TPCHDatabase::DictionaryEncode(Dictionary &dict,
   }
 }
 
+uint32_t TPCHDatabase::LookupCode(const Dictionary &dict,
+                                  const std::string &val) {
+  auto iter = dict.find(val);
+  return iter != dict.end() ? iter->second : 0;
+}
+
 uint32_t TPCHDatabase::CodeForMktSegment(const std::string mktsegment) const {
-  auto iter = c_mktsegment_dict_.find(mktsegment);
-  return iter != c_mktsegment_dict_.end() ? iter->second : 0;
+  return LookupCode(c_mktsegment_dict_, mktsegment);
+}
+
+uint32_t TPCHDatabase::CodeForShipMode(const std::string &shipmode) const {
+  return LookupCode(l_shipmode_dict_, shipmode);
+}
+
+uint32_t TPCHDatabase::CodeForShipInstruct(
+    const std::string &shipinstruct) const {
+  return LookupCode(l_shipinstruct_dict_, shipinstruct);
+}
+
+uint32_t TPCHDatabase::CodeForBrand(const std::string &brand) const {
+  return LookupCode(p_brand_dict_, brand);
+}
+
+uint32_t TPCHDatabase::CodeForContainer(const std::string &container) const {
+  return LookupCode(p_container_dict_, container);
+}
+
+int32_t TPCHDatabase::KeyForNation(const std::string &name) const {
+  return static_cast<int32_t>(LookupCode(nation_keys_, name));
+}
+
+int32_t TPCHDatabase::KeyForRegion(const std::string &name) const {
+  return static_cast<int32_t>(LookupCode(region_keys_, name));
 }
 
 //===----------------------------------------------------------------------===//
@@ -218,8 +263,15 @@ void TPCHDatabase::CreateLineitemTable() const {
   catalog::Column l_shipdate = {type::TypeId::DATE, kDateSize, "l_shipdate"};
   catalog::Column l_commitdate = {type::TypeId::DATE, kDateSize, "l_commitdate"};
   catalog::Column l_receiptdate = {type::TypeId::DATE, kDateSize, "l_receiptdate"};
-  catalog::Column l_shipinstruct = {type::TypeId::INTEGER, kIntSize, "l_shipinstruct"};
-  catalog::Column l_shipmode = {type::TypeId::INTEGER, kIntSize, "l_shipmode"};
+  catalog::Column l_shipinstruct;
+  catalog::Column l_shipmode;
+  if (config_.dictionary_encode) {
+    l_shipinstruct = {type::TypeId::INTEGER, kIntSize, "l_shipinstruct"};
+    l_shipmode = {type::TypeId::INTEGER, kIntSize, "l_shipmode"};
+  } else {
+    l_shipinstruct = {type::TypeId::VARCHAR, 25, "l_shipinstruct"};
+    l_shipmode = {type::TypeId::VARCHAR, 10, "l_shipmode"};
+  }
   catalog::Column l_comment = {type::TypeId::VARCHAR, 44, "l_comment"};
 
   auto lineitem_cols = {
@@ -350,11 +402,88 @@ void TPCHDatabase::CreatePartTable() const {
   GetDatabase().AddTable(part_table);
 }
 
-void TPCHDatabase::CreatePartSupplierTable() const {}
+void TPCHDatabase::CreatePartSupplierTable() const {
+  catalog::Column ps_partkey = {type::TypeId::INTEGER, kIntSize,
+                                "ps_partkey", true};
+  catalog::Column ps_suppkey = {type::TypeId::INTEGER, kIntSize,
+                                "ps_suppkey", true};
+  catalog::Column ps_availqty = {type::TypeId::INTEGER, kIntSize,
+                                 "ps_availqty", true};
+  catalog::Column ps_supplycost = {type::TypeId::DECIMAL, kDecimalSize,
+                                   "ps_supplycost", true};
+  catalog::Column ps_comment = {type::TypeId::VARCHAR, 199, "ps_comment",
+                                false};
+
+  // Create the schema
+  auto partsupp_cols = {ps_partkey, ps_suppkey, ps_availqty, ps_supplycost,
+                        ps_comment};
+  std::unique_ptr<catalog::Schema> partsupp_schema{
+      new catalog::Schema{partsupp_cols}};
+
+  // Create the table!
+  bool owns_schema = true;
+  bool adapt_table = true;
+  storage::DataTable *partsupp_table = storage::TableFactory::GetDataTable(
+      kTPCHDatabaseId, (uint32_t)TableId::PartSupp, partsupp_schema.release(),
+      "PartSupp", config_.tuples_per_tile_group, owns_schema, adapt_table);
+
+  // Add the table to the database (we're releasing ownership at this point)
+  GetDatabase().AddTable(partsupp_table);
+}
+
+void TPCHDatabase::CreateRegionTable() const {
+  catalog::Column r_regionkey = {type::TypeId::INTEGER, kIntSize,
+                                 "r_regionkey", true};
+  catalog::Column r_name = {type::TypeId::VARCHAR, 25, "r_name", false};
+  catalog::Column r_comment = {type::TypeId::VARCHAR, 152, "r_comment",
+                               false};
+
+  // Create the schema
+  auto region_cols = {r_regionkey, r_name, r_comment};
+  std::unique_ptr<catalog::Schema> region_schema{
+      new catalog::Schema{region_cols}};
+
+  // Create the table!
+  bool owns_schema = true;
+  bool adapt_table = true;
+  storage::DataTable *region_table = storage::TableFactory::GetDataTable(
+      kTPCHDatabaseId, (uint32_t)TableId::Region, region_schema.release(),
+      "Region", config_.tuples_per_tile_group, owns_schema, adapt_table);
+
+  // Add the table to the database (we're releasing ownership at this point)
+  GetDatabase().AddTable(region_table);
+}
+
+void TPCHDatabase::CreateSupplierTable() const {
+  catalog::Column s_suppkey = {type::TypeId::INTEGER, kIntSize,
+                               "s_suppkey", true};
+  catalog::Column s_name = {type::TypeId::VARCHAR, 25, "s_name", false};
+  catalog::Column s_address = {type::TypeId::VARCHAR, 40, "s_address",
+                               false};
+  catalog::Column s_nationkey = {type::TypeId::INTEGER, kIntSize,
+                                 "s_nationkey", true};
+  catalog::Column s_phone = {type::TypeId::VARCHAR, 15, "s_phone", false};
+  catalog::Column s_acctbal = {type::TypeId::DECIMAL, kDecimalSize,
+                               "s_acctbal", true};
+  catalog::Column s_comment = {type::TypeId::VARCHAR, 101, "s_comment",
+                               false};
+
+  // Create the schema
+  auto supplier_cols = {s_suppkey, s_name,    s_address, s_nationkey,
+                        s_phone,   s_acctbal, s_comment};
+  std::unique_ptr<catalog::Schema> supplier_schema{
+      new catalog::Schema{supplier_cols}};
 
-void TPCHDatabase::CreateRegionTable() const {}
+  // Create the table!
+  bool owns_schema = true;
+  bool adapt_table = true;
+  storage::DataTable *supplier_table = storage::TableFactory::GetDataTable(
+      kTPCHDatabaseId, (uint32_t)TableId::Supplier, supplier_schema.release(),
+      "Supplier", config_.tuples_per_tile_group, owns_schema, adapt_table);
 
-void TPCHDatabase::CreateSupplierTable() const {}
+  // Add the table to the database (we're releasing ownership at this point)
+  GetDatabase().AddTable(supplier_table);
+}
 
 //===----------------------------------------------------------------------===//
 // TABLE LOADERS
@@ -423,11 +552,11 @@ void TPCHDatabase::LoadPartTable() {
     p = p_end + 1;
     tuple.SetValue(5, type::ValueFactory::GetIntegerValue(std::atoi(p)));
 
-    p = p_end + 1;
+    p = strchr(p, '|') + 1;
     p_end = strchr(p, '|');
     std::string p_container{p, p_end};
     if (config_.dictionary_encode) {
-      uint32_t code = DictionaryEncode(p_container_dict_, p_brand);
+      uint32_t code = DictionaryEncode(p_container_dict_, p_container);
       tuple.SetValue(6, type::ValueFactory::GetIntegerValue(code));
     } else {
       tuple.SetValue(6, type::ValueFactory::GetVarcharValue(p_container), pool.get());
@@ -436,7 +565,7 @@ void TPCHDatabase::LoadPartTable() {
     p = p_end + 1;
     tuple.SetValue(7, type::ValueFactory::GetDecimalValue(std::atof(p)));
 
-    p = p_end + 1;
+    p = strchr(p, '|') + 1;
     p_end = strchr(p, '|');
     tuple.SetValue(8, type::ValueFactory::GetVarcharValue(std::string{p, p_end}), pool.get());
 
@@ -461,16 +590,159 @@ void TPCHDatabase::LoadPartTable() {
   SetTableIsLoaded(TableId::Part);
 }
 
-void TPCHDatabase::LoadSupplierTable() {}
+void TPCHDatabase::LoadSupplierTable() {
+  if (TableIsLoaded(TableId::Supplier)) {
+    return;
+  }
+
+  const std::string filename = config_.GetSupplierPath();
+
+  LOG_INFO("Loading Supplier ['%s']\n", filename.c_str());
+
+  auto &table = GetTable(TableId::Supplier);
+
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+
+  uint64_t num_tuples = 0;
+  std::unique_ptr<type::AbstractPool> pool{new type::EphemeralPool()};
+
+  ForEachLine(filename, [&](char *p) {
+    storage::Tuple tuple{table.GetSchema(), true /* allocate */};
+
+    // S_SUPPKEY
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // S_NAME
+    p = strchr(p, '|') + 1;
+    char *p_end = strchr(p, '|');
+    tuple.SetValue(1,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // S_ADDRESS
+    p = p_end + 1;
+    p_end = strchr(p, '|');
+    tuple.SetValue(2,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // S_NATIONKEY
+    p = p_end + 1;
+    tuple.SetValue(3, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // S_PHONE
+    p = strchr(p, '|') + 1;
+    p_end = strchr(p, '|');
+    tuple.SetValue(4,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // S_ACCTBAL
+    p = p_end + 1;
+    tuple.SetValue(5, type::ValueFactory::GetDecimalValue(std::atof(p)));
+
+    // S_COMMENT
+    p = strchr(p, '|') + 1;
+    p_end = strchr(p, '|');
+    tuple.SetValue(6,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // Insert into table
+    ItemPointer tuple_slot_id = table.InsertTuple(&tuple);
+    PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+    PL_ASSERT(tuple_slot_id.offset != INVALID_OID);
+    txn_manager.PerformInsert(txn, tuple_slot_id);
+
+    num_tuples++;
+  });
+
+  // Commit
+  PL_ASSERT(txn_manager.CommitTransaction(txn) == ResultType::SUCCESS);
+
+  timer.Stop();
+  LOG_INFO("Loading Supplier finished: %.2f ms (%lu tuples)\n",
+           timer.GetDuration(), num_tuples);
+
+  // Set table as loaded
+  SetTableIsLoaded(TableId::Supplier);
+}
+
+void TPCHDatabase::LoadPartSupplierTable() {
+  if (TableIsLoaded(TableId::PartSupp)) {
+    return;
+  }
+
+  const std::string filename = config_.GetPartSuppPath();
+
+  LOG_INFO("Loading PartSupplier ['%s']\n", filename.c_str());
+
+  auto &table = GetTable(TableId::PartSupp);
+
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+
+  uint64_t num_tuples = 0;
+  std::unique_ptr<type::AbstractPool> pool{new type::EphemeralPool()};
+
+  ForEachLine(filename, [&](char *p) {
+    storage::Tuple tuple{table.GetSchema(), true /* allocate */};
+
+    // PS_PARTKEY
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // PS_SUPPKEY
+    p = strchr(p, '|') + 1;
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // PS_AVAILQTY
+    p = strchr(p, '|') + 1;
+    tuple.SetValue(2, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // PS_SUPPLYCOST
+    p = strchr(p, '|') + 1;
+    tuple.SetValue(3, type::ValueFactory::GetDecimalValue(std::atof(p)));
+
+    // PS_COMMENT
+    p = strchr(p, '|') + 1;
+    char *p_end = strchr(p, '|');
+    tuple.SetValue(4,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // Insert into table
+    ItemPointer tuple_slot_id = table.InsertTuple(&tuple);
+    PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+    PL_ASSERT(tuple_slot_id.offset != INVALID_OID);
+    txn_manager.PerformInsert(txn, tuple_slot_id);
+
+    num_tuples++;
+  });
+
+  // Commit
+  PL_ASSERT(txn_manager.CommitTransaction(txn) == ResultType::SUCCESS);
+
+  timer.Stop();
+  LOG_INFO("Loading PartSupplier finished: %.2f ms (%lu tuples)\n",
+           timer.GetDuration(), num_tuples);
 
-void TPCHDatabase::LoadPartSupplierTable() {}
+  // Set table as loaded
+  SetTableIsLoaded(TableId::PartSupp);
+}
 
 void TPCHDatabase::LoadCustomerTable() {
   if (TableIsLoaded(TableId::Customer)) {
     return;
   }
 
-  const std::string filename = config_.GetPartPath();
+  const std::string filename = config_.GetCustomerPath();
 
   LOG_INFO("Loading Customer ['%s']\n", filename.c_str());
 
@@ -560,7 +832,70 @@ void TPCHDatabase::LoadCustomerTable() {
   SetTableIsLoaded(TableId::Customer);
 }
 
-void TPCHDatabase::LoadNationTable() {}
+void TPCHDatabase::LoadNationTable() {
+  if (TableIsLoaded(TableId::Nation)) {
+    return;
+  }
+
+  const std::string filename = config_.GetNationPath();
+
+  LOG_INFO("Loading Nation ['%s']\n", filename.c_str());
+
+  auto &table = GetTable(TableId::Nation);
+
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+
+  uint64_t num_tuples = 0;
+  std::unique_ptr<type::AbstractPool> pool{new type::EphemeralPool()};
+
+  ForEachLine(filename, [&](char *p) {
+    storage::Tuple tuple{table.GetSchema(), true /* allocate */};
+
+    // N_NATIONKEY
+    int32_t n_nationkey = std::atoi(p);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(n_nationkey));
+
+    // N_NAME
+    p = strchr(p, '|') + 1;
+    char *p_end = strchr(p, '|');
+    std::string n_name{p, p_end};
+    nation_keys_[n_name] = static_cast<uint32_t>(n_nationkey);
+    tuple.SetValue(1, type::ValueFactory::GetVarcharValue(n_name), pool.get());
+
+    // N_REGIONKEY
+    p = p_end + 1;
+    tuple.SetValue(2, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // N_COMMENT
+    p = strchr(p, '|') + 1;
+    p_end = strchr(p, '|');
+    tuple.SetValue(3,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // Insert into table
+    ItemPointer tuple_slot_id = table.InsertTuple(&tuple);
+    PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+    PL_ASSERT(tuple_slot_id.offset != INVALID_OID);
+    txn_manager.PerformInsert(txn, tuple_slot_id);
+
+    num_tuples++;
+  });
+
+  // Commit
+  PL_ASSERT(txn_manager.CommitTransaction(txn) == ResultType::SUCCESS);
+
+  timer.Stop();
+  LOG_INFO("Loading Nation finished: %.2f ms (%lu tuples)\n",
+           timer.GetDuration(), num_tuples);
+
+  // Set table as loaded
+  SetTableIsLoaded(TableId::Nation);
+}
 
 void TPCHDatabase::LoadLineitemTable() {
   // Short-circuit if table is already loaded
@@ -647,7 +982,7 @@ void TPCHDatabase::LoadLineitemTable() {
       uint32_t code = DictionaryEncode(l_shipmode_dict_, l_shipmode);
       tuple.SetValue(14, type::ValueFactory::GetIntegerValue(code));
     } else {
-      tuple.SetValue(14, type::ValueFactory::GetVarcharValue(l_shipinstruct),
+      tuple.SetValue(14, type::ValueFactory::GetVarcharValue(l_shipmode),
                      pool.get());
     }
 
@@ -681,9 +1016,156 @@ void TPCHDatabase::LoadLineitemTable() {
   SetTableIsLoaded(TableId::Lineitem);
 }
 
-void TPCHDatabase::LoadRegionTable() {}
+void TPCHDatabase::LoadRegionTable() {
+  if (TableIsLoaded(TableId::Region)) {
+    return;
+  }
+
+  const std::string filename = config_.GetRegionPath();
+
+  LOG_INFO("Loading Region ['%s']\n", filename.c_str());
 
-void TPCHDatabase::LoadOrdersTable() {}
+  auto &table = GetTable(TableId::Region);
+
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+
+  uint64_t num_tuples = 0;
+  std::unique_ptr<type::AbstractPool> pool{new type::EphemeralPool()};
+
+  ForEachLine(filename, [&](char *p) {
+    storage::Tuple tuple{table.GetSchema(), true /* allocate */};
+
+    // R_REGIONKEY
+    int32_t r_regionkey = std::atoi(p);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(r_regionkey));
+
+    // R_NAME
+    p = strchr(p, '|') + 1;
+    char *p_end = strchr(p, '|');
+    std::string r_name{p, p_end};
+    region_keys_[r_name] = static_cast<uint32_t>(r_regionkey);
+    tuple.SetValue(1, type::ValueFactory::GetVarcharValue(r_name), pool.get());
+
+    // R_COMMENT
+    p = p_end + 1;
+    p_end = strchr(p, '|');
+    tuple.SetValue(2,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // Insert into table
+    ItemPointer tuple_slot_id = table.InsertTuple(&tuple);
+    PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+    PL_ASSERT(tuple_slot_id.offset != INVALID_OID);
+    txn_manager.PerformInsert(txn, tuple_slot_id);
+
+    num_tuples++;
+  });
+
+  // Commit
+  PL_ASSERT(txn_manager.CommitTransaction(txn) == ResultType::SUCCESS);
+
+  timer.Stop();
+  LOG_INFO("Loading Region finished: %.2f ms (%lu tuples)\n",
+           timer.GetDuration(), num_tuples);
+
+  // Set table as loaded
+  SetTableIsLoaded(TableId::Region);
+}
+
+void TPCHDatabase::LoadOrdersTable() {
+  if (TableIsLoaded(TableId::Orders)) {
+    return;
+  }
+
+  const std::string filename = config_.GetOrdersPath();
+
+  LOG_INFO("Loading Orders ['%s']\n", filename.c_str());
+
+  auto &table = GetTable(TableId::Orders);
+
+  Timer<std::ratio<1, 1000>> timer;
+  timer.Start();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto *txn = txn_manager.BeginTransaction();
+
+  uint64_t num_tuples = 0;
+  std::unique_ptr<type::AbstractPool> pool{new type::EphemeralPool()};
+
+  ForEachLine(filename, [&](char *p) {
+    storage::Tuple tuple{table.GetSchema(), true /* allocate */};
+
+    // O_ORDERKEY
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // O_CUSTKEY
+    p = strchr(p, '|') + 1;
+    tuple.SetValue(1, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // O_ORDERSTATUS
+    p = strchr(p, '|') + 1;
+    char *p_end = strchr(p, '|');
+    tuple.SetValue(2,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // O_TOTALPRICE
+    p = p_end + 1;
+    tuple.SetValue(3, type::ValueFactory::GetDecimalValue(std::atof(p)));
+
+    // O_ORDERDATE
+    p = strchr(p, '|') + 1;
+    tuple.SetValue(4, type::ValueFactory::GetDateValue(ConvertDate(p)));
+
+    // O_ORDERPRIORITY
+    p = strchr(p, '|') + 1;
+    p_end = strchr(p, '|');
+    tuple.SetValue(5,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // O_CLERK
+    p = p_end + 1;
+    p_end = strchr(p, '|');
+    tuple.SetValue(6,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // O_SHIPPRIORITY
+    p = p_end + 1;
+    tuple.SetValue(7, type::ValueFactory::GetIntegerValue(std::atoi(p)));
+
+    // O_COMMENT
+    p = strchr(p, '|') + 1;
+    p_end = strchr(p, '|');
+    tuple.SetValue(8,
+                   type::ValueFactory::GetVarcharValue(std::string{p, p_end}),
+                   pool.get());
+
+    // Insert into table
+    ItemPointer tuple_slot_id = table.InsertTuple(&tuple);
+    PL_ASSERT(tuple_slot_id.block != INVALID_OID);
+    PL_ASSERT(tuple_slot_id.offset != INVALID_OID);
+    txn_manager.PerformInsert(txn, tuple_slot_id);
+
+    num_tuples++;
+  });
+
+  // Commit
+  PL_ASSERT(txn_manager.CommitTransaction(txn) == ResultType::SUCCESS);
+
+  timer.Stop();
+  LOG_INFO("Loading Orders finished: %.2f ms (%lu tuples)\n",
+           timer.GetDuration(), num_tuples);
+
+  // Set table as loaded
+  SetTableIsLoaded(TableId::Orders);
+}
 
 }  // namespace tpch
 }  // namespace benchmark
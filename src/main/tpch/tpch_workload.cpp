@@ -12,18 +12,33 @@
 
 #include "benchmark/tpch/tpch_workload.h"
 
+#include <algorithm>
+#include <fstream>
+
+#include "catalog/schema.h"
 #include "codegen/query.h"
+#include "codegen/query_compiler.h"
+#include "common/timer.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "executor/executor_context.h"
 #include "executor/plan_executor.h"
+#include "expression/constant_value_expression.h"
+#include "expression/operator_expression.h"
+#include "expression/tuple_value_expression.h"
 #include "planner/abstract_plan.h"
 #include "planner/binding_context.h"
+#include "planner/exchange_plan.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/seq_scan_plan.h"
 
 namespace peloton {
 namespace benchmark {
 namespace tpch {
 
 TPCHBenchmark::TPCHBenchmark(const Configuration &config, TPCHDatabase &db)
-    : config_(config), db_(db) {
+    : config_(config), db_(db), engine_(ExecutionEngine::Codegen) {
   query_configs_ = {
       {"Q1",
        QueryId::Q1,
@@ -32,8 +47,9 @@ TPCHBenchmark::TPCHBenchmark(const Configuration &config, TPCHDatabase &db)
 
       {"Q2",
        QueryId::Q2,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Part, TableId::Supplier, TableId::PartSupp, TableId::Nation,
+        TableId::Region},
+       nullptr},
 
       {"Q3",
        QueryId::Q3,
@@ -42,13 +58,14 @@ TPCHBenchmark::TPCHBenchmark(const Configuration &config, TPCHDatabase &db)
 
       {"Q4",
        QueryId::Q4,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Orders},
+       [&]() { return ConstructQ4Plan(); }},
 
       {"Q5",
        QueryId::Q5,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Customer, TableId::Orders,
+        TableId::Supplier, TableId::Nation, TableId::Region},
+       [&]() { return ConstructQ5Plan(); }},
 
       {"Q6",
        QueryId::Q6,
@@ -57,83 +74,87 @@ TPCHBenchmark::TPCHBenchmark(const Configuration &config, TPCHDatabase &db)
 
       {"Q7",
        QueryId::Q7,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Customer, TableId::Orders,
+        TableId::Supplier, TableId::Nation},
+       [&]() { return ConstructQ7Plan(); }},
 
       {"Q8",
        QueryId::Q8,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Part, TableId::Customer, TableId::Orders,
+        TableId::Supplier, TableId::Nation, TableId::Region},
+       nullptr},
 
       {"Q9",
        QueryId::Q9,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Part, TableId::Orders, TableId::Supplier,
+        TableId::PartSupp, TableId::Nation},
+       nullptr},
 
       {"Q10",
        QueryId::Q10,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Customer, TableId::Orders, TableId::Nation},
+       [&]() { return ConstructQ10Plan(); }},
 
       {"Q11",
        QueryId::Q11,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::PartSupp, TableId::Supplier, TableId::Nation},
+       [&]() { return ConstructQ11Plan(); }},
 
       {"Q12",
        QueryId::Q12,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Orders},
+       [&]() { return ConstructQ12Plan(); }},
 
       {"Q13",
        QueryId::Q13,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Customer, TableId::Orders},
+       nullptr},
 
       {"Q14",
        QueryId::Q14,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Part},
+       [&]() { return ConstructQ14Plan(); }},
 
       {"Q15",
        QueryId::Q15,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Supplier},
+       [&]() { return ConstructQ15Plan(); }},
 
       {"Q16",
        QueryId::Q16,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Part, TableId::PartSupp, TableId::Supplier},
+       nullptr},
 
       {"Q17",
        QueryId::Q17,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Part},
+       [&]() { return ConstructQ17Plan(); }},
 
       {"Q18",
        QueryId::Q18,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Customer, TableId::Orders},
+       [&]() { return ConstructQ18Plan(); }},
 
       {"Q19",
        QueryId::Q19,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Part},
+       [&]() { return ConstructQ19Plan(); }},
 
       {"Q20",
        QueryId::Q20,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Part, TableId::Supplier, TableId::PartSupp,
+        TableId::Nation},
+       nullptr},
 
       {"Q21",
        QueryId::Q21,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Lineitem, TableId::Orders, TableId::Supplier, TableId::Nation},
+       nullptr},
 
       {"Q22",
        QueryId::Q22,
-       {TableId::Lineitem},
-       [&]() { return ConstructQ1Plan(); }},
+       {TableId::Customer, TableId::Orders},
+       nullptr},
   };
 }
 
@@ -144,9 +165,16 @@ void TPCHBenchmark::RunBenchmark() {
       RunQuery(query_config);
     }
   }
+  PrintStats();
 }
 
 void TPCHBenchmark::RunQuery(const TPCHBenchmark::QueryConfig &query_config) {
+  if (query_config.PlanConstructor == nullptr) {
+    LOG_INFO("TPCH %s has no plan yet, skipping it",
+             query_config.query_name.c_str());
+    return;
+  }
+
   LOG_INFO("Running TPCH %s", query_config.query_name.c_str());
 
   // Load all the necessary tables
@@ -154,8 +182,24 @@ void TPCHBenchmark::RunQuery(const TPCHBenchmark::QueryConfig &query_config) {
     db_.LoadTable(tid);
   }
 
-  // Construct the plan for Q1
+  if (config_.run_codegen) {
+    RunCompiled(query_config);
+  }
+  if (config_.run_interpreter) {
+    RunInterpreted(query_config);
+  }
+}
+
+void TPCHBenchmark::RunCompiled(const QueryConfig &query_config) {
+  engine_ = ExecutionEngine::Codegen;
+
+  // Construct the plan for the query
   std::unique_ptr<planner::AbstractPlan> plan = query_config.PlanConstructor();
+  if (!codegen::QueryCompiler::IsSupported(*plan)) {
+    LOG_INFO("%s: the plan can't be compiled, skipping codegen",
+             query_config.query_name.c_str());
+    return;
+  }
 
   // Do attribute binding
   planner::BindingContext binding_context;
@@ -173,17 +217,20 @@ void TPCHBenchmark::RunQuery(const TPCHBenchmark::QueryConfig &query_config) {
   overall_stats.init_ms = 0.0;
   overall_stats.plan_ms = 0.0;
   overall_stats.tear_down_ms = 0.0;
+  std::vector<double> run_ms;
   for (uint32_t i = 0; i < config_.num_runs; i++) {
     // Reset the counter for this run
     counter.ResetCount();
 
-    // Begin a transaction
+    // Begin a read-only transaction, so that the scans run in parallel
     auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-    auto *txn = txn_manager.BeginTransaction();
+    auto *txn = txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
 
     // Execute query in a transaction
+    executor::ExecutorContext executor_context{txn};
     codegen::Query::RuntimeStats runtime_stats;
-    compiled_query->Execute(*txn, counter.GetCountAsState(), &runtime_stats);
+    compiled_query->Execute(*txn, &executor_context, counter.GetCountAsState(),
+                            &runtime_stats);
 
     // Commit transaction
     txn_manager.CommitTransaction(txn);
@@ -192,19 +239,197 @@ void TPCHBenchmark::RunQuery(const TPCHBenchmark::QueryConfig &query_config) {
     overall_stats.init_ms += runtime_stats.init_ms;
     overall_stats.plan_ms += runtime_stats.plan_ms;
     overall_stats.tear_down_ms += runtime_stats.tear_down_ms;
+    run_ms.push_back(runtime_stats.init_ms + runtime_stats.plan_ms +
+                     runtime_stats.tear_down_ms);
   }
 
   LOG_INFO("%s: ==============================================",
            query_config.query_name.c_str());
   LOG_INFO("# Runs: %u, # Result tuples: %lu", config_.num_runs,
            counter.GetCount());
-  LOG_INFO("Setup: %.2lf, IR Gen: %.2lf, Compile: %.2lf",
+  LOG_INFO("Setup: %.2lf, IR Gen: %.2lf, Optimize: %.2lf, Compile: %.2lf",
            compile_stats.setup_ms, compile_stats.ir_gen_ms,
-           compile_stats.jit_ms);
+           compile_stats.opt_ms, compile_stats.jit_ms);
+  LOG_INFO("# Functions: %lu, # Instructions: %lu",
+           compile_stats.num_functions, compile_stats.num_instructions);
   LOG_INFO("Init: %.2lf ms, Plan: %.2lf ms, TearDown: %.2lf ms",
            overall_stats.init_ms / config_.num_runs,
            overall_stats.plan_ms / config_.num_runs,
            overall_stats.tear_down_ms / config_.num_runs);
+
+  RecordStats(query_config, counter.GetCount(), compile_stats, run_ms);
+}
+
+void TPCHBenchmark::RunInterpreted(const QueryConfig &query_config) {
+  engine_ = ExecutionEngine::Interpreter;
+
+  // Construct the plan for the query
+  std::shared_ptr<planner::AbstractPlan> plan{query_config.PlanConstructor()};
+
+  std::vector<oid_t> columns;
+  plan->GetOutputColumns(columns);
+  std::vector<int> result_format(columns.size(), 0);
+
+  // Keep the plan executor from compiling the plan
+  bool codegen = FLAGS_codegen;
+  FLAGS_codegen = false;
+
+  uint64_t num_tuples = 0;
+  std::vector<double> run_ms;
+  for (uint32_t i = 0; i < config_.num_runs; i++) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
+
+    // Execute query in a transaction
+    std::vector<StatementResult> result;
+    Timer<std::ratio<1, 1000>> timer;
+    timer.Start();
+    auto status = executor::PlanExecutor::ExecutePlan(plan, txn, {}, result,
+                                                      result_format);
+    timer.Stop();
+
+    // Commit transaction
+    txn_manager.CommitTransaction(txn);
+
+    if (status.m_result != ResultType::SUCCESS) {
+      LOG_ERROR("%s: the executors failed", query_config.query_name.c_str());
+      break;
+    }
+    num_tuples = columns.empty() ? 0 : result.size() / columns.size();
+    run_ms.push_back(timer.GetDuration());
+  }
+
+  FLAGS_codegen = codegen;
+
+  LOG_INFO("%s (interpreted): ================================",
+           query_config.query_name.c_str());
+  LOG_INFO("# Runs: %lu, # Result tuples: %lu", run_ms.size(), num_tuples);
+
+  RecordStats(query_config, num_tuples, codegen::QueryCompiler::CompileStats{},
+              run_ms);
+}
+
+void TPCHBenchmark::RecordStats(
+    const QueryConfig &query_config, uint64_t num_tuples,
+    const codegen::QueryCompiler::CompileStats &compile_stats,
+    const std::vector<double> &run_ms) {
+  if (run_ms.empty()) {
+    return;
+  }
+
+  QueryStats stats;
+  stats.query_name = query_config.query_name;
+  stats.engine = engine_;
+  stats.num_tuples = num_tuples;
+  stats.compile_ms = compile_stats.TotalTime();
+  stats.compile_stats = compile_stats;
+  stats.avg_ms = 0.0;
+  stats.min_ms = run_ms[0];
+  stats.max_ms = run_ms[0];
+  for (auto ms : run_ms) {
+    stats.avg_ms += ms / run_ms.size();
+    stats.min_ms = std::min(stats.min_ms, ms);
+    stats.max_ms = std::max(stats.max_ms, ms);
+  }
+  query_stats_.push_back(stats);
+}
+
+void TPCHBenchmark::PrintStats() const {
+  LOG_INFO("TPCH (SF %.2lf, %u threads): ============================",
+           config_.scale_factor, config_.num_threads);
+  LOG_INFO("%-5s %-12s %10s %12s %10s %10s %10s", "Query", "Engine",
+           "Tuples", "Compile ms", "Avg ms", "Min ms", "Max ms");
+  for (const auto &stats : query_stats_) {
+    LOG_INFO("%-5s %-12s %10lu %12.2lf %10.2lf %10.2lf %10.2lf",
+             stats.query_name.c_str(),
+             stats.engine == ExecutionEngine::Codegen ? "codegen"
+                                                      : "interpreter",
+             stats.num_tuples, stats.compile_ms, stats.avg_ms, stats.min_ms,
+             stats.max_ms);
+  }
+
+  // A line per query and engine: query, engine, tuples, compile, avg, min
+  // and max ms, then the setup, IR generation, optimization and JIT ms of
+  // the compilation and the number of IR instructions
+  std::ofstream out("outputfile.summary");
+  for (const auto &stats : query_stats_) {
+    out << stats.query_name << " "
+        << (stats.engine == ExecutionEngine::Codegen ? "codegen"
+                                                     : "interpreter")
+        << " " << stats.num_tuples << " " << stats.compile_ms << " "
+        << stats.avg_ms << " " << stats.min_ms << " " << stats.max_ms << " "
+        << stats.compile_stats.setup_ms << " " << stats.compile_stats.ir_gen_ms
+        << " " << stats.compile_stats.opt_ms << " "
+        << stats.compile_stats.jit_ms << " "
+        << stats.compile_stats.num_instructions << "\n";
+  }
+}
+
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ScanTable(
+    TableId table_id, expression::AbstractExpression *predicate,
+    const std::vector<oid_t> &column_ids) const {
+  std::unique_ptr<planner::AbstractPlan> scan{new planner::SeqScanPlan(
+      &db_.GetTable(table_id), predicate, column_ids)};
+  if (engine_ != ExecutionEngine::Interpreter || config_.num_threads <= 1) {
+    return scan;
+  }
+
+  std::unique_ptr<planner::AbstractPlan> exchange{
+      new planner::ExchangePlan(config_.num_threads)};
+  exchange->AddChild(std::move(scan));
+  return exchange;
+}
+
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::HashJoin(
+    std::unique_ptr<planner::AbstractPlan> &&left,
+    std::unique_ptr<planner::AbstractPlan> &&right,
+    const std::vector<oid_t> &key_ids, DirectMapList &&direct_map_list,
+    const std::vector<catalog::Column> &columns) {
+  std::vector<std::unique_ptr<const expression::AbstractExpression>> hash_keys;
+  std::vector<std::unique_ptr<const expression::AbstractExpression>>
+      left_hash_keys;
+  std::vector<std::unique_ptr<const expression::AbstractExpression>>
+      right_hash_keys;
+  for (oid_t key_id : key_ids) {
+    hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, key_id));
+    left_hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, key_id));
+    right_hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 1, key_id));
+  }
+
+  // Build the hash table on the right input
+  std::unique_ptr<planner::AbstractPlan> hash_plan{
+      new planner::HashPlan(hash_keys)};
+  hash_plan->AddChild(std::move(right));
+
+  std::unique_ptr<const planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+  auto schema =
+      std::shared_ptr<const catalog::Schema>(new catalog::Schema(columns));
+  std::unique_ptr<planner::AbstractPlan> join_plan{new planner::HashJoinPlan(
+      JoinType::INNER, nullptr, std::move(projection), schema, left_hash_keys,
+      right_hash_keys)};
+
+  // From convention, build goes on right
+  join_plan->AddChild(std::move(left));
+  join_plan->AddChild(std::move(hash_plan));
+  return join_plan;
+}
+
+expression::AbstractExpression *TPCHBenchmark::DiscountedPrice(
+    oid_t price_col, oid_t discount_col) {
+  return new expression::OperatorExpression(
+      ExpressionType::OPERATOR_MULTIPLY, type::TypeId::DECIMAL,
+      new expression::TupleValueExpression(type::TypeId::DECIMAL, 0,
+                                           price_col),
+      new expression::OperatorExpression(
+          ExpressionType::OPERATOR_MINUS, type::TypeId::DECIMAL,
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetDecimalValue(1.0)),
+          new expression::TupleValueExpression(type::TypeId::DECIMAL, 0,
+                                               discount_col)));
 }
 
 //===----------------------------------------------------------------------===//
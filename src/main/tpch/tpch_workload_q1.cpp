@@ -29,8 +29,6 @@ namespace tpch {
 static constexpr int32_t _1998_08_28 = 904276800;
 
 std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ1Plan() const {
-  auto &lineitem = db_.GetTable(TableId::Lineitem);
-
   //////////////////////////////////////////////////////////////////////////////
   /// THE PREDICATE FOR THE SCAN OVER LINEITEM
   //////////////////////////////////////////////////////////////////////////////
@@ -48,8 +46,8 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ1Plan() const {
   //////////////////////////////////////////////////////////////////////////////
 
   // Lineitem scan
-  std::unique_ptr<planner::AbstractPlan> lineitem_scan{new planner::SeqScanPlan(
-      &lineitem, shipdate_predicate.release(), {8, 9, 4, 5, 6, 7})};
+  std::unique_ptr<planner::AbstractPlan> lineitem_scan = ScanTable(
+      TableId::Lineitem, shipdate_predicate.release(), {8, 9, 4, 5, 6, 7});
 
   //////////////////////////////////////////////////////////////////////////////
   /// THE AGGREGATION PLAN
@@ -59,13 +57,11 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ1Plan() const {
   planner::AggregatePlan::AggTerm agg1{
       ExpressionType::AGGREGATE_SUM,
       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 2)};
-  agg1.agg_ai.type = type::TypeId::INTEGER;
 
   // sum(l_extendedprice) as sum_base_price
   planner::AggregatePlan::AggTerm agg2{
       ExpressionType::AGGREGATE_SUM,
       new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 3)};
-  agg2.agg_ai.type = type::TypeId::DECIMAL;
 
   // sum(l_extendedprice * (1 - l_discount)) as sum_disc_price
   planner::AggregatePlan::AggTerm agg3{
@@ -80,7 +76,6 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ1Plan() const {
                   type::ValueFactory::GetDecimalValue(1.0)),
               new expression::TupleValueExpression(type::TypeId::DECIMAL,
                                                    0, 4)))};
-  agg3.agg_ai.type = type::TypeId::DECIMAL;
 
   // sum(l_extendedprice * (1 - l_discount) * (1 + l_tax))
   planner::AggregatePlan::AggTerm agg4{
@@ -107,30 +102,25 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ1Plan() const {
                       type::ValueFactory::GetDecimalValue(1.0)),
                   new expression::TupleValueExpression(
                       type::TypeId::DECIMAL, 0, 5))))};
-  agg4.agg_ai.type = type::TypeId::DECIMAL;
 
   // avg(l_quantity)
   planner::AggregatePlan::AggTerm agg5{
       ExpressionType::AGGREGATE_AVG,
       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 2)};
-  agg5.agg_ai.type = type::TypeId::DECIMAL;
 
   // avg(l_extendedprice)
   planner::AggregatePlan::AggTerm agg6{
       ExpressionType::AGGREGATE_AVG,
       new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 3)};
-  agg6.agg_ai.type = type::TypeId::DECIMAL;
 
   // avg(l_discount)
   planner::AggregatePlan::AggTerm agg7{
       ExpressionType::AGGREGATE_AVG,
       new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 4)};
-  agg7.agg_ai.type = type::TypeId::DECIMAL;
 
   // count(*)
   planner::AggregatePlan::AggTerm agg8{ExpressionType::AGGREGATE_COUNT_STAR,
                                        nullptr};
-  agg8.agg_ai.type = type::TypeId::BIGINT;
 
   auto output_schema =
       std::shared_ptr<const catalog::Schema>{new catalog::Schema(
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q10.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q10.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/limit_plan.h"
+#include "planner/order_by_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT c_custkey, c_name, sum(l_extendedprice * (1 - l_discount)) AS revenue,
+//        c_acctbal, n_name, c_address, c_phone, c_comment
+// FROM customer, orders, lineitem, nation
+// WHERE c_custkey = o_custkey AND l_orderkey = o_orderkey
+//   AND o_orderdate >= date '1993-10-01' AND o_orderdate < date '1994-01-01'
+//   AND l_returnflag = 'R' AND c_nationkey = n_nationkey
+// GROUP BY c_custkey, c_name, c_acctbal, c_phone, n_name, c_address, c_comment
+// ORDER BY revenue DESC
+// LIMIT 20;
+//
+// The customer key determines the other grouping columns, so the revenue is
+// grouped by the key alone and joined with the customers afterwards.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ10Plan()
+    const {
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE PREDICATES FOR THE SCANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto returnflag_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_EQUAL,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 8),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue('R')))};
+
+  auto orderdate_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND,
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 4),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1993-10-01")))),
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_LESSTHAN,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 4),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1994-01-01")))))};
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SCAN PLANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_orderkey, l_extendedprice, l_discount)
+  auto lineitem_scan =
+      ScanTable(TableId::Lineitem, returnflag_pred.release(), {0, 5, 6});
+
+  // (o_orderkey, o_custkey)
+  auto orders_scan =
+      ScanTable(TableId::Orders, orderdate_pred.release(), {0, 1});
+
+  // (c_nationkey, c_custkey, c_name, c_acctbal, c_address, c_phone,
+  //  c_comment)
+  auto customer_scan =
+      ScanTable(TableId::Customer, nullptr, {3, 0, 1, 5, 2, 4, 7});
+
+  // (n_nationkey, n_name)
+  auto nation_scan = ScanTable(TableId::Nation, nullptr, {0, 1});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// LINEITEM - ORDERS JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (o_custkey, l_extendedprice, l_discount)
+  auto lineitem_join =
+      HashJoin(std::move(lineitem_scan), std::move(orders_scan), {0},
+               {{0, {1, 1}}, {1, {0, 1}}, {2, {0, 2}}},
+               {{type::TypeId::INTEGER, kIntSize, "o_custkey"},
+                {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"},
+                {type::TypeId::DECIMAL, kDecimalSize, "l_discount"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// REVENUE PER CUSTOMER
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm revenue_agg{ExpressionType::AGGREGATE_SUM,
+                                              DiscountedPrice(1, 2)};
+
+  auto agg_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::INTEGER, kIntSize, "c_custkey"},
+       {type::TypeId::DECIMAL, kDecimalSize, "revenue"}})};
+
+  DirectMapList agg_dml = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> agg_project{
+      new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(agg_project), nullptr, {revenue_agg}, {0}, agg_schema,
+      AggregateType::HASH)};
+  agg_plan->AddChild(std::move(lineitem_join));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// CUSTOMER - NATION JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (c_custkey, c_name, c_acctbal, n_name, c_address, c_phone, c_comment)
+  auto customer_join = HashJoin(
+      std::move(customer_scan), std::move(nation_scan), {0},
+      {{0, {0, 1}}, {1, {0, 2}}, {2, {0, 3}}, {3, {1, 1}}, {4, {0, 4}},
+       {5, {0, 5}}, {6, {0, 6}}},
+      {{type::TypeId::INTEGER, kIntSize, "c_custkey"},
+       {type::TypeId::VARCHAR, 25, "c_name", false},
+       {type::TypeId::DECIMAL, kDecimalSize, "c_acctbal"},
+       {type::TypeId::VARCHAR, 25, "n_name", false},
+       {type::TypeId::VARCHAR, 40, "c_address", false},
+       {type::TypeId::VARCHAR, 15, "c_phone", false},
+       {type::TypeId::VARCHAR, 117, "c_comment", false}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// CUSTOMER - REVENUE JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto join_plan = HashJoin(
+      std::move(customer_join), std::move(agg_plan), {0},
+      {{0, {0, 0}}, {1, {0, 1}}, {2, {1, 1}}, {3, {0, 2}}, {4, {0, 3}},
+       {5, {0, 4}}, {6, {0, 5}}, {7, {0, 6}}},
+      {{type::TypeId::INTEGER, kIntSize, "c_custkey"},
+       {type::TypeId::VARCHAR, 25, "c_name", false},
+       {type::TypeId::DECIMAL, kDecimalSize, "revenue"},
+       {type::TypeId::DECIMAL, kDecimalSize, "c_acctbal"},
+       {type::TypeId::VARCHAR, 25, "n_name", false},
+       {type::TypeId::VARCHAR, 40, "c_address", false},
+       {type::TypeId::VARCHAR, 15, "c_phone", false},
+       {type::TypeId::VARCHAR, 117, "c_comment", false}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SORT AND LIMIT
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<planner::AbstractPlan> sort_plan{new planner::OrderByPlan{
+      {2}, {true}, {0, 1, 2, 3, 4, 5, 6, 7}}};
+  sort_plan->AddChild(std::move(join_plan));
+
+  std::unique_ptr<planner::AbstractPlan> limit_plan{
+      new planner::LimitPlan(20, 0)};
+  limit_plan->AddChild(std::move(sort_plan));
+
+  return limit_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q11.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q11.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/operator_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/nested_loop_join_plan.h"
+#include "planner/order_by_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT ps_partkey, sum(ps_supplycost * ps_availqty) AS value
+// FROM partsupp, supplier, nation
+// WHERE ps_suppkey = s_suppkey AND s_nationkey = n_nationkey
+//   AND n_name = 'GERMANY'
+// GROUP BY ps_partkey
+// HAVING sum(ps_supplycost * ps_availqty) >
+//          (SELECT sum(ps_supplycost * ps_availqty) * [FRACTION]
+//           FROM partsupp, supplier, nation
+//           WHERE ps_suppkey = s_suppkey AND s_nationkey = n_nationkey
+//             AND n_name = 'GERMANY')
+// ORDER BY value DESC;
+//
+// The nation is looked up by its key and the fraction is 0.0001 over the
+// scale factor. The single row of the total is joined with the value of every
+// part.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ11Plan()
+    const {
+  int32_t germany = db_.KeyForNation("GERMANY");
+
+  // (ps_partkey, ps_availqty, ps_supplycost) of the German suppliers
+  auto german_stock = [this, germany]() {
+    auto nation_pred = new expression::ComparisonExpression(
+        ExpressionType::COMPARE_EQUAL,
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 3),
+        new expression::ConstantValueExpression(
+            type::ValueFactory::GetIntegerValue(germany)));
+
+    // (s_suppkey)
+    auto supplier_scan = ScanTable(TableId::Supplier, nation_pred, {0});
+
+    // (ps_suppkey, ps_partkey, ps_availqty, ps_supplycost)
+    auto partsupp_scan = ScanTable(TableId::PartSupp, nullptr, {1, 0, 2, 3});
+
+    return HashJoin(std::move(partsupp_scan), std::move(supplier_scan), {0},
+                    {{0, {0, 1}}, {1, {0, 2}}, {2, {0, 3}}},
+                    {{type::TypeId::INTEGER, kIntSize, "ps_partkey"},
+                     {type::TypeId::INTEGER, kIntSize, "ps_availqty"},
+                     {type::TypeId::DECIMAL, kDecimalSize, "ps_supplycost"}});
+  };
+
+  // ps_supplycost * ps_availqty
+  auto stock_value = []() {
+    return new expression::OperatorExpression(
+        ExpressionType::OPERATOR_MULTIPLY, type::TypeId::DECIMAL,
+        new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 2),
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1));
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// VALUE PER PART
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm value_agg{ExpressionType::AGGREGATE_SUM,
+                                            stock_value()};
+
+  auto value_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema({{type::TypeId::INTEGER, kIntSize, "ps_partkey"},
+                           {type::TypeId::DECIMAL, kDecimalSize, "value"}})};
+
+  DirectMapList value_dml = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> value_project{
+      new planner::ProjectInfo(TargetList{}, std::move(value_dml))};
+  std::unique_ptr<planner::AbstractPlan> value_plan{new planner::AggregatePlan(
+      std::move(value_project), nullptr, {value_agg}, {0}, value_schema,
+      AggregateType::HASH)};
+  value_plan->AddChild(german_stock());
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// TOTAL VALUE
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm total_agg{ExpressionType::AGGREGATE_SUM,
+                                            stock_value()};
+
+  auto total_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema({{type::TypeId::DECIMAL, kDecimalSize, "total"}})};
+
+  DirectMapList total_dml = {{0, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> total_project{
+      new planner::ProjectInfo(TargetList{}, std::move(total_dml))};
+  std::unique_ptr<planner::AbstractPlan> total_plan{new planner::AggregatePlan(
+      std::move(total_project), nullptr, {total_agg}, {}, total_schema,
+      AggregateType::PLAIN)};
+  total_plan->AddChild(german_stock());
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// TOTAL - PART JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // value > total * fraction
+  std::unique_ptr<const expression::AbstractExpression> having_pred{
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_GREATERTHAN,
+          new expression::TupleValueExpression(type::TypeId::DECIMAL, 1, 1),
+          new expression::OperatorExpression(
+              ExpressionType::OPERATOR_MULTIPLY, type::TypeId::DECIMAL,
+              new expression::TupleValueExpression(type::TypeId::DECIMAL, 0,
+                                                   0),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDecimalValue(
+                      0.0001 / config_.scale_factor))))};
+
+  auto join_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema({{type::TypeId::INTEGER, kIntSize, "ps_partkey"},
+                           {type::TypeId::DECIMAL, kDecimalSize, "value"}})};
+
+  DirectMapList join_dml = {{0, {1, 0}}, {1, {1, 1}}};
+  std::unique_ptr<const planner::ProjectInfo> join_project{
+      new planner::ProjectInfo(TargetList{}, std::move(join_dml))};
+  std::unique_ptr<planner::AbstractPlan> join_plan{
+      new planner::NestedLoopJoinPlan(JoinType::INNER, std::move(having_pred),
+                                      std::move(join_project), join_schema)};
+  join_plan->AddChild(std::move(total_plan));
+  join_plan->AddChild(std::move(value_plan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SORT
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<planner::AbstractPlan> sort_plan{
+      new planner::OrderByPlan{{1}, {true}, {0, 1}}};
+  sort_plan->AddChild(std::move(join_plan));
+
+  return sort_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q12.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q12.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/case_expression.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/order_by_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT l_shipmode,
+//        sum(CASE WHEN o_orderpriority = '1-URGENT'
+//                   OR o_orderpriority = '2-HIGH'
+//            THEN 1 ELSE 0 END) AS high_line_count,
+//        sum(CASE WHEN o_orderpriority <> '1-URGENT'
+//                  AND o_orderpriority <> '2-HIGH'
+//            THEN 1 ELSE 0 END) AS low_line_count
+// FROM orders, lineitem
+// WHERE o_orderkey = l_orderkey AND l_shipmode IN ('MAIL', 'SHIP')
+//   AND l_commitdate < l_receiptdate AND l_shipdate < l_commitdate
+//   AND l_receiptdate >= date '1994-01-01'
+//   AND l_receiptdate < date '1995-01-01'
+// GROUP BY l_shipmode
+// ORDER BY l_shipmode;
+//
+// The ship modes are compared by their dictionary codes.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ12Plan()
+    const {
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE PREDICATE FOR THE SCAN
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto shipmode_pred = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_OR,
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_EQUAL,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 14),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(
+                  db_.CodeForShipMode("MAIL")))),
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_EQUAL,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 14),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(
+                  db_.CodeForShipMode("SHIP")))));
+
+  auto dates_pred = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND,
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_LESSTHAN,
+          new expression::TupleValueExpression(type::TypeId::DATE, 0, 11),
+          new expression::TupleValueExpression(type::TypeId::DATE, 0, 12)),
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_LESSTHAN,
+          new expression::TupleValueExpression(type::TypeId::DATE, 0, 10),
+          new expression::TupleValueExpression(type::TypeId::DATE, 0, 11)));
+
+  auto receiptdate_pred = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND,
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+          new expression::TupleValueExpression(type::TypeId::DATE, 0, 12),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetDateValue(ConvertDate("1994-01-01")))),
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_LESSTHAN,
+          new expression::TupleValueExpression(type::TypeId::DATE, 0, 12),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetDateValue(ConvertDate("1995-01-01")))));
+
+  auto lineitem_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND, shipmode_pred,
+          new expression::ConjunctionExpression(
+              ExpressionType::CONJUNCTION_AND, dates_pred,
+              receiptdate_pred))};
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SCAN PLANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_orderkey, l_shipmode)
+  auto lineitem_scan =
+      ScanTable(TableId::Lineitem, lineitem_pred.release(), {0, 14});
+
+  // (o_orderkey, o_orderpriority)
+  auto orders_scan = ScanTable(TableId::Orders, nullptr, {0, 5});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// ORDERS - LINEITEM JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_shipmode, o_orderpriority)
+  auto join_plan =
+      HashJoin(std::move(orders_scan), std::move(lineitem_scan), {0},
+               {{0, {1, 1}}, {1, {0, 1}}},
+               {{type::TypeId::INTEGER, kIntSize, "l_shipmode"},
+                {type::TypeId::VARCHAR, 15, "o_orderpriority", false}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// AGGREGATION
+  //////////////////////////////////////////////////////////////////////////////
+
+  // One for the orders of high priority, zero for the others, or the inverse
+  auto priority_count = [](bool high) {
+    std::vector<expression::CaseExpression::WhenClause> clauses;
+    clauses.push_back(expression::CaseExpression::WhenClause{
+        expression::CaseExpression::AbsExprPtr{
+            new expression::ConjunctionExpression(
+                ExpressionType::CONJUNCTION_OR,
+                new expression::ComparisonExpression(
+                    ExpressionType::COMPARE_EQUAL,
+                    new expression::TupleValueExpression(type::TypeId::VARCHAR,
+                                                         0, 1),
+                    new expression::ConstantValueExpression(
+                        type::ValueFactory::GetVarcharValue("1-URGENT"))),
+                new expression::ComparisonExpression(
+                    ExpressionType::COMPARE_EQUAL,
+                    new expression::TupleValueExpression(type::TypeId::VARCHAR,
+                                                         0, 1),
+                    new expression::ConstantValueExpression(
+                        type::ValueFactory::GetVarcharValue("2-HIGH"))))},
+        expression::CaseExpression::AbsExprPtr{
+            new expression::ConstantValueExpression(
+                type::ValueFactory::GetIntegerValue(high ? 1 : 0))}});
+    return new expression::CaseExpression(
+        type::TypeId::INTEGER, clauses,
+        expression::CaseExpression::AbsExprPtr{
+            new expression::ConstantValueExpression(
+                type::ValueFactory::GetIntegerValue(high ? 0 : 1))});
+  };
+
+  planner::AggregatePlan::AggTerm high_agg{ExpressionType::AGGREGATE_SUM,
+                                           priority_count(true)};
+  planner::AggregatePlan::AggTerm low_agg{ExpressionType::AGGREGATE_SUM,
+                                          priority_count(false)};
+
+  auto agg_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::INTEGER, kIntSize, "l_shipmode"},
+       {type::TypeId::INTEGER, kIntSize, "high_line_count"},
+       {type::TypeId::INTEGER, kIntSize, "low_line_count"}})};
+
+  DirectMapList agg_dml = {{0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}};
+  std::unique_ptr<const planner::ProjectInfo> agg_project{
+      new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(agg_project), nullptr, {high_agg, low_agg}, {0}, agg_schema,
+      AggregateType::HASH)};
+  agg_plan->AddChild(std::move(join_plan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SORT
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<planner::AbstractPlan> sort_plan{
+      new planner::OrderByPlan{{0}, {false}, {0, 1, 2}}};
+  sort_plan->AddChild(std::move(agg_plan));
+
+  return sort_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
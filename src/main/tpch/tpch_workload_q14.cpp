@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q14.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q14.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/case_expression.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/operator_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/projection_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT 100.00 * sum(CASE WHEN p_type LIKE 'PROMO%'
+//                     THEN l_extendedprice * (1 - l_discount) ELSE 0 END) /
+//        sum(l_extendedprice * (1 - l_discount)) AS promo_revenue
+// FROM lineitem, part
+// WHERE l_partkey = p_partkey
+//   AND l_shipdate >= date '1995-09-01' AND l_shipdate < date '1995-10-01';
+//
+// The prefix match is the range of types from 'PROMO' up to 'PROMP'.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ14Plan()
+    const {
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE PREDICATE FOR THE SCAN
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto shipdate_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND,
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 10),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1995-09-01")))),
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_LESSTHAN,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 10),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1995-10-01")))))};
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SCAN PLANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_partkey, l_extendedprice, l_discount)
+  auto lineitem_scan =
+      ScanTable(TableId::Lineitem, shipdate_pred.release(), {1, 5, 6});
+
+  // (p_partkey, p_type)
+  auto part_scan = ScanTable(TableId::Part, nullptr, {0, 4});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// LINEITEM - PART JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (p_type, l_extendedprice, l_discount)
+  auto join_plan =
+      HashJoin(std::move(lineitem_scan), std::move(part_scan), {0},
+               {{0, {1, 1}}, {1, {0, 1}}, {2, {0, 2}}},
+               {{type::TypeId::VARCHAR, 25, "p_type", true},
+                {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"},
+                {type::TypeId::DECIMAL, kDecimalSize, "l_discount"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// AGGREGATION
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::vector<expression::CaseExpression::WhenClause> promo_clauses;
+  promo_clauses.push_back(expression::CaseExpression::WhenClause{
+      expression::CaseExpression::AbsExprPtr{
+          new expression::ConjunctionExpression(
+              ExpressionType::CONJUNCTION_AND,
+              new expression::ComparisonExpression(
+                  ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+                  new expression::TupleValueExpression(type::TypeId::VARCHAR,
+                                                       0, 0),
+                  new expression::ConstantValueExpression(
+                      type::ValueFactory::GetVarcharValue("PROMO"))),
+              new expression::ComparisonExpression(
+                  ExpressionType::COMPARE_LESSTHAN,
+                  new expression::TupleValueExpression(type::TypeId::VARCHAR,
+                                                       0, 0),
+                  new expression::ConstantValueExpression(
+                      type::ValueFactory::GetVarcharValue("PROMP"))))},
+      expression::CaseExpression::AbsExprPtr{DiscountedPrice(1, 2)}});
+
+  planner::AggregatePlan::AggTerm promo_agg{
+      ExpressionType::AGGREGATE_SUM,
+      new expression::CaseExpression(
+          type::TypeId::DECIMAL, promo_clauses,
+          expression::CaseExpression::AbsExprPtr{
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDecimalValue(0))})};
+  planner::AggregatePlan::AggTerm revenue_agg{ExpressionType::AGGREGATE_SUM,
+                                              DiscountedPrice(1, 2)};
+
+  auto agg_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::DECIMAL, kDecimalSize, "promo"},
+       {type::TypeId::DECIMAL, kDecimalSize, "revenue"}})};
+
+  DirectMapList agg_dml = {{0, {1, 0}}, {1, {1, 1}}};
+  std::unique_ptr<const planner::ProjectInfo> agg_project{
+      new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(agg_project), nullptr, {promo_agg, revenue_agg}, {},
+      agg_schema, AggregateType::PLAIN)};
+  agg_plan->AddChild(std::move(join_plan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE PERCENTAGE
+  //////////////////////////////////////////////////////////////////////////////
+
+  TargetList percent_tl;
+  percent_tl.emplace_back(
+      0, planner::DerivedAttribute{new expression::OperatorExpression(
+             ExpressionType::OPERATOR_DIVIDE, type::TypeId::DECIMAL,
+             new expression::OperatorExpression(
+                 ExpressionType::OPERATOR_MULTIPLY, type::TypeId::DECIMAL,
+                 new expression::ConstantValueExpression(
+                     type::ValueFactory::GetDecimalValue(100)),
+                 new expression::TupleValueExpression(type::TypeId::DECIMAL, 0,
+                                                      0)),
+             new expression::TupleValueExpression(type::TypeId::DECIMAL, 0,
+                                                  1))});
+  std::unique_ptr<const planner::ProjectInfo> percent_project{
+      new planner::ProjectInfo(std::move(percent_tl), DirectMapList{})};
+  auto percent_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema(
+          {{type::TypeId::DECIMAL, kDecimalSize, "promo_revenue"}})};
+  std::unique_ptr<planner::AbstractPlan> percent_plan{
+      new planner::ProjectionPlan(std::move(percent_project), percent_schema)};
+  percent_plan->AddChild(std::move(agg_plan));
+
+  return percent_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
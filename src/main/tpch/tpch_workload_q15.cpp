@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q15.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q15.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/nested_loop_join_plan.h"
+#include "planner/order_by_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// CREATE VIEW revenue0 (supplier_no, total_revenue) AS
+//   SELECT l_suppkey, sum(l_extendedprice * (1 - l_discount))
+//   FROM lineitem
+//   WHERE l_shipdate >= date '1996-01-01' AND l_shipdate < date '1996-04-01'
+//   GROUP BY l_suppkey;
+//
+// SELECT s_suppkey, s_name, s_address, s_phone, total_revenue
+// FROM supplier, revenue0
+// WHERE s_suppkey = supplier_no
+//   AND total_revenue = (SELECT max(total_revenue) FROM revenue0)
+// ORDER BY s_suppkey;
+//
+// The view is planned twice. The single row of the largest revenue is joined
+// with the revenue of every supplier.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ15Plan()
+    const {
+  // (supplier_no, total_revenue)
+  auto revenue = [this]() {
+    auto shipdate_pred = new expression::ConjunctionExpression(
+        ExpressionType::CONJUNCTION_AND,
+        new expression::ComparisonExpression(
+            ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+            new expression::TupleValueExpression(type::TypeId::DATE, 0, 10),
+            new expression::ConstantValueExpression(
+                type::ValueFactory::GetDateValue(ConvertDate("1996-01-01")))),
+        new expression::ComparisonExpression(
+            ExpressionType::COMPARE_LESSTHAN,
+            new expression::TupleValueExpression(type::TypeId::DATE, 0, 10),
+            new expression::ConstantValueExpression(
+                type::ValueFactory::GetDateValue(ConvertDate("1996-04-01")))));
+
+    // (l_suppkey, l_extendedprice, l_discount)
+    auto lineitem_scan =
+        ScanTable(TableId::Lineitem, shipdate_pred, {2, 5, 6});
+
+    planner::AggregatePlan::AggTerm revenue_agg{ExpressionType::AGGREGATE_SUM,
+                                                DiscountedPrice(1, 2)};
+
+    auto agg_schema = std::shared_ptr<const catalog::Schema>{
+        new catalog::Schema(
+            {{type::TypeId::INTEGER, kIntSize, "supplier_no"},
+             {type::TypeId::DECIMAL, kDecimalSize, "total_revenue"}})};
+
+    DirectMapList agg_dml = {{0, {0, 0}}, {1, {1, 0}}};
+    std::unique_ptr<const planner::ProjectInfo> agg_project{
+        new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+    std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+        std::move(agg_project), nullptr, {revenue_agg}, {0}, agg_schema,
+        AggregateType::HASH)};
+    agg_plan->AddChild(std::move(lineitem_scan));
+    return agg_plan;
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE LARGEST REVENUE
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm max_agg{
+      ExpressionType::AGGREGATE_MAX,
+      new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 1)};
+
+  auto max_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::DECIMAL, kDecimalSize, "max_revenue"}})};
+
+  DirectMapList max_dml = {{0, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> max_project{
+      new planner::ProjectInfo(TargetList{}, std::move(max_dml))};
+  std::unique_ptr<planner::AbstractPlan> max_plan{new planner::AggregatePlan(
+      std::move(max_project), nullptr, {max_agg}, {}, max_schema,
+      AggregateType::PLAIN)};
+  max_plan->AddChild(revenue());
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SUPPLIERS WITH THE LARGEST REVENUE
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<const expression::AbstractExpression> max_pred{
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_EQUAL,
+          new expression::TupleValueExpression(type::TypeId::DECIMAL, 1, 1),
+          new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 0))};
+
+  auto top_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::INTEGER, kIntSize, "supplier_no"},
+       {type::TypeId::DECIMAL, kDecimalSize, "total_revenue"}})};
+
+  DirectMapList top_dml = {{0, {1, 0}}, {1, {1, 1}}};
+  std::unique_ptr<const planner::ProjectInfo> top_project{
+      new planner::ProjectInfo(TargetList{}, std::move(top_dml))};
+  std::unique_ptr<planner::AbstractPlan> top_plan{
+      new planner::NestedLoopJoinPlan(JoinType::INNER, std::move(max_pred),
+                                      std::move(top_project), top_schema)};
+  top_plan->AddChild(std::move(max_plan));
+  top_plan->AddChild(revenue());
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SUPPLIER - REVENUE JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (s_suppkey, s_name, s_address, s_phone)
+  auto supplier_scan = ScanTable(TableId::Supplier, nullptr, {0, 1, 2, 4});
+
+  auto join_plan = HashJoin(
+      std::move(supplier_scan), std::move(top_plan), {0},
+      {{0, {0, 0}}, {1, {0, 1}}, {2, {0, 2}}, {3, {0, 3}}, {4, {1, 1}}},
+      {{type::TypeId::INTEGER, kIntSize, "s_suppkey"},
+       {type::TypeId::VARCHAR, 25, "s_name", false},
+       {type::TypeId::VARCHAR, 40, "s_address", false},
+       {type::TypeId::VARCHAR, 15, "s_phone", false},
+       {type::TypeId::DECIMAL, kDecimalSize, "total_revenue"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SORT
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<planner::AbstractPlan> sort_plan{
+      new planner::OrderByPlan{{0}, {false}, {0, 1, 2, 3, 4}}};
+  sort_plan->AddChild(std::move(join_plan));
+
+  return sort_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q17.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q17.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/case_expression.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/operator_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/projection_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT sum(l_extendedprice) / 7.0 AS avg_yearly
+// FROM lineitem, part
+// WHERE p_partkey = l_partkey AND p_brand = 'Brand#23'
+//   AND p_container = 'MED BOX'
+//   AND l_quantity < (SELECT 0.2 * avg(l_quantity) FROM lineitem
+//                     WHERE l_partkey = p_partkey);
+//
+// The correlated average is grouped by the part key, over the lineitems of
+// the chosen parts alone, and joined back with those lineitems. The brand and
+// the container are compared by their dictionary codes.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ17Plan()
+    const {
+  // (l_partkey, l_quantity, l_extendedprice) of the chosen parts
+  auto part_lineitems = [this]() {
+    auto part_pred = new expression::ConjunctionExpression(
+        ExpressionType::CONJUNCTION_AND,
+        new expression::ComparisonExpression(
+            ExpressionType::COMPARE_EQUAL,
+            new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 3),
+            new expression::ConstantValueExpression(
+                type::ValueFactory::GetIntegerValue(
+                    db_.CodeForBrand("Brand#23")))),
+        new expression::ComparisonExpression(
+            ExpressionType::COMPARE_EQUAL,
+            new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 6),
+            new expression::ConstantValueExpression(
+                type::ValueFactory::GetIntegerValue(
+                    db_.CodeForContainer("MED BOX")))));
+
+    // (p_partkey)
+    auto part_scan = ScanTable(TableId::Part, part_pred, {0});
+
+    // (l_partkey, l_quantity, l_extendedprice)
+    auto lineitem_scan = ScanTable(TableId::Lineitem, nullptr, {1, 4, 5});
+
+    return HashJoin(
+        std::move(lineitem_scan), std::move(part_scan), {0},
+        {{0, {0, 0}}, {1, {0, 1}}, {2, {0, 2}}},
+        {{type::TypeId::INTEGER, kIntSize, "l_partkey"},
+         {type::TypeId::INTEGER, kIntSize, "l_quantity"},
+         {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"}});
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// AVERAGE QUANTITY PER PART
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm quantity_agg{
+      ExpressionType::AGGREGATE_AVG,
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)};
+
+  auto quantity_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema(
+          {{type::TypeId::INTEGER, kIntSize, "l_partkey"},
+           {type::TypeId::DECIMAL, kDecimalSize, "avg_quantity"}})};
+
+  DirectMapList quantity_dml = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> quantity_project{
+      new planner::ProjectInfo(TargetList{}, std::move(quantity_dml))};
+  std::unique_ptr<planner::AbstractPlan> quantity_plan{
+      new planner::AggregatePlan(std::move(quantity_project), nullptr,
+                                 {quantity_agg}, {0}, quantity_schema,
+                                 AggregateType::HASH)};
+  quantity_plan->AddChild(part_lineitems());
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// LINEITEM - AVERAGE JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_quantity, l_extendedprice, avg_quantity)
+  auto join_plan =
+      HashJoin(part_lineitems(), std::move(quantity_plan), {0},
+               {{0, {0, 1}}, {1, {0, 2}}, {2, {1, 1}}},
+               {{type::TypeId::INTEGER, kIntSize, "l_quantity"},
+                {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"},
+                {type::TypeId::DECIMAL, kDecimalSize, "avg_quantity"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// AGGREGATION
+  //////////////////////////////////////////////////////////////////////////////
+
+  // The price of the lineitems below a fifth of the average quantity
+  std::vector<expression::CaseExpression::WhenClause> small_clauses;
+  small_clauses.push_back(expression::CaseExpression::WhenClause{
+      expression::CaseExpression::AbsExprPtr{
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_LESSTHAN,
+              new expression::TupleValueExpression(type::TypeId::INTEGER, 0,
+                                                   0),
+              new expression::OperatorExpression(
+                  ExpressionType::OPERATOR_MULTIPLY, type::TypeId::DECIMAL,
+                  new expression::ConstantValueExpression(
+                      type::ValueFactory::GetDecimalValue(0.2)),
+                  new expression::TupleValueExpression(type::TypeId::DECIMAL,
+                                                       0, 2)))},
+      expression::CaseExpression::AbsExprPtr{
+          new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 1)}});
+
+  planner::AggregatePlan::AggTerm price_agg{
+      ExpressionType::AGGREGATE_SUM,
+      new expression::CaseExpression(
+          type::TypeId::DECIMAL, small_clauses,
+          expression::CaseExpression::AbsExprPtr{
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDecimalValue(0))})};
+
+  auto agg_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::DECIMAL, kDecimalSize, "price"}})};
+
+  DirectMapList agg_dml = {{0, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> agg_project{
+      new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(agg_project), nullptr, {price_agg}, {}, agg_schema,
+      AggregateType::PLAIN)};
+  agg_plan->AddChild(std::move(join_plan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE YEARLY AVERAGE
+  //////////////////////////////////////////////////////////////////////////////
+
+  TargetList yearly_tl;
+  yearly_tl.emplace_back(
+      0, planner::DerivedAttribute{new expression::OperatorExpression(
+             ExpressionType::OPERATOR_DIVIDE, type::TypeId::DECIMAL,
+             new expression::TupleValueExpression(type::TypeId::DECIMAL, 0,
+                                                  0),
+             new expression::ConstantValueExpression(
+                 type::ValueFactory::GetDecimalValue(7.0)))});
+  std::unique_ptr<const planner::ProjectInfo> yearly_project{
+      new planner::ProjectInfo(std::move(yearly_tl), DirectMapList{})};
+  auto yearly_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema(
+          {{type::TypeId::DECIMAL, kDecimalSize, "avg_yearly"}})};
+  std::unique_ptr<planner::AbstractPlan> yearly_plan{
+      new planner::ProjectionPlan(std::move(yearly_project), yearly_schema)};
+  yearly_plan->AddChild(std::move(agg_plan));
+
+  return yearly_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q18.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q18.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/limit_plan.h"
+#include "planner/order_by_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT c_name, c_custkey, o_orderkey, o_orderdate, o_totalprice,
+//        sum(l_quantity)
+// FROM customer, orders, lineitem
+// WHERE o_orderkey IN (SELECT l_orderkey FROM lineitem
+//                      GROUP BY l_orderkey HAVING sum(l_quantity) > 300)
+//   AND c_custkey = o_custkey AND o_orderkey = l_orderkey
+// GROUP BY c_name, c_custkey, o_orderkey, o_orderdate, o_totalprice
+// ORDER BY o_totalprice DESC, o_orderdate
+// LIMIT 100;
+//
+// Every group holds the lineitems of one order, so the sum of the quantities
+// is the one of the subquery and the outer grouping is left out.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ18Plan()
+    const {
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SCAN PLANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_orderkey, l_quantity)
+  auto lineitem_scan = ScanTable(TableId::Lineitem, nullptr, {0, 4});
+
+  // (o_orderkey, o_custkey, o_orderdate, o_totalprice)
+  auto orders_scan = ScanTable(TableId::Orders, nullptr, {0, 1, 4, 3});
+
+  // (c_custkey, c_name)
+  auto customer_scan = ScanTable(TableId::Customer, nullptr, {0, 1});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE LARGE ORDERS
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm quantity_agg{
+      ExpressionType::AGGREGATE_SUM,
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)};
+
+  // sum(l_quantity) > 300
+  std::unique_ptr<const expression::AbstractExpression> having_pred{
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_GREATERTHAN,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 1, 0),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(300)))};
+
+  auto large_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema({{type::TypeId::INTEGER, kIntSize, "l_orderkey"},
+                           {type::TypeId::INTEGER, kIntSize, "sum_quantity"}})};
+
+  DirectMapList large_dml = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> large_project{
+      new planner::ProjectInfo(TargetList{}, std::move(large_dml))};
+  std::unique_ptr<planner::AbstractPlan> large_orders{
+      new planner::AggregatePlan(std::move(large_project),
+                                 std::move(having_pred), {quantity_agg}, {0},
+                                 large_schema, AggregateType::HASH)};
+  large_orders->AddChild(std::move(lineitem_scan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE JOINS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (o_custkey, o_orderkey, o_orderdate, o_totalprice, sum_quantity)
+  auto orders_join = HashJoin(
+      std::move(orders_scan), std::move(large_orders), {0},
+      {{0, {0, 1}}, {1, {0, 0}}, {2, {0, 2}}, {3, {0, 3}}, {4, {1, 1}}},
+      {{type::TypeId::INTEGER, kIntSize, "o_custkey"},
+       {type::TypeId::INTEGER, kIntSize, "o_orderkey"},
+       {type::TypeId::DATE, kDateSize, "o_orderdate"},
+       {type::TypeId::DECIMAL, kDecimalSize, "o_totalprice"},
+       {type::TypeId::INTEGER, kIntSize, "sum_quantity"}});
+
+  // (c_name, c_custkey, o_orderkey, o_orderdate, o_totalprice, sum_quantity)
+  auto join_plan = HashJoin(
+      std::move(orders_join), std::move(customer_scan), {0},
+      {{0, {1, 1}}, {1, {0, 0}}, {2, {0, 1}}, {3, {0, 2}}, {4, {0, 3}},
+       {5, {0, 4}}},
+      {{type::TypeId::VARCHAR, 25, "c_name", false},
+       {type::TypeId::INTEGER, kIntSize, "c_custkey"},
+       {type::TypeId::INTEGER, kIntSize, "o_orderkey"},
+       {type::TypeId::DATE, kDateSize, "o_orderdate"},
+       {type::TypeId::DECIMAL, kDecimalSize, "o_totalprice"},
+       {type::TypeId::INTEGER, kIntSize, "sum_quantity"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SORT AND LIMIT
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<planner::AbstractPlan> sort_plan{new planner::OrderByPlan{
+      {4, 3}, {true, false}, {0, 1, 2, 3, 4, 5}}};
+  sort_plan->AddChild(std::move(join_plan));
+
+  std::unique_ptr<planner::AbstractPlan> limit_plan{
+      new planner::LimitPlan(100, 0)};
+  limit_plan->AddChild(std::move(sort_plan));
+
+  return limit_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q19.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q19.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/case_expression.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+namespace {
+
+// The column of the input equals the INTEGER value
+expression::AbstractExpression *ColumnEquals(oid_t col_id, int32_t value) {
+  return new expression::ComparisonExpression(
+      ExpressionType::COMPARE_EQUAL,
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, col_id),
+      new expression::ConstantValueExpression(
+          type::ValueFactory::GetIntegerValue(value)));
+}
+
+// The column of the input equals one of the INTEGER values
+expression::AbstractExpression *ColumnIn(oid_t col_id,
+                                         const std::vector<int32_t> &values) {
+  expression::AbstractExpression *in = ColumnEquals(col_id, values[0]);
+  for (uint32_t i = 1; i < values.size(); i++) {
+    in = new expression::ConjunctionExpression(ExpressionType::CONJUNCTION_OR,
+                                               in,
+                                               ColumnEquals(col_id, values[i]));
+  }
+  return in;
+}
+
+// The INTEGER column of the input is in [low, high]
+expression::AbstractExpression *ColumnBetween(oid_t col_id, int32_t low,
+                                              int32_t high) {
+  return new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND,
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0,
+                                               col_id),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(low))),
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_LESSTHANOREQUALTO,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0,
+                                               col_id),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(high))));
+}
+
+expression::AbstractExpression *And(expression::AbstractExpression *left,
+                                    expression::AbstractExpression *right) {
+  return new expression::ConjunctionExpression(ExpressionType::CONJUNCTION_AND,
+                                               left, right);
+}
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// SELECT sum(l_extendedprice * (1 - l_discount)) AS revenue
+// FROM lineitem, part
+// WHERE (p_partkey = l_partkey AND p_brand = 'Brand#12'
+//        AND p_container IN ('SM CASE', 'SM BOX', 'SM PACK', 'SM PKG')
+//        AND l_quantity >= 1 AND l_quantity <= 1 + 10
+//        AND p_size BETWEEN 1 AND 5
+//        AND l_shipmode IN ('AIR', 'AIR REG')
+//        AND l_shipinstruct = 'DELIVER IN PERSON')
+//    OR (p_partkey = l_partkey AND p_brand = 'Brand#23'
+//        AND p_container IN ('MED BAG', 'MED BOX', 'MED PKG', 'MED PACK')
+//        AND l_quantity >= 10 AND l_quantity <= 10 + 10
+//        AND p_size BETWEEN 1 AND 10
+//        AND l_shipmode IN ('AIR', 'AIR REG')
+//        AND l_shipinstruct = 'DELIVER IN PERSON')
+//    OR (p_partkey = l_partkey AND p_brand = 'Brand#34'
+//        AND p_container IN ('LG CASE', 'LG BOX', 'LG PACK', 'LG PKG')
+//        AND l_quantity >= 20 AND l_quantity <= 20 + 10
+//        AND p_size BETWEEN 1 AND 15
+//        AND l_shipmode IN ('AIR', 'AIR REG')
+//        AND l_shipinstruct = 'DELIVER IN PERSON');
+//
+// The conditions shared by the branches filter the scans, and the branches
+// pick the revenue summed of the joined lineitems. The generated data names
+// the second ship mode 'REG AIR'. All strings are compared by their
+// dictionary codes.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ19Plan()
+    const {
+  auto brand = [this](const std::string &name) {
+    return static_cast<int32_t>(db_.CodeForBrand(name));
+  };
+  auto containers = [this](const std::vector<std::string> &names) {
+    std::vector<int32_t> codes;
+    for (const auto &name : names) {
+      codes.push_back(static_cast<int32_t>(db_.CodeForContainer(name)));
+    }
+    return codes;
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE PREDICATES FOR THE SCANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto lineitem_pred = std::unique_ptr<expression::AbstractExpression>{
+      And(ColumnIn(14, {static_cast<int32_t>(db_.CodeForShipMode("AIR")),
+                        static_cast<int32_t>(db_.CodeForShipMode("REG AIR"))}),
+          And(ColumnEquals(13, static_cast<int32_t>(db_.CodeForShipInstruct(
+                                   "DELIVER IN PERSON"))),
+              ColumnBetween(4, 1, 30)))};
+
+  auto part_pred = std::unique_ptr<expression::AbstractExpression>{
+      And(ColumnBetween(5, 1, 15),
+          ColumnIn(3, {brand("Brand#12"), brand("Brand#23"),
+                       brand("Brand#34")}))};
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SCAN PLANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_partkey, l_quantity, l_extendedprice, l_discount)
+  auto lineitem_scan =
+      ScanTable(TableId::Lineitem, lineitem_pred.release(), {1, 4, 5, 6});
+
+  // (p_partkey, p_brand, p_container, p_size)
+  auto part_scan = ScanTable(TableId::Part, part_pred.release(), {0, 3, 6, 5});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// LINEITEM - PART JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_quantity, l_extendedprice, l_discount, p_brand, p_container, p_size)
+  auto join_plan = HashJoin(
+      std::move(lineitem_scan), std::move(part_scan), {0},
+      {{0, {0, 1}}, {1, {0, 2}}, {2, {0, 3}}, {3, {1, 1}}, {4, {1, 2}},
+       {5, {1, 3}}},
+      {{type::TypeId::INTEGER, kIntSize, "l_quantity"},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_discount"},
+       {type::TypeId::INTEGER, kIntSize, "p_brand"},
+       {type::TypeId::INTEGER, kIntSize, "p_container"},
+       {type::TypeId::INTEGER, kIntSize, "p_size"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// AGGREGATION
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto small = And(
+      ColumnEquals(3, brand("Brand#12")),
+      And(ColumnIn(4, containers({"SM CASE", "SM BOX", "SM PACK", "SM PKG"})),
+          And(ColumnBetween(0, 1, 11), ColumnBetween(5, 1, 5))));
+  auto medium = And(
+      ColumnEquals(3, brand("Brand#23")),
+      And(ColumnIn(4,
+                   containers({"MED BAG", "MED BOX", "MED PKG", "MED PACK"})),
+          And(ColumnBetween(0, 10, 20), ColumnBetween(5, 1, 10))));
+  auto large = And(
+      ColumnEquals(3, brand("Brand#34")),
+      And(ColumnIn(4, containers({"LG CASE", "LG BOX", "LG PACK", "LG PKG"})),
+          And(ColumnBetween(0, 20, 30), ColumnBetween(5, 1, 15))));
+
+  std::vector<expression::CaseExpression::WhenClause> revenue_clauses;
+  revenue_clauses.push_back(expression::CaseExpression::WhenClause{
+      expression::CaseExpression::AbsExprPtr{
+          new expression::ConjunctionExpression(
+              ExpressionType::CONJUNCTION_OR, small,
+              new expression::ConjunctionExpression(
+                  ExpressionType::CONJUNCTION_OR, medium, large))},
+      expression::CaseExpression::AbsExprPtr{DiscountedPrice(1, 2)}});
+
+  planner::AggregatePlan::AggTerm revenue_agg{
+      ExpressionType::AGGREGATE_SUM,
+      new expression::CaseExpression(
+          type::TypeId::DECIMAL, revenue_clauses,
+          expression::CaseExpression::AbsExprPtr{
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDecimalValue(0))})};
+
+  auto agg_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::DECIMAL, kDecimalSize, "revenue"}})};
+
+  DirectMapList agg_dml = {{0, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> agg_project{
+      new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(agg_project), nullptr, {revenue_agg}, {}, agg_schema,
+      AggregateType::PLAIN)};
+  agg_plan->AddChild(std::move(join_plan));
+
+  return agg_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
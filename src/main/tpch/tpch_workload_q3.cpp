@@ -31,10 +31,6 @@ namespace tpch {
 static int32_t _1995_03_10 = 794811600;
 
 std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ3Plan() const {
-  auto &lineitem = db_.GetTable(TableId::Lineitem);
-  auto &customer = db_.GetTable(TableId::Customer);
-  auto &orders = db_.GetTable(TableId::Orders);
-
   //////////////////////////////////////////////////////////////////////////////                                                              [3136/4535]
   /// THE PREDICATE FOR THE SCAN OVER LINEITEM
   //////////////////////////////////////////////////////////////////////////////
@@ -64,12 +60,12 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ3Plan() const {
   //////////////////////////////////////////////////////////////////////////////
 
   // The table scans
-  std::unique_ptr<planner::AbstractPlan> lineitem_scan{
-      new planner::SeqScanPlan(&lineitem, shipdate_pred.release(), {0,5,6})};
-  std::unique_ptr<planner::AbstractPlan> order_scan{
-      new planner::SeqScanPlan(&orders, orderdate_pred.release(), {0,1,4,7})};
-  std::unique_ptr<planner::AbstractPlan> customer_scan{
-      new planner::SeqScanPlan(&customer, mktsegment_pred.release(), {0})};
+  std::unique_ptr<planner::AbstractPlan> lineitem_scan =
+      ScanTable(TableId::Lineitem, shipdate_pred.release(), {0, 5, 6});
+  std::unique_ptr<planner::AbstractPlan> order_scan =
+      ScanTable(TableId::Orders, orderdate_pred.release(), {0, 1, 4, 7});
+  std::unique_ptr<planner::AbstractPlan> customer_scan =
+      ScanTable(TableId::Customer, mktsegment_pred.release(), {0});
 
   //////////////////////////////////////////////////////////////////////////////
   /// REARRANGE ORDERS COLUMNS FOR JOIN
@@ -120,7 +116,7 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ3Plan() const {
 
   std::vector<std::unique_ptr<const expression::AbstractExpression>> left_hash_keys;
   left_hash_keys.emplace_back(
-      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1));
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0));
 
   std::vector<std::unique_ptr<const expression::AbstractExpression>> right_hash_keys;
   right_hash_keys.emplace_back(
@@ -165,7 +161,7 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ3Plan() const {
 
   std::vector<std::unique_ptr<const expression::AbstractExpression>> left_hash_keys2;
   left_hash_keys2.emplace_back(
-      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1));
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0));
 
   std::vector<std::unique_ptr<const expression::AbstractExpression>> right_hash_keys2;
   right_hash_keys2.emplace_back(
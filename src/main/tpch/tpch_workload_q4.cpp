@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q4.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q4.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/order_by_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT o_orderpriority, count(*) AS order_count
+// FROM orders
+// WHERE o_orderdate >= date '1993-07-01'
+//   AND o_orderdate < date '1993-10-01'
+//   AND EXISTS (SELECT * FROM lineitem
+//               WHERE l_orderkey = o_orderkey AND l_commitdate < l_receiptdate)
+// GROUP BY o_orderpriority
+// ORDER BY o_orderpriority;
+//
+// The EXISTS is a join with the distinct keys of the late lineitems.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ4Plan() const {
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE PREDICATES FOR THE SCANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto commitdate_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_LESSTHAN,
+          new expression::TupleValueExpression(type::TypeId::DATE, 0, 11),
+          new expression::TupleValueExpression(type::TypeId::DATE, 0, 12))};
+
+  auto orderdate_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND,
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 4),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1993-07-01")))),
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_LESSTHAN,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 4),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1993-10-01")))))};
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SCAN PLANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_orderkey)
+  auto lineitem_scan =
+      ScanTable(TableId::Lineitem, commitdate_pred.release(), {0});
+
+  // (o_orderkey, o_orderpriority)
+  auto orders_scan =
+      ScanTable(TableId::Orders, orderdate_pred.release(), {0, 5});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE DISTINCT KEYS OF THE LATE LINEITEMS
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm late_count{
+      ExpressionType::AGGREGATE_COUNT_STAR, nullptr};
+
+  auto late_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema({{type::TypeId::INTEGER, kIntSize, "l_orderkey"}})};
+
+  DirectMapList late_dml = {{0, {0, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> late_project{
+      new planner::ProjectInfo(TargetList{}, std::move(late_dml))};
+  std::unique_ptr<planner::AbstractPlan> late_orders{new planner::AggregatePlan(
+      std::move(late_project), nullptr, {late_count}, {0}, late_schema,
+      AggregateType::HASH)};
+  late_orders->AddChild(std::move(lineitem_scan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// ORDERS - LINEITEM JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto join_plan =
+      HashJoin(std::move(orders_scan), std::move(late_orders), {0},
+               {{0, {0, 1}}},
+               {{type::TypeId::VARCHAR, 15, "o_orderpriority", false}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// AGGREGATION
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm order_count{
+      ExpressionType::AGGREGATE_COUNT_STAR, nullptr};
+
+  auto agg_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::VARCHAR, 15, "o_orderpriority", false},
+       {type::TypeId::BIGINT, kBigIntSize, "order_count"}})};
+
+  DirectMapList agg_dml = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> agg_project{
+      new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(agg_project), nullptr, {order_count}, {0}, agg_schema,
+      AggregateType::HASH)};
+  agg_plan->AddChild(std::move(join_plan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SORT
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<planner::AbstractPlan> sort_plan{
+      new planner::OrderByPlan{{0}, {false}, {0, 1}}};
+  sort_plan->AddChild(std::move(agg_plan));
+
+  return sort_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q5.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q5.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/order_by_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT n_name, sum(l_extendedprice * (1 - l_discount)) AS revenue
+// FROM customer, orders, lineitem, supplier, nation, region
+// WHERE c_custkey = o_custkey AND l_orderkey = o_orderkey
+//   AND l_suppkey = s_suppkey AND c_nationkey = s_nationkey
+//   AND s_nationkey = n_nationkey AND n_regionkey = r_regionkey
+//   AND r_name = 'ASIA'
+//   AND o_orderdate >= date '1994-01-01' AND o_orderdate < date '1995-01-01'
+// GROUP BY n_name
+// ORDER BY revenue DESC;
+//
+// The region is looked up by its key. The lineitems join their orders on the
+// order key and the nation of the supplier and of the customer together.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ5Plan() const {
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE PREDICATES FOR THE SCANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto region_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_EQUAL,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 2),
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(db_.KeyForRegion("ASIA"))))};
+
+  auto orderdate_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND,
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 4),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1994-01-01")))),
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_LESSTHAN,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 4),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1995-01-01")))))};
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SCAN PLANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (n_nationkey, n_name)
+  auto nation_scan = ScanTable(TableId::Nation, region_pred.release(), {0, 1});
+
+  // (s_nationkey, s_suppkey)
+  auto supplier_scan = ScanTable(TableId::Supplier, nullptr, {3, 0});
+
+  // (l_suppkey, l_orderkey, l_extendedprice, l_discount)
+  auto lineitem_scan = ScanTable(TableId::Lineitem, nullptr, {2, 0, 5, 6});
+
+  // (o_custkey, o_orderkey)
+  auto orders_scan =
+      ScanTable(TableId::Orders, orderdate_pred.release(), {1, 0});
+
+  // (c_custkey, c_nationkey)
+  auto customer_scan = ScanTable(TableId::Customer, nullptr, {0, 3});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE JOINS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (s_suppkey, s_nationkey, n_name)
+  auto supplier_join =
+      HashJoin(std::move(supplier_scan), std::move(nation_scan), {0},
+               {{0, {0, 1}}, {1, {0, 0}}, {2, {1, 1}}},
+               {{type::TypeId::INTEGER, kIntSize, "s_suppkey"},
+                {type::TypeId::INTEGER, kIntSize, "s_nationkey"},
+                {type::TypeId::VARCHAR, 25, "n_name", false}});
+
+  // (l_orderkey, s_nationkey, n_name, l_extendedprice, l_discount)
+  auto lineitem_join = HashJoin(
+      std::move(lineitem_scan), std::move(supplier_join), {0},
+      {{0, {0, 1}}, {1, {1, 1}}, {2, {1, 2}}, {3, {0, 2}}, {4, {0, 3}}},
+      {{type::TypeId::INTEGER, kIntSize, "l_orderkey"},
+       {type::TypeId::INTEGER, kIntSize, "s_nationkey"},
+       {type::TypeId::VARCHAR, 25, "n_name", false},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_discount"}});
+
+  // (o_orderkey, c_nationkey)
+  auto orders_join =
+      HashJoin(std::move(orders_scan), std::move(customer_scan), {0},
+               {{0, {0, 1}}, {1, {1, 1}}},
+               {{type::TypeId::INTEGER, kIntSize, "o_orderkey"},
+                {type::TypeId::INTEGER, kIntSize, "c_nationkey"}});
+
+  // (n_name, l_extendedprice, l_discount)
+  auto join_plan = HashJoin(
+      std::move(lineitem_join), std::move(orders_join), {0, 1},
+      {{0, {0, 2}}, {1, {0, 3}}, {2, {0, 4}}},
+      {{type::TypeId::VARCHAR, 25, "n_name", false},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_discount"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// AGGREGATION
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm revenue_agg{ExpressionType::AGGREGATE_SUM,
+                                              DiscountedPrice(1, 2)};
+
+  auto agg_schema = std::shared_ptr<const catalog::Schema>{new catalog::Schema(
+      {{type::TypeId::VARCHAR, 25, "n_name", false},
+       {type::TypeId::DECIMAL, kDecimalSize, "revenue"}})};
+
+  DirectMapList agg_dml = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> agg_project{
+      new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(agg_project), nullptr, {revenue_agg}, {0}, agg_schema,
+      AggregateType::HASH)};
+  agg_plan->AddChild(std::move(join_plan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SORT
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<planner::AbstractPlan> sort_plan{
+      new planner::OrderByPlan{{1}, {true}, {0, 1}}};
+  sort_plan->AddChild(std::move(agg_plan));
+
+  return sort_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
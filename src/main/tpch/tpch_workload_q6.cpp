@@ -31,8 +31,6 @@ static constexpr int32_t _1997_01_01 = 852094800;
 static constexpr int32_t _1998_01_01 = 883630800;
 
 std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ6Plan() const {
-  auto &lineitem = db_.GetTable(TableId::Lineitem);
-
   //////////////////////////////////////////////////////////////////////////////
   /// THE PREDICATE FOR THE SCAN OVER LINEITEM
   //////////////////////////////////////////////////////////////////////////////
@@ -98,8 +96,8 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ6Plan() const {
   //////////////////////////////////////////////////////////////////////////////
 
   // Lineitem scan
-  auto lineitem_scan = std::unique_ptr<planner::AbstractPlan>{
-      new planner::SeqScanPlan(&lineitem, lineitem_pred.release(), {5,6})};
+  auto lineitem_scan =
+      ScanTable(TableId::Lineitem, lineitem_pred.release(), {5, 6});
 
   //////////////////////////////////////////////////////////////////////////////
   /// THE GLOBAL AGGREGATION
@@ -112,7 +110,6 @@ std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ6Plan() const {
           ExpressionType::OPERATOR_MULTIPLY, type::TypeId::DECIMAL,
           new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 0),
           new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 1))};
-  revenue_agg.agg_ai.type = type::TypeId::DECIMAL;
 
   auto output_schema =
       std::shared_ptr<const catalog::Schema>{new catalog::Schema(
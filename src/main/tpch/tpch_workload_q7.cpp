@@ -0,0 +1,242 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tpch_workload_q7.cpp
+//
+// Identification: src/main/tpch/tpch_workload_q7.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/tpch/tpch_workload.h"
+
+#include "catalog/schema.h"
+#include "expression/case_expression.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/operator_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/order_by_plan.h"
+#include "planner/projection_plan.h"
+
+namespace peloton {
+namespace benchmark {
+namespace tpch {
+
+//===----------------------------------------------------------------------===//
+// SELECT supp_nation, cust_nation, l_year, sum(volume) AS revenue
+// FROM (SELECT n1.n_name AS supp_nation, n2.n_name AS cust_nation,
+//              extract(year FROM l_shipdate) AS l_year,
+//              l_extendedprice * (1 - l_discount) AS volume
+//       FROM supplier, lineitem, orders, customer, nation n1, nation n2
+//       WHERE s_suppkey = l_suppkey AND o_orderkey = l_orderkey
+//         AND c_custkey = o_custkey AND s_nationkey = n1.n_nationkey
+//         AND c_nationkey = n2.n_nationkey
+//         AND ((n1.n_name = 'FRANCE' AND n2.n_name = 'GERMANY')
+//           OR (n1.n_name = 'GERMANY' AND n2.n_name = 'FRANCE'))
+//         AND l_shipdate BETWEEN date '1995-01-01' AND date '1996-12-31')
+// GROUP BY supp_nation, cust_nation, l_year
+// ORDER BY supp_nation, cust_nation, l_year;
+//
+// The nations are looked up, and reported, by their keys. Suppliers and
+// customers of both nations are kept, and the lineitems join an order of the
+// other nation: its key is the sum of both keys less the nation of the
+// customer.
+//===----------------------------------------------------------------------===//
+std::unique_ptr<planner::AbstractPlan> TPCHBenchmark::ConstructQ7Plan() const {
+  int32_t france = db_.KeyForNation("FRANCE");
+  int32_t germany = db_.KeyForNation("GERMANY");
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE PREDICATES FOR THE SCANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  auto supplier_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_OR,
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_EQUAL,
+              new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 3),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetIntegerValue(france))),
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_EQUAL,
+              new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 3),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetIntegerValue(germany))))};
+
+  auto customer_pred = std::unique_ptr<expression::AbstractExpression>{
+      supplier_pred->Copy()};
+
+  auto shipdate_pred = std::unique_ptr<expression::AbstractExpression>{
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND,
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 10),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1995-01-01")))),
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_LESSTHANOREQUALTO,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 10),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1996-12-31")))))};
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE SCAN PLANS
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (s_suppkey, s_nationkey)
+  auto supplier_scan =
+      ScanTable(TableId::Supplier, supplier_pred.release(), {0, 3});
+
+  // (l_suppkey, l_orderkey, l_extendedprice, l_discount, l_shipdate)
+  auto lineitem_scan = ScanTable(TableId::Lineitem, shipdate_pred.release(),
+                                 {2, 0, 5, 6, 10});
+
+  // (c_custkey, c_nationkey)
+  auto customer_scan =
+      ScanTable(TableId::Customer, customer_pred.release(), {0, 3});
+
+  // (o_custkey, o_orderkey)
+  auto orders_scan = ScanTable(TableId::Orders, nullptr, {1, 0});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// LINEITEM - SUPPLIER JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (l_orderkey, s_nationkey, l_extendedprice, l_discount, l_shipdate)
+  auto lineitem_join = HashJoin(
+      std::move(lineitem_scan), std::move(supplier_scan), {0},
+      {{0, {0, 1}}, {1, {1, 1}}, {2, {0, 2}}, {3, {0, 3}}, {4, {0, 4}}},
+      {{type::TypeId::INTEGER, kIntSize, "l_orderkey"},
+       {type::TypeId::INTEGER, kIntSize, "s_nationkey"},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_discount"},
+       {type::TypeId::DATE, kDateSize, "l_shipdate"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// ORDERS - CUSTOMER JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (o_orderkey, c_nationkey)
+  auto orders_join =
+      HashJoin(std::move(orders_scan), std::move(customer_scan), {0},
+               {{0, {0, 1}}, {1, {1, 1}}},
+               {{type::TypeId::INTEGER, kIntSize, "o_orderkey"},
+                {type::TypeId::INTEGER, kIntSize, "c_nationkey"}});
+
+  // (o_orderkey, france + germany - c_nationkey, c_nationkey)
+  TargetList partner_tl;
+  partner_tl.emplace_back(
+      1, planner::DerivedAttribute{new expression::OperatorExpression(
+             ExpressionType::OPERATOR_MINUS, type::TypeId::INTEGER,
+             new expression::ConstantValueExpression(
+                 type::ValueFactory::GetIntegerValue(france + germany)),
+             new expression::TupleValueExpression(type::TypeId::INTEGER, 0,
+                                                  1))});
+  DirectMapList partner_dml = {{0, {0, 0}}, {2, {0, 1}}};
+  std::unique_ptr<const planner::ProjectInfo> partner_project{
+      new planner::ProjectInfo(std::move(partner_tl), std::move(partner_dml))};
+  auto partner_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema({{type::TypeId::INTEGER, kIntSize, "o_orderkey"},
+                           {type::TypeId::INTEGER, kIntSize, "partner_key"},
+                           {type::TypeId::INTEGER, kIntSize, "c_nationkey"}})};
+  std::unique_ptr<planner::AbstractPlan> partner_plan{
+      new planner::ProjectionPlan(std::move(partner_project), partner_schema)};
+  partner_plan->AddChild(std::move(orders_join));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// LINEITEM - ORDERS JOIN
+  //////////////////////////////////////////////////////////////////////////////
+
+  // (s_nationkey, c_nationkey, l_extendedprice, l_discount, l_shipdate)
+  auto join_plan = HashJoin(
+      std::move(lineitem_join), std::move(partner_plan), {0, 1},
+      {{0, {0, 1}}, {1, {1, 2}}, {2, {0, 2}}, {3, {0, 3}}, {4, {0, 4}}},
+      {{type::TypeId::INTEGER, kIntSize, "supp_nation"},
+       {type::TypeId::INTEGER, kIntSize, "cust_nation"},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_extendedprice"},
+       {type::TypeId::DECIMAL, kDecimalSize, "l_discount"},
+       {type::TypeId::DATE, kDateSize, "l_shipdate"}});
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// THE YEAR AND THE VOLUME
+  //////////////////////////////////////////////////////////////////////////////
+
+  // The shipping dates are in 1995 or 1996
+  std::vector<expression::CaseExpression::WhenClause> year_clauses;
+  year_clauses.push_back(expression::CaseExpression::WhenClause{
+      expression::CaseExpression::AbsExprPtr{
+          new expression::ComparisonExpression(
+              ExpressionType::COMPARE_LESSTHAN,
+              new expression::TupleValueExpression(type::TypeId::DATE, 0, 4),
+              new expression::ConstantValueExpression(
+                  type::ValueFactory::GetDateValue(
+                      ConvertDate("1996-01-01"))))},
+      expression::CaseExpression::AbsExprPtr{
+          new expression::ConstantValueExpression(
+              type::ValueFactory::GetIntegerValue(1995))}});
+
+  TargetList volume_tl;
+  volume_tl.emplace_back(
+      2, planner::DerivedAttribute{new expression::CaseExpression(
+             type::TypeId::INTEGER, year_clauses,
+             expression::CaseExpression::AbsExprPtr{
+                 new expression::ConstantValueExpression(
+                     type::ValueFactory::GetIntegerValue(1996))})});
+  volume_tl.emplace_back(3, planner::DerivedAttribute{DiscountedPrice(2, 3)});
+  DirectMapList volume_dml = {{0, {0, 0}}, {1, {0, 1}}};
+  std::unique_ptr<const planner::ProjectInfo> volume_project{
+      new planner::ProjectInfo(std::move(volume_tl), std::move(volume_dml))};
+  auto volume_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema({{type::TypeId::INTEGER, kIntSize, "supp_nation"},
+                           {type::TypeId::INTEGER, kIntSize, "cust_nation"},
+                           {type::TypeId::INTEGER, kIntSize, "l_year"},
+                           {type::TypeId::DECIMAL, kDecimalSize, "volume"}})};
+  std::unique_ptr<planner::AbstractPlan> volume_plan{
+      new planner::ProjectionPlan(std::move(volume_project), volume_schema)};
+  volume_plan->AddChild(std::move(join_plan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// AGGREGATION
+  //////////////////////////////////////////////////////////////////////////////
+
+  planner::AggregatePlan::AggTerm revenue_agg{
+      ExpressionType::AGGREGATE_SUM,
+      new expression::TupleValueExpression(type::TypeId::DECIMAL, 0, 3)};
+
+  auto agg_schema = std::shared_ptr<const catalog::Schema>{
+      new catalog::Schema({{type::TypeId::INTEGER, kIntSize, "supp_nation"},
+                           {type::TypeId::INTEGER, kIntSize, "cust_nation"},
+                           {type::TypeId::INTEGER, kIntSize, "l_year"},
+                           {type::TypeId::DECIMAL, kDecimalSize, "revenue"}})};
+
+  DirectMapList agg_dml = {{0, {0, 0}}, {1, {0, 1}}, {2, {0, 2}}, {3, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> agg_project{
+      new planner::ProjectInfo(TargetList{}, std::move(agg_dml))};
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(agg_project), nullptr, {revenue_agg}, {0, 1, 2}, agg_schema,
+      AggregateType::HASH)};
+  agg_plan->AddChild(std::move(volume_plan));
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// SORT
+  //////////////////////////////////////////////////////////////////////////////
+
+  std::unique_ptr<planner::AbstractPlan> sort_plan{new planner::OrderByPlan{
+      {0, 1, 2}, {false, false, false}, {0, 1, 2, 3}}};
+  sort_plan->AddChild(std::move(agg_plan));
+
+  return sort_plan;
+}
+
+}  // namespace tpch
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench.cpp
+//
+// Identification: src/main/wirebench/wirebench.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/wirebench/wirebench_configuration.h"
+#include "benchmark/wirebench/wirebench_loader.h"
+#include "benchmark/wirebench/wirebench_workload.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+configuration state;
+
+// Main Entry Point
+void RunBenchmark() {
+  // Create and load the tables on the server
+  if (state.load == true) {
+    CreateTables();
+    LoadTables();
+  }
+
+  // Run the workload
+  RunWorkload();
+
+  // Emit throughput and latencies
+  WriteOutput();
+}
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
+
+int main(int argc, char **argv) {
+  peloton::benchmark::wirebench::ParseArguments(
+      argc, argv, peloton::benchmark::wirebench::state);
+
+  peloton::benchmark::wirebench::RunBenchmark();
+
+  return 0;
+}
@@ -0,0 +1,341 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_client.cpp
+//
+// Identification: src/main/wirebench/wirebench_client.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/wirebench/wirebench_client.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+#include "common/logger.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+// Protocol version 3.0
+static const int32_t protocol_version = 3 << 16;
+
+// The socket connected to the host and port, -1 if none is
+static int ConnectSocket(const std::string &host, const int port) {
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+
+  struct addrinfo *addresses = nullptr;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints,
+                  &addresses) != 0) {
+    LOG_ERROR("Cannot resolve %s", host.c_str());
+    return -1;
+  }
+
+  int socket_fd = -1;
+  for (auto address = addresses; address != nullptr;
+       address = address->ai_next) {
+    socket_fd = socket(address->ai_family, address->ai_socktype,
+                       address->ai_protocol);
+    if (socket_fd < 0) {
+      continue;
+    }
+    if (connect(socket_fd, address->ai_addr, address->ai_addrlen) == 0) {
+      break;
+    }
+    close(socket_fd);
+    socket_fd = -1;
+  }
+  freeaddrinfo(addresses);
+
+  if (socket_fd >= 0) {
+    // the requests are flushed as a whole, so send them right away
+    int no_delay = 1;
+    setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &no_delay,
+               sizeof(no_delay));
+  }
+  return socket_fd;
+}
+
+PostgresClient::~PostgresClient() { Close(); }
+
+bool PostgresClient::Connect(const std::string &host, const int port,
+                             const std::string &user,
+                             const std::string &database) {
+  socket_fd_ = ConnectSocket(host, port);
+  if (socket_fd_ < 0) {
+    LOG_ERROR("Cannot connect to %s:%d", host.c_str(), port);
+    return false;
+  }
+
+  // The startup message has no type
+  message_start_ = write_buffer_.size();
+  PutInt32(0);
+  PutInt32(protocol_version);
+  PutString("user");
+  PutString(user);
+  PutString("database");
+  PutString(database);
+  write_buffer_.push_back('\0');
+  EndMessage();
+
+  // Authentication, parameters and the first ReadyForQuery
+  QueryResult result;
+  if (Flush() == false || ReadResult(result) == false) {
+    return false;
+  }
+  if (result.error == true) {
+    LOG_ERROR("Cannot start up: %s", result.error_message.c_str());
+    return false;
+  }
+  return true;
+}
+
+void PostgresClient::Close() {
+  if (socket_fd_ < 0) {
+    return;
+  }
+  write_buffer_.clear();
+  BeginMessage('X');
+  EndMessage();
+  Flush();
+  close(socket_fd_);
+  socket_fd_ = -1;
+}
+
+void PostgresClient::SendQuery(const std::string &query) {
+  BeginMessage('Q');
+  PutString(query);
+  EndMessage();
+}
+
+void PostgresClient::SendParse(const std::string &statement_name,
+                               const std::string &query) {
+  BeginMessage('P');
+  PutString(statement_name);
+  PutString(query);
+  // the types of the parameters are inferred
+  PutInt16(0);
+  EndMessage();
+
+  BeginMessage('S');
+  EndMessage();
+}
+
+void PostgresClient::SendExecute(const std::string &statement_name,
+                                 const std::vector<std::string> &params) {
+  // the unnamed portal, with parameters and results in text
+  BeginMessage('B');
+  PutString("");
+  PutString(statement_name);
+  PutInt16(0);
+  PutInt16(static_cast<int16_t>(params.size()));
+  for (auto &param : params) {
+    PutInt32(static_cast<int32_t>(param.size()));
+    write_buffer_.append(param);
+  }
+  PutInt16(0);
+  EndMessage();
+
+  // all the rows
+  BeginMessage('E');
+  PutString("");
+  PutInt32(0);
+  EndMessage();
+
+  BeginMessage('S');
+  EndMessage();
+}
+
+bool PostgresClient::Flush() {
+  size_t sent = 0;
+  while (sent < write_buffer_.size()) {
+    auto count = send(socket_fd_, write_buffer_.data() + sent,
+                      write_buffer_.size() - sent, MSG_NOSIGNAL);
+    if (count <= 0) {
+      LOG_ERROR("Cannot send: %s", strerror(errno));
+      write_buffer_.clear();
+      return false;
+    }
+    sent += count;
+  }
+  write_buffer_.clear();
+  return true;
+}
+
+bool PostgresClient::ReadResult(QueryResult &result) {
+  result = QueryResult();
+
+  char type;
+  std::string body;
+  while (ReadMessage(type, body) == true) {
+    switch (type) {
+      case 'C': {
+        // the tag ends with the row count, e.g. "UPDATE 1" or "INSERT 0 1"
+        auto count_start = body.find_last_of(' ');
+        if (count_start != std::string::npos) {
+          result.row_count += std::strtoull(body.c_str() + count_start + 1,
+                                            nullptr, 10);
+        }
+        break;
+      }
+      case 'E': {
+        if (result.error == true) {
+          break;
+        }
+        result.error = true;
+        // fields of a type byte and a string, up to a zero type
+        size_t field_start = 0;
+        while (field_start < body.size() && body[field_start] != '\0') {
+          auto field_end = body.find('\0', field_start + 1);
+          if (field_end == std::string::npos) {
+            break;
+          }
+          if (body[field_start] == 'M') {
+            result.error_message =
+                body.substr(field_start + 1, field_end - field_start - 1);
+          }
+          field_start = field_end + 1;
+        }
+        break;
+      }
+      case 'Z':
+        return true;
+      default:
+        // rows, descriptions, notices and parameter statuses
+        break;
+    }
+  }
+  return false;
+}
+
+void PostgresClient::BeginMessage(const char type) {
+  message_start_ = write_buffer_.size();
+  write_buffer_.push_back(type);
+  // the length, set by EndMessage
+  PutInt32(0);
+}
+
+void PostgresClient::PutInt16(const int16_t value) {
+  uint16_t network_value = htons(static_cast<uint16_t>(value));
+  write_buffer_.append(reinterpret_cast<const char *>(&network_value),
+                       sizeof(network_value));
+}
+
+void PostgresClient::PutInt32(const int32_t value) {
+  uint32_t network_value = htonl(static_cast<uint32_t>(value));
+  write_buffer_.append(reinterpret_cast<const char *>(&network_value),
+                       sizeof(network_value));
+}
+
+void PostgresClient::PutString(const std::string &value) {
+  write_buffer_.append(value);
+  write_buffer_.push_back('\0');
+}
+
+void PostgresClient::EndMessage() {
+  // the length counts itself but not the type, which the startup message
+  // does not have
+  size_t length_start = message_start_;
+  if (write_buffer_[message_start_] != '\0') {
+    length_start++;
+  }
+  uint32_t network_length =
+      htonl(static_cast<uint32_t>(write_buffer_.size() - length_start));
+  memcpy(&write_buffer_[length_start], &network_length,
+         sizeof(network_length));
+}
+
+bool PostgresClient::ReadMessage(char &type, std::string &body) {
+  if (Fill(5) == false) {
+    return false;
+  }
+  type = read_buffer_[read_ptr_];
+  uint32_t network_length;
+  memcpy(&network_length, &read_buffer_[read_ptr_ + 1],
+         sizeof(network_length));
+  size_t length = ntohl(network_length);
+
+  if (Fill(1 + length) == false) {
+    return false;
+  }
+  body.assign(read_buffer_, read_ptr_ + 5, length - 4);
+  read_ptr_ += 1 + length;
+  return true;
+}
+
+bool PostgresClient::Fill(const size_t byte_count) {
+  // drop the bytes read already
+  if (read_ptr_ > 0) {
+    read_buffer_.erase(0, read_ptr_);
+    read_ptr_ = 0;
+  }
+
+  char buffer[8192];
+  while (read_buffer_.size() < byte_count) {
+    auto count = recv(socket_fd_, buffer, sizeof(buffer), 0);
+    if (count <= 0) {
+      LOG_ERROR("Connection closed: %s", strerror(errno));
+      return false;
+    }
+    read_buffer_.append(buffer, count);
+  }
+  return true;
+}
+
+bool FetchHttp(const std::string &host, const int port,
+               const std::string &path, std::string &body) {
+  int socket_fd = ConnectSocket(host, port);
+  if (socket_fd < 0) {
+    return false;
+  }
+
+  std::string request = "GET " + path + " HTTP/1.0\r\nHost: " + host +
+                        "\r\nConnection: close\r\n\r\n";
+  size_t sent = 0;
+  while (sent < request.size()) {
+    auto count = send(socket_fd, request.data() + sent, request.size() - sent,
+                      MSG_NOSIGNAL);
+    if (count <= 0) {
+      close(socket_fd);
+      return false;
+    }
+    sent += count;
+  }
+
+  // the server closes the connection after the response
+  std::string response;
+  char buffer[8192];
+  ssize_t count;
+  while ((count = recv(socket_fd, buffer, sizeof(buffer), 0)) > 0) {
+    response.append(buffer, count);
+  }
+  close(socket_fd);
+
+  auto body_start = response.find("\r\n\r\n");
+  if (response.compare(0, 12, "HTTP/1.0 200") != 0 &&
+      response.compare(0, 12, "HTTP/1.1 200") != 0) {
+    return false;
+  }
+  if (body_start == std::string::npos) {
+    return false;
+  }
+  body = response.substr(body_start + 4);
+  return true;
+}
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,321 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_configuration.cpp
+//
+// Identification: src/main/wirebench/wirebench_configuration.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <getopt.h>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+#include "benchmark/wirebench/wirebench_configuration.h"
+#include "common/logger.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : wirebench <options> \n"
+          "   -h --help              :  print help message \n"
+          "   -a --host              :  server address (default: localhost) \n"
+          "   -r --port              :  server port (default: 15721) \n"
+          "   -m --metrics_port      :  metrics port of the server, to report "
+          "its latencies \n"
+          "   -w --workload          :  ycsb (default) or tpcc \n"
+          "   -q --protocol          :  extended (default) or simple \n"
+          "   -x --load              :  create and load the tables first \n"
+          "   -k --scale_factor      :  # of K tuples (ycsb) or warehouses "
+          "(tpcc) \n"
+          "   -d --duration          :  execution duration \n"
+          "   -c --client_count      :  # of client connections \n"
+          "   -i --pipeline_depth    :  # of requests sent before reading "
+          "results \n"
+          "   -u --update_ratio      :  fraction of updates (ycsb) \n"
+          "   -z --zipf_theta        :  theta to control skewness (ycsb) \n"
+          "   -l --loader_count      :  # of loaders \n");
+}
+
+static struct option opts[] = {
+    {"host", optional_argument, NULL, 'a'},
+    {"port", optional_argument, NULL, 'r'},
+    {"metrics_port", optional_argument, NULL, 'm'},
+    {"workload", optional_argument, NULL, 'w'},
+    {"protocol", optional_argument, NULL, 'q'},
+    {"load", no_argument, NULL, 'x'},
+    {"scale_factor", optional_argument, NULL, 'k'},
+    {"duration", optional_argument, NULL, 'd'},
+    {"client_count", optional_argument, NULL, 'c'},
+    {"pipeline_depth", optional_argument, NULL, 'i'},
+    {"update_ratio", optional_argument, NULL, 'u'},
+    {"zipf_theta", optional_argument, NULL, 'z'},
+    {"loader_count", optional_argument, NULL, 'l'},
+    {NULL, 0, NULL, 0}};
+
+std::string RequestTypeToString(RequestType type) {
+  switch (type) {
+    case RequestType::READ:
+      return "READ";
+    case RequestType::UPDATE:
+      return "UPDATE";
+    case RequestType::NEW_ORDER:
+      return "NEW_ORDER";
+    case RequestType::PAYMENT:
+      return "PAYMENT";
+  }
+  return "INVALID";
+}
+
+void ValidatePort(const configuration &state) {
+  if (state.port <= 0 || state.port > 65535) {
+    LOG_ERROR("Invalid port :: %d", state.port);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.metrics_port < 0 || state.metrics_port > 65535) {
+    LOG_ERROR("Invalid metrics_port :: %d", state.metrics_port);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "port", state.port);
+  LOG_TRACE("%s : %d", "metrics_port", state.metrics_port);
+}
+
+void ValidateScaleFactor(const configuration &state) {
+  if (state.scale_factor <= 0) {
+    LOG_ERROR("Invalid scale_factor :: %d", state.scale_factor);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "scale_factor", state.scale_factor);
+}
+
+void ValidateDuration(const configuration &state) {
+  if (state.duration <= 0) {
+    LOG_ERROR("Invalid duration :: %lf", state.duration);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "duration", state.duration);
+}
+
+void ValidateClientCount(const configuration &state) {
+  if (state.client_count <= 0) {
+    LOG_ERROR("Invalid client_count :: %d", state.client_count);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "client_count", state.client_count);
+}
+
+void ValidatePipelineDepth(const configuration &state) {
+  if (state.pipeline_depth <= 0) {
+    LOG_ERROR("Invalid pipeline_depth :: %d", state.pipeline_depth);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "pipeline_depth", state.pipeline_depth);
+}
+
+void ValidateUpdateRatio(const configuration &state) {
+  if (state.update_ratio < 0 || state.update_ratio > 1) {
+    LOG_ERROR("Invalid update_ratio :: %lf", state.update_ratio);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "update_ratio", state.update_ratio);
+}
+
+void ValidateZipfTheta(const configuration &state) {
+  if (state.zipf_theta < 0 || state.zipf_theta >= 1.0) {
+    LOG_ERROR("Invalid zipf_theta :: %lf", state.zipf_theta);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "zipf_theta", state.zipf_theta);
+}
+
+void ValidateLoaderCount(const configuration &state) {
+  if (state.loader_count <= 0) {
+    LOG_ERROR("Invalid loader_count :: %d", state.loader_count);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "loader_count", state.loader_count);
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.host = "localhost";
+  state.port = 15721;
+  state.metrics_port = 0;
+  state.workload = WorkloadType::YCSB;
+  state.protocol = QueryProtocol::EXTENDED;
+  state.load = false;
+  state.scale_factor = 1;
+  state.duration = 10;
+  state.client_count = 8;
+  state.pipeline_depth = 1;
+  state.update_ratio = 0.5;
+  state.zipf_theta = 0.0;
+  state.loader_count = 4;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hxa:r:m:w:q:k:d:c:i:u:z:l:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'a':
+        state.host = optarg;
+        break;
+      case 'r':
+        state.port = atoi(optarg);
+        break;
+      case 'm':
+        state.metrics_port = atoi(optarg);
+        break;
+      case 'w': {
+        char *workload = optarg;
+        if (strcmp(workload, "ycsb") == 0) {
+          state.workload = WorkloadType::YCSB;
+        } else if (strcmp(workload, "tpcc") == 0) {
+          state.workload = WorkloadType::TPCC;
+        } else {
+          LOG_ERROR("Unknown workload: %s", workload);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
+      case 'q': {
+        char *protocol = optarg;
+        if (strcmp(protocol, "extended") == 0) {
+          state.protocol = QueryProtocol::EXTENDED;
+        } else if (strcmp(protocol, "simple") == 0) {
+          state.protocol = QueryProtocol::SIMPLE;
+        } else {
+          LOG_ERROR("Unknown protocol: %s", protocol);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
+      case 'x':
+        state.load = true;
+        break;
+      case 'k':
+        state.scale_factor = atoi(optarg);
+        break;
+      case 'd':
+        state.duration = atof(optarg);
+        break;
+      case 'c':
+        state.client_count = atoi(optarg);
+        break;
+      case 'i':
+        state.pipeline_depth = atoi(optarg);
+        break;
+      case 'u':
+        state.update_ratio = atof(optarg);
+        break;
+      case 'z':
+        state.zipf_theta = atof(optarg);
+        break;
+      case 'l':
+        state.loader_count = atoi(optarg);
+        break;
+
+      case 'h':
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+
+      default:
+        LOG_ERROR("Unknown option: -%c-", c);
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+    }
+  }
+
+  // Print configuration
+  ValidatePort(state);
+  ValidateScaleFactor(state);
+  ValidateDuration(state);
+  ValidateClientCount(state);
+  ValidatePipelineDepth(state);
+  ValidateUpdateRatio(state);
+  ValidateZipfTheta(state);
+  ValidateLoaderCount(state);
+
+  LOG_TRACE("%s : %d", "Load tables", state.load);
+}
+
+void WriteOutput() {
+  std::ofstream out("outputfile.summary");
+
+  auto workload = state.workload == WorkloadType::YCSB ? "ycsb" : "tpcc";
+  auto protocol =
+      state.protocol == QueryProtocol::EXTENDED ? "extended" : "simple";
+
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("%s %s %d %d %d :: %lf %lf", workload, protocol,
+           state.scale_factor, state.client_count, state.pipeline_depth,
+           state.throughput, state.abort_rate);
+
+  out << workload << " ";
+  out << protocol << " ";
+  out << state.scale_factor << " ";
+  out << state.client_count << " ";
+  out << state.pipeline_depth << " ";
+  out << state.throughput << " ";
+  out << state.abort_rate << "\n";
+
+  auto write_result = [&out](const std::string &side, const std::string &name,
+                             const LatencyResult &result) {
+    LOG_INFO("%-7s %-10s %12.1lf %9.3lf %9.3lf %9.3lf %9.3lf", side.c_str(),
+             name.c_str(), result.throughput, result.average_latency,
+             result.p50_latency, result.p95_latency, result.p99_latency);
+
+    out << side << " " << name << " " << result.throughput << " "
+        << result.average_latency << " " << result.p50_latency << " "
+        << result.p95_latency << " " << result.p99_latency << "\n";
+  };
+
+  // throughput and latencies (ms) seen by the clients and by the server
+  LOG_INFO("%-7s %-10s %12s %9s %9s %9s %9s", "side", "type", "per s",
+           "avg ms", "p50 ms", "p95 ms", "p99 ms");
+  for (size_t type_id = 0; type_id < request_type_count; type_id++) {
+    auto &result = state.request_results[type_id];
+    if (result.throughput > 0) {
+      write_result("client",
+                   RequestTypeToString(static_cast<RequestType>(type_id)),
+                   result);
+    }
+  }
+  if (state.has_server_results == true) {
+    for (size_t type_id = 0; type_id < server_query_types.size(); type_id++) {
+      auto &result = state.server_query_results[type_id];
+      if (result.throughput > 0) {
+        write_result("server", server_query_types[type_id], result);
+      }
+    }
+    write_result("server", "TXN", state.server_txn_result);
+  }
+
+  out.flush();
+  out.close();
+}
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_loader.cpp
+//
+// Identification: src/main/wirebench/wirebench_loader.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include "benchmark/wirebench/wirebench_loader.h"
+#include "benchmark/wirebench/wirebench_workload.h"
+#include "common/logger.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+// Inserts sent by a loader before it reads their results
+static const size_t load_batch_size = 100;
+
+// Run the queries one after another, exiting if any fails
+static void RunQueries(PostgresClient &client,
+                       const std::vector<std::string> &queries) {
+  for (auto &query : queries) {
+    client.SendQuery(query);
+  }
+
+  bool connected = client.Flush();
+  for (size_t i = 0; connected == true && i < queries.size(); i++) {
+    QueryResult result;
+    connected = client.ReadResult(result);
+    if (connected == true && result.error == true) {
+      LOG_ERROR("Query failed: %s :: %s", queries[i].c_str(),
+                result.error_message.c_str());
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (connected == false) {
+    LOG_ERROR("Lost the connection to the server");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static std::string Price(FastRandom &rng) {
+  return std::to_string(1 + rng.next_u32() % 10000 / 100.0);
+}
+
+// Hand the inserts of all the rows to the callback, in the same order on
+// every call
+static void ForEachRow(const std::function<void(const std::string &)> &insert) {
+  FastRandom rng(0);
+
+  if (state.workload == WorkloadType::YCSB) {
+    std::string fields;
+    for (int field_itr = 0; field_itr < ycsb_field_count; field_itr++) {
+      fields += ", '" + std::string(ycsb_field_length, 'z') + "'";
+    }
+    for (int key = 0; key < state.scale_factor * 1000; key++) {
+      insert("INSERT INTO usertable VALUES (" + std::to_string(key) + fields +
+             ")");
+    }
+    return;
+  }
+
+  for (int item_id = 1; item_id <= tpcc_item_count; item_id++) {
+    insert("INSERT INTO item VALUES (" + std::to_string(item_id) + ", " +
+           Price(rng) + ")");
+  }
+
+  for (int w_id = 1; w_id <= state.scale_factor; w_id++) {
+    auto warehouse = std::to_string(w_id);
+    insert("INSERT INTO warehouse VALUES (" + warehouse + ", 300000.0)");
+
+    for (int d_id = 1; d_id <= tpcc_district_count; d_id++) {
+      auto district = warehouse + ", " + std::to_string(d_id);
+      insert("INSERT INTO district VALUES (" + district + ", " +
+             std::to_string(tpcc_customer_count + 1) + ", 30000.0)");
+
+      for (int c_id = 1; c_id <= tpcc_customer_count; c_id++) {
+        insert("INSERT INTO customer VALUES (" + district + ", " +
+               std::to_string(c_id) + ", -10.0, 1)");
+      }
+    }
+
+    for (int item_id = 1; item_id <= tpcc_item_count; item_id++) {
+      insert("INSERT INTO stock VALUES (" + warehouse + ", " +
+             std::to_string(item_id) + ", " +
+             std::to_string(10 + rng.next_u32() % 91) + ", 0)");
+    }
+  }
+}
+
+void CreateTables() {
+  PostgresClient client;
+  if (ConnectClient(client) == false) {
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.workload == WorkloadType::YCSB) {
+    std::string fields;
+    for (int field_itr = 1; field_itr <= ycsb_field_count; field_itr++) {
+      fields += ", field" + std::to_string(field_itr) + " VARCHAR(" +
+                std::to_string(ycsb_field_length) + ")";
+    }
+    RunQueries(client, {"DROP TABLE IF EXISTS usertable",
+                        "CREATE TABLE usertable (ycsb_key INT PRIMARY KEY" +
+                            fields + ")"});
+    return;
+  }
+
+  RunQueries(
+      client,
+      {"DROP TABLE IF EXISTS warehouse", "DROP TABLE IF EXISTS district",
+       "DROP TABLE IF EXISTS customer", "DROP TABLE IF EXISTS item",
+       "DROP TABLE IF EXISTS stock", "DROP TABLE IF EXISTS orders",
+       "DROP TABLE IF EXISTS order_line",
+       "CREATE TABLE warehouse (w_id INT PRIMARY KEY, w_ytd DECIMAL)",
+       "CREATE TABLE district (d_w_id INT, d_id INT, d_next_o_id INT, "
+       "d_ytd DECIMAL, PRIMARY KEY (d_w_id, d_id))",
+       "CREATE TABLE customer (c_w_id INT, c_d_id INT, c_id INT, "
+       "c_balance DECIMAL, c_payment_cnt INT, "
+       "PRIMARY KEY (c_w_id, c_d_id, c_id))",
+       "CREATE TABLE item (i_id INT PRIMARY KEY, i_price DECIMAL)",
+       "CREATE TABLE stock (s_w_id INT, s_i_id INT, s_quantity INT, "
+       "s_ytd INT, PRIMARY KEY (s_w_id, s_i_id))",
+       "CREATE TABLE orders (o_w_id INT, o_d_id INT, o_id INT, o_c_id INT, "
+       "o_ol_cnt INT, PRIMARY KEY (o_w_id, o_d_id, o_id))",
+       "CREATE TABLE order_line (ol_w_id INT, ol_d_id INT, ol_o_id INT, "
+       "ol_number INT, ol_i_id INT, ol_quantity INT, ol_amount DECIMAL, "
+       "PRIMARY KEY (ol_w_id, ol_d_id, ol_o_id, ol_number))"});
+}
+
+// Insert every loader_count-th row, from the one of the loader on
+static void LoadRows(const int loader_id) {
+  PostgresClient client;
+  if (ConnectClient(client) == false) {
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<std::string> batch;
+  size_t row_id = 0;
+  ForEachRow([&](const std::string &insert) {
+    if (row_id++ % state.loader_count != static_cast<size_t>(loader_id)) {
+      return;
+    }
+    batch.push_back(insert);
+    if (batch.size() == load_batch_size) {
+      RunQueries(client, batch);
+      batch.clear();
+    }
+  });
+  RunQueries(client, batch);
+}
+
+void LoadTables() {
+  std::chrono::steady_clock::time_point start_time =
+      std::chrono::steady_clock::now();
+
+  std::vector<std::unique_ptr<std::thread>> load_threads(state.loader_count);
+  for (int loader_id = 0; loader_id < state.loader_count; ++loader_id) {
+    load_threads[loader_id].reset(new std::thread(LoadRows, loader_id));
+  }
+  for (int loader_id = 0; loader_id < state.loader_count; ++loader_id) {
+    load_threads[loader_id]->join();
+  }
+
+  std::chrono::steady_clock::time_point end_time =
+      std::chrono::steady_clock::now();
+  double diff = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    end_time - start_time).count();
+  LOG_INFO("database table loading time = %lf ms", diff);
+}
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
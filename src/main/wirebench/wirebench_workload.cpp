@@ -0,0 +1,537 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_workload.cpp
+//
+// Identification: src/main/wirebench/wirebench_workload.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "benchmark/wirebench/wirebench_workload.h"
+#include "common/logger.h"
+#include "common/platform.h"
+#include "statistics/latency_histogram.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+/////////////////////////////////////////////////////////
+// STATEMENTS
+/////////////////////////////////////////////////////////
+
+enum YCSBStatementId : size_t { YCSB_READ = 0, YCSB_UPDATE };
+
+static const std::vector<StatementTemplate> ycsb_statements = {
+    {"ycsb_read", "SELECT * FROM usertable WHERE ycsb_key = $1", {false}},
+    {"ycsb_update", "UPDATE usertable SET field1 = $1 WHERE ycsb_key = $2",
+     {true, false}}};
+
+enum TPCCStatementId : size_t {
+  TPCC_BEGIN = 0,
+  TPCC_COMMIT,
+  NEW_ORDER_DISTRICT,
+  NEW_ORDER_CUSTOMER,
+  NEW_ORDER_ORDER,
+  NEW_ORDER_ITEM,
+  NEW_ORDER_STOCK,
+  NEW_ORDER_ORDER_LINE,
+  PAYMENT_WAREHOUSE,
+  PAYMENT_DISTRICT,
+  PAYMENT_CUSTOMER
+};
+
+static const std::vector<StatementTemplate> tpcc_statements = {
+    {"tpcc_begin", "BEGIN", {}},
+    {"tpcc_commit", "COMMIT", {}},
+    {"new_order_district",
+     "UPDATE district SET d_next_o_id = d_next_o_id + 1 "
+     "WHERE d_w_id = $1 AND d_id = $2",
+     {false, false}},
+    {"new_order_customer",
+     "SELECT c_balance FROM customer "
+     "WHERE c_w_id = $1 AND c_d_id = $2 AND c_id = $3",
+     {false, false, false}},
+    {"new_order_order", "INSERT INTO orders VALUES ($1, $2, $3, $4, $5)",
+     {false, false, false, false, false}},
+    {"new_order_item", "SELECT i_price FROM item WHERE i_id = $1", {false}},
+    {"new_order_stock",
+     "UPDATE stock SET s_quantity = s_quantity - $1, s_ytd = s_ytd + $2 "
+     "WHERE s_w_id = $3 AND s_i_id = $4",
+     {false, false, false, false}},
+    {"new_order_order_line",
+     "INSERT INTO order_line VALUES ($1, $2, $3, $4, $5, $6, $7)",
+     {false, false, false, false, false, false, false}},
+    {"payment_warehouse", "UPDATE warehouse SET w_ytd = w_ytd + $1 "
+                          "WHERE w_id = $2",
+     {false, false}},
+    {"payment_district",
+     "UPDATE district SET d_ytd = d_ytd + $1 WHERE d_w_id = $2 AND d_id = $3",
+     {false, false, false}},
+    {"payment_customer",
+     "UPDATE customer SET c_balance = c_balance - $1, "
+     "c_payment_cnt = c_payment_cnt + 1 "
+     "WHERE c_w_id = $2 AND c_d_id = $3 AND c_id = $4",
+     {false, false, false, false}}};
+
+// Fraction of the TPC-C requests that are new orders, as 45 to 43 in the
+// full mix
+static const double new_order_ratio = 0.51;
+
+const std::vector<StatementTemplate> &GetStatements() {
+  if (state.workload == WorkloadType::YCSB) {
+    return ycsb_statements;
+  }
+  return tpcc_statements;
+}
+
+// The query with the parameters inlined, the last ones first so $1 is not
+// taken for the start of $10
+static std::string InlineParams(const StatementTemplate &statement,
+                                const std::vector<std::string> &params) {
+  std::string query = statement.query;
+  for (size_t param_idx = params.size(); param_idx > 0; param_idx--) {
+    auto placeholder = "$" + std::to_string(param_idx);
+    auto value = params[param_idx - 1];
+    if (statement.string_params[param_idx - 1] == true) {
+      value = "'" + value + "'";
+    }
+    size_t position;
+    while ((position = query.find(placeholder)) != std::string::npos) {
+      query.replace(position, placeholder.size(), value);
+    }
+  }
+  return query;
+}
+
+void SendStatement(PostgresClient &client, const Statement &statement) {
+  auto &statement_template = GetStatements()[statement.statement_id];
+  if (state.protocol == QueryProtocol::EXTENDED) {
+    client.SendExecute(statement_template.name, statement.params);
+  } else {
+    client.SendQuery(InlineParams(statement_template, statement.params));
+  }
+}
+
+bool PrepareStatements(PostgresClient &client) {
+  auto &statements = GetStatements();
+  for (auto &statement : statements) {
+    client.SendParse(statement.name, statement.query);
+  }
+  if (client.Flush() == false) {
+    return false;
+  }
+
+  for (auto &statement : statements) {
+    QueryResult result;
+    if (client.ReadResult(result) == false) {
+      return false;
+    }
+    if (result.error == true) {
+      LOG_ERROR("Cannot prepare %s: %s", statement.name.c_str(),
+                result.error_message.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ConnectClient(PostgresClient &client) {
+  return client.Connect(state.host, state.port, "postgres", DEFAULT_DB_NAME);
+}
+
+/////////////////////////////////////////////////////////
+// REQUESTS
+/////////////////////////////////////////////////////////
+
+// Generates the requests of a client
+class RequestGenerator {
+ public:
+  RequestGenerator(const size_t client_id) : client_id_(client_id) {
+    if (state.workload == WorkloadType::YCSB) {
+      zipf_.reset(new ZipfDistribution(state.scale_factor * 1000 - 1,
+                                       state.zipf_theta));
+    }
+  }
+
+  Request NextRequest() {
+    if (state.workload == WorkloadType::YCSB) {
+      return NextYCSBRequest();
+    }
+    if (rng_.NextUniform() < new_order_ratio) {
+      return NextNewOrder();
+    }
+    return NextPayment();
+  }
+
+ private:
+  int Uniform(int low, int high) {
+    return low + rng_.next_u32() % (high - low + 1);
+  }
+
+  Request NextYCSBRequest() {
+    auto key = std::to_string(zipf_->GetNextNumber());
+    if (rng_.NextUniform() < state.update_ratio) {
+      return {RequestType::UPDATE,
+              {{YCSB_UPDATE, {std::string(ycsb_field_length, 'a'), key}}}};
+    }
+    return {RequestType::READ, {{YCSB_READ, {key}}}};
+  }
+
+  // The statements depend on no results, so a transaction is pipelined as a
+  // whole. The order ids are taken by the client instead of read from the
+  // district, from a range of its own, and the amounts are made up.
+  Request NextNewOrder() {
+    auto w_id = std::to_string(Uniform(1, state.scale_factor));
+    auto d_id = std::to_string(Uniform(1, tpcc_district_count));
+    auto c_id = std::to_string(Uniform(1, tpcc_customer_count));
+    auto o_id = std::to_string(tpcc_customer_count + 1 +
+                               order_count_++ * state.client_count +
+                               client_id_);
+    int ol_cnt = Uniform(5, 15);
+
+    Request request{RequestType::NEW_ORDER, {}};
+    auto &statements = request.statements;
+    statements.push_back({TPCC_BEGIN, {}});
+    statements.push_back({NEW_ORDER_DISTRICT, {w_id, d_id}});
+    statements.push_back({NEW_ORDER_CUSTOMER, {w_id, d_id, c_id}});
+    statements.push_back({NEW_ORDER_ORDER,
+                          {w_id, d_id, o_id, c_id, std::to_string(ol_cnt)}});
+    for (int ol_number = 1; ol_number <= ol_cnt; ol_number++) {
+      auto i_id = std::to_string(Uniform(1, tpcc_item_count));
+      auto quantity = std::to_string(Uniform(1, 10));
+      statements.push_back({NEW_ORDER_ITEM, {i_id}});
+      statements.push_back(
+          {NEW_ORDER_STOCK, {quantity, quantity, w_id, i_id}});
+      statements.push_back(
+          {NEW_ORDER_ORDER_LINE,
+           {w_id, d_id, o_id, std::to_string(ol_number), i_id, quantity,
+            std::to_string(Uniform(100, 10000) / 100.0)}});
+    }
+    statements.push_back({TPCC_COMMIT, {}});
+    return request;
+  }
+
+  Request NextPayment() {
+    auto w_id = std::to_string(Uniform(1, state.scale_factor));
+    auto d_id = std::to_string(Uniform(1, tpcc_district_count));
+    auto c_id = std::to_string(Uniform(1, tpcc_customer_count));
+    auto amount = std::to_string(Uniform(100, 500000) / 100.0);
+
+    return {RequestType::PAYMENT,
+            {{TPCC_BEGIN, {}},
+             {PAYMENT_WAREHOUSE, {amount, w_id}},
+             {PAYMENT_DISTRICT, {amount, w_id, d_id}},
+             {PAYMENT_CUSTOMER, {amount, w_id, d_id, c_id}},
+             {TPCC_COMMIT, {}}}};
+  }
+
+  size_t client_id_;
+
+  FastRandom rng_{static_cast<unsigned long>(rand())};
+
+  std::unique_ptr<ZipfDistribution> zipf_;
+
+  uint64_t order_count_ = 0;
+};
+
+/////////////////////////////////////////////////////////
+// WORKLOAD
+/////////////////////////////////////////////////////////
+
+volatile bool is_running = true;
+
+// of every client and request type
+PadInt *commit_counts;
+stats::LatencyHistogram *request_latencies;
+
+// of every client
+PadInt *abort_counts;
+
+// clients that could not connect or lost their connection
+std::atomic<int> failed_client_count;
+
+void RunClient(const size_t client_id) {
+  PostgresClient client;
+  if (ConnectClient(client) == false ||
+      (state.protocol == QueryProtocol::EXTENDED &&
+       PrepareStatements(client) == false)) {
+    failed_client_count++;
+    return;
+  }
+
+  RequestGenerator generator(client_id);
+  std::vector<Request> pipeline;
+
+  while (is_running == true) {
+    pipeline.clear();
+    for (int i = 0; i < state.pipeline_depth; i++) {
+      pipeline.push_back(generator.NextRequest());
+      for (auto &statement : pipeline.back().statements) {
+        SendStatement(client, statement);
+      }
+    }
+
+    // the latency of a request runs from sending the pipeline
+    auto start_time = std::chrono::steady_clock::now();
+    if (client.Flush() == false) {
+      failed_client_count++;
+      return;
+    }
+
+    bool rolling_back = false;
+    for (auto &request : pipeline) {
+      bool failed = false;
+      for (size_t i = 0; i < request.statements.size(); i++) {
+        QueryResult result;
+        if (client.ReadResult(result) == false) {
+          failed_client_count++;
+          return;
+        }
+        failed = failed || result.error;
+      }
+
+      if (failed == true) {
+        abort_counts[client_id].data++;
+        rolling_back = rolling_back || request.statements.size() > 1;
+        continue;
+      }
+
+      std::chrono::duration<double, std::milli> latency =
+          std::chrono::steady_clock::now() - start_time;
+      size_t count_idx =
+          client_id * request_type_count + static_cast<size_t>(request.type);
+      request_latencies[count_idx].Record(latency.count());
+      commit_counts[count_idx].data++;
+    }
+
+    // leave a transaction that failed before its commit
+    if (rolling_back == true) {
+      QueryResult result;
+      client.SendQuery("ROLLBACK");
+      if (client.Flush() == false || client.ReadResult(result) == false) {
+        failed_client_count++;
+        return;
+      }
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////
+// SERVER LATENCIES
+/////////////////////////////////////////////////////////
+
+// A latency histogram of the server, from its metrics
+struct ServerHistogram {
+  // the upper bounds (s) of the buckets and their cumulative counts
+  std::vector<std::pair<double, double>> buckets;
+
+  double sum = 0;
+
+  double count = 0;
+};
+
+// The value of the sample with the name and labels, 0 if there is none
+static double FindSample(const std::string &metrics,
+                         const std::string &series) {
+  auto position = metrics.find("\n" + series + " ");
+  if (position == std::string::npos) {
+    return 0;
+  }
+  return std::strtod(metrics.c_str() + position + series.size() + 2, nullptr);
+}
+
+// The histogram of the name, labelled with the labels "name=\"value\"" if
+// there are any
+static ServerHistogram ParseHistogram(const std::string &metrics,
+                                      const std::string &name,
+                                      const std::string &labels) {
+  ServerHistogram histogram;
+  std::string bucket_prefix =
+      "\n" + name + "_bucket{" + labels + (labels.empty() ? "" : ",") + "le=\"";
+
+  size_t position = 0;
+  while ((position = metrics.find(bucket_prefix, position)) !=
+         std::string::npos) {
+    position += bucket_prefix.size();
+    auto bound_end = metrics.find('"', position);
+    if (bound_end == std::string::npos) {
+      break;
+    }
+    auto bound = metrics.substr(position, bound_end - position);
+    if (bound != "+Inf") {
+      // the +Inf bucket counts them all, as the count does
+      histogram.buckets.emplace_back(
+          std::strtod(bound.c_str(), nullptr),
+          std::strtod(metrics.c_str() + bound_end + 3, nullptr));
+    }
+    position = bound_end;
+  }
+
+  auto series_labels = labels.empty() ? "" : "{" + labels + "}";
+  histogram.sum = FindSample(metrics, name + "_sum" + series_labels);
+  histogram.count = FindSample(metrics, name + "_count" + series_labels);
+  return histogram;
+}
+
+// The latency (ms) at the percentile, interpolated within its bucket as
+// Prometheus does. The highest bound if it is past all of them.
+static double GetPercentile(const ServerHistogram &histogram,
+                            const double percentile) {
+  double rank = histogram.count * percentile / 100;
+  double lower_bound = 0;
+  double lower_count = 0;
+  for (auto &bucket : histogram.buckets) {
+    if (bucket.second >= rank) {
+      double bucket_count = bucket.second - lower_count;
+      double fraction =
+          bucket_count > 0 ? (rank - lower_count) / bucket_count : 1;
+      return (lower_bound + (bucket.first - lower_bound) * fraction) * 1000;
+    }
+    lower_bound = bucket.first;
+    lower_count = bucket.second;
+  }
+  return lower_bound * 1000;
+}
+
+// The latencies of the run, from the histograms before and after it
+static LatencyResult DiffHistograms(const ServerHistogram &before,
+                                    const ServerHistogram &after) {
+  ServerHistogram run = after;
+  run.sum -= before.sum;
+  run.count -= before.count;
+  for (size_t i = 0; i < run.buckets.size() && i < before.buckets.size();
+       i++) {
+    run.buckets[i].second -= before.buckets[i].second;
+  }
+
+  LatencyResult result;
+  if (run.count <= 0) {
+    return result;
+  }
+  result.throughput = run.count / state.duration;
+  result.average_latency = run.sum / run.count * 1000;
+  result.p50_latency = GetPercentile(run, 50);
+  result.p95_latency = GetPercentile(run, 95);
+  result.p99_latency = GetPercentile(run, 99);
+  return result;
+}
+
+// The metrics of the server, empty if it does not serve them
+static std::string FetchMetrics() {
+  std::string metrics;
+  if (state.metrics_port != 0 &&
+      FetchHttp(state.host, state.metrics_port, "/metrics", metrics) == false) {
+    LOG_ERROR("Cannot fetch the metrics of %s:%d", state.host.c_str(),
+              state.metrics_port);
+  }
+  return metrics;
+}
+
+void RunWorkload() {
+  size_t num_clients = state.client_count;
+  size_t count_size = num_clients * request_type_count;
+
+  commit_counts = new PadInt[count_size];
+  request_latencies = new stats::LatencyHistogram[count_size];
+  abort_counts = new PadInt[num_clients];
+  failed_client_count = 0;
+  is_running = true;
+
+  // the server metrics are published once per aggregation of its statistics,
+  // so they cover the run up to an interval
+  auto metrics_before = FetchMetrics();
+
+  // Launch a group of clients
+  std::vector<std::thread> thread_group;
+  for (size_t client_itr = 0; client_itr < num_clients; ++client_itr) {
+    thread_group.push_back(std::thread(RunClient, client_itr));
+  }
+
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(int(state.duration * 1000)));
+  is_running = false;
+
+  // Join the clients with the main thread
+  for (size_t client_itr = 0; client_itr < num_clients; ++client_itr) {
+    thread_group[client_itr].join();
+  }
+
+  auto metrics_after = FetchMetrics();
+
+  if (failed_client_count > 0) {
+    LOG_ERROR("%d clients failed", failed_client_count.load());
+  }
+
+  // client-side throughput, abort rate and latencies
+  uint64_t total_commit_count = 0;
+  uint64_t total_abort_count = 0;
+  for (size_t client_itr = 0; client_itr < num_clients; ++client_itr) {
+    total_abort_count += abort_counts[client_itr].data;
+  }
+
+  state.request_results.clear();
+  for (size_t type_id = 0; type_id < request_type_count; ++type_id) {
+    stats::LatencyHistogram latencies;
+    uint64_t commit_count = 0;
+    for (size_t client_itr = 0; client_itr < num_clients; ++client_itr) {
+      size_t count_idx = client_itr * request_type_count + type_id;
+      latencies.Merge(request_latencies[count_idx]);
+      commit_count += commit_counts[count_idx].data;
+    }
+    total_commit_count += commit_count;
+
+    LatencyResult result;
+    result.throughput = commit_count * 1.0 / state.duration;
+    result.average_latency = latencies.GetAverage();
+    result.p50_latency = latencies.GetPercentile(50);
+    result.p95_latency = latencies.GetPercentile(95);
+    result.p99_latency = latencies.GetPercentile(99);
+    state.request_results.push_back(result);
+  }
+
+  state.throughput = total_commit_count * 1.0 / state.duration;
+  state.abort_rate =
+      total_commit_count == 0 ? 0 : total_abort_count * 1.0 /
+                                        total_commit_count;
+
+  // server-side latencies of every query type and of the transactions
+  state.has_server_results =
+      metrics_before.empty() == false && metrics_after.empty() == false;
+  if (state.has_server_results == true) {
+    state.server_query_results.clear();
+    for (auto &query_type : server_query_types) {
+      auto labels = "type=\"" + query_type + "\"";
+      state.server_query_results.push_back(DiffHistograms(
+          ParseHistogram(metrics_before, "peloton_query_latency_seconds",
+                         labels),
+          ParseHistogram(metrics_after, "peloton_query_latency_seconds",
+                         labels)));
+    }
+    state.server_txn_result = DiffHistograms(
+        ParseHistogram(metrics_before, "peloton_txn_latency_seconds", ""),
+        ParseHistogram(metrics_after, "peloton_txn_latency_seconds", ""));
+  }
+
+  // cleanup everything.
+  delete[] commit_counts;
+  commit_counts = nullptr;
+  delete[] request_latencies;
+  request_latencies = nullptr;
+  delete[] abort_counts;
+  abort_counts = nullptr;
+}
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
@@ -18,9 +18,11 @@
 #include "benchmark/ycsb/ycsb_configuration.h"
 #include "benchmark/ycsb/ycsb_loader.h"
 #include "benchmark/ycsb/ycsb_workload.h"
+#include "benchmark/memory_report.h"
 
 #include "gc/gc_manager_factory.h"
 #include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
 
 namespace peloton {
 namespace benchmark {
@@ -38,6 +40,8 @@ void RunBenchmark() {
   }
 
   concurrency::EpochManagerFactory::Configure(state.epoch);
+
+  concurrency::TransactionManagerFactory::Configure(state.protocol);
   
   std::unique_ptr<std::thread> epoch_thread;
   std::vector<std::unique_ptr<std::thread>> gc_threads;
@@ -59,12 +63,23 @@ void RunBenchmark() {
   // start GC.
   gc_manager.StartGC(gc_threads);
 
+  auto memory_before = stats::MemoryUsage::GetTracked();
+
   // Create the database
   CreateYCSBDatabase();
 
   // Load the databases
   LoadYCSBDatabase();
 
+  // Every scale factor is a run of its own
+  if (state.memory_report == true) {
+    auto memory_after = stats::MemoryUsage::GetTracked();
+    memory_after.AddTable(user_table);
+    std::ofstream out("outputfile.memory");
+    WriteMemoryReport(out, std::to_string(state.scale_factor), memory_before,
+                      memory_after);
+  }
+
   // Run the workload
   RunWorkload();
   
@@ -35,13 +35,21 @@ void Usage(FILE *out) {
           "   -c --column_count      :  # of columns \n"
           "   -o --operation_count   :  # of operations \n"
           "   -u --update_ratio      :  fraction of updates \n"
+          "   -w --workload          :  core workload: a, b, c, d, e or f \n"
+          "   -r --distribution      :  keys: zipf, uniform, latest or hotspot \n"
           "   -z --zipf_theta        :  theta to control skewness \n"
-          "   -e --exp_backoff       :  enable exponential backoff \n"
+          "   -x --hotspot_fraction  :  fraction of hot keys \n"
+          "   -q --hotspot_ops       :  fraction of operations on hot keys \n"
+          "   -s --max_scan_length   :  max # of records in a scan \n"
+          "   -v --value_size        :  length of a field in string mode \n"
+          "   -e --exp_backoff       :  enable contention-aware backoff \n"
           "   -m --string_mode       :  store strings \n"
           "   -g --gc_mode           :  enable garbage collection \n"
           "   -n --gc_backend_count  :  # of gc backends \n"
           "   -l --loader_count      :  # of loaders \n"
           "   -y --epoch             :  epoch type: centralized or decentralized \n"
+          "   -t --protocol          :  concurrency control: to (default) or occ \n"
+          "   -a --memory_report     :  report the memory per tuple of every component \n"
   );
 }
 
@@ -54,16 +62,52 @@ static struct option opts[] = {
     { "column_count", optional_argument, NULL, 'c' },
     { "operation_count", optional_argument, NULL, 'o' },
     { "update_ratio", optional_argument, NULL, 'u' },
+    { "workload", optional_argument, NULL, 'w' },
+    { "distribution", optional_argument, NULL, 'r' },
     { "zipf_theta", optional_argument, NULL, 'z' },
+    { "hotspot_fraction", optional_argument, NULL, 'x' },
+    { "hotspot_ops", optional_argument, NULL, 'q' },
+    { "max_scan_length", optional_argument, NULL, 's' },
+    { "value_size", optional_argument, NULL, 'v' },
     { "exp_backoff", no_argument, NULL, 'e' },
     { "string_mode", no_argument, NULL, 'm' },
     { "gc_mode", no_argument, NULL, 'g' },
     { "gc_backend_count", optional_argument, NULL, 'n' },
-    { "loader_count", optional_argument, NULL, 'n' },
+    { "loader_count", optional_argument, NULL, 'l' },
     { "epoch", optional_argument, NULL, 'y' },
+    { "protocol", optional_argument, NULL, 't' },
+    { "memory_report", no_argument, NULL, 'a' },
     { NULL, 0, NULL, 0 }
 };
 
+std::string OperationTypeToString(OperationType type) {
+  switch (type) {
+    case OperationType::READ:
+      return "READ";
+    case OperationType::UPDATE:
+      return "UPDATE";
+    case OperationType::INSERT:
+      return "INSERT";
+    case OperationType::SCAN:
+      return "SCAN";
+    case OperationType::READ_MODIFY_WRITE:
+      return "READ_MODIFY_WRITE";
+  }
+  return "INVALID";
+}
+
+// Set the operation ratios of the workload
+static void SetOperationRatios(configuration &state, double read_ratio,
+                               double update_ratio, double insert_ratio,
+                               double scan_ratio,
+                               double read_modify_write_ratio) {
+  state.read_ratio = read_ratio;
+  state.update_ratio = update_ratio;
+  state.insert_ratio = insert_ratio;
+  state.scan_ratio = scan_ratio;
+  state.read_modify_write_ratio = read_modify_write_ratio;
+}
+
 void ValidateIndex(const configuration &state) {
   if (state.index != IndexType::BWTREE && state.index != IndexType::BWTREE) {
     LOG_ERROR("Invalid index");
@@ -134,6 +178,39 @@ void ValidateUpdateRatio(const configuration &state) {
   LOG_TRACE("%s : %lf", "update_ratio", state.update_ratio);
 }
 
+void ValidateScanLength(const configuration &state) {
+  if (state.max_scan_length <= 0) {
+    LOG_ERROR("Invalid max_scan_length :: %d", state.max_scan_length);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "max_scan_length", state.max_scan_length);
+}
+
+void ValidateHotspot(const configuration &state) {
+  if (state.hotspot_fraction <= 0 || state.hotspot_fraction >= 1) {
+    LOG_ERROR("Invalid hotspot_fraction :: %lf", state.hotspot_fraction);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.hotspot_ops < 0 || state.hotspot_ops > 1) {
+    LOG_ERROR("Invalid hotspot_ops :: %lf", state.hotspot_ops);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %lf", "hotspot_fraction", state.hotspot_fraction);
+  LOG_TRACE("%s : %lf", "hotspot_ops", state.hotspot_ops);
+}
+
+void ValidateValueSize(const configuration &state) {
+  if (state.value_size <= 0) {
+    LOG_ERROR("Invalid value_size :: %d", state.value_size);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_TRACE("%s : %d", "value_size", state.value_size);
+}
+
 void ValidateZipfTheta(const configuration &state) {
   if (state.zipf_theta < 0 || state.zipf_theta > 1.0) {
     LOG_ERROR("Invalid zipf_theta :: %lf", state.zipf_theta);
@@ -156,6 +233,7 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   // Default Values
   state.index = IndexType::BWTREE;
   state.epoch = EpochType::DECENTRALIZED_EPOCH;
+  state.protocol = ProtocolType::TIMESTAMP_ORDERING;
   state.scale_factor = 1;
   state.duration = 10;
   state.profile_duration = 1;
@@ -164,16 +242,27 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   state.operation_count = 10;
   state.update_ratio = 0.5;
   state.zipf_theta = 0.0;
+  state.workload = WorkloadType::CUSTOM;
+  state.distribution = DistributionType::ZIPF;
+  state.max_scan_length = 100;
+  state.hotspot_fraction = 0.2;
+  state.hotspot_ops = 0.8;
+  state.value_size = ycsb_field_length;
   state.exp_backoff = false;
   state.string_mode = false;
   state.gc_mode = false;
   state.gc_backend_count = 1;
   state.loader_count = 1;
+  state.memory_report = false;
+
+  // the core workloads pick their own distribution, unless it is given
+  bool distribution_set = false;
+  bool zipf_theta_set = false;
 
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "hemgi:k:d:p:b:c:o:u:z:n:l:y:", opts, &idx);
+    int c = getopt_long(argc, argv, "hemgai:k:d:p:b:c:o:u:w:r:z:x:q:s:v:n:l:y:t:", opts, &idx);
 
     if (c == -1) break;
 
@@ -198,6 +287,18 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
         }
         break;
       }
+      case 't': {
+        char *protocol = optarg;
+        if (strcmp(protocol, "to") == 0) {
+          state.protocol = ProtocolType::TIMESTAMP_ORDERING;
+        } else if (strcmp(protocol, "occ") == 0) {
+          state.protocol = ProtocolType::OPTIMISTIC;
+        } else {
+          LOG_ERROR("Unknown protocol: %s", protocol);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
       case 'l':
         state.loader_count = atoi(optarg);
         break;
@@ -222,8 +323,49 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'u':
         state.update_ratio = atof(optarg);
         break;
+      case 'w': {
+        char *workload = optarg;
+        if (strlen(workload) == 1 && workload[0] >= 'a' && workload[0] <= 'f') {
+          state.workload =
+              static_cast<WorkloadType>(workload[0] - 'a' + 1);
+        } else {
+          LOG_ERROR("Unknown workload: %s", workload);
+          exit(EXIT_FAILURE);
+        }
+        break;
+      }
+      case 'r': {
+        char *distribution = optarg;
+        if (strcmp(distribution, "zipf") == 0) {
+          state.distribution = DistributionType::ZIPF;
+        } else if (strcmp(distribution, "uniform") == 0) {
+          state.distribution = DistributionType::UNIFORM;
+        } else if (strcmp(distribution, "latest") == 0) {
+          state.distribution = DistributionType::LATEST;
+        } else if (strcmp(distribution, "hotspot") == 0) {
+          state.distribution = DistributionType::HOTSPOT;
+        } else {
+          LOG_ERROR("Unknown distribution: %s", distribution);
+          exit(EXIT_FAILURE);
+        }
+        distribution_set = true;
+        break;
+      }
       case 'z':
         state.zipf_theta = atof(optarg);
+        zipf_theta_set = true;
+        break;
+      case 'x':
+        state.hotspot_fraction = atof(optarg);
+        break;
+      case 'q':
+        state.hotspot_ops = atof(optarg);
+        break;
+      case 's':
+        state.max_scan_length = atoi(optarg);
+        break;
+      case 'v':
+        state.value_size = atoi(optarg);
         break;
       case 'e':
         state.exp_backoff = true;
@@ -234,6 +376,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'g':
         state.gc_mode = true;
         break;
+      case 'a':
+        state.memory_report = true;
+        break;
       case 'n':
         state.gc_backend_count = atoi(optarg);
         break;
@@ -251,6 +396,39 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
     }
   }
 
+  // The ratios of the core workloads. Their keys are zipfian, with the theta
+  // of YCSB, except for the latest ones of D.
+  switch (state.workload) {
+    case WorkloadType::CUSTOM:
+      SetOperationRatios(state, 1 - state.update_ratio, state.update_ratio, 0,
+                         0, 0);
+      break;
+    case WorkloadType::A:
+      SetOperationRatios(state, 0.5, 0.5, 0, 0, 0);
+      break;
+    case WorkloadType::B:
+      SetOperationRatios(state, 0.95, 0.05, 0, 0, 0);
+      break;
+    case WorkloadType::C:
+      SetOperationRatios(state, 1, 0, 0, 0, 0);
+      break;
+    case WorkloadType::D:
+      SetOperationRatios(state, 0.95, 0, 0.05, 0, 0);
+      if (distribution_set == false) {
+        state.distribution = DistributionType::LATEST;
+      }
+      break;
+    case WorkloadType::E:
+      SetOperationRatios(state, 0, 0, 0.05, 0.95, 0);
+      break;
+    case WorkloadType::F:
+      SetOperationRatios(state, 0.5, 0, 0, 0, 0.5);
+      break;
+  }
+  if (state.workload != WorkloadType::CUSTOM && zipf_theta_set == false) {
+    state.zipf_theta = 0.99;
+  }
+
   // Print configuration
   ValidateIndex(state);
   ValidateScaleFactor(state);
@@ -260,6 +438,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   ValidateColumnCount(state);
   ValidateOperationCount(state);
   ValidateUpdateRatio(state);
+  ValidateScanLength(state);
+  ValidateHotspot(state);
+  ValidateValueSize(state);
   ValidateZipfTheta(state);
   ValidateGCBackendCount(state);
 
@@ -309,6 +490,41 @@ void WriteOutput() {
         << state.profile_abort_rate[round_id] << " "
         << state.profile_memory[round_id] << "\n";
   }
+
+  // throughput and latencies (ms) of the transactions and of every operation
+  LOG_INFO("%-18s %12s %9s %9s %9s %9s %9s", "operation", "op/s", "avg ms",
+           "p50 ms", "p95 ms", "p99 ms", "max ms");
+  std::vector<std::pair<std::string, const OperationResult *>> results;
+  results.emplace_back("TRANSACTION", &state.transaction_result);
+  for (size_t type_id = 0; type_id < operation_type_count; type_id++) {
+    results.emplace_back(
+        OperationTypeToString(static_cast<OperationType>(type_id)),
+        &state.operation_results[type_id]);
+  }
+
+  std::ofstream latency_out("outputfile.latency");
+  for (auto &entry : results) {
+    auto &result = *entry.second;
+    LOG_INFO("%-18s %12.1lf %9.3lf %9.3lf %9.3lf %9.3lf %9.3lf",
+             entry.first.c_str(), result.throughput, result.average_latency,
+             result.p50_latency, result.p95_latency, result.p99_latency,
+             result.max_latency);
+
+    out << entry.first << " " << result.throughput << " "
+        << result.average_latency << " " << result.p50_latency << " "
+        << result.p95_latency << " " << result.p99_latency << " "
+        << result.max_latency << "\n";
+
+    // one line per bucket: the latency bound (ms) and the operations up to it
+    // above the bound before
+    latency_out << entry.first << "\n";
+    for (auto &bucket : result.histogram) {
+      latency_out << "<= " << bucket.first << " ms: " << bucket.second << "\n";
+    }
+  }
+  latency_out.flush();
+  latency_out.close();
+
   out.flush();
   out.close();
 }
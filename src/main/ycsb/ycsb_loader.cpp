@@ -36,6 +36,7 @@
 #include "storage/data_table.h"
 #include "storage/table_factory.h"
 #include "storage/database.h"
+#include "type/ephemeral_pool.h"
 
 // Logging mode
 // extern peloton::LoggingType peloton_logging_mode;
@@ -77,7 +78,7 @@ void CreateYCSBDatabase() {
   if (state.string_mode == true) {
     for (oid_t col_itr = 1; col_itr < col_count; col_itr++) {
         auto column =
-            catalog::Column(type::TypeId::VARCHAR, 100,
+            catalog::Column(type::TypeId::VARCHAR, state.value_size,
                             "FIELD" + std::to_string(col_itr), is_inlined);
         columns.push_back(column);
     }
@@ -151,7 +152,7 @@ void LoadYCSBRows(const int begin_rowid, const int end_rowid) {
 
 
     if (state.string_mode == true) {
-      auto key_value = type::ValueFactory::GetVarcharValue(std::string(100, 'z'));
+      auto key_value = type::ValueFactory::GetVarcharValue(std::string(state.value_size, 'z'));
       for (oid_t col_itr = 1; col_itr < col_count; col_itr++) {
         tuple->SetValue(col_itr, key_value, pool.get());
       }
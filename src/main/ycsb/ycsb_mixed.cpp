@@ -36,6 +36,8 @@
 #include "type/types.h"
 #include "type/value.h"
 #include "type/value_factory.h"
+#include "type/value_peeker.h"
+#include "type/ephemeral_pool.h"
 #include "common/logger.h"
 #include "common/timer.h"
 #include "common/generator.h"
@@ -71,161 +73,238 @@
 
 #include "storage/data_table.h"
 #include "storage/table_factory.h"
+#include "storage/tuple.h"
 
 namespace peloton {
 namespace benchmark {
 namespace ycsb {
 
-  
-bool RunMixed(const size_t thread_id, ZipfDistribution &zipf, FastRandom &rng) {
-
-  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-
-  concurrency::Transaction *txn = txn_manager.BeginTransaction(thread_id);
-
-  std::unique_ptr<executor::ExecutorContext> context(
-      new executor::ExecutorContext(txn));
-
-  // Column ids to be added to logical tile.
+// The index scan of the records with keys from low_key up to high_key,
+// reading all their attributes
+static std::unique_ptr<planner::IndexScanPlan> KeyRangeScan(int low_key,
+                                                            int high_key) {
   std::vector<oid_t> column_ids;
   oid_t column_count = state.column_count + 1;
-
-  // read all the attributes in a tuple.
   for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
     column_ids.push_back(col_itr);
   }
 
-  // Create and set up index scan executor
   std::vector<oid_t> key_column_ids;
   std::vector<ExpressionType> expr_types;
+  std::vector<type::Value> values;
+  std::vector<expression::AbstractExpression *> runtime_keys;
 
-  key_column_ids.push_back(0);
-  expr_types.push_back(ExpressionType::COMPARE_EQUAL);
+  if (low_key == high_key) {
+    key_column_ids.push_back(0);
+    expr_types.push_back(ExpressionType::COMPARE_EQUAL);
+    values.push_back(type::ValueFactory::GetIntegerValue(low_key).Copy());
+  } else {
+    key_column_ids.push_back(0);
+    expr_types.push_back(ExpressionType::COMPARE_GREATERTHANOREQUALTO);
+    values.push_back(type::ValueFactory::GetIntegerValue(low_key).Copy());
 
-  std::vector<expression::AbstractExpression *> runtime_keys;
-  
-  for (int i = 0; i < state.operation_count; i++) {
+    key_column_ids.push_back(0);
+    expr_types.push_back(ExpressionType::COMPARE_LESSTHANOREQUALTO);
+    values.push_back(type::ValueFactory::GetIntegerValue(high_key).Copy());
+  }
 
-    auto rng_val = rng.NextUniform();
+  auto ycsb_pkey_index = user_table->GetIndexWithOid(user_table_pkey_index_oid);
 
-    if (rng_val < state.update_ratio) {
-      /////////////////////////////////////////////////////////
-      // PERFORM UPDATE
-      /////////////////////////////////////////////////////////
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      ycsb_pkey_index, key_column_ids, expr_types, values, runtime_keys);
 
-      // set up parameter values
-      std::vector<type::Value > values;
+  // Create plan node.
+  auto predicate = nullptr;
 
-      auto lookup_key = zipf.GetNextNumber();
+  return std::unique_ptr<planner::IndexScanPlan>(new planner::IndexScanPlan(
+      user_table, predicate, column_ids, index_scan_desc));
+}
 
-      values.push_back(type::ValueFactory::GetIntegerValue(lookup_key).Copy());
+// The value every field of a record is loaded or inserted with
+static type::Value FieldValue(int key) {
+  if (state.string_mode == true) {
+    return type::ValueFactory::GetVarcharValue(
+        std::string(state.value_size, 'z')).Copy();
+  } else {
+    return type::ValueFactory::GetIntegerValue(key).Copy();
+  }
+}
 
-      auto ycsb_pkey_index = user_table->GetIndexWithOid(user_table_pkey_index_oid);
-    
-      planner::IndexScanPlan::IndexScanDesc index_scan_desc(
-          ycsb_pkey_index, key_column_ids, expr_types, values, runtime_keys);
+static std::vector<std::vector<type::Value>> ReadRecords(
+    executor::ExecutorContext *context, int low_key, int high_key) {
+  auto index_scan_node = KeyRangeScan(low_key, high_key);
 
-      // Create plan node.
-      auto predicate = nullptr;
+  executor::IndexScanExecutor index_scan_executor(index_scan_node.get(),
+                                                  context);
 
-      planner::IndexScanPlan index_scan_node(user_table, predicate, column_ids,
-                                             index_scan_desc);
+  return ExecuteRead(&index_scan_executor);
+}
 
-      // Run the executor
-      executor::IndexScanExecutor index_scan_executor(&index_scan_node,
-                                                      context.get());
+// Set the first field of the record to the value
+static void UpdateRecord(executor::ExecutorContext *context, int key,
+                         const type::Value &update_val) {
+  auto index_scan_node = KeyRangeScan(key, key);
 
-      TargetList target_list;
-      DirectMapList direct_map_list;
+  executor::IndexScanExecutor index_scan_executor(index_scan_node.get(),
+                                                  context);
 
-      // update multiple attributes
-      for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
-        if (col_itr == 1) {
-          if (state.string_mode == true) {
+  TargetList target_list;
+  DirectMapList direct_map_list;
 
-            std::string update_raw_value(100, 'a');
-            type::Value update_val = type::ValueFactory::GetVarcharValue(update_raw_value).Copy();
+  oid_t column_count = state.column_count + 1;
+  for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
+    if (col_itr == 1) {
+      planner::DerivedAttribute attr{
+          expression::ExpressionUtil::ConstantValueFactory(update_val)};
+      target_list.emplace_back(col_itr, attr);
+    } else {
+      direct_map_list.emplace_back(col_itr,
+                                   std::pair<oid_t, oid_t>(0, col_itr));
+    }
+  }
 
-            planner::DerivedAttribute attr{
-                expression::ExpressionUtil::ConstantValueFactory(update_val)};
-            target_list.emplace_back(col_itr, attr);
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(std::move(target_list),
+                               std::move(direct_map_list)));
+  planner::UpdatePlan update_node(user_table, std::move(project_info));
 
-          } else {
+  executor::UpdateExecutor update_executor(&update_node, context);
 
-            int update_raw_value = 1;
-            type::Value update_val = type::ValueFactory::GetIntegerValue(update_raw_value).Copy();
+  update_executor.AddChild(&index_scan_executor);
 
-            planner::DerivedAttribute attr{
-                expression::ExpressionUtil::ConstantValueFactory(update_val)};
-            target_list.emplace_back(col_itr, attr);
-          }
-        }
-        else {
-          direct_map_list.emplace_back(col_itr,
-                                       std::pair<oid_t, oid_t>(0, col_itr));
-        }
-      }
+  ExecuteUpdate(&update_executor);
+}
 
-      std::unique_ptr<const planner::ProjectInfo> project_info(
-          new planner::ProjectInfo(std::move(target_list),
-                                   std::move(direct_map_list)));
-      planner::UpdatePlan update_node(user_table, std::move(project_info));
+static void InsertRecord(executor::ExecutorContext *context, int key) {
+  const oid_t column_count = state.column_count + 1;
+  const bool allocate = true;
 
-      executor::UpdateExecutor update_executor(&update_node, context.get());
+  std::unique_ptr<type::AbstractPool> pool(new type::EphemeralPool());
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(user_table->GetSchema(), allocate));
 
-      update_executor.AddChild(&index_scan_executor);
+  tuple->SetValue(0, type::ValueFactory::GetIntegerValue(key), nullptr);
+  auto field_value = FieldValue(key);
+  for (oid_t col_itr = 1; col_itr < column_count; col_itr++) {
+    tuple->SetValue(col_itr, field_value, pool.get());
+  }
 
-      ExecuteUpdate(&update_executor);
+  planner::InsertPlan insert_node(user_table, std::move(tuple));
+  executor::InsertExecutor insert_executor(&insert_node, context);
+  insert_executor.Execute();
+}
 
-      if (txn->GetResult() != ResultType::SUCCESS) {
-        txn_manager.AbortTransaction(txn);
-        return false;
-      }
+// Pick the type of the next operation by the ratios of the workload
+static OperationType NextOperationType(FastRandom &rng) {
+  auto rng_val = rng.NextUniform();
 
-    } else {
-      /////////////////////////////////////////////////////////
-      // PERFORM READ
-      /////////////////////////////////////////////////////////
+  if ((rng_val -= state.read_ratio) < 0) {
+    return OperationType::READ;
+  }
+  if ((rng_val -= state.update_ratio) < 0) {
+    return OperationType::UPDATE;
+  }
+  if ((rng_val -= state.insert_ratio) < 0) {
+    return OperationType::INSERT;
+  }
+  if ((rng_val -= state.scan_ratio) < 0) {
+    return OperationType::SCAN;
+  }
+  return OperationType::READ_MODIFY_WRITE;
+}
 
-      // set up parameter values
-      std::vector<type::Value > values;
+bool RunMixed(const size_t thread_id, KeyGenerator &key_generator,
+              FastRandom &rng) {
 
-      auto lookup_key = zipf.GetNextNumber();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
-      values.push_back(type::ValueFactory::GetIntegerValue(lookup_key).Copy());
+  concurrency::Transaction *txn = txn_manager.BeginTransaction(thread_id);
 
-      auto ycsb_pkey_index = user_table->GetIndexWithOid(user_table_pkey_index_oid);
-    
-      planner::IndexScanPlan::IndexScanDesc index_scan_desc(
-          ycsb_pkey_index, key_column_ids, expr_types, values, runtime_keys);
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
 
-      // Create plan node.
-      auto predicate = nullptr;
+  // the operations of every type, counted once the transaction commits
+  size_t type_counts[operation_type_count] = {0};
 
-      planner::IndexScanPlan index_scan_node(user_table, predicate, column_ids,
-                                             index_scan_desc);
+  for (int i = 0; i < state.operation_count; i++) {
 
-      // Run the executor
-      executor::IndexScanExecutor index_scan_executor(&index_scan_node,
-                                                      context.get());
+    auto type = NextOperationType(rng);
 
-      
-      
-      ExecuteRead(&index_scan_executor);
+    Timer<std::ratio<1, 1000>> timer;
+    timer.Start();
 
-      if (txn->GetResult() != ResultType::SUCCESS) {
-        txn_manager.AbortTransaction(txn);
-        return false;
+    switch (type) {
+      case OperationType::READ: {
+        int key = key_generator.NextKey();
+        ReadRecords(context.get(), key, key);
+        break;
+      }
+      case OperationType::UPDATE: {
+        UpdateRecord(context.get(), key_generator.NextKey(),
+                     state.string_mode == true
+                         ? type::ValueFactory::GetVarcharValue(
+                               std::string(state.value_size, 'a')).Copy()
+                         : type::ValueFactory::GetIntegerValue(1).Copy());
+        break;
+      }
+      case OperationType::INSERT: {
+        InsertRecord(context.get(), KeyGenerator::NextInsertKey());
+        break;
       }
+      case OperationType::SCAN: {
+        int low_key = key_generator.NextKey();
+        int length = 1 + rng.next_u32() % state.max_scan_length;
+        ReadRecords(context.get(), low_key, low_key + length - 1);
+        break;
+      }
+      case OperationType::READ_MODIFY_WRITE: {
+        int key = key_generator.NextKey();
+        auto records = ReadRecords(context.get(), key, key);
+        if (txn->GetResult() != ResultType::SUCCESS || records.empty()) {
+          break;
+        }
+
+        // write back the first field, changed
+        auto value = records[0][1];
+        if (state.string_mode == true) {
+          auto update_raw_value = value.ToString();
+          update_raw_value[0] = update_raw_value[0] == 'a' ? 'b' : 'a';
+          UpdateRecord(context.get(), key,
+                       type::ValueFactory::GetVarcharValue(update_raw_value)
+                           .Copy());
+        } else {
+          UpdateRecord(context.get(), key,
+                       type::ValueFactory::GetIntegerValue(
+                           type::ValuePeeker::PeekInteger(value) + 1).Copy());
+        }
+        break;
+      }
+    }
+
+    timer.Stop();
+    operation_latencies[thread_id * operation_type_count +
+                        static_cast<size_t>(type)].Record(timer.GetDuration());
+    type_counts[static_cast<size_t>(type)]++;
+
+    if (txn->GetResult() != ResultType::SUCCESS) {
+      txn_manager.AbortTransaction(txn);
+      return false;
     }
   }
 
   // transaction passed execution.
   PL_ASSERT(txn->GetResult() == ResultType::SUCCESS);
 
-  auto result = txn_manager.CommitTransaction(txn);
+  // acknowledged once durable when group commit runs, see the logger
+  // benchmark
+  auto result =
+      txn_manager.GroupCommitTransaction(txn, [](const ResultType) {});
 
   if (result == ResultType::SUCCESS) {
+    for (size_t type_id = 0; type_id < operation_type_count; type_id++) {
+      operation_counts[thread_id * operation_type_count + type_id].data +=
+          type_counts[type_id];
+    }
     return true;
     
   } else {
@@ -23,6 +23,7 @@
 #include <random>
 #include <cstddef>
 #include <limits>
+#include <atomic>
 
 #include "benchmark/ycsb/ycsb_workload.h"
 #include "benchmark/ycsb/ycsb_configuration.h"
@@ -40,6 +41,7 @@
 #include "common/platform.h"
 #include "common/container_tuple.h"
 
+#include "concurrency/contention_manager.h"
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 
@@ -70,6 +72,8 @@
 #include "storage/data_table.h"
 #include "storage/table_factory.h"
 
+#include "statistics/latency_histogram.h"
+
 namespace peloton {
 namespace benchmark {
 namespace ycsb {
@@ -84,6 +88,67 @@ volatile bool is_running = true;
 PadInt *abort_counts;
 PadInt *commit_counts;
 
+PadInt *operation_counts;
+stats::LatencyHistogram *operation_latencies;
+
+// of every thread
+stats::LatencyHistogram *transaction_latencies;
+
+// the key of the next inserted record
+std::atomic<int> next_insert_key;
+
+KeyGenerator::KeyGenerator(FastRandom &rng)
+    : rng_(rng),
+      zipf_((state.scale_factor * 1000) - 1, state.zipf_theta) {}
+
+int KeyGenerator::NextKey() {
+  int key_count = next_insert_key.load();
+
+  switch (state.distribution) {
+    case DistributionType::ZIPF:
+      return zipf_.GetNextNumber();
+    case DistributionType::UNIFORM:
+      return rng_.next_u32() % key_count;
+    case DistributionType::LATEST:
+      // zipf over the age of the records, the last inserted one first
+      return key_count - zipf_.GetNextNumber();
+    case DistributionType::HOTSPOT: {
+      int hot_count = std::max(
+          1, std::min(key_count - 1,
+                      static_cast<int>(key_count * state.hotspot_fraction)));
+      if (rng_.NextUniform() < state.hotspot_ops) {
+        return rng_.next_u32() % hot_count;
+      }
+      return hot_count + rng_.next_u32() % (key_count - hot_count);
+    }
+  }
+  return 0;
+}
+
+int KeyGenerator::NextInsertKey() { return next_insert_key.fetch_add(1); }
+
+// The result of the latencies, merged over the threads, and the throughput
+// of the committed count
+static OperationResult MakeResult(const stats::LatencyHistogram &latencies,
+                                  uint64_t commit_count) {
+  OperationResult result;
+  result.throughput = commit_count * 1.0 / state.duration;
+  result.average_latency = latencies.GetAverage();
+  result.p50_latency = latencies.GetPercentile(50);
+  result.p95_latency = latencies.GetPercentile(95);
+  result.p99_latency = latencies.GetPercentile(99);
+  result.max_latency = latencies.GetMax();
+
+  // the buckets from 1 us up to the largest latency
+  uint64_t last_count = 0;
+  for (double bound = 0.001; last_count < latencies.GetCount(); bound *= 2) {
+    uint64_t count = latencies.GetCountAtMost(bound);
+    result.histogram.emplace_back(bound, count - last_count);
+    last_count = count;
+  }
+  return result;
+}
+
 #ifndef __APPLE__
 void PinToCore(size_t core) {
   cpu_set_t cpuset;
@@ -105,34 +170,28 @@ void RunBackend(const size_t thread_id) {
   PadInt &execution_count_ref = abort_counts[thread_id];
   PadInt &transaction_count_ref = commit_counts[thread_id];
 
-  ZipfDistribution zipf((state.scale_factor * 1000) - 1,
-                        state.zipf_theta);
-
   FastRandom rng(rand());
 
-  // backoff
-  uint32_t backoff_shifts = 0;
+  KeyGenerator key_generator(rng);
 
   while (true) {
     if (is_running == false) {
       break;
     }
-    while (RunMixed(thread_id, zipf, rng) == false) {
+    Timer<std::ratio<1, 1000>> timer;
+    timer.Start();
+    while (RunMixed(thread_id, key_generator, rng) == false) {
       if (is_running == false) {
-        break;
+        return;
       }
       execution_count_ref.data++;
-      // backoff
+      // backoff, scaled by the contention on the conflicting tile group
       if (state.exp_backoff) {
-        if (backoff_shifts < 13) {
-          ++backoff_shifts;
-        }
-        uint64_t sleep_duration = 1UL << backoff_shifts;
-        sleep_duration *= 100;
-        std::this_thread::sleep_for(std::chrono::microseconds(sleep_duration));
+        concurrency::ContentionManager::GetInstance().WaitBeforeRetry();
       }
     }
-    backoff_shifts >>= 1;
+    timer.Stop();
+    transaction_latencies[thread_id].Record(timer.GetDuration());
     transaction_count_ref.data++;
   }
 }
@@ -148,6 +207,13 @@ void RunWorkload() {
   commit_counts = new PadInt[num_threads];
   PL_MEMSET(commit_counts, 0, sizeof(PadInt) * num_threads);
 
+  operation_counts = new PadInt[num_threads * operation_type_count];
+  operation_latencies =
+      new stats::LatencyHistogram[num_threads * operation_type_count];
+  transaction_latencies = new stats::LatencyHistogram[num_threads];
+
+  next_insert_key = state.scale_factor * 1000;
+
   size_t profile_round = (size_t)(state.duration / state.profile_duration);
 
   PadInt **abort_counts_profiles = new PadInt *[profile_round];
@@ -244,6 +310,27 @@ void RunWorkload() {
   state.throughput = total_commit_count * 1.0 / state.duration;
   state.abort_rate = total_abort_count * 1.0 / total_commit_count;
 
+  // the latencies of all threads, including the ones after the last round
+  stats::LatencyHistogram latencies;
+  for (size_t i = 0; i < num_threads; ++i) {
+    latencies.Merge(transaction_latencies[i]);
+  }
+  state.transaction_result = MakeResult(latencies, total_commit_count);
+
+  state.operation_results.clear();
+  for (size_t type_id = 0; type_id < operation_type_count; ++type_id) {
+    stats::LatencyHistogram type_latencies;
+    uint64_t commit_count = 0;
+    for (size_t i = 0; i < num_threads; ++i) {
+      type_latencies.Merge(
+          operation_latencies[i * operation_type_count + type_id]);
+      commit_count +=
+          operation_counts[i * operation_type_count + type_id].data;
+    }
+    state.operation_results.push_back(
+        MakeResult(type_latencies, commit_count));
+  }
+
   //////////////////////////////////////////////////
 
   // cleanup everything.
@@ -266,6 +353,12 @@ void RunWorkload() {
   abort_counts = nullptr;
   delete[] commit_counts;
   commit_counts = nullptr;
+  delete[] operation_counts;
+  operation_counts = nullptr;
+  delete[] operation_latencies;
+  operation_latencies = nullptr;
+  delete[] transaction_latencies;
+  transaction_latencies = nullptr;
 
 }
 
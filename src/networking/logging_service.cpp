@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logging_service.cpp
+//
+// Identification: src/networking/logging_service.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "networking/logging_service.h"
+
+#include "common/logger.h"
+#include "logging/logical_log_replica.h"
+
+namespace peloton {
+namespace networking {
+
+void LoggingService::LogRecordReplay(
+    ::google::protobuf::RpcController* controller,
+    const LogRecordReplayRequest* request, LogRecordReplayResponse* response,
+    ::google::protobuf::Closure* done) {
+  if (controller->Failed()) {
+    std::string error = controller->ErrorText();
+    LOG_TRACE("LoggingService with controller failed:%s ", error.c_str());
+  }
+
+  // If request is not null, this is a batch shipped to the replica
+  if (request != NULL) {
+    eid_t replicated_epoch_id =
+        logging::LogicalLogReplica::GetInstance().ReceiveLog(
+            request->logger_id(), request->logger_count(),
+            request->sequence_number(), request->log());
+
+    response->set_sequence_number(request->sequence_number());
+    response->set_replicated_epoch_id(replicated_epoch_id);
+
+    // if callback exist, run it
+    if (done) {
+      done->Run();
+    }
+  }
+  // Here is for the primary, answered by a replica
+  else {
+    LOG_TRACE("Replica applied the epochs up to %lu at batch %ld",
+              response->replicated_epoch_id(), response->sequence_number());
+  }
+}
+
+}  // namespace networking
+}  // namespace peloton
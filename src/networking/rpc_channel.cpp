@@ -68,29 +68,6 @@ void RpcChannel::CallMethod(
   /*  we use unit64_t because we should specify the exact length */
   uint64_t opcode = string_hash_fn(methodname);
 
-  /* prepare the sending buf */
-  uint32_t msg_len = request->ByteSize() + OPCODELEN + TYPELEN;
-
-  /* total length of the message: header length (4bytes) + message length
-   * (8bytes + ...) */
-  PL_ASSERT(HEADERLEN == sizeof(msg_len));
-  char buf[HEADERLEN + msg_len];
-
-  /* copy the header into the buf */
-  PL_MEMCPY(buf, &msg_len, sizeof(msg_len));
-
-  /* copy the type into the buf, following the header */
-  PL_ASSERT(TYPELEN == sizeof(type));
-  PL_MEMCPY(buf + HEADERLEN, &type, TYPELEN);
-
-  /*  copy the hashcode into the buf, following the type */
-  PL_ASSERT(OPCODELEN == sizeof(opcode));
-  PL_MEMCPY(buf + HEADERLEN + TYPELEN, &opcode, OPCODELEN);
-
-  /*  call protobuf to serialize the request message into sending buf */
-  request->SerializeToArray(buf + HEADERLEN + TYPELEN + OPCODELEN,
-                            request->ByteSize());
-
   /*
    * GET a connection to process the rpc send and recv. If there is a associated
    * connection
@@ -111,9 +88,12 @@ void RpcChannel::CallMethod(
     return;
   }
 
-  /* write data into sending buffer, when using libevent we don't need loop send
+  /*
+   * Serialize the request straight into the sending buffer, when using
+   * libevent we don't need loop send. The calls made before the buffer is
+   * flushed go out in the same write.
    */
-  if (conn->AddToWriteBuffer(buf, HEADERLEN + msg_len) == false) {
+  if (conn->WriteMessage(type, opcode, *request) == false) {
     LOG_TRACE("Write data Error");
     return;
   }
@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_client.cpp
+//
+// Identification: src/networking/shard_client.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "networking/shard_client.h"
+
+#include <chrono>
+
+#include "catalog/shard_map.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "configuration/configuration.h"
+#include "networking/rpc_channel.h"
+#include "networking/rpc_controller.h"
+#include "peloton/proto/shard_service.pb.h"
+
+namespace peloton {
+namespace networking {
+
+ShardClient::ShardClient() {}
+
+ShardClient::~ShardClient() {}
+
+ShardClient::Node &ShardClient::GetNode(const size_t node_id) {
+  auto &node = nodes_[node_id];
+  if (node == nullptr) {
+    auto &address = catalog::ShardMap::GetInstance().GetNodeAddress(node_id);
+    node.reset(new Node());
+    node->channel.reset(new RpcChannel(address));
+    node->controller.reset(new RpcController());
+    node->stub.reset(new PelotonShardService_Stub(node->channel.get()));
+  }
+  return *node;
+}
+
+uint64_t ShardClient::BeginCall() {
+  std::lock_guard<std::mutex> lock(call_mutex_);
+  auto call_id = next_call_id_++;
+  calls_[call_id] = nullptr;
+  return call_id;
+}
+
+void ShardClient::FailCall(const uint64_t call_id) {
+  std::lock_guard<std::mutex> lock(call_mutex_);
+  failed_calls_.insert(call_id);
+  call_cv_.notify_all();
+}
+
+uint64_t ShardClient::SendStatement(const size_t node_id,
+                                    const int64_t transaction_id,
+                                    const std::string &query) {
+  auto call_id = BeginCall();
+  ShardStatementRequest request;
+  request.set_request_id(call_id);
+  request.set_transaction_id(transaction_id);
+  request.set_query(query);
+
+  bool is_sent;
+  {
+    std::lock_guard<std::mutex> lock(node_mutex_);
+    auto &node = GetNode(node_id);
+    ShardStatementResponse response;
+    node.controller->Reset();
+    node.stub->ExecuteStatement(node.controller.get(), &request, &response,
+                                nullptr);
+    is_sent = node.controller->Failed() == false;
+  }
+  if (is_sent == false) {
+    LOG_ERROR("Cannot send the statement to shard node %lu", node_id);
+    FailCall(call_id);
+  }
+  return call_id;
+}
+
+uint64_t ShardClient::SendPrepare(const size_t node_id,
+                                  const int64_t transaction_id) {
+  auto call_id = BeginCall();
+  ShardTransactionRequest request;
+  request.set_request_id(call_id);
+  request.set_transaction_id(transaction_id);
+
+  bool is_sent;
+  {
+    std::lock_guard<std::mutex> lock(node_mutex_);
+    auto &node = GetNode(node_id);
+    ShardTransactionResponse response;
+    node.controller->Reset();
+    node.stub->PrepareTransaction(node.controller.get(), &request, &response,
+                                  nullptr);
+    is_sent = node.controller->Failed() == false;
+  }
+  if (is_sent == false) {
+    LOG_ERROR("Cannot prepare transaction %ld on shard node %lu",
+              transaction_id, node_id);
+    FailCall(call_id);
+  }
+  return call_id;
+}
+
+uint64_t ShardClient::SendFinish(const size_t node_id,
+                                 const int64_t transaction_id,
+                                 const bool commit) {
+  auto call_id = BeginCall();
+  ShardTransactionRequest request;
+  request.set_request_id(call_id);
+  request.set_transaction_id(transaction_id);
+  request.set_commit(commit);
+
+  bool is_sent;
+  {
+    std::lock_guard<std::mutex> lock(node_mutex_);
+    auto &node = GetNode(node_id);
+    ShardTransactionResponse response;
+    node.controller->Reset();
+    node.stub->FinishTransaction(node.controller.get(), &request, &response,
+                                 nullptr);
+    is_sent = node.controller->Failed() == false;
+  }
+  if (is_sent == false) {
+    LOG_ERROR("Cannot finish transaction %ld on shard node %lu",
+              transaction_id, node_id);
+    FailCall(call_id);
+  }
+  return call_id;
+}
+
+bool ShardClient::WaitStatement(const uint64_t call_id,
+                                ShardStatementResponse &response) {
+  return Wait(call_id, response);
+}
+
+bool ShardClient::WaitTransaction(const uint64_t call_id,
+                                  ShardTransactionResponse &response) {
+  return Wait(call_id, response);
+}
+
+bool ShardClient::Wait(const uint64_t call_id,
+                       google::protobuf::Message &response) {
+  std::unique_lock<std::mutex> lock(call_mutex_);
+  bool is_done = call_cv_.wait_for(
+      lock, std::chrono::milliseconds(FLAGS_shard_timeout_ms), [&]() {
+        return failed_calls_.count(call_id) > 0 || calls_[call_id] != nullptr;
+      });
+
+  // An answer that comes after the timeout is dropped
+  bool is_answered = is_done && failed_calls_.count(call_id) == 0;
+  if (is_answered) {
+    response.CopyFrom(*calls_[call_id]);
+  } else if (is_done == false) {
+    LOG_ERROR("Shard call %lu was not answered in time", call_id);
+  }
+  calls_.erase(call_id);
+  failed_calls_.erase(call_id);
+  return is_answered;
+}
+
+void ShardClient::Complete(const uint64_t call_id,
+                           const google::protobuf::Message &response) {
+  std::lock_guard<std::mutex> lock(call_mutex_);
+  auto call = calls_.find(call_id);
+  if (call == calls_.end()) {
+    LOG_TRACE("Dropped the late answer of shard call %lu", call_id);
+    return;
+  }
+
+  // The messages of the RPC layer are reused for the next answer
+  call->second.reset(response.New());
+  call->second->CopyFrom(response);
+  call_cv_.notify_all();
+}
+
+}  // namespace networking
+}  // namespace peloton
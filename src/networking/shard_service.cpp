@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_service.cpp
+//
+// Identification: src/networking/shard_service.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "networking/shard_service.h"
+
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "networking/shard_client.h"
+#include "tcop/tcop.h"
+
+namespace peloton {
+namespace networking {
+
+namespace {
+
+// Run a statement that only reports its result
+ResultType ExecuteCommand(tcop::TrafficCop &session, const std::string &query) {
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  int rows_changed = 0;
+  std::string error_message;
+  return session.ExecuteStatement(query, result, tuple_descriptor,
+                                  rows_changed, error_message);
+}
+
+}  // namespace
+
+ShardService::ShardService() : autocommit_session_(new tcop::TrafficCop()) {
+  // The statements run here are fragments already
+  autocommit_session_->SetShardRouting(false);
+}
+
+ShardService::~ShardService() {}
+
+tcop::TrafficCop &ShardService::GetSession(const int64_t transaction_id) {
+  auto &session = sessions_[transaction_id];
+  if (session == nullptr) {
+    session.reset(new tcop::TrafficCop());
+    session->SetShardRouting(false);
+    ExecuteCommand(*session, "BEGIN");
+  }
+  return *session;
+}
+
+size_t ShardService::GetSessionCount() {
+  std::lock_guard<std::mutex> lock(session_mutex_);
+  return sessions_.size();
+}
+
+void ShardService::ExecuteStatement(
+    ::google::protobuf::RpcController *controller,
+    const ShardStatementRequest *request, ShardStatementResponse *response,
+    ::google::protobuf::Closure *done) {
+  if (controller != nullptr && controller->Failed()) {
+    std::string error = controller->ErrorText();
+    LOG_TRACE("ShardService with controller failed:%s ", error.c_str());
+  }
+
+  // Here is for the coordinator, answered by this node
+  if (request == NULL) {
+    ShardClient::GetInstance().Complete(response->request_id(), *response);
+    return;
+  }
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  int rows_changed = 0;
+  std::string error_message;
+  ResultType status;
+  {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    auto &session = request->transaction_id() == 0
+                        ? *autocommit_session_
+                        : GetSession(request->transaction_id());
+    status = session.ExecuteStatement(request->query(), result,
+                                      tuple_descriptor, rows_changed,
+                                      error_message);
+  }
+  LOG_TRACE("Executed %s for transaction %ld: %s", request->query().c_str(),
+            request->transaction_id(), ResultTypeToString(status).c_str());
+
+  response->set_request_id(request->request_id());
+  response->set_result(static_cast<int>(status));
+  response->set_error_message(error_message);
+  response->set_rows_changed(rows_changed);
+  for (auto &field : tuple_descriptor) {
+    auto *column = response->add_column();
+    column->set_name(std::get<0>(field));
+    column->set_type_oid(std::get<1>(field));
+    column->set_type_size(std::get<2>(field));
+  }
+
+  // The result has the columns of every row one after the other
+  if (tuple_descriptor.empty() == false) {
+    for (size_t value_itr = 0; value_itr + tuple_descriptor.size() <=
+                               result.size();
+         value_itr += tuple_descriptor.size()) {
+      auto *row = response->add_row();
+      for (size_t col_itr = 0; col_itr < tuple_descriptor.size(); col_itr++) {
+        auto &value = result[value_itr + col_itr].second;
+        row->add_value(std::string(value.begin(), value.end()));
+      }
+    }
+  }
+
+  if (done) {
+    done->Run();
+  }
+}
+
+void ShardService::PrepareTransaction(
+    ::google::protobuf::RpcController *controller,
+    const ShardTransactionRequest *request,
+    ShardTransactionResponse *response, ::google::protobuf::Closure *done) {
+  if (controller != nullptr && controller->Failed()) {
+    std::string error = controller->ErrorText();
+    LOG_TRACE("ShardService with controller failed:%s ", error.c_str());
+  }
+
+  if (request == NULL) {
+    ShardClient::GetInstance().Complete(response->request_id(), *response);
+    return;
+  }
+
+  // A session that cannot commit aborts right away, the coordinator then
+  // aborts the transaction everywhere
+  ResultType status = ResultType::ABORTED;
+  {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    auto session = sessions_.find(request->transaction_id());
+    if (session != sessions_.end()) {
+      if (session->second->GetRunningTransactionResult() ==
+          ResultType::SUCCESS) {
+        auto &txn_manager =
+            concurrency::TransactionManagerFactory::GetInstance();
+        status = txn_manager.PrepareTransaction(
+            session->second->GetRunningTransaction());
+      }
+      if (status != ResultType::SUCCESS) {
+        ExecuteCommand(*session->second, "ROLLBACK");
+        sessions_.erase(session);
+      }
+    }
+  }
+  LOG_TRACE("Prepared transaction %ld: %s", request->transaction_id(),
+            ResultTypeToString(status).c_str());
+
+  response->set_request_id(request->request_id());
+  response->set_result(static_cast<int>(status));
+  if (done) {
+    done->Run();
+  }
+}
+
+void ShardService::FinishTransaction(
+    ::google::protobuf::RpcController *controller,
+    const ShardTransactionRequest *request,
+    ShardTransactionResponse *response, ::google::protobuf::Closure *done) {
+  if (controller != nullptr && controller->Failed()) {
+    std::string error = controller->ErrorText();
+    LOG_TRACE("ShardService with controller failed:%s ", error.c_str());
+  }
+
+  if (request == NULL) {
+    ShardClient::GetInstance().Complete(response->request_id(), *response);
+    return;
+  }
+
+  // A transaction without a session has aborted already
+  ResultType status =
+      request->commit() ? ResultType::ABORTED : ResultType::SUCCESS;
+  {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    auto session = sessions_.find(request->transaction_id());
+    if (session != sessions_.end()) {
+      status = ExecuteCommand(*session->second,
+                              request->commit() ? "COMMIT" : "ROLLBACK");
+      sessions_.erase(session);
+    }
+  }
+  LOG_TRACE("Finished transaction %ld: %s", request->transaction_id(),
+            ResultTypeToString(status).c_str());
+
+  response->set_request_id(request->request_id());
+  response->set_result(static_cast<int>(status));
+  if (done) {
+    done->Run();
+  }
+}
+
+}  // namespace networking
+}  // namespace peloton
@@ -12,6 +12,7 @@
 
 
 #include <iostream>
+#include <memory>
 #include <mutex>
 
 #include <pthread.h>
@@ -137,13 +138,14 @@ void *Connection::ProcessMessage(void *connection) {
 
     /*
      * Get a message.
-     * Note: we only get one message each time. so the buf is msg_len +
-     * HEADERLEN
+     * Note: we only get one message each time, and parse it where it is in
+     * the read buf. so the data are msg_len + HEADERLEN
      */
-    char buf[msg_len + HEADERLEN];
-
-    // Get the data
-    conn->GetReadData(buf, msg_len + HEADERLEN);
+    const char *buf = conn->PeekReadBuffer(msg_len + HEADERLEN);
+    if (buf == NULL) {
+      LOG_ERROR("Can't get a message of %u bytes", msg_len);
+      return NULL;
+    }
 
     // Get the message type
     uint16_t type = 0;
@@ -158,19 +160,22 @@ void *Connection::ProcessMessage(void *connection) {
 
     if (rpc_method == NULL) {
       LOG_TRACE("No method found");
+      conn->DrainReadBuffer(msg_len + HEADERLEN);
       return NULL;
     }
 
     const google::protobuf::MethodDescriptor *method = rpc_method->method_;
     RpcController controller;
+    RpcMessages &rpc_messages = conn->GetRpcMessages(opcode, rpc_method);
 
     switch (type) {
       case MSG_TYPE_REQ: {
         LOG_TRACE("Handle MSG_TYPE: Request");
 
-        // Get request and response type and create them
-        google::protobuf::Message *message = rpc_method->request_->New();
-        google::protobuf::Message *response = rpc_method->response_->New();
+        // Get request and response type
+        google::protobuf::Message *message = rpc_messages.request.get();
+        google::protobuf::Message *response = rpc_messages.response.get();
+        response->Clear();
 
         // Deserialize the receiving message
         message->ParseFromArray(buf + HEADERLEN + TYPELEN + OPCODELEN,
@@ -182,52 +187,25 @@ void *Connection::ProcessMessage(void *connection) {
 
         // Send back the response message. The message has been set up when
         // executing rpc method
-        msg_len = response->ByteSize() + OPCODELEN + TYPELEN;
-
-        char send_buf[sizeof(msg_len) + msg_len];
-        PL_ASSERT(sizeof(msg_len) == HEADERLEN);
-
-        // copy the header into the buf
-        PL_MEMCPY(send_buf, &msg_len, sizeof(msg_len));
-
-        // copy the type into the buf
-        type = MSG_TYPE_REP;
-
-        PL_ASSERT(sizeof(type) == TYPELEN);
-        PL_MEMCPY(send_buf + HEADERLEN, &type, TYPELEN);
-
-        // copy the opcode into the buf
-        PL_ASSERT(sizeof(opcode) == OPCODELEN);
-        PL_MEMCPY(send_buf + HEADERLEN + TYPELEN, &opcode, OPCODELEN);
-
-        // call protobuf to serialize the request message into sending buf
-        response->SerializeToArray(send_buf + HEADERLEN + TYPELEN + OPCODELEN,
-                                   msg_len);
-
-        // send data
         // Note: if we use raw socket send api, we should loop send
-        conn->AddToWriteBuffer(send_buf, HEADERLEN + msg_len);
-
-        delete message;
-        delete response;
+        conn->WriteMessage(MSG_TYPE_REP, opcode, *response);
 
       } break;
 
       case MSG_TYPE_REP: {
         LOG_TRACE("Handle MSG_TYPE: Response");
 
-        // Get response and response type and create them
-        google::protobuf::Message *message = rpc_method->response_->New();
+        // Get response type
+        google::protobuf::Message *message = rpc_messages.response.get();
 
         // Deserialize the receiving message
-        message->ParseFromArray(buf + HEADERLEN + TYPELEN + OPCODELEN, msg_len);
+        message->ParseFromArray(buf + HEADERLEN + TYPELEN + OPCODELEN,
+                                msg_len - TYPELEN - OPCODELEN);
 
         // Invoke rpc call. request is null
         rpc_method->service_->CallMethod(method, &controller, NULL, message,
                                          NULL);
 
-        delete message;
-
       } break;
 
       default:
@@ -235,6 +213,9 @@ void *Connection::ProcessMessage(void *connection) {
         break;
     }
 
+    // The message is processed, remove it from the read buf
+    conn->DrainReadBuffer(msg_len + HEADERLEN);
+
     // TODO: controller should be set within rpc method
     if (controller.Failed()) {
       std::string error = controller.ErrorText();
@@ -282,20 +263,10 @@ void Connection::ReadCb(UNUSED_ATTRIBUTE struct bufferevent *bev, void *ctx) {
 
   /*
    * Process the message will invoke rpc call.
-   * Note: this might take a long time. So we put this in a thread
-   */
-
-  /* prepaere workers_thread to send and recv data */
-  std::function<void()> worker_conn =
-      std::bind(&Connection::ProcessMessage, conn);
-
-  /*
-   * Add workers to thread pool to send and recv data
-   * Note: after AddTask, ReadCb will return and another
-   * request on this connection can be processed while
-   * the former is still being processed
+   * Note: the messages of a connection are processed in the order they
+   *       arrive, which the log shipped to a replica relies on
    */
-  //PthreadThreadPool::GetInstance().AddTask(worker_conn);
+  ProcessMessage(conn);
 }
 
 /*
@@ -446,6 +417,77 @@ bool Connection::AddToWriteBuffer(char *buffer, int len) {
   }
 }
 
+/*
+ * Frame and serialize the message into space reserved in the write buf
+ */
+bool Connection::WriteMessage(uint16_t type, uint64_t opcode,
+                              const google::protobuf::Message &message) {
+  // msg_len includes the length of type + opcode + message
+  uint32_t msg_len = message.ByteSize() + TYPELEN + OPCODELEN;
+  PL_ASSERT(sizeof(msg_len) == HEADERLEN);
+  PL_ASSERT(sizeof(type) == TYPELEN);
+  PL_ASSERT(sizeof(opcode) == OPCODELEN);
+
+  /*
+   * The space is reserved and committed in two calls, so the buf is locked
+   * explicitly to keep the messages of other threads from interleaving
+   */
+  bufferevent_lock(bev_);
+  struct evbuffer *output = bufferevent_get_output(bev_);
+  struct evbuffer_iovec vec;
+  bool written =
+      (evbuffer_reserve_space(output, HEADERLEN + msg_len, &vec, 1) == 1);
+  if (written) {
+    char *buf = (char *)vec.iov_base;
+    PL_MEMCPY(buf, &msg_len, HEADERLEN);
+    PL_MEMCPY(buf + HEADERLEN, &type, TYPELEN);
+    PL_MEMCPY(buf + HEADERLEN + TYPELEN, &opcode, OPCODELEN);
+
+    // ByteSize() above has cached the sizes
+    message.SerializeWithCachedSizesToArray(
+        (google::protobuf::uint8 *)(buf + HEADERLEN + TYPELEN + OPCODELEN));
+
+    vec.iov_len = HEADERLEN + msg_len;
+    written = (evbuffer_commit_space(output, &vec, 1) == 0);
+  }
+  bufferevent_unlock(bev_);
+
+  return written;
+}
+
+/*
+ * Make the first len data of read buf contiguous and get a pointer to them
+ */
+const char *Connection::PeekReadBuffer(int len) {
+  /*
+   * Note: it is automatically locked so we don't need
+   *       to explicitly lock it
+   */
+  struct evbuffer *input = bufferevent_get_input(bev_);
+  return (const char *)evbuffer_pullup(input, len);
+}
+
+/*
+ * Remove the first len data from read buf
+ */
+void Connection::DrainReadBuffer(int len) {
+  struct evbuffer *input = bufferevent_get_input(bev_);
+  evbuffer_drain(input, len);
+}
+
+/*
+ * Get the messages of the rpc method, creating them on its first message
+ */
+Connection::RpcMessages &Connection::GetRpcMessages(
+    uint64_t opcode, const RpcMethod *rpc_method) {
+  auto &rpc_messages = rpc_messages_[opcode];
+  if (rpc_messages.request == nullptr) {
+    rpc_messages.request.reset(rpc_method->request_->New());
+    rpc_messages.response.reset(rpc_method->response_->New());
+  }
+  return rpc_messages;
+}
+
 /*
  * put data in read buf into write buf
  */
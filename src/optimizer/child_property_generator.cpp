@@ -16,6 +16,7 @@
 #include "expression/expression_util.h"
 #include "expression/star_expression.h"
 #include "optimizer/memo.h"
+#include "optimizer/util.h"
 
 using std::move;
 using std::vector;
@@ -49,7 +50,19 @@ ChildPropertyGenerator::GetProperties(shared_ptr<GroupExpression> gexpr,
 
 void ChildPropertyGenerator::Visit(const PhysicalSeqScan *) { ScanHelper(); };
 
-void ChildPropertyGenerator::Visit(const PhysicalIndexScan *) { ScanHelper(); };
+void ChildPropertyGenerator::Visit(const PhysicalIndexScan *op) {
+  ScanHelper();
+
+  // Scanning an index in key order, or in reverse, provides the order of its
+  // leading columns
+  auto sort_prop = requirements_.GetPropertyOfType(PropertyType::SORT);
+  oid_t index_id;
+  bool descending;
+  if (sort_prop != nullptr &&
+      util::GetSortIndex(op->table_, op->table_alias,
+                         sort_prop->As<PropertySort>(), index_id, descending))
+    output_[0].first.AddProperty(sort_prop);
+};
 
 /**
  * Note:
@@ -80,6 +93,12 @@ void ChildPropertyGenerator::Visit(const PhysicalInnerNLJoin *op){
 void ChildPropertyGenerator::Visit(const PhysicalLeftNLJoin *){};
 void ChildPropertyGenerator::Visit(const PhysicalRightNLJoin *){};
 void ChildPropertyGenerator::Visit(const PhysicalOuterNLJoin *){};
+void ChildPropertyGenerator::Visit(const PhysicalInnerIndexNLJoin *op) {
+  JoinHelper(op);
+};
+void ChildPropertyGenerator::Visit(const PhysicalInnerMergeJoin *op) {
+  JoinHelper(op);
+};
 void ChildPropertyGenerator::Visit(const PhysicalInnerHashJoin *op) {
   JoinHelper(op);
 };
@@ -327,6 +346,10 @@ void ChildPropertyGenerator::JoinHelper(const BaseOperatorNode *op) {
     join_cond = ((PhysicalInnerHashJoin *)op)->join_predicate.get();
   else if (op->type() == OpType::InnerNLJoin)
     join_cond = ((PhysicalInnerNLJoin *)op)->join_predicate.get();
+  else if (op->type() == OpType::InnerIndexNLJoin)
+    join_cond = ((PhysicalInnerIndexNLJoin *)op)->join_predicate.get();
+  else if (op->type() == OpType::InnerMergeJoin)
+    join_cond = ((PhysicalInnerMergeJoin *)op)->join_predicate.get();
 
   ExprSet child_cols;
   ExprSet provided_cols;
@@ -335,6 +358,14 @@ void ChildPropertyGenerator::JoinHelper(const BaseOperatorNode *op) {
   vector<shared_ptr<expression::AbstractExpression>> left_cols;
   vector<shared_ptr<expression::AbstractExpression>> right_cols;
 
+  // Decide which base columns and predicates should be provided by which
+  // child based on the table alias.
+  PL_ASSERT(child_groups_.size() == 2);
+  auto &left_table_alias = child_groups_[0]->GetTableAliases();
+  auto &right_table_alias = child_groups_[1]->GetTableAliases();
+  shared_ptr<PropertyPredicate> left_predicate;
+  shared_ptr<PropertyPredicate> right_predicate;
+
   for (auto prop : requirements_.Properties()) {
     switch (prop->Type()) {
       case PropertyType::DISTINCT: {
@@ -361,13 +392,26 @@ void ChildPropertyGenerator::JoinHelper(const BaseOperatorNode *op) {
         break;
       }
       case PropertyType::PREDICATE: {
-        // TODO: later we need to modify this to support predicate push down.
-        // For now, the predicate will be evaluate in join executor
-
+        // The conjuncts on the tables of one child are pushed down to it, the
+        // rest is evaluated in join executor
         auto pred_prop = prop->As<PropertyPredicate>();
-        // Columns needed by predicate should be generated by child
-        expression::ExpressionUtil::GetTupleValueExprs(
-            child_cols, pred_prop->GetPredicate());
+        expression::AbstractExpression *l_predicate;
+        expression::AbstractExpression *r_predicate;
+        expression::AbstractExpression *join_predicate;
+        util::SplitJoinPredicate(pred_prop->GetPredicate(), left_table_alias,
+                                 right_table_alias, l_predicate, r_predicate,
+                                 join_predicate);
+        if (l_predicate != nullptr)
+          left_predicate = make_shared<PropertyPredicate>(l_predicate);
+        if (r_predicate != nullptr)
+          right_predicate = make_shared<PropertyPredicate>(r_predicate);
+
+        // Columns needed by the rest should be generated by child
+        if (join_predicate != nullptr) {
+          expression::ExpressionUtil::GetTupleValueExprs(child_cols,
+                                                         join_predicate);
+          delete join_predicate;
+        }
 
         provided_property.AddProperty(prop);
         break;
@@ -400,12 +444,6 @@ void ChildPropertyGenerator::JoinHelper(const BaseOperatorNode *op) {
     // All base columns in join condition needs to be generated by the child
     expression::ExpressionUtil::GetTupleValueExprs(child_cols, join_cond);
 
-    // Decide which base columns should be provided by which child based on
-    // the table alias.
-    PL_ASSERT(child_groups_.size() == 2);
-    auto &left_table_alias = child_groups_[0]->GetTableAliases();
-    UNUSED_ATTRIBUTE auto &right_table_alias = child_groups_[1]->GetTableAliases();
-
     for (auto child_col : child_cols) {
       auto tv_expr = (expression::TupleValueExpression *) child_col.get();
       if (left_table_alias.count(tv_expr->GetTableName()) > 0) {
@@ -426,6 +464,8 @@ void ChildPropertyGenerator::JoinHelper(const BaseOperatorNode *op) {
       PropertySet({make_shared<PropertyColumns>(std::move(left_cols))});
   auto r_property_set =
       PropertySet({make_shared<PropertyColumns>(std::move(right_cols))});
+  if (left_predicate != nullptr) l_property_set.AddProperty(left_predicate);
+  if (right_predicate != nullptr) r_property_set.AddProperty(right_predicate);
   child_input_propertys.push_back(l_property_set);
   child_input_propertys.emplace_back(r_property_set);
 
@@ -11,13 +11,51 @@
 //===----------------------------------------------------------------------===//
 
 #include "optimizer/cost_and_stats_calculator.h"
+
+#include <algorithm>
+
 #include "optimizer/column_manager.h"
 #include "optimizer/stats.h"
 #include "optimizer/properties.h"
+#include "optimizer/stats/cardinality_estimator.h"
+#include "optimizer/stats/cardinality_feedback.h"
+#include "optimizer/stats/cost.h"
+#include "optimizer/stats/stats_storage.h"
+#include "optimizer/stats/table_stats.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace optimizer {
 
+namespace {
+
+// The stats of an analyzed table, or null
+std::shared_ptr<TableStats> GetAnalyzedTableStats(storage::DataTable *table) {
+  if (table == nullptr) return nullptr;
+  auto table_stats = StatsStorage::GetInstance()->GetTableStats(
+      table->GetDatabaseOid(), table->GetOid());
+  if (table_stats == nullptr || table_stats->num_rows == 0) return nullptr;
+  return table_stats;
+}
+
+// The rows a scan of the analyzed table with the predicate produces
+double EstimateScanRows(const std::shared_ptr<TableStats> &table_stats,
+                        storage::DataTable *table,
+                        const PropertyPredicate *predicate_prop) {
+  if (predicate_prop == nullptr) return table_stats->num_rows;
+  double selectivity;
+  if (CardinalityFeedback::GetInstance().GetSelectivity(
+          table->GetOid(), predicate_prop->GetPredicate(), selectivity) ==
+      false) {
+    selectivity = CardinalityEstimator::EstimateSelectivity(
+        table_stats, predicate_prop->GetPredicate());
+  }
+  return selectivity * table_stats->num_rows;
+}
+
+}  // namespace
+
 void CostAndStatsCalculator::CalculateCostAndStats(
     std::shared_ptr<GroupExpression> gexpr,
     const PropertySet *output_properties,
@@ -29,8 +67,13 @@ void CostAndStatsCalculator::CalculateCostAndStats(
   input_properties_list_ = input_properties_list;
   child_stats_ = child_stats;
   child_costs_ = child_costs;
+  output_cost_ = 0;
 
   gexpr->Op().Accept(this);
+
+  // The cost of an expression includes the cost of producing its inputs, so
+  // that the cost of an order the inputs have to be sorted in is accounted
+  for (double child_cost : child_costs_) output_cost_ += child_cost;
 }
 
 void CostAndStatsCalculator::Visit(const DummyScan *) {
@@ -39,10 +82,22 @@ void CostAndStatsCalculator::Visit(const DummyScan *) {
   output_cost_ = 0;
 }
 
-void CostAndStatsCalculator::Visit(const PhysicalSeqScan *) {
-  // TODO : Replace with more accurate cost
+void CostAndStatsCalculator::Visit(const PhysicalSeqScan *op) {
   output_stats_.reset(new Stats(nullptr));
-  output_cost_ = 1;
+
+  // Without stats an index scan that can use its index wins
+  auto table_stats = GetAnalyzedTableStats(op->table_);
+  if (table_stats == nullptr) {
+    output_cost_ = 1;
+    return;
+  }
+  output_stats_.reset(new Stats(
+      nullptr,
+      EstimateScanRows(
+          table_stats, op->table_,
+          output_properties_->GetPropertyOfType(PropertyType::PREDICATE)
+              ->As<PropertyPredicate>())));
+  output_cost_ = table_stats->num_rows * DEFAULT_TUPLE_COST;
 };
 void CostAndStatsCalculator::Visit(const PhysicalIndexScan *op) {
   // Simple cost function
@@ -52,24 +107,67 @@ void CostAndStatsCalculator::Visit(const PhysicalIndexScan *op) {
   auto predicate_prop =
       output_properties_->GetPropertyOfType(PropertyType::PREDICATE)
           ->As<PropertyPredicate>();
-
-  if (predicate_prop == nullptr) {
-    output_cost_ = 2;
-    return;
-  }
+  auto sort_prop = output_properties_->GetPropertyOfType(PropertyType::SORT)
+                       ->As<PropertySort>();
 
   std::vector<oid_t> key_column_ids;
   std::vector<ExpressionType> expr_types;
   std::vector<type::Value> values;
   oid_t index_id = 0;
 
-  expression::AbstractExpression *predicate = predicate_prop->GetPredicate();
-  if (util::CheckIndexSearchable(op->table_, predicate, key_column_ids,
-                                 expr_types, values, index_id)) {
-    output_cost_ = 0;
-  } else {
-    output_cost_ = 2;
+  expression::AbstractExpression *predicate =
+      predicate_prop == nullptr ? nullptr : predicate_prop->GetPredicate();
+  bool index_searchable =
+      predicate != nullptr &&
+      util::CheckIndexSearchable(op->table_, predicate, key_column_ids,
+                                 expr_types, values, index_id);
+
+  // An order is provided by scanning the index on the sort columns, which
+  // the predicate may not narrow down
+  oid_t sort_index_id = 0;
+  bool descending;
+  if (sort_prop != nullptr && index_searchable &&
+      (util::GetSortIndex(op->table_, op->table_alias, sort_prop,
+                          sort_index_id, descending) == false ||
+       sort_index_id != index_id)) {
+    index_searchable = false;
   }
+
+  auto table_stats = GetAnalyzedTableStats(op->table_);
+  if (table_stats == nullptr) {
+    output_cost_ = index_searchable ? 0 : 2;
+    return;
+  }
+  output_stats_.reset(new Stats(
+      nullptr, EstimateScanRows(table_stats, op->table_, predicate_prop)));
+
+  // The index is descended once and the tuples of the keys it finds are
+  // fetched one by one, which beats a sequential scan for selective keys
+  double num_rows = table_stats->num_rows;
+  if (index_searchable == false) {
+    output_cost_ = num_rows * (DEFAULT_TUPLE_COST + DEFAULT_INDEX_TUPLE_COST);
+    return;
+  }
+  std::vector<ValueCondition> conditions;
+  for (size_t key_idx = 0; key_idx < key_column_ids.size(); key_idx++) {
+    // The value of a parameter is not known yet
+    auto &value = values[key_idx];
+    conditions.emplace_back(
+        key_column_ids[key_idx], expr_types[key_idx],
+        value.GetTypeId() == type::TypeId::PARAMETER_OFFSET
+            ? type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER)
+            : value);
+  }
+  double selectivity =
+      CardinalityEstimator::EstimateSelectivity(table_stats, conditions);
+
+  // The keys match at least the tuples a scan with the whole predicate found
+  double observed_selectivity;
+  if (CardinalityFeedback::GetInstance().GetSelectivity(
+          op->table_->GetOid(), predicate, observed_selectivity)) {
+    selectivity = std::max(selectivity, observed_selectivity);
+  }
+  output_cost_ = Cost::IndexLookupCost(num_rows, selectivity);
 };
 void CostAndStatsCalculator::Visit(const PhysicalProject *) {
   // TODO: Replace with more accurate cost
@@ -77,8 +175,20 @@ void CostAndStatsCalculator::Visit(const PhysicalProject *) {
   output_cost_ = 0;
 }
 void CostAndStatsCalculator::Visit(const PhysicalOrderBy *) {
-  // TODO: Replace with more accurate cost
-  output_cost_ = 0;
+  // Sorting pays for every comparison, unlike an input that is in order
+  double num_rows = -1;
+  if (child_stats_.size() > 0 && child_stats_[0] != nullptr)
+    num_rows = child_stats_[0]->GetNumRows();
+  output_stats_.reset(new Stats(nullptr, num_rows));
+  if (num_rows < 0) {
+    output_cost_ = 2 * DEFAULT_COST;
+    return;
+  }
+  output_cost_ =
+      num_rows < 2
+          ? 0
+          : default_sorting_cost(static_cast<size_t>(num_rows)) *
+                DEFAULT_OPERATOR_COST;
 }
 void CostAndStatsCalculator::Visit(const PhysicalLimit *) {
   // TODO: Replace with more accurate cost
@@ -92,6 +202,15 @@ void CostAndStatsCalculator::Visit(const PhysicalInnerNLJoin *){
 void CostAndStatsCalculator::Visit(const PhysicalLeftNLJoin *){};
 void CostAndStatsCalculator::Visit(const PhysicalRightNLJoin *){};
 void CostAndStatsCalculator::Visit(const PhysicalOuterNLJoin *){};
+void CostAndStatsCalculator::Visit(const PhysicalInnerIndexNLJoin *){
+  // The rule only applies it to a small outer side, which it beats a hash
+  // join on, so it ties with one and is tried first
+  output_cost_ = 0;
+};
+void CostAndStatsCalculator::Visit(const PhysicalInnerMergeJoin *){
+  // Likewise for key ordered inputs that are too large to hash in memory
+  output_cost_ = 0;
+};
 void CostAndStatsCalculator::Visit(const PhysicalInnerHashJoin *){
   // TODO: Replace with more accurate cost
   output_cost_ = 0;
@@ -116,8 +235,12 @@ void CostAndStatsCalculator::Visit(const PhysicalUpdate *) {
   output_cost_ = 0;
 };
 void CostAndStatsCalculator::Visit(const PhysicalHashGroupBy *) {
-  // TODO: Replace with more accurate cost
-  output_cost_ = 0;
+  // Every row is hashed, which a sort group by over an input that is in
+  // order saves
+  double num_rows = -1;
+  if (child_stats_.size() > 0 && child_stats_[0] != nullptr)
+    num_rows = child_stats_[0]->GetNumRows();
+  output_cost_ = num_rows < 0 ? DEFAULT_COST : num_rows * DEFAULT_TUPLE_COST;
 };
 void CostAndStatsCalculator::Visit(const PhysicalSortGroupBy *) {
   // TODO: Replace with more accurate cost
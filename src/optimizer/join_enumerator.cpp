@@ -0,0 +1,404 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_enumerator.cpp
+//
+// Identification: src/optimizer/join_enumerator.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/join_enumerator.h"
+
+#include <algorithm>
+
+#include "expression/expression_util.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/operators.h"
+#include "optimizer/stats/cardinality_estimator.h"
+#include "optimizer/stats/cardinality_feedback.h"
+#include "optimizer/stats/selectivity.h"
+#include "optimizer/stats/stats_storage.h"
+#include "optimizer/stats/table_stats.h"
+#include "optimizer/util.h"
+#include "parser/select_statement.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// The largest number of relations that fit into a relation set
+const size_t kMaxRelations = 63;
+
+bool IsSingleRelation(uint64_t relations) {
+  return (relations & (relations - 1)) == 0;
+}
+
+size_t GetRelationIndex(uint64_t relation) { return __builtin_ctzll(relation); }
+
+void CollectTableAliases(const std::shared_ptr<OperatorExpression> &expr,
+                         std::unordered_set<std::string> &table_aliases) {
+  if (expr->Op().type() == OpType::Get) {
+    table_aliases.insert(expr->Op().As<LogicalGet>()->table_alias);
+  }
+  for (auto &child : expr->Children()) {
+    CollectTableAliases(child, table_aliases);
+  }
+}
+
+}  // namespace
+
+JoinEnumerator::JoinEnumerator(const parser::SelectStatement *select)
+    : enabled_(true) {
+  for (auto expr : *select->getSelectList()) {
+    if (expr->GetExpressionType() == ExpressionType::STAR) {
+      enabled_ = false;
+    }
+  }
+
+  if (select->where_clause == nullptr) return;
+  std::vector<expression::AbstractExpression *> predicates;
+  util::SplitPredicates(select->where_clause, predicates);
+  for (auto predicate : predicates) {
+    std::unordered_set<std::string> table_aliases;
+    expression::ExpressionUtil::GenerateTableAliasSet(predicate,
+                                                      table_aliases);
+    if (table_aliases.size() == 1) {
+      where_predicates_.emplace(*table_aliases.begin(), predicate);
+    }
+  }
+}
+
+std::shared_ptr<OperatorExpression> JoinEnumerator::ReorderJoins(
+    std::shared_ptr<OperatorExpression> expr) {
+  if (enabled_ == false) return expr;
+
+  if (expr->Op().type() == OpType::InnerJoin) {
+    JoinGraph graph;
+    if (CollectRelations(expr, graph) && CollectPredicates(expr, graph) &&
+        graph.relations.size() > 2) {
+      // Joins of two relations are left to the physical join rules
+      if (graph.relations.size() <= kMaxDPRelations) {
+        EnumerateDP(graph);
+      } else {
+        EnumerateGreedy(graph);
+      }
+      return BuildJoinTree(graph, (1ULL << graph.relations.size()) - 1);
+    }
+  }
+
+  if (expr->Children().empty()) return expr;
+  auto result = std::make_shared<OperatorExpression>(expr->Op());
+  for (auto &child : expr->Children()) {
+    result->PushChild(ReorderJoins(child));
+  }
+  return result;
+}
+
+bool JoinEnumerator::CollectRelations(
+    const std::shared_ptr<OperatorExpression> &expr, JoinGraph &graph) {
+  if (expr->Op().type() == OpType::InnerJoin) {
+    for (auto &child : expr->Children()) {
+      if (CollectRelations(child, graph) == false) return false;
+    }
+    return true;
+  }
+
+  if (graph.relations.size() == kMaxRelations) return false;
+  Relation relation;
+  relation.expr = ReorderJoins(expr);
+  CollectTableAliases(expr, relation.table_aliases);
+  relation.rows = EstimateRelationRows(expr);
+  graph.relations.push_back(std::move(relation));
+  return true;
+}
+
+bool JoinEnumerator::CollectPredicates(
+    const std::shared_ptr<OperatorExpression> &expr, JoinGraph &graph) {
+  if (expr->Op().type() != OpType::InnerJoin) return true;
+
+  auto join_predicate = expr->Op().As<LogicalInnerJoin>()->join_predicate;
+  if (join_predicate != nullptr) {
+    std::vector<expression::AbstractExpression *> conjuncts;
+    util::SplitPredicates(join_predicate.get(), conjuncts);
+    for (auto conjunct : conjuncts) {
+      std::unordered_set<std::string> table_aliases;
+      expression::ExpressionUtil::GenerateTableAliasSet(conjunct,
+                                                        table_aliases);
+
+      uint64_t relations = 0;
+      for (auto &table_alias : table_aliases) {
+        size_t relation_idx = 0;
+        while (relation_idx < graph.relations.size() &&
+               graph.relations[relation_idx].table_aliases.count(
+                   table_alias) == 0) {
+          relation_idx++;
+        }
+        if (relation_idx == graph.relations.size()) return false;
+        relations |= 1ULL << relation_idx;
+      }
+
+      // A predicate that does not join relations stays where it is
+      if (IsSingleRelation(relations)) return false;
+
+      JoinPredicate predicate;
+      predicate.expr.reset(conjunct->Copy());
+      predicate.relations = relations;
+      predicate.selectivity = EstimateJoinSelectivity(graph, conjunct);
+      graph.predicates.push_back(std::move(predicate));
+    }
+  }
+
+  for (auto &child : expr->Children()) {
+    if (CollectPredicates(child, graph) == false) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Find the cheapest join order of every subset of the relations, from
+ * the joins of two relations up. A subset is split into the two subsets that
+ * are joined last, its cost is the cost of both and the size of its result.
+ * Splits that need fewer cross products are preferred, so that only connected
+ * subsets are joined while the join graph is connected.
+ */
+void JoinEnumerator::EnumerateDP(JoinGraph &graph) {
+  const uint64_t all_relations = (1ULL << graph.relations.size()) - 1;
+  std::vector<double> rows(all_relations + 1);
+  std::vector<double> costs(all_relations + 1, 0);
+  std::vector<size_t> cross_products(all_relations + 1, 0);
+
+  for (uint64_t relations = 1; relations <= all_relations; relations++) {
+    if (IsSingleRelation(relations)) {
+      rows[relations] = graph.relations[GetRelationIndex(relations)].rows;
+      continue;
+    }
+    rows[relations] = EstimateRows(graph, relations);
+
+    bool found = false;
+    uint64_t best_left = 0;
+    for (uint64_t left = (relations - 1) & relations; left > 0;
+         left = (left - 1) & relations) {
+      // Every split is visited twice, once for each side
+      uint64_t right = relations ^ left;
+      if (left < right) continue;
+
+      size_t cross_product_count = cross_products[left] +
+                                   cross_products[right] +
+                                   (IsConnected(graph, left, right) ? 0 : 1);
+      double cost = costs[left] + costs[right] + rows[relations];
+      if (found == false || cross_product_count < cross_products[relations] ||
+          (cross_product_count == cross_products[relations] &&
+           cost < costs[relations])) {
+        found = true;
+        best_left = left;
+        cross_products[relations] = cross_product_count;
+        costs[relations] = cost;
+      }
+    }
+
+    // The smaller side is the build side of a hash join
+    uint64_t best_right = relations ^ best_left;
+    if (rows[best_left] < rows[best_right]) std::swap(best_left, best_right);
+    graph.splits[relations] = std::make_pair(best_left, best_right);
+  }
+}
+
+/**
+ * @brief Join the two relation sets with the smallest result until all
+ * relations are joined, preferring sets that are connected.
+ */
+void JoinEnumerator::EnumerateGreedy(JoinGraph &graph) {
+  std::vector<uint64_t> joined;
+  for (size_t relation_idx = 0; relation_idx < graph.relations.size();
+       relation_idx++) {
+    joined.push_back(1ULL << relation_idx);
+  }
+
+  while (joined.size() > 1) {
+    bool found = false;
+    size_t best_left = 0;
+    size_t best_right = 0;
+    bool best_connected = false;
+    double best_rows = 0;
+    for (size_t left = 0; left < joined.size(); left++) {
+      for (size_t right = left + 1; right < joined.size(); right++) {
+        bool connected = IsConnected(graph, joined[left], joined[right]);
+        if (best_connected == true && connected == false) continue;
+        double rows = EstimateRows(graph, joined[left] | joined[right]);
+        if (found == false || connected != best_connected ||
+            rows < best_rows) {
+          found = true;
+          best_left = left;
+          best_right = right;
+          best_connected = connected;
+          best_rows = rows;
+        }
+      }
+    }
+
+    uint64_t left = joined[best_left];
+    uint64_t right = joined[best_right];
+    if (EstimateRows(graph, left) < EstimateRows(graph, right)) {
+      std::swap(left, right);
+    }
+    graph.splits[left | right] = std::make_pair(left, right);
+    joined[best_left] = left | right;
+    joined.erase(joined.begin() + best_right);
+  }
+}
+
+std::shared_ptr<OperatorExpression> JoinEnumerator::BuildJoinTree(
+    const JoinGraph &graph, uint64_t relations) {
+  if (IsSingleRelation(relations)) {
+    return graph.relations[GetRelationIndex(relations)].expr;
+  }
+
+  auto split = graph.splits.at(relations);
+  auto left_expr = BuildJoinTree(graph, split.first);
+  auto right_expr = BuildJoinTree(graph, split.second);
+
+  // Every predicate is evaluated by the lowest join of all its relations
+  std::vector<expression::AbstractExpression *> predicates;
+  for (auto &predicate : graph.predicates) {
+    if ((predicate.relations & ~relations) == 0 &&
+        (predicate.relations & ~split.first) != 0 &&
+        (predicate.relations & ~split.second) != 0) {
+      predicates.push_back(predicate.expr->Copy());
+    }
+  }
+
+  auto join_expr = std::make_shared<OperatorExpression>(
+      LogicalInnerJoin::make(util::CombinePredicates(predicates)));
+  join_expr->PushChild(left_expr);
+  join_expr->PushChild(right_expr);
+  return join_expr;
+}
+
+double JoinEnumerator::EstimateRows(const JoinGraph &graph,
+                                    uint64_t relations) const {
+  double rows = 1;
+  for (size_t relation_idx = 0; relation_idx < graph.relations.size();
+       relation_idx++) {
+    if (relations & (1ULL << relation_idx)) {
+      rows *= graph.relations[relation_idx].rows;
+    }
+  }
+  for (auto &predicate : graph.predicates) {
+    if ((predicate.relations & ~relations) == 0) {
+      rows *= predicate.selectivity;
+    }
+  }
+  return std::max(rows, 1.0);
+}
+
+bool JoinEnumerator::IsConnected(const JoinGraph &graph, uint64_t left,
+                                 uint64_t right) const {
+  for (auto &predicate : graph.predicates) {
+    if ((predicate.relations & ~(left | right)) == 0 &&
+        (predicate.relations & left) != 0 &&
+        (predicate.relations & right) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+double JoinEnumerator::EstimateRelationRows(
+    const std::shared_ptr<OperatorExpression> &expr) {
+  if (expr->Op().type() == OpType::Get) {
+    auto get = expr->Op().As<LogicalGet>();
+    if (get->table == nullptr) return 1;
+
+    auto table_stats = GetTableStats(get->table);
+    double rows = table_stats->num_rows > 0 ? table_stats->num_rows
+                                            : get->table->GetTupleCount();
+    std::vector<const expression::AbstractExpression *> conjuncts;
+    auto predicates = where_predicates_.equal_range(get->table_alias);
+    for (auto itr = predicates.first; itr != predicates.second; itr++) {
+      conjuncts.push_back(itr->second);
+    }
+    // A scan with the same predicates observed their selectivity
+    double selectivity;
+    auto &feedback = CardinalityFeedback::GetInstance();
+    if (conjuncts.empty() == false &&
+        feedback.GetSelectivity(get->table->GetOid(), conjuncts,
+                                selectivity) == false) {
+      selectivity =
+          CardinalityEstimator::EstimateSelectivity(table_stats, conjuncts);
+      feedback.SetEstimate(get->table->GetOid(), conjuncts, selectivity);
+    }
+    if (conjuncts.empty() == false) {
+      rows *= selectivity;
+    }
+    return std::max(rows, 1.0);
+  }
+
+  // Any other operator is estimated by its largest input
+  double rows = 1;
+  for (auto &child : expr->Children()) {
+    rows = std::max(rows, EstimateRelationRows(child));
+  }
+  return rows;
+}
+
+double JoinEnumerator::EstimateJoinSelectivity(
+    const JoinGraph &graph, const expression::AbstractExpression *expr) {
+  // An equi-join matches every value of the side with fewer distinct values
+  if (expr->GetExpressionType() == ExpressionType::COMPARE_EQUAL &&
+      expr->GetChild(0)->GetExpressionType() == ExpressionType::VALUE_TUPLE &&
+      expr->GetChild(1)->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    double left_rows, right_rows;
+    double left_distinct =
+        EstimateDistinctValues(graph, expr->GetChild(0), left_rows);
+    double right_distinct =
+        EstimateDistinctValues(graph, expr->GetChild(1), right_rows);
+    return CardinalityEstimator::EstimateJoinSelectivity(
+        left_distinct, left_rows, right_distinct, right_rows);
+  }
+  return DEFAULT_SELECTIVITY;
+}
+
+double JoinEnumerator::EstimateDistinctValues(
+    const JoinGraph &graph, const expression::AbstractExpression *expr,
+    double &rows) {
+  auto tuple_value =
+      static_cast<const expression::TupleValueExpression *>(expr);
+  rows = 1;
+  for (auto &relation : graph.relations) {
+    if (relation.table_aliases.count(tuple_value->GetTableName()) == 0) {
+      continue;
+    }
+
+    rows = relation.rows;
+    if (relation.expr->Op().type() == OpType::Get) {
+      auto table = relation.expr->Op().As<LogicalGet>()->table;
+      auto column_stats = GetTableStats(table)->GetColumnStats(
+          std::get<2>(tuple_value->GetBoundOid()));
+      if (column_stats != nullptr && column_stats->cardinality > 0) {
+        return column_stats->cardinality;
+      }
+    }
+    return relation.rows;
+  }
+  return 1;
+}
+
+std::shared_ptr<TableStats> JoinEnumerator::GetTableStats(
+    storage::DataTable *table) {
+  auto entry = table_stats_.find(table->GetOid());
+  if (entry != table_stats_.end()) return entry->second;
+
+  auto table_stats = StatsStorage::GetInstance()->GetTableStats(
+      table->GetDatabaseOid(), table->GetOid());
+  table_stats_.emplace(table->GetOid(), table_stats);
+  return table_stats;
+}
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -12,20 +12,28 @@
 
 #include "optimizer/operator_to_plan_transformer.h"
 
+#include <algorithm>
+
+#include "index/index.h"
 #include "optimizer/operator_expression.h"
+#include "optimizer/stats/stats_storage.h"
+#include "optimizer/stats/table_stats.h"
 #include "planner/aggregate_plan.h"
 #include "planner/delete_plan.h"
 #include "planner/hash_plan.h"
 #include "planner/hash_join_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/limit_plan.h"
+#include "planner/merge_join_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/order_by_plan.h"
+#include "planner/index_nested_loop_join_plan.h"
 #include "planner/index_scan_plan.h"
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 #include "planner/update_plan.h"
 #include "storage/data_table.h"
+#include "type/value_factory.h"
 
 using std::vector;
 using std::make_pair;
@@ -96,11 +104,59 @@ void OperatorToPlanTransformer::Visit(const PhysicalIndexScan *op) {
   vector<type::Value> values;
   oid_t index_id = 0;
 
-  if (!util::CheckIndexSearchable(op->table_, predicate, key_column_ids,
-                                  expr_types, values, index_id)) {
+  bool index_searchable = util::CheckIndexSearchable(
+      op->table_, predicate, key_column_ids, expr_types, values, index_id);
+
+  // The required order is produced by scanning the index on the sort
+  // columns in key order, with the keys of the predicate if they are its own
+  auto sort_prop =
+      requirements_->GetPropertyOfType(PropertyType::SORT)->As<PropertySort>();
+  oid_t sort_index_id = 0;
+  bool descending = false;
+  bool key_ordered = sort_prop != nullptr &&
+                     util::GetSortIndex(op->table_, op->table_alias, sort_prop,
+                                        sort_index_id, descending);
+  if (key_ordered && (index_searchable == false || index_id != sort_index_id)) {
+    index_searchable = false;
+    index_id = sort_index_id;
+    key_column_ids.clear();
+    expr_types.clear();
+    values.clear();
+  }
+
+  if (index_searchable == false && key_ordered == false) {
     // Can't be accelerated by index scan
-    // Just scan all keys using the first index
+    // Just scan all keys using the first index, unless it is a hash index
+    // which would have to be locked as a whole. An index that is still built
+    // in the background, or a partial index, lacks keys.
     index_id = 0;
+    oid_t complete_index_count = 0;
+    for (oid_t index_offset = 0; index_offset < op->table_->GetIndexCount();
+         index_offset++) {
+      auto index = op->table_->GetIndex(index_offset);
+      if (index == nullptr || index->GetMetadata()->IsBuilding() == true ||
+          index->GetMetadata()->HasPredicate() == true) {
+        continue;
+      }
+      if (complete_index_count++ == 0) {
+        index_id = index_offset;
+      }
+      if (index->GetIndexMethodType() != IndexType::HASH) {
+        index_id = index_offset;
+        break;
+      }
+    }
+
+    if (complete_index_count == 0) {
+      auto column_prop = requirements_->GetPropertyOfType(PropertyType::COLUMNS)
+                             ->As<PropertyColumns>();
+      vector<oid_t> column_ids =
+          GenerateColumnsForScan(column_prop, op->table_alias, op->table_);
+      unique_ptr<planner::AbstractPlan> seq_scan_plan(
+          new planner::SeqScanPlan(op->table_, predicate, column_ids));
+      output_plan_ = move(seq_scan_plan);
+      return;
+    }
     key_column_ids.clear();
     expr_types.clear();
     values.clear();
@@ -124,6 +180,8 @@ void OperatorToPlanTransformer::Visit(const PhysicalIndexScan *op) {
   std::unique_ptr<planner::IndexScanPlan> index_scan_plan(
       new planner::IndexScanPlan(op->table_, predicate, column_ids,
                                  index_scan_desc, false));
+  index_scan_plan->SetKeyOrdered(key_ordered);
+  index_scan_plan->SetDescend(key_ordered && descending);
 
   output_plan_ = move(index_scan_plan);
 }
@@ -199,6 +257,35 @@ void OperatorToPlanTransformer::Visit(const PhysicalLimit *) {
   // Limit Operator does not change the column mapping
   *output_expr_map_ = children_expr_map_[0];
 
+  // A sort below the limit only needs to keep the first offset + limit tuples
+  if (children_plans_[0]->GetPlanNodeType() == PlanNodeType::ORDERBY) {
+    auto *order_by_plan =
+        static_cast<planner::OrderByPlan *>(children_plans_[0].get());
+    order_by_plan->SetLimit(true);
+    order_by_plan->SetLimitNumber(limit_prop->GetLimit());
+    order_by_plan->SetLimitOffset(limit_prop->GetOffset());
+  }
+
+  // A scan of an index in key order without a predicate only needs the
+  // first offset + limit keys. The index cannot tell which of them are
+  // visible, so the offset is still applied by the limit.
+  auto *child_plan = children_plans_[0].get();
+  while (child_plan->GetPlanNodeType() == PlanNodeType::PROJECTION &&
+         child_plan->GetChildren().size() == 1) {
+    child_plan = child_plan->GetChildren()[0].get();
+  }
+  if (child_plan->GetPlanNodeType() == PlanNodeType::INDEXSCAN) {
+    auto *index_scan_plan = static_cast<planner::IndexScanPlan *>(child_plan);
+    if (index_scan_plan->IsKeyOrdered() &&
+        index_scan_plan->GetPredicate() == nullptr &&
+        index_scan_plan->GetKeyColumnIds().empty()) {
+      index_scan_plan->SetLimit(true);
+      index_scan_plan->SetLimitNumber(limit_prop->GetLimit() +
+                                      limit_prop->GetOffset());
+      index_scan_plan->SetLimitOffset(0);
+    }
+  }
+
   unique_ptr<planner::AbstractPlan> limit_plan(
       new planner::LimitPlan(limit_prop->GetLimit(), limit_prop->GetOffset()));
   limit_plan->AddChild(move(children_plans_[0]));
@@ -324,7 +411,8 @@ void OperatorToPlanTransformer::Visit(const PhysicalDistinct *) {
 void OperatorToPlanTransformer::Visit(const PhysicalFilter *) {}
 
 void OperatorToPlanTransformer::Visit(const PhysicalInnerNLJoin *op) {
-  output_plan_ = GenerateJoinPlan((op->join_predicate).get(), JoinType::INNER, false);
+  output_plan_ = GenerateJoinPlan((op->join_predicate).get(), JoinType::INNER,
+                                  PlanNodeType::NESTLOOP);
 }
 
 void OperatorToPlanTransformer::Visit(const PhysicalLeftNLJoin *) {}
@@ -333,9 +421,20 @@ void OperatorToPlanTransformer::Visit(const PhysicalRightNLJoin *) {}
 
 void OperatorToPlanTransformer::Visit(const PhysicalOuterNLJoin *) {}
 
+void OperatorToPlanTransformer::Visit(const PhysicalInnerIndexNLJoin *op) {
+  output_plan_ = GenerateJoinPlan((op->join_predicate).get(), JoinType::INNER,
+                                  PlanNodeType::NESTLOOPINDEX);
+}
+
+void OperatorToPlanTransformer::Visit(const PhysicalInnerMergeJoin *op) {
+  output_plan_ = GenerateJoinPlan((op->join_predicate).get(), JoinType::INNER,
+                                  PlanNodeType::MERGEJOIN);
+}
+
 void OperatorToPlanTransformer::Visit(const PhysicalInnerHashJoin *op) {
   output_plan_ =
-      GenerateJoinPlan((op->join_predicate).get(), JoinType::INNER, true);
+      GenerateJoinPlan((op->join_predicate).get(), JoinType::INNER,
+                       PlanNodeType::HASHJOIN);
 }
 
 void OperatorToPlanTransformer::Visit(const PhysicalLeftHashJoin *) {}
@@ -549,13 +648,17 @@ OperatorToPlanTransformer::GenerateAggregatePlan(
   unique_ptr<planner::AggregatePlan> agg_plan(new planner::AggregatePlan(
       move(proj_info), move(predicate), move(agg_terms), move(col_ids),
       output_table_schema, agg_type));
+  // There are at most as many groups as input tuples
+  if (agg_type == AggregateType::HASH) {
+    agg_plan->SetGroupCardinality(EstimateCardinality(*children_plans_[0]));
+  }
   agg_plan->AddChild(move(children_plans_[0]));
   return agg_plan;
 }
 
 unique_ptr<planner::AbstractPlan> OperatorToPlanTransformer::GenerateJoinPlan(
     expression::AbstractExpression *join_predicate, JoinType join_type,
-    bool is_hash) {
+    PlanNodeType join_plan_type) {
   auto cols_prop = requirements_->GetPropertyOfType(PropertyType::COLUMNS)
                        ->As<PropertyColumns>();
 
@@ -631,9 +734,31 @@ unique_ptr<planner::AbstractPlan> OperatorToPlanTransformer::GenerateJoinPlan(
           ->As<PropertyPredicate>();
 
   if (predicate_prop != nullptr) {
-    auto where_predicate = predicate_prop->GetPredicate()->Copy();
-    LOG_TRACE("where_predicate %s", where_predicate->GetInfo().c_str());
-    predicates.emplace_back(where_predicate);
+    // The conjuncts pushed down to a child are already evaluated by it
+    vector<expression::AbstractExpression *> pushed_conjuncts;
+    for (auto &input_props : *required_input_props_) {
+      auto input_predicate_prop =
+          input_props.GetPropertyOfType(PropertyType::PREDICATE)
+              ->As<PropertyPredicate>();
+      if (input_predicate_prop != nullptr)
+        util::SplitPredicates(input_predicate_prop->GetPredicate(),
+                              pushed_conjuncts);
+    }
+
+    vector<expression::AbstractExpression *> where_conjuncts;
+    util::SplitPredicates(predicate_prop->GetPredicate(), where_conjuncts);
+    for (auto conjunct : where_conjuncts) {
+      bool pushed_down = false;
+      for (auto pushed_conjunct : pushed_conjuncts) {
+        if (conjunct->Equals(pushed_conjunct)) {
+          pushed_down = true;
+          break;
+        }
+      }
+      if (pushed_down) continue;
+      LOG_TRACE("where_predicate %s", conjunct->GetInfo().c_str());
+      predicates.emplace_back(conjunct->Copy());
+    }
   }
 
   // Extract join columns
@@ -648,6 +773,78 @@ unique_ptr<planner::AbstractPlan> OperatorToPlanTransformer::GenerateJoinPlan(
     predicates.emplace_back(remaining_predicate);
   }
 
+  // An index nested loop join looks up the leading key columns of an index of
+  // the inner table, the other join columns are compared by its predicate
+  vector<oid_t> left_key_col_ids, right_key_col_ids, index_key_column_ids;
+  oid_t index_id = 0;
+
+  // A merge join merges full scans of indexes of both tables on the first
+  // pair of join columns that both have one, on which the key order is
+  oid_t left_index_id = 0;
+  size_t merge_key = 0;
+  if (join_plan_type == PlanNodeType::NESTLOOPINDEX) {
+    auto scan_plan =
+        static_cast<const planner::AbstractScan *>(children_plans_[1].get());
+    vector<oid_t> join_column_ids;
+    for (auto &expr : right_hash_keys)
+      join_column_ids.push_back(scan_plan->GetColumnIds()[
+          reinterpret_cast<const expression::TupleValueExpression *>(
+              expr.get())->GetColumnId()]);
+
+    size_t key_count =
+        util::GetJoinIndex(scan_plan->GetTable(), join_column_ids, index_id);
+    PL_ASSERT(key_count > 0);
+    const vector<oid_t> &key_attrs = scan_plan->GetTable()
+                                         ->GetIndex(index_id)
+                                         ->GetMetadata()
+                                         ->GetKeyAttrs();
+    vector<bool> is_key(join_column_ids.size(), false);
+    for (size_t key_itr = 0; key_itr < key_count; key_itr++) {
+      size_t join_itr = std::find(join_column_ids.begin(),
+                                  join_column_ids.end(), key_attrs[key_itr]) -
+                        join_column_ids.begin();
+      is_key[join_itr] = true;
+      left_key_col_ids.push_back(
+          reinterpret_cast<const expression::TupleValueExpression *>(
+              left_hash_keys[join_itr].get())->GetColumnId());
+      right_key_col_ids.push_back(
+          reinterpret_cast<const expression::TupleValueExpression *>(
+              right_hash_keys[join_itr].get())->GetColumnId());
+      index_key_column_ids.push_back(key_attrs[key_itr]);
+    }
+    for (size_t join_itr = 0; join_itr < join_column_ids.size(); join_itr++) {
+      if (is_key[join_itr] == false)
+        predicates.emplace_back(expression::ExpressionUtil::ComparisonFactory(
+            ExpressionType::COMPARE_EQUAL, left_hash_keys[join_itr]->Copy(),
+            right_hash_keys[join_itr]->Copy()));
+    }
+  } else if (join_plan_type == PlanNodeType::MERGEJOIN) {
+    auto left_scan =
+        static_cast<const planner::AbstractScan *>(children_plans_[0].get());
+    auto right_scan =
+        static_cast<const planner::AbstractScan *>(children_plans_[1].get());
+    for (merge_key = 0; merge_key < left_hash_keys.size(); merge_key++) {
+      oid_t left_column_id = left_scan->GetColumnIds()[
+          reinterpret_cast<const expression::TupleValueExpression *>(
+              left_hash_keys[merge_key].get())->GetColumnId()];
+      oid_t right_column_id = right_scan->GetColumnIds()[
+          reinterpret_cast<const expression::TupleValueExpression *>(
+              right_hash_keys[merge_key].get())->GetColumnId()];
+      if (util::GetOrderedIndex(left_scan->GetTable(), left_column_id,
+                                left_index_id) &&
+          util::GetOrderedIndex(right_scan->GetTable(), right_column_id,
+                                index_id))
+        break;
+    }
+    PL_ASSERT(merge_key < left_hash_keys.size());
+    for (size_t join_itr = 0; join_itr < left_hash_keys.size(); join_itr++) {
+      if (join_itr != merge_key)
+        predicates.emplace_back(expression::ExpressionUtil::ComparisonFactory(
+            ExpressionType::COMPARE_EQUAL, left_hash_keys[join_itr]->Copy(),
+            right_hash_keys[join_itr]->Copy()));
+    }
+  }
+
   // Generate the combined predicate and evaluate it
   unique_ptr<expression::AbstractExpression> predicate{
       util::CombinePredicates(predicates)};
@@ -655,7 +852,7 @@ unique_ptr<planner::AbstractPlan> OperatorToPlanTransformer::GenerateJoinPlan(
                                                  predicate.get());
 
   unique_ptr<planner::AbstractPlan> join_plan;
-  if (is_hash) {
+  if (join_plan_type == PlanNodeType::HASHJOIN) {
     // Generate hash join plan
     PL_ASSERT(left_hash_keys.size() == right_hash_keys.size());
     PL_ASSERT(left_hash_keys.size() != 0);
@@ -668,12 +865,57 @@ unique_ptr<planner::AbstractPlan> OperatorToPlanTransformer::GenerateJoinPlan(
     unique_ptr<planner::HashPlan> hash_plan(new planner::HashPlan(hash_keys));
     hash_plan->AddChild(move(children_plans_[1]));
 
-    join_plan = unique_ptr<planner::AbstractPlan>(
+    unique_ptr<planner::HashJoinPlan> hash_join_plan(
         new planner::HashJoinPlan(join_type, move(predicate), move(proj_info),
                                   schema_ptr, left_hash_keys, right_hash_keys));
+    hash_join_plan->SetBuildCardinality(
+        EstimateCardinality(*children_plans_[0]));
+    join_plan = move(hash_join_plan);
 
     join_plan->AddChild(move(children_plans_[0]));
     join_plan->AddChild(move(hash_plan));
+  } else if (join_plan_type == PlanNodeType::NESTLOOPINDEX) {
+    // Scan the same columns of the inner table through the index, with the
+    // keys of the outer tuples set by the join
+    auto scan_plan =
+        static_cast<const planner::AbstractScan *>(children_plans_[1].get());
+    storage::DataTable *table = scan_plan->GetTable();
+    vector<ExpressionType> expr_types(index_key_column_ids.size(),
+                                      ExpressionType::COMPARE_EQUAL);
+    vector<type::Value> values;
+    for (auto column_id : index_key_column_ids)
+      values.push_back(type::ValueFactory::GetNullValueByType(
+          table->GetSchema()->GetType(column_id)));
+    vector<expression::AbstractExpression *> runtime_keys;
+    planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+        table->GetIndex(index_id), index_key_column_ids, expr_types, values,
+        runtime_keys);
+
+    auto scan_predicate = scan_plan->GetPredicate();
+    unique_ptr<planner::AbstractPlan> index_scan_plan(
+        new planner::IndexScanPlan(
+            table, scan_predicate == nullptr ? nullptr : scan_predicate->Copy(),
+            scan_plan->GetColumnIds(), index_scan_desc,
+            scan_plan->IsForUpdate()));
+
+    join_plan = unique_ptr<planner::AbstractPlan>(
+        new planner::IndexNestedLoopJoinPlan(
+            join_type, move(predicate), move(proj_info), schema_ptr,
+            left_key_col_ids, right_key_col_ids));
+    join_plan->AddChild(move(children_plans_[0]));
+    join_plan->AddChild(move(index_scan_plan));
+  } else if (join_plan_type == PlanNodeType::MERGEJOIN) {
+    vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+    join_clauses.emplace_back(left_hash_keys[merge_key]->Copy(),
+                              right_hash_keys[merge_key]->Copy(), false);
+    join_plan = unique_ptr<planner::AbstractPlan>(new planner::MergeJoinPlan(
+        join_type, move(predicate), move(proj_info), schema_ptr,
+        join_clauses));
+
+    // Both sides are read in the order of the join key, so neither is sorted
+    join_plan->AddChild(
+        GenerateKeyOrderedScan(*children_plans_[0], left_index_id));
+    join_plan->AddChild(GenerateKeyOrderedScan(*children_plans_[1], index_id));
   } else {
     // NL Join plan use offset for join column
     vector<oid_t> left_join_col_ids, right_join_col_ids;
@@ -702,5 +944,49 @@ void OperatorToPlanTransformer::VisitOpExpression(
   op->Op().Accept(this);
 }
 
+// Scan the same columns of the table of the scan plan through the given index,
+// in the order of its keys
+unique_ptr<planner::AbstractPlan>
+OperatorToPlanTransformer::GenerateKeyOrderedScan(
+    const planner::AbstractPlan &scan_plan, oid_t index_id) {
+  auto &scan = static_cast<const planner::AbstractScan &>(scan_plan);
+  storage::DataTable *table = scan.GetTable();
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      table->GetIndex(index_id), {}, {}, {}, {});
+
+  auto scan_predicate = scan.GetPredicate();
+  unique_ptr<planner::IndexScanPlan> index_scan_plan(new planner::IndexScanPlan(
+      table, scan_predicate == nullptr ? nullptr : scan_predicate->Copy(),
+      scan.GetColumnIds(), index_scan_desc, scan.IsForUpdate()));
+  index_scan_plan->SetKeyOrdered(true);
+  return move(index_scan_plan);
+}
+
+// Estimate the number of tuples the plan produces from the stats of the
+// tables it scans. Predicates are not taken into account, so this is an upper
+// bound. Tables without stats count as empty.
+size_t OperatorToPlanTransformer::EstimateCardinality(
+    const planner::AbstractPlan &plan) {
+  switch (plan.GetPlanNodeType()) {
+    case PlanNodeType::SEQSCAN:
+    case PlanNodeType::INDEXSCAN: {
+      auto *table = static_cast<const planner::AbstractScan &>(plan).GetTable();
+      if (table == nullptr) {
+        return 0;
+      }
+      auto table_stats = StatsStorage::GetInstance()->GetTableStats(
+          table->GetDatabaseOid(), table->GetOid());
+      return table_stats->num_rows;
+    }
+    default: {
+      size_t cardinality = 0;
+      for (const auto &child : plan.GetChildren()) {
+        cardinality = std::max(cardinality, EstimateCardinality(*child));
+      }
+      return cardinality;
+    }
+  }
+}
+
 } /* namespace optimizer */
 } /* namespace peloton */
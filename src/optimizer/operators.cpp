@@ -299,6 +299,26 @@ Operator PhysicalOuterNLJoin::make(std::shared_ptr<expression::AbstractExpressio
   return Operator(join);
 }
 
+//===--------------------------------------------------------------------===//
+// InnerIndexNLJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalInnerIndexNLJoin::make(
+    std::shared_ptr<expression::AbstractExpression> join_predicate) {
+  PhysicalInnerIndexNLJoin *join = new PhysicalInnerIndexNLJoin();
+  join->join_predicate = join_predicate;
+  return Operator(join);
+}
+
+//===--------------------------------------------------------------------===//
+// InnerMergeJoin
+//===--------------------------------------------------------------------===//
+Operator PhysicalInnerMergeJoin::make(
+    std::shared_ptr<expression::AbstractExpression> join_predicate) {
+  PhysicalInnerMergeJoin *join = new PhysicalInnerMergeJoin();
+  join->join_predicate = join_predicate;
+  return Operator(join);
+}
+
 //===--------------------------------------------------------------------===//
 // InnerHashJoin
 //===--------------------------------------------------------------------===//
@@ -556,6 +576,12 @@ std::string OperatorNode<PhysicalRightNLJoin>::name_ = "PhysicalRightNLJoin";
 template <>
 std::string OperatorNode<PhysicalOuterNLJoin>::name_ = "PhysicalOuterNLJoin";
 template <>
+std::string OperatorNode<PhysicalInnerIndexNLJoin>::name_ =
+    "PhysicalInnerIndexNLJoin";
+template <>
+std::string OperatorNode<PhysicalInnerMergeJoin>::name_ =
+    "PhysicalInnerMergeJoin";
+template <>
 std::string OperatorNode<PhysicalInnerHashJoin>::name_ =
     "PhysicalInnerHashJoin";
 template <>
@@ -637,6 +663,10 @@ OpType OperatorNode<PhysicalRightNLJoin>::type_ = OpType::RightNLJoin;
 template <>
 OpType OperatorNode<PhysicalOuterNLJoin>::type_ = OpType::OuterNLJoin;
 template <>
+OpType OperatorNode<PhysicalInnerIndexNLJoin>::type_ = OpType::InnerIndexNLJoin;
+template <>
+OpType OperatorNode<PhysicalInnerMergeJoin>::type_ = OpType::InnerMergeJoin;
+template <>
 OpType OperatorNode<PhysicalInnerHashJoin>::type_ = OpType::InnerHashJoin;
 template <>
 OpType OperatorNode<PhysicalLeftHashJoin>::type_ = OpType::LeftHashJoin;
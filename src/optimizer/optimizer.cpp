@@ -15,11 +15,20 @@
 #include "optimizer/optimizer.h"
 
 #include "catalog/manager.h"
+#include "codegen/query_compiler.h"
+#include "configuration/configuration.h"
+#include "expression/aggregate_expression.h"
+#include "expression/expression_util.h"
+#include "expression/tuple_value_expression.h"
 
 #include "parser/create_statement.h"
+#include "parser/delete_statement.h"
+#include "parser/select_statement.h"
+#include "parser/update_statement.h"
 #include "optimizer/binding.h"
 #include "optimizer/child_property_generator.h"
 #include "optimizer/cost_and_stats_calculator.h"
+#include "optimizer/join_enumerator.h"
 #include "optimizer/operator_to_plan_transformer.h"
 #include "optimizer/operator_visitor.h"
 #include "optimizer/property_enforcer.h"
@@ -32,11 +41,19 @@
 #include "planner/projection_plan.h"
 #include "planner/seq_scan_plan.h"
 #include "planner/create_plan.h"
+#include "planner/exchange_plan.h"
 #include "planner/drop_plan.h"
 #include "planner/populate_index_plan.h"
+#include "planner/aggregate_view_scan_plan.h"
 #include "planner/analyze_plan.h"
+#include "planner/append_plan.h"
+#include "planner/delete_plan.h"
+#include "planner/update_plan.h"
 
+#include "storage/aggregate_view.h"
 #include "storage/data_table.h"
+#include "storage/partitioned_table.h"
+#include "util/string_util.h"
 
 #include "binder/bind_node_visitor.h"
 
@@ -74,6 +91,10 @@ Optimizer::Optimizer() {
   physical_implementation_rules_.emplace_back(new LeftJoinToLeftNLJoin());
   physical_implementation_rules_.emplace_back(new RightJoinToRightNLJoin());
   physical_implementation_rules_.emplace_back(new OuterJoinToOuterNLJoin());
+  // These tie with a hash join, which they must win when they apply
+  physical_implementation_rules_.emplace_back(
+      new InnerJoinToInnerIndexNLJoin());
+  physical_implementation_rules_.emplace_back(new InnerJoinToInnerMergeJoin());
   physical_implementation_rules_.emplace_back(new InnerJoinToInnerHashJoin());
 }
 
@@ -96,7 +117,20 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
   // Run binder
   auto bind_node_visitor = make_shared<binder::BindNodeVisitor>();
   bind_node_visitor->BindNameToNode(parse_tree);
-  
+
+  // A lookup of a single row by a unique key has only one sensible plan
+  try {
+    auto point_plan = HandlePointStatement(parse_tree);
+    if (point_plan != nullptr) {
+      Reset();
+      return move(point_plan);
+    }
+  }
+  catch (Exception &e) {
+    Reset();
+    throw e;
+  }
+
   // Generate initial operator tree from query tree
   shared_ptr<GroupExpression> gexpr = InsertQueryTree(parse_tree);
   GroupID root_id = gexpr->GetGroupID();
@@ -104,6 +138,10 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
   // Get the physical properties the final plan must output
   PropertySet properties = GetQueryRequiredProperties(parse_tree);
 
+  // The search budget starts with the query
+  search_start_time_ = std::chrono::steady_clock::now();
+  search_task_count_ = 0;
+
   // Explore the logically equivalent plans from the root group
   ExploreGroup(root_id);
 
@@ -121,8 +159,11 @@ shared_ptr<planner::AbstractPlan> Optimizer::BuildPelotonPlanTree(
     // Reset memo after finishing the optimization
     Reset();
 
+    best_plan = HandlePartitions(parse_tree, move(best_plan));
+    best_plan = HandleExchanges(parse_tree, move(best_plan));
+
     //  return shared_ptr<planner::AbstractPlan>(best_plan.release());
-    return move(best_plan);
+    return HandleViewStatement(parse_tree, move(best_plan));
   }
   catch (Exception &e) {
     Reset();
@@ -167,9 +208,17 @@ unique_ptr<planner::AbstractPlan> Optimizer::HandleDDLStatement(
         for (auto column_name : create_plan->GetIndexAttributes()) {
           column_ids.push_back(schema->GetColumnID(column_name));
         }
-        // Create a plan to retrieve data
+        // Create a plan to retrieve data. A partial index only gets the
+        // tuples that satisfy its predicate.
+        expression::AbstractExpression *index_predicate = nullptr;
+        if (create_stmt->index_predicate != nullptr) {
+          index_predicate = create_stmt->index_predicate->Copy();
+          expression::ExpressionUtil::TransformExpression(schema,
+                                                          index_predicate);
+        }
         std::unique_ptr<planner::SeqScanPlan> child_SeqScanPlan(
-            new planner::SeqScanPlan(target_table, nullptr, column_ids, false));
+            new planner::SeqScanPlan(target_table, index_predicate, column_ids,
+                                     false));
 
         child_SeqScanPlan->AddChild(std::move(ddl_plan));
         ddl_plan = std::move(child_SeqScanPlan);
@@ -205,11 +254,392 @@ unique_ptr<planner::AbstractPlan> Optimizer::HandleDDLStatement(
   return ddl_plan;
 }
 
+unique_ptr<planner::AbstractPlan> Optimizer::HandlePointStatement(
+    parser::SQLStatement *tree) {
+  storage::DataTable *target_table = nullptr;
+  expression::AbstractExpression *predicate = nullptr;
+  shared_ptr<OperatorExpression> scan_expr;
+  shared_ptr<OperatorExpression> root_expr;
+  switch (tree->GetType()) {
+    case StatementType::SELECT: {
+      auto select_stmt = static_cast<parser::SelectStatement *>(tree);
+      auto table_ref = select_stmt->from_table;
+      if (table_ref == nullptr || table_ref->select != nullptr ||
+          table_ref->join != nullptr ||
+          (table_ref->list != nullptr && table_ref->list->size() > 1) ||
+          select_stmt->group_by != nullptr || select_stmt->order != nullptr ||
+          select_stmt->limit != nullptr || select_stmt->select_distinct ||
+          select_stmt->union_select != nullptr)
+        return nullptr;
+      if (table_ref->list != nullptr) table_ref = table_ref->list->at(0);
+
+      // The scan has to produce the select list as is
+      ExprSet columns;
+      bool has_star = false;
+      for (auto expr : *select_stmt->select_list) {
+        if (expr->GetExpressionType() == ExpressionType::STAR)
+          has_star = true;
+        else if (expr->GetExpressionType() != ExpressionType::VALUE_TUPLE)
+          return nullptr;
+        columns.emplace(expr->Copy());
+      }
+      if (columns.size() != select_stmt->select_list->size() ||
+          (has_star && columns.size() > 1))
+        return nullptr;
+
+      target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+          table_ref->GetDatabaseName(), table_ref->GetTableName());
+      predicate = select_stmt->where_clause;
+      scan_expr = make_shared<OperatorExpression>(PhysicalIndexScan::make(
+          target_table, table_ref->GetTableAlias(), false));
+      root_expr = scan_expr;
+      break;
+    }
+    case StatementType::UPDATE: {
+      auto update_stmt = static_cast<parser::UpdateStatement *>(tree);
+      target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+          update_stmt->table->GetDatabaseName(),
+          update_stmt->table->GetTableName());
+      predicate = update_stmt->where;
+      scan_expr = make_shared<OperatorExpression>(PhysicalIndexScan::make(
+          target_table, update_stmt->table->GetTableName(), true));
+      root_expr = make_shared<OperatorExpression>(
+          PhysicalUpdate::make(target_table, *update_stmt->updates));
+      root_expr->PushChild(scan_expr);
+      break;
+    }
+    case StatementType::DELETE: {
+      auto delete_stmt = static_cast<parser::DeleteStatement *>(tree);
+      target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+          delete_stmt->GetDatabaseName(), delete_stmt->GetTableName());
+      predicate = delete_stmt->expr;
+      scan_expr = make_shared<OperatorExpression>(PhysicalIndexScan::make(
+          target_table, delete_stmt->GetTableName(), false));
+      root_expr = make_shared<OperatorExpression>(
+          PhysicalDelete::make(target_table));
+      root_expr->PushChild(scan_expr);
+      break;
+    }
+    default:
+      return nullptr;
+  }
+  if (target_table == nullptr || predicate == nullptr) return nullptr;
+
+  // The index has to be unique and all its keys compared for equality
+  vector<oid_t> key_column_ids;
+  vector<ExpressionType> expr_types;
+  vector<type::Value> values;
+  oid_t index_id = 0;
+  if (util::CheckIndexSearchable(target_table, predicate, key_column_ids,
+                                 expr_types, values, index_id) == false)
+    return nullptr;
+  auto index = target_table->GetIndex(index_id);
+  if (index == nullptr || index->HasUniqueKeys() == false ||
+      index->GetMetadata()->IsBuilding() == true)
+    return nullptr;
+  for (auto key_column_id : index->GetMetadata()->GetKeyAttrs()) {
+    bool bound = false;
+    for (size_t key_idx = 0; key_idx < key_column_ids.size(); key_idx++) {
+      if (key_column_ids[key_idx] == key_column_id &&
+          expr_types[key_idx] == ExpressionType::COMPARE_EQUAL) {
+        bound = true;
+        break;
+      }
+    }
+    if (bound == false) return nullptr;
+  }
+
+  // The scan has to provide all the required properties by itself
+  PropertySet requirements = GetQueryRequiredProperties(tree);
+  for (auto &property : requirements.Properties()) {
+    if (property->Type() != PropertyType::COLUMNS &&
+        property->Type() != PropertyType::PREDICATE)
+      return nullptr;
+  }
+  LOG_TRACE("Planning point statement on %s", target_table->GetName().c_str());
+
+  // Convert the scan, and the update or delete above it, the way the plan of
+  // the memo would be
+  vector<PropertySet> scan_input_props;
+  vector<unique_ptr<planner::AbstractPlan>> scan_children_plans;
+  vector<ExprMap> scan_children_expr_map;
+  if (root_expr == scan_expr) {
+    ExprMap output_expr_map;
+    return OptimizerPlanToPlannerPlan(scan_expr, requirements, scan_input_props,
+                                      scan_children_plans,
+                                      scan_children_expr_map, &output_expr_map);
+  }
+  ExprMap scan_expr_map;
+  vector<PropertySet> required_input_props{requirements};
+  vector<unique_ptr<planner::AbstractPlan>> children_plans;
+  children_plans.push_back(OptimizerPlanToPlannerPlan(
+      scan_expr, requirements, scan_input_props, scan_children_plans,
+      scan_children_expr_map, &scan_expr_map));
+  vector<ExprMap> children_expr_map;
+  children_expr_map.push_back(move(scan_expr_map));
+  ExprMap output_expr_map;
+  return OptimizerPlanToPlannerPlan(root_expr, requirements,
+                                    required_input_props, children_plans,
+                                    children_expr_map, &output_expr_map);
+}
+
+namespace {
+
+// Wrap a scan of a table of several tile groups in an exchange, or the scans
+// below any other plan
+unique_ptr<planner::AbstractPlan> PlaceExchanges(
+    unique_ptr<planner::AbstractPlan> plan) {
+  if (plan->GetPlanNodeType() != PlanNodeType::SEQSCAN ||
+      !plan->GetChildren().empty()) {
+    for (uint32_t i = 0; i < plan->GetChildren().size(); i++) {
+      auto child = plan->ReplaceChild(i, nullptr);
+      plan->ReplaceChild(i, PlaceExchanges(move(child)));
+    }
+    return plan;
+  }
+
+  auto scan = static_cast<planner::SeqScanPlan *>(plan.get());
+  if (scan->IsForUpdate() || scan->GetTable()->GetTileGroupCount() <= 1)
+    return plan;
+  unique_ptr<planner::AbstractPlan> exchange(new planner::ExchangePlan(0));
+  exchange->AddChild(move(plan));
+  return exchange;
+}
+
+// Append the plans, if there are several
+unique_ptr<planner::AbstractPlan> AppendPlans(
+    vector<unique_ptr<planner::AbstractPlan>> plans) {
+  if (plans.size() == 1) return move(plans.front());
+
+  unique_ptr<planner::AbstractPlan> append(new planner::AppendPlan());
+  for (auto &plan : plans) {
+    append->AddChild(move(plan));
+  }
+  return append;
+}
+
+// Replace an update or a delete of a partitioned table with the ones of the
+// partitions its scan can find tuples in. An update of the partition column
+// inserts the new tuples through the partitioned table, so that they move to
+// the partition of their new key.
+unique_ptr<planner::AbstractPlan> PlacePartitionWrites(
+    unique_ptr<planner::AbstractPlan> plan, storage::DataTable *table) {
+  if (plan->GetChildren().size() != 1 ||
+      plan->GetChildren()[0]->GetPlanNodeType() != PlanNodeType::SEQSCAN ||
+      !plan->GetChildren()[0]->GetChildren().empty()) {
+    throw NotImplementedException(StringUtil::Format(
+        "Cannot find the partitions of table %s to write",
+        table->GetName().c_str()));
+  }
+
+  // the table itself is empty, so it can be written if no partition is left
+  auto scan = static_cast<const planner::SeqScanPlan *>(
+      plan->GetChildren()[0].get());
+  auto partitioned_table = table->GetPartitionedTable();
+  auto predicate = scan->GetPredicate();
+  auto partitions = partitioned_table->GetPartitions(predicate);
+  if (partitions.empty()) return plan;
+
+  vector<unique_ptr<planner::AbstractPlan>> partition_writes;
+  for (auto partition : partitions) {
+    unique_ptr<planner::AbstractPlan> partition_write;
+    if (plan->GetPlanNodeType() == PlanNodeType::UPDATE) {
+      auto project_info =
+          static_cast<planner::UpdatePlan *>(plan.get())->GetProjectInfo();
+      unique_ptr<planner::UpdatePlan> partition_update(
+          new planner::UpdatePlan(partition, project_info->Copy()));
+      for (auto &target : project_info->GetTargetList()) {
+        if (target.first == partitioned_table->GetPartitionColumn()) {
+          partition_update->SetInsertTable(table);
+        }
+      }
+      partition_write = move(partition_update);
+    } else {
+      partition_write.reset(new planner::DeletePlan(partition, predicate));
+    }
+    partition_write->AddChild(unique_ptr<planner::AbstractPlan>(
+        new planner::SeqScanPlan(
+            partition, predicate == nullptr ? nullptr : predicate->Copy(),
+            scan->GetColumnIds(), scan->IsForUpdate())));
+    partition_writes.push_back(move(partition_write));
+  }
+  return AppendPlans(move(partition_writes));
+}
+
+// Replace a scan of a partitioned table with the scans of the partitions its
+// predicate can be satisfied in, appended if there are several
+unique_ptr<planner::AbstractPlan> PlacePartitionScans(
+    unique_ptr<planner::AbstractPlan> plan) {
+  if (plan->GetPlanNodeType() == PlanNodeType::UPDATE ||
+      plan->GetPlanNodeType() == PlanNodeType::DELETE) {
+    auto table =
+        (plan->GetPlanNodeType() == PlanNodeType::UPDATE)
+            ? static_cast<planner::UpdatePlan *>(plan.get())->GetTable()
+            : static_cast<planner::DeletePlan *>(plan.get())->GetTable();
+    if (table->GetPartitionedTable() != nullptr) {
+      return PlacePartitionWrites(move(plan), table);
+    }
+  }
+  if (plan->GetPlanNodeType() != PlanNodeType::SEQSCAN ||
+      !plan->GetChildren().empty()) {
+    for (uint32_t i = 0; i < plan->GetChildren().size(); i++) {
+      auto child = plan->ReplaceChild(i, nullptr);
+      plan->ReplaceChild(i, PlacePartitionScans(move(child)));
+    }
+    return plan;
+  }
+
+  auto scan = static_cast<planner::SeqScanPlan *>(plan.get());
+  auto partitioned_table = scan->GetTable()->GetPartitionedTable();
+  if (partitioned_table == nullptr) return plan;
+
+  // the table itself is empty, so is its scan if no partition is left
+  auto predicate = scan->GetPredicate();
+  auto partitions = partitioned_table->GetPartitions(predicate);
+  if (partitions.empty()) return plan;
+
+  vector<unique_ptr<planner::AbstractPlan>> partition_scans;
+  for (auto partition : partitions) {
+    partition_scans.emplace_back(new planner::SeqScanPlan(
+        partition, predicate == nullptr ? nullptr : predicate->Copy(),
+        scan->GetColumnIds(), scan->IsForUpdate()));
+  }
+  return AppendPlans(move(partition_scans));
+}
+
+}  // namespace
+
+unique_ptr<planner::AbstractPlan> Optimizer::HandlePartitions(
+    parser::SQLStatement *tree, unique_ptr<planner::AbstractPlan> plan) {
+  auto type = tree->GetType();
+  if (type != StatementType::SELECT && type != StatementType::UPDATE &&
+      type != StatementType::DELETE && type != StatementType::INSERT)
+    return plan;
+  return PlacePartitionScans(move(plan));
+}
+
+unique_ptr<planner::AbstractPlan> Optimizer::HandleExchanges(
+    parser::SQLStatement *tree, unique_ptr<planner::AbstractPlan> plan) {
+  // A compiled query runs its scans on the morsel workers instead
+  if (tree->GetType() != StatementType::SELECT ||
+      (FLAGS_codegen && codegen::QueryCompiler::IsSupported(*plan)))
+    return plan;
+  return PlaceExchanges(move(plan));
+}
+
+unique_ptr<planner::AbstractPlan> Optimizer::HandleViewStatement(
+    parser::SQLStatement *tree, unique_ptr<planner::AbstractPlan> plan) {
+  auto &view_manager = storage::AggregateViewManager::GetInstance();
+  if (tree->GetType() != StatementType::SELECT ||
+      view_manager.GetViewCount() == 0)
+    return plan;
+
+  // The view holds the groups of the whole table
+  auto select_stmt = static_cast<parser::SelectStatement *>(tree);
+  auto table_ref = select_stmt->from_table;
+  if (table_ref == nullptr || table_ref->select != nullptr ||
+      table_ref->join != nullptr ||
+      (table_ref->list != nullptr && table_ref->list->size() > 1) ||
+      select_stmt->where_clause != nullptr || select_stmt->order != nullptr ||
+      select_stmt->limit != nullptr || select_stmt->select_distinct ||
+      select_stmt->union_select != nullptr ||
+      (select_stmt->group_by != nullptr &&
+       select_stmt->group_by->having != nullptr))
+    return plan;
+  if (table_ref->list != nullptr) table_ref = table_ref->list->at(0);
+
+  vector<oid_t> group_column_ids;
+  if (select_stmt->group_by != nullptr) {
+    for (auto expr : *select_stmt->group_by->columns) {
+      if (expr->GetExpressionType() != ExpressionType::VALUE_TUPLE)
+        return plan;
+      group_column_ids.push_back(std::get<2>(
+          static_cast<expression::TupleValueExpression *>(expr)
+              ->GetBoundOid()));
+    }
+  }
+
+  // Every select item is a group column or an aggregate the view keeps
+  vector<pair<ExpressionType, oid_t>> select_items;
+  vector<oid_t> aggregate_column_ids;
+  for (auto expr : *select_stmt->select_list) {
+    auto expr_type = expr->GetExpressionType();
+    if (expr_type == ExpressionType::AGGREGATE_COUNT_STAR) {
+      select_items.emplace_back(expr_type, INVALID_OID);
+      continue;
+    }
+
+    const expression::TupleValueExpression *column_expr = nullptr;
+    if (expr_type == ExpressionType::VALUE_TUPLE) {
+      column_expr = static_cast<expression::TupleValueExpression *>(expr);
+      if (std::find(group_column_ids.begin(), group_column_ids.end(),
+                    std::get<2>(column_expr->GetBoundOid())) ==
+          group_column_ids.end())
+        return plan;
+    } else if ((expr_type == ExpressionType::AGGREGATE_COUNT ||
+                expr_type == ExpressionType::AGGREGATE_SUM ||
+                expr_type == ExpressionType::AGGREGATE_AVG) &&
+               !static_cast<expression::AggregateExpression *>(expr)
+                    ->distinct_ &&
+               expr->GetChild(0)->GetExpressionType() ==
+                   ExpressionType::VALUE_TUPLE) {
+      column_expr = static_cast<const expression::TupleValueExpression *>(
+          expr->GetChild(0));
+      aggregate_column_ids.push_back(std::get<2>(column_expr->GetBoundOid()));
+    } else {
+      return plan;
+    }
+    select_items.emplace_back(expr_type,
+                              std::get<2>(column_expr->GetBoundOid()));
+  }
+
+  auto target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+      table_ref->GetDatabaseName(), table_ref->GetTableName());
+  auto view = view_manager.FindView(target_table, group_column_ids,
+                                    aggregate_column_ids);
+  if (view == nullptr) return plan;
+
+  // The view produces the columns in the order of the select list
+  vector<planner::AggregateViewScanPlan::OutputColumn> output_columns;
+  vector<catalog::Column> columns;
+  for (size_t item_itr = 0; item_itr < select_items.size(); item_itr++) {
+    auto expr_type = select_items[item_itr].first;
+    auto column_id = select_items[item_itr].second;
+    oid_t offset = INVALID_OID;
+    if (expr_type == ExpressionType::VALUE_TUPLE)
+      offset = view->GetGroupOffset(column_id);
+    else if (expr_type != ExpressionType::AGGREGATE_COUNT_STAR)
+      offset = view->GetAggregateOffset(column_id);
+    output_columns.push_back({expr_type, offset});
+
+    auto expr = select_stmt->select_list->at(item_itr);
+    expr->DeduceExpressionType();
+    columns.push_back(catalog::Column(
+        expr->GetValueType(), type::Type::GetTypeSize(expr->GetValueType()),
+        expr->GetExpressionName()));
+  }
+
+  LOG_TRACE("Answering from aggregate view %s", view->GetName().c_str());
+  shared_ptr<const catalog::Schema> output_schema(new catalog::Schema(columns));
+  unique_ptr<planner::AbstractPlan> view_plan(
+      new planner::AggregateViewScanPlan(view, move(output_columns),
+                                         output_schema));
+  view_plan->AddChild(move(plan));
+  return view_plan;
+}
+
 shared_ptr<GroupExpression> Optimizer::InsertQueryTree(
     parser::SQLStatement *tree) {
   QueryToOperatorTransformer converter;
   shared_ptr<OperatorExpression> initial =
       converter.ConvertToOpExpression(tree);
+
+  // Join the relations of the query in the order of the least estimated cost
+  if (tree->GetType() == StatementType::SELECT) {
+    JoinEnumerator enumerator(static_cast<parser::SelectStatement *>(tree));
+    initial = enumerator.ReorderJoins(initial);
+  }
+
   shared_ptr<GroupExpression> gexpr;
   RecordTransformedExpression(initial, gexpr);
   return gexpr;
@@ -281,6 +711,13 @@ void Optimizer::OptimizeGroup(GroupID id, PropertySet requirements) {
 
   const vector<shared_ptr<GroupExpression>> exprs = group->GetExpressions();
   for (size_t i = 0; i < exprs.size(); ++i) {
+    // Out of budget, the best expression found so far is kept. Every group
+    // costs at least one, so that there is a plan.
+    if (group->GetBestExpression(requirements) != nullptr &&
+        HasExceededBudget()) {
+      LOG_DEBUG("Search budget exceeded at group %d", id);
+      break;
+    }
     if (exprs[i]->Op().IsPhysical()) OptimizeExpression(exprs[i], requirements);
   }
 }
@@ -292,6 +729,7 @@ void Optimizer::OptimizeExpression(shared_ptr<GroupExpression> gexpr,
 
   // Only optimize and cost physical expression
   PL_ASSERT(gexpr->Op().IsPhysical());
+  search_task_count_++;
 
   vector<pair<PropertySet, vector<PropertySet>>> output_input_property_pairs =
       DeriveChildProperties(gexpr, requirements);
@@ -370,6 +808,18 @@ void Optimizer::OptimizeExpression(shared_ptr<GroupExpression> gexpr,
   LOG_TRACE("Optimizing expression finishes");
 }
 
+bool Optimizer::HasExceededBudget() const {
+  if (FLAGS_optimizer_task_budget > 0 &&
+      search_task_count_ >= FLAGS_optimizer_task_budget)
+    return true;
+  if (FLAGS_optimizer_timeout > 0) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - search_start_time_);
+    return static_cast<uint64_t>(elapsed.count()) >= FLAGS_optimizer_timeout;
+  }
+  return false;
+}
+
 Property *Optimizer::GenerateNewPropertyCols(PropertySet requirements) {
   auto cols_prop = requirements.GetPropertyOfType(PropertyType::COLUMNS)
                        ->As<PropertyColumns>();
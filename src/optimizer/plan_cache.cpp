@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.cpp
+//
+// Identification: src/optimizer/plan_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/plan_cache.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "common/statement.h"
+#include "configuration/configuration.h"
+
+namespace peloton {
+namespace optimizer {
+
+CachedStatements::~CachedStatements() {
+  for (auto &statement : statements) {
+    MemoryTracker::Release(MemoryComponentType::PLAN_CACHE,
+                           statement->GetMemoryFootprint());
+  }
+}
+
+PlanCache &PlanCache::GetInstance() {
+  static PlanCache plan_cache;
+  return plan_cache;
+}
+
+PlanCache::PlanCache()
+    : cache_(std::max<size_t>(FLAGS_plan_cache_size, 1), kShardCount) {}
+
+std::shared_ptr<Statement> PlanCache::Acquire(const std::string &query,
+                                              uint64_t catalog_version) {
+  auto cached_statements = cache_.Find(query);
+  if (cached_statements == nullptr) {
+    return nullptr;
+  }
+  if (cached_statements->catalog_version != catalog_version) {
+    LOG_TRACE("Dropped the stale plans of %s", query.c_str());
+    cache_.Erase(query, cached_statements);
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(cached_statements->statements_mutex);
+  if (cached_statements->statements.empty()) {
+    return nullptr;
+  }
+  auto statement = cached_statements->statements.back();
+  cached_statements->statements.pop_back();
+  MemoryTracker::Release(MemoryComponentType::PLAN_CACHE,
+                         statement->GetMemoryFootprint());
+  return statement;
+}
+
+void PlanCache::Release(const std::string &query, uint64_t catalog_version,
+                        std::shared_ptr<Statement> statement) {
+  auto cached_statements = cache_.Find(query);
+
+  // A statement prepared before the catalog changed is not kept, one prepared
+  // after it replaces the stale ones
+  if (cached_statements != nullptr &&
+      cached_statements->catalog_version > catalog_version) {
+    return;
+  }
+  if (cached_statements == nullptr ||
+      cached_statements->catalog_version < catalog_version) {
+    std::shared_ptr<CachedStatements> new_statements(new CachedStatements());
+    new_statements->query = query;
+    new_statements->catalog_version = catalog_version;
+    if (cached_statements == nullptr) {
+      cached_statements = cache_.InsertIfAbsent(query, new_statements);
+    } else {
+      cache_.Insert(query, new_statements);
+      cached_statements = new_statements;
+    }
+
+    // Another statement of a different version got in first
+    if (cached_statements->catalog_version != catalog_version) {
+      return;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(cached_statements->statements_mutex);
+  if (cached_statements->statements.size() < kMaxStatementsPerQuery) {
+    MemoryTracker::Allocate(MemoryComponentType::PLAN_CACHE,
+                            statement->GetMemoryFootprint());
+    cached_statements->statements.push_back(std::move(statement));
+  }
+}
+
+std::shared_ptr<Statement> PlanCache::AcquireHandle(
+    const std::string &query, uint64_t catalog_version,
+    const std::function<std::shared_ptr<Statement>()> &prepare) {
+  auto statement = Acquire(query, catalog_version);
+
+  // A statement marked to be replanned is not handed out again
+  if (statement == nullptr || statement->GetNeedsPlan()) {
+    statement = prepare();
+    if (statement == nullptr) {
+      return nullptr;
+    }
+  }
+
+  // The handle shares the statement, and releases it once it's dropped
+  Statement *raw_statement = statement.get();
+  return std::shared_ptr<Statement>(
+      raw_statement, [statement, query, catalog_version](Statement *) mutable {
+        PlanCache::GetInstance().Release(query, catalog_version,
+                                         std::move(statement));
+      });
+}
+
+void PlanCache::Clear() { cache_.Clear(); }
+
+size_t PlanCache::GetCount() { return cache_.GetSize(); }
+
+}  // namespace optimizer
+}  // namespace peloton
@@ -192,6 +192,7 @@ bool PropertySort::operator>=(const Property &r) const {
   // All the sorting orders in r must be satisfied
   size_t num_sort_columns = r_sort.sort_columns_.size();
   PL_ASSERT(num_sort_columns == r_sort.sort_ascending_.size());
+  if (num_sort_columns > sort_columns_.size()) return false;
   for (size_t i = 0; i < num_sort_columns; ++i) {
     if (!sort_columns_[i]->Equals(r_sort.sort_columns_[i].get())) return false;
     if (sort_ascending_[i] != r_sort.sort_ascending_[i]) return false;
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "optimizer/rule_impls.h"
+#include "catalog/schema.h"
+#include "configuration/configuration.h"
 #include "optimizer/util.h"
 #include "optimizer/operators.h"
 #include "storage/data_table.h"
@@ -537,6 +539,182 @@ void OuterJoinToOuterNLJoin::Transform(
   return;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinToInnerIndexNLJoin
+namespace {
+
+// Every outer tuple costs about this many inner tuples of a hash join, as it
+// looks up the index instead of probing a hash table
+const double kIndexLookupCost = 4;
+
+// The table that the group gets, if it is a single table
+storage::DataTable *GetGroupTable(Memo *memo, GroupID group_id) {
+  for (auto &gexpr : memo->GetGroupByID(group_id)->GetExpressions()) {
+    if (gexpr->Op().type() == OpType::Get)
+      return gexpr->Op().As<LogicalGet>()->table;
+  }
+  return nullptr;
+}
+
+// An upper bound of the number of tuples of the group, which does not count
+// the predicates on its tables
+double EstimateGroupRows(Memo *memo, GroupID group_id) {
+  for (auto &gexpr : memo->GetGroupByID(group_id)->GetExpressions()) {
+    if (gexpr->Op().IsLogical() == false) continue;
+    if (gexpr->Op().type() == OpType::Get) {
+      auto table = gexpr->Op().As<LogicalGet>()->table;
+      return table == nullptr ? 1 : table->GetTupleCount();
+    }
+
+    // A join has at most the tuples of the cross product of its children
+    double rows = 1;
+    for (auto child_group_id : gexpr->GetChildGroupIDs())
+      rows *= EstimateGroupRows(memo, child_group_id);
+    return rows;
+  }
+  return 1;
+}
+
+}  // namespace
+
+InnerJoinToInnerIndexNLJoin::InnerJoinToInnerIndexNLJoin() {
+  physical = true;
+
+  std::shared_ptr<Pattern> left_child(std::make_shared<Pattern>(OpType::Leaf));
+  std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
+
+  match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
+  match_pattern->AddChild(left_child);
+  match_pattern->AddChild(right_child);
+
+  return;
+}
+
+bool InnerJoinToInnerIndexNLJoin::Check(
+    std::shared_ptr<OperatorExpression> plan, Memo *memo) const {
+  auto children = plan->Children();
+  PL_ASSERT(children.size() == 2);
+  auto left_group_id = children[0]->Op().As<LeafOperator>()->origin_group;
+  auto right_group_id = children[1]->Op().As<LeafOperator>()->origin_group;
+
+  // The inner side must be a base table with an index on the join columns
+  storage::DataTable *table = GetGroupTable(memo, right_group_id);
+  if (table == nullptr) return false;
+
+  const auto &left_group_alias =
+      memo->GetGroupByID(left_group_id)->GetTableAliases();
+  const auto &right_group_alias =
+      memo->GetGroupByID(right_group_id)->GetTableAliases();
+  PL_ASSERT(right_group_alias.size() == 1);
+  auto expr = plan->Op().As<LogicalInnerJoin>()->join_predicate.get();
+
+  std::vector<oid_t> column_ids;
+  util::GetJoinColumns(*right_group_alias.begin(), left_group_alias, expr,
+                       column_ids);
+  oid_t index_id;
+  if (util::GetJoinIndex(table, column_ids, index_id) == 0) return false;
+
+  // Looking up every outer tuple only beats hashing the inner table when the
+  // outer side is much smaller
+  return EstimateGroupRows(memo, left_group_id) * kIndexLookupCost <
+         table->GetTupleCount();
+}
+
+void InnerJoinToInnerIndexNLJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed) const {
+  const LogicalInnerJoin *inner_join = input->Op().As<LogicalInnerJoin>();
+  auto result_plan = std::make_shared<OperatorExpression>(
+      PhysicalInnerIndexNLJoin::make(inner_join->join_predicate));
+  std::vector<std::shared_ptr<OperatorExpression>> children = input->Children();
+  PL_ASSERT(children.size() == 2);
+
+  result_plan->PushChild(children[0]);
+  result_plan->PushChild(children[1]);
+
+  transformed.push_back(result_plan);
+
+  return;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// InnerJoinToInnerMergeJoin
+InnerJoinToInnerMergeJoin::InnerJoinToInnerMergeJoin() {
+  physical = true;
+
+  std::shared_ptr<Pattern> left_child(std::make_shared<Pattern>(OpType::Leaf));
+  std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
+
+  match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
+  match_pattern->AddChild(left_child);
+  match_pattern->AddChild(right_child);
+
+  return;
+}
+
+bool InnerJoinToInnerMergeJoin::Check(std::shared_ptr<OperatorExpression> plan,
+                                      Memo *memo) const {
+  auto children = plan->Children();
+  PL_ASSERT(children.size() == 2);
+  auto left_group_id = children[0]->Op().As<LeafOperator>()->origin_group;
+  auto right_group_id = children[1]->Op().As<LeafOperator>()->origin_group;
+
+  // Both sides must be base tables that an index scan reads in key order
+  storage::DataTable *left_table = GetGroupTable(memo, left_group_id);
+  storage::DataTable *right_table = GetGroupTable(memo, right_group_id);
+  if (left_table == nullptr || right_table == nullptr) return false;
+
+  // A hash join is cheaper while the inner table fits into the memory budget
+  size_t budget = FLAGS_query_memory_budget_mb << 20;
+  if (budget == 0 ||
+      static_cast<double>(right_table->GetTupleCount()) *
+              right_table->GetSchema()->GetLength() <=
+          budget)
+    return false;
+
+  const auto &left_group_alias =
+      memo->GetGroupByID(left_group_id)->GetTableAliases();
+  const auto &right_group_alias =
+      memo->GetGroupByID(right_group_id)->GetTableAliases();
+  PL_ASSERT(left_group_alias.size() == 1 && right_group_alias.size() == 1);
+  auto expr = plan->Op().As<LogicalInnerJoin>()->join_predicate.get();
+
+  // The columns of both tables are collected in the order of the conjuncts,
+  // so they come in pairs
+  std::vector<oid_t> left_column_ids, right_column_ids;
+  util::GetJoinColumns(*left_group_alias.begin(), right_group_alias, expr,
+                       left_column_ids);
+  util::GetJoinColumns(*right_group_alias.begin(), left_group_alias, expr,
+                       right_column_ids);
+  PL_ASSERT(left_column_ids.size() == right_column_ids.size());
+  for (size_t join_itr = 0; join_itr < left_column_ids.size(); join_itr++) {
+    oid_t left_index_id, right_index_id;
+    if (util::GetOrderedIndex(left_table, left_column_ids[join_itr],
+                              left_index_id) &&
+        util::GetOrderedIndex(right_table, right_column_ids[join_itr],
+                              right_index_id))
+      return true;
+  }
+  return false;
+}
+
+void InnerJoinToInnerMergeJoin::Transform(
+    std::shared_ptr<OperatorExpression> input,
+    std::vector<std::shared_ptr<OperatorExpression>> &transformed) const {
+  const LogicalInnerJoin *inner_join = input->Op().As<LogicalInnerJoin>();
+  auto result_plan = std::make_shared<OperatorExpression>(
+      PhysicalInnerMergeJoin::make(inner_join->join_predicate));
+  std::vector<std::shared_ptr<OperatorExpression>> children = input->Children();
+  PL_ASSERT(children.size() == 2);
+
+  result_plan->PushChild(children[0]);
+  result_plan->PushChild(children[1]);
+
+  transformed.push_back(result_plan);
+
+  return;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// InnerJoinToInnerHashJoin
 InnerJoinToInnerHashJoin::InnerJoinToInnerHashJoin() {
@@ -0,0 +1,294 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_estimator.cpp
+//
+// Identification: src/optimizer/stats/cardinality_estimator.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats/cardinality_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/stats/column_stats.h"
+#include "optimizer/stats/selectivity.h"
+#include "optimizer/stats/stats_util.h"
+#include "optimizer/stats/table_stats.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+ExpressionType MirrorComparison(ExpressionType type) {
+  switch (type) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return type;
+  }
+}
+
+void CollectConjuncts(
+    const expression::AbstractExpression *predicate,
+    std::vector<const expression::AbstractExpression *> &conjuncts) {
+  if (predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    for (size_t child_idx = 0; child_idx < predicate->GetChildrenSize();
+         child_idx++) {
+      CollectConjuncts(predicate->GetChild(child_idx), conjuncts);
+    }
+  } else {
+    conjuncts.push_back(predicate);
+  }
+}
+
+oid_t GetColumnId(const expression::AbstractExpression *column) {
+  return std::get<2>(
+      static_cast<const expression::TupleValueExpression *>(column)
+          ->GetBoundOid());
+}
+
+}  // namespace
+
+double CardinalityEstimator::EstimateSelectivity(
+    const std::shared_ptr<TableStats> &table_stats,
+    const expression::AbstractExpression *predicate) {
+  if (predicate == nullptr) {
+    return 1;
+  }
+
+  switch (predicate->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND: {
+      std::vector<const expression::AbstractExpression *> conjuncts;
+      CollectConjuncts(predicate, conjuncts);
+      return EstimateSelectivity(table_stats, conjuncts);
+    }
+    case ExpressionType::CONJUNCTION_OR: {
+      double left = EstimateSelectivity(table_stats, predicate->GetChild(0));
+      double right = EstimateSelectivity(table_stats, predicate->GetChild(1));
+      return left + right - left * right;
+    }
+    case ExpressionType::OPERATOR_NOT:
+      return 1 - EstimateSelectivity(table_stats, predicate->GetChild(0));
+    case ExpressionType::OPERATOR_IS_NULL: {
+      auto column = predicate->GetChild(0);
+      if (table_stats != nullptr &&
+          column->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+        auto column_stats = table_stats->GetColumnStats(GetColumnId(column));
+        if (column_stats != nullptr) {
+          return column_stats->frac_null;
+        }
+      }
+      return DEFAULT_SELECTIVITY;
+    }
+    default: {
+      std::vector<ValueCondition> conditions;
+      if (GetCondition(predicate, conditions) == false) {
+        return DEFAULT_SELECTIVITY;
+      }
+      return EstimateSelectivity(table_stats, conditions);
+    }
+  }
+}
+
+double CardinalityEstimator::EstimateSelectivity(
+    const std::shared_ptr<TableStats> &table_stats,
+    const std::vector<const expression::AbstractExpression *> &conjuncts) {
+  std::vector<const expression::AbstractExpression *> flattened;
+  for (auto conjunct : conjuncts) {
+    CollectConjuncts(conjunct, flattened);
+  }
+
+  std::vector<ValueCondition> conditions;
+  std::vector<double> selectivities;
+  for (auto conjunct : flattened) {
+    if (GetCondition(conjunct, conditions) == false) {
+      selectivities.push_back(EstimateSelectivity(table_stats, conjunct));
+    }
+  }
+  CollectColumnSelectivities(table_stats, conditions, selectivities);
+  return CombineConjuncts(selectivities);
+}
+
+double CardinalityEstimator::EstimateSelectivity(
+    const std::shared_ptr<TableStats> &table_stats,
+    const std::vector<ValueCondition> &conditions) {
+  std::vector<double> selectivities;
+  CollectColumnSelectivities(table_stats, conditions, selectivities);
+  return CombineConjuncts(selectivities);
+}
+
+double CardinalityEstimator::EstimateJoinSelectivity(double left_distinct,
+                                                     double left_rows,
+                                                     double right_distinct,
+                                                     double right_rows) {
+  double distinct = std::max(std::min(left_distinct, left_rows),
+                             std::min(right_distinct, right_rows));
+  return 1 / std::max(distinct, 1.0);
+}
+
+void CardinalityEstimator::CollectColumnSelectivities(
+    const std::shared_ptr<TableStats> &table_stats,
+    const std::vector<ValueCondition> &conditions,
+    std::vector<double> &selectivities) {
+  std::map<oid_t, std::vector<const ValueCondition *>> column_conditions;
+  for (auto &condition : conditions) {
+    column_conditions[condition.column_id].push_back(&condition);
+  }
+  for (auto &entry : column_conditions) {
+    selectivities.push_back(
+        EstimateColumnSelectivity(table_stats, entry.second));
+  }
+}
+
+double CardinalityEstimator::EstimateColumnSelectivity(
+    const std::shared_ptr<TableStats> &table_stats,
+    const std::vector<const ValueCondition *> &conditions) {
+  if (table_stats == nullptr) {
+    return DEFAULT_SELECTIVITY;
+  }
+
+  // The tightest bounds of a range, and the conditions that are not part of
+  // one
+  const ValueCondition *lower = nullptr;
+  const ValueCondition *upper = nullptr;
+  double lower_value = 0;
+  double upper_value = 0;
+  bool has_equal = false;
+  double equal = 1;
+  double others = 1;
+  for (auto condition : conditions) {
+    double value = StatsUtil::PelotonValueToNumericValue(condition->value);
+    switch (condition->type) {
+      case ExpressionType::COMPARE_EQUAL:
+        has_equal = true;
+        equal = std::min(equal, Selectivity::Equal(table_stats, *condition));
+        break;
+      case ExpressionType::COMPARE_LESSTHAN:
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        if (std::isnan(value)) {
+          others *= Selectivity::ComputeSelectivity(table_stats, *condition);
+        } else if (upper == nullptr || value < upper_value ||
+                   (value == upper_value &&
+                    condition->type == ExpressionType::COMPARE_LESSTHAN)) {
+          upper = condition;
+          upper_value = value;
+        }
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        if (std::isnan(value)) {
+          others *= Selectivity::ComputeSelectivity(table_stats, *condition);
+        } else if (lower == nullptr || value > lower_value ||
+                   (value == lower_value &&
+                    condition->type == ExpressionType::COMPARE_GREATERTHAN)) {
+          lower = condition;
+          lower_value = value;
+        }
+        break;
+      default:
+        others *= Selectivity::ComputeSelectivity(table_stats, *condition);
+        break;
+    }
+  }
+
+  // An equality leaves at most one value of any range
+  if (has_equal) {
+    return equal * others;
+  }
+
+  double range = 1;
+  if (lower != nullptr && upper != nullptr) {
+    double below_upper =
+        upper->type == ExpressionType::COMPARE_LESSTHAN
+            ? Selectivity::LessThan(table_stats, *upper)
+            : Selectivity::LessThanOrEqualTo(table_stats, *upper);
+    double below_lower =
+        lower->type == ExpressionType::COMPARE_GREATERTHAN
+            ? Selectivity::LessThanOrEqualTo(table_stats, *lower)
+            : Selectivity::LessThan(table_stats, *lower);
+    range = std::max(below_upper - below_lower, 0.0);
+  } else if (lower != nullptr) {
+    range = Selectivity::ComputeSelectivity(table_stats, *lower);
+  } else if (upper != nullptr) {
+    range = Selectivity::ComputeSelectivity(table_stats, *upper);
+  }
+  return range * others;
+}
+
+double CardinalityEstimator::CombineConjuncts(
+    std::vector<double> selectivities) {
+  std::sort(selectivities.begin(), selectivities.end());
+  double selectivity = 1;
+  double exponent = 1;
+  for (size_t idx = 0;
+       idx < selectivities.size() && idx < kMaxBackoffConjuncts; idx++) {
+    selectivity *= std::pow(selectivities[idx], exponent);
+    exponent /= 2;
+  }
+  return selectivity;
+}
+
+bool CardinalityEstimator::GetCondition(
+    const expression::AbstractExpression *predicate,
+    std::vector<ValueCondition> &conditions) {
+  auto type = predicate->GetExpressionType();
+  switch (type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return false;
+  }
+
+  auto column = predicate->GetChild(0);
+  auto value = predicate->GetChild(1);
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    std::swap(column, value);
+    type = MirrorComparison(type);
+  }
+  if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    return false;
+  }
+
+  // The value of a parameter is not known yet, which the selectivities of
+  // null values stand for
+  switch (value->GetExpressionType()) {
+    case ExpressionType::VALUE_CONSTANT:
+      conditions.emplace_back(
+          GetColumnId(column), type,
+          static_cast<const expression::ConstantValueExpression *>(value)
+              ->GetValue());
+      return true;
+    case ExpressionType::VALUE_PARAMETER:
+      conditions.emplace_back(
+          GetColumnId(column), type,
+          type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER));
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace optimizer
+}  // namespace peloton
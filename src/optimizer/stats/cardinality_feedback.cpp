@@ -0,0 +1,229 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_feedback.cpp
+//
+// Identification: src/optimizer/stats/cardinality_feedback.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/stats/cardinality_feedback.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "configuration/configuration.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/plan_cache.h"
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+void CollectConjuncts(
+    const expression::AbstractExpression *predicate,
+    std::vector<const expression::AbstractExpression *> &conjuncts) {
+  if (predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    for (size_t child_idx = 0; child_idx < predicate->GetChildrenSize();
+         child_idx++) {
+      CollectConjuncts(predicate->GetChild(child_idx), conjuncts);
+    }
+  } else {
+    conjuncts.push_back(predicate);
+  }
+}
+
+}  // namespace
+
+CardinalityFeedback &CardinalityFeedback::GetInstance() {
+  static CardinalityFeedback cardinality_feedback;
+  return cardinality_feedback;
+}
+
+CardinalityFeedback::CardinalityFeedback() : cache_(kMaxEntries) {}
+
+bool CardinalityFeedback::GetSelectivity(
+    oid_t table_id,
+    const std::vector<const expression::AbstractExpression *> &conjuncts,
+    double &selectivity) {
+  if (FLAGS_cardinality_feedback_error == 0 || conjuncts.empty()) {
+    return false;
+  }
+
+  auto key = GetKey(table_id, conjuncts);
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto itr = cache_.find(key);
+  if (itr == cache_.end() || (*itr)->observed_selectivity < 0) {
+    return false;
+  }
+  selectivity = (*itr)->observed_selectivity;
+  return true;
+}
+
+bool CardinalityFeedback::GetSelectivity(
+    oid_t table_id, const expression::AbstractExpression *predicate,
+    double &selectivity) {
+  if (predicate == nullptr) {
+    return false;
+  }
+  std::vector<const expression::AbstractExpression *> conjuncts;
+  CollectConjuncts(predicate, conjuncts);
+  return GetSelectivity(table_id, conjuncts, selectivity);
+}
+
+void CardinalityFeedback::SetEstimate(
+    oid_t table_id,
+    const std::vector<const expression::AbstractExpression *> &conjuncts,
+    double selectivity) {
+  if (FLAGS_cardinality_feedback_error == 0 || conjuncts.empty()) {
+    return;
+  }
+
+  auto key = GetKey(table_id, conjuncts);
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto itr = cache_.find(key);
+  if (itr != cache_.end()) {
+    (*itr)->estimated_selectivity = selectivity;
+    return;
+  }
+  std::shared_ptr<CardinalityFeedbackEntry> entry(
+      new CardinalityFeedbackEntry{key, selectivity, -1});
+  cache_.insert(std::make_pair(key, entry));
+}
+
+bool CardinalityFeedback::Record(
+    oid_t table_id, const expression::AbstractExpression *predicate,
+    size_t rows, size_t scanned_rows) {
+  if (FLAGS_cardinality_feedback_error == 0 || predicate == nullptr ||
+      scanned_rows == 0) {
+    return false;
+  }
+
+  std::vector<const expression::AbstractExpression *> conjuncts;
+  CollectConjuncts(predicate, conjuncts);
+  auto key = GetKey(table_id, conjuncts);
+  double selectivity = static_cast<double>(rows) / scanned_rows;
+
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  std::shared_ptr<CardinalityFeedbackEntry> entry;
+  auto itr = cache_.find(key);
+  if (itr != cache_.end()) {
+    entry = *itr;
+  } else {
+    entry.reset(new CardinalityFeedbackEntry{key, -1, -1});
+    cache_.insert(std::make_pair(key, entry));
+  }
+  if (entry->observed_selectivity < 0) {
+    entry->observed_selectivity = selectivity;
+  } else {
+    entry->observed_selectivity =
+        kObservationWeight * selectivity +
+        (1 - kObservationWeight) * entry->observed_selectivity;
+  }
+
+  // Compare whole rows, so that estimates of less than a row are not off
+  double estimated_rows = std::max(entry->estimated_selectivity * scanned_rows,
+                                   1.0);
+  double observed_rows = std::max(static_cast<double>(rows), 1.0);
+  if (entry->estimated_selectivity < 0 ||
+      std::max(estimated_rows / observed_rows, observed_rows / estimated_rows) <
+          FLAGS_cardinality_feedback_error) {
+    return false;
+  }
+
+  // The plans built with the estimate are replanned with the observation
+  LOG_TRACE("Estimated %lf rows for %s, observed %lf", estimated_rows,
+            key.c_str(), observed_rows);
+  entry->estimated_selectivity = entry->observed_selectivity;
+  PlanCache::GetInstance().Clear();
+  return true;
+}
+
+void CardinalityFeedback::Clear() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  std::vector<std::string> keys;
+  for (auto itr = cache_.begin(); itr != cache_.end(); itr++) {
+    keys.push_back((*itr)->key);
+  }
+
+  // Cache::clear() would also reset the capacity
+  for (const auto &key : keys) {
+    cache_.delete_key(key);
+  }
+}
+
+size_t CardinalityFeedback::GetCount() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return cache_.size();
+}
+
+std::string CardinalityFeedback::GetSignature(
+    const std::vector<const expression::AbstractExpression *> &conjuncts) {
+  std::vector<std::string> signatures;
+  for (auto conjunct : conjuncts) {
+    signatures.push_back(GetExpressionSignature(conjunct));
+  }
+  std::sort(signatures.begin(), signatures.end());
+
+  std::string signature;
+  for (const auto &conjunct_signature : signatures) {
+    if (signature.empty() == false) {
+      signature += " AND ";
+    }
+    signature += conjunct_signature;
+  }
+  return signature;
+}
+
+std::string CardinalityFeedback::GetKey(
+    oid_t table_id,
+    const std::vector<const expression::AbstractExpression *> &conjuncts) {
+  return std::to_string(table_id) + ":" + GetSignature(conjuncts);
+}
+
+std::string CardinalityFeedback::GetExpressionSignature(
+    const expression::AbstractExpression *expr) {
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::VALUE_TUPLE: {
+      // Columns are named by their ids, which do not depend on the alias
+      auto tuple_value =
+          static_cast<const expression::TupleValueExpression *>(expr);
+      if (tuple_value->GetIsBound()) {
+        return "#" + std::to_string(std::get<2>(tuple_value->GetBoundOid()));
+      }
+      return tuple_value->GetColumnName();
+    }
+    case ExpressionType::VALUE_CONSTANT:
+      return static_cast<const expression::ConstantValueExpression *>(expr)
+          ->GetValue()
+          .ToString();
+    case ExpressionType::VALUE_PARAMETER: {
+      auto parameter =
+          static_cast<const expression::ParameterValueExpression *>(expr);
+      return "$" + std::to_string(parameter->GetValueIdx());
+    }
+    default:
+      break;
+  }
+
+  std::string signature = ExpressionTypeToString(expr->GetExpressionType());
+  signature += "(";
+  for (size_t child_idx = 0; child_idx < expr->GetChildrenSize();
+       child_idx++) {
+    if (child_idx > 0) {
+      signature += ",";
+    }
+    signature += GetExpressionSignature(expr->GetChild(child_idx));
+  }
+  return signature + ")";
+}
+
+}  // namespace optimizer
+}  // namespace peloton
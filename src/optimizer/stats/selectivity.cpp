@@ -65,12 +65,23 @@ double Selectivity::LessThan(const std::shared_ptr<TableStats> &table_stats,
     return DEFAULT_SELECTIVITY;
   }
   // Use histogram to estimate selectivity
-  std::vector<double> histogram = column_stats->histogram_bounds;
+  const std::vector<double> &histogram = column_stats->histogram_bounds;
   size_t n = histogram.size();
-  PL_ASSERT(n > 0);
+  if (n == 0) {
+    return DEFAULT_SELECTIVITY;
+  }
   // find correspond bin using binary serach
   auto it = std::lower_bound(histogram.begin(), histogram.end(), v);
-  double res = (it - histogram.begin()) * 1.0 / n;
+  size_t idx = it - histogram.begin();
+  double res = idx * 1.0 / n;
+
+  // The values are spread evenly between the bounds of a bin, so only the
+  // part of the bin below the value counts
+  if (idx > 0 && idx < n && histogram[idx] > histogram[idx - 1]) {
+    double fraction =
+        (v - histogram[idx - 1]) / (histogram[idx] - histogram[idx - 1]);
+    res = (idx - 1 + fraction) / n;
+  }
   PL_ASSERT(res >= 0);
   PL_ASSERT(res <= 1);
   return res;
@@ -81,11 +92,20 @@ double Selectivity::Equal(const std::shared_ptr<TableStats> &table_stats,
   double value = StatsUtil::PelotonValueToNumericValue(condition.value);
   auto column_stats = table_stats->GetColumnStats(condition.column_id);
 
-  if (std::isnan(value) || column_stats == nullptr) {
+  if (column_stats == nullptr) {
     LOG_DEBUG("Calculate selectivity: return null");
     return DEFAULT_SELECTIVITY;
   }
 
+  // A value that is not known or not numeric matches one of the distinct
+  // values of the column
+  if (std::isnan(value)) {
+    if (column_stats->cardinality < 1) {
+      return DEFAULT_SELECTIVITY;
+    }
+    return (1 - column_stats->frac_null) / column_stats->cardinality;
+  }
+
   size_t numrows = column_stats->num_rows;
   // For now only double is supported in stats storage
   std::vector<double> most_common_vals = column_stats->most_common_vals;
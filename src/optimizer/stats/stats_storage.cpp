@@ -12,8 +12,11 @@
 
 #include "optimizer/stats/stats_storage.h"
 
+#include <algorithm>
+
 #include "catalog/catalog.h"
 #include "catalog/column_stats_catalog.h"
+#include "configuration/configuration.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "optimizer/stats/column_stats.h"
 #include "optimizer/stats/table_stats.h"
@@ -61,12 +64,16 @@ void StatsStorage::InsertOrUpdateTableStats(
   oid_t database_id = table->GetDatabaseOid();
   oid_t table_id = table->GetOid();
   size_t num_rows = table_stats_collector->GetActiveTupleCount();
+  double sample_ratio = table_stats_collector->GetSampleRatio();
 
   oid_t column_count = table_stats_collector->GetColumnCount();
   for (oid_t column_id = 0; column_id < column_count; column_id++) {
     ColumnStatsCollector *column_stats_collector =
         table_stats_collector->GetColumnStats(column_id);
     double cardinality = column_stats_collector->GetCardinality();
+    if (sample_ratio > 1) {
+      cardinality = ScaleSampleCardinality(cardinality, num_rows, sample_ratio);
+    }
     double frac_null = column_stats_collector->GetFracNull();
     // Currently, we only store the most common <value, frequency> pairs for
     // numeric values.
@@ -75,6 +82,9 @@ void StatsStorage::InsertOrUpdateTableStats(
     // TODO: Store common <value, freq> pairs for VARCHAR.
     std::vector<ValueFrequencyPair> most_common_val_freqs =
         column_stats_collector->GetCommonValueAndFrequency();
+    for (auto &val_freq : most_common_val_freqs) {
+      val_freq.second *= sample_ratio;
+    }
     std::vector<double> histogram_bounds =
         column_stats_collector->GetHistogramBound();
 
@@ -286,15 +296,56 @@ ResultType StatsStorage::AnalyzeStatsForAllTables(
     for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
       auto table = database->GetTable(table_offset);
       LOG_TRACE("Analyzing table: %s", table->GetName().c_str());
-      std::unique_ptr<TableStatsCollector> table_stats_collector(
-          new TableStatsCollector(table));
-      table_stats_collector->CollectColumnStats();
-      InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
+      AnalyzeStatsForTable(table, txn);
     }
   }
   return ResultType::SUCCESS;
 }
 
+/**
+ * AnalyzeStatsForStaleTables - This function analyzes the tables that had
+ * enough of their tuples modified since they were last analyzed.
+ */
+ResultType StatsStorage::AnalyzeStatsForStaleTables(
+    concurrency::Transaction *txn) {
+  if (FLAGS_auto_analyze_threshold == 0) {
+    return ResultType::NOOP;
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  bool single_statement_txn = false;
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_count = storage_manager->GetDatabaseCount();
+  for (oid_t db_offset = 0; db_offset < database_count; db_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(db_offset);
+    if (database->GetDBName().compare(CATALOG_DATABASE_NAME) == 0) {
+      continue;
+    }
+    oid_t table_count = database->GetTableCount();
+    for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
+      auto table = database->GetTable(table_offset);
+      double threshold = FLAGS_auto_analyze_threshold +
+                         FLAGS_auto_analyze_scale_factor *
+                             table->GetTupleCount();
+      if (table->GetModifiedTupleCount() < threshold) {
+        continue;
+      }
+
+      LOG_TRACE("Analyzing stale table: %s", table->GetName().c_str());
+      if (txn == nullptr) {
+        single_statement_txn = true;
+        txn = txn_manager.BeginTransaction();
+      }
+      AnalyzeStatsForTable(table, txn);
+    }
+  }
+
+  if (single_statement_txn) {
+    txn_manager.CommitTransaction(txn);
+  }
+  return ResultType::SUCCESS;
+}
+
 /**
  * AnalyzeStatsForTable - This function analyzes the stats for one table and
  * sotre the stats in column_stats_catalog.
@@ -306,13 +357,31 @@ ResultType StatsStorage::AnalyzeStatsForTable(storage::DataTable *table,
               table->GetName().c_str());
     return ResultType::FAILURE;
   }
+  // The modifications made while the table is analyzed count towards the
+  // next time
+  table->ResetModifiedTupleCount();
   std::unique_ptr<TableStatsCollector> table_stats_collector(
       new TableStatsCollector(table));
-  table_stats_collector->CollectColumnStats();
+  table_stats_collector->CollectColumnStats(FLAGS_analyze_sample_size);
   InsertOrUpdateTableStats(table, table_stats_collector.get(), txn);
   return ResultType::SUCCESS;
 }
 
+/**
+ * ScaleSampleCardinality - The distinct values of a sample undercount those
+ * of the table unless most of the sampled values were distinct. The more of
+ * the sample is distinct, the more of the rest of the table is assumed to be.
+ */
+double StatsStorage::ScaleSampleCardinality(double sample_cardinality,
+                                            size_t num_rows,
+                                            double sample_ratio) {
+  double sample_count = num_rows / sample_ratio;
+  double distinct_fraction = std::min(1.0, sample_cardinality / sample_count);
+  return std::min<double>(
+      num_rows,
+      sample_cardinality * (1 + distinct_fraction * (sample_ratio - 1)));
+}
+
 // TODO: Implement it.
 ResultType StatsStorage::AnalayzeStatsForColumns(
     UNUSED_ATTRIBUTE storage::DataTable *table,
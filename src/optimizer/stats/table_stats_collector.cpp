@@ -12,11 +12,14 @@
 
 #include "optimizer/stats/table_stats_collector.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "common/macros.h"
+#include "optimizer/stats/tuple_sampler.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
+#include "storage/tuple.h"
 #include "type/types.h"
 #include "type/value.h"
 
@@ -27,11 +30,12 @@ TableStatsCollector::TableStatsCollector(storage::DataTable *table)
     : table_(table),
       column_stats_collectors_{},
       active_tuple_count_{0},
-      column_count_{0} {}
+      column_count_{0},
+      sample_ratio_{1} {}
 
 TableStatsCollector::~TableStatsCollector() {}
 
-void TableStatsCollector::CollectColumnStats() {
+void TableStatsCollector::CollectColumnStats(size_t max_sample_count) {
   schema_ = table_->GetSchema();
   column_count_ = schema_->GetColumnCount();
 
@@ -42,11 +46,20 @@ void TableStatsCollector::CollectColumnStats() {
 
   InitColumnStatsCollectors();
 
+  if (max_sample_count > 0 && table_->GetTupleCount() > max_sample_count) {
+    CollectSampleColumnStats(max_sample_count);
+    return;
+  }
+
   size_t tile_group_count = table_->GetTileGroupCount();
   // Collect stats for all tile groups.
   for (size_t offset = 0; offset < tile_group_count; offset++) {
     std::shared_ptr<storage::TileGroup> tile_group =
         table_->GetTileGroup(offset);
+    // skip tile groups dropped by the compactor
+    if (tile_group == nullptr) {
+      continue;
+    }
     storage::TileGroupHeader *tile_group_header = tile_group->GetHeader();
     oid_t tuple_count = tile_group->GetAllocatedTupleCount();
     active_tuple_count_ += tile_group_header->GetActiveTupleCount();
@@ -64,6 +77,31 @@ void TableStatsCollector::CollectColumnStats() {
   }   /* tile group */
 }
 
+void TableStatsCollector::CollectSampleColumnStats(size_t sample_count) {
+  // Only the headers of the tile groups are read to count the tuples
+  size_t tile_group_count = table_->GetTileGroupCount();
+  for (size_t offset = 0; offset < tile_group_count; offset++) {
+    std::shared_ptr<storage::TileGroup> tile_group =
+        table_->GetTileGroup(offset);
+    if (tile_group != nullptr) {
+      active_tuple_count_ += tile_group->GetHeader()->GetActiveTupleCount();
+    }
+  }
+
+  TupleSampler sampler(table_);
+  size_t sampled_count = sampler.AcquireSampleTuples(sample_count);
+  if (sampled_count == 0) {
+    return;
+  }
+  for (auto &tuple : sampler.GetSampledTuples()) {
+    for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+      column_stats_collectors_[column_id]->AddValue(tuple->GetValue(column_id));
+    }
+  }
+  sample_ratio_ =
+      std::max(1.0, static_cast<double>(active_tuple_count_) / sampled_count);
+}
+
 void TableStatsCollector::InitColumnStatsCollectors() {
   oid_t database_id = table_->GetDatabaseOid();
   oid_t table_id = table_->GetOid();
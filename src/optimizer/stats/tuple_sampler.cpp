@@ -40,11 +40,19 @@ size_t TupleSampler::AcquireSampleTuples(size_t target_sample_count) {
   srand(time(NULL));
   catalog::Schema *tuple_schema = table->GetSchema();
 
-  while (sampled_tuples.size() < target_sample_count) {
+  // The tuple count includes versions that are no longer valid, so give up
+  // once most of the offsets tried were empty
+  size_t max_attempt_count = 4 * target_sample_count;
+  size_t attempt_count = 0;
+  while (sampled_tuples.size() < target_sample_count &&
+         attempt_count++ < max_attempt_count) {
     // Generate a random tilegroup offset
     rand_tilegroup_offset = rand() % tile_group_count;
     storage::TileGroup *tile_group =
         table->GetTileGroup(rand_tilegroup_offset).get();
+    if (tile_group == nullptr) {
+      continue;
+    }
     oid_t tuple_per_group = tile_group->GetActiveTupleCount();
     LOG_TRACE("tile_group: offset: %lu, addr: %p, tuple_per_group: %u",
               rand_tilegroup_offset, tile_group, tuple_per_group);
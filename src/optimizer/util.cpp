@@ -14,6 +14,9 @@
 
 #include "catalog/query_metrics_catalog.h"
 #include "expression/expression_util.h"
+#include "expression/tuple_value_expression.h"
+#include "index/index.h"
+#include "optimizer/properties.h"
 #include "planner/copy_plan.h"
 #include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
@@ -56,14 +59,50 @@ bool CheckIndexSearchable(storage::DataTable* target_table,
       // Loop through the indexes to find to most proper one (if any)
       int max_columns = 0;
       int index_index = 0;
+      bool is_hash_index_chosen = false;
       for (auto& column_set : target_table->GetIndexColumns()) {
         int matched_columns = 0;
-        for (auto column_id : predicate_column_ids)
-          if (column_set.find(column_id) != column_set.end()) matched_columns++;
-        if (matched_columns > max_columns) {
+        std::set<oid_t> equal_columns;
+        for (size_t predicate_itr = 0;
+             predicate_itr < predicate_column_ids.size(); predicate_itr++) {
+          auto column_id = predicate_column_ids[predicate_itr];
+          if (column_set.find(column_id) != column_set.end()) {
+            matched_columns++;
+            if (predicate_expr_types[predicate_itr] ==
+                ExpressionType::COMPARE_EQUAL) {
+              equal_columns.insert(column_id);
+            }
+          }
+        }
+
+        // A hash index only answers point queries, i.e. equality predicates
+        // on all of its columns, and it wins the ties as it does them in a
+        // single lookup
+        auto index = target_table->GetIndex(index_index);
+
+        // A partial index only holds the tuples that the query may return if
+        // the query predicate implies the index predicate
+        if (index != nullptr && index->GetMetadata()->HasPredicate() == true &&
+            PredicateImplies(target_table->GetSchema(), expression,
+                             index->GetMetadata()->GetPredicate()) == false) {
+          index_index++;
+          continue;
+        }
+
+        bool is_hash_index =
+            index != nullptr && index->GetIndexMethodType() == IndexType::HASH;
+        if (is_hash_index == true && equal_columns.size() != column_set.size()) {
+          index_index++;
+          continue;
+        }
+
+        if (matched_columns > max_columns ||
+            (matched_columns == max_columns && matched_columns > 0 &&
+             is_hash_index == true && is_hash_index_chosen == false)) {
           index_searchable = true;
           index_id = index_index;
           max_columns = matched_columns;
+          is_hash_index_chosen = is_hash_index;
         }
         index_index++;
       }
@@ -104,6 +143,156 @@ bool CheckIndexSearchable(storage::DataTable* target_table,
   return true;
 }
 
+// Collect the terms of a conjunction
+static void GetConjunctionTerms(
+    const expression::AbstractExpression* expr,
+    std::vector<const expression::AbstractExpression*>& terms) {
+  if (expr->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    for (size_t i = 0; i < expr->GetChildrenSize(); i++) {
+      GetConjunctionTerms(expr->GetChild(i), terms);
+    }
+    return;
+  }
+  terms.push_back(expr);
+}
+
+// Decompose a comparison of a column with a constant. The comparison is
+// mirrored if the constant is on the left.
+static bool GetColumnComparison(const catalog::Schema* schema,
+                                const expression::AbstractExpression* expr,
+                                oid_t& column_id, ExpressionType& expr_type,
+                                type::Value& value) {
+  expr_type = expr->GetExpressionType();
+  if (expr->GetChildrenSize() != 2) {
+    return false;
+  }
+
+  auto column_expr = expr->GetChild(0);
+  auto constant_expr = expr->GetChild(1);
+  if (column_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+    std::swap(column_expr, constant_expr);
+    switch (expr_type) {
+      case ExpressionType::COMPARE_LESSTHAN:
+        expr_type = ExpressionType::COMPARE_GREATERTHAN;
+        break;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        expr_type = ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        expr_type = ExpressionType::COMPARE_LESSTHAN;
+        break;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        expr_type = ExpressionType::COMPARE_LESSTHANOREQUALTO;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (column_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+      constant_expr->GetExpressionType() != ExpressionType::VALUE_CONSTANT) {
+    return false;
+  }
+
+  switch (expr_type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return false;
+  }
+
+  auto tuple_expr =
+      static_cast<const expression::TupleValueExpression*>(column_expr);
+  column_id = schema->GetColumnID(tuple_expr->GetColumnName());
+  value = static_cast<const expression::ConstantValueExpression*>(
+              constant_expr)->GetValue();
+  return column_id != INVALID_OID;
+}
+
+// Whether "value expr_type constant" holds
+static bool CompareValues(const type::Value& value, ExpressionType expr_type,
+                          const type::Value& constant) {
+  switch (expr_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return value.CompareEquals(constant) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return value.CompareNotEquals(constant) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHAN:
+      return value.CompareLessThan(constant) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return value.CompareLessThanEquals(constant) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return value.CompareGreaterThan(constant) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return value.CompareGreaterThanEquals(constant) == type::CMP_TRUE;
+    default:
+      return false;
+  }
+}
+
+/**
+ * This function checks whether every tuple that satisfies the predicate also
+ * satisfies the index predicate. Each term of the index predicate must be
+ * a column compared with a constant, and the predicate must have the same
+ * term, or an equality on the column whose constant satisfies the term.
+ */
+bool PredicateImplies(const catalog::Schema* schema,
+                      const expression::AbstractExpression* predicate,
+                      const expression::AbstractExpression* index_predicate) {
+  if (index_predicate == nullptr) {
+    return true;
+  }
+  if (predicate == nullptr) {
+    return false;
+  }
+
+  std::vector<const expression::AbstractExpression*> terms;
+  std::vector<const expression::AbstractExpression*> index_terms;
+  GetConjunctionTerms(predicate, terms);
+  GetConjunctionTerms(index_predicate, index_terms);
+
+  for (auto index_term : index_terms) {
+    oid_t index_column_id;
+    ExpressionType index_expr_type;
+    type::Value index_value;
+    if (GetColumnComparison(schema, index_term, index_column_id,
+                            index_expr_type, index_value) == false) {
+      return false;
+    }
+
+    bool implied = false;
+    for (auto term : terms) {
+      oid_t column_id;
+      ExpressionType expr_type;
+      type::Value value;
+      if (GetColumnComparison(schema, term, column_id, expr_type, value) ==
+              false ||
+          column_id != index_column_id) {
+        continue;
+      }
+
+      if ((expr_type == index_expr_type &&
+           value.CompareEquals(index_value) == type::CMP_TRUE) ||
+          (expr_type == ExpressionType::COMPARE_EQUAL &&
+           CompareValues(value, index_expr_type, index_value) == true)) {
+        implied = true;
+        break;
+      }
+    }
+
+    if (implied == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /**
  * This function replaces all COLUMN_REF expressions with TupleValue
  * expressions
@@ -232,6 +421,42 @@ expression::AbstractExpression* ConstructJoinPredicate(
   return CombinePredicates(qualified_exprs);
 }
 
+/**
+ * Split the predicate of a join into the conjuncts that only reference the
+ * tables of the left or the right child and the ones left for the join.
+ * Conjuncts without any table, e.g. constant ones, stay at the join.
+ */
+void SplitJoinPredicate(
+    expression::AbstractExpression* predicate,
+    const std::unordered_set<std::string>& l_group_alias,
+    const std::unordered_set<std::string>& r_group_alias,
+    expression::AbstractExpression*& l_predicate,
+    expression::AbstractExpression*& r_predicate,
+    expression::AbstractExpression*& join_predicate) {
+  std::vector<expression::AbstractExpression*> conjuncts;
+  std::vector<expression::AbstractExpression*> l_conjuncts;
+  std::vector<expression::AbstractExpression*> r_conjuncts;
+  std::vector<expression::AbstractExpression*> join_conjuncts;
+  if (predicate != nullptr) SplitPredicates(predicate, conjuncts);
+
+  for (auto conjunct : conjuncts) {
+    std::unordered_set<std::string> table_alias_set;
+    expression::ExpressionUtil::GenerateTableAliasSet(conjunct,
+                                                      table_alias_set);
+    if (table_alias_set.empty())
+      join_conjuncts.push_back(conjunct->Copy());
+    else if (IsSubset(l_group_alias, table_alias_set))
+      l_conjuncts.push_back(conjunct->Copy());
+    else if (IsSubset(r_group_alias, table_alias_set))
+      r_conjuncts.push_back(conjunct->Copy());
+    else
+      join_conjuncts.push_back(conjunct->Copy());
+  }
+  l_predicate = CombinePredicates(l_conjuncts);
+  r_predicate = CombinePredicates(r_conjuncts);
+  join_predicate = CombinePredicates(join_conjuncts);
+}
+
 /**
  * Split conjunction expression tree into a vector of expressions with AND
  */
@@ -312,9 +537,156 @@ bool ContainsJoinColumns(
   return false;
 }
 
+void GetJoinColumns(const std::string& table_alias,
+                    const std::unordered_set<std::string>& other_alias,
+                    const expression::AbstractExpression* expr,
+                    std::vector<oid_t>& column_ids) {
+  if (expr == nullptr) return;
+  if (expr->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    GetJoinColumns(table_alias, other_alias, expr->GetChild(0), column_ids);
+    GetJoinColumns(table_alias, other_alias, expr->GetChild(1), column_ids);
+  } else if (expr->GetExpressionType() == ExpressionType::COMPARE_EQUAL) {
+    auto l_expr = expr->GetChild(0);
+    auto r_expr = expr->GetChild(1);
+    if (l_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+        r_expr->GetExpressionType() != ExpressionType::VALUE_TUPLE)
+      return;
+
+    auto l_tuple_expr =
+        reinterpret_cast<const expression::TupleValueExpression*>(l_expr);
+    auto r_tuple_expr =
+        reinterpret_cast<const expression::TupleValueExpression*>(r_expr);
+    if (l_tuple_expr->GetTableName() == table_alias &&
+        other_alias.count(r_tuple_expr->GetTableName()))
+      column_ids.push_back(std::get<2>(l_tuple_expr->GetBoundOid()));
+    else if (r_tuple_expr->GetTableName() == table_alias &&
+             other_alias.count(l_tuple_expr->GetTableName()))
+      column_ids.push_back(std::get<2>(r_tuple_expr->GetBoundOid()));
+  }
+}
+
+size_t GetJoinIndex(storage::DataTable* table,
+                    const std::vector<oid_t>& column_ids, oid_t& index_id) {
+  size_t max_key_count = 0;
+  bool is_hash_index_chosen = false;
+  for (oid_t index_offset = 0; index_offset < table->GetIndexCount();
+       index_offset++) {
+    // An index that is still built lacks keys, and a partial one tuples
+    auto index = table->GetIndex(index_offset);
+    if (index == nullptr || index->GetMetadata()->IsBuilding() == true ||
+        index->GetMetadata()->HasPredicate() == true)
+      continue;
+
+    const std::vector<oid_t>& key_attrs = index->GetMetadata()->GetKeyAttrs();
+    size_t key_count = 0;
+    while (key_count < key_attrs.size() &&
+           std::find(column_ids.begin(), column_ids.end(),
+                     key_attrs[key_count]) != column_ids.end())
+      key_count++;
+
+    // A hash index only answers point queries, and it wins the ties as it
+    // does them in a single lookup
+    bool is_hash_index = index->GetIndexMethodType() == IndexType::HASH;
+    if (is_hash_index == true && key_count != key_attrs.size()) continue;
+
+    if (key_count > max_key_count ||
+        (key_count == max_key_count && key_count > 0 &&
+         is_hash_index == true && is_hash_index_chosen == false)) {
+      max_key_count = key_count;
+      index_id = index_offset;
+      is_hash_index_chosen = is_hash_index;
+    }
+  }
+  return max_key_count;
+}
+
+bool GetOrderedIndex(storage::DataTable* table, oid_t column_id,
+                     oid_t& index_id) {
+  for (oid_t index_offset = 0; index_offset < table->GetIndexCount();
+       index_offset++) {
+    auto index = table->GetIndex(index_offset);
+    if (index == nullptr || index->GetMetadata()->IsBuilding() == true ||
+        index->GetMetadata()->HasPredicate() == true ||
+        index->GetIndexMethodType() == IndexType::HASH)
+      continue;
+
+    if (index->GetMetadata()->GetKeyAttrs()[0] == column_id) {
+      index_id = index_offset;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool GetSortIndex(storage::DataTable* table, const std::string& alias,
+                  const PropertySort* sort_prop, oid_t& index_id,
+                  bool& descending) {
+  std::vector<oid_t> sort_column_ids;
+  descending = sort_prop->GetSortColumnSize() > 0 &&
+               sort_prop->GetSortAscending(0) == false;
+  for (size_t col_idx = 0; col_idx < sort_prop->GetSortColumnSize();
+       col_idx++) {
+    auto expr = sort_prop->GetSortColumn(col_idx);
+    if (sort_prop->GetSortAscending(col_idx) == descending ||
+        expr->GetExpressionType() != ExpressionType::VALUE_TUPLE)
+      return false;
+    auto tv_expr =
+        static_cast<const expression::TupleValueExpression*>(expr.get());
+    if (tv_expr->GetIsBound() == false || tv_expr->GetTableName() != alias ||
+        std::get<1>(tv_expr->GetBoundOid()) != table->GetOid())
+      return false;
+    sort_column_ids.push_back(std::get<2>(tv_expr->GetBoundOid()));
+  }
+  if (sort_column_ids.empty()) return false;
+
+  for (oid_t index_offset = 0; index_offset < table->GetIndexCount();
+       index_offset++) {
+    auto index = table->GetIndex(index_offset);
+    if (index == nullptr || index->GetMetadata()->IsBuilding() == true ||
+        index->GetMetadata()->HasPredicate() == true ||
+        index->GetIndexMethodType() == IndexType::HASH)
+      continue;
+
+    auto& key_attrs = index->GetMetadata()->GetKeyAttrs();
+    if (key_attrs.size() >= sort_column_ids.size() &&
+        std::equal(sort_column_ids.begin(), sort_column_ids.end(),
+                   key_attrs.begin())) {
+      index_id = index_offset;
+      return true;
+    }
+  }
+  return false;
+}
+
 std::unique_ptr<planner::AbstractPlan> CreateCopyPlan(
     parser::CopyStatement* copy_stmt) {
   std::string table_name(copy_stmt->cpy_table->GetTableName());
+
+  if (copy_stmt->type == CopyType::IMPORT_CSV) {
+    if (copy_stmt->file_path == nullptr) {
+      // The PacketManager loads the CopyData of the client itself
+      throw NotImplementedException(
+          "COPY FROM STDIN is only supported over the wire protocol");
+    }
+    auto target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+        copy_stmt->cpy_table->GetDatabaseName(), table_name);
+    return std::unique_ptr<planner::AbstractPlan>(new planner::CopyPlan(
+        copy_stmt->file_path, target_table, copy_stmt->delimiter));
+  }
+  // COPY TO STDOUT returns the rows of the table like a SELECT *, which the
+  // PacketManager sends as CopyData
+  if (copy_stmt->file_path == nullptr) {
+    auto target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+        copy_stmt->cpy_table->GetDatabaseName(), table_name);
+    std::vector<oid_t> column_ids;
+    for (oid_t column_id = 0;
+         column_id < target_table->GetSchema()->GetColumnCount(); column_id++) {
+      column_ids.push_back(column_id);
+    }
+    return std::unique_ptr<planner::AbstractPlan>(
+        new planner::SeqScanPlan(target_table, nullptr, column_ids, false));
+  }
+
   bool deserialize_parameters = false;
 
   // If we're copying the query metric table, then we need to handle the
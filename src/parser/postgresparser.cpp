@@ -10,12 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <include/parser/pg_list.h>
 #include <include/parser/pg_query.h>
 
+#include "common/arena_node.h"
 #include "common/exception.h"
 #include "expression/aggregate_expression.h"
 #include "expression/case_expression.h"
@@ -31,10 +35,19 @@
 #include "parser/postgresparser.h"
 #include "type/types.h"
 #include "type/value_factory.h"
+#include "util/string_util.h"
 
 namespace peloton {
 namespace parser {
 
+namespace {
+
+// The chunks of the arena a statement is parsed into. Most statements fit in
+// one.
+const size_t kParseArenaChunkSize = 4 * 1024;
+
+}  // namespace
+
 PostgresParser::PostgresParser() {}
 
 PostgresParser::~PostgresParser() {}
@@ -939,6 +952,57 @@ parser::SQLStatement* PostgresParser::CreateTransform(CreateStmt* root) {
     }
   }
 
+  // Table options of the WITH clause
+  if (root->options != nullptr) {
+    for (auto cell = root->options->head; cell != nullptr; cell = cell->next) {
+      auto def_elem = reinterpret_cast<DefElem*>(cell->data.ptr_value);
+      if (strcmp(def_elem->defname, "append_only") == 0) {
+        result->append_only = BoolOptionTransform(def_elem);
+      } else if (strcmp(def_elem->defname, "partition_column") == 0) {
+        result->partition_column = OptionValueTransform(def_elem);
+      } else if (strcmp(def_elem->defname, "hash_partitions") == 0) {
+        auto option_value = OptionValueTransform(def_elem);
+        if (option_value.empty() == false &&
+            std::all_of(option_value.begin(), option_value.end(), ::isdigit)) {
+          result->hash_partition_count = std::stoul(option_value);
+        }
+        if (result->hash_partition_count == 0) {
+          delete result;
+          throw NotImplementedException(
+              "Option hash_partitions requires a positive integer");
+        }
+      } else if (strcmp(def_elem->defname, "range_partitions") == 0) {
+        for (auto &bound :
+             StringUtil::Split(OptionValueTransform(def_elem), ",")) {
+          auto first = bound.find_first_not_of(' ');
+          if (first == std::string::npos) {
+            delete result;
+            throw NotImplementedException(
+                "Option range_partitions requires non-empty bounds");
+          }
+          auto last = bound.find_last_not_of(' ');
+          result->range_partition_bounds.push_back(
+              bound.substr(first, last - first + 1));
+        }
+      } else {
+        std::string option_name(def_elem->defname);
+        delete result;
+        throw NotImplementedException(StringUtil::Format(
+            "Table option %s not supported yet", option_name.c_str()));
+      }
+    }
+    // a partitioned table needs its column and exactly one kind of partition
+    bool has_hash = result->hash_partition_count > 0;
+    bool has_range = result->range_partition_bounds.empty() == false;
+    if ((has_hash || has_range || result->partition_column.empty() == false) &&
+        (has_hash == has_range || result->partition_column.empty() == true)) {
+      delete result;
+      throw NotImplementedException(
+          "Option partition_column requires one of hash_partitions or "
+          "range_partitions");
+    }
+  }
+
   return reinterpret_cast<parser::SQLStatement*>(result);
 }
 
@@ -956,10 +1020,19 @@ parser::SQLStatement* PostgresParser::CreateIndexTransform(IndexStmt* root) {
     char* index_attr = reinterpret_cast<IndexElem*>(cell->data.ptr_value)->name;
     result->index_attrs->push_back(cstrdup(index_attr));
   }
-  result->index_type = IndexType::BWTREE;
+  // USING HASH builds a hash index, any other method a BwTree
+  if (root->accessMethod != nullptr &&
+      StringUtil::Lower(root->accessMethod) == "hash") {
+    result->index_type = IndexType::HASH;
+  } else {
+    result->index_type = IndexType::BWTREE;
+  }
   result->table_info_ = new TableInfo();
   result->table_info_->table_name = cstrdup(root->relation->relname);
   result->index_name = cstrdup(root->idxname);
+  if (root->whereClause != nullptr) {
+    result->index_predicate = WhereTransform(root->whereClause);
+  }
   return result;
 }
 
@@ -974,8 +1047,31 @@ parser::SQLStatement* PostgresParser::CreateDbTransform(CreatedbStmt* root) {
   return result;
 }
 
+// This function takes in a Postgres CreateTableAsStmt parsenode of a
+// CREATE MATERIALIZED VIEW and transfers into a Peloton CreateStatement
+// parsenode. Please refer to parser/parsenode.h for the definition of
+// CreateTableAsStmt parsenodes.
+parser::SQLStatement* PostgresParser::CreateViewTransform(
+    CreateTableAsStmt* root) {
+  if (root->relkind != OBJECT_MATVIEW ||
+      root->query->type != T_SelectStmt) {
+    throw NotImplementedException(
+        "Only CREATE MATERIALIZED VIEW ... AS SELECT is supported...\n");
+  }
+  parser::CreateStatement* result =
+      new parser::CreateStatement(CreateStatement::kMaterializedView);
+  result->if_not_exists = root->if_not_exists;
+  result->table_info_ = new TableInfo();
+  result->table_info_->table_name = cstrdup(root->into->rel->relname);
+  result->view_query = reinterpret_cast<parser::SelectStatement*>(
+      SelectTransform(reinterpret_cast<SelectStmt*>(root->query)));
+  return result;
+}
+
 parser::DropStatement* PostgresParser::DropTransform(DropStmt* root) {
-  auto res = new DropStatement(DropStatement::EntityType::kTable);
+  auto res = new DropStatement(root->removeType == OBJECT_MATVIEW
+                                   ? DropStatement::EntityType::kView
+                                   : DropStatement::EntityType::kTable);
   for (auto cell = root->objects->head; cell != nullptr; cell = cell->next) {
     res->missing = root->missing_ok;
     auto table_info = new TableInfo{};
@@ -1018,9 +1114,12 @@ parser::PrepareStatement* PostgresParser::PrepareTransform(PrepareStmt* root) {
 
 // TODO: Only support COPY TABLE TO FILE and DELIMITER option
 parser::CopyStatement* PostgresParser::CopyTransform(CopyStmt* root) {
-  auto res = new CopyStatement(peloton::CopyType::EXPORT_OTHER);
+  auto res = new CopyStatement(root->is_from ? peloton::CopyType::IMPORT_CSV
+                                             : peloton::CopyType::EXPORT_OTHER);
   res->cpy_table = RangeVarTransform(root->relation);
-  res->file_path = cstrdup(root->filename);
+  if (root->filename != nullptr) {
+    res->file_path = cstrdup(root->filename);
+  }
   for (auto cell = root->options->head; cell != NULL; cell = cell->next) {
     auto def_elem = reinterpret_cast<DefElem*>(cell->data.ptr_value);
     if (strcmp(def_elem->defname, "delimiter") == 0) {
@@ -1046,6 +1145,24 @@ parser::AnalyzeStatement* PostgresParser::VacuumTransform(VacuumStmt* root) {
   return res;
 }
 
+// Only the ANALYZE option is supported, e.g. EXPLAIN (ANALYZE off) x
+parser::ExplainStatement* PostgresParser::ExplainTransform(ExplainStmt* root) {
+  auto res = new ExplainStatement();
+  res->real_sql_stmt.reset(NodeTransform(root->query));
+  if (root->options != nullptr) {
+    for (auto cell = root->options->head; cell != NULL; cell = cell->next) {
+      auto def_elem = reinterpret_cast<DefElem*>(cell->data.ptr_value);
+      if (strcmp(def_elem->defname, "analyze") == 0) {
+        auto arg = reinterpret_cast<value*>(def_elem->arg);
+        res->analyze = arg == nullptr || arg->type != T_String ||
+                       (strcmp(arg->val.str, "false") != 0 &&
+                        strcmp(arg->val.str, "off") != 0);
+      }
+    }
+  }
+  return res;
+}
+
 std::vector<char*>* PostgresParser::ColumnNameTransform(List* root) {
   if (root == nullptr) return nullptr;
 
@@ -1197,11 +1314,98 @@ parser::SQLStatement* PostgresParser::DeleteTransform(DeleteStmt* root) {
   return (parser::SQLStatement*)result;
 }
 
+// Transform the isolation level of BEGIN into a Peloton isolation level. As in
+// Postgres, REPEATABLE READ runs at snapshot isolation and READ UNCOMMITTED
+// at READ COMMITTED.
+IsolationLevelType PostgresParser::IsolationLevelTransform(const char* level) {
+  if (strcmp(level, "serializable") == 0) {
+    return IsolationLevelType::SERIALIZABLE;
+  } else if (strcmp(level, "repeatable read") == 0) {
+    return IsolationLevelType::SNAPSHOT;
+  } else if (strcmp(level, "read committed") == 0 ||
+             strcmp(level, "read uncommitted") == 0) {
+    return IsolationLevelType::READ_COMMITTED;
+  }
+  throw NotImplementedException(
+      StringUtil::Format("Isolation level %s not supported yet.\n", level));
+}
+
+// An option without a value is set. Otherwise its value is a keyword like
+// true or off, or a number. The grammar reads unreserved keywords like off
+// as type names.
+bool PostgresParser::BoolOptionTransform(DefElem* root) {
+  if (root->arg == nullptr) {
+    return true;
+  }
+  auto val = reinterpret_cast<value*>(root->arg);
+  if (val->type == T_TypeName) {
+    auto type_name = reinterpret_cast<TypeName*>(root->arg);
+    if (type_name->names != nullptr && type_name->names->length == 1) {
+      val = reinterpret_cast<value*>(type_name->names->head->data.ptr_value);
+    }
+  }
+  if (val->type == T_Integer) {
+    return val->val.ival != 0;
+  }
+  if (val->type == T_String) {
+    std::string option_value = StringUtil::Lower(val->val.str);
+    if (option_value == "true" || option_value == "on" ||
+        option_value == "yes") {
+      return true;
+    }
+    if (option_value == "false" || option_value == "off" ||
+        option_value == "no") {
+      return false;
+    }
+  }
+  throw NotImplementedException(StringUtil::Format(
+      "Option %s requires a boolean value", root->defname));
+}
+
+// The value of an option is a string, a number, or a name the grammar reads
+// as a type name
+std::string PostgresParser::OptionValueTransform(DefElem* root) {
+  if (root->arg == nullptr) {
+    throw NotImplementedException(
+        StringUtil::Format("Option %s requires a value", root->defname));
+  }
+  auto val = reinterpret_cast<value*>(root->arg);
+  if (val->type == T_TypeName) {
+    auto type_name = reinterpret_cast<TypeName*>(root->arg);
+    if (type_name->names != nullptr && type_name->names->length == 1) {
+      val = reinterpret_cast<value*>(type_name->names->head->data.ptr_value);
+    }
+  }
+  if (val->type == T_Integer) {
+    return std::to_string(val->val.ival);
+  }
+  if (val->type == T_String) {
+    return std::string(val->val.str);
+  }
+  throw NotImplementedException(
+      StringUtil::Format("Option %s has an invalid value", root->defname));
+}
+
 // Transform Postgres TransacStmt into Peloton TransactionStmt
 parser::TransactionStatement* PostgresParser::TransactionTransform(
     TransactionStmt* root) {
   if (root->kind == TRANS_STMT_BEGIN) {
-    return new parser::TransactionStatement(TransactionStatement::kBegin);
+    bool read_only = false;
+    IsolationLevelType isolation = IsolationLevelType::INVALID;
+    if (root->options != nullptr) {
+      for (auto cell = root->options->head; cell != NULL; cell = cell->next) {
+        auto def_elem = reinterpret_cast<DefElem*>(cell->data.ptr_value);
+        if (strcmp(def_elem->defname, "transaction_read_only") == 0) {
+          read_only =
+              (reinterpret_cast<A_Const*>(def_elem->arg)->val.val.ival != 0);
+        } else if (strcmp(def_elem->defname, "transaction_isolation") == 0) {
+          isolation = IsolationLevelTransform(
+              reinterpret_cast<A_Const*>(def_elem->arg)->val.val.str);
+        }
+      }
+    }
+    return new parser::TransactionStatement(TransactionStatement::kBegin,
+                                            read_only, isolation);
   } else if (root->kind == TRANS_STMT_COMMIT) {
     return new parser::TransactionStatement(TransactionStatement::kCommit);
   } else if (root->kind == TRANS_STMT_ROLLBACK) {
@@ -1258,9 +1462,15 @@ parser::SQLStatement* PostgresParser::NodeTransform(Node* stmt) {
     case T_CreatedbStmt:
       result = CreateDbTransform((CreatedbStmt*)stmt);
       break;
+    case T_CreateTableAsStmt:
+      result = CreateViewTransform((CreateTableAsStmt*)stmt);
+      break;
     case T_VacuumStmt:
       result = VacuumTransform((VacuumStmt*)stmt);
       break;
+    case T_ExplainStmt:
+      result = ExplainTransform((ExplainStmt*)stmt);
+      break;
     default: {
       throw NotImplementedException(StringUtil::Format(
           "Statement of type %d not supported yet...\n", stmt->type));
@@ -1336,14 +1546,23 @@ parser::SQLStatementList* PostgresParser::ParseSQLString(const char* text) {
 
   // DEBUG only. Comment this out in release mode
   // print_pg_parse_tree(result.tree);
+
+  // The statements and their expressions are carved from one arena and
+  // freed with it, instead of one by one
+  std::unique_ptr<type::ArenaPool> arena(
+      new type::ArenaPool(kParseArenaChunkSize));
   parser::SQLStatementList* transform_result;
   try {
+    ArenaNodeScope arena_scope(arena.get());
     transform_result = ListTransform(result.tree);
   } catch (Exception &e) {
     pg_query_parse_finish(ctx);
     pg_query_free_parse_result(result);
     throw e;
   }
+  if (transform_result != nullptr) {
+    transform_result->arena = std::move(arena);
+  }
 
   pg_query_parse_finish(ctx);
   pg_query_free_parse_result(result);
@@ -1370,5 +1589,182 @@ std::unique_ptr<parser::SQLStatementList> PostgresParser::BuildParseTree(
   return sql_stmt;
 }
 
+bool PostgresParser::ParameterizeLiterals(
+    const std::string& query, std::string& parameterized_query,
+    std::vector<type::Value>& params) {
+  // The numbers of the parameters of the query would clash with the new ones
+  if (query.find('$') != std::string::npos) {
+    return false;
+  }
+
+  auto ctx = pg_query_parse_init();
+  auto result = pg_query_parse(query.c_str());
+  std::vector<A_Const*> literals;
+  if (result.error == nullptr && result.tree != nullptr &&
+      result.tree->length == 1) {
+    CollectLiterals(reinterpret_cast<Node*>(result.tree->head->data.ptr_value),
+                    literals);
+  }
+  std::sort(literals.begin(), literals.end(),
+            [](const A_Const* left, const A_Const* right) {
+              return left->location < right->location;
+            });
+
+  // The values are read before the parse tree is freed
+  parameterized_query.clear();
+  params.clear();
+  size_t position = 0;
+  for (auto literal : literals) {
+    if (static_cast<size_t>(literal->location) < position) continue;
+    size_t length = LiteralLength(query, literal);
+    if (length == 0) continue;
+
+    parameterized_query.append(query, position, literal->location - position);
+    parameterized_query.append("$" + std::to_string(params.size() + 1));
+    position = literal->location + length;
+    std::unique_ptr<expression::AbstractExpression> value(
+        ValueTransform(literal->val));
+    params.push_back(
+        static_cast<expression::ConstantValueExpression*>(value.get())
+            ->GetValue());
+  }
+  parameterized_query.append(query, position, std::string::npos);
+
+  pg_query_parse_finish(ctx);
+  pg_query_free_parse_result(result);
+  return params.empty() == false;
+}
+
+void PostgresParser::CollectLiterals(Node* stmt,
+                                     std::vector<A_Const*>& literals) {
+  switch (stmt->type) {
+    case T_SelectStmt: {
+      auto select_stmt = reinterpret_cast<SelectStmt*>(stmt);
+      if (select_stmt->op == SETOP_NONE) {
+        CollectWhereLiterals(select_stmt->whereClause, literals);
+      }
+      break;
+    }
+    case T_InsertStmt: {
+      // The plan of an insert only binds the parameters of a single row
+      auto select_stmt = reinterpret_cast<SelectStmt*>(
+          reinterpret_cast<InsertStmt*>(stmt)->selectStmt);
+      if (select_stmt == nullptr || select_stmt->fromClause != nullptr ||
+          select_stmt->valuesLists == nullptr ||
+          select_stmt->valuesLists->length != 1) {
+        break;
+      }
+      auto row = select_stmt->valuesLists->head;
+      auto values = reinterpret_cast<List*>(row->data.ptr_value);
+      for (auto cell = values->head; cell != nullptr; cell = cell->next) {
+        auto node = reinterpret_cast<Node*>(cell->data.ptr_value);
+        if (node->type == T_A_Const) {
+          literals.push_back(reinterpret_cast<A_Const*>(node));
+        }
+      }
+      break;
+    }
+    case T_UpdateStmt:
+      CollectWhereLiterals(reinterpret_cast<UpdateStmt*>(stmt)->whereClause,
+                           literals);
+      break;
+    case T_DeleteStmt:
+      CollectWhereLiterals(reinterpret_cast<DeleteStmt*>(stmt)->whereClause,
+                           literals);
+      break;
+    default:
+      break;
+  }
+}
+
+void PostgresParser::CollectWhereLiterals(Node* root,
+                                          std::vector<A_Const*>& literals) {
+  if (root == nullptr) {
+    return;
+  }
+  if (root->type == T_BoolExpr) {
+    auto bool_expr = reinterpret_cast<BoolExpr*>(root);
+    for (auto cell = bool_expr->args->head; cell != nullptr;
+         cell = cell->next) {
+      CollectWhereLiterals(reinterpret_cast<Node*>(cell->data.ptr_value),
+                           literals);
+    }
+    return;
+  }
+  if (root->type != T_A_Expr) {
+    return;
+  }
+
+  // Only the comparisons of a column with a literal
+  auto expr = reinterpret_cast<A_Expr*>(root);
+  if (expr->kind != AEXPR_OP || expr->lexpr == nullptr ||
+      expr->rexpr == nullptr || expr->name->length != 1) {
+    return;
+  }
+  static const std::unordered_set<std::string> comparisons(
+      {"=", "<>", "<", ">", "<=", ">="});
+  std::string name =
+      (reinterpret_cast<value*>(expr->name->head->data.ptr_value))->val.str;
+  if (comparisons.count(name) == 0) {
+    return;
+  }
+  if (expr->lexpr->type == T_ColumnRef && expr->rexpr->type == T_A_Const) {
+    literals.push_back(reinterpret_cast<A_Const*>(expr->rexpr));
+  } else if (expr->lexpr->type == T_A_Const &&
+             expr->rexpr->type == T_ColumnRef) {
+    literals.push_back(reinterpret_cast<A_Const*>(expr->lexpr));
+  }
+}
+
+size_t PostgresParser::LiteralLength(const std::string& query,
+                                     A_Const* literal) {
+  if (literal->location < 0 ||
+      static_cast<size_t>(literal->location) >= query.size()) {
+    return 0;
+  }
+  size_t begin = literal->location;
+  size_t end = begin;
+  std::string text;
+  switch (literal->val.type) {
+    case T_Integer:
+    case T_Float: {
+      // A negated number starts at its sign
+      if (query[end] == '-') {
+        text.push_back(query[end++]);
+        while (end < query.size() && std::isspace(query[end])) end++;
+      }
+      while (end < query.size() &&
+             (std::isalnum(query[end]) || query[end] == '.' ||
+              ((query[end] == '+' || query[end] == '-') && end > begin &&
+               std::tolower(query[end - 1]) == 'e'))) {
+        text.push_back(query[end++]);
+      }
+      std::string number = literal->val.type == T_Integer
+                               ? std::to_string(literal->val.val.ival)
+                               : std::string(literal->val.val.str);
+      return text == number ? end - begin : 0;
+    }
+    case T_String: {
+      if (query[end++] != '\'') {
+        return 0;
+      }
+      while (end < query.size()) {
+        if (query[end] == '\'' && end + 1 < query.size() &&
+            query[end + 1] == '\'') {
+          text.push_back('\'');
+          end += 2;
+        } else if (query[end] == '\'') {
+          return text == literal->val.val.str ? end + 1 - begin : 0;
+        } else {
+          text.push_back(query[end++]);
+        }
+      }
+      return 0;
+    }
+    default:
+      return 0;
+  }
+}
+
 }  // End pgparser namespace
 }  // End peloton namespace
@@ -37,6 +37,13 @@ const AbstractPlan *AbstractPlan::GetChild(uint32_t child_index) const {
   return children_[child_index].get();
 }
 
+std::unique_ptr<AbstractPlan> AbstractPlan::ReplaceChild(
+    uint32_t child_index, std::unique_ptr<AbstractPlan> &&child) {
+  PL_ASSERT(child_index < children_.size());
+  children_[child_index].swap(child);
+  return std::move(child);
+}
+
 const AbstractPlan *AbstractPlan::GetParent() const { return parent_; }
 
 // Get a string representation of this plan
@@ -34,7 +34,8 @@ void AggregatePlan::AggTerm::PerformBinding(BindingContext &binding_context) {
   // Setup the aggregate's return type
   switch (aggtype) {
     case ExpressionType::AGGREGATE_COUNT:
-    case ExpressionType::AGGREGATE_COUNT_STAR: {
+    case ExpressionType::AGGREGATE_COUNT_STAR:
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
       // The SQL type of COUNT() or COUNT(*) is always a non-nullable BIGINT
       agg_ai.type = codegen::type::Type{codegen::type::BigInt::Instance()};
       break;
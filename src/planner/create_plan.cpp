@@ -12,6 +12,12 @@
 
 #include "planner/create_plan.h"
 
+#include <algorithm>
+
+#include "common/exception.h"
+#include "expression/abstract_expression.h"
+#include "expression/aggregate_expression.h"
+#include "expression/tuple_value_expression.h"
 #include "parser/create_statement.h"
 #include "storage/data_table.h"
 #include "catalog/schema.h"
@@ -78,6 +84,10 @@ CreatePlan::CreatePlan(parser::CreateStatement *parse_tree) {
     }
     catalog::Schema *schema = new catalog::Schema(columns);
     table_schema = schema;
+    append_only = parse_tree->append_only;
+    partition_column = parse_tree->partition_column;
+    hash_partition_count = parse_tree->hash_partition_count;
+    range_partition_bounds = parse_tree->range_partition_bounds;
   }
   if (parse_tree->type == parse_tree->CreateType::kIndex) {
     create_type = CreateType::INDEX;
@@ -100,6 +110,81 @@ CreatePlan::CreatePlan(parser::CreateStatement *parse_tree) {
     index_type = parse_tree->index_type;
 
     unique = parse_tree->unique;
+
+    if (parse_tree->index_predicate != nullptr) {
+      index_predicate.reset(parse_tree->index_predicate->Copy());
+    }
+  }
+  if (parse_tree->type == parse_tree->CreateType::kMaterializedView) {
+    create_type = CreateType::VIEW;
+    view_name = std::string(parse_tree->GetTableName());
+
+    // Only the aggregates that stay exact through deletes can be maintained
+    auto select_stmt = parse_tree->view_query;
+    auto table_ref = select_stmt->from_table;
+    if (table_ref == nullptr || table_ref->select != nullptr ||
+        table_ref->join != nullptr || table_ref->list != nullptr ||
+        select_stmt->where_clause != nullptr || select_stmt->order != nullptr ||
+        select_stmt->limit != nullptr || select_stmt->select_distinct ||
+        select_stmt->union_select != nullptr ||
+        (select_stmt->group_by != nullptr &&
+         select_stmt->group_by->having != nullptr)) {
+      throw NotImplementedException(
+          "A materialized view aggregates a single table without WHERE, "
+          "HAVING, ORDER BY, LIMIT or DISTINCT");
+    }
+    table_name = std::string(table_ref->GetTableName());
+    database_name = std::string(table_ref->GetDatabaseName());
+
+    if (select_stmt->group_by != nullptr) {
+      for (auto expr : *select_stmt->group_by->columns) {
+        if (expr->GetExpressionType() != ExpressionType::VALUE_TUPLE) {
+          throw NotImplementedException(
+              "A materialized view only groups by columns");
+        }
+        view_group_columns.push_back(
+            static_cast<expression::TupleValueExpression *>(expr)
+                ->GetColumnName());
+      }
+    }
+
+    for (auto expr : *select_stmt->select_list) {
+      auto expr_type = expr->GetExpressionType();
+      if (expr_type == ExpressionType::AGGREGATE_COUNT_STAR) {
+        continue;
+      }
+
+      std::string column_name;
+      if (expr_type == ExpressionType::VALUE_TUPLE) {
+        column_name =
+            static_cast<expression::TupleValueExpression *>(expr)
+                ->GetColumnName();
+        if (std::find(view_group_columns.begin(), view_group_columns.end(),
+                      column_name) != view_group_columns.end()) {
+          continue;
+        }
+      } else if ((expr_type == ExpressionType::AGGREGATE_COUNT ||
+                  expr_type == ExpressionType::AGGREGATE_SUM ||
+                  expr_type == ExpressionType::AGGREGATE_AVG) &&
+                 static_cast<expression::AggregateExpression *>(expr)
+                         ->distinct_ == false &&
+                 expr->GetChild(0)->GetExpressionType() ==
+                     ExpressionType::VALUE_TUPLE) {
+        column_name =
+            static_cast<const expression::TupleValueExpression *>(
+                expr->GetChild(0))->GetColumnName();
+        if (std::find(view_aggregate_columns.begin(),
+                      view_aggregate_columns.end(),
+                      column_name) == view_aggregate_columns.end()) {
+          view_aggregate_columns.push_back(column_name);
+        }
+        continue;
+      }
+
+      throw NotImplementedException(
+          "A materialized view selects its group columns and COUNT, SUM or "
+          "AVG of columns");
+    }
   }
   // TODO check type CreateType::kDatabase
 }
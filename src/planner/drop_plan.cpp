@@ -36,6 +36,12 @@ DropPlan::DropPlan(parser::DropStatement *parse_tree) {
   // Set it up for the moment , cannot seem to find it in DropStatement
   missing = parse_tree->missing;
 
+  // A view is not in the catalog
+  if (parse_tree->type == parser::DropStatement::EntityType::kView) {
+    is_view = true;
+    return;
+  }
+
   try {
     target_table_ = catalog::Catalog::GetInstance()->GetTableWithName(
         parse_tree->GetDatabaseName(), table_name);
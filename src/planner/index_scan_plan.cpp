@@ -41,6 +41,11 @@ IndexScanPlan::IndexScanPlan(storage::DataTable *table,
 
   SetTargetTable(table);
 
+  // The binding of the base scan and its output columns go by its column ids
+  for (auto column_id : column_ids) {
+    AddColumnId(column_id);
+  }
+
   if (predicate != NULL) {
     expression::ExpressionUtil::TransformExpression(table->GetSchema(),
                                                     predicate);
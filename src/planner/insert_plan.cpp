@@ -198,5 +198,22 @@ void InsertPlan::SetParameterValues(std::vector<type::Value> *values) {
     }
   }
 }
+
+void InsertPlan::PerformBinding(BindingContext &binding_context) {
+  // Let the child do its binding first
+  AbstractPlan::PerformBinding(binding_context);
+
+  ais_.clear();
+  if (GetChildren().empty()) {
+    return;
+  }
+  for (oid_t col_id = 0; col_id < target_table_->GetSchema()->GetColumnCount();
+       col_id++) {
+    auto *ai = binding_context.Find(col_id);
+    PL_ASSERT(ai != nullptr);
+    ais_.push_back(ai);
+  }
 }
-}
+
+}  // namespace planner
+}  // namespace peloton
@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         PelotonDB
+//
+// set_op_plan.cpp
+//
+// Identification: src/planner/set_op_plan.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "planner/set_op_plan.h"
+
+namespace peloton {
+namespace planner {
+
+void SetOpPlan::PerformBinding(BindingContext &binding_context) {
+  const auto &children = GetChildren();
+  PL_ASSERT(children.size() == 2);
+
+  // The left child binds into the context of our parent
+  BindingContext right_context;
+  children[0]->PerformBinding(binding_context);
+  children[1]->PerformBinding(right_context);
+
+  // Both children have the same physical schema, so their columns match up
+  for (oid_t col_id = 0; binding_context.Find(col_id) != nullptr; col_id++) {
+    left_ais_.push_back(binding_context.Find(col_id));
+    right_ais_.push_back(right_context.Find(col_id));
+    PL_ASSERT(right_ais_.back() != nullptr);
+  }
+}
+
+}  // namespace planner
+}  // namespace peloton
@@ -177,5 +177,25 @@ void UpdatePlan::SetParameterValues(std::vector<type::Value> *values) {
   children[0]->SetParameterValues(values);
 }
 
+void UpdatePlan::PerformBinding(BindingContext &binding_context) {
+  const auto &children = GetChildren();
+  PL_ASSERT(children.size() == 1);
+
+  // Let the child do its binding first
+  BindingContext child_context;
+  children[0]->PerformBinding(child_context);
+
+  std::vector<const BindingContext *> inputs = {&child_context};
+  GetProjectInfo()->PerformRebinding(binding_context, inputs);
+
+  ais_.clear();
+  for (oid_t col_id = 0; col_id < target_table_->GetSchema()->GetColumnCount();
+       col_id++) {
+    auto *ai = binding_context.Find(col_id);
+    PL_ASSERT(ai != nullptr);
+    ais_.push_back(ai);
+  }
+}
+
 }  // namespace planner
 }  // namespace peloton
@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// access_counter_slab.cpp
+//
+// Identification: src/statistics/access_counter_slab.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/access_counter_slab.h"
+
+namespace peloton {
+namespace stats {
+
+AccessCounterSlab::AccessCounterSlab()
+    : directory_(new std::atomic<Segment *>[DIRECTORY_SIZE]),
+      segment_count_(0) {
+  for (size_t segment_idx = 0; segment_idx < DIRECTORY_SIZE; segment_idx++) {
+    directory_[segment_idx].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+AccessCounterSlab::~AccessCounterSlab() {
+  for (size_t segment_idx = 0; segment_idx < DIRECTORY_SIZE; segment_idx++) {
+    delete directory_[segment_idx].load(std::memory_order_relaxed);
+  }
+}
+
+size_t AccessCounterSlab::GetNextSlotId() {
+  static std::atomic<size_t> next_slot_id(0);
+  return next_slot_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+AccessCounterSlab::Segment *AccessCounterSlab::AddSegment(
+    const size_t segment_idx) {
+  Segment *segment = new Segment();
+  directory_[segment_idx].store(segment, std::memory_order_release);
+  if (segment_idx >= segment_count_.load(std::memory_order_relaxed)) {
+    segment_count_.store(segment_idx + 1, std::memory_order_release);
+  }
+  return segment;
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -12,20 +12,35 @@
 
 #include "statistics/backend_stats_context.h"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 #include "type/types.h"
 #include "common/statement.h"
 #include "catalog/catalog.h"
 #include "catalog/manager.h"
+#include "configuration/configuration.h"
 #include "index/index.h"
 #include "statistics/stats_aggregator.h"
+#include "storage/abstract_table.h"
 #include "storage/storage_manager.h"
 #include "storage/tile_group.h"
 
 namespace peloton {
 namespace stats {
 
+namespace {
+
+// The statement types whose query latencies are recorded apart
+const char* const QUERY_LATENCY_TYPES[] = {"SELECT", "INSERT", "UPDATE",
+                                           "DELETE", "OTHER"};
+
+const size_t QUERY_LATENCY_TYPE_COUNT =
+    sizeof(QUERY_LATENCY_TYPES) / sizeof(QUERY_LATENCY_TYPES[0]);
+
+}  // namespace
+
 CuckooMap<std::thread::id, std::shared_ptr<BackendStatsContext>>&
 BackendStatsContext::GetBackendContextMap() {
   static CuckooMap<std::thread::id, std::shared_ptr<BackendStatsContext>>
@@ -34,20 +49,31 @@ BackendStatsContext::GetBackendContextMap() {
 }
 
 BackendStatsContext* BackendStatsContext::GetInstance() {
+  // The context of the thread is only looked up on its first call
+  static thread_local BackendStatsContext* thread_context = nullptr;
+  if (thread_context != nullptr) {
+    return thread_context;
+  }
+
   // Each thread gets a backend stats context
   std::thread::id this_id = std::this_thread::get_id();
   std::shared_ptr<BackendStatsContext> result(nullptr);
   auto& stats_context_map = GetBackendContextMap();
   if (stats_context_map.Find(this_id, result) == false) {
-    result.reset(new BackendStatsContext(LATENCY_MAX_HISTORY_THREAD, true));
+    result.reset(new BackendStatsContext(true));
     stats_context_map.Insert(this_id, result);
   }
-  return result.get();
+  thread_context = result.get();
+  return thread_context;
 }
 
-BackendStatsContext::BackendStatsContext(size_t max_latency_history,
-                                         bool regiser_to_aggregator)
-    : txn_latencies_(LATENCY_METRIC, max_latency_history) {
+BackendStatsContext::BackendStatsContext(bool regiser_to_aggregator)
+    : txn_latencies_(LATENCY_METRIC), commit_latencies_(LATENCY_METRIC) {
+  // Created up front, the aggregator reads them while this thread records
+  for (size_t type_idx = 0; type_idx < QUERY_LATENCY_TYPE_COUNT; type_idx++) {
+    query_latencies_.emplace_back(new LatencyMetric(LATENCY_METRIC));
+  }
+
   std::thread::id this_id = std::this_thread::get_id();
   thread_id_ = this_id;
 
@@ -107,57 +133,50 @@ LatencyMetric& BackendStatsContext::GetTxnLatencyMetric() {
   return txn_latencies_;
 }
 
+LatencyMetric& BackendStatsContext::GetCommitLatencyMetric() {
+  return commit_latencies_;
+}
+
+LatencyMetric& BackendStatsContext::GetQueryLatencyMetric(
+    const std::string& query_type_string) {
+  return *query_latencies_[GetQueryLatencyTypeIdx(query_type_string)];
+}
+
 void BackendStatsContext::IncrementTableReads(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementReads();
+  auto table_counters = GetTableCounters(tile_group_id);
+  if (table_counters != nullptr) {
+    AccessCounterSlab::Increment(table_counters->reads);
+  }
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetQueryAccess().IncrementReads();
   }
 }
 
 void BackendStatsContext::IncrementTableInserts(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementInserts();
+  auto table_counters = GetTableCounters(tile_group_id);
+  if (table_counters != nullptr) {
+    AccessCounterSlab::Increment(table_counters->inserts);
+  }
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetQueryAccess().IncrementInserts();
   }
 }
 
 void BackendStatsContext::IncrementTableUpdates(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementUpdates();
+  auto table_counters = GetTableCounters(tile_group_id);
+  if (table_counters != nullptr) {
+    AccessCounterSlab::Increment(table_counters->updates);
+  }
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetQueryAccess().IncrementUpdates();
   }
 }
 
 void BackendStatsContext::IncrementTableDeletes(oid_t tile_group_id) {
-  oid_t table_id =
-      catalog::Manager::GetInstance().GetTileGroup(tile_group_id)->GetTableId();
-  oid_t database_id = catalog::Manager::GetInstance()
-                          .GetTileGroup(tile_group_id)
-                          ->GetDatabaseId();
-  auto table_metric = GetTableMetric(database_id, table_id);
-  PL_ASSERT(table_metric != nullptr);
-  table_metric->GetTableAccess().IncrementDeletes();
+  auto table_counters = GetTableCounters(tile_group_id);
+  if (table_counters != nullptr) {
+    AccessCounterSlab::Increment(table_counters->deletes);
+  }
   if (ongoing_query_metric_ != nullptr) {
     ongoing_query_metric_->GetQueryAccess().IncrementDeletes();
   }
@@ -165,42 +184,34 @@ void BackendStatsContext::IncrementTableDeletes(oid_t tile_group_id) {
 
 void BackendStatsContext::IncrementIndexReads(size_t read_count,
                                               index::IndexMetadata* metadata) {
-  oid_t index_id = metadata->GetOid();
-  oid_t table_id = metadata->GetTableOid();
-  oid_t database_id = metadata->GetDatabaseOid();
-  auto index_metric = GetIndexMetric(database_id, table_id, index_id);
-  PL_ASSERT(index_metric != nullptr);
-  index_metric->GetIndexAccess().IncrementReads(read_count);
+  auto index_counters = GetIndexCounters(metadata);
+  if (index_counters != nullptr) {
+    AccessCounterSlab::Increment(index_counters->reads, read_count);
+  }
 }
 
 void BackendStatsContext::IncrementIndexInserts(
     index::IndexMetadata* metadata) {
-  oid_t index_id = metadata->GetOid();
-  oid_t table_id = metadata->GetTableOid();
-  oid_t database_id = metadata->GetDatabaseOid();
-  auto index_metric = GetIndexMetric(database_id, table_id, index_id);
-  PL_ASSERT(index_metric != nullptr);
-  index_metric->GetIndexAccess().IncrementInserts();
+  auto index_counters = GetIndexCounters(metadata);
+  if (index_counters != nullptr) {
+    AccessCounterSlab::Increment(index_counters->inserts);
+  }
 }
 
 void BackendStatsContext::IncrementIndexUpdates(
     index::IndexMetadata* metadata) {
-  oid_t index_id = metadata->GetOid();
-  oid_t table_id = metadata->GetTableOid();
-  oid_t database_id = metadata->GetDatabaseOid();
-  auto index_metric = GetIndexMetric(database_id, table_id, index_id);
-  PL_ASSERT(index_metric != nullptr);
-  index_metric->GetIndexAccess().IncrementUpdates();
+  auto index_counters = GetIndexCounters(metadata);
+  if (index_counters != nullptr) {
+    AccessCounterSlab::Increment(index_counters->updates);
+  }
 }
 
 void BackendStatsContext::IncrementIndexDeletes(
     size_t delete_count, index::IndexMetadata* metadata) {
-  oid_t index_id = metadata->GetOid();
-  oid_t table_id = metadata->GetTableOid();
-  oid_t database_id = metadata->GetDatabaseOid();
-  auto index_metric = GetIndexMetric(database_id, table_id, index_id);
-  PL_ASSERT(index_metric != nullptr);
-  index_metric->GetIndexAccess().IncrementDeletes(delete_count);
+  auto index_counters = GetIndexCounters(metadata);
+  if (index_counters != nullptr) {
+    AccessCounterSlab::Increment(index_counters->deletes, delete_count);
+  }
 }
 
 void BackendStatsContext::IncrementTxnCommitted(oid_t database_id) {
@@ -217,12 +228,62 @@ void BackendStatsContext::IncrementTxnAborted(oid_t database_id) {
   CompleteQueryMetric();
 }
 
+void BackendStatsContext::RecordQueryCodegen(
+    const QueryMetric::CodegenInfo& codegen_info) {
+  if (is_query_ongoing_) {
+    RecordQueryPhase(QueryPhase::COMPILE, codegen_info.compile_ms);
+  }
+  if (ongoing_query_metric_ != nullptr) {
+    ongoing_query_metric_->GetCodegenInfo() = codegen_info;
+  }
+}
+
 void BackendStatsContext::InitQueryMetric(
     const std::shared_ptr<Statement> statement,
     const std::shared_ptr<QueryMetric::QueryParams> params) {
-  // TODO currently all queries belong to DEFAULT_DB
-  ongoing_query_metric_.reset(new QueryMetric(
-      QUERY_METRIC, statement->GetQueryString(), params, DEFAULT_DB_ID));
+  is_query_ongoing_ = true;
+  started_query_count_++;
+  ongoing_query_type_idx_ =
+      GetQueryLatencyTypeIdx(statement->GetQueryTypeString());
+
+  auto sample_interval = FLAGS_stats_query_sample_interval;
+  if (sample_interval != 0 && started_query_count_ % sample_interval == 0) {
+    // TODO currently all queries belong to DEFAULT_DB
+    ongoing_query_metric_.reset(new QueryMetric(
+        QUERY_METRIC, statement->GetQueryString(), params, DEFAULT_DB_ID));
+    ongoing_statement_.reset();
+    ongoing_query_params_.reset();
+  } else {
+    ongoing_query_metric_.reset();
+    ongoing_statement_ = statement;
+    ongoing_query_params_ = params;
+    ongoing_query_timer_.StartTimer();
+  }
+}
+
+void BackendStatsContext::RecordQueryPhase(const QueryPhase phase,
+                                           const double latency_ms) {
+  // After the query of the response completed, the time counts for it alone
+  if (is_trace_completed_) {
+    if (traced_query_metric_ != nullptr) {
+      traced_query_metric_->AddPhaseLatency(phase, latency_ms);
+    }
+    return;
+  }
+  query_phase_latencies_[static_cast<size_t>(phase)] += latency_ms;
+}
+
+void BackendStatsContext::StartQueryTrace() {
+  FinishQueryTrace();
+  is_tracing_ = true;
+}
+
+void BackendStatsContext::FinishQueryTrace() {
+  if (traced_query_metric_ != nullptr) {
+    EnqueueCompletedQueryMetric(std::move(traced_query_metric_));
+  }
+  is_tracing_ = false;
+  is_trace_completed_ = false;
 }
 
 //===--------------------------------------------------------------------===//
@@ -232,13 +293,36 @@ void BackendStatsContext::InitQueryMetric(
 void BackendStatsContext::Aggregate(BackendStatsContext& source) {
   // Aggregate all global metrics
   txn_latencies_.Aggregate(source.txn_latencies_);
-  txn_latencies_.ComputeLatencies();
+  commit_latencies_.Aggregate(source.commit_latencies_);
+  for (size_t type_idx = 0; type_idx < QUERY_LATENCY_TYPE_COUNT; type_idx++) {
+    query_latencies_[type_idx]->Aggregate(*source.query_latencies_[type_idx]);
+  }
 
   // Aggregate all per-database metrics
   for (auto& database_item : source.database_metrics_) {
     GetDatabaseMetric(database_item.first)->Aggregate(*database_item.second);
   }
 
+  // Aggregate the accesses counted by the thread of the source
+  source.access_counters_.ForEachSlot([this](const AccessCounterSlot& slot) {
+    AccessMetric* access_metric;
+    if (slot.index_id == INVALID_OID) {
+      access_metric =
+          &GetTableMetric(slot.database_id, slot.table_id)->GetTableAccess();
+    } else {
+      access_metric =
+          &GetIndexMetric(slot.database_id, slot.table_id, slot.index_id)
+               ->GetIndexAccess();
+    }
+    access_metric->IncrementReads(slot.reads.load(std::memory_order_relaxed));
+    access_metric->IncrementUpdates(
+        slot.updates.load(std::memory_order_relaxed));
+    access_metric->IncrementInserts(
+        slot.inserts.load(std::memory_order_relaxed));
+    access_metric->IncrementDeletes(
+        slot.deletes.load(std::memory_order_relaxed));
+  });
+
   // Aggregate all per-table metrics
   for (auto& table_item : source.table_metrics_) {
     GetTableMetric(table_item.second->GetDatabaseId(),
@@ -247,19 +331,24 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
   }
 
   // Aggregate all per-index metrics
-  for (auto id : index_ids_) {
-    std::shared_ptr<IndexMetric> index_metric;
-    index_metrics_.Find(id, index_metric);
-    auto database_oid = index_metric->GetDatabaseId();
-    auto table_oid = index_metric->GetTableId();
-    index_metric->Aggregate(
-        *(source.GetIndexMetric(database_oid, table_oid, id)));
+  source.index_id_lock.Lock();
+  std::vector<oid_t> source_index_ids(source.index_ids_.begin(),
+                                      source.index_ids_.end());
+  source.index_id_lock.Unlock();
+  for (auto id : source_index_ids) {
+    std::shared_ptr<IndexMetric> source_index_metric;
+    source.index_metrics_.Find(id, source_index_metric);
+    GetIndexMetric(source_index_metric->GetDatabaseId(),
+                   source_index_metric->GetTableId(), id)
+        ->Aggregate(*source_index_metric);
   }
 
   // Aggregate all per-query metrics
   std::shared_ptr<QueryMetric> query_metric;
   while (source.completed_query_metrics_.Dequeue(query_metric)) {
-    completed_query_metrics_.Enqueue(query_metric);
+    if (completed_query_metrics_.Enqueue(std::move(query_metric)) == false) {
+      LOG_TRACE("Dropped a query metric to aggregate");
+    }
     LOG_TRACE("Found a query metric to aggregate");
     aggregated_query_count_++;
   }
@@ -267,6 +356,10 @@ void BackendStatsContext::Aggregate(BackendStatsContext& source) {
 
 void BackendStatsContext::Reset() {
   txn_latencies_.Reset();
+  commit_latencies_.Reset();
+  for (auto& query_latencies : query_latencies_) {
+    query_latencies->Reset();
+  }
 
   for (auto& database_item : database_metrics_) {
     database_item.second->Reset();
@@ -321,10 +414,47 @@ void BackendStatsContext::Reset() {
   }
 }
 
+void BackendStatsContext::ComputeLatencies() {
+  txn_latencies_.ComputeLatencies();
+  commit_latencies_.ComputeLatencies();
+  for (auto& query_latencies : query_latencies_) {
+    query_latencies->ComputeLatencies();
+  }
+}
+
+AccessCounterSlot* BackendStatsContext::GetTableCounters(
+    oid_t tile_group_id) {
+  // The tile group is kept alive by the txn accessing it
+  auto tile_group =
+      catalog::Manager::GetInstance().ResolveTileGroup(tile_group_id);
+  if (tile_group == nullptr || tile_group->GetAbstractTable() == nullptr) {
+    return nullptr;
+  }
+  auto table = tile_group->GetAbstractTable();
+  return access_counters_.GetSlot(table->GetStatsSlotId(),
+                                  tile_group->GetDatabaseId(),
+                                  table->GetOid(), INVALID_OID);
+}
+
+AccessCounterSlot* BackendStatsContext::GetIndexCounters(
+    index::IndexMetadata* metadata) {
+  return access_counters_.GetSlot(
+      metadata->GetStatsSlotId(), metadata->GetDatabaseOid(),
+      metadata->GetTableOid(), metadata->GetOid());
+}
+
 std::string BackendStatsContext::ToString() const {
   std::stringstream ss;
 
-  ss << txn_latencies_.GetInfo() << std::endl;
+  ss << "TXN " << txn_latencies_.GetInfo();
+  ss << "COMMIT " << commit_latencies_.GetInfo();
+  for (size_t type_idx = 0; type_idx < QUERY_LATENCY_TYPE_COUNT; type_idx++) {
+    auto& query_latencies = *query_latencies_[type_idx];
+    if (query_latencies.GetLatencyMeasurements().count_ != 0) {
+      ss << QUERY_LATENCY_TYPES[type_idx] << " " << query_latencies.GetInfo();
+    }
+  }
+  ss << std::endl;
 
   for (auto& database_item : database_metrics_) {
     oid_t database_id = database_item.second->GetDatabaseId();
@@ -360,12 +490,117 @@ std::string BackendStatsContext::ToString() const {
 }
 
 void BackendStatsContext::CompleteQueryMetric() {
+  if (is_query_ongoing_ == false) {
+    return;
+  }
+  is_query_ongoing_ = false;
+
+  std::shared_ptr<QueryMetric> query_metric;
+  double latency_ms;
   if (ongoing_query_metric_ != nullptr) {
-    ongoing_query_metric_->GetProcessorMetric().RecordTime();
-    ongoing_query_metric_->GetQueryLatency().RecordLatency();
-    completed_query_metrics_.Enqueue(ongoing_query_metric_);
-    ongoing_query_metric_.reset();
-    LOG_TRACE("Ongoing query completed");
+    query_metric = std::move(ongoing_query_metric_);
+    query_metric->GetProcessorMetric().RecordTime();
+    auto& query_latency = query_metric->GetQueryLatency();
+    query_latency.RecordLatency();
+    latency_ms = query_latency.GetLatencyValue();
+  } else {
+    ongoing_query_timer_.RecordLatency();
+    latency_ms = ongoing_query_timer_.GetLatencyValue();
+
+    // A slow query gets its metric now, without its accesses, processor
+    // time and compilation
+    auto slow_query_ms = FLAGS_stats_slow_query_ms;
+    if (slow_query_ms != 0 && latency_ms >= slow_query_ms) {
+      query_metric.reset(new QueryMetric(
+          QUERY_METRIC, ongoing_statement_->GetQueryString(),
+          ongoing_query_params_, DEFAULT_DB_ID));
+      query_metric->GetQueryLatency().SetLatencyValue(latency_ms);
+    }
+    ongoing_statement_.reset();
+    ongoing_query_params_.reset();
+  }
+  query_latencies_[ongoing_query_type_idx_]->RecordLatency(latency_ms);
+
+  // The query executed from its start on, but while it was compiled
+  auto compile_ms =
+      query_phase_latencies_[static_cast<size_t>(QueryPhase::COMPILE)];
+  query_phase_latencies_[static_cast<size_t>(QueryPhase::EXECUTE)] +=
+      std::max(latency_ms - compile_ms, 0.0);
+  if (query_metric != nullptr) {
+    for (size_t phase_idx = 0; phase_idx < QUERY_PHASE_COUNT; phase_idx++) {
+      query_metric->AddPhaseLatency(static_cast<QueryPhase>(phase_idx),
+                                    query_phase_latencies_[phase_idx]);
+    }
+  }
+  for (auto& phase_latency : query_phase_latencies_) {
+    phase_latency = 0;
+  }
+
+  // The results of a traced response are yet to be sent
+  if (is_tracing_) {
+    if (traced_query_metric_ != nullptr) {
+      EnqueueCompletedQueryMetric(std::move(traced_query_metric_));
+    }
+    traced_query_metric_ = std::move(query_metric);
+    is_trace_completed_ = true;
+  } else if (query_metric != nullptr) {
+    EnqueueCompletedQueryMetric(std::move(query_metric));
+  }
+  LOG_TRACE("Ongoing query completed");
+}
+
+void BackendStatsContext::EnqueueCompletedQueryMetric(
+    std::shared_ptr<QueryMetric> query_metric) {
+  if (completed_query_metrics_.Enqueue(std::move(query_metric)) == false) {
+    LOG_TRACE("Dropped a completed query metric");
+  }
+}
+
+size_t BackendStatsContext::GetQueryLatencyTypeIdx(
+    const std::string& query_type_string) {
+  for (size_t type_idx = 0; type_idx < QUERY_LATENCY_TYPE_COUNT - 1;
+       type_idx++) {
+    if (query_type_string == QUERY_LATENCY_TYPES[type_idx]) {
+      return type_idx;
+    }
+  }
+  return QUERY_LATENCY_TYPE_COUNT - 1;
+}
+
+//===--------------------------------------------------------------------===//
+// Query Phase Timer
+//===--------------------------------------------------------------------===//
+
+QueryPhaseTimer::QueryPhaseTimer(const QueryPhase phase)
+    : phase_(phase), is_timing_(FLAGS_stats_mode != STATS_TYPE_INVALID) {
+  if (is_timing_) {
+    timer_ms_.Start();
+  }
+}
+
+void QueryPhaseTimer::Stop() {
+  if (is_timing_) {
+    is_timing_ = false;
+    timer_ms_.Stop();
+    BackendStatsContext::GetInstance()->RecordQueryPhase(
+        phase_, timer_ms_.GetDuration());
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Query Trace Scope
+//===--------------------------------------------------------------------===//
+
+QueryTraceScope::QueryTraceScope()
+    : is_tracing_(FLAGS_stats_mode != STATS_TYPE_INVALID) {
+  if (is_tracing_) {
+    BackendStatsContext::GetInstance()->StartQueryTrace();
+  }
+}
+
+QueryTraceScope::~QueryTraceScope() {
+  if (is_tracing_) {
+    BackendStatsContext::GetInstance()->FinishQueryTrace();
   }
 }
 
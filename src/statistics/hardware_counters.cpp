@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hardware_counters.cpp
+//
+// Identification: src/statistics/hardware_counters.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/hardware_counters.h"
+
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#include "common/logger.h"
+
+namespace peloton {
+namespace stats {
+
+void HardwareCounterValues::Add(const HardwareCounterValues &source) {
+  cycles += source.cycles;
+  instructions += source.instructions;
+  llc_misses += source.llc_misses;
+  branch_misses += source.branch_misses;
+  tlb_misses += source.tlb_misses;
+}
+
+HardwareCounterValues HardwareCounterValues::GetSince(
+    const HardwareCounterValues &begin) const {
+  HardwareCounterValues values;
+  values.cycles = cycles - begin.cycles;
+  values.instructions = instructions - begin.instructions;
+  values.llc_misses = llc_misses - begin.llc_misses;
+  values.branch_misses = branch_misses - begin.branch_misses;
+  values.tlb_misses = tlb_misses - begin.tlb_misses;
+  return values;
+}
+
+double HardwareCounterValues::GetInstructionsPerCycle() const {
+  if (cycles == 0) {
+    return 0;
+  }
+  return static_cast<double>(instructions) / cycles;
+}
+
+double HardwareCounterValues::GetMissesPerKiloInstructions(
+    const uint64_t misses) const {
+  if (instructions == 0) {
+    return 0;
+  }
+  return misses * 1000.0 / instructions;
+}
+
+const std::string HardwareCounterValues::GetInfo() const {
+  std::stringstream ss;
+  ss << "cycles=" << cycles << ", instructions=" << instructions
+     << ", ipc=" << GetInstructionsPerCycle()
+     << ", llc_mpki=" << GetMissesPerKiloInstructions(llc_misses)
+     << ", branch_mpki=" << GetMissesPerKiloInstructions(branch_misses)
+     << ", tlb_mpki=" << GetMissesPerKiloInstructions(tlb_misses);
+  return ss.str();
+}
+
+#ifdef __linux__
+
+namespace {
+
+// The events of the counters, in the order of HardwareCounterValues
+struct CounterEvent {
+  uint32_t type;
+  uint64_t config;
+};
+
+const CounterEvent COUNTER_EVENTS[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)}};
+
+int OpenCounter(const CounterEvent &event, const int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  // The calling thread, on any CPU
+  return static_cast<int>(
+      syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+
+}  // namespace
+
+HardwareCounters::HardwareCounters() {
+  for (size_t counter_idx = 0; counter_idx < COUNTER_COUNT; counter_idx++) {
+    int group_fd = counter_idx == 0 ? -1 : counter_fds_[0];
+    counter_fds_[counter_idx] =
+        OpenCounter(COUNTER_EVENTS[counter_idx], group_fd);
+    if (counter_fds_[counter_idx] < 0) {
+      LOG_DEBUG("Cannot count hardware counter %lu: %s", counter_idx,
+                strerror(errno));
+      // Without the leader there is no group
+      if (counter_idx == 0) {
+        break;
+      }
+      continue;
+    }
+    value_counters_[open_count_++] = counter_idx;
+  }
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (size_t value_idx = 0; value_idx < open_count_; value_idx++) {
+    close(counter_fds_[value_counters_[value_idx]]);
+  }
+}
+
+bool HardwareCounters::Read(HardwareCounterValues &values) const {
+  // The number of values, followed by the values
+  uint64_t buffer[1 + COUNTER_COUNT];
+  auto read_size = sizeof(uint64_t) * (1 + open_count_);
+  if (read(counter_fds_[0], buffer, read_size) !=
+          static_cast<ssize_t>(read_size) ||
+      buffer[0] != open_count_) {
+    return false;
+  }
+
+  uint64_t *counters[] = {&values.cycles, &values.instructions,
+                          &values.llc_misses, &values.branch_misses,
+                          &values.tlb_misses};
+  for (size_t value_idx = 0; value_idx < open_count_; value_idx++) {
+    *counters[value_counters_[value_idx]] = buffer[1 + value_idx];
+  }
+  return true;
+}
+
+#else
+
+HardwareCounters::HardwareCounters() {}
+
+HardwareCounters::~HardwareCounters() {}
+
+bool HardwareCounters::Read(HardwareCounterValues &) const { return false; }
+
+#endif
+
+HardwareCounters *HardwareCounters::GetInstance() {
+  thread_local HardwareCounters counters;
+  if (counters.open_count_ == 0) {
+    return nullptr;
+  }
+  return &counters;
+}
+
+}  // namespace stats
+}  // namespace peloton
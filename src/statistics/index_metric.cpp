@@ -40,6 +40,24 @@ void IndexMetric::Aggregate(AbstractMetric& source) {
 
   IndexMetric& index_metric = static_cast<IndexMetric&>(source);
   index_access_.Aggregate(index_metric.GetIndexAccess());
+  consolidations_ += index_metric.GetConsolidations();
+  splits_ += index_metric.GetSplits();
+  merges_ += index_metric.GetMerges();
+  cas_failures_ += index_metric.GetCASFailures();
+  epochs_ += index_metric.GetEpochs();
+  garbage_nodes_ += index_metric.GetGarbageNodes();
+  delta_chain_threshold_ += index_metric.GetDeltaChainThreshold();
+}
+
+void IndexMetric::SetStructureStats(
+    const index::IndexStructureStats& structure_stats) {
+  consolidations_ = structure_stats.consolidation_count;
+  splits_ = structure_stats.split_count;
+  merges_ = structure_stats.merge_count;
+  cas_failures_ = structure_stats.cas_failure_count;
+  epochs_ = structure_stats.epoch_count;
+  garbage_nodes_ = structure_stats.garbage_node_count;
+  delta_chain_threshold_ = structure_stats.delta_chain_threshold;
 }
 
 }  // namespace stats
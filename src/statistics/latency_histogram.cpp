@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram.cpp
+//
+// Identification: src/statistics/latency_histogram.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/latency_histogram.h"
+
+#include <cmath>
+
+namespace peloton {
+namespace stats {
+
+namespace {
+
+// Only called by the thread owning the histogram, which is the only writer of
+// the counter, so this compiles to a plain add
+inline void AddTo(std::atomic<uint64_t> &counter, const uint64_t count) {
+  counter.store(counter.load(std::memory_order_relaxed) + count,
+                std::memory_order_relaxed);
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram() { Reset(); }
+
+size_t LatencyHistogram::GetBucketIdx(uint64_t latency_us) {
+  if (latency_us > MAX_LATENCY_US) {
+    latency_us = MAX_LATENCY_US;
+  }
+  if (latency_us < SUB_BUCKET_COUNT) {
+    return latency_us;
+  }
+  // Shifted down so that it is one of the upper half of the sub buckets
+  uint64_t high_bit = 63 - __builtin_clzll(latency_us);
+  uint64_t magnitude = high_bit - SUB_BUCKET_BITS + 1;
+  return magnitude * SUB_BUCKET_HALF_COUNT + (latency_us >> magnitude);
+}
+
+uint64_t LatencyHistogram::GetBucketLatency(size_t bucket_idx) {
+  if (bucket_idx < SUB_BUCKET_COUNT) {
+    return bucket_idx;
+  }
+  uint64_t magnitude = bucket_idx / SUB_BUCKET_HALF_COUNT - 1;
+  uint64_t sub_bucket_idx = bucket_idx - magnitude * SUB_BUCKET_HALF_COUNT;
+  return ((sub_bucket_idx + 1) << magnitude) - 1;
+}
+
+void LatencyHistogram::Record(double latency_ms) {
+  double latency_us = latency_ms * 1000;
+  uint64_t rounded_latency_us = 0;
+  if (latency_us >= MAX_LATENCY_US) {
+    rounded_latency_us = MAX_LATENCY_US;
+  } else if (latency_us > 0) {
+    rounded_latency_us = static_cast<uint64_t>(std::llround(latency_us));
+  }
+  AddTo(bucket_counts_[GetBucketIdx(rounded_latency_us)], 1);
+  AddTo(total_count_, 1);
+  AddTo(total_latency_us_, rounded_latency_us);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram &source) {
+  for (size_t bucket_idx = 0; bucket_idx < BUCKET_COUNT; bucket_idx++) {
+    uint64_t count =
+        source.bucket_counts_[bucket_idx].load(std::memory_order_relaxed);
+    if (count != 0) {
+      AddTo(bucket_counts_[bucket_idx], count);
+    }
+  }
+  AddTo(total_count_, source.total_count_.load(std::memory_order_relaxed));
+  AddTo(total_latency_us_,
+        source.total_latency_us_.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Subtract(const LatencyHistogram &source) {
+  for (size_t bucket_idx = 0; bucket_idx < BUCKET_COUNT; bucket_idx++) {
+    uint64_t count =
+        source.bucket_counts_[bucket_idx].load(std::memory_order_relaxed);
+    if (count != 0) {
+      // Adding the negation wraps around to the difference
+      AddTo(bucket_counts_[bucket_idx], -count);
+    }
+  }
+  AddTo(total_count_, -source.total_count_.load(std::memory_order_relaxed));
+  AddTo(total_latency_us_,
+        -source.total_latency_us_.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Reset() {
+  for (auto &bucket_count : bucket_counts_) {
+    bucket_count.store(0, std::memory_order_relaxed);
+  }
+  total_count_.store(0, std::memory_order_relaxed);
+  total_latency_us_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+  return total_count_.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::GetAverage() const {
+  uint64_t count = GetCount();
+  if (count == 0) {
+    return 0;
+  }
+  return total_latency_us_.load(std::memory_order_relaxed) / 1000.0 / count;
+}
+
+double LatencyHistogram::GetSum() const {
+  return total_latency_us_.load(std::memory_order_relaxed) / 1000.0;
+}
+
+uint64_t LatencyHistogram::GetCountAtMost(double latency_ms) const {
+  uint64_t count = 0;
+  for (size_t bucket_idx = 0; bucket_idx < BUCKET_COUNT; bucket_idx++) {
+    if (GetBucketLatency(bucket_idx) / 1000.0 > latency_ms) {
+      break;
+    }
+    count += bucket_counts_[bucket_idx].load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+double LatencyHistogram::GetPercentile(double percentile) const {
+  // Counted from the buckets, which may be recorded into meanwhile
+  uint64_t count = 0;
+  for (auto &bucket_count : bucket_counts_) {
+    count += bucket_count.load(std::memory_order_relaxed);
+  }
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100 * count));
+  if (rank < 1) {
+    rank = 1;
+  } else if (rank > count) {
+    rank = count;
+  }
+
+  uint64_t seen_count = 0;
+  size_t last_bucket_idx = 0;
+  for (size_t bucket_idx = 0; bucket_idx < BUCKET_COUNT; bucket_idx++) {
+    uint64_t bucket_count =
+        bucket_counts_[bucket_idx].load(std::memory_order_relaxed);
+    if (bucket_count == 0) {
+      continue;
+    }
+    last_bucket_idx = bucket_idx;
+    seen_count += bucket_count;
+    if (seen_count >= rank) {
+      break;
+    }
+  }
+  return GetBucketLatency(last_bucket_idx) / 1000.0;
+}
+
+double LatencyHistogram::GetMin() const { return GetPercentile(0); }
+
+double LatencyHistogram::GetMax() const { return GetPercentile(100); }
+
+}  // namespace stats
+}  // namespace peloton
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_usage.cpp
+//
+// Identification: src/statistics/memory_usage.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/memory_usage.h"
+
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace stats {
+
+MemoryUsage::MemoryUsage() : tuple_count(0) {
+  for (size_t type = 0; type < MEMORY_COMPONENT_TYPE_COUNT; type++) {
+    bytes[type] = 0;
+  }
+}
+
+MemoryUsage MemoryUsage::GetTracked() {
+  MemoryUsage usage;
+  for (size_t type = 0; type < MEMORY_COMPONENT_TYPE_COUNT; type++) {
+    usage.bytes[type] = MemoryTracker::GetAllocatedBytes(
+        static_cast<MemoryComponentType>(type));
+  }
+  return usage;
+}
+
+MemoryUsage MemoryUsage::Collect() {
+  auto usage = GetTracked();
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto database_count = storage_manager->GetDatabaseCount();
+  for (oid_t database_offset = 0; database_offset < database_count;
+       database_offset++) {
+    usage.AddDatabase(storage_manager->GetDatabaseWithOffset(database_offset));
+  }
+  return usage;
+}
+
+void MemoryUsage::AddTable(storage::DataTable *table) {
+  auto index_count = table->GetIndexCount();
+  for (oid_t index_offset = 0; index_offset < index_count; index_offset++) {
+    auto index = table->GetIndex(index_offset);
+    if (index == nullptr) continue;
+    bytes[static_cast<size_t>(MemoryComponentType::INDEX)] +=
+        index->GetMemoryFootprint();
+  }
+
+  // A version awaiting GC has been superseded or deleted by a committed
+  // transaction and still holds its slot
+  size_t version_size = table->GetSchema()->GetLength() +
+                        storage::TileGroupHeader::header_entry_size;
+  auto tile_group_count = table->GetTileGroupCount();
+  for (size_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) continue;
+    auto header = tile_group->GetHeader();
+    auto slot_count = header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+      if (header->GetEndCommitId(tuple_slot) != MAX_CID &&
+          header->GetTransactionId(tuple_slot) != INVALID_TXN_ID) {
+        bytes[static_cast<size_t>(MemoryComponentType::VERSION_CHAIN)] +=
+            version_size;
+      }
+    }
+  }
+
+  tuple_count += table->GetTupleCount();
+}
+
+void MemoryUsage::AddDatabase(storage::Database *database) {
+  auto table_count = database->GetTableCount();
+  for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
+    AddTable(database->GetTable(table_offset));
+  }
+}
+
+size_t MemoryUsage::GetTotalBytes() const {
+  size_t total_bytes = 0;
+  for (size_t type = 0; type < MEMORY_COMPONENT_TYPE_COUNT; type++) {
+    if (type == static_cast<size_t>(MemoryComponentType::VERSION_CHAIN)) {
+      continue;
+    }
+    total_bytes += bytes[type];
+  }
+  return total_bytes;
+}
+
+}  // namespace stats
+}  // namespace peloton
@@ -0,0 +1,222 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// metrics_exporter.cpp
+//
+// Identification: src/statistics/metrics_exporter.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "statistics/metrics_exporter.h"
+
+#include <event2/buffer.h>
+#include <event2/event.h>
+#include <event2/http.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "statistics/latency_histogram.h"
+
+namespace peloton {
+namespace stats {
+
+namespace {
+
+std::string EscapeLabelValue(const std::string &value) {
+  std::string escaped;
+  for (auto c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+std::string FormatValue(const double value) {
+  std::ostringstream ss;
+  ss << std::setprecision(15) << value;
+  return ss.str();
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Metrics Text
+//===--------------------------------------------------------------------===//
+
+const std::vector<double> MetricsText::HISTOGRAM_BUCKETS_S = {
+    0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5};
+
+void MetricsText::AddFamily(const std::string &name, const std::string &type,
+                            const std::string &help) {
+  text_ += "# HELP " + name + " " + help + "\n";
+  text_ += "# TYPE " + name + " " + type + "\n";
+}
+
+void MetricsText::AddSample(const std::string &name,
+                            const MetricLabels &labels, const double value) {
+  AddSample(name, labels, FormatValue(value));
+}
+
+void MetricsText::AddHistogram(const std::string &name,
+                               const MetricLabels &labels,
+                               const LatencyHistogram &latencies) {
+  // The count first, so no bucket counts more than it while the histogram
+  // is being recorded into
+  auto count = latencies.GetCount();
+  auto bucket_labels = labels;
+  bucket_labels.emplace_back("le", "");
+  for (auto bucket_s : HISTOGRAM_BUCKETS_S) {
+    bucket_labels.back().second = FormatValue(bucket_s);
+    auto bucket_count = latencies.GetCountAtMost(bucket_s * 1000);
+    AddSample(name + "_bucket", bucket_labels,
+              FormatValue(std::min(bucket_count, count)));
+  }
+  bucket_labels.back().second = "+Inf";
+  AddSample(name + "_bucket", bucket_labels, FormatValue(count));
+  AddSample(name + "_sum", labels, latencies.GetSum() / 1000);
+  AddSample(name + "_count", labels, FormatValue(count));
+}
+
+void MetricsText::AddSample(const std::string &name,
+                            const MetricLabels &labels,
+                            const std::string &value) {
+  text_ += name;
+  if (labels.empty() == false) {
+    text_ += "{";
+    for (size_t label_idx = 0; label_idx < labels.size(); label_idx++) {
+      if (label_idx != 0) {
+        text_ += ",";
+      }
+      text_ += labels[label_idx].first + "=\"" +
+               EscapeLabelValue(labels[label_idx].second) + "\"";
+    }
+    text_ += "}";
+  }
+  text_ += " " + value + "\n";
+}
+
+//===--------------------------------------------------------------------===//
+// Metrics Exporter
+//===--------------------------------------------------------------------===//
+
+MetricsExporter::MetricsExporter()
+    : metrics_(std::make_shared<const std::string>()),
+      is_running_(false),
+      exporter_stop_(false) {}
+
+MetricsExporter::~MetricsExporter() {
+  if (IsRunning()) {
+    Stop();
+  }
+}
+
+MetricsExporter &MetricsExporter::GetInstance() {
+  static MetricsExporter metrics_exporter;
+  return metrics_exporter;
+}
+
+bool MetricsExporter::Start(const int port) {
+  PL_ASSERT(IsRunning() == false);
+  event_base_ = event_base_new();
+  http_ = event_base_ == nullptr ? nullptr : evhttp_new(event_base_);
+  if (http_ == nullptr ||
+      evhttp_bind_socket(http_, "0.0.0.0", port) != 0) {
+    LOG_ERROR("Cannot serve the metrics on port %d", port);
+    if (http_ != nullptr) {
+      evhttp_free(http_);
+      http_ = nullptr;
+    }
+    if (event_base_ != nullptr) {
+      event_base_free(event_base_);
+      event_base_ = nullptr;
+    }
+    return false;
+  }
+  evhttp_set_gencb(http_, MetricsExporter::HandleRequest, this);
+
+  // Set signal
+  exporter_stop_ = false;
+  is_running_ = true;
+
+  // Launch thread
+  exporter_thread_ = std::thread(&stats::MetricsExporter::Serve, this);
+
+  LOG_INFO("Serving the metrics on port %d", port);
+  return true;
+}
+
+void MetricsExporter::Serve() {
+  struct timeval stop_check_interval = {0, stop_check_interval_ms_ * 1000};
+  auto stop_check_event = event_new(event_base_, -1, EV_PERSIST,
+                                    MetricsExporter::CheckStop, this);
+  event_add(stop_check_event, &stop_check_interval);
+  event_base_dispatch(event_base_);
+  event_free(stop_check_event);
+}
+
+void MetricsExporter::Stop() {
+  // Stop serving
+  exporter_stop_ = true;
+
+  // Stop thread
+  exporter_thread_.join();
+  evhttp_free(http_);
+  http_ = nullptr;
+  event_base_free(event_base_);
+  event_base_ = nullptr;
+  is_running_ = false;
+
+  LOG_INFO("Stopped serving the metrics");
+}
+
+void MetricsExporter::Publish(std::shared_ptr<const std::string> metrics) {
+  std::atomic_store(&metrics_, metrics);
+}
+
+std::shared_ptr<const std::string> MetricsExporter::GetMetrics() const {
+  return std::atomic_load(&metrics_);
+}
+
+void MetricsExporter::HandleRequest(struct evhttp_request *request,
+                                    void *arg) {
+  auto exporter = static_cast<MetricsExporter *>(arg);
+  std::string path(evhttp_request_get_uri(request));
+  path = path.substr(0, path.find('?'));
+  if (evhttp_request_get_command(request) != EVHTTP_REQ_GET ||
+      path != "/metrics") {
+    evhttp_send_error(request, HTTP_NOTFOUND, nullptr);
+    return;
+  }
+
+  // The text stays alive until it is copied out, even if a newer one is
+  // published meanwhile
+  auto metrics = exporter->GetMetrics();
+  auto buffer = evbuffer_new();
+  evbuffer_add(buffer, metrics->data(), metrics->size());
+  evhttp_add_header(evhttp_request_get_output_headers(request),
+                    "Content-Type", "text/plain; version=0.0.4");
+  evhttp_send_reply(request, HTTP_OK, "OK", buffer);
+  evbuffer_free(buffer);
+}
+
+void MetricsExporter::CheckStop(int, short, void *arg) {
+  auto exporter = static_cast<MetricsExporter *>(arg);
+  if (exporter->exporter_stop_ == true) {
+    event_base_loopbreak(exporter->event_base_);
+  }
+}
+
+}  // namespace stats
+}  // namespace peloton
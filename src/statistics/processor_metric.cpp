@@ -12,6 +12,8 @@
 
 #include "statistics/processor_metric.h"
 
+#include "configuration/configuration.h"
+
 #ifndef RUSAGE_THREAD
 
 #include <mach/mach_init.h>
@@ -27,10 +29,24 @@ ProcessorMetric::ProcessorMetric(MetricType type) : AbstractMetric(type) {}
 
 void ProcessorMetric::StartTimer() {
   UpdateTimeInt(user_time_begin_, sys_time_begin_);
+  has_hardware_counters_ = false;
+  if (FLAGS_stats_hardware_counters) {
+    auto counters = HardwareCounters::GetInstance();
+    has_hardware_counters_ =
+        counters != nullptr && counters->Read(hardware_counters_begin_);
+    started_hardware_counters_ = counters;
+  }
 }
 
 void ProcessorMetric::RecordTime() {
   UpdateTimeInt(user_time_end_, sys_time_end_);
+  if (has_hardware_counters_) {
+    // The counters of another thread would not count the execution
+    auto counters = HardwareCounters::GetInstance();
+    has_hardware_counters_ = counters != nullptr &&
+                             counters == started_hardware_counters_ &&
+                             counters->Read(hardware_counters_end_);
+  }
 }
 
 double ProcessorMetric::GetMilliSec(struct timeval time) const {
@@ -70,6 +86,10 @@ const std::string ProcessorMetric::GetInfo() const {
   ss << "system time=" << GetSystemDuration();
   ss << ", user time=" << GetUserDuration();
   ss << " ]" << std::endl;
+  if (has_hardware_counters_) {
+    ss << "Query Hardware Counters: [ " << GetHardwareCounters().GetInfo();
+    ss << " ]" << std::endl;
+  }
   return ss.str();
 }
 
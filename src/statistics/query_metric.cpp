@@ -19,6 +19,24 @@
 namespace peloton {
 namespace stats {
 
+std::string QueryPhaseToString(QueryPhase phase) {
+  switch (phase) {
+    case QueryPhase::PARSE:
+      return "PARSE";
+    case QueryPhase::BIND:
+      return "BIND";
+    case QueryPhase::OPTIMIZE:
+      return "OPTIMIZE";
+    case QueryPhase::COMPILE:
+      return "COMPILE";
+    case QueryPhase::EXECUTE:
+      return "EXECUTE";
+    case QueryPhase::SEND:
+      return "SEND";
+  }
+  return "INVALID";
+}
+
 QueryMetric::QueryMetric(MetricType type, const std::string& query_name,
                          std::shared_ptr<QueryParams> query_params,
                          const oid_t database_id)
@@ -26,7 +44,7 @@ QueryMetric::QueryMetric(MetricType type, const std::string& query_name,
       database_id_(database_id),
       query_name_(query_name),
       query_params_(query_params) {
-  latency_metric_.StartTimer();
+  latency_timer_.StartTimer();
   processor_metric_.StartTimer();
   LOG_TRACE("Query metric initialized");
 }
@@ -45,5 +63,16 @@ QueryMetric::QueryParams::QueryParams(QueryParamBuf format_buf_copy,
 
 void QueryMetric::Aggregate(AbstractMetric& source UNUSED_ATTRIBUTE) {}
 
+const std::string QueryMetric::GetPhaseInfo() const {
+  std::stringstream ss;
+  ss << "latency_ms=" << latency_timer_.GetLatencyValue();
+  for (size_t phase_idx = 0; phase_idx < QUERY_PHASE_COUNT; phase_idx++) {
+    auto phase = static_cast<QueryPhase>(phase_idx);
+    ss << ", " << QueryPhaseToString(phase) << "="
+       << GetPhaseLatency(phase);
+  }
+  return ss.str();
+}
+
 }  // namespace stats
 }  // namespace peloton
@@ -12,21 +12,32 @@
 
 #include "statistics/stats_aggregator.h"
 
+#include <algorithm>
+
+#include "brain/workload_forecaster.h"
 #include "catalog/catalog.h"
 #include "catalog/database_metrics_catalog.h"
 #include "catalog/table_metrics_catalog.h"
 #include "catalog/index_metrics_catalog.h"
 #include "catalog/query_metrics_catalog.h"
+#include "common/maintenance_scheduler.h"
+#include "common/memory_tracker.h"
+#include "common/wait_events.h"
+#include "concurrency/contention_manager.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "gc/gc_manager_factory.h"
+#include "statistics/metrics_exporter.h"
 #include "storage/storage_manager.h"
 #include "type/ephemeral_pool.h"
+#include "wire/libevent_thread.h"
 
 namespace peloton {
 namespace stats {
 
 StatsAggregator::StatsAggregator(int64_t aggregation_interval_ms)
-    : stats_history_(0, false),
-      aggregated_stats_(LATENCY_MAX_HISTORY_AGGREGATOR, false),
+    : stats_history_(false),
+      aggregated_stats_(false),
       aggregation_interval_ms_(aggregation_interval_ms),
       thread_number_(0),
       total_prev_txn_committed_(0) {
@@ -42,6 +53,12 @@ StatsAggregator::StatsAggregator(int64_t aggregation_interval_ms)
 StatsAggregator::~StatsAggregator() {
   LOG_DEBUG("StatsAggregator destruction");
   ShutdownAggregator();
+  auto registered_context = registered_contexts_.load();
+  while (registered_context != nullptr) {
+    auto next = registered_context->next;
+    delete registered_context;
+    registered_context = next;
+  }
   try {
     ofs_.close();
   } catch (std::ofstream::failure &e) {
@@ -77,15 +94,34 @@ void StatsAggregator::Aggregate(int64_t &interval_cnt, double &alpha,
   aggregated_stats_.Reset();
   std::thread::id this_id = aggregator_thread_.get_id();
 
-  for (auto &val : backend_stats_) {
-    // Exclude the txn stats generated by the aggregator thread
-    if (val.first != this_id) {
-      aggregated_stats_.Aggregate((*val.second));
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    for (auto registered_context = registered_contexts_.load();
+         registered_context != nullptr;
+         registered_context = registered_context->next) {
+      // Exclude the txn stats generated by the aggregator thread
+      if (registered_context->is_unregistered == false &&
+          registered_context->thread_id != this_id) {
+        aggregated_stats_.Aggregate(*registered_context->context);
+      }
     }
+    aggregated_stats_.Aggregate(stats_history_);
   }
-  aggregated_stats_.Aggregate(stats_history_);
+  aggregated_stats_.ComputeLatencies();
   LOG_TRACE("%s\n", aggregated_stats_.ToString().c_str());
 
+  // The background maintenance holds back while the queries are slow
+  double query_p99_ms = 0;
+  uint64_t query_count = 0;
+  for (auto query_type : {"SELECT", "INSERT", "UPDATE", "DELETE", "OTHER"}) {
+    auto &measurements = aggregated_stats_.GetQueryLatencyMetric(query_type)
+                             .GetLatencyMeasurements();
+    query_p99_ms = std::max(query_p99_ms, measurements.perc_99th_);
+    query_count += measurements.count_;
+  }
+  MaintenanceScheduler::GetInstance().RecordQueryLatency(query_p99_ms,
+                                                         query_count);
+
   int64_t current_txns_committed = 0;
   // Traverse the metric of all threads to get the total number of committed
   // txns.
@@ -111,8 +147,23 @@ void StatsAggregator::Aggregate(int64_t &interval_cnt, double &alpha,
   LOG_TRACE("Moving avg. throughput: %lf txn/s", weighted_avg_throughput);
   LOG_TRACE("Current throughput:     %lf txn/s", throughput_);
 
-  // Write the stats to metric tables
-  UpdateMetrics();
+  // Write the stats to metric tables every few intervals, so that the writes
+  // are batched into one txn and few tuples
+  SampleQueryMetrics();
+  int64_t forecast_intervals = std::max<int64_t>(
+      FLAGS_workload_forecast_interval_s * 1000 / STATS_AGGREGATION_INTERVAL_MS,
+      1);
+  if (interval_cnt % forecast_intervals == 0) {
+    brain::WorkloadForecaster::GetInstance().FinishInterval();
+  }
+  if (MetricsExporter::GetInstance().IsRunning()) {
+    PublishMetrics(throughput_);
+  }
+  int64_t flush_intervals =
+      std::max<int64_t>(FLAGS_stats_flush_intervals, 1);
+  if (interval_cnt % flush_intervals == 0) {
+    UpdateMetrics();
+  }
 
   if (interval_cnt % STATS_LOG_INTERVALS == 0) {
     try {
@@ -121,29 +172,273 @@ void StatsAggregator::Aggregate(int64_t &interval_cnt, double &alpha,
       ofs_ << "Weighted avg. throughput=" << weighted_avg_throughput
            << std::endl;
       ofs_ << "Average throughput=" << avg_throughput_ << std::endl;
-      ofs_ << "Current throughput=" << throughput_;
+      ofs_ << "Current throughput=" << throughput_ << std::endl;
+      ofs_ << "Compiled queries=" << compiled_query_count_
+           << ", compile_ms=" << total_compile_ms_
+           << ", execute_ms=" << total_compiled_execute_ms_;
+      for (auto &shape_item : query_shape_counters_) {
+        ofs_ << std::endl << "Queries=" << shape_item.second.query_count
+             << ", " << shape_item.second.counters.GetInfo()
+             << ": " << shape_item.first;
+      }
+      query_shape_counters_.clear();
+      for (auto &slow_query_trace : slow_query_traces_) {
+        ofs_ << std::endl << "Slow query " << slow_query_trace;
+      }
+      slow_query_traces_.clear();
+      LogWaitEvents();
     } catch (std::ofstream::failure &e) {
       LOG_ERROR("Error when writing to the stats log file %s", e.what());
     }
   }
 }
 
+void StatsAggregator::LogWaitEvents() {
+  auto wait_totals = WaitEvents::GetTotals();
+  for (size_t type_idx = 0; type_idx < WAIT_EVENT_TYPE_COUNT; type_idx++) {
+    if (wait_totals.wait_counts[type_idx] == 0) {
+      continue;
+    }
+    ofs_ << std::endl << "Waits=" << wait_totals.wait_counts[type_idx]
+         << ", wait_us=" << wait_totals.wait_us[type_idx] << ", event="
+         << WaitEventTypeToString(static_cast<WaitEventType>(type_idx));
+  }
+
+  auto abort_counts =
+      concurrency::ContentionManager::GetInstance().GetAbortCounts();
+  for (auto &abort_item : abort_counts) {
+    ofs_ << std::endl << "Aborts=" << abort_item.second
+         << ", table_oid=" << abort_item.first.first
+         << ", conflict=" << ConflictTypeToString(abort_item.first.second);
+  }
+  ofs_ << std::endl;
+}
+
+void StatsAggregator::PublishMetrics(double throughput) {
+  MetricsText metrics;
+
+  int64_t txn_committed = 0;
+  int64_t txn_aborted = 0;
+  for (auto &database_item : aggregated_stats_.database_metrics_) {
+    txn_committed += database_item.second->GetTxnCommitted().GetCounter();
+    txn_aborted += database_item.second->GetTxnAborted().GetCounter();
+  }
+  metrics.AddFamily("peloton_txn_committed_total", "counter",
+                    "Transactions committed");
+  metrics.AddSample("peloton_txn_committed_total", {}, txn_committed);
+  metrics.AddFamily("peloton_txn_aborted_total", "counter",
+                    "Transactions aborted");
+  metrics.AddSample("peloton_txn_aborted_total", {}, txn_aborted);
+  metrics.AddFamily("peloton_txn_throughput", "gauge",
+                    "Transactions committed per second in the last interval");
+  metrics.AddSample("peloton_txn_throughput", {}, throughput);
+
+  metrics.AddFamily("peloton_txn_latency_seconds", "histogram",
+                    "Latency of transactions");
+  metrics.AddHistogram("peloton_txn_latency_seconds", {},
+                       aggregated_stats_.GetTxnLatencyMetric().GetLatencies());
+  metrics.AddFamily("peloton_commit_latency_seconds", "histogram",
+                    "Latency of the commits of transactions that wrote");
+  metrics.AddHistogram(
+      "peloton_commit_latency_seconds", {},
+      aggregated_stats_.GetCommitLatencyMetric().GetLatencies());
+
+  // The statement types BackendStatsContext records apart
+  metrics.AddFamily("peloton_query_latency_seconds", "histogram",
+                    "Latency of queries by statement type");
+  for (auto query_type : {"SELECT", "INSERT", "UPDATE", "DELETE", "OTHER"}) {
+    metrics.AddHistogram(
+        "peloton_query_latency_seconds", {{"type", query_type}},
+        aggregated_stats_.GetQueryLatencyMetric(query_type).GetLatencies());
+  }
+
+  metrics.AddFamily("peloton_compiled_queries_total", "counter",
+                    "Completed queries that ran as compiled code");
+  metrics.AddSample("peloton_compiled_queries_total", {},
+                    compiled_query_count_);
+
+  metrics.AddFamily("peloton_aborts_total", "counter",
+                    "Transactions aborted by table and conflict");
+  auto abort_counts =
+      concurrency::ContentionManager::GetInstance().GetAbortCounts();
+  for (auto &abort_item : abort_counts) {
+    metrics.AddSample(
+        "peloton_aborts_total",
+        {{"table_oid", std::to_string(abort_item.first.first)},
+         {"conflict", ConflictTypeToString(abort_item.first.second)}},
+        abort_item.second);
+  }
+
+  auto wait_totals = WaitEvents::GetTotals();
+  MetricsText wait_time_metrics;
+  metrics.AddFamily("peloton_wait_events_total", "counter",
+                    "Waits of all threads by what they waited for");
+  wait_time_metrics.AddFamily(
+      "peloton_wait_seconds_total", "counter",
+      "Time waited by all threads by what they waited for");
+  for (size_t type_idx = 0; type_idx < WAIT_EVENT_TYPE_COUNT; type_idx++) {
+    MetricLabels labels = {
+        {"event", WaitEventTypeToString(static_cast<WaitEventType>(type_idx))}};
+    metrics.AddSample("peloton_wait_events_total", labels,
+                      wait_totals.wait_counts[type_idx]);
+    wait_time_metrics.AddSample("peloton_wait_seconds_total", labels,
+                                wait_totals.wait_us[type_idx] / 1000000.0);
+  }
+
+  metrics.AddFamily("peloton_gc_backlog", "gauge",
+                    "Garbage contexts waiting to be unlinked or reclaimed");
+  metrics.AddSample("peloton_gc_backlog", {},
+                    gc::GCManagerFactory::GetInstance().GetBacklog());
+
+  metrics.AddFamily("peloton_gc_reclaimed_versions_total", "counter",
+                    "Versions reclaimed by the garbage collector");
+  metrics.AddSample(
+      "peloton_gc_reclaimed_versions_total", {},
+      gc::GCManagerFactory::GetInstance().GetReclaimedVersionCount());
+
+  metrics.AddFamily("peloton_connections", "gauge", "Open connections");
+  metrics.AddSample("peloton_connections", {},
+                    wire::LibeventThread::GetTotalConnectionCount());
+
+  metrics.AddFamily("peloton_memory_bytes", "gauge",
+                    "Memory charged to every tracked component");
+  for (size_t type = 0; type < MEMORY_COMPONENT_TYPE_COUNT; type++) {
+    auto component = static_cast<MemoryComponentType>(type);
+    if (component == MemoryComponentType::INDEX ||
+        component == MemoryComponentType::VERSION_CHAIN) {
+      continue;
+    }
+    metrics.AddSample("peloton_memory_bytes",
+                      {{"component", MemoryComponentTypeToString(component)}},
+                      MemoryTracker::GetAllocatedBytes(component));
+  }
+
+  // The tile groups and the memory of the indexes of every table
+  MetricsText storage_metrics;
+  storage_metrics.AddFamily("peloton_index_memory_bytes", "gauge",
+                            "Memory used by indexes");
+  metrics.AddFamily("peloton_tile_groups", "gauge", "Tile groups of tables");
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto database_count = storage_manager->GetDatabaseCount();
+  for (oid_t database_offset = 0; database_offset < database_count;
+       database_offset++) {
+    auto database = storage_manager->GetDatabaseWithOffset(database_offset);
+    auto database_oid = std::to_string(database->GetOid());
+    auto table_count = database->GetTableCount();
+    for (oid_t table_offset = 0; table_offset < table_count; table_offset++) {
+      auto table = database->GetTable(table_offset);
+      auto table_oid = std::to_string(table->GetOid());
+      metrics.AddSample("peloton_tile_groups",
+                        {{"database_oid", database_oid},
+                         {"table_oid", table_oid}},
+                        table->GetTileGroupCount());
+
+      auto index_count = table->GetIndexCount();
+      for (oid_t index_offset = 0; index_offset < index_count;
+           index_offset++) {
+        auto index = table->GetIndex(index_offset);
+        if (index == nullptr) continue;
+        storage_metrics.AddSample(
+            "peloton_index_memory_bytes",
+            {{"database_oid", database_oid},
+             {"table_oid", table_oid},
+             {"index_oid", std::to_string(index->GetOid())}},
+            index->GetMemoryFootprint());
+      }
+    }
+  }
+
+  MetricsExporter::GetInstance().Publish(std::make_shared<const std::string>(
+      metrics.GetText() + wait_time_metrics.GetText() +
+      storage_metrics.GetText()));
+}
+
+void StatsAggregator::SampleQueryMetrics() {
+  std::shared_ptr<QueryMetric> query_metric;
+  auto &completed_query_metrics = aggregated_stats_.GetCompletedQueryMetrics();
+  auto &workload_forecaster = brain::WorkloadForecaster::GetInstance();
+  double query_count =
+      std::max<uint64_t>(FLAGS_stats_query_sample_interval, 1);
+  while (completed_query_metrics.Dequeue(query_metric)) {
+    // Count the arrivals of the shape, a measured query stands for the ones
+    // that were not
+    workload_forecaster.RecordQuery(query_metric->GetName(), query_count);
+
+    // Sum up the queries that ran as compiled code
+    const auto &codegen_info = query_metric->GetCodegenInfo();
+    if (codegen_info.compiled) {
+      compiled_query_count_++;
+      total_compile_ms_ += codegen_info.compile_ms;
+      total_compiled_execute_ms_ += codegen_info.execute_ms;
+    }
+
+    // Sum up the hardware counters of the queries of the same shape
+    const auto &processor_metric = query_metric->GetProcessorMetric();
+    if (processor_metric.HasHardwareCounters()) {
+      auto shape_itr = query_shape_counters_.find(query_metric->GetName());
+      if (shape_itr == query_shape_counters_.end() &&
+          query_shape_counters_.size() < STATS_MAX_QUERY_SHAPES) {
+        shape_itr = query_shape_counters_.emplace(query_metric->GetName(),
+                                                  QueryShapeCounters()).first;
+      }
+      if (shape_itr != query_shape_counters_.end()) {
+        shape_itr->second.query_count++;
+        shape_itr->second.counters.Add(processor_metric.GetHardwareCounters());
+      }
+    }
+
+    // Keep the phases of the slow queries for the stats log
+    auto slow_query_ms = FLAGS_stats_slow_query_ms;
+    if (slow_query_ms != 0 &&
+        query_metric->GetQueryLatency().GetLatencyValue() >= slow_query_ms &&
+        slow_query_traces_.size() < STATS_MAX_SLOW_QUERIES) {
+      slow_query_traces_.push_back(query_metric->GetPhaseInfo() + ": " +
+                                   query_metric->GetName());
+    }
+
+    // Keep every query equally likely to be sampled (reservoir sampling)
+    completed_query_count_++;
+    size_t sample_size = FLAGS_stats_query_metrics_per_flush;
+    if (sample_size == 0 || sampled_query_metrics_.size() < sample_size) {
+      sampled_query_metrics_.push_back(std::move(query_metric));
+      continue;
+    }
+    std::uniform_int_distribution<uint64_t> distribution(
+        0, completed_query_count_ - 1);
+    auto sample_idx = distribution(random_generator_);
+    if (sample_idx < sample_size) {
+      sampled_query_metrics_[sample_idx] = std::move(query_metric);
+    }
+  }
+}
+
+bool StatsAggregator::AddChangedCounters(oid_t oid,
+                                         std::vector<int64_t> counters,
+                                         CounterList &written_counters) const {
+  auto itr = written_counters_.find(oid);
+  if (itr != written_counters_.end() && itr->second == counters) {
+    return false;
+  }
+  written_counters.emplace_back(oid, std::move(counters));
+  return true;
+}
+
 void StatsAggregator::UpdateQueryMetrics(int64_t time_stamp,
                                          concurrency::Transaction *txn) {
   // Get the target query metrics table
   LOG_TRACE("Inserting Query Metric Tuples");
-  // auto query_metrics_table = GetMetricTable(QUERY_METRIC_NAME);
+  auto query_metrics_catalog = catalog::QueryMetricsCatalog::GetInstance();
 
-  std::shared_ptr<QueryMetric> query_metric;
-  auto &completed_query_metrics = aggregated_stats_.GetCompletedQueryMetrics();
-  while (completed_query_metrics.Dequeue(query_metric)) {
+  std::vector<std::unique_ptr<storage::Tuple>> query_tuples;
+  query_tuples.reserve(sampled_query_metrics_.size());
+  for (auto &query_metric : sampled_query_metrics_) {
     // Get physical stats
     auto table_access = query_metric->GetQueryAccess();
     auto reads = table_access.GetReads();
     auto updates = table_access.GetUpdates();
     auto deletes = table_access.GetDeletes();
     auto inserts = table_access.GetInserts();
-    auto latency = query_metric->GetQueryLatency().GetFirstLatencyValue();
+    auto latency = query_metric->GetQueryLatency().GetLatencyValue();
     auto cpu_system = query_metric->GetProcessorMetric().GetSystemDuration();
     auto cpu_user = query_metric->GetProcessorMetric().GetUserDuration();
 
@@ -162,26 +457,29 @@ void StatsAggregator::UpdateQueryMetrics(int64_t time_stamp,
       PL_ASSERT(num_params > 0);
     }
 
-    // Generate and insert the tuple
-    // auto query_tuple = catalog::GetQueryMetricsCatalogTuple(
-    //     query_metrics_table->GetSchema(), query_metric->GetName(),
-    //     query_metric->GetDatabaseId(), num_params, type_buf, format_buf,
-    //     value_buf, reads, updates, deletes, inserts, (int64_t)latency,
-    //     (int64_t)(cpu_system + cpu_user), time_stamp, pool_.get());
-    // catalog::InsertTuple(query_metrics_table, std::move(query_tuple), txn);
-
-    catalog::QueryMetricsCatalog::GetInstance()->InsertQueryMetrics(
+    // Generate the tuple
+    query_tuples.push_back(query_metrics_catalog->GetQueryMetricsTuple(
         query_metric->GetName(), query_metric->GetDatabaseId(), num_params,
         type_buf, format_buf, value_buf, reads, updates, deletes, inserts,
         (int64_t)latency, (int64_t)(cpu_system + cpu_user), time_stamp,
-        pool_.get(), txn);
+        pool_.get()));
+  }
+
+  // Append them in bulk
+  if (query_tuples.empty() == false) {
+    query_metrics_catalog->InsertQueryMetrics(std::move(query_tuples), txn);
+    LOG_TRACE("Query Metric Tuples inserted");
+  }
 
-    LOG_TRACE("Query Metric Tuple inserted");
+  if (FLAGS_stats_query_metrics_retention > 0) {
+    query_metrics_catalog->DeleteQueryMetricsBefore(
+        time_stamp - static_cast<int64_t>(FLAGS_stats_query_metrics_retention),
+        txn);
   }
 }
 
 void StatsAggregator::UpdateMetrics() {
-  // All tuples are inserted in a single txn
+  // All tuples are written in a single txn
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
 
@@ -193,6 +491,9 @@ void StatsAggregator::UpdateMetrics() {
   auto time_stamp = std::chrono::duration_cast<std::chrono::seconds>(
                         time_since_epoch).count();
 
+  // The counters written by this txn, remembered once it commits
+  CounterList written_counters;
+
   auto database_count = storage_manager->GetDatabaseCount();
   for (oid_t database_offset = 0; database_offset < database_count;
        database_offset++) {
@@ -205,22 +506,48 @@ void StatsAggregator::UpdateMetrics() {
     auto txn_committed = database_metric->GetTxnCommitted().GetCounter();
     auto txn_aborted = database_metric->GetTxnAborted().GetCounter();
 
-    catalog::DatabaseMetricsCatalog::GetInstance()->InsertDatabaseMetrics(
-        database_oid, txn_committed, txn_aborted, time_stamp, pool_.get(), txn);
-    LOG_TRACE("DB Metric Tuple inserted");
+    if (AddChangedCounters(database_oid, {txn_committed, txn_aborted},
+                           written_counters)) {
+      auto database_metrics_catalog =
+          catalog::DatabaseMetricsCatalog::GetInstance();
+      database_metrics_catalog->DeleteDatabaseMetrics(database_oid, txn);
+      database_metrics_catalog->InsertDatabaseMetrics(
+          database_oid, txn_committed, txn_aborted, time_stamp, pool_.get(),
+          txn);
+      LOG_TRACE("DB Metric Tuple inserted");
+    }
 
     // Update all the indices of this database
-    UpdateTableMetrics(database, time_stamp, txn);
+    UpdateTableMetrics(database, time_stamp, written_counters, txn);
   }
 
   // Update all query metrics
   UpdateQueryMetrics(time_stamp, txn);
 
-  txn_manager.CommitTransaction(txn);
+  if (txn->GetResult() != ResultType::SUCCESS) {
+    LOG_DEBUG("Failed to write the metrics tables, retrying on the next write");
+    txn_manager.AbortTransaction(txn);
+    return;
+  }
+  if (txn_manager.CommitTransaction(txn) != ResultType::SUCCESS) {
+    LOG_DEBUG("Failed to write the metrics tables, retrying on the next write");
+    return;
+  }
+
+  for (auto &counters : written_counters) {
+    written_counters_[counters.first] = std::move(counters.second);
+  }
+  if (completed_query_count_ > sampled_query_metrics_.size()) {
+    LOG_DEBUG("Sampled %lu of %lu completed queries",
+              sampled_query_metrics_.size(), completed_query_count_);
+  }
+  sampled_query_metrics_.clear();
+  completed_query_count_ = 0;
 }
 
 void StatsAggregator::UpdateTableMetrics(storage::Database *database,
                                          int64_t time_stamp,
+                                         CounterList &written_counters,
                                          concurrency::Transaction *txn) {
   // Update table metrics table for each of the indices
   auto database_oid = database->GetOid();
@@ -236,18 +563,24 @@ void StatsAggregator::UpdateTableMetrics(storage::Database *database,
     auto deletes = table_access.GetDeletes();
     auto inserts = table_access.GetInserts();
 
-    catalog::TableMetricsCatalog::GetInstance()->InsertTableMetrics(
-        database_oid, table_oid, reads, updates, deletes, inserts, time_stamp,
-        pool_.get(), txn);
-    LOG_TRACE("Table Metric Tuple inserted");
+    if (AddChangedCounters(table_oid, {reads, updates, deletes, inserts},
+                           written_counters)) {
+      auto table_metrics_catalog = catalog::TableMetricsCatalog::GetInstance();
+      table_metrics_catalog->DeleteTableMetrics(table_oid, txn);
+      table_metrics_catalog->InsertTableMetrics(
+          database_oid, table_oid, reads, updates, deletes, inserts,
+          time_stamp, pool_.get(), txn);
+      LOG_TRACE("Table Metric Tuple inserted");
+    }
 
-    UpdateIndexMetrics(database, table, time_stamp, txn);
+    UpdateIndexMetrics(database, table, time_stamp, written_counters, txn);
   }
 }
 
 void StatsAggregator::UpdateIndexMetrics(storage::Database *database,
                                          storage::DataTable *table,
                                          int64_t time_stamp,
+                                         CounterList &written_counters,
                                          concurrency::Transaction *txn) {
   // Update index metrics table for each of the indices
   auto database_oid = database->GetOid();
@@ -260,14 +593,34 @@ void StatsAggregator::UpdateIndexMetrics(storage::Database *database,
     auto index_metric =
         aggregated_stats_.GetIndexMetric(database_oid, table_oid, index_oid);
 
+    // The structure counters are kept by the index rather than by the
+    // backends
+    index_metric->SetStructureStats(index->GetStructureStats());
+
     auto index_access = index_metric->GetIndexAccess();
     auto reads = index_access.GetReads();
     auto deletes = index_access.GetDeletes();
     auto inserts = index_access.GetInserts();
 
-    catalog::IndexMetricsCatalog::GetInstance()->InsertIndexMetrics(
+    if (AddChangedCounters(
+            index_oid,
+            {reads, deletes, inserts, index_metric->GetConsolidations(),
+             index_metric->GetSplits(), index_metric->GetMerges(),
+             index_metric->GetCASFailures(), index_metric->GetEpochs(),
+             index_metric->GetGarbageNodes(),
+             index_metric->GetDeltaChainThreshold()},
+            written_counters) == false) {
+      continue;
+    }
+
+    auto index_metrics_catalog = catalog::IndexMetricsCatalog::GetInstance();
+    index_metrics_catalog->DeleteIndexMetrics(index_oid, txn);
+    index_metrics_catalog->InsertIndexMetrics(
         database_oid, table_oid, index_oid, reads, deletes, inserts, time_stamp,
-        pool_.get(), txn);
+        index_metric->GetConsolidations(), index_metric->GetSplits(),
+        index_metric->GetMerges(), index_metric->GetCASFailures(),
+        index_metric->GetEpochs(), index_metric->GetGarbageNodes(),
+        index_metric->GetDeltaChainThreshold(), pool_.get(), txn);
   }
 }
 
@@ -301,15 +654,14 @@ StatsAggregator &StatsAggregator::GetInstance(int64_t aggregation_interval_ms) {
 // Aggregator
 void StatsAggregator::RegisterContext(std::thread::id id_,
                                       BackendStatsContext *context_) {
-  {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-
-    PL_ASSERT(backend_stats_.find(id_) == backend_stats_.end());
-
-    thread_number_++;
-    backend_stats_[id_] = context_;
+  auto registered_context =
+      new RegisteredContext{id_, context_, false, registered_contexts_.load()};
+  while (registered_contexts_.compare_exchange_weak(
+             registered_context->next, registered_context) == false) {
   }
-  LOG_DEBUG("Stats aggregator hash map size: %ld", backend_stats_.size());
+  thread_number_++;
+  LOG_DEBUG("Stats aggregator registered contexts: %d",
+            thread_number_.load());
 }
 
 // Unregister a BackendStatsContext. Currently we directly reuse the thread id
@@ -318,13 +670,18 @@ void StatsAggregator::UnregisterContext(std::thread::id id) {
   {
     std::lock_guard<std::mutex> lock(stats_mutex_);
 
-    if (backend_stats_.find(id) != backend_stats_.end()) {
-      stats_history_.Aggregate(*backend_stats_[id]);
-      backend_stats_.erase(id);
-      thread_number_--;
-    } else {
-      LOG_DEBUG("stats_context already deleted!");
+    for (auto registered_context = registered_contexts_.load();
+         registered_context != nullptr;
+         registered_context = registered_context->next) {
+      if (registered_context->is_unregistered == false &&
+          registered_context->thread_id == id) {
+        stats_history_.Aggregate(*registered_context->context);
+        registered_context->is_unregistered = true;
+        thread_number_--;
+        return;
+      }
     }
+    LOG_DEBUG("stats_context already deleted!");
   }
 }
 
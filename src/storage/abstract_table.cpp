@@ -17,6 +17,7 @@
 #include "common/exception.h"
 #include "common/logger.h"
 #include "index/index.h"
+#include "statistics/access_counter_slab.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_factory.h"
 #include "util/stringbox_util.h"
@@ -26,7 +27,10 @@ namespace storage {
 
 AbstractTable::AbstractTable(id_t table_oid, catalog::Schema *schema,
                              bool own_schema)
-    : table_oid(table_oid), schema(schema), own_schema_(own_schema) {}
+    : table_oid(table_oid),
+      schema(schema),
+      own_schema_(own_schema),
+      stats_slot_id_(stats::AccessCounterSlab::GetNextSlotId()) {}
 
 AbstractTable::~AbstractTable() {
   // clean up schema
@@ -66,7 +70,7 @@ column_map_type AbstractTable::GetTileGroupLayout(
 
 TileGroup *AbstractTable::GetTileGroupWithLayout(
     oid_t database_id, oid_t tile_group_id, const column_map_type &partitioning,
-    const size_t num_tuples) {
+    const size_t num_tuples, const int numa_node) {
   std::vector<catalog::Schema> schemas;
 
   // Figure out the columns in each tile in new layout
@@ -87,7 +91,8 @@ TileGroup *AbstractTable::GetTileGroupWithLayout(
 
   TileGroup *tile_group =
       TileGroupFactory::GetTileGroup(database_id, GetOid(), tile_group_id, this,
-                                     schemas, partitioning, num_tuples);
+                                     schemas, partitioning, num_tuples,
+                                     numa_node);
 
   return tile_group;
 }
@@ -98,9 +103,10 @@ const std::string AbstractTable::GetInfo() const {
   oid_t tuple_count = 0;
   for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
        tile_group_itr++) {
-    if (tile_group_itr > 0) inner << std::endl;
-
     auto tile_group = this->GetTileGroup(tile_group_itr);
+    if (tile_group == nullptr) continue;
+
+    if (tile_group_itr > 0) inner << std::endl;
     auto tile_tuple_count = tile_group->GetNextTupleSlot();
 
     std::string tileData = tile_group->GetInfo();
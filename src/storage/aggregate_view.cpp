@@ -0,0 +1,601 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregate_view.cpp
+//
+// Identification: src/storage/aggregate_view.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/aggregate_view.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/container_tuple.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Aggregate View
+//===--------------------------------------------------------------------===//
+
+static bool IsIntegerType(const type::TypeId type_id) {
+  return type_id == type::TypeId::TINYINT ||
+         type_id == type::TypeId::SMALLINT ||
+         type_id == type::TypeId::INTEGER || type_id == type::TypeId::BIGINT;
+}
+
+AggregateView::AggregateView(const std::string &name, DataTable *table,
+                             const std::vector<oid_t> &group_column_ids,
+                             const std::vector<oid_t> &aggregate_column_ids)
+    : name(name),
+      table(table),
+      group_column_ids(group_column_ids),
+      aggregate_column_ids(aggregate_column_ids),
+      is_ready(false),
+      is_valid(true) {
+  auto schema = table->GetSchema();
+  for (auto column_id : aggregate_column_ids) {
+    is_integer_column.push_back(IsIntegerType(schema->GetType(column_id)));
+  }
+}
+
+oid_t AggregateView::GetGroupOffset(const oid_t column_id) const {
+  auto itr =
+      std::find(group_column_ids.begin(), group_column_ids.end(), column_id);
+  if (itr == group_column_ids.end()) {
+    return INVALID_OID;
+  }
+  return static_cast<oid_t>(itr - group_column_ids.begin());
+}
+
+oid_t AggregateView::GetAggregateOffset(const oid_t column_id) const {
+  auto itr = std::find(aggregate_column_ids.begin(),
+                       aggregate_column_ids.end(), column_id);
+  if (itr == aggregate_column_ids.end()) {
+    return INVALID_OID;
+  }
+  return static_cast<oid_t>(itr - aggregate_column_ids.begin());
+}
+
+void AggregateView::AddTuple(GroupMap &groups, const AbstractTuple *tuple,
+                             const int sign) const {
+  // The keys outlive the version they were read from
+  std::vector<type::Value> key;
+  for (auto column_id : group_column_ids) {
+    key.push_back(tuple->GetValue(column_id).Copy());
+  }
+
+  auto &group = groups[key];
+  size_t aggregate_count = aggregate_column_ids.size();
+  if (group.value_counts.empty() && aggregate_count > 0) {
+    group.value_counts.resize(aggregate_count, 0);
+    for (size_t offset = 0; offset < aggregate_count; offset++) {
+      group.sums.push_back(is_integer_column[offset]
+                               ? type::ValueFactory::GetBigIntValue(0)
+                               : type::ValueFactory::GetDecimalValue(0));
+    }
+  }
+
+  group.row_count += sign;
+  for (size_t offset = 0; offset < aggregate_count; offset++) {
+    auto value = tuple->GetValue(aggregate_column_ids[offset]);
+    if (value.IsNull() == true) {
+      continue;
+    }
+    auto sum_value = value.CastAs(is_integer_column[offset]
+                                      ? type::TypeId::BIGINT
+                                      : type::TypeId::DECIMAL);
+    group.value_counts[offset] += sign;
+    group.sums[offset] = (sign > 0) ? group.sums[offset].Add(sum_value)
+                                    : group.sums[offset].Subtract(sum_value);
+  }
+}
+
+void AggregateView::MergeGroups(GroupMap &groups, const GroupMap &delta) {
+  for (auto &delta_group : delta) {
+    auto itr = groups.find(delta_group.first);
+    if (itr == groups.end()) {
+      itr = groups.emplace(delta_group.first, delta_group.second).first;
+    } else {
+      auto &group = itr->second;
+      group.row_count += delta_group.second.row_count;
+      for (size_t offset = 0; offset < group.value_counts.size(); offset++) {
+        group.value_counts[offset] += delta_group.second.value_counts[offset];
+        group.sums[offset] =
+            group.sums[offset].Add(delta_group.second.sums[offset]);
+      }
+    }
+
+    if (itr->second.row_count == 0) {
+      groups.erase(itr);
+    }
+  }
+}
+
+void AggregateView::AddDelta(const cid_t commit_id, GroupMap &&delta) {
+  std::lock_guard<std::mutex> lock(view_mutex);
+  deltas.push_back({commit_id, std::move(delta)});
+}
+
+void AggregateView::SetBase(const cid_t commit_id, GroupMap &&groups) {
+  std::lock_guard<std::mutex> lock(view_mutex);
+
+  // The scan saw the versions of these commits already
+  deltas.erase(std::remove_if(deltas.begin(), deltas.end(),
+                              [commit_id](const Delta &delta) {
+                                return delta.commit_id <= commit_id;
+                              }),
+               deltas.end());
+
+  base_groups = std::move(groups);
+  base_cid = commit_id;
+  is_ready = true;
+}
+
+size_t AggregateView::FoldDeltas(const cid_t expired_cid) {
+  std::lock_guard<std::mutex> lock(view_mutex);
+  if (is_ready == false || expired_cid <= base_cid) {
+    return 0;
+  }
+
+  // No transaction that reads before the expired commit id runs anymore
+  auto folded = std::stable_partition(
+      deltas.begin(), deltas.end(), [expired_cid](const Delta &delta) {
+        return delta.commit_id > expired_cid;
+      });
+  size_t folded_count = std::distance(folded, deltas.end());
+  for (auto itr = folded; itr != deltas.end(); itr++) {
+    MergeGroups(base_groups, itr->groups);
+  }
+  deltas.erase(folded, deltas.end());
+  base_cid = expired_cid;
+
+  return folded_count;
+}
+
+bool AggregateView::GetGroups(concurrency::Transaction *txn,
+                              GroupMap &groups) {
+  if (is_ready == false || is_valid == false) {
+    return false;
+  }
+
+  // The changes of the transaction itself are only captured at commit
+  auto &manager = catalog::Manager::GetInstance();
+  for (auto &rw_entry : txn->GetReadWriteSet()) {
+    if (rw_entry.type == RWType::READ || rw_entry.type == RWType::READ_OWN) {
+      continue;
+    }
+    auto tile_group = manager.ResolveTileGroup(rw_entry.location.block);
+    if (tile_group != nullptr && tile_group->GetAbstractTable() == table) {
+      return false;
+    }
+  }
+  for (auto &bulk_entry : txn->GetBulkInsertSet()) {
+    auto tile_group = manager.ResolveTileGroup(bulk_entry.first);
+    if (tile_group != nullptr && tile_group->GetAbstractTable() == table) {
+      return false;
+    }
+  }
+  for (auto tile_group_id : txn->GetDeletedTileGroupSet()) {
+    auto tile_group = manager.ResolveTileGroup(tile_group_id);
+    if (tile_group != nullptr && tile_group->GetAbstractTable() == table) {
+      return false;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(view_mutex);
+  auto read_id = txn->GetReadId();
+  if (read_id <= base_cid) {
+    return false;
+  }
+
+  groups = base_groups;
+  for (auto &delta : deltas) {
+    if (delta.commit_id <= read_id) {
+      MergeGroups(groups, delta.groups);
+    }
+  }
+  return true;
+}
+
+size_t AggregateView::GetDeltaCount() {
+  std::lock_guard<std::mutex> lock(view_mutex);
+  return deltas.size();
+}
+
+//===--------------------------------------------------------------------===//
+// Aggregate View Manager
+//===--------------------------------------------------------------------===//
+
+AggregateViewManager &AggregateViewManager::GetInstance() {
+  static AggregateViewManager aggregate_view_manager;
+  return aggregate_view_manager;
+}
+
+AggregateViewManager::AggregateViewManager() : view_count(0) {}
+
+AggregateViewManager::~AggregateViewManager() { StopAll(); }
+
+bool AggregateViewManager::CreateView(
+    const std::string &name, DataTable *table,
+    const std::vector<oid_t> &group_column_ids,
+    const std::vector<oid_t> &aggregate_column_ids) {
+  std::shared_ptr<AggregateView> view(
+      new AggregateView(name, table, group_column_ids, aggregate_column_ids));
+
+  // The view captures the deltas of the commits from now on
+  {
+    std::lock_guard<std::mutex> lock(manager_mutex);
+    if (views.find(name) != views.end()) {
+      return false;
+    }
+    views[name] = view;
+    table_views[table].push_back(view);
+    view_count++;
+  }
+
+  std::unique_ptr<ViewBuild> build(new ViewBuild());
+  build->view = view;
+  build->barrier_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  build->stop = false;
+  build->done = false;
+
+  {
+    std::lock_guard<std::mutex> lock(builder_mutex);
+
+    // Release the builds that finished since the last call
+    auto itr = std::partition(builds.begin(), builds.end(),
+                              [](const std::unique_ptr<ViewBuild> &entry) {
+                                return entry->done == false;
+                              });
+    for (auto finished_itr = itr; finished_itr != builds.end();
+         finished_itr++) {
+      (*finished_itr)->build_thread.join();
+    }
+    builds.erase(itr, builds.end());
+
+    build->build_thread =
+        std::thread(&storage::AggregateViewManager::Build, this, build.get());
+    builds.push_back(std::move(build));
+  }
+
+  LOG_TRACE("Started building aggregate view %s", name.c_str());
+  return true;
+}
+
+void AggregateViewManager::Build(ViewBuild *build) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  // A transaction of the barrier epoch may have committed before the view
+  // was there. Every later one captures its deltas.
+  while (build->stop == false &&
+         epoch_manager.GetCurrentEpochId() <= build->barrier_eid) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_duration));
+  }
+
+  if (build->stop == false) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+    // The transaction keeps the versions the scan needs from the GC
+    auto txn = txn_manager.BeginTransaction();
+    eid_t build_eid = txn->GetEpochId();
+    while (build->stop == false) {
+      auto expired_eid = epoch_manager.GetExpiredEpochId();
+      if (expired_eid != MAX_EID && expired_eid + 1 >= build_eid) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(sleep_duration));
+    }
+
+    if (build->stop == false) {
+      // The transactions of the earlier epochs have all ended
+      cid_t build_cid = (static_cast<cid_t>(build_eid) << 32) - 1;
+      AggregateView::GroupMap groups;
+      ScanTable(build->view.get(), build_cid, groups);
+      size_t group_count = groups.size();
+      build->view->SetBase(build_cid, std::move(groups));
+      LOG_INFO("Built aggregate view %s with %lu groups",
+               build->view->GetName().c_str(), group_count);
+    }
+
+    txn_manager.CommitTransaction(txn);
+  }
+
+  build->done = true;
+}
+
+void AggregateViewManager::ScanTable(const AggregateView *view,
+                                     const cid_t commit_id,
+                                     AggregateView::GroupMap &groups) {
+  auto table = view->GetTable();
+  auto tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      // Empty versions of deletes and aborted versions hold no tuple
+      if (tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID) {
+        continue;
+      }
+      if (tile_group_header->GetBeginCommitId(tuple_id) > commit_id ||
+          tile_group_header->GetEndCommitId(tuple_id) <= commit_id) {
+        continue;
+      }
+
+      expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                           tuple_id);
+      view->AddTuple(groups, &tuple, 1);
+    }
+  }
+}
+
+bool AggregateViewManager::DropView(const std::string &name) {
+  std::shared_ptr<AggregateView> view;
+  {
+    std::lock_guard<std::mutex> lock(manager_mutex);
+    auto itr = views.find(name);
+    if (itr == views.end()) {
+      return false;
+    }
+    view = itr->second;
+    views.erase(itr);
+
+    auto &views_of_table = table_views[view->GetTable()];
+    views_of_table.erase(
+        std::remove(views_of_table.begin(), views_of_table.end(), view),
+        views_of_table.end());
+    if (views_of_table.empty()) {
+      table_views.erase(view->GetTable());
+    }
+    view_count--;
+  }
+
+  // Plans that hold on to the view fall back to their own
+  view->Invalidate();
+  JoinBuilds(view.get(), true);
+  return true;
+}
+
+std::shared_ptr<AggregateView> AggregateViewManager::GetView(
+    const std::string &name) {
+  std::lock_guard<std::mutex> lock(manager_mutex);
+  auto itr = views.find(name);
+  if (itr == views.end()) {
+    return nullptr;
+  }
+  return itr->second;
+}
+
+std::shared_ptr<AggregateView> AggregateViewManager::FindView(
+    DataTable *table, const std::vector<oid_t> &group_column_ids,
+    const std::vector<oid_t> &aggregate_column_ids) {
+  std::vector<oid_t> group_columns(group_column_ids);
+  std::sort(group_columns.begin(), group_columns.end());
+  group_columns.erase(std::unique(group_columns.begin(), group_columns.end()),
+                      group_columns.end());
+
+  for (auto &view : GetTableViews(table)) {
+    if (view->IsReady() == false || view->IsValid() == false) {
+      continue;
+    }
+
+    std::vector<oid_t> view_group_columns(view->GetGroupColumnIds());
+    std::sort(view_group_columns.begin(), view_group_columns.end());
+    if (view_group_columns != group_columns) {
+      continue;
+    }
+
+    bool is_covered = true;
+    for (auto column_id : aggregate_column_ids) {
+      if (view->GetAggregateOffset(column_id) == INVALID_OID) {
+        is_covered = false;
+        break;
+      }
+    }
+    if (is_covered == true) {
+      return view;
+    }
+  }
+  return nullptr;
+}
+
+std::vector<std::shared_ptr<AggregateView>>
+AggregateViewManager::GetTableViews(const AbstractTable *table) {
+  std::lock_guard<std::mutex> lock(manager_mutex);
+  auto itr = table_views.find(table);
+  if (itr == table_views.end()) {
+    return {};
+  }
+  return itr->second;
+}
+
+void AggregateViewManager::RecordCommit(concurrency::Transaction *txn) {
+  if (view_count == 0) {
+    return;
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  std::vector<std::pair<std::shared_ptr<AggregateView>,
+                        AggregateView::GroupMap>> view_deltas;
+
+  // Consecutive versions mostly belong to the same table
+  const AbstractTable *last_table = nullptr;
+  std::vector<std::shared_ptr<AggregateView>> last_views;
+  auto get_views = [&](const storage::TileGroup *tile_group)
+      -> const std::vector<std::shared_ptr<AggregateView>> &{
+    if (tile_group->GetAbstractTable() != last_table) {
+      last_table = tile_group->GetAbstractTable();
+      last_views = GetTableViews(last_table);
+    }
+    return last_views;
+  };
+
+  auto add_version = [&](const ItemPointer &location, const int sign) {
+    auto tile_group = manager.ResolveTileGroup(location.block);
+    if (tile_group == nullptr) {
+      return;
+    }
+    auto &views_of_table = get_views(tile_group);
+    if (views_of_table.empty()) {
+      return;
+    }
+
+    expression::ContainerTuple<storage::TileGroup> tuple(tile_group,
+                                                         location.offset);
+    for (auto &view : views_of_table) {
+      auto itr = std::find_if(
+          view_deltas.begin(), view_deltas.end(),
+          [&view](const std::pair<std::shared_ptr<AggregateView>,
+                                  AggregateView::GroupMap> &entry) {
+            return entry.first == view;
+          });
+      if (itr == view_deltas.end()) {
+        view_deltas.emplace_back(view, AggregateView::GroupMap());
+        itr = view_deltas.end() - 1;
+      }
+      view->AddTuple(itr->second, &tuple, sign);
+    }
+  };
+
+  // The old values of versions updated in place are gone
+  for (auto &undo_record : txn->GetUndoBuffer()) {
+    auto tile_group = manager.ResolveTileGroup(undo_record.location.block);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    for (auto &view : get_views(tile_group)) {
+      view->Invalidate();
+    }
+  }
+
+  for (auto &rw_entry : txn->GetReadWriteSet()) {
+    switch (rw_entry.type) {
+      case RWType::INSERT:
+        add_version(rw_entry.location, 1);
+        break;
+      case RWType::DELETE:
+        add_version(rw_entry.location, -1);
+        break;
+      case RWType::UPDATE: {
+        // The new version is linked from the old one
+        add_version(rw_entry.location, -1);
+        auto tile_group = manager.ResolveTileGroup(rw_entry.location.block);
+        if (tile_group != nullptr) {
+          add_version(tile_group->GetHeader()->GetPrevItemPointer(
+                          rw_entry.location.offset),
+                      1);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  for (auto &bulk_entry : txn->GetBulkInsertSet()) {
+    for (oid_t tuple_slot = 0; tuple_slot < bulk_entry.second; tuple_slot++) {
+      add_version(ItemPointer(bulk_entry.first, tuple_slot), 1);
+    }
+  }
+
+  for (auto tile_group_id : txn->GetDeletedTileGroupSet()) {
+    auto tile_group = manager.ResolveTileGroup(tile_group_id);
+    if (tile_group == nullptr || get_views(tile_group).empty()) {
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t slot_count = tile_group_header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_slot = 0; tuple_slot < slot_count; tuple_slot++) {
+      if (tile_group_header->IsDeletedSlot(tuple_slot) == true) {
+        add_version(ItemPointer(tile_group_id, tuple_slot), -1);
+      }
+    }
+  }
+
+  if (view_deltas.empty()) {
+    return;
+  }
+
+  auto expired_cid =
+      concurrency::EpochManagerFactory::GetInstance().GetLastExpiredCid();
+  for (auto &view_delta : view_deltas) {
+    view_delta.first->AddDelta(txn->GetCommitId(),
+                               std::move(view_delta.second));
+    view_delta.first->FoldDeltas(expired_cid);
+  }
+}
+
+void AggregateViewManager::WaitForAll() { JoinBuilds(nullptr, false); }
+
+void AggregateViewManager::DropTable(DataTable *table) {
+  std::vector<std::shared_ptr<AggregateView>> dropped_views;
+  {
+    std::lock_guard<std::mutex> lock(manager_mutex);
+    auto itr = table_views.find(table);
+    if (itr == table_views.end()) {
+      return;
+    }
+    dropped_views = std::move(itr->second);
+    table_views.erase(itr);
+    for (auto &view : dropped_views) {
+      views.erase(view->GetName());
+      view_count--;
+    }
+  }
+
+  for (auto &view : dropped_views) {
+    view->Invalidate();
+    JoinBuilds(view.get(), true);
+  }
+}
+
+void AggregateViewManager::StopAll() { JoinBuilds(nullptr, true); }
+
+void AggregateViewManager::JoinBuilds(const AggregateView *view, bool stop) {
+  std::vector<std::unique_ptr<ViewBuild>> joined_builds;
+
+  {
+    std::lock_guard<std::mutex> lock(builder_mutex);
+    auto itr = std::partition(builds.begin(), builds.end(),
+                              [view](const std::unique_ptr<ViewBuild> &build) {
+                                return view != nullptr &&
+                                       build->view.get() != view;
+                              });
+    std::move(itr, builds.end(), std::back_inserter(joined_builds));
+    builds.erase(itr, builds.end());
+  }
+
+  for (auto &build : joined_builds) {
+    if (stop == true) {
+      build->stop = true;
+    }
+    build->build_thread.join();
+  }
+}
+
+}  // End storage namespace
+}  // End peloton namespace
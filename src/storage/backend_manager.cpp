@@ -30,6 +30,7 @@
 #include "type/types.h"
 // #include "logging/logging_util.h"
 #include "storage/backend_manager.h"
+#include "util/numa_util.h"
 
 //===--------------------------------------------------------------------===//
 // GUC Variables
@@ -186,17 +187,17 @@ static inline void flush_clflush(const void *addr, size_t len) {
     _mm_clflush((char *)uptr);
 }
 
-// // flush_clwb -- (internal) flush the CPU cache, using clwb
-// static inline void flush_clwb(const void *addr, size_t len) {
-//   uintptr_t uptr;
+// flush_clwb -- (internal) flush the CPU cache, using clwb
+static inline void flush_clwb(const void *addr, size_t len) {
+  uintptr_t uptr;
 
-//   // Loop through cache-line-size (typically 64B) aligned chunks
-//   // covering the given range.
-//   for (uptr = (uintptr_t)addr & ~(FLUSH_ALIGN - 1);
-//        uptr < (uintptr_t)addr + len; uptr += FLUSH_ALIGN) {
-//     _mm_clwb((char *)uptr);
-//   }
-// }
+  // Loop through cache-line-size (typically 64B) aligned chunks
+  // covering the given range.
+  for (uptr = (uintptr_t)addr & ~(FLUSH_ALIGN - 1);
+       uptr < (uintptr_t)addr + len; uptr += FLUSH_ALIGN) {
+    _mm_clwb((char *)uptr);
+  }
+}
 
 /*
  * pmem_flush() calls through Func_flush to do the work.  Although
@@ -218,12 +219,12 @@ static void predrain_fence_empty(void) {
   /* nothing to do (because CLFLUSH did it for us) */
 }
 
-// /*
-//  * predrain_fence_sfence -- (internal) issue the pre-drain fence instruction
-//  */
-// static void predrain_fence_sfence(void) {
-//   _mm_sfence(); /* ensure CLWB or CLFLUSHOPT completes before PCOMMIT */
-// }
+/*
+ * predrain_fence_sfence -- (internal) issue the pre-drain fence instruction
+ */
+static void predrain_fence_sfence(void) {
+  _mm_sfence(); /* ensure CLWB or CLFLUSHOPT completes before PCOMMIT */
+}
 
 //  * pmem_drain() calls through Func_predrain_fence to do the fence.  Although
 //  * initialized to predrain_fence_empty(), once the existence of the CLWB or
@@ -313,6 +314,14 @@ BackendManager &BackendManager::GetInstance(void) {
 
 BackendManager::BackendManager()
     : data_file_address(nullptr), data_file_len(0), data_file_offset(0) {
+  // clwb writes the lines back without evicting them, the fence orders the
+  // write backs before the stores that follow a sync
+  if (is_cpu_clwb_present()) {
+    LOG_TRACE("Found clwb \n");
+    Func_flush = flush_clwb;
+    Func_predrain_fence = predrain_fence_sfence;
+  }
+
   // // Check if we need a data pool
   // if (logging::LoggingUtil::IsBasedOnWriteAheadLogging(peloton_logging_mode)
   // ==
@@ -448,7 +457,9 @@ void *BackendManager::Allocate(BackendType type, size_t size) {
   allocation_count++;
 
   switch (type) {
+    // unsized releases can't go back to the huge page arenas
     case BackendType::MM:
+    case BackendType::HUGE_PAGE:
     case BackendType::NVM: {
       return ::operator new(size);
     } break;
@@ -496,6 +507,7 @@ void *BackendManager::Allocate(BackendType type, size_t size) {
 void BackendManager::Release(BackendType type, void *address) {
   switch (type) {
     case BackendType::MM:
+    case BackendType::HUGE_PAGE:
     case BackendType::NVM: {
       ::operator delete(address);
     } break;
@@ -513,9 +525,123 @@ void BackendManager::Release(BackendType type, void *address) {
   }
 }
 
+void *BackendManager::AllocateOnNode(size_t size, int numa_node) {
+  allocation_count++;
+
+  void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (address == MAP_FAILED) {
+    throw Exception("could not allocate memory on numa node " +
+                    std::to_string(numa_node) + " : size : " +
+                    std::to_string(size));
+  }
+
+  // The pages are not touched yet, so they will be faulted in on the node
+  NumaUtil::BindMemoryToNode(address, size, numa_node);
+
+  return address;
+}
+
+void BackendManager::ReleaseOnNode(void *address, size_t size) {
+  munmap(address, size);
+}
+
+void *BackendManager::MapHugePages(size_t size, int numa_node) {
+  void *address = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+  // use explicit huge pages if the kernel has some reserved
+  address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+  if (address == MAP_FAILED) {
+    address = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) {
+      throw Exception("could not allocate huge pages : size : " +
+                      std::to_string(size));
+    }
+
+#ifdef MADV_HUGEPAGE
+    // fall back to transparent huge pages
+    madvise(address, size, MADV_HUGEPAGE);
+#endif
+  }
+
+  NumaUtil::BindMemoryToNode(address, size, numa_node);
+
+  huge_page_mapping_count++;
+
+  return address;
+}
+
+void *BackendManager::AllocateHugePages(size_t size, int numa_node) {
+  allocation_count++;
+
+  // keep blocks cache line aligned
+  size = (size + FLUSH_ALIGN - 1) & ~(FLUSH_ALIGN - 1);
+
+  if (size >= HUGE_PAGE_DIRECT_SIZE) {
+    size_t mapping_size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    return MapHugePages(mapping_size, numa_node);
+  }
+
+  void *address = nullptr;
+
+  huge_page_spinlock.Lock();
+
+  auto &free_blocks = huge_page_free_blocks[std::make_pair(numa_node, size)];
+  if (free_blocks.empty() == false) {
+    address = free_blocks.back();
+    free_blocks.pop_back();
+    huge_page_spinlock.Unlock();
+
+    return address;
+  }
+
+  auto &arena = huge_page_arenas[numa_node];
+  if (arena.remaining < size) {
+    try {
+      arena.next = reinterpret_cast<char *>(
+          MapHugePages(HUGE_PAGE_ARENA_SIZE, numa_node));
+    } catch (Exception &e) {
+      huge_page_spinlock.Unlock();
+      throw;
+    }
+    // the tail of the previous arena is left unused
+    arena.remaining = HUGE_PAGE_ARENA_SIZE;
+  }
+
+  address = arena.next;
+  arena.next += size;
+  arena.remaining -= size;
+
+  huge_page_spinlock.Unlock();
+
+  return address;
+}
+
+void BackendManager::ReleaseHugePages(void *address, size_t size,
+                                      int numa_node) {
+  size = (size + FLUSH_ALIGN - 1) & ~(FLUSH_ALIGN - 1);
+
+  if (size >= HUGE_PAGE_DIRECT_SIZE) {
+    size_t mapping_size = (size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    munmap(address, mapping_size);
+    return;
+  }
+
+  // arenas are never unmapped. the block is recycled for the same size.
+  huge_page_spinlock.Lock();
+  huge_page_free_blocks[std::make_pair(numa_node, size)].push_back(address);
+  huge_page_spinlock.Unlock();
+}
+
 void BackendManager::Sync(BackendType type, void *address, size_t length) {
   switch (type) {
-    case BackendType::MM: {
+    case BackendType::MM:
+    case BackendType::HUGE_PAGE: {
       // Nothing to do here
     } break;
 
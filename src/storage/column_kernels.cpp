@@ -0,0 +1,445 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// column_kernels.cpp
+//
+// Identification: src/storage/column_kernels.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/column_kernels.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/macros.h"
+#include "storage/tile.h"
+#include "type/limits.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+TileColumn::TileColumn(const Tile *tile, oid_t column_id) {
+  const auto *schema = tile->GetSchema();
+  PL_ASSERT(schema->IsInlined(column_id));
+  data = tile->GetTupleLocation(0) + schema->GetOffset(column_id);
+  stride = schema->GetLength();
+  type_id = schema->GetType(column_id);
+  tuple_count = tile->GetAllocatedTupleCount();
+}
+
+namespace {
+
+// The comparisons, on the native values and, with AVX2, on vectors of 32 and
+// 64 bit integers, where they set the lanes that compare true
+#if defined(__AVX2__)
+inline __m256i Not(__m256i mask) {
+  return _mm256_xor_si256(mask, _mm256_set1_epi32(-1));
+}
+#endif
+
+struct Equal {
+  template <typename T>
+  static inline bool Apply(T left, T right) { return left == right; }
+#if defined(__AVX2__)
+  static inline __m256i Apply32(__m256i left, __m256i right) {
+    return _mm256_cmpeq_epi32(left, right);
+  }
+  static inline __m256i Apply64(__m256i left, __m256i right) {
+    return _mm256_cmpeq_epi64(left, right);
+  }
+#endif
+};
+
+struct NotEqual {
+  template <typename T>
+  static inline bool Apply(T left, T right) { return left != right; }
+#if defined(__AVX2__)
+  static inline __m256i Apply32(__m256i left, __m256i right) {
+    return Not(_mm256_cmpeq_epi32(left, right));
+  }
+  static inline __m256i Apply64(__m256i left, __m256i right) {
+    return Not(_mm256_cmpeq_epi64(left, right));
+  }
+#endif
+};
+
+struct LessThan {
+  template <typename T>
+  static inline bool Apply(T left, T right) { return left < right; }
+#if defined(__AVX2__)
+  static inline __m256i Apply32(__m256i left, __m256i right) {
+    return _mm256_cmpgt_epi32(right, left);
+  }
+  static inline __m256i Apply64(__m256i left, __m256i right) {
+    return _mm256_cmpgt_epi64(right, left);
+  }
+#endif
+};
+
+struct GreaterThan {
+  template <typename T>
+  static inline bool Apply(T left, T right) { return left > right; }
+#if defined(__AVX2__)
+  static inline __m256i Apply32(__m256i left, __m256i right) {
+    return _mm256_cmpgt_epi32(left, right);
+  }
+  static inline __m256i Apply64(__m256i left, __m256i right) {
+    return _mm256_cmpgt_epi64(left, right);
+  }
+#endif
+};
+
+struct LessThanEquals {
+  template <typename T>
+  static inline bool Apply(T left, T right) { return left <= right; }
+#if defined(__AVX2__)
+  static inline __m256i Apply32(__m256i left, __m256i right) {
+    return Not(_mm256_cmpgt_epi32(left, right));
+  }
+  static inline __m256i Apply64(__m256i left, __m256i right) {
+    return Not(_mm256_cmpgt_epi64(left, right));
+  }
+#endif
+};
+
+struct GreaterThanEquals {
+  template <typename T>
+  static inline bool Apply(T left, T right) { return left >= right; }
+#if defined(__AVX2__)
+  static inline __m256i Apply32(__m256i left, __m256i right) {
+    return Not(_mm256_cmpgt_epi32(right, left));
+  }
+  static inline __m256i Apply64(__m256i left, __m256i right) {
+    return Not(_mm256_cmpgt_epi64(right, left));
+  }
+#endif
+};
+
+template <typename Stored>
+inline Stored Load(const TileColumn &column, oid_t tuple_id) {
+  Stored stored;
+  std::memcpy(&stored, column.data + tuple_id * column.stride, sizeof(stored));
+  return stored;
+}
+
+// Compare the stored values as T, the common type of them and the constant
+template <typename Op, typename T, typename Stored>
+void CompareScalar(const TileColumn &column, Stored null_value, T constant,
+                   const oid_t *tuple_ids, size_t count,
+                   type::CmpBool *results) {
+  for (size_t i = 0; i < count; i++) {
+    Stored stored = Load<Stored>(column, tuple_ids[i]);
+    if (stored == null_value) {
+      results[i] = type::CMP_NULL;
+    } else if (Op::Apply(static_cast<T>(stored), constant)) {
+      results[i] = type::CMP_TRUE;
+    } else {
+      results[i] = type::CMP_FALSE;
+    }
+  }
+}
+
+#if defined(__AVX2__)
+inline void StoreLanes(int true_lanes, int null_lanes, size_t lane_count,
+                       type::CmpBool *results) {
+  for (size_t lane = 0; lane < lane_count; lane++) {
+    if (null_lanes & (1 << lane)) {
+      results[lane] = type::CMP_NULL;
+    } else {
+      results[lane] =
+          (true_lanes & (1 << lane)) ? type::CMP_TRUE : type::CMP_FALSE;
+    }
+  }
+}
+
+// Compare 8 INTEGER values at a time. Returns the number compared, the rest
+// is left to the scalar loop.
+template <typename Op>
+size_t CompareInt32(const TileColumn &column, int32_t constant,
+                    const oid_t *tuple_ids, size_t count,
+                    type::CmpBool *results) {
+  const __m256i stride = _mm256_set1_epi32(static_cast<int>(column.stride));
+  const __m256i constants = _mm256_set1_epi32(constant);
+  const __m256i nulls = _mm256_set1_epi32(type::PELOTON_INT32_NULL);
+  const int *base = reinterpret_cast<const int *>(column.data);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i offsets = _mm256_mullo_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(tuple_ids + i)),
+        stride);
+    __m256i values = _mm256_i32gather_epi32(base, offsets, 1);
+    int true_lanes = _mm256_movemask_ps(
+        _mm256_castsi256_ps(Op::Apply32(values, constants)));
+    int null_lanes = _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(values, nulls)));
+    StoreLanes(true_lanes, null_lanes, 8, results + i);
+  }
+  return i;
+}
+
+// Compare 4 BIGINT values at a time
+template <typename Op>
+size_t CompareInt64(const TileColumn &column, int64_t constant,
+                    const oid_t *tuple_ids, size_t count,
+                    type::CmpBool *results) {
+  const __m128i stride = _mm_set1_epi32(static_cast<int>(column.stride));
+  const __m256i constants = _mm256_set1_epi64x(constant);
+  const __m256i nulls = _mm256_set1_epi64x(type::PELOTON_INT64_NULL);
+  const long long *base = reinterpret_cast<const long long *>(column.data);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i offsets = _mm_mullo_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(tuple_ids + i)),
+        stride);
+    __m256i values = _mm256_i32gather_epi64(base, offsets, 1);
+    int true_lanes = _mm256_movemask_pd(
+        _mm256_castsi256_pd(Op::Apply64(values, constants)));
+    int null_lanes = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpeq_epi64(values, nulls)));
+    StoreLanes(true_lanes, null_lanes, 4, results + i);
+  }
+  return i;
+}
+#endif
+
+template <typename Op>
+void CompareAs(const TileColumn &column, const type::Value &constant,
+               const oid_t *tuple_ids, size_t count, type::CmpBool *results) {
+  // Integers compare as BIGINT, and everything as DECIMAL if either side is
+  // one, which is what the comparisons of the values do too
+  if (column.type_id == type::TypeId::DECIMAL ||
+      constant.GetTypeId() == type::TypeId::DECIMAL) {
+    double value = constant.CastAs(type::TypeId::DECIMAL).GetAs<double>();
+    switch (column.type_id) {
+      case type::TypeId::TINYINT:
+        return CompareScalar<Op, double, int8_t>(
+            column, type::PELOTON_INT8_NULL, value, tuple_ids, count, results);
+      case type::TypeId::SMALLINT:
+        return CompareScalar<Op, double, int16_t>(column,
+                                                  type::PELOTON_INT16_NULL,
+                                                  value, tuple_ids, count,
+                                                  results);
+      case type::TypeId::INTEGER:
+        return CompareScalar<Op, double, int32_t>(column,
+                                                  type::PELOTON_INT32_NULL,
+                                                  value, tuple_ids, count,
+                                                  results);
+      case type::TypeId::BIGINT:
+        return CompareScalar<Op, double, int64_t>(column,
+                                                  type::PELOTON_INT64_NULL,
+                                                  value, tuple_ids, count,
+                                                  results);
+      default:
+        return CompareScalar<Op, double, double>(column,
+                                                 type::PELOTON_DECIMAL_NULL,
+                                                 value, tuple_ids, count,
+                                                 results);
+    }
+  }
+
+  int64_t value = constant.CastAs(type::TypeId::BIGINT).GetAs<int64_t>();
+  size_t done = 0;
+  switch (column.type_id) {
+    case type::TypeId::TINYINT:
+      return CompareScalar<Op, int64_t, int8_t>(
+          column, type::PELOTON_INT8_NULL, value, tuple_ids, count, results);
+    case type::TypeId::SMALLINT:
+      return CompareScalar<Op, int64_t, int16_t>(
+          column, type::PELOTON_INT16_NULL, value, tuple_ids, count, results);
+    case type::TypeId::INTEGER:
+#if defined(__AVX2__)
+      // The gathers take 32 bit offsets, and a constant out of the range of
+      // the column is left to the scalar loop
+      if (static_cast<uint64_t>(column.tuple_count) * column.stride <=
+              static_cast<uint64_t>(INT_MAX) &&
+          value > type::PELOTON_INT32_NULL && value <= INT_MAX) {
+        done = CompareInt32<Op>(column, static_cast<int32_t>(value),
+                                tuple_ids, count, results);
+      }
+#endif
+      return CompareScalar<Op, int64_t, int32_t>(
+          column, type::PELOTON_INT32_NULL, value, tuple_ids + done,
+          count - done, results + done);
+    default:
+#if defined(__AVX2__)
+      if (static_cast<uint64_t>(column.tuple_count) * column.stride <=
+          static_cast<uint64_t>(INT_MAX)) {
+        done = CompareInt64<Op>(column, value, tuple_ids, count, results);
+      }
+#endif
+      return CompareScalar<Op, int64_t, int64_t>(
+          column, type::PELOTON_INT64_NULL, value, tuple_ids + done,
+          count - done, results + done);
+  }
+}
+
+inline void AddToSum(int64_t &sum, int64_t value) {
+  if (__builtin_add_overflow(sum, value, &sum)) {
+    throw Exception(EXCEPTION_TYPE_OUT_OF_RANGE, "Numeric value out of range.");
+  }
+}
+
+inline void AddToSum(double &sum, double value) { sum += value; }
+
+// Aggregate the stored values as T, BIGINT for integers
+template <typename T, typename Stored>
+void AggregateAs(const TileColumn &column, Stored null_value,
+                 const oid_t *tuple_ids, size_t count,
+                 ColumnAggregate &aggregate) {
+  T sum = 0;
+  Stored min = std::numeric_limits<Stored>::max();
+  Stored max = std::numeric_limits<Stored>::lowest();
+  uint64_t value_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    Stored stored = Load<Stored>(column, tuple_ids[i]);
+    if (stored == null_value) {
+      continue;
+    }
+    value_count++;
+    AddToSum(sum, stored);
+    min = std::min(min, stored);
+    max = std::max(max, stored);
+  }
+
+  aggregate.row_count += count;
+  if (value_count == 0) {
+    return;
+  }
+  if (!std::is_floating_point<T>::value &&
+      (sum < static_cast<T>(std::numeric_limits<Stored>::lowest()) ||
+       sum > static_cast<T>(std::numeric_limits<Stored>::max()))) {
+    throw Exception(EXCEPTION_TYPE_OUT_OF_RANGE,
+                    "Numeric value out of range.");
+  }
+
+  // The values of the type of the column, by way of the constructors of
+  // the integers of that width
+  type::Value sum_value, min_value, max_value;
+  if (column.type_id == type::TypeId::DECIMAL) {
+    sum_value = type::ValueFactory::GetDecimalValue(sum);
+    min_value = type::ValueFactory::GetDecimalValue(min);
+    max_value = type::ValueFactory::GetDecimalValue(max);
+  } else {
+    sum_value = type::ValueFactory::GetBigIntValue(static_cast<int64_t>(sum))
+                    .CastAs(column.type_id);
+    min_value = type::ValueFactory::GetBigIntValue(min).CastAs(column.type_id);
+    max_value = type::ValueFactory::GetBigIntValue(max).CastAs(column.type_id);
+  }
+
+  if (aggregate.count == 0) {
+    aggregate.sum = sum_value;
+    aggregate.min = min_value;
+    aggregate.max = max_value;
+  } else {
+    aggregate.sum = aggregate.sum.Add(sum_value);
+    aggregate.min = aggregate.min.Min(min_value);
+    aggregate.max = aggregate.max.Max(max_value);
+  }
+  aggregate.count += value_count;
+}
+
+}  // namespace
+
+bool ColumnKernels::IsSupported(type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ColumnKernels::Compare(const TileColumn &column,
+                            ExpressionType compare_type,
+                            const type::Value &constant,
+                            const oid_t *tuple_ids, size_t count,
+                            type::CmpBool *results) {
+  PL_ASSERT(IsSupported(column.type_id));
+  if (constant.IsNull()) {
+    std::fill(results, results + count, type::CMP_NULL);
+    return;
+  }
+  PL_ASSERT(IsSupported(constant.GetTypeId()));
+
+  switch (compare_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return CompareAs<Equal>(column, constant, tuple_ids, count, results);
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return CompareAs<NotEqual>(column, constant, tuple_ids, count, results);
+    case ExpressionType::COMPARE_LESSTHAN:
+      return CompareAs<LessThan>(column, constant, tuple_ids, count, results);
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return CompareAs<GreaterThan>(column, constant, tuple_ids, count,
+                                    results);
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return CompareAs<LessThanEquals>(column, constant, tuple_ids, count,
+                                       results);
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return CompareAs<GreaterThanEquals>(column, constant, tuple_ids, count,
+                                          results);
+    default:
+      throw Exception("Invalid comparison expression type.");
+  }
+}
+
+size_t ColumnKernels::Filter(const TileColumn &column,
+                             ExpressionType compare_type,
+                             const type::Value &constant,
+                             const oid_t *tuple_ids, size_t count,
+                             oid_t *selection) {
+  std::vector<type::CmpBool> results(count);
+  Compare(column, compare_type, constant, tuple_ids, count, results.data());
+  size_t selected = 0;
+  for (size_t i = 0; i < count; i++) {
+    // Branch free, the tuple id is overwritten unless it is selected
+    selection[selected] = tuple_ids[i];
+    selected += results[i] == type::CMP_TRUE;
+  }
+  return selected;
+}
+
+void ColumnKernels::Aggregate(const TileColumn &column,
+                              const oid_t *tuple_ids, size_t count,
+                              ColumnAggregate &aggregate) {
+  switch (column.type_id) {
+    case type::TypeId::TINYINT:
+      return AggregateAs<int64_t, int8_t>(column, type::PELOTON_INT8_NULL,
+                                          tuple_ids, count, aggregate);
+    case type::TypeId::SMALLINT:
+      return AggregateAs<int64_t, int16_t>(column, type::PELOTON_INT16_NULL,
+                                           tuple_ids, count, aggregate);
+    case type::TypeId::INTEGER:
+      return AggregateAs<int64_t, int32_t>(column, type::PELOTON_INT32_NULL,
+                                           tuple_ids, count, aggregate);
+    case type::TypeId::BIGINT:
+      return AggregateAs<int64_t, int64_t>(column, type::PELOTON_INT64_NULL,
+                                           tuple_ids, count, aggregate);
+    case type::TypeId::DECIMAL:
+      return AggregateAs<double, double>(column, type::PELOTON_DECIMAL_NULL,
+                                         tuple_ids, count, aggregate);
+    default:
+      throw Exception("Invalid type for a column kernel.");
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
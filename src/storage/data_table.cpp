@@ -10,12 +10,15 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <mutex>
+#include <unordered_set>
 #include <utility>
 
 #include "brain/clusterer.h"
 #include "brain/sample.h"
 #include "catalog/foreign_key.h"
+#include "common/container_tuple.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/platform.h"
@@ -27,12 +30,15 @@
 #include "storage/abstract_table.h"
 #include "storage/data_table.h"
 #include "storage/database.h"
+#include "storage/foreign_key_cache.h"
+#include "storage/partitioned_table.h"
 #include "storage/storage_manager.h"
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_factory.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/zone_map.h"
 
 //===--------------------------------------------------------------------===//
 // Configuration Variables
@@ -52,6 +58,24 @@ oid_t DataTable::invalid_tile_group_id = -1;
 size_t DataTable::default_active_tilegroup_count_ = 1;
 size_t DataTable::default_active_indirection_array_count_ = 1;
 
+const size_t DataTable::MAX_ACTIVE_TILE_GROUP_COUNT;
+
+namespace {
+
+// The keys of new index entries are built in a buffer of the thread that is
+// reused across insertions. The indexes copy the keys they are given, and the
+// varlen values of a key still come from the pool of its index.
+char *GetKeyBuffer(const catalog::Schema *key_schema) {
+  thread_local std::vector<char> key_buffer;
+  size_t key_length = key_schema->GetLength();
+  if (key_buffer.size() < key_length) {
+    key_buffer.resize(key_length);
+  }
+  return key_buffer.data();
+}
+
+}  // namespace
+
 DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
                      const oid_t &database_oid, const oid_t &table_oid,
                      const size_t &tuples_per_tilegroup, const bool own_schema,
@@ -60,6 +84,7 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
       database_oid(database_oid),
       table_name(table_name),
       tuples_per_tilegroup_(tuples_per_tilegroup),
+      recycled_indirections_(INDIRECTION_ARRAY_MAX_SIZE),
       adapt_table_(adapt_table) {
   // Init default partition
   auto col_count = schema->GetColumnCount();
@@ -75,9 +100,24 @@ DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
     active_indirection_array_count_ = default_active_indirection_array_count_;
   }
 
-  active_tile_groups_.resize(active_tilegroup_count_);
+  // Every NUMA node gets the same number of active tile groups
+  numa_node_count_ = (is_catalog == true) ? 1 : NumaUtil::GetNodeCount();
+  if (active_tilegroup_count_ % numa_node_count_ != 0) {
+    active_tilegroup_count_ +=
+        numa_node_count_ - active_tilegroup_count_ % numa_node_count_;
+  }
+
+  // Catalog tables keep their single active tile group
+  if (is_catalog == true) {
+    active_tile_groups_.resize(active_tilegroup_count_);
+  } else {
+    active_tile_groups_.resize(
+        std::max(active_tilegroup_count_.load(), MAX_ACTIVE_TILE_GROUP_COUNT));
+  }
+  spare_tile_groups_.resize(active_tile_groups_.size());
 
   active_indirection_arrays_.resize(active_indirection_array_count_);
+  spare_indirection_arrays_.resize(active_indirection_array_count_);
   // Create tile groups.
   for (size_t i = 0; i < active_tilegroup_count_; ++i) {
     AddDefaultTileGroup(i);
@@ -116,6 +156,11 @@ DataTable::~DataTable() {
     auto oid = indirection_array->GetOid();
     catalog_manager.DropIndirectionArray(oid);
   }
+  for (auto indirection_array : spare_indirection_arrays_) {
+    if (indirection_array != nullptr) {
+      catalog_manager.DropIndirectionArray(indirection_array->GetOid());
+    }
+  }
 
   // AbstractTable cleans up the schema
 }
@@ -167,6 +212,10 @@ bool DataTable::CheckConstraints(const storage::Tuple *tuple) const {
 // however, when performing insert, we have to copy data immediately,
 // and the argument cannot be set to nullptr.
 ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
+  // the tuples of the tile groups loaded into the table get their index
+  // entries first
+  WaitForIndexFill();
+
   //=============== garbage collection==================
   // check if there are recycled tuple slots
   auto &gc_manager = gc::GCManagerFactory::GetInstance();
@@ -182,7 +231,7 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple) {
   }
   //====================================================
 
-  size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
+  size_t active_tile_group_id = GetActiveTileGroupId();
   std::shared_ptr<storage::TileGroup> tile_group;
   oid_t tuple_slot = INVALID_OID;
   oid_t tile_group_id = INVALID_OID;
@@ -251,7 +300,13 @@ ItemPointer DataTable::AcquireVersion() {
 bool DataTable::InstallVersion(const AbstractTuple *tuple,
                                const TargetList *targets_ptr,
                                concurrency::Transaction *transaction,
-                               ItemPointer *index_entry_ptr) {
+                               ItemPointer *index_entry_ptr,
+                               const AbstractTuple *old_tuple) {
+  // Most updates only change columns no index covers
+  if (IsHeapOnlyUpdate(tuple, targets_ptr, old_tuple) == true) {
+    return true;
+  }
+
   // Index checks and updates
   if (InsertInSecondaryIndexes(tuple, targets_ptr, transaction,
                                index_entry_ptr) == false) {
@@ -264,6 +319,18 @@ bool DataTable::InstallVersion(const AbstractTuple *tuple,
 ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple,
                                    concurrency::Transaction *transaction,
                                    ItemPointer **index_entry_ptr) {
+  return InsertTuple(tuple, transaction, index_entry_ptr, nullptr);
+}
+
+ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple,
+                                   concurrency::Transaction *transaction,
+                                   ItemPointer **index_entry_ptr,
+                                   ForeignKeyCache *foreign_key_cache) {
+  if (partitioned_table_ != nullptr) {
+    return partitioned_table_->InsertTuple(tuple, transaction,
+                                           index_entry_ptr, foreign_key_cache);
+  }
+
   // the upper layer may not pass a index_entry_ptr (default value: nullptr)
   // into the function.
   // in this case, we have to create a temp_ptr to hold the content.
@@ -290,12 +357,14 @@ ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple,
   // Index checks and updates
   if (InsertInIndexes(tuple, location, transaction, index_entry_ptr) == false) {
     LOG_TRACE("Index constraint violated");
+    AbortAppend(location);
     return INVALID_ITEMPOINTER;
   }
 
   // ForeignKey checks
-  if (CheckForeignKeyConstraints(tuple) == false) {
+  if (CheckForeignKeyConstraints(tuple, foreign_key_cache) == false) {
     LOG_TRACE("ForeignKey constraint violated");
+    AbortAppend(location);
     return INVALID_ITEMPOINTER;
   }
 
@@ -340,29 +409,7 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
                                 ItemPointer **index_entry_ptr) {
   int index_count = GetIndexCount();
 
-  size_t active_indirection_array_id =
-      number_of_tuples_ % active_indirection_array_count_;
-
-  size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
-
-  while (true) {
-    auto active_indirection_array =
-        active_indirection_arrays_[active_indirection_array_id];
-    indirection_offset = active_indirection_array->AllocateIndirection();
-
-    if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
-      *index_entry_ptr =
-          active_indirection_array->GetIndirectionByOffset(indirection_offset);
-      break;
-    }
-  }
-
-  (*index_entry_ptr)->block = location.block;
-  (*index_entry_ptr)->offset = location.offset;
-
-  if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
-    AddDefaultIndirectionArray(active_indirection_array_id);
-  }
+  *index_entry_ptr = AllocateIndirection(location);
 
   auto &transaction_manager =
       concurrency::TransactionManagerFactory::GetInstance();
@@ -378,10 +425,12 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
   for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
     auto index = GetIndex(index_itr);
     if (index == nullptr) continue;
+    // a partial index skips the tuples that do not satisfy its predicate
+    if (index->GetMetadata()->SatisfiesPredicate(tuple) == false) continue;
     auto index_schema = index->GetKeySchema();
     auto indexed_columns = index_schema->GetIndexedColumns();
-    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
+    storage::Tuple key(index_schema, GetKeyBuffer(index_schema));
+    key.SetFromTuple(tuple, indexed_columns, index->GetPool());
 
     switch (index->GetIndexType()) {
       case IndexConstraintType::PRIMARY_KEY:
@@ -389,12 +438,12 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
         // get unique tuple from primary/unique index.
         // if in this index there has been a visible or uncommitted
         // <key, location> pair, this constraint is violated
-        res = index->CondInsertEntry(key.get(), *index_entry_ptr, fn);
+        res = index->CondInsertEntry(&key, *index_entry_ptr, fn);
       } break;
 
       case IndexConstraintType::DEFAULT:
       default:
-        index->InsertEntry(key.get(), *index_entry_ptr);
+        index->InsertEntry(&key, *index_entry_ptr);
         break;
     }
 
@@ -403,9 +452,13 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
       // If some of the indexes have been inserted,
       // the pointer has a chance to be dereferenced by readers and it cannot be
       // deleted
+      if (success_count == 0) {
+        ReleaseIndirection(*index_entry_ptr);
+      }
       *index_entry_ptr = nullptr;
       return false;
     } else {
+      IndirectionArray::AddIndexEntry(*index_entry_ptr);
       success_count += 1;
     }
     LOG_TRACE("Index constraint check on %s passed.", index->GetName().c_str());
@@ -414,6 +467,265 @@ bool DataTable::InsertInIndexes(const storage::Tuple *tuple,
   return true;
 }
 
+ItemPointer *DataTable::AllocateIndirection(const ItemPointer &location) {
+  ItemPointer *index_entry_ptr = nullptr;
+
+  // reuse an indirection of a reclaimed tuple if there is one
+  if (recycled_indirections_.Dequeue(index_entry_ptr) == true) {
+    PL_ASSERT(IndirectionArray::GetIndexEntryCount(index_entry_ptr) == 0);
+    index_entry_ptr->block = location.block;
+    index_entry_ptr->offset = location.offset;
+    return index_entry_ptr;
+  }
+
+  size_t active_indirection_array_id =
+      number_of_tuples_ % active_indirection_array_count_;
+
+  size_t indirection_offset = INVALID_INDIRECTION_OFFSET;
+
+  while (true) {
+    auto active_indirection_array =
+        active_indirection_arrays_[active_indirection_array_id];
+    indirection_offset = active_indirection_array->AllocateIndirection();
+
+    if (indirection_offset != INVALID_INDIRECTION_OFFSET) {
+      index_entry_ptr =
+          active_indirection_array->GetIndirectionByOffset(indirection_offset);
+      break;
+    }
+  }
+
+  index_entry_ptr->block = location.block;
+  index_entry_ptr->offset = location.offset;
+
+  // create the next array before this one runs out, so that the inserter
+  // that takes the last indirection does not stall the others
+  if (indirection_offset == INDIRECTION_ARRAY_PREALLOCATE_SIZE) {
+    PrepareIndirectionArray(active_indirection_array_id);
+  }
+
+  if (indirection_offset == INDIRECTION_ARRAY_MAX_SIZE - 1) {
+    AddDefaultIndirectionArray(active_indirection_array_id);
+  }
+
+  return index_entry_ptr;
+}
+
+void DataTable::ReleaseIndirection(ItemPointer *indirection) {
+  PL_ASSERT(IndirectionArray::GetIndexEntryCount(indirection) == 0);
+  recycled_indirections_.Enqueue(indirection);
+}
+
+bool DataTable::BulkInsert(const std::vector<std::unique_ptr<Tuple>> &tuples,
+                           concurrency::Transaction *transaction) {
+  if (partitioned_table_ != nullptr) {
+    return partitioned_table_->BulkInsert(tuples, transaction);
+  }
+
+  for (auto &tuple : tuples) {
+    if (CheckConstraints(tuple.get()) == false) {
+      LOG_TRACE("Constraint violated");
+      return false;
+    }
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+  auto column_map = GetTileGroupLayout((LayoutType)peloton_layout_mode);
+  size_t tuple_count = tuples.size();
+
+  std::vector<ItemPointer> locations;
+  locations.reserve(tuple_count);
+
+  // fill fresh tile groups. they are not reachable through the table until
+  // every slot in them is owned by the transaction.
+  size_t tuples_per_tilegroup = tuples_per_tilegroup_;
+  for (size_t tuple_itr = 0; tuple_itr < tuple_count;
+       tuple_itr += tuples_per_tilegroup) {
+    std::shared_ptr<TileGroup> tile_group(
+        GetTileGroupWithLayout(column_map, INVALID_NUMA_NODE));
+    PL_ASSERT(tile_group.get());
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+
+    size_t batch_end = std::min(tuple_count, tuple_itr + tuples_per_tilegroup);
+    for (size_t batch_itr = tuple_itr; batch_itr < batch_end; batch_itr++) {
+      oid_t tuple_slot = tile_group->InsertTuple(tuples[batch_itr].get());
+      PL_ASSERT(tuple_slot != INVALID_OID);
+      locations.emplace_back(tile_group_id, tuple_slot);
+    }
+
+    manager.AddTileGroup(tile_group_id, tile_group);
+
+    transaction_manager.PerformBulkInsert(transaction, tile_group_id,
+                                          batch_end - tuple_itr);
+
+    tile_groups_.Append(tile_group_id);
+
+    // we must guarantee that the compiler always add tile group before adding
+    // tile_group_count_.
+    COMPILER_MEMORY_FENCE;
+
+    tile_group_count_++;
+  }
+
+  IncreaseTupleCount(tuple_count);
+
+  if (GetIndexCount() == 0) {
+    return true;
+  }
+
+  std::vector<ItemPointer *> index_entry_ptrs;
+  index_entry_ptrs.reserve(tuple_count);
+  for (auto &location : locations) {
+    auto index_entry_ptr = AllocateIndirection(location);
+    manager.GetTileGroup(location.block)
+        ->GetHeader()
+        ->SetIndirection(location.offset, index_entry_ptr);
+    index_entry_ptrs.push_back(index_entry_ptr);
+  }
+
+  if (BulkInsertInIndexes(tuples, index_entry_ptrs, transaction) == false) {
+    LOG_TRACE("Index constraint violated");
+    return false;
+  }
+
+  if (foreign_keys_.empty() == false) {
+    std::vector<const Tuple *> fk_tuples;
+    fk_tuples.reserve(tuple_count);
+    for (auto &tuple : tuples) {
+      fk_tuples.push_back(tuple.get());
+    }
+    if (CheckForeignKeyConstraints(fk_tuples) == false) {
+      LOG_TRACE("ForeignKey constraint violated");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool DataTable::BulkInsertInIndexes(
+    const std::vector<std::unique_ptr<Tuple>> &tuples,
+    const std::vector<ItemPointer *> &index_entry_ptrs,
+    concurrency::Transaction *transaction) {
+  int index_count = GetIndexCount();
+
+  auto &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  std::function<bool(const void *)> fn =
+      std::bind(&concurrency::TransactionManager::IsOccupied,
+                &transaction_manager, transaction, std::placeholders::_1);
+
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr) continue;
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+
+    std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer *>>
+        entries;
+    entries.reserve(tuples.size());
+    for (size_t tuple_itr = 0; tuple_itr < tuples.size(); tuple_itr++) {
+      if (index->GetMetadata()->SatisfiesPredicate(tuples[tuple_itr].get()) ==
+          false) {
+        continue;
+      }
+      std::unique_ptr<storage::Tuple> key(
+          new storage::Tuple(index_schema, true));
+      key->SetFromTuple(tuples[tuple_itr].get(), indexed_columns,
+                        index->GetPool());
+      entries.emplace_back(std::move(key), index_entry_ptrs[tuple_itr]);
+    }
+
+    // inserting in key order keeps the index appends local
+    std::sort(entries.begin(), entries.end(),
+              [](const std::pair<std::unique_ptr<storage::Tuple>,
+                                 ItemPointer *> &lhs,
+                 const std::pair<std::unique_ptr<storage::Tuple>,
+                                 ItemPointer *> &rhs) {
+                return lhs.first->Compare(*rhs.first) < 0;
+              });
+
+    for (auto &entry : entries) {
+      bool res = true;
+      switch (index->GetIndexType()) {
+        case IndexConstraintType::PRIMARY_KEY:
+        case IndexConstraintType::UNIQUE:
+          res = index->CondInsertEntry(entry.first.get(), entry.second, fn);
+          break;
+
+        case IndexConstraintType::DEFAULT:
+        default:
+          index->InsertEntry(entry.first.get(), entry.second);
+          break;
+      }
+
+      if (res == false) {
+        return false;
+      }
+      IndirectionArray::AddIndexEntry(entry.second);
+    }
+    LOG_TRACE("Bulk loaded %lu entries into %s", entries.size(),
+              index->GetName().c_str());
+  }
+
+  return true;
+}
+
+bool DataTable::IsHeapOnlyUpdate(const AbstractTuple *tuple,
+                                 const TargetList *targets_ptr,
+                                 const AbstractTuple *old_tuple) {
+  // A target column is changed unless the old version has the same value
+  auto is_changed = [&](oid_t column_id) {
+    bool is_target = false;
+    for (const auto &target : *targets_ptr) {
+      if (target.first == column_id) {
+        is_target = true;
+        break;
+      }
+    }
+    if (is_target == false) {
+      return false;
+    }
+    if (old_tuple == nullptr) {
+      return true;
+    }
+    auto new_value = tuple->GetValue(column_id);
+    auto old_value = old_tuple->GetValue(column_id);
+    if (new_value.IsNull() || old_value.IsNull()) {
+      return new_value.IsNull() != old_value.IsNull();
+    }
+    return new_value.CompareNotEquals(old_value) == type::CmpBool::CMP_TRUE;
+  };
+
+  size_t index_count = GetIndexCount();
+  for (size_t index_itr = 0; index_itr < index_count; index_itr++) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr ||
+        index->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+      continue;
+    }
+    // An index that is built in the background gets every new version
+    auto index_metadata = index->GetMetadata();
+    if (index_metadata->IsBuilding() == true) {
+      return false;
+    }
+    for (auto column_id : index_metadata->GetKeyAttrs()) {
+      if (is_changed(column_id)) {
+        return false;
+      }
+    }
+    for (auto column_id : index_metadata->GetPredicateColumns()) {
+      if (is_changed(column_id)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
                                          const TargetList *targets_ptr,
                                          concurrency::Transaction *transaction,
@@ -458,31 +770,79 @@ bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
       }
     }
 
-    // If attributes on key are not updated, skip the index update
-    if (updated == false) {
+    // A partial index holds the new version if it satisfies the predicate.
+    // The old version may not have, when the predicate columns are updated.
+    auto index_metadata = index->GetMetadata();
+    if (index_metadata->SatisfiesPredicate(tuple) == false) {
       continue;
     }
+    for (auto col : index_metadata->GetPredicateColumns()) {
+      if (targets_set.find(col) != targets_set.end()) {
+        updated = true;
+        break;
+      }
+    }
 
-    // Key attributes are updated, insert a new entry in all secondary index
-    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+    // If attributes on key are not updated, skip the index update. An index
+    // that is built in the background may not hold the key of the old
+    // version yet, so it gets the key of every new version.
+    if (updated == false && index_metadata->IsBuilding() == false) {
+      continue;
+    }
 
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
+    // Key attributes are updated, insert a new entry in all secondary index
+    storage::Tuple key(index_schema, GetKeyBuffer(index_schema));
+    key.SetFromTuple(tuple, indexed_columns, index->GetPool());
 
     switch (index->GetIndexType()) {
       case IndexConstraintType::PRIMARY_KEY:
       case IndexConstraintType::UNIQUE: {
-        res = index->CondInsertEntry(key.get(), index_entry_ptr, fn);
+        res = index->CondInsertEntry(&key, index_entry_ptr, fn);
       } break;
       case IndexConstraintType::DEFAULT:
       default:
-        index->InsertEntry(key.get(), index_entry_ptr);
+        // the background build may have inserted the unchanged key already
+        if (index->InsertEntry(&key, index_entry_ptr) == false &&
+            updated == false) {
+          continue;
+        }
         break;
     }
+    if (res == true) {
+      IndirectionArray::AddIndexEntry(index_entry_ptr);
+    }
     LOG_TRACE("Index constraint check on %s passed.", index->GetName().c_str());
   }
   return res;
 }
 
+bool DataTable::GetReferencedIndex(const catalog::ForeignKey *foreign_key,
+                                   std::shared_ptr<index::Index> &index) {
+  oid_t sink_table_id = foreign_key->GetSinkTableOid();
+  storage::DataTable *ref_table = nullptr;
+  try {
+    ref_table = (storage::DataTable *)storage::StorageManager::GetInstance()
+                    ->GetTableWithOid(database_oid, sink_table_id);
+  } catch (CatalogException &e) {
+    LOG_TRACE("Can't find table %d! Return false", sink_table_id);
+    return false;
+  }
+
+  // The foreign key constraints only refer to the primary key
+  index = nullptr;
+  int ref_table_index_count = ref_table->GetIndexCount();
+  for (int index_itr = ref_table_index_count - 1; index_itr >= 0;
+       --index_itr) {
+    auto ref_index = ref_table->GetIndex(index_itr);
+    if (ref_index != nullptr &&
+        ref_index->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
+      index = ref_index;
+      break;
+    }
+  }
+  return true;
+}
+
 /**
  * @brief Check if all the foreign key constraints on this table
  * is satisfied by checking whether the key exist in the referred table
@@ -494,51 +854,114 @@ bool DataTable::InsertInSecondaryIndexes(const AbstractTuple *tuple,
  *   We should modify this function and add logic to check
  *   if the result of the ScanKey is visible.
  *
+ * The keys found in the foreign key cache, if any, are not probed again, and
+ * the keys that were found are added to it.
+ *
  * @returns True on success, false if any foreign key constraints fail
  */
-bool DataTable::CheckForeignKeyConstraints(const storage::Tuple *tuple
-                                               UNUSED_ATTRIBUTE) {
+bool DataTable::CheckForeignKeyConstraints(const storage::Tuple *tuple,
+                                           ForeignKeyCache *foreign_key_cache) {
   for (auto foreign_key : foreign_keys_) {
-    oid_t sink_table_id = foreign_key->GetSinkTableOid();
-    storage::DataTable *ref_table = nullptr;
-    try{
-        ref_table = (storage::DataTable *)storage::StorageManager::GetInstance()
-            ->GetTableWithOid(database_oid, sink_table_id);
-    } catch (CatalogException &e) {
-        LOG_TRACE("Can't find table %d! Return false", sink_table_id);
-        return false;
+    std::shared_ptr<index::Index> index;
+    if (GetReferencedIndex(foreign_key, index) == false) {
+      return false;
     }
-    int ref_table_index_count = ref_table->GetIndexCount();
+    if (index == nullptr) continue;
 
-    for (int index_itr = ref_table_index_count - 1; index_itr >= 0;
-         --index_itr) {
-      auto index = ref_table->GetIndex(index_itr);
-      if (index == nullptr) continue;
+    LOG_TRACE("BEGIN checking referred table");
+    auto key_attrs = foreign_key->GetFKColumnOffsets();
 
-      // The foreign key constraints only refer to the primary key
-      if (index->GetIndexType() == IndexConstraintType::PRIMARY_KEY) {
-        LOG_TRACE("BEGIN checking referred table");
-        auto key_attrs = foreign_key->GetFKColumnOffsets();
+    std::unique_ptr<catalog::Schema> foreign_key_schema(
+        catalog::Schema::CopySchema(schema, key_attrs));
+    std::unique_ptr<storage::Tuple> key(
+        new storage::Tuple(foreign_key_schema.get(), true));
+    // FIXME: what is the 3rd arg should be?
+    key->SetFromTuple(tuple, key_attrs, index->GetPool());
 
-        std::unique_ptr<catalog::Schema> foreign_key_schema(
-            catalog::Schema::CopySchema(schema, key_attrs));
-        std::unique_ptr<storage::Tuple> key(
-            new storage::Tuple(foreign_key_schema.get(), true));
-        // FIXME: what is the 3rd arg should be?
-        key->SetFromTuple(tuple, key_attrs, index->GetPool());
+    LOG_TRACE("check key: %s", key->GetInfo().c_str());
 
-        LOG_TRACE("check key: %s", key->GetInfo().c_str());
+    std::string cache_key;
+    if (foreign_key_cache != nullptr) {
+      cache_key = ForeignKeyCache::MakeKey(key.get());
+      if (foreign_key_cache->Contains(foreign_key, cache_key)) {
+        continue;
+      }
+    }
 
-        std::vector<ItemPointer *> location_ptrs;
-        index->ScanKey(key.get(), location_ptrs);
+    std::vector<ItemPointer *> location_ptrs;
+    index->ScanKey(key.get(), location_ptrs);
 
-        // if this key doesn't exist in the refered column
-        if (location_ptrs.size() == 0) {
-          return false;
-        }
+    // if this key doesn't exist in the refered column
+    if (location_ptrs.size() == 0) {
+      return false;
+    }
 
-        break;
+    if (foreign_key_cache != nullptr) {
+      foreign_key_cache->Add(foreign_key, cache_key);
+    }
+  }
+
+  return true;
+}
+
+bool DataTable::CheckForeignKeyConstraints(
+    const std::vector<const Tuple *> &tuples,
+    ForeignKeyCache *foreign_key_cache) {
+  // without a cache of the caller, the keys are only deduplicated
+  ForeignKeyCache local_cache;
+  if (foreign_key_cache == nullptr) {
+    foreign_key_cache = &local_cache;
+  }
+
+  for (auto foreign_key : foreign_keys_) {
+    std::shared_ptr<index::Index> index;
+    if (GetReferencedIndex(foreign_key, index) == false) {
+      return false;
+    }
+    if (index == nullptr) continue;
+
+    auto key_attrs = foreign_key->GetFKColumnOffsets();
+    std::unique_ptr<catalog::Schema> foreign_key_schema(
+        catalog::Schema::CopySchema(schema, key_attrs));
+
+    // the distinct keys that are not known to exist yet
+    std::unordered_set<std::string> pending;
+    std::vector<std::string> cache_keys;
+    std::vector<std::unique_ptr<storage::Tuple>> keys;
+    for (auto tuple : tuples) {
+      std::unique_ptr<storage::Tuple> key(
+          new storage::Tuple(foreign_key_schema.get(), true));
+      key->SetFromTuple(tuple, key_attrs, index->GetPool());
+      auto cache_key = ForeignKeyCache::MakeKey(key.get());
+      if (foreign_key_cache->Contains(foreign_key, cache_key) ||
+          pending.insert(cache_key).second == false) {
+        continue;
       }
+      cache_keys.push_back(std::move(cache_key));
+      keys.push_back(std::move(key));
+    }
+    if (keys.empty()) continue;
+
+    LOG_TRACE("Probing %lu distinct keys of %lu tuples", keys.size(),
+              tuples.size());
+    std::vector<const storage::Tuple *> key_ptrs;
+    key_ptrs.reserve(keys.size());
+    for (auto &key : keys) {
+      key_ptrs.push_back(key.get());
+    }
+    std::vector<std::vector<ItemPointer *>> results;
+    index->ScanKeys(key_ptrs, results);
+
+    bool all_found = true;
+    for (size_t key_itr = 0; key_itr < keys.size(); key_itr++) {
+      if (results[key_itr].empty()) {
+        all_found = false;
+      } else {
+        foreign_key_cache->Add(foreign_key, cache_keys[key_itr]);
+      }
+    }
+    if (all_found == false) {
+      return false;
     }
   }
 
@@ -555,6 +978,7 @@ bool DataTable::CheckForeignKeyConstraints(const storage::Tuple *tuple
  */
 void DataTable::IncreaseTupleCount(const size_t &amount) {
   number_of_tuples_ += amount;
+  modified_tuple_count_ += amount;
   dirty_ = true;
 }
 
@@ -598,14 +1022,44 @@ void DataTable::ResetDirty() { dirty_ = false; }
 //===--------------------------------------------------------------------===//
 
 TileGroup *DataTable::GetTileGroupWithLayout(
-    const column_map_type &partitioning) {
+    const column_map_type &partitioning, const int numa_node) {
   oid_t tile_group_id = catalog::Manager::GetInstance().GetNextTileGroupId();
-  return (AbstractTable::GetTileGroupWithLayout(
-      database_oid, tile_group_id, partitioning, tuples_per_tilegroup_));
+  return (AbstractTable::GetTileGroupWithLayout(database_oid, tile_group_id,
+                                                partitioning,
+                                                tuples_per_tilegroup_,
+                                                numa_node));
 }
 
 oid_t DataTable::AddDefaultIndirectionArray(
     const size_t &active_indirection_array_id) {
+  auto indirection_array =
+      std::atomic_exchange(&spare_indirection_arrays_[active_indirection_array_id],
+                           std::shared_ptr<IndirectionArray>());
+  if (indirection_array == nullptr) {
+    indirection_array = CreateIndirectionArray();
+  }
+
+  COMPILER_MEMORY_FENCE;
+
+  active_indirection_arrays_[active_indirection_array_id] = indirection_array;
+
+  return indirection_array->GetOid();
+}
+
+void DataTable::PrepareIndirectionArray(
+    const size_t &active_indirection_array_id) {
+  // a spare left over from a race with the inserter that replaced the array
+  if (std::atomic_load(&spare_indirection_arrays_[active_indirection_array_id]) !=
+      nullptr) {
+    return;
+  }
+
+  auto indirection_array = CreateIndirectionArray();
+  std::atomic_store(&spare_indirection_arrays_[active_indirection_array_id],
+                    indirection_array);
+}
+
+std::shared_ptr<IndirectionArray> DataTable::CreateIndirectionArray() {
   auto &manager = catalog::Manager::GetInstance();
   oid_t indirection_array_id = manager.GetNextIndirectionArrayId();
 
@@ -613,18 +1067,26 @@ oid_t DataTable::AddDefaultIndirectionArray(
       new IndirectionArray(indirection_array_id));
   manager.AddIndirectionArray(indirection_array_id, indirection_array);
 
-  COMPILER_MEMORY_FENCE;
-
-  active_indirection_arrays_[active_indirection_array_id] = indirection_array;
-
-  return indirection_array_id;
+  return indirection_array;
 }
 
 oid_t DataTable::AddDefaultTileGroup() {
-  size_t active_tile_group_id = number_of_tuples_ % active_tilegroup_count_;
+  size_t active_tile_group_id = GetActiveTileGroupId();
   return AddDefaultTileGroup(active_tile_group_id);
 }
 
+size_t DataTable::GetActiveTileGroupId() const {
+  size_t active_tilegroup_count = active_tilegroup_count_;
+  if (numa_node_count_ == 1) {
+    return number_of_tuples_ % active_tilegroup_count;
+  }
+
+  size_t numa_node = NumaUtil::GetCurrentNode() % numa_node_count_;
+  size_t node_tile_group_count = active_tilegroup_count / numa_node_count_;
+  return numa_node +
+         numa_node_count_ * (number_of_tuples_ % node_tile_group_count);
+}
+
 oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
   column_map_type column_map;
   oid_t tile_group_id = INVALID_OID;
@@ -632,12 +1094,29 @@ oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
   // Figure out the partitioning for given tilegroup layout
   column_map = GetTileGroupLayout((LayoutType)peloton_layout_mode);
 
-  // Create a tile group with that partitioning
-  std::shared_ptr<TileGroup> tile_group(GetTileGroupWithLayout(column_map));
+  // Place the tile group on the NUMA node of its active slot
+  int numa_node = INVALID_NUMA_NODE;
+  if (numa_node_count_ > 1) {
+    numa_node = static_cast<int>(active_tile_group_id % numa_node_count_);
+  }
+
+  // Take the spare tile group unless the layout or the size it was made
+  // with is stale, else create a tile group with that partitioning
+  auto tile_group =
+      std::atomic_exchange(&spare_tile_groups_[active_tile_group_id],
+                           std::shared_ptr<TileGroup>());
+  if (tile_group == nullptr || tile_group->GetColumnMap() != column_map ||
+      tile_group->GetAllocatedTupleCount() != tuples_per_tilegroup_) {
+    tile_group.reset(GetTileGroupWithLayout(column_map, numa_node));
+  }
   PL_ASSERT(tile_group.get());
 
   tile_group_id = tile_group->GetTileGroupId();
 
+  if (append_only_ == true) {
+    tile_group->GetHeader()->SetAppendOnly();
+  }
+
   LOG_TRACE("Added a tile group ");
   tile_groups_.Append(tile_group_id);
 
@@ -659,6 +1138,126 @@ oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
   return tile_group_id;
 }
 
+size_t DataTable::PrepareTileGroups() {
+  column_map_type column_map =
+      GetTileGroupLayout((LayoutType)peloton_layout_mode);
+
+  size_t created_count = 0;
+  size_t active_tilegroup_count = active_tilegroup_count_;
+  for (size_t slot_itr = 0; slot_itr < active_tilegroup_count; slot_itr++) {
+    if (std::atomic_load(&spare_tile_groups_[slot_itr]) != nullptr) {
+      continue;
+    }
+
+    int numa_node = INVALID_NUMA_NODE;
+    if (numa_node_count_ > 1) {
+      numa_node = static_cast<int>(slot_itr % numa_node_count_);
+    }
+    std::shared_ptr<TileGroup> tile_group(
+        GetTileGroupWithLayout(column_map, numa_node));
+
+    // if an inserter created its own tile group meanwhile, this one waits
+    // for the next time the slot fills
+    std::atomic_store(&spare_tile_groups_[slot_itr], tile_group);
+    created_count++;
+  }
+
+  return created_count;
+}
+
+size_t DataTable::AdjustActiveTileGroupCount(
+    const size_t active_tile_group_count) {
+  std::lock_guard<std::mutex> lock(active_tile_group_mutex_);
+
+  // Every NUMA node keeps the same number of active tile groups
+  size_t max_count = active_tile_groups_.size();
+  max_count -= max_count % numa_node_count_;
+  size_t new_count = std::max(active_tile_group_count, numa_node_count_);
+  if (new_count % numa_node_count_ != 0) {
+    new_count += numa_node_count_ - new_count % numa_node_count_;
+  }
+  new_count = std::min(new_count, max_count);
+
+  // Slots that were active before still hold their tile group, the others
+  // get one before any insert can pick them
+  for (size_t slot_itr = active_tilegroup_count_; slot_itr < new_count;
+       slot_itr++) {
+    if (active_tile_groups_[slot_itr] == nullptr) {
+      AddDefaultTileGroup(slot_itr);
+    }
+  }
+
+  COMPILER_MEMORY_FENCE;
+
+  // Inserts that picked a slot past a smaller count still find their tile
+  // group there
+  active_tilegroup_count_ = new_count;
+
+  LOG_TRACE("Table %u inserts into %lu active tile groups", table_oid,
+            new_count);
+  return new_count;
+}
+
+void DataTable::SetTuplesPerTileGroup(const size_t tuples_per_tilegroup) {
+  PL_ASSERT(tuples_per_tilegroup > 0);
+  tuples_per_tilegroup_ = tuples_per_tilegroup;
+}
+
+void DataTable::SetPartitionedTable(
+    std::unique_ptr<PartitionedTable> partitioned_table) {
+  PL_ASSERT(partitioned_table_ == nullptr && GetTupleCount() == 0);
+  partitioned_table_ = std::move(partitioned_table);
+}
+
+bool DataTable::SetAppendOnly() {
+  std::lock_guard<std::mutex> lock(active_tile_group_mutex_);
+  if (number_of_tuples_ > 0) {
+    return false;
+  }
+
+  // the tile groups added from now on are marked when they are created
+  append_only_ = true;
+
+  size_t tile_group_count = tile_group_count_;
+  for (size_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = GetTileGroup(tile_group_offset);
+    if (tile_group != nullptr) {
+      tile_group->GetHeader()->SetAppendOnly();
+    }
+  }
+
+  LOG_TRACE("Table %u is append-only", table_oid);
+  return true;
+}
+
+bool DataTable::SetTimeToLive(const oid_t column_id,
+                              const uint64_t time_to_live) {
+  if (column_id >= schema->GetColumnCount() ||
+      schema->GetType(column_id) != type::TypeId::TIMESTAMP) {
+    return false;
+  }
+
+  // the expirer reads the column after the time to live
+  ttl_ = time_to_live;
+  ttl_column_id_ = column_id;
+
+  LOG_TRACE("Tuples of table %u expire after %lu us", table_oid,
+            time_to_live);
+  return true;
+}
+
+void DataTable::AbortAppend(const ItemPointer &location) {
+  if (append_only_ == false) {
+    return;
+  }
+  auto tile_group_header =
+      catalog::Manager::GetInstance().GetTileGroup(location.block)->GetHeader();
+  if (tile_group_header->IsAppendOnly() == true) {
+    tile_group_header->AbortAppend();
+  }
+}
+
 void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
   PL_ASSERT(tile_group_id);
 
@@ -718,6 +1317,168 @@ void DataTable::AddTileGroup(const std::shared_ptr<TileGroup> &tile_group) {
   LOG_TRACE("Recording tile group : %u ", tile_group_id);
 }
 
+void DataTable::AddCommittedTileGroup(
+    const std::shared_ptr<TileGroup> &tile_group) {
+  oid_t tile_group_id = tile_group->GetTileGroupId();
+
+  catalog::Manager::GetInstance().AddTileGroup(tile_group_id, tile_group);
+
+  tile_groups_.Append(tile_group_id);
+
+  // we must guarantee that the compiler always add tile group before adding
+  // tile_group_count_.
+  COMPILER_MEMORY_FENCE;
+
+  tile_group_count_++;
+
+  IncreaseTupleCount(tile_group->GetHeader()->GetCurrentNextTupleSlot());
+}
+
+void DataTable::InsertTileGroupsInIndexes(
+    const std::vector<oid_t> &tile_group_ids) {
+  if (GetIndexCount() == 0) {
+    return;
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+
+  std::vector<std::shared_ptr<TileGroup>> tile_groups;
+  std::vector<ItemPointer *> index_entry_ptrs;
+  for (auto tile_group_id : tile_group_ids) {
+    auto tile_group = manager.GetTileGroup(tile_group_id);
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+      auto index_entry_ptr =
+          AllocateIndirection(ItemPointer(tile_group_id, tuple_slot));
+      tile_group_header->SetIndirection(tuple_slot, index_entry_ptr);
+      index_entry_ptrs.push_back(index_entry_ptr);
+    }
+    tile_groups.push_back(tile_group);
+  }
+
+  int index_count = GetIndexCount();
+  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr) continue;
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+
+    std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer *>>
+        entries;
+    entries.reserve(index_entry_ptrs.size());
+    size_t entry_itr = 0;
+    for (auto &tile_group : tile_groups) {
+      oid_t tuple_count = tile_group->GetHeader()->GetCurrentNextTupleSlot();
+      for (oid_t tuple_slot = 0; tuple_slot < tuple_count; tuple_slot++) {
+        expression::ContainerTuple<TileGroup> tuple(tile_group.get(),
+                                                    tuple_slot);
+        auto index_entry_ptr = index_entry_ptrs[entry_itr++];
+        if (index->GetMetadata()->SatisfiesPredicate(&tuple) == false) {
+          continue;
+        }
+        std::unique_ptr<storage::Tuple> key(
+            new storage::Tuple(index_schema, true));
+        key->SetFromTuple(&tuple, indexed_columns, index->GetPool());
+        entries.emplace_back(std::move(key), index_entry_ptr);
+      }
+    }
+
+    // the committed tuples satisfied the unique constraints already
+    LoadIndex(index.get(), entries, nullptr);
+    LOG_TRACE("Inserted %lu entries of committed tile groups into %s",
+              entries.size(), index->GetName().c_str());
+  }
+}
+
+void DataTable::BeginIndexFill() {
+  std::lock_guard<std::mutex> lock(index_fill_mutex_);
+  PL_ASSERT(index_fill_pending_ == false);
+  size_t index_count = GetIndexCount();
+  for (size_t index_itr = 0; index_itr < index_count; index_itr++) {
+    auto index = GetIndex(index_itr);
+    if (index == nullptr || index->GetMetadata()->IsBuilding() == true) {
+      continue;
+    }
+    index->GetMetadata()->SetBuilding(true);
+    filling_indexes_.push_back(index);
+  }
+  index_fill_pending_ = true;
+}
+
+void DataTable::EndIndexFill() {
+  {
+    std::lock_guard<std::mutex> lock(index_fill_mutex_);
+    for (auto &index : filling_indexes_) {
+      index->GetMetadata()->SetBuilding(false);
+    }
+    filling_indexes_.clear();
+    index_fill_pending_ = false;
+  }
+  index_fill_cv_.notify_all();
+}
+
+void DataTable::WaitForIndexFill() {
+  if (index_fill_pending_ == false) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(index_fill_mutex_);
+  index_fill_cv_.wait(lock, [this] { return index_fill_pending_ == false; });
+}
+
+bool DataTable::LoadIndex(
+    index::Index *index,
+    std::vector<std::pair<std::unique_ptr<Tuple>, ItemPointer *>> &entries,
+    concurrency::Transaction *transaction) {
+  if (index->BulkLoad(entries) == true) {
+    for (auto &entry : entries) {
+      IndirectionArray::AddIndexEntry(entry.second);
+    }
+    LOG_TRACE("Bulk loaded %lu entries into %s", entries.size(),
+              index->GetName().c_str());
+    return true;
+  }
+
+  // inserting in key order keeps the index appends local
+  std::sort(entries.begin(), entries.end(),
+            [](const std::pair<std::unique_ptr<storage::Tuple>,
+                               ItemPointer *> &lhs,
+               const std::pair<std::unique_ptr<storage::Tuple>,
+                               ItemPointer *> &rhs) {
+              return lhs.first->Compare(*rhs.first) < 0;
+            });
+
+  bool check_unique = transaction != nullptr &&
+                      (index->GetIndexType() ==
+                           IndexConstraintType::PRIMARY_KEY ||
+                       index->GetIndexType() == IndexConstraintType::UNIQUE);
+
+  std::function<bool(const void *)> fn;
+  if (check_unique == true) {
+    auto &transaction_manager =
+        concurrency::TransactionManagerFactory::GetInstance();
+    fn = std::bind(&concurrency::TransactionManager::IsOccupied,
+                   &transaction_manager, transaction, std::placeholders::_1);
+  }
+
+  bool res = true;
+  for (auto &entry : entries) {
+    bool inserted;
+    if (check_unique == true) {
+      inserted = index->CondInsertEntry(entry.first.get(), entry.second, fn);
+      res = res && inserted;
+    } else {
+      inserted = index->InsertEntry(entry.first.get(), entry.second);
+    }
+
+    if (inserted == true) {
+      IndirectionArray::AddIndexEntry(entry.second);
+    }
+  }
+
+  return res;
+}
+
 size_t DataTable::GetTileGroupCount() const { return tile_group_count_; }
 
 std::shared_ptr<storage::TileGroup> DataTable::GetTileGroup(
@@ -736,6 +1497,29 @@ std::shared_ptr<storage::TileGroup> DataTable::GetTileGroupById(
   return manager.GetTileGroup(tile_group_id);
 }
 
+storage::TileGroup *DataTable::ResolveTileGroup(
+    const std::size_t &tile_group_offset) const {
+  PL_ASSERT(tile_group_offset < GetTileGroupCount());
+
+  auto tile_group_id =
+      tile_groups_.FindValid(tile_group_offset, invalid_tile_group_id);
+
+  auto &manager = catalog::Manager::GetInstance();
+  return manager.ResolveTileGroup(tile_group_id);
+}
+
+bool DataTable::DropTileGroup(const oid_t &tile_group_id) {
+  if (tile_groups_.Contains(tile_group_id) == false) {
+    return false;
+  }
+
+  // the id stays in tile_groups_ so that the offsets of the other tile groups
+  // do not shift under concurrent scans. readers that already hold the tile
+  // group keep it alive.
+  catalog::Manager::GetInstance().DropTileGroup(tile_group_id);
+  return true;
+}
+
 void DataTable::DropTileGroups() {
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto tile_groups_size = tile_groups_.GetSize();
@@ -976,6 +1760,9 @@ void SetTransformedTileGroup(storage::TileGroup *orig_tile_group,
     }
   }
 
+  // The values were copied without going through the tile group
+  new_tile_group->GetZoneMap()->Merge(*orig_tile_group->GetZoneMap());
+
   // Finally, copy over the tile header
   auto header = orig_tile_group->GetHeader();
   auto new_header = new_tile_group->GetHeader();
@@ -1015,7 +1802,7 @@ storage::TileGroup *DataTable::TransformTileGroup(
           tile_group->GetDatabaseId(), tile_group->GetTableId(),
           tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
           new_schema, default_partition_,
-          tile_group->GetAllocatedTupleCount()));
+          tile_group->GetAllocatedTupleCount(), tile_group->GetNumaNode()));
 
   // Set the transformed tile group column-at-a-time
   SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
@@ -1027,6 +1814,102 @@ storage::TileGroup *DataTable::TransformTileGroup(
   return new_tile_group.get();
 }
 
+// No transaction owns a tuple of the tile group, and none can insert into it
+// or reuse one of its slots
+bool IsQuiescentTileGroup(const storage::TileGroup *tile_group) {
+  auto tile_group_header = tile_group->GetHeader();
+  auto tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+  if (tuple_count < tile_group->GetAllocatedTupleCount() ||
+      tile_group_header->IsFrozen() == true ||
+      tile_group_header->IsRetired() == true) {
+    return false;
+  }
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) != INITIAL_TXN_ID ||
+        tile_group_header->GetEndCommitId(tuple_id) != MAX_CID) {
+      return false;
+    }
+  }
+  return true;
+}
+
+storage::TileGroup *DataTable::RelayoutTileGroup(
+    const oid_t &tile_group_offset, const double &theta) {
+  // First, check if the tile group is in this table
+  if (tile_group_offset >= tile_groups_.GetSize()) {
+    LOG_ERROR("Tile group offset not found in table : %u ", tile_group_offset);
+    return nullptr;
+  }
+
+  auto tile_group_id =
+      tile_groups_.FindValid(tile_group_offset, invalid_tile_group_id);
+
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto tile_group = catalog_manager.GetTileGroup(tile_group_id);
+  if (tile_group == nullptr ||
+      tile_group->GetSchemaDifference(default_partition_) < theta) {
+    return nullptr;
+  }
+
+  auto tile_group_header = tile_group->GetHeader();
+  if (IsQuiescentTileGroup(tile_group.get()) == false) {
+    return nullptr;
+  }
+
+  // Writers that take ownership from now on give it up again. The ones that
+  // took it before are seen by the check that follows.
+  tile_group_header->StartRelocation();
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (IsQuiescentTileGroup(tile_group.get()) == false) {
+    tile_group_header->FinishRelocation();
+    return nullptr;
+  }
+
+  LOG_TRACE("Relocating tile group : %u", tile_group_offset);
+
+  auto new_schema =
+      TransformTileGroupSchema(tile_group.get(), default_partition_);
+
+  std::shared_ptr<storage::TileGroup> new_tile_group(
+      TileGroupFactory::GetTileGroup(
+          tile_group->GetDatabaseId(), tile_group->GetTableId(),
+          tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
+          new_schema, default_partition_,
+          tile_group->GetAllocatedTupleCount(), tile_group->GetNumaNode()));
+
+  // Readers keep reading the original while it is copied
+  SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
+  auto new_header = new_tile_group->GetHeader();
+  new_header->StartRelocation();
+
+  // A writer may have owned a tuple for a moment while it was copied
+  if (IsQuiescentTileGroup(new_tile_group.get()) == false) {
+    tile_group_header->FinishRelocation();
+    return nullptr;
+  }
+
+  // Switch the location of the tile group. The original stays relocating,
+  // and is released once the transactions that can reach it have ended.
+  catalog_manager.AddTileGroup(tile_group_id, new_tile_group);
+
+  // The transactions that began before the switch may have recorded their
+  // reads in the original only. None of them reads at a later commit id
+  // than a transaction that begins now.
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto read_commit_id = txn->GetCommitId();
+  txn_manager.CommitTransaction(txn);
+
+  auto tuple_count = new_header->GetCurrentNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    txn_manager.RecordRelocatedRead(new_header, tuple_id, read_commit_id);
+  }
+  new_header->FinishRelocation();
+
+  return new_tile_group.get();
+}
+
 void DataTable::RecordLayoutSample(const brain::Sample &sample) {
   // Add layout sample
   {
@@ -10,15 +10,25 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <sstream>
 
+#include "brain/knob_tuner.h"
 #include "catalog/foreign_key.h"
 #include "common/exception.h"
 #include "common/logger.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "storage/aggregate_view.h"
 #include "storage/database.h"
+#include "storage/index_builder.h"
 #include "storage/table_factory.h"
+#include "storage/tile_group_classifier.h"
+#include "storage/tile_group_compactor.h"
+#include "storage/tile_group_evictor.h"
+#include "storage/tile_group_freezer.h"
+#include "storage/tile_group_provisioner.h"
+#include "storage/tuple_expirer.h"
 
 namespace peloton {
 namespace storage {
@@ -29,7 +39,16 @@ Database::~Database() {
   // Clean up all the tables
   LOG_TRACE("Deleting tables from database");
   for (auto table : tables) {
-    if (table != nullptr) delete table;
+    if (table != nullptr) {
+      TileGroupFreezer::GetInstance().DropTable(table);
+      TileGroupEvictor::GetInstance().DropTable(table);
+      TileGroupCompactor::GetInstance().DropTable(table);
+      TupleExpirer::GetInstance().DropTable(table);
+      TileGroupProvisioner::GetInstance().DropTable(table);
+      IndexBuilder::GetInstance().DropTable(table);
+      AggregateViewManager::GetInstance().DropTable(table);
+      delete table;
+    }
   }
 
   LOG_TRACE("Finish deleting tables from database");
@@ -49,6 +68,24 @@ void Database::AddTable(storage::DataTable *table, bool is_catalog) {
       auto *gc_manager = &gc::GCManagerFactory::GetInstance();
       assert(gc_manager != nullptr);
       gc_manager->RegisterTable(table->GetOid());
+
+      // Register table to tile group freezer.
+      TileGroupFreezer::GetInstance().AddTable(table);
+
+      // Register table to tile group evictor.
+      TileGroupEvictor::GetInstance().AddTable(table);
+
+      // Register table to tile group compactor.
+      TileGroupCompactor::GetInstance().AddTable(table);
+
+      // Register table to tuple expirer.
+      TupleExpirer::GetInstance().AddTable(table);
+
+      // Register table to tile group provisioner.
+      TileGroupProvisioner::GetInstance().AddTable(table);
+
+      // Register table to knob tuner.
+      brain::KnobTuner::GetInstance().AddTable(table);
     }
   }
 }
@@ -75,27 +112,40 @@ storage::DataTable *Database::GetTableWithName(
 }
 
 void Database::DropTableWithOid(const oid_t table_oid) {
-  {
-    std::lock_guard<std::mutex> lock(database_mutex);
+  auto table = DetachTableWithOid(table_oid);
+  PL_ASSERT(table != nullptr);
+  delete table;
+}
 
-    // Deregister table from GC manager.
-    auto *gc_manager = &gc::GCManagerFactory::GetInstance();
-    assert(gc_manager != nullptr);
-    gc_manager->DeregisterTable(table_oid);
+storage::DataTable *Database::DetachTableWithOid(const oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(database_mutex);
 
-    oid_t table_offset = 0;
-    for (auto table : tables) {
-      if (table->GetOid() == table_oid) {
-        delete table;
-        break;
-      }
-      table_offset++;
-    }
-    PL_ASSERT(table_offset < tables.size());
-
-    // Drop the table
-    tables.erase(tables.begin() + table_offset);
+  auto table_itr = std::find_if(tables.begin(), tables.end(),
+                                [table_oid](storage::DataTable *table) {
+                                  return table->GetOid() == table_oid;
+                                });
+  if (table_itr == tables.end()) {
+    return nullptr;
   }
+  auto table = *table_itr;
+
+  // Deregister table from GC manager.
+  auto *gc_manager = &gc::GCManagerFactory::GetInstance();
+  assert(gc_manager != nullptr);
+  gc_manager->DeregisterTable(table_oid);
+
+  TileGroupFreezer::GetInstance().DropTable(table);
+  TileGroupEvictor::GetInstance().DropTable(table);
+  TileGroupCompactor::GetInstance().DropTable(table);
+  TupleExpirer::GetInstance().DropTable(table);
+  TileGroupProvisioner::GetInstance().DropTable(table);
+  brain::KnobTuner::GetInstance().DropTable(table);
+  TileGroupClassifier::GetInstance().DropTable(table);
+  IndexBuilder::GetInstance().DropTable(table);
+  AggregateViewManager::GetInstance().DropTable(table);
+
+  tables.erase(table_itr);
+  return table;
 }
 
 storage::DataTable *Database::GetTable(const oid_t table_offset) const {
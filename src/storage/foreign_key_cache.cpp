@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// foreign_key_cache.cpp
+//
+// Identification: src/storage/foreign_key_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/foreign_key_cache.h"
+
+#include "storage/tuple.h"
+#include "type/serializeio.h"
+
+namespace peloton {
+namespace storage {
+
+std::string ForeignKeyCache::MakeKey(const Tuple *key) {
+  CopySerializeOutput output;
+  oid_t column_count = key->GetColumnCount();
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    key->GetValue(column_itr).SerializeTo(output);
+  }
+  return std::string(output.Data(), output.Size());
+}
+
+bool ForeignKeyCache::Contains(const catalog::ForeignKey *foreign_key,
+                               const std::string &key) const {
+  auto itr = keys_.find(foreign_key);
+  return itr != keys_.end() && itr->second.count(key) > 0;
+}
+
+void ForeignKeyCache::Add(const catalog::ForeignKey *foreign_key,
+                          const std::string &key) {
+  keys_[foreign_key].insert(key);
+}
+
+size_t ForeignKeyCache::GetKeyCount() const {
+  size_t count = 0;
+  for (auto &keys : keys_) {
+    count += keys.second.size();
+  }
+  return count;
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,743 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_tile_group.cpp
+//
+// Identification: src/storage/frozen_tile_group.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/frozen_tile_group.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "expression/abstract_expression.h"
+#include "storage/tile_group.h"
+#include "storage/zone_map.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace storage {
+
+std::string ColumnEncodingTypeToString(ColumnEncodingType type) {
+  switch (type) {
+    case ColumnEncodingType::INVALID:
+      return "INVALID";
+    case ColumnEncodingType::DICTIONARY:
+      return "DICTIONARY";
+    case ColumnEncodingType::RUN_LENGTH:
+      return "RUN_LENGTH";
+    case ColumnEncodingType::BIT_PACKED:
+      return "BIT_PACKED";
+    default: {
+      throw ConversionException(
+          StringUtil::Format("No string conversion for ColumnEncodingType "
+                             "value '%d'",
+                             static_cast<int>(type)));
+    }
+  }
+  return "INVALID";
+}
+
+//===--------------------------------------------------------------------===//
+// Frozen Dictionary
+//===--------------------------------------------------------------------===//
+
+FrozenDictionary::FrozenDictionary(const std::vector<type::Value> &values,
+                                   const FrozenDictionary *base) {
+  bool has_null = false;
+  auto add = [this, &has_null](const type::Value &value) {
+    if (value.IsNull()) {
+      has_null = true;
+      return;
+    }
+    uint32_t code;
+    if (Lookup(value, code) == false) {
+      lookup_.emplace(value.Hash(), entries_.size());
+      entries_.push_back(value.Copy());
+    }
+  };
+  if (base != nullptr) {
+    for (auto &entry : base->entries_) {
+      add(entry);
+    }
+  }
+  for (auto &value : values) {
+    add(value);
+  }
+
+  std::sort(entries_.begin(), entries_.end(),
+            [](const type::Value &a, const type::Value &b) {
+              return a.CompareLessThan(b) == type::CmpBool::CMP_TRUE;
+            });
+  non_null_count_ = entries_.size();
+
+  // NULL goes last
+  if (has_null) {
+    for (auto &value : values) {
+      if (value.IsNull()) {
+        entries_.push_back(value.Copy());
+        break;
+      }
+    }
+    if (entries_.size() == non_null_count_) {
+      entries_.push_back(base->entries_.back().Copy());
+    }
+  }
+
+  lookup_.clear();
+  for (uint32_t code = 0; code < non_null_count_; code++) {
+    lookup_.emplace(entries_[code].Hash(), code);
+  }
+}
+
+bool FrozenDictionary::Lookup(const type::Value &value,
+                              uint32_t &code) const {
+  if (value.IsNull()) {
+    code = non_null_count_;
+    return entries_.size() > non_null_count_;
+  }
+  auto range = lookup_.equal_range(value.Hash());
+  for (auto itr = range.first; itr != range.second; ++itr) {
+    if (entries_[itr->second].CompareEquals(value) ==
+        type::CmpBool::CMP_TRUE) {
+      code = itr->second;
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t FrozenDictionary::GetMemorySize() const {
+  size_t size = 0;
+  for (auto &value : entries_) {
+    size += sizeof(type::Value);
+    if (value.IsInlined() == false && value.IsNull() == false) {
+      size += value.GetLength();
+    }
+  }
+  return size;
+}
+
+//===--------------------------------------------------------------------===//
+// Frozen Column
+//===--------------------------------------------------------------------===//
+
+FrozenColumn::FrozenColumn(
+    const type::TypeId type_id, const std::vector<type::Value> &values,
+    std::shared_ptr<const FrozenDictionary> *shared_dictionary)
+    : type_id_(type_id), tuple_count_(values.size()) {
+  if (IsIntegralType(type_id_) == false) {
+    EncodeDictionary(values, shared_dictionary);
+    return;
+  }
+
+  std::vector<int64_t> integral_values;
+  integral_values.reserve(values.size());
+  for (auto &value : values) {
+    int64_t integral_value = 0;
+    UNUSED_ATTRIBUTE bool converted = ToIntegral(value, integral_value);
+    PL_ASSERT(converted);
+    integral_values.push_back(integral_value);
+  }
+
+  EncodeIntegral(integral_values);
+}
+
+bool FrozenColumn::IsIntegralType(const type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DATE:
+    case type::TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool FrozenColumn::ToIntegral(const type::Value &value, int64_t &result) {
+  switch (value.GetTypeId()) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+      result = value.GetAs<int8_t>();
+      return true;
+    case type::TypeId::SMALLINT:
+      result = value.GetAs<int16_t>();
+      return true;
+    case type::TypeId::INTEGER:
+      result = value.GetAs<int32_t>();
+      return true;
+    case type::TypeId::DATE:
+      result = value.GetAs<uint32_t>();
+      return true;
+    case type::TypeId::BIGINT:
+      result = value.GetAs<int64_t>();
+      return true;
+    case type::TypeId::TIMESTAMP:
+      result = static_cast<int64_t>(value.GetAs<uint64_t>());
+      return true;
+    default:
+      return false;
+  }
+}
+
+void FrozenColumn::EncodeIntegral(const std::vector<int64_t> &values) {
+  if (values.empty()) {
+    encoding_type_ = ColumnEncodingType::BIT_PACKED;
+    return;
+  }
+
+  int64_t min_value = values[0];
+  int64_t max_value = values[0];
+  size_t run_count = 1;
+  for (oid_t offset = 1; offset < values.size(); offset++) {
+    if (values[offset] < min_value) min_value = values[offset];
+    if (values[offset] > max_value) max_value = values[offset];
+    if (values[offset] != values[offset - 1]) run_count++;
+  }
+
+  // Compare the footprint of the two candidate encodings
+  uint8_t bit_width = GetBitWidth(static_cast<uint64_t>(max_value) -
+                                  static_cast<uint64_t>(min_value));
+  size_t packed_size = ((values.size() * bit_width + 63) / 64) * 8;
+  size_t run_length_size = run_count * (sizeof(int64_t) + sizeof(oid_t));
+
+  if (run_length_size < packed_size) {
+    encoding_type_ = ColumnEncodingType::RUN_LENGTH;
+    run_values_.reserve(run_count);
+    run_ends_.reserve(run_count);
+    for (oid_t offset = 0; offset < values.size(); offset++) {
+      if (offset == 0 || values[offset] != values[offset - 1]) {
+        run_values_.push_back(values[offset]);
+        run_ends_.push_back(offset + 1);
+      } else {
+        run_ends_.back() = offset + 1;
+      }
+    }
+    return;
+  }
+
+  encoding_type_ = ColumnEncodingType::BIT_PACKED;
+  base_value_ = min_value;
+  bit_width_ = bit_width;
+  packed_words_.resize((values.size() * bit_width_ + 63) / 64, 0);
+  for (oid_t offset = 0; offset < values.size(); offset++) {
+    Pack(packed_words_, bit_width_, offset,
+         static_cast<uint64_t>(values[offset]) -
+             static_cast<uint64_t>(base_value_));
+  }
+}
+
+void FrozenColumn::EncodeDictionary(
+    const std::vector<type::Value> &values,
+    std::shared_ptr<const FrozenDictionary> *shared_dictionary) {
+  encoding_type_ = ColumnEncodingType::DICTIONARY;
+
+  std::vector<uint32_t> codes(values.size());
+  auto encode = [&values, &codes](const FrozenDictionary &dictionary) {
+    for (size_t i = 0; i < values.size(); i++) {
+      if (dictionary.Lookup(values[i], codes[i]) == false) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  // Use the dictionary of the table if it has all the values
+  const FrozenDictionary *base = nullptr;
+  if (shared_dictionary != nullptr && *shared_dictionary != nullptr) {
+    base = shared_dictionary->get();
+    if (encode(*base) == true) {
+      dictionary_ = *shared_dictionary;
+    }
+  }
+
+  if (dictionary_ == nullptr) {
+    dictionary_.reset(new FrozenDictionary(values, base));
+    if (dictionary_->GetEntryCount() > FrozenDictionary::kMaxSharedSize &&
+        base != nullptr) {
+      // Too many values to share, keep the ones of this column only
+      dictionary_.reset(new FrozenDictionary(values, nullptr));
+    } else if (shared_dictionary != nullptr &&
+               dictionary_->GetEntryCount() <=
+                   FrozenDictionary::kMaxSharedSize) {
+      *shared_dictionary = dictionary_;
+    }
+    UNUSED_ATTRIBUTE bool encoded = encode(*dictionary_);
+    PL_ASSERT(encoded);
+  }
+
+  auto entry_count = dictionary_->GetEntryCount();
+  bit_width_ = GetBitWidth(entry_count == 0 ? 0 : entry_count - 1);
+  packed_words_.resize((codes.size() * bit_width_ + 63) / 64, 0);
+  for (oid_t offset = 0; offset < codes.size(); offset++) {
+    Pack(packed_words_, bit_width_, offset, codes[offset]);
+  }
+}
+
+type::Value FrozenColumn::GetValue(const oid_t tuple_offset) const {
+  PL_ASSERT(tuple_offset < tuple_count_);
+
+  if (encoding_type_ == ColumnEncodingType::DICTIONARY) {
+    auto code = Unpack(packed_words_, bit_width_, tuple_offset);
+    return dictionary_->GetValue(code);
+  }
+
+  return MakeIntegralValue(GetIntegralValue(tuple_offset));
+}
+
+int64_t FrozenColumn::GetIntegralValue(const oid_t tuple_offset) const {
+  if (encoding_type_ == ColumnEncodingType::RUN_LENGTH) {
+    // Binary search for the run containing the tuple
+    auto itr = std::upper_bound(run_ends_.begin(), run_ends_.end(),
+                                tuple_offset);
+    PL_ASSERT(itr != run_ends_.end());
+    return run_values_[itr - run_ends_.begin()];
+  }
+
+  PL_ASSERT(encoding_type_ == ColumnEncodingType::BIT_PACKED);
+  return static_cast<int64_t>(static_cast<uint64_t>(base_value_) +
+                              Unpack(packed_words_, bit_width_, tuple_offset));
+}
+
+type::Value FrozenColumn::MakeIntegralValue(const int64_t value) const {
+  switch (type_id_) {
+    case type::TypeId::BOOLEAN:
+      return type::ValueFactory::GetBooleanValue(static_cast<int8_t>(value));
+    case type::TypeId::TINYINT:
+      return type::ValueFactory::GetTinyIntValue(static_cast<int8_t>(value));
+    case type::TypeId::SMALLINT:
+      return type::ValueFactory::GetSmallIntValue(static_cast<int16_t>(value));
+    case type::TypeId::INTEGER:
+      return type::ValueFactory::GetIntegerValue(static_cast<int32_t>(value));
+    case type::TypeId::DATE:
+      return type::ValueFactory::GetDateValue(static_cast<uint32_t>(value));
+    case type::TypeId::BIGINT:
+      return type::ValueFactory::GetBigIntValue(value);
+    case type::TypeId::TIMESTAMP:
+      return type::ValueFactory::GetTimestampValue(value);
+    default:
+      break;
+  }
+  throw Exception(EXCEPTION_TYPE_UNKNOWN_TYPE,
+                  "Unsupported type for frozen integral column");
+}
+
+uint32_t FrozenColumn::FilterComparison(const ExpressionType comparison_type,
+                                        const type::Value &value,
+                                        uint32_t *selection,
+                                        const uint32_t count) const {
+  switch (comparison_type) {
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      return count;
+  }
+
+  if (encoding_type_ == ColumnEncodingType::DICTIONARY) {
+    return FilterDictionary(comparison_type, value, selection, count);
+  }
+  return FilterIntegral(comparison_type, value, selection, count);
+}
+
+//===--------------------------------------------------------------------===//
+// The value is looked up in the sorted dictionary once. The comparison then
+// holds for a range of codes, or for all codes outside of it, which are
+// compared without unpacking any value.
+//===--------------------------------------------------------------------===//
+uint32_t FrozenColumn::FilterDictionary(const ExpressionType comparison_type,
+                                        const type::Value &value,
+                                        uint32_t *selection,
+                                        const uint32_t count) const {
+  // Stay away from comparisons that need implicit casts
+  bool numeric = type_id_ == type::TypeId::DECIMAL &&
+                 (value.GetTypeId() == type::TypeId::TINYINT ||
+                  value.GetTypeId() == type::TypeId::SMALLINT ||
+                  value.GetTypeId() == type::TypeId::INTEGER ||
+                  value.GetTypeId() == type::TypeId::BIGINT);
+  if (value.GetTypeId() != type_id_ && numeric == false) {
+    return count;
+  }
+
+  // Codes in [range_begin, range_end) satisfy the comparison, or the ones of
+  // non-null values outside of it if negated
+  uint64_t range_begin = 0;
+  uint64_t range_end = 0;
+  bool negate = false;
+  auto &entries = dictionary_->GetEntries();
+  uint64_t non_null_count = dictionary_->GetNonNullCount();
+  if (value.IsNull() == false) {
+    auto non_null_end = entries.begin() + non_null_count;
+    uint64_t lower = std::lower_bound(entries.begin(), non_null_end, value,
+                                      [](const type::Value &entry,
+                                         const type::Value &constant) {
+                                        return entry.CompareLessThan(
+                                                   constant) ==
+                                               type::CmpBool::CMP_TRUE;
+                                      }) -
+                     entries.begin();
+    uint64_t upper = std::upper_bound(entries.begin(), non_null_end, value,
+                                      [](const type::Value &constant,
+                                         const type::Value &entry) {
+                                        return constant.CompareLessThan(
+                                                   entry) ==
+                                               type::CmpBool::CMP_TRUE;
+                                      }) -
+                     entries.begin();
+    switch (comparison_type) {
+      case ExpressionType::COMPARE_EQUAL:
+        range_begin = lower;
+        range_end = upper;
+        break;
+      case ExpressionType::COMPARE_NOTEQUAL:
+        range_begin = lower;
+        range_end = upper;
+        negate = true;
+        break;
+      case ExpressionType::COMPARE_LESSTHAN:
+        range_end = lower;
+        break;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        range_end = upper;
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        range_begin = upper;
+        range_end = non_null_count;
+        break;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        range_begin = lower;
+        range_end = non_null_count;
+        break;
+      default:
+        return count;
+    }
+  }
+
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t offset = selection[i];
+    bool valid = true;
+    if (offset < tuple_count_) {
+      uint64_t code = Unpack(packed_words_, bit_width_, offset);
+      valid = ((code >= range_begin && code < range_end) != negate) &&
+              code < non_null_count;
+    }
+    selection[kept] = offset;
+    kept += valid;
+  }
+  return kept;
+}
+
+//===--------------------------------------------------------------------===//
+// The comparison holds for a range of values, or for all values outside of
+// it if negated. Runs are checked once for all of their tuples. Bit-packed
+// values are compared against the range shifted by the frame of reference,
+// so that they are never decoded.
+//===--------------------------------------------------------------------===//
+uint32_t FrozenColumn::FilterIntegral(const ExpressionType comparison_type,
+                                      const type::Value &value,
+                                      uint32_t *selection,
+                                      const uint32_t count) const {
+  // Integers of any width compare with each other, other types only with
+  // themselves
+  auto is_integer = [](type::TypeId type_id) {
+    return type_id == type::TypeId::TINYINT ||
+           type_id == type::TypeId::SMALLINT ||
+           type_id == type::TypeId::INTEGER || type_id == type::TypeId::BIGINT;
+  };
+  bool integers = is_integer(value.GetTypeId()) && is_integer(type_id_);
+  if (value.GetTypeId() != type_id_ && integers == false) {
+    return count;
+  }
+
+  // NULLs are stored as the sentinel of the type, which never satisfies the
+  // comparison. Values in [range_min, range_max] satisfy it.
+  int64_t null_value = 0;
+  ToIntegral(type::ValueFactory::GetNullValueByType(type_id_), null_value);
+  int64_t range_min = 1;
+  int64_t range_max = 0;
+  bool negate = false;
+  int64_t constant = 0;
+  if (value.IsNull() == false && ToIntegral(value, constant) == true) {
+    range_min = std::numeric_limits<int64_t>::min();
+    range_max = std::numeric_limits<int64_t>::max();
+    switch (comparison_type) {
+      case ExpressionType::COMPARE_EQUAL:
+        range_min = constant;
+        range_max = constant;
+        break;
+      case ExpressionType::COMPARE_NOTEQUAL:
+        range_min = constant;
+        range_max = constant;
+        negate = true;
+        break;
+      case ExpressionType::COMPARE_LESSTHAN:
+        if (constant == range_min) {
+          // Nothing is less than the smallest value
+          range_min = 1;
+          range_max = 0;
+        } else {
+          range_max = constant - 1;
+        }
+        break;
+      case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+        range_max = constant;
+        break;
+      case ExpressionType::COMPARE_GREATERTHAN:
+        if (constant == range_max) {
+          range_min = 1;
+          range_max = 0;
+        } else {
+          range_min = constant + 1;
+        }
+        break;
+      case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+        range_min = constant;
+        break;
+      default:
+        return count;
+    }
+  }
+
+  uint32_t kept = 0;
+  if (encoding_type_ == ColumnEncodingType::RUN_LENGTH) {
+    // The selection is ascending, so the runs of its offsets are too
+    size_t run = 0;
+    size_t checked_run = run_ends_.size();
+    bool run_valid = false;
+    for (uint32_t i = 0; i < count; i++) {
+      uint32_t offset = selection[i];
+      bool valid = true;
+      if (offset < tuple_count_) {
+        while (run_ends_[run] <= offset) {
+          run++;
+        }
+        if (run != checked_run) {
+          int64_t run_value = run_values_[run];
+          run_valid = ((run_value >= range_min && run_value <= range_max) !=
+                       negate) &&
+                      run_value != null_value;
+          checked_run = run;
+        }
+        valid = run_valid;
+      }
+      selection[kept] = offset;
+      kept += valid;
+    }
+    return kept;
+  }
+
+  // Shift the range by the frame of reference. All values are at least the
+  // base value, so the range can be cut off there.
+  PL_ASSERT(encoding_type_ == ColumnEncodingType::BIT_PACKED);
+  uint64_t packed_min = 1;
+  uint64_t packed_max = 0;
+  if (range_min <= range_max && range_max >= base_value_) {
+    packed_min = range_min <= base_value_
+                     ? 0
+                     : static_cast<uint64_t>(range_min) -
+                           static_cast<uint64_t>(base_value_);
+    packed_max =
+        static_cast<uint64_t>(range_max) - static_cast<uint64_t>(base_value_);
+  }
+  uint64_t packed_null =
+      static_cast<uint64_t>(null_value) - static_cast<uint64_t>(base_value_);
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t offset = selection[i];
+    bool valid = true;
+    if (offset < tuple_count_) {
+      uint64_t packed = Unpack(packed_words_, bit_width_, offset);
+      valid = ((packed >= packed_min && packed <= packed_max) != negate) &&
+              packed != packed_null;
+    }
+    selection[kept] = offset;
+    kept += valid;
+  }
+  return kept;
+}
+
+size_t FrozenColumn::GetEntryCount() const {
+  switch (encoding_type_) {
+    case ColumnEncodingType::DICTIONARY:
+      return dictionary_->GetEntryCount();
+    case ColumnEncodingType::RUN_LENGTH:
+      return run_values_.size();
+    default:
+      return tuple_count_;
+  }
+}
+
+size_t FrozenColumn::GetMemorySize() const {
+  size_t size = packed_words_.size() * sizeof(uint64_t) +
+                run_values_.size() * sizeof(int64_t) +
+                run_ends_.size() * sizeof(oid_t);
+  if (dictionary_ != nullptr) {
+    size += dictionary_->GetMemorySize();
+  }
+  return size;
+}
+
+uint8_t FrozenColumn::GetBitWidth(const uint64_t max_value) {
+  uint8_t bit_width = 0;
+  while (bit_width < 64 && (max_value >> bit_width) != 0) {
+    bit_width++;
+  }
+  return bit_width;
+}
+
+void FrozenColumn::Pack(std::vector<uint64_t> &words, const uint8_t bit_width,
+                        const oid_t offset, const uint64_t value) {
+  if (bit_width == 0) return;
+
+  uint64_t bit_offset = static_cast<uint64_t>(offset) * bit_width;
+  size_t word = bit_offset / 64;
+  uint8_t shift = bit_offset % 64;
+
+  words[word] |= value << shift;
+  if (shift + bit_width > 64) {
+    words[word + 1] |= value >> (64 - shift);
+  }
+}
+
+uint64_t FrozenColumn::Unpack(const std::vector<uint64_t> &words,
+                              const uint8_t bit_width, const oid_t offset) {
+  if (bit_width == 0) return 0;
+
+  uint64_t bit_offset = static_cast<uint64_t>(offset) * bit_width;
+  size_t word = bit_offset / 64;
+  uint8_t shift = bit_offset % 64;
+
+  uint64_t value = words[word] >> shift;
+  if (shift + bit_width > 64) {
+    value |= words[word + 1] << (64 - shift);
+  }
+
+  if (bit_width == 64) return value;
+  return value & ((1ull << bit_width) - 1);
+}
+
+//===--------------------------------------------------------------------===//
+// Frozen Tile Group
+//===--------------------------------------------------------------------===//
+
+FrozenTileGroup::FrozenTileGroup(
+    TileGroup *tile_group, const oid_t tuple_count, const cid_t commit_id,
+    std::vector<std::shared_ptr<const FrozenDictionary>> *shared_dictionaries)
+    : tuple_count_(tuple_count), commit_id_(commit_id) {
+  auto &tile_schemas = tile_group->GetTileSchemas();
+  oid_t column_count = tile_group->GetColumnMap().size();
+  if (shared_dictionaries != nullptr) {
+    shared_dictionaries->resize(column_count);
+  }
+
+  std::vector<type::Value> values;
+  values.reserve(tuple_count_);
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    oid_t tile_offset, tile_column_offset;
+    tile_group->LocateTileAndColumn(column_itr, tile_offset,
+                                    tile_column_offset);
+    auto type_id = tile_schemas[tile_offset].GetType(tile_column_offset);
+
+    values.clear();
+    for (oid_t tuple_itr = 0; tuple_itr < tuple_count_; tuple_itr++) {
+      values.push_back(tile_group->GetValue(tuple_itr, column_itr));
+    }
+
+    columns_.emplace_back(new FrozenColumn(
+        type_id, values, shared_dictionaries == nullptr
+                             ? nullptr
+                             : &(*shared_dictionaries)[column_itr]));
+  }
+}
+
+uint32_t FrozenTileGroup::FilterTuples(
+    const expression::AbstractExpression *predicate,
+    executor::ExecutorContext *executor_context, uint32_t *selection,
+    const uint32_t count) const {
+  if (predicate == nullptr || count == 0) {
+    return count;
+  }
+
+  switch (predicate->GetExpressionType()) {
+    case ExpressionType::CONJUNCTION_AND: {
+      uint32_t kept = FilterTuples(predicate->GetChild(0), executor_context,
+                                   selection, count);
+      return FilterTuples(predicate->GetChild(1), executor_context, selection,
+                          kept);
+    }
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      // The caller evaluates this predicate
+      return count;
+  }
+
+  ExpressionType comparison_type;
+  oid_t column_id;
+  type::Value value;
+  if (ZoneMap::GetColumnComparison(predicate, executor_context,
+                                   comparison_type, column_id,
+                                   value) == false ||
+      column_id >= columns_.size()) {
+    return count;
+  }
+  return columns_[column_id]->FilterComparison(comparison_type, value,
+                                               selection, count);
+}
+
+size_t FrozenTileGroup::GetMemorySize() const {
+  size_t size = 0;
+  for (auto &column : columns_) {
+    size += column->GetMemorySize();
+  }
+  return size;
+}
+
+const std::string FrozenTileGroup::GetInfo() const {
+  std::ostringstream os;
+
+  os << "FROZEN TILE GROUP (";
+  os << "Tuples:" << tuple_count_ << ", ";
+  os << "CommitId:" << commit_id_ << ", ";
+  os << "Bytes:" << GetMemorySize();
+  os << ")" << std::endl;
+
+  for (oid_t column_itr = 0; column_itr < columns_.size(); column_itr++) {
+    auto &column = columns_[column_itr];
+    os << "  Column " << column_itr << ": "
+       << TypeIdToString(column->GetTypeId()) << " "
+       << ColumnEncodingTypeToString(column->GetEncodingType()) << " "
+       << "Entries:" << column->GetEntryCount() << " "
+       << "Bytes:" << column->GetMemorySize() << std::endl;
+  }
+
+  return os.str();
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,222 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_builder.cpp
+//
+// Identification: src/storage/index_builder.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index_builder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+
+#include "common/container_tuple.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace storage {
+
+IndexBuilder &IndexBuilder::GetInstance() {
+  static IndexBuilder index_builder;
+  return index_builder;
+}
+
+IndexBuilder::IndexBuilder()
+    : worker_count(std::max(1U, std::thread::hardware_concurrency())) {}
+
+IndexBuilder::~IndexBuilder() { StopAll(); }
+
+void IndexBuilder::BuildIndex(DataTable *table,
+                              std::shared_ptr<index::Index> index) {
+  PL_ASSERT(index->GetIndexType() == IndexConstraintType::DEFAULT);
+
+  // The planner must not use the index before it covers the table, and the
+  // writers must not skip it from now on
+  index->GetMetadata()->SetVisibility(false);
+  index->GetMetadata()->SetBuilding(true);
+
+  std::unique_ptr<IndexBuild> build(new IndexBuild());
+  build->table = table;
+  build->index = index;
+  build->barrier_eid =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  build->stop = false;
+  build->done = false;
+
+  {
+    std::lock_guard<std::mutex> lock(builder_mutex);
+
+    // Release the builds that finished since the last call
+    auto itr = std::partition(builds.begin(), builds.end(),
+                              [](const std::unique_ptr<IndexBuild> &entry) {
+                                return entry->done == false;
+                              });
+    for (auto finished_itr = itr; finished_itr != builds.end();
+         finished_itr++) {
+      (*finished_itr)->build_thread.join();
+    }
+    builds.erase(itr, builds.end());
+
+    build->build_thread =
+        std::thread(&storage::IndexBuilder::Build, this, build.get());
+    builds.push_back(std::move(build));
+  }
+
+  LOG_TRACE("Started building index %s", index->GetName().c_str());
+}
+
+void IndexBuilder::Build(IndexBuild *build) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  // A transaction that entered the barrier epoch or an earlier one may have
+  // written a version without inserting it into the index. Once they have
+  // ended, all their versions are in the tile groups.
+  while (build->stop == false &&
+         epoch_manager.GetExpiredEpochId() < build->barrier_eid) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_duration));
+  }
+
+  if (build->stop == false) {
+    auto table = build->table;
+    auto index = build->index.get();
+    auto expired_cid = epoch_manager.GetExpiredCid();
+    auto tile_group_count = static_cast<oid_t>(table->GetTileGroupCount());
+    auto stride = static_cast<oid_t>(
+        std::min<size_t>(worker_count, std::max<size_t>(tile_group_count, 1)));
+
+    // Tile groups added later only hold versions of the writers that
+    // maintain the index themselves
+    std::vector<std::thread> worker_threads;
+    for (oid_t worker_itr = 1; worker_itr < stride; worker_itr++) {
+      worker_threads.emplace_back(&IndexBuilder::IndexTileGroups, table, index,
+                                  worker_itr, tile_group_count, stride,
+                                  expired_cid);
+    }
+    IndexTileGroups(table, index, 0, tile_group_count, stride, expired_cid);
+    for (auto &worker_thread : worker_threads) {
+      worker_thread.join();
+    }
+
+    index->GetMetadata()->SetBuilding(false);
+    index->GetMetadata()->SetVisibility(true);
+    LOG_INFO("Built index %s over %u tile groups", index->GetName().c_str(),
+             tile_group_count);
+  }
+
+  build->done = true;
+}
+
+size_t IndexBuilder::IndexTileGroups(DataTable *table, index::Index *index,
+                                     const oid_t begin_offset,
+                                     const oid_t end_offset,
+                                     const oid_t stride,
+                                     const cid_t expired_cid) {
+  size_t inserted_count = 0;
+  auto index_schema = index->GetKeySchema();
+  auto indexed_columns = index_schema->GetIndexedColumns();
+
+  for (oid_t tile_group_offset = begin_offset; tile_group_offset < end_offset;
+       tile_group_offset += stride) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    // tile groups dropped by the compactor have nothing to index
+    if (tile_group == nullptr) {
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      // The entry shares the indirection of the tuple with the other indexes
+      auto index_entry_ptr = tile_group_header->GetIndirection(tuple_id);
+      if (index_entry_ptr == nullptr ||
+          tile_group_header->GetTransactionId(tuple_id) == INVALID_TXN_ID) {
+        continue;
+      }
+
+      // The writer of an uncommitted version inserts its key, and an aborted
+      // or expired version is never read again
+      if (tile_group_header->GetBeginCommitId(tuple_id) == MAX_CID ||
+          tile_group_header->GetEndCommitId(tuple_id) <= expired_cid) {
+        continue;
+      }
+
+      expression::ContainerTuple<storage::TileGroup> container_tuple(
+          tile_group.get(), tuple_id);
+      if (index->GetMetadata()->SatisfiesPredicate(&container_tuple) ==
+          false) {
+        continue;
+      }
+      std::unique_ptr<storage::Tuple> key(
+          new storage::Tuple(index_schema, true));
+      key->SetFromTuple(&container_tuple, indexed_columns, index->GetPool());
+
+      // The writers may have inserted the entry already
+      if (index->InsertEntry(key.get(), index_entry_ptr) == true) {
+        IndirectionArray::AddIndexEntry(index_entry_ptr);
+        inserted_count++;
+      }
+    }
+  }
+
+  return inserted_count;
+}
+
+void IndexBuilder::WaitForTable(DataTable *table) {
+  PL_ASSERT(table != nullptr);
+  JoinBuilds(table, false);
+}
+
+void IndexBuilder::WaitForAll() { JoinBuilds(nullptr, false); }
+
+void IndexBuilder::DropTable(DataTable *table) {
+  PL_ASSERT(table != nullptr);
+  JoinBuilds(table, true);
+}
+
+void IndexBuilder::StopAll() { JoinBuilds(nullptr, true); }
+
+size_t IndexBuilder::GetActiveBuildCount() {
+  std::lock_guard<std::mutex> lock(builder_mutex);
+  return std::count_if(builds.begin(), builds.end(),
+                       [](const std::unique_ptr<IndexBuild> &build) {
+                         return build->done == false;
+                       });
+}
+
+void IndexBuilder::JoinBuilds(DataTable *table, bool stop) {
+  std::vector<std::unique_ptr<IndexBuild>> joined_builds;
+
+  {
+    std::lock_guard<std::mutex> lock(builder_mutex);
+    auto itr = std::partition(builds.begin(), builds.end(),
+                              [table](const std::unique_ptr<IndexBuild> &build) {
+                                return table != nullptr &&
+                                       build->table != table;
+                              });
+    std::move(itr, builds.end(), std::back_inserter(joined_builds));
+    builds.erase(itr, builds.end());
+  }
+
+  for (auto &build : joined_builds) {
+    if (stop == true) {
+      build->stop = true;
+    }
+    build->build_thread.join();
+  }
+}
+
+}  // End storage namespace
+}  // End peloton namespace
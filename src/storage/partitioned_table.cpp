@@ -0,0 +1,305 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_table.cpp
+//
+// Identification: src/storage/partitioned_table.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/partitioned_table.h"
+
+#include <algorithm>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "expression/abstract_expression.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/tuple.h"
+#include "storage/zone_map.h"
+
+namespace peloton {
+namespace storage {
+
+PartitionedTable::PartitionedTable(const std::string &name,
+                                   const PartitionType type,
+                                   const oid_t column_id)
+    : name(name), type(type), column_id(column_id) {}
+
+bool PartitionedTable::AddPartition(DataTable *table,
+                                    const type::Value &lower_bound) {
+  if (type != PartitionType::RANGE || lower_bound.IsNull() == true) {
+    return false;
+  }
+
+  PelotonWriteLock lock(partition_lock);
+  if (partitions.empty() == false &&
+      (*table->GetSchema() != *partitions.front()->GetSchema() ||
+       lower_bound.CheckComparable(lower_bounds.back()) == false ||
+       lower_bound.CompareGreaterThan(lower_bounds.back()) != type::CMP_TRUE)) {
+    return false;
+  }
+  if (column_id >= table->GetSchema()->GetColumnCount()) {
+    return false;
+  }
+
+  partitions.push_back(table);
+  lower_bounds.push_back(lower_bound.Copy());
+
+  LOG_TRACE("Partitioned table %s adding partition %u from %s", name.c_str(),
+            table->GetOid(), lower_bound.ToString().c_str());
+  return true;
+}
+
+bool PartitionedTable::AddPartition(DataTable *table) {
+  if (type != PartitionType::HASH) {
+    return false;
+  }
+
+  PelotonWriteLock lock(partition_lock);
+  if (partitions.empty() == false &&
+      *table->GetSchema() != *partitions.front()->GetSchema()) {
+    return false;
+  }
+  if (column_id >= table->GetSchema()->GetColumnCount()) {
+    return false;
+  }
+
+  partitions.push_back(table);
+
+  LOG_TRACE("Partitioned table %s adding partition %u", name.c_str(),
+            table->GetOid());
+  return true;
+}
+
+size_t PartitionedTable::GetPartitionCount() const {
+  PelotonReadLock lock(partition_lock);
+  return partitions.size();
+}
+
+DataTable *PartitionedTable::GetPartition(
+    const oid_t partition_offset) const {
+  PelotonReadLock lock(partition_lock);
+  if (partition_offset >= partitions.size()) {
+    return nullptr;
+  }
+  return partitions[partition_offset];
+}
+
+DataTable *PartitionedTable::GetPartitionForKey(
+    const type::Value &key) const {
+  PelotonReadLock lock(partition_lock);
+  auto partition_offset = GetPartitionOffset(key);
+  if (partition_offset == INVALID_OID) {
+    return nullptr;
+  }
+  return partitions[partition_offset];
+}
+
+ItemPointer PartitionedTable::InsertTuple(const Tuple *tuple,
+                                          concurrency::Transaction *txn,
+                                          ItemPointer **index_entry_ptr,
+                                          ForeignKeyCache *foreign_key_cache) {
+  auto partition = GetPartitionForKey(tuple->GetValue(column_id));
+  if (partition == nullptr) {
+    LOG_TRACE("Tuple has no partition in %s", name.c_str());
+    return INVALID_ITEMPOINTER;
+  }
+  return partition->InsertTuple(tuple, txn, index_entry_ptr,
+                                foreign_key_cache);
+}
+
+bool PartitionedTable::BulkInsert(
+    const std::vector<std::unique_ptr<Tuple>> &tuples,
+    concurrency::Transaction *txn) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  for (auto &tuple : tuples) {
+    ItemPointer *index_entry_ptr = nullptr;
+    ItemPointer location = InsertTuple(tuple.get(), txn, &index_entry_ptr);
+    if (location.IsNull() == true) {
+      return false;
+    }
+    txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  }
+  return true;
+}
+
+std::vector<DataTable *> PartitionedTable::GetPartitions(
+    const expression::AbstractExpression *predicate,
+    executor::ExecutorContext *executor_context) const {
+  PelotonReadLock lock(partition_lock);
+  std::vector<DataTable *> candidates;
+  for (oid_t partition_offset = 0; partition_offset < partitions.size();
+       partition_offset++) {
+    if (CanSatisfy(partition_offset, predicate, executor_context) == true) {
+      candidates.push_back(partitions[partition_offset]);
+    }
+  }
+
+  LOG_TRACE("Scanning %zu of %zu partitions of %s", candidates.size(),
+            partitions.size(), name.c_str());
+  return candidates;
+}
+
+std::vector<oid_t> PartitionedTable::DropPartitionsBefore(
+    const type::Value &bound) {
+  std::vector<oid_t> dropped_oids;
+  if (type != PartitionType::RANGE || bound.IsNull() == true) {
+    return dropped_oids;
+  }
+
+  std::vector<DataTable *> dropped_partitions;
+  {
+    PelotonWriteLock lock(partition_lock);
+
+    // the keys of a partition are below the bound of the next one, and the
+    // last one holds keys without bound
+    size_t drop_count = 0;
+    while (drop_count + 1 < partitions.size() &&
+           lower_bounds[drop_count + 1].CheckComparable(bound) == true &&
+           lower_bounds[drop_count + 1].CompareLessThanEquals(bound) ==
+               type::CMP_TRUE) {
+      drop_count++;
+    }
+
+    dropped_partitions.assign(partitions.begin(),
+                              partitions.begin() + drop_count);
+    partitions.erase(partitions.begin(), partitions.begin() + drop_count);
+    lower_bounds.erase(lower_bounds.begin(), lower_bounds.begin() + drop_count);
+  }
+
+  // the tile groups go with their tables, once no scan can reach them
+  auto storage_manager = StorageManager::GetInstance();
+  for (auto partition : dropped_partitions) {
+    LOG_TRACE("Partitioned table %s dropping partition %u", name.c_str(),
+              partition->GetOid());
+    dropped_oids.push_back(partition->GetOid());
+    catalog::Manager::GetInstance().RetireTable(
+        storage_manager->GetDatabaseWithOid(partition->GetDatabaseOid())
+            ->DetachTableWithOid(partition->GetOid()));
+  }
+  return dropped_oids;
+}
+
+oid_t PartitionedTable::GetPartitionOffset(const type::Value &key) const {
+  if (partitions.empty() == true || key.IsNull() == true) {
+    return INVALID_OID;
+  }
+
+  if (type == PartitionType::HASH) {
+    return key.Hash() % partitions.size();
+  }
+
+  // the last partition whose bound is not above the key
+  if (key.CheckComparable(lower_bounds.front()) == false) {
+    return INVALID_OID;
+  }
+  auto bound_itr = std::upper_bound(
+      lower_bounds.begin(), lower_bounds.end(), key,
+      [](const type::Value &key, const type::Value &lower_bound) {
+        return key.CompareLessThan(lower_bound) == type::CMP_TRUE;
+      });
+  if (bound_itr == lower_bounds.begin()) {
+    return INVALID_OID;
+  }
+  return (bound_itr - lower_bounds.begin()) - 1;
+}
+
+bool PartitionedTable::CanSatisfy(
+    const oid_t partition_offset,
+    const expression::AbstractExpression *predicate,
+    executor::ExecutorContext *executor_context) const {
+  if (predicate == nullptr) {
+    return true;
+  }
+
+  auto expression_type = predicate->GetExpressionType();
+  switch (expression_type) {
+    case ExpressionType::CONJUNCTION_AND:
+      return CanSatisfy(partition_offset, predicate->GetChild(0),
+                        executor_context) &&
+             CanSatisfy(partition_offset, predicate->GetChild(1),
+                        executor_context);
+    case ExpressionType::CONJUNCTION_OR:
+      return CanSatisfy(partition_offset, predicate->GetChild(0),
+                        executor_context) ||
+             CanSatisfy(partition_offset, predicate->GetChild(1),
+                        executor_context);
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      // We can't reason about this predicate
+      return true;
+  }
+
+  oid_t predicate_column_id;
+  type::Value value;
+  if (ZoneMap::GetColumnComparison(predicate, executor_context,
+                                   expression_type, predicate_column_id,
+                                   value) == false ||
+      predicate_column_id != column_id) {
+    return true;
+  }
+
+  return CanSatisfyComparison(partition_offset, expression_type, value);
+}
+
+bool PartitionedTable::CanSatisfyComparison(
+    const oid_t partition_offset, const ExpressionType comparison_type,
+    const type::Value &value) const {
+  if (value.IsNull() == true) {
+    return true;
+  }
+
+  if (type == PartitionType::HASH) {
+    // keys of another type may hash differently
+    if (comparison_type != ExpressionType::COMPARE_EQUAL ||
+        value.GetTypeId() !=
+            partitions[partition_offset]->GetSchema()->GetType(column_id)) {
+      return true;
+    }
+    return GetPartitionOffset(value) == partition_offset;
+  }
+
+  auto &lower_bound = lower_bounds[partition_offset];
+  if (value.CheckComparable(lower_bound) == false) {
+    return true;
+  }
+  bool has_upper_bound = partition_offset + 1 < lower_bounds.size();
+
+  // is the value below the upper bound of the partition
+  bool below_upper_bound =
+      has_upper_bound == false ||
+      value.CompareLessThan(lower_bounds[partition_offset + 1]) ==
+          type::CMP_TRUE;
+
+  switch (comparison_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return value.CompareGreaterThanEquals(lower_bound) == type::CMP_TRUE &&
+             below_upper_bound;
+    case ExpressionType::COMPARE_LESSTHAN:
+      return value.CompareGreaterThan(lower_bound) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return value.CompareGreaterThanEquals(lower_bound) == type::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return below_upper_bound;
+    default:
+      return true;
+  }
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,359 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_snapshot.cpp
+//
+// Identification: src/storage/table_snapshot.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table_snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_factory.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "storage/zone_map.h"
+#include "type/serializeio.h"
+
+namespace peloton {
+namespace storage {
+
+const char TableSnapshot::snapshot_magic_[8] = {'P', 'L', 'S', 'N',
+                                                'A', 'P', 'S', 'H'};
+
+const size_t TableSnapshot::snapshot_page_size_;
+
+const cid_t TableSnapshot::snapshot_commit_id_;
+
+namespace {
+
+// a tile group of the directory
+struct TileGroupEntry {
+  oid_t tuple_count;
+  size_t data_offset;
+  std::vector<size_t> null_counts;
+  std::vector<type::Value> min_values;
+  std::vector<type::Value> max_values;
+};
+
+}  // namespace
+
+bool TableSnapshot::WriteTable(concurrency::Transaction *txn,
+                               DataTable *table, const std::string &path) {
+  auto schema = table->GetSchema();
+  if (schema->IsInlined() == false) {
+    LOG_ERROR("Cannot snapshot table %s, its columns are not all inlined",
+              table->GetName().c_str());
+    return false;
+  }
+
+  // a table mapped from the old file keeps reading it
+  std::string temp_path = path + ".tmp";
+  FILE *snapshot_file = fopen(temp_path.c_str(), "wb");
+  if (snapshot_file == nullptr) {
+    LOG_ERROR("Cannot open snapshot file %s", temp_path.c_str());
+    return false;
+  }
+
+  bool success = true;
+  auto write_data = [&](const char *data, const size_t size) {
+    if (size > 0 && fwrite(data, size, 1, snapshot_file) != 1) {
+      success = false;
+    }
+  };
+
+  // the header is written once the directory is
+  std::string padding(snapshot_page_size_, '\0');
+  write_data(padding.data(), padding.size());
+  size_t offset = snapshot_page_size_;
+
+  oid_t column_count = schema->GetColumnCount();
+  size_t tuple_length = schema->GetLength();
+
+  CopySerializeOutput directory;
+  directory.WriteInt(column_count);
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    directory.WriteEnumInSingleByte(
+        static_cast<int>(schema->GetType(column_id)));
+    directory.WriteInt(schema->GetLength(column_id));
+  }
+  directory.WriteLong(tuple_length);
+  size_t tile_group_count_position = directory.Position();
+  directory.WriteLong(0);
+
+  std::string tile_data;
+  std::unique_ptr<ZoneMap> zone_map(new ZoneMap(column_count));
+  oid_t tuple_count = 0;
+  size_t snapshot_tile_group_count = 0;
+
+  // the tile data is padded to a whole number of pages
+  auto write_tile_group = [&] {
+    if (tuple_count == 0) {
+      return;
+    }
+    directory.WriteLong(tuple_count);
+    directory.WriteLong(offset);
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      directory.WriteLong(zone_map->GetNullCount(column_id));
+      auto min_value = zone_map->GetMinValue(column_id);
+      bool has_range = (min_value.GetTypeId() != type::TypeId::INVALID);
+      directory.WriteBool(has_range);
+      if (has_range == true) {
+        min_value.SerializeTo(directory);
+        zone_map->GetMaxValue(column_id).SerializeTo(directory);
+      }
+    }
+
+    tile_data.resize((tile_data.size() + snapshot_page_size_ - 1) /
+                         snapshot_page_size_ * snapshot_page_size_,
+                     '\0');
+    write_data(tile_data.data(), tile_data.size());
+    offset += tile_data.size();
+
+    tile_data.clear();
+    zone_map.reset(new ZoneMap(column_count));
+    tuple_count = 0;
+    snapshot_tile_group_count++;
+  };
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  size_t tuples_per_tile_group = table->GetTuplesPerTileGroup();
+  storage::Tuple tuple(schema, true);
+
+  // tile groups added after the snapshot only hold invisible versions
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t tile_group_offset = 0;
+       tile_group_offset < tile_group_count && success == true;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+    auto tile_group_header = tile_group->GetHeader();
+
+    oid_t active_tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+      if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+          VisibilityType::OK) {
+        continue;
+      }
+
+      // the tuple is laid out as in a tile of the whole schema
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        auto value = tile_group->GetValue(tuple_id, column_id);
+        tuple.SetValue(column_id, value);
+        zone_map->Widen(column_id, value);
+      }
+      tile_data.append(tuple.GetData(), tuple_length);
+
+      if (++tuple_count == tuples_per_tile_group) {
+        write_tile_group();
+      }
+    }
+  }
+  write_tile_group();
+
+  directory.WritePrimitiveAt<int64_t>(tile_group_count_position,
+                                      snapshot_tile_group_count);
+  write_data(directory.Data(), directory.Size());
+
+  CopySerializeOutput header;
+  header.WriteBytes(snapshot_magic_, sizeof(snapshot_magic_));
+  header.WriteLong(offset);
+  header.WriteLong(directory.Size());
+  if (success == true && fseek(snapshot_file, 0, SEEK_SET) != 0) {
+    success = false;
+  }
+  write_data(header.Data(), header.Size());
+
+  if (success == false || fflush(snapshot_file) != 0 ||
+      fsync(fileno(snapshot_file)) != 0) {
+    success = false;
+  }
+  fclose(snapshot_file);
+
+  if (success == true && rename(temp_path.c_str(), path.c_str()) != 0) {
+    success = false;
+  }
+  if (success == false) {
+    LOG_ERROR("Cannot write snapshot file %s", path.c_str());
+    std::remove(temp_path.c_str());
+  }
+  return success;
+}
+
+bool TableSnapshot::LoadTable(DataTable *table, const std::string &path,
+                              std::unique_ptr<std::thread> &index_thread) {
+  auto schema = table->GetSchema();
+
+  int fd = open(path.c_str(), O_RDONLY);
+  struct stat file_stat;
+  if (fd < 0 || fstat(fd, &file_stat) != 0) {
+    LOG_ERROR("Cannot open snapshot file %s: %s", path.c_str(),
+              strerror(errno));
+    if (fd >= 0) {
+      close(fd);
+    }
+    return false;
+  }
+  size_t file_size = file_stat.st_size;
+  if (file_size < snapshot_page_size_) {
+    LOG_ERROR("Snapshot file %s is truncated", path.c_str());
+    close(fd);
+    return false;
+  }
+
+  // the writes to the tuples stay in memory, the file is never changed
+  void *address = mmap(nullptr, file_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    LOG_ERROR("Cannot map snapshot file %s: %s", path.c_str(),
+              strerror(errno));
+    return false;
+  }
+
+  // the tiles share the mapping, it is unmapped with the last of them
+  std::shared_ptr<char> mapping(static_cast<char *>(address),
+                                [file_size](char *address) {
+                                  munmap(address, file_size);
+                                });
+
+  ReferenceSerializeInput header(mapping.get(), snapshot_page_size_);
+  char magic[sizeof(snapshot_magic_)];
+  header.ReadBytes(magic, sizeof(magic));
+  size_t directory_offset = header.ReadLong();
+  size_t directory_size = header.ReadLong();
+  if (memcmp(magic, snapshot_magic_, sizeof(magic)) != 0 ||
+      directory_offset < snapshot_page_size_ ||
+      directory_offset + directory_size > file_size) {
+    LOG_ERROR("Snapshot file %s is invalid", path.c_str());
+    return false;
+  }
+
+  // the tuples are only mapped into a table of the same layout
+  ReferenceSerializeInput directory(mapping.get() + directory_offset,
+                                    directory_size);
+  oid_t column_count = directory.ReadInt();
+  bool is_matching = (schema->IsInlined() == true &&
+                      column_count == schema->GetColumnCount());
+  for (oid_t column_id = 0; column_id < column_count && is_matching == true;
+       column_id++) {
+    auto column_type =
+        static_cast<type::TypeId>(directory.ReadEnumInSingleByte());
+    size_t column_length = directory.ReadInt();
+    is_matching = (column_type == schema->GetType(column_id) &&
+                   column_length == schema->GetLength(column_id));
+  }
+  size_t tuple_length = 0;
+  if (is_matching == true) {
+    tuple_length = directory.ReadLong();
+    is_matching = (tuple_length == schema->GetLength());
+  }
+  if (is_matching == false) {
+    LOG_ERROR("Snapshot file %s does not match table %s", path.c_str(),
+              table->GetName().c_str());
+    return false;
+  }
+
+  size_t tile_group_count = directory.ReadLong();
+  std::vector<TileGroupEntry> entries(tile_group_count);
+  for (auto &entry : entries) {
+    entry.tuple_count = directory.ReadLong();
+    entry.data_offset = directory.ReadLong();
+    if (entry.tuple_count == 0 || entry.data_offset < snapshot_page_size_ ||
+        entry.data_offset + entry.tuple_count * tuple_length >
+            directory_offset) {
+      LOG_ERROR("Snapshot file %s is invalid", path.c_str());
+      return false;
+    }
+
+    entry.null_counts.resize(column_count);
+    entry.min_values.resize(column_count);
+    entry.max_values.resize(column_count);
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      entry.null_counts[column_id] = directory.ReadLong();
+      if (directory.ReadBool() == true) {
+        auto column_type = schema->GetType(column_id);
+        entry.min_values[column_id] =
+            type::Value::DeserializeFrom(directory, column_type, nullptr);
+        entry.max_values[column_id] =
+            type::Value::DeserializeFrom(directory, column_type, nullptr);
+      }
+    }
+  }
+
+  std::vector<catalog::Schema> schemas;
+  schemas.push_back(*schema);
+  column_map_type column_map;
+  for (oid_t column_id = 0; column_id < column_count; column_id++) {
+    column_map[column_id] = std::make_pair(0, column_id);
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  std::vector<oid_t> tile_group_ids;
+  for (auto &entry : entries) {
+    oid_t tile_group_id = manager.GetNextTileGroupId();
+    std::vector<std::shared_ptr<char>> tile_data{
+        std::shared_ptr<char>(mapping, mapping.get() + entry.data_offset)};
+    std::shared_ptr<TileGroup> tile_group(TileGroupFactory::GetTileGroup(
+        table->GetDatabaseOid(), table->GetOid(), tile_group_id, table,
+        schemas, column_map, entry.tuple_count, INVALID_NUMA_NODE,
+        tile_data));
+
+    auto tile_group_header = tile_group->GetHeader();
+    for (oid_t tuple_slot = 0; tuple_slot < entry.tuple_count; tuple_slot++) {
+      tile_group_header->SetTransactionId(tuple_slot, INITIAL_TXN_ID);
+      tile_group_header->SetBeginCommitId(tuple_slot, snapshot_commit_id_);
+      tile_group_header->SetEndCommitId(tuple_slot, MAX_CID);
+    }
+    tile_group_header->GetEmptyTupleSlot(entry.tuple_count - 1);
+
+    auto zone_map = tile_group->GetZoneMap();
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      if (entry.min_values[column_id].GetTypeId() != type::TypeId::INVALID) {
+        zone_map->Widen(column_id, entry.min_values[column_id]);
+        zone_map->Widen(column_id, entry.max_values[column_id]);
+      }
+      zone_map->AddNullCount(column_id, entry.null_counts[column_id]);
+    }
+
+    table->AddCommittedTileGroup(tile_group);
+    tile_group_ids.push_back(tile_group_id);
+  }
+
+  // the writers wait for the tuples to get their index entries
+  if (table->GetIndexCount() > 0 && tile_group_ids.empty() == false) {
+    table->BeginIndexFill();
+    index_thread.reset(new std::thread([table, tile_group_ids] {
+      table->InsertTileGroupsInIndexes(tile_group_ids);
+      table->EndIndexFill();
+    }));
+  }
+
+  LOG_TRACE("Mapped %lu tile groups of table %s", tile_group_ids.size(),
+            table->GetName().c_str());
+  return true;
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -10,15 +10,20 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <cstdio>
 #include <sstream>
 
 #include "catalog/schema.h"
 #include "common/exception.h"
 #include "common/macros.h"
+#include "common/memory_tracker.h"
 #include "type/serializer.h"
 #include "type/types.h"
-#include "type/ephemeral_pool.h"
+#include "type/arena_pool.h"
+#include "type/varlen_type.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "storage/backend_manager.h"
 #include "storage/tile.h"
@@ -29,16 +34,50 @@
 namespace peloton {
 namespace storage {
 
+// Allocate the tuple slots of a tile
+static char *AllocateTileData(const BackendType backend_type,
+                              const int numa_node, const size_t tile_size) {
+  if (backend_type == BackendType::HUGE_PAGE) {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    return reinterpret_cast<char *>(
+        backend_manager.AllocateHugePages(tile_size, numa_node));
+  } else if (numa_node == INVALID_NUMA_NODE) {
+    return new char[tile_size];
+  } else {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    return reinterpret_cast<char *>(
+        backend_manager.AllocateOnNode(tile_size, numa_node));
+  }
+}
+
+// Free tuple slots allocated by AllocateTileData
+static void ReleaseTileData(const BackendType backend_type, const int numa_node,
+                            char *data, const size_t tile_size) {
+  if (backend_type == BackendType::HUGE_PAGE) {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    backend_manager.ReleaseHugePages(data, tile_size, numa_node);
+  } else if (numa_node == INVALID_NUMA_NODE) {
+    delete[] data;
+  } else {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    backend_manager.ReleaseOnNode(data, tile_size);
+  }
+}
+
 Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
            const catalog::Schema &tuple_schema, TileGroup *tile_group,
-           int tuple_count)
+           int tuple_count, int numa_node,
+           const std::shared_ptr<char> &mapped_data)
     : database_id(INVALID_OID),
       table_id(INVALID_OID),
       tile_group_id(INVALID_OID),
       tile_id(INVALID_OID),
       backend_type(backend_type),
+      numa_node(numa_node),
       schema(tuple_schema),
       data(NULL),
+      mapped_data(mapped_data),
+      is_released(false),
       tile_group(tile_group),
       pool(NULL),
       num_tuple_slots(tuple_count),
@@ -57,15 +96,25 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   // data = reinterpret_cast<char *>(
   // storage_manager.Allocate(backend_type, tile_size));
 
-  data = new char[tile_size];
+  // mapped tuple slots are paged in on first access
+  if (mapped_data != nullptr) {
+    data = mapped_data.get();
+  } else {
+    data = AllocateTileData(backend_type, numa_node, tile_size);
+  }
   PL_ASSERT(data != NULL);
 
-  // zero out the data
-  PL_MEMSET(data, 0, tile_size);
+  // zero out the data. mapped tuple slots are backed by their file.
+  if (mapped_data == nullptr) {
+    PL_MEMSET(data, 0, tile_size);
+    MemoryTracker::Allocate(MemoryComponentType::TILE_DATA, tile_size);
+  }
 
-  // allocate pool for blob storage if schema not inlined
+  // allocate pool for blob storage if schema not inlined.
+  // varlen data is released with the tile, so a bump-pointer arena keeps
+  // concurrent inserts from serializing on the pool.
   // if (schema.IsInlined() == false) {
-  pool = new type::EphemeralPool();
+  pool = new type::ArenaPool(MemoryComponentType::VARLEN_POOL);
   //}
 }
 
@@ -74,7 +123,12 @@ Tile::~Tile() {
   // auto &storage_manager = storage::StorageManager::GetInstance();
   // storage_manager.Release(backend_type, data);
 
-  delete[] data;
+  if (mapped_data != nullptr) {
+    mapped_data.reset();
+  } else if (is_released == false) {
+    ReleaseTileData(backend_type, numa_node, data, tile_size);
+    MemoryTracker::Release(MemoryComponentType::TILE_DATA, tile_size);
+  }
   data = NULL;
 
   // reclaim the tile memory (UNINLINED data)
@@ -88,6 +142,72 @@ Tile::~Tile() {
   column_header = NULL;
 }
 
+//===--------------------------------------------------------------------===//
+// Mapped tuple slots
+//===--------------------------------------------------------------------===//
+
+std::function<void()> Tile::MapData(const std::shared_ptr<char> &mapped_copy) {
+  PL_ASSERT(mapped_data == nullptr);
+  char *old_data = data;
+
+  // the varlen pointers in the copy still point into the pool
+  mapped_data = mapped_copy;
+  COMPILER_MEMORY_FENCE;
+  data = mapped_data.get();
+
+  // readers that found the old slots keep reading them until they are freed
+  BackendType old_backend_type = backend_type;
+  int old_numa_node = numa_node;
+  size_t old_tile_size = tile_size;
+  return [old_backend_type, old_numa_node, old_data, old_tile_size]() {
+    ReleaseTileData(old_backend_type, old_numa_node, old_data, old_tile_size);
+  };
+}
+
+//===--------------------------------------------------------------------===//
+// Released tuple slots
+//===--------------------------------------------------------------------===//
+
+std::function<void()> Tile::ReleaseData() {
+  PL_ASSERT(mapped_data == nullptr);
+  PL_ASSERT(is_released == false);
+  is_released = true;
+
+  // readers that found the slots keep reading them until they are freed
+  char *old_data = data;
+  BackendType old_backend_type = backend_type;
+  int old_numa_node = numa_node;
+  size_t old_tile_size = tile_size;
+  return [old_backend_type, old_numa_node, old_data, old_tile_size]() {
+    ReleaseTileData(old_backend_type, old_numa_node, old_data, old_tile_size);
+    MemoryTracker::Release(MemoryComponentType::TILE_DATA, old_tile_size);
+  };
+}
+
+void Tile::RestoreData() {
+  PL_ASSERT(is_released == true);
+  char *new_data = AllocateTileData(backend_type, numa_node, tile_size);
+  PL_ASSERT(new_data != NULL);
+  PL_MEMSET(new_data, 0, tile_size);
+  MemoryTracker::Allocate(MemoryComponentType::TILE_DATA, tile_size);
+
+  COMPILER_MEMORY_FENCE;
+  data = new_data;
+  is_released = false;
+}
+
+void Tile::PrefetchData() const {
+  if (mapped_data == nullptr) {
+    return;
+  }
+
+  // madvise wants a page aligned start
+  static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  uintptr_t start = reinterpret_cast<uintptr_t>(data) & ~(page_size - 1);
+  size_t length = reinterpret_cast<uintptr_t>(data) + tile_size - start;
+  madvise(reinterpret_cast<void *>(start), length, MADV_WILLNEED);
+}
+
 //===--------------------------------------------------------------------===//
 // Tuples
 //===--------------------------------------------------------------------===//
@@ -160,10 +280,12 @@ void Tile::SetValue(const type::Value &value, const oid_t tuple_offset,
   // Cast the value if the type is different from column type
   const type::TypeId col_type = schema.GetType(column_id);
   if (value.GetTypeId() == col_type) {
-    value.SerializeTo(field_location, is_inlined, pool);
+    type::VarlenType::SerializeToTile(value, field_location, is_inlined,
+                                      pool);
   } else {
     type::Value casted_value = value.CastAs(col_type);
-    casted_value.SerializeTo(field_location, is_inlined, pool);
+    type::VarlenType::SerializeToTile(casted_value, field_location,
+                                      is_inlined, pool);
   }
 }
 
@@ -183,7 +305,8 @@ void Tile::SetValueFast(const type::Value &value, const oid_t tuple_offset,
 
   // const bool is_in_bytes = false;
   PL_ASSERT(pool != nullptr);
-  value.SerializeTo(field_location, is_inlined, pool);
+  type::VarlenType::SerializeToTile(value, field_location, is_inlined,
+                                      pool);
 }
 
 Tile *Tile::CopyTile(BackendType backend_type) {
@@ -20,9 +20,12 @@
 #include "common/platform.h"
 #include "type/types.h"
 #include "storage/abstract_table.h"
+#include "storage/frozen_tile_group.h"
 #include "storage/tile.h"
 #include "storage/tile_group_header.h"
 #include "storage/tuple.h"
+#include "storage/tuple_serializer.h"
+#include "storage/zone_map.h"
 
 namespace peloton {
 namespace storage {
@@ -30,17 +33,26 @@ namespace storage {
 TileGroup::TileGroup(BackendType backend_type,
                      TileGroupHeader *tile_group_header, AbstractTable *table,
                      const std::vector<catalog::Schema> &schemas,
-                     const column_map_type &column_map, int tuple_count)
+                     const column_map_type &column_map, int tuple_count,
+                     int numa_node,
+                     const std::vector<std::shared_ptr<char>> &mapped_tile_data)
     : database_id(INVALID_OID),
       table_id(INVALID_OID),
       tile_group_id(INVALID_OID),
       backend_type(backend_type),
+      numa_node(numa_node),
       tile_schemas(schemas),
       tile_group_header(tile_group_header),
       table(table),
       num_tuple_slots(tuple_count),
+      is_released(false),
       column_map(column_map) {
   tile_count = tile_schemas.size();
+  PL_ASSERT(mapped_tile_data.empty() == true ||
+            mapped_tile_data.size() == tile_count);
+
+  zone_map.reset(new ZoneMap(column_map.size()));
+  serializer.reset(new TupleSerializer(tile_schemas, column_map));
 
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
     auto &manager = catalog::Manager::GetInstance();
@@ -48,7 +60,10 @@ TileGroup::TileGroup(BackendType backend_type,
 
     std::shared_ptr<Tile> tile(storage::TileFactory::GetTile(
         backend_type, database_id, table_id, tile_group_id, tile_id,
-        tile_group_header, tile_schemas[tile_itr], this, tuple_count));
+        tile_group_header, tile_schemas[tile_itr], this, tuple_count,
+        numa_node, mapped_tile_data.empty() == true
+                       ? nullptr
+                       : mapped_tile_data[tile_itr]));
 
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
@@ -121,7 +136,8 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
     for (oid_t tile_column_itr = 0; tile_column_itr < tile_column_count;
          tile_column_itr++) {
       type::Value val = (tuple->GetValue(column_itr));
-      tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
+      tile_tuple.SetTileValue(tile_column_itr, val, tile->GetPool());
+      zone_map->Widen(column_itr, val);
       column_itr++;
     }
   }
@@ -175,7 +191,7 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
   // No more slots
   if (status == false) return INVALID_OID;
 
-  tile_group_header->GetHeaderLock().Lock();
+  tile_group_header->GetHeaderLock().Lock(WaitEventType::TILE_HEADER_LATCH);
 
   cid_t current_begin_cid = tile_group_header->GetBeginCommitId(tuple_slot_id);
   if (current_begin_cid != MAX_CID && current_begin_cid > commit_id) {
@@ -204,7 +220,8 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
     for (oid_t tile_column_itr = 0; tile_column_itr < tile_column_count;
          tile_column_itr++) {
       type::Value val = (tuple->GetValue(column_itr));
-      tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
+      tile_tuple.SetTileValue(tile_column_itr, val, tile->GetPool());
+      zone_map->Widen(column_itr, val);
       column_itr++;
     }
   }
@@ -223,7 +240,7 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
 oid_t TileGroup::DeleteTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id) {
   auto status = tile_group_header->GetEmptyTupleSlot(tuple_slot_id);
 
-  tile_group_header->GetHeaderLock().Lock();
+  tile_group_header->GetHeaderLock().Lock(WaitEventType::TILE_HEADER_LATCH);
 
   cid_t current_begin_cid = tile_group_header->GetBeginCommitId(tuple_slot_id);
   if (current_begin_cid != MAX_CID && current_begin_cid > commit_id) {
@@ -248,7 +265,7 @@ oid_t TileGroup::UpdateTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
                                          ItemPointer new_location) {
   auto status = tile_group_header->GetEmptyTupleSlot(tuple_slot_id);
 
-  tile_group_header->GetHeaderLock().Lock();
+  tile_group_header->GetHeaderLock().Lock(WaitEventType::TILE_HEADER_LATCH);
 
   cid_t current_begin_cid = tile_group_header->GetBeginCommitId(tuple_slot_id);
   if (current_begin_cid != MAX_CID && current_begin_cid > commit_id) {
@@ -304,7 +321,8 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
     for (oid_t tile_column_itr = 0; tile_column_itr < tile_column_count;
          tile_column_itr++) {
       type::Value val = (tuple->GetValue(column_itr));
-      tile_tuple.SetValue(tile_column_itr, val, tile->GetPool());
+      tile_tuple.SetTileValue(tile_column_itr, val, tile->GetPool());
+      zone_map->Widen(column_itr, val);
       column_itr++;
     }
   }
@@ -332,6 +350,16 @@ oid_t TileGroup::GetTileColumnId(oid_t column_id) {
 
 type::Value TileGroup::GetValue(oid_t tuple_id, oid_t column_id) {
   PL_ASSERT(tuple_id < GetNextTupleSlot());
+
+  // released tuple slots are read from the frozen copy. nobody wrote the
+  // slots since, writers restore them first.
+  if (is_released == true) {
+    auto frozen_copy = std::atomic_load(&frozen_tile_group);
+    if (frozen_copy != nullptr) {
+      return frozen_copy->GetValue(tuple_id, column_id);
+    }
+  }
+
   oid_t tile_column_id, tile_offset;
   LocateTileAndColumn(column_id, tile_offset, tile_column_id);
   return GetTile(tile_offset)->GetValue(tuple_id, tile_column_id);
@@ -343,12 +371,139 @@ void TileGroup::SetValue(type::Value &value, oid_t tuple_id,
   oid_t tile_column_id, tile_offset;
   LocateTileAndColumn(column_id, tile_offset, tile_column_id);
   GetTile(tile_offset)->SetValue(value, tuple_id, tile_column_id);
+  zone_map->Widen(column_id, value);
+}
+
+
+void TileGroup::Freeze(
+    const std::shared_ptr<FrozenTileGroup> &frozen_tile_group) {
+  std::atomic_store(&this->frozen_tile_group, frozen_tile_group);
+
+  // publish the compressed copy before readers can observe the frozen header
+  COMPILER_MEMORY_FENCE;
+
+  tile_group_header->SetFrozenCommitId(frozen_tile_group->GetCommitId());
+}
+
+std::shared_ptr<FrozenTileGroup> TileGroup::GetFrozenTileGroup() const {
+  if (tile_group_header->IsFrozen() == false) {
+    return nullptr;
+  }
+  return std::atomic_load(&frozen_tile_group);
 }
 
+void TileGroup::ReleaseFrozenTileGroup() {
+  PL_ASSERT(tile_group_header->IsFrozen() == false);
+
+  // the compressed copy may hold the only copy of the tuples
+  RestoreTiles();
+  std::atomic_store(&frozen_tile_group, std::shared_ptr<FrozenTileGroup>());
+}
+
+std::vector<std::function<void()>> TileGroup::ReleaseTiles() {
+  std::vector<std::function<void()>> releases;
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+  if (tile_group_header->IsFrozen() == false || is_released == true ||
+      IsEvicted() == true) {
+    return releases;
+  }
+
+  // readers check the flag before they touch the tiles
+  is_released = true;
+  for (auto &tile : tiles) {
+    releases.push_back(tile->ReleaseData());
+  }
+  return releases;
+}
+
+void TileGroup::RestoreTiles() const {
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+  if (is_released == false) {
+    return;
+  }
+
+  // the tile group is released only while it has a frozen copy, which is
+  // dropped only after restoring it
+  auto frozen_copy = std::atomic_load(&frozen_tile_group);
+  PL_ASSERT(frozen_copy != nullptr);
+
+  for (auto &tile : tiles) {
+    tile->RestoreData();
+  }
+  for (oid_t column_id = 0; column_id < frozen_copy->GetColumnCount();
+       column_id++) {
+    oid_t tile_offset, tile_column_id;
+    LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+    auto tile = tiles[tile_offset].get();
+    for (oid_t tuple_id = 0; tuple_id < frozen_copy->GetTupleCount();
+         tuple_id++) {
+      tile->SetValue(frozen_copy->GetValue(tuple_id, column_id), tuple_id,
+                     tile_column_id);
+    }
+  }
+
+  // the slots are filled before readers stop decoding the frozen copy
+  is_released = false;
+}
+
+std::shared_ptr<Tile> TileGroup::DecodeFrozenTile(
+    const std::vector<oid_t> &column_ids,
+    const std::vector<oid_t> &tuple_ids) {
+  auto frozen_copy = std::atomic_load(&frozen_tile_group);
+  if (frozen_copy == nullptr) {
+    return nullptr;
+  }
+
+  std::unique_ptr<catalog::Schema> schema(
+      catalog::Schema::CopySchema(table->GetSchema(), column_ids));
+  std::shared_ptr<Tile> tile(TileFactory::GetTile(
+      BackendType::MM, database_id, table_id, tile_group_id, INVALID_OID,
+      tile_group_header, *schema, this, num_tuple_slots));
+  for (oid_t column_itr = 0; column_itr < column_ids.size(); column_itr++) {
+    for (auto tuple_id : tuple_ids) {
+      tile->SetValue(frozen_copy->GetValue(tuple_id, column_ids[column_itr]),
+                     tuple_id, column_itr);
+    }
+  }
+  return tile;
+}
+
+size_t TileGroup::GetResidentSize() const {
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+  if (is_released == true) {
+    return 0;
+  }
+
+  size_t resident_size = 0;
+  for (auto &tile : tiles) {
+    if (tile->IsMapped() == false) {
+      resident_size += tile->GetInlinedSize();
+    }
+  }
+  return resident_size;
+}
+
+bool TileGroup::IsEvicted() const {
+  for (auto &tile : tiles) {
+    if (tile->IsMapped() == false) {
+      return false;
+    }
+  }
+  return tile_count > 0;
+}
+
+void TileGroup::Prefetch() const {
+  for (auto &tile : tiles) {
+    tile->PrefetchData();
+  }
+}
 
 std::shared_ptr<Tile> TileGroup::GetTileReference(
     const oid_t tile_offset) const {
   PL_ASSERT(tile_offset < tile_count);
+  if (is_released == true) {
+    RestoreTiles();
+  }
   return tiles[tile_offset];
 }
 
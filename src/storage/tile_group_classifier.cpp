@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_classifier.cpp
+//
+// Identification: src/storage/tile_group_classifier.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_classifier.h"
+
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace storage {
+
+std::string TileGroupTemperatureToString(TileGroupTemperature temperature) {
+  switch (temperature) {
+    case TileGroupTemperature::HOT:
+      return "HOT";
+    case TileGroupTemperature::WARM:
+      return "WARM";
+    case TileGroupTemperature::COLD:
+      return "COLD";
+  }
+  return "INVALID";
+}
+
+const uint32_t TileGroupClassifier::ACCESS_SAMPLE_INTERVAL;
+
+TileGroupClassifier::TileGroupClassifier() {}
+
+TileGroupClassifier &TileGroupClassifier::GetInstance() {
+  static TileGroupClassifier tile_group_classifier;
+  return tile_group_classifier;
+}
+
+bool TileGroupClassifier::IsSampled() {
+  static thread_local uint32_t access_itr = 0;
+  return ++access_itr % ACCESS_SAMPLE_INTERVAL == 0;
+}
+
+void TileGroupClassifier::RecordAccess(const oid_t tile_group_id) {
+  // The tile group is only looked up for the sampled accesses
+  if (IsSampled() == false) {
+    return;
+  }
+
+  auto tile_group =
+      catalog::Manager::GetInstance().GetTileGroup(tile_group_id);
+  if (tile_group != nullptr) {
+    tile_group->GetHeader()->IncrementAccessCount();
+  }
+}
+
+void TileGroupClassifier::RecordAccess(TileGroupHeader *tile_group_header) {
+  if (IsSampled() == true) {
+    tile_group_header->IncrementAccessCount();
+  }
+}
+
+size_t TileGroupClassifier::ClassifyTable(DataTable *table) {
+  std::lock_guard<std::mutex> lock(classifier_mutex);
+  auto classify_time = classify_times.find(table);
+  if (classify_time != classify_times.end() &&
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          Clock::now() - classify_time->second).count() <
+          static_cast<int64_t>(classify_interval)) {
+    return 0;
+  }
+
+  return Classify(table);
+}
+
+size_t TileGroupClassifier::ClassifyTableNow(DataTable *table) {
+  std::lock_guard<std::mutex> lock(classifier_mutex);
+  return Classify(table);
+}
+
+size_t TileGroupClassifier::Classify(DataTable *table) {
+  classify_times[table] = Clock::now();
+
+  size_t cold_count = 0;
+  auto tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    auto tile_group_header = tile_group->GetHeader();
+    double score = tile_group_header->GetAccessScore() * score_decay +
+                   tile_group_header->TakeAccessCount();
+    tile_group_header->SetAccessScore(score);
+
+    auto temperature = GetTemperature(score);
+    tile_group_header->SetTemperature(temperature);
+    if (temperature == TileGroupTemperature::COLD) {
+      cold_count++;
+    }
+  }
+
+  LOG_TRACE("Table %u has %lu cold tile groups", table->GetOid(), cold_count);
+  return cold_count;
+}
+
+void TileGroupClassifier::DropTable(DataTable *table) {
+  std::lock_guard<std::mutex> lock(classifier_mutex);
+  classify_times.erase(table);
+}
+
+void TileGroupClassifier::SetThresholds(const double hot_score,
+                                        const double cold_score) {
+  PL_ASSERT(cold_score <= hot_score);
+  std::lock_guard<std::mutex> lock(classifier_mutex);
+  hot_threshold = hot_score;
+  cold_threshold = cold_score;
+}
+
+TileGroupTemperature TileGroupClassifier::GetTemperature(
+    const double score) const {
+  if (score >= hot_threshold) {
+    return TileGroupTemperature::HOT;
+  }
+  if (score < cold_threshold) {
+    return TileGroupTemperature::COLD;
+  }
+  return TileGroupTemperature::WARM;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor.cpp
+//
+// Identification: src/storage/tile_group_compactor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_compactor.h"
+
+#include <algorithm>
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/logger.h"
+#include "common/maintenance_scheduler.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+TileGroupCompactor &TileGroupCompactor::GetInstance() {
+  static TileGroupCompactor tile_group_compactor;
+  return tile_group_compactor;
+}
+
+TileGroupCompactor::TileGroupCompactor() : compactor_stop(true) {}
+
+TileGroupCompactor::~TileGroupCompactor() {}
+
+void TileGroupCompactor::Start() {
+  // Set signal
+  compactor_stop = false;
+
+  // Launch thread
+  compactor_thread = std::thread(&storage::TileGroupCompactor::Compact, this);
+
+  LOG_INFO("Started tile group compactor");
+}
+
+void TileGroupCompactor::Compact() {
+  // Continue till signal is not false
+  while (compactor_stop == false) {
+    {
+      MaintenanceWork work(MaintenanceTask::COMPACTOR);
+      std::lock_guard<std::mutex> lock(compactor_mutex);
+      for (auto table : tables) {
+        CompactTable(table);
+      }
+    }
+
+    // Sleep a bit
+    MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::COMPACTOR,
+                                              sleep_duration * 1000);
+  }
+}
+
+void TileGroupCompactor::Stop() {
+  // Stop compacting
+  compactor_stop = true;
+
+  // Stop thread
+  compactor_thread.join();
+
+  LOG_INFO("Stopped tile group compactor");
+}
+
+void TileGroupCompactor::AddTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(compactor_mutex);
+    LOG_TRACE("Tile group compactor adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void TileGroupCompactor::DropTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(compactor_mutex);
+    tables.erase(std::remove(tables.begin(), tables.end(), table),
+                 tables.end());
+  }
+}
+
+void TileGroupCompactor::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(compactor_mutex);
+    tables.clear();
+  }
+}
+
+size_t TileGroupCompactor::CompactTable(DataTable *table) {
+  size_t dropped_count = 0;
+  auto tile_group_count = table->GetTileGroupCount();
+
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    auto tile_group_header = tile_group->GetHeader();
+    auto allocated_tuple_count = tile_group->GetAllocatedTupleCount();
+
+    if (tile_group_header->IsRetired() == false) {
+      // the tile group may still receive inserts
+      if (tile_group_header->GetCurrentNextTupleSlot() <
+          allocated_tuple_count) {
+        continue;
+      }
+
+      if (GetLiveTupleCount(tile_group.get()) >=
+          compaction_threshold * allocated_tuple_count) {
+        continue;
+      }
+
+      LOG_TRACE("Retiring tile group %u", tile_group->GetTileGroupId());
+      tile_group_header->Retire();
+    }
+
+    if (GetLiveTupleCount(tile_group.get()) > 0) {
+      // the old versions are recycled by the GC before a later pass drops
+      // the tile group
+      MoveTuples(table, tile_group.get());
+      continue;
+    }
+
+    // every slot has been recycled, so no version chain can lead here
+    if (tile_group_header->GetRecycledTupleSlotCount() ==
+        allocated_tuple_count) {
+      if (table->DropTileGroup(tile_group->GetTileGroupId()) == true) {
+        LOG_TRACE("Dropped tile group %u", tile_group->GetTileGroupId());
+        dropped_count++;
+      }
+    }
+  }
+
+  return dropped_count;
+}
+
+bool TileGroupCompactor::MoveTuples(DataTable *table, TileGroup *tile_group) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &manager = catalog::Manager::GetInstance();
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto column_count = table->GetSchema()->GetColumnCount();
+  auto tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+
+  auto txn = txn_manager.BeginTransaction();
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+        VisibilityType::OK) {
+      continue;
+    }
+
+    // a newer version lives elsewhere. this one is left to the GC.
+    if (tile_group_header->GetEndCommitId(tuple_id) != MAX_CID) {
+      continue;
+    }
+
+    if (txn_manager.IsOwnable(txn, tile_group_header, tuple_id) == false ||
+        txn_manager.AcquireOwnership(txn, tile_group_header, tuple_id) ==
+            false) {
+      LOG_TRACE("Tuple (%u, %u) is being written, retry later", tile_group_id,
+                tuple_id);
+      txn_manager.AbortTransaction(txn);
+      return false;
+    }
+
+    // install an identical version in the active tile groups. the indexes
+    // point at the indirection, which commit moves to the new version.
+    ItemPointer old_location(tile_group_id, tuple_id);
+    ItemPointer new_location = table->AcquireVersion();
+    auto new_tile_group = manager.GetTileGroup(new_location.block);
+
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      auto value = tile_group->GetValue(tuple_id, column_id);
+      new_tile_group->SetValue(value, new_location.offset, column_id);
+    }
+
+    txn_manager.PerformUpdate(txn, old_location, new_location);
+  }
+
+  return txn_manager.CommitTransaction(txn) == ResultType::SUCCESS;
+}
+
+oid_t TileGroupCompactor::GetLiveTupleCount(const TileGroup *tile_group) {
+  auto tile_group_header = tile_group->GetHeader();
+  auto tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+
+  oid_t live_tuple_count = 0;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    // owned or committed, and not superseded by a newer version
+    if (tile_group_header->GetTransactionId(tuple_id) != INVALID_TXN_ID &&
+        tile_group_header->GetEndCommitId(tuple_id) == MAX_CID) {
+      live_tuple_count++;
+    }
+  }
+
+  return live_tuple_count;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,335 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_evictor.cpp
+//
+// Identification: src/storage/tile_group_evictor.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_evictor.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "common/maintenance_scheduler.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_classifier.h"
+#include "storage/tile_group_freezer.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+const oid_t TileGroupEvictor::PREFETCH_TILE_GROUP_COUNT;
+
+TileGroupEvictor &TileGroupEvictor::GetInstance() {
+  static TileGroupEvictor tile_group_evictor;
+  return tile_group_evictor;
+}
+
+TileGroupEvictor::TileGroupEvictor() : evictor_stop(true) {}
+
+TileGroupEvictor::~TileGroupEvictor() {
+  // No transaction runs anymore
+  for (auto &data : retired_data) {
+    data.release();
+  }
+}
+
+void TileGroupEvictor::Start() {
+  // Set signal
+  evictor_stop = false;
+
+  // Launch thread
+  evictor_thread = std::thread(&storage::TileGroupEvictor::Evict, this);
+
+  LOG_INFO("Started tile group evictor");
+}
+
+void TileGroupEvictor::Evict() {
+  // Continue till signal is not false
+  while (evictor_stop == false) {
+    {
+      MaintenanceWork work(MaintenanceTask::EVICTOR);
+      size_t evicted_size = 0;
+      EvictTables(&evicted_size);
+      work.AddIoBytes(evicted_size);
+      ReleaseData();
+    }
+
+    // Sleep a bit
+    MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::EVICTOR,
+                                              sleep_duration * 1000);
+  }
+}
+
+void TileGroupEvictor::Stop() {
+  // Stop evicting
+  evictor_stop = true;
+
+  // Stop thread
+  evictor_thread.join();
+
+  LOG_INFO("Stopped tile group evictor");
+}
+
+void TileGroupEvictor::AddTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(evictor_mutex);
+    LOG_TRACE("Tile group evictor adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void TileGroupEvictor::DropTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(evictor_mutex);
+    tables.erase(std::remove(tables.begin(), tables.end(), table),
+                 tables.end());
+  }
+}
+
+void TileGroupEvictor::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(evictor_mutex);
+    tables.clear();
+  }
+}
+
+size_t TileGroupEvictor::GetResidentSize(const TileGroup *tile_group) {
+  return tile_group->GetResidentSize();
+}
+
+size_t TileGroupEvictor::EvictTables(size_t *evicted_size) {
+  std::lock_guard<std::mutex> lock(evictor_mutex);
+
+  // The cold candidates of all tables compete for the same budget
+  std::vector<std::shared_ptr<TileGroup>> candidates;
+  size_t resident_size = 0;
+  for (auto table : tables) {
+    TileGroupClassifier::GetInstance().ClassifyTable(table);
+
+    auto tile_group_count = table->GetTileGroupCount();
+    for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+         tile_group_offset++) {
+      auto tile_group = table->GetTileGroup(tile_group_offset);
+      if (tile_group == nullptr) {
+        continue;
+      }
+
+      resident_size += GetResidentSize(tile_group.get());
+
+      auto tile_group_header = tile_group->GetHeader();
+      if (tile_group_header->IsFrozen() == true &&
+          tile_group_header->GetTemperature() == TileGroupTemperature::COLD &&
+          tile_group->IsEvicted() == false &&
+          tile_group->IsReleased() == false) {
+        candidates.push_back(tile_group);
+      }
+    }
+  }
+
+  // Coldest first
+  std::sort(candidates.begin(), candidates.end(),
+            [](const std::shared_ptr<TileGroup> &left,
+               const std::shared_ptr<TileGroup> &right) {
+              return left->GetHeader()->GetAccessScore() <
+                     right->GetHeader()->GetAccessScore();
+            });
+
+  size_t evicted_count = 0;
+  for (auto &tile_group : candidates) {
+    if (evicted_count >= max_evictions_per_pass ||
+        (memory_budget != 0 && resident_size <= memory_budget)) {
+      break;
+    }
+
+    size_t tile_group_size = GetResidentSize(tile_group.get());
+    if (EvictTileGroup(tile_group.get()) == true) {
+      resident_size -= std::min(resident_size, tile_group_size);
+      if (evicted_size != nullptr) {
+        *evicted_size += tile_group_size;
+      }
+      evicted_count++;
+    }
+  }
+
+  if (evicted_count > 0) {
+    LOG_DEBUG("Evicted %lu tile groups, %lu bytes of tuple slots resident",
+              evicted_count, resident_size);
+  }
+  return evicted_count;
+}
+
+// Unmaps the file the tuple slots of a tile group were evicted to
+class MappedFileDeleter {
+ public:
+  explicit MappedFileDeleter(const size_t length) : length(length) {}
+
+  void operator()(char *address) const { munmap(address, length); }
+
+ private:
+  size_t length;
+};
+
+bool TileGroupEvictor::EvictTileGroup(TileGroup *tile_group) {
+  // The freezer may be releasing the tuple slots
+  std::lock_guard<std::mutex> lock(tile_group->tile_group_mutex);
+
+  auto tile_group_header = tile_group->GetHeader();
+  if (tile_group_header->IsFrozen() == false ||
+      tile_group->IsEvicted() == true || tile_group->IsReleased() == true) {
+    return false;
+  }
+
+  // Writers that take ownership from now on give it up again. The ones that
+  // took it before have thawed the tile group, see the check that follows.
+  tile_group_header->StartRelocation();
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  // The versions are at most as new as when the tile group was frozen
+  cid_t commit_id = INVALID_CID;
+  if (tile_group_header->IsFrozen() == false ||
+      TileGroupFreezer::CanFreeze(tile_group,
+                                  tile_group_header->GetFrozenCommitId(),
+                                  commit_id) == false) {
+    tile_group_header->FinishRelocation();
+    return false;
+  }
+
+  // Every tile starts on a page of its own in the file
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  auto tile_count = tile_group->GetTileCount();
+  std::vector<size_t> tile_offsets;
+  size_t file_size = 0;
+  for (oid_t tile_offset = 0; tile_offset < tile_count; tile_offset++) {
+    tile_offsets.push_back(file_size);
+    size_t tile_size = tile_group->GetTile(tile_offset)->GetInlinedSize();
+    file_size += (tile_size + page_size - 1) / page_size * page_size;
+  }
+
+  std::string file_name = eviction_directory + "/tile_group_" +
+                          std::to_string(tile_group->GetTileGroupId()) +
+                          ".evicted";
+  int fd = open(file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0) {
+    LOG_ERROR("Could not create %s to evict a tile group", file_name.c_str());
+    tile_group_header->FinishRelocation();
+    return false;
+  }
+
+  bool is_written = (file_size > 0 && ftruncate(fd, file_size) == 0);
+  for (oid_t tile_offset = 0; is_written == true && tile_offset < tile_count;
+       tile_offset++) {
+    auto tile = tile_group->GetTile(tile_offset);
+    const char *tile_data = tile->GetTupleLocation(0);
+    size_t tile_size = tile->GetInlinedSize();
+    size_t written_size = 0;
+    while (written_size < tile_size) {
+      auto size = pwrite(fd, tile_data + written_size, tile_size - written_size,
+                         tile_offsets[tile_offset] + written_size);
+      if (size <= 0) {
+        is_written = false;
+        break;
+      }
+      written_size += size;
+    }
+  }
+
+  // The slots are only read from the file once the page cache dropped them
+  char *address = nullptr;
+  if (is_written == true && fdatasync(fd) == 0) {
+    posix_fadvise(fd, 0, file_size, POSIX_FADV_DONTNEED);
+    void *mapping = mmap(nullptr, file_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      address = static_cast<char *>(mapping);
+    }
+  }
+
+  // The mapping keeps the file until it is unmapped
+  close(fd);
+  unlink(file_name.c_str());
+
+  if (address == nullptr) {
+    LOG_ERROR("Could not evict tile group %u to %s",
+              tile_group->GetTileGroupId(), file_name.c_str());
+    tile_group_header->FinishRelocation();
+    return false;
+  }
+
+  // The tiles share the mapping, it is unmapped with the last of them
+  std::shared_ptr<char> mapped_file(address, MappedFileDeleter(file_size));
+  eid_t epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  {
+    std::lock_guard<std::mutex> lock(retired_data_mutex);
+    for (oid_t tile_offset = 0; tile_offset < tile_count; tile_offset++) {
+      std::shared_ptr<char> mapped_tile(mapped_file,
+                                        address + tile_offsets[tile_offset]);
+      auto release = tile_group->GetTile(tile_offset)->MapData(mapped_tile);
+      retired_data.push_back({epoch_id, release});
+    }
+  }
+
+  tile_group_header->FinishRelocation();
+
+  LOG_TRACE("Evicted tile group %u : %lu bytes",
+            tile_group->GetTileGroupId(), file_size);
+  return true;
+}
+
+size_t TileGroupEvictor::ReleaseData() {
+  auto expired_epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetExpiredEpochId();
+  if (expired_epoch_id == MAX_EID) {
+    return 0;
+  }
+
+  // The readers of the epoch the slots were moved in may still use them
+  std::vector<RetiredData> released_data;
+  {
+    std::lock_guard<std::mutex> lock(retired_data_mutex);
+    auto released = std::stable_partition(
+        retired_data.begin(), retired_data.end(),
+        [expired_epoch_id](const RetiredData &data) {
+          return data.epoch_id > expired_epoch_id;
+        });
+    released_data.assign(released, retired_data.end());
+    retired_data.erase(released, retired_data.end());
+  }
+
+  for (auto &data : released_data) {
+    data.release();
+  }
+  return released_data.size();
+}
+
+void TileGroupEvictor::PrefetchTileGroups(DataTable *table,
+                                          const oid_t tile_group_offset,
+                                          const oid_t tile_group_count) {
+  auto table_tile_group_count = table->GetTileGroupCount();
+  auto end_offset = std::min<size_t>(tile_group_offset + tile_group_count,
+                                     table_tile_group_count);
+  for (oid_t offset = tile_group_offset; offset < end_offset; offset++) {
+    auto tile_group = table->GetTileGroup(offset);
+    if (tile_group != nullptr && tile_group->IsEvicted() == true) {
+      tile_group->Prefetch();
+    }
+  }
+}
+
+}  // End storage namespace
+}  // End peloton namespace
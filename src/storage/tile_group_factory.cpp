@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/tile_group_factory.h"
+#include "configuration/configuration.h"
 // #include "logging/logging_util.h"
 #include "storage/tile_group_header.h"
 
@@ -27,14 +28,18 @@ namespace storage {
 TileGroup *TileGroupFactory::GetTileGroup(
     oid_t database_id, oid_t table_id, oid_t tile_group_id,
     AbstractTable *table, const std::vector<catalog::Schema> &schemas,
-    const column_map_type &column_map, int tuple_count) {
+    const column_map_type &column_map, int tuple_count, int numa_node,
+    const std::vector<std::shared_ptr<char>> &mapped_tile_data) {
   // Allocate the data on appropriate backend
-  BackendType backend_type = BackendType::MM;
+  BackendType backend_type =
+      FLAGS_huge_page_tiles ? BackendType::HUGE_PAGE : BackendType::MM;
       // logging::LoggingUtil::GetBackendType(peloton_logging_mode);
 
-  TileGroupHeader *tile_header = new TileGroupHeader(backend_type, tuple_count);
-  TileGroup *tile_group = new TileGroup(backend_type, tile_header, table,
-                                        schemas, column_map, tuple_count);
+  TileGroupHeader *tile_header =
+      new TileGroupHeader(backend_type, tuple_count, numa_node);
+  TileGroup *tile_group =
+      new TileGroup(backend_type, tile_header, table, schemas, column_map,
+                    tuple_count, numa_node, mapped_tile_data);
 
   tile_header->SetTileGroup(tile_group);
 
@@ -0,0 +1,265 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_freezer.cpp
+//
+// Identification: src/storage/tile_group_freezer.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_freezer.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "common/maintenance_scheduler.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/frozen_tile_group.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_classifier.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+TileGroupFreezer &TileGroupFreezer::GetInstance() {
+  static TileGroupFreezer tile_group_freezer;
+  return tile_group_freezer;
+}
+
+TileGroupFreezer::TileGroupFreezer() : freezer_stop(true) {}
+
+TileGroupFreezer::~TileGroupFreezer() {}
+
+void TileGroupFreezer::Start() {
+  // Set signal
+  freezer_stop = false;
+
+  // Launch thread
+  freezer_thread = std::thread(&storage::TileGroupFreezer::Freeze, this);
+
+  LOG_INFO("Started tile group freezer");
+}
+
+void TileGroupFreezer::Freeze() {
+  // Continue till signal is not false
+  while (freezer_stop == false) {
+    auto expired_cid =
+        concurrency::EpochManagerFactory::GetInstance().GetExpiredCid();
+
+    {
+      MaintenanceWork work(MaintenanceTask::FREEZER);
+      std::lock_guard<std::mutex> lock(freezer_mutex);
+      for (auto table : tables) {
+        TileGroupClassifier::GetInstance().ClassifyTable(table);
+        FreezeTable(table, expired_cid, true);
+      }
+      ReleaseData();
+    }
+
+    // Sleep a bit
+    MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::FREEZER,
+                                              sleep_duration * 1000);
+  }
+}
+
+void TileGroupFreezer::Stop() {
+  // Stop freezing
+  freezer_stop = true;
+
+  // Stop thread
+  freezer_thread.join();
+
+  LOG_INFO("Stopped tile group freezer");
+}
+
+void TileGroupFreezer::AddTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(freezer_mutex);
+    LOG_TRACE("Tile group freezer adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void TileGroupFreezer::DropTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(freezer_mutex);
+    tables.erase(std::remove(tables.begin(), tables.end(), table),
+                 tables.end());
+  }
+  {
+    std::lock_guard<std::mutex> lock(dictionaries_mutex);
+    dictionaries.erase(table);
+  }
+}
+
+void TileGroupFreezer::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(freezer_mutex);
+    tables.clear();
+  }
+  {
+    std::lock_guard<std::mutex> lock(dictionaries_mutex);
+    dictionaries.clear();
+  }
+}
+
+size_t TileGroupFreezer::FreezeTable(DataTable *table,
+                                     const cid_t expired_cid,
+                                     const bool cold_only) {
+  size_t frozen_count = 0;
+  auto tile_group_count = table->GetTileGroupCount();
+
+  // The tile groups of a table are frozen one pass at a time
+  std::lock_guard<std::mutex> lock(dictionaries_mutex);
+  auto &shared_dictionaries = dictionaries[table];
+
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    if (cold_only == true && tile_group->GetHeader()->GetTemperature() !=
+                                 TileGroupTemperature::COLD) {
+      continue;
+    }
+
+    bool is_frozen = FreezeTileGroup(tile_group.get(), expired_cid,
+                                     &shared_dictionaries);
+    if (is_frozen == true) {
+      frozen_count++;
+    }
+
+    // the frozen copy is all that stays resident. the slots restored since
+    // the tile group was frozen are released again once it is cold.
+    if (is_frozen == true ||
+        (tile_group->GetHeader()->IsFrozen() == true &&
+         tile_group->GetHeader()->GetTemperature() ==
+             TileGroupTemperature::COLD)) {
+      ReleaseTiles(tile_group.get());
+    }
+  }
+
+  return frozen_count;
+}
+
+void TileGroupFreezer::ReleaseTiles(TileGroup *tile_group) {
+  auto releases = tile_group->ReleaseTiles();
+  if (releases.empty() == true) {
+    return;
+  }
+
+  // The readers of the current epoch may still use the slots
+  eid_t epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetCurrentEpochId();
+  std::lock_guard<std::mutex> lock(retired_data_mutex);
+  for (auto &release : releases) {
+    retired_data.push_back({epoch_id, release});
+  }
+}
+
+size_t TileGroupFreezer::ReleaseData() {
+  auto expired_epoch_id =
+      concurrency::EpochManagerFactory::GetInstance().GetExpiredEpochId();
+  if (expired_epoch_id == MAX_EID) {
+    return 0;
+  }
+
+  std::vector<RetiredData> released_data;
+  {
+    std::lock_guard<std::mutex> lock(retired_data_mutex);
+    auto released = std::stable_partition(
+        retired_data.begin(), retired_data.end(),
+        [expired_epoch_id](const RetiredData &data) {
+          return data.epoch_id > expired_epoch_id;
+        });
+    released_data.assign(released, retired_data.end());
+    retired_data.erase(released, retired_data.end());
+  }
+
+  for (auto &data : released_data) {
+    data.release();
+  }
+  return released_data.size();
+}
+
+bool TileGroupFreezer::FreezeTileGroup(
+    TileGroup *tile_group, const cid_t expired_cid,
+    std::vector<std::shared_ptr<const FrozenDictionary>>
+        *shared_dictionaries) {
+  auto tile_group_header = tile_group->GetHeader();
+
+  if (tile_group_header->IsFrozen() == true) {
+    return false;
+  }
+
+  // the tile group was thawed by a writer. drop the stale compressed copy.
+  tile_group->ReleaseFrozenTileGroup();
+
+  cid_t commit_id = INVALID_CID;
+  if (CanFreeze(tile_group, expired_cid, commit_id) == false) {
+    return false;
+  }
+
+  std::shared_ptr<FrozenTileGroup> frozen_tile_group(
+      new FrozenTileGroup(tile_group, tile_group->GetAllocatedTupleCount(),
+                          commit_id, shared_dictionaries));
+
+  tile_group->Freeze(frozen_tile_group);
+
+  // a writer may have acquired a tuple while we were encoding the tile group.
+  // writers thaw after acquiring ownership, so re-checking after publishing
+  // the frozen header guarantees that one of us thaws it.
+  if (CanFreeze(tile_group, expired_cid, commit_id) == false) {
+    tile_group_header->Thaw();
+    return false;
+  }
+
+  LOG_TRACE("Froze tile group %u : %s", tile_group->GetTileGroupId(),
+            frozen_tile_group->GetInfo().c_str());
+
+  return true;
+}
+
+bool TileGroupFreezer::CanFreeze(const TileGroup *tile_group,
+                                 const cid_t expired_cid, cid_t &commit_id) {
+  auto tile_group_header = tile_group->GetHeader();
+  auto tuple_count = tile_group->GetAllocatedTupleCount();
+
+  // the tile group may still receive inserts
+  if (tile_group_header->GetCurrentNextTupleSlot() < tuple_count) {
+    return false;
+  }
+
+  commit_id = INVALID_CID;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (tile_group_header->GetTransactionId(tuple_id) != INITIAL_TXN_ID) {
+      // owned by a writer, or an empty/recycled slot
+      return false;
+    }
+
+    auto begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+    if (begin_cid == MAX_CID || begin_cid > expired_cid) {
+      return false;
+    }
+
+    if (tile_group_header->GetEndCommitId(tuple_id) != MAX_CID) {
+      // older or deleted version
+      return false;
+    }
+
+    commit_id = std::max(commit_id, begin_cid);
+  }
+
+  return tuple_count > 0;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
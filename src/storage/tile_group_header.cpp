@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -17,6 +18,7 @@
 #include "common/container_tuple.h"
 #include "common/logger.h"
 #include "common/macros.h"
+#include "common/memory_tracker.h"
 #include "common/platform.h"
 #include "common/printable.h"
 #include "concurrency/transaction_manager_factory.h"
@@ -29,24 +31,59 @@ namespace peloton {
 namespace storage {
 
 TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
-                                 const int &tuple_count)
+                                 const int &tuple_count, const int numa_node)
     : backend_type(backend_type),
+      numa_node(numa_node),
       tile_group(nullptr),
       data(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
-      tile_header_lock() {
+      tile_header_lock(),
+      recycled_slot_count(0),
+      frozen_commit_id(INVALID_CID),
+      append_only(false),
+      pending_append_count(0),
+      newest_append_commit_id(INVALID_CID),
+      has_empty_append(false),
+      retired(false),
+      relocating(false),
+      deleting_txn_id(INVALID_TXN_ID),
+      delete_read_id(INVALID_CID),
+      deleted_commit_id(MAX_CID),
+      access_count(0),
+      access_score(0),
+      temperature(TileGroupTemperature::HOT) {
   header_size = num_tuple_slots * header_entry_size;
 
+  // one bit per slot
+  recycled_slot_word_count = (num_tuple_slots + 63) / 64;
+  recycled_slots.reset(new std::atomic<uint64_t>[recycled_slot_word_count]);
+  for (oid_t word_itr = 0; word_itr < recycled_slot_word_count; word_itr++) {
+    recycled_slots[word_itr] = 0;
+  }
+
   // allocate storage space for header
   // auto &storage_manager = storage::StorageManager::GetInstance();
   // data = reinterpret_cast<char *>(
   // storage_manager.Allocate(backend_type, header_size));
-  data = new char[header_size];
+  if (backend_type == BackendType::HUGE_PAGE) {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    data = reinterpret_cast<char *>(
+        backend_manager.AllocateHugePages(header_size, numa_node));
+  } else if (numa_node == INVALID_NUMA_NODE) {
+    data = reinterpret_cast<char *>(aligned_alloc(CACHELINE_SIZE, header_size));
+  } else {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    data = reinterpret_cast<char *>(
+        backend_manager.AllocateOnNode(header_size, numa_node));
+  }
   PL_ASSERT(data != nullptr);
 
   // zero out the data
   PL_MEMSET(data, 0, header_size);
+  MemoryTracker::Allocate(
+      MemoryComponentType::TILE_GROUP_HEADER,
+      header_size + recycled_slot_word_count * sizeof(uint64_t));
 
   // Set MVCC Initial Value
   for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
@@ -63,10 +100,147 @@ TileGroupHeader::~TileGroupHeader() {
   // reclaim the space
   // auto &storage_manager = storage::StorageManager::GetInstance();
   // storage_manager.Release(backend_type, data);
-  delete[] data;
+  if (backend_type == BackendType::HUGE_PAGE) {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    backend_manager.ReleaseHugePages(data, header_size, numa_node);
+  } else if (numa_node == INVALID_NUMA_NODE) {
+    free(data);
+  } else {
+    auto &backend_manager = storage::BackendManager::GetInstance();
+    backend_manager.ReleaseOnNode(data, header_size);
+  }
+  MemoryTracker::Release(
+      MemoryComponentType::TILE_GROUP_HEADER,
+      header_size + recycled_slot_word_count * sizeof(uint64_t));
   data = nullptr;
 }
 
+//===--------------------------------------------------------------------===//
+// Recycled tuple slots
+//===--------------------------------------------------------------------===//
+
+bool TileGroupHeader::RecycleTupleSlot(const oid_t tuple_slot_id) {
+  PL_ASSERT(tuple_slot_id < num_tuple_slots);
+
+  uint64_t mask = 1UL << (tuple_slot_id % 64);
+  auto old_word = recycled_slots[tuple_slot_id / 64].fetch_or(mask);
+
+  // the slot was already recycled
+  if ((old_word & mask) != 0) {
+    return false;
+  }
+
+  return recycled_slot_count.fetch_add(1) == 0;
+}
+
+oid_t TileGroupHeader::GetRecycledTupleSlot() {
+  for (oid_t word_itr = 0;
+       word_itr < recycled_slot_word_count && recycled_slot_count > 0;
+       word_itr++) {
+    uint64_t word = recycled_slots[word_itr].load();
+
+    while (word != 0) {
+      // claim the lowest recycled slot in this word
+      uint64_t mask = word & (~word + 1);
+      if (recycled_slots[word_itr].compare_exchange_weak(word, word & ~mask) ==
+          true) {
+        recycled_slot_count.fetch_sub(1);
+        return word_itr * 64 + __builtin_ctzll(mask);
+      }
+      // word was reloaded by the failed exchange, try again
+    }
+  }
+
+  return INVALID_OID;
+}
+
+//===--------------------------------------------------------------------===//
+// Append-only tile groups
+//===--------------------------------------------------------------------===//
+
+void TileGroupHeader::CommitAppend(const cid_t commit_id) {
+  PL_ASSERT(append_only == true);
+  cid_t newest_commit_id = newest_append_commit_id.load();
+  while (newest_commit_id < commit_id &&
+         newest_append_commit_id.compare_exchange_weak(
+             newest_commit_id, commit_id) == false)
+    ;
+
+  // the commit id is published before the insert stops being pending
+  pending_append_count--;
+}
+
+void TileGroupHeader::AbortAppend() {
+  PL_ASSERT(append_only == true);
+  has_empty_append = true;
+  pending_append_count--;
+}
+
+oid_t TileGroupHeader::GetVisibleAppendCount(const cid_t read_id) const {
+  // the slots of a retired tile group are recycled and no longer hold
+  // committed tuples
+  if (append_only == false || retired.load() == true) {
+    return 0;
+  }
+
+  // the slots are read before the pending inserts, so that every slot
+  // handed out so far is either counted as pending or committed
+  oid_t slot_count = GetCurrentNextTupleSlot();
+  if (pending_append_count.load() != 0 || has_empty_append.load() == true ||
+      newest_append_commit_id.load() > read_id) {
+    return 0;
+  }
+  return slot_count;
+}
+
+//===--------------------------------------------------------------------===//
+// Deleted tile groups
+//===--------------------------------------------------------------------===//
+
+bool TileGroupHeader::StartDelete(const txn_id_t txn_id,
+                                  const cid_t read_id) {
+  txn_id_t no_txn_id = INVALID_TXN_ID;
+  if (deleting_txn_id.compare_exchange_strong(no_txn_id, txn_id) == false) {
+    return false;
+  }
+  // only read by the deleting transaction until it is committed
+  delete_read_id = read_id;
+  return true;
+}
+
+void TileGroupHeader::CommitDelete(const cid_t commit_id) {
+  PL_ASSERT(IsDeleting() == true);
+  // the read id is published along with the commit id
+  deleted_commit_id = commit_id;
+}
+
+void TileGroupHeader::FinishDelete() {
+  PL_ASSERT(IsDeleting() == true);
+  deleted_commit_id = MAX_CID;
+  deleting_txn_id = INVALID_TXN_ID;
+}
+
+bool TileGroupHeader::IsDeletedVersion(const txn_id_t txn_id,
+                                       const cid_t vis_id,
+                                       const cid_t begin_cid) const {
+  txn_id_t deleting_txn = deleting_txn_id.load();
+  if (deleting_txn == INVALID_TXN_ID) {
+    return false;
+  }
+  if (deleting_txn != txn_id && deleted_commit_id.load() > vis_id) {
+    // the delete is not visible to the transaction
+    return false;
+  }
+  return begin_cid <= delete_read_id;
+}
+
+bool TileGroupHeader::IsDeletedSlot(const oid_t tuple_slot_id) const {
+  return IsDeleting() == true &&
+         GetTransactionId(tuple_slot_id) == INITIAL_TXN_ID &&
+         GetBeginCommitId(tuple_slot_id) <= delete_read_id &&
+         GetEndCommitId(tuple_slot_id) == MAX_CID;
+}
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
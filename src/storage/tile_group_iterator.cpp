@@ -19,10 +19,16 @@ namespace peloton {
 namespace storage {
 
 bool TileGroupIterator::Next(std::shared_ptr<TileGroup> &tileGroup) {
-  if (HasNext()) {
+  while (HasNext()) {
     auto next = table_->GetTileGroup(tile_group_itr_);
-    tileGroup.swap(next);
     tile_group_itr_++;
+
+    // skip tile groups dropped by the compactor
+    if (next == nullptr) {
+      continue;
+    }
+
+    tileGroup.swap(next);
     return (true);
   }
   return (false);
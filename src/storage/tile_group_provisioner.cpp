@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_provisioner.cpp
+//
+// Identification: src/storage/tile_group_provisioner.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tile_group_provisioner.h"
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "common/maintenance_scheduler.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace storage {
+
+TileGroupProvisioner &TileGroupProvisioner::GetInstance() {
+  static TileGroupProvisioner tile_group_provisioner;
+  return tile_group_provisioner;
+}
+
+TileGroupProvisioner::TileGroupProvisioner() : provisioner_stop(true) {}
+
+TileGroupProvisioner::~TileGroupProvisioner() {}
+
+void TileGroupProvisioner::Start() {
+  // Set signal
+  provisioner_stop = false;
+
+  // Launch thread
+  provisioner_thread =
+      std::thread(&storage::TileGroupProvisioner::Provision, this);
+
+  LOG_INFO("Started tile group provisioner");
+}
+
+void TileGroupProvisioner::Provision() {
+  // Continue till signal is not false
+  while (provisioner_stop == false) {
+    {
+      MaintenanceWork work(MaintenanceTask::PROVISIONER);
+      ProvisionTables();
+    }
+
+    // Sleep a bit
+    MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::PROVISIONER,
+                                              sleep_duration * 1000);
+  }
+}
+
+void TileGroupProvisioner::Stop() {
+  // Stop provisioning
+  provisioner_stop = true;
+
+  // Stop thread
+  provisioner_thread.join();
+
+  LOG_INFO("Stopped tile group provisioner");
+}
+
+void TileGroupProvisioner::AddTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(provisioner_mutex);
+    LOG_TRACE("Tile group provisioner adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void TileGroupProvisioner::DropTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(provisioner_mutex);
+    tables.erase(std::remove(tables.begin(), tables.end(), table),
+                 tables.end());
+  }
+}
+
+void TileGroupProvisioner::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(provisioner_mutex);
+    tables.clear();
+  }
+}
+
+size_t TileGroupProvisioner::ProvisionTables() {
+  std::lock_guard<std::mutex> lock(provisioner_mutex);
+  size_t created_count = 0;
+  for (auto table : tables) {
+    created_count += table->PrepareTileGroups();
+  }
+  if (created_count > 0) {
+    LOG_TRACE("Provisioned %lu tile groups", created_count);
+  }
+  return created_count;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -21,6 +21,7 @@
 #include "common/macros.h"
 #include "storage/tuple.h"
 #include "type/value.h"
+#include "type/varlen_type.h"
 
 namespace peloton {
 namespace storage {
@@ -44,6 +45,16 @@ type::Value Tuple::GetValue(oid_t column_id) const {
 // Set all columns by value into this tuple.
 void Tuple::SetValue(const oid_t column_offset, const type::Value &value,
                      type::AbstractPool *data_pool) {
+  SetValue(column_offset, value, data_pool, false);
+}
+
+void Tuple::SetTileValue(const oid_t column_offset, const type::Value &value,
+                         type::AbstractPool *data_pool) {
+  SetValue(column_offset, value, data_pool, true);
+}
+
+void Tuple::SetValue(const oid_t column_offset, const type::Value &value,
+                     type::AbstractPool *data_pool, bool in_tile) {
   const type::TypeId type = tuple_schema_->GetType(column_offset);
   LOG_TRACE("c offset: %d; using pool: %p", column_offset, data_pool);
 
@@ -64,10 +75,20 @@ void Tuple::SetValue(const oid_t column_offset, const type::Value &value,
         && value.GetLength() > column_length + 1) {      // value.GetLength() == strlen(value) + 1 because of '\0'
       throw peloton::ValueOutOfRangeException(type, column_length);
     }
-    value.SerializeTo(value_location, is_inlined, data_pool);
+    if (in_tile) {
+      type::VarlenType::SerializeToTile(value, value_location, is_inlined,
+                                        data_pool);
+    } else {
+      value.SerializeTo(value_location, is_inlined, data_pool);
+    }
   } else {
     type::Value casted_value = (value.CastAs(type));
-    casted_value.SerializeTo(value_location, is_inlined, data_pool);
+    if (in_tile) {
+      type::VarlenType::SerializeToTile(casted_value, value_location,
+                                        is_inlined, data_pool);
+    } else {
+      casted_value.SerializeTo(value_location, is_inlined, data_pool);
+    }
   }
 }
 
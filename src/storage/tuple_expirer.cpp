@@ -0,0 +1,323 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_expirer.cpp
+//
+// Identification: src/storage/tuple_expirer.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tuple_expirer.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <date/date.h>
+
+#include "common/logger.h"
+#include "common/maintenance_scheduler.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/zone_map.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// Timestamps are encoded as ((((month * 32 + day) * 27 + zone) * 10000 +
+// year) * 100000 + second) * 1000000 + microsecond. Two of them with the
+// same date prefix compare like the times they encode.
+const uint64_t kTimestampDateDivisor = 10000ULL * 100000ULL * 1000000ULL;
+
+}  // namespace
+
+TupleExpirer &TupleExpirer::GetInstance() {
+  static TupleExpirer tuple_expirer;
+  return tuple_expirer;
+}
+
+TupleExpirer::TupleExpirer() : expirer_stop(true) {}
+
+TupleExpirer::~TupleExpirer() {}
+
+void TupleExpirer::Start() {
+  // Set signal
+  expirer_stop = false;
+
+  // Launch thread
+  expirer_thread = std::thread(&storage::TupleExpirer::Expire, this);
+
+  LOG_INFO("Started tuple expirer");
+}
+
+void TupleExpirer::Expire() {
+  // Continue till signal is not false
+  while (expirer_stop == false) {
+    {
+      MaintenanceWork work(MaintenanceTask::EXPIRER);
+      std::lock_guard<std::mutex> lock(expirer_mutex);
+      auto now = GetCurrentTime();
+      for (auto table : tables) {
+        ExpireTable(table, now);
+      }
+    }
+
+    // Sleep a bit
+    MaintenanceScheduler::GetInstance().Pause(MaintenanceTask::EXPIRER,
+                                              sleep_duration * 1000);
+  }
+}
+
+void TupleExpirer::Stop() {
+  // Stop expiring
+  expirer_stop = true;
+
+  // Stop thread
+  expirer_thread.join();
+
+  LOG_INFO("Stopped tuple expirer");
+}
+
+void TupleExpirer::AddTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(expirer_mutex);
+    LOG_TRACE("Tuple expirer adding table : %p", table);
+
+    tables.push_back(table);
+  }
+}
+
+void TupleExpirer::DropTable(DataTable *table) {
+  {
+    std::lock_guard<std::mutex> lock(expirer_mutex);
+    tables.erase(std::remove(tables.begin(), tables.end(), table),
+                 tables.end());
+  }
+}
+
+void TupleExpirer::ClearTables() {
+  {
+    std::lock_guard<std::mutex> lock(expirer_mutex);
+    tables.clear();
+  }
+}
+
+size_t TupleExpirer::ExpireTable(DataTable *table, const int64_t now) {
+  oid_t column_id = table->GetTimeToLiveColumn();
+  if (column_id == INVALID_OID) {
+    return 0;
+  }
+  int64_t cutoff = now - static_cast<int64_t>(table->GetTimeToLive());
+
+  size_t expired_count = 0;
+  auto tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count &&
+                                    expired_count < expire_batch_size;
+       tile_group_offset++) {
+    auto tile_group = table->GetTileGroup(tile_group_offset);
+    if (tile_group == nullptr) {
+      continue;
+    }
+
+    int64_t oldest, newest;
+    bool bounded =
+        GetTimeRange(tile_group.get(), column_id, oldest, newest);
+
+    // no tuple has expired yet
+    if (bounded == true && oldest >= cutoff) {
+      continue;
+    }
+
+    // every tuple has expired
+    if (bounded == true && newest < cutoff) {
+      auto deleted_count = DeleteTileGroup(tile_group.get());
+      if (deleted_count > 0) {
+        LOG_TRACE("Expired tile group %u", tile_group->GetTileGroupId());
+        expired_count += deleted_count;
+        continue;
+      }
+    }
+
+    expired_count +=
+        ExpireTuples(table, tile_group.get(), column_id, cutoff);
+  }
+
+  return expired_count;
+}
+
+bool TupleExpirer::GetTimestampTime(const type::Value &value, int64_t &time) {
+  if (value.IsNull() == true ||
+      value.GetTypeId() != type::TypeId::TIMESTAMP) {
+    return false;
+  }
+
+  uint64_t timestamp = value.GetAs<uint64_t>();
+  uint32_t micro = timestamp % 1000000;
+  timestamp /= 1000000;
+  uint32_t second = timestamp % 100000;
+  timestamp /= 100000;
+  uint32_t year = timestamp % 10000;
+  timestamp /= 10000;
+  int32_t zone = static_cast<int32_t>(timestamp % 27) - 12;
+  timestamp /= 27;
+  uint32_t day = timestamp % 32;
+  timestamp /= 32;
+  uint32_t month = timestamp;
+
+  date::year_month_day ymd{date::year{static_cast<int>(year)},
+                           date::month{month}, date::day{day}};
+  if (ymd.ok() == false || second >= 24 * 3600) {
+    return false;
+  }
+
+  // the zone is the offset of the local time from UTC, in hours
+  int64_t days = date::sys_days{ymd}.time_since_epoch().count();
+  time = (days * 24 * 3600 + second - zone * 3600) * 1000000 + micro;
+  return true;
+}
+
+int64_t TupleExpirer::GetCurrentTime() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+bool TupleExpirer::GetTimeRange(const TileGroup *tile_group,
+                                const oid_t column_id, int64_t &oldest,
+                                int64_t &newest) {
+  auto zone_map = tile_group->GetZoneMap();
+  if (zone_map->GetNullCount(column_id) > 0) {
+    return false;
+  }
+
+  auto min_value = zone_map->GetMinValue(column_id);
+  auto max_value = zone_map->GetMaxValue(column_id);
+  if (min_value.GetTypeId() != type::TypeId::TIMESTAMP ||
+      max_value.GetTypeId() != type::TypeId::TIMESTAMP) {
+    return false;
+  }
+
+  // the values in between only compare like their times if they all share
+  // the date of the bounds
+  if (min_value.GetAs<uint64_t>() / kTimestampDateDivisor !=
+      max_value.GetAs<uint64_t>() / kTimestampDateDivisor) {
+    return false;
+  }
+
+  return GetTimestampTime(min_value, oldest) == true &&
+         GetTimestampTime(max_value, newest) == true;
+}
+
+size_t TupleExpirer::DeleteTileGroup(TileGroup *tile_group) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  if (txn_manager.PerformTileGroupDelete(txn, tile_group->GetTileGroupId()) ==
+      false) {
+    txn_manager.AbortTransaction(txn);
+    return 0;
+  }
+
+  auto tile_group_header = tile_group->GetHeader();
+  auto tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+  size_t deleted_count = 0;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (tile_group_header->IsDeletedSlot(tuple_id) == true) {
+      deleted_count++;
+    }
+  }
+
+  if (txn_manager.CommitTransaction(txn) != ResultType::SUCCESS) {
+    return 0;
+  }
+  return deleted_count;
+}
+
+size_t TupleExpirer::ExpireTuples(DataTable *table, TileGroup *tile_group,
+                                  const oid_t column_id,
+                                  const int64_t cutoff) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+
+  auto txn = txn_manager.BeginTransaction();
+
+  std::vector<oid_t> expired_tuples;
+  bool all_expired = true;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) !=
+        VisibilityType::OK) {
+      continue;
+    }
+
+    int64_t time;
+    if (GetTimestampTime(tile_group->GetValue(tuple_id, column_id), time) ==
+            false ||
+        time >= cutoff) {
+      all_expired = false;
+      continue;
+    }
+    expired_tuples.push_back(tuple_id);
+  }
+
+  if (expired_tuples.empty() == true) {
+    txn_manager.AbortTransaction(txn);
+    return 0;
+  }
+
+  // the tile group may still be deleted at once, e.g. if its timestamps span
+  // more than one date
+  if (all_expired == true &&
+      txn_manager.PerformTileGroupDelete(txn, tile_group_id) == true) {
+    size_t deleted_count = 0;
+    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+      if (tile_group_header->IsDeletedSlot(tuple_id) == true) {
+        deleted_count++;
+      }
+    }
+    if (txn_manager.CommitTransaction(txn) != ResultType::SUCCESS) {
+      return 0;
+    }
+    return deleted_count;
+  }
+
+  size_t deleted_count = 0;
+  for (auto tuple_id : expired_tuples) {
+    // a newer version lives elsewhere, or a writer holds the tuple. it is
+    // tried again in the next pass.
+    if (tile_group_header->GetEndCommitId(tuple_id) != MAX_CID ||
+        txn_manager.IsOwnable(txn, tile_group_header, tuple_id) == false ||
+        txn_manager.AcquireOwnership(txn, tile_group_header, tuple_id) ==
+            false) {
+      continue;
+    }
+
+    ItemPointer new_location = table->InsertEmptyVersion();
+    if (new_location.IsNull() == true) {
+      txn_manager.YieldOwnership(txn, tile_group_header, tuple_id);
+      break;
+    }
+    txn_manager.PerformDelete(txn, ItemPointer(tile_group_id, tuple_id),
+                              new_location);
+    deleted_count++;
+  }
+
+  if (deleted_count == 0) {
+    txn_manager.AbortTransaction(txn);
+    return 0;
+  }
+  if (txn_manager.CommitTransaction(txn) != ResultType::SUCCESS) {
+    return 0;
+  }
+  return deleted_count;
+}
+
+}  // End storage namespace
+}  // End peloton namespace
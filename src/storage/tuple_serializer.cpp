@@ -0,0 +1,257 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_serializer.cpp
+//
+// Identification: src/storage/tuple_serializer.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/tuple_serializer.h"
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
+#include "type/value.h"
+#include "type/varlen_type.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// Fixed-width types whose serialized bytes are the ones they are stored as
+bool IsNativeFixedType(const type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+    case type::TypeId::TIMESTAMP:
+    case type::TypeId::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The length of the varlen value in a slot, PELOTON_VALUE_NULL for NULL,
+// and where its data is
+inline uint32_t ReadVarlen(const char *slot, const char *&data) {
+  if (type::VarlenType::IsInlineStorage(slot)) {
+    data = type::VarlenType::GetInlineData(slot);
+    return type::VarlenType::GetInlineLength(slot);
+  }
+  const char *ptr = *reinterpret_cast<const char *const *>(slot);
+  if (ptr == nullptr) {
+    data = nullptr;
+    return type::PELOTON_VALUE_NULL;
+  }
+  data = ptr + sizeof(uint32_t);
+  return *reinterpret_cast<const uint32_t *>(ptr);
+}
+
+// The bytes of the data written after the length, like VarlenType does
+inline uint32_t GetDataLength(const uint32_t len) {
+  return (len > 0 && len < type::PELOTON_VALUE_NULL) ? len : 0;
+}
+
+// The locations of a tuple in the tiles of a tile group, on the stack for
+// the usual few tiles
+class TileLocations {
+ public:
+  TileLocations(const TileGroup *tile_group, const oid_t tile_count)
+      : tile_group_(tile_group), tile_count_(tile_count) {
+    locations_ = stack_locations_;
+    if (tile_count_ > kStackTiles) {
+      heap_locations_.resize(tile_count_);
+      locations_ = heap_locations_.data();
+    }
+  }
+
+  const char *const *Locate(const oid_t tuple_offset) {
+    for (oid_t tile_itr = 0; tile_itr < tile_count_; tile_itr++) {
+      locations_[tile_itr] =
+          tile_group_->GetTile(tile_itr)->GetTupleLocation(tuple_offset);
+    }
+    return locations_;
+  }
+
+ private:
+  static const oid_t kStackTiles = 8;
+
+  const TileGroup *tile_group_;
+  oid_t tile_count_;
+  const char **locations_;
+  const char *stack_locations_[kStackTiles];
+  std::vector<const char *> heap_locations_;
+};
+
+}  // namespace
+
+TupleSerializer::TupleSerializer(const catalog::Schema &schema) {
+  for (oid_t column_id = 0; column_id < schema.GetColumnCount();
+       column_id++) {
+    AddColumn(schema, 0, column_id);
+  }
+}
+
+TupleSerializer::TupleSerializer(
+    const std::vector<catalog::Schema> &tile_schemas,
+    const column_map_type &column_map)
+    : tile_count_(tile_schemas.size()) {
+  for (auto &entry : column_map) {
+    auto tile_offset = entry.second.first;
+    AddColumn(tile_schemas[tile_offset], tile_offset, entry.second.second);
+  }
+}
+
+void TupleSerializer::AddColumn(const catalog::Schema &schema,
+                                const oid_t tile_offset,
+                                const oid_t column_id) {
+  auto type_id = schema.GetType(column_id);
+  bool is_inlined = schema.IsInlined(column_id);
+  size_t offset = schema.GetOffset(column_id);
+
+  if (is_inlined && IsNativeFixedType(type_id) &&
+      schema.GetLength(column_id) == type::Type::GetTypeSize(type_id)) {
+    size_t length = schema.GetLength(column_id);
+    fixed_size_ += length;
+
+    // Extend the run of the column before if this one comes right after it
+    if (segments_.empty() == false) {
+      auto &last = segments_.back();
+      if (last.type == SegmentType::FIXED && last.tile_offset == tile_offset &&
+          last.offset + last.length == offset) {
+        last.length += length;
+        return;
+      }
+    }
+    segments_.push_back(
+        {SegmentType::FIXED, tile_offset, offset, length, type_id, true});
+    return;
+  }
+
+  if (is_inlined == false && (type_id == type::TypeId::VARCHAR ||
+                              type_id == type::TypeId::VARBINARY)) {
+    segments_.push_back(
+        {SegmentType::VARLEN, tile_offset, offset, 0, type_id, false});
+    return;
+  }
+
+  segments_.push_back(
+      {SegmentType::VALUE, tile_offset, offset, 0, type_id, is_inlined});
+  is_native_ = false;
+}
+
+size_t TupleSerializer::GetSerializedSize(
+    const char *const *tile_locations) const {
+  size_t size = fixed_size_;
+  for (auto &segment : segments_) {
+    const char *column_location =
+        tile_locations[segment.tile_offset] + segment.offset;
+    switch (segment.type) {
+      case SegmentType::FIXED:
+        break;
+      case SegmentType::VARLEN: {
+        const char *data;
+        size += sizeof(int32_t) +
+                GetDataLength(ReadVarlen(column_location, data));
+        break;
+      }
+      case SegmentType::VALUE: {
+        CopySerializeOutput output;
+        type::Value::DeserializeFrom(column_location, segment.type_id,
+                                     segment.is_inlined)
+            .SerializeTo(output);
+        size += output.Size();
+        break;
+      }
+    }
+  }
+  return size;
+}
+
+void TupleSerializer::SerializeTo(const char *const *tile_locations,
+                                  SerializeOutput &output) const {
+  if (is_native_ == false) {
+    // The size of the Values is only known once they are written
+    for (auto &segment : segments_) {
+      const char *column_location =
+          tile_locations[segment.tile_offset] + segment.offset;
+      switch (segment.type) {
+        case SegmentType::FIXED:
+          output.WriteBytes(column_location, segment.length);
+          break;
+        case SegmentType::VARLEN: {
+          const char *data;
+          uint32_t len = ReadVarlen(column_location, data);
+          output.WriteInt(static_cast<int32_t>(len));
+          output.WriteBytes(data, GetDataLength(len));
+          break;
+        }
+        case SegmentType::VALUE:
+          type::Value::DeserializeFrom(column_location, segment.type_id,
+                                     segment.is_inlined)
+              .SerializeTo(output);
+          break;
+      }
+    }
+    return;
+  }
+
+  char *buffer = output.ReserveBuffer(GetSerializedSize(tile_locations));
+  for (auto &segment : segments_) {
+    const char *column_location =
+        tile_locations[segment.tile_offset] + segment.offset;
+    if (segment.type == SegmentType::FIXED) {
+      PL_MEMCPY(buffer, column_location, segment.length);
+      buffer += segment.length;
+      continue;
+    }
+
+    const char *data;
+    uint32_t len = ReadVarlen(column_location, data);
+    uint32_t data_length = GetDataLength(len);
+    int32_t serialized_len = static_cast<int32_t>(len);
+    PL_MEMCPY(buffer, &serialized_len, sizeof(int32_t));
+    buffer += sizeof(int32_t);
+    PL_MEMCPY(buffer, data, data_length);
+    buffer += data_length;
+  }
+}
+
+void TupleSerializer::SerializeTo(const Tuple &tuple,
+                                  SerializeOutput &output) const {
+  PL_ASSERT(tile_count_ == 1);
+  const char *location = tuple.GetData();
+  SerializeTo(&location, output);
+}
+
+void TupleSerializer::SerializeTo(const TileGroup *tile_group,
+                                  const oid_t tuple_offset,
+                                  SerializeOutput &output) const {
+  PL_ASSERT(tile_group->GetTileCount() == tile_count_);
+  TileLocations locations(tile_group, tile_count_);
+  SerializeTo(locations.Locate(tuple_offset), output);
+}
+
+void TupleSerializer::SerializeRangeTo(const TileGroup *tile_group,
+                                       const oid_t begin, const oid_t end,
+                                       SerializeOutput &output) const {
+  PL_ASSERT(tile_group->GetTileCount() == tile_count_);
+  TileLocations locations(tile_group, tile_count_);
+  for (oid_t tuple_offset = begin; tuple_offset < end; tuple_offset++) {
+    SerializeTo(locations.Locate(tuple_offset), output);
+  }
+}
+
+}  // namespace storage
+}  // namespace peloton
@@ -0,0 +1,431 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map.cpp
+//
+// Identification: src/storage/zone_map.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/zone_map.h"
+
+#include <sstream>
+
+#include "common/macros.h"
+#include "executor/executor_context.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/parameter_value_expression.h"
+#include "expression/tuple_value_expression.h"
+
+namespace peloton {
+namespace storage {
+
+namespace {
+
+// Types whose values have a total order we can keep min/max bounds on
+bool IsOrderedType(const type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+    case type::TypeId::TIMESTAMP:
+    case type::TypeId::DATE:
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsNumericType(const type::TypeId type_id) {
+  switch (type_id) {
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Mirror the comparison so that the column is on the left hand side
+ExpressionType FlipComparison(const ExpressionType comparison_type) {
+  switch (comparison_type) {
+    case ExpressionType::COMPARE_LESSTHAN:
+      return ExpressionType::COMPARE_GREATERTHAN;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return ExpressionType::COMPARE_LESSTHAN;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return ExpressionType::COMPARE_GREATERTHANOREQUALTO;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return ExpressionType::COMPARE_LESSTHANOREQUALTO;
+    default:
+      return comparison_type;
+  }
+}
+
+// Try to get the value of a constant or parameter expression
+bool GetConstantValue(const expression::AbstractExpression *expression,
+                      executor::ExecutorContext *executor_context,
+                      type::Value &value) {
+  switch (expression->GetExpressionType()) {
+    case ExpressionType::VALUE_CONSTANT:
+      value = static_cast<const expression::ConstantValueExpression *>(
+                  expression)->GetValue();
+      return true;
+    case ExpressionType::VALUE_PARAMETER: {
+      if (executor_context == nullptr) {
+        return false;
+      }
+      auto value_idx =
+          static_cast<const expression::ParameterValueExpression *>(
+              expression)->GetValueIdx();
+      auto &params = executor_context->GetParams();
+      if (value_idx < 0 || static_cast<size_t>(value_idx) >= params.size()) {
+        return false;
+      }
+      value = params[value_idx];
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// INVALID-typed values can't be copied by the type system
+type::Value CopyValue(const type::Value &value) {
+  if (value.GetTypeId() == type::TypeId::INVALID) {
+    return type::Value();
+  }
+  return value.Copy();
+}
+
+}  // anonymous namespace
+
+ZoneMap::ZoneMap(const oid_t column_count)
+    : column_count_(column_count),
+      min_values_(column_count),
+      max_values_(column_count),
+      null_counts_(column_count, 0) {}
+
+void ZoneMap::Widen(const oid_t column_id, const type::Value &value) {
+  PL_ASSERT(column_id < column_count_);
+
+  zone_map_lock_.Lock();
+
+  if (value.IsNull() == true) {
+    null_counts_[column_id]++;
+  } else if (IsOrderedType(value.GetTypeId()) == true) {
+    auto &min_value = min_values_[column_id];
+    auto &max_value = max_values_[column_id];
+
+    if (min_value.GetTypeId() == type::TypeId::INVALID) {
+      min_value = value.Copy();
+      max_value = value.Copy();
+    } else if (value.CompareLessThan(min_value) == type::CmpBool::CMP_TRUE) {
+      min_value = value.Copy();
+    } else if (value.CompareGreaterThan(max_value) ==
+               type::CmpBool::CMP_TRUE) {
+      max_value = value.Copy();
+    }
+  }
+
+  zone_map_lock_.Unlock();
+}
+
+void ZoneMap::Merge(const ZoneMap &other) {
+  PL_ASSERT(other.column_count_ == column_count_);
+
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    auto min_value = other.GetMinValue(column_id);
+    auto max_value = other.GetMaxValue(column_id);
+    auto null_count = other.GetNullCount(column_id);
+
+    if (min_value.GetTypeId() != type::TypeId::INVALID) {
+      Widen(column_id, min_value);
+      Widen(column_id, max_value);
+    }
+
+    AddNullCount(column_id, null_count);
+  }
+}
+
+void ZoneMap::AddNullCount(const oid_t column_id, const size_t null_count) {
+  PL_ASSERT(column_id < column_count_);
+
+  zone_map_lock_.Lock();
+  null_counts_[column_id] += null_count;
+  zone_map_lock_.Unlock();
+}
+
+type::Value ZoneMap::GetMinValue(const oid_t column_id) const {
+  PL_ASSERT(column_id < column_count_);
+
+  zone_map_lock_.Lock();
+  auto min_value = CopyValue(min_values_[column_id]);
+  zone_map_lock_.Unlock();
+
+  return min_value;
+}
+
+type::Value ZoneMap::GetMaxValue(const oid_t column_id) const {
+  PL_ASSERT(column_id < column_count_);
+
+  zone_map_lock_.Lock();
+  auto max_value = CopyValue(max_values_[column_id]);
+  zone_map_lock_.Unlock();
+
+  return max_value;
+}
+
+size_t ZoneMap::GetNullCount(const oid_t column_id) const {
+  PL_ASSERT(column_id < column_count_);
+
+  zone_map_lock_.Lock();
+  auto null_count = null_counts_[column_id];
+  zone_map_lock_.Unlock();
+
+  return null_count;
+}
+
+bool ZoneMap::HasNulls() const {
+  bool has_nulls = false;
+
+  zone_map_lock_.Lock();
+  for (auto null_count : null_counts_) {
+    if (null_count > 0) {
+      has_nulls = true;
+      break;
+    }
+  }
+  zone_map_lock_.Unlock();
+
+  return has_nulls;
+}
+
+bool ZoneMap::CanSatisfy(const expression::AbstractExpression *predicate,
+                         executor::ExecutorContext *executor_context) const {
+  if (predicate == nullptr) {
+    return true;
+  }
+
+  auto expression_type = predicate->GetExpressionType();
+  switch (expression_type) {
+    case ExpressionType::CONJUNCTION_AND:
+      return CanSatisfy(predicate->GetChild(0), executor_context) &&
+             CanSatisfy(predicate->GetChild(1), executor_context);
+    case ExpressionType::CONJUNCTION_OR:
+      return CanSatisfy(predicate->GetChild(0), executor_context) ||
+             CanSatisfy(predicate->GetChild(1), executor_context);
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      // We can't reason about this predicate
+      return true;
+  }
+
+  oid_t column_id;
+  type::Value value;
+  if (GetColumnComparison(predicate, executor_context, expression_type,
+                          column_id, value) == false ||
+      column_id >= column_count_) {
+    return true;
+  }
+
+  return CanSatisfyComparison(expression_type, column_id, value);
+}
+
+bool ZoneMap::SatisfiesAll(const expression::AbstractExpression *predicate,
+                           executor::ExecutorContext *executor_context) const {
+  if (predicate == nullptr) {
+    return true;
+  }
+
+  auto expression_type = predicate->GetExpressionType();
+  switch (expression_type) {
+    case ExpressionType::CONJUNCTION_AND:
+      return SatisfiesAll(predicate->GetChild(0), executor_context) &&
+             SatisfiesAll(predicate->GetChild(1), executor_context);
+    case ExpressionType::CONJUNCTION_OR:
+      return SatisfiesAll(predicate->GetChild(0), executor_context) ||
+             SatisfiesAll(predicate->GetChild(1), executor_context);
+    case ExpressionType::COMPARE_EQUAL:
+    case ExpressionType::COMPARE_NOTEQUAL:
+    case ExpressionType::COMPARE_LESSTHAN:
+    case ExpressionType::COMPARE_GREATERTHAN:
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      break;
+    default:
+      // We can't reason about this predicate
+      return false;
+  }
+
+  oid_t column_id;
+  type::Value value;
+  if (GetColumnComparison(predicate, executor_context, expression_type,
+                          column_id, value) == false ||
+      column_id >= column_count_) {
+    return false;
+  }
+
+  return SatisfiesAllComparison(expression_type, column_id, value);
+}
+
+bool ZoneMap::GetColumnComparison(
+    const expression::AbstractExpression *predicate,
+    executor::ExecutorContext *executor_context,
+    ExpressionType &comparison_type, oid_t &column_id, type::Value &value) {
+  auto left = predicate->GetChild(0);
+  auto right = predicate->GetChild(1);
+  if (left == nullptr || right == nullptr) {
+    return false;
+  }
+
+  comparison_type = predicate->GetExpressionType();
+  const expression::TupleValueExpression *column = nullptr;
+  if (left->GetExpressionType() == ExpressionType::VALUE_TUPLE &&
+      GetConstantValue(right, executor_context, value) == true) {
+    column = static_cast<const expression::TupleValueExpression *>(left);
+  } else if (right->GetExpressionType() == ExpressionType::VALUE_TUPLE &&
+             GetConstantValue(left, executor_context, value) == true) {
+    column = static_cast<const expression::TupleValueExpression *>(right);
+    comparison_type = FlipComparison(comparison_type);
+  } else {
+    return false;
+  }
+
+  // Only predicates on the scanned tuple
+  if (column->GetTupleId() != 0 || column->GetColumnId() < 0) {
+    return false;
+  }
+  column_id = column->GetColumnId();
+  return true;
+}
+
+bool ZoneMap::CanSatisfyComparison(const ExpressionType comparison_type,
+                                   const oid_t column_id,
+                                   const type::Value &value) const {
+  // Comparisons with NULL are never true
+  if (value.IsNull() == true) {
+    return false;
+  }
+
+  auto min_value = GetMinValue(column_id);
+  auto max_value = GetMaxValue(column_id);
+
+  // No non-null value was ever written into this column
+  if (min_value.GetTypeId() == type::TypeId::INVALID) {
+    return false;
+  }
+
+  // Stay away from comparisons that need implicit casts (e.g. from VARCHAR)
+  if (min_value.GetTypeId() != value.GetTypeId() &&
+      (IsNumericType(min_value.GetTypeId()) == false ||
+       IsNumericType(value.GetTypeId()) == false)) {
+    return true;
+  }
+
+  switch (comparison_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return min_value.CompareLessThanEquals(value) ==
+                 type::CmpBool::CMP_TRUE &&
+             max_value.CompareGreaterThanEquals(value) ==
+                 type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return min_value.CompareNotEquals(value) == type::CmpBool::CMP_TRUE ||
+             max_value.CompareNotEquals(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHAN:
+      return min_value.CompareLessThan(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return min_value.CompareLessThanEquals(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return max_value.CompareGreaterThan(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return max_value.CompareGreaterThanEquals(value) ==
+             type::CmpBool::CMP_TRUE;
+    default:
+      return true;
+  }
+}
+
+bool ZoneMap::SatisfiesAllComparison(const ExpressionType comparison_type,
+                                     const oid_t column_id,
+                                     const type::Value &value) const {
+  // Comparisons with NULL are never true
+  if (value.IsNull() == true || GetNullCount(column_id) > 0) {
+    return false;
+  }
+
+  auto min_value = GetMinValue(column_id);
+  auto max_value = GetMaxValue(column_id);
+
+  // No non-null value was ever written into this column
+  if (min_value.GetTypeId() == type::TypeId::INVALID) {
+    return false;
+  }
+
+  // Stay away from comparisons that need implicit casts (e.g. from VARCHAR)
+  if (min_value.GetTypeId() != value.GetTypeId() &&
+      (IsNumericType(min_value.GetTypeId()) == false ||
+       IsNumericType(value.GetTypeId()) == false)) {
+    return false;
+  }
+
+  switch (comparison_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return min_value.CompareEquals(value) == type::CmpBool::CMP_TRUE &&
+             max_value.CompareEquals(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return max_value.CompareLessThan(value) == type::CmpBool::CMP_TRUE ||
+             min_value.CompareGreaterThan(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHAN:
+      return max_value.CompareLessThan(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return max_value.CompareLessThanEquals(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return min_value.CompareGreaterThan(value) == type::CmpBool::CMP_TRUE;
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return min_value.CompareGreaterThanEquals(value) ==
+             type::CmpBool::CMP_TRUE;
+    default:
+      return false;
+  }
+}
+
+const std::string ZoneMap::GetInfo() const {
+  std::ostringstream os;
+
+  os << "ZONE MAP :: ";
+  for (oid_t column_id = 0; column_id < column_count_; column_id++) {
+    auto min_value = GetMinValue(column_id);
+    os << "[" << column_id << ": ";
+    if (min_value.GetTypeId() == type::TypeId::INVALID) {
+      os << "empty";
+    } else {
+      os << min_value.ToString() << " - "
+         << GetMaxValue(column_id).ToString();
+    }
+    os << ", nulls: " << GetNullCount(column_id) << "] ";
+  }
+
+  return os.str();
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// procedure_manager.cpp
+//
+// Identification: src/tcop/procedure_manager.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "tcop/procedure_manager.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include <boost/algorithm/string.hpp>
+
+#include "common/statement.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace tcop {
+
+ProcedureManager &ProcedureManager::GetInstance() {
+  static ProcedureManager procedure_manager;
+  return procedure_manager;
+}
+
+void ProcedureManager::CreateProcedure(
+    std::shared_ptr<const Procedure> procedure) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &entry = procedures_[StringUtil::Lower(procedure->name)];
+  entry.procedure = std::move(procedure);
+  entry.prepared.clear();
+}
+
+bool ProcedureManager::DropProcedure(const std::string &name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return procedures_.erase(StringUtil::Lower(name)) > 0;
+}
+
+std::shared_ptr<const Procedure> ProcedureManager::GetProcedure(
+    const std::string &name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = procedures_.find(StringUtil::Lower(name));
+  return entry != procedures_.end() ? entry->second.procedure : nullptr;
+}
+
+std::unique_ptr<PreparedProcedure> ProcedureManager::Acquire(
+    const std::string &name, uint64_t catalog_version) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = procedures_.find(StringUtil::Lower(name));
+  if (entry == procedures_.end()) {
+    return nullptr;
+  }
+  auto &prepared = entry->second.prepared;
+  while (prepared.empty() == false) {
+    auto statements = std::move(prepared.back());
+    prepared.pop_back();
+    if (statements->catalog_version == catalog_version) {
+      return statements;
+    }
+  }
+  return nullptr;
+}
+
+void ProcedureManager::Release(std::unique_ptr<PreparedProcedure> prepared) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // The statements of a procedure that was replaced or dropped are not kept
+  auto entry = procedures_.find(StringUtil::Lower(prepared->procedure->name));
+  if (entry == procedures_.end() ||
+      entry->second.procedure != prepared->procedure ||
+      entry->second.prepared.size() >= kMaxPreparedPerProcedure) {
+    return;
+  }
+  entry->second.prepared.push_back(std::move(prepared));
+}
+
+void ProcedureManager::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  procedures_.clear();
+}
+
+size_t ProcedureManager::GetCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return procedures_.size();
+}
+
+std::vector<std::string> ProcedureManager::SplitQueries(
+    const std::string &body, size_t &parameter_count) {
+  std::vector<std::string> queries;
+  std::string query;
+  char quote = '\0';
+  parameter_count = 0;
+  for (size_t char_itr = 0; char_itr < body.size(); char_itr++) {
+    char c = body[char_itr];
+    if (quote != '\0') {
+      quote = c == quote ? '\0' : quote;
+    } else if (c == '\'' || c == '"') {
+      quote = c;
+    } else if (c == ';') {
+      boost::trim(query);
+      if (query.empty() == false) {
+        queries.push_back(std::move(query));
+      }
+      query.clear();
+      continue;
+    } else if (c == '$' && char_itr + 1 < body.size() &&
+               std::isdigit(body[char_itr + 1])) {
+      size_t parameter = std::strtoul(body.c_str() + char_itr + 1, nullptr, 10);
+      parameter_count = std::max(parameter_count, parameter);
+    }
+    query += c;
+  }
+  boost::trim(query);
+  if (query.empty() == false) {
+    queries.push_back(std::move(query));
+  }
+  return queries;
+}
+
+}  // End tcop namespace
+}  // End peloton namespace
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// result_cache.cpp
+//
+// Identification: src/tcop/result_cache.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "tcop/result_cache.h"
+
+#include <algorithm>
+
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "concurrency/transaction.h"
+#include "configuration/configuration.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace tcop {
+
+ResultCache &ResultCache::GetInstance() {
+  static ResultCache result_cache;
+  return result_cache;
+}
+
+ResultCache::ResultCache()
+    : cache_(std::max<size_t>(FLAGS_result_cache_size, 1), kShardCount),
+      hit_count_(0) {
+  for (auto &version : table_versions_) {
+    version = 0;
+  }
+}
+
+std::string ResultCache::GetKey(const std::string &query,
+                                const std::vector<type::Value> &params) {
+  // The type and the length keep apart values that print the same
+  std::string key = query;
+  for (auto &param : params) {
+    std::string value = param.IsNull() ? "" : param.ToString();
+    key += '\0';
+    key += std::to_string(static_cast<int>(param.GetTypeId()));
+    key += param.IsNull() ? 'n' : ':';
+    key += std::to_string(value.size());
+    key += ':';
+    key += value;
+  }
+  return key;
+}
+
+std::shared_ptr<CachedResult> ResultCache::Find(const std::string &key,
+                                                uint64_t catalog_version) {
+  auto result = cache_.Find(key);
+  if (result == nullptr) {
+    return nullptr;
+  }
+
+  bool is_current = (result->catalog_version == catalog_version);
+  for (auto &table_version : result->table_versions) {
+    if (is_current == false) {
+      break;
+    }
+    is_current = (GetVersionSlot(table_version.first).load() ==
+                  table_version.second);
+  }
+  if (is_current == false) {
+    LOG_TRACE("Dropped a stale result");
+    cache_.Erase(key, result);
+    return nullptr;
+  }
+
+  hit_count_++;
+  return result;
+}
+
+void ResultCache::Insert(const std::string &key,
+                         std::shared_ptr<CachedResult> result) {
+  size_t row_count = result->rows.size();
+  if (row_count > GetMaxResultRows()) {
+    return;
+  }
+  cache_.Insert(key, std::move(result), row_count + 1);
+}
+
+std::vector<std::pair<oid_t, uint64_t>> ResultCache::GetTableVersions(
+    const std::set<oid_t> &table_oids) const {
+  std::vector<std::pair<oid_t, uint64_t>> versions;
+  for (auto table_oid : table_oids) {
+    versions.emplace_back(
+        table_oid, table_versions_[table_oid % kVersionSlotCount].load());
+  }
+  return versions;
+}
+
+void ResultCache::RecordCommit(concurrency::Transaction *txn) {
+  // The entries of a tile group mostly follow each other
+  auto &manager = catalog::Manager::GetInstance();
+  std::vector<oid_t> table_oids;
+  oid_t last_block = INVALID_OID;
+  auto add_block = [&](oid_t block) {
+    if (block == last_block) {
+      return;
+    }
+    last_block = block;
+    auto tile_group = manager.ResolveTileGroup(block);
+    if (tile_group == nullptr) {
+      return;
+    }
+    oid_t table_oid = tile_group->GetTableId();
+    if (std::find(table_oids.begin(), table_oids.end(), table_oid) ==
+        table_oids.end()) {
+      table_oids.push_back(table_oid);
+    }
+  };
+
+  for (auto &rw_entry : txn->GetReadWriteSet()) {
+    if (rw_entry.type != RWType::READ && rw_entry.type != RWType::READ_OWN) {
+      add_block(rw_entry.location.block);
+    }
+  }
+  for (auto &bulk_entry : txn->GetBulkInsertSet()) {
+    add_block(bulk_entry.first);
+  }
+  for (auto tile_group_id : txn->GetDeletedTileGroupSet()) {
+    add_block(tile_group_id);
+  }
+  for (auto &undo_record : txn->GetUndoBuffer()) {
+    add_block(undo_record.location.block);
+  }
+
+  for (auto table_oid : table_oids) {
+    BumpTableVersion(table_oid);
+  }
+}
+
+void ResultCache::BumpTableVersion(oid_t table_oid) {
+  GetVersionSlot(table_oid)++;
+}
+
+void ResultCache::Clear() { cache_.Clear(); }
+
+size_t ResultCache::GetCount() const { return cache_.GetSize(); }
+
+}  // namespace tcop
+}  // namespace peloton
@@ -0,0 +1,952 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_router.cpp
+//
+// Identification: src/tcop/shard_router.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "tcop/shard_router.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+
+#include "catalog/catalog.h"
+#include "catalog/schema.h"
+#include "catalog/shard_map.h"
+#include "common/exception.h"
+#include "common/logger.h"
+#include "expression/abstract_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "networking/shard_client.h"
+#include "parser/postgresparser.h"
+#include "parser/statements.h"
+#include "peloton/proto/shard_service.pb.h"
+#include "storage/data_table.h"
+#include "tcop/tcop.h"
+#include "type/value_factory.h"
+#include "util/string_util.h"
+
+namespace peloton {
+namespace tcop {
+
+namespace {
+
+// The distributed transactions this node coordinates. The node is in the
+// highest bits of their ids to keep them apart from those of other nodes.
+std::atomic<int64_t> next_transaction_id(1);
+
+// How the values of a column of the rows of several shards merge
+enum class ColumnMerge { GROUP, ADD, MIN, MAX };
+
+std::string GetAlias(const parser::TableRef *table_ref) {
+  return table_ref->alias != nullptr ? StringUtil::Lower(table_ref->alias)
+                                     : std::string();
+}
+
+// The key a conjunct of the predicate selects for the table, if any
+bool FindKey(const expression::AbstractExpression *predicate,
+             const catalog::ShardedTable &table, const std::string &alias,
+             type::Value &key) {
+  if (predicate == nullptr) {
+    return false;
+  }
+  if (predicate->GetExpressionType() == ExpressionType::CONJUNCTION_AND) {
+    return FindKey(predicate->GetChild(0), table, alias, key) ||
+           FindKey(predicate->GetChild(1), table, alias, key);
+  }
+  if (predicate->GetExpressionType() != ExpressionType::COMPARE_EQUAL) {
+    return false;
+  }
+
+  for (int child_itr = 0; child_itr < 2; child_itr++) {
+    auto column = predicate->GetChild(child_itr);
+    auto constant = predicate->GetChild(1 - child_itr);
+    if (column->GetExpressionType() != ExpressionType::VALUE_TUPLE ||
+        constant->GetExpressionType() != ExpressionType::VALUE_CONSTANT) {
+      continue;
+    }
+    auto tuple_value =
+        static_cast<const expression::TupleValueExpression *>(column);
+    auto column_table = StringUtil::Lower(tuple_value->GetTableName());
+    if (StringUtil::Lower(tuple_value->GetColumnName()) != table.key_column ||
+        (column_table.empty() == false && column_table != table.table_name &&
+         column_table != alias)) {
+      continue;
+    }
+    auto value =
+        static_cast<const expression::ConstantValueExpression *>(constant)
+            ->GetValue();
+    if (value.IsNull() == false) {
+      key = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Route to the shard of the key the predicates select, or to every shard
+void RouteByKey(
+    const catalog::ShardedTable &table, const std::string &alias,
+    const std::vector<const expression::AbstractExpression *> &predicates,
+    ShardTarget &target) {
+  type::Value key;
+  for (auto predicate : predicates) {
+    if (FindKey(predicate, table, alias, key)) {
+      target.type = ShardTargetType::SINGLE;
+      target.node_id = catalog::ShardMap::GetInstance().GetShard(table, key);
+      return;
+    }
+  }
+  target.type = ShardTargetType::ALL;
+}
+
+// Collect the tables, the subqueries and the join conditions of the FROM
+// clause
+void CollectTables(
+    const parser::TableRef *table_ref,
+    std::vector<const parser::TableRef *> &tables,
+    std::vector<const parser::SelectStatement *> &subqueries,
+    std::vector<const expression::AbstractExpression *> &predicates) {
+  if (table_ref == nullptr) {
+    return;
+  }
+  switch (table_ref->type) {
+    case TableReferenceType::NAME:
+      tables.push_back(table_ref);
+      break;
+    case TableReferenceType::SELECT:
+      subqueries.push_back(table_ref->select);
+      break;
+    case TableReferenceType::JOIN:
+      predicates.push_back(table_ref->join->condition);
+      CollectTables(table_ref->join->left, tables, subqueries, predicates);
+      CollectTables(table_ref->join->right, tables, subqueries, predicates);
+      break;
+    case TableReferenceType::CROSS_PRODUCT:
+      for (auto list_ref : *table_ref->list) {
+        CollectTables(list_ref, tables, subqueries, predicates);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+bool GetSelectTarget(const parser::SelectStatement &select,
+                     ShardTarget &target, std::string &error_message) {
+  auto &shard_map = catalog::ShardMap::GetInstance();
+  std::vector<const parser::TableRef *> tables;
+  std::vector<const parser::SelectStatement *> subqueries;
+  std::vector<const expression::AbstractExpression *> predicates{
+      select.where_clause};
+  CollectTables(select.from_table, tables, subqueries, predicates);
+  if (select.union_select != nullptr) {
+    subqueries.push_back(select.union_select);
+  }
+
+  // The subqueries have to run on this node
+  for (auto subquery : subqueries) {
+    ShardTarget subquery_target;
+    if (GetSelectTarget(*subquery, subquery_target, error_message) == false) {
+      return false;
+    }
+    if (subquery_target.type != ShardTargetType::LOCAL) {
+      error_message = "subqueries over sharded tables are not supported";
+      return false;
+    }
+  }
+
+  std::vector<const parser::TableRef *> sharded_tables;
+  for (auto table_ref : tables) {
+    if (shard_map.GetTable(table_ref->GetTableName()) != nullptr) {
+      sharded_tables.push_back(table_ref);
+    }
+  }
+  if (sharded_tables.empty()) {
+    return true;
+  }
+  if (tables.size() == 1) {
+    RouteByKey(*shard_map.GetTable(tables[0]->GetTableName()),
+               GetAlias(tables[0]), predicates, target);
+    return true;
+  }
+
+  // A join runs on the one shard that has the rows of all its sharded tables
+  for (auto table_ref : sharded_tables) {
+    ShardTarget table_target;
+    RouteByKey(*shard_map.GetTable(table_ref->GetTableName()),
+               GetAlias(table_ref), predicates, table_target);
+    if (table_target.type != ShardTargetType::SINGLE) {
+      error_message = StringUtil::Format(
+          "a join of the sharded table %s has to select its shard key",
+          table_ref->GetTableName());
+      return false;
+    }
+    if (target.type == ShardTargetType::SINGLE &&
+        target.node_id != table_target.node_id) {
+      error_message = "a join of the rows of several shards is not supported";
+      return false;
+    }
+    target = table_target;
+  }
+  return true;
+}
+
+bool HasAggregate(const expression::AbstractExpression *expr) {
+  if (expr == nullptr) {
+    return false;
+  }
+  switch (expr->GetExpressionType()) {
+    case ExpressionType::AGGREGATE_COUNT:
+    case ExpressionType::AGGREGATE_COUNT_STAR:
+    case ExpressionType::AGGREGATE_SUM:
+    case ExpressionType::AGGREGATE_MIN:
+    case ExpressionType::AGGREGATE_MAX:
+    case ExpressionType::AGGREGATE_AVG:
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT:
+      return true;
+    default:
+      break;
+  }
+  for (size_t child_itr = 0; child_itr < expr->GetChildrenSize();
+       child_itr++) {
+    if (HasAggregate(expr->GetChild(child_itr))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The value of the text of a column of the given type, NULL if it is empty
+type::Value ParseValue(const std::string &text, const FieldInfo &column) {
+  auto type_id = type::TypeId::VARCHAR;
+  try {
+    type_id = PostgresValueTypeToPelotonValueType(
+        static_cast<PostgresValueType>(std::get<1>(column)));
+  } catch (ConversionException &e) {
+    LOG_TRACE("Compare column %s as text", std::get<0>(column).c_str());
+  }
+  if (type_id == type::TypeId::VARCHAR) {
+    return type::ValueFactory::GetVarcharValue(text);
+  }
+  if (text.empty()) {
+    return type::ValueFactory::GetNullValueByType(type_id);
+  }
+  return type::ValueFactory::GetVarcharValue(text).CastAs(type_id);
+}
+
+std::string MergeValue(const ColumnMerge merge, const std::string &left,
+                       const std::string &right, const FieldInfo &column) {
+  if (left.empty()) {
+    return right;
+  }
+  if (right.empty()) {
+    return left;
+  }
+
+  // The sums of a column of any numeric type are added as text
+  if (merge == ColumnMerge::ADD) {
+    bool is_decimal = left.find_first_of(".eE") != std::string::npos ||
+                      right.find_first_of(".eE") != std::string::npos;
+    auto type_id = is_decimal ? type::TypeId::DECIMAL : type::TypeId::BIGINT;
+    auto left_value = type::ValueFactory::GetVarcharValue(left).CastAs(type_id);
+    auto right_value =
+        type::ValueFactory::GetVarcharValue(right).CastAs(type_id);
+    return left_value.Add(right_value).ToString();
+  }
+
+  bool is_less = ParseValue(left, column)
+                     .CompareLessThan(ParseValue(right, column)) ==
+                 type::CMP_TRUE;
+  if (merge == ColumnMerge::MIN) {
+    return is_less ? left : right;
+  }
+  return is_less ? right : left;
+}
+
+// The column of the result an ORDER BY expression sorts by, the number of
+// columns if none
+size_t FindColumn(const parser::SelectStatement &select,
+                  const std::vector<FieldInfo> &columns,
+                  expression::AbstractExpression *expr) {
+  if (expr->GetExpressionType() == ExpressionType::VALUE_CONSTANT) {
+    auto position =
+        static_cast<expression::ConstantValueExpression *>(expr)->GetValue();
+    if (position.CheckInteger()) {
+      auto column = position.CastAs(type::TypeId::BIGINT).GetAs<int64_t>();
+      return column >= 1 && static_cast<size_t>(column) <= columns.size()
+                 ? column - 1
+                 : columns.size();
+    }
+  }
+
+  auto &select_list = *select.select_list;
+  bool has_star = std::any_of(
+      select_list.begin(), select_list.end(),
+      [](expression::AbstractExpression *select_expr) {
+        return select_expr->GetExpressionType() == ExpressionType::STAR;
+      });
+  if (has_star == false) {
+    for (size_t column = 0;
+         column < select_list.size() && column < columns.size(); column++) {
+      if (select_list[column]->Equals(expr)) {
+        return column;
+      }
+    }
+  }
+  if (expr->GetExpressionType() == ExpressionType::VALUE_TUPLE) {
+    auto name = StringUtil::Lower(
+        static_cast<expression::TupleValueExpression *>(expr)
+            ->GetColumnName());
+    for (size_t column = 0; column < columns.size(); column++) {
+      if (StringUtil::Lower(std::get<0>(columns[column])) == name) {
+        return column;
+      }
+    }
+  }
+  return columns.size();
+}
+
+}  // namespace
+
+ShardRouter::ShardRouter(TrafficCop &traffic_cop) : traffic_cop_(traffic_cop) {}
+
+ShardRouter::~ShardRouter() {
+  if (participants_.empty() == false) {
+    FinishTransaction(false);
+  }
+}
+
+bool ShardRouter::GetTarget(parser::SQLStatement *statement,
+                            ShardTarget &target, std::string &error_message) {
+  auto &shard_map = catalog::ShardMap::GetInstance();
+  target = ShardTarget();
+  switch (statement->GetType()) {
+    case StatementType::SELECT:
+      return GetSelectTarget(*(parser::SelectStatement *)statement, target,
+                             error_message);
+
+    case StatementType::INSERT: {
+      auto insert_stmt = (parser::InsertStatement *)statement;
+      auto table = shard_map.GetTable(insert_stmt->GetTableName());
+      if (insert_stmt->select != nullptr) {
+        ShardTarget select_target;
+        if (GetSelectTarget(*insert_stmt->select, select_target,
+                            error_message) == false) {
+          return false;
+        }
+        if (table != nullptr ||
+            select_target.type != ShardTargetType::LOCAL) {
+          error_message = "INSERT ... SELECT over sharded tables is not "
+                          "supported";
+          return false;
+        }
+        return true;
+      }
+      if (table == nullptr) {
+        return true;
+      }
+
+      // Every row has to go to the same shard
+      size_t key_index;
+      if (insert_stmt->columns == nullptr) {
+        auto data_table = catalog::Catalog::GetInstance()->GetTableWithName(
+            insert_stmt->GetDatabaseName(), insert_stmt->GetTableName());
+        key_index = data_table->GetSchema()->GetColumnID(table->key_column);
+      } else {
+        auto &columns = *insert_stmt->columns;
+        key_index = std::find_if(columns.begin(), columns.end(),
+                                 [&table](char *column) {
+                                   return StringUtil::Lower(column) ==
+                                          table->key_column;
+                                 }) -
+                    columns.begin();
+      }
+      target.is_write = true;
+      for (auto tuple : *insert_stmt->insert_values) {
+        auto expr = key_index < tuple->size() ? (*tuple)[key_index] : nullptr;
+        if (expr == nullptr ||
+            expr->GetExpressionType() != ExpressionType::VALUE_CONSTANT ||
+            static_cast<expression::ConstantValueExpression *>(expr)
+                ->GetValue()
+                .IsNull()) {
+          error_message = StringUtil::Format(
+              "the shard key of the rows inserted into %s has to be a "
+              "constant",
+              insert_stmt->GetTableName().c_str());
+          return false;
+        }
+        auto node_id = shard_map.GetShard(
+            *table,
+            static_cast<expression::ConstantValueExpression *>(expr)
+                ->GetValue());
+        if (target.type == ShardTargetType::SINGLE &&
+            target.node_id != node_id) {
+          error_message = StringUtil::Format(
+              "the rows inserted into %s belong to several shards",
+              insert_stmt->GetTableName().c_str());
+          return false;
+        }
+        target.type = ShardTargetType::SINGLE;
+        target.node_id = node_id;
+      }
+      return true;
+    }
+
+    case StatementType::UPDATE: {
+      auto update_stmt = (parser::UpdateStatement *)statement;
+      auto table = shard_map.GetTable(update_stmt->table->GetTableName());
+      if (table == nullptr) {
+        return true;
+      }
+      for (auto clause : *update_stmt->updates) {
+        if (StringUtil::Lower(clause->column) == table->key_column) {
+          error_message = StringUtil::Format(
+              "the shard key %s of %s cannot be updated",
+              table->key_column.c_str(), table->table_name.c_str());
+          return false;
+        }
+      }
+      target.is_write = true;
+      RouteByKey(*table, GetAlias(update_stmt->table), {update_stmt->where},
+                 target);
+      return true;
+    }
+
+    case StatementType::DELETE: {
+      auto delete_stmt = (parser::DeleteStatement *)statement;
+      auto table = shard_map.GetTable(delete_stmt->GetTableName());
+      if (table == nullptr) {
+        return true;
+      }
+      target.is_write = true;
+      RouteByKey(*table, GetAlias(delete_stmt->table_ref), {delete_stmt->expr},
+                 target);
+      return true;
+    }
+
+    // The tables and indexes of a sharded table are on every node
+    case StatementType::CREATE: {
+      auto create_stmt = (parser::CreateStatement *)statement;
+      if ((create_stmt->type == parser::CreateStatement::kTable ||
+           create_stmt->type == parser::CreateStatement::kIndex) &&
+          create_stmt->table_info_ != nullptr &&
+          shard_map.GetTable(create_stmt->GetTableName()) != nullptr) {
+        target.type = ShardTargetType::ALL;
+        target.is_write = true;
+      }
+      return true;
+    }
+
+    case StatementType::DROP: {
+      auto drop_stmt = (parser::DropStatement *)statement;
+      if (drop_stmt->type == parser::DropStatement::kTable &&
+          drop_stmt->table_info_ != nullptr &&
+          shard_map.GetTable(drop_stmt->GetTableName()) != nullptr) {
+        target.type = ShardTargetType::ALL;
+        target.is_write = true;
+      }
+      return true;
+    }
+
+    case StatementType::COPY: {
+      auto copy_stmt = (parser::CopyStatement *)statement;
+      if (copy_stmt->cpy_table != nullptr &&
+          shard_map.GetTable(copy_stmt->cpy_table->GetTableName()) !=
+              nullptr) {
+        error_message = StringUtil::Format(
+            "COPY of the sharded table %s is not supported",
+            copy_stmt->cpy_table->GetTableName());
+        return false;
+      }
+      return true;
+    }
+
+    default:
+      return true;
+  }
+}
+
+bool ShardRouter::MergeResults(const parser::SelectStatement &select,
+                               const std::vector<ShardResult> &shard_results,
+                               ShardResult &merged,
+                               std::string &error_message) {
+  merged = ShardResult();
+  if (shard_results.empty()) {
+    return true;
+  }
+  merged.columns = shard_results[0].columns;
+  auto &columns = merged.columns;
+  for (auto &shard_result : shard_results) {
+    merged.rows_changed += shard_result.rows_changed;
+  }
+
+  // Every shard aggregated its own rows. The groups of all shards are merged
+  // by their columns that are not aggregates.
+  auto &select_list = *select.select_list;
+  std::vector<ColumnMerge> merges(columns.size(), ColumnMerge::GROUP);
+  bool is_aggregate = select.group_by != nullptr;
+  if (select.group_by != nullptr && select.group_by->having != nullptr) {
+    error_message = "HAVING over several shards is not supported";
+    return false;
+  }
+  bool has_star = false;
+  for (size_t expr_itr = 0; expr_itr < select_list.size(); expr_itr++) {
+    auto expr = select_list[expr_itr];
+    has_star |= expr->GetExpressionType() == ExpressionType::STAR;
+    if (HasAggregate(expr) == false) {
+      continue;
+    }
+    is_aggregate = true;
+    switch (expr->GetExpressionType()) {
+      case ExpressionType::AGGREGATE_COUNT:
+      case ExpressionType::AGGREGATE_COUNT_STAR:
+      case ExpressionType::AGGREGATE_SUM:
+        merges[expr_itr] = ColumnMerge::ADD;
+        break;
+      case ExpressionType::AGGREGATE_MIN:
+        merges[expr_itr] = ColumnMerge::MIN;
+        break;
+      case ExpressionType::AGGREGATE_MAX:
+        merges[expr_itr] = ColumnMerge::MAX;
+        break;
+      default:
+        error_message = StringUtil::Format(
+            "%s over several shards is not supported",
+            expr->GetExpressionName());
+        return false;
+    }
+    if (expr->distinct_ && merges[expr_itr] == ColumnMerge::ADD) {
+      error_message = StringUtil::Format(
+          "%s of distinct values over several shards is not supported",
+          expr->GetExpressionName());
+      return false;
+    }
+  }
+  if (is_aggregate && (has_star || select_list.size() != columns.size())) {
+    error_message = "aggregates over several shards need named columns";
+    return false;
+  }
+
+  // Every shard skipped and limited its own rows
+  auto limit = select.limit;
+  if (limit != nullptr && limit->offset > 0) {
+    error_message = "OFFSET over several shards is not supported";
+    return false;
+  }
+  if (limit != nullptr && limit->limit != parser::kNoLimit &&
+      select.group_by != nullptr) {
+    error_message = "LIMIT of groups over several shards is not supported";
+    return false;
+  }
+
+  auto &rows = merged.rows;
+  if (is_aggregate) {
+    std::map<std::vector<std::string>, size_t> groups;
+    for (auto &shard_result : shard_results) {
+      for (auto &row : shard_result.rows) {
+        std::vector<std::string> group;
+        for (size_t column = 0; column < merges.size(); column++) {
+          if (merges[column] == ColumnMerge::GROUP) {
+            group.push_back(row[column]);
+          }
+        }
+        auto entry = groups.find(group);
+        if (entry == groups.end()) {
+          groups.emplace(std::move(group), rows.size());
+          rows.push_back(row);
+          continue;
+        }
+        auto &merged_row = rows[entry->second];
+        for (size_t column = 0; column < merges.size(); column++) {
+          if (merges[column] != ColumnMerge::GROUP) {
+            merged_row[column] = MergeValue(merges[column], merged_row[column],
+                                            row[column], columns[column]);
+          }
+        }
+      }
+    }
+  } else {
+    for (auto &shard_result : shard_results) {
+      rows.insert(rows.end(), shard_result.rows.begin(),
+                  shard_result.rows.end());
+    }
+  }
+
+  if (select.select_distinct) {
+    std::set<std::vector<std::string>> distinct_rows;
+    rows.erase(std::remove_if(rows.begin(), rows.end(),
+                              [&distinct_rows](
+                                  const std::vector<std::string> &row) {
+                                return distinct_rows.insert(row).second ==
+                                       false;
+                              }),
+               rows.end());
+  }
+
+  // NULL sorts after every value, as in Postgres
+  if (select.order != nullptr) {
+    std::vector<std::pair<size_t, bool>> sort_keys;
+    for (size_t order_itr = 0; order_itr < select.order->exprs->size();
+         order_itr++) {
+      auto column =
+          FindColumn(select, columns, (*select.order->exprs)[order_itr]);
+      if (column == columns.size()) {
+        error_message = "ORDER BY over several shards has to sort by the "
+                        "columns of the result";
+        return false;
+      }
+      sort_keys.emplace_back(
+          column, (*select.order->types)[order_itr] == parser::kOrderDesc);
+    }
+
+    std::vector<std::pair<std::vector<type::Value>, size_t>> sort_rows;
+    for (size_t row_itr = 0; row_itr < rows.size(); row_itr++) {
+      std::vector<type::Value> values;
+      for (auto &sort_key : sort_keys) {
+        values.push_back(
+            ParseValue(rows[row_itr][sort_key.first], columns[sort_key.first]));
+      }
+      sort_rows.emplace_back(std::move(values), row_itr);
+    }
+    std::stable_sort(
+        sort_rows.begin(), sort_rows.end(),
+        [&sort_keys](
+            const std::pair<std::vector<type::Value>, size_t> &left,
+            const std::pair<std::vector<type::Value>, size_t> &right) {
+          for (size_t key_itr = 0; key_itr < sort_keys.size(); key_itr++) {
+            bool is_desc = sort_keys[key_itr].second;
+            auto &left_value = left.first[key_itr];
+            auto &right_value = right.first[key_itr];
+            if (left_value.IsNull() || right_value.IsNull()) {
+              if (left_value.IsNull() == right_value.IsNull()) {
+                continue;
+              }
+              return right_value.IsNull() != is_desc;
+            }
+            if (left_value.CompareLessThan(right_value) == type::CMP_TRUE) {
+              return is_desc == false;
+            }
+            if (right_value.CompareLessThan(left_value) == type::CMP_TRUE) {
+              return is_desc;
+            }
+          }
+          return false;
+        });
+
+    std::vector<std::vector<std::string>> sorted_rows;
+    for (auto &sort_row : sort_rows) {
+      sorted_rows.push_back(std::move(rows[sort_row.second]));
+    }
+    rows = std::move(sorted_rows);
+  }
+
+  if (limit != nullptr && limit->limit >= 0 &&
+      rows.size() > static_cast<size_t>(limit->limit)) {
+    rows.resize(limit->limit);
+  }
+  return true;
+}
+
+bool ShardRouter::ExecuteStatement(const std::string &query,
+                                   std::vector<StatementResult> &result,
+                                   std::vector<FieldInfo> &tuple_descriptor,
+                                   int &rows_changed,
+                                   std::string &error_message,
+                                   ResultType &status) {
+  // This node reports the statements that do not parse
+  std::unique_ptr<parser::SQLStatementList> statements;
+  try {
+    statements = parser::PostgresParser::GetInstance().BuildParseTree(query);
+  } catch (Exception &e) {
+    return false;
+  }
+  if (statements == nullptr || statements->is_valid == false ||
+      statements->GetNumStatements() != 1) {
+    return false;
+  }
+  auto statement = statements->GetStatement(0);
+  rows_changed = 0;
+
+  if (statement->GetType() == StatementType::TRANSACTION) {
+    auto type = ((parser::TransactionStatement *)statement)->type;
+    if (participants_.empty() ||
+        type == parser::TransactionStatement::kBegin) {
+      return false;
+    }
+    status = type == parser::TransactionStatement::kCommit
+                 ? CommitTransaction(error_message)
+                 : AbortTransaction(error_message);
+    return true;
+  }
+
+  ShardTarget target;
+  try {
+    if (GetTarget(statement, target, error_message) == false) {
+      status = ResultType::FAILURE;
+      return true;
+    }
+  } catch (Exception &e) {
+    error_message = e.what();
+    status = ResultType::FAILURE;
+    return true;
+  }
+  auto &shard_map = catalog::ShardMap::GetInstance();
+  if (target.type == ShardTargetType::LOCAL ||
+      (target.type == ShardTargetType::SINGLE &&
+       target.node_id == shard_map.GetNodeId())) {
+    return false;
+  }
+
+  // This node reports that the transaction block aborted
+  auto txn_result = traffic_cop_.GetRunningTransactionResult();
+  if (txn_result == ResultType::ABORTED) {
+    return false;
+  }
+
+  // A write on several nodes outside of a transaction block runs in a
+  // distributed transaction of its own
+  bool is_implicit = txn_result == ResultType::INVALID && target.is_write &&
+                     target.type == ShardTargetType::ALL;
+  ShardResult merged;
+  if (is_implicit) {
+    status = ExecuteLocal("BEGIN", merged, error_message);
+    if (status != ResultType::SUCCESS) {
+      return true;
+    }
+  }
+
+  status = ExecuteOnShards(statement, query, target, merged, error_message);
+  if (is_implicit) {
+    if (status == ResultType::SUCCESS) {
+      status = CommitTransaction(error_message);
+    } else {
+      std::string abort_error;
+      AbortTransaction(abort_error);
+    }
+  }
+
+  rows_changed = merged.rows_changed;
+  tuple_descriptor = merged.columns;
+  for (auto &row : merged.rows) {
+    for (auto &value : row) {
+      StatementResult field;
+      field.second.assign(value.begin(), value.end());
+      result.push_back(std::move(field));
+    }
+  }
+  return true;
+}
+
+ResultType ShardRouter::ExecuteLocal(const std::string &query,
+                                     ShardResult &shard_result,
+                                     std::string &error_message) {
+  // The rows of this node are merged with those of the other nodes before
+  // they are handed over
+  auto rows_callback = traffic_cop_.GetRowsCallback();
+  traffic_cop_.SetRowsCallback(nullptr);
+  traffic_cop_.SetShardRouting(false);
+  std::vector<StatementResult> result;
+  shard_result = ShardResult();
+  auto status = traffic_cop_.ExecuteStatement(query, result,
+                                              shard_result.columns,
+                                              shard_result.rows_changed,
+                                              error_message);
+  traffic_cop_.SetShardRouting(true);
+  traffic_cop_.SetRowsCallback(rows_callback);
+
+  auto column_count = shard_result.columns.size();
+  for (size_t value_itr = 0;
+       column_count > 0 && value_itr + column_count <= result.size();
+       value_itr += column_count) {
+    std::vector<std::string> row;
+    for (size_t col_itr = 0; col_itr < column_count; col_itr++) {
+      auto &value = result[value_itr + col_itr].second;
+      row.emplace_back(value.begin(), value.end());
+    }
+    shard_result.rows.push_back(std::move(row));
+  }
+  return status;
+}
+
+ResultType ShardRouter::ExecuteOnShards(parser::SQLStatement *statement,
+                                        const std::string &query,
+                                        const ShardTarget &target,
+                                        ShardResult &merged,
+                                        std::string &error_message) {
+  auto &shard_map = catalog::ShardMap::GetInstance();
+  auto &shard_client = networking::ShardClient::GetInstance();
+  bool is_in_block =
+      traffic_cop_.GetRunningTransactionResult() != ResultType::INVALID;
+  int64_t transaction_id = is_in_block ? GetTransactionId() : 0;
+
+  std::vector<size_t> nodes;
+  if (target.type == ShardTargetType::SINGLE) {
+    nodes.push_back(target.node_id);
+  } else {
+    for (size_t node_id = 0; node_id < shard_map.GetNodeCount(); node_id++) {
+      nodes.push_back(node_id);
+    }
+  }
+
+  // The other nodes execute the statement while this node does
+  std::vector<std::pair<size_t, uint64_t>> calls;
+  bool is_local = false;
+  for (auto node_id : nodes) {
+    if (node_id == shard_map.GetNodeId()) {
+      is_local = true;
+      continue;
+    }
+    calls.emplace_back(node_id, shard_client.SendStatement(
+                                    node_id, transaction_id, query));
+    if (transaction_id != 0) {
+      participants_.insert(node_id);
+    }
+  }
+
+  std::vector<ShardResult> shard_results;
+  auto status = ResultType::SUCCESS;
+  if (is_local) {
+    shard_results.emplace_back();
+    status = ExecuteLocal(query, shard_results.back(), error_message);
+  }
+  for (auto &call : calls) {
+    networking::ShardStatementResponse response;
+    bool is_answered = shard_client.WaitStatement(call.second, response);
+    auto call_status = is_answered
+                           ? static_cast<ResultType>(response.result())
+                           : ResultType::FAILURE;
+    if (call_status != ResultType::SUCCESS) {
+      if (status == ResultType::SUCCESS) {
+        status = call_status;
+        error_message =
+            is_answered ? response.error_message()
+                        : StringUtil::Format("shard node %lu did not answer",
+                                             call.first);
+      }
+      continue;
+    }
+
+    shard_results.emplace_back();
+    auto &shard_result = shard_results.back();
+    shard_result.rows_changed = response.rows_changed();
+    for (auto &column : response.column()) {
+      shard_result.columns.emplace_back(column.name(), column.type_oid(),
+                                        column.type_size());
+    }
+    for (auto &row : response.row()) {
+      shard_result.rows.emplace_back(row.value().begin(), row.value().end());
+    }
+  }
+
+  if (status == ResultType::SUCCESS) {
+    if (statement->GetType() == StatementType::SELECT &&
+        shard_results.size() > 1) {
+      try {
+        if (MergeResults(*(parser::SelectStatement *)statement,
+                         shard_results, merged, error_message) == false) {
+          status = ResultType::FAILURE;
+        }
+      } catch (Exception &e) {
+        error_message = e.what();
+        status = ResultType::FAILURE;
+      }
+    } else if (shard_results.empty() == false) {
+      merged.columns = shard_results[0].columns;
+      for (auto &shard_result : shard_results) {
+        merged.rows_changed += shard_result.rows_changed;
+        merged.rows.insert(merged.rows.end(), shard_result.rows.begin(),
+                           shard_result.rows.end());
+      }
+    }
+  }
+
+  // A statement that failed on any node aborts the whole transaction
+  if (status != ResultType::SUCCESS && is_in_block) {
+    traffic_cop_.AbortRunningTransaction();
+  }
+  return status;
+}
+
+int64_t ShardRouter::GetTransactionId() {
+  if (transaction_id_ == 0) {
+    auto node_id =
+        static_cast<int64_t>(catalog::ShardMap::GetInstance().GetNodeId());
+    transaction_id_ = ((node_id + 1) << 48) | next_transaction_id++;
+  }
+  return transaction_id_;
+}
+
+ResultType ShardRouter::CommitTransaction(std::string &error_message) {
+  auto &shard_client = networking::ShardClient::GetInstance();
+  bool is_prepared =
+      traffic_cop_.GetRunningTransactionResult() == ResultType::SUCCESS;
+  if (is_prepared) {
+    std::vector<std::pair<size_t, uint64_t>> calls;
+    for (auto node_id : participants_) {
+      calls.emplace_back(node_id,
+                         shard_client.SendPrepare(node_id, transaction_id_));
+    }
+    for (auto &call : calls) {
+      networking::ShardTransactionResponse response;
+      if (shard_client.WaitTransaction(call.second, response) == false ||
+          static_cast<ResultType>(response.result()) != ResultType::SUCCESS) {
+        LOG_DEBUG("Shard node %lu cannot commit transaction %ld", call.first,
+                  transaction_id_);
+        is_prepared = false;
+      }
+    }
+  }
+
+  // Once every other node is prepared the commit of this node decides
+  ShardResult local_result;
+  ResultType status;
+  if (is_prepared) {
+    status = ExecuteLocal("COMMIT", local_result, error_message);
+  } else {
+    ExecuteLocal("ROLLBACK", local_result, error_message);
+    status = ResultType::ABORTED;
+  }
+  FinishTransaction(status == ResultType::SUCCESS);
+  return status;
+}
+
+ResultType ShardRouter::AbortTransaction(std::string &error_message) {
+  FinishTransaction(false);
+  ShardResult local_result;
+  return ExecuteLocal("ROLLBACK", local_result, error_message);
+}
+
+void ShardRouter::FinishTransaction(const bool commit) {
+  auto &shard_client = networking::ShardClient::GetInstance();
+  std::vector<std::pair<size_t, uint64_t>> calls;
+  for (auto node_id : participants_) {
+    calls.emplace_back(node_id, shard_client.SendFinish(
+                                    node_id, transaction_id_, commit));
+  }
+
+  // A node that does not confirm the commit keeps its part of the
+  // transaction open
+  for (auto &call : calls) {
+    networking::ShardTransactionResponse response;
+    if (shard_client.WaitTransaction(call.second, response) == false ||
+        (commit == true && static_cast<ResultType>(response.result()) !=
+                               ResultType::SUCCESS)) {
+      LOG_ERROR("Shard node %lu did not %s transaction %ld", call.first,
+                commit ? "commit" : "abort", transaction_id_);
+    }
+  }
+  participants_.clear();
+  transaction_id_ = 0;
+}
+
+}  // End tcop namespace
+}  // End peloton namespace
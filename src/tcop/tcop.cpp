@@ -12,10 +12,13 @@
 
 #include "tcop/tcop.h"
 
+#include "brain/index_sampler.h"
 #include "catalog/catalog.h"
+#include "catalog/shard_map.h"
 #include "common/abstract_tuple.h"
 #include "common/logger.h"
 #include "common/macros.h"
+#include "common/memory_tracker.h"
 #include "common/portal.h"
 #include "type/type.h"
 #include "type/types.h"
@@ -23,14 +26,28 @@
 #include "configuration/configuration.h"
 
 #include "expression/aggregate_expression.h"
+#include "expression/constant_value_expression.h"
 #include "expression/expression_util.h"
 #include "common/exception.h"
+#include "parser/copy_statement.h"
+#include "parser/explain_statement.h"
 #include "parser/select_statement.h"
+#include "parser/transaction_statement.h"
 
 #include "catalog/catalog.h"
 #include "executor/plan_executor.h"
+#include "logging/group_commit_manager.h"
+#include "logging/log_manager_factory.h"
 #include "optimizer/optimizer.h"
+#include "optimizer/plan_cache.h"
+#include "optimizer/stats/stats_storage.h"
 #include "planner/plan_util.h"
+#include "tcop/procedure_manager.h"
+#include "tcop/result_cache.h"
+#include "tcop/shard_router.h"
+#include "util/string_util.h"
+
+#include <sstream>
 
 #include <boost/algorithm/string.hpp>
 #include <include/parser/postgresparser.h>
@@ -49,6 +66,7 @@ void TrafficCop::Reset() {
   // clear out the stack
   swap(tcop_txn_state_, new_tcop_txn_state);
   optimizer_->Reset();
+  shard_router_.reset();
 }
 
 TrafficCop::~TrafficCop() {
@@ -80,9 +98,19 @@ TrafficCop::TcopTxnState &TrafficCop::GetCurrentTxnState() {
   return tcop_txn_state_.top();
 }
 
-ResultType TrafficCop::BeginQueryHelper(const size_t thread_id) {
+ResultType TrafficCop::BeginQueryHelper(const size_t thread_id,
+                                        const bool read_only,
+                                        const IsolationLevelType isolation) {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-  auto txn = txn_manager.BeginTransaction(thread_id);
+  // a read-only transaction reads a snapshot without leaving any trace in
+  // the tuple headers
+  IsolationLevelType level = txn_manager.GetIsolationLevel();
+  if (read_only) {
+    level = IsolationLevelType::READ_ONLY;
+  } else if (isolation != IsolationLevelType::INVALID) {
+    level = isolation;
+  }
+  auto txn = txn_manager.BeginTransaction(thread_id, level);
 
   // this shouldn't happen
   if (txn == nullptr) {
@@ -102,16 +130,22 @@ ResultType TrafficCop::CommitQueryHelper() {
   tcop_txn_state_.pop();
   // commit the txn only if it has not aborted already
   if (curr_state.second != ResultType::ABORTED) {
-    auto txn = curr_state.first;
-    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-    auto result = txn_manager.CommitTransaction(txn);
-    return result;
+    return CommitTransaction(curr_state.first);
   } else {
     // otherwise, the txn has already been aborted
     return ResultType::ABORTED;
   }
 }
 
+ResultType TrafficCop::CommitTransaction(concurrency::Transaction *txn) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  if (commit_waiter_ == nullptr) {
+    return txn_manager.GroupCommitTransaction(txn, [](const ResultType) {});
+  }
+  return txn_manager.GroupCommitTransaction(
+      txn, commit_waiter_->AddCommit(commit_waiter_));
+}
+
 ResultType TrafficCop::AbortQueryHelper() {
   // do nothing if we have no active txns
   if (tcop_txn_state_.empty()) return ResultType::NOOP;
@@ -129,36 +163,171 @@ ResultType TrafficCop::AbortQueryHelper() {
   }
 }
 
+void TrafficCop::AbortRunningTransaction() {
+  if (tcop_txn_state_.empty() ||
+      tcop_txn_state_.top().second == ResultType::ABORTED) {
+    return;
+  }
+  auto &curr_state = tcop_txn_state_.top();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.AbortTransaction(curr_state.first);
+  curr_state.second = ResultType::ABORTED;
+}
+
 ResultType TrafficCop::ExecuteStatement(
     const std::string &query, std::vector<StatementResult> &result,
     std::vector<FieldInfo> &tuple_descriptor, int &rows_changed,
-    std::string &error_message, const size_t thread_id UNUSED_ATTRIBUTE) {
+    std::string &error_message, const size_t thread_id) {
   LOG_TRACE("Received %s", query.c_str());
 
-  // Prepare the statement
+  // The stored procedures run on this node
+  ResultType status;
+  if (ExecuteProcedureCommand(query, result, tuple_descriptor, rows_changed,
+                              error_message, thread_id, status)) {
+    return status;
+  }
+
+  // A statement over sharded tables runs on the nodes of their shards
+  if (route_shards_ && catalog::ShardMap::GetInstance().IsEnabled()) {
+    if (shard_router_ == nullptr) {
+      shard_router_.reset(new ShardRouter(*this));
+    }
+    if (shard_router_->ExecuteStatement(query, result, tuple_descriptor,
+                                        rows_changed, error_message, status)) {
+      return status;
+    }
+  }
+
+  // A query that only differs from an earlier one in its literals runs the
+  // plan prepared for the earlier one, with its literals as the parameters
   std::string unnamed_statement = "unnamed";
-  auto statement = PrepareStatement(unnamed_statement, query, error_message);
+  std::string parameterized_query;
+  std::vector<type::Value> params;
+  std::shared_ptr<Statement> statement;
+  uint64_t catalog_version = catalog::Catalog::GetInstance()->GetVersion();
+  stats::QueryPhaseTimer parse_timer(stats::QueryPhase::PARSE);
+  bool parameterized =
+      (FLAGS_plan_cache_size > 0 || FLAGS_result_cache_size > 0) &&
+      parser::PostgresParser::ParameterizeLiterals(query, parameterized_query,
+                                                   params);
+  parse_timer.Stop();
+
+  // A query outside of a transaction block returns the rows cached for it
+  // while the tables it read are unchanged
+  auto &result_cache = ResultCache::GetInstance();
+  std::string result_key;
+  if (FLAGS_result_cache_size > 0 && tcop_txn_state_.empty()) {
+    result_key = parameterized
+                     ? ResultCache::GetKey(parameterized_query, params)
+                     : query;
+    auto cached_result = result_cache.Find(result_key, catalog_version);
+    if (cached_result != nullptr) {
+      LOG_TRACE("Returned the cached result of %s", query.c_str());
+      result = cached_result->rows;
+      tuple_descriptor = cached_result->tuple_descriptor;
+      rows_changed = cached_result->rows_changed;
+      return ResultType::SUCCESS;
+    }
+  }
+
+  bool cached = FLAGS_plan_cache_size > 0 && parameterized;
+  if (cached == false) {
+    params.clear();
+  }
+  if (cached) {
+    statement = optimizer::PlanCache::GetInstance().Acquire(
+        parameterized_query, catalog_version);
+    if (statement == nullptr) {
+      std::string parameterized_error;
+      statement = PrepareStatement(unnamed_statement, parameterized_query,
+                                   parameterized_error);
+    }
+
+    // Some queries can only be planned with their literals
+    if (statement == nullptr || statement->GetPlanTree() == nullptr) {
+      LOG_TRACE("Cannot plan %s", parameterized_query.c_str());
+      cached = false;
+      statement = nullptr;
+      params.clear();
+    } else {
+      stats::QueryPhaseTimer bind_timer(stats::QueryPhase::BIND);
+      statement->GetPlanTree()->SetParameterValues(&params);
+    }
+  }
+
+  // Prepare the statement
+  if (statement == nullptr) {
+    statement = PrepareStatement(unnamed_statement, query, error_message);
+  }
 
   if (statement.get() == nullptr) {
     rows_changed = 0;
     return ResultType::FAILURE;
   }
 
+  // Only the rows of a query reading tables are cached. The versions of the
+  // tables are taken before its transaction starts.
+  std::shared_ptr<CachedResult> new_result;
+  auto &plan = statement->GetPlanTree();
+  if (result_key.empty() == false && plan != nullptr &&
+      statement->IsExplain() == false &&
+      statement->GetTupleDescriptor().empty() == false &&
+      plan->GetPlanNodeType() != PlanNodeType::COPY &&
+      planner::PlanUtil::IsModifyingPlan(plan.get()) == false) {
+    auto table_oids = statement->GetReferencedTables();
+    if (table_oids.empty() == false) {
+      new_result.reset(new CachedResult());
+      new_result->catalog_version = catalog_version;
+      new_result->table_versions = result_cache.GetTableVersions(table_oids);
+    }
+  }
+
+  // The rows streamed while the statement executes are kept as well
+  RowsCallback rows_callback = rows_callback_;
+  size_t max_result_rows = result_cache.GetMaxResultRows();
+  if (new_result != nullptr && rows_callback) {
+    rows_callback_ = [&new_result, &rows_callback, max_result_rows](
+        const std::vector<FieldInfo> &columns,
+        std::vector<StatementResult> &rows) {
+      if (new_result != nullptr &&
+          new_result->rows.size() + rows.size() > max_result_rows) {
+        new_result = nullptr;
+      }
+      if (new_result != nullptr) {
+        new_result->rows.insert(new_result->rows.end(), rows.begin(),
+                                rows.end());
+      }
+      rows_callback(columns, rows);
+    };
+  }
+
   // Then, execute the statement
   bool unnamed = true;
   std::vector<int> result_format(statement->GetTupleDescriptor().size(), 0);
-  std::vector<type::Value> params;
-  auto status =
+  status =
       ExecuteStatement(statement, params, unnamed, nullptr, result_format,
                        result, rows_changed, error_message, thread_id);
+  rows_callback_ = rows_callback;
 
   if (status == ResultType::SUCCESS) {
     LOG_TRACE("Execution succeeded!");
     tuple_descriptor = statement->GetTupleDescriptor();
+    if (new_result != nullptr &&
+        new_result->rows.size() + result.size() <= max_result_rows) {
+      new_result->rows.insert(new_result->rows.end(), result.begin(),
+                              result.end());
+      new_result->tuple_descriptor = tuple_descriptor;
+      new_result->rows_changed = rows_changed;
+      result_cache.Insert(result_key, std::move(new_result));
+    }
   } else {
     LOG_TRACE("Execution failed!");
   }
 
+  if (cached) {
+    optimizer::PlanCache::GetInstance().Release(parameterized_query,
+                                                catalog_version, statement);
+  }
   return status;
 }
 
@@ -183,18 +352,39 @@ ResultType TrafficCop::ExecuteStatement(
   try {
     switch(statement->GetQueryType()) {
       case QueryType::QUERY_BEGIN:
-        return BeginQueryHelper(thread_id);
+        return BeginQueryHelper(thread_id,
+                                statement->IsReadOnlyTransaction(),
+                                statement->GetTransactionIsolation());
       case QueryType::QUERY_COMMIT:
         return CommitQueryHelper();
       case QueryType::QUERY_ROLLBACK:
         return AbortQueryHelper();
       default:
-        auto status = ExecuteStatementPlan(statement->GetPlanTree(), params,
-                                           result, result_format,
-                                           thread_id);
+        if (statement->IsExplain()) {
+          return ExplainStatementPlan(statement, params, result,
+                                      rows_changed, thread_id);
+        }
+
+        // The rows handed over have the columns of the statement
+        ResultCallback callback;
+        if (rows_callback_) {
+          callback = [this, &statement](std::vector<StatementResult> &rows) {
+            rows_callback_(statement->GetTupleDescriptor(), rows);
+          };
+        }
+        auto status = ExecuteStatementPlan(
+            statement->GetPlanTree(), params, result, result_format, thread_id,
+            statement.get(), rows_callback_ ? &callback : nullptr);
         LOG_TRACE("Statement executed. Result: %s",
                   ResultTypeToString(status.m_result).c_str());
         rows_changed = status.m_processed;
+
+        // The index tuner learns from the predicates that were executed
+        if (FLAGS_index_tuner == true &&
+            status.m_result == ResultType::SUCCESS) {
+          brain::IndexSampler::RecordPlan(statement->GetPlanTree().get(),
+                                          status.m_processed);
+        }
         return status.m_result;
     }
   } catch (Exception &e) {
@@ -203,12 +393,249 @@ ResultType TrafficCop::ExecuteStatement(
   }
 }
 
+ResultType TrafficCop::ExecuteProcedure(
+    const std::string &name, const std::vector<type::Value> &params,
+    std::vector<StatementResult> &result,
+    std::vector<FieldInfo> &tuple_descriptor, int &rows_changed,
+    std::string &error_message, const size_t thread_id) {
+  auto &procedure_manager = ProcedureManager::GetInstance();
+  rows_changed = 0;
+  auto procedure = procedure_manager.GetProcedure(name);
+  if (procedure == nullptr) {
+    error_message =
+        StringUtil::Format("procedure %s does not exist", name.c_str());
+    return ResultType::FAILURE;
+  }
+  if (params.size() != procedure->parameter_count) {
+    error_message = StringUtil::Format("procedure %s takes %lu arguments",
+                                       name.c_str(),
+                                       procedure->parameter_count);
+    return ResultType::FAILURE;
+  }
+
+  // The statements are only prepared again once the catalog changed
+  uint64_t catalog_version = catalog::Catalog::GetInstance()->GetVersion();
+  auto prepared = procedure_manager.Acquire(name, catalog_version);
+  if (prepared == nullptr || prepared->procedure != procedure) {
+    prepared = PrepareProcedure(procedure, catalog_version, error_message);
+    if (prepared == nullptr) {
+      return ResultType::FAILURE;
+    }
+  }
+
+  // All statements run in one transaction
+  bool single_statement_txn = tcop_txn_state_.empty();
+  if (single_statement_txn &&
+      BeginQueryHelper(thread_id) != ResultType::SUCCESS) {
+    procedure_manager.Release(std::move(prepared));
+    return ResultType::FAILURE;
+  }
+  auto txn = tcop_txn_state_.top().first;
+  ResultType status = tcop_txn_state_.top().second == ResultType::ABORTED
+                          ? ResultType::ABORTED
+                          : ResultType::SUCCESS;
+
+  // binding the arguments points the plans at them
+  std::vector<type::Value> values = params;
+  result.clear();
+  tuple_descriptor.clear();
+  try {
+    for (auto &statement : prepared->statements) {
+      if (status != ResultType::SUCCESS) {
+        break;
+      }
+      auto &plan = statement->GetPlanTree();
+      bool is_modifying = planner::PlanUtil::IsModifyingPlan(plan.get());
+      if (is_modifying && txn->IsDeclaredReadOnly()) {
+        error_message = "cannot write in a read-only transaction";
+        status = ResultType::FAILURE;
+        break;
+      }
+      if (values.empty() == false) {
+        plan->SetParameterValues(&values);
+      }
+      if (is_modifying) {
+        LogCommand(txn, plan.get(), statement.get(), values);
+      }
+
+      std::vector<StatementResult> statement_result;
+      std::vector<int> result_format(statement->GetTupleDescriptor().size(),
+                                     0);
+      auto p_status = executor::PlanExecutor::ExecutePlan(
+          plan, txn, values, statement_result, result_format);
+      if (p_status.m_result != ResultType::SUCCESS ||
+          txn->GetResult() != ResultType::SUCCESS) {
+        status = ResultType::FAILURE;
+        break;
+      }
+      if (is_modifying) {
+        rows_changed += p_status.m_processed;
+      }
+      if (statement->GetTupleDescriptor().empty() == false) {
+        result = std::move(statement_result);
+        tuple_descriptor = statement->GetTupleDescriptor();
+      }
+    }
+  } catch (Exception &e) {
+    error_message = e.what();
+    status = ResultType::FAILURE;
+  }
+  procedure_manager.Release(std::move(prepared));
+
+  // A failed statement rolls back the whole call
+  if (status == ResultType::SUCCESS && single_statement_txn) {
+    status = CommitQueryHelper();
+  } else if (status != ResultType::SUCCESS) {
+    if (single_statement_txn) {
+      AbortQueryHelper();
+    } else {
+      AbortRunningTransaction();
+    }
+    result.clear();
+    tuple_descriptor.clear();
+  }
+  return status;
+}
+
+std::unique_ptr<PreparedProcedure> TrafficCop::PrepareProcedure(
+    std::shared_ptr<const Procedure> procedure, uint64_t catalog_version,
+    std::string &error_message) {
+  std::unique_ptr<PreparedProcedure> prepared(new PreparedProcedure());
+  prepared->procedure = procedure;
+  prepared->catalog_version = catalog_version;
+  for (auto &query : procedure->queries) {
+    auto statement = PrepareStatement(procedure->name, query, error_message);
+    if (statement == nullptr) {
+      return nullptr;
+    }
+    switch (statement->GetQueryType()) {
+      case QueryType::QUERY_BEGIN:
+      case QueryType::QUERY_COMMIT:
+      case QueryType::QUERY_ROLLBACK:
+        error_message = "a procedure cannot begin or end its transaction";
+        return nullptr;
+      default:
+        break;
+    }
+    if (statement->GetPlanTree() == nullptr || statement->IsExplain()) {
+      error_message = StringUtil::Format("%s cannot run in a procedure",
+                                         query.c_str());
+      return nullptr;
+    }
+    prepared->statements.push_back(std::move(statement));
+  }
+  return prepared;
+}
+
+bool TrafficCop::ExecuteProcedureCommand(
+    const std::string &query, std::vector<StatementResult> &result,
+    std::vector<FieldInfo> &tuple_descriptor, int &rows_changed,
+    std::string &error_message, const size_t thread_id, ResultType &status) {
+  std::string command = boost::trim_copy(query);
+  std::stringstream stream(command);
+  std::string first_word, second_word, name;
+  stream >> first_word >> second_word;
+  first_word = StringUtil::Upper(first_word);
+  status = ResultType::FAILURE;
+  rows_changed = 0;
+
+  // CALL name(arguments), whose arguments are constants
+  if (first_word == "CALL") {
+    auto open = command.find('(');
+    auto close = command.rfind(')');
+    if (open == std::string::npos || close == std::string::npos ||
+        close < open) {
+      error_message = "syntax error in CALL";
+      return true;
+    }
+    name = boost::trim_copy(command.substr(4, open - 4));
+    std::string arguments =
+        boost::trim_copy(command.substr(open + 1, close - open - 1));
+    std::vector<type::Value> params;
+    if (arguments.empty() == false) {
+      try {
+        auto statements = parser::PostgresParser::GetInstance().BuildParseTree(
+            "SELECT " + arguments);
+        if (statements == nullptr || statements->is_valid == false ||
+            statements->GetNumStatements() != 1) {
+          error_message = "syntax error in the arguments of CALL";
+          return true;
+        }
+        auto select = (parser::SelectStatement *)statements->GetStatement(0);
+        for (auto expr : *select->select_list) {
+          if (expr->GetExpressionType() != ExpressionType::VALUE_CONSTANT) {
+            error_message = "the arguments of CALL have to be constants";
+            return true;
+          }
+          params.push_back(
+              ((expression::ConstantValueExpression *)expr)->GetValue().Copy());
+        }
+      } catch (Exception &e) {
+        error_message = e.what();
+        return true;
+      }
+    }
+    status = ExecuteProcedure(name, params, result, tuple_descriptor,
+                              rows_changed, error_message, thread_id);
+    return true;
+  }
+
+  if ((first_word != "CREATE" && first_word != "DROP") ||
+      StringUtil::Upper(second_word) != "PROCEDURE") {
+    return false;
+  }
+  stream >> name;
+  if (name.empty() == false && name.back() == ';') {
+    name.pop_back();
+  }
+  if (name.empty()) {
+    error_message = StringUtil::Format("syntax error in %s PROCEDURE",
+                                       first_word.c_str());
+    return true;
+  }
+  auto &procedure_manager = ProcedureManager::GetInstance();
+  if (first_word == "DROP") {
+    if (procedure_manager.DropProcedure(name) == false) {
+      error_message =
+          StringUtil::Format("procedure %s does not exist", name.c_str());
+      return true;
+    }
+    status = ResultType::SUCCESS;
+    return true;
+  }
+
+  // CREATE PROCEDURE name AS query; ... whose queries use $1 .. $n
+  std::string as_word, body;
+  stream >> as_word;
+  std::getline(stream, body, '\0');
+  std::shared_ptr<Procedure> procedure(new Procedure());
+  procedure->name = name;
+  procedure->queries =
+      ProcedureManager::SplitQueries(body, procedure->parameter_count);
+  if (StringUtil::Upper(as_word) != "AS" || procedure->queries.empty()) {
+    error_message = "syntax error in CREATE PROCEDURE";
+    return true;
+  }
+
+  // The statements are prepared right away to check that they can run
+  auto prepared = PrepareProcedure(
+      procedure, catalog::Catalog::GetInstance()->GetVersion(), error_message);
+  if (prepared == nullptr) {
+    return true;
+  }
+  procedure_manager.CreateProcedure(procedure);
+  procedure_manager.Release(std::move(prepared));
+  status = ResultType::SUCCESS;
+  return true;
+}
+
 executor::ExecuteResult TrafficCop::ExecuteStatementPlan(
     std::shared_ptr<planner::AbstractPlan> plan,
     const std::vector<type::Value> &params,
     std::vector<StatementResult> &result,
     const std::vector<int> &result_format,
-    const size_t thread_id) {
+    const size_t thread_id, Statement *statement,
+    const ResultCallback *callback, executor::ExecutorProfile *profile) {
   concurrency::Transaction *txn;
   bool single_statement_txn = false, init_failure = false;
   executor::ExecuteResult p_status;
@@ -226,11 +653,26 @@ executor::ExecuteResult TrafficCop::ExecuteStatementPlan(
     txn = curr_state.first;
   }
 
+  // a read-only transaction cannot run a statement that writes. it is
+  // rolled back like a failed statement would be.
+  if (curr_state.second != ResultType::ABORTED && txn->IsDeclaredReadOnly() == true &&
+      planner::PlanUtil::IsModifyingPlan(plan.get()) == true) {
+    LOG_TRACE("Cannot write in a read-only transaction");
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    txn_manager.AbortTransaction(txn);
+    curr_state.second = ResultType::ABORTED;
+    p_status.m_result = ResultType::FAILURE;
+    return p_status;
+  }
+
   // skip if already aborted
   if (curr_state.second != ResultType::ABORTED) {
     PL_ASSERT(txn);
-    p_status = executor::PlanExecutor::ExecutePlan(plan, txn, params, result,
-                                                   result_format);
+    if (planner::PlanUtil::IsModifyingPlan(plan.get()) == true) {
+      LogCommand(txn, plan.get(), statement, params);
+    }
+    p_status = executor::PlanExecutor::ExecutePlan(
+        plan, txn, params, result, result_format, callback, profile);
 
     if (p_status.m_result == ResultType::FAILURE) {
       // only possible if init failed
@@ -250,7 +692,14 @@ executor::ExecuteResult TrafficCop::ExecuteStatementPlan(
         case ResultType::SUCCESS:
           // Commit
           LOG_TRACE("Commit Transaction");
-          p_status.m_result = txn_manager.CommitTransaction(txn);
+          p_status.m_result = CommitTransaction(txn);
+          // Keep the stats of the tables the statement modified fresh
+          if (FLAGS_auto_analyze_threshold > 0 &&
+              p_status.m_result == ResultType::SUCCESS &&
+              planner::PlanUtil::IsModifyingPlan(plan.get()) == true) {
+            optimizer::StatsStorage::GetInstance()
+                ->AnalyzeStatsForStaleTables();
+          }
           break;
 
         case ResultType::FAILURE:
@@ -268,21 +717,106 @@ executor::ExecuteResult TrafficCop::ExecuteStatementPlan(
   return p_status;
 }
 
+ResultType TrafficCop::ExplainStatementPlan(
+    const std::shared_ptr<Statement> &statement,
+    const std::vector<type::Value> &params,
+    std::vector<StatementResult> &result, int &rows_changed,
+    const size_t thread_id) {
+  auto &plan = statement->GetPlanTree();
+  if (plan == nullptr) {
+    throw NotImplementedException("Cannot explain " +
+                                  statement->GetQueryString());
+  }
+
+  executor::ExecutorProfile profile;
+  ResultType status = ResultType::SUCCESS;
+  if (statement->IsExplainAnalyze()) {
+    // The rows of the statement are dropped. It is not logged as a command,
+    // replaying that would only run the EXPLAIN again.
+    std::vector<StatementResult> rows;
+    std::vector<int> result_format(statement->GetExplainedColumnCount(), 0);
+    auto p_status = ExecuteStatementPlan(plan, params, rows, result_format,
+                                         thread_id, nullptr, nullptr,
+                                         &profile);
+    rows_changed = p_status.m_processed;
+    status = p_status.m_result;
+  } else {
+    profile = executor::ExecutorProfile::FromPlan(*plan);
+  }
+
+  result.clear();
+  for (auto &line : profile.GetLines()) {
+    StatementResult row;
+    executor::PlanExecutor::copyFromTo(line, row.second);
+    result.push_back(std::move(row));
+  }
+  return status;
+}
+
+void TrafficCop::LogCommand(concurrency::Transaction *txn,
+                            const planner::AbstractPlan *plan,
+                            Statement *statement,
+                            const std::vector<type::Value> &params) {
+  // only the statements writing tuples can be replayed from the command log,
+  // any other write has the transaction logged by value
+  bool is_logged = false;
+  if (statement != nullptr) {
+    switch (plan->GetPlanNodeType()) {
+      case PlanNodeType::INSERT:
+      case PlanNodeType::UPDATE:
+      case PlanNodeType::DELETE:
+        is_logged = logging::LogManagerFactory::GetInstance().LogCommand(
+            txn, *statement, params);
+        break;
+      default:
+        break;
+    }
+  }
+  if (is_logged == false) {
+    txn->DisableCommandLogging();
+  }
+}
+
 std::shared_ptr<Statement> TrafficCop::PrepareStatement(
     const std::string &statement_name, const std::string &query_string,
     UNUSED_ATTRIBUTE std::string &error_message) {
   LOG_TRACE("Prepare Statement name: %s", statement_name.c_str());
   LOG_TRACE("Prepare Statement query: %s", query_string.c_str());
 
+  // What the statement holds on to is charged to the plan cache if it's
+  // cached
+  MemoryScope memory_scope;
+
   std::shared_ptr<Statement> statement(
       new Statement(statement_name, query_string));
   try {
     auto &peloton_parser = parser::PostgresParser::GetInstance();
+    stats::QueryPhaseTimer parse_timer(stats::QueryPhase::PARSE);
     auto sql_stmt = peloton_parser.BuildParseTree(query_string);
+    parse_timer.Stop();
     if (sql_stmt->is_valid == false) {
       throw ParserException("Error parsing SQL statement");
     }
+
+    // An EXPLAIN is planned as the statement it explains
+    bool explain = sql_stmt->GetNumStatements() > 0 &&
+                   sql_stmt->GetStatement(0)->GetType() ==
+                       StatementType::EXPLAIN;
+    bool explain_analyze = false;
+    if (explain) {
+      auto explain_stmt =
+          static_cast<parser::ExplainStatement *>(sql_stmt->GetStatement(0));
+      explain_analyze = explain_stmt->analyze;
+      std::unique_ptr<parser::SQLStatementList> real_stmt(
+          new parser::SQLStatementList(explain_stmt->real_sql_stmt.release()));
+      // the explained statement lives in the arena of the EXPLAIN
+      real_stmt->arena = std::move(sql_stmt->arena);
+      sql_stmt = std::move(real_stmt);
+    }
+
+    stats::QueryPhaseTimer optimize_timer(stats::QueryPhase::OPTIMIZE);
     auto plan = optimizer_->BuildPelotonPlanTree(sql_stmt);
+    optimize_timer.Stop();
     statement->SetPlanTree(plan);
 
     // Get the tables that our plan references so that we know how to
@@ -293,13 +827,29 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(
 
     for (auto stmt : sql_stmt->GetStatements()) {
       LOG_TRACE("SQLStatement: %s", stmt->GetInfo().c_str());
-      if (stmt->GetType() == StatementType::SELECT) {
+      if (explain) {
+        size_t explained_column_count = 0;
+        if (stmt->GetType() == StatementType::SELECT) {
+          explained_column_count = GenerateTupleDescriptor(stmt).size();
+        }
+        statement->SetExplain(explain_analyze, explained_column_count);
+        statement->SetTupleDescriptor({GetColumnFieldForValueType(
+            "QUERY PLAN", type::TypeId::VARCHAR)});
+      } else if (stmt->GetType() == StatementType::SELECT ||
+                 stmt->GetType() == StatementType::COPY) {
         auto tuple_descriptor = GenerateTupleDescriptor(stmt);
         statement->SetTupleDescriptor(tuple_descriptor);
+      } else if (stmt->GetType() == StatementType::TRANSACTION) {
+        auto txn_stmt = static_cast<parser::TransactionStatement *>(stmt);
+        statement->SetReadOnlyTransaction(txn_stmt->read_only);
+        statement->SetTransactionIsolation(txn_stmt->isolation);
       }
       break;
     }
 
+    sql_stmt.reset();
+    statement->SetMemoryFootprint(memory_scope.GetAllocatedBytes());
+
 #ifdef LOG_DEBUG_ENABLED
     if (statement->GetPlanTree().get() != nullptr) {
       LOG_DEBUG("Statement Prepared: %s", statement->GetInfo().c_str());
@@ -341,6 +891,22 @@ void TrafficCop::GetDataTables(
 std::vector<FieldInfo> TrafficCop::GenerateTupleDescriptor(
     parser::SQLStatement *sql_stmt) {
   std::vector<FieldInfo> tuple_descriptor;
+  if (sql_stmt->GetType() == StatementType::COPY) {
+    // The columns of the table a COPY TO STDOUT returns
+    auto copy_stmt = (parser::CopyStatement *)sql_stmt;
+    if (copy_stmt->type == CopyType::IMPORT_CSV ||
+        copy_stmt->file_path != nullptr) {
+      return tuple_descriptor;
+    }
+    auto target_table = catalog::Catalog::GetInstance()->GetTableWithName(
+        copy_stmt->cpy_table->GetDatabaseName(),
+        copy_stmt->cpy_table->GetTableName());
+    for (auto &column : target_table->GetSchema()->GetColumns()) {
+      tuple_descriptor.push_back(
+          GetColumnFieldForValueType(column.GetName(), column.GetType()));
+    }
+    return tuple_descriptor;
+  }
   if (sql_stmt->GetType() != StatementType::SELECT) return tuple_descriptor;
   auto select_stmt = (parser::SelectStatement *)sql_stmt;
 
@@ -465,6 +1031,13 @@ FieldInfo TrafficCop::GetColumnFieldForAggregates(std::string name,
       field_name = name;
       break;
     }
+    // The estimate is computed as a BIGINT
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
+      field_type = PostgresValueType::BIGINT;
+      field_size = 8;
+      field_name = name;
+      break;
+    }
     // Return a DOUBLE if the functiob is AVG
     case ExpressionType::AGGREGATE_AVG: {
       field_type = PostgresValueType::DOUBLE;
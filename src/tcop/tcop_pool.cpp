@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tcop_pool.cpp
+//
+// Identification: src/tcop/tcop_pool.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "tcop/tcop_pool.h"
+
+#include "common/logger.h"
+#include "tcop/tcop.h"
+
+namespace peloton {
+namespace tcop {
+
+TrafficCopPool &TrafficCopPool::GetInstance() {
+  static TrafficCopPool traffic_cop_pool;
+  return traffic_cop_pool;
+}
+
+TrafficCop *TrafficCopPool::Acquire() {
+  std::unique_lock<std::mutex> lock(pool_mutex_);
+  while (free_traffic_cops_.empty() &&
+         traffic_cops_.size() >= FLAGS_execution_contexts) {
+    LOG_TRACE("Waiting for one of %lu traffic cops", traffic_cops_.size());
+    released_.wait(lock);
+  }
+
+  if (free_traffic_cops_.empty() == false) {
+    auto traffic_cop = free_traffic_cops_.back();
+    free_traffic_cops_.pop_back();
+    return traffic_cop;
+  }
+  traffic_cops_.emplace_back(new TrafficCop());
+  return traffic_cops_.back().get();
+}
+
+void TrafficCopPool::Release(TrafficCop *traffic_cop) {
+  // The next connection streams its rows elsewhere
+  traffic_cop->SetRowsCallback(nullptr);
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    free_traffic_cops_.push_back(traffic_cop);
+  }
+  released_.notify_one();
+}
+
+size_t TrafficCopPool::GetCount() {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  return traffic_cops_.size();
+}
+
+size_t TrafficCopPool::GetFreeCount() {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  return free_traffic_cops_.size();
+}
+
+}  // namespace tcop
+}  // namespace peloton
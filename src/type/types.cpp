@@ -32,6 +32,9 @@ FileHandle INVALID_FILE_HANDLE;
 int DEFAULT_TUPLES_PER_TILEGROUP = 1000;
 int TEST_TUPLES_PER_TILEGROUP = 5;
 
+// For epoch
+std::atomic<size_t> EPOCH_LENGTH(40);
+
 // For threads
 size_t CONNECTION_THREAD_COUNT = 1;
 size_t LOGGING_THREAD_COUNT = 1;
@@ -171,6 +174,8 @@ std::string BackendTypeToString(BackendType type) {
       return "SSD";
     case (BackendType::HDD):
       return "HDD";
+    case (BackendType::HUGE_PAGE):
+      return "HUGE_PAGE";
     case (BackendType::INVALID):
       return "INVALID";
     default: {
@@ -193,6 +198,8 @@ BackendType StringToBackendType(const std::string& str) {
     return BackendType::SSD;
   } else if (str == "HDD") {
     return BackendType::HDD;
+  } else if (str == "HUGE_PAGE") {
+    return BackendType::HUGE_PAGE;
   } else {
     throw ConversionException(StringUtil::Format(
         "No BackendType conversion from string '%s'", str.c_str()));
@@ -366,6 +373,9 @@ std::string StatementTypeToString(StatementType type) {
     case StatementType::ANALYZE: {
       return "ANALYZE";
     }
+    case StatementType::EXPLAIN: {
+      return "EXPLAIN";
+    }
     default: {
       throw ConversionException(StringUtil::Format(
           "No string conversion for StatementType value '%d'",
@@ -403,6 +413,8 @@ StatementType StringToStatementType(const std::string& str) {
     return StatementType::TRANSACTION;
   } else if (upper_str == "COPY") {
     return StatementType::COPY;
+  } else if (upper_str == "EXPLAIN") {
+    return StatementType::EXPLAIN;
   } else {
     throw ConversionException(StringUtil::Format(
         "No StatementType conversion from string '%s'", upper_str.c_str()));
@@ -531,6 +543,9 @@ std::string ExpressionTypeToString(ExpressionType type, bool short_str) {
     case ExpressionType::AGGREGATE_AVG: {
       return ("AGGREGATE_AVG");
     }
+    case ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT: {
+      return ("AGGREGATE_APPROX_COUNT_DISTINCT");
+    }
     case ExpressionType::FUNCTION: {
       return ("FUNCTION");
     }
@@ -644,6 +659,8 @@ ExpressionType ParserExpressionNameToExpressionType(const std::string& str) {
     return ExpressionType::AGGREGATE_MAX;
   } else if (str == "min") {
     return ExpressionType::AGGREGATE_MIN;
+  } else if (str == "approx_count_distinct") {
+    return ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT;
   }
   return ExpressionType::INVALID;
 }
@@ -725,6 +742,8 @@ ExpressionType StringToExpressionType(const std::string& str) {
     return ExpressionType::AGGREGATE_MAX;
   } else if (upper_str == "AGGREGATE_AVG") {
     return ExpressionType::AGGREGATE_AVG;
+  } else if (upper_str == "AGGREGATE_APPROX_COUNT_DISTINCT") {
+    return ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT;
   } else if (upper_str == "FUNCTION") {
     return ExpressionType::FUNCTION;
   } else if (upper_str == "HASH_RANGE") {
@@ -815,6 +834,9 @@ std::string IndexTypeToString(IndexType type) {
     case IndexType::SKIPLIST: {
       return "SKIPLIST";
     }
+    case IndexType::ART: {
+      return "ART";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for IndexType value '%d'",
@@ -834,6 +856,8 @@ IndexType StringToIndexType(const std::string& str) {
     return IndexType::HASH;
   } else if (upper_str == "SKIPLIST") {
     return IndexType::SKIPLIST;
+  } else if (upper_str == "ART") {
+    return IndexType::ART;
   } else {
     throw ConversionException(StringUtil::Format(
         "No IndexType conversion from string '%s'", upper_str.c_str()));
@@ -963,6 +987,9 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PlanNodeType::INDEXSCAN: {
       return ("INDEXSCAN");
     }
+    case PlanNodeType::AGGREGATE_VIEW_SCAN: {
+      return ("AGGREGATE_VIEW_SCAN");
+    }
     case PlanNodeType::NESTLOOP: {
       return ("NESTLOOP");
     }
@@ -999,6 +1026,9 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PlanNodeType::PRINT: {
       return ("PRINT");
     }
+    case PlanNodeType::EXCHANGE: {
+      return ("EXCHANGE");
+    }
     case PlanNodeType::AGGREGATE: {
       return ("AGGREGATE");
     }
@@ -1032,6 +1062,9 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PlanNodeType::HASH: {
       return ("HASH");
     }
+    case PlanNodeType::WINDOW: {
+      return ("WINDOW");
+    }
     case PlanNodeType::RESULT: {
       return ("RESULT");
     }
@@ -1066,6 +1099,8 @@ PlanNodeType StringToPlanNodeType(const std::string& str) {
     return PlanNodeType::SEQSCAN;
   } else if (upper_str == "INDEXSCAN") {
     return PlanNodeType::INDEXSCAN;
+  } else if (upper_str == "AGGREGATE_VIEW_SCAN") {
+    return PlanNodeType::AGGREGATE_VIEW_SCAN;
   } else if (upper_str == "NESTLOOP") {
     return PlanNodeType::NESTLOOP;
   } else if (upper_str == "NESTLOOPINDEX") {
@@ -1090,6 +1125,8 @@ PlanNodeType StringToPlanNodeType(const std::string& str) {
     return PlanNodeType::RECEIVE;
   } else if (upper_str == "PRINT") {
     return PlanNodeType::PRINT;
+  } else if (upper_str == "EXCHANGE") {
+    return PlanNodeType::EXCHANGE;
   } else if (upper_str == "AGGREGATE") {
     return PlanNodeType::AGGREGATE;
   } else if (upper_str == "UNION") {
@@ -1112,6 +1149,8 @@ PlanNodeType StringToPlanNodeType(const std::string& str) {
     return PlanNodeType::AGGREGATE_V2;
   } else if (upper_str == "HASH") {
     return PlanNodeType::HASH;
+  } else if (upper_str == "WINDOW") {
+    return PlanNodeType::WINDOW;
   } else if (upper_str == "RESULT") {
     return PlanNodeType::RESULT;
   } else if (upper_str == "COPY") {
@@ -1779,6 +1818,12 @@ std::string ProtocolTypeToString(ProtocolType type) {
     case ProtocolType::TIMESTAMP_ORDERING: {
       return "TIMESTAMP_ORDERING";
     }
+    case ProtocolType::OPTIMISTIC: {
+      return "OPTIMISTIC";
+    }
+    case ProtocolType::PARTITIONED: {
+      return "PARTITIONED";
+    }
     default: {
       throw ConversionException(
           StringUtil::Format("No string conversion for ProtocolType value '%d'",
@@ -1794,6 +1839,10 @@ ProtocolType StringToProtocolType(const std::string &str) {
     return ProtocolType::INVALID;
   } else if (upper_str == "TIMESTAMP_ORDERING") {
     return ProtocolType::TIMESTAMP_ORDERING;
+  } else if (upper_str == "OPTIMISTIC") {
+    return ProtocolType::OPTIMISTIC;
+  } else if (upper_str == "PARTITIONED") {
+    return ProtocolType::PARTITIONED;
   } else {
     throw ConversionException(StringUtil::Format(
         "No ProtocolType conversion from string '%s'", upper_str.c_str()));
@@ -2085,6 +2134,60 @@ std::ostream &operator<<(std::ostream &os, const ConflictAvoidanceType &type) {
   return os;
 }
 
+//===--------------------------------------------------------------------===//
+// Conflict Types
+//===--------------------------------------------------------------------===//
+
+std::string ConflictTypeToString(ConflictType type) {
+  switch (type) {
+    case ConflictType::INVALID: {
+      return "INVALID";
+    }
+    case ConflictType::WRITE_WRITE: {
+      return "WRITE_WRITE";
+    }
+    case ConflictType::READ_WRITE: {
+      return "READ_WRITE";
+    }
+    case ConflictType::WRITE_READ: {
+      return "WRITE_READ";
+    }
+    case ConflictType::VALIDATION: {
+      return "VALIDATION";
+    }
+    default: {
+      throw ConversionException(
+          StringUtil::Format("No string conversion for ConflictType value '%d'",
+                             static_cast<int>(type)));
+    }
+  }
+  return "INVALID";
+}
+
+ConflictType StringToConflictType(const std::string &str) {
+  std::string upper_str = StringUtil::Upper(str);
+  if (upper_str == "INVALID") {
+    return ConflictType::INVALID;
+  } else if (upper_str == "WRITE_WRITE") {
+    return ConflictType::WRITE_WRITE;
+  } else if (upper_str == "READ_WRITE") {
+    return ConflictType::READ_WRITE;
+  } else if (upper_str == "WRITE_READ") {
+    return ConflictType::WRITE_READ;
+  } else if (upper_str == "VALIDATION") {
+    return ConflictType::VALIDATION;
+  } else {
+    throw ConversionException(StringUtil::Format(
+        "No ConflictType conversion from string '%s'", upper_str.c_str()));
+  }
+  return ConflictType::INVALID;
+}
+
+std::ostream& operator<<(std::ostream& os, const ConflictType& type) {
+  os << ConflictTypeToString(type);
+  return os;
+}
+
 //===--------------------------------------------------------------------===//
 // Garbage Collection Types
 //===--------------------------------------------------------------------===//
@@ -2194,6 +2297,9 @@ std::string LogRecordTypeToString(LogRecordType type) {
     case LogRecordType::TUPLE_UPDATE: {
       return "TUPLE_UPDATE";
     }
+    case LogRecordType::COMMAND: {
+      return "COMMAND";
+    }
     case LogRecordType::EPOCH_BEGIN: {
       return "EPOCH_BEGIN";
     }
@@ -2223,6 +2329,8 @@ LogRecordType StringToLogRecordType(const std::string& str) {
     return LogRecordType::TUPLE_DELETE;
   } else if (upper_str == "TUPLE_UPDATE") {
     return LogRecordType::TUPLE_UPDATE;
+  } else if (upper_str == "COMMAND") {
+    return LogRecordType::COMMAND;
   } else if (upper_str == "EPOCH_BEGIN") {
     return LogRecordType::EPOCH_BEGIN;
   } else if (upper_str == "EPOCH_END") {
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// value_dispatch.cpp
+//
+// Identification: src/type/value_dispatch.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/value_dispatch.h"
+
+#include "type/value_ref.h"
+
+namespace peloton {
+namespace type {
+
+namespace {
+
+// The comparisons, what they do on the native values and through the Type
+struct Equal {
+  template <class L, class R>
+  static inline bool Apply(L left, R right) { return left == right; }
+  static CmpBool Virtual(const Value &left, const Value &right) {
+    return left.CompareEquals(right);
+  }
+};
+
+struct NotEqual {
+  template <class L, class R>
+  static inline bool Apply(L left, R right) { return left != right; }
+  static CmpBool Virtual(const Value &left, const Value &right) {
+    return left.CompareNotEquals(right);
+  }
+};
+
+struct LessThan {
+  template <class L, class R>
+  static inline bool Apply(L left, R right) { return left < right; }
+  static CmpBool Virtual(const Value &left, const Value &right) {
+    return left.CompareLessThan(right);
+  }
+};
+
+struct GreaterThan {
+  template <class L, class R>
+  static inline bool Apply(L left, R right) { return left > right; }
+  static CmpBool Virtual(const Value &left, const Value &right) {
+    return left.CompareGreaterThan(right);
+  }
+};
+
+struct LessThanEquals {
+  template <class L, class R>
+  static inline bool Apply(L left, R right) { return left <= right; }
+  static CmpBool Virtual(const Value &left, const Value &right) {
+    return left.CompareLessThanEquals(right);
+  }
+};
+
+struct GreaterThanEquals {
+  template <class L, class R>
+  static inline bool Apply(L left, R right) { return left >= right; }
+  static CmpBool Virtual(const Value &left, const Value &right) {
+    return left.CompareGreaterThanEquals(right);
+  }
+};
+
+// Integers of different widths and decimals compare as their common type,
+// the way the numeric types compare them
+template <class Op, class L, class R>
+CmpBool CompareNative(const Value &left, const Value &right) {
+  if (left.IsNull() || right.IsNull()) return CMP_NULL;
+  return GetCmpBool(Op::Apply(left.GetAs<L>(), right.GetAs<R>()));
+}
+
+template <class Op>
+CmpBool CompareVarlen(const Value &left, const Value &right) {
+  if (left.IsNull() || right.IsNull()) return CMP_NULL;
+  return GetCmpBool(
+      Op::Apply(ValueRef(left).CompareVarlen(ValueRef(right)), 0));
+}
+
+template <class Op>
+CmpBool CompareVirtual(const Value &left, const Value &right) {
+  return Op::Virtual(left, right);
+}
+
+const int kCompareCount = 6;
+const int kTypeCount = TypeId::UDT + 1;
+
+class CompareTable {
+ public:
+  CompareTable() {
+    Fill<Equal>(0);
+    Fill<NotEqual>(1);
+    Fill<LessThan>(2);
+    Fill<GreaterThan>(3);
+    Fill<LessThanEquals>(4);
+    Fill<GreaterThanEquals>(5);
+  }
+
+  ValueDispatch::CompareFunction Get(int compare, TypeId left,
+                                     TypeId right) const {
+    return functions_[compare][left][right];
+  }
+
+ private:
+  template <class Op>
+  void Fill(int compare) {
+    for (int left = 0; left < kTypeCount; left++) {
+      for (int right = 0; right < kTypeCount; right++) {
+        functions_[compare][left][right] = &CompareVirtual<Op>;
+      }
+    }
+    FillNumeric<Op, int8_t>(compare, TypeId::TINYINT);
+    FillNumeric<Op, int16_t>(compare, TypeId::SMALLINT);
+    FillNumeric<Op, int32_t>(compare, TypeId::INTEGER);
+    FillNumeric<Op, int64_t>(compare, TypeId::BIGINT);
+    FillNumeric<Op, double>(compare, TypeId::DECIMAL);
+    Set(compare, TypeId::BOOLEAN, TypeId::BOOLEAN,
+        &CompareNative<Op, int8_t, int8_t>);
+    Set(compare, TypeId::TIMESTAMP, TypeId::TIMESTAMP,
+        &CompareNative<Op, uint64_t, uint64_t>);
+    Set(compare, TypeId::DATE, TypeId::DATE,
+        &CompareNative<Op, uint32_t, uint32_t>);
+    Set(compare, TypeId::VARCHAR, TypeId::VARCHAR, &CompareVarlen<Op>);
+  }
+
+  template <class Op, class L>
+  void FillNumeric(int compare, TypeId left) {
+    Set(compare, left, TypeId::TINYINT, &CompareNative<Op, L, int8_t>);
+    Set(compare, left, TypeId::SMALLINT, &CompareNative<Op, L, int16_t>);
+    Set(compare, left, TypeId::INTEGER, &CompareNative<Op, L, int32_t>);
+    Set(compare, left, TypeId::BIGINT, &CompareNative<Op, L, int64_t>);
+    Set(compare, left, TypeId::DECIMAL, &CompareNative<Op, L, double>);
+  }
+
+  void Set(int compare, TypeId left, TypeId right,
+           ValueDispatch::CompareFunction function) {
+    functions_[compare][left][right] = function;
+  }
+
+  ValueDispatch::CompareFunction functions_[kCompareCount][kTypeCount]
+                                           [kTypeCount];
+};
+
+}  // namespace
+
+ValueDispatch::CompareFunction ValueDispatch::GetCompareFunction(
+    ExpressionType compare_type, TypeId left_type, TypeId right_type) {
+  static const CompareTable table;
+  PL_ASSERT(left_type < kTypeCount && right_type < kTypeCount);
+  switch (compare_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return table.Get(0, left_type, right_type);
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return table.Get(1, left_type, right_type);
+    case ExpressionType::COMPARE_LESSTHAN:
+      return table.Get(2, left_type, right_type);
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return table.Get(3, left_type, right_type);
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return table.Get(4, left_type, right_type);
+    case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+      return table.Get(5, left_type, right_type);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace type
+}  // namespace peloton
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// value_ref.cpp
+//
+// Identification: src/type/value_ref.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/value_ref.h"
+
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace type {
+
+Value ValueRef::ToValue() const {
+  if (is_null_) {
+    return ValueFactory::GetNullValueByType(type_id_);
+  }
+  switch (type_id_) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      return Value(type_id_, GetAs<int8_t>());
+    case TypeId::SMALLINT:
+      return Value(type_id_, GetAs<int16_t>());
+    case TypeId::INTEGER:
+    case TypeId::PARAMETER_OFFSET:
+      return Value(type_id_, GetAs<int32_t>());
+    case TypeId::BIGINT:
+      return Value(type_id_, GetAs<int64_t>());
+    case TypeId::DECIMAL:
+      return Value(type_id_, GetAs<double>());
+    case TypeId::TIMESTAMP:
+      return Value(type_id_, GetAs<uint64_t>());
+    case TypeId::DATE:
+      return Value(type_id_, static_cast<int32_t>(GetAs<uint32_t>()));
+    case TypeId::VARCHAR:
+    case TypeId::VARBINARY:
+      return Value(type_id_, data_, len_, false);
+    default: {
+      std::string msg =
+          StringUtil::Format("Invalid Type '%s' for a value reference",
+                             TypeIdToString(type_id_).c_str());
+      throw Exception(EXCEPTION_TYPE_INCOMPATIBLE_TYPE, msg);
+    }
+  }
+}
+
+int ValueRef::CompareValues(const ValueRef &other) const {
+  Value left = ToValue();
+  Value right = other.ToValue();
+  if (left.CompareLessThan(right) == CMP_TRUE) return -1;
+  if (left.CompareGreaterThan(right) == CMP_TRUE) return 1;
+  return 0;
+}
+
+}  // namespace type
+}  // namespace peloton
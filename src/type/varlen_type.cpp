@@ -53,6 +53,9 @@ uint32_t VarlenType::GetLength(const Value &val) const { return val.size_.len; }
 
 // Access the raw varlen data stored from the tuple storage
 char *VarlenType::GetData(char *storage) {
+  if (IsInlineStorage(storage)) {
+    return nullptr;
+  }
   char *ptr = *reinterpret_cast<char **>(storage);
   return ptr;
 }
@@ -192,10 +195,40 @@ void VarlenType::SerializeTo(const Value &val, char *storage,
   *reinterpret_cast<const char **>(storage) = data;
 }
 
+bool VarlenType::SerializeInlineTo(const Value &val, char *storage) {
+  if (val.GetTypeId() != TypeId::VARCHAR &&
+      val.GetTypeId() != TypeId::VARBINARY) {
+    return false;
+  }
+  uint32_t len = val.size_.len;
+  if (len > kInlineCapacity) {
+    return false;
+  }
+  // Built aside, since the value may be the one in the slot already
+  char slot[kInlineCapacity + 1] = {};
+  slot[0] = static_cast<char>(len << 1 | 1);
+  PL_MEMCPY(slot + 1, val.value_.varlen, len);
+  PL_MEMCPY(storage, slot, sizeof(slot));
+  return true;
+}
+
+void VarlenType::SerializeToTile(const Value &val, char *storage, bool inlined,
+                                 AbstractPool *pool) {
+  if (!inlined && !val.IsNull() && SerializeInlineTo(val, storage)) {
+    return;
+  }
+  val.SerializeTo(storage, inlined, pool);
+}
+
 // Deserialize a value of the given type from the given storage space.
 Value VarlenType::DeserializeFrom(const char *storage,
                                   const bool inlined UNUSED_ATTRIBUTE,
                                   AbstractPool *pool UNUSED_ATTRIBUTE) const {
+  // Like the pool data, the value in the slot is not copied
+  if (IsInlineStorage(storage)) {
+    return Value(type_id_, GetInlineData(storage), GetInlineLength(storage),
+                 false);
+  }
   const char *ptr = *reinterpret_cast<const char *const *>(storage);
   if (ptr == nullptr) {
     return Value(type_id_, nullptr, 0, false);
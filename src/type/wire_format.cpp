@@ -0,0 +1,248 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wire_format.cpp
+//
+// Identification: src/type/wire_format.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "type/wire_format.h"
+
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace type {
+
+namespace {
+
+// The days from 1970-01-01 to 2000-01-01
+const int64_t kPostgresEpochDays = 10957;
+
+const int64_t kMicrosPerDay = 86400LL * 1000000LL;
+
+void AppendInt(uint64_t value, size_t len, std::vector<unsigned char> &bytes) {
+  for (size_t i = len; i > 0; i--) {
+    bytes.push_back(static_cast<unsigned char>(value >> (8 * (i - 1))));
+  }
+}
+
+uint64_t ReadInt(const unsigned char *data, size_t len) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < len; i++) {
+    value = (value << 8) | data[i];
+  }
+  return value;
+}
+
+// The days since 1970-01-01 of a date of the proleptic Gregorian calendar,
+// and the date of them
+int64_t DaysFromCivil(int64_t year, uint32_t month, uint32_t day) {
+  year -= month <= 2;
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  uint32_t year_of_era = static_cast<uint32_t>(year - era * 400);
+  uint32_t day_of_year =
+      (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  uint32_t day_of_era = year_of_era * 365 + year_of_era / 4 -
+                        year_of_era / 100 + day_of_year;
+  return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+void CivilFromDays(int64_t days, int64_t &year, uint32_t &month,
+                   uint32_t &day) {
+  days += 719468;
+  int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  uint32_t day_of_era = static_cast<uint32_t>(days - era * 146097);
+  uint32_t year_of_era = (day_of_era - day_of_era / 1460 +
+                          day_of_era / 36524 - day_of_era / 146096) /
+                         365;
+  uint32_t day_of_year =
+      day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  uint32_t month_index = (5 * day_of_year + 2) / 153;
+  day = day_of_year - (153 * month_index + 2) / 5 + 1;
+  month = month_index < 10 ? month_index + 3 : month_index - 9;
+  year = static_cast<int64_t>(year_of_era) + era * 400 + (month <= 2);
+}
+
+// A NUMERIC is a sign and base 10000 digits, the first of them weight digits
+// before the decimal point
+bool DecodeNumeric(const unsigned char *data, size_t len, double &result) {
+  if (len < 8) return false;
+  int16_t num_digits = static_cast<int16_t>(ReadInt(data, 2));
+  int16_t weight = static_cast<int16_t>(ReadInt(data + 2, 2));
+  uint16_t sign = static_cast<uint16_t>(ReadInt(data + 4, 2));
+  if (num_digits < 0 || len != 8 + 2 * static_cast<size_t>(num_digits)) {
+    return false;
+  }
+  if (sign == 0xC000) {
+    result = NAN;
+    return true;
+  }
+
+  result = 0;
+  for (int16_t digit_idx = 0; digit_idx < num_digits; digit_idx++) {
+    double digit = static_cast<double>(ReadInt(data + 8 + 2 * digit_idx, 2));
+    result += digit * std::pow(10000.0, weight - digit_idx);
+  }
+  if (sign == 0x4000) result = -result;
+  return true;
+}
+
+}  // namespace
+
+void WireFormat::Encode(const Value &value, int format,
+                        std::vector<unsigned char> &bytes) {
+  if (value.IsNull()) return;
+
+  if (format == kBinaryFormat) {
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        bytes.push_back(value.GetAs<int8_t>() != 0 ? 1 : 0);
+        return;
+      case TypeId::SMALLINT:
+        AppendInt(static_cast<uint16_t>(value.GetAs<int16_t>()), 2, bytes);
+        return;
+      case TypeId::INTEGER:
+        AppendInt(static_cast<uint32_t>(value.GetAs<int32_t>()), 4, bytes);
+        return;
+      case TypeId::BIGINT:
+        AppendInt(static_cast<uint64_t>(value.GetAs<int64_t>()), 8, bytes);
+        return;
+      case TypeId::DECIMAL: {
+        double decimal = value.GetAs<double>();
+        uint64_t bits;
+        std::memcpy(&bits, &decimal, sizeof(bits));
+        AppendInt(bits, 8, bytes);
+        return;
+      }
+      case TypeId::TIMESTAMP:
+        AppendInt(static_cast<uint64_t>(
+                      ToPostgresTimestamp(value.GetAs<uint64_t>())),
+                  8, bytes);
+        return;
+      default:
+        // Described as text
+        break;
+    }
+  }
+
+  std::string str = value.ToString();
+  bytes.insert(bytes.end(), str.begin(), str.end());
+}
+
+bool WireFormat::DecodeBinary(PostgresValueType type,
+                              const unsigned char *data, size_t len,
+                              Value &value) {
+  switch (type) {
+    case PostgresValueType::BOOLEAN:
+      if (len != 1) return false;
+      value = ValueFactory::GetBooleanValue(data[0] != 0);
+      return true;
+    case PostgresValueType::SMALLINT:
+      if (len != 2) return false;
+      value = ValueFactory::GetSmallIntValue(
+          static_cast<int16_t>(ReadInt(data, len)));
+      return true;
+    case PostgresValueType::INTEGER:
+      if (len != 4) return false;
+      value = ValueFactory::GetIntegerValue(
+          static_cast<int32_t>(ReadInt(data, len)));
+      return true;
+    case PostgresValueType::BIGINT:
+      if (len != 8) return false;
+      value = ValueFactory::GetBigIntValue(
+          static_cast<int64_t>(ReadInt(data, len)));
+      return true;
+    case PostgresValueType::REAL: {
+      if (len != 4) return false;
+      uint32_t bits = static_cast<uint32_t>(ReadInt(data, len));
+      float real;
+      std::memcpy(&real, &bits, sizeof(real));
+      value = ValueFactory::GetDecimalValue(real);
+      return true;
+    }
+    case PostgresValueType::DOUBLE: {
+      if (len != 8) return false;
+      uint64_t bits = ReadInt(data, len);
+      double decimal;
+      std::memcpy(&decimal, &bits, sizeof(decimal));
+      value = ValueFactory::GetDecimalValue(decimal);
+      return true;
+    }
+    case PostgresValueType::DECIMAL: {
+      double decimal;
+      if (DecodeNumeric(data, len, decimal) == false) return false;
+      value = ValueFactory::GetDecimalValue(decimal);
+      return true;
+    }
+    case PostgresValueType::TIMESTAMPS:
+    case PostgresValueType::TIMESTAMPS2:
+      if (len != 8) return false;
+      value = ValueFactory::GetTimestampValue(FromPostgresTimestamp(
+          static_cast<int64_t>(ReadInt(data, len))));
+      return true;
+    case PostgresValueType::TEXT:
+    case PostgresValueType::BPCHAR:
+    case PostgresValueType::VARCHAR:
+    case PostgresValueType::VARCHAR2:
+      value = ValueFactory::GetVarcharValue(
+          std::string(reinterpret_cast<const char *>(data), len));
+      return true;
+    case PostgresValueType::VARBINARY:
+      value = ValueFactory::GetVarbinaryValue(data, len, true);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// A timestamp packs its month, day, time zone, year, second of the day and
+// microsecond, see ValueFactory::CastAsTimestamp(). The time zone is ignored,
+// the columns are described as timestamps without time zone.
+int64_t WireFormat::ToPostgresTimestamp(uint64_t timestamp) {
+  uint64_t micros = timestamp % 1000000;
+  timestamp /= 1000000;
+  uint64_t seconds = timestamp % 100000;
+  timestamp /= 100000;
+  int64_t year = timestamp % 10000;
+  timestamp /= 10000;
+  timestamp /= 27;
+  uint32_t day = timestamp % 32;
+  uint32_t month = static_cast<uint32_t>(timestamp / 32);
+
+  int64_t days = DaysFromCivil(year, month, day) - kPostgresEpochDays;
+  return days * kMicrosPerDay +
+         static_cast<int64_t>(seconds * 1000000 + micros);
+}
+
+uint64_t WireFormat::FromPostgresTimestamp(int64_t micros) {
+  int64_t days = micros / kMicrosPerDay;
+  int64_t micros_of_day = micros % kMicrosPerDay;
+  if (micros_of_day < 0) {
+    days--;
+    micros_of_day += kMicrosPerDay;
+  }
+
+  int64_t year;
+  uint32_t month, day;
+  CivilFromDays(days + kPostgresEpochDays, year, month, day);
+
+  // UTC is stored as the time zone 12 hours after the earliest
+  uint64_t timestamp = month;
+  timestamp = timestamp * 32 + day;
+  timestamp = timestamp * 27 + 12;
+  timestamp = timestamp * 10000 + static_cast<uint64_t>(year);
+  timestamp = timestamp * 100000 + micros_of_day / 1000000;
+  return timestamp * 1000000 + micros_of_day % 1000000;
+}
+
+}  // namespace type
+}  // namespace peloton
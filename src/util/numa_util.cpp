@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// numa_util.cpp
+//
+// Identification: src/util/numa_util.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "util/numa_util.h"
+
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "common/logger.h"
+
+// Memory policy from <numaif.h>
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+namespace peloton {
+
+static const std::string kNodeDirectory = "/sys/devices/system/node/";
+
+int NumaUtil::GetNodeCount() {
+  static const int node_count = [] {
+    std::ifstream online(kNodeDirectory + "online");
+    std::string list;
+    if (!(online >> list)) {
+      return 1;
+    }
+    auto nodes = ParseList(list);
+    return nodes.empty() ? 1 : nodes.back() + 1;
+  }();
+  return node_count;
+}
+
+int NumaUtil::GetCurrentNode() {
+  if (GetNodeCount() == 1) {
+    return 0;
+  }
+
+  unsigned cpu = 0, node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+  return static_cast<int>(node);
+}
+
+std::vector<int> NumaUtil::GetNodeCpus(const int node) {
+  std::ifstream cpu_list_file(kNodeDirectory + "node" + std::to_string(node) +
+                              "/cpulist");
+  std::string list;
+  if (!(cpu_list_file >> list)) {
+    return std::vector<int>();
+  }
+  return ParseList(list);
+}
+
+bool NumaUtil::BindThreadToNode(const int node) {
+  auto cpus = GetNodeCpus(node);
+  if (cpus.empty()) {
+    return false;
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &cpu_set);
+  }
+
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    LOG_DEBUG("Could not bind thread to node %d", node);
+    return false;
+  }
+  return true;
+}
+
+bool NumaUtil::BindThreadToCpu(const int cpu) {
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return false;
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    LOG_DEBUG("Could not bind thread to cpu %d", cpu);
+    return false;
+  }
+  return true;
+}
+
+bool NumaUtil::BindMemoryToNode(void *address, const size_t size,
+                                const int node) {
+  if (node < 0 || GetNodeCount() == 1) {
+    return false;
+  }
+
+  const size_t bits_per_word = sizeof(unsigned long) * 8;
+  std::vector<unsigned long> node_mask(node / bits_per_word + 1, 0);
+  node_mask[node / bits_per_word] |= 1UL << (node % bits_per_word);
+
+  // the kernel expects the mask size in bits, plus one
+  auto status =
+      syscall(SYS_mbind, address, size, MPOL_PREFERRED, node_mask.data(),
+              node_mask.size() * bits_per_word + 1, 0);
+  if (status != 0) {
+    LOG_DEBUG("Could not bind memory %p to node %d", address, node);
+    return false;
+  }
+  return true;
+}
+
+std::vector<int> NumaUtil::ParseList(const std::string &list) {
+  std::vector<int> items;
+  std::istringstream stream(list);
+  std::string range;
+
+  while (std::getline(stream, range, ',')) {
+    if (range.empty()) {
+      continue;
+    }
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = (dash == std::string::npos) ? first
+                                           : std::stoi(range.substr(dash + 1));
+    for (int item = first; item <= last; item++) {
+      items.push_back(item);
+    }
+  }
+
+  return items;
+}
+
+}  // End peloton namespace
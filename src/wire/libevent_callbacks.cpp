@@ -58,6 +58,17 @@ void WorkerHandleNewConn(evutil_socket_t new_conn_recv_fd,
       break;
     }
 
+    /* executed packet case */
+    case 'e': {
+      // resume the connection whose packet has been processed
+      thread->executed_conn_queue.Dequeue(item);
+      conn = LibeventServer::GetConn(item->new_conn_fd);
+      PL_ASSERT(conn != nullptr && conn->state == CONN_EXECUTING);
+      conn->TransitState(item->init_state);
+      StateMachine(conn);
+      break;
+    }
+
     default:
       LOG_ERROR("Unexpected message. Shouldn't reach here");
   }
@@ -80,15 +91,25 @@ void StateMachine(LibeventSocket *conn) {
     LOG_TRACE("current state: %d", conn->state);
     switch (conn->state) {
       case CONN_LISTENING: {
-        struct sockaddr_storage addr;
-        socklen_t addrlen = sizeof(addr);
-        int new_conn_fd =
-            accept(conn->sock_fd, (struct sockaddr *)&addr, &addrlen);
-        if (new_conn_fd == -1) {
-          LOG_ERROR("Failed to accept");
+        // Accept all the pending connections, many clients reconnect at once
+        // e.g. after a failover
+        while (true) {
+          struct sockaddr_storage addr;
+          socklen_t addrlen = sizeof(addr);
+          int new_conn_fd =
+              accept(conn->sock_fd, (struct sockaddr *)&addr, &addrlen);
+          if (new_conn_fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+              continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+              LOG_ERROR("Failed to accept: %d", errno);
+            }
+            break;
+          }
+          (static_cast<LibeventMasterThread *>(conn->thread))
+              ->DispatchConnection(new_conn_fd, EV_READ | EV_PERSIST);
         }
-        (static_cast<LibeventMasterThread *>(conn->thread))
-            ->DispatchConnection(new_conn_fd, EV_READ | EV_PERSIST);
         done = true;
         break;
       }
@@ -179,10 +200,33 @@ void StateMachine(LibeventSocket *conn) {
           else if (status_res == -1){
             conn->pkt_manager.ssl_sent = true;
           }
+        } else if (LibeventExecutionPool::GetInstance().IsEnabled()) {
+          // Stop listening to the socket while the packet is processed
+          // elsewhere, the thread resumes once it is (see WorkerHandleNewConn)
+          conn->RemoveEvent();
+          conn->TransitState(CONN_EXECUTING);
+          LibeventExecutionPool::GetInstance().ProcessPacket(conn);
+          done = true;
+          break;
         } else {
           // Process all other packets
           status = conn->pkt_manager.ProcessPacket(&conn->rpkt,
                                                    (size_t)conn->thread_id);
+
+          // The responses to the commits are sent once these are durable. The
+          // connection is resumed on this thread then, as it is after an
+          // execution thread, so it cannot be resumed before it waits.
+          auto *thread = static_cast<LibeventWorkerThread *>(conn->thread);
+          int conn_fd = conn->sock_fd;
+          ConnState next_state = status ? CONN_WRITE : CONN_CLOSING;
+          if (conn->pkt_manager.OnCommitsDurable([thread, conn_fd, next_state] {
+                thread->ResumeConnection(conn_fd, next_state);
+              }) == true) {
+            conn->RemoveEvent();
+            conn->TransitState(CONN_EXECUTING);
+            done = true;
+            break;
+          }
         }
 
         if (status == false) {
@@ -228,6 +272,7 @@ void StateMachine(LibeventSocket *conn) {
         break;
       }
 
+      case CONN_EXECUTING:
       case CONN_CLOSED: {
         done = true;
         break;
@@ -36,7 +36,14 @@ LibeventServer::GetGlobalSocketList() {
   return global_socket_list;
 }
 
+std::mutex &LibeventServer::GetGlobalSocketListMutex() {
+  static std::mutex global_socket_list_mutex;
+  return global_socket_list_mutex;
+}
+
 LibeventSocket *LibeventServer::GetConn(const int &connfd) {
+  // The worker threads add connections concurrently
+  std::lock_guard<std::mutex> lock(GetGlobalSocketListMutex());
   auto &global_socket_list = GetGlobalSocketList();
   if (global_socket_list.find(connfd) != global_socket_list.end()) {
     return global_socket_list.at(connfd).get();
@@ -48,6 +55,7 @@ LibeventSocket *LibeventServer::GetConn(const int &connfd) {
 void LibeventServer::CreateNewConn(const int &connfd, short ev_flags,
                                    LibeventThread *thread,
                                    ConnState init_state) {
+  std::lock_guard<std::mutex> lock(GetGlobalSocketListMutex());
   auto &global_socket_list = GetGlobalSocketList();
   recent_connfd = connfd;
   if (global_socket_list.find(connfd) == global_socket_list.end()) {
@@ -115,7 +123,8 @@ void LibeventServer::StartServer() {
       throw ConnectionException("Failed to create listen socket");
     }
 
-    int conn_backlog = 12;
+    // Queue up a reconnect storm in the kernel rather than refusing it
+    int conn_backlog = SOMAXCONN;
     int reuse = 1;
     setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
 
@@ -10,6 +10,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <poll.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include "wire/libevent_server.h"
 
@@ -29,6 +31,7 @@ void LibeventSocket::Init(short event_flags, LibeventThread *thread,
 
   // clear out packet
   rpkt.Reset();
+  pkt_manager.flush_responses = [this]() { return FlushResponses(); };
   if (event == nullptr) {
     event = event_new(thread->GetEventBase(), sock_fd, event_flags,
                       EventHandler, this);
@@ -48,6 +51,7 @@ void LibeventSocket::Init(short event_flags, LibeventThread *thread,
     }
   }
   event_add(event, nullptr);
+  listen_flags_ = event_flags;
 }
 
 void LibeventSocket::TransitState(ConnState next_state) {
@@ -58,11 +62,18 @@ void LibeventSocket::TransitState(ConnState next_state) {
 
 // Update event
 bool LibeventSocket::UpdateEvent(short flags) {
+  // A persistent event stays added, there's no need to re-add it after every
+  // packet
+  if (flags == listen_flags_ && (flags & EV_PERSIST) != 0) {
+    return true;
+  }
+
   auto base = thread->GetEventBase();
   if (event_del(event) == -1) {
     LOG_ERROR("Failed to delete event");
     return false;
   }
+  listen_flags_ = 0;
   auto result =
       event_assign(event, base, sock_fd, flags, EventHandler, (void *)this);
 
@@ -77,10 +88,16 @@ bool LibeventSocket::UpdateEvent(short flags) {
     LOG_ERROR("Failed to add event");
     return false;
   }
+  listen_flags_ = flags;
 
   return true;
 }
 
+void LibeventSocket::RemoveEvent() {
+  event_del(event);
+  listen_flags_ = 0;
+}
+
 void LibeventSocket::GetSizeFromPktHeader(size_t start_index) {
   rpkt.len = 0;
   // directly converts from network byte order to little-endian
@@ -170,6 +187,29 @@ bool LibeventSocket::ReadPacket() {
   return true;
 }
 
+bool LibeventSocket::ReadBufferedPacket() {
+  size_t header_size = sizeof(int32_t) + 1;
+  if (pkt_manager.is_started == false ||
+      IsReadDataAvailable(header_size) == false) {
+    return false;
+  }
+
+  size_t len = 0;
+  for (size_t i = rbuf_.buf_ptr + 1; i < rbuf_.buf_ptr + header_size; i++) {
+    len = (len << 8) | rbuf_.GetByte(i);
+  }
+  len -= sizeof(int32_t);
+  if (len > rbuf_.GetMaxSize() ||
+      IsReadDataAvailable(header_size + len) == false) {
+    return false;
+  }
+
+  rpkt.Reset();
+  ReadPacketHeader();
+  ReadPacket();
+  return true;
+}
+
 /**
  * Public Functions
  */
@@ -187,7 +227,7 @@ WriteState LibeventSocket::WritePackets() {
   }
 
   // Done writing all packets. clear packets
-  pkt_manager.responses.clear();
+  pkt_manager.RecycleResponses();
   next_response_ = 0;
 
   if (pkt_manager.force_flush == true) {
@@ -196,6 +236,28 @@ WriteState LibeventSocket::WritePackets() {
   return WRITE_COMPLETE;
 }
 
+bool LibeventSocket::FlushResponses() {
+  pkt_manager.force_flush = true;
+  while (true) {
+    switch (WritePackets()) {
+      case WRITE_COMPLETE:
+        return true;
+      case WRITE_NOT_READY: {
+        // Block the execution until the client has read enough, instead of
+        // buffering more of the result
+        struct pollfd poll_fd = {sock_fd, POLLOUT, 0};
+        if (poll(&poll_fd, 1, -1) < 0 && errno != EINTR) {
+          LOG_ERROR("Error waiting to write: %d", errno);
+          return false;
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+}
+
 ReadState LibeventSocket::FillReadBuffer() {
   ReadState result = READ_NO_DATA_RECEIVED;
   ssize_t bytes_read = 0;
@@ -358,8 +420,12 @@ WriteState LibeventSocket::FlushWriteBuffer() {
           // Write would have blocked if the socket was
           // in blocking mode. Wait till it's readable
         } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
-          // Listen for socket being enabled for write
-          UpdateEvent(EV_WRITE | EV_PERSIST);
+          // Listen for socket being enabled for write. The events of the
+          // connection belong to its thread, a statement being executed
+          // elsewhere waits in FlushResponses() instead.
+          if (state != CONN_EXECUTING) {
+            UpdateEvent(EV_WRITE | EV_PERSIST);
+          }
           // We should go to CONN_WRITE state
           return WRITE_NOT_READY;
         } else {
@@ -437,7 +503,7 @@ WriteState LibeventSocket::BufferWriteBytesHeader(OutputPacket *pkt) {
 
   // move the write buffer pointer and update size of the socket buffer
   wbuf_.buf_ptr += sizeof(int32_t);
-  wbuf_.buf_size = wbuf_.buf_ptr;
+  wbuf_.buf_size = wbuf_.buf_ptr - wbuf_.buf_flush_ptr;
 
   // Header is written to socket buf. No need to write it in the future
   pkt->skip_header_write = true;
@@ -450,7 +516,7 @@ WriteState LibeventSocket::BufferWriteBytesContent(OutputPacket *pkt) {
   // the packet content to write
   ByteBuf &pkt_buf = pkt->buf;
   // the length of remaining content to write
-  size_t len = pkt->len;
+  size_t len = pkt->len - pkt->write_ptr;
   // window is the size of remaining space in socket's wbuf
   size_t window = 0;
 
@@ -458,15 +524,22 @@ WriteState LibeventSocket::BufferWriteBytesContent(OutputPacket *pkt) {
   while (len) {
     // calculate the remaining space in wbuf
     window = wbuf_.GetMaxSize() - wbuf_.buf_ptr;
+    if (len > window && len >= wbuf_.GetMaxSize() &&
+        conn_SSL_context == nullptr) {
+      // contents larger than the socket buffer are written straight from the
+      // packet, rather than copied through the buffer
+      return WritevContent(pkt);
+    }
     if (len <= window) {
       // contents fit in the window, range copy "len" bytes
       std::copy(std::begin(pkt_buf) + pkt->write_ptr,
                 std::begin(pkt_buf) + pkt->write_ptr + len,
                 std::begin(wbuf_.buf) + wbuf_.buf_ptr);
 
-      // Move the cursor and update size of socket buffer
+      // Move the cursors and update size of socket buffer
+      pkt->write_ptr += len;
       wbuf_.buf_ptr += len;
-      wbuf_.buf_size = wbuf_.buf_ptr;
+      wbuf_.buf_size = wbuf_.buf_ptr - wbuf_.buf_flush_ptr;
       LOG_TRACE("Content fit in window. Write content successful");
       return WRITE_COMPLETE;
     } else {
@@ -481,7 +554,8 @@ WriteState LibeventSocket::BufferWriteBytesContent(OutputPacket *pkt) {
       pkt->write_ptr += window;
       len -= window;
       // Now the wbuf is full
-      wbuf_.buf_size = wbuf_.GetMaxSize();
+      wbuf_.buf_ptr = wbuf_.GetMaxSize();
+      wbuf_.buf_size = wbuf_.buf_ptr - wbuf_.buf_flush_ptr;
 
       LOG_TRACE("Content doesn't fit in window. Try flushing");
       auto result = FlushWriteBuffer();
@@ -495,11 +569,55 @@ WriteState LibeventSocket::BufferWriteBytesContent(OutputPacket *pkt) {
   return WRITE_COMPLETE;
 }
 
+WriteState LibeventSocket::WritevContent(OutputPacket *pkt) {
+  while (pkt->write_ptr < pkt->len) {
+    // the buffered bytes go first, then the rest of the packet
+    struct iovec iov[2];
+    int iovcnt = 0;
+    if (wbuf_.buf_size > 0) {
+      iov[iovcnt].iov_base = wbuf_.GetPtr(wbuf_.buf_flush_ptr);
+      iov[iovcnt].iov_len = wbuf_.buf_size;
+      iovcnt++;
+    }
+    iov[iovcnt].iov_base = &pkt->buf[pkt->write_ptr];
+    iov[iovcnt].iov_len = pkt->len - pkt->write_ptr;
+    iovcnt++;
+
+    ssize_t written_bytes = writev(sock_fd, iov, iovcnt);
+    if (written_bytes < 0) {
+      if (errno == EINTR) {
+        continue;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // See FlushWriteBuffer()
+        if (state != CONN_EXECUTING) {
+          UpdateEvent(EV_WRITE | EV_PERSIST);
+        }
+        return WRITE_NOT_READY;
+      }
+      LOG_ERROR("Fatal error during write");
+      return WRITE_ERROR;
+    }
+
+    size_t buffered_bytes =
+        std::min(static_cast<size_t>(written_bytes), wbuf_.buf_size);
+    wbuf_.buf_flush_ptr += buffered_bytes;
+    wbuf_.buf_size -= buffered_bytes;
+    pkt->write_ptr += written_bytes - buffered_bytes;
+  }
+
+  // the buffered bytes have all been written
+  wbuf_.Reset();
+  return WRITE_COMPLETE;
+}
+
 void LibeventSocket::CloseSocket() {
   LOG_DEBUG("Attempt to close the connection %d", sock_fd);
   // Remove listening event
-  event_del(event);
+  RemoveEvent();
   // event_free(event);
+  if (state != CONN_LISTENING) {
+    thread->RemoveConnection();
+  }
 
   TransitState(CONN_CLOSED);
   Reset();
@@ -22,6 +22,82 @@
 namespace peloton {
 namespace wire {
 
+std::atomic<int> LibeventThread::total_conn_count_(0);
+
+/*
+ * Resume a connection on the worker thread
+ */
+void LibeventWorkerThread::ResumeConnection(int conn_fd,
+                                            ConnState next_state) {
+  char buf[1];
+  buf[0] = 'e';
+  std::shared_ptr<NewConnQueueItem> item(
+      new NewConnQueueItem(conn_fd, EV_READ | EV_PERSIST, next_state));
+  executed_conn_queue.Enqueue(item);
+
+  if (write(GetNewConnSendFd(), buf, 1) != 1) {
+    LOG_ERROR("Failed to write to thread notify pipe");
+  }
+}
+
+LibeventExecutionPool &LibeventExecutionPool::GetInstance() {
+  static LibeventExecutionPool execution_pool;
+  return execution_pool;
+}
+
+void LibeventExecutionPool::ProcessPacket(LibeventSocket *conn) {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  if (pool_ == nullptr) {
+    pool_.reset(new ThreadPool());
+    pool_->Initialize(FLAGS_execution_threads, 0);
+  }
+  pool_->SubmitTask([this, conn]() { ExecutePacket(conn); });
+}
+
+void LibeventExecutionPool::Shutdown() {
+  std::unique_ptr<ThreadPool> pool;
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    pool = std::move(pool_);
+  }
+  if (pool != nullptr) {
+    pool->Shutdown();
+    next_thread_id_ = 0;
+  }
+}
+
+void LibeventExecutionPool::ExecutePacket(LibeventSocket *conn) {
+  static thread_local size_t thread_id = RegisterThread();
+
+  // The worker thread does not touch the connection until it's resumed. The
+  // packets pipelined behind this one are processed right away until their
+  // responses have to be sent, e.g. at a Sync, rather than handing each of
+  // them back and forth between the threads.
+  bool status = conn->pkt_manager.ProcessPacket(&conn->rpkt, thread_id);
+  while (status == true && conn->pkt_manager.force_flush == false &&
+         conn->ReadBufferedPacket() == true) {
+    status = conn->pkt_manager.ProcessPacket(&conn->rpkt, thread_id);
+  }
+  // The responses to the commits are sent once these are durable
+  auto *thread = static_cast<LibeventWorkerThread *>(conn->thread);
+  int conn_fd = conn->sock_fd;
+  ConnState next_state = status ? CONN_WRITE : CONN_CLOSING;
+  if (conn->pkt_manager.OnCommitsDurable([thread, conn_fd, next_state] {
+        thread->ResumeConnection(conn_fd, next_state);
+      }) == false) {
+    thread->ResumeConnection(conn_fd, next_state);
+  }
+}
+
+size_t LibeventExecutionPool::RegisterThread() {
+  size_t thread_id = CONNECTION_THREAD_COUNT + next_thread_id_++;
+  if (concurrency::EpochManagerFactory::GetEpochType() ==
+      EpochType::DECENTRALIZED_EPOCH) {
+    concurrency::EpochManagerFactory::GetInstance().RegisterThread(thread_id);
+  }
+  return thread_id;
+}
+
 /*
  * Get the vector of libevent worker threads
  */
@@ -116,7 +192,9 @@ void LibeventMasterThread::StartWorker(LibeventWorkerThread *worker_thread) {
 * constructor.
 */
 LibeventWorkerThread::LibeventWorkerThread(const int thread_id)
-    : LibeventThread(thread_id, event_base_new()), new_conn_queue(QUEUE_SIZE) {
+    : LibeventThread(thread_id, event_base_new()),
+      new_conn_queue(QUEUE_SIZE),
+      executed_conn_queue(QUEUE_SIZE) {
   int fds[2];
   if (pipe(fds)) {
     LOG_ERROR("Can't create notify pipe to accept connections");
@@ -153,13 +231,23 @@ void LibeventMasterThread::DispatchConnection(int new_conn_fd,
   buf[0] = 'c';
   auto &threads = GetWorkerThreads();
 
-  // Dispatch by rand number
+  // Dispatch to the thread with the fewest open connections, so that long
+  // lived connections don't pile up on a thread. The search starts after
+  // the last thread to spread the ties round-robin.
   int thread_id = next_thread_id_;
+  for (int offset = 1; offset < num_threads_; offset++) {
+    int candidate = (next_thread_id_ + offset) % num_threads_;
+    if (threads[candidate]->GetConnectionCount() <
+        threads[thread_id]->GetConnectionCount()) {
+      thread_id = candidate;
+    }
+  }
 
   // update next threadID
-  next_thread_id_ = (next_thread_id_ + 1) % num_threads_;
+  next_thread_id_ = (thread_id + 1) % num_threads_;
 
   std::shared_ptr<LibeventWorkerThread> worker_thread = threads[thread_id];
+  worker_thread->AddConnection();
   LOG_DEBUG("Dispatching connection to worker %d", thread_id);
 
   std::shared_ptr<NewConnQueueItem> item(
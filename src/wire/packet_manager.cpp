@@ -17,15 +17,24 @@
 
 #include "common/cache.h"
 #include "common/macros.h"
+#include "catalog/catalog.h"
 #include "common/portal.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "optimizer/plan_cache.h"
+#include "parser/copy_statement.h"
+#include "parser/postgresparser.h"
 #include "planner/abstract_plan.h"
 #include "planner/delete_plan.h"
 #include "planner/insert_plan.h"
 #include "planner/update_plan.h"
+#include "statistics/backend_stats_context.h"
 #include "tcop/tcop.h"
+#include "tcop/tcop_pool.h"
 #include "type/types.h"
 #include "type/value.h"
 #include "type/value_factory.h"
+#include "type/wire_format.h"
 #include "wire/marshal.h"
 
 #define SSL_MESSAGE_VERNO 80877103
@@ -57,8 +66,9 @@ std::vector<PacketManager *> PacketManager::packet_managers_;
 std::mutex PacketManager::packet_managers_mutex_;
 
 PacketManager::PacketManager()
-    : txn_state_(NetworkTransactionStateType::IDLE), pkt_cntr_(0) {
-  traffic_cop_.reset(new tcop::TrafficCop());
+    : txn_state_(NetworkTransactionStateType::IDLE),
+      pkt_cntr_(0),
+      commit_waiter_(std::make_shared<logging::CommitWaiter>()) {
   {
     std::lock_guard<std::mutex> lock(PacketManager::packet_managers_mutex_);
     PacketManager::packet_managers_.push_back(this);
@@ -68,6 +78,8 @@ PacketManager::PacketManager()
 }
 
 PacketManager::~PacketManager() {
+  CloseCopyIn(false);
+  UnbindTrafficCop();
   {
     std::lock_guard<std::mutex> lock(PacketManager::packet_managers_mutex_);
     PacketManager::packet_managers_.erase(
@@ -118,7 +130,7 @@ void PacketManager::ReplanPreparedStatement(Statement *statement) {
 
 void PacketManager::MakeHardcodedParameterStatus(
     const std::pair<std::string, std::string> &kv) {
-  std::unique_ptr<OutputPacket> response(new OutputPacket());
+  auto response = NewPacket();
   response->msg_type = NetworkMessageType::PARAMETER_STATUS;
   PacketPutString(response.get(), kv.first);
   PacketPutString(response.get(), kv.second);
@@ -131,7 +143,7 @@ void PacketManager::MakeHardcodedParameterStatus(
  */
 int PacketManager::ProcessInitialPacket(InputPacket *pkt) {
   std::string token, value;
-  std::unique_ptr<OutputPacket> response(new OutputPacket());
+  auto response = NewPacket();
 
   int32_t proto_version = PacketGetInt(pkt, sizeof(int32_t));
   LOG_INFO("protocol version: %d", proto_version);
@@ -158,7 +170,7 @@ int PacketManager::ProcessInitialPacket(InputPacket *pkt) {
 
 bool PacketManager::ProcessStartupPacket(InputPacket* pkt, int32_t proto_version) {
   std::string token, value;
-  std::unique_ptr<OutputPacket> response(new OutputPacket());
+  auto response = NewPacket();
 
   // Only protocol version 3 is supported
   if (PROTO_MAJOR_VERSION(proto_version) != 3) {
@@ -211,7 +223,7 @@ bool PacketManager::ProcessStartupPacket(InputPacket* pkt, int32_t proto_version
 
 bool PacketManager::ProcessSSLRequestPacket(InputPacket *pkt) {
   UNUSED(pkt);
-  std::unique_ptr<OutputPacket> response(new OutputPacket());
+  auto response = NewPacket();
   // TODO: consider more about a proper response
   response->msg_type = NetworkMessageType::SSL_YES;
   responses.push_back(std::move(response));
@@ -220,13 +232,15 @@ bool PacketManager::ProcessSSLRequestPacket(InputPacket *pkt) {
 }
 
 void PacketManager::PutTupleDescriptor(
-    const std::vector<FieldInfo> &tuple_descriptor) {
+    const std::vector<FieldInfo> &tuple_descriptor,
+    const std::vector<int> *result_format) {
   if (tuple_descriptor.empty()) return;
 
-  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  auto pkt = NewPacket();
   pkt->msg_type = NetworkMessageType::ROW_DESCRIPTION;
   PacketPutInt(pkt.get(), tuple_descriptor.size(), 2);
 
+  size_t column_idx = 0;
   for (auto col : tuple_descriptor) {
     PacketPutString(pkt.get(), std::get<0>(col));
     // TODO: Table Oid (int32)
@@ -239,21 +253,32 @@ void PacketManager::PutTupleDescriptor(
     PacketPutInt(pkt.get(), std::get<2>(col), 2);
     // Type modifier (int32)
     PacketPutInt(pkt.get(), -1, 4);
-    // Format code for text
-    PacketPutInt(pkt.get(), 0, 2);
+    // Format code
+    int format = type::WireFormat::kTextFormat;
+    if (result_format != nullptr && column_idx < result_format->size()) {
+      format = (*result_format)[column_idx];
+    }
+    PacketPutInt(pkt.get(), format, 2);
+    column_idx++;
   }
   responses.push_back(std::move(pkt));
 }
 
 void PacketManager::SendDataRows(std::vector<StatementResult> &results,
-                                 int colcount, int &rows_affected) {
+                                 int colcount, int &rows_affected,
+                                 size_t first_row, size_t max_rows) {
   if (results.empty() || colcount == 0) return;
 
   size_t numrows = results.size() / colcount;
+  size_t last_row = numrows;
+  if (max_rows > 0) {
+    last_row = std::min(numrows, first_row + max_rows);
+  }
+  first_row = std::min(first_row, last_row);
 
   // 1 packet per row
-  for (size_t i = 0; i < numrows; i++) {
-    std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  for (size_t i = first_row; i < last_row; i++) {
+    auto pkt = NewPacket();
     pkt->msg_type = NetworkMessageType::DATA_ROW;
     PacketPutInt(pkt.get(), colcount, 2);
     for (int j = 0; j < colcount; j++) {
@@ -271,11 +296,109 @@ void PacketManager::SendDataRows(std::vector<StatementResult> &results,
     }
     responses.push_back(std::move(pkt));
   }
+  rows_affected = last_row - first_row;
+}
+
+void PacketManager::StartStreaming(bool send_descriptor) {
+  streamed_rows_ = 0;
+  stream_descriptor_ = send_descriptor;
+  if (FLAGS_result_chunk_rows == 0) return;
+
+  traffic_cop_->SetRowsCallback(
+      [this](const std::vector<FieldInfo> &tuple_descriptor,
+             std::vector<StatementResult> &results) {
+        StreamDataRows(tuple_descriptor, results);
+      });
+}
+
+void PacketManager::StopStreaming() { traffic_cop_->SetRowsCallback(nullptr); }
+
+void PacketManager::StreamDataRows(
+    const std::vector<FieldInfo> &tuple_descriptor,
+    std::vector<StatementResult> &results) {
+  if (stream_descriptor_ == true) {
+    if (copy_out_delimiter_ != 0) {
+      PutCopyResponse(NetworkMessageType::COPY_OUT_RESPONSE,
+                      tuple_descriptor.size());
+    } else {
+      PutTupleDescriptor(tuple_descriptor);
+    }
+    stream_descriptor_ = false;
+  }
+  int rows = 0;
+  if (copy_out_delimiter_ != 0) {
+    SendCopyData(results, tuple_descriptor.size(), rows);
+  } else {
+    SendDataRows(results, tuple_descriptor.size(), rows);
+  }
+  streamed_rows_ += rows;
+  results.clear();
+
+  // The execution waits here while the client is slow to read the rows. The
+  // responses to the statements whose commits are not durable yet stay
+  // buffered.
+  if (commit_waiter_->GetPendingCommitCount() > 0) return;
+  if (flush_responses && flush_responses() == false) {
+    // The connection is closed once the statement completes
+    LOG_DEBUG("Failed to send the rows of the statement");
+    responses.clear();
+  }
+}
+
+void PacketManager::SendPortalSuspended() {
+  auto response = NewPacket();
+  response->msg_type = NetworkMessageType::PORTAL_SUSPENDED;
+  responses.push_back(std::move(response));
+}
+
+void PacketManager::PutCopyResponse(NetworkMessageType msg_type,
+                                    size_t column_count) {
+  auto pkt = NewPacket();
+  pkt->msg_type = msg_type;
+  // text format for the COPY and each of its columns
+  PacketPutByte(pkt.get(), 0);
+  PacketPutInt(pkt.get(), column_count, 2);
+  for (size_t column_idx = 0; column_idx < column_count; column_idx++) {
+    PacketPutInt(pkt.get(), type::WireFormat::kTextFormat, 2);
+  }
+  responses.push_back(std::move(pkt));
+}
+
+void PacketManager::SendCopyData(std::vector<StatementResult> &results,
+                                 int colcount, int &rows_affected) {
+  rows_affected = 0;
+  if (results.empty() || colcount == 0) return;
+
+  // The lines are what COPY FROM reads back: NULL is an empty field, and
+  // backslashes, delimiters and line ends in a value are escaped
+  size_t numrows = results.size() / colcount;
+  std::vector<uchar> line;
+  for (size_t i = 0; i < numrows; i++) {
+    line.clear();
+    for (int j = 0; j < colcount; j++) {
+      if (j > 0) {
+        line.push_back(copy_out_delimiter_);
+      }
+      for (auto ch : results[i * colcount + j].second) {
+        if (ch == '\\' || ch == copy_out_delimiter_ || ch == '\n' ||
+            ch == '\r') {
+          line.push_back('\\');
+        }
+        line.push_back(ch);
+      }
+    }
+    line.push_back('\n');
+
+    auto pkt = NewPacket();
+    pkt->msg_type = NetworkMessageType::COPY_DATA;
+    PacketPutBytes(pkt.get(), line);
+    responses.push_back(std::move(pkt));
+  }
   rows_affected = numrows;
 }
 
 void PacketManager::CompleteCommand(const std::string &query, const QueryType& query_type, int rows) {
-  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  auto pkt = NewPacket();
   pkt->msg_type = NetworkMessageType::COMMAND_COMPLETE;
   std::string query_type_string;
   Statement::ParseQueryTypeString(query, query_type_string);
@@ -308,7 +431,7 @@ void PacketManager::CompleteCommand(const std::string &query, const QueryType& q
  * put_empty_query_response - Informs the client that an empty query was sent
  */
 void PacketManager::SendEmptyQueryResponse() {
-  std::unique_ptr<OutputPacket> response(new OutputPacket());
+  auto response = NewPacket();
   response->msg_type = NetworkMessageType::EMPTY_QUERY_RESPONSE;
   responses.push_back(std::move(response));
 }
@@ -344,6 +467,7 @@ bool PacketManager::HardcodedExecuteFilter(QueryType query_type) {
 // However, the multi-statement queries has been split by the psql client and
 // there is no need to split the query again.
 void PacketManager::ExecQueryMessage(InputPacket *pkt, const size_t thread_id) {
+  stats::QueryTraceScope query_trace;
   std::string query;
   PacketGetString(pkt, pkt->len, query);
 
@@ -366,6 +490,11 @@ void PacketManager::ExecQueryMessage(InputPacket *pkt, const size_t thread_id) {
     Statement::MapToQueryType(query_type_string_, query_type);
     std::stringstream stream(query_type_string_);
 
+    if (query_type == QueryType::QUERY_COPY &&
+        ExecCopyQuery(query, thread_id)) {
+      return;
+    }
+
     switch (query_type) {
       case QueryType::QUERY_PREPARE:
       {
@@ -435,12 +564,15 @@ void PacketManager::ExecQueryMessage(InputPacket *pkt, const size_t thread_id) {
         }
 
         if (param_values.size() > 0) {
+          stats::QueryPhaseTimer bind_timer(stats::QueryPhase::BIND);
           statement->GetPlanTree()->SetParameterValues(&param_values);
         }
 
+        StartStreaming(true);
         auto status =
                 traffic_cop_->ExecuteStatement(statement, param_values, unnamed, nullptr, result_format,
                              result, rows_affected, error_message, thread_id);
+        StopStreaming();
 
         if (status == ResultType::SUCCESS) {
           tuple_descriptor = statement->GetTupleDescriptor();
@@ -455,9 +587,11 @@ void PacketManager::ExecQueryMessage(InputPacket *pkt, const size_t thread_id) {
       default:
       {
         // execute the query using tcop
+        StartStreaming(true);
         auto status = traffic_cop_->ExecuteStatement(
             query, result, tuple_descriptor, rows_affected, error_message,
             thread_id);
+        StopStreaming();
 
       // check status
         if (status == ResultType::FAILURE) {
@@ -469,11 +603,19 @@ void PacketManager::ExecQueryMessage(InputPacket *pkt, const size_t thread_id) {
       }
     }
 
-    // send the attribute names
-    PutTupleDescriptor(tuple_descriptor);
+    stats::QueryPhaseTimer send_timer(stats::QueryPhase::SEND);
+    if (streamed_rows_ == 0) {
+      // send the attribute names
+      PutTupleDescriptor(tuple_descriptor);
 
-    // send the result rows
-    SendDataRows(result, tuple_descriptor.size(), rows_affected);
+      // send the result rows
+      SendDataRows(result, tuple_descriptor.size(), rows_affected);
+    } else {
+      // send the rows left over after the ones sent during the execution
+      int rows_left = 0;
+      SendDataRows(result, tuple_descriptor.size(), rows_left);
+      rows_affected = streamed_rows_ + rows_left;
+    }
 
     // The response to the SimpleQueryCommand is the query string.
     CompleteCommand(query, query_type, rows_affected);
@@ -513,7 +655,7 @@ void PacketManager::ExecParseMessage(InputPacket *pkt) {
     skipped_query_type_ = std::move(query_type);
 
     // Send Parse complete response
-    std::unique_ptr<OutputPacket> response(new OutputPacket());
+    auto response = NewPacket();
     response->msg_type = NetworkMessageType::PARSE_COMPLETE;
     responses.push_back(std::move(response));
     return;
@@ -525,8 +667,7 @@ void PacketManager::ExecParseMessage(InputPacket *pkt) {
   LOG_DEBUG("PrepareStatement[%s] => %s", statement_name.c_str(),
             query_string.c_str());
 
-  statement = traffic_cop_->PrepareStatement(statement_name, query_string,
-                                             error_message);
+  statement = PrepareStatement(statement_name, query_string, error_message);
   if (statement.get() == nullptr) {
     skipped_stmt_ = true;
     SendErrorResponse(
@@ -562,18 +703,9 @@ void PacketManager::ExecParseMessage(InputPacket *pkt) {
     }
   }
 
-  // Unnamed statement
-  if (unnamed_query) {
-    unnamed_statement_ = statement;
-  } else {
-    auto entry = std::make_pair(statement_name, statement);
-    statement_cache_.insert(entry);
-    for (auto table_id : statement->GetReferencedTables()) {
-      table_statement_cache_[table_id].push_back(statement.get());
-    }
-  }
+  CacheStatement(statement_name, statement);
   // Send Parse complete response
-  std::unique_ptr<OutputPacket> response(new OutputPacket());
+  auto response = NewPacket();
   response->msg_type = NetworkMessageType::PARSE_COMPLETE;
   responses.push_back(std::move(response));
 }
@@ -586,7 +718,7 @@ void PacketManager::ExecBindMessage(InputPacket *pkt) {
 
   if (skipped_stmt_) {
     // send bind complete
-    std::unique_ptr<OutputPacket> response(new OutputPacket());
+    auto response = NewPacket();
     response->msg_type = NetworkMessageType::BIND_COMPLETE;
     responses.push_back(std::move(response));
     return;
@@ -600,8 +732,11 @@ void PacketManager::ExecBindMessage(InputPacket *pkt) {
   auto format_buf_len = ReadParamFormat(pkt, num_params_format, formats);
 
   int num_params = PacketGetInt(pkt, 2);
-  // error handling
-  if (num_params_format != num_params) {
+  // A single format code applies to all parameters, none means text
+  if (num_params_format <= 1 && num_params > num_params_format) {
+    formats.assign(num_params, num_params_format == 0 ? 0 : formats[0]);
+  } else if (num_params_format != num_params) {
+    // error handling
     std::string error_message =
         "Malformed request: num_params_format is not equal to num_params";
     SendErrorResponse(
@@ -651,7 +786,7 @@ void PacketManager::ExecBindMessage(InputPacket *pkt) {
   if (HardcodedExecuteFilter(query_type) == false) {
     skipped_stmt_ = true;
     skipped_query_string_ = query_string;
-    std::unique_ptr<OutputPacket> response(new OutputPacket());
+    auto response = NewPacket();
     // Send Bind complete response
     response->msg_type = NetworkMessageType::BIND_COMPLETE;
     responses.push_back(std::move(response));
@@ -660,11 +795,23 @@ void PacketManager::ExecBindMessage(InputPacket *pkt) {
 
   // Check whether somebody wants us to generate a new query plan
   // for this prepared statement
+  if (statement->GetNeedsPlan() && FLAGS_plan_cache_size > 0) {
+    // Take the plan another connection has built already, if there is one
+    std::string error_message;
+    auto new_statement =
+        PrepareStatement(statement_name, query_string, error_message);
+    if (new_statement != nullptr) {
+      new_statement->SetParamTypes(statement->GetParamTypes());
+      CacheStatement(statement_name, new_statement);
+      statement = new_statement;
+    }
+  }
   if (statement->GetNeedsPlan()) {
     ReplanPreparedStatement(statement.get());
   }
 
   // Group the parameter types and the parameters in this vector
+  stats::QueryPhaseTimer bind_timer(stats::QueryPhase::BIND);
   std::vector<std::pair<int, std::string>> bind_parameters(num_params);
   std::vector<type::Value> param_values(num_params);
 
@@ -701,14 +848,25 @@ void PacketManager::ExecBindMessage(InputPacket *pkt) {
     // Instead of tree traversal, we should put param values in the
     // executor context.
   }
+  bind_timer.Stop();
 
   std::shared_ptr<stats::QueryMetric::QueryParams> param_stat(nullptr);
   if (FLAGS_stats_mode != STATS_TYPE_INVALID && num_params > 0) {
     // Make a copy of format for stat collection
     stats::QueryMetric::QueryParamBuf param_format_buf;
-    param_format_buf.len = format_buf_len;
-    param_format_buf.buf = PacketCopyBytes(format_buf_begin, format_buf_len);
-    PL_ASSERT(format_buf_len > 0);
+    if (num_params_format == num_params) {
+      param_format_buf.len = format_buf_len;
+      param_format_buf.buf = PacketCopyBytes(format_buf_begin, format_buf_len);
+      PL_ASSERT(format_buf_len > 0);
+    } else {
+      // Record the format code of every parameter
+      param_format_buf.len = num_params * sizeof(int16_t);
+      param_format_buf.buf = new uchar[param_format_buf.len];
+      for (int param_idx = 0; param_idx < num_params; param_idx++) {
+        param_format_buf.buf[2 * param_idx] = formats[param_idx] >> 8;
+        param_format_buf.buf[2 * param_idx + 1] = formats[param_idx] & 0xff;
+      }
+    }
 
     // Make a copy of value for stat collection
     stats::QueryMetric::QueryParamBuf param_val_buf;
@@ -736,7 +894,7 @@ void PacketManager::ExecBindMessage(InputPacket *pkt) {
     portals_.insert(std::make_pair(portal_name, portal_reference));
   }
   // send bind complete
-  std::unique_ptr<OutputPacket> response(new OutputPacket());
+  auto response = NewPacket();
   response->msg_type = NetworkMessageType::BIND_COMPLETE;
   responses.push_back(std::move(response));
 }
@@ -805,54 +963,22 @@ size_t PacketManager::ReadParamValue(
         PL_ASSERT(param_values[param_idx].GetTypeId() != type::TypeId::INVALID);
       } else {
         // BINARY mode
-        switch (static_cast<PostgresValueType>(param_types[param_idx])) {
-          case PostgresValueType::INTEGER: {
-            int int_val = 0;
-            for (size_t i = 0; i < sizeof(int); ++i) {
-              int_val = (int_val << 8) | param[i];
-            }
-            bind_parameters[param_idx] =
-                std::make_pair(type::TypeId::INTEGER, std::to_string(int_val));
-            param_values[param_idx] =
-                type::ValueFactory::GetIntegerValue(int_val).Copy();
-            break;
-          }
-          case PostgresValueType::BIGINT: {
-            int64_t int_val = 0;
-            for (size_t i = 0; i < sizeof(int64_t); ++i) {
-              int_val = (int_val << 8) | param[i];
-            }
-            bind_parameters[param_idx] =
-                std::make_pair(type::TypeId::BIGINT, std::to_string(int_val));
-            param_values[param_idx] =
-                type::ValueFactory::GetBigIntValue(int_val).Copy();
-            break;
-          }
-          case PostgresValueType::DOUBLE: {
-            double float_val = 0;
-            unsigned long buf = 0;
-            for (size_t i = 0; i < sizeof(double); ++i) {
-              buf = (buf << 8) | param[i];
-            }
-            PL_MEMCPY(&float_val, &buf, sizeof(double));
-            bind_parameters[param_idx] =
-                std::make_pair(type::TypeId::DECIMAL, std::to_string(float_val));
-            param_values[param_idx] =
-                type::ValueFactory::GetDecimalValue(float_val).Copy();
-            break;
-          }
-          case PostgresValueType::VARBINARY: {
-            bind_parameters[param_idx] = std::make_pair(
-                type::TypeId::VARBINARY,
-                std::string(reinterpret_cast<char *>(&param[0]), param_len));
-            param_values[param_idx] = type::ValueFactory::GetVarbinaryValue(
-                &param[0], param_len, true);
-            break;
-          }
-          default: {
-            LOG_ERROR("Do not support data type: %d", param_types[param_idx]);
-            break;
-          }
+        auto param_type = static_cast<PostgresValueType>(
+            (unsigned int)param_idx < param_types.size()
+                ? param_types[param_idx]
+                : static_cast<int32_t>(PostgresValueType::INVALID));
+        auto &param_value = param_values[param_idx];
+        if (type::WireFormat::DecodeBinary(param_type, param.data(),
+                                           param_len, param_value) == false) {
+          LOG_ERROR("Do not support data type: %d",
+                    static_cast<int>(param_type));
+        } else if (param_value.GetTypeId() == type::TypeId::VARBINARY) {
+          bind_parameters[param_idx] = std::make_pair(
+              type::TypeId::VARBINARY,
+              std::string(reinterpret_cast<char *>(param.data()), param_len));
+        } else {
+          bind_parameters[param_idx] =
+              std::make_pair(param_value.GetTypeId(), param_value.ToString());
         }
         PL_ASSERT(param_values[param_idx].GetTypeId() != type::TypeId::INVALID);
       }
@@ -865,7 +991,7 @@ size_t PacketManager::ReadParamValue(
 bool PacketManager::ExecDescribeMessage(InputPacket *pkt) {
   if (skipped_stmt_) {
     // send 'no-data' message
-    std::unique_ptr<OutputPacket> response(new OutputPacket());
+    auto response = NewPacket();
     response->msg_type = NetworkMessageType::NO_DATA_RESPONSE;
     responses.push_back(std::move(response));
     return true;
@@ -898,8 +1024,9 @@ bool PacketManager::ExecDescribeMessage(InputPacket *pkt) {
       return false;
     }
 
+    // The columns are sent in the formats the portal was bound with
     auto statement = portal->GetStatement();
-    PutTupleDescriptor(statement->GetTupleDescriptor());
+    PutTupleDescriptor(statement->GetTupleDescriptor(), &result_format_);
   } else {
     LOG_TRACE("Describe a prepared statement");
   }
@@ -908,12 +1035,15 @@ bool PacketManager::ExecDescribeMessage(InputPacket *pkt) {
 
 void PacketManager::ExecExecuteMessage(InputPacket *pkt,
                                        const size_t thread_id) {
+  stats::QueryTraceScope query_trace;
   // EXECUTE message
-  std::vector<StatementResult> results;
   std::string error_message, portal_name;
   int rows_affected = 0;
   GetStringToken(pkt, portal_name);
 
+  // The most rows to send, 0 for all of them
+  int max_rows = PacketGetInt(pkt, 4);
+
   // covers weird JDBC edge case of sending double BEGIN statements. Don't
   // execute them
   if (skipped_stmt_) {
@@ -950,37 +1080,67 @@ void PacketManager::ExecExecuteMessage(InputPacket *pkt,
     return;
   }
 
-  auto statement_name = statement->GetStatementName();
-  bool unnamed = statement_name.empty();
-  auto param_values = portal->GetParameters();
+  // A portal suspended at the row limit of an earlier execution continues
+  // with the rows it held back
+  auto &results = portal->suspended_results_;
+  streamed_rows_ = 0;
+  if (results.empty()) {
+    auto statement_name = statement->GetStatementName();
+    bool unnamed = statement_name.empty();
+    auto param_values = portal->GetParameters();
+
+    // Rows are only streamed if they can all be sent
+    if (max_rows <= 0) {
+      StartStreaming(false);
+    }
+    auto status = traffic_cop_->ExecuteStatement(
+        statement, param_values, unnamed, param_stat, result_format_, results,
+        rows_affected, error_message, thread_id);
+    StopStreaming();
+    portal->suspended_row_ = 0;
+
+    switch (status) {
+      case ResultType::FAILURE:
+        LOG_ERROR("Failed to execute: %s", error_message.c_str());
+        results.clear();
+        SendErrorResponse(
+            {{NetworkMessageType::HUMAN_READABLE_ERROR, error_message}});
+        return;
+      case ResultType::ABORTED:
+        results.clear();
+        if (query_type != QueryType::QUERY_ROLLBACK) {
+          LOG_DEBUG("Failed to execute: Conflicting txn aborted");
+          // Send an error response if the abort is not due to ROLLBACK query
+          SendErrorResponse({{NetworkMessageType::SQLSTATE_CODE_ERROR,
+                              SqlStateErrorCodeToString(
+                                  SqlStateErrorCode::SERIALIZATION_ERROR)}});
+        }
+        return;
+      default:
+        break;
+    }
+  }
 
-  auto status = traffic_cop_->ExecuteStatement(
-      statement, param_values, unnamed, param_stat, result_format_, results,
-      rows_affected, error_message, thread_id);
+  stats::QueryPhaseTimer send_timer(stats::QueryPhase::SEND);
+  auto tuple_descriptor = statement->GetTupleDescriptor();
+  int rows_sent = 0;
+  SendDataRows(results, tuple_descriptor.size(), rows_sent,
+               portal->suspended_row_, std::max(max_rows, 0));
+  if (streamed_rows_ > 0 || results.empty() == false) {
+    rows_affected = streamed_rows_ + rows_sent;
+  }
+  portal->suspended_row_ += rows_sent;
 
-  switch (status) {
-    case ResultType::FAILURE:
-      LOG_ERROR("Failed to execute: %s", error_message.c_str());
-      SendErrorResponse(
-          {{NetworkMessageType::HUMAN_READABLE_ERROR, error_message}});
-      return;
-    case ResultType::ABORTED:
-      if (query_type != QueryType::QUERY_ROLLBACK) {
-        LOG_DEBUG("Failed to execute: Conflicting txn aborted");
-        // Send an error response if the abort is not due to ROLLBACK query
-        SendErrorResponse({{NetworkMessageType::SQLSTATE_CODE_ERROR,
-                            SqlStateErrorCodeToString(
-                                SqlStateErrorCode::SERIALIZATION_ERROR)}});
-      }
-      return;
-    default: {
-      auto tuple_descriptor = statement->GetTupleDescriptor();
-      SendDataRows(results, tuple_descriptor.size(), rows_affected);
-      // The reponse to ExecuteCommand is the query_type string token.
-      CompleteCommand(statement->GetQueryTypeString(), query_type, rows_affected);
-      return;
-    }
+  if (tuple_descriptor.empty() == false &&
+      portal->suspended_row_ * tuple_descriptor.size() < results.size()) {
+    SendPortalSuspended();
+    return;
   }
+  results.clear();
+  portal->suspended_row_ = 0;
+
+  // The reponse to ExecuteCommand is the query_type string token.
+  CompleteCommand(statement->GetQueryTypeString(), query_type, rows_affected);
 }
 
 void PacketManager::ExecCloseMessage(InputPacket *pkt) {
@@ -988,16 +1148,10 @@ void PacketManager::ExecCloseMessage(InputPacket *pkt) {
   std::string name;
   PacketGetByte(pkt, close_type);
   PacketGetString(pkt, 0, name);
-  bool is_unnamed = (name.size() == 0) ? true : false;
   switch (close_type) {
     case 'S':
       LOG_TRACE("Deleting statement %s from cache", name.c_str());
-      if (is_unnamed) {
-        unnamed_statement_.reset();
-      } else {
-        // TODO: Invalidate table_statement_cache!
-        statement_cache_.delete_key(name);
-      }
+      UncacheStatement(name);
       break;
     case 'P': {
       LOG_TRACE("Deleting portal %s from cache", name.c_str());
@@ -1013,16 +1167,181 @@ void PacketManager::ExecCloseMessage(InputPacket *pkt) {
       break;
   }
   // Send close complete response
-  std::unique_ptr<OutputPacket> response(new OutputPacket());
+  auto response = NewPacket();
   response->msg_type = NetworkMessageType::CLOSE_COMPLETE;
   responses.push_back(std::move(response));
 }
 
+bool PacketManager::ExecCopyQuery(const std::string &query,
+                                  const size_t thread_id) {
+  std::unique_ptr<parser::SQLStatementList> sql_stmt;
+  try {
+    sql_stmt = parser::PostgresParser::GetInstance().BuildParseTree(query);
+  } catch (Exception &e) {
+    // The error is reported once the statement executes
+    return false;
+  }
+  if (sql_stmt == nullptr || sql_stmt->is_valid == false ||
+      sql_stmt->GetStatements().size() != 1 ||
+      sql_stmt->GetStatement(0)->GetType() != StatementType::COPY) {
+    return false;
+  }
+  auto copy_stmt = static_cast<parser::CopyStatement *>(
+      sql_stmt->GetStatement(0));
+  if (copy_stmt->file_path != nullptr) {
+    return false;
+  }
+
+  if (copy_stmt->type != CopyType::IMPORT_CSV) {
+    // COPY TO STDOUT executes like a SELECT * whose rows are sent as CopyData
+    std::vector<StatementResult> result;
+    std::vector<FieldInfo> tuple_descriptor;
+    std::string error_message;
+    int rows_affected = 0;
+    copy_out_delimiter_ = copy_stmt->delimiter;
+    StartStreaming(true);
+    auto status = traffic_cop_->ExecuteStatement(
+        query, result, tuple_descriptor, rows_affected, error_message,
+        thread_id);
+    StopStreaming();
+
+    if (status == ResultType::FAILURE) {
+      copy_out_delimiter_ = 0;
+      SendErrorResponse(
+          {{NetworkMessageType::HUMAN_READABLE_ERROR, error_message}});
+      SendReadyForQuery(NetworkTransactionStateType::IDLE);
+      return true;
+    }
+    if (stream_descriptor_ == true) {
+      PutCopyResponse(NetworkMessageType::COPY_OUT_RESPONSE,
+                      tuple_descriptor.size());
+    }
+    int rows_left = 0;
+    SendCopyData(result, tuple_descriptor.size(), rows_left);
+    copy_out_delimiter_ = 0;
+
+    auto pkt = NewPacket();
+    pkt->msg_type = NetworkMessageType::COPY_DONE;
+    responses.push_back(std::move(pkt));
+    CompleteCommand(query, QueryType::QUERY_COPY, streamed_rows_ + rows_left);
+    SendReadyForQuery(NetworkTransactionStateType::IDLE);
+    return true;
+  }
+
+  // COPY FROM STDIN loads the CopyData the client sends next
+  storage::DataTable *table;
+  try {
+    table = catalog::Catalog::GetInstance()->GetTableWithName(
+        copy_stmt->cpy_table->GetDatabaseName(),
+        copy_stmt->cpy_table->GetTableName());
+  } catch (Exception &e) {
+    SendErrorResponse({{NetworkMessageType::HUMAN_READABLE_ERROR, e.what()}});
+    SendReadyForQuery(txn_state_);
+    return true;
+  }
+
+  copy_txn_ = traffic_cop_->GetRunningTransaction();
+  own_copy_txn_ = copy_txn_ == nullptr;
+  if (own_copy_txn_) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    copy_txn_ = txn_manager.BeginTransaction(thread_id);
+  }
+  copy_loader_.reset(
+      new executor::CopyFromLoader(table, copy_stmt->delimiter, copy_txn_));
+  PutCopyResponse(NetworkMessageType::COPY_IN_RESPONSE,
+                  table->GetSchema()->GetColumnCount());
+  return true;
+}
+
+void PacketManager::ExecCopyDataMessage(InputPacket *pkt) {
+  if (copy_loader_ == nullptr || pkt->len == 0) return;
+
+  bool success;
+  std::string error_message = "COPY FROM STDIN violated a constraint";
+  try {
+    success = copy_loader_->Append(
+        reinterpret_cast<const char *>(&*pkt->Begin()), pkt->len);
+  } catch (Exception &e) {
+    success = false;
+    error_message = e.what();
+  }
+  if (success == false) {
+    EndCopyIn(false, error_message);
+  }
+}
+
+void PacketManager::ExecCopyDoneMessage() {
+  if (copy_loader_ == nullptr) return;
+
+  bool success;
+  std::string error_message = "COPY FROM STDIN violated a constraint";
+  try {
+    success = copy_loader_->Finish();
+  } catch (Exception &e) {
+    success = false;
+    error_message = e.what();
+  }
+  EndCopyIn(success, error_message);
+}
+
+void PacketManager::ExecCopyFailMessage(InputPacket *pkt) {
+  if (copy_loader_ == nullptr) return;
+
+  std::string reason;
+  PacketGetString(pkt, pkt->len, reason);
+  EndCopyIn(false, "COPY from stdin failed: " + reason);
+}
+
+void PacketManager::EndCopyIn(bool success, std::string error_message) {
+  size_t rows = copy_loader_->GetRowCount();
+  if (CloseCopyIn(success) != ResultType::SUCCESS && success) {
+    success = false;
+    error_message = "COPY FROM STDIN failed to commit";
+  }
+
+  if (success) {
+    CompleteCommand("COPY", QueryType::QUERY_COPY, rows);
+  } else {
+    SendErrorResponse(
+        {{NetworkMessageType::HUMAN_READABLE_ERROR, error_message}});
+  }
+  SendReadyForQuery(txn_state_);
+  force_flush = true;
+}
+
+ResultType PacketManager::CloseCopyIn(bool success) {
+  if (copy_loader_ == nullptr) return ResultType::SUCCESS;
+
+  // Stop the parser threads before the transaction ends
+  copy_loader_.reset();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  ResultType result = ResultType::SUCCESS;
+  if (own_copy_txn_) {
+    result = success ? txn_manager.CommitTransaction(copy_txn_)
+                     : txn_manager.AbortTransaction(copy_txn_);
+  } else if (success == false) {
+    // The transaction block fails once it commits
+    txn_manager.SetTransactionResult(copy_txn_, ResultType::FAILURE);
+  }
+  copy_txn_ = nullptr;
+  own_copy_txn_ = false;
+  return result;
+}
+
 /*
  * process_packet - Main switch block; process incoming packets,
  *  Returns false if the session needs to be closed.
  */
 bool PacketManager::ProcessPacket(InputPacket *pkt, const size_t thread_id) {
+  BindTrafficCop();
+  bool status = DispatchPacket(pkt, thread_id);
+  if (txn_state_ == NetworkTransactionStateType::IDLE) {
+    UnbindTrafficCop();
+  }
+  return status;
+}
+
+bool PacketManager::DispatchPacket(InputPacket *pkt, const size_t thread_id) {
   LOG_TRACE("Message type: %c", static_cast<unsigned char>(pkt->msg_type));
   // We don't set force_flush to true for `PBDE` messages because they're
   // part of the extended protocol. Buffer responses and don't flush until
@@ -1058,6 +1377,18 @@ bool PacketManager::ProcessPacket(InputPacket *pkt, const size_t thread_id) {
       LOG_TRACE("CLOSE_COMMAND");
       ExecCloseMessage(pkt);
     } break;
+    case NetworkMessageType::COPY_DATA: {
+      LOG_TRACE("COPY_DATA");
+      ExecCopyDataMessage(pkt);
+    } break;
+    case NetworkMessageType::COPY_DONE: {
+      LOG_TRACE("COPY_DONE");
+      ExecCopyDoneMessage();
+    } break;
+    case NetworkMessageType::COPY_FAIL_COMMAND: {
+      LOG_TRACE("COPY_FAIL_COMMAND");
+      ExecCopyFailMessage(pkt);
+    } break;
     case NetworkMessageType::TERMINATE_COMMAND: {
       LOG_TRACE("TERMINATE_COMMAND");
       force_flush = true;
@@ -1083,7 +1414,7 @@ bool PacketManager::ProcessPacket(InputPacket *pkt, const size_t thread_id) {
  */
 void PacketManager::SendErrorResponse(
     std::vector<std::pair<NetworkMessageType, std::string>> error_status) {
-  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  auto pkt = NewPacket();
   pkt->msg_type = NetworkMessageType::ERROR_RESPONSE;
 
   for (auto entry : error_status) {
@@ -1099,7 +1430,7 @@ void PacketManager::SendErrorResponse(
 }
 
 void PacketManager::SendReadyForQuery(NetworkTransactionStateType txn_status) {
-  std::unique_ptr<OutputPacket> pkt(new OutputPacket());
+  auto pkt = NewPacket();
   pkt->msg_type = NetworkMessageType::READY_FOR_QUERY;
 
   PacketPutByte(pkt.get(), static_cast<unsigned char>(txn_status));
@@ -1107,6 +1438,100 @@ void PacketManager::SendReadyForQuery(NetworkTransactionStateType txn_status) {
   responses.push_back(std::move(pkt));
 }
 
+std::unique_ptr<OutputPacket> PacketManager::NewPacket() {
+  if (free_packets_.empty()) {
+    return std::unique_ptr<OutputPacket>(new OutputPacket());
+  }
+  auto pkt = std::move(free_packets_.back());
+  free_packets_.pop_back();
+  return pkt;
+}
+
+void PacketManager::RecycleResponses() {
+  for (auto &pkt : responses) {
+    if (free_packets_.size() == kMaxFreePackets) break;
+    pkt->Reset();
+    free_packets_.push_back(std::move(pkt));
+  }
+  responses.clear();
+}
+
+std::shared_ptr<Statement> PacketManager::PrepareStatement(
+    const std::string &statement_name, const std::string &query_string,
+    std::string &error_message) {
+  if (FLAGS_plan_cache_size == 0) {
+    return traffic_cop_->PrepareStatement(statement_name, query_string,
+                                          error_message);
+  }
+
+  auto statement = optimizer::PlanCache::GetInstance().AcquireHandle(
+      query_string, catalog::Catalog::GetInstance()->GetVersion(),
+      [this, &statement_name, &query_string, &error_message]() {
+        return traffic_cop_->PrepareStatement(statement_name, query_string,
+                                              error_message);
+      });
+  if (statement != nullptr) {
+    statement->SetStatementName(statement_name);
+  }
+  return statement;
+}
+
+void PacketManager::CacheStatement(
+    const std::string &statement_name,
+    const std::shared_ptr<Statement> &statement) {
+  UncacheStatement(statement_name);
+  if (statement_name.empty()) {
+    unnamed_statement_ = statement;
+    return;
+  }
+  statement_cache_.insert(std::make_pair(statement_name, statement));
+  for (auto table_id : statement->GetReferencedTables()) {
+    table_statement_cache_[table_id].push_back(statement.get());
+  }
+}
+
+void PacketManager::UncacheStatement(const std::string &statement_name) {
+  if (statement_name.empty()) {
+    unnamed_statement_.reset();
+    return;
+  }
+  auto itr = statement_cache_.find(statement_name);
+  if (itr == statement_cache_.end()) {
+    return;
+  }
+  Statement *statement = (*itr).get();
+  for (auto &table_statements : table_statement_cache_) {
+    auto &statements = table_statements.second;
+    statements.erase(
+        std::remove(statements.begin(), statements.end(), statement),
+        statements.end());
+  }
+  statement_cache_.delete_key(statement_name);
+}
+
+void PacketManager::BindTrafficCop() {
+  if (traffic_cop_ != nullptr) return;
+  if (tcop::TrafficCopPool::GetInstance().IsEnabled()) {
+    traffic_cop_ = tcop::TrafficCopPool::GetInstance().Acquire();
+  } else {
+    if (own_traffic_cop_ == nullptr) {
+      own_traffic_cop_.reset(new tcop::TrafficCop());
+    }
+    traffic_cop_ = own_traffic_cop_.get();
+  }
+  traffic_cop_->SetCommitWaiter(commit_waiter_);
+}
+
+void PacketManager::UnbindTrafficCop() {
+  // The connection keeps its own traffic cop
+  if (traffic_cop_ == nullptr || traffic_cop_ == own_traffic_cop_.get()) {
+    return;
+  }
+  traffic_cop_->SetCommitWaiter(nullptr);
+  tcop::TrafficCopPool::GetInstance().Release(traffic_cop_);
+  traffic_cop_ = nullptr;
+}
+
 void PacketManager::Reset() {
   client_.Reset();
   is_started = false;
@@ -1123,8 +1548,13 @@ void PacketManager::Reset() {
   table_statement_cache_.clear();
   portals_.clear();
   pkt_cntr_ = 0;
+  CloseCopyIn(false);
+  copy_out_delimiter_ = 0;
 
-  traffic_cop_->Reset();
+  if (traffic_cop_ != nullptr) {
+    traffic_cop_->Reset();
+    UnbindTrafficCop();
+  }
 }
 
 }  // End wire namespace
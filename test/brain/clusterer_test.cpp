@@ -83,5 +83,63 @@ TEST_F(ClustererTests, BasicTest) {
 
 }
 
+TEST_F(ClustererTests, BitmapTest) {
+  oid_t column_count = 70;
+
+  // Bitmaps span words
+  brain::Sample sample({0, 3, 64, 69});
+  auto bitmap = brain::ColumnBitmap::FromColumnIds(sample, column_count);
+  EXPECT_EQ(4U, bitmap.GetCount());
+  EXPECT_TRUE(bitmap.IsSet(64));
+  EXPECT_FALSE(bitmap.IsSet(1));
+
+  std::vector<double> columns_accessed(column_count, 0);
+  columns_accessed[0] = columns_accessed[3] = 1;
+  columns_accessed[64] = columns_accessed[69] = 1;
+  auto sample_bitmap = brain::ColumnBitmap::FromSample(
+      brain::Sample(columns_accessed));
+  EXPECT_EQ(bitmap.GetWords(), sample_bitmap.GetWords());
+
+  // The distance is the one of the samples
+  brain::Clusterer clusterer(2, column_count);
+  for (int sample_itr = 0; sample_itr < 10; sample_itr++) {
+    clusterer.ProcessBitmap(bitmap);
+  }
+  auto mean = clusterer.GetCluster(0);
+  std::vector<double> other_columns_accessed(column_count, 1);
+  other_columns_accessed[0] = other_columns_accessed[3] = 0;
+  other_columns_accessed[64] = other_columns_accessed[69] = 0;
+  brain::Sample other(other_columns_accessed);
+  EXPECT_LT(brain::Sample(columns_accessed).GetDistance(mean),
+            other.GetDistance(mean));
+  EXPECT_EQ(0U, clusterer.GetClosestCluster(bitmap));
+  EXPECT_EQ(1U, clusterer.GetClosestCluster(other));
+}
+
+TEST_F(ClustererTests, BatchTest) {
+  oid_t column_count = 4;
+  oid_t cluster_count = 2;
+
+  brain::Clusterer clusterer(cluster_count, column_count, 0.1);
+  brain::ColumnBitmap first(column_count);
+  first.Set(0);
+  first.Set(1);
+  brain::ColumnBitmap second(column_count);
+  second.Set(2);
+  second.Set(3);
+
+  // Each shape ends up in a cluster of its own
+  for (int batch_itr = 0; batch_itr < 50; batch_itr++) {
+    clusterer.ProcessBitmaps({first, first, second, second});
+  }
+  auto first_cluster = clusterer.GetClosestCluster(first);
+  auto second_cluster = clusterer.GetClosestCluster(second);
+  EXPECT_NE(first_cluster, second_cluster);
+  EXPECT_EQ(std::vector<oid_t>({0, 1}),
+            clusterer.GetCluster(first_cluster).GetEnabledColumns());
+  EXPECT_EQ(std::vector<oid_t>({2, 3}),
+            clusterer.GetCluster(second_cluster).GetEnabledColumns());
+}
+
 }  // End test namespace
 }  // End peloton namespace
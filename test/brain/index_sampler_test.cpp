@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_sampler_test.cpp
+//
+// Identification: test/brain/index_sampler_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "brain/index_sampler.h"
+#include "brain/sample.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "expression/expression_util.h"
+#include "planner/delete_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Index Sampler Tests
+//===--------------------------------------------------------------------===//
+
+class IndexSamplerTests : public PelotonTest {};
+
+namespace {
+
+storage::DataTable *CreateAndPopulateTable(const int tuple_count) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto table = TestingExecutorUtil::CreateTable(tuple_count, false);
+  TestingExecutorUtil::PopulateTable(table, tuple_count, false, false, false,
+                                     txn);
+  txn_manager.CommitTransaction(txn);
+  return table;
+}
+
+// column = value
+expression::AbstractExpression *CreateComparison(const ExpressionType type,
+                                                 const oid_t column_id,
+                                                 const int value) {
+  return expression::ExpressionUtil::ComparisonFactory(
+      type, expression::ExpressionUtil::TupleValueFactory(
+                type::TypeId::INTEGER, 0, column_id),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(value)));
+}
+
+}  // namespace
+
+TEST_F(IndexSamplerTests, ScanSampleTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP * 10;
+  std::unique_ptr<storage::DataTable> data_table(
+      CreateAndPopulateTable(tuple_count));
+
+  // a = 10 AND b > 5, both columns are looked up
+  auto predicate = expression::ExpressionUtil::ConjunctionFactory(
+      ExpressionType::CONJUNCTION_AND,
+      CreateComparison(ExpressionType::COMPARE_EQUAL, 0, 10),
+      CreateComparison(ExpressionType::COMPARE_GREATERTHAN, 1, 5));
+  std::set<oid_t> column_ids;
+  brain::IndexSampler::GetIndexableColumns(predicate, column_ids);
+  EXPECT_EQ(std::set<oid_t>({0, 1}), column_ids);
+
+  planner::SeqScanPlan scan(data_table.get(), predicate, {0, 1});
+  brain::IndexSampler::RecordSamples(&scan, 0);
+  auto samples = data_table->GetIndexSamples();
+  ASSERT_EQ(1U, samples.size());
+  EXPECT_EQ(brain::SAMPLE_TYPE_ACCESS, samples[0].GetSampleType());
+  EXPECT_EQ(std::vector<double>({0, 1}), samples[0].GetColumnsAccessed());
+  EXPECT_LT(0, samples[0].GetWeight());
+  data_table->ClearIndexSamples();
+
+  // A range the estimate cannot narrow down is cheaper to scan
+  planner::SeqScanPlan range_scan(
+      data_table.get(),
+      CreateComparison(ExpressionType::COMPARE_GREATERTHAN, 1, 5), {0, 1});
+  brain::IndexSampler::RecordSamples(&range_scan, 0);
+  EXPECT_EQ(0U, data_table->GetIndexSamples().size());
+}
+
+TEST_F(IndexSamplerTests, UpdateSampleTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+  std::unique_ptr<storage::DataTable> data_table(
+      CreateAndPopulateTable(tuple_count));
+
+  // The tuples a delete modified weigh against the indexes of the table
+  std::unique_ptr<planner::DeletePlan> delete_plan(
+      new planner::DeletePlan(data_table.get(), false));
+  brain::IndexSampler::RecordSamples(delete_plan.get(), 0);
+  EXPECT_EQ(0U, data_table->GetIndexSamples().size());
+
+  brain::IndexSampler::RecordSamples(delete_plan.get(), 10);
+  auto samples = data_table->GetIndexSamples();
+  ASSERT_EQ(1U, samples.size());
+  EXPECT_EQ(brain::SAMPLE_TYPE_UPDATE, samples[0].GetSampleType());
+  EXPECT_DOUBLE_EQ(
+      brain::IndexSampler::GetIndexMaintenanceCost(data_table.get(), 10),
+      samples[0].GetWeight());
+  EXPECT_DOUBLE_EQ(
+      2 * brain::IndexSampler::GetIndexMaintenanceCost(data_table.get(), 5),
+      samples[0].GetWeight());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// knob_tuner_test.cpp
+//
+// Identification: test/brain/knob_tuner_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "brain/knob_tuner.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Knob Tuner Tests
+//===--------------------------------------------------------------------===//
+
+class KnobTunerTests : public PelotonTest {};
+
+TEST_F(KnobTunerTests, TableTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  size_t active_tile_group_count = data_table->GetActiveTileGroupCount();
+
+  brain::KnobTuner knob_tuner;
+  knob_tuner.TuneTable(data_table.get(), 0);
+
+  // Contended inserts that fill many tile groups
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     tuples_per_tilegroup * 40, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+  knob_tuner.TuneTable(data_table.get(), 1000);
+  EXPECT_LT(active_tile_group_count, data_table->GetActiveTileGroupCount());
+  EXPECT_EQ(tuples_per_tilegroup * 2,
+            static_cast<int>(data_table->GetTuplesPerTileGroup()));
+
+  // The new active tile groups take inserts
+  txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuples_per_tilegroup,
+                                     false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(tuples_per_tilegroup * 41,
+            static_cast<int>(data_table->GetTupleCount()));
+
+  // They are given back once the contention is gone
+  for (int interval_itr = 0; interval_itr < 10; interval_itr++) {
+    knob_tuner.TuneTable(data_table.get(), 0);
+  }
+  EXPECT_EQ(active_tile_group_count, data_table->GetActiveTileGroupCount());
+
+  // The count is capped
+  EXPECT_GE(storage::DataTable::MAX_ACTIVE_TILE_GROUP_COUNT,
+            data_table->AdjustActiveTileGroupCount(1000));
+}
+
+TEST_F(KnobTunerTests, EpochTest) {
+  brain::KnobTuner knob_tuner;
+  knob_tuner.SetGCLagTarget(100);
+
+  // The epoch thread keeps up and the GC lags little
+  EXPECT_EQ(40U, knob_tuner.GetEpochLength(40, 25, 1000, 2));
+
+  // The epoch thread falls behind its period
+  EXPECT_EQ(80U, knob_tuner.GetEpochLength(40, 10, 1000, 2));
+
+  // A few long epochs hold the versions back
+  EXPECT_EQ(20U, knob_tuner.GetEpochLength(40, 25, 1000, 4));
+
+  // A long transaction does, which shorter epochs do not help
+  EXPECT_EQ(40U, knob_tuner.GetEpochLength(40, 25, 1000, 100));
+
+  // Back to the default once the GC keeps up
+  EXPECT_EQ(20U, knob_tuner.GetEpochLength(10, 100, 1000, 1));
+  EXPECT_EQ(5U, knob_tuner.GetEpochLength(5, 200, 1000, 30));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -125,7 +125,10 @@ TEST_F(LayoutTunerTests, BasicTest) {
   EXPECT_EQ(third_column_tile, 0);
   EXPECT_EQ(fourth_column_tile, 1);
 
-
+  // The existing tile group converges to the new layout
+  layout_tuner.RelayoutTable(data_table.get());
+  EXPECT_EQ(0, data_table->GetTileGroup(0)->GetSchemaDifference(
+                   new_default_layout));
 }
 
 }  // End test namespace
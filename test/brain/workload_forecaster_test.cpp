@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// workload_forecaster_test.cpp
+//
+// Identification: test/brain/workload_forecaster_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "brain/workload_forecaster.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Workload Forecaster Tests
+//===--------------------------------------------------------------------===//
+
+class WorkloadForecasterTests : public PelotonTest {};
+
+TEST_F(WorkloadForecasterTests, TrendTest) {
+  brain::WorkloadForecaster forecaster(100);
+  EXPECT_EQ(0, forecaster.GetForecast("SELECT a FROM t"));
+
+  // 10, 20, 30, 40 queries: the line goes on
+  for (int interval_itr = 1; interval_itr <= 4; interval_itr++) {
+    forecaster.RecordQuery("SELECT a FROM t", 10 * interval_itr);
+    forecaster.FinishInterval();
+  }
+  EXPECT_EQ(4U, forecaster.GetIntervalCount());
+  EXPECT_DOUBLE_EQ(40, forecaster.GetLastTotal());
+  EXPECT_DOUBLE_EQ(50, forecaster.GetForecast("SELECT a FROM t"));
+  EXPECT_DOUBLE_EQ(70, forecaster.GetForecast("SELECT a FROM t", 3));
+
+  // It does not fall below 0
+  for (int interval_itr = 0; interval_itr < 4; interval_itr++) {
+    forecaster.RecordQuery("DELETE FROM t", 40 - 10 * interval_itr);
+    forecaster.FinishInterval();
+  }
+  EXPECT_DOUBLE_EQ(0, forecaster.GetForecast("DELETE FROM t", 10));
+}
+
+TEST_F(WorkloadForecasterTests, SeasonTest) {
+  const size_t season_length = 4;
+  brain::WorkloadForecaster forecaster(season_length);
+
+  // A peak in the third interval of every season
+  std::vector<double> season = {10, 10, 100, 10};
+  for (int season_itr = 0; season_itr < 2; season_itr++) {
+    for (auto query_count : season) {
+      forecaster.RecordQuery("SELECT a FROM t", query_count);
+      forecaster.RecordQuery("UPDATE t SET a = 1", 10);
+      forecaster.FinishInterval();
+    }
+  }
+
+  EXPECT_DOUBLE_EQ(10, forecaster.GetForecast("SELECT a FROM t", 1));
+  EXPECT_DOUBLE_EQ(100, forecaster.GetForecast("SELECT a FROM t", 3));
+  EXPECT_GT(100, forecaster.GetForecast(
+                     "SELECT a FROM t", 3,
+                     brain::FORECAST_MODEL_LINEAR_REGRESSION));
+  EXPECT_DOUBLE_EQ(110, forecaster.GetTotalForecast(3));
+
+  auto forecast_mix = forecaster.GetForecastMix(3);
+  EXPECT_DOUBLE_EQ(100.0 / 110, forecast_mix["SELECT a FROM t"]);
+  EXPECT_DOUBLE_EQ(10.0 / 110, forecast_mix["UPDATE t SET a = 1"]);
+
+  // The peak is two intervals away
+  EXPECT_FALSE(forecaster.IsPeakAhead(1, 2));
+  EXPECT_TRUE(forecaster.IsPeakAhead(3, 2));
+}
+
+TEST_F(WorkloadForecasterTests, ShapeTest) {
+  const size_t season_length = 2;
+  brain::WorkloadForecaster forecaster(season_length, 1, 16, 1);
+
+  // Only as many shapes as are kept are counted
+  forecaster.RecordQuery("SELECT a FROM t", 5);
+  forecaster.RecordQuery("SELECT b FROM t", 5);
+  forecaster.FinishInterval();
+  EXPECT_DOUBLE_EQ(5, forecaster.GetLastTotal());
+  EXPECT_EQ(0, forecaster.GetForecast("SELECT b FROM t"));
+
+  // Shapes that stop arriving are forgotten
+  forecaster.FinishInterval();
+  forecaster.FinishInterval();
+  EXPECT_EQ(0, forecaster.GetForecast("SELECT a FROM t"));
+  forecaster.RecordQuery("SELECT b FROM t", 5);
+  forecaster.FinishInterval();
+  EXPECT_DOUBLE_EQ(5, forecaster.GetLastTotal());
+
+  forecaster.Clear();
+  EXPECT_EQ(0U, forecaster.GetIntervalCount());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// catalog_cache_test.cpp
+//
+// Identification: test/catalog/catalog_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/catalog_cache.h"
+
+#include <thread>
+#include <vector>
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Catalog Cache Tests
+//===--------------------------------------------------------------------===//
+
+class CatalogCacheTests : public PelotonTest {};
+
+TEST_F(CatalogCacheTests, BasicTest) {
+  catalog::CatalogCache cache;
+  uint64_t version = cache.GetVersion();
+  EXPECT_EQ(INVALID_OID, cache.GetDatabaseOid("db"));
+
+  cache.AddDatabase(version, "db", 1);
+  cache.AddTable(version, 1, "table", 10);
+  EXPECT_EQ(1U, cache.GetDatabaseOid("db"));
+  EXPECT_EQ(10U, cache.GetTableOid(1, "table"));
+  EXPECT_EQ(INVALID_OID, cache.GetTableOid(2, "table"));
+  EXPECT_EQ(version, cache.GetVersion());
+
+  // Only erased while it caches the oid
+  cache.EraseTable(1, "table", 11);
+  EXPECT_EQ(10U, cache.GetTableOid(1, "table"));
+  cache.EraseTable(1, "table", 10);
+  EXPECT_EQ(INVALID_OID, cache.GetTableOid(1, "table"));
+  cache.EraseDatabase("db", 1);
+  EXPECT_EQ(INVALID_OID, cache.GetDatabaseOid("db"));
+
+  // What was found before a change is not cached after it
+  cache.AddDatabase(version, "db", 1);
+  cache.Reset();
+  EXPECT_EQ(version + 1, cache.GetVersion());
+  EXPECT_EQ(INVALID_OID, cache.GetDatabaseOid("db"));
+  cache.AddTable(version, 1, "table", 10);
+  EXPECT_EQ(INVALID_OID, cache.GetTableOid(1, "table"));
+  cache.AddTable(version + 1, 1, "table", 10);
+  EXPECT_EQ(10U, cache.GetTableOid(1, "table"));
+}
+
+TEST_F(CatalogCacheTests, MultiThreadedTest) {
+  catalog::CatalogCache cache;
+  const oid_t table_count = 64;
+
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < 4; thread_id++) {
+    threads.emplace_back([&cache, thread_id, table_count] {
+      for (int i = 0; i < 2000; i++) {
+        oid_t table_oid = (i * 7 + thread_id) % table_count;
+        std::string table_name = "table_" + std::to_string(table_oid);
+        auto cached_oid = cache.GetTableOid(1, table_name);
+        if (cached_oid == INVALID_OID) {
+          cache.AddTable(cache.GetVersion(), 1, table_name, table_oid);
+        } else {
+          EXPECT_EQ(table_oid, cached_oid);
+        }
+        if (thread_id == 0 && i % 100 == 0) {
+          cache.Reset();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
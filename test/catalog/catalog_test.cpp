@@ -19,6 +19,7 @@
 #include "common/harness.h"
 #include "common/logger.h"
 #include "storage/storage_manager.h"
+#include "storage/tuple.h"
 #include "type/ephemeral_pool.h"
 
 namespace peloton {
@@ -147,6 +148,41 @@ TEST_F(CatalogTests, CreatingTable) {
   //           72);
 }
 
+TEST_F(CatalogTests, QueryMetricsRetention) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  auto query_metrics_catalog = catalog::QueryMetricsCatalog::GetInstance();
+
+  // Enough queries to fill a tile group in bulk, and one more
+  std::unique_ptr<type::AbstractPool> pool(new type::EphemeralPool());
+  stats::QueryMetric::QueryParamBuf param;
+  param.len = 1;
+  param.buf = (unsigned char *)pool->Allocate(1);
+  *param.buf = 'a';
+  int query_count = DEFAULT_TUPLES_PER_TILEGROUP + 1;
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  for (int query_itr = 0; query_itr < query_count; query_itr++) {
+    tuples.push_back(query_metrics_catalog->GetQueryMetricsTuple(
+        "query " + std::to_string(query_itr), 1, 2, param, param, param, 1, 1,
+        1, 1, 1, 1, 100 + query_itr, pool.get()));
+  }
+  EXPECT_TRUE(query_metrics_catalog->InsertQueryMetrics(std::move(tuples),
+                                                        txn));
+  EXPECT_EQ(2, query_metrics_catalog->GetNumParams("query 0", 1, txn));
+  EXPECT_EQ(2, query_metrics_catalog->GetNumParams(
+                   "query " + std::to_string(query_count - 1), 1, txn));
+
+  // Only the queries recorded before the time stamp are deleted
+  EXPECT_TRUE(query_metrics_catalog->DeleteQueryMetricsBefore(101, txn));
+  EXPECT_EQ(0, query_metrics_catalog->GetNumParams("a query", 1, txn));
+  EXPECT_EQ(0, query_metrics_catalog->GetNumParams("query 0", 1, txn));
+  EXPECT_EQ(2, query_metrics_catalog->GetNumParams("query 1", 1, txn));
+  EXPECT_EQ(2, query_metrics_catalog->GetNumParams(
+                   "query " + std::to_string(query_count - 1), 1, txn));
+
+  txn_manager.CommitTransaction(txn);
+}
+
 TEST_F(CatalogTests, DroppingTable) {
   EXPECT_EQ(catalog::Catalog::GetInstance()
                 ->GetDatabaseWithName("EMP_DB")
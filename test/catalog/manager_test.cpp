@@ -16,6 +16,8 @@
 #include "common/macros.h"
 #include "catalog/manager.h"
 #include "catalog/schema.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_factory.h"
 
@@ -70,5 +72,45 @@ TEST_F(ManagerTests, TransactionTest) {
   // EXPECT_EQ(catalog::Manager::GetInstance().GetCurrentTileGroupId(), 800);
 }
 
+TEST_F(ManagerTests, ResolveTileGroupTest) {
+  auto &manager = catalog::Manager::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  epoch_manager.RegisterThread(0);
+
+  catalog::Column column(type::TypeId::INTEGER,
+                         type::Type::GetTypeSize(type::TypeId::INTEGER), "A",
+                         true);
+  std::vector<catalog::Schema> schemas = {catalog::Schema({column})};
+  std::map<oid_t, std::pair<oid_t, oid_t>> column_map;
+  column_map[0] = std::make_pair(0, 0);
+
+  oid_t tile_group_id = manager.GetNextTileGroupId();
+  std::shared_ptr<storage::TileGroup> tile_group(
+      storage::TileGroupFactory::GetTileGroup(INVALID_OID, INVALID_OID,
+                                              tile_group_id, nullptr, schemas,
+                                              column_map, 3));
+  std::weak_ptr<storage::TileGroup> weak_tile_group(tile_group);
+  manager.AddTileGroup(tile_group_id, tile_group);
+
+  auto txn = txn_manager.BeginTransaction();
+  auto resolved = manager.ResolveTileGroup(tile_group_id);
+  EXPECT_EQ(tile_group.get(), resolved);
+
+  // The transaction can still use the tile group after it is dropped
+  manager.DropTileGroup(tile_group_id);
+  tile_group.reset();
+  EXPECT_EQ(nullptr, manager.ResolveTileGroup(tile_group_id));
+  EXPECT_FALSE(weak_tile_group.expired());
+  EXPECT_EQ(tile_group_id, resolved->GetTileGroupId());
+  txn_manager.CommitTransaction(txn);
+
+  // Released once the epoch of the transaction has expired
+  manager.ReleaseRetiredTileGroups(epoch_manager.GetCurrentEpochId());
+  EXPECT_TRUE(weak_tile_group.expired());
+
+  epoch_manager.DeregisterThread(0);
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_map_test.cpp
+//
+// Identification: test/catalog/shard_map_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/shard_map.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Shard Map Tests
+//===--------------------------------------------------------------------===//
+
+class ShardMapTests : public PelotonTest {
+ protected:
+  void TearDown() override {
+    catalog::ShardMap::GetInstance().Configure("", 0, "");
+    PelotonTest::TearDown();
+  }
+};
+
+TEST_F(ShardMapTests, ConfigureTest) {
+  auto &shard_map = catalog::ShardMap::GetInstance();
+
+  // No nodes disable sharding
+  EXPECT_TRUE(shard_map.Configure("", 0, "orders:hash:id"));
+  EXPECT_FALSE(shard_map.IsEnabled());
+  EXPECT_EQ(nullptr, shard_map.GetTable("orders"));
+
+  EXPECT_TRUE(shard_map.Configure("127.0.0.1:15445,127.0.0.1:15446", 1,
+                                  "Orders:hash:Id,items:range:price:10:100"));
+  EXPECT_TRUE(shard_map.IsEnabled());
+  EXPECT_EQ(2U, shard_map.GetNodeCount());
+  EXPECT_EQ(1U, shard_map.GetNodeId());
+  EXPECT_EQ("127.0.0.1:15446", shard_map.GetNodeAddress(1));
+
+  auto orders = shard_map.GetTable("ORDERS");
+  ASSERT_NE(nullptr, orders);
+  EXPECT_EQ("id", orders->key_column);
+  EXPECT_EQ(catalog::ShardingType::HASH, orders->type);
+  auto items = shard_map.GetTable("items");
+  ASSERT_NE(nullptr, items);
+  EXPECT_EQ(catalog::ShardingType::RANGE, items->type);
+  EXPECT_EQ(std::vector<int64_t>({10, 100}), items->bounds);
+  EXPECT_EQ(nullptr, shard_map.GetTable("customers"));
+}
+
+TEST_F(ShardMapTests, InvalidConfigurationTest) {
+  auto &shard_map = catalog::ShardMap::GetInstance();
+  std::string nodes = "127.0.0.1:15445,127.0.0.1:15446";
+
+  EXPECT_FALSE(shard_map.Configure("127.0.0.1", 0, ""));
+  EXPECT_FALSE(shard_map.Configure(nodes, 2, ""));
+  EXPECT_FALSE(shard_map.Configure(nodes, 0, "orders"));
+  EXPECT_FALSE(shard_map.Configure(nodes, 0, "orders:list:id"));
+  EXPECT_FALSE(shard_map.Configure(nodes, 0, "orders:hash:id:10"));
+  EXPECT_FALSE(shard_map.Configure(nodes, 0, "orders:range:id:100:10"));
+  EXPECT_FALSE(shard_map.Configure(nodes, 0, "orders:range:id:ten"));
+
+  // A failed configuration disables sharding
+  EXPECT_FALSE(shard_map.IsEnabled());
+}
+
+TEST_F(ShardMapTests, GetShardTest) {
+  auto &shard_map = catalog::ShardMap::GetInstance();
+  EXPECT_TRUE(shard_map.Configure(
+      "127.0.0.1:15445,127.0.0.1:15446,127.0.0.1:15447", 0,
+      "orders:hash:id,items:range:price:10:100"));
+
+  // Ranges below the first bound, between the bounds and from the last one
+  auto items = shard_map.GetTable("items");
+  EXPECT_EQ(0U, shard_map.GetShard(*items,
+                                   type::ValueFactory::GetIntegerValue(9)));
+  EXPECT_EQ(1U, shard_map.GetShard(*items,
+                                   type::ValueFactory::GetIntegerValue(10)));
+  EXPECT_EQ(1U, shard_map.GetShard(*items,
+                                   type::ValueFactory::GetBigIntValue(99)));
+  EXPECT_EQ(2U, shard_map.GetShard(*items,
+                                   type::ValueFactory::GetIntegerValue(100)));
+
+  // A key of any integer type goes to the same shard, and the keys spread
+  // over every shard
+  auto orders = shard_map.GetTable("orders");
+  std::vector<size_t> counts(shard_map.GetNodeCount(), 0);
+  for (int key = 0; key < 300; key++) {
+    auto shard =
+        shard_map.GetShard(*orders, type::ValueFactory::GetIntegerValue(key));
+    EXPECT_EQ(shard, shard_map.GetShard(
+                         *orders, type::ValueFactory::GetBigIntValue(key)));
+    ASSERT_LT(shard, counts.size());
+    counts[shard]++;
+  }
+  for (auto count : counts) {
+    EXPECT_LT(0U, count);
+  }
+  EXPECT_EQ(shard_map.GetShard(*orders,
+                               type::ValueFactory::GetVarcharValue("abc")),
+            shard_map.GetShard(*orders,
+                               type::ValueFactory::GetVarcharValue("abc")));
+}
+
+}  // End test namespace
+}  // End peloton namespace
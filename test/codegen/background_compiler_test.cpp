@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// background_compiler_test.cpp
+//
+// Identification: test/codegen/background_compiler_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/background_compiler.h"
+#include "codegen/query_cache.h"
+#include "codegen/query_parameters.h"
+#include "common/harness.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class BackgroundCompilerTest : public PelotonCodeGenTest {
+ public:
+  BackgroundCompilerTest() : PelotonCodeGenTest() {
+    LoadTestTable(TableId::_1, 64);
+  }
+
+  ~BackgroundCompilerTest() { codegen::QueryCache::GetInstance().Clear(); }
+};
+
+TEST_F(BackgroundCompilerTest, TieredCompileTest) {
+  // SELECT a, b FROM table1 WHERE a >= 20
+  auto predicate =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20));
+  std::shared_ptr<planner::AbstractPlan> plan(new planner::SeqScanPlan(
+      &GetTestTable(TableId::_1), predicate.release(), {0, 1}));
+  planner::BindingContext context;
+  plan->PerformBinding(context);
+  codegen::QueryParameters parameters{*plan};
+  const auto &signature = parameters.GetSignature();
+
+  // The query is compiled without the optimization passes first
+  auto &background_compiler = codegen::BackgroundCompiler::GetInstance();
+  auto &query_cache = codegen::QueryCache::GetInstance();
+  EXPECT_TRUE(background_compiler.Compile(plan, signature, false));
+  background_compiler.WaitForAll();
+  EXPECT_EQ(0, background_compiler.GetPendingCount());
+
+  auto cached_query = query_cache.Find(signature);
+  ASSERT_NE(nullptr, cached_query);
+  EXPECT_TRUE(cached_query->query->IsParameterized());
+  EXPECT_FALSE(cached_query->query->IsOptimized());
+
+  // Hot queries are compiled again with them
+  background_compiler.SetOptimizeThreshold(2);
+  background_compiler.CountExecution(cached_query);
+  EXPECT_EQ(0, background_compiler.GetPendingCount());
+  background_compiler.CountExecution(cached_query);
+  background_compiler.WaitForAll();
+  background_compiler.SetOptimizeThreshold(16);
+
+  auto optimized_query = query_cache.Find(signature);
+  ASSERT_NE(nullptr, optimized_query);
+  EXPECT_NE(cached_query, optimized_query);
+  EXPECT_TRUE(optimized_query->query->IsOptimized());
+  EXPECT_EQ(1, query_cache.GetCount());
+}
+
+}  // namespace test
+}  // namespace peloton
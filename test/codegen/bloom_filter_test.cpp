@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bloom_filter_test.cpp
+//
+// Identification: test/codegen/bloom_filter_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "codegen/util/bloom_filter.h"
+
+namespace peloton {
+namespace test {
+
+class BloomFilterTest : public PelotonTest {};
+
+TEST_F(BloomFilterTest, NoFalseNegativesTest) {
+  constexpr uint32_t num_entries = 10000;
+
+  codegen::util::BloomFilter bloom_filter;
+  bloom_filter.Init(num_entries);
+
+  std::mt19937_64 generator{12345};
+  std::vector<uint64_t> hashes;
+  for (uint32_t i = 0; i < num_entries; i++) {
+    hashes.push_back(generator());
+    bloom_filter.Add(hashes.back());
+  }
+
+  // Every hash that was added must be found
+  for (auto hash : hashes) {
+    EXPECT_TRUE(bloom_filter.Contains(hash));
+  }
+
+  // Hashes that were never added are found rarely
+  uint32_t false_positives = 0;
+  for (uint32_t i = 0; i < num_entries; i++) {
+    false_positives += bloom_filter.Contains(generator()) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, num_entries / 20);
+}
+
+TEST_F(BloomFilterTest, SizeTest) {
+  codegen::util::BloomFilter bloom_filter;
+
+  // The filter has at least one word, even when it is empty
+  bloom_filter.Init(0);
+  EXPECT_EQ(1, bloom_filter.GetNumWords());
+  EXPECT_FALSE(bloom_filter.Contains(0x1234));
+  bloom_filter.Destroy();
+
+  // Otherwise, it has a power of two words with room for the entries
+  bloom_filter.Init(1000);
+  uint64_t num_words = bloom_filter.GetNumWords();
+  EXPECT_EQ(0, num_words & (num_words - 1));
+  EXPECT_GE(num_words * 64,
+            1000 * codegen::util::BloomFilter::kBitsPerEntry);
+  bloom_filter.Destroy();
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// function_translator_test.cpp
+//
+// Identification: test/codegen/function_translator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "expression/function_expression.h"
+#include "expression/string_functions.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class FunctionTranslatorTest : public PelotonCodeGenTest {
+ public:
+  FunctionTranslatorTest() : PelotonCodeGenTest() {
+    LoadTestTable(TableId::_1, 64);
+  }
+};
+
+TEST_F(FunctionTranslatorTest, StringFunctionInPredicate) {
+  //
+  // SELECT a FROM table WHERE CHAR_LENGTH(d) = 2;
+  //
+  // The values of 'd' are the strings of 10 * row ID + 3, so rows 1 to 9 have
+  // two characters
+  //
+
+  auto *char_length = new expression::FunctionExpression(
+      expression::StringFunctions::CharLength, type::TypeId::INTEGER,
+      {type::TypeId::VARCHAR}, {ColRefExpr(type::TypeId::VARCHAR, 3).release()});
+  std::unique_ptr<expression::AbstractExpression> char_length_ptr{char_length};
+  auto predicate = CmpEqExpr(std::move(char_length_ptr), ConstIntExpr(2));
+
+  planner::SeqScanPlan scan{&GetTestTable(TableId::_1), predicate.release(),
+                            {0}};
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  EXPECT_TRUE(codegen::QueryCompiler::IsSupported(scan));
+
+  codegen::BufferingConsumer buffer{{0}, context};
+  CompileAndExecute(scan, buffer, reinterpret_cast<char *>(buffer.GetState()));
+
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(9, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    EXPECT_EQ(type::CmpBool::CMP_TRUE,
+              results[i].GetValue(0).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(10 * (i + 1))));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
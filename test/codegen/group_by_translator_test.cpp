@@ -95,6 +95,55 @@ TEST_F(GroupByTranslatorTest, SingleColumnGrouping) {
   }
 }
 
+TEST_F(GroupByTranslatorTest, PrefetchingGrouping) {
+  //
+  // SELECT a, count(*) FROM table GROUP BY a;
+  //
+  // The estimated number of groups is large enough for the hash table to be
+  // probed with group prefetching
+  //
+
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  auto *tve_expr =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0);
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR, tve_expr}};
+
+  std::vector<oid_t> gb_cols = {0};
+
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_A"},
+                           {type::TypeId::BIGINT, 8, "COUNT_A"}})};
+
+  std::unique_ptr<planner::AggregatePlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+  agg_plan->SetGroupCardinality(1 << 20);
+
+  std::unique_ptr<planner::AbstractPlan> scan_plan{
+      new planner::SeqScanPlan(&GetTestTable(TestTableId()), nullptr, {0})};
+
+  agg_plan->AddChild(std::move(scan_plan));
+
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*agg_plan, buffer,
+                    reinterpret_cast<char*>(buffer.GetState()));
+
+  // The groups are the same as without prefetching
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(10, results.size());
+  type::Value const_one = type::ValueFactory::GetIntegerValue(1);
+  for (const auto &tuple : results) {
+    EXPECT_TRUE(tuple.GetValue(1).CompareEquals(const_one) == type::CMP_TRUE);
+  }
+}
+
 TEST_F(GroupByTranslatorTest, MultiColumnGrouping) {
   //
   // SELECT a, b, count(*) FROM table GROUP BY a, b;
@@ -129,5 +129,304 @@ TEST_F(HashJoinTranslatorTest, SingleHashJoinColumnTest) {
   }
 }
 
+TEST_F(HashJoinTranslatorTest, RadixPartitionedHashJoinTest) {
+  //
+  // SELECT
+  //   left_table.a, right_table.a, left_table.b, right_table.c,
+  // FROM
+  //   left_table
+  // JOIN
+  //   right_table ON left_table.a = right_table.a
+  //
+  // The build side is estimated to be large enough for both sides to be
+  // partitioned before they are joined
+  //
+
+  DirectMap dm1 = std::make_pair(0, std::make_pair(0, 0));
+  DirectMap dm2 = std::make_pair(1, std::make_pair(1, 0));
+  DirectMap dm3 = std::make_pair(2, std::make_pair(0, 1));
+  DirectMap dm4 = std::make_pair(3, std::make_pair(1, 2));
+  DirectMapList direct_map_list = {dm1, dm2, dm3, dm4};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  auto schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(1),
+                           TestingExecutorUtil::GetColumnInfo(2)}));
+
+  std::vector<AbstractExprPtr> left_hash_keys;
+  left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<AbstractExprPtr> right_hash_keys;
+  right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<AbstractExprPtr> hash_keys;
+  hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::unique_ptr<planner::HashJoinPlan> hj_plan{
+      new planner::HashJoinPlan(JoinType::INNER, nullptr, std::move(projection),
+                                schema, left_hash_keys, right_hash_keys)};
+  hj_plan->SetBuildCardinality(1 << 20);
+  std::unique_ptr<planner::HashPlan> hash_plan{
+      new planner::HashPlan(hash_keys)};
+
+  std::unique_ptr<planner::AbstractPlan> left_scan{
+      new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2})};
+  std::unique_ptr<planner::AbstractPlan> right_scan{
+      new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})};
+
+  hash_plan->AddChild(std::move(right_scan));
+  hj_plan->AddChild(std::move(left_scan));
+  hj_plan->AddChild(std::move(hash_plan));
+
+  planner::BindingContext context;
+  hj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+  CompileAndExecute(*hj_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // The partitioned join finds the same matches as the one that is not
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(20, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+
+    // The build-side values come out of the partitions along with the keys
+    auto left_b = type::ValueFactory::GetIntegerValue(
+        tuple.GetValue(0).GetAs<int32_t>() + 1);
+    EXPECT_EQ(type::CMP_TRUE, tuple.GetValue(2).CompareEquals(left_b));
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, BloomFilterHashJoinTest) {
+  //
+  // SELECT
+  //   left_table.a, right_table.a, left_table.b, right_table.c,
+  // FROM
+  //   left_table
+  // JOIN
+  //   right_table ON left_table.a = right_table.a
+  //
+  // The build side has a cardinality estimate, so the rows of the right table
+  // with no partner on the left are dropped by the Bloom filter
+  //
+
+  DirectMap dm1 = std::make_pair(0, std::make_pair(0, 0));
+  DirectMap dm2 = std::make_pair(1, std::make_pair(1, 0));
+  DirectMap dm3 = std::make_pair(2, std::make_pair(0, 1));
+  DirectMap dm4 = std::make_pair(3, std::make_pair(1, 2));
+  DirectMapList direct_map_list = {dm1, dm2, dm3, dm4};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  auto schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(1),
+                           TestingExecutorUtil::GetColumnInfo(2)}));
+
+  std::vector<AbstractExprPtr> left_hash_keys;
+  left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<AbstractExprPtr> right_hash_keys;
+  right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<AbstractExprPtr> hash_keys;
+  hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::unique_ptr<planner::HashJoinPlan> hj_plan{
+      new planner::HashJoinPlan(JoinType::INNER, nullptr, std::move(projection),
+                                schema, left_hash_keys, right_hash_keys)};
+  hj_plan->SetBuildCardinality(20);
+  std::unique_ptr<planner::HashPlan> hash_plan{
+      new planner::HashPlan(hash_keys)};
+
+  std::unique_ptr<planner::AbstractPlan> left_scan{
+      new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2})};
+  std::unique_ptr<planner::AbstractPlan> right_scan{
+      new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})};
+
+  hash_plan->AddChild(std::move(right_scan));
+  hj_plan->AddChild(std::move(left_scan));
+  hj_plan->AddChild(std::move(hash_plan));
+
+  planner::BindingContext context;
+  hj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+  CompileAndExecute(*hj_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // The filter never drops a row that has a partner
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(20, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, PrefetchingHashJoinTest) {
+  //
+  // SELECT
+  //   left_table.a, right_table.a, left_table.b, right_table.c,
+  // FROM
+  //   left_table
+  // JOIN
+  //   right_table ON left_table.a = right_table.a
+  //
+  // The build side is estimated to be too large for the cache, but not large
+  // enough to be partitioned, so the hash table is probed with prefetching
+  //
+
+  DirectMap dm1 = std::make_pair(0, std::make_pair(0, 0));
+  DirectMap dm2 = std::make_pair(1, std::make_pair(1, 0));
+  DirectMap dm3 = std::make_pair(2, std::make_pair(0, 1));
+  DirectMap dm4 = std::make_pair(3, std::make_pair(1, 2));
+  DirectMapList direct_map_list = {dm1, dm2, dm3, dm4};
+  std::unique_ptr<planner::ProjectInfo> projection{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  auto schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(1),
+                           TestingExecutorUtil::GetColumnInfo(2)}));
+
+  std::vector<AbstractExprPtr> left_hash_keys;
+  left_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<AbstractExprPtr> right_hash_keys;
+  right_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::vector<AbstractExprPtr> hash_keys;
+  hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::unique_ptr<planner::HashJoinPlan> hj_plan{
+      new planner::HashJoinPlan(JoinType::INNER, nullptr, std::move(projection),
+                                schema, left_hash_keys, right_hash_keys)};
+  hj_plan->SetBuildCardinality(1 << 14);
+  std::unique_ptr<planner::HashPlan> hash_plan{
+      new planner::HashPlan(hash_keys)};
+
+  std::unique_ptr<planner::AbstractPlan> left_scan{
+      new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2})};
+  std::unique_ptr<planner::AbstractPlan> right_scan{
+      new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})};
+
+  hash_plan->AddChild(std::move(right_scan));
+  hj_plan->AddChild(std::move(left_scan));
+  hj_plan->AddChild(std::move(hash_plan));
+
+  planner::BindingContext context;
+  hj_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+  CompileAndExecute(*hj_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // Prefetching finds the same matches
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(20, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+  }
+}
+
+TEST_F(HashJoinTranslatorTest, ChainedBloomFilterHashJoinTest) {
+  //
+  // SELECT
+  //   small_table.a, right_table.a
+  // FROM
+  //   left_table
+  // JOIN
+  //   right_table ON left_table.a = right_table.a
+  // JOIN
+  //   left_table AS small_table ON small_table.a = right_table.a
+  // WHERE
+  //   small_table.a < 50
+  //
+  // Both joins probe in the same pipeline. The filter of the upper join has
+  // the smaller build side, so the lower join checks it first.
+  //
+
+  DirectMapList inner_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<planner::ProjectInfo> inner_projection{
+      new planner::ProjectInfo(TargetList{}, std::move(inner_map_list))};
+  auto inner_schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(0)}));
+
+  std::vector<AbstractExprPtr> inner_left_keys;
+  inner_left_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+  std::vector<AbstractExprPtr> inner_right_keys;
+  inner_right_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+  std::vector<AbstractExprPtr> inner_hash_keys;
+  inner_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+
+  std::unique_ptr<planner::HashJoinPlan> inner_join{new planner::HashJoinPlan(
+      JoinType::INNER, nullptr, std::move(inner_projection), inner_schema,
+      inner_left_keys, inner_right_keys)};
+  inner_join->SetBuildCardinality(20);
+  std::unique_ptr<planner::HashPlan> inner_hash{
+      new planner::HashPlan(inner_hash_keys)};
+  inner_hash->AddChild(std::unique_ptr<planner::AbstractPlan>{
+      new planner::SeqScanPlan(&GetRightTable(), nullptr, {0, 1, 2})});
+  inner_join->AddChild(std::unique_ptr<planner::AbstractPlan>{
+      new planner::SeqScanPlan(&GetLeftTable(), nullptr, {0, 1, 2})});
+  inner_join->AddChild(std::move(inner_hash));
+
+  // The upper join probes with right_table.a, the second output column of the
+  // lower join
+  DirectMapList outer_map_list = {{0, {0, 0}}, {1, {1, 1}}};
+  std::unique_ptr<planner::ProjectInfo> outer_projection{
+      new planner::ProjectInfo(TargetList{}, std::move(outer_map_list))};
+  auto outer_schema = std::shared_ptr<const catalog::Schema>(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                           TestingExecutorUtil::GetColumnInfo(0)}));
+
+  std::vector<AbstractExprPtr> outer_left_keys;
+  outer_left_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 0));
+  std::vector<AbstractExprPtr> outer_right_keys;
+  outer_right_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 1));
+  std::vector<AbstractExprPtr> outer_hash_keys;
+  outer_hash_keys.emplace_back(ColRefExpr(type::TypeId::INTEGER, 1));
+
+  auto small_predicate =
+      CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(50));
+  std::unique_ptr<planner::HashJoinPlan> outer_join{new planner::HashJoinPlan(
+      JoinType::INNER, nullptr, std::move(outer_projection), outer_schema,
+      outer_left_keys, outer_right_keys)};
+  outer_join->SetBuildCardinality(5);
+  std::unique_ptr<planner::HashPlan> outer_hash{
+      new planner::HashPlan(outer_hash_keys)};
+  outer_hash->AddChild(std::move(inner_join));
+  outer_join->AddChild(std::unique_ptr<planner::AbstractPlan>{
+      new planner::SeqScanPlan(&GetLeftTable(), small_predicate.release(),
+                               {0})});
+  outer_join->AddChild(std::move(outer_hash));
+
+  planner::BindingContext context;
+  outer_join->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*outer_join, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // Only the rows of the right table matching both build sides are produced
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(5, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(1)));
+    EXPECT_LT(tuple.GetValue(1).GetAs<int32_t>(), 50);
+  }
+}
+
 }  // namespace test
 }  // namespace peloton
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_test.cpp
+//
+// Identification: test/codegen/hash_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/codegen.h"
+#include "codegen/function_builder.h"
+#include "codegen/hash.h"
+#include "codegen/type/bigint_type.h"
+#include "codegen/type/integer_type.h"
+#include "codegen/type/smallint_type.h"
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+class HashTest : public PelotonTest {
+ public:
+  // Build a function that hashes the keys of four rows together and alone,
+  // returning the number of rows whose hashes differ
+  uint32_t CountMismatches(codegen::Hash::HashMethod method, int64_t arg) {
+    static constexpr uint32_t kNumRows = 4;
+
+    codegen::CodeContext code_context;
+    codegen::CodeGen cg{code_context};
+    codegen::FunctionBuilder func{
+        code_context, "test", cg.Int32Type(), {{"x", cg.Int64Type()}}};
+    {
+      llvm::Value *x = func.GetArgumentByPosition(0);
+
+      // The key of the i-th row is (x + i, (int) x * i, (short) i)
+      std::vector<std::vector<codegen::Value>> rows;
+      for (uint32_t i = 0; i < kNumRows; i++) {
+        llvm::Value *col_a = cg->CreateAdd(x, cg.Const64(i));
+        llvm::Value *col_b =
+            cg->CreateTrunc(cg->CreateMul(x, cg.Const64(i)), cg.Int32Type());
+        rows.push_back({{codegen::type::BigInt::Instance(), col_a},
+                        {codegen::type::Integer::Instance(), col_b},
+                        {codegen::type::SmallInt::Instance(), cg.Const16(i)}});
+      }
+
+      auto batch_hashes = codegen::Hash::HashValues(cg, rows, method);
+      EXPECT_EQ(kNumRows, batch_hashes.size());
+
+      llvm::Value *mismatches = cg.Const32(0);
+      for (uint32_t i = 0; i < kNumRows; i++) {
+        llvm::Value *hash = codegen::Hash::HashValues(cg, rows[i], method);
+        llvm::Value *differs = cg->CreateICmpNE(hash, batch_hashes[i]);
+        mismatches = cg->CreateAdd(
+            mismatches, cg->CreateZExt(differs, cg.Int32Type()));
+      }
+      func.ReturnAndFinish(mismatches);
+    }
+
+    EXPECT_TRUE(code_context.Compile());
+
+    typedef uint32_t (*func_t)(int64_t);
+    func_t fn = (func_t)code_context.GetFunctionPointer(func.GetFunction());
+    return fn(arg);
+  }
+};
+
+TEST_F(HashTest, BatchCrc32MatchesScalar) {
+  EXPECT_EQ(0, CountMismatches(codegen::Hash::HashMethod::Crc32, 7));
+  EXPECT_EQ(0, CountMismatches(codegen::Hash::HashMethod::Crc32, -123456789));
+}
+
+TEST_F(HashTest, BatchMurmur3MatchesScalar) {
+  EXPECT_EQ(0, CountMismatches(codegen::Hash::HashMethod::Murmur3, 7));
+  EXPECT_EQ(0, CountMismatches(codegen::Hash::HashMethod::Murmur3, -123456789));
+}
+
+}  // namespace test
+}  // namespace peloton
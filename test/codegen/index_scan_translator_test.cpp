@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_scan_translator_test.cpp
+//
+// Identification: test/codegen/index_scan_translator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/schema.h"
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "expression/comparison_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "index/index_factory.h"
+#include "planner/index_scan_plan.h"
+#include "storage/data_table.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class IndexScanTranslatorTest : public PelotonCodeGenTest {
+ public:
+  IndexScanTranslatorTest() : PelotonCodeGenTest(), num_rows_to_insert(64) {
+    // Index column 'a' of the test table before loading it, so that the
+    // inserts also go into the index
+    auto &table = GetTestTable(TestTableId());
+    auto *tuple_schema = table.GetSchema();
+    std::vector<oid_t> key_attrs = {0};
+    auto *key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+    key_schema->SetIndexedColumns(key_attrs);
+
+    auto *index_metadata = new index::IndexMetadata(
+        "table1_a_index", 125, table.GetOid(), table.GetDatabaseOid(),
+        IndexType::BWTREE, IndexConstraintType::DEFAULT, tuple_schema,
+        key_schema, key_attrs, false);
+    std::shared_ptr<index::Index> index{
+        index::IndexFactory::GetIndex(index_metadata)};
+    table.AddIndex(index);
+
+    LoadTestTable(TestTableId(), num_rows_to_insert);
+  }
+
+  uint32_t NumRowsInTestTable() const { return num_rows_to_insert; }
+
+  TableId TestTableId() { return TableId::_1; }
+
+  // An index scan of the test table for rows whose 'a' compares to the value
+  // as given
+  std::unique_ptr<planner::IndexScanPlan> IndexScan(
+      ExpressionType expr_type, int32_t value,
+      expression::AbstractExpression *predicate,
+      const std::vector<oid_t> &column_ids) {
+    auto &table = GetTestTable(TestTableId());
+    std::vector<type::Value> values = {
+        type::ValueFactory::GetIntegerValue(value).Copy()};
+    planner::IndexScanPlan::IndexScanDesc index_scan_desc{
+        table.GetIndex(0), {0}, {expr_type}, values, {}};
+    return std::unique_ptr<planner::IndexScanPlan>{new planner::IndexScanPlan(
+        &table, predicate, column_ids, index_scan_desc)};
+  }
+
+ private:
+  uint32_t num_rows_to_insert = 64;
+};
+
+TEST_F(IndexScanTranslatorTest, SimpleIndexScan) {
+  //
+  // SELECT a, b FROM table WHERE a <= 110;
+  //
+
+  auto scan =
+      IndexScan(ExpressionType::COMPARE_LESSTHANOREQUALTO, 110, nullptr, {0, 1});
+
+  // Do binding
+  planner::BindingContext context;
+  scan->PerformBinding(context);
+
+  // Printing consumer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*scan, buffer, reinterpret_cast<char *>(buffer.GetState()));
+
+  // The values of 'a' are 10 * row ID, so the rows 0 to 11 qualify
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(12, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_TRUE(tuple.GetValue(0).CompareLessThanEquals(
+                    type::ValueFactory::GetIntegerValue(110)) ==
+                type::CMP_TRUE);
+    EXPECT_TRUE(tuple.GetValue(1).CompareEquals(tuple.GetValue(0).Add(
+                    type::ValueFactory::GetIntegerValue(1))) ==
+                type::CMP_TRUE);
+  }
+}
+
+TEST_F(IndexScanTranslatorTest, IndexScanWithPredicate) {
+  //
+  // SELECT a, b FROM table WHERE a >= 500 AND b < 701;
+  //
+  // Only the condition on 'a' is answered by the index
+  //
+
+  auto b_lt_701 =
+      CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(701));
+  auto scan = IndexScan(ExpressionType::COMPARE_GREATERTHANOREQUALTO, 500,
+                        b_lt_701.release(), {0, 1});
+
+  // Do binding
+  planner::BindingContext context;
+  scan->PerformBinding(context);
+
+  // Printing consumer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*scan, buffer, reinterpret_cast<char *>(buffer.GetState()));
+
+  // The rows whose 'a' is in [500, 690] qualify
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(20, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_TRUE(tuple.GetValue(0).CompareGreaterThanEquals(
+                    type::ValueFactory::GetIntegerValue(500)) ==
+                type::CMP_TRUE);
+    EXPECT_TRUE(tuple.GetValue(1).CompareLessThan(
+                    type::ValueFactory::GetIntegerValue(701)) ==
+                type::CMP_TRUE);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// insert_translator_test.cpp
+//
+// Identification: test/codegen/insert_translator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/testing_codegen_util.h"
+
+#include "planner/insert_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+class InsertTranslatorTest : public PelotonCodeGenTest {
+ public:
+  InsertTranslatorTest() : PelotonCodeGenTest() {}
+
+  size_t GetCurrentTableSize(TableId table_id) {
+    planner::SeqScanPlan scan{&GetTestTable(table_id), nullptr, {0, 1}};
+    planner::BindingContext context;
+    scan.PerformBinding(context);
+
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+    CompileAndExecute(scan, buffer, reinterpret_cast<char*>(buffer.GetState()));
+    return buffer.GetOutputTuples().size();
+  }
+
+  uint32_t NumRowsInTestTable() const { return num_rows_to_insert; }
+
+ private:
+  uint32_t num_rows_to_insert = 64;
+};
+
+TEST_F(InsertTranslatorTest, InsertOneTuple) {
+  //
+  // INSERT INTO table2 VALUES (0, 1, 2, 'hello');
+  //
+
+  auto &table = GetTestTable(TableId::_2);
+  std::unique_ptr<storage::Tuple> tuple{
+      new storage::Tuple(table.GetSchema(), true)};
+  tuple->SetValue(0, type::ValueFactory::GetIntegerValue(0));
+  tuple->SetValue(1, type::ValueFactory::GetIntegerValue(1));
+  tuple->SetValue(2, type::ValueFactory::GetDecimalValue(2));
+  tuple->SetValue(3, type::ValueFactory::GetVarcharValue("hello"));
+
+  std::unique_ptr<planner::InsertPlan> insert_plan{
+      new planner::InsertPlan(&table, std::move(tuple))};
+
+  planner::BindingContext context;
+  insert_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*insert_plan, buffer,
+                    reinterpret_cast<char*>(buffer.GetState()));
+
+  EXPECT_EQ(1, GetCurrentTableSize(TableId::_2));
+}
+
+TEST_F(InsertTranslatorTest, InsertFromScan) {
+  //
+  // INSERT INTO table2 SELECT * FROM table1;
+  //
+
+  LoadTestTable(TableId::_1, NumRowsInTestTable());
+
+  std::unique_ptr<planner::InsertPlan> insert_plan{
+      new planner::InsertPlan(&GetTestTable(TableId::_2))};
+  std::unique_ptr<planner::AbstractPlan> scan{new planner::SeqScanPlan(
+      &GetTestTable(TableId::_1), nullptr, {0, 1, 2, 3})};
+  insert_plan->AddChild(std::move(scan));
+
+  planner::BindingContext context;
+  insert_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecute(*insert_plan, buffer,
+                    reinterpret_cast<char*>(buffer.GetState()));
+
+  // Every row was copied, the source table is left untouched
+  EXPECT_EQ(NumRowsInTestTable(), GetCurrentTableSize(TableId::_2));
+  EXPECT_EQ(NumRowsInTestTable(), GetCurrentTableSize(TableId::_1));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,66 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// like_translator_test.cpp
+//
+// Identification: test/codegen/like_translator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class LikeTranslatorTest : public PelotonCodeGenTest {
+ public:
+  LikeTranslatorTest() : PelotonCodeGenTest() {
+    LoadTestTable(TableId::_1, 64);
+  }
+
+  // The number of rows of the test table whose column 'd' matches the pattern.
+  // The values of 'd' are the strings of 10 * row ID + 3.
+  uint32_t CountMatches(ExpressionType like_type, const std::string &pattern) {
+    auto *like = new expression::ComparisonExpression(
+        like_type, ColRefExpr(type::TypeId::VARCHAR, 3).release(),
+        new expression::ConstantValueExpression(
+            type::ValueFactory::GetVarcharValue(pattern)));
+    planner::SeqScanPlan scan{&GetTestTable(TableId::_1), like, {0}};
+    planner::BindingContext context;
+    scan.PerformBinding(context);
+
+    codegen::BufferingConsumer buffer{{0}, context};
+    CompileAndExecute(scan, buffer, reinterpret_cast<char *>(buffer.GetState()));
+    return buffer.GetOutputTuples().size();
+  }
+};
+
+TEST_F(LikeTranslatorTest, ConstantPatterns) {
+  // Prefix, suffix and substring matches
+  EXPECT_EQ(11, CountMatches(ExpressionType::COMPARE_LIKE, "1%"));
+  EXPECT_EQ(64, CountMatches(ExpressionType::COMPARE_LIKE, "%3"));
+  EXPECT_EQ(16, CountMatches(ExpressionType::COMPARE_LIKE, "%2%"));
+  EXPECT_EQ(64, CountMatches(ExpressionType::COMPARE_LIKE, "%"));
+  EXPECT_EQ(53, CountMatches(ExpressionType::COMPARE_NOTLIKE, "1%"));
+}
+
+TEST_F(LikeTranslatorTest, GeneralPatterns) {
+  // Patterns that need the general matcher
+  EXPECT_EQ(9, CountMatches(ExpressionType::COMPARE_LIKE, "_3"));
+  EXPECT_EQ(1, CountMatches(ExpressionType::COMPARE_LIKE, "13"));
+  EXPECT_EQ(10, CountMatches(ExpressionType::COMPARE_LIKE, "1_3"));
+  EXPECT_EQ(1, CountMatches(ExpressionType::COMPARE_LIKE, "1%3%3"));
+  EXPECT_EQ(0, CountMatches(ExpressionType::COMPARE_LIKE, "1\\%"));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// limit_translator_test.cpp
+//
+// Identification: test/codegen/limit_translator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "planner/limit_plan.h"
+#include "planner/order_by_plan.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class LimitTranslatorTest : public PelotonCodeGenTest {
+ public:
+  LimitTranslatorTest() : PelotonCodeGenTest() {
+    LoadTestTable(TestTableId(), NumRows());
+  }
+
+  uint32_t NumRows() const { return 20; }
+
+  TableId TestTableId() const { return TableId::_1; }
+};
+
+TEST_F(LimitTranslatorTest, LimitWithOffset) {
+  //
+  // SELECT a, b FROM table1 LIMIT 5 OFFSET 3;
+  //
+
+  std::unique_ptr<planner::AbstractPlan> limit_plan{
+      new planner::LimitPlan(5, 3)};
+  std::unique_ptr<planner::AbstractPlan> scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(TestTableId()), nullptr, {0, 1})};
+  limit_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  limit_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*limit_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // The scan produces the rows in order, the fourth to the eigth pass
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(5, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    EXPECT_EQ(type::CMP_TRUE, results[i].GetValue(0).CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(
+                                      10 * (i + 3))));
+  }
+}
+
+TEST_F(LimitTranslatorTest, LimitLargerThanInput) {
+  //
+  // SELECT a FROM table1 LIMIT 100;
+  //
+
+  std::unique_ptr<planner::AbstractPlan> limit_plan{
+      new planner::LimitPlan(100, 0)};
+  std::unique_ptr<planner::AbstractPlan> scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(TestTableId()), nullptr, {0})};
+  limit_plan->AddChild(std::move(scan_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  limit_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*limit_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  EXPECT_EQ(NumRows(), buffer.GetOutputTuples().size());
+}
+
+TEST_F(LimitTranslatorTest, TopNWithOffset) {
+  //
+  // SELECT a, b FROM table1 ORDER BY a DESC LIMIT 3 OFFSET 1;
+  //
+
+  std::unique_ptr<planner::AbstractPlan> limit_plan{
+      new planner::LimitPlan(3, 1)};
+  std::unique_ptr<planner::OrderByPlan> order_by_plan{
+      new planner::OrderByPlan({0}, {true}, {0, 1})};
+  order_by_plan->SetLimit(true);
+  order_by_plan->SetLimitNumber(3);
+  order_by_plan->SetLimitOffset(1);
+  std::unique_ptr<planner::AbstractPlan> scan_plan{new planner::SeqScanPlan(
+      &GetTestTable(TestTableId()), nullptr, {0, 1})};
+  order_by_plan->AddChild(std::move(scan_plan));
+  limit_plan->AddChild(std::move(order_by_plan));
+
+  // Do binding
+  planner::BindingContext context;
+  limit_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*limit_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // The sort keeps the four largest values of 'a', the limit skips the first
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(3, results.size());
+  for (uint32_t i = 0; i < results.size(); i++) {
+    EXPECT_EQ(type::CMP_TRUE, results[i].GetValue(0).CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(
+                                      10 * (NumRows() - 2 - i))));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
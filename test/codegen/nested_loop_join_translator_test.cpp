@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// nested_loop_join_translator_test.cpp
+//
+// Identification: test/codegen/nested_loop_join_translator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "expression/comparison_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/nested_loop_join_plan.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class NestedLoopJoinTranslatorTest : public PelotonCodeGenTest {
+ public:
+  NestedLoopJoinTranslatorTest() : PelotonCodeGenTest() {
+    LoadTestTable(LeftTableId(), NumLeftRows());
+    LoadTestTable(RightTableId(), 2 * NumLeftRows());
+  }
+
+  uint32_t NumLeftRows() const { return 10; }
+
+  TableId LeftTableId() const { return TableId::_1; }
+
+  TableId RightTableId() const { return TableId::_2; }
+
+  // A reference to a column of the right side of the join
+  std::unique_ptr<expression::AbstractExpression> RightColRefExpr(
+      type::TypeId type, uint32_t col_id) {
+    return std::unique_ptr<expression::AbstractExpression>{
+        new expression::TupleValueExpression(type, 1, col_id)};
+  }
+
+  // Join both tables on the given predicate, producing the columns 'a' and 'b'
+  // of the left side, followed by the ones of the right side
+  std::unique_ptr<planner::AbstractPlan> JoinPlan(
+      std::unique_ptr<expression::AbstractExpression> &&predicate) {
+    DirectMapList direct_map_list = {
+        {0, {0, 0}}, {1, {0, 1}}, {2, {1, 0}}, {3, {1, 1}}};
+    std::unique_ptr<const planner::ProjectInfo> projection{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+    std::shared_ptr<const catalog::Schema> schema{
+        new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(1),
+                             TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(1)})};
+
+    std::unique_ptr<const expression::AbstractExpression> join_predicate{
+        std::move(predicate)};
+    std::unique_ptr<planner::AbstractPlan> nlj_plan{
+        new planner::NestedLoopJoinPlan(JoinType::INNER,
+                                       std::move(join_predicate),
+                                       std::move(projection), schema)};
+    std::unique_ptr<planner::AbstractPlan> left_scan{new planner::SeqScanPlan(
+        &GetTestTable(LeftTableId()), nullptr, {0, 1})};
+    std::unique_ptr<planner::AbstractPlan> right_scan{new planner::SeqScanPlan(
+        &GetTestTable(RightTableId()), nullptr, {0, 1})};
+    nlj_plan->AddChild(std::move(left_scan));
+    nlj_plan->AddChild(std::move(right_scan));
+    return nlj_plan;
+  }
+};
+
+TEST_F(NestedLoopJoinTranslatorTest, EquiJoin) {
+  //
+  // SELECT l.a, l.b, r.a, r.b FROM table1 l JOIN table2 r ON l.a = r.a;
+  //
+
+  auto nlj_plan = JoinPlan(CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, 0),
+                                     RightColRefExpr(type::TypeId::INTEGER, 0)));
+
+  // Do binding
+  planner::BindingContext context;
+  nlj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*nlj_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // Every row of the left table has exactly one match in the right table
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(NumLeftRows(), results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_TRUE,
+              tuple.GetValue(0).CompareEquals(tuple.GetValue(2)));
+    EXPECT_EQ(type::CMP_TRUE,
+              tuple.GetValue(1).CompareEquals(tuple.GetValue(3)));
+  }
+}
+
+TEST_F(NestedLoopJoinTranslatorTest, NonEquiJoin) {
+  //
+  // SELECT l.a, l.b, r.a, r.b FROM table1 l JOIN table2 r ON l.a > r.a;
+  //
+
+  auto nlj_plan = JoinPlan(CmpGtExpr(ColRefExpr(type::TypeId::INTEGER, 0),
+                                     RightColRefExpr(type::TypeId::INTEGER, 0)));
+
+  // Do binding
+  planner::BindingContext context;
+  nlj_plan->PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(*nlj_plan, buffer,
+                    reinterpret_cast<char *>(buffer.GetState()));
+
+  // The i-th row of the left table matches the first i rows of the right one
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(NumLeftRows() * (NumLeftRows() - 1) / 2, results.size());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_TRUE,
+              tuple.GetValue(0).CompareGreaterThan(tuple.GetValue(2)));
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
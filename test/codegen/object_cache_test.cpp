@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// object_cache_test.cpp
+//
+// Identification: test/codegen/object_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/buffering_consumer.h"
+#include "codegen/object_cache.h"
+#include "codegen/query_compiler.h"
+#include "codegen/query_parameters.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "planner/seq_scan_plan.h"
+#include "util/file_util.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class ObjectCacheTest : public PelotonCodeGenTest {
+ public:
+  ObjectCacheTest() : PelotonCodeGenTest() {
+    LoadTestTable(TableId::_1, num_rows_to_insert);
+    directory_ = FileUtil::CreateTempDirectory("object_cache_test");
+    codegen::ObjectCache::GetInstance().SetDirectory(directory_);
+  }
+
+  ~ObjectCacheTest() {
+    codegen::ObjectCache::GetInstance().SetDirectory("");
+    FileUtil::RemoveDirectory(directory_);
+  }
+
+  // SELECT a, b FROM table_id WHERE a >= value
+  std::unique_ptr<planner::AbstractPlan> ScanPlan(TableId table_id,
+                                                  int64_t value) {
+    auto predicate =
+        CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(value));
+    return std::unique_ptr<planner::AbstractPlan>(new planner::SeqScanPlan(
+        &GetTestTable(table_id), predicate.release(), {0, 1}));
+  }
+
+  // Compile the plan with its parameters, and return the number of results
+  // of the query
+  size_t CompileAndExecute(planner::AbstractPlan &plan, bool optimize,
+                           codegen::QueryCompiler::CompileStats &stats) {
+    planner::BindingContext context;
+    plan.PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+    codegen::QueryParameters parameters{plan};
+    codegen::QueryCompiler compiler{optimize};
+    auto query = compiler.Compile(plan, buffer, &stats, &parameters);
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction();
+    executor::ExecutorContext executor_context{txn};
+    query->Execute(*txn, &executor_context,
+                   reinterpret_cast<char *>(buffer.GetState()), nullptr,
+                   &parameters);
+    txn_manager.CommitTransaction(txn);
+    return buffer.GetOutputTuples().size();
+  }
+
+  uint32_t num_rows_to_insert = 64;
+
+  std::string directory_;
+};
+
+TEST_F(ObjectCacheTest, KeyTest) {
+  auto plan_20 = ScanPlan(TableId::_1, 20);
+  auto plan_300 = ScanPlan(TableId::_1, 300);
+  auto plan_table_2 = ScanPlan(TableId::_2, 20);
+  codegen::QueryParameters parameters_20{*plan_20};
+  codegen::QueryParameters parameters_300{*plan_300};
+  codegen::QueryParameters parameters_table_2{*plan_table_2};
+
+  // The key only depends on the shape of the plan and on its tables
+  EXPECT_EQ(codegen::ObjectCache::GetKey(parameters_20, true),
+            codegen::ObjectCache::GetKey(parameters_300, true));
+  EXPECT_NE(codegen::ObjectCache::GetKey(parameters_20, true),
+            codegen::ObjectCache::GetKey(parameters_20, false));
+  EXPECT_NE(codegen::ObjectCache::GetKey(parameters_20, true),
+            codegen::ObjectCache::GetKey(parameters_table_2, true));
+}
+
+TEST_F(ObjectCacheTest, LoadTest) {
+  auto &object_cache = codegen::ObjectCache::GetInstance();
+  ASSERT_TRUE(object_cache.IsEnabled());
+  auto load_count = object_cache.GetLoadCount();
+  auto store_count = object_cache.GetStoreCount();
+
+  // The first compilation stores the object
+  codegen::QueryCompiler::CompileStats stats;
+  auto plan_20 = ScanPlan(TableId::_1, 20);
+  EXPECT_EQ(num_rows_to_insert - 2, CompileAndExecute(*plan_20, true, stats));
+  EXPECT_FALSE(stats.loaded_from_cache);
+  EXPECT_EQ(store_count + 1, object_cache.GetStoreCount());
+  EXPECT_EQ(1U, FileUtil::ListDirectory(directory_).size());
+
+  // The plans of the same shape load it, and run with their own constants
+  auto plan_300 = ScanPlan(TableId::_1, 300);
+  EXPECT_EQ(num_rows_to_insert - 30,
+            CompileAndExecute(*plan_300, true, stats));
+  EXPECT_TRUE(stats.loaded_from_cache);
+  EXPECT_EQ(load_count + 1, object_cache.GetLoadCount());
+  EXPECT_EQ(store_count + 1, object_cache.GetStoreCount());
+
+  // The unoptimized code is kept apart
+  EXPECT_EQ(num_rows_to_insert - 30,
+            CompileAndExecute(*plan_300, false, stats));
+  EXPECT_FALSE(stats.loaded_from_cache);
+  EXPECT_EQ(2U, FileUtil::ListDirectory(directory_).size());
+
+  // Nothing is stored or loaded once the cache is disabled
+  object_cache.SetDirectory("");
+  EXPECT_EQ(num_rows_to_insert - 2, CompileAndExecute(*plan_20, true, stats));
+  EXPECT_FALSE(stats.loaded_from_cache);
+  EXPECT_EQ(load_count + 1, object_cache.GetLoadCount());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// parallel_scan_test.cpp
+//
+// Identification: test/codegen/parallel_scan_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/buffering_consumer.h"
+#include "codegen/operator/hash_group_by_translator.h"
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "executor/executor_context.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class ParallelScanTest : public PelotonCodeGenTest {
+ public:
+  ParallelScanTest() : PelotonCodeGenTest() {
+    // The scheduler starts its threads on the first parallel scan
+    FLAGS_codegen_parallel_scan_threads = 4;
+    LoadTestTable(TableId::_1, NumRows());
+  }
+
+  // 32 tile groups of 32 tuples each
+  uint32_t NumRows() const { return 1024; }
+
+  // Compile and execute the plan in a read-only transaction, whose scans run
+  // in parallel
+  void CompileAndExecuteReadOnly(const planner::AbstractPlan &plan,
+                                 codegen::BufferingConsumer &consumer) {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
+
+    codegen::QueryCompiler compiler;
+    auto compiled_query = compiler.Compile(plan, consumer);
+
+    executor::ExecutorContext executor_context{txn};
+    compiled_query->Execute(*txn, &executor_context,
+                            reinterpret_cast<char *>(consumer.GetState()));
+
+    txn_manager.CommitTransaction(txn);
+  }
+};
+
+TEST_F(ParallelScanTest, GlobalAggregation) {
+  //
+  // SELECT COUNT(*), SUM(a), MIN(b), MAX(a) FROM table1;
+  //
+
+  DirectMapList direct_map_list = {
+      {0, {1, 0}}, {1, {1, 1}}, {2, {1, 2}}, {3, {1, 3}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)},
+      {ExpressionType::AGGREGATE_SUM,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)},
+      {ExpressionType::AGGREGATE_MIN,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)},
+      {ExpressionType::AGGREGATE_MAX,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)}};
+
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::BIGINT, 8, "COUNT"},
+                           {type::TypeId::INTEGER, 4, "SUM_A"},
+                           {type::TypeId::INTEGER, 4, "MIN_B"},
+                           {type::TypeId::INTEGER, 4, "MAX_A"}})};
+
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), {}, output_schema,
+      AggregateType::PLAIN)};
+  std::unique_ptr<planner::AbstractPlan> scan_plan{
+      new planner::SeqScanPlan(&GetTestTable(TableId::_1), nullptr, {0, 1})};
+  agg_plan->AddChild(std::move(scan_plan));
+
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1, 2, 3}, context};
+  CompileAndExecuteReadOnly(*agg_plan, buffer);
+
+  // The aggregates of all threads are merged into a single row. The values of
+  // 'a' are 10 * row ID, the ones of 'b' are 10 * row ID + 1.
+  const auto &results = buffer.GetOutputTuples();
+  ASSERT_EQ(1, results.size());
+  EXPECT_TRUE(results[0].GetValue(0).CompareEquals(
+                  type::ValueFactory::GetBigIntValue(NumRows())) ==
+              type::CMP_TRUE);
+  EXPECT_TRUE(results[0].GetValue(1).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(
+                      10 * (NumRows() - 1) * NumRows() / 2)) == type::CMP_TRUE);
+  EXPECT_TRUE(results[0].GetValue(2).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(1)) == type::CMP_TRUE);
+  EXPECT_TRUE(results[0].GetValue(3).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(10 * (NumRows() - 1))) ==
+              type::CMP_TRUE);
+}
+
+TEST_F(ParallelScanTest, HashAggregation) {
+  //
+  // SELECT a, COUNT(*) FROM table1 GROUP BY a;
+  //
+
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_COUNT_STAR,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)}};
+  std::vector<oid_t> gb_cols = {0};
+
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_A"},
+                           {type::TypeId::BIGINT, 8, "COUNT_A"}})};
+
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+  std::unique_ptr<planner::AbstractPlan> scan_plan{
+      new planner::SeqScanPlan(&GetTestTable(TableId::_1), nullptr, {0})};
+  agg_plan->AddChild(std::move(scan_plan));
+
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecuteReadOnly(*agg_plan, buffer);
+
+  // The groups of all threads are merged, every value of 'a' is unique
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(NumRows(), results.size());
+  type::Value const_one = type::ValueFactory::GetBigIntValue(1);
+  for (const auto &tuple : results) {
+    EXPECT_TRUE(tuple.GetValue(1).CompareEquals(const_one) == type::CMP_TRUE);
+  }
+}
+
+TEST_F(ParallelScanTest, PartitionedHashAggregation) {
+  //
+  // SELECT b, SUM(a) FROM table1 GROUP BY b;
+  //
+  // The groups of the threads are merged in partitions on several threads
+  //
+
+  codegen::HashGroupByTranslator::kUsePartitionedMerge = true;
+
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<planner::ProjectInfo> proj_info{
+      new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+      {ExpressionType::AGGREGATE_SUM,
+       new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)}};
+  std::vector<oid_t> gb_cols = {1};
+
+  std::shared_ptr<const catalog::Schema> output_schema{
+      new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_B"},
+                           {type::TypeId::INTEGER, 4, "SUM_A"}})};
+
+  std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+      std::move(proj_info), nullptr, std::move(agg_terms), std::move(gb_cols),
+      output_schema, AggregateType::HASH)};
+  std::unique_ptr<planner::AbstractPlan> scan_plan{
+      new planner::SeqScanPlan(&GetTestTable(TableId::_1), nullptr, {0, 1})};
+  agg_plan->AddChild(std::move(scan_plan));
+
+  planner::BindingContext context;
+  agg_plan->PerformBinding(context);
+
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  CompileAndExecuteReadOnly(*agg_plan, buffer);
+  codegen::HashGroupByTranslator::kUsePartitionedMerge = false;
+
+  // Every group is produced once, from the partition it was merged into. The
+  // values of 'b' are 10 * row ID + 1, the ones of 'a' are 10 * row ID.
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(NumRows(), results.size());
+  for (const auto &tuple : results) {
+    type::Value sum_a = tuple.GetValue(0).Subtract(
+        type::ValueFactory::GetIntegerValue(1));
+    EXPECT_TRUE(tuple.GetValue(1).CompareEquals(sum_a) == type::CMP_TRUE);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_cache_test.cpp
+//
+// Identification: test/codegen/query_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "catalog/catalog.h"
+#include "codegen/buffering_consumer.h"
+#include "codegen/query_cache.h"
+#include "codegen/query_compiler.h"
+#include "codegen/query_parameters.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "planner/seq_scan_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class QueryCacheTest : public PelotonCodeGenTest {
+ public:
+  QueryCacheTest() : PelotonCodeGenTest() {
+    LoadTestTable(TableId::_1, num_rows_to_insert);
+  }
+
+  ~QueryCacheTest() { codegen::QueryCache::GetInstance().Clear(); }
+
+  // SELECT a, b FROM table1 WHERE a >= value
+  std::shared_ptr<planner::AbstractPlan> ScanPlan(int64_t value) {
+    auto predicate =
+        CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(value));
+    return std::shared_ptr<planner::AbstractPlan>(new planner::SeqScanPlan(
+        &GetTestTable(TableId::_1), predicate.release(), {0, 1}));
+  }
+
+  // Execute the query for the given plan, and return the number of results
+  size_t Execute(codegen::Query &query, planner::AbstractPlan &plan) {
+    planner::BindingContext context;
+    plan.PerformBinding(context);
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+    codegen::QueryParameters parameters{plan};
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto *txn = txn_manager.BeginTransaction();
+    executor::ExecutorContext executor_context{txn};
+    query.Execute(*txn, &executor_context,
+                  reinterpret_cast<char *>(buffer.GetState()), nullptr,
+                  &parameters);
+    txn_manager.CommitTransaction(txn);
+    return buffer.GetOutputTuples().size();
+  }
+
+  uint32_t num_rows_to_insert = 64;
+};
+
+TEST_F(QueryCacheTest, SignatureTest) {
+  auto plan_20 = ScanPlan(20);
+  auto plan_300 = ScanPlan(300);
+  codegen::QueryParameters parameters_20{*plan_20};
+  codegen::QueryParameters parameters_300{*plan_300};
+
+  // The constants are parameters, and the predicate is passed on to the zone
+  // map checks
+  EXPECT_EQ(parameters_20.GetSignature(), parameters_300.GetSignature());
+  EXPECT_EQ(2, parameters_20.GetParameterCount());
+  EXPECT_EQ(1, parameters_20.GetTableOids().size());
+
+  // Comparing to another column changes the shape
+  auto predicate = CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 1),
+                              ConstIntExpr(20));
+  planner::SeqScanPlan plan_b{&GetTestTable(TableId::_1), predicate.release(),
+                              {0, 1}};
+  codegen::QueryParameters parameters_b{plan_b};
+  EXPECT_NE(parameters_20.GetSignature(), parameters_b.GetSignature());
+}
+
+TEST_F(QueryCacheTest, ReuseTest) {
+  auto plan_20 = ScanPlan(20);
+  codegen::QueryParameters parameters_20{*plan_20};
+
+  // Compile the query for the first plan
+  planner::BindingContext context;
+  plan_20->PerformBinding(context);
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+  codegen::QueryCompiler compiler;
+  auto query = compiler.Compile(*plan_20, buffer, nullptr, &parameters_20);
+  EXPECT_TRUE(query->IsParameterized());
+
+  auto &query_cache = codegen::QueryCache::GetInstance();
+  query_cache.Add(plan_20, std::move(query), parameters_20);
+  EXPECT_EQ(1, query_cache.GetCount());
+
+  // The query runs with the constants of every plan of the same shape
+  auto plan_300 = ScanPlan(300);
+  codegen::QueryParameters parameters_300{*plan_300};
+  auto cached_query = query_cache.Find(parameters_300.GetSignature());
+  ASSERT_NE(nullptr, cached_query);
+  EXPECT_EQ(num_rows_to_insert - 2, Execute(*cached_query->query, *plan_20));
+  EXPECT_EQ(num_rows_to_insert - 30,
+            Execute(*cached_query->query, *plan_300));
+
+  // Dropping the table drops its queries
+  query_cache.RemoveTable(GetDatabase().GetOid(),
+                          static_cast<oid_t>(TableId::_2));
+  EXPECT_EQ(1, query_cache.GetCount());
+  query_cache.RemoveTable(GetDatabase().GetOid(),
+                          static_cast<oid_t>(TableId::_1));
+  EXPECT_EQ(0, query_cache.GetCount());
+  EXPECT_EQ(nullptr, query_cache.Find(parameters_300.GetSignature()));
+}
+
+}  // namespace test
+}  // namespace peloton
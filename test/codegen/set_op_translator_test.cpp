@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// set_op_translator_test.cpp
+//
+// Identification: test/codegen/set_op_translator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/query_compiler.h"
+#include "common/harness.h"
+#include "planner/seq_scan_plan.h"
+#include "planner/set_op_plan.h"
+
+#include "codegen/testing_codegen_util.h"
+
+namespace peloton {
+namespace test {
+
+class SetOpTranslatorTest : public PelotonCodeGenTest {
+ public:
+  SetOpTranslatorTest() : PelotonCodeGenTest() {
+    LoadTestTable(TableId::_1, NumRows());
+    LoadTestTable(TableId::_2, 2 * NumRows());
+  }
+
+  uint32_t NumRows() const { return 20; }
+
+  // Execute the set operation on the columns 'a' and 'b' of the given tables
+  void ExecuteSetOp(SetOpType set_op, TableId left_table, TableId right_table,
+                    std::vector<codegen::WrappedTuple> &results) {
+    std::unique_ptr<planner::AbstractPlan> set_op_plan{
+        new planner::SetOpPlan(set_op)};
+    std::unique_ptr<planner::AbstractPlan> left_scan{new planner::SeqScanPlan(
+        &GetTestTable(left_table), nullptr, {0, 1})};
+    std::unique_ptr<planner::AbstractPlan> right_scan{new planner::SeqScanPlan(
+        &GetTestTable(right_table), nullptr, {0, 1})};
+    set_op_plan->AddChild(std::move(left_scan));
+    set_op_plan->AddChild(std::move(right_scan));
+
+    // Do binding
+    planner::BindingContext context;
+    set_op_plan->PerformBinding(context);
+
+    // We collect the results of the query into an in-memory buffer
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+
+    // COMPILE and execute
+    CompileAndExecute(*set_op_plan, buffer,
+                      reinterpret_cast<char *>(buffer.GetState()));
+    results = buffer.GetOutputTuples();
+  }
+};
+
+TEST_F(SetOpTranslatorTest, Intersect) {
+  //
+  // SELECT a, b FROM table2 INTERSECT SELECT a, b FROM table1;
+  //
+
+  std::vector<codegen::WrappedTuple> results;
+  ExecuteSetOp(SetOpType::INTERSECT, TableId::_2, TableId::_1, results);
+
+  // The rows of the smaller table are all in the larger one
+  EXPECT_EQ(NumRows(), results.size());
+  type::Value max_a = type::ValueFactory::GetIntegerValue(10 * NumRows());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_TRUE, tuple.GetValue(0).CompareLessThan(max_a));
+  }
+}
+
+TEST_F(SetOpTranslatorTest, Except) {
+  //
+  // SELECT a, b FROM table2 EXCEPT SELECT a, b FROM table1;
+  //
+
+  std::vector<codegen::WrappedTuple> results;
+  ExecuteSetOp(SetOpType::EXCEPT, TableId::_2, TableId::_1, results);
+
+  // Only the rows past the ones of the smaller table remain
+  EXPECT_EQ(NumRows(), results.size());
+  type::Value min_a = type::ValueFactory::GetIntegerValue(10 * NumRows());
+  for (const auto &tuple : results) {
+    EXPECT_EQ(type::CMP_TRUE,
+              tuple.GetValue(0).CompareGreaterThanEquals(min_a));
+  }
+}
+
+TEST_F(SetOpTranslatorTest, ExceptAllOfSubset) {
+  //
+  // SELECT a, b FROM table1 EXCEPT ALL SELECT a, b FROM table2;
+  //
+
+  std::vector<codegen::WrappedTuple> results;
+  ExecuteSetOp(SetOpType::EXCEPT_ALL, TableId::_1, TableId::_2, results);
+
+  // Every row of the smaller table is in the larger one
+  EXPECT_EQ(0, results.size());
+}
+
+}  // namespace test
+}  // namespace peloton
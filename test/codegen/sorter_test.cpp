@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "common/harness.h"
@@ -97,6 +98,85 @@ TEST_F(SorterTest, CanSortTuples) {
   TestSort(10);
 }
 
+TEST_F(SorterTest, CanKeepTopKTuples) {
+  // Insert 1000 tuples, keeping only the 10 with the smallest column B
+  const uint64_t top_k = 10;
+  std::vector<uint32_t> col_bs;
+  for (uint32_t i = 0; i < 1000; i++) {
+    TestTuple *tuple = reinterpret_cast<TestTuple *>(sorter.StoreInputTuple());
+    tuple->col_a = i;
+    tuple->col_b = rand() % 1000;
+    tuple->col_c = 0;
+    tuple->col_d = 0;
+    col_bs.push_back(tuple->col_b);
+    sorter.StoreInputTupleTopK(top_k);
+    EXPECT_EQ(std::min<uint64_t>(i + 1, top_k), sorter.GetNumTuples());
+  }
+
+  sorter.Sort();
+
+  // The result is the smallest tuples in order
+  std::sort(col_bs.begin(), col_bs.end());
+  uint32_t pos = 0;
+  for (auto iter : sorter) {
+    const auto *tt = reinterpret_cast<const TestTuple *>(iter);
+    EXPECT_EQ(col_bs[pos++], tt->col_b);
+  }
+  EXPECT_EQ(top_k, pos);
+}
+
+TEST_F(SorterTest, CanTransferTuples) {
+  // Split 1000 tuples between this sorter and a second one, as the threads of
+  // a parallel ORDER BY do, and move the tuples of the second into this one
+  codegen::util::Sorter other_sorter;
+  other_sorter.Init(
+      reinterpret_cast<int (*)(const void *, const void *)>(CompareTuples),
+      sizeof(TestTuple));
+
+  std::vector<uint32_t> col_bs;
+  for (uint32_t i = 0; i < 1000; i++) {
+    auto &target = (i % 2 == 0 ? sorter : other_sorter);
+    TestTuple *tuple = reinterpret_cast<TestTuple *>(target.StoreInputTuple());
+    tuple->col_a = i;
+    tuple->col_b = rand() % 1000;
+    tuple->col_c = 0;
+    tuple->col_d = 0;
+    col_bs.push_back(tuple->col_b);
+  }
+
+  sorter.TransferFrom(other_sorter, std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(1000, sorter.GetNumTuples());
+  EXPECT_EQ(0, other_sorter.GetNumTuples());
+
+  // Moving the tuples of a third sorter with a limit keeps the first top_k
+  // tuples of both
+  const uint64_t top_k = 10;
+  codegen::util::Sorter top_k_sorter;
+  top_k_sorter.Init(
+      reinterpret_cast<int (*)(const void *, const void *)>(CompareTuples),
+      sizeof(TestTuple));
+  TestTuple *tuple =
+      reinterpret_cast<TestTuple *>(top_k_sorter.StoreInputTuple());
+  *tuple = TestTuple{1000, 0, 0, 0};
+  top_k_sorter.StoreInputTupleTopK(top_k);
+  col_bs.push_back(0);
+
+  top_k_sorter.TransferFrom(sorter, top_k);
+  EXPECT_EQ(top_k, top_k_sorter.GetNumTuples());
+
+  top_k_sorter.Sort();
+
+  std::sort(col_bs.begin(), col_bs.end());
+  uint32_t pos = 0;
+  for (auto iter : top_k_sorter) {
+    const auto *tt = reinterpret_cast<const TestTuple *>(iter);
+    EXPECT_EQ(col_bs[pos++], tt->col_b);
+  }
+  EXPECT_EQ(top_k, pos);
+
+  top_k_sorter.Destroy();
+}
+
 TEST_F(SorterTest, BenchmarkSorter) {
   // Test sorting 5 million input tuples
   TestSort(5000000);
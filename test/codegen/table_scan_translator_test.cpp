@@ -15,6 +15,7 @@
 #include "common/harness.h"
 #include "expression/comparison_expression.h"
 #include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
 #include "expression/operator_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "planner/seq_scan_plan.h"
@@ -62,6 +63,59 @@ TEST_F(TableScanTranslatorTest, AllColumnsScan) {
   EXPECT_EQ(NumRowsInTestTable(), results.size());
 }
 
+TEST_F(TableScanTranslatorTest, AllColumnsScanIntoResults) {
+  //
+  // SELECT a, b, c FROM table;
+  //
+  // The columns of the results are appended as text, rather than buffered
+  //
+
+  planner::SeqScanPlan scan{&GetTestTable(TestTableId()), nullptr, {0, 1, 2}};
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  std::vector<StatementResult> results;
+  codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+  buffer.WriteResultsTo(results);
+
+  CompileAndExecute(scan, buffer, reinterpret_cast<char*>(buffer.GetState()));
+
+  EXPECT_TRUE(buffer.GetOutputTuples().empty());
+  ASSERT_EQ(3 * NumRowsInTestTable(), results.size());
+
+  // The values of 'a' are 10 * row ID, the ones of 'b' are 10 * row ID + 1
+  std::vector<std::string> first_row;
+  for (uint32_t i = 0; i < 3; i++) {
+    first_row.emplace_back(results[i].second.begin(), results[i].second.end());
+  }
+  EXPECT_EQ("0", first_row[0]);
+  EXPECT_EQ("1", first_row[1]);
+}
+
+TEST_F(TableScanTranslatorTest, CompileStatsCountCode) {
+  //
+  // SELECT a, b, c FROM table;
+  //
+
+  planner::SeqScanPlan scan{&GetTestTable(TestTableId()), nullptr, {0, 1, 2}};
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+  codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+
+  auto stats = CompileAndExecute(scan, buffer,
+                                 reinterpret_cast<char*>(buffer.GetState()));
+
+  // At least the init(), plan() and tearDown() functions are compiled, and
+  // every phase of the compilation is timed
+  EXPECT_GE(stats.num_functions, 3);
+  EXPECT_GT(stats.num_instructions, stats.num_functions);
+  EXPECT_GE(stats.opt_ms, 0.0);
+  EXPECT_GE(stats.jit_ms, 0.0);
+  EXPECT_DOUBLE_EQ(
+      stats.setup_ms + stats.ir_gen_ms + stats.opt_ms + stats.jit_ms,
+      stats.TotalTime());
+}
+
 TEST_F(TableScanTranslatorTest, SimplePredicate) {
   //
   // SELECT a, b, c FROM table where a >= 20;
@@ -138,6 +192,46 @@ TEST_F(TableScanTranslatorTest, SimplePredicateWithNull) {
                 type::ValueFactory::GetIntegerValue(11)));
 }
 
+TEST_F(TableScanTranslatorTest, ScanTileGroupsWithAndWithoutNulls) {
+  // Insert 10 null rows, into a tile group after the ones without nulls
+  const bool insert_nulls = true;
+  LoadTestTable(TestTableId(), 10, insert_nulls);
+
+  //
+  // SELECT a, b FROM table;
+  //
+
+  // Setup the scan plan node
+  auto &table = GetTestTable(TestTableId());
+  planner::SeqScanPlan scan{&table, nullptr, {0, 1}};
+
+  // Do binding
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(scan, buffer, reinterpret_cast<char*>(buffer.GetState()));
+
+  // The tile groups without NULLs are scanned by the code that skips the NULL
+  // checks, only the rows of the last one are NULL
+  const auto &results = buffer.GetOutputTuples();
+  EXPECT_EQ(NumRowsInTestTable() + 10, results.size());
+  uint32_t num_nulls = 0;
+  for (const auto &tuple : results) {
+    if (tuple.GetValue(1).IsNull()) {
+      num_nulls++;
+    } else {
+      EXPECT_EQ(type::CmpBool::CMP_TRUE,
+                tuple.GetValue(1).CompareEquals(tuple.GetValue(0).Add(
+                    type::ValueFactory::GetIntegerValue(1))));
+    }
+  }
+  EXPECT_EQ(10, num_nulls);
+}
+
 TEST_F(TableScanTranslatorTest, PredicateOnNonOutputColumn) {
   //
   // SELECT b FROM table where a >= 40;
@@ -207,6 +301,107 @@ TEST_F(TableScanTranslatorTest, ScanWithConjunctionPredicate) {
                                 type::ValueFactory::GetIntegerValue(21)));
 }
 
+TEST_F(TableScanTranslatorTest, ScanWithReorderedConjunctionPredicate) {
+  //
+  // SELECT a, b, c FROM table where a >= 20 and d <> '213' and b < 400;
+  //
+
+  // 1) Construct the components of the predicate. The string comparison
+  //    keeps it from being evaluated with SIMD, so its terms are evaluated one
+  //    after the other in the order chosen at runtime.
+
+  // a >= 20
+  std::unique_ptr<expression::AbstractExpression> a_gte_20 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(20));
+
+  // d <> '213'
+  auto *d_ne_213 = new expression::ComparisonExpression(
+      ExpressionType::COMPARE_NOTEQUAL,
+      ColRefExpr(type::TypeId::VARCHAR, 3).release(),
+      new expression::ConstantValueExpression(
+          type::ValueFactory::GetVarcharValue("213")));
+
+  // b < 400
+  std::unique_ptr<expression::AbstractExpression> b_lt_400 =
+      CmpLtExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(400));
+
+  // a >= 20 AND d <> '213' AND b < 400
+  auto *conj = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_AND,
+      new expression::ConjunctionExpression(ExpressionType::CONJUNCTION_AND,
+                                            a_gte_20.release(), d_ne_213),
+      b_lt_400.release());
+
+  // 2) Setup the scan plan node
+  planner::SeqScanPlan scan{&GetTestTable(TestTableId()), conj, {0, 1, 2}};
+
+  // 3) Do binding
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(scan, buffer, reinterpret_cast<char*>(buffer.GetState()));
+
+  // Check output results: the rows 2 to 39, except for row 21
+  const auto& results = buffer.GetOutputTuples();
+  ASSERT_EQ(37U, results.size());
+  EXPECT_EQ(type::CMP_TRUE, results[0].GetValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(20)));
+  EXPECT_EQ(type::CMP_TRUE, results[19].GetValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(220)));
+  EXPECT_EQ(type::CMP_TRUE, results[36].GetValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(390)));
+}
+
+TEST_F(TableScanTranslatorTest, ScanWithMixedTypeDisjunctionPredicate) {
+  //
+  // SELECT a, b, c FROM table where c < 100 or a >= 600;
+  //
+
+  // 1) Construct the components of the predicate
+
+  // c < 100, which compares the decimal column with an integer
+  std::unique_ptr<expression::AbstractExpression> c_lt_100 =
+      CmpLtExpr(ColRefExpr(type::TypeId::DECIMAL, 2), ConstIntExpr(100));
+
+  // a >= 600
+  std::unique_ptr<expression::AbstractExpression> a_gte_600 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(600));
+
+  // c < 100 OR a >= 600
+  auto *disj = new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_OR, c_lt_100.release(), a_gte_600.release());
+
+  // 2) Setup the scan plan node
+  planner::SeqScanPlan scan{&GetTestTable(TestTableId()), disj, {0, 1, 2}};
+
+  // 3) Do binding
+  planner::BindingContext context;
+  scan.PerformBinding(context);
+
+  // We collect the results of the query into an in-memory buffer
+  codegen::BufferingConsumer buffer{{0, 1, 2}, context};
+
+  // COMPILE and execute
+  CompileAndExecute(scan, buffer, reinterpret_cast<char*>(buffer.GetState()));
+
+  // Check output results: c = 10 * row ID + 2 is below 100 for the first ten
+  // rows, and a = 10 * row ID reaches 600 for the last four
+  const auto& results = buffer.GetOutputTuples();
+  ASSERT_EQ(14, results.size());
+  EXPECT_EQ(type::CMP_TRUE, results[0].GetValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(0)));
+  EXPECT_EQ(type::CMP_TRUE, results[9].GetValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(90)));
+  EXPECT_EQ(type::CMP_TRUE, results[10].GetValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(600)));
+  EXPECT_EQ(type::CMP_TRUE, results[13].GetValue(0).CompareEquals(
+                                type::ValueFactory::GetIntegerValue(630)));
+}
+
 TEST_F(TableScanTranslatorTest, ScanWithAddPredicate) {
   //
   // SELECT a, b FROM table where b = a + 1;
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// update_translator_test.cpp
+//
+// Identification: test/codegen/update_translator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "codegen/testing_codegen_util.h"
+
+#include "expression/operator_expression.h"
+#include "planner/seq_scan_plan.h"
+#include "planner/update_plan.h"
+
+namespace peloton {
+namespace test {
+
+class UpdateTranslatorTest : public PelotonCodeGenTest {
+ public:
+  UpdateTranslatorTest() : PelotonCodeGenTest() {
+    LoadTestTable(TableId::_1, NumRowsInTestTable());
+  }
+
+  // Scan columns 'a' and 'b' of the given table
+  std::vector<codegen::WrappedTuple> ScanTable(
+      TableId table_id, expression::AbstractExpression *predicate = nullptr) {
+    planner::SeqScanPlan scan{&GetTestTable(table_id), predicate, {0, 1}};
+    planner::BindingContext context;
+    scan.PerformBinding(context);
+
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+    CompileAndExecute(scan, buffer, reinterpret_cast<char*>(buffer.GetState()));
+    return buffer.GetOutputTuples();
+  }
+
+  // Update column 'b' of the rows of table1 matching the predicate
+  void UpdateColumnB(std::unique_ptr<expression::AbstractExpression> b_expr,
+                     expression::AbstractExpression *predicate) {
+    TargetList target_list;
+    planner::DerivedAttribute attribute{b_expr.release()};
+    target_list.emplace_back(1, attribute);
+    DirectMapList direct_map_list = {{0, {0, 0}}, {2, {0, 2}}, {3, {0, 3}}};
+    std::unique_ptr<const planner::ProjectInfo> proj_info{
+        new planner::ProjectInfo(std::move(target_list),
+                                 std::move(direct_map_list))};
+
+    auto &table = GetTestTable(TableId::_1);
+    std::unique_ptr<planner::UpdatePlan> update_plan{
+        new planner::UpdatePlan(&table, std::move(proj_info))};
+    std::unique_ptr<planner::AbstractPlan> scan{
+        new planner::SeqScanPlan(&table, predicate, {0, 1, 2, 3})};
+    update_plan->AddChild(std::move(scan));
+
+    planner::BindingContext context;
+    update_plan->PerformBinding(context);
+
+    codegen::BufferingConsumer buffer{{0, 1}, context};
+    CompileAndExecute(*update_plan, buffer,
+                      reinterpret_cast<char*>(buffer.GetState()));
+  }
+
+  uint32_t NumRowsInTestTable() const { return num_rows_to_insert; }
+
+ private:
+  uint32_t num_rows_to_insert = 64;
+};
+
+TEST_F(UpdateTranslatorTest, UpdateWithConstant) {
+  //
+  // UPDATE table1 SET b = 1 WHERE a >= 400;
+  //
+
+  auto a_gte_400 =
+      CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, 0), ConstIntExpr(400));
+  UpdateColumnB(ConstIntExpr(1), a_gte_400.release());
+
+  // The updated rows are visible to later scans, the others are unchanged
+  auto b_eq_1 =
+      CmpEqExpr(ColRefExpr(type::TypeId::INTEGER, 1), ConstIntExpr(1));
+  EXPECT_EQ(NumRowsInTestTable() - 40,
+            ScanTable(TableId::_1, b_eq_1.release()).size());
+  EXPECT_EQ(NumRowsInTestTable(), ScanTable(TableId::_1).size());
+}
+
+TEST_F(UpdateTranslatorTest, UpdateWithExpression) {
+  //
+  // UPDATE table1 SET b = a + 2;
+  //
+
+  auto a_plus_2 = std::unique_ptr<expression::AbstractExpression>{
+      new expression::OperatorExpression(
+          ExpressionType::OPERATOR_PLUS, type::TypeId::INTEGER,
+          ColRefExpr(type::TypeId::INTEGER, 0).release(),
+          ConstIntExpr(2).release())};
+  UpdateColumnB(std::move(a_plus_2), nullptr);
+
+  auto results = ScanTable(TableId::_1);
+  ASSERT_EQ(NumRowsInTestTable(), results.size());
+  for (const auto &tuple : results) {
+    type::Value expected =
+        tuple.GetValue(0).Add(type::ValueFactory::GetIntegerValue(2));
+    EXPECT_TRUE(tuple.GetValue(1).CompareEquals(expected) == type::CMP_TRUE);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -160,5 +160,37 @@ TEST_F(ValueIntegrityTest, IntegerDivideByZero) {
   }
 }
 
+TEST_F(ValueIntegrityTest, BatchedOverflowChecks) {
+  // (arg * 3) - 1, with the overflow checks of both operators batched
+  codegen::CodeContext code_context;
+  codegen::CodeGen codegen{code_context};
+  codegen::FunctionBuilder function{code_context,
+                                    "test",
+                                    codegen.Int32Type(),
+                                    {{"arg", codegen.Int32Type()}}};
+  {
+    codegen::Value arg{codegen::type::Integer::Instance(),
+                       function.GetArgumentByPosition(0)};
+    codegen::Value three{codegen::type::Integer::Instance(),
+                         codegen.Const32(3)};
+    codegen::Value one{codegen::type::Integer::Instance(), codegen.Const32(1)};
+
+    codegen.BeginOverflowBatch();
+    codegen::Value res = arg.Mul(codegen, three).Sub(codegen, one);
+    codegen.EndOverflowBatch();
+
+    function.ReturnAndFinish(res.GetValue());
+  }
+
+  EXPECT_TRUE(code_context.Compile());
+
+  typedef int32_t (*func)(int32_t);
+  func f = (func)code_context.GetFunctionPointer(function.GetFunction());
+  EXPECT_EQ(20, f(7));
+
+  // The multiplication overflows, the subtraction after it doesn't
+  EXPECT_THROW(f(INT32_MAX / 2), std::overflow_error);
+}
+
 }  // namespace test
 }  // namespace peloton
\ No newline at end of file
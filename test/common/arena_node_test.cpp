@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// arena_node_test.cpp
+//
+// Identification: test/common/arena_node_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "common/arena_node.h"
+#include "parser/postgresparser.h"
+#include "parser/select_statement.h"
+#include "type/arena_pool.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Arena Node Tests
+//===--------------------------------------------------------------------===//
+
+class ArenaNodeTests : public PelotonTest {};
+
+namespace {
+
+// Counts its live instances
+struct CountedNode : public ArenaNode {
+  CountedNode() { live_count++; }
+  ~CountedNode() { live_count--; }
+
+  int64_t payload[4];
+
+  static int live_count;
+};
+
+int CountedNode::live_count = 0;
+
+}  // namespace
+
+TEST_F(ArenaNodeTests, ScopeTest) {
+  type::ArenaPool arena(4096);
+  EXPECT_EQ(nullptr, ArenaNodeScope::GetArena());
+
+  CountedNode *arena_node;
+  {
+    ArenaNodeScope scope(&arena);
+    EXPECT_EQ(&arena, ArenaNodeScope::GetArena());
+    arena_node = new CountedNode();
+    {
+      // Scopes nest
+      ArenaNodeScope inner_scope(nullptr);
+      EXPECT_EQ(nullptr, ArenaNodeScope::GetArena());
+    }
+    EXPECT_EQ(&arena, ArenaNodeScope::GetArena());
+  }
+  EXPECT_EQ(nullptr, ArenaNodeScope::GetArena());
+  EXPECT_EQ(4096U, arena.GetAllocatedSize());
+
+  // Nodes from the heap and from the arena are deleted alike, and always
+  // destroyed
+  auto heap_node = new CountedNode();
+  EXPECT_EQ(2, CountedNode::live_count);
+  delete heap_node;
+  delete arena_node;
+  EXPECT_EQ(0, CountedNode::live_count);
+}
+
+TEST_F(ArenaNodeTests, ParseTreeTest) {
+  auto &parser = parser::PostgresParser::GetInstance();
+  auto stmt_list =
+      parser.BuildParseTree("SELECT a, b + 1 FROM foo WHERE a > 2 ORDER BY b;");
+  ASSERT_TRUE(stmt_list->is_valid);
+  ASSERT_NE(nullptr, stmt_list->arena);
+  EXPECT_LT(0U, stmt_list->arena->GetAllocatedSize());
+
+  auto select =
+      static_cast<parser::SelectStatement *>(stmt_list->GetStatement(0));
+  EXPECT_EQ(2U, select->select_list->size());
+  EXPECT_EQ(ExpressionType::COMPARE_GREATERTHAN,
+            select->where_clause->GetExpressionType());
+
+  // A copy outside of the parse outlives the parse tree
+  std::unique_ptr<expression::AbstractExpression> where(
+      select->where_clause->Copy());
+  stmt_list.reset();
+  EXPECT_EQ(ExpressionType::COMPARE_GREATERTHAN, where->GetExpressionType());
+}
+
+}  // namespace test
+}  // namespace peloton
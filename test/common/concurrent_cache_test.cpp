@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// concurrent_cache_test.cpp
+//
+// Identification: test/common/concurrent_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "common/concurrent_cache.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Concurrent Cache Test
+//===--------------------------------------------------------------------===//
+
+class ConcurrentCacheTests : public PelotonTest {};
+
+TEST_F(ConcurrentCacheTests, BasicTest) {
+  ConcurrentCache<int, std::string> cache(8, 1);
+  EXPECT_EQ(8U, cache.GetCapacity());
+  EXPECT_EQ(nullptr, cache.Find(1));
+
+  std::shared_ptr<std::string> one(new std::string("one"));
+  cache.Insert(1, one);
+  EXPECT_EQ(one, cache.Find(1));
+
+  // Only inserted if absent
+  std::shared_ptr<std::string> other(new std::string("other"));
+  EXPECT_EQ(one, cache.InsertIfAbsent(1, other));
+  EXPECT_EQ(other, cache.InsertIfAbsent(2, other));
+
+  // Replaced
+  cache.Insert(1, other);
+  EXPECT_EQ(other, cache.Find(1));
+  EXPECT_EQ(2U, cache.GetSize());
+
+  // Erased only while it caches the value
+  EXPECT_FALSE(cache.Erase(1, one));
+  EXPECT_TRUE(cache.Erase(1, other));
+  EXPECT_FALSE(cache.Erase(1));
+  EXPECT_TRUE(cache.Erase(2));
+  EXPECT_EQ(0U, cache.GetSize());
+
+  for (int key = 0; key < 6; key++) {
+    cache.Insert(key, one);
+  }
+  EXPECT_EQ(3U, cache.EraseIf([](const int &key,
+                                 const std::shared_ptr<std::string> &) {
+    return key % 2 == 0;
+  }));
+  EXPECT_EQ(3U, cache.GetSize());
+  cache.Clear();
+  EXPECT_EQ(0U, cache.GetSize());
+  EXPECT_EQ(8U, cache.GetCapacity());
+}
+
+TEST_F(ConcurrentCacheTests, EvictionTest) {
+  std::vector<int> evicted_keys;
+  ConcurrentCache<int, int> cache(
+      100, 1, [&evicted_keys](const int &key, const std::shared_ptr<int> &) {
+        evicted_keys.push_back(key);
+      });
+
+  // Entries are charged by their size. The entries that were looked up since
+  // the clock hand last passed them are kept.
+  for (int key = 0; key < 10; key++) {
+    cache.Insert(key, std::make_shared<int>(key), 10);
+  }
+  EXPECT_EQ(100U, cache.GetCharge());
+  EXPECT_TRUE(evicted_keys.empty());
+
+  cache.Insert(10, std::make_shared<int>(10), 10);
+  EXPECT_EQ(1U, evicted_keys.size());
+  EXPECT_LE(cache.GetCharge(), 100U);
+
+  // The hand cleared the marks of the remaining entries on its way round
+  cache.Find(1);
+  cache.Find(2);
+  cache.Insert(11, std::make_shared<int>(11), 30);
+  EXPECT_LE(cache.GetCharge(), 100U);
+  EXPECT_NE(nullptr, cache.Find(1));
+  EXPECT_NE(nullptr, cache.Find(2));
+  EXPECT_NE(nullptr, cache.Find(11));
+  EXPECT_EQ(cache.GetSize() + evicted_keys.size(), 12U);
+
+  // An entry that does not fit is not kept, and the hand stops once it is
+  // gone
+  cache.Insert(12, std::make_shared<int>(12), 1000);
+  EXPECT_EQ(nullptr, cache.Find(12));
+  EXPECT_NE(nullptr, cache.Find(11));
+  EXPECT_LE(cache.GetCharge(), 100U);
+}
+
+TEST_F(ConcurrentCacheTests, MultiThreadedTest) {
+  ConcurrentCache<int, int> cache(64);
+  const int thread_count = 4;
+  const int operation_count = 10000;
+
+  std::atomic<int> found_count(0);
+  std::vector<std::thread> threads;
+  for (int thread_id = 0; thread_id < thread_count; thread_id++) {
+    threads.emplace_back([&cache, &found_count, thread_id, operation_count] {
+      for (int i = 0; i < operation_count; i++) {
+        int key = (i * 7 + thread_id) % 128;
+        auto value = cache.Find(key);
+        if (value != nullptr) {
+          EXPECT_EQ(key, *value);
+          found_count++;
+        } else {
+          cache.InsertIfAbsent(key, std::make_shared<int>(key));
+        }
+        if (i % 100 == 0) {
+          cache.Erase(key);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_LT(0, found_count.load());
+  EXPECT_LE(cache.GetCharge(), cache.GetCapacity());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// maintenance_scheduler_test.cpp
+//
+// Identification: test/common/maintenance_scheduler_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "common/maintenance_scheduler.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Maintenance Scheduler Tests
+//===--------------------------------------------------------------------===//
+
+class MaintenanceSchedulerTests : public PelotonTest {};
+
+TEST_F(MaintenanceSchedulerTests, ModeTest) {
+  MaintenanceScheduler scheduler;
+  scheduler.SetBudgets(10, 0, 0);
+  const uint64_t pause_us = 1000;
+
+  // Without a latency reported the tasks pause as they would
+  EXPECT_EQ(MaintenanceMode::NORMAL, scheduler.GetMode());
+  EXPECT_EQ(pause_us,
+            scheduler.GetPause(MaintenanceTask::INDEX_TUNER, pause_us));
+
+  // Slow queries hold the tasks back, but not the GC
+  scheduler.RecordQueryLatency(20, 100);
+  EXPECT_EQ(MaintenanceMode::THROTTLED, scheduler.GetMode());
+  EXPECT_EQ(MaintenanceScheduler::MIN_THROTTLED_PAUSE_US,
+            scheduler.GetPause(MaintenanceTask::INDEX_TUNER, pause_us));
+  EXPECT_EQ(MaintenanceScheduler::MAX_PAUSE_US,
+            scheduler.GetPause(MaintenanceTask::COMPACTOR, 1000 * 1000));
+  EXPECT_EQ(pause_us, scheduler.GetPause(MaintenanceTask::GC, pause_us));
+
+  // Idle periods speed them up
+  scheduler.RecordQueryLatency(0, 0);
+  EXPECT_EQ(MaintenanceMode::IDLE, scheduler.GetMode());
+  EXPECT_EQ(pause_us / MaintenanceScheduler::IDLE_FACTOR,
+            scheduler.GetPause(MaintenanceTask::LAYOUT_TUNER, pause_us));
+
+  scheduler.RecordQueryLatency(5, 100);
+  EXPECT_EQ(MaintenanceMode::NORMAL, scheduler.GetMode());
+  EXPECT_EQ("THROTTLED", MaintenanceModeToString(MaintenanceMode::THROTTLED));
+}
+
+TEST_F(MaintenanceSchedulerTests, BudgetTest) {
+  MaintenanceScheduler scheduler;
+
+  // 10% of a core: 100 ms of work to start with
+  scheduler.SetBudgets(0, 10, 1);
+  scheduler.RecordWork(MaintenanceTask::COMPACTOR, 50 * 1000);
+  EXPECT_EQ(0U, scheduler.GetPause(MaintenanceTask::COMPACTOR, 0));
+
+  // The debt of 50 ms takes 500 ms to pay off, whichever task pays it
+  scheduler.RecordWork(MaintenanceTask::GC, 100 * 1000);
+  auto pause_us = scheduler.GetPause(MaintenanceTask::FREEZER, 0);
+  EXPECT_LT(400U * 1000, pause_us);
+  EXPECT_GE(500U * 1000, pause_us);
+  EXPECT_EQ(50U * 1000, scheduler.GetWorkUs(MaintenanceTask::COMPACTOR));
+  EXPECT_EQ(100U * 1000, scheduler.GetWorkUs(MaintenanceTask::GC));
+
+  // 1 MB/s of writes: a debt of 3 MB takes the longest pause
+  scheduler.SetBudgets(0, 0, 1);
+  scheduler.RecordWork(MaintenanceTask::CHECKPOINT, 0, 4 * 1024 * 1024);
+  EXPECT_EQ(MaintenanceScheduler::MAX_PAUSE_US,
+            scheduler.GetPause(MaintenanceTask::CHECKPOINT, 0));
+  EXPECT_EQ(4U * 1024 * 1024,
+            scheduler.GetIoBytes(MaintenanceTask::CHECKPOINT));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_tracker_test.cpp
+//
+// Identification: test/common/memory_tracker_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "common/memory_tracker.h"
+#include "type/arena_pool.h"
+
+#include <vector>
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Memory Tracker Test
+//===--------------------------------------------------------------------===//
+
+class MemoryTrackerTests : public PelotonTest {};
+
+TEST_F(MemoryTrackerTests, AllocateTest) {
+  auto type = MemoryComponentType::CODEGEN;
+  auto bytes = MemoryTracker::GetAllocatedBytes(type);
+
+  MemoryTracker::Allocate(type, 1000);
+  EXPECT_EQ(bytes + 1000, MemoryTracker::GetAllocatedBytes(type));
+
+  MemoryTracker::Release(type, 1000);
+  EXPECT_EQ(bytes, MemoryTracker::GetAllocatedBytes(type));
+}
+
+TEST_F(MemoryTrackerTests, ScopeTest) {
+  EXPECT_FALSE(MemoryTracker::IsMeasuringThread());
+
+  std::vector<char> *kept;
+  {
+    MemoryScope scope;
+    EXPECT_TRUE(MemoryTracker::IsMeasuringThread());
+
+    // What is freed within the scope is not counted
+    { std::vector<char> freed(10000); }
+    EXPECT_LT(scope.GetAllocatedBytes(), 10000UL);
+
+    kept = new std::vector<char>(10000);
+    {
+      // Nested scopes count what they see only
+      MemoryScope inner_scope;
+      EXPECT_EQ(0UL, inner_scope.GetAllocatedBytes());
+    }
+    EXPECT_TRUE(MemoryTracker::IsMeasuringThread());
+    EXPECT_GE(scope.GetAllocatedBytes(), 10000UL);
+  }
+  EXPECT_FALSE(MemoryTracker::IsMeasuringThread());
+
+  delete kept;
+}
+
+TEST_F(MemoryTrackerTests, TrackedAllocatorTest) {
+  auto type = MemoryComponentType::PLAN_CACHE;
+  auto bytes = MemoryTracker::GetAllocatedBytes(type);
+  {
+    std::vector<uint64_t, TrackedAllocator<uint64_t, MemoryComponentType::
+                                                         PLAN_CACHE>> values;
+    values.reserve(100);
+    EXPECT_EQ(bytes + 100 * sizeof(uint64_t),
+              MemoryTracker::GetAllocatedBytes(type));
+  }
+  EXPECT_EQ(bytes, MemoryTracker::GetAllocatedBytes(type));
+}
+
+TEST_F(MemoryTrackerTests, ArenaPoolTest) {
+  auto type = MemoryComponentType::VARLEN_POOL;
+  auto bytes = MemoryTracker::GetAllocatedBytes(type);
+  {
+    // Only the pools given a component are charged
+    type::ArenaPool untracked_pool;
+    untracked_pool.Allocate(100);
+    EXPECT_EQ(bytes, MemoryTracker::GetAllocatedBytes(type));
+
+    type::ArenaPool pool(type);
+    pool.Allocate(100);
+    EXPECT_LT(bytes, MemoryTracker::GetAllocatedBytes(type));
+  }
+  EXPECT_EQ(bytes, MemoryTracker::GetAllocatedBytes(type));
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -11,6 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "common/thread_pool.h"
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
 #include "common/harness.h"
 
 namespace peloton {
@@ -74,5 +79,67 @@ TEST_F(ThreadPoolTests, BasicTest) {
   thread_pool.Shutdown();
 }
 
+TEST_F(ThreadPoolTests, NestedTaskTest) {
+  ThreadPool thread_pool;
+  thread_pool.Initialize(4, 0, ThreadPlacement::CPU);
+  EXPECT_EQ(4U, thread_pool.GetWorkerCount());
+
+  // Every task submits two more from its worker, which idle workers steal
+  const int depth = 8;
+  std::atomic<int> counter(0);
+  std::function<void(int)> spawn = [&](int level) {
+    counter.fetch_add(1);
+    if (level < depth) {
+      thread_pool.SubmitTask(spawn, level + 1);
+      thread_pool.SubmitTask(spawn, level + 1);
+    }
+  };
+  thread_pool.SubmitTask(spawn, 0);
+
+  const int task_count = (1 << (depth + 1)) - 1;
+  while (counter.load() != task_count) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(task_count, counter.load());
+
+  thread_pool.Shutdown();
+}
+
+TEST_F(ThreadPoolTests, PriorityTest) {
+  ThreadPool thread_pool;
+  thread_pool.Initialize(1, 0);
+
+  // Keep the only worker busy until all tasks are submitted
+  std::mutex mutex;
+  std::unique_lock<std::mutex> lock(mutex);
+  thread_pool.SubmitTask([&mutex] { std::lock_guard<std::mutex> l(mutex); });
+
+  std::vector<TaskPriority> order;
+  std::atomic<int> counter(0);
+  auto record = [&order, &counter](TaskPriority priority) {
+    order.push_back(priority);
+    counter.fetch_add(1);
+  };
+  thread_pool.SubmitTaskWithPriority(TaskPriority::BACKGROUND, record,
+                                     TaskPriority::BACKGROUND);
+  thread_pool.SubmitTaskWithPriority(TaskPriority::FOREGROUND, record,
+                                     TaskPriority::FOREGROUND);
+  thread_pool.SubmitTaskWithPriority(TaskPriority::BACKGROUND, record,
+                                     TaskPriority::BACKGROUND);
+  lock.unlock();
+
+  while (counter.load() != 3) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  // Foreground tasks run before background ones submitted earlier
+  ASSERT_EQ(3U, order.size());
+  EXPECT_EQ(TaskPriority::FOREGROUND, order[0]);
+  EXPECT_EQ(TaskPriority::BACKGROUND, order[1]);
+  EXPECT_EQ(TaskPriority::BACKGROUND, order[2]);
+
+  thread_pool.Shutdown();
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wait_events_test.cpp
+//
+// Identification: test/common/wait_events_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "common/platform.h"
+#include "common/wait_events.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Wait Events Test
+//===--------------------------------------------------------------------===//
+
+class WaitEventsTests : public PelotonTest {};
+
+TEST_F(WaitEventsTests, LatchTest) {
+  auto type_idx = static_cast<size_t>(WaitEventType::TUPLE_LATCH);
+  auto wait_count = WaitEvents::GetTotals().wait_counts[type_idx];
+
+  // A latch taken without waiting is not counted
+  Spinlock latch;
+  latch.Lock(WaitEventType::TUPLE_LATCH);
+  latch.Unlock();
+  EXPECT_EQ(wait_count, WaitEvents::GetTotals().wait_counts[type_idx]);
+
+  // Another thread waiting for it is
+  latch.Lock(WaitEventType::TUPLE_LATCH);
+  std::atomic<bool> is_waiting(false);
+  std::thread waiter([&latch, &is_waiting] {
+    is_waiting.store(true);
+    latch.Lock(WaitEventType::TUPLE_LATCH);
+    latch.Unlock();
+  });
+  while (is_waiting.load() == false) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  latch.Unlock();
+  waiter.join();
+  EXPECT_EQ(wait_count + 1, WaitEvents::GetTotals().wait_counts[type_idx]);
+}
+
+TEST_F(WaitEventsTests, RecordTest) {
+  auto type_idx = static_cast<size_t>(WaitEventType::EPOCH_WAIT);
+  auto totals = WaitEvents::GetTotals();
+
+  // Waits of known duration are all timed, from every thread
+  WaitEvents::RecordWait(WaitEventType::EPOCH_WAIT, 100);
+  std::thread other_thread(
+      [] { WaitEvents::RecordWait(WaitEventType::EPOCH_WAIT, 300); });
+  other_thread.join();
+
+  auto new_totals = WaitEvents::GetTotals();
+  EXPECT_EQ(totals.wait_counts[type_idx] + 2,
+            new_totals.wait_counts[type_idx]);
+  EXPECT_EQ(totals.wait_us[type_idx] + 400, new_totals.wait_us[type_idx]);
+  EXPECT_EQ("EPOCH_WAIT", WaitEventTypeToString(WaitEventType::EPOCH_WAIT));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// contention_manager_test.cpp
+//
+// Identification: test/concurrency/contention_manager_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/testing_transaction_util.h"
+#include "common/harness.h"
+#include "common/wait_events.h"
+#include "concurrency/contention_manager.h"
+#include "executor/testing_executor_util.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Contention Manager Tests
+//===--------------------------------------------------------------------===//
+
+class ContentionManagerTests : public PelotonTest {};
+
+TEST_F(ContentionManagerTests, HotnessTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset();
+  auto &contention_manager = concurrency::ContentionManager::GetInstance();
+  contention_manager.Reset();
+
+  for (int i = 0; i < 32; i++) {
+    contention_manager.RecordConflict(1, ConflictType::WRITE_WRITE);
+  }
+  contention_manager.EndTransaction(ResultType::SUCCESS);
+  EXPECT_EQ(32U, contention_manager.GetHotness(1));
+  EXPECT_TRUE(contention_manager.IsHot(1));
+  EXPECT_EQ(0U, contention_manager.GetHotness(2));
+  EXPECT_FALSE(contention_manager.IsHot(2));
+
+  // The conflicts are halved every epoch
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  EXPECT_EQ(16U, contention_manager.GetHotness(1));
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  EXPECT_FALSE(contention_manager.IsHot(1));
+
+  epoch_manager.Reset();
+  contention_manager.Reset();
+}
+
+TEST_F(ContentionManagerTests, RetryTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset();
+  auto &contention_manager = concurrency::ContentionManager::GetInstance();
+  contention_manager.Reset();
+
+  EXPECT_EQ(0U, contention_manager.GetRetryBackoff());
+  EXPECT_EQ(0U, contention_manager.WaitBeforeRetry());
+
+  // The backoff grows with the consecutive aborts, and is counted as a wait
+  auto backoff_type_idx = static_cast<size_t>(WaitEventType::RETRY_BACKOFF);
+  auto backoff_count = WaitEvents::GetTotals().wait_counts[backoff_type_idx];
+  contention_manager.RecordConflict(1, ConflictType::WRITE_WRITE);
+  contention_manager.EndTransaction(ResultType::ABORTED);
+  auto first_backoff = contention_manager.GetRetryBackoff();
+  EXPECT_LT(0U, first_backoff);
+  EXPECT_LT(0U, contention_manager.WaitBeforeRetry());
+  EXPECT_EQ(backoff_count + 1,
+            WaitEvents::GetTotals().wait_counts[backoff_type_idx]);
+
+  contention_manager.RecordConflict(1, ConflictType::WRITE_WRITE);
+  contention_manager.EndTransaction(ResultType::ABORTED);
+  auto second_backoff = contention_manager.GetRetryBackoff();
+  EXPECT_EQ(2 * first_backoff, second_backoff);
+
+  // and is longer on a hot tile group
+  for (int i = 0; i < 32; i++) {
+    contention_manager.RecordConflict(1, ConflictType::WRITE_WRITE);
+  }
+  contention_manager.EndTransaction(ResultType::ABORTED);
+  EXPECT_EQ(8 * first_backoff, contention_manager.GetRetryBackoff());
+  EXPECT_LT(0U, contention_manager.WaitBeforeRetry());
+
+  // A commit resets the backoff
+  contention_manager.EndTransaction(ResultType::SUCCESS);
+  EXPECT_EQ(0U, contention_manager.GetRetryBackoff());
+
+  epoch_manager.Reset();
+  contention_manager.Reset();
+}
+
+TEST_F(ContentionManagerTests, ConflictTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &contention_manager = concurrency::ContentionManager::GetInstance();
+  contention_manager.Reset();
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     TESTS_TUPLES_PER_TILEGROUP, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+
+  // A failed attempt to own a tuple is a conflict on its tile group
+  auto owner_txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(txn_manager.AcquireOwnership(owner_txn, tile_group_header, 0));
+  txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(txn_manager.AcquireOwnership(txn, tile_group_header, 0));
+  EXPECT_EQ(1U, contention_manager.GetHotness(tile_group_id));
+
+  // The retry of the aborted transaction is delayed, and the abort counted
+  // by the table
+  txn_manager.AbortTransaction(txn);
+  EXPECT_LT(0U, contention_manager.GetRetryBackoff());
+  auto abort_counts = contention_manager.GetAbortCounts();
+  EXPECT_EQ(1U, abort_counts.size());
+  EXPECT_EQ(1U, abort_counts[std::make_pair(data_table->GetOid(),
+                                            ConflictType::WRITE_WRITE)]);
+  txn_manager.YieldOwnership(owner_txn, tile_group_header, 0);
+  txn_manager.CommitTransaction(owner_txn);
+  EXPECT_EQ(0U, contention_manager.GetRetryBackoff());
+
+  contention_manager.Reset();
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <thread>
+#include <vector>
+
 #include "concurrency/local_epoch.h"
 #include "common/harness.h"
 
@@ -24,21 +27,6 @@ namespace test {
 class LocalEpochTests : public PelotonTest {};
 
 
-TEST_F(LocalEpochTests, EpochCompareTest) {
-  concurrency::EpochCompare comp;
-  
-  std::shared_ptr<concurrency::Epoch> epoch0(new concurrency::Epoch(10, 20));
-  std::shared_ptr<concurrency::Epoch> epoch1(new concurrency::Epoch(10, 20));
-  bool rt = comp(epoch0, epoch1);
-  EXPECT_EQ(rt, false);
-
-  std::shared_ptr<concurrency::Epoch> epoch2(new concurrency::Epoch(11, 21));
-  std::shared_ptr<concurrency::Epoch> epoch3(new concurrency::Epoch(12, 20));
-  rt = comp(epoch2, epoch3);
-  EXPECT_EQ(rt, false);
-}
-
-
 TEST_F(LocalEpochTests, TransactionTest) {
   concurrency::LocalEpoch local_epoch(0);
   
@@ -92,6 +80,67 @@ TEST_F(LocalEpochTests, TransactionTest) {
 }
 
 
+TEST_F(LocalEpochTests, OverflowTest) {
+  concurrency::LocalEpoch local_epoch(0);
+
+  // more running epochs than the local epoch has slots
+  for (eid_t epoch_id = 10; epoch_id < 30; ++epoch_id) {
+    bool rt = local_epoch.EnterEpoch(epoch_id, TimestampType::READ);
+    EXPECT_EQ(rt, true);
+  }
+
+  // a second transaction in the oldest epoch
+  local_epoch.EnterEpoch(10, TimestampType::READ);
+
+  uint64_t max_eid = local_epoch.GetExpiredEpochId(30);
+  EXPECT_EQ(max_eid, 9);
+
+  // the epochs spilled into the overflow map hold back the lower bound
+  // once the epochs in the slots are gone.
+  local_epoch.ExitEpoch(10);
+  max_eid = local_epoch.GetExpiredEpochId(30);
+  EXPECT_EQ(max_eid, 9);
+
+  for (eid_t epoch_id = 10; epoch_id < 25; ++epoch_id) {
+    local_epoch.ExitEpoch(epoch_id);
+  }
+  max_eid = local_epoch.GetExpiredEpochId(30);
+  EXPECT_EQ(max_eid, 24);
+
+  for (eid_t epoch_id = 25; epoch_id < 30; ++epoch_id) {
+    local_epoch.ExitEpoch(epoch_id);
+  }
+  max_eid = local_epoch.GetExpiredEpochId(31);
+  EXPECT_EQ(max_eid, 30);
+}
+
+
+TEST_F(LocalEpochTests, ConcurrentTest) {
+  concurrency::LocalEpoch local_epoch(0);
+  const size_t thread_count = 4;
+  const size_t txn_count = 10000;
+
+  // threads sharing one local epoch, like the default thread id
+  std::vector<std::thread> threads;
+  for (size_t thread_itr = 0; thread_itr < thread_count; ++thread_itr) {
+    threads.emplace_back([&local_epoch, thread_itr, txn_count] {
+      for (size_t txn_itr = 0; txn_itr < txn_count; ++txn_itr) {
+        eid_t epoch_id = 10 + (txn_itr + thread_itr) % 8;
+        EXPECT_TRUE(local_epoch.EnterEpoch(epoch_id, TimestampType::READ));
+        local_epoch.ExitEpoch(epoch_id);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // every transaction has left
+  uint64_t max_eid = local_epoch.GetExpiredEpochId(20);
+  EXPECT_EQ(max_eid, 19);
+}
+
+
 }  // End test namespace
 }  // End peloton namespace
 
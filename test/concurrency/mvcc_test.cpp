@@ -26,7 +26,8 @@ namespace test {
 class MVCCTests : public PelotonTest {};
 
 static std::vector<ProtocolType> PROTOCOL_TYPES = {
-    ProtocolType::TIMESTAMP_ORDERING};
+    ProtocolType::TIMESTAMP_ORDERING, ProtocolType::OPTIMISTIC,
+    ProtocolType::PARTITIONED};
 
 TEST_F(MVCCTests, SingleThreadVersionChainTest) {
   LOG_INFO("SingleThreadVersionChainTest");
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// optimistic_transaction_manager_test.cpp
+//
+// Identification: test/concurrency/optimistic_transaction_manager_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "concurrency/testing_transaction_util.h"
+#include "common/harness.h"
+#include "executor/testing_executor_util.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Optimistic Transaction Manager Tests
+//===--------------------------------------------------------------------===//
+
+class OptimisticTransactionManagerTests : public PelotonTest {};
+
+TEST_F(OptimisticTransactionManagerTests, ReadTest) {
+  concurrency::TransactionManagerFactory::Configure(ProtocolType::OPTIMISTIC);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     TESTS_TUPLES_PER_TILEGROUP, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto reserved_size = storage::TileGroupHeader::GetReservedSize();
+  std::vector<char> reserved_field(reserved_size);
+  PL_MEMCPY(reserved_field.data(), tile_group_header->GetReservedFieldRef(0),
+            reserved_size);
+
+  // Reads are only recorded in the read set
+  auto writer_txn = txn_manager.BeginTransaction();
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(txn_manager.PerformRead(txn, ItemPointer(tile_group_id, 0)));
+  EXPECT_EQ(RWType::READ, txn->GetRWType(ItemPointer(tile_group_id, 0)));
+  EXPECT_EQ(0, memcmp(reserved_field.data(),
+                      tile_group_header->GetReservedFieldRef(0),
+                      reserved_size));
+
+  // A younger reader does not keep an older writer from owning the tuple
+  EXPECT_TRUE(txn_manager.PerformRead(txn, ItemPointer(tile_group_id, 1)));
+  EXPECT_TRUE(
+      txn_manager.PerformRead(writer_txn, ItemPointer(tile_group_id, 1), true));
+  EXPECT_EQ(RWType::READ_OWN,
+            writer_txn->GetRWType(ItemPointer(tile_group_id, 1)));
+
+  // The reader of an owned version fails validation
+  auto &occ_manager = static_cast<concurrency::OptimisticTransactionManager &>(
+      txn_manager);
+  EXPECT_FALSE(occ_manager.ValidateReadSet(txn));
+
+  // Releasing the ownership without writing does not invalidate the read
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(writer_txn));
+  EXPECT_TRUE(occ_manager.ValidateReadSet(txn));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING);
+}
+
+TEST_F(OptimisticTransactionManagerTests, ValidationTest) {
+  concurrency::TransactionManagerFactory::Configure(ProtocolType::OPTIMISTIC);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // read, concurrent update and commit, commit
+  {
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+    TransactionScheduler scheduler(2, table, &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(1).Update(0, 1);
+    scheduler.Txn(1).Commit();
+    scheduler.Txn(0).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[1].txn_result);
+    EXPECT_EQ(ResultType::ABORTED, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(0, scheduler.schedules[0].results[0]);
+  }
+
+  // write skew
+  {
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+    TransactionScheduler scheduler(2, table, &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(1).Read(1);
+    scheduler.Txn(0).Update(1, 1);
+    scheduler.Txn(1).Update(0, 1);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Commit();
+
+    scheduler.Run();
+
+    EXPECT_FALSE(scheduler.schedules[0].txn_result == ResultType::SUCCESS &&
+                 scheduler.schedules[1].txn_result == ResultType::SUCCESS);
+  }
+
+  // disjoint reads and writes
+  {
+    concurrency::EpochManagerFactory::GetInstance().Reset();
+    storage::DataTable *table = TestingTransactionUtil::CreateTable();
+
+    TransactionScheduler scheduler(2, table, &txn_manager);
+    scheduler.Txn(0).Read(0);
+    scheduler.Txn(1).Read(1);
+    scheduler.Txn(0).Update(2, 1);
+    scheduler.Txn(1).Update(3, 1);
+    scheduler.Txn(0).Commit();
+    scheduler.Txn(1).Commit();
+
+    scheduler.Run();
+
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[0].txn_result);
+    EXPECT_EQ(ResultType::SUCCESS, scheduler.schedules[1].txn_result);
+  }
+
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_transaction_manager_test.cpp
+//
+// Identification: test/concurrency/partitioned_transaction_manager_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "concurrency/testing_transaction_util.h"
+#include "common/harness.h"
+#include "concurrency/partitioned_transaction_manager.h"
+
+namespace peloton {
+
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Partitioned Transaction Manager Tests
+//===--------------------------------------------------------------------===//
+
+class PartitionedTransactionManagerTests : public PelotonTest {};
+
+TEST_F(PartitionedTransactionManagerTests, SinglePartitionTest) {
+  concurrency::TransactionManagerFactory::Configure(ProtocolType::PARTITIONED);
+  auto &txn_manager =
+      static_cast<concurrency::PartitionedTransactionManager &>(
+          concurrency::TransactionManagerFactory::GetInstance());
+  txn_manager.SetPartitionCount(2);
+  EXPECT_EQ(2, txn_manager.GetPartitionCount());
+
+  // the table is partitioned by id
+  std::unique_ptr<storage::DataTable> table(
+      TestingTransactionUtil::CreateTable());
+  EXPECT_EQ(0, txn_manager.GetPartitionId(2));
+  EXPECT_EQ(1, txn_manager.GetPartitionId(3));
+
+  int result = -1;
+  auto txn = txn_manager.BeginPartitionTransaction(0, {0});
+  EXPECT_TRUE(txn->IsSinglePartition());
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table.get(), 0, result));
+  EXPECT_EQ(0, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 2, 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // a cross-partition transaction sees the writes of the partition
+  txn = txn_manager.BeginPartitionTransaction(0, {1, 0});
+  EXPECT_FALSE(txn->IsSinglePartition());
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table.get(), 2, result));
+  EXPECT_EQ(1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 3, 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // an aborted transaction releases its partition as well
+  txn = txn_manager.BeginPartitionTransaction(0, {1});
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 3, 2));
+  EXPECT_EQ(ResultType::ABORTED, txn_manager.AbortTransaction(txn));
+
+  txn = txn_manager.BeginPartitionTransaction(0, {1});
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table.get(), 3, result));
+  EXPECT_EQ(1, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING);
+}
+
+TEST_F(PartitionedTransactionManagerTests, PartitionLockTest) {
+  concurrency::TransactionManagerFactory::Configure(ProtocolType::PARTITIONED);
+  auto &txn_manager =
+      static_cast<concurrency::PartitionedTransactionManager &>(
+          concurrency::TransactionManagerFactory::GetInstance());
+  txn_manager.SetPartitionCount(2);
+
+  auto txn = txn_manager.BeginPartitionTransaction(0, {1});
+
+  // transactions of other partitions are not blocked, those of the held
+  // partition wait for it to be released
+  std::atomic<bool> other_partition_done(false);
+  std::atomic<bool> same_partition_done(false);
+  std::thread thread([&] {
+    auto other_txn = txn_manager.BeginPartitionTransaction(0, {0});
+    txn_manager.CommitTransaction(other_txn);
+    other_partition_done = true;
+
+    other_txn = txn_manager.BeginPartitionTransaction(0, {0, 1});
+    same_partition_done = true;
+    txn_manager.CommitTransaction(other_txn);
+  });
+
+  while (other_partition_done == false) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(same_partition_done);
+
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  thread.join();
+  EXPECT_TRUE(same_partition_done);
+
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING);
+}
+
+TEST_F(PartitionedTransactionManagerTests, InPlaceUpdateTest) {
+  concurrency::TransactionManagerFactory::Configure(ProtocolType::PARTITIONED);
+  auto &txn_manager =
+      static_cast<concurrency::PartitionedTransactionManager &>(
+          concurrency::TransactionManagerFactory::GetInstance());
+  txn_manager.SetPartitionCount(1);
+  txn_manager.SetInPlaceUpdates(true);
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingTransactionUtil::CreateTable());
+  auto tile_group_header = table->GetTileGroup(0)->GetHeader();
+  ItemPointer location = *(tile_group_header->GetIndirection(0));
+
+  // the newest version is updated in place
+  int result = -1;
+  auto txn = txn_manager.BeginPartitionTransaction(0, {0});
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 0, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 0, 2));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table.get(), 0, result));
+  EXPECT_EQ(2, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  ItemPointer *indirection = tile_group_header->GetIndirection(0);
+  EXPECT_EQ(location.block, indirection->block);
+  EXPECT_EQ(location.offset, indirection->offset);
+  EXPECT_TRUE(tile_group_header->GetNextItemPointer(0).IsNull());
+  EXPECT_EQ(INITIAL_TXN_ID, tile_group_header->GetTransactionId(0));
+
+  // an abort restores the old values from the undo buffer
+  txn = txn_manager.BeginPartitionTransaction(0, {0});
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 0, 3));
+  EXPECT_EQ(ResultType::ABORTED, txn_manager.AbortTransaction(txn));
+
+  txn = txn_manager.BeginPartitionTransaction(0, {0});
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table.get(), 0, result));
+  EXPECT_EQ(2, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  txn_manager.SetInPlaceUpdates(false);
+  concurrency::TransactionManagerFactory::Configure(
+      ProtocolType::TIMESTAMP_ORDERING);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// read_write_set_test.cpp
+//
+// Identification: test/concurrency/read_write_set_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "concurrency/read_write_set.h"
+#include "concurrency/transaction_manager_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Read Write Set Tests
+//===--------------------------------------------------------------------===//
+
+class ReadWriteSetTests : public PelotonTest {};
+
+TEST_F(ReadWriteSetTests, FindTest) {
+  concurrency::ReadWriteSet rw_set;
+  const oid_t tuple_count = 1000;
+
+  // small sets are searched linearly, larger ones through the index
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    ItemPointer location(tuple_id % 7, tuple_id);
+    EXPECT_EQ(nullptr, rw_set.Find(location));
+    rw_set.Insert(location, RWType::READ);
+
+    auto type = rw_set.Find(ItemPointer(0, 0));
+    EXPECT_NE(nullptr, type);
+  }
+  EXPECT_EQ(tuple_count, rw_set.size());
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    auto type = rw_set.Find(ItemPointer(tuple_id % 7, tuple_id));
+    EXPECT_NE(nullptr, type);
+    EXPECT_EQ(RWType::READ, *type);
+    if (tuple_id % 2 == 0) {
+      *type = RWType::UPDATE;
+    }
+    EXPECT_EQ(nullptr, rw_set.Find(ItemPointer(tuple_id % 7 + 1, tuple_id)));
+  }
+
+  // entries are iterated in the order of their first access
+  oid_t tuple_id = 0;
+  for (auto &entry : rw_set) {
+    EXPECT_EQ(tuple_id, entry.location.offset);
+    EXPECT_EQ(tuple_id % 2 == 0 ? RWType::UPDATE : RWType::READ, entry.type);
+    tuple_id++;
+  }
+
+  rw_set.Clear();
+  EXPECT_TRUE(rw_set.empty());
+  EXPECT_EQ(nullptr, rw_set.Find(ItemPointer(0, 0)));
+
+  rw_set.Insert(ItemPointer(0, 0), RWType::INSERT);
+  EXPECT_EQ(RWType::INSERT, *rw_set.Find(ItemPointer(0, 0)));
+}
+
+TEST_F(ReadWriteSetTests, TransactionReuseTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  auto txn = txn_manager.BeginTransaction();
+  txn_manager.AbortTransaction(txn);
+
+  // a transaction reused from the pool starts from a clean state
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(ResultType::SUCCESS, txn->GetResult());
+  EXPECT_TRUE(txn->GetReadWriteSet().empty());
+  EXPECT_TRUE(txn->IsGCSetEmpty());
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // End test namespace
+}  // End peloton namespace
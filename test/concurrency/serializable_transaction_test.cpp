@@ -23,7 +23,8 @@ namespace test {
 class SerializableTransactionTests : public PelotonTest {};
 
 static std::vector<ProtocolType> PROTOCOL_TYPES = {
-    ProtocolType::TIMESTAMP_ORDERING
+    ProtocolType::TIMESTAMP_ORDERING,
+    ProtocolType::OPTIMISTIC
 };
 
 static IsolationLevelType ISOLATION_LEVEL_TYPE = 
@@ -13,6 +13,10 @@
 
 #include "concurrency/testing_transaction_util.h"
 #include "common/harness.h"
+#include "executor/testing_executor_util.h"
+#include "catalog/manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 
 namespace peloton {
 
@@ -29,5 +33,192 @@ TEST_F(TimestampOrderingTransactionManagerTests, Test) {
   EXPECT_TRUE(true);
 }
 
+TEST_F(TimestampOrderingTransactionManagerTests, GetVisibleTuplesTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuples_per_tilegroup,
+                                     false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+
+  // Delete the second tuple
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(txn_manager.AcquireOwnership(txn, tile_group_header, 1));
+  ItemPointer new_location = data_table->InsertEmptyVersion();
+  txn_manager.PerformDelete(txn, ItemPointer(tile_group_id, 1), new_location);
+  txn_manager.CommitTransaction(txn);
+
+  // The fourth tuple is selected for update. Its owner still sees it, as do
+  // other transactions.
+  auto owner_txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(
+      txn_manager.PerformRead(owner_txn, ItemPointer(tile_group_id, 3), true));
+
+  auto reader_txn = txn_manager.BeginTransaction();
+  for (auto current_txn : {owner_txn, reader_txn}) {
+    std::vector<oid_t> selection_vector(tuples_per_tilegroup);
+    auto visible_count = txn_manager.GetVisibleTuples(
+        current_txn, tile_group_header, 0, tuples_per_tilegroup,
+        selection_vector.data());
+    EXPECT_EQ(static_cast<oid_t>(tuples_per_tilegroup - 1), visible_count);
+
+    // Same answer as checking the tuples one by one
+    oid_t visible_idx = 0;
+    for (oid_t tuple_id = 0; tuple_id < tuples_per_tilegroup; tuple_id++) {
+      if (txn_manager.IsVisible(current_txn, tile_group_header, tuple_id) ==
+          VisibilityType::OK) {
+        EXPECT_EQ(tuple_id, selection_vector[visible_idx]);
+        visible_idx++;
+      }
+    }
+    EXPECT_EQ(visible_count, visible_idx);
+  }
+
+  // Subranges only cover their own slots
+  std::vector<oid_t> selection_vector(tuples_per_tilegroup);
+  EXPECT_EQ(1U, txn_manager.GetVisibleTuples(reader_txn, tile_group_header, 1,
+                                             3, selection_vector.data()));
+  EXPECT_EQ(2U, selection_vector[0]);
+
+  txn_manager.CommitTransaction(reader_txn);
+  txn_manager.CommitTransaction(owner_txn);
+}
+
+TEST_F(TimestampOrderingTransactionManagerTests, ReadOnlyTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     TESTS_TUPLES_PER_TILEGROUP, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+  auto reserved_size = storage::TileGroupHeader::GetReservedSize();
+  std::vector<char> reserved_field(reserved_size);
+  PL_MEMCPY(reserved_field.data(), tile_group_header->GetReservedFieldRef(0),
+            reserved_size);
+
+  // Reads of a declared read-only transaction leave the header untouched
+  auto read_only_txn =
+      txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
+  EXPECT_TRUE(read_only_txn->IsDeclaredReadOnly());
+  EXPECT_EQ(VisibilityType::OK,
+            txn_manager.IsVisible(read_only_txn, tile_group_header, 0));
+  EXPECT_TRUE(
+      txn_manager.PerformRead(read_only_txn, ItemPointer(tile_group_id, 0)));
+  EXPECT_EQ(0, memcmp(reserved_field.data(),
+                      tile_group_header->GetReservedFieldRef(0),
+                      reserved_size));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(read_only_txn));
+
+  // A read-only transaction can be rolled back
+  read_only_txn = txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
+  EXPECT_EQ(ResultType::ABORTED, txn_manager.AbortTransaction(read_only_txn));
+
+  // Other transactions record their reads
+  txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(txn->IsDeclaredReadOnly());
+  EXPECT_TRUE(txn_manager.PerformRead(txn, ItemPointer(tile_group_id, 0)));
+  EXPECT_NE(0, memcmp(reserved_field.data(),
+                      tile_group_header->GetReservedFieldRef(0),
+                      reserved_size));
+  txn_manager.CommitTransaction(txn);
+}
+
+TEST_F(TimestampOrderingTransactionManagerTests, SnapshotWriteConflictTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     TESTS_TUPLES_PER_TILEGROUP, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group_id = data_table->GetTileGroup(0)->GetTileGroupId();
+
+  // Two writers begin before a serializable transaction reads their tuples
+  auto snapshot_txn =
+      txn_manager.BeginTransaction(IsolationLevelType::SNAPSHOT);
+  auto serializable_txn =
+      txn_manager.BeginTransaction(IsolationLevelType::SERIALIZABLE);
+  auto reader_txn =
+      txn_manager.BeginTransaction(IsolationLevelType::SERIALIZABLE);
+  for (oid_t tuple_id : {0, 1}) {
+    EXPECT_TRUE(txn_manager.PerformRead(reader_txn,
+                                        ItemPointer(tile_group_id, tuple_id)));
+  }
+
+  // Only the serializable writer conflicts with the later reader
+  EXPECT_FALSE(txn_manager.PerformRead(serializable_txn,
+                                       ItemPointer(tile_group_id, 0), true));
+  EXPECT_TRUE(txn_manager.PerformRead(snapshot_txn,
+                                      ItemPointer(tile_group_id, 1), true));
+
+  // Snapshot writers still conflict with each other
+  auto other_snapshot_txn =
+      txn_manager.BeginTransaction(IsolationLevelType::SNAPSHOT);
+  EXPECT_FALSE(txn_manager.PerformRead(other_snapshot_txn,
+                                       ItemPointer(tile_group_id, 1), true));
+
+  txn_manager.AbortTransaction(other_snapshot_txn);
+  txn_manager.AbortTransaction(serializable_txn);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(snapshot_txn));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(reader_txn));
+}
+
+TEST_F(TimestampOrderingTransactionManagerTests, PruneVersionChainTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  std::unique_ptr<storage::DataTable> table(
+      TestingTransactionUtil::CreateTable());
+  ItemPointer *indirection =
+      table->GetTileGroup(0)->GetHeader()->GetIndirection(0);
+
+  for (int value = 1; value <= 2; value++) {
+    auto txn = txn_manager.BeginTransaction();
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 0,
+                                                      value));
+    EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  auto head = *indirection;
+  auto head_header = manager.GetTileGroup(head.block)->GetHeader();
+
+  // the older versions may still be visible to a running transaction
+  int result = -1;
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table.get(), 0, result));
+  EXPECT_EQ(2, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_FALSE(head_header->GetNextItemPointer(head.offset).IsNull());
+
+  // once the epoch of the updates has expired, a reader detaches them
+  epoch_manager.SetCurrentEpochId(3);
+  epoch_manager.GetExpiredCid();
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table.get(), 0, result));
+  EXPECT_EQ(2, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_TRUE(head_header->GetNextItemPointer(head.offset).IsNull());
+  EXPECT_EQ(head.block, indirection->block);
+  EXPECT_EQ(head.offset, indirection->offset);
+}
+
 }  // End test namespace
 }  // End peloton namespace
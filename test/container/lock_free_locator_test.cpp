@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// lock_free_locator_test.cpp
+//
+// Identification: test/container/lock_free_locator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/lock_free_locator.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Lock Free Locator Tests
+//===--------------------------------------------------------------------===//
+
+class LockFreeLocatorTests : public PelotonTest {};
+
+TEST_F(LockFreeLocatorTests, BasicTest) {
+  LockFreeLocator<int> locator;
+  EXPECT_EQ(nullptr, locator.Find(0));
+
+  // Offsets far apart land in segments of their own
+  std::vector<size_t> offsets = {0, 1, 65535, 65536, 1000000, 4000000000};
+  for (auto offset : offsets) {
+    locator.Update(offset, std::make_shared<int>(offset % 1000));
+  }
+  for (auto offset : offsets) {
+    auto value = locator.Find(offset);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(static_cast<int>(offset % 1000), *value);
+  }
+  EXPECT_EQ(nullptr, locator.Find(2));
+  EXPECT_EQ(nullptr, locator.Find(3000000000));
+
+  // Replaced and dropped entries are deleted without concurrent lookups
+  std::shared_ptr<int> value(new int(7));
+  std::weak_ptr<int> weak_value(value);
+  EXPECT_EQ(1, *locator.Update(1, value));
+  EXPECT_EQ(value.get(), locator.FindPointer(1));
+  value.reset();
+  EXPECT_EQ(7, *locator.Find(1));
+  EXPECT_EQ(7, *locator.Erase(1));
+  EXPECT_EQ(nullptr, locator.Find(1));
+  EXPECT_TRUE(weak_value.expired());
+  EXPECT_EQ(0U, locator.GetRetiredCount());
+
+  EXPECT_EQ(nullptr, locator.Erase(2));
+  EXPECT_EQ(nullptr, locator.FindPointer(2));
+  locator.Clear();
+  for (auto offset : offsets) {
+    EXPECT_EQ(nullptr, locator.Find(offset));
+  }
+}
+
+TEST_F(LockFreeLocatorTests, MultiThreadedTest) {
+  LockFreeLocator<size_t> locator;
+  const size_t offset_count = 256;
+  const size_t operation_count = 20000;
+  for (size_t offset = 0; offset < offset_count; offset++) {
+    locator.Update(offset, std::make_shared<size_t>(offset));
+  }
+
+  // Lookups either see no entry or an entry of their offset, never a deleted
+  // one
+  std::atomic<bool> done(false);
+  std::vector<std::thread> readers;
+  for (int reader_id = 0; reader_id < 4; reader_id++) {
+    readers.emplace_back([&locator, &done, offset_count] {
+      size_t offset = 0;
+      while (done.load() == false) {
+        auto value = locator.Find(offset);
+        if (value != nullptr) {
+          EXPECT_EQ(offset, *value % offset_count);
+        }
+        offset = (offset + 1) % offset_count;
+      }
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (size_t writer_id = 0; writer_id < 2; writer_id++) {
+    writers.emplace_back([&locator, writer_id, offset_count, operation_count] {
+      for (size_t i = 0; i < operation_count; i++) {
+        size_t offset = (i * 7 + writer_id) % offset_count;
+        if (i % 3 == 0) {
+          locator.Erase(offset);
+        } else {
+          locator.Update(offset, std::make_shared<size_t>(offset + i *
+                                                          offset_count));
+        }
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  // Without lookups running the next entry replaced deletes all retired ones
+  locator.Update(0, std::make_shared<size_t>(0));
+  locator.Update(0, std::make_shared<size_t>(0));
+  EXPECT_EQ(0U, locator.GetRetiredCount());
+}
+
+}  // namespace test
+}  // namespace peloton
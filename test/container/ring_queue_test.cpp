@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// ring_queue_test.cpp
+//
+// Identification: test/container/ring_queue_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/ring_queue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Ring Queue Tests
+//===--------------------------------------------------------------------===//
+
+class RingQueueTests : public PelotonTest {};
+
+TEST_F(RingQueueTests, BoundedTest) {
+  MPMCRingQueue<int> queue(5);
+  EXPECT_EQ(8U, queue.GetCapacity());
+  EXPECT_TRUE(queue.IsEmpty());
+
+  for (int i = 0; i < 8; i++) {
+    EXPECT_TRUE(queue.Enqueue(i));
+  }
+  EXPECT_FALSE(queue.Enqueue(8));
+
+  int item;
+  EXPECT_TRUE(queue.Dequeue(item));
+  EXPECT_EQ(0, item);
+
+  // Only the free slot is filled, and items come out in order
+  int batch[4] = {8, 9, 10, 11};
+  EXPECT_EQ(1U, queue.EnqueueBatch(batch, 4));
+
+  int items[16];
+  EXPECT_EQ(8U, queue.DequeueBatch(items, 16));
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(i + 1, items[i]);
+  }
+  EXPECT_TRUE(queue.IsEmpty());
+  EXPECT_FALSE(queue.Dequeue(item));
+  EXPECT_EQ(0U, queue.DequeueBatch(items, 16));
+}
+
+TEST_F(RingQueueTests, MultiThreadedTest) {
+  MPMCRingQueue<std::shared_ptr<int>> queue(64);
+  const int producer_count = 4;
+  const int consumer_count = 2;
+  const int item_count = 10000;
+
+  std::atomic<int64_t> sum(0);
+  std::atomic<int> dequeued_count(0);
+  std::vector<std::thread> threads;
+
+  // Half the producers enqueue in batches
+  for (int producer = 0; producer < producer_count; producer++) {
+    threads.emplace_back([&queue, producer, item_count] {
+      for (int i = 0; i < item_count;) {
+        if (producer % 2 == 0) {
+          if (queue.Enqueue(std::make_shared<int>(i))) {
+            i++;
+          }
+          continue;
+        }
+        std::shared_ptr<int> batch[3];
+        size_t count = std::min(3, item_count - i);
+        for (size_t j = 0; j < count; j++) {
+          batch[j] = std::make_shared<int>(i + j);
+        }
+        i += queue.EnqueueBatch(batch, count);
+      }
+    });
+  }
+
+  // One consumer dequeues in batches
+  for (int consumer = 0; consumer < consumer_count; consumer++) {
+    threads.emplace_back([&, consumer] {
+      while (dequeued_count.load() < producer_count * item_count) {
+        std::shared_ptr<int> items[5];
+        size_t count = (consumer == 0) ? queue.DequeueBatch(items, 5)
+                                       : (queue.Dequeue(items[0]) ? 1 : 0);
+        for (size_t j = 0; j < count; j++) {
+          sum += *items[j];
+        }
+        dequeued_count += count;
+      }
+    });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  int64_t expected_sum =
+      (int64_t)producer_count * item_count * (item_count - 1) / 2;
+  EXPECT_EQ(expected_sum, sum.load());
+  EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST_F(RingQueueTests, SingleProducerTest) {
+  SPSCRingQueue<std::unique_ptr<int>> queue(16);
+  EXPECT_EQ(16U, queue.GetCapacity());
+  const int item_count = 10000;
+
+  std::thread producer([&queue, item_count] {
+    for (int i = 0; i < item_count;) {
+      std::unique_ptr<int> batch[2] = {std::unique_ptr<int>(new int(i)),
+                                       std::unique_ptr<int>(new int(i + 1))};
+      size_t count = std::min(2, item_count - i);
+      i += queue.EnqueueBatch(batch, count);
+    }
+  });
+
+  // Items come out in the order they went in
+  int next = 0;
+  while (next < item_count) {
+    std::unique_ptr<int> items[3];
+    size_t count = queue.DequeueBatch(items, 3);
+    for (size_t j = 0; j < count; j++) {
+      EXPECT_EQ(next, *items[j]);
+      next++;
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(queue.IsEmpty());
+  std::unique_ptr<int> item;
+  EXPECT_FALSE(queue.Dequeue(item));
+}
+
+}  // namespace test
+}  // namespace peloton
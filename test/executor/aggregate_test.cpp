@@ -22,6 +22,7 @@
 #include "type/value.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/aggregate_executor.h"
+#include "executor/aggregator.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
@@ -863,5 +864,28 @@ TEST_F(AggregateTests, PlainSumCountDistinctTest) {
   EXPECT_TRUE(cmp == type::CMP_TRUE);
 }
 
+TEST_F(AggregateTests, ApproxCountDistinctTest) {
+  EXPECT_EQ(ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT,
+            ParserExpressionNameToExpressionType("approx_count_distinct"));
+
+  // Every value shows up twice, split over two partial aggregates
+  const int distinct_count = 10000;
+  executor::ApproxCountDistinctAggregator lower, upper, all;
+  for (int i = 0; i < distinct_count; i++) {
+    auto value = type::ValueFactory::GetIntegerValue(i);
+    auto &partial = i < distinct_count / 2 ? lower : upper;
+    partial.Advance(value);
+    partial.Advance(value);
+    all.Advance(value);
+  }
+  all.Advance(type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER));
+
+  int64_t estimate = all.Finalize().GetAs<int64_t>();
+  EXPECT_LT(std::abs(estimate - distinct_count), distinct_count / 20);
+
+  lower.Merge(upper);
+  EXPECT_EQ(estimate, lower.Finalize().GetAs<int64_t>());
+}
+
 }  // namespace test
 }  // namespace peloton
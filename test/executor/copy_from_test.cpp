@@ -0,0 +1,182 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_from_test.cpp
+//
+// Identification: test/executor/copy_from_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "executor/testing_executor_util.h"
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "executor/copy_from_executor.h"
+#include "executor/copy_from_loader.h"
+#include "executor/executor_context.h"
+#include "planner/copy_plan.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace test {
+
+class CopyFromTests : public PelotonTest {};
+
+namespace {
+
+const std::string kFilePath = "/tmp/copy_from_test.csv";
+
+// Enough rows for the file to be cut into several chunks
+const size_t kNumRows = 100000;
+
+void WriteFile(const std::string &text) {
+  FILE *file = fopen(kFilePath.c_str(), "w");
+  ASSERT_NE(nullptr, file);
+  fwrite(text.data(), 1, text.size(), file);
+  fclose(file);
+}
+
+// Run a COPY FROM of the file into the table, returns whether it succeeded
+bool RunCopyFrom(storage::DataTable *table, size_t &row_count) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  char *file_path = const_cast<char *>(kFilePath.c_str());
+  planner::CopyPlan node(file_path, table, ',');
+  executor::CopyFromExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+  bool success;
+  try {
+    success = executor.Execute();
+  } catch (Exception &e) {
+    txn_manager.AbortTransaction(txn);
+    throw;
+  }
+  row_count = executor.GetRowCount();
+
+  if (success) {
+    txn_manager.CommitTransaction(txn);
+  } else {
+    txn_manager.AbortTransaction(txn);
+  }
+  return success;
+}
+
+void CheckCopyFrom(size_t thread_count) {
+  FLAGS_copy_threads = thread_count;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(1000, false));
+
+  // Escaped delimiters, escaped new lines, Windows line ends and empty lines
+  std::string text;
+  for (size_t row = 0; row < kNumRows; row++) {
+    std::string value = std::to_string(row);
+    text += value + "," + std::to_string(row + 1) + "," + value + ".5,";
+    if (row % 3 == 0) {
+      text += "a\\,b" + value + "\n";
+    } else if (row % 3 == 1) {
+      text += "a\\\nb" + value + "\r\n";
+    } else {
+      text += "ab" + value + "\n\n";
+    }
+  }
+  WriteFile(text);
+
+  size_t row_count = 0;
+  EXPECT_TRUE(RunCopyFrom(table.get(), row_count));
+  EXPECT_EQ(kNumRows, row_count);
+  EXPECT_EQ(kNumRows, table->GetTupleCount());
+
+  // The rows are loaded in the order of the file
+  size_t row = 0;
+  for (oid_t tile_group_itr = 0; tile_group_itr < table->GetTileGroupCount();
+       tile_group_itr++) {
+    auto tile_group = table->GetTileGroup(tile_group_itr);
+    for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+         tuple_id++, row++) {
+      std::string value = std::to_string(row);
+      int32_t integer = static_cast<int32_t>(row);
+      EXPECT_EQ(integer, tile_group->GetValue(tuple_id, 0).GetAs<int32_t>());
+      EXPECT_EQ(integer + 1,
+                tile_group->GetValue(tuple_id, 1).GetAs<int32_t>());
+      EXPECT_EQ(row + 0.5, tile_group->GetValue(tuple_id, 2).GetAs<double>());
+
+      std::string expected = row % 3 == 0 ? "a,b" + value
+                                          : row % 3 == 1 ? "a\nb" + value
+                                                         : "ab" + value;
+      EXPECT_EQ(expected, tile_group->GetValue(tuple_id, 3).ToString());
+    }
+  }
+  EXPECT_EQ(kNumRows, row);
+}
+
+}  // namespace
+
+TEST_F(CopyFromTests, SerialTest) { CheckCopyFrom(1); }
+
+TEST_F(CopyFromTests, ParallelTest) { CheckCopyFrom(4); }
+
+TEST_F(CopyFromTests, InvalidRowTest) {
+  FLAGS_copy_threads = 4;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(1000, false));
+  size_t row_count = 0;
+
+  // A missing field
+  WriteFile("1,2,3.5,a\n4,5,6.5\n");
+  EXPECT_THROW(RunCopyFrom(table.get(), row_count), ExecutorException);
+
+  // A value that is not a number
+  WriteFile("1,2,3.5,a\nb,5,6.5,c\n");
+  EXPECT_THROW(RunCopyFrom(table.get(), row_count), Exception);
+
+  // An empty field is NULL, which violates the constraint of the column
+  WriteFile("1,2,3.5,a\n4,,6.5,b\n");
+  EXPECT_FALSE(RunCopyFrom(table.get(), row_count));
+  EXPECT_EQ(0U, table->GetTupleCount());
+}
+
+TEST_F(CopyFromTests, LoaderTest) {
+  // Text handed over in pieces that split lines, as CopyData does
+  FLAGS_copy_threads = 4;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(1000, false));
+  std::string text;
+  for (size_t row = 0; row < kNumRows; row++) {
+    std::string value = std::to_string(row);
+    text += value + "," + value + "," + value + ".5,a\\\nb\n";
+  }
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  executor::CopyFromLoader loader(table.get(), ',', txn);
+  const size_t piece_size = 1000;
+  for (size_t pos = 0; pos < text.size(); pos += piece_size) {
+    EXPECT_TRUE(loader.Append(text.data() + pos,
+                              std::min(piece_size, text.size() - pos)));
+  }
+  EXPECT_TRUE(loader.Finish());
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ(kNumRows, loader.GetRowCount());
+  EXPECT_EQ(kNumRows, table->GetTupleCount());
+  // An escaped new line is part of the value
+  auto tile_group = table->GetTileGroup(table->GetTileGroupCount() - 1);
+  oid_t last_tuple = tile_group->GetNextTupleSlot() - 1;
+  EXPECT_EQ("a\nb", tile_group->GetValue(last_tuple, 3).ToString());
+}
+
+}  // namespace test
+}  // namespace peloton
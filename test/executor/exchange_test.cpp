@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// exchange_test.cpp
+//
+// Identification: test/executor/exchange_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "executor/testing_executor_util.h"
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "executor/exchange_executor.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "planner/exchange_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace test {
+
+class ExchangeTests : public PelotonTest {};
+
+namespace {
+
+// 40 tile groups of 5 tuples each
+const size_t kNumRows = 40 * TESTS_TUPLES_PER_TILEGROUP;
+
+storage::DataTable *CreateAndPopulateTable() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  TestingExecutorUtil::PopulateTable(table.get(), kNumRows, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+  return table.release();
+}
+
+// Scan the first column of the table through an exchange with the given
+// number of instances, returning its values
+std::multiset<int32_t> RunExchange(storage::DataTable *table,
+                                   size_t num_instances,
+                                   IsolationLevelType isolation_level,
+                                   size_t *read_count = nullptr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction(isolation_level);
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::ExchangePlan exchange_plan(num_instances);
+  std::unique_ptr<planner::AbstractPlan> scan_plan(
+      new planner::SeqScanPlan(table, nullptr, {0}));
+  exchange_plan.AddChild(std::move(scan_plan));
+
+  // The exchange stops its workers before the child is destroyed
+  executor::SeqScanExecutor scan(exchange_plan.GetChildren()[0].get(),
+                                 context.get());
+  executor::ExchangeExecutor exchange(&exchange_plan, context.get());
+  exchange.AddChild(&scan);
+
+  std::multiset<int32_t> values;
+  EXPECT_TRUE(exchange.Init());
+  while (exchange.Execute()) {
+    std::unique_ptr<executor::LogicalTile> tile(exchange.GetOutput());
+    for (oid_t tuple_id : *tile) {
+      values.insert(tile->GetValue(tuple_id, 0).GetAs<int32_t>());
+    }
+  }
+
+  if (read_count != nullptr) {
+    *read_count = txn->GetReadWriteSet().size();
+  }
+  txn_manager.CommitTransaction(txn);
+  return values;
+}
+
+}  // namespace
+
+TEST_F(ExchangeTests, ParallelScanTest) {
+  FLAGS_exchange_threads = 4;
+  std::unique_ptr<storage::DataTable> table(CreateAndPopulateTable());
+
+  // Every tuple is returned once, whichever thread scanned it
+  auto values = RunExchange(table.get(), 8, IsolationLevelType::READ_ONLY);
+  EXPECT_EQ(kNumRows, values.size());
+  EXPECT_EQ(kNumRows, std::set<int32_t>(values.begin(), values.end()).size());
+
+  // More instances than tile groups
+  values = RunExchange(table.get(), 100, IsolationLevelType::READ_ONLY);
+  EXPECT_EQ(kNumRows, values.size());
+}
+
+TEST_F(ExchangeTests, SerializableScanTest) {
+  FLAGS_exchange_threads = 4;
+  std::unique_ptr<storage::DataTable> table(CreateAndPopulateTable());
+
+  // The workers record the reads of every tuple in the transaction
+  size_t read_count = 0;
+  auto read_only_values =
+      RunExchange(table.get(), 8, IsolationLevelType::READ_ONLY);
+  auto serializable_values = RunExchange(
+      table.get(), 8, IsolationLevelType::SERIALIZABLE, &read_count);
+  EXPECT_EQ(read_only_values, serializable_values);
+  EXPECT_EQ(kNumRows, read_count);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_nested_loop_join_test.cpp
+//
+// Identification: test/executor/index_nested_loop_join_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "executor/testing_executor_util.h"
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/index_nested_loop_join_executor.h"
+#include "executor/index_scan_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "expression/comparison_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/index_nested_loop_join_plan.h"
+#include "planner/index_scan_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class IndexNestedLoopJoinTests : public PelotonTest {};
+
+namespace {
+
+const int kNumLeftRows = 20;
+
+// Join LEFT.A = RIGHT.A through the given index of the right table, and
+// return the number of joined tuples
+size_t ExecuteIndexNestedLoopJoin(storage::DataTable *left_table,
+                                  storage::DataTable *right_table,
+                                  oid_t index_offset) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids({0, 1});
+  planner::SeqScanPlan left_node(left_table, nullptr, column_ids);
+  executor::SeqScanExecutor left_executor(&left_node, context.get());
+
+  // The key values are set by the join
+  std::vector<oid_t> key_column_ids({0});
+  std::vector<ExpressionType> expr_types({ExpressionType::COMPARE_EQUAL});
+  std::vector<type::Value> values(
+      {type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER)});
+  std::vector<expression::AbstractExpression *> runtime_keys;
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      right_table->GetIndex(index_offset), key_column_ids, expr_types, values,
+      runtime_keys);
+  planner::IndexScanPlan right_node(right_table, nullptr, column_ids,
+                                    index_scan_desc);
+  executor::IndexScanExecutor right_executor(&right_node, context.get());
+
+  std::unique_ptr<const expression::AbstractExpression> predicate(
+      new expression::ComparisonExpression(
+          ExpressionType::COMPARE_EQUAL,
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0),
+          new expression::TupleValueExpression(type::TypeId::INTEGER, 1, 0)));
+  std::unique_ptr<const planner::ProjectInfo> projection;
+  std::shared_ptr<const catalog::Schema> schema;
+  planner::IndexNestedLoopJoinPlan join_node(
+      JoinType::INNER, std::move(predicate), std::move(projection), schema,
+      {0}, {0});
+  executor::IndexNestedLoopJoinExecutor join_executor(&join_node,
+                                                      context.get());
+  join_executor.AddChild(&left_executor);
+  join_executor.AddChild(&right_executor);
+
+  size_t result_tuple_count = 0;
+  EXPECT_TRUE(join_executor.Init());
+  while (join_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        join_executor.GetOutput());
+    EXPECT_EQ(4U, result_tile->GetColumnCount());
+    for (auto tuple_id : *result_tile) {
+      EXPECT_EQ(result_tile->GetValue(tuple_id, 0).GetAs<int32_t>(),
+                result_tile->GetValue(tuple_id, 2).GetAs<int32_t>());
+      EXPECT_EQ(result_tile->GetValue(tuple_id, 1).GetAs<int32_t>(),
+                result_tile->GetValue(tuple_id, 3).GetAs<int32_t>());
+      result_tuple_count++;
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+  return result_tuple_count;
+}
+
+}  // namespace
+
+TEST_F(IndexNestedLoopJoinTests, JoinTest) {
+  // The right table has the keys 0, 10, ..., 140
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateAndPopulateTable());
+
+  // The left table has every key 0, 30, ..., 570 twice, 0 to 120 of them are
+  // in the right table
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(kNumLeftRows, false));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(left_table.get(), kNumLeftRows, true,
+                                     false, false, txn);
+  TestingExecutorUtil::PopulateTable(left_table.get(), kNumLeftRows, true,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The keys are the whole key of the primary index, which looks all keys of
+  // a left tile up at once
+  EXPECT_EQ(10U, ExecuteIndexNestedLoopJoin(left_table.get(),
+                                            right_table.get(), 0));
+
+  // The keys are a prefix of the key of the secondary index on (A, B), which
+  // is scanned for every key
+  EXPECT_EQ(10U, ExecuteIndexNestedLoopJoin(left_table.get(),
+                                            right_table.get(), 1));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -33,6 +33,7 @@
 #include "planner/index_scan_plan.h"
 #include "planner/insert_plan.h"
 #include "storage/data_table.h"
+#include "storage/tile_group_freezer.h"
 #include "tcop/tcop.h"
 
 
@@ -171,5 +172,73 @@ TEST_F(IndexScanTests, MultiColumnPredicateTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+// Index scan that only reads key columns of the primary key index.
+TEST_F(IndexScanTests, IndexOnlyScanTest) {
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateAndPopulateTable());
+
+  // Every tile group is full, so all of them are frozen
+  auto &freezer = storage::TileGroupFreezer::GetInstance();
+  EXPECT_EQ(DEFAULT_TILEGROUP_COUNT,
+            freezer.FreezeTable(data_table.get(), MAX_CID - 1));
+
+  //===--------------------------------------------------------------------===//
+  // ATTR 0 < 110
+  //===--------------------------------------------------------------------===//
+
+  auto index = data_table->GetIndex(0);
+  std::vector<oid_t> key_column_ids({0});
+  std::vector<ExpressionType> expr_types({ExpressionType::COMPARE_LESSTHAN});
+  std::vector<type::Value> values(
+      {type::ValueFactory::GetIntegerValue(110).Copy()});
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      index, key_column_ids, expr_types, values, runtime_keys);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  // Only the key column is read, so the tuples come from the index keys
+  // in one tile
+  planner::IndexScanPlan key_node(data_table.get(), nullptr, {0},
+                                  index_scan_desc);
+  executor::IndexScanExecutor key_executor(&key_node, context.get());
+  EXPECT_TRUE(key_executor.Init());
+  EXPECT_TRUE(key_executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(key_executor.GetOutput());
+  EXPECT_FALSE(key_executor.Execute());
+
+  EXPECT_EQ(1, result_tile->GetColumnCount());
+  EXPECT_EQ(11, result_tile->GetTupleCount());
+  oid_t tuple_id = 0;
+  for (oid_t tuple_itr : *result_tile) {
+    type::Value expected = type::ValueFactory::GetIntegerValue(
+        TestingExecutorUtil::PopulatedValue(tuple_id, 0));
+    EXPECT_EQ(type::CMP_TRUE,
+              result_tile->GetValue(tuple_itr, 0).CompareEquals(expected));
+    tuple_id++;
+  }
+
+  // The other columns are read from the tile groups
+  planner::IndexScanPlan table_node(data_table.get(), nullptr, {0, 1},
+                                    index_scan_desc);
+  executor::IndexScanExecutor table_executor(&table_node, context.get());
+  EXPECT_TRUE(table_executor.Init());
+  size_t tuple_count = 0;
+  size_t tile_count = 0;
+  while (table_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> tile(table_executor.GetOutput());
+    tuple_count += tile->GetTupleCount();
+    tile_count++;
+  }
+  EXPECT_EQ(11, tuple_count);
+  EXPECT_EQ(DEFAULT_TILEGROUP_COUNT, tile_count);
+
+  txn_manager.CommitTransaction(txn);
+}
+
 }  // namespace test
 }  // namespace peloton
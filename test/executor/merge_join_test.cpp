@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// merge_join_test.cpp
+//
+// Identification: test/executor/merge_join_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "executor/testing_executor_util.h"
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "executor/executor_context.h"
+#include "executor/index_scan_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/merge_join_executor.h"
+#include "expression/expression_util.h"
+#include "planner/index_scan_plan.h"
+#include "planner/merge_join_plan.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace test {
+
+class MergeJoinTests : public PelotonTest {};
+
+namespace {
+
+// Enough left tuples for two threads
+const int kNumLeftRows =
+    2 * executor::MergeJoinExecutor::kMinRowsPerThread + 100;
+const int kNumRightRows = kNumLeftRows / 2;
+
+// A full scan of the primary key index in key order
+std::unique_ptr<planner::IndexScanPlan> CreateKeyOrderedScan(
+    storage::DataTable *table) {
+  std::vector<oid_t> column_ids({0, 1});
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      table->GetIndex(0), {}, {}, {}, {});
+  std::unique_ptr<planner::IndexScanPlan> scan_plan(new planner::IndexScanPlan(
+      table, nullptr, column_ids, index_scan_desc));
+  scan_plan->SetKeyOrdered(true);
+  return scan_plan;
+}
+
+// Join LEFT.A = RIGHT.A, and return the number of joined tuples
+size_t ExecuteMergeJoin(storage::DataTable *left_table,
+                        storage::DataTable *right_table,
+                        size_t thread_count) {
+  FLAGS_merge_join_threads = thread_count;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  auto left_node = CreateKeyOrderedScan(left_table);
+  executor::IndexScanExecutor left_executor(left_node.get(), context.get());
+  auto right_node = CreateKeyOrderedScan(right_table);
+  executor::IndexScanExecutor right_executor(right_node.get(), context.get());
+
+  std::vector<planner::MergeJoinPlan::JoinClause> join_clauses;
+  join_clauses.emplace_back(
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    0),
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 1,
+                                                    0),
+      false);
+  std::unique_ptr<const planner::ProjectInfo> projection;
+  std::shared_ptr<const catalog::Schema> schema;
+  planner::MergeJoinPlan join_node(JoinType::INNER, nullptr,
+                                   std::move(projection), schema,
+                                   join_clauses);
+  executor::MergeJoinExecutor join_executor(&join_node, context.get());
+  join_executor.AddChild(&left_executor);
+  join_executor.AddChild(&right_executor);
+
+  size_t result_tuple_count = 0;
+  EXPECT_TRUE(join_executor.Init());
+  while (join_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        join_executor.GetOutput());
+    EXPECT_EQ(4U, result_tile->GetColumnCount());
+    for (auto tuple_id : *result_tile) {
+      EXPECT_EQ(result_tile->GetValue(tuple_id, 0).GetAs<int32_t>(),
+                result_tile->GetValue(tuple_id, 2).GetAs<int32_t>());
+      result_tuple_count++;
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+  return result_tuple_count;
+}
+
+}  // namespace
+
+TEST_F(MergeJoinTests, ParallelKeyOrderedTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+
+  // The left keys are 0, 10, 20, ..., the right ones 0, 30, 60, ...
+  std::unique_ptr<storage::DataTable> left_table(
+      TestingExecutorUtil::CreateTable(1000));
+  TestingExecutorUtil::PopulateTable(left_table.get(), kNumLeftRows, false,
+                                     false, false, txn);
+  std::unique_ptr<storage::DataTable> right_table(
+      TestingExecutorUtil::CreateTable(1000));
+  TestingExecutorUtil::PopulateTable(right_table.get(), kNumRightRows, true,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Every right key up to the largest left one matches
+  size_t expected = (kNumLeftRows - 1) / 3 + 1;
+  EXPECT_EQ(expected,
+            ExecuteMergeJoin(left_table.get(), right_table.get(), 1));
+  EXPECT_EQ(expected,
+            ExecuteMergeJoin(left_table.get(), right_table.get(), 4));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -26,6 +26,8 @@
 #include "executor/logical_tile.h"
 #include "executor/order_by_executor.h"
 #include "executor/logical_tile_factory.h"
+#include "executor/seq_scan_executor.h"
+#include "planner/seq_scan_plan.h"
 #include "storage/data_table.h"
 #include "concurrency/transaction_manager_factory.h"
 
@@ -300,6 +302,91 @@ TEST_F(OrderByTests, StringDescIntAscTest) {
 
   RunTest(executor, tile_size * 2, sort_keys, descend_flags);
 }
+
+// Sort the table on 'b' ascending and 'd' descending through a sequential
+// scan, returning the values of 'b' in the order of the output
+std::vector<int32_t> RunSortedScan(storage::DataTable *table,
+                                   planner::OrderByPlan &node,
+                                   size_t memory_budget) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  context->SetMemoryBudget(memory_budget);
+
+  planner::SeqScanPlan scan_plan(table, nullptr, {0, 1, 2, 3});
+  executor::SeqScanExecutor scan(&scan_plan, context.get());
+  executor::OrderByExecutor executor(&node, context.get());
+  executor.AddChild(&scan);
+
+  std::vector<int32_t> values;
+  std::vector<std::string> strings;
+  EXPECT_TRUE(executor.Init());
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> tile(executor.GetOutput());
+    for (oid_t tuple_id : *tile) {
+      values.push_back(tile->GetValue(tuple_id, 1).GetAs<int32_t>());
+      strings.push_back(tile->GetValue(tuple_id, 3).ToString());
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+
+  for (size_t i = 1; i < values.size(); i++) {
+    EXPECT_LE(values[i - 1], values[i]);
+    if (values[i - 1] == values[i]) {
+      EXPECT_GE(strings[i - 1], strings[i]);
+    }
+  }
+  return values;
+}
+
+TEST_F(OrderByTests, ExternalSortTest) {
+  // 40 tile groups of 5 tuples each, with duplicate values of 'b'
+  const size_t num_rows = 40 * TESTS_TUPLES_PER_TILEGROUP;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), num_rows, false, true,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  planner::OrderByPlan node({1, 3}, {false, true}, {0, 1, 2, 3});
+
+  // The sort writes runs of a few tiles each, and merges them
+  auto in_memory_values = RunSortedScan(data_table.get(), node, 0);
+  auto merged_values = RunSortedScan(data_table.get(), node, 2048);
+  EXPECT_EQ(num_rows, in_memory_values.size());
+  EXPECT_EQ(in_memory_values, merged_values);
+
+  // Runs of a single tile
+  merged_values = RunSortedScan(data_table.get(), node, 1);
+  EXPECT_EQ(in_memory_values, merged_values);
+}
+
+TEST_F(OrderByTests, TopNTest) {
+  const size_t num_rows = 40 * TESTS_TUPLES_PER_TILEGROUP;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), num_rows, false, true,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  planner::OrderByPlan full_node({1, 3}, {false, true}, {0, 1, 2, 3});
+  auto all_values = RunSortedScan(data_table.get(), full_node, 0);
+
+  // ORDER BY b, d DESC LIMIT 7 OFFSET 3 keeps the first 10 tuples, the limit
+  // above skips the offset
+  planner::OrderByPlan node({1, 3}, {false, true}, {0, 1, 2, 3});
+  node.SetLimit(true);
+  node.SetLimitNumber(7);
+  node.SetLimitOffset(3);
+  auto values = RunSortedScan(data_table.get(), node, 0);
+  EXPECT_EQ(std::vector<int32_t>(all_values.begin(), all_values.begin() + 10),
+            values);
+}
 }
 
 }  // namespace test
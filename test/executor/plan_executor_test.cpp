@@ -0,0 +1,91 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_executor_test.cpp
+//
+// Identification: test/executor/plan_executor_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "executor/plan_executor.h"
+#include "optimizer/optimizer.h"
+
+namespace peloton {
+namespace test {
+
+class PlanExecutorTests : public PelotonTest {
+ protected:
+  virtual void SetUp() override {
+    PelotonTest::SetUp();
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE test(a INT PRIMARY KEY, b INT);");
+    for (int i = 0; i < 10; i++) {
+      TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (" +
+                                      std::to_string(i) + ", 1);");
+    }
+    optimizer_.reset(new optimizer::Optimizer());
+  }
+
+  virtual void TearDown() override {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+
+    PelotonTest::TearDown();
+  }
+
+  size_t EstimateProcessedRows(const std::string &query) {
+    auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer_, query);
+    return executor::PlanExecutor::EstimateProcessedRows(*plan);
+  }
+
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer_;
+};
+
+TEST_F(PlanExecutorTests, EstimateProcessedRowsTest) {
+  // A lookup of the primary key reads a single tuple, other scans all of
+  // them
+  EXPECT_EQ(1U, EstimateProcessedRows("SELECT b FROM test WHERE a = 3"));
+  EXPECT_EQ(10U, EstimateProcessedRows("SELECT b FROM test WHERE a > 3"));
+  EXPECT_EQ(10U, EstimateProcessedRows("SELECT b FROM test WHERE b = 1"));
+}
+
+TEST_F(PlanExecutorTests, ShortPlanTest) {
+  // Plans below the row threshold run on the executors with the same result
+  FLAGS_codegen_min_rows = 5;
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_changed;
+  TestingSQLUtil::ExecuteSQLQueryWithOptimizer(
+      optimizer_, "SELECT b FROM test WHERE a = 3", result, tuple_descriptor,
+      rows_changed, error_message);
+  ASSERT_EQ(1U, result.size());
+  EXPECT_EQ("1", TestingSQLUtil::GetResultValueAsString(result, 0));
+  TestingSQLUtil::ExecuteSQLQueryWithOptimizer(
+      optimizer_, "SELECT b FROM test WHERE a > 3", result, tuple_descriptor,
+      rows_changed, error_message);
+  EXPECT_EQ(6U, result.size());
+  FLAGS_codegen_min_rows = 0;
+}
+
+}  // namespace test
+}  // namespace peloton
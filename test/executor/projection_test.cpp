@@ -171,6 +171,67 @@ TEST_F(ProjectionTests, TwoColumnTest) {
   RunTest(executor, 1);
 }
 
+TEST_F(ProjectionTests, DirectMapTest) {
+  MockExecutor child_executor;
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  size_t tile_size = 5;
+
+  // Create a table and wrap it in logical tile
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tile_size));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tile_size, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+  storage::Tile *base_tile = source_logical_tile1->GetBaseTile(1);
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()));
+
+  /////////////////////////////////////////////////////////
+  // PROJECTION 1, 0
+  /////////////////////////////////////////////////////////
+
+  std::vector<catalog::Column> columns;
+  auto orig_schema = data_table.get()->GetSchema();
+  columns.push_back(orig_schema->GetColumn(1));
+  columns.push_back(orig_schema->GetColumn(0));
+  std::shared_ptr<const catalog::Schema> schema(new catalog::Schema(columns));
+
+  DirectMapList direct_map_list = {{0, {0, 1}}, {1, {0, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  planner::ProjectionPlan node(std::move(project_info), schema);
+
+  executor::ProjectionExecutor executor(&node, nullptr);
+  executor.AddChild(&child_executor);
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+
+  // The columns still refer to the table, nothing was copied
+  ASSERT_EQ(2U, result_tile->GetColumnCount());
+  EXPECT_EQ(base_tile, result_tile->GetBaseTile(0));
+  EXPECT_EQ(tile_size, result_tile->GetTupleCount());
+  for (oid_t tuple_id : *result_tile) {
+    int32_t a = result_tile->GetValue(tuple_id, 1).GetAs<int32_t>();
+    int32_t b = result_tile->GetValue(tuple_id, 0).GetAs<int32_t>();
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(tuple_id, 1), b);
+    EXPECT_EQ(TestingExecutorUtil::PopulatedValue(tuple_id, 0), a);
+  }
+  EXPECT_FALSE(executor.Execute());
+}
+
 TEST_F(ProjectionTests, BasicTargetTest) {
   MockExecutor child_executor;
   EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
@@ -0,0 +1,256 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// spill_test.cpp
+//
+// Identification: test/executor/spill_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "executor/testing_executor_util.h"
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/aggregator.h"
+#include "executor/executor_context.h"
+#include "executor/hash_executor.h"
+#include "executor/hash_join_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/spill_file.h"
+#include "expression/expression_util.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/table_factory.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class SpillTests : public PelotonTest {};
+
+namespace {
+
+// 20 tile groups of 5 tuples each
+const size_t kNumRows = 20 * TESTS_TUPLES_PER_TILEGROUP;
+
+// Large enough for a few tiles of a hash table, but not for all of them
+const size_t kSmallBudget = 4096;
+
+// Populate the table with the given number of copies of every row
+storage::DataTable *CreateAndPopulateTable(size_t num_copies) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+  for (size_t i = 0; i < num_copies; i++) {
+    TestingExecutorUtil::PopulateTable(table.get(), kNumRows, false, false,
+                                       false, txn);
+  }
+  txn_manager.CommitTransaction(txn);
+  return table.release();
+}
+
+}  // namespace
+
+TEST_F(SpillTests, SpillFileTest) {
+  executor::SpillFile file({type::TypeId::INTEGER, type::TypeId::VARCHAR,
+                            type::TypeId::DECIMAL});
+
+  const size_t num_rows = 100;
+  for (size_t row = 0; row < num_rows; row++) {
+    std::vector<type::Value> values = {
+        type::ValueFactory::GetIntegerValue(row),
+        row % 10 == 0
+            ? type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR)
+            : type::ValueFactory::GetVarcharValue(std::to_string(row)),
+        type::ValueFactory::GetDecimalValue(row / 2.0)};
+    file.Append(values);
+  }
+  EXPECT_EQ(num_rows, file.GetRowCount());
+
+  // The rows are read back in order, twice
+  for (size_t pass = 0; pass < 2; pass++) {
+    file.Rewind();
+    std::vector<type::Value> values;
+    size_t row = 0;
+    while (file.Next(values)) {
+      ASSERT_EQ(3U, values.size());
+      EXPECT_EQ(static_cast<int32_t>(row), values[0].GetAs<int32_t>());
+      if (row % 10 == 0) {
+        EXPECT_TRUE(values[1].IsNull());
+      } else {
+        EXPECT_EQ(std::to_string(row), values[1].ToString());
+      }
+      EXPECT_EQ(row / 2.0, values[2].GetAs<double>());
+      row++;
+    }
+    EXPECT_EQ(num_rows, row);
+  }
+}
+
+TEST_F(SpillTests, HashAggregationTest) {
+  // SELECT d, SUM(a) FROM table GROUP BY d;
+  std::unique_ptr<storage::DataTable> table(CreateAndPopulateTable(2));
+
+  DirectMapList direct_map_list = {{0, {0, 3}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  agg_terms.emplace_back(ExpressionType::AGGREGATE_SUM,
+                         expression::ExpressionUtil::TupleValueFactory(
+                             type::TypeId::INTEGER, 0, 0));
+  std::shared_ptr<const catalog::Schema> output_schema(
+      new catalog::Schema({TestingExecutorUtil::GetColumnInfo(3),
+                           TestingExecutorUtil::GetColumnInfo(0)}));
+  planner::AggregatePlan node(std::move(proj_info), nullptr,
+                              std::move(agg_terms), {3}, output_schema,
+                              AggregateType::HASH);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  context->SetMemoryBudget(kSmallBudget);
+
+  std::unique_ptr<storage::AbstractTable> output_table(
+      storage::TableFactory::GetTempTable(
+          const_cast<catalog::Schema *>(output_schema.get()), false));
+
+  // The groups that do not fit into the budget are spilled
+  {
+    executor::HashAggregator aggregator(&node, output_table.get(),
+                                        context.get(), 4);
+    planner::SeqScanPlan scan_plan(table.get(), nullptr, {0, 1, 2, 3});
+    executor::SeqScanExecutor scan(&scan_plan, context.get());
+    EXPECT_TRUE(scan.Init());
+    while (scan.Execute()) {
+      std::unique_ptr<executor::LogicalTile> tile(scan.GetOutput());
+      for (oid_t tuple_id : *tile) {
+        expression::ContainerTuple<executor::LogicalTile> tuple(tile.get(),
+                                                                tuple_id);
+        EXPECT_TRUE(aggregator.Advance(&tuple));
+      }
+    }
+    EXPECT_TRUE(aggregator.IsSpilled());
+    EXPECT_TRUE(aggregator.Finalize());
+  }
+  EXPECT_EQ(0U, context->GetReservedMemory());
+  txn_manager.CommitTransaction(txn);
+
+  // Every group is output once, with both of its tuples. The values of 'd'
+  // are the strings of 10 * row ID + 3, the ones of 'a' are 10 * row ID.
+  std::set<std::string> groups;
+  for (oid_t tile_group_itr = 0;
+       tile_group_itr < output_table->GetTileGroupCount(); tile_group_itr++) {
+    std::unique_ptr<executor::LogicalTile> tile(
+        executor::LogicalTileFactory::WrapTileGroup(
+            output_table->GetTileGroup(tile_group_itr)));
+    for (oid_t tuple_id : *tile) {
+      std::string group = tile->GetValue(tuple_id, 0).ToString();
+      int32_t sum = tile->GetValue(tuple_id, 1).GetAs<int32_t>();
+      EXPECT_EQ(2 * (std::stoi(group) - 3), sum);
+      EXPECT_TRUE(groups.insert(group).second);
+    }
+  }
+  EXPECT_EQ(kNumRows, groups.size());
+}
+
+namespace {
+
+// Join the table with itself on column 'b' in an inner hash join with the
+// given memory budget, returning the joined values of 'b'
+std::multiset<int32_t> RunHashJoin(storage::DataTable *table, size_t budget,
+                                   bool *spilled) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  context->SetMemoryBudget(budget);
+
+  std::vector<std::unique_ptr<const expression::AbstractExpression>> hash_keys;
+  hash_keys.emplace_back(
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 1, 1));
+  planner::HashPlan hash_plan(hash_keys);
+
+  // SELECT left.b, right.b, right.a, left.a
+  DirectMapList direct_map_list = {
+      {0, {0, 1}}, {1, {1, 1}}, {2, {1, 0}}, {3, {0, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> projection(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+  std::shared_ptr<const catalog::Schema> schema(new catalog::Schema(
+      {TestingExecutorUtil::GetColumnInfo(1),
+       TestingExecutorUtil::GetColumnInfo(1),
+       TestingExecutorUtil::GetColumnInfo(0),
+       TestingExecutorUtil::GetColumnInfo(0)}));
+  planner::HashJoinPlan hash_join_plan(JoinType::INNER, nullptr,
+                                       std::move(projection), schema);
+
+  planner::SeqScanPlan left_scan_plan(table, nullptr, {0, 1, 2, 3});
+  planner::SeqScanPlan right_scan_plan(table, nullptr, {0, 1, 2, 3});
+  executor::SeqScanExecutor left_scan(&left_scan_plan, context.get());
+  executor::SeqScanExecutor right_scan(&right_scan_plan, context.get());
+  executor::HashExecutor hash_executor(&hash_plan, context.get());
+  executor::HashJoinExecutor hash_join_executor(&hash_join_plan,
+                                                context.get());
+  hash_executor.AddChild(&right_scan);
+  hash_join_executor.AddChild(&left_scan);
+  hash_join_executor.AddChild(&hash_executor);
+
+  std::multiset<int32_t> values;
+  EXPECT_TRUE(hash_join_executor.Init());
+  while (hash_join_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> tile(
+        hash_join_executor.GetOutput());
+    for (oid_t tuple_id : *tile) {
+      int32_t left_b = tile->GetValue(tuple_id, 0).GetAs<int32_t>();
+      int32_t right_b = tile->GetValue(tuple_id, 1).GetAs<int32_t>();
+      EXPECT_EQ(left_b, right_b);
+      EXPECT_EQ(tile->GetValue(tuple_id, 3).GetAs<int32_t>(),
+                tile->GetValue(tuple_id, 2).GetAs<int32_t>());
+      values.insert(left_b);
+    }
+  }
+  *spilled = hash_executor.IsSpilled();
+
+  txn_manager.CommitTransaction(txn);
+  return values;
+}
+
+}  // namespace
+
+TEST_F(SpillTests, HashJoinTest) {
+  std::unique_ptr<storage::DataTable> table(CreateAndPopulateTable(1));
+
+  bool spilled;
+  auto in_memory_values = RunHashJoin(table.get(), 0, &spilled);
+  EXPECT_FALSE(spilled);
+  EXPECT_EQ(kNumRows, in_memory_values.size());
+
+  // The partitions fit into the budget
+  auto spilled_values = RunHashJoin(table.get(), kSmallBudget, &spilled);
+  EXPECT_TRUE(spilled);
+  EXPECT_EQ(in_memory_values, spilled_values);
+
+  // No partition fits, they are partitioned again down to the deepest level
+  spilled_values = RunHashJoin(table.get(), 1, &spilled);
+  EXPECT_TRUE(spilled);
+  EXPECT_EQ(in_memory_values, spilled_values);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_delete_test.cpp
+//
+// Identification: test/executor/tile_group_delete_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "concurrency/testing_transaction_util.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/delete_executor.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "expression/comparison_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/delete_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Delete Tests
+//===--------------------------------------------------------------------===//
+
+class TileGroupDeleteTests : public PelotonTest {};
+
+namespace {
+
+// Delete the tuples that satisfy the predicate, all of them if it is null.
+// Returns the number of tuples deleted.
+size_t ExecuteDelete(concurrency::Transaction *txn, storage::DataTable *table,
+                     expression::AbstractExpression *predicate) {
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::DeletePlan delete_node(table, predicate == nullptr);
+  executor::DeleteExecutor delete_executor(&delete_node, context.get());
+
+  std::vector<oid_t> column_ids = {0};
+  std::unique_ptr<planner::SeqScanPlan> seq_scan_node(
+      new planner::SeqScanPlan(table, predicate, column_ids));
+  executor::SeqScanExecutor seq_scan_executor(seq_scan_node.get(),
+                                              context.get());
+
+  delete_node.AddChild(std::move(seq_scan_node));
+  delete_executor.AddChild(&seq_scan_executor);
+
+  EXPECT_TRUE(delete_executor.Init());
+  while (delete_executor.Execute() == true)
+    ;
+  return context->num_processed;
+}
+
+size_t CountTuples(concurrency::Transaction *txn, storage::DataTable *table) {
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  std::vector<oid_t> column_ids = {0};
+  planner::SeqScanPlan seq_scan_node(table, nullptr, column_ids);
+  executor::SeqScanExecutor seq_scan_executor(&seq_scan_node, context.get());
+
+  EXPECT_TRUE(seq_scan_executor.Init());
+  size_t tuple_count = 0;
+  while (seq_scan_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        seq_scan_executor.GetOutput());
+    tuple_count += result_tile->GetTupleCount();
+  }
+  return tuple_count;
+}
+
+// Fill three tile groups of a hundred slots: the last one is not full
+storage::DataTable *CreateFilledTable(oid_t database_oid, oid_t table_oid) {
+  auto table = TestingTransactionUtil::CreateTable(
+      0, "DELETE_TABLE", database_oid, table_oid, table_oid + 1, true);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  for (int id = 0; id < 250; id++) {
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, id, id));
+  }
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_EQ(3U, table->GetTileGroupCount());
+  return table;
+}
+
+}  // namespace
+
+TEST_F(TileGroupDeleteTests, TruncateTest) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_oid = 24201;
+  storage_manager->AddDatabaseToStorageManager(
+      new storage::Database(database_oid));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto table = CreateFilledTable(database_oid, 24202);
+
+  auto reader = txn_manager.BeginTransaction();
+
+  // the full tile groups are deleted as a whole, the others tuple by tuple
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(250U, ExecuteDelete(txn, table, nullptr));
+  EXPECT_TRUE(table->GetTileGroup(0)->GetHeader()->IsDeleting());
+  EXPECT_TRUE(table->GetTileGroup(1)->GetHeader()->IsDeleting());
+  EXPECT_FALSE(table->GetTileGroup(2)->GetHeader()->IsDeleting());
+  EXPECT_EQ(0U, CountTuples(txn, table));
+
+  // the tuples cannot be updated by others in the meantime
+  auto writer = txn_manager.BeginTransaction();
+  EXPECT_FALSE(TestingTransactionUtil::ExecuteUpdate(writer, table, 5, 5));
+  txn_manager.AbortTransaction(writer);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // the delete is only visible to the transactions that start after it
+  EXPECT_EQ(250U, CountTuples(reader, table));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(reader));
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(0U, CountTuples(txn, table));
+
+  // the keys of the deleted tuples can be inserted again
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, 5, 5));
+  EXPECT_EQ(1U, CountTuples(txn, table));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  storage_manager->RemoveDatabaseFromStorageManager(database_oid);
+}
+
+TEST_F(TileGroupDeleteTests, RangeDeleteTest) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_oid = 24203;
+  storage_manager->AddDatabaseToStorageManager(
+      new storage::Database(database_oid));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto table = CreateFilledTable(database_oid, 24204);
+
+  // only the first tile group holds ids below 150 alone
+  auto txn = txn_manager.BeginTransaction();
+  auto predicate = new expression::ComparisonExpression(
+      ExpressionType::COMPARE_LESSTHAN,
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0),
+      new expression::ConstantValueExpression(
+          type::ValueFactory::GetIntegerValue(150)));
+  EXPECT_EQ(150U, ExecuteDelete(txn, table, predicate));
+  EXPECT_TRUE(table->GetTileGroup(0)->GetHeader()->IsDeleting());
+  EXPECT_FALSE(table->GetTileGroup(1)->GetHeader()->IsDeleting());
+  EXPECT_EQ(100U, CountTuples(txn, table));
+
+  // a rolled back delete leaves the tile groups as they were
+  txn_manager.AbortTransaction(txn);
+  EXPECT_FALSE(table->GetTileGroup(0)->GetHeader()->IsDeleting());
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(250U, CountTuples(txn, table));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  storage_manager->RemoveDatabaseFromStorageManager(database_oid);
+}
+
+}  // namespace test
+}  // namespace peloton
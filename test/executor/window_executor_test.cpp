@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// window_executor_test.cpp
+//
+// Identification: test/executor/window_executor_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "executor/mock_executor.h"
+#include "executor/testing_executor_util.h"
+#include "executor/window_executor.h"
+#include "planner/window_plan.h"
+#include "storage/data_table.h"
+#include "type/value_factory.h"
+
+using ::testing::Return;
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Window Executor Tests
+//===--------------------------------------------------------------------===//
+
+class WindowExecutorTests : public PelotonTest {};
+
+namespace {
+
+// Run the window plan over ten rows. The first column is 0 for the first five
+// rows and 10 for the others, the second one is 10 * row + 1.
+std::unique_ptr<executor::LogicalTile> RunWindow(
+    const planner::WindowPlan &node, storage::DataTable *table) {
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+  executor::WindowExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(
+          executor::LogicalTileFactory::WrapTileGroup(table->GetTileGroup(0))));
+
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result(executor.GetOutput());
+  EXPECT_FALSE(executor.Execute());
+  return result;
+}
+
+std::unique_ptr<storage::DataTable> CreateGroupedTable() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(10));
+  TestingExecutorUtil::PopulateTable(table.get(), 10, false, false, true, txn);
+  txn_manager.CommitTransaction(txn);
+  return table;
+}
+
+}  // namespace
+
+TEST_F(WindowExecutorTests, PartitionTest) {
+  auto table = CreateGroupedTable();
+
+  std::vector<planner::WindowTerm> terms = {
+      planner::WindowTerm(planner::WindowFunctionType::ROW_NUMBER),
+      planner::WindowTerm(planner::WindowFunctionType::SUM, 1),
+      planner::WindowTerm(planner::WindowFunctionType::AVG, 1),
+      planner::WindowTerm(planner::WindowFunctionType::MIN, 1, 1, 1),
+      planner::WindowTerm(planner::WindowFunctionType::MAX, 1, 1, 1),
+      planner::WindowTerm(planner::WindowFunctionType::COUNT, INVALID_OID,
+                          planner::WindowTerm::UNBOUNDED,
+                          planner::WindowTerm::UNBOUNDED)};
+  planner::WindowPlan node({0}, {1}, terms);
+
+  auto result = RunWindow(node, table.get());
+  ASSERT_EQ(10U, result->GetTupleCount());
+  EXPECT_EQ(10U, result->GetColumnCount());
+
+  // the input columns come first
+  EXPECT_EQ(0, result->GetValue(4, 0).GetAs<int32_t>());
+  EXPECT_EQ(10, result->GetValue(5, 0).GetAs<int32_t>());
+
+  std::vector<int64_t> row_numbers = {1, 2, 3, 4, 5, 1, 2, 3, 4, 5};
+  std::vector<int64_t> sums = {1, 12, 33, 64, 105, 51, 112, 183, 264, 355};
+  std::vector<int32_t> mins = {1, 1, 11, 21, 31, 51, 51, 61, 71, 81};
+  std::vector<int32_t> maxs = {11, 21, 31, 41, 41, 61, 71, 81, 91, 91};
+  for (oid_t row = 0; row < 10; row++) {
+    EXPECT_EQ(row_numbers[row], result->GetValue(row, 4).GetAs<int64_t>());
+    EXPECT_EQ(sums[row], result->GetValue(row, 5).GetAs<int64_t>());
+    EXPECT_EQ(mins[row], result->GetValue(row, 7).GetAs<int32_t>());
+    EXPECT_EQ(maxs[row], result->GetValue(row, 8).GetAs<int32_t>());
+    EXPECT_EQ(5, result->GetValue(row, 9).GetAs<int64_t>());
+  }
+  EXPECT_EQ(51.0, result->GetValue(5, 6).GetAs<double>());
+  EXPECT_EQ(56.0, result->GetValue(6, 6).GetAs<double>());
+}
+
+TEST_F(WindowExecutorTests, RankTest) {
+  auto table = CreateGroupedTable();
+
+  // without partitions, the rows with the same first column are peers
+  std::vector<planner::WindowTerm> terms = {
+      planner::WindowTerm(planner::WindowFunctionType::RANK),
+      planner::WindowTerm(planner::WindowFunctionType::DENSE_RANK),
+      planner::WindowTerm(planner::WindowFunctionType::ROW_NUMBER)};
+  planner::WindowPlan node({}, {0}, terms);
+
+  auto result = RunWindow(node, table.get());
+  ASSERT_EQ(10U, result->GetTupleCount());
+  for (oid_t row = 0; row < 10; row++) {
+    EXPECT_EQ(row < 5 ? 1 : 6, result->GetValue(row, 4).GetAs<int64_t>());
+    EXPECT_EQ(row < 5 ? 1 : 2, result->GetValue(row, 5).GetAs<int64_t>());
+    EXPECT_EQ(static_cast<int64_t>(row + 1),
+              result->GetValue(row, 6).GetAs<int64_t>());
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// conjunction_order_test.cpp
+//
+// Identification: test/expression/conjunction_order_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "expression/conjunction_order.h"
+#include "expression/expression_util.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class ConjunctionOrderTests : public PelotonTest {};
+
+namespace {
+
+using expression::ConjunctionOrder;
+using expression::ExpressionUtil;
+
+expression::AbstractExpression *ColumnEquals(int column_id, int32_t value) {
+  return ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_EQUAL,
+      ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0, column_id),
+      ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(value)));
+}
+
+expression::AbstractExpression *And(expression::AbstractExpression *left,
+                                    expression::AbstractExpression *right) {
+  return ExpressionUtil::ConjunctionFactory(ExpressionType::CONJUNCTION_AND,
+                                            left, right);
+}
+
+// Evaluate the terms of the order on the tuples, where every term decides the
+// result of the given share of the tuples it sees
+void Sample(ConjunctionOrder &order, const std::vector<double> &decided) {
+  while (order.IsSampling()) {
+    uint64_t current = order.GetOrder();
+    uint64_t num_tuples = 1024;
+    for (uint32_t pos = 0; pos < order.GetTermCount() && num_tuples > 0;
+         pos++) {
+      uint32_t term = ConjunctionOrder::GetTerm(current, pos);
+      uint64_t num_decided = num_tuples * decided[term];
+      order.Record(term, num_tuples, num_decided);
+      num_tuples -= num_decided;
+    }
+  }
+}
+
+}  // namespace
+
+TEST_F(ConjunctionOrderTests, CollectTermsTest) {
+  // (a = 1 AND b = 2) AND (c = 3 OR d = 4)
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      And(And(ColumnEquals(0, 1), ColumnEquals(1, 2)),
+          ExpressionUtil::ConjunctionFactory(ExpressionType::CONJUNCTION_OR,
+                                             ColumnEquals(2, 3),
+                                             ColumnEquals(3, 4))));
+  std::vector<const expression::AbstractExpression *> terms;
+  ConjunctionOrder::CollectTerms(predicate.get(), terms);
+  ASSERT_EQ(3U, terms.size());
+  EXPECT_EQ(predicate->GetChild(0)->GetChild(0), terms[0]);
+  EXPECT_EQ(predicate->GetChild(0)->GetChild(1), terms[1]);
+  EXPECT_EQ(predicate->GetChild(1), terms[2]);
+
+  EXPECT_TRUE(ConjunctionOrder::IsReorderable(predicate.get()));
+  EXPECT_FALSE(ConjunctionOrder::IsReorderable(predicate.get(), 2));
+  EXPECT_FALSE(
+      ConjunctionOrder::IsReorderable(predicate->GetChild(0)->GetChild(0)));
+
+  // The terms start out in the order of the query
+  ConjunctionOrder order(predicate.get());
+  EXPECT_EQ(3U, order.GetTermCount());
+  EXPECT_TRUE(order.IsSampling());
+  for (uint32_t pos = 0; pos < 3; pos++) {
+    EXPECT_EQ(pos, ConjunctionOrder::GetTerm(order.GetOrder(), pos));
+  }
+}
+
+TEST_F(ConjunctionOrderTests, ReorderTest) {
+  // a = 1 AND b = 2 AND c = 3, where the last term is the most selective
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      And(And(ColumnEquals(0, 1), ColumnEquals(1, 2)), ColumnEquals(2, 3)));
+  ConjunctionOrder order(predicate.get());
+  Sample(order, {0.1, 0.5, 0.99});
+
+  uint64_t reordered = order.GetOrder();
+  EXPECT_EQ(2U, ConjunctionOrder::GetTerm(reordered, 0));
+  EXPECT_EQ(1U, ConjunctionOrder::GetTerm(reordered, 1));
+  EXPECT_EQ(0U, ConjunctionOrder::GetTerm(reordered, 2));
+
+  // The order does not change anymore
+  order.Record(0, 100000, 100000);
+  EXPECT_EQ(reordered, order.GetOrder());
+}
+
+TEST_F(ConjunctionOrderTests, FailingTermTest) {
+  // a / b = 1 AND c = 3, where the division can fail and stays last however
+  // selective it is
+  auto *divide = ExpressionUtil::OperatorFactory(
+      ExpressionType::OPERATOR_DIVIDE, type::TypeId::INTEGER,
+      ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0, 0),
+      ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0, 1));
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      And(ExpressionUtil::ComparisonFactory(
+              ExpressionType::COMPARE_EQUAL, divide,
+              ExpressionUtil::ConstantValueFactory(
+                  type::ValueFactory::GetIntegerValue(1))),
+          ColumnEquals(2, 3)));
+  ConjunctionOrder order(predicate.get());
+  Sample(order, {0.99, 0.1});
+
+  EXPECT_EQ(1U, ConjunctionOrder::GetTerm(order.GetOrder(), 0));
+  EXPECT_EQ(0U, ConjunctionOrder::GetTerm(order.GetOrder(), 1));
+}
+
+}  // namespace test
+}  // namespace peloton
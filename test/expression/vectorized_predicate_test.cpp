@@ -0,0 +1,221 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// vectorized_predicate_test.cpp
+//
+// Identification: test/expression/vectorized_predicate_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "executor/testing_executor_util.h"
+#include "common/harness.h"
+
+#include "common/container_tuple.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "expression/expression_util.h"
+#include "expression/vectorized_predicate.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class VectorizedPredicateTests : public PelotonTest {};
+
+namespace {
+
+const size_t kNumRows = 50;
+
+using expression::ExpressionUtil;
+
+expression::AbstractExpression *Column(type::TypeId type_id, int column_id) {
+  return ExpressionUtil::TupleValueFactory(type_id, 0, column_id);
+}
+
+expression::AbstractExpression *Constant(const type::Value &value) {
+  return ExpressionUtil::ConstantValueFactory(value);
+}
+
+expression::AbstractExpression *Compare(ExpressionType type,
+                                        expression::AbstractExpression *left,
+                                        expression::AbstractExpression *right) {
+  return ExpressionUtil::ComparisonFactory(type, left, right);
+}
+
+type::CmpBool ToCmpBool(const type::Value &value) {
+  if (value.IsNull()) {
+    return type::CMP_NULL;
+  }
+  return value.IsTrue() ? type::CMP_TRUE : type::CMP_FALSE;
+}
+
+// Check the results of the vectorized predicate against the ones of the
+// expression, one tuple at a time
+void CheckPredicate(const std::shared_ptr<storage::TileGroup> &tile_group,
+                    expression::AbstractExpression *expr, bool vectorized) {
+  std::unique_ptr<expression::AbstractExpression> predicate(expr);
+  expression::VectorizedPredicate vectorized_predicate(predicate.get());
+  EXPECT_EQ(vectorized, vectorized_predicate.IsVectorized());
+
+  // Every other tuple of the tile group
+  std::vector<oid_t> tuple_ids;
+  for (oid_t tuple_id = 0; tuple_id < kNumRows; tuple_id += 2) {
+    tuple_ids.push_back(tuple_id);
+  }
+
+  std::vector<type::CmpBool> results;
+  vectorized_predicate.Evaluate(tile_group.get(), tuple_ids.data(),
+                                tuple_ids.size(), nullptr, nullptr, results);
+  ASSERT_EQ(tuple_ids.size(), results.size());
+  for (size_t idx = 0; idx < tuple_ids.size(); idx++) {
+    expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                         tuple_ids[idx]);
+    EXPECT_EQ(ToCmpBool(predicate->Evaluate(&tuple, nullptr, nullptr)),
+              results[idx]);
+  }
+
+  // The same tuples of a logical tile over the tile group
+  std::unique_ptr<executor::LogicalTile> tile(
+      executor::LogicalTileFactory::WrapTileGroup(tile_group));
+  std::vector<type::CmpBool> tile_results;
+  vectorized_predicate.Evaluate(tile.get(), tuple_ids.data(), tuple_ids.size(),
+                                nullptr, nullptr, tile_results);
+  EXPECT_EQ(results, tile_results);
+}
+
+}  // namespace
+
+TEST_F(VectorizedPredicateTests, CompareWithTupleAtATimeTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(kNumRows, false));
+  TestingExecutorUtil::PopulateTable(table.get(), kNumRows, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+  auto tile_group = table->GetTileGroup(0);
+
+  // The columns are a INTEGER, b INTEGER, c DECIMAL and d VARCHAR, with the
+  // values 10 * row ID plus the column ID
+  auto a = [] { return Column(type::TypeId::INTEGER, 0); };
+  auto b = [] { return Column(type::TypeId::INTEGER, 1); };
+  auto c = [] { return Column(type::TypeId::DECIMAL, 2); };
+  auto d = [] { return Column(type::TypeId::VARCHAR, 3); };
+  auto integer = [](int32_t value) {
+    return Constant(type::ValueFactory::GetIntegerValue(value));
+  };
+
+  // a > 200
+  CheckPredicate(
+      tile_group,
+      Compare(ExpressionType::COMPARE_GREATERTHAN, a(), integer(200)), true);
+
+  // 300.5 >= c
+  CheckPredicate(
+      tile_group,
+      Compare(ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+              Constant(type::ValueFactory::GetDecimalValue(300.5)), c()),
+      true);
+
+  // a < c, compared as decimals
+  CheckPredicate(tile_group,
+                 Compare(ExpressionType::COMPARE_LESSTHAN, a(), c()), true);
+
+  // a >= 100 AND b <> 201
+  CheckPredicate(
+      tile_group,
+      ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_AND,
+          Compare(ExpressionType::COMPARE_GREATERTHANOREQUALTO, a(),
+                  integer(100)),
+          Compare(ExpressionType::COMPARE_NOTEQUAL, b(), integer(201))),
+      true);
+
+  // a < 50 OR d = '333', the strings are compared one tuple at a time
+  CheckPredicate(
+      tile_group,
+      ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_OR,
+          Compare(ExpressionType::COMPARE_LESSTHAN, a(), integer(50)),
+          Compare(ExpressionType::COMPARE_EQUAL, d(),
+                  Constant(type::ValueFactory::GetVarcharValue("333")))),
+      true);
+  CheckPredicate(tile_group,
+                 Compare(ExpressionType::COMPARE_EQUAL, d(),
+                         Constant(type::ValueFactory::GetVarcharValue("333"))),
+                 false);
+
+  // (a > 100 AND b = NULL) OR c <= 50, where the conjunction is NULL or FALSE
+  CheckPredicate(
+      tile_group,
+      ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_OR,
+          ExpressionUtil::ConjunctionFactory(
+              ExpressionType::CONJUNCTION_AND,
+              Compare(ExpressionType::COMPARE_GREATERTHAN, a(), integer(100)),
+              Compare(ExpressionType::COMPARE_EQUAL, b(),
+                      Constant(type::ValueFactory::GetNullValueByType(
+                          type::TypeId::INTEGER)))),
+          Compare(ExpressionType::COMPARE_LESSTHANOREQUALTO, c(),
+                  integer(50))),
+      true);
+}
+
+TEST_F(VectorizedPredicateTests, ReorderedConjunctionTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(kNumRows, false));
+  TestingExecutorUtil::PopulateTable(table.get(), kNumRows, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+  auto tile_group = table->GetTileGroup(0);
+
+  // a >= 0 AND d <> '333' AND b < 101, where the last term is the most
+  // selective and the string comparison the most expensive one
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_AND,
+          ExpressionUtil::ConjunctionFactory(
+              ExpressionType::CONJUNCTION_AND,
+              Compare(ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+                      Column(type::TypeId::INTEGER, 0),
+                      Constant(type::ValueFactory::GetIntegerValue(0))),
+              Compare(ExpressionType::COMPARE_NOTEQUAL,
+                      Column(type::TypeId::VARCHAR, 3),
+                      Constant(type::ValueFactory::GetVarcharValue("333")))),
+          Compare(ExpressionType::COMPARE_LESSTHAN,
+                  Column(type::TypeId::INTEGER, 1),
+                  Constant(type::ValueFactory::GetIntegerValue(101)))));
+  expression::VectorizedPredicate vectorized_predicate(predicate.get());
+
+  std::vector<oid_t> tuple_ids;
+  std::vector<type::CmpBool> expected;
+  for (oid_t tuple_id = 0; tuple_id < kNumRows; tuple_id++) {
+    tuple_ids.push_back(tuple_id);
+    expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                         tuple_id);
+    expected.push_back(
+        ToCmpBool(predicate->Evaluate(&tuple, nullptr, nullptr)));
+  }
+
+  // The results are the same before and after the terms are reordered
+  for (int batch = 0; batch < 200; batch++) {
+    std::vector<type::CmpBool> results;
+    vectorized_predicate.Evaluate(tile_group.get(), tuple_ids.data(),
+                                  tuple_ids.size(), nullptr, nullptr, results);
+    EXPECT_EQ(expected, results);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
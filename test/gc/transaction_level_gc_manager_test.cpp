@@ -199,6 +199,107 @@ TEST_F(TransactionLevelGCManagerTests, GCTest) {
 
 }
 
+TEST_F(TransactionLevelGCManagerTests, ReclaimIndirectionTest) {
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE");
+  oid_t db_id = database->GetOid();
+
+  // create a table with only one key
+  const int num_key = 1;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TABLE", db_id, INVALID_OID, 1234, true));
+  auto index = table->GetIndex(0);
+
+  ItemPointer *indirection =
+      table->GetTileGroup(0)->GetHeader()->GetIndirection(0);
+  EXPECT_EQ(1U, storage::IndirectionArray::GetIndexEntryCount(indirection));
+
+  const int delete_num = 1;
+  DeleteTuple(table.get(), delete_num, num_key);
+
+  // unlinking the deleted tuple removes its index entry
+  epoch_manager.SetCurrentEpochId(2);
+  gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId());
+  EXPECT_EQ(1, gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId()));
+
+  EXPECT_EQ(0U, storage::IndirectionArray::GetIndexEntryCount(indirection));
+  std::vector<ItemPointer *> index_entries;
+  index->ScanAllKeys(index_entries);
+  EXPECT_EQ(0U, index_entries.size());
+
+  // the indirection is reused once the garbage is recycled
+  epoch_manager.SetCurrentEpochId(3);
+  EXPECT_EQ(1, gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId()));
+
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table.get(), 1, 0));
+  txn_manager.CommitTransaction(txn);
+
+  index->ScanAllKeys(index_entries);
+  EXPECT_EQ(1U, index_entries.size());
+  EXPECT_EQ(indirection, index_entries[0]);
+  EXPECT_EQ(1U, storage::IndirectionArray::GetIndexEntryCount(indirection));
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("DATABASE");
+  EXPECT_FALSE(storage_manager->HasDatabase(db_id));
+}
+
+TEST_F(TransactionLevelGCManagerTests, BatchedIndexCleanupTest) {
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  gc::GCManagerFactory::Configure(1);
+  auto &gc_manager = gc::TransactionLevelGCManager::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  auto storage_manager = storage::StorageManager::GetInstance();
+  auto database = TestingExecutorUtil::InitializeDatabase("DATABASE");
+  oid_t db_id = database->GetOid();
+
+  const int num_key = 10;
+  std::unique_ptr<storage::DataTable> table(
+    TestingTransactionUtil::CreateTable(num_key, "TABLE", db_id, INVALID_OID, 1234, true));
+  auto index = table->GetIndex(0);
+
+  // delete the tuples in reverse key order, one transaction each
+  for (int key = num_key - 1; key >= 0; key--) {
+    auto txn = txn_manager.BeginTransaction();
+    EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table.get(), key));
+    EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  }
+
+  // the index entries of all the transactions are deleted in one batch
+  epoch_manager.SetCurrentEpochId(2);
+  gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId());
+  EXPECT_EQ(num_key, gc_manager.Unlink(0, epoch_manager.GetExpiredEpochId()));
+
+  std::vector<ItemPointer *> index_entries;
+  index->ScanAllKeys(index_entries);
+  EXPECT_EQ(0U, index_entries.size());
+
+  // and the garbage shares one bucket of the reclaim queue
+  epoch_manager.SetCurrentEpochId(3);
+  EXPECT_EQ(num_key, gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId()));
+  EXPECT_EQ(0, gc_manager.Reclaim(0, epoch_manager.GetExpiredEpochId()));
+
+  table.release();
+
+  // DROP!
+  TestingExecutorUtil::DeleteDatabase("DATABASE");
+  EXPECT_FALSE(storage_manager->HasDatabase(db_id));
+}
 
 }  // End test namespace
 }  // End peloton namespace
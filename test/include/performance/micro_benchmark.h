@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// micro_benchmark.h
+//
+// Identification: test/include/performance/micro_benchmark.h
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/logger.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Micro Benchmark
+//===--------------------------------------------------------------------===//
+
+/**
+ * Runs a benchmark body on a sweep of thread counts and writes the results
+ * as JSON.
+ *
+ * Every thread count runs once to warm up and then the given number of
+ * repetitions. The threads are released together and the repetition is
+ * timed until the last one is done. The setup and teardown of a repetition
+ * are not timed. Bodies draw their inputs from generators seeded by the
+ * thread id, so the runs are repeatable.
+ *
+ * The environment sets the sweep and the output:
+ *   PELOTON_BENCHMARK_MAX_THREADS  largest thread count, the sweep doubles
+ *                                  from 1 (default: hardware threads)
+ *   PELOTON_BENCHMARK_REPETITIONS  timed runs per thread count (default: 5)
+ *   PELOTON_BENCHMARK_OUT          JSON file (default: micro_benchmark.json)
+ */
+class MicroBenchmark {
+ public:
+  // Runs the operations of one thread
+  typedef std::function<void(size_t thread_id, size_t thread_count)>
+      ThreadBody;
+
+  // Prepares or cleans up a repetition with the thread count
+  typedef std::function<void(size_t thread_count)> RunHook;
+
+  struct Result {
+    std::string name;
+    size_t thread_count;
+
+    // Operations of all threads in one repetition
+    size_t operation_count;
+
+    // Nanoseconds per operation, over the repetitions
+    double median_ns;
+    double min_ns;
+    double max_ns;
+    double stddev_ns;
+
+    // Operations per second of the median repetition
+    double throughput;
+  };
+
+  static MicroBenchmark &GetInstance() {
+    static MicroBenchmark micro_benchmark;
+    return micro_benchmark;
+  }
+
+  // Run the body on every thread count of the sweep, each thread doing the
+  // given number of operations
+  void Run(const std::string &name, size_t operations_per_thread,
+           const ThreadBody &body, const RunHook &setup = nullptr,
+           const RunHook &teardown = nullptr) {
+    for (auto thread_count : GetThreadCounts()) {
+      std::vector<double> run_ns;
+      for (size_t run_itr = 0; run_itr <= repetitions_; run_itr++) {
+        if (setup) {
+          setup(thread_count);
+        }
+        double elapsed_ns = RunThreads(body, thread_count);
+        if (teardown) {
+          teardown(thread_count);
+        }
+
+        // The first run warms up
+        if (run_itr > 0) {
+          run_ns.push_back(elapsed_ns /
+                           (operations_per_thread * thread_count));
+        }
+      }
+      AddResult(name, thread_count, operations_per_thread * thread_count,
+                run_ns);
+    }
+  }
+
+  // 1, 2, 4, ... up to the largest thread count
+  std::vector<size_t> GetThreadCounts() const {
+    std::vector<size_t> thread_counts;
+    for (size_t thread_count = 1; thread_count < max_threads_;
+         thread_count *= 2) {
+      thread_counts.push_back(thread_count);
+    }
+    thread_counts.push_back(max_threads_);
+    return thread_counts;
+  }
+
+  const std::vector<Result> &GetResults() const { return results_; }
+
+  // Write the results of all benchmarks that ran
+  void WriteJson() const {
+    std::ofstream out(output_path_);
+    out << "{\n  \"context\": {\"max_threads\": " << max_threads_
+        << ", \"repetitions\": " << repetitions_ << "},\n"
+        << "  \"benchmarks\": [";
+    for (size_t result_itr = 0; result_itr < results_.size(); result_itr++) {
+      auto &result = results_[result_itr];
+      out << (result_itr == 0 ? "\n" : ",\n") << "    {\"name\": \""
+          << result.name << "\", \"threads\": " << result.thread_count
+          << ", \"operations\": " << result.operation_count
+          << ", \"median_ns_per_op\": " << result.median_ns
+          << ", \"min_ns_per_op\": " << result.min_ns
+          << ", \"max_ns_per_op\": " << result.max_ns
+          << ", \"stddev_ns_per_op\": " << result.stddev_ns
+          << ", \"ops_per_second\": " << result.throughput << "}";
+    }
+    out << "\n  ]\n}\n";
+    LOG_INFO("Wrote %lu benchmark results to %s", results_.size(),
+             output_path_.c_str());
+  }
+
+ private:
+  MicroBenchmark()
+      : max_threads_(GetEnv("PELOTON_BENCHMARK_MAX_THREADS",
+                            std::max(std::thread::hardware_concurrency(),
+                                     1u))),
+        repetitions_(GetEnv("PELOTON_BENCHMARK_REPETITIONS", 5)) {
+    const char *output_path = std::getenv("PELOTON_BENCHMARK_OUT");
+    output_path_ =
+        output_path != nullptr ? output_path : "micro_benchmark.json";
+    max_threads_ = std::max<size_t>(max_threads_, 1);
+    repetitions_ = std::max<size_t>(repetitions_, 1);
+  }
+
+  static size_t GetEnv(const char *name, size_t default_value) {
+    const char *value = std::getenv(name);
+    return value != nullptr ? std::strtoull(value, nullptr, 10)
+                            : default_value;
+  }
+
+  // Nanoseconds from releasing the threads until the last one is done
+  static double RunThreads(const ThreadBody &body, size_t thread_count) {
+    std::atomic<size_t> ready_count(0);
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+      threads.emplace_back([&, thread_id]() {
+        ready_count++;
+        while (start.load() == false) {
+          std::this_thread::yield();
+        }
+        body(thread_id, thread_count);
+      });
+    }
+    while (ready_count.load() < thread_count) {
+      std::this_thread::yield();
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count();
+  }
+
+  void AddResult(const std::string &name, size_t thread_count,
+                 size_t operation_count, std::vector<double> run_ns) {
+    std::sort(run_ns.begin(), run_ns.end());
+    double mean_ns = 0;
+    for (auto ns : run_ns) {
+      mean_ns += ns / run_ns.size();
+    }
+    double variance = 0;
+    for (auto ns : run_ns) {
+      variance += (ns - mean_ns) * (ns - mean_ns) / run_ns.size();
+    }
+
+    Result result;
+    result.name = name;
+    result.thread_count = thread_count;
+    result.operation_count = operation_count;
+    result.median_ns = run_ns[run_ns.size() / 2];
+    result.min_ns = run_ns.front();
+    result.max_ns = run_ns.back();
+    result.stddev_ns = std::sqrt(variance);
+    result.throughput = result.median_ns > 0 ? 1e9 / result.median_ns : 0;
+    results_.push_back(result);
+
+    LOG_INFO("%-40s %3lu threads: %10.1f ns/op (+/- %.1f)", name.c_str(),
+             thread_count, result.median_ns, result.stddev_ns);
+  }
+
+ private:
+  size_t max_threads_;
+
+  size_t repetitions_;
+
+  std::string output_path_;
+
+  std::vector<Result> results_;
+};
+
+}  // End test namespace
+}  // End peloton namespace
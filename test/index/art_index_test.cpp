@@ -0,0 +1,245 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// art_index_test.cpp
+//
+// Identification: test/index/art_index_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "gtest/gtest.h"
+
+#include "common/item_pointer.h"
+#include "common/logger.h"
+#include "index/index_factory.h"
+#include "index/scan_optimizer.h"
+#include "storage/tuple.h"
+#include "type/types.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// ART Index Tests
+//===--------------------------------------------------------------------===//
+
+class ARTIndexTests : public PelotonTest {};
+
+// The ART takes integer keys only, so the tests of TestingIndexUtil and
+// their varchar column do not apply
+static index::Index *BuildARTIndex(bool unique_keys) {
+  std::vector<catalog::Column> column_list = {
+      catalog::Column(type::TypeId::BIGINT,
+                      type::Type::GetTypeSize(type::TypeId::BIGINT), "A",
+                      true),
+      catalog::Column(type::TypeId::INTEGER,
+                      type::Type::GetTypeSize(type::TypeId::INTEGER), "B",
+                      true)};
+  std::vector<oid_t> key_attrs = {0, 1};
+
+  catalog::Schema *key_schema = new catalog::Schema(column_list);
+  key_schema->SetIndexedColumns(key_attrs);
+  catalog::Schema *tuple_schema = new catalog::Schema(column_list);
+
+  index::IndexMetadata *index_metadata = new index::IndexMetadata(
+      "art_index", 125, INVALID_OID, INVALID_OID, IndexType::ART,
+      IndexConstraintType::DEFAULT, tuple_schema, key_schema, key_attrs,
+      unique_keys);
+
+  return index::IndexFactory::GetIndex(index_metadata);
+}
+
+static std::unique_ptr<storage::Tuple> MakeKey(index::Index *index,
+                                               int64_t a, int32_t b) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::unique_ptr<storage::Tuple> key(
+      new storage::Tuple(index->GetKeySchema(), true));
+  key->SetValue(0, type::ValueFactory::GetBigIntValue(a), pool);
+  key->SetValue(1, type::ValueFactory::GetIntegerValue(b), pool);
+  return key;
+}
+
+TEST_F(ARTIndexTests, BasicTest) {
+  std::unique_ptr<index::Index> index(BuildARTIndex(false));
+  EXPECT_EQ("ART", index->GetTypeName());
+
+  ItemPointer item0(120, 5);
+  ItemPointer item1(120, 7);
+  auto key0 = MakeKey(index.get(), 100, 1);
+  auto key1 = MakeKey(index.get(), 100, 2);
+
+  EXPECT_TRUE(index->InsertEntry(key0.get(), &item0));
+  EXPECT_TRUE(index->InsertEntry(key0.get(), &item1));
+  EXPECT_FALSE(index->InsertEntry(key0.get(), &item1));
+  EXPECT_TRUE(index->InsertEntry(key1.get(), &item0));
+
+  std::vector<ItemPointer *> location_ptrs;
+  index->ScanKey(key0.get(), location_ptrs);
+  EXPECT_EQ(2, location_ptrs.size());
+  location_ptrs.clear();
+
+  EXPECT_TRUE(index->DeleteEntry(key0.get(), &item0));
+  EXPECT_FALSE(index->DeleteEntry(key0.get(), &item0));
+  index->ScanKey(key0.get(), location_ptrs);
+  EXPECT_EQ(1, location_ptrs.size());
+  EXPECT_EQ(&item1, location_ptrs[0]);
+  location_ptrs.clear();
+
+  EXPECT_TRUE(index->DeleteEntry(key0.get(), &item1));
+  index->ScanKey(key0.get(), location_ptrs);
+  EXPECT_EQ(0, location_ptrs.size());
+
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(1, location_ptrs.size());
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
+TEST_F(ARTIndexTests, UniqueKeyTest) {
+  std::unique_ptr<index::Index> index(BuildARTIndex(true));
+
+  ItemPointer item0(120, 5);
+  ItemPointer item1(120, 7);
+  auto key0 = MakeKey(index.get(), -7, 3);
+
+  EXPECT_TRUE(index->InsertEntry(key0.get(), &item0));
+  EXPECT_FALSE(index->InsertEntry(key0.get(), &item1));
+
+  // The predicate decides for the versions of a key
+  EXPECT_FALSE(index->CondInsertEntry(
+      key0.get(), &item1,
+      [&item0](const void *value) { return value == &item0; }));
+  EXPECT_TRUE(index->CondInsertEntry(
+      key0.get(), &item1, [](const void *) { return false; }));
+
+  std::vector<ItemPointer *> location_ptrs;
+  index->ScanKey(key0.get(), location_ptrs);
+  EXPECT_EQ(2, location_ptrs.size());
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
+TEST_F(ARTIndexTests, ScanTest) {
+  std::unique_ptr<index::Index> index(BuildARTIndex(false));
+
+  // Negative keys come first, as the sign bit of the key bytes is flipped
+  const int64_t key_count = 2000;
+  std::vector<ItemPointer> items;
+  for (int64_t i = 0; i < key_count; i++) {
+    items.emplace_back(i, i);
+  }
+  for (int64_t i = 0; i < key_count; i++) {
+    int64_t a = (i * 7919) % key_count - key_count / 2;
+    auto key = MakeKey(index.get(), a, 0);
+    EXPECT_TRUE(index->InsertEntry(key.get(), &items[a + key_count / 2]));
+  }
+
+  std::vector<ItemPointer *> location_ptrs;
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(key_count, location_ptrs.size());
+  for (int64_t i = 0; i < key_count; i++) {
+    EXPECT_EQ(&items[i], location_ptrs[i]);
+  }
+  location_ptrs.clear();
+
+  // -100 <= A <= 100
+  std::vector<type::Value> value_list = {
+      type::ValueFactory::GetBigIntValue(-100).Copy(),
+      type::ValueFactory::GetBigIntValue(100).Copy()};
+  std::vector<oid_t> tuple_column_id_list = {0, 0};
+  std::vector<ExpressionType> expr_list = {
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+      ExpressionType::COMPARE_LESSTHANOREQUALTO};
+
+  index::IndexScanPredicate isp{};
+  isp.AddConjunctionScanPredicate(index.get(), value_list,
+                                  tuple_column_id_list, expr_list);
+  const index::ConjunctionScanPredicate *csp_p =
+      &isp.GetConjunctionList()[0];
+
+  index->Scan(value_list, tuple_column_id_list, expr_list,
+              ScanDirectionType::FORWARD, location_ptrs, csp_p);
+  EXPECT_EQ(201, location_ptrs.size());
+  for (size_t i = 0; i < location_ptrs.size(); i++) {
+    EXPECT_EQ(&items[key_count / 2 - 100 + i], location_ptrs[i]);
+  }
+  location_ptrs.clear();
+
+  index->ScanLimit(value_list, tuple_column_id_list, expr_list,
+                   ScanDirectionType::FORWARD, location_ptrs, csp_p, 10, 5);
+  EXPECT_EQ(10, location_ptrs.size());
+  EXPECT_EQ(&items[key_count / 2 - 95], location_ptrs[0]);
+  location_ptrs.clear();
+
+  index->ScanLimit(value_list, tuple_column_id_list, expr_list,
+                   ScanDirectionType::BACKWARD, location_ptrs, csp_p, 10, 5);
+  EXPECT_EQ(10, location_ptrs.size());
+  EXPECT_EQ(&items[key_count / 2 + 95], location_ptrs[0]);
+  EXPECT_EQ(&items[key_count / 2 + 86], location_ptrs[9]);
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
+static void InsertDeleteHelper(index::Index *index, size_t scale_factor,
+                               std::vector<ItemPointer> *items,
+                               uint64_t thread_itr) {
+  // Every thread has its own keys, and deletes every other one of them
+  for (size_t i = 0; i < scale_factor; i++) {
+    int64_t a = static_cast<int64_t>(i * 4 + thread_itr);
+    auto key = MakeKey(index, a, static_cast<int32_t>(a % 3));
+    EXPECT_TRUE(index->InsertEntry(key.get(), &(*items)[a]));
+    if (i % 2 == 1) {
+      EXPECT_TRUE(index->DeleteEntry(key.get(), &(*items)[a]));
+    }
+  }
+}
+
+TEST_F(ARTIndexTests, MultiThreadedTest) {
+  std::unique_ptr<index::Index> index(BuildARTIndex(false));
+
+  const size_t num_threads = 4;
+  const size_t scale_factor = 5000;
+  std::vector<ItemPointer> items(num_threads * scale_factor);
+
+  LaunchParallelTest(num_threads, InsertDeleteHelper, index.get(),
+                     scale_factor, &items);
+
+  std::vector<ItemPointer *> location_ptrs;
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(num_threads * scale_factor / 2, location_ptrs.size());
+  for (size_t i = 0; i < location_ptrs.size(); i++) {
+    size_t a = (i / num_threads) * num_threads * 2 + i % num_threads;
+    EXPECT_EQ(&items[a], location_ptrs[i]);
+  }
+
+  index->PerformGC();
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
+TEST_F(ARTIndexTests, NonIntegerKeyTest) {
+  std::vector<catalog::Column> column_list = {
+      catalog::Column(type::TypeId::VARCHAR, 32, "A", false)};
+  std::vector<oid_t> key_attrs = {0};
+
+  catalog::Schema *key_schema = new catalog::Schema(column_list);
+  key_schema->SetIndexedColumns(key_attrs);
+  std::unique_ptr<catalog::Schema> tuple_schema(
+      new catalog::Schema(column_list));
+
+  std::unique_ptr<index::IndexMetadata> index_metadata(
+      new index::IndexMetadata("art_index", 125, INVALID_OID, INVALID_OID,
+                               IndexType::ART, IndexConstraintType::DEFAULT,
+                               tuple_schema.get(), key_schema, key_attrs,
+                               false));
+
+  EXPECT_THROW(index::IndexFactory::GetIndex(index_metadata.get()),
+               IndexException);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -16,6 +16,16 @@
 #include "index/testing_index_util.h"
 #include "index/testing_index_util.h"
 
+#include "catalog/schema.h"
+#include "index/bwtree.h"
+#include "index/bwtree_index.h"
+#include "index/generic_key.h"
+#include "index/index.h"
+#include "index/index_factory.h"
+#include "index/scan_optimizer.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
 namespace peloton {
 namespace test {
 
@@ -65,5 +75,283 @@ TEST_F(BwTreeIndexTests, NonUniqueKeyMultiThreadedStressTest2) {
   TestingIndexUtil::NonUniqueKeyMultiThreadedStressTest2(IndexType::BWTREE);
 }
 
+TEST_F(BwTreeIndexTests, ScanKeysTest) {
+  TestingIndexUtil::ScanKeysTest(IndexType::BWTREE);
+}
+
+TEST_F(BwTreeIndexTests, BulkLoadTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<ItemPointer *> location_ptrs;
+
+  std::unique_ptr<index::Index> index(
+      TestingIndexUtil::BuildIndex(IndexType::BWTREE, false));
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // 100 keys with 100 locations each, in reverse key order
+  const size_t key_count = 100;
+  const size_t value_count = 100;
+  std::vector<ItemPointer> locations(key_count * value_count);
+  std::vector<std::pair<std::unique_ptr<storage::Tuple>, ItemPointer *>>
+      entries;
+  for (size_t entry_itr = 0; entry_itr < locations.size(); entry_itr++) {
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(static_cast<int>(
+                         key_count - entry_itr / value_count)),
+                  pool);
+    key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    locations[entry_itr] = ItemPointer(entry_itr, 0);
+    entries.emplace_back(std::move(key), &locations[entry_itr]);
+  }
+
+  EXPECT_TRUE(index->BulkLoad(entries));
+
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(locations.size(), location_ptrs.size());
+  location_ptrs.clear();
+
+  index->ScanKey(entries[0].first.get(), location_ptrs);
+  EXPECT_EQ(value_count, location_ptrs.size());
+  location_ptrs.clear();
+
+  // The loaded tree takes inserts and deletes
+  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+  key0->SetValue(0, type::ValueFactory::GetIntegerValue(1000), pool);
+  key0->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+  EXPECT_TRUE(index->InsertEntry(key0.get(), TestingIndexUtil::item0.get()));
+  EXPECT_TRUE(index->DeleteEntry(entries[0].first.get(), entries[0].second));
+
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(locations.size(), location_ptrs.size());
+  location_ptrs.clear();
+
+  // Only an empty index is bulk loaded
+  EXPECT_FALSE(index->BulkLoad(entries));
+
+  delete index->GetMetadata()->GetTupleSchema();
+
+  // A unique index is not bulk loaded with duplicate keys
+  std::unique_ptr<index::Index> unique_index(
+      TestingIndexUtil::BuildIndex(IndexType::BWTREE, true));
+  EXPECT_FALSE(unique_index->BulkLoad(entries));
+
+  entries.resize(1);
+  EXPECT_TRUE(unique_index->BulkLoad(entries));
+
+  delete unique_index->GetMetadata()->GetTupleSchema();
+}
+
+TEST_F(BwTreeIndexTests, ScanLimitTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::unique_ptr<index::Index> index(
+      TestingIndexUtil::BuildIndex(IndexType::BWTREE, false));
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // Enough keys for several leaves, with two locations for every key
+  const int key_count = 10000;
+  std::vector<ItemPointer> locations(key_count * 2);
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+  for (int key_itr = 0; key_itr < key_count; key_itr++) {
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(key_itr), pool);
+    for (int value_itr = 0; value_itr < 2; value_itr++) {
+      locations[key_itr * 2 + value_itr] = ItemPointer(key_itr, value_itr);
+      EXPECT_TRUE(
+          index->InsertEntry(key.get(), &locations[key_itr * 2 + value_itr]));
+    }
+  }
+
+  // 100 <= A <= 200
+  std::vector<type::Value> value_list = {
+      type::ValueFactory::GetIntegerValue(100).Copy(),
+      type::ValueFactory::GetIntegerValue(200).Copy()};
+  std::vector<oid_t> tuple_column_id_list = {0, 0};
+  std::vector<ExpressionType> expr_list = {
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+      ExpressionType::COMPARE_LESSTHANOREQUALTO};
+  index::IndexScanPredicate range_isp{};
+  range_isp.AddConjunctionScanPredicate(index.get(), value_list,
+                                        tuple_column_id_list, expr_list);
+
+  std::vector<ItemPointer *> location_ptrs;
+  index->ScanLimit(value_list, tuple_column_id_list, expr_list,
+                   ScanDirectionType::FORWARD, location_ptrs,
+                   &range_isp.GetConjunctionList()[0], 10, 5);
+  ASSERT_EQ(10U, location_ptrs.size());
+  EXPECT_EQ(102U, location_ptrs[0]->block);
+  EXPECT_EQ(107U, location_ptrs[9]->block);
+  location_ptrs.clear();
+
+  index->ScanLimit(value_list, tuple_column_id_list, expr_list,
+                   ScanDirectionType::BACKWARD, location_ptrs,
+                   &range_isp.GetConjunctionList()[0], 10, 5);
+  ASSERT_EQ(10U, location_ptrs.size());
+  EXPECT_EQ(197U, location_ptrs[0]->block);
+  EXPECT_EQ(193U, location_ptrs[9]->block);
+  location_ptrs.clear();
+
+  // The whole range backward, from the last key of the last leaf
+  index::IndexScanPredicate all_isp{};
+  all_isp.AddConjunctionScanPredicate(index.get(), {}, {}, {});
+  index->ScanLimit({}, {}, {}, ScanDirectionType::BACKWARD, location_ptrs,
+                   &all_isp.GetConjunctionList()[0], 3, 0);
+  ASSERT_EQ(3U, location_ptrs.size());
+  EXPECT_EQ(static_cast<oid_t>(key_count - 1), location_ptrs[0]->block);
+  EXPECT_EQ(static_cast<oid_t>(key_count - 2), location_ptrs[2]->block);
+  location_ptrs.clear();
+
+  index->ScanLimit({}, {}, {}, ScanDirectionType::BACKWARD, location_ptrs,
+                   &all_isp.GetConjunctionList()[0],
+                   std::numeric_limits<uint64_t>::max(), 0);
+  ASSERT_EQ(locations.size(), location_ptrs.size());
+  EXPECT_EQ(0U, location_ptrs.back()->block);
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
+TEST_F(BwTreeIndexTests, CompositeKeyTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // integer 4 + varchar 8 + decimal 8 + timestamp 8 = total 28
+  std::vector<catalog::Column> column_list = {
+      catalog::Column(type::TypeId::INTEGER,
+                      type::Type::GetTypeSize(type::TypeId::INTEGER), "A",
+                      true),
+      catalog::Column(type::TypeId::VARCHAR, 1024, "B", false),
+      catalog::Column(type::TypeId::DECIMAL,
+                      type::Type::GetTypeSize(type::TypeId::DECIMAL), "C",
+                      true),
+      catalog::Column(type::TypeId::TIMESTAMP,
+                      type::Type::GetTypeSize(type::TypeId::TIMESTAMP), "D",
+                      true)};
+  std::vector<oid_t> key_attrs = {0, 1, 2, 3};
+  catalog::Schema *key_schema = new catalog::Schema(column_list);
+  key_schema->SetIndexedColumns(key_attrs);
+  catalog::Schema *tuple_schema = new catalog::Schema(column_list);
+  EXPECT_EQ(28U, key_schema->GetLength());
+
+  index::IndexMetadata *index_metadata = new index::IndexMetadata(
+      "composite_index", 126, INVALID_OID, INVALID_OID, IndexType::BWTREE,
+      IndexConstraintType::DEFAULT, tuple_schema, key_schema, key_attrs,
+      false);
+  std::unique_ptr<index::Index> index(
+      index::IndexFactory::GetIndex(index_metadata));
+
+  // The 28 byte keys take the 32 byte size class, not the 64 byte one
+  using Key32Index = index::BWTreeIndex<
+      index::GenericKey<32>, ItemPointer *, index::FastGenericComparator<32>,
+      index::GenericEqualityChecker<32>, index::GenericHasher<32>,
+      ItemPointerComparator, ItemPointerHashFunc>;
+  EXPECT_NE(nullptr, dynamic_cast<Key32Index *>(index.get()));
+
+  // The keys share the first three columns and differ in the last one
+  const int key_count = 1000;
+  std::vector<ItemPointer> locations(key_count);
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(0, type::ValueFactory::GetIntegerValue(7), pool);
+  key->SetValue(1, type::ValueFactory::GetVarcharValue("tenant"), pool);
+  key->SetValue(2, type::ValueFactory::GetDecimalValue(1.5), pool);
+  for (int key_itr = key_count - 1; key_itr >= 0; key_itr--) {
+    key->SetValue(3, type::ValueFactory::GetTimestampValue(key_itr), pool);
+    locations[key_itr] = ItemPointer(key_itr, 0);
+    EXPECT_TRUE(index->InsertEntry(key.get(), &locations[key_itr]));
+  }
+
+  std::vector<ItemPointer *> location_ptrs;
+  key->SetValue(3, type::ValueFactory::GetTimestampValue(500), pool);
+  index->ScanKey(key.get(), location_ptrs);
+  ASSERT_EQ(1U, location_ptrs.size());
+  EXPECT_EQ(500U, location_ptrs[0]->block);
+  location_ptrs.clear();
+
+  // The full scan returns the keys in order of the last column
+  index::IndexScanPredicate all_isp{};
+  all_isp.AddConjunctionScanPredicate(index.get(), {}, {}, {});
+  index->ScanLimit({}, {}, {}, ScanDirectionType::FORWARD, location_ptrs,
+                   &all_isp.GetConjunctionList()[0],
+                   std::numeric_limits<uint64_t>::max(), 0);
+  ASSERT_EQ(locations.size(), location_ptrs.size());
+  for (oid_t key_itr = 0; key_itr < location_ptrs.size(); key_itr++) {
+    EXPECT_EQ(key_itr, location_ptrs[key_itr]->block);
+  }
+
+  delete tuple_schema;
+}
+
+TEST_F(BwTreeIndexTests, ThreadLocalEpochTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::unique_ptr<index::Index> index(
+      TestingIndexUtil::BuildIndex(IndexType::BWTREE, false));
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  // More threads than GC contexts over all rounds, so the threads of later
+  // rounds take over the GC IDs of the exited ones
+  const int thread_count = 8;
+  const int round_count = 40;
+  const int key_count = 50;
+  std::vector<ItemPointer> locations(thread_count * round_count * key_count);
+  for (int round_itr = 0; round_itr < round_count; round_itr++) {
+    LaunchParallelTest(thread_count, [&](uint64_t thread_itr) {
+      std::unique_ptr<storage::Tuple> key(
+          new storage::Tuple(key_schema, true));
+      key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+      for (int key_itr = 0; key_itr < key_count; key_itr++) {
+        int entry_itr =
+            (round_itr * thread_count + static_cast<int>(thread_itr)) *
+                key_count + key_itr;
+        key->SetValue(0, type::ValueFactory::GetIntegerValue(entry_itr), pool);
+        locations[entry_itr] = ItemPointer(entry_itr, 0);
+        EXPECT_TRUE(index->InsertEntry(key.get(), &locations[entry_itr]));
+      }
+    });
+  }
+
+  std::vector<ItemPointer *> location_ptrs;
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(locations.size(), location_ptrs.size());
+  EXPECT_NE(-1, index::BwTreeBase::gc_id);
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
+TEST_F(BwTreeIndexTests, StructureStatsTest) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  std::unique_ptr<index::Index> index(
+      TestingIndexUtil::BuildIndex(IndexType::BWTREE, false));
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  auto structure_stats = index->GetStructureStats();
+  EXPECT_EQ(0, structure_stats.consolidation_count);
+  EXPECT_EQ(0, structure_stats.split_count);
+  EXPECT_EQ(1, structure_stats.epoch_count);
+  EXPECT_EQ(0, structure_stats.garbage_node_count);
+  EXPECT_EQ(8, structure_stats.delta_chain_threshold);
+
+  // Enough writes without reads to tune the tree for a write mostly workload
+  const int key_count = 1 << 16;
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  key->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+  for (int key_itr = 0; key_itr < key_count; key_itr++) {
+    key->SetValue(0, type::ValueFactory::GetIntegerValue(key_itr), pool);
+    EXPECT_TRUE(index->InsertEntry(key.get(), TestingIndexUtil::item0.get()));
+  }
+
+  structure_stats = index->GetStructureStats();
+  EXPECT_LT(0, structure_stats.consolidation_count);
+  EXPECT_LT(0, structure_stats.split_count);
+  EXPECT_LT(0, structure_stats.garbage_node_count);
+  EXPECT_EQ(16, structure_stats.delta_chain_threshold);
+
+  // The replaced nodes are freed once no thread is in their epoch
+  index->PerformGC();
+  index->PerformGC();
+  structure_stats = index->GetStructureStats();
+  EXPECT_EQ(0, structure_stats.garbage_node_count);
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -220,7 +220,7 @@ void GenerateSequence(std::vector<oid_t> &hyadapt_column_ids,
   }
 }
 
-void ExecuteTest(executor::AbstractExecutor *executor) {
+size_t ExecuteTest(executor::AbstractExecutor *executor) {
   Timer<> timer;
 
   bool status = false;
@@ -246,6 +246,7 @@ void ExecuteTest(executor::AbstractExecutor *executor) {
   LOG_TRACE("Upper bound        : %.0lf", tuple_end_offset);
   LOG_TRACE("Result tuple count : %lu", result_tuple_count);
   // EXPECT_EQ(result_tuple_count, selectivity * tuple_count);
+  return result_tuple_count;
 }
 
 void LaunchSeqScan(std::unique_ptr<storage::DataTable> &hyadapt_table) {
@@ -326,7 +327,7 @@ void LaunchIndexScan(std::unique_ptr<storage::DataTable> &hyadapt_table) {
   txn_manager.CommitTransaction(txn);
 }
 
-void LaunchHybridScan(std::unique_ptr<storage::DataTable> &hyadapt_table) {
+size_t LaunchHybridScan(std::unique_ptr<storage::DataTable> &hyadapt_table) {
   std::vector<oid_t> column_ids;
   std::vector<oid_t> column_ids_second;
   oid_t query_column_count = projectivity * column_count;
@@ -367,9 +368,10 @@ void LaunchHybridScan(std::unique_ptr<storage::DataTable> &hyadapt_table) {
   executor::HybridScanExecutor hybrid_scan_executor(&hybrid_scan_plan,
                                                     context.get());
 
-  ExecuteTest(&hybrid_scan_executor);
+  auto result_tuple_count = ExecuteTest(&hybrid_scan_executor);
 
   txn_manager.CommitTransaction(txn);
+  return result_tuple_count;
 }
 
 void CopyTuple(const oid_t &tuple_slot_id, storage::Tuple *tuple,
@@ -381,13 +383,12 @@ void CopyTuple(const oid_t &tuple_slot_id, storage::Tuple *tuple,
   }
 }
 
-void BuildIndex(std::shared_ptr<index::Index> index,
-                storage::DataTable *table) {
+// Index the tile groups of the table in [start, end)
+void BuildIndex(std::shared_ptr<index::Index> index, storage::DataTable *table,
+                oid_t start_tile_group_count, oid_t table_tile_group_count) {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   auto txn = txn_manager.BeginTransaction();
 
-  oid_t start_tile_group_count = START_OID;
-  oid_t table_tile_group_count = table->GetTileGroupCount();
 
   while (start_tile_group_count < table_tile_group_count) {
     auto tile_group = table->GetTileGroup(start_tile_group_count++);
@@ -458,7 +459,8 @@ TEST_F(HybridIndexTests, HybridScanTest) {
   hyadapt_table->AddIndex(pkey_index);
 
   std::thread index_builder =
-      std::thread(BuildIndex, pkey_index, hyadapt_table.get());
+      std::thread(BuildIndex, pkey_index, hyadapt_table.get(), START_OID,
+                  hyadapt_table->GetTileGroupCount());
 
   for (size_t query_itr = 0; query_itr < query_count; query_itr++) {
     LaunchHybridScan(hyadapt_table);
@@ -467,6 +469,37 @@ TEST_F(HybridIndexTests, HybridScanTest) {
   index_builder.join();
 }
 
+TEST_F(HybridIndexTests, AdaptiveHybridScanTest) {
+  std::unique_ptr<storage::DataTable> hyadapt_table;
+  CreateTable(hyadapt_table, false);
+  LoadTable(hyadapt_table);
+
+  std::vector<oid_t> key_attrs = {0};
+  auto tuple_schema = hyadapt_table->GetSchema();
+  catalog::Schema *key_schema =
+      catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+  index::IndexMetadata *index_metadata = new index::IndexMetadata(
+      "primary_index", 123, INVALID_OID, INVALID_OID, IndexType::BWTREE,
+      IndexConstraintType::PRIMARY_KEY, tuple_schema, key_schema, key_attrs,
+      true);
+  std::shared_ptr<index::Index> pkey_index(
+      index::IndexFactory::GetIndex(index_metadata));
+  hyadapt_table->AddIndex(pkey_index);
+
+  size_t expected = static_cast<int32_t>(tuple_end_offset) -
+                    static_cast<int32_t>(tuple_start_offset);
+
+  // The tuples of the predicate are in the last tile group, which is scanned
+  // while the others are not indexed, and looked up once it is
+  BuildIndex(pkey_index, hyadapt_table.get(), START_OID, tile_group_count - 1);
+  EXPECT_EQ(expected, LaunchHybridScan(hyadapt_table));
+
+  BuildIndex(pkey_index, hyadapt_table.get(), tile_group_count - 1,
+             tile_group_count);
+  EXPECT_EQ(expected, LaunchHybridScan(hyadapt_table));
+}
+
 }  // namespace hybrid_index_test
 }  // namespace test
 }  // namespace peloton
@@ -17,6 +17,7 @@
 #include "common/platform.h"
 #include "common/timer.h"
 #include "index/index_factory.h"
+#include "index/index_key.h"
 #include "storage/tuple.h"
 
 namespace peloton {
@@ -234,6 +235,53 @@ TEST_F(IndexIntsKeyTests, IndexIntsKeyTest) {
   }
 }
 
+TEST_F(IndexIntsKeyTests, CountKeysBeforeTest) {
+  // Keys are searched inside arrays of pairs, as in the BwTree nodes
+  using KeyType = index::CompactIntsKey<1>;
+  using KeyComparator = index::CompactIntsComparator<1>;
+  static_assert(KeyComparator::HAS_KEY_ARRAY_SEARCH,
+                "Single word keys should be searched by arrays");
+
+  std::vector<std::pair<KeyType, ItemPointer *>> key_array;
+  std::vector<int64_t> values;
+  for (int64_t i = 0; i < 100; i++) {
+    // Duplicates and negative values to check the order of key bytes
+    values.push_back((i / 2) * 3 - 50);
+  }
+  for (int64_t value : values) {
+    KeyType key;
+    key.AddInteger<int64_t>(value, 0);
+    key_array.emplace_back(key, nullptr);
+  }
+
+  const unsigned char *key_array_p =
+      reinterpret_cast<const unsigned char *>(key_array.data());
+  for (int64_t search_value = -60; search_value < 110; search_value++) {
+    KeyType search_key;
+    search_key.AddInteger<int64_t>(search_value, 0);
+
+    // Every array size exercises both the vector and the scalar compares
+    for (size_t key_count : {0, 1, 5, 16, 17, 63, 100}) {
+      size_t expected_lower = std::lower_bound(values.begin(),
+                                               values.begin() + key_count,
+                                               search_value) -
+                              values.begin();
+      size_t expected_upper = std::upper_bound(values.begin(),
+                                               values.begin() + key_count,
+                                               search_value) -
+                              values.begin();
+      EXPECT_EQ(expected_lower,
+                KeyComparator::CountKeysBefore(key_array_p,
+                                               sizeof(key_array[0]),
+                                               key_count, search_key, false));
+      EXPECT_EQ(expected_upper,
+                KeyComparator::CountKeysBefore(key_array_p,
+                                               sizeof(key_array[0]),
+                                               key_count, search_key, true));
+    }
+  }
+}
+
 // FIXME: The B-Tree core dumps. If we're not going to support then we should
 // probably drop it.
 // TEST_F(IndexIntsKeyTests, BTreeTest) {
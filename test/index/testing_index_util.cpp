@@ -12,6 +12,8 @@
 
 #include "index/testing_index_util.h"
 
+#include <algorithm>
+
 #include "gtest/gtest.h"
 
 #include "common/harness.h"
@@ -731,6 +733,63 @@ index::Index *TestingIndexUtil::BuildIndex(const IndexType index_type,
   return index;
 }
 
+void TestingIndexUtil::ScanKeysTest(const IndexType index_type) {
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // INDEX
+  std::unique_ptr<index::Index> index(
+      TestingIndexUtil::BuildIndex(index_type, false));
+  const catalog::Schema *key_schema = index->GetKeySchema();
+
+  size_t scale_factor = 100;
+  LaunchParallelTest(1, TestingIndexUtil::InsertHelper, index.get(), pool,
+                     scale_factor);
+
+  // Keys with one and three values, and keys that are not in the index
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  for (size_t scale_itr = 1; scale_itr <= scale_factor; scale_itr++) {
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> keynonce(
+        new storage::Tuple(key_schema, true));
+    key0->SetValue(0, type::ValueFactory::GetIntegerValue(100 * scale_itr),
+                   pool);
+    key0->SetValue(1, type::ValueFactory::GetVarcharValue("a"), pool);
+    key1->SetValue(0, type::ValueFactory::GetIntegerValue(100 * scale_itr),
+                   pool);
+    key1->SetValue(1, type::ValueFactory::GetVarcharValue("b"), pool);
+    keynonce->SetValue(0, type::ValueFactory::GetIntegerValue(1000 * scale_itr),
+                       pool);
+    keynonce->SetValue(1, type::ValueFactory::GetVarcharValue("f"), pool);
+    keys.push_back(std::move(key1));
+    keys.push_back(std::move(keynonce));
+    keys.push_back(std::move(key0));
+  }
+
+  std::vector<const storage::Tuple *> batch;
+  for (auto &key : keys) {
+    batch.push_back(key.get());
+  }
+
+  std::vector<std::vector<ItemPointer *>> results;
+  index->ScanKeys(batch, results);
+  EXPECT_EQ(batch.size(), results.size());
+
+  // The batch finds what the keys find one by one
+  for (size_t key_itr = 0; key_itr < batch.size(); key_itr++) {
+    std::vector<ItemPointer *> location_ptrs;
+    index->ScanKey(batch[key_itr], location_ptrs);
+
+    std::sort(location_ptrs.begin(), location_ptrs.end());
+    std::sort(results[key_itr].begin(), results[key_itr].end());
+    EXPECT_EQ(location_ptrs, results[key_itr]);
+    EXPECT_EQ(key_itr % 3 == 0 ? 3 : key_itr % 3 == 1 ? 0 : 1,
+              results[key_itr].size());
+  }
+
+  delete index->GetMetadata()->GetTupleSchema();
+}
+
 void TestingIndexUtil::InsertHelper(index::Index *index, type::AbstractPool *pool,
                                   size_t scale_factor,
                                   UNUSED_ATTRIBUTE uint64_t thread_itr) {
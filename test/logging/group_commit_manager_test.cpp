@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// group_commit_manager_test.cpp
+//
+// Identification: test/logging/group_commit_manager_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "logging/group_commit_manager.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Group Commit Manager Tests
+//===--------------------------------------------------------------------===//
+
+class GroupCommitManagerTests : public PelotonTest {};
+
+TEST_F(GroupCommitManagerTests, AcknowledgeTest) {
+  auto &group_commit_manager = logging::GroupCommitManager::GetInstance();
+
+  std::vector<eid_t> acknowledged;
+  for (eid_t epoch_id = 1; epoch_id <= 3; epoch_id++) {
+    group_commit_manager.EnqueueCommit(
+        epoch_id, [&acknowledged, epoch_id](const ResultType result) {
+          EXPECT_EQ(ResultType::SUCCESS, result);
+          acknowledged.push_back(epoch_id);
+        });
+  }
+  group_commit_manager.EnqueueCommit(
+      1, [&acknowledged](const ResultType) { acknowledged.push_back(1); });
+  EXPECT_EQ(4U, group_commit_manager.GetPendingCommitCount());
+
+  // Nothing is durable yet
+  EXPECT_EQ(0U, group_commit_manager.AcknowledgeCommits(0));
+
+  // The commits of an epoch are acknowledged together, in epoch order
+  EXPECT_EQ(3U, group_commit_manager.AcknowledgeCommits(2));
+  EXPECT_EQ(std::vector<eid_t>({1, 1, 2}), acknowledged);
+  EXPECT_EQ(1U, group_commit_manager.GetPendingCommitCount());
+
+  EXPECT_EQ(1U, group_commit_manager.AcknowledgeCommits(MAX_EID));
+  EXPECT_EQ(0U, group_commit_manager.GetPendingCommitCount());
+}
+
+TEST_F(GroupCommitManagerTests, GroupCommitTransactionTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // Without the group commit thread, commits are acknowledged right away
+  EXPECT_FALSE(logging::GroupCommitManager::GetInstance().IsRunning());
+
+  std::vector<ResultType> results;
+  auto callback = [&results](const ResultType result) {
+    results.push_back(result);
+  };
+
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(ResultType::SUCCESS,
+            txn_manager.GroupCommitTransaction(txn, callback));
+  EXPECT_EQ(std::vector<ResultType>({ResultType::SUCCESS}), results);
+}
+
+TEST_F(GroupCommitManagerTests, CommitLatencyTest) {
+  auto &group_commit_manager = logging::GroupCommitManager::GetInstance();
+  group_commit_manager.ResetCommitLatencies();
+
+  for (int commit_itr = 0; commit_itr < 4; commit_itr++) {
+    group_commit_manager.EnqueueCommit(1, [](const ResultType) {});
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(4U, group_commit_manager.AcknowledgeCommits(1));
+
+  // The latency runs from the enqueue to the acknowledgement, at least the
+  // 10 ms waited up to the precision of the histogram
+  auto latencies = group_commit_manager.GetCommitLatencies();
+  EXPECT_EQ(4U, latencies.GetCount());
+  EXPECT_LE(10000U, latencies.GetMax());
+  EXPECT_LE(9500, latencies.GetPercentile(50));
+  EXPECT_LE(latencies.GetPercentile(50), latencies.GetMax());
+
+  group_commit_manager.ResetCommitLatencies();
+  EXPECT_EQ(0U, group_commit_manager.GetCommitLatencies().GetCount());
+}
+
+TEST_F(GroupCommitManagerTests, CommitWaiterTest) {
+  auto &group_commit_manager = logging::GroupCommitManager::GetInstance();
+  auto commit_waiter = std::make_shared<logging::CommitWaiter>();
+  int acknowledged_count = 0;
+  auto acknowledged = [&acknowledged_count] { acknowledged_count++; };
+
+  // Nothing to wait for
+  EXPECT_FALSE(commit_waiter->OnAcknowledged(acknowledged));
+
+  // The client learns once the last of its commits is acknowledged
+  group_commit_manager.EnqueueCommit(1,
+                                     commit_waiter->AddCommit(commit_waiter));
+  group_commit_manager.EnqueueCommit(2,
+                                     commit_waiter->AddCommit(commit_waiter));
+  EXPECT_EQ(2U, commit_waiter->GetPendingCommitCount());
+  EXPECT_TRUE(commit_waiter->OnAcknowledged(acknowledged));
+  EXPECT_EQ(1U, group_commit_manager.AcknowledgeCommits(1));
+  EXPECT_EQ(0, acknowledged_count);
+  EXPECT_EQ(1U, group_commit_manager.AcknowledgeCommits(2));
+  EXPECT_EQ(1, acknowledged_count);
+  EXPECT_EQ(0U, commit_waiter->GetPendingCommitCount());
+  EXPECT_FALSE(commit_waiter->OnAcknowledged(acknowledged));
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -62,6 +62,8 @@ TEST_F(LogBufferTests, LogBufferTest) {
 
   EXPECT_EQ(size, sizeof(num));
 
+  EXPECT_EQ(log_buffer.GetFrameCount(), 1);
+
   log_buffer.Reset();
 
   rt = log_buffer.Empty();
@@ -71,6 +73,8 @@ TEST_F(LogBufferTests, LogBufferTest) {
   size = log_buffer.GetSize();
 
   EXPECT_EQ(size, 0);
+
+  EXPECT_EQ(log_buffer.GetFrameCount(), 0);
   
 }
 
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_file_test.cpp
+//
+// Identification: test/logging/log_file_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <sys/stat.h>
+
+#include "logging/log_file.h"
+#include "common/harness.h"
+#include "util/file_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Log File Tests
+//===--------------------------------------------------------------------===//
+
+class LogFileTests : public PelotonTest {};
+
+TEST_F(LogFileTests, BatchedAppendTest) {
+  std::string log_dir = FileUtil::CreateTempDirectory("log_file_test");
+  std::string log_file_path = log_dir + "/log_0_0";
+
+  logging::LogFile log_file;
+  EXPECT_TRUE(log_file.Open(log_file_path));
+  EXPECT_TRUE(log_file.IsOpen());
+  EXPECT_EQ(0U, log_file.GetSize());
+
+  // nothing reaches the file before the flush
+  std::string first(1000, 'a');
+  std::string second = "bc";
+  log_file.Append(first.data(), first.size());
+  log_file.Append(second.data(), second.size());
+  log_file.Append(second.data(), 0);
+  EXPECT_EQ(first.size() + second.size(), log_file.GetSize());
+  EXPECT_TRUE(FileUtil::GetFile(log_file_path).empty());
+
+  // the preallocated space is not part of the file
+  EXPECT_TRUE(log_file.Flush());
+  EXPECT_TRUE(log_file.Flush());
+  EXPECT_EQ(first + second, FileUtil::GetFile(log_file_path));
+  log_file.Close();
+  EXPECT_FALSE(log_file.IsOpen());
+
+  struct stat file_stat;
+  ASSERT_EQ(0, stat(log_file_path.c_str(), &file_stat));
+  EXPECT_EQ(first.size() + second.size(),
+            static_cast<size_t>(file_stat.st_size));
+
+  // a reopened file is appended to
+  EXPECT_TRUE(log_file.Open(log_file_path));
+  EXPECT_EQ(first.size() + second.size(), log_file.GetSize());
+  log_file.Append(second.data(), second.size());
+  EXPECT_TRUE(log_file.Flush());
+  log_file.Close();
+  EXPECT_EQ(first + second + second, FileUtil::GetFile(log_file_path));
+
+  FileUtil::RemoveDirectory(log_dir);
+}
+
+TEST_F(LogFileTests, PersistentMappingTest) {
+  std::string log_dir = FileUtil::CreateTempDirectory("log_file_test");
+  std::string log_file_path = log_dir + "/log_0_0";
+
+  // without DAX support the mapping falls back to msync
+  logging::LogFile log_file;
+  EXPECT_TRUE(log_file.Open(log_file_path, BackendType::NVM));
+  EXPECT_EQ(BackendType::NVM, log_file.GetBackendType());
+  EXPECT_EQ(0U, log_file.GetSize());
+  EXPECT_TRUE(logging::LogFile::ReadFile(log_file_path).empty());
+
+  // the header only covers the flushed data
+  std::string first(1000, 'a');
+  std::string second = "bc";
+  log_file.Append(first.data(), first.size());
+  log_file.Append(second.data(), second.size());
+  EXPECT_TRUE(logging::LogFile::ReadFile(log_file_path).empty());
+  EXPECT_TRUE(log_file.Flush());
+  EXPECT_EQ(first + second, logging::LogFile::ReadFile(log_file_path));
+  EXPECT_LT(first.size() + second.size(),
+            FileUtil::GetFile(log_file_path).size());
+  log_file.Close();
+  EXPECT_EQ(first + second, logging::LogFile::ReadFile(log_file_path));
+
+  // a reopened file keeps its layout
+  EXPECT_TRUE(log_file.Open(log_file_path));
+  EXPECT_EQ(BackendType::NVM, log_file.GetBackendType());
+  EXPECT_EQ(first.size() + second.size(), log_file.GetSize());
+  log_file.Append(second.data(), second.size());
+  EXPECT_TRUE(log_file.Flush());
+  EXPECT_EQ(first + second + second,
+            logging::LogFile::ReadFile(log_file_path));
+
+  EXPECT_TRUE(log_file.Truncate(first.size()));
+  EXPECT_EQ(first.size(), log_file.GetSize());
+  log_file.Close();
+  EXPECT_EQ(first, logging::LogFile::ReadFile(log_file_path));
+
+  FileUtil::RemoveDirectory(log_dir);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_stats_test.cpp
+//
+// Identification: test/logging/log_stats_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "logging/log_stats.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Log Stats Tests
+//===--------------------------------------------------------------------===//
+
+class LogStatsTests : public PelotonTest {};
+
+TEST_F(LogStatsTests, LatencyHistogramTest) {
+  logging::LatencyHistogram histogram;
+  EXPECT_EQ(0U, histogram.GetCount());
+  EXPECT_EQ(0, histogram.GetPercentile(50));
+
+  // Small latencies are counted exactly
+  for (uint64_t latency = 1; latency <= 10; latency++) {
+    histogram.Record(latency);
+  }
+  EXPECT_EQ(10U, histogram.GetCount());
+  EXPECT_EQ(5.5, histogram.GetAverage());
+  EXPECT_EQ(5, histogram.GetPercentile(50));
+  EXPECT_EQ(10, histogram.GetPercentile(100));
+
+  // Larger ones within their bucket
+  logging::LatencyHistogram other_histogram;
+  for (uint64_t latency = 1000; latency <= 100000; latency += 1000) {
+    other_histogram.Record(latency);
+  }
+  EXPECT_NEAR(50000, other_histogram.GetPercentile(50), 50000 * 0.04);
+  EXPECT_NEAR(99000, other_histogram.GetPercentile(99), 99000 * 0.04);
+  EXPECT_EQ(100000, other_histogram.GetPercentile(100));
+  EXPECT_EQ(100000U, other_histogram.GetMax());
+
+  histogram.Merge(other_histogram);
+  EXPECT_EQ(110U, histogram.GetCount());
+  EXPECT_EQ(100000U, histogram.GetMax());
+  EXPECT_EQ(10, histogram.GetPercentile(9));
+
+  histogram.Reset();
+  EXPECT_EQ(0U, histogram.GetCount());
+  EXPECT_EQ(0U, histogram.GetMax());
+}
+
+TEST_F(LogStatsTests, LoggerStatsTest) {
+  logging::LoggerStats stats;
+  stats.flush_count = 1;
+  stats.flush_byte_count = 100;
+  stats.max_flush_byte_count = 100;
+
+  logging::LoggerStats other_stats;
+  other_stats.flush_count = 2;
+  other_stats.flush_byte_count = 300;
+  other_stats.max_flush_byte_count = 200;
+
+  stats += other_stats;
+  EXPECT_EQ(3U, stats.flush_count);
+  EXPECT_EQ(400U, stats.flush_byte_count);
+  EXPECT_EQ(200U, stats.max_flush_byte_count);
+}
+
+}  // End test namespace
+}  // End peloton namespace
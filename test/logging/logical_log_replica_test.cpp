@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logical_log_replica_test.cpp
+//
+// Identification: test/logging/logical_log_replica_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "logging/log_manager_factory.h"
+#include "logging/logical_log_replica.h"
+#include "catalog/catalog_defaults.h"
+#include "common/harness.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "type/serializeio.h"
+#include "util/file_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Logical Log Replica Tests
+//===--------------------------------------------------------------------===//
+
+class LogicalLogReplicaTests : public PelotonTest {};
+
+TEST_F(LogicalLogReplicaTests, ApplyShippedLogTest) {
+  std::string log_dir = FileUtil::CreateTempDirectory("replica_test");
+  logging::LogManagerFactory::Configure(1, log_dir);
+  auto &log_manager = logging::LogManagerFactory::GetInstance();
+  auto &log_replica = logging::LogicalLogReplica::GetInstance();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  oid_t table_oid = 34567;
+  oid_t index_oid = 34568;
+
+  // the log of the primary
+  log_manager.StartLogging();
+
+  auto table = TestingTransactionUtil::CreateTable(
+      10, "REPLICA_TABLE", CATALOG_DATABASE_OID, table_oid, index_oid, true);
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 0, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table, 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  log_manager.StopLogging();
+
+  // the replica starts with an empty table
+  auto database = storage::StorageManager::GetInstance()->GetDatabaseWithOid(
+      CATALOG_DATABASE_OID);
+  database->DropTableWithOid(table_oid);
+  table = TestingTransactionUtil::CreateTable(
+      0, "REPLICA_TABLE", CATALOG_DATABASE_OID, table_oid, index_oid, true);
+
+  // ship the log as two batches, split after its first frame
+  std::string log = FileUtil::GetFile(
+      logging::LogicalLogger::GetSegmentPath(log_dir, 0, 0));
+  ASSERT_LT(sizeof(int32_t), log.size());
+  ReferenceSerializeInput input(log.data(), sizeof(int32_t));
+  size_t first_size = sizeof(int32_t) + input.ReadInt();
+  ASSERT_LT(first_size, log.size());
+
+  // a batch arriving ahead of the earlier one waits for it
+  EXPECT_EQ(INVALID_EID,
+            log_replica.ReceiveLog(0, 1, 1, log.substr(first_size)));
+  EXPECT_EQ(INVALID_EID, log_replica.GetReplicatedEpochId());
+  eid_t replicated_epoch_id =
+      log_replica.ReceiveLog(0, 1, 0, log.substr(0, first_size));
+  EXPECT_NE(INVALID_EID, replicated_epoch_id);
+  EXPECT_EQ(replicated_epoch_id, log_replica.GetReplicatedEpochId());
+
+  // the snapshots see the epochs applied before they began
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  int result = -1;
+  txn = log_replica.BeginSnapshot();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 0, result));
+  EXPECT_EQ(1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 1, result));
+  EXPECT_EQ(-1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 9, result));
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  log_replica.Reset();
+  database->DropTableWithOid(table_oid);
+  FileUtil::RemoveDirectory(log_dir);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -11,7 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "logging/checkpoint_manager_factory.h"
+#include "logging/log_manager_factory.h"
 #include "common/harness.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "util/file_util.h"
 
 namespace peloton {
 namespace test {
@@ -25,9 +33,100 @@ class NewCheckpointingTests : public PelotonTest {};
 TEST_F(NewCheckpointingTests, MyTest) {
   auto &checkpoint_manager = logging::CheckpointManagerFactory::GetInstance();
   checkpoint_manager.Reset();
-  
+
   EXPECT_TRUE(true);
 }
 
+TEST_F(NewCheckpointingTests, LogicalCheckpointRecoveryTest) {
+  std::string checkpoint_dir = FileUtil::CreateTempDirectory("checkpoint_test");
+  logging::LogManagerFactory::Configure(1, checkpoint_dir);
+  auto &log_manager = logging::LogManagerFactory::GetInstance();
+  auto &checkpoint_manager = logging::LogicalCheckpointManager::GetInstance();
+  checkpoint_manager.SetDirectory(checkpoint_dir);
+  checkpoint_manager.SetCheckpointerCount(2);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_oid = 23456;
+  oid_t table_oids[] = {23457, 23458};
+  oid_t index_oids[] = {23459, 23460};
+  storage_manager->AddDatabaseToStorageManager(
+      new storage::Database(database_oid));
+
+  // the tuples inserted before the logging starts are only in the checkpoint
+  auto table = TestingTransactionUtil::CreateTable(
+      10, "CHECKPOINT_TABLE", database_oid, table_oids[0], index_oids[0], true);
+  auto other_table = TestingTransactionUtil::CreateTable(
+      10, "OTHER_TABLE", database_oid, table_oids[1], index_oids[1], true);
+
+  log_manager.StartLogging();
+
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 0, 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // the checkpoint holds the epochs before the current one
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  eid_t checkpoint_epoch_id = checkpoint_manager.DoCheckpoint();
+  EXPECT_EQ(epoch_manager.GetCurrentEpochId() - 1, checkpoint_epoch_id);
+  EXPECT_EQ(INVALID_EID, checkpoint_manager.DoCheckpoint());
+
+  // each table has its own file, a snapshot for the tables without varlen
+  // values
+  std::vector<std::string> checkpoint_paths;
+  EXPECT_EQ(checkpoint_epoch_id,
+            checkpoint_manager.GetLatestCheckpoint(checkpoint_paths));
+  EXPECT_EQ(2U, checkpoint_paths.size());
+  std::string suffix = ".snapshot";
+  for (auto &path : checkpoint_paths) {
+    EXPECT_EQ(suffix, path.substr(path.size() - suffix.size()));
+  }
+
+  // the writes after the checkpoint are only in the log
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 1, 2));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, other_table, 2));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  log_manager.StopLogging();
+
+  // restart with empty tables
+  auto database = storage_manager->GetDatabaseWithOid(database_oid);
+  database->DropTableWithOid(table_oids[0]);
+  database->DropTableWithOid(table_oids[1]);
+  table = TestingTransactionUtil::CreateTable(
+      0, "CHECKPOINT_TABLE", database_oid, table_oids[0], index_oids[0], true);
+  other_table = TestingTransactionUtil::CreateTable(
+      0, "OTHER_TABLE", database_oid, table_oids[1], index_oids[1], true);
+
+  EXPECT_NE(INVALID_EID, log_manager.DoRecovery(2));
+  EXPECT_EQ(10U, table->GetTupleCount());
+  EXPECT_EQ(9U, other_table->GetTupleCount());
+
+  int result = -1;
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 0, result));
+  EXPECT_EQ(1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 1, result));
+  EXPECT_EQ(2, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, other_table, 2, result));
+  EXPECT_EQ(-1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, other_table, 3, result));
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // the recovered tables take writes like any other
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 9, 5));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_FALSE(table->GetIndex(0)->GetMetadata()->IsBuilding());
+
+  storage_manager->RemoveDatabaseFromStorageManager(database_oid);
+  checkpoint_manager.SetDirectory(".");
+  FileUtil::RemoveDirectory(checkpoint_dir);
+}
+
 }
 }
@@ -10,8 +10,19 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
+
 #include "logging/log_manager_factory.h"
+#include "catalog/catalog.h"
 #include "common/harness.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/testing_transaction_util.h"
+#include "configuration/configuration.h"
+#include "sql/testing_sql_util.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "type/serializeio.h"
+#include "util/file_util.h"
 
 namespace peloton {
 namespace test {
@@ -30,5 +41,188 @@ TEST_F(NewLoggingTests, MyTest) {
   
 }
 
+TEST_F(NewLoggingTests, LogicalLoggingTest) {
+  std::string log_dir = FileUtil::CreateTempDirectory("logging_test");
+  logging::LogManagerFactory::Configure(1, log_dir);
+  auto &log_manager = static_cast<logging::LogicalLogManager &>(
+      logging::LogManagerFactory::GetInstance());
+  std::string log_file_path = log_dir + "/log_0_0";
+
+  // nothing to wait for without logging
+  EXPECT_EQ(MAX_EID, log_manager.GetPersistentEpochId());
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingTransactionUtil::CreateTable());
+
+  log_manager.StartLogging();
+  EXPECT_TRUE(log_manager.GetStatus());
+  EXPECT_EQ(log_file_path, log_manager.GetLogFilePath(0));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  eid_t epoch_id = txn->GetEpochId();
+  cid_t commit_id = txn->GetCommitId();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table.get(), 0, 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // a transaction without writes is not logged
+  int result = -1;
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table.get(), 0, result));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // the buffers left are written out when the logging stops
+  log_manager.StopLogging();
+  EXPECT_FALSE(log_manager.GetStatus());
+
+  std::string contents = FileUtil::GetFile(log_file_path);
+  ASSERT_FALSE(contents.empty());
+  CopySerializeInput input(contents.data(), contents.size());
+
+  int32_t length = input.ReadInt();
+  EXPECT_EQ(static_cast<char>(LogRecordType::TRANSACTION_BEGIN),
+            input.ReadEnumInSingleByte());
+  EXPECT_EQ(epoch_id, static_cast<eid_t>(input.ReadVarInt()));
+  EXPECT_EQ(commit_id, static_cast<cid_t>(input.ReadVarInt() ^
+                                          (static_cast<cid_t>(epoch_id) << 32)));
+  EXPECT_EQ(static_cast<char>(LogRecordType::TUPLE_UPDATE),
+            input.ReadEnumInSingleByte());
+  input.ReadVarInt();
+  EXPECT_EQ(table->GetOid(), static_cast<oid_t>(input.ReadVarInt()));
+
+  // the key of a table without primary key is the whole tuple
+  EXPECT_EQ(0xff, static_cast<uint8_t>(input.ReadByte()));
+  EXPECT_EQ(0, input.ReadInt());
+  EXPECT_EQ(1, input.ReadInt());
+  EXPECT_EQ(static_cast<char>(LogRecordType::TRANSACTION_COMMIT),
+            input.ReadEnumInSingleByte());
+
+  // only epoch end markers follow
+  size_t marker_size = sizeof(int32_t) + 1 + sizeof(int64_t);
+  size_t marker_bytes = contents.size() - sizeof(int32_t) - length;
+  EXPECT_EQ(0U, marker_bytes % marker_size);
+  if (marker_bytes > 0) {
+    EXPECT_EQ(1 + sizeof(int64_t), static_cast<size_t>(input.ReadInt()));
+    EXPECT_EQ(static_cast<char>(LogRecordType::EPOCH_END),
+              input.ReadEnumInSingleByte());
+  }
+
+  FileUtil::RemoveDirectory(log_dir);
+}
+
+TEST_F(NewLoggingTests, LogicalRecoveryTest) {
+  std::string log_dir = FileUtil::CreateTempDirectory("recovery_test");
+  logging::LogManagerFactory::Configure(2, log_dir);
+  auto &log_manager = logging::LogManagerFactory::GetInstance();
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  oid_t table_oid = 12345;
+  oid_t index_oid = 12346;
+
+  log_manager.StartLogging();
+
+  auto table = TestingTransactionUtil::CreateTable(
+      10, "RECOVERY_TABLE", CATALOG_DATABASE_OID, table_oid, index_oid, true);
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 0, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table, 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // an update changing no column only logs the key, the other values are
+  // those of the version it replaced
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 9, 0));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // the epochs of the transactions expire before the loggers stop
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  log_manager.StopLogging();
+
+  // restart with an empty table
+  auto database = storage::StorageManager::GetInstance()->GetDatabaseWithOid(
+      CATALOG_DATABASE_OID);
+  database->DropTableWithOid(table_oid);
+  table = TestingTransactionUtil::CreateTable(
+      0, "RECOVERY_TABLE", CATALOG_DATABASE_OID, table_oid, index_oid, true);
+
+  eid_t current_epoch_id = epoch_manager.GetCurrentEpochId();
+  EXPECT_NE(INVALID_EID, log_manager.DoRecovery(2));
+  EXPECT_LT(current_epoch_id, epoch_manager.GetCurrentEpochId());
+  EXPECT_EQ(9U, table->GetTupleCount());
+
+  // the recovered tuples are reachable through the rebuilt index
+  int result = -1;
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 0, result));
+  EXPECT_EQ(1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 1, result));
+  EXPECT_EQ(-1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 9, result));
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  database->DropTableWithOid(table_oid);
+  FileUtil::RemoveDirectory(log_dir);
+}
+
+TEST_F(NewLoggingTests, CommandLoggingTest) {
+  std::string log_dir = FileUtil::CreateTempDirectory("command_test");
+  logging::LogManagerFactory::Configure(1, log_dir);
+  auto &log_manager = logging::LogManagerFactory::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  auto catalog = catalog::Catalog::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE command_test(a INT PRIMARY KEY, b INT);");
+
+  FLAGS_command_logging = true;
+  log_manager.StartLogging();
+
+  // the statement run twice is stored once
+  std::string insert_query = "INSERT INTO command_test VALUES (1, 10);";
+  EXPECT_EQ(ResultType::SUCCESS, TestingSQLUtil::ExecuteSQLQuery(insert_query));
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "INSERT INTO command_test VALUES (2, 20);"));
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "UPDATE command_test SET b = b + 5;"));
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "UPDATE command_test SET b = b + 5;"));
+
+  epoch_manager.SetCurrentEpochId(epoch_manager.GetCurrentEpochId() + 1);
+  log_manager.StopLogging();
+  FLAGS_command_logging = false;
+
+  std::vector<std::string> query_strings;
+  logging::LogicalLogManager::ReadCommandFile(log_dir, query_strings);
+  EXPECT_EQ(3U, query_strings.size());
+  EXPECT_EQ(insert_query, query_strings[0]);
+
+  // restart with an empty table, the statements are run again
+  TestingSQLUtil::ExecuteSQLQuery("DROP TABLE command_test;");
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE command_test(a INT PRIMARY KEY, b INT);");
+  EXPECT_NE(INVALID_EID, log_manager.DoRecovery(1));
+
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM command_test WHERE a = 2;",
+                                  result);
+  ASSERT_EQ(1U, result.size());
+  EXPECT_EQ("30", std::string(result[0].second.begin(),
+                              result[0].second.end()));
+
+  txn = txn_manager.BeginTransaction();
+  catalog->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+  FileUtil::RemoveDirectory(log_dir);
+}
+
 }
 }
@@ -0,0 +1,143 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_service_test.cpp
+//
+// Identification: test/networking/shard_service_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/catalog.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "networking/shard_service.h"
+#include "sql/testing_sql_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Shard Service Tests
+//===--------------------------------------------------------------------===//
+
+class ShardServiceTests : public PelotonTest {
+ protected:
+  void SetUp() override {
+    PelotonTest::SetUp();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE orders(id INT PRIMARY KEY, total INT);");
+  }
+
+  void TearDown() override {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME,
+                                                          txn);
+    txn_manager.CommitTransaction(txn);
+    PelotonTest::TearDown();
+  }
+
+  ResultType Execute(networking::ShardService &service,
+                     const int64_t transaction_id, const std::string &query,
+                     networking::ShardStatementResponse &response) {
+    networking::ShardStatementRequest request;
+    request.set_request_id(1);
+    request.set_transaction_id(transaction_id);
+    request.set_query(query);
+    response.Clear();
+    service.ExecuteStatement(nullptr, &request, &response, nullptr);
+    EXPECT_EQ(1U, response.request_id());
+    return static_cast<ResultType>(response.result());
+  }
+
+  ResultType Prepare(networking::ShardService &service,
+                     const int64_t transaction_id) {
+    networking::ShardTransactionRequest request;
+    networking::ShardTransactionResponse response;
+    request.set_transaction_id(transaction_id);
+    service.PrepareTransaction(nullptr, &request, &response, nullptr);
+    return static_cast<ResultType>(response.result());
+  }
+
+  ResultType Finish(networking::ShardService &service,
+                    const int64_t transaction_id, const bool commit) {
+    networking::ShardTransactionRequest request;
+    networking::ShardTransactionResponse response;
+    request.set_transaction_id(transaction_id);
+    request.set_commit(commit);
+    service.FinishTransaction(nullptr, &request, &response, nullptr);
+    return static_cast<ResultType>(response.result());
+  }
+};
+
+TEST_F(ShardServiceTests, ExecuteStatementTest) {
+  networking::ShardService service;
+  networking::ShardStatementResponse response;
+
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute(service, 0, "INSERT INTO orders VALUES (1, 10), (2, 20);",
+                    response));
+  EXPECT_EQ(2, response.rows_changed());
+
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute(service, 0, "SELECT id, total FROM orders ORDER BY id;",
+                    response));
+  ASSERT_EQ(2, response.column_size());
+  EXPECT_EQ("id", response.column(0).name());
+  ASSERT_EQ(2, response.row_size());
+  EXPECT_EQ("2", response.row(1).value(0));
+  EXPECT_EQ("20", response.row(1).value(1));
+
+  EXPECT_NE(ResultType::SUCCESS,
+            Execute(service, 0, "SELECT * FROM customers;", response));
+  EXPECT_EQ(0U, service.GetSessionCount());
+}
+
+TEST_F(ShardServiceTests, TwoPhaseCommitTest) {
+  networking::ShardService service;
+  networking::ShardStatementResponse response;
+
+  // The statements of a distributed transaction are visible once it commits
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute(service, 7, "INSERT INTO orders VALUES (3, 30);",
+                    response));
+  EXPECT_EQ(1U, service.GetSessionCount());
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute(service, 0, "SELECT * FROM orders;", response));
+  EXPECT_EQ(0, response.row_size());
+  EXPECT_EQ(ResultType::SUCCESS, Prepare(service, 7));
+  EXPECT_EQ(ResultType::SUCCESS, Finish(service, 7, true));
+  EXPECT_EQ(0U, service.GetSessionCount());
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute(service, 0, "SELECT * FROM orders;", response));
+  EXPECT_EQ(1, response.row_size());
+
+  // An aborted one leaves nothing behind
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute(service, 8, "INSERT INTO orders VALUES (4, 40);",
+                    response));
+  EXPECT_EQ(ResultType::SUCCESS, Finish(service, 8, false));
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute(service, 0, "SELECT * FROM orders;", response));
+  EXPECT_EQ(1, response.row_size());
+
+  // A transaction that is unknown or failed cannot prepare or commit
+  EXPECT_EQ(ResultType::ABORTED, Prepare(service, 9));
+  EXPECT_EQ(ResultType::ABORTED, Finish(service, 9, true));
+  EXPECT_NE(ResultType::SUCCESS,
+            Execute(service, 10, "INSERT INTO orders VALUES (3, 30);",
+                    response));
+  EXPECT_EQ(ResultType::ABORTED, Prepare(service, 10));
+  EXPECT_EQ(0U, service.GetSessionCount());
+}
+
+}  // End test namespace
+}  // End peloton namespace
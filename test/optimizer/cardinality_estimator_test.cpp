@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_estimator_test.cpp
+//
+// Identification: test/optimizer/cardinality_estimator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/operator_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/stats/cardinality_estimator.h"
+#include "optimizer/stats/column_stats.h"
+#include "optimizer/stats/table_stats.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class CardinalityEstimatorTests : public PelotonTest {};
+
+namespace {
+
+const size_t kNumRows = 1000;
+
+// Column 0 is spread evenly over 0 to 1000, half the tuples of column 1 are
+// 1 and the rest are spread over 10 other values
+std::shared_ptr<TableStats> CreateTableStats() {
+  std::vector<double> bounds;
+  for (int bound = 10; bound < 1000; bound += 10) {
+    bounds.push_back(bound);
+  }
+  std::vector<std::shared_ptr<ColumnStats>> column_stats;
+  column_stats.emplace_back(new ColumnStats(0, 0, 0, "a", false, kNumRows,
+                                            kNumRows, 0, {}, {}, bounds));
+  column_stats.emplace_back(new ColumnStats(0, 0, 1, "b", false, kNumRows, 11,
+                                            0, {1}, {500}, {}));
+  return std::make_shared<TableStats>(kNumRows, column_stats);
+}
+
+expression::AbstractExpression *Compare(ExpressionType type, oid_t column_id,
+                                        int value) {
+  auto column =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, column_id);
+  column->SetBoundOid(0, 0, column_id);
+  return new expression::ComparisonExpression(
+      type, column, new expression::ConstantValueExpression(
+                        type::ValueFactory::GetIntegerValue(value)));
+}
+
+}  // namespace
+
+TEST_F(CardinalityEstimatorTests, RangeTest) {
+  auto table_stats = CreateTableStats();
+
+  // The bounds of the range are estimated together, not as independent
+  // predicates
+  std::unique_ptr<expression::AbstractExpression> greater(
+      Compare(ExpressionType::COMPARE_GREATERTHAN, 0, 100));
+  std::unique_ptr<expression::AbstractExpression> less(
+      Compare(ExpressionType::COMPARE_LESSTHAN, 0, 200));
+  double greater_selectivity =
+      CardinalityEstimator::EstimateSelectivity(table_stats, greater.get());
+  double less_selectivity =
+      CardinalityEstimator::EstimateSelectivity(table_stats, less.get());
+  EXPECT_NEAR(0.9, greater_selectivity, 0.02);
+  EXPECT_NEAR(0.2, less_selectivity, 0.02);
+
+  std::vector<const expression::AbstractExpression *> conjuncts(
+      {greater.get(), less.get()});
+  double range_selectivity =
+      CardinalityEstimator::EstimateSelectivity(table_stats, conjuncts);
+  EXPECT_NEAR(0.1, range_selectivity, 0.02);
+  EXPECT_LT(range_selectivity, greater_selectivity * less_selectivity);
+}
+
+TEST_F(CardinalityEstimatorTests, SkewedEqualityTest) {
+  auto table_stats = CreateTableStats();
+
+  // The most common value is estimated by its frequency, the others share
+  // what is left
+  std::unique_ptr<expression::AbstractExpression> common(
+      Compare(ExpressionType::COMPARE_EQUAL, 1, 1));
+  std::unique_ptr<expression::AbstractExpression> rare(
+      Compare(ExpressionType::COMPARE_EQUAL, 1, 2));
+  EXPECT_NEAR(0.5, CardinalityEstimator::EstimateSelectivity(table_stats,
+                                                             common.get()),
+              0.01);
+  EXPECT_NEAR(0.05, CardinalityEstimator::EstimateSelectivity(table_stats,
+                                                              rare.get()),
+              0.01);
+}
+
+TEST_F(CardinalityEstimatorTests, ConjunctionTest) {
+  auto table_stats = CreateTableStats();
+  std::unique_ptr<expression::AbstractExpression> less(
+      Compare(ExpressionType::COMPARE_LESSTHAN, 0, 200));
+  std::unique_ptr<expression::AbstractExpression> common(
+      Compare(ExpressionType::COMPARE_EQUAL, 1, 1));
+  double less_selectivity =
+      CardinalityEstimator::EstimateSelectivity(table_stats, less.get());
+  double common_selectivity =
+      CardinalityEstimator::EstimateSelectivity(table_stats, common.get());
+
+  // The columns are not assumed to be independent
+  std::vector<const expression::AbstractExpression *> conjuncts(
+      {less.get(), common.get()});
+  double selectivity =
+      CardinalityEstimator::EstimateSelectivity(table_stats, conjuncts);
+  EXPECT_GT(selectivity, less_selectivity * common_selectivity);
+  EXPECT_LT(selectivity, std::min(less_selectivity, common_selectivity));
+}
+
+TEST_F(CardinalityEstimatorTests, DisjunctionAndNegationTest) {
+  auto table_stats = CreateTableStats();
+  double less_selectivity = CardinalityEstimator::EstimateSelectivity(
+      table_stats, std::unique_ptr<expression::AbstractExpression>(
+                       Compare(ExpressionType::COMPARE_LESSTHAN, 0, 200))
+                       .get());
+
+  std::unique_ptr<expression::AbstractExpression> disjunction(
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_OR,
+          Compare(ExpressionType::COMPARE_LESSTHAN, 0, 200),
+          Compare(ExpressionType::COMPARE_EQUAL, 1, 1)));
+  EXPECT_NEAR(less_selectivity + 0.5 - less_selectivity * 0.5,
+              CardinalityEstimator::EstimateSelectivity(table_stats,
+                                                        disjunction.get()),
+              0.01);
+
+  std::unique_ptr<expression::AbstractExpression> negation(
+      new expression::OperatorExpression(
+          ExpressionType::OPERATOR_NOT, type::TypeId::BOOLEAN,
+          Compare(ExpressionType::COMPARE_EQUAL, 1, 2), nullptr));
+  EXPECT_NEAR(0.95, CardinalityEstimator::EstimateSelectivity(table_stats,
+                                                              negation.get()),
+              0.01);
+}
+
+TEST_F(CardinalityEstimatorTests, JoinSelectivityTest) {
+  // Every value of the side with fewer distinct values matches, and a side
+  // has no more distinct values than rows
+  EXPECT_DOUBLE_EQ(0.01, CardinalityEstimator::EstimateJoinSelectivity(
+                             100, 1000, 10, 5));
+  EXPECT_DOUBLE_EQ(0.01, CardinalityEstimator::EstimateJoinSelectivity(
+                             100, 1000, 10, 1000));
+  EXPECT_DOUBLE_EQ(1, CardinalityEstimator::EstimateJoinSelectivity(0, 0, 0,
+                                                                    0));
+}
+
+}  // namespace test
+}  // namespace peloton
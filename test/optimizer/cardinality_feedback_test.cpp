@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// cardinality_feedback_test.cpp
+//
+// Identification: test/optimizer/cardinality_feedback_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "optimizer/stats/cardinality_feedback.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class CardinalityFeedbackTests : public PelotonTest {
+ protected:
+  virtual void TearDown() override {
+    CardinalityFeedback::GetInstance().Clear();
+    PelotonTest::TearDown();
+  }
+};
+
+namespace {
+
+const oid_t kTableId = 1;
+
+expression::AbstractExpression *Compare(ExpressionType type, oid_t column_id,
+                                        int value) {
+  auto column =
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, column_id);
+  column->SetBoundOid(0, kTableId, column_id);
+  return new expression::ComparisonExpression(
+      type, column, new expression::ConstantValueExpression(
+                        type::ValueFactory::GetIntegerValue(value)));
+}
+
+}  // namespace
+
+TEST_F(CardinalityFeedbackTests, SignatureTest) {
+  std::unique_ptr<expression::AbstractExpression> less(
+      Compare(ExpressionType::COMPARE_LESSTHAN, 0, 10));
+  std::unique_ptr<expression::AbstractExpression> equal(
+      Compare(ExpressionType::COMPARE_EQUAL, 1, 10));
+  std::unique_ptr<expression::AbstractExpression> other_equal(
+      Compare(ExpressionType::COMPARE_EQUAL, 1, 20));
+
+  // The order of the conjuncts does not matter, their values do
+  EXPECT_EQ(CardinalityFeedback::GetSignature({less.get(), equal.get()}),
+            CardinalityFeedback::GetSignature({equal.get(), less.get()}));
+  EXPECT_NE(CardinalityFeedback::GetSignature({less.get(), equal.get()}),
+            CardinalityFeedback::GetSignature({less.get(), other_equal.get()}));
+}
+
+TEST_F(CardinalityFeedbackTests, RecordTest) {
+  auto &feedback = CardinalityFeedback::GetInstance();
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND,
+          Compare(ExpressionType::COMPARE_LESSTHAN, 0, 10),
+          Compare(ExpressionType::COMPARE_EQUAL, 1, 10)));
+  std::vector<const expression::AbstractExpression *> conjuncts(
+      {predicate->GetChild(1), predicate->GetChild(0)});
+
+  double selectivity;
+  EXPECT_FALSE(feedback.GetSelectivity(kTableId, conjuncts, selectivity));
+
+  // The first observation is taken as is, later ones are averaged in
+  EXPECT_FALSE(feedback.Record(kTableId, predicate.get(), 10, 100));
+  EXPECT_TRUE(feedback.GetSelectivity(kTableId, conjuncts, selectivity));
+  EXPECT_DOUBLE_EQ(0.1, selectivity);
+  EXPECT_FALSE(feedback.Record(kTableId, predicate.get(), 30, 100));
+  EXPECT_TRUE(feedback.GetSelectivity(kTableId, predicate.get(), selectivity));
+  EXPECT_DOUBLE_EQ(0.2, selectivity);
+
+  // Another table has its own feedback
+  EXPECT_FALSE(feedback.GetSelectivity(kTableId + 1, conjuncts, selectivity));
+  EXPECT_EQ(1U, feedback.GetCount());
+}
+
+TEST_F(CardinalityFeedbackTests, EstimateErrorTest) {
+  auto &feedback = CardinalityFeedback::GetInstance();
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      Compare(ExpressionType::COMPARE_LESSTHAN, 0, 10));
+  std::vector<const expression::AbstractExpression *> conjuncts(
+      {predicate.get()});
+
+  // An observation close to the estimate keeps the cached plans
+  feedback.SetEstimate(kTableId, conjuncts, 0.1);
+  EXPECT_FALSE(feedback.Record(kTableId, predicate.get(), 20, 100));
+
+  // One that is far off drops them, once
+  feedback.Clear();
+  feedback.SetEstimate(kTableId, conjuncts, 0.001);
+  EXPECT_TRUE(feedback.Record(kTableId, predicate.get(), 50, 100));
+  EXPECT_FALSE(feedback.Record(kTableId, predicate.get(), 50, 100));
+}
+
+}  // namespace test
+}  // namespace peloton
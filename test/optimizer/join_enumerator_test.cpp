@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// join_enumerator_test.cpp
+//
+// Identification: test/optimizer/join_enumerator_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+
+#include "common/harness.h"
+
+#include "binder/bind_node_visitor.h"
+#include "catalog/catalog.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/join_enumerator.h"
+#include "optimizer/operator_expression.h"
+#include "optimizer/operators.h"
+#include "optimizer/query_to_operator_transformer.h"
+#include "parser/postgresparser.h"
+#include "sql/testing_sql_util.h"
+
+namespace peloton {
+namespace test {
+
+using namespace optimizer;
+
+class JoinEnumeratorTests : public PelotonTest {
+ protected:
+  virtual void SetUp() override {
+    PelotonTest::SetUp();
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+
+    // test and test2 have 20 tuples, test3 only 2
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE test2(a2 INT PRIMARY KEY, b2 INT, c2 INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE test3(a3 INT PRIMARY KEY, b3 INT, c3 INT);");
+    for (int i = 0; i < 20; i++) {
+      std::string values = " VALUES (" + std::to_string(i) + ", 1, 1);";
+      TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test" + values);
+      TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test2" + values);
+      if (i < 2) TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test3" + values);
+    }
+  }
+
+  virtual void TearDown() override {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+
+    PelotonTest::TearDown();
+  }
+
+  // Transform the query into operators, and return them before and after the
+  // joins are reordered
+  std::shared_ptr<OperatorExpression> ReorderJoins(
+      std::string query, std::shared_ptr<OperatorExpression> &initial) {
+    auto &peloton_parser = parser::PostgresParser::GetInstance();
+    stmt_list_ = peloton_parser.BuildParseTree(query);
+    auto stmt =
+        static_cast<parser::SelectStatement *>(stmt_list_->GetStatement(0));
+
+    binder::BindNodeVisitor binder;
+    binder.BindNameToNode(stmt);
+
+    QueryToOperatorTransformer transformer;
+    initial = transformer.ConvertToOpExpression(stmt);
+    JoinEnumerator enumerator(stmt);
+    return enumerator.ReorderJoins(initial);
+  }
+
+  std::string GetTableAlias(const std::shared_ptr<OperatorExpression> &expr) {
+    EXPECT_EQ(OpType::Get, expr->Op().type());
+    return expr->Op().As<LogicalGet>()->table_alias;
+  }
+
+  std::unique_ptr<parser::SQLStatementList> stmt_list_;
+};
+
+TEST_F(JoinEnumeratorTests, AvoidCrossProductTest) {
+  // The tables are listed in an order that joins test and test2 without a
+  // predicate
+  std::shared_ptr<OperatorExpression> initial;
+  auto op_expr = ReorderJoins(
+      "SELECT test.b FROM test, test2, test3 "
+      "WHERE test.a = test3.a3 AND test2.a2 = test3.a3",
+      initial);
+  EXPECT_EQ(nullptr, initial->Children()[0]
+                         ->Op()
+                         .As<LogicalInnerJoin>()
+                         ->join_predicate);
+
+  // Both joins have a predicate
+  ASSERT_EQ(OpType::InnerJoin, op_expr->Op().type());
+  EXPECT_NE(nullptr, op_expr->Op().As<LogicalInnerJoin>()->join_predicate);
+  auto children = op_expr->Children();
+  ASSERT_EQ(2U, children.size());
+  auto &lower_join =
+      children[0]->Op().type() == OpType::InnerJoin ? children[0] : children[1];
+  ASSERT_EQ(OpType::InnerJoin, lower_join->Op().type());
+  EXPECT_NE(nullptr, lower_join->Op().As<LogicalInnerJoin>()->join_predicate);
+}
+
+TEST_F(JoinEnumeratorTests, SmallestJoinFirstTest) {
+  // Joining test with the small test3 first gives the smallest intermediate
+  // result, and the smaller side of every join is the right one
+  std::shared_ptr<OperatorExpression> initial;
+  auto op_expr = ReorderJoins(
+      "SELECT test.b FROM test, test2, test3 "
+      "WHERE test.a = test2.a2 AND test.a = test3.a3",
+      initial);
+
+  ASSERT_EQ(OpType::InnerJoin, op_expr->Op().type());
+  auto children = op_expr->Children();
+  EXPECT_EQ("test2", GetTableAlias(children[0]));
+  ASSERT_EQ(OpType::InnerJoin, children[1]->Op().type());
+  auto lower_children = children[1]->Children();
+  EXPECT_EQ("test", GetTableAlias(lower_children[0]));
+  EXPECT_EQ("test3", GetTableAlias(lower_children[1]));
+}
+
+TEST_F(JoinEnumeratorTests, SelectStarTest) {
+  // The columns of SELECT * are in the order of the joined tables
+  std::shared_ptr<OperatorExpression> initial;
+  auto op_expr = ReorderJoins(
+      "SELECT * FROM test, test2, test3 "
+      "WHERE test.a = test3.a3 AND test2.a2 = test3.a3",
+      initial);
+  EXPECT_EQ(initial, op_expr);
+}
+
+}  // namespace test
+}  // namespace peloton
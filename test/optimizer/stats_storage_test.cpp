@@ -26,6 +26,7 @@
 #include "catalog/column_stats_catalog.h"
 #include "executor/testing_executor_util.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
 
 namespace peloton {
 namespace test {
@@ -253,5 +254,35 @@ TEST_F(StatsStorageTests, GetTableStatsTest) {
   EXPECT_EQ(table_stats->num_rows, tuple_count);
 }
 
+TEST_F(StatsStorageTests, AnalyzeStatsForStaleTablesTest) {
+  auto database = TestingExecutorUtil::InitializeDatabase("stale_db");
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  storage::DataTable *data_table =
+      TestingExecutorUtil::CreateTable(tuple_per_tilegroup, false);
+  TestingExecutorUtil::PopulateTable(data_table, tuple_count, false, false,
+                                     true, txn);
+  database->AddTable(data_table);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(static_cast<size_t>(tuple_count),
+            data_table->GetModifiedTupleCount());
+
+  StatsStorage *stats_storage = StatsStorage::GetInstance();
+  EXPECT_EQ(ResultType::NOOP, stats_storage->AnalyzeStatsForStaleTables());
+
+  // The inserted tuples are more than the threshold
+  FLAGS_auto_analyze_threshold = tuple_count / 2;
+  FLAGS_auto_analyze_scale_factor = 0;
+  EXPECT_EQ(ResultType::SUCCESS, stats_storage->AnalyzeStatsForStaleTables());
+  EXPECT_EQ(0U, data_table->GetModifiedTupleCount());
+  auto table_stats = stats_storage->GetTableStats(
+      data_table->GetDatabaseOid(), data_table->GetOid());
+  EXPECT_EQ(static_cast<size_t>(tuple_count), table_stats->num_rows);
+
+  FLAGS_auto_analyze_threshold = 0;
+  FLAGS_auto_analyze_scale_factor = 0.1;
+  TestingExecutorUtil::DeleteDatabase("stale_db");
+}
+
 } /* namespace test */
 } /* namespace peloton */
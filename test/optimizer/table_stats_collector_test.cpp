@@ -83,6 +83,42 @@ TEST_F(TableStatsCollectorTests, SingleColumnTableTest) {
   txn_manager.CommitTransaction(txn);
 }
 
+TEST_F(TableStatsCollectorTests, SampleTableTest) {
+  // Boostrap database
+  auto catalog = catalog::Catalog::GetInstance();
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE test(id integer);");
+  int nrow = 100;
+  for (int i = 0; i < nrow; i++) {
+    std::ostringstream os;
+    os << "INSERT INTO test VALUES (" << i << ");";
+    TestingSQLUtil::ExecuteSQLQuery(os.str());
+  }
+
+  // Only a fifth of the tuples are collected, but all of them are counted
+  auto table = catalog->GetTableWithName(DEFAULT_DB_NAME, "test");
+  TableStatsCollector stats{table};
+  int sample_count = nrow / 5;
+  stats.CollectColumnStats(sample_count);
+
+  EXPECT_EQ(stats.GetActiveTupleCount(), nrow);
+  EXPECT_DOUBLE_EQ(stats.GetSampleRatio(), 5);
+  auto column_stats_collector = stats.GetColumnStats(0);
+  EXPECT_EQ(column_stats_collector->GetFracNull(), 0);
+  double cardinality_error = column_stats_collector->GetCardinalityError();
+  EXPECT_LE(column_stats_collector->GetCardinality(),
+            sample_count * (1 + cardinality_error));
+
+  // Free the database
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
 // Table with four columns with types Integer, Varchar, Decimal and Timestamp
 // BOOLEAN insertion seems not supported.
 TEST_F(TableStatsCollectorTests, MultiColumnTableTest) {
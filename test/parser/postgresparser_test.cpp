@@ -20,6 +20,7 @@
 #include "expression/operator_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "parser/postgresparser.h"
+#include "type/value_factory.h"
 
 namespace peloton {
 namespace test {
@@ -650,6 +651,71 @@ TEST_F(PostgresParserTests, CreateTest) {
   delete stmt_list;
 }
 
+TEST_F(PostgresParserTests, AppendOnlyTableTest) {
+  auto parser = parser::PostgresParser::GetInstance();
+  std::vector<std::string> queries = {
+      "CREATE TABLE events (id INT, payload INT) WITH (append_only);",
+      "CREATE TABLE events (id INT, payload INT) WITH (append_only = true);",
+      "CREATE TABLE events (id INT, payload INT) WITH (append_only = 1);"};
+  for (auto &query : queries) {
+    auto stmt_list = parser.BuildParseTree(query);
+    EXPECT_TRUE(stmt_list->is_valid);
+    auto create_stmt =
+        (parser::CreateStatement *)stmt_list->GetStatement(0);
+    EXPECT_TRUE(create_stmt->append_only);
+  }
+
+  auto stmt_list = parser.BuildParseTree(
+      "CREATE TABLE events (id INT) WITH (append_only = off);");
+  EXPECT_TRUE(stmt_list->is_valid);
+  EXPECT_FALSE(
+      ((parser::CreateStatement *)stmt_list->GetStatement(0))->append_only);
+
+  stmt_list = parser.BuildParseTree("CREATE TABLE events (id INT);");
+  EXPECT_TRUE(stmt_list->is_valid);
+  EXPECT_FALSE(
+      ((parser::CreateStatement *)stmt_list->GetStatement(0))->append_only);
+}
+
+TEST_F(PostgresParserTests, PartitionedTableTest) {
+  auto parser = parser::PostgresParser::GetInstance();
+  auto stmt_list = parser.BuildParseTree(
+      "CREATE TABLE events (id INT, stamp INT) WITH (partition_column = stamp, "
+      "range_partitions = '0, 100,200');");
+  EXPECT_TRUE(stmt_list->is_valid);
+  auto create_stmt = (parser::CreateStatement *)stmt_list->GetStatement(0);
+  EXPECT_EQ("stamp", create_stmt->partition_column);
+  EXPECT_EQ(0U, create_stmt->hash_partition_count);
+  EXPECT_EQ(std::vector<std::string>({"0", "100", "200"}),
+            create_stmt->range_partition_bounds);
+
+  stmt_list = parser.BuildParseTree(
+      "CREATE TABLE events (id INT) WITH (partition_column = id, "
+      "hash_partitions = 4);");
+  EXPECT_TRUE(stmt_list->is_valid);
+  create_stmt = (parser::CreateStatement *)stmt_list->GetStatement(0);
+  EXPECT_EQ("id", create_stmt->partition_column);
+  EXPECT_EQ(4U, create_stmt->hash_partition_count);
+  EXPECT_TRUE(create_stmt->range_partition_bounds.empty());
+
+  stmt_list = parser.BuildParseTree("CREATE TABLE events (id INT);");
+  EXPECT_TRUE(stmt_list->is_valid);
+  EXPECT_TRUE(((parser::CreateStatement *)stmt_list->GetStatement(0))
+                  ->partition_column.empty());
+
+  // a partitioned table needs its column and one kind of partitions
+  std::vector<std::string> invalid_queries = {
+      "CREATE TABLE events (id INT) WITH (partition_column = id);",
+      "CREATE TABLE events (id INT) WITH (hash_partitions = 4);",
+      "CREATE TABLE events (id INT) WITH (partition_column = id, "
+      "hash_partitions = 0);",
+      "CREATE TABLE events (id INT) WITH (partition_column = id, "
+      "hash_partitions = 4, range_partitions = '0');"};
+  for (auto &query : invalid_queries) {
+    EXPECT_THROW(parser.BuildParseTree(query), Exception);
+  }
+}
+
 TEST_F(PostgresParserTests, TransactionTest) {
   auto parser = parser::PostgresParser::GetInstance();
   auto stmt_list = parser.BuildParseTree("BEGIN TRANSACTION;").release();
@@ -657,6 +723,7 @@ TEST_F(PostgresParserTests, TransactionTest) {
       (parser::TransactionStatement *)stmt_list->GetStatement(0);
   EXPECT_TRUE(stmt_list->is_valid);
   EXPECT_EQ(parser::TransactionStatement::kBegin, transac_stmt->type);
+  EXPECT_FALSE(transac_stmt->read_only);
   delete stmt_list;
 
   stmt_list = parser.BuildParseTree("BEGIN;").release();
@@ -665,6 +732,40 @@ TEST_F(PostgresParserTests, TransactionTest) {
   EXPECT_EQ(parser::TransactionStatement::kBegin, transac_stmt->type);
   delete stmt_list;
 
+  stmt_list = parser.BuildParseTree("BEGIN READ ONLY;").release();
+  transac_stmt = (parser::TransactionStatement *)stmt_list->GetStatement(0);
+  EXPECT_TRUE(stmt_list->is_valid);
+  EXPECT_EQ(parser::TransactionStatement::kBegin, transac_stmt->type);
+  EXPECT_TRUE(transac_stmt->read_only);
+  delete stmt_list;
+
+  stmt_list = parser.BuildParseTree("BEGIN TRANSACTION READ WRITE;").release();
+  transac_stmt = (parser::TransactionStatement *)stmt_list->GetStatement(0);
+  EXPECT_TRUE(stmt_list->is_valid);
+  EXPECT_FALSE(transac_stmt->read_only);
+  delete stmt_list;
+
+  stmt_list = parser.BuildParseTree("BEGIN;").release();
+  transac_stmt = (parser::TransactionStatement *)stmt_list->GetStatement(0);
+  EXPECT_EQ(IsolationLevelType::INVALID, transac_stmt->isolation);
+  delete stmt_list;
+
+  stmt_list =
+      parser.BuildParseTree("BEGIN ISOLATION LEVEL REPEATABLE READ;").release();
+  transac_stmt = (parser::TransactionStatement *)stmt_list->GetStatement(0);
+  EXPECT_TRUE(stmt_list->is_valid);
+  EXPECT_EQ(IsolationLevelType::SNAPSHOT, transac_stmt->isolation);
+  delete stmt_list;
+
+  stmt_list =
+      parser.BuildParseTree("BEGIN ISOLATION LEVEL SERIALIZABLE READ ONLY;")
+          .release();
+  transac_stmt = (parser::TransactionStatement *)stmt_list->GetStatement(0);
+  EXPECT_TRUE(stmt_list->is_valid);
+  EXPECT_EQ(IsolationLevelType::SERIALIZABLE, transac_stmt->isolation);
+  EXPECT_TRUE(transac_stmt->read_only);
+  delete stmt_list;
+
   stmt_list = parser.BuildParseTree("COMMIT TRANSACTION;").release();
   transac_stmt = (parser::TransactionStatement *)stmt_list->GetStatement(0);
   EXPECT_TRUE(stmt_list->is_valid);
@@ -699,6 +800,82 @@ TEST_F(PostgresParserTests, CreateIndexTest) {
   delete stmt_list;
 }
 
+TEST_F(PostgresParserTests, CreateHashIndexTest) {
+  std::string query = "CREATE INDEX IDX_CUSTOMER ON customer USING HASH (C_ID);";
+
+  auto parser = parser::PostgresParser::GetInstance();
+  auto stmt_list = parser.BuildParseTree(query).release();
+  EXPECT_TRUE(stmt_list->is_valid);
+  auto create_stmt = (parser::CreateStatement *)stmt_list->GetStatement(0);
+
+  EXPECT_EQ(parser::CreateStatement::kIndex, create_stmt->type);
+  EXPECT_EQ(IndexType::HASH, create_stmt->index_type);
+  EXPECT_FALSE(create_stmt->unique);
+  EXPECT_EQ("c_id", std::string(create_stmt->index_attrs->at(0)));
+
+  delete stmt_list;
+
+  // Other methods build a BwTree
+  query = "CREATE INDEX IDX_CUSTOMER ON customer (C_ID);";
+  stmt_list = parser.BuildParseTree(query).release();
+  EXPECT_TRUE(stmt_list->is_valid);
+  create_stmt = (parser::CreateStatement *)stmt_list->GetStatement(0);
+  EXPECT_EQ(IndexType::BWTREE, create_stmt->index_type);
+
+  delete stmt_list;
+}
+
+TEST_F(PostgresParserTests, PartialIndexTest) {
+  std::string query =
+      "CREATE INDEX IDX_PENDING ON orders (O_ID) WHERE O_STATUS = 1;";
+
+  auto parser = parser::PostgresParser::GetInstance();
+  auto stmt_list = parser.BuildParseTree(query).release();
+  EXPECT_TRUE(stmt_list->is_valid);
+  auto create_stmt = (parser::CreateStatement *)stmt_list->GetStatement(0);
+
+  EXPECT_EQ(parser::CreateStatement::kIndex, create_stmt->type);
+  EXPECT_EQ("o_id", std::string(create_stmt->index_attrs->at(0)));
+  auto predicate = create_stmt->index_predicate;
+  EXPECT_NE(nullptr, predicate);
+  EXPECT_EQ(ExpressionType::COMPARE_EQUAL, predicate->GetExpressionType());
+  EXPECT_EQ("o_status",
+            ((expression::TupleValueExpression *)predicate->GetChild(0))
+                ->GetColumnName());
+
+  delete stmt_list;
+}
+
+TEST_F(PostgresParserTests, MaterializedViewTest) {
+  std::string query =
+      "CREATE MATERIALIZED VIEW order_totals AS "
+      "SELECT O_W_ID, COUNT(*), SUM(O_OL_CNT) FROM oorder GROUP BY O_W_ID;";
+
+  auto parser = parser::PostgresParser::GetInstance();
+  auto stmt_list = parser.BuildParseTree(query).release();
+  EXPECT_TRUE(stmt_list->is_valid);
+  auto create_stmt = (parser::CreateStatement *)stmt_list->GetStatement(0);
+
+  EXPECT_EQ(parser::CreateStatement::kMaterializedView, create_stmt->type);
+  EXPECT_EQ("order_totals",
+            std::string(create_stmt->table_info_->table_name));
+  auto view_query = create_stmt->view_query;
+  EXPECT_NE(nullptr, view_query);
+  EXPECT_EQ(3U, view_query->select_list->size());
+  EXPECT_EQ(1U, view_query->group_by->columns->size());
+
+  delete stmt_list;
+
+  query = "DROP MATERIALIZED VIEW order_totals;";
+  stmt_list = parser.BuildParseTree(query).release();
+  EXPECT_TRUE(stmt_list->is_valid);
+  auto drop_stmt = (parser::DropStatement *)stmt_list->GetStatement(0);
+  EXPECT_EQ(parser::DropStatement::kView, drop_stmt->type);
+  EXPECT_EQ("order_totals", std::string(drop_stmt->table_info_->table_name));
+
+  delete stmt_list;
+}
+
 TEST_F(PostgresParserTests, InsertIntoSelectTest) {
   std::vector<std::string> queries;
 
@@ -949,6 +1126,41 @@ TEST_F(PostgresParserTests, CaseTest) {
   delete stmt_list;
 }
 
+TEST_F(PostgresParserTests, ParameterizeLiteralsTest) {
+  std::string query;
+  std::vector<type::Value> params;
+
+  // The literals compared with columns, but not the one of the LIMIT
+  EXPECT_TRUE(parser::PostgresParser::ParameterizeLiterals(
+      "SELECT a FROM foo WHERE b = 2 AND (c > -1.5 OR 'x''y' <> d) LIMIT 3;",
+      query, params));
+  EXPECT_EQ("SELECT a FROM foo WHERE b = $1 AND (c > $2 OR $3 <> d) LIMIT 3;",
+            query);
+  ASSERT_EQ(3U, params.size());
+  EXPECT_TRUE(params[0].CompareEquals(type::ValueFactory::GetIntegerValue(2)));
+  EXPECT_TRUE(
+      params[1].CompareEquals(type::ValueFactory::GetDecimalValue(-1.5)));
+  EXPECT_TRUE(
+      params[2].CompareEquals(type::ValueFactory::GetVarcharValue("x'y")));
+
+  // The values of a single row
+  EXPECT_TRUE(parser::PostgresParser::ParameterizeLiterals(
+      "INSERT INTO foo VALUES (1, - 2, 'abc');", query, params));
+  EXPECT_EQ("INSERT INTO foo VALUES ($1, $2, $3);", query);
+  ASSERT_EQ(3U, params.size());
+  EXPECT_TRUE(params[1].CompareEquals(type::ValueFactory::GetIntegerValue(-2)));
+
+  // Nothing to replace
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeLiterals(
+      "INSERT INTO foo VALUES (1, 2), (3, 4);", query, params));
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeLiterals(
+      "SELECT a FROM foo WHERE b = $1;", query, params));
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeLiterals(
+      "SELECT a + 1 FROM foo;", query, params));
+  EXPECT_FALSE(parser::PostgresParser::ParameterizeLiterals(
+      "CREATE TABLE foo (a INT);", query, params));
+}
+
 
 }  // End test namespace
 }  // End peloton namespace
@@ -0,0 +1,446 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// codegen_compile_benchmark_test.cpp
+//
+// Identification: test/performance/codegen_compile_benchmark_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "codegen/testing_codegen_util.h"
+
+#include "codegen/buffering_consumer.h"
+#include "codegen/query.h"
+#include "codegen/query_compiler.h"
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "executor/executor_context.h"
+#include "executor/plan_executor.h"
+#include "expression/conjunction_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/aggregate_plan.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "planner/order_by_plan.h"
+#include "planner/seq_scan_plan.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Codegen Compile Benchmark
+//===--------------------------------------------------------------------===//
+
+/**
+ * Compiles a corpus of plans of increasing size and runs them compiled and
+ * on the executors at growing table sizes, to find where compiling pays off.
+ *
+ * Every plan is compiled and run as often as the repetitions, the medians
+ * are reported. The compilation is broken down in its phases, the execution
+ * of the compiled query and the one of the executors both write the results
+ * as the text columns of the wire protocol. A plan breaks even after
+ * compile / (interpreter - codegen) runs of the compiled query, and a single
+ * run pays off from the smallest size at which compile + codegen is faster
+ * than the interpreter, which is what codegen_min_rows compares against.
+ *
+ * The environment sets the sweep and the output:
+ *   PELOTON_BENCHMARK_MAX_ROWS     largest size of the tables, the sweep
+ *                                  grows tenfold from 1000 (default: 100000)
+ *   PELOTON_BENCHMARK_REPETITIONS  runs of every plan and size (default: 5)
+ *   PELOTON_BENCHMARK_OUT          JSON file
+ *                                  (default: codegen_compile_benchmark.json)
+ */
+class CodegenCompileBenchmarkTest : public PelotonCodeGenTest {
+ public:
+  typedef std::unique_ptr<const expression::AbstractExpression> ExprPtr;
+
+  typedef std::function<std::unique_ptr<planner::AbstractPlan>()>
+      PlanConstructor;
+
+  struct PlanConfig {
+    std::string name;
+
+    // The number of plan nodes and expression nodes
+    size_t operator_count;
+
+    PlanConstructor Construct;
+  };
+
+  struct Result {
+    std::string name;
+    size_t operator_count;
+    size_t num_rows;
+    size_t estimated_rows;
+    size_t num_tuples;
+    uint64_t num_functions;
+    uint64_t num_instructions;
+
+    // Medians over the repetitions, in ms
+    double setup_ms;
+    double ir_gen_ms;
+    double opt_ms;
+    double jit_ms;
+    double compile_ms;
+    double codegen_ms;
+    double interpreter_ms;
+
+    // Runs of the compiled query until the compilation paid off, 0 if it
+    // never does
+    double break_even_runs;
+  };
+
+  CodegenCompileBenchmarkTest()
+      : max_rows_(GetEnv("PELOTON_BENCHMARK_MAX_ROWS", 100000)),
+        repetitions_(GetEnv("PELOTON_BENCHMARK_REPETITIONS", 5)) {
+    const char *output_path = std::getenv("PELOTON_BENCHMARK_OUT");
+    output_path_ = output_path != nullptr ? output_path
+                                          : "codegen_compile_benchmark.json";
+    repetitions_ = std::max<size_t>(repetitions_, 1);
+  }
+
+  // 1000, 10000, ... up to the largest size
+  std::vector<size_t> GetRowCounts() const {
+    std::vector<size_t> row_counts;
+    for (size_t num_rows = 1000; num_rows < max_rows_; num_rows *= 10) {
+      row_counts.push_back(num_rows);
+    }
+    row_counts.push_back(max_rows_);
+    return row_counts;
+  }
+
+  // Scans of the first table with a conjunction of the given number of
+  // comparisons, which all rows pass
+  PlanConfig FilterPlan(size_t num_predicates) {
+    PlanConfig config;
+    config.name = "filter_" + std::to_string(num_predicates);
+    config.operator_count = 1 + 3 * num_predicates + (num_predicates - 1);
+    config.Construct = [this, num_predicates]() {
+      expression::AbstractExpression *predicate = nullptr;
+      for (size_t pred_itr = 0; pred_itr < num_predicates; pred_itr++) {
+        auto *comparison =
+            CmpGteExpr(ColRefExpr(type::TypeId::INTEGER, pred_itr % 2),
+                       ConstIntExpr(-static_cast<int64_t>(pred_itr)))
+                .release();
+        predicate = predicate == nullptr
+                        ? comparison
+                        : new expression::ConjunctionExpression(
+                              ExpressionType::CONJUNCTION_AND, predicate,
+                              comparison);
+      }
+      return Scan(TableId::_1, predicate);
+    };
+    return config;
+  }
+
+  // Pipelines of growing length: a scan, then a hash aggregation, an order
+  // by and at the bottom up to three hash joins
+  PlanConfig PipelinePlan(size_t num_joins, bool aggregate, bool sort) {
+    PlanConfig config;
+    config.name = "pipeline_" + std::to_string(num_joins) + "j" +
+                  (aggregate ? "_agg" : "") + (sort ? "_sort" : "");
+    config.operator_count = 1 + 3 * num_joins + (aggregate ? 1 : 0) +
+                            (sort ? 1 : 0);
+    config.Construct = [this, num_joins, aggregate, sort]() {
+      std::vector<TableId> table_ids = {TableId::_2, TableId::_3,
+                                        TableId::_4};
+      auto plan = Scan(TableId::_1, nullptr);
+      for (size_t join_itr = 0; join_itr < num_joins; join_itr++) {
+        plan = HashJoin(std::move(plan), Scan(table_ids[join_itr], nullptr));
+      }
+      if (aggregate) {
+        plan = Aggregate(std::move(plan));
+      }
+      if (sort) {
+        // By the sum of the aggregation, or the second column of the scan
+        std::unique_ptr<planner::AbstractPlan> order_by_plan{
+            new planner::OrderByPlan({1}, {true},
+                                     aggregate ? std::vector<oid_t>{0, 1, 2}
+                                               : std::vector<oid_t>{0, 1})};
+        order_by_plan->AddChild(std::move(plan));
+        plan = std::move(order_by_plan);
+      }
+      return plan;
+    };
+    return config;
+  }
+
+  // Compile and run the plan at the current size of the tables
+  Result RunPlan(const PlanConfig &config, size_t num_rows) {
+    Result result;
+    result.name = config.name;
+    result.operator_count = config.operator_count;
+    result.num_rows = num_rows;
+
+    std::vector<double> setup_ms, ir_gen_ms, opt_ms, jit_ms, compile_ms;
+    std::vector<double> codegen_ms, interpreter_ms;
+    size_t codegen_tuples = 0;
+    for (size_t run_itr = 0; run_itr < repetitions_; run_itr++) {
+      // Every repetition compiles a new plan, so that no compiled state is
+      // shared between them
+      std::unique_ptr<planner::AbstractPlan> plan = config.Construct();
+      planner::BindingContext context;
+      plan->PerformBinding(context);
+
+      std::vector<oid_t> columns;
+      plan->GetOutputColumns(columns);
+      std::vector<StatementResult> results;
+      codegen::BufferingConsumer consumer{columns, context};
+      consumer.WriteResultsTo(results);
+
+      codegen::QueryCompiler::CompileStats compile_stats;
+      codegen::QueryCompiler compiler;
+      auto query = compiler.Compile(*plan, consumer, &compile_stats);
+
+      auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+      auto *txn = txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
+      executor::ExecutorContext executor_context{txn};
+      codegen::Query::RuntimeStats runtime_stats;
+      query->Execute(*txn, &executor_context,
+                     reinterpret_cast<char *>(consumer.GetState()),
+                     &runtime_stats);
+      txn_manager.CommitTransaction(txn);
+
+      setup_ms.push_back(compile_stats.setup_ms);
+      ir_gen_ms.push_back(compile_stats.ir_gen_ms);
+      opt_ms.push_back(compile_stats.opt_ms);
+      jit_ms.push_back(compile_stats.jit_ms);
+      compile_ms.push_back(compile_stats.TotalTime());
+      codegen_ms.push_back(runtime_stats.init_ms + runtime_stats.plan_ms +
+                           runtime_stats.tear_down_ms);
+      result.num_functions = compile_stats.num_functions;
+      result.num_instructions = compile_stats.num_instructions;
+      codegen_tuples = columns.empty() ? 0 : results.size() / columns.size();
+    }
+
+    // Keep the plan executor from compiling the plan
+    bool codegen = FLAGS_codegen;
+    FLAGS_codegen = false;
+    for (size_t run_itr = 0; run_itr < repetitions_; run_itr++) {
+      std::shared_ptr<planner::AbstractPlan> plan{config.Construct()};
+      if (run_itr == 0) {
+        result.estimated_rows =
+            executor::PlanExecutor::EstimateProcessedRows(*plan);
+      }
+
+      std::vector<oid_t> columns;
+      plan->GetOutputColumns(columns);
+      std::vector<int> result_format(columns.size(), 0);
+
+      auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+      auto *txn = txn_manager.BeginTransaction(IsolationLevelType::READ_ONLY);
+      std::vector<StatementResult> results;
+      Timer<std::ratio<1, 1000>> timer;
+      timer.Start();
+      auto status = executor::PlanExecutor::ExecutePlan(plan, txn, {}, results,
+                                                        result_format);
+      timer.Stop();
+      txn_manager.CommitTransaction(txn);
+
+      EXPECT_EQ(ResultType::SUCCESS, status.m_result);
+      interpreter_ms.push_back(timer.GetDuration());
+      result.num_tuples = columns.empty() ? 0 : results.size() / columns.size();
+    }
+    FLAGS_codegen = codegen;
+
+    // Both engines find the same tuples
+    EXPECT_EQ(codegen_tuples, result.num_tuples);
+
+    result.setup_ms = Median(setup_ms);
+    result.ir_gen_ms = Median(ir_gen_ms);
+    result.opt_ms = Median(opt_ms);
+    result.jit_ms = Median(jit_ms);
+    result.compile_ms = Median(compile_ms);
+    result.codegen_ms = Median(codegen_ms);
+    result.interpreter_ms = Median(interpreter_ms);
+    result.break_even_runs =
+        result.interpreter_ms > result.codegen_ms
+            ? result.compile_ms / (result.interpreter_ms - result.codegen_ms)
+            : 0;
+
+    LOG_INFO("%-24s %7lu rows: %5lu instructions, compile %7.2f ms "
+             "(setup %.2f, IR %.2f, opt %.2f, JIT %.2f), codegen %8.2f ms, "
+             "interpreter %8.2f ms, break-even %.1f runs",
+             result.name.c_str(), result.num_rows, result.num_instructions,
+             result.compile_ms, result.setup_ms, result.ir_gen_ms,
+             result.opt_ms, result.jit_ms, result.codegen_ms,
+             result.interpreter_ms, result.break_even_runs);
+    return result;
+  }
+
+  // Log where a single run of every plan pays off, and write all results
+  void WriteResults(const std::vector<PlanConfig> &configs,
+                    const std::vector<Result> &results) const {
+    for (const auto &config : configs) {
+      bool pays_off = false;
+      for (const auto &result : results) {
+        if (result.name == config.name &&
+            result.compile_ms + result.codegen_ms < result.interpreter_ms) {
+          LOG_INFO("%-24s pays off in one run from %lu rows, %lu estimated",
+                   config.name.c_str(), result.num_rows,
+                   result.estimated_rows);
+          pays_off = true;
+          break;
+        }
+      }
+      if (!pays_off) {
+        LOG_INFO("%-24s does not pay off in one run", config.name.c_str());
+      }
+    }
+
+    std::ofstream out(output_path_);
+    out << "{\n  \"context\": {\"max_rows\": " << max_rows_
+        << ", \"repetitions\": " << repetitions_ << "},\n"
+        << "  \"benchmarks\": [";
+    for (size_t result_itr = 0; result_itr < results.size(); result_itr++) {
+      auto &result = results[result_itr];
+      out << (result_itr == 0 ? "\n" : ",\n") << "    {\"name\": \""
+          << result.name << "\", \"operators\": " << result.operator_count
+          << ", \"rows\": " << result.num_rows
+          << ", \"estimated_rows\": " << result.estimated_rows
+          << ", \"tuples\": " << result.num_tuples
+          << ", \"functions\": " << result.num_functions
+          << ", \"instructions\": " << result.num_instructions
+          << ", \"setup_ms\": " << result.setup_ms
+          << ", \"ir_gen_ms\": " << result.ir_gen_ms
+          << ", \"opt_ms\": " << result.opt_ms
+          << ", \"jit_ms\": " << result.jit_ms
+          << ", \"compile_ms\": " << result.compile_ms
+          << ", \"codegen_ms\": " << result.codegen_ms
+          << ", \"interpreter_ms\": " << result.interpreter_ms
+          << ", \"break_even_runs\": " << result.break_even_runs << "}";
+    }
+    out << "\n  ]\n}\n";
+    LOG_INFO("Wrote %lu benchmark results to %s", results.size(),
+             output_path_.c_str());
+  }
+
+ private:
+  static size_t GetEnv(const char *name, size_t default_value) {
+    const char *value = std::getenv(name);
+    return value != nullptr ? std::strtoull(value, nullptr, 10)
+                            : default_value;
+  }
+
+  static double Median(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+  }
+
+  // A scan of the first two columns of the table
+  std::unique_ptr<planner::AbstractPlan> Scan(
+      TableId table_id, expression::AbstractExpression *predicate) {
+    return std::unique_ptr<planner::AbstractPlan>{new planner::SeqScanPlan(
+        &GetTestTable(table_id), predicate, {0, 1})};
+  }
+
+  // Join the first two columns of the left input with the right one on the
+  // first column, keeping the columns of the left
+  std::unique_ptr<planner::AbstractPlan> HashJoin(
+      std::unique_ptr<planner::AbstractPlan> &&left,
+      std::unique_ptr<planner::AbstractPlan> &&right) {
+    std::vector<ExprPtr> hash_keys;
+    hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0));
+    std::vector<ExprPtr> left_hash_keys;
+    left_hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0));
+    std::vector<ExprPtr> right_hash_keys;
+    right_hash_keys.emplace_back(
+        new expression::TupleValueExpression(type::TypeId::INTEGER, 1, 0));
+
+    std::unique_ptr<planner::AbstractPlan> hash_plan{
+        new planner::HashPlan(hash_keys)};
+    hash_plan->AddChild(std::move(right));
+
+    DirectMapList direct_map_list = {{0, {0, 0}}, {1, {0, 1}}};
+    std::unique_ptr<const planner::ProjectInfo> projection{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+    auto schema = std::shared_ptr<const catalog::Schema>(
+        new catalog::Schema({TestingExecutorUtil::GetColumnInfo(0),
+                             TestingExecutorUtil::GetColumnInfo(1)}));
+    std::unique_ptr<planner::AbstractPlan> join_plan{
+        new planner::HashJoinPlan(JoinType::INNER, nullptr,
+                                  std::move(projection), schema,
+                                  left_hash_keys, right_hash_keys)};
+    join_plan->AddChild(std::move(left));
+    join_plan->AddChild(std::move(hash_plan));
+    return join_plan;
+  }
+
+  // SELECT a, COUNT(*), SUM(b) GROUP BY a
+  std::unique_ptr<planner::AbstractPlan> Aggregate(
+      std::unique_ptr<planner::AbstractPlan> &&child) {
+    DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}, {2, {1, 1}}};
+    std::unique_ptr<planner::ProjectInfo> proj_info{
+        new planner::ProjectInfo(TargetList{}, std::move(direct_map_list))};
+    std::vector<planner::AggregatePlan::AggTerm> agg_terms = {
+        {ExpressionType::AGGREGATE_COUNT_STAR,
+         new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0)},
+        {ExpressionType::AGGREGATE_SUM,
+         new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1)}};
+    std::vector<oid_t> gb_cols = {0};
+    std::shared_ptr<const catalog::Schema> output_schema{
+        new catalog::Schema({{type::TypeId::INTEGER, 4, "COL_A"},
+                             {type::TypeId::BIGINT, 8, "COUNT_A"},
+                             {type::TypeId::INTEGER, 4, "SUM_B"}})};
+    std::unique_ptr<planner::AbstractPlan> agg_plan{new planner::AggregatePlan(
+        std::move(proj_info), nullptr, std::move(agg_terms),
+        std::move(gb_cols), output_schema, AggregateType::HASH)};
+    agg_plan->AddChild(std::move(child));
+    return agg_plan;
+  }
+
+ private:
+  size_t max_rows_;
+
+  size_t repetitions_;
+
+  std::string output_path_;
+};
+
+TEST_F(CodegenCompileBenchmarkTest, CompileVersusExecutionTest) {
+  std::vector<PlanConfig> configs = {
+      FilterPlan(1),
+      FilterPlan(4),
+      FilterPlan(16),
+      FilterPlan(64),
+      PipelinePlan(0, false, false),
+      PipelinePlan(0, true, false),
+      PipelinePlan(0, true, true),
+      PipelinePlan(1, true, true),
+      PipelinePlan(2, true, true),
+      PipelinePlan(3, true, true)};
+
+  std::vector<TableId> table_ids = {TableId::_1, TableId::_2, TableId::_3,
+                                    TableId::_4};
+  std::vector<Result> results;
+  size_t loaded_rows = 0;
+  for (auto num_rows : GetRowCounts()) {
+    // The tables grow from the rows loaded for the previous size
+    for (auto table_id : table_ids) {
+      LoadTestTable(table_id, num_rows - loaded_rows);
+    }
+    loaded_rows = num_rows;
+
+    for (const auto &config : configs) {
+      results.push_back(RunPlan(config, num_rows));
+    }
+  }
+
+  WriteResults(configs, results);
+}
+
+}  // End test namespace
+}  // End peloton namespace
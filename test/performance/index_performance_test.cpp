@@ -368,6 +368,10 @@ TEST_F(IndexPerformanceTests, BwTreeMultiThreadedTest) {
   TestIndexPerformance(IndexType::BWTREE);
 }
 
+TEST_F(IndexPerformanceTests, ARTMultiThreadedTest) {
+  TestIndexPerformance(IndexType::ART);
+}
+
 // TEST_F(IndexPerformanceTests, BTreeMultiThreadedTest) {
 //  TestIndexPerformance(IndexType::BTREE);
 //}
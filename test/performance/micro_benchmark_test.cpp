@@ -0,0 +1,548 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// micro_benchmark_test.cpp
+//
+// Identification: test/performance/micro_benchmark_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+#include "performance/micro_benchmark.h"
+
+#include "catalog/schema.h"
+#include "codegen/util/cc_hash_table.h"
+#include "codegen/util/oa_hash_table.h"
+#include "codegen/util/sorter.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "container/lock_free_queue.h"
+#include "index/index_factory.h"
+#include "index/scan_optimizer.h"
+#include "murmur3/MurmurHash3.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "type/ephemeral_pool.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Micro Benchmarks
+//===--------------------------------------------------------------------===//
+
+// Writes the results of all benchmarks once they have run
+class MicroBenchmarkEnvironment : public ::testing::Environment {
+ public:
+  void TearDown() override { MicroBenchmark::GetInstance().WriteJson(); }
+};
+
+static ::testing::Environment *const micro_benchmark_environment =
+    ::testing::AddGlobalTestEnvironment(new MicroBenchmarkEnvironment());
+
+class MicroBenchmarkTests : public PelotonTest {};
+
+// Keeps the results of the benchmarked operations alive
+static std::atomic<uint64_t> benchmark_sink(0);
+
+static const size_t kIndexOperationsPerThread = 20000;
+static const size_t kScanOperationsPerThread = 1000;
+static const size_t kScanLength = 100;
+static const size_t kOperationsPerThread = 100000;
+
+//===------------------------------===//
+// Index
+//===------------------------------===//
+
+// An index over one key column, with the keys to benchmark in shuffled order
+struct IndexBenchmarkState {
+  std::unique_ptr<catalog::Schema> tuple_schema;
+  std::unique_ptr<index::Index> index;
+  std::unique_ptr<type::EphemeralPool> pool;
+  std::vector<std::unique_ptr<storage::Tuple>> keys;
+  std::vector<ItemPointer> items;
+};
+
+// Keys of every type order like the numbers they are made of
+static type::Value GetKeyValue(type::TypeId key_type, size_t key) {
+  switch (key_type) {
+    case type::TypeId::INTEGER:
+      return type::ValueFactory::GetIntegerValue(key);
+    case type::TypeId::BIGINT:
+      return type::ValueFactory::GetBigIntValue(key);
+    default: {
+      char key_string[32];
+      snprintf(key_string, sizeof(key_string), "%020lu", key);
+      return type::ValueFactory::GetVarcharValue(key_string);
+    }
+  }
+}
+
+static void BuildIndexState(IndexBenchmarkState &state, IndexType index_type,
+                            type::TypeId key_type, size_t key_count) {
+  bool is_inlined = key_type != type::TypeId::VARCHAR;
+  catalog::Column key_column(
+      key_type, is_inlined ? type::Type::GetTypeSize(key_type) : 32, "A",
+      is_inlined);
+  catalog::Column value_column(type::TypeId::INTEGER,
+                               type::Type::GetTypeSize(type::TypeId::INTEGER),
+                               "B", true);
+  std::vector<oid_t> key_attrs = {0};
+  auto key_schema = new catalog::Schema({key_column});
+  key_schema->SetIndexedColumns(key_attrs);
+  state.tuple_schema.reset(new catalog::Schema({key_column, value_column}));
+
+  auto index_metadata = new index::IndexMetadata(
+      "benchmark_index", 125, INVALID_OID, INVALID_OID, index_type,
+      IndexConstraintType::DEFAULT, state.tuple_schema.get(), key_schema,
+      key_attrs, false);
+  state.index.reset(index::IndexFactory::GetIndex(index_metadata));
+
+  std::vector<size_t> key_order(key_count);
+  for (size_t key = 0; key < key_count; key++) {
+    key_order[key] = key;
+  }
+  std::mt19937_64 generator(42);
+  std::shuffle(key_order.begin(), key_order.end(), generator);
+
+  state.pool.reset(new type::EphemeralPool());
+  state.keys.clear();
+  state.items.assign(key_count, ItemPointer(1, 1));
+  for (auto key : key_order) {
+    std::unique_ptr<storage::Tuple> key_tuple(
+        new storage::Tuple(key_schema, true));
+    key_tuple->SetValue(0, GetKeyValue(key_type, key), state.pool.get());
+    state.keys.push_back(std::move(key_tuple));
+  }
+}
+
+static void ClearIndexState(IndexBenchmarkState &state) {
+  state.keys.clear();
+  state.index.reset();
+  state.tuple_schema.reset();
+  state.pool.reset();
+}
+
+static void BenchmarkIndex(IndexType index_type, type::TypeId key_type) {
+  auto &micro_benchmark = MicroBenchmark::GetInstance();
+  std::string name = IndexTypeToString(index_type) + "/" +
+                     TypeIdToString(key_type);
+  IndexBenchmarkState state;
+
+  // Every thread inserts keys of its own
+  micro_benchmark.Run(
+      name + "/Insert", kIndexOperationsPerThread,
+      [&state](size_t thread_id, UNUSED_ATTRIBUTE size_t thread_count) {
+        size_t begin = thread_id * kIndexOperationsPerThread;
+        for (size_t key_itr = begin;
+             key_itr < begin + kIndexOperationsPerThread; key_itr++) {
+          state.index->InsertEntry(state.keys[key_itr].get(),
+                                   &state.items[key_itr]);
+        }
+      },
+      [&state, index_type, key_type](size_t thread_count) {
+        BuildIndexState(state, index_type, key_type,
+                        thread_count * kIndexOperationsPerThread);
+      },
+      [&state](UNUSED_ATTRIBUTE size_t thread_count) {
+        ClearIndexState(state);
+      });
+
+  // The keys to look up and scan are inserted beforehand
+  auto load_index = [&state, index_type, key_type](size_t thread_count) {
+    BuildIndexState(state, index_type, key_type,
+                    thread_count * kIndexOperationsPerThread);
+    for (size_t key_itr = 0; key_itr < state.keys.size(); key_itr++) {
+      state.index->InsertEntry(state.keys[key_itr].get(),
+                               &state.items[key_itr]);
+    }
+  };
+
+  micro_benchmark.Run(
+      name + "/Lookup", kIndexOperationsPerThread,
+      [&state](size_t thread_id, UNUSED_ATTRIBUTE size_t thread_count) {
+        std::mt19937_64 generator(thread_id);
+        std::uniform_int_distribution<size_t> distribution(
+            0, state.keys.size() - 1);
+        std::vector<ItemPointer *> result;
+        for (size_t op_itr = 0; op_itr < kIndexOperationsPerThread;
+             op_itr++) {
+          result.clear();
+          state.index->ScanKey(state.keys[distribution(generator)].get(),
+                               result);
+          benchmark_sink += result.size();
+        }
+      },
+      load_index, [&state](UNUSED_ATTRIBUTE size_t thread_count) {
+        ClearIndexState(state);
+      });
+
+  micro_benchmark.Run(
+      name + "/Scan", kScanOperationsPerThread,
+      [&state, key_type](size_t thread_id,
+                         UNUSED_ATTRIBUTE size_t thread_count) {
+        std::mt19937_64 generator(thread_id);
+        std::uniform_int_distribution<size_t> distribution(
+            0, state.keys.size() - kScanLength);
+        std::vector<oid_t> column_ids = {0, 0};
+        std::vector<ExpressionType> expr_types = {
+            ExpressionType::COMPARE_GREATERTHANOREQUALTO,
+            ExpressionType::COMPARE_LESSTHAN};
+        std::vector<ItemPointer *> result;
+        for (size_t op_itr = 0; op_itr < kScanOperationsPerThread; op_itr++) {
+          size_t low_key = distribution(generator);
+          std::vector<type::Value> values = {
+              GetKeyValue(key_type, low_key).Copy(),
+              GetKeyValue(key_type, low_key + kScanLength).Copy()};
+          index::IndexScanPredicate scan_predicate;
+          scan_predicate.AddConjunctionScanPredicate(
+              state.index.get(), values, column_ids, expr_types);
+          result.clear();
+          state.index->Scan(values, column_ids, expr_types,
+                            ScanDirectionType::FORWARD, result,
+                            &scan_predicate.GetConjunctionList()[0]);
+          benchmark_sink += result.size();
+        }
+      },
+      load_index, [&state](UNUSED_ATTRIBUTE size_t thread_count) {
+        ClearIndexState(state);
+      });
+}
+
+TEST_F(MicroBenchmarkTests, BwTreeTest) {
+  BenchmarkIndex(IndexType::BWTREE, type::TypeId::INTEGER);
+  BenchmarkIndex(IndexType::BWTREE, type::TypeId::BIGINT);
+  BenchmarkIndex(IndexType::BWTREE, type::TypeId::VARCHAR);
+}
+
+TEST_F(MicroBenchmarkTests, SkipListTest) {
+  BenchmarkIndex(IndexType::SKIPLIST, type::TypeId::INTEGER);
+  BenchmarkIndex(IndexType::SKIPLIST, type::TypeId::BIGINT);
+  BenchmarkIndex(IndexType::SKIPLIST, type::TypeId::VARCHAR);
+}
+
+//===------------------------------===//
+// Hash Tables
+//===------------------------------===//
+
+struct HashTableKey {
+  uint64_t k1, k2;
+
+  bool operator==(const HashTableKey &rhs) const {
+    return k1 == rhs.k1 && k2 == rhs.k2;
+  }
+  bool operator!=(const HashTableKey &rhs) const { return !(rhs == *this); }
+};
+
+struct HashTableValue {
+  uint64_t v1, v2;
+};
+
+static uint64_t HashKey(const HashTableKey &key) {
+  uint64_t hash[2];
+  MurmurHash3_x64_128(&key, sizeof(key), 12345, hash);
+  return hash[0];
+}
+
+TEST_F(MicroBenchmarkTests, HashTableTest) {
+  auto &micro_benchmark = MicroBenchmark::GetInstance();
+
+  // The hash tables are not shared, every thread builds its own
+  std::vector<std::unique_ptr<int8_t[]>> oa_hash_tables;
+  auto get_oa_hash_table = [&oa_hash_tables](size_t thread_id) {
+    return reinterpret_cast<codegen::util::OAHashTable *>(
+        oa_hash_tables[thread_id].get());
+  };
+  auto init_oa_hash_tables = [&oa_hash_tables,
+                              get_oa_hash_table](size_t thread_count) {
+    oa_hash_tables.clear();
+    for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+      oa_hash_tables.emplace_back(
+          new int8_t[sizeof(codegen::util::OAHashTable)]);
+      get_oa_hash_table(thread_id)
+          ->Init(sizeof(HashTableKey), sizeof(HashTableValue));
+    }
+  };
+  auto destroy_oa_hash_tables = [&oa_hash_tables,
+                                 get_oa_hash_table](size_t thread_count) {
+    for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+      get_oa_hash_table(thread_id)->Destroy();
+    }
+    oa_hash_tables.clear();
+  };
+  auto build_oa_hash_table = [get_oa_hash_table](size_t thread_id) {
+    auto hash_table = get_oa_hash_table(thread_id);
+    HashTableValue value = {1, 2};
+    for (uint64_t key_itr = 0; key_itr < kOperationsPerThread; key_itr++) {
+      HashTableKey key = {thread_id, key_itr};
+      hash_table->Insert(HashKey(key), key, value);
+    }
+  };
+
+  micro_benchmark.Run(
+      "OAHashTable/Build", kOperationsPerThread,
+      [build_oa_hash_table](size_t thread_id,
+                            UNUSED_ATTRIBUTE size_t thread_count) {
+        build_oa_hash_table(thread_id);
+      },
+      init_oa_hash_tables, destroy_oa_hash_tables);
+
+  // The generated code probes the tables, this iterates their entries
+  micro_benchmark.Run(
+      "OAHashTable/Iterate", kOperationsPerThread,
+      [get_oa_hash_table](size_t thread_id,
+                          UNUSED_ATTRIBUTE size_t thread_count) {
+        auto hash_table = get_oa_hash_table(thread_id);
+        uint64_t sum = 0;
+        for (auto iter = hash_table->begin(), end = hash_table->end();
+             iter != end; ++iter) {
+          sum += reinterpret_cast<const HashTableValue *>(iter.Value())->v1;
+        }
+        benchmark_sink += sum;
+      },
+      [init_oa_hash_tables, build_oa_hash_table](size_t thread_count) {
+        init_oa_hash_tables(thread_count);
+        for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+          build_oa_hash_table(thread_id);
+        }
+      },
+      destroy_oa_hash_tables);
+
+  std::vector<std::unique_ptr<codegen::util::CCHashTable>> cc_hash_tables;
+  auto init_cc_hash_tables = [&cc_hash_tables](size_t thread_count) {
+    cc_hash_tables.clear();
+    for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+      cc_hash_tables.emplace_back(
+          new codegen::util::CCHashTable(kOperationsPerThread));
+    }
+  };
+  auto build_cc_hash_table = [&cc_hash_tables](size_t thread_id) {
+    auto &hash_table = cc_hash_tables[thread_id];
+    for (uint64_t key_itr = 0; key_itr < kOperationsPerThread; key_itr++) {
+      HashTableKey key = {thread_id, key_itr};
+      auto data = hash_table->StoreTuple(
+          HashKey(key), sizeof(HashTableKey) + sizeof(HashTableValue));
+      *reinterpret_cast<HashTableKey *>(data) = key;
+      *reinterpret_cast<HashTableValue *>(data + sizeof(HashTableKey)) = {1,
+                                                                          2};
+    }
+  };
+  auto destroy_cc_hash_tables = [&cc_hash_tables](
+      UNUSED_ATTRIBUTE size_t thread_count) { cc_hash_tables.clear(); };
+
+  micro_benchmark.Run(
+      "CCHashTable/Build", kOperationsPerThread,
+      [build_cc_hash_table](size_t thread_id,
+                            UNUSED_ATTRIBUTE size_t thread_count) {
+        build_cc_hash_table(thread_id);
+      },
+      init_cc_hash_tables, destroy_cc_hash_tables);
+
+  micro_benchmark.Run(
+      "CCHashTable/Iterate", kOperationsPerThread,
+      [&cc_hash_tables](size_t thread_id,
+                        UNUSED_ATTRIBUTE size_t thread_count) {
+        auto &hash_table = cc_hash_tables[thread_id];
+        uint64_t sum = 0;
+        for (auto iter = hash_table->begin(), end = hash_table->end();
+             iter != end; ++iter) {
+          sum += reinterpret_cast<const HashTableKey *>(*iter)->k2;
+        }
+        benchmark_sink += sum;
+      },
+      [init_cc_hash_tables, build_cc_hash_table](size_t thread_count) {
+        init_cc_hash_tables(thread_count);
+        for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+          build_cc_hash_table(thread_id);
+        }
+      },
+      destroy_cc_hash_tables);
+}
+
+//===------------------------------===//
+// Sorter
+//===------------------------------===//
+
+struct SortTuple {
+  uint32_t col_a;
+  uint32_t col_b;
+};
+
+static int CompareSortTuples(const void *left, const void *right) {
+  auto left_b = reinterpret_cast<const SortTuple *>(left)->col_b;
+  auto right_b = reinterpret_cast<const SortTuple *>(right)->col_b;
+  return (left_b > right_b) - (left_b < right_b);
+}
+
+TEST_F(MicroBenchmarkTests, SorterTest) {
+  auto &micro_benchmark = MicroBenchmark::GetInstance();
+  std::vector<std::unique_ptr<codegen::util::Sorter>> sorters;
+
+  // Every thread fills and sorts a sorter of its own
+  micro_benchmark.Run(
+      "Sorter/StoreAndSort", kOperationsPerThread,
+      [&sorters](size_t thread_id, UNUSED_ATTRIBUTE size_t thread_count) {
+        auto &sorter = sorters[thread_id];
+        std::mt19937 generator(thread_id);
+        for (size_t tuple_itr = 0; tuple_itr < kOperationsPerThread;
+             tuple_itr++) {
+          auto tuple = reinterpret_cast<SortTuple *>(sorter->StoreInputTuple());
+          tuple->col_a = tuple_itr;
+          tuple->col_b = generator();
+        }
+        sorter->Sort();
+      },
+      [&sorters](size_t thread_count) {
+        sorters.clear();
+        for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+          sorters.emplace_back(new codegen::util::Sorter());
+          sorters.back()->Init(CompareSortTuples, sizeof(SortTuple));
+        }
+      },
+      [&sorters](UNUSED_ATTRIBUTE size_t thread_count) { sorters.clear(); });
+}
+
+//===------------------------------===//
+// Value
+//===------------------------------===//
+
+TEST_F(MicroBenchmarkTests, ValueTest) {
+  auto &micro_benchmark = MicroBenchmark::GetInstance();
+  std::vector<type::Value> integer_values;
+  std::vector<type::Value> varchar_values;
+  std::mt19937 generator(42);
+  for (size_t value_itr = 0; value_itr < 1024; value_itr++) {
+    auto value = generator();
+    integer_values.push_back(type::ValueFactory::GetIntegerValue(value));
+    varchar_values.push_back(
+        type::ValueFactory::GetVarcharValue(std::to_string(value)));
+  }
+
+  for (auto values : {&integer_values, &varchar_values}) {
+    std::string name = TypeIdToString(values->front().GetTypeId());
+    micro_benchmark.Run(
+        "Value/" + name + "/Compare", kOperationsPerThread,
+        [values](UNUSED_ATTRIBUTE size_t thread_id,
+                 UNUSED_ATTRIBUTE size_t thread_count) {
+          uint64_t less_count = 0;
+          for (size_t op_itr = 0; op_itr < kOperationsPerThread; op_itr++) {
+            auto &left = (*values)[op_itr % values->size()];
+            auto &right = (*values)[(op_itr + 1) % values->size()];
+            less_count += left.CompareLessThan(right) == type::CMP_TRUE;
+          }
+          benchmark_sink += less_count;
+        });
+
+    micro_benchmark.Run(
+        "Value/" + name + "/Hash", kOperationsPerThread,
+        [values](UNUSED_ATTRIBUTE size_t thread_id,
+                 UNUSED_ATTRIBUTE size_t thread_count) {
+          uint64_t hash = 0;
+          for (size_t op_itr = 0; op_itr < kOperationsPerThread; op_itr++) {
+            hash ^= (*values)[op_itr % values->size()].Hash();
+          }
+          benchmark_sink += hash;
+        });
+  }
+}
+
+//===------------------------------===//
+// Tile Group Header
+//===------------------------------===//
+
+TEST_F(MicroBenchmarkTests, TileGroupHeaderTest) {
+  auto &micro_benchmark = MicroBenchmark::GetInstance();
+  std::unique_ptr<storage::TileGroupHeader> tile_group_header;
+
+  // All threads take the slots of one header, like concurrent inserts
+  micro_benchmark.Run(
+      "TileGroupHeader/NextEmptyTupleSlot", kOperationsPerThread,
+      [&tile_group_header](UNUSED_ATTRIBUTE size_t thread_id,
+                           UNUSED_ATTRIBUTE size_t thread_count) {
+        uint64_t slot_sum = 0;
+        for (size_t op_itr = 0; op_itr < kOperationsPerThread; op_itr++) {
+          slot_sum += tile_group_header->GetNextEmptyTupleSlot();
+        }
+        benchmark_sink += slot_sum;
+      },
+      [&tile_group_header](size_t thread_count) {
+        tile_group_header.reset(new storage::TileGroupHeader(
+            BackendType::MM, thread_count * kOperationsPerThread));
+      },
+      [&tile_group_header](UNUSED_ATTRIBUTE size_t thread_count) {
+        tile_group_header.reset();
+      });
+}
+
+//===------------------------------===//
+// Epoch
+//===------------------------------===//
+
+TEST_F(MicroBenchmarkTests, EpochTest) {
+  auto &micro_benchmark = MicroBenchmark::GetInstance();
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  micro_benchmark.Run(
+      "Epoch/EnterExit", kOperationsPerThread,
+      [&epoch_manager](size_t thread_id,
+                       UNUSED_ATTRIBUTE size_t thread_count) {
+        for (size_t op_itr = 0; op_itr < kOperationsPerThread; op_itr++) {
+          cid_t read_id = epoch_manager.EnterEpoch(thread_id,
+                                                   TimestampType::READ);
+          epoch_manager.ExitEpoch(thread_id, read_id >> 32);
+        }
+      },
+      [&epoch_manager](size_t thread_count) {
+        for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+          epoch_manager.RegisterThread(thread_id);
+        }
+      },
+      [&epoch_manager](size_t thread_count) {
+        for (size_t thread_id = 0; thread_id < thread_count; thread_id++) {
+          epoch_manager.DeregisterThread(thread_id);
+        }
+      });
+}
+
+//===------------------------------===//
+// Lock-free Queue
+//===------------------------------===//
+
+TEST_F(MicroBenchmarkTests, LockFreeQueueTest) {
+  auto &micro_benchmark = MicroBenchmark::GetInstance();
+  std::unique_ptr<LockFreeQueue<uint64_t>> queue;
+
+  // Every thread enqueues an item and dequeues one
+  micro_benchmark.Run(
+      "LockFreeQueue/EnqueueDequeue", kOperationsPerThread,
+      [&queue](size_t thread_id, UNUSED_ATTRIBUTE size_t thread_count) {
+        uint64_t item_sum = 0;
+        for (uint64_t op_itr = 0; op_itr < kOperationsPerThread; op_itr++) {
+          uint64_t item = thread_id * kOperationsPerThread + op_itr;
+          queue->Enqueue(item);
+          if (queue->Dequeue(item) == true) {
+            item_sum += item;
+          }
+        }
+        benchmark_sink += item_sum;
+      },
+      [&queue](size_t thread_count) {
+        queue.reset(new LockFreeQueue<uint64_t>(thread_count * 1024));
+      },
+      [&queue](UNUSED_ATTRIBUTE size_t thread_count) { queue.reset(); });
+}
+
+}  // End test namespace
+}  // End peloton namespace
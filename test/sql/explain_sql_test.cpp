@@ -0,0 +1,72 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// explain_sql_test.cpp
+//
+// Identification: test/sql/explain_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+
+namespace peloton {
+namespace test {
+
+class ExplainSQLTests : public PelotonTest {};
+
+TEST_F(ExplainSQLTests, ExplainAnalyzeTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 22);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 33);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 22);");
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_changed;
+
+  // The plan is returned without running it
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "EXPLAIN SELECT a FROM test WHERE b = 22;", result,
+                tuple_descriptor, rows_changed, error_message));
+  EXPECT_EQ(1U, tuple_descriptor.size());
+  EXPECT_EQ("QUERY PLAN", std::get<0>(tuple_descriptor[0]));
+  EXPECT_LT(0U, result.size());
+  for (size_t row_idx = 0; row_idx < result.size(); row_idx++) {
+    auto line = TestingSQLUtil::GetResultValueAsString(result, row_idx);
+    EXPECT_EQ(std::string::npos, line.find("rows="));
+  }
+
+  // With ANALYZE the plan tells what it did, while its rows are dropped
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "EXPLAIN ANALYZE SELECT a FROM test WHERE b = 22;", result,
+                tuple_descriptor, rows_changed, error_message));
+  EXPECT_EQ(1U, tuple_descriptor.size());
+  EXPECT_LT(0U, result.size());
+  auto top_line = TestingSQLUtil::GetResultValueAsString(result, 0);
+  EXPECT_NE(std::string::npos, top_line.find("rows=2 "));
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -10,13 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 
 #include "sql/testing_sql_util.h"
 #include "catalog/catalog.h"
+#include "configuration/configuration.h"
 #include "common/harness.h"
 #include "executor/create_executor.h"
 #include "optimizer/optimizer.h"
+#include "planner/abstract_scan_plan.h"
 #include "planner/create_plan.h"
 #include "planner/order_by_plan.h"
 
@@ -217,6 +220,76 @@ TEST_F(OptimizerSQLTests, SelectOrderByTest) {
            true);
 }
 
+TEST_F(OptimizerSQLTests, IndexOrderTest) {
+  // The plan node types from the root down the first children
+  auto get_plan_types = [&](const std::string &query) {
+    auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query);
+    vector<PlanNodeType> plan_types;
+    for (auto plan_ptr = plan.get(); plan_ptr != nullptr;
+         plan_ptr = plan_ptr->GetChildren().empty()
+                        ? nullptr
+                        : plan_ptr->GetChildren()[0].get())
+      plan_types.push_back(plan_ptr->GetPlanNodeType());
+    return plan_types;
+  };
+
+  // The primary key index is scanned in key order instead of sorting
+  std::string query = "SELECT a, b FROM test ORDER BY a";
+  auto plan_types = get_plan_types(query);
+  EXPECT_EQ(PlanNodeType::INDEXSCAN, plan_types.back());
+  EXPECT_EQ(plan_types.end(), std::find(plan_types.begin(), plan_types.end(),
+                                        PlanNodeType::ORDERBY));
+  TestUtil(query, {"1", "22", "2", "11", "3", "33", "4", "0"}, true);
+
+  // Columns without an index, or a descending order, are still sorted
+  plan_types = get_plan_types("SELECT a, b FROM test ORDER BY b");
+  EXPECT_NE(plan_types.end(), std::find(plan_types.begin(), plan_types.end(),
+                                        PlanNodeType::ORDERBY));
+  plan_types = get_plan_types("SELECT a, b FROM test ORDER BY a DESC");
+  EXPECT_NE(plan_types.end(), std::find(plan_types.begin(), plan_types.end(),
+                                        PlanNodeType::ORDERBY));
+
+  // Once the table is analyzed, grouping the rows in key order beats hashing
+  // them
+  TestingSQLUtil::ExecuteSQLQuery("ANALYZE test;");
+  query = "SELECT a, SUM(b) FROM test GROUP BY a";
+  plan_types = get_plan_types(query);
+  EXPECT_EQ(PlanNodeType::INDEXSCAN, plan_types.back());
+  EXPECT_EQ(plan_types.end(), std::find(plan_types.begin(), plan_types.end(),
+                                        PlanNodeType::ORDERBY));
+  TestUtil(query, {"1", "22", "2", "11", "3", "33", "4", "0"}, false);
+}
+
+TEST_F(OptimizerSQLTests, PointStatementTest) {
+  // Statements on a single row of the primary key are planned as an index
+  // scan directly
+  TestUtil("SELECT * FROM test WHERE a = 2", {"2", "11", "0"}, false,
+           {PlanNodeType::INDEXSCAN});
+  TestUtil("SELECT c, b FROM test WHERE a = 3", {"444", "33"}, false,
+           {PlanNodeType::INDEXSCAN});
+
+  std::string query = "UPDATE test SET b = 12 WHERE a = 2";
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query);
+  EXPECT_EQ(PlanNodeType::UPDATE, plan->GetPlanNodeType());
+  ASSERT_EQ(1U, plan->GetChildren().size());
+  EXPECT_EQ(PlanNodeType::INDEXSCAN,
+            plan->GetChildren()[0]->GetPlanNodeType());
+  TestingSQLUtil::ExecuteSQLQueryWithOptimizer(
+      optimizer, query, result, tuple_descriptor, rows_changed, error_message);
+  EXPECT_EQ(1, rows_changed);
+
+  query = "DELETE FROM test WHERE a = 3";
+  plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query);
+  EXPECT_EQ(PlanNodeType::DELETE, plan->GetPlanNodeType());
+  TestingSQLUtil::ExecuteSQLQueryWithOptimizer(
+      optimizer, query, result, tuple_descriptor, rows_changed, error_message);
+  EXPECT_EQ(1, rows_changed);
+
+  // Range predicates and expressions in the select list take the full path
+  TestUtil("SELECT a, b FROM test WHERE a > 1", {"2", "12", "4", "0"}, false);
+  TestUtil("SELECT a + b FROM test WHERE a = 2", {"14"}, false);
+}
+
 TEST_F(OptimizerSQLTests, SelectLimitTest) {
   // Test limit with default offset
   TestUtil("SELECT b FROM test ORDER BY b LIMIT 3", {"0", "11", "22"}, true);
@@ -630,6 +703,104 @@ TEST_F(OptimizerSQLTests, JoinTest) {
 
 }
 
+TEST_F(OptimizerSQLTests, JoinPredicatePushdownTest) {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (2, 11, 000);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (3, 22, 444);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (4, 00, 333);");
+
+  std::string query =
+      "SELECT test.a, test1.b FROM test, test1 "
+      "WHERE test.a = test1.a AND test.c > 333 AND test1.b = 22";
+
+  // The predicates on a single table are evaluated by the scan of that table
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query);
+  auto plan_ptr = plan.get();
+  while (plan_ptr->GetChildren().size() == 1)
+    plan_ptr = plan_ptr->GetChildren()[0].get();
+  ASSERT_EQ(2U, plan_ptr->GetChildren().size());
+  for (auto &child : plan_ptr->GetChildren()) {
+    // The inner side of a hash join is hashed
+    auto child_ptr = child.get();
+    if (child_ptr->GetPlanNodeType() == PlanNodeType::HASH)
+      child_ptr = child_ptr->GetChildren()[0].get();
+    auto scan_plan = dynamic_cast<const planner::AbstractScan *>(child_ptr);
+    ASSERT_NE(nullptr, scan_plan);
+    EXPECT_NE(nullptr, scan_plan->GetPredicate());
+  }
+
+  TestUtil(query, {"3", "22"}, false);
+}
+
+TEST_F(OptimizerSQLTests, SearchBudgetTest) {
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (1, 22, 333);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test1 VALUES (2, 11, 000);");
+
+  // Out of budget every group keeps the first plan it found, which still
+  // has to give the right result
+  FLAGS_optimizer_task_budget = 1;
+  TestUtil("SELECT test.a, test1.b FROM test, test1 WHERE test.a = test1.a",
+           {"1", "22", "2", "11"}, false);
+  TestUtil("SELECT a, b FROM test WHERE b > 20 ORDER BY a",
+           {"1", "22", "3", "33"}, true);
+  FLAGS_optimizer_task_budget = 0;
+}
+
+TEST_F(OptimizerSQLTests, ExchangeTest) {
+  // A table of several tile groups
+  int tuples_per_tilegroup = DEFAULT_TUPLES_PER_TILEGROUP;
+  DEFAULT_TUPLES_PER_TILEGROUP = TEST_TUPLES_PER_TILEGROUP;
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test1(a INT PRIMARY KEY, b INT, c INT);");
+  DEFAULT_TUPLES_PER_TILEGROUP = tuples_per_tilegroup;
+  vector<string> ref_result;
+  for (int i = 1; i <= 4 * TEST_TUPLES_PER_TILEGROUP; i++) {
+    TestingSQLUtil::ExecuteSQLQuery(
+        "INSERT INTO test1 VALUES (" + std::to_string(i) + ", " +
+        std::to_string(i % 2) + ", " + std::to_string(i) + ");");
+    if (i % 2 == 1) ref_result.push_back(std::to_string(i));
+  }
+
+  // The plan node types from the root down the first children
+  auto get_plan_types = [&](const std::string &query) {
+    auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query);
+    vector<PlanNodeType> plan_types;
+    for (auto plan_ptr = plan.get(); plan_ptr != nullptr;
+         plan_ptr = plan_ptr->GetChildren().empty()
+                        ? nullptr
+                        : plan_ptr->GetChildren()[0].get())
+      plan_types.push_back(plan_ptr->GetPlanNodeType());
+    return plan_types;
+  };
+  auto has_exchange = [&](const std::string &query) {
+    auto plan_types = get_plan_types(query);
+    EXPECT_EQ(PlanNodeType::SEQSCAN, plan_types.back());
+    return std::find(plan_types.begin(), plan_types.end(),
+                     PlanNodeType::EXCHANGE) != plan_types.end();
+  };
+
+  // The interpreted scans of the large table run on the exchange workers
+  bool codegen = FLAGS_codegen;
+  FLAGS_codegen = false;
+  FLAGS_exchange_threads = 4;
+  std::string query = "SELECT a FROM test1 WHERE b = 1";
+  EXPECT_TRUE(has_exchange(query));
+  TestUtil(query, ref_result, false);
+  query = "SELECT a FROM test1 WHERE b = 1 ORDER BY c";
+  EXPECT_TRUE(has_exchange(query));
+  TestUtil(query, ref_result, true);
+
+  // The scan of a single tile group does not
+  query = "SELECT a FROM test WHERE b > 20 ORDER BY c";
+  EXPECT_FALSE(has_exchange(query));
+  TestUtil(query, {"1", "3"}, true);
+  FLAGS_codegen = codegen;
+}
+
 TEST_F(OptimizerSQLTests, IndexTest) {
   TestingSQLUtil::ExecuteSQLQuery(
       "create table foo(a int, b varchar(32), primary key(a, b));");
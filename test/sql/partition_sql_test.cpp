@@ -0,0 +1,139 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partition_sql_test.cpp
+//
+// Identification: test/sql/partition_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/optimizer.h"
+#include "planner/abstract_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/partitioned_table.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class PartitionSQLTests : public PelotonTest {};
+
+TEST_F(PartitionSQLTests, RangePartitionTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "CREATE TABLE events (id INT PRIMARY KEY, stamp INT) WITH "
+                "(partition_column = stamp, range_partitions = '0, 100, "
+                "200');"));
+  auto table = catalog::Catalog::GetInstance()->GetTableWithName(
+      DEFAULT_DB_NAME, "events");
+  auto partitioned_table = table->GetPartitionedTable();
+  ASSERT_NE(nullptr, partitioned_table);
+  EXPECT_EQ(3U, partitioned_table->GetPartitionCount());
+  // the partitions have the primary key, the table itself keeps no index
+  EXPECT_EQ(0U, table->GetIndexCount());
+  EXPECT_EQ(1U, partitioned_table->GetPartition(0)->GetIndexCount());
+
+  for (int id = 0; id < 30; id++) {
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO events VALUES (" +
+                                    std::to_string(id) + ", " +
+                                    std::to_string(id * 10) + ");");
+  }
+  EXPECT_EQ(0U, table->GetTupleCount());
+  EXPECT_EQ(10U, partitioned_table->GetPartition(2)->GetTupleCount());
+
+  // only the last partition can hold the tuples of the query
+  std::unique_ptr<optimizer::AbstractOptimizer> optimizer(
+      new optimizer::Optimizer());
+  std::string query = "SELECT id FROM events WHERE stamp >= 250;";
+  auto plan = TestingSQLUtil::GeneratePlanWithOptimizer(optimizer, query);
+  auto plan_ptr = plan.get();
+  while (plan_ptr->GetChildren().empty() == false) {
+    EXPECT_NE(PlanNodeType::APPEND, plan_ptr->GetPlanNodeType());
+    plan_ptr = plan_ptr->GetChildren()[0].get();
+  }
+  ASSERT_EQ(PlanNodeType::SEQSCAN, plan_ptr->GetPlanNodeType());
+  EXPECT_EQ(partitioned_table->GetPartition(2),
+            static_cast<planner::AbstractScan *>(plan_ptr)->GetTable());
+
+  std::vector<StatementResult> result;
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_changed;
+  TestingSQLUtil::ExecuteSQLQuery(query, result, tuple_descriptor,
+                                  rows_changed, error_message);
+  EXPECT_EQ(5U, result.size());
+
+  TestingSQLUtil::ExecuteSQLQuery("SELECT id FROM events WHERE stamp < 150;",
+                                  result, tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(15U, result.size());
+
+  // an update of the partition column moves the tuple to its new partition
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "UPDATE events SET stamp = 50 WHERE id = 29;"));
+  TestingSQLUtil::ExecuteSQLQuery("SELECT id FROM events WHERE stamp < 100;",
+                                  result, tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(11U, result.size());
+
+  // the tuples moved into a partition scanned later are not updated again
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery(
+                "UPDATE events SET stamp = stamp + 100 WHERE stamp < 200;"));
+  TestingSQLUtil::ExecuteSQLQuery("SELECT id FROM events WHERE stamp < 200;",
+                                  result, tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(11U, result.size());
+  TestingSQLUtil::ExecuteSQLQuery("SELECT id FROM events;", result,
+                                  tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(30U, result.size());
+
+  // a delete writes every partition it can find tuples in
+  EXPECT_EQ(ResultType::SUCCESS, TestingSQLUtil::ExecuteSQLQuery(
+                                     "DELETE FROM events WHERE id < 5;"));
+  TestingSQLUtil::ExecuteSQLQuery("SELECT id FROM events;", result,
+                                  tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(25U, result.size());
+
+  // the tuples of the dropped partitions are gone at once
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(ResultType::SUCCESS,
+            catalog::Catalog::GetInstance()->DropPartitionsBefore(
+                DEFAULT_DB_NAME, "events",
+                type::ValueFactory::GetIntegerValue(200), txn));
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(1U, partitioned_table->GetPartitionCount());
+
+  TestingSQLUtil::ExecuteSQLQuery("SELECT id FROM events;", result,
+                                  tuple_descriptor, rows_changed,
+                                  error_message);
+  EXPECT_EQ(19U, result.size());
+
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::ExecuteSQLQuery("DROP TABLE events;"));
+
+  // free the database just created
+  txn = txn_manager.BeginTransaction();
+  catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache_sql_test.cpp
+//
+// Identification: test/sql/plan_cache_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "optimizer/plan_cache.h"
+#include "tcop/tcop.h"
+
+namespace peloton {
+namespace test {
+
+class PlanCacheSQLTests : public PelotonTest {
+ protected:
+  virtual void SetUp() override {
+    PelotonTest::SetUp();
+    FLAGS_plan_cache_size = 100;
+    optimizer::PlanCache::GetInstance().Clear();
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+  }
+
+  virtual void TearDown() override {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+
+    optimizer::PlanCache::GetInstance().Clear();
+    FLAGS_plan_cache_size = 0;
+    PelotonTest::TearDown();
+  }
+};
+
+TEST_F(PlanCacheSQLTests, SameShapeTest) {
+  auto &plan_cache = optimizer::PlanCache::GetInstance();
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c VARCHAR);");
+
+  // All rows are inserted with the plan of the first one
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 11, 'x');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 22, 'it''s');");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (3, 33, 'z');");
+  EXPECT_EQ(1U, plan_cache.GetCount());
+
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b, c FROM test WHERE a = 1;",
+                                  result);
+  EXPECT_EQ("11", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ("x", TestingSQLUtil::GetResultValueAsString(result, 1));
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b, c FROM test WHERE a = 2;",
+                                  result);
+  EXPECT_EQ("22", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ("it's", TestingSQLUtil::GetResultValueAsString(result, 1));
+  EXPECT_EQ(2U, plan_cache.GetCount());
+
+  // The literals of the assignments are part of the shape
+  TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET b = 44 WHERE a = 3;");
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b, c FROM test WHERE a = 3;",
+                                  result);
+  EXPECT_EQ("44", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(3U, plan_cache.GetCount());
+}
+
+TEST_F(PlanCacheSQLTests, CatalogChangeTest) {
+  auto &plan_cache = optimizer::PlanCache::GetInstance();
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT, c INT);");
+  for (int i = 0; i < 10; i++) {
+    TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (" +
+                                    std::to_string(i) + ", " +
+                                    std::to_string(i * 10) + ", 0);");
+  }
+
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 30;", result);
+  EXPECT_EQ("3", TestingSQLUtil::GetResultValueAsString(result, 0));
+
+  // The plans built before the index exists are not used anymore
+  uint64_t catalog_version = catalog::Catalog::GetInstance()->GetVersion();
+  TestingSQLUtil::ExecuteSQLQuery("CREATE INDEX i1 ON test(b);");
+  EXPECT_LT(catalog_version, catalog::Catalog::GetInstance()->GetVersion());
+  EXPECT_EQ(nullptr, plan_cache.Acquire("SELECT a FROM test WHERE b = $1;",
+                                        catalog_version));
+
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test WHERE b = 70;", result);
+  EXPECT_EQ(1U, result.size());
+  EXPECT_EQ("7", TestingSQLUtil::GetResultValueAsString(result, 0));
+}
+
+TEST_F(PlanCacheSQLTests, HandleTest) {
+  auto &plan_cache = optimizer::PlanCache::GetInstance();
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE test(a INT, b INT);");
+
+  std::string query = "SELECT a FROM test WHERE b = $1;";
+  uint64_t catalog_version = catalog::Catalog::GetInstance()->GetVersion();
+  int prepare_count = 0;
+  auto prepare = [&query, &prepare_count]() {
+    std::string error_message;
+    prepare_count++;
+    return tcop::TrafficCop::GetInstance().PrepareStatement("s1", query,
+                                                            error_message);
+  };
+
+  // Connections holding the statement at the same time prepare their own
+  {
+    auto first = plan_cache.AcquireHandle(query, catalog_version, prepare);
+    auto second = plan_cache.AcquireHandle(query, catalog_version, prepare);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    EXPECT_NE(first.get(), second.get());
+    EXPECT_EQ(2, prepare_count);
+  }
+
+  // Dropped handles put their statements back for the next connections
+  auto third = plan_cache.AcquireHandle(query, catalog_version, prepare);
+  auto fourth = plan_cache.AcquireHandle(query, catalog_version, prepare);
+  EXPECT_EQ(2, prepare_count);
+  EXPECT_EQ(1U, plan_cache.GetCount());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// result_cache_sql_test.cpp
+//
+// Identification: test/sql/result_cache_sql_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "sql/testing_sql_util.h"
+#include "catalog/catalog.h"
+#include "common/harness.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "configuration/configuration.h"
+#include "tcop/result_cache.h"
+
+namespace peloton {
+namespace test {
+
+class ResultCacheSQLTests : public PelotonTest {
+ protected:
+  virtual void SetUp() override {
+    FLAGS_result_cache_size = 1000;
+    PelotonTest::SetUp();
+    tcop::ResultCache::GetInstance().Clear();
+
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+  }
+
+  virtual void TearDown() override {
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+
+    tcop::ResultCache::GetInstance().Clear();
+    FLAGS_result_cache_size = 0;
+    PelotonTest::TearDown();
+  }
+};
+
+TEST_F(ResultCacheSQLTests, InvalidateTest) {
+  auto &result_cache = tcop::ResultCache::GetInstance();
+  TestingSQLUtil::ExecuteSQLQuery(
+      "CREATE TABLE test(a INT PRIMARY KEY, b INT);");
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE other(a INT, b INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 11);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 22);");
+  EXPECT_EQ(0U, result_cache.GetCount());
+
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 1;", result);
+  EXPECT_EQ("11", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(1U, result_cache.GetCount());
+
+  // The same query returns the cached rows, other literals run the query
+  auto hit_count = result_cache.GetHitCount();
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 1;", result);
+  EXPECT_EQ("11", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(hit_count + 1, result_cache.GetHitCount());
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 2;", result);
+  EXPECT_EQ("22", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(hit_count + 1, result_cache.GetHitCount());
+  EXPECT_EQ(2U, result_cache.GetCount());
+
+  // A write to another table keeps the results
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO other VALUES (1, 1);");
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 1;", result);
+  EXPECT_EQ(hit_count + 2, result_cache.GetHitCount());
+
+  // A write to the table drops them
+  TestingSQLUtil::ExecuteSQLQuery("UPDATE test SET b = 33 WHERE a = 1;");
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 1;", result);
+  EXPECT_EQ("33", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(hit_count + 2, result_cache.GetHitCount());
+
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT b FROM test WHERE a = 1;", result);
+  EXPECT_EQ("33", TestingSQLUtil::GetResultValueAsString(result, 0));
+  EXPECT_EQ(hit_count + 3, result_cache.GetHitCount());
+}
+
+TEST_F(ResultCacheSQLTests, TransactionTest) {
+  auto &result_cache = tcop::ResultCache::GetInstance();
+  TestingSQLUtil::ExecuteSQLQuery("CREATE TABLE test(a INT, b INT);");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (1, 11);");
+
+  // Queries in a transaction block see its own writes, they are not cached
+  TestingSQLUtil::ExecuteSQLQuery("BEGIN;");
+  TestingSQLUtil::ExecuteSQLQuery("INSERT INTO test VALUES (2, 22);");
+  std::vector<StatementResult> result;
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test;", result);
+  EXPECT_EQ(2U, result.size());
+  TestingSQLUtil::ExecuteSQLQuery("ROLLBACK;");
+  EXPECT_EQ(0U, result_cache.GetCount());
+
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test;", result);
+  EXPECT_EQ(1U, result.size());
+  EXPECT_EQ(1U, result_cache.GetCount());
+
+  // The versions are bumped by the transaction block once it commits
+  TestingSQLUtil::ExecuteSQLQuery("BEGIN;");
+  TestingSQLUtil::ExecuteSQLQuery("DELETE FROM test WHERE a = 1;");
+  TestingSQLUtil::ExecuteSQLQuery("COMMIT;");
+  result.clear();
+  TestingSQLUtil::ExecuteSQLQuery("SELECT a FROM test;", result);
+  EXPECT_EQ(0U, result.size());
+}
+
+}  // namespace test
+}  // namespace peloton
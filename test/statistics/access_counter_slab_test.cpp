@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// access_counter_slab_test.cpp
+//
+// Identification: test/statistics/access_counter_slab_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "statistics/access_counter_slab.h"
+
+#include <atomic>
+#include <thread>
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Access Counter Slab Test
+//===--------------------------------------------------------------------===//
+
+class AccessCounterSlabTests : public PelotonTest {};
+
+TEST_F(AccessCounterSlabTests, BasicTest) {
+  stats::AccessCounterSlab slab;
+  size_t slot_count = 0;
+  slab.ForEachSlot([&slot_count](const stats::AccessCounterSlot &) {
+    slot_count++;
+  });
+  EXPECT_EQ(0U, slot_count);
+
+  // Slots are claimed on first use, in segments far apart
+  auto table_slot = slab.GetSlot(3, 1, 2, INVALID_OID);
+  auto index_slot = slab.GetSlot(5000, 1, 2, 4);
+  stats::AccessCounterSlab::Increment(table_slot->reads);
+  stats::AccessCounterSlab::Increment(table_slot->reads, 2);
+  stats::AccessCounterSlab::Increment(index_slot->deletes, 5);
+  EXPECT_EQ(table_slot, slab.GetSlot(3, 1, 2, INVALID_OID));
+
+  slab.ForEachSlot([&slot_count](const stats::AccessCounterSlot &slot) {
+    slot_count++;
+    if (slot.index_id == INVALID_OID) {
+      EXPECT_EQ(2U, slot.table_id);
+      EXPECT_EQ(3, slot.reads.load());
+      EXPECT_EQ(0, slot.deletes.load());
+    } else {
+      EXPECT_EQ(4U, slot.index_id);
+      EXPECT_EQ(0, slot.reads.load());
+      EXPECT_EQ(5, slot.deletes.load());
+    }
+  });
+  EXPECT_EQ(2U, slot_count);
+
+  // Ids past the capacity are not counted
+  EXPECT_EQ(nullptr, slab.GetSlot(1UL << 30, 1, 2, 4));
+
+  // Ids are never handed out twice
+  EXPECT_NE(stats::AccessCounterSlab::GetNextSlotId(),
+            stats::AccessCounterSlab::GetNextSlotId());
+}
+
+TEST_F(AccessCounterSlabTests, ConcurrentReadTest) {
+  stats::AccessCounterSlab slab;
+  const size_t slot_count = 1000;
+  const int64_t round_count = 100;
+  std::atomic<bool> is_counting(true);
+
+  // The owner counts while another thread reads the counters
+  std::thread reader([&slab, &is_counting] {
+    while (is_counting.load()) {
+      slab.ForEachSlot([](const stats::AccessCounterSlot &slot) {
+        EXPECT_LE(0, slot.reads.load(std::memory_order_relaxed));
+        EXPECT_EQ(slot.table_id, slot.database_id + 1);
+      });
+    }
+  });
+  for (int64_t round = 0; round < round_count; round++) {
+    for (size_t slot_id = 0; slot_id < slot_count; slot_id++) {
+      auto slot = slab.GetSlot(slot_id, slot_id, slot_id + 1, INVALID_OID);
+      stats::AccessCounterSlab::Increment(slot->reads);
+    }
+  }
+  is_counting.store(false);
+  reader.join();
+
+  int64_t total_reads = 0;
+  slab.ForEachSlot([&total_reads](const stats::AccessCounterSlot &slot) {
+    total_reads += slot.reads.load();
+  });
+  EXPECT_EQ(round_count * static_cast<int64_t>(slot_count), total_reads);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hardware_counters_test.cpp
+//
+// Identification: test/statistics/hardware_counters_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "common/logger.h"
+#include "configuration/configuration.h"
+#include "statistics/hardware_counters.h"
+#include "statistics/processor_metric.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Hardware Counters Test
+//===--------------------------------------------------------------------===//
+
+class HardwareCountersTests : public PelotonTest {};
+
+namespace {
+
+uint64_t DoWork() {
+  volatile uint64_t sum = 0;
+  for (uint64_t value = 0; value < 1000000; value++) {
+    sum += value;
+  }
+  return sum;
+}
+
+}  // namespace
+
+TEST_F(HardwareCountersTests, ValuesTest) {
+  stats::HardwareCounterValues begin;
+  begin.cycles = 100;
+  begin.instructions = 1000;
+  stats::HardwareCounterValues end;
+  end.cycles = 600;
+  end.instructions = 2000;
+  end.llc_misses = 3;
+
+  auto values = end.GetSince(begin);
+  EXPECT_EQ(500U, values.cycles);
+  EXPECT_EQ(1000U, values.instructions);
+  EXPECT_EQ(2, values.GetInstructionsPerCycle());
+  EXPECT_EQ(3, values.GetMissesPerKiloInstructions(values.llc_misses));
+
+  values.Add(end);
+  EXPECT_EQ(1100U, values.cycles);
+  EXPECT_EQ(6U, values.llc_misses);
+
+  // Nothing counted
+  stats::HardwareCounterValues empty;
+  EXPECT_EQ(0, empty.GetInstructionsPerCycle());
+  EXPECT_EQ(0, empty.GetMissesPerKiloInstructions(0));
+}
+
+TEST_F(HardwareCountersTests, ProcessorMetricTest) {
+  // Counted if enabled and the machine has them
+  stats::ProcessorMetric processor_metric(PROCESSOR_METRIC);
+  processor_metric.StartTimer();
+  DoWork();
+  processor_metric.RecordTime();
+  EXPECT_FALSE(processor_metric.HasHardwareCounters());
+
+  FLAGS_stats_hardware_counters = true;
+  processor_metric.StartTimer();
+  DoWork();
+  processor_metric.RecordTime();
+  FLAGS_stats_hardware_counters = false;
+
+  if (stats::HardwareCounters::GetInstance() == nullptr) {
+    LOG_INFO("No hardware counters on this machine");
+    EXPECT_FALSE(processor_metric.HasHardwareCounters());
+    return;
+  }
+  EXPECT_TRUE(processor_metric.HasHardwareCounters());
+  auto values = processor_metric.GetHardwareCounters();
+  EXPECT_LT(1000000U, values.instructions);
+  EXPECT_LT(0U, values.cycles);
+}
+
+}  // namespace test
+}  // namespace peloton
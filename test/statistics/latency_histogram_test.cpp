@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// latency_histogram_test.cpp
+//
+// Identification: test/statistics/latency_histogram_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "statistics/latency_histogram.h"
+#include "statistics/latency_metric.h"
+
+#include <atomic>
+#include <thread>
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Latency Histogram Test
+//===--------------------------------------------------------------------===//
+
+class LatencyHistogramTests : public PelotonTest {};
+
+TEST_F(LatencyHistogramTests, BasicTest) {
+  stats::LatencyHistogram histogram;
+  EXPECT_EQ(0U, histogram.GetCount());
+  EXPECT_EQ(0, histogram.GetPercentile(50));
+
+  // Latencies below 128 us are counted exactly
+  for (int latency_us = 1; latency_us <= 100; latency_us++) {
+    histogram.Record(latency_us / 1000.0);
+  }
+  EXPECT_EQ(100U, histogram.GetCount());
+  EXPECT_EQ(0.001, histogram.GetMin());
+  EXPECT_EQ(0.05, histogram.GetPercentile(50));
+  EXPECT_EQ(0.099, histogram.GetPercentile(99));
+  EXPECT_EQ(0.1, histogram.GetMax());
+  EXPECT_NEAR(0.0505, histogram.GetAverage(), 0.0001);
+
+  // Longer ones within 1/64 of their value, and the tail is not lost
+  stats::LatencyHistogram other_histogram;
+  for (int latency_ms = 1; latency_ms <= 1000; latency_ms++) {
+    other_histogram.Record(latency_ms);
+  }
+  other_histogram.Record(60 * 1000);
+  EXPECT_NEAR(500, other_histogram.GetPercentile(50), 500 / 64.0);
+  EXPECT_NEAR(990, other_histogram.GetPercentile(99), 990 / 64.0);
+  EXPECT_NEAR(1000, other_histogram.GetPercentile(99.9), 1000 / 64.0);
+  EXPECT_NEAR(60 * 1000, other_histogram.GetMax(), 60 * 1000 / 64.0);
+  EXPECT_LE(60 * 1000, other_histogram.GetMax());
+
+  // Merged histograms count the latencies of both
+  histogram.Merge(other_histogram);
+  EXPECT_EQ(1101U, histogram.GetCount());
+  EXPECT_EQ(0.001, histogram.GetMin());
+  EXPECT_EQ(other_histogram.GetMax(), histogram.GetMax());
+
+  // And taking one away leaves the latencies of the other
+  histogram.Subtract(other_histogram);
+  EXPECT_EQ(100U, histogram.GetCount());
+  EXPECT_EQ(0.1, histogram.GetMax());
+  EXPECT_NEAR(0.0505, histogram.GetAverage(), 0.0001);
+
+  histogram.Reset();
+  EXPECT_EQ(0U, histogram.GetCount());
+  EXPECT_EQ(0, histogram.GetMax());
+}
+
+TEST_F(LatencyHistogramTests, IntervalTest) {
+  stats::LatencyMetric latencies(LATENCY_METRIC);
+  for (int latency_ms = 1; latency_ms <= 100; latency_ms++) {
+    latencies.RecordLatency(latency_ms);
+  }
+  latencies.ComputeLatencies();
+  EXPECT_EQ(100U, latencies.GetLatencyMeasurements().count_);
+  EXPECT_NEAR(100, latencies.GetLatencyMeasurements().max_, 100 / 64.0);
+
+  // Only the latencies since the last measurements are measured
+  latencies.RecordLatency(1000);
+  latencies.ComputeLatencies();
+  EXPECT_EQ(1U, latencies.GetLatencyMeasurements().count_);
+  EXPECT_NEAR(1000, latencies.GetLatencyMeasurements().min_, 1000 / 64.0);
+
+  latencies.ComputeLatencies();
+  EXPECT_EQ(0U, latencies.GetLatencyMeasurements().count_);
+  EXPECT_EQ(0, latencies.GetLatencyMeasurements().max_);
+}
+
+TEST_F(LatencyHistogramTests, ConcurrentMergeTest) {
+  stats::LatencyHistogram histogram;
+  const int latency_count = 100000;
+  std::atomic<bool> is_recording(true);
+
+  // The owner records while another thread merges its latencies
+  std::thread merger([&histogram, &is_recording] {
+    while (is_recording.load()) {
+      stats::LatencyHistogram merged_histogram;
+      merged_histogram.Merge(histogram);
+      EXPECT_LE(merged_histogram.GetPercentile(50), 1);
+    }
+  });
+  for (int latency_itr = 0; latency_itr < latency_count; latency_itr++) {
+    histogram.Record((latency_itr % 1000) / 1000.0);
+  }
+  is_recording.store(false);
+  merger.join();
+
+  EXPECT_EQ(static_cast<uint64_t>(latency_count), histogram.GetCount());
+}
+
+}  // namespace test
+}  // namespace peloton
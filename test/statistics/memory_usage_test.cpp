@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// memory_usage_test.cpp
+//
+// Identification: test/statistics/memory_usage_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "statistics/memory_usage.h"
+#include "storage/data_table.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Memory Usage Test
+//===--------------------------------------------------------------------===//
+
+class MemoryUsageTests : public PelotonTest {};
+
+TEST_F(MemoryUsageTests, TableTest) {
+  auto before = stats::MemoryUsage::GetTracked();
+
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(table.get(),
+                                     TESTS_TUPLES_PER_TILEGROUP * 2, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto after = stats::MemoryUsage::GetTracked();
+  after.AddTable(table.get());
+  EXPECT_EQ(TESTS_TUPLES_PER_TILEGROUP * 2UL, after.tuple_count);
+
+  // The tiles, their headers and the index entries are charged
+  EXPECT_LT(before.GetBytes(MemoryComponentType::TILE_DATA),
+            after.GetBytes(MemoryComponentType::TILE_DATA));
+  EXPECT_LT(before.GetBytes(MemoryComponentType::TILE_GROUP_HEADER),
+            after.GetBytes(MemoryComponentType::TILE_GROUP_HEADER));
+  EXPECT_LT(0UL, after.GetBytes(MemoryComponentType::INDEX));
+
+  // Nothing was updated or deleted
+  EXPECT_EQ(0UL, after.GetBytes(MemoryComponentType::VERSION_CHAIN));
+  EXPECT_LT(before.GetTotalBytes(), after.GetTotalBytes());
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// metrics_exporter_test.cpp
+//
+// Identification: test/statistics/metrics_exporter_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+
+#include "common/logger.h"
+#include "statistics/latency_histogram.h"
+#include "statistics/metrics_exporter.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Metrics Exporter Test
+//===--------------------------------------------------------------------===//
+
+class MetricsExporterTests : public PelotonTest {};
+
+namespace {
+
+// Send the request to the port on this host and return the response
+std::string SendRequest(const int port, const std::string &request) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = inet_addr("127.0.0.1");
+  std::string response;
+  if (connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0 &&
+      write(fd, request.data(), request.size()) ==
+          static_cast<ssize_t>(request.size())) {
+    char buffer[4096];
+    ssize_t read_size;
+    while ((read_size = read(fd, buffer, sizeof(buffer))) > 0) {
+      response.append(buffer, read_size);
+    }
+  }
+  close(fd);
+  return response;
+}
+
+}  // namespace
+
+TEST_F(MetricsExporterTests, TextTest) {
+  stats::MetricsText metrics;
+  metrics.AddFamily("peloton_test_total", "counter", "Test counter");
+  metrics.AddSample("peloton_test_total", {}, 12345678);
+  metrics.AddSample("peloton_test_total",
+                    {{"table_oid", "7"}, {"name", "a\"b"}}, 0.25);
+  EXPECT_EQ(
+      "# HELP peloton_test_total Test counter\n"
+      "# TYPE peloton_test_total counter\n"
+      "peloton_test_total 12345678\n"
+      "peloton_test_total{table_oid=\"7\",name=\"a\\\"b\"} 0.25\n",
+      metrics.GetText());
+}
+
+TEST_F(MetricsExporterTests, HistogramTest) {
+  stats::LatencyHistogram latencies;
+  latencies.Record(0.05);
+  latencies.Record(2);
+  latencies.Record(2000);
+  EXPECT_EQ(1U, latencies.GetCountAtMost(0.1));
+  EXPECT_EQ(2U, latencies.GetCountAtMost(10));
+  EXPECT_EQ(3U, latencies.GetCountAtMost(5000));
+  EXPECT_DOUBLE_EQ(2002.05, latencies.GetSum());
+
+  // Cumulative buckets in seconds
+  stats::MetricsText metrics;
+  metrics.AddHistogram("peloton_test_seconds", {{"type", "SELECT"}},
+                       latencies);
+  auto &text = metrics.GetText();
+  EXPECT_NE(std::string::npos,
+            text.find("peloton_test_seconds_bucket{type=\"SELECT\","
+                      "le=\"0.0001\"} 1\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("peloton_test_seconds_bucket{type=\"SELECT\","
+                      "le=\"0.005\"} 2\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("peloton_test_seconds_bucket{type=\"SELECT\","
+                      "le=\"1\"} 2\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("peloton_test_seconds_bucket{type=\"SELECT\","
+                      "le=\"+Inf\"} 3\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("peloton_test_seconds_sum{type=\"SELECT\"} 2.00205\n"));
+  EXPECT_NE(std::string::npos,
+            text.find("peloton_test_seconds_count{type=\"SELECT\"} 3\n"));
+}
+
+TEST_F(MetricsExporterTests, ServeTest) {
+  const int port = 19187;
+  stats::MetricsExporter exporter;
+  EXPECT_EQ("", *exporter.GetMetrics());
+  if (exporter.Start(port) == false) {
+    LOG_INFO("Cannot bind port %d", port);
+    return;
+  }
+  EXPECT_TRUE(exporter.IsRunning());
+
+  exporter.Publish(
+      std::make_shared<const std::string>("peloton_test_total 1\n"));
+  auto response = SendRequest(port, "GET /metrics HTTP/1.0\r\n\r\n");
+  EXPECT_NE(std::string::npos, response.find(" 200 "));
+  EXPECT_NE(std::string::npos,
+            response.find("Content-Type: text/plain; version=0.0.4"));
+  EXPECT_NE(std::string::npos, response.find("\r\n\r\npeloton_test_total 1\n"));
+
+  response = SendRequest(port, "GET /other HTTP/1.0\r\n\r\n");
+  EXPECT_NE(std::string::npos, response.find(" 404 "));
+
+  exporter.Stop();
+  EXPECT_FALSE(exporter.IsRunning());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// query_trace_test.cpp
+//
+// Identification: test/statistics/query_trace_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include <chrono>
+#include <thread>
+
+#include "common/statement.h"
+#include "configuration/configuration.h"
+#include "statistics/backend_stats_context.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Query Trace Test
+//===--------------------------------------------------------------------===//
+
+class QueryTraceTests : public PelotonTest {};
+
+namespace {
+
+// Run a query that takes at least the given time
+void RunQuery(stats::BackendStatsContext &context,
+              const std::shared_ptr<Statement> &statement,
+              const int64_t latency_ms = 0) {
+  context.InitQueryMetric(statement, nullptr);
+  if (latency_ms > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(latency_ms));
+  }
+  context.IncrementTxnCommitted(DEFAULT_DB_ID);
+}
+
+size_t TakeCompletedQueries(
+    stats::BackendStatsContext &context,
+    std::vector<std::shared_ptr<stats::QueryMetric>> &query_metrics) {
+  std::shared_ptr<stats::QueryMetric> query_metric;
+  while (context.GetCompletedQueryMetrics().Dequeue(query_metric)) {
+    query_metrics.push_back(std::move(query_metric));
+  }
+  return query_metrics.size();
+}
+
+}  // namespace
+
+TEST_F(QueryTraceTests, SampleTest) {
+  stats::BackendStatsContext context(false);
+  std::shared_ptr<Statement> statement(
+      new Statement("sample", "SELECT * FROM test"));
+
+  // One in three queries is measured, all of them are timed
+  FLAGS_stats_query_sample_interval = 3;
+  for (int query_itr = 0; query_itr < 6; query_itr++) {
+    RunQuery(context, statement);
+  }
+  FLAGS_stats_query_sample_interval = 1;
+
+  std::vector<std::shared_ptr<stats::QueryMetric>> query_metrics;
+  EXPECT_EQ(2U, TakeCompletedQueries(context, query_metrics));
+  EXPECT_EQ(6U, context.GetQueryLatencyMetric("SELECT").GetLatencies()
+                    .GetCount());
+}
+
+TEST_F(QueryTraceTests, SlowQueryTest) {
+  stats::BackendStatsContext context(false);
+  std::shared_ptr<Statement> statement(
+      new Statement("slow", "SELECT * FROM test"));
+
+  // Only the slow query is measured
+  FLAGS_stats_query_sample_interval = 0;
+  FLAGS_stats_slow_query_ms = 5;
+  RunQuery(context, statement);
+  RunQuery(context, statement, 10);
+  FLAGS_stats_query_sample_interval = 1;
+  FLAGS_stats_slow_query_ms = 0;
+
+  std::vector<std::shared_ptr<stats::QueryMetric>> query_metrics;
+  ASSERT_EQ(1U, TakeCompletedQueries(context, query_metrics));
+  auto &query_metric = query_metrics[0];
+  EXPECT_EQ("SELECT * FROM test", query_metric->GetName());
+  EXPECT_LE(10, query_metric->GetQueryLatency().GetLatencyValue());
+  EXPECT_LE(10, query_metric->GetPhaseLatency(stats::QueryPhase::EXECUTE));
+}
+
+TEST_F(QueryTraceTests, PhaseTest) {
+  stats::BackendStatsContext context(false);
+  std::shared_ptr<Statement> statement(
+      new Statement("phase", "SELECT * FROM test"));
+
+  // The phases before the query count for it, and so do the ones of its
+  // response after it completed
+  context.StartQueryTrace();
+  context.RecordQueryPhase(stats::QueryPhase::PARSE, 1);
+  context.RecordQueryPhase(stats::QueryPhase::OPTIMIZE, 2);
+  RunQuery(context, statement);
+  std::vector<std::shared_ptr<stats::QueryMetric>> query_metrics;
+  EXPECT_EQ(0U, TakeCompletedQueries(context, query_metrics));
+
+  context.RecordQueryPhase(stats::QueryPhase::SEND, 3);
+  context.FinishQueryTrace();
+  ASSERT_EQ(1U, TakeCompletedQueries(context, query_metrics));
+  auto &query_metric = query_metrics[0];
+  EXPECT_EQ(1, query_metric->GetPhaseLatency(stats::QueryPhase::PARSE));
+  EXPECT_EQ(2, query_metric->GetPhaseLatency(stats::QueryPhase::OPTIMIZE));
+  EXPECT_EQ(3, query_metric->GetPhaseLatency(stats::QueryPhase::SEND));
+  EXPECT_EQ(0, query_metric->GetPhaseLatency(stats::QueryPhase::COMPILE));
+
+  // The next query starts without them
+  RunQuery(context, statement);
+  ASSERT_EQ(2U, TakeCompletedQueries(context, query_metrics));
+  EXPECT_EQ(0, query_metrics[1]->GetPhaseLatency(stats::QueryPhase::PARSE));
+  EXPECT_EQ(0, query_metrics[1]->GetPhaseLatency(stats::QueryPhase::SEND));
+  EXPECT_EQ("PARSE", stats::QueryPhaseToString(stats::QueryPhase::PARSE));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// aggregate_view_test.cpp
+//
+// Identification: test/storage/aggregate_view_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/aggregate_view.h"
+#include "storage/data_table.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Aggregate View Tests
+//===--------------------------------------------------------------------===//
+
+class AggregateViewTests : public PelotonTest {};
+
+// Insert a tuple of the group with the values of the row id
+void InsertGroupTuple(storage::DataTable *table, int group, int rowid,
+                      concurrency::Transaction *txn) {
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  storage::Tuple tuple(table->GetSchema(), true);
+  tuple.SetValue(0, type::ValueFactory::GetIntegerValue(group), testing_pool);
+  tuple.SetValue(1, type::ValueFactory::GetIntegerValue(
+                        TestingExecutorUtil::PopulatedValue(rowid, 1)),
+                 testing_pool);
+  tuple.SetValue(2, type::ValueFactory::GetDecimalValue(
+                        TestingExecutorUtil::PopulatedValue(rowid, 2)),
+                 testing_pool);
+  tuple.SetValue(3, type::ValueFactory::GetVarcharValue("inserted"),
+                 testing_pool);
+  ItemPointer *index_entry_ptr = nullptr;
+  auto location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+  EXPECT_NE(INVALID_OID, location.block);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+}
+
+TEST_F(AggregateViewTests, MaintainTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  // Column 0 holds the groups 0 and 10 with five rows each
+  const int tuple_count = 10;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto &view_manager = storage::AggregateViewManager::GetInstance();
+  EXPECT_TRUE(
+      view_manager.CreateView("sum_view", data_table.get(), {0}, {1, 2}));
+  EXPECT_FALSE(
+      view_manager.CreateView("sum_view", data_table.get(), {0}, {1}));
+  auto view = view_manager.GetView("sum_view");
+  ASSERT_NE(nullptr, view);
+  EXPECT_FALSE(view->IsReady());
+  EXPECT_EQ(nullptr, view_manager.FindView(data_table.get(), {0}, {1}));
+
+  // A commit of the barrier epoch is picked up by the scan of the build
+  txn = txn_manager.BeginTransaction();
+  InsertGroupTuple(data_table.get(), 0, tuple_count, txn);
+  txn_manager.CommitTransaction(txn);
+
+  epoch_manager.SetCurrentEpochId(2);
+  view_manager.WaitForAll();
+  EXPECT_TRUE(view->IsReady());
+  EXPECT_TRUE(view->IsValid());
+  EXPECT_EQ(0U, view->GetDeltaCount());
+  EXPECT_EQ(view, view_manager.FindView(data_table.get(), {0}, {1}));
+  EXPECT_EQ(nullptr, view_manager.FindView(data_table.get(), {1}, {0}));
+  EXPECT_EQ(nullptr, view_manager.FindView(data_table.get(), {0}, {3}));
+
+  txn = txn_manager.BeginTransaction();
+  storage::AggregateView::GroupMap groups;
+  EXPECT_TRUE(view->GetGroups(txn, groups));
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(2U, groups.size());
+
+  auto &first_group = groups[{type::ValueFactory::GetIntegerValue(0)}];
+  EXPECT_EQ(6, first_group.row_count);
+  EXPECT_EQ(6, first_group.value_counts[0]);
+  EXPECT_EQ(105 + 101, first_group.sums[0].GetAs<int64_t>());
+  EXPECT_EQ(110 + 102, first_group.sums[1].GetAs<double>());
+
+  auto &second_group = groups[{type::ValueFactory::GetIntegerValue(10)}];
+  EXPECT_EQ(5, second_group.row_count);
+  EXPECT_EQ(355, second_group.sums[0].GetAs<int64_t>());
+
+  // A commit after the build is added as a delta
+  txn = txn_manager.BeginTransaction();
+  InsertGroupTuple(data_table.get(), 20, tuple_count + 1, txn);
+
+  // The writer sees its own insert only in its own scan
+  EXPECT_FALSE(view->GetGroups(txn, groups));
+  txn_manager.CommitTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  groups.clear();
+  EXPECT_TRUE(view->GetGroups(txn, groups));
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(3U, groups.size());
+  auto &third_group = groups[{type::ValueFactory::GetIntegerValue(20)}];
+  EXPECT_EQ(1, third_group.row_count);
+  EXPECT_EQ(111, third_group.sums[0].GetAs<int64_t>());
+
+  EXPECT_TRUE(view_manager.DropView("sum_view"));
+  EXPECT_FALSE(view_manager.DropView("sum_view"));
+  EXPECT_EQ(nullptr, view_manager.GetView("sum_view"));
+}
+
+TEST_F(AggregateViewTests, MergeTest) {
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+  storage::AggregateView view("merge_view", data_table.get(), {0}, {1});
+  EXPECT_EQ(0U, view.GetGroupOffset(0));
+  EXPECT_EQ(INVALID_OID, view.GetGroupOffset(1));
+  EXPECT_EQ(0U, view.GetAggregateOffset(1));
+  EXPECT_EQ(INVALID_OID, view.GetAggregateOffset(2));
+
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  storage::Tuple tuple(data_table->GetSchema(), true);
+  tuple.SetValue(0, type::ValueFactory::GetIntegerValue(1), testing_pool);
+  tuple.SetValue(1, type::ValueFactory::GetIntegerValue(7), testing_pool);
+  tuple.SetValue(2, type::ValueFactory::GetDecimalValue(0.5), testing_pool);
+  tuple.SetValue(3, type::ValueFactory::GetVarcharValue("merged"),
+                 testing_pool);
+
+  storage::AggregateView::GroupMap groups;
+  view.AddTuple(groups, &tuple, 1);
+  view.AddTuple(groups, &tuple, 1);
+  EXPECT_EQ(1U, groups.size());
+  EXPECT_EQ(2, groups.begin()->second.row_count);
+  EXPECT_EQ(14, groups.begin()->second.sums[0].GetAs<int64_t>());
+
+  // A delete of every row of the group drops it
+  storage::AggregateView::GroupMap delta;
+  view.AddTuple(delta, &tuple, -1);
+  storage::AggregateView::MergeGroups(groups, delta);
+  EXPECT_EQ(1, groups.begin()->second.row_count);
+  EXPECT_EQ(7, groups.begin()->second.sums[0].GetAs<int64_t>());
+  storage::AggregateView::MergeGroups(groups, delta);
+  EXPECT_EQ(0U, groups.size());
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// append_only_table_test.cpp
+//
+// Identification: test/storage/append_only_table_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "common/harness.h"
+
+#include "concurrency/testing_transaction_util.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Append-Only Table Tests
+//===--------------------------------------------------------------------===//
+
+class AppendOnlyTableTests : public PelotonTest {};
+
+TEST_F(AppendOnlyTableTests, VisibilityTest) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_oid = 24101;
+  storage_manager->AddDatabaseToStorageManager(
+      new storage::Database(database_oid));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // only an empty table can be made append-only
+  auto filled_table = TestingTransactionUtil::CreateTable(
+      10, "FILLED_TABLE", database_oid, 24102, 24103, true);
+  EXPECT_FALSE(filled_table->SetAppendOnly());
+  EXPECT_FALSE(filled_table->IsAppendOnly());
+
+  auto table = TestingTransactionUtil::CreateTable(
+      0, "APPEND_TABLE", database_oid, 24104, 24105, true);
+  EXPECT_TRUE(table->SetAppendOnly());
+  EXPECT_TRUE(table->IsAppendOnly());
+  auto tile_group_header = table->GetTileGroup(0)->GetHeader();
+  EXPECT_TRUE(tile_group_header->IsAppendOnly());
+
+  // the inserts in flight are checked one by one
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, 1, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, 2, 2));
+  EXPECT_EQ(0U, tile_group_header->GetVisibleAppendCount(MAX_CID - 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // once committed, the tile group is visible at once to later readers
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(2U, tile_group_header->GetVisibleAppendCount(txn->GetReadId()));
+  EXPECT_EQ(0U, tile_group_header->GetVisibleAppendCount(INVALID_CID));
+  std::vector<int> results;
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteScan(txn, results, table, 0));
+  EXPECT_EQ(2U, results.size());
+
+  // the tuples cannot be updated
+  EXPECT_FALSE(TestingTransactionUtil::ExecuteUpdate(txn, table, 1, 5));
+  txn_manager.AbortTransaction(txn);
+
+  // a rolled back insert leaves its slot empty, so the slots are checked
+  // one by one from then on
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteInsert(txn, table, 3, 3));
+  txn_manager.AbortTransaction(txn);
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(0U, tile_group_header->GetVisibleAppendCount(txn->GetReadId()));
+  results.clear();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteScan(txn, results, table, 0));
+  EXPECT_EQ(2U, results.size());
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  storage_manager->RemoveDatabaseFromStorageManager(database_oid);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -13,6 +13,7 @@
 #include "common/harness.h"
 
 #include "storage/backend_manager.h"
+#include "util/numa_util.h"
 
 namespace peloton {
 namespace test {
@@ -54,5 +55,44 @@ TEST_F(StorageManagerTests, BasicTest) {
   }
 }
 
+TEST_F(StorageManagerTests, NumaTest) {
+  peloton::storage::BackendManager backend_manager;
+
+  // Allocation on a node falls back gracefully on single-node machines
+  size_t length = 1 << 20;
+  for (int node = 0; node < NumaUtil::GetNodeCount(); node++) {
+    auto location = backend_manager.AllocateOnNode(length, node);
+    EXPECT_NE(nullptr, location);
+    PL_MEMSET(location, '-', length);
+    backend_manager.ReleaseOnNode(location, length);
+  }
+}
+
+TEST_F(StorageManagerTests, HugePageTest) {
+  peloton::storage::BackendManager backend_manager;
+
+  // Small blocks share an arena and are recycled by size
+  size_t length = 4096;
+  auto first = backend_manager.AllocateHugePages(length, INVALID_NUMA_NODE);
+  auto second = backend_manager.AllocateHugePages(length, INVALID_NUMA_NODE);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(1U, backend_manager.GetHugePageMappingCount());
+  PL_MEMSET(first, '-', length);
+  PL_MEMSET(second, '-', length);
+
+  backend_manager.ReleaseHugePages(first, length, INVALID_NUMA_NODE);
+  auto third = backend_manager.AllocateHugePages(length, INVALID_NUMA_NODE);
+  EXPECT_EQ(first, third);
+  backend_manager.ReleaseHugePages(second, length, INVALID_NUMA_NODE);
+  backend_manager.ReleaseHugePages(third, length, INVALID_NUMA_NODE);
+
+  // Large blocks get their own mapping
+  length = HUGE_PAGE_SIZE + 1;
+  auto location = backend_manager.AllocateHugePages(length, INVALID_NUMA_NODE);
+  EXPECT_EQ(2U, backend_manager.GetHugePageMappingCount());
+  PL_MEMSET(location, '-', length);
+  backend_manager.ReleaseHugePages(location, length, INVALID_NUMA_NODE);
+}
+
 }  // End test namespace
 }  // End peloton namespace
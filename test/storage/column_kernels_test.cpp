@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// column_kernels_test.cpp
+//
+// Identification: test/storage/column_kernels_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "storage/column_kernels.h"
+#include "storage/tile.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+class ColumnKernelsTests : public PelotonTest {};
+
+namespace {
+
+const oid_t kTupleCount = 37;
+
+const std::vector<type::TypeId> kColumnTypes = {
+    type::TypeId::TINYINT, type::TypeId::SMALLINT, type::TypeId::INTEGER,
+    type::TypeId::BIGINT, type::TypeId::DECIMAL};
+
+// A tile with a column of every supported type, whose value at tuple i is
+// i % 9 - 4, and NULL for every seventh tuple
+class KernelTile {
+ public:
+  KernelTile() : header_(BackendType::MM, kTupleCount) {
+    std::vector<catalog::Column> columns;
+    for (auto type_id : kColumnTypes) {
+      columns.emplace_back(type_id, type::Type::GetTypeSize(type_id),
+                           TypeIdToString(type_id), true);
+    }
+    schema_.reset(new catalog::Schema(columns));
+    tile_.reset(storage::TileFactory::GetTile(
+        BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+        &header_, *schema_, nullptr, kTupleCount));
+
+    for (oid_t tuple_id = 0; tuple_id < kTupleCount; tuple_id++) {
+      for (oid_t column_id = 0; column_id < kColumnTypes.size();
+           column_id++) {
+        tile_->SetValue(GetValue(tuple_id, column_id), tuple_id, column_id);
+      }
+    }
+  }
+
+  type::Value GetValue(oid_t tuple_id, oid_t column_id) const {
+    type::TypeId type_id = kColumnTypes[column_id];
+    if (tuple_id % 7 == 3) {
+      return type::ValueFactory::GetNullValueByType(type_id);
+    }
+    return type::ValueFactory::GetIntegerValue(
+               static_cast<int32_t>(tuple_id % 9) - 4)
+        .CastAs(type_id);
+  }
+
+  const storage::Tile *GetTile() const { return tile_.get(); }
+
+ private:
+  storage::TileGroupHeader header_;
+  std::unique_ptr<catalog::Schema> schema_;
+  std::unique_ptr<storage::Tile> tile_;
+};
+
+type::CmpBool CompareValues(ExpressionType compare_type,
+                            const type::Value &left,
+                            const type::Value &right) {
+  switch (compare_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return left.CompareEquals(right);
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return left.CompareNotEquals(right);
+    case ExpressionType::COMPARE_LESSTHAN:
+      return left.CompareLessThan(right);
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return left.CompareGreaterThan(right);
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return left.CompareLessThanEquals(right);
+    default:
+      return left.CompareGreaterThanEquals(right);
+  }
+}
+
+}  // namespace
+
+TEST_F(ColumnKernelsTests, CompareTest) {
+  KernelTile kernel_tile;
+
+  // The tuples in a different order, so that the gathers are not sequential
+  std::vector<oid_t> tuple_ids;
+  for (oid_t tuple_id = 0; tuple_id < kTupleCount; tuple_id++) {
+    tuple_ids.push_back((tuple_id * 5) % kTupleCount);
+  }
+
+  std::vector<ExpressionType> compare_types = {
+      ExpressionType::COMPARE_EQUAL,
+      ExpressionType::COMPARE_NOTEQUAL,
+      ExpressionType::COMPARE_LESSTHAN,
+      ExpressionType::COMPARE_GREATERTHAN,
+      ExpressionType::COMPARE_LESSTHANOREQUALTO,
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO};
+  std::vector<type::Value> constants = {
+      type::ValueFactory::GetIntegerValue(4),
+      type::ValueFactory::GetBigIntValue(-4),
+      type::ValueFactory::GetTinyIntValue(0),
+      type::ValueFactory::GetBigIntValue(1LL << 40),
+      type::ValueFactory::GetDecimalValue(2.5),
+      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER)};
+
+  for (oid_t column_id = 0; column_id < kColumnTypes.size(); column_id++) {
+    storage::TileColumn column(kernel_tile.GetTile(), column_id);
+    EXPECT_TRUE(storage::ColumnKernels::IsSupported(column.type_id));
+    for (auto compare_type : compare_types) {
+      for (auto &constant : constants) {
+        std::vector<type::CmpBool> results(tuple_ids.size());
+        storage::ColumnKernels::Compare(column, compare_type, constant,
+                                        tuple_ids.data(), tuple_ids.size(),
+                                        results.data());
+
+        std::vector<oid_t> selected(tuple_ids.size());
+        size_t selected_count = storage::ColumnKernels::Filter(
+            column, compare_type, constant, tuple_ids.data(),
+            tuple_ids.size(), selected.data());
+
+        size_t expected_count = 0;
+        for (size_t i = 0; i < tuple_ids.size(); i++) {
+          auto expected = CompareValues(
+              compare_type, kernel_tile.GetValue(tuple_ids[i], column_id),
+              constant);
+          EXPECT_EQ(expected, results[i]);
+          if (expected == type::CMP_TRUE) {
+            ASSERT_LT(expected_count, selected_count);
+            EXPECT_EQ(tuple_ids[i], selected[expected_count]);
+            expected_count++;
+          }
+        }
+        EXPECT_EQ(expected_count, selected_count);
+      }
+    }
+  }
+}
+
+TEST_F(ColumnKernelsTests, AggregateTest) {
+  KernelTile kernel_tile;
+  std::vector<oid_t> tuple_ids;
+  for (oid_t tuple_id = 0; tuple_id < kTupleCount; tuple_id++) {
+    tuple_ids.push_back(tuple_id);
+  }
+
+  for (oid_t column_id = 0; column_id < kColumnTypes.size(); column_id++) {
+    storage::TileColumn column(kernel_tile.GetTile(), column_id);
+
+    // Aggregated in two batches, which are added up
+    storage::ColumnAggregate aggregate;
+    storage::ColumnKernels::Aggregate(column, tuple_ids.data(), 20, aggregate);
+    storage::ColumnKernels::Aggregate(column, tuple_ids.data() + 20,
+                                      tuple_ids.size() - 20, aggregate);
+
+    int64_t sum = 0;
+    uint64_t count = 0;
+    for (oid_t tuple_id = 0; tuple_id < kTupleCount; tuple_id++) {
+      if (tuple_id % 7 != 3) {
+        sum += static_cast<int64_t>(tuple_id % 9) - 4;
+        count++;
+      }
+    }
+    EXPECT_EQ(kTupleCount, aggregate.row_count);
+    EXPECT_EQ(count, aggregate.count);
+    EXPECT_EQ(kColumnTypes[column_id], aggregate.sum.GetTypeId());
+    EXPECT_EQ(type::CMP_TRUE,
+              aggregate.sum.CompareEquals(
+                  type::ValueFactory::GetBigIntValue(sum)));
+    EXPECT_EQ(type::CMP_TRUE, aggregate.min.CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(-4)));
+    EXPECT_EQ(type::CMP_TRUE, aggregate.max.CompareEquals(
+                                  type::ValueFactory::GetIntegerValue(4)));
+  }
+
+  // Only NULLs leave the values NULL
+  storage::TileColumn column(kernel_tile.GetTile(), 2);
+  oid_t null_tuple = 3;
+  storage::ColumnAggregate aggregate;
+  storage::ColumnKernels::Aggregate(column, &null_tuple, 1, aggregate);
+  EXPECT_EQ(1U, aggregate.row_count);
+  EXPECT_EQ(0U, aggregate.count);
+  EXPECT_TRUE(aggregate.sum.IsNull());
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -15,8 +15,14 @@
 #include "storage/data_table.h"
 
 #include "executor/testing_executor_util.h"
+#include "expression/expression_util.h"
+#include "index/index_factory.h"
+#include "planner/project_info.h"
 #include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 #include "storage/database.h"
+#include "type/ephemeral_pool.h"
+#include "type/value_factory.h"
 
 #include "concurrency/transaction_manager_factory.h"
 
@@ -72,6 +78,234 @@ TEST_F(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+TEST_F(DataTableTests, RelayoutTileGroupTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Fill the first tile group
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuple_count, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  storage::column_map_type column_map;
+  column_map[0] = std::make_pair(0, 0);
+  column_map[1] = std::make_pair(0, 1);
+  column_map[2] = std::make_pair(1, 0);
+  column_map[3] = std::make_pair(1, 1);
+  data_table->SetDefaultLayout(column_map);
+  auto theta = 0.0001;
+
+  // Not while a transaction owns one of its tuples
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(txn_manager.AcquireOwnership(txn, tile_group_header, 0));
+  EXPECT_EQ(nullptr, data_table->RelayoutTileGroup(0, theta));
+  txn_manager.YieldOwnership(txn, tile_group_header, 0);
+  txn_manager.CommitTransaction(txn);
+
+  auto new_tile_group = data_table->RelayoutTileGroup(0, theta);
+  ASSERT_NE(nullptr, new_tile_group);
+  EXPECT_EQ(new_tile_group, data_table->GetTileGroup(0).get());
+  EXPECT_EQ(2U, new_tile_group->GetTileCount());
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    for (oid_t column_id = 0; column_id < 4; column_id++) {
+      EXPECT_EQ(type::CMP_TRUE,
+                tile_group->GetValue(tuple_id, column_id)
+                    .CompareEquals(
+                        new_tile_group->GetValue(tuple_id, column_id)));
+    }
+  }
+
+  // Writers still holding the original cannot write to it
+  txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(txn_manager.AcquireOwnership(txn, tile_group_header, 0));
+  EXPECT_TRUE(
+      txn_manager.AcquireOwnership(txn, new_tile_group->GetHeader(), 0));
+  txn_manager.YieldOwnership(txn, new_tile_group->GetHeader(), 0);
+  txn_manager.CommitTransaction(txn);
+
+  // Already in the layout
+  EXPECT_EQ(nullptr, data_table->RelayoutTileGroup(0, theta));
+}
+
+// Build tuples of the testing table with col_0 = 10 * key
+std::vector<std::unique_ptr<storage::Tuple>> BuildBulkTuples(
+    const catalog::Schema *schema, const std::vector<int> &keys) {
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  for (auto key : keys) {
+    std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+    for (oid_t column_id = 0; column_id < 2; column_id++) {
+      tuple->SetValue(column_id,
+                      type::ValueFactory::GetIntegerValue(
+                          TestingExecutorUtil::PopulatedValue(key, column_id)),
+                      testing_pool);
+    }
+    tuple->SetValue(2, type::ValueFactory::GetDecimalValue(
+                           TestingExecutorUtil::PopulatedValue(key, 2)),
+                    testing_pool);
+    tuple->SetValue(3, type::ValueFactory::GetVarcharValue(std::to_string(
+                           TestingExecutorUtil::PopulatedValue(key, 3))),
+                    testing_pool);
+    tuples.push_back(std::move(tuple));
+  }
+  return tuples;
+}
+
+TEST_F(DataTableTests, BulkInsertTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  const int tuple_count = tuples_per_tilegroup * 2 + 1;
+
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, true));
+  auto initial_tile_group_count = data_table->GetTileGroupCount();
+
+  // Load the keys in reverse order
+  std::vector<int> keys;
+  for (int key = tuple_count - 1; key >= 0; key--) {
+    keys.push_back(key);
+  }
+  auto tuples = BuildBulkTuples(data_table->GetSchema(), keys);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(data_table->BulkInsert(tuples, txn));
+
+  // The batch fills three new tile groups
+  EXPECT_EQ(initial_tile_group_count + 3, data_table->GetTileGroupCount());
+  EXPECT_EQ(static_cast<size_t>(tuple_count), data_table->GetTupleCount());
+
+  auto tile_group_header =
+      data_table->GetTileGroup(initial_tile_group_count)->GetHeader();
+  EXPECT_EQ(txn->GetTransactionId(), tile_group_header->GetTransactionId(0));
+  EXPECT_EQ(MAX_CID, tile_group_header->GetBeginCommitId(0));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // The whole batch is committed at once
+  for (oid_t tuple_id = 0; tuple_id < TESTS_TUPLES_PER_TILEGROUP; tuple_id++) {
+    EXPECT_EQ(INITIAL_TXN_ID, tile_group_header->GetTransactionId(tuple_id));
+    EXPECT_NE(MAX_CID, tile_group_header->GetBeginCommitId(tuple_id));
+    EXPECT_EQ(MAX_CID, tile_group_header->GetEndCommitId(tuple_id));
+    EXPECT_NE(nullptr, tile_group_header->GetIndirection(tuple_id));
+  }
+
+  std::vector<ItemPointer *> index_entries;
+  data_table->GetIndex(0)->ScanAllKeys(index_entries);
+  EXPECT_EQ(static_cast<size_t>(tuple_count), index_entries.size());
+
+  // A duplicate primary key fails the load
+  auto duplicate_tuples = BuildBulkTuples(data_table->GetSchema(), {0});
+  txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(data_table->BulkInsert(duplicate_tuples, txn));
+  EXPECT_EQ(ResultType::ABORTED, txn_manager.AbortTransaction(txn));
+}
+
+TEST_F(DataTableTests, PartialIndexTest) {
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP * 2;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+
+  // Index column 0 of the tuples whose column 1 is below that of row 10
+  auto tuple_schema = data_table->GetSchema();
+  std::vector<oid_t> key_attrs = {0};
+  auto key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+  auto index_metadata = new index::IndexMetadata(
+      "partial_index", 125, INVALID_OID, INVALID_OID, IndexType::BWTREE,
+      IndexConstraintType::DEFAULT, tuple_schema, key_schema, key_attrs,
+      false);
+  std::shared_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ComparisonFactory(
+          ExpressionType::COMPARE_LESSTHAN,
+          expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER,
+                                                        0, 1),
+          expression::ExpressionUtil::ConstantValueFactory(
+              type::ValueFactory::GetIntegerValue(
+                  TestingExecutorUtil::PopulatedValue(10, 1)))));
+  index_metadata->SetPredicate(predicate);
+  EXPECT_EQ(std::set<oid_t>({1}), index_metadata->GetPredicateColumns());
+  std::shared_ptr<index::Index> partial_index(
+      index::IndexFactory::GetIndex(index_metadata));
+  data_table->AddIndex(partial_index);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The full indexes hold every tuple, the partial index the first ten
+  std::vector<ItemPointer *> index_entries;
+  data_table->GetIndex(0)->ScanAllKeys(index_entries);
+  EXPECT_EQ(static_cast<size_t>(tuple_count), index_entries.size());
+  index_entries.clear();
+  partial_index->ScanAllKeys(index_entries);
+  EXPECT_EQ(10U, index_entries.size());
+}
+
+TEST_F(DataTableTests, HeapOnlyUpdateTest) {
+  const int tuple_count = 10;
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The secondary index is on the columns 0 and 1
+  auto secondary_index = data_table->GetIndex(1);
+  auto count_entries = [&secondary_index]() {
+    std::vector<ItemPointer *> index_entries;
+    secondary_index->ScanAllKeys(index_entries);
+    return index_entries.size();
+  };
+  EXPECT_EQ(static_cast<size_t>(tuple_count), count_entries());
+
+  // The versions of the update of the first tuple
+  auto schema = data_table->GetSchema();
+  type::EphemeralPool pool;
+  storage::Tuple old_tuple(schema, true), new_tuple(schema, true);
+  for (oid_t column_id = 0; column_id < schema->GetColumnCount();
+       column_id++) {
+    auto value = data_table->GetTileGroup(0)->GetValue(0, column_id);
+    old_tuple.SetValue(column_id, value, &pool);
+    new_tuple.SetValue(column_id, value, &pool);
+  }
+  auto *indirection =
+      data_table->GetTileGroup(0)->GetHeader()->GetIndirection(0);
+
+  txn = txn_manager.BeginTransaction();
+
+  // Updating a column that is not indexed leaves the index alone
+  new_tuple.SetValue(2, type::ValueFactory::GetDecimalValue(0.5), &pool);
+  TargetList targets = {{2, planner::DerivedAttribute(nullptr)}};
+  EXPECT_TRUE(data_table->InstallVersion(&new_tuple, &targets, txn,
+                                         indirection, &old_tuple));
+  EXPECT_EQ(static_cast<size_t>(tuple_count), count_entries());
+
+  // So does setting an indexed column to the value it had
+  targets.emplace_back(1, planner::DerivedAttribute(nullptr));
+  EXPECT_TRUE(data_table->InstallVersion(&new_tuple, &targets, txn,
+                                         indirection, &old_tuple));
+  EXPECT_EQ(static_cast<size_t>(tuple_count), count_entries());
+
+  // A new key gets an entry
+  new_tuple.SetValue(
+      1, type::ValueFactory::GetIntegerValue(
+             TestingExecutorUtil::PopulatedValue(tuple_count, 1)),
+      &pool);
+  EXPECT_TRUE(data_table->InstallVersion(&new_tuple, &targets, txn,
+                                         indirection, &old_tuple));
+  EXPECT_EQ(static_cast<size_t>(tuple_count + 1), count_entries());
+
+  txn_manager.CommitTransaction(txn);
+}
+
 std::unique_ptr<storage::DataTable> data_table_test_table;
 
 TEST_F(DataTableTests, GlobalTableTest) {
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// foreign_key_cache_test.cpp
+//
+// Identification: test/storage/foreign_key_cache_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "catalog/foreign_key.h"
+#include "concurrency/testing_transaction_util.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/foreign_key_cache.h"
+#include "storage/storage_manager.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Foreign Key Cache Tests
+//===--------------------------------------------------------------------===//
+
+class ForeignKeyCacheTests : public PelotonTest {};
+
+namespace {
+
+std::unique_ptr<storage::Tuple> MakeTuple(const catalog::Schema *schema,
+                                          int32_t id, int32_t value) {
+  std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
+  tuple->SetValue(0, type::ValueFactory::GetIntegerValue(id), nullptr);
+  tuple->SetValue(1, type::ValueFactory::GetIntegerValue(value), nullptr);
+  return tuple;
+}
+
+}  // namespace
+
+TEST_F(ForeignKeyCacheTests, CacheTest) {
+  auto id_column = catalog::Column(
+      type::TypeId::INTEGER, type::Type::GetTypeSize(type::TypeId::INTEGER),
+      "id", true);
+  auto value_column = catalog::Column(
+      type::TypeId::INTEGER, type::Type::GetTypeSize(type::TypeId::INTEGER),
+      "value", true);
+  std::unique_ptr<catalog::Schema> schema(
+      new catalog::Schema({id_column, value_column}));
+
+  auto first = storage::ForeignKeyCache::MakeKey(
+      MakeTuple(schema.get(), 1, 2).get());
+  auto same = storage::ForeignKeyCache::MakeKey(
+      MakeTuple(schema.get(), 1, 2).get());
+  auto swapped = storage::ForeignKeyCache::MakeKey(
+      MakeTuple(schema.get(), 2, 1).get());
+  EXPECT_EQ(first, same);
+  EXPECT_NE(first, swapped);
+
+  catalog::ForeignKey foreign_key(1, {"id"}, {0}, {"id"}, {0}, 'r', 'c',
+                                  "FK");
+  catalog::ForeignKey other_key(1, {"id"}, {0}, {"id"}, {0}, 'r', 'c',
+                                "OTHER_FK");
+  storage::ForeignKeyCache cache;
+  cache.Add(&foreign_key, first);
+  cache.Add(&foreign_key, same);
+  EXPECT_TRUE(cache.Contains(&foreign_key, same));
+  EXPECT_FALSE(cache.Contains(&foreign_key, swapped));
+  EXPECT_FALSE(cache.Contains(&other_key, first));
+  EXPECT_EQ(1U, cache.GetKeyCount());
+
+  cache.Clear();
+  EXPECT_FALSE(cache.Contains(&foreign_key, first));
+  EXPECT_EQ(0U, cache.GetKeyCount());
+}
+
+TEST_F(ForeignKeyCacheTests, BatchedCheckTest) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_oid = 24001;
+  storage_manager->AddDatabaseToStorageManager(
+      new storage::Database(database_oid));
+
+  // the parent table holds the keys 0 to 9
+  TestingTransactionUtil::CreateTable(10, "PARENT_TABLE", database_oid, 24002,
+                                      24003, true);
+  auto child_table = TestingTransactionUtil::CreateTable(
+      0, "CHILD_TABLE", database_oid, 24004, 24005, true);
+  catalog::ForeignKey foreign_key(24002, {"id"}, {0}, {"value"}, {1}, 'r',
+                                  'c', "CHILD_FK");
+  child_table->AddForeignKey(&foreign_key);
+  auto schema = child_table->GetSchema();
+
+  // a key that repeats is probed and cached once
+  std::vector<std::unique_ptr<storage::Tuple>> tuples;
+  tuples.push_back(MakeTuple(schema, 0, 3));
+  tuples.push_back(MakeTuple(schema, 1, 3));
+  tuples.push_back(MakeTuple(schema, 2, 7));
+  std::vector<const storage::Tuple *> tuple_ptrs;
+  for (auto &tuple : tuples) {
+    tuple_ptrs.push_back(tuple.get());
+  }
+  storage::ForeignKeyCache cache;
+  EXPECT_TRUE(child_table->CheckForeignKeyConstraints(tuple_ptrs, &cache));
+  EXPECT_EQ(2U, cache.GetKeyCount());
+
+  // a missing key fails the check, and only the keys found are cached
+  tuples.push_back(MakeTuple(schema, 3, 20));
+  tuples.push_back(MakeTuple(schema, 4, 5));
+  tuple_ptrs.push_back(tuples[3].get());
+  tuple_ptrs.push_back(tuples[4].get());
+  EXPECT_FALSE(child_table->CheckForeignKeyConstraints(tuple_ptrs, &cache));
+  EXPECT_EQ(3U, cache.GetKeyCount());
+  std::vector<const storage::Tuple *> missing = {tuple_ptrs[3]};
+  EXPECT_FALSE(child_table->CheckForeignKeyConstraints(missing));
+
+  storage_manager->RemoveDatabaseFromStorageManager(database_oid);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,406 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// frozen_tile_group_test.cpp
+//
+// Identification: test/storage/frozen_tile_group_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "executor/testing_executor_util.h"
+#include "expression/expression_util.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/frozen_tile_group.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_classifier.h"
+#include "storage/tile_group_evictor.h"
+#include "storage/tile_group_freezer.h"
+#include "storage/tile_group_header.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Frozen Tile Group Tests
+//===--------------------------------------------------------------------===//
+
+class FrozenTileGroupTests : public PelotonTest {};
+
+TEST_F(FrozenTileGroupTests, ColumnEncodingTest) {
+  std::vector<type::Value> runs;
+  std::vector<type::Value> packed;
+  std::vector<type::Value> strings;
+  for (int i = 0; i < 1000; i++) {
+    runs.push_back(type::ValueFactory::GetIntegerValue(i / 100));
+    packed.push_back(type::ValueFactory::GetBigIntValue(1000000 + i * 7));
+    strings.push_back(
+        type::ValueFactory::GetVarcharValue(std::to_string(i % 3)));
+  }
+  runs[5] = type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER);
+  strings[7] = type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR);
+
+  storage::FrozenColumn runs_column(type::TypeId::INTEGER, runs);
+  storage::FrozenColumn packed_column(type::TypeId::BIGINT, packed);
+  storage::FrozenColumn strings_column(type::TypeId::VARCHAR, strings);
+
+  EXPECT_EQ(storage::ColumnEncodingType::RUN_LENGTH,
+            runs_column.GetEncodingType());
+  EXPECT_EQ(storage::ColumnEncodingType::BIT_PACKED,
+            packed_column.GetEncodingType());
+  EXPECT_EQ(storage::ColumnEncodingType::DICTIONARY,
+            strings_column.GetEncodingType());
+  EXPECT_EQ(4U, strings_column.GetEntryCount());
+
+  for (oid_t i = 0; i < 1000; i++) {
+    auto run_value = runs_column.GetValue(i);
+    auto string_value = strings_column.GetValue(i);
+    EXPECT_EQ(runs[i].IsNull(), run_value.IsNull());
+    EXPECT_EQ(strings[i].IsNull(), string_value.IsNull());
+    if (run_value.IsNull() == false) {
+      EXPECT_EQ(type::CmpBool::CMP_TRUE, runs[i].CompareEquals(run_value));
+    }
+    if (string_value.IsNull() == false) {
+      EXPECT_EQ(type::CmpBool::CMP_TRUE,
+                strings[i].CompareEquals(string_value));
+    }
+    EXPECT_EQ(type::CmpBool::CMP_TRUE,
+              packed[i].CompareEquals(packed_column.GetValue(i)));
+  }
+
+  // The encoded columns must be smaller than their fixed-width form
+  EXPECT_LT(runs_column.GetMemorySize(), 1000 * sizeof(int32_t));
+  EXPECT_LT(packed_column.GetMemorySize(), 1000 * sizeof(int64_t));
+}
+
+TEST_F(FrozenTileGroupTests, FilterComparisonTest) {
+  std::vector<type::Value> runs;
+  std::vector<type::Value> packed;
+  std::vector<type::Value> strings;
+  for (int i = 0; i < 1000; i++) {
+    runs.push_back(type::ValueFactory::GetIntegerValue(i / 100));
+    packed.push_back(type::ValueFactory::GetBigIntValue(1000000 + i * 7));
+    strings.push_back(
+        type::ValueFactory::GetVarcharValue(std::to_string(i % 5)));
+  }
+  runs[5] = type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER);
+  packed[9] = type::ValueFactory::GetNullValueByType(type::TypeId::BIGINT);
+  strings[7] = type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR);
+
+  storage::FrozenColumn runs_column(type::TypeId::INTEGER, runs);
+  storage::FrozenColumn packed_column(type::TypeId::BIGINT, packed);
+  storage::FrozenColumn strings_column(type::TypeId::VARCHAR, strings);
+
+  std::vector<ExpressionType> comparisons = {
+      ExpressionType::COMPARE_EQUAL,
+      ExpressionType::COMPARE_NOTEQUAL,
+      ExpressionType::COMPARE_LESSTHAN,
+      ExpressionType::COMPARE_LESSTHANOREQUALTO,
+      ExpressionType::COMPARE_GREATERTHAN,
+      ExpressionType::COMPARE_GREATERTHANOREQUALTO};
+
+  // Filter every other tuple by the comparison, and check that exactly the
+  // ones whose values satisfy it are kept
+  auto check = [&comparisons](const storage::FrozenColumn &column,
+                              const std::vector<type::Value> &values,
+                              const type::Value &constant) {
+    for (auto comparison : comparisons) {
+      std::vector<uint32_t> selection;
+      for (uint32_t i = 0; i < values.size(); i += 2) {
+        selection.push_back(i);
+      }
+      uint32_t kept = column.FilterComparison(
+          comparison, constant, selection.data(), selection.size());
+
+      std::vector<uint32_t> expected;
+      for (uint32_t i = 0; i < values.size(); i += 2) {
+        type::CmpBool result = type::CmpBool::CMP_FALSE;
+        if (values[i].IsNull() == false) {
+          switch (comparison) {
+            case ExpressionType::COMPARE_EQUAL:
+              result = values[i].CompareEquals(constant);
+              break;
+            case ExpressionType::COMPARE_NOTEQUAL:
+              result = values[i].CompareNotEquals(constant);
+              break;
+            case ExpressionType::COMPARE_LESSTHAN:
+              result = values[i].CompareLessThan(constant);
+              break;
+            case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+              result = values[i].CompareLessThanEquals(constant);
+              break;
+            case ExpressionType::COMPARE_GREATERTHAN:
+              result = values[i].CompareGreaterThan(constant);
+              break;
+            default:
+              result = values[i].CompareGreaterThanEquals(constant);
+              break;
+          }
+        }
+        if (result == type::CmpBool::CMP_TRUE) {
+          expected.push_back(i);
+        }
+      }
+
+      ASSERT_EQ(expected.size(), kept);
+      for (uint32_t i = 0; i < kept; i++) {
+        EXPECT_EQ(expected[i], selection[i]);
+      }
+    }
+  };
+
+  check(runs_column, runs, type::ValueFactory::GetIntegerValue(4));
+  check(runs_column, runs, type::ValueFactory::GetBigIntValue(0));
+  check(packed_column, packed, type::ValueFactory::GetBigIntValue(1003500));
+  check(packed_column, packed, type::ValueFactory::GetIntegerValue(5));
+  check(strings_column, strings, type::ValueFactory::GetVarcharValue("2"));
+  check(strings_column, strings, type::ValueFactory::GetVarcharValue("9"));
+
+  // Comparisons with NULL are never true
+  std::vector<uint32_t> selection = {0, 1, 2};
+  auto null_value =
+      type::ValueFactory::GetNullValueByType(type::TypeId::BIGINT);
+  EXPECT_EQ(0U, packed_column.FilterComparison(
+                    ExpressionType::COMPARE_NOTEQUAL, null_value,
+                    selection.data(), selection.size()));
+}
+
+TEST_F(FrozenTileGroupTests, SharedDictionaryTest) {
+  auto make_strings = [](const std::vector<std::string> &strings) {
+    std::vector<type::Value> values;
+    for (auto &string : strings) {
+      values.push_back(type::ValueFactory::GetVarcharValue(string));
+    }
+    return values;
+  };
+  auto check_values = [](const storage::FrozenColumn &column,
+                         const std::vector<type::Value> &values) {
+    for (oid_t i = 0; i < values.size(); i++) {
+      auto value = column.GetValue(i);
+      EXPECT_EQ(values[i].IsNull(), value.IsNull());
+      if (value.IsNull() == false) {
+        EXPECT_EQ(type::CmpBool::CMP_TRUE, values[i].CompareEquals(value));
+      }
+    }
+  };
+
+  std::shared_ptr<const storage::FrozenDictionary> shared_dictionary;
+  auto first = make_strings({"b", "d", "b"});
+  storage::FrozenColumn first_column(type::TypeId::VARCHAR, first,
+                                     &shared_dictionary);
+  EXPECT_EQ(first_column.GetDictionary(), shared_dictionary.get());
+  check_values(first_column, first);
+
+  // A column with no new values uses the same dictionary
+  auto second = make_strings({"d", "d"});
+  storage::FrozenColumn second_column(type::TypeId::VARCHAR, second,
+                                      &shared_dictionary);
+  EXPECT_EQ(first_column.GetDictionary(), second_column.GetDictionary());
+  check_values(second_column, second);
+
+  // New values replace it with a larger one, which stays sorted with NULL
+  // last. The columns frozen before keep theirs.
+  auto third = make_strings({"c", "a"});
+  third.push_back(
+      type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR));
+  storage::FrozenColumn third_column(type::TypeId::VARCHAR, third,
+                                     &shared_dictionary);
+  EXPECT_EQ(third_column.GetDictionary(), shared_dictionary.get());
+  EXPECT_NE(first_column.GetDictionary(), third_column.GetDictionary());
+  EXPECT_EQ(2U, first_column.GetEntryCount());
+  check_values(first_column, first);
+  check_values(third_column, third);
+
+  auto dictionary = third_column.GetDictionary();
+  EXPECT_EQ(5U, dictionary->GetEntryCount());
+  EXPECT_EQ(4U, dictionary->GetNonNullCount());
+  for (uint32_t code = 1; code < dictionary->GetNonNullCount(); code++) {
+    EXPECT_EQ(type::CmpBool::CMP_TRUE,
+              dictionary->GetValue(code - 1).CompareLessThan(
+                  dictionary->GetValue(code)));
+  }
+  EXPECT_TRUE(dictionary->GetValue(4).IsNull());
+
+  std::vector<uint32_t> selection = {0, 1, 2};
+  EXPECT_EQ(1U, third_column.FilterComparison(
+                    ExpressionType::COMPARE_LESSTHAN,
+                    type::ValueFactory::GetVarcharValue("b"),
+                    selection.data(), selection.size()));
+  EXPECT_EQ(1U, selection[0]);
+
+  // Columns with too many values keep a dictionary of their own
+  std::vector<std::string> many;
+  for (size_t i = 0; i < storage::FrozenDictionary::kMaxSharedSize; i++) {
+    many.push_back(std::to_string(i));
+  }
+  auto fourth = make_strings(many);
+  storage::FrozenColumn fourth_column(type::TypeId::VARCHAR, fourth,
+                                      &shared_dictionary);
+  EXPECT_EQ(dictionary, shared_dictionary.get());
+  EXPECT_EQ(fourth.size(), fourth_column.GetEntryCount());
+  check_values(fourth_column, fourth);
+}
+
+TEST_F(FrozenTileGroupTests, FreezeAndThawTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  const int tuple_count = tuples_per_tilegroup * 2 + 1;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto &freezer = storage::TileGroupFreezer::GetInstance();
+
+  // Nothing is older than the GC horizon yet
+  EXPECT_EQ(0U, freezer.FreezeTable(data_table.get(), INVALID_CID));
+
+  // The two full tile groups are frozen, the active one is not
+  EXPECT_EQ(2U, freezer.FreezeTable(data_table.get(), MAX_CID - 1));
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  EXPECT_TRUE(tile_group_header->IsFrozen());
+  EXPECT_FALSE(data_table->GetTileGroup(2)->GetHeader()->IsFrozen());
+
+  auto frozen_tile_group = tile_group->GetFrozenTileGroup();
+  EXPECT_NE(nullptr, frozen_tile_group.get());
+  LOG_INFO("%s", frozen_tile_group->GetInfo().c_str());
+
+  oid_t column_count = data_table->GetSchema()->GetColumnCount();
+  for (oid_t tuple_id = 0; tuple_id < frozen_tile_group->GetTupleCount();
+       tuple_id++) {
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      auto expected = tile_group->GetValue(tuple_id, column_id);
+      auto actual = frozen_tile_group->GetValue(tuple_id, column_id);
+      EXPECT_EQ(type::CmpBool::CMP_TRUE, expected.CompareEquals(actual));
+    }
+  }
+
+  // A writer thaws the tile group when it takes ownership of a tuple
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(txn_manager.AcquireOwnership(txn, tile_group_header, 0));
+  EXPECT_FALSE(tile_group_header->IsFrozen());
+  EXPECT_EQ(nullptr, tile_group->GetFrozenTileGroup().get());
+  txn_manager.YieldOwnership(txn, tile_group_header, 0);
+  txn_manager.AbortTransaction(txn);
+
+  // The next pass freezes the tile group again
+  EXPECT_EQ(1U, freezer.FreezeTable(data_table.get(), MAX_CID - 1));
+  EXPECT_TRUE(tile_group_header->IsFrozen());
+}
+
+TEST_F(FrozenTileGroupTests, ReleaseTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  const int tuple_count = tuples_per_tilegroup * 2 + 1;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  oid_t column_count = data_table->GetSchema()->GetColumnCount();
+  std::vector<type::Value> values;
+  for (oid_t tuple_id = 0; tuple_id < (oid_t)tuples_per_tilegroup;
+       tuple_id++) {
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      values.push_back(tile_group->GetValue(tuple_id, column_id));
+    }
+  }
+  auto check_values = [&]() {
+    size_t value_itr = 0;
+    for (oid_t tuple_id = 0; tuple_id < (oid_t)tuples_per_tilegroup;
+         tuple_id++) {
+      for (oid_t column_id = 0; column_id < column_count; column_id++) {
+        EXPECT_EQ(type::CMP_TRUE,
+                  values[value_itr++].CompareEquals(
+                      tile_group->GetValue(tuple_id, column_id)));
+      }
+    }
+  };
+
+  // Freezing releases the tuple slots, whether the evictor runs or not
+  auto &freezer = storage::TileGroupFreezer::GetInstance();
+  EXPECT_EQ(2U, freezer.FreezeTable(data_table.get(), MAX_CID - 1));
+  EXPECT_TRUE(tile_group->IsReleased());
+  EXPECT_FALSE(data_table->GetTileGroup(2)->IsReleased());
+  EXPECT_EQ(0U, storage::TileGroupEvictor::GetResidentSize(tile_group.get()));
+  storage::TileGroupEvictor evictor;
+  EXPECT_FALSE(evictor.EvictTileGroup(tile_group.get()));
+
+  // The values and the scans are read from the frozen copy
+  check_values();
+
+  auto predicate = expression::ExpressionUtil::ComparisonFactory(
+      ExpressionType::COMPARE_LESSTHAN,
+      expression::ExpressionUtil::TupleValueFactory(type::TypeId::INTEGER, 0,
+                                                    1),
+      expression::ExpressionUtil::ConstantValueFactory(
+          type::ValueFactory::GetIntegerValue(
+              TestingExecutorUtil::PopulatedValue(3, 1))));
+  planner::SeqScanPlan node(data_table.get(), predicate, {0, 3});
+
+  txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+  executor::SeqScanExecutor executor(&node, context.get());
+  EXPECT_TRUE(executor.Init());
+  EXPECT_TRUE(executor.Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_FALSE(executor.Execute());
+  txn_manager.CommitTransaction(txn);
+
+  EXPECT_EQ(3U, result_tile->GetTupleCount());
+  oid_t tuple_id = 0;
+  for (oid_t tuple_itr : *result_tile) {
+    EXPECT_EQ(tuple_id, tuple_itr);
+    EXPECT_EQ(type::CMP_TRUE,
+              result_tile->GetValue(tuple_itr, 0).CompareEquals(
+                  type::ValueFactory::GetIntegerValue(
+                      TestingExecutorUtil::PopulatedValue(tuple_id, 0))));
+    EXPECT_EQ(type::CMP_TRUE,
+              result_tile->GetValue(tuple_itr, 1).CompareEquals(
+                  type::ValueFactory::GetVarcharValue(std::to_string(
+                      TestingExecutorUtil::PopulatedValue(tuple_id, 3)))));
+    tuple_id++;
+  }
+  EXPECT_TRUE(tile_group->IsReleased());
+
+  // The readers of the raw tuple slots restore them
+  tile_group->GetTile(0);
+  EXPECT_FALSE(tile_group->IsReleased());
+  EXPECT_LT(0U, storage::TileGroupEvictor::GetResidentSize(tile_group.get()));
+  check_values();
+
+  // They are released again once the tile group is cold
+  storage::TileGroupClassifier classifier;
+  for (int classify_itr = 0; classify_itr < 10; classify_itr++) {
+    classifier.ClassifyTableNow(data_table.get());
+  }
+  EXPECT_EQ(0U, freezer.FreezeTable(data_table.get(), MAX_CID - 1));
+  EXPECT_TRUE(tile_group->IsReleased());
+  check_values();
+  freezer.ReleaseData();
+}
+
+}  // End test namespace
+}  // End peloton namespace
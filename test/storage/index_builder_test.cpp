@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// index_builder_test.cpp
+//
+// Identification: test/storage/index_builder_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "concurrency/epoch_manager_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "index/index_factory.h"
+#include "storage/data_table.h"
+#include "storage/index_builder.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Index Builder Tests
+//===--------------------------------------------------------------------===//
+
+class IndexBuilderTests : public PelotonTest {};
+
+static std::shared_ptr<index::Index> AddIndex(storage::DataTable *table,
+                                              oid_t index_oid) {
+  auto tuple_schema = table->GetSchema();
+  std::vector<oid_t> key_attrs = {1};
+  auto key_schema = catalog::Schema::CopySchema(tuple_schema, key_attrs);
+  key_schema->SetIndexedColumns(key_attrs);
+
+  auto index_metadata = new index::IndexMetadata(
+      "built_index", index_oid, INVALID_OID, INVALID_OID, IndexType::BWTREE,
+      IndexConstraintType::DEFAULT, tuple_schema, key_schema, key_attrs,
+      false);
+  std::shared_ptr<index::Index> index(
+      index::IndexFactory::GetIndex(index_metadata));
+  table->AddIndex(index);
+  return index;
+}
+
+TEST_F(IndexBuilderTests, BuildTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP * 2 + 1;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto &index_builder = storage::IndexBuilder::GetInstance();
+  auto index = AddIndex(data_table.get(), 125);
+  index_builder.BuildIndex(data_table.get(), index);
+  EXPECT_TRUE(index->GetMetadata()->IsBuilding());
+  EXPECT_FALSE(index->GetMetadata()->GetVisibility());
+
+  // A writer of the barrier epoch maintains the index itself
+  txn = txn_manager.BeginTransaction();
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  storage::Tuple tuple(data_table->GetSchema(), true);
+  tuple.SetValue(0, type::ValueFactory::GetIntegerValue(
+                        TestingExecutorUtil::PopulatedValue(tuple_count, 0)),
+                 testing_pool);
+  tuple.SetValue(1, type::ValueFactory::GetIntegerValue(
+                        TestingExecutorUtil::PopulatedValue(tuple_count, 1)),
+                 testing_pool);
+  tuple.SetValue(2, type::ValueFactory::GetDecimalValue(
+                        TestingExecutorUtil::PopulatedValue(tuple_count, 2)),
+                 testing_pool);
+  tuple.SetValue(3, type::ValueFactory::GetVarcharValue("written"),
+                 testing_pool);
+  ItemPointer *index_entry_ptr = nullptr;
+  auto location = data_table->InsertTuple(&tuple, txn, &index_entry_ptr);
+  EXPECT_NE(INVALID_OID, location.block);
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  txn_manager.CommitTransaction(txn);
+
+  // The build starts once the barrier epoch has expired
+  epoch_manager.SetCurrentEpochId(2);
+  index_builder.WaitForTable(data_table.get());
+  EXPECT_EQ(0, index_builder.GetActiveBuildCount());
+  EXPECT_FALSE(index->GetMetadata()->IsBuilding());
+  EXPECT_TRUE(index->GetMetadata()->GetVisibility());
+
+  std::vector<ItemPointer *> location_ptrs;
+  index->ScanAllKeys(location_ptrs);
+  EXPECT_EQ(tuple_count + 1, location_ptrs.size());
+}
+
+TEST_F(IndexBuilderTests, DropTableTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.Reset(1);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP));
+  TestingExecutorUtil::PopulateTable(data_table.get(),
+                                     TESTS_TUPLES_PER_TILEGROUP, false, false,
+                                     false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // The open transaction holds the build back
+  txn = txn_manager.BeginTransaction();
+  auto &index_builder = storage::IndexBuilder::GetInstance();
+  auto index = AddIndex(data_table.get(), 126);
+  index_builder.BuildIndex(data_table.get(), index);
+  EXPECT_EQ(1, index_builder.GetActiveBuildCount());
+
+  // The abandoned index is never shown to the planner
+  index_builder.DropTable(data_table.get());
+  EXPECT_EQ(0, index_builder.GetActiveBuildCount());
+  EXPECT_TRUE(index->GetMetadata()->IsBuilding());
+  EXPECT_FALSE(index->GetMetadata()->GetVisibility());
+  txn_manager.CommitTransaction(txn);
+}
+
+}  // End test namespace
+}  // End peloton namespace
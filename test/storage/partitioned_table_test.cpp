@@ -0,0 +1,185 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// partitioned_table_test.cpp
+//
+// Identification: test/storage/partitioned_table_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "concurrency/testing_transaction_util.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "expression/comparison_expression.h"
+#include "expression/conjunction_expression.h"
+#include "expression/constant_value_expression.h"
+#include "expression/tuple_value_expression.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/partitioned_table.h"
+#include "storage/storage_manager.h"
+#include "storage/tuple.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Partitioned Table Tests
+//===--------------------------------------------------------------------===//
+
+class PartitionedTableTests : public PelotonTest {};
+
+namespace {
+
+bool InsertTuple(storage::PartitionedTable &table, int id) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  storage::Tuple tuple(table.GetPartition(0)->GetSchema(), true);
+  tuple.SetValue(0, type::ValueFactory::GetIntegerValue(id));
+  tuple.SetValue(1, type::ValueFactory::GetIntegerValue(id));
+
+  ItemPointer *index_entry_ptr = nullptr;
+  ItemPointer location = table.InsertTuple(&tuple, txn, &index_entry_ptr);
+  if (location.IsNull() == true) {
+    txn_manager.AbortTransaction(txn);
+    return false;
+  }
+  txn_manager.PerformInsert(txn, location, index_entry_ptr);
+  return txn_manager.CommitTransaction(txn) == ResultType::SUCCESS;
+}
+
+expression::AbstractExpression *CompareId(ExpressionType comparison_type,
+                                          int id) {
+  return new expression::ComparisonExpression(
+      comparison_type,
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 0),
+      new expression::ConstantValueExpression(
+          type::ValueFactory::GetIntegerValue(id)));
+}
+
+}  // namespace
+
+TEST_F(PartitionedTableTests, RangePartitionTest) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_oid = 24401;
+  auto database = new storage::Database(database_oid);
+  storage_manager->AddDatabaseToStorageManager(database);
+
+  storage::PartitionedTable table("RANGE_TABLE", storage::PartitionType::RANGE,
+                                  0);
+  for (int partition = 0; partition < 3; partition++) {
+    auto partition_table = TestingTransactionUtil::CreateTable(
+        0, "RANGE_TABLE", database_oid, 24402 + partition * 2,
+        24403 + partition * 2, true);
+    EXPECT_TRUE(table.AddPartition(
+        partition_table, type::ValueFactory::GetIntegerValue(partition * 100)));
+  }
+
+  // the bounds must ascend
+  EXPECT_FALSE(table.AddPartition(table.GetPartition(0),
+                                  type::ValueFactory::GetIntegerValue(50)));
+  EXPECT_EQ(3U, table.GetPartitionCount());
+
+  for (int id = 0; id < 300; id += 10) {
+    EXPECT_TRUE(InsertTuple(table, id));
+  }
+  EXPECT_FALSE(InsertTuple(table, -10));
+  EXPECT_EQ(table.GetPartition(1),
+            table.GetPartitionForKey(type::ValueFactory::GetIntegerValue(100)));
+  EXPECT_EQ(table.GetPartition(2),
+            table.GetPartitionForKey(type::ValueFactory::GetIntegerValue(999)));
+
+  // primary keys are checked within a partition
+  EXPECT_FALSE(InsertTuple(table, 150));
+
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      new expression::ConjunctionExpression(
+          ExpressionType::CONJUNCTION_AND,
+          CompareId(ExpressionType::COMPARE_GREATERTHANOREQUALTO, 150),
+          CompareId(ExpressionType::COMPARE_LESSTHAN, 180)));
+  auto partitions = table.GetPartitions(predicate.get());
+  ASSERT_EQ(1U, partitions.size());
+  EXPECT_EQ(table.GetPartition(1), partitions[0]);
+
+  predicate.reset(new expression::ConjunctionExpression(
+      ExpressionType::CONJUNCTION_OR,
+      CompareId(ExpressionType::COMPARE_LESSTHAN, 100),
+      CompareId(ExpressionType::COMPARE_GREATERTHAN, 250)));
+  partitions = table.GetPartitions(predicate.get());
+  ASSERT_EQ(2U, partitions.size());
+  EXPECT_EQ(table.GetPartition(0), partitions[0]);
+  EXPECT_EQ(table.GetPartition(2), partitions[1]);
+
+  // predicates on other columns visit every partition
+  predicate.reset(new expression::ComparisonExpression(
+      ExpressionType::COMPARE_EQUAL,
+      new expression::TupleValueExpression(type::TypeId::INTEGER, 0, 1),
+      new expression::ConstantValueExpression(
+          type::ValueFactory::GetIntegerValue(5))));
+  EXPECT_EQ(3U, table.GetPartitions(predicate.get()).size());
+  EXPECT_EQ(3U, table.GetPartitions(nullptr).size());
+
+  // the oldest partition is dropped with its table, which stays valid for
+  // the transactions of the epoch
+  auto table_count = database->GetTableCount();
+  auto oldest_partition = table.GetPartition(0);
+  auto oldest_partition_oid = oldest_partition->GetOid();
+  EXPECT_TRUE(
+      table.DropPartitionsBefore(type::ValueFactory::GetIntegerValue(50))
+          .empty());
+  auto dropped_oids =
+      table.DropPartitionsBefore(type::ValueFactory::GetIntegerValue(150));
+  ASSERT_EQ(1U, dropped_oids.size());
+  EXPECT_EQ(oldest_partition_oid, dropped_oids[0]);
+  EXPECT_EQ(2U, table.GetPartitionCount());
+  EXPECT_EQ(table_count - 1, database->GetTableCount());
+  EXPECT_EQ(oldest_partition_oid, oldest_partition->GetOid());
+  EXPECT_FALSE(InsertTuple(table, 50));
+  EXPECT_TRUE(InsertTuple(table, 105));
+
+  storage_manager->RemoveDatabaseFromStorageManager(database_oid);
+}
+
+TEST_F(PartitionedTableTests, HashPartitionTest) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_oid = 24411;
+  storage_manager->AddDatabaseToStorageManager(
+      new storage::Database(database_oid));
+
+  storage::PartitionedTable table("HASH_TABLE", storage::PartitionType::HASH,
+                                  0);
+  for (int partition = 0; partition < 4; partition++) {
+    auto partition_table = TestingTransactionUtil::CreateTable(
+        0, "HASH_TABLE", database_oid, 24412 + partition * 2,
+        24413 + partition * 2, true);
+    EXPECT_TRUE(table.AddPartition(partition_table));
+  }
+  EXPECT_FALSE(table.AddPartition(
+      table.GetPartition(0), type::ValueFactory::GetIntegerValue(0)));
+
+  for (int id = 0; id < 100; id++) {
+    EXPECT_TRUE(InsertTuple(table, id));
+  }
+
+  // an equality on the key visits one partition
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      CompareId(ExpressionType::COMPARE_EQUAL, 7));
+  auto partitions = table.GetPartitions(predicate.get());
+  ASSERT_EQ(1U, partitions.size());
+  EXPECT_EQ(table.GetPartitionForKey(type::ValueFactory::GetIntegerValue(7)),
+            partitions[0]);
+
+  // ranges visit all of them
+  predicate.reset(CompareId(ExpressionType::COMPARE_LESSTHAN, 7));
+  EXPECT_EQ(4U, table.GetPartitions(predicate.get()).size());
+
+  storage_manager->RemoveDatabaseFromStorageManager(database_oid);
+}
+
+}  // namespace test
+}  // namespace peloton
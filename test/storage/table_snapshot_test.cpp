@@ -0,0 +1,121 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_snapshot_test.cpp
+//
+// Identification: test/storage/table_snapshot_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <thread>
+
+#include "common/harness.h"
+
+#include "catalog/catalog_defaults.h"
+#include "concurrency/testing_transaction_util.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "index/index.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/table_snapshot.h"
+#include "util/file_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Table Snapshot Tests
+//===--------------------------------------------------------------------===//
+
+class TableSnapshotTests : public PelotonTest {};
+
+TEST_F(TableSnapshotTests, MapTableTest) {
+  std::string snapshot_dir = FileUtil::CreateTempDirectory("snapshot_test");
+  std::string snapshot_path = snapshot_dir + "/snapshot";
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  oid_t table_oid = 45678;
+  oid_t index_oid = 45679;
+
+  auto table = TestingTransactionUtil::CreateTable(
+      10, "SNAPSHOT_TABLE", CATALOG_DATABASE_OID, table_oid, index_oid, true);
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 0, 1));
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteDelete(txn, table, 1));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(storage::TableSnapshot::WriteTable(txn, table, snapshot_path));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // restart with an empty table
+  auto database = storage::StorageManager::GetInstance()->GetDatabaseWithOid(
+      CATALOG_DATABASE_OID);
+  database->DropTableWithOid(table_oid);
+  table = TestingTransactionUtil::CreateTable(
+      0, "SNAPSHOT_TABLE", CATALOG_DATABASE_OID, table_oid, index_oid, true);
+
+  std::unique_ptr<std::thread> index_thread;
+  EXPECT_TRUE(
+      storage::TableSnapshot::LoadTable(table, snapshot_path, index_thread));
+  EXPECT_EQ(9U, table->GetTupleCount());
+
+  // the tuples can be scanned before the indexes are filled
+  std::vector<int> results;
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteScan(txn, results, table, 9));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_EQ(1U, results.size());
+
+  ASSERT_TRUE(index_thread != nullptr);
+  index_thread->join();
+  EXPECT_FALSE(table->GetIndex(0)->GetMetadata()->IsBuilding());
+
+  int result = -1;
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 0, result));
+  EXPECT_EQ(1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 1, result));
+  EXPECT_EQ(-1, result);
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 9, result));
+  EXPECT_EQ(0, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // the mapped tuples are updated like any other, the file is left as is
+  std::string snapshot = FileUtil::GetFile(snapshot_path);
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteUpdate(txn, table, 9, 5));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  txn = txn_manager.BeginTransaction();
+  EXPECT_TRUE(TestingTransactionUtil::ExecuteRead(txn, table, 9, result));
+  EXPECT_EQ(5, result);
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_EQ(snapshot, FileUtil::GetFile(snapshot_path));
+
+  database->DropTableWithOid(table_oid);
+  FileUtil::RemoveDirectory(snapshot_dir);
+}
+
+TEST_F(TableSnapshotTests, UninlinedTableTest) {
+  std::string snapshot_dir = FileUtil::CreateTempDirectory("snapshot_test");
+
+  // the varlen values live in the pools of the tiles
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable());
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_FALSE(storage::TableSnapshot::WriteTable(txn, table.get(),
+                                                  snapshot_dir + "/snapshot"));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  FileUtil::RemoveDirectory(snapshot_dir);
+}
+
+}  // End test namespace
+}  // End peloton namespace
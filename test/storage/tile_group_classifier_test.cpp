@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_classifier_test.cpp
+//
+// Identification: test/storage/tile_group_classifier_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_classifier.h"
+#include "storage/tile_group_freezer.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Classifier Tests
+//===--------------------------------------------------------------------===//
+
+class TileGroupClassifierTests : public PelotonTest {};
+
+TEST_F(TileGroupClassifierTests, ClassifyTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  const int tuple_count = tuples_per_tilegroup * 3 + 1;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group_count = data_table->GetTileGroupCount();
+  auto first_header = data_table->GetTileGroup(0)->GetHeader();
+  auto second_header = data_table->GetTileGroup(1)->GetHeader();
+  EXPECT_EQ(storage::TileGroupTemperature::HOT,
+            first_header->GetTemperature());
+
+  // Without accesses every tile group cools down
+  storage::TileGroupClassifier classifier;
+  for (int classify_itr = 0; classify_itr < 10; classify_itr++) {
+    classifier.ClassifyTableNow(data_table.get());
+  }
+  EXPECT_EQ(tile_group_count, classifier.ClassifyTableNow(data_table.get()));
+
+  // One in ACCESS_SAMPLE_INTERVAL accesses is counted
+  for (int access_itr = 0; access_itr < 32; access_itr++) {
+    first_header->IncrementAccessCount();
+  }
+  for (uint32_t access_itr = 0;
+       access_itr < storage::TileGroupClassifier::ACCESS_SAMPLE_INTERVAL * 4;
+       access_itr++) {
+    storage::TileGroupClassifier::RecordAccess(second_header);
+  }
+  EXPECT_EQ(tile_group_count - 2,
+            classifier.ClassifyTableNow(data_table.get()));
+  EXPECT_EQ(storage::TileGroupTemperature::HOT,
+            first_header->GetTemperature());
+  EXPECT_EQ(storage::TileGroupTemperature::WARM,
+            second_header->GetTemperature());
+  EXPECT_EQ("WARM", storage::TileGroupTemperatureToString(
+                        second_header->GetTemperature()));
+
+  // Only the cold tile groups are frozen by the background pass
+  auto &freezer = storage::TileGroupFreezer::GetInstance();
+  EXPECT_EQ(1U, freezer.FreezeTable(data_table.get(), MAX_CID - 1, true));
+  EXPECT_FALSE(first_header->IsFrozen());
+  EXPECT_TRUE(data_table->GetTileGroup(2)->GetHeader()->IsFrozen());
+
+  // A table is not classified again within the interval
+  EXPECT_EQ(0U, classifier.ClassifyTable(data_table.get()));
+  EXPECT_EQ(storage::TileGroupTemperature::HOT,
+            first_header->GetTemperature());
+
+  // The scores decay by half every classification
+  classifier.SetClassifyInterval(0);
+  classifier.ClassifyTable(data_table.get());
+  EXPECT_EQ(storage::TileGroupTemperature::HOT,
+            first_header->GetTemperature());
+  classifier.ClassifyTable(data_table.get());
+  EXPECT_EQ(storage::TileGroupTemperature::WARM,
+            first_header->GetTemperature());
+}
+
+}  // namespace test
+}  // namespace peloton
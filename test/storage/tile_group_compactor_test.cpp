@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compactor_test.cpp
+//
+// Identification: test/storage/tile_group_compactor_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_compactor.h"
+#include "storage/tile_group_header.h"
+#include "storage/tile_group_iterator.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Compactor Tests
+//===--------------------------------------------------------------------===//
+
+class TileGroupCompactorTests : public PelotonTest {};
+
+TEST_F(TileGroupCompactorTests, CompactTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  const int tuple_count = tuples_per_tilegroup * 2 + 1;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  auto tile_group = data_table->GetTileGroup(0);
+  auto tile_group_header = tile_group->GetHeader();
+  auto tile_group_id = tile_group->GetTileGroupId();
+
+  // Delete all but the last tuple of the first tile group
+  txn = txn_manager.BeginTransaction();
+  for (oid_t tuple_id = 0; tuple_id < TESTS_TUPLES_PER_TILEGROUP - 1;
+       tuple_id++) {
+    EXPECT_TRUE(
+        txn_manager.AcquireOwnership(txn, tile_group_header, tuple_id));
+    ItemPointer new_location = data_table->InsertEmptyVersion();
+    txn_manager.PerformDelete(txn, ItemPointer(tile_group_id, tuple_id),
+                              new_location);
+  }
+  txn_manager.CommitTransaction(txn);
+
+  auto &compactor = storage::TileGroupCompactor::GetInstance();
+  EXPECT_EQ(1U, compactor.GetLiveTupleCount(tile_group.get()));
+
+  // The sparse tile group is retired and its last tuple is moved out. It is
+  // not dropped before the GC has recycled its slots.
+  EXPECT_EQ(0U, compactor.CompactTable(data_table.get()));
+  EXPECT_TRUE(tile_group_header->IsRetired());
+  EXPECT_FALSE(data_table->GetTileGroup(1)->GetHeader()->IsRetired());
+  EXPECT_EQ(0U, compactor.GetLiveTupleCount(tile_group.get()));
+
+  // The moved tuple is still visible with the same values
+  txn = txn_manager.BeginTransaction();
+  size_t visible_count = 0;
+  auto tile_group_count = data_table->GetTileGroupCount();
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto current_tile_group = data_table->GetTileGroup(tile_group_offset);
+    auto current_header = current_tile_group->GetHeader();
+    for (oid_t tuple_id = 0;
+         tuple_id < current_header->GetCurrentNextTupleSlot(); tuple_id++) {
+      if (txn_manager.IsVisible(txn, current_header, tuple_id) ==
+          VisibilityType::OK) {
+        visible_count++;
+      }
+    }
+  }
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(static_cast<size_t>(tuple_count - tuples_per_tilegroup + 1),
+            visible_count);
+
+  // Dropping leaves a hole that scans skip
+  EXPECT_TRUE(data_table->DropTileGroup(tile_group_id));
+  EXPECT_EQ(nullptr, data_table->GetTileGroup(0).get());
+  EXPECT_EQ(tile_group_count, data_table->GetTileGroupCount());
+
+  storage::TileGroupIterator tile_group_itr(data_table.get());
+  std::shared_ptr<storage::TileGroup> next_tile_group;
+  size_t iterated_count = 0;
+  while (tile_group_itr.Next(next_tile_group)) {
+    EXPECT_NE(tile_group_id, next_tile_group->GetTileGroupId());
+    iterated_count++;
+  }
+  EXPECT_EQ(tile_group_count - 1, iterated_count);
+}
+
+}  // End test namespace
+}  // End peloton namespace
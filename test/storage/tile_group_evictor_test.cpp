@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_evictor_test.cpp
+//
+// Identification: test/storage/tile_group_evictor_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_classifier.h"
+#include "storage/tile_group_evictor.h"
+#include "storage/tile_group_freezer.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Evictor Tests
+//===--------------------------------------------------------------------===//
+
+class TileGroupEvictorTests : public PelotonTest {};
+
+TEST_F(TileGroupEvictorTests, EvictTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  const int tuple_count = tuples_per_tilegroup * 3 + 1;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, true, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // Without accesses every tile group cools down, the full ones freeze
+  storage::TileGroupClassifier classifier;
+  for (int classify_itr = 0; classify_itr < 10; classify_itr++) {
+    classifier.ClassifyTableNow(data_table.get());
+  }
+  auto &freezer = storage::TileGroupFreezer::GetInstance();
+  EXPECT_EQ(3U, freezer.FreezeTable(data_table.get(), MAX_CID - 1));
+
+  // Freezing released the tuple slots, the readers of the raw slots restore
+  // them next to the frozen copy
+  for (oid_t tile_group_offset = 0; tile_group_offset < 3;
+       tile_group_offset++) {
+    data_table->GetTileGroup(tile_group_offset)->GetTile(0);
+  }
+
+  auto tile_group = data_table->GetTileGroup(0);
+  std::vector<type::Value> values;
+  for (oid_t tuple_id = 0; tuple_id < (oid_t)tuples_per_tilegroup;
+       tuple_id++) {
+    for (oid_t column_id = 0; column_id < 4; column_id++) {
+      values.push_back(tile_group->GetValue(tuple_id, column_id));
+    }
+  }
+
+  storage::TileGroupEvictor evictor;
+  EXPECT_LT(0U, storage::TileGroupEvictor::GetResidentSize(tile_group.get()));
+  EXPECT_TRUE(evictor.EvictTileGroup(tile_group.get()));
+  EXPECT_TRUE(tile_group->IsEvicted());
+  EXPECT_FALSE(tile_group->GetHeader()->IsRelocating());
+  EXPECT_EQ(0U, storage::TileGroupEvictor::GetResidentSize(tile_group.get()));
+  EXPECT_FALSE(evictor.EvictTileGroup(tile_group.get()));
+
+  // The tile group that still receives inserts is not frozen
+  auto last_tile_group = data_table->GetTileGroup(3);
+  EXPECT_FALSE(evictor.EvictTileGroup(last_tile_group.get()));
+  EXPECT_FALSE(last_tile_group->IsEvicted());
+
+  // The other cold, frozen tile groups are evicted by a pass
+  evictor.AddTable(data_table.get());
+  EXPECT_EQ(2U, evictor.EvictTables());
+  EXPECT_EQ(0U, evictor.EvictTables());
+  EXPECT_TRUE(data_table->GetTileGroup(2)->IsEvicted());
+
+  // The evicted tuples are paged in from the file, with their varlen data
+  storage::TileGroupEvictor::PrefetchTileGroups(data_table.get(), 0, 4);
+  evictor.ReleaseData();
+  size_t value_itr = 0;
+  for (oid_t tuple_id = 0; tuple_id < (oid_t)tuples_per_tilegroup;
+       tuple_id++) {
+    for (oid_t column_id = 0; column_id < 4; column_id++) {
+      EXPECT_EQ(type::CMP_TRUE,
+                values[value_itr++].CompareEquals(
+                    tile_group->GetValue(tuple_id, column_id)));
+    }
+  }
+
+  evictor.ClearTables();
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_provisioner_test.cpp
+//
+// Identification: test/storage/tile_group_provisioner_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "storage/data_table.h"
+#include "storage/tile_group_provisioner.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Provisioner Tests
+//===--------------------------------------------------------------------===//
+
+class TileGroupProvisionerTests : public PelotonTest {};
+
+TEST_F(TileGroupProvisionerTests, SpareTileGroupTest) {
+  const int tuples_per_tilegroup = 5;
+  std::unique_ptr<storage::DataTable> table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  size_t active_count = table->GetActiveTileGroupCount();
+  size_t tile_group_count = table->GetTileGroupCount();
+
+  auto &provisioner = storage::TileGroupProvisioner::GetInstance();
+  provisioner.AddTable(table.get());
+  EXPECT_EQ(active_count, provisioner.ProvisionTables());
+  EXPECT_EQ(0U, provisioner.ProvisionTables());
+
+  // filling the active tile groups swaps the spares in
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  TestingExecutorUtil::PopulateTable(
+      table.get(), tuples_per_tilegroup * static_cast<int>(active_count),
+      false, false, false, txn);
+  txn_manager.CommitTransaction(txn);
+  EXPECT_EQ(tile_group_count + active_count, table->GetTileGroupCount());
+
+  EXPECT_EQ(active_count, provisioner.ProvisionTables());
+  provisioner.DropTable(table.get());
+  EXPECT_EQ(0U, provisioner.ProvisionTables());
+}
+
+}  // namespace test
+}  // namespace peloton
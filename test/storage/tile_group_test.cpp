@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <set>
+#include <thread>
+
 #include "common/harness.h"
 
 #include "type/value_factory.h"
@@ -544,5 +547,82 @@ TEST_F(TileGroupTests, TileCopyTest) {
   delete schema;
 }
 
+TEST_F(TileGroupTests, RecycleTupleSlotTest) {
+  const int tuple_count = 100;
+  storage::TileGroupHeader header(BackendType::MM, tuple_count);
+
+  EXPECT_EQ(INVALID_OID, header.GetRecycledTupleSlot());
+
+  // Only the first recycled slot announces the tile group
+  EXPECT_TRUE(header.RecycleTupleSlot(70));
+  EXPECT_FALSE(header.RecycleTupleSlot(3));
+  EXPECT_FALSE(header.RecycleTupleSlot(99));
+  EXPECT_FALSE(header.RecycleTupleSlot(3));
+  EXPECT_EQ(3U, header.GetRecycledTupleSlotCount());
+
+  EXPECT_EQ(3U, header.GetRecycledTupleSlot());
+  EXPECT_EQ(70U, header.GetRecycledTupleSlot());
+  EXPECT_EQ(99U, header.GetRecycledTupleSlot());
+  EXPECT_EQ(INVALID_OID, header.GetRecycledTupleSlot());
+  EXPECT_EQ(0U, header.GetRecycledTupleSlotCount());
+
+  EXPECT_TRUE(header.RecycleTupleSlot(3));
+
+  // Concurrent recyclers and claimers never hand out a slot twice
+  const int thread_count = 4;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<oid_t>> claimed(thread_count);
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    threads.push_back(std::thread([&, thread_itr] {
+      for (oid_t tuple_slot_id = thread_itr; tuple_slot_id < tuple_count;
+           tuple_slot_id += thread_count) {
+        header.RecycleTupleSlot(tuple_slot_id);
+        auto recycled_slot = header.GetRecycledTupleSlot();
+        if (recycled_slot != INVALID_OID) {
+          claimed[thread_itr].push_back(recycled_slot);
+        }
+      }
+    }));
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::set<oid_t> slots;
+  size_t claimed_count = 0;
+  for (auto &thread_slots : claimed) {
+    slots.insert(thread_slots.begin(), thread_slots.end());
+    claimed_count += thread_slots.size();
+  }
+  EXPECT_EQ(claimed_count, slots.size());
+  EXPECT_EQ(tuple_count - claimed_count, header.GetRecycledTupleSlotCount());
+
+  // Logging claims specific slots
+  EXPECT_TRUE(header.GetEmptyTupleSlot(10));
+  EXPECT_EQ(11U, header.GetCurrentNextTupleSlot());
+  EXPECT_TRUE(header.GetEmptyTupleSlot(5));
+  EXPECT_EQ(11U, header.GetCurrentNextTupleSlot());
+  EXPECT_FALSE(header.GetEmptyTupleSlot(tuple_count));
+}
+
+TEST_F(TileGroupTests, AlignedHeaderTest) {
+  const int tuple_count = 100;
+  storage::TileGroupHeader header(BackendType::MM, tuple_count);
+
+  // every header fills its own cache line
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(header.GetHeaderEntry(0)) %
+                    CACHELINE_SIZE);
+  EXPECT_EQ(CACHELINE_SIZE,
+            header.GetHeaderEntry(1) - header.GetHeaderEntry(0));
+
+  // the header is copied into another one of the same size
+  ItemPointer indirection(7, 9);
+  header.SetIndirection(3, &indirection);
+  storage::TileGroupHeader other(BackendType::MM, tuple_count);
+  other = header;
+  EXPECT_EQ(&indirection, other.GetIndirection(3));
+  EXPECT_TRUE(other.GetPrevItemPointer(3).IsNull());
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -16,6 +16,8 @@
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tuple_iterator.h"
+#include "type/value_ref.h"
+#include "type/varlen_type.h"
 
 namespace peloton {
 namespace test {
@@ -103,5 +105,52 @@ TEST_F(TileTests, BasicTest) {
   delete schema;
 }
 
+TEST_F(TileTests, ShortVarlenTest) {
+  std::vector<catalog::Column> columns;
+  columns.emplace_back(type::TypeId::VARCHAR, 25, "A", false);
+  columns.emplace_back(type::TypeId::VARBINARY, 25, "B", false);
+  catalog::Schema schema(columns);
+
+  const int tuple_count = 4;
+  storage::TileGroupHeader header(BackendType::MM, tuple_count);
+  std::unique_ptr<storage::Tile> tile(storage::TileFactory::GetTile(
+      BackendType::MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+      &header, schema, nullptr, tuple_count));
+
+  // Up to six characters and the terminating null fit into the slot
+  std::vector<type::Value> values = {
+      type::ValueFactory::GetVarcharValue("abcdef"),
+      type::ValueFactory::GetVarcharValue("abcdefg"),
+      type::ValueFactory::GetVarcharValue(""),
+      type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR)};
+  std::vector<bool> in_slot = {true, false, true, false};
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    tile->SetValue(values[tuple_id], tuple_id, 0);
+    tile->SetValue(type::ValueFactory::GetVarbinaryValue(
+                       std::string(tuple_id * 3, 'x')),
+                   tuple_id, 1);
+  }
+
+  std::unique_ptr<storage::Tile> copy(tile->CopyTile(BackendType::MM));
+  for (auto current : {tile.get(), copy.get()}) {
+    for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+      const char *slot = current->GetTupleLocation(tuple_id);
+      EXPECT_EQ(in_slot[tuple_id], type::VarlenType::IsInlineStorage(slot));
+      EXPECT_EQ(tuple_id * 3 <= type::VarlenType::kInlineCapacity,
+                type::VarlenType::IsInlineStorage(slot + schema.GetOffset(1)));
+
+      auto value = current->GetValue(tuple_id, 0);
+      if (values[tuple_id].IsNull()) {
+        EXPECT_TRUE(value.IsNull());
+      } else {
+        EXPECT_EQ(type::CMP_TRUE, value.CompareEquals(values[tuple_id]));
+        EXPECT_EQ(0, type::ValueRef(type::TypeId::VARCHAR, slot)
+                         .Compare(type::ValueRef(values[tuple_id])));
+      }
+      EXPECT_EQ(tuple_id * 3, current->GetValue(tuple_id, 1).GetLength());
+    }
+  }
+}
+
 }  // End test namespace
 }  // End peloton namespace
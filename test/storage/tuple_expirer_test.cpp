@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_expirer_test.cpp
+//
+// Identification: test/storage/tuple_expirer_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/storage_manager.h"
+#include "storage/table_factory.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+#include "storage/tuple_expirer.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tuple Expirer Tests
+//===--------------------------------------------------------------------===//
+
+class TupleExpirerTests : public PelotonTest {};
+
+namespace {
+
+type::Value GetTimestamp(const std::string &timestamp) {
+  return type::ValueFactory::CastAsTimestamp(
+      type::ValueFactory::GetVarcharValue(timestamp));
+}
+
+void InsertTuple(concurrency::Transaction *txn, storage::DataTable *table,
+                 int id, const std::string &timestamp) {
+  storage::Tuple tuple(table->GetSchema(), true);
+  tuple.SetValue(0, type::ValueFactory::GetIntegerValue(id));
+  tuple.SetValue(1, GetTimestamp(timestamp));
+
+  ItemPointer *index_entry_ptr = nullptr;
+  ItemPointer location = table->InsertTuple(&tuple, txn, &index_entry_ptr);
+  EXPECT_FALSE(location.IsNull());
+  concurrency::TransactionManagerFactory::GetInstance().PerformInsert(
+      txn, location, index_entry_ptr);
+}
+
+size_t CountTuples(concurrency::Transaction *txn, storage::DataTable *table) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  size_t tuple_count = 0;
+  for (oid_t offset = 0; offset < table->GetTileGroupCount(); offset++) {
+    auto tile_group_header = table->GetTileGroup(offset)->GetHeader();
+    auto slot_count = tile_group_header->GetCurrentNextTupleSlot();
+    for (oid_t tuple_id = 0; tuple_id < slot_count; tuple_id++) {
+      if (txn_manager.IsVisible(txn, tile_group_header, tuple_id) ==
+          VisibilityType::OK) {
+        tuple_count++;
+      }
+    }
+  }
+  return tuple_count;
+}
+
+}  // namespace
+
+TEST_F(TupleExpirerTests, TimestampTimeTest) {
+  int64_t time;
+  EXPECT_TRUE(storage::TupleExpirer::GetTimestampTime(
+      GetTimestamp("1970-01-01 00:00:00.000000+00"), time));
+  EXPECT_EQ(0, time);
+
+  // the zone is taken into account
+  EXPECT_TRUE(storage::TupleExpirer::GetTimestampTime(
+      GetTimestamp("1970-01-01 02:00:00.000001+02"), time));
+  EXPECT_EQ(1, time);
+
+  EXPECT_TRUE(storage::TupleExpirer::GetTimestampTime(
+      GetTimestamp("2000-03-01 00:00:01.000000+00"), time));
+  EXPECT_EQ(951868801000000, time);
+
+  EXPECT_FALSE(storage::TupleExpirer::GetTimestampTime(
+      type::ValueFactory::GetNullValueByType(type::TypeId::TIMESTAMP), time));
+}
+
+TEST_F(TupleExpirerTests, ExpireTest) {
+  auto storage_manager = storage::StorageManager::GetInstance();
+  oid_t database_oid = 24301;
+  auto database = new storage::Database(database_oid);
+  storage_manager->AddDatabaseToStorageManager(database);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  auto id_column = catalog::Column(
+      type::TypeId::INTEGER, type::Type::GetTypeSize(type::TypeId::INTEGER),
+      "id", true);
+  auto stamp_column = catalog::Column(
+      type::TypeId::TIMESTAMP,
+      type::Type::GetTypeSize(type::TypeId::TIMESTAMP), "stamp", true);
+  auto table = storage::TableFactory::GetDataTable(
+      database_oid, 24302, new catalog::Schema({id_column, stamp_column}),
+      "EXPIRE_TABLE", 100, true, false);
+  database->AddTable(table);
+
+  // only timestamp columns can expire
+  EXPECT_FALSE(table->SetTimeToLive(0, 1000000));
+  EXPECT_EQ(INVALID_OID, table->GetTimeToLiveColumn());
+
+  // the first tile group expires as a whole, half of the second one tuple
+  // by tuple, and the third one not at all
+  auto txn = txn_manager.BeginTransaction();
+  for (int id = 0; id < 100; id++) {
+    InsertTuple(txn, table, id, "2000-01-01 00:00:00.000000+00");
+  }
+  for (int id = 100; id < 200; id++) {
+    InsertTuple(txn, table, id, (id % 2 == 0)
+                                    ? "2000-01-02 00:00:00.000000+00"
+                                    : "2100-01-01 00:00:00.000000+00");
+  }
+  for (int id = 200; id < 210; id++) {
+    InsertTuple(txn, table, id, "2100-01-02 00:00:00.000000+00");
+  }
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+  EXPECT_EQ(3U, table->GetTileGroupCount());
+
+  auto &tuple_expirer = storage::TupleExpirer::GetInstance();
+  auto now = storage::TupleExpirer::GetCurrentTime();
+  EXPECT_EQ(0U, tuple_expirer.ExpireTable(table, now));
+
+  // a day to live
+  EXPECT_TRUE(table->SetTimeToLive(1, 24ULL * 3600 * 1000000));
+  EXPECT_EQ(1U, table->GetTimeToLiveColumn());
+  EXPECT_EQ(150U, tuple_expirer.ExpireTable(table, now));
+  EXPECT_TRUE(table->GetTileGroup(0)->GetHeader()->IsDeleting());
+  EXPECT_FALSE(table->GetTileGroup(1)->GetHeader()->IsDeleting());
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(60U, CountTuples(txn, table));
+  EXPECT_EQ(ResultType::SUCCESS, txn_manager.CommitTransaction(txn));
+
+  // nothing is left to expire
+  EXPECT_EQ(0U, tuple_expirer.ExpireTable(table, now));
+
+  storage_manager->RemoveDatabaseFromStorageManager(database_oid);
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tuple_serializer_test.cpp
+//
+// Identification: test/storage/tuple_serializer_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "executor/testing_executor_util.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
+#include "storage/tuple_serializer.h"
+#include "type/serializeio.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tuple Serializer Tests
+//===--------------------------------------------------------------------===//
+
+class TupleSerializerTests : public PelotonTest {};
+
+namespace {
+
+std::string ToString(const CopySerializeOutput &output) {
+  return std::string(output.Data(), output.Size());
+}
+
+}  // namespace
+
+TEST_F(TupleSerializerTests, TupleTest) {
+  std::vector<catalog::Column> columns = {
+      catalog::Column(type::TypeId::INTEGER,
+                      type::Type::GetTypeSize(type::TypeId::INTEGER), "A",
+                      true),
+      catalog::Column(type::TypeId::SMALLINT,
+                      type::Type::GetTypeSize(type::TypeId::SMALLINT), "B",
+                      true),
+      catalog::Column(type::TypeId::VARCHAR, 64, "C", false),
+      catalog::Column(type::TypeId::DECIMAL,
+                      type::Type::GetTypeSize(type::TypeId::DECIMAL), "D",
+                      true),
+      catalog::Column(type::TypeId::BIGINT,
+                      type::Type::GetTypeSize(type::TypeId::BIGINT), "E",
+                      true)};
+  catalog::Schema schema(columns);
+  storage::TupleSerializer serializer(schema);
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // A varchar short enough to be stored in its slot, a long one and NULL
+  std::vector<type::Value> varchars = {
+      type::ValueFactory::GetVarcharValue("abc"),
+      type::ValueFactory::GetVarcharValue(std::string(40, 'x')),
+      type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR)};
+
+  for (auto &varchar : varchars) {
+    storage::Tuple tuple(&schema, true);
+    tuple.SetValue(0, type::ValueFactory::GetIntegerValue(-17), pool);
+    tuple.SetValue(1, type::ValueFactory::GetSmallIntValue(3), pool);
+    tuple.SetValue(2, varchar, pool);
+    tuple.SetValue(3, type::ValueFactory::GetDecimalValue(2.5), pool);
+    tuple.SetValue(4, type::ValueFactory::GetNullValueByType(
+                          type::TypeId::BIGINT),
+                   pool);
+
+    CopySerializeOutput expected;
+    for (oid_t column_id = 0; column_id < schema.GetColumnCount();
+         column_id++) {
+      tuple.GetValue(column_id).SerializeTo(expected);
+    }
+
+    CopySerializeOutput output;
+    serializer.SerializeTo(tuple, output);
+    EXPECT_EQ(ToString(expected), ToString(output));
+
+    const char *location = tuple.GetData();
+    EXPECT_EQ(expected.Size(), serializer.GetSerializedSize(&location));
+  }
+}
+
+TEST_F(TupleSerializerTests, TileGroupTest) {
+  const int tuple_count = 20;
+  std::shared_ptr<storage::TileGroup> tile_group(
+      TestingExecutorUtil::CreateTileGroup(tuple_count));
+  TestingExecutorUtil::PopulateTiles(tile_group, tuple_count);
+
+  auto &serializer = tile_group->GetSerializer();
+  oid_t column_count = tile_group->GetColumnMap().size();
+
+  CopySerializeOutput expected_range;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    CopySerializeOutput expected;
+    for (oid_t column_id = 0; column_id < column_count; column_id++) {
+      tile_group->GetValue(tuple_id, column_id).SerializeTo(expected);
+      tile_group->GetValue(tuple_id, column_id).SerializeTo(expected_range);
+    }
+
+    CopySerializeOutput output;
+    serializer.SerializeTo(tile_group.get(), tuple_id, output);
+    EXPECT_EQ(ToString(expected), ToString(output));
+  }
+
+  // The range is serialized back to back after what is already there
+  CopySerializeOutput output;
+  output.WriteInt(42);
+  serializer.SerializeRangeTo(tile_group.get(), 0, tuple_count, output);
+  EXPECT_EQ(sizeof(int32_t) + expected_range.Size(), output.Size());
+  EXPECT_EQ(ToString(expected_range),
+            ToString(output).substr(sizeof(int32_t)));
+}
+
+}  // namespace test
+}  // namespace peloton
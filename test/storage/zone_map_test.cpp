@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// zone_map_test.cpp
+//
+// Identification: test/storage/zone_map_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/testing_executor_util.h"
+#include "expression/expression_util.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/zone_map.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Zone Map Tests
+//===--------------------------------------------------------------------===//
+
+class ZoneMapTests : public PelotonTest {};
+
+// col_0 <comparison_type> value
+expression::AbstractExpression *MakeComparison(ExpressionType comparison_type,
+                                               int value,
+                                               bool constant_first = false) {
+  auto column = expression::ExpressionUtil::TupleValueFactory(
+      type::TypeId::INTEGER, 0, 0);
+  auto constant = expression::ExpressionUtil::ConstantValueFactory(
+      type::ValueFactory::GetIntegerValue(value));
+  if (constant_first == true) {
+    return expression::ExpressionUtil::ComparisonFactory(comparison_type,
+                                                         constant, column);
+  }
+  return expression::ExpressionUtil::ComparisonFactory(comparison_type, column,
+                                                       constant);
+}
+
+TEST_F(ZoneMapTests, WidenTest) {
+  storage::ZoneMap zone_map(2);
+
+  EXPECT_EQ(type::TypeId::INVALID, zone_map.GetMinValue(0).GetTypeId());
+
+  for (int i = 10; i > 0; i--) {
+    zone_map.Widen(0, type::ValueFactory::GetIntegerValue(i));
+    zone_map.Widen(1, type::ValueFactory::GetVarcharValue(std::to_string(i)));
+  }
+  EXPECT_FALSE(zone_map.HasNulls());
+  zone_map.Widen(0,
+                 type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER));
+
+  EXPECT_EQ(type::CmpBool::CMP_TRUE,
+            zone_map.GetMinValue(0).CompareEquals(
+                type::ValueFactory::GetIntegerValue(1)));
+  EXPECT_EQ(type::CmpBool::CMP_TRUE,
+            zone_map.GetMaxValue(0).CompareEquals(
+                type::ValueFactory::GetIntegerValue(10)));
+  EXPECT_EQ(type::CmpBool::CMP_TRUE,
+            zone_map.GetMinValue(1).CompareEquals(
+                type::ValueFactory::GetVarcharValue("1")));
+  EXPECT_EQ(type::CmpBool::CMP_TRUE,
+            zone_map.GetMaxValue(1).CompareEquals(
+                type::ValueFactory::GetVarcharValue("9")));
+  EXPECT_EQ(1U, zone_map.GetNullCount(0));
+  EXPECT_EQ(0U, zone_map.GetNullCount(1));
+  EXPECT_TRUE(zone_map.HasNulls());
+
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      MakeComparison(ExpressionType::COMPARE_GREATERTHAN, 10));
+  EXPECT_FALSE(zone_map.CanSatisfy(predicate.get()));
+  predicate.reset(
+      MakeComparison(ExpressionType::COMPARE_GREATERTHANOREQUALTO, 10));
+  EXPECT_TRUE(zone_map.CanSatisfy(predicate.get()));
+  predicate.reset(MakeComparison(ExpressionType::COMPARE_LESSTHAN, 1));
+  EXPECT_FALSE(zone_map.CanSatisfy(predicate.get()));
+  predicate.reset(MakeComparison(ExpressionType::COMPARE_EQUAL, 5));
+  EXPECT_TRUE(zone_map.CanSatisfy(predicate.get()));
+  predicate.reset(MakeComparison(ExpressionType::COMPARE_EQUAL, 11));
+  EXPECT_FALSE(zone_map.CanSatisfy(predicate.get()));
+
+  // 11 < col_0
+  predicate.reset(MakeComparison(ExpressionType::COMPARE_LESSTHAN, 11, true));
+  EXPECT_FALSE(zone_map.CanSatisfy(predicate.get()));
+
+  // col_0 > 10 OR col_0 < 2
+  predicate.reset(expression::ExpressionUtil::ConjunctionFactory(
+      ExpressionType::CONJUNCTION_OR,
+      MakeComparison(ExpressionType::COMPARE_GREATERTHAN, 10),
+      MakeComparison(ExpressionType::COMPARE_LESSTHAN, 2)));
+  EXPECT_TRUE(zone_map.CanSatisfy(predicate.get()));
+}
+
+TEST_F(ZoneMapTests, TileGroupTest) {
+  const int tuples_per_tilegroup = TESTS_TUPLES_PER_TILEGROUP;
+  const int tuple_count = tuples_per_tilegroup * 2 + 1;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      TestingExecutorUtil::CreateTable(tuples_per_tilegroup, false));
+  TestingExecutorUtil::PopulateTable(data_table.get(), tuple_count, false,
+                                     false, false, txn);
+  txn_manager.CommitTransaction(txn);
+
+  // col_0 of tuple i is 10 * i
+  // 50 <= col_0 AND col_0 < 100
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ConjunctionFactory(
+          ExpressionType::CONJUNCTION_AND,
+          MakeComparison(ExpressionType::COMPARE_LESSTHANOREQUALTO, 50, true),
+          MakeComparison(ExpressionType::COMPARE_LESSTHAN, 100)));
+
+  auto tile_group_count = data_table->GetTileGroupCount();
+  EXPECT_EQ(3U, tile_group_count);
+
+  std::vector<bool> expected = {false, true, false};
+  for (oid_t tile_group_offset = 0; tile_group_offset < tile_group_count;
+       tile_group_offset++) {
+    auto tile_group = data_table->GetTileGroup(tile_group_offset);
+    auto zone_map = tile_group->GetZoneMap();
+    LOG_INFO("%s", zone_map->GetInfo().c_str());
+    EXPECT_EQ(expected[tile_group_offset],
+              zone_map->CanSatisfy(predicate.get()));
+  }
+
+  // Updating a value in place widens the zone map
+  auto tile_group = data_table->GetTileGroup(0);
+  auto value = type::ValueFactory::GetIntegerValue(70);
+  tile_group->SetValue(value, 0, 0);
+  EXPECT_TRUE(tile_group->GetZoneMap()->CanSatisfy(predicate.get()));
+}
+
+}  // End test namespace
+}  // End peloton namespace
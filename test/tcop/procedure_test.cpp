@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// procedure_test.cpp
+//
+// Identification: test/tcop/procedure_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/catalog.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "sql/testing_sql_util.h"
+#include "tcop/procedure_manager.h"
+#include "type/value_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Stored Procedure Tests
+//===--------------------------------------------------------------------===//
+
+class ProcedureTests : public PelotonTest {
+ protected:
+  void SetUp() override {
+    PelotonTest::SetUp();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->CreateDatabase(DEFAULT_DB_NAME, txn);
+    txn_manager.CommitTransaction(txn);
+    TestingSQLUtil::ExecuteSQLQuery(
+        "CREATE TABLE accounts(id INT PRIMARY KEY, balance INT);");
+    TestingSQLUtil::ExecuteSQLQuery(
+        "INSERT INTO accounts VALUES (1, 100), (2, 50);");
+  }
+
+  void TearDown() override {
+    tcop::ProcedureManager::GetInstance().Clear();
+    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+    auto txn = txn_manager.BeginTransaction();
+    catalog::Catalog::GetInstance()->DropDatabaseWithName(DEFAULT_DB_NAME,
+                                                          txn);
+    txn_manager.CommitTransaction(txn);
+    PelotonTest::TearDown();
+  }
+
+  ResultType Execute(const std::string &query,
+                     std::vector<StatementResult> &result) {
+    return TestingSQLUtil::ExecuteSQLQuery(query, result);
+  }
+
+  std::string GetBalance(const int id) {
+    std::vector<StatementResult> result;
+    EXPECT_EQ(ResultType::SUCCESS,
+              Execute("SELECT balance FROM accounts WHERE id = " +
+                          std::to_string(id) + ";",
+                      result));
+    return result.size() == 1
+               ? TestingSQLUtil::GetResultValueAsString(result, 0)
+               : "";
+  }
+};
+
+TEST_F(ProcedureTests, CallTest) {
+  std::vector<StatementResult> result;
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute("CREATE PROCEDURE transfer AS "
+                    "UPDATE accounts SET balance = balance - $3 "
+                    "WHERE id = $1; "
+                    "UPDATE accounts SET balance = balance + $3 "
+                    "WHERE id = $2; "
+                    "SELECT balance FROM accounts WHERE id = $1;",
+                    result));
+  EXPECT_EQ(1U, tcop::ProcedureManager::GetInstance().GetCount());
+  auto procedure = tcop::ProcedureManager::GetInstance().GetProcedure(
+      "TRANSFER");
+  ASSERT_NE(nullptr, procedure);
+  EXPECT_EQ(3U, procedure->parameter_count);
+  EXPECT_EQ(3U, procedure->queries.size());
+
+  // The rows are those of the last statement, and the prepared statements
+  // are reused by the next call
+  for (int call = 1; call <= 2; call++) {
+    EXPECT_EQ(ResultType::SUCCESS, Execute("CALL transfer(1, 2, 10);",
+                                           result));
+    ASSERT_EQ(1U, result.size());
+    EXPECT_EQ(std::to_string(100 - call * 10),
+              TestingSQLUtil::GetResultValueAsString(result, 0));
+  }
+  EXPECT_EQ("70", GetBalance(2));
+
+  // The C++ interface binds the arguments the same way
+  std::vector<FieldInfo> tuple_descriptor;
+  std::string error_message;
+  int rows_changed;
+  std::vector<type::Value> params = {type::ValueFactory::GetIntegerValue(2),
+                                     type::ValueFactory::GetIntegerValue(1),
+                                     type::ValueFactory::GetIntegerValue(5)};
+  EXPECT_EQ(ResultType::SUCCESS,
+            TestingSQLUtil::traffic_cop_.ExecuteProcedure(
+                "transfer", params, result, tuple_descriptor, rows_changed,
+                error_message));
+  EXPECT_EQ(2, rows_changed);
+  EXPECT_EQ(1U, tuple_descriptor.size());
+  EXPECT_EQ("85", GetBalance(1));
+
+  EXPECT_EQ(ResultType::SUCCESS, Execute("DROP PROCEDURE transfer;", result));
+  EXPECT_EQ(0U, tcop::ProcedureManager::GetInstance().GetCount());
+  EXPECT_EQ(ResultType::FAILURE, Execute("CALL transfer(1, 2, 10);", result));
+  EXPECT_EQ(ResultType::FAILURE, Execute("DROP PROCEDURE transfer;", result));
+}
+
+TEST_F(ProcedureTests, FailedCallTest) {
+  std::vector<StatementResult> result;
+  EXPECT_EQ(ResultType::SUCCESS,
+            Execute("CREATE PROCEDURE open_account AS "
+                    "UPDATE accounts SET balance = balance - $2 "
+                    "WHERE id = 1; "
+                    "INSERT INTO accounts VALUES ($1, $2);",
+                    result));
+
+  // A failed statement rolls back the ones before it
+  EXPECT_EQ(ResultType::FAILURE, Execute("CALL open_account(2, 10);",
+                                         result));
+  EXPECT_EQ("100", GetBalance(1));
+  EXPECT_EQ(ResultType::SUCCESS, Execute("CALL open_account(3, 10);",
+                                         result));
+  EXPECT_EQ("90", GetBalance(1));
+  EXPECT_EQ("10", GetBalance(3));
+
+  // The arguments have to match the parameters and be constants
+  EXPECT_EQ(ResultType::FAILURE, Execute("CALL open_account(4);", result));
+  EXPECT_EQ(ResultType::FAILURE, Execute("CALL open_account(4, id);",
+                                         result));
+
+  // A procedure cannot end its transaction or use missing tables
+  EXPECT_EQ(ResultType::FAILURE,
+            Execute("CREATE PROCEDURE p AS DELETE FROM accounts; COMMIT;",
+                    result));
+  EXPECT_EQ(ResultType::FAILURE,
+            Execute("CREATE PROCEDURE p AS SELECT * FROM customers;",
+                    result));
+  EXPECT_EQ(1U, tcop::ProcedureManager::GetInstance().GetCount());
+}
+
+TEST_F(ProcedureTests, SplitQueriesTest) {
+  size_t parameter_count;
+  auto queries = tcop::ProcedureManager::SplitQueries(
+      " INSERT INTO t VALUES ($2, 'a;b'); ;SELECT \"x;\" FROM t WHERE a = $10",
+      parameter_count);
+  ASSERT_EQ(2U, queries.size());
+  EXPECT_EQ("INSERT INTO t VALUES ($2, 'a;b')", queries[0]);
+  EXPECT_EQ("SELECT \"x;\" FROM t WHERE a = $10", queries[1]);
+  EXPECT_EQ(10U, parameter_count);
+}
+
+}  // End test namespace
+}  // End peloton namespace
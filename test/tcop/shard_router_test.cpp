@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// shard_router_test.cpp
+//
+// Identification: test/tcop/shard_router_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/shard_map.h"
+#include "parser/postgresparser.h"
+#include "parser/select_statement.h"
+#include "tcop/shard_router.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Shard Router Tests
+//===--------------------------------------------------------------------===//
+
+class ShardRouterTests : public PelotonTest {
+ protected:
+  void SetUp() override {
+    PelotonTest::SetUp();
+    catalog::ShardMap::GetInstance().Configure(
+        "127.0.0.1:15445,127.0.0.1:15446", 0,
+        "orders:range:id:100,items:range:order_id:100");
+  }
+
+  void TearDown() override {
+    catalog::ShardMap::GetInstance().Configure("", 0, "");
+    PelotonTest::TearDown();
+  }
+
+  // The target of the statement, or false if it cannot be routed
+  bool GetTarget(const std::string &query, tcop::ShardTarget &target) {
+    auto statements =
+        parser::PostgresParser::GetInstance().BuildParseTree(query);
+    std::string error_message;
+    return tcop::ShardRouter::GetTarget(statements->GetStatement(0), target,
+                                        error_message);
+  }
+
+  // The rows of the shards merged for the query
+  bool Merge(const std::string &query,
+             const std::vector<tcop::ShardResult> &shard_results,
+             tcop::ShardResult &merged) {
+    auto statements =
+        parser::PostgresParser::GetInstance().BuildParseTree(query);
+    std::string error_message;
+    return tcop::ShardRouter::MergeResults(
+        *(parser::SelectStatement *)statements->GetStatement(0),
+        shard_results, merged, error_message);
+  }
+
+  tcop::ShardResult MakeResult(
+      const std::vector<std::string> &names,
+      const std::vector<std::vector<std::string>> &rows) {
+    tcop::ShardResult shard_result;
+    for (auto &name : names) {
+      shard_result.columns.emplace_back(
+          name, static_cast<oid_t>(PostgresValueType::BIGINT), 8);
+    }
+    shard_result.rows = rows;
+    return shard_result;
+  }
+};
+
+TEST_F(ShardRouterTests, TargetTest) {
+  tcop::ShardTarget target;
+
+  // A statement selecting its shard key goes to that shard
+  EXPECT_TRUE(GetTarget("SELECT * FROM orders WHERE id = 150;", target));
+  EXPECT_EQ(tcop::ShardTargetType::SINGLE, target.type);
+  EXPECT_EQ(1U, target.node_id);
+  EXPECT_FALSE(target.is_write);
+  EXPECT_TRUE(GetTarget(
+      "SELECT * FROM orders o WHERE o.total > 5 AND 20 = o.id;", target));
+  EXPECT_EQ(tcop::ShardTargetType::SINGLE, target.type);
+  EXPECT_EQ(0U, target.node_id);
+  EXPECT_TRUE(GetTarget("UPDATE orders SET total = 1 WHERE id = 7;", target));
+  EXPECT_EQ(tcop::ShardTargetType::SINGLE, target.type);
+  EXPECT_TRUE(target.is_write);
+  EXPECT_TRUE(GetTarget(
+      "INSERT INTO orders (total, id) VALUES (1, 101), (2, 102);", target));
+  EXPECT_EQ(tcop::ShardTargetType::SINGLE, target.type);
+  EXPECT_EQ(1U, target.node_id);
+
+  // Any other goes to every shard
+  EXPECT_TRUE(GetTarget("SELECT * FROM orders WHERE id > 5;", target));
+  EXPECT_EQ(tcop::ShardTargetType::ALL, target.type);
+  EXPECT_TRUE(GetTarget(
+      "SELECT * FROM orders WHERE id = 5 OR id = 150;", target));
+  EXPECT_EQ(tcop::ShardTargetType::ALL, target.type);
+  EXPECT_TRUE(GetTarget("DELETE FROM orders;", target));
+  EXPECT_EQ(tcop::ShardTargetType::ALL, target.type);
+  EXPECT_TRUE(target.is_write);
+  EXPECT_TRUE(GetTarget("CREATE TABLE orders (id INT, total INT);", target));
+  EXPECT_EQ(tcop::ShardTargetType::ALL, target.type);
+
+  // The tables that are not sharded stay on this node
+  EXPECT_TRUE(GetTarget("SELECT * FROM customers;", target));
+  EXPECT_EQ(tcop::ShardTargetType::LOCAL, target.type);
+  EXPECT_TRUE(GetTarget("CREATE TABLE customers (id INT);", target));
+  EXPECT_EQ(tcop::ShardTargetType::LOCAL, target.type);
+
+  // A join runs on one shard
+  EXPECT_TRUE(GetTarget(
+      "SELECT * FROM orders, items WHERE orders.id = 5 AND "
+      "items.order_id = 5;",
+      target));
+  EXPECT_EQ(tcop::ShardTargetType::SINGLE, target.type);
+  EXPECT_EQ(0U, target.node_id);
+}
+
+TEST_F(ShardRouterTests, UnsupportedTargetTest) {
+  tcop::ShardTarget target;
+  EXPECT_FALSE(GetTarget(
+      "INSERT INTO orders (id, total) VALUES (1, 1), (101, 2);", target));
+  EXPECT_FALSE(GetTarget(
+      "INSERT INTO orders (total) VALUES (1);", target));
+  EXPECT_FALSE(GetTarget("UPDATE orders SET id = 3 WHERE id = 2;", target));
+  EXPECT_FALSE(GetTarget(
+      "SELECT * FROM orders, items WHERE orders.id = items.order_id;",
+      target));
+  EXPECT_FALSE(GetTarget(
+      "SELECT * FROM orders, items WHERE orders.id = 5 AND "
+      "items.order_id = 150;",
+      target));
+}
+
+TEST_F(ShardRouterTests, MergeAggregateTest) {
+  tcop::ShardResult merged;
+  std::vector<tcop::ShardResult> shard_results = {
+      MakeResult({"b", "count(*)", "sum", "min", "max"},
+                 {{"1", "2", "10", "3", "7"}, {"2", "1", "", "", ""}}),
+      MakeResult({"b", "count(*)", "sum", "min", "max"},
+                 {{"1", "3", "5", "1", "6"}, {"3", "1", "4", "4", "4"}})};
+  EXPECT_TRUE(Merge(
+      "SELECT b, COUNT(*), SUM(a), MIN(a), MAX(a) FROM orders GROUP BY b "
+      "ORDER BY b DESC;",
+      shard_results, merged));
+  std::vector<std::vector<std::string>> expected_rows = {
+      {"3", "1", "4", "4", "4"},
+      {"2", "1", "", "", ""},
+      {"1", "5", "15", "1", "7"}};
+  EXPECT_EQ(expected_rows, merged.rows);
+
+  // Averages and skipped rows cannot be merged
+  EXPECT_FALSE(Merge("SELECT b, AVG(a) FROM orders GROUP BY b;",
+                     shard_results, merged));
+  EXPECT_FALSE(Merge("SELECT * FROM orders LIMIT 2 OFFSET 1;", shard_results,
+                     merged));
+}
+
+TEST_F(ShardRouterTests, MergeRowsTest) {
+  tcop::ShardResult merged;
+  std::vector<tcop::ShardResult> shard_results = {
+      MakeResult({"id", "total"}, {{"4", "1"}, {"2", ""}}),
+      MakeResult({"id", "total"}, {{"3", "1"}, {"2", ""}})};
+
+  EXPECT_TRUE(Merge("SELECT id, total FROM orders ORDER BY id LIMIT 3;",
+                    shard_results, merged));
+  std::vector<std::vector<std::string>> expected_rows = {
+      {"2", ""}, {"2", ""}, {"3", "1"}};
+  EXPECT_EQ(expected_rows, merged.rows);
+
+  // NULL sorts last
+  EXPECT_TRUE(Merge(
+      "SELECT DISTINCT id, total FROM orders ORDER BY total, id DESC;",
+      shard_results, merged));
+  expected_rows = {{"4", "1"}, {"3", "1"}, {"2", ""}};
+  EXPECT_EQ(expected_rows, merged.rows);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tcop_pool_test.cpp
+//
+// Identification: test/tcop/tcop_pool_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>
+
+#include "common/harness.h"
+
+#include "tcop/tcop.h"
+#include "tcop/tcop_pool.h"
+
+namespace peloton {
+namespace test {
+
+class TrafficCopPoolTests : public PelotonTest {};
+
+TEST_F(TrafficCopPoolTests, AcquireReleaseTest) {
+  FLAGS_execution_contexts = 2;
+  auto &pool = tcop::TrafficCopPool::GetInstance();
+  size_t count = pool.GetCount();
+
+  // Traffic cops are created up to the limit and reused once given back
+  auto first = pool.Acquire();
+  auto second = pool.Acquire();
+  EXPECT_NE(first, second);
+  EXPECT_GE(2U, pool.GetCount());
+  pool.Release(first);
+  EXPECT_EQ(first, pool.Acquire());
+
+  // With all of them taken, a connection waits for one to be given back
+  tcop::TrafficCop *third = nullptr;
+  std::thread waiter([&pool, &third]() { third = pool.Acquire(); });
+  pool.Release(second);
+  waiter.join();
+  EXPECT_EQ(second, third);
+  EXPECT_GE(2U, pool.GetCount());
+  EXPECT_LE(count, pool.GetCount());
+
+  pool.Release(first);
+  pool.Release(third);
+  EXPECT_EQ(pool.GetCount(), pool.GetFreeCount());
+  FLAGS_execution_contexts = 0;
+}
+
+}  // namespace test
+}  // namespace peloton
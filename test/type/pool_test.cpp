@@ -13,6 +13,10 @@
 #include <limits.h>
 #include <pthread.h>
 
+#include <thread>
+#include <unordered_map>
+
+#include "type/arena_pool.h"
 #include "type/ephemeral_pool.h"
 #include "gtest/gtest.h"
 #include "common/harness.h"
@@ -65,5 +69,63 @@ TEST_F(PoolTests, AllocateOnceTest) {
   delete pool;
 }
 
+// Concurrent allocations from an arena never overlap
+TEST_F(PoolTests, ArenaPoolTest) {
+  type::ArenaPool pool(4096);
+  const int thread_count = 4;
+  const int allocation_count = 1000;
+
+  std::vector<std::vector<char *>> locations(thread_count);
+  std::vector<std::thread> threads;
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    threads.push_back(std::thread([&pool, &locations, thread_itr] {
+      for (int allocation_itr = 0; allocation_itr < allocation_count;
+           allocation_itr++) {
+        auto location = reinterpret_cast<char *>(pool.Allocate(12));
+        EXPECT_TRUE(location != nullptr);
+        EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(location) % 8);
+        PL_MEMSET(location, thread_itr, 12);
+        locations[thread_itr].push_back(location);
+      }
+    }));
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    for (auto location : locations[thread_itr]) {
+      for (int byte_itr = 0; byte_itr < 12; byte_itr++) {
+        EXPECT_EQ(thread_itr, location[byte_itr]);
+      }
+    }
+  }
+
+  // Large blocks get a chunk of their own
+  auto allocated_size = pool.GetAllocatedSize();
+  EXPECT_TRUE(pool.Allocate(str_len * 2) != nullptr);
+  EXPECT_EQ(allocated_size + str_len * 2, pool.GetAllocatedSize());
+}
+
+// A hash table drawing its nodes from an arena
+TEST_F(PoolTests, ArenaAllocatorTest) {
+  type::ArenaPool pool;
+  typedef type::ArenaAllocator<std::pair<const int, int>> Allocator;
+  std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, Allocator>
+      map(0, std::hash<int>(), std::equal_to<int>(), Allocator(&pool));
+  for (int key = 0; key < 10000; key++) {
+    map[key] = key * 2;
+  }
+  for (int key = 0; key < 10000; key++) {
+    EXPECT_EQ(key * 2, map.at(key));
+  }
+  EXPECT_TRUE(pool.GetAllocatedSize() > 0);
+
+  // The nodes stay in the arena until it is destroyed
+  auto allocated_size = pool.GetAllocatedSize();
+  map.clear();
+  EXPECT_EQ(allocated_size, pool.GetAllocatedSize());
+}
+
 }
 }
@@ -80,7 +80,8 @@ TEST_F(TypesTests, DatePartTypeTest) {
 TEST_F(TypesTests, BackendTypeTest) {
   std::vector<BackendType> list = {BackendType::INVALID, BackendType::MM,
                                    BackendType::NVM, BackendType::SSD,
-                                   BackendType::HDD};
+                                   BackendType::HDD,
+                                   BackendType::HUGE_PAGE};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {
@@ -136,7 +137,7 @@ TEST_F(TypesTests, StatementTypeTest) {
       StatementType::DROP,    StatementType::PREPARE,
       StatementType::EXECUTE, StatementType::RENAME,
       StatementType::ALTER,   StatementType::TRANSACTION,
-      StatementType::COPY};
+      StatementType::COPY,    StatementType::EXPLAIN};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {
@@ -197,6 +198,7 @@ TEST_F(TypesTests, ExpressionTypeTest) {
       ExpressionType::AGGREGATE_MIN,
       ExpressionType::AGGREGATE_MAX,
       ExpressionType::AGGREGATE_AVG,
+      ExpressionType::AGGREGATE_APPROX_COUNT_DISTINCT,
       ExpressionType::FUNCTION,
       ExpressionType::HASH_RANGE,
       ExpressionType::OPERATOR_CASE_EXPR,
@@ -251,7 +253,8 @@ TEST_F(TypesTests, ExpressionTypeTest) {
 
 TEST_F(TypesTests, IndexTypeTest) {
   std::vector<IndexType> list = {IndexType::INVALID, IndexType::BWTREE,
-                                 IndexType::HASH, IndexType::SKIPLIST};
+                                 IndexType::HASH, IndexType::SKIPLIST,
+                                 IndexType::ART};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {
@@ -355,19 +358,22 @@ TEST_F(TypesTests, PlanNodeTypeTest) {
   std::vector<PlanNodeType> list = {
       PlanNodeType::INVALID,     PlanNodeType::ABSTRACT_SCAN,
       PlanNodeType::SEQSCAN,     PlanNodeType::INDEXSCAN,
+      PlanNodeType::AGGREGATE_VIEW_SCAN,
       PlanNodeType::NESTLOOP,    PlanNodeType::NESTLOOPINDEX,
       PlanNodeType::MERGEJOIN,   PlanNodeType::HASHJOIN,
       PlanNodeType::UPDATE,      PlanNodeType::INSERT,
       PlanNodeType::DELETE,      PlanNodeType::DROP,
       PlanNodeType::CREATE,      PlanNodeType::SEND,
       PlanNodeType::RECEIVE,     PlanNodeType::PRINT,
-      PlanNodeType::AGGREGATE,   PlanNodeType::UNION,
-      PlanNodeType::ORDERBY,     PlanNodeType::PROJECTION,
-      PlanNodeType::MATERIALIZE, PlanNodeType::LIMIT,
-      PlanNodeType::DISTINCT,    PlanNodeType::SETOP,
-      PlanNodeType::APPEND,      PlanNodeType::AGGREGATE_V2,
-      PlanNodeType::HASH,        PlanNodeType::RESULT,
-      PlanNodeType::COPY,        PlanNodeType::MOCK};
+      PlanNodeType::EXCHANGE,    PlanNodeType::AGGREGATE,
+      PlanNodeType::UNION,       PlanNodeType::ORDERBY,
+      PlanNodeType::PROJECTION,  PlanNodeType::MATERIALIZE,
+      PlanNodeType::LIMIT,       PlanNodeType::DISTINCT,
+      PlanNodeType::SETOP,       PlanNodeType::APPEND,
+      PlanNodeType::AGGREGATE_V2, PlanNodeType::HASH,
+      PlanNodeType::WINDOW,
+      PlanNodeType::RESULT,      PlanNodeType::COPY,
+      PlanNodeType::MOCK};
 
   // Make sure that ToString and FromString work
   for (auto val : list) {
@@ -510,6 +516,29 @@ TEST_F(TypesTests, CheckpointingTypeTest) {
                peloton::Exception);
 }
 
+TEST_F(TypesTests, ConflictTypeTest) {
+  std::vector<ConflictType> list = {
+      ConflictType::INVALID, ConflictType::WRITE_WRITE,
+      ConflictType::READ_WRITE, ConflictType::WRITE_READ,
+      ConflictType::VALIDATION};
+
+  // Make sure that ToString and FromString work
+  for (auto val : list) {
+    std::string str = peloton::ConflictTypeToString(val);
+    EXPECT_TRUE(str.size() > 0);
+
+    auto newVal = peloton::StringToConflictType(str);
+    EXPECT_EQ(val, newVal);
+  }
+
+  // Then make sure that we can't cast garbage
+  std::string invalid("WU TANG");
+  EXPECT_THROW(peloton::StringToConflictType(invalid), peloton::Exception);
+  EXPECT_THROW(
+      peloton::ConflictTypeToString(static_cast<ConflictType>(-99999)),
+      peloton::Exception);
+}
+
 TEST_F(TypesTests, GarbageCollectionTypeTest) {
   std::vector<GarbageCollectionType> list = {
       GarbageCollectionType::INVALID, GarbageCollectionType::OFF, GarbageCollectionType::ON
@@ -534,7 +563,9 @@ TEST_F(TypesTests, GarbageCollectionTypeTest) {
 TEST_F(TypesTests, ProtocolTypeTest) {
   std::vector<ProtocolType> list = {
       ProtocolType::INVALID, 
-      ProtocolType::TIMESTAMP_ORDERING
+      ProtocolType::TIMESTAMP_ORDERING,
+      ProtocolType::OPTIMISTIC,
+      ProtocolType::PARTITIONED
   };
 
   // Make sure that ToString and FromString work
@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// value_dispatch_test.cpp
+//
+// Identification: test/type/value_dispatch_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "common/harness.h"
+
+#include "type/ephemeral_pool.h"
+#include "type/value_dispatch.h"
+#include "type/value_factory.h"
+#include "type/value_ref.h"
+
+namespace peloton {
+namespace test {
+
+class ValueDispatchTests : public PelotonTest {};
+
+namespace {
+
+const std::vector<ExpressionType> compare_types = {
+    ExpressionType::COMPARE_EQUAL,
+    ExpressionType::COMPARE_NOTEQUAL,
+    ExpressionType::COMPARE_LESSTHAN,
+    ExpressionType::COMPARE_GREATERTHAN,
+    ExpressionType::COMPARE_LESSTHANOREQUALTO,
+    ExpressionType::COMPARE_GREATERTHANOREQUALTO};
+
+type::CmpBool CompareVirtual(ExpressionType compare_type,
+                             const type::Value &left,
+                             const type::Value &right) {
+  switch (compare_type) {
+    case ExpressionType::COMPARE_EQUAL:
+      return left.CompareEquals(right);
+    case ExpressionType::COMPARE_NOTEQUAL:
+      return left.CompareNotEquals(right);
+    case ExpressionType::COMPARE_LESSTHAN:
+      return left.CompareLessThan(right);
+    case ExpressionType::COMPARE_GREATERTHAN:
+      return left.CompareGreaterThan(right);
+    case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+      return left.CompareLessThanEquals(right);
+    default:
+      return left.CompareGreaterThanEquals(right);
+  }
+}
+
+// Every kernel agrees with the comparison through the Type
+void CheckCompare(const std::vector<type::Value> &values) {
+  for (auto compare_type : compare_types) {
+    for (auto &left : values) {
+      for (auto &right : values) {
+        auto compare = type::ValueDispatch::GetCompareFunction(
+            compare_type, left.GetTypeId(), right.GetTypeId());
+        ASSERT_NE(nullptr, compare);
+        EXPECT_EQ(CompareVirtual(compare_type, left, right),
+                  compare(left, right))
+            << left.ToString() << " " << ExpressionTypeToString(compare_type)
+            << " " << right.ToString();
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST_F(ValueDispatchTests, NumericCompareTest) {
+  CheckCompare({type::ValueFactory::GetTinyIntValue(-3),
+                type::ValueFactory::GetTinyIntValue(7),
+                type::ValueFactory::GetSmallIntValue(7),
+                type::ValueFactory::GetIntegerValue(-100000),
+                type::ValueFactory::GetIntegerValue(7),
+                type::ValueFactory::GetBigIntValue(1LL << 40),
+                type::ValueFactory::GetDecimalValue(6.5),
+                type::ValueFactory::GetDecimalValue(7),
+                type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER),
+                type::ValueFactory::GetNullValueByType(type::TypeId::DECIMAL)});
+}
+
+TEST_F(ValueDispatchTests, VarcharCompareTest) {
+  CheckCompare({type::ValueFactory::GetVarcharValue("abc"),
+                type::ValueFactory::GetVarcharValue("abcd"),
+                type::ValueFactory::GetVarcharValue("abd"),
+                type::ValueFactory::GetVarcharValue(""),
+                type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR)});
+  CheckCompare({type::ValueFactory::GetBooleanValue(true),
+                type::ValueFactory::GetBooleanValue(false),
+                type::ValueFactory::GetNullValueByType(type::TypeId::BOOLEAN)});
+  CheckCompare({type::ValueFactory::GetTimestampValue(1),
+                type::ValueFactory::GetTimestampValue(2)});
+
+  // Only comparisons have kernels
+  EXPECT_EQ(nullptr, type::ValueDispatch::GetCompareFunction(
+                         ExpressionType::OPERATOR_PLUS,
+                         type::TypeId::INTEGER, type::TypeId::INTEGER));
+}
+
+TEST_F(ValueDispatchTests, ValueRefTest) {
+  type::EphemeralPool pool;
+  std::vector<type::Value> values = {
+      type::ValueFactory::GetIntegerValue(42),
+      type::ValueFactory::GetNullValueByType(type::TypeId::INTEGER),
+      type::ValueFactory::GetDecimalValue(-1.5),
+      type::ValueFactory::GetVarcharValue("peloton"),
+      type::ValueFactory::GetNullValueByType(type::TypeId::VARCHAR)};
+
+  // A view of the storage reads what the Value was serialized as
+  for (auto &value : values) {
+    char storage[sizeof(int64_t)];
+    value.SerializeTo(storage, false, &pool);
+    type::ValueRef ref(value.GetTypeId(), storage);
+    EXPECT_EQ(value.IsNull(), ref.IsNull());
+    EXPECT_EQ(value.IsNull(), ref.ToValue().IsNull());
+    if (value.IsNull() == false) {
+      EXPECT_EQ(type::CMP_TRUE, value.CompareEquals(ref.ToValue()));
+      EXPECT_EQ(0, ref.Compare(type::ValueRef(value)));
+    }
+  }
+
+  auto abc = type::ValueFactory::GetVarcharValue("abc");
+  auto abd = type::ValueFactory::GetVarcharValue("abd");
+  EXPECT_GT(0, type::ValueRef(abc).Compare(type::ValueRef(abd)));
+  EXPECT_LT(0, type::ValueRef(abd).Compare(type::ValueRef(abc)));
+
+  // The view does not copy the data
+  EXPECT_EQ(abc.GetData(), type::ValueRef(abc).GetData());
+  EXPECT_EQ(abc.GetData(), type::ValueRef(abc).ToValue().GetData());
+
+  // NULL compares equal, like in the index comparators
+  EXPECT_EQ(0, type::ValueRef(values[1]).Compare(type::ValueRef(values[0])));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wire_format_test.cpp
+//
+// Identification: test/type/wire_format_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "common/harness.h"
+
+#include "type/value_factory.h"
+#include "type/wire_format.h"
+
+namespace peloton {
+namespace test {
+
+class WireFormatTests : public PelotonTest {};
+
+namespace {
+
+// Encode the value in binary and decode it as the type its column is
+// described as
+type::Value RoundTrip(const type::Value &value, PostgresValueType type) {
+  std::vector<unsigned char> bytes;
+  type::WireFormat::Encode(value, type::WireFormat::kBinaryFormat, bytes);
+  type::Value decoded;
+  EXPECT_TRUE(type::WireFormat::DecodeBinary(type, bytes.data(), bytes.size(),
+                                             decoded));
+  return decoded;
+}
+
+}  // namespace
+
+TEST_F(WireFormatTests, BinaryEncodingTest) {
+  // Integers are in network order
+  std::vector<unsigned char> bytes;
+  type::WireFormat::Encode(type::ValueFactory::GetIntegerValue(0x01020304),
+                           type::WireFormat::kBinaryFormat, bytes);
+  EXPECT_EQ(std::vector<unsigned char>({1, 2, 3, 4}), bytes);
+
+  // NULLs are empty, text is what the value prints as
+  bytes.clear();
+  type::WireFormat::Encode(
+      type::ValueFactory::GetNullValueByType(type::TypeId::BIGINT),
+      type::WireFormat::kBinaryFormat, bytes);
+  EXPECT_TRUE(bytes.empty());
+  type::WireFormat::Encode(type::ValueFactory::GetIntegerValue(42),
+                           type::WireFormat::kTextFormat, bytes);
+  EXPECT_EQ(std::vector<unsigned char>({'4', '2'}), bytes);
+}
+
+TEST_F(WireFormatTests, RoundTripTest) {
+  std::vector<std::pair<type::Value, PostgresValueType>> values = {
+      {type::ValueFactory::GetBooleanValue(true), PostgresValueType::BOOLEAN},
+      {type::ValueFactory::GetSmallIntValue(-2), PostgresValueType::SMALLINT},
+      {type::ValueFactory::GetIntegerValue(-123456),
+       PostgresValueType::INTEGER},
+      {type::ValueFactory::GetBigIntValue(1LL << 40),
+       PostgresValueType::BIGINT},
+      {type::ValueFactory::GetDecimalValue(-1.5), PostgresValueType::DOUBLE},
+      {type::ValueFactory::GetVarcharValue("peloton"),
+       PostgresValueType::TEXT}};
+  for (auto &value : values) {
+    auto decoded = RoundTrip(value.first, value.second);
+    EXPECT_EQ(value.first.GetTypeId(), decoded.GetTypeId());
+    EXPECT_EQ(type::CmpBool::CMP_TRUE, value.first.CompareEquals(decoded));
+  }
+}
+
+TEST_F(WireFormatTests, TimestampTest) {
+  auto timestamp = type::ValueFactory::GetVarcharValue(
+                       "2017-06-15 13:45:30.123456+00")
+                       .CastAs(type::TypeId::TIMESTAMP);
+
+  // Timestamps are microseconds since 2000-01-01
+  EXPECT_EQ(550849530123456LL, type::WireFormat::ToPostgresTimestamp(
+                                   timestamp.GetAs<uint64_t>()));
+  EXPECT_EQ(timestamp.GetAs<uint64_t>(),
+            type::WireFormat::FromPostgresTimestamp(550849530123456LL));
+  EXPECT_EQ(timestamp.ToString(),
+            RoundTrip(timestamp, PostgresValueType::TIMESTAMPS).ToString());
+
+  auto epoch =
+      type::ValueFactory::GetVarcharValue("2000-01-01 00:00:00.000000+00")
+          .CastAs(type::TypeId::TIMESTAMP);
+  EXPECT_EQ(0, type::WireFormat::ToPostgresTimestamp(epoch.GetAs<uint64_t>()));
+}
+
+TEST_F(WireFormatTests, NumericTest) {
+  // -12345.5 is the base 10000 digits 1, 2345 and 5000 with weight 1
+  std::vector<unsigned char> bytes = {0, 3, 0, 1, 0x40, 0, 0, 1, 0, 1,
+                                      0x09, 0x29, 0x13, 0x88};
+  type::Value value;
+  EXPECT_TRUE(type::WireFormat::DecodeBinary(
+      PostgresValueType::DECIMAL, bytes.data(), bytes.size(), value));
+  EXPECT_DOUBLE_EQ(-12345.5, value.GetAs<double>());
+
+  // A length that does not fit the type is rejected
+  EXPECT_FALSE(type::WireFormat::DecodeBinary(
+      PostgresValueType::INTEGER, bytes.data(), 2, value));
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// numa_util_test.cpp
+//
+// Identification: test/util/numa_util_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "util/numa_util.h"
+#include "common/harness.h"
+
+#include <vector>
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// NumaUtil Test
+//===--------------------------------------------------------------------===//
+
+class NumaUtilTests : public PelotonTest {};
+
+TEST_F(NumaUtilTests, ParseListTest) {
+  std::vector<int> expected = {0, 1, 2, 3, 8, 10, 11};
+  EXPECT_EQ(expected, NumaUtil::ParseList("0-3,8,10-11"));
+
+  expected = {0};
+  EXPECT_EQ(expected, NumaUtil::ParseList("0"));
+  EXPECT_TRUE(NumaUtil::ParseList("").empty());
+}
+
+TEST_F(NumaUtilTests, TopologyTest) {
+  auto node_count = NumaUtil::GetNodeCount();
+  EXPECT_GE(node_count, 1);
+
+  auto current_node = NumaUtil::GetCurrentNode();
+  EXPECT_GE(current_node, 0);
+  EXPECT_LT(current_node, node_count);
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// copy_test.cpp
+//
+// Identification: test/wire/copy_test.cpp
+//
+// Copyright (c) 2015-17, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+#include "gtest/gtest.h"
+#include "common/logger.h"
+#include "wire/libevent_server.h"
+#include "util/string_util.h"
+#include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
+#include <algorithm>
+#include <vector>
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Copy Tests
+//===--------------------------------------------------------------------===//
+
+class CopyTests : public PelotonTest {};
+
+static void *LaunchServer(peloton::wire::LibeventServer libeventserver,
+                          int port) {
+  try {
+    libeventserver.SetPort(port);
+    libeventserver.StartServer();
+  } catch (peloton::ConnectionException exception) {
+    LOG_INFO("[LaunchServer] exception in thread");
+  }
+  return NULL;
+}
+
+/**
+ * Load rows with COPY FROM STDIN and read them back with COPY TO STDOUT
+ */
+void *CopyInOutTest(int port) {
+  try {
+    pqxx::connection C(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=postgres sslmode=disable", port));
+    pqxx::nontransaction txn1(C);
+    txn1.exec("DROP TABLE IF EXISTS employee;");
+    txn1.exec("CREATE TABLE employee(id INT, name VARCHAR(100));");
+
+    // The rows are loaded in a transaction of their own
+    {
+      pqxx::tablewriter writer(txn1, "employee");
+      for (int id = 0; id < 5; id++) {
+        writer.write_raw_line(StringUtil::Format("%d,a\\,b%d", id, id));
+      }
+      writer.complete();
+    }
+    pqxx::result R = txn1.exec("SELECT id, name FROM employee;");
+    EXPECT_EQ(R.size(), 5);
+
+    // A malformed line fails the whole COPY
+    EXPECT_THROW(
+        {
+          pqxx::tablewriter writer(txn1, "employee");
+          writer.write_raw_line("5,a");
+          writer.write_raw_line("b,6");
+          writer.complete();
+        },
+        std::exception);
+    R = txn1.exec("SELECT id, name FROM employee;");
+    EXPECT_EQ(R.size(), 5);
+
+    // The lines are escaped the way COPY FROM reads them
+    std::vector<std::string> lines;
+    {
+      pqxx::tablereader reader(txn1, "employee");
+      std::string line;
+      while (reader.get_raw_line(line)) {
+        lines.push_back(line);
+      }
+      reader.complete();
+    }
+    EXPECT_EQ(lines.size(), 5);
+    EXPECT_NE(std::find(lines.begin(), lines.end(), "3,a\\,b3"), lines.end());
+
+    txn1.commit();
+
+    // COPY FROM STDIN in a transaction block is part of the transaction
+    {
+      pqxx::work txn2(C);
+      pqxx::tablewriter writer(txn2, "employee");
+      writer.write_raw_line("5,c");
+      writer.complete();
+      txn2.abort();
+    }
+    pqxx::nontransaction txn3(C);
+    R = txn3.exec("SELECT id, name FROM employee;");
+    EXPECT_EQ(R.size(), 5);
+  } catch (const std::exception &e) {
+    LOG_INFO("[CopyInOutTest] Exception occurred: %s", e.what());
+    EXPECT_TRUE(false);
+  }
+  return NULL;
+}
+
+TEST_F(CopyTests, CopyInOutTest) {
+  peloton::PelotonInit::Initialize();
+  peloton::wire::LibeventServer libeventserver;
+
+  int port = 15721;
+  std::thread serverThread(LaunchServer, libeventserver, port);
+  while (!libeventserver.GetIsStarted()) {
+    sleep(1);
+  }
+
+  CopyInOutTest(port);
+
+  libeventserver.CloseServer();
+  serverThread.join();
+  peloton::PelotonInit::Shutdown();
+}
+
+}  // namespace test
+}  // namespace peloton
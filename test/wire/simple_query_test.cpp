@@ -13,9 +13,12 @@
 #include "common/harness.h"
 #include "gtest/gtest.h"
 #include "common/logger.h"
+#include "configuration/configuration.h"
+#include "tcop/tcop_pool.h"
 #include "wire/libevent_server.h"
 #include "util/string_util.h"
 #include <pqxx/pqxx> /* libpqxx is used to instantiate C++ client */
+#include <set>
 
 #define NUM_THREADS 1
 
@@ -78,6 +81,41 @@ void *SimpleQueryTest(int port) {
   return NULL;
 }
 
+/**
+ * Select more rows than are sent to the client at a time
+ */
+void *StreamingQueryTest(int port) {
+  try {
+    pqxx::connection C(StringUtil::Format(
+        "host=127.0.0.1 port=%d user=postgres sslmode=disable", port));
+    pqxx::work txn1(C);
+    txn1.exec("DROP TABLE IF EXISTS employee;");
+    txn1.exec("CREATE TABLE employee(id INT, name VARCHAR(100));");
+    for (int id = 0; id < 5; id++) {
+      txn1.exec(StringUtil::Format(
+          "INSERT INTO employee VALUES (%d, 'Employee %d');", id, id));
+    }
+    txn1.commit();
+
+    pqxx::work txn2(C);
+    pqxx::result R = txn2.exec("SELECT id, name FROM employee;");
+    txn2.commit();
+
+    // The rows of all chunks arrive, after a single row description
+    EXPECT_EQ(R.size(), 5);
+    EXPECT_EQ(R.columns(), 2);
+    std::set<int> ids;
+    for (const auto &row : R) {
+      ids.insert(row[0].as<int>());
+    }
+    EXPECT_EQ(ids.size(), 5);
+  } catch (const std::exception &e) {
+    LOG_INFO("[StreamingQueryTest] Exception occurred: %s", e.what());
+    EXPECT_TRUE(false);
+  }
+  return NULL;
+}
+
 /**
  * rollback test
  * YINGJUN: rewrite wanted.
@@ -172,6 +210,71 @@ TEST_F(SimpleQueryTests, SimpleQueryTest) {
   LOG_INFO("Peloton has shut down");
 }
 
+TEST_F(SimpleQueryTests, StreamingQueryTest) {
+  peloton::PelotonInit::Initialize();
+  peloton::wire::LibeventServer libeventserver;
+
+  int port = 15721;
+  std::thread serverThread(LaunchServer, libeventserver, port);
+  while (!libeventserver.GetIsStarted()) {
+    sleep(1);
+  }
+
+  FLAGS_result_chunk_rows = 2;
+  StreamingQueryTest(port);
+  FLAGS_result_chunk_rows = 1000;
+
+  libeventserver.CloseServer();
+  serverThread.join();
+  peloton::PelotonInit::Shutdown();
+}
+
+TEST_F(SimpleQueryTests, ExecutionThreadsTest) {
+  peloton::PelotonInit::Initialize();
+  peloton::wire::LibeventServer libeventserver;
+
+  int port = 15721;
+  std::thread serverThread(LaunchServer, libeventserver, port);
+  while (!libeventserver.GetIsStarted()) {
+    sleep(1);
+  }
+
+  // The statements run on the execution threads with the same results,
+  // also when the rows are sent while they run
+  FLAGS_execution_threads = 2;
+  SimpleQueryTest(port);
+  FLAGS_result_chunk_rows = 2;
+  StreamingQueryTest(port);
+  FLAGS_result_chunk_rows = 1000;
+  FLAGS_execution_threads = 0;
+
+  libeventserver.CloseServer();
+  serverThread.join();
+  peloton::PelotonInit::Shutdown();
+}
+
+TEST_F(SimpleQueryTests, ExecutionContextsTest) {
+  peloton::PelotonInit::Initialize();
+  peloton::wire::LibeventServer libeventserver;
+
+  int port = 15721;
+  std::thread serverThread(LaunchServer, libeventserver, port);
+  while (!libeventserver.GetIsStarted()) {
+    sleep(1);
+  }
+
+  // The connection runs its transactions on a shared traffic cop, which it
+  // gives back in between
+  FLAGS_execution_contexts = 1;
+  SimpleQueryTest(port);
+  EXPECT_EQ(1U, peloton::tcop::TrafficCopPool::GetInstance().GetFreeCount());
+  FLAGS_execution_contexts = 0;
+
+  libeventserver.CloseServer();
+  serverThread.join();
+  peloton::PelotonInit::Shutdown();
+}
+
 ///**
 // * Scalability test
 // * Open 2 servers in threads concurrently